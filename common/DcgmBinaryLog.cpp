@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmBinaryLog.h"
+#include "DcgmLogging.h"
+#include "DcgmTrace.h"
+
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace DcgmNs::Logging
+{
+namespace
+{
+    std::mutex g_startMutex;
+
+    constexpr char BINARY_LOG_MAGIC[8] = { 'D', 'C', 'G', 'M', 'B', 'L', 'G', '1' };
+
+    unsigned int CurrentTid()
+    {
+        thread_local unsigned int tid = (unsigned int)syscall(SYS_gettid);
+        return tid;
+    }
+
+    template <class T>
+    void Append(std::string &out, T value)
+    {
+        out.append(reinterpret_cast<char const *>(&value), sizeof(value));
+    }
+
+    void AppendString(std::string &out, char const *str)
+    {
+        std::uint32_t const length = strlen(str);
+        Append(out, length);
+        out.append(str, length);
+    }
+
+    /* Reads the dump front to back. Every read fails once the dump runs out */
+    class DumpReader
+    {
+    public:
+        explicit DumpReader(std::string const &dump)
+            : m_dump(dump)
+            , m_offset(0)
+        {}
+
+        template <class T>
+        bool Read(T &value)
+        {
+            return ReadBytes(&value, sizeof(value));
+        }
+
+        bool ReadString(std::string &str)
+        {
+            std::uint32_t length = 0;
+            if (!Read(length) || length > m_dump.size() - m_offset)
+            {
+                return false;
+            }
+            str.assign(m_dump, m_offset, length);
+            m_offset += length;
+            return true;
+        }
+
+        bool ReadBytes(void *dest, size_t size)
+        {
+            if (size > m_dump.size() - m_offset)
+            {
+                return false;
+            }
+            memcpy(dest, m_dump.data() + m_offset, size);
+            m_offset += size;
+            return true;
+        }
+
+    private:
+        std::string const &m_dump;
+        size_t m_offset;
+    };
+
+    /* Append format with each conversion filled in from args, the way printf would have */
+    void FormatEntry(std::string &out,
+                     std::string const &format,
+                     std::uint8_t numArgs,
+                     BinaryLogArgKind const *kinds,
+                     std::uint64_t const *args)
+    {
+        char buf[128];
+        std::uint8_t argIndex = 0;
+
+        for (size_t i = 0; i < format.size(); i++)
+        {
+            if (format[i] != '%')
+            {
+                out += format[i];
+                continue;
+            }
+            if (i + 1 < format.size() && format[i + 1] == '%')
+            {
+                out += '%';
+                i++;
+                continue;
+            }
+
+            /* Keep the flags, width and precision. Replace the length since the arguments are all 64-bit */
+            std::string spec = "%";
+            size_t j         = i + 1;
+            while (j < format.size() && strchr("-+ #0123456789.", format[j]) != nullptr)
+            {
+                spec += format[j++];
+            }
+            while (j < format.size() && strchr("hlLqjzt", format[j]) != nullptr)
+            {
+                j++;
+            }
+            if (j >= format.size())
+            {
+                out.append(format, i, std::string::npos);
+                return;
+            }
+
+            char const conversion = format[j];
+            i                     = j;
+
+            if (conversion == 's' || conversion == 'n')
+            {
+                out += "<string>";
+                continue;
+            }
+            if (argIndex >= numArgs)
+            {
+                out += "<missing>";
+                continue;
+            }
+
+            std::uint64_t const arg     = args[argIndex];
+            BinaryLogArgKind const kind = kinds[argIndex++];
+            if (strchr("di", conversion) != nullptr)
+            {
+                spec += "ll";
+                spec += conversion;
+                snprintf(buf, sizeof(buf), spec.c_str(), (long long)arg);
+            }
+            else if (strchr("uoxX", conversion) != nullptr)
+            {
+                spec += "ll";
+                spec += conversion;
+                snprintf(buf, sizeof(buf), spec.c_str(), (unsigned long long)arg);
+            }
+            else if (conversion == 'c')
+            {
+                spec += conversion;
+                snprintf(buf, sizeof(buf), spec.c_str(), (int)arg);
+            }
+            else if (strchr("fFeEgGaA", conversion) != nullptr)
+            {
+                double d = 0.0;
+                if (kind == BinaryLogArgKind::Double)
+                {
+                    memcpy(&d, &arg, sizeof(d));
+                }
+                else
+                {
+                    d = kind == BinaryLogArgKind::Signed ? (double)(long long)arg : (double)arg;
+                }
+                spec += conversion;
+                snprintf(buf, sizeof(buf), spec.c_str(), d);
+            }
+            else if (conversion == 'p')
+            {
+                spec += conversion;
+                snprintf(buf, sizeof(buf), spec.c_str(), (void *)(std::uintptr_t)arg);
+            }
+            else
+            {
+                snprintf(buf, sizeof(buf), "<%%%c?>", conversion);
+            }
+            out += buf;
+        }
+    }
+} // namespace
+
+/*****************************************************************************/
+BinaryLog &BinaryLog::Instance()
+{
+    static BinaryLog binaryLog;
+    return binaryLog;
+}
+
+/*****************************************************************************/
+BinaryLog::BinaryLog()
+    : m_enabled(false)
+    , m_slots(nullptr)
+    , m_capacity(0)
+    , m_next(0)
+{}
+
+/*****************************************************************************/
+void BinaryLog::Start(size_t numEntries)
+{
+    std::lock_guard<std::mutex> guard(g_startMutex);
+
+    if (!m_ring)
+    {
+        m_capacity = numEntries ? numEntries : DCGM_BINARY_LOG_DEFAULT_ENTRIES;
+        m_ring     = std::make_unique<Slot[]>(m_capacity);
+        for (size_t i = 0; i < m_capacity; i++)
+        {
+            m_ring[i].seq.store(0, std::memory_order_relaxed);
+        }
+        m_slots.store(m_ring.get(), std::memory_order_release);
+        DCGM_LOG_INFO << "Binary log started with room for " << m_capacity << " entries";
+    }
+
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+void BinaryLog::Stop(void)
+{
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+size_t BinaryLog::Capacity(void) const
+{
+    return m_slots.load(std::memory_order_acquire) ? m_capacity : 0;
+}
+
+/*****************************************************************************/
+void BinaryLog::Push(BinaryLogEntry &entry)
+{
+    Slot *slots = m_slots.load(std::memory_order_acquire);
+    if (!slots)
+    {
+        return;
+    }
+
+    entry.usec = timelib_usecSince1970();
+    entry.tid  = CurrentTid();
+
+    std::uint64_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot          = slots[index % m_capacity];
+
+    slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.entry = entry;
+    slot.seq.store(2 * (index + 1), std::memory_order_release);
+}
+
+/*****************************************************************************/
+std::vector<BinaryLogEntry> BinaryLog::Snapshot(void) const
+{
+    std::vector<BinaryLogEntry> entries;
+    Slot const *slots = m_slots.load(std::memory_order_acquire);
+    if (!slots)
+    {
+        return entries;
+    }
+
+    std::uint64_t next  = m_next.load(std::memory_order_relaxed);
+    std::uint64_t first = next > m_capacity ? next - m_capacity : 0;
+    entries.reserve(next - first);
+
+    for (std::uint64_t index = first; index < next; index++)
+    {
+        Slot const &slot     = slots[index % m_capacity];
+        std::uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before != 2 * (index + 1))
+        {
+            continue; /* Not written yet or already overwritten */
+        }
+
+        BinaryLogEntry entry = slot.entry;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before)
+        {
+            entries.push_back(entry);
+        }
+    }
+
+    return entries;
+}
+
+/*****************************************************************************/
+std::string BinaryLog::Serialize(std::vector<BinaryLogEntry> const &entries, int pid)
+{
+    std::unordered_map<BinaryLogSite const *, std::uint32_t> siteIndexes;
+    std::vector<BinaryLogSite const *> sites;
+    for (auto const &entry : entries)
+    {
+        if (siteIndexes.emplace(entry.site, sites.size()).second)
+        {
+            sites.push_back(entry.site);
+        }
+    }
+
+    std::string out;
+    out.append(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+    Append(out, (std::uint32_t)pid);
+    Append(out, (std::uint32_t)sites.size());
+    Append(out, (std::uint64_t)entries.size());
+
+    for (auto const *site : sites)
+    {
+        Append(out, (std::uint32_t)site->line);
+        AppendString(out, site->file);
+        AppendString(out, site->format);
+    }
+
+    for (auto const &entry : entries)
+    {
+        Append(out, siteIndexes[entry.site]);
+        Append(out, (std::uint32_t)entry.tid);
+        Append(out, (std::int64_t)entry.usec);
+        Append(out, entry.numArgs);
+        out.append(reinterpret_cast<char const *>(entry.kinds), entry.numArgs);
+        out.append(reinterpret_cast<char const *>(entry.args), entry.numArgs * sizeof(entry.args[0]));
+    }
+
+    return out;
+}
+
+/*****************************************************************************/
+dcgmReturn_t BinaryLog::Decode(std::string const &dump, std::ostream &out)
+{
+    DumpReader reader(dump);
+    char magic[sizeof(BINARY_LOG_MAGIC)];
+    std::uint32_t pid        = 0;
+    std::uint32_t numSites   = 0;
+    std::uint64_t numEntries = 0;
+
+    if (!reader.ReadBytes(magic, sizeof(magic)) || memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) != 0
+        || !reader.Read(pid) || !reader.Read(numSites) || !reader.Read(numEntries))
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    struct DecodedSite
+    {
+        std::uint32_t line;
+        std::string file;
+        std::string format;
+    };
+    if (numSites > dump.size())
+    {
+        return DCGM_ST_BADPARAM; /* Don't allocate for a count that can't be real */
+    }
+
+    std::vector<DecodedSite> sites(numSites);
+    for (auto &site : sites)
+    {
+        if (!reader.Read(site.line) || !reader.ReadString(site.file) || !reader.ReadString(site.format))
+        {
+            return DCGM_ST_BADPARAM;
+        }
+    }
+
+    std::string line;
+    for (std::uint64_t i = 0; i < numEntries; i++)
+    {
+        std::uint32_t siteIndex = 0;
+        std::uint32_t tid       = 0;
+        std::int64_t usec       = 0;
+        std::uint8_t numArgs    = 0;
+        BinaryLogArgKind kinds[DCGM_BINARY_LOG_MAX_ARGS];
+        std::uint64_t args[DCGM_BINARY_LOG_MAX_ARGS];
+
+        if (!reader.Read(siteIndex) || siteIndex >= sites.size() || !reader.Read(tid) || !reader.Read(usec)
+            || !reader.Read(numArgs) || numArgs > DCGM_BINARY_LOG_MAX_ARGS || !reader.ReadBytes(kinds, numArgs)
+            || !reader.ReadBytes(args, numArgs * sizeof(args[0])))
+        {
+            return DCGM_ST_BADPARAM;
+        }
+
+        DecodedSite const &site = sites[siteIndex];
+        line = std::to_string(usec) + " " + std::to_string(tid) + " " + site.file + ":" + std::to_string(site.line)
+               + " ";
+        FormatEntry(line, site.format, numArgs, kinds, args);
+        out << line << "\n";
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t BinaryLog::WriteBinaryLog(std::string const &directory, std::string &filename) const
+{
+    if (!Capacity())
+    {
+        return DCGM_ST_UNINITIALIZED;
+    }
+
+    std::string dump = Serialize(Snapshot(), (int)getpid());
+
+    return WriteDumpFile(directory, "dcgm-binlog-XXXXXX.bin", 4, dump, filename);
+}
+
+} // namespace DcgmNs::Logging
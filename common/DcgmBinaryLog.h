@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+#include "timelib.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/* Number of entries kept when the binary log is started without a size */
+#define DCGM_BINARY_LOG_DEFAULT_ENTRIES 65536
+
+/* Most arguments a DCGM_BINARY_LOG statement can have */
+#define DCGM_BINARY_LOG_MAX_ARGS 6
+
+namespace DcgmNs::Logging
+{
+/*****************************************************************************/
+/* One DCGM_BINARY_LOG statement. Static, so its address identifies the format */
+struct BinaryLogSite
+{
+    char const *file;
+    int line;
+    char const *format; /* printf format. Only numbers and pointers can be formatted */
+};
+
+/* How an argument was stored in BinaryLogEntry::args */
+enum class BinaryLogArgKind : std::uint8_t
+{
+    Signed   = 0,
+    Unsigned = 1,
+    Double   = 2,
+    Pointer  = 3,
+};
+
+/*****************************************************************************/
+/* One logged statement: the site and the raw arguments, not yet formatted */
+struct BinaryLogEntry
+{
+    BinaryLogSite const *site;
+    timelib64_t usec;
+    unsigned int tid;
+    std::uint8_t numArgs;
+    BinaryLogArgKind kinds[DCGM_BINARY_LOG_MAX_ARGS];
+    std::uint64_t args[DCGM_BINARY_LOG_MAX_ARGS];
+};
+
+/*****************************************************************************/
+/*
+ * Process-wide ring of log statements whose formatting is deferred until the
+ * log is read. Recording an entry copies a site pointer, a timestamp and the
+ * raw arguments into a slot, so a busy loop can log every iteration for
+ * nanoseconds each. Off until Start(). While off, a DCGM_BINARY_LOG costs one
+ * relaxed atomic load and its arguments are not evaluated.
+ *
+ * Dumps are written by WriteBinaryLog() and turned into text with Decode(),
+ * which can run in any process since the dump carries the formats.
+ *
+ * Dump format, native byte order:
+ *   char[8] magic "DCGMBLG1", uint32 pid, uint32 numSites, uint64 numEntries
+ *   numSites x  { uint32 line, uint32 fileLength, file, uint32 formatLength, format }
+ *   numEntries x { uint32 siteIndex, uint32 tid, int64 usec, uint8 numArgs,
+ *                  uint8 kinds[numArgs], uint64 args[numArgs] }
+ */
+class BinaryLog
+{
+public:
+    static BinaryLog &Instance();
+
+    /*************************************************************************/
+    /*
+     * Start recording. The ring is allocated by the first Start() and keeps its
+     * size for the life of the process, so numEntries is ignored after that.
+     * 0 = DCGM_BINARY_LOG_DEFAULT_ENTRIES
+     */
+    void Start(size_t numEntries);
+
+    /* Stop recording. Recorded entries are kept for Snapshot() */
+    void Stop(void);
+
+    bool IsEnabled(void) const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    template <class... Args>
+    void Record(BinaryLogSite const *site, Args... args)
+    {
+        static_assert(sizeof...(Args) <= DCGM_BINARY_LOG_MAX_ARGS, "Too many arguments for DCGM_BINARY_LOG");
+
+        BinaryLogEntry entry;
+        entry.site    = site;
+        entry.numArgs = 0;
+        (Pack(entry, args), ...);
+        Push(entry);
+    }
+
+    /* Get the entries in the ring, oldest first */
+    std::vector<BinaryLogEntry> Snapshot(void) const;
+
+    /* Number of slots in the ring. 0 = never started */
+    size_t Capacity(void) const;
+
+    /* Serialize entries in the dump format above */
+    static std::string Serialize(std::vector<BinaryLogEntry> const &entries, int pid);
+
+    /*************************************************************************/
+    /*
+     * Format a dump as text, one "usec tid file:line message" line per entry
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM if dump is not a complete binary log
+     */
+    static dcgmReturn_t Decode(std::string const &dump, std::ostream &out);
+
+    /*************************************************************************/
+    /*
+     * Write the current entries to a new file in directory. The file is created
+     * exclusively, so an existing file or link is never followed.
+     *
+     * filename OUT: Path of the file that was written
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_UNINITIALIZED if the binary log was never started
+     *         DCGM_ST_GENERIC_ERROR if the file couldn't be written
+     */
+    dcgmReturn_t WriteBinaryLog(std::string const &directory, std::string &filename) const;
+
+private:
+    BinaryLog();
+
+    template <class T>
+    static void Pack(BinaryLogEntry &entry, T value)
+    {
+        static_assert(!(std::is_pointer_v<T> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char>),
+                      "Strings are not kept by DCGM_BINARY_LOG. Log them with DCGM_LOG_*");
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>,
+                      "DCGM_BINARY_LOG only takes numbers and pointers");
+
+        if constexpr (std::is_enum_v<T>)
+        {
+            Pack(entry, static_cast<std::underlying_type_t<T>>(value));
+            return;
+        }
+
+        std::uint8_t const i = entry.numArgs++;
+        if constexpr (std::is_pointer_v<T>)
+        {
+            entry.kinds[i] = BinaryLogArgKind::Pointer;
+            entry.args[i]  = reinterpret_cast<std::uintptr_t>(value);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            double const d = value;
+            entry.kinds[i] = BinaryLogArgKind::Double;
+            memcpy(&entry.args[i], &d, sizeof(d));
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            entry.kinds[i] = BinaryLogArgKind::Signed;
+            entry.args[i]  = static_cast<std::uint64_t>(static_cast<long long>(value));
+        }
+        else
+        {
+            entry.kinds[i] = BinaryLogArgKind::Unsigned;
+            entry.args[i]  = static_cast<std::uint64_t>(value);
+        }
+    }
+
+    void Push(BinaryLogEntry &entry);
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> seq; /* 0 = empty. Odd = being written. Else 2 * (index + 1) */
+        BinaryLogEntry entry;
+    };
+
+    std::atomic<bool> m_enabled;
+    std::atomic<Slot *> m_slots;    /* Published once by the first Start() */
+    std::unique_ptr<Slot[]> m_ring; /* Owns m_slots */
+    size_t m_capacity;
+    std::atomic<std::uint64_t> m_next; /* Index of the next entry to record */
+};
+
+} // namespace DcgmNs::Logging
+
+/*
+ * Record a printf-style statement in the binary log if it is on, e.g.
+ * DCGM_BINARY_LOG("Updating eg %u eid %u fieldId %u", entityGroupId, entityId, fieldId).
+ * format must be a string literal. Arguments are only evaluated while the log is on
+ */
+#define DCGM_BINARY_LOG(format, ...)                                                                         \
+    do                                                                                                       \
+    {                                                                                                        \
+        if (DcgmNs::Logging::BinaryLog::Instance().IsEnabled())                                              \
+        {                                                                                                    \
+            static DcgmNs::Logging::BinaryLogSite const dcgmBinaryLogSite { __FILE__, __LINE__, "" format }; \
+            DcgmNs::Logging::BinaryLog::Instance().Record(&dcgmBinaryLogSite, ##__VA_ARGS__);                \
+        }                                                                                                    \
+    } while (0)
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmCpuPlacement.h"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <pthread.h>
+
+namespace DcgmNs
+{
+namespace
+{
+    /* Parse one decimal CPU number of [first, last). Returns false if that isn't all it is */
+    bool ParseCpu(char const *first, char const *last, unsigned int &cpu)
+    {
+        auto [ptr, ec] = std::from_chars(first, last, cpu);
+        return ec == std::errc() && ptr == last && first != last && cpu < CPU_SETSIZE;
+    }
+} // namespace
+
+/*****************************************************************************/
+bool ParseCpuList(std::string const &cpuList, cpu_set_t &cpus)
+{
+    CPU_ZERO(&cpus);
+
+    char const *pos = cpuList.data();
+    char const *end = cpuList.data() + cpuList.size();
+
+    while (pos < end)
+    {
+        char const *comma = std::find(pos, end, ',');
+        char const *dash  = std::find(pos, comma, '-');
+        unsigned int first, last;
+
+        if (!ParseCpu(pos, dash, first))
+        {
+            CPU_ZERO(&cpus);
+            return false;
+        }
+        last = first;
+        if (dash != comma && (!ParseCpu(dash + 1, comma, last) || last < first))
+        {
+            CPU_ZERO(&cpus);
+            return false;
+        }
+
+        for (unsigned int cpu = first; cpu <= last; cpu++)
+            CPU_SET(cpu, &cpus);
+
+        /* A trailing comma leaves an empty range */
+        if (comma != end && comma + 1 == end)
+        {
+            CPU_ZERO(&cpus);
+            return false;
+        }
+        pos = comma + 1;
+    }
+
+    return CPU_COUNT(&cpus) > 0;
+}
+
+/*****************************************************************************/
+void CpuSetFromBitmask(unsigned long const *bitmask, unsigned int numLongs, cpu_set_t &cpus)
+{
+    constexpr unsigned int bitsPerLong = sizeof(unsigned long) * CHAR_BIT;
+
+    CPU_ZERO(&cpus);
+    for (unsigned int i = 0; i < numLongs; i++)
+    {
+        for (unsigned int bit = 0; bit < bitsPerLong; bit++)
+        {
+            unsigned int cpu = i * bitsPerLong + bit;
+            if (cpu < CPU_SETSIZE && (bitmask[i] & (1UL << bit)))
+                CPU_SET(cpu, &cpus);
+        }
+    }
+}
+
+/*****************************************************************************/
+bool ExcludeCpusFromCurrentThread(cpu_set_t const &reserved)
+{
+    cpu_set_t cpus;
+
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+        return false;
+
+    for (unsigned int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &reserved))
+            CPU_CLR(cpu, &cpus);
+    }
+
+    if (CPU_COUNT(&cpus) == 0)
+        return false;
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+}
+
+/*****************************************************************************/
+bool PinCurrentThread(cpu_set_t const &cpus, cpu_set_t const &allowed)
+{
+    cpu_set_t pinned;
+
+    CPU_AND(&pinned, &cpus, &allowed);
+    if (CPU_COUNT(&pinned) == 0)
+        return false;
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned) == 0;
+}
+} // namespace DcgmNs
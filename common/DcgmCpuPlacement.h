@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <sched.h>
+#include <string>
+
+/* Values of DCGM_ENV_THREAD_PLACEMENT */
+#define DCGM_THREAD_PLACEMENT_NONE "none" /* Threads run wherever the scheduler puts them */
+#define DCGM_THREAD_PLACEMENT_GPU  "gpu"  /* GPU fetch threads are pinned to the CPUs near their GPU */
+
+namespace DcgmNs
+{
+/*****************************************************************************/
+/*
+ * Parse a cpulist in the format of /sys/devices/system/cpu/online, like
+ * "0-3,8,10-11", into cpus. Returns false if cpuList is empty, malformed or
+ * names a CPU past CPU_SETSIZE. cpus is left empty in that case
+ */
+bool ParseCpuList(std::string const &cpuList, cpu_set_t &cpus);
+
+/*****************************************************************************/
+/*
+ * Convert an affinity bitmask as returned by nvmlDeviceGetCpuAffinity(), one
+ * bit per CPU in each of numLongs unsigned longs, to a cpu_set_t
+ */
+void CpuSetFromBitmask(unsigned long const *bitmask, unsigned int numLongs, cpu_set_t &cpus);
+
+/*****************************************************************************/
+/*
+ * Remove the CPUs in reserved from the calling thread's affinity. Threads
+ * created by this thread afterward inherit the result, so calling this early
+ * in main() keeps a whole process off of reserved.
+ *
+ * Returns false and leaves the affinity as is if no CPU would be left or the
+ * call fails
+ */
+bool ExcludeCpusFromCurrentThread(cpu_set_t const &reserved);
+
+/*****************************************************************************/
+/*
+ * Pin the calling thread to the CPUs that are in both cpus and allowed.
+ * Returns false and leaves the affinity as is if they have none in common or
+ * the call fails
+ */
+bool PinCurrentThread(cpu_set_t const &cpus, cpu_set_t const &allowed);
+} // namespace DcgmNs
@@ -16,6 +16,10 @@
 #include "DcgmFvBuffer.h"
 #include "DcgmLogging.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
 /******************************************************************************/
 DcgmFvBuffer::DcgmFvBuffer(size_t initialCapacity)
 {
@@ -23,6 +27,7 @@ DcgmFvBuffer::DcgmFvBuffer(size_t initialCapacity)
     m_bufferCapacity = 0;
     m_bufferUsed     = 0;
     m_numEntries     = 0;
+    m_indexEnabled   = false;
     /* Allow this to be initialized without a capacity for efficient setting from a buffer */
     if (initialCapacity > 0)
         Resize(initialCapacity);
@@ -42,6 +47,46 @@ DcgmFvBuffer::~DcgmFvBuffer()
     m_numEntries     = 0;
 }
 
+/******************************************************************************/
+DcgmFvBuffer::DcgmFvBuffer(DcgmFvBuffer &&other) noexcept
+    : m_buffer(other.m_buffer)
+    , m_bufferUsed(other.m_bufferUsed)
+    , m_bufferCapacity(other.m_bufferCapacity)
+    , m_numEntries(other.m_numEntries)
+    , m_indexEnabled(other.m_indexEnabled)
+    , m_index(std::move(other.m_index))
+{
+    other.m_buffer         = 0;
+    other.m_bufferUsed     = 0;
+    other.m_bufferCapacity = 0;
+    other.m_numEntries     = 0;
+    other.m_index.clear();
+}
+
+/******************************************************************************/
+DcgmFvBuffer &DcgmFvBuffer::operator=(DcgmFvBuffer &&other) noexcept
+{
+    if (this != &other)
+    {
+        free(m_buffer);
+
+        m_buffer         = other.m_buffer;
+        m_bufferUsed     = other.m_bufferUsed;
+        m_bufferCapacity = other.m_bufferCapacity;
+        m_numEntries     = other.m_numEntries;
+        m_indexEnabled   = other.m_indexEnabled;
+        m_index          = std::move(other.m_index);
+
+        other.m_buffer         = 0;
+        other.m_bufferUsed     = 0;
+        other.m_bufferCapacity = 0;
+        other.m_numEntries     = 0;
+        other.m_index.clear();
+    }
+
+    return *this;
+}
+
 /******************************************************************************/
 dcgmReturn_t DcgmFvBuffer::Resize(size_t newCapacity)
 {
@@ -57,6 +102,7 @@ dcgmReturn_t DcgmFvBuffer::Resize(size_t newCapacity)
         m_bufferUsed     = 0;
         m_bufferCapacity = 0;
         m_numEntries     = 0;
+        m_index.clear();
         free(m_buffer);
         m_buffer = nullptr;
         return DCGM_ST_MEMORY;
@@ -68,11 +114,31 @@ dcgmReturn_t DcgmFvBuffer::Resize(size_t newCapacity)
     return DCGM_ST_OK;
 }
 
+/******************************************************************************/
+size_t DcgmFvBuffer::GrowthCapacity(size_t spaceNeeded) const
+{
+    // Find nearest value that is a product of 512
+    size_t newBufferCapacity = (spaceNeeded + 511U) & (~511U);
+
+    /* Grow geometrically so that filling a buffer costs a logarithmic number of reallocs */
+    return std::max(newBufferCapacity, 2 * m_bufferCapacity);
+}
+
+/******************************************************************************/
+dcgmReturn_t DcgmFvBuffer::Reserve(size_t capacity)
+{
+    if (capacity <= m_bufferCapacity)
+        return DCGM_ST_OK;
+
+    return Resize(capacity);
+}
+
 /******************************************************************************/
 void DcgmFvBuffer::Clear(void)
 {
     m_bufferUsed = 0;
     m_numEntries = 0;
+    m_index.clear();
 }
 
 /******************************************************************************/
@@ -84,10 +150,7 @@ dcgmBufferedFv_t *DcgmFvBuffer::AddFvReally(size_t bytesNeeded)
     size_t spaceUsedAfter = m_bufferUsed + bytesNeeded;
     if (spaceUsedAfter > m_bufferCapacity)
     {
-        // Find nearest value that is a product of 512
-        size_t newBufferCapacity = (spaceUsedAfter + 511U) & (~511U);
-
-        dcgmReturn = Resize(newBufferCapacity);
+        dcgmReturn = Resize(GrowthCapacity(spaceUsedAfter));
         if (dcgmReturn != DCGM_ST_OK)
         {
             return nullptr;
@@ -103,6 +166,69 @@ dcgmBufferedFv_t *DcgmFvBuffer::AddFvReally(size_t bytesNeeded)
     return retPtr;
 }
 
+/******************************************************************************/
+dcgmBufferedFv_t *DcgmFvBuffer::AddFvsReally(size_t recordSize, size_t count)
+{
+    size_t spaceUsedAfter = m_bufferUsed + recordSize * count;
+    if (spaceUsedAfter > m_bufferCapacity)
+    {
+        if (Resize(GrowthCapacity(spaceUsedAfter)) != DCGM_ST_OK)
+        {
+            return nullptr;
+        }
+    }
+
+    dcgmBufferedFv_t *retPtr = (dcgmBufferedFv_t *)&m_buffer[m_bufferUsed];
+    m_bufferUsed             = spaceUsedAfter;
+    m_numEntries += count;
+    return retPtr;
+}
+
+/******************************************************************************/
+void DcgmFvBuffer::IndexFrom(size_t offset)
+{
+    if (!m_indexEnabled)
+        return;
+
+    dcgmBufferedFvCursor_t cursor = offset;
+    for (dcgmBufferedFv_t const *fv = GetNextFv(&cursor); fv; fv = GetNextFv(&cursor))
+    {
+        m_index[IndexKey(fv->entityGroupId, fv->entityId, fv->fieldId)] = (char const *)fv - m_buffer;
+    }
+}
+
+/******************************************************************************/
+void DcgmFvBuffer::EnableIndex(void)
+{
+    if (m_indexEnabled)
+        return;
+
+    m_indexEnabled = true;
+    IndexFrom(0);
+}
+
+/******************************************************************************/
+dcgmBufferedFv_t const *DcgmFvBuffer::Find(dcgm_field_entity_group_t entityGroupId,
+                                           dcgm_field_eid_t entityId,
+                                           unsigned short fieldId) const
+{
+    if (m_indexEnabled)
+    {
+        auto it = m_index.find(IndexKey(entityGroupId, entityId, fieldId));
+        if (it == m_index.end())
+            return nullptr;
+        return (dcgmBufferedFv_t const *)&m_buffer[it->second];
+    }
+
+    dcgmBufferedFv_t const *found = nullptr;
+    for (dcgmBufferedFv_t const &fv : *this)
+    {
+        if (fv.entityGroupId == (unsigned int)entityGroupId && fv.entityId == entityId && fv.fieldId == fieldId)
+            found = &fv;
+    }
+    return found;
+}
+
 /******************************************************************************/
 dcgmBufferedFv_t *DcgmFvBuffer::AddInt64Value(dcgm_field_entity_group_t entityGroupId,
                                               dcgm_field_eid_t entityId,
@@ -127,6 +253,7 @@ dcgmBufferedFv_t *DcgmFvBuffer::AddInt64Value(dcgm_field_entity_group_t entityGr
     retPtr->fieldId       = fieldId;
     retPtr->timestamp     = timestamp;
     retPtr->value.i64     = value;
+    IndexFrom((char *)retPtr - m_buffer);
     return retPtr;
 }
 
@@ -154,6 +281,7 @@ dcgmBufferedFv_t *DcgmFvBuffer::AddDoubleValue(dcgm_field_entity_group_t entityG
     retPtr->fieldId       = fieldId;
     retPtr->timestamp     = timestamp;
     retPtr->value.dbl     = value;
+    IndexFrom((char *)retPtr - m_buffer);
     return retPtr;
 }
 
@@ -197,6 +325,7 @@ dcgmBufferedFv_t *DcgmFvBuffer::AddStringValue(dcgm_field_entity_group_t entityG
     retPtr->fieldId       = fieldId;
     retPtr->timestamp     = timestamp;
     memmove(retPtr->value.str, value, stringLength + 1);
+    IndexFrom((char *)retPtr - m_buffer);
     return retPtr;
 }
 
@@ -237,13 +366,96 @@ dcgmBufferedFv_t *DcgmFvBuffer::AddBlobValue(dcgm_field_entity_group_t entityGro
     retPtr->fieldId       = fieldId;
     retPtr->timestamp     = timestamp;
     memmove(retPtr->value.blob, value, valueSize);
+    IndexFrom((char *)retPtr - m_buffer);
     return retPtr;
 }
 
+/******************************************************************************/
+template <typename T>
+static void FillBatch(dcgmBufferedFv_t *fv,
+                      size_t recordSize,
+                      unsigned short fieldType,
+                      dcgm_field_entity_group_t entityGroupId,
+                      dcgm_field_eid_t entityId,
+                      unsigned short fieldId,
+                      T const *values,
+                      long long const *timestamps,
+                      size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        fv->length        = recordSize;
+        fv->version       = dcgmBufferedFv_version;
+        fv->fieldType     = fieldType;
+        fv->status        = DCGM_ST_OK;
+        fv->entityGroupId = entityGroupId;
+        fv->fieldId       = fieldId;
+        fv->timestamp     = timestamps[i];
+        fv->entityId      = entityId;
+        fv->unused        = 0;
+        memcpy(&fv->value, &values[i], sizeof(T));
+        fv = (dcgmBufferedFv_t *)((char *)fv + recordSize);
+    }
+}
+
+/******************************************************************************/
+dcgmReturn_t DcgmFvBuffer::AddInt64Values(dcgm_field_entity_group_t entityGroupId,
+                                          dcgm_field_eid_t entityId,
+                                          unsigned short fieldId,
+                                          long long const *values,
+                                          long long const *timestamps,
+                                          size_t count)
+{
+    if (!count)
+        return DCGM_ST_OK;
+    if (!values || !timestamps)
+        return DCGM_ST_BADPARAM;
+
+    size_t const recordSize = (sizeof(dcgmBufferedFv_t) - sizeof(dcgmBufferedFv_t::value)) + sizeof(long long);
+    size_t const offset     = m_bufferUsed;
+    dcgmBufferedFv_t *first = AddFvsReally(recordSize, count);
+    if (!first)
+        return DCGM_ST_MEMORY;
+
+    FillBatch(first, recordSize, DCGM_FT_INT64, entityGroupId, entityId, fieldId, values, timestamps, count);
+    IndexFrom(offset);
+    return DCGM_ST_OK;
+}
+
+/******************************************************************************/
+dcgmReturn_t DcgmFvBuffer::AddDoubleValues(dcgm_field_entity_group_t entityGroupId,
+                                           dcgm_field_eid_t entityId,
+                                           unsigned short fieldId,
+                                           double const *values,
+                                           long long const *timestamps,
+                                           size_t count)
+{
+    if (!count)
+        return DCGM_ST_OK;
+    if (!values || !timestamps)
+        return DCGM_ST_BADPARAM;
+
+    size_t const recordSize = (sizeof(dcgmBufferedFv_t) - sizeof(dcgmBufferedFv_t::value)) + sizeof(double);
+    size_t const offset     = m_bufferUsed;
+    dcgmBufferedFv_t *first = AddFvsReally(recordSize, count);
+    if (!first)
+        return DCGM_ST_MEMORY;
+
+    FillBatch(first, recordSize, DCGM_FT_DOUBLE, entityGroupId, entityId, fieldId, values, timestamps, count);
+    IndexFrom(offset);
+    return DCGM_ST_OK;
+}
+
 /******************************************************************************/
 dcgmBufferedFv_t *DcgmFvBuffer::GetNextFv(dcgmBufferedFvCursor_t *cursor)
 {
-    dcgmBufferedFv_t *retPtr;
+    return const_cast<dcgmBufferedFv_t *>(static_cast<DcgmFvBuffer const *>(this)->GetNextFv(cursor));
+}
+
+/******************************************************************************/
+dcgmBufferedFv_t const *DcgmFvBuffer::GetNextFv(dcgmBufferedFvCursor_t *cursor) const
+{
+    dcgmBufferedFv_t const *retPtr;
 
     if (!m_buffer || !m_bufferUsed)
         return 0;
@@ -251,7 +463,7 @@ dcgmBufferedFv_t *DcgmFvBuffer::GetNextFv(dcgmBufferedFvCursor_t *cursor)
     if ((*cursor) >= m_bufferUsed)
         return 0;
 
-    retPtr = (dcgmBufferedFv_t *)&m_buffer[*cursor];
+    retPtr = (dcgmBufferedFv_t const *)&m_buffer[*cursor];
 
     /* Do some basic sanity on the FV */
     if (retPtr->version != dcgmBufferedFv_version)
@@ -288,11 +500,17 @@ dcgmReturn_t DcgmFvBuffer::SetFromBuffer(const char *buffer, size_t bufferSize)
     memcpy(m_buffer, buffer, bufferSize);
     m_bufferUsed = bufferSize;
     m_numEntries = 0;
+    m_index.clear();
 
     /* Count entries and do basic sanity */
     for (bufferIndex = 0; bufferIndex < m_bufferUsed; bufferIndex += fv->length)
     {
         fv = (dcgmBufferedFv_t *)&m_buffer[bufferIndex];
+        if (bufferIndex + offsetof(dcgmBufferedFv_t, value) > m_bufferUsed)
+        {
+            PRINT_ERROR("%d %d", "Truncated fv at %d / %d", (int)bufferIndex, (int)m_bufferUsed);
+            return DCGM_ST_GENERIC_ERROR;
+        }
         if (fv->version != dcgmBufferedFv_version)
         {
             PRINT_ERROR("%d %d %d",
@@ -302,7 +520,8 @@ dcgmReturn_t DcgmFvBuffer::SetFromBuffer(const char *buffer, size_t bufferSize)
                         (int)m_bufferUsed);
             return DCGM_ST_GENERIC_ERROR;
         }
-        if (fv->length + bufferIndex > m_bufferUsed)
+        /* The buffer may have come from another process. A short length would never advance */
+        if (fv->length < offsetof(dcgmBufferedFv_t, value) || fv->length + bufferIndex > m_bufferUsed)
         {
             PRINT_ERROR("%u %d %d", "Corrupt fv length %u at %d / %d", fv->length, (int)bufferIndex, (int)m_bufferUsed);
             return DCGM_ST_GENERIC_ERROR;
@@ -311,9 +530,50 @@ dcgmReturn_t DcgmFvBuffer::SetFromBuffer(const char *buffer, size_t bufferSize)
         m_numEntries++;
     }
 
+    IndexFrom(0);
     return DCGM_ST_OK;
 }
 
+/******************************************************************************/
+dcgmReturn_t DcgmFvBuffer::AppendFvBuffer(DcgmFvBuffer *other)
+{
+    if (!other || other == this)
+        return DCGM_ST_BADPARAM;
+    if (!other->m_bufferUsed)
+        return DCGM_ST_OK; /* Nothing to append */
+
+    size_t spaceUsedAfter = m_bufferUsed + other->m_bufferUsed;
+    if (spaceUsedAfter > m_bufferCapacity)
+    {
+        dcgmReturn_t dcgmReturn = Resize(GrowthCapacity(spaceUsedAfter));
+        if (dcgmReturn != DCGM_ST_OK)
+            return dcgmReturn;
+    }
+
+    /* Entries are self-describing, so they can be copied as-is */
+    size_t const offset = m_bufferUsed;
+    memcpy(&m_buffer[m_bufferUsed], other->m_buffer, other->m_bufferUsed);
+    m_bufferUsed = spaceUsedAfter;
+    m_numEntries += other->m_numEntries;
+    IndexFrom(offset);
+    return DCGM_ST_OK;
+}
+
+/******************************************************************************/
+dcgmBufferedFv_t *DcgmFvBuffer::AddFvCopy(dcgmBufferedFv_t const *fv)
+{
+    if (!fv)
+        return nullptr;
+
+    dcgmBufferedFv_t *retPtr = AddFvReally(fv->length);
+    if (retPtr != nullptr)
+    {
+        memcpy(retPtr, fv, fv->length);
+        IndexFrom((char *)retPtr - m_buffer);
+    }
+    return retPtr;
+}
+
 /******************************************************************************/
 void DcgmFvBuffer::ConvertBufferedFvToFv1(dcgmBufferedFv_t *fv, dcgmFieldValue_v1 *fv1)
 {
@@ -420,7 +680,7 @@ dcgmReturn_t DcgmFvBuffer::GetAllAsFv1(dcgmFieldValue_v1 *fv1, size_t fv1Capacit
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmFvBuffer::GetSize(size_t *bufferSize, size_t *elementCount)
+dcgmReturn_t DcgmFvBuffer::GetSize(size_t *bufferSize, size_t *elementCount) const
 {
     if (!bufferSize && !elementCount)
         return DCGM_ST_BADPARAM;
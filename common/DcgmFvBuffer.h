@@ -18,7 +18,10 @@
 
 #include "dcgm_fields.h"
 #include "dcgm_structs.h"
+#include <cstdint>
+#include <iterator>
 #include <stddef.h> //size_t
+#include <unordered_map>
 
 /**
  * This structure is used to buffer field values within DCGM, so it is optimized for storage size.
@@ -90,11 +93,127 @@ public:
     ~DcgmFvBuffer();
 
     /**************************************************************************
-     * Clear the contents of this structure
+     * Buffers own their memory, so they can be moved but not copied. Moving takes
+     * the FVs of other without copying them and leaves other empty
+     */
+    DcgmFvBuffer(DcgmFvBuffer &&other) noexcept;
+    DcgmFvBuffer &operator=(DcgmFvBuffer &&other) noexcept;
+
+    DcgmFvBuffer(DcgmFvBuffer const &) = delete;
+    DcgmFvBuffer &operator=(DcgmFvBuffer const &) = delete;
+
+    /**************************************************************************
+     * Forward iterator over the buffered FVs, so that a buffer can be walked with
+     * for (dcgmBufferedFv_t const &fv : fvBuffer). Walks the same FVs as GetNextFv()
+     * and is invalidated by anything that adds to the buffer
+     */
+    template <class FvType, class BufferType>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = dcgmBufferedFv_t;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = FvType *;
+        using reference         = FvType &;
+
+        /* End iterator */
+        Iterator()
+            : m_buffer(nullptr)
+            , m_cursor(0)
+            , m_fv(nullptr)
+        {}
+
+        /* Iterator to the first FV of buffer */
+        explicit Iterator(BufferType *buffer)
+            : m_buffer(buffer)
+            , m_cursor(0)
+            , m_fv(buffer->GetNextFv(&m_cursor))
+        {}
+
+        reference operator*() const
+        {
+            return *m_fv;
+        }
+
+        pointer operator->() const
+        {
+            return m_fv;
+        }
+
+        Iterator &operator++()
+        {
+            m_fv = m_buffer->GetNextFv(&m_cursor);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator before = *this;
+            ++(*this);
+            return before;
+        }
+
+        bool operator==(Iterator const &other) const
+        {
+            return m_fv == other.m_fv;
+        }
+
+        bool operator!=(Iterator const &other) const
+        {
+            return m_fv != other.m_fv;
+        }
+
+    private:
+        BufferType *m_buffer;
+        dcgmBufferedFvCursor_t m_cursor; /* Where the FV after m_fv starts */
+        FvType *m_fv;                    /* nullptr = end */
+    };
+
+    using iterator       = Iterator<dcgmBufferedFv_t, DcgmFvBuffer>;
+    using const_iterator = Iterator<dcgmBufferedFv_t const, DcgmFvBuffer const>;
+
+    iterator begin()
+    {
+        return iterator(this);
+    }
+    iterator end()
+    {
+        return iterator();
+    }
+    const_iterator begin() const
+    {
+        return const_iterator(this);
+    }
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+    /**************************************************************************
+     * Clear the contents of this structure. The allocation is kept so that the
+     * buffer can be refilled without touching the heap. An index stays enabled
      *
      */
     void Clear(void);
 
+    /**************************************************************************
+     * Make sure this structure can hold at least capacity bytes without being
+     * resized. This never shrinks the buffer and keeps its contents
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_MEMORY if we're out of memory
+     */
+    dcgmReturn_t Reserve(size_t capacity);
+
+    /**************************************************************************
+     * Get how many bytes this structure can hold before being resized
+     */
+    size_t GetCapacity(void) const
+    {
+        return m_bufferCapacity;
+    }
+
     /**************************************************************************
      * Get the next field value in this structure based on the passed-in cursor
      *
@@ -104,6 +223,7 @@ public:
      *         NULL if we have walked the entire FV buffer or an error occurs
      */
     dcgmBufferedFv_t *GetNextFv(dcgmBufferedFvCursor_t *cursor);
+    dcgmBufferedFv_t const *GetNextFv(dcgmBufferedFvCursor_t *cursor) const;
 
     /**************************************************************************
      * Set the contents of this FV from a buffer. This is essentially
@@ -120,7 +240,25 @@ public:
      * Returns DCGM_ST_OK on success
      *         DCGM_ST_? #define on error
      */
-    dcgmReturn_t GetSize(size_t *bufferSize, size_t *elementCount);
+    dcgmReturn_t GetSize(size_t *bufferSize, size_t *elementCount) const;
+
+    /**************************************************************************
+     * Append copies of all of the field values in other to the end of this
+     * structure. other is not modified
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_? #define on error
+     */
+    dcgmReturn_t AppendFvBuffer(DcgmFvBuffer *other);
+
+    /**************************************************************************
+     * Append a copy of a single field value, which may come from another
+     * DcgmFvBuffer
+     *
+     * Returns A pointer to the copy
+     *         NULL on error. Likely out of memory
+     */
+    dcgmBufferedFv_t *AddFvCopy(dcgmBufferedFv_t const *fv);
 
     /**************************************************************************
      *
@@ -128,7 +266,7 @@ public:
      * only. Do not modify this buffer. This value may be NULL.
      *
      */
-    const char *GetBuffer(void)
+    const char *GetBuffer(void) const
     {
         return m_buffer;
     }
@@ -194,6 +332,51 @@ public:
                                    long long timestamp,
                                    dcgmReturn_t status);
 
+    /**************************************************************************
+     * Append count samples of one field of one entity at once, e.g. a range of
+     * a time series. Every record has the same size, so the buffer is grown once
+     * and the records are written in one pass. The samples' status is DCGM_ST_OK
+     *
+     * values      IN: count values
+     * timestamps  IN: count timestamps in usec since 1970, one per value
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM if values or timestamps is NULL while count isn't 0
+     *         DCGM_ST_MEMORY if we're out of memory. Nothing was appended
+     */
+    dcgmReturn_t AddInt64Values(dcgm_field_entity_group_t entityGroupId,
+                                dcgm_field_eid_t entityId,
+                                unsigned short fieldId,
+                                long long const *values,
+                                long long const *timestamps,
+                                size_t count);
+    dcgmReturn_t AddDoubleValues(dcgm_field_entity_group_t entityGroupId,
+                                 dcgm_field_eid_t entityId,
+                                 unsigned short fieldId,
+                                 double const *values,
+                                 long long const *timestamps,
+                                 size_t count);
+
+    /**************************************************************************
+     * Keep an index from (entityGroupId, entityId, fieldId) to the last FV added
+     * for it, so that Find() doesn't have to walk the buffer. Indexes the FVs
+     * already in the buffer. Everything added afterwards is indexed as it is added.
+     * Costs a hash table insert per FV, so only enable it for buffers that are
+     * searched more than once.
+     */
+    void EnableIndex(void);
+
+    /**************************************************************************
+     * Find the last FV added for an entity's field. Uses the index if
+     * EnableIndex() was called and walks the buffer otherwise
+     *
+     * Returns A pointer to the FV. Valid until the buffer is added to
+     *         NULL if this buffer has no FV for the entity's field
+     */
+    dcgmBufferedFv_t const *Find(dcgm_field_entity_group_t entityGroupId,
+                                 dcgm_field_eid_t entityId,
+                                 unsigned short fieldId) const;
+
 private:
     /**************************************************************************
      * Resize this structure to hold a new capacity of bytes
@@ -205,6 +388,11 @@ private:
      */
     dcgmReturn_t Resize(size_t newCapacity);
 
+    /**************************************************************************
+     * Get the capacity to resize to when spaceNeeded bytes don't fit
+     */
+    size_t GrowthCapacity(size_t spaceNeeded) const;
+
     /**************************************************************************
      * Really add a FV to this buffer and return a pointer to it
      *
@@ -215,12 +403,29 @@ private:
      */
     dcgmBufferedFv_t *AddFvReally(size_t bytesNeeded);
 
+    /**************************************************************************
+     * Add the FVs from offset in m_buffer to the end to m_index if the index is
+     * enabled
+     */
+    void IndexFrom(size_t offset);
+
+    /* Batch version of AddFvReally(). Returns a pointer to the first record or NULL if out of memory */
+    dcgmBufferedFv_t *AddFvsReally(size_t recordSize, size_t count);
+
+    static std::uint64_t IndexKey(unsigned int entityGroupId, dcgm_field_eid_t entityId, unsigned short fieldId)
+    {
+        return ((std::uint64_t)entityGroupId << 48) | ((std::uint64_t)fieldId << 32) | entityId;
+    }
+
     char *m_buffer;          /* Buffer of FVs, one after another. m_bufferUsed is how many bytes
                        of this are used. m_bufferCapacity is how many bytes this buffer
                        can hold before being resized. */
     size_t m_bufferUsed;     /* How much of this buffer is currently used in bytes */
     size_t m_bufferCapacity; /* how many bytes this buffer can hold before being resized */
     size_t m_numEntries;     /* Number of FVs that are currently buffered */
+
+    bool m_indexEnabled;                               /* Whether m_index is kept. See EnableIndex() */
+    std::unordered_map<std::uint64_t, size_t> m_index; /* IndexKey() -> offset of the last FV for it */
 };
 
 #endif // DCGMFVBUFFER_H
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmFvBufferPool.h"
+
+/******************************************************************************/
+DcgmFvBufferPool::DcgmFvBufferPool(size_t maxPooled)
+    : m_maxPooled(maxPooled)
+    , m_capacityHint(FVBUFFER_GUESS_INITIAL_CAPACITY(1, 16))
+{
+    m_pooled.reserve(maxPooled);
+}
+
+/******************************************************************************/
+DcgmFvBuffer *DcgmFvBufferPool::Acquire(void)
+{
+    size_t capacity = m_capacityHint.load(std::memory_order_relaxed);
+    std::unique_ptr<DcgmFvBuffer> fvBuffer;
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_pooled.empty())
+        {
+            fvBuffer = std::move(m_pooled.back());
+            m_pooled.pop_back();
+        }
+    }
+
+    if (!fvBuffer)
+    {
+        fvBuffer = std::make_unique<DcgmFvBuffer>(capacity);
+    }
+
+    /* A no-op unless the watches have grown since this buffer was last used */
+    if (fvBuffer->Reserve(capacity) != DCGM_ST_OK)
+    {
+        return nullptr;
+    }
+
+    return fvBuffer.release();
+}
+
+/******************************************************************************/
+void DcgmFvBufferPool::Release(DcgmFvBuffer *fvBuffer)
+{
+    if (!fvBuffer)
+        return;
+
+    std::unique_ptr<DcgmFvBuffer> owned(fvBuffer);
+    owned->Clear();
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_pooled.size() < m_maxPooled)
+    {
+        m_pooled.push_back(std::move(owned));
+    }
+}
+
+/******************************************************************************/
+std::shared_ptr<DcgmFvBuffer const> DcgmFvBufferPool::Share(DcgmFvBuffer *fvBuffer)
+{
+    if (!fvBuffer)
+        return nullptr;
+
+    std::shared_ptr<DcgmFvBufferPool> pool = shared_from_this();
+    return std::shared_ptr<DcgmFvBuffer const>(fvBuffer, [pool](DcgmFvBuffer const *buffer) {
+        pool->Release(const_cast<DcgmFvBuffer *>(buffer));
+    });
+}
+
+/******************************************************************************/
+void DcgmFvBufferPool::SetCapacityHint(size_t capacity)
+{
+    m_capacityHint.store(capacity, std::memory_order_relaxed);
+}
+
+/******************************************************************************/
+size_t DcgmFvBufferPool::NumPooled(void)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_pooled.size();
+}
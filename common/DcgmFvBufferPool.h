@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "DcgmFvBuffer.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+ * Pool of DcgmFvBuffers that are cleared and reused instead of freed, so that
+ * code that buffers field values on every update cycle or injection doesn't
+ * rebuild its buffer from a small capacity each time.
+ *
+ * This class is thread safe. The buffers it hands out are not. See DcgmFvBuffer.
+ * Create pools with std::make_shared if you want to use Share().
+ */
+class DcgmFvBufferPool : public std::enable_shared_from_this<DcgmFvBufferPool>
+{
+public:
+    /**************************************************************************
+     * Constructor
+     *
+     * maxPooled  IN: How many released buffers to keep for reuse. Buffers
+     *                released beyond this are freed
+     */
+    explicit DcgmFvBufferPool(size_t maxPooled = 8);
+
+    /**************************************************************************
+     * Get an empty buffer that can hold at least the capacity hint in bytes.
+     * Pooled buffers are reused before new ones are allocated.
+     *
+     * Returns a buffer to hand back with Release()
+     *         nullptr if we're out of memory
+     */
+    DcgmFvBuffer *Acquire(void);
+
+    /**************************************************************************
+     * Clear a buffer from Acquire() and return it to the pool. NULL is ignored
+     */
+    void Release(DcgmFvBuffer *fvBuffer);
+
+    /**************************************************************************
+     * Hand a filled buffer from Acquire() to any number of readers at once.
+     * The buffer must not be written to after this. It goes back to the pool
+     * when the last reference is dropped, even if that happens after every
+     * other reference to the pool is gone.
+     *
+     * Returns the shared buffer
+     *         nullptr if fvBuffer was NULL
+     */
+    std::shared_ptr<DcgmFvBuffer const> Share(DcgmFvBuffer *fvBuffer);
+
+    /**************************************************************************
+     * Set how many bytes buffers from Acquire() should be able to hold without
+     * growing. Use FVBUFFER_GUESS_INITIAL_CAPACITY to get this number
+     */
+    void SetCapacityHint(size_t capacity);
+
+    /* Number of buffers waiting to be reused */
+    size_t NumPooled(void);
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<DcgmFvBuffer>> m_pooled; /* Released buffers. Protected by m_mutex */
+    size_t m_maxPooled;
+    std::atomic<size_t> m_capacityHint;
+};
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmFvUpdateWorker.h"
+
+/******************************************************************************/
+DcgmFvUpdateWorker::DcgmFvUpdateWorker(Handler_t handler, std::string threadName)
+    : DcgmThread(false, std::move(threadName))
+    , m_handler(std::move(handler))
+    , m_numPosted(0)
+    , m_numHandled(0)
+    , m_stopped(false)
+{}
+
+/******************************************************************************/
+DcgmFvUpdateWorker::~DcgmFvUpdateWorker()
+{
+    StopAndWait(60000);
+}
+
+/******************************************************************************/
+void DcgmFvUpdateWorker::Post(std::shared_ptr<DcgmFvBuffer const> fvBuffer)
+{
+    if (!fvBuffer)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_pending.push_back(std::move(fvBuffer));
+        m_numPosted++;
+    }
+    m_cond.notify_all();
+}
+
+/******************************************************************************/
+void DcgmFvUpdateWorker::Flush(void)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    unsigned long long target = m_numPosted;
+    m_cond.wait(lock, [this, target] { return m_numHandled >= target || m_stopped; });
+}
+
+/******************************************************************************/
+void DcgmFvUpdateWorker::OnStop(void)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stopped = true;
+    }
+    m_cond.notify_all();
+}
+
+/******************************************************************************/
+void DcgmFvUpdateWorker::run(void)
+{
+    std::vector<std::shared_ptr<DcgmFvBuffer const>> batch;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopped)
+    {
+        m_cond.wait(lock, [this] { return !m_pending.empty() || m_stopped; });
+        if (m_stopped)
+            break;
+
+        batch.swap(m_pending);
+        lock.unlock();
+
+        for (auto const &fvBuffer : batch)
+        {
+            m_handler(*fvBuffer);
+        }
+
+        /* Return the buffers to their pool before anyone waiting in Flush() runs */
+        size_t numHandled = batch.size();
+        batch.clear();
+
+        lock.lock();
+        m_numHandled += numHandled;
+        m_cond.notify_all();
+    }
+
+    m_stopped = true;
+    m_cond.notify_all();
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "DcgmFvBuffer.h"
+#include "DcgmThread.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+ * Thread that hands shared field-value snapshots to a module's handler, so
+ * that the cache manager's update thread only has to queue a reference
+ * instead of waiting for every subscriber to walk its values.
+ *
+ * Snapshots are handled one at a time in the order they were posted.
+ */
+class DcgmFvUpdateWorker : public DcgmThread
+{
+public:
+    typedef std::function<void(DcgmFvBuffer const &fvBuffer)> Handler_t;
+
+    /**************************************************************************
+     * Constructor. Call Start() to start handling snapshots
+     *
+     * handler    IN: Called from this thread for each posted snapshot
+     * threadName IN: Name of the thread for debuggers
+     */
+    DcgmFvUpdateWorker(Handler_t handler, std::string threadName);
+
+    /* Stops the thread. Snapshots that weren't handled yet are dropped */
+    ~DcgmFvUpdateWorker() override;
+
+    /**************************************************************************
+     * Queue a snapshot for the handler. Never blocks on the handler
+     */
+    void Post(std::shared_ptr<DcgmFvBuffer const> fvBuffer);
+
+    /**************************************************************************
+     * Wait until every snapshot posted before this call has been handled, so
+     * that a request sees the effect of updates that came before it. Returns
+     * early if the thread is stopping. Start() must have been called.
+     */
+    void Flush(void);
+
+    /* Inherited from DcgmThread */
+    void run(void) override;
+    void OnStop(void) override;
+
+private:
+    Handler_t m_handler;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;                             /* Signalled on posts, completions and stop */
+    std::vector<std::shared_ptr<DcgmFvBuffer const>> m_pending; /* Protected by m_mutex */
+    unsigned long long m_numPosted;                             /* Protected by m_mutex */
+    unsigned long long m_numHandled;                            /* Protected by m_mutex */
+    bool m_stopped;                                             /* Has Stop() been called? Protected by m_mutex */
+};
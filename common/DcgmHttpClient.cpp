@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmHttpClient.h"
+#include "DcgmLogging.h"
+#include "DcgmNumberFormat.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace
+{
+/* Value of header name in the headers of a response, or an empty view */
+std::string_view HeaderValue(std::string_view headers, char const *name)
+{
+    size_t const nameLength = strlen(name);
+    size_t lineStart        = headers.find("\r\n");
+
+    while (lineStart != std::string_view::npos && lineStart + 2 < headers.size())
+    {
+        lineStart += 2;
+        size_t const lineEnd        = headers.find("\r\n", lineStart);
+        std::string_view const line = headers.substr(lineStart, lineEnd - lineStart);
+        if (line.size() > nameLength && line[nameLength] == ':'
+            && strncasecmp(line.data(), name, nameLength) == 0)
+        {
+            std::string_view value = line.substr(nameLength + 1);
+            value.remove_prefix(std::min(value.find_first_not_of(" \t"), value.size()));
+            return value;
+        }
+        lineStart = lineEnd;
+    }
+
+    return {};
+}
+} // namespace
+
+/*****************************************************************************/
+DcgmHttpClient::~DcgmHttpClient()
+{
+    Disconnect();
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHttpClient::SetUrl(std::string const &url)
+{
+    static constexpr std::string_view scheme = "http://";
+
+    if (url.compare(0, scheme.size(), scheme) != 0)
+    {
+        DCGM_LOG_ERROR << "Unable to use URL \"" << url << "\". Only http:// URLs are supported";
+        return DCGM_ST_BADPARAM;
+    }
+
+    std::string_view rest(url);
+    rest.remove_prefix(scheme.size());
+    size_t const pathStart          = std::min(rest.find('/'), rest.size());
+    std::string_view const hostPort = rest.substr(0, pathStart);
+    size_t const colon              = hostPort.rfind(':');
+
+    std::string host(hostPort.substr(0, colon));
+    std::string port = colon == std::string_view::npos ? "80" : std::string(hostPort.substr(colon + 1));
+    long long portNumber = 0;
+    if (host.empty() || !DcgmNs::ParseInt64(port, portNumber) || portNumber <= 0 || portNumber > UINT16_MAX)
+    {
+        DCGM_LOG_ERROR << "Unable to parse URL \"" << url << "\". Expected http://host[:port][/path]";
+        return DCGM_ST_BADPARAM;
+    }
+
+    Disconnect();
+    m_host = std::move(host);
+    m_port = std::move(port);
+    m_path = pathStart == rest.size() ? "/" : std::string(rest.substr(pathStart));
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmHttpClient::Disconnect()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+/*****************************************************************************/
+bool DcgmHttpClient::Connect(int timeoutMs)
+{
+    struct addrinfo hints {};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo *addresses = nullptr;
+    int ret                    = getaddrinfo(m_host.c_str(), m_port.c_str(), &hints, &addresses);
+    if (ret != 0)
+    {
+        DCGM_LOG_ERROR << "Unable to resolve " << m_host << ": " << gai_strerror(ret);
+        return false;
+    }
+
+    struct timeval timeout {};
+    timeout.tv_sec  = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+
+    for (struct addrinfo *address = addresses; address != nullptr && m_fd < 0; address = address->ai_next)
+    {
+        int fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        /* SO_SNDTIMEO also bounds connect() */
+        if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0
+            || setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0
+            || connect(fd, address->ai_addr, address->ai_addrlen) < 0)
+        {
+            close(fd);
+            continue;
+        }
+        m_fd = fd;
+    }
+
+    freeaddrinfo(addresses);
+
+    if (m_fd < 0)
+    {
+        DCGM_LOG_ERROR << "Unable to connect to " << m_host << ":" << m_port << ". errno " << errno;
+        return false;
+    }
+    return true;
+}
+
+/*****************************************************************************/
+int DcgmHttpClient::Exchange(std::string const &request, bool &keepAlive)
+{
+    for (size_t offset = 0; offset < request.size();)
+    {
+        ssize_t sent = send(m_fd, request.data() + offset, request.size() - offset, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            return errno == EPIPE || errno == ECONNRESET ? -1 : 0;
+        }
+        offset += sent;
+    }
+
+    std::string response;
+    size_t headerEnd = std::string::npos;
+    char buffer[4096];
+
+    while (headerEnd == std::string::npos)
+    {
+        ssize_t received = recv(m_fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            return received == 0 && response.empty() ? -1 : 0;
+        }
+        response.append(buffer, received);
+        headerEnd = response.find("\r\n\r\n");
+        if (headerEnd == std::string::npos && response.size() > MAX_RESPONSE_HEADER_BYTES)
+        {
+            DCGM_LOG_ERROR << "The response headers from " << m_host << " are too large";
+            return 0;
+        }
+    }
+
+    std::string_view const headers(response.data(), headerEnd + 2);
+    long long status = 0;
+    if (headers.compare(0, 5, "HTTP/") != 0 || headers.size() < 12
+        || !DcgmNs::ParseInt64(headers.substr(9, 3), status))
+    {
+        DCGM_LOG_ERROR << "Got a malformed response from " << m_host;
+        return 0;
+    }
+
+    /* Drain the body so that the connection can be reused. Without a length only closing it ends the body */
+    long long contentLength            = 0;
+    std::string_view const connection = HeaderValue(headers, "Connection");
+    if (!DcgmNs::ParseInt64(HeaderValue(headers, "Content-Length"), contentLength)
+        || (connection.size() >= 5 && strncasecmp(connection.data(), "close", 5) == 0))
+    {
+        keepAlive = false;
+        return (int)status;
+    }
+
+    long long remaining = contentLength - (long long)(response.size() - headerEnd - 4);
+    while (remaining > 0)
+    {
+        ssize_t received = recv(m_fd, buffer, std::min((long long)sizeof(buffer), remaining), 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            keepAlive = false;
+            break;
+        }
+        remaining -= received;
+    }
+
+    return (int)status;
+}
+
+/*****************************************************************************/
+int DcgmHttpClient::Post(char const *contentType, std::string_view body, int timeoutMs)
+{
+    if (m_host.empty())
+    {
+        return 0;
+    }
+
+    std::string request = "POST " + m_path + " HTTP/1.1\r\nHost: " + m_host + ":" + m_port
+                          + "\r\nContent-Type: " + contentType + "\r\nContent-Length: ";
+    DcgmNs::AppendInt64(request, (long long)body.size());
+    request += "\r\n\r\n";
+    request += body;
+
+    /* An idle kept-alive connection may have been closed by the server. That is worth one retry */
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        bool const reused = m_fd >= 0;
+        if (!reused && !Connect(timeoutMs))
+        {
+            return 0;
+        }
+
+        bool keepAlive   = true;
+        int const status = Exchange(request, keepAlive);
+        if (status <= 0 || !keepAlive)
+        {
+            Disconnect();
+        }
+        if (status > 0)
+        {
+            return status;
+        }
+        if (status == 0 || !reused)
+        {
+            DCGM_LOG_ERROR << "Got no response from " << m_host << ":" << m_port << ". errno " << errno;
+            return 0;
+        }
+    }
+
+    return 0;
+}
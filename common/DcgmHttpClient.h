@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMHTTPCLIENT_H
+#define DCGMHTTPCLIENT_H
+
+#include "dcgm_structs.h"
+
+#include <string>
+#include <string_view>
+
+/*
+ * Minimal blocking HTTP/1.1 client for DCGM to push to a collector, like the
+ * hostengine's OTLP exporter. Plain http:// only.
+ *
+ * The connection is kept open between requests while the server allows it and
+ * reopened once if the server closed it in the meantime.
+ *
+ * A client holds one connection, so it makes one request at a time. The OTLP
+ * exporter sets its URL before starting its thread and only posts from there.
+ */
+class DcgmHttpClient
+{
+public:
+    static constexpr size_t MAX_RESPONSE_HEADER_BYTES = 16384;
+
+    DcgmHttpClient() = default;
+
+    /* Closes the connection */
+    ~DcgmHttpClient();
+
+    DcgmHttpClient(DcgmHttpClient const &) = delete;
+    DcgmHttpClient &operator=(DcgmHttpClient const &) = delete;
+
+    /*************************************************************************/
+    /*
+     * Set where requests go
+     *
+     * url IN: http://host[:port][/path]. The port defaults to 80 and the path to /
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_BADPARAM if url can't be parsed or isn't http://
+     */
+    dcgmReturn_t SetUrl(std::string const &url);
+
+    /*************************************************************************/
+    /*
+     * POST body to the URL and wait for the response. The response body is read and dropped
+     *
+     * contentType IN: Value of the Content-Type header
+     * timeoutMs   IN: How long connecting, sending and receiving may each block
+     *
+     * Returns: The HTTP status of the response, like 200
+     *          0 if no response was received. The reason is logged
+     */
+    int Post(char const *contentType, std::string_view body, int timeoutMs);
+
+private:
+    std::string m_host;
+    std::string m_port;
+    std::string m_path;
+    int m_fd = -1;
+
+    /* Open m_fd. Returns whether it is open */
+    bool Connect(int timeoutMs);
+
+    void Disconnect();
+
+    /*
+     * Send the whole request and read the response
+     *
+     * Returns: The HTTP status of the response
+     *          0 if it failed after the server started responding
+     *          -1 if the server closed the connection before responding, as it does with idle connections
+     */
+    int Exchange(std::string const &request, bool &keepAlive);
+};
+
+#endif // DCGMHTTPCLIENT_H
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmHttpServer.h"
+#include "DcgmLogging.h"
+#include "DcgmNumberFormat.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+int SetNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0)
+    {
+        return -1;
+    }
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+} // namespace
+
+/*****************************************************************************/
+DcgmHttpServer::DcgmHttpServer(Handler handler)
+    : m_handler(std::move(handler))
+    , m_tooLarge(StatusResponse("431 Request Header Fields Too Large"))
+{}
+
+/*****************************************************************************/
+DcgmHttpServer::~DcgmHttpServer()
+{
+    for (auto const &connection : m_connections)
+    {
+        close(connection.fd);
+    }
+    if (m_listenFd >= 0)
+    {
+        close(m_listenFd);
+    }
+}
+
+/*****************************************************************************/
+void DcgmHttpServer::BuildResponse(std::string &out,
+                                   char const *status,
+                                   char const *contentType,
+                                   std::string_view body)
+{
+    out.clear();
+    out += "HTTP/1.1 ";
+    out += status;
+    out += "\r\nContent-Type: ";
+    out += contentType;
+    out += "\r\nConnection: close\r\nContent-Length: ";
+    DcgmNs::AppendInt64(out, (long long)body.size());
+    out += "\r\n\r\n";
+    out += body;
+}
+
+/*****************************************************************************/
+std::string DcgmHttpServer::StatusResponse(char const *status)
+{
+    return std::string("HTTP/1.1 ") + status + "\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHttpServer::Listen(std::string const &address)
+{
+    std::string ip     = "0.0.0.0";
+    std::string port   = address;
+    size_t const colon = address.rfind(':');
+    if (colon != std::string::npos)
+    {
+        ip   = address.substr(0, colon);
+        port = address.substr(colon + 1);
+    }
+
+    long long portNumber = 0;
+    struct sockaddr_in listenAddr {};
+    listenAddr.sin_family = AF_INET;
+    if (!DcgmNs::ParseInt64(port, portNumber) || portNumber < 0 || portNumber > UINT16_MAX
+        || !inet_aton(ip.c_str(), &listenAddr.sin_addr))
+    {
+        DCGM_LOG_ERROR << "Unable to parse HTTP address \"" << address << "\". Expected [ip:]port";
+        return DCGM_ST_BADPARAM;
+    }
+    listenAddr.sin_port = htons((std::uint16_t)portNumber);
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        DCGM_LOG_ERROR << "socket creation failed. errno " << errno;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    int reuseAddrOn   = 1;
+    socklen_t addrLen = sizeof(listenAddr);
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuseAddrOn, sizeof(reuseAddrOn))
+        || bind(fd, (struct sockaddr *)&listenAddr, sizeof(listenAddr)) < 0 || listen(fd, MAX_CONNECTIONS) < 0
+        || getsockname(fd, (struct sockaddr *)&listenAddr, &addrLen) < 0 || SetNonBlocking(fd) < 0)
+    {
+        DCGM_LOG_ERROR << "Unable to listen for HTTP requests on " << address << ". errno " << errno;
+        close(fd);
+        return DCGM_ST_IN_USE;
+    }
+
+    if (m_listenFd >= 0)
+    {
+        close(m_listenFd);
+    }
+    m_listenFd = fd;
+    m_port     = ntohs(listenAddr.sin_port);
+    DCGM_LOG_INFO << "Listening for HTTP requests on " << ip << ":" << m_port;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+bool DcgmHttpServer::SendOrKeep(Connection &connection, char const *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t sent = send(connection.fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            return false;
+        }
+        data += sent;
+        size -= sent;
+    }
+
+    connection.unsent.assign(data, size);
+    return true;
+}
+
+/*****************************************************************************/
+void DcgmHttpServer::AcceptConnections()
+{
+    while (true)
+    {
+        int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+        if (m_connections.size() >= MAX_CONNECTIONS)
+        {
+            DCGM_LOG_WARNING << "Dropping an HTTP connection. Already serving " << m_connections.size();
+            close(fd);
+            continue;
+        }
+        m_connections.push_back({ fd, timelib_usecSince1970(), {}, {}, false });
+    }
+}
+
+/*****************************************************************************/
+bool DcgmHttpServer::ServiceConnection(Connection &connection, short revents)
+{
+    if (connection.responded)
+    {
+        if (revents & (POLLERR | POLLHUP))
+        {
+            return false;
+        }
+        if ((revents & POLLOUT) && !connection.unsent.empty())
+        {
+            std::string unsent;
+            unsent.swap(connection.unsent);
+            if (!SendOrKeep(connection, unsent.data(), unsent.size()))
+            {
+                return false;
+            }
+        }
+        return !connection.unsent.empty();
+    }
+
+    if (!(revents & (POLLIN | POLLERR | POLLHUP)))
+    {
+        return true;
+    }
+
+    char buffer[1024];
+    ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (received <= 0)
+    {
+        return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+    }
+    connection.request.append(buffer, received);
+
+    std::string const *response = &m_tooLarge;
+    if (connection.request.find("\r\n\r\n") != std::string::npos)
+    {
+        /* Request line is "METHOD TARGET VERSION" */
+        std::string_view requestLine(connection.request.data(), connection.request.find("\r\n"));
+        size_t const methodEnd = requestLine.find(' ');
+        size_t const targetEnd = requestLine.find(' ', methodEnd + 1);
+        std::string_view method
+            = methodEnd == std::string_view::npos ? requestLine : requestLine.substr(0, methodEnd);
+        std::string_view target = methodEnd == std::string_view::npos
+                                      ? std::string_view()
+                                      : requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+        response = &m_handler(method, target);
+    }
+    else if (connection.request.size() <= MAX_REQUEST_BYTES)
+    {
+        return true;
+    }
+
+    connection.responded = true;
+    return SendOrKeep(connection, response->data(), response->size()) && !connection.unsent.empty();
+}
+
+/*****************************************************************************/
+void DcgmHttpServer::Poll(int timeoutMs)
+{
+    std::vector<struct pollfd> pollFds;
+    pollFds.reserve(m_connections.size() + 1);
+    pollFds.push_back({ m_listenFd, POLLIN, 0 });
+    for (auto const &connection : m_connections)
+    {
+        pollFds.push_back({ connection.fd, (short)(connection.responded ? POLLOUT : POLLIN), 0 });
+    }
+
+    if (poll(pollFds.data(), pollFds.size(), timeoutMs) < 0)
+    {
+        if (errno != EINTR)
+        {
+            DCGM_LOG_ERROR << "poll failed. errno " << errno;
+        }
+        return;
+    }
+
+    timelib64_t const now = timelib_usecSince1970();
+    std::vector<Connection> kept;
+    kept.reserve(m_connections.size());
+    for (size_t i = 0; i < m_connections.size(); i++)
+    {
+        Connection &connection = m_connections[i];
+        if (ServiceConnection(connection, pollFds[i + 1].revents)
+            && now - connection.acceptedAt < CONNECTION_TIMEOUT_USEC)
+        {
+            kept.push_back(std::move(connection));
+        }
+        else
+        {
+            close(connection.fd);
+        }
+    }
+    m_connections.swap(kept);
+
+    if (pollFds[0].revents & POLLIN)
+    {
+        AcceptConnections();
+    }
+}
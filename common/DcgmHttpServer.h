@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMHTTPSERVER_H
+#define DCGMHTTPSERVER_H
+
+#include "dcgm_structs.h"
+#include "timelib.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Minimal HTTP/1.1 server for the read-only endpoints of DCGM, like the
+ * hostengine's OpenMetrics endpoint and dcgm-rest.
+ *
+ * It is driven by whoever owns it calling Poll() in a loop, so requests are
+ * handled one at a time on that thread. Each connection gets one response and is
+ * then closed. The handler returns a reference to a response it keeps, so a
+ * response that didn't change is sent again without being copied. Only what a
+ * slow client's socket didn't take is copied.
+ *
+ * A server belongs to the thread that polls it: DcgmMetricsExporter's thread in
+ * the hostengine and the main thread of dcgm-rest. Listen() is called before
+ * that thread starts polling. Nothing else is called from other threads.
+ */
+class DcgmHttpServer
+{
+public:
+    static constexpr unsigned int MAX_CONNECTIONS        = 16;
+    static constexpr size_t MAX_REQUEST_BYTES            = 8192;
+    static constexpr timelib64_t CONNECTION_TIMEOUT_USEC = 10000000;
+
+    /*
+     * Build the full response to a request, status line and headers included. See BuildResponse().
+     * The response has to stay valid until the handler is called again
+     *
+     * method IN: Like "GET"
+     * target IN: Path and query string of the request, like "/metrics" or "/dcgmjsonrest?action=getallgpuids"
+     */
+    using Handler = std::function<std::string const &(std::string_view method, std::string_view target)>;
+
+    explicit DcgmHttpServer(Handler handler);
+
+    /* Closes every socket */
+    ~DcgmHttpServer();
+
+    DcgmHttpServer(DcgmHttpServer const &) = delete;
+    DcgmHttpServer &operator=(DcgmHttpServer const &) = delete;
+
+    /*************************************************************************/
+    /*
+     * Bind the listening socket
+     *
+     * address IN: [ip:]port like "9400" or "127.0.0.1:9400". Port 0 picks a free port. See GetPort()
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_BADPARAM if address can't be parsed
+     *          DCGM_ST_IN_USE if the port can't be bound
+     */
+    dcgmReturn_t Listen(std::string const &address);
+
+    /* Port Listen() bound. 0 before Listen() */
+    std::uint16_t GetPort() const
+    {
+        return m_port;
+    }
+
+    /*
+     * Wait up to timeoutMs for sockets to be ready, then accept connections, read
+     * requests and send responses
+     */
+    void Poll(int timeoutMs);
+
+    /*************************************************************************/
+    /*
+     * Replace out with a response with body. The Connection and Content-Length headers are added
+     *
+     * status      IN: Like "200 OK"
+     * contentType IN: Value of the Content-Type header
+     */
+    static void BuildResponse(std::string &out, char const *status, char const *contentType, std::string_view body);
+
+    /* Response with no body, like for a 404 */
+    static std::string StatusResponse(char const *status);
+
+private:
+    struct Connection
+    {
+        int fd;
+        timelib64_t acceptedAt;
+        std::string request; /* Read so far */
+        std::string unsent;  /* Rest of the response the socket didn't take */
+        bool responded;
+    };
+
+    Handler m_handler;
+    int m_listenFd       = -1;
+    std::uint16_t m_port = 0;
+    std::vector<Connection> m_connections;
+    std::string m_tooLarge; /* Response to requests past MAX_REQUEST_BYTES */
+
+    /* Accept every pending connection */
+    void AcceptConnections();
+
+    /* Read from and write to connection. Returns false once it should be closed */
+    bool ServiceConnection(Connection &connection, short revents);
+
+    /* Send as much of data as the socket takes and keep the rest. Returns false on error */
+    static bool SendOrKeep(Connection &connection, char const *data, size_t size);
+};
+
+#endif // DCGMHTTPSERVER_H
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmLogAsyncAppender.h"
+
+#include <chrono>
+#include <sstream>
+#include <strings.h>
+
+namespace DcgmNs::Logging
+{
+namespace
+{
+    /* How long the writer sleeps when there was nothing to write. Bounds the delay of a record in a quiet ring */
+    constexpr auto WRITER_IDLE_WAIT = std::chrono::milliseconds(10);
+
+    /* How long a thread waits for room with AsyncOverflowPolicy::Block before checking again */
+    constexpr auto BLOCKED_WAIT = std::chrono::microseconds(100);
+
+    /* Room kept in each slot so that typical records are copied without allocating */
+    constexpr size_t RESERVED_MESSAGE_LENGTH = 256;
+
+    std::atomic<std::uint64_t> g_nextAppenderId { 1 };
+
+    struct ThreadRingRef
+    {
+        std::uint64_t appenderId;
+        std::shared_ptr<void> ring;
+    };
+
+    /* Rings of the calling thread. The appenders keep them alive after the thread exits until they are drained */
+    thread_local std::vector<ThreadRingRef> t_rings;
+
+    /* plog::Record of a record that went through a ring */
+    class ReplayedRecord : public plog::Record
+    {
+    public:
+        ReplayedRecord(char const *message,
+                       char const *func,
+                       char const *file,
+                       plog::Severity severity,
+                       std::size_t line,
+                       void const *object,
+                       plog::util::Time const &time,
+                       unsigned int tid)
+            : plog::Record(severity, func, line, file, object)
+            , m_message(message)
+            , m_time(time)
+            , m_tid(tid)
+        {}
+
+        plog::util::Time const &getTime() const override
+        {
+            return m_time;
+        }
+
+        unsigned int getTid() const override
+        {
+            return m_tid;
+        }
+
+        plog::util::nchar const *getMessage() const override
+        {
+            return m_message;
+        }
+
+    private:
+        char const *m_message;
+        plog::util::Time m_time;
+        unsigned int m_tid;
+    };
+} // namespace
+
+/*****************************************************************************/
+AsyncAppender::Ring::Ring(size_t capacity)
+    : m_records(new QueuedRecord[capacity])
+    , m_capacity(capacity)
+    , m_head(0)
+    , m_tail(0)
+{
+    for (size_t i = 0; i < m_capacity; i++)
+    {
+        m_records[i].message.reserve(RESERVED_MESSAGE_LENGTH);
+    }
+}
+
+/*****************************************************************************/
+bool AsyncAppender::Ring::TryPush(plog::Record const &record)
+{
+    size_t const head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= m_capacity)
+    {
+        return false;
+    }
+
+    QueuedRecord &slot = m_records[head % m_capacity];
+    slot.severity      = record.getSeverity();
+    slot.time          = record.getTime();
+    slot.tid           = record.getTid();
+    slot.line          = record.getLine();
+    slot.object        = record.getObject();
+    slot.func.assign(record.getFunc());
+    slot.file.assign(record.getFile());
+    slot.message.assign(record.getMessage());
+
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+/*****************************************************************************/
+AsyncAppender::QueuedRecord *AsyncAppender::Ring::Front()
+{
+    size_t const tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    return &m_records[tail % m_capacity];
+}
+
+/*****************************************************************************/
+void AsyncAppender::Ring::Pop()
+{
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/*****************************************************************************/
+size_t AsyncAppender::Ring::Size() const
+{
+    size_t const tail = m_tail.load(std::memory_order_acquire);
+    return m_head.load(std::memory_order_acquire) - tail;
+}
+
+/*****************************************************************************/
+AsyncAppender::AsyncAppender(std::unique_ptr<plog::IAppender> target,
+                             AsyncOverflowPolicy policy,
+                             size_t recordsPerThread)
+    : m_target(std::move(target))
+    , m_policy(policy)
+    , m_recordsPerThread(recordsPerThread == 0 ? DCGM_LOGGING_ASYNC_DEFAULT_RECORDS : recordsPerThread)
+    , m_id(g_nextAppenderId.fetch_add(1, std::memory_order_relaxed))
+    , m_stop(false)
+    , m_draining(false)
+    , m_drainPasses(0)
+    , m_dropped(0)
+    , m_droppedReported(0)
+{
+    m_writer = std::thread(&AsyncAppender::WriterMain, this);
+}
+
+/*****************************************************************************/
+AsyncAppender::~AsyncAppender()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeWriter.notify_one();
+    m_writer.join();
+}
+
+/*****************************************************************************/
+bool AsyncAppender::PolicyFromString(std::string const &str, AsyncOverflowPolicy &policy)
+{
+    if (strcasecmp(str.c_str(), DCGM_LOGGING_ASYNC_STRING_DROP) == 0)
+    {
+        policy = AsyncOverflowPolicy::Drop;
+        return true;
+    }
+    if (strcasecmp(str.c_str(), DCGM_LOGGING_ASYNC_STRING_BLOCK) == 0)
+    {
+        policy = AsyncOverflowPolicy::Block;
+        return true;
+    }
+    return false;
+}
+
+/*****************************************************************************/
+std::uint64_t AsyncAppender::GetDroppedCount() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+AsyncAppender::Ring &AsyncAppender::GetThreadRing()
+{
+    for (auto const &ref : t_rings)
+    {
+        if (ref.appenderId == m_id)
+        {
+            return *static_cast<Ring *>(ref.ring.get());
+        }
+    }
+
+    auto ring = std::make_shared<Ring>(m_recordsPerThread);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_rings.push_back(ring);
+    }
+    t_rings.push_back(ThreadRingRef { m_id, ring });
+    return *ring;
+}
+
+/*****************************************************************************/
+void AsyncAppender::write(plog::Record const &record)
+{
+    if (std::this_thread::get_id() == m_writer.get_id())
+    {
+        /* Logged by the target itself. Queueing it could wait on this very thread */
+        m_target->write(record);
+        return;
+    }
+
+    Ring &ring = GetThreadRing();
+
+    while (!ring.TryPush(record))
+    {
+        if (m_policy == AsyncOverflowPolicy::Drop)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        m_wakeWriter.notify_one();
+        std::this_thread::sleep_for(BLOCKED_WAIT);
+    }
+
+    if (record.getSeverity() == plog::fatal)
+    {
+        Flush();
+    }
+    else if (ring.Size() >= ring.Capacity() / 2)
+    {
+        /* Don't wait for the writer to wake up by itself when the ring is filling up */
+        m_wakeWriter.notify_one();
+    }
+}
+
+/*****************************************************************************/
+void AsyncAppender::Flush()
+{
+    if (std::this_thread::get_id() == m_writer.get_id())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    /* A pass that is running now may have missed records queued just before this call. The next one won't */
+    std::uint64_t const drainedBy = m_drainPasses + (m_draining ? 2 : 1);
+
+    m_wakeWriter.notify_one();
+    m_drained.wait(lock, [this, drainedBy] { return m_drainPasses >= drainedBy || m_stop; });
+}
+
+/*****************************************************************************/
+size_t AsyncAppender::Drain(std::vector<std::shared_ptr<Ring>> const &rings)
+{
+    size_t written = 0;
+
+    for (auto const &ring : rings)
+    {
+        /* Only take what is there now, so that a busy thread can't keep the writer from the other rings */
+        size_t const count = ring->Size();
+        for (size_t i = 0; i < count; i++)
+        {
+            QueuedRecord *queued = ring->Front();
+            ReplayedRecord record(queued->message.c_str(),
+                                  queued->func.c_str(),
+                                  queued->file.c_str(),
+                                  queued->severity,
+                                  queued->line,
+                                  queued->object,
+                                  queued->time,
+                                  queued->tid);
+            m_target->write(record);
+            ring->Pop();
+        }
+        written += count;
+    }
+
+    return written;
+}
+
+/*****************************************************************************/
+void AsyncAppender::ReportDrops()
+{
+    std::uint64_t const dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped == m_droppedReported)
+    {
+        return;
+    }
+
+    std::ostringstream ss;
+    ss << "Dropped " << (dropped - m_droppedReported) << " log records because a logging thread filled its "
+       << m_recordsPerThread << " record ring. " << dropped << " were dropped in total.";
+    m_droppedReported = dropped;
+
+    std::string const message = ss.str();
+    plog::util::Time now;
+    plog::util::ftime(&now);
+    ReplayedRecord record(
+        message.c_str(), __FUNCTION__, __FILE__, plog::warning, __LINE__, nullptr, now, plog::util::gettid());
+    m_target->write(record);
+}
+
+/*****************************************************************************/
+void AsyncAppender::WriterMain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        std::vector<std::shared_ptr<Ring>> rings = m_rings;
+        m_draining = true;
+        lock.unlock();
+
+        size_t const written = Drain(rings);
+        ReportDrops();
+        rings.clear();
+
+        lock.lock();
+        m_draining = false;
+
+        /* Forget the rings of threads that exited once they are empty */
+        for (auto it = m_rings.begin(); it != m_rings.end();)
+        {
+            if (it->use_count() == 1 && (*it)->Size() == 0)
+            {
+                it = m_rings.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        m_drainPasses++;
+        m_drained.notify_all();
+
+        if (written == 0)
+        {
+            if (m_stop)
+            {
+                break;
+            }
+            m_wakeWriter.wait_for(lock, WRITER_IDLE_WAIT);
+        }
+    }
+}
+
+} // namespace DcgmNs::Logging
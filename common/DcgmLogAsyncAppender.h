@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <plog/Log.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Records each thread can have queued for the writer when no size is given */
+#define DCGM_LOGGING_ASYNC_DEFAULT_RECORDS 4096
+
+#define DCGM_LOGGING_ASYNC_STRING_DROP  "drop"
+#define DCGM_LOGGING_ASYNC_STRING_BLOCK "block"
+
+namespace DcgmNs::Logging
+{
+/* What a logging thread does when its ring is full */
+enum class AsyncOverflowPolicy
+{
+    Drop,  /* Throw the record away and count it. The thread never waits */
+    Block, /* Wait for the writer to make room. No record is lost */
+};
+
+/*****************************************************************************/
+/*
+ * Appender that moves the formatting and I/O of another appender off the
+ * logging threads. Each logging thread copies its records into a ring of its
+ * own, without taking a lock, and a background writer drains the rings into
+ * the target appender.
+ *
+ * Records of one thread keep their order. Records of different threads are
+ * written in the order the writer finds them, so the timestamps in the log can
+ * be slightly out of order across threads.
+ *
+ * Fatal records are flushed before write() returns so that they are on disk if
+ * the process goes down right after.
+ */
+class AsyncAppender : public plog::IAppender
+{
+public:
+    /*************************************************************************/
+    /*
+     * target:           Appender to write the records to. Owned by this
+     * policy:           What to do with records that don't fit in the ring of
+     *                   their thread
+     * recordsPerThread: Records each thread can have queued. 0 =
+     *                   DCGM_LOGGING_ASYNC_DEFAULT_RECORDS
+     */
+    AsyncAppender(std::unique_ptr<plog::IAppender> target, AsyncOverflowPolicy policy, size_t recordsPerThread);
+
+    /* Writes the records still queued and stops the writer */
+    ~AsyncAppender() override;
+
+    void write(plog::Record const &record) override;
+
+    /* Wait until the records queued before this call are written */
+    void Flush();
+
+    /* Number of records thrown away by AsyncOverflowPolicy::Drop */
+    std::uint64_t GetDroppedCount() const;
+
+    /* Parse DCGM_LOGGING_ASYNC_STRING_*. Returns false if str is neither */
+    static bool PolicyFromString(std::string const &str, AsyncOverflowPolicy &policy);
+
+    AsyncAppender(AsyncAppender const &) = delete;
+    AsyncAppender &operator=(AsyncAppender const &) = delete;
+
+private:
+    struct QueuedRecord
+    {
+        plog::Severity severity;
+        plog::util::Time time;
+        unsigned int tid;
+        std::size_t line;
+        void const *object;
+        std::string func;
+        std::string file;
+        std::string message;
+    };
+
+    /* Ring written by one logging thread and read by the writer */
+    class Ring
+    {
+    public:
+        explicit Ring(size_t capacity);
+
+        bool TryPush(plog::Record const &record);
+
+        /* Oldest record or nullptr if empty. Only valid until Pop() */
+        QueuedRecord *Front();
+        void Pop();
+
+        size_t Size() const;
+
+        size_t Capacity() const
+        {
+            return m_capacity;
+        }
+
+    private:
+        std::unique_ptr<QueuedRecord[]> m_records;
+        size_t m_capacity;
+        alignas(64) std::atomic<size_t> m_head; /* Next slot to write. Only moved by the logging thread */
+        alignas(64) std::atomic<size_t> m_tail; /* Next slot to read. Only moved by the writer */
+    };
+
+    Ring &GetThreadRing();
+    void WriterMain();
+    size_t Drain(std::vector<std::shared_ptr<Ring>> const &rings);
+    void ReportDrops();
+
+    std::unique_ptr<plog::IAppender> m_target;
+    AsyncOverflowPolicy m_policy;
+    size_t m_recordsPerThread;
+    std::uint64_t m_id; /* Tells apart the rings of different appenders in the same thread */
+
+    std::mutex m_mutex; /* Guards the members up to m_drainPasses */
+    std::condition_variable m_wakeWriter;
+    std::condition_variable m_drained;
+    std::vector<std::shared_ptr<Ring>> m_rings;
+    bool m_stop;
+    bool m_draining; /* The writer is in Drain() */
+    std::uint64_t m_drainPasses;
+
+    std::atomic<std::uint64_t> m_dropped;
+    std::uint64_t m_droppedReported; /* Only used by the writer */
+    std::thread m_writer;
+};
+
+} // namespace DcgmNs::Logging
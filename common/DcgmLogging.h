@@ -24,6 +24,8 @@
 // before syslog if we don't want those overwritten by plog
 #include <plog/Log.h>
 
+#include "DcgmLogAsyncAppender.h"
+
 #include <atomic>
 #include <cstdio>
 #include <dcgm_structs.h>
@@ -50,6 +52,10 @@
  *
  * DCGM_LOGGING_SEVERITY_INFO_TO(MY_LOGGER) << "This will not be logged";
  * DCGM_LOGGING_SEVERITY_WARNING_TO(MY_LOGGER) << "This will be logged";
+ *
+ * // Write the log file from a background thread. Records that don't fit in
+ * // the ring of their thread are dropped ("drop") or waited on ("block")
+ * DcgmLogging::init("destination_file", DEFAULT_SEVERITY, DCGM_LOGGING_ASYNC_STRING_DROP);
  */
 
 #define DCGM_LOGGING_SEVERITY_OPTIONS "NONE, FATAL, ERROR, WARN, INFO, DEBUG, VERB"
@@ -142,40 +148,89 @@ DCGM_CASSERT(DcgmLoggingSeverityInfo == (DcgmLoggingSeverity_t)plog::info, 1);
 DCGM_CASSERT(DcgmLoggingSeverityDebug == (DcgmLoggingSeverity_t)plog::debug, 1);
 DCGM_CASSERT(DcgmLoggingSeverityVerbose == (DcgmLoggingSeverity_t)plog::verbose, 1);
 
-#define DCGM_LOG_VERBOSE_TO(logger) LOG_(logger, plog::verbose)
-#define DCGM_LOG_DEBUG_TO(logger)   LOG_(logger, plog::debug)
-#define DCGM_LOG_INFO_TO(logger)    LOG_(logger, plog::info)
-#define DCGM_LOG_WARNING_TO(logger) LOG_(logger, plog::warning)
-#define DCGM_LOG_ERROR_TO(logger)   LOG_(logger, plog::error)
-#define DCGM_LOG_FATAL_TO(logger)   LOG_(logger, plog::fatal)
-
-#define DCGM_LOG_VERBOSE LOG_(BASE_LOGGER, plog::verbose)
-#define DCGM_LOG_DEBUG   LOG_(BASE_LOGGER, plog::debug)
-#define DCGM_LOG_INFO    LOG_(BASE_LOGGER, plog::info)
-#define DCGM_LOG_WARNING LOG_(BASE_LOGGER, plog::warning)
-#define DCGM_LOG_ERROR   LOG_(BASE_LOGGER, plog::error)
-#define DCGM_LOG_FATAL   LOG_(BASE_LOGGER, plog::fatal)
-
-#define IF_DCGM_LOG_VERBOSE IF_LOG_(BASE_LOGGER, plog::verbose)
-#define IF_DCGM_LOG_DEBUG   IF_LOG_(BASE_LOGGER, plog::debug)
-#define IF_DCGM_LOG_INFO    IF_LOG_(BASE_LOGGER, plog::info)
-#define IF_DCGM_LOG_WARNING IF_LOG_(BASE_LOGGER, plog::warning)
-#define IF_DCGM_LOG_ERROR   IF_LOG_(BASE_LOGGER, plog::error)
-#define IF_DCGM_LOG_FATAL   IF_LOG_(BASE_LOGGER, plog::fatal)
-
-#define DCGM_LOG_SYSLOG_DEBUG    LOG_(SYSLOG_LOGGER, plog::verbose)
-#define DCGM_LOG_SYSLOG_INFO     LOG_(SYSLOG_LOGGER, plog::debug)
-#define DCGM_LOG_SYSLOG_NOTICE   LOG_(SYSLOG_LOGGER, plog::info)
-#define DCGM_LOG_SYSLOG_WARNING  LOG_(SYSLOG_LOGGER, plog::warning)
-#define DCGM_LOG_SYSLOG_ERROR    LOG_(SYSLOG_LOGGER, plog::error)
-#define DCGM_LOG_SYSLOG_CRITICAL LOG_(SYSLOG_LOGGER, plog::fatal)
-
-#define IF_DCGM_LOG_SYSLOG_DEBUG    IF_LOG_(SYSLOG_LOGGER, plog::verbose)
-#define IF_DCGM_LOG_SYSLOG_INFO     IF_LOG_(SYSLOG_LOGGER, plog::debug)
-#define IF_DCGM_LOG_SYSLOG_NOTICE   IF_LOG_(SYSLOG_LOGGER, plog::info)
-#define IF_DCGM_LOG_SYSLOG_WARNING  IF_LOG_(SYSLOG_LOGGER, plog::warning)
-#define IF_DCGM_LOG_SYSLOG_ERROR    IF_LOG_(SYSLOG_LOGGER, plog::error)
-#define IF_DCGM_LOG_SYSLOG_CRITICAL IF_LOG_(SYSLOG_LOGGER, plog::fatal)
+/*
+ * Most verbose severity that is compiled in. Statements above it are removed
+ * by the compiler, arguments and all. Builds can lower it, e.g.
+ * -DDCGM_LOGGING_MAX_COMPILED_SEVERITY=plog::info
+ */
+#ifndef DCGM_LOGGING_MAX_COMPILED_SEVERITY
+#define DCGM_LOGGING_MAX_COMPILED_SEVERITY plog::verbose
+#endif
+
+namespace DcgmNs::Logging
+{
+/*
+ * Max severity of each logger, kept next to plog's own so that a disabled
+ * statement costs one relaxed load before anything else is evaluated. Set with
+ * the plog severity by DcgmLogging. plog::none until the logger is initialized
+ */
+inline std::atomic<int> g_maxSeverity[SYSLOG_LOGGER + 1] = { plog::none, plog::none };
+
+template <loggerCategory_t logger>
+inline bool IsLogEnabled(plog::Severity severity)
+{
+    return severity <= DCGM_LOGGING_MAX_COMPILED_SEVERITY
+           && severity <= g_maxSeverity[logger].load(std::memory_order_relaxed);
+}
+
+template <loggerCategory_t logger>
+inline void SetMaxSeverity(plog::Severity severity)
+{
+    g_maxSeverity[logger].store(severity, std::memory_order_relaxed);
+}
+} // namespace DcgmNs::Logging
+
+/* Like plog's IF_LOG_ and LOG_, but check the severity before touching plog */
+#define DCGM_IF_LOG_(logger, severity)                    \
+    if (!DcgmNs::Logging::IsLogEnabled<logger>(severity)) \
+    {                                                     \
+        ;                                                 \
+    }                                                     \
+    else                                                  \
+        IF_LOG_(logger, severity)
+
+#define DCGM_LOG_(logger, severity)                       \
+    if (!DcgmNs::Logging::IsLogEnabled<logger>(severity)) \
+    {                                                     \
+        ;                                                 \
+    }                                                     \
+    else                                                  \
+        LOG_(logger, severity)
+
+#define DCGM_LOG_VERBOSE_TO(logger) DCGM_LOG_(logger, plog::verbose)
+#define DCGM_LOG_DEBUG_TO(logger)   DCGM_LOG_(logger, plog::debug)
+#define DCGM_LOG_INFO_TO(logger)    DCGM_LOG_(logger, plog::info)
+#define DCGM_LOG_WARNING_TO(logger) DCGM_LOG_(logger, plog::warning)
+#define DCGM_LOG_ERROR_TO(logger)   DCGM_LOG_(logger, plog::error)
+#define DCGM_LOG_FATAL_TO(logger)   DCGM_LOG_(logger, plog::fatal)
+
+#define DCGM_LOG_VERBOSE DCGM_LOG_(BASE_LOGGER, plog::verbose)
+#define DCGM_LOG_DEBUG   DCGM_LOG_(BASE_LOGGER, plog::debug)
+#define DCGM_LOG_INFO    DCGM_LOG_(BASE_LOGGER, plog::info)
+#define DCGM_LOG_WARNING DCGM_LOG_(BASE_LOGGER, plog::warning)
+#define DCGM_LOG_ERROR   DCGM_LOG_(BASE_LOGGER, plog::error)
+#define DCGM_LOG_FATAL   DCGM_LOG_(BASE_LOGGER, plog::fatal)
+
+#define IF_DCGM_LOG_VERBOSE DCGM_IF_LOG_(BASE_LOGGER, plog::verbose)
+#define IF_DCGM_LOG_DEBUG   DCGM_IF_LOG_(BASE_LOGGER, plog::debug)
+#define IF_DCGM_LOG_INFO    DCGM_IF_LOG_(BASE_LOGGER, plog::info)
+#define IF_DCGM_LOG_WARNING DCGM_IF_LOG_(BASE_LOGGER, plog::warning)
+#define IF_DCGM_LOG_ERROR   DCGM_IF_LOG_(BASE_LOGGER, plog::error)
+#define IF_DCGM_LOG_FATAL   DCGM_IF_LOG_(BASE_LOGGER, plog::fatal)
+
+#define DCGM_LOG_SYSLOG_DEBUG    DCGM_LOG_(SYSLOG_LOGGER, plog::verbose)
+#define DCGM_LOG_SYSLOG_INFO     DCGM_LOG_(SYSLOG_LOGGER, plog::debug)
+#define DCGM_LOG_SYSLOG_NOTICE   DCGM_LOG_(SYSLOG_LOGGER, plog::info)
+#define DCGM_LOG_SYSLOG_WARNING  DCGM_LOG_(SYSLOG_LOGGER, plog::warning)
+#define DCGM_LOG_SYSLOG_ERROR    DCGM_LOG_(SYSLOG_LOGGER, plog::error)
+#define DCGM_LOG_SYSLOG_CRITICAL DCGM_LOG_(SYSLOG_LOGGER, plog::fatal)
+
+#define IF_DCGM_LOG_SYSLOG_DEBUG    DCGM_IF_LOG_(SYSLOG_LOGGER, plog::verbose)
+#define IF_DCGM_LOG_SYSLOG_INFO     DCGM_IF_LOG_(SYSLOG_LOGGER, plog::debug)
+#define IF_DCGM_LOG_SYSLOG_NOTICE   DCGM_IF_LOG_(SYSLOG_LOGGER, plog::info)
+#define IF_DCGM_LOG_SYSLOG_WARNING  DCGM_IF_LOG_(SYSLOG_LOGGER, plog::warning)
+#define IF_DCGM_LOG_SYSLOG_ERROR    DCGM_IF_LOG_(SYSLOG_LOGGER, plog::error)
+#define IF_DCGM_LOG_SYSLOG_CRITICAL DCGM_IF_LOG_(SYSLOG_LOGGER, plog::fatal)
 
 namespace
 {
@@ -194,7 +249,7 @@ void OldLoggerAdapter(char *outBuffer, size_t bufSize, char const * /*unused*/,
 #undef PRINT_CRITICAL
 #define PRINT_CRITICAL(...)                                                              \
     {                                                                                    \
-        IF_LOG_(BASE_LOGGER, plog::fatal)                                                \
+        DCGM_IF_LOG_(BASE_LOGGER, plog::fatal)                                           \
         {                                                                                \
             char _dcgm_logging_buf[4096];                                                \
             OldLoggerAdapter(_dcgm_logging_buf, sizeof(_dcgm_logging_buf), __VA_ARGS__); \
@@ -205,7 +260,7 @@ void OldLoggerAdapter(char *outBuffer, size_t bufSize, char const * /*unused*/,
 #undef PRINT_ERROR
 #define PRINT_ERROR(...)                                                                 \
     {                                                                                    \
-        IF_LOG_(BASE_LOGGER, plog::error)                                                \
+        DCGM_IF_LOG_(BASE_LOGGER, plog::error)                                           \
         {                                                                                \
             char _dcgm_logging_buf[4096];                                                \
             OldLoggerAdapter(_dcgm_logging_buf, sizeof(_dcgm_logging_buf), __VA_ARGS__); \
@@ -216,7 +271,7 @@ void OldLoggerAdapter(char *outBuffer, size_t bufSize, char const * /*unused*/,
 #undef PRINT_WARNING
 #define PRINT_WARNING(...)                                                               \
     {                                                                                    \
-        IF_LOG_(BASE_LOGGER, plog::warning)                                              \
+        DCGM_IF_LOG_(BASE_LOGGER, plog::warning)                                         \
         {                                                                                \
             char _dcgm_logging_buf[4096];                                                \
             OldLoggerAdapter(_dcgm_logging_buf, sizeof(_dcgm_logging_buf), __VA_ARGS__); \
@@ -227,7 +282,7 @@ void OldLoggerAdapter(char *outBuffer, size_t bufSize, char const * /*unused*/,
 #undef PRINT_INFO
 #define PRINT_INFO(...)                                                                  \
     {                                                                                    \
-        IF_LOG_(BASE_LOGGER, plog::info)                                                 \
+        DCGM_IF_LOG_(BASE_LOGGER, plog::info)                                            \
         {                                                                                \
             char _dcgm_logging_buf[4096];                                                \
             OldLoggerAdapter(_dcgm_logging_buf, sizeof(_dcgm_logging_buf), __VA_ARGS__); \
@@ -241,7 +296,7 @@ void OldLoggerAdapter(char *outBuffer, size_t bufSize, char const * /*unused*/,
 #undef PRINT_DEBUG
 #define PRINT_DEBUG(...)                                                                 \
     {                                                                                    \
-        IF_LOG_(BASE_LOGGER, plog::debug)                                                \
+        DCGM_IF_LOG_(BASE_LOGGER, plog::debug)                                           \
         {                                                                                \
             char _dcgm_logging_buf[1024];                                                \
             OldLoggerAdapter(_dcgm_logging_buf, sizeof(_dcgm_logging_buf), __VA_ARGS__); \
@@ -355,24 +410,53 @@ public:
     DcgmLogging(const DcgmLogging &other) = delete;
     DcgmLogging &operator=(const DcgmLogging &other) = delete;
 
-    static void init(const char *logFile, const DcgmLoggingSeverity_t severity)
+    /**
+     * asyncPolicy: DCGM_LOGGING_ASYNC_STRING_DROP or DCGM_LOGGING_ASYNC_STRING_BLOCK to write the log file
+     *              from a background thread. Empty = write it on the logging threads
+     */
+    static void init(const char *logFile, const DcgmLoggingSeverity_t severity, std::string const &asyncPolicy = "")
     {
         if (!singletonInstance.m_loggingInitialized.load(std::memory_order_relaxed))
         {
             std::lock_guard<std::mutex> guard(singletonInstance.m_loggerMutex);
             if (!singletonInstance.m_loggingInitialized.load(std::memory_order_relaxed))
             {
-                singletonInstance.Initialize(logFile, severity);
+                singletonInstance.Initialize(logFile, severity, asyncPolicy);
                 return;
             }
         }
         DCGM_LOG_DEBUG << "Logger already initialized -- skipped second initialization";
     }
 
+    /**
+     * Wait until the records logged so far are written when the log file is written asynchronously
+     */
+    static void flush()
+    {
+        if (singletonInstance.m_asyncAppender != nullptr)
+        {
+            singletonInstance.m_asyncAppender->Flush();
+        }
+    }
+
+    /**
+     * Number of records dropped because a logging thread filled its ring. Always 0 for synchronous logging
+     */
+    static std::uint64_t getDroppedRecordCount()
+    {
+        if (singletonInstance.m_asyncAppender != nullptr)
+        {
+            return singletonInstance.m_asyncAppender->GetDroppedCount();
+        }
+        return 0;
+    }
+
     static void initLogToHostengine(const DcgmLoggingSeverity_t severity)
     {
         plog::init<BASE_LOGGER>((plog::Severity)severity, &hostengineAppender);
         plog::init<SYSLOG_LOGGER>((plog::Severity)severity, &syslogAppender);
+        DcgmNs::Logging::SetMaxSeverity<BASE_LOGGER>((plog::Severity)severity);
+        DcgmNs::Logging::SetMaxSeverity<SYSLOG_LOGGER>((plog::Severity)severity);
     }
 
     static void setHostEngineCallback(hostEngineAppenderCallbackFp_t callback)
@@ -501,6 +585,7 @@ public:
         }
 
         plog::get<logger>()->setMaxSeverity((plog::Severity)severity);
+        DcgmNs::Logging::SetMaxSeverity<logger>((plog::Severity)severity);
         return 0;
     }
 
@@ -585,33 +670,59 @@ public:
         return helperGetLogSettingFromArgAndEnv(arg, defaultValue, envPrefix, "LVL");
     }
 
+    static std::string getLogAsyncPolicyFromArgAndEnv(const std::string &arg,
+                                                      const std::string &defaultValue,
+                                                      const std::string &envPrefix)
+    {
+        return helperGetLogSettingFromArgAndEnv(arg, defaultValue, envPrefix, "ASYNC");
+    }
+
 private:
     static DcgmLogging singletonInstance;
     // Not really unique_ptr as they are used in plog as well. We are using
     // unique_ptr to manage lifetime only so we don't have to write a destructor
     std::vector<std::unique_ptr<plog::IAppender>> m_appenders;
+    DcgmNs::Logging::AsyncAppender *m_asyncAppender = nullptr; //!< Owned by m_appenders
     std::atomic<bool> m_loggingInitialized = false;
     std::mutex m_severityMutex;
     std::mutex m_loggerMutex;
     DcgmLogging() = default;
 
-    void Initialize(const char *logFile, const DcgmLoggingSeverity_t severity)
+    void Initialize(const char *logFile, const DcgmLoggingSeverity_t severity, std::string const &asyncPolicy)
     {
-        InitLogger<BASE_LOGGER>(logFile, (plog::Severity)severity);
+        InitLogger<BASE_LOGGER>(logFile, (plog::Severity)severity, asyncPolicy);
         plog::init<SYSLOG_LOGGER>((plog::Severity)severity, &syslogAppender);
+        DcgmNs::Logging::SetMaxSeverity<SYSLOG_LOGGER>((plog::Severity)severity);
 
         m_loggingInitialized = true;
+
+        if (!asyncPolicy.empty() && m_asyncAppender == nullptr)
+        {
+            DCGM_LOG_WARNING << "Ignoring asynchronous logging policy '" << asyncPolicy << "'. Expected "
+                             << DCGM_LOGGING_ASYNC_STRING_DROP << " or " << DCGM_LOGGING_ASYNC_STRING_BLOCK
+                             << ", and a log file.";
+        }
     }
 
     template <loggerCategory_t logger = BASE_LOGGER>
-    int InitLogger(const char *logFile, plog::Severity severity)
+    int InitLogger(const char *logFile, plog::Severity severity, std::string const &asyncPolicy = "")
     {
         plog::IAppender *appender;
+        DcgmNs::Logging::AsyncOverflowPolicy overflowPolicy;
 
         if (strncmp(DCGM_LOGGING_CONSTANT_HYPHEN, logFile, sizeof(DCGM_LOGGING_CONSTANT_HYPHEN)) == 0)
         {
             appender = &consoleAppender;
         }
+        else if (DcgmNs::Logging::AsyncAppender::PolicyFromString(asyncPolicy, overflowPolicy))
+        {
+            std::unique_ptr<plog::IAppender> fileAppender
+                = std::make_unique<plog::RollingFileAppender<DcgmLogFormatter<PlogSeverityMapper>>>(logFile);
+            m_asyncAppender = new DcgmNs::Logging::AsyncAppender(
+                std::move(fileAppender), overflowPolicy, DCGM_LOGGING_ASYNC_DEFAULT_RECORDS);
+            appender = m_asyncAppender;
+            m_appenders.push_back(std::unique_ptr<plog::IAppender>(appender));
+        }
         else
         {
             appender = new plog::RollingFileAppender<DcgmLogFormatter<PlogSeverityMapper>>(logFile);
@@ -619,6 +730,7 @@ private:
         }
 
         plog::init<logger>(severity, appender);
+        DcgmNs::Logging::SetMaxSeverity<logger>(severity);
         return 0;
     }
 };
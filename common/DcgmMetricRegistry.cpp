@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmMetricRegistry.h"
+#include "DcgmNumberFormat.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+
+namespace DcgmNs
+{
+namespace
+{
+    /* Same tags as DcgmStatCollection's g_entityJsonTags */
+    char const *const g_scopeJsonTags[] = { "globals", "gpus", "switches", "vgpus" };
+
+    void AppendSampleJson(std::string &out, timelib64_t timestamp)
+    {
+        out += "{\"timestamp\":";
+        AppendInt64(out, timestamp);
+        out += ",\"value\":";
+    }
+
+    void AppendBucketsJson(std::string &out, long long const *buckets, std::size_t count)
+    {
+        out += '[';
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (i > 0)
+            {
+                out += ',';
+            }
+            AppendInt64(out, buckets[i]);
+        }
+        out += ']';
+    }
+} // namespace
+
+/*****************************************************************************/
+std::string MetricRegistry::LookupKey(std::string const &name, MetricScope scope, unsigned int entityId)
+{
+    std::string key;
+    key.reserve(name.size() + 16);
+    AppendInt64(key, static_cast<long long>(scope));
+    key += '/';
+    AppendInt64(key, entityId);
+    key += '/';
+    key += name;
+    return key;
+}
+
+/*****************************************************************************/
+MetricHandle MetricRegistry::Register(std::string const &name,
+                                      MetricKind kind,
+                                      MetricScope scope,
+                                      unsigned int entityId,
+                                      std::vector<double> const *upperBounds)
+{
+    std::string key = LookupKey(name, scope, entityId);
+
+    auto const existing = m_byName.find(key);
+    if (existing != m_byName.end())
+    {
+        MetricInfo const &info = m_info[existing->second];
+        if (info.kind != kind || (upperBounds != nullptr && info.bucketCount != upperBounds->size() + 1))
+        {
+            return InvalidMetricHandle;
+        }
+        return existing->second;
+    }
+
+    if (m_info.size() >= InvalidMetricHandle)
+    {
+        return InvalidMetricHandle;
+    }
+
+    MetricHandle const handle = static_cast<MetricHandle>(m_info.size());
+
+    MetricInfo info {};
+    info.kind     = kind;
+    info.scope    = scope;
+    info.entityId = entityId;
+    info.name     = name;
+
+    if (upperBounds != nullptr)
+    {
+        info.firstBucket = static_cast<std::uint32_t>(m_buckets.size());
+        info.bucketCount = static_cast<std::uint32_t>(upperBounds->size() + 1);
+        m_bucketBounds.insert(m_bucketBounds.end(), upperBounds->begin(), upperBounds->end());
+        m_bucketBounds.push_back(std::numeric_limits<double>::infinity());
+        m_buckets.resize(m_bucketBounds.size(), 0);
+        m_previousBuckets.resize(m_bucketBounds.size(), 0);
+    }
+
+    m_info.push_back(std::move(info));
+    m_samples.push_back(MetricSample {});
+    m_byName.emplace(std::move(key), handle);
+    return handle;
+}
+
+/*****************************************************************************/
+MetricHandle MetricRegistry::RegisterCounter(std::string const &name, MetricScope scope, unsigned int entityId)
+{
+    return Register(name, MetricKind::Counter, scope, entityId, nullptr);
+}
+
+/*****************************************************************************/
+MetricHandle MetricRegistry::RegisterGauge(std::string const &name, MetricScope scope, unsigned int entityId)
+{
+    return Register(name, MetricKind::Gauge, scope, entityId, nullptr);
+}
+
+/*****************************************************************************/
+MetricHandle MetricRegistry::RegisterHistogram(std::string const &name,
+                                               std::vector<double> const &upperBounds,
+                                               MetricScope scope,
+                                               unsigned int entityId)
+{
+    if (!std::is_sorted(upperBounds.begin(), upperBounds.end()))
+    {
+        return InvalidMetricHandle;
+    }
+    return Register(name, MetricKind::Histogram, scope, entityId, &upperBounds);
+}
+
+/*****************************************************************************/
+MetricHandle MetricRegistry::Find(std::string const &name, MetricScope scope, unsigned int entityId) const
+{
+    auto const it = m_byName.find(LookupKey(name, scope, entityId));
+    return it == m_byName.end() ? InvalidMetricHandle : it->second;
+}
+
+/*****************************************************************************/
+void MetricRegistry::Record(MetricHandle handle, MetricValue value, timelib64_t timestamp)
+{
+    MetricSample &sample     = m_samples[handle];
+    sample.previous          = sample.value;
+    sample.previousTimestamp = sample.timestamp;
+    sample.value             = value;
+    sample.timestamp         = timestamp;
+    if (sample.updateCount < UINT32_MAX)
+    {
+        sample.updateCount++;
+    }
+}
+
+/*****************************************************************************/
+void MetricRegistry::SetCounter(MetricHandle handle, long long total, timelib64_t timestamp)
+{
+    if (!IsKind(handle, MetricKind::Counter))
+    {
+        return;
+    }
+    MetricValue value;
+    value.i64 = total;
+    Record(handle, value, timestamp);
+}
+
+/*****************************************************************************/
+void MetricRegistry::AddCounter(MetricHandle handle, long long delta, timelib64_t timestamp)
+{
+    if (!IsKind(handle, MetricKind::Counter))
+    {
+        return;
+    }
+    MetricValue value;
+    value.i64 = m_samples[handle].value.i64 + delta;
+    Record(handle, value, timestamp);
+}
+
+/*****************************************************************************/
+void MetricRegistry::SetGauge(MetricHandle handle, double gauge, timelib64_t timestamp)
+{
+    if (!IsKind(handle, MetricKind::Gauge))
+    {
+        return;
+    }
+    MetricValue value;
+    value.dbl = gauge;
+    Record(handle, value, timestamp);
+}
+
+/*****************************************************************************/
+void MetricRegistry::Observe(MetricHandle handle, double observed, timelib64_t timestamp)
+{
+    if (!IsKind(handle, MetricKind::Histogram))
+    {
+        return;
+    }
+
+    MetricInfo const &info = m_info[handle];
+    long long *buckets     = &m_buckets[info.firstBucket];
+    long long *previous    = &m_previousBuckets[info.firstBucket];
+    double const *bounds   = &m_bucketBounds[info.firstBucket];
+
+    std::copy(buckets, buckets + info.bucketCount, previous);
+    /* The first bucket whose bound is above observed. Anything past the last bound, NaN included, lands in the last */
+    std::size_t const bucket = std::upper_bound(bounds, bounds + info.bucketCount - 1, observed) - bounds;
+    buckets[bucket]++;
+
+    MetricValue value;
+    value.i64 = m_samples[handle].value.i64 + 1;
+    Record(handle, value, timestamp);
+}
+
+/*****************************************************************************/
+void MetricRegistry::SetBuckets(MetricHandle handle, long long const *counts, timelib64_t timestamp)
+{
+    if (!IsKind(handle, MetricKind::Histogram) || counts == nullptr)
+    {
+        return;
+    }
+
+    MetricInfo const &info = m_info[handle];
+    long long *buckets     = &m_buckets[info.firstBucket];
+
+    std::copy(buckets, buckets + info.bucketCount, &m_previousBuckets[info.firstBucket]);
+    std::copy(counts, counts + info.bucketCount, buckets);
+
+    MetricValue value;
+    value.i64 = 0;
+    for (std::uint32_t i = 0; i < info.bucketCount; i++)
+    {
+        value.i64 += counts[i];
+    }
+    Record(handle, value, timestamp);
+}
+
+/*****************************************************************************/
+long long MetricRegistry::GetCounter(MetricHandle handle) const
+{
+    return IsKind(handle, MetricKind::Counter) ? m_samples[handle].value.i64 : 0;
+}
+
+/*****************************************************************************/
+long long MetricRegistry::GetCounterDelta(MetricHandle handle) const
+{
+    if (!IsKind(handle, MetricKind::Counter))
+    {
+        return 0;
+    }
+    MetricSample const &sample = m_samples[handle];
+    return sample.updateCount > 1 ? sample.value.i64 - sample.previous.i64 : sample.value.i64;
+}
+
+/*****************************************************************************/
+double MetricRegistry::GetGauge(MetricHandle handle) const
+{
+    return IsKind(handle, MetricKind::Gauge) ? m_samples[handle].value.dbl : 0.0;
+}
+
+/*****************************************************************************/
+long long const *MetricRegistry::GetBuckets(MetricHandle handle) const
+{
+    return IsKind(handle, MetricKind::Histogram) ? &m_buckets[m_info[handle].firstBucket] : nullptr;
+}
+
+/*****************************************************************************/
+std::size_t MetricRegistry::GetBucketCount(MetricHandle handle) const
+{
+    return IsKind(handle, MetricKind::Histogram) ? m_info[handle].bucketCount : 0;
+}
+
+/*****************************************************************************/
+timelib64_t MetricRegistry::GetLastUpdate(MetricHandle handle) const
+{
+    return handle < m_samples.size() ? m_samples[handle].timestamp : 0;
+}
+
+/*****************************************************************************/
+std::uint32_t MetricRegistry::GetUpdateCount(MetricHandle handle) const
+{
+    return handle < m_samples.size() ? m_samples[handle].updateCount : 0;
+}
+
+/*****************************************************************************/
+MetricKind MetricRegistry::GetKind(MetricHandle handle) const
+{
+    return m_info.at(handle).kind;
+}
+
+/*****************************************************************************/
+std::string const &MetricRegistry::GetName(MetricHandle handle) const
+{
+    return m_info.at(handle).name;
+}
+
+/*****************************************************************************/
+long long MetricRegistry::SumCounters(MetricHandle const *handles, std::size_t count) const
+{
+    long long sum = 0;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        sum += GetCounter(handles[i]);
+    }
+    return sum;
+}
+
+/*****************************************************************************/
+double MetricRegistry::SumGauges(MetricHandle const *handles, std::size_t count) const
+{
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        sum += GetGauge(handles[i]);
+    }
+    return sum;
+}
+
+/*****************************************************************************/
+void MetricRegistry::SumBuckets(MetricHandle const *handles, std::size_t count, long long *counts) const
+{
+    std::size_t bucketCount = 0;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        long long const *buckets = GetBuckets(handles[i]);
+        if (buckets == nullptr)
+        {
+            continue;
+        }
+        if (bucketCount == 0)
+        {
+            bucketCount = m_info[handles[i]].bucketCount;
+        }
+        else if (m_info[handles[i]].bucketCount != bucketCount)
+        {
+            continue;
+        }
+
+        for (std::size_t j = 0; j < bucketCount; j++)
+        {
+            counts[j] += buckets[j];
+        }
+    }
+}
+
+/*****************************************************************************/
+void MetricRegistry::Reset()
+{
+    std::fill(m_samples.begin(), m_samples.end(), MetricSample {});
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    std::fill(m_previousBuckets.begin(), m_previousBuckets.end(), 0);
+}
+
+/*****************************************************************************/
+std::string MetricRegistry::ToJson() const
+{
+    /* Handles of each entity of each scope, in registration order */
+    std::map<unsigned int, std::vector<MetricHandle>> byEntity[std::size(g_scopeJsonTags)];
+    for (MetricHandle handle = 0; handle < m_info.size(); handle++)
+    {
+        if (m_samples[handle].updateCount > 0)
+        {
+            byEntity[static_cast<std::size_t>(m_info[handle].scope)][m_info[handle].entityId].push_back(handle);
+        }
+    }
+
+    std::string out;
+    out.reserve(64 + m_info.size() * 96);
+
+    auto appendMetrics = [&](std::vector<MetricHandle> const &handles) {
+        bool first = true;
+        for (MetricHandle const handle : handles)
+        {
+            MetricInfo const &info     = m_info[handle];
+            MetricSample const &sample = m_samples[handle];
+
+            if (!first)
+            {
+                out += ',';
+            }
+            first = false;
+
+            out += '"';
+            out += info.name;
+            out += "\":[";
+
+            for (int older = sample.updateCount > 1 ? 1 : 0; older >= 0; older--)
+            {
+                AppendSampleJson(out, older ? sample.previousTimestamp : sample.timestamp);
+                MetricValue const &value = older ? sample.previous : sample.value;
+                switch (info.kind)
+                {
+                    case MetricKind::Counter:
+                        AppendInt64(out, value.i64);
+                        break;
+                    case MetricKind::Gauge:
+                        AppendDouble(out, value.dbl);
+                        break;
+                    case MetricKind::Histogram:
+                        AppendBucketsJson(out,
+                                          older ? &m_previousBuckets[info.firstBucket] : &m_buckets[info.firstBucket],
+                                          info.bucketCount);
+                        break;
+                }
+                out += older ? "}," : "}";
+            }
+            out += ']';
+        }
+    };
+
+    out += "{\"globals\":{";
+    bool firstGlobal = true;
+    for (auto const &[entityId, handles] : byEntity[static_cast<std::size_t>(MetricScope::Global)])
+    {
+        if (!firstGlobal)
+        {
+            out += ',';
+        }
+        firstGlobal = false;
+        appendMetrics(handles);
+    }
+    out += "},\"groups\":{";
+
+    for (std::size_t scope = static_cast<std::size_t>(MetricScope::Gpu); scope < std::size(g_scopeJsonTags); scope++)
+    {
+        out += "},\"";
+        out += g_scopeJsonTags[scope];
+        out += "\":{";
+
+        bool first = true;
+        for (auto const &[entityId, handles] : byEntity[scope])
+        {
+            if (!first)
+            {
+                out += ',';
+            }
+            first = false;
+
+            out += '"';
+            AppendInt64(out, entityId);
+            out += "\":{";
+            appendMetrics(handles);
+            out += '}';
+        }
+    }
+
+    out += "}}";
+    return out;
+}
+
+} // namespace DcgmNs
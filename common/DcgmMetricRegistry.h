@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <timelib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace DcgmNs
+{
+using MetricHandle = std::uint32_t;
+
+constexpr MetricHandle InvalidMetricHandle = UINT32_MAX;
+
+enum class MetricKind : std::uint8_t
+{
+    Counter,   //!< Integer total. Usually only goes up. See GetCounterDelta()
+    Gauge,     //!< Double that is overwritten with each sample
+    Histogram, //!< Integer counts of values by bucket
+};
+
+/* Where ToJson() puts a metric. Mirrors DcgmStatCollection's global and per-entity collections */
+enum class MetricScope : std::uint8_t
+{
+    Global,
+    Gpu,
+    Switch,
+    Vgpu,
+};
+
+/*
+ * Typed replacement for DcgmStatCollection on paths that record the same stats over and over.
+ *
+ * Metrics are registered once by name and then recorded and read through the integer handle that
+ * registration returns, so updates neither hash strings nor allocate. Values live in contiguous
+ * arrays indexed by handle and histogram buckets in one shared array, so aggregating over a set of
+ * metrics is a walk over indexes.
+ *
+ * Each metric keeps its latest and previous value, which is what DcgmStatCollection's callers kept
+ * with a quota of 2 entries.
+ *
+ * A registry does no locking of its own. It's meant to be used from one thread, the way the
+ * introspect module's task runner is the only user of DcgmMetadataManager's. Callers that share
+ * one between threads need their own lock around every call, reads included.
+ */
+class MetricRegistry
+{
+public:
+    /*************************************************************************/
+    /*
+     * Register a metric. Registering a name again for the same scope and entity returns the
+     * existing handle if the kind matches.
+     *
+     * upperBounds  IN: Exclusive upper bound of each histogram bucket but the last, ascending.
+     *                  The last bucket holds everything from the last bound up
+     *
+     * Returns: Handle to record and read the metric with
+     *          InvalidMetricHandle if the name is registered as another kind of metric
+     */
+    MetricHandle RegisterCounter(std::string const &name,
+                                 MetricScope scope      = MetricScope::Global,
+                                 unsigned int entityId = 0);
+    MetricHandle RegisterGauge(std::string const &name,
+                               MetricScope scope      = MetricScope::Global,
+                               unsigned int entityId = 0);
+    MetricHandle RegisterHistogram(std::string const &name,
+                                   std::vector<double> const &upperBounds,
+                                   MetricScope scope      = MetricScope::Global,
+                                   unsigned int entityId = 0);
+
+    /* Registration-time lookup. InvalidMetricHandle if there is no such metric */
+    MetricHandle Find(std::string const &name,
+                      MetricScope scope      = MetricScope::Global,
+                      unsigned int entityId = 0) const;
+
+    /*************************************************************************/
+    /*
+     * Record a sample taken at timestamp. The previous sample is kept for GetCounterDelta().
+     * Handles of the wrong kind are ignored.
+     */
+    void SetCounter(MetricHandle handle, long long total, timelib64_t timestamp);
+    void AddCounter(MetricHandle handle, long long delta, timelib64_t timestamp);
+    void SetGauge(MetricHandle handle, double value, timelib64_t timestamp);
+
+    /* Count value in its histogram bucket */
+    void Observe(MetricHandle handle, double value, timelib64_t timestamp);
+
+    /* Replace all the bucket counts of a histogram. counts has GetBucketCount() entries */
+    void SetBuckets(MetricHandle handle, long long const *counts, timelib64_t timestamp);
+
+    /*************************************************************************/
+    /*
+     * Read a metric. Reading a handle of the wrong kind or one that was never recorded returns 0.
+     */
+    long long GetCounter(MetricHandle handle) const;
+    double GetGauge(MetricHandle handle) const;
+
+    /* Latest total minus the one before it. The latest total if there was only one sample */
+    long long GetCounterDelta(MetricHandle handle) const;
+
+    /* Bucket counts of a histogram, GetBucketCount() of them. nullptr if handle is not a histogram */
+    long long const *GetBuckets(MetricHandle handle) const;
+    std::size_t GetBucketCount(MetricHandle handle) const;
+
+    /* Timestamp of the latest sample. 0 if the metric was never recorded */
+    timelib64_t GetLastUpdate(MetricHandle handle) const;
+
+    /* How many samples were recorded, saturating at UINT32_MAX */
+    std::uint32_t GetUpdateCount(MetricHandle handle) const;
+
+    MetricKind GetKind(MetricHandle handle) const;
+    std::string const &GetName(MetricHandle handle) const;
+
+    std::size_t Size() const
+    {
+        return m_info.size();
+    }
+
+    /*************************************************************************/
+    /*
+     * Aggregate over a set of metrics by handle. Handles of the wrong kind count as 0.
+     */
+    long long SumCounters(MetricHandle const *handles, std::size_t count) const;
+    double SumGauges(MetricHandle const *handles, std::size_t count) const;
+
+    /* Add the buckets of each histogram to counts, which has GetBucketCount() of the first histogram entries.
+       Histograms with a different bucket count are skipped */
+    void SumBuckets(MetricHandle const *handles, std::size_t count, long long *counts) const;
+
+    /*************************************************************************/
+    /*
+     * Forget every sample. Registrations and handles stay valid
+     */
+    void Reset();
+
+    /*
+     * Same layout as DcgmStatCollection::ToJson(): globals, groups (always empty), gpus, switches and vgpus,
+     * each a map of name to the metric's samples, oldest first. Histogram sample values are arrays of bucket counts.
+     */
+    std::string ToJson() const;
+
+private:
+    union MetricValue
+    {
+        long long i64;
+        double dbl;
+    };
+
+    struct MetricSample
+    {
+        MetricValue value;
+        MetricValue previous;
+        timelib64_t timestamp;
+        timelib64_t previousTimestamp;
+        std::uint32_t updateCount;
+    };
+
+    struct MetricInfo
+    {
+        MetricKind kind;
+        MetricScope scope;
+        unsigned int entityId;
+        std::uint32_t firstBucket; /* Index into m_buckets and m_bucketBounds. Histograms only */
+        std::uint32_t bucketCount;
+        std::string name;
+    };
+
+    MetricHandle Register(std::string const &name,
+                          MetricKind kind,
+                          MetricScope scope,
+                          unsigned int entityId,
+                          std::vector<double> const *upperBounds);
+
+    static std::string LookupKey(std::string const &name, MetricScope scope, unsigned int entityId);
+
+    bool IsKind(MetricHandle handle, MetricKind kind) const
+    {
+        return handle < m_info.size() && m_info[handle].kind == kind;
+    }
+
+    void Record(MetricHandle handle, MetricValue value, timelib64_t timestamp);
+
+    std::vector<MetricSample> m_samples; /* Indexed by handle */
+    std::vector<MetricInfo> m_info;      /* Indexed by handle */
+    std::vector<long long> m_buckets;    /* Current bucket counts of every histogram */
+    std::vector<long long> m_previousBuckets;
+    std::vector<double> m_bucketBounds; /* Upper bound of each entry of m_buckets */
+    std::unordered_map<std::string, MetricHandle> m_byName;
+};
+
+} // namespace DcgmNs
@@ -17,8 +17,129 @@
 #include "DcgmLogging.h"
 #include "timelib.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <ratio>
+#include <sstream>
+
+/* Live counters behind a DcgmMutexTimeStats */
+struct DcgmMutexTimes
+{
+    std::atomic<long long> count;
+    std::atomic<long long> totalNs;
+    std::atomic<long long> maxNs;
+    std::atomic<long long> buckets[DCGM_MUTEX_PROFILE_BUCKETS];
+
+    void Add(long long ns)
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+        totalNs.fetch_add(ns, std::memory_order_relaxed);
+
+        long long max = maxNs.load(std::memory_order_relaxed);
+        while (ns > max && !maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+            ;
+
+        int bucket = 0;
+        for (long long usec = ns / 1000; usec > 0 && bucket < DCGM_MUTEX_PROFILE_BUCKETS - 1; usec >>= 1)
+        {
+            bucket++;
+        }
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Reset()
+    {
+        count.store(0, std::memory_order_relaxed);
+        totalNs.store(0, std::memory_order_relaxed);
+        maxNs.store(0, std::memory_order_relaxed);
+        for (auto &bucket : buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    DcgmMutexTimeStats Get() const
+    {
+        DcgmMutexTimeStats stats {};
+        stats.count   = count.load(std::memory_order_relaxed);
+        stats.totalNs = totalNs.load(std::memory_order_relaxed);
+        stats.maxNs   = maxNs.load(std::memory_order_relaxed);
+        for (int i = 0; i < DCGM_MUTEX_PROFILE_BUCKETS; i++)
+        {
+            stats.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+};
+
+/* One slot of the call site table */
+struct DcgmMutexSite
+{
+    std::atomic<int> state; /* 0 = free. 1 = being claimed. 2 = file and line are set */
+    const char *file;
+    int line;
+    DcgmMutexTimes wait;
+    DcgmMutexTimes hold;
+};
+
+namespace
+{
+/* Call sites that can be told apart. Sites past this many are all counted in the overflow site */
+constexpr size_t MUTEX_PROFILE_SITES = 1024;
+
+std::atomic<bool> g_profilingEnabled { false };
+
+/* Open-addressed by file and line. Slots are claimed once and never freed, so lookups take no lock */
+DcgmMutexSite g_sites[MUTEX_PROFILE_SITES + 1];
+
+DcgmMutexSite &OverflowSite()
+{
+    return g_sites[MUTEX_PROFILE_SITES];
+}
+
+DcgmMutexSite *FindSite(const char *file, int line)
+{
+    size_t const hash = std::hash<const void *> {}(file) * 31 + (size_t)line;
+
+    for (size_t probe = 0; probe < MUTEX_PROFILE_SITES; probe++)
+    {
+        DcgmMutexSite &site = g_sites[(hash + probe) % MUTEX_PROFILE_SITES];
+        int state           = site.state.load(std::memory_order_acquire);
+
+        if (state == 0)
+        {
+            if (site.state.compare_exchange_strong(state, 1, std::memory_order_acquire))
+            {
+                site.file = file;
+                site.line = line;
+                site.state.store(2, std::memory_order_release);
+                return &site;
+            }
+        }
+
+        /* Another thread is claiming this slot. It's only a few stores away from done */
+        while (state == 1)
+        {
+            std::this_thread::yield();
+            state = site.state.load(std::memory_order_acquire);
+        }
+
+        if (site.file == file && site.line == line)
+        {
+            return &site;
+        }
+    }
+
+    return &OverflowSite();
+}
+
+long long SteadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace
 
 /*****************************************************************************/
 DcgmMutex::DcgmMutex(int timeoutMs)
@@ -29,6 +150,8 @@ DcgmMutex::DcgmMutex(int timeoutMs)
     , m_lockCount(0)
     , m_mutex()
     , m_locker()
+    , m_lockerSite(nullptr)
+    , m_lockedAtNs(0)
 {
     if (m_debugLogging)
         PRINT_DEBUG("%p", "Mutex %p allocated", (void *)this);
@@ -97,6 +220,12 @@ dcgmMutexReturn_t DcgmMutex::Unlock(const char *file, int line)
     /* Clear locker info */
     m_locker = dcgm_mutex_locker_t {};
 
+    if (m_lockerSite != nullptr)
+    {
+        m_lockerSite->hold.Add(SteadyNowNs() - m_lockedAtNs);
+        m_lockerSite = nullptr;
+    }
+
     m_mutex.unlock();
 
     if (m_debugLogging)
@@ -133,6 +262,9 @@ dcgmMutexReturn_t DcgmMutex::Lock(int complainMe, const char *file, int line)
         return DCGM_MUTEX_ST_LOCKEDBYME;
     }
 
+    bool const profiling        = g_profilingEnabled.load(std::memory_order_relaxed);
+    long long const waitStartNs = profiling ? SteadyNowNs() : 0;
+
     /* Try and get the lock */
     if (!m_timeoutUsec)
     {
@@ -207,6 +339,13 @@ dcgmMutexReturn_t DcgmMutex::Lock(int complainMe, const char *file, int line)
         m_locker.whenLockedUsec = timelib_usecSince1970();
     }
 
+    if (profiling)
+    {
+        m_lockedAtNs = SteadyNowNs();
+        m_lockerSite = FindSite(file, line);
+        m_lockerSite->wait.Add(m_lockedAtNs - waitStartNs);
+    }
+
     if (m_debugLogging)
     {
         PRINT_DEBUG("%p %zu %s %d %lld",
@@ -253,6 +392,14 @@ dcgmMutexReturn_t DcgmMutex::CondWait(std::condition_variable &cv,
     m_locker          = dcgm_mutex_locker_t {};
     m_locker.ownerTid = std::thread::id();
 
+    /* The hold ends while waiting. Other lockers will use m_lockerSite in the meantime */
+    DcgmMutexSite *backupSite = m_lockerSite;
+    if (backupSite != nullptr)
+    {
+        backupSite->hold.Add(SteadyNowNs() - m_lockedAtNs);
+        m_lockerSite = nullptr;
+    }
+
     if (timeoutMs == 0)
     {
         timeoutMs = 60000U;
@@ -287,6 +434,12 @@ dcgmMutexReturn_t DcgmMutex::CondWait(std::condition_variable &cv,
     /* We now have the lock again. Restore the locker info */
     m_locker = backupLocker;
 
+    if (backupSite != nullptr)
+    {
+        m_lockerSite = backupSite;
+        m_lockedAtNs = SteadyNowNs();
+    }
+
     if (m_debugLogging)
     {
         DCGM_LOG_DEBUG << "CondWait finished on mutex" << (void *)this << ". retSt " << retSt;
@@ -302,3 +455,96 @@ long long DcgmMutex::GetLockCount(void)
 }
 
 /*****************************************************************************/
+void DcgmMutex::EnableProfiling(bool enabled)
+{
+    g_profilingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+bool DcgmMutex::IsProfilingEnabled(void)
+{
+    return g_profilingEnabled.load(std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+void DcgmMutex::ResetProfile(void)
+{
+    for (auto &site : g_sites)
+    {
+        site.wait.Reset();
+        site.hold.Reset();
+    }
+}
+
+/*****************************************************************************/
+std::vector<DcgmMutexSiteProfile> DcgmMutex::GetProfile(void)
+{
+    std::vector<DcgmMutexSiteProfile> profile;
+
+    for (size_t i = 0; i <= MUTEX_PROFILE_SITES; i++)
+    {
+        DcgmMutexSite const &site = g_sites[i];
+        bool const overflow       = i == MUTEX_PROFILE_SITES;
+        if (!overflow && site.state.load(std::memory_order_acquire) != 2)
+        {
+            continue;
+        }
+
+        DcgmMutexSiteProfile siteProfile {};
+        siteProfile.file = overflow ? "<other>" : site.file;
+        siteProfile.line = overflow ? 0 : site.line;
+        siteProfile.wait = site.wait.Get();
+        siteProfile.hold = site.hold.Get();
+        if (siteProfile.wait.count != 0 || siteProfile.hold.count != 0)
+        {
+            profile.push_back(siteProfile);
+        }
+    }
+
+    return profile;
+}
+
+/*****************************************************************************/
+static void TimeStatsToJson(std::stringstream &ss, DcgmMutexTimeStats const &stats)
+{
+    ss << "{\"count\":" << stats.count << ",\"totalUsec\":" << stats.totalNs / 1000
+       << ",\"maxUsec\":" << stats.maxNs / 1000 << ",\"buckets\":[";
+
+    /* Leave out the empty buckets at the end */
+    int numBuckets = DCGM_MUTEX_PROFILE_BUCKETS;
+    while (numBuckets > 0 && stats.buckets[numBuckets - 1] == 0)
+    {
+        numBuckets--;
+    }
+    for (int i = 0; i < numBuckets; i++)
+    {
+        ss << (i ? "," : "") << stats.buckets[i];
+    }
+    ss << "]}";
+}
+
+/*****************************************************************************/
+std::string DcgmMutex::ProfileToJson(std::vector<DcgmMutexSiteProfile> const &profile)
+{
+    std::vector<DcgmMutexSiteProfile> sorted(profile);
+    std::sort(sorted.begin(), sorted.end(), [](DcgmMutexSiteProfile const &a, DcgmMutexSiteProfile const &b) {
+        return a.wait.totalNs > b.wait.totalNs;
+    });
+
+    std::stringstream ss;
+    ss << "{\"buckets\":\"Bucket i counts times under 2^i usec. The last one counts the rest\",\"sites\":[";
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        ss << (i ? ",\n" : "\n") << "{\"file\":\"" << sorted[i].file << "\",\"line\":" << sorted[i].line
+           << ",\"wait\":";
+        TimeStatsToJson(ss, sorted[i].wait);
+        ss << ",\"hold\":";
+        TimeStatsToJson(ss, sorted[i].hold);
+        ss << "}";
+    }
+    ss << "\n]}\n";
+
+    return ss.str();
+}
+
+/*****************************************************************************/
@@ -19,7 +19,9 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 /* API Status codes */
 typedef enum dcgmMutexSt
@@ -50,6 +52,29 @@ struct dcgm_mutex_locker_t
 };
 using dcgm_mutex_locker_p = dcgm_mutex_locker_t *;
 
+/* Histogram buckets of a DcgmMutexTimeStats. Bucket i counts times under 2^i usec. The last one counts the rest */
+#define DCGM_MUTEX_PROFILE_BUCKETS 24
+
+/* Distribution of the wait or hold times of one call site */
+struct DcgmMutexTimeStats
+{
+    long long count;
+    long long totalNs;
+    long long maxNs;
+    long long buckets[DCGM_MUTEX_PROFILE_BUCKETS];
+};
+
+/* Contention profile of one call site that locks a DcgmMutex */
+struct DcgmMutexSiteProfile
+{
+    const char *file; /* file and line passed to Lock() */
+    int line;
+    DcgmMutexTimeStats wait; /* Time spent waiting for the lock */
+    DcgmMutexTimeStats hold; /* Time from getting the lock until Unlock() or CondWait() released it */
+};
+
+struct DcgmMutexSite;
+
 
 /* DcgmMutex class. Instantiate this class to get a mutex */
 class DcgmMutex
@@ -151,6 +176,26 @@ public:
      */
     long long GetLockCount(void);
 
+    /*************************************************************************/
+    /*
+     * Turn wait-time and hold-time profiling of all DcgmMutexes on or off.
+     * Profiles are kept per call site, using the file and line given to
+     * Lock(). While off, Lock() and Unlock() only pay for one relaxed atomic
+     * load. Profiles are kept when profiling is turned off
+     */
+    static void EnableProfiling(bool enabled);
+
+    static bool IsProfilingEnabled(void);
+
+    /* Forget all recorded profiles */
+    static void ResetProfile(void);
+
+    /* Get the profile of each call site that locked a mutex while profiling was on */
+    static std::vector<DcgmMutexSiteProfile> GetProfile(void);
+
+    /* Format profiles as JSON, sites with the most total wait first */
+    static std::string ProfileToJson(std::vector<DcgmMutexSiteProfile> const &profile);
+
 private:
     /*************************************************************************/
 
@@ -163,6 +208,9 @@ private:
 
     dcgm_mutex_locker_t m_locker; /* Information about the locker of this mutex */
 
+    DcgmMutexSite *m_lockerSite; /* Profile of the locker's call site. nullptr if profiling was off when locked */
+    long long m_lockedAtNs;      /* steady_clock time m_lockerSite got the lock */
+
     /*************************************************************************/
 };
 
@@ -173,11 +221,14 @@ private:
 class DcgmLockGuard
 {
 public:
-    explicit DcgmLockGuard(DcgmMutex *mutex) noexcept
+    /* file and line default to the caller's so that mutex profiles show where the guard is */
+    explicit DcgmLockGuard(DcgmMutex *mutex,
+                           const char *file = __builtin_FILE(),
+                           int line         = __builtin_LINE()) noexcept
         : m_mutex(mutex)
     {
         /* Use recursive version of lock. The destructor will handle this properly */
-        m_mutexReturn = dcgm_mutex_lock_me(m_mutex);
+        m_mutexReturn = m_mutex->Lock(0, file, line);
     }
 
     ~DcgmLockGuard() noexcept
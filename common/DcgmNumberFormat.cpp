@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmNumberFormat.h"
+
+#include <dcgm_structs.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cctype>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+/* libstdc++ only defines this once std::to_chars and std::from_chars handle floating point */
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define DCGM_HAVE_FLOAT_TO_CHARS 1
+#endif
+
+namespace DcgmNs
+{
+namespace
+{
+#ifndef DCGM_HAVE_FLOAT_TO_CHARS
+    /* snprintf into [first, last) without the terminating NUL */
+    char *PrintDouble(char *first, char *last, char const *format, int precision, double value)
+    {
+        std::ptrdiff_t const size = last - first;
+        if (size <= 0)
+        {
+            return nullptr;
+        }
+
+        int const length = snprintf(first, size, format, precision, value);
+        if (length < 0 || length >= size)
+        {
+            return nullptr;
+        }
+        return first + length;
+    }
+#endif
+} // namespace
+
+/*****************************************************************************/
+char *FormatInt64(char *first, char *last, long long value)
+{
+    auto const [end, ec] = std::to_chars(first, last, value);
+    return ec == std::errc() ? end : nullptr;
+}
+
+/*****************************************************************************/
+char *FormatDouble(char *first, char *last, double value)
+{
+#ifdef DCGM_HAVE_FLOAT_TO_CHARS
+    /* general rather than the default, which would write 100000 as 1e+05 because that is shorter */
+    auto const [end, ec] = std::to_chars(first, last, value, std::chars_format::general);
+    return ec == std::errc() ? end : nullptr;
+#else
+    /* The fewest significant digits that round-trip. 17 always do */
+    for (int precision = DBL_DIG; precision < 17; precision++)
+    {
+        char *end = PrintDouble(first, last, "%.*g", precision, value);
+        if (end == nullptr)
+        {
+            return nullptr;
+        }
+        *end = '\0'; /* PrintDouble() left room for it */
+        if (strtod(first, nullptr) == value || value != value)
+        {
+            return end;
+        }
+    }
+    return PrintDouble(first, last, "%.*g", 17, value);
+#endif
+}
+
+/*****************************************************************************/
+char *FormatDoubleFixed(char *first, char *last, double value, int precision)
+{
+    precision = std::max(precision, 0);
+#ifdef DCGM_HAVE_FLOAT_TO_CHARS
+    auto const [end, ec] = std::to_chars(first, last, value, std::chars_format::fixed, precision);
+    return ec == std::errc() ? end : nullptr;
+#else
+    return PrintDouble(first, last, "%.*f", precision, value);
+#endif
+}
+
+/*****************************************************************************/
+void AppendInt64(std::string &out, long long value)
+{
+    char buffer[MaxFormattedNumberLength];
+    out.append(buffer, FormatInt64(buffer, buffer + sizeof(buffer), value));
+}
+
+/*****************************************************************************/
+void AppendDouble(std::string &out, double value)
+{
+    char buffer[MaxFormattedNumberLength];
+    out.append(buffer, FormatDouble(buffer, buffer + sizeof(buffer), value));
+}
+
+/*****************************************************************************/
+void AppendDoubleFixed(std::string &out, double value, int precision)
+{
+    char buffer[64];
+    char *end = FormatDoubleFixed(buffer, buffer + sizeof(buffer), value, precision);
+    if (end != nullptr)
+    {
+        out.append(buffer, end);
+        return;
+    }
+
+    /* Only huge values or precisions get here. Sign, integer digits, point, decimals and snprintf's NUL */
+    std::size_t const oldSize = out.size();
+    out.resize(oldSize + DBL_MAX_10_EXP + std::max(precision, 0) + 5);
+    end = FormatDoubleFixed(out.data() + oldSize, out.data() + out.size(), value, precision);
+    out.resize(end != nullptr ? end - out.data() : oldSize);
+}
+
+/*****************************************************************************/
+std::string Int64ToString(long long value)
+{
+    std::string result;
+    AppendInt64(result, value);
+    return result;
+}
+
+/*****************************************************************************/
+std::string DoubleToString(double value)
+{
+    std::string result;
+    AppendDouble(result, value);
+    return result;
+}
+
+/*****************************************************************************/
+char const *BlankValueName(int value)
+{
+    if (!DCGM_INT32_IS_BLANK(value))
+    {
+        return nullptr;
+    }
+
+    switch (value)
+    {
+        case DCGM_INT32_BLANK:
+            return "Not Specified";
+        case DCGM_INT32_NOT_FOUND:
+            return "Not Found";
+        case DCGM_INT32_NOT_SUPPORTED:
+            return "Not Supported";
+        case DCGM_INT32_NOT_PERMISSIONED:
+            return "Insf. Permission";
+        default:
+            return "Unknown";
+    }
+}
+
+/*****************************************************************************/
+char const *BlankValueName(long long value)
+{
+    if (!DCGM_INT64_IS_BLANK(value))
+    {
+        return nullptr;
+    }
+
+    switch (value)
+    {
+        case DCGM_INT64_BLANK:
+            return "Not Specified";
+        case DCGM_INT64_NOT_FOUND:
+            return "Not Found";
+        case DCGM_INT64_NOT_SUPPORTED:
+            return "Not Supported";
+        case DCGM_INT64_NOT_PERMISSIONED:
+            return "Insf. Permission";
+        default:
+            return "Unknown";
+    }
+}
+
+/*****************************************************************************/
+char const *BlankValueName(double value)
+{
+    if (!DCGM_FP64_IS_BLANK(value))
+    {
+        return nullptr;
+    }
+
+    if (value == DCGM_FP64_BLANK)
+        return "Not Specified";
+    if (value == DCGM_FP64_NOT_FOUND)
+        return "Not Found";
+    if (value == DCGM_FP64_NOT_SUPPORTED)
+        return "Not Supported";
+    if (value == DCGM_FP64_NOT_PERMISSIONED)
+        return "Insf. Permission";
+    return "Unknown";
+}
+
+/*****************************************************************************/
+/* Drop a leading '+' that from_chars would reject. A sign after it stays an error */
+static bool SkipPlusSign(std::string_view &str)
+{
+    if (!str.empty() && str.front() == '+')
+    {
+        str.remove_prefix(1);
+        return !str.empty() && str.front() != '-' && str.front() != '+';
+    }
+    return true;
+}
+
+/*****************************************************************************/
+bool ParseInt64(std::string_view str, long long &value)
+{
+    if (!SkipPlusSign(str))
+    {
+        return false;
+    }
+
+    long long parsed     = 0;
+    auto const [end, ec] = std::from_chars(str.data(), str.data() + str.size(), parsed);
+    if (ec != std::errc() || end != str.data() + str.size())
+    {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+/*****************************************************************************/
+bool ParseDouble(std::string_view str, double &value)
+{
+    if (!SkipPlusSign(str) || str.empty())
+    {
+        return false;
+    }
+
+    double parsed = 0;
+#ifdef DCGM_HAVE_FLOAT_TO_CHARS
+    auto const [end, ec] = std::from_chars(str.data(), str.data() + str.size(), parsed);
+    if (ec != std::errc() || end != str.data() + str.size())
+    {
+        return false;
+    }
+#else
+    /* strtod() also takes leading whitespace and hex, which from_chars() doesn't */
+    if (isspace((unsigned char)str.front()) || str.find_first_of("xX") != std::string_view::npos)
+    {
+        return false;
+    }
+
+    std::string const terminated(str); /* strtod() needs the NUL */
+    char *end = nullptr;
+    errno     = 0;
+    parsed    = strtod(terminated.c_str(), &end);
+    /* ERANGE also flags denormals, which from_chars() takes. Only overflow and underflow to 0 are errors */
+    bool const outOfRange = errno == ERANGE && (parsed == 0 || std::isinf(parsed));
+    if (outOfRange || end != terminated.c_str() + terminated.size())
+    {
+        return false;
+    }
+#endif
+
+    value = parsed;
+    return true;
+}
+
+} // namespace DcgmNs
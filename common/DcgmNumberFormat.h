@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*
+ * Number formatting and parsing for paths that convert many values, built on
+ * std::to_chars/std::from_chars instead of streams and snprintf/strtod. None of
+ * these allocate except to grow the std::string they append to.
+ *
+ * Toolchains whose standard library has no floating point std::to_chars (GCC < 11)
+ * fall back to snprintf/strtod. Doubles still round-trip there, though very large
+ * and very small ones may be spelled differently.
+ */
+namespace DcgmNs
+{
+/* Buffer size that fits the output of FormatInt64() and FormatDouble() */
+constexpr std::size_t MaxFormattedNumberLength = 32;
+
+/*****************************************************************************/
+/*
+ * Write value to [first, last). The output is not NUL-terminated.
+ *
+ * Returns: One past the last character written
+ *          nullptr if the buffer is too small
+ */
+char *FormatInt64(char *first, char *last, long long value);
+
+/*
+ * The shortest representation that parses back to exactly value, e.g. 0.1 and not 0.10000000000000001.
+ * NaN and infinities are written as nan, inf and -inf.
+ */
+char *FormatDouble(char *first, char *last, double value);
+
+/*
+ * value with precision digits after the decimal point, like printf("%.*f")
+ */
+char *FormatDoubleFixed(char *first, char *last, double value, int precision);
+
+/*****************************************************************************/
+/*
+ * Append the output of the Format functions above to out
+ */
+void AppendInt64(std::string &out, long long value);
+void AppendDouble(std::string &out, double value);
+void AppendDoubleFixed(std::string &out, double value, int precision);
+
+std::string Int64ToString(long long value);
+std::string DoubleToString(double value);
+
+/*****************************************************************************/
+/*
+ * How dcgmi shows a DCGM blank value (DCGM_INT32_BLANK, DCGM_INT64_NOT_FOUND, DCGM_FP64_NOT_SUPPORTED, ...)
+ *
+ * Returns: "Not Specified", "Not Found", "Not Supported", "Insf. Permission" or "Unknown" if value is blank
+ *          nullptr if value is a regular value
+ */
+char const *BlankValueName(int value);
+char const *BlankValueName(long long value);
+char const *BlankValueName(double value);
+
+/*****************************************************************************/
+/*
+ * Parse all of str as a number. A leading '+' is accepted. Whitespace is not.
+ * Doubles can be written in fixed or scientific notation.
+ *
+ * Returns: true if str was a number that fits value. value is set
+ *          false otherwise. value is left alone
+ */
+bool ParseInt64(std::string_view str, long long &value);
+bool ParseDouble(std::string_view str, double &value);
+
+} // namespace DcgmNs
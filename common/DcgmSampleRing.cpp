@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmSampleRing.h"
+#include "DcgmLogging.h"
+
+#include <algorithm>
+
+/*****************************************************************************/
+DcgmSampleRing::DcgmSampleRing(size_t capacity, timelib64_t flushIntervalUsec)
+    : m_samples(std::max<size_t>(capacity, 1))
+    , m_flushIntervalUsec(flushIntervalUsec)
+{}
+
+/*****************************************************************************/
+dcgm_ring_sample_t &DcgmSampleRing::NextSlot()
+{
+    if (m_count == m_samples.size())
+    {
+        /* Full. The newest sample takes the place of the oldest */
+        m_head = (m_head + 1) % m_samples.size();
+        m_count--;
+        m_numDropped++;
+    }
+
+    dcgm_ring_sample_t &slot = m_samples[(m_head + m_count) % m_samples.size()];
+    m_count++;
+    return slot;
+}
+
+/*****************************************************************************/
+void DcgmSampleRing::AddInt64(dcgm_field_entity_group_t entityGroupId,
+                              dcgm_field_eid_t entityId,
+                              unsigned short fieldId,
+                              long long value,
+                              timelib64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    dcgm_ring_sample_t &sample = NextSlot();
+    sample.timestamp           = timestamp;
+    sample.value.i64           = value;
+    sample.entityId            = entityId;
+    sample.fieldId             = fieldId;
+    sample.entityGroupId       = entityGroupId;
+    sample.fieldType           = DCGM_FT_INT64;
+}
+
+/*****************************************************************************/
+void DcgmSampleRing::AddDouble(dcgm_field_entity_group_t entityGroupId,
+                               dcgm_field_eid_t entityId,
+                               unsigned short fieldId,
+                               double value,
+                               timelib64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    dcgm_ring_sample_t &sample = NextSlot();
+    sample.timestamp           = timestamp;
+    sample.value.dbl           = value;
+    sample.entityId            = entityId;
+    sample.fieldId             = fieldId;
+    sample.entityGroupId       = entityGroupId;
+    sample.fieldType           = DCGM_FT_DOUBLE;
+}
+
+/*****************************************************************************/
+bool DcgmSampleRing::IsFlushDue(timelib64_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count > 0 && now - m_lastDrainUsec >= m_flushIntervalUsec;
+}
+
+/*****************************************************************************/
+size_t DcgmSampleRing::Drain(DcgmFvBuffer &fvBuffer, timelib64_t now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t numDrained = m_count;
+    for (size_t i = 0; i < numDrained; i++)
+    {
+        dcgm_ring_sample_t const &sample = m_samples[(m_head + i) % m_samples.size()];
+        auto entityGroupId               = static_cast<dcgm_field_entity_group_t>(sample.entityGroupId);
+        if (sample.fieldType == DCGM_FT_DOUBLE)
+        {
+            fvBuffer.AddDoubleValue(
+                entityGroupId, sample.entityId, sample.fieldId, sample.value.dbl, sample.timestamp, DCGM_ST_OK);
+        }
+        else
+        {
+            fvBuffer.AddInt64Value(
+                entityGroupId, sample.entityId, sample.fieldId, sample.value.i64, sample.timestamp, DCGM_ST_OK);
+        }
+    }
+
+    m_head          = 0;
+    m_count         = 0;
+    m_lastDrainUsec = now;
+
+    if (m_numDropped > m_numDroppedLogged)
+    {
+        DCGM_LOG_WARNING << "Dropped " << m_numDropped - m_numDroppedLogged << " samples that didn't fit in a ring of "
+                         << m_samples.size() << " between drains";
+        m_numDroppedLogged = m_numDropped;
+    }
+
+    return numDrained;
+}
+
+/*****************************************************************************/
+size_t DcgmSampleRing::Size()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count;
+}
+
+/*****************************************************************************/
+long long DcgmSampleRing::GetNumDropped()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numDropped;
+}
+
+/*****************************************************************************/
+void DcgmSampleRing::SetFlushInterval(timelib64_t flushIntervalUsec)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_flushIntervalUsec = flushIntervalUsec;
+}
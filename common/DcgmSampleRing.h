@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "DcgmFvBuffer.h"
+#include "dcgm_fields.h"
+#include "timelib.h"
+
+#include <mutex>
+#include <vector>
+
+/* One numeric sample waiting in a DcgmSampleRing */
+typedef struct
+{
+    timelib64_t timestamp; /* When the sample was taken, in usec since 1970 */
+    union
+    {
+        long long i64;
+        double dbl;
+    } value;
+    dcgm_field_eid_t entityId;
+    unsigned short fieldId;
+    unsigned char entityGroupId; /* dcgm_field_entity_group_t */
+    unsigned char fieldType;     /* DCGM_FT_INT64 or DCGM_FT_DOUBLE */
+} dcgm_ring_sample_t;
+
+/*
+ * Fixed-size ring of numeric samples that a module takes at a higher rate than
+ * it delivers them to the cache, like counters sampled at their hardware rate
+ * for DCGM_PROF_WATCH_FLAG_BUFFERED watches. Samples keep their own timestamps
+ * and are handed to the cache in one DcgmCoreProxy::AppendSamples() call per
+ * flush interval instead of one per sample:
+ *
+ *     ring.AddDouble(DCGM_FE_GPU, gpuId, fieldId, value, sampleUsec);
+ *     ...
+ *     DcgmFvBuffer fvBuffer;
+ *     if (ring.IsFlushDue(now) && ring.Drain(fvBuffer, now) > 0)
+ *         coreProxy.AppendSamples(std::move(fvBuffer));
+ *
+ * The ring never grows, so sampling doesn't allocate. When it is full, the
+ * oldest samples are overwritten and counted as dropped. Size it for at least
+ * a flush interval of samples of every buffered watch.
+ *
+ * This class is thread safe, so samples can be added by one thread and drained
+ * by another.
+ */
+class DcgmSampleRing
+{
+public:
+    /*************************************************************************/
+    /*
+     * capacity          IN: Most samples to hold between drains. At least 1
+     * flushIntervalUsec IN: How often IsFlushDue() says to drain, like the updateFreq of the watch
+     */
+    DcgmSampleRing(size_t capacity, timelib64_t flushIntervalUsec);
+
+    /*************************************************************************/
+    /*
+     * Add a sample, overwriting the oldest one if the ring is full
+     */
+    void AddInt64(dcgm_field_entity_group_t entityGroupId,
+                  dcgm_field_eid_t entityId,
+                  unsigned short fieldId,
+                  long long value,
+                  timelib64_t timestamp);
+    void AddDouble(dcgm_field_entity_group_t entityGroupId,
+                   dcgm_field_eid_t entityId,
+                   unsigned short fieldId,
+                   double value,
+                   timelib64_t timestamp);
+
+    /*************************************************************************/
+    /*
+     * Returns true if there are samples and the flush interval has passed
+     * since the last Drain() as of now
+     */
+    bool IsFlushDue(timelib64_t now);
+
+    /*************************************************************************/
+    /*
+     * Move every sample in the ring to fvBuffer, oldest first, and start a new
+     * flush interval as of now
+     *
+     * Returns the number of samples added to fvBuffer
+     */
+    size_t Drain(DcgmFvBuffer &fvBuffer, timelib64_t now);
+
+    /* Samples waiting to be drained */
+    size_t Size();
+
+    /* Samples overwritten before they could be drained since the ring was created */
+    long long GetNumDropped();
+
+    /* Change how often IsFlushDue() says to drain, like when the watch's updateFreq changes */
+    void SetFlushInterval(timelib64_t flushIntervalUsec);
+
+private:
+    /* Get the slot for the next sample, overwriting the oldest one if needed. Caller holds m_mutex */
+    dcgm_ring_sample_t &NextSlot();
+
+    std::mutex m_mutex; /* Guards everything below */
+    std::vector<dcgm_ring_sample_t> m_samples;
+    timelib64_t m_flushIntervalUsec;
+    size_t m_head                = 0; /* Index of the oldest sample */
+    size_t m_count               = 0; /* Number of samples from m_head on */
+    timelib64_t m_lastDrainUsec  = 0;
+    long long m_numDropped       = 0;
+    long long m_numDroppedLogged = 0; /* m_numDropped as of the last warning about it */
+};
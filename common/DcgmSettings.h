@@ -30,6 +30,134 @@
 /* Environmental variable to bypass the white list */
 #define DCGM_ENV_WL_BYPASS "__DCGM_WL_BYPASS"
 
+/* Environmental variable to compress the cached history of long-lived numeric watches */
+#define DCGM_ENV_COMPRESS_HISTORY "__DCGM_COMPRESS_HISTORY"
+
+/* Environmental variable to fetch each GPU's watched fields on its own worker thread */
+#define DCGM_ENV_PARALLEL_GPU_FETCH "__DCGM_PARALLEL_GPU_FETCH"
+
+/* Environmental variable giving where the cache manager runs its threads. DCGM_THREAD_PLACEMENT_GPU pins the GPU
+   fetch workers to the CPUs near their GPU and the update thread to the CPUs near any GPU. See DcgmCpuPlacement.h */
+#define DCGM_ENV_THREAD_PLACEMENT "__DCGM_THREAD_PLACEMENT"
+
+/* Environmental variable giving what backs the cache manager's watches and samples. DCGM_CACHE_ARENAS_THP carves
+   them from per-GPU arenas of 2 MiB chunks that transparent huge pages can back. DCGM_CACHE_ARENAS_HUGETLB maps the
+   chunks from the hugetlbfs pool first. Unset = DCGM_CACHE_ARENAS_NONE, the heap. See DcgmCacheArena.h */
+#define DCGM_ENV_CACHE_ARENAS     "__DCGM_CACHE_ARENAS"
+#define DCGM_CACHE_ARENAS_NONE    "none"
+#define DCGM_CACHE_ARENAS_THP     "thp"
+#define DCGM_CACHE_ARENAS_HUGETLB "hugetlb"
+
+/* Environmental variable naming a file to keep the cache manager's samples in across hostengine restarts */
+#define DCGM_ENV_CACHE_SNAPSHOT "__DCGM_CACHE_SNAPSHOT"
+
+/* Environmental variable naming a file to keep client groups, field groups, watches, health watches and policies in
+   across hostengine restarts. See DcgmStateCheckpoint.h */
+#define DCGM_ENV_STATE_CHECKPOINT "__DCGM_STATE_CHECKPOINT"
+
+/* Environmental variable listing rollup tiers for long-retention numeric watches. See DcgmCacheRollup::ParseTiers() */
+#define DCGM_ENV_ROLLUP_TIERS "__DCGM_ROLLUP_TIERS"
+
+/* Environmental variable giving how far, in usec, watch deadlines may move to share a polling tick */
+#define DCGM_ENV_WATCH_COALESCE_USEC "__DCGM_WATCH_COALESCE_USEC"
+
+/* Environmental variable that turns on event-backed fields, which are then only polled this often in usec */
+#define DCGM_ENV_EVENT_FIELD_POLL_USEC "__DCGM_EVENT_FIELD_POLL_USEC"
+
+/* Environmental variable that turns on adaptive sampling with this base interval in usec. See SetAdaptiveSampling() */
+#define DCGM_ENV_ADAPTIVE_SAMPLING_USEC "__DCGM_ADAPTIVE_SAMPLING_USEC"
+
+/* Environmental variable overriding the relative deviation below which adaptive sampling decimates a watch */
+#define DCGM_ENV_ADAPTIVE_SAMPLING_THRESHOLD "__DCGM_ADAPTIVE_SAMPLING_THRESHOLD"
+
+/* Environmental variable to read power and utilization from the driver's sample buffers. See SetBufferedSampling() */
+#define DCGM_ENV_BUFFERED_SAMPLING "__DCGM_BUFFERED_SAMPLING"
+
+/* Environmental variable capping the bytes of samples the cache manager keeps across all watches */
+#define DCGM_ENV_CACHE_MEMORY_BUDGET "__DCGM_CACHE_MEMORY_BUDGET"
+
+/* Environmental variable naming a directory to spill samples that age out of the cache to. See DcgmCacheSpill.h */
+#define DCGM_ENV_SPILL_DIR "__DCGM_SPILL_DIR"
+
+/* Environmental variable capping the bytes of spilled samples. Unset = DCGM_CM_SPILL_DEFAULT_BUDGET_BYTES */
+#define DCGM_ENV_SPILL_BUDGET "__DCGM_SPILL_BUDGET"
+
+/* Environmental variable that starts update-loop tracing at startup with a ring of this many spans. 0 = default size */
+#define DCGM_ENV_TRACE_SPANS "__DCGM_TRACE_SPANS"
+
+/* Environmental variable naming the directory that trace dumps are written to. Defaults to /tmp */
+#define DCGM_ENV_TRACE_DIR "__DCGM_TRACE_DIR"
+
+/* Environmental variable that starts the binary log at startup with a ring of this many entries. 0 = default size */
+#define DCGM_ENV_BINARY_LOG_ENTRIES "__DCGM_BINARY_LOG_ENTRIES"
+
+/* Environmental variable forcing the SIMD kernels used for summaries: scalar, avx2, avx512 or neon */
+#define DCGM_ENV_SUMMARY_KERNEL "__DCGM_SUMMARY_KERNEL"
+
+/* Environmental variable giving how many event loop threads the hostengine spreads client connections over */
+#define DCGM_ENV_IPC_REACTORS "__DCGM_IPC_REACTORS"
+
+/* Environmental variable giving how many bytes may wait to be sent to one client before it counts as slow.
+   0 = unbounded */
+#define DCGM_ENV_IPC_SEND_QUEUE_BYTES "__DCGM_IPC_SEND_QUEUE_BYTES"
+
+/* Environmental variable picking what happens to slow clients: drop, coalesce or disconnect. See DcgmIpc.h */
+#define DCGM_ENV_IPC_SLOW_CONSUMER "__DCGM_IPC_SLOW_CONSUMER"
+
+/* Environmental variable giving the minimum worker threads of the hostengine's fast, admin and long-running request
+   lanes, like "2,1,2". A single number applies to every lane. See DcgmWorkerLanes.h */
+#define DCGM_ENV_IPC_WORKER_LANES "__DCGM_IPC_WORKER_LANES"
+
+/* Environmental variable giving the most worker threads each request lane grows to while requests wait for a worker,
+   in the same form as DCGM_ENV_IPC_WORKER_LANES */
+#define DCGM_ENV_IPC_MAX_WORKER_LANES "__DCGM_IPC_MAX_WORKER_LANES"
+
+/* Environmental variable that, if set to 1, has the hostengine's IPC workers each keep their own queue and steal from
+   each other instead of sharing one queue. See WorkStealingThreadPool.hpp */
+#define DCGM_ENV_IPC_WORK_STEALING "__DCGM_IPC_WORK_STEALING"
+
+/* Environmental variable listing the host engines a proxy hostengine collects from, like
+   "10.0.0.1,10.0.0.2:5555,unix:/tmp/he.sock". See DcgmProxyManager.h */
+#define DCGM_ENV_PROXY_HOSTS "__DCGM_PROXY_HOSTS"
+
+/* Environmental variable giving the [ip:]port the hostengine serves OpenMetrics scrapes on, like "9400" or
+   "127.0.0.1:9400". Unset = no endpoint. See DcgmMetricsExporter.h */
+#define DCGM_ENV_METRICS_LISTEN "__DCGM_METRICS_LISTEN"
+
+/* Environmental variable listing the field IDs the OpenMetrics endpoint exports, like "150,155,203".
+   Unset = DcgmMetricsExporter::DefaultFieldIds() */
+#define DCGM_ENV_METRICS_FIELDS "__DCGM_METRICS_FIELDS"
+
+/* Environmental variable giving the URL the hostengine pushes OTLP metrics to, like
+   "http://localhost:4318/v1/metrics". Unset = no push. The fields are DCGM_ENV_METRICS_FIELDS.
+   See DcgmOtlpExporter.h */
+#define DCGM_ENV_OTLP_ENDPOINT "__DCGM_OTLP_ENDPOINT"
+
+/* Environmental variable giving how many seconds apart OTLP metrics are pushed.
+   Unset = DcgmOtlpExporter::DEFAULT_INTERVAL_USEC */
+#define DCGM_ENV_OTLP_INTERVAL "__DCGM_OTLP_INTERVAL"
+
+/* Environmental variable giving the name of the shared memory segment the hostengine publishes the latest values
+   to, like "/nvidia-dcgm-latest". Unset = no board. See dcgm_latest_board.h */
+#define DCGM_ENV_LATEST_BOARD "__DCGM_LATEST_BOARD"
+
+/* Environmental variable listing the field IDs the latest value board publishes, like "150,155,203".
+   Unset = DcgmMetricsExporter::DefaultFieldIds() */
+#define DCGM_ENV_LATEST_BOARD_FIELDS "__DCGM_LATEST_BOARD_FIELDS"
+
+/* Environmental variable capping how many stopped jobs the hostengine keeps stats of until they are removed.
+   The longest stopped are evicted first. 0 = no cap. See DcgmJobStatsAccumulator.h */
+#define DCGM_ENV_MAX_STOPPED_JOBS "__DCGM_MAX_STOPPED_JOBS"
+
+/* Environmental variable giving how many seconds after it stopped a job that isn't removed is evicted.
+   0 = never */
+#define DCGM_ENV_STOPPED_JOB_TTL_SEC "__DCGM_STOPPED_JOB_TTL_SEC"
+
+/* Environmental variable giving when the hostengine loads modules, like "1=lazy,7=eager". Policies are eager (at
+   startup), lazy (on first use) and prewarm (in the background once the hostengine is listening). Keys are
+   DcgmModuleId values. Unlisted modules keep their default: prewarm for NvSwitch and lazy for the others */
+#define DCGM_ENV_MODULE_LOAD_POLICY "__DCGM_MODULE_LOAD_POLICY"
+
 #define DCGM_MODE_EMBEDDED_HE   0 /* Mode when Host Engine is Embedded. ISV Agent Use Case */
 #define DCGM_MODE_STANDALONE_HE 1 /* Mode when Host Engine is Standalone. NV Agent Use Case */
 
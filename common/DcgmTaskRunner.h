@@ -28,6 +28,10 @@ class DcgmTaskRunner
     , public DcgmNs::TaskRunner
 {
 public:
+    explicit DcgmTaskRunner(DcgmNs::TaskQueueKind queueKind = DcgmNs::TaskQueueKind::Locked)
+        : DcgmNs::TaskRunner(queueKind)
+    {}
+
     ~DcgmTaskRunner() override;
 
     /** Virtual method inherited from DcgmThread that is the main() for this thread */
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmTrace.h"
+#include "DcgmLogging.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace DcgmNs
+{
+namespace
+{
+    std::mutex g_startMutex;
+
+    unsigned int CurrentTid()
+    {
+        thread_local unsigned int tid = (unsigned int)syscall(SYS_gettid);
+        return tid;
+    }
+} // namespace
+
+/*****************************************************************************/
+Tracer &Tracer::Instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+/*****************************************************************************/
+Tracer::Tracer()
+    : m_enabled(false)
+    , m_slots(nullptr)
+    , m_capacity(0)
+    , m_next(0)
+{}
+
+/*****************************************************************************/
+void Tracer::Start(size_t numSpans)
+{
+    std::lock_guard<std::mutex> guard(g_startMutex);
+
+    if (!m_ring)
+    {
+        m_capacity = numSpans ? numSpans : DCGM_TRACE_DEFAULT_SPANS;
+        m_ring     = std::make_unique<Slot[]>(m_capacity);
+        for (size_t i = 0; i < m_capacity; i++)
+        {
+            m_ring[i].seq.store(0, std::memory_order_relaxed);
+        }
+        m_slots.store(m_ring.get(), std::memory_order_release);
+        DCGM_LOG_INFO << "Tracing started with room for " << m_capacity << " spans";
+    }
+
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+void Tracer::Stop(void)
+{
+    m_enabled.store(false, std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+size_t Tracer::Capacity(void) const
+{
+    return m_slots.load(std::memory_order_acquire) ? m_capacity : 0;
+}
+
+/*****************************************************************************/
+void Tracer::Record(char const *category,
+                    char const *name,
+                    timelib64_t startUsec,
+                    timelib64_t durationUsec,
+                    long long arg)
+{
+    Slot *slots = m_slots.load(std::memory_order_acquire);
+    if (!slots)
+    {
+        return;
+    }
+
+    std::uint64_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot          = slots[index % m_capacity];
+
+    slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.span = TraceSpan { category, name, startUsec, durationUsec, arg, CurrentTid() };
+    slot.seq.store(2 * (index + 1), std::memory_order_release);
+}
+
+/*****************************************************************************/
+std::vector<TraceSpan> Tracer::Snapshot(void) const
+{
+    std::vector<TraceSpan> spans;
+    Slot const *slots = m_slots.load(std::memory_order_acquire);
+    if (!slots)
+    {
+        return spans;
+    }
+
+    std::uint64_t next  = m_next.load(std::memory_order_relaxed);
+    std::uint64_t first = next > m_capacity ? next - m_capacity : 0;
+    spans.reserve(next - first);
+
+    for (std::uint64_t index = first; index < next; index++)
+    {
+        Slot const &slot     = slots[index % m_capacity];
+        std::uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before != 2 * (index + 1))
+        {
+            continue; /* Not written yet or already overwritten */
+        }
+
+        TraceSpan span = slot.span;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before)
+        {
+            spans.push_back(span);
+        }
+    }
+
+    return spans;
+}
+
+/*****************************************************************************/
+std::string Tracer::ToChromeTraceJson(std::vector<TraceSpan> const &spans, int pid)
+{
+    std::stringstream ss;
+
+    ss << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < spans.size(); i++)
+    {
+        TraceSpan const &span = spans[i];
+        ss << (i ? ",\n" : "\n") << "{\"name\":\"" << span.name << "\",\"cat\":\"" << span.category
+           << "\",\"ph\":\"X\",\"ts\":" << span.startUsec << ",\"dur\":" << span.durationUsec << ",\"pid\":" << pid
+           << ",\"tid\":" << span.tid;
+        if (span.arg != 0)
+        {
+            ss << ",\"args\":{\"arg\":" << span.arg << "}";
+        }
+        ss << "}";
+    }
+    ss << "\n]}\n";
+
+    return ss.str();
+}
+
+/*****************************************************************************/
+dcgmReturn_t Tracer::WriteChromeTrace(std::string const &directory, std::string &filename) const
+{
+    if (!Capacity())
+    {
+        return DCGM_ST_UNINITIALIZED;
+    }
+
+    std::string json = ToChromeTraceJson(Snapshot(), (int)getpid());
+
+    return WriteDumpFile(directory, "dcgm-trace-XXXXXX.json", 5, json, filename);
+}
+
+/*****************************************************************************/
+dcgmReturn_t WriteDumpFile(std::string const &directory,
+                           char const *nameTemplate,
+                           int suffixLength,
+                           std::string const &contents,
+                           std::string &filename)
+{
+    std::string path = directory + "/" + nameTemplate;
+    int fd           = mkstemps(&path[0], suffixLength);
+    if (fd < 0)
+    {
+        DCGM_LOG_ERROR << "Unable to create a dump file in " << directory << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    /* Dumps carry no secrets. Let whoever asked for the dump open it */
+    fchmod(fd, 0644);
+
+    size_t written = 0;
+    while (written < contents.size())
+    {
+        ssize_t ret = write(fd, contents.data() + written, contents.size() - written);
+        if (ret < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ret <= 0)
+        {
+            DCGM_LOG_ERROR << "Error writing dump file " << path << ": " << strerror(errno);
+            close(fd);
+            unlink(path.c_str());
+            return DCGM_ST_GENERIC_ERROR;
+        }
+        written += ret;
+    }
+
+    close(fd);
+    filename = path;
+    return DCGM_ST_OK;
+}
+
+} // namespace DcgmNs
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+#include "timelib.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Number of spans kept when tracing is started without a size */
+#define DCGM_TRACE_DEFAULT_SPANS 65536
+
+namespace DcgmNs
+{
+/*****************************************************************************/
+/* One timed section of code. category and name must be string literals */
+struct TraceSpan
+{
+    char const *category;
+    char const *name;
+    timelib64_t startUsec;
+    timelib64_t durationUsec;
+    long long arg;   /* Optional detail such as a field or command ID. Shown under "args" */
+    unsigned int tid; /* Kernel thread ID of the recording thread */
+};
+
+/*****************************************************************************/
+/*
+ * Process-wide ring buffer of the most recent spans, for finding where the
+ * time went when an update loop or request overruns. Off until Start().
+ * While off, a TraceScope costs one relaxed atomic load.
+ *
+ * Recording is lock-free. Each slot is guarded by a sequence number so that
+ * Snapshot() skips slots that are being overwritten instead of blocking
+ * writers.
+ */
+class Tracer
+{
+public:
+    static Tracer &Instance();
+
+    /*************************************************************************/
+    /*
+     * Start recording. The ring is allocated by the first Start() and keeps its
+     * size for the life of the process, so numSpans is ignored after that.
+     * 0 = DCGM_TRACE_DEFAULT_SPANS
+     */
+    void Start(size_t numSpans);
+
+    /* Stop recording. Recorded spans are kept for Snapshot() */
+    void Stop(void);
+
+    bool IsEnabled(void) const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void Record(char const *category, char const *name, timelib64_t startUsec, timelib64_t durationUsec, long long arg);
+
+    /* Get the spans in the ring, oldest first */
+    std::vector<TraceSpan> Snapshot(void) const;
+
+    /* Number of slots in the ring. 0 = never started */
+    size_t Capacity(void) const;
+
+    /*************************************************************************/
+    /*
+     * Format spans as Chrome trace event JSON, which chrome://tracing and
+     * Perfetto load directly
+     */
+    static std::string ToChromeTraceJson(std::vector<TraceSpan> const &spans, int pid);
+
+    /*************************************************************************/
+    /*
+     * Write the current spans as Chrome trace JSON to a new file in directory.
+     * The file is created exclusively, so an existing file or link is never
+     * followed.
+     *
+     * filename OUT: Path of the file that was written
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_UNINITIALIZED if tracing was never started
+     *         DCGM_ST_GENERIC_ERROR if the file couldn't be written
+     */
+    dcgmReturn_t WriteChromeTrace(std::string const &directory, std::string &filename) const;
+
+private:
+    Tracer();
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> seq; /* 0 = empty. Odd = being written. Else 2 * (index + 1) */
+        TraceSpan span;
+    };
+
+    std::atomic<bool> m_enabled;
+    std::atomic<Slot *> m_slots;   /* Published once by the first Start() */
+    std::unique_ptr<Slot[]> m_ring; /* Owns m_slots */
+    size_t m_capacity;
+    std::atomic<std::uint64_t> m_next; /* Index of the next span to record */
+};
+
+/*****************************************************************************/
+/*
+ * Write contents to a new file in directory, named after nameTemplate with its
+ * XXXXXX replaced as by mkstemps(). The file is created exclusively, so an
+ * existing file or link is never followed.
+ *
+ * suffixLength: Length of what follows XXXXXX in nameTemplate
+ * filename OUT: Path of the file that was written
+ *
+ * Returns DCGM_ST_OK on success
+ *         DCGM_ST_GENERIC_ERROR if the file couldn't be written
+ */
+dcgmReturn_t WriteDumpFile(std::string const &directory,
+                           char const *nameTemplate,
+                           int suffixLength,
+                           std::string const &contents,
+                           std::string &filename);
+
+/*****************************************************************************/
+/* Records a span from construction to destruction if tracing is on */
+class TraceScope
+{
+public:
+    TraceScope(char const *category, char const *name, long long arg = 0)
+        : m_category(category)
+        , m_name(name)
+        , m_arg(arg)
+        , m_startUsec(Tracer::Instance().IsEnabled() ? timelib_usecSince1970() : 0)
+    {}
+
+    ~TraceScope()
+    {
+        End();
+    }
+
+    /* Record the span now instead of at destruction. Later calls do nothing */
+    void End(void)
+    {
+        if (m_startUsec != 0)
+        {
+            Tracer::Instance().Record(m_category, m_name, m_startUsec, timelib_usecSince1970() - m_startUsec, m_arg);
+            m_startUsec = 0;
+        }
+    }
+
+    TraceScope(TraceScope const &) = delete;
+    TraceScope &operator=(TraceScope const &) = delete;
+
+private:
+    char const *m_category;
+    char const *m_name;
+    long long m_arg;
+    timelib64_t m_startUsec;
+};
+
+} // namespace DcgmNs
+
+#define DCGM_TRACE_CONCAT_INNER(a, b) a##b
+#define DCGM_TRACE_CONCAT(a, b)       DCGM_TRACE_CONCAT_INNER(a, b)
+
+/* Trace the rest of the enclosing scope as category/name, e.g. DCGM_TRACE_SCOPE("cache", "RunLockStep") */
+#define DCGM_TRACE_SCOPE(...) DcgmNs::TraceScope DCGM_TRACE_CONCAT(dcgmTraceScope, __LINE__)(__VA_ARGS__)
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <dcgm_fields.h>
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+namespace DcgmNs
+{
+/**
+ * Index of per-entity, per-field watches without any hashing for the common case.
+ *
+ * Entity group IDs, entity IDs and field IDs are mostly small dense integers, so values are found
+ * with array lookups: group -> entity -> field. Each entity gets a table of DCGM_FI_MAX_FIELDS slots
+ * the first time one of its fields is added. Entity IDs of DenseEntityLimit and above (vGPUs,
+ * NvLinks) go through a map to find their field table instead.
+ *
+ * Every value is also kept in a packed vector in insertion order so that walking all watches reads
+ * contiguous memory.
+ *
+ * The index doesn't own its values. Values can't be removed individually. The cache manager and
+ * DcgmWatchTable keep their watch infos until they are cleared and mark them unwatched instead.
+ *
+ * This class is not thread safe.
+ *
+ * @tparam T Type of the values. The index stores T pointers
+ */
+template <typename T>
+class DenseWatchIndex
+{
+public:
+    /** Entity IDs below this are looked up by array index */
+    static constexpr unsigned int DenseEntityLimit = 1024;
+
+    /**
+     * Find a value
+     * @return The value or nullptr if there is none for this key
+     */
+    T *Get(unsigned int entityGroupId, unsigned int entityId, unsigned int fieldId) const
+    {
+        if (fieldId >= DCGM_FI_MAX_FIELDS)
+        {
+            return nullptr;
+        }
+
+        T *const *fields = FindFields(entityGroupId, entityId);
+        return fields ? fields[fieldId] : nullptr;
+    }
+
+    /**
+     * Add a value for a key that doesn't have one yet
+     * @return true if value was added
+     *         false if the key is out of range or already has a value
+     */
+    bool Insert(unsigned int entityGroupId, unsigned int entityId, unsigned int fieldId, T *value)
+    {
+        if (value == nullptr || entityGroupId >= DCGM_FE_COUNT || fieldId >= DCGM_FI_MAX_FIELDS)
+        {
+            return false;
+        }
+
+        Group &group = m_groups[entityGroupId];
+        std::unique_ptr<T *[]> *fields;
+        if (entityId < DenseEntityLimit)
+        {
+            if (entityId >= group.dense.size())
+            {
+                group.dense.resize(entityId + 1);
+            }
+            fields = &group.dense[entityId];
+        }
+        else
+        {
+            fields = &group.sparse[entityId];
+        }
+
+        if (!*fields)
+        {
+            fields->reset(new T *[DCGM_FI_MAX_FIELDS]());
+        }
+
+        if ((*fields)[fieldId] != nullptr)
+        {
+            return false;
+        }
+
+        (*fields)[fieldId] = value;
+        m_values.push_back(value);
+        return true;
+    }
+
+    /**
+     * @return Every value in the index, in insertion order
+     */
+    std::vector<T *> const &Values() const
+    {
+        return m_values;
+    }
+
+    std::size_t Size() const
+    {
+        return m_values.size();
+    }
+
+    /**
+     * Remove every value. The values themselves aren't freed
+     */
+    void Clear()
+    {
+        for (auto &group : m_groups)
+        {
+            group.dense.clear();
+            group.sparse.clear();
+        }
+        m_values.clear();
+    }
+
+private:
+    struct Group
+    {
+        std::vector<std::unique_ptr<T *[]>> dense;                      /*!< Field tables by entityId */
+        std::unordered_map<unsigned int, std::unique_ptr<T *[]>> sparse; /*!< Field tables of large entityIds */
+    };
+
+    T *const *FindFields(unsigned int entityGroupId, unsigned int entityId) const
+    {
+        if (entityGroupId >= DCGM_FE_COUNT)
+        {
+            return nullptr;
+        }
+
+        Group const &group = m_groups[entityGroupId];
+        if (entityId < DenseEntityLimit)
+        {
+            return entityId < group.dense.size() ? group.dense[entityId].get() : nullptr;
+        }
+
+        auto it = group.sparse.find(entityId);
+        return it != group.sparse.end() ? it->second.get() : nullptr;
+    }
+
+    std::array<Group, DCGM_FE_COUNT> m_groups;
+    std::vector<T *> m_values;
+};
+
+} // namespace DcgmNs
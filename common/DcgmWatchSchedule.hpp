@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <timelib.h>
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+
+namespace DcgmNs
+{
+/**
+ * Deadline scheduler for watches, so that a poll only touches the watches that are due.
+ *
+ * This is a min-heap of (due time, watch). Rescheduling a watch pushes a new entry instead of
+ * moving the old one: the watch's nextUpdateUsec is its one live deadline, and entries that don't
+ * match it, or whose watch is no longer watched, are stale and skipped. Rebuild() drops the stale
+ * entries once ShouldRebuild() says they dominate.
+ *
+ * The schedule doesn't own its values. This class is not thread safe.
+ *
+ * @tparam T Type of the watches. T needs an isWatched member and a timelib64_t nextUpdateUsec
+ *           member, where 0 means unscheduled
+ */
+template <typename T>
+class WatchSchedule
+{
+public:
+    /**
+     * Make dueUsec the deadline of value, replacing any earlier one. Deadlines before 1 are
+     * moved to 1 since 0 means unscheduled
+     * @return false if value was already due at dueUsec
+     */
+    bool Schedule(T *value, timelib64_t dueUsec)
+    {
+        if (dueUsec < 1)
+        {
+            dueUsec = 1;
+        }
+
+        if (value->nextUpdateUsec == dueUsec)
+        {
+            return false;
+        }
+
+        value->nextUpdateUsec = dueUsec;
+        m_heap.push(Deadline(dueUsec, value));
+        return true;
+    }
+
+    /**
+     * Append the values that are due by now to due, earliest first, and unschedule them
+     */
+    void PopDue(timelib64_t now, std::vector<T *> &due)
+    {
+        while (!m_heap.empty() && m_heap.top().first <= now)
+        {
+            Deadline deadline = m_heap.top();
+            m_heap.pop();
+
+            if (!IsLive(deadline))
+            {
+                continue;
+            }
+
+            deadline.second->nextUpdateUsec = 0;
+            due.push_back(deadline.second);
+        }
+    }
+
+    /**
+     * @return The earliest deadline of any value or 0 if nothing is scheduled
+     */
+    timelib64_t NextDueUsec()
+    {
+        /* Discard any stale entries in the way */
+        while (!m_heap.empty())
+        {
+            if (IsLive(m_heap.top()))
+            {
+                return m_heap.top().first;
+            }
+            m_heap.pop();
+        }
+        return 0;
+    }
+
+    /**
+     * @return Number of entries, stale ones included
+     */
+    std::size_t Size() const
+    {
+        return m_heap.size();
+    }
+
+    /**
+     * Each value has at most one live entry.
+     * @return true once stale entries outnumber the numValues values that could be live
+     */
+    bool ShouldRebuild(std::size_t numValues) const
+    {
+        return m_heap.size() > 2 * numValues + 64;
+    }
+
+    /**
+     * Replace the entries with the deadlines of values. Values that aren't watched are
+     * unscheduled
+     */
+    void Rebuild(std::vector<T *> const &values)
+    {
+        Heap live;
+        for (T *value : values)
+        {
+            if (!value->isWatched)
+            {
+                value->nextUpdateUsec = 0;
+            }
+            if (value->nextUpdateUsec)
+            {
+                live.push(Deadline(value->nextUpdateUsec, value));
+            }
+        }
+        m_heap.swap(live);
+    }
+
+    /**
+     * Remove every entry. The values' nextUpdateUsec are left as they are
+     */
+    void Clear()
+    {
+        m_heap = Heap();
+    }
+
+private:
+    using Deadline = std::pair<timelib64_t, T *>;
+    using Heap     = std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>;
+
+    static bool IsLive(Deadline const &deadline)
+    {
+        return deadline.second->isWatched && deadline.second->nextUpdateUsec == deadline.first;
+    }
+
+    Heap m_heap;
+};
+
+} // namespace DcgmNs
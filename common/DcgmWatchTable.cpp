@@ -21,37 +21,38 @@
 /*****************************************************************************/
 DcgmWatchTable::DcgmWatchTable()
     : m_mutex(0)
-    , m_entityWatchHashTable()
+    , m_watchInfos()
+    , m_watchIndex()
+    , m_schedules()
 {}
 
 /*****************************************************************************/
 void DcgmWatchTable::ClearWatches()
 {
     DcgmLockGuard dlg(&m_mutex);
-    m_entityWatchHashTable.clear();
+    m_watchIndex.Clear();
+    for (auto &schedule : m_schedules)
+    {
+        schedule.Clear();
+    }
+    m_watchInfos.clear();
 }
 
 /*****************************************************************************/
 dcgmReturn_t DcgmWatchTable::ClearEntityWatches(dcgm_field_entity_group_t entityGroupId, dcgm_field_eid_t entityId)
 {
-    dcgmReturn_t ret = DCGM_ST_OK;
-    std::vector<dcgm_entity_key_t> toRemove;
     DcgmLockGuard dlg(&m_mutex);
 
-    for (auto &[watchKey, watchInfo] : m_entityWatchHashTable)
+    for (dcgm_watch_info_t *watchInfo : m_watchIndex.Values())
     {
-        if (watchKey.entityGroupId == entityGroupId && watchKey.entityId == entityId)
+        if (watchInfo->watchKey.entityGroupId == entityGroupId && watchInfo->watchKey.entityId == entityId)
         {
-            toRemove.push_back(watchKey);
+            /* Back to a never-watched state. Its schedule entries become stale */
+            *watchInfo = dcgm_watch_info_t();
         }
     }
 
-    for (auto &&watchKey : toRemove)
-    {
-        m_entityWatchHashTable.erase(watchKey);
-    }
-
-    return ret;
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
@@ -70,29 +71,58 @@ dcgmReturn_t DcgmWatchTable::RemoveWatches(DcgmWatcher watcher,
     watcherInfo.watcher = watcher;
     DcgmLockGuard dlg(&m_mutex);
 
-    for (auto &[watchkey, watchInfo] : m_entityWatchHashTable)
+    for (dcgm_watch_info_t *watchInfo : m_watchIndex.Values())
     {
         /* RemoveWatcher will log any failures */
-        RemoveWatcher(watchInfo, watcherInfo, postWatchInfo);
+        RemoveWatcher(*watchInfo, watcherInfo, postWatchInfo);
     }
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-bool DcgmWatchTable::IsFieldIgnored(unsigned int fieldId, dcgmModuleId_t currentModule)
+dcgmModuleId_t DcgmWatchTable::GetFieldModule(unsigned int fieldId)
 {
-    switch (currentModule)
+    if (fieldId < DCGM_FI_DEV_NVSWITCH_LATENCY_LOW_P00)
+    {
+        return DcgmModuleIdCore;
+    }
+    else if (fieldId < DCGM_FI_LAST_NVSWITCH_FIELD_ID)
     {
-        case DcgmModuleIdCore:
-            return fieldId >= DCGM_FI_DEV_NVSWITCH_LATENCY_LOW_P00;
-        case DcgmModuleIdNvSwitch:
-            return fieldId < DCGM_FI_DEV_NVSWITCH_LATENCY_LOW_P00 || fieldId >= DCGM_FI_LAST_NVSWITCH_FIELD_ID;
-        case DcgmModuleIdProfiling:
-            return fieldId < DCGM_FI_PROF_FIRST_ID || fieldId > DCGM_FI_PROF_LAST_ID;
-        default:
-            return true;
+        return DcgmModuleIdNvSwitch;
     }
+    else if (fieldId >= DCGM_FI_PROF_FIRST_ID && fieldId <= DCGM_FI_PROF_LAST_ID)
+    {
+        return DcgmModuleIdProfiling;
+    }
+
+    return DcgmModuleIdCount;
+}
+
+/*****************************************************************************/
+void DcgmWatchTable::ScheduleWatch(dcgm_watch_info_t &watchInfo, timelib64_t dueUsec)
+{
+    dcgmModuleId_t moduleId = GetFieldModule(watchInfo.watchKey.fieldId);
+    if (moduleId >= DcgmModuleIdCount)
+    {
+        return; /* Nothing would ever update it */
+    }
+
+    auto &schedule = m_schedules[moduleId];
+    if (!schedule.Schedule(&watchInfo, dueUsec) || !schedule.ShouldRebuild(m_watchIndex.Size()))
+    {
+        return;
+    }
+
+    std::vector<dcgm_watch_info_t *> moduleWatches;
+    for (dcgm_watch_info_t *wi : m_watchIndex.Values())
+    {
+        if (GetFieldModule(wi->watchKey.fieldId) == moduleId)
+        {
+            moduleWatches.push_back(wi);
+        }
+    }
+    schedule.Rebuild(moduleWatches);
 }
 
 const int GLOBAL_WATCH_ENTITY_INDEX = -1;
@@ -182,6 +212,7 @@ dcgmReturn_t DcgmWatchTable::UpdateWatchFromWatchers(dcgm_watch_info_t &watchInf
     watchInfo.updateIntervalUsec    = minUpdateIntervalUsec;
     watchInfo.maxAgeUsec            = minMaxAgeUsec;
     watchInfo.hasSubscribedWatchers = hasSubscribedWatchers;
+    ScheduleWatch(watchInfo, watchInfo.lastQueriedUsec + watchInfo.updateIntervalUsec);
 
     DCGM_LOG_DEBUG << "UpdateWatchFromWatchers minUpdateIntervalUsec " << minUpdateIntervalUsec << ", minMaxAgeUsec "
                    << minMaxAgeUsec << ", hsw " << watchInfo.hasSubscribedWatchers;
@@ -189,77 +220,55 @@ dcgmReturn_t DcgmWatchTable::UpdateWatchFromWatchers(dcgm_watch_info_t &watchInf
     return DCGM_ST_OK;
 }
 
-/*****************************************************************************/
-static inline void UpdateNextUpdateTime(timelib64_t &earliestNextUpdate, timelib64_t fieldNextUpdate)
-{
-    if (!(earliestNextUpdate) || fieldNextUpdate < earliestNextUpdate)
-    {
-        earliestNextUpdate = fieldNextUpdate;
-    }
-}
-
 /*****************************************************************************/
 dcgmReturn_t DcgmWatchTable::GetFieldsToUpdate(dcgmModuleId_t currentModule,
                                                timelib64_t now,
                                                std::vector<dcgm_field_update_info_t> &toUpdate,
                                                timelib64_t &earliestNextUpdate)
 {
-    timelib64_t age;
-    timelib64_t nextUpdate;
     dcgm_field_meta_p fieldMeta = 0;
+    std::vector<dcgm_watch_info_t *> dueWatches;
 
     earliestNextUpdate = 0;
     DcgmLockGuard dlg(&m_mutex);
 
-    /* Walk the hash table of watch objects, looking for any that have expired */
-    for (auto &[watchkey, watchInfo] : m_entityWatchHashTable)
+    /* Fields updated by other modules are in other schedules */
+    if (currentModule >= DcgmModuleIdCount)
     {
-        if (!watchInfo.isWatched)
-        {
-            continue; /* Not watched */
-        }
-
-        /* Some fields are pushed by modules. Don't handle those fields here */
-        if (IsFieldIgnored(watchInfo.watchKey.fieldId, currentModule))
-        {
-            continue;
-        }
+        return DCGM_ST_OK;
+    }
 
-        /* Last sample time old enough to take another? */
-        age = now - watchInfo.lastQueriedUsec;
-        if (age < watchInfo.updateIntervalUsec)
-        {
-            nextUpdate = watchInfo.lastQueriedUsec + watchInfo.updateIntervalUsec;
-            UpdateNextUpdateTime(earliestNextUpdate, nextUpdate);
-            continue; /* Not old enough to update */
-        }
+    auto &schedule = m_schedules[currentModule];
+    schedule.PopDue(now, dueWatches);
 
-        fieldMeta = DcgmFieldGetById(watchInfo.watchKey.fieldId);
+    for (dcgm_watch_info_t *watchInfo : dueWatches)
+    {
+        fieldMeta = DcgmFieldGetById(watchInfo->watchKey.fieldId);
         if (fieldMeta == nullptr)
         {
-            DCGM_LOG_ERROR << "Unexpected null fieldMeta for field " << watchInfo.watchKey.fieldId;
+            DCGM_LOG_ERROR << "Unexpected null fieldMeta for field " << watchInfo->watchKey.fieldId;
             continue;
         }
 
-        DCGM_LOG_DEBUG << "Preparing to update watchInfo 0x" << std::hex << (void *)&watchInfo << ", eg " << std::dec
-                       << watchInfo.watchKey.entityGroupId << ", eid " << watchInfo.watchKey.entityId << ", fieldId "
-                       << watchInfo.watchKey.fieldId;
-
-        /* Base when we sync again on before the driver call so we don't continuously
-         * get behind by how long the driver call took
-         */
-        nextUpdate = now + watchInfo.updateIntervalUsec;
-        UpdateNextUpdateTime(earliestNextUpdate, nextUpdate);
+        DCGM_LOG_DEBUG << "Preparing to update watchInfo 0x" << std::hex << (void *)watchInfo << ", eg " << std::dec
+                       << watchInfo->watchKey.entityGroupId << ", eid " << watchInfo->watchKey.entityId
+                       << ", fieldId " << watchInfo->watchKey.fieldId;
 
         // At this point we know we want to update the field
         dcgm_field_update_info_t updateInfo;
-        updateInfo.entityGroupId  = static_cast<dcgm_field_entity_group_t>(watchInfo.watchKey.entityGroupId);
-        updateInfo.entityId       = watchInfo.watchKey.entityId;
-        updateInfo.fieldMeta      = fieldMeta;
-        watchInfo.lastQueriedUsec = now;
+        updateInfo.entityGroupId   = static_cast<dcgm_field_entity_group_t>(watchInfo->watchKey.entityGroupId);
+        updateInfo.entityId        = watchInfo->watchKey.entityId;
+        updateInfo.fieldMeta       = fieldMeta;
+        watchInfo->lastQueriedUsec = now;
         toUpdate.push_back(updateInfo);
+
+        /* Base when we sync again on before the driver call so we don't continuously
+         * get behind by how long the driver call took
+         */
+        ScheduleWatch(*watchInfo, now + watchInfo->updateIntervalUsec);
     }
 
+    earliestNextUpdate = schedule.NextDueUsec();
     return DCGM_ST_OK;
 }
 
@@ -280,7 +289,21 @@ bool DcgmWatchTable::AddWatcher(dcgm_field_entity_group_t entityGroupId,
     watcherInfo.maxAgeUsec         = maxAgeUsec;
     watcherInfo.isSubscribed       = isSubscribed;
 
-    dcgm_watch_info_t &watchInfo = m_entityWatchHashTable[key];
+    dcgm_watch_info_t *existing = m_watchIndex.Get(entityGroupId, entityId, fieldId);
+    if (existing == nullptr)
+    {
+        m_watchInfos.emplace_back();
+        if (!m_watchIndex.Insert(entityGroupId, entityId, fieldId, &m_watchInfos.back()))
+        {
+            m_watchInfos.pop_back();
+            DCGM_LOG_ERROR << "Unable to watch eg " << entityGroupId << ", eid " << entityId << ", fieldId "
+                           << fieldId;
+            return false;
+        }
+        existing = &m_watchInfos.back();
+    }
+
+    dcgm_watch_info_t &watchInfo = *existing;
     bool newWatch = watchInfo.watchKey.fieldId == DCGM_FI_UNKNOWN && watchInfo.watchKey.entityGroupId == DCGM_FE_NONE;
     if (newWatch)
     {
@@ -304,6 +327,7 @@ bool DcgmWatchTable::AddWatcher(dcgm_field_entity_group_t entityGroupId,
         watchInfo.hasSubscribedWatchers = true;
     }
 
+    ScheduleWatch(watchInfo, watchInfo.lastQueriedUsec + watchInfo.updateIntervalUsec);
     return newWatch;
 }
 
@@ -329,10 +353,9 @@ timelib64_t DcgmWatchTable::GetUpdateIntervalUsec(dcgm_field_entity_group_t enti
                                                   dcgm_field_eid_t entityId,
                                                   unsigned short fieldId)
 {
-    dcgm_entity_key_t key { entityId, fieldId, entityGroupId };
     DcgmLockGuard dlg(&m_mutex);
-    dcgm_watch_info_t &watchInfo = m_entityWatchHashTable[key];
-    return watchInfo.updateIntervalUsec;
+    dcgm_watch_info_t *watchInfo = m_watchIndex.Get(entityGroupId, entityId, fieldId);
+    return watchInfo != nullptr ? watchInfo->updateIntervalUsec : 0;
 }
 
 /*****************************************************************************/
@@ -340,10 +363,9 @@ timelib64_t DcgmWatchTable::GetMaxAgeUsec(dcgm_field_entity_group_t entityGroupI
                                           dcgm_field_eid_t entityId,
                                           unsigned short fieldId)
 {
-    dcgm_entity_key_t key { entityId, fieldId, entityGroupId };
     DcgmLockGuard dlg(&m_mutex);
-    dcgm_watch_info_t &watchInfo = m_entityWatchHashTable[key];
-    return watchInfo.maxAgeUsec;
+    dcgm_watch_info_t *watchInfo = m_watchIndex.Get(entityGroupId, entityId, fieldId);
+    return watchInfo != nullptr ? watchInfo->maxAgeUsec : 0;
 }
 
 /*****************************************************************************/
@@ -351,10 +373,9 @@ bool DcgmWatchTable::GetIsSubscribed(dcgm_field_entity_group_t entityGroupId,
                                      dcgm_field_eid_t entityId,
                                      unsigned short fieldId)
 {
-    dcgm_entity_key_t key { entityId, fieldId, entityGroupId };
     DcgmLockGuard dlg(&m_mutex);
-    dcgm_watch_info_t &watchInfo = m_entityWatchHashTable[key];
-    return watchInfo.hasSubscribedWatchers;
+    dcgm_watch_info_t *watchInfo = m_watchIndex.Get(entityGroupId, entityId, fieldId);
+    return watchInfo != nullptr ? watchInfo->hasSubscribedWatchers : false;
 }
 
 /*****************************************************************************/
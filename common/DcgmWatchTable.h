@@ -20,9 +20,14 @@
 #include <hashtable.h>
 #include <timelib.h>
 #include <timeseries.h>
+
+#include <array>
+#include <deque>
 #include <unordered_map>
 
 #include "DcgmMutex.h"
+#include "DcgmWatchIndex.hpp"
+#include "DcgmWatchSchedule.hpp"
 #include "DcgmWatcher.h"
 
 /*****************************************************************************/
@@ -83,6 +88,7 @@ struct dcgm_watch_info_t
         , isWatched(false)
         , hasSubscribedWatchers(false)
         , lastQueriedUsec(0)
+        , nextUpdateUsec(0)
         , updateIntervalUsec(0)
         , maxAgeUsec(0)
         , watchers()
@@ -97,6 +103,8 @@ struct dcgm_watch_info_t
     timelib64_t lastQueriedUsec;               /* Last time we updated this value. Used for
                                            determining if we should request an update
                                            of this field or not */
+    timelib64_t nextUpdateUsec;                /* When this watch is next due in its module's
+                                                  schedule. 0 = not scheduled */
     timelib64_t updateIntervalUsec;            /* How often this field should be sampled */
     timelib64_t maxAgeUsec;                    /* Maximum time to cache samples of this
                                            field. If 0, the class default is used */
@@ -115,19 +123,43 @@ typedef struct
                                          fetched from the driver */
     long long bytesUsed;
     int scope;
-} dcgmCoreWatchInfo_v1;
+    long long maxExecTimeUsec;                                      /* Longest single fetch of this field */
+    long long execTimeHistogram[DCGM_INTROSPECT_EXEC_TIME_BUCKETS]; /* Fetches by how long they took. See
+                                                                       dcgmIntrospectFieldsExecTime_v3 */
+    long long maxSampleLagUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT];    /* Oldest sample by dcgmIntrospectLagStage_t */
+    /* Samples by how old they were at each dcgmIntrospectLagStage_t */
+    long long sampleLagHistogram[DCGM_INTROSPECT_LAG_STAGE_COUNT][DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
+} dcgmCoreWatchInfo_v3;
 
-#define dcgmCoreWatchInfo_version1 MAKE_DCGM_VERSION(dcgmCoreWatchInfo_v1, 2)
+#define dcgmCoreWatchInfo_version3 MAKE_DCGM_VERSION(dcgmCoreWatchInfo_v3, 3)
 
-#define dcgmCoreWatchInfo_version dcgmCoreWatchInfo_version1
-typedef dcgmCoreWatchInfo_v1 dcgmCoreWatchInfo_t;
+#define dcgmCoreWatchInfo_version dcgmCoreWatchInfo_version3
+typedef dcgmCoreWatchInfo_v3 dcgmCoreWatchInfo_t;
 
+/*****************************************************************************/
+/*
+ * Watches of the fields that a module updates itself. Watches are found with a
+ * DcgmNs::DenseWatchIndex and polled with one DcgmNs::WatchSchedule per module,
+ * the same structures the cache manager uses for its own watches, so that
+ * GetFieldsToUpdate() only touches the watches that are due.
+ */
 class DcgmWatchTable
 {
 public:
     /*****************************************************************************/
     DcgmWatchTable();
 
+    /*****************************************************************************/
+    /**
+     * Gets the module that updates a field. The cache manager updates the
+     * DcgmModuleIdCore fields. The other modules push theirs.
+     *
+     * @param fieldId[in] - the id of the field in question
+     *
+     * @return the id of the module, or DcgmModuleIdCount if no module updates this field
+     */
+    static dcgmModuleId_t GetFieldModule(unsigned int fieldId);
+
     /*****************************************************************************/
     /**
      * Clear all watches in the system.
@@ -257,19 +289,23 @@ public:
 
 private:
     DcgmMutex m_mutex;
-    // Track per-entity watches of fields
-    std::unordered_map<dcgm_entity_key_t, dcgm_watch_info_t> m_entityWatchHashTable;
+    // Track per-entity watches of fields. Watches are reset rather than removed so that
+    // the index and schedules never point at freed ones
+    std::deque<dcgm_watch_info_t> m_watchInfos;
+    DcgmNs::DenseWatchIndex<dcgm_watch_info_t> m_watchIndex;
+    // Deadlines of the watches by the module that updates them. See GetFieldModule()
+    std::array<DcgmNs::WatchSchedule<dcgm_watch_info_t>, DcgmModuleIdCount> m_schedules;
 
     /*****************************************************************************/
     /**
-     * Determines if currentModule ignores this field
+     * Schedules watchInfo to be returned by GetFieldsToUpdate() once its update
+     * interval has passed since it was last queried.
      * NOTE: must be called with m_mutex locked
      *
-     * @param fieldId[in]       - the id of the field in question
-     * @param currentModule[in] - the id of the module considering this field
-     * @return true if this module is updated by a different module than current module
+     * @param watchInfo[in/out] - the watch to schedule
+     * @param dueUsec[in]       - when the watch is due
      */
-    bool IsFieldIgnored(unsigned int fieldId, dcgmModuleId_t currentModule);
+    void ScheduleWatch(dcgm_watch_info_t &watchInfo, timelib64_t dueUsec);
 
     /*****************************************************************************/
     /**
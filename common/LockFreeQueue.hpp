@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace DcgmNs
+{
+/**
+ * Queue for many producers and few (usually one) consumers, built on a bounded lock-free ring (D. Vyukov's bounded
+ * MPMC queue). Enqueue() and TryDequeue() only take a lock once the ring has filled up.
+ *
+ * The ring is bounded but Enqueue() never fails or blocks: once the ring is full, values go to a mutex-guarded
+ * overflow queue until the consumers have emptied it. Values from one producer are dequeued in the order that
+ * producer enqueued them, overflow or not.
+ *
+ * Consumers that run out of values park in WaitUntil() on a futex. Producers only make a syscall to wake them if one
+ * is actually parked, so a busy consumer is not woken once per value the way it is with a semaphore.
+ *
+ * @tparam T    Type of the values. Must be default constructible and movable.
+ */
+template <class T>
+class LockFreeQueue
+{
+public:
+    static constexpr std::size_t DefaultCapacity = 4096;
+
+    enum class [[nodiscard]] WaitResult {
+        Ok,       //!< There is something to dequeue, or Wake() was called
+        TimedOut, //!< The deadline passed with nothing to dequeue
+        Closed,   //!< Close() was called
+    };
+
+    /**
+     * @param[in] capacity  Number of values the ring holds before it overflows. Rounded up to a power of 2
+     */
+    explicit LockFreeQueue(std::size_t capacity = DefaultCapacity)
+        : m_mask(RoundUpToPowerOf2(capacity) - 1)
+        , m_cells(std::make_unique<Cell[]>(m_mask + 1))
+        , m_tail(0)
+        , m_head(0)
+        , m_overflowing(false)
+        , m_overflowCount(0)
+        , m_epoch(0)
+        , m_waiters(0)
+        , m_closed(false)
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i)
+        {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(LockFreeQueue const &) = delete;
+    LockFreeQueue &operator=(LockFreeQueue const &) = delete;
+
+    /**
+     * Add a value to the queue and wake a parked consumer, if any.
+     * @param[in] value     Value to add. Ownership is transferred to the queue
+     */
+    void Enqueue(T value)
+    {
+        if (m_overflowing.load(std::memory_order_acquire) || !TryPush(value))
+        {
+            std::lock_guard<std::mutex> lock(m_overflowMutex);
+            m_overflowing.store(true, std::memory_order_relaxed);
+            m_overflow.push_back(std::move(value));
+            m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        WakeOne();
+    }
+
+    /**
+     * Take the oldest value off the queue.
+     * @param[out] value    Set to the dequeued value
+     * @return  true if a value was dequeued. false if the queue was empty
+     */
+    [[nodiscard]] bool TryDequeue(T &value)
+    {
+        if (TryPop(value))
+        {
+            return true;
+        }
+        if (!m_overflowing.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        /* Values that made it into the ring before the overflow began are older */
+        if (TryPop(value))
+        {
+            return true;
+        }
+        if (m_overflow.empty())
+        {
+            m_overflowing.store(false, std::memory_order_release);
+            return false;
+        }
+
+        value = std::move(m_overflow.front());
+        m_overflow.pop_front();
+        if (m_overflow.empty())
+        {
+            m_overflowing.store(false, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /**
+     * Park until there is something to dequeue, Wake() is called, the deadline passes or the queue is closed.
+     * Returns right away if there is something to dequeue already.
+     */
+    WaitResult WaitUntil(std::chrono::system_clock::time_point deadline)
+    {
+        for (;;)
+        {
+            if (m_closed.load(std::memory_order_acquire))
+            {
+                return WaitResult::Closed;
+            }
+            if (!IsEmpty())
+            {
+                return WaitResult::Ok;
+            }
+
+            auto const remaining = deadline - std::chrono::system_clock::now();
+            if (remaining <= std::chrono::system_clock::duration::zero())
+            {
+                return WaitResult::TimedOut;
+            }
+
+            /* Read the epoch before announcing ourselves. A producer that enqueues after our emptiness check below
+               bumps it, so the futex won't put us to sleep on a stale value */
+            std::uint32_t const epoch = m_epoch.load(std::memory_order_acquire);
+            m_waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (IsEmpty() && !m_closed.load(std::memory_order_acquire))
+            {
+                auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+                timespec timeout { static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000) };
+                syscall(SYS_futex, EpochWord(), FUTEX_WAIT_PRIVATE, epoch, &timeout, nullptr, 0);
+            }
+
+            m_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+            if (m_epoch.load(std::memory_order_acquire) != epoch && !m_closed.load(std::memory_order_acquire))
+            {
+                return WaitResult::Ok; /* Woken by Wake() or a producer. The caller checks which */
+            }
+        }
+    }
+
+    /**
+     * Make every consumer parked in WaitUntil() return, e.g. so that it recalculates its deadline
+     */
+    void Wake()
+    {
+        m_epoch.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, EpochWord(), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    /**
+     * Wake every parked consumer and make WaitUntil() return Closed from now on.
+     * Values can still be enqueued and dequeued.
+     */
+    void Close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        Wake();
+    }
+
+    /**
+     * Whether there is nothing to dequeue. Only a hint while producers are enqueueing
+     */
+    [[nodiscard]] bool IsEmpty() const
+    {
+        std::size_t const head = m_head.load(std::memory_order_relaxed);
+        Cell const &cell       = m_cells[head & m_mask];
+        return cell.seq.load(std::memory_order_acquire) != head + 1
+               && !m_overflowing.load(std::memory_order_acquire);
+    }
+
+    /* Number of values in the ring before it overflows */
+    [[nodiscard]] std::size_t GetCapacity() const
+    {
+        return m_mask + 1;
+    }
+
+    /* How many values have gone to the overflow queue because the ring was full */
+    [[nodiscard]] std::uint64_t GetOverflowCount() const
+    {
+        return m_overflowCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> seq; /* == position: free for that enqueue. == position + 1: holds its value */
+        T value;
+    };
+
+    static std::size_t RoundUpToPowerOf2(std::size_t value)
+    {
+        std::size_t result = 2;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    /* Moves value into the ring. Leaves it alone if the ring is full */
+    bool TryPush(T &value)
+    {
+        std::size_t pos = m_tail.load(std::memory_order_relaxed);
+        Cell *cell      = nullptr;
+        for (;;)
+        {
+            cell                = &m_cells[pos & m_mask];
+            std::size_t seq     = cell->seq.load(std::memory_order_acquire);
+            std::intptr_t delta = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (delta == 0)
+            {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (delta < 0)
+            {
+                return false; /* The consumers haven't freed this cell since last time around */
+            }
+            else
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T &value)
+    {
+        std::size_t pos = m_head.load(std::memory_order_relaxed);
+        Cell *cell      = nullptr;
+        for (;;)
+        {
+            cell                = &m_cells[pos & m_mask];
+            std::size_t seq     = cell->seq.load(std::memory_order_acquire);
+            std::intptr_t delta = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (delta == 0)
+            {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (delta < 0)
+            {
+                return false; /* Nothing has been enqueued here yet */
+            }
+            else
+            {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        value       = std::move(cell->value);
+        cell->value = T {};
+        cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    void WakeOne()
+    {
+        /* Pairs with the fence in WaitUntil(): either we see the waiter or it sees what we enqueued */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) > 0)
+        {
+            m_epoch.fetch_add(1, std::memory_order_release);
+            syscall(SYS_futex, EpochWord(), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+    }
+
+    std::uint32_t *EpochWord()
+    {
+        static_assert(sizeof(m_epoch) == sizeof(std::uint32_t) && std::atomic<std::uint32_t>::is_always_lock_free,
+                      "The futex needs a plain 32-bit word");
+        return reinterpret_cast<std::uint32_t *>(&m_epoch);
+    }
+
+    std::size_t const m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    alignas(64) std::atomic<std::size_t> m_tail; /* Position of the next enqueue */
+    alignas(64) std::atomic<std::size_t> m_head; /* Position of the next dequeue */
+
+    alignas(64) std::atomic_bool m_overflowing; /* Enqueue into m_overflow until the consumers have emptied it */
+    std::mutex m_overflowMutex;
+    std::deque<T> m_overflow;
+    std::atomic<std::uint64_t> m_overflowCount;
+
+    alignas(64) std::atomic<std::uint32_t> m_epoch; /* Futex word. Bumped whenever parked consumers are woken */
+    std::atomic<std::uint32_t> m_waiters;           /* Consumers in WaitUntil() */
+    std::atomic_bool m_closed;
+};
+
+} // namespace DcgmNs
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "LockFreeQueue.hpp"
 #include "Semaphore.hpp"
 #include "Task.hpp"
 #include "ThreadSafeQueue.hpp"
@@ -23,7 +24,12 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 
@@ -49,22 +55,59 @@ struct UnwrapFutureNestedType<std::future<T>>
 template <class T>
 using UnwrapFutureNestedType_t = typename UnwrapFutureNestedType<T>::type;
 
+/**
+ * What a TaskRunner keeps its scheduled tasks in
+ */
+enum class TaskQueueKind : std::uint8_t
+{
+    Locked,   //!< A mutex-guarded queue. Every Enqueue() signals a semaphore
+    LockFree, //!< A lock-free ring (see LockFreeQueue). Enqueue() only wakes a runner that is actually waiting
+};
+
+/**
+ * Identifies a timer scheduled with TaskRunner::EnqueueAt() or TaskRunner::EnqueueEvery(). 0 is never a timer
+ */
+using TimerId = std::uint64_t;
+
+/**
+ * How late a TaskRunner's timers started. Timers start late when the runner is busy with other work
+ */
+struct TimerStats
+{
+    std::uint64_t runs              = 0; //!< Timer runs so far
+    std::uint64_t missedPeriods     = 0; //!< Periods of EnqueueEvery() timers skipped because a run started late
+    std::uint64_t totalLatenessUsec = 0; //!< Sum of how long after its deadline each run started
+    std::uint64_t maxLatenessUsec   = 0; //!< Most any run started after its deadline
+};
+
 /**
  * A class that represents Multiple-Producers-Single-Consumer working queue.
  * Only one thread is running the scheduled tasks and multiple threads can enqueue tasks for execution.
  *
+ * Besides tasks, the runner keeps a heap of timers (see `EnqueueAt()` and `EnqueueEvery()`) and runs each one from
+ * `Run()` once its deadline has passed, so periodic work doesn't need a thread of its own that sleeps and polls.
+ *
  * @note    It's technically possible to make multiple threads running the `Run()` function. But there are no quarantees
  *          that workload will be evenly distributed between such threads.
  */
 class TaskRunner
 {
 public:
-    TaskRunner()
+    /**
+     * @param[in] queueKind     What to keep scheduled tasks in. TaskQueueKind::LockFree is cheaper for runners that
+     *                          many threads enqueue small tasks into.
+     */
+    explicit TaskRunner(TaskQueueKind queueKind = TaskQueueKind::Locked)
         : m_runInterval(std::chrono::minutes(1))
         , m_runnerSemaphore(std::make_shared<Semaphore>())
         , m_stop(false)
         , m_debugLogging(false)
-    {}
+    {
+        if (queueKind == TaskQueueKind::LockFree)
+        {
+            m_lockFreeQueue = std::make_unique<LockFreeTaskQueue>();
+        }
+    }
 
     virtual ~TaskRunner() = default;
 
@@ -107,13 +150,7 @@ public:
 
         task.SetPromise(std::move(prom)); /* after this prom is invalid */
 
-        {
-            auto queueHandle = m_queue.Lock();
-            auto taskPtr     = std::make_unique<Task<T>>(std::move(task)); /* after this task is invalid */
-            queueHandle.Enqueue(std::move(taskPtr));
-        }
-
-        [[maybe_unused]] auto _ = m_runnerSemaphore->Release();
+        PushTask(std::make_unique<Task<T>>(std::move(task))); /* after this task is invalid */
 
         return result;
     }
@@ -163,14 +200,7 @@ public:
 
         task.SetPromise(std::move(contProm)); /* after this prom is invalid */
 
-        {
-            auto queueHandle = m_queue.Lock();
-            auto taskPtr
-                = std::make_unique<Task<std::shared_future<T>>>(std::move(task)); /* after this task is invalid */
-            queueHandle.Enqueue(std::move(taskPtr));
-        }
-
-        [[maybe_unused]] auto _ = m_runnerSemaphore->Release();
+        PushTask(std::make_unique<Task<std::shared_future<T>>>(std::move(task))); /* after this task is invalid */
 
         auto continuation = [contFuture = std::move(contFuture)]() mutable -> std::optional<T> {
             if (contFuture.get().wait_for(std::chrono::microseconds(0)) != std::future_status::ready)
@@ -186,6 +216,58 @@ public:
         return Enqueue(make_task("Auxiliary for a deferred task '"s + task.GetName() + "'"s, std::move(continuation)));
     }
 
+    /**
+     * Run func once from `Run()` at or after the given time.
+     * Timers run on the runner thread between tasks, so func should be as quick as a task.
+     *
+     * @param[in] when  When to run func
+     * @param[in] func  What to run
+     *
+     * @return  Id that can be passed to `CancelTimer()`
+     */
+    TimerId EnqueueAt(std::chrono::steady_clock::time_point when, std::function<void()> func)
+    {
+        return AddTimer(when, std::chrono::milliseconds::zero(), std::move(func));
+    }
+
+    /**
+     * Run func from `Run()` every period, first one period from now, until the timer is cancelled.
+     * Deadlines stay on the original schedule. If a run starts so late that whole periods have passed, those periods
+     * are skipped rather than run back to back, and counted in `TimerStats::missedPeriods`.
+     *
+     * @param[in] period    How often to run func. Must be more than 0
+     * @param[in] func      What to run
+     *
+     * @return  Id that can be passed to `CancelTimer()`
+     */
+    TimerId EnqueueEvery(std::chrono::milliseconds period, std::function<void()> func)
+    {
+        if (period <= std::chrono::milliseconds::zero())
+        {
+            period = std::chrono::milliseconds(1);
+        }
+        return AddTimer(std::chrono::steady_clock::now() + period, period, std::move(func));
+    }
+
+    /**
+     * Cancel a timer. A run that has already started is not interrupted, but it won't run again afterwards.
+     * @return  true if the timer was found. false if it was unknown, already cancelled or a one-shot that has run
+     */
+    bool CancelTimer(TimerId timerId)
+    {
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        return m_timers.erase(timerId) != 0;
+    }
+
+    /**
+     * Get how late this runner's timers started so far
+     */
+    TimerStats GetTimerStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        return m_timerStats;
+    }
+
     /**
      * This enum describes possible results of the Run() method
      */
@@ -202,6 +284,8 @@ public:
      *      some postponed tasks, and return.
      *  If new tasks were signalled (via semaphore), worker will process all tasks in the queue.
      *      Postponed (deferred) tasks will be re-added to the queue but will not be signalled.
+     *  Timers whose deadlines have passed are run every time the runner wakes up, and the runner wakes up for the
+     *      next deadline even before the run interval is over.
      *
      * Here is a example how this method could be used:
      * @code{.cpp}
@@ -219,6 +303,7 @@ public:
      *
      * @param[in] oneIteration      Do not spin TaskRunner until the given run interval is exhausted.
      *                              If true, TaskRunner will wake up at semaphore event, process the queue and return.
+     *                                  It also returns after running timers.
      *                              If false, TaskRunner will wake up at semaphore event, process the queue and wait on
      *                                  the semaphore if the run interval is not exhausted yet.
      * @return
@@ -241,7 +326,7 @@ public:
 
         while (waitResult == Semaphore::TimedWaitResult::Ok && !m_stop.load(std::memory_order_relaxed))
         {
-            waitResult = m_runnerSemaphore->WaitUntil(wakeUpTime);
+            waitResult = WaitForTasks(std::min(wakeUpTime, NextTimerDeadline()));
             if (waitResult == Semaphore::TimedWaitResult::Destroyed)
             {
                 if (m_debugLogging.load(std::memory_order_relaxed))
@@ -257,31 +342,32 @@ public:
                 return RunResult::NoLongerValid;
             }
 
+            bool const ranTimers = RunDueTimers();
+            if (waitResult == Semaphore::TimedWaitResult::TimedOut && std::chrono::system_clock::now() < wakeUpTime)
+            {
+                /* We woke up for a timer. The run interval isn't over yet */
+                waitResult = Semaphore::TimedWaitResult::Ok;
+            }
+
             /*
              * We need to check the queue even if the semaphore has timed out.
              */
             std::vector<std::unique_ptr<ITask>> tasks;
             std::vector<std::unique_ptr<ITask>> deferredTasks;
+            if (!TakeAllTasks(tasks))
             {
-                auto &&queueHandle = m_queue.Lock();
-                if (queueHandle.IsEmpty())
+                if (ranTimers && oneIteration)
                 {
-                    continue;
-                }
-
-                if (m_debugLogging.load(std::memory_order_relaxed))
-                {
-                    DCGM_LOG_DEBUG << "TaskRunner is consuming " << std::to_string(queueHandle.GetSize())
-                                   << " tasks from the queue";
+                    break;
                 }
+                continue;
+            }
 
-                tasks.reserve(queueHandle.GetSize());
-                deferredTasks.reserve(queueHandle.GetSize());
-                while (!queueHandle.IsEmpty())
-                {
-                    tasks.emplace_back(queueHandle.Dequeue());
-                }
+            if (m_debugLogging.load(std::memory_order_relaxed))
+            {
+                DCGM_LOG_DEBUG << "TaskRunner is consuming " << std::to_string(tasks.size()) << " tasks from the queue";
             }
+            deferredTasks.reserve(tasks.size());
 
             for (auto &&task : tasks)
             {
@@ -319,11 +405,7 @@ public:
             }
             if (!deferredTasks.empty())
             {
-                auto &&queueHandle = m_queue.Lock();
-                for (auto &&task : deferredTasks)
-                {
-                    queueHandle.Enqueue(std::move(task));
-                }
+                PutBackDeferredTasks(deferredTasks);
             }
 
             if (oneIteration)
@@ -346,6 +428,10 @@ public:
             DCGM_LOG_DEBUG << "The TaskRunner 0x" << to_hex_string((std::size_t)this) << " is going to stop";
         }
         m_stop.store(true, std::memory_order_relaxed);
+        if (m_lockFreeQueue)
+        {
+            m_lockFreeQueue->Close(); // Wakes up all runner threads parked on the queue
+        }
         m_runnerSemaphore->Destroy(); // Semaphore.Destroy will wake up all waiters (runner threads)
     }
 
@@ -360,11 +446,238 @@ protected:
     }
 
 private:
+    using LockFreeTaskQueue = LockFreeQueue<std::unique_ptr<ITask>>;
+
+    struct Timer
+    {
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::milliseconds period; //!< 0 = run once
+        std::shared_ptr<std::function<void()>> func;
+    };
+
+    /* Heap entry. Entries of cancelled or rescheduled timers are skipped when they come up */
+    struct TimerDeadline
+    {
+        std::chrono::steady_clock::time_point deadline;
+        TimerId timerId;
+
+        bool operator>(TimerDeadline const &other) const
+        {
+            return deadline > other.deadline;
+        }
+    };
+    using TimerHeap = std::priority_queue<TimerDeadline, std::vector<TimerDeadline>, std::greater<TimerDeadline>>;
+
+    TimerId AddTimer(std::chrono::steady_clock::time_point deadline,
+                     std::chrono::milliseconds period,
+                     std::function<void()> func)
+    {
+        TimerId timerId;
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(m_timerMutex);
+            timerId = ++m_lastTimerId;
+            auto sharedFunc = std::make_shared<std::function<void()>>(std::move(func));
+            m_timers.emplace(timerId, Timer { deadline, period, std::move(sharedFunc) });
+            earliest = m_timerHeap.empty() || deadline < m_timerHeap.top().deadline;
+            m_timerHeap.push(TimerDeadline { deadline, timerId });
+        }
+
+        if (earliest)
+        {
+            /* The runner may be waiting for a later deadline. Have it recalculate */
+            WakeRunner();
+        }
+        return timerId;
+    }
+
+    /* When the runner should wake up for the earliest timer. Far in the future if there are none */
+    std::chrono::system_clock::time_point NextTimerDeadline()
+    {
+        std::lock_guard<std::mutex> lock(m_timerMutex);
+        while (!m_timerHeap.empty())
+        {
+            TimerDeadline const &next = m_timerHeap.top();
+            auto timer                = m_timers.find(next.timerId);
+            if (timer == m_timers.end() || timer->second.deadline != next.deadline)
+            {
+                m_timerHeap.pop(); /* Cancelled or rescheduled */
+                continue;
+            }
+            auto const untilDeadline = next.deadline - std::chrono::steady_clock::now();
+            return std::chrono::system_clock::now()
+                   + std::chrono::duration_cast<std::chrono::system_clock::duration>(untilDeadline);
+        }
+        return std::chrono::system_clock::time_point::max();
+    }
+
+    /* Returns whether any timer ran */
+    bool RunDueTimers()
+    {
+        std::vector<std::pair<TimerId, std::shared_ptr<std::function<void()>>>> dueTimers;
+        auto const now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_timerMutex);
+            while (!m_timerHeap.empty() && m_timerHeap.top().deadline <= now)
+            {
+                TimerDeadline const due = m_timerHeap.top();
+                m_timerHeap.pop();
+
+                auto found = m_timers.find(due.timerId);
+                if (found == m_timers.end() || found->second.deadline != due.deadline)
+                {
+                    continue; /* Cancelled or rescheduled */
+                }
+
+                Timer &timer = found->second;
+                auto const lateness
+                    = std::chrono::duration_cast<std::chrono::microseconds>(now - timer.deadline).count();
+                m_timerStats.runs++;
+                m_timerStats.totalLatenessUsec += lateness;
+                m_timerStats.maxLatenessUsec = std::max(m_timerStats.maxLatenessUsec, (std::uint64_t)lateness);
+
+                dueTimers.emplace_back(due.timerId, timer.func);
+                if (timer.period == std::chrono::milliseconds::zero())
+                {
+                    m_timers.erase(found);
+                    continue;
+                }
+
+                /* Stay on schedule, skipping the periods that are already over */
+                auto const missed = (now - timer.deadline) / timer.period;
+                m_timerStats.missedPeriods += missed;
+                timer.deadline += timer.period * (missed + 1);
+                m_timerHeap.push(TimerDeadline { timer.deadline, due.timerId });
+            }
+        }
+
+        for (auto &[timerId, func] : dueTimers)
+        {
+            if (m_debugLogging.load(std::memory_order_relaxed))
+            {
+                DCGM_LOG_DEBUG << "TaskRunner is going to run timer " << timerId;
+            }
+            std::invoke(*func);
+        }
+        return !dueTimers.empty();
+    }
+
+    /* Make a waiting Run() return from its wait without adding a task */
+    void WakeRunner()
+    {
+        if (m_lockFreeQueue)
+        {
+            m_lockFreeQueue->Wake();
+            return;
+        }
+        [[maybe_unused]] auto _ = m_runnerSemaphore->Release();
+    }
+
+    void PushTask(std::unique_ptr<ITask> task)
+    {
+        if (m_lockFreeQueue)
+        {
+            m_lockFreeQueue->Enqueue(std::move(task));
+            return;
+        }
+
+        {
+            auto queueHandle = m_queue.Lock();
+            queueHandle.Enqueue(std::move(task));
+        }
+
+        [[maybe_unused]] auto _ = m_runnerSemaphore->Release();
+    }
+
+    Semaphore::TimedWaitResult WaitForTasks(std::chrono::system_clock::time_point wakeUpTime)
+    {
+        if (!m_lockFreeQueue)
+        {
+            return m_runnerSemaphore->WaitUntil(wakeUpTime);
+        }
+
+        switch (m_lockFreeQueue->WaitUntil(wakeUpTime))
+        {
+            case LockFreeTaskQueue::WaitResult::Ok:
+                return Semaphore::TimedWaitResult::Ok;
+            case LockFreeTaskQueue::WaitResult::TimedOut:
+                return Semaphore::TimedWaitResult::TimedOut;
+            case LockFreeTaskQueue::WaitResult::Closed:
+            default:
+                return Semaphore::TimedWaitResult::Destroyed;
+        }
+    }
+
+    /**
+     * Move every scheduled task into tasks, oldest first.
+     * @return false if there were none
+     */
+    bool TakeAllTasks(std::vector<std::unique_ptr<ITask>> &tasks)
+    {
+        if (!m_lockFreeQueue)
+        {
+            auto &&queueHandle = m_queue.Lock();
+            tasks.reserve(queueHandle.GetSize());
+            while (!queueHandle.IsEmpty())
+            {
+                tasks.emplace_back(queueHandle.Dequeue());
+            }
+            return !tasks.empty();
+        }
+
+        /* Stop at a ring's worth so that producers that keep up with us can't keep us here forever */
+        std::unique_ptr<ITask> task;
+        while (tasks.size() < m_lockFreeQueue->GetCapacity() && m_lockFreeQueue->TryDequeue(task))
+        {
+            tasks.emplace_back(std::move(task));
+        }
+
+        std::lock_guard<std::mutex> lock(m_deferredMutex);
+        for (auto &&deferred : m_deferredTasks)
+        {
+            tasks.emplace_back(std::move(deferred));
+        }
+        m_deferredTasks.clear();
+
+        return !tasks.empty();
+    }
+
+    /* Requeue tasks that weren't ready. They are retried with the next tasks, or once the run interval is over */
+    void PutBackDeferredTasks(std::vector<std::unique_ptr<ITask>> &deferredTasks)
+    {
+        if (!m_lockFreeQueue)
+        {
+            auto &&queueHandle = m_queue.Lock();
+            for (auto &&task : deferredTasks)
+            {
+                queueHandle.Enqueue(std::move(task));
+            }
+            return;
+        }
+
+        /* Kept off the ring, which would wake us right back up to retry them */
+        std::lock_guard<std::mutex> lock(m_deferredMutex);
+        for (auto &&task : deferredTasks)
+        {
+            m_deferredTasks.emplace_back(std::move(task));
+        }
+    }
+
     ThreadSafeQueue<std::unique_ptr<ITask>> m_queue;      //!< A queue of scheduled tasks. Thread Safe.
     std::atomic<std::chrono::milliseconds> m_runInterval; //!< How long a worker will wait for a new task signal.
     std::shared_ptr<Semaphore> m_runnerSemaphore;         //!< Signals if there is new task in the queue.
     std::atomic_bool m_stop;                              //!< Signals that the task runner should stop its work.
     std::atomic_bool m_debugLogging;                      //!< If the task runner methods need to write debug logs.
+
+    std::unique_ptr<LockFreeTaskQueue> m_lockFreeQueue;  //!< Used instead of m_queue and m_runnerSemaphore if set.
+    std::mutex m_deferredMutex;                          //!< Guards m_deferredTasks.
+    std::vector<std::unique_ptr<ITask>> m_deferredTasks; //!< Deferred tasks waiting for a retry. Lock-free queue only.
+
+    mutable std::mutex m_timerMutex;             //!< Guards the timer members below.
+    std::unordered_map<TimerId, Timer> m_timers; //!< Scheduled timers by id.
+    TimerHeap m_timerHeap;                       //!< Timer deadlines, earliest on top.
+    TimerId m_lastTimerId = 0;                   //!< Last id handed out.
+    TimerStats m_timerStats;                     //!< How late timers started so far.
 };
 
 } // namespace DcgmNs
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <Task.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <pthread.h>
+
+namespace DcgmNs
+{
+/**
+ * A drop-in alternative to ThreadPool for many small tasks.
+ *
+ * ThreadPool has every worker take tasks from one shared queue, so under a burst of small tasks the workers spend
+ * their time contending on that queue's lock. Here every worker has its own queue instead:
+ *  - Enqueue() from one of this pool's workers puts the task on that worker's queue, which no other thread touches
+ *    unless it is stealing.
+ *  - Enqueue() from any other thread spreads tasks over the workers' queues round-robin.
+ *  - A worker whose queue is empty steals from the others, starting at a random one so that idle workers don't all
+ *    pile onto the same victim. It sleeps only once every queue is empty.
+ *
+ * Owners and thieves both take the oldest task, so tasks are started in about the order they were enqueued.
+ *
+ * Tasks that are still queued when the pool stops are dropped, and their futures report std::broken_promise.
+ * Deferred tasks (functions returning std::optional) are not supported. Use ThreadPool for those.
+ */
+class WorkStealingThreadPool
+{
+public:
+    explicit WorkStealingThreadPool(std::size_t numOfWorkers)
+        : m_shouldStop(false)
+        , m_pending(0)
+        , m_sleeping(0)
+        , m_nextQueue(0)
+    {
+        std::stringstream ss;
+        ss << "Worker of a WorkStealingThreadPool at 0x" << std::hex << this;
+        std::string const threadName = ss.str();
+
+        m_queues.reserve(numOfWorkers);
+        for (std::size_t i = 0; i < numOfWorkers; ++i)
+        {
+            m_queues.emplace_back(std::make_unique<WorkerQueue>());
+        }
+
+        m_threads.reserve(numOfWorkers);
+        for (std::size_t i = 0; i < numOfWorkers; ++i)
+        {
+            m_threads.emplace_back([this, i]() { Run(i); });
+            pthread_setname_np(m_threads.back().native_handle(), threadName.c_str());
+        }
+    }
+
+    WorkStealingThreadPool(WorkStealingThreadPool const &) = delete;
+    WorkStealingThreadPool &operator=(WorkStealingThreadPool const &) = delete;
+
+    void Stop()
+    {
+        m_shouldStop.store(true);
+
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idleCv.notify_all();
+    }
+
+    void StopAndWait()
+    {
+        Stop();
+
+        std::lock_guard<std::mutex> lock(m_joinMutex);
+        for (auto &&th : m_threads)
+        {
+            if (th.joinable())
+            {
+                th.join();
+            }
+        }
+    }
+
+    ~WorkStealingThreadPool()
+    {
+        try
+        {
+            StopAndWait();
+        }
+        catch (std::exception &e)
+        {
+            std::cerr << "Caught exception in ~WorkStealingThreadPool. Swallowing " << e.what() << std::endl;
+        }
+    }
+
+    [[nodiscard]] std::size_t GetNumWorkers() const
+    {
+        return m_queues.size();
+    }
+
+    template <class Func>
+    auto Enqueue(Func func) -> std::shared_future<std::invoke_result_t<Func>>
+    {
+        using ResultType = std::invoke_result_t<Func>;
+        static_assert(std::is_same_v<OptionalNestedType_t<ResultType>, ResultType>,
+                      "WorkStealingThreadPool does not run deferred tasks");
+
+        std::promise<ResultType> promise;
+        auto result = promise.get_future().share();
+
+        auto task = std::make_unique<Task<ResultType>>(
+            [func = std::move(func)]() mutable -> ResultType { return std::invoke(func); });
+        task->SetPromise(std::move(promise)); /* after this promise is invalid */
+
+        Push(std::move(task));
+
+        return result;
+    }
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::unique_ptr<ITask>> tasks;
+    };
+
+    /* The pool and worker the current thread belongs to, if any */
+    struct CurrentWorker
+    {
+        WorkStealingThreadPool const *pool;
+        std::size_t index;
+    };
+    static inline thread_local CurrentWorker t_currentWorker { nullptr, 0 };
+
+    void Push(std::unique_ptr<ITask> task)
+    {
+        if (m_queues.empty())
+        {
+            return; /* Nobody would ever run it. The future reports a broken promise */
+        }
+
+        std::size_t const index = t_currentWorker.pool == this
+                                      ? t_currentWorker.index
+                                      : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+        {
+            WorkerQueue &queue = *m_queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+            /* Counted under the queue lock so that whoever takes the task can't uncount it first */
+            m_pending.fetch_add(1);
+        }
+
+        /* A worker going to sleep counts itself before it checks m_pending, and we counted the task before checking
+           m_sleeping, so at least one of us sees the other */
+        if (m_sleeping.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_idleMutex);
+            m_idleCv.notify_one();
+        }
+    }
+
+    std::unique_ptr<ITask> TakeOldest(WorkerQueue &queue)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            return nullptr;
+        }
+
+        std::unique_ptr<ITask> task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        m_pending.fetch_sub(1);
+        return task;
+    }
+
+    std::unique_ptr<ITask> Steal(std::size_t thiefIndex, std::minstd_rand &random)
+    {
+        std::size_t const numQueues = m_queues.size();
+        std::size_t const start     = random() % numQueues;
+
+        for (std::size_t i = 0; i < numQueues; ++i)
+        {
+            std::size_t const victim = (start + i) % numQueues;
+            if (victim == thiefIndex)
+            {
+                continue;
+            }
+            if (auto task = TakeOldest(*m_queues[victim]))
+            {
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void WaitForWork()
+    {
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        m_sleeping.fetch_add(1);
+        m_idleCv.wait(lock, [this] { return m_pending.load() > 0 || m_shouldStop.load(); });
+        m_sleeping.fetch_sub(1);
+    }
+
+    void Run(std::size_t index)
+    {
+        t_currentWorker = { this, index };
+        std::minstd_rand random(static_cast<std::minstd_rand::result_type>(index + 1));
+
+        while (!m_shouldStop.load(std::memory_order_relaxed))
+        {
+            std::unique_ptr<ITask> task = TakeOldest(*m_queues[index]);
+            if (!task)
+            {
+                task = Steal(index, random);
+            }
+            if (!task)
+            {
+                WaitForWork();
+                continue;
+            }
+
+            [[maybe_unused]] auto _ = task->Run();
+        }
+
+        t_currentWorker = { nullptr, 0 };
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues; /* One per worker. Fixed after construction */
+    std::vector<std::thread> m_threads;
+    std::mutex m_joinMutex;
+
+    std::atomic_bool m_shouldStop;
+    std::atomic<std::size_t> m_pending;   /* Tasks queued and not yet taken by a worker */
+    std::atomic<std::size_t> m_sleeping;  /* Workers in WaitForWork() */
+    std::atomic<std::size_t> m_nextQueue; /* Where the next task from outside the pool goes */
+
+    std::mutex m_idleMutex;
+    std::condition_variable m_idleCv;
+};
+
+} // namespace DcgmNs
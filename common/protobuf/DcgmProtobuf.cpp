@@ -25,10 +25,20 @@
  * Constructor for DCGM Protobuf
  *****************************************************************************/
 DcgmProtobuf::DcgmProtobuf()
-    : mMsgType(0)
+    : mpArena(NULL)
+    , mMsgType(0)
 {
-    mpProtoMsg       = new dcgm::Msg;
-    mpEncodedMessage = NULL;
+    mpProtoMsg = new dcgm::Msg;
+}
+
+/*****************************************************************************
+ * Constructor for DCGM Protobuf on an arena
+ *****************************************************************************/
+DcgmProtobuf::DcgmProtobuf(google::protobuf::Arena *arena)
+    : mpArena(arena)
+    , mMsgType(0)
+{
+    mpProtoMsg = google::protobuf::Arena::CreateMessage<dcgm::Msg>(arena);
 }
 
 /*****************************************************************************
@@ -36,13 +46,12 @@ DcgmProtobuf::DcgmProtobuf()
  *****************************************************************************/
 DcgmProtobuf::~DcgmProtobuf()
 {
-    delete mpProtoMsg;
-    mpProtoMsg = NULL;
-    if (mpEncodedMessage)
+    /* The arena may already have been reset, so the message isn't touched */
+    if (NULL == mpArena)
     {
-        delete[] mpEncodedMessage;
-        mpEncodedMessage = NULL;
+        delete mpProtoMsg;
     }
+    mpProtoMsg = NULL;
 }
 
 /*****************************************************************************
@@ -50,8 +59,9 @@ DcgmProtobuf::~DcgmProtobuf()
  *****************************************************************************/
 dcgmReturn_t DcgmProtobuf::GetEncodedMessage(std::vector<char> &encodedMessage)
 {
-    encodedMessage.resize(mpProtoMsg->ByteSize());
-    mpProtoMsg->SerializeToArray(encodedMessage.data(), encodedMessage.size());
+    /* Sizes are computed once. SerializeToArray() would compute them again */
+    encodedMessage.resize(mpProtoMsg->ByteSizeLong());
+    mpProtoMsg->SerializeWithCachedSizesToArray((google::protobuf::uint8 *)encodedMessage.data());
     return DCGM_ST_OK;
 }
 
@@ -81,6 +91,7 @@ dcgmReturn_t DcgmProtobuf::ParseRecvdMessage(char *buf, int bufLength, std::vect
         return DCGM_ST_BADPARAM;
     }
 
+    pCommands->reserve(pCommands->size() + numCmds);
     for (j = 0; j < numCmds; j++)
     {
         const dcgm::Command &cmdMsg = mpProtoMsg->cmd(j);
@@ -101,6 +112,7 @@ int DcgmProtobuf::GetAllCommands(std::vector<dcgm::Command *> *pCommands)
         return -1;
     }
 
+    pCommands->reserve(pCommands->size() + numCmds);
     for (j = 0; j < numCmds; j++)
     {
         const dcgm::Command &cmdMsg = mpProtoMsg->cmd(j);
@@ -110,6 +122,12 @@ int DcgmProtobuf::GetAllCommands(std::vector<dcgm::Command *> *pCommands)
     return 0;
 }
 
+/*****************************************************************************/
+size_t DcgmProtobuf::GetSpaceUsed() const
+{
+    return mpProtoMsg->SpaceUsedLong();
+}
+
 /*****************************************************************************
  * Add command to the protobuf message to be sent over the network
  *****************************************************************************/
@@ -22,6 +22,7 @@
 
 #include "DcgmProtocol.h"
 #include "dcgm.pb.h"
+#include <google/protobuf/arena.h>
 #include <iostream>
 #include <vector>
 
@@ -29,6 +30,14 @@ class DcgmProtobuf
 {
 public:
     DcgmProtobuf();
+
+    /*****************************************************************************
+     * Allocate the message, and everything parsed into or added to it, on arena.
+     * The arena must outlive this object and is only freed by resetting it, so
+     * all of a request's commands are freed at once.
+     *****************************************************************************/
+    explicit DcgmProtobuf(google::protobuf::Arena *arena);
+
     virtual ~DcgmProtobuf();
 
     /*****************************************************************************
@@ -40,6 +49,7 @@ public:
 
     /*****************************************************************************
      This method returns the encoded message to be sent over socket*
+     encodedMessage is resized to fit, so a buffer that is reused keeps its capacity
      *****************************************************************************/
     dcgmReturn_t GetEncodedMessage(std::vector<char> &encodedMessage);
 
@@ -54,10 +64,15 @@ public:
      *****************************************************************************/
     int GetAllCommands(std::vector<dcgm::Command *> *pCommands);
 
+    /*****************************************************************************
+     * Approximate bytes of memory the parsed message and its commands use
+     *****************************************************************************/
+    size_t GetSpaceUsed() const;
+
 protected:
-    dcgm::Msg *mpProtoMsg;  /* Google protobuf format message */
-    char *mpEncodedMessage; /* Encoded message is stored in this buffer */
-    int mMsgType;           /* Represents one of Request, Response or Notify */
+    dcgm::Msg *mpProtoMsg;            /* Google protobuf format message */
+    google::protobuf::Arena *mpArena; /* Owns mpProtoMsg if not NULL */
+    int mMsgType;                     /* Represents one of Request, Response or Notify */
 };
 
 #endif /* DCGMPROTOBUF_H */
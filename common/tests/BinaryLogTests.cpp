@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <DcgmBinaryLog.h>
+
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+TEST_CASE("BinaryLog: ring, dump and decode")
+{
+    using DcgmNs::Logging::BinaryLog;
+    BinaryLog &binaryLog = BinaryLog::Instance();
+
+    /* Arguments are not evaluated while the log is off */
+    int evaluated = 0;
+    if (binaryLog.Capacity() == 0)
+    {
+        DCGM_BINARY_LOG("before start %d", ++evaluated);
+        CHECK(evaluated == 0);
+        CHECK(binaryLog.Snapshot().empty());
+
+        std::string filename;
+        CHECK(binaryLog.WriteBinaryLog("/tmp", filename) == DCGM_ST_UNINITIALIZED);
+    }
+
+    binaryLog.Start(8);
+    REQUIRE(binaryLog.Capacity() == 8);
+
+    for (int i = 1; i <= 10; i++)
+    {
+        DCGM_BINARY_LOG("entry %d of %u", i, 10U);
+    }
+
+    /* Only the newest entries fit, oldest first */
+    std::vector<DcgmNs::Logging::BinaryLogEntry> entries = binaryLog.Snapshot();
+    REQUIRE(entries.size() == 8);
+    for (int i = 0; i < 8; i++)
+    {
+        REQUIRE(entries[i].numArgs == 2);
+        CHECK((int)entries[i].args[0] == i + 3);
+        CHECK(entries[i].tid != 0);
+    }
+
+    DCGM_BINARY_LOG("mixed %5.2f %x %lld %c 100%% %s", 1.5, 255U, -7LL, 'z');
+    DCGM_BINARY_LOG("no arguments");
+
+    std::stringstream text;
+    REQUIRE(BinaryLog::Decode(BinaryLog::Serialize(binaryLog.Snapshot(), 1), text) == DCGM_ST_OK);
+
+    std::vector<std::string> messages;
+    std::string line;
+    while (std::getline(text, line))
+    {
+        /* Skip "usec tid file:line " */
+        size_t messageStart = 0;
+        for (int field = 0; field < 3; field++)
+        {
+            messageStart = line.find(' ', messageStart) + 1;
+        }
+        messages.push_back(line.substr(messageStart));
+    }
+
+    REQUIRE(messages.size() == 8);
+    CHECK(messages[0] == "entry 5 of 10");
+    CHECK(messages[6] == "mixed  1.50 ff -7 z 100% <string>");
+    CHECK(messages[7] == "no arguments");
+
+    /* A truncated dump is rejected instead of misread */
+    std::string dump = BinaryLog::Serialize(binaryLog.Snapshot(), 1);
+    std::stringstream ignored;
+    CHECK(BinaryLog::Decode(dump.substr(0, dump.size() - 1), ignored) == DCGM_ST_BADPARAM);
+    CHECK(BinaryLog::Decode("not a binary log", ignored) == DCGM_ST_BADPARAM);
+
+    std::string filename;
+    REQUIRE(binaryLog.WriteBinaryLog("/tmp", filename) == DCGM_ST_OK);
+    std::ifstream file(filename, std::ios::binary);
+    std::string written((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(written.compare(0, 8, "DCGMBLG1") == 0);
+    unlink(filename.c_str());
+
+    binaryLog.Stop();
+    DCGM_BINARY_LOG("after stop %d", ++evaluated);
+    CHECK(evaluated == 0);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmCpuPlacement.h>
+
+#include <pthread.h>
+#include <thread>
+
+using namespace DcgmNs;
+
+TEST_CASE("CpuPlacement: cpulists")
+{
+    cpu_set_t cpus;
+
+    REQUIRE(ParseCpuList("0-3,8,10-11", cpus));
+    CHECK(CPU_COUNT(&cpus) == 7);
+    CHECK(CPU_ISSET(0, &cpus));
+    CHECK(CPU_ISSET(3, &cpus));
+    CHECK(!CPU_ISSET(4, &cpus));
+    CHECK(CPU_ISSET(8, &cpus));
+    CHECK(CPU_ISSET(11, &cpus));
+
+    REQUIRE(ParseCpuList("5", cpus));
+    CHECK(CPU_COUNT(&cpus) == 1);
+
+    for (char const *bad : { "", ",", "1,", ",1", "3-1", "1-", "-1", "a", "1-2-3", "1 ", "100000" })
+    {
+        CAPTURE(bad);
+        CHECK(!ParseCpuList(bad, cpus));
+        CHECK(CPU_COUNT(&cpus) == 0);
+    }
+}
+
+TEST_CASE("CpuPlacement: affinity bitmasks")
+{
+    unsigned long bitmask[2] = { 0x5UL, 0x1UL };
+    cpu_set_t cpus;
+
+    CpuSetFromBitmask(bitmask, 2, cpus);
+    CHECK(CPU_COUNT(&cpus) == 3);
+    CHECK(CPU_ISSET(0, &cpus));
+    CHECK(CPU_ISSET(2, &cpus));
+    CHECK(CPU_ISSET(sizeof(unsigned long) * 8, &cpus));
+}
+
+TEST_CASE("CpuPlacement: pinning and reserving")
+{
+    /* Work on a thread of our own so the test runner's affinity is left alone */
+    std::thread([] {
+        cpu_set_t original;
+        REQUIRE(pthread_getaffinity_np(pthread_self(), sizeof(original), &original) == 0);
+
+        cpu_set_t none;
+        CPU_ZERO(&none);
+        CHECK(!PinCurrentThread(original, none));
+        CHECK(!ExcludeCpusFromCurrentThread(original));
+
+        unsigned int firstCpu = 0;
+        while (!CPU_ISSET(firstCpu, &original))
+            firstCpu++;
+
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(firstCpu, &one);
+        REQUIRE(PinCurrentThread(one, original));
+
+        cpu_set_t current;
+        REQUIRE(pthread_getaffinity_np(pthread_self(), sizeof(current), &current) == 0);
+        CHECK(CPU_EQUAL(&current, &one));
+    }).join();
+}
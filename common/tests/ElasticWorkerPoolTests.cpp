@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmElasticWorkerPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+/* Holds tasks until released */
+struct Gate
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool released = false;
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return released; });
+    }
+
+    void Release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            released = true;
+        }
+        condition.notify_all();
+    }
+};
+
+/* Poll until condition holds or 5 seconds pass */
+template <typename Condition>
+bool WaitFor(Condition condition)
+{
+    for (int i = 0; i < 500; i++)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+} // namespace
+
+TEST_CASE("ElasticWorkerPool: grows while tasks wait on busy workers")
+{
+    DcgmElasticWorkerPoolParams_t params {};
+    params.minWorkers   = 1;
+    params.maxWorkers   = 3;
+    params.growWaitUsec = 1000;
+    params.idleUsec     = 60000000;
+
+    DcgmElasticWorkerPool pool(params, "test_pool");
+    CHECK(pool.GetStats().numWorkers == 1);
+
+    Gate gate;
+    std::atomic<int> done = 0;
+    auto blockingTask     = [&] {
+        gate.Wait();
+        done++;
+    };
+
+    /* Each task queued after the previous one waited past growWaitUsec adds a worker, which picks up the
+       waiting task. Wait for that before queueing the next one, so the same task can't grow the pool twice */
+    unsigned int const expectedBusy[]  = { 1, 1, 2, 3, 3, 3 };
+    unsigned int const expectedQueue[] = { 0, 1, 1, 1, 2, 3 };
+    for (int i = 0; i < 6; i++)
+    {
+        pool.Enqueue(blockingTask);
+        REQUIRE(WaitFor([&] {
+            auto stats = pool.GetStats();
+            return stats.busyWorkers == expectedBusy[i] && stats.queueDepth == expectedQueue[i];
+        }));
+
+        /* sleep_for() waits at least this long, so the task just queued is past growWaitUsec */
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    auto stats = pool.GetStats();
+    CHECK(stats.numWorkers == 3);
+    CHECK(stats.peakWorkers == 3);
+    CHECK(stats.workersStarted == 2);
+    CHECK(stats.queueDepth == 3);
+    CHECK(stats.maxQueueDepth >= 3);
+
+    gate.Release();
+    REQUIRE(WaitFor([&] { return done == 6; }));
+
+    stats = pool.GetStats();
+    CHECK(stats.tasksProcessed == 6);
+    CHECK(stats.queueDepth == 0);
+    CHECK(stats.maxWaitUsec >= params.growWaitUsec);
+    CHECK(stats.totalWaitUsec >= stats.maxWaitUsec);
+}
+
+TEST_CASE("ElasticWorkerPool: shrinks back to its minimum when idle")
+{
+    DcgmElasticWorkerPoolParams_t params {};
+    params.minWorkers   = 2;
+    params.maxWorkers   = 4;
+    params.growWaitUsec = 0;
+    params.idleUsec     = 50000;
+
+    DcgmElasticWorkerPool pool(params, "test_pool");
+
+    Gate gate;
+    std::atomic<int> done = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        pool.Enqueue([&] {
+            gate.Wait();
+            done++;
+        });
+    }
+
+    REQUIRE(WaitFor([&] { return pool.GetStats().numWorkers == 4; }));
+    gate.Release();
+    REQUIRE(WaitFor([&] { return done == 8; }));
+
+    REQUIRE(WaitFor([&] { return pool.GetStats().numWorkers == 2; }));
+    auto stats = pool.GetStats();
+    CHECK(stats.workersStopped == 2);
+    CHECK(stats.peakWorkers == 4);
+
+    /* The remaining workers keep processing */
+    pool.Enqueue([&] { done++; });
+    REQUIRE(WaitFor([&] { return done == 9; }));
+}
+
+TEST_CASE("ElasticWorkerPool: sizing is sanitized and stopping drops queued tasks")
+{
+    DcgmElasticWorkerPoolParams_t params {};
+    params.minWorkers = 0;
+    params.maxWorkers = 0;
+
+    DcgmElasticWorkerPool pool(params, "test_pool");
+    CHECK(pool.GetParams().minWorkers == 1);
+    CHECK(pool.GetParams().maxWorkers == 1);
+
+    Gate gate;
+    std::atomic<int> done = 0;
+    pool.Enqueue([&] {
+        gate.Wait();
+        done++;
+    });
+    pool.Enqueue([&] { done++; });
+    REQUIRE(WaitFor([&] { return pool.GetStats().busyWorkers == 1; }));
+
+    /* Stopping drops the queued task right away, then waits for the running one */
+    std::thread stopper([&] { pool.StopAndWait(); });
+    REQUIRE(WaitFor([&] { return pool.GetStats().numWorkers == 0; }));
+    CHECK(pool.GetStats().queueDepth == 0);
+    gate.Release();
+    stopper.join();
+
+    CHECK(done == 1);
+    CHECK(pool.GetStats().numWorkers == 0);
+
+    pool.Enqueue([&] { done++; });
+    CHECK(pool.GetStats().queueDepth == 0);
+}
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmFvBuffer.h>
+#include <DcgmFvBufferPool.h>
+#include <DcgmFvUpdateWorker.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("FvBuffer: AppendFvBuffer")
+{
+    DcgmFvBuffer first;
+    DcgmFvBuffer second;
+    DcgmFvBuffer empty;
+    size_t bufferSize = 0;
+    size_t elementCount;
+
+    first.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 40, 1000, DCGM_ST_OK);
+    second.AddDoubleValue(DCGM_FE_GPU, 1, DCGM_FI_DEV_POWER_USAGE, 125.5, 2000, DCGM_ST_OK);
+    char serial[] = "serial";
+    second.AddStringValue(DCGM_FE_GPU, 1, DCGM_FI_DEV_SERIAL, serial, 3000, DCGM_ST_OK);
+
+    REQUIRE(first.AppendFvBuffer(nullptr) == DCGM_ST_BADPARAM);
+    REQUIRE(first.AppendFvBuffer(&first) == DCGM_ST_BADPARAM);
+    REQUIRE(first.AppendFvBuffer(&empty) == DCGM_ST_OK);
+    REQUIRE(first.AppendFvBuffer(&second) == DCGM_ST_OK);
+
+    REQUIRE(first.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 3);
+
+    /* second is unchanged */
+    REQUIRE(second.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 2);
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    dcgmBufferedFv_t *fv          = first.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldId == DCGM_FI_DEV_GPU_TEMP);
+    CHECK(fv->value.i64 == 40);
+
+    fv = first.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->entityId == 1);
+    CHECK(fv->fieldId == DCGM_FI_DEV_POWER_USAGE);
+    CHECK(fv->value.dbl == 125.5);
+
+    fv = first.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldId == DCGM_FI_DEV_SERIAL);
+    CHECK(std::string(fv->value.str) == "serial");
+
+    CHECK(first.GetNextFv(&cursor) == nullptr);
+}
+
+TEST_CASE("FvBuffer: AppendFvBuffer grows the buffer")
+{
+    DcgmFvBuffer small(32);
+    DcgmFvBuffer big;
+    size_t bufferSize;
+    size_t elementCount;
+
+    for (int i = 0; i < 100; i++)
+    {
+        big.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, i, 1000 + i, DCGM_ST_OK);
+    }
+
+    REQUIRE(small.AppendFvBuffer(&big) == DCGM_ST_OK);
+    REQUIRE(small.AppendFvBuffer(&big) == DCGM_ST_OK);
+    REQUIRE(small.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 200);
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    int count                     = 0;
+    for (dcgmBufferedFv_t *fv = small.GetNextFv(&cursor); fv; fv = small.GetNextFv(&cursor))
+    {
+        CHECK(fv->value.i64 == count % 100);
+        count++;
+    }
+    CHECK(count == 200);
+}
+
+TEST_CASE("FvBuffer: Clear and Reserve keep the allocation")
+{
+    DcgmFvBuffer fvBuffer(512);
+    size_t bufferSize;
+    size_t elementCount;
+
+    REQUIRE(fvBuffer.Reserve(4096) == DCGM_ST_OK);
+    CHECK(fvBuffer.GetCapacity() == 4096);
+    REQUIRE(fvBuffer.Reserve(1024) == DCGM_ST_OK);
+    CHECK(fvBuffer.GetCapacity() == 4096); /* Never shrinks */
+
+    for (int i = 0; i < 100; i++)
+    {
+        fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, i, 1000 + i, DCGM_ST_OK);
+    }
+    size_t capacity = fvBuffer.GetCapacity();
+
+    fvBuffer.Clear();
+    REQUIRE(fvBuffer.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 0);
+    CHECK(fvBuffer.GetCapacity() == capacity);
+}
+
+TEST_CASE("FvBuffer: Moving hands over the FVs")
+{
+    DcgmFvBuffer fvBuffer;
+    size_t bufferSize;
+    size_t elementCount;
+
+    for (int i = 0; i < 10; i++)
+    {
+        fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, i, 1000 + i, DCGM_ST_OK);
+    }
+    char const *buffer = fvBuffer.GetBuffer();
+
+    DcgmFvBuffer moved(std::move(fvBuffer));
+    CHECK(moved.GetBuffer() == buffer); /* Not copied */
+    REQUIRE(moved.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 10);
+
+    /* The source is left empty and can be used again */
+    REQUIRE(fvBuffer.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 0);
+    CHECK(fvBuffer.begin() == fvBuffer.end());
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP, 42, 2000, DCGM_ST_OK);
+
+    moved = std::move(fvBuffer);
+    REQUIRE(moved.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 1);
+    CHECK(moved.begin()->value.i64 == 42);
+}
+
+TEST_CASE("FvBuffer: SetFromBuffer rejects corrupt buffers")
+{
+    DcgmFvBuffer source;
+    size_t bufferSize;
+    size_t elementCount;
+
+    source.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 40, 1000, DCGM_ST_OK);
+    source.AddDoubleValue(DCGM_FE_GPU, 1, DCGM_FI_DEV_POWER_USAGE, 125.5, 2000, DCGM_ST_OK);
+    REQUIRE(source.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+
+    std::vector<char> bytes(source.GetBuffer(), source.GetBuffer() + bufferSize);
+    DcgmFvBuffer copy;
+    REQUIRE(copy.SetFromBuffer(bytes.data(), bytes.size()) == DCGM_ST_OK);
+    REQUIRE(copy.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 2);
+
+    /* Ends partway through the second value's header. Each value above is 32 bytes */
+    CHECK(copy.SetFromBuffer(bytes.data(), 32 + 4) == DCGM_ST_GENERIC_ERROR);
+
+    /* A length shorter than the header would never advance */
+    ((dcgmBufferedFv_t *)bytes.data())->length = 0;
+    CHECK(copy.SetFromBuffer(bytes.data(), bytes.size()) == DCGM_ST_GENERIC_ERROR);
+}
+
+TEST_CASE("FvBuffer: Iterators and batch appends")
+{
+    DcgmFvBuffer fvBuffer;
+    long long const i64s[]       = { 10, 20, 30 };
+    double const dbls[]          = { 1.5, 2.5 };
+    long long const timestamps[] = { 1000, 1001, 1002 };
+
+    CHECK(fvBuffer.begin() == fvBuffer.end());
+
+    REQUIRE(fvBuffer.AddInt64Values(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP, i64s, timestamps, 3) == DCGM_ST_OK);
+    REQUIRE(fvBuffer.AddDoubleValues(DCGM_FE_GPU, 2, DCGM_FI_DEV_POWER_USAGE, dbls, timestamps, 2) == DCGM_ST_OK);
+    CHECK(fvBuffer.AddInt64Values(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP, nullptr, timestamps, 1) == DCGM_ST_BADPARAM);
+    CHECK(fvBuffer.AddInt64Values(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP, nullptr, nullptr, 0) == DCGM_ST_OK);
+
+    /* A batch is the same as adding the values one by one */
+    DcgmFvBuffer oneByOne;
+    for (int i = 0; i < 3; i++)
+    {
+        oneByOne.AddInt64Value(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP, i64s[i], timestamps[i], DCGM_ST_OK);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        oneByOne.AddDoubleValue(DCGM_FE_GPU, 2, DCGM_FI_DEV_POWER_USAGE, dbls[i], timestamps[i], DCGM_ST_OK);
+    }
+
+    size_t bufferSize;
+    size_t elementCount;
+    size_t oneByOneSize;
+    REQUIRE(fvBuffer.GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    REQUIRE(oneByOne.GetSize(&oneByOneSize, nullptr) == DCGM_ST_OK);
+    CHECK(elementCount == 5);
+    REQUIRE(bufferSize == oneByOneSize);
+
+    auto expected = oneByOne.begin();
+    int count     = 0;
+    for (dcgmBufferedFv_t const &fv : fvBuffer)
+    {
+        REQUIRE(expected != oneByOne.end());
+        CHECK(fv.length == expected->length);
+        CHECK(fv.fieldType == expected->fieldType);
+        CHECK(fv.entityId == expected->entityId);
+        CHECK(fv.fieldId == expected->fieldId);
+        CHECK(fv.timestamp == expected->timestamp);
+        CHECK(fv.value.i64 == expected->value.i64);
+        ++expected;
+        count++;
+    }
+    CHECK(count == 5);
+    CHECK(expected == oneByOne.end());
+
+    /* Iterators can change the FVs of a non-const buffer */
+    for (dcgmBufferedFv_t &fv : fvBuffer)
+    {
+        fv.status = DCGM_ST_NO_DATA;
+    }
+    DcgmFvBuffer const &constBuffer = fvBuffer;
+    CHECK(std::all_of(constBuffer.begin(), constBuffer.end(), [](dcgmBufferedFv_t const &fv) {
+        return fv.status == DCGM_ST_NO_DATA;
+    }));
+}
+
+TEST_CASE("FvBuffer: Find with and without the index")
+{
+    DcgmFvBuffer fvBuffer;
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 40, 1000, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP, 50, 1000, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 41, 1001, DCGM_ST_OK);
+
+    auto check = [](DcgmFvBuffer const &buffer) {
+        dcgmBufferedFv_t const *fv = buffer.Find(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP);
+        REQUIRE(fv != nullptr);
+        CHECK(fv->value.i64 == 41); /* The last one added */
+
+        fv = buffer.Find(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP);
+        REQUIRE(fv != nullptr);
+        CHECK(fv->value.i64 == 50);
+
+        CHECK(buffer.Find(DCGM_FE_GPU, 2, DCGM_FI_DEV_GPU_TEMP) == nullptr);
+        CHECK(buffer.Find(DCGM_FE_GPU_I, 0, DCGM_FI_DEV_GPU_TEMP) == nullptr);
+        CHECK(buffer.Find(DCGM_FE_GPU, 0, DCGM_FI_DEV_POWER_USAGE) == nullptr);
+    };
+
+    check(fvBuffer);
+
+    fvBuffer.EnableIndex();
+    check(fvBuffer);
+
+    /* Everything added after enabling the index is found too, even after the buffer grew */
+    long long const values[]     = { 1, 2, 3 };
+    long long const timestamps[] = { 2000, 2001, 2002 };
+    for (int i = 0; i < 100; i++)
+    {
+        fvBuffer.AddInt64Values(DCGM_FE_GPU, 100 + i, DCGM_FI_DEV_GPU_TEMP, values, timestamps, 3);
+    }
+    char const *name = "name";
+    fvBuffer.AddStringValue(DCGM_FE_GPU, 0, DCGM_FI_DEV_NAME, (char *)name, 3000, DCGM_ST_OK);
+    check(fvBuffer);
+
+    dcgmBufferedFv_t const *fv = fvBuffer.Find(DCGM_FE_GPU, 150, DCGM_FI_DEV_GPU_TEMP);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->value.i64 == 3);
+    fv = fvBuffer.Find(DCGM_FE_GPU, 0, DCGM_FI_DEV_NAME);
+    REQUIRE(fv != nullptr);
+    CHECK(std::string(fv->value.str) == "name");
+
+    /* Clear() empties the index but keeps it enabled */
+    fvBuffer.Clear();
+    CHECK(fvBuffer.Find(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP) == nullptr);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 42, 4000, DCGM_ST_OK);
+    fv = fvBuffer.Find(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->value.i64 == 42);
+}
+
+TEST_CASE("FvBuffer: Pool reuses released buffers")
+{
+    DcgmFvBufferPool pool(1);
+    size_t bufferSize;
+    size_t elementCount;
+
+    pool.SetCapacityHint(FVBUFFER_GUESS_INITIAL_CAPACITY(2, 64));
+    DcgmFvBuffer *first = pool.Acquire();
+    REQUIRE(first != nullptr);
+    CHECK(first->GetCapacity() >= FVBUFFER_GUESS_INITIAL_CAPACITY(2, 64));
+    first->AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 40, 1000, DCGM_ST_OK);
+
+    DcgmFvBuffer *second = pool.Acquire();
+    REQUIRE(second != nullptr);
+    CHECK(second != first);
+
+    pool.Release(first);
+    pool.Release(second); /* Beyond maxPooled. Freed */
+    pool.Release(nullptr);
+    CHECK(pool.NumPooled() == 1);
+
+    /* The pooled buffer comes back empty and is grown to a larger hint */
+    pool.SetCapacityHint(FVBUFFER_GUESS_INITIAL_CAPACITY(4, 64));
+    DcgmFvBuffer *reused = pool.Acquire();
+    CHECK(reused == first);
+    CHECK(pool.NumPooled() == 0);
+    REQUIRE(reused->GetSize(&bufferSize, &elementCount) == DCGM_ST_OK);
+    CHECK(elementCount == 0);
+    CHECK(reused->GetCapacity() >= FVBUFFER_GUESS_INITIAL_CAPACITY(4, 64));
+    pool.Release(reused);
+}
+
+TEST_CASE("FvBuffer: Shared buffers go back to the pool with the last reference")
+{
+    auto pool = std::make_shared<DcgmFvBufferPool>(2);
+    CHECK(pool->Share(nullptr) == nullptr);
+
+    DcgmFvBuffer *fvBuffer = pool->Acquire();
+    REQUIRE(fvBuffer != nullptr);
+    fvBuffer->AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 40, 1000, DCGM_ST_OK);
+
+    std::shared_ptr<DcgmFvBuffer const> snapshot = pool->Share(fvBuffer);
+    std::shared_ptr<DcgmFvBuffer const> copy     = snapshot;
+    snapshot.reset();
+    CHECK(pool->NumPooled() == 0);
+
+    /* Outliving the pool's owner is fine */
+    std::weak_ptr<DcgmFvBufferPool> weakPool = pool;
+    pool.reset();
+    REQUIRE(!weakPool.expired());
+    CHECK(weakPool.lock()->NumPooled() == 0);
+    copy.reset();
+    CHECK(weakPool.expired());
+}
+
+TEST_CASE("FvBuffer: Update worker handles snapshots in order")
+{
+    auto pool = std::make_shared<DcgmFvBufferPool>(8);
+    std::vector<long long> seen;
+
+    DcgmFvUpdateWorker worker(
+        [&seen](DcgmFvBuffer const &fvBuffer) {
+            dcgmBufferedFvCursor_t cursor = 0;
+            for (dcgmBufferedFv_t const *fv = fvBuffer.GetNextFv(&cursor); fv; fv = fvBuffer.GetNextFv(&cursor))
+            {
+                seen.push_back(fv->value.i64);
+            }
+        },
+        "fv_worker_test");
+    REQUIRE(worker.Start() == 0);
+
+    for (long long i = 0; i < 50; i++)
+    {
+        DcgmFvBuffer *fvBuffer = pool->Acquire();
+        REQUIRE(fvBuffer != nullptr);
+        fvBuffer->AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, i, 1000 + i, DCGM_ST_OK);
+        worker.Post(pool->Share(fvBuffer));
+    }
+    worker.Post(nullptr);
+
+    /* Everything posted so far has been handled and released */
+    worker.Flush();
+    REQUIRE(seen.size() == 50);
+    for (long long i = 0; i < 50; i++)
+    {
+        CHECK(seen[i] == i);
+    }
+    CHECK(pool->NumPooled() > 0);
+
+    /* Flush doesn't hang once the worker is stopping */
+    worker.StopAndWait(10000);
+    worker.Flush();
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmIpcCompression.h>
+
+#include <vector>
+
+/* Something shaped like a run of buffered field values: repetitive headers, slowly changing values */
+static std::vector<char> MakeBody(size_t length)
+{
+    std::vector<char> body(length);
+    for (size_t i = 0; i < length; i++)
+        body[i] = (char)((i % 64) < 48 ? i % 64 : i / 64);
+    return body;
+}
+
+TEST_CASE("IpcCompression: round trip")
+{
+    std::vector<char> const body = MakeBody(100000);
+
+    /* Appends after what is already there */
+    std::vector<char> compressed { 'h', 'd', 'r' };
+    REQUIRE(DcgmIpcCompress(DCGM_TRANSPORT_COMPRESSION_ZLIB, body.data(), body.size(), compressed) == DCGM_ST_OK);
+    REQUIRE(compressed.size() > 3);
+    CHECK(compressed[0] == 'h');
+    CHECK(compressed.size() < body.size() / 4);
+
+    std::vector<char> decompressed(body.size());
+    REQUIRE(DcgmIpcDecompress(DCGM_TRANSPORT_COMPRESSION_ZLIB,
+                              compressed.data() + 3,
+                              compressed.size() - 3,
+                              decompressed.data(),
+                              decompressed.size())
+            == DCGM_ST_OK);
+    CHECK(decompressed == body);
+}
+
+TEST_CASE("IpcCompression: empty body")
+{
+    std::vector<char> compressed;
+    REQUIRE(DcgmIpcCompress(DCGM_TRANSPORT_COMPRESSION_ZLIB, nullptr, 0, compressed) == DCGM_ST_OK);
+
+    char unused;
+    CHECK(DcgmIpcDecompress(DCGM_TRANSPORT_COMPRESSION_ZLIB, compressed.data(), compressed.size(), &unused, 0)
+          == DCGM_ST_OK);
+}
+
+TEST_CASE("IpcCompression: rejects bad input")
+{
+    std::vector<char> const body = MakeBody(5000);
+    std::vector<char> compressed;
+
+    CHECK(DcgmIpcCompress(DCGM_TRANSPORT_COMPRESSION_NONE, body.data(), body.size(), compressed)
+          == DCGM_ST_NOT_SUPPORTED);
+    CHECK(compressed.empty());
+
+    REQUIRE(DcgmIpcCompress(DCGM_TRANSPORT_COMPRESSION_ZLIB, body.data(), body.size(), compressed) == DCGM_ST_OK);
+
+    /* The length has to match exactly */
+    std::vector<char> decompressed(body.size() + 1);
+    CHECK(DcgmIpcDecompress(
+              DCGM_TRANSPORT_COMPRESSION_ZLIB, compressed.data(), compressed.size(), decompressed.data(), body.size() + 1)
+          == DCGM_ST_BADPARAM);
+    CHECK(DcgmIpcDecompress(
+              DCGM_TRANSPORT_COMPRESSION_ZLIB, compressed.data(), compressed.size(), decompressed.data(), body.size() - 1)
+          == DCGM_ST_BADPARAM);
+
+    /* Truncated */
+    CHECK(DcgmIpcDecompress(
+              DCGM_TRANSPORT_COMPRESSION_ZLIB, compressed.data(), compressed.size() / 2, decompressed.data(), body.size())
+          == DCGM_ST_BADPARAM);
+
+    /* Unknown algorithm */
+    CHECK(DcgmIpcDecompress(7, compressed.data(), compressed.size(), decompressed.data(), body.size())
+          == DCGM_ST_NOT_SUPPORTED);
+}
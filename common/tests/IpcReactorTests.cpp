@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmIpc.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unistd.h>
+
+namespace
+{
+/* Counts what a DcgmIpc hands to its worker pool */
+struct Received
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::multiset<dcgm_connection_id_t> connectionIds;
+    DcgmIpc *ipc = nullptr; /* Echo messages back over this if set */
+
+    bool WaitFor(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(10), [&] { return connectionIds.size() >= count; });
+    }
+
+    static void ProcessMessage(dcgm_connection_id_t connectionId, std::unique_ptr<DcgmMessage> message, void *userData)
+    {
+        auto received = (Received *)userData;
+        if (received->ipc != nullptr)
+        {
+            received->ipc->SendMessage(connectionId, std::move(message), false);
+        }
+
+        std::lock_guard<std::mutex> lock(received->mutex);
+        received->connectionIds.insert(connectionId);
+        received->condition.notify_all();
+    }
+
+    static void ProcessDisconnect(dcgm_connection_id_t, void *)
+    {}
+};
+
+std::unique_ptr<DcgmMessage> MakeMessage()
+{
+    auto message = std::make_unique<DcgmMessage>();
+    message->UpdateMsgHdr(DCGM_MSG_PROTO_REQUEST, 1, DCGM_ST_OK, 4);
+    message->GetMsgBytesPtr()->assign(4, 'x');
+    return message;
+}
+} // namespace
+
+TEST_CASE("IpcReactor: connections are spread over reactors")
+{
+    std::string const path = "/tmp/dcgm_ipc_reactor_test_" + std::to_string(getpid());
+    unsigned int const numClients = 7;
+
+    Received serverReceived;
+    DcgmIpc server(2);
+    serverReceived.ipc = &server;
+
+    DcgmIpcDomainServerParams_t domainParams {};
+    domainParams.domainSocketPath = path;
+    REQUIRE(server.Init(std::nullopt,
+                        domainParams,
+                        Received::ProcessMessage,
+                        &serverReceived,
+                        Received::ProcessDisconnect,
+                        nullptr,
+                        3)
+            == DCGM_ST_OK);
+
+    Received clientReceived;
+    DcgmIpc client(1);
+    REQUIRE(client.Init(std::nullopt,
+                        std::nullopt,
+                        Received::ProcessMessage,
+                        &clientReceived,
+                        Received::ProcessDisconnect,
+                        nullptr,
+                        2)
+            == DCGM_ST_OK);
+
+    std::vector<dcgm_connection_id_t> connectionIds(numClients);
+    for (auto &connectionId : connectionIds)
+    {
+        REQUIRE(client.ConnectDomain(path, connectionId, 5000) == DCGM_ST_OK);
+        REQUIRE(client.SendMessage(connectionId, MakeMessage(), true) == DCGM_ST_OK);
+    }
+
+    /* Each request comes back on the connection it was sent over */
+    REQUIRE(serverReceived.WaitFor(numClients));
+    REQUIRE(clientReceived.WaitFor(numClients));
+    CHECK(std::set<dcgm_connection_id_t>(serverReceived.connectionIds.begin(), serverReceived.connectionIds.end())
+              .size()
+          == numClients);
+    CHECK(clientReceived.connectionIds
+          == std::multiset<dcgm_connection_id_t>(connectionIds.begin(), connectionIds.end()));
+
+    /* Stats of one connection come from its reactor. The total covers all of them */
+    DcgmIpcConnectionStats_t stats {};
+    REQUIRE(client.GetConnectionStats(connectionIds[1], stats) == DCGM_ST_OK);
+    CHECK(stats.counters.messagesSent == 1);
+    REQUIRE(server.GetConnectionStats(DCGM_CONNECTION_ID_NONE, stats) == DCGM_ST_OK);
+    CHECK(stats.counters.messagesReceived == numClients);
+    CHECK(stats.counters.messagesSent == numClients);
+
+    /* Closed connections still count toward the total */
+    REQUIRE(client.CloseConnection(connectionIds[0]) == DCGM_ST_OK);
+    REQUIRE(client.GetConnectionStats(DCGM_CONNECTION_ID_NONE, stats) == DCGM_ST_OK);
+    CHECK(stats.counters.messagesSent == numClients);
+    CHECK(client.GetConnectionStats(connectionIds[0], stats) == DCGM_ST_CONNECTION_NOT_VALID);
+
+    unlink(path.c_str());
+}
+
+TEST_CASE("IpcReactor: a busy worker lane doesn't hold up other lanes")
+{
+    std::string const path = "/tmp/dcgm_ipc_lanes_test_" + std::to_string(getpid());
+
+    /* Module commands go to lane 1 and block there until released. Everything else goes to lane 0 */
+    struct Blocker
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool released = false;
+    } blocker;
+
+    Received serverReceived;
+    DcgmIpc server(1);
+    serverReceived.ipc = &server;
+    server.SetWorkerLanes(
+        { { 1, 1 }, { 1, 1 } },
+        [](DcgmMessage &message, void *) { return message.GetMsgType() == DCGM_MSG_MODULE_COMMAND ? 1U : 0U; },
+        nullptr);
+
+    auto processMessage = [&](dcgm_connection_id_t connectionId, std::unique_ptr<DcgmMessage> message, void *) {
+        if (message->GetMsgType() == DCGM_MSG_MODULE_COMMAND)
+        {
+            std::unique_lock<std::mutex> lock(blocker.mutex);
+            blocker.condition.wait(lock, [&] { return blocker.released; });
+        }
+        Received::ProcessMessage(connectionId, std::move(message), &serverReceived);
+    };
+
+    DcgmIpcDomainServerParams_t domainParams {};
+    domainParams.domainSocketPath = path;
+    REQUIRE(server.Init(std::nullopt, domainParams, processMessage, nullptr, Received::ProcessDisconnect, nullptr)
+            == DCGM_ST_OK);
+
+    Received clientReceived;
+    DcgmIpc client(1);
+    REQUIRE(client.Init(
+                std::nullopt, std::nullopt, Received::ProcessMessage, &clientReceived, Received::ProcessDisconnect, nullptr)
+            == DCGM_ST_OK);
+
+    dcgm_connection_id_t connectionId;
+    REQUIRE(client.ConnectDomain(path, connectionId, 5000) == DCGM_ST_OK);
+
+    auto slowMessage = MakeMessage();
+    slowMessage->UpdateMsgHdr(DCGM_MSG_MODULE_COMMAND, 2, DCGM_ST_OK, 4);
+    REQUIRE(client.SendMessage(connectionId, std::move(slowMessage), true) == DCGM_ST_OK);
+    REQUIRE(client.SendMessage(connectionId, MakeMessage(), true) == DCGM_ST_OK);
+
+    /* The quick request is answered while the slow one is still being processed */
+    REQUIRE(clientReceived.WaitFor(1));
+
+    {
+        std::lock_guard<std::mutex> lock(blocker.mutex);
+        blocker.released = true;
+    }
+    blocker.condition.notify_all();
+    REQUIRE(clientReceived.WaitFor(2));
+
+    unlink(path.c_str());
+}
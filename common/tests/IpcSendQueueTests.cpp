@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmIpc.h>
+
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+size_t const MESSAGE_BYTES  = 64 * 1024;
+size_t const HIGH_WATERMARK = 256 * 1024;
+
+/* A domain socket peer that accepts connections and never reads from them */
+class StalledPeer
+{
+public:
+    StalledPeer()
+    {
+        m_path = "/tmp/dcgm_ipc_send_queue_test_" + std::to_string(getpid());
+        unlink(m_path.c_str());
+
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, m_path.c_str(), sizeof(addr.sun_path) - 1);
+
+        m_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        REQUIRE(m_fd >= 0);
+        REQUIRE(bind(m_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+        REQUIRE(listen(m_fd, 4) == 0);
+    }
+
+    ~StalledPeer()
+    {
+        close(m_fd);
+        unlink(m_path.c_str());
+    }
+
+    std::string m_path;
+    int m_fd = -1;
+};
+
+void ProcessMessage(dcgm_connection_id_t, std::unique_ptr<DcgmMessage>, void *)
+{}
+
+void ProcessDisconnect(dcgm_connection_id_t, void *)
+{}
+
+std::unique_ptr<DcgmMessage> MakeMessage(unsigned int msgType, dcgm_request_id_t requestId)
+{
+    auto message = std::make_unique<DcgmMessage>();
+    message->UpdateMsgHdr(msgType, requestId, DCGM_ST_OK, MESSAGE_BYTES);
+    message->GetMsgBytesPtr()->assign(MESSAGE_BYTES, 'x');
+    return message;
+}
+
+void InitIpc(DcgmIpc &ipc, DcgmIpcSlowConsumerPolicy_t policy)
+{
+    DcgmIpcSendQueueParams_t params {};
+    params.highWatermark = HIGH_WATERMARK;
+    params.lowWatermark  = HIGH_WATERMARK / 2;
+    params.policy        = policy;
+    ipc.SetSendQueueParams(params);
+
+    REQUIRE(ipc.Init(std::nullopt, std::nullopt, ProcessMessage, nullptr, ProcessDisconnect, nullptr) == DCGM_ST_OK);
+}
+} // namespace
+
+TEST_CASE("IpcSendQueue: notifications to a stalled peer are dropped oldest first")
+{
+    StalledPeer peer;
+    DcgmIpc ipc(1);
+    InitIpc(ipc, DCGM_IPC_SLOW_CONSUMER_DROP_OLDEST);
+
+    dcgm_connection_id_t connectionId;
+    REQUIRE(ipc.ConnectDomain(peer.m_path, connectionId, 5000) == DCGM_ST_OK);
+
+    /* Far more than the socket buffers and the high watermark together */
+    for (int i = 0; i < 200; i++)
+    {
+        REQUIRE(ipc.SendMessage(connectionId, MakeMessage(DCGM_MSG_POLICY_NOTIFY, 1), true) == DCGM_ST_OK);
+    }
+
+    DcgmIpcConnectionStats_t stats {};
+    REQUIRE(ipc.GetConnectionStats(connectionId, stats) == DCGM_ST_OK);
+    CHECK(stats.sendQueue.highWatermarkHits == 1);
+    CHECK(stats.sendQueue.messagesDropped > 0);
+    CHECK(stats.sendQueue.heldMessages > 0);
+    CHECK(stats.sendQueue.queuedBytes <= 2 * HIGH_WATERMARK + MESSAGE_BYTES);
+
+    /* Replies can't be dropped, so piling them up closes the connection */
+    dcgmReturn_t dcgmReturn = DCGM_ST_OK;
+    for (int i = 0; i < 10 && dcgmReturn == DCGM_ST_OK; i++)
+    {
+        dcgmReturn = ipc.SendMessage(connectionId, MakeMessage(DCGM_MSG_PROTO_RESPONSE, 2), true);
+    }
+    CHECK(dcgmReturn == DCGM_ST_CONNECTION_NOT_VALID);
+    CHECK(ipc.GetConnectionStats(connectionId, stats) == DCGM_ST_CONNECTION_NOT_VALID);
+
+    /* The closed connection still counts toward the total */
+    REQUIRE(ipc.GetConnectionStats(DCGM_CONNECTION_ID_NONE, stats) == DCGM_ST_OK);
+    CHECK(stats.sendQueue.messagesDropped > 0);
+    CHECK(stats.sendQueue.queuedBytes == 0);
+}
+
+TEST_CASE("IpcSendQueue: coalescing keeps one notification per request")
+{
+    StalledPeer peer;
+    DcgmIpc ipc(1);
+    InitIpc(ipc, DCGM_IPC_SLOW_CONSUMER_COALESCE);
+
+    dcgm_connection_id_t connectionId;
+    REQUIRE(ipc.ConnectDomain(peer.m_path, connectionId, 5000) == DCGM_ST_OK);
+
+    for (int i = 0; i < 200; i++)
+    {
+        REQUIRE(ipc.SendMessage(connectionId, MakeMessage(DCGM_MSG_ATTRIBUTE_GENERATION, 1 + i % 2), true)
+                == DCGM_ST_OK);
+    }
+
+    DcgmIpcConnectionStats_t stats {};
+    REQUIRE(ipc.GetConnectionStats(connectionId, stats) == DCGM_ST_OK);
+    CHECK(stats.sendQueue.heldMessages == 2);
+    CHECK(stats.sendQueue.messagesCoalesced > 0);
+    CHECK(stats.sendQueue.messagesDropped == 0);
+}
+
+TEST_CASE("IpcSendQueue: the disconnect policy closes slow connections")
+{
+    StalledPeer peer;
+    DcgmIpc ipc(1);
+    InitIpc(ipc, DCGM_IPC_SLOW_CONSUMER_DISCONNECT);
+
+    dcgm_connection_id_t connectionId;
+    REQUIRE(ipc.ConnectDomain(peer.m_path, connectionId, 5000) == DCGM_ST_OK);
+
+    dcgmReturn_t dcgmReturn = DCGM_ST_OK;
+    for (int i = 0; i < 200 && dcgmReturn == DCGM_ST_OK; i++)
+    {
+        dcgmReturn = ipc.SendMessage(connectionId, MakeMessage(DCGM_MSG_POLICY_NOTIFY, 1), true);
+    }
+    CHECK(dcgmReturn == DCGM_ST_CONNECTION_NOT_VALID);
+
+    DcgmIpcConnectionStats_t stats {};
+    REQUIRE(ipc.GetConnectionStats(DCGM_CONNECTION_ID_NONE, stats) == DCGM_ST_OK);
+    CHECK(stats.sendQueue.highWatermarkHits == 1);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmIpcShm.h>
+
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+static std::unique_ptr<DcgmMessage> MakeMessage(dcgm_request_id_t requestId, size_t length)
+{
+    auto message = std::make_unique<DcgmMessage>();
+    message->UpdateMsgHdr(0x1234, requestId, DCGM_ST_OK, (int)length);
+
+    std::vector<char> *body = message->GetMsgBytesPtr();
+    body->resize(length);
+    for (size_t i = 0; i < length; i++)
+        (*body)[i] = (char)(requestId + i);
+    return message;
+}
+
+static void CheckMessage(DcgmMessage &message, dcgm_request_id_t requestId, size_t length)
+{
+    CHECK(message.GetMsgType() == 0x1234);
+    CHECK(message.GetRequestId() == requestId);
+    REQUIRE(message.GetMsgBytesPtr()->size() == length);
+
+    std::vector<char> *body = message.GetMsgBytesPtr();
+    size_t numBad           = 0;
+    for (size_t i = 0; i < length; i++)
+        numBad += (*body)[i] != (char)(requestId + i);
+    CHECK(numBad == 0);
+}
+
+/* Server and client ends of one channel, as if the fds had been passed over a socket */
+static void MakeChannelPair(DcgmIpcShmChannel &server, DcgmIpcShmChannel &client, unsigned int ringSize)
+{
+    REQUIRE(server.Create(ringSize) == DCGM_ST_OK);
+
+    int fds[DCGM_IPC_SHM_NUM_FDS];
+    server.GetSetupFds(fds);
+    for (auto &fd : fds)
+        fd = dup(fd);
+
+    REQUIRE(client.Attach(fds, server.GetRingSize()) == DCGM_ST_OK);
+}
+
+TEST_CASE("IpcShm: round trip")
+{
+    DcgmIpcShmChannel server;
+    DcgmIpcShmChannel client;
+    MakeChannelPair(server, client, 4096);
+
+    std::vector<std::unique_ptr<DcgmMessage>> messages;
+    CHECK(server.ReadMessages(messages) == DCGM_ST_NO_DATA);
+
+    REQUIRE(client.SendMessage(MakeMessage(1, 0)) == DCGM_ST_OK);
+    REQUIRE(client.SendMessage(MakeMessage(2, 100)) == DCGM_ST_OK);
+
+    REQUIRE(server.ReadMessages(messages) == DCGM_ST_OK);
+    REQUIRE(messages.size() == 2);
+    CheckMessage(*messages[0], 1, 0);
+    CheckMessage(*messages[1], 2, 100);
+
+    /* The other direction is independent */
+    messages.clear();
+    REQUIRE(server.SendMessage(MakeMessage(3, 1000)) == DCGM_ST_OK);
+    CHECK(server.ReadMessages(messages) == DCGM_ST_NO_DATA);
+    REQUIRE(client.ReadMessages(messages) == DCGM_ST_OK);
+    REQUIRE(messages.size() == 1);
+    CheckMessage(*messages[0], 3, 1000);
+}
+
+TEST_CASE("IpcShm: messages larger than the ring")
+{
+    DcgmIpcShmChannel server;
+    DcgmIpcShmChannel client;
+    MakeChannelPair(server, client, 4096);
+
+    size_t const lengths[] = { 10000, 4096, 4096 - sizeof(dcgm_message_header_t), 3, 50000 };
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+        REQUIRE(server.SendMessage(MakeMessage(100 + i, lengths[i])) == DCGM_ST_OK);
+
+    /* Alternate the way the IPC threads would until everything is across */
+    std::vector<std::unique_ptr<DcgmMessage>> messages;
+    for (int pass = 0; pass < 1000 && messages.size() < 5; pass++)
+    {
+        client.AcknowledgeWake();
+        dcgmReturn_t dcgmReturn = client.ReadMessages(messages);
+        REQUIRE((dcgmReturn == DCGM_ST_OK || dcgmReturn == DCGM_ST_NO_DATA));
+
+        server.AcknowledgeWake();
+        REQUIRE(server.FlushPending() == DCGM_ST_OK);
+    }
+
+    REQUIRE(messages.size() == 5);
+    for (size_t i = 0; i < messages.size(); i++)
+        CheckMessage(*messages[i], 100 + i, lengths[i]);
+}
+
+TEST_CASE("IpcShm: wake fd")
+{
+    DcgmIpcShmChannel server;
+    DcgmIpcShmChannel client;
+    MakeChannelPair(server, client, 4096);
+
+    uint64_t count = 0;
+    CHECK(read(server.GetWakeFd(), &count, sizeof(count)) < 0); /* Nonblocking and not signaled yet */
+
+    REQUIRE(client.SendMessage(MakeMessage(1, 10)) == DCGM_ST_OK);
+    CHECK(read(server.GetWakeFd(), &count, sizeof(count)) == sizeof(count));
+    CHECK(count > 0);
+}
+
+TEST_CASE("IpcShm: attach rejects a bad ring size")
+{
+    DcgmIpcShmChannel server;
+    DcgmIpcShmChannel client;
+    REQUIRE(server.Create(4096) == DCGM_ST_OK);
+
+    int fds[DCGM_IPC_SHM_NUM_FDS];
+    server.GetSetupFds(fds);
+    for (auto &fd : fds)
+        fd = dup(fd);
+
+    CHECK(client.Attach(fds, 8192) != DCGM_ST_OK);
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <LockFreeQueue.hpp>
+#include <ThreadSafeQueue.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace DcgmNs;
+
+TEST_CASE("LockFreeQueue : Overflow keeps the order")
+{
+    LockFreeQueue<int> queue(4);
+    REQUIRE(queue.GetCapacity() == 4);
+
+    int value = 0;
+    CHECK(queue.IsEmpty());
+    CHECK_FALSE(queue.TryDequeue(value));
+
+    for (int i = 0; i < 10; i++)
+    {
+        queue.Enqueue(i);
+    }
+    CHECK(queue.GetOverflowCount() == 6);
+
+    /* Room in the ring again, but values keep going after the ones that overflowed until those are dequeued */
+    REQUIRE(queue.TryDequeue(value));
+    CHECK(value == 0);
+    queue.Enqueue(10);
+
+    for (int i = 1; i <= 10; i++)
+    {
+        REQUIRE(queue.TryDequeue(value));
+        CHECK(value == i);
+    }
+    CHECK_FALSE(queue.TryDequeue(value));
+    CHECK(queue.IsEmpty());
+}
+
+TEST_CASE("LockFreeQueue : Many producers")
+{
+    constexpr int numProducers = 4;
+    constexpr int numValues    = 20000;
+
+    LockFreeQueue<int> queue(64);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; p++)
+    {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < numValues; i++)
+            {
+                queue.Enqueue(p * numValues + i);
+            }
+        });
+    }
+
+    /* Each producer's values come out in the order it enqueued them */
+    std::vector<int> next(numProducers, 0);
+    int received = 0;
+    while (received < numProducers * numValues)
+    {
+        int value = 0;
+        if (!queue.TryDequeue(value))
+        {
+            REQUIRE(queue.WaitUntil(std::chrono::system_clock::now() + std::chrono::seconds(10))
+                    == LockFreeQueue<int>::WaitResult::Ok);
+            continue;
+        }
+        int const producer = value / numValues;
+        REQUIRE(value % numValues == next[producer]);
+        next[producer]++;
+        received++;
+    }
+
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    CHECK(queue.IsEmpty());
+}
+
+TEST_CASE("LockFreeQueue : Wait")
+{
+    using namespace std::chrono_literals;
+    LockFreeQueue<int> queue;
+
+    auto start = std::chrono::system_clock::now();
+    CHECK(queue.WaitUntil(start + 20ms) == LockFreeQueue<int>::WaitResult::TimedOut);
+    CHECK(std::chrono::system_clock::now() - start >= 20ms);
+
+    /* Each thread acts once the consumer is about to wait. Whether it gets there before or during the wait, the
+       wait must see what it did */
+    std::promise<void> waiting;
+    std::thread producer([&queue, started = waiting.get_future()] {
+        started.wait();
+        queue.Enqueue(1);
+    });
+    waiting.set_value();
+    CHECK(queue.WaitUntil(std::chrono::system_clock::now() + 10s) == LockFreeQueue<int>::WaitResult::Ok);
+    producer.join();
+
+    std::promise<void> waitingToClose;
+    std::thread closer([&queue, started = waitingToClose.get_future()] {
+        started.wait();
+        queue.Close();
+    });
+    int value = 0;
+    REQUIRE(queue.TryDequeue(value));
+    waitingToClose.set_value();
+    CHECK(queue.WaitUntil(std::chrono::system_clock::now() + 10s) == LockFreeQueue<int>::WaitResult::Closed);
+    closer.join();
+}
+
+/* Throughput against the ThreadSafeQueue that TaskRunner otherwise uses, with several producers and one consumer.
+   Hidden from the default run. Use: commontests "[benchmark]" */
+TEST_CASE("LockFreeQueue : Benchmark against ThreadSafeQueue", "[.][benchmark]")
+{
+    using Clock                   = std::chrono::steady_clock;
+    constexpr int numProducers    = 4;
+    constexpr int valuesPerThread = 1000000;
+    constexpr int numValues       = numProducers * valuesPerThread;
+
+    auto measure = [](auto enqueue, auto tryDequeue) {
+        std::vector<std::thread> producers;
+        auto start = Clock::now();
+        for (int p = 0; p < numProducers; p++)
+        {
+            producers.emplace_back([&enqueue] {
+                for (int i = 0; i < valuesPerThread; i++)
+                {
+                    enqueue(i);
+                }
+            });
+        }
+        long long sum = 0;
+        for (int received = 0; received < numValues;)
+        {
+            int value = 0;
+            if (tryDequeue(value))
+            {
+                sum += value;
+                received++;
+            }
+        }
+        auto elapsed = Clock::now() - start;
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+        CHECK(sum == (long long)numProducers * valuesPerThread * (valuesPerThread - 1) / 2);
+        return std::chrono::duration<double, std::nano>(elapsed).count() / numValues;
+    };
+
+    ThreadSafeQueue<int> locked;
+    double const lockedNs = measure([&locked](int value) { locked.Lock().Enqueue(value); },
+                                    [&locked](int &value) {
+                                        auto handle = locked.Lock();
+                                        if (handle.IsEmpty())
+                                        {
+                                            return false;
+                                        }
+                                        value = handle.Dequeue();
+                                        return true;
+                                    });
+
+    LockFreeQueue<int> lockFree;
+    double const lockFreeNs = measure([&lockFree](int value) { lockFree.Enqueue(value); },
+                                      [&lockFree](int &value) { return lockFree.TryDequeue(value); });
+
+    WARN("Producers: " << numProducers << ". ns/value ThreadSafeQueue vs LockFreeQueue: " << lockedNs << " vs "
+                       << lockFreeNs << ". Overflowed: " << lockFree.GetOverflowCount());
+}
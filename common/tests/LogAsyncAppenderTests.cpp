@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <DcgmLogAsyncAppender.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+/* Keeps the messages it is given. Writes wait while m_gate is held */
+class CaptureAppender : public plog::IAppender
+{
+public:
+    void write(plog::Record const &record) override
+    {
+        std::lock_guard<std::mutex> gate(m_gate);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_messages.push_back(record.getMessage());
+    }
+
+    std::vector<std::string> Messages()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_messages;
+    }
+
+    std::mutex m_gate;
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::string> m_messages;
+};
+
+void Log(plog::IAppender &appender, std::string const &message)
+{
+    plog::Record record(plog::info, __FUNCTION__, __LINE__, __FILE__, nullptr);
+    record << message;
+    appender.write(record);
+}
+} // namespace
+
+TEST_CASE("LogAsyncAppender: policy strings")
+{
+    using DcgmNs::Logging::AsyncAppender;
+    using DcgmNs::Logging::AsyncOverflowPolicy;
+
+    AsyncOverflowPolicy policy = AsyncOverflowPolicy::Block;
+    CHECK(AsyncAppender::PolicyFromString("DROP", policy));
+    CHECK(policy == AsyncOverflowPolicy::Drop);
+    CHECK(AsyncAppender::PolicyFromString(DCGM_LOGGING_ASYNC_STRING_BLOCK, policy));
+    CHECK(policy == AsyncOverflowPolicy::Block);
+    CHECK_FALSE(AsyncAppender::PolicyFromString("", policy));
+    CHECK_FALSE(AsyncAppender::PolicyFromString("sync", policy));
+}
+
+TEST_CASE("LogAsyncAppender: block keeps every record in thread order")
+{
+    using DcgmNs::Logging::AsyncAppender;
+    using DcgmNs::Logging::AsyncOverflowPolicy;
+
+    auto capture  = std::make_unique<CaptureAppender>();
+    auto *target  = capture.get();
+    auto appender = std::make_unique<AsyncAppender>(std::move(capture), AsyncOverflowPolicy::Block, 8);
+
+    constexpr int numThreads = 4;
+    constexpr int numRecords = 500;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back([&appender, t] {
+            for (int i = 0; i < numRecords; i++)
+            {
+                Log(*appender, std::to_string(t) + ":" + std::to_string(i));
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    appender->Flush();
+    CHECK(appender->GetDroppedCount() == 0);
+
+    std::vector<std::string> messages = target->Messages();
+    REQUIRE(messages.size() == numThreads * numRecords);
+
+    std::map<int, int> nextRecord;
+    for (auto const &message : messages)
+    {
+        int const t = std::stoi(message.substr(0, message.find(':')));
+        int const i = std::stoi(message.substr(message.find(':') + 1));
+        CHECK(i == nextRecord[t]);
+        nextRecord[t] = i + 1;
+    }
+}
+
+TEST_CASE("LogAsyncAppender: drop counts and reports what didn't fit")
+{
+    using DcgmNs::Logging::AsyncAppender;
+    using DcgmNs::Logging::AsyncOverflowPolicy;
+
+    auto capture  = std::make_unique<CaptureAppender>();
+    auto *target  = capture.get();
+    auto appender = std::make_unique<AsyncAppender>(std::move(capture), AsyncOverflowPolicy::Drop, 4);
+
+    {
+        /* The writer is stuck in the target, so the ring fills up */
+        std::lock_guard<std::mutex> gate(target->m_gate);
+        for (int i = 0; i < 100; i++)
+        {
+            Log(*appender, std::to_string(i));
+        }
+    }
+
+    appender->Flush();
+    std::uint64_t const dropped = appender->GetDroppedCount();
+    CHECK(dropped > 0);
+
+    std::vector<std::string> messages = target->Messages();
+    auto const isReport = [](std::string const &message) { return message.find("Dropped") == 0; };
+    CHECK(std::count_if(messages.begin(), messages.end(), isReport) == 1);
+    /* Every record was either written or dropped, plus the report of the drops */
+    CHECK(messages.size() - 1 + dropped == 100);
+}
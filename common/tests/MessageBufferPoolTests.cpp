@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmMessageBufferPool.h>
+#include <DcgmProtocol.h>
+
+TEST_CASE("MessageBufferPool: buffers are reused within their size class")
+{
+    DcgmMessageBufferPool pool;
+
+    std::vector<char> buffer = pool.Acquire(1000);
+    CHECK(buffer.empty());
+    CHECK(buffer.capacity() >= 1024);
+    buffer.resize(1000);
+    char const *storage = buffer.data();
+    pool.Release(std::move(buffer));
+    CHECK(buffer.capacity() == 0);
+
+    /* Anything up to the class size gets the same storage back */
+    buffer = pool.Acquire(600);
+    CHECK(buffer.empty());
+    CHECK(buffer.data() == storage);
+
+    /* A larger class doesn't have anything pooled */
+    std::vector<char> larger = pool.Acquire(4096);
+    CHECK(larger.capacity() >= 4096);
+
+    auto stats = pool.GetStats();
+    CHECK(stats.acquires == 3);
+    CHECK(stats.hits == 1);
+    CHECK(stats.pooledBytes == 0);
+
+    /* Small and oversized buffers aren't kept */
+    pool.Release(std::vector<char>(16));
+    pool.Release(std::vector<char>(((size_t)1 << DcgmMessageBufferPool::MAX_CLASS_SHIFT) * 2));
+    stats = pool.GetStats();
+    CHECK(stats.releases == 2);
+    CHECK(stats.discarded == 1);
+    CHECK(stats.pooledBytes == 0);
+}
+
+TEST_CASE("MessageBufferPool: the pool stays under its byte budget")
+{
+    DcgmMessageBufferPool pool(8192);
+
+    std::vector<std::vector<char>> buffers;
+    for (int i = 0; i < 4; i++)
+    {
+        buffers.push_back(pool.Acquire(4096));
+    }
+    for (auto &buffer : buffers)
+    {
+        pool.Release(std::move(buffer));
+    }
+
+    auto stats = pool.GetStats();
+    CHECK(stats.pooledBytes <= 8192);
+    CHECK(stats.discarded == 2);
+}
+
+TEST_CASE("MessageBufferPool: messages get their bodies from the global pool")
+{
+    dcgm_message_header_t header {};
+    header.msgId  = DCGM_PROTO_MAGIC;
+    header.length = 3000;
+
+    auto before = DcgmMessageBufferPool::Global().GetStats();
+    {
+        DcgmMessage message(&header);
+        CHECK(message.GetMsgBytesPtr()->capacity() >= 3000);
+        message.GetMsgBytesPtr()->resize(3000);
+    }
+    {
+        /* Room for a larger reply keeps the content */
+        DcgmMessage message(&header);
+        message.GetMsgBytesPtr()->assign(3000, 'x');
+        message.ReserveMsgBytes(10000);
+        CHECK(message.GetMsgBytesPtr()->size() == 3000);
+        CHECK(message.GetMsgBytesPtr()->back() == 'x');
+        CHECK(message.GetMsgBytesPtr()->capacity() >= 10000);
+    }
+    auto after = DcgmMessageBufferPool::Global().GetStats();
+
+    CHECK(after.acquires - before.acquires == 3);
+    CHECK(after.hits - before.hits >= 1);
+}
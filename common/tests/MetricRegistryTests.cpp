@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmMetricRegistry.h>
+#include <DcgmStatCollection.h>
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace DcgmNs;
+
+TEST_CASE("MetricRegistry: Registration")
+{
+    MetricRegistry registry;
+
+    MetricHandle const counter = registry.RegisterCounter("fetches");
+    MetricHandle const gauge   = registry.RegisterGauge("bytes");
+    MetricHandle const gpu0    = registry.RegisterCounter("fetches", MetricScope::Gpu, 0);
+    MetricHandle const gpu1    = registry.RegisterCounter("fetches", MetricScope::Gpu, 1);
+
+    CHECK(registry.Size() == 4);
+    CHECK(counter != gpu0);
+    CHECK(gpu0 != gpu1);
+    CHECK(registry.RegisterCounter("fetches") == counter);
+    CHECK(registry.Find("bytes") == gauge);
+    CHECK(registry.Find("bytes", MetricScope::Gpu, 0) == InvalidMetricHandle);
+    CHECK(registry.GetName(gpu1) == "fetches");
+    CHECK(registry.GetKind(gauge) == MetricKind::Gauge);
+
+    /* Same name as another kind */
+    CHECK(registry.RegisterGauge("fetches") == InvalidMetricHandle);
+    CHECK(registry.RegisterHistogram("unsorted", { 4.0, 2.0 }) == InvalidMetricHandle);
+    CHECK(registry.Size() == 4);
+}
+
+TEST_CASE("MetricRegistry: Counters and gauges")
+{
+    MetricRegistry registry;
+
+    MetricHandle const counter = registry.RegisterCounter("exec-time");
+    MetricHandle const gauge   = registry.RegisterGauge("recent-exec-time");
+
+    CHECK(registry.GetUpdateCount(counter) == 0);
+    CHECK(registry.GetLastUpdate(counter) == 0);
+
+    registry.SetCounter(counter, 100, 1000);
+    CHECK(registry.GetCounter(counter) == 100);
+    CHECK(registry.GetCounterDelta(counter) == 100);
+
+    registry.SetCounter(counter, 130, 2000);
+    registry.AddCounter(counter, 5, 3000);
+    CHECK(registry.GetCounter(counter) == 135);
+    CHECK(registry.GetCounterDelta(counter) == 5);
+    CHECK(registry.GetUpdateCount(counter) == 3);
+    CHECK(registry.GetLastUpdate(counter) == 3000);
+
+    registry.SetGauge(gauge, 2.5, 4000);
+    CHECK(registry.GetGauge(gauge) == 2.5);
+
+    /* Wrong kinds are ignored and read as 0 */
+    registry.SetGauge(counter, 1.0, 5000);
+    registry.SetCounter(gauge, 1, 5000);
+    CHECK(registry.GetCounter(counter) == 135);
+    CHECK(registry.GetGauge(gauge) == 2.5);
+    CHECK(registry.GetCounter(gauge) == 0);
+    CHECK(registry.GetBuckets(counter) == nullptr);
+    CHECK(registry.GetCounter(InvalidMetricHandle) == 0);
+    CHECK(registry.GetUpdateCount(InvalidMetricHandle) == 0);
+
+    registry.Reset();
+    CHECK(registry.GetCounter(counter) == 0);
+    CHECK(registry.GetUpdateCount(gauge) == 0);
+    CHECK(registry.Find("exec-time") == counter);
+}
+
+TEST_CASE("MetricRegistry: Histograms")
+{
+    MetricRegistry registry;
+
+    MetricHandle const histogram = registry.RegisterHistogram("latency", { 2.0, 4.0, 8.0 });
+    REQUIRE(histogram != InvalidMetricHandle);
+    REQUIRE(registry.GetBucketCount(histogram) == 4);
+
+    for (double const value : { 0.0, 1.9, 2.0, 3.0, 7.99, 8.0, 1000.0 })
+    {
+        registry.Observe(histogram, value, 100);
+    }
+
+    long long const *buckets = registry.GetBuckets(histogram);
+    CHECK(buckets[0] == 2);
+    CHECK(buckets[1] == 2);
+    CHECK(buckets[2] == 1);
+    CHECK(buckets[3] == 2);
+    CHECK(registry.GetUpdateCount(histogram) == 7);
+
+    long long const counts[] = { 5, 6, 7, 8 };
+    registry.SetBuckets(histogram, counts, 200);
+    CHECK(registry.GetBuckets(histogram)[2] == 7);
+    CHECK(registry.GetLastUpdate(histogram) == 200);
+
+    /* Buckets of different histograms don't overlap */
+    MetricHandle const other = registry.RegisterHistogram("latency", { 2.0, 4.0, 8.0 }, MetricScope::Gpu, 3);
+    registry.Observe(other, 3.0, 300);
+    CHECK(registry.GetBuckets(other)[1] == 1);
+    CHECK(registry.GetBuckets(histogram)[1] == 6);
+
+    /* Re-registering with other bounds is refused */
+    CHECK(registry.RegisterHistogram("latency", { 1.0 }) == InvalidMetricHandle);
+}
+
+TEST_CASE("MetricRegistry: Aggregation by handle")
+{
+    MetricRegistry registry;
+    std::vector<MetricHandle> counters;
+    std::vector<MetricHandle> gauges;
+    std::vector<MetricHandle> histograms;
+
+    for (unsigned int gpuId = 0; gpuId < 4; gpuId++)
+    {
+        counters.push_back(registry.RegisterCounter("fetches", MetricScope::Gpu, gpuId));
+        gauges.push_back(registry.RegisterGauge("bytes", MetricScope::Gpu, gpuId));
+        histograms.push_back(registry.RegisterHistogram("latency", { 10.0 }, MetricScope::Gpu, gpuId));
+
+        registry.SetCounter(counters.back(), gpuId + 1, 1);
+        registry.SetGauge(gauges.back(), 0.5 * gpuId, 1);
+        registry.Observe(histograms.back(), gpuId * 5.0, 1);
+    }
+
+    CHECK(registry.SumCounters(counters.data(), counters.size()) == 10);
+    CHECK(registry.SumGauges(gauges.data(), gauges.size()) == 3.0);
+    /* Wrong kinds count as 0 */
+    CHECK(registry.SumCounters(gauges.data(), gauges.size()) == 0);
+
+    long long buckets[2] = { 0, 0 };
+    registry.SumBuckets(histograms.data(), histograms.size(), buckets);
+    CHECK(buckets[0] == 2);
+    CHECK(buckets[1] == 2);
+}
+
+TEST_CASE("MetricRegistry: JSON matches DcgmStatCollection")
+{
+    MetricRegistry registry;
+    DcgmStatCollection collection;
+
+    MetricHandle const counter = registry.RegisterCounter("count");
+    MetricHandle const gauge   = registry.RegisterGauge("ratio", MetricScope::Gpu, 1);
+
+    registry.SetCounter(counter, 3, 1000);
+    registry.SetCounter(counter, 4, 2000);
+    registry.SetGauge(gauge, 0.25, 3000);
+
+    collection.AppendGlobalStat("count", 3LL, 1000);
+    collection.AppendGlobalStat("count", 4LL, 2000);
+    collection.AppendEntityStat(SC_ENTITY_GROUP_GPU, 1, "ratio", 0.25, 0.0, 3000);
+
+    CHECK(registry.ToJson() == collection.ToJson());
+
+    MetricHandle const histogram = registry.RegisterHistogram("latency", { 1.0 });
+    registry.Observe(histogram, 5.0, 4000);
+    CHECK(registry.ToJson().find("\"latency\":[{\"timestamp\":4000,\"value\":[0,1]}]") != std::string::npos);
+
+    /* Metrics that were never recorded are left out, like keys that were never appended */
+    registry.RegisterGauge("unused");
+    CHECK(registry.ToJson().find("unused") == std::string::npos);
+}
+
+/* Record the stats of an introspection update loop both ways. Hidden from the default run.
+   Use: commontests "[benchmark]" */
+TEST_CASE("MetricRegistry: Benchmark recording against DcgmStatCollection", "[.][benchmark]")
+{
+    using Clock               = std::chrono::steady_clock;
+    constexpr int numStats    = 1000;
+    constexpr int repetitions = 200;
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < numStats; i++)
+    {
+        keys.push_back(":field:DCGM_FI_DEV_FIELD_" + std::to_string(i) + ":total-exec-time");
+    }
+
+    DcgmStatCollection collection(false);
+    auto start = Clock::now();
+    for (int r = 0; r < repetitions; r++)
+    {
+        for (int i = 0; i < numStats; i++)
+        {
+            collection.AppendGlobalStat(keys[i], (long long)r, r + 1);
+            collection.EnforceGlobalStatQuota(keys[i], 0, 2);
+        }
+    }
+    double const collectionNs
+        = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ((double)numStats * repetitions);
+
+    /* The introspection module finds handles by an integer key, so include that lookup */
+    MetricRegistry registry;
+    std::vector<MetricHandle> handles;
+    std::unordered_map<std::uint64_t, MetricHandle> byKey;
+    for (int i = 0; i < numStats; i++)
+    {
+        handles.push_back(registry.RegisterCounter(keys[i]));
+        byKey.emplace((std::uint64_t)i << 32, handles.back());
+    }
+    start = Clock::now();
+    for (int r = 0; r < repetitions; r++)
+    {
+        for (int i = 0; i < numStats; i++)
+        {
+            registry.SetCounter(byKey.find((std::uint64_t)i << 32)->second, r, r + 1);
+        }
+    }
+    double const registryNs
+        = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ((double)numStats * repetitions);
+
+    CHECK(registry.SumCounters(handles.data(), handles.size()) == (long long)numStats * (repetitions - 1));
+    WARN("ns/stat DcgmStatCollection vs MetricRegistry: " << collectionNs << " vs " << registryNs);
+}
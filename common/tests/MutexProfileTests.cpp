@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <DcgmMutex.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+namespace
+{
+DcgmMutexSiteProfile const *FindSite(std::vector<DcgmMutexSiteProfile> const &profile, int line)
+{
+    for (auto const &site : profile)
+    {
+        if (site.line == line && std::string(site.file) == __FILE__)
+        {
+            return &site;
+        }
+    }
+    return nullptr;
+}
+
+long long BucketTotal(DcgmMutexTimeStats const &stats)
+{
+    long long total = 0;
+    for (auto const bucket : stats.buckets)
+    {
+        total += bucket;
+    }
+    return total;
+}
+} // namespace
+
+TEST_CASE("DcgmMutex: profiles waits and holds per call site")
+{
+    DcgmMutex mutex(0);
+
+    /* Nothing is recorded while profiling is off */
+    DcgmMutex::ResetProfile();
+    DcgmMutex::EnableProfiling(false);
+    int const offLine = __LINE__ + 1;
+    mutex.Lock(0, __FILE__, offLine);
+    mutex.Unlock(__FILE__, __LINE__);
+    CHECK(FindSite(DcgmMutex::GetProfile(), offLine) == nullptr);
+
+    DcgmMutex::EnableProfiling(true);
+
+    /* The holder keeps the mutex for 20ms after another thread starts waiting for it. Waiting on the thread
+       rather than only sleeping means a slow thread start doesn't shorten its wait */
+    int const holdLine = __LINE__ + 1;
+    mutex.Lock(0, __FILE__, holdLine);
+    int waitLine = 0;
+    std::promise<void> locking;
+    std::future<void> waiterLocking = locking.get_future();
+    std::thread waiter([&mutex, &waitLine, &locking] {
+        waitLine = __LINE__ + 2;
+        locking.set_value();
+        mutex.Lock(0, __FILE__, waitLine);
+        mutex.Unlock(__FILE__, __LINE__);
+    });
+    REQUIRE(waiterLocking.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mutex.Unlock(__FILE__, __LINE__);
+    waiter.join();
+
+    {
+        DcgmLockGuard guard(&mutex);
+    }
+    int const guardLine = __LINE__ - 2;
+
+    DcgmMutex::EnableProfiling(false);
+    std::vector<DcgmMutexSiteProfile> profile = DcgmMutex::GetProfile();
+
+    DcgmMutexSiteProfile const *holder = FindSite(profile, holdLine);
+    REQUIRE(holder != nullptr);
+    CHECK(holder->hold.count == 1);
+    CHECK(holder->hold.maxNs >= 20000000);
+    CHECK(BucketTotal(holder->hold) == 1);
+
+    DcgmMutexSiteProfile const *waiterSite = FindSite(profile, waitLine);
+    REQUIRE(waiterSite != nullptr);
+    CHECK(waiterSite->wait.count == 1);
+    CHECK(waiterSite->wait.totalNs >= 10000000);
+    CHECK(waiterSite->hold.count == 1);
+
+    /* Guards are profiled where they are, not inside DcgmMutex.h */
+    DcgmMutexSiteProfile const *guardSite = FindSite(profile, guardLine);
+    REQUIRE(guardSite != nullptr);
+    CHECK(guardSite->wait.count == 1);
+
+    std::string const json = DcgmMutex::ProfileToJson(profile);
+    CHECK(json.find("\"line\":" + std::to_string(holdLine)) != std::string::npos);
+
+    DcgmMutex::ResetProfile();
+    CHECK(FindSite(DcgmMutex::GetProfile(), holdLine) == nullptr);
+}
+
+TEST_CASE("DcgmMutex: CondWait ends the hold while waiting")
+{
+    DcgmMutex mutex(0);
+    std::condition_variable cv;
+
+    DcgmMutex::ResetProfile();
+    DcgmMutex::EnableProfiling(true);
+
+    int const lockLine = __LINE__ + 1;
+    mutex.Lock(0, __FILE__, lockLine);
+    mutex.CondWait(cv, 30, [] { return false; });
+    mutex.Unlock(__FILE__, __LINE__);
+
+    DcgmMutex::EnableProfiling(false);
+
+    std::vector<DcgmMutexSiteProfile> profile = DcgmMutex::GetProfile();
+    DcgmMutexSiteProfile const *site          = FindSite(profile, lockLine);
+    REQUIRE(site != nullptr);
+    /* One hold before the wait and one after it. Neither includes the 30ms wait */
+    CHECK(site->hold.count == 2);
+    CHECK(site->hold.totalNs < 30000000);
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmNumberFormat.h>
+#include <dcgm_structs.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+
+using namespace DcgmNs;
+
+TEST_CASE("NumberFormat: Integers")
+{
+    CHECK(Int64ToString(0) == "0");
+    CHECK(Int64ToString(-42) == "-42");
+    CHECK(Int64ToString(std::numeric_limits<long long>::min()) == "-9223372036854775808");
+    CHECK(Int64ToString(std::numeric_limits<long long>::max()) == "9223372036854775807");
+
+    char small[4];
+    CHECK(FormatInt64(small, small + sizeof(small), 12345) == nullptr);
+
+    std::string out = "x=";
+    AppendInt64(out, 7);
+    CHECK(out == "x=7");
+}
+
+TEST_CASE("NumberFormat: Doubles round-trip")
+{
+    CHECK(DoubleToString(0.1) == "0.1");
+    CHECK(DoubleToString(123.25) == "123.25");
+    CHECK(DoubleToString(-2.5) == "-2.5");
+    CHECK(DoubleToString(100000.0) == "100000");
+    CHECK(DoubleToString(std::numeric_limits<double>::infinity()) == "inf");
+    CHECK(DoubleToString(-std::numeric_limits<double>::infinity()) == "-inf");
+    CHECK(DoubleToString(std::nan("")).find("nan") != std::string::npos);
+
+    double const values[] = { 0.1 + 0.2, 1.0 / 3.0, 6.02214076e23, 1.6e-19, DCGM_FP64_BLANK, 5e-324,
+                              std::numeric_limits<double>::max() };
+    for (double const value : values)
+    {
+        std::string const formatted = DoubleToString(value);
+        CHECK(formatted.size() <= MaxFormattedNumberLength);
+
+        double parsed = 0;
+        REQUIRE(ParseDouble(formatted, parsed));
+        CHECK(parsed == value);
+    }
+
+    std::string out;
+    AppendDoubleFixed(out, 2.0 / 3.0, 3);
+    CHECK(out == "0.667");
+    out.clear();
+    AppendDoubleFixed(out, 1e300, 1);
+    CHECK(out.size() == 303);
+    CHECK(out.substr(0, 2) == "10");
+}
+
+TEST_CASE("NumberFormat: Parsing")
+{
+    long long i64 = 5;
+    CHECK(ParseInt64("-123", i64));
+    CHECK(i64 == -123);
+    CHECK(ParseInt64("+9223372036854775807", i64));
+    CHECK(i64 == std::numeric_limits<long long>::max());
+
+    i64 = 5;
+    CHECK_FALSE(ParseInt64("", i64));
+    CHECK_FALSE(ParseInt64("+", i64));
+    CHECK_FALSE(ParseInt64("+-1", i64));
+    CHECK_FALSE(ParseInt64(" 1", i64));
+    CHECK_FALSE(ParseInt64("1x", i64));
+    CHECK_FALSE(ParseInt64("9223372036854775808", i64));
+    CHECK(i64 == 5);
+
+    double dbl = 5;
+    CHECK(ParseDouble("1.5e3", dbl));
+    CHECK(dbl == 1500.0);
+    CHECK(ParseDouble("+.5", dbl));
+    CHECK(dbl == 0.5);
+    CHECK(ParseDouble("-0", dbl));
+    CHECK(dbl == 0.0);
+
+    dbl = 5;
+    CHECK_FALSE(ParseDouble("", dbl));
+    CHECK_FALSE(ParseDouble("abc", dbl));
+    CHECK_FALSE(ParseDouble("1.5 ", dbl));
+    CHECK_FALSE(ParseDouble(" 1.5", dbl));
+    CHECK_FALSE(ParseDouble("0x10", dbl));
+    CHECK_FALSE(ParseDouble("1e999", dbl));
+    CHECK(dbl == 5);
+
+    /* Not NUL-terminated */
+    std::string_view const view = std::string_view("12345").substr(0, 2);
+    CHECK(ParseInt64(view, i64));
+    CHECK(i64 == 12);
+    CHECK(ParseDouble(view, dbl));
+    CHECK(dbl == 12.0);
+}
+
+TEST_CASE("NumberFormat: Blank values")
+{
+    CHECK(BlankValueName(0) == nullptr);
+    CHECK(BlankValueName(42LL) == nullptr);
+    CHECK(BlankValueName(1.5) == nullptr);
+
+    CHECK(std::string(BlankValueName(DCGM_INT32_BLANK)) == "Not Specified");
+    CHECK(std::string(BlankValueName((long long)DCGM_INT64_NOT_FOUND)) == "Not Found");
+    CHECK(std::string(BlankValueName(DCGM_FP64_NOT_SUPPORTED)) == "Not Supported");
+    CHECK(std::string(BlankValueName((long long)DCGM_INT64_NOT_PERMISSIONED)) == "Insf. Permission");
+    CHECK(std::string(BlankValueName(DCGM_INT32_BLANK + 10)) == "Unknown");
+}
+
+/* Against the stream and snprintf conversions the output paths used before.
+   Hidden from the default run. Use: commontests "[benchmark]" */
+TEST_CASE("NumberFormat: Benchmark against streams and snprintf", "[.][benchmark]")
+{
+    using Clock             = std::chrono::steady_clock;
+    constexpr int numValues = 1000000;
+
+    auto measure = [](auto convert) {
+        std::size_t totalLength = 0;
+        auto start              = Clock::now();
+        for (int i = 0; i < numValues; i++)
+        {
+            totalLength += convert(i * 1.37 + 0.001).size();
+        }
+        auto elapsed = Clock::now() - start;
+        CHECK(totalLength > 0);
+        return std::chrono::duration<double, std::nano>(elapsed).count() / numValues;
+    };
+
+    double const streamNs = measure([](double value) {
+        std::stringstream ss;
+        ss.precision(17);
+        ss << value;
+        return ss.str();
+    });
+    double const snprintfNs = measure([](double value) {
+        char buffer[32];
+        int const length = snprintf(buffer, sizeof(buffer), "%.17g", value);
+        return std::string(buffer, length);
+    });
+    double const toCharsNs = measure([](double value) { return DoubleToString(value); });
+
+    double const int64StreamNs = measure([](double value) {
+        std::stringstream ss;
+        ss << (long long)(value * 1000);
+        return ss.str();
+    });
+    double const int64ToCharsNs = measure([](double value) { return Int64ToString((long long)(value * 1000)); });
+
+    WARN("ns/double stringstream vs snprintf vs DoubleToString: " << streamNs << " vs " << snprintfNs << " vs "
+                                                                 << toCharsNs);
+    WARN("ns/int64 stringstream vs Int64ToString: " << int64StreamNs << " vs " << int64ToCharsNs);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmSampleRing.h>
+
+#include <vector>
+
+TEST_CASE("SampleRing: drain keeps each sample and its timestamp")
+{
+    DcgmSampleRing ring(16, 1000000);
+
+    for (int i = 0; i < 5; i++)
+    {
+        ring.AddDouble(DCGM_FE_GPU, 0, DCGM_FI_PROF_SM_ACTIVE, i * 0.1, 1000 + i * 20000);
+        ring.AddInt64(DCGM_FE_GPU, 1, DCGM_FI_PROF_PCIE_TX_BYTES, i * 100, 1000 + i * 20000);
+    }
+    CHECK(ring.Size() == 10);
+
+    DcgmFvBuffer fvBuffer;
+    REQUIRE(ring.Drain(fvBuffer, 100000) == 10);
+    CHECK(ring.Size() == 0);
+
+    std::vector<long long> smActiveTimestamps;
+    std::vector<long long> pcieTxValues;
+    for (dcgmBufferedFv_t const &fv : fvBuffer)
+    {
+        CHECK(fv.status == DCGM_ST_OK);
+        if (fv.fieldId == DCGM_FI_PROF_SM_ACTIVE)
+        {
+            CHECK(fv.fieldType == DCGM_FT_DOUBLE);
+            CHECK(fv.entityId == 0);
+            CHECK(fv.value.dbl == Approx((fv.timestamp - 1000) / 20000 * 0.1));
+            smActiveTimestamps.push_back(fv.timestamp);
+        }
+        else
+        {
+            CHECK(fv.fieldType == DCGM_FT_INT64);
+            CHECK(fv.entityGroupId == DCGM_FE_GPU);
+            CHECK(fv.entityId == 1);
+            pcieTxValues.push_back(fv.value.i64);
+        }
+    }
+    CHECK(smActiveTimestamps == std::vector<long long> { 1000, 21000, 41000, 61000, 81000 });
+    CHECK(pcieTxValues == std::vector<long long> { 0, 100, 200, 300, 400 });
+}
+
+TEST_CASE("SampleRing: flush interval")
+{
+    DcgmSampleRing ring(16, 100000);
+
+    /* Nothing to flush */
+    CHECK(!ring.IsFlushDue(1000000));
+
+    ring.AddInt64(DCGM_FE_GPU, 0, DCGM_FI_PROF_SM_ACTIVE, 1, 1000000);
+    CHECK(ring.IsFlushDue(1000000));
+
+    DcgmFvBuffer fvBuffer;
+    REQUIRE(ring.Drain(fvBuffer, 1000000) == 1);
+
+    ring.AddInt64(DCGM_FE_GPU, 0, DCGM_FI_PROF_SM_ACTIVE, 2, 1050000);
+    CHECK(!ring.IsFlushDue(1050000));
+    CHECK(ring.IsFlushDue(1100000));
+
+    ring.SetFlushInterval(200000);
+    CHECK(!ring.IsFlushDue(1100000));
+    CHECK(ring.IsFlushDue(1200000));
+}
+
+TEST_CASE("SampleRing: overwrite the oldest samples when full")
+{
+    DcgmSampleRing ring(4, 1000000);
+
+    for (long long i = 0; i < 10; i++)
+    {
+        ring.AddInt64(DCGM_FE_GPU, 0, DCGM_FI_PROF_SM_ACTIVE, i, i);
+    }
+    CHECK(ring.Size() == 4);
+    CHECK(ring.GetNumDropped() == 6);
+
+    DcgmFvBuffer fvBuffer;
+    REQUIRE(ring.Drain(fvBuffer, 10) == 4);
+
+    std::vector<long long> values;
+    for (dcgmBufferedFv_t const &fv : fvBuffer)
+    {
+        values.push_back(fv.value.i64);
+    }
+    CHECK(values == std::vector<long long> { 6, 7, 8, 9 });
+
+    /* The ring starts over after a drain */
+    ring.AddInt64(DCGM_FE_GPU, 0, DCGM_FI_PROF_SM_ACTIVE, 10, 10);
+    DcgmFvBuffer nextBuffer;
+    REQUIRE(ring.Drain(nextBuffer, 20) == 1);
+    CHECK(ring.GetNumDropped() == 6);
+}
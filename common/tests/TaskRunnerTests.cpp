@@ -21,6 +21,7 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <future>
 #include <string>
 #include <thread>
 #include <unordered_set>
@@ -220,3 +221,193 @@ TEST_CASE("TaskRunner: Multiple runners", "[!mayfail]")
     REQUIRE(seenIds.size() > 1);
     CHECK(seenIds.size() == 10);
 }
+
+TEST_CASE("TaskRunner: Lock-free queue")
+{
+    TaskRunner tr(TaskQueueKind::LockFree);
+    std::atomic_bool stop { false };
+    std::thread runner([&tr, &stop] {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            if (tr.Run() != TaskRunner::RunResult::Ok)
+            {
+                break;
+            }
+        }
+    });
+
+    std::vector<std::shared_future<int>> futures;
+    for (int i = 0; i < 10000; ++i)
+    {
+        futures.push_back(tr.Enqueue(make_task([i] { return i; })));
+    }
+    for (int i = 0; i < 10000; ++i)
+    {
+        REQUIRE(futures[i].get() == i);
+    }
+
+    tr.Stop();
+    stop.store(true, std::memory_order_relaxed);
+    runner.join();
+}
+
+TEST_CASE("TaskRunner: Lock-free queue deferred")
+{
+    TaskRunner lockFree(TaskQueueKind::LockFree);
+    int runs = 0;
+
+    auto fut = lockFree.Enqueue(make_task([&runs]() mutable -> std::optional<int> {
+        if (++runs == 1)
+        {
+            return std::nullopt;
+        }
+        return 10;
+    }));
+
+    REQUIRE(lockFree.Run(true) == TaskRunner::RunResult::Ok);
+    REQUIRE(runs == 1);
+    REQUIRE(fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready);
+
+    /* The deferred task doesn't wake the runner, but it is retried along with the next task */
+    auto other = lockFree.Enqueue(make_task([] { return 1; }));
+    REQUIRE(lockFree.Run(true) == TaskRunner::RunResult::Ok);
+    REQUIRE(other.get() == 1);
+    REQUIRE(fut.get() == 10);
+}
+
+TEST_CASE("TaskRunner: Timers")
+{
+    using namespace std::chrono_literals;
+    using Clock = std::chrono::steady_clock;
+
+    for (auto queueKind : { TaskQueueKind::Locked, TaskQueueKind::LockFree })
+    {
+        /* The run interval is much longer than the timers, so they are only on time if the runner wakes up for them */
+        TaskRunner tr(queueKind);
+        std::thread runner([&tr] {
+            while (tr.Run() == TaskRunner::RunResult::Ok)
+            {}
+        });
+
+        std::promise<Clock::time_point> oneShot;
+        auto oneShotRan = oneShot.get_future();
+        auto start      = Clock::now();
+        TimerId const oneShotId
+            = tr.EnqueueAt(start + 50ms, [&oneShot]() mutable { oneShot.set_value(Clock::now()); });
+
+        std::atomic_int ticks { 0 };
+        TimerId const everyId = tr.EnqueueEvery(10ms, [&ticks] { ticks++; });
+        CHECK(everyId != oneShotId);
+
+        bool cancelledRan = false;
+        TimerId const cancelledId = tr.EnqueueAt(start + 20ms, [&cancelledRan] { cancelledRan = true; });
+        CHECK(tr.CancelTimer(cancelledId));
+        CHECK_FALSE(tr.CancelTimer(cancelledId));
+
+        REQUIRE(oneShotRan.wait_for(10s) == std::future_status::ready);
+        CHECK(oneShotRan.get() >= start + 50ms);
+        CHECK_FALSE(tr.CancelTimer(oneShotId));
+
+        auto const deadline = Clock::now() + 10s;
+        while (ticks < 5 && Clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE(ticks >= 5);
+        CHECK(tr.CancelTimer(everyId));
+        int const ticksAtCancel = ticks;
+
+        /* Timers run in deadline order, so the periodic timer would tick twice before this one if it still ran */
+        std::promise<void> marker;
+        auto markerRan                 = marker.get_future();
+        [[maybe_unused]] auto markerId = tr.EnqueueAt(Clock::now() + 30ms, [&marker] { marker.set_value(); });
+        REQUIRE(markerRan.wait_for(10s) == std::future_status::ready);
+        CHECK(ticks <= ticksAtCancel + 1);
+        CHECK_FALSE(cancelledRan);
+
+        TimerStats const stats = tr.GetTimerStats();
+        CHECK(stats.runs >= 6);
+        CHECK(stats.maxLatenessUsec * stats.runs >= stats.totalLatenessUsec);
+
+        tr.Stop();
+        runner.join();
+    }
+}
+
+TEST_CASE("TaskRunner: Late periodic timers skip missed periods")
+{
+    using namespace std::chrono_literals;
+    TaskRunner tr;
+
+    int ticks = 0;
+    [[maybe_unused]] auto everyId = tr.EnqueueEvery(10ms, [&ticks] { ticks++; });
+    auto blocker = tr.Enqueue(make_task([] { std::this_thread::sleep_for(55ms); }));
+
+    /* The task holds the runner past five deadlines, which then make only one run */
+    REQUIRE(tr.Run(true) == TaskRunner::RunResult::Ok);
+    blocker.get();
+    while (ticks == 0)
+    {
+        REQUIRE(tr.Run(true) == TaskRunner::RunResult::Ok);
+    }
+
+    CHECK(ticks == 1);
+    TimerStats const stats = tr.GetTimerStats();
+    CHECK(stats.runs == 1);
+    CHECK(stats.missedPeriods >= 4);
+    CHECK(stats.maxLatenessUsec >= 40000);
+}
+
+/* Enqueue and run throughput of both queue kinds with several producers and one runner.
+   Hidden from the default run. Use: commontests "[benchmark]" */
+TEST_CASE("TaskRunner: Benchmark queue kinds", "[.][benchmark]")
+{
+    using Clock                  = std::chrono::steady_clock;
+    constexpr int numProducers   = 4;
+    constexpr int tasksPerThread = 100000;
+
+    auto measure = [](TaskQueueKind queueKind) {
+        TaskRunner tr(queueKind);
+        std::atomic_int done { 0 };
+        std::thread runner([&tr] {
+            while (tr.Run() == TaskRunner::RunResult::Ok)
+            {}
+        });
+
+        auto start = Clock::now();
+        std::vector<std::thread> producers;
+        for (int p = 0; p < numProducers; p++)
+        {
+            producers.emplace_back([&tr, &done] {
+                for (int i = 0; i < tasksPerThread; i++)
+                {
+                    [[maybe_unused]] auto discard
+                        = tr.Enqueue(make_task([&done] { done.fetch_add(1, std::memory_order_relaxed); }));
+                }
+            });
+        }
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+        auto enqueued = Clock::now() - start;
+        while (done.load(std::memory_order_relaxed) < numProducers * tasksPerThread)
+        {
+            std::this_thread::yield();
+        }
+        auto ran = Clock::now() - start;
+
+        tr.Stop();
+        runner.join();
+        return std::make_pair(enqueued, ran);
+    };
+
+    auto perTask = [](Clock::duration elapsed) {
+        return std::chrono::duration<double, std::nano>(elapsed).count() / (numProducers * tasksPerThread);
+    };
+    auto locked   = measure(TaskQueueKind::Locked);
+    auto lockFree = measure(TaskQueueKind::LockFree);
+    WARN("Producers: " << numProducers << ". ns/task locked vs lock-free: enqueue " << perTask(locked.first)
+                       << " vs " << perTask(lockFree.first) << ", enqueue and run " << perTask(locked.second)
+                       << " vs " << perTask(lockFree.second));
+}
@@ -0,0 +1,940 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dcgm_structs.h>
+#include <timeseries.h>
+#include <vector>
+
+TEST_CASE("TimeSeries: ring append, iterate and find")
+{
+    int errorSt     = 0;
+    timeseries_p ts = timeseries_alloc_ring(TS_TYPE_INT64, 3, &errorSt);
+    REQUIRE(ts != nullptr);
+    REQUIRE(errorSt == TS_ST_OK);
+    REQUIRE(ts->storage == TS_STORAGE_RING);
+    REQUIRE(ts->ring->capacity == 4); /* Rounded up to a power of 2 */
+
+    /* Append past the initial capacity to force a grow */
+    for (long long i = 1; i <= 10; i++)
+    {
+        REQUIRE(timeseries_insert_int64(ts, i * 10, i, 0) == TS_ST_OK);
+    }
+    REQUIRE(timeseries_size(ts) == 10);
+    REQUIRE(ts->ring->capacity == 16);
+    REQUIRE(ts->ring->val2 == nullptr); /* Never stored a non-zero val2 */
+
+    timeseries_cursor_t cursor;
+    long long expected = 1;
+    for (timeseries_entry_p entry = timeseries_first(ts, &cursor); entry; entry = timeseries_next(ts, &cursor))
+    {
+        REQUIRE(entry->usecSince1970 == expected * 10);
+        REQUIRE(entry->val.i64 == expected);
+        REQUIRE(entry->val2.i64 == 0);
+        expected++;
+    }
+    REQUIRE(expected == 11);
+
+    timeseries_entry_p entry = timeseries_find(ts, 45, TS_LGE_GREATEQUAL, &cursor);
+    REQUIRE(entry != nullptr);
+    REQUIRE(entry->usecSince1970 == 50);
+    entry = timeseries_prev(ts, &cursor);
+    REQUIRE(entry != nullptr);
+    REQUIRE(entry->usecSince1970 == 40);
+
+    REQUIRE(timeseries_find(ts, 45, TS_LGE_LESSEQUAL, nullptr)->usecSince1970 == 40);
+    REQUIRE(timeseries_find(ts, 40, TS_LGE_LESS, nullptr)->usecSince1970 == 30);
+    REQUIRE(timeseries_find(ts, 40, TS_LGE_GREATER, nullptr)->usecSince1970 == 50);
+    REQUIRE(timeseries_find(ts, 40, TS_LGE_EQUAL, nullptr)->usecSince1970 == 40);
+    REQUIRE(timeseries_find(ts, 45, TS_LGE_EQUAL, nullptr) == nullptr);
+    REQUIRE(timeseries_find(ts, 101, TS_LGE_GREATEQUAL, nullptr) == nullptr);
+    REQUIRE(timeseries_find(ts, 10, TS_LGE_LESS, nullptr) == nullptr);
+    REQUIRE(timeseries_last(ts, nullptr)->val.i64 == 10);
+
+    int calcSt = TS_ST_OK;
+    REQUIRE(timeseries_sum_int64(ts, 0, 0, &calcSt) == 55);
+    REQUIRE(timeseries_min_int64(ts, 20, 50, &calcSt) == 2);
+    REQUIRE(timeseries_max_int64(ts, 20, 50, &calcSt) == 5);
+    REQUIRE(calcSt == TS_ST_OK);
+
+    timeseries_destroy(ts);
+}
+
+TEST_CASE("TimeSeries: ring out of order and duplicate timestamps")
+{
+    int errorSt     = 0;
+    timeseries_p ts = timeseries_alloc_ring(TS_TYPE_DOUBLE, 16, &errorSt);
+    REQUIRE(ts != nullptr);
+
+    REQUIRE(timeseries_insert_double(ts, 100, 1.0, 0.0) == TS_ST_OK);
+    REQUIRE(timeseries_insert_double(ts, 300, 3.0, 0.0) == TS_ST_OK);
+    REQUIRE(timeseries_insert_double(ts, 200, 2.0, 0.5) == TS_ST_OK); /* Out of order */
+    REQUIRE(timeseries_insert_double(ts, 300, 4.0, 0.0) == TS_ST_OK); /* Duplicate is bumped to 301 */
+    REQUIRE(ts->ring->val2 != nullptr);
+
+    timeseries_cursor_t cursor;
+    timelib64_t expectedTimes[] = { 100, 200, 300, 301 };
+    double expectedVals[]       = { 1.0, 2.0, 3.0, 4.0 };
+    int i                       = 0;
+    for (timeseries_entry_p entry = timeseries_first(ts, &cursor); entry; entry = timeseries_next(ts, &cursor), i++)
+    {
+        REQUIRE(i < 4);
+        REQUIRE(entry->usecSince1970 == expectedTimes[i]);
+        REQUIRE(entry->val.dbl == expectedVals[i]);
+        REQUIRE(entry->val2.dbl == (i == 1 ? 0.5 : 0.0));
+    }
+    REQUIRE(i == 4);
+
+    /* Coercion from int64 still works */
+    REQUIRE(timeseries_insert_int64_coerce(ts, 400, 5, 0) == TS_ST_OK);
+    REQUIRE(timeseries_last(ts, nullptr)->val.dbl == 5.0);
+
+    timeseries_destroy(ts);
+}
+
+TEST_CASE("TimeSeries: ring quota enforcement")
+{
+    int errorSt     = 0;
+    timeseries_p ts = timeseries_alloc_ring(TS_TYPE_INT64, 8, &errorSt);
+    REQUIRE(ts != nullptr);
+
+    /* Wrap around the ring a few times while keeping at most 5 samples */
+    for (long long i = 1; i <= 30; i++)
+    {
+        REQUIRE(timeseries_insert_int64(ts, i, i, 0) == TS_ST_OK);
+        REQUIRE(timeseries_enforce_quota(ts, i - 4, 0) == TS_ST_OK);
+        REQUIRE(timeseries_size(ts) == (i < 5 ? i : 5));
+    }
+    REQUIRE(ts->ring->capacity == 8); /* Never needed to grow */
+    REQUIRE(timeseries_first(ts, nullptr)->usecSince1970 == 26);
+    REQUIRE(timeseries_last(ts, nullptr)->usecSince1970 == 30);
+
+    REQUIRE(timeseries_enforce_quota(ts, 0, 2) == TS_ST_OK);
+    REQUIRE(timeseries_size(ts) == 2);
+    REQUIRE(timeseries_first(ts, nullptr)->usecSince1970 == 29);
+
+    int calcSt = TS_ST_OK;
+    REQUIRE(timeseries_average(ts, 0, 0, &calcSt) == 29.5);
+
+    REQUIRE(timeseries_enforce_quota(ts, 1000, 0) == TS_ST_OK);
+    REQUIRE(timeseries_size(ts) == 0);
+    REQUIRE(timeseries_first(ts, nullptr) == nullptr);
+
+    timeseries_destroy(ts);
+}
+
+TEST_CASE("TimeSeries: ring shrink")
+{
+    int errorSt     = 0;
+    timeseries_p ts = timeseries_alloc_ring(TS_TYPE_INT64, 4096, &errorSt);
+    REQUIRE(ts != nullptr);
+
+    /* Wrapped so that the kept samples straddle the end of the columns */
+    for (long long i = 1; i <= 5000; i++)
+    {
+        REQUIRE(timeseries_insert_int64(ts, i, i, 0) == TS_ST_OK);
+        REQUIRE(timeseries_enforce_quota(ts, i - 4000, 0) == TS_ST_OK);
+    }
+    long long bytesBefore = timeseries_bytes_used(ts);
+
+    REQUIRE(timeseries_enforce_quota(ts, 0, 20) == TS_ST_OK);
+    REQUIRE(timeseries_shrink(ts, 16) == TS_ST_OK);
+    CHECK(ts->ring->capacity == 32);
+    CHECK(timeseries_bytes_used(ts) < bytesBefore);
+    REQUIRE(timeseries_size(ts) == 20);
+    CHECK(timeseries_first(ts, nullptr)->usecSince1970 == 4981);
+    CHECK(timeseries_last(ts, nullptr)->usecSince1970 == 5000);
+
+    /* Never below the samples kept and grows again as needed */
+    REQUIRE(timeseries_shrink(ts, 1) == TS_ST_OK);
+    CHECK(ts->ring->capacity == 32);
+    for (long long i = 5001; i <= 5100; i++)
+    {
+        REQUIRE(timeseries_insert_int64(ts, i, i, 0) == TS_ST_OK);
+    }
+    CHECK(timeseries_size(ts) == 120);
+    CHECK(timeseries_last(ts, nullptr)->val.i64 == 5100);
+
+    timeseries_destroy(ts);
+}
+
+TEST_CASE("TimeSeries: ring alloc parameter validation")
+{
+    int errorSt = 0;
+    REQUIRE(timeseries_alloc_ring(TS_TYPE_STRING, 16, &errorSt) == nullptr);
+    REQUIRE(errorSt == TS_ST_BADPARAM);
+    REQUIRE(timeseries_alloc_ring(TS_TYPE_INT64, 0, &errorSt) == nullptr);
+    REQUIRE(errorSt == TS_ST_BADPARAM);
+}
+
+TEST_CASE("TimeSeries: block codec round trip")
+{
+    timelib64_t times[TS_BLOCK_SAMPLES];
+    long long val[TS_BLOCK_SAMPLES];
+    long long val2[TS_BLOCK_SAMPLES];
+    timelib64_t outTimes[TS_BLOCK_SAMPLES];
+    long long outVal[TS_BLOCK_SAMPLES];
+    long long outVal2[TS_BLOCK_SAMPLES];
+
+    for (int i = 0; i < TS_BLOCK_SAMPLES; i++)
+    {
+        /* Mostly regular timestamps with some jitter, and values including the extremes */
+        times[i] = 1600000000000000LL + i * 1000000LL + (i % 7 == 0 ? 13 : 0);
+        val[i]   = (i % 3 == 0) ? LLONG_MIN + i : LLONG_MAX - i * 12345;
+        val2[i]  = (i == 5) ? -1 : 0;
+    }
+
+    for (int tsType : { TS_TYPE_INT64, TS_TYPE_DOUBLE })
+    {
+        timeseries_block_t block;
+        REQUIRE(tscompress_encode_block(tsType, times, val, val2, TS_BLOCK_SAMPLES, &block) == TS_ST_OK);
+        REQUIRE(block.hasVal2 == 1);
+        REQUIRE(block.firstUsec == times[0]);
+        REQUIRE(block.lastUsec == times[TS_BLOCK_SAMPLES - 1]);
+        REQUIRE(tscompress_decode_block(tsType, &block, outTimes, outVal, outVal2) == TS_ST_OK);
+        for (int i = 0; i < TS_BLOCK_SAMPLES; i++)
+        {
+            REQUIRE(outTimes[i] == times[i]);
+            REQUIRE(outVal[i] == val[i]);
+            REQUIRE(outVal2[i] == val2[i]);
+        }
+        tscompress_free_block(&block);
+    }
+}
+
+TEST_CASE("TimeSeries: compressed history matches uncompressed ring")
+{
+    int errorSt              = 0;
+    timeseries_p compressed  = timeseries_alloc_compressed(TS_TYPE_DOUBLE, &errorSt);
+    timeseries_p plain       = timeseries_alloc_ring(TS_TYPE_DOUBLE, 16, &errorSt);
+    const int numSamples     = 3600;
+    const timelib64_t keepUs = 30000;
+    REQUIRE(compressed != nullptr);
+    REQUIRE(plain != nullptr);
+
+    for (int i = 1; i <= numSamples; i++)
+    {
+        /* A value that changes occasionally, like a clock or power limit */
+        double value = (double)(100 + i / 500);
+        for (timeseries_p ts : { compressed, plain })
+        {
+            REQUIRE(timeseries_insert_double(ts, i * 10, value, 0.0) == TS_ST_OK);
+            REQUIRE(timeseries_enforce_quota(ts, i * 10 - keepUs, 0) == TS_ST_OK);
+        }
+    }
+
+    /* Out of order sample landing inside the sealed history */
+    for (timeseries_p ts : { compressed, plain })
+    {
+        REQUIRE(timeseries_insert_double(ts, 10005, 7.0, 1.5) == TS_ST_OK);
+    }
+
+    REQUIRE(compressed->compressed->numBlocks > 0);
+    REQUIRE(timeseries_size(compressed) == timeseries_size(plain));
+
+    timeseries_cursor_t cursorA, cursorB;
+    timeseries_entry_p a = timeseries_first(compressed, &cursorA);
+    timeseries_entry_p b = timeseries_first(plain, &cursorB);
+    for (; a && b; a = timeseries_next(compressed, &cursorA), b = timeseries_next(plain, &cursorB))
+    {
+        REQUIRE(a->usecSince1970 == b->usecSince1970);
+        REQUIRE(a->val.dbl == b->val.dbl);
+        REQUIRE(a->val2.dbl == b->val2.dbl);
+    }
+    REQUIRE(a == nullptr);
+    REQUIRE(b == nullptr);
+
+    /* Walking backward works across block boundaries too */
+    a = timeseries_find(compressed, 20005, TS_LGE_LESSEQUAL, &cursorA);
+    REQUIRE(a != nullptr);
+    REQUIRE(a->usecSince1970 == 20000);
+    a = timeseries_prev(compressed, &cursorA);
+    REQUIRE(a->usecSince1970 == 19990);
+    REQUIRE(timeseries_find(compressed, 10005, TS_LGE_EQUAL, nullptr)->val.dbl == 7.0);
+    REQUIRE(timeseries_find(compressed, 10005, TS_LGE_EQUAL, nullptr)->val2.dbl == 1.5);
+
+    int calcSt = TS_ST_OK;
+    REQUIRE(timeseries_sum_double(compressed, 7000, 30000, &calcSt)
+            == timeseries_sum_double(plain, 7000, 30000, &calcSt));
+    REQUIRE(calcSt == TS_ST_OK);
+
+    /* Count-based quota drops into the middle of a block */
+    for (timeseries_p ts : { compressed, plain })
+    {
+        REQUIRE(timeseries_enforce_quota(ts, 0, 1000) == TS_ST_OK);
+        REQUIRE(timeseries_size(ts) == 1000);
+    }
+    REQUIRE(timeseries_first(compressed, nullptr)->usecSince1970
+            == timeseries_first(plain, nullptr)->usecSince1970);
+
+    timeseries_destroy(compressed);
+    timeseries_destroy(plain);
+}
+
+TEST_CASE("TimeSeries: compressed history footprint")
+{
+    int errorSt             = 0;
+    timeseries_p compressed = timeseries_alloc_compressed(TS_TYPE_INT64, &errorSt);
+    timeseries_p plain      = timeseries_alloc_ring(TS_TYPE_INT64, 3600, &errorSt);
+    REQUIRE(compressed != nullptr);
+    REQUIRE(plain != nullptr);
+
+    /* An hour of 1 Hz samples of a rarely changing counter */
+    for (long long i = 0; i < 3600; i++)
+    {
+        timelib64_t timestamp = 1600000000000000LL + i * 1000000LL;
+        REQUIRE(timeseries_insert_int64(compressed, timestamp, 42 + i / 600, 0) == TS_ST_OK);
+        REQUIRE(timeseries_insert_int64(plain, timestamp, 42 + i / 600, 0) == TS_ST_OK);
+    }
+
+    /* The cache manager would size an uncompressed ring like plain for this watch */
+    REQUIRE(timeseries_bytes_used(compressed) * 10 < timeseries_bytes_used(plain));
+
+    timeseries_destroy(compressed);
+    timeseries_destroy(plain);
+}
+
+TEST_CASE("TimeSeries: string and blob values share slabs")
+{
+    int errorSt     = 0;
+    timeseries_p ts = timeseries_alloc(TS_TYPE_STRING, &errorSt);
+    REQUIRE(ts != nullptr);
+    REQUIRE(ts->arena != nullptr);
+
+    char value[32];
+    for (int i = 1; i <= 1000; i++)
+    {
+        snprintf(value, sizeof(value), "sample %d", i);
+        REQUIRE(timeseries_insert_string(ts, i, value) == TS_ST_OK);
+    }
+
+    /* Far fewer allocations than values */
+    int numSlabs        = ts->arena->numSlabs;
+    long long bytesUsed = timeseries_bytes_used(ts);
+    CHECK(numSlabs > 1);
+    CHECK(numSlabs < 20);
+    CHECK(ts->arena->slabBytes >= ts->arena->liveBytes);
+
+    REQUIRE(timeseries_enforce_quota(ts, 901, 0) == TS_ST_OK);
+    REQUIRE(timeseries_size(ts) == 100);
+    CHECK(ts->arena->numSlabs < numSlabs);
+    CHECK(timeseries_bytes_used(ts) < bytesUsed);
+    CHECK(strcmp((char *)timeseries_first(ts, nullptr)->val.ptr, "sample 901") == 0);
+    CHECK(strcmp((char *)timeseries_last(ts, nullptr)->val.ptr, "sample 1000") == 0);
+
+    /* The current slab is reused once it empties */
+    REQUIRE(timeseries_enforce_quota(ts, 2000, 0) == TS_ST_OK);
+    CHECK(ts->arena->numSlabs == 1);
+    CHECK(ts->arena->liveBytes == 0);
+    REQUIRE(timeseries_insert_string(ts, 3000, value) == TS_ST_OK);
+    CHECK(ts->arena->numSlabs == 1);
+
+    timeseries_destroy(ts);
+
+    /* Large blobs get a slab of their own that goes away with them */
+    ts = timeseries_alloc(TS_TYPE_BLOB, &errorSt);
+    REQUIRE(ts != nullptr);
+    std::vector<int> small(4, 7);
+    std::vector<char> large(TS_SLAB_MAX_SIZE, 'x');
+    REQUIRE(timeseries_insert_blob(ts, 1, small.data(), small.size() * sizeof(int)) == TS_ST_OK);
+    REQUIRE(timeseries_insert_blob(ts, 2, large.data(), large.size()) == TS_ST_OK);
+    REQUIRE(timeseries_insert_blob(ts, 3, small.data(), small.size() * sizeof(int)) == TS_ST_OK);
+    CHECK(ts->arena->numSlabs == 2);
+    CHECK(timeseries_bytes_used(ts) > TS_SLAB_MAX_SIZE);
+    CHECK(memcmp(timeseries_find(ts, 2, TS_LGE_EQUAL, nullptr)->val.ptr, large.data(), large.size()) == 0);
+    CHECK(memcmp(timeseries_find(ts, 3, TS_LGE_EQUAL, nullptr)->val.ptr, small.data(), 4 * sizeof(int)) == 0);
+
+    REQUIRE(timeseries_enforce_quota(ts, 3, 0) == TS_ST_OK);
+    CHECK(ts->arena->numSlabs == 1);
+    CHECK(timeseries_bytes_used(ts) < TS_SLAB_MAX_SIZE);
+
+    timeseries_destroy(ts);
+}
+
+TEST_CASE("TimeSeries: bucketize")
+{
+    int errorSt = 0;
+    timeseries_bucket_t buckets[8];
+
+    for (int compressed = 0; compressed < 2; compressed++)
+    {
+        timeseries_p ts = compressed ? timeseries_alloc_compressed(TS_TYPE_INT64, &errorSt)
+                                     : timeseries_alloc_ring(TS_TYPE_INT64, 4, &errorSt);
+        REQUIRE(ts != nullptr);
+
+        /* 0..99 at 100..9900 usec, with a blank value at 500 */
+        for (long long i = 1; i < 100; i++)
+        {
+            long long value = i == 5 ? DCGM_INT64_BLANK : i;
+            REQUIRE(timeseries_insert_int64(ts, i * 100, value, 0) == TS_ST_OK);
+        }
+
+        int numBuckets = timeseries_bucketize(ts, 0, 0, 1000, buckets, 8);
+        REQUIRE(numBuckets == 8);
+        CHECK(buckets[0].startUsec == 0);
+        CHECK(buckets[0].count == 8); /* 100..900 minus the blank */
+        CHECK(buckets[0].min.i64 == 1);
+        CHECK(buckets[0].max.i64 == 9);
+        CHECK(buckets[0].last.i64 == 9);
+        CHECK(buckets[0].lastUsec == 900);
+        CHECK(buckets[0].sum == 40.0);
+        CHECK(buckets[1].startUsec == 1000);
+        CHECK(buckets[1].count == 10);
+        CHECK(buckets[7].startUsec == 7000);
+
+        /* Time range is inclusive of both ends */
+        numBuckets = timeseries_bucketize(ts, 2500, 4000, 1000, buckets, 8);
+        REQUIRE(numBuckets == 3);
+        CHECK(buckets[0].startUsec == 2000);
+        CHECK(buckets[0].count == 5);
+        CHECK(buckets[0].min.i64 == 25);
+        CHECK(buckets[2].startUsec == 4000);
+        CHECK(buckets[2].count == 1);
+
+        CHECK(timeseries_bucketize(ts, 0, 0, 0, buckets, 8) == TS_ST_BADPARAM);
+        timeseries_destroy(ts);
+    }
+
+    timeseries_p ts = timeseries_alloc(TS_TYPE_STRING, &errorSt);
+    REQUIRE(ts != nullptr);
+    CHECK(timeseries_bucketize(ts, 0, 0, 1000, buckets, 8) == TS_ST_WRONGTYPE);
+    timeseries_destroy(ts);
+}
+
+/* Appends the samples of each span to a std::vector<long long> of timestamps and values */
+static int CollectSpan(timelib64_t const *usecSince1970, timeseries_value_t const *values, int count, void *userData)
+{
+    auto *collected = (std::vector<long long> *)userData;
+    REQUIRE(count > 0);
+    for (int i = 0; i < count; i++)
+    {
+        collected->push_back(usecSince1970[i]);
+        collected->push_back(values[i].i64);
+    }
+    return 0;
+}
+
+static int CountSpan(timelib64_t const *, timeseries_value_t const *, int, void *userData)
+{
+    (*(int *)userData)++;
+    return 0;
+}
+
+TEST_CASE("TimeSeries: for each span")
+{
+    int errorSt = 0;
+
+    for (int compressed = 0; compressed < 2; compressed++)
+    {
+        timeseries_p ts = compressed ? timeseries_alloc_compressed(TS_TYPE_INT64, &errorSt)
+                                     : timeseries_alloc_ring(TS_TYPE_INT64, 4, &errorSt);
+        REQUIRE(ts != nullptr);
+
+        /* Keep the last 300 samples so the ring wraps and the oldest block is partly dropped */
+        for (long long i = 1; i <= 1000; i++)
+        {
+            REQUIRE(timeseries_insert_int64(ts, i * 10, i * 3, 0) == TS_ST_OK);
+            REQUIRE(timeseries_enforce_quota(ts, (i - 299) * 10, 0) == TS_ST_OK);
+        }
+
+        for (auto [startTime, endTime] : std::vector<std::pair<long long, long long>> {
+                 { 0, 0 }, { 7005, 0 }, { 0, 8000 }, { 7500, 9995 }, { 9000, 9000 }, { 20000, 0 } })
+        {
+            std::vector<long long> collected;
+            REQUIRE(timeseries_for_each_span(ts, startTime, endTime, CollectSpan, &collected) == TS_ST_OK);
+
+            std::vector<long long> expected;
+            for (long long i = 701; i <= 1000; i++)
+            {
+                if (i * 10 >= startTime && (!endTime || i * 10 <= endTime))
+                {
+                    expected.push_back(i * 10);
+                    expected.push_back(i * 3);
+                }
+            }
+            CHECK(collected == expected);
+        }
+
+        int numSpans = 0;
+        REQUIRE(timeseries_for_each_span(ts, 0, 0, CountSpan, &numSpans) == TS_ST_OK);
+        if (!compressed)
+            CHECK(numSpans <= 2);
+        else
+            CHECK(numSpans > 2);
+
+        timeseries_destroy(ts);
+    }
+
+    timeseries_p ts = timeseries_alloc(TS_TYPE_INT64, &errorSt);
+    REQUIRE(ts != nullptr);
+    CHECK(timeseries_for_each_span(ts, 0, 0, CountSpan, nullptr) == TS_ST_WRONGTYPE);
+    timeseries_destroy(ts);
+}
+
+TEST_CASE("TimeSeries: ring spans")
+{
+    int errorSt     = 0;
+    timeseries_p ts = timeseries_alloc_ring(TS_TYPE_INT64, 8, &errorSt);
+    REQUIRE(ts != nullptr);
+
+    /* Keep 5 samples in a ring of 8 so they wrap past the end of the columns */
+    for (long long i = 1; i <= 12; i++)
+    {
+        REQUIRE(timeseries_insert_int64(ts, i * 10, i, 0) == TS_ST_OK);
+        REQUIRE(timeseries_enforce_quota(ts, (i - 4) * 10, 0) == TS_ST_OK);
+    }
+    REQUIRE(ts->ring->capacity == 8);
+
+    timeseries_span_t spans[2];
+    int olderInHistory = -1;
+    REQUIRE(timeseries_ring_spans(ts, 0, 0, spans, &olderInHistory) == 2);
+    CHECK(olderInHistory == 0);
+    CHECK(spans[0].count + spans[1].count == 5);
+
+    std::vector<long long> values;
+    for (timeseries_span_t const &span : spans)
+    {
+        for (int i = 0; i < span.count; i++)
+        {
+            CHECK(span.usecSince1970[i] == span.values[i].i64 * 10);
+            values.push_back(span.values[i].i64);
+        }
+    }
+    CHECK(values == std::vector<long long> { 8, 9, 10, 11, 12 });
+
+    /* The spans point into the ring rather than at copies */
+    CHECK(spans[0].values == &ts->ring->val[ts->ring->head]);
+
+    REQUIRE(timeseries_ring_spans(ts, 0, 1, spans, nullptr) == 1);
+    CHECK(spans[0].count == 1);
+    CHECK(spans[0].values[0].i64 == 12);
+
+    REQUIRE(timeseries_ring_spans(ts, 105, 0, spans, nullptr) == 1);
+    CHECK(spans[0].count == 2);
+    CHECK(spans[0].values[0].i64 == 11);
+
+    CHECK(timeseries_ring_spans(ts, 1000, 0, spans, nullptr) == 0);
+    CHECK(spans[0].count == 0);
+    timeseries_destroy(ts);
+
+    /* Compressed history isn't in the spans, but the caller is told that it's there */
+    ts = timeseries_alloc_compressed(TS_TYPE_INT64, &errorSt);
+    REQUIRE(ts != nullptr);
+    for (long long i = 1; i <= 1000; i++)
+    {
+        REQUIRE(timeseries_insert_int64(ts, i * 10, i, 0) == TS_ST_OK);
+    }
+    REQUIRE(timeseries_ring_spans(ts, 0, 0, spans, &olderInHistory) >= 1);
+    CHECK(olderInHistory == 1);
+    CHECK(spans[0].count < 1000);
+    REQUIRE(timeseries_ring_spans(ts, 0, 1, spans, &olderInHistory) == 1);
+    CHECK(olderInHistory == 0);
+    CHECK(spans[0].values[0].i64 == 1000);
+    timeseries_destroy(ts);
+
+    ts = timeseries_alloc(TS_TYPE_INT64, &errorSt);
+    REQUIRE(ts != nullptr);
+    CHECK(timeseries_ring_spans(ts, 0, 0, spans, nullptr) == TS_ST_WRONGTYPE);
+    timeseries_destroy(ts);
+}
+
+namespace
+{
+/* Allocator that counts what it hands out */
+struct CountingAllocator
+{
+    long long bytesOutstanding = 0;
+    int numAllocs              = 0;
+
+    static void *Alloc(void *userData, size_t size)
+    {
+        auto *self = static_cast<CountingAllocator *>(userData);
+        self->bytesOutstanding += size;
+        self->numAllocs++;
+        return malloc(size);
+    }
+
+    static void Release(void *userData, void *ptr, size_t size)
+    {
+        static_cast<CountingAllocator *>(userData)->bytesOutstanding -= size;
+        free(ptr);
+    }
+};
+} // namespace
+
+TEST_CASE("TimeSeries: ring allocator")
+{
+    CountingAllocator counter;
+    timeseries_allocator_t allocator { CountingAllocator::Alloc, CountingAllocator::Release, &counter };
+
+    int errorSt     = 0;
+    timeseries_p ts = timeseries_alloc_ring(TS_TYPE_INT64, 4, &errorSt);
+    REQUIRE(ts != nullptr);
+    for (long long i = 1; i <= 3; i++)
+    {
+        REQUIRE(timeseries_insert_int64(ts, i * 10, i, 0) == TS_ST_OK);
+    }
+
+    /* The samples move to the allocator's memory */
+    REQUIRE(timeseries_set_allocator(ts, &allocator) == TS_ST_OK);
+    CHECK(ts->ring->allocator == &allocator);
+    CHECK(counter.bytesOutstanding == 4 * (long long)(sizeof(timelib64_t) + sizeof(timeseries_value_t)));
+    CHECK(timeseries_set_allocator(ts, &allocator) == TS_ST_OK);
+
+    /* Growing the ring uses it too */
+    int numAllocs = counter.numAllocs;
+    for (long long i = 4; i <= 6; i++)
+    {
+        REQUIRE(timeseries_insert_int64(ts, i * 10, i, 0) == TS_ST_OK);
+    }
+    CHECK(ts->ring->capacity == 8);
+    CHECK(counter.numAllocs > numAllocs);
+    CHECK(counter.bytesOutstanding == 8 * (long long)(sizeof(timelib64_t) + sizeof(timeseries_value_t)));
+
+    std::vector<long long> values;
+    timeseries_cursor_t cursor;
+    for (timeseries_entry_p entry = timeseries_first(ts, &cursor); entry; entry = timeseries_next(ts, &cursor))
+    {
+        values.push_back(entry->val.i64);
+    }
+    CHECK(values == std::vector<long long> { 1, 2, 3, 4, 5, 6 });
+
+    timeseries_destroy(ts);
+    CHECK(counter.bytesOutstanding == 0);
+
+    /* Only rings have columns to allocate */
+    ts = timeseries_alloc(TS_TYPE_INT64, &errorSt);
+    REQUIRE(ts != nullptr);
+    CHECK(timeseries_set_allocator(ts, &allocator) == TS_ST_BADPARAM);
+    timeseries_destroy(ts);
+}
+
+/* Read up to pageSize entries after position. Returns their values */
+static std::vector<long long> ReadPage(timeseries_p ts,
+                                       timeseries_position_t &position,
+                                       int pageSize,
+                                       long long *entriesSkipped = nullptr)
+{
+    std::vector<long long> values;
+    timeseries_cursor_t cursor;
+    for (timeseries_entry_p entry = timeseries_resume(ts, &position, &cursor, entriesSkipped);
+         entry && (int)values.size() < pageSize;
+         entry = timeseries_next(ts, &cursor))
+    {
+        values.push_back(entry->val.i64);
+        timeseries_position_after(ts, entry, &cursor, &position);
+    }
+    return values;
+}
+
+TEST_CASE("TimeSeries: resume from a position")
+{
+    int errorSt = 0;
+
+    for (int storage = 0; storage < 3; storage++)
+    {
+        timeseries_p ts = storage == 0   ? timeseries_alloc(TS_TYPE_INT64, &errorSt)
+                          : storage == 1 ? timeseries_alloc_ring(TS_TYPE_INT64, 4, &errorSt)
+                                         : timeseries_alloc_compressed(TS_TYPE_INT64, &errorSt);
+        REQUIRE(ts != nullptr);
+
+        for (long long i = 1; i <= 10; i++)
+        {
+            REQUIRE(timeseries_insert_int64(ts, i * 10, i, 0) == TS_ST_OK);
+        }
+
+        timeseries_position_t position {};
+        CHECK(ReadPage(ts, position, 4) == std::vector<long long> { 1, 2, 3, 4 });
+        CHECK(position.usecSince1970 == 40);
+        if (storage != 0)
+            CHECK(position.serial == 4);
+
+        /* New entries and quota enforcement don't move the position */
+        for (long long i = 11; i <= 600; i++)
+        {
+            REQUIRE(timeseries_insert_int64(ts, i * 10, i, 0) == TS_ST_OK);
+        }
+        REQUIRE(timeseries_enforce_quota(ts, 30, 0) == TS_ST_OK);
+        CHECK(ReadPage(ts, position, 3) == std::vector<long long> { 5, 6, 7 });
+
+        /* Entries removed before they were read are skipped */
+        REQUIRE(timeseries_enforce_quota(ts, 0, 500) == TS_ST_OK);
+        long long entriesSkipped = 0;
+        CHECK(ReadPage(ts, position, 2, &entriesSkipped) == std::vector<long long> { 101, 102 });
+        if (storage != 0)
+            CHECK(entriesSkipped == 93);
+
+        /* An out of order insert behind the position falls back to searching by timestamp */
+        REQUIRE(timeseries_insert_int64(ts, 1015, -1, 0) == TS_ST_OK);
+        CHECK(ReadPage(ts, position, 3) == std::vector<long long> { 103, 104, 105 });
+        CHECK(position.usecSince1970 == 1050);
+
+        CHECK(ReadPage(ts, position, 1000).size() == 495);
+        CHECK(ReadPage(ts, position, 1000).empty());
+        CHECK(position.usecSince1970 == 6000);
+
+        timeseries_destroy(ts);
+    }
+}
+
+static int CompareInts(void *elem1, void *elem2)
+{
+    int const a = *(int *)elem1;
+    int const b = *(int *)elem2;
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static int RejectDuplicateInts(void *, void *, void *)
+{
+    return KV_ST_DUPLICATE;
+}
+
+static void CountFreedInts(void *, void *user)
+{
+    (*(int *)user)++;
+}
+
+TEST_CASE("KeyedVector: append, copy range and remove first")
+{
+    int errorSt = 0;
+    int freed   = 0;
+    /* 4 elements per block so that everything below spans many blocks */
+    keyedvector_p kv = keyedvector_alloc(
+        sizeof(int), 4 * sizeof(int), CompareInts, RejectDuplicateInts, CountFreedInts, &freed, &errorSt);
+    REQUIRE(kv != nullptr);
+
+    std::vector<int> values;
+    for (int i = 1; i <= 10; i++)
+    {
+        values.push_back(i * 10);
+    }
+    CHECK(keyedvector_append(kv, values.data(), 10) == 10);
+    CHECK(keyedvector_size(kv) == 10);
+    CHECK(keyedvector_size_slow(kv) == 10);
+
+    /* Stops at the first element that isn't past the one before it */
+    int more[] = { 110, 120, 115, 130 };
+    CHECK(keyedvector_append(kv, more, 4) == 2);
+    CHECK(keyedvector_append(kv, more, 4) == 0);
+    kv_cursor_t cursor;
+    REQUIRE(keyedvector_insert(kv, &more[2], &cursor) == KV_ST_OK);
+    CHECK(keyedvector_append(kv, &more[3], 1) == 1);
+    CHECK(keyedvector_size(kv) == 14);
+
+    std::vector<int> copied(20, 0);
+    REQUIRE(keyedvector_copy_range(kv, nullptr, nullptr, copied.data(), 20) == 14);
+    for (int i = 1; i < 14; i++)
+    {
+        CHECK(copied[i - 1] < copied[i]);
+    }
+    CHECK(copied[13] == 130);
+
+    /* A range within the middle, cut short by maxElements */
+    kv_cursor_t start, end;
+    int key = 25;
+    REQUIRE(keyedvector_find_by_key(kv, &key, KV_LGE_GREATEQUAL, &start) != nullptr);
+    key = 115;
+    REQUIRE(keyedvector_find_by_key(kv, &key, KV_LGE_LESSEQUAL, &end) != nullptr);
+    CHECK(keyedvector_copy_range(kv, &start, &end, nullptr, 100) == 10);
+    REQUIRE(keyedvector_copy_range(kv, &start, &end, copied.data(), 3) == 3);
+    CHECK(copied[0] == 30);
+    CHECK(copied[2] == 50);
+    CHECK(keyedvector_copy_range(kv, &end, &start, copied.data(), 3) == 0);
+
+    /* Whole blocks and part of one */
+    REQUIRE(keyedvector_remove_first(kv, 6) == KV_ST_OK);
+    CHECK(freed == 6);
+    CHECK(keyedvector_size(kv) == 8);
+    CHECK(keyedvector_size_slow(kv) == 8);
+    CHECK(*(int *)keyedvector_first(kv, &cursor) == 70);
+
+    REQUIRE(keyedvector_remove_first(kv, 100) == KV_ST_OK);
+    CHECK(freed == 14);
+    CHECK(keyedvector_size(kv) == 0);
+    CHECK(keyedvector_first(kv, &cursor) == nullptr);
+
+    /* Still usable once empty */
+    CHECK(keyedvector_append(kv, values.data(), 10) == 10);
+    CHECK(keyedvector_size_slow(kv) == 10);
+
+    keyedvector_destroy(kv);
+    CHECK(freed == 24);
+}
+
+TEST_CASE("TimeSeries: insert many and copy range")
+{
+    int errorSt = 0;
+
+    for (int storage = 0; storage < 3; storage++)
+    {
+        timeseries_p ts = storage == 0   ? timeseries_alloc(TS_TYPE_INT64, &errorSt)
+                          : storage == 1 ? timeseries_alloc_ring(TS_TYPE_INT64, 4, &errorSt)
+                                         : timeseries_alloc_compressed(TS_TYPE_INT64, &errorSt);
+        REQUIRE(ts != nullptr);
+
+        std::vector<timelib64_t> times;
+        std::vector<timeseries_value_t> values, values2;
+        for (long long i = 1; i <= 1000; i++)
+        {
+            times.push_back(i * 10);
+            values.emplace_back();
+            values.back().i64 = i;
+            values2.emplace_back();
+            values2.back().i64 = i % 3;
+        }
+        REQUIRE(timeseries_insert_many(ts, times.data(), values.data(), values2.data(), 1000) == TS_ST_OK);
+        REQUIRE(timeseries_size(ts) == 1000);
+
+        /* Out of order and a duplicate timestamp, which gets bumped by one */
+        timelib64_t lateTimes[] = { 10005, 5, 10010, 10010, 10020 };
+        timeseries_value_t lateVals[5];
+        for (int i = 0; i < 5; i++)
+        {
+            lateVals[i].i64 = -(i + 1);
+        }
+        REQUIRE(timeseries_insert_many(ts, lateTimes, lateVals, nullptr, 5) == TS_ST_OK);
+        REQUIRE(timeseries_size(ts) == 1005);
+
+        /* Matches walking a cursor */
+        std::vector<timeseries_entry_t> entries(2000);
+        REQUIRE(timeseries_copy_range(ts, 0, 0, entries.data(), 2000) == 1005);
+        timeseries_cursor_t cursor;
+        int i = 0;
+        for (timeseries_entry_p entry = timeseries_first(ts, &cursor); entry; entry = timeseries_next(ts, &cursor), i++)
+        {
+            CHECK(entries[i].usecSince1970 == entry->usecSince1970);
+            CHECK(entries[i].val.i64 == entry->val.i64);
+            CHECK(entries[i].val2.i64 == entry->val2.i64);
+        }
+        CHECK(i == 1005);
+        CHECK(entries[0].val.i64 == -2);
+        CHECK(entries[1001].usecSince1970 == 10005);
+        CHECK(entries[1003].usecSince1970 == 10011);
+        CHECK(entries[1003].val.i64 == -4);
+
+        /* Time range, and a range cut short by maxEntries */
+        REQUIRE(timeseries_copy_range(ts, 95, 150, entries.data(), 2000) == 6);
+        CHECK(entries[0].val.i64 == 10);
+        CHECK(entries[5].val.i64 == 15);
+        CHECK(entries[5].val2.i64 == 0);
+        REQUIRE(timeseries_copy_range(ts, 95, 0, entries.data(), 2) == 2);
+        CHECK(entries[1].val.i64 == 11);
+        CHECK(timeseries_copy_range(ts, 20000, 0, entries.data(), 2000) == 0);
+        CHECK(timeseries_copy_range(ts, 1, 4, entries.data(), 2000) == 0);
+
+        /* Quota enforcement by count */
+        REQUIRE(timeseries_enforce_quota(ts, 0, 300) == TS_ST_OK);
+        CHECK(timeseries_size(ts) == 300);
+        CHECK(timeseries_first(ts, nullptr)->val.i64 == 705);
+
+        timeseries_destroy(ts);
+    }
+
+    timeseries_p strings = timeseries_alloc(TS_TYPE_STRING, &errorSt);
+    REQUIRE(strings != nullptr);
+    timelib64_t time = 1;
+    timeseries_value_t value;
+    value.i64 = 1;
+    CHECK(timeseries_insert_many(strings, &time, &value, nullptr, 1) == TS_ST_WRONGTYPE);
+    timeseries_destroy(strings);
+}
+
+/* Filling a timeseries with 10k samples and reading them back the way GetSamples() used to, entry by entry through
+   a cursor, against the bulk functions. Hidden from the default run. Use: commontests "[benchmark]" */
+TEST_CASE("TimeSeries: Benchmark bulk insert and copy range", "[.][benchmark]")
+{
+    using Clock               = std::chrono::steady_clock;
+    constexpr int numSamples  = 10000;
+    constexpr int repetitions = 100;
+    int errorSt               = 0;
+
+    std::vector<timelib64_t> times(numSamples);
+    std::vector<timeseries_value_t> values(numSamples);
+    for (int i = 0; i < numSamples; i++)
+    {
+        times[i]      = i + 1;
+        values[i].i64 = i + 1;
+    }
+
+    for (int storage = 0; storage < 2; storage++)
+    {
+        auto alloc = [&] {
+            return storage == 0 ? timeseries_alloc(TS_TYPE_INT64, &errorSt)
+                                : timeseries_alloc_ring(TS_TYPE_INT64, 4, &errorSt);
+        };
+        auto elapsedNs = [](Clock::time_point start) {
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numSamples / repetitions;
+        };
+
+        auto start = Clock::now();
+        for (int r = 0; r < repetitions; r++)
+        {
+            timeseries_p ts = alloc();
+            for (int i = 0; i < numSamples; i++)
+            {
+                timeseries_insert_int64(ts, times[i], values[i].i64, 0);
+            }
+            timeseries_destroy(ts);
+        }
+        double const insertOneNs = elapsedNs(start);
+
+        timeseries_p ts = nullptr;
+        start           = Clock::now();
+        for (int r = 0; r < repetitions; r++)
+        {
+            timeseries_destroy(ts);
+            ts = alloc();
+            timeseries_insert_many(ts, times.data(), values.data(), nullptr, numSamples);
+        }
+        double const insertManyNs = elapsedNs(start);
+        REQUIRE(timeseries_size(ts) == numSamples);
+
+        long long sum = 0;
+        start         = Clock::now();
+        for (int r = 0; r < repetitions; r++)
+        {
+            timeseries_cursor_t cursor;
+            for (timeseries_entry_p entry = timeseries_first(ts, &cursor); entry; entry = timeseries_next(ts, &cursor))
+            {
+                sum += entry->val.i64;
+            }
+        }
+        double const walkNs = elapsedNs(start);
+
+        std::vector<timeseries_entry_t> entries(numSamples);
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++)
+        {
+            REQUIRE(timeseries_copy_range(ts, 0, 0, entries.data(), numSamples) == numSamples);
+            for (auto const &entry : entries)
+            {
+                sum -= entry.val.i64;
+            }
+        }
+        double const copyNs = elapsedNs(start);
+        CHECK(sum == 0);
+        timeseries_destroy(ts);
+
+        WARN((storage == 0 ? "keyedvector" : "ring") << " ns/sample insert one vs many: " << insertOneNs << " vs "
+                                                     << insertManyNs << ". Cursor walk vs copy range: " << walkNs
+                                                     << " vs " << copyNs);
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <DcgmTrace.h>
+
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+TEST_CASE("Trace: ring and Chrome trace output")
+{
+    using DcgmNs::Tracer;
+    Tracer &tracer = Tracer::Instance();
+
+    /* Nothing is recorded before the first Start() */
+    std::string filename;
+    if (tracer.Capacity() == 0)
+    {
+        {
+            DCGM_TRACE_SCOPE("test", "before-start");
+        }
+        CHECK(tracer.Snapshot().empty());
+        CHECK(tracer.WriteChromeTrace("/tmp", filename) == DCGM_ST_UNINITIALIZED);
+    }
+
+    tracer.Start(8);
+    REQUIRE(tracer.Capacity() == 8);
+
+    for (int i = 1; i <= 10; i++)
+    {
+        tracer.Record("test", "span", 1000 * i, i, i);
+    }
+
+    /* Only the newest spans fit, oldest first */
+    std::vector<DcgmNs::TraceSpan> spans = tracer.Snapshot();
+    REQUIRE(spans.size() == 8);
+    for (int i = 0; i < 8; i++)
+    {
+        CHECK(spans[i].arg == i + 3);
+        CHECK(spans[i].startUsec == 1000 * (i + 3));
+        CHECK(spans[i].tid != 0);
+    }
+
+    {
+        DCGM_TRACE_SCOPE("test", "scope", 42);
+    }
+    spans = tracer.Snapshot();
+    CHECK(std::string(spans.back().name) == "scope");
+    CHECK(spans.back().arg == 42);
+
+    {
+        DcgmNs::TraceScope scope("test", "ended", 43);
+        scope.End();
+        scope.End();
+    }
+    spans = tracer.Snapshot();
+    CHECK(std::string(spans.back().name) == "ended");
+    CHECK(std::string(spans[spans.size() - 2].name) == "scope");
+
+    /* Stopped tracing keeps what was recorded but ignores new scopes */
+    tracer.Stop();
+    {
+        DCGM_TRACE_SCOPE("test", "after-stop");
+    }
+    CHECK(std::string(tracer.Snapshot().back().name) == "ended");
+
+    std::string json = Tracer::ToChromeTraceJson({ { "cat", "name", 10, 5, 0, 7 } }, 3);
+    CHECK(json.find("{\"name\":\"name\",\"cat\":\"cat\",\"ph\":\"X\",\"ts\":10,\"dur\":5,\"pid\":3,\"tid\":7}")
+          != std::string::npos);
+    CHECK(json.find("\"traceEvents\":[") != std::string::npos);
+
+    REQUIRE(tracer.WriteChromeTrace("/tmp", filename) == DCGM_ST_OK);
+    std::ifstream file(filename);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    CHECK(contents.str().find("\"name\":\"scope\"") != std::string::npos);
+    unlink(filename.c_str());
+
+    CHECK(tracer.WriteChromeTrace("/nonexistent-dir", filename) == DCGM_ST_GENERIC_ERROR);
+}
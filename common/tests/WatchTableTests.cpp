@@ -173,3 +173,51 @@ TEST_CASE("WatchTable: GetFieldsToUpdate")
     CHECK(memTempCount == 4);
     CHECK(earliestNextUpdate == now + 10);
 }
+
+TEST_CASE("WatchTable: GetFieldsToUpdate only returns due watches")
+{
+    DcgmWatchTable wt;
+    DcgmFieldsInit();
+    DcgmWatcher watcher(DcgmWatcherTypeCacheManager, 1);
+    timelib64_t const now = 1000000;
+
+    CHECK(DcgmWatchTable::GetFieldModule(DCGM_FI_DEV_GPU_TEMP) == DcgmModuleIdCore);
+    CHECK(DcgmWatchTable::GetFieldModule(DCGM_FI_DEV_NVSWITCH_NON_FATAL_ERRORS) == DcgmModuleIdNvSwitch);
+    CHECK(DcgmWatchTable::GetFieldModule(DCGM_FI_PROF_GR_ENGINE_ACTIVE) == DcgmModuleIdProfiling);
+
+    REQUIRE(wt.AddWatcher(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, watcher, 100, 1000000, false) == true);
+    REQUIRE(wt.AddWatcher(DCGM_FE_GPU, 0, DCGM_FI_DEV_MEMORY_TEMP, watcher, 300, 1000000, false) == true);
+
+    std::vector<dcgm_field_update_info_t> toUpdate;
+    timelib64_t earliestNextUpdate = 0;
+    REQUIRE(wt.GetFieldsToUpdate(DcgmModuleIdCore, now, toUpdate, earliestNextUpdate) == DCGM_ST_OK);
+    CHECK(toUpdate.size() == 2);
+    CHECK(earliestNextUpdate == now + 100);
+
+    // Nothing is due before the earliest deadline
+    toUpdate.clear();
+    REQUIRE(wt.GetFieldsToUpdate(DcgmModuleIdCore, now + 99, toUpdate, earliestNextUpdate) == DCGM_ST_OK);
+    CHECK(toUpdate.empty());
+    CHECK(earliestNextUpdate == now + 100);
+
+    REQUIRE(wt.GetFieldsToUpdate(DcgmModuleIdCore, now + 100, toUpdate, earliestNextUpdate) == DCGM_ST_OK);
+    REQUIRE(toUpdate.size() == 1);
+    CHECK(toUpdate[0].fieldMeta->fieldId == DCGM_FI_DEV_GPU_TEMP);
+    CHECK(earliestNextUpdate == now + 200);
+
+    // A faster watcher moves the deadline up
+    DcgmWatcher client(DcgmWatcherTypeClient, 2);
+    REQUIRE(wt.AddWatcher(DCGM_FE_GPU, 0, DCGM_FI_DEV_MEMORY_TEMP, client, 50, 1000000, false) == false);
+    toUpdate.clear();
+    REQUIRE(wt.GetFieldsToUpdate(DcgmModuleIdCore, now + 50, toUpdate, earliestNextUpdate) == DCGM_ST_OK);
+    REQUIRE(toUpdate.size() == 1);
+    CHECK(toUpdate[0].fieldMeta->fieldId == DCGM_FI_DEV_MEMORY_TEMP);
+    CHECK(earliestNextUpdate == now + 100);
+
+    // Cleared watches aren't returned again
+    REQUIRE(wt.ClearEntityWatches(DCGM_FE_GPU, 0) == DCGM_ST_OK);
+    toUpdate.clear();
+    REQUIRE(wt.GetFieldsToUpdate(DcgmModuleIdCore, now + 1000, toUpdate, earliestNextUpdate) == DCGM_ST_OK);
+    CHECK(toUpdate.empty());
+    CHECK(earliestNextUpdate == 0);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <WorkStealingThreadPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace DcgmNs;
+
+TEST_CASE("WorkStealingThreadPool: runs every task from many threads")
+{
+    WorkStealingThreadPool pool(4);
+    REQUIRE(pool.GetNumWorkers() == 4);
+
+    constexpr int numThreads = 4;
+    constexpr int numTasks   = 2000;
+
+    std::atomic<int> ran { 0 };
+    std::vector<std::thread> threads;
+    std::vector<std::vector<std::shared_future<int>>> futures(numThreads);
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back([&pool, &ran, &futures, t] {
+            for (int i = 0; i < numTasks; i++)
+            {
+                futures[t].push_back(pool.Enqueue([&ran, i] {
+                    ran++;
+                    return i;
+                }));
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto const &threadFutures : futures)
+    {
+        for (int i = 0; i < numTasks; i++)
+        {
+            REQUIRE(threadFutures[i].get() == i);
+        }
+    }
+    CHECK(ran == numThreads * numTasks);
+}
+
+TEST_CASE("WorkStealingThreadPool: idle workers steal from a busy one")
+{
+    WorkStealingThreadPool pool(4);
+
+    /* Every child is enqueued from the same worker, so it lands on that worker's queue. The parent holds that
+       worker until all of them have started, which can only happen if they were stolen */
+    constexpr int numChildren = 3;
+    std::mutex mutex;
+    std::set<std::thread::id> childThreads;
+    std::atomic<int> started { 0 };
+
+    auto parent = pool.Enqueue([&] {
+        std::vector<std::shared_future<void>> children;
+        for (int i = 0; i < numChildren; i++)
+        {
+            children.push_back(pool.Enqueue([&] {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    childThreads.insert(std::this_thread::get_id());
+                }
+                started++;
+                while (started < numChildren)
+                {
+                    std::this_thread::yield();
+                }
+            }));
+        }
+
+        for (auto &child : children)
+        {
+            child.wait();
+        }
+        return std::this_thread::get_id();
+    });
+
+    REQUIRE(parent.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    std::thread::id const parentThread = parent.get();
+    CHECK(childThreads.size() == numChildren);
+    CHECK(childThreads.count(parentThread) == 0);
+}
+
+TEST_CASE("WorkStealingThreadPool: wakes up for tasks after going idle")
+{
+    WorkStealingThreadPool pool(2);
+
+    for (int i = 0; i < 100; i++)
+    {
+        /* Give the workers time to go to sleep between tasks */
+        if (i % 10 == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto future = pool.Enqueue([i] { return i * 2; });
+        REQUIRE(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+        CHECK(future.get() == i * 2);
+    }
+}
+
+TEST_CASE("WorkStealingThreadPool: stopping drops queued tasks")
+{
+    std::shared_future<void> dropped;
+    {
+        WorkStealingThreadPool pool(1);
+        std::promise<void> started;
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+
+        auto blocker = pool.Enqueue([&started, released] {
+            started.set_value();
+            released.wait();
+        });
+        started.get_future().wait();
+        dropped = pool.Enqueue([] {});
+
+        pool.Stop();
+        release.set_value();
+        pool.StopAndWait();
+        blocker.get();
+    }
+
+    CHECK_THROWS_AS(dropped.get(), std::future_error);
+
+    WorkStealingThreadPool empty(0);
+    CHECK_THROWS_AS(empty.Enqueue([] { return 1; }).get(), std::future_error);
+}
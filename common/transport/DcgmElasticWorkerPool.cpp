@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmElasticWorkerPool.h"
+#include "DcgmLogging.h"
+
+#include <algorithm>
+#include <pthread.h>
+
+/*****************************************************************************/
+DcgmElasticWorkerPool::DcgmElasticWorkerPool(DcgmElasticWorkerPoolParams_t const &params, std::string name)
+    : m_params(params)
+    , m_name(std::move(name))
+{
+    m_params.minWorkers = std::max(m_params.minWorkers, 1U);
+    m_params.maxWorkers = std::max(m_params.maxWorkers, m_params.minWorkers);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (unsigned int i = 0; i < m_params.minWorkers; i++)
+    {
+        StartWorker();
+    }
+}
+
+/*****************************************************************************/
+DcgmElasticWorkerPool::~DcgmElasticWorkerPool()
+{
+    StopAndWait();
+}
+
+/*****************************************************************************/
+void DcgmElasticWorkerPool::StartWorker()
+{
+    auto self = m_threads.emplace(m_threads.end());
+
+    /* The worker waits for m_mutex, which the caller holds, so *self is set before it runs */
+    *self = std::thread([this, self] { RunWorker(self); });
+
+    /* Thread names are limited to 15 characters */
+    std::string threadName = (m_name + "_" + std::to_string(m_nextWorkerIndex++)).substr(0, 15);
+    pthread_setname_np(self->native_handle(), threadName.c_str());
+
+    m_stats.peakWorkers = std::max(m_stats.peakWorkers, (unsigned int)m_threads.size());
+    if (m_threads.size() > m_params.minWorkers)
+    {
+        m_stats.workersStarted++;
+        DCGM_LOG_DEBUG << m_name << " grew to " << m_threads.size() << " workers";
+    }
+}
+
+/*****************************************************************************/
+void DcgmElasticWorkerPool::GrowIfBehind(Clock::time_point now)
+{
+    if (m_queue.empty() || m_idleWorkers > 0 || m_threads.size() >= m_params.maxWorkers)
+    {
+        return;
+    }
+
+    if (now - m_queue.front().enqueueTime >= std::chrono::microseconds(m_params.growWaitUsec))
+    {
+        StartWorker();
+    }
+}
+
+/*****************************************************************************/
+void DcgmElasticWorkerPool::Enqueue(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping)
+        {
+            return;
+        }
+
+        Clock::time_point now = Clock::now();
+        m_queue.push_back({ std::move(task), now });
+        m_stats.maxQueueDepth = std::max(m_stats.maxQueueDepth, (unsigned int)m_queue.size());
+        GrowIfBehind(now);
+    }
+
+    m_cond.notify_one();
+    JoinExited();
+}
+
+/*****************************************************************************/
+void DcgmElasticWorkerPool::RunWorker(std::list<std::thread>::iterator self)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stopping)
+    {
+        if (m_queue.empty())
+        {
+            m_idleWorkers++;
+            bool const gotWork = m_cond.wait_for(lock, std::chrono::microseconds(m_params.idleUsec), [this] {
+                return m_stopping || !m_queue.empty();
+            });
+            m_idleWorkers--;
+
+            if (!gotWork && m_threads.size() > m_params.minWorkers)
+            {
+                /* Whoever enqueues next joins this thread */
+                m_stats.workersStopped++;
+                m_exited.push_back(std::move(*self));
+                m_threads.erase(self);
+                DCGM_LOG_DEBUG << m_name << " shrank to " << m_threads.size() << " workers";
+                return;
+            }
+            continue;
+        }
+
+        QueuedTask queued = std::move(m_queue.front());
+        m_queue.pop_front();
+
+        Clock::time_point now = Clock::now();
+        auto waitUsec
+            = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(now - queued.enqueueTime).count();
+        m_stats.tasksProcessed++;
+        m_stats.totalWaitUsec += waitUsec;
+        m_stats.maxWaitUsec = std::max(m_stats.maxWaitUsec, waitUsec);
+
+        /* The tasks behind this one may have waited as long */
+        GrowIfBehind(now);
+
+        lock.unlock();
+        try
+        {
+            queued.task();
+        }
+        catch (std::exception const &e)
+        {
+            DCGM_LOG_ERROR << m_name << " task threw " << e.what();
+        }
+        queued.task = nullptr; /* Release what the task captured before taking the lock */
+        lock.lock();
+    }
+}
+
+/*****************************************************************************/
+void DcgmElasticWorkerPool::JoinExited()
+{
+    std::vector<std::thread> exited;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        exited.swap(m_exited);
+    }
+
+    for (auto &thread : exited)
+    {
+        thread.join();
+    }
+}
+
+/*****************************************************************************/
+void DcgmElasticWorkerPool::StopAndWait()
+{
+    std::list<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+        threads.swap(m_threads);
+    }
+    m_cond.notify_all();
+
+    for (auto &thread : threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    JoinExited();
+}
+
+/*****************************************************************************/
+DcgmElasticWorkerPoolStats_t DcgmElasticWorkerPool::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    DcgmElasticWorkerPoolStats_t stats = m_stats;
+    stats.numWorkers                   = (unsigned int)m_threads.size();
+    stats.busyWorkers                  = stats.numWorkers - std::min(m_idleWorkers, stats.numWorkers);
+    stats.queueDepth                   = (unsigned int)m_queue.size();
+    return stats;
+}
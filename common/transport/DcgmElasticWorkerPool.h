@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Sizing of a DcgmElasticWorkerPool */
+typedef struct
+{
+    unsigned int minWorkers;              /* Workers that are always running. At least 1 */
+    unsigned int maxWorkers;              /* Most workers to grow to. Raised to minWorkers if lower */
+    unsigned int growWaitUsec = 5000;     /* Queue wait that makes the pool grow while every worker is busy */
+    unsigned int idleUsec     = 30000000; /* Idle time after which workers past minWorkers stop */
+} DcgmElasticWorkerPoolParams_t;
+
+/* Counters of a DcgmElasticWorkerPool */
+typedef struct
+{
+    unsigned int numWorkers;           /* Workers running right now */
+    unsigned int busyWorkers;          /* ... of which are running a task */
+    unsigned int peakWorkers;          /* Most workers that ran at once */
+    unsigned int queueDepth;           /* Tasks waiting for a worker right now */
+    unsigned int maxQueueDepth;        /* Most tasks that waited at once */
+    unsigned long long tasksProcessed; /* Tasks a worker picked up */
+    unsigned long long totalWaitUsec;  /* Time tasksProcessed spent queued */
+    unsigned long long maxWaitUsec;    /* Longest time a task spent queued */
+    unsigned long long workersStarted; /* Workers started past minWorkers */
+    unsigned long long workersStopped; /* Workers stopped for being idle */
+} DcgmElasticWorkerPoolStats_t;
+
+/*
+ * Worker threads that grow under load and shrink when idle.
+ *
+ * The pool starts with minWorkers. When a task has waited growWaitUsec or more
+ * for a worker while every worker is busy, another worker is started, up to
+ * maxWorkers. This is checked whenever a task is queued or picked up. Workers
+ * past minWorkers that go idleUsec without a task stop.
+ *
+ * Tasks still queued when the pool stops are dropped.
+ */
+class DcgmElasticWorkerPool
+{
+public:
+    using Task = std::function<void()>;
+
+    /* name is the prefix of the worker thread names */
+    DcgmElasticWorkerPool(DcgmElasticWorkerPoolParams_t const &params, std::string name);
+
+    /* Calls StopAndWait() */
+    ~DcgmElasticWorkerPool();
+
+    DcgmElasticWorkerPool(DcgmElasticWorkerPool const &) = delete;
+    DcgmElasticWorkerPool &operator=(DcgmElasticWorkerPool const &) = delete;
+
+    /* Queue task to be run by a worker. Ignored once the pool is stopping */
+    void Enqueue(Task task);
+
+    /* Stop every worker once it finishes its current task and wait for them */
+    void StopAndWait();
+
+    DcgmElasticWorkerPoolParams_t const &GetParams() const
+    {
+        return m_params;
+    }
+
+    DcgmElasticWorkerPoolStats_t GetStats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct QueuedTask
+    {
+        Task task;
+        Clock::time_point enqueueTime;
+    };
+
+    DcgmElasticWorkerPoolParams_t m_params;
+    std::string m_name;
+
+    std::mutex m_mutex; /* Protects everything below */
+    std::condition_variable m_cond;
+    std::deque<QueuedTask> m_queue;
+    std::list<std::thread> m_threads;  /* Running workers */
+    std::vector<std::thread> m_exited; /* Workers that stopped for being idle and still need joining */
+    unsigned int m_idleWorkers     = 0; /* Workers waiting for a task */
+    unsigned int m_nextWorkerIndex = 0; /* For thread names */
+    bool m_stopping                = false;
+    DcgmElasticWorkerPoolStats_t m_stats {};
+
+    /* Start a worker. Caller holds m_mutex */
+    void StartWorker();
+
+    /* Start a worker if the oldest task waited too long for a busy pool. Caller holds m_mutex */
+    void GrowIfBehind(Clock::time_point now);
+
+    /* Body of each worker thread. self points to its entry of m_threads */
+    void RunWorker(std::list<std::thread>::iterator self);
+
+    /* Join the workers that stopped for being idle. Caller must not hold m_mutex */
+    void JoinExited();
+};
@@ -16,11 +16,13 @@
 
 
 #include "DcgmIpc.h"
+#include "DcgmMessageBufferPool.h"
 #include <DcgmLogging.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <optional>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/un.h>
 
 /*****************************************************************************/
@@ -28,22 +30,232 @@
    to validate that we're indeed in the correct thread */
 #define ASSERT_IS_IPC_THREAD assert(pthread_equal(pthread_self(), m_ipcThreadId))
 
+/* Same for the thread that owns the connections of a reactor */
+#define ASSERT_IS_REACTOR_THREAD(reactor) assert(pthread_equal(pthread_self(), (reactor).m_threadId))
+
+/*****************************************************************************/
+static void AddCounters(dcgmTransportCounters_t &total, dcgmTransportCounters_t const &counters)
+{
+    total.messagesSent += counters.messagesSent;
+    total.messagesSentCompressed += counters.messagesSentCompressed;
+    total.bytesSent += counters.bytesSent;
+    total.uncompressedBytesSent += counters.uncompressedBytesSent;
+    total.messagesReceived += counters.messagesReceived;
+    total.bytesReceived += counters.bytesReceived;
+    total.uncompressedBytesReceived += counters.uncompressedBytesReceived;
+    total.compressUsec += counters.compressUsec;
+    total.decompressUsec += counters.decompressUsec;
+}
+
+/*****************************************************************************/
+static void AddSendQueueStats(dcgmSendQueueStats_t &total, dcgmSendQueueStats_t const &stats)
+{
+    total.queuedBytes += stats.queuedBytes;
+    total.maxQueuedBytes = std::max(total.maxQueuedBytes, stats.maxQueuedBytes);
+    total.heldMessages += stats.heldMessages;
+    total.highWatermarkHits += stats.highWatermarkHits;
+    total.messagesDropped += stats.messagesDropped;
+    total.messagesCoalesced += stats.messagesCoalesced;
+}
+
+/*****************************************************************************/
+/* Messages that only tell the peer about something newer and can be dropped or coalesced
+   if it falls behind. See DcgmIpcSendQueueParams_t */
+static bool IsNotification(unsigned int msgType)
+{
+    return msgType == DCGM_MSG_POLICY_NOTIFY || msgType == DCGM_MSG_ATTRIBUTE_GENERATION;
+}
+
+/*****************************************************************************/
+/* msgType of message, or of the message it wraps if it is a DCGM_MSG_MUX */
+static unsigned int CarriedMsgType(DcgmMessage &message)
+{
+    dcgm_msg_mux_t mux;
+
+    if (message.GetMsgType() != DCGM_MSG_MUX || message.GetMsgBytesPtr()->size() < sizeof(mux))
+    {
+        return message.GetMsgType();
+    }
+
+    memcpy(&mux, message.GetMsgBytesPtr()->data(), sizeof(mux));
+    return (unsigned int)mux.msgType;
+}
+
+/*****************************************************************************/
+static void WrapMuxMessage(DcgmMessage &message, unsigned int muxId)
+{
+    auto msgHdr   = message.GetMessageHdr();
+    auto msgBytes = message.GetMsgBytesPtr();
+
+    dcgm_msg_mux_t mux { muxId, msgHdr->msgType };
+    msgBytes->insert(msgBytes->begin(), (char *)&mux, (char *)&mux + sizeof(mux));
+    message.UpdateMsgHdr(DCGM_MSG_MUX, msgHdr->requestId, msgHdr->status, (int)msgBytes->size());
+}
+
+/*****************************************************************************/
+static dcgmReturn_t UnwrapMuxMessage(DcgmMessage &message, unsigned int &muxId)
+{
+    auto msgHdr   = message.GetMessageHdr();
+    auto msgBytes = message.GetMsgBytesPtr();
+
+    dcgm_msg_mux_t mux;
+    if (msgBytes->size() < sizeof(mux))
+    {
+        DCGM_LOG_ERROR << "Got a truncated DCGM_MSG_MUX of " << msgBytes->size() << " bytes";
+        return DCGM_ST_BADPARAM;
+    }
+
+    memcpy(&mux, msgBytes->data(), sizeof(mux));
+    if (mux.muxId == 0 || mux.msgType == DCGM_MSG_MUX || mux.msgType == DCGM_MSG_MUX_CLOSE)
+    {
+        DCGM_LOG_ERROR << "Got a bad DCGM_MSG_MUX of muxId " << mux.muxId << ", msgType 0x" << std::hex
+                       << mux.msgType;
+        return DCGM_ST_BADPARAM;
+    }
+
+    msgBytes->erase(msgBytes->begin(), msgBytes->begin() + sizeof(mux));
+    message.UpdateMsgHdr(mux.msgType, msgHdr->requestId, msgHdr->status, (int)msgBytes->size());
+    muxId = mux.muxId;
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************/
-DcgmIpc::DcgmIpc(int numWorkerThreads)
+static size_t MessageSize(DcgmMessage &message)
+{
+    return sizeof(dcgm_message_header_t) + message.GetLength();
+}
+
+/*****************************************************************************/
+DcgmIpc::DcgmIpc(int numWorkerThreads, bool workStealing)
     : DcgmThread(false, "dcgm_ipc")
-    , m_workersPool(numWorkerThreads)
+    , m_workersPool(workStealing ? 0 : numWorkerThreads)
 {
+    if (workStealing)
+    {
+        m_stealingPool = std::make_unique<DcgmNs::WorkStealingThreadPool>(numWorkerThreads);
+    }
+
     m_tcpParameters         = std::nullopt;
     m_domainParameters      = std::nullopt;
     m_tcpListenSocketFd     = -1;
     m_domainListenSocketFd  = -1;
     m_ipcThreadId           = 0; /* Any valid value is nonzero */
-    m_eventBase             = nullptr;
     m_dnsBase               = nullptr;
     m_processDisconnectData = nullptr;
     m_tcpListenEvent        = nullptr;
     m_domainListenEvent     = nullptr;
     m_processMessageData    = nullptr;
+    m_sendQueueParams       = {};
+    m_classifyMessageFunc   = nullptr;
+    m_classifyMessageData   = nullptr;
+}
+
+/*****************************************************************************/
+void DcgmIpc::SetSendQueueParams(DcgmIpcSendQueueParams_t const &params)
+{
+    m_sendQueueParams = params;
+}
+
+/*****************************************************************************/
+void DcgmIpc::SetWorkerLanes(std::vector<DcgmElasticWorkerPoolParams_t> const &lanes,
+                             DcgmIpcClassifyMessageFunc_f classifyMessageFunc,
+                             void *classifyMessageData)
+{
+    m_lanes.clear();
+    for (size_t i = 0; i < lanes.size(); i++)
+    {
+        m_lanes.push_back(std::make_unique<DcgmElasticWorkerPool>(lanes[i], "dcgm_lane" + std::to_string(i)));
+    }
+
+    m_classifyMessageFunc = std::move(classifyMessageFunc);
+    m_classifyMessageData = classifyMessageData;
+}
+
+/*****************************************************************************/
+void DcgmIpc::GetWorkerLaneStats(std::vector<DcgmElasticWorkerPoolParams_t> &params,
+                                 std::vector<DcgmElasticWorkerPoolStats_t> &stats)
+{
+    params.clear();
+    stats.clear();
+    for (auto &lane : m_lanes)
+    {
+        params.push_back(lane->GetParams());
+        stats.push_back(lane->GetStats());
+    }
+}
+
+/*****************************************************************************/
+unsigned int DcgmIpc::GetConnectionCount()
+{
+    unsigned int numConnections = 0;
+    for (auto &reactor : m_reactors)
+    {
+        numConnections += reactor->m_numConnections;
+    }
+    return numConnections;
+}
+
+/*****************************************************************************/
+DcgmIpcReactor::DcgmIpcReactor(DcgmIpc *ipc, unsigned int index)
+    : DcgmThread(false, "dcgm_ipc_" + std::to_string(index))
+    , m_ipc(ipc)
+    , m_index(index)
+    , m_eventBase(nullptr)
+    , m_threadId(0)
+{}
+
+/*****************************************************************************/
+DcgmIpcReactor::~DcgmIpcReactor()
+{
+    int st = StopAndWait(60000);
+    if (st)
+    {
+        DCGM_LOG_ERROR << "Killing DcgmIpcReactor thread " << m_index << " that is still running.";
+        Kill();
+    }
+
+    /* Connections free their bufferevents, so they have to go before the base */
+    ClearConnections();
+
+    if (m_eventBase)
+    {
+        event_base_free(m_eventBase);
+        m_eventBase = nullptr;
+    }
+}
+
+/*****************************************************************************/
+void DcgmIpcReactor::ClearConnections()
+{
+    m_bevToConnectionId.clear();
+    m_shmWakeFdToConnectionId.clear();
+    m_connections.clear();
+    m_numConnections = 0;
+}
+
+/*****************************************************************************/
+void DcgmIpcReactor::run()
+{
+    m_threadId = pthread_self();
+
+    DCGM_LOG_DEBUG << "reactor " << m_index << " starting event_base_loop()";
+
+    /* Run until we're told to stop */
+    event_base_loop(m_eventBase, EVLOOP_NO_EXIT_ON_EMPTY);
+
+    DCGM_LOG_DEBUG << "reactor " << m_index << " event_base_loop() ended. Closing connections.";
+
+    /* Clear out our structures from this thread since this thread owns them */
+    ClearConnections();
+}
+
+/*****************************************************************************/
+void DcgmIpcReactor::OnStop()
+{
+    if (m_eventBase)
+    {
+        event_base_loopexit(m_eventBase, nullptr);
+    }
 }
 
 /*****************************************************************************/
@@ -73,7 +285,8 @@ dcgmReturn_t DcgmIpc::Init(std::optional<DcgmIpcTcpServerParams_t> tcpParameters
                            DcgmIpcProcessMessageFunc_f processMessageFunc,
                            void *processMessageData,
                            DcgmIpcProcessDisconnectFunc_f processDisconnectFunc,
-                           void *processDisconnectData)
+                           void *processDisconnectData,
+                           unsigned int numReactors)
 {
     (void)evthread_use_pthreads();
 
@@ -84,11 +297,17 @@ dcgmReturn_t DcgmIpc::Init(std::optional<DcgmIpcTcpServerParams_t> tcpParameters
         event_enable_debug_logging(EVENT_DBG_ALL);
     }
 
-    m_eventBase = event_base_new();
-    if (m_eventBase == nullptr)
+    numReactors = std::max(numReactors, 1U);
+    for (unsigned int i = 0; i < numReactors; i++)
     {
-        DCGM_LOG_ERROR << "Failed to open event base";
-        return DCGM_ST_GENERIC_ERROR;
+        auto reactor         = std::make_unique<DcgmIpcReactor>(this, i);
+        reactor->m_eventBase = event_base_new();
+        if (reactor->m_eventBase == nullptr)
+        {
+            DCGM_LOG_ERROR << "Failed to open event base";
+            return DCGM_ST_GENERIC_ERROR;
+        }
+        m_reactors.push_back(std::move(reactor));
     }
 
 #if 1
@@ -96,7 +315,7 @@ dcgmReturn_t DcgmIpc::Init(std::optional<DcgmIpcTcpServerParams_t> tcpParameters
                             resolution was sync'd, and the caller
                             is blocked on our future anyway. */
 #else
-    m_dnsBase = evdns_base_new(m_eventBase, 0);
+    m_dnsBase = evdns_base_new(m_reactors[0]->m_eventBase, 0);
     if (m_dnsBase == nullptr)
     {
         DCGM_LOG_ERROR << "Failed to open DNS event base";
@@ -117,6 +336,18 @@ dcgmReturn_t DcgmIpc::Init(std::optional<DcgmIpcTcpServerParams_t> tcpParameters
 
     auto initFuture = m_initPromise.get_future();
 
+    /* The first reactor runs on our own thread below */
+    for (unsigned int i = 1; i < m_reactors.size(); i++)
+    {
+        if (m_reactors[i]->Start() != 0)
+        {
+            DCGM_LOG_ERROR << "Unable to start reactor " << i;
+            return DCGM_ST_GENERIC_ERROR;
+        }
+    }
+
+    DCGM_LOG_DEBUG << "Spreading connections over " << m_reactors.size() << " reactors";
+
     int st = Start();
     if (st != 0)
     {
@@ -154,17 +385,14 @@ DcgmIpc::~DcgmIpc()
         event_free(m_domainListenEvent);
     }
 
-    /* Free mpBase after any libevent workers are gone */
+    /* Free the bases after any libevent workers are gone. This stops the reactor threads
+       if Init() failed before we were started */
     if (m_dnsBase)
     {
         evdns_base_free(m_dnsBase, 1);
         m_dnsBase = nullptr;
     }
-    if (m_eventBase)
-    {
-        event_base_free(m_eventBase);
-        m_eventBase = nullptr;
-    }
+    m_reactors.clear();
 
     libevent_global_shutdown();
 }
@@ -174,7 +402,8 @@ void DcgmIpc::run()
 {
     dcgmReturn_t dcgmReturn;
 
-    m_ipcThreadId = pthread_self();
+    m_ipcThreadId              = pthread_self();
+    m_reactors[0]->m_threadId = m_ipcThreadId;
 
     ASSERT_IS_IPC_THREAD; /* Make sure the macro works */
 
@@ -202,13 +431,12 @@ void DcgmIpc::run()
     DCGM_LOG_DEBUG << "starting event_base_loop()";
 
     /* Run until we're told to stop */
-    event_base_loop(m_eventBase, EVLOOP_NO_EXIT_ON_EMPTY);
+    event_base_loop(m_reactors[0]->m_eventBase, EVLOOP_NO_EXIT_ON_EMPTY);
 
     DCGM_LOG_DEBUG << "event_base_loop() ended. Closing connections.";
 
-    /* Clear out our structures from this thread since this thread owns them */
-    m_bevToConnectionId.clear();
-    m_connections.clear();
+    /* Clear out the first reactor's structures from this thread since this thread owns them */
+    m_reactors[0]->ClearConnections();
 
     m_state = DCGM_IPC_STATE_STOPPED;
 
@@ -229,12 +457,30 @@ void DcgmIpc::OnStop()
 
     /* Stop the workers before we stop the event loop. The event loop can leak
        callbacks, but the worker pool queue won't leak */
+    for (auto &lane : m_lanes)
+    {
+        lane->StopAndWait();
+    }
     m_workersPool.StopAndWait();
+    if (m_stealingPool)
+    {
+        m_stealingPool->StopAndWait();
+    }
 
-    if (m_eventBase)
+    /* Reactors after the first close their connections on their own threads */
+    for (unsigned int i = 1; i < m_reactors.size(); i++)
+    {
+        if (m_reactors[i]->StopAndWait(60000))
+        {
+            DCGM_LOG_ERROR << "Killing DcgmIpcReactor thread " << i << " that is still running.";
+            m_reactors[i]->Kill();
+        }
+    }
+
+    if (!m_reactors.empty() && m_reactors[0]->m_eventBase)
     {
         DCGM_LOG_DEBUG << "Requesting loop exit";
-        event_base_loopexit(m_eventBase, nullptr);
+        event_base_loopexit(m_reactors[0]->m_eventBase, nullptr);
     }
 }
 
@@ -335,7 +581,8 @@ dcgmReturn_t DcgmIpc::InitTCPListenerSocket()
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    m_tcpListenEvent = event_new(m_eventBase, m_tcpListenSocketFd, EV_READ | EV_PERSIST, DcgmIpc::StaticOnAccept, this);
+    m_tcpListenEvent = event_new(
+        m_reactors[0]->m_eventBase, m_tcpListenSocketFd, EV_READ | EV_PERSIST, DcgmIpc::StaticOnAccept, this);
     if (m_tcpListenEvent == nullptr)
     {
         DCGM_LOG_ERROR << "event_new() failed for TCP listener";
@@ -416,8 +663,8 @@ dcgmReturn_t DcgmIpc::InitUnixListenerSocket()
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    m_domainListenEvent
-        = event_new(m_eventBase, m_domainListenSocketFd, EV_READ | EV_PERSIST, DcgmIpc::StaticOnAccept, this);
+    m_domainListenEvent = event_new(
+        m_reactors[0]->m_eventBase, m_domainListenSocketFd, EV_READ | EV_PERSIST, DcgmIpc::StaticOnAccept, this);
     if (m_domainListenEvent == nullptr)
     {
         DCGM_LOG_ERROR << "event_new() failed for domain listener";
@@ -438,12 +685,13 @@ dcgmReturn_t DcgmIpc::InitUnixListenerSocket()
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmIpc::AddConnection(struct bufferevent *bev,
+dcgmReturn_t DcgmIpc::AddConnection(DcgmIpcReactor &reactor,
+                                    struct bufferevent *bev,
                                     dcgm_connection_id_t connectionId,
                                     DcgmIpcConnectionState_t initialConnState,
                                     std::promise<dcgmReturn_t> &&connectPromise)
 {
-    ASSERT_IS_IPC_THREAD;
+    ASSERT_IS_REACTOR_THREAD(reactor);
 
     if (bev == nullptr || connectionId == DCGM_CONNECTION_ID_NONE)
     {
@@ -451,20 +699,25 @@ dcgmReturn_t DcgmIpc::AddConnection(struct bufferevent *bev,
         return DCGM_ST_BADPARAM;
     }
 
-    m_bevToConnectionId[bev]    = connectionId;
-    m_connections[connectionId] = std::make_unique<DcgmIpcConnection>(bev, initialConnState, std::move(connectPromise));
+    auto connection = std::make_unique<DcgmIpcConnection>(bev, initialConnState, std::move(connectPromise));
+    connection->SetSendQueueParams(m_sendQueueParams);
+
+    reactor.m_bevToConnectionId[bev]    = connectionId;
+    reactor.m_connections[connectionId] = std::move(connection);
+    reactor.m_numConnections            = reactor.m_connections.size();
 
-    DCGM_LOG_DEBUG << "Added connectionId " << connectionId << " bev " << bev << " ics " << initialConnState;
+    DCGM_LOG_DEBUG << "Added connectionId " << connectionId << " bev " << bev << " ics " << initialConnState
+                   << " to reactor " << reactor.m_index;
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmIpc::RemoveConnectionById(dcgm_connection_id_t connectionId)
+dcgmReturn_t DcgmIpc::RemoveConnectionById(DcgmIpcReactor &reactor, dcgm_connection_id_t connectionId)
 {
-    ASSERT_IS_IPC_THREAD;
+    ASSERT_IS_REACTOR_THREAD(reactor);
 
-    auto connectionIt = m_connections.find(connectionId);
-    if (connectionIt == m_connections.end())
+    auto connectionIt = reactor.m_connections.find(connectionId);
+    if (connectionIt == reactor.m_connections.end())
     {
         DCGM_LOG_DEBUG << "connectionId " << connectionId << " did not exist.";
         return DCGM_ST_NO_DATA;
@@ -472,7 +725,7 @@ dcgmReturn_t DcgmIpc::RemoveConnectionById(dcgm_connection_id_t connectionId)
 
     /* Now look up the bev (linear search) */
     struct bufferevent *bev = nullptr;
-    for (auto &bevIt : m_bevToConnectionId)
+    for (auto &bevIt : reactor.m_bevToConnectionId)
     {
         if (bevIt.second == connectionId)
         {
@@ -485,18 +738,19 @@ dcgmReturn_t DcgmIpc::RemoveConnectionById(dcgm_connection_id_t connectionId)
     {
         DCGM_LOG_ERROR << "bev -> connectionId did not exist but connectionId -> object did for connectionId "
                        << connectionId;
-        m_connections.erase(connectionIt);
+        reactor.m_connections.erase(connectionIt);
+        reactor.m_numConnections = reactor.m_connections.size();
         return DCGM_ST_GENERIC_ERROR;
     }
 
     /* Use the helper API since it calls callbacks */
-    return RemoveConnectionByBev(bev);
+    return RemoveConnectionByBev(reactor, bev);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmIpc::RemoveConnectionByBev(struct bufferevent *bev)
+dcgmReturn_t DcgmIpc::RemoveConnectionByBev(DcgmIpcReactor &reactor, struct bufferevent *bev)
 {
-    ASSERT_IS_IPC_THREAD;
+    ASSERT_IS_REACTOR_THREAD(reactor);
 
     if (bev == nullptr)
     {
@@ -504,8 +758,8 @@ dcgmReturn_t DcgmIpc::RemoveConnectionByBev(struct bufferevent *bev)
         return DCGM_ST_BADPARAM;
     }
 
-    auto conIdIt = m_bevToConnectionId.find(bev);
-    if (conIdIt == m_bevToConnectionId.end())
+    auto conIdIt = reactor.m_bevToConnectionId.find(bev);
+    if (conIdIt == reactor.m_bevToConnectionId.end())
     {
         DCGM_LOG_DEBUG << "bev " << bev << " was already gone.";
         return DCGM_ST_OK;
@@ -514,38 +768,59 @@ dcgmReturn_t DcgmIpc::RemoveConnectionByBev(struct bufferevent *bev)
     /* Save the connectionId for our callback later */
     dcgm_connection_id_t connectionId = conIdIt->second;
 
-    auto connectionIt = m_connections.find(connectionId);
-    if (connectionIt == m_connections.end())
+    auto connectionIt = reactor.m_connections.find(connectionId);
+    if (connectionIt == reactor.m_connections.end())
     {
         DCGM_LOG_DEBUG << "m_connections entry missing for connectionId " << connectionId << " bev " << bev;
-        m_bevToConnectionId.erase(conIdIt);
+        reactor.m_bevToConnectionId.erase(conIdIt);
         return DCGM_ST_OK;
     }
 
     /* Found both. Erase them */
     DCGM_LOG_DEBUG << "Removing bev " << bev << ", connectionId " << connectionId;
-    m_bevToConnectionId.erase(conIdIt);
-    m_connections.erase(connectionIt);
+    if (connectionIt->second->GetShmChannel() != nullptr)
+    {
+        reactor.m_shmWakeFdToConnectionId.erase(connectionIt->second->GetShmChannel()->GetWakeFd());
+    }
+    DcgmIpcConnectionStats_t closedStats = connectionIt->second->GetStats();
+    closedStats.sendQueue.queuedBytes    = 0; /* Nothing of it waits anymore */
+    closedStats.sendQueue.heldMessages   = 0;
+    AddCounters(reactor.m_closedConnectionCounters, closedStats.counters);
+    AddSendQueueStats(reactor.m_closedSendQueueStats, closedStats.sendQueue);
+    reactor.m_bevToConnectionId.erase(conIdIt);
+    reactor.m_connections.erase(connectionIt);
+    reactor.m_numConnections = reactor.m_connections.size();
+
+    /* Notify our parent that we got a disconnect, including of the logical connections that shared it */
+    for (dcgm_connection_id_t muxConnectionId : RemoveMuxConnections(connectionId))
+    {
+        EnqueueProcessDisconnect(muxConnectionId);
+    }
+    EnqueueProcessDisconnect(connectionId);
+    return DCGM_ST_OK;
+}
 
-    /* Notify our parent that we got a disconnect */
+/*****************************************************************************/
+void DcgmIpc::EnqueueProcessDisconnect(dcgm_connection_id_t connectionId)
+{
     DcgmIpcProcessDisconnect_t pd {};
     pd.connectionId      = connectionId;
     pd.processDisconnect = m_processDisconnectFunc;
     pd.userData          = m_processDisconnectData;
 
-    m_workersPool.Enqueue([pd]() mutable { DcgmIpc::ProcessDisconnectInPool(pd); });
-    return DCGM_ST_OK;
+    EnqueueOnWorkers([pd]() mutable { DcgmIpc::ProcessDisconnectInPool(pd); });
 }
 
 /*****************************************************************************/
 void DcgmIpc::ConnectTcpAsyncImpl(DcgmIpcConnectTcp &tcpConnect)
 {
-    ASSERT_IS_IPC_THREAD;
+    DcgmIpcReactor &reactor = ReactorOf(tcpConnect.m_connectionId);
+    ASSERT_IS_REACTOR_THREAD(reactor);
 
     /* TCP/IP */
     DCGM_LOG_DEBUG << "Client trying to connect to " << tcpConnect.m_hostname << ":" << tcpConnect.m_port;
 
-    struct bufferevent *bev = bufferevent_socket_new(m_eventBase, -1, BEV_OPT_CLOSE_ON_FREE);
+    struct bufferevent *bev = bufferevent_socket_new(reactor.m_eventBase, -1, BEV_OPT_CLOSE_ON_FREE);
     if (bev == nullptr)
     {
         DCGM_LOG_ERROR << "Failed to create socket";
@@ -554,8 +829,8 @@ void DcgmIpc::ConnectTcpAsyncImpl(DcgmIpcConnectTcp &tcpConnect)
     }
 
     /* Add a tracked connection and remove our pending status */
-    dcgmReturn_t dcgmReturn
-        = AddConnection(bev, tcpConnect.m_connectionId, DCGM_IPC_CS_PENDING, std::move(tcpConnect.m_promise));
+    dcgmReturn_t dcgmReturn = AddConnection(
+        reactor, bev, tcpConnect.m_connectionId, DCGM_IPC_CS_PENDING, std::move(tcpConnect.m_promise));
     if (dcgmReturn != DCGM_ST_OK)
     {
         DCGM_LOG_ERROR << "Failed to AddConnection";
@@ -565,14 +840,14 @@ void DcgmIpc::ConnectTcpAsyncImpl(DcgmIpcConnectTcp &tcpConnect)
     }
 
     /* Track our event before callbacks could be invoked */
-    bufferevent_setcb(bev, DcgmIpc::StaticReadCB, NULL, DcgmIpc::StaticEventCB, this);
+    bufferevent_setcb(bev, DcgmIpc::StaticReadCB, GetWriteCB(), DcgmIpc::StaticEventCB, &reactor);
     bufferevent_enable(bev, EV_READ | EV_WRITE);
 
     int ret = bufferevent_socket_connect_hostname(
         bev, m_dnsBase, AF_INET, tcpConnect.m_hostname.c_str(), tcpConnect.m_port);
     if (0 != ret)
     {
-        RemoveConnectionByBev(bev);
+        RemoveConnectionByBev(reactor, bev);
         DCGM_LOG_ERROR << "Failed to connect to Host engine running at IP " << tcpConnect.m_hostname << " port "
                        << tcpConnect.m_port;
         return;
@@ -595,7 +870,9 @@ void DcgmIpc::ConnectTcpAsyncImplCB(evutil_socket_t, short, void *data)
 dcgmReturn_t DcgmIpc::ConnectTcp(std::string hostname,
                                  int port,
                                  dcgm_connection_id_t &connectionId,
-                                 unsigned int timeoutMs)
+                                 unsigned int timeoutMs,
+                                 unsigned int compression,
+                                 unsigned int compressionThreshold)
 {
     connectionId = GetNextConnectionId();
 
@@ -605,14 +882,105 @@ dcgmReturn_t DcgmIpc::ConnectTcp(std::string hostname,
 
     std::future<dcgmReturn_t> connectReturn = connectTcp->m_promise.get_future();
 
-    int st = event_base_once(m_eventBase, -1, EV_TIMEOUT, DcgmIpc::ConnectTcpAsyncImplCB, connectTcp, 0);
+    int st = event_base_once(
+        ReactorOf(connectionId).m_eventBase, -1, EV_TIMEOUT, DcgmIpc::ConnectTcpAsyncImplCB, connectTcp, 0);
     if (st)
     {
         DCGM_LOG_ERROR << "Got error " << st << " from event_base_once";
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    return WaitForConnectHelper(connectionId, connectReturn, timeoutMs);
+    dcgmReturn_t dcgmReturn = WaitForConnectHelper(connectionId, connectReturn, timeoutMs);
+    if (dcgmReturn != DCGM_ST_OK || compression == DCGM_TRANSPORT_COMPRESSION_NONE)
+        return dcgmReturn;
+
+    /* The connection works either way. Compression is only an optimization */
+    dcgmReturn = SetupCompression(connectionId, compression, compressionThreshold, timeoutMs);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_WARNING << "connectionId " << connectionId << " will not be compressed: " << errorString(dcgmReturn);
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmIpc::SetupCompressionImpl(DcgmIpcSetupCompression &setupCompression)
+{
+    DcgmIpcReactor &reactor = ReactorOf(setupCompression.m_connectionId);
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    DcgmIpcConnection *connection = ConnectionIdToPtr(reactor, setupCompression.m_connectionId);
+    if (connection == nullptr)
+    {
+        setupCompression.m_promise.set_value(DCGM_ST_CONNECTION_NOT_VALID);
+        return;
+    }
+
+    if (connection->IsAwaitingCompressionSetup())
+    {
+        setupCompression.m_promise.set_value(DCGM_ST_IN_USE);
+        return;
+    }
+
+    auto request = std::make_unique<DcgmMessage>();
+    request->UpdateMsgHdr(
+        DCGM_MSG_COMPRESSION_SETUP, DCGM_REQUEST_ID_NONE, DCGM_ST_OK, (int)sizeof(setupCompression.m_setup));
+    request->GetMsgBytesPtr()->assign((char const *)&setupCompression.m_setup,
+                                      (char const *)&setupCompression.m_setup + sizeof(setupCompression.m_setup));
+
+    dcgmReturn_t dcgmReturn = connection->SendMessage(std::move(request));
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        setupCompression.m_promise.set_value(dcgmReturn);
+        return;
+    }
+
+    /* ReadCB hands the reply to the connection, which sets the promise */
+    connection->AwaitCompressionSetup(std::move(setupCompression.m_promise));
+}
+
+/*****************************************************************************/
+void DcgmIpc::SetupCompressionImplCB(evutil_socket_t, short, void *data)
+{
+    std::unique_ptr<DcgmIpcSetupCompression> setupCompression((DcgmIpcSetupCompression *)data);
+
+    setupCompression->m_ipc->SetupCompressionImpl(*setupCompression);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpc::SetupCompression(dcgm_connection_id_t connectionId,
+                                       unsigned int compression,
+                                       unsigned int compressionThreshold,
+                                       unsigned int timeoutMs)
+{
+    dcgm_msg_compression_setup_t setup {};
+    setup.version   = dcgm_msg_compression_setup_version;
+    setup.algorithm = compression;
+    setup.threshold = compressionThreshold;
+
+    /* Using new here because we're transferring it through a C callback */
+    DcgmIpcSetupCompression *setupCompression = new DcgmIpcSetupCompression(this, connectionId, setup);
+
+    std::future<dcgmReturn_t> setupReturn = setupCompression->m_promise.get_future();
+
+    int st = event_base_once(
+        ReactorOf(connectionId).m_eventBase, -1, EV_TIMEOUT, DcgmIpc::SetupCompressionImplCB, setupCompression, 0);
+    if (st)
+    {
+        DCGM_LOG_ERROR << "Got error " << st << " from event_base_once";
+        delete setupCompression;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    /* Host engines that predate DCGM_MSG_COMPRESSION_SETUP never answer it. Messages
+       stay uncompressed until an answer arrives, so giving up here is safe */
+    if (setupReturn.wait_for(std::chrono::milliseconds(timeoutMs)) != std::future_status::ready)
+    {
+        return DCGM_ST_TIMEOUT;
+    }
+
+    return setupReturn.get();
 }
 
 /*****************************************************************************/
@@ -637,22 +1005,34 @@ dcgmReturn_t DcgmIpc::WaitForConnectHelper(dcgm_connection_id_t connectionId,
 /*****************************************************************************/
 void DcgmIpc::ConnectDomainAsyncImpl(DcgmIpcConnectDomain &domainConnect)
 {
-    ASSERT_IS_IPC_THREAD;
+    DcgmIpcReactor &reactor = ReactorOf(domainConnect.m_connectionId);
+    ASSERT_IS_REACTOR_THREAD(reactor);
 
     /* Domain socket */
     DCGM_LOG_DEBUG << "Client trying to connect to " << domainConnect.m_path;
 
-    struct bufferevent *bev = bufferevent_socket_new(m_eventBase, -1, BEV_OPT_CLOSE_ON_FREE);
+    if (domainConnect.m_fd >= 0 && SetNonBlocking(domainConnect.m_fd))
+    {
+        close(domainConnect.m_fd);
+        domainConnect.m_promise.set_value(DCGM_ST_GENERIC_ERROR);
+        return;
+    }
+
+    struct bufferevent *bev = bufferevent_socket_new(reactor.m_eventBase, domainConnect.m_fd, BEV_OPT_CLOSE_ON_FREE);
     if (bev == nullptr)
     {
         DCGM_LOG_ERROR << "Failed to create socket";
+        if (domainConnect.m_fd >= 0)
+        {
+            close(domainConnect.m_fd);
+        }
         domainConnect.m_promise.set_value(DCGM_ST_GENERIC_ERROR);
         return;
     }
 
     /* Add a tracked connection and remove our pending status */
-    dcgmReturn_t dcgmReturn
-        = AddConnection(bev, domainConnect.m_connectionId, DCGM_IPC_CS_PENDING, std::move(domainConnect.m_promise));
+    dcgmReturn_t dcgmReturn = AddConnection(
+        reactor, bev, domainConnect.m_connectionId, DCGM_IPC_CS_PENDING, std::move(domainConnect.m_promise));
     if (dcgmReturn != DCGM_ST_OK)
     {
         DCGM_LOG_ERROR << "Failed to AddConnection";
@@ -662,9 +1042,27 @@ void DcgmIpc::ConnectDomainAsyncImpl(DcgmIpcConnectDomain &domainConnect)
     }
 
     /* Track our event before callbacks could be invoked */
-    bufferevent_setcb(bev, DcgmIpc::StaticReadCB, NULL, DcgmIpc::StaticEventCB, this);
+    bufferevent_setcb(bev, DcgmIpc::StaticReadCB, GetWriteCB(), DcgmIpc::StaticEventCB, &reactor);
     bufferevent_enable(bev, EV_READ | EV_WRITE);
 
+    if (domainConnect.m_fd >= 0)
+    {
+        /* Already connected by ConnectDomain(), which also set up the shared-memory channel */
+        DcgmIpcConnection *connection = ConnectionIdToPtr(reactor, domainConnect.m_connectionId);
+        dcgmReturn                    = AttachShmChannel(
+            reactor, domainConnect.m_connectionId, connection, std::move(domainConnect.m_shmChannel));
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            RemoveConnectionByBev(reactor, bev); /* Fails the connect promise */
+            return;
+        }
+
+        SetConnectionState(reactor, domainConnect.m_connectionId, DCGM_IPC_CS_ACTIVE);
+        DCGM_LOG_DEBUG << "connectionId " << domainConnect.m_connectionId << " connected to " << domainConnect.m_path
+                       << " over shared memory";
+        return;
+    }
+
     struct sockaddr_un unixDomainAddr; /* Unix domain socket address used for specifying connection details */
     memset(&unixDomainAddr, 0, sizeof(unixDomainAddr));
     unixDomainAddr.sun_family = AF_UNIX;
@@ -673,7 +1071,7 @@ void DcgmIpc::ConnectDomainAsyncImpl(DcgmIpcConnectDomain &domainConnect)
     int ret = bufferevent_socket_connect(bev, (struct sockaddr *)&unixDomainAddr, sizeof(unixDomainAddr));
     if (0 != ret)
     {
-        RemoveConnectionByBev(bev);
+        RemoveConnectionByBev(reactor, bev);
         DCGM_LOG_ERROR << "Failed to connect to Host engine running at IP " << domainConnect.m_path;
         return;
     }
@@ -692,45 +1090,198 @@ void DcgmIpc::ConnectDomainAsyncImplCB(evutil_socket_t, short, void *data)
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmIpc::ConnectDomain(std::string path, dcgm_connection_id_t &connectionId, unsigned int timeoutMs)
+/*
+ * Client side of DCGM_MSG_SHM_SETUP. This is done with blocking calls before the
+ * socket is handed to libevent, since a bufferevent would drop the fds that come
+ * with the reply.
+ *
+ * On success, socketFd is a connected socket and shmChannel is attached to the
+ * channel the server created for it.
+ */
+static dcgmReturn_t DcgmIpcShmHandshake(std::string const &path,
+                                        unsigned int timeoutMs,
+                                        int &socketFd,
+                                        std::unique_ptr<DcgmIpcShmChannel> &shmChannel)
 {
-    connectionId = GetNextConnectionId();
-
-    /* Using new here because we're transferring it through a C callback. The callback will
-       assign this to a unique_ptr and then free it automatically */
-    DcgmIpcConnectDomain *connectDomain = new DcgmIpcConnectDomain(this, path, connectionId);
-
-    std::future<dcgmReturn_t> connectReturn = connectDomain->m_promise.get_future();
+    struct sockaddr_un unixDomainAddr;
+    memset(&unixDomainAddr, 0, sizeof(unixDomainAddr));
+    unixDomainAddr.sun_family = AF_UNIX;
+    strncpy(unixDomainAddr.sun_path, path.c_str(), sizeof(unixDomainAddr.sun_path) - 1);
 
-    int st = event_base_once(m_eventBase, -1, EV_TIMEOUT, DcgmIpc::ConnectDomainAsyncImplCB, connectDomain, 0);
-    if (st)
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
     {
-        DCGM_LOG_ERROR << "Got error " << st << " from event_base_once";
+        DCGM_LOG_ERROR << "socket creation failed. errno " << errno;
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    return WaitForConnectHelper(connectionId, connectReturn, timeoutMs);
-}
+    /* Bound every blocking call below, including waiting on a server that doesn't know DCGM_MSG_SHM_SETUP */
+    struct timeval timeout;
+    timeout.tv_sec  = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
 
-/*****************************************************************************/
-dcgm_connection_id_t DcgmIpc::GetNextConnectionId()
-{
-    dcgm_connection_id_t newId = m_connectionId++;
+    if (connect(fd, (struct sockaddr *)&unixDomainAddr, sizeof(unixDomainAddr)) != 0)
+    {
+        DCGM_LOG_DEBUG << "connect to " << path << " failed. errno " << errno;
+        close(fd);
+        return DCGM_ST_CONNECTION_NOT_VALID;
+    }
 
-    /* Don't allocate a connection as id DCGM_CONNECTION_ID_NONE. In practice,
-       this will only happen after 2^32 connections */
-    if (newId == DCGM_CONNECTION_ID_NONE)
+    dcgm_message_header_t request {};
+    request.msgId   = DCGM_PROTO_MAGIC;
+    request.msgType = DCGM_MSG_SHM_SETUP;
+    request.status  = DCGM_ST_OK;
+    if (send(fd, &request, sizeof(request), MSG_NOSIGNAL) != (ssize_t)sizeof(request))
     {
-        newId = m_connectionId++;
+        DCGM_LOG_ERROR << "Unable to send the shared-memory setup request. errno " << errno;
+        close(fd);
+        return DCGM_ST_CONNECTION_NOT_VALID;
     }
 
-    return newId;
-}
+    struct
+    {
+        dcgm_message_header_t header;
+        dcgm_msg_shm_setup_t setup;
+    } __attribute__((packed)) reply {};
+    struct iovec iov = { &reply, sizeof(reply) };
+    union
+    {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int) * DCGM_IPC_SHM_NUM_FDS)];
+    } control {};
+    struct msghdr msg {};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t numBytes = recvmsg(fd, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC);
+
+    int fds[DCGM_IPC_SHM_NUM_FDS] = { -1, -1, -1 };
+    int numFds                    = 0;
+    struct cmsghdr *cmsg          = CMSG_FIRSTHDR(&msg);
+    if (numBytes > 0 && cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+    {
+        numFds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        memcpy(fds, CMSG_DATA(cmsg), std::min(numFds, DCGM_IPC_SHM_NUM_FDS) * sizeof(int));
+    }
+
+    dcgmReturn_t dcgmReturn = DCGM_ST_OK;
+    if (numBytes != (ssize_t)sizeof(reply))
+    {
+        DCGM_LOG_WARNING << "No shared-memory setup reply from " << path << ". errno " << errno;
+        dcgmReturn = DCGM_ST_CONNECTION_NOT_VALID;
+    }
+    else if (reply.header.msgId != DCGM_PROTO_MAGIC || reply.header.msgType != DCGM_MSG_SHM_SETUP
+             || reply.header.length != sizeof(reply.setup))
+    {
+        DCGM_LOG_ERROR << "Unexpected shared-memory setup reply msgType 0x" << std::hex << reply.header.msgType;
+        dcgmReturn = DCGM_ST_CONNECTION_NOT_VALID;
+    }
+    else if (reply.header.status != DCGM_ST_OK)
+    {
+        DCGM_LOG_WARNING << "Server declined the shared-memory channel: " << errorString((dcgmReturn_t)reply.header.status);
+        dcgmReturn = (dcgmReturn_t)reply.header.status;
+    }
+    else if (numFds != DCGM_IPC_SHM_NUM_FDS || (msg.msg_flags & MSG_CTRUNC))
+    {
+        DCGM_LOG_ERROR << "Got " << numFds << " fds with the shared-memory setup reply";
+        dcgmReturn = DCGM_ST_CONNECTION_NOT_VALID;
+    }
+
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        for (int i = 0; i < std::min(numFds, DCGM_IPC_SHM_NUM_FDS); i++)
+        {
+            close(fds[i]);
+        }
+        close(fd);
+        return dcgmReturn;
+    }
+
+    shmChannel = std::make_unique<DcgmIpcShmChannel>();
+    dcgmReturn = shmChannel->Attach(fds, reply.setup.ringSize);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        shmChannel.reset();
+        close(fd);
+        return dcgmReturn;
+    }
+
+    socketFd = fd;
+    return DCGM_ST_OK;
+}
 
 /*****************************************************************************/
-void DcgmIpc::EventCB(struct bufferevent *bev, short events)
+dcgmReturn_t DcgmIpc::ConnectDomain(std::string path,
+                                    dcgm_connection_id_t &connectionId,
+                                    unsigned int timeoutMs,
+                                    bool useSharedMemory)
 {
-    dcgm_connection_id_t connectionId = BevToConnectionId(bev);
+    int socketFd = -1;
+    std::unique_ptr<DcgmIpcShmChannel> shmChannel;
+
+    if (useSharedMemory)
+    {
+        dcgmReturn_t dcgmReturn = DcgmIpcShmHandshake(path, timeoutMs, socketFd, shmChannel);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_WARNING << "Unable to set up shared memory with " << path << ": " << errorString(dcgmReturn)
+                             << ". Using the domain socket.";
+        }
+    }
+
+    connectionId = GetNextConnectionId();
+
+    /* Using new here because we're transferring it through a C callback. The callback will
+       assign this to a unique_ptr and then free it automatically */
+    DcgmIpcConnectDomain *connectDomain = new DcgmIpcConnectDomain(this, path, connectionId);
+    connectDomain->m_fd                 = socketFd;
+    connectDomain->m_shmChannel         = std::move(shmChannel);
+
+    std::future<dcgmReturn_t> connectReturn = connectDomain->m_promise.get_future();
+
+    int st = event_base_once(
+        ReactorOf(connectionId).m_eventBase, -1, EV_TIMEOUT, DcgmIpc::ConnectDomainAsyncImplCB, connectDomain, 0);
+    if (st)
+    {
+        DCGM_LOG_ERROR << "Got error " << st << " from event_base_once";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return WaitForConnectHelper(connectionId, connectReturn, timeoutMs);
+}
+
+/*****************************************************************************/
+dcgm_connection_id_t DcgmIpc::GetNextConnectionId()
+{
+    dcgm_connection_id_t newId = m_connectionId++;
+
+    /* Don't allocate a connection as id DCGM_CONNECTION_ID_NONE. In practice,
+       this will only happen after 2^32 connections */
+    if (newId == DCGM_CONNECTION_ID_NONE)
+    {
+        newId = m_connectionId++;
+    }
+
+    return newId;
+}
+
+/*****************************************************************************/
+DcgmIpcReactor &DcgmIpc::ReactorOf(dcgm_connection_id_t connectionId)
+{
+    /* Connection IDs are handed out in sequence, so this spreads connections round-robin */
+    return *m_reactors[connectionId % m_reactors.size()];
+}
+
+/*****************************************************************************/
+void DcgmIpc::EventCB(DcgmIpcReactor &reactor, struct bufferevent *bev, short events)
+{
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    dcgm_connection_id_t connectionId = BevToConnectionId(reactor, bev);
     if (connectionId == DCGM_CONNECTION_ID_NONE)
     {
         DCGM_LOG_ERROR << "Unknown bev " << bev << " got events x" << std::hex << events;
@@ -743,36 +1294,64 @@ void DcgmIpc::EventCB(struct bufferevent *bev, short events)
     {
         /* Connected */
         DCGM_LOG_DEBUG << "Got connected event for connectionId " << connectionId << " bev " << bev;
-        SetConnectionState(connectionId, DCGM_IPC_CS_ACTIVE);
+        SetConnectionState(reactor, connectionId, DCGM_IPC_CS_ACTIVE);
     }
     else if ((events & BEV_EVENT_ERROR) || (events & BEV_EVENT_EOF))
     {
         DCGM_LOG_DEBUG << "Got connection error for bev " << bev << " connectionId " << connectionId << " events "
                        << std::hex << events;
-        RemoveConnectionByBev(bev);
+        RemoveConnectionByBev(reactor, bev);
     }
 }
 
 /*****************************************************************************/
 void DcgmIpc::StaticEventCB(struct bufferevent *bev, short events, void *ptr)
 {
-    DcgmIpc *dcgmIpc = (DcgmIpc *)ptr;
-    dcgmIpc->EventCB(bev, events);
+    DcgmIpcReactor *reactor = (DcgmIpcReactor *)ptr;
+    reactor->m_ipc->EventCB(*reactor, bev, events);
 }
 
 /*****************************************************************************/
 void DcgmIpc::StaticReadCB(struct bufferevent *bev, void *ptr)
 {
-    DcgmIpc *dcgmIpc = (DcgmIpc *)ptr;
-    dcgmIpc->ReadCB(bev);
+    DcgmIpcReactor *reactor = (DcgmIpcReactor *)ptr;
+    reactor->m_ipc->ReadCB(*reactor, bev);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmIpc::SetConnectionState(dcgm_connection_id_t connectionId, DcgmIpcConnectionState_t state)
+void DcgmIpc::StaticWriteCB(struct bufferevent *bev, void *ptr)
 {
-    ASSERT_IS_IPC_THREAD;
+    DcgmIpcReactor *reactor = (DcgmIpcReactor *)ptr;
+    reactor->m_ipc->WriteCB(*reactor, bev);
+}
+
+/*****************************************************************************/
+bufferevent_data_cb DcgmIpc::GetWriteCB()
+{
+    /* Drained output only matters if messages can be held back */
+    return m_sendQueueParams.highWatermark > 0 ? DcgmIpc::StaticWriteCB : nullptr;
+}
+
+/*****************************************************************************/
+void DcgmIpc::WriteCB(DcgmIpcReactor &reactor, bufferevent *bev)
+{
+    ASSERT_IS_REACTOR_THREAD(reactor);
 
-    DcgmIpcConnection *connection = ConnectionIdToPtr(connectionId);
+    DcgmIpcConnection *connection = ConnectionIdToPtr(reactor, BevToConnectionId(reactor, bev));
+    if (connection != nullptr)
+    {
+        connection->FlushHeldMessages();
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpc::SetConnectionState(DcgmIpcReactor &reactor,
+                                         dcgm_connection_id_t connectionId,
+                                         DcgmIpcConnectionState_t state)
+{
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    DcgmIpcConnection *connection = ConnectionIdToPtr(reactor, connectionId);
     if (connection == nullptr)
     {
         DCGM_LOG_ERROR << "SetConnectionState got unknown connectionId " << connectionId;
@@ -798,10 +1377,10 @@ void DcgmIpc::ProcessDisconnectInPool(DcgmIpcProcessDisconnect_t &processMe)
 }
 
 /*****************************************************************************/
-DcgmIpcConnection *DcgmIpc::ConnectionIdToPtr(dcgm_connection_id_t connectionId)
+DcgmIpcConnection *DcgmIpc::ConnectionIdToPtr(DcgmIpcReactor &reactor, dcgm_connection_id_t connectionId)
 {
-    auto connectionIt = m_connections.find(connectionId);
-    if (connectionIt == m_connections.end())
+    auto connectionIt = reactor.m_connections.find(connectionId);
+    if (connectionIt == reactor.m_connections.end())
     {
         DCGM_LOG_DEBUG << "Unknown connectionId " << connectionId;
         return nullptr;
@@ -813,16 +1392,18 @@ DcgmIpcConnection *DcgmIpc::ConnectionIdToPtr(dcgm_connection_id_t connectionId)
 }
 
 /*****************************************************************************/
-void DcgmIpc::ReadCB(bufferevent *bev)
+void DcgmIpc::ReadCB(DcgmIpcReactor &reactor, bufferevent *bev)
 {
-    dcgm_connection_id_t connectionId = BevToConnectionId(bev);
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    dcgm_connection_id_t connectionId = BevToConnectionId(reactor, bev);
     if (connectionId == DCGM_CONNECTION_ID_NONE)
     {
         DCGM_LOG_ERROR << "Unknown bev " << bev << " got ReadCB";
         return;
     }
 
-    DcgmIpcConnection *connection = ConnectionIdToPtr(connectionId);
+    DcgmIpcConnection *connection = ConnectionIdToPtr(reactor, connectionId);
     if (connection == nullptr)
     {
         DCGM_LOG_ERROR << "Unknown connectionId " << connectionId << " got ReadCB for bev " << bev;
@@ -842,29 +1423,527 @@ void DcgmIpc::ReadCB(bufferevent *bev)
     {
         DCGM_LOG_ERROR << "Got error " << errorString(dcgmReturn) << " from ReadMessages";
         /* Assume the connection is broken */
-        RemoveConnectionByBev(bev);
+        RemoveConnectionByBev(reactor, bev);
         return;
     }
 
+    /* Shared-memory setup is handled here since it needs the socket. Only servers offer it */
+    if (messages.front()->GetMsgType() == DCGM_MSG_SHM_SETUP && m_domainParameters.has_value())
+    {
+        SetupShmChannel(reactor, bev, connection, *messages.front());
+        messages.erase(messages.begin());
+    }
+
+    /* So is compression setup, since it changes how the connection writes */
+    for (auto it = messages.begin(); it != messages.end();)
+    {
+        if ((*it)->GetMsgType() == DCGM_MSG_COMPRESSION_SETUP)
+        {
+            OnCompressionSetup(connectionId, connection, **it);
+            it = messages.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    DispatchMessages(connectionId, messages);
+}
+
+/*****************************************************************************/
+void DcgmIpc::DispatchMessages(dcgm_connection_id_t connectionId, std::vector<std::unique_ptr<DcgmMessage>> &messages)
+{
     DcgmIpcProcessMessage_t processMessage {};
 
-    processMessage.connectionId   = connectionId;
     processMessage.processMessage = m_processMessageFunc;
     processMessage.userData       = m_processMessageData;
 
+    auto const receivedTime = std::chrono::steady_clock::now();
+
     for (auto &&dcgmMessage : messages)
     {
-        processMessage.dcgmMessage = dcgmMessage.release();
-
-        m_workersPool.Enqueue([processMessage]() mutable { DcgmIpc::ProcessMessageInPool(processMessage); });
+        processMessage.connectionId = connectionId;
+
+        if (dcgmMessage->GetMsgType() == DCGM_MSG_MUX)
+        {
+            processMessage.connectionId = DemuxMessage(connectionId, *dcgmMessage);
+            if (processMessage.connectionId == DCGM_CONNECTION_ID_NONE)
+            {
+                continue;
+            }
+        }
+        else if (dcgmMessage->GetMsgType() == DCGM_MSG_MUX_CLOSE)
+        {
+            OnMuxClose(connectionId, *dcgmMessage);
+            continue;
+        }
+
+        dcgmMessage->SetReceivedTime(receivedTime);
+
+        DcgmElasticWorkerPool *lane = nullptr;
+        if (!m_lanes.empty() && m_classifyMessageFunc)
+        {
+            unsigned int laneIndex = m_classifyMessageFunc(*dcgmMessage, m_classifyMessageData);
+            if (laneIndex < m_lanes.size())
+            {
+                lane = m_lanes[laneIndex].get();
+            }
+        }
+
+        processMessage.dcgmMessage = dcgmMessage.release();
+
+        if (lane != nullptr)
+        {
+            lane->Enqueue([processMessage]() mutable { DcgmIpc::ProcessMessageInPool(processMessage); });
+        }
+        else
+        {
+            EnqueueOnWorkers([processMessage]() mutable { DcgmIpc::ProcessMessageInPool(processMessage); });
+        }
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpc::OpenMuxConnection(dcgm_connection_id_t carrierId, dcgm_connection_id_t &connectionId)
+{
+    DcgmIpcMuxConnection_t mux;
+    if (FindMuxConnection(carrierId, mux))
+    {
+        carrierId = mux.carrierId;
+    }
+
+    DcgmIpcConnectionStats_t carrierStats {};
+    if (GetConnectionStats(carrierId, carrierStats) != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Can't share unknown connectionId " << carrierId;
+        return DCGM_ST_CONNECTION_NOT_VALID;
+    }
+
+    mux.carrierId = carrierId;
+    mux.muxId     = ++m_muxId;
+    if (mux.muxId == 0)
+    {
+        mux.muxId = ++m_muxId; /* 0 is never a muxId */
+    }
+
+    std::lock_guard<std::mutex> lock(m_muxMutex);
+
+    auto &carried = m_muxByCarrier[carrierId];
+    if (carried.size() >= DCGM_IPC_MAX_MUX_CONNECTIONS)
+    {
+        DCGM_LOG_ERROR << "connectionId " << carrierId << " already carries " << carried.size()
+                       << " logical connections";
+        return DCGM_ST_MAX_LIMIT;
+    }
+
+    connectionId                   = GetNextConnectionId();
+    carried[mux.muxId]             = connectionId;
+    m_muxConnections[connectionId] = mux;
+    m_numMuxConnections            = m_muxConnections.size();
+
+    DCGM_LOG_DEBUG << "Opened connectionId " << connectionId << " as muxId " << mux.muxId << " of connectionId "
+                   << carrierId;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+bool DcgmIpc::FindMuxConnection(dcgm_connection_id_t connectionId, DcgmIpcMuxConnection_t &mux)
+{
+    /* Most processes never multiplex. Spare their sends the lock */
+    if (m_numMuxConnections == 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_muxMutex);
+
+    auto muxIt = m_muxConnections.find(connectionId);
+    if (muxIt == m_muxConnections.end())
+    {
+        return false;
+    }
+
+    mux = muxIt->second;
+    return true;
+}
+
+/*****************************************************************************/
+dcgm_connection_id_t DcgmIpc::DemuxMessage(dcgm_connection_id_t carrierId, DcgmMessage &message)
+{
+    unsigned int muxId = 0;
+    if (UnwrapMuxMessage(message, muxId) != DCGM_ST_OK)
+    {
+        return DCGM_CONNECTION_ID_NONE;
+    }
+
+    std::unique_lock<std::mutex> lock(m_muxMutex);
+
+    auto &carried = m_muxByCarrier[carrierId];
+    auto muxIt    = carried.find(muxId);
+    if (muxIt != carried.end())
+    {
+        return muxIt->second;
+    }
+
+    if (!m_tcpParameters.has_value() && !m_domainParameters.has_value())
+    {
+        /* Clients only hear back on logical connections they opened. This one was closed since */
+        DCGM_LOG_DEBUG << "Dropping a message of closed muxId " << muxId << " of connectionId " << carrierId;
+        if (carried.empty())
+        {
+            m_muxByCarrier.erase(carrierId);
+        }
+        return DCGM_CONNECTION_ID_NONE;
+    }
+
+    if (carried.size() >= DCGM_IPC_MAX_MUX_CONNECTIONS)
+    {
+        lock.unlock();
+        DCGM_LOG_ERROR << "Refusing muxId " << muxId << " of connectionId " << carrierId << " that already carries "
+                       << DCGM_IPC_MAX_MUX_CONNECTIONS << " logical connections";
+        SendMuxClose(carrierId, muxId);
+        return DCGM_CONNECTION_ID_NONE;
+    }
+
+    dcgm_connection_id_t connectionId = GetNextConnectionId();
+    carried[muxId]                    = connectionId;
+    m_muxConnections[connectionId]    = { carrierId, muxId };
+    m_numMuxConnections               = m_muxConnections.size();
+
+    DCGM_LOG_DEBUG << "Peer opened connectionId " << connectionId << " as muxId " << muxId << " of connectionId "
+                   << carrierId;
+    return connectionId;
+}
+
+/*****************************************************************************/
+void DcgmIpc::OnMuxClose(dcgm_connection_id_t carrierId, DcgmMessage &message)
+{
+    dcgm_msg_mux_close_t muxClose;
+    if (message.GetMsgBytesPtr()->size() < sizeof(muxClose))
+    {
+        DCGM_LOG_ERROR << "Got a truncated DCGM_MSG_MUX_CLOSE of " << message.GetMsgBytesPtr()->size() << " bytes";
+        return;
+    }
+    memcpy(&muxClose, message.GetMsgBytesPtr()->data(), sizeof(muxClose));
+
+    dcgm_connection_id_t connectionId = DCGM_CONNECTION_ID_NONE;
+    {
+        std::lock_guard<std::mutex> lock(m_muxMutex);
+
+        auto carrierIt = m_muxByCarrier.find(carrierId);
+        if (carrierIt == m_muxByCarrier.end())
+        {
+            return;
+        }
+        auto muxIt = carrierIt->second.find(muxClose.muxId);
+        if (muxIt == carrierIt->second.end())
+        {
+            return;
+        }
+
+        connectionId = muxIt->second;
+        carrierIt->second.erase(muxIt);
+        if (carrierIt->second.empty())
+        {
+            m_muxByCarrier.erase(carrierIt);
+        }
+        m_muxConnections.erase(connectionId);
+        m_numMuxConnections = m_muxConnections.size();
+    }
+
+    DCGM_LOG_DEBUG << "Peer closed connectionId " << connectionId << ", muxId " << muxClose.muxId
+                   << " of connectionId " << carrierId;
+    EnqueueProcessDisconnect(connectionId);
+}
+
+/*****************************************************************************/
+std::vector<dcgm_connection_id_t> DcgmIpc::RemoveMuxConnections(dcgm_connection_id_t carrierId)
+{
+    std::vector<dcgm_connection_id_t> connectionIds;
+
+    if (m_numMuxConnections == 0)
+    {
+        return connectionIds;
+    }
+
+    std::lock_guard<std::mutex> lock(m_muxMutex);
+
+    auto carrierIt = m_muxByCarrier.find(carrierId);
+    if (carrierIt == m_muxByCarrier.end())
+    {
+        return connectionIds;
+    }
+
+    for (auto const &[muxId, connectionId] : carrierIt->second)
+    {
+        m_muxConnections.erase(connectionId);
+        connectionIds.push_back(connectionId);
+    }
+    m_muxByCarrier.erase(carrierIt);
+    m_numMuxConnections = m_muxConnections.size();
+    return connectionIds;
+}
+
+/*****************************************************************************/
+void DcgmIpc::SendMuxClose(dcgm_connection_id_t carrierId, unsigned int muxId)
+{
+    dcgm_msg_mux_close_t muxClose { muxId };
+
+    auto dcgmMessage = std::make_unique<DcgmMessage>();
+    dcgmMessage->GetMsgBytesPtr()->assign((char *)&muxClose, (char *)&muxClose + sizeof(muxClose));
+    dcgmMessage->UpdateMsgHdr(DCGM_MSG_MUX_CLOSE, DCGM_REQUEST_ID_NONE, DCGM_ST_OK, sizeof(muxClose));
+
+    /* The carrier may be going away too. Nothing is waiting on this either way */
+    SendMessage(carrierId, std::move(dcgmMessage), false);
+}
+
+/*****************************************************************************/
+void DcgmIpc::SetupShmChannel(DcgmIpcReactor &reactor,
+                              struct bufferevent *bev,
+                              DcgmIpcConnection *connection,
+                              DcgmMessage &request)
+{
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    dcgm_connection_id_t connectionId = BevToConnectionId(reactor, bev);
+    auto shmChannel                   = std::make_unique<DcgmIpcShmChannel>();
+    int fd                            = bufferevent_getfd(bev);
+    dcgmReturn_t status               = DCGM_ST_OK;
+
+    struct sockaddr_storage address;
+    socklen_t addressLength = sizeof(address);
+    if (getsockname(fd, (struct sockaddr *)&address, &addressLength) != 0 || address.ss_family != AF_UNIX)
+    {
+        status = DCGM_ST_NOT_SUPPORTED; /* fds can only be passed over domain sockets */
+    }
+    else if (connection->GetShmChannel() != nullptr || connection->HasPendingOutput())
+    {
+        /* The reply has to be the next thing on the socket */
+        status = DCGM_ST_IN_USE;
+    }
+    else
+    {
+        status = shmChannel->Create(DCGM_IPC_SHM_RING_SIZE);
+    }
+
+    struct
+    {
+        dcgm_message_header_t header;
+        dcgm_msg_shm_setup_t setup;
+    } __attribute__((packed)) reply {};
+    reply.header.msgId     = DCGM_PROTO_MAGIC;
+    reply.header.requestId = request.GetRequestId();
+    reply.header.length    = sizeof(reply.setup);
+    reply.header.msgType   = DCGM_MSG_SHM_SETUP;
+    reply.header.status    = status;
+    reply.setup.ringSize   = status == DCGM_ST_OK ? shmChannel->GetRingSize() : 0;
+
+    if (status != DCGM_ST_OK)
+    {
+        DCGM_LOG_WARNING << "Not setting up shared memory for connectionId " << connectionId << ": "
+                         << errorString(status);
+        if (bufferevent_write(bev, &reply, sizeof(reply)))
+        {
+            RemoveConnectionByBev(reactor, bev);
+        }
+        return;
+    }
+
+    /* Nothing is buffered, so writing past the bufferevent keeps the stream in order */
+    int fds[DCGM_IPC_SHM_NUM_FDS];
+    shmChannel->GetSetupFds(fds);
+
+    struct iovec iov = { &reply, sizeof(reply) };
+    union
+    {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(fds))];
+    } control {};
+    struct msghdr msg {};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level     = SOL_SOCKET;
+    cmsg->cmsg_type      = SCM_RIGHTS;
+    cmsg->cmsg_len       = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    ssize_t numBytes = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    if (numBytes != (ssize_t)sizeof(reply))
+    {
+        /* A short write leaves part of a header on the stream. Don't try to recover */
+        DCGM_LOG_ERROR << "sendmsg of the shared-memory setup reply returned " << numBytes << ". errno " << errno;
+        RemoveConnectionByBev(reactor, bev);
+        return;
+    }
+
+    if (AttachShmChannel(reactor, connectionId, connection, std::move(shmChannel)) != DCGM_ST_OK)
+    {
+        /* The client is already switching over. Make it notice */
+        RemoveConnectionByBev(reactor, bev);
+        return;
+    }
+
+    DCGM_LOG_DEBUG << "connectionId " << connectionId << " moved to shared memory";
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpc::AttachShmChannel(DcgmIpcReactor &reactor,
+                                       dcgm_connection_id_t connectionId,
+                                       DcgmIpcConnection *connection,
+                                       std::unique_ptr<DcgmIpcShmChannel> shmChannel)
+{
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    if (connection == nullptr || shmChannel == nullptr)
+    {
+        DCGM_LOG_ERROR << "Bad parameter";
+        return DCGM_ST_BADPARAM;
+    }
+
+    int wakeFd = shmChannel->GetWakeFd();
+    struct event *wakeEvent
+        = event_new(reactor.m_eventBase, wakeFd, EV_READ | EV_PERSIST, DcgmIpc::StaticShmWakeCB, &reactor);
+    if (wakeEvent == nullptr || event_add(wakeEvent, nullptr))
+    {
+        DCGM_LOG_ERROR << "Unable to watch the shared-memory wake fd of connectionId " << connectionId;
+        if (wakeEvent != nullptr)
+        {
+            event_free(wakeEvent);
+        }
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    reactor.m_shmWakeFdToConnectionId[wakeFd] = connectionId;
+    connection->SetShmChannel(std::move(shmChannel), wakeEvent);
+
+    /* The peer may have written before we started watching */
+    event_active(wakeEvent, EV_READ, 0);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmIpc::OnCompressionSetup(dcgm_connection_id_t connectionId,
+                                 DcgmIpcConnection *connection,
+                                 DcgmMessage &message)
+{
+    ASSERT_IS_REACTOR_THREAD(ReactorOf(connectionId));
+
+    if (connection->IsAwaitingCompressionSetup())
+    {
+        connection->OnCompressionSetupReply(message);
+        return;
+    }
+
+    if (!m_tcpParameters.has_value() && !m_domainParameters.has_value())
+    {
+        DCGM_LOG_ERROR << "Ignoring a DCGM_MSG_COMPRESSION_SETUP that wasn't asked for";
+        return;
+    }
+
+    dcgm_msg_compression_setup_t setup {};
+    dcgmReturn_t status = DCGM_ST_OK;
+    auto msgBytes       = message.GetMsgBytesPtr();
+
+    if (msgBytes->size() != sizeof(setup))
+    {
+        status = DCGM_ST_BADPARAM;
+    }
+    else
+    {
+        memcpy(&setup, msgBytes->data(), sizeof(setup));
+        if (setup.version != dcgm_msg_compression_setup_version)
+            status = DCGM_ST_VER_MISMATCH;
+        else if (setup.algorithm != DCGM_TRANSPORT_COMPRESSION_ZLIB)
+            status = DCGM_ST_NOT_SUPPORTED;
+        else if (connection->GetShmChannel() != nullptr)
+            status = DCGM_ST_NOT_SUPPORTED; /* Nothing goes over the socket anymore */
+    }
+
+    setup.version = dcgm_msg_compression_setup_version;
+    if (status == DCGM_ST_OK)
+    {
+        if (setup.threshold == 0)
+            setup.threshold = DCGM_IPC_COMPRESSION_DEFAULT_THRESHOLD;
+    }
+    else
+    {
+        DCGM_LOG_WARNING << "Not compressing connectionId " << connectionId << ": " << errorString(status);
+        setup.algorithm = DCGM_TRANSPORT_COMPRESSION_NONE;
+        setup.threshold = 0;
+    }
+
+    auto reply = std::make_unique<DcgmMessage>();
+    reply->UpdateMsgHdr(DCGM_MSG_COMPRESSION_SETUP, message.GetRequestId(), status, (int)sizeof(setup));
+    reply->GetMsgBytesPtr()->assign((char const *)&setup, (char const *)&setup + sizeof(setup));
+
+    /* The reply itself goes out uncompressed since the client doesn't know yet */
+    if (connection->SendMessage(std::move(reply)) != DCGM_ST_OK || status != DCGM_ST_OK)
+        return;
+
+    connection->SetCompression(setup.algorithm, setup.threshold);
+}
+
+/*****************************************************************************/
+void DcgmIpc::StaticShmWakeCB(evutil_socket_t fd, short /*events*/, void *ptr)
+{
+    DcgmIpcReactor *reactor = (DcgmIpcReactor *)ptr;
+    reactor->m_ipc->ShmWakeCB(*reactor, fd);
+}
+
+/*****************************************************************************/
+void DcgmIpc::ShmWakeCB(DcgmIpcReactor &reactor, int fd)
+{
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    auto it = reactor.m_shmWakeFdToConnectionId.find(fd);
+    if (it == reactor.m_shmWakeFdToConnectionId.end())
+    {
+        DCGM_LOG_ERROR << "Unknown shared-memory wake fd " << fd;
+        return;
+    }
+
+    dcgm_connection_id_t connectionId = it->second;
+    DcgmIpcConnection *connection     = ConnectionIdToPtr(reactor, connectionId);
+    if (connection == nullptr || connection->GetShmChannel() == nullptr)
+    {
+        DCGM_LOG_ERROR << "Unknown connectionId " << connectionId << " for shared-memory wake fd " << fd;
+        return;
+    }
+
+    DcgmIpcShmChannel *shmChannel = connection->GetShmChannel();
+
+    /* Reset first so that anything the peer writes from here on wakes us again */
+    shmChannel->AcknowledgeWake();
+    shmChannel->FlushPending();
+
+    std::vector<std::unique_ptr<DcgmMessage>> messages;
+
+    dcgmReturn_t dcgmReturn = shmChannel->ReadMessages(messages);
+    if (dcgmReturn == DCGM_ST_NO_DATA)
+    {
+        return;
+    }
+    else if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got error " << errorString(dcgmReturn) << " reading shared memory of connectionId "
+                       << connectionId;
+        RemoveConnectionById(reactor, connectionId);
+        return;
     }
+
+    DispatchMessages(connectionId, messages);
 }
 
 /*****************************************************************************/
-dcgm_connection_id_t DcgmIpc::BevToConnectionId(struct bufferevent *bev)
+dcgm_connection_id_t DcgmIpc::BevToConnectionId(DcgmIpcReactor &reactor, struct bufferevent *bev)
 {
-    auto it = m_bevToConnectionId.find(bev);
-    if (it == m_bevToConnectionId.end())
+    auto it = reactor.m_bevToConnectionId.find(bev);
+    if (it == reactor.m_bevToConnectionId.end())
     {
         return DCGM_CONNECTION_ID_NONE;
     }
@@ -882,6 +1961,14 @@ DcgmIpcConnection::DcgmIpcConnection(struct bufferevent *bev,
     , m_connectionState(connectionState)
     , m_shouldReadHeader(true)
     , m_readHeader({})
+    , m_shmEvent(nullptr)
+    , m_compression(DCGM_TRANSPORT_COMPRESSION_NONE)
+    , m_compressionThreshold(0)
+    , m_counters({})
+    , m_sendQueueParams({})
+    , m_heldBytes(0)
+    , m_sendQueueStats({})
+    , m_isSlowConsumer(false)
     , m_connectPromise(std::move(connectPromise))
 {
     DCGM_LOG_DEBUG << "DcgmIpcConnection constructor for bev " << m_bev;
@@ -894,6 +1981,18 @@ DcgmIpcConnection::~DcgmIpcConnection()
     /* Set this connection to closed, possibly triggering the m_connectPromise-linked future */
     SetConnectionState(DCGM_IPC_CS_CLOSED);
 
+    if (m_compressionSetupPromise.has_value())
+    {
+        m_compressionSetupPromise->set_value(DCGM_ST_CONNECTION_NOT_VALID);
+    }
+
+    /* Stop watching the channel's wake fd before m_shmChannel closes it */
+    if (m_shmEvent != nullptr)
+    {
+        event_free(m_shmEvent);
+        m_shmEvent = nullptr;
+    }
+
     if (m_bev != nullptr)
     {
         DCGM_LOG_DEBUG << "bufferevent_free " << m_bev;
@@ -1009,6 +2108,21 @@ dcgmReturn_t DcgmIpcConnection::ReadMessages(struct bufferevent *bev,
         /* We read an entire message. We should read a header next */
         m_shouldReadHeader = true;
 
+        m_counters.messagesReceived++;
+        m_counters.bytesReceived += sizeof(m_readHeader) + numBytes;
+
+        if (m_readHeader.msgType == DCGM_MSG_COMPRESSED)
+        {
+            dcgmReturn_t dcgmReturn = DecompressMessage(*dcgmMessage);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                /* The peer is broken or isn't speaking our protocol */
+                return DCGM_ST_CONNECTION_NOT_VALID;
+            }
+        }
+
+        m_counters.uncompressedBytesReceived += sizeof(m_readHeader) + dcgmMessage->GetMsgBytesPtr()->size();
+
         messages.push_back(std::move(dcgmMessage));
         retSt = DCGM_ST_OK; /* We read at least one complete message */
     }
@@ -1040,30 +2154,72 @@ void DcgmIpc::OnAccept(int listenerFd)
         return;
     }
 
+    dcgm_connection_id_t connectionId = GetNextConnectionId();
+    DcgmIpcAcceptConnection acceptConnection(this, connectionId, clientFd);
+
+    DcgmIpcReactor &reactor = ReactorOf(connectionId);
+    if (reactor.m_index == 0)
+    {
+        /* We are its thread */
+        AcceptConnectionImpl(acceptConnection);
+        return;
+    }
+
+    /* Hand the socket to the reactor that will own the connection. Using new here because
+       we're transferring it through a C callback */
+    DcgmIpcAcceptConnection *handOff = new DcgmIpcAcceptConnection(acceptConnection);
+
+    int st = event_base_once(reactor.m_eventBase, -1, EV_TIMEOUT, DcgmIpc::AcceptConnectionImplCB, handOff, 0);
+    if (st)
+    {
+        DCGM_LOG_ERROR << "Got error " << st << " from event_base_once";
+        delete handOff;
+        close(clientFd);
+    }
+}
+
+/*****************************************************************************/
+void DcgmIpc::AcceptConnectionImpl(DcgmIpcAcceptConnection &acceptConnection)
+{
+    DcgmIpcReactor &reactor = ReactorOf(acceptConnection.m_connectionId);
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    dcgm_connection_id_t connectionId = acceptConnection.m_connectionId;
+
     /* TCP/IP */
-    struct bufferevent *bev = bufferevent_socket_new(m_eventBase, clientFd, BEV_OPT_CLOSE_ON_FREE);
+    struct bufferevent *bev
+        = bufferevent_socket_new(reactor.m_eventBase, acceptConnection.m_fd, BEV_OPT_CLOSE_ON_FREE);
     if (bev == nullptr)
     {
-        DCGM_LOG_ERROR << "Failed to create socket for fd " << clientFd;
-        close(clientFd);
+        DCGM_LOG_ERROR << "Failed to create socket for fd " << acceptConnection.m_fd;
+        close(acceptConnection.m_fd);
         return;
     }
 
-    dcgm_connection_id_t connectionId = GetNextConnectionId();
     /* Add a tracked connection and remove our pending status */
-    dcgmReturn_t dcgmReturn = AddConnection(bev, connectionId, DCGM_IPC_CS_ACTIVE, std::promise<dcgmReturn_t>());
+    dcgmReturn_t dcgmReturn
+        = AddConnection(reactor, bev, connectionId, DCGM_IPC_CS_ACTIVE, std::promise<dcgmReturn_t>());
     if (dcgmReturn != DCGM_ST_OK)
     {
         DCGM_LOG_ERROR << "Failed to AddConnection connectionId" << connectionId;
-        bufferevent_free(bev); /* This auto closes clientFd */
+        bufferevent_free(bev); /* This auto closes the socket */
         return;
     }
 
     /* Track our event before callbacks could be invoked */
-    bufferevent_setcb(bev, DcgmIpc::StaticReadCB, NULL, DcgmIpc::StaticEventCB, this);
+    bufferevent_setcb(bev, DcgmIpc::StaticReadCB, GetWriteCB(), DcgmIpc::StaticEventCB, &reactor);
     bufferevent_enable(bev, EV_READ | EV_WRITE);
 
-    DCGM_LOG_DEBUG << "Server connection accepted with connectionId " << connectionId << " bev " << bev;
+    DCGM_LOG_DEBUG << "Server connection accepted with connectionId " << connectionId << " bev " << bev
+                   << " on reactor " << reactor.m_index;
+}
+
+/*****************************************************************************/
+void DcgmIpc::AcceptConnectionImplCB(evutil_socket_t, short, void *data)
+{
+    std::unique_ptr<DcgmIpcAcceptConnection> acceptConnection((DcgmIpcAcceptConnection *)data);
+
+    acceptConnection->m_ipc->AcceptConnectionImpl(*acceptConnection);
 }
 
 /*****************************************************************************/
@@ -1077,12 +2233,13 @@ void DcgmIpc::StaticOnAccept(int listenFd, short /*ev*/, void *userData)
 /*****************************************************************************/
 void DcgmIpc::SendMessageImpl(DcgmIpcSendMessage &sendMessage)
 {
-    ASSERT_IS_IPC_THREAD;
+    DcgmIpcReactor &reactor = ReactorOf(sendMessage.m_connectionId);
+    ASSERT_IS_REACTOR_THREAD(reactor);
 
     /* TCP/IP */
     DCGM_LOG_DEBUG << "Sending message to " << sendMessage.m_connectionId;
 
-    DcgmIpcConnection *connection = ConnectionIdToPtr(sendMessage.m_connectionId);
+    DcgmIpcConnection *connection = ConnectionIdToPtr(reactor, sendMessage.m_connectionId);
     if (connection == nullptr)
     {
         DCGM_LOG_ERROR << "Couldn't find connectionId " << sendMessage.m_connectionId << " for SendMessage()";
@@ -1092,6 +2249,13 @@ void DcgmIpc::SendMessageImpl(DcgmIpcSendMessage &sendMessage)
 
     dcgmReturn_t dcgmReturn = connection->SendMessage(std::move(sendMessage.m_message));
     sendMessage.m_promise.set_value(dcgmReturn);
+
+    if (connection->IsSlowConsumer())
+    {
+        DCGM_LOG_WARNING << "Closing connectionId " << sendMessage.m_connectionId
+                         << " since its peer stopped reading what we send";
+        RemoveConnectionById(reactor, sendMessage.m_connectionId);
+    }
 }
 
 /*****************************************************************************/
@@ -1107,12 +2271,21 @@ dcgmReturn_t DcgmIpc::SendMessage(dcgm_connection_id_t connectionId,
                                   std::unique_ptr<DcgmMessage> message,
                                   bool waitForSend)
 {
+    /* Messages of logical connections go out over their carrier */
+    DcgmIpcMuxConnection_t mux;
+    if (FindMuxConnection(connectionId, mux))
+    {
+        WrapMuxMessage(*message, mux.muxId);
+        connectionId = mux.carrierId;
+    }
+
     /* Using new here because we're transferring it through a C callback */
     DcgmIpcSendMessage *sendMessage = new DcgmIpcSendMessage(this, connectionId, std::move(message));
 
     auto sendMessageFuture = sendMessage->m_promise.get_future();
 
-    int st = event_base_once(m_eventBase, -1, EV_TIMEOUT, DcgmIpc::SendMessageImplCB, sendMessage, 0);
+    int st = event_base_once(
+        ReactorOf(connectionId).m_eventBase, -1, EV_TIMEOUT, DcgmIpc::SendMessageImplCB, sendMessage, 0);
     if (st)
     {
         DCGM_LOG_ERROR << "Got error " << st << " from event_base_once";
@@ -1141,30 +2314,329 @@ dcgmReturn_t DcgmIpcConnection::SendMessage(std::unique_ptr<DcgmMessage> dcgmMes
         return DCGM_ST_CONNECTION_NOT_VALID;
     }
 
+    if (m_shmChannel != nullptr)
+    {
+        return m_shmChannel->SendMessage(std::move(dcgmMessage));
+    }
+
+    if (m_isSlowConsumer)
+    {
+        return DCGM_ST_CONNECTION_NOT_VALID; /* About to be closed */
+    }
+
+    dcgmReturn_t dcgmReturn;
+
+    /* Held messages go first so that the peer sees messages in order */
+    if (m_sendQueueParams.highWatermark == 0
+        || (m_heldMessages.empty() && GetOutputBytes() < m_sendQueueParams.highWatermark))
+    {
+        dcgmReturn = WriteOut(std::move(dcgmMessage));
+    }
+    else
+    {
+        dcgmReturn = HoldMessage(std::move(dcgmMessage));
+    }
+
+    m_sendQueueStats.maxQueuedBytes
+        = std::max(m_sendQueueStats.maxQueuedBytes, (unsigned long long)(GetOutputBytes() + m_heldBytes));
+    return dcgmReturn;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcConnection::WriteOut(std::unique_ptr<DcgmMessage> dcgmMessage)
+{
     auto msgHdr   = dcgmMessage->GetMessageHdr();
     auto msgBytes = dcgmMessage->GetMsgBytesPtr();
 
+    m_counters.messagesSent++;
+    m_counters.uncompressedBytesSent += sizeof(*msgHdr) + msgBytes->size();
+
+    if (m_compression != DCGM_TRANSPORT_COMPRESSION_NONE && msgBytes->size() >= m_compressionThreshold)
+    {
+        dcgm_message_header_t wireHeader;
+        std::vector<char> wireBody
+            = DcgmMessageBufferPool::Global().Acquire(sizeof(dcgm_msg_compressed_t) + msgBytes->size());
+        if (CompressMessage(*msgHdr, *msgBytes, wireHeader, wireBody) == DCGM_ST_OK)
+        {
+            m_counters.messagesSentCompressed++;
+            dcgmReturn_t dcgmReturn = WriteMessage(wireHeader, wireBody);
+            DcgmMessageBufferPool::Global().Release(std::move(wireBody));
+            return dcgmReturn;
+        }
+        DcgmMessageBufferPool::Global().Release(std::move(wireBody));
+        /* Send it as it is */
+    }
+
+    return WriteMessage(*msgHdr, *msgBytes);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcConnection::HoldMessage(std::unique_ptr<DcgmMessage> dcgmMessage)
+{
+    if (m_heldMessages.empty())
+    {
+        m_sendQueueStats.highWatermarkHits++;
+        DCGM_LOG_WARNING << "The peer of bev " << m_bev << " fell behind with " << GetOutputBytes()
+                         << " bytes waiting to be written. Holding messages back.";
+    }
+
+    if (m_sendQueueParams.policy == DCGM_IPC_SLOW_CONSUMER_DISCONNECT)
+    {
+        m_isSlowConsumer = true;
+        return DCGM_ST_CONNECTION_NOT_VALID;
+    }
+
+    /* Notifications of logical connections are as disposable as any */
+    unsigned int msgType = CarriedMsgType(*dcgmMessage);
+    if (m_sendQueueParams.policy == DCGM_IPC_SLOW_CONSUMER_COALESCE && IsNotification(msgType))
+    {
+        for (auto &held : m_heldMessages)
+        {
+            if (held->GetMsgType() == dcgmMessage->GetMsgType() && CarriedMsgType(*held) == msgType
+                && held->GetRequestId() == dcgmMessage->GetRequestId())
+            {
+                m_heldBytes = m_heldBytes - MessageSize(*held) + MessageSize(*dcgmMessage);
+                held        = std::move(dcgmMessage);
+                m_sendQueueStats.messagesCoalesced++;
+                break;
+            }
+        }
+    }
+
+    if (dcgmMessage != nullptr)
+    {
+        m_heldBytes += MessageSize(*dcgmMessage);
+        m_heldMessages.push_back(std::move(dcgmMessage));
+    }
+
+    /* Hold at most as much as the socket buffers */
+    while (m_heldBytes > m_sendQueueParams.highWatermark)
+    {
+        auto dropIt = m_heldMessages.end();
+        if (m_sendQueueParams.policy == DCGM_IPC_SLOW_CONSUMER_DROP_OLDEST)
+        {
+            dropIt = std::find_if(m_heldMessages.begin(), m_heldMessages.end(), [](auto const &held) {
+                return IsNotification(CarriedMsgType(*held));
+            });
+        }
+
+        if (dropIt == m_heldMessages.end())
+        {
+            DCGM_LOG_ERROR << "The peer of bev " << m_bev << " is " << m_heldBytes
+                           << " bytes behind on messages that can't be dropped";
+            m_isSlowConsumer = true;
+            return DCGM_ST_CONNECTION_NOT_VALID;
+        }
+
+        m_heldBytes -= MessageSize(**dropIt);
+        m_heldMessages.erase(dropIt);
+        m_sendQueueStats.messagesDropped++;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmIpcConnection::FlushHeldMessages()
+{
+    if (m_heldMessages.empty())
+    {
+        return;
+    }
+
+    while (!m_heldMessages.empty() && GetOutputBytes() < m_sendQueueParams.highWatermark)
+    {
+        std::unique_ptr<DcgmMessage> dcgmMessage = std::move(m_heldMessages.front());
+        m_heldMessages.pop_front();
+        m_heldBytes -= MessageSize(*dcgmMessage);
+
+        if (WriteOut(std::move(dcgmMessage)) != DCGM_ST_OK)
+        {
+            return; /* The event callback will notice the broken connection */
+        }
+    }
+
+    if (m_heldMessages.empty())
+    {
+        DCGM_LOG_DEBUG << "The peer of bev " << m_bev << " caught up";
+    }
+}
+
+/*****************************************************************************/
+void DcgmIpcConnection::SetSendQueueParams(DcgmIpcSendQueueParams_t const &params)
+{
+    m_sendQueueParams = params;
+    if (m_sendQueueParams.highWatermark > 0 && m_bev != nullptr)
+    {
+        bufferevent_setwatermark(m_bev, EV_WRITE, m_sendQueueParams.lowWatermark, 0);
+    }
+}
+
+/*****************************************************************************/
+size_t DcgmIpcConnection::GetOutputBytes()
+{
+    return m_bev == nullptr ? 0 : evbuffer_get_length(bufferevent_get_output(m_bev));
+}
 
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcConnection::WriteMessage(dcgm_message_header_t const &header, std::vector<char> const &body)
+{
     /* Note that we're only able to do these calls in succession because
        we only write to connections from a single thread. Otherwise, we'd have
        to stage the entire message in an evbuffer and call bufferevent_write_buffer */
-    int st  = bufferevent_write(m_bev, msgHdr, sizeof(*msgHdr));
-    int st2 = bufferevent_write(m_bev, msgBytes->data(), msgBytes->size());
+    int st  = bufferevent_write(m_bev, &header, sizeof(header));
+    int st2 = bufferevent_write(m_bev, body.data(), body.size());
     if (st || st2)
     {
         DCGM_LOG_ERROR << "Got error from first or second write " << st << ", " << st2;
         return DCGM_ST_CONNECTION_NOT_VALID;
     }
 
+    m_counters.bytesSent += sizeof(header) + body.size();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcConnection::CompressMessage(dcgm_message_header_t const &header,
+                                                std::vector<char> const &body,
+                                                dcgm_message_header_t &wireHeader,
+                                                std::vector<char> &wireBody)
+{
+    dcgm_msg_compressed_t compressed {};
+    compressed.algorithm = m_compression;
+    compressed.msgType   = header.msgType;
+    compressed.length    = (int)body.size();
+
+    wireBody.reserve(sizeof(compressed) + body.size());
+    wireBody.assign((char const *)&compressed, (char const *)&compressed + sizeof(compressed));
+
+    long long startUsec     = DcgmIpcThreadCpuUsec();
+    dcgmReturn_t dcgmReturn = DcgmIpcCompress(m_compression, body.data(), body.size(), wireBody);
+    m_counters.compressUsec += DcgmIpcThreadCpuUsec() - startUsec;
+
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+    if (wireBody.size() >= body.size())
+        return DCGM_ST_NO_DATA;
+
+    wireHeader         = header;
+    wireHeader.msgType = DCGM_MSG_COMPRESSED;
+    wireHeader.length  = (int)wireBody.size();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcConnection::DecompressMessage(DcgmMessage &message)
+{
+    auto msgHdr   = message.GetMessageHdr();
+    auto msgBytes = message.GetMsgBytesPtr();
+
+    dcgm_msg_compressed_t compressed;
+    if (msgBytes->size() < sizeof(compressed))
+    {
+        DCGM_LOG_ERROR << "Got a truncated DCGM_MSG_COMPRESSED of " << msgBytes->size() << " bytes";
+        return DCGM_ST_BADPARAM;
+    }
+
+    memcpy(&compressed, msgBytes->data(), sizeof(compressed));
+    if (compressed.length < 0 || compressed.length > DCGM_PROTO_MAX_MESSAGE_SIZE
+        || compressed.msgType == DCGM_MSG_COMPRESSED)
+    {
+        DCGM_LOG_ERROR << "Got a bad DCGM_MSG_COMPRESSED of msgType 0x" << std::hex << compressed.msgType
+                       << std::dec << ", length " << compressed.length;
+        return DCGM_ST_BADPARAM;
+    }
+
+    std::vector<char> body = DcgmMessageBufferPool::Global().Acquire(compressed.length);
+    body.resize(compressed.length);
+
+    long long startUsec     = DcgmIpcThreadCpuUsec();
+    dcgmReturn_t dcgmReturn = DcgmIpcDecompress(compressed.algorithm,
+                                                msgBytes->data() + sizeof(compressed),
+                                                msgBytes->size() - sizeof(compressed),
+                                                body.data(),
+                                                body.size());
+    m_counters.decompressUsec += DcgmIpcThreadCpuUsec() - startUsec;
+
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+
+    msgBytes->swap(body);
+    DcgmMessageBufferPool::Global().Release(std::move(body));
+    message.UpdateMsgHdr(compressed.msgType, msgHdr->requestId, msgHdr->status, compressed.length);
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+void DcgmIpcConnection::SetCompression(unsigned int algorithm, unsigned int threshold)
+{
+    m_compression          = algorithm;
+    m_compressionThreshold = threshold;
+}
+
+/*****************************************************************************/
+void DcgmIpcConnection::AwaitCompressionSetup(std::promise<dcgmReturn_t> &&promise)
+{
+    m_compressionSetupPromise = std::move(promise);
+}
+
+/*****************************************************************************/
+void DcgmIpcConnection::OnCompressionSetupReply(DcgmMessage &reply)
+{
+    dcgmReturn_t status = (dcgmReturn_t)reply.GetMessageHdr()->status;
+    auto msgBytes       = reply.GetMsgBytesPtr();
+    dcgm_msg_compression_setup_t setup {};
+
+    if (status == DCGM_ST_OK && msgBytes->size() != sizeof(setup))
+    {
+        DCGM_LOG_ERROR << "Got a DCGM_MSG_COMPRESSION_SETUP reply of " << msgBytes->size() << " bytes";
+        status = DCGM_ST_BADPARAM;
+    }
+    else if (status == DCGM_ST_OK)
+    {
+        memcpy(&setup, msgBytes->data(), sizeof(setup));
+        SetCompression(setup.algorithm, setup.threshold);
+        DCGM_LOG_DEBUG << "Compressing messages of at least " << setup.threshold << " bytes with algorithm "
+                       << setup.algorithm;
+    }
+
+    m_compressionSetupPromise->set_value(status);
+    m_compressionSetupPromise.reset();
+}
+
+/*****************************************************************************/
+DcgmIpcConnectionStats_t DcgmIpcConnection::GetStats()
+{
+    DcgmIpcConnectionStats_t stats {};
+    stats.compression          = m_compression;
+    stats.compressionThreshold = m_compressionThreshold;
+    stats.counters             = m_counters;
+    stats.sendQueue            = m_sendQueueStats;
+    stats.sendQueue.queuedBytes  = GetOutputBytes() + m_heldBytes;
+    stats.sendQueue.heldMessages = m_heldMessages.size();
+    return stats;
+}
+
+/*****************************************************************************/
+void DcgmIpcConnection::SetShmChannel(std::unique_ptr<DcgmIpcShmChannel> shmChannel, struct event *shmEvent)
+{
+    m_shmChannel = std::move(shmChannel);
+    m_shmEvent   = shmEvent;
+}
+
+/*****************************************************************************/
+bool DcgmIpcConnection::HasPendingOutput()
+{
+    return GetOutputBytes() > 0 || !m_heldMessages.empty();
+}
+
 /*****************************************************************************/
 void DcgmIpc::CloseConnectionImpl(DcgmIpcCloseConnection &closeConnection)
 {
-    ASSERT_IS_IPC_THREAD;
+    DcgmIpcReactor &reactor = ReactorOf(closeConnection.m_connectionId);
+    ASSERT_IS_REACTOR_THREAD(reactor);
 
-    dcgmReturn_t dcgmReturn = RemoveConnectionById(closeConnection.m_connectionId);
+    dcgmReturn_t dcgmReturn = RemoveConnectionById(reactor, closeConnection.m_connectionId);
     if (dcgmReturn != DCGM_ST_OK)
     {
         DCGM_LOG_ERROR << "Got error " << errorString(dcgmReturn) << " for RemoveConnectionById of connectionId "
@@ -1187,11 +2659,35 @@ void DcgmIpc::CloseConnectionImplCB(evutil_socket_t, short, void *data)
 /*****************************************************************************/
 dcgmReturn_t DcgmIpc::CloseConnection(dcgm_connection_id_t connectionId)
 {
+    DcgmIpcMuxConnection_t mux;
+    if (FindMuxConnection(connectionId, mux))
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_muxMutex);
+            m_muxConnections.erase(connectionId);
+            m_numMuxConnections = m_muxConnections.size();
+            auto carrierIt = m_muxByCarrier.find(mux.carrierId);
+            if (carrierIt != m_muxByCarrier.end())
+            {
+                carrierIt->second.erase(mux.muxId);
+                if (carrierIt->second.empty())
+                {
+                    m_muxByCarrier.erase(carrierIt);
+                }
+            }
+        }
+
+        SendMuxClose(mux.carrierId, mux.muxId);
+        EnqueueProcessDisconnect(connectionId);
+        return DCGM_ST_OK;
+    }
+
     /* Using new here because we're transferring it through a C callback. The callback will
        assign this to a unique_ptr and then free it automatically */
     DcgmIpcCloseConnection *closeConnection = new DcgmIpcCloseConnection(this, connectionId);
 
-    int st = event_base_once(m_eventBase, -1, EV_TIMEOUT, DcgmIpc::CloseConnectionImplCB, closeConnection, 0);
+    int st = event_base_once(
+        ReactorOf(connectionId).m_eventBase, -1, EV_TIMEOUT, DcgmIpc::CloseConnectionImplCB, closeConnection, 0);
     if (st)
     {
         DCGM_LOG_ERROR << "Got error " << st << " from event_base_once";
@@ -1201,4 +2697,96 @@ dcgmReturn_t DcgmIpc::CloseConnection(dcgm_connection_id_t connectionId)
     return DCGM_ST_OK;
 }
 
-/*****************************************************************************/
\ No newline at end of file
+/*****************************************************************************/
+
+/*****************************************************************************/
+void DcgmIpc::GetConnectionStatsImpl(DcgmIpcGetConnectionStats &getStats)
+{
+    DcgmIpcReactor &reactor = *getStats.m_reactor;
+    ASSERT_IS_REACTOR_THREAD(reactor);
+
+    if (getStats.m_connectionId != DCGM_CONNECTION_ID_NONE)
+    {
+        DcgmIpcConnection *connection = ConnectionIdToPtr(reactor, getStats.m_connectionId);
+        if (connection == nullptr)
+        {
+            getStats.m_promise.set_value(DCGM_ST_CONNECTION_NOT_VALID);
+            return;
+        }
+
+        *getStats.m_stats = connection->GetStats();
+        getStats.m_promise.set_value(DCGM_ST_OK);
+        return;
+    }
+
+    *getStats.m_stats          = {};
+    getStats.m_stats->counters  = reactor.m_closedConnectionCounters;
+    getStats.m_stats->sendQueue = reactor.m_closedSendQueueStats;
+    for (auto const &connection : reactor.m_connections)
+    {
+        DcgmIpcConnectionStats_t connectionStats = connection.second->GetStats();
+        AddCounters(getStats.m_stats->counters, connectionStats.counters);
+        AddSendQueueStats(getStats.m_stats->sendQueue, connectionStats.sendQueue);
+    }
+    getStats.m_promise.set_value(DCGM_ST_OK);
+}
+
+/*****************************************************************************/
+void DcgmIpc::GetConnectionStatsImplCB(evutil_socket_t, short, void *data)
+{
+    std::unique_ptr<DcgmIpcGetConnectionStats> getStats((DcgmIpcGetConnectionStats *)data);
+
+    getStats->m_reactor->m_ipc->GetConnectionStatsImpl(*getStats);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpc::GetConnectionStats(dcgm_connection_id_t connectionId, DcgmIpcConnectionStats_t &stats)
+{
+    if (connectionId != DCGM_CONNECTION_ID_NONE)
+    {
+        DcgmIpcMuxConnection_t mux;
+        if (FindMuxConnection(connectionId, mux))
+        {
+            connectionId = mux.carrierId;
+        }
+        return GetReactorConnectionStats(ReactorOf(connectionId), connectionId, stats);
+    }
+
+    /* Each reactor only knows the traffic of its own connections */
+    stats = {};
+    for (auto &reactor : m_reactors)
+    {
+        DcgmIpcConnectionStats_t reactorStats {};
+        dcgmReturn_t dcgmReturn = GetReactorConnectionStats(*reactor, DCGM_CONNECTION_ID_NONE, reactorStats);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            return dcgmReturn;
+        }
+        AddCounters(stats.counters, reactorStats.counters);
+        AddSendQueueStats(stats.sendQueue, reactorStats.sendQueue);
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpc::GetReactorConnectionStats(DcgmIpcReactor &reactor,
+                                                dcgm_connection_id_t connectionId,
+                                                DcgmIpcConnectionStats_t &stats)
+{
+    /* Using new here because we're transferring it through a C callback. stats stays
+       valid since we wait for the callback below */
+    DcgmIpcGetConnectionStats *getStats = new DcgmIpcGetConnectionStats(&reactor, connectionId, &stats);
+
+    auto getStatsFuture = getStats->m_promise.get_future();
+
+    int st = event_base_once(reactor.m_eventBase, -1, EV_TIMEOUT, DcgmIpc::GetConnectionStatsImplCB, getStats, 0);
+    if (st)
+    {
+        DCGM_LOG_ERROR << "Got error " << st << " from event_base_once";
+        delete getStats;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return getStatsFuture.get();
+}
@@ -15,11 +15,16 @@
  */
 #pragma once
 
+#include "DcgmElasticWorkerPool.h"
+#include "DcgmIpcCompression.h"
+#include "DcgmIpcShm.h"
 #include "DcgmProtocol.h"
 #include <DcgmThread.h>
 #include <ThreadPool.hpp>
+#include <WorkStealingThreadPool.hpp>
 #include <atomic>
 #include <dcgm_structs.h>
+#include <deque>
 #include <event2/buffer.h>
 #include <event2/bufferevent.h>
 #include <event2/dns.h>
@@ -27,9 +32,14 @@
 #include <event2/thread.h>
 #include <functional>
 #include <future>
+#include <mutex>
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+/* Most logical connections that can share one connection. See DcgmIpc::OpenMuxConnection */
+#define DCGM_IPC_MAX_MUX_CONNECTIONS 4096
 
 typedef struct
 {
@@ -60,6 +70,40 @@ typedef enum
     DCGM_IPC_CS_MAX     = 4  /* Sentinel value */
 } DcgmIpcConnectionState_t;
 
+/* Compression settings and traffic of a connection. See DcgmIpc::GetConnectionStats */
+typedef struct
+{
+    unsigned int compression;          /* DCGM_TRANSPORT_COMPRESSION_? messages are sent with */
+    unsigned int compressionThreshold; /* Message bodies with fewer bytes than this are sent as they are */
+    dcgmTransportCounters_t counters;  /* Traffic over the socket */
+    dcgmSendQueueStats_t sendQueue;    /* Messages waiting to be written to the socket */
+} DcgmIpcConnectionStats_t;
+
+/* What happens to messages for a peer that stopped keeping up. See DcgmIpcSendQueueParams_t */
+typedef enum
+{
+    DCGM_IPC_SLOW_CONSUMER_DROP_OLDEST = 0, /* Drop the oldest held notifications */
+    DCGM_IPC_SLOW_CONSUMER_COALESCE    = 1, /* Replace a held notification with a newer one for the same request */
+    DCGM_IPC_SLOW_CONSUMER_DISCONNECT  = 2, /* Close the connection */
+} DcgmIpcSlowConsumerPolicy_t;
+
+/*
+ * Bounds on what a connection buffers for a peer that doesn't read.
+ *
+ * Once highWatermark bytes wait to be written to the socket, further messages are
+ * held back until fewer than lowWatermark bytes wait. policy applies to held
+ * messages. Only notifications (DCGM_MSG_POLICY_NOTIFY and DCGM_MSG_ATTRIBUTE_GENERATION)
+ * are dropped or coalesced. Replies never are, and field value streams have their
+ * own flow control, so a connection that holds more than highWatermark bytes of
+ * those is closed whatever the policy.
+ */
+typedef struct
+{
+    size_t highWatermark; /* 0 = buffer without bound */
+    size_t lowWatermark;
+    DcgmIpcSlowConsumerPolicy_t policy;
+} DcgmIpcSendQueueParams_t;
+
 /* Callback function to pass to DcgmIpc::Init that will process any messages received by clients.
    This will be invoked on a separate worker pool */
 typedef std::function<void(dcgm_connection_id_t, std::unique_ptr<DcgmMessage>, void *userData)>
@@ -69,6 +113,11 @@ typedef std::function<void(dcgm_connection_id_t, std::unique_ptr<DcgmMessage>, v
    This will be invoked on a separate worker pool */
 typedef std::function<void(dcgm_connection_id_t, void *userData)> DcgmIpcProcessDisconnectFunc_f;
 
+/* Callback function to pass to DcgmIpc::SetWorkerLanes that picks which lane a received
+   message is processed on. Returns an index into the lanes given to SetWorkerLanes().
+   This is invoked on the event loop thread, so it has to be cheap */
+typedef std::function<unsigned int(DcgmMessage &, void *userData)> DcgmIpcClassifyMessageFunc_f;
+
 class DcgmIpcConnection
 {
 private:
@@ -78,6 +127,50 @@ private:
     dcgm_message_header_t m_readHeader; /* Header of the message we are currently reading. This gets updated
                                            by ReadMessages */
 
+    /* Shared-memory channel that messages go over instead of m_bev once it is set up.
+       m_bev is then only watched for the peer going away */
+    std::unique_ptr<DcgmIpcShmChannel> m_shmChannel;
+    struct event *m_shmEvent; /* Read event on m_shmChannel's wake fd */
+
+    /* How messages written to m_bev are compressed. Set by DCGM_MSG_COMPRESSION_SETUP.
+       Compressed messages are read no matter what this is */
+    unsigned int m_compression;
+    unsigned int m_compressionThreshold;
+
+    /* Set while this client waits for the reply to its DCGM_MSG_COMPRESSION_SETUP */
+    std::optional<std::promise<dcgmReturn_t>> m_compressionSetupPromise;
+
+    dcgmTransportCounters_t m_counters; /* Traffic over m_bev */
+
+    /* Messages held back while m_bev's output is above the high watermark */
+    DcgmIpcSendQueueParams_t m_sendQueueParams;
+    std::deque<std::unique_ptr<DcgmMessage>> m_heldMessages;
+    size_t m_heldBytes;
+    dcgmSendQueueStats_t m_sendQueueStats;
+    bool m_isSlowConsumer; /* Set once m_sendQueueParams says to close this connection */
+
+    /* Compress and write a message to m_bev */
+    dcgmReturn_t WriteOut(std::unique_ptr<DcgmMessage> dcgmMessage);
+
+    /* Hold dcgmMessage back and apply m_sendQueueParams.policy */
+    dcgmReturn_t HoldMessage(std::unique_ptr<DcgmMessage> dcgmMessage);
+
+    /* Bytes waiting in m_bev's output */
+    size_t GetOutputBytes();
+
+    /* Write a header and body to m_bev */
+    dcgmReturn_t WriteMessage(dcgm_message_header_t const &header, std::vector<char> const &body);
+
+    /* Build the DCGM_MSG_COMPRESSED that carries header + body. Returns DCGM_ST_NO_DATA
+       if body doesn't get any smaller */
+    dcgmReturn_t CompressMessage(dcgm_message_header_t const &header,
+                                 std::vector<char> const &body,
+                                 dcgm_message_header_t &wireHeader,
+                                 std::vector<char> &wireBody);
+
+    /* Turn a DCGM_MSG_COMPRESSED that was read back into the message it carries */
+    dcgmReturn_t DecompressMessage(DcgmMessage &message);
+
 public:
     /* Promise used for async connect. Making this public for ease of use as a private class */
     std::promise<dcgmReturn_t> m_connectPromise;
@@ -88,16 +181,92 @@ public:
                       std::promise<dcgmReturn_t> &&connectPromise);
     ~DcgmIpcConnection();
 
+    /* Write dcgmMessage to the peer, or hold it back if the peer has fallen behind. Check
+       IsSlowConsumer() afterwards */
     dcgmReturn_t SendMessage(std::unique_ptr<DcgmMessage> dcgmMessage);
     void SetConnectionState(DcgmIpcConnectionState_t state);
+
+    /* Bound what is buffered for the peer from now on */
+    void SetSendQueueParams(DcgmIpcSendQueueParams_t const &params);
+
+    /* Write held messages once m_bev's output drained to the low watermark */
+    void FlushHeldMessages();
+
+    /* Whether the peer fell far enough behind that this connection should be closed */
+    bool IsSlowConsumer()
+    {
+        return m_isSlowConsumer;
+    }
     dcgmReturn_t ReadMessages(struct bufferevent *bev, std::vector<std::unique_ptr<DcgmMessage>> &messages);
+
+    /* Send and receive over shmChannel from now on. shmEvent is owned by this object from now on */
+    void SetShmChannel(std::unique_ptr<DcgmIpcShmChannel> shmChannel, struct event *shmEvent);
+
+    /* nullptr if messages go over the socket */
+    DcgmIpcShmChannel *GetShmChannel()
+    {
+        return m_shmChannel.get();
+    }
+
+    /* Whether anything is waiting to be written to the socket, held messages included */
+    bool HasPendingOutput();
+
+    /* Compress message bodies of at least threshold bytes with algorithm from now on */
+    void SetCompression(unsigned int algorithm, unsigned int threshold);
+
+    /* Client side of DCGM_MSG_COMPRESSION_SETUP. promise is set once the reply arrives */
+    void AwaitCompressionSetup(std::promise<dcgmReturn_t> &&promise);
+    bool IsAwaitingCompressionSetup()
+    {
+        return m_compressionSetupPromise.has_value();
+    }
+    void OnCompressionSetupReply(DcgmMessage &reply);
+
+    DcgmIpcConnectionStats_t GetStats();
+};
+
+class DcgmIpc;
+
+/* An event loop and the connections it owns. Each connection belongs to exactly one
+   reactor, and only that reactor's thread may touch it. See DcgmIpc::Init */
+class DcgmIpcReactor : public DcgmThread
+{
+public:
+    DcgmIpc *m_ipc;          /* Instance of DcgmIpc this belongs to. Not owned here */
+    unsigned int m_index;    /* Index of this reactor in DcgmIpc::m_reactors */
+    event_base *m_eventBase; /* libevent base of this reactor. Owned here */
+    pthread_t m_threadId;    /* ID of the thread running m_eventBase's loop */
+
+    /* Tracking of connections - These should only be changed from m_threadId.
+       Use the ASSERT_IS_REACTOR_THREAD macro to verify you are in that thread before
+       reading or writing any of the following. */
+    std::unordered_map<struct bufferevent *, dcgm_connection_id_t> m_bevToConnectionId;
+    std::unordered_map<dcgm_connection_id_t, std::unique_ptr<DcgmIpcConnection>> m_connections;
+    std::unordered_map<int, dcgm_connection_id_t> m_shmWakeFdToConnectionId; /* Shared-memory wake fds */
+    dcgmTransportCounters_t m_closedConnectionCounters {}; /* Traffic of connections that were removed */
+    dcgmSendQueueStats_t m_closedSendQueueStats {};        /* Drops of connections that were removed */
+    std::atomic<unsigned int> m_numConnections { 0 };      /* m_connections.size() for other threads */
+
+    DcgmIpcReactor(DcgmIpc *ipc, unsigned int index);
+    ~DcgmIpcReactor();
+
+    /* Drop every connection. Only call this from m_threadId or once it has exited */
+    void ClearConnections();
+
+    /*************************************************************************/
+    /* Inherited from DcgmThread(). Only reactors after the first are started.
+       The first one runs on DcgmIpc's own thread along with the listeners */
+    void OnStop() override;
+    void run() override;
 };
 
 class DcgmIpc : public DcgmThread
 {
 private:
-    /* libevent base class instance */
-    event_base *m_eventBase;
+    /* Reactors that connections are spread over. The first one also runs our
+       listeners and is driven by this instance's own thread */
+    std::vector<std::unique_ptr<DcgmIpcReactor>> m_reactors;
+
     evdns_base *m_dnsBase;
     struct event *m_tcpListenEvent;
     struct event *m_domainListenEvent;
@@ -107,10 +276,22 @@ private:
     std::optional<DcgmIpcTcpServerParams_t> m_tcpParameters;
     std::optional<DcgmIpcDomainServerParams_t> m_domainParameters;
 
+    /* Bounds on what every connection buffers for its peer */
+    DcgmIpcSendQueueParams_t m_sendQueueParams;
+
     /* Worker threads where cllbacks like
        ProcessMessage() and OnClientDisconnect() are called from */
     DcgmNs::ThreadPool m_workersPool;
 
+    /* Used instead of m_workersPool if work stealing was asked for. m_workersPool then has no workers */
+    std::unique_ptr<DcgmNs::WorkStealingThreadPool> m_stealingPool;
+
+    /* Optional lanes that messages are processed on instead of m_workersPool, so that
+       slow requests can't hold up quick ones. See SetWorkerLanes() */
+    std::vector<std::unique_ptr<DcgmElasticWorkerPool>> m_lanes;
+    DcgmIpcClassifyMessageFunc_f m_classifyMessageFunc;
+    void *m_classifyMessageData;
+
     /* State of this instance's event base thread, including our server listeners */
     std::atomic<DcgmIpcState_t> m_state = DCGM_IPC_STATE_NOT_STARTED;
 
@@ -118,7 +299,7 @@ private:
     int m_tcpListenSocketFd;
     int m_domainListenSocketFd;
 
-    pthread_t m_ipcThreadId; /* ID of the IPC thread */
+    pthread_t m_ipcThreadId; /* ID of the IPC thread. This is also the first reactor's thread */
 
     /* Callback to call when processing messages from the worker thread */
     DcgmIpcProcessMessageFunc_f m_processMessageFunc;
@@ -132,11 +313,20 @@ private:
        GetNextConnectionId() to access this */
     std::atomic<dcgm_connection_id_t> m_connectionId = DCGM_CONNECTION_ID_NONE;
 
-    /* Tracking of connections - These should only be changed from the IPC thread.
-       Use the ASSERT_IS_IPC_THREAD macro to verify you are in the IPC thread before
-       reading or writing any of the following. */
-    std::unordered_map<struct bufferevent *, dcgm_connection_id_t> m_bevToConnectionId;
-    std::unordered_map<dcgm_connection_id_t, std::unique_ptr<DcgmIpcConnection>> m_connections;
+    /* A logical connection that shares the socket of another. See OpenMuxConnection() */
+    typedef struct
+    {
+        dcgm_connection_id_t carrierId; /* Connection whose socket this one's messages go over */
+        unsigned int muxId;             /* Identifies this connection in messages over carrierId */
+    } DcgmIpcMuxConnection_t;
+
+    /* Logical connections by their own connectionId, and their connectionIds by
+       carrier and muxId. Protected by m_muxMutex */
+    std::mutex m_muxMutex;
+    std::unordered_map<dcgm_connection_id_t, DcgmIpcMuxConnection_t> m_muxConnections;
+    std::unordered_map<dcgm_connection_id_t, std::unordered_map<unsigned int, dcgm_connection_id_t>> m_muxByCarrier;
+    std::atomic<size_t> m_numMuxConnections { 0 }; /* m_muxConnections.size(), read without the lock */
+    std::atomic<unsigned int> m_muxId { 0 };        /* Last muxId this side opened */
 
     /* Start-up promise. gets set by worker thread after init finishes or fails */
     std::promise<dcgmReturn_t> m_initPromise;
@@ -147,7 +337,12 @@ public:
     static const int DCGM_IPC_CONNECTION_BACKLOG = 6;
 
     /*************************************************************************/
-    explicit DcgmIpc(int numWorkerThreads);
+    /* numWorkerThreads IN: Threads that callbacks are called from
+     * workStealing     IN: Give each worker its own queue and let idle workers steal from busy ones, rather than
+     *                      have them all share one queue. Cheaper under bursts of small requests.
+     *                      See WorkStealingThreadPool.hpp
+     */
+    explicit DcgmIpc(int numWorkerThreads, bool workStealing = false);
     ~DcgmIpc();
 
     /*************************************************************************/
@@ -156,13 +351,51 @@ public:
     void run() override;
 
     /*************************************************************************/
-    /* Soft constructor. Returns DCGM_ST_OK on success */
+    /* Soft constructor. Returns DCGM_ST_OK on success
+     *
+     * numReactors IN: How many event loops to spread connections over, each on its own
+     *                 thread. Connections are assigned round-robin by connectionId.
+     *                 Messages are processed on the worker pool either way
+     */
     dcgmReturn_t Init(std::optional<DcgmIpcTcpServerParams_t> tcpParameters,
                       std::optional<DcgmIpcDomainServerParams_t> domainParameters,
                       DcgmIpcProcessMessageFunc_f processMessageFunc,
                       void *processMessageData,
                       DcgmIpcProcessDisconnectFunc_f processDisconnectFunc,
-                      void *processDisconnectData);
+                      void *processDisconnectData,
+                      unsigned int numReactors = 1);
+
+    /*************************************************************************/
+    /* Bound what connections buffer for peers that don't keep up. Call this before
+       Init(). Connections buffer without bound by default */
+    void SetSendQueueParams(DcgmIpcSendQueueParams_t const &params);
+
+    /*************************************************************************/
+    /* Process received messages on separate worker lanes rather than on the
+     * worker pool given to the constructor. Call this before Init().
+     *
+     * lanes                IN: Sizing of each lane's workers, which grow under load
+     *                          and shrink when idle. See DcgmElasticWorkerPool.h
+     * classifyMessageFunc  IN: Picks the lane of each message. Messages of lanes
+     *                          that don't exist go to the constructor's pool, which
+     *                          also keeps handling disconnects
+     * classifyMessageData  IN: User data passed to classifyMessageFunc
+     *
+     * Messages of one connection that land in different lanes can be processed
+     * out of order
+     */
+    void SetWorkerLanes(std::vector<DcgmElasticWorkerPoolParams_t> const &lanes,
+                        DcgmIpcClassifyMessageFunc_f classifyMessageFunc,
+                        void *classifyMessageData);
+
+    /*************************************************************************/
+    /* Sizing and counters of each lane given to SetWorkerLanes(), by lane index */
+    void GetWorkerLaneStats(std::vector<DcgmElasticWorkerPoolParams_t> &params,
+                            std::vector<DcgmElasticWorkerPoolStats_t> &stats);
+
+    /*************************************************************************/
+    /* Number of open connections across all reactors. Can be called from any thread */
+    unsigned int GetConnectionCount();
 
     /*************************************************************************/
     /* Connect to a TCP/IP Host
@@ -171,25 +404,39 @@ public:
      * port          IN: TCP port to connect to
      * connectionId OUT: Connection ID that was allocated for this
      * timeoutMs     IN: How long to wait for this connection to establish in ms
+     * compression   IN: DCGM_TRANSPORT_COMPRESSION_? to ask the server to compress messages
+     *                   with. If the server won't, messages are sent uncompressed
+     * compressionThreshold IN: Smallest message body to compress. 0 = the server's default
      *
      * Returns: DCGM_ST_OK if the request was successful.
      *          DCGM_ST_CONNECTION_NOT_VALID if the connection failed
      *
      */
-    dcgmReturn_t ConnectTcp(std::string hostname, int port, dcgm_connection_id_t &connectionId, unsigned int timeoutMs);
+    dcgmReturn_t ConnectTcp(std::string hostname,
+                            int port,
+                            dcgm_connection_id_t &connectionId,
+                            unsigned int timeoutMs,
+                            unsigned int compression          = DCGM_TRANSPORT_COMPRESSION_NONE,
+                            unsigned int compressionThreshold = 0);
 
     /*************************************************************************/
     /* Connect to a domain socket
      *
-     * path          IN: Domain socket to connect to
-     * connectionId OUT: Connection ID that was allocated for this
-     * timeoutMs     IN: How long to wait for this connection to establish in ms
+     * path            IN: Domain socket to connect to
+     * connectionId   OUT: Connection ID that was allocated for this
+     * timeoutMs       IN: How long to wait for this connection to establish in ms
+     * useSharedMemory IN: Ask the server for a shared-memory channel (see DcgmIpcShm.h)
+     *                     and send messages over it. If the server doesn't set one up,
+     *                     the connection falls back to the socket
      *
      * Returns: DCGM_ST_OK if the request was successful.
      *          DCGM_ST_CONNECTION_NOT_VALID if the connection failed
      *
      */
-    dcgmReturn_t ConnectDomain(std::string path, dcgm_connection_id_t &connectionId, unsigned int timeoutMs);
+    dcgmReturn_t ConnectDomain(std::string path,
+                               dcgm_connection_id_t &connectionId,
+                               unsigned int timeoutMs,
+                               bool useSharedMemory = false);
 
     /*************************************************************************/
     /* Send a message to a given connectionId. Note that this returns once the
@@ -218,6 +465,37 @@ public:
      */
     dcgmReturn_t CloseConnection(dcgm_connection_id_t connectionId);
 
+    /*************************************************************************/
+    /* Open a logical connection that shares the socket of another. Its messages
+     * are wrapped in DCGM_MSG_MUX and the server sees it as a connection of its
+     * own, with its own connectionId and disconnect. Closing it with
+     * CloseConnection() leaves the carrier open. Closing the carrier closes it.
+     *
+     * carrierId     IN: Connection from ConnectTcp() or ConnectDomain() to share.
+     *                   A logical connection shares the socket of its carrier
+     * connectionId OUT: Connection ID that was allocated for the logical connection
+     *
+     * Returns: DCGM_ST_OK if the request was successful.
+     *          DCGM_ST_CONNECTION_NOT_VALID if carrierId isn't a connection
+     *          DCGM_ST_MAX_LIMIT if carrierId already carries DCGM_IPC_MAX_MUX_CONNECTIONS
+     *
+     */
+    dcgmReturn_t OpenMuxConnection(dcgm_connection_id_t carrierId, dcgm_connection_id_t &connectionId);
+
+    /*************************************************************************/
+    /* Get the compression settings and traffic of a connection. Logical connections
+     * from OpenMuxConnection() report those of their carrier
+     *
+     * connectionId  IN: Connection to get the stats of. DCGM_CONNECTION_ID_NONE = the
+     *                   traffic of every connection, including closed ones
+     * stats        OUT: The stats
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_CONNECTION_NOT_VALID if connectionId isn't a connection
+     *
+     */
+    dcgmReturn_t GetConnectionStats(dcgm_connection_id_t connectionId, DcgmIpcConnectionStats_t &stats);
+
 private:
     /*************************************************************************/
     /* Helpers to start listening sockets */
@@ -227,15 +505,21 @@ private:
     /*************************************************************************/
     dcgm_connection_id_t GetNextConnectionId();
 
+    /* Reactor that owns connectionId */
+    DcgmIpcReactor &ReactorOf(dcgm_connection_id_t connectionId);
+
     /*************************************************************************/
-    /* Track and untrack connections */
-    dcgmReturn_t AddConnection(struct bufferevent *bev,
+    /* Track and untrack connections of a reactor */
+    dcgmReturn_t AddConnection(DcgmIpcReactor &reactor,
+                               struct bufferevent *bev,
                                dcgm_connection_id_t connectionId,
                                DcgmIpcConnectionState_t initialConnState,
                                std::promise<dcgmReturn_t> &&connectPromise);
-    dcgmReturn_t RemoveConnectionByBev(struct bufferevent *bev);
-    dcgmReturn_t RemoveConnectionById(dcgm_connection_id_t connectionId);
-    dcgmReturn_t SetConnectionState(dcgm_connection_id_t connectionId, DcgmIpcConnectionState_t state);
+    dcgmReturn_t RemoveConnectionByBev(DcgmIpcReactor &reactor, struct bufferevent *bev);
+    dcgmReturn_t RemoveConnectionById(DcgmIpcReactor &reactor, dcgm_connection_id_t connectionId);
+    dcgmReturn_t SetConnectionState(DcgmIpcReactor &reactor,
+                                    dcgm_connection_id_t connectionId,
+                                    DcgmIpcConnectionState_t state);
 
     /*****************************************************************************/
     class DcgmIpcConnectTcp
@@ -259,6 +543,31 @@ private:
     static void ConnectTcpAsyncImplCB(evutil_socket_t, short, void *data);
     void ConnectTcpAsyncImpl(DcgmIpcConnectTcp &tcpConnect);
 
+    /*****************************************************************************/
+    class DcgmIpcSetupCompression
+    {
+    public:
+        DcgmIpc *m_ipc;                       /* Instance of DcgmIpc this is associated with. Not owned here */
+        dcgm_connection_id_t m_connectionId;  /* Connection to set up compression of */
+        dcgm_msg_compression_setup_t m_setup; /* What to ask the server for */
+        std::promise<dcgmReturn_t> m_promise; /* Promise used to return the server's answer */
+
+        DcgmIpcSetupCompression(DcgmIpc *ipc, dcgm_connection_id_t connectionId, dcgm_msg_compression_setup_t setup)
+            : m_ipc(ipc)
+            , m_connectionId(connectionId)
+            , m_setup(setup)
+        {}
+    };
+
+    static void SetupCompressionImplCB(evutil_socket_t, short, void *data);
+    void SetupCompressionImpl(DcgmIpcSetupCompression &setupCompression);
+
+    /* Ask the server of connectionId to compress messages and wait up to timeoutMs for its answer */
+    dcgmReturn_t SetupCompression(dcgm_connection_id_t connectionId,
+                                  unsigned int compression,
+                                  unsigned int compressionThreshold,
+                                  unsigned int timeoutMs);
+
     /*****************************************************************************/
     class DcgmIpcConnectDomain
     {
@@ -268,11 +577,16 @@ private:
         dcgm_connection_id_t m_connectionId;  /* Connection ID that was assigned to this
                                              pending connect */
         std::promise<dcgmReturn_t> m_promise; /* Promise used to return if we connected or not */
+        int m_fd;                             /* Socket that is already connected. -1 = connect to m_path */
+
+        /* Shared-memory channel that was set up over m_fd. Optional */
+        std::unique_ptr<DcgmIpcShmChannel> m_shmChannel;
 
         DcgmIpcConnectDomain(DcgmIpc *ipc, std::string path, dcgm_connection_id_t connectionId)
             : m_ipc(ipc)
             , m_path(path)
             , m_connectionId(connectionId)
+            , m_fd(-1)
         {}
     };
 
@@ -314,15 +628,122 @@ private:
     static void CloseConnectionImplCB(evutil_socket_t, short, void *data);
     void CloseConnectionImpl(DcgmIpcCloseConnection &closeConnection);
 
+    /*****************************************************************************/
+    class DcgmIpcGetConnectionStats
+    {
+    public:
+        DcgmIpcReactor *m_reactor;            /* Reactor to get the stats from. Not owned here */
+        dcgm_connection_id_t m_connectionId;  /* Connection to get the stats of. DCGM_CONNECTION_ID_NONE =
+                                                 the traffic of every connection of m_reactor */
+        DcgmIpcConnectionStats_t *m_stats;    /* Where to put the stats. Owned by the waiting caller */
+        std::promise<dcgmReturn_t> m_promise; /* Promise used to return whether the connection was found */
+
+        DcgmIpcGetConnectionStats(DcgmIpcReactor *reactor,
+                                  dcgm_connection_id_t connectionId,
+                                  DcgmIpcConnectionStats_t *stats)
+            : m_reactor(reactor)
+            , m_connectionId(connectionId)
+            , m_stats(stats)
+        {}
+    };
+
+    static void GetConnectionStatsImplCB(evutil_socket_t, short, void *data);
+    void GetConnectionStatsImpl(DcgmIpcGetConnectionStats &getStats);
+
+    /* Get the stats of a connection, or of every connection, of reactor */
+    dcgmReturn_t GetReactorConnectionStats(DcgmIpcReactor &reactor,
+                                           dcgm_connection_id_t connectionId,
+                                           DcgmIpcConnectionStats_t &stats);
+
+    /*****************************************************************************/
+    class DcgmIpcAcceptConnection
+    {
+    public:
+        DcgmIpc *m_ipc;                      /* Instance of DcgmIpc this is associated with. Not owned here */
+        dcgm_connection_id_t m_connectionId; /* Connection ID that was assigned to the new client */
+        int m_fd;                            /* Accepted socket. Owned here until a bufferevent takes it */
+
+        DcgmIpcAcceptConnection(DcgmIpc *ipc, dcgm_connection_id_t connectionId, int fd)
+            : m_ipc(ipc)
+            , m_connectionId(connectionId)
+            , m_fd(fd)
+        {}
+    };
+
+    /* Start tracking a client that OnAccept() handed to the reactor of its connectionId */
+    static void AcceptConnectionImplCB(evutil_socket_t, short, void *data);
+    void AcceptConnectionImpl(DcgmIpcAcceptConnection &acceptConnection);
+
     /*************************************************************************/
     /* Libevent eventCB. Called on connect/disconnect */
+    /* ptr is the DcgmIpcReactor of the bev for all of these */
     static void StaticEventCB(struct bufferevent *bev, short events, void *ptr);
-    void EventCB(struct bufferevent *bev, short events);
+    void EventCB(DcgmIpcReactor &reactor, struct bufferevent *bev, short events);
 
     /*************************************************************************/
     /* Libevent readCB. Called when data is read from a socket */
     static void StaticReadCB(struct bufferevent *bev, void *ptr);
-    void ReadCB(bufferevent *bev);
+    void ReadCB(DcgmIpcReactor &reactor, bufferevent *bev);
+
+    /*************************************************************************/
+    /* Libevent writeCB. Called when the output of a socket drained to the low watermark */
+    static void StaticWriteCB(struct bufferevent *bev, void *ptr);
+    void WriteCB(DcgmIpcReactor &reactor, bufferevent *bev);
+
+    /* writeCB to give new bevs. Only set if messages can be held back */
+    bufferevent_data_cb GetWriteCB();
+
+    /*************************************************************************/
+    /* Libevent callback for the wake fd of a connection's shared-memory channel */
+    static void StaticShmWakeCB(evutil_socket_t fd, short events, void *ptr);
+    void ShmWakeCB(DcgmIpcReactor &reactor, int fd);
+
+    /*************************************************************************/
+    /* Server side of DCGM_MSG_SHM_SETUP. Replies to the client with the channel's
+       fds or with an error status if the connection stays on the socket */
+    void SetupShmChannel(DcgmIpcReactor &reactor,
+                         struct bufferevent *bev,
+                         DcgmIpcConnection *connection,
+                         DcgmMessage &request);
+
+    /* Watch the wake fd of shmChannel and move connectionId's messages to it */
+    dcgmReturn_t AttachShmChannel(DcgmIpcReactor &reactor,
+                                  dcgm_connection_id_t connectionId,
+                                  DcgmIpcConnection *connection,
+                                  std::unique_ptr<DcgmIpcShmChannel> shmChannel);
+
+    /*************************************************************************/
+    /* Both sides of DCGM_MSG_COMPRESSION_SETUP. Servers answer requests and
+       clients take the answer to theirs */
+    void OnCompressionSetup(dcgm_connection_id_t connectionId, DcgmIpcConnection *connection, DcgmMessage &message);
+
+    /*************************************************************************/
+    /* Hand messages read from connectionId to the worker pool. DCGM_MSG_MUX
+       messages are unwrapped and handed off as their logical connection's */
+    void DispatchMessages(dcgm_connection_id_t connectionId, std::vector<std::unique_ptr<DcgmMessage>> &messages);
+
+    /*************************************************************************/
+    /* Logical connections of OpenMuxConnection(). These can be called from any thread */
+
+    /* Look up connectionId. Returns false if it isn't a logical connection */
+    bool FindMuxConnection(dcgm_connection_id_t connectionId, DcgmIpcMuxConnection_t &mux);
+
+    /* Unwrap a DCGM_MSG_MUX that arrived over carrierId. Returns the connectionId of
+       its logical connection, which servers open here, or DCGM_CONNECTION_ID_NONE if
+       the message should be dropped */
+    dcgm_connection_id_t DemuxMessage(dcgm_connection_id_t carrierId, DcgmMessage &message);
+
+    /* The peer of carrierId closed one of the logical connections it carries */
+    void OnMuxClose(dcgm_connection_id_t carrierId, DcgmMessage &message);
+
+    /* Stop tracking the logical connections of a carrier that went away. Returns their connectionIds */
+    std::vector<dcgm_connection_id_t> RemoveMuxConnections(dcgm_connection_id_t carrierId);
+
+    /* Tell the peer of carrierId that muxId was closed */
+    void SendMuxClose(dcgm_connection_id_t carrierId, unsigned int muxId);
+
+    /* Queue the disconnect callback of connectionId on the worker pool */
+    void EnqueueProcessDisconnect(dcgm_connection_id_t connectionId);
 
     /*************************************************************************/
     /* Libevent acceptCB. Called when a new connection is ready to accept */
@@ -331,9 +752,9 @@ private:
 
     /*************************************************************************/
     /* Helper methods for converting a bev or connectionId to a pointer to a DcgmIpcConnection object
-       These are only safe to call from the IPC main thread */
-    dcgm_connection_id_t BevToConnectionId(struct bufferevent *bev);
-    DcgmIpcConnection *ConnectionIdToPtr(dcgm_connection_id_t connectionId);
+       These are only safe to call from the thread of reactor */
+    dcgm_connection_id_t BevToConnectionId(DcgmIpcReactor &reactor, struct bufferevent *bev);
+    DcgmIpcConnection *ConnectionIdToPtr(DcgmIpcReactor &reactor, dcgm_connection_id_t connectionId);
 
     /*************************************************************************/
     /* Function to call to process a message in our worker pool. We queue this outside
@@ -360,6 +781,21 @@ private:
 
     static void ProcessDisconnectInPool(DcgmIpcProcessDisconnect_t &processMe);
 
+    /*************************************************************************/
+    /* Run func on whichever worker pool this instance uses */
+    template <class Func>
+    void EnqueueOnWorkers(Func func)
+    {
+        if (m_stealingPool)
+        {
+            m_stealingPool->Enqueue(std::move(func));
+        }
+        else
+        {
+            m_workersPool.Enqueue(std::move(func));
+        }
+    }
+
     /*************************************************************************/
     /* Helper method to wait for a connection future for a given timeout */
     dcgmReturn_t WaitForConnectHelper(dcgm_connection_id_t connectionId,
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmIpcCompression.h"
+#include <DcgmLogging.h>
+
+#include <ctime>
+#include <zlib.h>
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcCompress(unsigned int algorithm, char const *src, size_t srcSize, std::vector<char> &dest)
+{
+    if (algorithm != DCGM_TRANSPORT_COMPRESSION_ZLIB)
+    {
+        DCGM_LOG_ERROR << "Unknown compression algorithm " << algorithm;
+        return DCGM_ST_NOT_SUPPORTED;
+    }
+
+    size_t const offset = dest.size();
+    uLongf destSize     = compressBound((uLong)srcSize);
+    dest.resize(offset + destSize);
+
+    int zRet = compress2(
+        (Bytef *)dest.data() + offset, &destSize, (Bytef const *)src, (uLong)srcSize, DCGM_IPC_COMPRESSION_ZLIB_LEVEL);
+    if (zRet != Z_OK)
+    {
+        DCGM_LOG_ERROR << "compress2 of " << srcSize << " bytes returned " << zRet;
+        dest.resize(offset);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    dest.resize(offset + destSize);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcDecompress(unsigned int algorithm, char const *src, size_t srcSize, char *dest, size_t destSize)
+{
+    if (algorithm != DCGM_TRANSPORT_COMPRESSION_ZLIB)
+    {
+        DCGM_LOG_ERROR << "Unknown compression algorithm " << algorithm;
+        return DCGM_ST_NOT_SUPPORTED;
+    }
+
+    uLongf actualSize = (uLongf)destSize;
+    int zRet          = uncompress((Bytef *)dest, &actualSize, (Bytef const *)src, (uLong)srcSize);
+    if (zRet != Z_OK || actualSize != destSize)
+    {
+        DCGM_LOG_ERROR << "uncompress of " << srcSize << " bytes returned " << zRet << " with " << actualSize << "/"
+                       << destSize << " bytes";
+        return DCGM_ST_BADPARAM;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+long long DcgmIpcThreadCpuUsec()
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <dcgm_structs.h>
+#include <vector>
+
+/* Smallest message body that is compressed when a client doesn't pick a threshold.
+   Smaller messages are mostly single requests and responses that don't shrink enough
+   to pay for the CPU time */
+#define DCGM_IPC_COMPRESSION_DEFAULT_THRESHOLD 4096
+
+/* zlib level messages are deflated with. The host engine compresses for every client
+   it has, so this favors speed over ratio */
+#define DCGM_IPC_COMPRESSION_ZLIB_LEVEL 1
+
+/*****************************************************************************/
+/*
+ * Compress a message body
+ *
+ * algorithm IN: DCGM_TRANSPORT_COMPRESSION_? other than NONE
+ * src       IN: Bytes to compress
+ * srcSize   IN: Number of bytes at src
+ * dest     OUT: The compressed bytes are appended to this
+ *
+ * Returns: DCGM_ST_OK on success
+ *          DCGM_ST_NOT_SUPPORTED if algorithm is unknown
+ *          DCGM_ST_GENERIC_ERROR if the compressor failed
+ */
+dcgmReturn_t DcgmIpcCompress(unsigned int algorithm, char const *src, size_t srcSize, std::vector<char> &dest);
+
+/*****************************************************************************/
+/*
+ * Decompress a message body compressed by DcgmIpcCompress
+ *
+ * algorithm IN: DCGM_TRANSPORT_COMPRESSION_? src was compressed with
+ * src       IN: Compressed bytes
+ * srcSize   IN: Number of bytes at src
+ * dest     OUT: Where to put the decompressed bytes
+ * destSize  IN: Exact number of bytes src decompresses to
+ *
+ * Returns: DCGM_ST_OK on success
+ *          DCGM_ST_NOT_SUPPORTED if algorithm is unknown
+ *          DCGM_ST_BADPARAM if src is corrupt or doesn't decompress to destSize bytes
+ */
+dcgmReturn_t DcgmIpcDecompress(unsigned int algorithm, char const *src, size_t srcSize, char *dest, size_t destSize);
+
+/*****************************************************************************/
+/* CPU time the calling thread has used in usec. For timing compression */
+long long DcgmIpcThreadCpuUsec();
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmIpcShm.h"
+#include <DcgmLogging.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Start of a channel's mapping. Ring 0 (client to server) follows, then ring 1 (server to client) */
+typedef struct
+{
+    alignas(64) uint32_t magic; /* DCGM_IPC_SHM_MAGIC */
+    uint32_t ringSize;          /* Bytes of data of each ring */
+} dcgm_ipc_shm_header_t;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring counters must be lock-free to be shared");
+
+/*****************************************************************************/
+/* Offset of ring index's control block from the start of the mapping */
+static size_t DcgmIpcShmRingOffset(unsigned int ringSize, int index)
+{
+    return sizeof(dcgm_ipc_shm_header_t) + index * (sizeof(dcgm_ipc_shm_ring_t) + ringSize);
+}
+
+/*****************************************************************************/
+/* Copy into a ring's data at free-running position pos, wrapping at its end */
+static void DcgmIpcShmCopyIn(char *data, unsigned int ringSize, uint64_t pos, char const *src, size_t length)
+{
+    size_t offset = pos & (ringSize - 1);
+    size_t first  = std::min(length, ringSize - offset);
+
+    memcpy(&data[offset], src, first);
+    memcpy(data, src + first, length - first);
+}
+
+/*****************************************************************************/
+static void DcgmIpcShmCopyOut(char const *data, unsigned int ringSize, uint64_t pos, char *dest, size_t length)
+{
+    size_t offset = pos & (ringSize - 1);
+    size_t first  = std::min(length, ringSize - offset);
+
+    memcpy(dest, &data[offset], first);
+    memcpy(dest + first, data, length - first);
+}
+
+/*****************************************************************************/
+DcgmIpcShmChannel::DcgmIpcShmChannel()
+    : m_isServer(false)
+    , m_memFd(-1)
+    , m_serverEventFd(-1)
+    , m_clientEventFd(-1)
+    , m_ringSize(0)
+    , m_mapSize(0)
+    , m_map(nullptr)
+    , m_outRing(nullptr)
+    , m_outData(nullptr)
+    , m_inRing(nullptr)
+    , m_inData(nullptr)
+    , m_pendingOffset(0)
+    , m_readOffset(0)
+{}
+
+/*****************************************************************************/
+DcgmIpcShmChannel::~DcgmIpcShmChannel()
+{
+    Unmap();
+
+    for (int fd : { m_memFd, m_serverEventFd, m_clientEventFd })
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+/*****************************************************************************/
+void DcgmIpcShmChannel::Unmap()
+{
+    if (m_map != nullptr)
+    {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+    }
+    m_outRing = nullptr;
+    m_outData = nullptr;
+    m_inRing  = nullptr;
+    m_inData  = nullptr;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcShmChannel::MapChannel(bool initialize)
+{
+    m_mapSize = DcgmIpcShmRingOffset(m_ringSize, 2);
+
+    if (initialize && ftruncate(m_memFd, (off_t)m_mapSize) != 0)
+    {
+        DCGM_LOG_ERROR << "ftruncate of shared-memory channel to " << m_mapSize << " failed. errno " << errno;
+        return DCGM_ST_MEMORY;
+    }
+
+    m_map = mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_memFd, 0);
+    if (m_map == MAP_FAILED)
+    {
+        DCGM_LOG_ERROR << "mmap of shared-memory channel failed. errno " << errno;
+        m_map = nullptr;
+        return DCGM_ST_MEMORY;
+    }
+
+    char *base                     = (char *)m_map;
+    dcgm_ipc_shm_header_t *header  = (dcgm_ipc_shm_header_t *)base;
+    dcgm_ipc_shm_ring_t *rings[2]  = { (dcgm_ipc_shm_ring_t *)(base + DcgmIpcShmRingOffset(m_ringSize, 0)),
+                                      (dcgm_ipc_shm_ring_t *)(base + DcgmIpcShmRingOffset(m_ringSize, 1)) };
+
+    if (initialize)
+    {
+        /* The memfd starts zeroed. Construct the atomics in place */
+        new (rings[0]) dcgm_ipc_shm_ring_t {};
+        new (rings[1]) dcgm_ipc_shm_ring_t {};
+        header->ringSize = m_ringSize;
+        header->magic    = DCGM_IPC_SHM_MAGIC;
+    }
+    else if (header->magic != DCGM_IPC_SHM_MAGIC || header->ringSize != m_ringSize)
+    {
+        DCGM_LOG_ERROR << "Shared-memory channel has magic 0x" << std::hex << header->magic << std::dec
+                       << " and ring size " << header->ringSize << ". Expected ring size " << m_ringSize;
+        Unmap();
+        return DCGM_ST_CONNECTION_NOT_VALID;
+    }
+
+    int outIndex = m_isServer ? 1 : 0;
+    m_outRing    = rings[outIndex];
+    m_outData    = (char *)(m_outRing + 1);
+    m_inRing     = rings[1 - outIndex];
+    m_inData     = (char *)(m_inRing + 1);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcShmChannel::Create(unsigned int ringSize)
+{
+    if (ringSize < sizeof(dcgm_message_header_t) || (ringSize & (ringSize - 1)) != 0 || m_map != nullptr)
+    {
+        DCGM_LOG_ERROR << "Bad ring size " << ringSize << " or channel already set up";
+        return DCGM_ST_BADPARAM;
+    }
+
+    m_isServer = true;
+    m_ringSize = ringSize;
+
+    m_memFd         = memfd_create("dcgm_ipc_shm", MFD_CLOEXEC);
+    m_serverEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_clientEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_memFd < 0 || m_serverEventFd < 0 || m_clientEventFd < 0)
+    {
+        DCGM_LOG_ERROR << "Unable to create the fds of a shared-memory channel. errno " << errno;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return MapChannel(true);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcShmChannel::Attach(int const (&fds)[DCGM_IPC_SHM_NUM_FDS], unsigned int ringSize)
+{
+    m_isServer      = false;
+    m_memFd         = fds[0];
+    m_serverEventFd = fds[1];
+    m_clientEventFd = fds[2];
+    m_ringSize      = ringSize;
+
+    if (m_map != nullptr || m_memFd < 0 || m_serverEventFd < 0 || m_clientEventFd < 0 || ringSize == 0
+        || (ringSize & (ringSize - 1)) != 0)
+    {
+        DCGM_LOG_ERROR << "Bad shared-memory channel fds or ring size " << ringSize;
+        return DCGM_ST_BADPARAM;
+    }
+
+    return MapChannel(false);
+}
+
+/*****************************************************************************/
+void DcgmIpcShmChannel::GetSetupFds(int (&fds)[DCGM_IPC_SHM_NUM_FDS]) const
+{
+    fds[0] = m_memFd;
+    fds[1] = m_serverEventFd;
+    fds[2] = m_clientEventFd;
+}
+
+/*****************************************************************************/
+void DcgmIpcShmChannel::AcknowledgeWake()
+{
+    uint64_t count;
+
+    /* Nonblocking. Fails with EAGAIN if the counter was already 0 */
+    (void)!read(GetWakeFd(), &count, sizeof(count));
+}
+
+/*****************************************************************************/
+void DcgmIpcShmChannel::WakePeer()
+{
+    uint64_t one = 1;
+    int peerFd   = m_isServer ? m_clientEventFd : m_serverEventFd;
+
+    /* Can only fail if the counter would overflow, in which case the peer is already awake */
+    (void)!write(peerFd, &one, sizeof(one));
+}
+
+/*****************************************************************************/
+bool DcgmIpcShmChannel::WriteFront()
+{
+    DcgmMessage &message           = *m_pending.front();
+    dcgm_message_header_t *header  = message.GetMessageHdr();
+    std::vector<char> *body        = message.GetMsgBytesPtr();
+    size_t const totalSize         = sizeof(*header) + body->size();
+
+    uint64_t tail = m_outRing->tail.load(std::memory_order_relaxed);
+    uint64_t head = m_outRing->head.load(std::memory_order_seq_cst);
+    size_t room   = m_ringSize - (size_t)(tail - head);
+
+    /* A header is never split, so the consumer can always read one whole */
+    if (m_pendingOffset == 0 && room < sizeof(*header))
+        room = 0;
+
+    if (room < totalSize - m_pendingOffset)
+    {
+        /* Ask to be woken once the consumer frees space, then check that it didn't just do so */
+        m_outRing->producerWaiting.store(1, std::memory_order_seq_cst);
+        head = m_outRing->head.load(std::memory_order_seq_cst);
+        room = m_ringSize - (size_t)(tail - head);
+        if (m_pendingOffset == 0 && room < sizeof(*header))
+            room = 0;
+    }
+
+    uint64_t start = tail;
+    while (room > 0 && m_pendingOffset < totalSize)
+    {
+        char const *src;
+        size_t length;
+
+        if (m_pendingOffset < sizeof(*header))
+        {
+            src    = (char const *)header + m_pendingOffset;
+            length = sizeof(*header) - m_pendingOffset;
+        }
+        else
+        {
+            src    = body->data() + (m_pendingOffset - sizeof(*header));
+            length = totalSize - m_pendingOffset;
+        }
+
+        length = std::min(length, room);
+        DcgmIpcShmCopyIn(m_outData, m_ringSize, tail, src, length);
+        tail += length;
+        room -= length;
+        m_pendingOffset += length;
+    }
+
+    if (tail != start)
+    {
+        m_outRing->tail.store(tail, std::memory_order_seq_cst);
+
+        /* The consumer drains until the ring is empty, so it only needs waking if it was */
+        if (m_outRing->head.load(std::memory_order_seq_cst) == start)
+            WakePeer();
+    }
+
+    if (m_pendingOffset < totalSize)
+        return false;
+
+    m_pending.pop_front();
+    m_pendingOffset = 0;
+    return true;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcShmChannel::SendMessage(std::unique_ptr<DcgmMessage> dcgmMessage)
+{
+    if (m_outRing == nullptr)
+    {
+        DCGM_LOG_ERROR << "SendMessage on a shared-memory channel that isn't set up";
+        return DCGM_ST_CONNECTION_NOT_VALID;
+    }
+
+    m_pending.push_back(std::move(dcgmMessage));
+    return FlushPending();
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcShmChannel::FlushPending()
+{
+    while (!m_pending.empty())
+    {
+        if (!WriteFront())
+            break;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmIpcShmChannel::ReadMessages(std::vector<std::unique_ptr<DcgmMessage>> &messages)
+{
+    dcgmReturn_t retSt = DCGM_ST_NO_DATA;
+
+    if (m_inRing == nullptr)
+        return DCGM_ST_CONNECTION_NOT_VALID;
+
+    uint64_t head = m_inRing->head.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        uint64_t tail    = m_inRing->tail.load(std::memory_order_seq_cst);
+        size_t available = (size_t)(tail - head);
+        if (available == 0)
+            break;
+
+        if (!m_readMessage)
+        {
+            /* Producers never split a header */
+            dcgm_message_header_t header;
+            if (available < sizeof(header))
+            {
+                DCGM_LOG_ERROR << "Shared-memory ring has " << available << " bytes, less than a header";
+                return DCGM_ST_CONNECTION_NOT_VALID;
+            }
+
+            DcgmIpcShmCopyOut(m_inData, m_ringSize, head, (char *)&header, sizeof(header));
+            head += sizeof(header);
+            available -= sizeof(header);
+
+            if (header.length < 0 || header.length > DCGM_PROTO_MAX_MESSAGE_SIZE)
+            {
+                DCGM_LOG_ERROR << "Got bad message size " << header.length << ". Closing connection.";
+                return DCGM_ST_CONNECTION_NOT_VALID;
+            }
+            if (header.msgId != DCGM_PROTO_MAGIC)
+            {
+                DCGM_LOG_ERROR << "Unexpected DCGM Proto ID " << std::hex << header.msgId;
+                return DCGM_ST_CONNECTION_NOT_VALID;
+            }
+
+            m_readMessage = std::make_unique<DcgmMessage>(&header);
+            m_readMessage->SetRequestId(header.requestId);
+            m_readMessage->GetMsgBytesPtr()->resize(header.length);
+            m_readOffset = 0;
+        }
+
+        std::vector<char> *body = m_readMessage->GetMsgBytesPtr();
+        size_t length           = std::min(available, body->size() - m_readOffset);
+
+        DcgmIpcShmCopyOut(m_inData, m_ringSize, head, body->data() + m_readOffset, length);
+        head += length;
+        m_readOffset += length;
+
+        /* Hand the space back right away so a producer streaming a large message can continue */
+        m_inRing->head.store(head, std::memory_order_seq_cst);
+        if (m_inRing->producerWaiting.load(std::memory_order_seq_cst)
+            && m_inRing->producerWaiting.exchange(0, std::memory_order_seq_cst))
+            WakePeer();
+
+        if (m_readOffset == body->size())
+        {
+            messages.push_back(std::move(m_readMessage));
+            retSt = DCGM_ST_OK;
+        }
+    }
+
+    return retSt;
+}
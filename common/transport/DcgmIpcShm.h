@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "DcgmProtocol.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <dcgm_structs.h>
+#include <memory>
+#include <vector>
+
+/* "DSHM". First word of a channel's mapping so a foreign memfd is rejected */
+#define DCGM_IPC_SHM_MAGIC 0x4d485344
+
+/* Bytes of each direction's ring. Must be a power of 2. Messages larger than
+   this are streamed through in pieces */
+#define DCGM_IPC_SHM_RING_SIZE (2 * 1024 * 1024)
+
+/* Number of file descriptors passed from the server to the client to set up a channel */
+#define DCGM_IPC_SHM_NUM_FDS 3
+
+/* Body of a DCGM_MSG_SHM_SETUP reply. The request has no body. The channel's
+   memfd, server eventfd and client eventfd are passed alongside it with SCM_RIGHTS */
+typedef struct
+{
+    unsigned int ringSize; /* Bytes of each direction's ring */
+} dcgm_msg_shm_setup_t;
+
+/* Control block of one direction of a channel. head and tail are free-running
+   byte counts, so tail - head is the number of unread bytes. They sit on their
+   own cache lines since each is written by a different process */
+typedef struct
+{
+    alignas(64) std::atomic<uint64_t> tail; /* Bytes written. Only stored by the producer */
+    alignas(64) std::atomic<uint64_t> head; /* Bytes read. Only stored by the consumer */
+    std::atomic<uint32_t> producerWaiting;  /* Set by a producer that ran out of space. The consumer
+                                               clears it and wakes the producer once it frees some */
+} dcgm_ipc_shm_ring_t;
+
+/*
+ * Shared-memory transport between a client and the host engine on the same
+ * machine: a pair of single-producer single-consumer byte rings in a memfd,
+ * carrying the same header + body messages as the socket. Each side waits on
+ * its own eventfd, which the peer writes to when it makes an empty ring
+ * non-empty or frees space the other side is waiting for.
+ *
+ * The server creates the channel and passes its file descriptors over the
+ * domain socket of the connection. The socket stays open so that either side
+ * going away is still noticed as a disconnect.
+ *
+ * This class is not thread safe. DcgmIpc only uses it from the reactor thread
+ * that owns the connection.
+ */
+class DcgmIpcShmChannel
+{
+public:
+    DcgmIpcShmChannel();
+    ~DcgmIpcShmChannel();
+
+    DcgmIpcShmChannel(const DcgmIpcShmChannel &)            = delete;
+    DcgmIpcShmChannel &operator=(const DcgmIpcShmChannel &) = delete;
+
+    /*************************************************************************/
+    /*
+     * Allocate a new channel as the server
+     *
+     * ringSize IN: Bytes of each direction's ring. Must be a power of 2
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_? on error
+     */
+    dcgmReturn_t Create(unsigned int ringSize);
+
+    /*************************************************************************/
+    /*
+     * Map a channel that a server created, as the client. Takes ownership of the
+     * file descriptors whether this succeeds or not
+     *
+     * fds      IN: File descriptors from GetSetupFds() of the server, in the same order
+     * ringSize IN: ringSize from the server's dcgm_msg_shm_setup_t
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_? on error
+     */
+    dcgmReturn_t Attach(int const (&fds)[DCGM_IPC_SHM_NUM_FDS], unsigned int ringSize);
+
+    /* File descriptors to pass to the client. Still owned by this object */
+    void GetSetupFds(int (&fds)[DCGM_IPC_SHM_NUM_FDS]) const;
+
+    unsigned int GetRingSize() const
+    {
+        return m_ringSize;
+    }
+
+    /* The eventfd this side waits on for new messages or freed space. Poll it for reading */
+    int GetWakeFd() const
+    {
+        return m_isServer ? m_serverEventFd : m_clientEventFd;
+    }
+
+    /* Reset the wake fd after it polled readable. Call before ReadMessages() and FlushPending() */
+    void AcknowledgeWake();
+
+    /*************************************************************************/
+    /*
+     * Queue a message to the peer. As much of it as fits is written right away.
+     * The rest is written by FlushPending() as the peer frees space
+     *
+     * Returns: DCGM_ST_OK if the message was written or queued
+     *          DCGM_ST_? on error
+     */
+    dcgmReturn_t SendMessage(std::unique_ptr<DcgmMessage> dcgmMessage);
+
+    /* Write as much of the queued messages as fits. Call when the wake fd fires */
+    dcgmReturn_t FlushPending();
+
+    /*************************************************************************/
+    /*
+     * Read the complete messages the peer has written. Has the same contract as
+     * DcgmIpcConnection::ReadMessages()
+     *
+     * Returns: DCGM_ST_OK if at least one message was read
+     *          DCGM_ST_NO_DATA if no complete message was available
+     *          DCGM_ST_CONNECTION_NOT_VALID if the peer wrote a bad header
+     */
+    dcgmReturn_t ReadMessages(std::vector<std::unique_ptr<DcgmMessage>> &messages);
+
+private:
+    bool m_isServer;
+    int m_memFd;
+    int m_serverEventFd; /* Waited on by the server */
+    int m_clientEventFd; /* Waited on by the client */
+    unsigned int m_ringSize;
+    size_t m_mapSize;
+    void *m_map;
+
+    dcgm_ipc_shm_ring_t *m_outRing; /* Written by this side */
+    char *m_outData;
+    dcgm_ipc_shm_ring_t *m_inRing; /* Read by this side */
+    char *m_inData;
+
+    /* Messages waiting for room in m_outRing. m_pendingOffset bytes of the front
+       one (counting its header) have been written */
+    std::deque<std::unique_ptr<DcgmMessage>> m_pending;
+    size_t m_pendingOffset;
+
+    /* Message being read from m_inRing. nullptr = a header is next */
+    std::unique_ptr<DcgmMessage> m_readMessage;
+    size_t m_readOffset; /* Bytes of m_readMessage's body read so far */
+
+    dcgmReturn_t MapChannel(bool initialize);
+    void Unmap();
+
+    /* Write as much of the front pending message as fits. Returns true if it was finished */
+    bool WriteFront();
+
+    /* Wake the peer's eventfd */
+    void WakePeer();
+};
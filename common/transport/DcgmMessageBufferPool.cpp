@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmMessageBufferPool.h"
+
+#include <algorithm>
+
+/*****************************************************************************/
+/* Smallest class whose buffers hold size bytes */
+static unsigned int ClassShiftFor(size_t size)
+{
+    unsigned int shift = DcgmMessageBufferPool::MIN_CLASS_SHIFT;
+    while (((size_t)1 << shift) < size)
+    {
+        shift++;
+    }
+    return shift;
+}
+
+/*****************************************************************************/
+DcgmMessageBufferPool::DcgmMessageBufferPool(size_t maxPooledBytes)
+    : m_maxPooledBytes(maxPooledBytes)
+{}
+
+/*****************************************************************************/
+DcgmMessageBufferPool &DcgmMessageBufferPool::Global()
+{
+    static DcgmMessageBufferPool *pool = new DcgmMessageBufferPool();
+    return *pool;
+}
+
+/*****************************************************************************/
+std::vector<char> DcgmMessageBufferPool::Acquire(size_t size)
+{
+    std::vector<char> buffer;
+    unsigned int shift = ClassShiftFor(size);
+
+    if (shift <= MAX_CLASS_SHIFT)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.acquires++;
+
+        auto &pooled = m_classes[shift - MIN_CLASS_SHIFT];
+        if (!pooled.empty())
+        {
+            buffer = std::move(pooled.back());
+            pooled.pop_back();
+            m_stats.hits++;
+            m_stats.pooledBytes -= buffer.capacity();
+            return buffer;
+        }
+    }
+
+    /* Round up so the buffer can go back into this class */
+    buffer.reserve(shift <= MAX_CLASS_SHIFT ? (size_t)1 << shift : size);
+    return buffer;
+}
+
+/*****************************************************************************/
+void DcgmMessageBufferPool::Release(std::vector<char> &&buffer)
+{
+    size_t capacity = buffer.capacity();
+    if (capacity < ((size_t)1 << MIN_CLASS_SHIFT))
+    {
+        return; /* Not worth keeping. Also covers moved-from buffers */
+    }
+
+    /* Largest class the capacity covers */
+    unsigned int shift = ClassShiftFor(capacity);
+    if (((size_t)1 << shift) > capacity)
+    {
+        shift--;
+    }
+
+    std::vector<char> toFree; /* Freed after unlocking */
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.releases++;
+
+        auto &pooled = m_classes[std::min(shift, MAX_CLASS_SHIFT) - MIN_CLASS_SHIFT];
+        if (shift > MAX_CLASS_SHIFT || pooled.size() >= MAX_BUFFERS_PER_CLASS
+            || m_stats.pooledBytes + capacity > m_maxPooledBytes)
+        {
+            m_stats.discarded++;
+            toFree = std::move(buffer);
+        }
+        else
+        {
+            buffer.clear();
+            m_stats.pooledBytes += capacity;
+            pooled.push_back(std::move(buffer));
+        }
+    }
+
+    buffer = std::vector<char>();
+}
+
+/*****************************************************************************/
+DcgmMessageBufferPoolStats_t DcgmMessageBufferPool::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/* Counters of a DcgmMessageBufferPool. For tests and logging */
+typedef struct
+{
+    unsigned long long acquires;  /* Buffers handed out by Acquire() */
+    unsigned long long hits;      /* ... of which came from the pool rather than malloc */
+    unsigned long long releases;  /* Buffers given back by Release() */
+    unsigned long long discarded; /* ... of which were freed since their class was full */
+    size_t pooledBytes;           /* Capacity of the buffers currently pooled */
+} DcgmMessageBufferPoolStats_t;
+
+/*
+ * Size-classed pool of message body storage, so that receiving a request and
+ * sending its reply don't malloc and free a body each time.
+ *
+ * Classes are powers of two from 256 bytes up to DCGM_PROTO_MAX_MESSAGE_SIZE.
+ * A buffer is pooled in the largest class its capacity covers. Each class keeps a
+ * bounded number of buffers and the pool as a whole a bounded number of bytes.
+ *
+ * DcgmMessage gets its body from Global() and gives it back when destroyed.
+ */
+class DcgmMessageBufferPool
+{
+public:
+    static constexpr unsigned int MIN_CLASS_SHIFT  = 8;  /* 256 bytes */
+    static constexpr unsigned int MAX_CLASS_SHIFT  = 22; /* 4 MB */
+    static constexpr unsigned int NUM_CLASSES      = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+    static constexpr size_t MAX_BUFFERS_PER_CLASS  = 64;
+    static constexpr size_t DEFAULT_MAX_POOL_BYTES = 32 * 1024 * 1024;
+
+    explicit DcgmMessageBufferPool(size_t maxPooledBytes = DEFAULT_MAX_POOL_BYTES);
+
+    /* The process-wide pool. Never destroyed, so messages can outlive static destructors */
+    static DcgmMessageBufferPool &Global();
+
+    /* An empty buffer with capacity for at least size bytes. Sizes past the largest
+       class are allocated as usual */
+    std::vector<char> Acquire(size_t size);
+
+    /* Keep buffer's storage for a later Acquire(). buffer is left empty */
+    void Release(std::vector<char> &&buffer);
+
+    DcgmMessageBufferPoolStats_t GetStats();
+
+private:
+    std::mutex m_mutex; /* Protects everything below */
+    std::array<std::vector<std::vector<char>>, NUM_CLASSES> m_classes;
+    size_t m_maxPooledBytes;
+    DcgmMessageBufferPoolStats_t m_stats {};
+};
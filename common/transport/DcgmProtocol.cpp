@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "DcgmProtocol.h"
+#include "DcgmMessageBufferPool.h"
 #include <arpa/inet.h>
 #include <memory.h>
 
@@ -25,9 +26,29 @@ DcgmMessage::DcgmMessage(dcgm_message_header_t *header)
     : m_messageHdr()
 {
     memcpy(&m_messageHdr, header, sizeof(m_messageHdr));
+
+    if (m_messageHdr.length > 0)
+    {
+        m_msgBytes = DcgmMessageBufferPool::Global().Acquire(m_messageHdr.length);
+    }
 }
 
-DcgmMessage::~DcgmMessage() = default;
+DcgmMessage::~DcgmMessage()
+{
+    DcgmMessageBufferPool::Global().Release(std::move(m_msgBytes));
+}
+
+DcgmMessage &DcgmMessage::operator=(DcgmMessage &&other)
+{
+    if (this != &other)
+    {
+        DcgmMessageBufferPool::Global().Release(std::move(m_msgBytes));
+        m_messageHdr   = other.m_messageHdr;
+        m_receivedTime = other.m_receivedTime;
+        m_msgBytes     = std::move(other.m_msgBytes);
+    }
+    return *this;
+}
 
 void DcgmMessage::UpdateMsgHdr(int msgType, dcgm_request_id_t requestId, int status, int length)
 {
@@ -48,6 +69,19 @@ std::vector<char> *DcgmMessage::GetMsgBytesPtr()
     return &m_msgBytes;
 }
 
+void DcgmMessage::ReserveMsgBytes(size_t capacity)
+{
+    if (m_msgBytes.capacity() >= capacity)
+    {
+        return;
+    }
+
+    std::vector<char> msgBytes = DcgmMessageBufferPool::Global().Acquire(capacity);
+    msgBytes.assign(m_msgBytes.begin(), m_msgBytes.end());
+    DcgmMessageBufferPool::Global().Release(std::move(m_msgBytes));
+    m_msgBytes = std::move(msgBytes);
+}
+
 size_t DcgmMessage::GetLength()
 {
     return m_msgBytes.size();
@@ -21,6 +21,7 @@
 #define DCGM_PROTOCOL_H
 
 #include "dcgm_structs.h"
+#include <chrono>
 #include <vector>
 
 /* Align to byte boundaries */
@@ -58,20 +59,174 @@ typedef struct
 /**
  * The following defines are used to recognize type of DCGM messages
  */
-#define DCGM_MSG_PROTO_REQUEST  0x0100 /* A Google protobuf-based request */
-#define DCGM_MSG_PROTO_RESPONSE 0x0200 /* A Google protobuf-based response to a request */
-#define DCGM_MSG_MODULE_COMMAND 0x0300 /* A module command message */
-#define DCGM_MSG_POLICY_NOTIFY  0x0400 /* Async notification of a policy violation */
-#define DCGM_MSG_REQUEST_NOTIFY 0x0500 /* Notify an async request that it will receive no further updates */
+#define DCGM_MSG_PROTO_REQUEST        0x0100 /* A Google protobuf-based request */
+#define DCGM_MSG_PROTO_RESPONSE       0x0200 /* A Google protobuf-based response to a request */
+#define DCGM_MSG_MODULE_COMMAND       0x0300 /* A module command message */
+#define DCGM_MSG_POLICY_NOTIFY        0x0400 /* Async notification of a policy violation */
+#define DCGM_MSG_REQUEST_NOTIFY       0x0500 /* Notify an async request that it will receive no further updates */
+#define DCGM_MSG_SHM_SETUP            0x0600 /* Move a domain socket connection to shared memory. See DcgmIpcShm.h */
+#define DCGM_MSG_FV_STREAM            0x0700 /* Batch of field values pushed to a field value stream */
+#define DCGM_MSG_FV_STREAM_ACK        0x0701 /* Client finished processing batches of a field value stream */
+#define DCGM_MSG_PROXY_FV_BATCH       0x0702 /* Host-tagged field values a proxy host engine gathered */
+#define DCGM_MSG_MODULE_COMMAND_BATCH 0x0800 /* Several module commands processed in one round trip */
+#define DCGM_MSG_COMPRESSION_SETUP    0x0900 /* Negotiate compression of the messages of a connection */
+#define DCGM_MSG_COMPRESSED           0x0901 /* A compressed message of another type */
+#define DCGM_MSG_ATTRIBUTE_GENERATION 0x0A00 /* Static attributes like the entity lists changed on the host engine */
+#define DCGM_MSG_MUX                  0x0B00 /* A message of a logical connection that shares another's socket */
+#define DCGM_MSG_MUX_CLOSE            0x0B01 /* Close a logical connection that shares another's socket */
 
 /* DCGM_MSG_POLICY_NOTIFY - Signal a client that a policy has been violated */
 typedef struct
 {
-    int begin;                             /* Whether this is the first response (1) or the second (0).
+    int begin;                              /* Whether this is the first response (1) or the second (0).
                                      This will determine if beginCB or finishCB is called. */
-    dcgmPolicyCallbackResponse_t response; /* Policy response to pass to client callbacks */
+    dcgmPolicyCallbackResponse_v2 response; /* Policy response to pass to client callbacks. Only the members of
+                                              dcgmPolicyCallbackResponse_v1 are set if that is its version */
 } dcgm_msg_policy_notify_t;
 
+/* Largest batch of buffered field values in one DCGM_MSG_FV_STREAM message. More values
+   are split over several batches */
+#define DCGM_FV_STREAM_MAX_BATCH_SIZE (1024 * 1024)
+
+/* DCGM_MSG_FV_STREAM - Field values for a stream. The header requestId is the
+ *                      stream's. Followed by bufferSize bytes of DcgmFvBuffer
+ **/
+typedef struct
+{
+    unsigned int version;    /* dcgm_msg_fv_stream_version */
+    unsigned int numValues;  /* Number of field values in the buffer */
+    unsigned int numDropped; /* Values dropped since the previous batch because the client fell behind */
+    unsigned int bufferSize; /* Bytes of DcgmFvBuffer after this struct */
+} dcgm_msg_fv_stream_v1;
+
+#define dcgm_msg_fv_stream_version1 1
+#define dcgm_msg_fv_stream_version  dcgm_msg_fv_stream_version1
+
+typedef dcgm_msg_fv_stream_v1 dcgm_msg_fv_stream_t;
+
+/* DCGM_MSG_FV_STREAM_ACK - Return flow control credit to a stream. No response is sent */
+typedef struct
+{
+    unsigned int numBatches; /* Number of DCGM_MSG_FV_STREAM batches the client is done with */
+} dcgm_msg_fv_stream_ack_t;
+
+/* DCGM_MSG_PROXY_FV_BATCH - Values of a proxy stream from the host engines behind a proxy.
+ *                           The header requestId is the stream's. Followed by numSections
+ *                           sections, each a dcgm_msg_proxy_fv_section_t followed by
+ *                           bufferSize bytes of DcgmFvBuffer. Acked with DCGM_MSG_FV_STREAM_ACK
+ **/
+typedef struct
+{
+    unsigned int version;     /* dcgm_msg_proxy_fv_batch_version */
+    unsigned int numSections; /* Number of host sections after this struct */
+} dcgm_msg_proxy_fv_batch_v1;
+
+#define dcgm_msg_proxy_fv_batch_version1 1
+#define dcgm_msg_proxy_fv_batch_version  dcgm_msg_proxy_fv_batch_version1
+
+typedef dcgm_msg_proxy_fv_batch_v1 dcgm_msg_proxy_fv_batch_t;
+
+typedef struct
+{
+    unsigned int hostId;     /* Index of the host engine in dcgmProxyHosts_v1::hosts */
+    unsigned int numValues;  /* Number of field values in the buffer */
+    unsigned int numDropped; /* Values of this host dropped since the previous batch because the client fell behind */
+    unsigned int bufferSize; /* Bytes of DcgmFvBuffer after this struct */
+} dcgm_msg_proxy_fv_section_t;
+
+/* Most module commands in one DCGM_MSG_MODULE_COMMAND_BATCH */
+#define DCGM_MODULE_COMMAND_BATCH_MAX_COMMANDS 256
+
+/* DCGM_MSG_MODULE_COMMAND_BATCH - Module commands for the host engine to process
+ *                                 in order. Followed by numCommands entries, each a
+ *                                 dcgm_msg_module_command_batch_entry_t and then a
+ *                                 module command of its header's length. The response
+ *                                 has the same layout with each command replaced by its
+ *                                 response and its status set. The header status is only
+ *                                 an error if the batch itself couldn't be processed
+ **/
+typedef struct
+{
+    unsigned int version;     /* dcgm_msg_module_command_batch_version */
+    unsigned int numCommands; /* Number of entries after this struct */
+} dcgm_msg_module_command_batch_v1;
+
+#define dcgm_msg_module_command_batch_version1 1
+#define dcgm_msg_module_command_batch_version  dcgm_msg_module_command_batch_version1
+
+typedef dcgm_msg_module_command_batch_v1 dcgm_msg_module_command_batch_t;
+
+typedef struct
+{
+    int status; /* Response: DCGM_ST_? the command returned. Ignored in the request */
+} dcgm_msg_module_command_batch_entry_t;
+
+/* DCGM_MSG_COMPRESSION_SETUP - Ask the peer to compress the messages it sends
+ *                              from now on. The reply has the same body, with the
+ *                              algorithm and threshold the peer went with. The
+ *                              header status of the reply is an error if it won't
+ *                              compress. Either side sends compressed messages once
+ *                              the reply is on the wire
+ **/
+typedef struct
+{
+    unsigned int version;   /* dcgm_msg_compression_setup_version */
+    unsigned int algorithm; /* DCGM_TRANSPORT_COMPRESSION_? */
+    unsigned int threshold; /* Message bodies with fewer bytes than this are sent as they are.
+                               0 in a request = DCGM_IPC_COMPRESSION_DEFAULT_THRESHOLD */
+} dcgm_msg_compression_setup_v1;
+
+#define dcgm_msg_compression_setup_version1 1
+#define dcgm_msg_compression_setup_version  dcgm_msg_compression_setup_version1
+
+typedef dcgm_msg_compression_setup_v1 dcgm_msg_compression_setup_t;
+
+/* DCGM_MSG_COMPRESSED - Wraps a message whose body didn't go out as it was. The
+ *                       header requestId and status are the original message's.
+ *                       Followed by the compressed body
+ **/
+typedef struct
+{
+    unsigned int algorithm; /* DCGM_TRANSPORT_COMPRESSION_? the body was compressed with */
+    int msgType;            /* msgType of the original message */
+    int length;             /* Length of the original message body */
+} dcgm_msg_compressed_t;
+
+/* DCGM_MSG_ATTRIBUTE_GENERATION - Tell a client that cached static attributes
+ *                                 are stale. The header requestId is the one the
+ *                                 client subscribed with. No response is sent
+ **/
+typedef struct
+{
+    unsigned int version;          /* dcgm_msg_attribute_generation_version */
+    unsigned int unused;           /* Unused. Aligns generation */
+    unsigned long long generation; /* The host engine's new attribute generation */
+} dcgm_msg_attribute_generation_v1;
+
+#define dcgm_msg_attribute_generation_version1 1
+#define dcgm_msg_attribute_generation_version  dcgm_msg_attribute_generation_version1
+
+typedef dcgm_msg_attribute_generation_v1 dcgm_msg_attribute_generation_t;
+
+/* DCGM_MSG_MUX - Wraps a message of a logical connection that is multiplexed
+ *                over the connection it is sent on. The header requestId and
+ *                status are the wrapped message's. Followed by the wrapped body.
+ *                A server opens the logical connection the first time it sees
+ *                its muxId
+ **/
+typedef struct
+{
+    unsigned int muxId; /* Logical connection the message belongs to. Never 0 */
+    int msgType;        /* msgType of the wrapped message */
+} dcgm_msg_mux_t;
+
+/* DCGM_MSG_MUX_CLOSE - The sender closed a logical connection. No response is sent
+ **/
+typedef struct
+{
+    unsigned int muxId; /* Logical connection that was closed */
+} dcgm_msg_mux_close_t;
+
 /* DCGM_MSG_REQUEST_NOTIFY - Notify an async request that it will receive
  *                           no further updates
  **/
@@ -85,7 +240,8 @@ class DcgmMessage
 {
 public:
     DcgmMessage();
-    DcgmMessage(dcgm_message_header_t *header); /* Set header from a network packet */
+    DcgmMessage(dcgm_message_header_t *header); /* Set header from a network packet. The body
+                                                   gets room for header->length bytes */
     ~DcgmMessage();
 
     /**
@@ -98,7 +254,7 @@ public:
      * Move Constructors
      */
     DcgmMessage(DcgmMessage &&other) = default;
-    DcgmMessage &operator=(DcgmMessage &&other) = default;
+    DcgmMessage &operator=(DcgmMessage &&other);
 
     /**
      * This method updates the message header to be sent over socket. mMessageHdr will be
@@ -117,6 +273,12 @@ public:
      */
     std::vector<char> *GetMsgBytesPtr();
 
+    /**
+     * Make room for capacity bytes of content without changing it. The storage comes from
+     * DcgmMessageBufferPool, so resizing the content up to capacity won't allocate
+     */
+    void ReserveMsgBytes(size_t capacity);
+
     /**
      * This message is used to get the length of the message
      */
@@ -141,11 +303,27 @@ public:
      */
     unsigned int GetRequestId();
 
+    /**
+     * When a received message was handed off to be processed. Set by DcgmIpc so the time the message
+     * spent queued for a worker can be measured. Default-constructed for messages that weren't received
+     */
+    void SetReceivedTime(std::chrono::steady_clock::time_point receivedTime)
+    {
+        m_receivedTime = receivedTime;
+    }
+
+    std::chrono::steady_clock::time_point GetReceivedTime() const
+    {
+        return m_receivedTime;
+    }
+
 private:
     dcgm_message_header_t m_messageHdr {}; /*!< Sender populates the message to be sent */
     std::vector<char> m_msgBytes;          /*!< The bytes of the message that come after m_messageHdr on the
                                                socket stream. The .size() member of this is the size of
-                                               the message. This should match m_messageHdr.length */
+                                               the message. This should match m_messageHdr.length.
+                                               Given back to DcgmMessageBufferPool when destroyed */
+    std::chrono::steady_clock::time_point m_receivedTime {}; /*!< See SetReceivedTime() */
 };
 
 #endif /* DCGM_PROTOCOL_H */
@@ -17,6 +17,9 @@
 #include <DcgmLogging.h>
 
 #include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 /*
  * Cublas
@@ -104,6 +107,52 @@ cublasStatus_t CublasHgemm(cublasHandle_t handle,
 {
     MAKE_API_CALL(cublasHgemm, handle, transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
+#if (CUDA_VERSION_USED > 10)
+
+cublasStatus_t CublasGemmEx(cublasHandle_t handle,
+                            cublasOperation_t transa,
+                            cublasOperation_t transb,
+                            int m,
+                            int n,
+                            int k,
+                            const void *alpha, /* host or device pointer */
+                            const void *A,
+                            cudaDataType Atype,
+                            int lda,
+                            const void *B,
+                            cudaDataType Btype,
+                            int ldb,
+                            const void *beta, /* host or device pointer */
+                            void *C,
+                            cudaDataType Ctype,
+                            int ldc,
+                            cublasComputeType_t computeType,
+                            cublasGemmAlgo_t algo)
+{
+    MAKE_API_CALL(cublasGemmEx,
+                  handle,
+                  transa,
+                  transb,
+                  m,
+                  n,
+                  k,
+                  alpha,
+                  A,
+                  Atype,
+                  lda,
+                  B,
+                  Btype,
+                  ldb,
+                  beta,
+                  C,
+                  Ctype,
+                  ldc,
+                  computeType,
+                  algo);
+}
+
+#endif // CUDA_VERSION_USED > 10
+
 /*
  * CublasLt
  */
@@ -250,4 +299,183 @@ size_t CublasLtGetVersion(void)
 
 #endif // CUDA_VERSION_USED > 10
 
+/*
+ * Cached handles
+ */
+
+namespace
+{
+struct CachedHandles
+{
+    cublasHandle_t cublas = nullptr;
+#if (CUDA_VERSION_USED > 10)
+    cublasLtHandle_t cublasLt = nullptr;
+    void *workspace           = nullptr;
+    size_t workspaceSize      = 0;
+#endif
+};
+
+class HandleCache
+{
+public:
+    std::mutex m_mutex; /* Guards m_handles */
+    std::map<std::tuple<int, cudaStream_t>, CachedHandles> m_handles;
+
+    /* Destroys what is still cached at exit */
+    ~HandleCache()
+    {
+        Release(-1);
+    }
+
+    /* Get the handles of the current device and stream. Caller holds m_mutex */
+    CachedHandles *FindLocked(cudaStream_t stream)
+    {
+        int device;
+        if (cudaGetDevice(&device) != cudaSuccess)
+        {
+            return nullptr;
+        }
+        return &m_handles[std::make_tuple(device, stream)];
+    }
+
+    void Release(int device)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        int currentDevice = -1;
+        bool switched     = false;
+        cudaGetDevice(&currentDevice);
+
+        for (auto it = m_handles.begin(); it != m_handles.end();)
+        {
+            int handlesDevice = std::get<0>(it->first);
+            if (device != -1 && handlesDevice != device)
+            {
+                ++it;
+                continue;
+            }
+
+            /* Keep the current context if it is already on the right device. It might not be the primary one */
+            if (handlesDevice != currentDevice)
+            {
+                cudaSetDevice(handlesDevice);
+                switched = true;
+            }
+            CachedHandles &handles = it->second;
+            if (handles.cublas != nullptr)
+            {
+                ::cublasDestroy(handles.cublas);
+            }
+#if (CUDA_VERSION_USED > 10)
+            if (handles.cublasLt != nullptr)
+            {
+                ::cublasLtDestroy(handles.cublasLt);
+            }
+            if (handles.workspace != nullptr)
+            {
+                cudaFree(handles.workspace);
+            }
+#endif
+            it = m_handles.erase(it);
+        }
+
+        if (switched && currentDevice != -1)
+        {
+            cudaSetDevice(currentDevice);
+        }
+    }
+};
+
+HandleCache &GetHandleCache()
+{
+    static HandleCache cache;
+    return cache;
+}
+} // namespace
+
+cublasStatus_t CublasGetCachedHandle(cudaStream_t stream, cublasHandle_t *handle)
+{
+    HandleCache &cache = GetHandleCache();
+    std::lock_guard<std::mutex> lock(cache.m_mutex);
+
+    CachedHandles *handles = cache.FindLocked(stream);
+    if (handles == nullptr)
+    {
+        return CUBLAS_STATUS_NOT_INITIALIZED;
+    }
+
+    cublasStatus_t cubSt;
+    if (handles->cublas == nullptr)
+    {
+        cubSt = ::cublasCreate(&handles->cublas);
+        if (cubSt != CUBLAS_STATUS_SUCCESS)
+        {
+            handles->cublas = nullptr;
+            return cubSt;
+        }
+    }
+
+    /* Don't let a caller inherit the settings of the previous one */
+    cubSt = ::cublasSetStream(handles->cublas, stream);
+    if (cubSt == CUBLAS_STATUS_SUCCESS)
+    {
+        cubSt = ::cublasSetMathMode(handles->cublas, CUBLAS_DEFAULT_MATH);
+    }
+    if (cubSt != CUBLAS_STATUS_SUCCESS)
+    {
+        return cubSt;
+    }
+
+    *handle = handles->cublas;
+    return CUBLAS_STATUS_SUCCESS;
+}
+
+#if (CUDA_VERSION_USED > 10)
+cublasStatus_t CublasLtGetCachedHandle(cudaStream_t stream,
+                                       cublasLtHandle_t *lightHandle,
+                                       void **workspace,
+                                       size_t *workspaceSize)
+{
+    HandleCache &cache = GetHandleCache();
+    std::lock_guard<std::mutex> lock(cache.m_mutex);
+
+    CachedHandles *handles = cache.FindLocked(stream);
+    if (handles == nullptr)
+    {
+        return CUBLAS_STATUS_NOT_INITIALIZED;
+    }
+
+    if (handles->cublasLt == nullptr)
+    {
+        cublasStatus_t cubSt = ::cublasLtCreate(&handles->cublasLt);
+        if (cubSt != CUBLAS_STATUS_SUCCESS)
+        {
+            handles->cublasLt = nullptr;
+            return cubSt;
+        }
+
+        if (cudaMalloc(&handles->workspace, DCGM_CUBLASLT_WORKSPACE_BYTES) == cudaSuccess)
+        {
+            handles->workspaceSize = DCGM_CUBLASLT_WORKSPACE_BYTES;
+        }
+        else
+        {
+            DCGM_LOG_WARNING << "Unable to allocate a " << DCGM_CUBLASLT_WORKSPACE_BYTES
+                             << " byte cuBLASLt workspace. Continuing without one";
+            handles->workspace = nullptr;
+        }
+    }
+
+    *lightHandle   = handles->cublasLt;
+    *workspace     = handles->workspace;
+    *workspaceSize = handles->workspaceSize;
+    return CUBLAS_STATUS_SUCCESS;
+}
+#endif // CUDA_VERSION_USED > 10
+
+void CublasReleaseCachedHandles(int device)
+{
+    GetHandleCache().Release(device);
+}
+
 } // namespace Dcgm::CublasProxy
\ No newline at end of file
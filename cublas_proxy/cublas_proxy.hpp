@@ -71,6 +71,28 @@ cublasStatus_t PUBLIC_API CublasHgemm(cublasHandle_t handle,
                                       const __half *beta, /* host or device pointer */
                                       __half *C,
                                       int ldc);
+#if (CUDA_VERSION_USED > 10)
+cublasStatus_t PUBLIC_API CublasGemmEx(cublasHandle_t handle,
+                                       cublasOperation_t transa,
+                                       cublasOperation_t transb,
+                                       int m,
+                                       int n,
+                                       int k,
+                                       const void *alpha, /* host or device pointer */
+                                       const void *A,
+                                       cudaDataType Atype,
+                                       int lda,
+                                       const void *B,
+                                       cudaDataType Btype,
+                                       int ldb,
+                                       const void *beta, /* host or device pointer */
+                                       void *C,
+                                       cudaDataType Ctype,
+                                       int ldc,
+                                       cublasComputeType_t computeType,
+                                       cublasGemmAlgo_t algo);
+#endif // CUDA_VERSION_USED > 10
+
 /*
  * CublasLt
  */
@@ -131,6 +153,30 @@ size_t PUBLIC_API CublasLtGetVersion(void);
 
 #endif // CUDA_VERSION_USED > 10
 
+/*
+ * Cached handles
+ *
+ * Creating handles is slow and allocates device memory, so handles are kept by the proxy for the rest of the
+ * process, keyed by the current CUDA device and the stream. They are shared by every caller in the process that
+ * asks for the same device and stream, so callers that use them from several threads at once need their own
+ * streams. Callers must not destroy cached handles.
+ */
+
+/* Bytes of the cuBLASLt workspace that comes with each cached cuBLASLt handle */
+#define DCGM_CUBLASLT_WORKSPACE_BYTES (4 * 1024 * 1024)
+
+/* The handle's stream is set to stream and its math mode reset to CUBLAS_DEFAULT_MATH */
+cublasStatus_t PUBLIC_API CublasGetCachedHandle(cudaStream_t stream, cublasHandle_t *handle);
+#if (CUDA_VERSION_USED > 10)
+/* workspace is nullptr and workspaceSize 0 if the workspace couldn't be allocated */
+cublasStatus_t PUBLIC_API CublasLtGetCachedHandle(cudaStream_t stream,
+                                                  cublasLtHandle_t *lightHandle,
+                                                  void **workspace,
+                                                  size_t *workspaceSize);
+#endif // CUDA_VERSION_USED > 10
+/* Destroy the cached handles of device, or of all devices if device is -1. Needed before resetting a device */
+void PUBLIC_API CublasReleaseCachedHandles(int device = -1);
+
 } // namespace Dcgm::CublasProxy
 
 #undef PUBLIC_API
@@ -57,20 +57,20 @@ static void *g_cudaLibrary = 0;
 
 #define BEGIN_ENTRYPOINTS
 #define END_ENTRYPOINTS
-#define CUDA_API_ENTRYPOINT(cudaFuncname, entrypointApiFuncname, argtypes, fmt, ...) \
-    CUresult CUDAAPI cudaFuncname argtypes                                           \
-    {                                                                                \
-        if (NULL != g_itblCudaLibrary.cudaFuncname)                                  \
-            return (*(g_itblCudaLibrary.cudaFuncname))(__VA_ARGS__);                 \
-        return (*(g_itblDefaultCudaLibrary.cudaFuncname))(__VA_ARGS__);              \
-    }                                                                                \
-    void set_##cudaFuncname##Hook(cudaFuncname##_loader_t cudaFuncHook)              \
-    {                                                                                \
-        g_itblCudaLibrary.cudaFuncname = cudaFuncHook;                               \
-    }                                                                                \
-    void reset_##cudaFuncname##Hook(void)                                            \
-    {                                                                                \
-        g_itblCudaLibrary.cudaFuncname = NULL;                                       \
+#define CUDA_API_ENTRYPOINT(cudaFuncname, entrypointApiFuncname, argtypes, fmt, ...)                      \
+    CUresult CUDAAPI cudaFuncname argtypes                                                                \
+    {                                                                                                     \
+        if (NULL != g_itblCudaLibrary.cudaFuncname)                                                       \
+            return (*(g_itblCudaLibrary.cudaFuncname))(__VA_ARGS__);                                      \
+        return (*__atomic_load_n(&g_itblDefaultCudaLibrary.cudaFuncname, __ATOMIC_ACQUIRE))(__VA_ARGS__); \
+    }                                                                                                     \
+    void set_##cudaFuncname##Hook(cudaFuncname##_loader_t cudaFuncHook)                                   \
+    {                                                                                                     \
+        g_itblCudaLibrary.cudaFuncname = cudaFuncHook;                                                    \
+    }                                                                                                     \
+    void reset_##cudaFuncname##Hook(void)                                                                 \
+    {                                                                                                     \
+        g_itblCudaLibrary.cudaFuncname = NULL;                                                            \
     }
 
 #include "cuda-entrypoints.h"
@@ -93,9 +93,10 @@ static void *cudaLoaderLoadLibrary(const char *name)
 // Pre-emptive API Loading
 // ----------------------------------------
 // The following defines a function which Dynamically loads all CUDA API's into the import table.
+// This is only done in CUDA_LIBRARY_BIND_EAGER mode, which checks up front that every API exists.
 
 #define BEGIN_ENTRYPOINTS                                    \
-    static cudaLibraryLoadResult_t loadCudaLibraryApis(void) \
+    static cudaLibraryLoadResult_t bindCudaLibraryApisEagerly(void) \
     {                                                        \
         assert(g_cudaLibrary);
 #define CUDA_API_ENTRYPOINT(cudaFuncname, entrypointApiFuncname, argtypes, fmt, ...)                \
@@ -116,15 +117,81 @@ static void *cudaLoaderLoadLibrary(const char *name)
 #undef CUDA_API_ENTRYPOINT
 #undef BEGIN_ENTRYPOINTS
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Lazy API Loading
+// ----------------------------------------
+// The following defines a resolver for each CUDA API. In CUDA_LIBRARY_BIND_LAZY mode the import table
+// starts out pointing at the resolvers. The first call of an API looks it up, patches the import table
+// so that later calls go straight to the CUDA library, and forwards the call. Threads that race on the
+// first call look up the same address, so the patch doesn't need a lock.
+
+#define BEGIN_ENTRYPOINTS
+#define END_ENTRYPOINTS
+#define CUDA_API_ENTRYPOINT(cudaFuncname, entrypointApiFuncname, argtypes, fmt, ...)                    \
+    static CUresult CUDAAPI resolve_##cudaFuncname argtypes                                             \
+    {                                                                                                   \
+        cudaFuncname##_loader_t cudaFunc                                                                \
+            = (cudaFuncname##_loader_t)cudaLoaderGetProcAddress(g_cudaLibrary, #entrypointApiFuncname); \
+        if (NULL == cudaFunc)                                                                           \
+            return CUDA_ERROR_NOT_FOUND;                                                                \
+        __atomic_store_n(&g_itblDefaultCudaLibrary.cudaFuncname, cudaFunc, __ATOMIC_RELEASE);           \
+        return (*cudaFunc)(__VA_ARGS__);                                                                \
+    }
+
+#include "cuda-entrypoints.h"
+
+#undef CUDA_API_ENTRYPOINT
+#undef END_ENTRYPOINTS
+#undef BEGIN_ENTRYPOINTS
+
+#define BEGIN_ENTRYPOINTS                       \
+    static void bindCudaLibraryApisLazily(void) \
+    {                                           \
+        assert(g_cudaLibrary);
+#define CUDA_API_ENTRYPOINT(cudaFuncname, entrypointApiFuncname, argtypes, fmt, ...) \
+    g_itblDefaultCudaLibrary.cudaFuncname = resolve_##cudaFuncname;
+#define END_ENTRYPOINTS }
+
+#include "cuda-entrypoints.h"
+
+#undef END_ENTRYPOINTS
+#undef CUDA_API_ENTRYPOINT
+#undef BEGIN_ENTRYPOINTS
+
+static cudaLibraryLoadResult_t loadCudaLibraryApis(cudaLibraryBindMode_t bindMode)
+{
+    if (CUDA_LIBRARY_BIND_EAGER == bindMode)
+        return bindCudaLibraryApisEagerly();
+
+    bindCudaLibraryApisLazily();
+    return CUDA_LIBRARY_LOAD_SUCCESS;
+}
+
 /**
  * Attempts to dynamically load the CUDA library from typical locations where the CUDA
- * library is found.
+ * library is found. API's are looked up the first time they are called.
  *
  * @return
  *         - CUDA_LIBRARY_LOAD_SUCCESS      If the CUDA library was found and successfully loaded
  *         - CUDA_ERROR_LIBRARY_NOT_FOUND   If the CUDA library was not found or could not be loaded
  */
 cudaLibraryLoadResult_t loadDefaultCudaLibrary(void)
+{
+    return loadCudaLibrary(CUDA_LIBRARY_BIND_LAZY);
+}
+
+/**
+ * Attempts to dynamically load the CUDA library from typical locations where the CUDA
+ * library is found.
+ *
+ * @param bindMode When to look up the CUDA API's. Ignored if the library is already loaded
+ *
+ * @return
+ *         - CUDA_LIBRARY_LOAD_SUCCESS          If the CUDA library was found and successfully loaded
+ *         - CUDA_ERROR_LIBRARY_NOT_FOUND       If the CUDA library was not found or could not be loaded
+ *         - CUDA_LIBRARY_ERROR_API_NOT_FOUND   If bindMode is CUDA_LIBRARY_BIND_EAGER and an API is missing
+ */
+cudaLibraryLoadResult_t loadCudaLibrary(cudaLibraryBindMode_t bindMode)
 {
     if (g_cudaLibrary)
         return CUDA_LIBRARY_LOAD_SUCCESS;
@@ -137,7 +204,7 @@ cudaLibraryLoadResult_t loadDefaultCudaLibrary(void)
 
     g_cudaLibrary = cudaLoaderLoadLibrary("libcuda.so.1");
     if (g_cudaLibrary)
-        return loadCudaLibraryApis();
+        return loadCudaLibraryApis(bindMode);
 
     //
     // for Ubuntu we support /usr/lib{,32,64}/nvidia-current/...
@@ -148,34 +215,34 @@ cudaLibraryLoadResult_t loadDefaultCudaLibrary(void)
     // For x64 .run installs
     g_cudaLibrary = cudaLoaderLoadLibrary("/usr/lib64/libcuda.so.1");
     if (g_cudaLibrary)
-        return loadCudaLibraryApis();
+        return loadCudaLibraryApis(bindMode);
 
     // For RPM fusion x64
     g_cudaLibrary = cudaLoaderLoadLibrary("/usr/lib64/nvidia/libcuda.so.1");
     if (g_cudaLibrary)
-        return loadCudaLibraryApis();
+        return loadCudaLibraryApis(bindMode);
 
     // For some 32 and 64 bit installs
     g_cudaLibrary = cudaLoaderLoadLibrary("/usr/lib/libcuda.so.1");
     if (g_cudaLibrary)
-        return loadCudaLibraryApis();
+        return loadCudaLibraryApis(bindMode);
 
     // For some 32 bit installs
     g_cudaLibrary = cudaLoaderLoadLibrary("/usr/lib32/libcuda.so.1");
     if (g_cudaLibrary)
-        return loadCudaLibraryApis();
+        return loadCudaLibraryApis(bindMode);
 
     // For RPM Fusion 32 bit
     g_cudaLibrary = cudaLoaderLoadLibrary("/usr/lib/nvidia/libcuda.so.1");
     if (g_cudaLibrary)
-        return loadCudaLibraryApis();
+        return loadCudaLibraryApis(bindMode);
 
 #endif /* _UNIX */
 #ifdef _WINDOWS
     // Load from the system directory (a trusted location)
     g_cudaLibrary = cudaLoaderLoadLibrary("nvcuda.dll");
     if (g_cudaLibrary)
-        return loadCudaLibraryApis();
+        return loadCudaLibraryApis(bindMode);
 #endif /* _WINDOWS */
 
     return CUDA_LIBRARY_ERROR_NOT_FOUND;
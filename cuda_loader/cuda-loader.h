@@ -27,11 +27,18 @@ typedef enum cudaLibraryLoadResult
     CUDA_LIBRARY_ERROR_OUT_OF_MEMORY
 } cudaLibraryLoadResult_t;
 
+typedef enum cudaLibraryBindMode
+{
+    CUDA_LIBRARY_BIND_LAZY = 0, /* Look up each API the first time it is called */
+    CUDA_LIBRARY_BIND_EAGER     /* Look up every API while loading. Fails if any is missing */
+} cudaLibraryBindMode_t;
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
 cudaLibraryLoadResult_t loadDefaultCudaLibrary(void);
+cudaLibraryLoadResult_t loadCudaLibrary(cudaLibraryBindMode_t bindMode);
 cudaLibraryLoadResult_t unloadCudaLibrary(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,795 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmRestGateway.h"
+#include "JsonStringWriter.h"
+
+#include <DcgmHttpServer.h>
+#include <DcgmLogging.h>
+#include <DcgmNumberFormat.h>
+#include <dcgm_agent.h>
+#include <dcgm_fields.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+/* Reaches DCGM through the client API of a host engine */
+class DcgmRestApiBackend : public DcgmRestBackend
+{
+public:
+    /* Most distinct sets of fields getlatestvalues keeps watched */
+    static constexpr size_t MAX_FIELD_GROUPS = 32;
+
+    DcgmRestApiBackend(std::string address, timelib64_t updateFreqUsec)
+        : m_address(std::move(address))
+        , m_updateFreqUsec(updateFreqUsec)
+    {}
+
+    ~DcgmRestApiBackend() override
+    {
+        Reset();
+    }
+
+    void Reset() override
+    {
+        if (m_connected)
+        {
+            for (auto const &[fieldIds, fieldGroupId] : m_fieldGroups)
+            {
+                dcgmFieldGroupDestroy(m_handle, fieldGroupId);
+            }
+            dcgmDisconnect(m_handle);
+        }
+
+        m_connected     = false;
+        m_healthWatched = false;
+        m_fieldGroups.clear();
+    }
+
+    dcgmReturn_t GetGpuIds(std::vector<unsigned int> &gpuIds) override
+    {
+        dcgmReturn_t dcgmReturn = Connect();
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            return dcgmReturn;
+        }
+
+        unsigned int ids[DCGM_MAX_NUM_DEVICES];
+        int count  = 0;
+        dcgmReturn = dcgmGetAllSupportedDevices(m_handle, ids, &count);
+        gpuIds.assign(ids, ids + std::max(count, 0));
+        return dcgmReturn;
+    }
+
+    dcgmReturn_t GetAttributes(unsigned int gpuId, dcgmDeviceAttributes_t &attributes) override
+    {
+        dcgmReturn_t dcgmReturn = Connect();
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            return dcgmReturn;
+        }
+
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.version = dcgmDeviceAttributes_version;
+        return dcgmGetDeviceAttributes(m_handle, gpuId, &attributes);
+    }
+
+    dcgmReturn_t CheckHealth(dcgmHealthResponse_t &response) override
+    {
+        dcgmReturn_t dcgmReturn = Connect();
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            return dcgmReturn;
+        }
+
+        if (!m_healthWatched)
+        {
+            dcgmReturn = dcgmHealthSet(m_handle, DCGM_GROUP_ALL_GPUS, DCGM_HEALTH_WATCH_ALL);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                return dcgmReturn;
+            }
+            /* Make sure the health has updated at least once */
+            dcgmUpdateAllFields(m_handle, 1);
+            m_healthWatched = true;
+        }
+
+        memset(&response, 0, sizeof(response));
+        response.version = dcgmHealthResponse_version;
+        return dcgmHealthCheck(m_handle, DCGM_GROUP_ALL_GPUS, &response);
+    }
+
+    dcgmReturn_t RunDiagnostic(dcgmPolicyValidation_t validate, dcgmDiagResponse_t &response) override
+    {
+        dcgmReturn_t dcgmReturn = Connect();
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            return dcgmReturn;
+        }
+
+        memset(&response, 0, sizeof(response));
+        response.version = dcgmDiagResponse_version;
+        return dcgmActionValidate(m_handle, DCGM_GROUP_ALL_GPUS, validate, &response);
+    }
+
+    dcgmReturn_t GetLatestValues(std::vector<unsigned short> const &fieldIds,
+                                 std::vector<dcgmFieldValue_v1> &values) override
+    {
+        dcgmReturn_t dcgmReturn = Connect();
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            return dcgmReturn;
+        }
+
+        auto it = m_fieldGroups.find(fieldIds);
+        if (it == m_fieldGroups.end())
+        {
+            dcgmFieldGrp_t fieldGroupId;
+            dcgmReturn = WatchFields(fieldIds, fieldGroupId);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                return dcgmReturn;
+            }
+            it = m_fieldGroups.emplace(fieldIds, fieldGroupId).first;
+        }
+
+        return dcgmGetLatestValues_v2(m_handle, DCGM_GROUP_ALL_GPUS, it->second, &AppendValues, &values);
+    }
+
+private:
+    std::string m_address;
+    timelib64_t m_updateFreqUsec;
+    dcgmHandle_t m_handle = 0;
+    bool m_connected      = false;
+    bool m_healthWatched  = false;
+    std::map<std::vector<unsigned short>, dcgmFieldGrp_t> m_fieldGroups; /* Watched field groups by their fields */
+
+    dcgmReturn_t Connect()
+    {
+        if (m_connected)
+        {
+            return DCGM_ST_OK;
+        }
+
+        dcgmConnectV2Params_t params {};
+        params.version   = dcgmConnectV2Params_version;
+        params.timeoutMs = 5000;
+
+        std::string target = m_address;
+        if (m_address.rfind("unix:", 0) == 0)
+        {
+            params.addressIsUnixSocket = 1;
+            target                     = m_address.substr(strlen("unix:"));
+        }
+
+        dcgmReturn_t dcgmReturn = dcgmConnect_v2(target.c_str(), &params, &m_handle);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " connecting to the host engine at " << m_address;
+            return dcgmReturn;
+        }
+
+        m_connected = true;
+        return DCGM_ST_OK;
+    }
+
+    dcgmReturn_t WatchFields(std::vector<unsigned short> const &fieldIds, dcgmFieldGrp_t &fieldGroupId)
+    {
+        if (m_fieldGroups.size() >= MAX_FIELD_GROUPS)
+        {
+            DCGM_LOG_ERROR << "Already watching " << m_fieldGroups.size() << " sets of fields";
+            return DCGM_ST_MAX_LIMIT;
+        }
+
+        std::vector<unsigned short> ids = fieldIds;
+        std::string name                = "dcgm-rest-" + std::to_string(m_fieldGroups.size());
+        std::vector<char> fieldGroupName(name.begin(), name.end());
+        fieldGroupName.push_back('\0');
+
+        dcgmReturn_t dcgmReturn
+            = dcgmFieldGroupCreate(m_handle, (int)ids.size(), ids.data(), fieldGroupName.data(), &fieldGroupId);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            return dcgmReturn;
+        }
+
+        /* Only the latest value is ever read */
+        dcgmReturn = dcgmWatchFields(m_handle, DCGM_GROUP_ALL_GPUS, fieldGroupId, m_updateFreqUsec, 0.0, 1);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            dcgmFieldGroupDestroy(m_handle, fieldGroupId);
+            return dcgmReturn;
+        }
+
+        /* Make sure there is a value to return the first time */
+        dcgmUpdateAllFields(m_handle, 1);
+        return DCGM_ST_OK;
+    }
+
+    static int AppendValues(dcgm_field_entity_group_t /* entityGroupId */,
+                            dcgm_field_eid_t /* entityId */,
+                            dcgmFieldValue_v1 *values,
+                            int numValues,
+                            void *userData)
+    {
+        auto *out = static_cast<std::vector<dcgmFieldValue_v1> *>(userData);
+        out->insert(out->end(), values, values + numValues);
+        return 0;
+    }
+};
+
+int HexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    c = (char)tolower(c);
+    return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+/* value with %XX and '+' decoded */
+std::string PercentDecode(std::string_view value)
+{
+    std::string decoded;
+    decoded.reserve(value.size());
+
+    for (size_t i = 0; i < value.size(); i++)
+    {
+        if (value[i] == '%' && i + 2 < value.size() && HexDigit(value[i + 1]) >= 0 && HexDigit(value[i + 2]) >= 0)
+        {
+            decoded += (char)(HexDigit(value[i + 1]) * 16 + HexDigit(value[i + 2]));
+            i += 2;
+        }
+        else
+        {
+            decoded += value[i] == '+' ? ' ' : value[i];
+        }
+    }
+
+    return decoded;
+}
+
+/* JSON status of the response envelope */
+void StartEnvelope(JsonStringWriter &writer, char const *status)
+{
+    writer.StartObject();
+    writer.Member("version", DcgmRestGateway::JSON_VERSION);
+    writer.Member("status", status);
+}
+
+void WriteErrorDetail(JsonStringWriter &writer, std::string_view key, dcgmDiagErrorDetail_t const &error)
+{
+    writer.Key(key);
+    writer.StartObject();
+    writer.Member("msg", error.msg);
+    writer.Member("code", (std::int64_t)error.code);
+    writer.EndObject();
+}
+
+void WriteDiagTestResult(JsonStringWriter &writer, dcgmDiagTestResult_v2 const &result)
+{
+    writer.StartObject();
+    writer.Member("status", (std::int64_t)result.status);
+    WriteErrorDetail(writer, "error", result.error);
+    writer.Member("info", result.info);
+    writer.EndObject();
+}
+} // namespace
+
+/*****************************************************************************/
+DcgmRestGateway::DcgmRestGateway(std::unique_ptr<DcgmRestBackend> backend, timelib64_t cacheUsec)
+    : m_backend(std::move(backend))
+    , m_cacheUsec(cacheUsec)
+    , m_notFound(DcgmHttpServer::StatusResponse("404 Not Found"))
+    , m_notAllowed(DcgmHttpServer::StatusResponse("405 Method Not Allowed"))
+    , m_health(std::make_unique<dcgmHealthResponse_t>())
+    , m_diag(std::make_unique<dcgmDiagResponse_t>())
+{}
+
+/*****************************************************************************/
+std::unique_ptr<DcgmRestBackend> DcgmRestGateway::ApiBackend(std::string address, timelib64_t updateFreqUsec)
+{
+    return std::make_unique<DcgmRestApiBackend>(std::move(address), updateFreqUsec);
+}
+
+/*****************************************************************************/
+std::map<std::string, std::string> DcgmRestGateway::ParseQuery(std::string_view target)
+{
+    std::map<std::string, std::string> params;
+
+    size_t const queryStart = target.find('?');
+    if (queryStart == std::string_view::npos)
+    {
+        return params;
+    }
+
+    std::string_view query = target.substr(queryStart + 1);
+    while (!query.empty())
+    {
+        size_t const end          = std::min(query.find('&'), query.size());
+        std::string_view const kv = query.substr(0, end);
+        size_t const equals       = kv.find('=');
+        if (equals != 0 && !kv.empty())
+        {
+            std::string_view const key = kv.substr(0, equals);
+            std::string_view const value
+                = equals == std::string_view::npos ? std::string_view() : kv.substr(equals + 1);
+            params[PercentDecode(key)] = PercentDecode(value);
+        }
+        query.remove_prefix(std::min(end + 1, query.size()));
+    }
+
+    return params;
+}
+
+/*****************************************************************************/
+void DcgmRestGateway::WriteError(std::string_view errorString)
+{
+    m_body.clear();
+    JsonStringWriter writer(m_body);
+    StartEnvelope(writer, "ERROR");
+    writer.Member("errorString", errorString);
+    writer.EndObject();
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmRestGateway::WriteGpuIds()
+{
+    std::vector<unsigned int> gpuIds;
+    dcgmReturn_t dcgmReturn = m_backend->GetGpuIds(gpuIds);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    m_body.clear();
+    JsonStringWriter writer(m_body);
+    StartEnvelope(writer, "OK");
+    writer.Key("responseData");
+    writer.StartArray();
+    for (unsigned int gpuId : gpuIds)
+    {
+        writer.Value((std::int64_t)gpuId);
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmRestGateway::WriteAttributes(unsigned int gpuId)
+{
+    dcgmDeviceAttributes_t attributes;
+    dcgmReturn_t dcgmReturn = m_backend->GetAttributes(gpuId, attributes);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    m_body.clear();
+    JsonStringWriter writer(m_body);
+    StartEnvelope(writer, "OK");
+    writer.Key("responseData");
+    writer.StartObject();
+    writer.Member("version", (std::int64_t)attributes.version);
+
+    writer.Key("clockSets");
+    writer.StartObject();
+    writer.Member("version", (std::int64_t)attributes.clockSets.version);
+    writer.Member("count", (std::int64_t)attributes.clockSets.count);
+    writer.Key("clockSet");
+    writer.StartArray();
+    for (unsigned int i = 0; i < std::min(attributes.clockSets.count, (unsigned int)DCGM_MAX_CLOCKS); i++)
+    {
+        writer.StartObject();
+        writer.Member("version", (std::int64_t)attributes.clockSets.clockSet[i].version);
+        writer.Member("memClock", (std::int64_t)attributes.clockSets.clockSet[i].memClock);
+        writer.Member("smClock", (std::int64_t)attributes.clockSets.clockSet[i].smClock);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    writer.Key("thermalSettings");
+    writer.StartObject();
+    writer.Member("version", (std::int64_t)attributes.thermalSettings.version);
+    writer.Member("slowdownTemp", (std::int64_t)attributes.thermalSettings.slowdownTemp);
+    writer.Member("shutdownTemp", (std::int64_t)attributes.thermalSettings.shutdownTemp);
+    writer.EndObject();
+
+    dcgmDevicePowerLimits_t const &power = attributes.powerLimits;
+    writer.Key("powerLimits");
+    writer.StartObject();
+    writer.Member("version", (std::int64_t)power.version);
+    writer.Member("curPowerLimit", (std::int64_t)power.curPowerLimit);
+    writer.Member("defaultPowerLimit", (std::int64_t)power.defaultPowerLimit);
+    writer.Member("enforcedPowerLimit", (std::int64_t)power.enforcedPowerLimit);
+    writer.Member("minPowerLimit", (std::int64_t)power.minPowerLimit);
+    writer.Member("maxPowerLimit", (std::int64_t)power.maxPowerLimit);
+    writer.EndObject();
+
+    dcgmDeviceIdentifiers_t const &identifiers = attributes.identifiers;
+    writer.Key("identifiers");
+    writer.StartObject();
+    writer.Member("version", (std::int64_t)identifiers.version);
+    writer.Member("brandName", identifiers.brandName);
+    writer.Member("deviceName", identifiers.deviceName);
+    writer.Member("pciBusId", identifiers.pciBusId);
+    writer.Member("serial", identifiers.serial);
+    writer.Member("uuid", identifiers.uuid);
+    writer.Member("vbios", identifiers.vbios);
+    writer.Member("inforomImageVersion", identifiers.inforomImageVersion);
+    writer.Member("pciDeviceId", (std::int64_t)identifiers.pciDeviceId);
+    writer.Member("pciSubSystemId", (std::int64_t)identifiers.pciSubSystemId);
+    writer.Member("driverVersion", identifiers.driverVersion);
+    writer.Member("virtualizationMode", (std::int64_t)identifiers.virtualizationMode);
+    writer.EndObject();
+
+    writer.Key("memoryUsage");
+    writer.StartObject();
+    writer.Member("version", (std::int64_t)attributes.memoryUsage.version);
+    writer.Member("bar1Total", (std::int64_t)attributes.memoryUsage.bar1Total);
+    writer.Member("fbTotal", (std::int64_t)attributes.memoryUsage.fbTotal);
+    writer.Member("fbUsed", (std::int64_t)attributes.memoryUsage.fbUsed);
+    writer.Member("fbFree", (std::int64_t)attributes.memoryUsage.fbFree);
+    writer.EndObject();
+
+    writer.EndObject();
+    writer.EndObject();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmRestGateway::WriteHealth()
+{
+    dcgmHealthResponse_t &health = *m_health;
+    dcgmReturn_t dcgmReturn      = m_backend->CheckHealth(health);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    m_body.clear();
+    JsonStringWriter writer(m_body);
+    StartEnvelope(writer, "OK");
+    writer.Key("responseData");
+    writer.StartObject();
+    writer.Member("version", (std::int64_t)health.version);
+    writer.Member("overallHealth", (std::int64_t)health.overallHealth);
+    writer.Member("incidentCount", (std::int64_t)health.incidentCount);
+    writer.Key("incidents");
+    writer.StartArray();
+    for (unsigned int i = 0; i < std::min(health.incidentCount, (unsigned int)DCGM_HEALTH_WATCH_MAX_INCIDENTS); i++)
+    {
+        dcgmIncidentInfo_t const &incident = health.incidents[i];
+        writer.StartObject();
+        writer.Member("system", (std::int64_t)incident.system);
+        writer.Member("health", (std::int64_t)incident.health);
+        WriteErrorDetail(writer, "error", incident.error);
+        writer.Key("entityInfo");
+        writer.StartObject();
+        writer.Member("entityGroupId", (std::int64_t)incident.entityInfo.entityGroupId);
+        writer.Member("entityId", (std::int64_t)incident.entityInfo.entityId);
+        writer.EndObject();
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    writer.EndObject();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmRestGateway::WriteDiagnostic(dcgmPolicyValidation_t validate)
+{
+    dcgmDiagResponse_t &diag = *m_diag;
+    dcgmReturn_t dcgmReturn  = m_backend->RunDiagnostic(validate, diag);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    m_body.clear();
+    JsonStringWriter writer(m_body);
+    StartEnvelope(writer, "OK");
+    writer.Key("responseData");
+    writer.StartObject();
+    writer.Member("version", (std::int64_t)diag.version);
+    writer.Member("gpuCount", (std::int64_t)diag.gpuCount);
+    writer.Member("levelOneTestCount", (std::int64_t)diag.levelOneTestCount);
+
+    writer.Key("levelOneResults");
+    writer.StartArray();
+    for (unsigned int i = 0; i < std::min(diag.levelOneTestCount, (unsigned int)LEVEL_ONE_MAX_RESULTS); i++)
+    {
+        WriteDiagTestResult(writer, diag.levelOneResults[i]);
+    }
+    writer.EndArray();
+
+    writer.Key("perGpuResponses");
+    writer.StartArray();
+    for (unsigned int i = 0; i < std::min(diag.gpuCount, (unsigned int)DCGM_MAX_NUM_DEVICES); i++)
+    {
+        dcgmDiagResponsePerGpu_v2 const &perGpu = diag.perGpuResponses[i];
+        writer.StartObject();
+        writer.Member("gpuId", (std::int64_t)perGpu.gpuId);
+        writer.Member("hwDiagnosticReturn", (std::int64_t)perGpu.hwDiagnosticReturn);
+        writer.Key("results");
+        writer.StartArray();
+        for (auto const &result : perGpu.results)
+        {
+            WriteDiagTestResult(writer, result);
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    WriteErrorDetail(writer, "systemError", diag.systemError);
+    writer.Member("trainingMsg", diag.trainingMsg);
+    writer.EndObject();
+    writer.EndObject();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmRestGateway::WriteLatestValues(std::vector<unsigned short> const &fieldIds)
+{
+    std::vector<dcgmFieldValue_v1> values;
+    dcgmReturn_t dcgmReturn = m_backend->GetLatestValues(fieldIds, values);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    m_body.clear();
+    JsonStringWriter writer(m_body);
+    StartEnvelope(writer, "OK");
+    writer.Key("responseData");
+    writer.StartArray();
+    for (auto const &value : values)
+    {
+        writer.StartObject();
+        writer.Member("fieldId", (std::int64_t)value.fieldId);
+        writer.Member("status", (std::int64_t)value.status);
+        writer.Member("ts", (std::int64_t)value.ts);
+        writer.Key("value");
+        if (value.status != DCGM_ST_OK)
+        {
+            writer.Null();
+        }
+        else if (value.fieldType == DCGM_FT_INT64 || value.fieldType == DCGM_FT_TIMESTAMP)
+        {
+            if (DCGM_INT64_IS_BLANK(value.value.i64))
+            {
+                writer.Null();
+            }
+            else
+            {
+                writer.Value((std::int64_t)value.value.i64);
+            }
+        }
+        else if (value.fieldType == DCGM_FT_DOUBLE)
+        {
+            if (DCGM_FP64_IS_BLANK(value.value.dbl))
+            {
+                writer.Null();
+            }
+            else
+            {
+                writer.Value(value.value.dbl);
+            }
+        }
+        else if (value.fieldType == DCGM_FT_STRING)
+        {
+            writer.Value(std::string_view(value.value.str, strnlen(value.value.str, sizeof(value.value.str))));
+        }
+        else
+        {
+            writer.Null();
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+char const *DcgmRestGateway::RunAction(std::map<std::string, std::string> const &params, bool &cacheable)
+{
+    auto actionIt = params.find("action");
+    if (actionIt == params.end())
+    {
+        WriteError("Missing 'action' parameter");
+        return "400 Bad Request";
+    }
+
+    std::string action = actionIt->second;
+    std::transform(action.begin(), action.end(), action.begin(), ::tolower);
+
+    auto param = [&params](char const *name) -> std::string const * {
+        auto it = params.find(name);
+        return it == params.end() ? nullptr : &it->second;
+    };
+
+    /* Retry once after reconnecting if the host engine went away */
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        dcgmReturn_t dcgmReturn = DCGM_ST_OK;
+        cacheable               = true;
+
+        if (action == "getallgpuids")
+        {
+            dcgmReturn = WriteGpuIds();
+        }
+        else if (action == "getgpuattributes")
+        {
+            std::string const *gpuIdParam = param("gpuid");
+            long long gpuId               = 0;
+            if (gpuIdParam == nullptr)
+            {
+                WriteError("Missing 'gpuid' parameter");
+                return "400 Bad Request";
+            }
+
+            std::vector<unsigned int> gpuIds;
+            dcgmReturn = m_backend->GetGpuIds(gpuIds);
+            if (dcgmReturn == DCGM_ST_OK)
+            {
+                if (!DcgmNs::ParseInt64(*gpuIdParam, gpuId)
+                    || std::find(gpuIds.begin(), gpuIds.end(), gpuId) == gpuIds.end())
+                {
+                    WriteError("gpuid parameter is invalid");
+                    return "400 Bad Request";
+                }
+                dcgmReturn = WriteAttributes((unsigned int)gpuId);
+            }
+        }
+        else if (action == "checkgpuhealth")
+        {
+            dcgmReturn = WriteHealth();
+        }
+        else if (action == "rundiagnostic")
+        {
+            cacheable                 = false;
+            std::string const *level  = param("level");
+            long long validationLevel = DCGM_POLICY_VALID_SV_SHORT;
+            if (level != nullptr
+                && (!DcgmNs::ParseInt64(*level, validationLevel) || validationLevel < DCGM_POLICY_VALID_SV_SHORT
+                    || validationLevel > DCGM_POLICY_VALID_SV_LONG))
+            {
+                WriteError("\"level\" parameter must be between 1 and 3");
+                return "400 Bad Request";
+            }
+
+            dcgmReturn = WriteDiagnostic((dcgmPolicyValidation_t)validationLevel);
+            if (dcgmReturn == DCGM_ST_NOT_SUPPORTED)
+            {
+                WriteError("The DCGM diagnostic program is not installed. Please install the Tesla-recommended "
+                           "driver.");
+                return "200 OK";
+            }
+        }
+        else if (action == "getlatestvalues")
+        {
+            std::string const *fields = param("fields");
+            std::vector<unsigned short> fieldIds;
+            std::stringstream ss(fields == nullptr ? "" : *fields);
+            std::string token;
+            while (std::getline(ss, token, ','))
+            {
+                long long fieldId = 0;
+                if (!DcgmNs::ParseInt64(token, fieldId) || fieldId <= 0 || fieldId >= DCGM_FI_MAX_FIELDS
+                    || DcgmFieldGetById((unsigned short)fieldId) == nullptr)
+                {
+                    WriteError("fields parameter is invalid");
+                    return "400 Bad Request";
+                }
+                fieldIds.push_back((unsigned short)fieldId);
+            }
+            if (fieldIds.empty())
+            {
+                WriteError("Missing 'fields' parameter");
+                return "400 Bad Request";
+            }
+
+            /* Requests that list the same fields share a field group */
+            std::sort(fieldIds.begin(), fieldIds.end());
+            fieldIds.erase(std::unique(fieldIds.begin(), fieldIds.end()), fieldIds.end());
+            dcgmReturn = WriteLatestValues(fieldIds);
+        }
+        else
+        {
+            /* Like dcgm_wsgi.py, an unknown action is an error response rather than an HTTP error */
+            cacheable = false;
+            WriteError("Unknown action: " + action);
+            return "200 OK";
+        }
+
+        if (dcgmReturn == DCGM_ST_OK)
+        {
+            return "200 OK";
+        }
+        if (dcgmReturn != DCGM_ST_CONNECTION_NOT_VALID || attempt > 0)
+        {
+            cacheable = false;
+            WriteError(errorString(dcgmReturn));
+            return "500 Internal Server Error";
+        }
+
+        DCGM_LOG_WARNING << "Got disconnected from the host engine. Reconnecting";
+        m_backend->Reset();
+    }
+
+    return "500 Internal Server Error";
+}
+
+/*****************************************************************************/
+void DcgmRestGateway::PurgeCache(timelib64_t now)
+{
+    if (now - m_lastPurge < std::max(m_cacheUsec, (timelib64_t)1000000))
+    {
+        return;
+    }
+    m_lastPurge = now;
+
+    for (auto it = m_cache.begin(); it != m_cache.end();)
+    {
+        it = it->second.expiresAt <= now ? m_cache.erase(it) : std::next(it);
+    }
+}
+
+/*****************************************************************************/
+std::string const &DcgmRestGateway::HandleRequest(std::string_view method, std::string_view target, timelib64_t now)
+{
+    if (method != "GET")
+    {
+        return m_notAllowed;
+    }
+
+    std::string_view const path = target.substr(0, target.find('?'));
+    if (path != JSON_DIR && path != std::string(JSON_DIR) + "/")
+    {
+        return m_notFound;
+    }
+
+    PurgeCache(now);
+
+    std::string key(target);
+    auto cached = m_cache.find(key);
+    if (cached != m_cache.end() && cached->second.expiresAt > now)
+    {
+        return cached->second.response;
+    }
+
+    bool cacheable           = false;
+    char const *const status = RunAction(ParseQuery(target), cacheable);
+
+    if (cacheable && m_cacheUsec > 0 && strcmp(status, "200 OK") == 0)
+    {
+        CachedResponse &entry = m_cache[key];
+        DcgmHttpServer::BuildResponse(entry.response, status, "application/json", m_body);
+        entry.expiresAt = now + m_cacheUsec;
+        return entry.response;
+    }
+
+    DcgmHttpServer::BuildResponse(m_response, status, "application/json", m_body);
+    return m_response;
+}
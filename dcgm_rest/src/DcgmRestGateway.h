@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <dcgm_structs.h>
+#include <timelib.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * How the gateway reaches DCGM. The default is a client of a host engine that
+ * keeps its handle, health watches and field groups between requests. Tests
+ * provide their own
+ */
+class DcgmRestBackend
+{
+public:
+    virtual ~DcgmRestBackend() = default;
+
+    /* Drop what was set up on the host engine so that the next call sets it up again */
+    virtual void Reset() = 0;
+
+    virtual dcgmReturn_t GetGpuIds(std::vector<unsigned int> &gpuIds) = 0;
+
+    virtual dcgmReturn_t GetAttributes(unsigned int gpuId, dcgmDeviceAttributes_t &attributes) = 0;
+
+    /* Health of every GPU. The health watches are set on the first call */
+    virtual dcgmReturn_t CheckHealth(dcgmHealthResponse_t &response) = 0;
+
+    virtual dcgmReturn_t RunDiagnostic(dcgmPolicyValidation_t validate, dcgmDiagResponse_t &response) = 0;
+
+    /* Latest values of fieldIds for every GPU. The fields are watched on the first call with the same fieldIds */
+    virtual dcgmReturn_t GetLatestValues(std::vector<unsigned short> const &fieldIds,
+                                         std::vector<dcgmFieldValue_v1> &values)
+        = 0;
+};
+
+/*
+ * JSON REST API of dcgm_wsgi.py as a compiled gateway (see dcgm-rest).
+ *
+ * Requests are GET /dcgmjsonrest?action=ACTION with these actions:
+ *   getallgpuids                 IDs of the GPUs
+ *   getgpuattributes&gpuid=N     Attributes of a GPU
+ *   checkgpuhealth               Health check of every GPU
+ *   rundiagnostic&level=N        Run the diagnostic at level 1 to 3. Never cached
+ *   getlatestvalues&fields=A,B   Latest values of the given field IDs for every GPU
+ *
+ * Responses look like dcgm_wsgi.py's: {"version":"1.0","status":"OK","responseData":...}
+ * or {"version":"1.0","status":"ERROR","errorString":"..."}. The JSON is written
+ * straight into the response as the data is walked.
+ *
+ * A response is reused for cacheUsec, the interval the fields are sampled at, by
+ * requests with the same target since DCGM has nothing newer to show them.
+ *
+ * The gateway is only used by the thread that polls its DcgmHttpServer, which
+ * is dcgm-rest's main thread, so requests never overlap.
+ */
+class DcgmRestGateway
+{
+public:
+    static constexpr char const *JSON_DIR     = "/dcgmjsonrest";
+    static constexpr char const *JSON_VERSION = "1.0";
+
+    /*
+     * backend   IN: How to reach DCGM. See ApiBackend()
+     * cacheUsec IN: How long responses are reused. 0 = never
+     */
+    DcgmRestGateway(std::unique_ptr<DcgmRestBackend> backend, timelib64_t cacheUsec);
+
+    /*
+     * The backend that connects to the host engine at address
+     *
+     * address        IN: host[:port] or unix:/path/to/socket
+     * updateFreqUsec IN: How often watched fields are sampled
+     */
+    static std::unique_ptr<DcgmRestBackend> ApiBackend(std::string address, timelib64_t updateFreqUsec);
+
+    /*************************************************************************/
+    /*
+     * Build the HTTP response to a request. See DcgmHttpServer::Handler
+     *
+     * now IN: Current time in usec since 1970
+     *
+     * Returns: The full HTTP response. Valid until the next call
+     */
+    std::string const &HandleRequest(std::string_view method, std::string_view target, timelib64_t now);
+
+    /* Split the query string of target into its parameters. Later ones win. Values are percent-decoded */
+    static std::map<std::string, std::string> ParseQuery(std::string_view target);
+
+    /* Number of responses in the cache. For tests */
+    size_t GetCacheSize() const
+    {
+        return m_cache.size();
+    }
+
+private:
+    struct CachedResponse
+    {
+        std::string response;
+        timelib64_t expiresAt;
+    };
+
+    std::unique_ptr<DcgmRestBackend> m_backend;
+    timelib64_t m_cacheUsec;
+    std::unordered_map<std::string, CachedResponse> m_cache; /* By request target */
+    timelib64_t m_lastPurge = 0;
+
+    std::string m_body;     /* JSON being written. Reused by every request */
+    std::string m_response; /* Response that isn't cached */
+    std::string m_notFound;
+    std::string m_notAllowed;
+
+    std::unique_ptr<dcgmHealthResponse_t> m_health; /* Too large for the stack */
+    std::unique_ptr<dcgmDiagResponse_t> m_diag;
+
+    /*
+     * Write the JSON response of action into m_body
+     *
+     * Returns: HTTP status of the response, like "200 OK"
+     */
+    char const *RunAction(std::map<std::string, std::string> const &params, bool &cacheable);
+
+    /* Write the response data of each action into m_body. DCGM_ST_OK or the error of the backend */
+    dcgmReturn_t WriteGpuIds();
+    dcgmReturn_t WriteAttributes(unsigned int gpuId);
+    dcgmReturn_t WriteHealth();
+    dcgmReturn_t WriteDiagnostic(dcgmPolicyValidation_t validate);
+    dcgmReturn_t WriteLatestValues(std::vector<unsigned short> const &fieldIds);
+
+    /* Replace m_body with an error response */
+    void WriteError(std::string_view errorString);
+
+    /* Drop expired responses now and then so that one-off targets don't pile up */
+    void PurgeCache(timelib64_t now);
+};
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "JsonStringWriter.h"
+
+#include <DcgmNumberFormat.h>
+
+#include <cmath>
+
+JsonStringWriter::JsonStringWriter(std::string &out)
+    : m_out(out)
+    , m_hasMembers()
+    , m_afterKey(false)
+{}
+
+void JsonStringWriter::BeforeValue()
+{
+    if (m_afterKey)
+    {
+        // The key already placed the separator
+        m_afterKey = false;
+        return;
+    }
+
+    if (m_hasMembers.empty())
+    {
+        return;
+    }
+
+    if (m_hasMembers.back())
+    {
+        m_out += ',';
+    }
+    m_hasMembers.back() = true;
+}
+
+void JsonStringWriter::AppendString(std::string_view value)
+{
+    static char const hexDigits[] = "0123456789abcdef";
+
+    m_out += '"';
+    for (char const c : value)
+    {
+        switch (c)
+        {
+            case '"':
+                m_out += "\\\"";
+                break;
+            case '\\':
+                m_out += "\\\\";
+                break;
+            case '\n':
+                m_out += "\\n";
+                break;
+            case '\r':
+                m_out += "\\r";
+                break;
+            case '\t':
+                m_out += "\\t";
+                break;
+            default:
+                if ((unsigned char)c < 0x20)
+                {
+                    m_out += "\\u00";
+                    m_out += hexDigits[(unsigned char)c >> 4];
+                    m_out += hexDigits[(unsigned char)c & 0xf];
+                }
+                else
+                {
+                    m_out += c;
+                }
+                break;
+        }
+    }
+    m_out += '"';
+}
+
+void JsonStringWriter::StartObject()
+{
+    BeforeValue();
+    m_out += '{';
+    m_hasMembers.push_back(false);
+}
+
+void JsonStringWriter::EndObject()
+{
+    m_hasMembers.pop_back();
+    m_out += '}';
+}
+
+void JsonStringWriter::StartArray()
+{
+    BeforeValue();
+    m_out += '[';
+    m_hasMembers.push_back(false);
+}
+
+void JsonStringWriter::EndArray()
+{
+    m_hasMembers.pop_back();
+    m_out += ']';
+}
+
+void JsonStringWriter::Key(std::string_view key)
+{
+    BeforeValue();
+    AppendString(key);
+    m_out += ':';
+    m_afterKey = true;
+}
+
+void JsonStringWriter::Value(std::int64_t value)
+{
+    BeforeValue();
+    DcgmNs::AppendInt64(m_out, value);
+}
+
+void JsonStringWriter::Value(double value)
+{
+    if (!std::isfinite(value))
+    {
+        // JSON has no spelling for these
+        Null();
+        return;
+    }
+
+    BeforeValue();
+    DcgmNs::AppendDouble(m_out, value);
+}
+
+void JsonStringWriter::Value(std::string_view value)
+{
+    BeforeValue();
+    AppendString(value);
+}
+
+void JsonStringWriter::Null()
+{
+    BeforeValue();
+    m_out += "null";
+}
+
+void JsonStringWriter::Member(std::string_view key, std::int64_t value)
+{
+    Key(key);
+    Value(value);
+}
+
+void JsonStringWriter::Member(std::string_view key, std::string_view value)
+{
+    Key(key);
+    Value(value);
+}
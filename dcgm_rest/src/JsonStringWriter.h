@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Appends compact JSON to a string as it is produced, without building a Json::Value tree first.
+ *
+ * The caller is responsible for well-formedness: keys only inside objects, every Start matched by an End.
+ */
+class JsonStringWriter
+{
+public:
+    explicit JsonStringWriter(std::string &out);
+
+    void StartObject();
+    void EndObject();
+    void StartArray();
+    void EndArray();
+
+    /*
+     * Write the key of the next member of the current object
+     */
+    void Key(std::string_view key);
+
+    void Value(std::int64_t value);
+    void Value(double value);
+    void Value(std::string_view value);
+    void Null();
+
+    /* Shorthands for Key() followed by Value() */
+    void Member(std::string_view key, std::int64_t value);
+    void Member(std::string_view key, std::string_view value);
+
+private:
+    std::string &m_out;
+    std::vector<bool> m_hasMembers; /* One entry per open object or array */
+    bool m_afterKey;
+
+    void BeforeValue();
+    void AppendString(std::string_view value);
+};
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * dcgm-rest: the JSON REST API of dcgm_wsgi.py without a web server or Python.
+ * See DcgmRestGateway for the API
+ */
+#include "DcgmRestGateway.h"
+
+#include <DcgmBuildInfo.hpp>
+#include <DcgmHttpServer.h>
+#include <DcgmLogging.h>
+#include <DcgmSettings.h>
+#include <dcgm_agent.h>
+
+#include <tclap/ArgException.h>
+#include <tclap/CmdLine.h>
+#include <tclap/ValueArg.h>
+
+#include <csignal>
+#include <iostream>
+
+#define DCGM_LOGGING_DEFAULT_DCGM_REST_FILE "./dcgm-rest.log"
+
+namespace
+{
+volatile std::sig_atomic_t g_stop = 0;
+
+void sig_handler(int /* signum */)
+{
+    g_stop = 1;
+}
+
+/* Answer requests on listen until SIGINT or SIGTERM */
+int Serve(std::string const &listen, std::string const &hostEngine, timelib64_t updateIntervalUsec)
+{
+    DcgmRestGateway gateway(DcgmRestGateway::ApiBackend(hostEngine, updateIntervalUsec), updateIntervalUsec);
+
+    DcgmHttpServer server([&gateway](std::string_view method, std::string_view target) -> std::string const & {
+        return gateway.HandleRequest(method, target, timelib_usecSince1970());
+    });
+
+    dcgmReturn_t dcgmReturn = server.Listen(listen);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        std::cerr << "Error: unable to listen on " << listen << ": " << errorString(dcgmReturn) << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, sig_handler);
+    std::signal(SIGTERM, sig_handler);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "Serving " << DcgmRestGateway::JSON_DIR << " on port " << server.GetPort() << std::endl;
+
+    while (!g_stop)
+    {
+        server.Poll(1000);
+    }
+
+    return 0;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string listen;
+    std::string hostEngine;
+    unsigned int updateIntervalMs = 0;
+
+    try
+    {
+        TCLAP::CmdLine cmdLine("Serves the DCGM JSON REST API of dcgm_wsgi.py at /dcgmjsonrest",
+                               ' ',
+                               std::string(DcgmNs::DcgmBuildInfo().GetVersion()));
+
+        TCLAP::ValueArg<std::string> listenArg(
+            "l", "listen", "[ip:]port to serve HTTP on", false, "127.0.0.1:1981", "ADDRESS", cmdLine);
+        TCLAP::ValueArg<std::string> hostEngineArg("",
+                                                   "hostengine",
+                                                   "Host engine to connect to: host[:port] or unix:/path/to/socket",
+                                                   false,
+                                                   "127.0.0.1",
+                                                   "ADDRESS",
+                                                   cmdLine);
+        TCLAP::ValueArg<unsigned int> updateIntervalArg(
+            "u",
+            "update-interval",
+            "How often watched fields are sampled in ms. Responses are reused for as long",
+            false,
+            1000,
+            "MS",
+            cmdLine);
+
+        cmdLine.parse(argc, argv);
+
+        listen           = listenArg.getValue();
+        hostEngine       = hostEngineArg.getValue();
+        updateIntervalMs = updateIntervalArg.getValue();
+    }
+    catch (TCLAP::ArgException const &ex)
+    {
+        std::cerr << "Argument parsing error: " << ex.error() << " for argument " << ex.argId() << std::endl;
+        return 1;
+    }
+
+    std::string const logFile
+        = DcgmLogging::getLogFilenameFromArgAndEnv("", DCGM_LOGGING_DEFAULT_DCGM_REST_FILE, DCGM_ENV_LOG_PREFIX);
+    std::string const logSeverity
+        = DcgmLogging::getLogSeverityFromArgAndEnv("", DCGM_LOGGING_DEFAULT_DCGMI_SEVERITY, DCGM_ENV_LOG_PREFIX);
+    DcgmLogging::init(logFile.c_str(),
+                      DcgmLogging::severityFromString(logSeverity.c_str(), DcgmLoggingSeverityWarning));
+
+    dcgmReturn_t dcgmReturn = dcgmInit();
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        std::cerr << "Error: unable to initialize DCGM: " << errorString(dcgmReturn) << std::endl;
+        return 1;
+    }
+
+    /* Serve() disconnects from the host engine before DCGM is shut down */
+    int const ret = Serve(listen, hostEngine, (timelib64_t)updateIntervalMs * 1000);
+    dcgmShutdown();
+    return ret;
+}
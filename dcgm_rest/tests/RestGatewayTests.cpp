@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmRestGateway.h>
+#include <JsonStringWriter.h>
+#include <dcgm_fields.h>
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct FakeState
+{
+    std::vector<unsigned int> gpuIds { 0, 1 };
+    dcgmReturn_t nextError = DCGM_ST_OK; /* Returned once by the next call */
+    unsigned int calls     = 0;
+    unsigned int resets    = 0;
+    std::vector<unsigned short> lastFieldIds;
+};
+
+/* Answers from a FakeState the test keeps */
+class FakeBackend : public DcgmRestBackend
+{
+public:
+    explicit FakeBackend(FakeState &state)
+        : m_state(state)
+    {}
+
+    void Reset() override
+    {
+        m_state.resets++;
+    }
+
+    dcgmReturn_t GetGpuIds(std::vector<unsigned int> &gpuIds) override
+    {
+        gpuIds = m_state.gpuIds;
+        return Call();
+    }
+
+    dcgmReturn_t GetAttributes(unsigned int gpuId, dcgmDeviceAttributes_t &attributes) override
+    {
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.thermalSettings.slowdownTemp = 90 + gpuId;
+        strcpy(attributes.identifiers.deviceName, "Tesla \"V100\"");
+        return Call();
+    }
+
+    dcgmReturn_t CheckHealth(dcgmHealthResponse_t &response) override
+    {
+        memset(&response, 0, sizeof(response));
+        response.overallHealth = DCGM_HEALTH_RESULT_PASS;
+        return Call();
+    }
+
+    dcgmReturn_t RunDiagnostic(dcgmPolicyValidation_t validate, dcgmDiagResponse_t &response) override
+    {
+        memset(&response, 0, sizeof(response));
+        response.gpuCount = (unsigned int)validate;
+        return Call();
+    }
+
+    dcgmReturn_t GetLatestValues(std::vector<unsigned short> const &fieldIds,
+                                 std::vector<dcgmFieldValue_v1> &values) override
+    {
+        m_state.lastFieldIds = fieldIds;
+        for (unsigned short fieldId : fieldIds)
+        {
+            dcgmFieldValue_v1 value {};
+            value.fieldId   = fieldId;
+            value.fieldType = DCGM_FT_INT64;
+            value.ts        = 1000;
+            value.value.i64 = fieldId * 10;
+            values.push_back(value);
+        }
+        return Call();
+    }
+
+private:
+    FakeState &m_state;
+
+    dcgmReturn_t Call()
+    {
+        m_state.calls++;
+        dcgmReturn_t ret   = m_state.nextError;
+        m_state.nextError = DCGM_ST_OK;
+        return ret;
+    }
+};
+
+std::string Body(std::string const &response)
+{
+    return response.substr(response.find("\r\n\r\n") + 4);
+}
+
+bool HasStatus(std::string const &response, char const *status)
+{
+    return response.rfind(std::string("HTTP/1.1 ") + status, 0) == 0;
+}
+} // namespace
+
+TEST_CASE("JsonStringWriter")
+{
+    std::string out;
+    JsonStringWriter writer(out);
+
+    writer.StartObject();
+    writer.Member("a", (std::int64_t)-1);
+    writer.Member("b", "quote\" slash\\ \n\x01");
+    writer.Key("c");
+    writer.StartArray();
+    writer.Value(1.5);
+    writer.Value(NAN);
+    writer.StartObject();
+    writer.EndObject();
+    writer.StartArray();
+    writer.EndArray();
+    writer.EndArray();
+    writer.EndObject();
+
+    CHECK(out == R"({"a":-1,"b":"quote\" slash\\ \n\u0001","c":[1.5,null,{},[]]})");
+}
+
+TEST_CASE("DcgmRestGateway::ParseQuery")
+{
+    auto params = DcgmRestGateway::ParseQuery("/dcgmjsonrest?action=getGpuAttributes&gpuid=1&x=a%20b+c&&flag&gpuid=2");
+    CHECK(params.size() == 4);
+    CHECK(params["action"] == "getGpuAttributes");
+    CHECK(params["gpuid"] == "2");
+    CHECK(params["x"] == "a b c");
+    CHECK(params["flag"].empty());
+
+    CHECK(DcgmRestGateway::ParseQuery("/dcgmjsonrest").empty());
+    CHECK(DcgmRestGateway::ParseQuery("/dcgmjsonrest?bad=%zz%4").at("bad") == "%zz%4");
+}
+
+TEST_CASE("DcgmRestGateway routing and errors")
+{
+    DcgmFieldsInit();
+
+    FakeState state;
+    DcgmRestGateway gateway(std::make_unique<FakeBackend>(state), 0);
+
+    CHECK(HasStatus(gateway.HandleRequest("POST", "/dcgmjsonrest?action=getallgpuids", 0), "405"));
+    CHECK(HasStatus(gateway.HandleRequest("GET", "/metrics", 0), "404"));
+    CHECK(HasStatus(gateway.HandleRequest("GET", "/dcgmjsonrest", 0), "400"));
+    CHECK(HasStatus(gateway.HandleRequest("GET", "/dcgmjsonrest?action=getgpuattributes", 0), "400"));
+    CHECK(HasStatus(gateway.HandleRequest("GET", "/dcgmjsonrest?action=getgpuattributes&gpuid=7", 0), "400"));
+    CHECK(HasStatus(gateway.HandleRequest("GET", "/dcgmjsonrest?action=rundiagnostic&level=4", 0), "400"));
+    CHECK(HasStatus(gateway.HandleRequest("GET", "/dcgmjsonrest?action=getlatestvalues&fields=150,x", 0), "400"));
+
+    std::string response = gateway.HandleRequest("GET", "/dcgmjsonrest?action=bogus", 0);
+    CHECK(HasStatus(response, "200"));
+    CHECK(Body(response) == R"({"version":"1.0","status":"ERROR","errorString":"Unknown action: bogus"})");
+
+    response = gateway.HandleRequest("GET", "/dcgmjsonrest?action=getAllGpuIds", 0);
+    CHECK(HasStatus(response, "200"));
+    CHECK(Body(response) == R"({"version":"1.0","status":"OK","responseData":[0,1]})");
+
+    response = gateway.HandleRequest("GET", "/dcgmjsonrest/?action=getgpuattributes&gpuid=1", 0);
+    CHECK(HasStatus(response, "200"));
+    CHECK(Body(response).find(R"("slowdownTemp":91)") != std::string::npos);
+    CHECK(Body(response).find(R"("deviceName":"Tesla \"V100\"")") != std::string::npos);
+
+    response = gateway.HandleRequest("GET", "/dcgmjsonrest?action=rundiagnostic&level=3", 0);
+    CHECK(Body(response).find(R"("gpuCount":3)") != std::string::npos);
+
+    response = gateway.HandleRequest("GET", "/dcgmjsonrest?action=getlatestvalues&fields=155,150,155", 0);
+    CHECK(state.lastFieldIds == std::vector<unsigned short> { 150, 155 });
+    CHECK(Body(response)
+          == R"({"version":"1.0","status":"OK","responseData":[{"fieldId":150,"status":0,"ts":1000,"value":1500},)"
+             R"({"fieldId":155,"status":0,"ts":1000,"value":1550}]})");
+
+    /* A lost connection is retried once after a reset */
+    state.nextError = DCGM_ST_CONNECTION_NOT_VALID;
+    response        = gateway.HandleRequest("GET", "/dcgmjsonrest?action=checkgpuhealth", 0);
+    CHECK(HasStatus(response, "200"));
+    CHECK(state.resets == 1);
+
+    state.nextError = DCGM_ST_GENERIC_ERROR;
+    response        = gateway.HandleRequest("GET", "/dcgmjsonrest?action=checkgpuhealth", 0);
+    CHECK(HasStatus(response, "500"));
+    CHECK(state.resets == 1);
+}
+
+TEST_CASE("DcgmRestGateway cache")
+{
+    FakeState state;
+    DcgmRestGateway gateway(std::make_unique<FakeBackend>(state), 1000000);
+
+    std::string const target = "/dcgmjsonrest?action=getallgpuids";
+    std::string first        = gateway.HandleRequest("GET", target, 0);
+    CHECK(state.calls == 1);
+
+    /* Reused within the interval */
+    state.gpuIds = { 3 };
+    CHECK(gateway.HandleRequest("GET", target, 999999) == first);
+    CHECK(state.calls == 1);
+    CHECK(gateway.GetCacheSize() == 1);
+
+    /* Errors and diagnostics are never cached */
+    state.nextError = DCGM_ST_GENERIC_ERROR;
+    gateway.HandleRequest("GET", "/dcgmjsonrest?action=checkgpuhealth", 0);
+    gateway.HandleRequest("GET", "/dcgmjsonrest?action=rundiagnostic", 0);
+    gateway.HandleRequest("GET", "/dcgmjsonrest?action=rundiagnostic", 0);
+    CHECK(state.calls == 4);
+    CHECK(gateway.GetCacheSize() == 1);
+
+    /* Expired */
+    CHECK(Body(gateway.HandleRequest("GET", target, 1000000)).find("[3]") != std::string::npos);
+    CHECK(state.calls == 5);
+
+    /* Expired entries are purged */
+    gateway.HandleRequest("GET", "/dcgmjsonrest?action=checkgpuhealth", 1000000);
+    CHECK(gateway.GetCacheSize() == 2);
+    gateway.HandleRequest("GET", target, 5000000);
+    CHECK(gateway.GetCacheSize() == 1);
+}
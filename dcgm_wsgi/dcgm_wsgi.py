@@ -12,6 +12,9 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+# dcgm-rest serves the same API as a compiled binary, without a web server or
+# Python, and keeps its watches and field groups between requests
+
 from wsgiref.simple_server import make_server
 import cgi
 import os
@@ -27,6 +27,7 @@
 #include "Health.h"
 #include "Introspect.h"
 #include "Module.h"
+#include "MultiHost.h"
 #include "NvcmTCLAP.h"
 #include "Nvlink.h"
 #include "Policy.h"
@@ -48,6 +49,7 @@
 #include <algorithm>
 #include <cctype>
 #include <csignal>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -64,6 +66,14 @@
 static const string g_hostnameHelpText
     = "Connects to specified IP or fully-qualified domain name. To connect to a host engine that was started with -d (unix socket), prefix the unix socket filename with 'unix://'. [default = localhost]";
 
+static const string g_hostListHelpText
+    = g_hostnameHelpText
+      + " A comma-separated list connects to all of the hosts at once, and tags the output with the host.";
+
+static const string g_hostFileHelpText
+    = "Connects to all of the hosts listed in the file at once, and tags the output with the host. The hosts are "
+      "separated by commas or newlines. Text after a '#' is ignored.";
+
 static const std::string HW_SLOWDOWN("hw_slowdown");
 static const std::string SW_THERMAL("sw_thermal");
 static const std::string HW_THERMAL("hw_thermal");
@@ -1041,6 +1051,32 @@ void CheckDuplicateFlagsForSetWatches(unsigned int i, const std::string &setWatc
     }
 }
 
+std::vector<std::string> CommandLineParser::GetHostList(const std::string &hostList, const std::string &hostFile)
+{
+    std::string hosts = hostList;
+
+    if (!hostFile.empty())
+    {
+        std::ifstream file(hostFile);
+        std::stringstream buf;
+
+        if (!file || !(buf << file.rdbuf()))
+        {
+            throw TCLAP::CmdLineParseException("Unable to read the host file '" + hostFile + "'", "host-file");
+        }
+
+        hosts += "\n" + buf.str();
+    }
+
+    std::vector<std::string> hostNames = ParseHostList(hosts);
+    if (hostNames.empty())
+    {
+        throw TCLAP::CmdLineParseException("No hosts given", hostFile.empty() ? "host" : "host-file");
+    }
+
+    return hostNames;
+}
+
 unsigned int CommandLineParser::CheckGroupIdArgument(const std::string &groupIdStr)
 {
     static const char *groupErr = "The only allowed non-digit strings are g (gpus), s (switches), i (instances),"
@@ -1090,7 +1126,8 @@ dcgmReturn_t CommandLineParser::ProcessHealthCommandLine(int argc, char const *c
 
     TCLAP::ValueArg<std::string> groupIdArg(
         "g", "group", "The GPU group to query on the specified host.", false, "g", "groupId", cmd);
-    TCLAP::ValueArg<std::string> hostAddress("", "host", g_hostnameHelpText, false, "localhost", "IP/FQDN");
+    TCLAP::ValueArg<std::string> hostAddress("", "host", g_hostListHelpText, false, "localhost", "IP/FQDN");
+    TCLAP::ValueArg<std::string> hostFile("", "host-file", g_hostFileHelpText, false, "", "path", cmd);
     TCLAP::SwitchArg clearWatches("", "clear", "Disable all watches being monitored.", false);
     TCLAP::SwitchArg getWatches("f", "fetch", "Fetch the current watch status.", false);
     TCLAP::SwitchArg checkWatches(
@@ -1145,6 +1182,7 @@ dcgmReturn_t CommandLineParser::ProcessHealthCommandLine(int argc, char const *c
     helpOutput.addToGroup("set", &updateInterval);
 
     helpOutput.addToGroup("check", &hostAddress);
+    helpOutput.addToGroup("check", &hostFile);
     helpOutput.addToGroup("check", &groupIdArg);
     helpOutput.addToGroup("check", &checkWatches);
     helpOutput.addToGroup("check", &json);
@@ -1154,15 +1192,22 @@ dcgmReturn_t CommandLineParser::ProcessHealthCommandLine(int argc, char const *c
     // Check for (invalid) inputs
     unsigned int groupId = CheckGroupIdArgument(groupIdArg.getValue());
 
+    std::vector<std::string> hostNames
+        = GetHostList(hostFile.isSet() && !hostAddress.isSet() ? "" : hostAddress.getValue(), hostFile.getValue());
+    if (hostNames.size() > 1 && !checkWatches.isSet())
+    {
+        throw TCLAP::CmdLineParseException("Several hosts are only supported with --check");
+    }
+
     // Process Get Command
     if (getWatches.isSet())
     {
-        result = GetHealth(hostAddress.getValue(), groupId, json.getValue()).Execute();
+        result = GetHealth(hostNames[0], groupId, json.getValue()).Execute();
     }
     else if (clearWatches.isSet())
     {
         result
-            = SetHealth(hostAddress.getValue(), groupId, 0, updateInterval.getValue(), maxKeepAge.getValue()).Execute();
+            = SetHealth(hostNames[0], groupId, 0, updateInterval.getValue(), maxKeepAge.getValue()).Execute();
     }
     else if (setWatches.isSet())
     {
@@ -1240,13 +1285,20 @@ dcgmReturn_t CommandLineParser::ProcessHealthCommandLine(int argc, char const *c
             throw TCLAP::CmdLineParseException("No flags detected", "set");
         }
 
-        result = SetHealth(
-                     hostAddress.getValue(), groupId, bitwiseWatches, updateInterval.getValue(), maxKeepAge.getValue())
-                     .Execute();
+        result
+            = SetHealth(hostNames[0], groupId, bitwiseWatches, updateInterval.getValue(), maxKeepAge.getValue())
+                  .Execute();
     }
     else if (checkWatches.isSet())
     {
-        result = CheckHealth(hostAddress.getValue(), groupId, json.getValue()).Execute();
+        if (hostNames.size() > 1)
+        {
+            result = CheckHealthMultiHost(hostNames, groupId, json.getValue()).Execute();
+        }
+        else
+        {
+            result = CheckHealth(hostNames[0], groupId, json.getValue()).Execute();
+        }
     }
 
     return result;
@@ -1696,7 +1748,8 @@ dcgmReturn_t CommandLineParser::ProcessStatsCommandLine(int argc, char const *co
     TCLAP::SwitchArg jobRemoveAll("a", "jremoveall", "Remove all job statistics.", false);
     TCLAP::ValueArg<int> groupId(
         "g", "group", "The GPU group to query on the specified host.", false, DCGM_GROUP_ALL_GPUS, "groupId", cmd);
-    TCLAP::ValueArg<std::string> hostAddress("", "host", g_hostnameHelpText, false, "localhost", "IP/FQDN");
+    TCLAP::ValueArg<std::string> hostAddress("", "host", g_hostListHelpText, false, "localhost", "IP/FQDN");
+    TCLAP::ValueArg<std::string> hostFile("", "host-file", g_hostFileHelpText, false, "", "path");
     /* Note: leaving the units blank for updateInterval and maxKeepAge since the formatting engine can't display them
      * correctly */
     TCLAP::ValueArg<int> updateInterval(
@@ -1708,6 +1761,13 @@ dcgmReturn_t CommandLineParser::ProcessStatsCommandLine(int argc, char const *co
                                     false,
                                     3600,
                                     "");
+    TCLAP::ValueArg<int> watch("w",
+                               "watch",
+                               "Display the job statistics again every this many ms until interrupted. "
+                               "They are only fetched again once they changed.",
+                               false,
+                               1000,
+                               "");
 
     std::vector<TCLAP::Arg *> xors;
     xors.push_back(&pid);
@@ -1720,8 +1780,10 @@ dcgmReturn_t CommandLineParser::ProcessStatsCommandLine(int argc, char const *co
     xors.push_back(&jobRemoveAll);
     cmd.xorAdd(xors);
     cmd.add(&hostAddress);
+    cmd.add(&hostFile);
     cmd.add(&updateInterval);
     cmd.add(&maxKeepAge);
+    cmd.add(&watch);
 
     // Set help output information
 
@@ -1791,8 +1853,10 @@ dcgmReturn_t CommandLineParser::ProcessStatsCommandLine(int argc, char const *co
     helpOutput.addToGroup("5", &jobStop);
 
     helpOutput.addToGroup("6", &hostAddress);
+    helpOutput.addToGroup("6", &hostFile);
     helpOutput.addToGroup("6", &jobStats);
     helpOutput.addToGroup("6", &verbose);
+    helpOutput.addToGroup("6", &watch);
 
     helpOutput.addToGroup("6", &hostAddress);
     helpOutput.addToGroup("6", &jobRemove);
@@ -1808,40 +1872,72 @@ dcgmReturn_t CommandLineParser::ProcessStatsCommandLine(int argc, char const *co
     CHECK_TCLAP_ARG_NEGATIVE_VALUE(groupId, "group");
     CHECK_TCLAP_ARG_NEGATIVE_VALUE(pid, "pid");
 
+    std::vector<std::string> hostNames
+        = GetHostList(hostFile.isSet() && !hostAddress.isSet() ? "" : hostAddress.getValue(), hostFile.getValue());
+    if (hostNames.size() > 1 && !jobStats.isSet())
+    {
+        throw TCLAP::CmdLineParseException("Several hosts are only supported with --job");
+    }
+
+    if (watch.isSet())
+    {
+        if (!jobStats.isSet())
+        {
+            throw TCLAP::CmdLineParseException("--watch is only supported with --job");
+        }
+        if (hostNames.size() > 1)
+        {
+            throw TCLAP::CmdLineParseException("--watch is only supported with a single host");
+        }
+        if (watch.getValue() < 1)
+        {
+            throw TCLAP::CmdLineParseException("Invalid value", "watch");
+        }
+    }
+
     if (enableWatches.isSet())
     {
-        result = EnableWatches(
-                     hostAddress.getValue(), groupId.getValue(), updateInterval.getValue(), maxKeepAge.getValue())
+        result = EnableWatches(hostNames[0], groupId.getValue(), updateInterval.getValue(), maxKeepAge.getValue())
                      .Execute();
     }
     else if (disableWatches.isSet())
     {
-        result = DisableWatches(hostAddress.getValue(), groupId.getValue()).Execute();
+        result = DisableWatches(hostNames[0], groupId.getValue()).Execute();
     }
     else if (pid.isSet())
     {
-        result = ViewProcessStats(hostAddress.getValue(), groupId.getValue(), pid.getValue(), verbose.getValue())
-                     .Execute();
+        result = ViewProcessStats(hostNames[0], groupId.getValue(), pid.getValue(), verbose.getValue()).Execute();
     }
     else if (jobStart.isSet())
     {
-        result = StartJob(hostAddress.getValue(), groupId.getValue(), jobStart.getValue()).Execute();
+        result = StartJob(hostNames[0], groupId.getValue(), jobStart.getValue()).Execute();
     }
     else if (jobStop.isSet())
     {
-        result = StopJob(hostAddress.getValue(), jobStop.getValue()).Execute();
+        result = StopJob(hostNames[0], jobStop.getValue()).Execute();
     }
     else if (jobStats.isSet())
     {
-        result = ViewJobStats(hostAddress.getValue(), jobStats.getValue(), verbose.getValue()).Execute();
+        if (hostNames.size() > 1)
+        {
+            result = ViewJobStatsMultiHost(hostNames, jobStats.getValue(), verbose.getValue()).Execute();
+        }
+        else
+        {
+            result = ViewJobStats(hostNames[0],
+                                  jobStats.getValue(),
+                                  verbose.getValue(),
+                                  watch.isSet() ? watch.getValue() : 0)
+                         .Execute();
+        }
     }
     else if (jobRemove.isSet())
     {
-        result = RemoveJob(hostAddress.getValue(), jobRemove.getValue()).Execute();
+        result = RemoveJob(hostNames[0], jobRemove.getValue()).Execute();
     }
     else if (jobRemoveAll.isSet())
     {
-        result = RemoveAllJobs(hostAddress.getValue()).Execute();
+        result = RemoveAllJobs(hostNames[0]).Execute();
     }
 
     return result;
@@ -1913,12 +2009,62 @@ dcgmReturn_t CommandLineParser::ProcessIntrospectCommandLine(int argc, char cons
                           false);
     TCLAP::SwitchArg enable("e", "enable", "Enable introspection and start recording information.", false);
     TCLAP::SwitchArg disable("d", "disable", "Disable introspection and stop recording information.", false);
+    std::vector<std::string> traceActions { "start", "stop", "dump" };
+    TCLAP::ValuesConstraint<std::string> traceConstraint(traceActions);
+    TCLAP::ValueArg<std::string> trace("",
+                                       "trace",
+                                       "Start or stop tracing the hostengine's update loop, or dump the trace as "
+                                       "Chrome trace JSON to a file on the hostengine's host.",
+                                       false,
+                                       "",
+                                       &traceConstraint);
+    TCLAP::ValueArg<std::string> mutexProfile("",
+                                              "mutex-profile",
+                                              "Start or stop recording how long the hostengine's callers wait for "
+                                              "and hold each DcgmMutex, or dump the histograms per call site as "
+                                              "JSON to a file on the hostengine's host.",
+                                              false,
+                                              "",
+                                              &traceConstraint);
+    TCLAP::SwitchArg requests("r",
+                              "requests",
+                              "Show how many requests of each type clients sent the hostengine, how long they "
+                              "waited and took to process and how big their replies were.",
+                              false);
+    TCLAP::SwitchArg perConnection(
+        "", "per-connection", "With --requests, show the requests of each connected client separately.", false);
+    TCLAP::SwitchArg memory("m",
+                            "memory",
+                            "Show the memory of the hostengine by the subsystem, module and watcher it is "
+                            "charged to.",
+                            false);
+    TCLAP::SwitchArg watchCost("",
+                               "watch-cost",
+                               "Predict the CPU time, driver calls and cache memory of watching a field group on a "
+                               "group, on its own and on top of the watches already active. "
+                               "Must be accompanied by --field-group.",
+                               false);
+    TCLAP::ValueArg<int> groupId(
+        "g", "group", "With --watch-cost, the group to watch.", false, DCGM_GROUP_ALL_GPUS, "groupId");
+    /* Note: leaving the units blank for updateInterval and maxKeepAge since the formatting engine can't display them
+     * correctly */
+    TCLAP::ValueArg<int> updateInterval(
+        "u", "update-interval", "With --watch-cost, how often to update the fields in ms.", false, 1000, "");
+    TCLAP::ValueArg<double> maxKeepAge(
+        "", "max-keep-age", "With --watch-cost, how long to keep the samples in seconds.", false, 3600.0, "");
+    TCLAP::ValueArg<int> maxKeepSamples(
+        "", "max-keep-samples", "With --watch-cost, the most samples to keep. 0 = no limit.", false, 0, "");
     TCLAP::ValueArg<std::string> hostAddress("", "host", g_hostnameHelpText, false, "localhost", "IP/FQDN");
 
     std::vector<TCLAP::Arg *> cmdXors;
     cmdXors.push_back(&enable);
     cmdXors.push_back(&disable);
     cmdXors.push_back(&show);
+    cmdXors.push_back(&trace);
+    cmdXors.push_back(&mutexProfile);
+    cmdXors.push_back(&requests);
+    cmdXors.push_back(&memory);
+    cmdXors.push_back(&watchCost);
 
     TCLAP::SwitchArg hostengineTarget(
         "H", "hostengine", "Specify the hostengine process as a target to retrieve introspection stats for.", false);
@@ -1945,6 +2091,11 @@ dcgmReturn_t CommandLineParser::ProcessIntrospectCommandLine(int argc, char cons
     cmd.add(&allFieldsTarget);
     cmd.add(&fieldGroupTarget);
     cmd.add(&allFieldGroupsTarget);
+    cmd.add(&perConnection);
+    cmd.add(&groupId);
+    cmd.add(&updateInterval);
+    cmd.add(&maxKeepAge);
+    cmd.add(&maxKeepSamples);
 
     // Set help output information
     helpOutput.addDescription("introspect -- Used to access info about DCGM itself.");
@@ -1955,6 +2106,27 @@ dcgmReturn_t CommandLineParser::ProcessIntrospectCommandLine(int argc, char cons
     helpOutput.addToGroup("disable", &hostAddress);
     helpOutput.addToGroup("disable", &disable);
 
+    helpOutput.addToGroup("trace", &hostAddress);
+    helpOutput.addToGroup("trace", &trace);
+
+    helpOutput.addToGroup("mutex-profile", &hostAddress);
+    helpOutput.addToGroup("mutex-profile", &mutexProfile);
+
+    helpOutput.addToGroup("requests", &hostAddress);
+    helpOutput.addToGroup("requests", &requests);
+    helpOutput.addToGroup("requests", &perConnection);
+
+    helpOutput.addToGroup("memory", &hostAddress);
+    helpOutput.addToGroup("memory", &memory);
+
+    helpOutput.addToGroup("watch-cost", &hostAddress);
+    helpOutput.addToGroup("watch-cost", &watchCost);
+    helpOutput.addToGroup("watch-cost", &groupId);
+    helpOutput.addToGroup("watch-cost", &fieldGroupTarget);
+    helpOutput.addToGroup("watch-cost", &updateInterval);
+    helpOutput.addToGroup("watch-cost", &maxKeepAge);
+    helpOutput.addToGroup("watch-cost", &maxKeepSamples);
+
     helpOutput.addToGroup("summary", &hostAddress);
     helpOutput.addToGroup("summary", &show);
     helpOutput.addToGroup("summary", &hostengineTarget);
@@ -1972,6 +2144,71 @@ dcgmReturn_t CommandLineParser::ProcessIntrospectCommandLine(int argc, char cons
     {
         result = ToggleIntrospect(hostAddress.getValue(), false).Execute();
     }
+    else if (trace.isSet())
+    {
+        unsigned int action = DCGM_TRACE_ACTION_DUMP;
+        if (trace.getValue() == "start")
+        {
+            action = DCGM_TRACE_ACTION_START;
+        }
+        else if (trace.getValue() == "stop")
+        {
+            action = DCGM_TRACE_ACTION_STOP;
+        }
+
+        result = TraceIntrospect(hostAddress.getValue(), action).Execute();
+    }
+    else if (mutexProfile.isSet())
+    {
+        unsigned int action = DCGM_TRACE_ACTION_MUTEX_PROFILE_DUMP;
+        if (mutexProfile.getValue() == "start")
+        {
+            action = DCGM_TRACE_ACTION_MUTEX_PROFILE_START;
+        }
+        else if (mutexProfile.getValue() == "stop")
+        {
+            action = DCGM_TRACE_ACTION_MUTEX_PROFILE_STOP;
+        }
+
+        result = TraceIntrospect(hostAddress.getValue(), action).Execute();
+    }
+    else if (requests.isSet())
+    {
+        result = DisplayIntrospectRequests(hostAddress.getValue(), perConnection.getValue()).Execute();
+    }
+    else if (memory.isSet())
+    {
+        result = DisplayIntrospectMemory(hostAddress.getValue()).Execute();
+    }
+    else if (watchCost.isSet())
+    {
+        CHECK_TCLAP_ARG_NEGATIVE_VALUE(groupId, "group");
+
+        auto const &fgIds = fieldGroupTarget.getValue();
+        if (fgIds.size() != 1)
+        {
+            throw TCLAP::CmdLineParseException("--watch-cost needs exactly one --field-group");
+        }
+
+        bool success          = false;
+        auto const parsedFgId = strTo<unsigned long long>(fgIds[0], &success);
+        if (!success)
+        {
+            throw TCLAP::CmdLineParseException("Unable to parse provided Field Group Id: " + fgIds[0]);
+        }
+        if (updateInterval.getValue() <= 0)
+        {
+            throw TCLAP::CmdLineParseException("--update-interval must be greater than 0");
+        }
+
+        result = DisplayIntrospectWatchCost(hostAddress.getValue(),
+                                            groupId.getValue(),
+                                            static_cast<dcgmFieldGrp_t>(parsedFgId),
+                                            updateInterval.getValue(),
+                                            maxKeepAge.getValue(),
+                                            maxKeepSamples.getValue())
+                     .Execute();
+    }
     else if (show.isSet())
     {
         if (!hostengineTarget.isSet() && !allFieldsTarget.isSet() && !fieldGroupTarget.isSet()
@@ -2102,7 +2339,8 @@ dcgmReturn_t CommandLineParser::ProcessDmonCommandLine(int argc, char const *con
     DCGMSubsystemCmdLine cmd(myName, _DCGMI_FORMAL_NAME, ' ', std::string(DcgmNs::DcgmBuildInfo().GetVersion()));
     cmd.setOutput(&helpOutput);
 
-    TCLAP::ValueArg<std::string> hostAddress("", "host", g_hostnameHelpText, false, "localhost", "IP/FQDN", cmd);
+    TCLAP::ValueArg<std::string> hostAddress("", "host", g_hostListHelpText, false, "localhost", "IP/FQDN", cmd);
+    TCLAP::ValueArg<std::string> hostFile("", "host-file", g_hostFileHelpText, false, "", "path", cmd);
 
     TCLAP::ValueArg<std::string> gpuId("i",
                                        "gpu-id",
@@ -2134,9 +2372,21 @@ dcgmReturn_t CommandLineParser::ProcessDmonCommandLine(int argc, char const *con
                                0,
                                "count");
     TCLAP::SwitchArg list("l", "list", "List to look up the long names, short names and field ids.", false);
+    std::vector<std::string> formats { "table", "csv", "jsonl", "binary" };
+    TCLAP::ValuesConstraint<std::string> formatConstraint(formats);
+    TCLAP::ValueArg<std::string> format(
+        "",
+        "format",
+        " Output format. table is for people. csv and jsonl print a row per entity and interval, and binary writes "
+        "the dcgmBufferedFv_v1 records of the values, for collectors. [default = table]",
+        false,
+        "table",
+        &formatConstraint);
 
     // Set help output information
     helpOutput.addDescription("dmon -- Used to monitor GPUs and their stats.");
+    helpOutput.addToGroup("1", &hostAddress);
+    helpOutput.addToGroup("1", &hostFile);
     helpOutput.addToGroup("1", &gpuId);
     helpOutput.addToGroup("1", &groupId);
     helpOutput.addToGroup("1", &fieldGroupId);
@@ -2144,6 +2394,7 @@ dcgmReturn_t CommandLineParser::ProcessDmonCommandLine(int argc, char const *con
     helpOutput.addToGroup("1", &delay);
     helpOutput.addToGroup("1", &count);
     helpOutput.addToGroup("1", &list);
+    helpOutput.addToGroup("1", &format);
 
     std::vector<TCLAP::Arg *> xorsFields;
     xorsFields.push_back(&fieldGroupId);
@@ -2152,6 +2403,7 @@ dcgmReturn_t CommandLineParser::ProcessDmonCommandLine(int argc, char const *con
     cmd.xorAdd(xorsFields);
     cmd.add(&delay);
     cmd.add(&count);
+    cmd.add(&format);
 
     cmd.parse(argc, argv);
 
@@ -2169,7 +2421,7 @@ dcgmReturn_t CommandLineParser::ProcessDmonCommandLine(int argc, char const *con
 
     if (list.isSet()
         && (groupId.isSet() || gpuId.isSet() || fieldId.isSet() || fieldGroupId.isSet() || delay.isSet()
-            || count.isSet()))
+            || count.isSet() || format.isSet() || hostFile.isSet()))
     {
         throw TCLAP::CmdLineParseException("Invalid parameters with list arg. Usage : dmon -l");
     }
@@ -2199,14 +2451,50 @@ dcgmReturn_t CommandLineParser::ProcessDmonCommandLine(int argc, char const *con
         throw TCLAP::CmdLineParseException("Invalid value", "field-id");
     }
 
-    return DeviceInfo(hostAddress.getValue(),
+    DmonOutputFormat outputFormat = DmonOutputFormat::Table;
+    if (format.getValue() == "csv")
+    {
+        outputFormat = DmonOutputFormat::Csv;
+    }
+    else if (format.getValue() == "jsonl")
+    {
+        outputFormat = DmonOutputFormat::Jsonl;
+    }
+    else if (format.getValue() == "binary")
+    {
+        outputFormat = DmonOutputFormat::Binary;
+    }
+
+    std::vector<std::string> hostNames
+        = GetHostList(hostFile.isSet() && !hostAddress.isSet() ? "" : hostAddress.getValue(), hostFile.getValue());
+    if (hostNames.size() > 1)
+    {
+        if (outputFormat == DmonOutputFormat::Binary)
+        {
+            throw TCLAP::CmdLineParseException("The binary format doesn't record the host. Use csv or jsonl instead",
+                                               "format");
+        }
+
+        return MultiHostDeviceInfo(hostNames,
+                                   gpuId.getValue(),
+                                   groupId.getValue(),
+                                   fieldId.getValue(),
+                                   fieldGroupId.getValue(),
+                                   delay.getValue(),
+                                   count.getValue(),
+                                   outputFormat)
+            .Execute();
+    }
+
+    return DeviceInfo(hostNames[0],
                       gpuId.getValue(),
                       groupId.getValue(),
                       fieldId.getValue(),
                       fieldGroupId.getValue(),
                       delay.getValue(),
                       count.getValue(),
-                      false)
+                      false,
+                      outputFormat)
         .Execute();
 }
 
@@ -19,6 +19,8 @@
 #include "dcgmi_common.h"
 
 #include <map>
+#include <string>
+#include <vector>
 
 
 /*
@@ -59,6 +61,9 @@ private:
     static dcgmReturn_t ProcessVersionInfoCommandLine(int argc, char const *const *argv);
     static unsigned int CheckGroupIdArgument(const std::string &groupId);
 
+    // Helper to get the hosts to connect to from the --host list and the --host-file file
+    static std::vector<std::string> GetHostList(const std::string &hostList, const std::string &hostFile);
+
     // Helper to validate the throttle mask parameter
     static void ValidateThrottleMask(const std::string &throttleMask);
 
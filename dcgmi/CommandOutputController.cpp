@@ -22,8 +22,10 @@
 
 #include "CommandOutputController.h"
 #include "dcgm_agent.h"
+#include <DcgmNumberFormat.h>
 #include <DcgmStringHelpers.h>
 #include <algorithm>
+#include <climits>
 #include <cstdarg>
 #include <iostream>
 #include <string>
@@ -123,140 +125,47 @@ void CommandOutputController::ReplaceTag(std::string &buff, std::string_view tag
 /*****************************************************************************/
 std::string CommandOutputController::HelperDisplayValue(int val)
 {
-    std::stringstream ss;
-
-    if (DCGM_INT32_IS_BLANK(val))
-    {
-        switch (val)
-        {
-            case DCGM_INT32_BLANK:
-                ss << "Not Specified";
-                break;
-
-            case DCGM_INT32_NOT_FOUND:
-                ss << "Not Found";
-                break;
-
-            case DCGM_INT32_NOT_SUPPORTED:
-                ss << "Not Supported";
-                break;
-
-            case DCGM_INT32_NOT_PERMISSIONED:
-                ss << "Insf. Permission";
-                break;
-
-            default:
-                ss << "Unknown";
-                break;
-        }
-    }
-    else
+    if (char const *blankName = DcgmNs::BlankValueName(val))
     {
-        ss << val;
+        return blankName;
     }
 
-    return ss.str();
+    return DcgmNs::Int64ToString(val);
 }
 
 /*****************************************************************************/
 std::string CommandOutputController::HelperDisplayValue(unsigned int val)
 {
-    std::stringstream ss;
-
     if (DCGM_INT32_IS_BLANK(val))
     {
-        switch (val)
-        {
-            case DCGM_INT32_BLANK:
-                ss << "Not Specified";
-                break;
-
-            case DCGM_INT32_NOT_FOUND:
-                ss << "Not Found";
-                break;
-
-            case DCGM_INT32_NOT_SUPPORTED:
-                ss << "Not Supported";
-                break;
-
-            case DCGM_INT32_NOT_PERMISSIONED:
-                ss << "Insf. Permission";
-                break;
-
-            default:
-                ss << "Unknown";
-                break;
-        }
-    }
-    else
-    {
-        ss << val;
+        /* Values past INT_MAX are blank too. INT_MAX itself is an unknown blank value */
+        return DcgmNs::BlankValueName(static_cast<int>(std::min(val, static_cast<unsigned int>(INT_MAX))));
     }
 
-    return ss.str();
+    return DcgmNs::Int64ToString(val);
 }
 
 /*****************************************************************************/
 std::string CommandOutputController::HelperDisplayValue(long long val)
 {
-    std::stringstream ss;
-
-    if (DCGM_INT64_IS_BLANK(val))
+    if (char const *blankName = DcgmNs::BlankValueName(val))
     {
-        switch (val)
-        {
-            case DCGM_INT64_BLANK:
-                ss << "Not Specified";
-                break;
-
-            case DCGM_INT64_NOT_FOUND:
-                ss << "Not Found";
-                break;
-
-            case DCGM_INT64_NOT_SUPPORTED:
-                ss << "Not Supported";
-                break;
-
-            case DCGM_INT64_NOT_PERMISSIONED:
-                ss << "Insf. Permission";
-                break;
-
-            default:
-                ss << "Unknown";
-                break;
-        }
-    }
-    else
-    {
-        ss << val;
+        return blankName;
     }
 
-    return ss.str();
+    return DcgmNs::Int64ToString(val);
 }
 
 /*****************************************************************************/
 std::string CommandOutputController::HelperDisplayValue(double val)
 {
-    std::stringstream ss;
-
-    if (DCGM_FP64_IS_BLANK(val))
+    if (char const *blankName = DcgmNs::BlankValueName(val))
     {
-        if (val == DCGM_FP64_BLANK)
-            ss << "Not Specified";
-        else if (val == DCGM_FP64_NOT_FOUND)
-            ss << "Not Found";
-        else if (val == DCGM_FP64_NOT_SUPPORTED)
-            ss << "Not Supported";
-        else if (val == DCGM_FP64_NOT_PERMISSIONED)
-            ss << "Insf. Permission";
-        else
-            ss << "Unknown";
-    }
-    else
-    {
-        ss << val;
+        return blankName;
     }
 
+    std::stringstream ss;
+    ss << val;
     return ss.str();
 }
 
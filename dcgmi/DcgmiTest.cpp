@@ -182,6 +182,10 @@ void DcgmiTest::HelperDisplayField(dcgmCacheManagerFieldInfo_t &fieldInfo)
     cmdView.addDisplayParameter(DATA_INFO_TAG, fieldInfo.monitorFrequencyUsec / 1000000);
     cmdView.display();
 
+    cmdView.addDisplayParameter(DATA_NAME_TAG, "Poll Interval (usec)");
+    cmdView.addDisplayParameter(DATA_INFO_TAG, fieldInfo.pollIntervalUsec);
+    cmdView.display();
+
     cmdView.addDisplayParameter(DATA_NAME_TAG, "Max Age (sec)");
     cmdView.addDisplayParameter(DATA_INFO_TAG, fieldInfo.maxAgeUsec / 1000000);
     cmdView.display();
@@ -203,6 +207,22 @@ void DcgmiTest::HelperDisplayField(dcgmCacheManagerFieldInfo_t &fieldInfo)
     cmdView.addDisplayParameter(DATA_INFO_TAG, usecPerFetch);
     cmdView.display();
 
+    cmdView.addDisplayParameter(DATA_NAME_TAG, "Bytes Used");
+    cmdView.addDisplayParameter(DATA_INFO_TAG, fieldInfo.bytesUsed);
+    cmdView.display();
+
+    cmdView.addDisplayParameter(DATA_NAME_TAG, "Last Read");
+    cmdView.addDisplayParameter(DATA_INFO_TAG, HelperFormatTimestamp(fieldInfo.lastReadUsec));
+    cmdView.display();
+
+    for (int i = 0; i < fieldInfo.numWatchers; i++)
+    {
+        std::string name = "Watcher " + std::to_string(i) + " Bytes Used";
+        cmdView.addDisplayParameter(DATA_NAME_TAG, name);
+        cmdView.addDisplayParameter(DATA_INFO_TAG, fieldInfo.watchers[i].bytesUsed);
+        cmdView.display();
+    }
+
     std::cout << std::endl;
 }
 
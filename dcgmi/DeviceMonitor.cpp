@@ -34,6 +34,8 @@
  * -d         --delay          1sec                                           *
  * -c         --count          0(infinite)                                    *
  * -l         --list                                                          *
+ *            --format         table                                          *
+ *            --host           localhost (a list monitors several hosts)      *
  *                                                                            *
  * When field Ids are mentioned, the dmon creates a group of FieldIds and     *
  * similarly when the Gpu Ids are mentioned, the dmon creates a group of Gpus *
@@ -46,8 +48,13 @@
 #include "dcgmi_common.h"
 
 #include <DcgmLogging.h>
+#include <DcgmNumberFormat.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <iomanip>
+#include <thread>
 
 
 #define MAX_PRINT_HEADER_COUNT 14
@@ -70,7 +77,7 @@
 /*****************************************************************************/
 /* This is used by the signal handler to let the device monitor know that
    we've received a signal from a ctrl-c..etc that we should stop */
-static bool deviceMonitorShouldStop = false;
+static std::atomic<bool> deviceMonitorShouldStop = false;
 
 static std::string_view HelperGetGroupIdPrefix(dcgm_field_entity_group_t const groupId)
 {
@@ -103,8 +110,10 @@ DeviceInfo::DeviceInfo(std::string hostname,
                        int fieldGroupId,
                        int updateDelay,
                        int numOfIterations,
-                       bool listOptionMentioned)
-    : m_requestedEntityIds(std::move(requestedEntityIds))
+                       bool listOptionMentioned,
+                       DmonOutputFormat outputFormat)
+    : m_outputFormat(outputFormat)
+    , m_requestedEntityIds(std::move(requestedEntityIds))
     , m_groupIdStr(std::move(grpIdStr))
     , m_fieldIdsStr(std::move(fldIds))
     , m_fieldGrpId_int(fieldGroupId)
@@ -118,6 +127,15 @@ DeviceInfo::DeviceInfo(std::string hostname,
     deviceMonitorShouldStop = false;
 
     m_hostName = std::move(hostname);
+
+    m_ownOutput.m_intervalsPerHeader = MAX_PRINT_HEADER_COUNT;
+}
+
+void DeviceInfo::SetHost(std::string hostTag, unsigned int hostWidth, DmonOutput &output)
+{
+    m_hostTag   = std::move(hostTag);
+    m_hostWidth = hostWidth;
+    m_output    = &output;
 }
 
 /**
@@ -182,126 +200,623 @@ void killHandler(int sig)
 }
 
 /**
- * In this function we simply print out the information in the callback of
- * the  watched field. This ia called as a callback to dcgmGetLatestValues_v2
- * function.
+ * Format a field value the way the dmon table displays it.
+ *
+ * @param value     The value to format.
+ * @param formatted Set to the formatted value.
+ * @return          true on success; false if the value is of an unknown type
+ */
+static bool FormatFieldValue(DmonValue const &value, std::string &formatted)
+{
+    // Including a switch statement here for handling different
+    // types of values (except binary blobs).
+    switch (value.m_fieldType)
+    {
+        case DCGM_FT_BINARY:
+            formatted = NA;
+            break;
+        case DCGM_FT_DOUBLE:
+            if (DCGM_FP64_IS_BLANK(value.m_dbl))
+            {
+                formatted = NA;
+            }
+            else
+            {
+                // fixing the number of values after decimal for consistency in display.
+                formatted.clear();
+                DcgmNs::AppendDoubleFixed(formatted, value.m_dbl, FLOAT_VAL_PREC);
+            }
+            break;
+        case DCGM_FT_INT64:
+        case DCGM_FT_TIMESTAMP:
+            if (DCGM_INT64_IS_BLANK(value.m_i64))
+            {
+                formatted = NA;
+            }
+            else
+            {
+                formatted = DcgmNs::Int64ToString(value.m_i64);
+            }
+            break;
+        case DCGM_FT_STRING:
+            formatted = value.m_str;
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Whether a value is blank and shown as N/A in the dmon table.
+ */
+static bool IsBlankValue(DmonValue const &value)
+{
+    switch (value.m_fieldType)
+    {
+        case DCGM_FT_DOUBLE:
+            return DCGM_FP64_IS_BLANK(value.m_dbl);
+        case DCGM_FT_INT64:
+        case DCGM_FT_TIMESTAMP:
+            return DCGM_INT64_IS_BLANK(value.m_i64);
+        case DCGM_FT_STRING:
+            return DCGM_STR_IS_BLANK(value.m_str.c_str());
+        default:
+            return true;
+    }
+}
+
+/**
+ * Append a number for the csv and jsonl formats. Strings are left to the
+ * callers, which quote them differently.
+ *
+ * @return false if the value is not a number
+ */
+static bool AppendNumber(std::string &out, DmonValue const &value)
+{
+    switch (value.m_fieldType)
+    {
+        case DCGM_FT_DOUBLE:
+            DcgmNs::AppendDoubleFixed(out, value.m_dbl, FLOAT_VAL_PREC);
+            return true;
+        case DCGM_FT_INT64:
+        case DCGM_FT_TIMESTAMP:
+            DcgmNs::AppendInt64(out, value.m_i64);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void AppendJsonString(std::string &out, std::string_view value)
+{
+    out += '"';
+    for (char const c : value)
+    {
+        switch (c)
+        {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                    out += escaped;
+                }
+                else
+                {
+                    out += c;
+                }
+                break;
+        }
+    }
+    out += '"';
+}
+
+static void AppendCsvString(std::string &out, std::string_view value)
+{
+    if (value.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        out += value;
+        return;
+    }
+
+    out += '"';
+    for (char const c : value)
+    {
+        if (c == '"')
+        {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+/**
+ * The timestamp of a row: that of its newest value.
+ */
+static long long RowTimestamp(std::vector<std::optional<DmonValue>> const &columns)
+{
+    long long timestamp = 0;
+
+    for (auto const &value : columns)
+    {
+        if (value)
+        {
+            timestamp = std::max(timestamp, value->m_timestamp);
+        }
+    }
+
+    return timestamp;
+}
+
+/**
+ * Write a buffer to stdout and flush it, so that consumers of the csv,
+ * jsonl and binary formats get each interval as soon as it is complete.
+ */
+static void WriteToStdout(char const *buffer, size_t size)
+{
+    std::cout.flush();
+    fwrite(buffer, 1, size, stdout);
+    fflush(stdout);
+}
+
+/**
+ * Called on a DCGM thread with the values the host engine pushes to our
+ * stream. The values are queued per entity and column, to be printed by
+ * LockWatchAndUpdate once a full interval has arrived.
  *
  * @param entityGroupId entityGroup of the entity this field value set belongs to
  * @param entityId      Entity this field value set belongs to
- * @param values        The values under watch.
- * @param numValues     Total number of values under watch.
- * @param userdata      The generic data which needs to be passed to function. The void
- *                      pointer at the end allows a pointer to be passed to this function. Here we know
- *                      that we are passing in a map, so we can cast it as such.
- *                      This pointer is also useful if we need a reference to something else inside your function.
+ * @param values        The values streamed.
+ * @param numValues     Total number of values streamed.
+ * @param userdata      The DeviceInfo that subscribed.
  * @return              0 on success; 1 on failure
  */
-static int ListFieldValues(dcgm_field_entity_group_t entityGroupId,
-                           dcgm_field_eid_t entityId,
-                           dcgmFieldValue_v1 *values,
-                           int numValues,
-                           void *userdata)
-{
-    std::string st;
-    std::stringstream strs;
+int DeviceInfo::StreamFieldValues(dcgm_field_entity_group_t entityGroupId,
+                                  dcgm_field_eid_t entityId,
+                                  dcgmFieldValue_v1 *values,
+                                  int numValues,
+                                  void *userdata)
+{
+    DeviceInfo &self = *static_cast<DeviceInfo *>(userdata);
     dcgmi_entity_pair_t entityKey;
 
-    // Note: this is a pointer to a map and we cast it to map below.
-    std::map<dcgmi_entity_pair_t, std::vector<std::string>> &entityStats
-        = *(static_cast<std::map<dcgmi_entity_pair_t, std::vector<std::string>> *>(userdata));
-
     entityKey.entityGroupId = entityGroupId;
     entityKey.entityId      = entityId;
 
-    for (int i = 0; i < numValues; i++)
+    std::lock_guard<std::mutex> lock(self.m_pendingMutex);
+
+    auto entityIt = self.m_pendingValues.find(entityKey);
+    if (entityIt == self.m_pendingValues.end())
     {
-        strs.clear(); // clear any bits set
-        strs.str(std::string());
-        strs << std::fixed;
-        strs << std::setprecision(
-            FLOAT_VAL_PREC); // fixing the number of values after decimal for consistency in display.
+        return 0; /* Not one of ours */
+    }
 
-        // Including a switch statement here for handling different
-        // types of values (except binary blobs).
-        dcgm_field_meta_p field = DcgmFieldGetById(values[i].fieldId);
-        if (field == nullptr)
+    for (int i = 0; i < numValues; i++)
+    {
+        auto columnIt = self.m_fieldColumns.find(values[i].fieldId);
+        if (columnIt == self.m_fieldColumns.end())
         {
-            return 1;
+            continue;
         }
 
-        switch (field->fieldType)
+        DmonValue value;
+
+        value.m_timestamp = values[i].ts;
+        value.m_fieldId   = values[i].fieldId;
+        value.m_fieldType = values[i].fieldType;
+
+        switch (values[i].fieldType)
         {
             case DCGM_FT_BINARY:
-                strs << NA;
-                entityStats[entityKey].push_back(strs.str());
                 break;
             case DCGM_FT_DOUBLE:
-                if (DCGM_FP64_IS_BLANK(values[i].value.dbl))
-                {
-                    entityStats[entityKey].push_back(NA);
-                }
-                else
-                {
-                    strs << values[i].value.dbl;
-                    st = strs.str();
-                    entityStats[entityKey].push_back(st);
-                }
+                value.m_dbl = values[i].value.dbl;
                 break;
             case DCGM_FT_INT64:
-                if (DCGM_INT64_IS_BLANK(values[i].value.i64))
-                {
-                    entityStats[entityKey].push_back(NA);
-                }
-                else
-                {
-                    strs << values[i].value.i64;
-                    st = strs.str();
-                    entityStats[entityKey].push_back(st);
-                }
+            case DCGM_FT_TIMESTAMP:
+                value.m_i64 = values[i].value.i64;
                 break;
             case DCGM_FT_STRING:
-                entityStats[entityKey].push_back(values[i].value.str);
-                break;
-            case DCGM_FT_TIMESTAMP:
-                if (DCGM_INT64_IS_BLANK(values[i].value.i64))
-                {
-                    entityStats[entityKey].push_back(NA);
-                }
-                else
-                {
-                    strs << values[i].value.i64;
-                    entityStats[entityKey].push_back(strs.str());
-                }
+                value.m_str = values[i].value.str;
                 break;
             default:
-                std::cout << "Error in field types. " << values[i].fieldType << " Exiting." << std::endl;
-                // Error, return > 0 error code.
+                self.m_streamFailed = true;
+                self.m_pendingCv.notify_one();
                 return 1;
         }
+
+        entityIt->second[columnIt->second].push_back(std::move(value));
     }
-    // Program executed correctly. Return 0 to notify DCGM (callee) that it
-    // was successful.
+
+    self.m_pendingCv.notify_one();
+
     return 0;
 }
 
 /**
- * lockWatchAndUpdate : The function sets the watches on the field group
- *                      for the mentioned Gpu group.
+ * Whether the values of an interval are queued and can be printed. That is
+ * when every entity has a value for every column, or when a column has
+ * values of two intervals, so that a field that doesn't update on each
+ * interval does not hold back the others. Call with m_pendingMutex held.
+ */
+bool DeviceInfo::IsIntervalReady() const
+{
+    bool allFilled = true;
+
+    for (auto const &[entityPair, columns] : m_pendingValues)
+    {
+        for (auto const &column : columns)
+        {
+            if (column.size() >= 2)
+            {
+                return true;
+            }
+
+            allFilled = allFilled && !column.empty();
+        }
+    }
+
+    return allFilled;
+}
+
+/**
+ * Move the oldest queued value of each entity and column into m_interval.
+ * Call with m_pendingMutex held.
+ */
+void DeviceInfo::TakeInterval()
+{
+    for (auto &[entityPair, columns] : m_pendingValues)
+    {
+        auto &interval = m_interval[entityPair];
+
+        interval.resize(columns.size());
+
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            if (columns[i].empty())
+            {
+                interval[i].reset();
+                continue;
+            }
+
+            interval[i] = std::move(columns[i].front());
+            columns[i].pop_front();
+        }
+    }
+}
+
+/**
+ * Print m_interval as rows of the table. Columns without a new value
+ * keep the value printed last.
+ */
+void DeviceInfo::PrintTableInterval()
+{
+    for (auto const &[entityPair, columns] : m_interval)
+    {
+        auto &statsVec = m_entityStats[entityPair];
+
+        statsVec.resize(columns.size(), NA);
+
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            if (columns[i] && !FormatFieldValue(*columns[i], statsVec[i]))
+            {
+                statsVec[i] = NA;
+            }
+        }
+    }
+
+    // print the map that we populated from the stream
+    for (auto const &[entityPair, statsVec] : m_entityStats)
+    {
+        auto const groupPrefix = HelperGetGroupIdPrefix(entityPair.entityGroupId);
+
+        if (!m_hostTag.empty())
+        {
+            std::cout << std::left << std::setw(m_hostWidth + 1) << m_hostTag << std::right;
+        }
+
+        std::cout << std::setw(m_widthArray[0]);
+        std::cout << groupPrefix << " " << entityPair.entityId;
+
+        for (size_t i = 0; i < statsVec.size(); i++)
+        {
+            auto const width = m_widthArray[i + 1];
+            /* Check if we are overflowing the width we are assigned */
+            if (statsVec[i].length() >= width)
+            {
+                std::cout << std::setw(0);
+                std::cout << ' ';
+            }
+            std::cout << std::setw(width);
+            std::cout << statsVec[i];
+        }
+        std::cout << "\n";
+    }
+
+    std::cout.flush();
+}
+
+/**
+ * Write m_interval as csv rows, one per entity with new values. Columns
+ * without a new value, and blank values, are left empty.
+ */
+void DeviceInfo::WriteCsvInterval()
+{
+    m_outputBuffer.clear();
+
+    for (auto const &[entityPair, columns] : m_interval)
+    {
+        long long const timestamp = RowTimestamp(columns);
+        if (timestamp == 0)
+        {
+            continue;
+        }
+
+        if (!m_hostTag.empty())
+        {
+            AppendCsvString(m_outputBuffer, m_hostTag);
+            m_outputBuffer += ',';
+        }
+
+        m_outputBuffer += HelperGetGroupIdPrefix(entityPair.entityGroupId);
+        m_outputBuffer += ',';
+        DcgmNs::AppendInt64(m_outputBuffer, entityPair.entityId);
+        m_outputBuffer += ',';
+        DcgmNs::AppendInt64(m_outputBuffer, timestamp);
+
+        for (auto const &value : columns)
+        {
+            m_outputBuffer += ',';
+
+            if (!value || IsBlankValue(*value) || AppendNumber(m_outputBuffer, *value))
+            {
+                continue;
+            }
+
+            AppendCsvString(m_outputBuffer, value->m_str);
+        }
+
+        m_outputBuffer += '\n';
+    }
+
+    WriteToStdout(m_outputBuffer.data(), m_outputBuffer.size());
+}
+
+/**
+ * Write m_interval as JSON objects, one per line and entity with new
+ * values. Fields without a new value are left out; blank values are null.
+ */
+void DeviceInfo::WriteJsonlInterval()
+{
+    m_outputBuffer.clear();
+
+    for (auto const &[entityPair, columns] : m_interval)
+    {
+        long long const timestamp = RowTimestamp(columns);
+        if (timestamp == 0)
+        {
+            continue;
+        }
+
+        bool first = true;
+
+        m_outputBuffer += '{';
+
+        if (!m_hostTag.empty())
+        {
+            m_outputBuffer += "\"host\":";
+            AppendJsonString(m_outputBuffer, m_hostTag);
+            m_outputBuffer += ',';
+        }
+
+        m_outputBuffer += "\"entity_group\":\"";
+        m_outputBuffer += HelperGetGroupIdPrefix(entityPair.entityGroupId);
+        m_outputBuffer += "\",\"entity_id\":";
+        DcgmNs::AppendInt64(m_outputBuffer, entityPair.entityId);
+        m_outputBuffer += ",\"timestamp\":";
+        DcgmNs::AppendInt64(m_outputBuffer, timestamp);
+        m_outputBuffer += ",\"values\":{";
+
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            if (!columns[i])
+            {
+                continue;
+            }
+
+            if (!first)
+            {
+                m_outputBuffer += ',';
+            }
+            first = false;
+
+            AppendJsonString(m_outputBuffer, m_fieldTags[i]);
+            m_outputBuffer += ':';
+
+            if (IsBlankValue(*columns[i]))
+            {
+                m_outputBuffer += "null";
+            }
+            else if (!AppendNumber(m_outputBuffer, *columns[i]))
+            {
+                AppendJsonString(m_outputBuffer, columns[i]->m_str);
+            }
+        }
+
+        m_outputBuffer += "}}\n";
+    }
+
+    WriteToStdout(m_outputBuffer.data(), m_outputBuffer.size());
+}
+
+/**
+ * Write the new values of m_interval as dcgmBufferedFv_v1 records. Each
+ * record starts with its length. Blank values keep their DCGM blank
+ * values. Binary fields are not written.
+ */
+void DeviceInfo::WriteBinaryInterval()
+{
+    size_t bufferSize   = 0;
+    size_t elementCount = 0;
+
+    m_fvBuffer.Clear();
+
+    for (auto const &[entityPair, columns] : m_interval)
+    {
+        for (auto const &value : columns)
+        {
+            if (!value)
+            {
+                continue;
+            }
+
+            auto const entityGroupId = static_cast<dcgm_field_entity_group_t>(entityPair.entityGroupId);
+            dcgmBufferedFv_t *fv     = nullptr;
+
+            switch (value->m_fieldType)
+            {
+                case DCGM_FT_DOUBLE:
+                    fv = m_fvBuffer.AddDoubleValue(entityGroupId,
+                                                   entityPair.entityId,
+                                                   value->m_fieldId,
+                                                   value->m_dbl,
+                                                   value->m_timestamp,
+                                                   DCGM_ST_OK);
+                    break;
+                case DCGM_FT_INT64:
+                case DCGM_FT_TIMESTAMP:
+                    fv = m_fvBuffer.AddInt64Value(entityGroupId,
+                                                  entityPair.entityId,
+                                                  value->m_fieldId,
+                                                  value->m_i64,
+                                                  value->m_timestamp,
+                                                  DCGM_ST_OK);
+                    break;
+                case DCGM_FT_STRING:
+                    fv = m_fvBuffer.AddStringValue(entityGroupId,
+                                                   entityPair.entityId,
+                                                   value->m_fieldId,
+                                                   const_cast<char *>(value->m_str.c_str()),
+                                                   value->m_timestamp,
+                                                   DCGM_ST_OK);
+                    break;
+                default:
+                    break;
+            }
+
+            if (fv != nullptr)
+            {
+                fv->fieldType = value->m_fieldType;
+            }
+        }
+    }
+
+    m_fvBuffer.GetSize(&bufferSize, &elementCount);
+
+    if (bufferSize > 0)
+    {
+        WriteToStdout(m_fvBuffer.GetBuffer(), bufferSize);
+    }
+}
+
+/**
+ * Fill m_pendingValues with an empty queue for each column of each entity
+ * of m_myGroupId.
+ *
+ * @return dcgmReturn_t : result - success or error
+ */
+dcgmReturn_t DeviceInfo::PrepareStreamedEntities()
+{
+    dcgmGroupInfo_t dcgmGroupInfo {};
+    dcgmGroupInfo.version = dcgmGroupInfo_version;
+
+    dcgmReturn_t result = dcgmGroupGetInfo(m_dcgmHandle, m_myGroupId, &dcgmGroupInfo);
+    if (result != DCGM_ST_OK)
+    {
+        std::cout << "Error: Unable to retrieve information about the entity group. Return: " << errorString(result)
+                  << std::endl;
+        return result;
+    }
+
+    if ((dcgmGroupInfo.count == 0) || m_fieldIds.empty())
+    {
+        std::cout << "Error: The field group or entity group is empty." << std::endl;
+        return DCGM_ST_NO_DATA; /* Propagate this to any callers */
+    }
+
+    m_fieldColumns.clear();
+    for (size_t i = 0; i < m_fieldIds.size(); i++)
+    {
+        m_fieldColumns.emplace(m_fieldIds[i], i);
+    }
+
+    m_pendingValues.clear();
+    for (unsigned int i = 0; i < dcgmGroupInfo.count; i++)
+    {
+        dcgmi_entity_pair_t entityKey;
+
+        entityKey.entityGroupId = dcgmGroupInfo.entityList[i].entityGroupId;
+        entityKey.entityId      = dcgmGroupInfo.entityList[i].entityId;
+
+        m_pendingValues[entityKey].resize(m_fieldIds.size());
+    }
+
+    m_fieldTags.clear();
+    for (auto const fieldId : m_fieldIds)
+    {
+        dcgm_field_meta_p meta_p = DcgmFieldGetById(fieldId);
+        m_fieldTags.emplace_back((meta_p == nullptr) ? std::to_string(fieldId) : meta_p->tag);
+    }
+
+    m_entityStats.clear();
+    m_interval.clear();
+    m_streamFailed = false;
+
+    return DCGM_ST_OK;
+}
+
+/**
+ * lockWatchAndUpdate : The function subscribes to a stream of the field
+ *                      group for the mentioned Gpu group, and prints each
+ *                      interval of values that the host engine pushes.
  * @return dcgmReturn_t : result - success or error
  */
 
 dcgmReturn_t DeviceInfo::LockWatchAndUpdate()
 {
-    int running          = 0;
-    int decrement        = 0;
-    int printHeaderCount = 0;
+    int running   = 0;
+    int decrement = 0;
+    unsigned int streamId { 0 };
+
+    dcgmReturn_t result = PrepareStreamedEntities();
+    if (result != DCGM_ST_OK)
+    {
+        return result;
+    }
 
     /* Install a signal handler to catch ctrl-c */
     signal(SIGINT, &killHandler);
 
-    // set the watch on field group id for Group of gpus.
-    dcgmReturn_t result = dcgmWatchFields(
-        m_dcgmHandle, m_myGroupId, m_fieldGroupId, m_delay * MILLI_SEC, MAX_KEEP_AGE, MAX_KEEP_SAMPLES);
+    // Subscribe to the field group for the group of gpus. This sets the watches too.
+    dcgmFieldValueStreamParams_t streamParams {};
+    streamParams.version        = dcgmFieldValueStreamParams_version;
+    streamParams.groupId        = m_myGroupId;
+    streamParams.fieldGroupId   = m_fieldGroupId;
+    streamParams.updateFreq     = m_delay * MILLI_SEC;
+    streamParams.maxKeepAge     = MAX_KEEP_AGE;
+    streamParams.maxKeepSamples = MAX_KEEP_SAMPLES;
+
+    result = dcgmFieldValueStreamSubscribe(m_dcgmHandle, &streamParams, &StreamFieldValues, this, &streamId);
 
     // Check result to see if DCGM operation was successful.
     if (result != DCGM_ST_OK)
@@ -347,48 +862,56 @@ dcgmReturn_t DeviceInfo::LockWatchAndUpdate()
 
     while (running && !deviceMonitorShouldStop)
     {
-        m_entityStats.clear();
-        result = dcgmGetLatestValues_v2(m_dcgmHandle, m_myGroupId, m_fieldGroupId, &ListFieldValues, &m_entityStats);
-        // Check the result to see if our DCGM operation was successful.
-        if (result != DCGM_ST_OK)
-        {
-            PRINT_ERROR("%d", "Error! Error getting values information. Return: %d", result);
-            std::cout << "Error getting values information."
-                         "Return: "
-                      << errorString(result) << std::endl;
-            return result;
-        }
-
-        if (m_entityStats.empty())
         {
-            std::cout << "Error: The field group or entity group is empty." << std::endl;
-            return DCGM_ST_NO_DATA; /* Propagate this to any callers */
-        }
+            std::unique_lock<std::mutex> lock(m_pendingMutex);
 
-        // print the map that we populated in callback of dcgmGetLatestValues
-        for (auto const &[entityPair, statsVec] : m_entityStats)
-        {
-            auto const groupPrefix = HelperGetGroupIdPrefix(entityPair.entityGroupId);
+            /* Wake up now and then to notice ctrl-c */
+            m_pendingCv.wait_for(lock, std::chrono::milliseconds(100), [this] {
+                return m_streamFailed || IsIntervalReady();
+            });
 
-            std::cout << std::setw(m_widthArray[0]);
-            std::cout << groupPrefix << " " << entityPair.entityId;
+            if (m_streamFailed)
+            {
+                result = DCGM_ST_GENERIC_ERROR;
+                break;
+            }
 
-            for (size_t i = 0; i < statsVec.size(); i++)
+            if (!IsIntervalReady())
             {
-                auto const width = m_widthArray[i + 1];
-                /* Check if we are overflowing the width we are assigned */
-                if (statsVec[i].length() >= width)
-                {
-                    std::cout << std::setw(0);
-                    std::cout << ' ';
-                }
-                std::cout << std::setw(width);
-                std::cout << statsVec[i];
+                continue;
             }
-            std::cout << "\n";
+
+            TakeInterval();
         }
 
-        std::cout.flush();
+        std::lock_guard<std::mutex> outputLock(m_output->m_mutex);
+
+        switch (m_outputFormat)
+        {
+            case DmonOutputFormat::Table:
+                if (m_output->m_intervalsSinceHeader == m_output->m_intervalsPerHeader)
+                {
+                    std::cout << "" << std::endl;
+                    PrintHeaderForOutput();
+                    m_output->m_intervalsSinceHeader = 0;
+                }
+                m_output->m_intervalsSinceHeader++;
+
+                PrintTableInterval();
+                break;
+
+            case DmonOutputFormat::Csv:
+                WriteCsvInterval();
+                break;
+
+            case DmonOutputFormat::Jsonl:
+                WriteJsonlInterval();
+                break;
+
+            case DmonOutputFormat::Binary:
+                WriteBinaryInterval();
+                break;
+        }
 
         // We decrement only when count value is not default and the loop is not supposed to run forever.
         if (decrement)
@@ -399,20 +922,19 @@ dcgmReturn_t DeviceInfo::LockWatchAndUpdate()
                 break;
             }
         }
-
-        usleep(m_delay * MILLI_SEC);
-        if (printHeaderCount == MAX_PRINT_HEADER_COUNT)
-        {
-            std::cout << "" << std::endl;
-            PrintHeaderForOutput();
-            printHeaderCount = 0;
-        }
-        printHeaderCount++;
     }
 
-    if (deviceMonitorShouldStop)
+    dcgmFieldValueStreamUnsubscribe(m_dcgmHandle, streamId);
+
+    std::lock_guard<std::mutex> outputLock(m_output->m_mutex);
+
+    if (deviceMonitorShouldStop && !m_output->m_stopPrinted)
     {
-        std::cout << std::endl << "dmon was stopped due to receiving a signal." << std::endl;
+        /* Keep the machine-readable formats parseable */
+        std::ostream &out = (m_outputFormat == DmonOutputFormat::Table) ? std::cout : std::cerr;
+
+        out << std::endl << "dmon was stopped due to receiving a signal." << std::endl;
+        m_output->m_stopPrinted = true;
     }
 
     return result;
@@ -441,6 +963,13 @@ void DeviceInfo::SetHeaderForOutput(unsigned short fieldIds[], unsigned int cons
     std::stringstream ss;
     std::stringstream ss_unit;
     ss << "#";
+
+    if (!m_hostTag.empty())
+    {
+        ss << std::left << std::setw(m_hostWidth) << "Host" << std::right << " ";
+        ss_unit << std::setw(m_hostWidth + 1) << "";
+    }
+
     ss << std::setw(entityWidth);
     ss << "Entity";
 
@@ -624,8 +1153,121 @@ dcgmReturn_t DeviceInfo::CreateFieldGroupAndGpuGroup(void)
         return dcgmReturn;
     }
 
-    PrintHeaderForOutput();
+    PrintHeaderOnce();
 
     dcgmReturn = LockWatchAndUpdate();
     return dcgmReturn;
 }
+
+/**
+ * Print the header of the table or the csv header row, unless the DeviceInfo
+ * of another host printed it already.
+ */
+void DeviceInfo::PrintHeaderOnce()
+{
+    std::lock_guard<std::mutex> outputLock(m_output->m_mutex);
+
+    if (m_output->m_headerPrinted)
+    {
+        return;
+    }
+    m_output->m_headerPrinted = true;
+
+    if (m_outputFormat == DmonOutputFormat::Table)
+    {
+        PrintHeaderForOutput();
+    }
+    else if (m_outputFormat == DmonOutputFormat::Csv)
+    {
+        std::string header = m_hostTag.empty() ? "" : "host,";
+
+        header += "entity_group,entity_id,timestamp";
+
+        for (auto const fieldId : m_fieldIds)
+        {
+            dcgm_field_meta_p meta_p = DcgmFieldGetById(fieldId);
+
+            header += ',';
+            header += (meta_p == nullptr) ? std::to_string(fieldId) : meta_p->tag;
+        }
+
+        header += '\n';
+        WriteToStdout(header.data(), header.size());
+    }
+}
+
+/**
+ * Constructor : One DeviceInfo per host, all printing to m_output
+ */
+MultiHostDeviceInfo::MultiHostDeviceInfo(std::vector<std::string> hostNames,
+                                         std::string const &requestedEntityIds,
+                                         std::string const &grpIdStr,
+                                         std::string const &fldIds,
+                                         int fieldGroupId,
+                                         int updateDelay,
+                                         int numOfIterations,
+                                         DmonOutputFormat outputFormat)
+    : m_hostNames(std::move(hostNames))
+{
+    unsigned int hostWidth = 4; /* strlen("Host") */
+
+    for (auto const &hostName : m_hostNames)
+    {
+        hostWidth = std::max(hostWidth, static_cast<unsigned int>(hostName.size()));
+    }
+
+    /* Repeat the table header about as often as for a single host */
+    m_output.m_intervalsPerHeader = MAX_PRINT_HEADER_COUNT * m_hostNames.size();
+
+    for (auto const &hostName : m_hostNames)
+    {
+        m_devices.push_back(std::make_unique<DeviceInfo>(hostName,
+                                                         requestedEntityIds,
+                                                         grpIdStr,
+                                                         fldIds,
+                                                         fieldGroupId,
+                                                         updateDelay,
+                                                         numOfIterations,
+                                                         false,
+                                                         outputFormat));
+        m_devices.back()->SetHost(hostName, hostWidth, m_output);
+    }
+}
+
+dcgmReturn_t MultiHostDeviceInfo::Execute()
+{
+    std::vector<dcgmReturn_t> results(m_devices.size(), DCGM_ST_OK);
+    std::vector<std::thread> threads;
+
+    threads.reserve(m_devices.size());
+
+    /* Each host connects, streams and prints on its own thread */
+    for (size_t i = 0; i < m_devices.size(); i++)
+    {
+        threads.emplace_back([this, &results, i] { results[i] = m_devices[i]->Execute(); });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < m_devices.size(); i++)
+    {
+        if (results[i] != DCGM_ST_OK)
+        {
+            std::cerr << "Error: dmon failed on host " << m_hostNames[i] << ". Return: " << errorString(results[i])
+                      << std::endl;
+        }
+    }
+
+    for (auto const result : results)
+    {
+        if (result != DCGM_ST_OK)
+        {
+            return result;
+        }
+    }
+
+    return DCGM_ST_OK;
+}
@@ -21,13 +21,20 @@
 #define DEVICEMONITOR_H_
 
 #include "Command.h"
+#include "DcgmFvBuffer.h"
 #include "dcgm_structs.h"
 #include "dcgmi_common.h"
 
 #include <algorithm>
 #include <climits>
+#include <condition_variable>
 #include <csignal>
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <vector>
 
 
@@ -52,6 +59,43 @@ struct FieldDetails
     char m_padding[4] {};    /*!< Padding for alignment */
 };
 
+/**
+ * How dmon prints the values it monitors.
+ */
+enum class DmonOutputFormat
+{
+    Table,  /*!< Aligned columns for people. The default. */
+    Csv,    /*!< One comma-separated row per entity and interval, after a header row of field tags. */
+    Jsonl,  /*!< One JSON object per entity and interval. */
+    Binary, /*!< The dcgmBufferedFv_v1 records of the values, one after another. */
+};
+
+/**
+ * A value streamed to dmon, kept until its interval is printed.
+ */
+struct DmonValue
+{
+    long long m_timestamp {};      /*!< Timestamp in usec since 1970 */
+    unsigned short m_fieldId {};   /*!< One of DCGM_FI_? */
+    unsigned short m_fieldType {}; /*!< One of DCGM_FT_? */
+    int64_t m_i64 {};              /*!< Value of int64 and timestamp fields */
+    double m_dbl {};               /*!< Value of double fields */
+    std::string m_str;             /*!< Value of string fields */
+};
+
+/**
+ * Where the DeviceInfo of each host that dmon monitors prints, so that their intervals aren't
+ * interleaved and the header is printed once for all of them.
+ */
+struct DmonOutput
+{
+    std::mutex m_mutex;                     /*!< Held while the header or an interval is printed */
+    bool m_headerPrinted { false };         /*!< Set once the header or csv header row is printed */
+    bool m_stopPrinted { false };           /*!< Set once the stop message is printed */
+    unsigned int m_intervalsSinceHeader {}; /*!< Intervals of any host printed since the table header */
+    unsigned int m_intervalsPerHeader {};   /*!< How many intervals to print before repeating the table header */
+};
+
 class DeviceInfo : public Command
 {
 public:
@@ -62,15 +106,41 @@ public:
                int fieldGroupId,
                int updateDelay,
                int numOfIterations,
-               bool listOptionMentioned);
+               bool listOptionMentioned,
+               DmonOutputFormat outputFormat = DmonOutputFormat::Table);
+
+    /**********************************************************************
+     * Tag the output with hostTag, left-aligned in a column of hostWidth
+     * characters, and print to output, which is shared with the DeviceInfo
+     * of the other hosts monitored. Call before Execute.
+     */
+    void SetHost(std::string hostTag, unsigned int hostWidth, DmonOutput &output);
 
 protected:
     dcgmReturn_t DoExecuteConnected() override;
 
 private:
+    DmonOutput m_ownOutput;                  /*!< Where to print when monitoring a single host */
+    DmonOutput *m_output { &m_ownOutput };   /*!< Where to print */
+    std::string m_hostTag;                   /*!< Host the output is tagged with. Empty for a single host */
+    unsigned int m_hostWidth {};             /*!< Width of the host column of the table */
     std::map<dcgmi_entity_pair_t, std::vector<std::string>>
         m_entityStats; /*!< map that holds the entity ID and vector of values for fields that are queried in dmon are
-                            requested. Populated in callback of dcgmGetLatestValues_v2. */
+                            requested. Populated from m_pendingValues for each interval printed. */
+    std::map<dcgmi_entity_pair_t, std::vector<std::deque<DmonValue>>>
+        m_pendingValues; /*!< Values streamed but not printed yet, per entity and column. Guarded by
+                              m_pendingMutex. */
+    std::map<dcgmi_entity_pair_t, std::vector<std::optional<DmonValue>>>
+        m_interval; /*!< The values of the interval being printed, per entity and column. Empty when a column
+                         has no new value. */
+    DmonOutputFormat m_outputFormat;                 /*!< How to print the values */
+    std::string m_outputBuffer;                      /*!< csv and jsonl rows, written once per interval */
+    std::vector<std::string> m_fieldTags;            /*!< Field tag of each column, for the csv and jsonl formats */
+    DcgmFvBuffer m_fvBuffer;                         /*!< Records of the binary format, reused for each interval */
+    std::map<unsigned short, size_t> m_fieldColumns; /*!< Column of each field id in m_fieldIds */
+    std::mutex m_pendingMutex;                       /*!< Guards m_pendingValues and m_streamFailed */
+    std::condition_variable m_pendingCv;             /*!< Signaled when values are streamed */
+    bool m_streamFailed { false };                   /*!< Set when a streamed value couldn't be handled */
     std::string m_requestedEntityIds;       /*!< The Entity Ids requested in the options for command.*/
     std::string m_groupIdStr;               /*!< The group Id mentioned in command. */
     std::string m_fieldIdsStr;              /*!< The Field Ids to query for. Mentioned in the options.  */
@@ -118,9 +188,50 @@ private:
     dcgmReturn_t CreateEntityGroupFromEntityList(void);
 
     dcgmReturn_t LockWatchAndUpdate();
+    dcgmReturn_t PrepareStreamedEntities();
+    bool IsIntervalReady() const;
+    void TakeInterval();
+    void PrintTableInterval();
+    void WriteCsvInterval();
+    void WriteJsonlInterval();
+    void WriteBinaryInterval();
+    static int StreamFieldValues(dcgm_field_entity_group_t entityGroupId,
+                                 dcgm_field_eid_t entityId,
+                                 dcgmFieldValue_v1 *values,
+                                 int numValues,
+                                 void *userdata);
     void PrintHeaderForOutput() const;
+    void PrintHeaderOnce();
     void SetHeaderForOutput(unsigned short fieldIds[], unsigned int numFields);
     void PopulateFieldDetails();
     void DisplayFieldDetails();
 };
+/**
+ * Runs dmon against several hosts at once, each on its own thread and connection. The values are
+ * merged into one stream, tagged with the host they came from.
+ */
+class MultiHostDeviceInfo
+{
+public:
+    MultiHostDeviceInfo(std::vector<std::string> hostNames,
+                        std::string const &requestedEntityIds,
+                        std::string const &grpIdStr,
+                        std::string const &fldIds,
+                        int fieldGroupId,
+                        int updateDelay,
+                        int numOfIterations,
+                        DmonOutputFormat outputFormat);
+
+    /**********************************************************************
+     * Monitor all of the hosts until the count is reached on each of them
+     * or dmon is stopped. Returns the error of the first host that failed
+     */
+    dcgmReturn_t Execute();
+
+private:
+    std::vector<std::string> m_hostNames;
+    std::vector<std::unique_ptr<DeviceInfo>> m_devices; /*!< One per host, in the order of m_hostNames */
+    DmonOutput m_output;
+};
+
 #endif /* DEVICEMONITOR_H_ */
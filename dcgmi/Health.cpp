@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <ctype.h>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string.h>
@@ -180,50 +181,9 @@ dcgmReturn_t Health::SetWatches(dcgmHandle_t mDcgmHandle,
 }
 
 /*****************************************************************************/
-dcgmReturn_t Health::CheckWatches(dcgmHandle_t mDcgmHandle, dcgmGpuGrp_t groupId, bool json)
+template <typename Output>
+void Health::HelperAddIncidents(Output &out, dcgmHealthResponse_t const &response)
 {
-    dcgmReturn_t result = DCGM_ST_OK;
-    dcgmHealthResponse_t response;
-    dcgmHealthSystems_t systems;
-    DcgmiOutputTree outTree(28, 60);
-    DcgmiOutputJson outJson;
-    DcgmiOutput &out = json ? (DcgmiOutput &)outJson : (DcgmiOutput &)outTree;
-
-    response.version = dcgmHealthResponse_version;
-
-    result = dcgmHealthCheck(mDcgmHandle, groupId, &response);
-
-    if (DCGM_ST_OK != result)
-    {
-        std::string error = (result == DCGM_ST_NOT_CONFIGURED) ? "The Group is not found" : errorString(result);
-        std::cout << "Error: Unable to check health watches. Return: " << error << std::endl;
-        PRINT_ERROR("%u, %d",
-                    "Error: could not check Health information for group: %u. Return: %d",
-                    (unsigned int)(uintptr_t)groupId,
-                    result);
-        return DCGM_ST_GENERIC_ERROR;
-    }
-
-
-    // Check if watches are enabled
-    result = dcgmHealthGet(mDcgmHandle, groupId, &systems);
-    if (DCGM_ST_OK != result)
-    {
-        std::cout << "Error: Unable to check health watches. Return: " << errorString(result) << std::endl;
-        return DCGM_ST_GENERIC_ERROR;
-    }
-
-    if (!(systems & DCGM_HEALTH_WATCH_ALL))
-    {
-        std::cout << "Error: Health watches not enabled. Please enable watches. \n";
-        return DCGM_ST_GENERIC_ERROR;
-    }
-
-    out.addHeader("Health Monitor Report");
-
-    out[OVERALL_HEALTH_TAG] = HelperHealthToString(response.overallHealth);
-
-
     for (unsigned int index = 0; index < response.incidentCount; index++)
     {
         dcgm_field_eid_t entityId               = response.incidents[index].entityInfo.entityId;
@@ -312,6 +272,54 @@ dcgmReturn_t Health::CheckWatches(dcgmHandle_t mDcgmHandle, dcgmGpuGrp_t groupId
 
         outEntity = HelperHealthToString(entityHealth);
     }
+}
+
+/*****************************************************************************/
+dcgmReturn_t Health::CheckWatches(dcgmHandle_t mDcgmHandle, dcgmGpuGrp_t groupId, bool json)
+{
+    dcgmReturn_t result = DCGM_ST_OK;
+    dcgmHealthResponse_t response;
+    dcgmHealthSystems_t systems;
+    DcgmiOutputTree outTree(28, 60);
+    DcgmiOutputJson outJson;
+    DcgmiOutput &out = json ? (DcgmiOutput &)outJson : (DcgmiOutput &)outTree;
+
+    response.version = dcgmHealthResponse_version;
+
+    result = dcgmHealthCheck(mDcgmHandle, groupId, &response);
+
+    if (DCGM_ST_OK != result)
+    {
+        std::string error = (result == DCGM_ST_NOT_CONFIGURED) ? "The Group is not found" : errorString(result);
+        std::cout << "Error: Unable to check health watches. Return: " << error << std::endl;
+        PRINT_ERROR("%u, %d",
+                    "Error: could not check Health information for group: %u. Return: %d",
+                    (unsigned int)(uintptr_t)groupId,
+                    result);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+
+    // Check if watches are enabled
+    result = dcgmHealthGet(mDcgmHandle, groupId, &systems);
+    if (DCGM_ST_OK != result)
+    {
+        std::cout << "Error: Unable to check health watches. Return: " << errorString(result) << std::endl;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    if (!(systems & DCGM_HEALTH_WATCH_ALL))
+    {
+        std::cout << "Error: Health watches not enabled. Please enable watches. \n";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    out.addHeader("Health Monitor Report");
+
+    out[OVERALL_HEALTH_TAG] = HelperHealthToString(response.overallHealth);
+
+
+    HelperAddIncidents(out, response);
 
     std::cout << out.str();
 
@@ -443,3 +451,95 @@ dcgmReturn_t CheckHealth::DoExecuteConnected()
 {
     return healthObj.CheckWatches(m_dcgmHandle, groupId, m_json);
 }
+
+/*****************************************************************************
+ *****************************************************************************
+ *Watch Watches Invoker for several hosts
+ *****************************************************************************
+ *****************************************************************************/
+
+/*****************************************************************************/
+CheckHealthMultiHost::CheckHealthMultiHost(std::vector<std::string> hostNames, unsigned int groupId, bool json)
+    : MultiHostCommand(std::move(hostNames))
+    , groupId(groupId)
+    , m_json(json)
+{
+    /* We want group actions to persist once this DCGMI instance exits */
+    SetPersistAfterDisconnect(1);
+}
+
+/*****************************************************************************/
+void CheckHealthMultiHost::DoPrepareHost(Host &host)
+{
+    dcgmHealthSystems_t systems;
+
+    // Check if watches are enabled
+    dcgmReturn_t result = dcgmHealthGet(host.m_dcgmHandle, groupId, &systems);
+    if (DCGM_ST_OK != result)
+    {
+        host.m_status = result;
+        host.m_error  = std::string("Unable to check health watches. Return: ") + errorString(result);
+    }
+    else if (!(systems & DCGM_HEALTH_WATCH_ALL))
+    {
+        host.m_status = DCGM_ST_NOT_CONFIGURED;
+        host.m_error  = "Health watches not enabled. Please enable watches.";
+    }
+}
+
+/*****************************************************************************/
+void CheckHealthMultiHost::DoExecuteConnected()
+{
+    DcgmiOutputTree outTree(28, 60);
+    DcgmiOutputJson outJson;
+    DcgmiOutput &out = m_json ? (DcgmiOutput &)outJson : (DcgmiOutput &)outTree;
+    std::vector<std::unique_ptr<dcgmHealthResponse_t>> responses(m_hosts.size());
+    AsyncRequestSet requests;
+
+    for (size_t i = 0; i < m_hosts.size(); i++)
+    {
+        if (m_hosts[i].m_status != DCGM_ST_OK)
+        {
+            continue;
+        }
+
+        responses[i]          = std::make_unique<dcgmHealthResponse_t>();
+        responses[i]->version = dcgmHealthResponse_version;
+
+        void *userData      = requests.Add(&m_hosts[i].m_status);
+        dcgmReturn_t result = dcgmHealthCheckAsync(
+            m_hosts[i].m_dcgmHandle, groupId, responses[i].get(), &AsyncRequestSet::Complete, userData);
+        if (DCGM_ST_OK != result)
+        {
+            AsyncRequestSet::Complete(result, userData);
+        }
+    }
+
+    requests.Wait();
+
+    out.addHeader("Health Monitor Report");
+
+    for (size_t i = 0; i < m_hosts.size(); i++)
+    {
+        Host &host                = m_hosts[i];
+        DcgmiOutputBoxer &outHost = out[host.m_hostName];
+
+        if (host.m_status != DCGM_ST_OK && host.m_error.empty())
+        {
+            std::string error = (host.m_status == DCGM_ST_NOT_CONFIGURED) ? "The Group is not found"
+                                                                          : errorString(host.m_status);
+            host.m_error      = "Unable to check health watches. Return: " + error;
+        }
+
+        if (host.m_status != DCGM_ST_OK)
+        {
+            outHost["Error"] = host.m_error;
+            continue;
+        }
+
+        outHost[OVERALL_HEALTH_TAG] = healthObj.HelperHealthToString(responses[i]->overallHealth);
+        healthObj.HelperAddIncidents(outHost, *responses[i]);
+    }
+
+    std::cout << out.str();
+}
@@ -24,6 +24,7 @@
 #define HEALTH_H_
 
 #include "Command.h"
+#include "MultiHost.h"
 
 class Health : public Command
 {
@@ -37,11 +38,18 @@ public:
                             double maxKeepAge);
     dcgmReturn_t CheckWatches(dcgmHandle_t mDcgmHandle, dcgmGpuGrp_t groupId, bool json);
 
+    /*****************************************************************************
+     * Add the incidents of a health check to an output or a section of it
+     *****************************************************************************/
+    template <typename Output>
+    void HelperAddIncidents(Output &out, dcgmHealthResponse_t const &response);
+
+    std::string HelperHealthToString(dcgmHealthWatchResults_t health);
+
 protected:
     dcgmReturn_t DoExecuteConnected() override;
 
 private:
-    std::string HelperHealthToString(dcgmHealthWatchResults_t health);
     std::string HelperSystemToString(dcgmHealthSystems_t system);
 };
 
@@ -105,4 +113,23 @@ private:
     dcgmGpuGrp_t groupId;
 };
 
+/**
+ * Check Watches Invoker for several hosts at once. The reports are merged into one, with a
+ * section per host.
+ */
+class CheckHealthMultiHost : public MultiHostCommand
+{
+public:
+    CheckHealthMultiHost(std::vector<std::string> hostNames, unsigned int groupId, bool json);
+
+protected:
+    void DoPrepareHost(Host &host) override;
+    void DoExecuteConnected() override;
+
+private:
+    Health healthObj;
+    dcgmGpuGrp_t groupId;
+    bool m_json;
+};
+
 #endif /* HEALTH_H_ */
@@ -13,8 +13,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -22,8 +24,10 @@
 #include "CommandLineParser.h"
 #include "DcgmLogging.h"
 #include "Introspect.h"
+#include "Module.h"
 #include "dcgm_agent.h"
 #include "dcgm_structs.h"
+#include "dcgm_test_apis.h"
 
 static char const INTROSPECT_HEADER[]
     = "+----------------------------------------------------------------------------+\n"
@@ -94,6 +98,52 @@ dcgmReturn_t Introspect::DisableIntrospect(dcgmHandle_t handle)
     return result;
 }
 
+dcgmReturn_t Introspect::TraceControl(dcgmHandle_t handle, unsigned int action)
+{
+    dcgmTraceControl_t traceControl {};
+    traceControl.version = dcgmTraceControl_version;
+    traceControl.action  = action;
+
+    dcgmReturn_t result = dcgmTraceControl(handle, &traceControl);
+    if (DCGM_ST_UNINITIALIZED == result)
+    {
+        std::cout << "Error: tracing has not been started. Run dcgmi introspect --trace start first." << std::endl;
+        return result;
+    }
+    else if (DCGM_ST_OK != result)
+    {
+        std::cout << "Error: failed to control tracing. Return: " << errorString(result) << "." << std::endl;
+        PRINT_ERROR("%s", "failed to control tracing. Return: %s", errorString(result));
+        return result;
+    }
+
+    switch (action)
+    {
+        case DCGM_TRACE_ACTION_START:
+            std::cout << "Tracing started with room for " << traceControl.numSpans << " spans" << std::endl;
+            break;
+        case DCGM_TRACE_ACTION_STOP:
+            std::cout << "Tracing stopped" << std::endl;
+            break;
+        case DCGM_TRACE_ACTION_MUTEX_PROFILE_START:
+            std::cout << "Mutex profiling started" << std::endl;
+            break;
+        case DCGM_TRACE_ACTION_MUTEX_PROFILE_STOP:
+            std::cout << "Mutex profiling stopped" << std::endl;
+            break;
+        case DCGM_TRACE_ACTION_MUTEX_PROFILE_DUMP:
+            std::cout << "Mutex profile written to " << traceControl.filename << " on the hostengine's host"
+                      << std::endl;
+            break;
+        default:
+            std::cout << "Trace written to " << traceControl.filename << " on the hostengine's host. "
+                      << "Open it with chrome://tracing or https://ui.perfetto.dev" << std::endl;
+            break;
+    }
+
+    return result;
+}
+
 dcgmReturn_t Introspect::DisplayStats(dcgmHandle_t handle,
                                       bool forHostengine,
                                       bool forAllFields,
@@ -109,6 +159,10 @@ dcgmReturn_t Introspect::DisplayStats(dcgmHandle_t handle,
     dcgmIntrospectCpuUtil_t heCpuInfo;
     heCpuInfo.version = dcgmIntrospectCpuUtil_version1;
 
+    dcgmReturn_t heThreadCpuReturn = DCGM_ST_GENERIC_ERROR;
+    auto heThreadCpuInfo           = std::make_unique<dcgmIntrospectThreadCpuUtil_t>();
+    heThreadCpuInfo->version       = dcgmIntrospectThreadCpuUtil_version1;
+
     // all fields stats
     dcgmReturn_t afMemReturn = DCGM_ST_GENERIC_ERROR;
     dcgmIntrospectFullMemory_t afMemInfo;
@@ -116,7 +170,7 @@ dcgmReturn_t Introspect::DisplayStats(dcgmHandle_t handle,
 
     dcgmReturn_t afExecReturn = DCGM_ST_GENERIC_ERROR;
     dcgmIntrospectFullFieldsExecTime_t afExecInfo;
-    afExecInfo.version = dcgmIntrospectFullFieldsExecTime_version2;
+    afExecInfo.version = dcgmIntrospectFullFieldsExecTime_version;
 
     dcgmAllFieldGroup_t allFieldGroup;
     memset(&allFieldGroup, 0, sizeof(allFieldGroup));
@@ -158,7 +212,7 @@ dcgmReturn_t Introspect::DisplayStats(dcgmHandle_t handle,
     std::vector<dcgmIntrospectFullFieldsExecTime_t> fgExecInfos(forFieldGroups.size());
     for (auto &fgExecInfo : fgExecInfos)
     {
-        fgExecInfo.version = dcgmIntrospectFullFieldsExecTime_version2;
+        fgExecInfo.version = dcgmIntrospectFullFieldsExecTime_version;
     }
 
     // always retrieve hostengine mem usage as a way to check if introspection is enabled
@@ -180,6 +234,13 @@ dcgmReturn_t Introspect::DisplayStats(dcgmHandle_t handle,
         {
             PRINT_ERROR("%s", "Error retrieving CPU utilization for hostengine. Return: %s", errorString(heCpuReturn));
         }
+
+        heThreadCpuReturn = dcgmIntrospectGetHostengineThreadCpuUtilization(handle, heThreadCpuInfo.get(), true);
+        if (DCGM_ST_OK != heThreadCpuReturn)
+        {
+            DCGM_LOG_ERROR << "Error retrieving per-thread CPU utilization for hostengine. Return: "
+                           << errorString(heThreadCpuReturn);
+        }
     }
 
     if (forAllFields)
@@ -271,6 +332,21 @@ dcgmReturn_t Introspect::DisplayStats(dcgmHandle_t handle,
         }
         cmdView.display();
 
+        // CPU util of each thread that used any. Threads come busiest first
+        if (DCGM_ST_OK == heThreadCpuReturn)
+        {
+            for (unsigned int i = 0; i < heThreadCpuInfo->numThreads && heThreadCpuInfo->threads[i].total > 0; i++)
+            {
+                dcgmIntrospectThreadCpuUtilEntry_t const &thread = heThreadCpuInfo->threads[i];
+
+                std::stringstream ss;
+                ss << readablePercent(thread.total) << " (tid " << thread.tid << ")";
+                cmdView.addDisplayParameter(ATTRIBUTE_TAG, std::string("  ") + thread.name);
+                cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, ss.str());
+                cmdView.display();
+            }
+        }
+
         cmdView.setDisplayStencil(INTROSPECT_TARGET_SEPARATOR);
         cmdView.display();
     }
@@ -317,6 +393,9 @@ dcgmReturn_t Introspect::DisplayStats(dcgmHandle_t handle,
                 cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, ERROR_STRING);
             }
             cmdView.display();
+
+            displayExecTimeDistribution(cmdView, afExecReturn, afExecInfo.aggregateInfo);
+            displaySampleLagDistribution(cmdView, afExecReturn, afExecInfo.aggregateInfo);
         }
 
         cmdView.setDisplayStencil(INTROSPECT_TARGET_SEPARATOR);
@@ -397,6 +476,9 @@ dcgmReturn_t Introspect::DisplayStats(dcgmHandle_t handle,
                 cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, ERROR_STRING);
             }
             cmdView.display();
+
+            displayExecTimeDistribution(cmdView, fgExecReturn, fcExecInfo.aggregateInfo);
+            displaySampleLagDistribution(cmdView, fgExecReturn, fcExecInfo.aggregateInfo);
         }
 
         cmdView.setDisplayStencil(INTROSPECT_TARGET_SEPARATOR);
@@ -428,6 +510,435 @@ string Introspect::readablePercent(double p)
     return ss.str();
 }
 
+dcgmReturn_t Introspect::DisplayRequestStats(dcgmHandle_t handle, bool perConnection)
+{
+    auto requestStats     = std::make_unique<dcgmIntrospectRequestStats_t>();
+    requestStats->version = dcgmIntrospectRequestStats_version;
+    requestStats->flags   = perConnection ? DCGM_INTROSPECT_REQUEST_STATS_PER_CONNECTION : 0;
+
+    dcgmReturn_t result = dcgmIntrospectGetRequestStats(handle, requestStats.get());
+    if (DCGM_ST_OK != result)
+    {
+        std::cout << "Error: failed to get request stats. Return: " << errorString(result) << "." << std::endl;
+        PRINT_ERROR("%s", "failed to get request stats. Return: %s", errorString(result));
+        return result;
+    }
+
+    CommandOutputController cmdView = CommandOutputController();
+    std::cout << INTROSPECT_HEADER;
+
+    for (unsigned int i = 0; i < requestStats->numEntries; i++)
+    {
+        dcgmIntrospectRequestTypeStats_t const &entry = requestStats->entries[i];
+
+        std::stringstream name;
+        if (entry.moduleId == DCGM_INTROSPECT_REQUEST_PROTOBUF)
+        {
+            name << "Protobuf command " << entry.command;
+        }
+        else
+        {
+            std::string moduleName;
+            if (Module::moduleIdToName((dcgmModuleId_t)entry.moduleId, moduleName) != DCGM_ST_OK)
+            {
+                moduleName = "Module " + std::to_string(entry.moduleId);
+            }
+            name << moduleName << " command " << entry.command;
+        }
+        if (perConnection)
+        {
+            name << " (connection " << entry.connectionId << ")";
+        }
+
+        cmdView.setDisplayStencil(INTROSPECT_SUB_TARGET_HEADER);
+        cmdView.addDisplayParameter(TARGET_TAG, name.str());
+        cmdView.display();
+
+        cmdView.setDisplayStencil(INTROSPECT_ATTRIBUTE_DATA);
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Requests");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, (long long)entry.count);
+        cmdView.display();
+
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Errors");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, (long long)entry.errorCount);
+        cmdView.display();
+
+        unsigned long long count = std::max(entry.count, 1ULL);
+
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Queue Wait");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG,
+                                    "avg " + readableTime(entry.totalQueueWaitUsec / (double)count) + ", max "
+                                        + readableTime(entry.maxQueueWaitUsec));
+        cmdView.display();
+
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Processing Time");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG,
+                                    "avg " + readableTime(entry.totalProcessUsec / (double)count) + ", max "
+                                        + readableTime(entry.maxProcessUsec));
+        cmdView.display();
+
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Reply Size");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG,
+                                    "avg " + readableMemory(entry.totalReplyBytes / count) + ", max "
+                                        + readableMemory(entry.maxReplyBytes));
+        cmdView.display();
+
+        std::cout << INTROSPECT_TARGET_SEPARATOR;
+    }
+
+    if (requestStats->numEntries == 0)
+    {
+        std::cout << "No requests have been recorded." << std::endl;
+    }
+    else if (requestStats->moreEntries)
+    {
+        std::cout << "Only the " << requestStats->numEntries << " busiest request types are shown." << std::endl;
+    }
+
+    return result;
+}
+
+static std::string helperWatcherName(dcgmIntrospectWatcherMemory_t const &watcher)
+{
+    switch (watcher.watcherType)
+    {
+        case DcgmWatcherTypeClient:
+            if (watcher.connectionId == DCGM_CONNECTION_ID_NONE)
+            {
+                return "Embedded client";
+            }
+            return "Client (connection " + std::to_string(watcher.connectionId) + ")";
+        case DcgmWatcherTypeHostEngine:
+            return "Hostengine";
+        case DcgmWatcherTypeHealthWatch:
+            return "Health";
+        case DcgmWatcherTypePolicyManager:
+            return "Policy";
+        case DcgmWatcherTypeCacheManager:
+            return "Cache manager";
+        case DcgmWatcherTypeConfigManager:
+            return "Config";
+        case DcgmWatcherTypeNvSwitchManager:
+            return "NvSwitch";
+        case DcgmWatcherTypeFvStream:
+            return "Field value stream (connection " + std::to_string(watcher.connectionId) + ")";
+        case DcgmWatcherTypeJobStats:
+            return "Job stats";
+        case DcgmWatcherTypeMetricsExporter:
+            return "Metrics endpoint";
+        case DcgmWatcherTypeOtlpExporter:
+            return "OTLP exporter";
+        case DcgmWatcherTypeLatestValueBoard:
+            return "Latest value board";
+        case DcgmWatcherTypeDiagResultCache:
+            return "Diag result reuse";
+        default:
+            return "Watcher type " + std::to_string(watcher.watcherType);
+    }
+}
+
+dcgmReturn_t Introspect::DisplayMemoryAccounting(dcgmHandle_t handle)
+{
+    dcgmIntrospectMemoryAccounting_t accounting {};
+    accounting.version = dcgmIntrospectMemoryAccounting_version;
+
+    dcgmReturn_t result = dcgmIntrospectGetMemoryAccounting(handle, &accounting);
+    if (DCGM_ST_OK != result)
+    {
+        std::cout << "Error: failed to get memory accounting. Return: " << errorString(result) << "." << std::endl;
+        DCGM_LOG_ERROR << "failed to get memory accounting. Return: " << errorString(result);
+        return result;
+    }
+
+    static char const *const tagNames[DCGM_INTROSPECT_MEM_TAG_COUNT]
+        = { "Cache", "IPC Send Queues", "IPC Buffer Pool", "Protobuf", "Module Requests", "Cache Arenas" };
+
+    CommandOutputController cmdView = CommandOutputController();
+    std::cout << INTROSPECT_HEADER;
+
+    auto displayUsage = [&](std::string const &name, dcgmIntrospectMemoryTag_t const &usage) {
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, name);
+        if (usage.maxBytesUsed > usage.bytesUsed)
+        {
+            cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG,
+                                        readableMemory(usage.bytesUsed) + ", max "
+                                            + readableMemory(usage.maxBytesUsed));
+        }
+        else
+        {
+            cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, readableMemory(usage.bytesUsed));
+        }
+        cmdView.display();
+    };
+
+    cmdView.setDisplayStencil(INTROSPECT_TARGET_HEADER);
+    cmdView.addDisplayParameter(TARGET_TAG, "Subsystems");
+    cmdView.display();
+
+    cmdView.setDisplayStencil(INTROSPECT_ATTRIBUTE_DATA);
+    for (unsigned int tag = 0; tag < std::min<unsigned int>(accounting.numTags, DCGM_INTROSPECT_MEM_TAG_COUNT); tag++)
+    {
+        displayUsage(tagNames[tag], accounting.tags[tag]);
+    }
+    std::cout << INTROSPECT_TARGET_SEPARATOR;
+
+    cmdView.setDisplayStencil(INTROSPECT_TARGET_HEADER);
+    cmdView.addDisplayParameter(TARGET_TAG, "Module Requests");
+    cmdView.display();
+
+    cmdView.setDisplayStencil(INTROSPECT_ATTRIBUTE_DATA);
+    for (unsigned int moduleId = 0; moduleId < DcgmModuleIdCount; moduleId++)
+    {
+        if (accounting.modules[moduleId].maxBytesUsed == 0)
+        {
+            continue;
+        }
+
+        std::string moduleName;
+        if (Module::moduleIdToName((dcgmModuleId_t)moduleId, moduleName) != DCGM_ST_OK)
+        {
+            moduleName = "Module " + std::to_string(moduleId);
+        }
+        displayUsage(moduleName, accounting.modules[moduleId]);
+    }
+    std::cout << INTROSPECT_TARGET_SEPARATOR;
+
+    for (unsigned int i = 0; i < accounting.numWatchers; i++)
+    {
+        dcgmIntrospectWatcherMemory_t const &watcher = accounting.watchers[i];
+
+        cmdView.setDisplayStencil(INTROSPECT_SUB_TARGET_HEADER);
+        cmdView.addDisplayParameter(TARGET_TAG, helperWatcherName(watcher));
+        cmdView.display();
+
+        cmdView.setDisplayStencil(INTROSPECT_ATTRIBUTE_DATA);
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Cache");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, readableMemory(watcher.cacheBytes));
+        cmdView.display();
+
+        if (watcher.connectionId != DCGM_CONNECTION_ID_NONE)
+        {
+            cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Send Queue");
+            cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, readableMemory(watcher.sendQueueBytes));
+            cmdView.display();
+        }
+
+        std::cout << INTROSPECT_TARGET_SEPARATOR;
+    }
+
+    if (accounting.moreWatchers)
+    {
+        std::cout << "Only the " << accounting.numWatchers << " watchers with the most memory are shown." << std::endl;
+    }
+
+    return result;
+}
+
+dcgmReturn_t Introspect::DisplayWatchCost(dcgmHandle_t handle,
+                                          dcgmGpuGrp_t groupId,
+                                          dcgmFieldGrp_t fieldGroupId,
+                                          long long updateFreqUsec,
+                                          double maxKeepAge,
+                                          int maxKeepSamples)
+{
+    auto cost            = std::make_unique<dcgmIntrospectWatchCost_t>();
+    cost->version        = dcgmIntrospectWatchCost_version;
+    cost->groupId        = (unsigned int)(uintptr_t)groupId;
+    cost->fieldGroupId   = (unsigned int)(uintptr_t)fieldGroupId;
+    cost->updateFreq     = updateFreqUsec;
+    cost->maxKeepAge     = maxKeepAge;
+    cost->maxKeepSamples = maxKeepSamples;
+
+    dcgmReturn_t result = dcgmIntrospectEstimateWatchCost(handle, cost.get());
+    if (DCGM_ST_OK != result)
+    {
+        std::cout << "Error: failed to estimate the watch cost. Return: " << errorString(result) << "." << std::endl;
+        DCGM_LOG_ERROR << "failed to estimate the watch cost. Return: " << errorString(result);
+        return result;
+    }
+
+    static char const *const fetchMethodNames[] = { "Own Driver Call", "Batched Field Value", "Shared Getter",
+                                                    "Entity Collector" };
+
+    auto perSecond = [](double value, int precision) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(precision) << value << "/s";
+        return ss.str();
+    };
+    auto cpuTime = [&](double usecPerSec) {
+        return readableTime(usecPerSec) + "/s (" + readablePercent(usecPerSec / 1000000.0) + " of a CPU)";
+    };
+
+    CommandOutputController cmdView = CommandOutputController();
+    std::cout << INTROSPECT_HEADER;
+
+    auto displayTotals = [&](std::string const &target, double cpuUsec, double driverCalls, long long cacheBytes) {
+        cmdView.setDisplayStencil(INTROSPECT_TARGET_HEADER);
+        cmdView.addDisplayParameter(TARGET_TAG, target);
+        cmdView.display();
+
+        cmdView.setDisplayStencil(INTROSPECT_ATTRIBUTE_DATA);
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "CPU Time");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, cpuTime(cpuUsec));
+        cmdView.display();
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Driver Calls");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, perSecond(driverCalls, 2));
+        cmdView.display();
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Cache Memory");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, readableMemory(cacheBytes));
+        cmdView.display();
+        std::cout << INTROSPECT_TARGET_SEPARATOR;
+    };
+
+    displayTotals("Watch Cost", cost->cpuUsecPerSec, cost->driverCallsPerSec, cost->cacheBytes);
+    displayTotals("Added To Active Watches",
+                  cost->marginalCpuUsecPerSec,
+                  cost->marginalDriverCallsPerSec,
+                  cost->marginalCacheBytes);
+
+    cmdView.setDisplayStencil(INTROSPECT_TARGET_HEADER);
+    cmdView.addDisplayParameter(TARGET_TAG, "Fields");
+    cmdView.display();
+
+    for (unsigned int i = 0; i < std::min<unsigned int>(cost->numFields, DCGM_INTROSPECT_WATCH_COST_MAX_FIELDS); i++)
+    {
+        dcgmIntrospectFieldCost_t const &fieldCost = cost->fields[i];
+        dcgm_field_meta_p fieldMeta                = DcgmFieldGetById(fieldCost.fieldId);
+
+        std::stringstream target;
+        target << fieldCost.fieldId << " " << (fieldMeta ? fieldMeta->tag : "unknown") << " on "
+               << fieldCost.numEntities << " entities, " << fieldCost.numWatched << " watched";
+
+        cmdView.setDisplayStencil(INTROSPECT_SUB_TARGET_HEADER);
+        cmdView.addDisplayParameter(TARGET_TAG, target.str());
+        cmdView.display();
+
+        cmdView.setDisplayStencil(INTROSPECT_ATTRIBUTE_DATA);
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Fetched With");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG,
+                                    fieldCost.fetchMethod < DCGM_ARRAY_CAPACITY(fetchMethodNames)
+                                        ? fetchMethodNames[fieldCost.fetchMethod]
+                                        : "Unknown");
+        cmdView.display();
+
+        std::stringstream execTime;
+        execTime << readableTime(fieldCost.execUsecPerFetch) << ", measured on " << fieldCost.numMeasured << " of "
+                 << fieldCost.numEntities;
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Time Per Fetch");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, execTime.str());
+        cmdView.display();
+
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "CPU Time");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG,
+                                    readableTime(fieldCost.cpuUsecPerSec) + "/s, adds "
+                                        + readableTime(fieldCost.marginalCpuUsecPerSec) + "/s");
+        cmdView.display();
+
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Driver Calls");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG,
+                                    perSecond(fieldCost.driverCallsPerSec, 2) + ", adds "
+                                        + perSecond(fieldCost.marginalDriverCallsPerSec, 2));
+        cmdView.display();
+
+        std::stringstream cacheMemory;
+        cacheMemory << readableMemory(fieldCost.cacheBytes) << ", adds " << readableMemory(fieldCost.marginalCacheBytes)
+                    << " (" << fieldCost.samplesKept << " x " << fieldCost.bytesPerSample << " B)";
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Cache Memory");
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, cacheMemory.str());
+        cmdView.display();
+
+        std::cout << INTROSPECT_TARGET_SEPARATOR;
+    }
+
+    return result;
+}
+
+void Introspect::displayExecTimeDistribution(CommandOutputController &cmdView,
+                                             dcgmReturn_t execReturn,
+                                             dcgmIntrospectFieldsExecTime_t const &execTime)
+{
+    cmdView.setDisplayStencil(INTROSPECT_ATTRIBUTE_DATA);
+    cmdView.addDisplayParameter(ATTRIBUTE_TAG, "Max Update Time");
+
+    if (DCGM_ST_OK != execReturn)
+    {
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, ERROR_STRING);
+        cmdView.display();
+        return;
+    }
+
+    cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, readableTime(execTime.maxUpdateUsec));
+    cmdView.display();
+
+    displayUsecHistogram(cmdView, "Updates Taking", execTime.updateUsecHistogram);
+}
+
+void Introspect::displaySampleLagDistribution(CommandOutputController &cmdView,
+                                              dcgmReturn_t execReturn,
+                                              dcgmIntrospectFieldsExecTime_t const &execTime)
+{
+    static char const *const stageNames[DCGM_INTROSPECT_LAG_STAGE_COUNT]
+        = { "Cache Insert", "Subscriber Dispatch", "Client Send" };
+
+    if (DCGM_ST_OK != execReturn)
+    {
+        return;
+    }
+
+    for (int stage = 0; stage < DCGM_INTROSPECT_LAG_STAGE_COUNT; stage++)
+    {
+        long long const *histogram = execTime.sampleLagUsecHistogram[stage];
+        if (std::all_of(histogram, histogram + DCGM_INTROSPECT_EXEC_TIME_BUCKETS, [](long long n) { return n == 0; }))
+        {
+            /* No sample got this far. Ex: nothing subscribes to these fields */
+            continue;
+        }
+
+        cmdView.setDisplayStencil(INTROSPECT_ATTRIBUTE_DATA);
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, std::string("Max Sample Age at ") + stageNames[stage]);
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, readableTime(execTime.maxSampleLagUsec[stage]));
+        cmdView.display();
+
+        displayUsecHistogram(cmdView, std::string("Samples at ") + stageNames[stage] + " Aged", histogram);
+    }
+}
+
+void Introspect::displayUsecHistogram(CommandOutputController &cmdView,
+                                      std::string const &title,
+                                      long long const histogram[DCGM_INTROSPECT_EXEC_TIME_BUCKETS])
+{
+    /* One row per non-empty bucket, labeled by its lower bound */
+    cmdView.addDisplayParameter(ATTRIBUTE_TAG, title);
+    cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, "");
+    cmdView.display();
+
+    for (int i = 0; i < DCGM_INTROSPECT_EXEC_TIME_BUCKETS; i++)
+    {
+        if (histogram[i] == 0)
+        {
+            continue;
+        }
+
+        std::stringstream label;
+        if (i == 0)
+        {
+            label << "  < 2 us";
+        }
+        else if (i < 10)
+        {
+            label << "  >= " << (1LL << i) << " us";
+        }
+        else
+        {
+            label << "  >= " << readableTime(1LL << i);
+        }
+
+        cmdView.addDisplayParameter(ATTRIBUTE_TAG, label.str());
+        cmdView.addDisplayParameter(ATTRIBUTE_DATA_TAG, histogram[i]);
+        cmdView.display();
+    }
+}
+
 ToggleIntrospect::ToggleIntrospect(std::string hostname, bool enabled)
     : Command()
     , enabled(enabled)
@@ -443,6 +954,21 @@ dcgmReturn_t ToggleIntrospect::DoExecuteConnected()
     return enabled ? introspectObj.EnableIntrospect(m_dcgmHandle) : introspectObj.DisableIntrospect(m_dcgmHandle);
 }
 
+TraceIntrospect::TraceIntrospect(std::string hostname, unsigned int action)
+    : Command()
+    , action(action)
+{
+    m_hostName = std::move(hostname);
+
+    /* Tracing should keep running once this DCGMI instance exits */
+    SetPersistAfterDisconnect(1);
+}
+
+dcgmReturn_t TraceIntrospect::DoExecuteConnected()
+{
+    return introspectObj.TraceControl(m_dcgmHandle, action);
+}
+
 DisplayIntrospectSummary::DisplayIntrospectSummary(std::string hostname,
                                                    bool forHostengine,
                                                    bool forAllFields,
@@ -464,3 +990,48 @@ dcgmReturn_t DisplayIntrospectSummary::DoExecuteConnected()
 {
     return introspectObj.DisplayStats(m_dcgmHandle, forHostengine, forAllFields, forAllFieldGroups, forFieldGroups);
 }
+
+DisplayIntrospectRequests::DisplayIntrospectRequests(std::string hostname, bool perConnection)
+    : Command()
+    , perConnection(perConnection)
+{
+    m_hostName = std::move(hostname);
+}
+
+dcgmReturn_t DisplayIntrospectRequests::DoExecuteConnected()
+{
+    return introspectObj.DisplayRequestStats(m_dcgmHandle, perConnection);
+}
+
+DisplayIntrospectMemory::DisplayIntrospectMemory(std::string hostname)
+    : Command()
+{
+    m_hostName = std::move(hostname);
+}
+
+dcgmReturn_t DisplayIntrospectMemory::DoExecuteConnected()
+{
+    return introspectObj.DisplayMemoryAccounting(m_dcgmHandle);
+}
+
+DisplayIntrospectWatchCost::DisplayIntrospectWatchCost(std::string hostname,
+                                                       unsigned int groupId,
+                                                       dcgmFieldGrp_t fieldGroupId,
+                                                       int updateIntervalMs,
+                                                       double maxKeepAge,
+                                                       int maxKeepSamples)
+    : Command()
+    , groupId((dcgmGpuGrp_t)(uintptr_t)groupId)
+    , fieldGroupId(fieldGroupId)
+    , updateFreqUsec((long long)updateIntervalMs * 1000)
+    , maxKeepAge(maxKeepAge)
+    , maxKeepSamples(maxKeepSamples)
+{
+    m_hostName = std::move(hostname);
+}
+
+dcgmReturn_t DisplayIntrospectWatchCost::DoExecuteConnected()
+{
+    return introspectObj.DisplayWatchCost(
+        m_dcgmHandle, groupId, fieldGroupId, updateFreqUsec, maxKeepAge, maxKeepSamples);
+}
@@ -34,11 +34,20 @@ public:
 
     dcgmReturn_t EnableIntrospect(dcgmHandle_t handle);
     dcgmReturn_t DisableIntrospect(dcgmHandle_t handle);
+    dcgmReturn_t TraceControl(dcgmHandle_t handle, unsigned int action);
     dcgmReturn_t DisplayStats(dcgmHandle_t handle,
                               bool forHostengine,
                               bool forAllFields,
                               bool forAllFieldGroups,
                               std::vector<dcgmFieldGrp_t> forFieldGroups);
+    dcgmReturn_t DisplayRequestStats(dcgmHandle_t handle, bool perConnection);
+    dcgmReturn_t DisplayMemoryAccounting(dcgmHandle_t handle);
+    dcgmReturn_t DisplayWatchCost(dcgmHandle_t handle,
+                                  dcgmGpuGrp_t groupId,
+                                  dcgmFieldGrp_t fieldGroupId,
+                                  long long updateFreqUsec,
+                                  double maxKeepAge,
+                                  int maxKeepSamples);
 
 private:
     string readableMemory(long long bytes);
@@ -46,6 +55,18 @@ private:
 
     template <typename T>
     string readableTime(T usec);
+
+    void displayExecTimeDistribution(CommandOutputController &cmdView,
+                                     dcgmReturn_t execReturn,
+                                     dcgmIntrospectFieldsExecTime_t const &execTime);
+
+    void displaySampleLagDistribution(CommandOutputController &cmdView,
+                                      dcgmReturn_t execReturn,
+                                      dcgmIntrospectFieldsExecTime_t const &execTime);
+
+    void displayUsecHistogram(CommandOutputController &cmdView,
+                              std::string const &title,
+                              long long const histogram[DCGM_INTROSPECT_EXEC_TIME_BUCKETS]);
 };
 
 /**
@@ -64,6 +85,22 @@ private:
     bool enabled;
 };
 
+/**
+ * Start, stop or dump the hostengine's update-loop trace or mutex profile
+ */
+class TraceIntrospect : public Command
+{
+public:
+    TraceIntrospect(string hostname, unsigned int action);
+
+protected:
+    dcgmReturn_t DoExecuteConnected() override;
+
+private:
+    Introspect introspectObj;
+    unsigned int action; /* DCGM_TRACE_ACTION_* */
+};
+
 /**
  * Display a summary of introspection information
  */
@@ -87,5 +124,61 @@ private:
     std::vector<dcgmFieldGrp_t> forFieldGroups;
 };
 
+/**
+ * Display the counts and latencies of the requests clients sent the hostengine
+ */
+class DisplayIntrospectRequests : public Command
+{
+public:
+    DisplayIntrospectRequests(string hostname, bool perConnection);
+
+protected:
+    dcgmReturn_t DoExecuteConnected() override;
+
+private:
+    Introspect introspectObj;
+    bool perConnection;
+};
+
+/**
+ * Display the memory of the hostengine by the subsystem, module and watcher it is charged to
+ */
+class DisplayIntrospectMemory : public Command
+{
+public:
+    explicit DisplayIntrospectMemory(string hostname);
+
+protected:
+    dcgmReturn_t DoExecuteConnected() override;
+
+private:
+    Introspect introspectObj;
+};
+
+/**
+ * Display the predicted cost of watching a field group on a group
+ */
+class DisplayIntrospectWatchCost : public Command
+{
+public:
+    DisplayIntrospectWatchCost(string hostname,
+                               unsigned int groupId,
+                               dcgmFieldGrp_t fieldGroupId,
+                               int updateIntervalMs,
+                               double maxKeepAge,
+                               int maxKeepSamples);
+
+protected:
+    dcgmReturn_t DoExecuteConnected() override;
+
+private:
+    Introspect introspectObj;
+    dcgmGpuGrp_t groupId;
+    dcgmFieldGrp_t fieldGroupId;
+    long long updateFreqUsec;
+    double maxKeepAge;
+    int maxKeepSamples;
+};
+
 
 #endif /* INTROSPECT_H_ */
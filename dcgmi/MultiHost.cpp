@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * File:   MultiHost.cpp
+ */
+
+#include "MultiHost.h"
+#include "dcgm_agent.h"
+#include "dcgmi_common.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+
+/*****************************************************************************/
+std::vector<std::string> ParseHostList(std::string const &hostList)
+{
+    std::vector<std::string> hostNames;
+    std::string hostName;
+    bool inComment = false;
+
+    auto endHostName = [&hostNames, &hostName]() {
+        if (!hostName.empty() && std::find(hostNames.begin(), hostNames.end(), hostName) == hostNames.end())
+        {
+            hostNames.push_back(hostName);
+        }
+        hostName.clear();
+    };
+
+    for (char const c : hostList)
+    {
+        if (c == '\n')
+        {
+            inComment = false;
+            endHostName();
+        }
+        else if (inComment)
+        {
+            continue;
+        }
+        else if (c == '#')
+        {
+            inComment = true;
+            endHostName();
+        }
+        else if (c == ',' || isspace(static_cast<unsigned char>(c)))
+        {
+            endHostName();
+        }
+        else
+        {
+            hostName += c;
+        }
+    }
+
+    endHostName();
+    return hostNames;
+}
+
+/*****************************************************************************/
+void *AsyncRequestSet::Add(dcgmReturn_t *status)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_requests.push_back(Request { this, status });
+    m_pending++;
+    return &m_requests.back();
+}
+
+/*****************************************************************************/
+void AsyncRequestSet::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_cv.wait(lock, [this] { return m_pending == 0; });
+}
+
+/*****************************************************************************/
+void AsyncRequestSet::Complete(dcgmReturn_t status, void *userData)
+{
+    auto *request         = static_cast<Request *>(userData);
+    AsyncRequestSet &self = *request->m_requestSet;
+
+    std::lock_guard<std::mutex> lock(self.m_mutex);
+
+    *request->m_status = status;
+    self.m_pending--;
+    self.m_cv.notify_all();
+}
+
+/*****************************************************************************/
+MultiHostCommand::MultiHostCommand(std::vector<std::string> hostNames)
+{
+    m_hosts.resize(hostNames.size());
+
+    for (size_t i = 0; i < hostNames.size(); i++)
+    {
+        m_hosts[i].m_hostName = std::move(hostNames[i]);
+    }
+}
+
+/*****************************************************************************/
+MultiHostCommand::~MultiHostCommand()
+{
+    for (auto &host : m_hosts)
+    {
+        if (host.m_dcgmHandle)
+        {
+            dcgmDisconnect(host.m_dcgmHandle);
+            host.m_dcgmHandle = 0;
+        }
+    }
+}
+
+/*****************************************************************************/
+void MultiHostCommand::SetPersistAfterDisconnect(unsigned int persistAfterDisconnect)
+{
+    m_persistAfterDisconnect = persistAfterDisconnect;
+}
+
+/*****************************************************************************/
+void MultiHostCommand::ConnectHost(Host &host)
+{
+    dcgmConnectV2Params_t connectParams;
+    bool isUnixSocketAddress = false;
+
+    const char *hostNameStr = dcgmi_parse_hostname_string(host.m_hostName.c_str(), &isUnixSocketAddress, false);
+    if (!hostNameStr)
+    {
+        host.m_status = DCGM_ST_BADPARAM;
+        host.m_error  = "Missing hostname after \"unix://\".";
+        return;
+    }
+
+    memset(&connectParams, 0, sizeof(connectParams));
+    connectParams.version                = dcgmConnectV2Params_version;
+    connectParams.persistAfterDisconnect = m_persistAfterDisconnect;
+    connectParams.addressIsUnixSocket    = isUnixSocketAddress ? 1 : 0;
+
+    dcgmReturn_t result = dcgmConnect_v2(hostNameStr, &connectParams, &host.m_dcgmHandle);
+    if (DCGM_ST_OK != result)
+    {
+        host.m_dcgmHandle = 0;
+        host.m_status     = DCGM_ST_CONNECTION_NOT_VALID;
+        host.m_error      = std::string("Unable to connect to host engine. ") + errorString(result) + ".";
+        return;
+    }
+
+    DoPrepareHost(host);
+}
+
+/*****************************************************************************/
+dcgmReturn_t MultiHostCommand::Execute()
+{
+    dcgmReturn_t result = dcgmInit();
+    if (DCGM_ST_OK != result)
+    {
+        std::cout << "Error: unable to initialize DCGM" << std::endl;
+        return result;
+    }
+
+    /* dcgmConnect_v2 blocks until the host engine answers, so connect to each host on its own thread */
+    std::vector<std::thread> connectThreads;
+    connectThreads.reserve(m_hosts.size());
+
+    for (auto &host : m_hosts)
+    {
+        connectThreads.emplace_back([this, &host] { ConnectHost(host); });
+    }
+
+    for (auto &thread : connectThreads)
+    {
+        thread.join();
+    }
+
+    DoExecuteConnected();
+
+    for (auto const &host : m_hosts)
+    {
+        if (host.m_status != DCGM_ST_OK)
+        {
+            return host.m_status;
+        }
+    }
+
+    return DCGM_ST_OK;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * File:   MultiHost.h
+ */
+
+#ifndef MULTIHOST_H
+#define MULTIHOST_H
+
+#include "dcgm_structs.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+/*****************************************************************************
+ * Split a list of hosts separated by commas, whitespace or newlines into the
+ * host names. Text after a '#' up to the end of the line is ignored, so that
+ * a host file can have comments. Duplicates are removed, keeping the order.
+ *****************************************************************************/
+std::vector<std::string> ParseHostList(std::string const &hostList);
+
+/**
+ * Waits for the completion of asynchronous requests like dcgmHealthCheckAsync that were started
+ * with Complete as their callback.
+ */
+class AsyncRequestSet
+{
+public:
+    /*************************************************************************
+     * Add a request to wait for. Returns the userData to start it with.
+     * status is set when the request completes. If the request couldn't be
+     * started, call Complete with userData and the error instead.
+     *************************************************************************/
+    void *Add(dcgmReturn_t *status);
+
+    /*************************************************************************
+     * Wait until every request added has completed
+     *************************************************************************/
+    void Wait();
+
+    /*************************************************************************
+     * dcgmRequestComplete_f of the requests
+     *************************************************************************/
+    static void Complete(dcgmReturn_t status, void *userData);
+
+private:
+    struct Request
+    {
+        AsyncRequestSet *m_requestSet;
+        dcgmReturn_t *m_status;
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Request> m_requests; /*!< A deque, so that the userData handed out stays valid */
+    unsigned int m_pending {};
+};
+
+/**
+ * Base class of the commands that run against several host engines at once. Execute connects
+ * to all of them concurrently, then DoExecuteConnected issues the requests of the command to
+ * every connected host through the async client API and merges the results into one
+ * host-tagged output.
+ */
+class MultiHostCommand
+{
+public:
+    explicit MultiHostCommand(std::vector<std::string> hostNames);
+
+    virtual ~MultiHostCommand();
+
+    /*****************************************************************************
+     * persistAfterDisconnect: Should the host engines persist the watches created
+     *                         by this connection after the connection goes away?
+     *                         1=yes. 0=no (default).
+     *****************************************************************************/
+    void SetPersistAfterDisconnect(unsigned int persistAfterDisconnect);
+
+    /*****************************************************************************
+     * Connect to the hosts and execute the command on the ones connected to.
+     * Returns the error of the first host the command failed on, if any
+     *****************************************************************************/
+    dcgmReturn_t Execute();
+
+protected:
+    struct Host
+    {
+        std::string m_hostName;
+        dcgmHandle_t m_dcgmHandle {};
+        dcgmReturn_t m_status { DCGM_ST_OK }; /*!< Result of the command on this host */
+        std::string m_error;                  /*!< What went wrong, when m_status isn't DCGM_ST_OK */
+    };
+
+    /**
+     * Called on the connecting thread of each host once it is connected, for requests that have no
+     * async version. Set host.m_status and host.m_error to skip the host.
+     */
+    virtual void DoPrepareHost(Host & /* host */)
+    {}
+
+    /**
+     * Issue the requests of the command to the hosts with m_status DCGM_ST_OK, and print the results.
+     * The hosts that failed should be reported as well.
+     */
+    virtual void DoExecuteConnected() = 0;
+
+    std::vector<Host> m_hosts;
+    unsigned int m_persistAfterDisconnect {};
+
+private:
+    void ConnectHost(Host &host);
+};
+
+#endif /* MULTIHOST_H */
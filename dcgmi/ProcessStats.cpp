@@ -23,12 +23,19 @@
 #include "ProcessStats.h"
 #include "CommandOutputController.h"
 #include "DcgmLogging.h"
+#include "DcgmiOutput.h"
 #include "dcgm_agent.h"
 #include "dcgm_structs.h"
 #include "dcgm_test_apis.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <thread>
 #include <time.h>
 
 /**************************************************************************************/
@@ -328,6 +335,70 @@ dcgmReturn_t ProcessStats::ViewJobStats(dcgmHandle_t mNvcmHandle, std::string jo
     // Display Process Info
     std::cout << "Successfully retrieved statistics for job: " << jobId << ". \n";
 
+    DisplayJobStats(jobInfo, verbose);
+
+    return result;
+}
+
+/* Set by the signal handler on ctrl-c to stop WatchJobStats() */
+static std::atomic<bool> jobWatchShouldStop = false;
+
+static void jobWatchKillHandler(int sig)
+{
+    signal(sig, SIG_IGN);
+    jobWatchShouldStop = true;
+}
+
+/***************************************************************************************/
+dcgmReturn_t ProcessStats::WatchJobStats(dcgmHandle_t mNvcmHandle, std::string jobId, bool verbose, int intervalMs)
+{
+    dcgmJobInfo_t jobInfo;
+    jobInfo.version                   = dcgmJobInfo_version;
+    unsigned long long updateSequence = 0;
+
+    if (jobId.length() > 64)
+    {
+        std::cout << "Error: Unable to watch job. Return: Job ID too long." << std::endl;
+        return DCGM_ST_BADPARAM;
+    }
+
+    signal(SIGINT, &jobWatchKillHandler);
+
+    while (!jobWatchShouldStop)
+    {
+        unsigned long long lastUpdateSequence = updateSequence;
+
+        dcgmReturn_t result = dcgmJobGetStatsSince(mNvcmHandle, (char *)jobId.c_str(), &updateSequence, &jobInfo);
+        if (result != DCGM_ST_OK)
+        {
+            std::cout << "Error: Unable to retrieve job statistics. Return: " << errorString(result) << "."
+                      << std::endl;
+            DCGM_LOG_ERROR << "Error getting job stats. Return: " << result;
+            return result;
+        }
+
+        /* The host engine only sends stats again once samples were added to the job or it stopped */
+        if (updateSequence != lastUpdateSequence)
+        {
+            std::cout << "Statistics for job: " << jobId << " as of "
+                      << HelperFormatTimestamp(jobInfo.summary.endTime, false) << ". \n";
+            DisplayJobStats(jobInfo, verbose);
+        }
+
+        /* Wake up now and then to notice ctrl-c */
+        for (int waitedMs = 0; waitedMs < intervalMs && !jobWatchShouldStop; waitedMs += 100)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(100, intervalMs - waitedMs)));
+        }
+    }
+
+    std::cout << std::endl << "Stopped watching job " << jobId << " due to receiving a signal." << std::endl;
+    return DCGM_ST_OK;
+}
+
+/***************************************************************************************/
+void ProcessStats::DisplayJobStats(dcgmJobInfo_t &jobInfo, bool verbose)
+{
     if (verbose)
     {
         for (int i = 0; i < jobInfo.numGpus; i++)
@@ -350,8 +421,6 @@ dcgmReturn_t ProcessStats::ViewJobStats(dcgmHandle_t mNvcmHandle, std::string jo
         HelperDisplayOverAllHealth(&jobInfo.summary, false);
         std::cout << STATS_FOOTER << std::endl;
     }
-
-    return result;
 }
 
 
@@ -1241,11 +1310,12 @@ dcgmReturn_t RemoveAllJobs::DoExecuteConnected()
  *****************************************************************************/
 
 /*****************************************************************************/
-ViewJobStats::ViewJobStats(std::string hostname, std::string jobId, bool verbose)
+ViewJobStats::ViewJobStats(std::string hostname, std::string jobId, bool verbose, int watchIntervalMs)
 {
-    m_hostName    = hostname;
-    this->jobId   = jobId;
-    this->verbose = verbose;
+    m_hostName            = hostname;
+    this->jobId           = jobId;
+    this->verbose         = verbose;
+    this->watchIntervalMs = watchIntervalMs;
 
     /* We want group actions to persist once this DCGMI instance exits */
     SetPersistAfterDisconnect(1);
@@ -1254,5 +1324,133 @@ ViewJobStats::ViewJobStats(std::string hostname, std::string jobId, bool verbose
 /*****************************************************************************/
 dcgmReturn_t ViewJobStats::DoExecuteConnected()
 {
+    if (watchIntervalMs > 0)
+    {
+        return mProcessStatsObj.WatchJobStats(m_dcgmHandle, jobId, verbose, watchIntervalMs);
+    }
     return mProcessStatsObj.ViewJobStats(m_dcgmHandle, jobId, verbose);
 }
+
+/*****************************************************************************
+ *****************************************************************************
+ * View Job Stats Invoker for several hosts
+ *****************************************************************************
+ *****************************************************************************/
+
+/*****************************************************************************/
+ViewJobStatsMultiHost::ViewJobStatsMultiHost(std::vector<std::string> hostNames, std::string jobId, bool verbose)
+    : MultiHostCommand(std::move(hostNames))
+    , jobId(std::move(jobId))
+    , verbose(verbose)
+{
+    /* We want group actions to persist once this DCGMI instance exits */
+    SetPersistAfterDisconnect(1);
+}
+
+/*****************************************************************************/
+static std::string HelperInt64ToString(long long num)
+{
+    if (DCGM_INT64_IS_BLANK(num))
+    {
+        return "N/A";
+    }
+    return std::to_string(num);
+}
+
+/*****************************************************************************/
+void ViewJobStatsMultiHost::DoExecuteConnected()
+{
+    std::vector<std::unique_ptr<dcgmJobInfo_t>> jobInfos(m_hosts.size());
+    AsyncRequestSet requests;
+    char jobIdStr[64] = {};
+
+    if (jobId.length() >= sizeof(jobIdStr))
+    {
+        std::cout << "Error: Unable to retrieve job statistics. Return: Job ID too long." << std::endl;
+        for (auto &host : m_hosts)
+        {
+            host.m_status = DCGM_ST_BADPARAM;
+        }
+        return;
+    }
+
+    jobId.copy(jobIdStr, jobId.length());
+
+    for (size_t i = 0; i < m_hosts.size(); i++)
+    {
+        if (m_hosts[i].m_status != DCGM_ST_OK)
+        {
+            continue;
+        }
+
+        jobInfos[i]          = std::make_unique<dcgmJobInfo_t>();
+        jobInfos[i]->version = dcgmJobInfo_version;
+
+        void *userData      = requests.Add(&m_hosts[i].m_status);
+        dcgmReturn_t result = dcgmJobGetStatsAsync(
+            m_hosts[i].m_dcgmHandle, jobIdStr, jobInfos[i].get(), &AsyncRequestSet::Complete, userData);
+        if (result != DCGM_ST_OK)
+        {
+            AsyncRequestSet::Complete(result, userData);
+        }
+    }
+
+    requests.Wait();
+
+    if (verbose)
+    {
+        for (size_t i = 0; i < m_hosts.size(); i++)
+        {
+            if (m_hosts[i].m_status == DCGM_ST_OK)
+            {
+                std::cout << "Host: " << m_hosts[i].m_hostName << "\n";
+                mProcessStatsObj.DisplayJobStats(*jobInfos[i], true);
+            }
+        }
+    }
+
+    DcgmiOutputColumns out;
+    DcgmiOutputFieldSelector hostSelector   = DcgmiOutputFieldSelector().child("Host");
+    DcgmiOutputFieldSelector gpusSelector   = DcgmiOutputFieldSelector().child("GPUs");
+    DcgmiOutputFieldSelector energySelector = DcgmiOutputFieldSelector().child("Energy (J)");
+    DcgmiOutputFieldSelector xidSelector    = DcgmiOutputFieldSelector().child("XID Errors");
+    DcgmiOutputFieldSelector healthSelector = DcgmiOutputFieldSelector().child("Overall Health");
+
+    out.addColumn(24, "Host", hostSelector);
+    out.addColumn(6, "GPUs", gpusSelector);
+    out.addColumn(14, "Energy (J)", energySelector);
+    out.addColumn(12, "XID Errors", xidSelector);
+    out.addColumn(22, "Overall Health", healthSelector);
+
+    out.addHeader("Job: " + jobId);
+
+    for (size_t i = 0; i < m_hosts.size(); i++)
+    {
+        Host &host            = m_hosts[i];
+        DcgmiOutputBoxer &row = out[host.m_hostName];
+
+        row["Host"] = host.m_hostName;
+
+        if (host.m_status != DCGM_ST_OK)
+        {
+            if (host.m_error.empty())
+            {
+                host.m_error = std::string("Unable to retrieve job statistics. Return: ") + errorString(host.m_status);
+            }
+            row["Overall Health"] = "Error";
+            row["Overall Health"].addOverflow(host.m_error);
+            continue;
+        }
+
+        dcgmGpuUsageInfo_t const &summary = jobInfos[i]->summary;
+
+        row["GPUs"]           = jobInfos[i]->numGpus;
+        row["Energy (J)"]     = DCGM_INT64_IS_BLANK(summary.energyConsumed)
+                                    ? HelperInt64ToString(summary.energyConsumed)
+                                    : HelperInt64ToString(summary.energyConsumed / 1000); // 1000 mWs = 1 J
+        row["XID Errors"]     = summary.numXidCriticalErrors;
+        row["Overall Health"] = mProcessStatsObj.HelperHealthResultToString(summary.overallHealth);
+    }
+
+    std::cout << out.str();
+}
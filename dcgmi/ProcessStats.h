@@ -24,6 +24,7 @@
 #define PROCESSSTATS_H_
 
 #include "Command.h"
+#include "MultiHost.h"
 
 class ProcessStats
 {
@@ -66,6 +67,20 @@ public:
      *****************************************************************************/
     dcgmReturn_t ViewJobStats(dcgmHandle_t mNvcmHandle, std::string jobId, bool verbose);
 
+    /*****************************************************************************
+     * This method is used to display job stats on the host-engine represented by the
+     * DCGM handle again every intervalMs until interrupted. The stats are only fetched
+     * and displayed again after they changed
+     *****************************************************************************/
+    dcgmReturn_t WatchJobStats(dcgmHandle_t mNvcmHandle, std::string jobId, bool verbose, int intervalMs);
+
+    /*****************************************************************************
+     * This method is used to display job stats retrieved from a host-engine
+     *****************************************************************************/
+    void DisplayJobStats(dcgmJobInfo_t &jobInfo, bool verbose);
+
+    std::string HelperHealthResultToString(dcgmHealthWatchResults_t health);
+
     /*****************************************************************************
      * This method is used to remove job stats for a job on the host-engine represented
      * by the DCGM handle
@@ -186,8 +201,6 @@ private:
     std::string HelperPCILongToString(long long num);
 
     std::string HelperHealthSystemToString(dcgmHealthSystems_enum system);
-
-    std::string HelperHealthResultToString(dcgmHealthWatchResults_t health);
 };
 
 
@@ -314,11 +327,31 @@ private:
 class ViewJobStats : public Command
 {
 public:
-    ViewJobStats(std::string hostname, std::string jobId, bool verbose);
+    /* watchIntervalMs: Display the stats again every this many ms until interrupted. 0 = display them once */
+    ViewJobStats(std::string hostname, std::string jobId, bool verbose, int watchIntervalMs = 0);
 
 protected:
     dcgmReturn_t DoExecuteConnected() override;
 
+private:
+    ProcessStats mProcessStatsObj;
+    std::string jobId;
+    bool verbose;
+    int watchIntervalMs;
+};
+
+/**
+ * View Job Stats Invoker for several hosts at once. Prints a row per host, after the stats of
+ * each GPU of each host in verbose mode.
+ */
+class ViewJobStatsMultiHost : public MultiHostCommand
+{
+public:
+    ViewJobStatsMultiHost(std::vector<std::string> hostNames, std::string jobId, bool verbose);
+
+protected:
+    void DoExecuteConnected() override;
+
 private:
     ProcessStats mProcessStatsObj;
     std::string jobId;
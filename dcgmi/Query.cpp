@@ -85,7 +85,6 @@ Query::~Query()
 dcgmReturn_t Query::DisplayDiscoveredDevices(dcgmHandle_t dcgmHandle)
 {
     dcgmReturn_t result;
-    dcgmDeviceAttributes_t stDeviceAttributes;
     std::vector<dcgm_field_eid_t> entityIds;
 
     std::string entityId;
@@ -113,10 +112,22 @@ dcgmReturn_t Query::DisplayDiscoveredDevices(dcgmHandle_t dcgmHandle)
         }
 
         std::cout << entityIds.size() << " GPU" << (entityIds.size() == 1 ? "" : "s") << " found." << std::endl;
+
+        /* Fetch the attributes of all of the GPUs in one request */
+        std::vector<dcgmDeviceAttributes_t> deviceAttributes(entityIds.size());
+        for (auto &attributes : deviceAttributes)
+        {
+            attributes.version = dcgmDeviceAttributes_version;
+        }
+        if (!entityIds.empty())
+        {
+            result = dcgmGetDeviceAttributesBulk(
+                dcgmHandle, entityIds.data(), entityIds.size(), deviceAttributes.data());
+        }
+
         for (unsigned int i = 0; i < entityIds.size(); i++)
         {
-            stDeviceAttributes.version = dcgmDeviceAttributes_version;
-            result                     = dcgmGetDeviceAttributes(dcgmHandle, entityIds[i], &stDeviceAttributes);
+            dcgmDeviceAttributes_t const &stDeviceAttributes = deviceAttributes[i];
 
             entityId = std::to_string(entityIds[i]);
 
@@ -175,9 +186,7 @@ dcgmReturn_t Query::DisplayDeviceInfo(dcgmHandle_t dcgmHandle,
                                       std::string const &attributes)
 {
     dcgmDeviceAttributes_t stDeviceAttributes;
-    stDeviceAttributes.version      = dcgmDeviceAttributes_version;
-    CommandOutputController cmdView = CommandOutputController();
-    std::stringstream ss;
+    stDeviceAttributes.version = dcgmDeviceAttributes_version;
 
     // Check if input attribute flags are valid
     dcgmReturn_t result = HelperValidInput(attributes);
@@ -195,17 +204,30 @@ dcgmReturn_t Query::DisplayDeviceInfo(dcgmHandle_t dcgmHandle,
         DCGM_LOG_ERROR << "Error getting device attributes with GPU ID: " << requestedGpuId << ". Return: " << result;
         return result;
     }
-    else if (!stDeviceAttributes.identifiers.brandName[0])
+
+    return HelperDisplayDeviceAttributes(requestedGpuId, stDeviceAttributes, attributes);
+}
+
+/********************************************************************************/
+dcgmReturn_t Query::HelperDisplayDeviceAttributes(unsigned int gpuId,
+                                                  dcgmDeviceAttributes_t &stDeviceAttributes,
+                                                  std::string const &attributes)
+{
+    CommandOutputController cmdView = CommandOutputController();
+    std::stringstream ss;
+
+    if (!stDeviceAttributes.identifiers.brandName[0])
     { // This should be there if the gpu was found
         std::cout << "Error: Unable to get GPU info. Return: Bad parameter passed to function.\n";
-        DCGM_LOG_ERROR << "Error getting device attributes with GPU ID: " << requestedGpuId << ". Return: " << result;
+        DCGM_LOG_ERROR << "Error getting device attributes with GPU ID: " << gpuId
+                       << ". Return: " << DCGM_ST_BADPARAM;
         return DCGM_ST_BADPARAM;
     }
     else
     {
         // Parse tags and output selected parameters
         cmdView.setDisplayStencil(QUERY_DEVICE_HEADER);
-        ss << "GPU ID: " << requestedGpuId;
+        ss << "GPU ID: " << gpuId;
         cmdView.addDisplayParameter(HEADER_TAG, ss.str());
         cmdView.display();
 
@@ -239,7 +261,7 @@ dcgmReturn_t Query::DisplayDeviceInfo(dcgmHandle_t dcgmHandle,
                     break;
                 default:
                     // Should never run
-                    DCGM_LOG_ERROR << "Unexpected error in querying GPU " << requestedGpuId << ".";
+                    DCGM_LOG_ERROR << "Unexpected error in querying GPU " << gpuId << ".";
                     break;
             }
         }
@@ -278,6 +300,23 @@ dcgmReturn_t Query::DisplayGroupInfo(dcgmHandle_t mNvcmHandle,
     }
     else
     {
+        // Check if input attribute flags are valid
+        result = HelperValidInput(attributes);
+        if (DCGM_ST_OK != result)
+        {
+            std::cout << "Error: Invalid flags detected. Return: " << errorString(result) << std::endl;
+            return result;
+        }
+
+        std::unique_ptr<dcgmDeviceAttributes_t[]> stDeviceAttributes {
+            new dcgmDeviceAttributes_t[stNvcmGroupInfo.count]
+        };
+        result = HelperGetGroupDeviceAttributes(mNvcmHandle, stNvcmGroupInfo, stDeviceAttributes.get());
+        if (result != DCGM_ST_OK)
+        {
+            return result;
+        }
+
         std::cout << "Device info: " << std::endl;
         for (unsigned int i = 0; i < stNvcmGroupInfo.count; i++)
         {
@@ -288,7 +327,8 @@ dcgmReturn_t Query::DisplayGroupInfo(dcgmHandle_t mNvcmHandle,
                 continue;
             }
 
-            result = DisplayDeviceInfo(mNvcmHandle, stNvcmGroupInfo.entityList[i].entityId, attributes);
+            result = HelperDisplayDeviceAttributes(
+                stNvcmGroupInfo.entityList[i].entityId, stDeviceAttributes[i], attributes);
 
             if (result != DCGM_ST_OK)
             {
@@ -300,6 +340,50 @@ dcgmReturn_t Query::DisplayGroupInfo(dcgmHandle_t mNvcmHandle,
     return result;
 }
 
+/********************************************************************************/
+dcgmReturn_t Query::HelperGetGroupDeviceAttributes(dcgmHandle_t dcgmHandle,
+                                                   dcgmGroupInfo_t &stNvcmGroupInfo,
+                                                   dcgmDeviceAttributes_t stDeviceAttributes[])
+{
+    std::vector<unsigned int> gpuIds;
+    std::vector<unsigned int> gpuIndexes;
+
+    for (unsigned int i = 0; i < stNvcmGroupInfo.count; i++)
+    {
+        if (stNvcmGroupInfo.entityList[i].entityGroupId == DCGM_FE_GPU)
+        {
+            gpuIds.push_back(stNvcmGroupInfo.entityList[i].entityId);
+            gpuIndexes.push_back(i);
+        }
+    }
+
+    if (gpuIds.empty())
+    {
+        return DCGM_ST_OK;
+    }
+
+    std::vector<dcgmDeviceAttributes_t> gpuAttributes(gpuIds.size());
+    for (auto &attributes : gpuAttributes)
+    {
+        attributes.version = dcgmDeviceAttributes_version;
+    }
+
+    dcgmReturn_t result = dcgmGetDeviceAttributesBulk(dcgmHandle, gpuIds.data(), gpuIds.size(), gpuAttributes.data());
+    if (result != DCGM_ST_OK)
+    {
+        std::cout << "Error: Unable to get GPU info. Return: " << errorString(result) << std::endl;
+        DCGM_LOG_ERROR << "Error getting device attributes of the GPUs of the group. Return: " << result;
+        return result;
+    }
+
+    for (unsigned int i = 0; i < gpuIds.size(); i++)
+    {
+        stDeviceAttributes[gpuIndexes[i]] = gpuAttributes[i];
+    }
+
+    return DCGM_ST_OK;
+}
+
 /********************************************************************************/
 dcgmReturn_t Query::HelperDisplayNonVerboseGroup(dcgmHandle_t mNvcmHandle,
                                                  dcgmGroupInfo_t &stNvcmGroupInfo,
@@ -326,21 +410,13 @@ dcgmReturn_t Query::HelperDisplayNonVerboseGroup(dcgmHandle_t mNvcmHandle,
         {
             std::cout << DcgmFieldsGetEntityGroupString(stNvcmGroupInfo.entityList[i].entityGroupId)
                       << " id: " << stNvcmGroupInfo.entityList[i].entityId << std::endl;
-            continue;
         }
+    }
 
-        stDeviceAttributes[i].version = dcgmDeviceAttributes_version;
-        result = dcgmGetDeviceAttributes(mNvcmHandle, stNvcmGroupInfo.entityList[i].entityId, &stDeviceAttributes[i]);
-
-        if (result != DCGM_ST_OK)
-        {
-            std::cout << "Error: Unable to get GPU info. Return: " << errorString(result) << std::endl;
-            PRINT_ERROR("%d %d",
-                        "Error getting device attributes with GPU ID: %d. Return: %d",
-                        stNvcmGroupInfo.entityList[i].entityId,
-                        result);
-            return result;
-        }
+    result = HelperGetGroupDeviceAttributes(mNvcmHandle, stNvcmGroupInfo, stDeviceAttributes.get());
+    if (result != DCGM_ST_OK)
+    {
+        return result;
     }
 
     // Parse tags and output selected parameters
@@ -75,6 +75,21 @@ private:
      *****************************************************************************/
     dcgmReturn_t HelperValidInput(std::string const &attributes);
 
+    /*****************************************************************************
+     * Helper method to fetch the attributes of all of the GPUs of a group in one
+     * request. stDeviceAttributes is indexed like stNvcmGroupInfo.entityList
+     *****************************************************************************/
+    dcgmReturn_t HelperGetGroupDeviceAttributes(dcgmHandle_t dcgmHandle,
+                                                dcgmGroupInfo_t &stNvcmGroupInfo,
+                                                dcgmDeviceAttributes_t stDeviceAttributes[]);
+
+    /*****************************************************************************
+     * Helper method to display the selected attributes of one GPU
+     *****************************************************************************/
+    dcgmReturn_t HelperDisplayDeviceAttributes(unsigned int gpuId,
+                                               dcgmDeviceAttributes_t &stDeviceAttributes,
+                                               std::string const &attributes);
+
     /*****************************************************************************
      * Helper method to format the display of clock information
      *****************************************************************************/
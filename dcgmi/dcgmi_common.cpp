@@ -339,21 +339,35 @@ using EntityMap = std::unordered_map<DcgmNs::ParseResult, dcgmGroupEntityPair_t>
         {
             entityMap.insert_or_assign(ParsedGpu { std::to_string(entities[idx]) },
                                        dcgmGroupEntityPair_t { DCGM_FE_GPU, entities[idx] });
+        }
+
+        /* Fetch the UUIDs of all of the GPUs in one request */
+        std::vector<dcgmDeviceAttributes_t> deviceAttributes(numItems);
+        for (auto &attributes : deviceAttributes)
+        {
+            memset(&attributes, 0, sizeof(attributes));
+            attributes.version = dcgmDeviceAttributes_version2;
+        }
 
-            dcgmDeviceAttributes_t deviceAttributes {};
-            deviceAttributes.version = dcgmDeviceAttributes_version2;
+        if (numItems > 0)
+        {
+            ret = dcgmGetDeviceAttributesBulk(dcgmHandle, entities, numItems, deviceAttributes.data());
+        }
 
-            ret = dcgmGetDeviceAttributes(dcgmHandle, entities[idx], &deviceAttributes);
-            if (ret != DCGM_ST_OK)
+        if (ret != DCGM_ST_OK)
+        {
+            SHOW_AND_LOG_ERROR << "Unable to collect GPU attributes. "
+                               << "It may be impossible to specify GPU UUID as entity id. "
+                               << "Result: " << ret << " " << errorString(ret);
+        }
+        else
+        {
+            for (size_t idx = 0; idx < (size_t)numItems; ++idx)
             {
-                SHOW_AND_LOG_ERROR << "Unable to collect GPU attributes for GpuId " << entities[idx]
-                                   << ". It may be impossible to specify GPU UUID as entity id. "
-                                   << "Result: " << ret << " " << errorString(ret);
-                continue;
+                auto const uuid = CutUuidPrefix(deviceAttributes[idx].identifiers.uuid);
+                entityMap.insert_or_assign(ParseInstanceId(uuid),
+                                           dcgmGroupEntityPair_t { DCGM_FE_GPU, entities[idx] });
             }
-
-            auto const uuid = CutUuidPrefix(deviceAttributes.identifiers.uuid);
-            entityMap.insert_or_assign(ParseInstanceId(uuid), dcgmGroupEntityPair_t { DCGM_FE_GPU, entities[idx] });
         }
     }
 
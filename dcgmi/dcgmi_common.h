@@ -56,7 +56,7 @@ struct ConsoleErrorLogger
 
     ~ConsoleErrorLogger()
     {
-        IF_LOG_(BASE_LOGGER, plog::debug)(*plog::get<BASE_LOGGER>()) += record;
+        DCGM_IF_LOG_(BASE_LOGGER, plog::debug)(*plog::get<BASE_LOGGER>()) += record;
         std::cerr << std::endl;
     }
 
@@ -97,7 +97,7 @@ typedef struct dcgmi_entity_pair_t
     /* < operator needed for using this struct in a std::map */
     bool operator<(const dcgmi_entity_pair_t &a) const
     {
-        return (entityGroupId < a.entityGroupId || entityId < a.entityId);
+        return (entityGroupId < a.entityGroupId || (entityGroupId == a.entityGroupId && entityId < a.entityId));
     }
 } dcgmi_entity_pair_t;
 
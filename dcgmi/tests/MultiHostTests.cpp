@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <MultiHost.h>
+
+#include <thread>
+
+TEST_CASE("Dcgmi MultiHost: ParseHostList")
+{
+    SECTION("Comma-separated list")
+    {
+        auto result = ParseHostList("node1,node2, node3");
+        REQUIRE(result == std::vector<std::string> { "node1", "node2", "node3" });
+    }
+
+    SECTION("Host file with comments and duplicates")
+    {
+        auto result = ParseHostList("# rack 1\nnode1\nnode2 # spare\n\nunix:///tmp/he.sock\nnode1\n");
+        REQUIRE(result == std::vector<std::string> { "node1", "node2", "unix:///tmp/he.sock" });
+    }
+
+    SECTION("Nothing but separators")
+    {
+        REQUIRE(ParseHostList(" ,\n# none").empty());
+    }
+}
+
+TEST_CASE("Dcgmi MultiHost: AsyncRequestSet")
+{
+    AsyncRequestSet requests;
+    dcgmReturn_t statuses[3] = { DCGM_ST_OK, DCGM_ST_OK, DCGM_ST_OK };
+    std::vector<void *> userData;
+
+    for (auto &status : statuses)
+    {
+        userData.push_back(requests.Add(&status));
+    }
+
+    AsyncRequestSet::Complete(DCGM_ST_BADPARAM, userData[0]);
+
+    std::thread completer([&userData] {
+        AsyncRequestSet::Complete(DCGM_ST_OK, userData[1]);
+        AsyncRequestSet::Complete(DCGM_ST_CONNECTION_NOT_VALID, userData[2]);
+    });
+
+    requests.Wait();
+    completer.join();
+
+    CHECK(statuses[0] == DCGM_ST_BADPARAM);
+    CHECK(statuses[1] == DCGM_ST_OK);
+    CHECK(statuses[2] == DCGM_ST_CONNECTION_NOT_VALID);
+}
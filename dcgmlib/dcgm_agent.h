@@ -162,6 +162,33 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmConnect_v2(const char *ipAddress,
                                             dcgmConnectV2Params_t *connectParams,
                                             dcgmHandle_t *pDcgmHandle);
 
+/**
+ * This method is used to get another handle to the host engine that pDcgmHandle is connected to, without opening
+ * another connection. Messages of both handles go over the socket of pDcgmHandle, but the host engine tracks the new
+ * handle as a connection of its own: its watches and other state are removed when it is disconnected, unless
+ * persistAfterDisconnect is set. Processes that use a handle per thread or per subsystem can share one connection
+ * this way rather than open a socket for each.
+ *
+ * Disconnecting the new handle leaves pDcgmHandle connected. Disconnecting pDcgmHandle, or losing its connection,
+ * disconnects every handle that shares it.
+ *
+ * @param pDcgmHandle             IN: DCGM Handle that came from dcgmConnect_v2
+ * @param persistAfterDisconnect  IN: Whether to persist DCGM state modified by the new handle once it is
+ *                                    disconnected. See \ref dcgmConnectV2Params_t
+ * @param pSharedHandle          OUT: The new DCGM Handle. Disconnect it with \ref dcgmDisconnect
+ *
+ * @return
+ *         - \ref DCGM_ST_OK                   if the call was successful
+ *         - \ref DCGM_ST_BADPARAM             if pSharedHandle is NULL
+ *         - \ref DCGM_ST_UNINITIALIZED        if DCGM has not been initialized with \ref dcgmInit
+ *         - \ref DCGM_ST_NOT_SUPPORTED        if pDcgmHandle is an embedded host engine
+ *         - \ref DCGM_ST_MAX_LIMIT            if too many handles already share the connection of pDcgmHandle
+ *         - \ref DCGM_ST_CONNECTION_NOT_VALID if the connection is gone
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmConnectShared(dcgmHandle_t pDcgmHandle,
+                                               unsigned int persistAfterDisconnect,
+                                               dcgmHandle_t *pSharedHandle);
+
 /**
  * This method is used to disconnect from a stand-alone host engine process.
  *
@@ -175,6 +202,87 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmConnect_v2(const char *ipAddress,
  */
 dcgmReturn_t DCGM_PUBLIC_API dcgmDisconnect(dcgmHandle_t pDcgmHandle);
 
+/**
+ * This method is used to get how much traffic a connection to a host engine has carried and how it was compressed.
+ * Use it to tune \ref dcgmConnectV2Params_t compressionThreshold: compare the bytes sent and the bytes that would
+ * have been sent without compression against the CPU time spent compressing on either side.
+ *
+ * The send queues show whether either side is falling behind reading what the other sends. Notifications the
+ * host engine dropped or coalesced for this process are counted in stats->hostEngineSendQueue.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle that came from dcgmConnect_v2
+ * @param stats       OUT: Compression settings, traffic and send queues of the connection. stats->version must be
+ *                         set to dcgmTransportStats_version. dcgmTransportStats_version1 is also accepted
+ *
+ * @return
+ *         - \ref DCGM_ST_OK                   if the call was successful
+ *         - \ref DCGM_ST_BADPARAM             if stats is NULL
+ *         - \ref DCGM_ST_VER_MISMATCH         if stats->version is not a known dcgmTransportStats version
+ *         - \ref DCGM_ST_NOT_SUPPORTED        if pDcgmHandle is an embedded host engine
+ *         - \ref DCGM_ST_CONNECTION_NOT_VALID if the connection is gone
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmGetTransportStats(dcgmHandle_t pDcgmHandle, dcgmTransportStats_t *stats);
+
+/**
+ * This method is used to have this process cache responses that only change when GPUs are attached, MIG is
+ * reconfigured or field groups are created or destroyed. Once enabled, repeated calls of
+ * \ref dcgmGetDeviceAttributes, \ref dcgmGetAllDevices, \ref dcgmGetAllSupportedDevices,
+ * \ref dcgmGetEntityGroupEntities, \ref dcgmFieldGroupGetInfo and \ref dcgmFieldGroupGetAll on pDcgmHandle are
+ * answered without a round trip to the host engine. The host engine tells the client when any of those events
+ * happen, which drops everything cached.
+ *
+ * Note that the memory usage and power limits in a cached \ref dcgmDeviceAttributes_t are as of the first call after
+ * the cache was last dropped. Use \ref dcgmGetLatestValuesForFields for up-to-date values of them.
+ *
+ * The cache lasts until pDcgmHandle is disconnected.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle that came from dcgmConnect_v2
+ *
+ * @return
+ *         - \ref DCGM_ST_OK                   if the cache is enabled. Also if it already was
+ *         - \ref DCGM_ST_NOT_SUPPORTED        if pDcgmHandle is an embedded host engine
+ *         - \ref DCGM_ST_CONNECTION_NOT_VALID if the connection is gone
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmClientCacheEnable(dcgmHandle_t pDcgmHandle);
+
+/**
+ * This method is used to get a token that this connection's state can be taken back with after the host engine
+ * restarts. If nv-hostengine was started with --state-file, it saves the groups, field groups, watches and health
+ * watches of every connection that got a token when it stops, and restores them before it starts listening again.
+ * A client that reconnects within 5 minutes passes the token to \ref dcgmSessionResume and keeps using its group
+ * and field group IDs without setting them up again. Restored state that no client resumes is removed after that.
+ *
+ * Violation policies are restored for every GPU whether or not anyone resumes. Policy callbacks are not; register
+ * them again with \ref dcgmPolicyRegister_v2 after resuming.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle that came from dcgmConnect_v2
+ * @param token       OUT: Token of this connection. It stays the same for as long as the connection lasts
+ *
+ * @return
+ *         - \ref DCGM_ST_OK                   if the call was successful
+ *         - \ref DCGM_ST_BADPARAM             if token is NULL
+ *         - \ref DCGM_ST_NOT_SUPPORTED        if pDcgmHandle is an embedded host engine
+ *         - \ref DCGM_ST_CONNECTION_NOT_VALID if the connection is gone
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmSessionGetToken(dcgmHandle_t pDcgmHandle, unsigned long long *token);
+
+/**
+ * This method is used to take over the state that a connection with token had before the host engine restarted.
+ * See \ref dcgmSessionGetToken. Afterward the state belongs to pDcgmHandle, is removed when it disconnects, and
+ * token is the token of pDcgmHandle. Any state pDcgmHandle already set up is kept.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle that came from dcgmConnect_v2
+ * @param token        IN: Token from \ref dcgmSessionGetToken on the connection before the restart
+ *
+ * @return
+ *         - \ref DCGM_ST_OK                   if the call was successful
+ *         - \ref DCGM_ST_NO_DATA              if no state is held for token. It was never saved, was resumed
+ *                                             already or expired
+ *         - \ref DCGM_ST_NOT_SUPPORTED        if pDcgmHandle is an embedded host engine
+ *         - \ref DCGM_ST_CONNECTION_NOT_VALID if the connection is gone
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmSessionResume(dcgmHandle_t pDcgmHandle, unsigned long long token);
+
 
 /** @} */ // Closing for DCGMAPI_Admin_InitShut
 
@@ -241,6 +349,22 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmHostengineSetLoggingSeverity(dcgmHandle_t pDcgm
  */
 dcgmReturn_t DCGM_PUBLIC_API dcgmHostengineIsHealthy(dcgmHandle_t pDcgmHandle, dcgmHostengineHealth_t *heHealth);
 
+/**
+ * This function gets the worker threads of each of the host engine's request lanes and how long requests waited
+ * for them, to check the sizing set with nv-hostengine --min-workers and --max-workers
+ *
+ * @param[in]     pDcgmHandle - the handle to DCGM
+ * @param[in,out] stats       - version must be set to dcgmHostengineWorkerStats_version. Populated with the lanes
+ *                              on success
+ *
+ * @return
+ *          - \ref DCGM_ST_OK           if the call was successful
+ *          - \ref DCGM_ST_BADPARAM     if stats is NULL
+ *          - \ref DCGM_ST_VER_MISMATCH if stats->version is not dcgmHostengineWorkerStats_version
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmHostengineGetWorkerStats(dcgmHandle_t pDcgmHandle,
+                                                          dcgmHostengineWorkerStats_t *stats);
+
 
 /**
  * This function describes DCGM error codes in human readable form
@@ -345,6 +469,26 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmGetDeviceAttributes(dcgmHandle_t pDcgmHandle,
                                                      unsigned int gpuId,
                                                      dcgmDeviceAttributes_t *pDcgmAttr);
 
+/**
+ * Gets the device attributes of several GPUs at once. This is the same as calling \ref dcgmGetDeviceAttributes
+ * for each of them, but the attributes of all of the GPUs are fetched with a single request to the host engine.
+ *
+ * @param pDcgmHandle    IN: DCGM Handle
+ * @param gpuIds         IN: GPU Ids corresponding to which the attributes should be fetched
+ * @param count          IN: Number of entries in gpuIds[] and attributes[]. At most \ref DCGM_MAX_NUM_DEVICES
+ * @param attributes IN/OUT: Device attributes corresponding to each entry of \a gpuIds.<br> The .version of each
+ *                           entry should be set to \ref dcgmDeviceAttributes_version before this call.
+ *
+ * @return
+ *        - \ref DCGM_ST_OK            if the call was successful.
+ *        - \ref DCGM_ST_BADPARAM      if \a count is 0 or larger than \ref DCGM_MAX_NUM_DEVICES.
+ *        - \ref DCGM_ST_VER_MISMATCH  if the .version of any of \a attributes is not set or is invalid.
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmGetDeviceAttributesBulk(dcgmHandle_t pDcgmHandle,
+                                                         unsigned int gpuIds[],
+                                                         unsigned int count,
+                                                         dcgmDeviceAttributes_t attributes[]);
+
 /**
  * Gets the list of entities that exist for a given entity group. This API can be used in place of
  * \ref dcgmGetAllDevices.
@@ -928,6 +1072,65 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmWatchFields(dcgmHandle_t pDcgmHandle,
                                              double maxKeepAge,
                                              int maxKeepSamples);
 
+/**
+ * Request that DCGM start recording updates for a given field collection as a snapshot group. This works like
+ * \ref dcgmWatchFields, except that whenever one of the fields is due, every field of the collection is fetched on
+ * every entity of the group in one parallel pass and all of the values get the same timestamp. Values of different
+ * fields and GPUs can then be joined by timestamp instead of interpolated.
+ *
+ * Only GPU fields are fetched as part of the snapshot. Profiling fields are watched as with \ref dcgmWatchFields.
+ * A field of an entity is part of one snapshot group at a time, so watching it as part of another one moves it.
+ * Fields fetched as a snapshot group read instantaneous values even if the host engine reads driver sample buffers.
+ * Use \ref dcgmUnwatchFields to stop the watches.
+ *
+ * @param pDcgmHandle         IN: DCGM Handle
+ * @param groupId             IN: Group ID representing collection of one or more entities. Look at \ref dcgmGroupCreate
+ *                                for details on creating the group. Alternatively, pass in the group id as
+ *                                \a DCGM_GROUP_ALL_GPUS to perform operation on all the GPUs.
+ * @param fieldGroupId        IN: Fields to watch.
+ * @param updateFreq          IN: How often to update this field in usec
+ * @param maxKeepAge          IN: How long to keep data for this field in seconds
+ * @param maxKeepSamples      IN: Maximum number of samples to keep. 0=no limit
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmWatchFieldsSnapshot(dcgmHandle_t pDcgmHandle,
+                                                     dcgmGpuGrp_t groupId,
+                                                     dcgmFieldGrp_t fieldGroupId,
+                                                     long long updateFreq,
+                                                     double maxKeepAge,
+                                                     int maxKeepSamples);
+
+/**
+ * Define a derived field as an arithmetic expression over other fields of the same entity. The host engine compiles
+ * the expression once and evaluates it whenever its inputs are updated, so the derived field can be watched and read
+ * like any other field, without the client fetching every input.
+ *
+ * Derived fields are \ref DCGM_FI_FIRST_DERIVED_FIELD_ID through \ref DCGM_FI_LAST_DERIVED_FIELD_ID, and are doubles.
+ * Expressions are made of numbers, + - * /, unary minus and parentheses. Fields are referred to by tag or by ID,
+ * as in "power_usage / enforced_power_limit * 100" or "$155 / $160 * 100". Only int64 and double fields that aren't
+ * derived fields can be used, and at most \ref DCGM_DERIVED_FIELD_MAX_INPUTS of them.
+ *
+ * Watching a derived field watches its inputs at the same frequency. A derived value has the timestamp of its newest
+ * input. If an input is blank, the derived value is that same blank, and a result that isn't a finite number, like
+ * after a division by 0, is \ref DCGM_FP64_BLANK. Watches of a derived field that is defined again switch to the new
+ * expression, and an empty expression removes the definition. Definitions aren't kept across host engine restarts.
+ *
+ * @param pDcgmHandle         IN: DCGM Handle
+ * @param derivedField    IN/OUT: fieldId and expression of the derived field. The version must be set to
+ *                                \ref dcgmDerivedField_version. If the expression isn't valid, error says why.
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if fieldId isn't a derived field or the expression isn't valid
+ *        - \ref DCGM_ST_VER_MISMATCH         if derivedField has the wrong version
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmSetDerivedField(dcgmHandle_t pDcgmHandle, dcgmDerivedField_t *derivedField);
+
 /**
  * Request that DCGM stop recording updates for a given field collection.
  *
@@ -1010,6 +1213,164 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmGetValuesSince_v2(dcgmHandle_t pDcgmHandle,
                                                    dcgmFieldValueEntityEnumeration_f enumCB,
                                                    void *userData);
 
+/**
+ * Request field values that have updated since a given timestamp, combined into fixed-width time buckets
+ * by the host engine. This is much cheaper than \ref dcgmGetValuesSince_v2 when the caller only needs a
+ * fraction of the samples, such as when plotting a long time range.
+ *
+ * Buckets start at multiples of bucketWidthUsec since 1970. Only buckets that have ended by the time of
+ * the query and that contain at least one non-blank sample are returned. Each value's timestamp is the
+ * start of its bucket. Only int64, timestamp and double fields can be bucketed. Other fields are returned
+ * as a single value with status DCGM_ST_NOT_SUPPORTED.
+ *
+ * @param pDcgmHandle         IN: DCGM Handle
+ * @param groupId             IN: Group ID representing collection of one or more entities. Look at \ref dcgmGroupCreate
+ *                                for details on creating the group. Alternatively, pass in the group id as
+ *                                \a DCGM_GROUP_ALL_GPUS to perform operation on all the GPUs or
+ *                                \a DCGM_GROUP_ALL_NVSWITCHES to perform the operation on all NvSwitches.
+ * @param fieldGroupId        IN: Fields to return data for
+ * @param sinceTimestamp      IN: Timestamp to request values since in usec since 1970. It is rounded down to a
+ *                                multiple of bucketWidthUsec. 0 = request all data
+ * @param bucketWidthUsec     IN: Width of each bucket in usec
+ * @param aggregation         IN: How to combine the samples of each bucket
+ * @param nextSinceTimestamp OUT: Timestamp to use for sinceTimestamp on next call to this function. This is the end
+ *                                of the last complete bucket, so buckets are never returned twice
+ * @param enumCB              IN: Callback to invoke with the buckets of each entity and field. Note that multiple
+ *                                buckets can be returned in each invocation
+ * @param userData            IN: User data pointer to pass to the userData field of enumCB.
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmGetValuesSinceBucketed(dcgmHandle_t pDcgmHandle,
+                                                        dcgmGpuGrp_t groupId,
+                                                        dcgmFieldGrp_t fieldGroupId,
+                                                        long long sinceTimestamp,
+                                                        long long bucketWidthUsec,
+                                                        dcgmBucketAggregation_t aggregation,
+                                                        long long *nextSinceTimestamp,
+                                                        dcgmFieldValueEntityEnumeration_f enumCB,
+                                                        void *userData);
+
+/**
+ * Subscribe to a stream of the values of a field group on a group of entities. Instead of being polled with
+ * \ref dcgmGetValuesSince_v2, the host engine pushes new values to the client in batches as it samples them and
+ * \a callback is invoked for each batch.
+ *
+ * The fields are watched at params->updateFreq as if \ref dcgmWatchFields had been called, until the stream is
+ * unsubscribed or the connection closes.
+ *
+ * The host engine only sends params->maxBatchesInFlight batches that the client hasn't finished processing. While
+ * the client is behind, new values are held on the host engine and sent together once the client catches up. If
+ * more than params->maxPendingValues are held, newer values are dropped and a warning is logged by the client.
+ *
+ * \a callback is invoked on a DCGM thread, once for each run of values of the same entity in a batch. Return a
+ * negative value from it to skip the rest of the batch. It must not call DCGM APIs and should return quickly.
+ * It can be invoked before this function returns.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle
+ * @param params       IN: Group, field group and watch and flow control parameters of the stream
+ * @param callback     IN: Callback to invoke with the streamed values
+ * @param userData     IN: User data pointer to pass to the userData field of callback
+ * @param streamId    OUT: Identifier of the stream to pass to \ref dcgmFieldValueStreamUnsubscribe
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid
+ *        - \ref DCGM_ST_VER_MISMATCH         if params->version is not dcgmFieldValueStreamParams_version
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmFieldValueStreamSubscribe(dcgmHandle_t pDcgmHandle,
+                                                           dcgmFieldValueStreamParams_t *params,
+                                                           dcgmFieldValueEntityEnumeration_f callback,
+                                                           void *userData,
+                                                           unsigned int *streamId);
+
+/**
+ * Stop a stream started by \ref dcgmFieldValueStreamSubscribe and remove its watches. No more values of the
+ * stream are passed to its callback once this returns.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle
+ * @param streamId     IN: streamId returned by \ref dcgmFieldValueStreamSubscribe
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_NO_DATA              if there is no such stream
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmFieldValueStreamUnsubscribe(dcgmHandle_t pDcgmHandle, unsigned int streamId);
+
+/**
+ * Subscribe to a stream of the values of a field group on every host engine behind a proxy host engine (see
+ * nv-hostengine --proxy-hosts). This lets a collector get the values of a rack of host engines over one connection.
+ *
+ * The proxy keeps a stream like \ref dcgmFieldValueStreamSubscribe with params->updateFreq, params->maxKeepAge and
+ * params->maxKeepSamples on each host engine it is connected to, and subscribes it again when it reconnects to a host
+ * engine. The values the host engines push are gathered on the proxy and sent to the client in batches with a
+ * section for each host engine.
+ *
+ * The proxy only sends params->maxBatchesInFlight batches that the client hasn't finished processing. While the
+ * client is behind, the proxy holds up to params->maxPendingValues values of each host engine and drops newer ones.
+ * Drops are logged by the client and counted in \ref dcgmProxyHostStatus_v1::valuesDropped.
+ *
+ * \a callback is invoked on a DCGM thread, once for each run of values of the same entity of a host engine. Return a
+ * negative value from it to skip the rest of the batch. It must not call DCGM APIs and should return quickly.
+ * It can be invoked before this function returns.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle of a connection to the proxy
+ * @param params       IN: Watch and flow control parameters of the stream. params->groupId must be
+ *                         DCGM_GROUP_ALL_GPUS or DCGM_GROUP_ALL_NVSWITCHES, which are resolved on each host engine.
+ *                         params->fieldGroupId is a field group on the proxy
+ * @param callback     IN: Callback to invoke with the streamed values
+ * @param userData     IN: User data pointer to pass to the userData field of callback
+ * @param streamId    OUT: Identifier of the stream to pass to \ref dcgmProxyStreamUnsubscribe
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid
+ *        - \ref DCGM_ST_VER_MISMATCH         if params->version is not dcgmFieldValueStreamParams_version
+ *        - \ref DCGM_ST_NOT_SUPPORTED        if the host engine isn't a proxy
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmProxyStreamSubscribe(dcgmHandle_t pDcgmHandle,
+                                                      dcgmFieldValueStreamParams_t *params,
+                                                      dcgmProxyFieldValueEnumeration_f callback,
+                                                      void *userData,
+                                                      unsigned int *streamId);
+
+/**
+ * Stop a stream started by \ref dcgmProxyStreamSubscribe. No more values of the stream are passed to its callback
+ * once this returns. The proxy removes the stream from the host engines behind it shortly after.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle
+ * @param streamId     IN: streamId returned by \ref dcgmProxyStreamSubscribe
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_NO_DATA              if there is no such stream
+ *        - \ref DCGM_ST_NOT_SUPPORTED        if the host engine isn't a proxy
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmProxyStreamUnsubscribe(dcgmHandle_t pDcgmHandle, unsigned int streamId);
+
+/**
+ * Get the state of the host engines behind a proxy host engine. The index of each host engine in hosts->hosts is the
+ * hostId passed to the callbacks of \ref dcgmProxyStreamSubscribe.
+ *
+ * @param pDcgmHandle  IN: DCGM Handle of a connection to the proxy
+ * @param hosts    IN/OUT: .version should be set to \ref dcgmProxyHosts_version before this call
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if hosts is NULL
+ *        - \ref DCGM_ST_VER_MISMATCH         if hosts->version is not dcgmProxyHosts_version
+ *        - \ref DCGM_ST_NOT_SUPPORTED        if the host engine isn't a proxy
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmProxyGetHosts(dcgmHandle_t pDcgmHandle, dcgmProxyHosts_t *hosts);
+
 /**
  * Request latest cached field value for a field value collection
  *
@@ -1123,6 +1484,246 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmEntitiesGetLatestValues(dcgmHandle_t pDcgmHandl
                                                          unsigned int flags,
                                                          dcgmFieldValue_v2 values[]);
 
+/**
+ * Request only the latest cached field values that changed since a previous call, for pollers that watch many
+ * entities and fields of which few change between polls.
+ *
+ * Every time the host engine records a value, it gets a higher update sequence. Start with \a updateSequence set
+ * to 0 to get every value, then pass back the \a updateSequence each call returned to get the values recorded
+ * after it. Fields that have never been recorded are only returned when \a updateSequence is 0.
+ *
+ * @param pDcgmHandle      IN: DCGM Handle
+ * @param entities         IN: List of entities to get values for
+ * @param entityCount      IN: Number of entries in entities[]
+ * @param fields           IN: Field IDs to return data for. See the definitions in dcgm_fields.h that start with
+ *                             DCGM_FI_.
+ * @param fieldCount       IN: Number of field IDs in fields[] array.
+ * @param flags            IN: Optional flags. See \ref dcgmEntitiesGetLatestValues. With \ref DCGM_FV_FLAG_LIVE_DATA,
+ *                             every value is returned regardless of \a updateSequence
+ * @param updateSequence   IN/OUT: Update sequence returned by the previous call, or 0 for all values. Set to the
+ *                             update sequence the returned values are current as of
+ * @param values          OUT: Field values that changed. This must be able to hold entityCount * fieldCount field
+ *                             value records
+ * @param valuesCount     OUT: Number of records written to values[]
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmEntitiesGetLatestValuesSince(dcgmHandle_t pDcgmHandle,
+                                                              dcgmGroupEntityPair_t entities[],
+                                                              unsigned int entityCount,
+                                                              unsigned short fields[],
+                                                              unsigned int fieldCount,
+                                                              unsigned int flags,
+                                                              unsigned long long *updateSequence,
+                                                              dcgmFieldValue_v2 values[],
+                                                              unsigned int *valuesCount);
+
+/**
+ * Asynchronous version of \ref dcgmEntitiesGetLatestValues. Returns once the request is sent and invokes \a callback
+ * when it completes, so that one thread can keep many requests in flight.
+ *
+ * \a callback is invoked on a DCGM thread, or before this returns for the embedded host engine. It must not call
+ * DCGM APIs and should return quickly. Requests complete when the host engine responds or the connection closes.
+ *
+ * @param pDcgmHandle   IN: DCGM Handle
+ * @param entities      IN: List of entities to get values for. Copied before this returns
+ * @param entityCount   IN: Number of entries in entities[]
+ * @param fields        IN: Field IDs to return data for. Copied before this returns
+ * @param fieldCount    IN: Number of field IDs in fields[] array.
+ * @param flags         IN: Optional flags. See \ref dcgmEntitiesGetLatestValues
+ * @param values       OUT: Latest field values for the fields requested. This must be able to hold entityCount *
+ *                          fieldCount field value records and stay valid until \a callback is invoked.
+ * @param callback      IN: Callback to invoke when the request completes
+ * @param userData      IN: User data pointer to pass to the userData field of callback
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the request was started. \a callback will be invoked
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid. \a callback won't be invoked
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmEntitiesGetLatestValuesAsync(dcgmHandle_t pDcgmHandle,
+                                                              dcgmGroupEntityPair_t entities[],
+                                                              unsigned int entityCount,
+                                                              unsigned short fields[],
+                                                              unsigned int fieldCount,
+                                                              unsigned int flags,
+                                                              dcgmFieldValue_v2 values[],
+                                                              dcgmRequestComplete_f callback,
+                                                              void *userData);
+
+/**
+ * Request the latest cached values of a field group for every entity of a group as one dense table, rather than as
+ * a \ref dcgmFieldValue_v2 record per value. See \ref dcgmLatestValuesMatrix_v1 for the layout. The table is filled
+ * in one pass over the cache, so all of its values are as current as the request.
+ *
+ * Cells that couldn't be read are blank and have status bits that say why, rather than failing the request.
+ *
+ * @param pDcgmHandle   IN: DCGM Handle
+ * @param groupId       IN: Group of entities to get values for. These are the rows, in group order
+ * @param fieldGroupId  IN: Fields to get values for. These are the columns, in field group order
+ * @param matrix    IN/OUT: version must be set to dcgmLatestValuesMatrix_version. The rest is filled in
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid
+ *        - \ref DCGM_ST_VER_MISMATCH         if \a matrix has the wrong version
+ *        - \ref DCGM_ST_NOT_CONFIGURED       if \a groupId doesn't exist
+ *        - \ref DCGM_ST_NO_DATA              if \a fieldGroupId doesn't exist
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmGetLatestValuesMatrix(dcgmHandle_t pDcgmHandle,
+                                                       dcgmGpuGrp_t groupId,
+                                                       dcgmFieldGrp_t fieldGroupId,
+                                                       dcgmLatestValuesMatrix_v1 *matrix);
+
+/**
+ * Asynchronously get the values of one field of one entity that were recorded since a timestamp, oldest first.
+ * This is the single entity and field building block of \ref dcgmGetValuesSince_v2. See
+ * \ref dcgmEntitiesGetLatestValuesAsync for when \a callback is invoked.
+ *
+ * @param pDcgmHandle     IN: DCGM Handle
+ * @param entityGroup     IN: Entity group of the entity to get values of
+ * @param entityId        IN: Entity to get values of
+ * @param fieldId         IN: Field to get values of
+ * @param sinceTimestamp  IN: Only values recorded at or after this timestamp in usec since 1970 are returned.
+ *                            0 = all cached values
+ * @param count       IN/OUT: Number of entries values[] can hold. Set to how many were returned when \a callback
+ *                            is invoked with DCGM_ST_OK. Must stay valid until then
+ * @param values         OUT: Values of the field. Must stay valid until \a callback is invoked
+ * @param callback        IN: Callback to invoke when the request completes
+ * @param userData        IN: User data pointer to pass to the userData field of callback
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the request was started. \a callback will be invoked
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid. \a callback won't be invoked
+ *        - \ref DCGM_ST_UNKNOWN_FIELD        if \a fieldId is not a valid field. \a callback won't be invoked
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmEntityGetValuesSinceAsync(dcgmHandle_t pDcgmHandle,
+                                                           dcgm_field_entity_group_t entityGroup,
+                                                           dcgm_field_eid_t entityId,
+                                                           unsigned short fieldId,
+                                                           long long sinceTimestamp,
+                                                           int *count,
+                                                           dcgmFieldValue_v1 values[],
+                                                           dcgmRequestComplete_f callback,
+                                                           void *userData);
+
+/**
+ * Get the next page of the cached values of one field of one entity, oldest first. Unlike reading by timestamp,
+ * continuing from \a cursor doesn't search the cache for where the last page ended in the usual case, and values
+ * are neither returned twice nor missed as new values are recorded and old ones removed in between pages.
+ * Values that were removed before they could be returned are counted in \a valuesSkipped.
+ *
+ * Only values kept at full resolution are returned. History the host engine has rolled up into coarser buckets is
+ * not.
+ *
+ * @param pDcgmHandle     IN: DCGM Handle
+ * @param entityGroup     IN: Entity group of the entity to get values of
+ * @param entityId        IN: Entity to get values of
+ * @param fieldId         IN: Field to get values of
+ * @param cursor      IN/OUT: Where to continue from. Zero it to start from the oldest cached value. Set to after
+ *                            the last value returned
+ * @param count       IN/OUT: Number of entries values[] can hold. Set to how many were returned. 0 = there are no
+ *                            values after \a cursor yet
+ * @param values         OUT: Values of the field
+ * @param valuesSkipped  OUT: Optional. Number of values removed from the cache after \a cursor before this page
+ *                            could return them, if known
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid
+ *        - \ref DCGM_ST_UNKNOWN_FIELD        if \a fieldId is not a valid field
+ *        - \ref DCGM_ST_NOT_WATCHED          if the field is not being watched for the entity
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmEntityGetValuesPage(dcgmHandle_t pDcgmHandle,
+                                                     dcgm_field_entity_group_t entityGroup,
+                                                     dcgm_field_eid_t entityId,
+                                                     unsigned short fieldId,
+                                                     dcgmValuesCursor_t *cursor,
+                                                     int *count,
+                                                     dcgmFieldValue_v1 values[],
+                                                     long long *valuesSkipped);
+
+/**
+ * Like \ref dcgmEntityGetValuesPage for a numeric field, but the values are returned as two flat arrays rather
+ * than as \ref dcgmFieldValue_v1 structs, which are mostly room for strings and blobs. The arrays can be handed to
+ * NumPy or the like as is.
+ *
+ * Values that couldn't be read hold the blank value of the field type, like \a DCGM_INT64_BLANK.
+ *
+ * @param pDcgmHandle     IN: DCGM Handle
+ * @param entityGroup     IN: Entity group of the entity to get values of
+ * @param entityId        IN: Entity to get values of
+ * @param fieldId         IN: Field to get values of. Must be of type DCGM_FT_INT64, DCGM_FT_TIMESTAMP or
+ *                            DCGM_FT_DOUBLE
+ * @param cursor      IN/OUT: Where to continue from. See \ref dcgmEntityGetValuesPage
+ * @param count       IN/OUT: Number of entries timestamps[] and values can hold. Set to how many were returned.
+ *                            0 = there are no values after \a cursor yet
+ * @param timestamps     OUT: Timestamp of each value in usec since 1970
+ * @param values         OUT: Array of long long for DCGM_FT_INT64 and DCGM_FT_TIMESTAMP fields or of double for
+ *                            DCGM_FT_DOUBLE fields
+ * @param valuesSkipped  OUT: Optional. See \ref dcgmEntityGetValuesPage
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid or \a fieldId is not numeric
+ *        - \ref DCGM_ST_UNKNOWN_FIELD        if \a fieldId is not a valid field
+ *        - \ref DCGM_ST_NOT_WATCHED          if the field is not being watched for the entity
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmEntityGetValuesPageNumeric(dcgmHandle_t pDcgmHandle,
+                                                            dcgm_field_entity_group_t entityGroup,
+                                                            dcgm_field_eid_t entityId,
+                                                            unsigned short fieldId,
+                                                            dcgmValuesCursor_t *cursor,
+                                                            int *count,
+                                                            long long timestamps[],
+                                                            void *values,
+                                                            long long *valuesSkipped);
+
+/**
+ * Borrow read-only views of the cached values of numeric fields from the embedded host engine, without copying
+ * them or sending a request. Each view points at the values in the cache itself, so this is the cheapest way
+ * for a client in the same process as the host engine to read values that it reads very often.
+ *
+ * The host engine doesn't update its cache while views are held, so call \ref dcgmEmbeddedReleaseValueViews as
+ * soon as you are done reading them, from the same thread, and don't call other DCGM APIs in between. Calls may
+ * nest, in which case every call that returned DCGM_ST_OK needs its own release.
+ *
+ * @param pDcgmHandle     IN: DCGM Handle. Must be the handle returned by \ref dcgmStartEmbedded
+ * @param views       IN/OUT: What to view. The status of each view says whether that view could be filled
+ * @param count           IN: Number of entries in \a views
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the views were filled and must be released
+ *        - \ref DCGM_ST_BADPARAM             if a parameter is invalid
+ *        - \ref DCGM_ST_NOT_SUPPORTED        if \a pDcgmHandle isn't for an embedded host engine
+ *        - \ref DCGM_ST_UNINITIALIZED        if the embedded host engine isn't running
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmEmbeddedAcquireValueViews(dcgmHandle_t pDcgmHandle,
+                                                           dcgmValueView_v1 views[],
+                                                           unsigned int count);
+
+/**
+ * Give back the views borrowed by the latest call to \ref dcgmEmbeddedAcquireValueViews on this thread. Their
+ * spans must not be read afterward.
+ *
+ * @param pDcgmHandle     IN: DCGM Handle passed to \ref dcgmEmbeddedAcquireValueViews
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_NOT_SUPPORTED        if \a pDcgmHandle isn't for an embedded host engine
+ *        - \ref DCGM_ST_UNINITIALIZED        if the embedded host engine isn't running or no views are held
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmEmbeddedReleaseValueViews(dcgmHandle_t pDcgmHandle);
+
 /*************************************************************************/
 /**
  * Get a summary of the values for a field id over a period of time.
@@ -1320,6 +1921,80 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmJobStopStats(dcgmHandle_t pDcgmHandle, char job
  */
 dcgmReturn_t DCGM_PUBLIC_API dcgmJobGetStats(dcgmHandle_t pDcgmHandle, char jobId[64], dcgmJobInfo_t *pJobInfo);
 
+/**
+ * Asynchronous version of \ref dcgmJobGetStats. See \ref dcgmEntitiesGetLatestValuesAsync for when \a callback
+ * is invoked.
+ *
+ * @param pDcgmHandle        IN: DCGM Handle
+ * @param jobId              IN: User provided string to represent the job. Copied before this returns
+ * @param pJobInfo       IN/OUT: Structure to return information about the job.<br> .version should be set to
+ *                               \ref dcgmJobInfo_version before this call. Must stay valid until \a callback is invoked
+ * @param callback           IN: Callback to invoke when the request completes
+ * @param userData           IN: User data pointer to pass to the userData field of callback
+ *
+ * @return
+ *       - \ref DCGM_ST_OK                  if the request was started. \a callback will be invoked
+ *       - \ref DCGM_ST_BADPARAM            if a parameter is invalid. \a callback won't be invoked
+ *       - \ref DCGM_ST_VER_MISMATCH        if .version is not set or is invalid. \a callback won't be invoked
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmJobGetStatsAsync(dcgmHandle_t pDcgmHandle,
+                                                  char jobId[64],
+                                                  dcgmJobInfo_t *pJobInfo,
+                                                  dcgmRequestComplete_f callback,
+                                                  void *userData);
+
+/**
+ * Get the stats of a job like \ref dcgmJobGetStats, but only if they changed since a previous call. A job can be
+ * watched while it runs this way for about the cost of checking whether it changed, rather than of building its
+ * stats every time.
+ *
+ * Every time samples of a job's GPUs are added to its stats, or it is stopped, it gets a higher update sequence.
+ * Start with \a updateSequence set to 0 to get the stats, then pass back the \a updateSequence each call returned.
+ * The stats of a running job only change as its fields are updated (see \ref dcgmWatchJobFields), so polling more
+ * often than that just returns them unchanged.
+ *
+ * @param pDcgmHandle        IN: DCGM Handle
+ * @param jobId              IN: User provided string to represent the job
+ * @param updateSequence IN/OUT: Update sequence returned by the previous call for this job, or 0. Set to the
+ *                               update sequence of the job. \a pJobInfo was filled in if it changed
+ * @param pJobInfo       IN/OUT: Structure to return information about the job.<br> .version should be set to
+ *                               \ref dcgmJobInfo_version before this call. Left as it is if the job didn't change
+ *                               since \a updateSequence
+ *
+ * @return
+ *       - \ref DCGM_ST_OK                  if the call was successful
+ *       - \ref DCGM_ST_BADPARAM            if a parameter is invalid
+ *       - \ref DCGM_ST_NO_DATA             if \a jobId is not a valid job identifier.
+ *       - \ref DCGM_ST_VER_MISMATCH        if .version is not set or is invalid.
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmJobGetStatsSince(dcgmHandle_t pDcgmHandle,
+                                                  char jobId[64],
+                                                  unsigned long long *updateSequence,
+                                                  dcgmJobInfo_t *pJobInfo);
+
+/**
+ * Get the p50, p95 and p99 of the gauges of a job, like power usage and clocks, from its start until now or until
+ * it was stopped. They come from the same samples as \ref dcgmJobGetStats, folded into quantile sketches as they
+ * arrive, so they cost the same no matter how long the job ran.
+ *
+ * @param pDcgmHandle        IN: DCGM Handle
+ * @param jobId              IN: User provided string to represent the job
+ * @param percentiles    IN/OUT: Structure to return the percentiles of the job.<br> .version should be set to
+ *                               \ref dcgmJobPercentiles_version before this call.
+ *
+ * @return
+ *       - \ref DCGM_ST_OK                  if the call was successful
+ *       - \ref DCGM_ST_BADPARAM            if a parameter is invalid
+ *       - \ref DCGM_ST_NO_DATA             if \a jobId is not a valid job identifier.
+ *       - \ref DCGM_ST_VER_MISMATCH        if .version is not set or is invalid.
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmJobGetPercentiles(dcgmHandle_t pDcgmHandle,
+                                                   char jobId[64],
+                                                   dcgmJobPercentiles_t *percentiles);
+
 /**
  * This API tells DCGM to stop tracking the job given by jobId. After this call, you will no longer
  * be able to call dcgmJobGetStats() on this jobId. However, you will be able to reuse jobId after
@@ -1438,6 +2113,31 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmHealthCheck(dcgmHandle_t pDcgmHandle,
                                              dcgmGpuGrp_t groupId,
                                              dcgmHealthResponse_t *results);
 
+/**
+ * Asynchronous version of \ref dcgmHealthCheck. See \ref dcgmEntitiesGetLatestValuesAsync for when \a callback
+ * is invoked.
+ *
+ * @param pDcgmHandle                   IN: DCGM Handle
+ * @param groupId                       IN: Group ID representing a collection of one or more entities.
+ * @param results                      OUT: A reference to the dcgmHealthResponse_t structure to populate.
+ *                                          results->version must be set to dcgmHealthResponse_version.
+ *                                          Must stay valid until \a callback is invoked
+ * @param callback                      IN: Callback to invoke when the request completes
+ * @param userData                      IN: User data pointer to pass to the userData field of callback
+ *
+ * @return
+ *       - \ref DCGM_ST_OK                  if the request was started. \a callback will be invoked
+ *       - \ref DCGM_ST_BADPARAM            if a parameter is invalid. \a callback won't be invoked
+ *       - \ref DCGM_ST_VER_MISMATCH        if results->version is not dcgmHealthResponse_version.
+ *                                          \a callback won't be invoked
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmHealthCheckAsync(dcgmHandle_t pDcgmHandle,
+                                                  dcgmGpuGrp_t groupId,
+                                                  dcgmHealthResponse_t *results,
+                                                  dcgmRequestComplete_f callback,
+                                                  void *userData);
+
 /** @} */
 
 /***************************************************************************************************/
@@ -1543,6 +2243,26 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmPolicyRegister(dcgmHandle_t pDcgmHandle,
                                                 fpRecvUpdates beginCallback,
                                                 fpRecvUpdates finishCallback);
 
+/**
+ * Register functions to be called when policy conditions (see \ref dcgmPolicyCondition_t) are violated, with
+ * control over how often they are called. This is \ref dcgmPolicyRegister with the addition that violations that
+ * come in quick succession are coalesced: the callbacks get a \ref dcgmPolicyCallbackResponse_v2 with the number
+ * of violations it stands for and the timestamps of the first and last of them.
+ *
+ * @param pDcgmHandle        IN: DCGM Handle
+ * @param params             IN: Group, conditions, callbacks and coalescing settings. See
+ *                               \ref dcgmPolicyRegisterParams_v1
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if \a params is NULL, or its \a groupId, \a condition or
+ *                                            \a coalesceWindowUsec is invalid
+ *        - \ref DCGM_ST_VER_MISMATCH         if \a params has the wrong version
+ *        - \ref DCGM_ST_NOT_SUPPORTED        if any unsupported GPUs are part of the GPU group specified in groupId
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmPolicyRegister_v2(dcgmHandle_t pDcgmHandle, dcgmPolicyRegisterParams_v1 *params);
+
 /**
  * Unregister a function to be called for a specific policy condition (see \ref dcgmPolicyCondition_t).
  * This function will unregister all callbacks for a given condition and handle.
@@ -1701,6 +2421,24 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmGetDeviceTopology(dcgmHandle_t pDcgmHandle,
                                                    unsigned int gpuId,
                                                    dcgmDeviceTopology_t *pDcgmDeviceTopology);
 
+/**
+ * Gets the device topology of several GPUs at once. This is the same as calling \ref dcgmGetDeviceTopology for
+ * each of them, but the topology of the system is only fetched from the host engine once.
+ *
+ * @param pDcgmHandle     IN: DCGM Handle
+ * @param gpuIds          IN: GPU Ids corresponding to which topology information should be fetched
+ * @param count           IN: Number of entries in gpuIds[] and topologies[]. At most \ref DCGM_MAX_NUM_DEVICES
+ * @param topologies     OUT: Topology information corresponding to each entry of \a gpuIds
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful.
+ *        - \ref DCGM_ST_BADPARAM             if \a count or any of \a gpuIds were not valid.
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmGetDeviceTopologyBulk(dcgmHandle_t pDcgmHandle,
+                                                       unsigned int gpuIds[],
+                                                       unsigned int count,
+                                                       dcgmDeviceTopology_t topologies[]);
+
 /**
  * Gets group topology corresponding to the \a groupId.
  *
@@ -1798,7 +2536,9 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmIntrospectGetHostengineMemoryUsage(dcgmHandle_t
  *                               introspection for (ex: all fields, field group ) context->version must be set to
  *                               dcgmIntrospectContext_version prior to this call.
  * @param execTime       IN/OUT: see \ref dcgmIntrospectFullFieldsExecTime_t. execTime->version must be set to
- *                               dcgmIntrospectFullFieldsExecTime_version prior to this call.
+ *                               dcgmIntrospectFullFieldsExecTime_version prior to this call. Older versions,
+ *                               dcgmIntrospectFullFieldsExecTime_version2 and 3, are filled in without the fields
+ *                               that they don't have.
  * @param waitIfNoData       IN: if no metadata is gathered, wait until data has been gathered (1) or return
  *                               DCGM_ST_NO_DATA (0)
  * @return
@@ -1833,6 +2573,27 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmIntrospectGetHostengineCpuUtilization(dcgmHandl
                                                                        dcgmIntrospectCpuUtil_t *cpuUtil,
                                                                        int waitIfNoData);
 
+/*************************************************************************/
+/**
+ * Retrieve the CPU utilization of each thread of the DCGM hostengine process, like the cache manager,
+ * IPC, worker and module threads. Threads are read from /proc/self/task of the hostengine.
+ *
+ * @param pDcgmHandle        IN: DCGM Handle
+ * @param cpuUtil        IN/OUT: see \ref dcgmIntrospectThreadCpuUtil_t. cpuUtil->version must be set to
+ *                               dcgmIntrospectThreadCpuUtil_version prior to this call.
+ * @param waitIfNoData       IN: if no metadata is gathered wait till this occurs (!0) or return DCGM_ST_NO_DATA (0)
+ *
+ * @return
+ *       - \ref DCGM_ST_OK                   if the call was successful
+ *       - \ref DCGM_ST_NOT_CONFIGURED       if metadata gathering state is \a DCGM_INTROSPECT_STATE_DISABLED
+ *       - \ref DCGM_ST_NO_DATA              if \a waitIfNoData is false and metadata has not been gathered yet
+ *       - \ref DCGM_ST_VER_MISMATCH         if cpuUtil->version is 0 or invalid.
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmIntrospectGetHostengineThreadCpuUtilization(dcgmHandle_t pDcgmHandle,
+                                                                             dcgmIntrospectThreadCpuUtil_t *cpuUtil,
+                                                                             int waitIfNoData);
+
 /*************************************************************************/
 /**
  * This method is used to manually tell the the introspection module to update
@@ -1849,6 +2610,79 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmIntrospectGetHostengineCpuUtilization(dcgmHandl
  */
 dcgmReturn_t DCGM_PUBLIC_API dcgmIntrospectUpdateAll(dcgmHandle_t pDcgmHandle, int waitForUpdate);
 
+/*************************************************************************/
+/**
+ * Get the count, queue wait, processing time and reply size of each type of request that clients sent the host
+ * engine since it started. Requests made by embedded clients aren't counted.
+ *
+ * @param pDcgmHandle        IN: DCGM Handle
+ * @param requestStats   IN/OUT: see \ref dcgmIntrospectRequestStats_t. requestStats->version must be set to
+ *                               dcgmIntrospectRequestStats_version and requestStats->flags to
+ *                               DCGM_INTROSPECT_REQUEST_STATS_* flags prior to this call.
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if \a requestStats is NULL
+ *        - \ref DCGM_ST_VER_MISMATCH         if requestStats->version is 0 or invalid.
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmIntrospectGetRequestStats(dcgmHandle_t pDcgmHandle,
+                                                           dcgmIntrospectRequestStats_t *requestStats);
+
+/*************************************************************************/
+/**
+ * Get the memory of the host engine by the subsystem and module it is charged to, and the cache and send queue
+ * memory of each watcher, so that memory growth can be charged to the client that caused it.
+ *
+ * The cache, IPC send queues and IPC buffer pool are measured when this is called. Protobuf requests and module
+ * commands are charged while they are processed, so their high-water marks are reported too. Memory a module
+ * allocates for its own state isn't charged to it.
+ *
+ * @param pDcgmHandle        IN: DCGM Handle
+ * @param accounting     IN/OUT: see \ref dcgmIntrospectMemoryAccounting_t. accounting->version must be set to
+ *                               dcgmIntrospectMemoryAccounting_version prior to this call.
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if \a accounting is NULL
+ *        - \ref DCGM_ST_VER_MISMATCH         if accounting->version is 0 or invalid.
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmIntrospectGetMemoryAccounting(dcgmHandle_t pDcgmHandle,
+                                                               dcgmIntrospectMemoryAccounting_t *accounting);
+
+/*************************************************************************/
+/**
+ * Predict what watching a field group on a group with 
+ef dcgmWatchFields would cost the host engine before
+ * making the watch: the CPU time and driver calls per second of updating its fields and the cache memory of the
+ * samples kept. Both the cost of the watch on its own and what it would add to the watches already active are
+ * reported, since fields that are already watched only cost more if the new watch is faster or keeps more.
+ *
+ * The prediction uses the exec time measured for each field and entity. Fields that haven't been fetched yet are
+ * estimated from the same field on other entities, then from fields fetched the same way. Fields that share
+ * driver calls, like those read with one nvmlDeviceGetFieldValues() per GPU, are charged a share of those calls.
+ * Cache bytes are of uncompressed samples and leave out rollups. Profiling fields are estimated like other fields
+ * even though the profiling module fetches them.
+ *
+ * @param pDcgmHandle        IN: DCGM Handle
+ * @param cost           IN/OUT: see 
+ef dcgmIntrospectWatchCost_t. cost->version must be set to
+ *                               dcgmIntrospectWatchCost_version prior to this call. Set groupId, fieldGroupId,
+ *                               updateFreq, maxKeepAge and maxKeepSamples as they would be passed to
+ *                               
+ef dcgmWatchFields.
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if \a cost is NULL or cost->updateFreq isn't positive
+ *        - \ref DCGM_ST_VER_MISMATCH         if cost->version is 0 or invalid.
+ *        - \ref DCGM_ST_NOT_CONFIGURED       if cost->groupId doesn't exist
+ *        - \ref DCGM_ST_NO_DATA              if cost->fieldGroupId doesn't exist
+ *
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmIntrospectEstimateWatchCost(dcgmHandle_t pDcgmHandle, dcgmIntrospectWatchCost_t *cost);
+
 /** @} */ // Closing for DCGMAPI_METADATA
 
 /***************************************************************************************************/
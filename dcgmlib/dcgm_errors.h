@@ -111,7 +111,8 @@ typedef enum dcgmError_enum
     DCGM_FR_DBE_PENDING_PAGE_RETIREMENTS = 83, //!< Pending page retirements due to a DBE
     DCGM_FR_UNCORRECTABLE_ROW_REMAP      = 84, //!< Uncorrectable row remapping
     DCGM_FR_PENDING_ROW_REMAP            = 85, //!< Row remapping is pending
-    DCGM_FR_ERROR_SENTINEL               = 86, //!< MUST BE THE LAST ERROR CODE
+    DCGM_FR_FIELD_ANOMALY                = 86, //!< A field drifted away from its usual level
+    DCGM_FR_ERROR_SENTINEL               = 87, //!< MUST BE THE LAST ERROR CODE
 } dcgmError_t;
 
 typedef enum dcgmErrorSeverity_enum
@@ -340,6 +341,7 @@ extern dcgm_error_meta_t dcgmErrorMeta[];
 #define DCGM_FR_DBE_PENDING_PAGE_RETIREMENTS_MSG "Pending page retirements together with a DBE were detected on GPU %u."
 #define DCGM_FR_UNCORRECTABLE_ROW_REMAP_MSG      "GPU %u had uncorrectable memory errors and %u rows were remapped"
 #define DCGM_FR_PENDING_ROW_REMAP_MSG            "GPU %u has uncorrectable memory errors and row remappings are pending"
+#define DCGM_FR_FIELD_ANOMALY_MSG                "The %s of GPU %u has %s from a baseline of %.1f to %.1f."
 
 /*
  * Suggestions for next steps for the corresponding error message
@@ -469,6 +471,7 @@ extern dcgm_error_meta_t dcgmErrorMeta[];
 #define DCGM_FR_EMPTY_GPU_LIST_NEXT               ""
 #define DCGM_FR_UNCORRECTABLE_ROW_REMAP_NEXT      ""
 #define DCGM_FR_PENDING_ROW_REMAP_NEXT            ""
+#define DCGM_FR_FIELD_ANOMALY_NEXT                "Check the GPU cooling and workload. " TRIAGE_RUN_FIELD_DIAG_MSG
 
 #ifdef __cplusplus
 extern "C" {
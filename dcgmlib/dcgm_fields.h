@@ -234,6 +234,36 @@ typedef unsigned int dcgm_field_eid_t;
  */
 #define DCGM_FI_CUDA_DRIVER_VERSION 5
 
+/**
+ * How long the most recent update cycle of the hostengine's field cache took in usec
+ */
+#define DCGM_FI_HOSTENGINE_UPDATE_LOOP_USEC 20
+
+/**
+ * Number of update cycles of the hostengine's field cache that ran long enough to leave no time to sleep before
+ * the next one
+ */
+#define DCGM_FI_HOSTENGINE_UPDATE_OVERRUNS 21
+
+/**
+ * How long the most recent update cycle spent passing new values to subscribers in usec
+ */
+#define DCGM_FI_HOSTENGINE_SUBSCRIBER_CALLBACK_USEC 22
+
+/**
+ * Number of client requests waiting for a hostengine worker
+ */
+#define DCGM_FI_HOSTENGINE_IPC_QUEUE_DEPTH 23
+
+/**
+ * Number of open connections of the hostengine
+ */
+#define DCGM_FI_HOSTENGINE_CONNECTIONS 24
+
+/**
+ * Bytes of samples held by the hostengine's field cache
+ */
+#define DCGM_FI_HOSTENGINE_CACHE_BYTES 25
 
 /**
  * Name of the GPU device
@@ -684,6 +714,50 @@ typedef unsigned int dcgm_field_eid_t;
  */
 #define DCGM_FI_DEV_FB_USED 252
 
+/**
+ * Rate of DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION in W (mJ/ms), averaged since its previous sample
+ *
+ * This and the other *_RATE fields are derived by the host engine from each new sample of their counter field,
+ * which is watched on their behalf at their frequency. They cost no driver calls of their own. A counter that
+ * goes backwards is taken to have been reset to 0, so its rate over that interval is the new value
+ */
+#define DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION_RATE 270
+
+/**
+ * Rate of DCGM_FI_DEV_PCIE_REPLAY_COUNTER in replays per second
+ */
+#define DCGM_FI_DEV_PCIE_REPLAY_RATE 271
+
+/**
+ * Rate of DCGM_FI_DEV_ECC_SBE_AGG_TOTAL in errors per second
+ */
+#define DCGM_FI_DEV_ECC_SBE_AGG_RATE 272
+
+/**
+ * Rate of DCGM_FI_DEV_ECC_DBE_AGG_TOTAL in errors per second
+ */
+#define DCGM_FI_DEV_ECC_DBE_AGG_RATE 273
+
+/**
+ * Rate of DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_COUNT_TOTAL in errors per second
+ */
+#define DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_RATE_TOTAL 274
+
+/**
+ * Rate of DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_COUNT_TOTAL in errors per second
+ */
+#define DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_RATE_TOTAL 275
+
+/**
+ * Rate of DCGM_FI_DEV_NVLINK_REPLAY_ERROR_COUNT_TOTAL in errors per second
+ */
+#define DCGM_FI_DEV_NVLINK_REPLAY_ERROR_RATE_TOTAL 276
+
+/**
+ * Rate of DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_COUNT_TOTAL in errors per second
+ */
+#define DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_RATE_TOTAL 277
+
 /**
  * Current ECC mode for the device
  */
@@ -2065,6 +2139,24 @@ typedef unsigned int dcgm_field_eid_t;
  */
 #define DCGM_FI_MAX_NVSWITCH_FIELDS DCGM_FI_LAST_NVSWITCH_FIELD_ID - DCGM_FI_FIRST_NVSWITCH_FIELD_ID + 1
 
+/**
+ * Derived fields. Each of these is defined at runtime with dcgmSetDerivedField() as an expression over other
+ * fields of the same entity, like "power_usage / enforced_power_limit * 100". The host engine evaluates it whenever
+ * those fields update. The values are doubles and are watched and read like any other field. A derived field has
+ * no values until it is defined.
+ */
+#define DCGM_FI_FIRST_DERIVED_FIELD_ID 900
+
+/**
+ * Last derived field ID
+ */
+#define DCGM_FI_LAST_DERIVED_FIELD_ID 915
+
+/**
+ * Number of derived field IDs
+ */
+#define DCGM_FI_MAX_DERIVED_FIELDS (DCGM_FI_LAST_DERIVED_FIELD_ID - DCGM_FI_FIRST_DERIVED_FIELD_ID + 1)
+
 /**
  * Profiling Fields. These all start with DCGM_FI_PROF_*
  */
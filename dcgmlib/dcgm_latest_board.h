@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGM_LATEST_BOARD_H
+#define DCGM_LATEST_BOARD_H
+
+/*
+ * Reader of the latest value board, a read-only POSIX shared memory segment the
+ * host engine keeps the latest value of some fields of every GPU in (see
+ * nv-hostengine --latest-board). Reading it takes no request to the host
+ * engine and doesn't need libdcgm, so local agents can poll it as often as
+ * they like at no cost to the host engine.
+ *
+ * This header is all there is to the reader. Link with -lrt on older glibc.
+ *
+ *     dcgmLatestBoard_t board;
+ *     if (dcgmLatestBoardOpen(DCGM_LATEST_BOARD_DEFAULT_NAME, &board) == 0)
+ *     {
+ *         dcgmLatestBoardValue_t value;
+ *         int index = dcgmLatestBoardFind(&board, DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP);
+ *         if (index >= 0 && dcgmLatestBoardRead(&board, index, &value) == 0 && value.status == DCGM_ST_OK)
+ *             printf("%lld\n", (long long)value.value.i64);
+ *         dcgmLatestBoardClose(&board);
+ *     }
+ *
+ * Each entry is guarded by a sequence counter that is odd while the host
+ * engine writes it. dcgmLatestBoardRead() copies an entry until it gets a
+ * copy that no write overlapped.
+ */
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DCGM_LATEST_BOARD_MAGIC        0x4243564cU /* "LVCB" */
+#define DCGM_LATEST_BOARD_VERSION      1
+#define DCGM_LATEST_BOARD_DEFAULT_NAME "/nvidia-dcgm-latest"
+
+/* Times dcgmLatestBoardRead() retries an entry that keeps being written before giving up */
+#define DCGM_LATEST_BOARD_MAX_READ_TRIES 1000
+
+/* Start of the segment. The entries follow it */
+typedef struct
+{
+    uint32_t magic;          /* DCGM_LATEST_BOARD_MAGIC once the segment is ready to read */
+    uint32_t version;        /* DCGM_LATEST_BOARD_VERSION */
+    uint32_t numEntries;     /* Entries after the header */
+    uint32_t entrySize;      /* sizeof(dcgmLatestBoardEntry_t) of the host engine */
+    uint32_t closed;         /* Set when the host engine stops updating the segment */
+    uint32_t writerPid;      /* Process ID of the host engine */
+    uint64_t updateFreqUsec; /* How often the fields are sampled */
+    uint64_t publishCount;   /* Number of times the host engine wrote values. Only grows */
+    uint64_t publishUsec;    /* When the host engine last looked for new values, in usec since 1970 */
+} dcgmLatestBoardHeader_t;
+
+/* One field of one entity. Entries are sorted by entityGroupId, entityId and fieldId */
+typedef struct
+{
+    uint32_t sequence;      /* Odd while the entry is being written */
+    uint32_t entityGroupId; /* dcgm_field_entity_group_t */
+    uint32_t entityId;
+    uint16_t fieldId;
+    uint8_t fieldType;     /* DCGM_FT_INT64 ('i') or DCGM_FT_DOUBLE ('d') */
+    uint8_t reserved;
+    int32_t status;        /* dcgmReturn_t of reading the value. DCGM_ST_NO_DATA until there is one */
+    uint32_t reserved2;
+    int64_t timestamp;     /* Of the value, in usec since 1970 */
+    union
+    {
+        int64_t i64;
+        double dbl;
+    } value;
+} dcgmLatestBoardEntry_t;
+
+/* An open board */
+typedef struct
+{
+    void *mapping;
+    size_t size;
+    dcgmLatestBoardHeader_t const *header;
+    dcgmLatestBoardEntry_t const *entries;
+} dcgmLatestBoard_t;
+
+/* A consistent copy of an entry */
+typedef struct
+{
+    uint32_t entityGroupId;
+    uint32_t entityId;
+    uint16_t fieldId;
+    uint8_t fieldType;
+    int32_t status;
+    int64_t timestamp;
+    union
+    {
+        int64_t i64;
+        double dbl;
+    } value;
+} dcgmLatestBoardValue_t;
+
+/*****************************************************************************/
+/*
+ * Map the board the host engine published as name, like
+ * DCGM_LATEST_BOARD_DEFAULT_NAME
+ *
+ * Returns 0 on success
+ *        -1 if there is no such board or it isn't ready or of another version
+ */
+static inline int dcgmLatestBoardOpen(char const *name, dcgmLatestBoard_t *board)
+{
+    struct stat st;
+    void *mapping;
+    dcgmLatestBoardHeader_t const *header;
+    int fd;
+
+    memset(board, 0, sizeof(*board));
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(dcgmLatestBoardHeader_t))
+    {
+        close(fd);
+        return -1;
+    }
+
+    mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return -1;
+
+    header = (dcgmLatestBoardHeader_t const *)mapping;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != DCGM_LATEST_BOARD_MAGIC
+        || header->version != DCGM_LATEST_BOARD_VERSION || header->entrySize != sizeof(dcgmLatestBoardEntry_t)
+        || sizeof(*header) + (size_t)header->numEntries * header->entrySize > (size_t)st.st_size)
+    {
+        munmap(mapping, (size_t)st.st_size);
+        return -1;
+    }
+
+    board->mapping = mapping;
+    board->size    = (size_t)st.st_size;
+    board->header  = header;
+    board->entries = (dcgmLatestBoardEntry_t const *)(header + 1);
+    return 0;
+}
+
+/*****************************************************************************/
+/* Unmap a board dcgmLatestBoardOpen() opened */
+static inline void dcgmLatestBoardClose(dcgmLatestBoard_t *board)
+{
+    if (board->mapping != NULL)
+        munmap(board->mapping, board->size);
+    memset(board, 0, sizeof(*board));
+}
+
+/*****************************************************************************/
+/*
+ * Is the host engine that wrote the board done with it? A restarted host
+ * engine publishes a new board under the same name, so reopen it then
+ */
+static inline int dcgmLatestBoardIsClosed(dcgmLatestBoard_t const *board)
+{
+    return __atomic_load_n(&board->header->closed, __ATOMIC_ACQUIRE) != 0;
+}
+
+/*****************************************************************************/
+/*
+ * Find the entry of a field of an entity. The entries don't move, so the
+ * index can be kept for as long as the board is open
+ *
+ * Returns the index of the entry or -1 if the board doesn't have it
+ */
+static inline int dcgmLatestBoardFind(dcgmLatestBoard_t const *board,
+                                      uint32_t entityGroupId,
+                                      uint32_t entityId,
+                                      uint16_t fieldId)
+{
+    int low  = 0;
+    int high = (int)board->header->numEntries - 1;
+
+    while (low <= high)
+    {
+        int mid                             = low + (high - low) / 2;
+        dcgmLatestBoardEntry_t const *entry = &board->entries[mid];
+        int cmp                             = 0;
+
+        if (entry->entityGroupId != entityGroupId)
+            cmp = entry->entityGroupId < entityGroupId ? -1 : 1;
+        else if (entry->entityId != entityId)
+            cmp = entry->entityId < entityId ? -1 : 1;
+        else if (entry->fieldId != fieldId)
+            cmp = entry->fieldId < fieldId ? -1 : 1;
+
+        if (cmp == 0)
+            return mid;
+        if (cmp < 0)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+
+    return -1;
+}
+
+/*****************************************************************************/
+/*
+ * Copy the entry at index, which dcgmLatestBoardFind() returned
+ *
+ * Returns 0 on success
+ *        -1 if index is out of range or the entry kept being written
+ */
+static inline int dcgmLatestBoardRead(dcgmLatestBoard_t const *board, int index, dcgmLatestBoardValue_t *value)
+{
+    dcgmLatestBoardEntry_t const *entry;
+    int tries;
+
+    if (index < 0 || (uint32_t)index >= board->header->numEntries)
+        return -1;
+    entry = &board->entries[index];
+
+    for (tries = 0; tries < DCGM_LATEST_BOARD_MAX_READ_TRIES; tries++)
+    {
+        uint32_t before = __atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1)
+            continue;
+
+        value->entityGroupId = entry->entityGroupId;
+        value->entityId      = entry->entityId;
+        value->fieldId       = entry->fieldId;
+        value->fieldType     = entry->fieldType;
+        value->status        = __atomic_load_n(&entry->status, __ATOMIC_RELAXED);
+        value->timestamp     = __atomic_load_n(&entry->timestamp, __ATOMIC_RELAXED);
+        value->value.i64     = __atomic_load_n(&entry->value.i64, __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&entry->sequence, __ATOMIC_RELAXED) == before)
+            return 0;
+    }
+
+    return -1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DCGM_LATEST_BOARD_H */
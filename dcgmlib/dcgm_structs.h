@@ -259,6 +259,27 @@ typedef enum dcgmOrder_enum
     DCGM_ORDER_DESCENDING = 2  //!< Data with latest (highest) timestamps returned first
 } dcgmOrder_t;
 
+/**
+ * Opaque position in the cached values of one field of one entity, for reading them in pages.
+ * Zero it to start from the oldest value. See \ref dcgmEntityGetValuesPage
+ */
+typedef struct
+{
+    long long opaque[2]; //!< Don't interpret or change
+} dcgmValuesCursor_t;
+
+/**
+ * How the samples of each bucket are combined by \ref dcgmGetValuesSinceBucketed
+ */
+typedef enum dcgmBucketAggregation_enum
+{
+    DCGM_BUCKET_AGG_MIN   = 1, //!< Smallest sample. Same type as the field
+    DCGM_BUCKET_AGG_MAX   = 2, //!< Largest sample. Same type as the field
+    DCGM_BUCKET_AGG_AVG   = 3, //!< Average of the samples. Always DCGM_FT_DOUBLE
+    DCGM_BUCKET_AGG_LAST  = 4, //!< Latest sample. Same type as the field
+    DCGM_BUCKET_AGG_COUNT = 5  //!< Number of samples. Always DCGM_FT_INT64
+} dcgmBucketAggregation_t;
+
 /**
  * Return values for DCGM API calls.
  */
@@ -454,19 +475,159 @@ typedef struct
 } dcgmConnectV2Params_v2;
 
 /**
- * Typedef for \ref dcgmConnectV2Params_v2
+ * Version 2 for \ref dcgmConnectV2Params_v2
  */
-typedef dcgmConnectV2Params_v2 dcgmConnectV2Params_t;
+#define dcgmConnectV2Params_version2 MAKE_DCGM_VERSION(dcgmConnectV2Params_v2, 2)
 
 /**
- * Version 2 for \ref dcgmConnectV2Params_v2
+ * Connection options for dcgmConnect_v2 (v3)
  */
-#define dcgmConnectV2Params_version2 MAKE_DCGM_VERSION(dcgmConnectV2Params_v2, 2)
+typedef struct
+{
+    unsigned int version;                /*!< Version number. Use dcgmConnectV2Params_version */
+    unsigned int persistAfterDisconnect; /*!< Whether to persist DCGM state modified by this connection once the
+                                              connection is terminated. Normally, all field watches created by a
+                                              connection are removed once a connection goes away. 1 = do not clean up
+                                              after this connection. 0 = clean up after this connection */
+    unsigned int timeoutMs;              /*!< When attempting to connect to the specified host engine, how long should
+                                              we wait in milliseconds before giving up */
+    unsigned int addressIsUnixSocket;    /*!< Whether or not the passed-in address is a unix socket filename (1) or a
+                                              TCP/IP address (0) */
+    unsigned int useSharedMemory;        /*!< Only used if addressIsUnixSocket is 1. Whether to exchange requests and
+                                              responses with the host engine through shared memory (1) rather than
+                                              the unix socket (0). Falls back to the unix socket if the host engine
+                                              doesn't support it */
+} dcgmConnectV2Params_v3;
+
+/**
+ * Version 3 for \ref dcgmConnectV2Params_v3
+ */
+#define dcgmConnectV2Params_version3 MAKE_DCGM_VERSION(dcgmConnectV2Params_v3, 3)
+
+/**
+ * Compression of the messages of a TCP/IP connection to the host engine
+ */
+#define DCGM_TRANSPORT_COMPRESSION_NONE 0 /*!< Messages are sent as they are */
+#define DCGM_TRANSPORT_COMPRESSION_ZLIB 1 /*!< Messages are deflated with zlib */
+
+/**
+ * Connection options for dcgmConnect_v2 (v4)
+ */
+typedef struct
+{
+    unsigned int version;                /*!< Version number. Use dcgmConnectV2Params_version */
+    unsigned int persistAfterDisconnect; /*!< Whether to persist DCGM state modified by this connection once the
+                                              connection is terminated. Normally, all field watches created by a
+                                              connection are removed once a connection goes away. 1 = do not clean up
+                                              after this connection. 0 = clean up after this connection */
+    unsigned int timeoutMs;              /*!< When attempting to connect to the specified host engine, how long should
+                                              we wait in milliseconds before giving up */
+    unsigned int addressIsUnixSocket;    /*!< Whether or not the passed-in address is a unix socket filename (1) or a
+                                              TCP/IP address (0) */
+    unsigned int useSharedMemory;        /*!< Only used if addressIsUnixSocket is 1. Whether to exchange requests and
+                                              responses with the host engine through shared memory (1) rather than
+                                              the unix socket (0). Falls back to the unix socket if the host engine
+                                              doesn't support it */
+    unsigned int compression;            /*!< Only used if addressIsUnixSocket is 0. DCGM_TRANSPORT_COMPRESSION_? to
+                                              compress messages in both directions with. Falls back to
+                                              DCGM_TRANSPORT_COMPRESSION_NONE if the host engine doesn't support it */
+    unsigned int compressionThreshold;   /*!< Messages with fewer bytes than this are sent uncompressed.
+                                              0 = the host engine's default */
+} dcgmConnectV2Params_v4;
+
+/**
+ * Typedef for \ref dcgmConnectV2Params_v4
+ */
+typedef dcgmConnectV2Params_v4 dcgmConnectV2Params_t;
+
+/**
+ * Version 4 for \ref dcgmConnectV2Params_v4
+ */
+#define dcgmConnectV2Params_version4 MAKE_DCGM_VERSION(dcgmConnectV2Params_v4, 4)
 
 /**
  * Latest version for \ref dcgmConnectV2Params_t
  */
-#define dcgmConnectV2Params_version dcgmConnectV2Params_version2
+#define dcgmConnectV2Params_version dcgmConnectV2Params_version4
+
+/**
+ * Traffic of one side of a connection to the host engine. Only messages sent over the socket are
+ * counted. Messages of a connection that moved to shared memory aren't
+ */
+typedef struct
+{
+    unsigned long long messagesSent;              /*!< Messages written to the socket */
+    unsigned long long messagesSentCompressed;    /*!< How many of messagesSent were compressed */
+    unsigned long long bytesSent;                 /*!< Bytes written to the socket, message headers included */
+    unsigned long long uncompressedBytesSent;     /*!< Bytes that would have been written without compression */
+    unsigned long long messagesReceived;          /*!< Messages read from the socket */
+    unsigned long long bytesReceived;             /*!< Bytes read from the socket, message headers included */
+    unsigned long long uncompressedBytesReceived; /*!< Bytes received once decompressed */
+    unsigned long long compressUsec;              /*!< CPU time spent compressing messages in usec */
+    unsigned long long decompressUsec;            /*!< CPU time spent decompressing messages in usec */
+} dcgmTransportCounters_t;
+
+/**
+ * Traffic of a connection to the host engine, as counted by both sides
+ */
+typedef struct
+{
+    unsigned int version;              /*!< Version number. Use dcgmTransportStats_version */
+    unsigned int compression;          /*!< DCGM_TRANSPORT_COMPRESSION_? this client sends messages with */
+    unsigned int compressionThreshold; /*!< Messages with fewer bytes than this are sent uncompressed */
+    unsigned int unused;               /*!< Unused. Aligns the counters */
+    dcgmTransportCounters_t client;     /*!< Counted by this process */
+    dcgmTransportCounters_t hostEngine; /*!< Counted by the host engine for this connection */
+} dcgmTransportStats_v1;
+
+/**
+ * Version 1 for \ref dcgmTransportStats_v1
+ */
+#define dcgmTransportStats_version1 MAKE_DCGM_VERSION(dcgmTransportStats_v1, 1)
+
+/**
+ * Messages one side of a connection is waiting to write to the socket. Once the peer falls far enough behind,
+ * further messages are held back and the side's slow consumer policy decides what happens to them
+ */
+typedef struct
+{
+    unsigned long long queuedBytes;       /*!< Bytes waiting to be written right now, held messages included */
+    unsigned long long maxQueuedBytes;    /*!< Most bytes that have waited to be written at once */
+    unsigned long long heldMessages;      /*!< Messages held back right now */
+    unsigned long long highWatermarkHits; /*!< Times the peer fell far enough behind for messages to be held back */
+    unsigned long long messagesDropped;   /*!< Held notifications that were dropped to make room */
+    unsigned long long messagesCoalesced; /*!< Held notifications replaced by a newer one for the same request */
+} dcgmSendQueueStats_t;
+
+/**
+ * Traffic of a connection to the host engine and the messages waiting to be sent over it, as counted by both sides
+ */
+typedef struct
+{
+    unsigned int version;                     /*!< Version number. Use dcgmTransportStats_version */
+    unsigned int compression;                 /*!< DCGM_TRANSPORT_COMPRESSION_? this client sends messages with */
+    unsigned int compressionThreshold;        /*!< Messages with fewer bytes than this are sent uncompressed */
+    unsigned int unused;                      /*!< Unused. Aligns the counters */
+    dcgmTransportCounters_t client;           /*!< Counted by this process */
+    dcgmTransportCounters_t hostEngine;       /*!< Counted by the host engine for this connection */
+    dcgmSendQueueStats_t clientSendQueue;     /*!< Messages this process is waiting to send */
+    dcgmSendQueueStats_t hostEngineSendQueue; /*!< Messages the host engine is waiting to send to this process */
+} dcgmTransportStats_v2;
+
+/**
+ * Typedef for \ref dcgmTransportStats_v2
+ */
+typedef dcgmTransportStats_v2 dcgmTransportStats_t;
+
+/**
+ * Version 2 for \ref dcgmTransportStats_v2
+ */
+#define dcgmTransportStats_version2 MAKE_DCGM_VERSION(dcgmTransportStats_v2, 2)
+
+/**
+ * Latest version for \ref dcgmTransportStats_t
+ */
+#define dcgmTransportStats_version dcgmTransportStats_version2
 
 /**
  * Typedef for \ref dcgmHostengineHealth_v1
@@ -493,6 +654,58 @@ typedef dcgmHostengineHealth_v1 dcgmHostengineHealth_t;
  */
 #define dcgmHostengineHealth_version dcgmHostengineHealth_version1
 
+/**
+ * Most request lanes \ref dcgmHostengineWorkerStats_v1 reports
+ */
+#define DCGM_MAX_WORKER_LANES 8
+
+/**
+ * Worker threads of one of the host engine's request lanes. Each lane grows while requests wait for a busy worker
+ * and shrinks back to its minimum when idle
+ */
+typedef struct
+{
+    unsigned int minWorkers;           //!< Workers the lane always keeps
+    unsigned int maxWorkers;           //!< Most workers the lane grows to
+    unsigned int numWorkers;           //!< Workers running right now
+    unsigned int busyWorkers;          //!< ... of which are processing a request
+    unsigned int peakWorkers;          //!< Most workers that ran at once
+    unsigned int queueDepth;           //!< Requests waiting for a worker right now
+    unsigned int maxQueueDepth;        //!< Most requests that waited at once
+    unsigned int unused;               //!< Unused. Aligns the counters
+    unsigned long long tasksProcessed; //!< Requests a worker picked up
+    unsigned long long totalWaitUsec;  //!< Time the tasksProcessed requests waited for a worker in usec
+    unsigned long long maxWaitUsec;    //!< Longest time a request waited for a worker in usec
+    unsigned long long workersStarted; //!< Workers started past minWorkers
+    unsigned long long workersStopped; //!< Workers stopped for being idle
+} dcgmWorkerLaneStats_t;
+
+/**
+ * Request lanes of the host engine, in order: cheap reads of cached state, everything else, and long-running
+ * requests like diagnostics
+ */
+typedef struct
+{
+    unsigned int version;                               //!< Version number. Use dcgmHostengineWorkerStats_version
+    unsigned int numLanes;                              //!< Populated entries of lanes. 0 = no remote clients served
+    dcgmWorkerLaneStats_t lanes[DCGM_MAX_WORKER_LANES]; //!< Each lane's workers
+} dcgmHostengineWorkerStats_v1;
+
+/**
+ * Typedef for \ref dcgmHostengineWorkerStats_v1
+ */
+typedef dcgmHostengineWorkerStats_v1 dcgmHostengineWorkerStats_t;
+
+/**
+ * Version 1 for \ref dcgmHostengineWorkerStats_v1
+ */
+#define dcgmHostengineWorkerStats_version1 MAKE_DCGM_VERSION(dcgmHostengineWorkerStats_v1, 1)
+
+/**
+ * Latest version for \ref dcgmHostengineWorkerStats_t
+ */
+#define dcgmHostengineWorkerStats_version dcgmHostengineWorkerStats_version1
+
 /**
  * Represents a entityGroupId + entityId pair to uniquely identify a given entityId inside a group of entities
  *
@@ -676,6 +889,43 @@ typedef dcgmAllFieldGroup_v1 dcgmAllFieldGroup_t;
  */
 #define dcgmAllFieldGroup_version dcgmAllFieldGroup_version1
 
+/**
+ * Size of \ref dcgmDerivedField_v1::expression, including the terminator
+ */
+#define DCGM_DERIVED_FIELD_EXPRESSION_SIZE 256
+
+/**
+ * Most fields one derived field's expression can refer to
+ */
+#define DCGM_DERIVED_FIELD_MAX_INPUTS 8
+
+/**
+ * Definition of a derived field. See dcgmSetDerivedField()
+ */
+typedef struct
+{
+    unsigned int version;   //!< IN: Version number. Use dcgmDerivedField_version
+    unsigned short fieldId; //!< IN: DCGM_FI_FIRST_DERIVED_FIELD_ID through DCGM_FI_LAST_DERIVED_FIELD_ID
+    unsigned short unused;  //!< Unused
+    char expression[DCGM_DERIVED_FIELD_EXPRESSION_SIZE]; //!< IN: Expression to evaluate. Empty = remove the definition
+    char error[DCGM_MAX_STR_LENGTH]; //!< OUT: Why the expression was rejected if DCGM_ST_BADPARAM is returned
+} dcgmDerivedField_v1;
+
+/**
+ * Typedef for \ref dcgmDerivedField_v1
+ */
+typedef dcgmDerivedField_v1 dcgmDerivedField_t;
+
+/**
+ * Version 1 for \ref dcgmDerivedField_v1
+ */
+#define dcgmDerivedField_version1 MAKE_DCGM_VERSION(dcgmDerivedField_v1, 1)
+
+/**
+ * Latest version for \ref dcgmDerivedField_t
+ */
+#define dcgmDerivedField_version dcgmDerivedField_version1
+
 /**
  * Structure to represent error attributes
  */
@@ -1558,6 +1808,61 @@ typedef dcgmPolicyCallbackResponse_v1 dcgmPolicyCallbackResponse_t;
  */
 #define dcgmPolicyCallbackResponse_version dcgmPolicyCallbackResponse_version1
 
+/**
+ * Structure given to the callback functions of registrations made with \ref dcgmPolicyRegister_v2. Violations
+ * of the same condition on the same GPU may be coalesced into one callback. The members up to \a val are the
+ * same as in \ref dcgmPolicyCallbackResponse_v1 and describe the latest of the coalesced violations
+ */
+typedef struct
+{
+    // version must always be first
+    unsigned int version; //!< version number (dcgmPolicyCallbackResponse_version2)
+
+    dcgmPolicyCondition_t condition; //!< Condition that was violated
+    union
+    {
+        dcgmPolicyConditionDbe_t dbe;         //!< ECC DBE return structure
+        dcgmPolicyConditionPci_t pci;         //!< PCI replay error return structure
+        dcgmPolicyConditionMpr_t mpr;         //!< Max retired pages limit return structure
+        dcgmPolicyConditionThermal_t thermal; //!< Thermal policy violations return structure
+        dcgmPolicyConditionPower_t power;     //!< Power policy violations return structure
+        dcgmPolicyConditionNvlink_t nvlink;   //!< Nvlink policy violations return structure
+        dcgmPolicyConditionXID_t xid;         //!< XID policy violations return structure
+    } val;
+
+    unsigned int numViolations; //!< How many violations this callback stands for. At least 1
+    long long firstTimestamp;   //!< Timestamp of the first of the violations in usec since 1970
+    long long lastTimestamp;    //!< Timestamp of the last of the violations in usec since 1970
+} dcgmPolicyCallbackResponse_v2;
+
+/**
+ * Version 2 for \ref dcgmPolicyCallbackResponse_v2
+ */
+#define dcgmPolicyCallbackResponse_version2 MAKE_DCGM_VERSION(dcgmPolicyCallbackResponse_v2, 2)
+
+/**
+ * Parameters of \ref dcgmPolicyRegister_v2
+ */
+typedef struct
+{
+    unsigned int version;            //!< Version number. Use dcgmPolicyRegisterParams_version1
+    dcgmGpuGrp_t groupId;            //!< Group to register for violations on. DCGM_GROUP_ALL_GPUS for all GPUs
+    dcgmPolicyCondition_t condition; //!< OR'd list of DCGM_POLICY_COND_* to register for
+    fpRecvUpdates beginCallback;     //!< Called with a \ref dcgmPolicyCallbackResponse_v2 when a violation occurs
+    fpRecvUpdates finishCallback;    //!< Called with the same response after beginCallback
+    long long coalesceWindowUsec;    //!< After a notification of a condition on a GPU, further violations of that
+                                     //!< condition on that GPU are folded into one notification that is sent once
+                                     //!< this long has passed. 0 = notify every violation
+    unsigned int maxNotificationsPerSec; //!< Cap on the notifications of this registration across all GPUs and
+                                         //!< conditions. Violations past the cap are folded into later
+                                         //!< notifications. 0 = no cap
+} dcgmPolicyRegisterParams_v1;
+
+/**
+ * Version 1 for \ref dcgmPolicyRegisterParams_v1
+ */
+#define dcgmPolicyRegisterParams_version1 MAKE_DCGM_VERSION(dcgmPolicyRegisterParams_v1, 1)
+
 /**
  * Set above size of largest blob entry. Currently this is dcgmDeviceVgpuTypeInfo_v1
  */
@@ -1617,6 +1922,124 @@ typedef struct
  */
 #define dcgmFieldValue_version2 MAKE_DCGM_VERSION(dcgmFieldValue_v2, 2)
 
+/**
+ * Most runs of contiguous values that a \ref dcgmValueView_v1 is split into
+ */
+#define DCGM_VALUE_VIEW_MAX_SPANS 2
+
+/**
+ * Run of values of a \ref dcgmValueView_v1 that are contiguous in the host engine's cache
+ */
+typedef struct
+{
+    long long const *timestamps; //!< Timestamp of each value in usec since 1970, in ascending order
+    void const *values;          //!< Array of long long for DCGM_FT_INT64 and DCGM_FT_TIMESTAMP fields or of double
+                                 //!< for DCGM_FT_DOUBLE fields
+    int count;                   //!< Number of values
+} dcgmValueSpan_t;
+
+/**
+ * Read-only view of the cached values of one numeric field of one entity, borrowed from the embedded host engine
+ * by \ref dcgmEmbeddedAcquireValueViews. The spans point into the cache itself, so they are only valid until
+ * \ref dcgmEmbeddedReleaseValueViews is called.
+ */
+typedef struct
+{
+    // version must always be first
+    unsigned int version;                    //!< IN: version number (dcgmValueView_version1)
+    dcgm_field_entity_group_t entityGroupId; //!< IN: Entity group of the entity to view values of
+    dcgm_field_eid_t entityId;               //!< IN: Entity to view values of
+    unsigned short fieldId;                  //!< IN: Field to view values of. Must be of type DCGM_FT_INT64,
+                                             //!<     DCGM_FT_TIMESTAMP or DCGM_FT_DOUBLE
+    unsigned short fieldType;                //!< OUT: DCGM_FT_? of the values
+    long long sinceTimestamp;                //!< IN: Only view values with a timestamp after this. 0 = all of them
+    int maxCount;                            //!< IN: Only view the newest maxCount of those values.
+                                             //!<     1 = just the latest value. 0 = no limit
+    int status;                              //!< OUT: DCGM_ST_OK or one of DCGM_ST_? if this view couldn't be filled
+    int olderValuesOmitted;                  //!< OUT: 1 if values that were asked for are only kept compressed,
+                                             //!<      so they aren't in spans. Read those with
+                                             //!<      \ref dcgmGetValuesSince instead
+    int numSpans;                            //!< OUT: Number of entries of spans in use. 0 = no values
+    dcgmValueSpan_t spans[DCGM_VALUE_VIEW_MAX_SPANS]; //!< OUT: The values in ascending time order
+} dcgmValueView_v1;
+
+/**
+ * Version 1 for \ref dcgmValueView_v1
+ */
+#define dcgmValueView_version1 MAKE_DCGM_VERSION(dcgmValueView_v1, 1)
+
+/**
+ * Latest version for \ref dcgmValueView_v1
+ */
+#define dcgmValueView_version dcgmValueView_version1
+
+/**
+ * Most cells of a \ref dcgmLatestValuesMatrix_v1
+ */
+#define DCGM_MATRIX_MAX_CELLS (DCGM_GROUP_MAX_ENTITIES * DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP)
+
+/**
+ * Bytes of the string section of a \ref dcgmLatestValuesMatrix_v1
+ */
+#define DCGM_MATRIX_STRINGS_SIZE 65536
+
+/**
+ * Status bits of a \ref dcgmLatestValuesMatrix_v1 cell. 0 = the cell holds its whole value
+ */
+#define DCGM_MATRIX_CELL_BLANK         0x01 //!< No value. The cell holds the blank value of its field type, like
+                                            //!< DCGM_INT64_BLANK, or an empty string. Set along with the bits
+                                            //!< below but DCGM_MATRIX_CELL_TRUNCATED, and for values the host
+                                            //!< engine recorded as blank
+#define DCGM_MATRIX_CELL_NOT_WATCHED   0x02 //!< The field isn't watched for the entity
+#define DCGM_MATRIX_CELL_NOT_SUPPORTED 0x04 //!< The field isn't supported for the entity
+#define DCGM_MATRIX_CELL_ERROR         0x08 //!< Another error kept the field from being read. DCGM_FT_BINARY
+                                            //!< fields always have this set
+#define DCGM_MATRIX_CELL_TRUNCATED     0x10 //!< The string was cut short because the string section was full
+
+/**
+ * Value of a \ref dcgmLatestValuesMatrix_v1 cell. Which member is set depends on the field type of the cell's column
+ */
+typedef union
+{
+    long long i64; //!< For DCGM_FT_INT64 and DCGM_FT_TIMESTAMP fields. The offset of the value in strings[] for
+                   //!< DCGM_FT_STRING fields. strings[0] is always an empty string
+    double dbl;    //!< For DCGM_FT_DOUBLE fields
+} dcgmMatrixValue_t;
+
+/**
+ * Latest values of a group of entities for a field group as a dense table, returned by
+ * \ref dcgmGetLatestValuesMatrix. Row r is entities[r] and column c is fieldIds[c], so the cell of both is at
+ * index r * numFields + c of values[], timestamps[] and status[]. A column only holds one field type, so a column
+ * can be read without looking at each cell's type.
+ */
+typedef struct
+{
+    // version must always be first
+    unsigned int version;                                         //!< IN: dcgmLatestValuesMatrix_version1
+    unsigned int numEntities;                                     //!< OUT: Number of rows
+    unsigned int numFields;                                       //!< OUT: Number of columns
+    unsigned int stringsSize;                                     //!< OUT: Bytes of strings[] in use
+    dcgmGroupEntityPair_t entities[DCGM_GROUP_MAX_ENTITIES];      //!< OUT: Entity of each row
+    unsigned short fieldIds[DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP];  //!< OUT: Field of each column
+    unsigned char fieldTypes[DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP]; //!< OUT: DCGM_FT_? of each column
+    dcgmMatrixValue_t values[DCGM_MATRIX_MAX_CELLS];              //!< OUT: Value of each cell
+    long long timestamps[DCGM_MATRIX_MAX_CELLS];                  //!< OUT: Timestamp of each value in usec since
+                                                                  //!<      1970. 0 if the cell has no value
+    unsigned char status[DCGM_MATRIX_MAX_CELLS];                  //!< OUT: DCGM_MATRIX_CELL_? bits of each cell
+    char strings[DCGM_MATRIX_STRINGS_SIZE];                       //!< OUT: Null-terminated values of the
+                                                                  //!<      DCGM_FT_STRING cells
+} dcgmLatestValuesMatrix_v1;
+
+/**
+ * Version 1 for \ref dcgmLatestValuesMatrix_v1
+ */
+#define dcgmLatestValuesMatrix_version1 MAKE_DCGM_VERSION(dcgmLatestValuesMatrix_v1, 1)
+
+/**
+ * Latest version for \ref dcgmLatestValuesMatrix_v1
+ */
+#define dcgmLatestValuesMatrix_version dcgmLatestValuesMatrix_version1
+
 /**
  * Field value flags used by \ref dcgmEntitiesGetLatestValues
  *
@@ -1670,6 +2093,128 @@ typedef int (*dcgmFieldValueEntityEnumeration_f)(dcgm_field_entity_group_t entit
                                                  int numValues,
                                                  void *userData);
 
+/**
+ * User callback function for the completion of an asynchronous request like \ref dcgmEntitiesGetLatestValuesAsync.
+ * It is invoked exactly once for each request that was started successfully.
+ *
+ * @param status               IN: What the synchronous version of the request would have returned. The request's
+ *                                 outputs are only valid when this is DCGM_ST_OK
+ * @param userData             IN: User data pointer passed to the function that started the request
+ *
+ */
+typedef void (*dcgmRequestComplete_f)(dcgmReturn_t status, void *userData);
+
+/**
+ * Default for \ref dcgmFieldValueStreamParams_v1::maxBatchesInFlight
+ */
+#define DCGM_FV_STREAM_DEFAULT_BATCHES_IN_FLIGHT 4
+
+/**
+ * Default for \ref dcgmFieldValueStreamParams_v1::maxPendingValues
+ */
+#define DCGM_FV_STREAM_DEFAULT_PENDING_VALUES 100000
+
+/**
+ * Parameters of \ref dcgmFieldValueStreamSubscribe
+ */
+typedef struct
+{
+    unsigned int version;            //!< Version number. Use dcgmFieldValueStreamParams_version
+    dcgmGpuGrp_t groupId;            //!< Group of entities to stream values of. Can be DCGM_GROUP_ALL_GPUS or
+                                     //!< DCGM_GROUP_ALL_NVSWITCHES
+    dcgmFieldGrp_t fieldGroupId;     //!< Fields to stream values of
+    long long updateFreq;            //!< How often to sample the fields in usec
+    double maxKeepAge;               //!< How long to keep the fields' samples in the cache in seconds. 0=no limit
+    int maxKeepSamples;              //!< How many of the fields' samples to keep in the cache. 0=no limit
+    unsigned int maxBatchesInFlight; //!< How many batches the host engine may send before the client has processed
+                                     //!< them. 0 = DCGM_FV_STREAM_DEFAULT_BATCHES_IN_FLIGHT
+    unsigned int maxPendingValues;   //!< How many values the host engine holds for a client that is behind before
+                                     //!< dropping new ones. 0 = DCGM_FV_STREAM_DEFAULT_PENDING_VALUES
+} dcgmFieldValueStreamParams_v1;
+
+/**
+ * Typedef for \ref dcgmFieldValueStreamParams_v1
+ */
+typedef dcgmFieldValueStreamParams_v1 dcgmFieldValueStreamParams_t;
+
+/**
+ * Version 1 for \ref dcgmFieldValueStreamParams_v1
+ */
+#define dcgmFieldValueStreamParams_version1 MAKE_DCGM_VERSION(dcgmFieldValueStreamParams_v1, 1)
+
+/**
+ * Latest version for \ref dcgmFieldValueStreamParams_t
+ */
+#define dcgmFieldValueStreamParams_version dcgmFieldValueStreamParams_version1
+
+/**
+ * Most host engines a proxy host engine collects from. See nv-hostengine --proxy-hosts
+ */
+#define DCGM_PROXY_MAX_HOSTS 128
+
+/**
+ * Callback for the values of a proxy stream. See \ref dcgmProxyStreamSubscribe
+ *
+ * @param hostId               IN: Index of the host engine the values came from in \ref dcgmProxyHosts_v1::hosts
+ * @param entityGroupId        IN: entityGroup of the entity the values belong to, on that host
+ * @param entityId             IN: Entity the values belong to, on that host
+ * @param values               IN: Field values. These values must be copied as they will be destroyed as soon as this
+ *                                 call returns.
+ * @param numValues            IN: Number of entries that are valid in values[]
+ * @param userData             IN: User data pointer passed to \ref dcgmProxyStreamSubscribe
+ *
+ * @returns
+ *          0 if OK
+ *         <0 to skip the rest of the batch
+ *
+ */
+typedef int (*dcgmProxyFieldValueEnumeration_f)(unsigned int hostId,
+                                                dcgm_field_entity_group_t entityGroupId,
+                                                dcgm_field_eid_t entityId,
+                                                dcgmFieldValue_v1 *values,
+                                                int numValues,
+                                                void *userData);
+
+/**
+ * State of one of the host engines a proxy host engine collects from
+ */
+typedef struct
+{
+    char address[DCGM_MAX_STR_LENGTH];   //!< Address of the host engine as given to nv-hostengine --proxy-hosts
+    unsigned int connected;              //!< Whether the proxy is connected to the host engine (1) or not (0)
+    unsigned int numConnects;            //!< How many times the proxy connected to the host engine
+    int lastStatus;                      //!< DCGM_ST_? of the last connection attempt or health check
+    long long nextConnectTime;           //!< When the proxy tries to connect again in usec since 1970.
+                                         //!< 0 while connected
+    unsigned long long valuesForwarded;  //!< Values received from the host engine and queued for clients
+    unsigned long long valuesDropped;    //!< Values dropped because clients fell behind
+} dcgmProxyHostStatus_v1;
+
+/**
+ * Host engines a proxy host engine collects from. See \ref dcgmProxyGetHosts
+ */
+typedef struct
+{
+    unsigned int version;                               //!< Version number. Use dcgmProxyHosts_version
+    unsigned int numHosts;                              //!< Number of entries in hosts[]. Indexes are hostIds
+    dcgmProxyHostStatus_v1 hosts[DCGM_PROXY_MAX_HOSTS]; //!< Host engines in the order they were given
+} dcgmProxyHosts_v1;
+
+/**
+ * Typedef for \ref dcgmProxyHosts_v1
+ */
+typedef dcgmProxyHosts_v1 dcgmProxyHosts_t;
+
+/**
+ * Version 1 for \ref dcgmProxyHosts_v1
+ */
+#define dcgmProxyHosts_version1 MAKE_DCGM_VERSION(dcgmProxyHosts_v1, 1)
+
+/**
+ * Latest version for \ref dcgmProxyHosts_t
+ */
+#define dcgmProxyHosts_version dcgmProxyHosts_version1
+
 
 /**
  * Summary of time series data in int64 format.
@@ -2004,6 +2549,60 @@ typedef dcgmJobInfo_v3 dcgmJobInfo_t;
  */
 #define dcgmJobInfo_version dcgmJobInfo_version3
 
+/**
+ * Percentiles of time series data in double-precision format. Each is an estimate within 1% of a value that was
+ * sampled, or blank if there were no samples. Check for blank with the DCGM_FP64_IS_BLANK() macro.
+ */
+typedef struct
+{
+    double p50; //!< Median of the samples looked at
+    double p95; //!< 95th percentile of the samples looked at
+    double p99; //!< 99th percentile of the samples looked at
+} dcgmStatPercentilesFp64_t;
+
+/**
+ * Percentiles of the gauges of dcgmGpuUsageInfo_t over a job on a GPU
+ */
+typedef struct
+{
+    unsigned int gpuId; //!< ID of the GPU this pertains to. GPU_ID_INVALID = summary information for multiple GPUs
+
+    dcgmStatPercentilesFp64_t powerUsage;        //!< Power usage in watts
+    dcgmStatPercentilesFp64_t pcieRxBandwidth;   //!< PCI-E bytes read from the GPU
+    dcgmStatPercentilesFp64_t pcieTxBandwidth;   //!< PCI-E bytes written to the GPU
+    dcgmStatPercentilesFp64_t smUtilization;     //!< GPU SM Utilization in percent
+    dcgmStatPercentilesFp64_t memoryUtilization; //!< GPU Memory Utilization in percent
+    dcgmStatPercentilesFp64_t memoryClock;       //!< Memory clock in MHz
+    dcgmStatPercentilesFp64_t smClock;           //!< SM clock in MHz
+} dcgmGpuUsagePercentiles_t;
+
+/**
+ * To store the percentiles of a job. Unlike the averages of \ref dcgmJobInfo_t, the summary percentiles are of the
+ * samples of all GPUs together rather than of the per-GPU values
+ */
+typedef struct
+{
+    unsigned int version;                                 //!< Version of this message (dcgmJobPercentiles_version)
+    int numGpus;                                          //!< Number of GPUs that are valid in gpus[]
+    dcgmGpuUsagePercentiles_t summary;                    //!< Percentiles of all GPUs listed in gpus[]
+    dcgmGpuUsagePercentiles_t gpus[DCGM_MAX_NUM_DEVICES]; //!< Per-GPU percentiles
+} dcgmJobPercentiles_v1;
+
+/**
+ * Typedef for \ref dcgmJobPercentiles_v1
+ */
+typedef dcgmJobPercentiles_v1 dcgmJobPercentiles_t;
+
+/**
+ * Version 1 for \ref dcgmJobPercentiles_v1
+ */
+#define dcgmJobPercentiles_version1 MAKE_DCGM_VERSION(dcgmJobPercentiles_v1, 1)
+
+/**
+ * Latest version for \ref dcgmJobPercentiles_t
+ */
+#define dcgmJobPercentiles_version dcgmJobPercentiles_version1
+
 
 /**
  * Running process information for a compute or graphics process
@@ -2313,6 +2912,77 @@ typedef dcgmIntrospectContext_v1 dcgmIntrospectContext_t;
  */
 #define dcgmIntrospectContext_version dcgmIntrospectContext_version1
 
+/**
+ * DCGM Execution time info for a set of fields, without the maximum and the histograms of
+ * \ref dcgmIntrospectFieldsExecTime_t
+ */
+typedef struct
+{
+    unsigned int version; //!< version number (dcgmIntrospectFieldsExecTime_version1)
+
+    long long meanUpdateFreqUsec; //!< the mean update frequency of all fields
+
+    double recentUpdateUsec; //!< the sum of every field's most recent execution time after they
+                             //!< have been normalized to \ref meanUpdateFreqUsec".
+                             //!< This is roughly how long it takes to update fields every \ref meanUpdateFreqUsec
+
+    long long totalEverUpdateUsec; //!< The total amount of time, ever, that has been spent updating all the fields
+} dcgmIntrospectFieldsExecTime_v1;
+
+/**
+ * Version 1 for \ref dcgmIntrospectFieldsExecTime_v1
+ */
+#define dcgmIntrospectFieldsExecTime_version1 MAKE_DCGM_VERSION(dcgmIntrospectFieldsExecTime_v1, 1)
+
+/**
+ * Number of buckets in the histograms of \ref dcgmIntrospectFieldsExecTime_t
+ */
+#define DCGM_INTROSPECT_EXEC_TIME_BUCKETS 20
+
+/**
+ * DCGM Execution time info for a set of fields, without the sample age histograms of
+ * \ref dcgmIntrospectFieldsExecTime_t
+ */
+typedef struct
+{
+    unsigned int version; //!< version number (dcgmIntrospectFieldsExecTime_version2)
+
+    long long meanUpdateFreqUsec; //!< the mean update frequency of all fields
+
+    double recentUpdateUsec; //!< the sum of every field's most recent execution time after they
+                             //!< have been normalized to \ref meanUpdateFreqUsec".
+                             //!< This is roughly how long it takes to update fields every \ref meanUpdateFreqUsec
+
+    long long totalEverUpdateUsec; //!< The total amount of time, ever, that has been spent updating all the fields
+
+    long long maxUpdateUsec; //!< The longest that a single update of any of the fields has ever taken
+
+    long long updateUsecHistogram[DCGM_INTROSPECT_EXEC_TIME_BUCKETS]; //!< Number of updates of the fields by how
+                                                                      //!< long they took. Bucket 0 counts updates
+                                                                      //!< under 2 usec. Bucket i counts updates of
+                                                                      //!< [2^i, 2^(i+1)) usec. The last bucket also
+                                                                      //!< counts everything longer
+} dcgmIntrospectFieldsExecTime_v2;
+
+/**
+ * Version 2 for \ref dcgmIntrospectFieldsExecTime_v2
+ */
+#define dcgmIntrospectFieldsExecTime_version2 MAKE_DCGM_VERSION(dcgmIntrospectFieldsExecTime_v2, 2)
+
+/**
+ * Points on the way from the driver to clients where the age of samples is measured. The age of a sample
+ * is how long it has been since its timestamp, which is taken around the driver call that read it.
+ * See \ref dcgmIntrospectFieldsExecTime_v3::sampleLagUsecHistogram
+ */
+typedef enum dcgmIntrospectLagStage_enum
+{
+    DCGM_INTROSPECT_LAG_CACHE_INSERT        = 0, //!< The sample was stored in the cache
+    DCGM_INTROSPECT_LAG_SUBSCRIBER_DISPATCH = 1, //!< The sample was published to modules and field value streams
+    DCGM_INTROSPECT_LAG_IPC_SEND            = 2, //!< The sample was sent to a client, in a reply to a request for
+                                                 //!< the latest values or in a field value stream batch
+    DCGM_INTROSPECT_LAG_STAGE_COUNT         = 3  //!< Number of stages. Keep this last
+} dcgmIntrospectLagStage_t;
+
 /**
  * DCGM Execution time info for a set of fields
  */
@@ -2327,31 +2997,46 @@ typedef struct
                              //!< This is roughly how long it takes to update fields every \ref meanUpdateFreqUsec
 
     long long totalEverUpdateUsec; //!< The total amount of time, ever, that has been spent updating all the fields
-} dcgmIntrospectFieldsExecTime_v1;
+
+    long long maxUpdateUsec; //!< The longest that a single update of any of the fields has ever taken
+
+    long long updateUsecHistogram[DCGM_INTROSPECT_EXEC_TIME_BUCKETS]; //!< Number of updates of the fields by how
+                                                                      //!< long they took. Bucket 0 counts updates
+                                                                      //!< under 2 usec. Bucket i counts updates of
+                                                                      //!< [2^i, 2^(i+1)) usec. The last bucket also
+                                                                      //!< counts everything longer
+
+    long long maxSampleLagUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT]; //!< The oldest that a sample of any of the fields
+                                                                 //!< has been at each \ref dcgmIntrospectLagStage_t
+
+    //! Number of samples of the fields by how old they were at each \ref dcgmIntrospectLagStage_t. The buckets
+    //! are the same as the ones of \ref updateUsecHistogram
+    long long sampleLagUsecHistogram[DCGM_INTROSPECT_LAG_STAGE_COUNT][DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
+} dcgmIntrospectFieldsExecTime_v3;
 
 /**
  * Typedef for \ref dcgmIntrospectFieldsExecTime_t
  */
-typedef dcgmIntrospectFieldsExecTime_v1 dcgmIntrospectFieldsExecTime_t;
+typedef dcgmIntrospectFieldsExecTime_v3 dcgmIntrospectFieldsExecTime_t;
 
 /**
- * Version 1 for \ref dcgmIntrospectFieldsExecTime_t
+ * Version 3 for \ref dcgmIntrospectFieldsExecTime_t
  */
-#define dcgmIntrospectFieldsExecTime_version1 MAKE_DCGM_VERSION(dcgmIntrospectFieldsExecTime_v1, 1)
+#define dcgmIntrospectFieldsExecTime_version3 MAKE_DCGM_VERSION(dcgmIntrospectFieldsExecTime_v3, 3)
 
 /**
  * Latest version for \ref dcgmIntrospectFieldsExecTime_t
  */
-#define dcgmIntrospectFieldsExecTime_version dcgmIntrospectFieldsExecTime_version1
+#define dcgmIntrospectFieldsExecTime_version dcgmIntrospectFieldsExecTime_version3
 
 /**
- * Full introspection info for field execution time
+ * Full introspection info for field execution time, made of \ref dcgmIntrospectFieldsExecTime_v1
  *
  * Since DCGM 2.0
  */
 typedef struct
 {
-    unsigned int version; //!< version number (dcgmIntrospectFullFieldsExecTime_version)
+    unsigned int version; //!< version number (dcgmIntrospectFullFieldsExecTime_version2)
 
     dcgmIntrospectFieldsExecTime_v1 aggregateInfo; //!< info that includes global and device scope
 
@@ -2367,19 +3052,71 @@ typedef struct
 } dcgmIntrospectFullFieldsExecTime_v2;
 
 /**
- * typedef for \ref dcgmIntrospectFullFieldsExecTime_v1
+ * Version 2 for \ref dcgmIntrospectFullFieldsExecTime_v2
  */
-typedef dcgmIntrospectFullFieldsExecTime_v2 dcgmIntrospectFullFieldsExecTime_t;
+#define dcgmIntrospectFullFieldsExecTime_version2 MAKE_DCGM_VERSION(dcgmIntrospectFullFieldsExecTime_v2, 2)
 
 /**
- * Version 1 for \ref dcgmIntrospectFullFieldsExecTime_t
+ * Full introspection info for field execution time, made of \ref dcgmIntrospectFieldsExecTime_v2
  */
-#define dcgmIntrospectFullFieldsExecTime_version2 MAKE_DCGM_VERSION(dcgmIntrospectFullFieldsExecTime_v2, 2)
+typedef struct
+{
+    unsigned int version; //!< version number (dcgmIntrospectFullFieldsExecTime_version3)
+
+    dcgmIntrospectFieldsExecTime_v2 aggregateInfo; //!< info that includes global and device scope
+
+    int hasGlobalInfo;                          //!< 0 means \ref globalInfo is populated, !0 means it's not
+    dcgmIntrospectFieldsExecTime_v2 globalInfo; //!< info that only includes global field scope
+
+    unsigned short gpuInfoCount;                         //!< count of how many entries in \ref gpuInfo are populated
+    unsigned int gpuIdsForGpuInfo[DCGM_MAX_NUM_DEVICES]; //!< the GPU ID at a given index identifies which gpu
+                                                         //!< the corresponding entry in \ref gpuInfo is from
+
+    dcgmIntrospectFieldsExecTime_v2 gpuInfo[DCGM_MAX_NUM_DEVICES]; //!< info that is separated by the
+                                                                   //!< GPU ID that the watches were for
+} dcgmIntrospectFullFieldsExecTime_v3;
+
+/**
+ * Version 3 for \ref dcgmIntrospectFullFieldsExecTime_v3
+ */
+#define dcgmIntrospectFullFieldsExecTime_version3 MAKE_DCGM_VERSION(dcgmIntrospectFullFieldsExecTime_v3, 3)
+
+/**
+ * Full introspection info for field execution time
+ *
+ * Since DCGM 2.0
+ */
+typedef struct
+{
+    unsigned int version; //!< version number (dcgmIntrospectFullFieldsExecTime_version)
+
+    dcgmIntrospectFieldsExecTime_v3 aggregateInfo; //!< info that includes global and device scope
+
+    int hasGlobalInfo;                          //!< 0 means \ref globalInfo is populated, !0 means it's not
+    dcgmIntrospectFieldsExecTime_v3 globalInfo; //!< info that only includes global field scope
+
+    unsigned short gpuInfoCount;                         //!< count of how many entries in \ref gpuInfo are populated
+    unsigned int gpuIdsForGpuInfo[DCGM_MAX_NUM_DEVICES]; //!< the GPU ID at a given index identifies which gpu
+                                                         //!< the corresponding entry in \ref gpuInfo is from
+
+    dcgmIntrospectFieldsExecTime_v3 gpuInfo[DCGM_MAX_NUM_DEVICES]; //!< info that is separated by the
+                                                                   //!< GPU ID that the watches were for
+} dcgmIntrospectFullFieldsExecTime_v4;
+
+/**
+ * typedef for \ref dcgmIntrospectFullFieldsExecTime_v4
+ */
+typedef dcgmIntrospectFullFieldsExecTime_v4 dcgmIntrospectFullFieldsExecTime_t;
+
+/**
+ * Version 4 for \ref dcgmIntrospectFullFieldsExecTime_t
+ */
+#define dcgmIntrospectFullFieldsExecTime_version4 MAKE_DCGM_VERSION(dcgmIntrospectFullFieldsExecTime_v4, 4)
 
 /**
  * Latest version for \ref dcgmIntrospectFullFieldsExecTime_t
  */
-#define dcgmIntrospectFullFieldsExecTime_version dcgmIntrospectFullFieldsExecTime_version2
+#define dcgmIntrospectFullFieldsExecTime_version dcgmIntrospectFullFieldsExecTime_version4
 
 /**
  * State of DCGM metadata gathering.  If it is set to DISABLED then "Metadata" API
@@ -2477,6 +3214,280 @@ typedef dcgmIntrospectCpuUtil_v1 dcgmIntrospectCpuUtil_t;
  */
 #define dcgmIntrospectCpuUtil_version dcgmIntrospectCpuUtil_version1
 
+/**
+ * Maximum number of threads in \ref dcgmIntrospectThreadCpuUtil_t
+ */
+#define DCGM_INTROSPECT_MAX_THREADS 256
+
+/**
+ * CPU utilization of one thread of the host engine.  Multiply values by 100 to get them in %.
+ */
+typedef struct
+{
+    unsigned int tid;    //!< Thread ID as seen in /proc/<pid>/task
+    char name[16];       //!< Thread name, like cache_mgr_main or dcgm_ipc
+    unsigned int unused; //!< Unused. Here for structure alignment
+    double total;        //!< fraction of device's CPU resources that this thread used
+    double kernel;       //!< fraction of device's CPU resources that this thread used in kernel mode
+    double user;         //!< fraction of device's CPU resources that this thread used in user mode
+} dcgmIntrospectThreadCpuUtilEntry_t;
+
+/**
+ * CPU utilization of each thread of the host engine between its last two introspection samples
+ */
+typedef struct
+{
+    unsigned int version;     //!< version number (dcgmIntrospectThreadCpuUtil_version)
+    unsigned int numThreads;  //!< Number of populated entries in threads[]
+    unsigned int moreThreads; //!< Set to 1 if the host engine had more than DCGM_INTROSPECT_MAX_THREADS threads
+    unsigned int unused;      //!< Unused. Here for structure alignment
+    dcgmIntrospectThreadCpuUtilEntry_t threads[DCGM_INTROSPECT_MAX_THREADS]; //!< Busiest thread first
+} dcgmIntrospectThreadCpuUtil_v1;
+
+/**
+ * Typedef for \ref dcgmIntrospectThreadCpuUtil_t
+ */
+typedef dcgmIntrospectThreadCpuUtil_v1 dcgmIntrospectThreadCpuUtil_t;
+
+/**
+ * Version 1 for \ref dcgmIntrospectThreadCpuUtil_t
+ */
+#define dcgmIntrospectThreadCpuUtil_version1 MAKE_DCGM_VERSION(dcgmIntrospectThreadCpuUtil_v1, 1)
+
+/**
+ * Latest version for \ref dcgmIntrospectThreadCpuUtil_t
+ */
+#define dcgmIntrospectThreadCpuUtil_version dcgmIntrospectThreadCpuUtil_version1
+
+/**
+ * Buckets of the latency histograms of \ref dcgmIntrospectRequestTypeStats_t. Bucket 0 counts latencies under
+ * 1 usec, bucket i > 0 those from 2^(i-1) up to 2^i usec and the last bucket everything longer
+ */
+#define DCGM_INTROSPECT_LATENCY_BUCKETS 24
+
+/**
+ * Most entries \ref dcgmIntrospectRequestStats_v1 reports
+ */
+#define DCGM_INTROSPECT_MAX_REQUEST_TYPES 128
+
+/**
+ * moduleId of the entries of \ref dcgmIntrospectRequestStats_v1 for protobuf commands rather than module commands
+ */
+#define DCGM_INTROSPECT_REQUEST_PROTOBUF 0xFFFFFFFF
+
+/**
+ * Ask \ref dcgmIntrospectGetRequestStats for an entry per connected client and request type rather than per request
+ * type
+ */
+#define DCGM_INTROSPECT_REQUEST_STATS_PER_CONNECTION 0x1
+
+/**
+ * Requests of one type that clients sent the host engine
+ */
+typedef struct
+{
+    unsigned int moduleId;                  //!< dcgmModuleId_t of module commands. DCGM_INTROSPECT_REQUEST_PROTOBUF for
+                                            //!< protobuf commands
+    unsigned int command;                   //!< Subcommand of module commands. Command type of protobuf commands
+    unsigned int connectionId;              //!< Client connection of the entries reported per connection. 0 otherwise
+    unsigned int unused;                    //!< Unused. Aligns the counters
+    unsigned long long count;               //!< Requests processed
+    unsigned long long errorCount;          //!< ... of which returned an error
+    unsigned long long totalQueueWaitUsec;  //!< Time the requests waited for a worker in usec
+    unsigned long long maxQueueWaitUsec;    //!< Longest time a request waited for a worker in usec
+    unsigned long long totalProcessUsec;    //!< Time spent processing the requests in usec
+    unsigned long long maxProcessUsec;      //!< Longest time spent processing a request in usec
+    unsigned long long totalReplyBytes;     //!< Bytes of the replies
+    unsigned long long maxReplyBytes;       //!< Largest reply in bytes
+
+    //! Requests by queue wait. See DCGM_INTROSPECT_LATENCY_BUCKETS
+    unsigned long long queueWaitHistogram[DCGM_INTROSPECT_LATENCY_BUCKETS];
+    //! Requests by processing time. See DCGM_INTROSPECT_LATENCY_BUCKETS
+    unsigned long long processHistogram[DCGM_INTROSPECT_LATENCY_BUCKETS];
+} dcgmIntrospectRequestTypeStats_t;
+
+/**
+ * Per request type counters of the requests clients sent the host engine since it started
+ */
+typedef struct
+{
+    unsigned int version;     //!< IN: Version number. Use dcgmIntrospectRequestStats_version
+    unsigned int flags;       //!< IN: DCGM_INTROSPECT_REQUEST_STATS_* flags
+    unsigned int numEntries;  //!< OUT: Populated entries of entries, busiest first
+    unsigned int moreEntries; //!< OUT: Whether there were more entries than fit in entries
+
+    dcgmIntrospectRequestTypeStats_t entries[DCGM_INTROSPECT_MAX_REQUEST_TYPES]; //!< OUT: Each request type
+} dcgmIntrospectRequestStats_v1;
+
+/**
+ * Typedef for \ref dcgmIntrospectRequestStats_v1
+ */
+typedef dcgmIntrospectRequestStats_v1 dcgmIntrospectRequestStats_t;
+
+/**
+ * Version 1 for \ref dcgmIntrospectRequestStats_v1
+ */
+#define dcgmIntrospectRequestStats_version1 MAKE_DCGM_VERSION(dcgmIntrospectRequestStats_v1, 1)
+
+/**
+ * Latest version for \ref dcgmIntrospectRequestStats_t
+ */
+#define dcgmIntrospectRequestStats_version dcgmIntrospectRequestStats_version1
+
+/**
+ * Subsystems the host engine charges memory to. Indexes of \ref dcgmIntrospectMemoryAccounting_v1::tags
+ */
+#define DCGM_INTROSPECT_MEM_TAG_CACHE           0 //!< Samples kept by the cache manager
+#define DCGM_INTROSPECT_MEM_TAG_IPC_SEND_QUEUES 1 //!< Messages waiting to be written to client sockets
+#define DCGM_INTROSPECT_MEM_TAG_IPC_BUFFER_POOL 2 //!< Message buffers pooled for reuse
+#define DCGM_INTROSPECT_MEM_TAG_PROTOBUF        3 //!< Protobuf requests being processed, wire bytes and objects
+#define DCGM_INTROSPECT_MEM_TAG_MODULE_REQUESTS 4 //!< Module command buffers being processed or queued
+#define DCGM_INTROSPECT_MEM_TAG_CACHE_ARENAS    5 //!< Huge page backed memory mapped for watches and their samples
+#define DCGM_INTROSPECT_MEM_TAG_COUNT           6 //!< 1 greater than the largest tag above
+
+/**
+ * Room for tags in \ref dcgmIntrospectMemoryAccounting_v1, so tags can be added without versioning it
+ */
+#define DCGM_INTROSPECT_MEM_MAX_TAGS 16
+
+/**
+ * Room for modules in \ref dcgmIntrospectMemoryAccounting_v1. Larger than DcgmModuleIdCount, like
+ * DCGM_MODULE_STATUSES_CAPACITY
+ */
+#define DCGM_INTROSPECT_MEM_MAX_MODULES 16
+
+/**
+ * Most watchers \ref dcgmIntrospectMemoryAccounting_v1 reports
+ */
+#define DCGM_INTROSPECT_MEM_MAX_WATCHERS 128
+
+/**
+ * Memory charged to one subsystem or module
+ */
+typedef struct
+{
+    long long bytesUsed;    //!< Bytes held right now
+    long long maxBytesUsed; //!< Most bytes held at once since the host engine started. Same as bytesUsed for
+                            //!< subsystems that are measured rather than charged as they allocate
+} dcgmIntrospectMemoryTag_t;
+
+/**
+ * Memory charged to one watcher: a client connection or a subsystem of the host engine that watches fields
+ */
+typedef struct
+{
+    unsigned int watcherType;  //!< Who watches. 0 = a client (see connectionId), others are host engine subsystems
+    unsigned int connectionId; //!< Connection of the client. 0 for embedded clients and host engine subsystems
+    long long cacheBytes;      //!< Bytes of samples kept for this watcher's watches. Watches with several
+                               //!< watchers are split evenly between them
+    long long sendQueueBytes;  //!< Bytes waiting to be written to this watcher's connection
+} dcgmIntrospectWatcherMemory_t;
+
+/**
+ * Memory of the host engine by the subsystem, module and watcher it is charged to
+ */
+typedef struct
+{
+    unsigned int version;      //!< IN: Version number. Use dcgmIntrospectMemoryAccounting_version
+    unsigned int numTags;      //!< OUT: Populated entries of tags. DCGM_INTROSPECT_MEM_TAG_COUNT of this host engine
+    unsigned int numWatchers;  //!< OUT: Populated entries of watchers, largest first
+    unsigned int moreWatchers; //!< OUT: Whether there were more watchers than fit in watchers
+
+    dcgmIntrospectMemoryTag_t tags[DCGM_INTROSPECT_MEM_MAX_TAGS]; //!< OUT: By DCGM_INTROSPECT_MEM_TAG_*
+    //! OUT: DCGM_INTROSPECT_MEM_TAG_MODULE_REQUESTS by dcgmModuleId_t
+    dcgmIntrospectMemoryTag_t modules[DCGM_INTROSPECT_MEM_MAX_MODULES];
+    dcgmIntrospectWatcherMemory_t watchers[DCGM_INTROSPECT_MEM_MAX_WATCHERS]; //!< OUT: Each watcher
+} dcgmIntrospectMemoryAccounting_v1;
+
+/**
+ * Typedef for \ref dcgmIntrospectMemoryAccounting_v1
+ */
+typedef dcgmIntrospectMemoryAccounting_v1 dcgmIntrospectMemoryAccounting_t;
+
+/**
+ * Version 1 for \ref dcgmIntrospectMemoryAccounting_v1
+ */
+#define dcgmIntrospectMemoryAccounting_version1 MAKE_DCGM_VERSION(dcgmIntrospectMemoryAccounting_v1, 1)
+
+/**
+ * Latest version for \ref dcgmIntrospectMemoryAccounting_t
+ */
+#define dcgmIntrospectMemoryAccounting_version dcgmIntrospectMemoryAccounting_version1
+
+/**
+ * How the cache manager fetches a field. See \ref dcgmIntrospectFieldCost_t::fetchMethod
+ */
+#define DCGM_INTROSPECT_FETCH_SINGLE       0 //!< One driver call per entity per update
+#define DCGM_INTROSPECT_FETCH_FIELD_VALUES 1 //!< Batched with the other NVML field values of its GPU into one call
+#define DCGM_INTROSPECT_FETCH_SHARED       2 //!< Shares one driver call per GPU with related fields, like FB used/free
+#define DCGM_INTROSPECT_FETCH_COLLECTOR    3 //!< One call per update fetches all entities of its entity group
+
+/**
+ * Most fields \ref dcgmIntrospectWatchCost_v1 reports. Same as DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP
+ */
+#define DCGM_INTROSPECT_WATCH_COST_MAX_FIELDS 128
+
+/**
+ * Predicted cost of watching one field on the entities of a group
+ */
+typedef struct
+{
+    unsigned short fieldId;           //!< Field ID
+    unsigned short fetchMethod;       //!< DCGM_INTROSPECT_FETCH_*
+    unsigned int numEntities;         //!< Entities of the group the field would be watched on
+    unsigned int numMeasured;         //!< Of numEntities, how many had been fetched, so their exec time was measured.
+                                      //!< The rest are estimated from other entities or fields fetched the same way
+    unsigned int numWatched;          //!< Of numEntities, how many the field is watched on already
+    double execUsecPerFetch;          //!< Average CPU time of fetching the field for one entity
+    long long bytesPerSample;         //!< Average cache bytes of one sample
+    long long samplesKept;            //!< Samples kept per entity at the proposed frequency and keep age
+    double cpuUsecPerSec;             //!< CPU time per second of updating the field on all numEntities
+    double driverCallsPerSec;         //!< Driver calls per second of updating it. Batched calls are shared between
+                                      //!< the fields of the batch
+    long long cacheBytes;             //!< Cache bytes of keeping samplesKept on all numEntities
+    double marginalCpuUsecPerSec;     //!< What cpuUsecPerSec would add to the watches already active
+    double marginalDriverCallsPerSec; //!< What driverCallsPerSec would add to the watches already active
+    long long marginalCacheBytes;     //!< What cacheBytes would add to the watches already active
+} dcgmIntrospectFieldCost_t;
+
+/**
+ * Predicted cost of a watch before it is made with dcgmWatchFields()
+ */
+typedef struct
+{
+    unsigned int version;             //!< IN: Version number. Use dcgmIntrospectWatchCost_version
+    unsigned int groupId;             //!< IN: Group of the proposed watch. dcgmGpuGrp_t
+    unsigned int fieldGroupId;        //!< IN: Field group of the proposed watch. dcgmFieldGrp_t
+    unsigned int numFields;           //!< OUT: Populated entries of fields
+    long long updateFreq;             //!< IN: Proposed update frequency in usec. See dcgmWatchFields()
+    double maxKeepAge;                //!< IN: Proposed max keep age in seconds. See dcgmWatchFields()
+    int maxKeepSamples;               //!< IN: Proposed max keep samples. 0 = no limit. See dcgmWatchFields()
+    unsigned int reserved;            //!< Unused
+    double cpuUsecPerSec;             //!< OUT: Sum of fields[].cpuUsecPerSec
+    double driverCallsPerSec;         //!< OUT: Sum of fields[].driverCallsPerSec
+    long long cacheBytes;             //!< OUT: Sum of fields[].cacheBytes
+    double marginalCpuUsecPerSec;     //!< OUT: Sum of fields[].marginalCpuUsecPerSec
+    double marginalDriverCallsPerSec; //!< OUT: Sum of fields[].marginalDriverCallsPerSec
+    long long marginalCacheBytes;     //!< OUT: Sum of fields[].marginalCacheBytes. Can be negative if the
+                                      //!< watch would shorten the keep age of existing watches
+    dcgmIntrospectFieldCost_t fields[DCGM_INTROSPECT_WATCH_COST_MAX_FIELDS]; //!< OUT: Each field of the field group
+} dcgmIntrospectWatchCost_v1;
+
+/**
+ * Typedef for \ref dcgmIntrospectWatchCost_v1
+ */
+typedef dcgmIntrospectWatchCost_v1 dcgmIntrospectWatchCost_t;
+
+/**
+ * Version 1 for \ref dcgmIntrospectWatchCost_v1
+ */
+#define dcgmIntrospectWatchCost_version1 MAKE_DCGM_VERSION(dcgmIntrospectWatchCost_v1, 1)
+
+/**
+ * Latest version for \ref dcgmIntrospectWatchCost_t
+ */
+#define dcgmIntrospectWatchCost_version dcgmIntrospectWatchCost_version1
+
 #define DCGM_MAX_CONFIG_FILE_LEN 10000
 #define DCGM_MAX_TEST_NAMES      20
 #define DCGM_MAX_TEST_NAMES_LEN  50
@@ -2518,6 +3529,20 @@ typedef dcgmIntrospectCpuUtil_v1 dcgmIntrospectCpuUtil_t;
  */
 #define DCGM_RUN_FLAGS_FAIL_EARLY 0x0010
 
+/**
+ * Stop the whole run at the first fatal error (double bit ECC error or XID) on any GPU in it. Running tests are
+ * cancelled and the remaining tests are skipped. The errors are checked for every failCheckInterval seconds
+ */
+#define DCGM_RUN_FLAGS_FAIL_FAST 0x0020
+
+/**
+ * Return the results of a recent run of the same tests on a GPU instead of running them again, as long as they all
+ * passed, they are at most 10 minutes old, and the GPU had no XID, double bit ECC error, page retirement or row remap
+ * failure since. The tests run only on the GPUs without such results. The info of each reused result says how old
+ * it is
+ */
+#define DCGM_RUN_FLAGS_REUSE_RESULTS 0x0040
+
 /**
  * @}
  */
@@ -2679,7 +3704,10 @@ typedef dcgmNvLinkStatus_v2 dcgmNvLinkStatus_t;
 #define DCGM_SUMMARY_COUNT    0x00000010
 #define DCGM_SUMMARY_INTEGRAL 0x00000020
 #define DCGM_SUMMARY_DIFF     0x00000040
-#define DCGM_SUMMARY_SIZE     7
+#define DCGM_SUMMARY_P50      0x00000080 //!< Median. Percentiles are estimates within 1% of a sampled value
+#define DCGM_SUMMARY_P95      0x00000100 //!< 95th percentile
+#define DCGM_SUMMARY_P99      0x00000200 //!< 99th percentile
+#define DCGM_SUMMARY_SIZE     7          //!< Most summaries one request can ask for
 
 /* dcgmSummaryResponse_t is part of dcgmFieldSummaryRequest, so it uses dcgmFieldSummaryRequest's version. */
 
@@ -2850,6 +3878,24 @@ typedef struct
 #define dcgmProfGetMetricGroups_version  dcgmProfGetMetricGroups_version2
 typedef dcgmProfGetMetricGroups_v2 dcgmProfGetMetricGroups_t;
 
+/**
+ * Flag for dcgmProfWatchFields_t.flags: watch fields whose metric groups can't be collected at the same
+ * time by rotating through them. Each set of metric groups that can be collected together is watched for
+ * updateFreq usec in turn, so a field only gets samples while its metric group is watched. The host engine
+ * logs the share of the rotation each field is collected in. Without this flag, such a watch fails with
+ * DCGM_ST_PROFILING_MULTI_PASS. A later watch without the flag or dcgmProfUnwatchFields() ends the rotation
+ */
+#define DCGM_PROF_WATCH_FLAG_MULTIPLEX 0x00000001
+
+/**
+ * Flag for dcgmProfWatchFields_t.flags: sample the counters at the minUpdateFreqUsec of their metric group rather than
+ * at updateFreq, and keep every sample with its own timestamp instead of aggregating them to updateFreq intervals.
+ * The profiling module buffers the samples and hands them to the cache in one batch every updateFreq usec, so phases
+ * of a workload shorter than updateFreq show up without the cost of watching at the higher rate. Note that
+ * maxKeepSamples counts these samples, of which there are updateFreq / minUpdateFreqUsec per interval
+ */
+#define DCGM_PROF_WATCH_FLAG_BUFFERED 0x00000002
+
 /**
  * Structure to pass to dcgmProfWatchFields() when watching profiling metrics
  */
@@ -2869,7 +3915,7 @@ typedef struct
                                  //!< then samples will be aggregated to updateFreq intervals in DCGM's internal cache.
     double maxKeepAge;           //!< How long to keep data for every fieldId in seconds
     int maxKeepSamples;          //!< Maximum number of samples to keep for each fieldId. 0=no limit
-    unsigned int flags;          //!< For future use. Set to 0 for now.
+    unsigned int flags;          //!< DCGM_PROF_WATCH_FLAG_* flags. 0 for none
 } dcgmProfWatchFields_v1;
 
 /**
@@ -175,13 +175,19 @@ typedef struct
 /* Watcher types. Each watcher type's watches are tracked separately within subsystems */
 typedef enum
 {
-    DcgmWatcherTypeClient          = 0, /* Embedded or remote client via external APIs */
-    DcgmWatcherTypeHostEngine      = 1, /* Watcher is DcgmHostEngineHandler */
-    DcgmWatcherTypeHealthWatch     = 2, /* Watcher is DcgmHealthWatch */
-    DcgmWatcherTypePolicyManager   = 3, /* Watcher is DcgmPolicyMgr */
-    DcgmWatcherTypeCacheManager    = 4, /* Watcher is DcgmCacheManager */
-    DcgmWatcherTypeConfigManager   = 5, /* Watcher is DcgmConfigMgr */
-    DcgmWatcherTypeNvSwitchManager = 6, /* Watcher is NvSwitchManager */
+    DcgmWatcherTypeClient           = 0,  /* Embedded or remote client via external APIs */
+    DcgmWatcherTypeHostEngine       = 1,  /* Watcher is DcgmHostEngineHandler */
+    DcgmWatcherTypeHealthWatch      = 2,  /* Watcher is DcgmHealthWatch */
+    DcgmWatcherTypePolicyManager    = 3,  /* Watcher is DcgmPolicyMgr */
+    DcgmWatcherTypeCacheManager     = 4,  /* Watcher is DcgmCacheManager */
+    DcgmWatcherTypeConfigManager    = 5,  /* Watcher is DcgmConfigMgr */
+    DcgmWatcherTypeNvSwitchManager  = 6,  /* Watcher is NvSwitchManager */
+    DcgmWatcherTypeFvStream         = 7,  /* Field value stream of a client. See DcgmFvStreamManager */
+    DcgmWatcherTypeJobStats         = 8,  /* Running job stats. See DcgmJobStatsAccumulator */
+    DcgmWatcherTypeMetricsExporter  = 9,  /* OpenMetrics endpoint. See DcgmMetricsExporter */
+    DcgmWatcherTypeOtlpExporter     = 10, /* OTLP metrics push. See DcgmOtlpExporter */
+    DcgmWatcherTypeLatestValueBoard = 11, /* Shared memory board. See DcgmLatestValueBoard */
+    DcgmWatcherTypeDiagResultCache  = 12, /* Health of GPUs with reusable diag results. See DcgmDiagResultCache */
 
     DcgmWatcherTypeCount /* Should always be last */
 } DcgmWatcherType_t;
@@ -194,7 +200,8 @@ typedef unsigned int dcgm_connection_id_t;
 #define DCGM_CONNECTION_ID_NONE ((dcgm_connection_id_t)0)
 
 /* Cache Manager Info flags */
-#define DCGM_CMI_F_WATCHED 0x00000001 /* Is this field being watched? */
+#define DCGM_CMI_F_WATCHED            0x00000001 /* Is this field being watched? */
+#define DCGM_CMI_F_ADAPTIVE_DECIMATED 0x00000002 /* Is it polled slower than its monitor frequency for now? */
 
 /* This structure mirrors the DcgmWatcher object */
 typedef struct dcgm_cm_field_info_watcher_t
@@ -204,6 +211,7 @@ typedef struct dcgm_cm_field_info_watcher_t
     long long monitorFrequencyUsec;    /* How often this field should be sampled */
     long long maxAgeUsec;              /* Maximum time to cache samples of this
                                        field. If 0, the class default is used */
+    long long bytesUsed;               /* This watcher's share of the field's bytesUsed */
 } dcgm_cm_field_info_watcher_t, *dcgm_cm_field_info_watcher_p;
 
 /**
@@ -211,7 +219,7 @@ typedef struct dcgm_cm_field_info_watcher_t
  */
 #define DCGM_CM_FIELD_INFO_NUM_WATCHERS 10
 
-typedef struct dcgmCacheManagerFieldInfo_v3_t
+typedef struct dcgmCacheManagerFieldInfo_v5_t
 {
     unsigned int version;           /* Version. Check against dcgmCacheManagerInfo_version */
     unsigned int flags;             /* Bitmask of DCGM_CMI_F_? #defines that apply to this field */
@@ -228,15 +236,19 @@ typedef struct dcgmCacheManagerFieldInfo_v3_t
                               field since the cache manager started */
     long long fetchCount;           /* Number of times that this field has been
                               fetched from the driver */
+    long long bytesUsed;            /* Approximate bytes used to cache this field's samples */
+    long long lastReadUsec;         /* Last time a client read this field's history. 0 = never */
+    long long pollIntervalUsec;     /* How often this field is actually polled right now. Longer than
+                              monitorFrequencyUsec while it's DCGM_CMI_F_ADAPTIVE_DECIMATED */
     int numSamples;                 /* Number of samples currently cached for this field */
     int numWatchers;                /* Number of watchers that are valid in watchers[] */
     dcgm_cm_field_info_watcher_t watchers[DCGM_CM_FIELD_INFO_NUM_WATCHERS]; /* Who are the first 10
                                                                            watchers of this field? */
-} dcgmCacheManagerFieldInfo_v3_t, *dcgmCacheManagerFieldInfo_v3_p;
+} dcgmCacheManagerFieldInfo_v5_t, *dcgmCacheManagerFieldInfo_v5_p;
 
-typedef dcgmCacheManagerFieldInfo_v3_t dcgmCacheManagerFieldInfo_t;
-#define dcgmCacheManagerFieldInfo_version3 MAKE_DCGM_VERSION(dcgmCacheManagerFieldInfo_v3_t, 3)
-#define dcgmCacheManagerFieldInfo_version  dcgmCacheManagerFieldInfo_version3
+typedef dcgmCacheManagerFieldInfo_v5_t dcgmCacheManagerFieldInfo_t;
+#define dcgmCacheManagerFieldInfo_version5 MAKE_DCGM_VERSION(dcgmCacheManagerFieldInfo_v5_t, 5)
+#define dcgmCacheManagerFieldInfo_version  dcgmCacheManagerFieldInfo_version5
 
 /**
  * The maximum number of topology elements possible given DCGM_MAX_NUM_DEVICES
@@ -548,6 +560,31 @@ typedef struct
     char buffer[SAMPLES_BUFFER_SIZE]; //!< OUT:: this field is last, and can be truncated for speed */
 } dcgmGetMultipleValuesForField_v1;
 
+/**
+ * Most buckets that fit in the buffer of dcgmGetBucketedValuesForField_t. Each one is an int64 or double
+ * dcgmBufferedFv_t, which takes 32 bytes
+ */
+#define DCGM_MAX_BUCKETS_PER_REQUEST (SAMPLES_BUFFER_SIZE / 32)
+
+/**
+ * Version 1 of dcgmGetBucketedValuesForField_t
+ */
+typedef struct
+{
+    unsigned int entityGroupId;       //!< IN: Entity group of the entity to fetch values for
+    unsigned int entityId;            //!< IN: Entity to fetch values for
+    unsigned int fieldId;             //!< IN: Field id to fetch
+    unsigned int aggregation;         //!< IN: How to combine samples, see dcgmBucketAggregation_t
+    long long startTs;                //!< IN: Starting timestamp. Should be a multiple of bucketWidth
+    long long endTs;                  //!< IN: End timestamp, inclusive
+    long long bucketWidth;            //!< IN: Width of each bucket in usec
+    unsigned int count;               //!< IN: Maximum number of buckets. Capped at DCGM_MAX_BUCKETS_PER_REQUEST
+                                      //!< OUT: Number of buckets in buffer
+    unsigned int cmdRet;              //!< OUT: Error code generated
+    unsigned int bufferSize;          //!< OUT: Length of populated buffer
+    char buffer[SAMPLES_BUFFER_SIZE]; //!< OUT: One fv per bucket. This field is last, and can be truncated for speed
+} dcgmGetBucketedValuesForField_v1;
+
 /**
  * Version 1 of dcgmJobCmd_t
  */
@@ -756,6 +793,39 @@ typedef struct
     unsigned int cmdRet; //!< OUT: Error code generated
 } dcgmMsgGetGpuInstanceHierarchy_v1;
 
+/**
+ * Actions for dcgmTraceControl()
+ */
+#define DCGM_TRACE_ACTION_START 1 //!< Start recording update-loop and request spans
+#define DCGM_TRACE_ACTION_STOP  2 //!< Stop recording. Recorded spans are kept
+#define DCGM_TRACE_ACTION_DUMP  3 //!< Write the recorded spans as Chrome trace JSON on the hostengine's host,
+                                  //!< and the binary log next to it if it was started
+#define DCGM_TRACE_ACTION_MUTEX_PROFILE_START 4 //!< Reset the DcgmMutex profiles and start recording waits and holds
+#define DCGM_TRACE_ACTION_MUTEX_PROFILE_STOP  5 //!< Stop profiling DcgmMutexes. Recorded profiles are kept
+#define DCGM_TRACE_ACTION_MUTEX_PROFILE_DUMP  6 //!< Write the mutex profiles as JSON on the hostengine's host
+
+typedef struct
+{
+    unsigned int version;               //!< IN: Version number (dcgmTraceControl_version)
+    unsigned int action;                //!< IN: One of DCGM_TRACE_ACTION_*
+    unsigned int numSpans;              //!< IN: Ring size for the first START. 0 = default.
+                                        //!< OUT: Ring size in use. 0 = tracing was never started
+    unsigned int isEnabled;             //!< OUT: Whether spans, or for MUTEX_PROFILE actions mutex times, are
+                                        //!< being recorded after the action
+    char filename[DCGM_MAX_STR_LENGTH]; //!< OUT: For DUMP, the path of the file that was written
+} dcgmTraceControl_v1;
+
+#define dcgmTraceControl_version1 MAKE_DCGM_VERSION(dcgmTraceControl_v1, 1)
+#define dcgmTraceControl_version  dcgmTraceControl_version1
+
+typedef dcgmTraceControl_v1 dcgmTraceControl_t;
+
+typedef struct
+{
+    dcgmTraceControl_v1 tc; //!< IN/OUT: trace request and results
+    unsigned int cmdRet;    //!< OUT: Error code generated
+} dcgmMsgTraceControl_v1;
+
 /**
  * Older version of nvmlProcessInfo_t. This is here because NVML changed the size of nvmlProcessInfo_t
  * without changing the version used by nvmlDeviceGetComputeRunningProcesses(). This can be removed
@@ -796,7 +866,16 @@ DCGM_CASSERT((int)DCGM_GPU_VIRTUALIZATION_MODE_HOST_VSGA == (int)NVML_GPU_VIRTUA
 DCGM_CASSERT(dcgmPidInfo_version == (long)0x02004528, 1);
 DCGM_CASSERT(dcgmConfig_version == (long)16777256, 1);
 DCGM_CASSERT(dcgmConnectV2Params_version1 == (long)16777224, 1);
-DCGM_CASSERT(dcgmConnectV2Params_version == (long)0x02000010, 1);
+DCGM_CASSERT(dcgmConnectV2Params_version2 == (long)0x02000010, 1);
+DCGM_CASSERT(dcgmConnectV2Params_version3 == (long)0x03000014, 1);
+DCGM_CASSERT(dcgmConnectV2Params_version4 == (long)0x0400001c, 1);
+DCGM_CASSERT(dcgmTransportStats_version1 == (long)0x010000a0, 1);
+DCGM_CASSERT(dcgmTransportStats_version2 == (long)0x02000100, 2);
+DCGM_CASSERT(dcgmFieldValueStreamParams_version1 == (long)0x01000038, 1);
+DCGM_CASSERT(dcgmProxyHosts_version1 == (long)0x01009408, 1);
+DCGM_CASSERT(dcgmHostengineWorkerStats_version1 == (long)0x01000248, 1);
+DCGM_CASSERT(dcgmIntrospectRequestStats_version1 == (long)0x0100e810, 1);
+DCGM_CASSERT(dcgmIntrospectMemoryAccounting_version1 == (long)0x01000e10, 1);
 DCGM_CASSERT(dcgmFieldGroupInfo_version == (long)16777744, 1);
 DCGM_CASSERT(dcgmAllFieldGroup_version == (long)16811016, 1);
 DCGM_CASSERT(dcgmDeviceAttributes_version1 == (long)16782628, 1);
@@ -805,11 +884,19 @@ DCGM_CASSERT(dcgmHealthResponse_version4 == (long)0x0401050C, 1);
 DCGM_CASSERT(dcgmIntrospectContext_version == (long)16777232, 1);
 DCGM_CASSERT(dcgmIntrospectMemory_version == (long)16777232, 1);
 DCGM_CASSERT(dcgmIntrospectCpuUtil_version == (long)16777248, 1);
-DCGM_CASSERT(dcgmIntrospectFieldsExecTime_version == (long)16777248, 1);
-DCGM_CASSERT(dcgmIntrospectFullFieldsExecTime_version == (long)0x020004D8, 1);
+DCGM_CASSERT(dcgmIntrospectThreadCpuUtil_version == (long)0x01003010, 1);
+DCGM_CASSERT(dcgmIntrospectFieldsExecTime_version1 == (long)16777248, 1);
+DCGM_CASSERT(dcgmIntrospectFieldsExecTime_version2 == (long)0x020000C8, 1);
+DCGM_CASSERT(dcgmIntrospectFieldsExecTime_version == (long)0x030002C0, 1);
+DCGM_CASSERT(dcgmIntrospectFullFieldsExecTime_version2 == (long)0x020004D8, 1);
+DCGM_CASSERT(dcgmIntrospectFullFieldsExecTime_version3 == (long)0x03001B28, 1);
+DCGM_CASSERT(dcgmIntrospectFullFieldsExecTime_version == (long)0x04005E18, 1);
 DCGM_CASSERT(dcgmJobInfo_version == (long)0x030098A8, 1);
+DCGM_CASSERT(dcgmJobPercentiles_version == (long)0x010016B8, 1);
 DCGM_CASSERT(dcgmPolicy_version == (long)16777360, 1);
 DCGM_CASSERT(dcgmPolicyCallbackResponse_version == (long)16777240, 1);
+DCGM_CASSERT(dcgmPolicyCallbackResponse_version2 == (long)0x02000030, 1);
+DCGM_CASSERT(dcgmPolicyRegisterParams_version1 == (long)0x01000038, 1);
 DCGM_CASSERT(dcgmDiagResponse_version6 == (long)0x06079090, 1);
 DCGM_CASSERT(dcgmDiagResponse_version == (long)0x06079090, 1);
 DCGM_CASSERT(dcgmRunDiag_version7 == (long)0x70054D0, 1);
@@ -823,6 +910,7 @@ DCGM_CASSERT(dcgmVersionInfo_version == (long)0x2000204, 1);
 DCGM_CASSERT(dcgmStartEmbeddedV2Params_version1 == (long)0x01000048, 1);
 DCGM_CASSERT(dcgmInjectFieldValue_version1 == (long)0x1001018, 1);
 DCGM_CASSERT(dcgmInjectFieldValue_version == (long)0x1001018, 1);
+DCGM_CASSERT(dcgmTraceControl_version1 == (long)0x1000110, 1);
 
 /* Min and Max macros */
 #ifndef DCGM_MIN
@@ -422,6 +422,32 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmEntityInjectFieldValue(dcgmHandle_t pDcgmHandle
                                                         dcgm_field_eid_t entityId,
                                                         dcgmInjectFieldValue_t *dcgmInjectFieldValue);
 
+/**
+ * Inject many samples, of any number of entities and fields, into the cache manager
+ *
+ * This is much faster than calling dcgmInjectEntityFieldValue() for each sample, since the
+ * samples are sent in as few requests as will hold them and the cache manager is locked once
+ * per request rather than once per sample. This is meant for loading fake entities with
+ * production-scale data.
+ *
+ * @param pDcgmHandle    IN: DCGM Handle
+ * @param entities       IN: Entity of each sample. entities[i] is the entity of values[i]
+ * @param values         IN: Samples to inject. Only int64, double and string samples can be
+ *                           injected. Their types must match their fields'
+ * @param count          IN: Number of entries in entities[] and values[]
+ *
+ * @return
+ *        - \ref DCGM_ST_OK                   if the call was successful
+ *        - \ref DCGM_ST_BADPARAM             if a provided parameter or sample is invalid. None of the
+ *                                            samples of the request it would have been in are injected.
+ *                                            Samples of requests before it may already be
+ *        - \ref DCGM_ST_VER_MISMATCH         if a sample's version isn't dcgmInjectFieldValue_version
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmInjectEntityFieldValues(dcgmHandle_t pDcgmHandle,
+                                                         dcgmGroupEntityPair_t *entities,
+                                                         dcgmInjectFieldValue_t *values,
+                                                         unsigned int count);
+
 /**
  * This method sets the link state of an entity's NvLink
  *
@@ -456,6 +482,25 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmCreateMigEntity(dcgmHandle_t dcgmHandle, dcgmCr
  */
 dcgmReturn_t DCGM_PUBLIC_API dcgmDeleteMigEntity(dcgmHandle_t dcgmHandle, dcgmDeleteMigEntity_t *dme);
 
+/**
+ * Start, stop or dump the hostengine's update-loop trace. Dumps are written as Chrome trace JSON, which
+ * chrome://tracing and Perfetto can open, to a new file in the directory named by __DCGM_TRACE_DIR (/tmp by
+ * default) on the hostengine's host.
+ *
+ * The DCGM_TRACE_ACTION_MUTEX_PROFILE_* actions do the same for the wait-time and hold-time histograms that
+ * DcgmMutex keeps per call site.
+ *
+ * @param dcgmHandle       IN: DCGM Handle
+ * @param traceControl IN/OUT: the action to take. Returns the ring size, whether tracing is on and, for
+ *                             DCGM_TRACE_ACTION_DUMP, the path of the file that was written
+ * @return
+ *        - \ref DCGM_ST_OK                if the call was successful.
+ *        - \ref DCGM_ST_BADPARAM          if the action is invalid
+ *        - \ref DCGM_ST_UNINITIALIZED     if a dump was requested but tracing was never started
+ *        - \ref DCGM_ST_GENERIC_ERROR     if the trace file couldn't be written
+ */
+dcgmReturn_t DCGM_PUBLIC_API dcgmTraceControl(dcgmHandle_t dcgmHandle, dcgmTraceControl_t *traceControl);
+
 #ifdef __cplusplus
 }
 #endif
@@ -59,6 +59,18 @@ DCGM_ENTRY_POINT(dcgmInjectEntityFieldValue,
                  entityId,
                  pDcgmInjectFieldValue)
 
+DCGM_ENTRY_POINT(dcgmInjectEntityFieldValues,
+                 tsapiInjectEntityFieldValues,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmGroupEntityPair_t *entities,
+                  dcgmInjectFieldValue_t *values,
+                  unsigned int count),
+                 "(%p %p %p %u)",
+                 pDcgmHandle,
+                 entities,
+                 values,
+                 count)
+
 DCGM_ENTRY_POINT(dcgmSetEntityNvLinkLinkState,
                  tsapiSetEntityNvLinkLinkState,
                  (dcgmHandle_t pDcgmHandle, dcgmSetNvLinkLinkState_v1 *linkState),
@@ -102,6 +114,18 @@ DCGM_ENTRY_POINT(dcgmGetDeviceAttributes,
                  gpuId,
                  pDcgmDeviceAttr)
 
+DCGM_ENTRY_POINT(dcgmGetDeviceAttributesBulk,
+                 tsapiEngineGetDeviceAttributesBulk,
+                 (dcgmHandle_t pDcgmHandle,
+                  unsigned int gpuIds[],
+                  unsigned int count,
+                  dcgmDeviceAttributes_t attributes[]),
+                 "(%p %p %u %p)",
+                 pDcgmHandle,
+                 gpuIds,
+                 count,
+                 attributes)
+
 DCGM_ENTRY_POINT(dcgmGetEntityGroupEntities,
                  tsapiGetEntityGroupEntities,
                  (dcgmHandle_t dcgmHandle,
@@ -137,6 +161,13 @@ DCGM_ENTRY_POINT(dcgmDeleteMigEntity,
                  dcgmHandle,
                  dme)
 
+DCGM_ENTRY_POINT(dcgmTraceControl,
+                 tsapiTraceControl,
+                 (dcgmHandle_t dcgmHandle, dcgmTraceControl_t *traceControl),
+                 "(%p %p)",
+                 dcgmHandle,
+                 traceControl)
+
 DCGM_ENTRY_POINT(dcgmGetNvLinkLinkStatus,
                  tsapiGetNvLinkLinkStatus,
                  (dcgmHandle_t dcgmHandle, dcgmNvLinkStatus_v2 *linkStatus),
@@ -435,6 +466,13 @@ DCGM_ENTRY_POINT(dcgmPolicyRegister,
                  beginCallback,
                  finishCallback)
 
+DCGM_ENTRY_POINT(dcgmPolicyRegister_v2,
+                 tsapiEnginePolicyRegister_v2,
+                 (dcgmHandle_t pDcgmHandle, dcgmPolicyRegisterParams_v1 *params),
+                 "(%p %p)",
+                 pDcgmHandle,
+                 params)
+
 DCGM_ENTRY_POINT(dcgmPolicyUnregister,
                  tsapiEnginePolicyUnregister,
                  (dcgmHandle_t pDcgmHandle, dcgmGpuGrp_t groupId, dcgmPolicyCondition_t condition),
@@ -499,6 +537,100 @@ DCGM_ENTRY_POINT(dcgmGetValuesSince_v2,
                  enumCB,
                  userData)
 
+DCGM_ENTRY_POINT(dcgmGetValuesSinceBucketed,
+                 tsapiEngineGetValuesSinceBucketed,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmGpuGrp_t groupId,
+                  dcgmFieldGrp_t fieldGroupId,
+                  long long sinceTimestamp,
+                  long long bucketWidthUsec,
+                  dcgmBucketAggregation_t aggregation,
+                  long long *nextSinceTimestamp,
+                  dcgmFieldValueEntityEnumeration_f enumCB,
+                  void *userData),
+                 "(%p %p %p %lld %lld %d %p %p %p)",
+                 pDcgmHandle,
+                 groupId,
+                 fieldGroupId,
+                 sinceTimestamp,
+                 bucketWidthUsec,
+                 aggregation,
+                 nextSinceTimestamp,
+                 enumCB,
+                 userData)
+
+DCGM_ENTRY_POINT(dcgmFieldValueStreamSubscribe,
+                 tsapiFieldValueStreamSubscribe,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmFieldValueStreamParams_t *params,
+                  dcgmFieldValueEntityEnumeration_f callback,
+                  void *userData,
+                  unsigned int *streamId),
+                 "(%p %p %p %p %p)",
+                 pDcgmHandle,
+                 params,
+                 callback,
+                 userData,
+                 streamId)
+
+DCGM_ENTRY_POINT(dcgmFieldValueStreamUnsubscribe,
+                 tsapiFieldValueStreamUnsubscribe,
+                 (dcgmHandle_t pDcgmHandle, unsigned int streamId),
+                 "(%p %u)",
+                 pDcgmHandle,
+                 streamId)
+
+DCGM_ENTRY_POINT(dcgmProxyStreamSubscribe,
+                 tsapiProxyStreamSubscribe,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmFieldValueStreamParams_t *params,
+                  dcgmProxyFieldValueEnumeration_f callback,
+                  void *userData,
+                  unsigned int *streamId),
+                 "(%p %p %p %p %p)",
+                 pDcgmHandle,
+                 params,
+                 callback,
+                 userData,
+                 streamId)
+
+DCGM_ENTRY_POINT(dcgmProxyStreamUnsubscribe,
+                 tsapiProxyStreamUnsubscribe,
+                 (dcgmHandle_t pDcgmHandle, unsigned int streamId),
+                 "(%p %u)",
+                 pDcgmHandle,
+                 streamId)
+
+DCGM_ENTRY_POINT(dcgmProxyGetHosts,
+                 tsapiProxyGetHosts,
+                 (dcgmHandle_t pDcgmHandle, dcgmProxyHosts_t *hosts),
+                 "(%p %p)",
+                 pDcgmHandle,
+                 hosts)
+
+DCGM_ENTRY_POINT(dcgmGetTransportStats,
+                 tsapiGetTransportStats,
+                 (dcgmHandle_t pDcgmHandle, dcgmTransportStats_t *stats),
+                 "(%p %p)",
+                 pDcgmHandle,
+                 stats)
+
+DCGM_ENTRY_POINT(dcgmClientCacheEnable, tsapiClientCacheEnable, (dcgmHandle_t pDcgmHandle), "(%p)", pDcgmHandle)
+
+DCGM_ENTRY_POINT(dcgmSessionGetToken,
+                 tsapiSessionGetToken,
+                 (dcgmHandle_t pDcgmHandle, unsigned long long *token),
+                 "(%p %p)",
+                 pDcgmHandle,
+                 token)
+
+DCGM_ENTRY_POINT(dcgmSessionResume,
+                 tsapiSessionResume,
+                 (dcgmHandle_t pDcgmHandle, unsigned long long token),
+                 "(%p %llu)",
+                 pDcgmHandle,
+                 token)
+
 DCGM_ENTRY_POINT(dcgmGetLatestValues,
                  tsapiEngineGetLatestValues,
                  (dcgmHandle_t pDcgmHandle,
@@ -527,6 +659,18 @@ DCGM_ENTRY_POINT(dcgmGetLatestValues_v2,
                  enumCB,
                  userData)
 
+DCGM_ENTRY_POINT(dcgmGetLatestValuesMatrix,
+                 tsapiEngineGetLatestValuesMatrix,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmGpuGrp_t groupId,
+                  dcgmFieldGrp_t fieldGroupId,
+                  dcgmLatestValuesMatrix_v1 *matrix),
+                 "(%p %p %p %p)",
+                 pDcgmHandle,
+                 groupId,
+                 fieldGroupId,
+                 matrix)
+
 DCGM_ENTRY_POINT(dcgmEntitiesGetLatestValues,
                  tsapiEntitiesGetLatestValues,
                  (dcgmHandle_t pDcgmHandle,
@@ -545,6 +689,128 @@ DCGM_ENTRY_POINT(dcgmEntitiesGetLatestValues,
                  flags,
                  values)
 
+DCGM_ENTRY_POINT(dcgmEntitiesGetLatestValuesSince,
+                 tsapiEntitiesGetLatestValuesSince,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmGroupEntityPair_t entities[],
+                  unsigned int entityCount,
+                  unsigned short fields[],
+                  unsigned int fieldCount,
+                  unsigned int flags,
+                  unsigned long long *updateSequence,
+                  dcgmFieldValue_v2 values[],
+                  unsigned int *valuesCount),
+                 "(%p %p %u %p %u %u %p %p %p)",
+                 pDcgmHandle,
+                 entities,
+                 entityCount,
+                 fields,
+                 fieldCount,
+                 flags,
+                 updateSequence,
+                 values,
+                 valuesCount)
+
+DCGM_ENTRY_POINT(dcgmEntitiesGetLatestValuesAsync,
+                 tsapiEntitiesGetLatestValuesAsync,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmGroupEntityPair_t entities[],
+                  unsigned int entityCount,
+                  unsigned short fields[],
+                  unsigned int fieldCount,
+                  unsigned int flags,
+                  dcgmFieldValue_v2 values[],
+                  dcgmRequestComplete_f callback,
+                  void *userData),
+                 "(%p %p %u %p %u %u %p %p %p)",
+                 pDcgmHandle,
+                 entities,
+                 entityCount,
+                 fields,
+                 fieldCount,
+                 flags,
+                 values,
+                 callback,
+                 userData)
+
+DCGM_ENTRY_POINT(dcgmEntityGetValuesPage,
+                 tsapiEntityGetValuesPage,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgm_field_entity_group_t entityGroup,
+                  dcgm_field_eid_t entityId,
+                  unsigned short fieldId,
+                  dcgmValuesCursor_t *cursor,
+                  int *count,
+                  dcgmFieldValue_v1 values[],
+                  long long *valuesSkipped),
+                 "(%p %u %u %u %p %p %p %p)",
+                 pDcgmHandle,
+                 entityGroup,
+                 entityId,
+                 fieldId,
+                 cursor,
+                 count,
+                 values,
+                 valuesSkipped)
+
+DCGM_ENTRY_POINT(dcgmEntityGetValuesPageNumeric,
+                 tsapiEntityGetValuesPageNumeric,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgm_field_entity_group_t entityGroup,
+                  dcgm_field_eid_t entityId,
+                  unsigned short fieldId,
+                  dcgmValuesCursor_t *cursor,
+                  int *count,
+                  long long timestamps[],
+                  void *values,
+                  long long *valuesSkipped),
+                 "(%p %u %u %u %p %p %p %p %p)",
+                 pDcgmHandle,
+                 entityGroup,
+                 entityId,
+                 fieldId,
+                 cursor,
+                 count,
+                 timestamps,
+                 values,
+                 valuesSkipped)
+
+DCGM_ENTRY_POINT(dcgmEmbeddedAcquireValueViews,
+                 tsapiEmbeddedAcquireValueViews,
+                 (dcgmHandle_t pDcgmHandle, dcgmValueView_v1 views[], unsigned int count),
+                 "(%p %p %u)",
+                 pDcgmHandle,
+                 views,
+                 count)
+
+DCGM_ENTRY_POINT(dcgmEmbeddedReleaseValueViews,
+                 tsapiEmbeddedReleaseValueViews,
+                 (dcgmHandle_t pDcgmHandle),
+                 "(%p)",
+                 pDcgmHandle)
+
+DCGM_ENTRY_POINT(dcgmEntityGetValuesSinceAsync,
+                 tsapiEntityGetValuesSinceAsync,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgm_field_entity_group_t entityGroup,
+                  dcgm_field_eid_t entityId,
+                  unsigned short fieldId,
+                  long long sinceTimestamp,
+                  int *count,
+                  dcgmFieldValue_v1 values[],
+                  dcgmRequestComplete_f callback,
+                  void *userData),
+                 "(%p %u %u %u %lld %p %p %p %p)",
+                 pDcgmHandle,
+                 entityGroup,
+                 entityId,
+                 fieldId,
+                 sinceTimestamp,
+                 count,
+                 values,
+                 callback,
+                 userData)
+
 DCGM_ENTRY_POINT(dcgmWatchFields,
                  tsapiWatchFields,
                  (dcgmHandle_t pDcgmHandle,
@@ -561,6 +827,29 @@ DCGM_ENTRY_POINT(dcgmWatchFields,
                  maxKeepAge,
                  maxKeepSamples)
 
+DCGM_ENTRY_POINT(dcgmWatchFieldsSnapshot,
+                 tsapiWatchFieldsSnapshot,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmGpuGrp_t groupId,
+                  dcgmFieldGrp_t fieldGroupId,
+                  long long updateFreq,
+                  double maxKeepAge,
+                  int maxKeepSamples),
+                 "(%p %p, %p, %lld, %f, %d)",
+                 pDcgmHandle,
+                 groupId,
+                 fieldGroupId,
+                 updateFreq,
+                 maxKeepAge,
+                 maxKeepSamples)
+
+DCGM_ENTRY_POINT(dcgmSetDerivedField,
+                 tsapiSetDerivedField,
+                 (dcgmHandle_t pDcgmHandle, dcgmDerivedField_t *derivedField),
+                 "(%p %p)",
+                 pDcgmHandle,
+                 derivedField)
+
 DCGM_ENTRY_POINT(dcgmUnwatchFields,
                  tsapiUnwatchFields,
                  (dcgmHandle_t pDcgmHandle, dcgmGpuGrp_t groupId, dcgmFieldGrp_t fieldGroupId),
@@ -635,6 +924,20 @@ DCGM_ENTRY_POINT(dcgmHealthCheck,
                  groupId,
                  results)
 
+DCGM_ENTRY_POINT(dcgmHealthCheckAsync,
+                 tsapiEngineHealthCheckAsync,
+                 (dcgmHandle_t pDcgmHandle,
+                  dcgmGpuGrp_t groupId,
+                  dcgmHealthResponse_t *results,
+                  dcgmRequestComplete_f callback,
+                  void *userData),
+                 "(%p %p %p %p %p)",
+                 pDcgmHandle,
+                 groupId,
+                 results,
+                 callback,
+                 userData)
+
 DCGM_ENTRY_POINT(dcgmActionValidate_v2,
                  tsapiEngineActionValidate_v2,
                  (dcgmHandle_t pDcgmHandle, dcgmRunDiag_t *drd, dcgmDiagResponse_t *response),
@@ -692,6 +995,18 @@ DCGM_ENTRY_POINT(dcgmGetDeviceTopology,
                  gpuId,
                  deviceTopology)
 
+DCGM_ENTRY_POINT(dcgmGetDeviceTopologyBulk,
+                 tsapiEngineGetDeviceTopologyBulk,
+                 (dcgmHandle_t pDcgmHandle,
+                  unsigned int gpuIds[],
+                  unsigned int count,
+                  dcgmDeviceTopology_t topologies[]),
+                 "(%p %p %u %p)",
+                 pDcgmHandle,
+                 gpuIds,
+                 count,
+                 topologies)
+
 DCGM_ENTRY_POINT(dcgmGetGroupTopology,
                  tsapiEngineGroupTopology,
                  (dcgmHandle_t pDcgmHandle, dcgmGpuGrp_t groupId, dcgmGroupTopology_t *groupTopology),
@@ -735,6 +1050,40 @@ DCGM_ENTRY_POINT(dcgmJobGetStats,
                  jobId,
                  pJobInfo)
 
+DCGM_ENTRY_POINT(dcgmJobGetStatsSince,
+                 tsapiJobGetStatsSince,
+                 (dcgmHandle_t pDcgmHandle,
+                  char jobId[64],
+                  unsigned long long *updateSequence,
+                  dcgmJobInfo_t *pJobInfo),
+                 "(%p %p %p %p)",
+                 pDcgmHandle,
+                 jobId,
+                 updateSequence,
+                 pJobInfo)
+
+DCGM_ENTRY_POINT(dcgmJobGetPercentiles,
+                 tsapiJobGetPercentiles,
+                 (dcgmHandle_t pDcgmHandle, char jobId[64], dcgmJobPercentiles_t *percentiles),
+                 "(%p %p %p)",
+                 pDcgmHandle,
+                 jobId,
+                 percentiles)
+
+DCGM_ENTRY_POINT(dcgmJobGetStatsAsync,
+                 tsapiEngineJobGetStatsAsync,
+                 (dcgmHandle_t pDcgmHandle,
+                  char jobId[64],
+                  dcgmJobInfo_t *pJobInfo,
+                  dcgmRequestComplete_f callback,
+                  void *userData),
+                 "(%p %p %p %p %p)",
+                 pDcgmHandle,
+                 jobId,
+                 pJobInfo,
+                 callback,
+                 userData)
+
 DCGM_ENTRY_POINT(dcgmJobRemove,
                  tsapiEngineJobRemove,
                  (dcgmHandle_t pDcgmHandle, char jobId[64]),
@@ -795,6 +1144,35 @@ DCGM_ENTRY_POINT(dcgmIntrospectGetHostengineCpuUtilization,
                  cpuUtil,
                  waitIfNoData)
 
+DCGM_ENTRY_POINT(dcgmIntrospectGetHostengineThreadCpuUtilization,
+                 tsapiIntrospectGetHostengineThreadCpuUtilization,
+                 (dcgmHandle_t pDcgmHandle, dcgmIntrospectThreadCpuUtil_t *cpuUtil, int waitIfNoData),
+                 "(%p %p %d)",
+                 pDcgmHandle,
+                 cpuUtil,
+                 waitIfNoData)
+
+DCGM_ENTRY_POINT(dcgmIntrospectGetRequestStats,
+                 tsapiIntrospectGetRequestStats,
+                 (dcgmHandle_t pDcgmHandle, dcgmIntrospectRequestStats_t *requestStats),
+                 "(%p %p)",
+                 pDcgmHandle,
+                 requestStats)
+
+DCGM_ENTRY_POINT(dcgmIntrospectGetMemoryAccounting,
+                 tsapiIntrospectGetMemoryAccounting,
+                 (dcgmHandle_t pDcgmHandle, dcgmIntrospectMemoryAccounting_t *accounting),
+                 "(%p %p)",
+                 pDcgmHandle,
+                 accounting)
+
+DCGM_ENTRY_POINT(dcgmIntrospectEstimateWatchCost,
+                 tsapiIntrospectEstimateWatchCost,
+                 (dcgmHandle_t pDcgmHandle, dcgmIntrospectWatchCost_t *cost),
+                 "(%p %p)",
+                 pDcgmHandle,
+                 cost)
+
 DCGM_ENTRY_POINT(dcgmIntrospectGetFieldsMemoryUsage,
                  tsapiIntrospectGetFieldsMemoryUsage,
                  (dcgmHandle_t pDcgmHandle,
@@ -905,6 +1283,13 @@ DCGM_ENTRY_POINT(dcgmHostengineIsHealthy,
                  dcgmHandle,
                  heHealth)
 
+DCGM_ENTRY_POINT(dcgmHostengineGetWorkerStats,
+                 tsapiHostengineGetWorkerStats,
+                 (dcgmHandle_t dcgmHandle, dcgmHostengineWorkerStats_t *stats),
+                 "(%p, %p)",
+                 dcgmHandle,
+                 stats)
+
 DCGM_ENTRY_POINT(dcgmModuleIdToName,
                  tsapiDcgmModuleIdToName,
                  (dcgmModuleId_t id, char const **name),
@@ -19,8 +19,11 @@
 #include <cstdint>
 #include <cstdio>
 
+#include "DcgmAttributeCache.h"
 #include "DcgmBuildInfo.hpp"
 #include "DcgmFvBuffer.h"
+#include "DcgmFvStreamRequest.h"
+#include "DcgmProxyStreamRequest.h"
 #include "DcgmLogging.h"
 #include "DcgmModuleApi.h"
 #include "DcgmPolicyRequest.h"
@@ -230,6 +233,23 @@ static void dcgmapiReleaseClientHandler()
     dcgmGlobalsUnlock();
 }
 
+/*****************************************************************************/
+/* Get the attribute cache of a connection. Returns nullptr unless the connection
+   enabled one with dcgmClientCacheEnable */
+static std::shared_ptr<DcgmAttributeCache> dcgmapiGetAttributeCache(dcgmHandle_t dcgmHandle)
+{
+    if (dcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+        return nullptr;
+
+    DcgmClientHandler *clientHandler = dcgmapiAcquireClientHandler(false);
+    if (!clientHandler)
+        return nullptr;
+
+    std::shared_ptr<DcgmAttributeCache> cache = clientHandler->GetAttributeCache(dcgmHandle);
+    dcgmapiReleaseClientHandler();
+    return cache;
+}
+
 /*****************************************************************************/
 /* free the client handler that was allocated with dcgmapiAcquireClientHandler */
 static void dcgmapiFreeClientHandler()
@@ -434,6 +454,52 @@ dcgmReturn_t processModuleCommandAtEmbeddedHostEngine(dcgm_module_command_header
     return ret;
 }
 
+/*****************************************************************************/
+/* Send moduleCommand to a remote host engine without waiting for its response.
+   See DcgmClientHandler::SendModuleCommandAsync for when callback is invoked */
+static dcgmReturn_t processModuleCommandAtRemoteHostEngineAsync(dcgmHandle_t pDcgmHandle,
+                                                                dcgm_module_command_header_t *moduleCommand,
+                                                                size_t maxResponseSize,
+                                                                DcgmClientHandler::ModuleCommandCallback callback)
+{
+    if ((dcgmHandle_t) nullptr == pDcgmHandle)
+    {
+        DCGM_LOG_ERROR << "Invalid DCGM handle passed to processModuleCommandAtRemoteHostEngineAsync. Handle = nullptr";
+        return DCGM_ST_BADPARAM;
+    }
+
+    DcgmClientHandler *clientHandler = dcgmapiAcquireClientHandler(true);
+    if (!clientHandler)
+    {
+        DCGM_LOG_ERROR << "Unable to acqire the client handler";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    moduleCommand->connectionId = pDcgmHandle;
+
+    dcgmReturn_t ret
+        = clientHandler->SendModuleCommandAsync(pDcgmHandle, moduleCommand, maxResponseSize, std::move(callback));
+
+    dcgmapiReleaseClientHandler();
+    return ret;
+}
+
+/*****************************************************************************/
+/* Check that an async module command that succeeded got a response of at least responseSize */
+static dcgmReturn_t helperCheckAsyncResponse(dcgmReturn_t dcgmReturn,
+                                             dcgm_module_command_header_t *response,
+                                             size_t responseSize)
+{
+    if (dcgmReturn == DCGM_ST_OK && response->length < responseSize)
+    {
+        DCGM_LOG_ERROR << "Module command response of " << response->length << " bytes is shorter than "
+                       << responseSize;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return dcgmReturn;
+}
+
 
 /*****************************************************************************/
 dcgmReturn_t processModuleCommandAtHostEngine(dcgmHandle_t pDcgmHandle,
@@ -455,6 +521,42 @@ dcgmReturn_t processModuleCommandAtHostEngine(dcgmHandle_t pDcgmHandle,
     }
 }
 
+/*****************************************************************************/
+dcgmReturn_t processModuleCommandBatchAtHostEngine(dcgmHandle_t pDcgmHandle,
+                                                   std::vector<char> &batch,
+                                                   unsigned int timeout)
+{
+    if (pDcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+    {
+        DcgmHostEngineHandler *pHEHandlerInstance = DcgmHostEngineHandler::Instance();
+        if (pHEHandlerInstance == nullptr)
+        {
+            DCGM_LOG_ERROR << "DcgmHostEngineHandler::Instance() returned NULL";
+            return DCGM_ST_UNINITIALIZED;
+        }
+
+        return pHEHandlerInstance->ProcessModuleCommandBatch(DCGM_CONNECTION_ID_NONE, DCGM_REQUEST_ID_NONE, batch);
+    }
+
+    if ((dcgmHandle_t) nullptr == pDcgmHandle)
+    {
+        DCGM_LOG_ERROR << "Invalid DCGM handle passed to processModuleCommandBatchAtHostEngine. Handle = nullptr";
+        return DCGM_ST_BADPARAM;
+    }
+
+    DcgmClientHandler *clientHandler = dcgmapiAcquireClientHandler(true);
+    if (!clientHandler)
+    {
+        DCGM_LOG_ERROR << "Unable to acqire the client handler";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    dcgmReturn_t ret = clientHandler->ExchangeModuleCommandBatch(pDcgmHandle, batch, timeout);
+
+    dcgmapiReleaseClientHandler();
+    return ret;
+}
+
 /*****************************************************************************/
 dcgmReturn_t helperGroupCreate(dcgmHandle_t pDcgmHandle,
                                dcgmGroupType_t type,
@@ -1105,95 +1207,155 @@ dcgmReturn_t cmHelperGroupGetInfo(dcgmHandle_t pDcgmHandle,
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t helperGetLatestValuesForFields(dcgmHandle_t dcgmHandle,
-                                            dcgmGpuGrp_t groupId,
-                                            dcgmGroupEntityPair_t *entityList,
-                                            unsigned int entityListCount,
-                                            dcgmFieldGrp_t fieldGroupId,
-                                            unsigned short fieldIdList[],
-                                            unsigned int fieldIdListCount,
-                                            DcgmFvBuffer *fvBuffer,
-                                            unsigned int flags)
-{
-    DcgmProtobuf encodePrb;                  /* Protobuf message for encoding */
-    DcgmProtobuf decodePrb;                  /* Protobuf message for decoding */
-    dcgm::Command *pCmdTemp;                 /* Pointer to proto command for intermediate usage */
-    std::vector<dcgm::Command *> vecCmdsRef; /* Vector of proto commands. Used as output parameter */
-    dcgmReturn_t ret;
-    dcgmGetMultipleLatestValues_t msg;
-
-    if ((entityList && !entityListCount) || (fieldIdList && !fieldIdListCount) || !fvBuffer
-        || entityListCount > DCGM_GROUP_MAX_ENTITIES || fieldIdListCount > DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP)
-    {
-        PRINT_ERROR("", "Bad parameter");
-        return DCGM_ST_BADPARAM;
-    }
-
-    /* Add Command to be sent over the network */
-    pCmdTemp = encodePrb.AddCommand(dcgm::GET_MULTIPLE_LATEST_VALUES, dcgm::OPERATION_SYSTEM, 0, 0);
-    if (NULL == pCmdTemp)
-    {
-        PRINT_ERROR("", "encodePrb.AddCommand failed.");
-        return DCGM_ST_GENERIC_ERROR;
-    }
-
-    dcgm::CmdArg *pCmdArg = pCmdTemp->add_arg();
-
-    memset(&msg, 0, sizeof(msg));
-    msg.version = dcgmGetMultipleLatestValues_version;
-    msg.flags   = flags;
+/*****************************************************************************/
+/* Build a DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES request with room for bufferCapacity
+   bytes of values in msgBytes. See helperGetLatestValuesForFields for the other params */
+static void helperInitMultipleLatestValuesMsg(std::vector<char> &msgBytes,
+                                              dcgmGpuGrp_t groupId,
+                                              dcgmGroupEntityPair_t *entityList,
+                                              unsigned int entityListCount,
+                                              dcgmFieldGrp_t fieldGroupId,
+                                              unsigned short fieldIdList[],
+                                              unsigned int fieldIdListCount,
+                                              unsigned int flags,
+                                              size_t bufferCapacity,
+                                              unsigned long long sinceSequence = 0)
+{
+    msgBytes.assign(sizeof(dcgm_core_msg_get_multiple_latest_values_t) + bufferCapacity, 0);
+    auto msg = (dcgm_core_msg_get_multiple_latest_values_t *)msgBytes.data();
+
+    msg->header.length     = sizeof(*msg); /* Only send the request. The host engine makes room for the values */
+    msg->header.moduleId   = DcgmModuleIdCore;
+    msg->header.subCommand = DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES;
+    msg->header.version    = dcgm_core_msg_get_multiple_latest_values_version;
+    msg->request.version   = dcgmGetMultipleLatestValues_version;
+    msg->request.flags     = flags;
+    msg->bufferCapacity    = bufferCapacity;
+    msg->sinceSequence     = sinceSequence;
 
     if (entityList)
     {
-        memmove(&msg.entities[0], entityList, entityListCount * sizeof(entityList[0]));
-        msg.entitiesCount = entityListCount;
+        memmove(&msg->request.entities[0], entityList, entityListCount * sizeof(entityList[0]));
+        msg->request.entitiesCount = entityListCount;
     }
     else
     {
-        msg.groupId = groupId;
+        msg->request.groupId = groupId;
     }
 
     if (fieldIdList)
     {
-        memmove(&msg.fieldIds[0], fieldIdList, fieldIdListCount * sizeof(fieldIdList[0]));
-        msg.fieldIdCount = fieldIdListCount;
+        memmove(&msg->request.fieldIds[0], fieldIdList, fieldIdListCount * sizeof(fieldIdList[0]));
+        msg->request.fieldIdCount = fieldIdListCount;
     }
     else
     {
-        msg.fieldGroupId = fieldGroupId;
+        msg->request.fieldGroupId = fieldGroupId;
     }
+}
 
-    pCmdArg->set_blob(&msg, sizeof(msg));
-
-    ret = processAtHostEngine(dcgmHandle, &encodePrb, &decodePrb, &vecCmdsRef);
-    if (DCGM_ST_OK != ret)
+/*****************************************************************************/
+/* Returns the bufferCapacity to retry a DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES request
+   with, or 0 if msg shouldn't be retried. attempt counts from 0 */
+static size_t helperMultipleLatestValuesRetryCapacity(dcgm_core_msg_get_multiple_latest_values_t const *msg,
+                                                      size_t bufferCapacity,
+                                                      int attempt)
+{
+    if ((dcgmReturn_t)msg->cmdRet != DCGM_ST_INSUFFICIENT_SIZE || attempt >= 2
+        || bufferCapacity >= DCGM_FV_REPLY_MAX_BUFFER_SIZE)
     {
-        PRINT_ERROR("%d", "processAtHostEngine returned %d", (int)ret);
-        return ret;
+        return 0;
     }
 
-    if (vecCmdsRef.size() < 1 || vecCmdsRef[0]->arg_size() < 1)
-    {
-        PRINT_ERROR("", "Malformed GET_MULTIPLE_LATEST_VALUES response 1.");
-        return DCGM_ST_GENERIC_ERROR;
-    }
+    /* Values can be added between attempts, so leave some slack when growing */
+    return std::min<size_t>(msg->bufferSize + msg->bufferSize / 8, DCGM_FV_REPLY_MAX_BUFFER_SIZE);
+}
 
+/*****************************************************************************/
+/* Load the values of a DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES response into fvBuffer.
+   bufferCapacity is what the request asked for */
+static dcgmReturn_t helperReadMultipleLatestValuesMsg(dcgm_core_msg_get_multiple_latest_values_t *msg,
+                                                      size_t bufferCapacity,
+                                                      DcgmFvBuffer *fvBuffer)
+{
     /* Did the request return a global request error (vs a field value status)? */
-    if (vecCmdsRef[0]->has_status() && vecCmdsRef[0]->status() != DCGM_ST_OK)
+    if (DCGM_ST_OK != msg->cmdRet)
     {
-        PRINT_ERROR("%d", "Got message status %d", (int)vecCmdsRef[0]->status());
-        return (dcgmReturn_t)vecCmdsRef[0]->status();
+        DCGM_LOG_ERROR << "Got message status " << msg->cmdRet;
+        return (dcgmReturn_t)msg->cmdRet;
     }
 
-    if (!vecCmdsRef[0]->arg(0).has_blob())
+    if (msg->bufferSize > bufferCapacity || msg->header.length != sizeof(*msg) + msg->bufferSize)
     {
-        PRINT_ERROR("", "Malformed GET_MULTIPLE_LATEST_VALUES missing blob.");
+        DCGM_LOG_ERROR << "Malformed DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES response. bufferSize "
+                       << msg->bufferSize << ", length " << msg->header.length;
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    /* Make a FV buffer from our protobuf string */
-    fvBuffer->SetFromBuffer(vecCmdsRef[0]->arg(0).blob().c_str(), vecCmdsRef[0]->arg(0).blob().size());
-    return DCGM_ST_OK;
+    return fvBuffer->SetFromBuffer((char *)msg + sizeof(*msg), msg->bufferSize);
+}
+
+dcgmReturn_t helperGetLatestValuesForFields(dcgmHandle_t dcgmHandle,
+                                            dcgmGpuGrp_t groupId,
+                                            dcgmGroupEntityPair_t *entityList,
+                                            unsigned int entityListCount,
+                                            dcgmFieldGrp_t fieldGroupId,
+                                            unsigned short fieldIdList[],
+                                            unsigned int fieldIdListCount,
+                                            DcgmFvBuffer *fvBuffer,
+                                            unsigned int flags,
+                                            unsigned long long sinceSequence    = 0,
+                                            unsigned long long *updateSequence = nullptr)
+{
+    dcgmReturn_t ret;
+
+    if ((entityList && !entityListCount) || (fieldIdList && !fieldIdListCount) || !fvBuffer
+        || entityListCount > DCGM_GROUP_MAX_ENTITIES || fieldIdListCount > DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP)
+    {
+        PRINT_ERROR("", "Bad parameter");
+        return DCGM_ST_BADPARAM;
+    }
+
+    /* The reply carries the values as a DcgmFvBuffer after the message. Start with room for
+       the values we expect and grow if the host engine says that wasn't enough */
+    size_t bufferCapacity = SAMPLES_BUFFER_SIZE;
+    if (entityList && fieldIdList)
+        bufferCapacity = std::max(bufferCapacity, FVBUFFER_GUESS_INITIAL_CAPACITY(entityListCount, fieldIdListCount));
+
+    std::vector<char> msgBytes;
+    for (int attempt = 0;; attempt++)
+    {
+        helperInitMultipleLatestValuesMsg(msgBytes,
+                                          groupId,
+                                          entityList,
+                                          entityListCount,
+                                          fieldGroupId,
+                                          fieldIdList,
+                                          fieldIdListCount,
+                                          flags,
+                                          bufferCapacity,
+                                          sinceSequence);
+        auto msg = (dcgm_core_msg_get_multiple_latest_values_t *)msgBytes.data();
+
+        ret = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg->header, msgBytes.size());
+        if (DCGM_ST_OK != ret)
+        {
+            DCGM_LOG_ERROR << "dcgmModuleSendBlockingFixedRequest returned " << ret;
+            return ret;
+        }
+
+        size_t const retryCapacity = helperMultipleLatestValuesRetryCapacity(msg, bufferCapacity, attempt);
+        if (retryCapacity > 0)
+        {
+            bufferCapacity = retryCapacity;
+            continue;
+        }
+
+        ret = helperReadMultipleLatestValuesMsg(msg, bufferCapacity, fvBuffer);
+        if (ret == DCGM_ST_OK && updateSequence)
+            *updateSequence = msg->updateSequence;
+        return ret;
+    }
 }
 
 /*****************************************************************************
@@ -1286,6 +1448,34 @@ dcgmReturn_t cmHelperGetLatestValuesForFields(dcgmHandle_t dcgmHandle,
     return DCGM_ST_OK;
 }
 
+/****************************************************************************/
+/* Convert the values of fvBuffer to values[], which must be expectedCount long */
+static dcgmReturn_t helperFvBufferToFv2Array(DcgmFvBuffer &fvBuffer, size_t expectedCount, dcgmFieldValue_v2 values[])
+{
+    size_t bufferSize = 0, elementCount = 0;
+    dcgmReturn_t dcgmReturn = fvBuffer.GetSize(&bufferSize, &elementCount);
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+
+    /* Check that we got as many fields back as we requested */
+    if (elementCount != expectedCount)
+    {
+        DCGM_LOG_ERROR << "Returned FV mismatch. Requested " << expectedCount << " != returned " << elementCount;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    /* Convert the buffered FVs to our output array */
+    dcgmBufferedFvCursor_t cursor = 0;
+    unsigned int valuesIndex      = 0;
+    for (dcgmBufferedFv_t *fv = fvBuffer.GetNextFv(&cursor); fv; fv = fvBuffer.GetNextFv(&cursor))
+    {
+        fvBuffer.ConvertBufferedFvToFv2(fv, &values[valuesIndex]);
+        valuesIndex++;
+    }
+
+    return DCGM_ST_OK;
+}
+
 /****************************************************************************/
 dcgmReturn_t tsapiEntitiesGetLatestValues(dcgmHandle_t dcgmHandle,
                                           dcgmGroupEntityPair_t entities[],
@@ -1310,29 +1500,188 @@ dcgmReturn_t tsapiEntitiesGetLatestValues(dcgmHandle_t dcgmHandle,
     if (dcgmReturn != DCGM_ST_OK)
         return dcgmReturn;
 
+    return helperFvBufferToFv2Array(fvBuffer, entityCount * fieldCount, values);
+}
+
+/****************************************************************************/
+dcgmReturn_t tsapiEntitiesGetLatestValuesSince(dcgmHandle_t dcgmHandle,
+                                               dcgmGroupEntityPair_t entities[],
+                                               unsigned int entityCount,
+                                               unsigned short fields[],
+                                               unsigned int fieldCount,
+                                               unsigned int flags,
+                                               unsigned long long *updateSequence,
+                                               dcgmFieldValue_v2 values[],
+                                               unsigned int *valuesCount)
+{
+    dcgmReturn_t dcgmReturn;
+
+    if (!entities || entityCount < 1 || !fields || fieldCount < 1 || !updateSequence || !values || !valuesCount)
+    {
+        DCGM_LOG_ERROR << "Bad parameter";
+        return DCGM_ST_BADPARAM;
+    }
+
+    *valuesCount = 0;
+
+    DcgmFvBuffer fvBuffer(0);
+    unsigned long long newUpdateSequence = 0;
+
+    dcgmReturn = helperGetLatestValuesForFields(dcgmHandle,
+                                                0,
+                                                entities,
+                                                entityCount,
+                                                0,
+                                                fields,
+                                                fieldCount,
+                                                &fvBuffer,
+                                                flags,
+                                                *updateSequence,
+                                                &newUpdateSequence);
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+
+    /* Only what changed is returned, so anything up to every requested value is fine */
     size_t bufferSize = 0, elementCount = 0;
     dcgmReturn = fvBuffer.GetSize(&bufferSize, &elementCount);
     if (dcgmReturn != DCGM_ST_OK)
         return dcgmReturn;
 
-    /* Check that we got as many fields back as we requested */
-    if (elementCount != fieldCount * entityCount)
+    if (elementCount > (size_t)entityCount * fieldCount)
     {
-        DCGM_LOG_ERROR << "Returned FV mismatch. Requested " << entityCount * fieldCount << " != returned "
+        DCGM_LOG_ERROR << "Returned FV mismatch. Requested at most " << entityCount * fieldCount << " < returned "
                        << elementCount;
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    /* Convert the buffered FVs to our output array */
-    dcgmBufferedFvCursor_t cursor = 0;
-    unsigned int valuesIndex      = 0;
-    for (dcgmBufferedFv_t *fv = fvBuffer.GetNextFv(&cursor); fv; fv = fvBuffer.GetNextFv(&cursor))
+    dcgmReturn = helperFvBufferToFv2Array(fvBuffer, elementCount, values);
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+
+    *valuesCount    = elementCount;
+    *updateSequence = newUpdateSequence;
+    return DCGM_ST_OK;
+}
+
+/****************************************************************************/
+/* A dcgmEntitiesGetLatestValuesAsync request. Lives until its callback is invoked */
+struct dcgmapiLatestValuesAsync_t
+{
+    std::vector<dcgmGroupEntityPair_t> entities;
+    std::vector<unsigned short> fields;
+    unsigned int flags;
+    dcgmFieldValue_v2 *values;
+    dcgmRequestComplete_f callback;
+    void *userData;
+};
+
+/****************************************************************************/
+/* Send one attempt of request with room for bufferCapacity bytes of values. Retries from the
+   response like helperGetLatestValuesForFields does, so the client handler is used directly
+   rather than acquired on its own thread */
+static dcgmReturn_t helperSendLatestValuesAsync(DcgmClientHandler *clientHandler,
+                                                dcgmHandle_t dcgmHandle,
+                                                std::shared_ptr<dcgmapiLatestValuesAsync_t> request,
+                                                size_t bufferCapacity,
+                                                int attempt)
+{
+    std::vector<char> msgBytes;
+    helperInitMultipleLatestValuesMsg(msgBytes,
+                                      0,
+                                      request->entities.data(),
+                                      request->entities.size(),
+                                      0,
+                                      request->fields.data(),
+                                      request->fields.size(),
+                                      request->flags,
+                                      bufferCapacity);
+    auto msg                 = (dcgm_core_msg_get_multiple_latest_values_t *)msgBytes.data();
+    msg->header.connectionId = dcgmHandle;
+
+    auto onResponse = [clientHandler, dcgmHandle, request, bufferCapacity, attempt](
+                          dcgmReturn_t dcgmReturn, dcgm_module_command_header_t *response) {
+        auto reply = (dcgm_core_msg_get_multiple_latest_values_t *)response;
+        dcgmReturn = helperCheckAsyncResponse(dcgmReturn, response, sizeof(*reply));
+        if (dcgmReturn == DCGM_ST_OK)
+        {
+            size_t const retryCapacity = helperMultipleLatestValuesRetryCapacity(reply, bufferCapacity, attempt);
+            if (retryCapacity > 0
+                && helperSendLatestValuesAsync(clientHandler, dcgmHandle, request, retryCapacity, attempt + 1)
+                       == DCGM_ST_OK)
+            {
+                return; /* The retry completes the request */
+            }
+
+            DcgmFvBuffer fvBuffer(0);
+            dcgmReturn = helperReadMultipleLatestValuesMsg(reply, bufferCapacity, &fvBuffer);
+            if (dcgmReturn == DCGM_ST_OK)
+            {
+                dcgmReturn = helperFvBufferToFv2Array(
+                    fvBuffer, request->entities.size() * request->fields.size(), request->values);
+            }
+        }
+
+        request->callback(dcgmReturn, request->userData);
+    };
+
+    return clientHandler->SendModuleCommandAsync(dcgmHandle, &msg->header, msgBytes.size(), std::move(onResponse));
+}
+
+/****************************************************************************/
+static dcgmReturn_t tsapiEntitiesGetLatestValuesAsync(dcgmHandle_t dcgmHandle,
+                                                      dcgmGroupEntityPair_t entities[],
+                                                      unsigned int entityCount,
+                                                      unsigned short fields[],
+                                                      unsigned int fieldCount,
+                                                      unsigned int flags,
+                                                      dcgmFieldValue_v2 values[],
+                                                      dcgmRequestComplete_f callback,
+                                                      void *userData)
+{
+    if (!entities || entityCount < 1 || !fields || fieldCount < 1 || !values || !callback
+        || entityCount > DCGM_GROUP_MAX_ENTITIES || fieldCount > DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP)
     {
-        fvBuffer.ConvertBufferedFvToFv2(fv, &values[valuesIndex]);
-        valuesIndex++;
+        DCGM_LOG_ERROR << "Bad parameter";
+        return DCGM_ST_BADPARAM;
     }
 
-    return DCGM_ST_OK;
+    if (dcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+    {
+        /* The embedded host engine answers without a round trip */
+        callback(tsapiEntitiesGetLatestValues(dcgmHandle, entities, entityCount, fields, fieldCount, flags, values),
+                 userData);
+        return DCGM_ST_OK;
+    }
+
+    if ((dcgmHandle_t) nullptr == dcgmHandle)
+    {
+        DCGM_LOG_ERROR << "Invalid DCGM handle. Handle = nullptr";
+        return DCGM_ST_BADPARAM;
+    }
+
+    auto request = std::make_shared<dcgmapiLatestValuesAsync_t>();
+    request->entities.assign(entities, entities + entityCount);
+    request->fields.assign(fields, fields + fieldCount);
+    request->flags    = flags;
+    request->values   = values;
+    request->callback = callback;
+    request->userData = userData;
+
+    size_t bufferCapacity = SAMPLES_BUFFER_SIZE;
+    bufferCapacity        = std::max(bufferCapacity, FVBUFFER_GUESS_INITIAL_CAPACITY(entityCount, fieldCount));
+
+    DcgmClientHandler *clientHandler = dcgmapiAcquireClientHandler(true);
+    if (!clientHandler)
+    {
+        DCGM_LOG_ERROR << "Unable to acqire the client handler";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    dcgmReturn_t dcgmReturn
+        = helperSendLatestValuesAsync(clientHandler, dcgmHandle, std::move(request), bufferCapacity, 0);
+
+    dcgmapiReleaseClientHandler();
+    return dcgmReturn;
 }
 
 dcgmReturn_t helperGetAllDevices(dcgmHandle_t pDcgmHandle, unsigned int *pGpuIdList, int *pCount, int onlySupported)
@@ -1350,6 +1699,21 @@ dcgmReturn_t helperGetAllDevices(dcgmHandle_t pDcgmHandle, unsigned int *pGpuIdL
         return DCGM_ST_BADPARAM;
     }
 
+    std::shared_ptr<DcgmAttributeCache> cache = dcgmapiGetAttributeCache(pDcgmHandle);
+    DcgmAttributeCache::Key const cacheKey { DcgmAttributeCacheKindAllDevices, onlySupported, 0 };
+    unsigned long long cacheGeneration = 0;
+    if (cache != nullptr)
+    {
+        std::vector<char> cached;
+        if (cache->Lookup(cacheKey, cached))
+        {
+            *pCount = (int)(cached.size() / sizeof(unsigned int));
+            memcpy(pGpuIdList, cached.data(), cached.size());
+            return DCGM_ST_OK;
+        }
+        cacheGeneration = cache->GetGeneration();
+    }
+
     /* Add Command to the protobuf encoder object */
     pCmdTemp = encodePrb.AddCommand(dcgm::DISCOVER_DEVICES, dcgm::OPERATION_SYSTEM, -1, 0);
     if (NULL == pCmdTemp)
@@ -1391,6 +1755,11 @@ dcgmReturn_t helperGetAllDevices(dcgmHandle_t pDcgmHandle, unsigned int *pGpuIdL
         pGpuIdList[index] = pListGpuIdsOutput->mutable_vals(index)->i64();
     }
 
+    if (cache != nullptr)
+    {
+        cache->Store(cacheKey, cacheGeneration, pGpuIdList, *pCount * sizeof(unsigned int));
+    }
+
     return DCGM_ST_OK;
 }
 
@@ -1441,381 +1810,435 @@ dcgmReturn_t cmHelperGetAllDevices(dcgmHandle_t pDcgmHandle, unsigned int *pGpuI
 }
 
 /**
- * Common helper to get device attributes
- * @param mode
- * @param pDcgmHandle
- * @param gpuId
- * @param pDcgmDeviceAttr
- * @return
+ * Store the value of one of the fields fetched by helperDeviceGetAttributesBulk in the attributes of its GPU
  */
-dcgmReturn_t helperDeviceGetAttributes(dcgmHandle_t pDcgmHandle, int gpuId, dcgmDeviceAttributes_t *pDcgmDeviceAttr)
+static dcgmReturn_t helperDecodeDeviceAttribute(dcgmBufferedFv_t *fv, dcgmDeviceAttributes_t *pDcgmDeviceAttr)
 {
-    unsigned short fieldIds[34];
-    dcgmBufferedFv_t *fv;
-    unsigned int count = 0;
-    dcgmReturn_t ret;
-
-    if (NULL == pDcgmDeviceAttr)
+    switch (fv->fieldId)
     {
-        return DCGM_ST_BADPARAM;
-    }
+        case DCGM_FI_DEV_SLOWDOWN_TEMP:
+            pDcgmDeviceAttr->thermalSettings.slowdownTemp = (unsigned int)nvcmvalue_int64_to_int32(fv->value.i64);
+            break;
 
-    if (pDcgmDeviceAttr->version != dcgmDeviceAttributes_version)
-    {
-        return DCGM_ST_VER_MISMATCH;
-    }
+        case DCGM_FI_DEV_SHUTDOWN_TEMP:
+            pDcgmDeviceAttr->thermalSettings.shutdownTemp = (unsigned int)nvcmvalue_int64_to_int32(fv->value.i64);
+            break;
 
+        case DCGM_FI_DEV_POWER_MGMT_LIMIT:
+            pDcgmDeviceAttr->powerLimits.curPowerLimit = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
+            break;
 
-    fieldIds[count++] = DCGM_FI_DEV_SLOWDOWN_TEMP;
-    fieldIds[count++] = DCGM_FI_DEV_SHUTDOWN_TEMP;
-    fieldIds[count++] = DCGM_FI_DEV_ENFORCED_POWER_LIMIT;
-    fieldIds[count++] = DCGM_FI_DEV_POWER_MGMT_LIMIT;
-    fieldIds[count++] = DCGM_FI_DEV_POWER_MGMT_LIMIT_DEF;
-    fieldIds[count++] = DCGM_FI_DEV_POWER_MGMT_LIMIT_MAX;
-    fieldIds[count++] = DCGM_FI_DEV_POWER_MGMT_LIMIT_MIN;
-    fieldIds[count++] = DCGM_FI_DEV_SUPPORTED_CLOCKS;
-    fieldIds[count++] = DCGM_FI_DEV_UUID;
-    fieldIds[count++] = DCGM_FI_DEV_VBIOS_VERSION;
-    fieldIds[count++] = DCGM_FI_DEV_INFOROM_IMAGE_VER;
-    fieldIds[count++] = DCGM_FI_DEV_BRAND;
-    fieldIds[count++] = DCGM_FI_DEV_NAME;
-    fieldIds[count++] = DCGM_FI_DEV_SERIAL;
-    fieldIds[count++] = DCGM_FI_DEV_PCI_BUSID;
-    fieldIds[count++] = DCGM_FI_DEV_PCI_COMBINED_ID;
-    fieldIds[count++] = DCGM_FI_DEV_PCI_SUBSYS_ID;
-    fieldIds[count++] = DCGM_FI_DEV_BAR1_TOTAL;
-    fieldIds[count++] = DCGM_FI_DEV_FB_TOTAL;
-    fieldIds[count++] = DCGM_FI_DEV_FB_USED;
-    fieldIds[count++] = DCGM_FI_DEV_FB_FREE;
-    fieldIds[count++] = DCGM_FI_DRIVER_VERSION;
-    fieldIds[count++] = DCGM_FI_DEV_VIRTUAL_MODE;
-    fieldIds[count++] = DCGM_FI_DEV_PERSISTENCE_MODE;
-    fieldIds[count++] = DCGM_FI_DEV_MIG_MODE;
-
-    if (count >= sizeof(fieldIds) / sizeof(fieldIds[0]))
-    {
-        PRINT_ERROR("", "Update DeviceGetAttributes to accommodate more fields\n");
-        return DCGM_ST_GENERIC_ERROR;
-    }
+        case DCGM_FI_DEV_ENFORCED_POWER_LIMIT:
+            pDcgmDeviceAttr->powerLimits.enforcedPowerLimit
+                = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
+            break;
 
-    dcgmGroupEntityPair_t entityPair;
-    entityPair.entityGroupId = DCGM_FE_GPU;
-    entityPair.entityId      = gpuId;
-    DcgmFvBuffer fvBuffer(0);
-    ret = helperGetLatestValuesForFields(
-        pDcgmHandle, 0, &entityPair, 1, 0, fieldIds, count, &fvBuffer, DCGM_FV_FLAG_LIVE_DATA);
-    if (DCGM_ST_OK != ret)
-    {
-        return ret;
-    }
+        case DCGM_FI_DEV_POWER_MGMT_LIMIT_DEF:
+            pDcgmDeviceAttr->powerLimits.defaultPowerLimit = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
 
-    size_t bufferSize = 0, elementCount = 0;
-    ret = fvBuffer.GetSize(&bufferSize, &elementCount);
-    if (elementCount != count)
-    {
-        PRINT_ERROR("%d %d %d", "Unexpected elementCount %d != count %d or ret %d", (int)elementCount, count, (int)ret);
-        /* Keep going. We will only process what we have */
-    }
+            break;
 
-    dcgmBufferedFvCursor_t cursor = 0;
-    for (fv = fvBuffer.GetNextFv(&cursor); fv; fv = fvBuffer.GetNextFv(&cursor))
-    {
-        switch (fv->fieldId)
-        {
-            case DCGM_FI_DEV_SLOWDOWN_TEMP:
-                pDcgmDeviceAttr->thermalSettings.slowdownTemp = (unsigned int)nvcmvalue_int64_to_int32(fv->value.i64);
-                break;
+        case DCGM_FI_DEV_POWER_MGMT_LIMIT_MAX:
+            pDcgmDeviceAttr->powerLimits.maxPowerLimit = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
+            break;
 
-            case DCGM_FI_DEV_SHUTDOWN_TEMP:
-                pDcgmDeviceAttr->thermalSettings.shutdownTemp = (unsigned int)nvcmvalue_int64_to_int32(fv->value.i64);
-                break;
+        case DCGM_FI_DEV_POWER_MGMT_LIMIT_MIN:
+            pDcgmDeviceAttr->powerLimits.minPowerLimit = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
+            break;
 
-            case DCGM_FI_DEV_POWER_MGMT_LIMIT:
-                pDcgmDeviceAttr->powerLimits.curPowerLimit = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
-                break;
+        case DCGM_FI_DEV_UUID:
+        {
+            size_t length;
+            length = strlen(fv->value.str);
+            if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.uuid))
+            {
+                PRINT_ERROR("", "String overflow error for the requested UUID field");
+                dcgmStrncpy(
+                    pDcgmDeviceAttr->identifiers.uuid, DCGM_STR_BLANK, sizeof(pDcgmDeviceAttr->identifiers.uuid));
+            }
+            else
+            {
+                dcgmStrncpy(
+                    pDcgmDeviceAttr->identifiers.uuid, fv->value.str, sizeof(pDcgmDeviceAttr->identifiers.uuid));
+            }
 
-            case DCGM_FI_DEV_ENFORCED_POWER_LIMIT:
-                pDcgmDeviceAttr->powerLimits.enforcedPowerLimit
-                    = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
-                break;
+            break;
+        }
 
-            case DCGM_FI_DEV_POWER_MGMT_LIMIT_DEF:
-                pDcgmDeviceAttr->powerLimits.defaultPowerLimit = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
+        case DCGM_FI_DEV_VBIOS_VERSION:
+        {
+            size_t length;
+            length = strlen(fv->value.str);
+            if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.vbios))
+            {
+                PRINT_ERROR("", "String overflow error for the requested VBIOS field");
+                dcgmStrncpy(
+                    pDcgmDeviceAttr->identifiers.vbios, DCGM_STR_BLANK, sizeof(pDcgmDeviceAttr->identifiers.vbios));
+            }
+            else
+            {
+                dcgmStrncpy(
+                    pDcgmDeviceAttr->identifiers.vbios, fv->value.str, sizeof(pDcgmDeviceAttr->identifiers.vbios));
+            }
 
-                break;
+            break;
+        }
 
-            case DCGM_FI_DEV_POWER_MGMT_LIMIT_MAX:
-                pDcgmDeviceAttr->powerLimits.maxPowerLimit = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
-                break;
+        case DCGM_FI_DEV_INFOROM_IMAGE_VER:
+        {
+            size_t length;
+            length = strlen(fv->value.str);
+            if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.inforomImageVersion))
+            {
+                PRINT_ERROR("", "String overflow error for the requested Inforom field");
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.inforomImageVersion,
+                            DCGM_STR_BLANK,
+                            sizeof(pDcgmDeviceAttr->identifiers.inforomImageVersion));
+            }
+            else
+            {
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.inforomImageVersion,
+                            fv->value.str,
+                            sizeof(pDcgmDeviceAttr->identifiers.inforomImageVersion));
+            }
 
-            case DCGM_FI_DEV_POWER_MGMT_LIMIT_MIN:
-                pDcgmDeviceAttr->powerLimits.minPowerLimit = (unsigned int)nvcmvalue_double_to_int32(fv->value.dbl);
-                break;
+            break;
+        }
 
-            case DCGM_FI_DEV_UUID:
+        case DCGM_FI_DEV_BRAND:
+        {
+            size_t length;
+            length = strlen(fv->value.str);
+            if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.brandName))
             {
-                size_t length;
-                length = strlen(fv->value.str);
-                if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.uuid))
-                {
-                    PRINT_ERROR("", "String overflow error for the requested UUID field");
-                    dcgmStrncpy(
-                        pDcgmDeviceAttr->identifiers.uuid, DCGM_STR_BLANK, sizeof(pDcgmDeviceAttr->identifiers.uuid));
-                }
-                else
-                {
-                    dcgmStrncpy(
-                        pDcgmDeviceAttr->identifiers.uuid, fv->value.str, sizeof(pDcgmDeviceAttr->identifiers.uuid));
-                }
-
-                break;
+                PRINT_ERROR("", "String overflow error for the requested brand name field");
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.brandName,
+                            DCGM_STR_BLANK,
+                            sizeof(pDcgmDeviceAttr->identifiers.brandName));
             }
-
-            case DCGM_FI_DEV_VBIOS_VERSION:
+            else
             {
-                size_t length;
-                length = strlen(fv->value.str);
-                if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.vbios))
-                {
-                    PRINT_ERROR("", "String overflow error for the requested VBIOS field");
-                    dcgmStrncpy(
-                        pDcgmDeviceAttr->identifiers.vbios, DCGM_STR_BLANK, sizeof(pDcgmDeviceAttr->identifiers.vbios));
-                }
-                else
-                {
-                    dcgmStrncpy(
-                        pDcgmDeviceAttr->identifiers.vbios, fv->value.str, sizeof(pDcgmDeviceAttr->identifiers.vbios));
-                }
-
-                break;
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.brandName,
+                            fv->value.str,
+                            sizeof(pDcgmDeviceAttr->identifiers.brandName));
             }
 
-            case DCGM_FI_DEV_INFOROM_IMAGE_VER:
-            {
-                size_t length;
-                length = strlen(fv->value.str);
-                if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.inforomImageVersion))
-                {
-                    PRINT_ERROR("", "String overflow error for the requested Inforom field");
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.inforomImageVersion,
-                                DCGM_STR_BLANK,
-                                sizeof(pDcgmDeviceAttr->identifiers.inforomImageVersion));
-                }
-                else
-                {
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.inforomImageVersion,
-                                fv->value.str,
-                                sizeof(pDcgmDeviceAttr->identifiers.inforomImageVersion));
-                }
+            break;
+        }
 
-                break;
+        case DCGM_FI_DEV_NAME:
+        {
+            size_t length;
+            length = strlen(fv->value.str);
+            if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.deviceName))
+            {
+                PRINT_ERROR("", "String overflow error for the requested device name field");
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.deviceName,
+                            DCGM_STR_BLANK,
+                            sizeof(pDcgmDeviceAttr->identifiers.deviceName));
             }
-
-            case DCGM_FI_DEV_BRAND:
+            else
             {
-                size_t length;
-                length = strlen(fv->value.str);
-                if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.brandName))
-                {
-                    PRINT_ERROR("", "String overflow error for the requested brand name field");
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.brandName,
-                                DCGM_STR_BLANK,
-                                sizeof(pDcgmDeviceAttr->identifiers.brandName));
-                }
-                else
-                {
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.brandName,
-                                fv->value.str,
-                                sizeof(pDcgmDeviceAttr->identifiers.brandName));
-                }
-
-                break;
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.deviceName,
+                            fv->value.str,
+                            sizeof(pDcgmDeviceAttr->identifiers.deviceName));
             }
 
-            case DCGM_FI_DEV_NAME:
-            {
-                size_t length;
-                length = strlen(fv->value.str);
-                if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.deviceName))
-                {
-                    PRINT_ERROR("", "String overflow error for the requested device name field");
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.deviceName,
-                                DCGM_STR_BLANK,
-                                sizeof(pDcgmDeviceAttr->identifiers.deviceName));
-                }
-                else
-                {
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.deviceName,
-                                fv->value.str,
-                                sizeof(pDcgmDeviceAttr->identifiers.deviceName));
-                }
+            break;
+        }
 
-                break;
+        case DCGM_FI_DEV_SERIAL:
+        {
+            size_t length;
+            length = strlen(fv->value.str);
+            if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.serial))
+            {
+                PRINT_ERROR("", "String overflow error for the requested serial field");
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.serial,
+                            DCGM_STR_BLANK,
+                            sizeof(pDcgmDeviceAttr->identifiers.serial));
             }
-
-            case DCGM_FI_DEV_SERIAL:
+            else
             {
-                size_t length;
-                length = strlen(fv->value.str);
-                if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.serial))
-                {
-                    PRINT_ERROR("", "String overflow error for the requested serial field");
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.serial,
-                                DCGM_STR_BLANK,
-                                sizeof(pDcgmDeviceAttr->identifiers.serial));
-                }
-                else
-                {
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.serial,
-                                fv->value.str,
-                                sizeof(pDcgmDeviceAttr->identifiers.serial));
-                }
-
-                break;
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.serial,
+                            fv->value.str,
+                            sizeof(pDcgmDeviceAttr->identifiers.serial));
             }
 
-            case DCGM_FI_DEV_PCI_BUSID:
-            {
-                size_t length;
-                length = strlen(fv->value.str);
-                if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.pciBusId))
-                {
-                    PRINT_ERROR("", "String overflow error for the requested serial field");
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.pciBusId,
-                                DCGM_STR_BLANK,
-                                sizeof(pDcgmDeviceAttr->identifiers.pciBusId));
-                }
-                else
-                {
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.pciBusId,
-                                fv->value.str,
-                                sizeof(pDcgmDeviceAttr->identifiers.pciBusId));
-                }
+            break;
+        }
 
-                break;
+        case DCGM_FI_DEV_PCI_BUSID:
+        {
+            size_t length;
+            length = strlen(fv->value.str);
+            if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.pciBusId))
+            {
+                PRINT_ERROR("", "String overflow error for the requested serial field");
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.pciBusId,
+                            DCGM_STR_BLANK,
+                            sizeof(pDcgmDeviceAttr->identifiers.pciBusId));
             }
-
-            case DCGM_FI_DEV_SUPPORTED_CLOCKS:
+            else
             {
-                dcgmDeviceSupportedClockSets_t *supClocks = (dcgmDeviceSupportedClockSets_t *)fv->value.blob;
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.pciBusId,
+                            fv->value.str,
+                            sizeof(pDcgmDeviceAttr->identifiers.pciBusId));
+            }
 
-                if (!supClocks)
-                {
-                    memset(&pDcgmDeviceAttr->clockSets, 0, sizeof(pDcgmDeviceAttr->clockSets));
-                    PRINT_ERROR("", "Null field value for DCGM_FI_DEV_SUPPORTED_CLOCKS");
-                }
-                else if (supClocks->version != dcgmDeviceSupportedClockSets_version)
+            break;
+        }
+
+        case DCGM_FI_DEV_SUPPORTED_CLOCKS:
+        {
+            dcgmDeviceSupportedClockSets_t *supClocks = (dcgmDeviceSupportedClockSets_t *)fv->value.blob;
+
+            if (!supClocks)
+            {
+                memset(&pDcgmDeviceAttr->clockSets, 0, sizeof(pDcgmDeviceAttr->clockSets));
+                PRINT_ERROR("", "Null field value for DCGM_FI_DEV_SUPPORTED_CLOCKS");
+            }
+            else if (supClocks->version != dcgmDeviceSupportedClockSets_version)
+            {
+                memset(&pDcgmDeviceAttr->clockSets, 0, sizeof(pDcgmDeviceAttr->clockSets));
+                PRINT_ERROR("%d %d",
+                            "Expected dcgmDeviceSupportedClockSets_version %d. Got %d",
+                            (int)dcgmDeviceSupportedClockSets_version,
+                            (int)supClocks->version);
+            }
+            else
+            {
+                int payloadSize = (sizeof(*supClocks) - sizeof(supClocks->clockSet))
+                                  + (supClocks->count * sizeof(supClocks->clockSet[0]));
+                if (payloadSize > (int)(fv->length - (sizeof(*fv) - sizeof(fv->value))))
                 {
-                    memset(&pDcgmDeviceAttr->clockSets, 0, sizeof(pDcgmDeviceAttr->clockSets));
                     PRINT_ERROR("%d %d",
-                                "Expected dcgmDeviceSupportedClockSets_version %d. Got %d",
-                                (int)dcgmDeviceSupportedClockSets_version,
-                                (int)supClocks->version);
+                                "DCGM_FI_DEV_SUPPORTED_CLOCKS calculated size %d > possible size %d",
+                                payloadSize,
+                                (int)(fv->length - (sizeof(*fv) - sizeof(fv->value))));
+                    memset(&pDcgmDeviceAttr->clockSets, 0, sizeof(pDcgmDeviceAttr->clockSets));
                 }
                 else
                 {
-                    int payloadSize = (sizeof(*supClocks) - sizeof(supClocks->clockSet))
-                                      + (supClocks->count * sizeof(supClocks->clockSet[0]));
-                    if (payloadSize > (int)(fv->length - (sizeof(*fv) - sizeof(fv->value))))
-                    {
-                        PRINT_ERROR("%d %d",
-                                    "DCGM_FI_DEV_SUPPORTED_CLOCKS calculated size %d > possible size %d",
-                                    payloadSize,
-                                    (int)(fv->length - (sizeof(*fv) - sizeof(fv->value))));
-                        memset(&pDcgmDeviceAttr->clockSets, 0, sizeof(pDcgmDeviceAttr->clockSets));
-                    }
-                    else
-                    {
-                        /* Success */
-                        memcpy(&pDcgmDeviceAttr->clockSets, supClocks, payloadSize);
-                    }
+                    /* Success */
+                    memcpy(&pDcgmDeviceAttr->clockSets, supClocks, payloadSize);
                 }
-                break;
             }
+            break;
+        }
 
-            case DCGM_FI_DEV_PCI_COMBINED_ID:
-                pDcgmDeviceAttr->identifiers.pciDeviceId = fv->value.i64;
-                break;
+        case DCGM_FI_DEV_PCI_COMBINED_ID:
+            pDcgmDeviceAttr->identifiers.pciDeviceId = fv->value.i64;
+            break;
 
-            case DCGM_FI_DEV_PCI_SUBSYS_ID:
-                pDcgmDeviceAttr->identifiers.pciSubSystemId = fv->value.i64;
-                break;
+        case DCGM_FI_DEV_PCI_SUBSYS_ID:
+            pDcgmDeviceAttr->identifiers.pciSubSystemId = fv->value.i64;
+            break;
 
-            case DCGM_FI_DEV_BAR1_TOTAL:
-                pDcgmDeviceAttr->memoryUsage.bar1Total = fv->value.i64;
-                break;
+        case DCGM_FI_DEV_BAR1_TOTAL:
+            pDcgmDeviceAttr->memoryUsage.bar1Total = fv->value.i64;
+            break;
 
-            case DCGM_FI_DEV_FB_TOTAL:
-                pDcgmDeviceAttr->memoryUsage.fbTotal = fv->value.i64;
-                break;
+        case DCGM_FI_DEV_FB_TOTAL:
+            pDcgmDeviceAttr->memoryUsage.fbTotal = fv->value.i64;
+            break;
 
-            case DCGM_FI_DEV_FB_USED:
-                pDcgmDeviceAttr->memoryUsage.fbUsed = fv->value.i64;
-                break;
+        case DCGM_FI_DEV_FB_USED:
+            pDcgmDeviceAttr->memoryUsage.fbUsed = fv->value.i64;
+            break;
 
-            case DCGM_FI_DEV_FB_FREE:
-                pDcgmDeviceAttr->memoryUsage.fbFree = fv->value.i64;
-                break;
+        case DCGM_FI_DEV_FB_FREE:
+            pDcgmDeviceAttr->memoryUsage.fbFree = fv->value.i64;
+            break;
 
-            case DCGM_FI_DRIVER_VERSION:
+        case DCGM_FI_DRIVER_VERSION:
+        {
+            size_t length;
+            length = strlen(fv->value.str);
+            if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.driverVersion))
             {
-                size_t length;
-                length = strlen(fv->value.str);
-                if (length + 1 > sizeof(pDcgmDeviceAttr->identifiers.driverVersion))
-                {
-                    PRINT_ERROR("", "String overflow error for the requested driver version field");
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.driverVersion,
-                                DCGM_STR_BLANK,
-                                sizeof(pDcgmDeviceAttr->identifiers.driverVersion));
-                }
-                else
-                {
-                    dcgmStrncpy(pDcgmDeviceAttr->identifiers.driverVersion,
-                                fv->value.str,
-                                sizeof(pDcgmDeviceAttr->identifiers.driverVersion));
-                }
-
-                break;
+                PRINT_ERROR("", "String overflow error for the requested driver version field");
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.driverVersion,
+                            DCGM_STR_BLANK,
+                            sizeof(pDcgmDeviceAttr->identifiers.driverVersion));
+            }
+            else
+            {
+                dcgmStrncpy(pDcgmDeviceAttr->identifiers.driverVersion,
+                            fv->value.str,
+                            sizeof(pDcgmDeviceAttr->identifiers.driverVersion));
             }
 
-            case DCGM_FI_DEV_VIRTUAL_MODE:
-                pDcgmDeviceAttr->identifiers.virtualizationMode = (unsigned int)nvcmvalue_int64_to_int32(fv->value.i64);
-                break;
+            break;
+        }
 
-            case DCGM_FI_DEV_PERSISTENCE_MODE:
-                pDcgmDeviceAttr->settings.persistenceModeEnabled = fv->value.i64;
-                break;
+        case DCGM_FI_DEV_VIRTUAL_MODE:
+            pDcgmDeviceAttr->identifiers.virtualizationMode = (unsigned int)nvcmvalue_int64_to_int32(fv->value.i64);
+            break;
 
-            case DCGM_FI_DEV_MIG_MODE:
-                pDcgmDeviceAttr->settings.migModeEnabled = fv->value.i64;
-                break;
+        case DCGM_FI_DEV_PERSISTENCE_MODE:
+            pDcgmDeviceAttr->settings.persistenceModeEnabled = fv->value.i64;
+            break;
 
-            default:
-                /* This should never happen */
-                return DCGM_ST_GENERIC_ERROR;
-                break;
-        }
+        case DCGM_FI_DEV_MIG_MODE:
+            pDcgmDeviceAttr->settings.migModeEnabled = fv->value.i64;
+            break;
+
+        default:
+            /* This should never happen */
+            return DCGM_ST_GENERIC_ERROR;
+            break;
     }
 
     return DCGM_ST_OK;
 }
 
-/*****************************************************************************/
-dcgmReturn_t helperWatchFieldValue(dcgmHandle_t pDcgmHandle,
-                                   int gpuId,
-                                   unsigned short fieldId,
-                                   long long updateFreq,
-                                   double maxKeepAge,
-                                   int maxKeepSamples)
+/**
+ * Common helper to get the device attributes of several GPUs. All of them are fetched with a single
+ * request to the host engine.
+ * @param pDcgmHandle
+ * @param gpuIds
+ * @param count
+ * @param attributes
+ * @return
+ */
+static dcgmReturn_t helperDeviceGetAttributesBulk(dcgmHandle_t pDcgmHandle,
+                                                  unsigned int const gpuIds[],
+                                                  unsigned int count,
+                                                  dcgmDeviceAttributes_t attributes[])
 {
-    dcgm::WatchFieldValue *pProtoWatchFieldValue; /* Protobuf Arg */
-    DcgmProtobuf encodePrb;                       /* Protobuf message for encoding */
-    DcgmProtobuf decodePrb;                       /* Protobuf message for decoding */
-    dcgm::Command *pCmdTemp;                      /* Pointer to proto command for intermediate usage */
-    std::vector<dcgm::Command *> vecCmdsRef;      /* Vector of proto commands. Used as output parameter */
+    unsigned short fieldIds[34];
+    dcgmGroupEntityPair_t entityPairs[DCGM_MAX_NUM_DEVICES];
+    dcgmBufferedFv_t *fv;
+    unsigned int fieldCount = 0;
     dcgmReturn_t ret;
 
-    if (!fieldId || updateFreq <= 0 || (maxKeepSamples <= 0 && maxKeepAge <= 0.0))
+    if (gpuIds == nullptr || attributes == nullptr || count == 0 || count > DCGM_MAX_NUM_DEVICES)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (attributes[i].version != dcgmDeviceAttributes_version)
+        {
+            return DCGM_ST_VER_MISMATCH;
+        }
+
+        entityPairs[i].entityGroupId = DCGM_FE_GPU;
+        entityPairs[i].entityId      = gpuIds[i];
+    }
+
+
+    fieldIds[fieldCount++] = DCGM_FI_DEV_SLOWDOWN_TEMP;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_SHUTDOWN_TEMP;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_ENFORCED_POWER_LIMIT;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_POWER_MGMT_LIMIT;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_POWER_MGMT_LIMIT_DEF;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_POWER_MGMT_LIMIT_MAX;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_POWER_MGMT_LIMIT_MIN;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_SUPPORTED_CLOCKS;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_UUID;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_VBIOS_VERSION;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_INFOROM_IMAGE_VER;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_BRAND;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_NAME;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_SERIAL;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_PCI_BUSID;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_PCI_COMBINED_ID;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_PCI_SUBSYS_ID;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_BAR1_TOTAL;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_FB_TOTAL;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_FB_USED;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_FB_FREE;
+    fieldIds[fieldCount++] = DCGM_FI_DRIVER_VERSION;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_VIRTUAL_MODE;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_PERSISTENCE_MODE;
+    fieldIds[fieldCount++] = DCGM_FI_DEV_MIG_MODE;
+
+    if (fieldCount >= sizeof(fieldIds) / sizeof(fieldIds[0]))
+    {
+        PRINT_ERROR("", "Update DeviceGetAttributes to accommodate more fields\n");
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    DcgmFvBuffer fvBuffer(0);
+    ret = helperGetLatestValuesForFields(
+        pDcgmHandle, 0, entityPairs, count, 0, fieldIds, fieldCount, &fvBuffer, DCGM_FV_FLAG_LIVE_DATA);
+    if (DCGM_ST_OK != ret)
+    {
+        return ret;
+    }
+
+    size_t bufferSize = 0, elementCount = 0;
+    ret = fvBuffer.GetSize(&bufferSize, &elementCount);
+    if (elementCount != count * fieldCount)
+    {
+        PRINT_ERROR("%d %d %d",
+                    "Unexpected elementCount %d != count %d or ret %d",
+                    (int)elementCount,
+                    count * fieldCount,
+                    (int)ret);
+        /* Keep going. We will only process what we have */
+    }
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    for (fv = fvBuffer.GetNextFv(&cursor); fv; fv = fvBuffer.GetNextFv(&cursor))
+    {
+        /* Global fields like the driver version come back once per GPU, tagged with the GPU asked for */
+        for (unsigned int i = 0; i < count; i++)
+        {
+            if (gpuIds[i] != fv->entityId)
+            {
+                continue;
+            }
+
+            ret = helperDecodeDeviceAttribute(fv, &attributes[i]);
+            if (DCGM_ST_OK != ret)
+            {
+                return ret;
+            }
+        }
+    }
+
+    return DCGM_ST_OK;
+}
+
+/**
+ * Common helper to get device attributes
+ * @param mode
+ * @param pDcgmHandle
+ * @param gpuId
+ * @param pDcgmDeviceAttr
+ * @return
+ */
+dcgmReturn_t helperDeviceGetAttributes(dcgmHandle_t pDcgmHandle, int gpuId, dcgmDeviceAttributes_t *pDcgmDeviceAttr)
+{
+    if (NULL == pDcgmDeviceAttr)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    unsigned int const gpuIds[] = { (unsigned int)gpuId };
+    return helperDeviceGetAttributesBulk(pDcgmHandle, gpuIds, 1, pDcgmDeviceAttr);
+}
+
+/*****************************************************************************/
+dcgmReturn_t helperWatchFieldValue(dcgmHandle_t pDcgmHandle,
+                                   int gpuId,
+                                   unsigned short fieldId,
+                                   long long updateFreq,
+                                   double maxKeepAge,
+                                   int maxKeepSamples)
+{
+    dcgm::WatchFieldValue *pProtoWatchFieldValue; /* Protobuf Arg */
+    DcgmProtobuf encodePrb;                       /* Protobuf message for encoding */
+    DcgmProtobuf decodePrb;                       /* Protobuf message for decoding */
+    dcgm::Command *pCmdTemp;                      /* Pointer to proto command for intermediate usage */
+    std::vector<dcgm::Command *> vecCmdsRef;      /* Vector of proto commands. Used as output parameter */
+    dcgmReturn_t ret;
+
+    if (!fieldId || updateFreq <= 0 || (maxKeepSamples <= 0 && maxKeepAge <= 0.0))
         return DCGM_ST_BADPARAM;
 
     dcgm_field_meta_p fieldMeta = DcgmFieldGetById((unsigned short)fieldId);
@@ -2735,6 +3158,99 @@ dcgmReturn_t helperInjectFieldValue(dcgmHandle_t pDcgmHandle,
     return tsapiInjectEntityFieldValue(pDcgmHandle, DCGM_FE_GPU, gpuId, pDcgmInjectFieldValue);
 }
 
+/*****************************************************************************/
+/* Inject the values of fvBuffer with one DCGM_CORE_SR_INJECT_FIELD_VALUES request */
+static dcgmReturn_t helperInjectFvBuffer(dcgmHandle_t dcgmHandle, DcgmFvBuffer const &fvBuffer)
+{
+    size_t bufferSize   = 0;
+    size_t elementCount = 0;
+    fvBuffer.GetSize(&bufferSize, &elementCount);
+    if (elementCount == 0)
+        return DCGM_ST_OK;
+
+    std::vector<char> msgBytes(sizeof(dcgm_core_msg_inject_field_values_t) + bufferSize);
+    auto msg = (dcgm_core_msg_inject_field_values_t *)msgBytes.data();
+
+    msg->header.length     = msgBytes.size();
+    msg->header.moduleId   = DcgmModuleIdCore;
+    msg->header.subCommand = DCGM_CORE_SR_INJECT_FIELD_VALUES;
+    msg->header.version    = dcgm_core_msg_inject_field_values_version;
+    msg->bufferSize        = bufferSize;
+    memcpy(msgBytes.data() + sizeof(*msg), fvBuffer.GetBuffer(), bufferSize);
+
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg->header, msgBytes.size());
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_DEBUG << "dcgmModuleSendBlockingFixedRequest returned " << ret;
+        return ret;
+    }
+
+    return (dcgmReturn_t)msg->cmdRet;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperInjectEntityFieldValues(dcgmHandle_t dcgmHandle,
+                                                  dcgmGroupEntityPair_t *entities,
+                                                  dcgmInjectFieldValue_t *values,
+                                                  unsigned int count)
+{
+    if (!entities || !values || count == 0)
+        return DCGM_ST_BADPARAM;
+
+    DcgmFvBuffer fvBuffer(FVBUFFER_GUESS_INITIAL_CAPACITY(1, std::min(count, 4096U)));
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        dcgmInjectFieldValue_t &value = values[i];
+        if (value.version != dcgmInjectFieldValue_version)
+            return DCGM_ST_VER_MISMATCH;
+
+        /* Send what we have before the next value could push the request past its max size */
+        size_t bufferSize   = 0;
+        size_t elementCount = 0;
+        fvBuffer.GetSize(&bufferSize, &elementCount);
+        if (bufferSize + sizeof(dcgmBufferedFv_t) > DCGM_FV_INJECT_MAX_BUFFER_SIZE)
+        {
+            dcgmReturn_t ret = helperInjectFvBuffer(dcgmHandle, fvBuffer);
+            if (ret != DCGM_ST_OK)
+                return ret;
+            fvBuffer.Clear();
+        }
+
+        dcgm_field_entity_group_t entityGroupId = entities[i].entityGroupId;
+        dcgm_field_eid_t entityId               = entities[i].entityId;
+        dcgmBufferedFv_t *fv                    = nullptr;
+
+        switch (value.fieldType)
+        {
+            case DCGM_FT_INT64:
+                fv = fvBuffer.AddInt64Value(
+                    entityGroupId, entityId, value.fieldId, value.value.i64, value.ts, DCGM_ST_OK);
+                break;
+
+            case DCGM_FT_DOUBLE:
+                fv = fvBuffer.AddDoubleValue(
+                    entityGroupId, entityId, value.fieldId, value.value.dbl, value.ts, DCGM_ST_OK);
+                break;
+
+            case DCGM_FT_STRING:
+                if (!memchr(value.value.str, '\0', sizeof(value.value.str)))
+                    return DCGM_ST_BADPARAM;
+                fv = fvBuffer.AddStringValue(
+                    entityGroupId, entityId, value.fieldId, value.value.str, value.ts, DCGM_ST_OK);
+                break;
+
+            default:
+                return DCGM_ST_BADPARAM;
+        }
+
+        if (!fv)
+            return DCGM_ST_MEMORY;
+    }
+
+    return helperInjectFvBuffer(dcgmHandle, fvBuffer);
+}
+
 /*****************************************************************************/
 dcgmReturn_t helperGetCacheManagerFieldInfo(dcgmHandle_t pDcgmHandle, dcgmCacheManagerFieldInfo_t *fieldInfo)
 {
@@ -2855,6 +3371,105 @@ static void setFvValueAsBlank(dcgmFieldValue_v1 &fv, unsigned short fieldType)
     }
 }
 
+/*****************************************************************************/
+/* Build a DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES request for up to maxCount values of
+   fieldMeta in msgBytes. msgBytes is sized to receive the response */
+static void helperInitFieldMultipleValuesMsg(std::vector<char> &msgBytes,
+                                             dcgm_field_meta_p fieldMeta,
+                                             dcgm_field_entity_group_t entityGroup,
+                                             dcgm_field_eid_t entityId,
+                                             int maxCount,
+                                             long long startTs,
+                                             long long endTs,
+                                             dcgmOrder_t order)
+{
+    /* Make room for maxCount of the largest value this field type can have */
+    size_t maxFvSize = sizeof(dcgmBufferedFv_t);
+    if (fieldMeta->fieldType == DCGM_FT_STRING)
+        maxFvSize = offsetof(dcgmBufferedFv_t, value) + DCGM_MAX_STR_LENGTH;
+    else if (fieldMeta->fieldType != DCGM_FT_BINARY)
+        maxFvSize = offsetof(dcgmBufferedFv_t, value) + sizeof(int64_t);
+    size_t bufferCapacity = std::min<size_t>(maxCount * maxFvSize, DCGM_FV_REPLY_MAX_BUFFER_SIZE);
+
+    msgBytes.assign(sizeof(dcgm_core_msg_get_field_multiple_values_t) + bufferCapacity, 0);
+    auto msg = (dcgm_core_msg_get_field_multiple_values_t *)msgBytes.data();
+
+    msg->header.length     = sizeof(*msg); /* Only send the request. The host engine makes room for the values */
+    msg->header.moduleId   = DcgmModuleIdCore;
+    msg->header.subCommand = DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES;
+    msg->header.version    = dcgm_core_msg_get_field_multiple_values_version;
+
+    msg->entityGroupId  = fieldMeta->scope == DCGM_FS_GLOBAL ? DCGM_FE_NONE : entityGroup;
+    msg->entityId       = entityId;
+    msg->fieldId        = fieldMeta->fieldId;
+    msg->order          = order;
+    msg->startTs        = startTs;
+    msg->endTs          = endTs;
+    msg->count          = maxCount;
+    msg->bufferCapacity = bufferCapacity;
+}
+
+/*****************************************************************************/
+/* Read the values of a DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES response into values[].
+   bufferCapacity is what the request asked for. count is set to how many were read */
+static dcgmReturn_t helperReadFieldMultipleValuesMsg(dcgm_core_msg_get_field_multiple_values_t *msg,
+                                                     size_t bufferCapacity,
+                                                     dcgm_field_meta_p fieldMeta,
+                                                     int maxCount,
+                                                     int *count,
+                                                     dcgmFieldValue_v1 values[])
+{
+    memset(values, 0, sizeof(values[0]) * maxCount);
+    *count = 0;
+
+    /* Check the status of the DCGM command */
+    dcgmReturn_t ret = (dcgmReturn_t)msg->cmdRet;
+    if (ret == DCGM_ST_NO_DATA || ret == DCGM_ST_NOT_SUPPORTED)
+    {
+        DCGM_LOG_WARNING << "Handling ret " << ret << " for eg " << msg->entityGroupId << " eid " << msg->entityId
+                         << " by returning a single fv with that error code.";
+        /* Handle these returns by setting the field value status rather than failing the API */
+        *count              = 1;
+        values[0].version   = dcgmFieldValue_version1;
+        values[0].fieldId   = fieldMeta->fieldId;
+        values[0].fieldType = fieldMeta->fieldType;
+        setFvValueAsBlank(values[0], fieldMeta->fieldType);
+        values[0].status = ret;
+        return DCGM_ST_OK;
+    }
+    else if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_WARNING << "msg->cmdRet " << ret;
+        return ret;
+    }
+
+    if (msg->bufferSize > bufferCapacity || msg->header.length != sizeof(*msg) + msg->bufferSize)
+    {
+        DCGM_LOG_ERROR << "Malformed DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES response. bufferSize " << msg->bufferSize
+                       << ", length " << msg->header.length;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    /* Walk the values in place */
+    char const *buffer = (char const *)msg + sizeof(*msg);
+    int i              = 0;
+    for (size_t offset = 0; offset < msg->bufferSize && i < maxCount; i++)
+    {
+        auto fv = (dcgmBufferedFv_t *)(buffer + offset);
+        if (fv->length < offsetof(dcgmBufferedFv_t, value) || offset + fv->length > msg->bufferSize)
+        {
+            DCGM_LOG_ERROR << "Bad fv length " << fv->length << " at offset " << offset;
+            return DCGM_ST_GENERIC_ERROR;
+        }
+
+        DcgmFvBuffer::ConvertBufferedFvToFv1(fv, &values[i]);
+        offset += fv->length;
+    }
+
+    *count = i;
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************/
 dcgmReturn_t helperGetMultipleValuesForField(dcgmHandle_t pDcgmHandle,
                                              dcgm_field_entity_group_t entityGroup,
@@ -2866,15 +3481,8 @@ dcgmReturn_t helperGetMultipleValuesForField(dcgmHandle_t pDcgmHandle,
                                              dcgmOrder_t order,
                                              dcgmFieldValue_v1 values[])
 {
-    dcgm::FieldMultiValues *pProtoGetMultiValuesForField = 0;
-    dcgm::FieldMultiValues *pResponse                    = 0;
-    DcgmProtobuf encodePrb;                  /* Protobuf message for encoding */
-    DcgmProtobuf decodePrb;                  /* Protobuf message for decoding */
-    dcgm::Command *pCmdTemp;                 /* Pointer to proto command for intermediate usage */
-    std::vector<dcgm::Command *> vecCmdsRef; /* Vector of proto commands. Used as output parameter */
     dcgmReturn_t ret;
-    int maxCount, i;
-    int fieldType;
+    int maxCount;
     dcgm_field_meta_p fieldMeta;
 
     if (!count || (*count) < 1 || !fieldId || !values)
@@ -2904,145 +3512,292 @@ dcgmReturn_t helperGetMultipleValuesForField(dcgmHandle_t pDcgmHandle,
 
     memset(values, 0, sizeof(values[0]) * maxCount);
 
-    pProtoGetMultiValuesForField = new dcgm::FieldMultiValues;
-    pProtoGetMultiValuesForField->set_version(dcgmGetMultipleValuesForField_version);
-    pProtoGetMultiValuesForField->set_fieldid(fieldId);
-    // fieldType not required for request
-    pProtoGetMultiValuesForField->set_startts(startTs);
-    pProtoGetMultiValuesForField->set_endts(endTs);
-    pProtoGetMultiValuesForField->set_maxcount(maxCount);
-    pProtoGetMultiValuesForField->set_orderflag((dcgm::MultiValuesOrder)order);
+    std::vector<char> msgBytes;
+    helperInitFieldMultipleValuesMsg(msgBytes, fieldMeta, entityGroup, entityId, maxCount, startTs, endTs, order);
+    auto msg              = (dcgm_core_msg_get_field_multiple_values_t *)msgBytes.data();
+    size_t bufferCapacity = msg->bufferCapacity;
 
-    /* Add Command to the protobuf encoder object */
-    pCmdTemp = encodePrb.AddCommand(dcgm::GET_FIELD_MULTIPLE_VALUES, dcgm::OPERATION_SINGLE_ENTITY, entityId, 0);
-    if (NULL == pCmdTemp)
+    ret = dcgmModuleSendBlockingFixedRequest(pDcgmHandle, &msg->header, msgBytes.size());
+    if (DCGM_ST_OK != ret)
     {
-        PRINT_ERROR("", "encodePrb.AddCommand failed");
-        delete pProtoGetMultiValuesForField;
-        return DCGM_ST_GENERIC_ERROR;
+        PRINT_DEBUG("%d", "dcgmModuleSendBlockingFixedRequest returned %d", (int)ret);
+        return ret;
     }
 
-    if (fieldMeta->scope == DCGM_FS_GLOBAL)
-        pCmdTemp->set_entitygroupid(DCGM_FE_NONE);
-    else
-        pCmdTemp->set_entitygroupid(entityGroup);
+    return helperReadFieldMultipleValuesMsg(msg, bufferCapacity, fieldMeta, maxCount, count, values);
+}
 
-    /* Set the arg to passed as a proto message. After this point the arg is
-     * managed by protobuf library, so don't worry about freeing it after this point */
-    pCmdTemp->add_arg()->set_allocated_fieldmultivalues(pProtoGetMultiValuesForField);
+/*****************************************************************************/
+static dcgmReturn_t tsapiEntityGetValuesSinceAsync(dcgmHandle_t dcgmHandle,
+                                                   dcgm_field_entity_group_t entityGroup,
+                                                   dcgm_field_eid_t entityId,
+                                                   unsigned short fieldId,
+                                                   long long sinceTimestamp,
+                                                   int *count,
+                                                   dcgmFieldValue_v1 values[],
+                                                   dcgmRequestComplete_f callback,
+                                                   void *userData)
+{
+    if (!count || (*count) < 1 || !values || !callback)
+    {
+        DCGM_LOG_ERROR << "Bad parameter";
+        return DCGM_ST_BADPARAM;
+    }
 
-    ret = processAtHostEngine(pDcgmHandle, &encodePrb, &decodePrb, &vecCmdsRef);
-    if (DCGM_ST_OK != ret)
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+    if (!fieldMeta)
     {
-        PRINT_DEBUG("%d", "ProcessAtEmbeddedHostEngine returned %d", (int)ret);
-        return ret;
+        DCGM_LOG_ERROR << "Invalid fieldId " << fieldId;
+        return DCGM_ST_UNKNOWN_FIELD;
     }
 
-    /* Check the status of the DCGM command */
-    ret = (dcgmReturn_t)vecCmdsRef[0]->status();
-    if (ret == DCGM_ST_NO_DATA || ret == DCGM_ST_NOT_SUPPORTED)
+    if (dcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
     {
-        DCGM_LOG_WARNING << "Handling ret " << ret << " for eg " << entityGroup << " eid " << entityId
-                         << " by returning a single fv with that error code.";
-        /* Handle these returns by setting the field value status rather than failing the API */
-        *count = 1;
-        memset(&values[0], 0, sizeof(values[0]));
-        values[0].version   = dcgmFieldValue_version1;
-        values[0].fieldId   = fieldId;
-        values[0].fieldType = fieldMeta->fieldType;
-        setFvValueAsBlank(values[0], fieldMeta->fieldType);
-        values[0].status = ret;
+        /* The embedded host engine answers without a round trip */
+        callback(helperGetMultipleValuesForField(
+                     dcgmHandle, entityGroup, entityId, fieldId, count, sinceTimestamp, 0, DCGM_ORDER_ASCENDING, values),
+                 userData);
         return DCGM_ST_OK;
     }
-    else if (ret != DCGM_ST_OK)
+
+    int const maxCount = *count;
+    std::vector<char> msgBytes;
+    helperInitFieldMultipleValuesMsg(
+        msgBytes, fieldMeta, entityGroup, entityId, maxCount, sinceTimestamp, 0, DCGM_ORDER_ASCENDING);
+    auto msg                    = (dcgm_core_msg_get_field_multiple_values_t *)msgBytes.data();
+    size_t const bufferCapacity = msg->bufferCapacity;
+
+    return processModuleCommandAtRemoteHostEngineAsync(
+        dcgmHandle,
+        &msg->header,
+        msgBytes.size(),
+        [fieldMeta, maxCount, bufferCapacity, count, values, callback, userData](
+            dcgmReturn_t dcgmReturn, dcgm_module_command_header_t *response) {
+            auto reply = (dcgm_core_msg_get_field_multiple_values_t *)response;
+            dcgmReturn = helperCheckAsyncResponse(dcgmReturn, response, sizeof(*reply));
+            if (dcgmReturn == DCGM_ST_OK)
+            {
+                dcgmReturn = helperReadFieldMultipleValuesMsg(reply, bufferCapacity, fieldMeta, maxCount, count, values);
+            }
+            callback(dcgmReturn, userData);
+        });
+}
+
+/*****************************************************************************/
+/* Request the page of up to maxCount values of fieldMeta after cursor into msgBytes. hasValues is cleared when
+   there are no values after cursor. Unlike the timestamp based reads, that is the expected end of a page */
+static dcgmReturn_t helperSendValuesPageMsg(dcgmHandle_t dcgmHandle,
+                                            std::vector<char> &msgBytes,
+                                            dcgm_field_meta_p fieldMeta,
+                                            dcgm_field_entity_group_t entityGroup,
+                                            dcgm_field_eid_t entityId,
+                                            dcgmValuesCursor_t const &cursor,
+                                            int maxCount,
+                                            size_t &bufferCapacity,
+                                            bool &hasValues)
+{
+    helperInitFieldMultipleValuesMsg(msgBytes, fieldMeta, entityGroup, entityId, maxCount, 0, 0, DCGM_ORDER_ASCENDING);
+    auto msg       = (dcgm_core_msg_get_field_multiple_values_t *)msgBytes.data();
+    bufferCapacity = msg->bufferCapacity;
+    msg->useCursor = 1;
+    msg->cursor    = cursor;
+    hasValues      = false;
+
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg->header, msgBytes.size());
+    if (ret != DCGM_ST_OK)
     {
-        DCGM_LOG_WARNING << "vecCmdsRef[0]->status() " << ret;
+        DCGM_LOG_ERROR << "dcgmModuleSendBlockingFixedRequest returned " << ret;
         return ret;
     }
 
-    if (!(vecCmdsRef[0]->arg_size() && vecCmdsRef[0]->arg(0).has_fieldmultivalues()))
+    hasValues = (dcgmReturn_t)msg->cmdRet != DCGM_ST_NO_DATA;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t tsapiEntityGetValuesPage(dcgmHandle_t dcgmHandle,
+                                             dcgm_field_entity_group_t entityGroup,
+                                             dcgm_field_eid_t entityId,
+                                             unsigned short fieldId,
+                                             dcgmValuesCursor_t *cursor,
+                                             int *count,
+                                             dcgmFieldValue_v1 values[],
+                                             long long *valuesSkipped)
+{
+    if (!cursor || !count || (*count) < 1 || !values)
     {
-        PRINT_ERROR("", "arg or fieldmultivalue missing");
-        return DCGM_ST_GENERIC_ERROR;
+        DCGM_LOG_ERROR << "Bad parameter";
+        return DCGM_ST_BADPARAM;
     }
 
-    pResponse = vecCmdsRef[0]->mutable_arg(0)->mutable_fieldmultivalues();
-
-    if (pResponse->version() != dcgmGetMultipleValuesForField_version1)
-        return DCGM_ST_VER_MISMATCH;
-    if (!pResponse->has_fieldtype())
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+    if (!fieldMeta)
     {
-        PRINT_ERROR("", "Field type missing");
-        return DCGM_ST_GENERIC_ERROR;
+        DCGM_LOG_ERROR << "Invalid fieldId " << fieldId;
+        return DCGM_ST_UNKNOWN_FIELD;
     }
 
-    *count = pResponse->vals_size();
+    int const maxCount = *count;
+    *count             = 0;
+    if (valuesSkipped)
+        *valuesSkipped = 0;
+
+    std::vector<char> msgBytes;
+    size_t bufferCapacity = 0;
+    bool hasValues        = false;
+    dcgmReturn_t ret      = helperSendValuesPageMsg(
+        dcgmHandle, msgBytes, fieldMeta, entityGroup, entityId, *cursor, maxCount, bufferCapacity, hasValues);
+    if (ret != DCGM_ST_OK || !hasValues)
+        return ret;
+
+    auto msg = (dcgm_core_msg_get_field_multiple_values_t *)msgBytes.data();
+    ret      = helperReadFieldMultipleValuesMsg(msg, bufferCapacity, fieldMeta, maxCount, count, values);
+    if (ret != DCGM_ST_OK)
+        return ret;
 
-    fieldType = pResponse->fieldtype();
+    *cursor = msg->cursor;
+    if (valuesSkipped)
+        *valuesSkipped = msg->valuesSkipped;
+    return DCGM_ST_OK;
+}
 
-    for (i = 0; i < (*count); i++)
+/*****************************************************************************/
+static dcgmReturn_t tsapiEntityGetValuesPageNumeric(dcgmHandle_t dcgmHandle,
+                                                    dcgm_field_entity_group_t entityGroup,
+                                                    dcgm_field_eid_t entityId,
+                                                    unsigned short fieldId,
+                                                    dcgmValuesCursor_t *cursor,
+                                                    int *count,
+                                                    long long timestamps[],
+                                                    void *values,
+                                                    long long *valuesSkipped)
+{
+    if (!cursor || !count || (*count) < 1 || !timestamps || !values)
     {
-        dcgm::Value *responseValue = pResponse->mutable_vals(i);
+        DCGM_LOG_ERROR << "Bad parameter";
+        return DCGM_ST_BADPARAM;
+    }
 
-        if (responseValue->has_timestamp())
-            values[i].ts = responseValue->timestamp();
-        else
-            PRINT_WARNING("%d %d", "timestamp missing at index %d/%d", i, (*count));
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+    if (!fieldMeta)
+    {
+        DCGM_LOG_ERROR << "Invalid fieldId " << fieldId;
+        return DCGM_ST_UNKNOWN_FIELD;
+    }
 
+    if (fieldMeta->fieldType != DCGM_FT_DOUBLE && fieldMeta->fieldType != DCGM_FT_INT64
+        && fieldMeta->fieldType != DCGM_FT_TIMESTAMP)
+    {
+        DCGM_LOG_ERROR << "fieldId " << fieldId << " of type " << fieldMeta->fieldType << " isn't numeric";
+        return DCGM_ST_BADPARAM;
+    }
 
-        values[i].version   = dcgmFieldValue_version1;
-        values[i].fieldId   = fieldId;
-        values[i].fieldType = fieldType;
-        values[i].status    = 0;
+    int const maxCount = *count;
+    *count             = 0;
+    if (valuesSkipped)
+        *valuesSkipped = 0;
 
-        switch (values[i].fieldType)
-        {
-            case DCGM_FT_DOUBLE:
-                values[i].value.dbl = responseValue->dbl();
-                break;
+    std::vector<char> msgBytes;
+    size_t bufferCapacity = 0;
+    bool hasValues        = false;
+    dcgmReturn_t ret      = helperSendValuesPageMsg(
+        dcgmHandle, msgBytes, fieldMeta, entityGroup, entityId, *cursor, maxCount, bufferCapacity, hasValues);
+    if (ret != DCGM_ST_OK || !hasValues)
+        return ret;
 
-            case DCGM_FT_INT64:
-            case DCGM_FT_TIMESTAMP:
-                values[i].value.i64 = responseValue->i64();
-                break;
+    auto msg = (dcgm_core_msg_get_field_multiple_values_t *)msgBytes.data();
+    ret      = (dcgmReturn_t)msg->cmdRet;
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_WARNING << "msg->cmdRet " << ret;
+        return ret;
+    }
 
-            case DCGM_FT_STRING:
-                size_t length;
-                length = strlen(responseValue->str().c_str());
-                if (length + 1 > DCGM_MAX_STR_LENGTH)
-                {
-                    PRINT_ERROR("", "String overflow error for the requested field");
-                    return DCGM_ST_GENERIC_ERROR;
-                }
+    if (msg->bufferSize > bufferCapacity || msg->header.length != sizeof(*msg) + msg->bufferSize)
+    {
+        DCGM_LOG_ERROR << "Malformed DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES response. bufferSize " << msg->bufferSize
+                       << ", length " << msg->header.length;
+        return DCGM_ST_GENERIC_ERROR;
+    }
 
-                dcgmStrncpy(values[i].value.str, responseValue->str().c_str(), sizeof(values[i].value.str) - 1);
-                break;
+    /* Copy the timestamps and the 8 bytes of each value straight out of the reply. Both value types are 8 bytes */
+    static_assert(sizeof(double) == sizeof(int64_t), "values[] must have the same stride for every numeric type");
+    char const *buffer = (char const *)msg + sizeof(*msg);
+    char *valueBytes   = (char *)values;
+    int i              = 0;
+    for (size_t offset = 0; offset < msg->bufferSize && i < maxCount; i++)
+    {
+        auto fv = (dcgmBufferedFv_t const *)(buffer + offset);
+        if (fv->length < offsetof(dcgmBufferedFv_t, value) + sizeof(int64_t) || offset + fv->length > msg->bufferSize)
+        {
+            DCGM_LOG_ERROR << "Bad fv length " << fv->length << " at offset " << offset;
+            return DCGM_ST_GENERIC_ERROR;
+        }
 
-            case DCGM_FT_BINARY:
-            {
-                if (responseValue->blob().size() > sizeof(values[i].value.blob))
-                {
-                    PRINT_ERROR("%d %d %d",
-                                "Buffer values[index].value.blob size %d too small for %d. fieldType %d",
-                                (int)sizeof(values[i].value.blob),
-                                (int)responseValue->blob().size(),
-                                (int)values[i].fieldType);
-                    return DCGM_ST_MEMORY;
-                }
+        timestamps[i] = fv->timestamp;
+        memcpy(valueBytes + i * sizeof(int64_t), &fv->value, sizeof(int64_t));
+        offset += fv->length;
+    }
 
-                memcpy(values[i].value.blob, (void *)responseValue->blob().c_str(), responseValue->blob().size());
-                break;
-            }
+    *count  = i;
+    *cursor = msg->cursor;
+    if (valuesSkipped)
+        *valuesSkipped = msg->valuesSkipped;
+    return DCGM_ST_OK;
+}
 
-            default:
-                PRINT_ERROR("%c", "Uknown type: %c", (char)fieldType);
-                return DCGM_ST_GENERIC_ERROR;
-        }
+/*****************************************************************************/
+/* The cache manager of the embedded host engine, if dcgmHandle is for it. Views point into its memory, so no
+   other host engine can lend them */
+static dcgmReturn_t helperGetEmbeddedCacheManager(dcgmHandle_t dcgmHandle, DcgmCacheManager **cacheManager)
+{
+    if (dcgmHandle != (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+    {
+        DCGM_LOG_ERROR << "Value views are only supported by the embedded host engine";
+        return DCGM_ST_NOT_SUPPORTED;
+    }
+
+    DcgmHostEngineHandler *heHandler = DcgmHostEngineHandler::Instance();
+    *cacheManager                    = heHandler ? heHandler->GetCacheManager() : nullptr;
+    if (!*cacheManager)
+    {
+        DCGM_LOG_ERROR << "The embedded host engine isn't running";
+        return DCGM_ST_UNINITIALIZED;
     }
 
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+static dcgmReturn_t tsapiEmbeddedAcquireValueViews(dcgmHandle_t dcgmHandle,
+                                                   dcgmValueView_v1 views[],
+                                                   unsigned int count)
+{
+    if (!views || count < 1)
+    {
+        DCGM_LOG_ERROR << "Bad parameter";
+        return DCGM_ST_BADPARAM;
+    }
+
+    DcgmCacheManager *cacheManager = nullptr;
+    dcgmReturn_t dcgmReturn        = helperGetEmbeddedCacheManager(dcgmHandle, &cacheManager);
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+
+    return cacheManager->AcquireValueViews(views, count);
+}
+
+/*****************************************************************************/
+static dcgmReturn_t tsapiEmbeddedReleaseValueViews(dcgmHandle_t dcgmHandle)
+{
+    DcgmCacheManager *cacheManager = nullptr;
+    dcgmReturn_t dcgmReturn        = helperGetEmbeddedCacheManager(dcgmHandle, &cacheManager);
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+
+    return cacheManager->ReleaseValueViews();
+}
+
 /*****************************************************************************/
 dcgmReturn_t cmHelperGetMultipleValuesForField(dcgmHandle_t pDcgmHandle,
                                                dcgm_field_entity_group_t entityGroup,
@@ -3449,6 +4204,42 @@ dcgmReturn_t helperPolicyRegister(dcgmHandle_t dcgmHandle,
     return dcgmReturn;
 }
 
+/*****************************************************************************/
+dcgmReturn_t helperPolicyRegisterV2(dcgmHandle_t dcgmHandle, dcgmPolicyRegisterParams_v1 *params)
+{
+    dcgmReturn_t dcgmReturn;
+    dcgm_policy_msg_register_v2 msg = {};
+
+    if (params == nullptr)
+    {
+        DCGM_LOG_ERROR << "Null params";
+        return DCGM_ST_BADPARAM;
+    }
+    if (params->version != dcgmPolicyRegisterParams_version1)
+    {
+        DCGM_LOG_ERROR << "Version mismatch " << std::hex << params->version
+                       << " != " << dcgmPolicyRegisterParams_version1;
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    /* Make an ansync object. We're going to pass ownership off, so we won't have to free it */
+    std::unique_ptr<DcgmPolicyRequest> policyRequest
+        = std::make_unique<DcgmPolicyRequest>(params->beginCallback, params->finishCallback);
+
+    msg.header.length          = sizeof(msg);
+    msg.header.moduleId        = DcgmModuleIdPolicy;
+    msg.header.subCommand      = DCGM_POLICY_SR_REGISTER_V2;
+    msg.header.version         = dcgm_policy_msg_register_version2;
+    msg.groupId                = params->groupId;
+    msg.condition              = params->condition;
+    msg.coalesceWindowUsec     = params->coalesceWindowUsec;
+    msg.maxNotificationsPerSec = params->maxNotificationsPerSec;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg), std::move(policyRequest));
+    return dcgmReturn;
+}
+
 /*****************************************************************************/
 dcgmReturn_t helperPolicyUnregister(dcgmHandle_t dcgmHandle, dcgmGpuGrp_t groupId, dcgmPolicyCondition_t condition)
 {
@@ -3805,19 +4596,672 @@ static dcgmReturn_t helperGetValuesSince(dcgmHandle_t pDcgmHandle,
         }
     }
 
-    /* Success. We can advance the caller's next query timestamp */
-    *nextSinceTimestamp = endQueryTimestamp + 1;
-    PRINT_DEBUG("%lld", "nextSinceTimestamp advanced to %lld", *nextSinceTimestamp);
+    /* Success. We can advance the caller's next query timestamp */
+    *nextSinceTimestamp = endQueryTimestamp + 1;
+    PRINT_DEBUG("%lld", "nextSinceTimestamp advanced to %lld", *nextSinceTimestamp);
+
+CLEANUP:
+    if (fieldValues)
+    {
+        free(fieldValues);
+        fieldValues = 0;
+    }
+
+
+    return retDcgmSt;
+}
+
+/*****************************************************************************/
+/*
+ * Fetch up to DCGM_MAX_BUCKETS_PER_REQUEST buckets of one entity's field from the
+ * host engine and append them to values. Returns the command status of the host
+ * engine in cmdRet
+ */
+static dcgmReturn_t helperGetBucketedValuesForField(dcgmHandle_t pDcgmHandle,
+                                                    dcgm_field_entity_group_t entityGroup,
+                                                    dcgm_field_eid_t entityId,
+                                                    unsigned int fieldId,
+                                                    long long startTs,
+                                                    long long endTs,
+                                                    long long bucketWidthUsec,
+                                                    dcgmBucketAggregation_t aggregation,
+                                                    std::vector<dcgmFieldValue_v1> &values,
+                                                    dcgmReturn_t &cmdRet)
+{
+    dcgm_core_msg_get_bucketed_values_for_field_t msg = {};
+
+    /* avoid transferring the large buffer when making request */
+    msg.header.length     = sizeof(msg) - SAMPLES_BUFFER_SIZE;
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_GET_BUCKETED_VALUES_FOR_FIELD;
+    msg.header.version    = dcgm_core_msg_get_bucketed_values_for_field_version;
+
+    msg.fv.entityGroupId = entityGroup;
+    msg.fv.entityId      = entityId;
+    msg.fv.fieldId       = fieldId;
+    msg.fv.aggregation   = aggregation;
+    msg.fv.startTs       = startTs;
+    msg.fv.endTs         = endTs;
+    msg.fv.bucketWidth   = bucketWidthUsec;
+    msg.fv.count         = DCGM_MAX_BUCKETS_PER_REQUEST;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(pDcgmHandle, &msg.header, sizeof(msg));
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_DEBUG << "dcgmModuleSendBlockingFixedRequest returned " << ret;
+        return ret;
+    }
+
+    cmdRet = (dcgmReturn_t)msg.fv.cmdRet;
+    if (cmdRet != DCGM_ST_OK)
+        return DCGM_ST_OK;
+
+    DcgmFvBuffer fvBuffer(0);
+    fvBuffer.SetFromBuffer(msg.fv.buffer, std::min((size_t)msg.fv.bufferSize, sizeof(msg.fv.buffer)));
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    for (dcgmBufferedFv_t *fv = fvBuffer.GetNextFv(&cursor); fv; fv = fvBuffer.GetNextFv(&cursor))
+    {
+        dcgmFieldValue_v1 value {};
+        fvBuffer.ConvertBufferedFvToFv1(fv, &value);
+        values.push_back(value);
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperGetValuesSinceBucketed(dcgmHandle_t pDcgmHandle,
+                                                 dcgmGpuGrp_t groupId,
+                                                 dcgmFieldGrp_t fieldGroupId,
+                                                 long long sinceTimestamp,
+                                                 long long bucketWidthUsec,
+                                                 dcgmBucketAggregation_t aggregation,
+                                                 long long *nextSinceTimestamp,
+                                                 dcgmFieldValueEntityEnumeration_f enumCB,
+                                                 void *userData)
+{
+    dcgmGroupInfo_t groupInfo           = {};
+    dcgmFieldGroupInfo_t fieldGroupInfo = {};
+    long long endQueryTimestamp         = 0;
+    dcgmReturn_t dcgmSt;
+
+    if (!enumCB || !nextSinceTimestamp || bucketWidthUsec <= 0 || sinceTimestamp < 0
+        || aggregation < DCGM_BUCKET_AGG_MIN || aggregation > DCGM_BUCKET_AGG_COUNT)
+    {
+        DCGM_LOG_ERROR << "Bad param to helperGetValuesSinceBucketed";
+        return DCGM_ST_BADPARAM;
+    }
+
+    *nextSinceTimestamp = sinceTimestamp;
+
+    fieldGroupInfo.version      = dcgmFieldGroupInfo_version;
+    fieldGroupInfo.fieldGroupId = fieldGroupId;
+    dcgmSt                      = dcgmFieldGroupGetInfo(pDcgmHandle, &fieldGroupInfo);
+    if (dcgmSt != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got dcgmSt " << dcgmSt << " from dcgmFieldGroupGetInfo() fieldGroupId "
+                       << (void *)fieldGroupId;
+        return dcgmSt;
+    }
+
+    groupInfo.version = dcgmGroupInfo_version;
+    dcgmSt            = helperGroupGetInfo(pDcgmHandle, groupId, &groupInfo, &endQueryTimestamp);
+    if (dcgmSt != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "helperGroupGetInfo groupId " << (void *)groupId << " returned " << dcgmSt;
+        return dcgmSt;
+    }
+
+    /* Only return buckets that are complete as of the host engine's clock so that the next call
+       starting at nextSinceTimestamp doesn't return a bucket again with more samples in it */
+    long long startTs = sinceTimestamp - (sinceTimestamp % bucketWidthUsec);
+    long long endTs   = endQueryTimestamp - (endQueryTimestamp % bucketWidthUsec) - 1;
+    if (endTs < startTs)
+    {
+        DCGM_LOG_DEBUG << "No complete buckets since " << sinceTimestamp;
+        return DCGM_ST_OK;
+    }
+
+    std::vector<dcgmFieldValue_v1> values;
+    values.reserve(DCGM_MAX_BUCKETS_PER_REQUEST);
+
+    for (unsigned int i = 0; i < groupInfo.count; i++)
+    {
+        dcgm_field_entity_group_t entityGroup = groupInfo.entityList[i].entityGroupId;
+        dcgm_field_eid_t entityId             = groupInfo.entityList[i].entityId;
+
+        for (unsigned int j = 0; j < fieldGroupInfo.numFieldIds; j++)
+        {
+            unsigned short fieldId      = fieldGroupInfo.fieldIds[j];
+            dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+            if (!fieldMeta)
+            {
+                DCGM_LOG_ERROR << "Invalid fieldId " << fieldId;
+                return DCGM_ST_UNKNOWN_FIELD;
+            }
+
+            dcgm_field_entity_group_t queryEntityGroup
+                = fieldMeta->scope == DCGM_FS_GLOBAL ? DCGM_FE_NONE : entityGroup;
+            long long pageStartTs = startTs;
+            for (;;)
+            {
+                dcgmReturn_t cmdRet = DCGM_ST_OK;
+
+                values.clear();
+                dcgmSt = helperGetBucketedValuesForField(pDcgmHandle,
+                                                         queryEntityGroup,
+                                                         entityId,
+                                                         fieldId,
+                                                         pageStartTs,
+                                                         endTs,
+                                                         bucketWidthUsec,
+                                                         aggregation,
+                                                         values,
+                                                         cmdRet);
+                if (dcgmSt != DCGM_ST_OK)
+                    return dcgmSt;
+
+                if ((cmdRet == DCGM_ST_NO_DATA || cmdRet == DCGM_ST_NOT_SUPPORTED) && pageStartTs == startTs)
+                {
+                    /* Handle these returns by setting the field value status rather than failing the API */
+                    dcgmFieldValue_v1 value {};
+                    value.version   = dcgmFieldValue_version1;
+                    value.fieldId   = fieldId;
+                    value.fieldType = fieldMeta->fieldType;
+                    setFvValueAsBlank(value, fieldMeta->fieldType);
+                    value.status = cmdRet;
+                    values.push_back(value);
+                }
+                else if (cmdRet == DCGM_ST_NO_DATA)
+                {
+                    break; /* The previous page ended right at the last bucket */
+                }
+                else if (cmdRet != DCGM_ST_OK)
+                {
+                    DCGM_LOG_ERROR << "Got st " << cmdRet << " getting buckets of eg " << entityGroup << ", eid "
+                                   << entityId << ", fieldId " << fieldId;
+                    return cmdRet;
+                }
+
+                if (enumCB(entityGroup, entityId, values.data(), values.size(), userData) != 0)
+                {
+                    DCGM_LOG_DEBUG << "User requested callback exit";
+                    /* Leaving status as OK. User requested the exit */
+                    return DCGM_ST_OK;
+                }
+
+                if (cmdRet != DCGM_ST_OK || values.size() < DCGM_MAX_BUCKETS_PER_REQUEST)
+                    break;
+
+                pageStartTs = values.back().ts + bucketWidthUsec;
+                if (pageStartTs > endTs)
+                    break;
+            }
+        }
+    }
+
+    /* Success. We can advance the caller's next query timestamp */
+    *nextSinceTimestamp = endTs + 1;
+    DCGM_LOG_DEBUG << "nextSinceTimestamp advanced to " << *nextSinceTimestamp;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+/* Acknowledge batches of a field value stream of a remote connection */
+static void helperAckFieldValueStream(dcgmHandle_t dcgmHandle, dcgm_request_id_t requestId, unsigned int numBatches)
+{
+    DcgmClientHandler *clientHandler = dcgmapiAcquireClientHandler(false);
+    if (!clientHandler)
+    {
+        DCGM_LOG_DEBUG << "Not acking a stream batch with no client handler";
+        return;
+    }
+
+    dcgm_msg_fv_stream_ack_t ack {};
+    ack.numBatches = numBatches;
+
+    dcgmReturn_t dcgmReturn
+        = clientHandler->SendRawMessage(dcgmHandle, DCGM_MSG_FV_STREAM_ACK, requestId, &ack, sizeof(ack));
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " acking requestId " << requestId;
+    }
+
+    dcgmapiReleaseClientHandler();
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperFieldValueStreamSubscribe(dcgmHandle_t dcgmHandle,
+                                                    dcgmFieldValueStreamParams_t *params,
+                                                    dcgmFieldValueEntityEnumeration_f callback,
+                                                    void *userData,
+                                                    unsigned int *streamId)
+{
+    if (!params || !callback || !streamId)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+    if (params->version != dcgmFieldValueStreamParams_version1)
+    {
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    /* Embedded clients get their batches synchronously, so they have nothing to ack */
+    DcgmFvStreamRequest::AckFn ackFn;
+    if (dcgmHandle != (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+    {
+        ackFn = [dcgmHandle](dcgm_request_id_t requestId, unsigned int numBatches) {
+            helperAckFieldValueStream(dcgmHandle, requestId, numBatches);
+        };
+    }
+
+    std::unique_ptr<DcgmFvStreamRequest> streamRequest
+        = std::make_unique<DcgmFvStreamRequest>(callback, userData, std::move(ackFn));
+
+    dcgm_core_msg_fv_stream_subscribe_t msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_FV_STREAM_SUBSCRIBE;
+    msg.header.version    = dcgm_core_msg_fv_stream_subscribe_version;
+    memcpy(&msg.params, params, sizeof(msg.params));
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn
+        = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg), std::move(streamRequest));
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    if (msg.cmdRet != DCGM_ST_OK)
+    {
+        return (dcgmReturn_t)msg.cmdRet;
+    }
+
+    /* The stream is known by the requestId of the request that subscribed it */
+    *streamId = msg.header.requestId;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperFieldValueStreamUnsubscribe(dcgmHandle_t dcgmHandle, unsigned int streamId)
+{
+    dcgm_core_msg_fv_stream_unsubscribe_t msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_FV_STREAM_UNSUBSCRIBE;
+    msg.header.version    = dcgm_core_msg_fv_stream_unsubscribe_version;
+    msg.streamId          = streamId;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    return (dcgmReturn_t)msg.cmdRet;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperProxyStreamSubscribe(dcgmHandle_t dcgmHandle,
+                                               dcgmFieldValueStreamParams_t *params,
+                                               dcgmProxyFieldValueEnumeration_f callback,
+                                               void *userData,
+                                               unsigned int *streamId)
+{
+    if (!params || !callback || !streamId)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+    if (params->version != dcgmFieldValueStreamParams_version1)
+    {
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    /* Proxy batches are acked like those of field value streams */
+    DcgmProxyStreamRequest::AckFn ackFn;
+    if (dcgmHandle != (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+    {
+        ackFn = [dcgmHandle](dcgm_request_id_t requestId, unsigned int numBatches) {
+            helperAckFieldValueStream(dcgmHandle, requestId, numBatches);
+        };
+    }
+
+    std::unique_ptr<DcgmProxyStreamRequest> streamRequest
+        = std::make_unique<DcgmProxyStreamRequest>(callback, userData, std::move(ackFn));
+
+    dcgm_core_msg_proxy_stream_subscribe_t msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_PROXY_STREAM_SUBSCRIBE;
+    msg.header.version    = dcgm_core_msg_proxy_stream_subscribe_version;
+    memcpy(&msg.params, params, sizeof(msg.params));
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn
+        = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg), std::move(streamRequest));
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    if (msg.cmdRet != DCGM_ST_OK)
+    {
+        return (dcgmReturn_t)msg.cmdRet;
+    }
+
+    *streamId = msg.header.requestId;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperProxyStreamUnsubscribe(dcgmHandle_t dcgmHandle, unsigned int streamId)
+{
+    dcgm_core_msg_proxy_stream_unsubscribe_t msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_PROXY_STREAM_UNSUBSCRIBE;
+    msg.header.version    = dcgm_core_msg_proxy_stream_unsubscribe_version;
+    msg.streamId          = streamId;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    return (dcgmReturn_t)msg.cmdRet;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperProxyGetHosts(dcgmHandle_t dcgmHandle, dcgmProxyHosts_t *hosts)
+{
+    if (hosts == nullptr)
+        return DCGM_ST_BADPARAM;
+    if (hosts->version != dcgmProxyHosts_version1)
+        return DCGM_ST_VER_MISMATCH;
+
+    dcgm_core_msg_proxy_get_hosts_t msg = {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_PROXY_GET_HOSTS;
+    msg.header.version    = dcgm_core_msg_proxy_get_hosts_version;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        dcgmReturn = (dcgmReturn_t)msg.cmdRet;
+    }
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    memcpy(hosts, &msg.hosts, sizeof(*hosts));
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperHostengineGetWorkerStats(dcgmHandle_t dcgmHandle, dcgmHostengineWorkerStats_t *stats)
+{
+    if (stats == nullptr)
+        return DCGM_ST_BADPARAM;
+    if (stats->version != dcgmHostengineWorkerStats_version1)
+        return DCGM_ST_VER_MISMATCH;
+
+    dcgm_core_msg_get_worker_stats_t msg = {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_GET_WORKER_STATS;
+    msg.header.version    = dcgm_core_msg_get_worker_stats_version;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        dcgmReturn = (dcgmReturn_t)msg.cmdRet;
+    }
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    memcpy(stats, &msg.stats, sizeof(*stats));
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperIntrospectGetRequestStats(dcgmHandle_t dcgmHandle, dcgmIntrospectRequestStats_t *requestStats)
+{
+    if (requestStats == nullptr)
+        return DCGM_ST_BADPARAM;
+    if (requestStats->version != dcgmIntrospectRequestStats_version1)
+        return DCGM_ST_VER_MISMATCH;
+
+    /* Too big for the stack */
+    auto msg               = std::make_unique<dcgm_core_msg_get_request_stats_t>();
+    msg->header.length     = sizeof(*msg);
+    msg->header.moduleId   = DcgmModuleIdCore;
+    msg->header.subCommand = DCGM_CORE_SR_GET_REQUEST_STATS;
+    msg->header.version    = dcgm_core_msg_get_request_stats_version;
+    msg->stats.version     = requestStats->version;
+    msg->stats.flags       = requestStats->flags;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg->header, sizeof(*msg));
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        dcgmReturn = (dcgmReturn_t)msg->cmdRet;
+    }
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    memcpy(requestStats, &msg->stats, sizeof(*requestStats));
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperIntrospectGetMemoryAccounting(dcgmHandle_t dcgmHandle,
+                                                        dcgmIntrospectMemoryAccounting_t *accounting)
+{
+    if (accounting == nullptr)
+        return DCGM_ST_BADPARAM;
+    if (accounting->version != dcgmIntrospectMemoryAccounting_version1)
+        return DCGM_ST_VER_MISMATCH;
+
+    dcgm_core_msg_get_memory_accounting_t msg {};
+    msg.header.length      = sizeof(msg);
+    msg.header.moduleId    = DcgmModuleIdCore;
+    msg.header.subCommand  = DCGM_CORE_SR_GET_MEMORY_ACCOUNTING;
+    msg.header.version     = dcgm_core_msg_get_memory_accounting_version;
+    msg.accounting.version = accounting->version;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        dcgmReturn = (dcgmReturn_t)msg.cmdRet;
+    }
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    memcpy(accounting, &msg.accounting, sizeof(*accounting));
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperIntrospectEstimateWatchCost(dcgmHandle_t dcgmHandle, dcgmIntrospectWatchCost_t *cost)
+{
+    if (cost == nullptr)
+        return DCGM_ST_BADPARAM;
+    if (cost->version != dcgmIntrospectWatchCost_version1)
+        return DCGM_ST_VER_MISMATCH;
+
+    dcgm_core_msg_estimate_watch_cost_t msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_ESTIMATE_WATCH_COST;
+    msg.header.version    = dcgm_core_msg_estimate_watch_cost_version;
+    memcpy(&msg.cost, cost, sizeof(msg.cost));
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        dcgmReturn = (dcgmReturn_t)msg.cmdRet;
+    }
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    memcpy(cost, &msg.cost, sizeof(*cost));
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperGetTransportStats(dcgmHandle_t dcgmHandle, dcgmTransportStats_t *stats)
+{
+    if (stats == nullptr)
+        return DCGM_ST_BADPARAM;
+    if (stats->version != dcgmTransportStats_version1 && stats->version != dcgmTransportStats_version2)
+        return DCGM_ST_VER_MISMATCH;
+    if (dcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+        return DCGM_ST_NOT_SUPPORTED; /* Nothing goes over a socket */
+
+    dcgm_core_msg_get_transport_stats_t msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_GET_TRANSPORT_STATS;
+    msg.header.version    = dcgm_core_msg_get_transport_stats_version;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        dcgmReturn = (dcgmReturn_t)msg.cmdRet;
+    }
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    DcgmClientHandler *clientHandler = dcgmapiAcquireClientHandler(true);
+    if (!clientHandler)
+    {
+        DCGM_LOG_ERROR << "Unable to acqire the client handler";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    /* Taken after the exchange above, so the client counters include both of its messages */
+    DcgmIpcConnectionStats_t clientStats {};
+    dcgmReturn = clientHandler->GetConnectionStats(dcgmHandle, clientStats);
+    dcgmapiReleaseClientHandler();
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    /* Version 2 only appended fields, so version 1 is a prefix of it */
+    dcgmTransportStats_v2 statsV2 {};
+    statsV2.version              = stats->version;
+    statsV2.compression          = clientStats.compression;
+    statsV2.compressionThreshold = clientStats.compressionThreshold;
+    statsV2.client               = clientStats.counters;
+    statsV2.hostEngine           = msg.counters;
+    statsV2.clientSendQueue      = clientStats.sendQueue;
+    statsV2.hostEngineSendQueue  = msg.sendQueue;
+
+    if (stats->version == dcgmTransportStats_version1)
+        memcpy(stats, &statsV2, sizeof(dcgmTransportStats_v1));
+    else
+        *stats = statsV2;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperSession(dcgmHandle_t dcgmHandle, unsigned int subCommand, unsigned long long *token)
+{
+    if (token == nullptr)
+        return DCGM_ST_BADPARAM;
+    if (dcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+        return DCGM_ST_NOT_SUPPORTED; /* Embedded state goes away with the process */
+
+    dcgm_core_msg_session_t msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = subCommand;
+    msg.header.version    = dcgm_core_msg_session_version;
+    msg.token             = *token;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+    if (msg.cmdRet != DCGM_ST_OK)
+        return (dcgmReturn_t)msg.cmdRet;
+
+    *token = msg.token;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t helperClientCacheEnable(dcgmHandle_t dcgmHandle)
+{
+    if (dcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+        return DCGM_ST_NOT_SUPPORTED; /* Calls are already served in-process */
+
+    DcgmClientHandler *clientHandler = dcgmapiAcquireClientHandler(true);
+    if (!clientHandler)
+    {
+        DCGM_LOG_ERROR << "Unable to acqire the client handler";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    if (clientHandler->GetAttributeCache(dcgmHandle) != nullptr)
+    {
+        dcgmapiReleaseClientHandler();
+        return DCGM_ST_OK; /* Already enabled */
+    }
 
-CLEANUP:
-    if (fieldValues)
+    auto cache = std::make_shared<DcgmAttributeCache>();
+
+    dcgm_core_msg_attribute_cache_subscribe_t msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_ATTRIBUTE_CACHE_SUBSCRIBE;
+    msg.header.version    = dcgm_core_msg_attribute_cache_subscribe_version;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(
+        dcgmHandle, &msg.header, sizeof(msg), std::make_unique<DcgmAttributeCacheRequest>(cache));
+    if (dcgmReturn == DCGM_ST_OK)
     {
-        free(fieldValues);
-        fieldValues = 0;
+        dcgmReturn = (dcgmReturn_t)msg.cmdRet;
     }
 
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        /* Changes pushed before this response only move the cache further */
+        cache->SetGeneration(msg.generation);
+        clientHandler->SetAttributeCache(dcgmHandle, std::move(cache));
+    }
+    else
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " subscribing to attribute generation changes";
+    }
 
-    return retDcgmSt;
+    dcgmapiReleaseClientHandler();
+    return dcgmReturn;
 }
 
 /*****************************************************************************/
@@ -3893,6 +5337,77 @@ static dcgmReturn_t helperGetLatestValues(dcgmHandle_t pDcgmHandle,
     return retDcgmSt;
 }
 
+/*****************************************************************************/
+static dcgmReturn_t helperGetLatestValuesMatrix(dcgmHandle_t pDcgmHandle,
+                                                dcgmGpuGrp_t groupId,
+                                                dcgmFieldGrp_t fieldGroupId,
+                                                dcgmLatestValuesMatrix_v1 *matrix)
+{
+    if (!matrix)
+    {
+        DCGM_LOG_ERROR << "Bad param to helperGetLatestValuesMatrix";
+        return DCGM_ST_BADPARAM;
+    }
+    if (matrix->version != dcgmLatestValuesMatrix_version)
+    {
+        DCGM_LOG_ERROR << "Version mismatch " << std::hex << matrix->version
+                       << " != " << dcgmLatestValuesMatrix_version;
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    /* The cells come after the message. See DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX */
+    std::vector<char> msgBytes(sizeof(dcgm_core_msg_get_latest_values_matrix_t) + DCGM_MATRIX_REPLY_MAX_BUFFER_SIZE);
+    auto msg = (dcgm_core_msg_get_latest_values_matrix_t *)msgBytes.data();
+
+    msg->header.length     = sizeof(*msg); /* Only send the request. The host engine makes room for the cells */
+    msg->header.moduleId   = DcgmModuleIdCore;
+    msg->header.subCommand = DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX;
+    msg->header.version    = dcgm_core_msg_get_latest_values_matrix_version;
+    msg->groupId           = groupId;
+    msg->fieldGroupId      = fieldGroupId;
+
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(pDcgmHandle, &msg->header, msgBytes.size());
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "dcgmModuleSendBlockingFixedRequest returned " << ret;
+        return ret;
+    }
+    if (DCGM_ST_OK != msg->cmdRet)
+    {
+        DCGM_LOG_ERROR << "Got message status " << msg->cmdRet;
+        return (dcgmReturn_t)msg->cmdRet;
+    }
+
+    size_t const numCells = (size_t)msg->numEntities * msg->numFields;
+    if (msg->numEntities > DCGM_GROUP_MAX_ENTITIES || msg->numFields > DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP
+        || msg->stringsSize > DCGM_MATRIX_STRINGS_SIZE
+        || msg->header.length != sizeof(*msg) + DCGM_MATRIX_REPLY_BUFFER_SIZE(numCells, msg->stringsSize))
+    {
+        DCGM_LOG_ERROR << "Malformed DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX response. numEntities "
+                       << msg->numEntities << ", numFields " << msg->numFields << ", stringsSize "
+                       << msg->stringsSize << ", length " << msg->header.length;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    matrix->numEntities = msg->numEntities;
+    matrix->numFields   = msg->numFields;
+    matrix->stringsSize = msg->stringsSize;
+    memcpy(matrix->entities, msg->entities, msg->numEntities * sizeof(matrix->entities[0]));
+    memcpy(matrix->fieldIds, msg->fieldIds, msg->numFields * sizeof(matrix->fieldIds[0]));
+    memcpy(matrix->fieldTypes, msg->fieldTypes, msg->numFields * sizeof(matrix->fieldTypes[0]));
+
+    char const *buffer = msgBytes.data() + sizeof(*msg);
+    memcpy(matrix->values, buffer, numCells * sizeof(matrix->values[0]));
+    buffer += numCells * sizeof(matrix->values[0]);
+    memcpy(matrix->timestamps, buffer, numCells * sizeof(matrix->timestamps[0]));
+    buffer += numCells * sizeof(matrix->timestamps[0]);
+    memcpy(matrix->status, buffer, numCells * sizeof(matrix->status[0]));
+    buffer += numCells * sizeof(matrix->status[0]);
+    memcpy(matrix->strings, buffer, msg->stringsSize);
+
+    return DCGM_ST_OK;
+}
+
 dcgmReturn_t tsapiWatchFields(dcgmHandle_t pDcgmHandle,
                               dcgmGpuGrp_t groupId,
                               dcgmFieldGrp_t fieldGroupId,
@@ -3980,6 +5495,73 @@ dcgmReturn_t cmTsapiWatchFields(dcgmHandle_t pDcgmHandle,
     return (dcgmReturn_t)msg.watchInfo.cmdRet;
 }
 
+dcgmReturn_t tsapiWatchFieldsSnapshot(dcgmHandle_t pDcgmHandle,
+                                      dcgmGpuGrp_t groupId,
+                                      dcgmFieldGrp_t fieldGroupId,
+                                      long long updateFreq,
+                                      double maxKeepAge,
+                                      int maxKeepSamples)
+{
+    if (!groupId)
+    {
+        DCGM_LOG_ERROR << "Bad param";
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgm_core_msg_watch_fields_t msg = {};
+
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_WATCH_FIELDS_SNAPSHOT;
+    msg.header.version    = dcgm_core_msg_watch_fields_version;
+
+    msg.watchInfo.groupId        = groupId;
+    msg.watchInfo.fieldGroupId   = fieldGroupId;
+    msg.watchInfo.updateFreq     = updateFreq;
+    msg.watchInfo.maxKeepAge     = maxKeepAge;
+    msg.watchInfo.maxKeepSamples = maxKeepSamples;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(pDcgmHandle, &msg.header, sizeof(msg));
+
+    if (DCGM_ST_OK != ret)
+    {
+        return ret;
+    }
+
+    return (dcgmReturn_t)msg.watchInfo.cmdRet;
+}
+
+dcgmReturn_t tsapiSetDerivedField(dcgmHandle_t pDcgmHandle, dcgmDerivedField_t *derivedField)
+{
+    if (!derivedField)
+    {
+        DCGM_LOG_ERROR << "Bad param";
+        return DCGM_ST_BADPARAM;
+    }
+    if (derivedField->version != dcgmDerivedField_version1)
+        return DCGM_ST_VER_MISMATCH;
+
+    dcgm_core_msg_set_derived_field_t msg = {};
+
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_SET_DERIVED_FIELD;
+    msg.header.version    = dcgm_core_msg_set_derived_field_version;
+    memcpy(&msg.derivedField, derivedField, sizeof(msg.derivedField));
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(pDcgmHandle, &msg.header, sizeof(msg));
+
+    if (DCGM_ST_OK != ret)
+    {
+        return ret;
+    }
+
+    SafeCopyTo(derivedField->error, msg.derivedField.error);
+    return (dcgmReturn_t)msg.cmdRet;
+}
+
 dcgmReturn_t tsapiUnwatchFields(dcgmHandle_t pDcgmHandle, dcgmGpuGrp_t groupId, dcgmFieldGrp_t fieldGroupId)
 {
     dcgm::UnwatchFields *pUnwatchFields;     /* Request message */
@@ -4155,6 +5737,18 @@ dcgmReturn_t tsapiFieldGroupGetInfo(dcgmHandle_t pDcgmHandle, dcgmFieldGroupInfo
     if (!fieldGroupInfo->version)
         return DCGM_ST_VER_MISMATCH;
 
+    std::shared_ptr<DcgmAttributeCache> cache = dcgmapiGetAttributeCache(pDcgmHandle);
+    DcgmAttributeCache::Key const cacheKey { DcgmAttributeCacheKindFieldGroupInfo,
+                                             (uintptr_t)fieldGroupInfo->fieldGroupId,
+                                             fieldGroupInfo->version };
+    unsigned long long cacheGeneration = 0;
+    if (cache != nullptr)
+    {
+        if (cache->LookupStruct(cacheKey, *fieldGroupInfo))
+            return DCGM_ST_OK;
+        cacheGeneration = cache->GetGeneration();
+    }
+
     dcgm_core_msg_fieldgroup_op_t msg = {};
 
     msg.header.length     = sizeof(msg);
@@ -4176,6 +5770,11 @@ dcgmReturn_t tsapiFieldGroupGetInfo(dcgmHandle_t pDcgmHandle, dcgmFieldGroupInfo
 
     memcpy(fieldGroupInfo, &msg.info.fg, sizeof(msg.info.fg));
 
+    if (cache != nullptr && msg.info.cmdRet == DCGM_ST_OK)
+    {
+        cache->StoreStruct(cacheKey, cacheGeneration, *fieldGroupInfo);
+    }
+
     return (dcgmReturn_t)msg.info.cmdRet;
 }
 
@@ -4191,6 +5790,16 @@ dcgmReturn_t tsapiFieldGroupGetAll(dcgmHandle_t pDcgmHandle, dcgmAllFieldGroup_t
         return DCGM_ST_VER_MISMATCH;
     }
 
+    std::shared_ptr<DcgmAttributeCache> cache = dcgmapiGetAttributeCache(pDcgmHandle);
+    DcgmAttributeCache::Key const cacheKey { DcgmAttributeCacheKindFieldGroupAll, 0, allGroupInfo->version };
+    unsigned long long cacheGeneration = 0;
+    if (cache != nullptr)
+    {
+        if (cache->LookupStruct(cacheKey, *allGroupInfo))
+            return DCGM_ST_OK;
+        cacheGeneration = cache->GetGeneration();
+    }
+
     dcgm_core_msg_fieldgroup_get_all_t msg = {};
 
     msg.header.length     = sizeof(msg);
@@ -4212,6 +5821,11 @@ dcgmReturn_t tsapiFieldGroupGetAll(dcgmHandle_t pDcgmHandle, dcgmAllFieldGroup_t
 
     memcpy(allGroupInfo, &msg.info.fg, sizeof(msg.info.fg));
 
+    if (cache != nullptr && msg.info.cmdRet == DCGM_ST_OK)
+    {
+        cache->StoreStruct(cacheKey, cacheGeneration, *allGroupInfo);
+    }
+
     return (dcgmReturn_t)msg.info.cmdRet;
 }
 
@@ -4879,6 +6493,25 @@ static dcgmReturn_t tsapiGetEntityGroupEntities(dcgmHandle_t dcgmHandle,
 
     int onlySupported = (flags & DCGM_GEGE_FLAG_ONLY_SUPPORTED) ? 1 : 0;
 
+    std::shared_ptr<DcgmAttributeCache> cache = dcgmapiGetAttributeCache(dcgmHandle);
+    DcgmAttributeCache::Key const cacheKey { DcgmAttributeCacheKindEntityGroupEntities, entityGroup, flags };
+    unsigned long long cacheGeneration = 0;
+    if (cache != nullptr)
+    {
+        std::vector<char> cached;
+        if (cache->Lookup(cacheKey, cached))
+        {
+            *numEntities = (int)(cached.size() / sizeof(dcgm_field_eid_t));
+            if (*numEntities > entitiesCapacity)
+            {
+                return DCGM_ST_INSUFFICIENT_SIZE;
+            }
+            memcpy(entities, cached.data(), cached.size());
+            return DCGM_ST_OK;
+        }
+        cacheGeneration = cache->GetGeneration();
+    }
+
     /* Add Command to the protobuf encoder object */
     pCmdTemp = encodePrb.AddCommand(dcgm::GET_ENTITY_LIST, dcgm::OPERATION_SYSTEM, -1, 0);
     if (!pCmdTemp)
@@ -4933,6 +6566,11 @@ static dcgmReturn_t tsapiGetEntityGroupEntities(dcgmHandle_t dcgmHandle,
         entities[index] = pEntityList->mutable_entity(index)->entityid();
     }
 
+    if (cache != nullptr)
+    {
+        cache->Store(cacheKey, cacheGeneration, entities, *numEntities * sizeof(dcgm_field_eid_t));
+    }
+
     return DCGM_ST_OK;
 }
 
@@ -5142,6 +6780,39 @@ dcgmReturn_t tsapiDeleteMigEntity(dcgmHandle_t dcgmHandle, dcgmDeleteMigEntity_t
     return dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
 }
 
+dcgmReturn_t tsapiTraceControl(dcgmHandle_t dcgmHandle, dcgmTraceControl_t *traceControl)
+{
+    if (traceControl == nullptr)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    if (traceControl->version != dcgmTraceControl_version1)
+    {
+        DCGM_LOG_ERROR << "dcgmTraceControl version mismatch " << traceControl->version
+                       << " != " << dcgmTraceControl_version1;
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    dcgm_core_msg_trace_control_t msg = {};
+
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_TRACE_CONTROL;
+    msg.header.version    = dcgm_core_msg_trace_control_version;
+    memcpy(&msg.info.tc, traceControl, sizeof(msg.info.tc));
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
+    }
+
+    memcpy(traceControl, &msg.info.tc, sizeof(msg.info.tc));
+    return (dcgmReturn_t)msg.info.cmdRet;
+}
+
 dcgmReturn_t tsapiGetNvLinkLinkStatus(dcgmHandle_t dcgmHandle, dcgmNvLinkStatus_v2 *linkStatus)
 {
     if (!linkStatus)
@@ -5186,7 +6857,85 @@ static dcgmReturn_t tsapiEngineGetDeviceAttributes(dcgmHandle_t pDcgmHandle,
                                                    unsigned int gpuId,
                                                    dcgmDeviceAttributes_t *pDcgmDeviceAttr)
 {
-    return helperDeviceGetAttributes(pDcgmHandle, gpuId, pDcgmDeviceAttr);
+    std::shared_ptr<DcgmAttributeCache> cache = dcgmapiGetAttributeCache(pDcgmHandle);
+    if (cache == nullptr || pDcgmDeviceAttr == nullptr)
+    {
+        return helperDeviceGetAttributes(pDcgmHandle, gpuId, pDcgmDeviceAttr);
+    }
+
+    DcgmAttributeCache::Key const cacheKey { DcgmAttributeCacheKindDeviceAttributes, gpuId, pDcgmDeviceAttr->version };
+    if (cache->LookupStruct(cacheKey, *pDcgmDeviceAttr))
+    {
+        return DCGM_ST_OK;
+    }
+
+    unsigned long long cacheGeneration = cache->GetGeneration();
+    dcgmReturn_t dcgmReturn            = helperDeviceGetAttributes(pDcgmHandle, gpuId, pDcgmDeviceAttr);
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        cache->StoreStruct(cacheKey, cacheGeneration, *pDcgmDeviceAttr);
+    }
+    return dcgmReturn;
+}
+
+static dcgmReturn_t tsapiEngineGetDeviceAttributesBulk(dcgmHandle_t pDcgmHandle,
+                                                       unsigned int gpuIds[],
+                                                       unsigned int count,
+                                                       dcgmDeviceAttributes_t attributes[])
+{
+    std::shared_ptr<DcgmAttributeCache> cache = dcgmapiGetAttributeCache(pDcgmHandle);
+    if (cache == nullptr || gpuIds == nullptr || attributes == nullptr || count > DCGM_MAX_NUM_DEVICES)
+    {
+        return helperDeviceGetAttributesBulk(pDcgmHandle, gpuIds, count, attributes);
+    }
+
+    /* Only ask the host engine for the GPUs that aren't cached yet */
+    unsigned int missingGpuIds[DCGM_MAX_NUM_DEVICES];
+    unsigned int missingIndexes[DCGM_MAX_NUM_DEVICES];
+    std::unique_ptr<dcgmDeviceAttributes_t[]> missingAttributes;
+    unsigned int missingCount = 0;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        DcgmAttributeCache::Key const cacheKey { DcgmAttributeCacheKindDeviceAttributes,
+                                                 gpuIds[i],
+                                                 attributes[i].version };
+        if (!cache->LookupStruct(cacheKey, attributes[i]))
+        {
+            missingGpuIds[missingCount]  = gpuIds[i];
+            missingIndexes[missingCount] = i;
+            missingCount++;
+        }
+    }
+
+    if (missingCount == 0)
+    {
+        return DCGM_ST_OK;
+    }
+
+    missingAttributes.reset(new dcgmDeviceAttributes_t[missingCount]);
+    for (unsigned int i = 0; i < missingCount; i++)
+    {
+        missingAttributes[i] = attributes[missingIndexes[i]];
+    }
+
+    unsigned long long cacheGeneration = cache->GetGeneration();
+    dcgmReturn_t dcgmReturn
+        = helperDeviceGetAttributesBulk(pDcgmHandle, missingGpuIds, missingCount, missingAttributes.get());
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    for (unsigned int i = 0; i < missingCount; i++)
+    {
+        DcgmAttributeCache::Key const cacheKey { DcgmAttributeCacheKindDeviceAttributes,
+                                                 missingGpuIds[i],
+                                                 missingAttributes[i].version };
+        attributes[missingIndexes[i]] = missingAttributes[i];
+        cache->StoreStruct(cacheKey, cacheGeneration, missingAttributes[i]);
+    }
+    return DCGM_ST_OK;
 }
 
 static dcgmReturn_t tsapiEngineGetVgpuDeviceAttributes(dcgmHandle_t pDcgmHandle,
@@ -5258,6 +7007,14 @@ static dcgmReturn_t tsapiEngineInjectFieldValue(dcgmHandle_t pDcgmHandle,
     return helperInjectFieldValue(pDcgmHandle, gpuId, pDcgmInjectFieldValue);
 }
 
+static dcgmReturn_t tsapiInjectEntityFieldValues(dcgmHandle_t dcgmHandle,
+                                                 dcgmGroupEntityPair_t *entities,
+                                                 dcgmInjectFieldValue_t *values,
+                                                 unsigned int count)
+{
+    return helperInjectEntityFieldValues(dcgmHandle, entities, values, count);
+}
+
 static dcgmReturn_t tsapiEngineGetCacheManagerFieldInfo(dcgmHandle_t pDcgmHandle,
                                                         dcgmCacheManagerFieldInfo_t *fieldInfo)
 {
@@ -5435,6 +7192,11 @@ static dcgmReturn_t tsapiEnginePolicyRegister(dcgmHandle_t pDcgmHandle,
     return helperPolicyRegister(pDcgmHandle, groupId, condition, beginCallback, finishCallback);
 }
 
+static dcgmReturn_t tsapiEnginePolicyRegister_v2(dcgmHandle_t pDcgmHandle, dcgmPolicyRegisterParams_v1 *params)
+{
+    return helperPolicyRegisterV2(pDcgmHandle, params);
+}
+
 static dcgmReturn_t tsapiEnginePolicyUnregister(dcgmHandle_t pDcgmHandle,
                                                 dcgmGpuGrp_t groupId,
                                                 dcgmPolicyCondition_t condition)
@@ -5479,6 +7241,85 @@ static dcgmReturn_t tsapiEngineGetValuesSince_v2(dcgmHandle_t pDcgmHandle,
         pDcgmHandle, groupId, fieldGroupId, sinceTimestamp, nextSinceTimestamp, 0, enumCB, userData);
 }
 
+static dcgmReturn_t tsapiEngineGetValuesSinceBucketed(dcgmHandle_t pDcgmHandle,
+                                                      dcgmGpuGrp_t groupId,
+                                                      dcgmFieldGrp_t fieldGroupId,
+                                                      long long sinceTimestamp,
+                                                      long long bucketWidthUsec,
+                                                      dcgmBucketAggregation_t aggregation,
+                                                      long long *nextSinceTimestamp,
+                                                      dcgmFieldValueEntityEnumeration_f enumCB,
+                                                      void *userData)
+{
+    return helperGetValuesSinceBucketed(pDcgmHandle,
+                                        groupId,
+                                        fieldGroupId,
+                                        sinceTimestamp,
+                                        bucketWidthUsec,
+                                        aggregation,
+                                        nextSinceTimestamp,
+                                        enumCB,
+                                        userData);
+}
+
+static dcgmReturn_t tsapiFieldValueStreamSubscribe(dcgmHandle_t pDcgmHandle,
+                                                   dcgmFieldValueStreamParams_t *params,
+                                                   dcgmFieldValueEntityEnumeration_f callback,
+                                                   void *userData,
+                                                   unsigned int *streamId)
+{
+    return helperFieldValueStreamSubscribe(pDcgmHandle, params, callback, userData, streamId);
+}
+
+static dcgmReturn_t tsapiFieldValueStreamUnsubscribe(dcgmHandle_t pDcgmHandle, unsigned int streamId)
+{
+    return helperFieldValueStreamUnsubscribe(pDcgmHandle, streamId);
+}
+
+static dcgmReturn_t tsapiProxyStreamSubscribe(dcgmHandle_t pDcgmHandle,
+                                              dcgmFieldValueStreamParams_t *params,
+                                              dcgmProxyFieldValueEnumeration_f callback,
+                                              void *userData,
+                                              unsigned int *streamId)
+{
+    return helperProxyStreamSubscribe(pDcgmHandle, params, callback, userData, streamId);
+}
+
+static dcgmReturn_t tsapiProxyStreamUnsubscribe(dcgmHandle_t pDcgmHandle, unsigned int streamId)
+{
+    return helperProxyStreamUnsubscribe(pDcgmHandle, streamId);
+}
+
+static dcgmReturn_t tsapiProxyGetHosts(dcgmHandle_t pDcgmHandle, dcgmProxyHosts_t *hosts)
+{
+    return helperProxyGetHosts(pDcgmHandle, hosts);
+}
+
+static dcgmReturn_t tsapiHostengineGetWorkerStats(dcgmHandle_t pDcgmHandle, dcgmHostengineWorkerStats_t *stats)
+{
+    return helperHostengineGetWorkerStats(pDcgmHandle, stats);
+}
+
+static dcgmReturn_t tsapiGetTransportStats(dcgmHandle_t pDcgmHandle, dcgmTransportStats_t *stats)
+{
+    return helperGetTransportStats(pDcgmHandle, stats);
+}
+
+static dcgmReturn_t tsapiClientCacheEnable(dcgmHandle_t pDcgmHandle)
+{
+    return helperClientCacheEnable(pDcgmHandle);
+}
+
+static dcgmReturn_t tsapiSessionGetToken(dcgmHandle_t pDcgmHandle, unsigned long long *token)
+{
+    return helperSession(pDcgmHandle, DCGM_CORE_SR_SESSION_GET_TOKEN, token);
+}
+
+static dcgmReturn_t tsapiSessionResume(dcgmHandle_t pDcgmHandle, unsigned long long token)
+{
+    return helperSession(pDcgmHandle, DCGM_CORE_SR_SESSION_RESUME, &token);
+}
+
 static dcgmReturn_t tsapiEngineGetLatestValues(dcgmHandle_t pDcgmHandle,
                                                dcgmGpuGrp_t groupId,
                                                dcgmFieldGrp_t fieldGroupId,
@@ -5497,6 +7338,14 @@ static dcgmReturn_t tsapiEngineGetLatestValues_v2(dcgmHandle_t pDcgmHandle,
     return helperGetLatestValues(pDcgmHandle, groupId, fieldGroupId, 0, enumCB, userData);
 }
 
+static dcgmReturn_t tsapiEngineGetLatestValuesMatrix(dcgmHandle_t pDcgmHandle,
+                                                     dcgmGpuGrp_t groupId,
+                                                     dcgmFieldGrp_t fieldGroupId,
+                                                     dcgmLatestValuesMatrix_v1 *matrix)
+{
+    return helperGetLatestValuesMatrix(pDcgmHandle, groupId, fieldGroupId, matrix);
+}
+
 static dcgmReturn_t tsapiEngineHealthSet(dcgmHandle_t pDcgmHandle, dcgmGpuGrp_t groupId, dcgmHealthSystems_t systems)
 {
     dcgmHealthSetParams_v2 params {};
@@ -5537,7 +7386,55 @@ static dcgmReturn_t tsapiEngineHealthCheck(dcgmHandle_t pDcgmHandle,
         return DCGM_ST_VER_MISMATCH;
     }
 
-    return helperHealthCheckV4(pDcgmHandle, groupId, reinterpret_cast<dcgmHealthResponse_v4 *>(response));
+    return helperHealthCheckV4(pDcgmHandle, groupId, reinterpret_cast<dcgmHealthResponse_v4 *>(response));
+}
+
+static dcgmReturn_t tsapiEngineHealthCheckAsync(dcgmHandle_t pDcgmHandle,
+                                                dcgmGpuGrp_t groupId,
+                                                dcgmHealthResponse_t *response,
+                                                dcgmRequestComplete_f callback,
+                                                void *userData)
+{
+    if (!response || !callback)
+    {
+        DCGM_LOG_ERROR << "Bad param";
+        return DCGM_ST_BADPARAM;
+    }
+
+    if (response->version != dcgmHealthResponse_version)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    if (pDcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+    {
+        /* The embedded host engine answers without a round trip */
+        callback(tsapiEngineHealthCheck(pDcgmHandle, groupId, response), userData);
+        return DCGM_ST_OK;
+    }
+
+    dcgm_health_msg_check_v4 msg {};
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdHealth;
+    msg.header.subCommand = DCGM_HEALTH_SR_CHECK_V4;
+    msg.header.version    = dcgm_health_msg_check_version4;
+    msg.groupId           = groupId;
+    memcpy(&msg.response, response, sizeof(msg.response));
+
+    return processModuleCommandAtRemoteHostEngineAsync(
+        pDcgmHandle,
+        &msg.header,
+        sizeof(msg),
+        [response, callback, userData](dcgmReturn_t dcgmReturn, dcgm_module_command_header_t *reply) {
+            dcgmReturn = helperCheckAsyncResponse(dcgmReturn, reply, sizeof(dcgm_health_msg_check_v4));
+            if (dcgmReturn == DCGM_ST_OK)
+            {
+                auto healthReply = (dcgm_health_msg_check_v4 *)reply;
+                memcpy(response, &healthReply->response, sizeof(healthReply->response));
+            }
+            callback(dcgmReturn, userData);
+        });
 }
 
 static dcgmReturn_t tsapiEngineActionValidate_v2(dcgmHandle_t pDcgmHandle,
@@ -5890,6 +7787,56 @@ static dcgmReturn_t tsapiEngineJobGetStats(dcgmHandle_t pDcgmHandle, char jobId[
     return DCGM_ST_OK;
 }
 
+static dcgmReturn_t tsapiEngineJobGetStatsAsync(dcgmHandle_t pDcgmHandle,
+                                                char jobId[64],
+                                                dcgmJobInfo_t *pJobInfo,
+                                                dcgmRequestComplete_f callback,
+                                                void *userData)
+{
+    if ((NULL == jobId) || (NULL == pJobInfo) || (NULL == callback) || (0 == jobId[0]))
+        return DCGM_ST_BADPARAM;
+
+    /* Valid version can't be 0 or just any random number  */
+    if (pJobInfo->version != dcgmJobInfo_version)
+    {
+        DCGM_LOG_DEBUG << "Version Mismatch";
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    if (pDcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+    {
+        /* The embedded host engine answers without a round trip */
+        callback(tsapiEngineJobGetStats(pDcgmHandle, jobId, pJobInfo), userData);
+        return DCGM_ST_OK;
+    }
+
+    dcgm_core_msg_job_get_stats_t msg = {};
+
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_JOB_GET_STATS;
+    msg.header.version    = dcgm_core_msg_job_get_stats_version;
+
+    SafeCopyTo(msg.jc.jobId, jobId);
+    msg.jc.jobStats.version = dcgmJobInfo_version;
+
+    return processModuleCommandAtRemoteHostEngineAsync(
+        pDcgmHandle,
+        &msg.header,
+        sizeof(msg),
+        [pJobInfo, callback, userData](dcgmReturn_t dcgmReturn, dcgm_module_command_header_t *reply) {
+            dcgmReturn = helperCheckAsyncResponse(dcgmReturn, reply, sizeof(dcgm_core_msg_job_get_stats_t));
+            if (dcgmReturn == DCGM_ST_OK)
+            {
+                auto jobReply = (dcgm_core_msg_job_get_stats_t *)reply;
+                dcgmReturn    = (dcgmReturn_t)jobReply->jc.cmdRet;
+                if (dcgmReturn == DCGM_ST_OK)
+                    memcpy(pJobInfo, &jobReply->jc.jobStats, sizeof(dcgmJobInfo_t));
+            }
+            callback(dcgmReturn, userData);
+        });
+}
+
 dcgmReturn_t cmTsapiEngineJobGetStats(dcgmHandle_t pDcgmHandle, char jobId[64], dcgmJobInfo_t *pJobInfo)
 {
     if ((NULL == jobId) || (NULL == pJobInfo))
@@ -5936,6 +7883,86 @@ dcgmReturn_t cmTsapiEngineJobGetStats(dcgmHandle_t pDcgmHandle, char jobId[64],
     return DCGM_ST_OK;
 }
 
+static dcgmReturn_t tsapiJobGetStatsSince(dcgmHandle_t pDcgmHandle,
+                                          char jobId[64],
+                                          unsigned long long *updateSequence,
+                                          dcgmJobInfo_t *pJobInfo)
+{
+    if ((NULL == jobId) || (NULL == updateSequence) || (NULL == pJobInfo) || (0 == jobId[0]))
+        return DCGM_ST_BADPARAM;
+
+    if (pJobInfo->version != dcgmJobInfo_version)
+    {
+        DCGM_LOG_DEBUG << "Version Mismatch";
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    dcgm_core_msg_job_get_stats_since_t msg = {};
+
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_JOB_GET_STATS_SINCE;
+    msg.header.version    = dcgm_core_msg_job_get_stats_since_version;
+
+    SafeCopyTo(msg.jobId, jobId);
+    msg.updateSequence   = *updateSequence;
+    msg.jobStats.version = dcgmJobInfo_version;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(pDcgmHandle, &msg.header, sizeof(msg));
+    if (DCGM_ST_OK == ret)
+    {
+        ret = (dcgmReturn_t)msg.cmdRet;
+    }
+    if (DCGM_ST_OK != ret)
+    {
+        return ret;
+    }
+
+    if (msg.updateSequence != *updateSequence)
+    {
+        memcpy(pJobInfo, &msg.jobStats, sizeof(*pJobInfo));
+        *updateSequence = msg.updateSequence;
+    }
+    return DCGM_ST_OK;
+}
+
+static dcgmReturn_t tsapiJobGetPercentiles(dcgmHandle_t pDcgmHandle, char jobId[64], dcgmJobPercentiles_t *percentiles)
+{
+    if ((NULL == jobId) || (NULL == percentiles) || (0 == jobId[0]))
+        return DCGM_ST_BADPARAM;
+
+    if (percentiles->version != dcgmJobPercentiles_version)
+    {
+        DCGM_LOG_DEBUG << "Version Mismatch";
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    dcgm_core_msg_job_get_percentiles_t msg = {};
+
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdCore;
+    msg.header.subCommand = DCGM_CORE_SR_JOB_GET_PERCENTILES;
+    msg.header.version    = dcgm_core_msg_job_get_percentiles_version;
+
+    SafeCopyTo(msg.jobId, jobId);
+    msg.percentiles.version = dcgmJobPercentiles_version;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t ret = dcgmModuleSendBlockingFixedRequest(pDcgmHandle, &msg.header, sizeof(msg));
+    if (DCGM_ST_OK == ret)
+    {
+        ret = (dcgmReturn_t)msg.cmdRet;
+    }
+    if (DCGM_ST_OK != ret)
+    {
+        return ret;
+    }
+
+    memcpy(percentiles, &msg.percentiles, sizeof(*percentiles));
+    return DCGM_ST_OK;
+}
+
 static dcgmReturn_t tsapiEngineJobRemove(dcgmHandle_t pDcgmHandle, char jobId[64])
 {
     DcgmProtobuf encodePrb;                  /* Protobuf message for encoding */
@@ -6016,29 +8043,21 @@ dcgmReturn_t cmTsapiEngineJobRemoveAll(dcgmHandle_t pDcgmHandle)
     return helperJobStatCmd(pDcgmHandle, 0, "", DCGM_CORE_SR_JOB_REMOVE_ALL);
 }
 
-static dcgmReturn_t tsapiEngineGetDeviceTopology(dcgmHandle_t pDcgmHandle,
-                                                 unsigned int gpuId,
-                                                 dcgmDeviceTopology_t *deviceTopology)
+/**
+ * Fetch the PCI topology and the CPU affinity of all of the GPUs of the system
+ */
+static dcgmReturn_t helperGetSystemTopology(dcgmHandle_t pDcgmHandle,
+                                            dcgmTopology_t *groupTopology,
+                                            dcgmAffinity_t *groupAffinity)
 {
-    dcgmTopology_t groupTopology;
-    dcgmAffinity_t groupAffinity;
-    dcgmReturn_t ret = DCGM_ST_OK;
-
-    if (!deviceTopology)
-    {
-        DCGM_LOG_ERROR << "bad deviceTopology " << (void *)deviceTopology;
-        return DCGM_ST_BADPARAM;
-    }
-
-    unsigned int numGpusInTopology = 0;
+    dcgmReturn_t ret;
 
-    memset(&groupTopology, 0, sizeof(groupTopology));
-    memset(&groupAffinity, 0, sizeof(groupAffinity));
-    deviceTopology->version = dcgmDeviceTopology_version;
+    memset(groupTopology, 0, sizeof(*groupTopology));
+    memset(groupAffinity, 0, sizeof(*groupAffinity));
 
     ret = helperGetTopologyPci(pDcgmHandle,
                                (dcgmGpuGrp_t)DCGM_GROUP_ALL_GPUS,
-                               &groupTopology); // retrieve the topology for the entire system
+                               groupTopology); // retrieve the topology for the entire system
     if (DCGM_ST_OK != ret)
     {
         DCGM_LOG_DEBUG << "helperGetTopologyPci returned " << ret;
@@ -6047,6 +8066,21 @@ static dcgmReturn_t tsapiEngineGetDeviceTopology(dcgmHandle_t pDcgmHandle,
 
     // numElements from topology is going to be zero here if DCGM_ST_NO_DATA is returned
 
+    return helperGetTopologyAffinity(pDcgmHandle, (dcgmGpuGrp_t)DCGM_GROUP_ALL_GPUS, groupAffinity);
+}
+
+/**
+ * Fill the topology of one GPU in from the topology and affinity of the whole system
+ */
+static dcgmReturn_t helperExtractDeviceTopology(dcgmTopology_t const &groupTopology,
+                                                dcgmAffinity_t const &groupAffinity,
+                                                unsigned int gpuId,
+                                                dcgmDeviceTopology_t *deviceTopology)
+{
+    unsigned int numGpusInTopology = 0;
+
+    deviceTopology->version = dcgmDeviceTopology_version;
+
     // go through the entire topology looking for a match of gpuId in their gpuA or gpuB of the paths structs
     for (unsigned int index = 0; index < groupTopology.numElements; index++)
     {
@@ -6072,26 +8106,74 @@ static dcgmReturn_t tsapiEngineGetDeviceTopology(dcgmHandle_t pDcgmHandle,
 
     // it is ok at this point to have numGpusInTopology == 0 because there may only be one GPU on the system.
 
-    ret = helperGetTopologyAffinity(pDcgmHandle, (dcgmGpuGrp_t)DCGM_GROUP_ALL_GPUS, &groupAffinity);
-    if (DCGM_ST_OK != ret)
-        return ret;
-
-    bool found = false;
     for (unsigned int index = 0; index < groupAffinity.numGpus; index++)
     {
         if (groupAffinity.affinityMasks[index].dcgmGpuId == gpuId)
         {
-            found = true;
             memcpy(deviceTopology->cpuAffinityMask,
                    groupAffinity.affinityMasks[index].bitmask,
                    sizeof(unsigned long) * DCGM_AFFINITY_BITMASK_ARRAY_SIZE);
-            break;
+            return DCGM_ST_OK;
         }
     }
-    if (!found) // the gpuId was illegal as ALL GPUs should have some affinity
+
+    // the gpuId was illegal as ALL GPUs should have some affinity
+    return DCGM_ST_BADPARAM;
+}
+
+static dcgmReturn_t tsapiEngineGetDeviceTopology(dcgmHandle_t pDcgmHandle,
+                                                 unsigned int gpuId,
+                                                 dcgmDeviceTopology_t *deviceTopology)
+{
+    dcgmTopology_t groupTopology;
+    dcgmAffinity_t groupAffinity;
+    dcgmReturn_t ret = DCGM_ST_OK;
+
+    if (!deviceTopology)
+    {
+        DCGM_LOG_ERROR << "bad deviceTopology " << (void *)deviceTopology;
+        return DCGM_ST_BADPARAM;
+    }
+
+    ret = helperGetSystemTopology(pDcgmHandle, &groupTopology, &groupAffinity);
+    if (DCGM_ST_OK != ret)
+        return ret;
+
+    return helperExtractDeviceTopology(groupTopology, groupAffinity, gpuId, deviceTopology);
+}
+
+static dcgmReturn_t tsapiEngineGetDeviceTopologyBulk(dcgmHandle_t pDcgmHandle,
+                                                     unsigned int gpuIds[],
+                                                     unsigned int count,
+                                                     dcgmDeviceTopology_t topologies[])
+{
+    dcgmTopology_t groupTopology;
+    dcgmAffinity_t groupAffinity;
+    dcgmReturn_t ret = DCGM_ST_OK;
+
+    if (!gpuIds || !topologies || count == 0 || count > DCGM_MAX_NUM_DEVICES)
+    {
+        DCGM_LOG_ERROR << "bad gpuIds " << (void *)gpuIds << ", topologies " << (void *)topologies << " or count "
+                       << count;
         return DCGM_ST_BADPARAM;
+    }
 
-    return ret;
+    /* The system topology holds every GPU, so it is fetched once for all of them */
+    ret = helperGetSystemTopology(pDcgmHandle, &groupTopology, &groupAffinity);
+    if (DCGM_ST_OK != ret)
+        return ret;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        ret = helperExtractDeviceTopology(groupTopology, groupAffinity, gpuIds[i], &topologies[i]);
+        if (DCGM_ST_OK != ret)
+        {
+            DCGM_LOG_ERROR << "Unable to find the topology of GPU " << gpuIds[i];
+            return ret;
+        }
+    }
+
+    return DCGM_ST_OK;
 }
 
 /*
@@ -6318,14 +8400,37 @@ static dcgmReturn_t tsapiIntrospectGetFieldMemoryUsage(dcgmHandle_t dcgmHandle,
     return tsapiIntrospectGetFieldsMemoryUsage(dcgmHandle, &context, memoryInfo, waitIfNoData);
 }
 
+/*****************************************************************************/
+/* Send a DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME request in MsgT, the message that carries execTime's version */
+template <typename MsgT, typename FullFieldsExecTimeT>
+static dcgmReturn_t helperIntrospectGetFieldsExecTime(dcgmHandle_t dcgmHandle,
+                                                      unsigned int msgVersion,
+                                                      dcgmIntrospectContext_t *context,
+                                                      FullFieldsExecTimeT *execTime,
+                                                      int waitIfNoData)
+{
+    auto msg               = std::make_unique<MsgT>();
+    msg->header.length     = sizeof(*msg);
+    msg->header.moduleId   = DcgmModuleIdIntrospect;
+    msg->header.subCommand = DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME;
+    msg->header.version    = msgVersion;
+
+    memcpy(&msg->context, context, sizeof(msg->context));
+    memcpy(&msg->execTime, execTime, sizeof(msg->execTime));
+    msg->waitIfNoData = waitIfNoData;
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg->header, sizeof(*msg));
+
+    memcpy(execTime, &msg->execTime, sizeof(msg->execTime));
+    return dcgmReturn;
+}
+
 static dcgmReturn_t tsapiIntrospectGetFieldsExecTime(dcgmHandle_t dcgmHandle,
                                                      dcgmIntrospectContext_t *context,
                                                      dcgmIntrospectFullFieldsExecTime_t *execTime,
                                                      int waitIfNoData)
 {
-    dcgm_introspect_msg_fields_exec_time_t msg;
-    dcgmReturn_t dcgmReturn;
-
     if ((!context) || (!execTime))
     {
         PRINT_ERROR("", "arg cannot be NULL");
@@ -6340,7 +8445,9 @@ static dcgmReturn_t tsapiIntrospectGetFieldsExecTime(dcgmHandle_t dcgmHandle,
     }
 
     /* Valid version can't be 0 or just any random number  */
-    if (execTime->version != dcgmIntrospectFullFieldsExecTime_version)
+    if (execTime->version != dcgmIntrospectFullFieldsExecTime_version
+        && execTime->version != dcgmIntrospectFullFieldsExecTime_version2
+        && execTime->version != dcgmIntrospectFullFieldsExecTime_version3)
     {
         PRINT_DEBUG("", "Version Mismatch");
         return DCGM_ST_VER_MISMATCH;
@@ -6355,21 +8462,27 @@ static dcgmReturn_t tsapiIntrospectGetFieldsExecTime(dcgmHandle_t dcgmHandle,
         return DCGM_ST_BADPARAM;
     }
 
-    memset(&msg, 0, sizeof(msg));
-    msg.header.length     = sizeof(msg);
-    msg.header.moduleId   = DcgmModuleIdIntrospect;
-    msg.header.subCommand = DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME;
-    msg.header.version    = dcgm_introspect_msg_fields_exec_time_version;
-
-    memcpy(&msg.context, context, sizeof(msg.context));
-    memcpy(&msg.execTime, execTime, sizeof(msg.execTime));
-    msg.waitIfNoData = waitIfNoData;
-
-    // coverity[overrun-buffer-arg]
-    dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg.header, sizeof(msg));
+    if (execTime->version == dcgmIntrospectFullFieldsExecTime_version2)
+    {
+        return helperIntrospectGetFieldsExecTime<dcgm_introspect_msg_fields_exec_time_v1>(
+            dcgmHandle,
+            dcgm_introspect_msg_fields_exec_time_version1,
+            context,
+            reinterpret_cast<dcgmIntrospectFullFieldsExecTime_v2 *>(execTime),
+            waitIfNoData);
+    }
+    if (execTime->version == dcgmIntrospectFullFieldsExecTime_version3)
+    {
+        return helperIntrospectGetFieldsExecTime<dcgm_introspect_msg_fields_exec_time_v2>(
+            dcgmHandle,
+            dcgm_introspect_msg_fields_exec_time_version2,
+            context,
+            reinterpret_cast<dcgmIntrospectFullFieldsExecTime_v3 *>(execTime),
+            waitIfNoData);
+    }
 
-    memcpy(execTime, &msg.execTime, sizeof(msg.execTime));
-    return dcgmReturn;
+    return helperIntrospectGetFieldsExecTime<dcgm_introspect_msg_fields_exec_time_t>(
+        dcgmHandle, dcgm_introspect_msg_fields_exec_time_version, context, execTime, waitIfNoData);
 }
 
 static dcgmReturn_t tsapiIntrospectGetFieldExecTime(dcgmHandle_t dcgmHandle,
@@ -6449,6 +8562,53 @@ static dcgmReturn_t tsapiIntrospectGetHostengineCpuUtilization(dcgmHandle_t dcgm
     return dcgmReturn;
 }
 
+static dcgmReturn_t tsapiIntrospectGetHostengineThreadCpuUtilization(dcgmHandle_t dcgmHandle,
+                                                                     dcgmIntrospectThreadCpuUtil_t *cpuUtil,
+                                                                     int waitIfNoData)
+{
+    if (!cpuUtil)
+        return DCGM_ST_BADPARAM;
+    if (cpuUtil->version != dcgmIntrospectThreadCpuUtil_version)
+    {
+        PRINT_ERROR("%X %X", "Version mismatch x%X != x%X", cpuUtil->version, dcgmIntrospectThreadCpuUtil_version);
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    /* Too big for the stack */
+    auto msg               = std::make_unique<dcgm_introspect_msg_he_thread_cpu_util_t>();
+    msg->header.length     = sizeof(*msg);
+    msg->header.moduleId   = DcgmModuleIdIntrospect;
+    msg->header.subCommand = DCGM_INTROSPECT_SR_HOSTENGINE_THREAD_CPU_UTIL;
+    msg->header.version    = dcgm_introspect_msg_he_thread_cpu_util_version;
+
+    msg->waitIfNoData = waitIfNoData;
+
+    memcpy(&msg->cpuUtil, cpuUtil, sizeof(*cpuUtil));
+
+    // coverity[overrun-buffer-arg]
+    dcgmReturn_t dcgmReturn = dcgmModuleSendBlockingFixedRequest(dcgmHandle, &msg->header, sizeof(*msg));
+
+    /* Copy the response back over the request */
+    memcpy(cpuUtil, &msg->cpuUtil, sizeof(*cpuUtil));
+    return dcgmReturn;
+}
+
+static dcgmReturn_t tsapiIntrospectGetRequestStats(dcgmHandle_t dcgmHandle, dcgmIntrospectRequestStats_t *requestStats)
+{
+    return helperIntrospectGetRequestStats(dcgmHandle, requestStats);
+}
+
+static dcgmReturn_t tsapiIntrospectGetMemoryAccounting(dcgmHandle_t dcgmHandle,
+                                                       dcgmIntrospectMemoryAccounting_t *accounting)
+{
+    return helperIntrospectGetMemoryAccounting(dcgmHandle, accounting);
+}
+
+static dcgmReturn_t tsapiIntrospectEstimateWatchCost(dcgmHandle_t dcgmHandle, dcgmIntrospectWatchCost_t *cost)
+{
+    return helperIntrospectEstimateWatchCost(dcgmHandle, cost);
+}
+
 static dcgmReturn_t tsapiSelectGpusByTopology(dcgmHandle_t pDcgmHandle,
                                               uint64_t inputGpuIds,
                                               uint32_t numGpus,
@@ -6799,8 +8959,12 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmStartEmbedded_v2(dcgmStartEmbeddedV2Params_v1 *
     const std::string logSeverity = DcgmLogging::getLogSeverityFromArgAndEnv(
         loggingSeverityArg, DCGM_LOGGING_DEFAULT_HOSTENGINE_SEVERITY, DCGM_ENV_LOG_PREFIX);
 
+    // __DCGM_DBG_ASYNC=drop|block moves the log file I/O off the cache manager, IPC and module threads
+    const std::string logAsyncPolicy = DcgmLogging::getLogAsyncPolicyFromArgAndEnv("", "", DCGM_ENV_LOG_PREFIX);
+
     DcgmLogging::init(logFile.c_str(),
-                      DcgmLogging::severityFromString(logSeverity.c_str(), DcgmLoggingSeverityWarning));
+                      DcgmLogging::severityFromString(logSeverity.c_str(), DcgmLoggingSeverityWarning),
+                      logAsyncPolicy);
     DcgmLogging &logging = DcgmLogging::getInstance();
     logging.appendLogToBaseLogger<SYSLOG_LOGGER>();
     DCGM_LOG_DEBUG << "Initialized base logger";
@@ -6896,6 +9060,9 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmStopEmbedded(dcgmHandle_t pDcgmHandle)
 
     dcgmGlobalsUnlock();
 
+    /* Make sure the shutdown records are in the log file if it is written asynchronously */
+    DcgmLogging::flush();
+
     return DCGM_ST_OK;
 }
 
@@ -6989,7 +9156,7 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmConnect_v2(const char *ipAddress,
                                             dcgmHandle_t *pDcgmHandle)
 {
     dcgmReturn_t dcgmReturn;
-    dcgmConnectV2Params_v2 paramsCopy;
+    dcgmConnectV2Params_v4 paramsCopy;
 
     if (!ipAddress || !ipAddress[0] || !pDcgmHandle || !connectParams)
         return DCGM_ST_BADPARAM;
@@ -7009,6 +9176,29 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmConnect_v2(const char *ipAddress,
         /* Other fields default to 0 from the memset above */
         connectParams = &paramsCopy;
     }
+    else if (connectParams->version == dcgmConnectV2Params_version2)
+    {
+        dcgmConnectV2Params_v2 *paramsV2 = (dcgmConnectV2Params_v2 *)connectParams;
+
+        memset(&paramsCopy, 0, sizeof(paramsCopy));
+        paramsCopy.version                = dcgmConnectV2Params_version;
+        paramsCopy.persistAfterDisconnect = paramsV2->persistAfterDisconnect;
+        paramsCopy.timeoutMs              = paramsV2->timeoutMs;
+        paramsCopy.addressIsUnixSocket    = paramsV2->addressIsUnixSocket;
+        connectParams                     = &paramsCopy;
+    }
+    else if (connectParams->version == dcgmConnectV2Params_version3)
+    {
+        dcgmConnectV2Params_v3 *paramsV3 = (dcgmConnectV2Params_v3 *)connectParams;
+
+        memset(&paramsCopy, 0, sizeof(paramsCopy));
+        paramsCopy.version                = dcgmConnectV2Params_version;
+        paramsCopy.persistAfterDisconnect = paramsV3->persistAfterDisconnect;
+        paramsCopy.timeoutMs              = paramsV3->timeoutMs;
+        paramsCopy.addressIsUnixSocket    = paramsV3->addressIsUnixSocket;
+        paramsCopy.useSharedMemory        = paramsV3->useSharedMemory;
+        connectParams                     = &paramsCopy;
+    }
     else if (connectParams->version != dcgmConnectV2Params_version)
     {
         PRINT_ERROR(
@@ -7025,7 +9215,13 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmConnect_v2(const char *ipAddress,
 
     /* Add connection to the client handler */
     dcgmReturn_t status = clientHandler->GetConnHandleForHostEngine(
-        ipAddress, pDcgmHandle, connectParams->timeoutMs, connectParams->addressIsUnixSocket ? true : false);
+        ipAddress,
+        pDcgmHandle,
+        connectParams->timeoutMs,
+        connectParams->addressIsUnixSocket ? true : false,
+        connectParams->addressIsUnixSocket && connectParams->useSharedMemory ? true : false,
+        connectParams->addressIsUnixSocket ? DCGM_TRANSPORT_COMPRESSION_NONE : connectParams->compression,
+        connectParams->compressionThreshold);
     dcgmapiReleaseClientHandler();
     if (DCGM_ST_OK != status)
     {
@@ -7050,6 +9246,59 @@ dcgmReturn_t DCGM_PUBLIC_API dcgmConnect_v2(const char *ipAddress,
     return dcgmReturn;
 }
 
+/*****************************************************************************/
+dcgmReturn_t DCGM_PUBLIC_API dcgmConnectShared(dcgmHandle_t pDcgmHandle,
+                                               unsigned int persistAfterDisconnect,
+                                               dcgmHandle_t *pSharedHandle)
+{
+    if (!pSharedHandle)
+        return DCGM_ST_BADPARAM;
+    if (!g_dcgmGlobals.isInitialized)
+    {
+        PRINT_ERROR("", "dcgmConnectShared before dcgmInit()");
+        return DCGM_ST_UNINITIALIZED;
+    }
+    if (pDcgmHandle == (dcgmHandle_t)DCGM_EMBEDDED_HANDLE)
+        return DCGM_ST_NOT_SUPPORTED; /* Nothing goes over a socket */
+
+    DcgmClientHandler *clientHandler = dcgmapiAcquireClientHandler(false);
+    if (!clientHandler)
+    {
+        PRINT_ERROR("", "dcgmConnectShared called while client handler was not allocated.");
+        return DCGM_ST_CONNECTION_NOT_VALID;
+    }
+
+    dcgmReturn_t dcgmReturn = clientHandler->GetSharedConnHandle(pDcgmHandle, pSharedHandle);
+    dcgmapiReleaseClientHandler();
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        PRINT_ERROR("%p %d", "GetSharedConnHandle of dcgmHandle %p returned %d", (void *)pDcgmHandle, (int)dcgmReturn);
+        return dcgmReturn;
+    }
+
+    /* The host engine sees a new connection, which has to log in like any other */
+    dcgmConnectV2Params_t connectParams {};
+    connectParams.version                = dcgmConnectV2Params_version;
+    connectParams.persistAfterDisconnect = persistAfterDisconnect;
+
+    dcgmReturn = sendClientLogin(*pSharedHandle, &connectParams);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        PRINT_ERROR("%d %p",
+                    "Got error %d from sendClientLogin on shared connection %p. Abandoning it.",
+                    (int)dcgmReturn,
+                    (void *)*pSharedHandle);
+        dcgmDisconnect(*pSharedHandle);
+        return dcgmReturn;
+    }
+
+    PRINT_DEBUG("%p %p",
+                "dcgmHandle %p shares the connection of dcgmHandle %p",
+                (void *)*pSharedHandle,
+                (void *)pDcgmHandle);
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************/
 dcgmReturn_t DCGM_PUBLIC_API dcgmDisconnect(dcgmHandle_t pDcgmHandle)
 {
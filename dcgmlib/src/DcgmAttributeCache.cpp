@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmAttributeCache.h"
+#include "DcgmLogging.h"
+#include "dcgm_structs.h"
+
+/*****************************************************************************/
+unsigned long long DcgmAttributeCache::GetGeneration()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_generation;
+}
+
+/*****************************************************************************/
+void DcgmAttributeCache::SetGeneration(unsigned long long generation)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (generation <= m_generation)
+        return;
+
+    DCGM_LOG_DEBUG << "Attribute generation " << m_generation << " -> " << generation << ". Dropping "
+                   << m_entries.size() << " cached responses";
+
+    m_generation = generation;
+    m_entries.clear();
+}
+
+/*****************************************************************************/
+bool DcgmAttributeCache::Lookup(Key const &key, std::vector<char> &value)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return false;
+
+    value = it->second;
+    return true;
+}
+
+/*****************************************************************************/
+void DcgmAttributeCache::Store(Key const &key, unsigned long long generation, void const *value, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (generation != m_generation)
+    {
+        DCGM_LOG_DEBUG << "Not caching a response of generation " << generation << " in generation " << m_generation;
+        return;
+    }
+
+    m_entries[key].assign((char const *)value, (char const *)value + size);
+}
+
+/*****************************************************************************/
+size_t DcgmAttributeCache::GetSize()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+/*****************************************************************************/
+DcgmAttributeCacheRequest::DcgmAttributeCacheRequest(std::shared_ptr<DcgmAttributeCache> cache)
+    : DcgmRequest(0)
+    , m_isAckRecvd(false)
+    , m_cache(std::move(cache))
+{}
+
+/*****************************************************************************/
+int DcgmAttributeCacheRequest::ProcessMessage(std::unique_ptr<DcgmMessage> msg)
+{
+    if (!msg)
+        return DCGM_ST_BADPARAM;
+
+    dcgm_message_header_t *header = msg->GetMessageHdr();
+    if (header->msgType != DCGM_MSG_ATTRIBUTE_GENERATION)
+    {
+        /* The host engine confirming the subscription */
+        Lock();
+        if (!m_isAckRecvd)
+        {
+            m_status     = DCGM_ST_OK;
+            m_isAckRecvd = true;
+            m_messages.push_back(std::move(msg));
+            m_condition.notify_all(); /* The waiting thread will wake up and read the messages */
+        }
+        else
+        {
+            DCGM_LOG_ERROR << "Ignoring unexpected duplicate ACK";
+        }
+        Unlock();
+        return DCGM_ST_OK;
+    }
+
+    auto msgBytes = msg->GetMsgBytesPtr();
+    if (msgBytes->size() != sizeof(dcgm_msg_attribute_generation_t))
+    {
+        DCGM_LOG_ERROR << "Got a DCGM_MSG_ATTRIBUTE_GENERATION of bad size " << msgBytes->size();
+        return DCGM_ST_OK;
+    }
+
+    auto generationMsg = (dcgm_msg_attribute_generation_t *)msgBytes->data();
+    if (generationMsg->version != dcgm_msg_attribute_generation_version)
+    {
+        DCGM_LOG_ERROR << "Got a DCGM_MSG_ATTRIBUTE_GENERATION of bad version " << generationMsg->version;
+        return DCGM_ST_OK;
+    }
+
+    m_cache->SetGeneration(generationMsg->generation);
+    return DCGM_ST_OK;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMATTRIBUTECACHE_H
+#define DCGMATTRIBUTECACHE_H
+
+#include "DcgmRequest.h"
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/* Kinds of responses the client keeps in a DcgmAttributeCache */
+typedef enum
+{
+    DcgmAttributeCacheKindDeviceAttributes = 1, /* dcgmGetDeviceAttributes. a = gpuId, b = struct version */
+    DcgmAttributeCacheKindAllDevices,           /* dcgmGetAllDevices / dcgmGetAllSupportedDevices. a = onlySupported */
+    DcgmAttributeCacheKindEntityGroupEntities,  /* dcgmGetEntityGroupEntities. a = entityGroupId, b = flags */
+    DcgmAttributeCacheKindFieldGroupInfo,       /* dcgmFieldGroupGetInfo. a = fieldGroupId, b = struct version */
+    DcgmAttributeCacheKindFieldGroupAll,        /* dcgmFieldGroupGetAll. b = struct version */
+} DcgmAttributeCacheKind_t;
+
+/*
+ * Client-side cache of responses that only change when the host engine's
+ * attribute generation does: GPUs being attached, MIG reconfiguration and
+ * field groups being created or destroyed. See dcgmClientCacheEnable.
+ *
+ * The host engine pushes each new generation to subscribed clients with
+ * DCGM_MSG_ATTRIBUTE_GENERATION. Moving to a newer generation drops every entry.
+ */
+class DcgmAttributeCache
+{
+public:
+    using Key = std::tuple<DcgmAttributeCacheKind_t, unsigned long long, unsigned long long>;
+
+    /* The generation responses are cached under. Read it before sending the request */
+    unsigned long long GetGeneration();
+
+    /*
+     * Move to generation. Older generations are ignored since pushes can race
+     * the response that subscribed
+     */
+    void SetGeneration(unsigned long long generation);
+
+    /* Copy the cached response of key into value. Returns whether there was one */
+    bool Lookup(Key const &key, std::vector<char> &value);
+
+    /*
+     * Cache value as the response of key. Ignored if the cache moved past generation
+     * while the request was in flight
+     */
+    void Store(Key const &key, unsigned long long generation, void const *value, size_t size);
+
+    /* Number of cached responses. For tests and logging */
+    size_t GetSize();
+
+    /* Convenience wrappers for responses that are a single struct */
+    template <typename T>
+    bool LookupStruct(Key const &key, T &value)
+    {
+        std::vector<char> bytes;
+        if (!Lookup(key, bytes) || bytes.size() != sizeof(T))
+            return false;
+        memcpy(&value, bytes.data(), sizeof(T));
+        return true;
+    }
+
+    template <typename T>
+    void StoreStruct(Key const &key, unsigned long long generation, T const &value)
+    {
+        Store(key, generation, &value, sizeof(T));
+    }
+
+private:
+    std::mutex m_mutex; /* Protects everything below */
+    unsigned long long m_generation = 0;
+    std::map<Key, std::vector<char>> m_entries;
+};
+
+/*
+ * Persistent request of a client that subscribed to attribute generation
+ * changes. Moves its cache to each generation the host engine pushes.
+ */
+class DcgmAttributeCacheRequest : public DcgmRequest
+{
+public:
+    explicit DcgmAttributeCacheRequest(std::shared_ptr<DcgmAttributeCache> cache);
+    ~DcgmAttributeCacheRequest() override = default;
+    int ProcessMessage(std::unique_ptr<DcgmMessage> msg) override;
+
+private:
+    bool m_isAckRecvd;
+    std::shared_ptr<DcgmAttributeCache> m_cache;
+};
+
+#endif /* DCGMATTRIBUTECACHE_H */
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmCacheArena.h"
+#include "DcgmLogging.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+size_t RoundUp(size_t size, size_t multiple)
+{
+    return (size + multiple - 1) / multiple * multiple;
+}
+} // namespace
+
+/*****************************************************************************/
+DcgmCacheArena::DcgmCacheArena(bool useHugetlb)
+    : m_useHugetlb(useHugetlb)
+    , m_cursor(nullptr)
+    , m_chunkEnd(nullptr)
+    , m_stats {}
+    , m_timeseriesAllocator { TimeseriesAlloc, TimeseriesRelease, this }
+{}
+
+/*****************************************************************************/
+DcgmCacheArena::~DcgmCacheArena()
+{
+    if (m_stats.numLargeMapped > 0)
+    {
+        DCGM_LOG_ERROR << "Destroying a cache arena with " << m_stats.numLargeMapped
+                       << " large allocations that weren't released";
+    }
+
+    for (auto const &[chunk, hugetlb] : m_chunks)
+    {
+        munmap(chunk, DCGM_CM_ARENA_CHUNK_BYTES);
+    }
+}
+
+/*****************************************************************************/
+unsigned int DcgmCacheArena::GetSizeClass(size_t size, size_t &classSize)
+{
+    if (size <= 64)
+    {
+        classSize = 64;
+        return 0;
+    }
+
+    /* Four classes between each power of 2: 80, 96, 112, 128, 160, ... */
+    unsigned int log2 = 63 - __builtin_clzll((unsigned long long)(size - 1));
+    size_t step       = (size_t)1 << (log2 - 2);
+    size_t steps      = (size + step - 1) / step;
+
+    classSize = steps * step;
+    return 1 + (log2 - 6) * 4 + (unsigned int)(steps - 5);
+}
+
+/*****************************************************************************/
+void *DcgmCacheArena::MapChunk(size_t size, bool allowHugetlb, bool &hugetlb)
+{
+    hugetlb = false;
+
+    if (allowHugetlb && m_useHugetlb)
+    {
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED)
+        {
+            hugetlb = true;
+            return ptr;
+        }
+
+        DCGM_LOG_WARNING << "Unable to map a cache arena chunk from the hugetlbfs pool: " << strerror(errno)
+                         << ". Using transparent huge pages from now on";
+        m_useHugetlb = false;
+    }
+
+    /* Map a chunk more than needed so that the mapping can be aligned for THP to back it with huge pages */
+    size_t mapSize = size + DCGM_CM_ARENA_CHUNK_BYTES;
+    char *mapped   = (char *)mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == (char *)MAP_FAILED)
+    {
+        DCGM_LOG_ERROR << "Unable to map " << size << " bytes for a cache arena: " << strerror(errno);
+        return nullptr;
+    }
+
+    uintptr_t const alignMask = (uintptr_t)DCGM_CM_ARENA_CHUNK_BYTES - 1;
+    char *aligned             = (char *)(((uintptr_t)mapped + alignMask) & ~alignMask);
+    size_t head               = aligned - mapped;
+    size_t tail               = mapSize - head - size;
+    if (head > 0)
+    {
+        munmap(mapped, head);
+    }
+    if (tail > 0)
+    {
+        munmap(aligned + size, tail);
+    }
+
+    /* Fails if THP is disabled, in which case the chunk is still contiguous memory */
+    madvise(aligned, size, MADV_HUGEPAGE);
+    return aligned;
+}
+
+/*****************************************************************************/
+void *DcgmCacheArena::AllocateLarge(size_t size)
+{
+    size_t mapSize = RoundUp(size, DCGM_CM_ARENA_CHUNK_BYTES);
+    bool hugetlb   = false;
+    void *ptr      = nullptr;
+
+    if (mapSize == size || mapSize - size < (size_t)DCGM_CM_ARENA_MAX_SMALL_BYTES)
+    {
+        /* Close enough to a multiple of huge pages to be worth backing with them. The hugetlbfs pool is kept
+           for chunks */
+        ptr = MapChunk(mapSize, false, hugetlb);
+    }
+    else
+    {
+        mapSize = RoundUp(size, sysconf(_SC_PAGESIZE));
+        ptr     = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+        {
+            DCGM_LOG_ERROR << "Unable to map " << size << " bytes for a cache arena: " << strerror(errno);
+            ptr = nullptr;
+        }
+    }
+
+    if (ptr == nullptr)
+    {
+        return nullptr;
+    }
+
+    m_stats.bytesMapped += mapSize;
+    m_stats.maxBytesMapped = std::max(m_stats.maxBytesMapped, m_stats.bytesMapped);
+    m_stats.bytesAllocated += mapSize;
+    m_stats.numAllocations++;
+    m_stats.numLargeMapped++;
+    return ptr;
+}
+
+/*****************************************************************************/
+void DcgmCacheArena::ReleaseLarge(void *ptr, size_t size)
+{
+    size_t mapSize = RoundUp(size, DCGM_CM_ARENA_CHUNK_BYTES);
+    if (mapSize != size && mapSize - size >= (size_t)DCGM_CM_ARENA_MAX_SMALL_BYTES)
+    {
+        mapSize = RoundUp(size, sysconf(_SC_PAGESIZE));
+    }
+
+    munmap(ptr, mapSize);
+
+    m_stats.bytesMapped -= mapSize;
+    m_stats.bytesAllocated -= mapSize;
+    m_stats.numAllocations--;
+    m_stats.numLargeMapped--;
+}
+
+/*****************************************************************************/
+void *DcgmCacheArena::Allocate(size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (size > DCGM_CM_ARENA_MAX_SMALL_BYTES)
+    {
+        return AllocateLarge(size);
+    }
+
+    size_t classSize;
+    unsigned int sizeClass = GetSizeClass(size, classSize);
+    if (sizeClass >= m_freeLists.size())
+    {
+        m_freeLists.resize(sizeClass + 1, nullptr);
+    }
+
+    void *ptr = m_freeLists[sizeClass];
+    if (ptr != nullptr)
+    {
+        memcpy(&m_freeLists[sizeClass], ptr, sizeof(void *));
+    }
+    else
+    {
+        if ((size_t)(m_chunkEnd - m_cursor) < classSize)
+        {
+            /* The rest of the current chunk is left unused. It's less than the largest small class */
+            bool hugetlb = false;
+            char *chunk  = (char *)MapChunk(DCGM_CM_ARENA_CHUNK_BYTES, true, hugetlb);
+            if (chunk == nullptr)
+            {
+                return nullptr;
+            }
+
+            m_chunks.emplace_back(chunk, hugetlb);
+            m_cursor   = chunk;
+            m_chunkEnd = chunk + DCGM_CM_ARENA_CHUNK_BYTES;
+
+            m_stats.numChunks++;
+            m_stats.bytesMapped += DCGM_CM_ARENA_CHUNK_BYTES;
+            m_stats.maxBytesMapped = std::max(m_stats.maxBytesMapped, m_stats.bytesMapped);
+            if (hugetlb)
+            {
+                m_stats.hugetlbBytes += DCGM_CM_ARENA_CHUNK_BYTES;
+            }
+        }
+
+        ptr = m_cursor;
+        m_cursor += classSize;
+    }
+
+    m_stats.bytesAllocated += classSize;
+    m_stats.numAllocations++;
+    return ptr;
+}
+
+/*****************************************************************************/
+void DcgmCacheArena::Release(void *ptr, size_t size)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (size > DCGM_CM_ARENA_MAX_SMALL_BYTES)
+    {
+        ReleaseLarge(ptr, size);
+        return;
+    }
+
+    size_t classSize;
+    unsigned int sizeClass = GetSizeClass(size, classSize);
+    if (sizeClass >= m_freeLists.size())
+    {
+        m_freeLists.resize(sizeClass + 1, nullptr);
+    }
+
+    memcpy(ptr, &m_freeLists[sizeClass], sizeof(void *));
+    m_freeLists[sizeClass] = ptr;
+
+    m_stats.bytesAllocated -= classSize;
+    m_stats.numAllocations--;
+}
+
+/*****************************************************************************/
+void DcgmCacheArena::AddStats(dcgmcm_arena_stats_t &stats) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    stats.bytesMapped += m_stats.bytesMapped;
+    /* Arenas didn't necessarily peak at the same time, so this is an upper bound */
+    stats.maxBytesMapped += m_stats.maxBytesMapped;
+    stats.hugetlbBytes += m_stats.hugetlbBytes;
+    stats.bytesAllocated += m_stats.bytesAllocated;
+    stats.numAllocations += m_stats.numAllocations;
+    stats.numChunks += m_stats.numChunks;
+    stats.numLargeMapped += m_stats.numLargeMapped;
+}
+
+/*****************************************************************************/
+void *DcgmCacheArena::TimeseriesAlloc(void *userData, size_t size)
+{
+    return static_cast<DcgmCacheArena *>(userData)->Allocate(size);
+}
+
+/*****************************************************************************/
+void DcgmCacheArena::TimeseriesRelease(void *userData, void *ptr, size_t size)
+{
+    static_cast<DcgmCacheArena *>(userData)->Release(ptr, size);
+}
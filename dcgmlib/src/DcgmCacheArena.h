@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "timeseries.h"
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+/* Size of the huge pages arenas are backed by, and of the chunks they map at a time */
+#define DCGM_CM_ARENA_CHUNK_BYTES (2 * 1024 * 1024)
+
+/* Allocations larger than this get a mapping of their own rather than being carved from a chunk */
+#define DCGM_CM_ARENA_MAX_SMALL_BYTES (DCGM_CM_ARENA_CHUNK_BYTES / 4)
+
+/*****************************************************************************/
+/* Usage of one or more arenas */
+typedef struct
+{
+    long long bytesMapped;     /* Bytes of chunks and large allocations mapped right now */
+    long long maxBytesMapped;  /* Most bytes mapped at once */
+    long long hugetlbBytes;    /* Of bytesMapped, how many are backed by hugetlbfs pages rather than THP */
+    long long bytesAllocated;  /* Bytes handed out and not released yet, rounded up to their size class */
+    long long numAllocations;  /* Allocations handed out and not released yet */
+    long long numChunks;       /* Chunks mapped */
+    long long numLargeMapped;  /* Large allocations mapped */
+} dcgmcm_arena_stats_t;
+
+/*****************************************************************************/
+/*
+ * Memory for cache manager data structures carved from huge page backed chunks,
+ * so that the watches of one GPU and their samples sit in a few huge pages
+ * rather than in small allocations spread over the heap. This cuts the dTLB
+ * misses of the update sweep and of history reads.
+ *
+ * Chunks are DCGM_CM_ARENA_CHUNK_BYTES, aligned to that size so that THP can
+ * back each with one huge page. With useHugetlb, chunks are first mapped from
+ * the hugetlbfs pool with MAP_HUGETLB. Once the pool runs dry, chunks fall back
+ * to THP.
+ *
+ * Allocations are rounded up to size classes with four classes per power of 2
+ * and carved from the current chunk. Released allocations go on a free list of
+ * their class for the next allocation of that class. Chunks are only unmapped
+ * when the arena is destroyed, since cache memory mostly stays at the level the
+ * watches need. Allocations over DCGM_CM_ARENA_MAX_SMALL_BYTES are mapped and
+ * unmapped on their own.
+ *
+ * This class is thread safe.
+ */
+class DcgmCacheArena
+{
+public:
+    explicit DcgmCacheArena(bool useHugetlb = false);
+
+    /* Unmaps all of the memory of the arena. Everything allocated from it must be released first */
+    ~DcgmCacheArena();
+
+    DcgmCacheArena(DcgmCacheArena const &) = delete;
+    DcgmCacheArena &operator=(DcgmCacheArena const &) = delete;
+
+    /*************************************************************************/
+    /*
+     * Allocate size bytes aligned to 16 bytes
+     *
+     * Returns nullptr if out of memory
+     */
+    void *Allocate(size_t size);
+
+    /*************************************************************************/
+    /*
+     * Release an allocation. size must be what it was allocated with
+     */
+    void Release(void *ptr, size_t size);
+
+    /*************************************************************************/
+    /*
+     * Construct a T in the arena. Returns nullptr if out of memory
+     */
+    template <typename T, typename... Args>
+    T *New(Args &&...args)
+    {
+        void *ptr = Allocate(sizeof(T));
+        if (ptr == nullptr)
+        {
+            return nullptr;
+        }
+        return new (ptr) T(std::forward<Args>(args)...);
+    }
+
+    /*************************************************************************/
+    /*
+     * Destroy a T from New()
+     */
+    template <typename T>
+    void Delete(T *object)
+    {
+        if (object == nullptr)
+        {
+            return;
+        }
+        object->~T();
+        Release(object, sizeof(T));
+    }
+
+    /*************************************************************************/
+    /*
+     * Get an allocator for timeseries_set_allocator() that allocates from this arena
+     */
+    timeseries_allocator_p GetTimeseriesAllocator()
+    {
+        return &m_timeseriesAllocator;
+    }
+
+    /*************************************************************************/
+    /*
+     * Add the usage of this arena to stats
+     */
+    void AddStats(dcgmcm_arena_stats_t &stats) const;
+
+    /*************************************************************************/
+    /*
+     * Get the size class of an allocation of size bytes. Exposed for testing
+     *
+     * Returns the index of the class and sets classSize to the bytes it hands out
+     */
+    static unsigned int GetSizeClass(size_t size, size_t &classSize);
+
+private:
+    void *MapChunk(size_t size, bool allowHugetlb, bool &hugetlb);
+    void *AllocateLarge(size_t size);
+    void ReleaseLarge(void *ptr, size_t size);
+
+    static void *TimeseriesAlloc(void *userData, size_t size);
+    static void TimeseriesRelease(void *userData, void *ptr, size_t size);
+
+    mutable std::mutex m_mutex;
+    bool m_useHugetlb; /* Whether to try hugetlbfs for the next chunk. Cleared once the pool runs dry */
+
+    std::vector<std::pair<char *, bool>> m_chunks; /* Each chunk and whether it is hugetlbfs backed */
+    char *m_cursor;                                /* Next free byte of the newest chunk */
+    char *m_chunkEnd;                              /* End of the newest chunk */
+    std::vector<void *> m_freeLists;               /* Released allocations of each size class. Each
+                                                      links to the next one through its first bytes */
+
+    dcgmcm_arena_stats_t m_stats;
+    timeseries_allocator_t m_timeseriesAllocator;
+};
@@ -14,25 +14,39 @@
  * limitations under the License.
  */
 #include "DcgmCacheManager.h"
+#include "DcgmBinaryLog.h"
+#include "DcgmCpuPlacement.h"
+#include "DcgmCacheSnapshot.h"
+#include "DcgmGpuFieldFetchers.h"
 #include "DcgmGpuInstance.h"
 #include "DcgmHostEngineHandler.h"
 #include "DcgmMutex.h"
-#include "MurmurHash3.h"
+#include "DcgmTrace.h"
+#include "nvcmvalue.h"
 #include <DcgmException.hpp>
 #include <DcgmStringHelpers.h>
+#include <ThreadPool.hpp>
 #include <dcgm_agent.h>
 #include <dcgm_nvswitch_structs.h>
 
 #include <algorithm>
+#include <climits>
 #include <cmath>
+#include <cstddef>
+#include <cstdlib>
 #include <cstring>
 #include <list>
 #include <map>
+#include <new>
 #include <numeric>
+#include <pthread.h>
 #include <set>
 #include <stdexcept>
 #include <string>
 #include <sys/types.h>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <unistd.h>
 
 
@@ -93,75 +107,12 @@ constexpr dcgmReturn_t NvmlReturnToDcgmReturn(nvmlReturn_t nvmlReturn)
 //#define DEBUG_UPDATE_LOOP 1
 
 /*****************************************************************************/
-/* Keyed vector definition for pids that we've seen */
-typedef struct dcgmcm_pid_seen_t
+/* Key of m_latestAccountingStats */
+static unsigned long long DcgmcmAccountingKey(unsigned int gpuId, unsigned int pid)
 {
-    unsigned int pid;
-    timelib64_t timestamp;
-} dcgmcm_pid_seen_t, *dcgmcm_pid_seen_p;
-
-static int dcgmcm_pidSeenCmpCB(void *L, void *R)
-{
-    dcgmcm_pid_seen_p l = (dcgmcm_pid_seen_p)L;
-    dcgmcm_pid_seen_p r = (dcgmcm_pid_seen_p)R;
-
-    if (l->pid < r->pid)
-        return -1;
-    else if (l->pid > r->pid)
-        return 1;
-
-    if (l->timestamp < r->timestamp)
-        return -1;
-    else if (l->timestamp > r->timestamp)
-        return 1;
-
-    return 0;
-}
-
-static int dcgmcm_pidSeenMergeCB(void *current, void *inserting, void *user)
-{
-    PRINT_ERROR("", "Unexpected dcgmcm_pidSeenMergeCB");
-    return KV_ST_DUPLICATE;
-}
-
-/*****************************************************************************/
-/* Hash callbacks for m_entityWatchHashTable */
-static unsigned int entityKeyHashCB(const void *key)
-{
-    unsigned int retVal = 0;
-
-    /* We're passing address to key because the pointer passed in is the actual value */
-    MurmurHash3_x86_32(&key, sizeof(key), 0, &retVal);
-    return retVal;
-}
-
-/* Comparison callbacks for m_entityWatchHashTable */
-static int entityKeyCmpCB(const void *key1, const void *key2)
-{
-    if (key1 == key2)
-        return 1; /* Yes. The caller expects 1 for == */
-    else
-        return 0;
+    return ((unsigned long long)gpuId << 32) | pid;
 }
 
-static void entityValueFreeCB(void *WatchInfo)
-{
-    dcgmcm_watch_info_p watchInfo = (dcgmcm_watch_info_p)WatchInfo;
-
-    if (!watchInfo)
-    {
-        PRINT_ERROR("", "FreeWatchInfo got NULL watchInfo");
-        return;
-    }
-
-    if (watchInfo->timeSeries)
-    {
-        timeseries_destroy(watchInfo->timeSeries);
-        watchInfo->timeSeries = 0;
-    }
-
-    delete (watchInfo);
-}
 
 static dcgmReturn_t helperNvSwitchAddFieldWatch(dcgm_field_entity_group_t entityGroupId,
                                                 unsigned int entityId,
@@ -241,6 +192,26 @@ void DcgmCacheManager::ClearGpuMigInfo(dcgmcm_gpu_info_t &gpuInfo)
     m_numInstances -= gpuInfo.instances.size();
     m_numComputeInstances -= ciCount;
     gpuInfo.instances.clear();
+    m_migManager.ClearGpu(gpuInfo.gpuId);
+}
+
+/*****************************************************************************/
+DcgmGpuInstance *DcgmCacheManager::FindGpuInstance(unsigned int gpuId, DcgmNs::Mig::GpuInstanceId const &instanceId)
+{
+    if (gpuId >= m_numGpus)
+    {
+        return nullptr;
+    }
+
+    for (auto &instance : m_gpus[gpuId].instances)
+    {
+        if (instance.GetInstanceId() == instanceId)
+        {
+            return &instance;
+        }
+    }
+
+    return nullptr;
 }
 
 namespace
@@ -684,6 +655,23 @@ dcgmReturn_t DcgmCacheManager::InitializeGpuInstances(dcgmcm_gpu_info_t &gpuInfo
                        << ", PendingMode: " << pendingMode;
     }
 
+    /* Remember the entity IDs of the instances we already know about so that a reconfiguration
+       keeps the IDs, and with them the watches, of the instances that still exist */
+    std::unordered_map<unsigned int, DcgmNs::Mig::GpuInstanceId> knownInstanceIds;
+    std::map<std::pair<unsigned int, unsigned int>, DcgmNs::Mig::ComputeInstanceId> knownComputeInstanceIds;
+    for (auto const &instance : gpuInfo.instances)
+    {
+        knownInstanceIds[instance.GetNvmlInstanceId().id] = instance.GetInstanceId();
+        for (unsigned int ciIndex = 0; ciIndex < instance.GetComputeInstanceCount(); ciIndex++)
+        {
+            dcgmcm_gpu_compute_instance_t ci {};
+            instance.GetComputeInstance(ciIndex, ci);
+            knownComputeInstanceIds[{ ci.nvmlParentInstanceId.id, ci.nvmlComputeInstanceId.id }]
+                = ci.dcgmComputeInstanceId;
+        }
+    }
+    ClearGpuMigInfo(gpuInfo);
+
     gpuInfo.migEnabled = false;
 
     if (nvmlRet == NVML_SUCCESS)
@@ -740,6 +728,7 @@ dcgmReturn_t DcgmCacheManager::InitializeGpuInstances(dcgmcm_gpu_info_t &gpuInfo
     {
         DCGM_LOG_ERROR << "Could not retrieve the names of the compute instances for GPU " << gpuInfo.gpuId << ": '"
                        << errorString(ret) << "'";
+        ret = DCGM_ST_OK;
     }
 
     try
@@ -750,7 +739,13 @@ dcgmReturn_t DcgmCacheManager::InitializeGpuInstances(dcgmcm_gpu_info_t &gpuInfo
 
             for (auto const &[gpuInstance, gpuInstanceInfo] : GpuInstances(gpuInfo.nvmlDevice, profileInfo))
             {
-                DcgmNs::Mig::GpuInstanceId gpuInstanceId { gpuInfo.gpuId * gpuInfo.maxGpcs + gpuInfo.instances.size() };
+                /* New instances get an ID below, once we know which IDs are still taken */
+                DcgmNs::Mig::GpuInstanceId gpuInstanceId { std::uint64_t { DCGM_MAX_INSTANCES } };
+                auto knownInstance = knownInstanceIds.find(gpuInstanceInfo.id);
+                if (knownInstance != knownInstanceIds.end())
+                {
+                    gpuInstanceId = knownInstance->second;
+                }
 
                 DcgmGpuInstance dgi(gpuInstanceId,
                                     gpuInstanceInfo.id,
@@ -784,8 +779,12 @@ dcgmReturn_t DcgmCacheManager::InitializeGpuInstances(dcgmcm_gpu_info_t &gpuInfo
                         }
                         first = false;
 
-                        ci.dcgmComputeInstanceId
-                            = DcgmNs::Mig::ComputeInstanceId { gpuInfo.gpuId * maxGpcs + gpuInfo.ciCount };
+                        ci.dcgmComputeInstanceId = DcgmNs::Mig::ComputeInstanceId { DCGM_MAX_COMPUTE_INSTANCES };
+                        auto knownCi = knownComputeInstanceIds.find({ gpuInstanceInfo.id, computeInstanceInfo.id });
+                        if (knownCi != knownComputeInstanceIds.end())
+                        {
+                            ci.dcgmComputeInstanceId = knownCi->second;
+                        }
 
                         gpuInfo.ciCount += 1;
 
@@ -816,22 +815,11 @@ dcgmReturn_t DcgmCacheManager::InitializeGpuInstances(dcgmcm_gpu_info_t &gpuInfo
                         }
 
                         dgi.AddComputeInstance(ci);
-                        m_migManager.RecordGpuComputeInstance(gpuInfo.gpuId, gpuInstanceId, ci.dcgmComputeInstanceId);
                         m_numComputeInstances++;
                     }
                 }
 
-                IF_DCGM_LOG_DEBUG
-                {
-                    DCGM_LOG_DEBUG << "[CacheManager][MIG] Adding GpuInstance " << dgi.GetInstanceId()
-                                   << " (nvmlInstanceId: " << dgi.GetNvmlInstanceId() << ") with "
-                                   << dgi.GetComputeInstanceCount()
-                                   << " compute instances for GpuId: " << gpuInfo.gpuId;
-                }
-
                 gpuInfo.instances.push_back(dgi);
-
-                m_migManager.RecordGpuInstance(gpuInfo.gpuId, gpuInstanceId);
                 m_numInstances++;
             }
         }
@@ -839,12 +827,70 @@ dcgmReturn_t DcgmCacheManager::InitializeGpuInstances(dcgmcm_gpu_info_t &gpuInfo
     catch (DcgmNs::DcgmException const &ex)
     {
         DCGM_LOG_ERROR << "[MIG] Unable to initialize gpu instances. Ex: " << ex.what();
-        return ex.GetErrorCode();
+        ret = ex.GetErrorCode();
     }
     catch (std::exception const &ex)
     {
         DCGM_LOG_ERROR << "[MIG] Unable to initialize gpu instances. Ex: " << ex.what();
-        return DCGM_ST_GENERIC_ERROR;
+        ret = DCGM_ST_GENERIC_ERROR;
+    }
+
+    /* Instances that were already known kept their IDs above. Give the new ones the lowest IDs
+       in this GPU's range that aren't taken and record everything with the MIG manager */
+    std::set<std::uint64_t> usedInstanceIds;
+    std::set<std::uint32_t> usedComputeInstanceIds;
+    for (auto const &instance : gpuInfo.instances)
+    {
+        usedInstanceIds.insert(instance.GetInstanceId().id);
+        for (unsigned int ciIndex = 0; ciIndex < instance.GetComputeInstanceCount(); ciIndex++)
+        {
+            dcgmcm_gpu_compute_instance_t ci {};
+            instance.GetComputeInstance(ciIndex, ci);
+            usedComputeInstanceIds.insert(ci.dcgmComputeInstanceId.id);
+        }
+    }
+
+    std::uint64_t nextInstanceId        = gpuInfo.gpuId * gpuInfo.maxGpcs;
+    std::uint32_t nextComputeInstanceId = gpuInfo.gpuId * maxGpcs;
+    for (auto &instance : gpuInfo.instances)
+    {
+        if (instance.GetInstanceId().id == DCGM_MAX_INSTANCES)
+        {
+            while (usedInstanceIds.count(nextInstanceId) != 0)
+            {
+                nextInstanceId++;
+            }
+            instance.SetInstanceId(DcgmNs::Mig::GpuInstanceId { nextInstanceId++ });
+        }
+        m_migManager.RecordGpuInstance(gpuInfo.gpuId, instance.GetInstanceId());
+
+        for (unsigned int ciIndex = 0; ciIndex < instance.GetComputeInstanceCount(); ciIndex++)
+        {
+            dcgmcm_gpu_compute_instance_t ci {};
+            instance.GetComputeInstance(ciIndex, ci);
+            if (ci.dcgmComputeInstanceId.id == DCGM_MAX_COMPUTE_INSTANCES)
+            {
+                while (usedComputeInstanceIds.count(nextComputeInstanceId) != 0)
+                {
+                    nextComputeInstanceId++;
+                }
+                ci.dcgmComputeInstanceId = DcgmNs::Mig::ComputeInstanceId { nextComputeInstanceId++ };
+                instance.SetComputeInstanceId(ciIndex, ci.dcgmComputeInstanceId);
+            }
+            m_migManager.RecordGpuComputeInstance(gpuInfo.gpuId, instance.GetInstanceId(), ci.dcgmComputeInstanceId);
+        }
+
+        IF_DCGM_LOG_DEBUG
+        {
+            DCGM_LOG_DEBUG << "[CacheManager][MIG] Adding GpuInstance " << instance.GetInstanceId()
+                           << " (nvmlInstanceId: " << instance.GetNvmlInstanceId() << ") with "
+                           << instance.GetComputeInstanceCount() << " compute instances for GpuId: " << gpuInfo.gpuId;
+        }
+    }
+
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
     }
 
     gpuInfo.maxGpcs = std::max(maxGpcsInProfiles, gpuInfo.maxGpcs);
@@ -852,12 +898,90 @@ dcgmReturn_t DcgmCacheManager::InitializeGpuInstances(dcgmcm_gpu_info_t &gpuInfo
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+/* Fetches vGPU watches one field at a time with BufferOrCacheLatestVgpuValue(). The
+   values are only buffered. The cache manager caches them after Collect() returns */
+class DcgmCacheManager::VgpuCollector : public DcgmEntityCollector
+{
+public:
+    explicit VgpuCollector(DcgmCacheManager &cacheManager)
+        : m_cacheManager(cacheManager)
+        , m_threadCtx {}
+    {
+        m_cacheManager.InitAndClearThreadCtx(&m_threadCtx);
+        m_threadCtx.fvBuffer = &m_fieldValues;
+    }
+
+    void Collect(std::vector<dcgmcm_entity_key_t> const &keys, DcgmFvBuffer &fvBuffer) override
+    {
+        for (dcgmcm_entity_key_t const &key : keys)
+        {
+            dcgm_field_meta_p fieldMeta = DcgmFieldGetById(key.fieldId);
+            if (!fieldMeta)
+                continue;
+
+            /* Fetch into m_fieldValues so the status of the fetch can be set on what it added */
+            m_fieldValues.Clear();
+            m_threadCtx.entityKey = key;
+            dcgmReturn_t dcgmReturn
+                = m_cacheManager.BufferOrCacheLatestVgpuValue(&m_threadCtx, key.entityId, fieldMeta);
+
+            dcgmBufferedFvCursor_t cursor = 0;
+            for (dcgmBufferedFv_t *fv = m_fieldValues.GetNextFv(&cursor); fv; fv = m_fieldValues.GetNextFv(&cursor))
+            {
+                dcgmBufferedFv_t *copy = fvBuffer.AddFvCopy(fv);
+                if (!copy)
+                    continue;
+                if (dcgmReturn != DCGM_ST_OK)
+                    copy->status = dcgmReturn;
+                else if (key.fieldId == DCGM_FI_DEV_VGPU_DRIVER_VERSION && strcmp("Unknown", copy->value.str))
+                    SlowDriverVersionWatch(key.entityId);
+            }
+        }
+    }
+
+private:
+    /* Poll a vGPU's driver version every 15 minutes once it's known */
+    void SlowDriverVersionWatch(unsigned int vgpuId)
+    {
+        dcgmcm_watch_info_p watchInfo;
+        {
+            DcgmLockGuard dlg(m_cacheManager.m_mutex);
+            watchInfo = m_cacheManager.GetEntityWatchInfo(DCGM_FE_VGPU, vgpuId, DCGM_FI_DEV_VGPU_DRIVER_VERSION, 0);
+            if (!watchInfo || watchInfo->monitorFrequencyUsec == 900000000)
+                return;
+        }
+
+        m_cacheManager.UpdateFieldWatch(watchInfo, 900000000, 900.0, 1, DcgmWatcher(DcgmWatcherTypeCacheManager));
+    }
+
+    DcgmCacheManager &m_cacheManager;
+    dcgmcm_update_thread_t m_threadCtx; /* Has no watchInfo, so values are only buffered in m_fieldValues */
+    DcgmFvBuffer m_fieldValues;         /* Values of the field being fetched */
+};
+
 /*****************************************************************************/
 // NOTE: NVML is initialized by DcgmHostEngineHandler before DcgmCacheManager is instantiated
 DcgmCacheManager::DcgmCacheManager()
     : DcgmThread(false, "cache_mgr_main")
     , m_pollInLockStep(0)
     , m_maxSampleAgeUsec((timelib64_t)3600 * 1000000)
+    , m_compressHistory(getenv(DCGM_ENV_COMPRESS_HISTORY) != nullptr)
+    , m_parallelGpuFetch(getenv(DCGM_ENV_PARALLEL_GPU_FETCH) != nullptr)
+    , m_placeThreadsNearGpus(false)
+    , m_bufferedSampling(getenv(DCGM_ENV_BUFFERED_SAMPLING) != nullptr)
+    , m_watchCoalesceUsec(0)
+    , m_watchTickUsec(0)
+    , m_eventFieldPollUsec(0)
+    , m_adaptiveBaseUsec(0)
+    , m_adaptiveThreshold(DCGM_CM_ADAPTIVE_DEFAULT_THRESHOLD)
+    , m_cacheBudgetBytes(0)
+    , m_cacheBudgetLastCheckUsec(0)
+    , m_cacheBudgetLastWarnUsec(0)
+    , m_cacheArenas(false)
+    , m_cacheArenasUseHugetlb(false)
+    , m_nextSummaryWindowId(1)
+    , m_nextSnapshotGroupId(1)
     , m_driverIsR450OrNewer(false)
     , m_numGpus(0)
     , m_numInstances(0)
@@ -868,33 +992,98 @@ DcgmCacheManager::DcgmCacheManager()
     , m_waitForDriverClearCount(0)
     , m_startUpdateCondition()
     , m_updateCompleteCondition()
+    , m_topologyGeneration(0)
+    , m_haveCpuAffinity(false)
+    , m_cpuAffinity {}
+    , m_haveMigHierarchy(false)
+    , m_migHierarchy {}
     , m_nvmlEventSetInitialized(false)
     , m_nvmlEventSet()
     , m_subscriptions()
     , m_migManager()
     , m_delayedMigReconfigProcessingTimestamp(0)
 {
-    int kvSt = 0;
-
-    m_entityWatchHashTable   = 0;
+    m_watchIndex             = nullptr;
     m_haveAnyLiveSubscribers = false;
+    m_fvBufferPool           = std::make_shared<DcgmFvBufferPool>();
+
+    char const *snapshotFilename = getenv(DCGM_ENV_CACHE_SNAPSHOT);
+    if (snapshotFilename)
+        m_snapshotFilename = snapshotFilename;
+
+    m_rollupRawRetentionUsec = 0;
+    char const *rollupTiers  = getenv(DCGM_ENV_ROLLUP_TIERS);
+    if (rollupTiers
+        && DcgmCacheRollup::ParseTiers(rollupTiers, &m_rollupRawRetentionUsec, &m_rollupTiers) != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Ignoring malformed " << DCGM_ENV_ROLLUP_TIERS << " \"" << rollupTiers << "\"";
+        m_rollupTiers.clear();
+    }
+
+    char const *watchCoalesceUsec = getenv(DCGM_ENV_WATCH_COALESCE_USEC);
+    if (watchCoalesceUsec)
+    {
+        m_watchCoalesceUsec = std::max(0LL, strtoll(watchCoalesceUsec, nullptr, 10));
+    }
+
+    char const *eventFieldPollUsec = getenv(DCGM_ENV_EVENT_FIELD_POLL_USEC);
+    if (eventFieldPollUsec)
+    {
+        m_eventFieldPollUsec = std::max(0LL, strtoll(eventFieldPollUsec, nullptr, 10));
+    }
+
+    char const *adaptiveSamplingUsec = getenv(DCGM_ENV_ADAPTIVE_SAMPLING_USEC);
+    if (adaptiveSamplingUsec)
+    {
+        m_adaptiveBaseUsec = std::max(0LL, strtoll(adaptiveSamplingUsec, nullptr, 10));
+    }
+
+    char const *adaptiveSamplingThreshold = getenv(DCGM_ENV_ADAPTIVE_SAMPLING_THRESHOLD);
+    if (adaptiveSamplingThreshold)
+    {
+        m_adaptiveThreshold = std::max(0.0, strtod(adaptiveSamplingThreshold, nullptr));
+    }
+
+    char const *cacheArenas = getenv(DCGM_ENV_CACHE_ARENAS);
+    if (cacheArenas)
+    {
+        m_cacheArenas           = strcmp(cacheArenas, DCGM_CACHE_ARENAS_NONE) != 0;
+        m_cacheArenasUseHugetlb = strcmp(cacheArenas, DCGM_CACHE_ARENAS_HUGETLB) == 0;
+    }
+
+    char const *cacheBudget = getenv(DCGM_ENV_CACHE_MEMORY_BUDGET);
+    if (cacheBudget)
+    {
+        m_cacheBudgetBytes = std::max(0LL, strtoll(cacheBudget, nullptr, 10));
+    }
+
+    /* Threads are only ever placed within the CPUs the process was given, like those
+       nv-hostengine leaves after --reserved-cpus */
+    m_haveGpuCpuSets       = false;
+    m_gpuCpuSetsGeneration = 0;
+    char const *placement  = getenv(DCGM_ENV_THREAD_PLACEMENT);
+    m_placeThreadsNearGpus = placement && strcmp(placement, DCGM_THREAD_PLACEMENT_GPU) == 0;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(m_allowedCpus), &m_allowedCpus) != 0)
+    {
+        DCGM_LOG_WARNING << "Unable to read the CPU affinity. Threads won't be placed near GPUs";
+        CPU_ZERO(&m_allowedCpus);
+        m_placeThreadsNearGpus = false;
+    }
 
     m_mutex = new DcgmMutex(0);
     // m_mutex->EnableDebugLogging(true);
 
-    memset(&m_runStats, 0, sizeof(m_runStats));
-
-    m_entityWatchHashTable = hashtable_create(entityKeyHashCB, entityKeyCmpCB, 0, entityValueFreeCB);
-    if (!m_entityWatchHashTable)
+    char const *spillDir = getenv(DCGM_ENV_SPILL_DIR);
+    if (spillDir)
     {
-        PRINT_CRITICAL("", "hashtable_create failed");
-        throw std::runtime_error("DcgmCacheManager failed to create its hashtable.");
+        char const *spillBudget = getenv(DCGM_ENV_SPILL_BUDGET);
+        SetSpill(spillDir, spillBudget ? strtoll(spillBudget, nullptr, 10) : 0);
     }
 
-    memset(&m_currentEventMask[0], 0, sizeof(m_currentEventMask));
+    memset(&m_runStats, 0, sizeof(m_runStats));
 
-    m_accountingPidsSeen
-        = keyedvector_alloc(sizeof(dcgmcm_pid_seen_t), 0, dcgmcm_pidSeenCmpCB, dcgmcm_pidSeenMergeCB, 0, 0, &kvSt);
+    memset(&m_currentEventMask[0], 0, sizeof(m_currentEventMask));
+    memset(&m_adaptiveBurstUntilUsec[0], 0, sizeof(m_adaptiveBurstUntilUsec));
 
     for (unsigned short fieldId = 1; fieldId < DCGM_FI_MAX_FIELDS; ++fieldId)
     {
@@ -906,27 +1095,22 @@ DcgmCacheManager::DcgmCacheManager()
     }
 
     m_eventThread = new DcgmCacheManagerEventThread(this);
+
+    m_entityCollectors[DCGM_FE_VGPU] = std::make_shared<VgpuCollector>(*this);
 }
 
 /*****************************************************************************/
 DcgmCacheManager::~DcgmCacheManager()
 {
     Shutdown();
+    FreeGpuFetchWorkers();
+    FreeEntityCollectorWorkers();
+    m_liveFetchPool.reset();
 
     delete m_mutex;
     m_mutex = nullptr;
 
-    if (m_entityWatchHashTable)
-    {
-        hashtable_destroy(m_entityWatchHashTable);
-        m_entityWatchHashTable = 0;
-    }
-
-    if (m_accountingPidsSeen)
-    {
-        keyedvector_destroy(m_accountingPidsSeen);
-        m_accountingPidsSeen = 0;
-    }
+    FreeAllWatchInfos();
 
     UninitializeNvmlEventSet();
 }
@@ -1048,6 +1232,9 @@ dcgmReturn_t DcgmCacheManager::UpdateNvLinkLinkState(unsigned int gpuId)
     DCGM_LOG_DEBUG << "gpuId " << gpuId << " has migIsEnabledForGpu = " << migIsEnabledForGpu
                    << " migIsEnabledForAnyGpu " << migIsEnabledForAnyGpu;
 
+    dcgmNvLinkLinkState_t previousLinkState[DCGM_NVLINK_MAX_LINKS_PER_GPU];
+    memcpy(previousLinkState, gpu->nvLinkLinkState, sizeof(previousLinkState));
+
     for (linkId = 0; linkId < DCGM_NVLINK_MAX_LINKS_PER_GPU; linkId++)
     {
         /* If we know MIG is enabled, we can save a driver call to NVML */
@@ -1098,6 +1285,9 @@ dcgmReturn_t DcgmCacheManager::UpdateNvLinkLinkState(unsigned int gpuId)
         }
     }
 
+    if (memcmp(previousLinkState, gpu->nvLinkLinkState, sizeof(previousLinkState)))
+        InvalidateTopology();
+
     return DCGM_ST_OK;
 }
 
@@ -1286,6 +1476,84 @@ void DcgmCacheManager::MergeNewlyDetectedGpuList(dcgmcm_gpu_info_p detectedGpus,
     }
 }
 
+/*****************************************************************************/
+void DcgmCacheManager::AttachGpuDevice(dcgmcm_gpu_info_t &gpuInfo)
+{
+    nvmlReturn_t nvmlSt;
+    dcgmReturn_t ret;
+
+    nvmlSt = nvmlDeviceGetHandleByIndex_v2(gpuInfo.nvmlIndex, &gpuInfo.nvmlDevice);
+
+    // if nvmlReturn == NVML_ERROR_NO_PERMISSION this is ok
+    // but it should be logged in case it is unexpected
+    if (nvmlSt == NVML_ERROR_NO_PERMISSION)
+    {
+        PRINT_WARNING("%u", "GPU %u initialization was skipped due to no permissions.", gpuInfo.nvmlIndex);
+        gpuInfo.status = DcgmEntityStatusInaccessible;
+        return;
+    }
+    else if (nvmlSt != NVML_SUCCESS)
+    {
+        PRINT_ERROR("%d %u",
+                    "Got nvml error %d from nvmlDeviceGetHandleByIndex_v2 of nvmlIndex %u",
+                    (int)nvmlSt,
+                    gpuInfo.nvmlIndex);
+        /* Treat this error as inaccessible */
+        gpuInfo.status = DcgmEntityStatusInaccessible;
+        return;
+    }
+
+    nvmlSt = nvmlDeviceGetUUID(gpuInfo.nvmlDevice, gpuInfo.uuid, sizeof(gpuInfo.uuid));
+    if (nvmlSt != NVML_SUCCESS)
+    {
+        PRINT_ERROR(
+            "%d %u", "Got nvml error %d from nvmlDeviceGetUUID of nvmlIndex %u", (int)nvmlSt, gpuInfo.nvmlIndex);
+        /* Non-fatal. Keep going. */
+    }
+
+    nvmlBrandType_t nvmlBrand = NVML_BRAND_UNKNOWN;
+    nvmlSt                    = nvmlDeviceGetBrand(gpuInfo.nvmlDevice, &nvmlBrand);
+    if (nvmlSt != NVML_SUCCESS)
+    {
+        PRINT_ERROR(
+            "%d %u", "Got nvml error %d from nvmlDeviceGetBrand of nvmlIndex %u", (int)nvmlSt, gpuInfo.nvmlIndex);
+        /* Non-fatal. Keep going. */
+    }
+    gpuInfo.brand = (dcgmGpuBrandType_t)nvmlBrand;
+
+    nvmlSt = nvmlDeviceGetPciInfo_v3(gpuInfo.nvmlDevice, &gpuInfo.pciInfo);
+    if (nvmlSt != NVML_SUCCESS)
+    {
+        PRINT_ERROR(
+            "%d %u", "Got nvml error %d from nvmlDeviceGetPciInfo_v3 of nvmlIndex %u", (int)nvmlSt, gpuInfo.nvmlIndex);
+        /* Non-fatal. Keep going. */
+    }
+
+    /* Read the arch before we check the whitelist since the arch is used for the whitelist */
+    ret = HelperGetLiveChipArch(gpuInfo.nvmlDevice, gpuInfo.arch);
+    if (ret != DCGM_ST_OK)
+    {
+        PRINT_ERROR("%d %u", "Got error %d from HelperGetLiveChipArch of nvmlIndex %u", (int)ret, gpuInfo.nvmlIndex);
+        /* Non-fatal. Keep going. */
+    }
+
+    /* Get the virtualization mode of the GPU */
+
+    nvmlGpuVirtualizationMode_t nvmlVirtualMode;
+    nvmlSt = nvmlDeviceGetVirtualizationMode(gpuInfo.nvmlDevice, &nvmlVirtualMode);
+    if (nvmlSt == NVML_SUCCESS)
+    {
+        gpuInfo.virtualizationMode = (dcgmGpuVirtualizationMode_t)nvmlVirtualMode;
+    }
+    else
+    {
+        gpuInfo.virtualizationMode = DCGM_GPU_VIRTUALIZATION_MODE_NONE;
+        DCGM_LOG_ERROR << "nvmlDeviceGetVirtualizationMode returned " << (int)nvmlSt << " for nvmlIndex "
+                       << gpuInfo.nvmlIndex;
+        /* Non-fatal. Keep going. */
+    }
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmCacheManager::AttachGpus()
 {
@@ -1295,6 +1563,7 @@ dcgmReturn_t DcgmCacheManager::AttachGpus()
     dcgmcm_gpu_info_t detectedGpus[DCGM_MAX_NUM_DEVICES]; /* All of the GPUs we know about, indexed by gpuId */
     memset(&detectedGpus, 0, sizeof(detectedGpus));
     dcgmReturn_t ret;
+    timelib64_t startUsec = timelib_usecSince1970();
 
     dcgm_mutex_lock(m_mutex);
     m_numInstances        = 0;
@@ -1338,86 +1607,61 @@ dcgmReturn_t DcgmCacheManager::AttachGpus()
         PRINT_ERROR("%s", "Couldn't create the proper NVML event set when re-attaching to GPUS: %s", errorString(ret));
     }
 
+    timelib64_t queryStartUsec = timelib_usecSince1970();
+
     for (int i = 0; i < detectedGpusCount; i++)
     {
         detectedGpus[i].gpuId     = i; /* For now, gpuId == index == nvmlIndex */
         detectedGpus[i].nvmlIndex = i;
         detectedGpus[i].status    = DcgmEntityStatusOk; /* Start out OK */
+    }
 
-        nvmlSt = nvmlDeviceGetHandleByIndex_v2(detectedGpus[i].nvmlIndex, &detectedGpus[i].nvmlDevice);
-
-        // if nvmlReturn == NVML_ERROR_NO_PERMISSION this is ok
-        // but it should be logged in case it is unexpected
-        if (nvmlSt == NVML_ERROR_NO_PERMISSION)
-        {
-            PRINT_WARNING("%d", "GPU %d initialization was skipped due to no permissions.", i);
-            detectedGpus[i].status = DcgmEntityStatusInaccessible;
-            continue;
-        }
-        else if (nvmlSt != NVML_SUCCESS)
-        {
-            PRINT_ERROR(
-                "%d %d", "Got nvml error %d from nvmlDeviceGetHandleByIndex_v2 of nvmlIndex %d", (int)nvmlSt, i);
-            /* Treat this error as inaccessible */
-            detectedGpus[i].status = DcgmEntityStatusInaccessible;
-            continue;
-        }
-
-        nvmlSt = nvmlDeviceGetUUID(detectedGpus[i].nvmlDevice, detectedGpus[i].uuid, sizeof(detectedGpus[i].uuid));
-        if (nvmlSt != NVML_SUCCESS)
-        {
-            PRINT_ERROR("%d %d", "Got nvml error %d from nvmlDeviceGetUUID of nvmlIndex %d", (int)nvmlSt, i);
-            /* Non-fatal. Keep going. */
-        }
-
-        nvmlBrandType_t nvmlBrand = NVML_BRAND_UNKNOWN;
-        nvmlSt                    = nvmlDeviceGetBrand(detectedGpus[i].nvmlDevice, &nvmlBrand);
-        if (nvmlSt != NVML_SUCCESS)
-        {
-            PRINT_ERROR("%d %d", "Got nvml error %d from nvmlDeviceGetBrand of nvmlIndex %d", (int)nvmlSt, i);
-            /* Non-fatal. Keep going. */
-        }
-        detectedGpus[i].brand = (dcgmGpuBrandType_t)nvmlBrand;
+    /* The per-GPU queries don't touch our state, so query the GPUs concurrently. Each one
+       takes several driver round trips, which adds up to seconds on large systems */
+    if (detectedGpusCount > 1)
+    {
+        unsigned int numWorkers = DCGM_MIN((unsigned int)detectedGpusCount, std::thread::hardware_concurrency());
+        DcgmNs::ThreadPool attachPool(DCGM_MAX(numWorkers, 1U));
+        std::vector<std::shared_future<void>> workers;
 
-        nvmlSt = nvmlDeviceGetPciInfo_v3(detectedGpus[i].nvmlDevice, &detectedGpus[i].pciInfo);
-        if (nvmlSt != NVML_SUCCESS)
+        for (int i = 0; i < detectedGpusCount; i++)
         {
-            PRINT_ERROR("%d %d", "Got nvml error %d from nvmlDeviceGetPciInfo_v3 of nvmlIndex %d", (int)nvmlSt, i);
-            /* Non-fatal. Keep going. */
+            dcgmcm_gpu_info_t *gpuInfo = &detectedGpus[i];
+            workers.push_back(attachPool.Enqueue([this, gpuInfo]() { AttachGpuDevice(*gpuInfo); }));
         }
 
-        /* Read the arch before we check the whitelist since the arch is used for the whitelist */
-        ret = HelperGetLiveChipArch(detectedGpus[i].nvmlDevice, detectedGpus[i].arch);
-        if (ret != DCGM_ST_OK)
+        for (auto &worker : workers)
         {
-            PRINT_ERROR("%d %d", "Got error %d from HelperGetLiveChipArch of nvmlIndex %d", (int)ret, i);
-            /* Non-fatal. Keep going. */
+            worker.wait();
         }
+    }
+    else if (detectedGpusCount == 1)
+    {
+        AttachGpuDevice(detectedGpus[0]);
+    }
 
-        /* Get the virtualization mode of the GPU */
+    timelib64_t migStartUsec = timelib_usecSince1970();
 
-        nvmlGpuVirtualizationMode_t nvmlVirtualMode;
-        nvmlSt = nvmlDeviceGetVirtualizationMode(detectedGpus[i].nvmlDevice, &nvmlVirtualMode);
-        if (nvmlSt == NVML_SUCCESS)
-        {
-            detectedGpus[i].virtualizationMode = (dcgmGpuVirtualizationMode_t)nvmlVirtualMode;
-        }
-        else
+    /* MIG enumeration updates our instance bookkeeping, so it stays serial */
+    for (int i = 0; i < detectedGpusCount; i++)
+    {
+        if (detectedGpus[i].status == DcgmEntityStatusInaccessible)
         {
-            detectedGpus[i].virtualizationMode = DCGM_GPU_VIRTUALIZATION_MODE_NONE;
-            DCGM_LOG_ERROR << "nvmlDeviceGetVirtualizationMode returned " << (int)nvmlSt << " for nvmlIndex " << i;
-            /* Non-fatal. Keep going. */
+            continue;
         }
 
         ret = InitializeGpuInstances(detectedGpus[i]);
         if (ret != DCGM_ST_OK)
         {
+            dcgm_mutex_unlock(m_mutex);
             return ret;
         }
     }
 
     MergeNewlyDetectedGpuList(detectedGpus, detectedGpusCount);
 
+    timelib64_t nvLinkStartUsec = timelib_usecSince1970();
+
     /* We keep track of all GPUs that NVML knew about.
      * Do this before the for loop so that IsGpuWhitelisted doesn't
      * think we are setting invalid gpuIds */
@@ -1439,6 +1683,15 @@ dcgmReturn_t DcgmCacheManager::AttachGpus()
     /* Read and cache the GPU blacklist on each attach */
     ReadAndCacheGpuBlacklist();
 
+    InvalidateTopology();
+
+    timelib64_t endUsec = timelib_usecSince1970();
+    DCGM_LOG_INFO << "Attached " << detectedGpusCount << " GPUs in " << (endUsec - startUsec) / 1000
+                  << " ms. NVML init: " << (queryStartUsec - startUsec) / 1000
+                  << " ms, GPU queries: " << (migStartUsec - queryStartUsec) / 1000
+                  << " ms, MIG: " << (nvLinkStartUsec - migStartUsec) / 1000
+                  << " ms, NvLink and blacklist: " << (endUsec - nvLinkStartUsec) / 1000 << " ms";
+
     dcgm_mutex_unlock(m_mutex);
 
     return DCGM_ST_OK;
@@ -1544,6 +1797,7 @@ unsigned int DcgmCacheManager::AddFakeGpu(unsigned int pciDeviceId, unsigned int
     }
 
     m_numGpus++;
+    InvalidateTopology();
     dcgm_mutex_unlock(m_mutex);
 
     /* Inject ECC mode as enabled so policy management works */
@@ -1666,6 +1920,7 @@ dcgm_field_eid_t DcgmCacheManager::AddFakeInstance(dcgm_field_eid_t parentId)
 
     m_gpus[parentId].migEnabled = true;
     m_gpus[parentId].usedGpcs += 1;
+    m_haveMigHierarchy = false;
 
     return entityId;
 }
@@ -1711,6 +1966,7 @@ dcgm_field_eid_t DcgmCacheManager::AddFakeComputeInstance(dcgm_field_eid_t paren
                 m_migManager.RecordGpuComputeInstance(gpuIndex, gpuInstance.GetInstanceId(), ci.dcgmComputeInstanceId);
                 m_numComputeInstances++;
                 m_gpus[gpuIndex].ciCount++;
+                m_haveMigHierarchy = false;
                 break;
             }
         }
@@ -1742,7 +1998,11 @@ dcgmReturn_t DcgmCacheManager::SetGpuNvLinkLinkState(unsigned int gpuId,
     }
 
     PRINT_INFO("%u %u %u", "Setting gpuId %u, link %u to link state %u", gpuId, linkId, linkState);
-    m_gpus[gpuId].nvLinkLinkState[linkId] = linkState;
+    if (m_gpus[gpuId].nvLinkLinkState[linkId] != linkState)
+    {
+        m_gpus[gpuId].nvLinkLinkState[linkId] = linkState;
+        InvalidateTopology();
+    }
     return DCGM_ST_OK;
 }
 
@@ -1772,6 +2032,10 @@ dcgmReturn_t DcgmCacheManager::Init(int pollInLockStep, double maxSampleAge)
         return ret;
     }
 
+    /* Restore history from before a restart now that we know which GPUs we have */
+    if (!m_snapshotFilename.empty())
+        LoadSnapshot(m_snapshotFilename); /* Not fatal. Already logged */
+
     /* Start the event watch before we start the event reading thread */
     ManageDeviceEvents(DCGM_GPU_ID_BAD, 0);
 
@@ -1791,6637 +2055,9911 @@ dcgmReturn_t DcgmCacheManager::Init(int pollInLockStep, double maxSampleAge)
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::Shutdown()
+void DcgmCacheManager::SetHistoryCompression(bool enabled)
 {
-    dcgmReturn_t retSt = DCGM_ST_OK;
-    int st;
-    nvmlVgpuInstance_t vgpuInstanceCount;
+    DcgmLockGuard dlg(m_mutex);
+    m_compressHistory = enabled;
+}
 
-    if (m_eventThread)
-    {
-        PRINT_INFO("", "Stopping event thread.");
-        st = m_eventThread->StopAndWait(10000);
-        if (st)
-        {
-            PRINT_WARNING("", "Killing event thread that is still running.");
-            m_eventThread->Kill();
-        }
-        else
-            PRINT_INFO("", "Event thread was stopped normally.");
-        delete m_eventThread;
-        m_eventThread = 0;
-    }
-    else
-        PRINT_WARNING("", "m_eventThread was NULL");
-
-    /* Wake up the cache manager thread if it's sleeping. No need to wait */
-    Stop();
-    UpdateAllFields(0);
-
-    /* Wait for the thread to exit for a reasonable amount of time. After that,
-       just kill the polling thread so we don't wait forever */
-    st = StopAndWait(30000);
-    if (st)
-    {
-        PRINT_WARNING("", "Killing stats thread that is still running.");
-        Kill();
-    }
-
-    /* Sending an empty vgpuList to free vgpuList of all GPUs*/
-    vgpuInstanceCount = 0;
-    for (unsigned int i = 0; i < m_numGpus; i++)
-    {
-        ManageVgpuList(m_gpus[i].gpuId, &vgpuInstanceCount);
-    }
-
-    if (m_entityWatchHashTable)
-    {
-        hashtable_destroy(m_entityWatchHashTable);
-        m_entityWatchHashTable = 0;
-    }
-
-    return retSt;
+/*****************************************************************************/
+void DcgmCacheManager::SetParallelGpuFetch(bool enabled)
+{
+    DcgmLockGuard dlg(m_mutex);
+    m_parallelGpuFetch = enabled;
 }
 
 /*****************************************************************************/
-dcgmGpuBrandType_t DcgmCacheManager::GetGpuBrand(unsigned int gpuId)
+dcgmReturn_t DcgmCacheManager::SetEntityCollector(dcgm_field_entity_group_t entityGroupId,
+                                                  std::shared_ptr<DcgmEntityCollector> collector)
 {
-    if (gpuId >= m_numGpus)
-        return DCGM_GPU_BRAND_UNKNOWN;
+    if (entityGroupId == DCGM_FE_NONE || entityGroupId == DCGM_FE_GPU || entityGroupId >= DCGM_FE_COUNT)
+        return DCGM_ST_BADPARAM;
 
-    return m_gpus[gpuId].brand;
+    if (!collector && entityGroupId == DCGM_FE_VGPU)
+        collector = std::make_shared<VgpuCollector>(*this);
+
+    DcgmLockGuard dlg(m_mutex);
+    m_entityCollectors[entityGroupId] = std::move(collector);
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::EntityIdToWatchKey(dcgmcm_entity_key_t *watchKey,
-                                          dcgm_field_entity_group_t entityGroupId,
-                                          dcgm_field_eid_t entityId,
-                                          unsigned int fieldId)
+void DcgmCacheManager::SetThreadPlacement(bool nearGpus)
 {
-    if (!watchKey)
-        return;
-
-    watchKey->entityId      = entityId;
-    watchKey->entityGroupId = entityGroupId;
-    watchKey->fieldId       = fieldId;
+    DcgmLockGuard dlg(m_mutex);
+    m_placeThreadsNearGpus = nearGpus && CPU_COUNT(&m_allowedCpus) > 0;
 }
 
 /*****************************************************************************/
-dcgmcm_watch_info_p DcgmCacheManager::AllocWatchInfo(dcgmcm_entity_key_t entityKey)
+void DcgmCacheManager::SetBufferedSampling(bool enabled)
 {
-    dcgmcm_watch_info_p retInfo = new dcgmcm_watch_info_t;
-
-    retInfo->watchKey              = entityKey;
-    retInfo->isWatched             = 0;
-    retInfo->hasSubscribedWatchers = 0;
-    retInfo->lastStatus            = NVML_SUCCESS;
-    retInfo->lastQueriedUsec       = 0;
-    retInfo->monitorFrequencyUsec  = 0;
-    retInfo->maxAgeUsec            = 0;
-    retInfo->execTimeUsec          = 0;
-    retInfo->fetchCount            = 0;
-    retInfo->timeSeries            = 0;
-    // Initialize the practical watch information for fields whose data is not retrievable
-    // in all the places where they can be watched. This is relevant for MIG mode.
-    retInfo->practicalEntityGroupId = static_cast<dcgm_field_entity_group_t>(retInfo->watchKey.entityGroupId);
-    retInfo->practicalEntityId      = retInfo->watchKey.entityId;
-    return retInfo;
+    DcgmLockGuard dlg(m_mutex);
+    m_bufferedSampling = enabled;
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::FreeWatchInfo(dcgmcm_watch_info_p watchInfo)
+void DcgmCacheManager::SetWatchCoalescing(timelib64_t jitterUsec)
 {
-    /* Call the static version that is used by the hashtable callbacks */
-    entityValueFreeCB(watchInfo);
+    DcgmLockGuard dlg(m_mutex);
+    m_watchCoalesceUsec = std::max((timelib64_t)0, jitterUsec);
 }
 
 /*****************************************************************************/
-dcgmcm_watch_info_p DcgmCacheManager::GetEntityWatchInfo(dcgm_field_entity_group_t entityGroupId,
-                                                         dcgm_field_eid_t entityId,
-                                                         unsigned int fieldId,
-                                                         int createIfNotExists)
+void DcgmCacheManager::SetEventFieldPolling(timelib64_t pollUsec)
 {
-    dcgmcm_watch_info_p retInfo = 0;
-    dcgmMutexReturn_t mutexReturn;
-    void *hashKey = 0;
-    int st;
-
-    mutexReturn = dcgm_mutex_lock_me(m_mutex);
+    DcgmLockGuard dlg(m_mutex);
+    m_eventFieldPollUsec = std::max((timelib64_t)0, pollUsec);
 
-    /* Global watches have no entityId */
-    if (entityGroupId == DCGM_FE_NONE)
-        entityId = 0;
+    /* Register for the events of fields that are already watched */
+    ManageDeviceEvents(DCGM_GPU_ID_BAD, 0);
+}
 
-    EntityIdToWatchKey((dcgmcm_entity_key_t *)&hashKey, entityGroupId, entityId, fieldId);
+/*****************************************************************************/
+void DcgmCacheManager::SetAdaptiveSampling(timelib64_t baseUsec, double threshold)
+{
+    DcgmLockGuard dlg(m_mutex);
+    m_adaptiveBaseUsec  = std::max((timelib64_t)0, baseUsec);
+    m_adaptiveThreshold = std::max(0.0, threshold);
 
-    retInfo = (dcgmcm_watch_info_p)hashtable_get(m_entityWatchHashTable, hashKey);
-    if (!retInfo)
+    /* Watches that were decimated go back to their monitor frequency if it's turned off */
+    if (!m_adaptiveBaseUsec)
     {
-        if (!createIfNotExists)
-        {
-            if (mutexReturn == DCGM_MUTEX_ST_OK)
-                dcgm_mutex_unlock(m_mutex);
-            PRINT_DEBUG("%u %u %u",
-                        "watch key eg %u, eid %u, fieldId %u doesn't exist. createIfNotExists == false",
-                        entityGroupId,
-                        entityId,
-                        fieldId);
-            return NULL;
-        }
-
-        /* Allocate a new one */
-        PRINT_DEBUG("%p %u %u %u",
-                    "Adding WatchInfo on entityKey %p (eg %u, entityId %u, fieldId %u)",
-                    (void *)hashKey,
-                    entityGroupId,
-                    entityId,
-                    fieldId);
-        dcgmcm_entity_key_t addKey;
-        EntityIdToWatchKey(&addKey, entityGroupId, entityId, fieldId);
-        retInfo = AllocWatchInfo(addKey);
-        st      = hashtable_set(m_entityWatchHashTable, hashKey, retInfo);
-        if (st)
+        for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
         {
-            PRINT_ERROR("%d", "hashtable_set failed with st %d. Likely out of memory", st);
-            FreeWatchInfo(retInfo);
-            retInfo = 0;
+            ScheduleWatchBurst(watchInfo);
         }
     }
-
-    if (mutexReturn == DCGM_MUTEX_ST_OK)
-        dcgm_mutex_unlock(m_mutex);
-
-    return retInfo;
 }
 
 /*****************************************************************************/
-int DcgmCacheManager::HasAccountingPidBeenSeen(unsigned int pid, timelib64_t timestamp)
+unsigned long long DcgmCacheManager::NvmlEventTypeForField(unsigned short fieldId)
 {
-    dcgmcm_pid_seen_t key, *elem;
-    kv_cursor_t cursor;
+    switch (fieldId)
+    {
+        case DCGM_FI_DEV_ECC_SBE_VOL_TOTAL:
+        case DCGM_FI_DEV_ECC_SBE_AGG_TOTAL:
+            return nvmlEventTypeSingleBitEccError;
 
-    key.pid       = pid;
-    key.timestamp = timestamp;
+        case DCGM_FI_DEV_ECC_DBE_VOL_TOTAL:
+        case DCGM_FI_DEV_ECC_DBE_AGG_TOTAL:
+            return nvmlEventTypeDoubleBitEccError;
 
-    elem = (dcgmcm_pid_seen_p)keyedvector_find_by_key(m_accountingPidsSeen, &key, KV_LGE_EQUAL, &cursor);
-    if (elem)
-    {
-        PRINT_DEBUG("%u %lld", "PID %u, ts %lld FOUND in seen cache", key.pid, (long long)key.timestamp);
-        return 1;
-    }
-    else
-    {
-        PRINT_DEBUG("%u %lld", "PID %u, ts %lld NOT FOUND in seen cache", key.pid, (long long)key.timestamp);
-        return 0;
+        case DCGM_FI_DEV_PSTATE:
+            return nvmlEventTypePState;
+
+        default:
+            return 0;
     }
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::CacheAccountingPid(unsigned int pid, timelib64_t timestamp)
+timelib64_t DcgmCacheManager::GetPollIntervalUsec(dcgmcm_watch_info_p watchInfo) const
 {
-    dcgmcm_pid_seen_t key;
-    int st;
-    kv_cursor_t cursor;
+    timelib64_t intervalUsec = IsWatchDecimated(watchInfo) ? m_adaptiveBaseUsec : watchInfo->monitorFrequencyUsec;
 
-    key.pid       = pid;
-    key.timestamp = timestamp;
-
-    st = keyedvector_insert(m_accountingPidsSeen, &key, &cursor);
-    if (st)
+    if (!m_eventFieldPollUsec || watchInfo->watchKey.entityGroupId != DCGM_FE_GPU
+        || watchInfo->watchKey.entityId >= m_numGpus)
     {
-        PRINT_ERROR("%d %u %lld",
-                    "Error %d from keyedvector_insert pid %u, timestamp %lld",
-                    st,
-                    key.pid,
-                    (long long)key.timestamp);
-        return DCGM_ST_GENERIC_ERROR;
+        return intervalUsec;
     }
 
-    return DCGM_ST_OK;
+    /* Only stretch the polling if this GPU actually delivers the event */
+    unsigned long long eventType = NvmlEventTypeForField(watchInfo->watchKey.fieldId);
+    if (!eventType || !(m_currentEventMask[watchInfo->watchKey.entityId] & eventType))
+        return intervalUsec;
+
+    return std::max(intervalUsec, m_eventFieldPollUsec);
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::EmptyAccountingPidCache(void)
+bool DcgmCacheManager::IsWatchDecimated(dcgmcm_watch_info_p watchInfo) const
 {
-    PRINT_DEBUG("", "Pid seen cache emptied");
-    keyedvector_empty(m_accountingPidsSeen);
+    return m_adaptiveBaseUsec > watchInfo->monitorFrequencyUsec && watchInfo->adaptiveQuiet
+           && watchInfo->practicalEntityGroupId == DCGM_FE_GPU && watchInfo->practicalEntityId < m_numGpus
+           && m_adaptiveBurstUntilUsec[watchInfo->practicalEntityId] <= timelib_fastUsecSince1970();
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::EmptyCache(void)
+void DcgmCacheManager::ScheduleWatchBurst(dcgmcm_watch_info_p watchInfo)
 {
-    dcgm_mutex_lock(m_mutex);
-    ClearAllEntities(1);
-    EmptyAccountingPidCache();
-    dcgm_mutex_unlock(m_mutex);
-
-    return DCGM_ST_OK;
+    /* Only watches that are waiting out the base interval. Ones being fetched right now have already been
+       rescheduled, and derived fields are never scheduled */
+    timelib64_t burstUsec = watchInfo->lastQueriedUsec + watchInfo->monitorFrequencyUsec;
+    if (watchInfo->isWatched && watchInfo->nextUpdateUsec > burstUsec)
+        ScheduleWatchUpdate(watchInfo, burstUsec);
 }
 
-/*********************************f********************************************/
-int DcgmCacheManager::GpuIdToNvmlIndex(unsigned int gpuId)
+/*****************************************************************************/
+void DcgmCacheManager::UpdateAdaptiveSampling(dcgmcm_watch_info_p watchInfo, double value)
 {
-    /* Treat as index for now. Just bounds check it */
-    if (gpuId >= m_numGpus)
-        return DCGM_ST_BADPARAM;
+    if (watchInfo->practicalEntityGroupId != DCGM_FE_GPU || watchInfo->practicalEntityId >= m_numGpus)
+        return;
+
+    double limit = m_adaptiveThreshold * std::fabs(watchInfo->adaptiveMean);
+    bool moved   = watchInfo->adaptiveSamples == 0 || std::fabs(value - watchInfo->adaptiveMean) > limit;
+
+    if (watchInfo->adaptiveSamples == 0)
+    {
+        watchInfo->adaptiveMean     = value;
+        watchInfo->adaptiveVariance = 0.0;
+        watchInfo->adaptiveSamples  = 1;
+    }
     else
-        return m_gpus[gpuId].nvmlIndex;
-}
+    {
+        double diff = value - watchInfo->adaptiveMean;
+        watchInfo->adaptiveMean += DCGM_CM_ADAPTIVE_ALPHA * diff;
+        watchInfo->adaptiveVariance
+            = (1.0 - DCGM_CM_ADAPTIVE_ALPHA) * (watchInfo->adaptiveVariance + DCGM_CM_ADAPTIVE_ALPHA * diff * diff);
+        watchInfo->adaptiveSamples = 2;
+    }
 
-/*********************************f********************************************/
-unsigned int DcgmCacheManager::NvmlIndexToGpuId(int nvmlIndex)
-{
-    for (unsigned int i = 0; i < m_numGpus; i++)
+    unsigned int gpuId = watchInfo->practicalEntityId;
+    if (watchInfo->watchKey.fieldId == DCGM_CM_ADAPTIVE_TRIGGER_FIELD_ID)
     {
-        if (m_gpus[i].nvmlIndex == (unsigned int)nvmlIndex)
-            return m_gpus[i].gpuId;
+        /* The trigger itself is never decimated. When it changes, the GPU is busy changing what it does, so
+           every watch of it bursts for at least one base interval */
+        if (!moved)
+            return;
+
+        timelib64_t now   = timelib_fastUsecSince1970();
+        bool startedBurst = m_adaptiveBurstUntilUsec[gpuId] <= now;
+
+        m_adaptiveBurstUntilUsec[gpuId] = now + m_adaptiveBaseUsec;
+        if (startedBurst)
+        {
+            for (dcgmcm_watch_info_p gpuWatchInfo : m_entityWatches.Values())
+            {
+                if (gpuWatchInfo->practicalEntityGroupId == DCGM_FE_GPU && gpuWatchInfo->practicalEntityId == gpuId)
+                    ScheduleWatchBurst(gpuWatchInfo);
+            }
+        }
+        return;
     }
 
-    PRINT_ERROR("%d %d", "nvmlIndex %d not found in %u gpus", nvmlIndex, m_numGpus);
-    return 0;
+    limit                    = m_adaptiveThreshold * std::fabs(watchInfo->adaptiveMean);
+    watchInfo->adaptiveQuiet = !moved && watchInfo->adaptiveVariance <= limit * limit;
+    if (moved)
+        ScheduleWatchBurst(watchInfo);
 }
 
-/*********************************f********************************************/
-dcgmReturn_t DcgmCacheManager::Start(void)
+/*****************************************************************************/
+void DcgmCacheManager::RefreshEventBackedWatches(unsigned int gpuId, unsigned long long eventType)
 {
-    int st = DcgmThread::Start();
+    static const unsigned short eventBackedFieldIds[] = { DCGM_FI_DEV_ECC_SBE_VOL_TOTAL, DCGM_FI_DEV_ECC_SBE_AGG_TOTAL,
+                                                          DCGM_FI_DEV_ECC_DBE_VOL_TOTAL, DCGM_FI_DEV_ECC_DBE_AGG_TOTAL,
+                                                          DCGM_FI_DEV_PSTATE };
+    bool anyPending = false;
 
-    if (st)
-        return DCGM_ST_GENERIC_ERROR;
-    else
-        return DCGM_ST_OK;
-}
+    {
+        DcgmLockGuard dlg(m_mutex);
 
-/*********************************f********************************************/
-DcgmEntityStatus_t DcgmCacheManager::GetGpuStatus(unsigned int gpuId)
-{
-    PRINT_DEBUG("%d", "Checking status for gpu %d", gpuId);
-    if (gpuId >= m_numGpus)
-        return DcgmEntityStatusUnknown;
+        if (!m_eventFieldPollUsec)
+            return;
 
-    return m_gpus[gpuId].status;
-}
+        timelib64_t now = timelib_usecSince1970();
+        for (unsigned short fieldId : eventBackedFieldIds)
+        {
+            if (NvmlEventTypeForField(fieldId) != eventType)
+                continue;
 
-/******************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetGpuArch(unsigned int gpuId, dcgmChipArchitecture_t &arch)
-{
-    if (gpuId >= m_numGpus)
-        return DCGM_ST_BADPARAM;
+            dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, fieldId, 0);
+            if (!watchInfo || !watchInfo->isWatched)
+                continue;
 
-    arch = m_gpus[gpuId].arch;
+            watchInfo->eventPending = 1;
+            ScheduleWatchUpdate(watchInfo, now);
+            anyPending = true;
+        }
+    }
 
-    return DCGM_ST_OK;
+    if (anyPending)
+        UpdateAllFields(0);
 }
 
-/*********************************f********************************************/
-dcgmReturn_t DcgmCacheManager::PauseGpu(unsigned int gpuId)
+/*****************************************************************************/
+timelib64_t DcgmCacheManager::AlignWatchDeadline(timelib64_t dueUsec, timelib64_t tickUsec, timelib64_t jitterUsec)
 {
-    if (gpuId >= m_numGpus)
-        return DCGM_ST_BADPARAM;
+    if (jitterUsec <= 0 || tickUsec <= 0 || dueUsec <= 0)
+        return dueUsec;
+
+    timelib64_t gridUsec  = std::max(tickUsec, jitterUsec);
+    timelib64_t earlyUsec = dueUsec % gridUsec;
+    timelib64_t lateUsec  = gridUsec - earlyUsec;
+
+    if (earlyUsec == 0)
+        return dueUsec;
+    if (lateUsec <= earlyUsec && lateUsec <= jitterUsec)
+        return dueUsec + lateUsec;
+    if (earlyUsec < lateUsec && earlyUsec <= jitterUsec)
+        return dueUsec - earlyUsec;
+    return dueUsec;
+}
 
-    switch (m_gpus[gpuId].status)
+/*****************************************************************************/
+int DcgmCacheManager::GetExecTimeBucket(timelib64_t execTimeUsec)
+{
+    int bucket = 0;
+    while (execTimeUsec >= 2 && bucket < DCGM_INTROSPECT_EXEC_TIME_BUCKETS - 1)
     {
-        case DcgmEntityStatusDisabled:
-        case DcgmEntityStatusUnknown:
-        default:
-            /* Nothing to do */
-            return DCGM_ST_OK;
-
-        case DcgmEntityStatusOk:
-            /* Pause the GPU */
-            PRINT_INFO("%d", "gpuId %d PAUSED.", gpuId);
-            m_gpus[gpuId].status = DcgmEntityStatusDisabled;
-            /* Force an update to occur so that we get blank values saved */
-            (void)UpdateAllFields(1);
-            return DCGM_ST_OK;
+        execTimeUsec >>= 1;
+        bucket++;
     }
+    return bucket;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::ResumeGpu(unsigned int gpuId)
+dcgmReturn_t DcgmCacheManager::SetRollupTiers(timelib64_t rawRetentionUsec,
+                                              std::vector<dcgmcm_rollup_tier_config_t> const &tiers)
 {
-    if (gpuId >= m_numGpus)
-        return DCGM_ST_BADPARAM;
-
-    switch (m_gpus[gpuId].status)
+    for (size_t i = 0; i < tiers.size(); i++)
     {
-        case DcgmEntityStatusOk:
-        case DcgmEntityStatusUnknown:
-        default:
-            /* Nothing to do */
-            return DCGM_ST_OK;
-
-        case DcgmEntityStatusDisabled:
-            /* Pause the GPU */
-            PRINT_INFO("%d", "gpuId %d RESUMED.", gpuId);
-            m_gpus[gpuId].status = DcgmEntityStatusOk;
-            return DCGM_ST_OK;
+        if (tiers[i].bucketUsec <= 0 || tiers[i].retentionUsec < tiers[i].bucketUsec
+            || tiers[i].retentionUsec <= rawRetentionUsec
+            || (i > 0
+                && (tiers[i].bucketUsec <= tiers[i - 1].bucketUsec
+                    || tiers[i].retentionUsec <= tiers[i - 1].retentionUsec)))
+        {
+            DCGM_LOG_ERROR << "Rollup tier " << i << " must be wider and retained longer than the one before it";
+            return DCGM_ST_BADPARAM;
+        }
     }
 
+    if (!tiers.empty() && rawRetentionUsec <= 0)
+        return DCGM_ST_BADPARAM;
+
+    DcgmLockGuard dlg(m_mutex);
+    m_rollupRawRetentionUsec = rawRetentionUsec;
+    m_rollupTiers            = tiers;
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::Pause()
+dcgmReturn_t DcgmCacheManager::SetSpill(std::string const &directory, long long budgetBytes)
 {
-    for (unsigned int i = 0; i < m_numGpus; i++)
+    std::unique_ptr<DcgmCacheSpill> spill;
+    if (!directory.empty())
     {
-        if (m_gpus[i].status > DcgmEntityStatusUnknown && m_gpus[i].status != DcgmEntityStatusDetached)
-            PauseGpu(m_gpus[i].gpuId);
+        spill = std::make_unique<DcgmCacheSpill>(directory, budgetBytes);
+        dcgmReturn_t dcgmReturn = spill->Open();
+        if (dcgmReturn != DCGM_ST_OK)
+            return dcgmReturn; /* Logged by Open() */
     }
 
+    DcgmLockGuard dlg(m_mutex);
+    m_spill = std::move(spill);
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::Resume()
+void DcgmCacheManager::SetCacheArenas(bool enabled, bool useHugetlb)
 {
-    for (unsigned int i = 0; i < m_numGpus; i++)
+    DcgmLockGuard dlg(m_mutex);
+    m_cacheArenas           = enabled;
+    m_cacheArenasUseHugetlb = useHugetlb;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::GetCacheArenaStats(dcgmcm_arena_stats_t &stats)
+{
+    stats = {};
+
+    DcgmLockGuard dlg(m_mutex);
+    for (auto const &arena : m_gpuArenas)
     {
-        if (m_gpus[i].status > DcgmEntityStatusUnknown && m_gpus[i].status != DcgmEntityStatusDetached)
-            ResumeGpu(m_gpus[i].gpuId);
+        if (arena)
+            arena->AddStats(stats);
     }
-
-    return DCGM_ST_OK;
+    if (m_sharedArena)
+        m_sharedArena->AddStats(stats);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::UpdateAllFields(int waitForUpdate)
+dcgmReturn_t DcgmCacheManager::Shutdown()
 {
-    long long waitForFinishedCycle = 0;
-    unsigned int sleepAtATimeMs    = 1000;
+    dcgmReturn_t retSt = DCGM_ST_OK;
+    int st;
+    nvmlVgpuInstance_t vgpuInstanceCount;
 
-    dcgm_mutex_lock(m_mutex);
-    /*
-     * Which cycle should we wait for? If one is in progress, wait for the one
-     * after the current. This can be simplified as wait for the next cycle
-     * that starts to finish
-     */
-    waitForFinishedCycle = m_runStats.updateCycleStarted + 1;
+    if (m_eventThread)
+    {
+        PRINT_INFO("", "Stopping event thread.");
+        st = m_eventThread->StopAndWait(10000);
+        if (st)
+        {
+            PRINT_WARNING("", "Killing event thread that is still running.");
+            m_eventThread->Kill();
+        }
+        else
+            PRINT_INFO("", "Event thread was stopped normally.");
+        delete m_eventThread;
+        m_eventThread = 0;
+    }
+    else
+        PRINT_WARNING("", "m_eventThread was NULL");
 
-    /* Other UpdateAllFields could be waiting on this cycle as well, but that's ok.
-     * They would have had to get the lock in between us Unlock()ing below and the
-     * polling loop getting the lock. Either way, we're consistent thanks to the lock */
-    m_runStats.shouldFinishCycle = DCGM_MAX(waitForFinishedCycle, m_runStats.shouldFinishCycle);
+    /* Wake up the cache manager thread if it's sleeping. No need to wait */
+    Stop();
+    UpdateAllFields(0);
+
+    /* Wait for the thread to exit for a reasonable amount of time. After that,
+       just kill the polling thread so we don't wait forever */
+    st = StopAndWait(30000);
+    if (st)
+    {
+        PRINT_WARNING("", "Killing stats thread that is still running.");
+        Kill();
+    }
+
+    /* Sending an empty vgpuList to free vgpuList of all GPUs*/
+    vgpuInstanceCount = 0;
+    for (unsigned int i = 0; i < m_numGpus; i++)
+    {
+        ManageVgpuList(m_gpus[i].gpuId, &vgpuInstanceCount);
+    }
+
+    /* The update thread is stopped, so nothing more will be sampled */
+    if (!m_snapshotFilename.empty())
+    {
+        SaveSnapshot(m_snapshotFilename); /* Already logged */
+        m_snapshotFilename.clear();       /* Only once, in case Shutdown() is called again */
+    }
 
+    dcgm_mutex_lock(m_mutex);
+    FreeAllWatchInfos();
     dcgm_mutex_unlock(m_mutex);
-    m_startUpdateCondition.notify_all();
-    // Add some kind of incrementing here.
 
-    if (!waitForUpdate)
-        return DCGM_ST_OK; /* We don't care when it finishes. Just return */
+    return retSt;
+}
 
-    /* Wait for signals that update loops have completed until the loop we care
-       about has completed */
-    while (m_runStats.updateCycleFinished < waitForFinishedCycle)
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::SaveSnapshot(std::string const &filename)
+{
+    DcgmCacheSnapshotWriter writer(filename);
+    dcgmReturn_t ret = writer.Open();
+    if (ret != DCGM_ST_OK)
+        return ret;
+
+    std::vector<timelib64_t> times;
+    std::vector<long long> vals;
+    std::vector<long long> vals2;
+    std::vector<dcgm_cache_snapshot_var_t> varHeaders;
+    std::vector<void const *> varValues;
+    long long numSamples = 0;
+
+    DcgmLockGuard dlg(m_mutex);
+
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
     {
-#ifdef DEBUG_UPDATE_LOOP
-        PRINT_DEBUG("%u %lld %lld",
-                    "Sleeping %u ms. %lld < %lld",
-                    sleepAtATimeMs,
-                    m_runStats.updateCycleFinished,
-                    waitForFinishedCycle);
-#endif
-        dcgm_mutex_lock(m_mutex);
+        timeseries_p timeseries = watchInfo->timeSeries;
+        if (!timeseries || timeseries_size(timeseries) < 1)
+            continue;
 
-        /* Check the updateCycleFinished one more time, now that we got the lock */
-        if (m_runStats.updateCycleFinished < waitForFinishedCycle)
-        {
-            m_mutex->CondWait(m_updateCompleteCondition, sleepAtATimeMs, [this, waitForFinishedCycle] {
-                return not(m_runStats.updateCycleFinished < waitForFinishedCycle) || ShouldStop() != 0;
-            });
-#ifdef DEBUG_UPDATE_LOOP
-            PRINT_DEBUG("%d", "UpdateAllFields() RETURN st %d", st);
-        }
-        else
+        bool isNumeric = timeseries->tsType == TS_TYPE_INT64 || timeseries->tsType == TS_TYPE_DOUBLE;
+        times.clear();
+        vals.clear();
+        vals2.clear();
+        varHeaders.clear();
+        varValues.clear();
+
+        timeseries_cursor_t cursor;
+        for (timeseries_entry_p entry = timeseries_first(timeseries, &cursor); entry;
+             entry                    = timeseries_next(timeseries, &cursor))
         {
-            PRINT_DEBUG("", "UpdateAllFields() skipped CondWait()");
-#endif
+            if (isNumeric)
+            {
+                /* val and val2 are unions of double and long long, so this covers both types */
+                long long val, val2;
+                memcpy(&val, &entry->val, sizeof(val));
+                memcpy(&val2, &entry->val2, sizeof(val2));
+                times.push_back(entry->usecSince1970);
+                vals.push_back(val);
+                vals2.push_back(val2);
+            }
+            else
+            {
+                long long size = timeseries->tsType == TS_TYPE_STRING ? strlen((char *)entry->val.ptr) + 1
+                                                                      : entry->val2.ptrSize;
+                varHeaders.push_back({ entry->usecSince1970, size });
+                varValues.push_back(entry->val.ptr);
+            }
         }
 
-        dcgm_mutex_unlock(m_mutex);
+        dcgm_cache_snapshot_record_t record {};
+        record.entityId             = watchInfo->watchKey.entityId;
+        record.entityGroupId        = watchInfo->watchKey.entityGroupId;
+        record.fieldId              = watchInfo->watchKey.fieldId;
+        record.tsType               = timeseries->tsType;
+        record.numSamples           = isNumeric ? times.size() : varHeaders.size();
+        record.monitorFrequencyUsec = watchInfo->monitorFrequencyUsec;
+        record.maxAgeUsec           = watchInfo->maxAgeUsec;
 
-#ifdef DEBUG_UPDATE_LOOP
-        PRINT_DEBUG("%d %lld %lld",
-                    "Woke up to st %d. updateCycleFinished %lld, waitForFinishedCycle %lld",
-                    st,
-                    m_runStats.updateCycleFinished,
-                    waitForFinishedCycle);
-#endif
+        if (isNumeric)
+            ret = writer.AddNumericRecord(&record, times.data(), vals.data(), vals2.data());
+        else
+            ret = writer.AddVarRecord(&record, varHeaders.data(), varValues.data());
+        if (ret != DCGM_ST_OK)
+            return ret; /* Already logged. The writer removes its file */
 
-        /* Make sure we don't get stuck waiting when a shutdown is requested */
-        if (ShouldStop())
-            return DCGM_ST_OK;
+        numSamples += record.numSamples;
     }
 
-    return DCGM_ST_OK;
+    dcgm_cache_snapshot_header_t header {};
+    header.savedUsec = timelib_usecSince1970();
+    header.numGpus   = m_numGpus;
+    for (unsigned int i = 0; i < m_numGpus && i < DCGM_MAX_NUM_DEVICES; i++)
+        SafeCopyTo(header.gpuUuids[i], m_gpus[i].uuid);
+
+    ret = writer.Finish(&header);
+    if (ret == DCGM_ST_OK)
+    {
+        DCGM_LOG_INFO << "Saved " << numSamples << " samples of " << header.numRecords << " watches to " << filename;
+    }
+    return ret;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::ManageDeviceEvents(unsigned int addWatchOnGpuId, unsigned short addWatchOnFieldId)
+/* The TS_TYPE_? that samples of a DCGM_FT_? field are cached as. -1 if there isn't one */
+static int DcgmcmFieldTypeToTsType(char fieldType)
 {
-    unsigned long long desiredEvents[DCGM_MAX_NUM_DEVICES] = { 0 };
-    unsigned long long eventsMap                           = nvmlEventTypeXidCriticalError;
-    int somethingChanged;
-    unsigned int gpuId;
-    nvmlReturn_t nvmlReturn;
-    nvmlDevice_t nvmlDevice = 0;
-    dcgmReturn_t ret        = DCGM_ST_OK;
+    switch (fieldType)
+    {
+        case DCGM_FT_DOUBLE:
+            return TS_TYPE_DOUBLE;
+        case DCGM_FT_INT64:
+        case DCGM_FT_TIMESTAMP:
+            return TS_TYPE_INT64;
+        case DCGM_FT_STRING:
+            return TS_TYPE_STRING;
+        case DCGM_FT_BINARY:
+            return TS_TYPE_BLOB;
+        default:
+            return -1;
+    }
+}
 
-    /* First, walk all GPUs to build a bitmask of which event types we care about */
-    somethingChanged = 0;
-    for (gpuId = 0; gpuId < m_numGpus; gpuId++)
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::LoadSnapshot(std::string const &filename)
+{
+    DcgmCacheSnapshotReader reader;
+    dcgmReturn_t ret = reader.Open(filename);
+    if (ret == DCGM_ST_NO_DATA)
     {
-        if (m_gpus[gpuId].status == DcgmEntityStatusDetached)
-            continue;
+        DCGM_LOG_DEBUG << "No cache snapshot at " << filename;
+        return ret;
+    }
+    else if (ret != DCGM_ST_OK)
+        return ret; /* Already logged */
 
-            /* We always subscribe for XIDs so that we have SOMETHING watched. Otherwise,
-           the event thread won't start */
-#if 1
-        if (m_gpus[gpuId].arch >= DCGM_CHIP_ARCH_AMPERE && m_driverIsR450OrNewer && IsGpuMigEnabled(gpuId))
+    dcgm_cache_snapshot_header_t const *header = reader.Header();
+    timelib64_t now                            = timelib_usecSince1970();
+    long long numRestored = 0, numSkipped = 0, numSamples = 0;
+
+    DcgmLockGuard dlg(m_mutex);
+
+    /* GPU IDs can be reassigned if GPUs were added or removed while we were down */
+    bool gpuMatches[DCGM_MAX_NUM_DEVICES] = {};
+    for (unsigned int i = 0; i < header->numGpus && i < m_numGpus && i < DCGM_MAX_NUM_DEVICES; i++)
+        gpuMatches[i] = strncmp(header->gpuUuids[i], m_gpus[i].uuid, sizeof(header->gpuUuids[i])) == 0;
+
+    size_t offset = 0;
+    for (dcgm_cache_snapshot_record_t const *record = reader.NextRecord(&offset); record;
+         record                                     = reader.NextRecord(&offset))
+    {
+        bool keep;
+        switch (record->entityGroupId)
         {
-            desiredEvents[gpuId] |= eventsMap | nvmlEventMigConfigChange;
+            case DCGM_FE_NONE:
+            case DCGM_FE_SWITCH:
+                keep = true;
+                break;
+            case DCGM_FE_GPU:
+                keep = record->entityId < DCGM_MAX_NUM_DEVICES && gpuMatches[record->entityId];
+                break;
+            default:
+                keep = false; /* Instance and vGPU IDs are reassigned on restart */
+                break;
         }
-        else
+
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(record->fieldId);
+        if (keep && fieldMeta && record->tsType != DcgmcmFieldTypeToTsType(fieldMeta->fieldType))
         {
-            desiredEvents[gpuId] |= eventsMap;
+            /* Readers of the field would misinterpret the samples */
+            DCGM_LOG_WARNING << "Skipping snapshot samples of field " << record->fieldId << " of type "
+                             << record->tsType << ". The field is of type " << fieldMeta->fieldType;
+            keep = false;
         }
 
-#else
-        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_XID_ERRORS);
-        if (watchInfo->isWatched || ((gpuId == addWatchOnGpuId) && (addWatchOnFieldId == watchInfo->fieldId)))
+        dcgmcm_watch_info_p watchInfo = nullptr;
+        if (keep && fieldMeta && record->numSamples > 0)
         {
-            PRINT_DEBUG("%u", "gpuId %u wants nvmlEventTypeXidCriticalError", gpuId);
-            desiredEvents[gpuId] |= nvmlEventTypeXidCriticalError;
+            watchInfo = GetEntityWatchInfo(
+                (dcgm_field_entity_group_t)record->entityGroupId, record->entityId, record->fieldId, 1);
         }
-#endif
 
-#if 0 /* TODO: DCGM-1419 */
-        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_NVLINK_ERRORS, 1);
-        if(watchInfo->isWatched ||
-           ((gpuId == addWatchOnGpuId) && (addWatchOnFieldId == watchInfo->watchKey.fieldId)))
+        /* Don't mix restored samples with newer ones */
+        if (!watchInfo || watchInfo->timeSeries)
         {
-            PRINT_DEBUG("%u", "gpuId %u wants nvmlEventTypeNVLinkRecoveryError", gpuId);
-            desiredEvents[gpuId] |= nvmlEventTypeNVLinkRecoveryError;
-            PRINT_DEBUG("%u", "gpuId %u wants nvmlEventTypeNVLinkFatalError", gpuId);
-            desiredEvents[gpuId] |= nvmlEventTypeNVLinkFatalError;
+            numSkipped++;
+            continue;
         }
-#endif
 
-        if (desiredEvents[gpuId])
+        if (!watchInfo->isWatched)
         {
-            PRINT_DEBUG("%u %llX %llX",
-                        "gpuId %u, desiredEvents x%llX, m_currentEventMask x%llX",
-                        gpuId,
-                        desiredEvents[gpuId],
-                        m_currentEventMask[gpuId]);
+            /* Only used to size and age out the restored samples until someone watches this again */
+            watchInfo->monitorFrequencyUsec = record->monitorFrequencyUsec;
+            watchInfo->maxAgeUsec           = record->maxAgeUsec;
         }
 
-        if (desiredEvents[gpuId] != m_currentEventMask[gpuId])
-            somethingChanged = 1;
-    }
-
-
-    if (!somethingChanged)
-        return DCGM_ST_OK; /* Nothing to do */
-
-    ret = InitializeNvmlEventSet();
-    if (ret != DCGM_ST_OK)
-        return ret;
-
-    for (gpuId = 0; gpuId < m_numGpus; gpuId++)
-    {
-        if (m_gpus[gpuId].status == DcgmEntityStatusDetached)
-            continue;
-
-        // TODO: add a check here to investigate gpuInstanceId and computeInstanceId.
-        /* Did this GPU change? */
-        if (desiredEvents[gpuId] == m_currentEventMask[gpuId])
-            continue;
+        if (AllocWatchInfoTimeSeries(watchInfo, record->tsType) != DCGM_ST_OK)
+            return DCGM_ST_MEMORY; /* Already logged */
 
-        nvmlReturn = nvmlDeviceGetHandleByIndex_v2(GpuIdToNvmlIndex(gpuId), &nvmlDevice);
-        if (nvmlReturn != NVML_SUCCESS)
+        timeseries_p timeseries = watchInfo->timeSeries;
+        if (record->tsType == TS_TYPE_INT64 || record->tsType == TS_TYPE_DOUBLE)
         {
-            PRINT_ERROR("%d %d",
-                        "ManageDeviceEvents: nvmlDeviceGetHandleByIndex_v2 returned %d for gpuId %d",
-                        (int)nvmlReturn,
-                        (int)gpuId);
-            return NvmlReturnToDcgmReturn(nvmlReturn);
-        }
+            /* The columns hold the raw bits of either type, which is what timeseries_value_t is a union of. The
+               timeseries was allocated with the record's type, so they can be inserted as is */
+            timelib64_t const *times       = DcgmCacheSnapshotTimes(record);
+            timeseries_value_t const *val  = (timeseries_value_t const *)DcgmCacheSnapshotVal(record);
+            timeseries_value_t const *val2 = (timeseries_value_t const *)DcgmCacheSnapshotVal2(record);
 
-        nvmlReturn = nvmlDeviceRegisterEvents(nvmlDevice, desiredEvents[gpuId], m_nvmlEventSet);
-        if (nvmlReturn == NVML_ERROR_NOT_SUPPORTED)
-        {
-            PRINT_WARNING("%d, %llu",
-                          "ManageDeviceEvents: Desired events are not supported for gpuId: %d. Events mask: %llu",
-                          (int)gpuId,
-                          desiredEvents[gpuId]);
-            continue;
+            int tsSt = timeseries_insert_many(timeseries, times, val, val2, record->numSamples);
+            if (tsSt != TS_ST_OK)
+            {
+                DCGM_LOG_ERROR << "Error " << tsSt << " restoring " << record->numSamples << " samples of field "
+                               << record->fieldId;
+            }
         }
-        else if (nvmlReturn != NVML_SUCCESS)
+        else
         {
-            PRINT_ERROR("%d %d",
-                        "ManageDeviceEvents: nvmlDeviceRegisterEvents returned %d for gpuId %d",
-                        (int)nvmlReturn,
-                        (int)gpuId);
-            return NvmlReturnToDcgmReturn(nvmlReturn);
+            char const *cursor = (char const *)(record + 1);
+            for (int i = 0; i < record->numSamples; i++)
+            {
+                dcgm_cache_snapshot_var_t const *var = (dcgm_cache_snapshot_var_t const *)cursor;
+                void *value                          = (void *)(var + 1);
+
+                if (record->tsType == TS_TYPE_STRING)
+                    timeseries_insert_string(timeseries, var->timestamp, (char *)value);
+                else
+                    timeseries_insert_blob(timeseries, var->timestamp, value, (int)var->size);
+                cursor += DcgmCacheSnapshotVarSize(var->size);
+            }
         }
 
-        PRINT_DEBUG("%d %llX", "Set nvmlIndex %d event mask to x%llX", gpuId, desiredEvents[gpuId]);
+        timelib64_t maxAgeUsec = watchInfo->maxAgeUsec ? watchInfo->maxAgeUsec : m_maxSampleAgeUsec;
+        EnforceWatchInfoQuota(watchInfo, now, now - maxAgeUsec);
 
-        m_currentEventMask[gpuId] = desiredEvents[gpuId];
+        numRestored++;
+        numSamples += record->numSamples;
     }
 
+    DCGM_LOG_INFO << "Restored " << numSamples << " samples of " << numRestored << " watches from " << filename
+                  << " saved " << (now - header->savedUsec) / 1000 << " ms ago. Skipped " << numSkipped
+                  << " watches";
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-bool DcgmCacheManager::DriverVersionIsAtLeast(std::string const &compareVersion)
+dcgmGpuBrandType_t DcgmCacheManager::GetGpuBrand(unsigned int gpuId)
 {
-    DcgmLockGuard dlg = DcgmLockGuard(m_mutex);
-    return m_driverVersion >= compareVersion;
-}
+    if (gpuId >= m_numGpus)
+        return DCGM_GPU_BRAND_UNKNOWN;
+
+    return m_gpus[gpuId].brand;
+}
 
 /*****************************************************************************/
-void DcgmCacheManager::ReadAndCacheDriverVersions(void)
+void DcgmCacheManager::EntityIdToWatchKey(dcgmcm_entity_key_t *watchKey,
+                                          dcgm_field_entity_group_t entityGroupId,
+                                          dcgm_field_eid_t entityId,
+                                          unsigned int fieldId)
 {
-    char driverVersion[NVML_SYSTEM_DRIVER_VERSION_BUFFER_SIZE] = { 0 };
+    if (!watchKey)
+        return;
 
-    nvmlReturn_t nvmlReturn = nvmlSystemGetDriverVersion(driverVersion, sizeof(driverVersion));
-    if (NVML_SUCCESS != nvmlReturn)
+    watchKey->entityId      = entityId;
+    watchKey->entityGroupId = entityGroupId;
+    watchKey->fieldId       = fieldId;
+}
+
+/*****************************************************************************/
+DcgmCacheArena *DcgmCacheManager::GetWatchArena(dcgmcm_entity_key_t const &entityKey)
+{
+    if (!m_cacheArenas)
+        return nullptr;
+
+    std::unique_ptr<DcgmCacheArena> *arena = &m_sharedArena;
+    std::optional<unsigned int> gpuId
+        = GetGpuIdForEntity(static_cast<dcgm_field_entity_group_t>(entityKey.entityGroupId), entityKey.entityId);
+    if (gpuId.has_value() && *gpuId < DCGM_MAX_NUM_DEVICES)
+        arena = &m_gpuArenas[*gpuId];
+
+    if (!*arena)
+        *arena = std::make_unique<DcgmCacheArena>(m_cacheArenasUseHugetlb);
+
+    return arena->get();
+}
+
+/*****************************************************************************/
+dcgmcm_watch_info_p DcgmCacheManager::AllocWatchInfo(dcgmcm_entity_key_t entityKey)
+{
+    DcgmCacheArena *arena       = GetWatchArena(entityKey);
+    dcgmcm_watch_info_p retInfo = arena ? arena->New<dcgmcm_watch_info_t>() : nullptr;
+    if (!retInfo)
     {
-        DCGM_LOG_ERROR << "nvmlSystemGetDriverVersion returned " << (int)nvmlReturn << ": "
-                       << nvmlErrorString(nvmlReturn);
-        DcgmLockGuard dlg     = DcgmLockGuard(m_mutex);
-        m_driverVersion       = "";
-        m_driverIsR450OrNewer = false;
-        return;
+        arena   = nullptr; /* Out of arena memory. The heap may still have some */
+        retInfo = new dcgmcm_watch_info_t;
     }
 
-    DcgmLockGuard dlg = DcgmLockGuard(m_mutex);
-    m_driverVersion   = "";
+    retInfo->watchKey              = entityKey;
+    retInfo->isWatched             = 0;
+    retInfo->hasSubscribedWatchers = 0;
+    retInfo->eventPending          = 0;
+    retInfo->lastSampleTimestamp   = 0;
+    retInfo->lastStatus            = NVML_SUCCESS;
+    retInfo->lastQueriedUsec       = 0;
+    retInfo->lastReadUsec          = 0;
+    retInfo->monitorFrequencyUsec  = 0;
+    retInfo->nextUpdateUsec        = 0;
+    retInfo->maxAgeUsec            = 0;
+    retInfo->rawRetentionUsec      = 0;
+    retInfo->execTimeUsec          = 0;
+    retInfo->fetchCount            = 0;
+    retInfo->maxExecTimeUsec       = 0;
+    memset(retInfo->execTimeHistogram, 0, sizeof(retInfo->execTimeHistogram));
+    memset(retInfo->maxSampleLagUsec, 0, sizeof(retInfo->maxSampleLagUsec));
+    memset(retInfo->sampleLagHistogram, 0, sizeof(retInfo->sampleLagHistogram));
+    retInfo->timeSeries = 0;
+    // Initialize the practical watch information for fields whose data is not retrievable
+    // in all the places where they can be watched. This is relevant for MIG mode.
+    retInfo->practicalEntityGroupId = static_cast<dcgm_field_entity_group_t>(retInfo->watchKey.entityGroupId);
+    retInfo->practicalEntityId      = retInfo->watchKey.entityId;
+    retInfo->rateWatchInfo          = nullptr;
+    retInfo->rateLastCounter        = 0;
+    retInfo->rateLastUsec           = 0;
+    retInfo->snapshotGroupId        = 0;
+    retInfo->adaptiveMean           = 0.0;
+    retInfo->adaptiveVariance       = 0.0;
+    retInfo->adaptiveSamples        = 0;
+    retInfo->adaptiveQuiet          = false;
+    retInfo->arena                  = arena;
+    return retInfo;
+}
 
-    std::string version(driverVersion);
-    version.erase(std::remove(version.begin(), version.end(), '.'), version.end());
-    if (version.empty())
+/*****************************************************************************/
+void DcgmCacheManager::FreeWatchInfo(dcgmcm_watch_info_p watchInfo)
+{
+    if (!watchInfo)
     {
-        PRINT_DEBUG("", "nvmlSystemGetDriverVersion returned an empty string.");
-        m_driverVersion       = "";
-        m_driverIsR450OrNewer = false;
+        PRINT_ERROR("", "FreeWatchInfo got NULL watchInfo");
         return;
     }
 
-    m_driverVersion = version;
-
-    if (DriverVersionIsAtLeast("45000"))
+    if (watchInfo->timeSeries)
     {
-        m_driverIsR450OrNewer = true;
+        timeseries_destroy(watchInfo->timeSeries);
+        watchInfo->timeSeries = 0;
     }
+
+    if (watchInfo->arena)
+        watchInfo->arena->Delete(watchInfo);
     else
-    {
-        m_driverIsR450OrNewer = false;
-    }
+        delete (watchInfo);
+}
 
-    DCGM_LOG_INFO << "Parsed driver string is " << m_driverVersion << ", IsR450OrNewer: " << m_driverIsR450OrNewer;
+/*****************************************************************************/
+void DcgmCacheManager::FreeAllWatchInfos(void)
+{
+    /* Unpublish the lock-free index first so no new reader can find a watch info, then wait
+       for readers that already found one. Both are seq_cst to pair with DcgmcmLockFreeReader */
+    m_watchIndex.store(nullptr);
+    while (m_lockFreeReaders.load() != 0)
+        std::this_thread::yield();
+    m_watchIndexes.clear();
+
+    m_watchSchedule.Clear();
+
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+        FreeWatchInfo(watchInfo);
+    m_entityWatches.Clear();
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::NvmlPreWatch(unsigned int gpuId, unsigned short dcgmFieldId)
+dcgmcm_watch_info_p DcgmCacheManager::GetEntityWatchInfo(dcgm_field_entity_group_t entityGroupId,
+                                                         dcgm_field_eid_t entityId,
+                                                         unsigned int fieldId,
+                                                         int createIfNotExists)
 {
-    nvmlReturn_t nvmlReturn;
-    nvmlDevice_t nvmlDevice     = 0;
-    dcgm_field_meta_p fieldMeta = 0;
-    nvmlEnableState_t enabledState;
+    dcgmcm_watch_info_p retInfo = 0;
+    dcgmMutexReturn_t mutexReturn;
 
-    if (gpuId != (unsigned int)-1 && gpuId >= m_numGpus)
-    {
-        PRINT_ERROR("%u %u", "NvmlPreWatch: gpuId %u too high. We've detected %u GPUs", gpuId, m_numGpus);
-        return DCGM_ST_GENERIC_ERROR;
-    }
+    mutexReturn = dcgm_mutex_lock_me(m_mutex);
 
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-        return DCGM_ST_UNKNOWN_FIELD;
+    /* Global watches have no entityId */
+    if (entityGroupId == DCGM_FE_NONE)
+        entityId = 0;
 
-    if (fieldMeta->scope != DCGM_FS_GLOBAL)
+    retInfo = m_entityWatches.Get(entityGroupId, entityId, fieldId);
+    if (!retInfo)
     {
-        if (m_gpus[gpuId].status == DcgmEntityStatusFake)
+        if (!createIfNotExists)
         {
-            PRINT_DEBUG("%u %u", "Skipping NvmlPreWatch for fieldId %u, fake gpuId %u", dcgmFieldId, gpuId);
-            return DCGM_ST_OK;
+            if (mutexReturn == DCGM_MUTEX_ST_OK)
+                dcgm_mutex_unlock(m_mutex);
+            PRINT_DEBUG("%u %u %u",
+                        "watch key eg %u, eid %u, fieldId %u doesn't exist. createIfNotExists == false",
+                        entityGroupId,
+                        entityId,
+                        fieldId);
+            return NULL;
         }
 
-        nvmlReturn = nvmlDeviceGetHandleByIndex_v2(m_gpus[gpuId].nvmlIndex, &nvmlDevice);
-        if (nvmlReturn != NVML_SUCCESS)
+        /* Allocate a new one */
+        PRINT_DEBUG("%u %u %u",
+                    "Adding WatchInfo on eg %u, entityId %u, fieldId %u",
+                    entityGroupId,
+                    entityId,
+                    fieldId);
+        dcgmcm_entity_key_t addKey;
+        EntityIdToWatchKey(&addKey, entityGroupId, entityId, fieldId);
+        retInfo = AllocWatchInfo(addKey);
+        if (!m_entityWatches.Insert(entityGroupId, entityId, fieldId, retInfo))
         {
-            PRINT_ERROR("%d %u",
-                        "NvmlPreWatch: nvmlDeviceGetHandleByIndex_v2 returned %d for gpuId %u",
-                        (int)nvmlReturn,
-                        gpuId);
-            return NvmlReturnToDcgmReturn(nvmlReturn);
+            PRINT_ERROR("%u %u %u",
+                        "Unable to index watch eg %u, entityId %u, fieldId %u. Out of range?",
+                        entityGroupId,
+                        entityId,
+                        fieldId);
+            FreeWatchInfo(retInfo);
+            retInfo = 0;
+        }
+        else
+        {
+            AddToWatchIndex(retInfo);
+            /* Size pooled fv buffers for one value from every watch per cycle */
+            m_fvBufferPool->SetCapacityHint(FVBUFFER_GUESS_INITIAL_CAPACITY(1, m_entityWatches.Size()));
         }
     }
 
-    switch (dcgmFieldId)
-    {
-        case DCGM_FI_DEV_ACCOUNTING_DATA:
-            nvmlReturn = nvmlDeviceGetAccountingMode(nvmlDevice, &enabledState);
-            if (nvmlReturn == NVML_ERROR_NOT_SUPPORTED)
-            {
-                DCGM_LOG_WARNING << "Accounting mode is not supported for gpuId " << gpuId;
-                break;
-            }
-            else if (nvmlReturn != NVML_SUCCESS)
-            {
-                PRINT_ERROR("%d %d", "nvmlDeviceGetAccountingMode returned %d for gpuId %u", (int)nvmlReturn, gpuId);
-                return DCGM_ST_NVML_ERROR;
-            }
-            if (enabledState == NVML_FEATURE_ENABLED)
-            {
-                PRINT_DEBUG("%u", "Accounting is already enabled for gpuId %u", gpuId);
-                break;
-            }
-
-            /* Enable accounting */
-            nvmlReturn = nvmlDeviceSetAccountingMode(nvmlDevice, NVML_FEATURE_ENABLED);
-            if (nvmlReturn == NVML_ERROR_NOT_SUPPORTED)
-            {
-                DCGM_LOG_DEBUG << "Accounting mode is not supported for gpuId " << gpuId;
-                break;
-            }
-            else if (nvmlReturn == NVML_ERROR_NO_PERMISSION)
-            {
-                PRINT_DEBUG("%d", "nvmlDeviceSetAccountingMode() got no permission. running as uid %d", geteuid());
-                return DCGM_ST_REQUIRES_ROOT;
-            }
-            else if (nvmlReturn != NVML_SUCCESS)
-            {
-                PRINT_ERROR("%d %u", "nvmlDeviceSetAccountingMode returned %d for gpuId %u", (int)nvmlReturn, gpuId);
-                return DCGM_ST_NVML_ERROR;
-            }
-
-            PRINT_DEBUG("%u", "nvmlDeviceSetAccountingMode successful for gpuId %u", gpuId);
-            break;
+    if (mutexReturn == DCGM_MUTEX_ST_OK)
+        dcgm_mutex_unlock(m_mutex);
 
-        case DCGM_FI_DEV_XID_ERRORS:
-        case DCGM_FI_DEV_GPU_NVLINK_ERRORS:
-            ManageDeviceEvents(gpuId, dcgmFieldId);
-            break;
+    return retInfo;
+}
 
-        default:
-            /* Nothing to do */
-            break;
-    }
+/*****************************************************************************/
+/*
+ * Get the first slot to probe for watchKey in a dcgmcm_watch_index_t with
+ * 2^capacityLog2 slots. This is a Fibonacci hash of the packed 8-byte key
+ */
+static unsigned int DcgmcmWatchIndexSlot(dcgmcm_entity_key_t const &watchKey, unsigned int capacityLog2)
+{
+    static_assert(sizeof(watchKey) == sizeof(unsigned long long), "dcgmcm_entity_key_t must be 8 bytes");
+    unsigned long long packedKey;
 
-    return DCGM_ST_OK;
+    memcpy(&packedKey, &watchKey, sizeof(packedKey));
+    return (unsigned int)((packedKey * 0x9E3779B97F4A7C15ULL) >> (64 - capacityLog2));
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::NvmlPostWatch(unsigned int gpuId, unsigned short dcgmFieldId)
+static void DcgmcmWatchIndexInsert(dcgmcm_watch_index_t *index, dcgmcm_watch_info_p watchInfo)
 {
-    switch (dcgmFieldId)
-    {
-        case DCGM_FI_DEV_XID_ERRORS:
-        case DCGM_FI_DEV_GPU_NVLINK_ERRORS:
-            ManageDeviceEvents(DCGM_GPU_ID_BAD, 0);
-            break;
+    unsigned int mask = (1U << index->capacityLog2) - 1;
+    unsigned int slot = DcgmcmWatchIndexSlot(watchInfo->watchKey, index->capacityLog2);
 
-        default:
-            /* Nothing to do */
-            break;
-    }
+    while (index->slots[slot].load(std::memory_order_relaxed) != nullptr)
+        slot = (slot + 1) & mask;
 
-    return DCGM_ST_OK;
+    /* Release so that readers who find watchInfo also see its watchKey */
+    index->slots[slot].store(watchInfo, std::memory_order_release);
+    index->count++;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AddFieldWatch(dcgm_field_entity_group_t entityGroupId,
-                                             dcgm_field_eid_t entityId,
-                                             unsigned short dcgmFieldId,
-                                             timelib64_t monitorFrequencyUsec,
-                                             double maxSampleAge,
-                                             int maxKeepSamples,
-                                             DcgmWatcher watcher,
-                                             bool subscribeForUpdates)
+void DcgmCacheManager::AddToWatchIndex(dcgmcm_watch_info_p watchInfo)
 {
-    dcgm_field_meta_p fieldMeta = 0;
+    dcgmcm_watch_index_t *index = m_watchIndex.load(std::memory_order_relaxed);
 
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-        return DCGM_ST_UNKNOWN_FIELD;
-
-    if (fieldMeta->scope == DCGM_FS_GLOBAL && entityGroupId != DCGM_FE_NONE)
+    /* Keep the load factor at or below 1/2 so probe sequences stay short and
+       always end at an empty slot */
+    if (index && (index->count + 1) * 2 <= (1U << index->capacityLog2))
     {
-        PRINT_WARNING("", "Fixing global field watch to be correct scope.");
-        entityGroupId = DCGM_FE_NONE;
+        DcgmcmWatchIndexInsert(index, watchInfo);
+        return;
     }
 
-    /* Trigger the update loop to buffer updates from now on */
-    if (subscribeForUpdates)
-        m_haveAnyLiveSubscribers = true;
+    auto newIndex          = std::make_unique<dcgmcm_watch_index_t>();
+    newIndex->capacityLog2 = index ? index->capacityLog2 + 1 : DCGM_CM_WATCH_INDEX_MIN_CAPACITY_LOG2;
+    newIndex->count        = 0;
 
-    if (entityGroupId != DCGM_FE_NONE)
-    {
-        return AddEntityFieldWatch(entityGroupId,
-                                   entityId,
-                                   dcgmFieldId,
-                                   monitorFrequencyUsec,
-                                   maxSampleAge,
-                                   maxKeepSamples,
-                                   watcher,
-                                   subscribeForUpdates);
-    }
-    else
+    unsigned int capacity = 1U << newIndex->capacityLog2;
+    newIndex->slots.reset(new std::atomic<dcgmcm_watch_info_p>[capacity]);
+    for (unsigned int i = 0; i < capacity; i++)
+        newIndex->slots[i].store(nullptr, std::memory_order_relaxed);
+
+    if (index)
     {
-        return AddGlobalFieldWatch(
-            dcgmFieldId, monitorFrequencyUsec, maxSampleAge, maxKeepSamples, watcher, subscribeForUpdates);
+        for (unsigned int i = 0; i < (1U << index->capacityLog2); i++)
+        {
+            dcgmcm_watch_info_p existing = index->slots[i].load(std::memory_order_relaxed);
+            if (existing)
+                DcgmcmWatchIndexInsert(newIndex.get(), existing);
+        }
     }
+
+    DcgmcmWatchIndexInsert(newIndex.get(), watchInfo);
+
+    /* Readers may still be searching the old index, so it's retired rather than freed */
+    m_watchIndex.store(newIndex.get(), std::memory_order_release);
+    m_watchIndexes.push_back(std::move(newIndex));
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetFieldWatchFreq(unsigned int gpuId, unsigned short fieldId, timelib64_t *freqUsec)
+/* Counts the calling thread in m_lockFreeReaders while in scope. The increment and the
+   load of m_watchIndex after it are seq_cst so that FreeAllWatchInfos() either sees this
+   reader or this reader sees the unpublished index */
+class DcgmcmLockFreeReader
 {
-    dcgmcm_watch_info_p watchInfo = 0;
-
-    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
-    if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
+public:
+    explicit DcgmcmLockFreeReader(std::atomic<unsigned int> &readers)
+        : m_readers(readers)
     {
-        PRINT_ERROR("%u", "%u is not a valid field ID", fieldId);
-        return DCGM_ST_UNKNOWN_FIELD;
+        m_readers.fetch_add(1);
     }
 
-    if (fieldMeta->scope == DCGM_FS_DEVICE)
+    ~DcgmcmLockFreeReader()
     {
-        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, fieldMeta->fieldId, 0);
-    }
-    else
-    {
-        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+        m_readers.fetch_sub(1, std::memory_order_release);
     }
 
-    *freqUsec = 0;
-
-    if (watchInfo)
-        *freqUsec = watchInfo->monitorFrequencyUsec;
+    DcgmcmLockFreeReader(DcgmcmLockFreeReader const &) = delete;
+    DcgmcmLockFreeReader &operator=(DcgmcmLockFreeReader const &) = delete;
 
-    return DCGM_ST_OK;
-}
+private:
+    std::atomic<unsigned int> &m_readers;
+};
 
 /*****************************************************************************/
-timelib64_t DcgmCacheManager::GetMaxAgeUsec(timelib64_t monitorFrequencyUsec, double maxAgeSeconds, int maxKeepSamples)
+dcgmcm_watch_info_p DcgmCacheManager::LookupWatchIndex(dcgmcm_entity_key_t const &watchKey)
 {
-    timelib64_t maxAgeUsec;
-    timelib64_t maxKeepSamplesInUsec;
-
-    /* Either value can be 0, which is null */
-
-    if (maxAgeSeconds == 0.0)
-        return (timelib64_t)maxKeepSamples * monitorFrequencyUsec;
+    dcgmcm_watch_index_t *index = m_watchIndex.load();
+    if (!index)
+        return nullptr;
 
-    maxAgeUsec = (timelib64_t)(maxAgeSeconds * 1000000.0);
-
-    if (!maxKeepSamples)
-        return maxAgeUsec;
+    unsigned int mask = (1U << index->capacityLog2) - 1;
+    unsigned int slot = DcgmcmWatchIndexSlot(watchKey, index->capacityLog2);
 
-    /* Both values are nonzero. Use the most restrictive of the two */
-    maxKeepSamplesInUsec = (timelib64_t)maxKeepSamples * monitorFrequencyUsec;
+    for (;; slot = (slot + 1) & mask)
+    {
+        dcgmcm_watch_info_p watchInfo = index->slots[slot].load(std::memory_order_acquire);
+        if (!watchInfo)
+            return nullptr;
 
-    return DCGM_MIN(maxKeepSamplesInUsec, maxAgeUsec);
+        if (watchInfo->watchKey.entityId == watchKey.entityId && watchInfo->watchKey.fieldId == watchKey.fieldId
+            && watchInfo->watchKey.entityGroupId == watchKey.entityGroupId)
+            return watchInfo;
+    }
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::UpdateFieldWatch(dcgmcm_watch_info_p watchInfo,
-                                                timelib64_t monitorFrequencyUsec,
-                                                double maxAgeSec,
-                                                int maxKeepSamples,
-                                                DcgmWatcher watcher)
+void DcgmCacheManager::IndexAccountingStats(dcgmcm_watch_info_p watchInfo,
+                                            dcgmDevicePidAccountingStats_t const *stats,
+                                            timelib64_t timestamp)
 {
-    if (!watchInfo)
-        return DCGM_ST_BADPARAM;
+    /* The time series moves a record forward past others with the same timestamp.
+       Records are normally appended, so the newest entry tells us where it landed */
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = timeseries_last(watchInfo->timeSeries, &cursor);
+    if (entry && entry->val.ptr && ((dcgmDevicePidAccountingStats_t *)entry->val.ptr)->pid == stats->pid)
+        timestamp = entry->usecSince1970;
 
-    dcgm_mutex_lock(m_mutex);
+    dcgmcm_accounting_entry_t &latest
+        = m_latestAccountingStats[DcgmcmAccountingKey(watchInfo->watchKey.entityId, stats->pid)];
+    latest.timestamp = timestamp;
+    latest.stats     = *stats;
 
-    if (!watchInfo->isWatched)
+    if (watchInfo->watchKey.entityId < DCGM_MAX_NUM_DEVICES && stats->startTimestamp > 0)
     {
-        dcgm_mutex_unlock(m_mutex);
-        return DCGM_ST_NOT_WATCHED;
+        timelib64_t startUsec = (timelib64_t)stats->startTimestamp;
+        timelib64_t endUsec   = stats->activeTimeUsec == 0 ? 0 : startUsec + (timelib64_t)stats->activeTimeUsec;
+        m_processIntervals[watchInfo->watchKey.entityId][0].Set(stats->pid, startUsec, endUsec);
     }
-
-    watchInfo->monitorFrequencyUsec = monitorFrequencyUsec;
-    watchInfo->maxAgeUsec           = GetMaxAgeUsec(monitorFrequencyUsec, maxAgeSec, maxKeepSamples);
-
-    dcgm_mutex_unlock(m_mutex);
-    return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmCacheManager::IsGpuFieldWatched(unsigned int gpuId, unsigned short dcgmFieldId, bool *isWatched)
+/*****************************************************************************/
+int DcgmCacheManager::ProcessIntervalsIndex(unsigned short fieldId)
 {
-    dcgm_field_meta_p fieldMeta   = 0;
-    dcgmcm_watch_info_p watchInfo = 0;
-
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
+    switch (fieldId)
     {
-        PRINT_ERROR("%u", "dcgmFieldId does not exist: %d", dcgmFieldId);
-        return DCGM_ST_UNKNOWN_FIELD;
+        case DCGM_FI_DEV_ACCOUNTING_DATA:
+            return 0;
+        case DCGM_FI_DEV_COMPUTE_PIDS:
+            return 1;
+        case DCGM_FI_DEV_GRAPHICS_PIDS:
+            return 2;
+        default:
+            return -1;
     }
+}
 
-    if (fieldMeta->scope != DCGM_FS_DEVICE)
-    {
-        PRINT_ERROR("%u %d %d",
-                    "field ID %u has scope %d but this function only works for DEVICE (%d) scope fields",
-                    dcgmFieldId,
-                    fieldMeta->scope,
-                    DCGM_FS_DEVICE);
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetProcessesInWindow(unsigned int gpuId,
+                                                    unsigned short fieldId,
+                                                    timelib64_t startTime,
+                                                    timelib64_t endTime,
+                                                    std::vector<dcgm_process_interval_t> &intervals)
+{
+    int index = ProcessIntervalsIndex(fieldId);
+    if (gpuId >= DCGM_MAX_NUM_DEVICES || index < 0)
         return DCGM_ST_BADPARAM;
-    }
 
-    *isWatched = false;
-    watchInfo  = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, dcgmFieldId, 0);
-    if (watchInfo)
-        *isWatched = watchInfo->isWatched;
+    DcgmLockGuard dlg(m_mutex);
+
+    intervals.clear();
+    m_processIntervals[gpuId][index].Query(startTime, endTime, intervals);
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmCacheManager::IsGpuFieldWatchedOnAnyGpu(unsigned short fieldId, bool *isWatched)
+/*****************************************************************************/
+void DcgmCacheManager::IndexPidSample(unsigned int gpuId,
+                                      unsigned short fieldId,
+                                      unsigned int pid,
+                                      timelib64_t timestamp,
+                                      double util)
 {
-    dcgmReturn_t st;
+    if (gpuId >= DCGM_MAX_NUM_DEVICES)
+        return;
 
-    if (isWatched == NULL)
+    int utilIndex = -1;
+    if (fieldId == DCGM_FI_DEV_GPU_UTIL_SAMPLES)
+        utilIndex = 0;
+    else if (fieldId == DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES)
+        utilIndex = 1;
+
+    /* Every process's samples count towards the averages of the processes running alongside it */
+    unsigned long long sampleNumber = 0;
+    if (utilIndex >= 0)
+        sampleNumber = ++m_processUtilSampleCounts[gpuId][utilIndex];
+
+    /* Samples without a process */
+    if (pid == 0 || pid == std::numeric_limits<unsigned>::max())
+        return;
+
+    std::vector<dcgmcm_pid_gpu_stats_t> &gpus = m_pidStats[pid];
+    auto gpuStats = std::find_if(gpus.begin(), gpus.end(), [gpuId](dcgmcm_pid_gpu_stats_t const &gpuStats) {
+        return gpuStats.gpuId == gpuId;
+    });
+    if (gpuStats == gpus.end())
     {
-        PRINT_ERROR("", "arg cannot be NULL");
-        return DCGM_ST_BADPARAM;
+        dcgmcm_pid_gpu_stats_t newStats {};
+        newStats.gpuId         = gpuId;
+        newStats.firstSeenUsec = timestamp;
+        gpus.push_back(newStats);
+        gpuStats = gpus.end() - 1;
     }
 
-    std::vector<unsigned int> gpuIds;
-    this->GetGpuIds(1, gpuIds);
+    gpuStats->firstSeenUsec = std::min(gpuStats->firstSeenUsec, timestamp);
+    gpuStats->lastSeenUsec  = std::max(gpuStats->lastSeenUsec, timestamp);
 
-    for (size_t i = 0; i < gpuIds.size(); ++i)
+    if (utilIndex < 0)
     {
-        unsigned int gpuId = gpuIds.at(i);
-        st                 = IsGpuFieldWatched(gpuId, fieldId, isWatched);
-        if (DCGM_ST_OK != st)
-            return st;
+        gpuStats->haveAccounting = true;
+        return;
+    }
 
-        if (*isWatched == true)
-            break;
+    bool &haveUtil             = utilIndex == 0 ? gpuStats->haveSmUtil : gpuStats->haveMemUtil;
+    dcgmcm_pid_util_t &pidUtil = utilIndex == 0 ? gpuStats->smUtil : gpuStats->memUtil;
+    if (!haveUtil)
+    {
+        haveUtil                  = true;
+        pidUtil.firstSampleNumber = sampleNumber - 1;
     }
+    pidUtil.utilSum += util;
+    pidUtil.lastSampleNumber = sampleNumber;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetPidStats(unsigned int pid, std::vector<dcgmcm_pid_gpu_stats_t> &stats)
+{
+    DcgmLockGuard dlg(m_mutex);
+
+    stats.clear();
+    auto pidStats = m_pidStats.find(pid);
+    if (pidStats == m_pidStats.end())
+        return DCGM_ST_NO_DATA;
 
+    stats = pidStats->second;
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmCacheManager::IsGlobalFieldWatched(unsigned short dcgmFieldId, bool *isWatched)
+/*****************************************************************************/
+dcgmDevicePidAccountingStats_t const *DcgmCacheManager::FindCachedAccountingStats(unsigned int gpuId,
+                                                                                  unsigned int pid,
+                                                                                  dcgmcm_watch_info_p watchInfo)
 {
-    dcgm_field_meta_p fieldMeta   = 0;
-    dcgmcm_watch_info_p watchInfo = 0;
+    auto latest = m_latestAccountingStats.find(DcgmcmAccountingKey(gpuId, pid));
+    if (latest == m_latestAccountingStats.end() || !watchInfo || !watchInfo->timeSeries)
+        return nullptr;
 
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-    {
-        PRINT_ERROR("%u", "dcgmFieldId does not exist: %d", dcgmFieldId);
-        return DCGM_ST_UNKNOWN_FIELD;
-    }
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = timeseries_find(watchInfo->timeSeries, latest->second.timestamp, TS_LGE_EQUAL, &cursor);
+    if (!entry || !entry->val.ptr || ((dcgmDevicePidAccountingStats_t *)entry->val.ptr)->pid != pid)
+        return nullptr; /* Aged out of the time series */
 
-    if (fieldMeta->scope != DCGM_FS_GLOBAL)
+    return (dcgmDevicePidAccountingStats_t const *)entry->val.ptr;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::EmptyAccountingPidCache(void)
+{
+    PRINT_DEBUG("", "Pid seen cache emptied");
+    DcgmLockGuard dlg(m_mutex);
+    m_latestAccountingStats.clear();
+    m_pidStats.clear();
+    memset(m_processUtilSampleCounts, 0, sizeof(m_processUtilSampleCounts));
+    for (auto &gpuIntervals : m_processIntervals)
     {
-        PRINT_ERROR("%u %d %d",
-                    "field ID %u has scope %d but this function only works for GLOBAL (%d) scope fields",
-                    dcgmFieldId,
-                    fieldMeta->scope,
-                    DCGM_FS_GLOBAL);
-        return DCGM_ST_BADPARAM;
+        for (DcgmProcessIntervals &intervals : gpuIntervals)
+            intervals = DcgmProcessIntervals();
     }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::EmptyCache(void)
+{
+    dcgm_mutex_lock(m_mutex);
+    ClearAllEntities(1);
+    EmptyAccountingPidCache();
+    dcgm_mutex_unlock(m_mutex);
 
-    *isWatched = false;
-    watchInfo  = GetGlobalWatchInfo(dcgmFieldId, 0);
-    if (watchInfo)
-        *isWatched = watchInfo->isWatched;
     return DCGM_ST_OK;
 }
 
-bool DcgmCacheManager::AnyGlobalFieldsWatched(std::vector<unsigned short> *fieldIds)
+/*********************************f********************************************/
+int DcgmCacheManager::GpuIdToNvmlIndex(unsigned int gpuId)
 {
-    dcgmReturn_t st;
+    /* Treat as index for now. Just bounds check it */
+    if (gpuId >= m_numGpus)
+        return DCGM_ST_BADPARAM;
+    else
+        return m_gpus[gpuId].nvmlIndex;
+}
 
-    if (fieldIds == NULL)
+/*********************************f********************************************/
+unsigned int DcgmCacheManager::NvmlIndexToGpuId(int nvmlIndex)
+{
+    for (unsigned int i = 0; i < m_numGpus; i++)
     {
-        fieldIds = &this->m_allValidFieldIds;
+        if (m_gpus[i].nvmlIndex == (unsigned int)nvmlIndex)
+            return m_gpus[i].gpuId;
     }
 
-    for (size_t i = 0; i < fieldIds->size(); ++i)
-    {
-        unsigned short fieldId = fieldIds->at(i);
+    PRINT_ERROR("%d %d", "nvmlIndex %d not found in %u gpus", nvmlIndex, m_numGpus);
+    return 0;
+}
 
-        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+/*********************************f********************************************/
+dcgmReturn_t DcgmCacheManager::Start(void)
+{
+    int st = DcgmThread::Start();
 
-        // silently skip invalid fields
-        if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
-        {
-            continue;
-        }
+    if (st)
+        return DCGM_ST_GENERIC_ERROR;
+    else
+        return DCGM_ST_OK;
+}
 
-        if (fieldMeta->scope != DCGM_FS_GLOBAL)
-        {
-            continue;
-        }
+/*********************************f********************************************/
+DcgmEntityStatus_t DcgmCacheManager::GetGpuStatus(unsigned int gpuId)
+{
+    PRINT_DEBUG("%d", "Checking status for gpu %d", gpuId);
+    if (gpuId >= m_numGpus)
+        return DcgmEntityStatusUnknown;
 
-        bool isWatched;
-        st = this->IsGlobalFieldWatched(fieldId, &isWatched);
-        if (DCGM_ST_OK != st)
-        {
-            continue;
-        }
+    return m_gpus[gpuId].status;
+}
 
-        if (isWatched)
-        {
-            return true;
-        }
-    }
+/******************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetGpuArch(unsigned int gpuId, dcgmChipArchitecture_t &arch)
+{
+    if (gpuId >= m_numGpus)
+        return DCGM_ST_BADPARAM;
 
-    return false;
+    arch = m_gpus[gpuId].arch;
+
+    return DCGM_ST_OK;
 }
 
-bool DcgmCacheManager::AnyFieldsWatched(std::vector<unsigned short> *fieldIds)
+/*********************************f********************************************/
+dcgmReturn_t DcgmCacheManager::PauseGpu(unsigned int gpuId)
 {
-    if (fieldIds == NULL)
+    if (gpuId >= m_numGpus)
+        return DCGM_ST_BADPARAM;
+
+    switch (m_gpus[gpuId].status)
     {
-        fieldIds = &this->m_allValidFieldIds;
+        case DcgmEntityStatusDisabled:
+        case DcgmEntityStatusUnknown:
+        default:
+            /* Nothing to do */
+            return DCGM_ST_OK;
+
+        case DcgmEntityStatusOk:
+            /* Pause the GPU */
+            PRINT_INFO("%d", "gpuId %d PAUSED.", gpuId);
+            m_gpus[gpuId].status = DcgmEntityStatusDisabled;
+            /* Force an update to occur so that we get blank values saved */
+            (void)UpdateAllFields(1);
+            return DCGM_ST_OK;
     }
+}
 
-    dcgmReturn_t st = DCGM_ST_OK;
-    bool isWatched  = false;
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::ResumeGpu(unsigned int gpuId)
+{
+    if (gpuId >= m_numGpus)
+        return DCGM_ST_BADPARAM;
 
-    for (size_t i = 0; i < fieldIds->size(); ++i)
+    switch (m_gpus[gpuId].status)
     {
-        unsigned short fieldId = fieldIds->at(i);
+        case DcgmEntityStatusOk:
+        case DcgmEntityStatusUnknown:
+        default:
+            /* Nothing to do */
+            return DCGM_ST_OK;
 
-        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
-        if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
-            continue;
+        case DcgmEntityStatusDisabled:
+            /* Pause the GPU */
+            PRINT_INFO("%d", "gpuId %d RESUMED.", gpuId);
+            m_gpus[gpuId].status = DcgmEntityStatusOk;
+            return DCGM_ST_OK;
+    }
 
-        if (fieldMeta->scope == DCGM_FS_GLOBAL)
-        {
-            st = IsGlobalFieldWatched(fieldId, &isWatched);
-        }
-        else if (fieldMeta->scope == DCGM_FS_DEVICE)
-        {
-            st = IsGpuFieldWatchedOnAnyGpu(fieldId, &isWatched);
-        }
+    return DCGM_ST_OK;
+}
 
-        if (DCGM_ST_OK == st && isWatched)
-            return true;
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::Pause()
+{
+    for (unsigned int i = 0; i < m_numGpus; i++)
+    {
+        if (m_gpus[i].status > DcgmEntityStatusUnknown && m_gpus[i].status != DcgmEntityStatusDetached)
+            PauseGpu(m_gpus[i].gpuId);
     }
 
-    return false;
+    return DCGM_ST_OK;
 }
 
-bool DcgmCacheManager::AnyGpuFieldsWatchedAnywhere(std::vector<unsigned short> *fieldIds)
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::Resume()
 {
-    std::vector<unsigned int> gpuIds;
-    dcgmReturn_t st = GetGpuIds(1, gpuIds);
-    if (DCGM_ST_OK != st)
-        return false;
-
-    for (size_t i = 0; i < gpuIds.size(); ++i)
+    for (unsigned int i = 0; i < m_numGpus; i++)
     {
-        unsigned int gpuId = gpuIds.at(i);
-        if (AnyGpuFieldsWatched(gpuId, fieldIds))
-        {
-            return true;
-        }
+        if (m_gpus[i].status > DcgmEntityStatusUnknown && m_gpus[i].status != DcgmEntityStatusDetached)
+            ResumeGpu(m_gpus[i].gpuId);
     }
 
-    return false;
+    return DCGM_ST_OK;
 }
 
-bool DcgmCacheManager::AnyGpuFieldsWatched(unsigned int gpuId, std::vector<unsigned short> *fieldIds)
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::UpdateAllFields(int waitForUpdate)
 {
-    dcgmReturn_t st;
+    long long waitForFinishedCycle = 0;
+    unsigned int sleepAtATimeMs    = 1000;
 
-    if (fieldIds == NULL)
-    {
-        fieldIds = &this->m_allValidFieldIds;
-    }
+    dcgm_mutex_lock(m_mutex);
+    /*
+     * Which cycle should we wait for? If one is in progress, wait for the one
+     * after the current. This can be simplified as wait for the next cycle
+     * that starts to finish
+     */
+    waitForFinishedCycle = m_runStats.updateCycleStarted + 1;
 
-    for (size_t i = 0; i < fieldIds->size(); ++i)
-    {
-        unsigned short fieldId = fieldIds->at(i);
+    /* Other UpdateAllFields could be waiting on this cycle as well, but that's ok.
+     * They would have had to get the lock in between us Unlock()ing below and the
+     * polling loop getting the lock. Either way, we're consistent thanks to the lock */
+    m_runStats.shouldFinishCycle = DCGM_MAX(waitForFinishedCycle, m_runStats.shouldFinishCycle);
 
-        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+    dcgm_mutex_unlock(m_mutex);
+    m_startUpdateCondition.notify_all();
+    // Add some kind of incrementing here.
 
-        // silently skip invalid fields
-        if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
-        {
-            continue;
-        }
+    if (!waitForUpdate)
+        return DCGM_ST_OK; /* We don't care when it finishes. Just return */
 
-        if (fieldMeta->scope != DCGM_FS_DEVICE)
-        {
-            continue;
-        }
+    /* Wait for signals that update loops have completed until the loop we care
+       about has completed */
+    while (m_runStats.updateCycleFinished < waitForFinishedCycle)
+    {
+#ifdef DEBUG_UPDATE_LOOP
+        PRINT_DEBUG("%u %lld %lld",
+                    "Sleeping %u ms. %lld < %lld",
+                    sleepAtATimeMs,
+                    m_runStats.updateCycleFinished,
+                    waitForFinishedCycle);
+#endif
+        dcgm_mutex_lock(m_mutex);
 
-        bool isWatched;
-        st = this->IsGpuFieldWatched(gpuId, fieldId, &isWatched);
-        if (DCGM_ST_OK != st)
+        /* Check the updateCycleFinished one more time, now that we got the lock */
+        if (m_runStats.updateCycleFinished < waitForFinishedCycle)
         {
-            continue;
+            m_mutex->CondWait(m_updateCompleteCondition, sleepAtATimeMs, [this, waitForFinishedCycle] {
+                return not(m_runStats.updateCycleFinished < waitForFinishedCycle) || ShouldStop() != 0;
+            });
+#ifdef DEBUG_UPDATE_LOOP
+            PRINT_DEBUG("%d", "UpdateAllFields() RETURN st %d", st);
         }
-
-        if (isWatched)
+        else
         {
-            return true;
+            PRINT_DEBUG("", "UpdateAllFields() skipped CondWait()");
+#endif
         }
+
+        dcgm_mutex_unlock(m_mutex);
+
+#ifdef DEBUG_UPDATE_LOOP
+        PRINT_DEBUG("%d %lld %lld",
+                    "Woke up to st %d. updateCycleFinished %lld, waitForFinishedCycle %lld",
+                    st,
+                    m_runStats.updateCycleFinished,
+                    waitForFinishedCycle);
+#endif
+
+        /* Make sure we don't get stuck waiting when a shutdown is requested */
+        if (ShouldStop())
+            return DCGM_ST_OK;
     }
 
-    return false;
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::RemoveFieldWatch(dcgm_field_entity_group_t entityGroupId,
-                                                unsigned int entityId,
-                                                unsigned short dcgmFieldId,
-                                                int clearCache,
-                                                DcgmWatcher watcher)
+dcgmReturn_t DcgmCacheManager::ManageDeviceEvents(unsigned int addWatchOnGpuId, unsigned short addWatchOnFieldId)
 {
-    dcgm_field_meta_p fieldMeta = 0;
-
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-        return DCGM_ST_UNKNOWN_FIELD;
+    unsigned long long desiredEvents[DCGM_MAX_NUM_DEVICES] = { 0 };
+    unsigned long long eventsMap                           = nvmlEventTypeXidCriticalError;
+    int somethingChanged;
+    unsigned int gpuId;
+    nvmlReturn_t nvmlReturn;
+    nvmlDevice_t nvmlDevice = 0;
+    dcgmReturn_t ret        = DCGM_ST_OK;
 
-    if (entityGroupId != DCGM_FE_NONE)
-    {
-        return RemoveEntityFieldWatch(entityGroupId, entityId, dcgmFieldId, clearCache, watcher);
-    }
-    else
+    /* First, walk all GPUs to build a bitmask of which event types we care about */
+    somethingChanged = 0;
+    for (gpuId = 0; gpuId < m_numGpus; gpuId++)
     {
-        return RemoveGlobalFieldWatch(dcgmFieldId, clearCache, watcher);
-    }
-}
+        if (m_gpus[gpuId].status == DcgmEntityStatusDetached)
+            continue;
 
+            /* We always subscribe for XIDs so that we have SOMETHING watched. Otherwise,
+           the event thread won't start */
+#if 1
+        if (m_gpus[gpuId].arch >= DCGM_CHIP_ARCH_AMPERE && m_driverIsR450OrNewer && IsGpuMigEnabled(gpuId))
+        {
+            desiredEvents[gpuId] |= eventsMap | nvmlEventMigConfigChange;
+        }
+        else
+        {
+            desiredEvents[gpuId] |= eventsMap;
+        }
 
-/*************************************************************************/
-dcgmReturn_t DcgmCacheManager::RemoveWatcher(dcgmcm_watch_info_p watchInfo, dcgm_watch_watcher_info_t *watcher)
-{
-    std::vector<dcgm_watch_watcher_info_t>::iterator it;
+#else
+        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_XID_ERRORS);
+        if (watchInfo->isWatched || ((gpuId == addWatchOnGpuId) && (addWatchOnFieldId == watchInfo->fieldId)))
+        {
+            PRINT_DEBUG("%u", "gpuId %u wants nvmlEventTypeXidCriticalError", gpuId);
+            desiredEvents[gpuId] |= nvmlEventTypeXidCriticalError;
+        }
+#endif
 
-    for (it = watchInfo->watchers.begin(); it != watchInfo->watchers.end(); ++it)
-    {
-        if ((*it).watcher == watcher->watcher)
+#if 0 /* TODO: DCGM-1419 */
+        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_NVLINK_ERRORS, 1);
+        if(watchInfo->isWatched ||
+           ((gpuId == addWatchOnGpuId) && (addWatchOnFieldId == watchInfo->watchKey.fieldId)))
         {
-            PRINT_DEBUG("%u %u",
-                        "RemoveWatcher removing existing watcher type %u, connectionId %u",
-                        watcher->watcher.watcherType,
-                        watcher->watcher.connectionId);
+            PRINT_DEBUG("%u", "gpuId %u wants nvmlEventTypeNVLinkRecoveryError", gpuId);
+            desiredEvents[gpuId] |= nvmlEventTypeNVLinkRecoveryError;
+            PRINT_DEBUG("%u", "gpuId %u wants nvmlEventTypeNVLinkFatalError", gpuId);
+            desiredEvents[gpuId] |= nvmlEventTypeNVLinkFatalError;
+        }
+#endif
 
-            watchInfo->watchers.erase(it);
-            /* Update the watchInfo frequency and quota now that we removed a watcher */
-            UpdateWatchFromWatchers(watchInfo);
+        /* Fields whose changes the driver reports as events. See SetEventFieldPolling() */
+        if (m_eventFieldPollUsec)
+        {
+            static const unsigned short eventBackedFieldIds[]
+                = { DCGM_FI_DEV_ECC_SBE_VOL_TOTAL, DCGM_FI_DEV_ECC_SBE_AGG_TOTAL, DCGM_FI_DEV_ECC_DBE_VOL_TOTAL,
+                    DCGM_FI_DEV_ECC_DBE_AGG_TOTAL, DCGM_FI_DEV_PSTATE };
+            unsigned long long fieldEvents = 0;
 
-            /* Last watcher? */
-            if (watchInfo->watchers.size() < 1)
+            for (unsigned short fieldId : eventBackedFieldIds)
             {
-                watchInfo->isWatched = 0;
+                dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, fieldId, 0);
+                if ((watchInfo && watchInfo->isWatched) || (gpuId == addWatchOnGpuId && fieldId == addWatchOnFieldId))
+                    fieldEvents |= NvmlEventTypeForField(fieldId);
+            }
 
-                if (watchInfo->watchKey.entityGroupId == DCGM_FE_GPU)
-                {
-                    NvmlPostWatch(GpuIdToNvmlIndex(watchInfo->watchKey.entityId), watchInfo->watchKey.fieldId);
-                }
-                else if (watchInfo->watchKey.entityGroupId == DCGM_FE_NONE)
-                    NvmlPostWatch(-1, watchInfo->watchKey.fieldId);
+            /* Registering an unsupported type fails the whole mask, which would lose the XID events */
+            unsigned long long supportedEvents = 0;
+            if (fieldEvents && nvmlDeviceGetHandleByIndex_v2(GpuIdToNvmlIndex(gpuId), &nvmlDevice) == NVML_SUCCESS
+                && nvmlDeviceGetSupportedEventTypes(nvmlDevice, &supportedEvents) == NVML_SUCCESS)
+            {
+                desiredEvents[gpuId] |= fieldEvents & supportedEvents;
             }
+        }
 
-            return DCGM_ST_OK;
+        if (desiredEvents[gpuId])
+        {
+            PRINT_DEBUG("%u %llX %llX",
+                        "gpuId %u, desiredEvents x%llX, m_currentEventMask x%llX",
+                        gpuId,
+                        desiredEvents[gpuId],
+                        m_currentEventMask[gpuId]);
         }
+
+        if (desiredEvents[gpuId] != m_currentEventMask[gpuId])
+            somethingChanged = 1;
     }
 
-    PRINT_DEBUG("%u %u",
-                "RemoveWatcher() type %u, connectionId %u was not a watcher",
-                watcher->watcher.watcherType,
-                watcher->watcher.connectionId);
-    return DCGM_ST_NOT_WATCHED;
-}
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AddOrUpdateWatcher(dcgmcm_watch_info_p watchInfo,
-                                                  bool *wasAdded,
-                                                  dcgm_watch_watcher_info_t *newWatcher)
-{
-    std::vector<dcgm_watch_watcher_info_t>::iterator it;
+    if (!somethingChanged)
+        return DCGM_ST_OK; /* Nothing to do */
 
-    for (it = watchInfo->watchers.begin(); it != watchInfo->watchers.end(); ++it)
-    {
-        if ((*it).watcher == newWatcher->watcher)
-        {
-            PRINT_DEBUG("%u %u",
-                        "Updating existing watcher type %u, connectionId %u",
-                        newWatcher->watcher.watcherType,
-                        newWatcher->watcher.connectionId);
+    ret = InitializeNvmlEventSet();
+    if (ret != DCGM_ST_OK)
+        return ret;
 
-            *it       = *newWatcher;
-            *wasAdded = false;
-            /* Update the watchInfo frequency and quota now that we updated a watcher */
-            UpdateWatchFromWatchers(watchInfo);
-            return DCGM_ST_OK;
+    for (gpuId = 0; gpuId < m_numGpus; gpuId++)
+    {
+        if (m_gpus[gpuId].status == DcgmEntityStatusDetached)
+            continue;
+
+        // TODO: add a check here to investigate gpuInstanceId and computeInstanceId.
+        /* Did this GPU change? */
+        if (desiredEvents[gpuId] == m_currentEventMask[gpuId])
+            continue;
+
+        nvmlReturn = nvmlDeviceGetHandleByIndex_v2(GpuIdToNvmlIndex(gpuId), &nvmlDevice);
+        if (nvmlReturn != NVML_SUCCESS)
+        {
+            PRINT_ERROR("%d %d",
+                        "ManageDeviceEvents: nvmlDeviceGetHandleByIndex_v2 returned %d for gpuId %d",
+                        (int)nvmlReturn,
+                        (int)gpuId);
+            return NvmlReturnToDcgmReturn(nvmlReturn);
         }
-    }
 
-    PRINT_DEBUG("%u %u",
-                "Adding new watcher type %u, connectionId %u",
-                newWatcher->watcher.watcherType,
-                newWatcher->watcher.connectionId);
+        nvmlReturn = nvmlDeviceRegisterEvents(nvmlDevice, desiredEvents[gpuId], m_nvmlEventSet);
+        if (nvmlReturn == NVML_ERROR_NOT_SUPPORTED)
+        {
+            PRINT_WARNING("%d, %llu",
+                          "ManageDeviceEvents: Desired events are not supported for gpuId: %d. Events mask: %llu",
+                          (int)gpuId,
+                          desiredEvents[gpuId]);
+            continue;
+        }
+        else if (nvmlReturn != NVML_SUCCESS)
+        {
+            PRINT_ERROR("%d %d",
+                        "ManageDeviceEvents: nvmlDeviceRegisterEvents returned %d for gpuId %d",
+                        (int)nvmlReturn,
+                        (int)gpuId);
+            return NvmlReturnToDcgmReturn(nvmlReturn);
+        }
 
-    watchInfo->watchers.push_back(*newWatcher);
-    *wasAdded = true;
+        PRINT_DEBUG("%d %llX", "Set nvmlIndex %d event mask to x%llX", gpuId, desiredEvents[gpuId]);
 
-    /* Update the watchInfo frequency and quota now that we added a watcher */
-    UpdateWatchFromWatchers(watchInfo);
+        m_currentEventMask[gpuId] = desiredEvents[gpuId];
+    }
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::UpdateWatchFromWatchers(dcgmcm_watch_info_p watchInfo)
+bool DcgmCacheManager::DriverVersionIsAtLeast(std::string const &compareVersion)
 {
-    std::vector<dcgm_watch_watcher_info_t>::iterator it;
+    DcgmLockGuard dlg = DcgmLockGuard(m_mutex);
+    return m_driverVersion >= compareVersion;
+}
 
-    it = watchInfo->watchers.begin();
+/*****************************************************************************/
+void DcgmCacheManager::ReadAndCacheDriverVersions(void)
+{
+    char driverVersion[NVML_SYSTEM_DRIVER_VERSION_BUFFER_SIZE] = { 0 };
 
-    if (it == watchInfo->watchers.end())
+    nvmlReturn_t nvmlReturn = nvmlSystemGetDriverVersion(driverVersion, sizeof(driverVersion));
+    if (NVML_SUCCESS != nvmlReturn)
     {
-        watchInfo->hasSubscribedWatchers = 0;
-        return DCGM_ST_NOT_WATCHED;
+        DCGM_LOG_ERROR << "nvmlSystemGetDriverVersion returned " << (int)nvmlReturn << ": "
+                       << nvmlErrorString(nvmlReturn);
+        DcgmLockGuard dlg     = DcgmLockGuard(m_mutex);
+        m_driverVersion       = "";
+        m_driverIsR450OrNewer = false;
+        return;
     }
 
-    /* Don't update watchInfo's value here because we don't want non-locking readers to them in a temporary state */
-    timelib64_t minMonitorFreqUsec = it->monitorFrequencyUsec;
-    timelib64_t minMaxAgeUsec      = it->maxAgeUsec;
-    bool hasSubscribedWatchers     = it->isSubscribed;
+    DcgmLockGuard dlg = DcgmLockGuard(m_mutex);
+    m_driverVersion   = "";
 
-    for (++it; it != watchInfo->watchers.end(); ++it)
+    std::string version(driverVersion);
+    version.erase(std::remove(version.begin(), version.end(), '.'), version.end());
+    if (version.empty())
     {
-        minMonitorFreqUsec = DCGM_MIN(minMonitorFreqUsec, it->monitorFrequencyUsec);
-        minMaxAgeUsec      = DCGM_MIN(minMaxAgeUsec, it->maxAgeUsec);
-        if (it->isSubscribed)
-            hasSubscribedWatchers = 1;
+        PRINT_DEBUG("", "nvmlSystemGetDriverVersion returned an empty string.");
+        m_driverVersion       = "";
+        m_driverIsR450OrNewer = false;
+        return;
     }
 
-    watchInfo->monitorFrequencyUsec  = minMonitorFreqUsec;
-    watchInfo->maxAgeUsec            = minMaxAgeUsec;
-    watchInfo->hasSubscribedWatchers = hasSubscribedWatchers;
+    m_driverVersion = version;
 
-    PRINT_DEBUG("%lld %lld %d",
-                "UpdateWatchFromWatchers minMonitorFreqUsec %lld, minMaxAgeUsec %lld, hsw %d",
-                (long long)minMonitorFreqUsec,
-                (long long)minMaxAgeUsec,
-                watchInfo->hasSubscribedWatchers);
-    return DCGM_ST_OK;
+    if (DriverVersionIsAtLeast("45000"))
+    {
+        m_driverIsR450OrNewer = true;
+    }
+    else
+    {
+        m_driverIsR450OrNewer = false;
+    }
+
+    DCGM_LOG_INFO << "Parsed driver string is " << m_driverVersion << ", IsR450OrNewer: " << m_driverIsR450OrNewer;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AddEntityFieldWatch(dcgm_field_entity_group_t entityGroupId,
-                                                   unsigned int entityId,
-                                                   unsigned short dcgmFieldId,
-                                                   timelib64_t monitorFrequencyUsec,
-                                                   double maxSampleAge,
-                                                   int maxKeepSamples,
-                                                   DcgmWatcher watcher,
-                                                   bool subscribeForUpdates)
+dcgmReturn_t DcgmCacheManager::NvmlPreWatch(unsigned int gpuId, unsigned short dcgmFieldId)
 {
-    dcgmcm_watch_info_p watchInfo;
-    dcgmReturn_t dcgmReturn = DCGM_ST_OK;
-    bool wasAdded           = false;
-    dcgm_watch_watcher_info_t newWatcher;
+    nvmlReturn_t nvmlReturn;
+    nvmlDevice_t nvmlDevice     = 0;
+    dcgm_field_meta_p fieldMeta = 0;
+    nvmlEnableState_t enabledState;
 
-    if (dcgmFieldId >= DCGM_FI_MAX_FIELDS)
-        return DCGM_ST_BADPARAM;
-    else if (dcgmFieldId == DCGM_FI_DEV_INFOROM_CONFIG_CHECK || dcgmFieldId == DCGM_FI_DEV_INFOROM_CONFIG_VALID)
+    if (gpuId != (unsigned int)-1 && gpuId >= m_numGpus)
     {
-        /* For inforom checks, enforce a 30-second minumum to avoid excessive CPU cycles */
-        const timelib64_t minMonitorFrequenceUsec = 30000000;
-        if (monitorFrequencyUsec < minMonitorFrequenceUsec)
-        {
-            DCGM_LOG_DEBUG << "Adjusted logging for eg " << entityGroupId << " eid " << entityId << " fieldId "
-                           << dcgmFieldId << " from " << monitorFrequencyUsec << " to " << minMonitorFrequenceUsec;
-            monitorFrequencyUsec = minMonitorFrequenceUsec;
-        }
+        PRINT_ERROR("%u %u", "NvmlPreWatch: gpuId %u too high. We've detected %u GPUs", gpuId, m_numGpus);
+        return DCGM_ST_GENERIC_ERROR;
     }
 
-    dcgm_field_entity_group_t watchEntityGroupId = entityGroupId;
-    unsigned int watchEntityId                   = entityId;
-
-    /* Populate the cache manager version of watcher so we can insert/update it in this watchInfo's
-       watcher table */
-    newWatcher.watcher              = watcher;
-    newWatcher.monitorFrequencyUsec = monitorFrequencyUsec;
-    newWatcher.maxAgeUsec           = GetMaxAgeUsec(monitorFrequencyUsec, maxSampleAge, maxKeepSamples);
-    newWatcher.isSubscribed         = subscribeForUpdates ? 1 : 0;
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_UNKNOWN_FIELD;
 
-    if (entityGroupId == DCGM_FE_SWITCH)
+    if (fieldMeta->scope != DCGM_FS_GLOBAL)
     {
-        dcgmReturn_t retSt
-            = helperNvSwitchAddFieldWatch(entityGroupId, entityId, dcgmFieldId, monitorFrequencyUsec, watcher);
+        if (m_gpus[gpuId].status == DcgmEntityStatusFake)
+        {
+            PRINT_DEBUG("%u %u", "Skipping NvmlPreWatch for fieldId %u, fake gpuId %u", dcgmFieldId, gpuId);
+            return DCGM_ST_OK;
+        }
 
-        if (retSt != DCGM_ST_OK)
+        nvmlReturn = nvmlDeviceGetHandleByIndex_v2(m_gpus[gpuId].nvmlIndex, &nvmlDevice);
+        if (nvmlReturn != NVML_SUCCESS)
         {
-            DCGM_LOG_ERROR << "Got status " << errorString(retSt) << "(" << retSt << ")"
-                           << " when trying to set watches";
+            PRINT_ERROR("%d %u",
+                        "NvmlPreWatch: nvmlDeviceGetHandleByIndex_v2 returned %d for gpuId %u",
+                        (int)nvmlReturn,
+                        gpuId);
+            return NvmlReturnToDcgmReturn(nvmlReturn);
         }
     }
 
-    DcgmLockGuard dlg(m_mutex);
-
-    watchInfo = GetEntityWatchInfo(watchEntityGroupId, watchEntityId, dcgmFieldId, 1);
-
-    /* New watch? */
-    if (!watchInfo->isWatched && watchEntityGroupId == DCGM_FE_GPU)
+    switch (dcgmFieldId)
     {
-        watchInfo->lastQueriedUsec = 0;
+        case DCGM_FI_DEV_ACCOUNTING_DATA:
+            nvmlReturn = nvmlDeviceGetAccountingMode(nvmlDevice, &enabledState);
+            if (nvmlReturn == NVML_ERROR_NOT_SUPPORTED)
+            {
+                DCGM_LOG_WARNING << "Accounting mode is not supported for gpuId " << gpuId;
+                break;
+            }
+            else if (nvmlReturn != NVML_SUCCESS)
+            {
+                PRINT_ERROR("%d %d", "nvmlDeviceGetAccountingMode returned %d for gpuId %u", (int)nvmlReturn, gpuId);
+                return DCGM_ST_NVML_ERROR;
+            }
+            if (enabledState == NVML_FEATURE_ENABLED)
+            {
+                PRINT_DEBUG("%u", "Accounting is already enabled for gpuId %u", gpuId);
+                break;
+            }
 
-        /* Do the pre-watch first in case it fails */
-        dcgmReturn = NvmlPreWatch(GpuIdToNvmlIndex(watchEntityId), dcgmFieldId);
-        if (dcgmReturn != DCGM_ST_OK)
-        {
-            PRINT_ERROR("%u %u %d",
-                        "NvmlPreWatch eg %u,  eid %u, failed with %d",
-                        watchEntityGroupId,
-                        watchEntityId,
-                        (int)dcgmReturn);
-            return dcgmReturn;
-        }
-    }
+            /* Enable accounting */
+            nvmlReturn = nvmlDeviceSetAccountingMode(nvmlDevice, NVML_FEATURE_ENABLED);
+            if (nvmlReturn == NVML_ERROR_NOT_SUPPORTED)
+            {
+                DCGM_LOG_DEBUG << "Accounting mode is not supported for gpuId " << gpuId;
+                break;
+            }
+            else if (nvmlReturn == NVML_ERROR_NO_PERMISSION)
+            {
+                PRINT_DEBUG("%d", "nvmlDeviceSetAccountingMode() got no permission. running as uid %d", geteuid());
+                return DCGM_ST_REQUIRES_ROOT;
+            }
+            else if (nvmlReturn != NVML_SUCCESS)
+            {
+                PRINT_ERROR("%d %u", "nvmlDeviceSetAccountingMode returned %d for gpuId %u", (int)nvmlReturn, gpuId);
+                return DCGM_ST_NVML_ERROR;
+            }
 
-    /* Add or update the watcher in our table */
-    AddOrUpdateWatcher(watchInfo, &wasAdded, &newWatcher);
+            PRINT_DEBUG("%u", "nvmlDeviceSetAccountingMode successful for gpuId %u", gpuId);
+            break;
 
-    watchInfo->isWatched = 1;
+        case DCGM_FI_DEV_XID_ERRORS:
+        case DCGM_FI_DEV_GPU_NVLINK_ERRORS:
+            ManageDeviceEvents(gpuId, dcgmFieldId);
+            break;
 
-    PRINT_DEBUG("%u %u %u %lld %f %d %d",
-                "AddFieldWatch eg %u, eid %u, fieldId %u, mfu %lld, msa %f, mka %d, sfu %d",
-                watchEntityGroupId,
-                watchEntityId,
-                dcgmFieldId,
-                (long long int)monitorFrequencyUsec,
-                maxSampleAge,
-                maxKeepSamples,
-                subscribeForUpdates ? 1 : 0);
+        case DCGM_FI_DEV_ECC_SBE_VOL_TOTAL:
+        case DCGM_FI_DEV_ECC_SBE_AGG_TOTAL:
+        case DCGM_FI_DEV_ECC_DBE_VOL_TOTAL:
+        case DCGM_FI_DEV_ECC_DBE_AGG_TOTAL:
+        case DCGM_FI_DEV_PSTATE:
+            if (m_eventFieldPollUsec)
+                ManageDeviceEvents(gpuId, dcgmFieldId);
+            break;
+
+        default:
+            /* Nothing to do */
+            break;
+    }
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::RemoveEntityFieldWatch(dcgm_field_entity_group_t entityGroupId,
-                                                      unsigned int entityId,
-                                                      unsigned short dcgmFieldId,
-                                                      int clearCache,
-                                                      DcgmWatcher watcher)
+dcgmReturn_t DcgmCacheManager::NvmlPostWatch(unsigned int gpuId, unsigned short dcgmFieldId)
 {
-    dcgmcm_watch_info_p watchInfo;
-    dcgmMutexReturn_t mutexReturn;
-    dcgm_watch_watcher_info_t remWatcher;
-    dcgmReturn_t retSt = DCGM_ST_OK;
+    switch (dcgmFieldId)
+    {
+        case DCGM_FI_DEV_XID_ERRORS:
+        case DCGM_FI_DEV_GPU_NVLINK_ERRORS:
+            ManageDeviceEvents(DCGM_GPU_ID_BAD, 0);
+            break;
 
-    if (dcgmFieldId >= DCGM_FI_MAX_FIELDS)
-        return DCGM_ST_BADPARAM;
+        case DCGM_FI_DEV_ECC_SBE_VOL_TOTAL:
+        case DCGM_FI_DEV_ECC_SBE_AGG_TOTAL:
+        case DCGM_FI_DEV_ECC_DBE_VOL_TOTAL:
+        case DCGM_FI_DEV_ECC_DBE_AGG_TOTAL:
+        case DCGM_FI_DEV_PSTATE:
+            if (m_eventFieldPollUsec)
+                ManageDeviceEvents(DCGM_GPU_ID_BAD, 0);
+            break;
 
-    /* Populate the cache manager version of watcher so we can remove it in this watchInfo's
-       watcher table */
-    remWatcher.watcher = watcher;
+        default:
+            /* Nothing to do */
+            break;
+    }
 
-    if (entityGroupId == DCGM_FE_SWITCH)
-    {
-        retSt = helperNvSwitchRemoveFieldWatch(watcher);
+    return DCGM_ST_OK;
+}
 
-        if (retSt != DCGM_ST_OK)
-        {
-            DCGM_LOG_ERROR << "Got status " << errorString(retSt) << "(" << retSt << ")"
-                           << " when trying to unset watches";
-        }
-    }
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AddFieldWatch(dcgm_field_entity_group_t entityGroupId,
+                                             dcgm_field_eid_t entityId,
+                                             unsigned short dcgmFieldId,
+                                             timelib64_t monitorFrequencyUsec,
+                                             double maxSampleAge,
+                                             int maxKeepSamples,
+                                             DcgmWatcher watcher,
+                                             bool subscribeForUpdates)
+{
+    dcgm_field_meta_p fieldMeta = 0;
 
-    mutexReturn = dcgm_mutex_lock_me(m_mutex);
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_UNKNOWN_FIELD;
 
-    watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
-    if (!watchInfo)
+    if (fieldMeta->scope == DCGM_FS_GLOBAL && entityGroupId != DCGM_FE_NONE)
     {
-        retSt = DCGM_ST_NOT_WATCHED;
+        PRINT_WARNING("", "Fixing global field watch to be correct scope.");
+        entityGroupId = DCGM_FE_NONE;
     }
-    else
-        RemoveWatcher(watchInfo, &remWatcher);
-
-    if (mutexReturn == DCGM_MUTEX_ST_OK)
-        dcgm_mutex_unlock(m_mutex);
 
-    PRINT_DEBUG("%u %u %u %d",
-                "RemoveEntityFieldWatch eg %u, eid %u, nvmlFieldId %u, clearCache %d",
-                entityGroupId,
-                entityId,
-                dcgmFieldId,
-                clearCache);
+    /* Trigger the update loop to buffer updates from now on */
+    if (subscribeForUpdates)
+        m_haveAnyLiveSubscribers = true;
 
-    return retSt;
+    if (entityGroupId != DCGM_FE_NONE)
+    {
+        return AddEntityFieldWatch(entityGroupId,
+                                   entityId,
+                                   dcgmFieldId,
+                                   monitorFrequencyUsec,
+                                   maxSampleAge,
+                                   maxKeepSamples,
+                                   watcher,
+                                   subscribeForUpdates);
+    }
+    else
+    {
+        return AddGlobalFieldWatch(
+            dcgmFieldId, monitorFrequencyUsec, maxSampleAge, maxKeepSamples, watcher, subscribeForUpdates);
+    }
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AddGlobalFieldWatch(unsigned short dcgmFieldId,
-                                                   timelib64_t monitorFrequencyUsec,
-                                                   double maxSampleAge,
-                                                   int maxKeepSamples,
-                                                   DcgmWatcher watcher,
-                                                   bool subscribeForUpdates)
+dcgmReturn_t DcgmCacheManager::GetFieldWatchFreq(unsigned int gpuId, unsigned short fieldId, timelib64_t *freqUsec)
 {
-    dcgmcm_watch_info_p watchInfo;
-    bool wasAdded = false;
-    dcgm_watch_watcher_info_t newWatcher;
-
-    if (dcgmFieldId >= DCGM_FI_MAX_FIELDS)
-        return DCGM_ST_BADPARAM;
-
-    dcgm_mutex_lock(m_mutex);
-
-    watchInfo = GetGlobalWatchInfo(dcgmFieldId, 1);
-
-    /* Populate the cache manager version of watcher so we can insert/update it in this watchInfo's
-        watcher table */
-    newWatcher.watcher              = watcher;
-    newWatcher.monitorFrequencyUsec = monitorFrequencyUsec;
-    newWatcher.maxAgeUsec           = GetMaxAgeUsec(monitorFrequencyUsec, maxSampleAge, maxKeepSamples);
-    newWatcher.isSubscribed         = subscribeForUpdates;
+    dcgmcm_watch_info_p watchInfo = 0;
 
-    /* New watch? */
-    if (!watchInfo->isWatched)
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+    if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
     {
-        NvmlPreWatch(-1, dcgmFieldId);
+        PRINT_ERROR("%u", "%u is not a valid field ID", fieldId);
+        return DCGM_ST_UNKNOWN_FIELD;
     }
 
-    /* Add or update the watcher in our table */
-    AddOrUpdateWatcher(watchInfo, &wasAdded, &newWatcher);
-
-    watchInfo->isWatched = 1;
+    if (fieldMeta->scope == DCGM_FS_DEVICE)
+    {
+        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, fieldMeta->fieldId, 0);
+    }
+    else
+    {
+        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+    }
 
-    dcgm_mutex_unlock(m_mutex);
+    *freqUsec = 0;
 
-    PRINT_DEBUG("%u %lld %f %d %d",
-                "AddGlobalFieldWatch dcgmFieldId %u, mfu %lld, msa %f, mka %d, sfu %d",
-                dcgmFieldId,
-                (long long int)monitorFrequencyUsec,
-                maxSampleAge,
-                maxKeepSamples,
-                subscribeForUpdates ? 1 : 0);
+    if (watchInfo)
+        *freqUsec = watchInfo->monitorFrequencyUsec;
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::RemoveGlobalFieldWatch(unsigned short dcgmFieldId, int clearCache, DcgmWatcher watcher)
+timelib64_t DcgmCacheManager::GetMaxAgeUsec(timelib64_t monitorFrequencyUsec, double maxAgeSeconds, int maxKeepSamples)
 {
-    dcgmcm_watch_info_p watchInfo;
-    dcgmMutexReturn_t mutexReturn;
-    dcgm_watch_watcher_info_t remWatcher;
+    timelib64_t maxAgeUsec;
+    timelib64_t maxKeepSamplesInUsec;
 
-    if (dcgmFieldId >= DCGM_FI_MAX_FIELDS)
-        return DCGM_ST_BADPARAM;
+    /* Either value can be 0, which is null */
 
-    /* Populate the cache manager version of watcher so we can remove it in this watchInfo's
-       watcher table */
-    remWatcher.watcher = watcher;
+    if (maxAgeSeconds == 0.0)
+        return (timelib64_t)maxKeepSamples * monitorFrequencyUsec;
 
-    mutexReturn = dcgm_mutex_lock(m_mutex);
+    maxAgeUsec = (timelib64_t)(maxAgeSeconds * 1000000.0);
 
-    watchInfo = GetGlobalWatchInfo(dcgmFieldId, 0);
+    if (!maxKeepSamples)
+        return maxAgeUsec;
 
-    if (watchInfo)
-        RemoveWatcher(watchInfo, &remWatcher);
+    /* Both values are nonzero. Use the most restrictive of the two */
+    maxKeepSamplesInUsec = (timelib64_t)maxKeepSamples * monitorFrequencyUsec;
 
-    if (mutexReturn == DCGM_MUTEX_ST_OK)
+    return DCGM_MIN(maxKeepSamplesInUsec, maxAgeUsec);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::UpdateFieldWatch(dcgmcm_watch_info_p watchInfo,
+                                                timelib64_t monitorFrequencyUsec,
+                                                double maxAgeSec,
+                                                int maxKeepSamples,
+                                                DcgmWatcher watcher)
+{
+    if (!watchInfo)
+        return DCGM_ST_BADPARAM;
+
+    dcgm_mutex_lock(m_mutex);
+
+    if (!watchInfo->isWatched)
+    {
         dcgm_mutex_unlock(m_mutex);
+        return DCGM_ST_NOT_WATCHED;
+    }
 
-    PRINT_DEBUG("%u %d", "RemoveGlobalFieldWatch dcgmFieldId %u, clearCache %d", dcgmFieldId, clearCache);
+    watchInfo->monitorFrequencyUsec = monitorFrequencyUsec;
+    watchInfo->maxAgeUsec           = GetMaxAgeUsec(monitorFrequencyUsec, maxAgeSec, maxKeepSamples);
+    ScheduleWatchUpdate(watchInfo, watchInfo->lastQueriedUsec + GetPollIntervalUsec(watchInfo));
 
+    dcgm_mutex_unlock(m_mutex);
     return DCGM_ST_OK;
 }
 
-/*****************************************************************************/
-/*
- * Helper to convert a timeseries entry to a sample
- *
- */
-static dcgmReturn_t DcgmcmTimeSeriesEntryToSample(dcgmcm_sample_p sample,
-                                                  timeseries_entry_p entry,
-                                                  timeseries_p timeseries)
+dcgmReturn_t DcgmCacheManager::IsGpuFieldWatched(unsigned int gpuId, unsigned short dcgmFieldId, bool *isWatched)
 {
-    sample->timestamp = entry->usecSince1970;
-
+    dcgm_field_meta_p fieldMeta   = 0;
+    dcgmcm_watch_info_p watchInfo = 0;
 
-    switch (timeseries->tsType)
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
     {
-        case TS_TYPE_DOUBLE:
-            sample->val.d  = entry->val.dbl;
-            sample->val2.d = entry->val2.dbl;
-            break;
-        case TS_TYPE_INT64:
-            sample->val.i64  = entry->val.i64;
-            sample->val2.i64 = entry->val2.i64;
-            break;
-        case TS_TYPE_STRING:
-            sample->val.str = strdup((char *)entry->val.ptr);
-            if (!sample->val.str)
-            {
-                sample->val2.ptrSize = 0;
-                return DCGM_ST_MEMORY;
-            }
-            sample->val2.ptrSize = strlen(sample->val.str) + 1;
-            break;
-        case TS_TYPE_BLOB:
-            sample->val.blob = malloc(entry->val2.ptrSize);
-            if (!sample->val.blob)
-            {
-                sample->val2.ptrSize = 0;
-                return DCGM_ST_MEMORY;
-            }
-            sample->val2.ptrSize = entry->val2.ptrSize;
-            memcpy(sample->val.blob, entry->val.ptr, entry->val2.ptrSize);
-            break;
+        PRINT_ERROR("%u", "dcgmFieldId does not exist: %d", dcgmFieldId);
+        return DCGM_ST_UNKNOWN_FIELD;
+    }
 
-        default:
-            PRINT_ERROR("%d", "Shouldn't get here for type %d", (int)timeseries->tsType);
-            return DCGM_ST_BADPARAM;
+    if (fieldMeta->scope != DCGM_FS_DEVICE)
+    {
+        PRINT_ERROR("%u %d %d",
+                    "field ID %u has scope %d but this function only works for DEVICE (%d) scope fields",
+                    dcgmFieldId,
+                    fieldMeta->scope,
+                    DCGM_FS_DEVICE);
+        return DCGM_ST_BADPARAM;
     }
 
+    *isWatched = false;
+    watchInfo  = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, dcgmFieldId, 0);
+    if (watchInfo)
+        *isWatched = watchInfo->isWatched;
     return DCGM_ST_OK;
 }
 
-/*****************************************************************************/
-static dcgmReturn_t DcgmcmWriteTimeSeriesEntryToFvBuffer(dcgm_field_entity_group_t entityGroupId,
-                                                         dcgm_field_eid_t entityId,
-                                                         unsigned short fieldId,
-                                                         timeseries_entry_p entry,
-                                                         DcgmFvBuffer *fvBuffer,
-                                                         timeseries_p timeseries)
+dcgmReturn_t DcgmCacheManager::IsGpuFieldWatchedOnAnyGpu(unsigned short fieldId, bool *isWatched)
 {
-    dcgmBufferedFv_t *fv = 0;
+    dcgmReturn_t st;
 
-    switch (timeseries->tsType)
+    if (isWatched == NULL)
     {
-        case TS_TYPE_DOUBLE:
-            fv = fvBuffer->AddDoubleValue(
-                entityGroupId, entityId, fieldId, entry->val.dbl, entry->usecSince1970, DCGM_ST_OK);
-            break;
-        case TS_TYPE_INT64:
-            fv = fvBuffer->AddInt64Value(
-                entityGroupId, entityId, fieldId, entry->val.i64, entry->usecSince1970, DCGM_ST_OK);
-            break;
-        case TS_TYPE_STRING:
-            fv = fvBuffer->AddStringValue(
-                entityGroupId, entityId, fieldId, (char *)entry->val.ptr, entry->usecSince1970, DCGM_ST_OK);
-            break;
-        case TS_TYPE_BLOB:
-            fv = fvBuffer->AddBlobValue(entityGroupId,
-                                        entityId,
-                                        fieldId,
-                                        entry->val.ptr,
-                                        entry->val2.ptrSize,
-                                        entry->usecSince1970,
-                                        DCGM_ST_OK);
-            break;
-
-        default:
-            PRINT_ERROR("%d", "Shouldn't get here for type %d", (int)timeseries->tsType);
-            return DCGM_ST_BADPARAM;
+        PRINT_ERROR("", "arg cannot be NULL");
+        return DCGM_ST_BADPARAM;
     }
 
-    if (!fv)
+    std::vector<unsigned int> gpuIds;
+    this->GetGpuIds(1, gpuIds);
+
+    for (size_t i = 0; i < gpuIds.size(); ++i)
     {
-        PRINT_ERROR("%u %u %u",
-                    "Unexpected NULL fv returned for eg %u, eid %u, fieldId %u. Out of memory?",
-                    entityGroupId,
-                    entityId,
-                    fieldId);
-        return DCGM_ST_MEMORY;
-    }
+        unsigned int gpuId = gpuIds.at(i);
+        st                 = IsGpuFieldWatched(gpuId, fieldId, isWatched);
+        if (DCGM_ST_OK != st)
+            return st;
 
-    // PRINT_DEBUG("%u %u %u %d", "eg %u, eid %u, fieldId %u buffered %d bytes.",
-    //            entityGroupId, entityId, fieldId, fv->length);
+        if (*isWatched == true)
+            break;
+    }
 
     return DCGM_ST_OK;
 }
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetUniquePidLists(dcgm_field_entity_group_t entityGroupId,
-                                                 dcgm_field_eid_t entityId,
-                                                 unsigned short dcgmFieldId,
-                                                 unsigned int excludePid,
-                                                 dcgmProcessUtilInfo_t *pidInfo,
-                                                 unsigned int *numPids,
-                                                 timelib64_t startTime,
-                                                 timelib64_t endTime)
+dcgmReturn_t DcgmCacheManager::IsGlobalFieldWatched(unsigned short dcgmFieldId, bool *isWatched)
 {
+    dcgm_field_meta_p fieldMeta   = 0;
     dcgmcm_watch_info_p watchInfo = 0;
-    unsigned int maxPids;
-
-    if (!pidInfo || !numPids)
-        return DCGM_ST_BADPARAM;
-    if (dcgmFieldId != DCGM_FI_DEV_GRAPHICS_PIDS && dcgmFieldId != DCGM_FI_DEV_COMPUTE_PIDS)
-        return DCGM_ST_BADPARAM;
-
-    maxPids  = *numPids;
-    *numPids = 0;
-
-    dcgm_mutex_lock(m_mutex);
-
-    watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
 
-    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
-    if (dcgmReturn != DCGM_ST_OK)
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
     {
-        dcgm_mutex_unlock(m_mutex);
-        return dcgmReturn;
+        PRINT_ERROR("%u", "dcgmFieldId does not exist: %d", dcgmFieldId);
+        return DCGM_ST_UNKNOWN_FIELD;
     }
 
-    if (watchInfo->timeSeries->tsType != TS_TYPE_BLOB)
+    if (fieldMeta->scope != DCGM_FS_GLOBAL)
     {
-        PRINT_ERROR("%u %d", "Expected type TS_TYPE_BLOB for %u. Got %d", dcgmFieldId, watchInfo->timeSeries->tsType);
-        dcgm_mutex_unlock(m_mutex);
-        return DCGM_ST_GENERIC_ERROR;
+        PRINT_ERROR("%u %d %d",
+                    "field ID %u has scope %d but this function only works for GLOBAL (%d) scope fields",
+                    dcgmFieldId,
+                    fieldMeta->scope,
+                    DCGM_FS_GLOBAL);
+        return DCGM_ST_BADPARAM;
     }
 
-    /* Data type is assumed to be a time series type */
-    timeseries_p timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
-    timeseries_entry_p entry = 0;
-    dcgmRunningProcess_t *proc;
-    int i, havePid;
+    *isWatched = false;
+    watchInfo  = GetGlobalWatchInfo(dcgmFieldId, 0);
+    if (watchInfo)
+        *isWatched = watchInfo->isWatched;
+    return DCGM_ST_OK;
+}
 
-    /* Walk forward  */
-    if (startTime)
-    {
-        timeseries_entry_t key;
+bool DcgmCacheManager::AnyGlobalFieldsWatched(std::vector<unsigned short> *fieldIds)
+{
+    dcgmReturn_t st;
 
-        key.usecSince1970 = startTime;
-        entry = (timeseries_entry_p)keyedvector_find_by_key(timeseries->keyedVector, &key, KV_LGE_GREATEQUAL, &cursor);
+    if (fieldIds == NULL)
+    {
+        fieldIds = &this->m_allValidFieldIds;
     }
-    else
-        entry = (timeseries_entry_p)keyedvector_first(timeseries->keyedVector, &cursor);
 
-    for (; entry; entry = (timeseries_entry_p)keyedvector_next(timeseries->keyedVector, &cursor))
+    for (size_t i = 0; i < fieldIds->size(); ++i)
     {
-        /* Past our time range? */
-        if (endTime && entry->usecSince1970 > endTime)
-            break;
+        unsigned short fieldId = fieldIds->at(i);
 
-        proc = (dcgmRunningProcess_t *)entry->val.ptr;
-        if (!proc || proc->version != dcgmRunningProcess_version)
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+
+        // silently skip invalid fields
+        if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
         {
-            PRINT_ERROR("", "Skipping invalid entry");
             continue;
         }
 
-        if (excludePid && excludePid == proc->pid)
-            continue; /* Skip exclusion pid */
-
-        /* See if we already have this PID. Use a linear search since we don't expect to
-         * return large lists
-         */
-        havePid = 0;
-        for (i = 0; i < (int)(*numPids); i++)
+        if (fieldMeta->scope != DCGM_FS_GLOBAL)
         {
-            if (proc->pid == pidInfo[i].pid)
-            {
-                havePid = 1;
-                break;
-            }
+            continue;
         }
 
-        if (havePid)
-            continue; /* Already have this one */
-
-        /* We found a new PID */
-        pidInfo[*numPids].pid = proc->pid;
-        (*numPids)++;
+        bool isWatched;
+        st = this->IsGlobalFieldWatched(fieldId, &isWatched);
+        if (DCGM_ST_OK != st)
+        {
+            continue;
+        }
 
-        /* Have we reached our capacity? */
-        if ((*numPids) >= maxPids)
-            break;
+        if (isWatched)
+        {
+            return true;
+        }
     }
 
-    dcgm_mutex_unlock(m_mutex);
+    return false;
+}
 
-    if (!(*numPids))
+bool DcgmCacheManager::AnyFieldsWatched(std::vector<unsigned short> *fieldIds)
+{
+    if (fieldIds == NULL)
     {
-        if (!watchInfo->isWatched)
-            return DCGM_ST_NOT_WATCHED;
-        else
-            return DCGM_ST_NO_DATA;
+        fieldIds = &this->m_allValidFieldIds;
     }
 
-    return DCGM_ST_OK;
-}
+    dcgmReturn_t st = DCGM_ST_OK;
+    bool isWatched  = false;
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetUniquePidLists(dcgm_field_entity_group_t entityGroupId,
-                                                 dcgm_field_eid_t entityId,
-                                                 unsigned short dcgmFieldId,
-                                                 unsigned int excludePid,
-                                                 unsigned int *pids,
-                                                 unsigned int *numPids,
-                                                 timelib64_t startTime,
-                                                 timelib64_t endTime)
-{
-    dcgmcm_watch_info_p watchInfo = 0;
-    unsigned int maxPids;
+    for (size_t i = 0; i < fieldIds->size(); ++i)
+    {
+        unsigned short fieldId = fieldIds->at(i);
 
-    if (!pids || !numPids)
-        return DCGM_ST_BADPARAM;
-    if (dcgmFieldId != DCGM_FI_DEV_GRAPHICS_PIDS && dcgmFieldId != DCGM_FI_DEV_COMPUTE_PIDS)
-        return DCGM_ST_BADPARAM;
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
+            continue;
 
-    maxPids  = *numPids;
-    *numPids = 0;
+        if (fieldMeta->scope == DCGM_FS_GLOBAL)
+        {
+            st = IsGlobalFieldWatched(fieldId, &isWatched);
+        }
+        else if (fieldMeta->scope == DCGM_FS_DEVICE)
+        {
+            st = IsGpuFieldWatchedOnAnyGpu(fieldId, &isWatched);
+        }
 
-    dcgm_mutex_lock(m_mutex);
+        if (DCGM_ST_OK == st && isWatched)
+            return true;
+    }
 
-    watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
+    return false;
+}
 
-    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
-    if (dcgmReturn != DCGM_ST_OK)
-    {
-        dcgm_mutex_unlock(m_mutex);
-        return dcgmReturn;
-    }
+bool DcgmCacheManager::AnyGpuFieldsWatchedAnywhere(std::vector<unsigned short> *fieldIds)
+{
+    std::vector<unsigned int> gpuIds;
+    dcgmReturn_t st = GetGpuIds(1, gpuIds);
+    if (DCGM_ST_OK != st)
+        return false;
 
-    if (watchInfo->timeSeries->tsType != TS_TYPE_BLOB)
+    for (size_t i = 0; i < gpuIds.size(); ++i)
     {
-        PRINT_ERROR("%u %d", "Expected type TS_TYPE_BLOB for %u. Got %d", dcgmFieldId, watchInfo->timeSeries->tsType);
-        dcgm_mutex_unlock(m_mutex);
-        return DCGM_ST_GENERIC_ERROR;
+        unsigned int gpuId = gpuIds.at(i);
+        if (AnyGpuFieldsWatched(gpuId, fieldIds))
+        {
+            return true;
+        }
     }
 
-    /* Data type is assumed to be a time series type */
-    timeseries_p timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
-    timeseries_entry_p entry = 0;
-    dcgmRunningProcess_t *proc;
-    int i, havePid;
+    return false;
+}
 
-    /* Walk forward  */
-    if (startTime)
-    {
-        timeseries_entry_t key;
+bool DcgmCacheManager::AnyGpuFieldsWatched(unsigned int gpuId, std::vector<unsigned short> *fieldIds)
+{
+    dcgmReturn_t st;
 
-        key.usecSince1970 = startTime;
-        entry = (timeseries_entry_p)keyedvector_find_by_key(timeseries->keyedVector, &key, KV_LGE_GREATEQUAL, &cursor);
+    if (fieldIds == NULL)
+    {
+        fieldIds = &this->m_allValidFieldIds;
     }
-    else
-        entry = (timeseries_entry_p)keyedvector_first(timeseries->keyedVector, &cursor);
 
-    for (; entry; entry = (timeseries_entry_p)keyedvector_next(timeseries->keyedVector, &cursor))
+    for (size_t i = 0; i < fieldIds->size(); ++i)
     {
-        /* Past our time range? */
-        if (endTime && entry->usecSince1970 > endTime)
-            break;
+        unsigned short fieldId = fieldIds->at(i);
 
-        proc = (dcgmRunningProcess_t *)entry->val.ptr;
-        if (!proc || proc->version != dcgmRunningProcess_version)
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+
+        // silently skip invalid fields
+        if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
         {
-            PRINT_ERROR("", "Skipping invalid entry");
             continue;
         }
 
-        if (excludePid && excludePid == proc->pid)
-            continue; /* Skip exclusion pid */
+        if (fieldMeta->scope != DCGM_FS_DEVICE)
+        {
+            continue;
+        }
 
-        /* See if we already have this PID. Use a linear search since we don't expect to
-         * return large lists
-         */
-        havePid = 0;
-        for (i = 0; i < (int)(*numPids); i++)
+        bool isWatched;
+        st = this->IsGpuFieldWatched(gpuId, fieldId, &isWatched);
+        if (DCGM_ST_OK != st)
         {
-            if (proc->pid == pids[i])
-            {
-                havePid = 1;
-                break;
-            }
+            continue;
         }
 
-        if (havePid)
-            continue; /* Already have this one */
+        if (isWatched)
+        {
+            return true;
+        }
+    }
 
-        /* We found a new PID */
-        pids[*numPids] = proc->pid;
-        (*numPids)++;
+    return false;
+}
 
-        /* Have we reached our capacity? */
-        if ((*numPids) >= maxPids)
-            break;
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::RemoveFieldWatch(dcgm_field_entity_group_t entityGroupId,
+                                                unsigned int entityId,
+                                                unsigned short dcgmFieldId,
+                                                int clearCache,
+                                                DcgmWatcher watcher)
+{
+    dcgm_field_meta_p fieldMeta = 0;
+
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_UNKNOWN_FIELD;
+
+    if (entityGroupId != DCGM_FE_NONE)
+    {
+        return RemoveEntityFieldWatch(entityGroupId, entityId, dcgmFieldId, clearCache, watcher);
+    }
+    else
+    {
+        return RemoveGlobalFieldWatch(dcgmFieldId, clearCache, watcher);
     }
+}
 
-    dcgm_mutex_unlock(m_mutex);
 
-    if (!(*numPids))
+/*************************************************************************/
+dcgmReturn_t DcgmCacheManager::RemoveWatcher(dcgmcm_watch_info_p watchInfo, dcgm_watch_watcher_info_t *watcher)
+{
+    std::vector<dcgm_watch_watcher_info_t>::iterator it;
+
+    for (it = watchInfo->watchers.begin(); it != watchInfo->watchers.end(); ++it)
     {
-        if (!watchInfo->isWatched)
-            return DCGM_ST_NOT_WATCHED;
-        else
-            return DCGM_ST_NO_DATA;
+        if ((*it).watcher == watcher->watcher)
+        {
+            PRINT_DEBUG("%u %u",
+                        "RemoveWatcher removing existing watcher type %u, connectionId %u",
+                        watcher->watcher.watcherType,
+                        watcher->watcher.connectionId);
+
+            watchInfo->watchers.erase(it);
+            /* Update the watchInfo frequency and quota now that we removed a watcher */
+            UpdateWatchFromWatchers(watchInfo);
+
+            /* Last watcher? */
+            if (watchInfo->watchers.size() < 1)
+            {
+                watchInfo->isWatched = 0;
+
+                if (watchInfo->watchKey.entityGroupId == DCGM_FE_GPU)
+                {
+                    NvmlPostWatch(GpuIdToNvmlIndex(watchInfo->watchKey.entityId), watchInfo->watchKey.fieldId);
+                }
+                else if (watchInfo->watchKey.entityGroupId == DCGM_FE_NONE)
+                    NvmlPostWatch(-1, watchInfo->watchKey.fieldId);
+            }
+
+            return DCGM_ST_OK;
+        }
+    }
+
+    PRINT_DEBUG("%u %u",
+                "RemoveWatcher() type %u, connectionId %u was not a watcher",
+                watcher->watcher.watcherType,
+                watcher->watcher.connectionId);
+    return DCGM_ST_NOT_WATCHED;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AddOrUpdateWatcher(dcgmcm_watch_info_p watchInfo,
+                                                  bool *wasAdded,
+                                                  dcgm_watch_watcher_info_t *newWatcher)
+{
+    std::vector<dcgm_watch_watcher_info_t>::iterator it;
+
+    for (it = watchInfo->watchers.begin(); it != watchInfo->watchers.end(); ++it)
+    {
+        if ((*it).watcher == newWatcher->watcher)
+        {
+            PRINT_DEBUG("%u %u",
+                        "Updating existing watcher type %u, connectionId %u",
+                        newWatcher->watcher.watcherType,
+                        newWatcher->watcher.connectionId);
+
+            *it       = *newWatcher;
+            *wasAdded = false;
+            /* Update the watchInfo frequency and quota now that we updated a watcher */
+            UpdateWatchFromWatchers(watchInfo);
+            return DCGM_ST_OK;
+        }
     }
 
+    PRINT_DEBUG("%u %u",
+                "Adding new watcher type %u, connectionId %u",
+                newWatcher->watcher.watcherType,
+                newWatcher->watcher.connectionId);
+
+    watchInfo->watchers.push_back(*newWatcher);
+    *wasAdded = true;
+
+    /* Update the watchInfo frequency and quota now that we added a watcher */
+    UpdateWatchFromWatchers(watchInfo);
+
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::PrecheckWatchInfoForSamples(dcgmcm_watch_info_p watchInfo)
+dcgmReturn_t DcgmCacheManager::UpdateWatchFromWatchers(dcgmcm_watch_info_p watchInfo)
 {
-    /* Note: This code assumes that the cache manager is locked */
+    std::vector<dcgm_watch_watcher_info_t>::iterator it;
 
-    if (!watchInfo)
+    it = watchInfo->watchers.begin();
+
+    if (it == watchInfo->watchers.end())
     {
-        PRINT_DEBUG("", "PrecheckWatchInfoForSamples: not watched");
+        watchInfo->hasSubscribedWatchers = 0;
+        if (GetRateCounterFieldId(watchInfo->watchKey.fieldId))
+            UpdateRateCounterWatch(watchInfo);
+        else if (IsDerivedFieldId(watchInfo->watchKey.fieldId))
+            UpdateDerivedFieldWatch(watchInfo);
         return DCGM_ST_NOT_WATCHED;
     }
 
-    /* Matching existing behavior: if there is data for an entity, then we can
-       return it. This bypasses recent NVML failures or the field no longer
-       being watched. */
-    if (watchInfo->timeSeries)
-        return DCGM_ST_OK;
+    /* Don't update watchInfo's value here because we don't want non-locking readers to them in a temporary state */
+    timelib64_t minMonitorFreqUsec = it->monitorFrequencyUsec;
+    bool hasSubscribedWatchers     = it->isSubscribed;
 
-    if (!watchInfo->isWatched)
+    for (++it; it != watchInfo->watchers.end(); ++it)
     {
-        PRINT_DEBUG("%u %u %u",
-                    "eg %u, eid %u, fieldId %u not watched",
-                    watchInfo->watchKey.entityGroupId,
-                    watchInfo->watchKey.entityId,
-                    watchInfo->watchKey.fieldId);
-        return DCGM_ST_NOT_WATCHED;
+        minMonitorFreqUsec = DCGM_MIN(minMonitorFreqUsec, it->monitorFrequencyUsec);
+        if (it->isSubscribed)
+            hasSubscribedWatchers = 1;
     }
 
-    if (watchInfo->lastStatus != NVML_SUCCESS)
+    /* An age of 0 keeps samples until the entity goes away, so it outlasts any other age */
+    auto longerAge = [](timelib64_t a, timelib64_t b) { return (a == 0 || b == 0) ? 0 : std::max(a, b); };
+
+    /* Raw samples are kept as long as the fastest watchers want them. Slower watchers that want
+       their samples longer than that are kept at their own frequency by a rollup tier */
+    timelib64_t maxMaxAgeUsec    = watchInfo->watchers.front().maxAgeUsec;
+    timelib64_t rawRetentionUsec = -1;
+    std::vector<dcgmcm_rollup_tier_config_t> watcherTiers;
+    for (dcgm_watch_watcher_info_t const &watcherInfo : watchInfo->watchers)
     {
-        PRINT_DEBUG("%u %u %u %u",
-                    "eg %u, eid %u, fieldId %u NVML status %u",
-                    watchInfo->watchKey.entityGroupId,
-                    watchInfo->watchKey.entityId,
-                    watchInfo->watchKey.fieldId,
-                    watchInfo->lastStatus);
-        return NvmlReturnToDcgmReturn(watchInfo->lastStatus);
+        maxMaxAgeUsec = longerAge(maxMaxAgeUsec, watcherInfo.maxAgeUsec);
+        if (watcherInfo.monitorFrequencyUsec <= minMonitorFreqUsec || watcherInfo.maxAgeUsec == 0)
+        {
+            rawRetentionUsec = rawRetentionUsec < 0 ? watcherInfo.maxAgeUsec
+                                                    : longerAge(rawRetentionUsec, watcherInfo.maxAgeUsec);
+        }
+        else
+            watcherTiers.push_back({ watcherInfo.monitorFrequencyUsec, watcherInfo.maxAgeUsec });
     }
 
-    int numElements = timeseries_size(watchInfo->timeSeries);
-    if (!numElements)
+    if (rawRetentionUsec > 0)
+        DcgmCacheRollup::NormalizeTiers(rawRetentionUsec, &watcherTiers);
+    else
+        watcherTiers.clear();
+    if (watcherTiers.empty())
+        rawRetentionUsec = 0;
+
+    bool tiersChanged = watcherTiers.size() != watchInfo->watcherTiers.size()
+                        || !std::equal(watcherTiers.begin(),
+                                       watcherTiers.end(),
+                                       watchInfo->watcherTiers.begin(),
+                                       [](auto const &a, auto const &b) {
+                                           return a.bucketUsec == b.bucketUsec && a.retentionUsec == b.retentionUsec;
+                                       });
+
+    watchInfo->monitorFrequencyUsec  = minMonitorFreqUsec;
+    watchInfo->maxAgeUsec            = maxMaxAgeUsec;
+    watchInfo->rawRetentionUsec      = rawRetentionUsec;
+    watchInfo->hasSubscribedWatchers = hasSubscribedWatchers;
+    if (tiersChanged)
     {
-        PRINT_DEBUG("%u %u %u",
-                    "eg %u, eid %u, fieldId %u has NO DATA",
-                    watchInfo->watchKey.entityGroupId,
-                    watchInfo->watchKey.entityId,
-                    watchInfo->watchKey.fieldId);
-        return DCGM_ST_NO_DATA;
+        /* The rollup is rebuilt with the new tiers on the next append */
+        watchInfo->watcherTiers.swap(watcherTiers);
+        watchInfo->rollup.reset();
     }
+    if (minMonitorFreqUsec > 0)
+        m_watchTickUsec = std::gcd(m_watchTickUsec, minMonitorFreqUsec);
+    ScheduleWatchUpdate(watchInfo, watchInfo->lastQueriedUsec + GetPollIntervalUsec(watchInfo));
+    if (GetRateCounterFieldId(watchInfo->watchKey.fieldId))
+        UpdateRateCounterWatch(watchInfo);
+    else if (IsDerivedFieldId(watchInfo->watchKey.fieldId))
+        UpdateDerivedFieldWatch(watchInfo);
 
+    PRINT_DEBUG("%lld %lld %d",
+                "UpdateWatchFromWatchers minMonitorFreqUsec %lld, maxMaxAgeUsec %lld, hsw %d",
+                (long long)minMonitorFreqUsec,
+                (long long)maxMaxAgeUsec,
+                watchInfo->hasSubscribedWatchers);
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetUniquePidUtilLists(dcgm_field_entity_group_t entityGroupId,
-                                                     dcgm_field_eid_t entityId,
-                                                     unsigned short dcgmFieldId,
-                                                     unsigned int includePid,
-                                                     dcgmProcessUtilSample_t *processUtilSamples,
-                                                     unsigned int *numUniqueSamples,
-                                                     timelib64_t startTime,
-                                                     timelib64_t endTime)
+void DcgmCacheManager::ScheduleWatchUpdate(dcgmcm_watch_info_p watchInfo, timelib64_t dueUsec)
 {
-    dcgmcm_watch_info_p watchInfo = 0;
-    unsigned int maxPids;
-    unsigned int numSamples = 0;
+    /* The module that pushes the field schedules it in its own DcgmWatchTable */
+    if (IsModulePushedFieldId(watchInfo->watchKey.fieldId))
+        return;
 
-    if (!processUtilSamples || !numUniqueSamples)
-        return DCGM_ST_BADPARAM;
-    if (dcgmFieldId != DCGM_FI_DEV_GPU_UTIL_SAMPLES && dcgmFieldId != DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES)
-        return DCGM_ST_BADPARAM;
+    dueUsec = AlignWatchDeadline(dueUsec, m_watchTickUsec, GetWatchCoalesceUsec(watchInfo));
 
-    maxPids           = *numUniqueSamples;
-    *numUniqueSamples = 0;
+    if (!m_watchSchedule.Schedule(watchInfo, dueUsec))
+        return; /* Already scheduled for then */
 
-    dcgm_mutex_lock(m_mutex);
+    if (m_watchSchedule.ShouldRebuild(m_entityWatches.Size()))
+        CompactWatchSchedule();
+}
 
-    watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
+/*****************************************************************************/
+timelib64_t DcgmCacheManager::GetWatchCoalesceUsec(dcgmcm_watch_info_p watchInfo) const
+{
+    return std::min(m_watchCoalesceUsec, watchInfo->monitorFrequencyUsec / 4);
+}
 
-    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
-    if (dcgmReturn != DCGM_ST_OK)
-    {
-        dcgm_mutex_unlock(m_mutex);
-        return dcgmReturn;
-    }
+/*****************************************************************************/
+void DcgmCacheManager::RecordWatchExecTime(dcgmcm_watch_info_p watchInfo, timelib64_t execTimeUsec)
+{
+    watchInfo->execTimeUsec += execTimeUsec;
+    watchInfo->fetchCount++;
+    watchInfo->maxExecTimeUsec = std::max(watchInfo->maxExecTimeUsec, execTimeUsec);
+    watchInfo->execTimeHistogram[GetExecTimeBucket(execTimeUsec)]++;
+}
 
-    if (watchInfo->timeSeries->tsType != TS_TYPE_DOUBLE)
-    {
-        PRINT_ERROR("%u %d", "Expected type TS_TYPE_DOUBLE for %u. Got %d", dcgmFieldId, watchInfo->timeSeries->tsType);
-        dcgm_mutex_unlock(m_mutex);
-        return DCGM_ST_GENERIC_ERROR;
-    }
+/*****************************************************************************/
+void DcgmCacheManager::RecordWatchSampleLag(dcgmcm_watch_info_p watchInfo,
+                                            dcgmIntrospectLagStage_t stage,
+                                            timelib64_t ageUsec)
+{
+    /* Injected samples can be from the future */
+    ageUsec = std::max(ageUsec, (timelib64_t)0);
 
-    /* Data type is assumed to be a time series type */
-    timeseries_p timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
-    timeseries_entry_p entry = 0;
-    int i, havePid;
-    double utilVal;
-    unsigned int pid;
+    watchInfo->maxSampleLagUsec[stage] = std::max(watchInfo->maxSampleLagUsec[stage], ageUsec);
+    watchInfo->sampleLagHistogram[stage][GetExecTimeBucket(ageUsec)]++;
+}
 
-    /* Walk forward  */
-    if (startTime)
-    {
-        timeseries_entry_t key;
+/*****************************************************************************/
+void DcgmCacheManager::RecordSampleLag(dcgmIntrospectLagStage_t stage,
+                                       DcgmFvBuffer const &fvBuffer,
+                                       timelib64_t nowUsec)
+{
+    size_t bufferSize   = 0;
+    size_t elementCount = 0;
+    fvBuffer.GetSize(&bufferSize, &elementCount);
 
-        key.usecSince1970 = startTime;
-        entry = (timeseries_entry_p)keyedvector_find_by_key(timeseries->keyedVector, &key, KV_LGE_GREATEQUAL, &cursor);
-    }
-    else
-        entry = (timeseries_entry_p)keyedvector_first(timeseries->keyedVector, &cursor);
+    RecordSampleLag(stage, fvBuffer.GetBuffer(), bufferSize, nowUsec);
+}
 
-    for (; entry; entry = (timeseries_entry_p)keyedvector_next(timeseries->keyedVector, &cursor))
-    {
-        if (!entry)
-        {
-            PRINT_ERROR("", "Skipping invalid entry");
-            continue;
-        }
-
-        /* Past our time range? */
-        if (endTime && entry->usecSince1970 > endTime)
-            break;
-
-        utilVal = entry->val.dbl;
-        pid     = (unsigned int)entry->val2.dbl;
+/*****************************************************************************/
+void DcgmCacheManager::RecordSampleLag(dcgmIntrospectLagStage_t stage,
+                                       char const *buffer,
+                                       size_t bufferSize,
+                                       timelib64_t nowUsec)
+{
+    if (stage < 0 || stage >= DCGM_INTROSPECT_LAG_STAGE_COUNT || !buffer)
+        return;
 
-        /* Continue if it is an invalidPID or if the entry is not the one for which utilization is being looked for*/
-        if (std::numeric_limits<unsigned>::max() == pid || (includePid > 0 && pid != includePid))
-        {
-            numSamples++;
-            continue;
-        }
+    if (!nowUsec)
+        nowUsec = timelib_usecSince1970();
 
-        /* See if we already have this PID. Use a linear search since we don't expect to
-         * return large lists
-         */
-        havePid = 0;
-        for (i = 0; i < (int)(*numUniqueSamples); i++)
-        {
-            if (pid == processUtilSamples[i].pid)
-            {
-                havePid = 1;
-                processUtilSamples[i].util += utilVal;
-                numSamples++;
-                break;
-            }
-        }
+    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
 
-        if (havePid)
-            continue; /* Already have this one */
+    size_t offset = 0;
+    while (offset + offsetof(dcgmBufferedFv_t, value) <= bufferSize)
+    {
+        dcgmBufferedFv_t const *fv = (dcgmBufferedFv_t const *)(buffer + offset);
+        if (fv->length == 0 || offset + fv->length > bufferSize)
+            break;
+        offset += fv->length;
 
-        /* We found a new PID */
-        processUtilSamples[*numUniqueSamples].pid  = pid;
-        processUtilSamples[*numUniqueSamples].util = utilVal;
-        numSamples++;
-        (*numUniqueSamples)++;
+        if (fv->status != DCGM_ST_OK || fv->timestamp <= 0)
+            continue;
 
-        /* Have we reached our capacity? */
-        if ((*numUniqueSamples) >= maxPids)
-        {
-            PRINT_DEBUG(
-                "%d %d", "Reached Max Capacity of ProcessSamples  - %d, maxPids = %d", *numUniqueSamples, maxPids);
-            break;
-        }
+        dcgm_field_entity_group_t entityGroupId = (dcgm_field_entity_group_t)fv->entityGroupId;
+        dcgm_field_eid_t entityId               = entityGroupId == DCGM_FE_NONE ? 0 : fv->entityId;
+        dcgmcm_watch_info_p watchInfo           = m_entityWatches.Get(entityGroupId, entityId, fv->fieldId);
+        if (watchInfo)
+            RecordWatchSampleLag(watchInfo, stage, nowUsec - fv->timestamp);
     }
 
-    dcgm_mutex_unlock(m_mutex);
-    /* Average utilization rates */
-    for (i = 0; i < (int)*numUniqueSamples; i++)
-    {
-        processUtilSamples[i].util = processUtilSamples[i].util / numSamples;
-    }
+    if (mutexSt == DCGM_MUTEX_ST_OK)
+        dcgm_mutex_unlock(m_mutex);
+}
 
-    if (!(*numUniqueSamples))
+/*****************************************************************************/
+void DcgmCacheManager::CompactWatchSchedule(void)
+{
+    size_t oldSize = m_watchSchedule.Size();
+
+    m_watchTickUsec = 0;
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
     {
-        if (!watchInfo->isWatched)
-            return DCGM_ST_NOT_WATCHED;
-        else
-            return DCGM_ST_NO_DATA;
+        if (watchInfo->isWatched && watchInfo->monitorFrequencyUsec > 0)
+            m_watchTickUsec = std::gcd(m_watchTickUsec, watchInfo->monitorFrequencyUsec);
     }
 
-    return DCGM_ST_OK;
+    m_watchSchedule.Rebuild(m_entityWatches.Values());
+    PRINT_DEBUG("%zu %zu", "Compacted watch schedule from %zu to %zu entries", oldSize, m_watchSchedule.Size());
 }
 
-
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetLatestProcessInfo(unsigned int gpuId,
-                                                    unsigned int pid,
-                                                    dcgmDevicePidAccountingStats_t *pidInfo)
+dcgmReturn_t DcgmCacheManager::AddEntityFieldWatch(dcgm_field_entity_group_t entityGroupId,
+                                                   unsigned int entityId,
+                                                   unsigned short dcgmFieldId,
+                                                   timelib64_t monitorFrequencyUsec,
+                                                   double maxSampleAge,
+                                                   int maxKeepSamples,
+                                                   DcgmWatcher watcher,
+                                                   bool subscribeForUpdates)
 {
-    dcgmcm_watch_info_p watchInfo = 0;
+    dcgmcm_watch_info_p watchInfo;
+    dcgmReturn_t dcgmReturn = DCGM_ST_OK;
+    bool wasAdded           = false;
+    dcgm_watch_watcher_info_t newWatcher;
 
-    if (!pid || !pidInfo)
+    if (dcgmFieldId >= DCGM_FI_MAX_FIELDS)
         return DCGM_ST_BADPARAM;
-
-    dcgm_mutex_lock(m_mutex);
-
-    watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, 0);
-
-    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
-    if (dcgmReturn != DCGM_ST_OK)
+    else if (dcgmFieldId == DCGM_FI_DEV_INFOROM_CONFIG_CHECK || dcgmFieldId == DCGM_FI_DEV_INFOROM_CONFIG_VALID)
     {
-        dcgm_mutex_unlock(m_mutex);
-        return dcgmReturn;
+        /* For inforom checks, enforce a 30-second minumum to avoid excessive CPU cycles */
+        const timelib64_t minMonitorFrequenceUsec = 30000000;
+        if (monitorFrequencyUsec < minMonitorFrequenceUsec)
+        {
+            DCGM_LOG_DEBUG << "Adjusted logging for eg " << entityGroupId << " eid " << entityId << " fieldId "
+                           << dcgmFieldId << " from " << monitorFrequencyUsec << " to " << minMonitorFrequenceUsec;
+            monitorFrequencyUsec = minMonitorFrequenceUsec;
+        }
     }
 
-    if (watchInfo->timeSeries->tsType != TS_TYPE_BLOB)
-    {
-        PRINT_ERROR(
-            "%d", "Expected type TS_TYPE_BLOB for DCGM_FI_DEV_ACCOUNTING_DATA. Got %d", watchInfo->timeSeries->tsType);
-        dcgm_mutex_unlock(m_mutex);
-        return DCGM_ST_GENERIC_ERROR;
-    }
+    dcgm_field_entity_group_t watchEntityGroupId = entityGroupId;
+    unsigned int watchEntityId                   = entityId;
 
-    /* Data type is assumed to be a time series type */
-    timeseries_p timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
-    timeseries_entry_p entry = 0;
-    dcgmDevicePidAccountingStats_t *accStats;
-    dcgmDevicePidAccountingStats_t *matchingAccStats = 0;
-    int Nseen                                        = 0;
+    /* Populate the cache manager version of watcher so we can insert/update it in this watchInfo's
+       watcher table */
+    newWatcher.watcher              = watcher;
+    newWatcher.monitorFrequencyUsec = monitorFrequencyUsec;
+    newWatcher.maxAgeUsec           = GetMaxAgeUsec(monitorFrequencyUsec, maxSampleAge, maxKeepSamples);
+    newWatcher.isSubscribed         = subscribeForUpdates ? 1 : 0;
 
-    /* Walk backwards looking for our PID */
-    for (entry = (timeseries_entry_p)keyedvector_last(timeseries->keyedVector, &cursor); entry && !matchingAccStats;
-         entry = (timeseries_entry_p)keyedvector_prev(timeseries->keyedVector, &cursor))
+    if (entityGroupId == DCGM_FE_SWITCH)
     {
-        Nseen++;
-        accStats = (dcgmDevicePidAccountingStats_t *)entry->val.ptr;
-        if (!accStats)
-        {
-            PRINT_ERROR("", "Null entry");
-            continue;
-        }
+        dcgmReturn_t retSt
+            = helperNvSwitchAddFieldWatch(entityGroupId, entityId, dcgmFieldId, monitorFrequencyUsec, watcher);
 
-        if (accStats->pid == pid)
+        if (retSt != DCGM_ST_OK)
         {
-            PRINT_DEBUG("%u %d", "Found pid %u after %d entries", pid, Nseen);
-            matchingAccStats = accStats;
-            break;
+            DCGM_LOG_ERROR << "Got status " << errorString(retSt) << "(" << retSt << ")"
+                           << " when trying to set watches";
         }
     }
 
-    if (!Nseen || !matchingAccStats)
-    {
-        dcgm_mutex_unlock(m_mutex);
-        PRINT_DEBUG("%u %d", "Pid %u not found after looking at %d entries", pid, Nseen);
+    DcgmLockGuard dlg(m_mutex);
 
-        if (!watchInfo->isWatched)
-            return DCGM_ST_NOT_WATCHED;
-        else
-            return DCGM_ST_NO_DATA;
-    }
+    watchInfo = GetEntityWatchInfo(watchEntityGroupId, watchEntityId, dcgmFieldId, 1);
 
-    if (matchingAccStats->version != dcgmDevicePidAccountingStats_version)
+    /* New watch? */
+    if (!watchInfo->isWatched && watchEntityGroupId == DCGM_FE_GPU)
     {
-        dcgm_mutex_unlock(m_mutex);
-        PRINT_ERROR("%d %d",
-                    "Expected accounting stats version %d. Found %d",
-                    dcgmDevicePidAccountingStats_version,
-                    matchingAccStats->version);
-        return DCGM_ST_GENERIC_ERROR; /* This is an internal version mismatch, not a user one */
+        watchInfo->lastQueriedUsec = 0;
+
+        /* Do the pre-watch first in case it fails */
+        dcgmReturn = NvmlPreWatch(GpuIdToNvmlIndex(watchEntityId), dcgmFieldId);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            PRINT_ERROR("%u %u %d",
+                        "NvmlPreWatch eg %u,  eid %u, failed with %d",
+                        watchEntityGroupId,
+                        watchEntityId,
+                        (int)dcgmReturn);
+            return dcgmReturn;
+        }
     }
 
-    memcpy(pidInfo, matchingAccStats, sizeof(*pidInfo));
-    dcgm_mutex_unlock(m_mutex);
+    /* Add or update the watcher in our table */
+    AddOrUpdateWatcher(watchInfo, &wasAdded, &newWatcher);
+
+    watchInfo->isWatched = 1;
+
+    PRINT_DEBUG("%u %u %u %lld %f %d %d",
+                "AddFieldWatch eg %u, eid %u, fieldId %u, mfu %lld, msa %f, mka %d, sfu %d",
+                watchEntityGroupId,
+                watchEntityId,
+                dcgmFieldId,
+                (long long int)monitorFrequencyUsec,
+                maxSampleAge,
+                maxKeepSamples,
+                subscribeForUpdates ? 1 : 0);
 
-    PRINT_DEBUG("%u %d", "Found match for PID %u after %d records", pid, Nseen);
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetInt64SummaryData(dcgm_field_entity_group_t entityGroupId,
-                                                   dcgm_field_eid_t entityId,
-                                                   unsigned short dcgmFieldId,
-                                                   int numSummaryTypes,
-                                                   DcgmcmSummaryType_t *summaryTypes,
-                                                   long long *summaryValues,
-                                                   timelib64_t startTime,
-                                                   timelib64_t endTime,
-                                                   pfUseEntryForSummary pfUseEntryCB,
-                                                   void *userData)
+dcgmReturn_t DcgmCacheManager::RemoveEntityFieldWatch(dcgm_field_entity_group_t entityGroupId,
+                                                      unsigned int entityId,
+                                                      unsigned short dcgmFieldId,
+                                                      int clearCache,
+                                                      DcgmWatcher watcher)
 {
-    dcgmcm_watch_info_p watchInfo = 0;
-    int stIndex;
+    dcgmcm_watch_info_p watchInfo;
+    dcgmMutexReturn_t mutexReturn;
+    dcgm_watch_watcher_info_t remWatcher;
+    dcgmReturn_t retSt = DCGM_ST_OK;
 
-    if (!dcgmFieldId || numSummaryTypes < 1 || !summaryTypes || !summaryValues)
+    if (dcgmFieldId >= DCGM_FI_MAX_FIELDS)
         return DCGM_ST_BADPARAM;
 
-    dcgm_field_entity_group_t watchEntityGroupId = entityGroupId;
-    unsigned int watchEntityId                   = entityId;
-
-    /* Initialize all return data to blank */
-    for (stIndex = 0; stIndex < numSummaryTypes; stIndex++)
-    {
-        summaryValues[stIndex] = DCGM_INT64_BLANK;
-    }
-
-    dcgm_mutex_lock(m_mutex);
-
-    watchInfo = GetEntityWatchInfo(watchEntityGroupId, watchEntityId, dcgmFieldId, 0);
+    /* Populate the cache manager version of watcher so we can remove it in this watchInfo's
+       watcher table */
+    remWatcher.watcher = watcher;
 
-    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
-    if (dcgmReturn != DCGM_ST_OK)
+    if (entityGroupId == DCGM_FE_SWITCH)
     {
-        dcgm_mutex_unlock(m_mutex);
-        return dcgmReturn;
-    }
+        retSt = helperNvSwitchRemoveFieldWatch(watcher);
 
-    if (watchInfo->timeSeries->tsType != TS_TYPE_INT64)
-    {
-        PRINT_ERROR(
-            "%u %d", "Expected type TS_TYPE_INT64 for field %u. Got %d", dcgmFieldId, watchInfo->timeSeries->tsType);
-        dcgm_mutex_unlock(m_mutex);
-        return DCGM_ST_GENERIC_ERROR;
+        if (retSt != DCGM_ST_OK)
+        {
+            DCGM_LOG_ERROR << "Got status " << errorString(retSt) << "(" << retSt << ")"
+                           << " when trying to unset watches";
+        }
     }
 
-    /* Data type is assumed to be a time series type */
-    timeseries_p timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
-    timeseries_entry_p entry  = 0;
-    timelib64_t prevTimestamp = 0;
-    int Nseen                 = 0;
-    long long value = 0, prevValue = 0, sumValue = 0;
-    long long firstValue = DCGM_INT64_BLANK;
+    mutexReturn = dcgm_mutex_lock_me(m_mutex);
 
-    /* Walk forward  */
-    if (startTime)
+    watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
+    if (!watchInfo)
     {
-        timeseries_entry_t key;
-
-        key.usecSince1970 = startTime;
-        entry = (timeseries_entry_p)keyedvector_find_by_key(timeseries->keyedVector, &key, KV_LGE_GREATEQUAL, &cursor);
+        retSt = DCGM_ST_NOT_WATCHED;
     }
     else
-        entry = (timeseries_entry_p)keyedvector_first(timeseries->keyedVector, &cursor);
-
-    for (; entry; entry = (timeseries_entry_p)keyedvector_next(timeseries->keyedVector, &cursor))
-    {
-        /* Past our time range? */
-        if (endTime && entry->usecSince1970 > endTime)
-            break;
+        RemoveWatcher(watchInfo, &remWatcher);
 
+    if (mutexReturn == DCGM_MUTEX_ST_OK)
+        dcgm_mutex_unlock(m_mutex);
 
-        if (pfUseEntryCB)
-        {
-            if (!pfUseEntryCB(entry, userData))
-            {
-                continue;
-            }
-        }
+    PRINT_DEBUG("%u %u %u %d",
+                "RemoveEntityFieldWatch eg %u, eid %u, nvmlFieldId %u, clearCache %d",
+                entityGroupId,
+                entityId,
+                dcgmFieldId,
+                clearCache);
 
-        Nseen++;
-        value = entry->val.i64;
-
-        /* All of the current summary types ignore blank values */
-        if (DCGM_INT64_IS_BLANK(value))
-        {
-            PRINT_DEBUG("%d %u", "Skipping blank value at Nseen %d. fieldId %u", Nseen, watchInfo->watchKey.fieldId);
-            prevValue     = value;
-            prevTimestamp = entry->usecSince1970;
-            continue;
-        }
-
-        /* Keep track of first non-blank value */
-        if (DCGM_INT64_IS_BLANK(firstValue))
-        {
-            firstValue = value;
-        }
-
-        /* Keep a running sum */
-        sumValue += value;
-
-        /* Walk over each summary type the caller is requesting and do the necessary work
-         * for this value */
-        for (stIndex = 0; stIndex < numSummaryTypes; stIndex++)
-        {
-            switch (summaryTypes[stIndex])
-            {
-                case DcgmcmSummaryTypeMinimum:
-                    if (DCGM_INT64_IS_BLANK(summaryValues[stIndex]) || value < summaryValues[stIndex])
-                    {
-                        summaryValues[stIndex] = value;
-                    }
-                    break;
-
-                case DcgmcmSummaryTypeMaximum:
-                    if (DCGM_INT64_IS_BLANK(summaryValues[stIndex]) || value > summaryValues[stIndex])
-                    {
-                        summaryValues[stIndex] = value;
-                    }
-                    break;
-
-                case DcgmcmSummaryTypeAverage:
-                    summaryValues[stIndex] = sumValue / (long long)Nseen;
-                    break;
+    return retSt;
+}
 
-                case DcgmcmSummaryTypeSum:
-                    summaryValues[stIndex] = sumValue;
-                    break;
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AddGlobalFieldWatch(unsigned short dcgmFieldId,
+                                                   timelib64_t monitorFrequencyUsec,
+                                                   double maxSampleAge,
+                                                   int maxKeepSamples,
+                                                   DcgmWatcher watcher,
+                                                   bool subscribeForUpdates)
+{
+    dcgmcm_watch_info_p watchInfo;
+    bool wasAdded = false;
+    dcgm_watch_watcher_info_t newWatcher;
 
-                case DcgmcmSummaryTypeCount:
-                    summaryValues[stIndex] = Nseen;
-                    break;
+    if (dcgmFieldId >= DCGM_FI_MAX_FIELDS)
+        return DCGM_ST_BADPARAM;
 
-                case DcgmcmSummaryTypeIntegral:
-                {
-                    timelib64_t timeDiff;
-                    long long avgValue, area;
+    dcgm_mutex_lock(m_mutex);
 
-                    /* Need a time difference to calculate an area */
-                    if (!prevTimestamp)
-                    {
-                        summaryValues[stIndex] = 0; /* Make sure our starting value is non-blank */
-                        break;
-                    }
+    watchInfo = GetGlobalWatchInfo(dcgmFieldId, 1);
 
-                    avgValue = (value + prevValue) / 2;
-                    timeDiff = entry->usecSince1970 - prevTimestamp;
-                    area     = (avgValue * timeDiff);
-                    summaryValues[stIndex] += area;
-                    break;
-                }
+    /* Populate the cache manager version of watcher so we can insert/update it in this watchInfo's
+        watcher table */
+    newWatcher.watcher              = watcher;
+    newWatcher.monitorFrequencyUsec = monitorFrequencyUsec;
+    newWatcher.maxAgeUsec           = GetMaxAgeUsec(monitorFrequencyUsec, maxSampleAge, maxKeepSamples);
+    newWatcher.isSubscribed         = subscribeForUpdates;
 
-                case DcgmcmSummaryTypeDifference:
-                {
-                    summaryValues[stIndex] = value - firstValue;
-                    break;
-                }
+    /* New watch? */
+    if (!watchInfo->isWatched)
+    {
+        NvmlPreWatch(-1, dcgmFieldId);
+    }
 
-                default:
-                    dcgm_mutex_unlock(m_mutex);
-                    PRINT_ERROR("%d", "Unhandled summaryType %d", (int)summaryTypes[stIndex]);
-                    return DCGM_ST_BADPARAM;
-            }
-        }
+    /* Add or update the watcher in our table */
+    AddOrUpdateWatcher(watchInfo, &wasAdded, &newWatcher);
 
-        /* Save previous values before going around loop */
-        prevValue     = value;
-        prevTimestamp = entry->usecSince1970;
-    }
+    watchInfo->isWatched = 1;
 
     dcgm_mutex_unlock(m_mutex);
 
-    if (!Nseen)
-    {
-        PRINT_DEBUG("", "No values found");
-
-        if (!watchInfo->isWatched)
-            return DCGM_ST_NOT_WATCHED;
-        else
-            return DCGM_ST_NO_DATA;
-    }
+    PRINT_DEBUG("%u %lld %f %d %d",
+                "AddGlobalFieldWatch dcgmFieldId %u, mfu %lld, msa %f, mka %d, sfu %d",
+                dcgmFieldId,
+                (long long int)monitorFrequencyUsec,
+                maxSampleAge,
+                maxKeepSamples,
+                subscribeForUpdates ? 1 : 0);
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetFp64SummaryData(dcgm_field_entity_group_t entityGroupId,
-                                                  dcgm_field_eid_t entityId,
-                                                  unsigned short dcgmFieldId,
-                                                  int numSummaryTypes,
-                                                  DcgmcmSummaryType_t *summaryTypes,
-                                                  double *summaryValues,
-                                                  timelib64_t startTime,
-                                                  timelib64_t endTime,
-                                                  pfUseEntryForSummary pfUseEntryCB,
-                                                  void *userData)
+dcgmReturn_t DcgmCacheManager::RemoveGlobalFieldWatch(unsigned short dcgmFieldId, int clearCache, DcgmWatcher watcher)
 {
-    dcgmcm_watch_info_p watchInfo = 0;
-    int stIndex;
+    dcgmcm_watch_info_p watchInfo;
+    dcgmMutexReturn_t mutexReturn;
+    dcgm_watch_watcher_info_t remWatcher;
 
-    if (!dcgmFieldId || numSummaryTypes < 1 || !summaryTypes || !summaryValues)
+    if (dcgmFieldId >= DCGM_FI_MAX_FIELDS)
         return DCGM_ST_BADPARAM;
 
-    dcgm_field_entity_group_t watchEntityGroupId = entityGroupId;
-    unsigned int watchEntityId                   = entityId;
+    /* Populate the cache manager version of watcher so we can remove it in this watchInfo's
+       watcher table */
+    remWatcher.watcher = watcher;
 
-    /* Initialize all return data to blank */
-    for (stIndex = 0; stIndex < numSummaryTypes; stIndex++)
-    {
-        summaryValues[stIndex] = DCGM_FP64_BLANK;
-    }
+    mutexReturn = dcgm_mutex_lock(m_mutex);
 
-    dcgm_mutex_lock(m_mutex);
+    watchInfo = GetGlobalWatchInfo(dcgmFieldId, 0);
 
-    watchInfo = GetEntityWatchInfo(watchEntityGroupId, watchEntityId, dcgmFieldId, 0);
+    if (watchInfo)
+        RemoveWatcher(watchInfo, &remWatcher);
 
-    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
-    if (dcgmReturn != DCGM_ST_OK)
-    {
+    if (mutexReturn == DCGM_MUTEX_ST_OK)
         dcgm_mutex_unlock(m_mutex);
-        return dcgmReturn;
-    }
 
-    if (watchInfo->timeSeries->tsType != TS_TYPE_DOUBLE)
-    {
-        PRINT_ERROR(
-            "%u %d", "Expected type TS_TYPE_DOUBLE for field %u. Got %d", dcgmFieldId, watchInfo->timeSeries->tsType);
-        dcgm_mutex_unlock(m_mutex);
-        return DCGM_ST_GENERIC_ERROR;
-    }
+    PRINT_DEBUG("%u %d", "RemoveGlobalFieldWatch dcgmFieldId %u, clearCache %d", dcgmFieldId, clearCache);
 
-    /* Data type is assumed to be a time series type */
-    timeseries_p timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
-    timeseries_entry_p entry  = 0;
-    timelib64_t prevTimestamp = 0;
-    int Nseen                 = 0;
-    double value = 0.0, prevValue = 0.0, sumValue = 0.0;
-    double firstValue = DCGM_FP64_BLANK;
+    return DCGM_ST_OK;
+}
 
-    /* Walk forward  */
-    if (startTime)
-    {
-        timeseries_entry_t key;
+/*****************************************************************************/
+/*
+ * Helper to convert a timeseries entry to a sample
+ *
+ */
+static dcgmReturn_t DcgmcmTimeSeriesEntryToSample(dcgmcm_sample_p sample,
+                                                  timeseries_entry_p entry,
+                                                  timeseries_p timeseries)
+{
+    sample->timestamp = entry->usecSince1970;
 
-        key.usecSince1970 = startTime;
-        entry = (timeseries_entry_p)keyedvector_find_by_key(timeseries->keyedVector, &key, KV_LGE_GREATEQUAL, &cursor);
-    }
-    else
-        entry = (timeseries_entry_p)keyedvector_first(timeseries->keyedVector, &cursor);
 
-    for (; entry; entry = (timeseries_entry_p)keyedvector_next(timeseries->keyedVector, &cursor))
+    switch (timeseries->tsType)
     {
-        /* Past our time range? */
-        if (endTime && entry->usecSince1970 > endTime)
+        case TS_TYPE_DOUBLE:
+            sample->val.d  = entry->val.dbl;
+            sample->val2.d = entry->val2.dbl;
             break;
-
-        if (pfUseEntryCB)
-        {
-            if (!pfUseEntryCB(entry, userData))
+        case TS_TYPE_INT64:
+            sample->val.i64  = entry->val.i64;
+            sample->val2.i64 = entry->val2.i64;
+            break;
+        case TS_TYPE_STRING:
+            sample->val.str = strdup((char *)entry->val.ptr);
+            if (!sample->val.str)
             {
-                continue;
+                sample->val2.ptrSize = 0;
+                return DCGM_ST_MEMORY;
             }
-        }
-
-        Nseen++;
-        value = entry->val.dbl;
-
-        /* All of the current summary types ignore blank values */
-        if (DCGM_FP64_IS_BLANK(value))
-        {
-            PRINT_DEBUG("%d %u", "Skipping blank value at Nseen %d. fieldId %u", Nseen, watchInfo->watchKey.fieldId);
-            prevValue     = value;
-            prevTimestamp = entry->usecSince1970;
-            continue;
-        }
-
-        /* Keep track of the first non-blank value seen */
-        if (DCGM_FP64_IS_BLANK(firstValue))
-        {
-            firstValue = value;
-        }
-
-        /* Keep a running sum */
-        sumValue += value;
-
-        /* Walk over each summary type the caller is requesting and do the necessary work
-         * for this value */
-        for (stIndex = 0; stIndex < numSummaryTypes; stIndex++)
-        {
-            switch (summaryTypes[stIndex])
+            sample->val2.ptrSize = strlen(sample->val.str) + 1;
+            break;
+        case TS_TYPE_BLOB:
+            sample->val.blob = malloc(entry->val2.ptrSize);
+            if (!sample->val.blob)
             {
-                case DcgmcmSummaryTypeMinimum:
-                    if (DCGM_FP64_IS_BLANK(summaryValues[stIndex]) || value < summaryValues[stIndex])
-                    {
-                        summaryValues[stIndex] = value;
-                    }
-                    break;
-
-                case DcgmcmSummaryTypeMaximum:
-                    if (DCGM_FP64_IS_BLANK(summaryValues[stIndex]) || value > summaryValues[stIndex])
-                    {
-                        summaryValues[stIndex] = value;
-                    }
-                    break;
-
-                case DcgmcmSummaryTypeAverage:
-                    summaryValues[stIndex] = sumValue / (double)Nseen;
-                    break;
-
-                case DcgmcmSummaryTypeSum:
-                    summaryValues[stIndex] = sumValue;
-                    break;
-
-                case DcgmcmSummaryTypeCount:
-                    summaryValues[stIndex] = Nseen;
-                    break;
-
-                case DcgmcmSummaryTypeIntegral:
-                {
-                    timelib64_t timeDiff;
-                    double avgValue, area;
-
-                    /* Need a time difference to calculate an area */
-                    if (!prevTimestamp)
-                    {
-                        summaryValues[stIndex] = 0; /* Make sure our starting value is non-blank */
-                        break;
-                    }
-
-                    avgValue = (value + prevValue) / 2.0;
-                    timeDiff = entry->usecSince1970 - prevTimestamp;
-                    area     = (avgValue * timeDiff);
-                    summaryValues[stIndex] += area;
-                    break;
-                }
-
-                case DcgmcmSummaryTypeDifference:
-                {
-                    summaryValues[stIndex] = value - firstValue;
-                    break;
-                }
-
-                default:
-                    dcgm_mutex_unlock(m_mutex);
-                    PRINT_ERROR("%d", "Unhandled summaryType %d", (int)summaryTypes[stIndex]);
-                    return DCGM_ST_BADPARAM;
+                sample->val2.ptrSize = 0;
+                return DCGM_ST_MEMORY;
             }
-        }
-
-        /* Save previous values before going around loop */
-        prevValue     = value;
-        prevTimestamp = entry->usecSince1970;
-    }
-
-    dcgm_mutex_unlock(m_mutex);
-
-    if (!Nseen)
-    {
-        PRINT_DEBUG("", "No values found");
+            sample->val2.ptrSize = entry->val2.ptrSize;
+            memcpy(sample->val.blob, entry->val.ptr, entry->val2.ptrSize);
+            break;
 
-        if (!watchInfo->isWatched)
-            return DCGM_ST_NOT_WATCHED;
-        else
-            return DCGM_ST_NO_DATA;
+        default:
+            PRINT_ERROR("%d", "Shouldn't get here for type %d", (int)timeseries->tsType);
+            return DCGM_ST_BADPARAM;
     }
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetSamples(dcgm_field_entity_group_t entityGroupId,
-                                          dcgm_field_eid_t entityId,
-                                          unsigned short dcgmFieldId,
-                                          dcgmcm_sample_p samples,
-                                          int *Msamples,
-                                          timelib64_t startTime,
-                                          timelib64_t endTime,
-                                          dcgmOrder_t order)
+static dcgmReturn_t DcgmcmWriteTimeSeriesEntryToFvBuffer(dcgm_field_entity_group_t entityGroupId,
+                                                         dcgm_field_eid_t entityId,
+                                                         unsigned short fieldId,
+                                                         timeseries_entry_p entry,
+                                                         DcgmFvBuffer *fvBuffer,
+                                                         timeseries_p timeseries)
 {
-    dcgm_field_meta_p fieldMeta = 0;
-    dcgmReturn_t st, retSt = DCGM_ST_OK;
-    timeseries_p timeseries = 0;
-    int maxSamples;
-    dcgmcm_watch_info_p watchInfo = 0;
-
-    if (!samples || !Msamples || (*Msamples) < 1)
-        return DCGM_ST_BADPARAM;
-    if (order != DCGM_ORDER_ASCENDING && order != DCGM_ORDER_DESCENDING)
-        return DCGM_ST_BADPARAM;
+    dcgmBufferedFv_t *fv = 0;
 
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-        return DCGM_ST_UNKNOWN_FIELD;
+    switch (timeseries->tsType)
+    {
+        case TS_TYPE_DOUBLE:
+            fv = fvBuffer->AddDoubleValue(
+                entityGroupId, entityId, fieldId, entry->val.dbl, entry->usecSince1970, DCGM_ST_OK);
+            break;
+        case TS_TYPE_INT64:
+            fv = fvBuffer->AddInt64Value(
+                entityGroupId, entityId, fieldId, entry->val.i64, entry->usecSince1970, DCGM_ST_OK);
+            break;
+        case TS_TYPE_STRING:
+            fv = fvBuffer->AddStringValue(
+                entityGroupId, entityId, fieldId, (char *)entry->val.ptr, entry->usecSince1970, DCGM_ST_OK);
+            break;
+        case TS_TYPE_BLOB:
+            fv = fvBuffer->AddBlobValue(entityGroupId,
+                                        entityId,
+                                        fieldId,
+                                        entry->val.ptr,
+                                        entry->val2.ptrSize,
+                                        entry->usecSince1970,
+                                        DCGM_ST_OK);
+            break;
 
-    dcgm_field_entity_group_t watchEntityGroupId = entityGroupId;
-    unsigned int watchEntityId                   = entityId;
+        default:
+            PRINT_ERROR("%d", "Shouldn't get here for type %d", (int)timeseries->tsType);
+            return DCGM_ST_BADPARAM;
+    }
 
-    if (fieldMeta->scope == DCGM_FS_GLOBAL && watchEntityGroupId != DCGM_FE_NONE)
+    if (!fv)
     {
-        DCGM_LOG_DEBUG << "Fixing entityGroupId for global field";
-        watchEntityGroupId = DCGM_FE_NONE;
+        PRINT_ERROR("%u %u %u",
+                    "Unexpected NULL fv returned for eg %u, eid %u, fieldId %u. Out of memory?",
+                    entityGroupId,
+                    entityId,
+                    fieldId);
+        return DCGM_ST_MEMORY;
     }
 
-    dcgm_mutex_lock(m_mutex);
+    // PRINT_DEBUG("%u %u %u %d", "eg %u, eid %u, fieldId %u buffered %d bytes.",
+    //            entityGroupId, entityId, fieldId, fv->length);
 
-    if (watchEntityGroupId != DCGM_FE_NONE)
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t DcgmcmWriteSampleToFvBuffer(dcgm_field_entity_group_t entityGroupId,
+                                                dcgm_field_eid_t entityId,
+                                                dcgm_field_meta_p fieldMeta,
+                                                dcgmcm_sample_p sample,
+                                                DcgmFvBuffer *fvBuffer)
+{
+    dcgmBufferedFv_t *fv   = 0;
+    unsigned short fieldId = fieldMeta->fieldId;
+
+    switch (fieldMeta->fieldType)
     {
-        watchInfo = GetEntityWatchInfo(watchEntityGroupId, watchEntityId, fieldMeta->fieldId, 0);
+        case DCGM_FT_DOUBLE:
+            fv = fvBuffer->AddDoubleValue(
+                entityGroupId, entityId, fieldId, sample->val.d, sample->timestamp, DCGM_ST_OK);
+            break;
+        case DCGM_FT_STRING:
+            fv = fvBuffer->AddStringValue(
+                entityGroupId, entityId, fieldId, sample->val.str, sample->timestamp, DCGM_ST_OK);
+            break;
+        case DCGM_FT_BINARY:
+            fv = fvBuffer->AddBlobValue(entityGroupId,
+                                        entityId,
+                                        fieldId,
+                                        sample->val.blob,
+                                        sample->val2.ptrSize,
+                                        sample->timestamp,
+                                        DCGM_ST_OK);
+            break;
+        default: /* DCGM_FT_INT64 and DCGM_FT_TIMESTAMP */
+            fv = fvBuffer->AddInt64Value(
+                entityGroupId, entityId, fieldId, sample->val.i64, sample->timestamp, DCGM_ST_OK);
+            break;
     }
-    else
+
+    if (!fv)
     {
-        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+        DCGM_LOG_ERROR << "Unexpected NULL fv returned for eg " << entityGroupId << ", eid " << entityId
+                       << ", fieldId " << fieldId << ". Out of memory?";
+        return DCGM_ST_MEMORY;
     }
 
-    maxSamples = *Msamples; /* Store the passed in value */
-    *Msamples  = 0;         /* No samples collected yet */
+    return DCGM_ST_OK;
+}
 
-    st = PrecheckWatchInfoForSamples(watchInfo);
-    if (st != DCGM_ST_OK)
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetUniquePidLists(dcgm_field_entity_group_t entityGroupId,
+                                                 dcgm_field_eid_t entityId,
+                                                 unsigned short dcgmFieldId,
+                                                 unsigned int excludePid,
+                                                 dcgmProcessUtilInfo_t *pidInfo,
+                                                 unsigned int *numPids,
+                                                 timelib64_t startTime,
+                                                 timelib64_t endTime)
+{
+    dcgmcm_watch_info_p watchInfo = 0;
+    unsigned int maxPids;
+
+    if (!pidInfo || !numPids)
+        return DCGM_ST_BADPARAM;
+    if (dcgmFieldId != DCGM_FI_DEV_GRAPHICS_PIDS && dcgmFieldId != DCGM_FI_DEV_COMPUTE_PIDS)
+        return DCGM_ST_BADPARAM;
+
+    maxPids  = *numPids;
+    *numPids = 0;
+
+    dcgm_mutex_lock(m_mutex);
+
+    watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
+
+    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
+    if (dcgmReturn != DCGM_ST_OK)
     {
         dcgm_mutex_unlock(m_mutex);
-        return st;
+        return dcgmReturn;
     }
 
-    /* Data type is assumed to be a time series type */
+    if (watchInfo->timeSeries->tsType != TS_TYPE_BLOB)
+    {
+        PRINT_ERROR("%u %d", "Expected type TS_TYPE_BLOB for %u. Got %d", dcgmFieldId, watchInfo->timeSeries->tsType);
+        dcgm_mutex_unlock(m_mutex);
+        return DCGM_ST_GENERIC_ERROR;
+    }
 
-    timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
+    /* Data type is assumed to be a time series type */
+    timeseries_p timeseries = watchInfo->timeSeries;
+    timeseries_cursor_t cursor;
     timeseries_entry_p entry = 0;
+    dcgmRunningProcess_t *proc;
+    int i, havePid;
 
-    if (order == DCGM_ORDER_ASCENDING)
+    /* Walk forward  */
+    if (startTime)
     {
-        /* Which entry we start on depends on if a starting timestamp was provided or not */
-        if (!startTime)
+        entry = timeseries_find(timeseries, startTime, TS_LGE_GREATEQUAL, &cursor);
+    }
+    else
+        entry = timeseries_first(timeseries, &cursor);
+
+    for (; entry; entry = timeseries_next(timeseries, &cursor))
+    {
+        /* Past our time range? */
+        if (endTime && entry->usecSince1970 > endTime)
+            break;
+
+        proc = (dcgmRunningProcess_t *)entry->val.ptr;
+        if (!proc || proc->version != dcgmRunningProcess_version)
         {
-            entry = (timeseries_entry_p)keyedvector_first(timeseries->keyedVector, &cursor);
+            PRINT_ERROR("", "Skipping invalid entry");
+            continue;
         }
-        else
-        {
-            timeseries_entry_t key;
 
-            key.usecSince1970 = startTime;
-            entry             = (timeseries_entry_p)keyedvector_find_by_key(
-                timeseries->keyedVector, &key, KV_LGE_GREATEQUAL, &cursor);
-        }
+        if (excludePid && excludePid == proc->pid)
+            continue; /* Skip exclusion pid */
 
-        /* Walk all samples until we fill our buffer, run out of samples, or go past our end timestamp */
-        for (; entry && (*Msamples) < maxSamples;
-             entry = (timeseries_entry_p)keyedvector_next(timeseries->keyedVector, &cursor))
+        /* See if we already have this PID. Use a linear search since we don't expect to
+         * return large lists
+         */
+        havePid = 0;
+        for (i = 0; i < (int)(*numPids); i++)
         {
-            /* Past our time range? */
-            if (endTime && entry->usecSince1970 > endTime)
-                break;
-
-            /* Got an entry. Convert it to a sample */
-            st = DcgmcmTimeSeriesEntryToSample(&samples[*Msamples], entry, timeseries);
-            if (st)
+            if (proc->pid == pidInfo[i].pid)
             {
-                *Msamples = 0;
-                dcgm_mutex_unlock(m_mutex);
-                return st;
+                havePid = 1;
+                break;
             }
-
-            (*Msamples)++;
-        }
-    }
-    else /* DCGM_ORDER_DESCENDING */
-    {
-        /* Which entry we start on depends on if a starting timestamp was provided or not */
-        if (!endTime)
-        {
-            entry = (timeseries_entry_p)keyedvector_last(timeseries->keyedVector, &cursor);
-        }
-        else
-        {
-            timeseries_entry_t key;
-
-            key.usecSince1970 = endTime;
-            entry
-                = (timeseries_entry_p)keyedvector_find_by_key(timeseries->keyedVector, &key, KV_LGE_LESSEQUAL, &cursor);
         }
 
-        /* Walk all samples until we fill our buffer, run out of samples, or go past our end timestamp */
-        for (; entry && (*Msamples) < maxSamples;
-             entry = (timeseries_entry_p)keyedvector_prev(timeseries->keyedVector, &cursor))
-        {
-            /* Past our time range? */
-            if (startTime && entry->usecSince1970 < startTime)
-                break;
+        if (havePid)
+            continue; /* Already have this one */
 
-            /* Got an entry. Convert it to a sample */
-            st = DcgmcmTimeSeriesEntryToSample(&samples[*Msamples], entry, timeseries);
-            if (st)
-            {
-                *Msamples = 0;
-                dcgm_mutex_unlock(m_mutex);
-                return st;
-            }
+        /* We found a new PID */
+        pidInfo[*numPids].pid = proc->pid;
+        (*numPids)++;
 
-            (*Msamples)++;
-        }
+        /* Have we reached our capacity? */
+        if ((*numPids) >= maxPids)
+            break;
     }
 
-    /* Handle case where no samples are returned because of nvml errors calling the API */
-    if (!(*Msamples))
+    dcgm_mutex_unlock(m_mutex);
+
+    if (!(*numPids))
     {
-        if (keyedvector_size(timeseries->keyedVector) > 0)
-            retSt = DCGM_ST_NO_DATA; /* User just asked for a time range that has no records */
-        else if (watchInfo->lastStatus != NVML_SUCCESS)
-            retSt = NvmlReturnToDcgmReturn(watchInfo->lastStatus);
-        else if (!watchInfo->isWatched)
-            retSt = DCGM_ST_NOT_WATCHED;
+        if (!watchInfo->isWatched)
+            return DCGM_ST_NOT_WATCHED;
         else
-            retSt = DCGM_ST_NO_DATA;
+            return DCGM_ST_NO_DATA;
     }
 
-
-    dcgm_mutex_unlock(m_mutex);
-    return retSt;
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetLatestSample(dcgm_field_entity_group_t entityGroupId,
-                                               dcgm_field_eid_t entityId,
-                                               unsigned short dcgmFieldId,
-                                               dcgmcm_sample_p sample,
-                                               DcgmFvBuffer *fvBuffer)
+dcgmReturn_t DcgmCacheManager::GetUniquePidLists(dcgm_field_entity_group_t entityGroupId,
+                                                 dcgm_field_eid_t entityId,
+                                                 unsigned short dcgmFieldId,
+                                                 unsigned int excludePid,
+                                                 unsigned int *pids,
+                                                 unsigned int *numPids,
+                                                 timelib64_t startTime,
+                                                 timelib64_t endTime)
 {
-    dcgm_field_meta_p fieldMeta = 0;
-    dcgmReturn_t st, retSt = DCGM_ST_OK;
-    timeseries_p timeseries       = 0;
     dcgmcm_watch_info_p watchInfo = 0;
+    unsigned int maxPids;
 
-    if (!sample && !fvBuffer)
+    if (!pids || !numPids)
+        return DCGM_ST_BADPARAM;
+    if (dcgmFieldId != DCGM_FI_DEV_GRAPHICS_PIDS && dcgmFieldId != DCGM_FI_DEV_COMPUTE_PIDS)
         return DCGM_ST_BADPARAM;
 
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-    {
-        if (fvBuffer)
-            fvBuffer->AddInt64Value(entityGroupId, entityId, dcgmFieldId, 0, 0, DCGM_ST_UNKNOWN_FIELD);
-        return DCGM_ST_UNKNOWN_FIELD;
-    }
+    maxPids  = *numPids;
+    *numPids = 0;
 
-    dcgm_field_entity_group_t watchEntityGroupId = entityGroupId;
-    unsigned int watchEntityId                   = entityId;
+    dcgm_mutex_lock(m_mutex);
 
-    DcgmLockGuard dlg(m_mutex);
+    watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
 
-    if (fieldMeta->scope == DCGM_FS_GLOBAL && watchEntityGroupId != DCGM_FE_NONE)
+    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
+    if (dcgmReturn != DCGM_ST_OK)
     {
-        DCGM_LOG_DEBUG << "Fixing entityGroupId for global field";
-        watchEntityGroupId = DCGM_FE_NONE;
+        dcgm_mutex_unlock(m_mutex);
+        return dcgmReturn;
     }
 
-    /* Don't need to GetIsValidEntityId(entityGroupId, entityId) here because Get*WatchInfo will
-       return null if there isn't a valid watch */
-
-    if (watchEntityGroupId == DCGM_FE_NONE)
-        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
-    else
-        watchInfo = GetEntityWatchInfo(watchEntityGroupId, watchEntityId, fieldMeta->fieldId, 0);
-
-    st = PrecheckWatchInfoForSamples(watchInfo);
-    if (st != DCGM_ST_OK)
+    if (watchInfo->timeSeries->tsType != TS_TYPE_BLOB)
     {
-        if (fvBuffer)
-            fvBuffer->AddInt64Value(watchEntityGroupId, watchEntityId, dcgmFieldId, 0, 0, st);
-        return st;
+        PRINT_ERROR("%u %d", "Expected type TS_TYPE_BLOB for %u. Got %d", dcgmFieldId, watchInfo->timeSeries->tsType);
+        dcgm_mutex_unlock(m_mutex);
+        return DCGM_ST_GENERIC_ERROR;
     }
 
-    /* Data type is assumed to be a time series type */
+    /* The processes that ran during the window come from the GPU's interval tree of process
+     * lifetimes rather than a walk over every sample of the window
+     */
+    std::vector<dcgm_process_interval_t> intervals;
+    if (entityGroupId == DCGM_FE_GPU && entityId < DCGM_MAX_NUM_DEVICES)
+        m_processIntervals[entityId][ProcessIntervalsIndex(dcgmFieldId)].Query(startTime, endTime, intervals);
 
-    timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
-    timeseries_entry_p entry = (timeseries_entry_p)keyedvector_last(timeseries->keyedVector, &cursor);
-    if (!entry)
+    for (dcgm_process_interval_t const &interval : intervals)
     {
-        /* No entries in time series. If NVML apis failed, return their error code */
-        if (watchInfo->lastStatus != NVML_SUCCESS)
-            retSt = NvmlReturnToDcgmReturn(watchInfo->lastStatus);
-        else if (!watchInfo->isWatched)
-            retSt = DCGM_ST_NOT_WATCHED;
-        else
-            retSt = DCGM_ST_NO_DATA;
+        if (excludePid && excludePid == interval.pid)
+            continue; /* Skip exclusion pid */
 
-        if (fvBuffer)
-            fvBuffer->AddInt64Value(watchEntityGroupId, watchEntityId, dcgmFieldId, 0, 0, retSt);
-        return retSt;
-    }
+        /* A reused PID has more than one interval. Use a linear search since we don't expect to
+         * return large lists
+         */
+        if (std::find(pids, pids + *numPids, interval.pid) != pids + *numPids)
+            continue; /* Already have this one */
 
-    /* Got an entry. Convert it to a sample */
-    if (sample)
-    {
-        st    = DcgmcmTimeSeriesEntryToSample(sample, entry, timeseries);
-        retSt = st;
+        /* We found a new PID */
+        pids[*numPids] = interval.pid;
+        (*numPids)++;
+
+        /* Have we reached our capacity? */
+        if ((*numPids) >= maxPids)
+            break;
     }
-    /* If the user provided a FV buffer, append our sample to it */
-    if (fvBuffer)
+
+    dcgm_mutex_unlock(m_mutex);
+
+    if (!(*numPids))
     {
-        st = DcgmcmWriteTimeSeriesEntryToFvBuffer(
-            watchEntityGroupId, watchEntityId, dcgmFieldId, entry, fvBuffer, timeseries);
-        retSt = st;
+        if (!watchInfo->isWatched)
+            return DCGM_ST_NOT_WATCHED;
+        else
+            return DCGM_ST_NO_DATA;
     }
 
-    return retSt;
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetMultipleLatestSamples(std::vector<dcgmGroupEntityPair_t> &entities,
-                                                        std::vector<unsigned short> &fieldIds,
-                                                        DcgmFvBuffer *fvBuffer)
+dcgmReturn_t DcgmCacheManager::PrecheckWatchInfoForSamples(dcgmcm_watch_info_p watchInfo)
 {
-    std::vector<dcgmGroupEntityPair_t>::iterator entityIt;
-    std::vector<unsigned short>::iterator fieldIdIt;
+    /* Note: This code assumes that the cache manager is locked */
 
-    if (!fvBuffer)
-        return DCGM_ST_BADPARAM;
+    if (!watchInfo)
+    {
+        PRINT_DEBUG("", "PrecheckWatchInfoForSamples: not watched");
+        return DCGM_ST_NOT_WATCHED;
+    }
 
-    /* Lock the cache manager once for the whole request */
-    dcgm_mutex_lock(m_mutex);
+    /* Matching existing behavior: if there is data for an entity, then we can
+       return it. This bypasses recent NVML failures or the field no longer
+       being watched. */
+    if (watchInfo->timeSeries)
+        return DCGM_ST_OK;
 
-    for (entityIt = entities.begin(); entityIt != entities.end(); ++entityIt)
+    if (!watchInfo->isWatched)
     {
-        for (fieldIdIt = fieldIds.begin(); fieldIdIt != fieldIds.end(); ++fieldIdIt)
-        {
-            /* Buffer each sample. Errors are written as statuses for each fv in fvBuffer */
-            dcgmReturn_t ret
-                = GetLatestSample((*entityIt).entityGroupId, (*entityIt).entityId, (*fieldIdIt), 0, fvBuffer);
-            if (DCGM_ST_OK != ret)
-            {
-                DCGM_LOG_ERROR << "GetLatestSample returned " << errorString(ret) << " for entityId "
-                               << entityIt->entityId << " groupId " << entityIt->entityGroupId << " fieldId "
-                               << *fieldIdIt;
-            }
-        }
+        PRINT_DEBUG("%u %u %u",
+                    "eg %u, eid %u, fieldId %u not watched",
+                    watchInfo->watchKey.entityGroupId,
+                    watchInfo->watchKey.entityId,
+                    watchInfo->watchKey.fieldId);
+        return DCGM_ST_NOT_WATCHED;
     }
 
-    dcgm_mutex_unlock(m_mutex);
+    if (watchInfo->lastStatus != NVML_SUCCESS)
+    {
+        PRINT_DEBUG("%u %u %u %u",
+                    "eg %u, eid %u, fieldId %u NVML status %u",
+                    watchInfo->watchKey.entityGroupId,
+                    watchInfo->watchKey.entityId,
+                    watchInfo->watchKey.fieldId,
+                    watchInfo->lastStatus);
+        return NvmlReturnToDcgmReturn(watchInfo->lastStatus);
+    }
+
+    int numElements = timeseries_size(watchInfo->timeSeries);
+    if (!numElements)
+    {
+        PRINT_DEBUG("%u %u %u",
+                    "eg %u, eid %u, fieldId %u has NO DATA",
+                    watchInfo->watchKey.entityGroupId,
+                    watchInfo->watchKey.entityId,
+                    watchInfo->watchKey.fieldId);
+        return DCGM_ST_NO_DATA;
+    }
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::SetValue(int gpuId, unsigned short dcgmFieldId, dcgmcm_sample_p value)
+dcgmReturn_t DcgmCacheManager::GetUniquePidUtilLists(dcgm_field_entity_group_t entityGroupId,
+                                                     dcgm_field_eid_t entityId,
+                                                     unsigned short dcgmFieldId,
+                                                     unsigned int includePid,
+                                                     dcgmProcessUtilSample_t *processUtilSamples,
+                                                     unsigned int *numUniqueSamples,
+                                                     timelib64_t startTime,
+                                                     timelib64_t endTime)
 {
-    dcgm_field_meta_p fieldMeta = 0;
-    nvmlReturn_t nvmlReturn;
-    nvmlDevice_t nvmlDevice = 0;
-    timelib64_t now, expireTime;
     dcgmcm_watch_info_p watchInfo = 0;
-    dcgmcm_update_thread_t updateCtx;
+    unsigned int maxPids;
+    unsigned int numSamples = 0;
 
-    if (!value)
+    if (!processUtilSamples || !numUniqueSamples)
+        return DCGM_ST_BADPARAM;
+    if (dcgmFieldId != DCGM_FI_DEV_GPU_UTIL_SAMPLES && dcgmFieldId != DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES)
         return DCGM_ST_BADPARAM;
 
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-        return DCGM_ST_UNKNOWN_FIELD;
+    maxPids           = *numUniqueSamples;
+    *numUniqueSamples = 0;
 
-    memset(&updateCtx, 0, sizeof(updateCtx));
-    ClearThreadCtx(&updateCtx);
-    updateCtx.entityKey.entityGroupId = DCGM_FE_GPU;
-    updateCtx.entityKey.entityId      = gpuId;
-    updateCtx.entityKey.fieldId       = dcgmFieldId;
+    dcgm_mutex_lock(m_mutex);
 
-    if (fieldMeta->scope == DCGM_FS_ENTITY)
+    watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
+
+    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
+    if (dcgmReturn != DCGM_ST_OK)
     {
-        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, GpuIdToNvmlIndex(gpuId), dcgmFieldId, 1);
+        dcgm_mutex_unlock(m_mutex);
+        return dcgmReturn;
     }
-    else
+
+    if (watchInfo->timeSeries->tsType != TS_TYPE_DOUBLE)
     {
-        watchInfo = GetGlobalWatchInfo(dcgmFieldId, 1);
+        PRINT_ERROR("%u %d", "Expected type TS_TYPE_DOUBLE for %u. Got %d", dcgmFieldId, watchInfo->timeSeries->tsType);
+        dcgm_mutex_unlock(m_mutex);
+        return DCGM_ST_GENERIC_ERROR;
     }
 
-    now = timelib_usecSince1970();
-
-    expireTime = 0;
-    if (watchInfo->maxAgeUsec)
-        expireTime = now - watchInfo->maxAgeUsec;
-
-    /* Is the field watched? If so, cause live updates to occur */
-    if (watchInfo->isWatched)
-        updateCtx.watchInfo = watchInfo;
+    /* Data type is assumed to be a time series type */
+    timeseries_p timeseries = watchInfo->timeSeries;
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = 0;
+    int i;
+    double utilVal;
+    unsigned int pid;
+    std::unordered_map<unsigned int, unsigned int> pidIndex; /* PID -> index in processUtilSamples */
 
-    /* Do we need a device handle? */
-    if (fieldMeta->scope == DCGM_FS_DEVICE)
+    /* Walk forward  */
+    if (startTime)
     {
-        nvmlReturn = nvmlDeviceGetHandleByIndex_v2(GpuIdToNvmlIndex(gpuId), &nvmlDevice);
-        if (nvmlReturn != NVML_SUCCESS)
-        {
-            PRINT_ERROR("%d %u",
-                        "nvmlDeviceGetHandleByIndex_v2 returned %d for gpuId %u",
-                        (int)nvmlReturn,
-                        GpuIdToNvmlIndex(gpuId));
-            return NvmlReturnToDcgmReturn(nvmlReturn);
-        }
+        entry = timeseries_find(timeseries, startTime, TS_LGE_GREATEQUAL, &cursor);
     }
+    else
+        entry = timeseries_first(timeseries, &cursor);
 
-    switch (fieldMeta->fieldId)
+    for (; entry; entry = timeseries_next(timeseries, &cursor))
     {
-        case DCGM_FI_DEV_AUTOBOOST:
+        if (!entry)
         {
-            nvmlEnableState_t enabledState;
+            PRINT_ERROR("", "Skipping invalid entry");
+            continue;
+        }
 
-            enabledState = value->val.i64 ? NVML_FEATURE_ENABLED : NVML_FEATURE_DISABLED;
+        /* Past our time range? */
+        if (endTime && entry->usecSince1970 > endTime)
+            break;
 
-            nvmlReturn = nvmlDeviceSetDefaultAutoBoostedClocksEnabled(nvmlDevice, enabledState, 0);
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+        utilVal = entry->val.dbl;
+        pid     = (unsigned int)entry->val2.dbl;
 
-            if (watchInfo->isWatched)
-            {
-                AppendEntityInt64(&updateCtx, value->val.i64, 0, now, expireTime);
-            }
-            break;
+        /* Continue if it is an invalidPID or if the entry is not the one for which utilization is being looked for*/
+        if (std::numeric_limits<unsigned>::max() == pid || (includePid > 0 && pid != includePid))
+        {
+            numSamples++;
+            continue;
         }
 
-        case DCGM_FI_DEV_ENFORCED_POWER_LIMIT: /* Fall through is intentional */
-        case DCGM_FI_DEV_POWER_MGMT_LIMIT:
+        /* See if we already have this PID */
+        auto havePid = pidIndex.find(pid);
+        if (havePid != pidIndex.end())
         {
-            unsigned int currLimit, minLimit, maxLimit, newPowerLimit;
+            processUtilSamples[havePid->second].util += utilVal;
+            numSamples++;
+            continue; /* Already have this one */
+        }
 
-            newPowerLimit = (unsigned int)(value->val.d * 1000); // convert from W to mW
+        /* We found a new PID */
+        pidIndex[pid]                              = *numUniqueSamples;
+        processUtilSamples[*numUniqueSamples].pid  = pid;
+        processUtilSamples[*numUniqueSamples].util = utilVal;
+        numSamples++;
+        (*numUniqueSamples)++;
 
-            nvmlReturn = nvmlDeviceGetPowerManagementLimit(nvmlDevice, &currLimit);
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+        /* Have we reached our capacity? */
+        if ((*numUniqueSamples) >= maxPids)
+        {
+            PRINT_DEBUG(
+                "%d %d", "Reached Max Capacity of ProcessSamples  - %d, maxPids = %d", *numUniqueSamples, maxPids);
+            break;
+        }
+    }
 
-            nvmlReturn = nvmlDeviceGetPowerManagementLimitConstraints(nvmlDevice, &minLimit, &maxLimit);
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-
-            if (newPowerLimit < minLimit || newPowerLimit > maxLimit)
-            {
-                PRINT_WARNING("%u %u %u %u",
-                              "gpuId %u. Power limit %u is outside of range %u < x < %u",
-                              gpuId,
-                              newPowerLimit,
-                              minLimit,
-                              maxLimit);
-                return DCGM_ST_BADPARAM;
-            }
-
-            nvmlReturn = nvmlDeviceSetPowerManagementLimit(nvmlDevice, newPowerLimit);
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    dcgm_mutex_unlock(m_mutex);
+    /* Average utilization rates */
+    for (i = 0; i < (int)*numUniqueSamples; i++)
+    {
+        processUtilSamples[i].util = processUtilSamples[i].util / numSamples;
+    }
 
+    if (!(*numUniqueSamples))
+    {
+        if (!watchInfo->isWatched)
+            return DCGM_ST_NOT_WATCHED;
+        else
+            return DCGM_ST_NO_DATA;
+    }
 
-            if (watchInfo->isWatched)
-            {
-                AppendEntityDouble(&updateCtx, newPowerLimit / 1000, 0, now, expireTime);
-            }
+    return DCGM_ST_OK;
+}
 
-            break;
-        }
 
-        case DCGM_FI_DEV_APP_SM_CLOCK: // Fall-through is intentional
-        case DCGM_FI_DEV_APP_MEM_CLOCK:
-        {
-            /* Special Handling as two different values are set simultaneously in this case */
-            dcgm_field_meta_p fieldMetaSM    = 0;
-            dcgm_field_meta_p fieldMetaMEM   = 0;
-            dcgmcm_watch_info_p watchInfoSM  = 0;
-            dcgmcm_watch_info_p watchInfoMEM = 0;
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetLatestProcessInfo(unsigned int gpuId,
+                                                    unsigned int pid,
+                                                    dcgmDevicePidAccountingStats_t *pidInfo)
+{
+    dcgmcm_watch_info_p watchInfo = 0;
 
+    if (!pid || !pidInfo)
+        return DCGM_ST_BADPARAM;
 
-            fieldMetaSM = DcgmFieldGetById(DCGM_FI_DEV_APP_SM_CLOCK);
-            if (!fieldMetaSM)
-                return DCGM_ST_UNKNOWN_FIELD;
+    dcgm_mutex_lock(m_mutex);
 
-            watchInfoSM = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_APP_SM_CLOCK, 1);
+    watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, 0);
 
-            fieldMetaMEM = DcgmFieldGetById(DCGM_FI_DEV_APP_MEM_CLOCK);
-            if (!fieldMetaMEM)
-                return DCGM_ST_UNKNOWN_FIELD;
+    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        dcgm_mutex_unlock(m_mutex);
+        return dcgmReturn;
+    }
 
-            watchInfoMEM = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_APP_MEM_CLOCK, 1);
+    if (watchInfo->timeSeries->tsType != TS_TYPE_BLOB)
+    {
+        PRINT_ERROR(
+            "%d", "Expected type TS_TYPE_BLOB for DCGM_FI_DEV_ACCOUNTING_DATA. Got %d", watchInfo->timeSeries->tsType);
+        dcgm_mutex_unlock(m_mutex);
+        return DCGM_ST_GENERIC_ERROR;
+    }
 
-            /* Both blank means ignore */
-            if (DCGM_INT64_IS_BLANK(value->val.i64) && DCGM_INT64_IS_BLANK(value->val2.i64))
-            {
-                return NvmlReturnToDcgmReturn(NVML_SUCCESS);
-            }
-            else if ((value->val.i64 == 0) && (value->val2.i64 == 0))
-            {
-                /* Both 0s means reset application clocks */
-                nvmlReturn = nvmlDeviceResetApplicationsClocks(nvmlDevice);
-                PRINT_DEBUG("%d", "nvmlDeviceResetApplicationsClocks() returned %d", (int)nvmlReturn);
-                if (NVML_SUCCESS != nvmlReturn)
-                {
-                    return NvmlReturnToDcgmReturn(nvmlReturn);
-                }
-            }
-            else
-            {
-                /* Set Memory clock and Proc clock pair via NVML */
-                nvmlReturn = nvmlDeviceSetApplicationsClocks(nvmlDevice, value->val.i64, value->val2.i64);
-                PRINT_DEBUG("%lld %lld %d",
-                            "nvmlDeviceSetApplicationsClocks(%lld, %lld) returned %d",
-                            value->val.i64,
-                            value->val2.i64,
-                            (int)nvmlReturn);
-                if (NVML_SUCCESS != nvmlReturn)
-                {
-                    return NvmlReturnToDcgmReturn(nvmlReturn);
-                }
-            }
+    dcgmDevicePidAccountingStats_t const *matchingAccStats = FindCachedAccountingStats(gpuId, pid, watchInfo);
+    if (!matchingAccStats)
+    {
+        dcgm_mutex_unlock(m_mutex);
+        PRINT_DEBUG("%u %u", "Pid %u not found for gpuId %u", pid, gpuId);
 
-            if (watchInfoMEM->isWatched)
-            {
-                updateCtx.watchInfo = watchInfoMEM;
-                updateCtx.entityKey = watchInfoMEM->watchKey;
-                AppendEntityInt64(&updateCtx, value->val.i64, 0, now, expireTime);
-            }
+        if (!watchInfo->isWatched)
+            return DCGM_ST_NOT_WATCHED;
+        else
+            return DCGM_ST_NO_DATA;
+    }
 
-            if (watchInfoSM->isWatched)
-            {
-                updateCtx.watchInfo = watchInfoSM;
-                updateCtx.entityKey = watchInfoSM->watchKey;
-                AppendEntityInt64(&updateCtx, value->val2.i64, 0, now, expireTime);
-            }
+    if (matchingAccStats->version != dcgmDevicePidAccountingStats_version)
+    {
+        dcgm_mutex_unlock(m_mutex);
+        PRINT_ERROR("%d %d",
+                    "Expected accounting stats version %d. Found %d",
+                    dcgmDevicePidAccountingStats_version,
+                    matchingAccStats->version);
+        return DCGM_ST_GENERIC_ERROR; /* This is an internal version mismatch, not a user one */
+    }
 
-            break;
-        }
+    memcpy(pidInfo, matchingAccStats, sizeof(*pidInfo));
+    dcgm_mutex_unlock(m_mutex);
 
-        case DCGM_FI_DEV_ECC_CURRENT: // Fall-through is intentional
-        case DCGM_FI_DEV_ECC_PENDING:
-        {
-            nvmlEnableState_t nvmlState;
-            nvmlState = (value->val.i64 == true) ? NVML_FEATURE_ENABLED : NVML_FEATURE_DISABLED;
+    PRINT_DEBUG("%u", "Found match for PID %u", pid);
+    return DCGM_ST_OK;
+}
 
-            nvmlReturn = nvmlDeviceSetEccMode(nvmlDevice, nvmlState);
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+/*****************************************************************************/
+/* Value of a sample of a watch summarized as T */
+template <typename T>
+static T DcgmcmSummaryEntryValue(timeseries_entry_p entry)
+{
+    if constexpr (std::is_integral_v<T>)
+        return entry->val.i64;
+    else
+        return entry->val.dbl;
+}
 
+/*****************************************************************************/
+/*
+ * Summarize the rolled-up part of [startTime, endTime] of a watch: whatever is
+ * older than its oldest raw sample. Entry filters can only be applied to raw
+ * samples, so pfUseEntryCB turns this off
+ *
+ * Returns a summary with count 0 if there is nothing to add
+ */
+static dcgmcm_rollup_summary_t DcgmcmSummarizeRollup(dcgmcm_watch_info_p watchInfo,
+                                                     timelib64_t startTime,
+                                                     timelib64_t endTime,
+                                                     pfUseEntryForSummary pfUseEntryCB)
+{
+    dcgmcm_rollup_summary_t summary {};
+    if (!watchInfo->rollup || pfUseEntryCB)
+        return summary;
+
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = timeseries_first(watchInfo->timeSeries, &cursor);
+    timelib64_t beforeTime   = entry ? entry->usecSince1970 : 0;
+    if (startTime && beforeTime && startTime >= beforeTime)
+        return summary; /* The raw samples cover the whole window */
+
+    if (endTime && (!beforeTime || endTime + 1 < beforeTime))
+        beforeTime = endTime + 1;
+
+    int tier = watchInfo->rollup->FindTier(startTime);
+    if (tier >= 0)
+        summary = watchInfo->rollup->Summarize(tier, startTime, beforeTime);
+    return summary;
+}
 
-            if (watchInfo->isWatched)
-            {
-                AppendEntityInt64(&updateCtx, value->val.i64, 0, now, expireTime);
-            }
+/*****************************************************************************/
+/* State passed through timeseries_for_each_span() by DcgmcmAccumulateSummary() */
+template <typename T>
+struct DcgmcmSummarySpanState
+{
+    DcgmcmSummaryAccumulator<T> *accumulator;
+    bool computeIntegral;
+};
 
-            break;
-        }
+template <typename T>
+static int DcgmcmAccumulateSummarySpan(timelib64_t const *usecSince1970,
+                                       timeseries_value_t const *values,
+                                       int count,
+                                       void *userData)
+{
+    auto *state = (DcgmcmSummarySpanState<T> *)userData;
 
+    /* timeseries_value_t is a union of both, so the column can be read as an array of T */
+    state->accumulator->AddBatch(usecSince1970, (T const *)values, count, state->computeIntegral);
+    return 0;
+}
 
-        case DCGM_FI_DEV_COMPUTE_MODE:
-        {
-            nvmlComputeMode_t computeMode;
+/*****************************************************************************/
+/*
+ * Feed accumulator the samples of watchInfo in [startTime, endTime] that
+ * pfUseEntryCB accepts, starting with the rolled-up part of the window.
+ *
+ * Without a filter, a ring-backed watch is reduced a contiguous run at a time
+ * by the SIMD kernels. accumulator's integral is then only computed if
+ * computeIntegral. With a filter, each entry goes through pfUseEntryCB
+ */
+template <typename T>
+static void DcgmcmAccumulateSummary(dcgmcm_watch_info_p watchInfo,
+                                    timelib64_t startTime,
+                                    timelib64_t endTime,
+                                    pfUseEntryForSummary pfUseEntryCB,
+                                    void *userData,
+                                    bool computeIntegral,
+                                    DcgmcmSummaryAccumulator<T> &accumulator)
+{
+    dcgmcm_rollup_summary_t rollup = DcgmcmSummarizeRollup(watchInfo, startTime, endTime, pfUseEntryCB);
+    if (rollup.count)
+        accumulator.AddRollup(rollup);
 
-            if (value->val.i64 == DCGM_CONFIG_COMPUTEMODE_DEFAULT)
-                computeMode = NVML_COMPUTEMODE_DEFAULT;
-            else if (value->val.i64 == DCGM_CONFIG_COMPUTEMODE_PROHIBITED)
-                computeMode = NVML_COMPUTEMODE_PROHIBITED;
-            else if (value->val.i64 == DCGM_CONFIG_COMPUTEMODE_EXCLUSIVE_PROCESS)
-                computeMode = NVML_COMPUTEMODE_EXCLUSIVE_PROCESS;
-            else
-                return DCGM_ST_BADPARAM;
+    /* Data type is assumed to be a time series type */
+    timeseries_p timeseries = watchInfo->timeSeries;
 
+    if (!pfUseEntryCB && timeseries->storage == TS_STORAGE_RING)
+    {
+        DcgmcmSummarySpanState<T> state { &accumulator, computeIntegral };
+        /* Like timeseries_next(), a compressed block that fails to decode ends the walk */
+        int st = timeseries_for_each_span(timeseries, startTime, endTime, DcgmcmAccumulateSummarySpan<T>, &state);
+        if (st != TS_ST_OK)
+            PRINT_ERROR("%d", "timeseries_for_each_span returned %d", st);
+        return;
+    }
 
-            nvmlReturn = nvmlDeviceSetComputeMode(nvmlDevice, computeMode);
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = 0;
 
-            if (watchInfo->isWatched)
-            {
-                AppendEntityInt64(&updateCtx, value->val.i64, 0, now, expireTime);
-            }
+    /* Walk forward  */
+    if (startTime)
+        entry = timeseries_find(timeseries, startTime, TS_LGE_GREATEQUAL, &cursor);
+    else
+        entry = timeseries_first(timeseries, &cursor);
 
+    for (; entry; entry = timeseries_next(timeseries, &cursor))
+    {
+        /* Past our time range? */
+        if (endTime && entry->usecSince1970 > endTime)
             break;
-        }
-
-        default:
-            PRINT_WARNING("%d", "Unimplemented fieldId: %d", (int)fieldMeta->fieldId);
-            return DCGM_ST_GENERIC_ERROR;
-    }
 
+        if (pfUseEntryCB && !pfUseEntryCB(entry, userData))
+            continue;
 
-    return DCGM_ST_OK;
+        accumulator.Add(entry->usecSince1970, DcgmcmSummaryEntryValue<T>(entry));
+    }
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AppendSamples(DcgmFvBuffer *fvBuffer)
+template <typename T>
+dcgmReturn_t DcgmCacheManager::GetSummaryData(dcgm_field_entity_group_t entityGroupId,
+                                              dcgm_field_eid_t entityId,
+                                              unsigned short dcgmFieldId,
+                                              int numSummaryTypes,
+                                              DcgmcmSummaryType_t *summaryTypes,
+                                              T *summaryValues,
+                                              timelib64_t startTime,
+                                              timelib64_t endTime,
+                                              pfUseEntryForSummary pfUseEntryCB,
+                                              void *userData)
 {
-    if (!fvBuffer)
+    int tsType = std::is_integral_v<T> ? TS_TYPE_INT64 : TS_TYPE_DOUBLE;
+
+    if (!dcgmFieldId || numSummaryTypes < 1 || !summaryTypes || !summaryValues)
         return DCGM_ST_BADPARAM;
 
-    dcgmcm_update_thread_t threadCtx;
-    InitAndClearThreadCtx(&threadCtx);
+    /* Initialize all return data to blank */
+    for (int stIndex = 0; stIndex < numSummaryTypes; stIndex++)
+    {
+        summaryValues[stIndex] = DcgmcmSummaryAccumulator<T>::Blank();
+    }
 
-    /* Lock the mutex for every FV so we only take it once */
-    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock(m_mutex);
+    DcgmLockGuard dlg(m_mutex);
 
-    timelib64_t now = timelib_usecSince1970();
-    dcgmBufferedFv_t *fv;
-    dcgmBufferedFvCursor_t cursor = 0;
+    dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 0);
 
-    for (fv = fvBuffer->GetNextFv(&cursor); fv; fv = fvBuffer->GetNextFv(&cursor))
+    dcgmReturn_t dcgmReturn = PrecheckWatchInfoForSamples(watchInfo);
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+
+    if (watchInfo->timeSeries->tsType != tsType)
     {
-        dcgm_field_meta_t *fieldMeta = DcgmFieldGetById(fv->fieldId);
-        if (!fieldMeta)
-        {
-            PRINT_ERROR("%u", "Unknown fieldId %u in fvBuffer", fv->fieldId);
-            continue;
-        }
+        PRINT_ERROR("%d %u %d",
+                    "Expected type %d for field %u. Got %d",
+                    tsType,
+                    dcgmFieldId,
+                    watchInfo->timeSeries->tsType);
+        return DCGM_ST_GENERIC_ERROR;
+    }
 
-        dcgmcm_watch_info_t *watchInfo;
-        if (fieldMeta->scope == DCGM_FS_GLOBAL)
-            watchInfo = GetGlobalWatchInfo(fv->fieldId, 1);
-        else
-        {
-            watchInfo = GetEntityWatchInfo((dcgm_field_entity_group_t)fv->entityGroupId, fv->entityId, fv->fieldId, 1);
-        }
+    watchInfo->lastReadUsec = timelib_usecSince1970();
 
-        timelib64_t expireTime = 0;
-        if (watchInfo->maxAgeUsec)
-            expireTime = now - watchInfo->maxAgeUsec;
+    /* Registered windows are kept up to date as samples arrive */
+    DcgmcmSummaryAccumulator<T> const *summary = nullptr;
+    if (!pfUseEntryCB)
+        summary = GetWindowSummary<T>(watchInfo, startTime, endTime);
 
-        threadCtx.watchInfo = watchInfo;
-        threadCtx.entityKey = watchInfo->watchKey;
+    DcgmcmSummaryAccumulator<T> accumulator;
+    if (!summary)
+    {
+        accumulator.keepSketch = std::any_of(summaryTypes, summaryTypes + numSummaryTypes, [](DcgmcmSummaryType_t st) {
+            return DcgmcmSummaryAccumulator<T>::IsPercentile(st);
+        });
+        bool computeIntegral = std::find(summaryTypes, summaryTypes + numSummaryTypes, DcgmcmSummaryTypeIntegral)
+                               != summaryTypes + numSummaryTypes;
+        DcgmcmAccumulateSummary(watchInfo, startTime, endTime, pfUseEntryCB, userData, computeIntegral, accumulator);
+        summary = &accumulator;
+    }
 
-        switch (fv->fieldType)
-        {
-            case DCGM_FT_DOUBLE:
-                AppendEntityDouble(&threadCtx, fv->value.dbl, 0.0, fv->timestamp, expireTime);
-                break;
-
-            case DCGM_FT_INT64:
-                AppendEntityInt64(&threadCtx, fv->value.i64, 0, fv->timestamp, expireTime);
-                break;
-
-            case DCGM_FT_STRING:
-                AppendEntityString(&threadCtx, fv->value.str, fv->timestamp, expireTime);
-                break;
+    dcgmReturn = summary->GetSummaries(numSummaryTypes, summaryTypes, summaryValues);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        PRINT_ERROR("%u", "Unhandled summaryType requested for field %u", dcgmFieldId);
+        return dcgmReturn;
+    }
 
-            case DCGM_FT_BINARY:
-            {
-                size_t valueSize = (size_t)fv->length - (sizeof(*fv) - sizeof(fv->value));
-                AppendEntityBlob(&threadCtx, fv->value.blob, valueSize, fv->timestamp, expireTime);
-                break;
-            }
+    if (!summary->Nseen)
+    {
+        PRINT_DEBUG("", "No values found");
 
-            default:
-                PRINT_ERROR("%u", "Unknown field type: %u", fv->fieldType);
-                break;
-        }
+        if (!watchInfo->isWatched)
+            return DCGM_ST_NOT_WATCHED;
+        else
+            return DCGM_ST_NO_DATA;
     }
 
-    if (mutexSt == DCGM_MUTEX_ST_OK)
-        dcgm_mutex_unlock(m_mutex);
-
     return DCGM_ST_OK;
 }
 
-
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AppendSamples(dcgm_field_entity_group_t entityGroupId,
-                                             dcgm_field_eid_t entityId,
-                                             unsigned short dcgmFieldId,
-                                             dcgmcm_sample_p samples,
-                                             int Nsamples)
+dcgmReturn_t DcgmCacheManager::GetInt64SummaryData(dcgm_field_entity_group_t entityGroupId,
+                                                   dcgm_field_eid_t entityId,
+                                                   unsigned short dcgmFieldId,
+                                                   int numSummaryTypes,
+                                                   DcgmcmSummaryType_t *summaryTypes,
+                                                   long long *summaryValues,
+                                                   timelib64_t startTime,
+                                                   timelib64_t endTime,
+                                                   pfUseEntryForSummary pfUseEntryCB,
+                                                   void *userData)
 {
-    return InjectSamples(entityGroupId, entityId, dcgmFieldId, samples, Nsamples);
+    return GetSummaryData(entityGroupId,
+                          entityId,
+                          dcgmFieldId,
+                          numSummaryTypes,
+                          summaryTypes,
+                          summaryValues,
+                          startTime,
+                          endTime,
+                          pfUseEntryCB,
+                          userData);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::InjectSamples(dcgm_field_entity_group_t entityGroupId,
-                                             dcgm_field_eid_t entityId,
-                                             unsigned short dcgmFieldId,
-                                             dcgmcm_sample_p samples,
-                                             int Nsamples)
+dcgmReturn_t DcgmCacheManager::GetFp64SummaryData(dcgm_field_entity_group_t entityGroupId,
+                                                  dcgm_field_eid_t entityId,
+                                                  unsigned short dcgmFieldId,
+                                                  int numSummaryTypes,
+                                                  DcgmcmSummaryType_t *summaryTypes,
+                                                  double *summaryValues,
+                                                  timelib64_t startTime,
+                                                  timelib64_t endTime,
+                                                  pfUseEntryForSummary pfUseEntryCB,
+                                                  void *userData)
 {
-    dcgm_field_meta_p fieldMeta = 0;
-    int sampleIndex;
-    dcgmcm_sample_p currentSample = 0;
-    dcgmcm_watch_info_p watchInfo = 0;
-    timelib64_t now;
-    timelib64_t expireTime;
-    dcgmReturn_t retVal = DCGM_ST_OK;
-
-    dcgmcm_update_thread_t threadCtx;
-    InitAndClearThreadCtx(&threadCtx);
-    threadCtx.fvBuffer = 0;
-
-    if (!dcgmFieldId || !samples || Nsamples < 1)
-        return DCGM_ST_BADPARAM;
-
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-        return DCGM_ST_GENERIC_ERROR;
+    return GetSummaryData(entityGroupId,
+                          entityId,
+                          dcgmFieldId,
+                          numSummaryTypes,
+                          summaryTypes,
+                          summaryValues,
+                          startTime,
+                          endTime,
+                          pfUseEntryCB,
+                          userData);
+}
 
-    if (fieldMeta->scope == DCGM_FS_GLOBAL)
-    {
-        watchInfo = GetGlobalWatchInfo(dcgmFieldId, 1);
-    }
+/*****************************************************************************/
+/* Timestamp of the last sample in a running summary of watchInfo */
+static timelib64_t DcgmcmWindowSummaryLastUsec(dcgmcm_watch_info_p watchInfo,
+                                               dcgmcm_window_summary_t const &windowSummary)
+{
+    if (watchInfo->timeSeries->tsType == TS_TYPE_INT64)
+        return windowSummary.i64.prevTimestamp;
     else
-    {
-        watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 1);
-    }
+        return windowSummary.fp64.prevTimestamp;
+}
 
-    if (!watchInfo)
+/*****************************************************************************/
+/*
+ * Get the running summary of watchInfo over a window, starting it from the
+ * cache on first use. Nothing in the window has been evicted by then, since
+ * samples are only evicted on append, which starts the running summary
+ */
+template <typename T>
+static DcgmcmSummaryAccumulator<T> &DcgmcmWindowSummary(dcgmcm_watch_info_p watchInfo,
+                                                        unsigned int windowId,
+                                                        dcgmcm_summary_window_t const &window)
+{
+    auto it = watchInfo->windowSummaries.find(windowId);
+    if (it == watchInfo->windowSummaries.end())
     {
-        PRINT_DEBUG(
-            "%u %u %u", "InjectSamples eg %u, eid %u, fieldId %u got NULL", entityGroupId, entityId, dcgmFieldId);
-        return DCGM_ST_MEMORY;
-    }
-
-    /* If anyone is watching this watchInfo, we need to create a
-       fv buffer for the resulting notifcations */
-    if (watchInfo->hasSubscribedWatchers)
-        threadCtx.fvBuffer = new DcgmFvBuffer();
-
-    threadCtx.watchInfo               = watchInfo;
-    threadCtx.entityKey.entityGroupId = entityGroupId;
-    threadCtx.entityKey.entityId      = entityId;
-    threadCtx.entityKey.fieldId       = fieldMeta->fieldId;
-
-    now        = timelib_usecSince1970();
-    expireTime = 0;
-    if (watchInfo->maxAgeUsec)
-        expireTime = now - watchInfo->maxAgeUsec;
-    /* Update the last queried timestamp to now so that a watch on this field doesn't
-       update every single cycle. After all, we are injecting values. If the injected value
-       is in the future, then this field won't update live until after the injected timestamp
-       Note that we are also updating lastQueriedUsec in the loop below to achieve this. */
-    watchInfo->lastQueriedUsec = now;
+        it = watchInfo->windowSummaries.emplace(windowId, dcgmcm_window_summary_t {}).first;
 
-    /* A future optimization would be to Lock() + Unlock() around this loop
-     * and inject all samples at once This is fine for now
-     */
-    for (sampleIndex = 0; sampleIndex < Nsamples; sampleIndex++)
-    {
-        currentSample = &samples[sampleIndex];
+        /* Windows back job stats, so keep their percentiles */
+        it->second.i64.keepSketch  = std::is_integral_v<T>;
+        it->second.fp64.keepSketch = !std::is_integral_v<T>;
+        if constexpr (std::is_integral_v<T>)
+            DcgmcmAccumulateSummary(
+                watchInfo, window.startTime, window.endTime, nullptr, nullptr, true, it->second.i64);
+        else
+            DcgmcmAccumulateSummary(
+                watchInfo, window.startTime, window.endTime, nullptr, nullptr, true, it->second.fp64);
+    }
 
-        /* Use the latest timestamp of the injected samples as the last queried time */
-        watchInfo->lastQueriedUsec = DCGM_MAX(now, currentSample->timestamp);
+    if constexpr (std::is_integral_v<T>)
+        return it->second.i64;
+    else
+        return it->second.fp64;
+}
 
-        switch (fieldMeta->fieldType)
-        {
-            case DCGM_FT_DOUBLE:
-                AppendEntityDouble(
-                    &threadCtx, currentSample->val.d, currentSample->val2.d, currentSample->timestamp, expireTime);
-                break;
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AddSummaryWindow(timelib64_t startTime, unsigned int *windowId)
+{
+    if (!windowId || startTime <= 0)
+        return DCGM_ST_BADPARAM;
 
-            case DCGM_FT_INT64:
-                AppendEntityInt64(
-                    &threadCtx, currentSample->val.i64, currentSample->val2.i64, currentSample->timestamp, expireTime);
-                break;
+    DcgmLockGuard dlg(m_mutex);
+    *windowId                   = m_nextSummaryWindowId++;
+    m_summaryWindows[*windowId] = { startTime, 0 };
+    return DCGM_ST_OK;
+}
 
-            case DCGM_FT_STRING:
-                if (!currentSample->val.str)
-                {
-                    PRINT_ERROR("%d", "InjectSamples: Null string at index %d of samples", sampleIndex);
-                    /* Our injected samples before this one will still be in the data
-                     * cache. We can't do anything about this if their timestamp field
-                     * was 0 since it will assign a timestamp we won't know
-                     */
-                    return DCGM_ST_BADPARAM;
-                }
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::CloseSummaryWindow(unsigned int windowId, timelib64_t endTime)
+{
+    DcgmLockGuard dlg(m_mutex);
 
-                AppendEntityString(&threadCtx, currentSample->val.str, currentSample->timestamp, expireTime);
-                break;
+    auto it = m_summaryWindows.find(windowId);
+    if (it == m_summaryWindows.end())
+        return DCGM_ST_NO_DATA;
+    if (endTime < it->second.startTime)
+        return DCGM_ST_BADPARAM;
 
-            case DCGM_FT_BINARY:
-                if (!currentSample->val.blob)
-                {
-                    PRINT_ERROR("%d", "InjectSamples: Null blob at index %d of samples", sampleIndex);
-                    /* Our injected samples before this one will still be in the data
-                     * cache. We can't do anything about this if their timestamp field
-                     * was 0 since it will assign a timestamp we won't know
-                     */
-                    return DCGM_ST_BADPARAM;
-                }
+    /* Moving the end of a closed window out means samples after its old end were skipped */
+    bool extended      = it->second.endTime && endTime > it->second.endTime;
+    it->second.endTime = endTime;
 
-                AppendEntityBlob(&threadCtx,
-                                 currentSample->val.blob,
-                                 currentSample->val2.ptrSize,
-                                 currentSample->timestamp,
-                                 expireTime);
-                break;
+    /* Running summaries that no longer match the window are rebuilt from the cache on next use */
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        auto summaryIt = watchInfo->windowSummaries.find(windowId);
+        if (summaryIt == watchInfo->windowSummaries.end())
+            continue;
 
-            default:
-                PRINT_ERROR("%c", "InjectSamples: Unhandled field type: %c", fieldMeta->fieldType);
-                return DCGM_ST_BADPARAM;
-        }
+        if (extended || DcgmcmWindowSummaryLastUsec(watchInfo, summaryIt->second) > endTime)
+            watchInfo->windowSummaries.erase(summaryIt);
     }
 
-    /* Broadcast any accumulated notifications */
-    if (threadCtx.fvBuffer && threadCtx.affectedSubscribers)
-        UpdateFvSubscribers(&threadCtx);
-
-    FreeThreadCtx(&threadCtx);
-
-    return retVal;
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::FreeSamples(dcgmcm_sample_p samples, int Nsamples, unsigned short dcgmFieldId)
+dcgmReturn_t DcgmCacheManager::RemoveSummaryWindow(unsigned int windowId)
 {
-    dcgm_field_meta_p fieldMeta = 0;
-    int sampleIndex;
-    dcgmcm_sample_p currentSample = 0;
-
-    if (!dcgmFieldId || !samples || Nsamples < 1)
-        return DCGM_ST_BADPARAM;
+    DcgmLockGuard dlg(m_mutex);
 
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta)
-        return DCGM_ST_GENERIC_ERROR;
+    if (!m_summaryWindows.erase(windowId))
+        return DCGM_ST_NO_DATA;
 
-    /* Only strings/binary need their values freed. */
-    if ((DCGM_FT_STRING != fieldMeta->fieldType) && (DCGM_FT_BINARY != fieldMeta->fieldType))
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
     {
-        return DCGM_ST_OK;
+        watchInfo->windowSummaries.erase(windowId);
     }
 
-    for (sampleIndex = 0; sampleIndex < Nsamples; sampleIndex++)
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+template <typename T>
+DcgmcmSummaryAccumulator<T> const *DcgmCacheManager::GetWindowSummary(dcgmcm_watch_info_p watchInfo,
+                                                                      timelib64_t startTime,
+                                                                      timelib64_t endTime)
+{
+    for (auto const &[windowId, window] : m_summaryWindows)
     {
-        currentSample = &samples[sampleIndex];
+        if (window.startTime != startTime)
+            continue;
 
-        if (fieldMeta->fieldType == DCGM_FT_STRING)
-        {
-            if (currentSample->val.str)
-            {
-                free(currentSample->val.str);
-                currentSample->val.str      = 0;
-                currentSample->val2.ptrSize = 0;
-            }
-        }
+        if (window.endTime && window.endTime != endTime)
+            continue;
 
-        if (fieldMeta->fieldType == DCGM_FT_BINARY)
+        if (!window.endTime && endTime)
         {
-            if (currentSample->val.blob)
-            {
-                free(currentSample->val.blob);
-                currentSample->val.blob     = 0;
-                currentSample->val2.ptrSize = 0;
-            }
+            /* An open window only matches if endTime doesn't cut off any samples */
+            timeseries_cursor_t cursor;
+            timeseries_entry_p entry = timeseries_last(watchInfo->timeSeries, &cursor);
+            if (entry && entry->usecSince1970 > endTime)
+                continue;
         }
+
+        return &DcgmcmWindowSummary<T>(watchInfo, windowId, window);
     }
 
-    return DCGM_ST_OK;
+    return nullptr;
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::FreeThreadCtx(dcgmcm_update_thread_t *threadCtx)
+void DcgmCacheManager::UpdateWindowSummaries(dcgmcm_watch_info_p watchInfo,
+                                             timelib64_t timestamp,
+                                             long long i64Value,
+                                             double fp64Value)
 {
-    if (!threadCtx)
-        return;
+    for (auto const &[windowId, window] : m_summaryWindows)
+    {
+        if (timestamp < window.startTime || (window.endTime && timestamp > window.endTime))
+            continue;
 
-    ClearThreadCtx(threadCtx);
+        auto it = watchInfo->windowSummaries.find(windowId);
+        if (it == watchInfo->windowSummaries.end())
+        {
+            /* Start from the cache, which already has this sample */
+            if (watchInfo->timeSeries->tsType == TS_TYPE_INT64)
+                DcgmcmWindowSummary<long long>(watchInfo, windowId, window);
+            else
+                DcgmcmWindowSummary<double>(watchInfo, windowId, window);
+            continue;
+        }
 
-    if (threadCtx->fvBuffer)
-        delete threadCtx->fvBuffer;
+        dcgmcm_window_summary_t &windowSummary = it->second;
+        if (timestamp < DcgmcmWindowSummaryLastUsec(watchInfo, windowSummary))
+        {
+            /* Summaries depend on sample order. Rebuild from the cache on next use */
+            DCGM_LOG_DEBUG << "Dropping window " << windowId << " summary of fieldId "
+                           << watchInfo->watchKey.fieldId << " after an out of order sample";
+            watchInfo->windowSummaries.erase(it);
+            continue;
+        }
+
+        if (watchInfo->timeSeries->tsType == TS_TYPE_INT64)
+            windowSummary.i64.Add(timestamp, i64Value);
+        else
+            windowSummary.fp64.Add(timestamp, fp64Value);
+    }
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::InitAndClearThreadCtx(dcgmcm_update_thread_t *threadCtx)
-{
-    if (!threadCtx)
-        return;
+dcgmReturn_t DcgmCacheManager::GetSamples(dcgm_field_entity_group_t entityGroupId,
+                                          dcgm_field_eid_t entityId,
+                                          unsigned short dcgmFieldId,
+                                          dcgmcm_sample_p samples,
+                                          int *Msamples,
+                                          timelib64_t startTime,
+                                          timelib64_t endTime,
+                                          dcgmOrder_t order)
+{
+    dcgm_field_meta_p fieldMeta = 0;
+    dcgmReturn_t st, retSt = DCGM_ST_OK;
+    timeseries_p timeseries = 0;
+    int maxSamples;
+    dcgmcm_watch_info_p watchInfo = 0;
 
-    threadCtx->fvBuffer = NULL;
+    if (!samples || !Msamples || (*Msamples) < 1)
+        return DCGM_ST_BADPARAM;
+    if (order != DCGM_ORDER_ASCENDING && order != DCGM_ORDER_DESCENDING)
+        return DCGM_ST_BADPARAM;
 
-    ClearThreadCtx(threadCtx);
-}
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_UNKNOWN_FIELD;
 
-/*****************************************************************************/
-void DcgmCacheManager::ClearThreadCtx(dcgmcm_update_thread_t *threadCtx)
-{
-    if (!threadCtx)
-        return;
+    dcgm_field_entity_group_t watchEntityGroupId = entityGroupId;
+    unsigned int watchEntityId                   = entityId;
 
-    /* Clear the field-values counts */
-    memset(threadCtx->numFieldValues, 0, sizeof(threadCtx->numFieldValues));
+    if (fieldMeta->scope == DCGM_FS_GLOBAL && watchEntityGroupId != DCGM_FE_NONE)
+    {
+        DCGM_LOG_DEBUG << "Fixing entityGroupId for global field";
+        watchEntityGroupId = DCGM_FE_NONE;
+    }
 
-    threadCtx->watchInfo = 0;
-    if (threadCtx->fvBuffer)
-        threadCtx->fvBuffer->Clear();
-    threadCtx->affectedSubscribers = 0;
-}
+    /* Recursive so that GetMultipleSamples() can hold the lock across queries */
+    DcgmLockGuard dlg(m_mutex);
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::UpdateFvSubscribers(dcgmcm_update_thread_t *updateCtx)
-{
-    int numWatcherTypes = 0;
-    unsigned int i;
-    DcgmWatcherType_t watchers[DcgmWatcherTypeCount];
+    if (watchEntityGroupId != DCGM_FE_NONE)
+    {
+        watchInfo = GetEntityWatchInfo(watchEntityGroupId, watchEntityId, fieldMeta->fieldId, 0);
+    }
+    else
+    {
+        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+    }
 
-    if (!updateCtx->fvBuffer || !updateCtx->affectedSubscribers)
-        return DCGM_ST_OK; /* Nothing to do */
+    maxSamples = *Msamples; /* Store the passed in value */
+    *Msamples  = 0;         /* No samples collected yet */
 
-    /* Ok. We've got FVs and subscribers. Let's build the list */
-    for (i = 0; i < DcgmWatcherTypeCount; i++)
+    st = PrecheckWatchInfoForSamples(watchInfo);
+    if (st != DCGM_ST_OK)
     {
-        if (updateCtx->affectedSubscribers & (1 << i))
-        {
-            watchers[numWatcherTypes] = (DcgmWatcherType_t)i;
-            numWatcherTypes++;
-        }
+        return st;
     }
 
-    /* Locking the cache manager for now to protect m_subscriptions
-       We can reevaluate this later if there are deadlock issues. Technically,
-       we only modify this structure on start-up when we're single threaded. */
-    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
-
-    std::vector<dcgmcmEventSubscription_t> localCopy(begin(m_subscriptions[DcgmcmEventTypeFvUpdate]),
-                                                     end(m_subscriptions[DcgmcmEventTypeFvUpdate]));
+    /* Data type is assumed to be a time series type */
 
-    if (mutexSt != DCGM_MUTEX_ST_LOCKEDBYME)
-        dcgm_mutex_unlock(m_mutex);
+    watchInfo->lastReadUsec = timelib_usecSince1970();
+    timeseries              = watchInfo->timeSeries;
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = 0;
 
-    for (auto &&entry : localCopy)
+    /* Rolled-up and spilled watches answer for history older than their raw samples from the rollup and the
+       spill. The rollup only answers for what is older than the spill too */
+    timelib64_t rawOldestUsec = LLONG_MAX;
+    if (watchInfo->rollup || m_spill)
     {
-        entry.fn.fvCb(updateCtx->fvBuffer, watchers, numWatcherTypes, entry.userData);
+        entry = timeseries_first(timeseries, &cursor);
+        if (entry)
+            rawOldestUsec = entry->usecSince1970;
+    }
+    timelib64_t rollupBeforeUsec = rawOldestUsec;
+    if (m_spill)
+    {
+        timelib64_t spillOldestUsec = m_spill->OldestUsec(
+            watchInfo->watchKey.entityGroupId, watchInfo->watchKey.entityId, watchInfo->watchKey.fieldId);
+        if (spillOldestUsec)
+            rollupBeforeUsec = std::min(rollupBeforeUsec, spillOldestUsec);
     }
 
-    return DCGM_ST_OK;
-}
-
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::SubscribeForEvent(const dcgmcmEventSubscription_t &eventSub)
-{
-    switch (eventSub.type)
+    if (order == DCGM_ORDER_ASCENDING)
     {
-        case DcgmcmEventTypeFvUpdate:
+        *Msamples = GetRollupSamples(watchInfo, startTime, endTime, rollupBeforeUsec, order, samples, maxSamples);
+        *Msamples += GetSpillSamples(
+            watchInfo, startTime, endTime, rawOldestUsec, order, &samples[*Msamples], maxSamples - *Msamples);
+
+        /* Copy the time range out a chunk at a time instead of walking a cursor entry by entry. Timestamps are
+           unique, so each chunk after the first starts just after the last entry of the one before */
+        timeseries_entry_t chunk[256];
+        timelib64_t chunkStartTime = startTime;
+        while ((*Msamples) < maxSamples)
         {
-            if (eventSub.fn.fvCb == nullptr)
+            int const numWanted = std::min(maxSamples - (*Msamples), (int)(sizeof(chunk) / sizeof(chunk[0])));
+            int const numCopied = timeseries_copy_range(timeseries, chunkStartTime, endTime, chunk, numWanted);
+
+            for (int i = 0; i < numCopied; i++)
             {
-                DCGM_LOG_DEBUG << "Cannot subscribe to field value updates using a null callback function";
-                return DCGM_ST_BADPARAM;
+                st = DcgmcmTimeSeriesEntryToSample(&samples[*Msamples], &chunk[i], timeseries);
+                if (st)
+                {
+                    *Msamples = 0;
+                    return st;
+                }
+
+                (*Msamples)++;
             }
-            break;
-        }
 
-        case DcgmcmEventTypeMigReconfigure:
+            if (numCopied < numWanted)
+                break; /* Ran out of samples or went past our end timestamp */
+            chunkStartTime = chunk[numCopied - 1].usecSince1970 + 1;
+        }
+    }
+    else /* DCGM_ORDER_DESCENDING */
+    {
+        /* Which entry we start on depends on if a starting timestamp was provided or not */
+        if (!endTime)
         {
-            if (eventSub.fn.migCb == nullptr)
-            {
-                DCGM_LOG_DEBUG << "Cannot subscribe to mig reconfigure updates using a null callback function";
-                return DCGM_ST_BADPARAM;
-            }
-            break;
+            entry = timeseries_last(timeseries, &cursor);
         }
-
-        default:
+        else
         {
-            DCGM_LOG_DEBUG << "Cannot process cache manager event type " << eventSub.type;
-            return DCGM_ST_BADPARAM;
+            entry = timeseries_find(timeseries, endTime, TS_LGE_LESSEQUAL, &cursor);
         }
-    }
-
-
-    dcgm_mutex_lock(m_mutex);
-    m_subscriptions[eventSub.type].push_back(eventSub);
-    dcgm_mutex_unlock(m_mutex);
 
-    return DCGM_ST_OK;
-}
+        /* Walk all samples until we fill our buffer, run out of samples, or go past our end timestamp */
+        for (; entry && (*Msamples) < maxSamples;
+             entry = timeseries_prev(timeseries, &cursor))
+        {
+            /* Past our time range? */
+            if (startTime && entry->usecSince1970 < startTime)
+                break;
 
-/*****************************************************************************/
-void DcgmCacheManager::MarkEnteredDriver()
-{
-    DcgmLockGuard dlg(m_mutex);
+            /* Got an entry. Convert it to a sample */
+            st = DcgmcmTimeSeriesEntryToSample(&samples[*Msamples], entry, timeseries);
+            if (st)
+            {
+                *Msamples = 0;
+                return st;
+            }
 
-    // Make sure we aren't waiting to detach from the GPUs
-    WaitForDriverToBeReady();
+            (*Msamples)++;
+        }
 
-    m_inDriverCount++;
-}
+        *Msamples += GetSpillSamples(
+            watchInfo, startTime, endTime, rawOldestUsec, order, &samples[*Msamples], maxSamples - *Msamples);
+        *Msamples += GetRollupSamples(
+            watchInfo, startTime, endTime, rollupBeforeUsec, order, &samples[*Msamples], maxSamples - *Msamples);
+    }
 
-/*****************************************************************************/
-void DcgmCacheManager::MarkReturnedFromDriver()
-{
-    DcgmLockGuard dlg(m_mutex);
+    /* Handle case where no samples are returned because of nvml errors calling the API */
+    if (!(*Msamples))
+    {
+        if (timeseries_size(timeseries) > 0)
+            retSt = DCGM_ST_NO_DATA; /* User just asked for a time range that has no records */
+        else if (watchInfo->lastStatus != NVML_SUCCESS)
+            retSt = NvmlReturnToDcgmReturn(watchInfo->lastStatus);
+        else if (!watchInfo->isWatched)
+            retSt = DCGM_ST_NOT_WATCHED;
+        else
+            retSt = DCGM_ST_NO_DATA;
+    }
 
-    m_inDriverCount--;
+    return retSt;
 }
 
 /*****************************************************************************/
-bool DcgmCacheManager::IsModulePushedFieldId(unsigned int fieldId)
-{
-    /* NvLink and Profiling fields are the fields >= 700 */
-    if (fieldId >= DCGM_FI_DEV_NVSWITCH_LATENCY_LOW_P00)
-        return true;
-    else
-        return false;
-}
+/* How many AcquireValueViews() calls this thread has yet to release. The first one locks the cache manager */
+static thread_local unsigned int t_valueViewHolds = 0;
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::ActuallyUpdateAllFields(dcgmcm_update_thread_t *threadCtx,
-                                                       timelib64_t *earliestNextUpdate)
+dcgmReturn_t DcgmCacheManager::AcquireValueViews(dcgmValueView_v1 *views, unsigned int numViews)
 {
-    dcgmcm_watch_info_p watchInfo = 0;
-    timelib64_t now, newNow, age, nextUpdate;
-    dcgmMutexReturn_t mutexReturn;   /* Tracks the state of the cache manager mutex */
-    int anyFieldValues          = 0; /* Have we queued any field values to be fetched from nvml? */
-    dcgm_field_meta_p fieldMeta = 0;
-
-    mutexReturn = m_mutex->Poll();
-    if (mutexReturn != DCGM_MUTEX_ST_LOCKEDBYME)
-    {
-        PRINT_ERROR("%d", "Entered ActuallyUpdateAllFields() without the lock st %d", (int)mutexReturn);
-        return DCGM_ST_GENERIC_ERROR; /* We need the lock in here */
-    }
+    if (!views)
+        return DCGM_ST_BADPARAM;
 
-    ClearThreadCtx(threadCtx);
+    if (t_valueViewHolds++ == 0)
+        dcgm_mutex_lock(m_mutex);
 
-    *earliestNextUpdate = 0;
-    now                 = timelib_usecSince1970();
+    timelib64_t now = timelib_usecSince1970();
 
-    /* Walk the hash table of watch objects, looking for any that have expired */
-    for (void *hashIter = hashtable_iter(m_entityWatchHashTable); hashIter;
-         hashIter       = hashtable_iter_next(m_entityWatchHashTable, hashIter))
+    for (unsigned int i = 0; i < numViews; i++)
     {
-        watchInfo = (dcgmcm_watch_info_p)hashtable_iter_value(hashIter);
+        dcgmValueView_v1 &view = views[i];
 
-        if (!watchInfo->isWatched)
-            continue; /* Not watched */
-
-        /* Some fields are pushed by modules. Don't handle those fields here */
-        if (IsModulePushedFieldId(watchInfo->watchKey.fieldId))
-            continue;
+        view.numSpans           = 0;
+        view.olderValuesOmitted = 0;
+        memset(view.spans, 0, sizeof(view.spans));
 
-        /* Last sample time old enough to take another? */
-        age = now - watchInfo->lastQueriedUsec;
-        if (age < watchInfo->monitorFrequencyUsec)
+        if (view.version != dcgmValueView_version1)
         {
-            nextUpdate = watchInfo->lastQueriedUsec + watchInfo->monitorFrequencyUsec;
-            if (!(*earliestNextUpdate) || nextUpdate < (*earliestNextUpdate))
-            {
-                *earliestNextUpdate = nextUpdate;
-            }
-            continue; /* Not old enough to update */
+            view.status = DCGM_ST_VER_MISMATCH;
+            continue;
         }
 
-        fieldMeta = DcgmFieldGetById(watchInfo->watchKey.fieldId);
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(view.fieldId);
         if (!fieldMeta)
         {
-            PRINT_ERROR("%d", "Unexpected null fieldMeta for field %d", watchInfo->watchKey.fieldId);
+            view.status = DCGM_ST_UNKNOWN_FIELD;
             continue;
         }
-
-        PRINT_DEBUG("%p %u %u %u",
-                    "Preparing to update watchInfo %p, eg %u, eid %u, fieldId %u",
-                    (void *)watchInfo,
-                    watchInfo->watchKey.entityGroupId,
-                    watchInfo->watchKey.entityId,
-                    watchInfo->watchKey.fieldId);
-
-        if (watchInfo->practicalEntityGroupId == DCGM_FE_GPU)
-        {
-            /* Don't cache GPU fields if the GPU is not available */
-            DcgmEntityStatus_t gpuStatus = GetGpuStatus(watchInfo->practicalEntityId);
-            if (gpuStatus != DcgmEntityStatusOk)
-            {
-                PRINT_DEBUG("%d %d", "Skipping gpuId %d in status %d", watchInfo->practicalEntityId, gpuStatus);
-                continue;
-            }
-        }
-        /* Base when we sync again on before the driver call so we don't continuously
-         * get behind by how long the driver call took
-         */
-        nextUpdate = now + watchInfo->monitorFrequencyUsec;
-        if (!(*earliestNextUpdate) || nextUpdate < (*earliestNextUpdate))
+        view.fieldType = fieldMeta->fieldType;
+        if (fieldMeta->fieldType != DCGM_FT_DOUBLE && fieldMeta->fieldType != DCGM_FT_INT64
+            && fieldMeta->fieldType != DCGM_FT_TIMESTAMP)
         {
-            *earliestNextUpdate = nextUpdate;
+            view.status = DCGM_ST_BADPARAM;
+            continue;
         }
 
-        /* Set key information before we call child functions */
-        threadCtx->entityKey.entityGroupId = watchInfo->practicalEntityGroupId;
-        threadCtx->entityKey.entityId      = watchInfo->practicalEntityId;
-        threadCtx->entityKey.fieldId       = watchInfo->watchKey.fieldId;
-        threadCtx->watchInfo               = watchInfo;
+        dcgmcm_watch_info_p watchInfo;
+        if (fieldMeta->scope == DCGM_FS_GLOBAL)
+            watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+        else
+            watchInfo = GetEntityWatchInfo(view.entityGroupId, view.entityId, fieldMeta->fieldId, 0);
 
-        MarkEnteredDriver();
+        view.status = PrecheckWatchInfoForSamples(watchInfo);
+        if (view.status != DCGM_ST_OK)
+            continue;
 
-        /* Unlock the mutex before the driver call, unless we're just buffering a list of field values */
-        mutexReturn = m_mutex->Poll();
-        if ((watchInfo->practicalEntityGroupId != DCGM_FE_GPU || !fieldMeta->nvmlFieldId)
-            && mutexReturn == DCGM_MUTEX_ST_LOCKEDBYME)
+        watchInfo->lastReadUsec = now;
+
+        timelib64_t startTime = view.sinceTimestamp ? view.sinceTimestamp + 1 : 0;
+        timeseries_span_t spans[DCGM_VALUE_VIEW_MAX_SPANS];
+        int numSpans = timeseries_ring_spans(
+            watchInfo->timeSeries, startTime, std::max(0, view.maxCount), spans, &view.olderValuesOmitted);
+        if (numSpans < 0)
         {
-            dcgm_mutex_unlock(m_mutex);
-            mutexReturn = DCGM_MUTEX_ST_NOTLOCKED;
+            /* Only numeric ring time series are contiguous */
+            view.status = DCGM_ST_NOT_SUPPORTED;
+            continue;
         }
 
-        if (watchInfo->practicalEntityGroupId == DCGM_FE_NONE)
-            BufferOrCacheLatestGpuValue(threadCtx, fieldMeta);
-        else if (watchInfo->practicalEntityGroupId == DCGM_FE_GPU)
+        int numValues = 0;
+        for (int spanIndex = 0; spanIndex < numSpans; spanIndex++)
         {
-            /* Is this a mapped field? Set aside the info for the field and handle it below */
-            if (fieldMeta->nvmlFieldId > 0)
-            {
-                unsigned int gpuId                                                      = watchInfo->practicalEntityId;
-                threadCtx->fieldValueFields[gpuId][threadCtx->numFieldValues[gpuId]]    = fieldMeta;
-                threadCtx->fieldValueWatchInfo[gpuId][threadCtx->numFieldValues[gpuId]] = watchInfo;
-                threadCtx->numFieldValues[gpuId]++;
-                anyFieldValues = 1;
-                MarkReturnedFromDriver();
-                continue;
-            }
+            view.spans[spanIndex].timestamps = (long long const *)spans[spanIndex].usecSince1970;
+            view.spans[spanIndex].values     = spans[spanIndex].values;
+            view.spans[spanIndex].count      = spans[spanIndex].count;
+            numValues += spans[spanIndex].count;
+        }
+        view.numSpans = numSpans;
 
-            BufferOrCacheLatestGpuValue(threadCtx, fieldMeta);
+        /* Rolled-up history older than the raw samples is only in the rollup */
+        if (watchInfo->rollup && (view.maxCount <= 0 || numValues < view.maxCount))
+        {
+            timeseries_entry_p first = timeseries_first(watchInfo->timeSeries, nullptr);
+            if (first && first->usecSince1970 > startTime)
+                view.olderValuesOmitted = 1;
         }
-        else if (watchInfo->practicalEntityGroupId == DCGM_FE_VGPU)
-            BufferOrCacheLatestVgpuValue(threadCtx, watchInfo->practicalEntityId, fieldMeta);
-        else
-            PRINT_DEBUG("%u", "Unhandled entityGroupId %u", watchInfo->practicalEntityGroupId);
-        /* Resync clock after a value fetch since a driver call may take a while */
-        newNow = timelib_usecSince1970();
+    }
 
-        // accumulate the time spent retrieving this field
-        watchInfo->execTimeUsec += newNow - now;
-        watchInfo->fetchCount += 1;
-        now = newNow;
+    return DCGM_ST_OK;
+}
 
-        /* Relock the mutex if we need to */
-        if (mutexReturn == DCGM_MUTEX_ST_NOTLOCKED)
-            mutexReturn = dcgm_mutex_lock(m_mutex);
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::ReleaseValueViews(void)
+{
+    if (t_valueViewHolds == 0)
+        return DCGM_ST_UNINITIALIZED;
 
-        MarkReturnedFromDriver();
-    }
+    if (--t_valueViewHolds == 0)
+        dcgm_mutex_unlock(m_mutex);
 
-    if (!anyFieldValues)
-        return DCGM_ST_OK;
+    return DCGM_ST_OK;
+}
 
-    /* Unlock the mutex before the driver call */
-    mutexReturn = m_mutex->Poll();
-    if (mutexReturn == DCGM_MUTEX_ST_LOCKEDBYME)
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetSamplesAfter(dcgm_field_entity_group_t entityGroupId,
+                                               dcgm_field_eid_t entityId,
+                                               unsigned short dcgmFieldId,
+                                               dcgmcm_sample_p samples,
+                                               int *Msamples,
+                                               timeseries_position_t *position,
+                                               long long *samplesSkipped)
+{
+    if (!samples || !Msamples || (*Msamples) < 1 || !position)
+        return DCGM_ST_BADPARAM;
+
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_UNKNOWN_FIELD;
+
+    if (fieldMeta->scope == DCGM_FS_GLOBAL && entityGroupId != DCGM_FE_NONE)
     {
-        dcgm_mutex_unlock(m_mutex);
-        mutexReturn = DCGM_MUTEX_ST_NOTLOCKED;
+        DCGM_LOG_DEBUG << "Fixing entityGroupId for global field";
+        entityGroupId = DCGM_FE_NONE;
     }
 
-    for (unsigned int gpuId = 0; gpuId < m_numGpus; gpuId++)
-    {
-        if (!threadCtx->numFieldValues[gpuId])
-            continue;
+    int maxSamples = *Msamples;
+    *Msamples      = 0;
 
-        PRINT_DEBUG("%d %u", "Got %d field value fields for gpuId %u", threadCtx->numFieldValues[gpuId], gpuId);
+    DcgmLockGuard dlg(m_mutex);
 
-        MarkEnteredDriver();
-        ActuallyUpdateGpuFieldValues(threadCtx, gpuId);
-        MarkReturnedFromDriver();
+    dcgmcm_watch_info_p watchInfo;
+    if (entityGroupId != DCGM_FE_NONE)
+        watchInfo = GetEntityWatchInfo(entityGroupId, entityId, fieldMeta->fieldId, 0);
+    else
+        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+
+    dcgmReturn_t st = PrecheckWatchInfoForSamples(watchInfo);
+    if (st != DCGM_ST_OK)
+        return st;
+
+    watchInfo->lastReadUsec = timelib_usecSince1970();
+    timeseries_p timeseries = watchInfo->timeSeries;
+    timeseries_cursor_t cursor;
+
+    for (timeseries_entry_p entry = timeseries_resume(timeseries, position, &cursor, samplesSkipped);
+         entry && (*Msamples) < maxSamples;
+         entry = timeseries_next(timeseries, &cursor))
+    {
+        st = DcgmcmTimeSeriesEntryToSample(&samples[*Msamples], entry, timeseries);
+        if (st)
+        {
+            FreeSamples(samples, *Msamples, dcgmFieldId);
+            *Msamples = 0;
+            return st;
+        }
+
+        (*Msamples)++;
+        timeseries_position_after(timeseries, entry, &cursor, position);
     }
 
-    /* relock the mutex if we need to */
-    if (mutexReturn == DCGM_MUTEX_ST_NOTLOCKED)
-        mutexReturn = dcgm_mutex_lock(m_mutex);
+    if (!(*Msamples))
+    {
+        if (timeseries_size(timeseries) > 0)
+            return DCGM_ST_NO_DATA; /* Nothing new */
+        else if (watchInfo->lastStatus != NVML_SUCCESS)
+            return NvmlReturnToDcgmReturn(watchInfo->lastStatus);
+        else if (!watchInfo->isWatched)
+            return DCGM_ST_NOT_WATCHED;
+        return DCGM_ST_NO_DATA;
+    }
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-static bool FieldSupportsLiveUpdates(dcgm_field_entity_group_t entityGroupId, unsigned short fieldId)
+/* Fold the samples of from, which come after those of into, into into */
+static void DcgmcmMergeBucket(int tsType, timeseries_bucket_t &into, timeseries_bucket_t const &from)
 {
-    if (entityGroupId != DCGM_FE_NONE && entityGroupId != DCGM_FE_GPU && entityGroupId != DCGM_FE_GPU_I
-        && entityGroupId != DCGM_FE_GPU_CI)
+    if (tsType == TS_TYPE_INT64)
     {
-        return false;
+        into.min.i64 = std::min(into.min.i64, from.min.i64);
+        into.max.i64 = std::max(into.max.i64, from.max.i64);
+    }
+    else
+    {
+        into.min.dbl = std::min(into.min.dbl, from.min.dbl);
+        into.max.dbl = std::max(into.max.dbl, from.max.dbl);
     }
 
-    /* Any fieldIds that result in multiple samples need to be excluded from live updates */
-    switch (fieldId)
+    into.count += from.count;
+    into.sum += from.sum;
+    into.last     = from.last;
+    into.lastUsec = from.lastUsec;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetMultipleSamples(std::vector<dcgmcm_sample_query_t> const &queries,
+                                                  timelib64_t startTime,
+                                                  timelib64_t endTime,
+                                                  int maxSamplesPerQuery,
+                                                  DcgmFvBuffer *fvBuffer)
+{
+    if (!fvBuffer || maxSamplesPerQuery < 1)
+        return DCGM_ST_BADPARAM;
+
+    std::vector<dcgmcm_sample_t> samples(maxSamplesPerQuery);
+
+    /* GetSamples() relocks recursively, so every query sees the same state of the cache */
+    DcgmLockGuard dlg(m_mutex);
+
+    for (auto const &query : queries)
     {
-        case DCGM_FI_DEV_SUPPORTED_TYPE_INFO:
-        case DCGM_FI_DEV_GRAPHICS_PIDS:
-        case DCGM_FI_DEV_COMPUTE_PIDS:
-        case DCGM_FI_DEV_GPU_UTIL_SAMPLES:
-        case DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES:
-            return false;
+        int count       = maxSamplesPerQuery;
+        dcgmReturn_t st = GetSamples(query.entityGroupId,
+                                     query.entityId,
+                                     query.fieldId,
+                                     samples.data(),
+                                     &count,
+                                     startTime,
+                                     endTime,
+                                     query.order);
+        if (st != DCGM_ST_OK)
+        {
+            fvBuffer->AddInt64Value(query.entityGroupId, query.entityId, query.fieldId, 0, 0, st);
+            continue;
+        }
 
-        default:
-            break;
+        /* GetSamples() succeeding means that the field exists */
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(query.fieldId);
+
+        for (int i = 0; i < count && st == DCGM_ST_OK; i++)
+        {
+            st = DcgmcmWriteSampleToFvBuffer(query.entityGroupId, query.entityId, fieldMeta, &samples[i], fvBuffer);
+        }
+
+        FreeSamples(samples.data(), count, query.fieldId);
+        if (st != DCGM_ST_OK)
+            return st;
     }
 
-    return true;
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetMultipleLatestLiveSamples(std::vector<dcgmGroupEntityPair_t> &entities,
-                                                            std::vector<unsigned short> &fieldIds,
-                                                            DcgmFvBuffer *fvBuffer)
+dcgmReturn_t DcgmCacheManager::GetBucketedSamples(dcgm_field_entity_group_t entityGroupId,
+                                                  dcgm_field_eid_t entityId,
+                                                  unsigned short dcgmFieldId,
+                                                  timelib64_t startTime,
+                                                  timelib64_t endTime,
+                                                  timelib64_t bucketWidth,
+                                                  int maxBuckets,
+                                                  std::vector<timeseries_bucket_t> &buckets)
 {
-    std::vector<dcgmGroupEntityPair_t>::iterator entityIt;
-    std::vector<unsigned short>::iterator fieldIdIt;
-    unsigned short fieldId;
-    dcgm_field_meta_p fieldMeta = 0;
+    buckets.clear();
 
-    if (!fvBuffer)
+    if (bucketWidth <= 0 || maxBuckets < 1)
         return DCGM_ST_BADPARAM;
 
-    /* Allocate a thread context in this function in case we're in a user thread (embeded host engine) */
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_UNKNOWN_FIELD;
+    if (fieldMeta->fieldType != DCGM_FT_INT64 && fieldMeta->fieldType != DCGM_FT_TIMESTAMP
+        && fieldMeta->fieldType != DCGM_FT_DOUBLE)
+    {
+        return DCGM_ST_NOT_SUPPORTED;
+    }
 
-    dcgmcm_update_thread_t threadCtx;
-    InitAndClearThreadCtx(&threadCtx);
+    if (fieldMeta->scope == DCGM_FS_GLOBAL && entityGroupId != DCGM_FE_NONE)
+    {
+        DCGM_LOG_DEBUG << "Fixing entityGroupId for global field";
+        entityGroupId = DCGM_FE_NONE;
+    }
 
-    threadCtx.fvBuffer = fvBuffer;
+    DcgmLockGuard dlg(m_mutex);
 
-    /* Note: because we're handling fields that come from the NVML field value APIs out of order
-             from those that don't, we don't guarantee any order of returned results */
+    dcgmcm_watch_info_p watchInfo;
+    if (entityGroupId != DCGM_FE_NONE)
+        watchInfo = GetEntityWatchInfo(entityGroupId, entityId, fieldMeta->fieldId, 0);
+    else
+        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
 
-    for (entityIt = entities.begin(); entityIt != entities.end(); ++entityIt)
-    {
-        dcgm_field_entity_group_t entityGroupId = (*entityIt).entityGroupId;
-        dcgm_field_eid_t entityId               = (*entityIt).entityId;
+    dcgmReturn_t st = PrecheckWatchInfoForSamples(watchInfo);
+    if (st != DCGM_ST_OK)
+        return st;
 
-        threadCtx.entityKey.entityGroupId = entityGroupId;
-        threadCtx.entityKey.entityId      = entityId;
+    watchInfo->lastReadUsec = timelib_usecSince1970();
+    timeseries_p timeseries = watchInfo->timeSeries;
+    int tsType              = timeseries->tsType;
 
-        for (fieldIdIt = fieldIds.begin(); fieldIdIt != fieldIds.end(); ++fieldIdIt)
-        {
-            fieldId                     = *fieldIdIt;
-            threadCtx.entityKey.fieldId = fieldId;
-            /* Restore entityGroupId since it may have been changed by a previous iteration */
-            entityGroupId = (*entityIt).entityGroupId;
+    /* History older than the raw samples comes from the rollup */
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry  = timeseries_first(timeseries, &cursor);
+    timelib64_t rawOldestUsec = entry ? entry->usecSince1970 : LLONG_MAX;
+    int tier                  = watchInfo->rollup ? watchInfo->rollup->FindTier(startTime) : -1;
 
-            fieldMeta = DcgmFieldGetById(fieldId);
-            if (!fieldMeta)
-            {
-                PRINT_ERROR("%u", "Invalid field ID %u passed in.", fieldId);
-                fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_UNKNOWN_FIELD);
+    if (tier >= 0 && (!startTime || startTime < rawOldestUsec))
+    {
+        for (dcgmcm_rollup_bucket_t const &rollupBucket : watchInfo->rollup->Buckets(tier))
+        {
+            if (rollupBucket.lastUsec >= rawOldestUsec || (endTime && rollupBucket.firstUsec > endTime))
+                break;
+            if (startTime && rollupBucket.lastUsec < startTime)
                 continue;
-            }
-
-            /* Handle if the user accidentally marked this field as an entity field if it's global */
-            if (fieldMeta->scope == DCGM_FS_GLOBAL)
-            {
-                PRINT_DEBUG("%u", "Fixed entityGroupId to be DCGM_FE_NONE fieldId %u", fieldId);
-                entityGroupId = DCGM_FE_NONE;
-            }
 
-            /* Does this entity + fieldId even support live updates?
-               This will filter out VGPUs and NvSwitches */
-            if (!FieldSupportsLiveUpdates(entityGroupId, fieldId))
+            timeseries_bucket_t bucket {};
+            bucket.startUsec = rollupBucket.startUsec - (rollupBucket.startUsec % bucketWidth);
+            bucket.lastUsec  = rollupBucket.lastUsec;
+            bucket.count     = rollupBucket.count;
+            bucket.sum       = rollupBucket.sum;
+            if (tsType == TS_TYPE_INT64)
             {
-                PRINT_DEBUG("%u %u", "eg %u fieldId %u doesn't support live updates.", entityGroupId, fieldId);
-                fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_FIELD_UNSUPPORTED_BY_API);
-                continue;
+                bucket.min.i64  = llround(rollupBucket.min);
+                bucket.max.i64  = llround(rollupBucket.max);
+                bucket.last.i64 = llround(rollupBucket.last);
             }
-
-            if (entityGroupId == DCGM_FE_NONE)
+            else
             {
-                BufferOrCacheLatestGpuValue(&threadCtx, fieldMeta);
+                bucket.min.dbl  = rollupBucket.min;
+                bucket.max.dbl  = rollupBucket.max;
+                bucket.last.dbl = rollupBucket.last;
             }
-            else if (entityGroupId == DCGM_FE_GPU || entityGroupId == DCGM_FE_GPU_I || entityGroupId == DCGM_FE_GPU_CI)
-            {
-                /* Is the entityId valid? */
-                if (!GetIsValidEntityId(entityGroupId, entityId))
-                {
-                    PRINT_WARNING("%u %u", "Got invalid eg %u, eid %u", entityGroupId, entityId);
-                    fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_BADPARAM);
-                    continue;
-                }
 
-                /* Is this a mapped field? Set aside the info for the field and handle it below */
-                if (fieldMeta->nvmlFieldId > 0)
-                {
-                    threadCtx.fieldValueFields[entityId][threadCtx.numFieldValues[entityId]] = fieldMeta;
-                    threadCtx.fieldValueWatchInfo[entityId][threadCtx.numFieldValues[entityId]]
-                        = 0; /* Don't cache. Only buffer it */
-                    threadCtx.numFieldValues[entityId]++;
-                }
-                else
-                    BufferOrCacheLatestGpuValue(&threadCtx, fieldMeta);
-            }
+            if (!buckets.empty() && buckets.back().startUsec == bucket.startUsec)
+                DcgmcmMergeBucket(tsType, buckets.back(), bucket);
+            else if ((int)buckets.size() < maxBuckets)
+                buckets.push_back(bucket);
             else
-            {
-                /* Unhandled entity group. Should have been caught by FieldSupportsLiveUpdates() */
-                PRINT_ERROR("%u %u %u",
-                            "Didn't expect to get here for eg %u, eid %u, fieldId %u",
-                            threadCtx.entityKey.entityGroupId,
-                            threadCtx.entityKey.entityId,
-                            fieldId);
-                fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_FIELD_UNSUPPORTED_BY_API);
-            }
+                break;
         }
+    }
 
-        /* Handle any field values that come from the NVML FV APIs. Note that entityId could be invalid, so
-           we need to check it */
-        if (entityGroupId == DCGM_FE_GPU && GetIsValidEntityId(entityGroupId, entityId)
-            && threadCtx.numFieldValues[entityId] > 0)
-        {
-            ActuallyUpdateGpuFieldValues(&threadCtx, entityId);
-        }
+    /* Then the raw samples, read in place from the ring where possible */
+    int numRollupBuckets = buckets.size();
+    buckets.resize(maxBuckets + 1);
+    int numRaw = timeseries_bucketize(timeseries,
+                                      startTime,
+                                      endTime,
+                                      bucketWidth,
+                                      &buckets[numRollupBuckets],
+                                      maxBuckets + 1 - numRollupBuckets);
+    if (numRaw < 0)
+    {
+        DCGM_LOG_ERROR << "timeseries_bucketize returned " << numRaw << " for fieldId " << dcgmFieldId;
+        buckets.clear();
+        return DCGM_ST_GENERIC_ERROR;
+    }
+    buckets.resize(numRollupBuckets + numRaw);
+
+    /* The rollup and the raw samples can share a bucket at the boundary */
+    if (numRollupBuckets && numRaw && buckets[numRollupBuckets - 1].startUsec == buckets[numRollupBuckets].startUsec)
+    {
+        DcgmcmMergeBucket(tsType, buckets[numRollupBuckets - 1], buckets[numRollupBuckets]);
+        buckets.erase(buckets.begin() + numRollupBuckets);
+    }
+    if ((int)buckets.size() > maxBuckets)
+        buckets.resize(maxBuckets);
+
+    if (buckets.empty())
+    {
+        if (timeseries_size(timeseries) > 0)
+            return DCGM_ST_NO_DATA;
+        else if (watchInfo->lastStatus != NVML_SUCCESS)
+            return NvmlReturnToDcgmReturn(watchInfo->lastStatus);
+        else if (!watchInfo->isWatched)
+            return DCGM_ST_NOT_WATCHED;
+        return DCGM_ST_NO_DATA;
     }
 
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-static double NvmlFieldValueToDouble(nvmlFieldValue_t *v)
+dcgmReturn_t DcgmCacheManager::GetLatestSample(dcgm_field_entity_group_t entityGroupId,
+                                               dcgm_field_eid_t entityId,
+                                               unsigned short dcgmFieldId,
+                                               dcgmcm_sample_p sample,
+                                               DcgmFvBuffer *fvBuffer)
 {
-    long long retVal = 0;
+    dcgm_field_meta_p fieldMeta = 0;
+    dcgmReturn_t st, retSt = DCGM_ST_OK;
+    timeseries_p timeseries       = 0;
+    dcgmcm_watch_info_p watchInfo = 0;
 
-    switch (v->valueType)
+    if (!sample && !fvBuffer)
+        return DCGM_ST_BADPARAM;
+
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
     {
-        case NVML_VALUE_TYPE_DOUBLE:
-            return (double)v->value.dVal;
+        if (fvBuffer)
+            fvBuffer->AddInt64Value(entityGroupId, entityId, dcgmFieldId, 0, 0, DCGM_ST_UNKNOWN_FIELD);
+        return DCGM_ST_UNKNOWN_FIELD;
+    }
 
-        case NVML_VALUE_TYPE_UNSIGNED_INT:
-            return (double)v->value.uiVal;
+    dcgm_field_entity_group_t watchEntityGroupId = entityGroupId;
+    unsigned int watchEntityId                   = entityId;
 
-        case NVML_VALUE_TYPE_UNSIGNED_LONG:
-            return (double)v->value.ulVal;
+    if (fieldMeta->scope == DCGM_FS_GLOBAL && watchEntityGroupId != DCGM_FE_NONE)
+    {
+        DCGM_LOG_DEBUG << "Fixing entityGroupId for global field";
+        watchEntityGroupId = DCGM_FE_NONE;
+    }
 
-        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG:
-            return (double)v->value.ullVal;
+    /* Numeric samples can be read without blocking the update loop */
+    if (GetLatestSampleLockFree(watchEntityGroupId, watchEntityId, fieldMeta->fieldId, sample, fvBuffer))
+        return DCGM_ST_OK;
 
-        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:
-            return (double)v->value.sllVal;
+    DcgmLockGuard dlg(m_mutex);
 
-        default:
-            PRINT_ERROR("%d", "Unhandled valueType: %d", (int)v->valueType);
-            return retVal;
+    /* Don't need to GetIsValidEntityId(entityGroupId, entityId) here because Get*WatchInfo will
+       return null if there isn't a valid watch */
+
+    if (watchEntityGroupId == DCGM_FE_NONE)
+        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+    else
+        watchInfo = GetEntityWatchInfo(watchEntityGroupId, watchEntityId, fieldMeta->fieldId, 0);
+
+    st = PrecheckWatchInfoForSamples(watchInfo);
+    if (st != DCGM_ST_OK)
+    {
+        if (fvBuffer)
+            fvBuffer->AddInt64Value(watchEntityGroupId, watchEntityId, dcgmFieldId, 0, 0, st);
+        return st;
     }
 
-    return retVal;
+    /* Data type is assumed to be a time series type */
+
+    timeseries = watchInfo->timeSeries;
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = timeseries_last(timeseries, &cursor);
+    if (!entry)
+    {
+        /* No entries in time series. If NVML apis failed, return their error code */
+        if (watchInfo->lastStatus != NVML_SUCCESS)
+            retSt = NvmlReturnToDcgmReturn(watchInfo->lastStatus);
+        else if (!watchInfo->isWatched)
+            retSt = DCGM_ST_NOT_WATCHED;
+        else
+            retSt = DCGM_ST_NO_DATA;
+
+        if (fvBuffer)
+            fvBuffer->AddInt64Value(watchEntityGroupId, watchEntityId, dcgmFieldId, 0, 0, retSt);
+        return retSt;
+    }
+
+    /* Got an entry. Convert it to a sample */
+    if (sample)
+    {
+        st    = DcgmcmTimeSeriesEntryToSample(sample, entry, timeseries);
+        retSt = st;
+    }
+    /* If the user provided a FV buffer, append our sample to it */
+    if (fvBuffer)
+    {
+        st = DcgmcmWriteTimeSeriesEntryToFvBuffer(
+            watchEntityGroupId, watchEntityId, dcgmFieldId, entry, fvBuffer, timeseries);
+        retSt = st;
+    }
+
+    return retSt;
 }
 
 /*****************************************************************************/
-long long NvmlFieldValueToInt64(nvmlFieldValue_t *v)
+unsigned long long DcgmCacheManager::GetWatchUpdateSequence(dcgm_field_entity_group_t entityGroupId,
+                                                            dcgm_field_eid_t entityId,
+                                                            unsigned short fieldId)
 {
-    long long retVal = 0;
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+    if (!fieldMeta)
+        return 0;
 
-    switch (v->valueType)
+    /* Global watches have no entityId. See GetEntityWatchInfo() */
+    if (fieldMeta->scope == DCGM_FS_GLOBAL)
     {
-        case NVML_VALUE_TYPE_DOUBLE:
-            return (long long)v->value.dVal;
+        entityGroupId = DCGM_FE_NONE;
+        entityId      = 0;
+    }
 
-        case NVML_VALUE_TYPE_UNSIGNED_INT:
-            return (long long)v->value.uiVal;
+    dcgmcm_entity_key_t watchKey;
+    EntityIdToWatchKey(&watchKey, entityGroupId, entityId, fieldId);
 
-        case NVML_VALUE_TYPE_UNSIGNED_LONG:
-            return (long long)v->value.ulVal;
+    DcgmcmLockFreeReader reader(m_lockFreeReaders);
+    dcgmcm_watch_info_p watchInfo = LookupWatchIndex(watchKey);
+    if (!watchInfo)
+        return 0;
 
-        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG:
-            return (long long)v->value.ullVal;
+    return watchInfo->latestValue.updateSequence.load(std::memory_order_acquire);
+}
 
-        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:
-            return (long long)v->value.sllVal;
+/*****************************************************************************/
+bool DcgmCacheManager::GetLatestSampleLockFree(dcgm_field_entity_group_t entityGroupId,
+                                               dcgm_field_eid_t entityId,
+                                               unsigned short fieldId,
+                                               dcgmcm_sample_p sample,
+                                               DcgmFvBuffer *fvBuffer)
+{
+    dcgmcm_entity_key_t watchKey;
 
-        default:
-            PRINT_ERROR("%d", "Unhandled valueType: %d", (int)v->valueType);
-            return retVal;
+    /* Global watches have no entityId. See GetEntityWatchInfo() */
+    EntityIdToWatchKey(&watchKey, entityGroupId, entityGroupId == DCGM_FE_NONE ? 0 : entityId, fieldId);
+
+    DcgmcmLockFreeReader reader(m_lockFreeReaders);
+    dcgmcm_watch_info_p watchInfo = LookupWatchIndex(watchKey);
+    if (!watchInfo)
+        return false;
+
+    dcgmcm_latest_value_t &latest = watchInfo->latestValue;
+    int tsType;
+    long long timestamp, val, val2;
+
+    for (int attempt = 0; attempt < DCGM_CM_LATEST_VALUE_MAX_RETRIES; attempt++)
+    {
+        unsigned int sequence = latest.sequence.load(std::memory_order_acquire);
+        if (sequence & 1)
+            continue; /* Writer is mid-update */
+
+        tsType    = latest.tsType.load(std::memory_order_relaxed);
+        timestamp = latest.timestamp.load(std::memory_order_relaxed);
+        val       = latest.val.load(std::memory_order_relaxed);
+        val2      = latest.val2.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (latest.sequence.load(std::memory_order_relaxed) != sequence)
+            continue; /* Torn read */
+
+        if (tsType == TS_TYPE_INT64)
+        {
+            if (sample)
+            {
+                sample->timestamp = timestamp;
+                sample->val.i64   = val;
+                sample->val2.i64  = val2;
+            }
+            if (fvBuffer)
+                fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, val, timestamp, DCGM_ST_OK);
+            return true;
+        }
+        else if (tsType == TS_TYPE_DOUBLE)
+        {
+            double dblVal, dblVal2;
+            memcpy(&dblVal, &val, sizeof(dblVal));
+            memcpy(&dblVal2, &val2, sizeof(dblVal2));
+            if (sample)
+            {
+                sample->timestamp = timestamp;
+                sample->val.d     = dblVal;
+                sample->val2.d    = dblVal2;
+            }
+            if (fvBuffer)
+                fvBuffer->AddDoubleValue(entityGroupId, entityId, fieldId, dblVal, timestamp, DCGM_ST_OK);
+            return true;
+        }
+
+        return false; /* No numeric sample. Let the locked path work out what to return */
     }
 
-    return retVal;
+    return false;
 }
 
-void DcgmCacheManager::InsertNvmlErrorValue(dcgmcm_update_thread_t *threadCtx,
-                                            unsigned char fieldType,
-                                            nvmlReturn_t err,
-                                            timelib64_t maxAgeUsec)
-
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetMultipleLatestSamples(std::vector<dcgmGroupEntityPair_t> &entities,
+                                                        std::vector<unsigned short> &fieldIds,
+                                                        DcgmFvBuffer *fvBuffer,
+                                                        unsigned long long sinceSequence,
+                                                        unsigned long long *updateSequence)
 {
-    timelib64_t now            = timelib_usecSince1970();
-    timelib64_t oldestKeepTime = 0;
+    std::vector<dcgmGroupEntityPair_t>::iterator entityIt;
+    std::vector<unsigned short>::iterator fieldIdIt;
 
-    if (maxAgeUsec)
-        oldestKeepTime = now - maxAgeUsec;
+    if (!fvBuffer)
+        return DCGM_ST_BADPARAM;
 
-    /* Append a blank value of the correct type for our fieldId */
-    switch (fieldType)
-    {
-        case DCGM_FT_DOUBLE:
-            AppendEntityDouble(threadCtx, NvmlErrorToDoubleValue(err), 0, now, oldestKeepTime);
-            break;
+    /* Read before any watch so that updates racing this request are returned next time */
+    if (updateSequence)
+        *updateSequence = m_updateSequence.load(std::memory_order_acquire);
 
-        case DCGM_FT_INT64:
-            AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(err), 0, now, oldestKeepTime);
-            break;
+    /* Lock the cache manager once for a request of several samples so that they all come
+       from the same update. GetLatestSample() reads a lone numeric sample lock-free */
+    bool const lockRequest = entities.size() * fieldIds.size() > 1;
+    if (lockRequest)
+        dcgm_mutex_lock(m_mutex);
 
-        case DCGM_FT_STRING:
-            AppendEntityString(threadCtx, NvmlErrorToStringValue(err), now, oldestKeepTime);
-            break;
+    for (entityIt = entities.begin(); entityIt != entities.end(); ++entityIt)
+    {
+        for (fieldIdIt = fieldIds.begin(); fieldIdIt != fieldIds.end(); ++fieldIdIt)
+        {
+            if (sinceSequence > 0
+                && GetWatchUpdateSequence(entityIt->entityGroupId, entityIt->entityId, *fieldIdIt) <= sinceSequence)
+            {
+                continue; /* The caller already has this one */
+            }
 
-        default:
-            PRINT_ERROR("%c", "Field Type %c is unsupported for conversion from NVML errors", fieldType);
-            break;
+            /* Buffer each sample. Errors are written as statuses for each fv in fvBuffer */
+            dcgmReturn_t ret
+                = GetLatestSample((*entityIt).entityGroupId, (*entityIt).entityId, (*fieldIdIt), 0, fvBuffer);
+            if (DCGM_ST_OK != ret)
+            {
+                DCGM_LOG_ERROR << "GetLatestSample returned " << errorString(ret) << " for entityId "
+                               << entityIt->entityId << " groupId " << entityIt->entityGroupId << " fieldId "
+                               << *fieldIdIt;
+            }
+        }
     }
+
+    if (lockRequest)
+        dcgm_mutex_unlock(m_mutex);
+
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::ActuallyUpdateGpuFieldValues(dcgmcm_update_thread_t *threadCtx, unsigned int gpuId)
+/* Make a cell of matrix blank for the reason in st */
+static void DcgmcmSetMatrixCellBlank(dcgmLatestValuesMatrix_v1 *matrix,
+                                     unsigned int cell,
+                                     unsigned char fieldType,
+                                     dcgmReturn_t st)
 {
-    nvmlFieldValue_t values[NVML_FI_MAX]; /* Place to store actual NVML field values */
-    nvmlFieldValue_t *fv;                 /* Cached field value pointer */
-    int i;
-    nvmlReturn_t nvmlReturn;
-    timelib64_t expireTime;
-
-    /* Make local variables for threadCtx members to simplify the code */
-    int numFields                  = threadCtx->numFieldValues[gpuId];
-    dcgm_field_meta_p *fieldMeta   = threadCtx->fieldValueFields[gpuId];
-    dcgmcm_watch_info_p *watchInfo = threadCtx->fieldValueWatchInfo[gpuId];
+    if (fieldType == DCGM_FT_DOUBLE)
+        matrix->values[cell].dbl = DCGM_FP64_BLANK;
+    else if (fieldType == DCGM_FT_STRING)
+        matrix->values[cell].i64 = 0; /* The empty string */
+    else
+        matrix->values[cell].i64 = DCGM_INT64_BLANK;
+    matrix->timestamps[cell] = 0;
+
+    unsigned char status = DCGM_MATRIX_CELL_BLANK;
+    if (st == DCGM_ST_NOT_WATCHED)
+        status |= DCGM_MATRIX_CELL_NOT_WATCHED;
+    else if (st == DCGM_ST_NOT_SUPPORTED)
+        status |= DCGM_MATRIX_CELL_NOT_SUPPORTED;
+    else if (st != DCGM_ST_NO_DATA)
+        status |= DCGM_MATRIX_CELL_ERROR;
+    matrix->status[cell] = status;
+}
 
-    if (gpuId >= m_numGpus)
-        return DCGM_ST_GENERIC_ERROR;
+/*****************************************************************************/
+/* Append str to the strings of matrix as the value of cell, cut short if they're full */
+static void DcgmcmSetMatrixCellString(dcgmLatestValuesMatrix_v1 *matrix,
+                                      unsigned int cell,
+                                      char const *str,
+                                      timelib64_t timestamp)
+{
+    size_t const length = strlen(str);
+    size_t const room   = DCGM_MATRIX_STRINGS_SIZE - matrix->stringsSize;
 
-    if (numFields >= NVML_FI_MAX)
+    matrix->status[cell]     = DCGM_STR_IS_BLANK(str) ? DCGM_MATRIX_CELL_BLANK : 0;
+    matrix->timestamps[cell] = timestamp;
+    if (length == 0 || room < 2)
     {
-        PRINT_CRITICAL("%d", "numFieldValueFields %d > NVML_FI_MAX", numFields);
-        return DCGM_ST_BADPARAM;
+        matrix->values[cell].i64 = 0; /* The empty string */
+        if (length > 0)
+            matrix->status[cell] |= DCGM_MATRIX_CELL_TRUNCATED;
+        return;
     }
 
-    /* Initialize the values[] array */
-    memset(&values[0], 0, sizeof(values[0]) * numFields);
-    for (i = 0; i < numFields; i++)
+    size_t const copied = std::min(length, room - 1);
+    if (copied < length)
+        matrix->status[cell] |= DCGM_MATRIX_CELL_TRUNCATED;
+    matrix->values[cell].i64 = matrix->stringsSize;
+    memcpy(&matrix->strings[matrix->stringsSize], str, copied);
+    matrix->strings[matrix->stringsSize + copied] = '\0';
+    matrix->stringsSize += copied + 1;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetLatestValuesMatrix(std::vector<dcgmGroupEntityPair_t> const &entities,
+                                                     std::vector<unsigned short> const &fieldIds,
+                                                     dcgmLatestValuesMatrix_v1 *matrix)
+{
+    if (!matrix || entities.size() > DCGM_GROUP_MAX_ENTITIES || fieldIds.size() > DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP)
+        return DCGM_ST_BADPARAM;
+
+    unsigned int const numFields = fieldIds.size();
+    dcgm_field_meta_p fieldMetas[DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP];
+
+    matrix->numEntities = entities.size();
+    matrix->numFields   = numFields;
+    matrix->stringsSize = 1;
+    matrix->strings[0]  = '\0'; /* Blank string cells point here */
+    std::copy(entities.begin(), entities.end(), matrix->entities);
+    std::copy(fieldIds.begin(), fieldIds.end(), matrix->fieldIds);
+
+    for (unsigned int column = 0; column < numFields; column++)
     {
-        values[i].fieldId = fieldMeta[i]->nvmlFieldId;
+        fieldMetas[column]         = DcgmFieldGetById(fieldIds[column]);
+        matrix->fieldTypes[column] = fieldMetas[column] ? fieldMetas[column]->fieldType : DCGM_FT_INT64;
     }
 
-    // Do not attempt to poll NVML for values of detached GPUs
-    if (m_gpus[gpuId].status != DcgmEntityStatusDetached)
+    /* Read the numeric cells lock-free and leave the rest for one locked pass */
+    std::vector<unsigned int> lockedCells;
+    for (unsigned int row = 0; row < matrix->numEntities; row++)
     {
-        /* The fieldId field of fieldValueValues[] was already populated above. Make the NVML call */
-        nvmlReturn = nvmlDeviceGetFieldValues(m_gpus[gpuId].nvmlDevice, numFields, &values[0]);
-        if (nvmlReturn != NVML_SUCCESS)
+        for (unsigned int column = 0; column < numFields; column++)
         {
-            /* Any given field failure will be on a single fieldValueValues[] entry. A global failure is
-             * unexpected */
-            PRINT_ERROR("%d", "Unexpected NVML return %d from nvmlDeviceGetFieldValues", nvmlReturn);
-            return NvmlReturnToDcgmReturn(nvmlReturn);
+            unsigned int const cell           = row * numFields + column;
+            dcgm_field_meta_p const fieldMeta = fieldMetas[column];
+
+            if (!fieldMeta || fieldMeta->fieldType == DCGM_FT_BINARY)
+            {
+                DcgmcmSetMatrixCellBlank(matrix, cell, matrix->fieldTypes[column], DCGM_ST_UNKNOWN_FIELD);
+                continue;
+            }
+
+            dcgm_field_entity_group_t entityGroupId = entities[row].entityGroupId;
+            if (fieldMeta->scope == DCGM_FS_GLOBAL)
+                entityGroupId = DCGM_FE_NONE;
+
+            dcgmcm_sample_t sample;
+            unsigned int const entityId = entities[row].entityId;
+            if (fieldMeta->fieldType == DCGM_FT_STRING
+                || !GetLatestSampleLockFree(entityGroupId, entityId, fieldMeta->fieldId, &sample, nullptr))
+            {
+                lockedCells.push_back(cell);
+                continue;
+            }
+
+            matrix->timestamps[cell] = sample.timestamp;
+            if (fieldMeta->fieldType == DCGM_FT_DOUBLE)
+            {
+                matrix->values[cell].dbl = sample.val.d;
+                matrix->status[cell]     = DCGM_FP64_IS_BLANK(sample.val.d) ? DCGM_MATRIX_CELL_BLANK : 0;
+            }
+            else
+            {
+                matrix->values[cell].i64 = sample.val.i64;
+                matrix->status[cell]     = DCGM_INT64_IS_BLANK(sample.val.i64) ? DCGM_MATRIX_CELL_BLANK : 0;
+            }
         }
     }
 
-    /* Set thread context variables that won't change */
-    threadCtx->entityKey.entityGroupId = DCGM_FE_GPU;
-    threadCtx->entityKey.entityId      = gpuId;
+    if (lockedCells.empty())
+        return DCGM_ST_OK;
 
-    for (i = 0; i < numFields; i++)
+    DcgmLockGuard dlg(m_mutex);
+
+    for (unsigned int cell : lockedCells)
     {
-        fv = &values[i];
+        dcgmGroupEntityPair_t const &entity = matrix->entities[cell / numFields];
+        dcgm_field_meta_p const fieldMeta   = fieldMetas[cell % numFields];
+        dcgmcm_watch_info_p watchInfo;
 
-        /* Set threadCtx variables before we possibly use them */
-        threadCtx->entityKey.fieldId = fieldMeta[i]->fieldId;
-        threadCtx->watchInfo         = watchInfo[i];
+        if (fieldMeta->scope == DCGM_FS_GLOBAL)
+            watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+        else
+            watchInfo = GetEntityWatchInfo(entity.entityGroupId, entity.entityId, fieldMeta->fieldId, 0);
 
-        if (m_gpus[gpuId].status == DcgmEntityStatusDetached)
+        timeseries_entry_p entry = nullptr;
+        dcgmReturn_t st          = PrecheckWatchInfoForSamples(watchInfo);
+        if (st == DCGM_ST_OK)
         {
-            // Detached GPUs get an intentional NVML error and we're done
-            InsertNvmlErrorValue(threadCtx, fieldMeta[i]->fieldType, NVML_ERROR_GPU_IS_LOST, watchInfo[i]->maxAgeUsec);
+            timeseries_cursor_t cursor;
+            entry = timeseries_last(watchInfo->timeSeries, &cursor);
+            if (!entry)
+            {
+                /* Same statuses GetLatestSample() returns for an empty time series */
+                if (watchInfo->lastStatus != NVML_SUCCESS)
+                    st = NvmlReturnToDcgmReturn(watchInfo->lastStatus);
+                else if (!watchInfo->isWatched)
+                    st = DCGM_ST_NOT_WATCHED;
+                else
+                    st = DCGM_ST_NO_DATA;
+            }
+        }
+
+        if (!entry)
+        {
+            DcgmcmSetMatrixCellBlank(matrix, cell, fieldMeta->fieldType, st);
             continue;
         }
 
-        /* We need a timestamp on every FV or we'll just keep saving it over and over */
-        if (!fv->timestamp)
+        switch (watchInfo->timeSeries->tsType)
         {
-            PRINT_DEBUG("%u %u %i", "gpuId %u, fieldId %u, index %d had a null timestamp.", gpuId, fv->fieldId, i);
-            fv->timestamp = timelib_usecSince1970();
+            case TS_TYPE_STRING:
+                DcgmcmSetMatrixCellString(matrix, cell, (char const *)entry->val.ptr, entry->usecSince1970);
+                break;
+            case TS_TYPE_DOUBLE:
+                matrix->values[cell].dbl = entry->val.dbl;
+                matrix->timestamps[cell] = entry->usecSince1970;
+                matrix->status[cell]     = DCGM_FP64_IS_BLANK(entry->val.dbl) ? DCGM_MATRIX_CELL_BLANK : 0;
+                break;
+            case TS_TYPE_INT64:
+                matrix->values[cell].i64 = entry->val.i64;
+                matrix->timestamps[cell] = entry->usecSince1970;
+                matrix->status[cell]     = DCGM_INT64_IS_BLANK(entry->val.i64) ? DCGM_MATRIX_CELL_BLANK : 0;
+                break;
+            default:
+                DcgmcmSetMatrixCellBlank(matrix, cell, fieldMeta->fieldType, DCGM_ST_GENERIC_ERROR);
+                break;
+        }
+    }
 
-            /* WaR for NVML bug 2009232 where fields ECC can be left uninitialized if ECC is disabled */
-
-            if (!fv->latencyUsec
-                && fv->valueType == NVML_VALUE_TYPE_DOUBLE /* 0 */ && fv->fieldId >= NVML_FI_DEV_ECC_CURRENT
-                && fv->fieldId <= NVML_FI_DEV_RETIRED_PENDING)
-            {
-                if (fv->fieldId > NVML_FI_DEV_ECC_PENDING)
-                    fv->nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
-                else
-                {
-                    /* Read current/pending manually so that they have a valid value */
-                    nvmlEnableState_t currentIsEnabled, pendingIsEnabled;
-                    fv->nvmlReturn
-                        = nvmlDeviceGetEccMode(m_gpus[gpuId].nvmlDevice, &currentIsEnabled, &pendingIsEnabled);
-                    fv->valueType = NVML_VALUE_TYPE_UNSIGNED_LONG_LONG;
-                    if (fv->fieldId == NVML_FI_DEV_ECC_CURRENT)
-                        fv->value.ullVal = currentIsEnabled;
-                    else
-                        fv->value.ullVal = pendingIsEnabled;
-                }
-            }
-        }
-
-        /* Expiration is either measured in absolute time or 0 */
-        expireTime = 0;
-        if (watchInfo[i])
-        {
-            if (watchInfo[i]->maxAgeUsec)
-            {
-                expireTime = fv->timestamp - watchInfo[i]->maxAgeUsec;
-            }
-            watchInfo[i]->execTimeUsec += fv->latencyUsec;
-            watchInfo[i]->fetchCount++;
-            watchInfo[i]->lastQueriedUsec = fv->timestamp;
-            watchInfo[i]->lastStatus      = fv->nvmlReturn;
-        }
-
-        /* WAR for NVML Bug 2032468. Force the valueType to unsigned long long for ECC fields, because NVML
-         * isn't setting them and it's defaulting to a double which doesn't get stored properly. */
-        if ((threadCtx->entityKey.fieldId <= DCGM_FI_DEV_ECC_DBE_AGG_TEX)
-            && (threadCtx->entityKey.fieldId >= DCGM_FI_DEV_ECC_CURRENT))
-        {
-            fv->valueType = NVML_VALUE_TYPE_UNSIGNED_LONG_LONG;
-        }
-
-        if (fv->nvmlReturn != NVML_SUCCESS)
-        {
-            /* Store an appropriate error for the destination type */
-            timelib64_t maxAgeUsec = 0;
-            if (watchInfo[i])
-                maxAgeUsec = watchInfo[i]->maxAgeUsec;
-            InsertNvmlErrorValue(threadCtx, fieldMeta[i]->fieldType, fv->nvmlReturn, maxAgeUsec);
-        }
-        else /* NVML_SUCCESS */
-        {
-            PRINT_DEBUG("%d", "fieldId %d got good value", fv->fieldId);
-
-            /* Store an appropriate error for the destination type */
-            switch (fieldMeta[i]->fieldType)
-            {
-                case DCGM_FT_INT64:
-                    AppendEntityInt64(threadCtx, NvmlFieldValueToInt64(fv), 0, (timelib64_t)fv->timestamp, expireTime);
-                    break;
-
-                case DCGM_FT_DOUBLE:
-                    AppendEntityDouble(
-                        threadCtx, NvmlFieldValueToDouble(fv), 0.0, (timelib64_t)fv->timestamp, expireTime);
-                    break;
-
-                default:
-                    PRINT_ERROR("%c", "Unhandled field value output type: %c", fieldMeta[i]->fieldType);
-                    break;
-            }
-        }
-    }
-
-    return DCGM_ST_OK;
-}
+    return DCGM_ST_OK;
+}
 
 /*****************************************************************************/
-void DcgmCacheManager::ClearWatchInfo(dcgmcm_watch_info_p watchInfo, int clearCache)
+dcgmReturn_t DcgmCacheManager::SetValue(int gpuId, unsigned short dcgmFieldId, dcgmcm_sample_p value)
 {
-    if (!watchInfo)
-        return;
+    dcgm_field_meta_p fieldMeta = 0;
+    nvmlReturn_t nvmlReturn;
+    nvmlDevice_t nvmlDevice = 0;
+    timelib64_t now, expireTime;
+    dcgmcm_watch_info_p watchInfo = 0;
+    dcgmcm_update_thread_t updateCtx {};
 
-    watchInfo->watchers.clear();
-    watchInfo->isWatched            = 0;
-    watchInfo->monitorFrequencyUsec = 0;
-    watchInfo->maxAgeUsec           = 0;
-    watchInfo->lastQueriedUsec      = 0;
-    if (watchInfo->timeSeries && clearCache)
-    {
-        timeseries_destroy(watchInfo->timeSeries);
-        watchInfo->timeSeries = 0;
-    }
-}
+    if (!value)
+        return DCGM_ST_BADPARAM;
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::ClearAllEntities(int clearCache)
-{
-    dcgmcm_watch_info_p watchInfo = 0;
-    dcgmMutexReturn_t mutexReturn;
-    int numCleared = 0;
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_UNKNOWN_FIELD;
 
-    mutexReturn = dcgm_mutex_lock_me(m_mutex);
+    ClearThreadCtx(&updateCtx);
+    updateCtx.entityKey.entityGroupId = DCGM_FE_GPU;
+    updateCtx.entityKey.entityId      = gpuId;
+    updateCtx.entityKey.fieldId       = dcgmFieldId;
 
-    /* Walk the watch table and clear every entry */
-    for (void *hashIter = hashtable_iter(m_entityWatchHashTable); hashIter;
-         hashIter       = hashtable_iter_next(m_entityWatchHashTable, hashIter))
+    if (fieldMeta->scope == DCGM_FS_ENTITY)
     {
-        numCleared++;
-        watchInfo = (dcgmcm_watch_info_p)hashtable_iter_value(hashIter);
-        ClearWatchInfo(watchInfo, clearCache);
+        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, GpuIdToNvmlIndex(gpuId), dcgmFieldId, 1);
+    }
+    else
+    {
+        watchInfo = GetGlobalWatchInfo(dcgmFieldId, 1);
     }
 
-    if (mutexReturn == DCGM_MUTEX_ST_OK)
-        dcgm_mutex_unlock(m_mutex);
-
-    PRINT_DEBUG("%d %d", "ClearAllEntities clearCache %d, numCleared %d", clearCache, numCleared);
-
-    return DCGM_ST_OK;
-}
+    now = timelib_usecSince1970();
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::ClearEntity(dcgm_field_entity_group_t entityGroupId,
-                                           dcgm_field_eid_t entityId,
-                                           int clearCache)
-{
-    dcgmcm_watch_info_p watchInfo = 0;
-    dcgmMutexReturn_t mutexReturn;
-    int numMatched = 0;
-    int numScanned = 0;
+    expireTime = 0;
+    if (watchInfo->maxAgeUsec)
+        expireTime = now - watchInfo->maxAgeUsec;
 
-    mutexReturn = dcgm_mutex_lock_me(m_mutex);
+    /* Is the field watched? If so, cause live updates to occur */
+    if (watchInfo->isWatched)
+        updateCtx.watchInfo = watchInfo;
 
-    /* Walk the watch table and clear anything that points at this entityGroup + entityId combo */
-    for (void *hashIter = hashtable_iter(m_entityWatchHashTable); hashIter;
-         hashIter       = hashtable_iter_next(m_entityWatchHashTable, hashIter))
+    /* Do we need a device handle? */
+    if (fieldMeta->scope == DCGM_FS_DEVICE)
     {
-        numScanned++;
-        watchInfo = (dcgmcm_watch_info_p)hashtable_iter_value(hashIter);
-
-        if (watchInfo->watchKey.entityGroupId != entityGroupId || watchInfo->watchKey.entityId != entityId)
+        nvmlReturn = nvmlDeviceGetHandleByIndex_v2(GpuIdToNvmlIndex(gpuId), &nvmlDevice);
+        if (nvmlReturn != NVML_SUCCESS)
         {
-            continue; /* Not a match */
+            PRINT_ERROR("%d %u",
+                        "nvmlDeviceGetHandleByIndex_v2 returned %d for gpuId %u",
+                        (int)nvmlReturn,
+                        GpuIdToNvmlIndex(gpuId));
+            return NvmlReturnToDcgmReturn(nvmlReturn);
         }
-
-        numMatched++;
-        ClearWatchInfo(watchInfo, clearCache);
     }
 
-    if (mutexReturn == DCGM_MUTEX_ST_OK)
-        dcgm_mutex_unlock(m_mutex);
-
-    PRINT_DEBUG("%u %u %d %d %d",
-                "ClearEntity eg %u, eid %u, clearCache %d, "
-                "numScanned %d, numMatched %d",
-                entityGroupId,
-                entityId,
-                clearCache,
-                numScanned,
-                numMatched);
-
-    return DCGM_ST_OK;
-}
-
-/*****************************************************************************/
-void DcgmCacheManager::RunLockStep(dcgmcm_update_thread_t *threadCtx)
-{
-    bool haveLock               = false;
-    unsigned int sleepAtATimeMs = 10000;
-    timelib64_t earliestNextUpdate, lastWakeupTime, now;
-
-    lastWakeupTime = 0;
-
-    while (!ShouldStop())
+    switch (fieldMeta->fieldId)
     {
-        if (!haveLock)
-            dcgm_mutex_lock(m_mutex);
-        haveLock = true;
+        case DCGM_FI_DEV_AUTOBOOST:
+        {
+            nvmlEnableState_t enabledState;
 
-        /* Update runtime stats */
-        m_runStats.numSleepsDone++;
-        m_runStats.lockCount = m_mutex->GetLockCount();
-        m_runStats.sleepTimeUsec += 1000 * ((long long)sleepAtATimeMs);
-        now = timelib_usecSince1970();
-        /* If lastWakeupTime != 0 then we actually work up to do work */
-        if (lastWakeupTime)
-            m_runStats.awakeTimeUsec += now - lastWakeupTime;
+            enabledState = value->val.i64 ? NVML_FEATURE_ENABLED : NVML_FEATURE_DISABLED;
 
-#ifdef DEBUG_UPDATE_LOOP
-        PRINT_DEBUG("%u %lld %lld",
-                    "Waiting on m_startUpdateCondition for %u ms. updateCycleFinished %lld. was awake for %lld usec",
-                    sleepAtATimeMs,
-                    m_runStats.updateCycleFinished,
-                    (long long)now - lastWakeupTime);
-#endif
+            nvmlReturn = nvmlDeviceSetDefaultAutoBoostedClocksEnabled(nvmlDevice, enabledState, 0);
+            if (NVML_SUCCESS != nvmlReturn)
+            {
+                return NvmlReturnToDcgmReturn(nvmlReturn);
+            }
 
-        /* Wait for someone to call UpdateAllFields(). Check if shouldFinishCycle changed before we got the lock.
-         * If so, we need to skip our sleep and do another update cycle */
-        if (m_runStats.updateCycleFinished >= m_runStats.shouldFinishCycle)
-        {
-            m_mutex->CondWait(m_startUpdateCondition, sleepAtATimeMs, [this] {
-                return (m_runStats.updateCycleFinished < m_runStats.shouldFinishCycle) || (ShouldStop() != 0);
-            });
-            if (ShouldStop() != 0)
+            if (watchInfo->isWatched)
             {
-                break;
+                AppendEntityInt64(&updateCtx, value->val.i64, 0, now, expireTime);
             }
-#ifdef DEBUG_UPDATE_LOOP
-            PRINT_DEBUG("%d %lld %lld",
-                        "Woke up to st %d. updateCycleFinished %lld, shouldFinishCycle %lld",
-                        st,
-                        m_runStats.updateCycleFinished,
-                        m_runStats.shouldFinishCycle);
-        }
-        else
-        {
-            PRINT_DEBUG("", "RunLockStep() skipped CondWait()");
-#endif
+            break;
         }
 
-
-        if (m_runStats.updateCycleFinished >= m_runStats.shouldFinishCycle)
+        case DCGM_FI_DEV_ENFORCED_POWER_LIMIT: /* Fall through is intentional */
+        case DCGM_FI_DEV_POWER_MGMT_LIMIT:
         {
-            lastWakeupTime = 0;
-            continue;
-        }
-
-        lastWakeupTime = timelib_usecSince1970();
+            unsigned int currLimit, minLimit, maxLimit, newPowerLimit;
 
-        m_runStats.updateCycleStarted++;
+            newPowerLimit = (unsigned int)(value->val.d * 1000); // convert from W to mW
 
-        /* Leave the mutex locked throughout the update loop. It will be unlocked before any driver calls */
+            nvmlReturn = nvmlDeviceGetPowerManagementLimit(nvmlDevice, &currLimit);
+            if (NVML_SUCCESS != nvmlReturn)
+            {
+                return NvmlReturnToDcgmReturn(nvmlReturn);
+            }
 
-        /* If we haven't allocated fvBuffer yet, do so only if there are any live subscribers */
-        if (!threadCtx->fvBuffer && m_haveAnyLiveSubscribers)
-        {
-            /* Buffer live updates for subscribers */
-            threadCtx->fvBuffer = new DcgmFvBuffer();
-        }
+            nvmlReturn = nvmlDeviceGetPowerManagementLimitConstraints(nvmlDevice, &minLimit, &maxLimit);
+            if (NVML_SUCCESS != nvmlReturn)
+            {
+                return NvmlReturnToDcgmReturn(nvmlReturn);
+            }
 
-        /* Try to update all fields */
-        earliestNextUpdate = 0;
-        ActuallyUpdateAllFields(threadCtx, &earliestNextUpdate);
+            if (newPowerLimit < minLimit || newPowerLimit > maxLimit)
+            {
+                PRINT_WARNING("%u %u %u %u",
+                              "gpuId %u. Power limit %u is outside of range %u < x < %u",
+                              gpuId,
+                              newPowerLimit,
+                              minLimit,
+                              maxLimit);
+                return DCGM_ST_BADPARAM;
+            }
 
-        if (threadCtx->fvBuffer)
-            UpdateFvSubscribers(threadCtx);
+            nvmlReturn = nvmlDeviceSetPowerManagementLimit(nvmlDevice, newPowerLimit);
+            if (NVML_SUCCESS != nvmlReturn)
+            {
+                return NvmlReturnToDcgmReturn(nvmlReturn);
+            }
 
-        m_runStats.updateCycleFinished++;
-#ifdef DEBUG_UPDATE_LOOP
-        PRINT_DEBUG(
-            "%lld", "Setting m_updateCompleteCondition at updateCycleFinished %lld", m_runStats.updateCycleFinished);
-#endif
-        haveLock = false;
-        dcgm_mutex_unlock(m_mutex);
-        /* Let anyone waiting on this update cycle know we're done */
-        m_updateCompleteCondition.notify_all();
-    }
 
-    if (haveLock)
-        dcgm_mutex_unlock(m_mutex);
-}
+            if (watchInfo->isWatched)
+            {
+                AppendEntityDouble(&updateCtx, newPowerLimit / 1000, 0, now, expireTime);
+            }
 
-/*****************************************************************************/
-void DcgmCacheManager::RunTimedWakeup(dcgmcm_update_thread_t *threadCtx)
-{
-    timelib64_t now, maxNextWakeTime, diff, earliestNextUpdate, startOfLoop;
-    timelib64_t wakeTimeInterval = 10000000;
-    unsigned int sleepAtATimeMs  = 1000;
+            break;
+        }
 
-    while (!ShouldStop())
-    {
-        startOfLoop = timelib_usecSince1970();
-        /* Maximum time of 10 second between loops */
-        maxNextWakeTime = startOfLoop + wakeTimeInterval;
+        case DCGM_FI_DEV_APP_SM_CLOCK: // Fall-through is intentional
+        case DCGM_FI_DEV_APP_MEM_CLOCK:
+        {
+            /* Special Handling as two different values are set simultaneously in this case */
+            dcgm_field_meta_p fieldMetaSM    = 0;
+            dcgm_field_meta_p fieldMetaMEM   = 0;
+            dcgmcm_watch_info_p watchInfoSM  = 0;
+            dcgmcm_watch_info_p watchInfoMEM = 0;
 
-        dcgm_mutex_lock(m_mutex);
-        m_runStats.updateCycleStarted++;
 
-        /* If we haven't allocated fvBuffer yet, do so only if there are any live subscribers */
-        if (!threadCtx->fvBuffer && m_haveAnyLiveSubscribers)
-        {
-            /* Buffer live updates for subscribers */
-            threadCtx->fvBuffer = new DcgmFvBuffer();
-        }
+            fieldMetaSM = DcgmFieldGetById(DCGM_FI_DEV_APP_SM_CLOCK);
+            if (!fieldMetaSM)
+                return DCGM_ST_UNKNOWN_FIELD;
 
-        /* Try to update all fields */
-        earliestNextUpdate = 0;
-        ActuallyUpdateAllFields(threadCtx, &earliestNextUpdate);
+            watchInfoSM = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_APP_SM_CLOCK, 1);
 
-        if (threadCtx->fvBuffer)
-            UpdateFvSubscribers(threadCtx);
+            fieldMetaMEM = DcgmFieldGetById(DCGM_FI_DEV_APP_MEM_CLOCK);
+            if (!fieldMetaMEM)
+                return DCGM_ST_UNKNOWN_FIELD;
 
-        m_runStats.updateCycleFinished++;
-        dcgm_mutex_unlock(m_mutex);
-        /* Let anyone waiting on this update cycle know we're done */
-        m_updateCompleteCondition.notify_all();
+            watchInfoMEM = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_APP_MEM_CLOCK, 1);
 
-        /* Resync */
-        now = timelib_usecSince1970();
-        m_runStats.awakeTimeUsec += (now - startOfLoop);
+            /* Both blank means ignore */
+            if (DCGM_INT64_IS_BLANK(value->val.i64) && DCGM_INT64_IS_BLANK(value->val2.i64))
+            {
+                return NvmlReturnToDcgmReturn(NVML_SUCCESS);
+            }
+            else if ((value->val.i64 == 0) && (value->val2.i64 == 0))
+            {
+                /* Both 0s means reset application clocks */
+                nvmlReturn = nvmlDeviceResetApplicationsClocks(nvmlDevice);
+                PRINT_DEBUG("%d", "nvmlDeviceResetApplicationsClocks() returned %d", (int)nvmlReturn);
+                if (NVML_SUCCESS != nvmlReturn)
+                {
+                    return NvmlReturnToDcgmReturn(nvmlReturn);
+                }
+            }
+            else
+            {
+                /* Set Memory clock and Proc clock pair via NVML */
+                nvmlReturn = nvmlDeviceSetApplicationsClocks(nvmlDevice, value->val.i64, value->val2.i64);
+                PRINT_DEBUG("%lld %lld %d",
+                            "nvmlDeviceSetApplicationsClocks(%lld, %lld) returned %d",
+                            value->val.i64,
+                            value->val2.i64,
+                            (int)nvmlReturn);
+                if (NVML_SUCCESS != nvmlReturn)
+                {
+                    return NvmlReturnToDcgmReturn(nvmlReturn);
+                }
+            }
 
-        /* Only bother if we are supposed to sleep for > 100 usec. Sleep takes 60+ usec */
-        /* Are we past our maximum time between loops? */
-        if (now > maxNextWakeTime - 100)
+            if (watchInfoMEM->isWatched)
+            {
+                updateCtx.watchInfo = watchInfoMEM;
+                updateCtx.entityKey = watchInfoMEM->watchKey;
+                AppendEntityInt64(&updateCtx, value->val.i64, 0, now, expireTime);
+            }
+
+            if (watchInfoSM->isWatched)
+            {
+                updateCtx.watchInfo = watchInfoSM;
+                updateCtx.entityKey = watchInfoSM->watchKey;
+                AppendEntityInt64(&updateCtx, value->val2.i64, 0, now, expireTime);
+            }
+
+            break;
+        }
+
+        case DCGM_FI_DEV_ECC_CURRENT: // Fall-through is intentional
+        case DCGM_FI_DEV_ECC_PENDING:
         {
-            // printf("No sleep. now %lld. maxNextWakeTime %lld\n",
-            //       (long long int)diff, (long long int)maxNextWakeTime);
-            m_runStats.numSleepsSkipped++;
-            continue;
+            nvmlEnableState_t nvmlState;
+            nvmlState = (value->val.i64 == true) ? NVML_FEATURE_ENABLED : NVML_FEATURE_DISABLED;
+
+            nvmlReturn = nvmlDeviceSetEccMode(nvmlDevice, nvmlState);
+            if (NVML_SUCCESS != nvmlReturn)
+            {
+                return NvmlReturnToDcgmReturn(nvmlReturn);
+            }
+
+
+            if (watchInfo->isWatched)
+            {
+                AppendEntityInt64(&updateCtx, value->val.i64, 0, now, expireTime);
+            }
+
+            break;
         }
 
-        /* If we need to update something earlier than max time, sleep until we know
-         * we have to update something
-         */
-        diff = maxNextWakeTime - now;
-        if (earliestNextUpdate && earliestNextUpdate < maxNextWakeTime)
-            diff = earliestNextUpdate - now;
 
-        if (diff < 1000)
+        case DCGM_FI_DEV_COMPUTE_MODE:
         {
-            // printf("No sleep. diff %lld\n", (long long int)diff);
-            m_runStats.numSleepsSkipped++;
-            continue;
-        }
+            nvmlComputeMode_t computeMode;
 
-        sleepAtATimeMs = diff / 1000;
-        m_runStats.sleepTimeUsec += diff;
-        m_runStats.lockCount = m_mutex->GetLockCount();
-        m_runStats.numSleepsDone++;
-        // printf("Sleeping for %u\n", sleepAtATimeMs);
+            if (value->val.i64 == DCGM_CONFIG_COMPUTEMODE_DEFAULT)
+                computeMode = NVML_COMPUTEMODE_DEFAULT;
+            else if (value->val.i64 == DCGM_CONFIG_COMPUTEMODE_PROHIBITED)
+                computeMode = NVML_COMPUTEMODE_PROHIBITED;
+            else if (value->val.i64 == DCGM_CONFIG_COMPUTEMODE_EXCLUSIVE_PROCESS)
+                computeMode = NVML_COMPUTEMODE_EXCLUSIVE_PROCESS;
+            else
+                return DCGM_ST_BADPARAM;
 
-        /* Sleep for diff usec. This is an interruptible wait in case someone calls UpdateAllFields() */
-        dcgm_mutex_lock(m_mutex);
-        m_mutex->CondWait(m_startUpdateCondition, sleepAtATimeMs, [this] {
-            return (m_runStats.updateCycleFinished < m_runStats.shouldFinishCycle) || (ShouldStop() != 0);
-        });
-        /* We don't care about st. Either it timed out or we were woken up. Either way, run
-         * another update loop
-         */
-        dcgm_mutex_unlock(m_mutex);
-    }
-}
 
-/*****************************************************************************/
-void DcgmCacheManager::run(void)
-{
-    dcgmcm_update_thread_t *updateThreadCtx;
+            nvmlReturn = nvmlDeviceSetComputeMode(nvmlDevice, computeMode);
+            if (NVML_SUCCESS != nvmlReturn)
+            {
+                return NvmlReturnToDcgmReturn(nvmlReturn);
+            }
 
-    updateThreadCtx = (dcgmcm_update_thread_t *)malloc(sizeof(*updateThreadCtx));
-    if (!updateThreadCtx)
-    {
-        PRINT_ERROR("", "Unable to alloc updateThreadCtx. Exiting update thread");
-        return;
-    }
-    memset(updateThreadCtx, 0, sizeof(*updateThreadCtx));
+            if (watchInfo->isWatched)
+            {
+                AppendEntityInt64(&updateCtx, value->val.i64, 0, now, expireTime);
+            }
 
-    PRINT_INFO("", "Cache manager update thread starting");
+            break;
+        }
 
-    if (m_pollInLockStep)
-        RunLockStep(updateThreadCtx);
-    else
-        RunTimedWakeup(updateThreadCtx);
+        default:
+            PRINT_WARNING("%d", "Unimplemented fieldId: %d", (int)fieldMeta->fieldId);
+            return DCGM_ST_GENERIC_ERROR;
+    }
 
-    FreeThreadCtx(updateThreadCtx);
-    free(updateThreadCtx);
 
-    PRINT_INFO("", "Cache manager update thread ending");
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetCacheManagerFieldInfo(dcgmCacheManagerFieldInfo_t *fieldInfo)
+static bool IsSameWatch(dcgmBufferedFv_t const *a, dcgmBufferedFv_t const *b)
 {
-    dcgmcm_watch_info_p watchInfo = 0;
-    dcgm_field_meta_p fieldMeta   = 0;
-    timeseries_p timeseries       = 0;
+    return a->entityGroupId == b->entityGroupId && a->entityId == b->entityId && a->fieldId == b->fieldId;
+}
 
-    if (!fieldInfo)
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AppendSamples(DcgmFvBuffer *fvBuffer)
+{
+    if (!fvBuffer)
         return DCGM_ST_BADPARAM;
 
-    if (fieldInfo->version != dcgmCacheManagerFieldInfo_version)
-    {
-        PRINT_ERROR("%d %d",
-                    "Got GetCacheManagerFieldInfo ver %d != expected %d",
-                    (int)fieldInfo->version,
-                    (int)dcgmCacheManagerFieldInfo_version);
-        return DCGM_ST_VER_MISMATCH;
-    }
+    /* Modules publish a pass at a time, so each watch's samples are spread through the buffer.
+       Group them into runs per watch, keeping the order within each watch, so that each watch is
+       looked up and has its quota enforced once per run rather than once per sample */
+    size_t bufferSize = 0;
+    size_t numFvs     = 0;
+    fvBuffer->GetSize(&bufferSize, &numFvs);
 
-    fieldMeta = DcgmFieldGetById(fieldInfo->fieldId);
-    if (!fieldMeta)
+    std::vector<dcgmBufferedFv_t *> fvs;
+    fvs.reserve(numFvs);
+    for (dcgmBufferedFv_t &fv : *fvBuffer)
     {
-        PRINT_ERROR("%u", "Invalid fieldId %u passed to GetCacheManagerFieldInfo", (unsigned int)fieldInfo->fieldId);
-        return DCGM_ST_BADPARAM;
+        fvs.push_back(&fv);
     }
 
+    std::stable_sort(fvs.begin(), fvs.end(), [](dcgmBufferedFv_t const *a, dcgmBufferedFv_t const *b) {
+        return std::tie(a->entityGroupId, a->entityId, a->fieldId)
+               < std::tie(b->entityGroupId, b->entityId, b->fieldId);
+    });
 
-    if (fieldMeta->scope == DCGM_FS_ENTITY)
+    dcgmcm_update_thread_t threadCtx;
+    InitAndClearThreadCtx(&threadCtx);
+
+    /* Lock the mutex for every FV so we only take it once */
+    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock(m_mutex);
+
+    timelib64_t now = timelib_usecSince1970();
+
+    size_t runEnd;
+    for (size_t runStart = 0; runStart < fvs.size(); runStart = runEnd)
     {
-        if (fieldInfo->gpuId >= m_numGpus)
+        dcgmBufferedFv_t *first = fvs[runStart];
+        for (runEnd = runStart + 1; runEnd < fvs.size() && IsSameWatch(fvs[runEnd], first); runEnd++)
+            ;
+
+        dcgm_field_meta_t *fieldMeta = DcgmFieldGetById(first->fieldId);
+        if (!fieldMeta)
         {
-            PRINT_ERROR("%u", "Invalid gpuId %u passed to GetCacheManagerFieldInfo", fieldInfo->gpuId);
-            return DCGM_ST_BADPARAM;
+            PRINT_ERROR("%u", "Unknown fieldId %u in fvBuffer", first->fieldId);
+            continue;
         }
 
-        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, fieldInfo->gpuId, fieldMeta->fieldId, 0);
-    }
-    else
-    {
-        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
-    }
-    if (!watchInfo)
-    {
-        PRINT_DEBUG("", "not watched.");
-        return DCGM_ST_NOT_WATCHED;
-    }
-
-    dcgm_mutex_lock(m_mutex);
-    /* UNLOCK AFTER HERE */
-
-    /* Populate the fields we can */
-    fieldInfo->flags = 0;
-    if (watchInfo->isWatched)
-        fieldInfo->flags |= DCGM_CMI_F_WATCHED;
-
-    fieldInfo->version              = dcgmCacheManagerFieldInfo_version;
-    fieldInfo->lastStatus           = (short)watchInfo->lastStatus;
-    fieldInfo->maxAgeUsec           = watchInfo->maxAgeUsec;
-    fieldInfo->monitorFrequencyUsec = watchInfo->monitorFrequencyUsec;
-    fieldInfo->fetchCount           = watchInfo->fetchCount;
-    fieldInfo->execTimeUsec         = watchInfo->execTimeUsec;
-
-    fieldInfo->numWatchers = 0;
-    std::vector<dcgm_watch_watcher_info_t>::iterator it;
-    for (it = watchInfo->watchers.begin();
-         it != watchInfo->watchers.end() && fieldInfo->numWatchers < DCGM_CM_FIELD_INFO_NUM_WATCHERS;
-         ++it)
-    {
-        dcgm_cm_field_info_watcher_t *watcher = &fieldInfo->watchers[fieldInfo->numWatchers];
-        watcher->watcherType                  = it->watcher.watcherType;
-        watcher->connectionId                 = it->watcher.connectionId;
-        watcher->monitorFrequencyUsec         = it->monitorFrequencyUsec;
-        watcher->maxAgeUsec                   = it->maxAgeUsec;
-        fieldInfo->numWatchers++;
-    }
-
-    if (!watchInfo->timeSeries)
-    {
-        /* No values yet */
-        dcgm_mutex_unlock(m_mutex);
-        fieldInfo->newestTimestamp = 0;
-        fieldInfo->oldestTimestamp = 0;
-        fieldInfo->numSamples      = 0;
-        return DCGM_ST_OK;
-    }
-
-    timeseries = watchInfo->timeSeries;
-    kv_cursor_t cursor;
-    timeseries_entry_p entry = 0;
-
-    fieldInfo->numSamples = keyedvector_size(timeseries->keyedVector);
-    if (!fieldInfo->numSamples)
-    {
-        /* No values yet */
-        dcgm_mutex_unlock(m_mutex);
-        fieldInfo->newestTimestamp = 0;
-        fieldInfo->oldestTimestamp = 0;
-        return DCGM_ST_OK;
-    }
-
-    /* Get the first and last records to get their timestamps */
-    entry                      = (timeseries_entry_p)keyedvector_first(timeseries->keyedVector, &cursor);
-    fieldInfo->oldestTimestamp = entry == nullptr ? 0 : entry->usecSince1970;
-    entry                      = (timeseries_entry_p)keyedvector_last(timeseries->keyedVector, &cursor);
-    fieldInfo->newestTimestamp = entry->usecSince1970;
-
-    dcgm_mutex_unlock(m_mutex);
-    return DCGM_ST_OK;
-}
+        dcgmcm_watch_info_t *watchInfo;
+        if (fieldMeta->scope == DCGM_FS_GLOBAL)
+            watchInfo = GetGlobalWatchInfo(first->fieldId, 1);
+        else
+        {
+            watchInfo = GetEntityWatchInfo(
+                (dcgm_field_entity_group_t)first->entityGroupId, first->entityId, first->fieldId, 1);
+        }
 
-/*****************************************************************************/
-void DcgmCacheManager::MarkSubscribersInThreadCtx(dcgmcm_update_thread_t *threadCtx, dcgmcm_watch_info_p watchInfo)
-{
-    if (!threadCtx || !watchInfo)
-        return;
+        if (!watchInfo)
+        {
+            PRINT_ERROR("%u", "Unable to get the watch info of fieldId %u", first->fieldId);
+            continue;
+        }
 
-    /* Fast path exit if there are no subscribers */
-    if (!watchInfo->hasSubscribedWatchers)
-        return;
+        timelib64_t expireTime = 0;
+        if (watchInfo->maxAgeUsec)
+            expireTime = now - watchInfo->maxAgeUsec;
 
-    std::vector<dcgm_watch_watcher_info_t>::iterator it;
+        threadCtx.watchInfo           = watchInfo;
+        threadCtx.entityKey           = watchInfo->watchKey;
+        threadCtx.deferQuotaWatchInfo = watchInfo;
 
-    for (it = watchInfo->watchers.begin(); it != watchInfo->watchers.end(); ++it)
-    {
-        if (!it->isSubscribed)
-            continue;
+        timelib64_t newestTimestamp = 0;
 
-        threadCtx->affectedSubscribers |= 1 << it->watcher.watcherType;
+        for (size_t i = runStart; i < runEnd; i++)
+        {
+            dcgmBufferedFv_t *fv = fvs[i];
+            newestTimestamp      = std::max(newestTimestamp, (timelib64_t)fv->timestamp);
 
-        PRINT_DEBUG("%u %u %u %u",
-                    "watcherType %u has a subscribed update to eg %u, eid %u, fieldId %u",
-                    it->watcher.watcherType,
-                    watchInfo->watchKey.entityGroupId,
-                    watchInfo->watchKey.entityId,
-                    watchInfo->watchKey.fieldId);
-    }
-}
+            switch (fv->fieldType)
+            {
+                case DCGM_FT_DOUBLE:
+                    AppendEntityDouble(&threadCtx, fv->value.dbl, 0.0, fv->timestamp, expireTime);
+                    break;
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AppendEntityDouble(dcgmcm_update_thread_t *threadCtx,
-                                                  double value1,
-                                                  double value2,
-                                                  timelib64_t timestamp,
-                                                  timelib64_t oldestKeepTimestamp)
-{
-    dcgmReturn_t dcgmReturn;
-    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+                case DCGM_FT_INT64:
+                    AppendEntityInt64(&threadCtx, fv->value.i64, 0, fv->timestamp, expireTime);
+                    break;
 
-    if (threadCtx->fvBuffer)
-    {
-        threadCtx->fvBuffer->AddDoubleValue((dcgm_field_entity_group_t)threadCtx->entityKey.entityGroupId,
-                                            threadCtx->entityKey.entityId,
-                                            threadCtx->entityKey.fieldId,
-                                            value1,
-                                            timestamp,
-                                            DCGM_ST_OK);
-        MarkSubscribersInThreadCtx(threadCtx, watchInfo);
-    }
+                case DCGM_FT_STRING:
+                    AppendEntityString(&threadCtx, fv->value.str, fv->timestamp, expireTime);
+                    break;
 
-    /* Should we cache the value? */
-    if (watchInfo)
-    {
-        dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+                case DCGM_FT_BINARY:
+                {
+                    size_t valueSize = (size_t)fv->length - (sizeof(*fv) - sizeof(fv->value));
+                    AppendEntityBlob(&threadCtx, fv->value.blob, valueSize, fv->timestamp, expireTime);
+                    break;
+                }
 
-        if (!watchInfo->timeSeries)
-        {
-            dcgmReturn = AllocWatchInfoTimeSeries(watchInfo, TS_TYPE_DOUBLE);
-            if (dcgmReturn != DCGM_ST_OK)
-            {
-                /* Already logged by AllocWatchInfoTimeSeries. Return the error */
-                dcgm_mutex_unlock(m_mutex);
-                return dcgmReturn;
+                default:
+                    PRINT_ERROR("%u", "Unknown field type: %u", fv->fieldType);
+                    break;
             }
         }
 
-        timeseries_insert_double_coerce(watchInfo->timeSeries, timestamp, value1, value2);
-        EnforceWatchInfoQuota(watchInfo, timestamp, oldestKeepTimestamp);
-
-        if (mutexSt == DCGM_MUTEX_ST_OK)
-            dcgm_mutex_unlock(m_mutex);
+        threadCtx.deferQuotaWatchInfo = 0;
+        EnforceWatchInfoQuota(watchInfo, newestTimestamp, expireTime);
     }
 
-    PRINT_DEBUG(
-        "%u %u %u %lld %f %f %d %d",
-        "Appended entity double eg %u, eid %u, fieldId %u, ts %lld, value1 %f, value2 %f, cached %d, buffered %d",
-        threadCtx->entityKey.entityGroupId,
-        threadCtx->entityKey.entityId,
-        threadCtx->entityKey.fieldId,
-        (long long)timestamp,
-        value1,
-        value2,
-        watchInfo ? 1 : 0,
-        threadCtx->fvBuffer ? 1 : 0);
+    if (!threadCtx.derivedWatches.empty())
+        AppendDerivedFields(&threadCtx);
+
+    if (mutexSt == DCGM_MUTEX_ST_OK)
+        dcgm_mutex_unlock(m_mutex);
+
     return DCGM_ST_OK;
 }
 
+
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AllocWatchInfoTimeSeries(dcgmcm_watch_info_p watchInfo, int tsType)
+dcgmReturn_t DcgmCacheManager::AppendSamples(dcgm_field_entity_group_t entityGroupId,
+                                             dcgm_field_eid_t entityId,
+                                             unsigned short dcgmFieldId,
+                                             dcgmcm_sample_p samples,
+                                             int Nsamples)
 {
-    if (watchInfo->timeSeries)
-        return DCGM_ST_OK; /* Already alloc'd */
-
-    int errorSt           = 0;
-    watchInfo->timeSeries = timeseries_alloc(tsType, &errorSt);
-    if (!watchInfo->timeSeries)
-    {
-        PRINT_ERROR("%d %d", "timeseries_alloc(tsType=%d) failed with %d", tsType, errorSt);
-        return DCGM_ST_MEMORY; /* Assuming it's a memory alloc error */
-    }
-
-    return DCGM_ST_OK;
+    return InjectSamples(entityGroupId, entityId, dcgmFieldId, samples, Nsamples);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::EnforceWatchInfoQuota(dcgmcm_watch_info_p watchInfo,
-                                                     timelib64_t timestamp,
-                                                     timelib64_t oldestKeepTimestamp)
+dcgmReturn_t DcgmCacheManager::InjectSamples(dcgm_field_entity_group_t entityGroupId,
+                                             dcgm_field_eid_t entityId,
+                                             unsigned short dcgmFieldId,
+                                             dcgmcm_sample_p samples,
+                                             int Nsamples)
 {
-    if (!watchInfo || !watchInfo->timeSeries)
-        return DCGM_ST_OK; /* Nothing to do */
+    dcgm_field_meta_p fieldMeta = 0;
+    int sampleIndex;
+    dcgmcm_sample_p currentSample = 0;
+    dcgmcm_watch_info_p watchInfo = 0;
+    timelib64_t now;
+    timelib64_t expireTime;
+    dcgmReturn_t retVal = DCGM_ST_OK;
 
-    /* Passing count quota as 0 since we enforce quota by time alone */
-    int st = timeseries_enforce_quota(watchInfo->timeSeries, oldestKeepTimestamp, 0);
-    if (st)
-    {
-        PRINT_ERROR("%d", "timeseries_enforce_quota returned %d", st);
-        return DCGM_ST_GENERIC_ERROR;
-    }
+    dcgmcm_update_thread_t threadCtx;
+    InitAndClearThreadCtx(&threadCtx);
+    threadCtx.fvBuffer = 0;
 
-    return DCGM_ST_OK;
-}
+    if (!dcgmFieldId || !samples || Nsamples < 1)
+        return DCGM_ST_BADPARAM;
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AppendEntityInt64(dcgmcm_update_thread_t *threadCtx,
-                                                 long long value1,
-                                                 long long value2,
-                                                 timelib64_t timestamp,
-                                                 timelib64_t oldestKeepTimestamp)
-{
-    dcgmReturn_t dcgmReturn;
-    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_GENERIC_ERROR;
 
-    if (threadCtx->fvBuffer)
+    if (fieldMeta->scope == DCGM_FS_GLOBAL)
+    {
+        watchInfo = GetGlobalWatchInfo(dcgmFieldId, 1);
+    }
+    else
     {
-        threadCtx->fvBuffer->AddInt64Value((dcgm_field_entity_group_t)threadCtx->entityKey.entityGroupId,
-                                           threadCtx->entityKey.entityId,
-                                           threadCtx->entityKey.fieldId,
-                                           value1,
-                                           timestamp,
-                                           DCGM_ST_OK);
-        MarkSubscribersInThreadCtx(threadCtx, watchInfo);
+        watchInfo = GetEntityWatchInfo(entityGroupId, entityId, dcgmFieldId, 1);
     }
 
-    if (watchInfo)
+    if (!watchInfo)
     {
-        dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+        PRINT_DEBUG(
+            "%u %u %u", "InjectSamples eg %u, eid %u, fieldId %u got NULL", entityGroupId, entityId, dcgmFieldId);
+        return DCGM_ST_MEMORY;
+    }
 
-        if (!watchInfo->timeSeries)
-        {
-            dcgmReturn = AllocWatchInfoTimeSeries(watchInfo, TS_TYPE_INT64);
-            if (dcgmReturn != DCGM_ST_OK)
-            {
-                /* Already logged by AllocWatchInfoTimeSeries. Return the error */
-                dcgm_mutex_unlock(m_mutex);
-                return dcgmReturn;
-            }
-        }
+    /* If anyone is watching this watchInfo, we need to buffer the
+       values for the resulting notifcations */
+    if (watchInfo->hasSubscribedWatchers)
+        threadCtx.bufferForSubscribers = 1;
 
-        timeseries_insert_int64_coerce(watchInfo->timeSeries, timestamp, value1, value2);
-        EnforceWatchInfoQuota(watchInfo, timestamp, oldestKeepTimestamp);
+    threadCtx.watchInfo               = watchInfo;
+    threadCtx.entityKey.entityGroupId = entityGroupId;
+    threadCtx.entityKey.entityId      = entityId;
+    threadCtx.entityKey.fieldId       = fieldMeta->fieldId;
 
-        if (mutexSt == DCGM_MUTEX_ST_OK)
-            dcgm_mutex_unlock(m_mutex);
-    }
+    now        = timelib_usecSince1970();
+    expireTime = 0;
+    if (watchInfo->maxAgeUsec)
+        expireTime = now - watchInfo->maxAgeUsec;
+    /* Update the last queried timestamp to now so that a watch on this field doesn't
+       update every single cycle. After all, we are injecting values. If the injected value
+       is in the future, then this field won't update live until after the injected timestamp
+       Note that we are also updating lastQueriedUsec in the loop below to achieve this. */
+    watchInfo->lastQueriedUsec = now;
 
-    PRINT_DEBUG(
-        "%u %u %u %lld %lld %lld %d %d",
-        "Appended entity i64 eg %u, eid %u, fieldId %u, ts %lld, value1 %lld, value2 %lld, cached %d, buffered %d",
-        threadCtx->entityKey.entityGroupId,
-        threadCtx->entityKey.entityId,
-        threadCtx->entityKey.fieldId,
-        (long long)timestamp,
-        value1,
-        value2,
-        watchInfo ? 1 : 0,
-        threadCtx->fvBuffer ? 1 : 0);
-    return DCGM_ST_OK;
-}
-
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AppendEntityString(dcgmcm_update_thread_t *threadCtx,
-                                                  char *value,
-                                                  timelib64_t timestamp,
-                                                  timelib64_t oldestKeepTimestamp)
-{
-    dcgmReturn_t dcgmReturn;
-    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
-
-    if (threadCtx->fvBuffer)
+    /* A future optimization would be to Lock() + Unlock() around this loop
+     * and inject all samples at once This is fine for now
+     */
+    for (sampleIndex = 0; sampleIndex < Nsamples; sampleIndex++)
     {
-        threadCtx->fvBuffer->AddStringValue((dcgm_field_entity_group_t)threadCtx->entityKey.entityGroupId,
-                                            threadCtx->entityKey.entityId,
-                                            threadCtx->entityKey.fieldId,
-                                            value,
-                                            timestamp,
-                                            DCGM_ST_OK);
-        MarkSubscribersInThreadCtx(threadCtx, watchInfo);
-    }
+        currentSample = &samples[sampleIndex];
 
-    if (watchInfo)
-    {
-        dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+        /* Use the latest timestamp of the injected samples as the last queried time */
+        watchInfo->lastQueriedUsec = DCGM_MAX(now, currentSample->timestamp);
 
-        if (!watchInfo->timeSeries)
+        switch (fieldMeta->fieldType)
         {
-            dcgmReturn = AllocWatchInfoTimeSeries(watchInfo, TS_TYPE_STRING);
-            if (dcgmReturn != DCGM_ST_OK)
-            {
-                /* Already logged by AllocWatchInfoTimeSeries. Return the error */
-                dcgm_mutex_unlock(m_mutex);
-                return dcgmReturn;
-            }
-        }
-
-        timeseries_insert_string(watchInfo->timeSeries, timestamp, value);
-        EnforceWatchInfoQuota(watchInfo, timestamp, oldestKeepTimestamp);
+            case DCGM_FT_DOUBLE:
+                AppendEntityDouble(
+                    &threadCtx, currentSample->val.d, currentSample->val2.d, currentSample->timestamp, expireTime);
+                break;
 
-        if (mutexSt == DCGM_MUTEX_ST_OK)
-            dcgm_mutex_unlock(m_mutex);
-    }
+            case DCGM_FT_INT64:
+                AppendEntityInt64(
+                    &threadCtx, currentSample->val.i64, currentSample->val2.i64, currentSample->timestamp, expireTime);
+                break;
 
-    PRINT_DEBUG("%u %u %u %lld %s %d %d",
-                "Appended entity string eg %u, eid %u, fieldId %u, ts %lld, value \"%s\", cached %d, buffered %d",
-                threadCtx->entityKey.entityGroupId,
-                threadCtx->entityKey.entityId,
-                threadCtx->entityKey.fieldId,
-                (long long)timestamp,
-                value,
-                watchInfo ? 1 : 0,
-                threadCtx->fvBuffer ? 1 : 0);
-    return DCGM_ST_OK;
-}
+            case DCGM_FT_STRING:
+                if (!currentSample->val.str)
+                {
+                    PRINT_ERROR("%d", "InjectSamples: Null string at index %d of samples", sampleIndex);
+                    /* Our injected samples before this one will still be in the data
+                     * cache. We can't do anything about this if their timestamp field
+                     * was 0 since it will assign a timestamp we won't know
+                     */
+                    return DCGM_ST_BADPARAM;
+                }
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::AppendEntityBlob(dcgmcm_update_thread_t *threadCtx,
-                                                void *value,
-                                                int valueSize,
-                                                timelib64_t timestamp,
-                                                timelib64_t oldestKeepTimestamp)
-{
-    dcgmReturn_t dcgmReturn;
-    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+                AppendEntityString(&threadCtx, currentSample->val.str, currentSample->timestamp, expireTime);
+                break;
 
-    if (threadCtx->fvBuffer)
-    {
-        threadCtx->fvBuffer->AddBlobValue((dcgm_field_entity_group_t)threadCtx->entityKey.entityGroupId,
-                                          threadCtx->entityKey.entityId,
-                                          threadCtx->entityKey.fieldId,
-                                          value,
-                                          valueSize,
-                                          timestamp,
-                                          DCGM_ST_OK);
-        MarkSubscribersInThreadCtx(threadCtx, watchInfo);
-    }
+            case DCGM_FT_BINARY:
+                if (!currentSample->val.blob)
+                {
+                    PRINT_ERROR("%d", "InjectSamples: Null blob at index %d of samples", sampleIndex);
+                    /* Our injected samples before this one will still be in the data
+                     * cache. We can't do anything about this if their timestamp field
+                     * was 0 since it will assign a timestamp we won't know
+                     */
+                    return DCGM_ST_BADPARAM;
+                }
 
-    if (watchInfo)
-    {
-        dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+                AppendEntityBlob(&threadCtx,
+                                 currentSample->val.blob,
+                                 currentSample->val2.ptrSize,
+                                 currentSample->timestamp,
+                                 expireTime);
+                break;
 
-        if (!watchInfo->timeSeries)
-        {
-            dcgmReturn = AllocWatchInfoTimeSeries(watchInfo, TS_TYPE_BLOB);
-            if (dcgmReturn != DCGM_ST_OK)
-            {
-                /* Already logged by AllocWatchInfoTimeSeries. Return the error */
-                dcgm_mutex_unlock(m_mutex);
-                return dcgmReturn;
-            }
+            default:
+                PRINT_ERROR("%c", "InjectSamples: Unhandled field type: %c", fieldMeta->fieldType);
+                return DCGM_ST_BADPARAM;
         }
+    }
 
-        timeseries_insert_blob(watchInfo->timeSeries, timestamp, value, valueSize);
-        EnforceWatchInfoQuota(watchInfo, timestamp, oldestKeepTimestamp);
+    /* Broadcast any accumulated notifications */
+    UpdateFvSubscribers(&threadCtx);
 
-        if (mutexSt == DCGM_MUTEX_ST_OK)
-            dcgm_mutex_unlock(m_mutex);
-    }
+    FreeThreadCtx(&threadCtx);
 
-    PRINT_DEBUG("%u %u %u %lld %d %d %d",
-                "Appended entity blob eg %u, eid %u, fieldId %u, ts %lld, valueSize %d, cached %d, buffered %d",
-                threadCtx->entityKey.entityGroupId,
-                threadCtx->entityKey.entityId,
-                threadCtx->entityKey.fieldId,
-                (long long)timestamp,
-                valueSize,
-                watchInfo ? 1 : 0,
-                threadCtx->fvBuffer ? 1 : 0);
-    return DCGM_ST_OK;
+    return retVal;
 }
 
 /*****************************************************************************/
-char *DcgmCacheManager::NvmlErrorToStringValue(nvmlReturn_t nvmlReturn)
+/* Is fv a whole value of its field's type that can be injected? */
+static bool IsInjectableFv(dcgmBufferedFv_t const &fv, dcgm_field_meta_p fieldMeta)
 {
-    switch (nvmlReturn)
-    {
-        case NVML_SUCCESS:
-            DCGM_LOG_ERROR << "Called with successful code";
-            break;
+    size_t const valueSize = fv.length - std::min<size_t>(fv.length, offsetof(dcgmBufferedFv_t, value));
 
-        case NVML_ERROR_NOT_SUPPORTED:
-            return (char *)DCGM_STR_NOT_SUPPORTED;
+    if (fv.fieldType != fieldMeta->fieldType)
+        return false;
+    if (fieldMeta->scope != DCGM_FS_GLOBAL && fv.entityGroupId >= DCGM_FE_COUNT)
+        return false;
 
-        case NVML_ERROR_NO_PERMISSION:
-            return (char *)DCGM_STR_NOT_PERMISSIONED;
+    switch (fv.fieldType)
+    {
+        case DCGM_FT_DOUBLE:
+        case DCGM_FT_INT64:
+            return valueSize >= sizeof(fv.value.i64);
 
-        case NVML_ERROR_NOT_FOUND:
-            return (char *)DCGM_STR_NOT_FOUND;
+        case DCGM_FT_STRING:
+            return memchr(fv.value.str, '\0', std::min(valueSize, sizeof(fv.value.str))) != nullptr;
+
+        case DCGM_FT_BINARY:
+            return valueSize > 0 && valueSize <= sizeof(fv.value.blob);
 
         default:
-            return (char *)DCGM_STR_BLANK;
+            return false;
     }
-
-    return (char *)DCGM_STR_BLANK;
 }
 
 /*****************************************************************************/
-long long DcgmCacheManager::NvmlErrorToInt64Value(nvmlReturn_t nvmlReturn)
+dcgmReturn_t DcgmCacheManager::InjectSamples(DcgmFvBuffer *fvBuffer)
 {
-    switch (nvmlReturn)
-    {
-        case NVML_SUCCESS:
-            DCGM_LOG_ERROR << "Called with successful code";
-            break;
-
-        case NVML_ERROR_NOT_SUPPORTED:
-            return DCGM_INT64_NOT_SUPPORTED;
+    if (!fvBuffer)
+        return DCGM_ST_BADPARAM;
 
-        case NVML_ERROR_NO_PERMISSION:
-            return DCGM_INT64_NOT_PERMISSIONED;
+    /* Check the whole buffer first so that a bad value doesn't leave the ones before it injected */
+    for (dcgmBufferedFv_t const &fv : *fvBuffer)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fv.fieldId);
+        if (!fieldMeta || !IsInjectableFv(fv, fieldMeta))
+        {
+            DCGM_LOG_ERROR << "Can't inject fieldType " << (int)fv.fieldType << " length " << fv.length
+                           << " for eg " << (int)fv.entityGroupId << ", eid " << fv.entityId << ", fieldId "
+                           << fv.fieldId;
+            return DCGM_ST_BADPARAM;
+        }
+    }
 
-        case NVML_ERROR_NOT_FOUND:
-            return DCGM_INT64_NOT_FOUND;
+    dcgmcm_update_thread_t threadCtx;
+    InitAndClearThreadCtx(&threadCtx);
+    threadCtx.bufferForSubscribers = 1;
 
-        default:
-            return DCGM_INT64_BLANK;
-    }
+    dcgmReturn_t retVal       = DCGM_ST_OK;
+    timelib64_t now           = timelib_usecSince1970();
+    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock(m_mutex);
 
-    return DCGM_INT64_BLANK;
-}
+    dcgmBufferedFv_t *fv;
+    dcgmBufferedFvCursor_t cursor = 0;
 
-/*****************************************************************************/
-int DcgmCacheManager::NvmlErrorToInt32Value(nvmlReturn_t nvmlReturn)
-{
-    switch (nvmlReturn)
+    for (fv = fvBuffer->GetNextFv(&cursor); fv; fv = fvBuffer->GetNextFv(&cursor))
     {
-        case NVML_SUCCESS:
-            DCGM_LOG_ERROR << "Called with successful code";
+        dcgmcm_watch_info_p watchInfo;
+        if (DcgmFieldGetById(fv->fieldId)->scope == DCGM_FS_GLOBAL)
+            watchInfo = GetGlobalWatchInfo(fv->fieldId, 1);
+        else
+            watchInfo = GetEntityWatchInfo((dcgm_field_entity_group_t)fv->entityGroupId, fv->entityId, fv->fieldId, 1);
+
+        if (!watchInfo)
+        {
+            DCGM_LOG_ERROR << "Got a NULL watchInfo for eg " << (int)fv->entityGroupId << ", eid " << fv->entityId
+                           << ", fieldId " << fv->fieldId;
+            retVal = DCGM_ST_MEMORY;
             break;
+        }
 
-        case NVML_ERROR_NOT_SUPPORTED:
-            return DCGM_INT32_NOT_SUPPORTED;
+        timelib64_t expireTime = 0;
+        if (watchInfo->maxAgeUsec)
+            expireTime = now - watchInfo->maxAgeUsec;
 
-        case NVML_ERROR_NO_PERMISSION:
-            return DCGM_INT32_NOT_PERMISSIONED;
+        /* Keep a watch on this field from overwriting the injected values. See InjectSamples() above */
+        watchInfo->lastQueriedUsec = DCGM_MAX(watchInfo->lastQueriedUsec, DCGM_MAX(now, fv->timestamp));
 
-        case NVML_ERROR_NOT_FOUND:
-            return DCGM_INT32_NOT_FOUND;
+        threadCtx.watchInfo = watchInfo;
+        threadCtx.entityKey = watchInfo->watchKey;
 
-        default:
-            return DCGM_INT32_BLANK;
+        switch (fv->fieldType)
+        {
+            case DCGM_FT_DOUBLE:
+                AppendEntityDouble(&threadCtx, fv->value.dbl, 0.0, fv->timestamp, expireTime);
+                break;
+
+            case DCGM_FT_INT64:
+                AppendEntityInt64(&threadCtx, fv->value.i64, 0, fv->timestamp, expireTime);
+                break;
+
+            case DCGM_FT_STRING:
+                AppendEntityString(&threadCtx, fv->value.str, fv->timestamp, expireTime);
+                break;
+
+            case DCGM_FT_BINARY:
+                AppendEntityBlob(&threadCtx,
+                                 fv->value.blob,
+                                 (int)(fv->length - offsetof(dcgmBufferedFv_t, value)),
+                                 fv->timestamp,
+                                 expireTime);
+                break;
+        }
     }
 
-    return DCGM_INT32_BLANK;
+    if (mutexSt == DCGM_MUTEX_ST_OK)
+        dcgm_mutex_unlock(m_mutex);
+
+    /* Broadcast any accumulated notifications */
+    UpdateFvSubscribers(&threadCtx);
+
+    FreeThreadCtx(&threadCtx);
+
+    return retVal;
 }
 
 /*****************************************************************************/
-double DcgmCacheManager::NvmlErrorToDoubleValue(nvmlReturn_t nvmlReturn)
+dcgmReturn_t DcgmCacheManager::FreeSamples(dcgmcm_sample_p samples, int Nsamples, unsigned short dcgmFieldId)
 {
-    switch (nvmlReturn)
-    {
-        case NVML_SUCCESS:
-            DCGM_LOG_ERROR << "Called with successful code";
-            break;
+    dcgm_field_meta_p fieldMeta = 0;
+    int sampleIndex;
+    dcgmcm_sample_p currentSample = 0;
 
-        case NVML_ERROR_NOT_SUPPORTED:
-            return DCGM_FP64_NOT_SUPPORTED;
-
-        case NVML_ERROR_NO_PERMISSION:
-            return DCGM_FP64_NOT_PERMISSIONED;
+    if (!dcgmFieldId || !samples || Nsamples < 1)
+        return DCGM_ST_BADPARAM;
 
-        case NVML_ERROR_NOT_FOUND:
-            return DCGM_FP64_NOT_FOUND;
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta)
+        return DCGM_ST_GENERIC_ERROR;
 
-        default:
-            return DCGM_FP64_BLANK;
+    /* Only strings/binary need their values freed. */
+    if ((DCGM_FT_STRING != fieldMeta->fieldType) && (DCGM_FT_BINARY != fieldMeta->fieldType))
+    {
+        return DCGM_ST_OK;
     }
 
-    return DCGM_FP64_BLANK;
-}
-
-const unsigned int DCGM_BLANK_ENTITY_ID = 0xFFFFFFFF;
-
-std::optional<unsigned int> DcgmCacheManager::GetGpuIdForEntity(dcgm_field_entity_group_t entityGroupId,
-                                                                dcgm_field_eid_t entityId)
-{
-    switch (entityGroupId)
+    for (sampleIndex = 0; sampleIndex < Nsamples; sampleIndex++)
     {
-        case DCGM_FE_GPU:
-            return entityId;
-        case DCGM_FE_GPU_I:
-            for (auto const &gpu : m_gpus)
+        currentSample = &samples[sampleIndex];
+
+        if (fieldMeta->fieldType == DCGM_FT_STRING)
+        {
+            if (currentSample->val.str)
             {
-                for (auto const &instance : gpu.instances)
-                {
-                    if (instance.GetInstanceId().id == entityId)
-                    {
-                        return gpu.gpuId;
-                    };
-                }
+                free(currentSample->val.str);
+                currentSample->val.str      = 0;
+                currentSample->val2.ptrSize = 0;
             }
-            break;
-        case DCGM_FE_GPU_CI:
-            for (auto const &gpu : m_gpus)
+        }
+
+        if (fieldMeta->fieldType == DCGM_FT_BINARY)
+        {
+            if (currentSample->val.blob)
             {
-                for (auto const &instance : gpu.instances)
-                {
-                    if (instance.HasComputeInstance(DcgmNs::Mig::ComputeInstanceId { entityId }))
-                    {
-                        return gpu.gpuId;
-                    }
-                }
+                free(currentSample->val.blob);
+                currentSample->val.blob     = 0;
+                currentSample->val2.ptrSize = 0;
             }
-            break;
-        default:
-            return std::nullopt;
+        }
     }
 
-    return std::nullopt;
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgm_field_eid_t DcgmCacheManager::GetComputeInstanceEntityId(
-    unsigned int gpuId,
-    DcgmNs::Mig::Nvml::ComputeInstanceId const &nvmlComputeInstanceId,
-    DcgmNs::Mig::Nvml::GpuInstanceId const &nvmlGpuInstanceId)
+void DcgmCacheManager::FreeThreadCtx(dcgmcm_update_thread_t *threadCtx)
 {
-    DCGM_LOG_DEBUG << "[CacheManager][MIG] Entering GetComputeInstanceEntityId(gpuId: " << gpuId
-                   << ", nvmlComputeInstanceId: " << nvmlComputeInstanceId
-                   << ", nvmlGpuInstanceId: " << nvmlGpuInstanceId << ")";
+    if (!threadCtx)
+        return;
 
-    for (auto const &instance : m_gpus[gpuId].instances)
+    ClearThreadCtx(threadCtx);
+
+    for (dcgmcm_batched_gpu_values_t &batched : threadCtx->batchedValues)
     {
-        if (instance.GetNvmlInstanceId() == nvmlGpuInstanceId)
-        {
-            auto val = instance.ConvertCIIdNvmlToDcgm(nvmlComputeInstanceId);
-            if (!val)
-            {
-                break;
-            }
-            return val.value().id;
-        }
+        free(batched.fbcSessions);
+        batched.fbcSessions         = nullptr;
+        batched.fbcSessionsCapacity = 0;
+        free(batched.encoderSessions);
+        batched.encoderSessions         = nullptr;
+        batched.encoderSessionsCapacity = 0;
     }
+    threadCtx->batchedValues.clear();
+    threadCtx->fieldValues.clear();
 
-    DCGM_LOG_ERROR << "[CacheManager][MIG] Unable to find proper entityId for the given nvml values";
-    return DCGM_BLANK_ENTITY_ID;
+    m_fvBufferPool->Release(threadCtx->fvBuffer);
+    threadCtx->fvBuffer = NULL;
+
+    for (DcgmFvBuffer *&subscriberFvBuffer : threadCtx->subscriberFvBuffers)
+    {
+        m_fvBufferPool->Release(subscriberFvBuffer);
+        subscriberFvBuffer = NULL;
+    }
 }
 
 /*****************************************************************************/
-dcgm_field_eid_t DcgmCacheManager::GetInstanceEntityId(unsigned int gpuId,
-                                                       DcgmNs::Mig::Nvml::GpuInstanceId const &nvmlGpuInstanceId)
+void DcgmCacheManager::InitAndClearThreadCtx(dcgmcm_update_thread_t *threadCtx)
 {
-    DCGM_LOG_DEBUG << "[CacheManager][MIG] Entering GetInstanceEntityId(gpuId: " << gpuId
-                   << ", nvmlGpuInstanceId: " << nvmlGpuInstanceId << ")";
+    if (!threadCtx)
+        return;
 
-    for (auto const &instance : m_gpus[gpuId].instances)
-    {
-        if (instance.GetNvmlInstanceId() == nvmlGpuInstanceId)
-        {
-            return instance.GetInstanceId().id;
-        }
-    }
+    threadCtx->fvBuffer             = NULL;
+    threadCtx->bufferForSubscribers = 0;
+    memset(threadCtx->subscriberFvBuffers, 0, sizeof(threadCtx->subscriberFvBuffers));
+    threadCtx->fieldValues.clear();
+    threadCtx->batchedValues.clear();
 
-    DCGM_LOG_ERROR << "[CacheManager][MIG] Unable to find proper entityId for the given nvml values";
-    return DCGM_BLANK_ENTITY_ID;
+    ClearThreadCtx(threadCtx);
 }
 
-dcgmMigProfile_t DcgmCacheManager::GetInstanceProfile(unsigned int gpuId,
-                                                      DcgmNs::Mig::Nvml::GpuInstanceId const &nvmlGpuInstanceId)
+/*****************************************************************************/
+void DcgmCacheManager::AddGpuFieldValue(dcgmcm_update_thread_t *threadCtx,
+                                        unsigned int gpuId,
+                                        dcgm_field_meta_p fieldMeta,
+                                        dcgmcm_watch_info_p watchInfo)
 {
-    DCGM_LOG_DEBUG << "[CacheManager][MIG] Entering GetInstanceProfile(gpuId: " << gpuId
-                   << ", nvmlGpuInstanceId: " << nvmlGpuInstanceId << ")";
-    for (auto const &instance : m_gpus[gpuId].instances)
-    {
-        if (instance.GetNvmlInstanceId() == nvmlGpuInstanceId)
-        {
-            return instance.GetMigProfileType();
-        }
-    }
+    if (threadCtx->fieldValues.size() <= gpuId)
+        threadCtx->fieldValues.resize(gpuId + 1);
 
-    DCGM_LOG_ERROR << "[CacheManager][MIG] Unable to find requested GPU Instance";
-    return DcgmMigProfileNone;
+    threadCtx->fieldValues[gpuId].fields.push_back(fieldMeta);
+    threadCtx->fieldValues[gpuId].watchInfo.push_back(watchInfo);
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::NotifyMigUpdateSubscribers(unsigned int gpuId)
+void DcgmCacheManager::ClearThreadCtx(dcgmcm_update_thread_t *threadCtx)
 {
-    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+    if (!threadCtx)
+        return;
 
-    std::vector<dcgmcmEventSubscription_t> localCopy(begin(m_subscriptions[DcgmcmEventTypeMigReconfigure]),
-                                                     end(m_subscriptions[DcgmcmEventTypeMigReconfigure]));
+    /* Clear the field values. These are only as long as the highest gpuId that has had any */
+    for (dcgmcm_gpu_field_values_t &gpuFieldValues : threadCtx->fieldValues)
+    {
+        gpuFieldValues.fields.clear();
+        gpuFieldValues.watchInfo.clear();
+    }
 
-    if (mutexSt != DCGM_MUTEX_ST_LOCKEDBYME)
-        dcgm_mutex_unlock(m_mutex);
+    /* Forget the results of any batched getters from the last cycle */
+    for (dcgmcm_batched_gpu_values_t &batched : threadCtx->batchedValues)
+    {
+        batched.validMask = 0;
+    }
+    threadCtx->driverCallsSaved = 0;
 
-    for (auto &&entry : localCopy)
+    threadCtx->watchInfo = 0;
+    if (threadCtx->fvBuffer)
+        threadCtx->fvBuffer->Clear();
+    for (DcgmFvBuffer *subscriberFvBuffer : threadCtx->subscriberFvBuffers)
     {
-        entry.fn.migCb(gpuId, entry.userData);
+        if (subscriberFvBuffer)
+            subscriberFvBuffer->Clear();
     }
+    threadCtx->affectedSubscribers = 0;
+    threadCtx->cycleTimestamp      = 0;
+    threadCtx->derivedWatches.clear();
+    threadCtx->deferQuotaWatchInfo = 0;
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::RecordXidForGpu(unsigned int gpuId,
-                                       dcgmcm_update_thread_t &threadCtx,
-                                       long long eventData,
-                                       nvmlReturn_t nvmlReturn,
-                                       timelib64_t now)
+dcgmReturn_t DcgmCacheManager::UpdateFvSubscribers(dcgmcm_update_thread_t *updateCtx)
 {
-    // If the instance and compute instance IDs are set to blank, that means the XID is
-    // at the GPU level, so store it there.
-    dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_XID_ERRORS, 1);
-    threadCtx.entityKey           = watchInfo->watchKey;
-    threadCtx.watchInfo           = watchInfo;
-    timelib64_t expireTime        = 0;
-    if (watchInfo->maxAgeUsec)
-        expireTime = now - watchInfo->maxAgeUsec;
+    /* Derived fields go out with the values they were derived from */
+    if (!updateCtx->derivedWatches.empty())
+        AppendDerivedFields(updateCtx);
 
-    /* Only update once we have a valid watchInfo. This is always NVML_SUCCESS
-     * because of the for loop condition */
-    watchInfo->lastStatus = nvmlReturn;
+    if (!updateCtx->affectedSubscribers)
+        return DCGM_ST_OK; /* Nothing to do */
 
-    AppendEntityInt64(&threadCtx, eventData, 0, now, expireTime);
-}
+    DCGM_TRACE_SCOPE("cache", "UpdateFvSubscribers");
 
-/*****************************************************************************/
-void DcgmCacheManager::RecordXidForComputeInstance(unsigned int gpuId,
-                                                   dcgmcm_update_thread_t &threadCtx,
-                                                   nvmlEventData_t &eventData,
-                                                   nvmlReturn_t nvmlReturn,
-                                                   timelib64_t now)
-{
-    using DcgmNs::Mig::Nvml::ComputeInstanceId;
-    using DcgmNs::Mig::Nvml::GpuInstanceId;
-    // The XID is for a compute instance, find and add it there
-    dcgm_field_eid_t entityId = GetComputeInstanceEntityId(
-        gpuId, ComputeInstanceId { eventData.computeInstanceId }, GpuInstanceId { eventData.gpuInstanceId });
-    if (entityId != DCGM_BLANK_ENTITY_ID)
+    /* Locking the cache manager for now to protect m_subscriptions
+       We can reevaluate this later if there are deadlock issues. Technically,
+       we only modify this structure on start-up when we're single threaded. */
+    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+
+    std::vector<dcgmcmEventSubscription_t> localCopy(begin(m_subscriptions[DcgmcmEventTypeFvUpdate]),
+                                                     end(m_subscriptions[DcgmcmEventTypeFvUpdate]));
+
+    if (mutexSt != DCGM_MUTEX_ST_LOCKEDBYME)
+        dcgm_mutex_unlock(m_mutex);
+
+    /* Each watcher type gets a buffer of only the values it subscribed to. Publish them as is
+       instead of copying them for each subscriber. Subscribers may hold onto them, so the context
+       gets fresh buffers from the pool the next time it buffers values */
+    for (unsigned int i = 0; i < DcgmWatcherTypeCount; i++)
     {
-        dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(DCGM_FE_GPU_CI, entityId, DCGM_FI_DEV_XID_ERRORS, 1);
-        if (watchInfo != nullptr)
-        {
-            threadCtx.entityKey    = watchInfo->watchKey;
-            threadCtx.watchInfo    = watchInfo;
-            timelib64_t expireTime = 0;
-            if (watchInfo->maxAgeUsec)
-            {
-                expireTime = now - watchInfo->maxAgeUsec;
-            }
+        DcgmFvBuffer *&subscriberFvBuffer = updateCtx->subscriberFvBuffers[i];
+        if (!(updateCtx->affectedSubscribers & (1 << i)) || !subscriberFvBuffer)
+            continue;
 
-            watchInfo->lastStatus = nvmlReturn;
+        std::shared_ptr<DcgmFvBuffer const> snapshot = m_fvBufferPool->Share(subscriberFvBuffer);
+        subscriberFvBuffer                           = NULL;
 
-            AppendEntityInt64(&threadCtx, eventData.eventData, 0, now, expireTime);
+        RecordSampleLag(DCGM_INTROSPECT_LAG_SUBSCRIBER_DISPATCH, *snapshot);
+
+        DcgmWatcherType_t watcherType = (DcgmWatcherType_t)i;
+        for (auto &&entry : localCopy)
+        {
+            entry.fn.fvCb(snapshot, &watcherType, 1, entry.userData);
         }
     }
-    else
-    {
-        DCGM_LOG_DEBUG << "Somehow got XID error for compute instance " << eventData.computeInstanceId
-                       << " and GPU instance " << eventData.gpuInstanceId << " (NVML IDs) which do not exist in DCGM";
-    }
+
+    updateCtx->affectedSubscribers = 0;
+
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::RecordXidForGpuInstance(unsigned int gpuId,
-                                               dcgmcm_update_thread_t &threadCtx,
-                                               nvmlEventData_t &eventData,
-                                               nvmlReturn_t nvmlReturn,
-                                               timelib64_t now)
+dcgmReturn_t DcgmCacheManager::SubscribeForEvent(const dcgmcmEventSubscription_t &eventSub)
 {
-    using DcgmNs::Mig::Nvml::GpuInstanceId;
-    // The XID is for a GPU instance, find and add it there
-    dcgm_field_eid_t entityId = GetInstanceEntityId(gpuId, GpuInstanceId { eventData.gpuInstanceId });
-    if (entityId != DCGM_BLANK_ENTITY_ID)
+    switch (eventSub.type)
     {
-        dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(DCGM_FE_GPU_I, entityId, DCGM_FI_DEV_XID_ERRORS, 1);
-        if (watchInfo != nullptr)
+        case DcgmcmEventTypeFvUpdate:
         {
-            threadCtx.entityKey    = watchInfo->watchKey;
-            threadCtx.watchInfo    = watchInfo;
-            timelib64_t expireTime = 0;
-            if (watchInfo->maxAgeUsec)
+            if (eventSub.fn.fvCb == nullptr)
             {
-                expireTime = now - watchInfo->maxAgeUsec;
+                DCGM_LOG_DEBUG << "Cannot subscribe to field value updates using a null callback function";
+                return DCGM_ST_BADPARAM;
             }
+            break;
+        }
 
-            watchInfo->lastStatus = nvmlReturn;
+        case DcgmcmEventTypeMigReconfigure:
+        {
+            if (eventSub.fn.migCb == nullptr)
+            {
+                DCGM_LOG_DEBUG << "Cannot subscribe to mig reconfigure updates using a null callback function";
+                return DCGM_ST_BADPARAM;
+            }
+            break;
+        }
 
-            AppendEntityInt64(&threadCtx, eventData.eventData, 0, now, expireTime);
+        default:
+        {
+            DCGM_LOG_DEBUG << "Cannot process cache manager event type " << eventSub.type;
+            return DCGM_ST_BADPARAM;
         }
     }
-    else
-    {
-        DCGM_LOG_DEBUG << "Somehow got an XID error for GPU instance " << eventData.gpuInstanceId
-                       << " (NVML ID) which does not exist in DCGM";
-    }
-}
 
-/*****************************************************************************/
-void DcgmCacheManager::EventThreadMain(DcgmCacheManagerEventThread *eventThread)
-{
-    nvmlReturn_t nvmlReturn;
-    nvmlEventData_t eventData = {};
-    unsigned int nvmlGpuIndex;
-    timelib64_t now;
-    unsigned int gpuId;
-    int numErrors          = 0;
-    unsigned int timeoutMs = 0; // Do not block in the NVML event call
-    dcgmcm_update_thread_t threadCtx;
-    static const unsigned int MIG_RECONFIG_DELAY_TIMEOUT = 10000000; // 10 seconds in microseconds
-
-    InitAndClearThreadCtx(&threadCtx);
-
-    if (!m_nvmlEventSetInitialized)
-    {
-        PRINT_ERROR("", "event set not initialized");
-        Stop(); /* Skip the next loop */
-    }
-
-    while (!eventThread->ShouldStop())
-    {
-        unsigned int updatedMigGpuId = DCGM_MAX_NUM_DEVICES;
-
-        /* Clear fvBuffer if it exists */
-        ClearThreadCtx(&threadCtx);
 
-        /* If we haven't allocated fvBuffer yet, do so only if there are any live subscribers */
-        if (!threadCtx.fvBuffer && m_haveAnyLiveSubscribers)
-        {
-            /* Buffer live updates for subscribers */
-            threadCtx.fvBuffer = new DcgmFvBuffer();
-        }
-
-        MarkEnteredDriver();
+    dcgm_mutex_lock(m_mutex);
+    m_subscriptions[eventSub.type].push_back(eventSub);
+    dcgm_mutex_unlock(m_mutex);
 
-        if (!m_nvmlEventSetInitialized)
-        {
-            MarkReturnedFromDriver();
-            Sleep(1000000);
-            continue;
-        }
+    return DCGM_ST_OK;
+}
 
-        /* Try to read an event */
-        nvmlReturn = nvmlEventSetWait_v2(m_nvmlEventSet, &eventData, timeoutMs);
-        if (nvmlReturn == NVML_ERROR_NOT_SUPPORTED || nvmlReturn == NVML_ERROR_FUNCTION_NOT_FOUND)
-        {
-            DCGM_LOG_DEBUG << "nvmlEventSetWait_v2 returned " << nvmlReturn << ". Calling nvmlEventSetWait";
-            nvmlReturn = nvmlEventSetWait(m_nvmlEventSet, &eventData, timeoutMs);
-        }
-        if (nvmlReturn == NVML_ERROR_TIMEOUT)
-        {
-            // This happens often and is expected to. Only log if set to verbose to reduce noise
-            DCGM_LOG_VERBOSE << "nvmlEventSetWait timeout.";
-            MarkReturnedFromDriver();
-            Sleep(1000000);
-            continue; /* We expect to get this 99.9% of the time. Keep on reading */
-        }
-        else if (nvmlReturn != NVML_SUCCESS)
-        {
-            PRINT_WARNING("%d", "Got st %d from nvmlEventSetWait", (int)nvmlReturn);
-            numErrors++;
-            if (numErrors >= 1000)
-            {
-                /* If we get an excessive number of errors, quit instead of spinning in a hot loop
-                   this will cripple event reading, but it will prevent DCGM from using 100% CPU */
-                PRINT_CRITICAL("%d", "Quitting EventThreadMain() after %d errors.", numErrors);
-            }
-            MarkReturnedFromDriver();
-            Sleep(1000000);
-            continue;
-        }
+/*****************************************************************************/
+void DcgmCacheManager::MarkEnteredDriver()
+{
+    DcgmLockGuard dlg(m_mutex);
 
-        now = timelib_usecSince1970();
+    // Make sure we aren't waiting to detach from the GPUs
+    WaitForDriverToBeReady();
 
-        nvmlReturn = nvmlDeviceGetIndex(eventData.device, &nvmlGpuIndex);
-        if (nvmlReturn != NVML_SUCCESS)
-        {
-            PRINT_WARNING("", "Unable to convert device handle to index");
-            MarkReturnedFromDriver();
-            Sleep(1000000);
-            continue;
-        }
+    m_inDriverCount++;
+}
 
-        gpuId = NvmlIndexToGpuId(nvmlGpuIndex);
+/*****************************************************************************/
+void DcgmCacheManager::MarkReturnedFromDriver()
+{
+    DcgmLockGuard dlg(m_mutex);
 
-        PRINT_DEBUG("%llu %u", "Got nvmlEvent %llu for gpuId %u", eventData.eventType, gpuId);
+    m_inDriverCount--;
+}
 
-        switch (eventData.eventType)
-        {
-            case nvmlEventTypeXidCriticalError:
-                if (!m_driverIsR450OrNewer || m_gpus[gpuId].migEnabled == false)
-                {
-                    RecordXidForGpu(gpuId, threadCtx, eventData.eventData, nvmlReturn, now);
-                }
-                else if (eventData.gpuInstanceId == DCGM_BLANK_ENTITY_ID
-                         && eventData.computeInstanceId == DCGM_BLANK_ENTITY_ID)
-                {
-                    RecordXidForGpu(gpuId, threadCtx, eventData.eventData, nvmlReturn, now);
-                }
-                else if (eventData.computeInstanceId != DCGM_BLANK_ENTITY_ID)
-                {
-                    RecordXidForComputeInstance(gpuId, threadCtx, eventData, nvmlReturn, now);
-                }
-                else
-                {
-                    RecordXidForGpuInstance(gpuId, threadCtx, eventData, nvmlReturn, now);
-                }
-                break;
+/*****************************************************************************/
+bool DcgmCacheManager::IsModulePushedFieldId(unsigned int fieldId)
+{
+    /* NvSwitch and Profiling fields are the fields >= 700 */
+    return DcgmWatchTable::GetFieldModule(fieldId) != DcgmModuleIdCore;
+}
 
-#if 0 /* TODO: DCGM-1419 */
-            case nvmlEventTypeNVLinkRecoveryError:
-            case nvmlEventTypeNVLinkFatalError:
-                watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_NVLINK_ERRORS, 1);
-                threadCtx.entityKey = watchInfo->watchKey;
-                threadCtx.watchInfo = watchInfo;
-                expireTime = 0;
-                if(watchInfo->maxAgeUsec)
-                    expireTime = now - watchInfo->maxAgeUsec;
-
-                /* Only update once we have a valid watchInfo. This is always NVML_SUCCESS
-                * because of the for loop condition */
-                watchInfo->lastStatus = nvmlReturn;
-                // update eventData with DCGM error type
-                eventData.eventData = NvmlGpuNVLinkErrorToDcgmError(eventData.eventType);
-                AppendEntityInt64(&threadCtx, (long long)eventData.eventData, 0,
-                                  now, expireTime);
-                break;
-#endif
-            case nvmlEventMigConfigChange:
-            {
-                updatedMigGpuId = gpuId;
+/*****************************************************************************/
+/* A rate field and the cumulative counter field it is derived from */
+struct DcgmcmCounterRate
+{
+    unsigned short rateFieldId;
+    unsigned short counterFieldId;
+    double scale; /* Multiplies counter units per second into the rate field's units */
+};
 
-                dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
-                // If the user has requested that we delay processing this event within a reasonable timeout,
-                // then do so.
-                dcgmReturn_t ret = DCGM_ST_OK;
-                if (now - m_delayedMigReconfigProcessingTimestamp >= MIG_RECONFIG_DELAY_TIMEOUT)
-                {
-                    ClearGpuMigInfo(m_gpus[gpuId]);
-                    ret = InitializeGpuInstances(m_gpus[gpuId]);
-                }
-                if (mutexSt != DCGM_MUTEX_ST_LOCKEDBYME)
-                    dcgm_mutex_unlock(m_mutex);
+static DcgmcmCounterRate const c_counterRates[] = {
+    { DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION_RATE, DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION, 0.001 }, /* mJ/s -> W */
+    { DCGM_FI_DEV_PCIE_REPLAY_RATE, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, 1.0 },
+    { DCGM_FI_DEV_ECC_SBE_AGG_RATE, DCGM_FI_DEV_ECC_SBE_AGG_TOTAL, 1.0 },
+    { DCGM_FI_DEV_ECC_DBE_AGG_RATE, DCGM_FI_DEV_ECC_DBE_AGG_TOTAL, 1.0 },
+    { DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_RATE_TOTAL, DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_COUNT_TOTAL, 1.0 },
+    { DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_RATE_TOTAL, DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_COUNT_TOTAL, 1.0 },
+    { DCGM_FI_DEV_NVLINK_REPLAY_ERROR_RATE_TOTAL, DCGM_FI_DEV_NVLINK_REPLAY_ERROR_COUNT_TOTAL, 1.0 },
+    { DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_RATE_TOTAL, DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_COUNT_TOTAL, 1.0 },
+};
 
-                if (ret != DCGM_ST_OK)
-                {
-                    DCGM_LOG_ERROR << "Coult not re-initialize MIG information for GPU " << gpuId << ": "
-                                   << errorString(ret);
-                }
+static DcgmcmCounterRate const *FindCounterRate(unsigned int rateFieldId)
+{
+    if (rateFieldId < DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION_RATE
+        || rateFieldId > DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_RATE_TOTAL)
+        return nullptr; /* Fast path for the update loop */
 
-                break;
-            }
+    for (DcgmcmCounterRate const &counterRate : c_counterRates)
+    {
+        if (counterRate.rateFieldId == rateFieldId)
+            return &counterRate;
+    }
+    return nullptr;
+}
 
-            default:
-                PRINT_WARNING("%llX", "Unhandled event type %llX", eventData.eventType);
-                break;
-        }
+/*****************************************************************************/
+/* How much a counter went up from previous to current. A counter that went backwards was reset
+   to 0 by a driver reload, GPU reset or a clear of the counter, so it went up by current since then */
+static long long CounterIncrease(long long previous, long long current)
+{
+    return current >= previous ? current - previous : current;
+}
 
-        if (threadCtx.fvBuffer)
-            UpdateFvSubscribers(&threadCtx);
+/*****************************************************************************/
+unsigned short DcgmCacheManager::GetRateCounterFieldId(unsigned int fieldId)
+{
+    DcgmcmCounterRate const *counterRate = FindCounterRate(fieldId);
+    return counterRate ? counterRate->counterFieldId : 0;
+}
 
-        MarkReturnedFromDriver();
+/*****************************************************************************/
+void DcgmCacheManager::UpdateRateCounterWatch(dcgmcm_watch_info_p rateInfo)
+{
+    dcgmcm_entity_key_t const &rateKey = rateInfo->watchKey;
+    unsigned short counterFieldId      = GetRateCounterFieldId(rateKey.fieldId);
+
+    dcgm_watch_watcher_info_t rateWatcher;
+    rateWatcher.watcher              = DcgmWatcher(DcgmWatcherTypeCacheManager);
+    rateWatcher.monitorFrequencyUsec = rateInfo->monitorFrequencyUsec;
+    rateWatcher.maxAgeUsec           = rateInfo->maxAgeUsec;
+    rateWatcher.isSubscribed         = 0;
+
+    int createIfNotExists           = rateInfo->watchers.empty() ? 0 : 1;
+    dcgmcm_watch_info_p counterInfo = GetEntityWatchInfo(
+        (dcgm_field_entity_group_t)rateKey.entityGroupId, rateKey.entityId, counterFieldId, createIfNotExists);
+    if (!counterInfo)
+        return;
 
-        if (updatedMigGpuId != DCGM_MAX_NUM_DEVICES)
+    if (rateInfo->watchers.empty())
+    {
+        if (counterInfo->rateWatchInfo == rateInfo)
         {
-            NotifyMigUpdateSubscribers(updatedMigGpuId);
+            counterInfo->rateWatchInfo = nullptr;
+            RemoveWatcher(counterInfo, &rateWatcher);
         }
+        return;
+    }
+
+    if (counterInfo->rateWatchInfo != rateInfo)
+    {
+        /* Rates start from the next counter sample */
+        counterInfo->rateWatchInfo = rateInfo;
+        counterInfo->rateLastUsec  = 0;
+    }
 
-        Sleep(1000000);
+    bool wasAdded = false;
+    AddOrUpdateWatcher(counterInfo, &wasAdded, &rateWatcher);
+    if (!counterInfo->isWatched)
+    {
+        counterInfo->lastQueriedUsec = 0;
+        counterInfo->isWatched       = 1;
     }
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::PopulateTopologyAffinity(dcgmAffinity_t &affinity)
+void DcgmCacheManager::AppendCounterRate(dcgmcm_update_thread_t *threadCtx,
+                                         dcgmcm_watch_info_p counterInfo,
+                                         long long counter,
+                                         timelib64_t timestamp)
 {
-    unsigned int elementsFilled = 0;
+    dcgmcm_watch_info_p rateInfo = counterInfo->rateWatchInfo;
+    if (!rateInfo->isWatched)
+        return;
 
-    for (unsigned int index = 0; index < m_numGpus; index++)
-    {
-        if (m_gpus[index].status == DcgmEntityStatusDetached)
-            continue;
+    if (!timestamp)
+        timestamp = timelib_usecSince1970();
 
-        nvmlReturn_t nvmlReturn = nvmlDeviceGetCpuAffinity(
-            m_gpus[index].nvmlDevice, DCGM_AFFINITY_BITMASK_ARRAY_SIZE, affinity.affinityMasks[elementsFilled].bitmask);
-        if (NVML_SUCCESS != nvmlReturn)
-            return NvmlReturnToDcgmReturn(nvmlReturn);
-        affinity.affinityMasks[elementsFilled].dcgmGpuId = NvmlIndexToGpuId(index);
+    double rate;
+    if (DCGM_INT64_IS_BLANK(counter))
+    {
+        /* Pass on why there's no counter, like not supported. The next rate starts over */
+        rate                      = nvcmvalue_int64_to_double(counter);
+        counterInfo->rateLastUsec = 0;
+    }
+    else if (!counterInfo->rateLastUsec)
+    {
+        /* The first sample only gives us something to take the next rate from */
+        counterInfo->rateLastCounter = counter;
+        counterInfo->rateLastUsec    = timestamp;
+        return;
+    }
+    else if (timestamp <= counterInfo->rateLastUsec)
+    {
+        return; /* Out of order or repeated. There's no interval to take a rate over */
+    }
+    else
+    {
+        double elapsedSec = (timestamp - counterInfo->rateLastUsec) / 1000000.0;
+        rate = (double)CounterIncrease(counterInfo->rateLastCounter, counter) / elapsedSec;
+        rate *= FindCounterRate(rateInfo->watchKey.fieldId)->scale;
 
-        elementsFilled++;
+        counterInfo->rateLastCounter = counter;
+        counterInfo->rateLastUsec    = timestamp;
     }
-    affinity.numGpus = elementsFilled;
-    return DCGM_ST_OK;
+
+    dcgmcm_watch_info_p savedWatchInfo = threadCtx->watchInfo;
+    dcgmcm_entity_key_t savedEntityKey = threadCtx->entityKey;
+    threadCtx->watchInfo               = rateInfo;
+    threadCtx->entityKey               = rateInfo->watchKey;
+
+    timelib64_t expireTime = rateInfo->maxAgeUsec ? timestamp - rateInfo->maxAgeUsec : 0;
+    AppendEntityDouble(threadCtx, rate, 0.0, timestamp, expireTime);
+    rateInfo->lastQueriedUsec = timestamp;
+
+    threadCtx->watchInfo = savedWatchInfo;
+    threadCtx->entityKey = savedEntityKey;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::CacheTopologyAffinity(dcgmcm_update_thread_t *threadCtx,
-                                                     timelib64_t now,
-                                                     timelib64_t expireTime)
+bool DcgmCacheManager::IsDerivedFieldId(unsigned int fieldId)
 {
-    dcgmAffinity_t affinity = {};
-    PopulateTopologyAffinity(affinity);
-
-    AppendEntityBlob(threadCtx, &affinity, sizeof(dcgmAffinity_t), now, expireTime);
-
-    return DCGM_ST_OK;
+    return fieldId >= DCGM_FI_FIRST_DERIVED_FIELD_ID && fieldId <= DCGM_FI_LAST_DERIVED_FIELD_ID;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::HelperGetActiveNvSwitchNvLinkCountsForAllGpusUsingNVML(
-    std::vector<unsigned int> &gpuCounts)
+void DcgmCacheManager::UpdateDerivedFieldWatch(dcgmcm_watch_info_p derivedInfo)
 {
-    nvmlFieldValue_t value = {};
-    for (unsigned int i = 0; i < m_numGpus; i++)
+    dcgmcm_entity_key_t const &derivedKey = derivedInfo->watchKey;
+    std::shared_ptr<DcgmDerivedField const> const &derivedField
+        = m_derivedFields[derivedKey.fieldId - DCGM_FI_FIRST_DERIVED_FIELD_ID];
+
+    /* One watcher per derived field, so derived fields with inputs in common don't remove each other's */
+    dcgm_watch_watcher_info_t inputWatcher;
+    inputWatcher.watcher              = DcgmWatcher(DcgmWatcherTypeCacheManager, derivedKey.fieldId);
+    inputWatcher.monitorFrequencyUsec = derivedInfo->monitorFrequencyUsec;
+    inputWatcher.maxAgeUsec           = derivedInfo->maxAgeUsec;
+    inputWatcher.isSubscribed         = 0;
+
+    std::vector<dcgmcm_watch_info_p> inputs;
+    if (!derivedInfo->watchers.empty() && derivedField)
     {
-        if (m_gpus[i].status == DcgmEntityStatusDetached)
+        for (unsigned short inputFieldId : derivedField->GetInputFieldIds())
         {
-            continue;
+            dcgmcm_watch_info_p inputInfo = GetEntityWatchInfo(
+                (dcgm_field_entity_group_t)derivedKey.entityGroupId, derivedKey.entityId, inputFieldId, 1);
+            if (!inputInfo)
+            {
+                PRINT_ERROR("%u %u", "Unable to watch input %u of derived field %u", inputFieldId, derivedKey.fieldId);
+                inputs.clear();
+                break;
+            }
+            inputs.push_back(inputInfo);
         }
+    }
 
-        DCGM_LOG_DEBUG << "Getting CONNECTED_LINK_COUNT for GPU " << i;
+    for (dcgmcm_watch_info_p inputInfo : derivedInfo->derivedInputs)
+    {
+        if (std::find(inputs.begin(), inputs.end(), inputInfo) != inputs.end())
+            continue;
 
-        // Check for NVSwitch connectivity.
-        // We assume all-to-all connectivity in presence of NVSwitch.
-        value.fieldId           = NVML_FI_DEV_NVSWITCH_CONNECTED_LINK_COUNT;
-        nvmlReturn_t nvmlReturn = nvmlDeviceGetFieldValues(m_gpus[i].nvmlDevice, 1, &value);
-        if (nvmlReturn != NVML_SUCCESS || value.nvmlReturn == NVML_ERROR_INVALID_ARGUMENT)
-        {
-            DCGM_LOG_DEBUG << "DeviceGetFieldValues gpu " << m_gpus[i].gpuId << " failed with nvmlRet " << nvmlReturn
-                           << ", value.nvmlReturn " << value.nvmlReturn << ". Is the driver >= r460?";
-            return DCGM_ST_NOT_SUPPORTED;
-        }
-        else if (value.nvmlReturn != NVML_SUCCESS)
+        std::vector<dcgmcm_watch_info_p> &derivedWatchInfos = inputInfo->derivedWatchInfos;
+        derivedWatchInfos.erase(std::remove(derivedWatchInfos.begin(), derivedWatchInfos.end(), derivedInfo),
+                                derivedWatchInfos.end());
+        RemoveWatcher(inputInfo, &inputWatcher);
+    }
+    derivedInfo->derivedInputs = inputs;
+
+    for (dcgmcm_watch_info_p inputInfo : inputs)
+    {
+        std::vector<dcgmcm_watch_info_p> &derivedWatchInfos = inputInfo->derivedWatchInfos;
+        if (std::find(derivedWatchInfos.begin(), derivedWatchInfos.end(), derivedInfo) == derivedWatchInfos.end())
+            derivedWatchInfos.push_back(derivedInfo);
+
+        bool wasAdded = false;
+        AddOrUpdateWatcher(inputInfo, &wasAdded, &inputWatcher);
+        if (!inputInfo->isWatched)
         {
-            DCGM_LOG_DEBUG << "NvSwitch link count returned nvml status " << nvmlReturn << " for gpu "
-                           << m_gpus[i].gpuId;
-            continue;
+            inputInfo->lastQueriedUsec = 0;
+            inputInfo->isWatched       = 1;
         }
-
-        gpuCounts[i] = value.value.uiVal;
-        DCGM_LOG_DEBUG << "GPU " << m_gpus[i].gpuId << " has " << value.value.uiVal << " active NvSwitch NvLinks.";
     }
-    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::HelperGetActiveNvSwitchNvLinkCountsForAllGpusUsingNSCQ(
-    std::vector<unsigned int> &gpuCounts)
+void DcgmCacheManager::QueueDerivedFields(dcgmcm_update_thread_t *threadCtx, dcgmcm_watch_info_p inputInfo)
 {
-    std::vector<dcgmGroupEntityPair_t> entities;
-    dcgmReturn_t ret = DcgmHostEngineHandler::Instance()->GetAllEntitiesOfEntityGroup(1, DCGM_FE_SWITCH, entities);
+    std::vector<dcgmcm_watch_info_p> &derivedWatches = threadCtx->derivedWatches;
 
-    if (ret == DCGM_ST_MODULE_NOT_LOADED)
-    {
-        /* no switches detected */
-        return DCGM_ST_OK;
-    }
-    else if (ret != DCGM_ST_OK)
+    for (dcgmcm_watch_info_p derivedInfo : inputInfo->derivedWatchInfos)
     {
-        DCGM_LOG_ERROR << "Could not query NvSwitches: " << ret;
-        return ret;
+        if (std::find(derivedWatches.begin(), derivedWatches.end(), derivedInfo) == derivedWatches.end())
+            derivedWatches.push_back(derivedInfo);
     }
+}
 
-    if (entities.size() <= 0)
-    {
-        DCGM_LOG_DEBUG << "No NvSwitches detected.";
-        return DCGM_ST_OK;
-    }
+/*****************************************************************************/
+void DcgmCacheManager::AppendDerivedFields(dcgmcm_update_thread_t *threadCtx)
+{
+    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
 
-    for (unsigned int i = 0; i < m_numGpus; i++)
+    /* Appending the derived values doesn't queue anything, as derived fields aren't inputs */
+    std::vector<dcgmcm_watch_info_p> derivedWatches;
+    derivedWatches.swap(threadCtx->derivedWatches);
+
+    dcgmcm_watch_info_p savedWatchInfo = threadCtx->watchInfo;
+    dcgmcm_entity_key_t savedEntityKey = threadCtx->entityKey;
+
+    for (dcgmcm_watch_info_p derivedInfo : derivedWatches)
     {
-        if (m_gpus[i].status == DcgmEntityStatusDetached)
+        std::shared_ptr<DcgmDerivedField const> const &derivedField
+            = m_derivedFields[derivedInfo->watchKey.fieldId - DCGM_FI_FIRST_DERIVED_FIELD_ID];
+        if (!derivedInfo->isWatched || !derivedField
+            || derivedInfo->derivedInputs.size() != derivedField->GetInputFieldIds().size())
             continue;
 
-        for (unsigned int j = 0; j < DCGM_NVLINK_MAX_LINKS_PER_GPU; j++)
+        double inputs[DCGM_DERIVED_FIELD_MAX_INPUTS];
+        timelib64_t timestamp = 0;
+        double blank          = 0.0; /* First blank input. 0.0 = none */
+        size_t i;
+
+        for (i = 0; i < derivedInfo->derivedInputs.size(); i++)
         {
-            if (m_gpus[i].nvLinkLinkState[j] == DcgmNvLinkLinkStateUp)
-                gpuCounts[i]++;
+            timeseries_p timeSeries = derivedInfo->derivedInputs[i]->timeSeries;
+            timeseries_cursor_t cursor;
+            timeseries_entry_p entry = timeSeries ? timeseries_last(timeSeries, &cursor) : nullptr;
+            if (!entry)
+                break; /* Wait for every input to have a sample */
+
+            if (timeSeries->tsType == TS_TYPE_INT64)
+                inputs[i] = nvcmvalue_int64_to_double(entry->val.i64);
+            else
+                inputs[i] = entry->val.dbl;
+            if (DCGM_FP64_IS_BLANK(inputs[i]) && !blank)
+                blank = inputs[i];
+            timestamp = std::max(timestamp, entry->usecSince1970);
         }
 
-        DCGM_LOG_DEBUG << "GPU " << i << " is connected to " << gpuCounts[i] << " GPUs by NvSwitches.";
+        /* Nothing newer than the last value? */
+        if (i < derivedInfo->derivedInputs.size() || timestamp <= derivedInfo->lastQueriedUsec)
+            continue;
+
+        /* Pass on why an input has no value, like not supported */
+        double value = blank ? blank : derivedField->Evaluate(inputs);
+
+        threadCtx->watchInfo = derivedInfo;
+        threadCtx->entityKey = derivedInfo->watchKey;
+
+        timelib64_t expireTime = derivedInfo->maxAgeUsec ? timestamp - derivedInfo->maxAgeUsec : 0;
+        AppendEntityDouble(threadCtx, value, 0.0, timestamp, expireTime);
+        derivedInfo->lastQueriedUsec = timestamp;
     }
 
-    return DCGM_ST_OK;
+    threadCtx->watchInfo = savedWatchInfo;
+    threadCtx->entityKey = savedEntityKey;
+
+    if (mutexSt == DCGM_MUTEX_ST_OK)
+        dcgm_mutex_unlock(m_mutex);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetActiveNvSwitchNvLinkCountsForAllGpus(std::vector<unsigned int> &gpuCounts)
+dcgmReturn_t DcgmCacheManager::ActuallyUpdateAllFields(dcgmcm_update_thread_t *threadCtx,
+                                                       timelib64_t *earliestNextUpdate)
 {
-    if (gpuCounts.size() < m_numGpus)
+    dcgmcm_watch_info_p watchInfo = 0;
+    timelib64_t now, newNow, age;
+    dcgmMutexReturn_t mutexReturn;   /* Tracks the state of the cache manager mutex */
+    int anyFieldValues          = 0; /* Have we queued any field values to be fetched from nvml? */
+    int anyGpuWatches           = 0; /* Have we queued any watches for the per-GPU fetch workers? */
+    int anyCollectorWatches     = 0; /* Have we queued any watches for entity collectors? */
+    dcgm_field_meta_p fieldMeta = 0;
+    std::vector<dcgmcm_watch_info_p> gpuWatches[DCGM_MAX_NUM_DEVICES]; /* Due watches per GPU when
+                                                                          m_parallelGpuFetch is set */
+    std::vector<dcgmcm_watch_info_p> snapshotWatches[DCGM_MAX_NUM_DEVICES]; /* Watches of due snapshot
+                                                                               groups per GPU */
+    std::set<unsigned int> snapshotGroupsDue; /* Snapshot groups already gathered this pass */
+    DCGM_TRACE_SCOPE("cache", "ActuallyUpdateAllFields");
+
+    mutexReturn = m_mutex->Poll();
+    if (mutexReturn != DCGM_MUTEX_ST_LOCKEDBYME)
     {
-        return DCGM_ST_INSUFFICIENT_SIZE;
+        PRINT_ERROR("%d", "Entered ActuallyUpdateAllFields() without the lock st %d", (int)mutexReturn);
+        return DCGM_ST_GENERIC_ERROR; /* We need the lock in here */
     }
 
-    gpuCounts = {};
+    ClearThreadCtx(threadCtx);
+    UpdateThreadPlacement();
 
-    // Attempt to query through NVML. This is not supported in all drivers so
-    // there is a fallback approach below
-    if (HelperGetActiveNvSwitchNvLinkCountsForAllGpusUsingNVML(gpuCounts) == DCGM_ST_OK)
-    {
-        return DCGM_ST_OK;
-    }
-
-    DCGM_LOG_DEBUG << "Failed to query NVLink counts using NVML. Falling back to NSCQ";
-
-    // Failed to fetch link counts using NVML. Fall back to NSCQ.
-    return HelperGetActiveNvSwitchNvLinkCountsForAllGpusUsingNSCQ(gpuCounts);
-}
+    /* This loop reads the clock for every watch, so it uses the cheaper counter-based clock */
+    *earliestNextUpdate = 0;
+    now                 = timelib_fastUsecSince1970();
 
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::PopulateTopologyNvLink(dcgmTopology_t **topology_pp, unsigned int &topologySize)
-{
-    dcgmTopology_t *topology_p;
-    unsigned int elementArraySize = 0;
-    unsigned int elementsFilled   = 0;
-    std::vector<unsigned int> gpuNvSwitchLinkCounts(DCGM_MAX_NUM_DEVICES);
-    dcgmNvLinkStatus_v2 linkStatus;
+    /* Pop every watch that is due off of the schedule before doing any work. Watches are
+       rescheduled as they are processed, so draining first means a watch with a
+       monitorFrequencyUsec of 0 is only visited once per pass */
+    std::vector<dcgmcm_watch_info_p> dueWatches;
+    m_watchSchedule.PopDue(now, dueWatches);
 
-    if (m_numGpus < 2)
+    for (size_t dueIndex = 0; dueIndex < dueWatches.size(); dueIndex++)
     {
-        PRINT_DEBUG("", "Two devices not detected on this system");
-        return (DCGM_ST_NOT_SUPPORTED);
-    }
+        watchInfo = dueWatches[dueIndex];
 
-    /* Find out how many NvSwitches each GPU is connected to */
-    GetActiveNvSwitchNvLinkCountsForAllGpus(gpuNvSwitchLinkCounts);
-
-    // arithmetic series formula to calc number of combinations
-    elementArraySize = (unsigned int)((float)(m_numGpus - 1.0) * (1.0 + ((float)m_numGpus - 2.0) / 2.0));
+        /* Was this watch removed or rescheduled while we had the lock dropped for a driver call? */
+        if (!watchInfo->isWatched || watchInfo->nextUpdateUsec)
+            continue;
 
-    // this is intended to minimize how much we're storing since we rarely will need all 120 entries in the element
-    // array
-    topologySize = sizeof(dcgmTopology_t) - (sizeof(dcgmTopologyElement_t) * DCGM_TOPOLOGY_MAX_ELEMENTS)
-                   + elementArraySize * sizeof(dcgmTopologyElement_t);
+        /* Fields derived from other fields aren't fetched. They remain unscheduled. Module-pushed
+           fields are never scheduled here. See ScheduleWatchUpdate() */
+        if (GetRateCounterFieldId(watchInfo->watchKey.fieldId) || IsDerivedFieldId(watchInfo->watchKey.fieldId))
+            continue;
 
-    topology_p = (dcgmTopology_t *)calloc(1, topologySize);
-    if (!topology_p)
-    {
-        DCGM_LOG_ERROR << "Out of memory";
-        return DCGM_ST_MEMORY;
-    }
+        /* Last sample time old enough to take another? This can be false if the watch
+           was updated outside of this loop since it was scheduled. Watches aligned to an
+           earlier tick are due that much sooner. See SetWatchCoalescing() */
+        age = now - watchInfo->lastQueriedUsec;
+        if (!watchInfo->eventPending && age < GetPollIntervalUsec(watchInfo) - GetWatchCoalesceUsec(watchInfo))
+        {
+            ScheduleWatchUpdate(watchInfo, watchInfo->lastQueriedUsec + GetPollIntervalUsec(watchInfo));
+            continue; /* Not old enough to update */
+        }
+        watchInfo->eventPending = 0;
 
-    *topology_pp = topology_p;
+        fieldMeta = DcgmFieldGetById(watchInfo->watchKey.fieldId);
+        if (!fieldMeta)
+        {
+            PRINT_ERROR("%d", "Unexpected null fieldMeta for field %d", watchInfo->watchKey.fieldId);
+            ScheduleWatchUpdate(watchInfo, now + watchInfo->monitorFrequencyUsec);
+            continue;
+        }
 
-    /* Get the status of each GPU's NvLinks. We will use this to generate the link mask when
-     * gpuNvSwitchLinkCounts[x] is nonzero */
-    memset(&linkStatus, 0, sizeof(linkStatus));
-    PopulateNvLinkLinkStatus(linkStatus);
+        /* Once per watch per cycle. Too hot for the text log, so it goes to the binary log when that is on */
+        DCGM_BINARY_LOG("Preparing to update watchInfo %p, eg %u, eid %u, fieldId %u",
+                        (void *)watchInfo,
+                        watchInfo->watchKey.entityGroupId,
+                        watchInfo->watchKey.entityId,
+                        watchInfo->watchKey.fieldId);
 
-    topology_p->version = dcgmTopology_version1;
-    for (unsigned int index1 = 0; index1 < m_numGpus; index1++)
-    {
-        if (m_gpus[index1].status == DcgmEntityStatusDetached)
-            continue;
+        if (watchInfo->practicalEntityGroupId == DCGM_FE_GPU)
+        {
+            /* Don't cache GPU fields if the GPU is not available */
+            DcgmEntityStatus_t gpuStatus = GetGpuStatus(watchInfo->practicalEntityId);
+            if (gpuStatus != DcgmEntityStatusOk)
+            {
+                PRINT_DEBUG("%d %d", "Skipping gpuId %d in status %d", watchInfo->practicalEntityId, gpuStatus);
+                ScheduleWatchUpdate(watchInfo, now + watchInfo->monitorFrequencyUsec);
+                continue;
+            }
+        }
+        /* Base when we sync again on before the driver call so we don't continuously
+         * get behind by how long the driver call took
+         */
+        ScheduleWatchUpdate(watchInfo, now + GetPollIntervalUsec(watchInfo));
 
-        int gpuId1 = m_gpus[index1].gpuId;
+        /* The whole snapshot group is fetched together below. See AddSnapshotGroup() */
+        if (watchInfo->snapshotGroupId && watchInfo->practicalEntityGroupId == DCGM_FE_GPU)
+        {
+            if (snapshotGroupsDue.count(watchInfo->snapshotGroupId)
+                || GatherSnapshotGroup(watchInfo->snapshotGroupId, now, snapshotWatches))
+            {
+                snapshotGroupsDue.insert(watchInfo->snapshotGroupId);
+                continue;
+            }
+            watchInfo->snapshotGroupId = 0; /* The group is gone. Fetch it on its own */
+        }
 
-        if (m_gpus[index1].arch < DCGM_CHIP_ARCH_PASCAL) // bracket this when NVLINK becomes not available on an arch
+        /* Leave the watches of entity groups with a collector to it. See StartEntityCollectors() */
+        if (watchInfo->practicalEntityGroupId < DCGM_FE_COUNT && m_entityCollectors[watchInfo->practicalEntityGroupId])
         {
-            PRINT_DEBUG("%d", "GPU %d is older than Pascal", gpuId1);
+            watchInfo->lastQueriedUsec = now;
+            m_collectorPasses[watchInfo->practicalEntityGroupId].watches.push_back(watchInfo);
+            anyCollectorWatches = 1;
             continue;
         }
 
-        for (unsigned int index2 = index1 + 1; index2 < m_numGpus; index2++)
+        /* Leave GPU fields to that GPU's fetch worker below */
+        if (m_parallelGpuFetch && watchInfo->practicalEntityGroupId == DCGM_FE_GPU
+            && watchInfo->practicalEntityId < m_numGpus)
         {
-            if (m_gpus[index2].status == DcgmEntityStatusDetached)
-                continue;
+            gpuWatches[watchInfo->practicalEntityId].push_back(watchInfo);
+            anyGpuWatches = 1;
+            continue;
+        }
 
-            int gpuId2 = m_gpus[index2].gpuId;
+        /* Set key information before we call child functions */
+        threadCtx->entityKey.entityGroupId = watchInfo->practicalEntityGroupId;
+        threadCtx->entityKey.entityId      = watchInfo->practicalEntityId;
+        threadCtx->entityKey.fieldId       = watchInfo->watchKey.fieldId;
+        threadCtx->watchInfo               = watchInfo;
 
-            if (m_gpus[index2].arch
-                < DCGM_CHIP_ARCH_PASCAL) // bracket this when NVLINK becomes not available on an arch
+        MarkEnteredDriver();
+
+        /* Unlock the mutex before the driver call, unless we're just buffering a list of field values */
+        mutexReturn = m_mutex->Poll();
+        if ((watchInfo->practicalEntityGroupId != DCGM_FE_GPU || !fieldMeta->nvmlFieldId)
+            && mutexReturn == DCGM_MUTEX_ST_LOCKEDBYME)
+        {
+            dcgm_mutex_unlock(m_mutex);
+            mutexReturn = DCGM_MUTEX_ST_NOTLOCKED;
+        }
+
+        if (watchInfo->practicalEntityGroupId == DCGM_FE_NONE)
+            BufferOrCacheLatestGpuValue(threadCtx, fieldMeta);
+        else if (watchInfo->practicalEntityGroupId == DCGM_FE_GPU)
+        {
+            /* Is this a mapped field? Set aside the info for the field and handle it below */
+            if (fieldMeta->nvmlFieldId > 0)
             {
-                PRINT_DEBUG("", "GPU is older than Pascal");
+                AddGpuFieldValue(threadCtx, watchInfo->practicalEntityId, fieldMeta, watchInfo);
+                anyFieldValues = 1;
+                MarkReturnedFromDriver();
                 continue;
             }
 
-            // all of the paths are stored low GPU to higher GPU (i.e. 0 -> 1, 0 -> 2, 1 -> 2, etc.)
-            // so for NVLINK though the quantity of links will be the same as determined by querying
-            // node 0 or node 1, the link numbers themselves will be different.  Need to store both values.
-            unsigned int localNvLinkQuantity = 0, localNvLinkMask = 0;
-            unsigned int remoteNvLinkMask = 0;
+            BufferOrCacheLatestGpuValue(threadCtx, fieldMeta);
+        }
+        else
+            PRINT_DEBUG("%u", "Unhandled entityGroupId %u", watchInfo->practicalEntityGroupId);
+        /* Resync clock after a value fetch since a driver call may take a while */
+        newNow = timelib_fastUsecSince1970();
 
-            // Assign here instead of 6x below
-            localNvLinkQuantity = gpuNvSwitchLinkCounts[gpuId1];
+        // accumulate the time spent retrieving this field
+        RecordWatchExecTime(watchInfo, newNow - now);
+        now = newNow;
 
-            // fill in localNvLink information
-            for (unsigned localNvLink = 0; localNvLink < NVML_NVLINK_MAX_LINKS; localNvLink++)
-            {
-                /* If we have NvSwitches, those are are only connections */
-                if (gpuNvSwitchLinkCounts[gpuId1] > 0)
-                {
-                    if (linkStatus.gpus[gpuId1].linkState[localNvLink] == DcgmNvLinkLinkStateUp)
-                        localNvLinkMask |= 1 << localNvLink;
-                }
-                else
-                {
-                    nvmlPciInfo_t tempPciInfo;
-                    nvmlReturn_t nvmlReturn
-                        = nvmlDeviceGetNvLinkRemotePciInfo_v2(m_gpus[index1].nvmlDevice, localNvLink, &tempPciInfo);
+        /* Relock the mutex if we need to */
+        if (mutexReturn == DCGM_MUTEX_ST_NOTLOCKED)
+            mutexReturn = dcgm_mutex_lock(m_mutex);
 
-                    /* If the link is not supported, continue with other links */
-                    if (NVML_ERROR_NOT_SUPPORTED == nvmlReturn)
-                    {
-                        PRINT_DEBUG("%d %d", "GPU %d NVLINK %d not supported", gpuId1, localNvLink);
-                        continue;
-                    }
-                    else if (NVML_ERROR_INVALID_ARGUMENT == nvmlReturn)
-                    {
-                        /* This error can be ignored, we've most likely gone past the number of valid NvLinks */
-                        PRINT_DEBUG("%d %d", "GPU %d NVLINK %d not valid", gpuId1, localNvLink);
-                        break;
-                    }
-                    else if (NVML_SUCCESS != nvmlReturn)
-                    {
-                        PRINT_DEBUG("%d %d %d",
-                                    "Unable to retrieve remote PCI info for GPU %d on NVLINK %d. Returns %d",
-                                    gpuId1,
-                                    localNvLink,
-                                    nvmlReturn);
-                        return NvmlReturnToDcgmReturn(nvmlReturn);
-                    }
-                    DCGM_LOG_DEBUG << "Successfully populated topology for GPU " << gpuId1 << " NVLINK " << localNvLink;
-                    if (!strcasecmp(tempPciInfo.busId, m_gpus[index2].pciInfo.busId))
-                    {
-                        localNvLinkQuantity++;
-                        localNvLinkMask |= 1 << localNvLink;
-                    }
-                }
-            }
+        MarkReturnedFromDriver();
+    }
 
-            // fill in remoteNvLink information
-            for (unsigned remoteNvLink = 0; remoteNvLink < NVML_NVLINK_MAX_LINKS; remoteNvLink++)
-            {
-                /* If we have NvSwitches, those are are only connections */
-                if (gpuNvSwitchLinkCounts[gpuId2] > 0)
-                {
-                    if (linkStatus.gpus[gpuId2].linkState[remoteNvLink] == DcgmNvLinkLinkStateUp)
-                        remoteNvLinkMask |= 1 << remoteNvLink;
-                }
-                else
-                {
-                    nvmlPciInfo_t tempPciInfo;
-                    nvmlReturn_t nvmlReturn
-                        = nvmlDeviceGetNvLinkRemotePciInfo_v2(m_gpus[index2].nvmlDevice, remoteNvLink, &tempPciInfo);
+    /* The next wakeup is the head of the schedule */
+    *earliestNextUpdate = m_watchSchedule.NextDueUsec();
 
-                    /* If the link is not supported, continue with other links */
-                    if (NVML_ERROR_NOT_SUPPORTED == nvmlReturn)
-                    {
-                        PRINT_DEBUG("%d %d", "GPU %d NVLINK %d not supported", gpuId1, remoteNvLink);
-                        continue;
-                    }
-                    else if (NVML_ERROR_INVALID_ARGUMENT == nvmlReturn)
-                    {
-                        /* This error can be ignored, we've most likely gone past the number of valid NvLinks */
-                        PRINT_DEBUG("%d %d", "GPU %d NVLINK %d not valid", gpuId1, remoteNvLink);
-                        break;
-                    }
-                    else if (NVML_SUCCESS != nvmlReturn)
-                    {
-                        PRINT_DEBUG("%d %d %d",
-                                    "Unable to retrieve remote PCI info for GPU %d on NVLINK %d. Returns %d",
-                                    gpuId2,
-                                    remoteNvLink,
-                                    nvmlReturn);
-                        return NvmlReturnToDcgmReturn(nvmlReturn);
-                    }
-                    if (!strcasecmp(tempPciInfo.busId, m_gpus[index1].pciInfo.busId))
-                    {
-                        remoteNvLinkMask |= 1 << remoteNvLink;
-                    }
-                }
-            }
+    /* Fetch the snapshot groups first in one tight parallel pass with one timestamp */
+    if (!snapshotGroupsDue.empty())
+    {
+        threadCtx->cycleTimestamp = timelib_usecSince1970();
+        ParallelUpdateGpuFields(threadCtx, snapshotWatches);
+        threadCtx->cycleTimestamp = 0;
+    }
 
-            topology_p->element[elementsFilled].dcgmGpuA      = gpuId1;
-            topology_p->element[elementsFilled].dcgmGpuB      = gpuId2;
-            topology_p->element[elementsFilled].AtoBNvLinkIds = localNvLinkMask;
-            topology_p->element[elementsFilled].BtoANvLinkIds = remoteNvLinkMask;
+    /* The collectors run while the GPUs are fetched below */
+    if (anyCollectorWatches)
+        StartEntityCollectors();
 
-            // NVLINK information for path resides in bits 31:8 so it can fold into the PCI path
-            // easily
-            topology_p->element[elementsFilled].path = (dcgmGpuTopologyLevel_t)((1 << (localNvLinkQuantity - 1)) << 8);
-            elementsFilled++;
+    if (anyGpuWatches)
+        ParallelUpdateGpuFields(threadCtx, gpuWatches);
+
+    if (anyFieldValues)
+    {
+        /* Unlock the mutex before the driver call */
+        mutexReturn = m_mutex->Poll();
+        if (mutexReturn == DCGM_MUTEX_ST_LOCKEDBYME)
+        {
+            dcgm_mutex_unlock(m_mutex);
+            mutexReturn = DCGM_MUTEX_ST_NOTLOCKED;
+        }
+
+        for (unsigned int gpuId = 0; gpuId < threadCtx->fieldValues.size(); gpuId++)
+        {
+            size_t numFieldValues = threadCtx->fieldValues[gpuId].fields.size();
+            if (!numFieldValues)
+                continue;
+
+            PRINT_DEBUG("%zu %u", "Got %zu field value fields for gpuId %u", numFieldValues, gpuId);
+
+            MarkEnteredDriver();
+            ActuallyUpdateGpuFieldValues(threadCtx, gpuId);
+            MarkReturnedFromDriver();
         }
+
+        /* relock the mutex if we need to */
+        if (mutexReturn == DCGM_MUTEX_ST_NOTLOCKED)
+            mutexReturn = dcgm_mutex_lock(m_mutex);
     }
 
-    topology_p->numElements = elementsFilled;
+    if (anyCollectorWatches)
+        FinishEntityCollectors(threadCtx);
+
+    /* Adaptive sampling may have pulled watches in while their values were appended */
+    if (m_adaptiveBaseUsec)
+        *earliestNextUpdate = m_watchSchedule.NextDueUsec();
+
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::CacheTopologyNvLink(dcgmcm_update_thread_t *threadCtx,
-                                                   timelib64_t now,
-                                                   timelib64_t expireTime)
+void DcgmCacheManager::ParallelUpdateGpuFields(dcgmcm_update_thread_t *threadCtx,
+                                               std::vector<dcgmcm_watch_info_p> *gpuWatches)
 {
-    dcgmTopology_t *topology_p = NULL;
-    unsigned int topologySize  = 0;
-    dcgmReturn_t ret           = PopulateTopologyNvLink(&topology_p, topologySize);
+    std::vector<std::shared_future<void>> workers;
+    unsigned int numGpus = m_numGpus;
 
-    if (ret == DCGM_ST_NOT_SUPPORTED && threadCtx->watchInfo)
-        threadCtx->watchInfo->lastStatus = NVML_ERROR_NOT_SUPPORTED;
-
-    AppendEntityBlob(threadCtx, topology_p, topologySize, now, expireTime);
-
-    if (topology_p != NULL)
-        free(topology_p);
-
-    return ret;
-}
-
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::BufferOrCacheLatestVgpuValue(dcgmcm_update_thread_t *threadCtx,
-                                                            nvmlVgpuInstance_t vgpuId,
-                                                            dcgm_field_meta_p fieldMeta)
-{
-    timelib64_t now, expireTime;
-    nvmlReturn_t nvmlReturn;
-
-    if (!threadCtx || !fieldMeta || fieldMeta->scope != DCGM_FS_DEVICE)
-        return DCGM_ST_BADPARAM;
-
-    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
-
-    now = timelib_usecSince1970();
-
-    /* Expiration is either measured in absolute time or 0 */
-    expireTime = 0;
-    if (watchInfo && watchInfo->maxAgeUsec)
-        expireTime = now - watchInfo->maxAgeUsec;
+    /* Unlock the mutex so the workers can cache their values */
+    dcgmMutexReturn_t mutexReturn = m_mutex->Poll();
+    if (mutexReturn == DCGM_MUTEX_ST_LOCKEDBYME)
+    {
+        dcgm_mutex_unlock(m_mutex);
+        mutexReturn = DCGM_MUTEX_ST_NOTLOCKED;
+    }
 
-    /* Set without lock before we possibly return on error so we don't get in a hot
-     * polling loop on something that is unsupported or errors. Not getting the lock
-     * ahead of time because we don't want to hold the lock across a driver call that
-     * could be long */
-    if (watchInfo)
-        watchInfo->lastQueriedUsec = now;
+    /* Only this thread uses the pool, so it's idle and safe to replace if GPUs were added */
+    if (!m_gpuFetchPool || m_gpuFetchPool->GetNumWorkers() < numGpus)
+    {
+        PRINT_DEBUG("%u", "Starting %u GPU fetch workers", numGpus);
+        m_gpuFetchPool = std::make_unique<DcgmNs::ThreadPool>(numGpus);
+    }
+    if (m_gpuFetchCtx.size() < numGpus)
+        m_gpuFetchCtx.resize(numGpus, nullptr);
 
-    switch (fieldMeta->fieldId)
+    for (unsigned int gpuId = 0; gpuId < numGpus; gpuId++)
     {
-        case DCGM_FI_DEV_VGPU_VM_ID:
-        case DCGM_FI_DEV_VGPU_VM_NAME:
-        {
-            char buffer[DCGM_DEVICE_UUID_BUFFER_SIZE];
-            unsigned int bufferSize = DCGM_DEVICE_UUID_BUFFER_SIZE;
-            nvmlVgpuVmIdType_t vmIdType;
+        if (gpuWatches[gpuId].empty())
+            continue;
 
-            nvmlReturn = nvmlVgpuInstanceGetVmID(vgpuId, buffer, bufferSize, &vmIdType);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+        dcgmcm_update_thread_t *gpuCtx = m_gpuFetchCtx[gpuId];
+        if (!gpuCtx)
+        {
+            gpuCtx = new (std::nothrow) dcgmcm_update_thread_t();
+            if (!gpuCtx)
             {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                PRINT_ERROR("%u", "Unable to alloc an update context for gpuId %u", gpuId);
+                continue;
             }
+            InitAndClearThreadCtx(gpuCtx);
+            m_gpuFetchCtx[gpuId] = gpuCtx;
+        }
 
-            if (fieldMeta->fieldId == DCGM_FI_DEV_VGPU_VM_ID)
-            {
-                AppendEntityString(threadCtx, buffer, now, expireTime);
-            }
-            else
-            {
-#if defined(NV_VMWARE)
-                /* Command executed is specific to VMware */
-                snprintf(cmd,
-                         sizeof(cmd),
-                         "localcli vm process list | grep \"World ID: %s\" -B 1 | head -1 | cut -f1 -d ':'",
-                         buffer);
+        ClearThreadCtx(gpuCtx);
+        /* Buffer values on the worker if the update thread is buffering them */
+        if (threadCtx->fvBuffer && !gpuCtx->fvBuffer)
+            gpuCtx->fvBuffer = m_fvBufferPool->Acquire();
+        gpuCtx->bufferForSubscribers = threadCtx->bufferForSubscribers;
+        gpuCtx->cycleTimestamp       = threadCtx->cycleTimestamp;
 
-                if (strlen(cmd) == 0)
-                    return DCGM_ST_NO_DATA;
+        std::vector<dcgmcm_watch_info_p> const &watches = gpuWatches[gpuId];
+        workers.push_back(
+            m_gpuFetchPool->Enqueue([this, gpuCtx, gpuId, &watches]() {
+                PlaceGpuFetchWorker(gpuId);
+                UpdateGpuWatches(gpuCtx, gpuId, watches);
+            }));
+    }
 
-                if (NULL == (fp = popen(cmd, "r")))
-                {
-                    nvmlReturn = NVML_ERROR_NOT_FOUND;
-                    AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                    return NvmlReturnToDcgmReturn(nvmlReturn);
-                }
-                if (fgets(tmp_name, sizeof(tmp_name), fp))
-                {
-                    char *eol = strchr(tmp_name, '\n');
-                    if (eol)
-                        *eol = 0;
-                    AppendEntityString(threadCtx, tmp_name, now, expireTime);
-                }
-                else
-                {
-                    nvmlReturn = NVML_ERROR_NOT_FOUND;
-                    AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                }
-                pclose(fp);
-#else
-                /* Soon to be implemented for other environments. Appending error string for now. */
-                nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-#endif
-            }
-            break;
-        }
+    for (auto &worker : workers)
+    {
+        worker.wait();
+    }
 
-        case DCGM_FI_DEV_VGPU_TYPE:
-        {
-            unsigned int vgpuTypeId = 0;
+    /* Join the workers' results into the update thread's context for UpdateFvSubscribers() */
+    for (unsigned int gpuId = 0; gpuId < numGpus; gpuId++)
+    {
+        dcgmcm_update_thread_t *gpuCtx = m_gpuFetchCtx[gpuId];
+        if (gpuWatches[gpuId].empty() || !gpuCtx)
+            continue;
 
-            nvmlReturn = nvmlVgpuInstanceGetType(vgpuId, &vgpuTypeId);
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                PRINT_ERROR(
-                    "%d %u", "nvmlVgpuInstanceGetType failed with status %d for vgpuId %u", (int)nvmlReturn, vgpuId);
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityInt64(threadCtx, vgpuTypeId, 0, now, expireTime);
-            break;
+        threadCtx->driverCallsSaved += gpuCtx->driverCallsSaved;
+        if (threadCtx->fvBuffer && gpuCtx->fvBuffer)
+            threadCtx->fvBuffer->AppendFvBuffer(gpuCtx->fvBuffer);
+        for (dcgmcm_watch_info_p derivedInfo : gpuCtx->derivedWatches)
+        {
+            if (std::find(threadCtx->derivedWatches.begin(), threadCtx->derivedWatches.end(), derivedInfo)
+                == threadCtx->derivedWatches.end())
+                threadCtx->derivedWatches.push_back(derivedInfo);
         }
 
-        case DCGM_FI_DEV_VGPU_UUID:
+        for (unsigned int i = 0; i < DcgmWatcherTypeCount; i++)
         {
-            char buffer[DCGM_DEVICE_UUID_BUFFER_SIZE];
-            unsigned int bufferSize = DCGM_DEVICE_UUID_BUFFER_SIZE;
+            if (!(gpuCtx->affectedSubscribers & (1 << i)))
+                continue;
 
-            nvmlReturn = nvmlVgpuInstanceGetUUID(vgpuId, buffer, bufferSize);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                PRINT_ERROR(
-                    "%d %u", "nvmlVgpuInstanceGetUUID failed with status %d for vgpuId %u", (int)nvmlReturn, vgpuId);
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityString(threadCtx, buffer, now, expireTime);
-            break;
+            DcgmFvBuffer *&subscriberFvBuffer = threadCtx->subscriberFvBuffers[i];
+            if (!subscriberFvBuffer)
+                subscriberFvBuffer = m_fvBufferPool->Acquire();
+            if (subscriberFvBuffer && subscriberFvBuffer->AppendFvBuffer(gpuCtx->subscriberFvBuffers[i]) == DCGM_ST_OK)
+                threadCtx->affectedSubscribers |= 1 << i;
         }
+    }
 
-        case DCGM_FI_DEV_VGPU_DRIVER_VERSION:
-        {
-            char buffer[DCGM_DEVICE_UUID_BUFFER_SIZE];
-            unsigned int bufferSize = DCGM_DEVICE_UUID_BUFFER_SIZE;
+    /* Relock the mutex if we need to */
+    if (mutexReturn == DCGM_MUTEX_ST_NOTLOCKED)
+        mutexReturn = dcgm_mutex_lock(m_mutex);
+}
 
-            nvmlReturn = nvmlVgpuInstanceGetVmDriverVersion(vgpuId, buffer, bufferSize);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                PRINT_ERROR("%d %u",
-                            "nvmlVgpuInstanceGetVmDriverVersion failed with status %d for vgpuId %u",
-                            (int)nvmlReturn,
-                            vgpuId);
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+/*****************************************************************************/
+bool DcgmCacheManager::GatherSnapshotGroup(unsigned int snapshotGroupId,
+                                           timelib64_t now,
+                                           std::vector<dcgmcm_watch_info_p> *gpuWatches)
+{
+    auto group = m_snapshotGroups.find(snapshotGroupId);
+    if (group == m_snapshotGroups.end())
+        return false;
 
-            if (strcmp("Unknown", buffer))
-            {
-                /* Updating the cache frequency to once every 15 minutes after a known driver version is fetched. */
-                if (watchInfo && watchInfo->monitorFrequencyUsec != 900000000)
-                {
-                    UpdateFieldWatch(watchInfo, 900000000, 900.0, 1, DcgmWatcher(DcgmWatcherTypeCacheManager));
-                    PRINT_ERROR(
-                        "%d %u", "UpdateFieldWatch failed for vgpuId %u and fieldId %d", vgpuId, fieldMeta->fieldId);
-                }
-            }
+    bool anyWatched = false;
 
-            AppendEntityString(threadCtx, buffer, now, expireTime);
-            break;
-        }
+    for (dcgmcm_entity_key_t const &key : group->second.keys)
+    {
+        dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(
+            (dcgm_field_entity_group_t)key.entityGroupId, key.entityId, key.fieldId, 0);
+        if (!watchInfo || !watchInfo->isWatched || watchInfo->snapshotGroupId != snapshotGroupId)
+            continue;
 
-        case DCGM_FI_DEV_VGPU_MEMORY_USAGE:
-        {
-            unsigned long long fbUsage;
+        anyWatched = true;
 
-            nvmlReturn = nvmlVgpuInstanceGetFbUsage(vgpuId, &fbUsage);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                PRINT_ERROR(
-                    "%d %u", "nvmlVgpuInstanceGetFbUsage failed with status %d for vgpuId %u", (int)nvmlReturn, vgpuId);
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            fbUsage = fbUsage / (1024 * 1024);
-            AppendEntityInt64(threadCtx, fbUsage, 0, now, expireTime);
-            break;
-        }
+        /* Every watch of the group is due together from now on */
+        watchInfo->eventPending = 0;
+        ScheduleWatchUpdate(watchInfo, now + GetPollIntervalUsec(watchInfo));
 
-        case DCGM_FI_DEV_VGPU_LICENSE_INSTANCE_STATUS:
+        unsigned int gpuId = watchInfo->practicalEntityId;
+        if (watchInfo->practicalEntityGroupId != DCGM_FE_GPU || gpuId >= m_numGpus
+            || GetGpuStatus(gpuId) != DcgmEntityStatusOk || !DcgmFieldGetById(watchInfo->watchKey.fieldId))
         {
-            unsigned int licenseState;
-
-            nvmlReturn = nvmlVgpuInstanceGetLicenseStatus(vgpuId, &licenseState);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                PRINT_ERROR("%d %u",
-                            "nvmlVgpuInstanceGetLicenseStatus failed with status %d for vgpuId %u",
-                            (int)nvmlReturn,
-                            vgpuId);
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityInt64(threadCtx, licenseState, 0, now, expireTime);
-            break;
+            continue;
         }
 
-        case DCGM_FI_DEV_VGPU_FRAME_RATE_LIMIT:
-        {
-            unsigned int frameRateLimit;
+        gpuWatches[gpuId].push_back(watchInfo);
+    }
 
-            nvmlReturn = nvmlVgpuInstanceGetFrameRateLimit(vgpuId, &frameRateLimit);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                PRINT_ERROR("%d %u",
-                            "nvmlVgpuInstanceGetFrameRateLimit failed with status %d for vgpuId %u",
-                            (int)nvmlReturn,
-                            vgpuId);
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityInt64(threadCtx, frameRateLimit, 0, now, expireTime);
-            break;
-        }
+    if (!anyWatched)
+    {
+        PRINT_DEBUG("%u", "Removing snapshot group %u. None of its watches remain", snapshotGroupId);
+        m_snapshotGroups.erase(group);
+    }
 
-        case DCGM_FI_DEV_VGPU_ENC_STATS:
-        {
-            dcgmDeviceEncStats_t vgpuEncStats;
+    return true;
+}
 
-            nvmlReturn = nvmlVgpuInstanceGetEncoderStats(
-                vgpuId, &vgpuEncStats.sessionCount, &vgpuEncStats.averageFps, &vgpuEncStats.averageLatency);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                memset(&vgpuEncStats, 0, sizeof(vgpuEncStats));
-                AppendEntityBlob(threadCtx, &vgpuEncStats, (int)(sizeof(vgpuEncStats)), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityBlob(threadCtx, &vgpuEncStats, (int)(sizeof(vgpuEncStats)), now, expireTime);
-            break;
-        }
+/*****************************************************************************/
+void DcgmCacheManager::RemoveSnapshotGroup(unsigned int snapshotGroupId)
+{
+    auto group = m_snapshotGroups.find(snapshotGroupId);
+    if (group == m_snapshotGroups.end())
+        return;
 
-        case DCGM_FI_DEV_VGPU_ENC_SESSIONS_INFO:
-        {
-            dcgmDeviceVgpuEncSessions_t *vgpuEncSessionsInfo = NULL;
-            nvmlEncoderSessionInfo_t *sessionInfo            = NULL;
-            unsigned int i, sessionCount = 0;
+    for (dcgmcm_entity_key_t const &key : group->second.keys)
+    {
+        dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(
+            (dcgm_field_entity_group_t)key.entityGroupId, key.entityId, key.fieldId, 0);
+        if (watchInfo && watchInfo->snapshotGroupId == snapshotGroupId)
+            watchInfo->snapshotGroupId = 0;
+    }
 
-            nvmlReturn = nvmlVgpuInstanceGetEncoderSessions(vgpuId, &sessionCount, NULL);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
+    m_snapshotGroups.erase(group);
+}
 
-            sessionInfo = (nvmlEncoderSessionInfo_t *)malloc(sizeof(*sessionInfo) * (sessionCount));
-            if (!sessionInfo)
-            {
-                PRINT_ERROR("%d", "malloc of %d bytes failed", (int)(sizeof(*sessionInfo) * (sessionCount)));
-                return DCGM_ST_MEMORY;
-            }
+/*****************************************************************************/
+void DcgmCacheManager::UpdateGpuWatches(dcgmcm_update_thread_t *threadCtx,
+                                        unsigned int gpuId,
+                                        std::vector<dcgmcm_watch_info_p> const &watches)
+{
+    timelib64_t now, newNow;
 
-            vgpuEncSessionsInfo
-                = (dcgmDeviceVgpuEncSessions_t *)malloc(sizeof(*vgpuEncSessionsInfo) * (sessionCount + 1));
-            if (!vgpuEncSessionsInfo)
+    for (dcgmcm_watch_info_p watchInfo : watches)
+    {
+        /* Checked for NULL by ActuallyUpdateAllFields() */
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(watchInfo->watchKey.fieldId);
+
+        /* Set key information before we call child functions */
+        threadCtx->entityKey.entityGroupId = watchInfo->practicalEntityGroupId;
+        threadCtx->entityKey.entityId      = watchInfo->practicalEntityId;
+        threadCtx->entityKey.fieldId       = watchInfo->watchKey.fieldId;
+        threadCtx->watchInfo               = watchInfo;
+
+        /* Mapped fields are fetched together below */
+        if (fieldMeta->nvmlFieldId > 0)
+        {
+            AddGpuFieldValue(threadCtx, gpuId, fieldMeta, watchInfo);
+            continue;
+        }
+
+        now = timelib_monotonicUsec();
+
+        MarkEnteredDriver();
+        BufferOrCacheLatestGpuValue(threadCtx, fieldMeta);
+        MarkReturnedFromDriver();
+
+        // accumulate the time spent retrieving this field
+        newNow = timelib_monotonicUsec();
+        RecordWatchExecTime(watchInfo, newNow - now);
+    }
+
+    if (gpuId < threadCtx->fieldValues.size() && !threadCtx->fieldValues[gpuId].fields.empty())
+    {
+        PRINT_DEBUG("%zu %u",
+                    "Got %zu field value fields for gpuId %u",
+                    threadCtx->fieldValues[gpuId].fields.size(),
+                    gpuId);
+
+        MarkEnteredDriver();
+        ActuallyUpdateGpuFieldValues(threadCtx, gpuId);
+        MarkReturnedFromDriver();
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::FreeGpuFetchWorkers(void)
+{
+    if (m_gpuFetchPool)
+    {
+        m_gpuFetchPool->StopAndWait();
+        m_gpuFetchPool.reset();
+    }
+
+    for (dcgmcm_update_thread_t *gpuCtx : m_gpuFetchCtx)
+    {
+        if (!gpuCtx)
+            continue;
+        FreeThreadCtx(gpuCtx);
+        delete gpuCtx;
+    }
+    m_gpuFetchCtx.clear();
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::StartEntityCollectors(void)
+{
+    size_t numCollectors = 0;
+
+    for (unsigned int entityGroupId = 0; entityGroupId < DCGM_FE_COUNT; entityGroupId++)
+    {
+        dcgmcm_collector_pass_t &pass = m_collectorPasses[entityGroupId];
+        if (pass.watches.empty())
+            continue;
+
+        pass.collector = m_entityCollectors[entityGroupId];
+        pass.keys.clear();
+        for (dcgmcm_watch_info_p watchInfo : pass.watches)
+        {
+            pass.keys.push_back(watchInfo->watchKey);
+        }
+        pass.fvBuffer.Clear();
+        pass.collectUsec = 0;
+        numCollectors++;
+    }
+
+    /* Only this thread uses the pool, so it's idle and safe to replace */
+    if (!m_collectorPool || m_collectorPool->GetNumWorkers() < numCollectors)
+    {
+        PRINT_DEBUG("%zu", "Starting %zu entity collector workers", numCollectors);
+        m_collectorPool = std::make_unique<DcgmNs::ThreadPool>(numCollectors);
+    }
+
+    for (dcgmcm_collector_pass_t &pass : m_collectorPasses)
+    {
+        if (pass.watches.empty())
+            continue;
+
+        pass.worker = m_collectorPool->Enqueue([&pass]() {
+            timelib64_t start = timelib_monotonicUsec();
+            pass.collector->Collect(pass.keys, pass.fvBuffer);
+            pass.collectUsec = timelib_monotonicUsec() - start;
+        });
+    }
+}
+
+/*****************************************************************************/
+/* watchInfo->lastStatus is an NVML status. Map the statuses of collected values back to one */
+static nvmlReturn_t CollectedStatusToNvmlReturn(int status)
+{
+    switch (status)
+    {
+        case DCGM_ST_OK:
+            return NVML_SUCCESS;
+        case DCGM_ST_NOT_SUPPORTED:
+            return NVML_ERROR_NOT_SUPPORTED;
+        case DCGM_ST_NO_PERMISSION:
+            return NVML_ERROR_NO_PERMISSION;
+        case DCGM_ST_NO_DATA:
+            return NVML_ERROR_NOT_FOUND;
+        case DCGM_ST_TIMEOUT:
+            return NVML_ERROR_TIMEOUT;
+        case DCGM_ST_GPU_IS_LOST:
+            return NVML_ERROR_GPU_IS_LOST;
+        default:
+            return NVML_ERROR_UNKNOWN;
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::FinishEntityCollectors(dcgmcm_update_thread_t *threadCtx)
+{
+    /* Unlock the mutex so collectors can read the cache manager while we wait */
+    dcgmMutexReturn_t mutexReturn = m_mutex->Poll();
+    if (mutexReturn == DCGM_MUTEX_ST_LOCKEDBYME)
+    {
+        dcgm_mutex_unlock(m_mutex);
+        mutexReturn = DCGM_MUTEX_ST_NOTLOCKED;
+    }
+
+    for (dcgmcm_collector_pass_t &pass : m_collectorPasses)
+    {
+        if (pass.worker.valid())
+            pass.worker.wait();
+    }
+
+    if (mutexReturn == DCGM_MUTEX_ST_NOTLOCKED)
+        mutexReturn = dcgm_mutex_lock(m_mutex);
+
+    timelib64_t now = timelib_usecSince1970();
+
+    for (unsigned int entityGroupId = 0; entityGroupId < DCGM_FE_COUNT; entityGroupId++)
+    {
+        dcgmcm_collector_pass_t &pass = m_collectorPasses[entityGroupId];
+        if (pass.watches.empty())
+            continue;
+
+        /* Collectors may return values in any order, so each one is matched to its watch by key */
+        dcgmBufferedFvCursor_t cursor = 0;
+        for (dcgmBufferedFv_t *fv = pass.fvBuffer.GetNextFv(&cursor); fv; fv = pass.fvBuffer.GetNextFv(&cursor))
+        {
+            if (fv->entityGroupId != entityGroupId)
+                continue;
+
+            dcgmcm_watch_info_p watchInfo
+                = GetEntityWatchInfo((dcgm_field_entity_group_t)entityGroupId, fv->entityId, fv->fieldId, 0);
+            if (!watchInfo || !watchInfo->isWatched)
+                continue;
+
+            timelib64_t expireTime = 0;
+            if (watchInfo->maxAgeUsec)
+                expireTime = now - watchInfo->maxAgeUsec;
+
+            watchInfo->lastStatus = CollectedStatusToNvmlReturn(fv->status);
+            threadCtx->watchInfo  = watchInfo;
+            threadCtx->entityKey  = watchInfo->watchKey;
+
+            switch (fv->fieldType)
+            {
+                case DCGM_FT_DOUBLE:
+                    AppendEntityDouble(threadCtx, fv->value.dbl, 0.0, fv->timestamp, expireTime);
+                    break;
+
+                case DCGM_FT_INT64:
+                    AppendEntityInt64(threadCtx, fv->value.i64, 0, fv->timestamp, expireTime);
+                    break;
+
+                case DCGM_FT_STRING:
+                    AppendEntityString(threadCtx, fv->value.str, fv->timestamp, expireTime);
+                    break;
+
+                case DCGM_FT_BINARY:
+                {
+                    size_t valueSize = (size_t)fv->length - (sizeof(*fv) - sizeof(fv->value));
+                    AppendEntityBlob(threadCtx, fv->value.blob, valueSize, fv->timestamp, expireTime);
+                    break;
+                }
+
+                default:
+                    PRINT_ERROR("%u", "Unknown field type: %u", fv->fieldType);
+                    break;
+            }
+        }
+
+        /* The collector fetched its watches together, so they share its time evenly */
+        timelib64_t execTimeUsec = pass.collectUsec / (timelib64_t)pass.watches.size();
+        for (dcgmcm_watch_info_p watchInfo : pass.watches)
+        {
+            RecordWatchExecTime(watchInfo, execTimeUsec);
+        }
+
+        pass.watches.clear();
+        pass.collector.reset();
+        pass.worker = std::shared_future<void>();
+    }
+
+    threadCtx->watchInfo = nullptr;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::FreeEntityCollectorWorkers(void)
+{
+    if (m_collectorPool)
+    {
+        m_collectorPool->StopAndWait();
+        m_collectorPool.reset();
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::UpdateThreadPlacement(void)
+{
+    if (!m_placeThreadsNearGpus)
+    {
+        /* Undo any placement from before it was turned off. The workers undo their own */
+        if (m_haveGpuCpuSets)
+        {
+            m_haveGpuCpuSets = false;
+            m_gpuCpuSets.clear();
+            DcgmNs::PinCurrentThread(m_allowedCpus, m_allowedCpus);
+        }
+        return;
+    }
+    if (m_haveGpuCpuSets && m_gpuCpuSetsGeneration == m_topologyGeneration)
+        return;
+
+    /* Only build the sets once per topology, even if we can't read it */
+    m_haveGpuCpuSets       = true;
+    m_gpuCpuSetsGeneration = m_topologyGeneration;
+    m_gpuCpuSets.clear();
+
+    dcgmAffinity_t affinity {};
+    dcgmReturn_t ret = PopulateTopologyAffinity(affinity);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_WARNING << "Unable to read the CPU affinity of the GPUs. Threads won't be placed near them: "
+                         << errorString(ret);
+        return;
+    }
+
+    cpu_set_t nearAnyGpu;
+    CPU_ZERO(&nearAnyGpu);
+
+    for (unsigned int i = 0; i < affinity.numGpus; i++)
+    {
+        unsigned int gpuId = affinity.affinityMasks[i].dcgmGpuId;
+        if (gpuId >= m_gpuCpuSets.size())
+        {
+            cpu_set_t empty;
+            CPU_ZERO(&empty);
+            m_gpuCpuSets.resize(gpuId + 1, empty);
+        }
+
+        cpu_set_t gpuCpus;
+        DcgmNs::CpuSetFromBitmask(affinity.affinityMasks[i].bitmask, DCGM_AFFINITY_BITMASK_ARRAY_SIZE, gpuCpus);
+        CPU_AND(&m_gpuCpuSets[gpuId], &gpuCpus, &m_allowedCpus);
+        if (CPU_COUNT(&m_gpuCpuSets[gpuId]) == 0)
+        {
+            DCGM_LOG_WARNING << "None of the CPUs near gpuId " << gpuId << " are allowed. Not placing its worker";
+            continue;
+        }
+        CPU_OR(&nearAnyGpu, &nearAnyGpu, &m_gpuCpuSets[gpuId]);
+    }
+
+    /* The update thread fetches whatever the workers don't, so keep it near all of the GPUs */
+    if (CPU_COUNT(&nearAnyGpu) == 0)
+        return;
+    if (!DcgmNs::PinCurrentThread(nearAnyGpu, m_allowedCpus))
+        DCGM_LOG_WARNING << "Unable to pin the cache manager update thread near the GPUs";
+    else
+        DCGM_LOG_DEBUG << "Placed the cache manager update thread on " << CPU_COUNT(&nearAnyGpu) << " CPUs";
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::PlaceGpuFetchWorker(unsigned int gpuId)
+{
+    /* Pool workers take any GPU's work, so only re-pin when this worker's GPU changes.
+       placedBy is nullptr while the worker may run on any allowed CPU */
+    thread_local DcgmCacheManager const *placedBy      = nullptr;
+    thread_local unsigned int placedGpuId              = 0;
+    thread_local unsigned long long placedAtGeneration = 0;
+
+    /* Only the update thread, which is waiting on us, writes these. m_placeThreadsNearGpus isn't read
+       here since it can be set at any time */
+    if (!m_haveGpuCpuSets)
+    {
+        if (placedBy == this && DcgmNs::PinCurrentThread(m_allowedCpus, m_allowedCpus))
+            placedBy = nullptr;
+        return;
+    }
+    if (placedBy == this && placedGpuId == gpuId && placedAtGeneration == m_gpuCpuSetsGeneration)
+        return;
+
+    /* GPUs without any usable CPUs nearby are fetched from anywhere */
+    bool haveCpus         = gpuId < m_gpuCpuSets.size() && CPU_COUNT(&m_gpuCpuSets[gpuId]) > 0;
+    cpu_set_t const &cpus = haveCpus ? m_gpuCpuSets[gpuId] : m_allowedCpus;
+    if (!DcgmNs::PinCurrentThread(cpus, m_allowedCpus))
+        return;
+
+    placedBy           = this;
+    placedGpuId        = gpuId;
+    placedAtGeneration = m_gpuCpuSetsGeneration;
+}
+
+/*****************************************************************************/
+static bool FieldSupportsLiveUpdates(dcgm_field_entity_group_t entityGroupId, unsigned short fieldId)
+{
+    if (entityGroupId != DCGM_FE_NONE && entityGroupId != DCGM_FE_GPU && entityGroupId != DCGM_FE_GPU_I
+        && entityGroupId != DCGM_FE_GPU_CI)
+    {
+        return false;
+    }
+
+    /* Any fieldIds that result in multiple samples need to be excluded from live updates */
+    switch (fieldId)
+    {
+        case DCGM_FI_DEV_SUPPORTED_TYPE_INFO:
+        case DCGM_FI_DEV_GRAPHICS_PIDS:
+        case DCGM_FI_DEV_COMPUTE_PIDS:
+        case DCGM_FI_DEV_GPU_UTIL_SAMPLES:
+        case DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES:
+            return false;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Fields of a MIG instance that aren't just those of its GPU */
+static bool IsMigInstanceField(unsigned short fieldId)
+{
+    return fieldId == DCGM_FI_DEV_NAME || fieldId == DCGM_FI_DEV_CUDA_VISIBLE_DEVICES_STR;
+}
+
+/*****************************************************************************/
+/* Requests for a field of one GPU on behalf of its MIG instances */
+typedef struct
+{
+    std::vector<dcgmGroupEntityPair_t> requesters; /* Instances that asked for the field */
+    bool answered;                                 /* Did the GPU's fetch return a value? */
+} dcgmcm_mig_parent_request_t;
+
+static unsigned long long MigParentKey(unsigned int gpuId, unsigned short fieldId)
+{
+    return ((unsigned long long)gpuId << 16) | fieldId;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetMultipleLatestLiveSamples(std::vector<dcgmGroupEntityPair_t> &entities,
+                                                            std::vector<unsigned short> &fieldIds,
+                                                            DcgmFvBuffer *fvBuffer)
+{
+    std::vector<dcgmGroupEntityPair_t>::iterator entityIt;
+    std::vector<unsigned short>::iterator fieldIdIt;
+    unsigned short fieldId;
+    dcgm_field_meta_p fieldMeta = 0;
+
+    if (!fvBuffer)
+        return DCGM_ST_BADPARAM;
+
+    /* Reads of different GPUs don't have to wait on each other. Give each GPU its own worker */
+    std::map<unsigned int, std::vector<dcgmGroupEntityPair_t>> gpuEntities;
+    std::vector<dcgmGroupEntityPair_t> otherEntities;
+    for (dcgmGroupEntityPair_t const &entity : entities)
+    {
+        if (entity.entityGroupId == DCGM_FE_GPU && GetIsValidEntityId(DCGM_FE_GPU, entity.entityId))
+            gpuEntities[entity.entityId].push_back(entity);
+        else
+            otherEntities.push_back(entity);
+    }
+    if (gpuEntities.size() > 1)
+        return ParallelGetLiveSamples(gpuEntities, otherEntities, fieldIds, fvBuffer);
+
+    /* Allocate a thread context in this function in case we're in a user thread (embeded host engine) */
+
+    dcgmcm_update_thread_t threadCtx;
+    InitAndClearThreadCtx(&threadCtx);
+
+    threadCtx.fvBuffer = fvBuffer;
+
+    /* Most fields of a MIG instance are those of its GPU. Rather than make the same driver calls
+       for every instance, those are fetched once per GPU and field into parentValues with
+       parentCtx, then copied to each instance that asked. parentRequests is keyed by MigParentKey() */
+    dcgmcm_update_thread_t parentCtx;
+    std::unique_ptr<DcgmFvBuffer> parentValues;
+    std::unordered_map<unsigned long long, dcgmcm_mig_parent_request_t> parentRequests;
+
+    /* Note: because we're handling fields that come from the NVML field value APIs out of order
+             from those that don't, we don't guarantee any order of returned results */
+
+    for (entityIt = entities.begin(); entityIt != entities.end(); ++entityIt)
+    {
+        dcgm_field_entity_group_t entityGroupId = (*entityIt).entityGroupId;
+        dcgm_field_eid_t entityId               = (*entityIt).entityId;
+
+        threadCtx.entityKey.entityGroupId = entityGroupId;
+        threadCtx.entityKey.entityId      = entityId;
+
+        for (fieldIdIt = fieldIds.begin(); fieldIdIt != fieldIds.end(); ++fieldIdIt)
+        {
+            fieldId                     = *fieldIdIt;
+            threadCtx.entityKey.fieldId = fieldId;
+            /* Restore entityGroupId since it may have been changed by a previous iteration */
+            entityGroupId = (*entityIt).entityGroupId;
+
+            fieldMeta = DcgmFieldGetById(fieldId);
+            if (!fieldMeta)
+            {
+                PRINT_ERROR("%u", "Invalid field ID %u passed in.", fieldId);
+                fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_UNKNOWN_FIELD);
+                continue;
+            }
+
+            /* Handle if the user accidentally marked this field as an entity field if it's global */
+            if (fieldMeta->scope == DCGM_FS_GLOBAL)
+            {
+                PRINT_DEBUG("%u", "Fixed entityGroupId to be DCGM_FE_NONE fieldId %u", fieldId);
+                entityGroupId = DCGM_FE_NONE;
+            }
+
+            /* Does this entity + fieldId even support live updates?
+               This will filter out VGPUs and NvSwitches */
+            if (!FieldSupportsLiveUpdates(entityGroupId, fieldId))
+            {
+                PRINT_DEBUG("%u %u", "eg %u fieldId %u doesn't support live updates.", entityGroupId, fieldId);
+                fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_FIELD_UNSUPPORTED_BY_API);
+                continue;
+            }
+
+            if (entityGroupId == DCGM_FE_NONE)
+            {
+                BufferOrCacheLatestGpuValue(&threadCtx, fieldMeta);
+            }
+            else if (entityGroupId == DCGM_FE_GPU || entityGroupId == DCGM_FE_GPU_I || entityGroupId == DCGM_FE_GPU_CI)
+            {
+                /* Is the entityId valid? */
+                if (!GetIsValidEntityId(entityGroupId, entityId))
+                {
+                    PRINT_WARNING("%u %u", "Got invalid eg %u, eid %u", entityGroupId, entityId);
+                    fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_BADPARAM);
+                    continue;
+                }
+
+                /* A field of a MIG instance's GPU? Fetch it from the GPU if no other instance has */
+                unsigned int gpuId = entityId;
+                if (entityGroupId != DCGM_FE_GPU && !IsMigInstanceField(fieldId))
+                {
+                    if (GetGpuId(entityGroupId, entityId, gpuId) != DCGM_ST_OK)
+                    {
+                        fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_BADPARAM);
+                        continue;
+                    }
+
+                    dcgmcm_mig_parent_request_t &request = parentRequests[MigParentKey(gpuId, fieldId)];
+                    request.requesters.push_back({ entityGroupId, entityId });
+                    if (request.requesters.size() > 1)
+                        continue;
+
+                    if (!parentValues)
+                    {
+                        parentValues = std::make_unique<DcgmFvBuffer>();
+                        InitAndClearThreadCtx(&parentCtx);
+                        parentCtx.fvBuffer = parentValues.get();
+                    }
+                    parentCtx.entityKey.entityGroupId = DCGM_FE_GPU;
+                    parentCtx.entityKey.entityId      = gpuId;
+                    parentCtx.entityKey.fieldId       = fieldId;
+
+                    if (fieldMeta->nvmlFieldId > 0)
+                        AddGpuFieldValue(&parentCtx, gpuId, fieldMeta, nullptr);
+                    else
+                        BufferOrCacheLatestGpuValue(&parentCtx, fieldMeta);
+                }
+                /* Is this a mapped field? Set aside the info for the field and handle it below */
+                else if (fieldMeta->nvmlFieldId > 0)
+                {
+                    /* Don't cache. Only buffer it */
+                    AddGpuFieldValue(&threadCtx, entityId, fieldMeta, nullptr);
+                }
+                else
+                    BufferOrCacheLatestGpuValue(&threadCtx, fieldMeta);
+            }
+            else
+            {
+                /* Unhandled entity group. Should have been caught by FieldSupportsLiveUpdates() */
+                PRINT_ERROR("%u %u %u",
+                            "Didn't expect to get here for eg %u, eid %u, fieldId %u",
+                            threadCtx.entityKey.entityGroupId,
+                            threadCtx.entityKey.entityId,
+                            fieldId);
+                fvBuffer->AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_FIELD_UNSUPPORTED_BY_API);
+            }
+        }
+
+        /* Handle any field values that come from the NVML FV APIs. Note that entityId could be invalid, so
+           we need to check it */
+        if (entityGroupId == DCGM_FE_GPU && GetIsValidEntityId(entityGroupId, entityId)
+            && entityId < threadCtx.fieldValues.size() && !threadCtx.fieldValues[entityId].fields.empty())
+        {
+            ActuallyUpdateGpuFieldValues(&threadCtx, entityId);
+        }
+    }
+
+    if (parentRequests.empty())
+        return DCGM_ST_OK;
+
+    /* Fetch the mapped fields the instances asked for with one driver call per GPU */
+    for (unsigned int gpuId = 0; gpuId < parentCtx.fieldValues.size(); gpuId++)
+    {
+        if (!parentCtx.fieldValues[gpuId].fields.empty())
+            ActuallyUpdateGpuFieldValues(&parentCtx, gpuId);
+    }
+
+    /* Hand each GPU value to the instances that asked for it */
+    for (dcgmBufferedFv_t const &parentFv : *parentValues)
+    {
+        auto request = parentRequests.find(MigParentKey(parentFv.entityId, parentFv.fieldId));
+        if (parentFv.entityGroupId != DCGM_FE_GPU || request == parentRequests.end())
+            continue;
+
+        request->second.answered = true;
+        for (dcgmGroupEntityPair_t const &requester : request->second.requesters)
+        {
+            dcgmBufferedFv_t *fv = fvBuffer->AddFvCopy(&parentFv);
+            if (fv)
+            {
+                fv->entityGroupId = requester.entityGroupId;
+                fv->entityId      = requester.entityId;
+            }
+        }
+    }
+
+    for (auto const &[key, request] : parentRequests)
+    {
+        if (request.answered)
+            continue;
+        for (dcgmGroupEntityPair_t const &requester : request.requesters)
+        {
+            fvBuffer->AddInt64Value(
+                requester.entityGroupId, requester.entityId, (unsigned short)(key & 0xFFFF), 0, 0, DCGM_ST_NO_DATA);
+        }
+    }
+
+    /* parentValues isn't from m_fvBufferPool */
+    parentCtx.fvBuffer = nullptr;
+    FreeThreadCtx(&parentCtx);
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::ParallelGetLiveSamples(
+    std::map<unsigned int, std::vector<dcgmGroupEntityPair_t>> &gpuEntities,
+    std::vector<dcgmGroupEntityPair_t> &otherEntities,
+    std::vector<unsigned short> &fieldIds,
+    DcgmFvBuffer *fvBuffer)
+{
+    std::shared_ptr<DcgmNs::ThreadPool> pool;
+    {
+        /* Requests come from any thread. A pool that is too small is replaced and freed by its last user */
+        std::lock_guard<std::mutex> lock(m_liveFetchPoolMutex);
+        if (!m_liveFetchPool || m_liveFetchPool->GetNumWorkers() < gpuEntities.size())
+        {
+            PRINT_DEBUG("%zu", "Starting %zu live fetch workers", gpuEntities.size());
+            m_liveFetchPool = std::make_shared<DcgmNs::ThreadPool>(std::max<size_t>(gpuEntities.size(), m_numGpus));
+        }
+        pool = m_liveFetchPool;
+    }
+
+    std::vector<std::unique_ptr<DcgmFvBuffer>> gpuFvBuffers;
+    std::vector<std::shared_future<dcgmReturn_t>> workers;
+    for (auto &[gpuId, gpuEntityList] : gpuEntities)
+    {
+        gpuFvBuffers.push_back(std::make_unique<DcgmFvBuffer>());
+        DcgmFvBuffer *gpuFvBuffer = gpuFvBuffers.back().get();
+        std::vector<dcgmGroupEntityPair_t> *gpuEntityListPtr = &gpuEntityList;
+        workers.push_back(pool->Enqueue([this, gpuEntityListPtr, &fieldIds, gpuFvBuffer]() {
+            /* A single GPU is read on the calling thread */
+            return GetMultipleLatestLiveSamples(*gpuEntityListPtr, fieldIds, gpuFvBuffer);
+        }));
+    }
+
+    /* Global fields and MIG instances are read here while the workers read their GPUs */
+    dcgmReturn_t dcgmReturn = DCGM_ST_OK;
+    if (!otherEntities.empty())
+        dcgmReturn = GetMultipleLatestLiveSamples(otherEntities, fieldIds, fvBuffer);
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        dcgmReturn_t workerReturn = workers[i].get();
+        if (workerReturn != DCGM_ST_OK && dcgmReturn == DCGM_ST_OK)
+            dcgmReturn = workerReturn;
+        fvBuffer->AppendFvBuffer(gpuFvBuffers[i].get());
+    }
+
+    return dcgmReturn;
+}
+
+/*****************************************************************************/
+static double NvmlFieldValueToDouble(nvmlFieldValue_t *v)
+{
+    long long retVal = 0;
+
+    switch (v->valueType)
+    {
+        case NVML_VALUE_TYPE_DOUBLE:
+            return (double)v->value.dVal;
+
+        case NVML_VALUE_TYPE_UNSIGNED_INT:
+            return (double)v->value.uiVal;
+
+        case NVML_VALUE_TYPE_UNSIGNED_LONG:
+            return (double)v->value.ulVal;
+
+        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG:
+            return (double)v->value.ullVal;
+
+        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:
+            return (double)v->value.sllVal;
+
+        default:
+            PRINT_ERROR("%d", "Unhandled valueType: %d", (int)v->valueType);
+            return retVal;
+    }
+
+    return retVal;
+}
+
+/*****************************************************************************/
+long long NvmlFieldValueToInt64(nvmlFieldValue_t *v)
+{
+    long long retVal = 0;
+
+    switch (v->valueType)
+    {
+        case NVML_VALUE_TYPE_DOUBLE:
+            return (long long)v->value.dVal;
+
+        case NVML_VALUE_TYPE_UNSIGNED_INT:
+            return (long long)v->value.uiVal;
+
+        case NVML_VALUE_TYPE_UNSIGNED_LONG:
+            return (long long)v->value.ulVal;
+
+        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG:
+            return (long long)v->value.ullVal;
+
+        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:
+            return (long long)v->value.sllVal;
+
+        default:
+            PRINT_ERROR("%d", "Unhandled valueType: %d", (int)v->valueType);
+            return retVal;
+    }
+
+    return retVal;
+}
+
+void DcgmCacheManager::InsertNvmlErrorValue(dcgmcm_update_thread_t *threadCtx,
+                                            unsigned char fieldType,
+                                            nvmlReturn_t err,
+                                            timelib64_t maxAgeUsec)
+
+{
+    timelib64_t now            = timelib_usecSince1970();
+    timelib64_t oldestKeepTime = 0;
+
+    if (maxAgeUsec)
+        oldestKeepTime = now - maxAgeUsec;
+
+    /* Append a blank value of the correct type for our fieldId */
+    switch (fieldType)
+    {
+        case DCGM_FT_DOUBLE:
+            AppendEntityDouble(threadCtx, NvmlErrorToDoubleValue(err), 0, now, oldestKeepTime);
+            break;
+
+        case DCGM_FT_INT64:
+            AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(err), 0, now, oldestKeepTime);
+            break;
+
+        case DCGM_FT_STRING:
+            AppendEntityString(threadCtx, NvmlErrorToStringValue(err), now, oldestKeepTime);
+            break;
+
+        default:
+            PRINT_ERROR("%c", "Field Type %c is unsupported for conversion from NVML errors", fieldType);
+            break;
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::ActuallyUpdateGpuFieldValues(dcgmcm_update_thread_t *threadCtx, unsigned int gpuId)
+{
+    nvmlFieldValue_t values[NVML_FI_MAX]; /* Place to store actual NVML field values */
+    nvmlFieldValue_t *fv;                 /* Cached field value pointer */
+    int i;
+    nvmlReturn_t nvmlReturn;
+    timelib64_t expireTime;
+
+    if (gpuId >= m_numGpus)
+        return DCGM_ST_GENERIC_ERROR;
+    if (gpuId >= threadCtx->fieldValues.size())
+        return DCGM_ST_OK; /* Nothing was set aside for this GPU */
+
+    /* Make local variables for threadCtx members to simplify the code */
+    int numFields                  = (int)threadCtx->fieldValues[gpuId].fields.size();
+    dcgm_field_meta_p *fieldMeta   = threadCtx->fieldValues[gpuId].fields.data();
+    dcgmcm_watch_info_p *watchInfo = threadCtx->fieldValues[gpuId].watchInfo.data();
+
+    if (numFields >= NVML_FI_MAX)
+    {
+        PRINT_CRITICAL("%d", "numFieldValueFields %d > NVML_FI_MAX", numFields);
+        return DCGM_ST_BADPARAM;
+    }
+
+    /* Initialize the values[] array */
+    memset(&values[0], 0, sizeof(values[0]) * numFields);
+    for (i = 0; i < numFields; i++)
+    {
+        values[i].fieldId = fieldMeta[i]->nvmlFieldId;
+    }
+
+    // Do not attempt to poll NVML for values of detached GPUs
+    if (m_gpus[gpuId].status != DcgmEntityStatusDetached)
+    {
+        /* The fieldId field of fieldValueValues[] was already populated above. Make the NVML call */
+        nvmlReturn = DcgmcmGetFieldValues(m_gpus[gpuId].nvmlDevice, numFields, &values[0], threadCtx->driverCallsSaved);
+        if (nvmlReturn != NVML_SUCCESS)
+        {
+            /* Any given field failure will be on a single fieldValueValues[] entry. A global failure is
+             * unexpected */
+            PRINT_ERROR("%d", "Unexpected NVML return %d from nvmlDeviceGetFieldValues", nvmlReturn);
+            return NvmlReturnToDcgmReturn(nvmlReturn);
+        }
+    }
+
+    /* Set thread context variables that won't change */
+    threadCtx->entityKey.entityGroupId = DCGM_FE_GPU;
+    threadCtx->entityKey.entityId      = gpuId;
+
+    for (i = 0; i < numFields; i++)
+    {
+        fv = &values[i];
+
+        /* Set threadCtx variables before we possibly use them */
+        threadCtx->entityKey.fieldId = fieldMeta[i]->fieldId;
+        threadCtx->watchInfo         = watchInfo[i];
+
+        if (m_gpus[gpuId].status == DcgmEntityStatusDetached)
+        {
+            // Detached GPUs get an intentional NVML error and we're done
+            InsertNvmlErrorValue(threadCtx, fieldMeta[i]->fieldType, NVML_ERROR_GPU_IS_LOST, watchInfo[i]->maxAgeUsec);
+            continue;
+        }
+
+        /* We need a timestamp on every FV or we'll just keep saving it over and over */
+        if (!fv->timestamp)
+        {
+            PRINT_DEBUG("%u %u %i", "gpuId %u, fieldId %u, index %d had a null timestamp.", gpuId, fv->fieldId, i);
+            fv->timestamp = timelib_usecSince1970();
+
+            /* WaR for NVML bug 2009232 where fields ECC can be left uninitialized if ECC is disabled */
+
+            if (!fv->latencyUsec
+                && fv->valueType == NVML_VALUE_TYPE_DOUBLE /* 0 */ && fv->fieldId >= NVML_FI_DEV_ECC_CURRENT
+                && fv->fieldId <= NVML_FI_DEV_RETIRED_PENDING)
+            {
+                if (fv->fieldId > NVML_FI_DEV_ECC_PENDING)
+                    fv->nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
+                else
+                {
+                    /* Read current/pending manually so that they have a valid value */
+                    nvmlEnableState_t currentIsEnabled, pendingIsEnabled;
+                    fv->nvmlReturn
+                        = nvmlDeviceGetEccMode(m_gpus[gpuId].nvmlDevice, &currentIsEnabled, &pendingIsEnabled);
+                    fv->valueType = NVML_VALUE_TYPE_UNSIGNED_LONG_LONG;
+                    if (fv->fieldId == NVML_FI_DEV_ECC_CURRENT)
+                        fv->value.ullVal = currentIsEnabled;
+                    else
+                        fv->value.ullVal = pendingIsEnabled;
+                }
+            }
+        }
+
+        /* Expiration is either measured in absolute time or 0 */
+        expireTime = 0;
+        if (watchInfo[i])
+        {
+            if (watchInfo[i]->maxAgeUsec)
+            {
+                expireTime = fv->timestamp - watchInfo[i]->maxAgeUsec;
+            }
+            RecordWatchExecTime(watchInfo[i], fv->latencyUsec);
+            watchInfo[i]->lastQueriedUsec = fv->timestamp;
+            watchInfo[i]->lastStatus      = fv->nvmlReturn;
+        }
+
+        /* WAR for NVML Bug 2032468. Force the valueType to unsigned long long for ECC fields, because NVML
+         * isn't setting them and it's defaulting to a double which doesn't get stored properly. */
+        if ((threadCtx->entityKey.fieldId <= DCGM_FI_DEV_ECC_DBE_AGG_TEX)
+            && (threadCtx->entityKey.fieldId >= DCGM_FI_DEV_ECC_CURRENT))
+        {
+            fv->valueType = NVML_VALUE_TYPE_UNSIGNED_LONG_LONG;
+        }
+
+        if (fv->nvmlReturn != NVML_SUCCESS)
+        {
+            /* Store an appropriate error for the destination type */
+            timelib64_t maxAgeUsec = 0;
+            if (watchInfo[i])
+                maxAgeUsec = watchInfo[i]->maxAgeUsec;
+            InsertNvmlErrorValue(threadCtx, fieldMeta[i]->fieldType, fv->nvmlReturn, maxAgeUsec);
+        }
+        else /* NVML_SUCCESS */
+        {
+            PRINT_DEBUG("%d", "fieldId %d got good value", fv->fieldId);
+
+            /* Store an appropriate error for the destination type */
+            switch (fieldMeta[i]->fieldType)
+            {
+                case DCGM_FT_INT64:
+                    AppendEntityInt64(threadCtx, NvmlFieldValueToInt64(fv), 0, (timelib64_t)fv->timestamp, expireTime);
+                    break;
+
+                case DCGM_FT_DOUBLE:
+                    AppendEntityDouble(
+                        threadCtx, NvmlFieldValueToDouble(fv), 0.0, (timelib64_t)fv->timestamp, expireTime);
+                    break;
+
+                default:
+                    PRINT_ERROR("%c", "Unhandled field value output type: %c", fieldMeta[i]->fieldType);
+                    break;
+            }
+        }
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::ClearWatchInfo(dcgmcm_watch_info_p watchInfo, int clearCache)
+{
+    if (!watchInfo)
+        return;
+
+    watchInfo->watchers.clear();
+    watchInfo->isWatched            = 0;
+    watchInfo->monitorFrequencyUsec = 0;
+    watchInfo->nextUpdateUsec       = 0;
+    watchInfo->maxAgeUsec           = 0;
+    watchInfo->lastQueriedUsec      = 0;
+    watchInfo->adaptiveSamples      = 0;
+    watchInfo->adaptiveQuiet        = false;
+    if (watchInfo->timeSeries && clearCache)
+    {
+        timeseries_destroy(watchInfo->timeSeries);
+        watchInfo->timeSeries = 0;
+        watchInfo->rollup.reset();
+        watchInfo->windowSummaries.clear();
+        PublishLatestValue(watchInfo);
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::ClearAllEntities(int clearCache)
+{
+    dcgmMutexReturn_t mutexReturn;
+    int numCleared = 0;
+
+    mutexReturn = dcgm_mutex_lock_me(m_mutex);
+
+    /* Walk the watch table and clear every entry */
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        numCleared++;
+        ClearWatchInfo(watchInfo, clearCache);
+    }
+
+    if (mutexReturn == DCGM_MUTEX_ST_OK)
+        dcgm_mutex_unlock(m_mutex);
+
+    PRINT_DEBUG("%d %d", "ClearAllEntities clearCache %d, numCleared %d", clearCache, numCleared);
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::ClearEntity(dcgm_field_entity_group_t entityGroupId,
+                                           dcgm_field_eid_t entityId,
+                                           int clearCache)
+{
+    dcgmMutexReturn_t mutexReturn;
+    int numMatched = 0;
+    int numScanned = 0;
+
+    mutexReturn = dcgm_mutex_lock_me(m_mutex);
+
+    /* Walk the watch table and clear anything that points at this entityGroup + entityId combo */
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        numScanned++;
+
+        if (watchInfo->watchKey.entityGroupId != entityGroupId || watchInfo->watchKey.entityId != entityId)
+        {
+            continue; /* Not a match */
+        }
+
+        numMatched++;
+        ClearWatchInfo(watchInfo, clearCache);
+    }
+
+    if (mutexReturn == DCGM_MUTEX_ST_OK)
+        dcgm_mutex_unlock(m_mutex);
+
+    PRINT_DEBUG("%u %u %d %d %d",
+                "ClearEntity eg %u, eid %u, clearCache %d, "
+                "numScanned %d, numMatched %d",
+                entityGroupId,
+                entityId,
+                clearCache,
+                numScanned,
+                numMatched);
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::RunLockStep(dcgmcm_update_thread_t *threadCtx)
+{
+    bool haveLock               = false;
+    unsigned int sleepAtATimeMs = 10000;
+    timelib64_t earliestNextUpdate, lastWakeupTime, now;
+
+    lastWakeupTime = 0;
+
+    while (!ShouldStop())
+    {
+        if (!haveLock)
+            dcgm_mutex_lock(m_mutex);
+        haveLock = true;
+
+        /* Update runtime stats */
+        m_runStats.numSleepsDone++;
+        m_runStats.lockCount = m_mutex->GetLockCount();
+        m_runStats.sleepTimeUsec += 1000 * ((long long)sleepAtATimeMs);
+        now = timelib_usecSince1970();
+        /* If lastWakeupTime != 0 then we actually work up to do work */
+        if (lastWakeupTime)
+            m_runStats.awakeTimeUsec += now - lastWakeupTime;
+
+#ifdef DEBUG_UPDATE_LOOP
+        PRINT_DEBUG("%u %lld %lld",
+                    "Waiting on m_startUpdateCondition for %u ms. updateCycleFinished %lld. was awake for %lld usec",
+                    sleepAtATimeMs,
+                    m_runStats.updateCycleFinished,
+                    (long long)now - lastWakeupTime);
+#endif
+
+        /* Wait for someone to call UpdateAllFields(). Check if shouldFinishCycle changed before we got the lock.
+         * If so, we need to skip our sleep and do another update cycle */
+        if (m_runStats.updateCycleFinished >= m_runStats.shouldFinishCycle)
+        {
+            m_mutex->CondWait(m_startUpdateCondition, sleepAtATimeMs, [this] {
+                return (m_runStats.updateCycleFinished < m_runStats.shouldFinishCycle) || (ShouldStop() != 0);
+            });
+            if (ShouldStop() != 0)
+            {
+                break;
+            }
+#ifdef DEBUG_UPDATE_LOOP
+            PRINT_DEBUG("%d %lld %lld",
+                        "Woke up to st %d. updateCycleFinished %lld, shouldFinishCycle %lld",
+                        st,
+                        m_runStats.updateCycleFinished,
+                        m_runStats.shouldFinishCycle);
+        }
+        else
+        {
+            PRINT_DEBUG("", "RunLockStep() skipped CondWait()");
+#endif
+        }
+
+
+        if (m_runStats.updateCycleFinished >= m_runStats.shouldFinishCycle)
+        {
+            lastWakeupTime = 0;
+            continue;
+        }
+
+        lastWakeupTime = timelib_usecSince1970();
+
+        DCGM_TRACE_SCOPE("cache", "UpdateCycle");
+        m_runStats.updateCycleStarted++;
+
+        /* Leave the mutex locked throughout the update loop. It will be unlocked before any driver calls */
+
+        /* Buffer live updates only if there are any live subscribers */
+        threadCtx->bufferForSubscribers = m_haveAnyLiveSubscribers ? 1 : 0;
+
+        /* Try to update all fields */
+        earliestNextUpdate = 0;
+        ActuallyUpdateAllFields(threadCtx, &earliestNextUpdate);
+        EnforceCacheMemoryBudget(false);
+
+        m_runStats.lastCycleDriverCallsSaved = threadCtx->driverCallsSaved;
+        m_runStats.driverCallsSaved += threadCtx->driverCallsSaved;
+
+        timelib64_t subscribersStart = timelib_usecSince1970();
+        UpdateFvSubscribers(threadCtx);
+        now                           = timelib_usecSince1970();
+        m_runStats.lastSubscriberUsec = now - subscribersStart;
+        m_runStats.lastCycleUsec      = now - lastWakeupTime;
+
+        m_runStats.updateCycleFinished++;
+#ifdef DEBUG_UPDATE_LOOP
+        PRINT_DEBUG(
+            "%lld", "Setting m_updateCompleteCondition at updateCycleFinished %lld", m_runStats.updateCycleFinished);
+#endif
+        haveLock = false;
+        dcgm_mutex_unlock(m_mutex);
+        /* Let anyone waiting on this update cycle know we're done */
+        m_updateCompleteCondition.notify_all();
+    }
+
+    if (haveLock)
+        dcgm_mutex_unlock(m_mutex);
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::RunTimedWakeup(dcgmcm_update_thread_t *threadCtx)
+{
+    timelib64_t now, maxNextWakeTime, diff, earliestNextUpdate, startOfLoop;
+    timelib64_t wakeTimeInterval = 10000000;
+    unsigned int sleepAtATimeMs  = 1000;
+
+    while (!ShouldStop())
+    {
+        startOfLoop = timelib_usecSince1970();
+        /* Maximum time of 10 second between loops */
+        maxNextWakeTime = startOfLoop + wakeTimeInterval;
+
+        DcgmNs::TraceScope cycleTrace("cache", "UpdateCycle");
+        {
+            DCGM_TRACE_SCOPE("cache", "LockWait");
+            dcgm_mutex_lock(m_mutex);
+        }
+        m_runStats.updateCycleStarted++;
+
+        /* Buffer live updates only if there are any live subscribers */
+        threadCtx->bufferForSubscribers = m_haveAnyLiveSubscribers ? 1 : 0;
+
+        /* Try to update all fields */
+        earliestNextUpdate = 0;
+        ActuallyUpdateAllFields(threadCtx, &earliestNextUpdate);
+        EnforceCacheMemoryBudget(false);
+
+        m_runStats.lastCycleDriverCallsSaved = threadCtx->driverCallsSaved;
+        m_runStats.driverCallsSaved += threadCtx->driverCallsSaved;
+
+        timelib64_t subscribersStart = timelib_usecSince1970();
+        UpdateFvSubscribers(threadCtx);
+        now                           = timelib_usecSince1970();
+        m_runStats.lastSubscriberUsec = now - subscribersStart;
+        m_runStats.lastCycleUsec      = now - startOfLoop;
+
+        m_runStats.updateCycleFinished++;
+        dcgm_mutex_unlock(m_mutex);
+        cycleTrace.End();
+        /* Let anyone waiting on this update cycle know we're done */
+        m_updateCompleteCondition.notify_all();
+
+        /* Resync */
+        now = timelib_usecSince1970();
+        m_runStats.awakeTimeUsec += (now - startOfLoop);
+
+        /* Only bother if we are supposed to sleep for > 100 usec. Sleep takes 60+ usec */
+        /* Are we past our maximum time between loops? */
+        if (now > maxNextWakeTime - 100)
+        {
+            // printf("No sleep. now %lld. maxNextWakeTime %lld\n",
+            //       (long long int)diff, (long long int)maxNextWakeTime);
+            m_runStats.numSleepsSkipped++;
+            continue;
+        }
+
+        /* If we need to update something earlier than max time, sleep until we know
+         * we have to update something
+         */
+        diff = maxNextWakeTime - now;
+        if (earliestNextUpdate && earliestNextUpdate < maxNextWakeTime)
+            diff = earliestNextUpdate - now;
+
+        if (diff < 1000)
+        {
+            // printf("No sleep. diff %lld\n", (long long int)diff);
+            m_runStats.numSleepsSkipped++;
+            continue;
+        }
+
+        sleepAtATimeMs = diff / 1000;
+        m_runStats.sleepTimeUsec += diff;
+        m_runStats.lockCount = m_mutex->GetLockCount();
+        m_runStats.numSleepsDone++;
+        // printf("Sleeping for %u\n", sleepAtATimeMs);
+
+        /* Sleep for diff usec. This is an interruptible wait in case someone calls UpdateAllFields() */
+        dcgm_mutex_lock(m_mutex);
+        m_mutex->CondWait(m_startUpdateCondition, sleepAtATimeMs, [this] {
+            return (m_runStats.updateCycleFinished < m_runStats.shouldFinishCycle) || (ShouldStop() != 0);
+        });
+        /* We don't care about st. Either it timed out or we were woken up. Either way, run
+         * another update loop
+         */
+        dcgm_mutex_unlock(m_mutex);
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::run(void)
+{
+    dcgmcm_update_thread_t *updateThreadCtx;
+
+    updateThreadCtx = new (std::nothrow) dcgmcm_update_thread_t();
+    if (!updateThreadCtx)
+    {
+        PRINT_ERROR("", "Unable to alloc updateThreadCtx. Exiting update thread");
+        return;
+    }
+
+    PRINT_INFO("", "Cache manager update thread starting");
+
+    if (m_pollInLockStep)
+        RunLockStep(updateThreadCtx);
+    else
+        RunTimedWakeup(updateThreadCtx);
+
+    FreeThreadCtx(updateThreadCtx);
+    delete updateThreadCtx;
+    FreeGpuFetchWorkers();
+    FreeEntityCollectorWorkers();
+
+    PRINT_INFO("", "Cache manager update thread ending");
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetCacheManagerFieldInfo(dcgmCacheManagerFieldInfo_t *fieldInfo)
+{
+    dcgmcm_watch_info_p watchInfo = 0;
+    dcgm_field_meta_p fieldMeta   = 0;
+    timeseries_p timeseries       = 0;
+
+    if (!fieldInfo)
+        return DCGM_ST_BADPARAM;
+
+    if (fieldInfo->version != dcgmCacheManagerFieldInfo_version)
+    {
+        PRINT_ERROR("%d %d",
+                    "Got GetCacheManagerFieldInfo ver %d != expected %d",
+                    (int)fieldInfo->version,
+                    (int)dcgmCacheManagerFieldInfo_version);
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    fieldMeta = DcgmFieldGetById(fieldInfo->fieldId);
+    if (!fieldMeta)
+    {
+        PRINT_ERROR("%u", "Invalid fieldId %u passed to GetCacheManagerFieldInfo", (unsigned int)fieldInfo->fieldId);
+        return DCGM_ST_BADPARAM;
+    }
+
+
+    if (fieldMeta->scope == DCGM_FS_ENTITY)
+    {
+        if (fieldInfo->gpuId >= m_numGpus)
+        {
+            PRINT_ERROR("%u", "Invalid gpuId %u passed to GetCacheManagerFieldInfo", fieldInfo->gpuId);
+            return DCGM_ST_BADPARAM;
+        }
+
+        watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, fieldInfo->gpuId, fieldMeta->fieldId, 0);
+    }
+    else
+    {
+        watchInfo = GetGlobalWatchInfo(fieldMeta->fieldId, 0);
+    }
+    if (!watchInfo)
+    {
+        PRINT_DEBUG("", "not watched.");
+        return DCGM_ST_NOT_WATCHED;
+    }
+
+    dcgm_mutex_lock(m_mutex);
+    /* UNLOCK AFTER HERE */
+
+    /* Populate the fields we can */
+    fieldInfo->flags = 0;
+    if (watchInfo->isWatched)
+        fieldInfo->flags |= DCGM_CMI_F_WATCHED;
+    if (IsWatchDecimated(watchInfo))
+        fieldInfo->flags |= DCGM_CMI_F_ADAPTIVE_DECIMATED;
+
+    fieldInfo->version              = dcgmCacheManagerFieldInfo_version;
+    fieldInfo->lastStatus           = (short)watchInfo->lastStatus;
+    fieldInfo->maxAgeUsec           = watchInfo->maxAgeUsec;
+    fieldInfo->monitorFrequencyUsec = watchInfo->monitorFrequencyUsec;
+    fieldInfo->pollIntervalUsec     = GetPollIntervalUsec(watchInfo);
+    fieldInfo->fetchCount           = watchInfo->fetchCount;
+    fieldInfo->execTimeUsec         = watchInfo->execTimeUsec;
+    fieldInfo->lastReadUsec         = watchInfo->lastReadUsec;
+    fieldInfo->bytesUsed            = timeseries_bytes_used(watchInfo->timeSeries);
+
+    fieldInfo->numWatchers = 0;
+    std::vector<dcgm_watch_watcher_info_t>::iterator it;
+    for (it = watchInfo->watchers.begin();
+         it != watchInfo->watchers.end() && fieldInfo->numWatchers < DCGM_CM_FIELD_INFO_NUM_WATCHERS;
+         ++it)
+    {
+        dcgm_cm_field_info_watcher_t *watcher = &fieldInfo->watchers[fieldInfo->numWatchers];
+        watcher->watcherType                  = it->watcher.watcherType;
+        watcher->connectionId                 = it->watcher.connectionId;
+        watcher->monitorFrequencyUsec         = it->monitorFrequencyUsec;
+        watcher->maxAgeUsec                   = it->maxAgeUsec;
+        watcher->bytesUsed                    = fieldInfo->bytesUsed / (long long)watchInfo->watchers.size();
+        fieldInfo->numWatchers++;
+    }
+
+    if (!watchInfo->timeSeries)
+    {
+        /* No values yet */
+        dcgm_mutex_unlock(m_mutex);
+        fieldInfo->newestTimestamp = 0;
+        fieldInfo->oldestTimestamp = 0;
+        fieldInfo->numSamples      = 0;
+        return DCGM_ST_OK;
+    }
+
+    timeseries = watchInfo->timeSeries;
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = 0;
+
+    fieldInfo->numSamples = timeseries_size(timeseries);
+    if (!fieldInfo->numSamples)
+    {
+        /* No values yet */
+        dcgm_mutex_unlock(m_mutex);
+        fieldInfo->newestTimestamp = 0;
+        fieldInfo->oldestTimestamp = 0;
+        return DCGM_ST_OK;
+    }
+
+    /* Get the first and last records to get their timestamps */
+    entry                      = timeseries_first(timeseries, &cursor);
+    fieldInfo->oldestTimestamp = entry == nullptr ? 0 : entry->usecSince1970;
+    entry                      = timeseries_last(timeseries, &cursor);
+    fieldInfo->newestTimestamp = entry->usecSince1970;
+
+    dcgm_mutex_unlock(m_mutex);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+template <typename AddFn>
+void DcgmCacheManager::BufferValue(dcgmcm_update_thread_t *threadCtx,
+                                   dcgmcm_watch_info_p watchInfo,
+                                   timelib64_t timestamp,
+                                   dcgmcm_predicate_value_t const *value,
+                                   AddFn addFn)
+{
+    if (threadCtx->fvBuffer)
+        addFn(*threadCtx->fvBuffer);
+
+    /* Fast path exit if there are no subscribers */
+    if (!threadCtx->bufferForSubscribers || !watchInfo || !watchInfo->hasSubscribedWatchers)
+        return;
+
+    std::shared_ptr<std::vector<dcgmcm_watch_predicate_t>> predicates;
+    if (value)
+        predicates = std::atomic_load(&watchInfo->predicates);
+    unsigned int bypassMask = m_predicateBypassMask.load(std::memory_order_relaxed);
+
+    unsigned int bufferedFor = 0;
+    unsigned int rejectedFor = 0;
+    for (auto &watcherInfo : watchInfo->watchers)
+    {
+        if (!watcherInfo.isSubscribed)
+            continue;
+
+        /* Watchers slower than the watch only get one sample per period of their own */
+        timelib64_t decimationUsec = watcherInfo.monitorFrequencyUsec > watchInfo->monitorFrequencyUsec
+                                         ? watcherInfo.monitorFrequencyUsec
+                                         : 0;
+        if (!IsWatcherDue(decimationUsec, timestamp, watcherInfo.lastBufferedUsec))
+            continue;
+        watcherInfo.lastBufferedUsec = timestamp;
+
+        /* Every connection of a watcher type shares one buffer */
+        unsigned int watcherType = watcherInfo.watcher.watcherType;
+        if ((bufferedFor | rejectedFor) & (1 << watcherType))
+            continue;
+
+        /* Each watcher type's predicate is tested once per value, since it may remember the value */
+        if (predicates && !(bypassMask & (1 << watcherType)))
+        {
+            auto predicateIt = std::find_if(
+                predicates->begin(), predicates->end(), [watcherType](dcgmcm_watch_predicate_t const &p) {
+                    return (unsigned int)p.watcherType == watcherType;
+                });
+            if (predicateIt != predicates->end() && !PredicateMatches(*predicateIt, *value))
+            {
+                rejectedFor |= 1 << watcherType;
+                continue;
+            }
+        }
+        bufferedFor |= 1 << watcherType;
+
+        DcgmFvBuffer *&subscriberFvBuffer = threadCtx->subscriberFvBuffers[watcherType];
+        if (!subscriberFvBuffer)
+        {
+            subscriberFvBuffer = m_fvBufferPool->Acquire();
+            if (!subscriberFvBuffer)
+            {
+                DCGM_LOG_ERROR << "Unable to buffer a live update for watcherType " << watcherType;
+                continue;
+            }
+        }
+
+        addFn(*subscriberFvBuffer);
+        threadCtx->affectedSubscribers |= 1 << watcherType;
+
+        PRINT_DEBUG("%u %u %u %u",
+                    "watcherType %u has a subscribed update to eg %u, eid %u, fieldId %u",
+                    watcherType,
+                    watchInfo->watchKey.entityGroupId,
+                    watchInfo->watchKey.entityId,
+                    watchInfo->watchKey.fieldId);
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AppendEntityDouble(dcgmcm_update_thread_t *threadCtx,
+                                                  double value1,
+                                                  double value2,
+                                                  timelib64_t timestamp,
+                                                  timelib64_t oldestKeepTimestamp)
+{
+    dcgmReturn_t dcgmReturn;
+    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+    dcgmcm_predicate_value_t predicateValue { false, 0, value1 };
+
+    /* Every value of a snapshot pass gets the pass's timestamp */
+    if (threadCtx->cycleTimestamp)
+        timestamp = threadCtx->cycleTimestamp;
+
+    BufferValue(threadCtx, watchInfo, timestamp, &predicateValue, [&](DcgmFvBuffer &fvBuffer) {
+        fvBuffer.AddDoubleValue((dcgm_field_entity_group_t)threadCtx->entityKey.entityGroupId,
+                                threadCtx->entityKey.entityId,
+                                threadCtx->entityKey.fieldId,
+                                value1,
+                                timestamp,
+                                DCGM_ST_OK);
+    });
+
+    /* Should we cache the value? */
+    if (watchInfo)
+    {
+        dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+
+        if (!watchInfo->timeSeries)
+        {
+            dcgmReturn = AllocWatchInfoTimeSeries(watchInfo, TS_TYPE_DOUBLE);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                /* Already logged by AllocWatchInfoTimeSeries. Return the error */
+                dcgm_mutex_unlock(m_mutex);
+                return dcgmReturn;
+            }
+        }
+
+        timeseries_insert_double_coerce(watchInfo->timeSeries, timestamp, value1, value2);
+        if (timestamp > 0)
+            RecordWatchSampleLag(watchInfo, DCGM_INTROSPECT_LAG_CACHE_INSERT, timelib_usecSince1970() - timestamp);
+        if (watchInfo->watchKey.entityGroupId == DCGM_FE_GPU
+            && (watchInfo->watchKey.fieldId == DCGM_FI_DEV_GPU_UTIL_SAMPLES
+                || watchInfo->watchKey.fieldId == DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES))
+        {
+            /* value2 is the PID of value1 */
+            IndexPidSample(
+                watchInfo->watchKey.entityId, watchInfo->watchKey.fieldId, (unsigned int)value2, timestamp, value1);
+        }
+        if (!DCGM_FP64_IS_BLANK(value1))
+        {
+            AppendToRollup(watchInfo, timestamp, value1);
+            if (m_adaptiveBaseUsec)
+                UpdateAdaptiveSampling(watchInfo, value1);
+        }
+        if (!m_summaryWindows.empty())
+            UpdateWindowSummaries(watchInfo, timestamp, nvcmvalue_double_to_int64(value1), value1);
+        if (watchInfo != threadCtx->deferQuotaWatchInfo)
+            EnforceWatchInfoQuota(watchInfo, timestamp, oldestKeepTimestamp);
+        if (!watchInfo->derivedWatchInfos.empty())
+            QueueDerivedFields(threadCtx, watchInfo);
+
+        if (mutexSt == DCGM_MUTEX_ST_OK)
+            dcgm_mutex_unlock(m_mutex);
+    }
+
+    PRINT_DEBUG(
+        "%u %u %u %lld %f %f %d %d",
+        "Appended entity double eg %u, eid %u, fieldId %u, ts %lld, value1 %f, value2 %f, cached %d, buffered %d",
+        threadCtx->entityKey.entityGroupId,
+        threadCtx->entityKey.entityId,
+        threadCtx->entityKey.fieldId,
+        (long long)timestamp,
+        value1,
+        value2,
+        watchInfo ? 1 : 0,
+        threadCtx->fvBuffer ? 1 : 0);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AllocWatchInfoTimeSeries(dcgmcm_watch_info_p watchInfo, int tsType)
+{
+    if (watchInfo->timeSeries)
+        return DCGM_ST_OK; /* Already alloc'd */
+
+    int errorSt = 0;
+
+    if (tsType == TS_TYPE_INT64 || tsType == TS_TYPE_DOUBLE)
+    {
+        /* Numeric fields get a columnar ring buffer sized for the samples we expect to
+           keep so that appends don't allocate. The ring grows if this estimate is low */
+        int initialCapacity = GetWatchInfoRingCapacity(watchInfo);
+
+        if (m_compressHistory && initialCapacity >= DCGM_CM_COMPRESS_MIN_SAMPLES)
+        {
+            /* Long histories of mostly regular, slowly changing values compress well */
+            watchInfo->timeSeries = timeseries_alloc_compressed(tsType, &errorSt);
+            if (!watchInfo->timeSeries)
+            {
+                PRINT_ERROR("%d %d", "timeseries_alloc_compressed(tsType=%d) failed with %d", tsType, errorSt);
+                return DCGM_ST_MEMORY; /* Assuming it's a memory alloc error */
+            }
+
+            return DCGM_ST_OK;
+        }
+
+        watchInfo->timeSeries = timeseries_alloc_ring(tsType, initialCapacity, &errorSt);
+        if (!watchInfo->timeSeries)
+        {
+            PRINT_ERROR("%d %d %d",
+                        "timeseries_alloc_ring(tsType=%d, capacity=%d) failed with %d",
+                        tsType,
+                        initialCapacity,
+                        errorSt);
+            return DCGM_ST_MEMORY; /* Assuming it's a memory alloc error */
+        }
+
+        /* Keep the samples next to the watch. The ring grows within the arena too */
+        if (watchInfo->arena)
+        {
+            errorSt = timeseries_set_allocator(watchInfo->timeSeries, watchInfo->arena->GetTimeseriesAllocator());
+            if (errorSt != TS_ST_OK)
+            {
+                /* The ring stays on the heap */
+                DCGM_LOG_WARNING << "Unable to move the ring of a watch to its arena: " << errorSt;
+            }
+        }
+
+        return DCGM_ST_OK;
+    }
+
+    watchInfo->timeSeries = timeseries_alloc(tsType, &errorSt);
+    if (!watchInfo->timeSeries)
+    {
+        PRINT_ERROR("%d %d", "timeseries_alloc(tsType=%d) failed with %d", tsType, errorSt);
+        return DCGM_ST_MEMORY; /* Assuming it's a memory alloc error */
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+bool DcgmCacheManager::WatchInfoUsesRollups(dcgmcm_watch_info_p watchInfo)
+{
+    if (!watchInfo->watcherTiers.empty())
+        return true;
+    if (m_rollupTiers.empty())
+        return false;
+
+    timelib64_t maxAgeUsec = watchInfo->maxAgeUsec ? watchInfo->maxAgeUsec : m_maxSampleAgeUsec;
+    return maxAgeUsec == 0 || maxAgeUsec > m_rollupRawRetentionUsec;
+}
+
+/*****************************************************************************/
+timelib64_t DcgmCacheManager::GetWatchRawRetentionUsec(dcgmcm_watch_info_p watchInfo)
+{
+    timelib64_t rawRetentionUsec = watchInfo->watcherTiers.empty() ? 0 : watchInfo->rawRetentionUsec;
+    if (m_rollupTiers.empty())
+        return rawRetentionUsec;
+
+    timelib64_t maxAgeUsec = watchInfo->maxAgeUsec ? watchInfo->maxAgeUsec : m_maxSampleAgeUsec;
+    if (maxAgeUsec != 0 && maxAgeUsec <= m_rollupRawRetentionUsec)
+        return rawRetentionUsec;
+
+    return rawRetentionUsec ? std::min(rawRetentionUsec, m_rollupRawRetentionUsec) : m_rollupRawRetentionUsec;
+}
+
+/*****************************************************************************/
+std::vector<dcgmcm_rollup_tier_config_t> DcgmCacheManager::GetWatchRollupTiers(dcgmcm_watch_info_p watchInfo)
+{
+    std::vector<dcgmcm_rollup_tier_config_t> tiers = watchInfo->watcherTiers;
+
+    timelib64_t maxAgeUsec = watchInfo->maxAgeUsec ? watchInfo->maxAgeUsec : m_maxSampleAgeUsec;
+    if (!m_rollupTiers.empty() && (maxAgeUsec == 0 || maxAgeUsec > m_rollupRawRetentionUsec))
+        tiers.insert(tiers.end(), m_rollupTiers.begin(), m_rollupTiers.end());
+
+    DcgmCacheRollup::NormalizeTiers(GetWatchRawRetentionUsec(watchInfo), &tiers);
+    return tiers;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::AppendToRollup(dcgmcm_watch_info_p watchInfo, timelib64_t timestamp, double value)
+{
+    if (!WatchInfoUsesRollups(watchInfo))
+    {
+        watchInfo->rollup.reset();
+        return;
+    }
+
+    if (!watchInfo->rollup)
+        watchInfo->rollup = std::make_shared<DcgmCacheRollup>(GetWatchRollupTiers(watchInfo));
+
+    watchInfo->rollup->Append(timestamp, value);
+}
+
+/*****************************************************************************/
+int DcgmCacheManager::GetRollupSamples(dcgmcm_watch_info_p watchInfo,
+                                       timelib64_t startTime,
+                                       timelib64_t endTime,
+                                       timelib64_t beforeUsec,
+                                       dcgmOrder_t order,
+                                       dcgmcm_sample_p samples,
+                                       int maxSamples)
+{
+    if (!watchInfo->rollup || maxSamples < 1)
+        return 0;
+
+    int tier = watchInfo->rollup->FindTier(startTime);
+    if (tier < 0)
+        return 0;
+
+    std::deque<dcgmcm_rollup_bucket_t> const &buckets = watchInfo->rollup->Buckets(tier);
+
+    auto inRange = [&](dcgmcm_rollup_bucket_t const &bucket) {
+        return bucket.lastUsec < beforeUsec && (!startTime || bucket.lastUsec >= startTime)
+               && (!endTime || bucket.firstUsec <= endTime);
+    };
+    auto toSample = [&](dcgmcm_rollup_bucket_t const &bucket, dcgmcm_sample_p sample) {
+        double average    = bucket.sum / (double)bucket.count;
+        sample->timestamp = std::max(bucket.firstUsec, startTime);
+        sample->val2.i64  = 0;
+        if (watchInfo->timeSeries->tsType == TS_TYPE_INT64)
+            sample->val.i64 = llround(average);
+        else
+            sample->val.d = average;
+    };
+
+    int numSamples = 0;
+    if (order == DCGM_ORDER_ASCENDING)
+    {
+        for (auto it = buckets.begin(); it != buckets.end() && numSamples < maxSamples; ++it)
+        {
+            if (inRange(*it))
+                toSample(*it, &samples[numSamples++]);
+        }
+    }
+    else
+    {
+        for (auto it = buckets.rbegin(); it != buckets.rend() && numSamples < maxSamples; ++it)
+        {
+            if (inRange(*it))
+                toSample(*it, &samples[numSamples++]);
+        }
+    }
+
+    return numSamples;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::SpillAgedSamples(dcgmcm_watch_info_p watchInfo, timelib64_t oldestKeepTimestamp)
+{
+    timeseries_p timeseries = watchInfo->timeSeries;
+    if (!m_spill || oldestKeepTimestamp <= 1
+        || (timeseries->tsType != TS_TYPE_INT64 && timeseries->tsType != TS_TYPE_DOUBLE))
+        return;
+
+    /* Usually the one sample the newest append pushed out */
+    timeseries_entry_t chunk[256];
+    dcgmcm_spill_sample_t spilled[256];
+    timelib64_t chunkStartTime = 0;
+    while (true)
+    {
+        int const numCopied = timeseries_copy_range(
+            timeseries, chunkStartTime, oldestKeepTimestamp - 1, chunk, (int)(sizeof(chunk) / sizeof(chunk[0])));
+        if (numCopied <= 0)
+            break;
+
+        for (int i = 0; i < numCopied; i++)
+        {
+            spilled[i].timestamp = chunk[i].usecSince1970;
+            if (timeseries->tsType == TS_TYPE_INT64)
+                spilled[i].value.i64 = chunk[i].val.i64;
+            else
+                spilled[i].value.dbl = chunk[i].val.dbl;
+        }
+        m_spill->Append(watchInfo->watchKey.entityGroupId,
+                        watchInfo->watchKey.entityId,
+                        watchInfo->watchKey.fieldId,
+                        timeseries->tsType == TS_TYPE_DOUBLE,
+                        spilled,
+                        numCopied);
+
+        if (numCopied < (int)(sizeof(chunk) / sizeof(chunk[0])))
+            break;
+        chunkStartTime = chunk[numCopied - 1].usecSince1970 + 1;
+    }
+}
+
+/*****************************************************************************/
+int DcgmCacheManager::GetSpillSamples(dcgmcm_watch_info_p watchInfo,
+                                      timelib64_t startTime,
+                                      timelib64_t endTime,
+                                      timelib64_t beforeUsec,
+                                      dcgmOrder_t order,
+                                      dcgmcm_sample_p samples,
+                                      int maxSamples)
+{
+    if (!m_spill || maxSamples < 1)
+        return 0;
+
+    std::vector<dcgmcm_spill_sample_t> spilled;
+    bool isDouble     = false;
+    int const numRead = m_spill->Read(watchInfo->watchKey.entityGroupId,
+                                      watchInfo->watchKey.entityId,
+                                      watchInfo->watchKey.fieldId,
+                                      startTime,
+                                      endTime,
+                                      beforeUsec,
+                                      order,
+                                      maxSamples,
+                                      spilled,
+                                      &isDouble);
+
+    for (int i = 0; i < numRead; i++)
+    {
+        samples[i].timestamp = spilled[i].timestamp;
+        samples[i].val2.i64  = 0;
+        if (isDouble)
+            samples[i].val.d = spilled[i].value.dbl;
+        else
+            samples[i].val.i64 = spilled[i].value.i64;
+    }
+
+    return numRead;
+}
+
+/*****************************************************************************/
+int DcgmCacheManager::GetWatchInfoRingCapacity(dcgmcm_watch_info_p watchInfo)
+{
+    timelib64_t maxAgeUsec = watchInfo->maxAgeUsec ? watchInfo->maxAgeUsec : m_maxSampleAgeUsec;
+    if (WatchInfoUsesRollups(watchInfo))
+        maxAgeUsec = GetWatchRawRetentionUsec(watchInfo);
+    timelib64_t capacity   = DCGM_CM_RING_MIN_CAPACITY;
+
+    if (watchInfo->monitorFrequencyUsec > 0 && maxAgeUsec > 0)
+    {
+        /* One extra sample since quota is enforced after the newest sample is appended */
+        capacity = (maxAgeUsec / watchInfo->monitorFrequencyUsec) + 1;
+    }
+
+    return (int)DCGM_MAX((timelib64_t)DCGM_CM_RING_MIN_CAPACITY,
+                         DCGM_MIN(capacity, (timelib64_t)DCGM_CM_RING_MAX_INITIAL_CAPACITY));
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::EnforceWatchInfoQuota(dcgmcm_watch_info_p watchInfo,
+                                                     timelib64_t timestamp,
+                                                     timelib64_t oldestKeepTimestamp)
+{
+    if (!watchInfo || !watchInfo->timeSeries)
+        return DCGM_ST_OK; /* Nothing to do */
+
+    DCGM_TRACE_SCOPE("cache", "EnforceWatchInfoQuota", watchInfo->watchKey.fieldId);
+
+    if (watchInfo->rollup)
+    {
+        /* Older samples are answered from the rollup */
+        timelib64_t maxAgeUsec = watchInfo->maxAgeUsec ? watchInfo->maxAgeUsec : m_maxSampleAgeUsec;
+        watchInfo->rollup->EnforceQuota(timestamp, maxAgeUsec);
+        timelib64_t rawRetentionUsec = GetWatchRawRetentionUsec(watchInfo);
+        if (rawRetentionUsec)
+            oldestKeepTimestamp = std::max(oldestKeepTimestamp, timestamp - rawRetentionUsec);
+    }
+
+    SpillAgedSamples(watchInfo, oldestKeepTimestamp);
+
+    /* Passing count quota as 0 since we enforce quota by time alone */
+    int st = timeseries_enforce_quota(watchInfo->timeSeries, oldestKeepTimestamp, 0);
+
+    /* Every append ends up here, so this is where lock-free readers get the new sample */
+    PublishLatestValue(watchInfo);
+
+    if (st)
+    {
+        PRINT_ERROR("%d", "timeseries_enforce_quota returned %d", st);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::PublishLatestValue(dcgmcm_watch_info_p watchInfo)
+{
+    dcgmcm_latest_value_t &latest = watchInfo->latestValue;
+    int tsType                    = TS_TYPE_UNKNOWN;
+    long long timestamp           = 0;
+    long long val                 = 0;
+    long long val2                = 0;
+
+    timeseries_p timeseries = watchInfo->timeSeries;
+    if (timeseries && (timeseries->tsType == TS_TYPE_INT64 || timeseries->tsType == TS_TYPE_DOUBLE))
+    {
+        timeseries_cursor_t cursor;
+        timeseries_entry_p entry = timeseries_last(timeseries, &cursor);
+        if (entry)
+        {
+            tsType    = timeseries->tsType;
+            timestamp = entry->usecSince1970;
+            /* val and val2 are unions of double and long long, so this covers both types */
+            memcpy(&val, &entry->val, sizeof(val));
+            memcpy(&val2, &entry->val2, sizeof(val2));
+        }
+    }
+
+    unsigned int sequence = latest.sequence.load(std::memory_order_relaxed);
+    latest.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    latest.tsType.store(tsType, std::memory_order_relaxed);
+    latest.timestamp.store(timestamp, std::memory_order_relaxed);
+    latest.val.store(val, std::memory_order_relaxed);
+    latest.val2.store(val2, std::memory_order_relaxed);
+
+    /* Stamp the watch before moving m_updateSequence past it, so that a reader that saw
+       m_updateSequence also sees every watch stamped up to it */
+    unsigned long long updateSequence = m_updateSequence.load(std::memory_order_relaxed) + 1;
+    latest.updateSequence.store(updateSequence, std::memory_order_relaxed);
+
+    latest.sequence.store(sequence + 2, std::memory_order_release);
+    m_updateSequence.store(updateSequence, std::memory_order_release);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AppendEntityInt64(dcgmcm_update_thread_t *threadCtx,
+                                                 long long value1,
+                                                 long long value2,
+                                                 timelib64_t timestamp,
+                                                 timelib64_t oldestKeepTimestamp)
+{
+    dcgmReturn_t dcgmReturn;
+    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+    dcgmcm_predicate_value_t predicateValue { true, value1, 0.0 };
+
+    /* Every value of a snapshot pass gets the pass's timestamp */
+    if (threadCtx->cycleTimestamp)
+        timestamp = threadCtx->cycleTimestamp;
+
+    BufferValue(threadCtx, watchInfo, timestamp, &predicateValue, [&](DcgmFvBuffer &fvBuffer) {
+        fvBuffer.AddInt64Value((dcgm_field_entity_group_t)threadCtx->entityKey.entityGroupId,
+                               threadCtx->entityKey.entityId,
+                               threadCtx->entityKey.fieldId,
+                               value1,
+                               timestamp,
+                               DCGM_ST_OK);
+    });
+
+    if (watchInfo)
+    {
+        dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+
+        if (!watchInfo->timeSeries)
+        {
+            dcgmReturn = AllocWatchInfoTimeSeries(watchInfo, TS_TYPE_INT64);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                /* Already logged by AllocWatchInfoTimeSeries. Return the error */
+                dcgm_mutex_unlock(m_mutex);
+                return dcgmReturn;
+            }
+        }
+
+        timeseries_insert_int64_coerce(watchInfo->timeSeries, timestamp, value1, value2);
+        if (timestamp > 0)
+            RecordWatchSampleLag(watchInfo, DCGM_INTROSPECT_LAG_CACHE_INSERT, timelib_usecSince1970() - timestamp);
+        if (!DCGM_INT64_IS_BLANK(value1))
+        {
+            AppendToRollup(watchInfo, timestamp, (double)value1);
+            if (m_adaptiveBaseUsec)
+                UpdateAdaptiveSampling(watchInfo, (double)value1);
+        }
+        if (!m_summaryWindows.empty())
+            UpdateWindowSummaries(watchInfo, timestamp, value1, nvcmvalue_int64_to_double(value1));
+        if (watchInfo != threadCtx->deferQuotaWatchInfo)
+            EnforceWatchInfoQuota(watchInfo, timestamp, oldestKeepTimestamp);
+        if (watchInfo->rateWatchInfo)
+            AppendCounterRate(threadCtx, watchInfo, value1, timestamp);
+        if (!watchInfo->derivedWatchInfos.empty())
+            QueueDerivedFields(threadCtx, watchInfo);
+
+        if (mutexSt == DCGM_MUTEX_ST_OK)
+            dcgm_mutex_unlock(m_mutex);
+    }
+
+    PRINT_DEBUG(
+        "%u %u %u %lld %lld %lld %d %d",
+        "Appended entity i64 eg %u, eid %u, fieldId %u, ts %lld, value1 %lld, value2 %lld, cached %d, buffered %d",
+        threadCtx->entityKey.entityGroupId,
+        threadCtx->entityKey.entityId,
+        threadCtx->entityKey.fieldId,
+        (long long)timestamp,
+        value1,
+        value2,
+        watchInfo ? 1 : 0,
+        threadCtx->fvBuffer ? 1 : 0);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AppendEntityString(dcgmcm_update_thread_t *threadCtx,
+                                                  char *value,
+                                                  timelib64_t timestamp,
+                                                  timelib64_t oldestKeepTimestamp)
+{
+    dcgmReturn_t dcgmReturn;
+    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+
+    /* Every value of a snapshot pass gets the pass's timestamp */
+    if (threadCtx->cycleTimestamp)
+        timestamp = threadCtx->cycleTimestamp;
+
+    BufferValue(threadCtx, watchInfo, timestamp, nullptr, [&](DcgmFvBuffer &fvBuffer) {
+        fvBuffer.AddStringValue((dcgm_field_entity_group_t)threadCtx->entityKey.entityGroupId,
+                                threadCtx->entityKey.entityId,
+                                threadCtx->entityKey.fieldId,
+                                value,
+                                timestamp,
+                                DCGM_ST_OK);
+    });
+
+    if (watchInfo)
+    {
+        dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+
+        if (!watchInfo->timeSeries)
+        {
+            dcgmReturn = AllocWatchInfoTimeSeries(watchInfo, TS_TYPE_STRING);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                /* Already logged by AllocWatchInfoTimeSeries. Return the error */
+                dcgm_mutex_unlock(m_mutex);
+                return dcgmReturn;
+            }
+        }
+
+        timeseries_insert_string(watchInfo->timeSeries, timestamp, value);
+        if (timestamp > 0)
+            RecordWatchSampleLag(watchInfo, DCGM_INTROSPECT_LAG_CACHE_INSERT, timelib_usecSince1970() - timestamp);
+        if (watchInfo != threadCtx->deferQuotaWatchInfo)
+            EnforceWatchInfoQuota(watchInfo, timestamp, oldestKeepTimestamp);
+
+        if (mutexSt == DCGM_MUTEX_ST_OK)
+            dcgm_mutex_unlock(m_mutex);
+    }
+
+    PRINT_DEBUG("%u %u %u %lld %s %d %d",
+                "Appended entity string eg %u, eid %u, fieldId %u, ts %lld, value \"%s\", cached %d, buffered %d",
+                threadCtx->entityKey.entityGroupId,
+                threadCtx->entityKey.entityId,
+                threadCtx->entityKey.fieldId,
+                (long long)timestamp,
+                value,
+                watchInfo ? 1 : 0,
+                threadCtx->fvBuffer ? 1 : 0);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AppendEntityBlob(dcgmcm_update_thread_t *threadCtx,
+                                                void *value,
+                                                int valueSize,
+                                                timelib64_t timestamp,
+                                                timelib64_t oldestKeepTimestamp)
+{
+    dcgmReturn_t dcgmReturn;
+    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+
+    /* Every value of a snapshot pass gets the pass's timestamp */
+    if (threadCtx->cycleTimestamp)
+        timestamp = threadCtx->cycleTimestamp;
+
+    BufferValue(threadCtx, watchInfo, timestamp, nullptr, [&](DcgmFvBuffer &fvBuffer) {
+        fvBuffer.AddBlobValue((dcgm_field_entity_group_t)threadCtx->entityKey.entityGroupId,
+                              threadCtx->entityKey.entityId,
+                              threadCtx->entityKey.fieldId,
+                              value,
+                              valueSize,
+                              timestamp,
+                              DCGM_ST_OK);
+    });
+
+    if (watchInfo)
+    {
+        dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+
+        if (!watchInfo->timeSeries)
+        {
+            dcgmReturn = AllocWatchInfoTimeSeries(watchInfo, TS_TYPE_BLOB);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                /* Already logged by AllocWatchInfoTimeSeries. Return the error */
+                dcgm_mutex_unlock(m_mutex);
+                return dcgmReturn;
+            }
+        }
+
+        /* Give injected records a known timestamp so they can be indexed */
+        if (!timestamp && threadCtx->entityKey.fieldId == DCGM_FI_DEV_ACCOUNTING_DATA)
+            timestamp = timelib_usecSince1970();
+
+        timeseries_insert_blob(watchInfo->timeSeries, timestamp, value, valueSize);
+        if (timestamp > 0)
+            RecordWatchSampleLag(watchInfo, DCGM_INTROSPECT_LAG_CACHE_INSERT, timelib_usecSince1970() - timestamp);
+        if (threadCtx->entityKey.fieldId == DCGM_FI_DEV_ACCOUNTING_DATA
+            && valueSize == (int)sizeof(dcgmDevicePidAccountingStats_t))
+        {
+            IndexAccountingStats(watchInfo, (dcgmDevicePidAccountingStats_t const *)value, timestamp);
+            IndexPidSample(watchInfo->watchKey.entityId,
+                           DCGM_FI_DEV_ACCOUNTING_DATA,
+                           ((dcgmDevicePidAccountingStats_t const *)value)->pid,
+                           timestamp,
+                           0.0);
+        }
+        else if ((threadCtx->entityKey.fieldId == DCGM_FI_DEV_COMPUTE_PIDS
+                  || threadCtx->entityKey.fieldId == DCGM_FI_DEV_GRAPHICS_PIDS)
+                 && watchInfo->watchKey.entityGroupId == DCGM_FE_GPU
+                 && watchInfo->watchKey.entityId < DCGM_MAX_NUM_DEVICES
+                 && valueSize == (int)sizeof(dcgmRunningProcess_t)
+                 && ((dcgmRunningProcess_t const *)value)->version == dcgmRunningProcess_version)
+        {
+            m_processIntervals[watchInfo->watchKey.entityId][ProcessIntervalsIndex(threadCtx->entityKey.fieldId)]
+                .Extend(((dcgmRunningProcess_t const *)value)->pid, timestamp);
+        }
+
+        int intervalsIndex = ProcessIntervalsIndex(threadCtx->entityKey.fieldId);
+        if (intervalsIndex >= 0 && watchInfo->watchKey.entityGroupId == DCGM_FE_GPU
+            && watchInfo->watchKey.entityId < DCGM_MAX_NUM_DEVICES)
+        {
+            /* Keep the lifetimes as long as the samples */
+            m_processIntervals[watchInfo->watchKey.entityId][intervalsIndex].Trim(oldestKeepTimestamp);
+        }
+        if (watchInfo != threadCtx->deferQuotaWatchInfo)
+            EnforceWatchInfoQuota(watchInfo, timestamp, oldestKeepTimestamp);
+
+        if (mutexSt == DCGM_MUTEX_ST_OK)
+            dcgm_mutex_unlock(m_mutex);
+    }
+
+    PRINT_DEBUG("%u %u %u %lld %d %d %d",
+                "Appended entity blob eg %u, eid %u, fieldId %u, ts %lld, valueSize %d, cached %d, buffered %d",
+                threadCtx->entityKey.entityGroupId,
+                threadCtx->entityKey.entityId,
+                threadCtx->entityKey.fieldId,
+                (long long)timestamp,
+                valueSize,
+                watchInfo ? 1 : 0,
+                threadCtx->fvBuffer ? 1 : 0);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+char *DcgmCacheManager::NvmlErrorToStringValue(nvmlReturn_t nvmlReturn)
+{
+    switch (nvmlReturn)
+    {
+        case NVML_SUCCESS:
+            DCGM_LOG_ERROR << "Called with successful code";
+            break;
+
+        case NVML_ERROR_NOT_SUPPORTED:
+            return (char *)DCGM_STR_NOT_SUPPORTED;
+
+        case NVML_ERROR_NO_PERMISSION:
+            return (char *)DCGM_STR_NOT_PERMISSIONED;
+
+        case NVML_ERROR_NOT_FOUND:
+            return (char *)DCGM_STR_NOT_FOUND;
+
+        default:
+            return (char *)DCGM_STR_BLANK;
+    }
+
+    return (char *)DCGM_STR_BLANK;
+}
+
+/*****************************************************************************/
+long long DcgmCacheManager::NvmlErrorToInt64Value(nvmlReturn_t nvmlReturn)
+{
+    switch (nvmlReturn)
+    {
+        case NVML_SUCCESS:
+            DCGM_LOG_ERROR << "Called with successful code";
+            break;
+
+        case NVML_ERROR_NOT_SUPPORTED:
+            return DCGM_INT64_NOT_SUPPORTED;
+
+        case NVML_ERROR_NO_PERMISSION:
+            return DCGM_INT64_NOT_PERMISSIONED;
+
+        case NVML_ERROR_NOT_FOUND:
+            return DCGM_INT64_NOT_FOUND;
+
+        default:
+            return DCGM_INT64_BLANK;
+    }
+
+    return DCGM_INT64_BLANK;
+}
+
+/*****************************************************************************/
+int DcgmCacheManager::NvmlErrorToInt32Value(nvmlReturn_t nvmlReturn)
+{
+    switch (nvmlReturn)
+    {
+        case NVML_SUCCESS:
+            DCGM_LOG_ERROR << "Called with successful code";
+            break;
+
+        case NVML_ERROR_NOT_SUPPORTED:
+            return DCGM_INT32_NOT_SUPPORTED;
+
+        case NVML_ERROR_NO_PERMISSION:
+            return DCGM_INT32_NOT_PERMISSIONED;
+
+        case NVML_ERROR_NOT_FOUND:
+            return DCGM_INT32_NOT_FOUND;
+
+        default:
+            return DCGM_INT32_BLANK;
+    }
+
+    return DCGM_INT32_BLANK;
+}
+
+/*****************************************************************************/
+double DcgmCacheManager::NvmlErrorToDoubleValue(nvmlReturn_t nvmlReturn)
+{
+    switch (nvmlReturn)
+    {
+        case NVML_SUCCESS:
+            DCGM_LOG_ERROR << "Called with successful code";
+            break;
+
+        case NVML_ERROR_NOT_SUPPORTED:
+            return DCGM_FP64_NOT_SUPPORTED;
+
+        case NVML_ERROR_NO_PERMISSION:
+            return DCGM_FP64_NOT_PERMISSIONED;
+
+        case NVML_ERROR_NOT_FOUND:
+            return DCGM_FP64_NOT_FOUND;
+
+        default:
+            return DCGM_FP64_BLANK;
+    }
+
+    return DCGM_FP64_BLANK;
+}
+
+const unsigned int DCGM_BLANK_ENTITY_ID = 0xFFFFFFFF;
+
+std::optional<unsigned int> DcgmCacheManager::GetGpuIdForEntity(dcgm_field_entity_group_t entityGroupId,
+                                                                dcgm_field_eid_t entityId)
+{
+    switch (entityGroupId)
+    {
+        case DCGM_FE_GPU:
+            return entityId;
+        /* Looked up in m_migManager's maps rather than by walking every instance of every GPU,
+           since this is called per entity */
+        case DCGM_FE_GPU_I:
+        case DCGM_FE_GPU_CI:
+        {
+            unsigned int gpuId = 0;
+            if (GetGpuId(entityGroupId, entityId, gpuId) == DCGM_ST_OK && gpuId < m_numGpus)
+            {
+                return gpuId;
+            }
+            break;
+        }
+        default:
+            return std::nullopt;
+    }
+
+    return std::nullopt;
+}
+
+/*****************************************************************************/
+dcgm_field_eid_t DcgmCacheManager::GetComputeInstanceEntityId(
+    unsigned int gpuId,
+    DcgmNs::Mig::Nvml::ComputeInstanceId const &nvmlComputeInstanceId,
+    DcgmNs::Mig::Nvml::GpuInstanceId const &nvmlGpuInstanceId)
+{
+    DCGM_LOG_DEBUG << "[CacheManager][MIG] Entering GetComputeInstanceEntityId(gpuId: " << gpuId
+                   << ", nvmlComputeInstanceId: " << nvmlComputeInstanceId
+                   << ", nvmlGpuInstanceId: " << nvmlGpuInstanceId << ")";
+
+    for (auto const &instance : m_gpus[gpuId].instances)
+    {
+        if (instance.GetNvmlInstanceId() == nvmlGpuInstanceId)
+        {
+            auto val = instance.ConvertCIIdNvmlToDcgm(nvmlComputeInstanceId);
+            if (!val)
+            {
+                break;
+            }
+            return val.value().id;
+        }
+    }
+
+    DCGM_LOG_ERROR << "[CacheManager][MIG] Unable to find proper entityId for the given nvml values";
+    return DCGM_BLANK_ENTITY_ID;
+}
+
+/*****************************************************************************/
+dcgm_field_eid_t DcgmCacheManager::GetInstanceEntityId(unsigned int gpuId,
+                                                       DcgmNs::Mig::Nvml::GpuInstanceId const &nvmlGpuInstanceId)
+{
+    DCGM_LOG_DEBUG << "[CacheManager][MIG] Entering GetInstanceEntityId(gpuId: " << gpuId
+                   << ", nvmlGpuInstanceId: " << nvmlGpuInstanceId << ")";
+
+    for (auto const &instance : m_gpus[gpuId].instances)
+    {
+        if (instance.GetNvmlInstanceId() == nvmlGpuInstanceId)
+        {
+            return instance.GetInstanceId().id;
+        }
+    }
+
+    DCGM_LOG_ERROR << "[CacheManager][MIG] Unable to find proper entityId for the given nvml values";
+    return DCGM_BLANK_ENTITY_ID;
+}
+
+dcgmMigProfile_t DcgmCacheManager::GetInstanceProfile(unsigned int gpuId,
+                                                      DcgmNs::Mig::Nvml::GpuInstanceId const &nvmlGpuInstanceId)
+{
+    DCGM_LOG_DEBUG << "[CacheManager][MIG] Entering GetInstanceProfile(gpuId: " << gpuId
+                   << ", nvmlGpuInstanceId: " << nvmlGpuInstanceId << ")";
+    for (auto const &instance : m_gpus[gpuId].instances)
+    {
+        if (instance.GetNvmlInstanceId() == nvmlGpuInstanceId)
+        {
+            return instance.GetMigProfileType();
+        }
+    }
+
+    DCGM_LOG_ERROR << "[CacheManager][MIG] Unable to find requested GPU Instance";
+    return DcgmMigProfileNone;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::NotifyMigUpdateSubscribers(unsigned int gpuId)
+{
+    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+
+    /* MIG mode changes which links and GPUs are usable */
+    InvalidateTopology();
+
+    std::vector<dcgmcmEventSubscription_t> localCopy(begin(m_subscriptions[DcgmcmEventTypeMigReconfigure]),
+                                                     end(m_subscriptions[DcgmcmEventTypeMigReconfigure]));
+
+    if (mutexSt != DCGM_MUTEX_ST_LOCKEDBYME)
+        dcgm_mutex_unlock(m_mutex);
+
+    for (auto &&entry : localCopy)
+    {
+        entry.fn.migCb(gpuId, entry.userData);
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::RecordXidForGpu(unsigned int gpuId,
+                                       dcgmcm_update_thread_t &threadCtx,
+                                       long long eventData,
+                                       nvmlReturn_t nvmlReturn,
+                                       timelib64_t now)
+{
+    // If the instance and compute instance IDs are set to blank, that means the XID is
+    // at the GPU level, so store it there.
+    dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_XID_ERRORS, 1);
+    threadCtx.entityKey           = watchInfo->watchKey;
+    threadCtx.watchInfo           = watchInfo;
+    timelib64_t expireTime        = 0;
+    if (watchInfo->maxAgeUsec)
+        expireTime = now - watchInfo->maxAgeUsec;
+
+    /* Only update once we have a valid watchInfo. This is always NVML_SUCCESS
+     * because of the for loop condition */
+    watchInfo->lastStatus = nvmlReturn;
+
+    AppendEntityInt64(&threadCtx, eventData, 0, now, expireTime);
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::RecordXidForComputeInstance(unsigned int gpuId,
+                                                   dcgmcm_update_thread_t &threadCtx,
+                                                   nvmlEventData_t &eventData,
+                                                   nvmlReturn_t nvmlReturn,
+                                                   timelib64_t now)
+{
+    using DcgmNs::Mig::Nvml::ComputeInstanceId;
+    using DcgmNs::Mig::Nvml::GpuInstanceId;
+    // The XID is for a compute instance, find and add it there
+    dcgm_field_eid_t entityId = GetComputeInstanceEntityId(
+        gpuId, ComputeInstanceId { eventData.computeInstanceId }, GpuInstanceId { eventData.gpuInstanceId });
+    if (entityId != DCGM_BLANK_ENTITY_ID)
+    {
+        dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(DCGM_FE_GPU_CI, entityId, DCGM_FI_DEV_XID_ERRORS, 1);
+        if (watchInfo != nullptr)
+        {
+            threadCtx.entityKey    = watchInfo->watchKey;
+            threadCtx.watchInfo    = watchInfo;
+            timelib64_t expireTime = 0;
+            if (watchInfo->maxAgeUsec)
+            {
+                expireTime = now - watchInfo->maxAgeUsec;
+            }
+
+            watchInfo->lastStatus = nvmlReturn;
+
+            AppendEntityInt64(&threadCtx, eventData.eventData, 0, now, expireTime);
+        }
+    }
+    else
+    {
+        DCGM_LOG_DEBUG << "Somehow got XID error for compute instance " << eventData.computeInstanceId
+                       << " and GPU instance " << eventData.gpuInstanceId << " (NVML IDs) which do not exist in DCGM";
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::RecordXidForGpuInstance(unsigned int gpuId,
+                                               dcgmcm_update_thread_t &threadCtx,
+                                               nvmlEventData_t &eventData,
+                                               nvmlReturn_t nvmlReturn,
+                                               timelib64_t now)
+{
+    using DcgmNs::Mig::Nvml::GpuInstanceId;
+    // The XID is for a GPU instance, find and add it there
+    dcgm_field_eid_t entityId = GetInstanceEntityId(gpuId, GpuInstanceId { eventData.gpuInstanceId });
+    if (entityId != DCGM_BLANK_ENTITY_ID)
+    {
+        dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(DCGM_FE_GPU_I, entityId, DCGM_FI_DEV_XID_ERRORS, 1);
+        if (watchInfo != nullptr)
+        {
+            threadCtx.entityKey    = watchInfo->watchKey;
+            threadCtx.watchInfo    = watchInfo;
+            timelib64_t expireTime = 0;
+            if (watchInfo->maxAgeUsec)
+            {
+                expireTime = now - watchInfo->maxAgeUsec;
+            }
+
+            watchInfo->lastStatus = nvmlReturn;
+
+            AppendEntityInt64(&threadCtx, eventData.eventData, 0, now, expireTime);
+        }
+    }
+    else
+    {
+        DCGM_LOG_DEBUG << "Somehow got an XID error for GPU instance " << eventData.gpuInstanceId
+                       << " (NVML ID) which does not exist in DCGM";
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::EventThreadMain(DcgmCacheManagerEventThread *eventThread)
+{
+    nvmlReturn_t nvmlReturn;
+    nvmlEventData_t eventData = {};
+    unsigned int nvmlGpuIndex;
+    timelib64_t now;
+    unsigned int gpuId;
+    int numErrors = 0;
+    dcgmcm_update_thread_t threadCtx;
+    static const unsigned int MIG_RECONFIG_DELAY_TIMEOUT = 10000000; // 10 seconds in microseconds
+    /* How long to block for the first event of a batch. Events wake the wait right away, so this
+       only bounds how long Stop() and detaching from the GPUs wait for this thread */
+    static const unsigned int EVENT_WAIT_TIMEOUT_MS = 500;
+    static const unsigned int MAX_EVENTS_PER_BATCH  = 256; /* Publish at least this often in an event storm */
+
+    InitAndClearThreadCtx(&threadCtx);
+
+    if (!m_nvmlEventSetInitialized)
+    {
+        PRINT_ERROR("", "event set not initialized");
+        Stop(); /* Skip the next loop */
+    }
+
+    auto waitForEvent = [this, &eventData](unsigned int timeoutMs) {
+        nvmlReturn_t ret = nvmlEventSetWait_v2(m_nvmlEventSet, &eventData, timeoutMs);
+        if (ret == NVML_ERROR_NOT_SUPPORTED || ret == NVML_ERROR_FUNCTION_NOT_FOUND)
+        {
+            DCGM_LOG_DEBUG << "nvmlEventSetWait_v2 returned " << ret << ". Calling nvmlEventSetWait";
+            ret = nvmlEventSetWait(m_nvmlEventSet, &eventData, timeoutMs);
+        }
+        return ret;
+    };
+
+    while (!eventThread->ShouldStop())
+    {
+        std::vector<unsigned int> updatedMigGpuIds;
+        /* gpuId and event type of the events whose fields need a fresh read */
+        std::vector<std::pair<unsigned int, unsigned long long>> refreshedEvents;
+        bool gotError = false;
+
+        /* Clear fvBuffer if it exists */
+        ClearThreadCtx(&threadCtx);
+
+        /* Buffer live updates only if there are any live subscribers */
+        threadCtx.bufferForSubscribers = m_haveAnyLiveSubscribers ? 1 : 0;
+
+        MarkEnteredDriver();
+
+        if (!m_nvmlEventSetInitialized)
+        {
+            MarkReturnedFromDriver();
+            Sleep(1000000);
+            continue;
+        }
+
+        /* Block until the driver has an event, then drain everything else it has queued without
+           blocking so that the whole batch is published at once */
+        unsigned int timeoutMs = EVENT_WAIT_TIMEOUT_MS;
+        for (unsigned int numEvents = 0; numEvents < MAX_EVENTS_PER_BATCH; numEvents++, timeoutMs = 0)
+        {
+            nvmlReturn = waitForEvent(timeoutMs);
+            if (nvmlReturn == NVML_ERROR_TIMEOUT)
+            {
+                // This happens often and is expected to. Only log if set to verbose to reduce noise
+                DCGM_LOG_VERBOSE << "nvmlEventSetWait timeout.";
+                break; /* Nothing (else) is queued */
+            }
+            else if (nvmlReturn != NVML_SUCCESS)
+            {
+                PRINT_WARNING("%d", "Got st %d from nvmlEventSetWait", (int)nvmlReturn);
+                numErrors++;
+                if (numErrors >= 1000)
+                {
+                    /* If we get an excessive number of errors, quit instead of spinning in a hot loop
+                       this will cripple event reading, but it will prevent DCGM from using 100% CPU */
+                    PRINT_CRITICAL("%d", "Quitting EventThreadMain() after %d errors.", numErrors);
+                }
+                gotError = true;
+                break;
+            }
+
+            now = timelib_usecSince1970();
+
+            nvmlReturn = nvmlDeviceGetIndex(eventData.device, &nvmlGpuIndex);
+            if (nvmlReturn != NVML_SUCCESS)
+            {
+                PRINT_WARNING("", "Unable to convert device handle to index");
+                continue;
+            }
+
+            gpuId = NvmlIndexToGpuId(nvmlGpuIndex);
+
+            PRINT_DEBUG("%llu %u", "Got nvmlEvent %llu for gpuId %u", eventData.eventType, gpuId);
+
+            switch (eventData.eventType)
+            {
+                case nvmlEventTypeXidCriticalError:
+                    if (!m_driverIsR450OrNewer || m_gpus[gpuId].migEnabled == false)
+                    {
+                        RecordXidForGpu(gpuId, threadCtx, eventData.eventData, nvmlReturn, now);
+                    }
+                    else if (eventData.gpuInstanceId == DCGM_BLANK_ENTITY_ID
+                             && eventData.computeInstanceId == DCGM_BLANK_ENTITY_ID)
+                    {
+                        RecordXidForGpu(gpuId, threadCtx, eventData.eventData, nvmlReturn, now);
+                    }
+                    else if (eventData.computeInstanceId != DCGM_BLANK_ENTITY_ID)
+                    {
+                        RecordXidForComputeInstance(gpuId, threadCtx, eventData, nvmlReturn, now);
+                    }
+                    else
+                    {
+                        RecordXidForGpuInstance(gpuId, threadCtx, eventData, nvmlReturn, now);
+                    }
+                    break;
+
+#if 0 /* TODO: DCGM-1419 */
+                case nvmlEventTypeNVLinkRecoveryError:
+                case nvmlEventTypeNVLinkFatalError:
+                    watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_NVLINK_ERRORS, 1);
+                    threadCtx.entityKey = watchInfo->watchKey;
+                    threadCtx.watchInfo = watchInfo;
+                    expireTime = 0;
+                    if(watchInfo->maxAgeUsec)
+                        expireTime = now - watchInfo->maxAgeUsec;
+
+                    /* Only update once we have a valid watchInfo. This is always NVML_SUCCESS
+                    * because of the for loop condition */
+                    watchInfo->lastStatus = nvmlReturn;
+                    // update eventData with DCGM error type
+                    eventData.eventData = NvmlGpuNVLinkErrorToDcgmError(eventData.eventType);
+                    AppendEntityInt64(&threadCtx, (long long)eventData.eventData, 0,
+                                      now, expireTime);
+                    break;
+#endif
+                case nvmlEventMigConfigChange:
+                    if (std::find(updatedMigGpuIds.begin(), updatedMigGpuIds.end(), gpuId) == updatedMigGpuIds.end())
+                    {
+                        updatedMigGpuIds.push_back(gpuId);
+                    }
+                    break;
+
+                case nvmlEventTypeSingleBitEccError:
+                case nvmlEventTypeDoubleBitEccError:
+                case nvmlEventTypePState:
+                {
+                    std::pair<unsigned int, unsigned long long> refreshed { gpuId, eventData.eventType };
+                    if (std::find(refreshedEvents.begin(), refreshedEvents.end(), refreshed) == refreshedEvents.end())
+                    {
+                        refreshedEvents.push_back(refreshed);
+                    }
+                    break;
+                }
+
+                default:
+                    PRINT_WARNING("%llX", "Unhandled event type %llX", eventData.eventType);
+                    break;
+            }
+        }
+
+        /* Publish the XIDs right away, ahead of the slower MIG and refresh handling and without
+           waiting for an update cycle */
+        UpdateFvSubscribers(&threadCtx);
+
+        for (unsigned int migGpuId : updatedMigGpuIds)
+        {
+            dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
+            // If the user has requested that we delay processing this event within a reasonable timeout,
+            // then do so.
+            dcgmReturn_t ret = DCGM_ST_OK;
+            if (timelib_usecSince1970() - m_delayedMigReconfigProcessingTimestamp >= MIG_RECONFIG_DELAY_TIMEOUT)
+            {
+                ret = InitializeGpuInstances(m_gpus[migGpuId]);
+            }
+            if (mutexSt != DCGM_MUTEX_ST_LOCKEDBYME)
+                dcgm_mutex_unlock(m_mutex);
+
+            if (ret != DCGM_ST_OK)
+            {
+                DCGM_LOG_ERROR << "Coult not re-initialize MIG information for GPU " << migGpuId << ": "
+                               << errorString(ret);
+            }
+        }
+
+        MarkReturnedFromDriver();
+
+        for (unsigned int migGpuId : updatedMigGpuIds)
+        {
+            NotifyMigUpdateSubscribers(migGpuId);
+        }
+
+        for (auto const &refreshed : refreshedEvents)
+        {
+            RefreshEventBackedWatches(refreshed.first, refreshed.second);
+        }
+
+        if (gotError)
+        {
+            Sleep(1000000);
+        }
+    }
+
+    FreeThreadCtx(&threadCtx);
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::InvalidateTopology(void)
+{
+    DcgmLockGuard dlg(m_mutex);
+
+    m_topologyGeneration++;
+    m_nvLinkTopology.clear();
+    m_haveCpuAffinity = false;
+    m_topologySelections.clear();
+    m_topologySelector = nullptr;
+    m_haveMigHierarchy = false;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::PopulateTopologyAffinity(dcgmAffinity_t &affinity)
+{
+    unsigned long long generation;
+
+    {
+        DcgmLockGuard dlg(m_mutex);
+        if (m_haveCpuAffinity)
+        {
+            affinity = m_cpuAffinity;
+            return DCGM_ST_OK;
+        }
+        generation = m_topologyGeneration;
+    }
+
+    dcgmReturn_t ret = ComputeTopologyAffinity(affinity);
+    if (ret != DCGM_ST_OK)
+        return ret;
+
+    DcgmLockGuard dlg(m_mutex);
+    if (generation == m_topologyGeneration)
+    {
+        m_cpuAffinity     = affinity;
+        m_haveCpuAffinity = true;
+    }
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::ComputeTopologyAffinity(dcgmAffinity_t &affinity)
+{
+    unsigned int elementsFilled = 0;
+
+    for (unsigned int index = 0; index < m_numGpus; index++)
+    {
+        if (m_gpus[index].status == DcgmEntityStatusDetached)
+            continue;
+
+        nvmlReturn_t nvmlReturn = nvmlDeviceGetCpuAffinity(
+            m_gpus[index].nvmlDevice, DCGM_AFFINITY_BITMASK_ARRAY_SIZE, affinity.affinityMasks[elementsFilled].bitmask);
+        if (NVML_SUCCESS != nvmlReturn)
+            return NvmlReturnToDcgmReturn(nvmlReturn);
+        affinity.affinityMasks[elementsFilled].dcgmGpuId = NvmlIndexToGpuId(index);
+
+        elementsFilled++;
+    }
+    affinity.numGpus = elementsFilled;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::CacheTopologyAffinity(dcgmcm_update_thread_t *threadCtx,
+                                                     timelib64_t now,
+                                                     timelib64_t expireTime)
+{
+    dcgmAffinity_t affinity = {};
+    PopulateTopologyAffinity(affinity);
+
+    AppendEntityBlob(threadCtx, &affinity, sizeof(dcgmAffinity_t), now, expireTime);
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::HelperGetActiveNvSwitchNvLinkCountsForAllGpusUsingNVML(
+    std::vector<unsigned int> &gpuCounts)
+{
+    nvmlFieldValue_t value = {};
+    for (unsigned int i = 0; i < m_numGpus; i++)
+    {
+        if (m_gpus[i].status == DcgmEntityStatusDetached)
+        {
+            continue;
+        }
+
+        DCGM_LOG_DEBUG << "Getting CONNECTED_LINK_COUNT for GPU " << i;
+
+        // Check for NVSwitch connectivity.
+        // We assume all-to-all connectivity in presence of NVSwitch.
+        value.fieldId           = NVML_FI_DEV_NVSWITCH_CONNECTED_LINK_COUNT;
+        nvmlReturn_t nvmlReturn = nvmlDeviceGetFieldValues(m_gpus[i].nvmlDevice, 1, &value);
+        if (nvmlReturn != NVML_SUCCESS || value.nvmlReturn == NVML_ERROR_INVALID_ARGUMENT)
+        {
+            DCGM_LOG_DEBUG << "DeviceGetFieldValues gpu " << m_gpus[i].gpuId << " failed with nvmlRet " << nvmlReturn
+                           << ", value.nvmlReturn " << value.nvmlReturn << ". Is the driver >= r460?";
+            return DCGM_ST_NOT_SUPPORTED;
+        }
+        else if (value.nvmlReturn != NVML_SUCCESS)
+        {
+            DCGM_LOG_DEBUG << "NvSwitch link count returned nvml status " << nvmlReturn << " for gpu "
+                           << m_gpus[i].gpuId;
+            continue;
+        }
+
+        gpuCounts[i] = value.value.uiVal;
+        DCGM_LOG_DEBUG << "GPU " << m_gpus[i].gpuId << " has " << value.value.uiVal << " active NvSwitch NvLinks.";
+    }
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::HelperGetActiveNvSwitchNvLinkCountsForAllGpusUsingNSCQ(
+    std::vector<unsigned int> &gpuCounts)
+{
+    std::vector<dcgmGroupEntityPair_t> entities;
+    dcgmReturn_t ret = DcgmHostEngineHandler::Instance()->GetAllEntitiesOfEntityGroup(1, DCGM_FE_SWITCH, entities);
+
+    if (ret == DCGM_ST_MODULE_NOT_LOADED)
+    {
+        /* no switches detected */
+        return DCGM_ST_OK;
+    }
+    else if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Could not query NvSwitches: " << ret;
+        return ret;
+    }
+
+    if (entities.size() <= 0)
+    {
+        DCGM_LOG_DEBUG << "No NvSwitches detected.";
+        return DCGM_ST_OK;
+    }
+
+    for (unsigned int i = 0; i < m_numGpus; i++)
+    {
+        if (m_gpus[i].status == DcgmEntityStatusDetached)
+            continue;
+
+        for (unsigned int j = 0; j < DCGM_NVLINK_MAX_LINKS_PER_GPU; j++)
+        {
+            if (m_gpus[i].nvLinkLinkState[j] == DcgmNvLinkLinkStateUp)
+                gpuCounts[i]++;
+        }
+
+        DCGM_LOG_DEBUG << "GPU " << i << " is connected to " << gpuCounts[i] << " GPUs by NvSwitches.";
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetActiveNvSwitchNvLinkCountsForAllGpus(std::vector<unsigned int> &gpuCounts)
+{
+    if (gpuCounts.size() < m_numGpus)
+    {
+        return DCGM_ST_INSUFFICIENT_SIZE;
+    }
+
+    gpuCounts = {};
+
+    // Attempt to query through NVML. This is not supported in all drivers so
+    // there is a fallback approach below
+    if (HelperGetActiveNvSwitchNvLinkCountsForAllGpusUsingNVML(gpuCounts) == DCGM_ST_OK)
+    {
+        return DCGM_ST_OK;
+    }
+
+    DCGM_LOG_DEBUG << "Failed to query NVLink counts using NVML. Falling back to NSCQ";
+
+    // Failed to fetch link counts using NVML. Fall back to NSCQ.
+    return HelperGetActiveNvSwitchNvLinkCountsForAllGpusUsingNSCQ(gpuCounts);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::PopulateTopologyNvLink(dcgmTopology_t **topology_pp, unsigned int &topologySize)
+{
+    unsigned long long generation;
+
+    {
+        DcgmLockGuard dlg(m_mutex);
+        if (!m_nvLinkTopology.empty())
+        {
+            *topology_pp = (dcgmTopology_t *)malloc(m_nvLinkTopology.size());
+            if (!*topology_pp)
             {
-                PRINT_ERROR(
-                    "%d", "malloc of %d bytes failed", (int)(sizeof(*vgpuEncSessionsInfo) * (sessionCount + 1)));
-                free(sessionInfo);
+                DCGM_LOG_ERROR << "Out of memory";
                 return DCGM_ST_MEMORY;
             }
+            memcpy(*topology_pp, m_nvLinkTopology.data(), m_nvLinkTopology.size());
+            topologySize = m_nvLinkTopology.size();
+            return DCGM_ST_OK;
+        }
+        generation = m_topologyGeneration;
+    }
 
-            if (nvmlReturn != NVML_SUCCESS)
+    dcgmReturn_t ret = ComputeTopologyNvLink(topology_pp, topologySize);
+    if (ret != DCGM_ST_OK)
+        return ret;
+
+    DcgmLockGuard dlg(m_mutex);
+    if (generation == m_topologyGeneration)
+    {
+        char const *topology = (char const *)*topology_pp;
+        m_nvLinkTopology.assign(topology, topology + topologySize);
+    }
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::ComputeTopologyNvLink(dcgmTopology_t **topology_pp, unsigned int &topologySize)
+{
+    dcgmTopology_t *topology_p;
+    unsigned int elementArraySize = 0;
+    unsigned int elementsFilled   = 0;
+    std::vector<unsigned int> gpuNvSwitchLinkCounts(DCGM_MAX_NUM_DEVICES);
+    dcgmNvLinkStatus_v2 linkStatus;
+
+    if (m_numGpus < 2)
+    {
+        PRINT_DEBUG("", "Two devices not detected on this system");
+        return (DCGM_ST_NOT_SUPPORTED);
+    }
+
+    /* Find out how many NvSwitches each GPU is connected to */
+    GetActiveNvSwitchNvLinkCountsForAllGpus(gpuNvSwitchLinkCounts);
+
+    // arithmetic series formula to calc number of combinations
+    elementArraySize = (unsigned int)((float)(m_numGpus - 1.0) * (1.0 + ((float)m_numGpus - 2.0) / 2.0));
+
+    // this is intended to minimize how much we're storing since we rarely will need all 120 entries in the element
+    // array
+    topologySize = sizeof(dcgmTopology_t) - (sizeof(dcgmTopologyElement_t) * DCGM_TOPOLOGY_MAX_ELEMENTS)
+                   + elementArraySize * sizeof(dcgmTopologyElement_t);
+
+    topology_p = (dcgmTopology_t *)calloc(1, topologySize);
+    if (!topology_p)
+    {
+        DCGM_LOG_ERROR << "Out of memory";
+        return DCGM_ST_MEMORY;
+    }
+
+    *topology_pp = topology_p;
+
+    /* Get the status of each GPU's NvLinks. We will use this to generate the link mask when
+     * gpuNvSwitchLinkCounts[x] is nonzero */
+    memset(&linkStatus, 0, sizeof(linkStatus));
+    PopulateNvLinkLinkStatus(linkStatus);
+
+    topology_p->version = dcgmTopology_version1;
+    for (unsigned int index1 = 0; index1 < m_numGpus; index1++)
+    {
+        if (m_gpus[index1].status == DcgmEntityStatusDetached)
+            continue;
+
+        int gpuId1 = m_gpus[index1].gpuId;
+
+        if (m_gpus[index1].arch < DCGM_CHIP_ARCH_PASCAL) // bracket this when NVLINK becomes not available on an arch
+        {
+            PRINT_DEBUG("%d", "GPU %d is older than Pascal", gpuId1);
+            continue;
+        }
+
+        for (unsigned int index2 = index1 + 1; index2 < m_numGpus; index2++)
+        {
+            if (m_gpus[index2].status == DcgmEntityStatusDetached)
+                continue;
+
+            int gpuId2 = m_gpus[index2].gpuId;
+
+            if (m_gpus[index2].arch
+                < DCGM_CHIP_ARCH_PASCAL) // bracket this when NVLINK becomes not available on an arch
             {
-                vgpuEncSessionsInfo[0].encoderSessionInfo.sessionCount = 0;
-                AppendEntityBlob(threadCtx,
-                                 vgpuEncSessionsInfo,
-                                 (int)(sizeof(*vgpuEncSessionsInfo) * (sessionCount + 1)),
-                                 now,
-                                 expireTime);
-                free(sessionInfo);
-                free(vgpuEncSessionsInfo);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                PRINT_DEBUG("", "GPU is older than Pascal");
+                continue;
             }
 
-            if (sessionCount != 0)
+            // all of the paths are stored low GPU to higher GPU (i.e. 0 -> 1, 0 -> 2, 1 -> 2, etc.)
+            // so for NVLINK though the quantity of links will be the same as determined by querying
+            // node 0 or node 1, the link numbers themselves will be different.  Need to store both values.
+            unsigned int localNvLinkQuantity = 0, localNvLinkMask = 0;
+            unsigned int remoteNvLinkMask = 0;
+
+            // Assign here instead of 6x below
+            localNvLinkQuantity = gpuNvSwitchLinkCounts[gpuId1];
+
+            // fill in localNvLink information
+            for (unsigned localNvLink = 0; localNvLink < NVML_NVLINK_MAX_LINKS; localNvLink++)
             {
-                nvmlReturn = nvmlVgpuInstanceGetEncoderSessions(vgpuId, &sessionCount, sessionInfo);
-                if (watchInfo)
-                    watchInfo->lastStatus = nvmlReturn;
-                if (nvmlReturn != NVML_SUCCESS)
+                /* If we have NvSwitches, those are are only connections */
+                if (gpuNvSwitchLinkCounts[gpuId1] > 0)
                 {
-                    PRINT_ERROR("%d %u",
-                                "nvmlVgpuInstanceGetEncoderSessions failed with status %d for vgpuId %d",
-                                (int)nvmlReturn,
-                                vgpuId);
-                    free(sessionInfo);
-                    free(vgpuEncSessionsInfo);
-                    return NvmlReturnToDcgmReturn(nvmlReturn);
+                    if (linkStatus.gpus[gpuId1].linkState[localNvLink] == DcgmNvLinkLinkStateUp)
+                        localNvLinkMask |= 1 << localNvLink;
                 }
-            }
-
-            /* First element of the array holds the count */
-            vgpuEncSessionsInfo[0].encoderSessionInfo.sessionCount = sessionCount;
+                else
+                {
+                    nvmlPciInfo_t tempPciInfo;
+                    nvmlReturn_t nvmlReturn
+                        = nvmlDeviceGetNvLinkRemotePciInfo_v2(m_gpus[index1].nvmlDevice, localNvLink, &tempPciInfo);
 
-            for (i = 0; i < sessionCount; i++)
-            {
-                vgpuEncSessionsInfo[i + 1].encoderSessionInfo.vgpuId = sessionInfo[i].vgpuInstance;
-                vgpuEncSessionsInfo[i + 1].sessionId                 = sessionInfo[i].sessionId;
-                vgpuEncSessionsInfo[i + 1].pid                       = sessionInfo[i].pid;
-                vgpuEncSessionsInfo[i + 1].codecType                 = (dcgmEncoderType_t)sessionInfo[i].codecType;
-                vgpuEncSessionsInfo[i + 1].hResolution               = sessionInfo[i].hResolution;
-                vgpuEncSessionsInfo[i + 1].vResolution               = sessionInfo[i].vResolution;
-                vgpuEncSessionsInfo[i + 1].averageFps                = sessionInfo[i].averageFps;
-                vgpuEncSessionsInfo[i + 1].averageLatency            = sessionInfo[i].averageLatency;
+                    /* If the link is not supported, continue with other links */
+                    if (NVML_ERROR_NOT_SUPPORTED == nvmlReturn)
+                    {
+                        PRINT_DEBUG("%d %d", "GPU %d NVLINK %d not supported", gpuId1, localNvLink);
+                        continue;
+                    }
+                    else if (NVML_ERROR_INVALID_ARGUMENT == nvmlReturn)
+                    {
+                        /* This error can be ignored, we've most likely gone past the number of valid NvLinks */
+                        PRINT_DEBUG("%d %d", "GPU %d NVLINK %d not valid", gpuId1, localNvLink);
+                        break;
+                    }
+                    else if (NVML_SUCCESS != nvmlReturn)
+                    {
+                        PRINT_DEBUG("%d %d %d",
+                                    "Unable to retrieve remote PCI info for GPU %d on NVLINK %d. Returns %d",
+                                    gpuId1,
+                                    localNvLink,
+                                    nvmlReturn);
+                        return NvmlReturnToDcgmReturn(nvmlReturn);
+                    }
+                    DCGM_LOG_DEBUG << "Successfully populated topology for GPU " << gpuId1 << " NVLINK " << localNvLink;
+                    if (!strcasecmp(tempPciInfo.busId, m_gpus[index2].pciInfo.busId))
+                    {
+                        localNvLinkQuantity++;
+                        localNvLinkMask |= 1 << localNvLink;
+                    }
+                }
             }
-            AppendEntityBlob(threadCtx,
-                             vgpuEncSessionsInfo,
-                             (int)(sizeof(*vgpuEncSessionsInfo) * (sessionCount + 1)),
-                             now,
-                             expireTime);
-            free(sessionInfo);
-            free(vgpuEncSessionsInfo);
-            break;
-        }
-
-        case DCGM_FI_DEV_VGPU_FBC_STATS:
-        {
-            dcgmDeviceFbcStats_t vgpuFbcStats;
-            nvmlFBCStats_t fbcStats;
 
-            nvmlReturn = nvmlVgpuInstanceGetFBCStats(vgpuId, &fbcStats);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
+            // fill in remoteNvLink information
+            for (unsigned remoteNvLink = 0; remoteNvLink < NVML_NVLINK_MAX_LINKS; remoteNvLink++)
             {
-                PRINT_ERROR("%d %u",
-                            "nvmlVgpuInstanceGetFBCStats failed with status %d for vgpuId %u",
-                            (int)nvmlReturn,
-                            vgpuId);
-                memset(&vgpuFbcStats, 0, sizeof(vgpuFbcStats));
-                AppendEntityBlob(threadCtx, &vgpuFbcStats, (int)(sizeof(vgpuFbcStats)), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+                /* If we have NvSwitches, those are are only connections */
+                if (gpuNvSwitchLinkCounts[gpuId2] > 0)
+                {
+                    if (linkStatus.gpus[gpuId2].linkState[remoteNvLink] == DcgmNvLinkLinkStateUp)
+                        remoteNvLinkMask |= 1 << remoteNvLink;
+                }
+                else
+                {
+                    nvmlPciInfo_t tempPciInfo;
+                    nvmlReturn_t nvmlReturn
+                        = nvmlDeviceGetNvLinkRemotePciInfo_v2(m_gpus[index2].nvmlDevice, remoteNvLink, &tempPciInfo);
 
-            vgpuFbcStats.version        = dcgmDeviceFbcStats_version;
-            vgpuFbcStats.sessionCount   = fbcStats.sessionsCount;
-            vgpuFbcStats.averageFps     = fbcStats.averageFPS;
-            vgpuFbcStats.averageLatency = fbcStats.averageLatency;
+                    /* If the link is not supported, continue with other links */
+                    if (NVML_ERROR_NOT_SUPPORTED == nvmlReturn)
+                    {
+                        PRINT_DEBUG("%d %d", "GPU %d NVLINK %d not supported", gpuId1, remoteNvLink);
+                        continue;
+                    }
+                    else if (NVML_ERROR_INVALID_ARGUMENT == nvmlReturn)
+                    {
+                        /* This error can be ignored, we've most likely gone past the number of valid NvLinks */
+                        PRINT_DEBUG("%d %d", "GPU %d NVLINK %d not valid", gpuId1, remoteNvLink);
+                        break;
+                    }
+                    else if (NVML_SUCCESS != nvmlReturn)
+                    {
+                        PRINT_DEBUG("%d %d %d",
+                                    "Unable to retrieve remote PCI info for GPU %d on NVLINK %d. Returns %d",
+                                    gpuId2,
+                                    remoteNvLink,
+                                    nvmlReturn);
+                        return NvmlReturnToDcgmReturn(nvmlReturn);
+                    }
+                    if (!strcasecmp(tempPciInfo.busId, m_gpus[index1].pciInfo.busId))
+                    {
+                        remoteNvLinkMask |= 1 << remoteNvLink;
+                    }
+                }
+            }
 
-            AppendEntityBlob(threadCtx, &vgpuFbcStats, (int)(sizeof(vgpuFbcStats)), now, expireTime);
-            break;
-        }
+            topology_p->element[elementsFilled].dcgmGpuA      = gpuId1;
+            topology_p->element[elementsFilled].dcgmGpuB      = gpuId2;
+            topology_p->element[elementsFilled].AtoBNvLinkIds = localNvLinkMask;
+            topology_p->element[elementsFilled].BtoANvLinkIds = remoteNvLinkMask;
 
-        case DCGM_FI_DEV_VGPU_FBC_SESSIONS_INFO:
-        {
-            dcgmReturn_t status = GetVgpuInstanceFBCSessionsInfo(vgpuId, threadCtx, watchInfo, now, expireTime);
-            if (DCGM_ST_OK != status)
-                return status;
-            break;
+            // NVLINK information for path resides in bits 31:8 so it can fold into the PCI path
+            // easily
+            topology_p->element[elementsFilled].path = (dcgmGpuTopologyLevel_t)((1 << (localNvLinkQuantity - 1)) << 8);
+            elementsFilled++;
         }
-
-        default:
-            PRINT_WARNING("%d", "Unimplemented fieldId: %d", (int)fieldMeta->fieldId);
-            return DCGM_ST_GENERIC_ERROR;
     }
 
+    topology_p->numElements = elementsFilled;
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetGpuId(unsigned int entityGroupId, unsigned int entityId, unsigned int &gpuId)
+dcgmReturn_t DcgmCacheManager::CacheTopologyNvLink(dcgmcm_update_thread_t *threadCtx,
+                                                   timelib64_t now,
+                                                   timelib64_t expireTime)
 {
-    dcgmReturn_t ret = DCGM_ST_OK;
+    dcgmTopology_t *topology_p = NULL;
+    unsigned int topologySize  = 0;
 
-    switch (entityGroupId)
+    /* Catch NvLink state changes, which invalidate the cached topology */
+    for (unsigned int gpuId = 0; gpuId < m_numGpus; gpuId++)
     {
-        case DCGM_FE_GPU_I:
-        {
-            ret = m_migManager.GetGpuIdFromInstanceId(DcgmNs::Mig::GpuInstanceId { entityId }, gpuId);
-            break;
-        }
+        if (m_gpus[gpuId].status != DcgmEntityStatusDetached)
+            UpdateNvLinkLinkState(gpuId);
+    }
 
-        case DCGM_FE_GPU_CI:
-        {
-            ret = m_migManager.GetGpuIdFromComputeInstanceId(DcgmNs::Mig::ComputeInstanceId { entityId }, gpuId);
-            break;
-        }
+    dcgmReturn_t ret = PopulateTopologyNvLink(&topology_p, topologySize);
 
-        case DCGM_FE_GPU:
-        default:
-            // Just copy the entityId
-            gpuId = entityId;
-            break;
-    }
+    if (ret == DCGM_ST_NOT_SUPPORTED && threadCtx->watchInfo)
+        threadCtx->watchInfo->lastStatus = NVML_ERROR_NOT_SUPPORTED;
+
+    AppendEntityBlob(threadCtx, topology_p, topologySize, now, expireTime);
+
+    if (topology_p != NULL)
+        free(topology_p);
 
     return ret;
 }
 
 /*****************************************************************************/
-void DcgmCacheManager::GenerateCudaVisibleDevicesValue(unsigned int gpuId,
-                                                       unsigned int entityGroupId,
-                                                       unsigned int entityId,
-                                                       std::stringstream &valbuf)
+dcgmReturn_t DcgmCacheManager::BufferOrCacheLatestVgpuValue(dcgmcm_update_thread_t *threadCtx,
+                                                            nvmlVgpuInstance_t vgpuId,
+                                                            dcgm_field_meta_p fieldMeta)
 {
-    valbuf.str("");
+    timelib64_t now, expireTime;
+    nvmlReturn_t nvmlReturn;
 
-    switch (entityGroupId)
+    if (!threadCtx || !fieldMeta || fieldMeta->scope != DCGM_FS_DEVICE)
+        return DCGM_ST_BADPARAM;
+
+    DCGM_TRACE_SCOPE("driver", "VgpuFieldValue", fieldMeta->fieldId);
+
+    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+
+    now = timelib_fastUsecSince1970();
+
+    /* Expiration is either measured in absolute time or 0 */
+    expireTime = 0;
+    if (watchInfo && watchInfo->maxAgeUsec)
+        expireTime = now - watchInfo->maxAgeUsec;
+
+    /* Set without lock before we possibly return on error so we don't get in a hot
+     * polling loop on something that is unsupported or errors. Not getting the lock
+     * ahead of time because we don't want to hold the lock across a driver call that
+     * could be long */
+    if (watchInfo)
+        watchInfo->lastQueriedUsec = now;
+
+    /* Copy the instance's cached metadata out, since ManageVgpuList() can free its node
+       once m_mutex is released */
+    dcgmcm_vgpu_info_t vgpuInfo {};
+    unsigned int gpuId = 0;
+    bool haveVgpuInfo  = false;
     {
-        case DCGM_FE_GPU:
+        DcgmLockGuard dlg(m_mutex);
+        dcgmcm_vgpu_info_p node = FindVgpuInfo(vgpuId, gpuId);
+        if (node)
         {
-            if (entityId >= m_numGpus)
+            vgpuInfo     = *node;
+            haveVgpuInfo = true;
+        }
+    }
+
+    /* Save metadata fetched from NVML in the instance's node, if it still has one */
+    auto updateVgpuInfo = [this, vgpuId](auto const &update) {
+        DcgmLockGuard dlg(m_mutex);
+        unsigned int nodeGpuId;
+        dcgmcm_vgpu_info_p node = FindVgpuInfo(vgpuId, nodeGpuId);
+        if (node)
+            update(*node);
+    };
+
+    switch (fieldMeta->fieldId)
+    {
+        case DCGM_FI_DEV_VGPU_VM_ID:
+        case DCGM_FI_DEV_VGPU_VM_NAME:
+        {
+            char buffer[DCGM_DEVICE_UUID_BUFFER_SIZE];
+            unsigned int bufferSize = DCGM_DEVICE_UUID_BUFFER_SIZE;
+            nvmlVgpuVmIdType_t vmIdType;
+
+            if (vgpuInfo.haveVmId)
             {
-                valbuf << "Invalid GPU id: " << entityId;
-                DCGM_LOG_ERROR << "Cannot create CUDA_VISIBLE_DEVICES value for GPU: " << valbuf.str();
+                SafeCopyTo(buffer, vgpuInfo.vmId);
+                if (watchInfo)
+                    watchInfo->lastStatus = NVML_SUCCESS;
             }
             else
             {
-                const char *uuid = m_gpus[gpuId].uuid;
-
-                if (std::strncmp(uuid, "GPU-", 4) == 0)
-                {
-                    uuid += 4;
-                }
-
-                if (IsGpuMigEnabled(gpuId))
+                nvmlReturn = nvmlVgpuInstanceGetVmID(vgpuId, buffer, bufferSize, &vmIdType);
+                if (watchInfo)
+                    watchInfo->lastStatus = nvmlReturn;
+                if (nvmlReturn != NVML_SUCCESS)
                 {
-                    valbuf << "MIG-";
+                    AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
+                    return NvmlReturnToDcgmReturn(nvmlReturn);
                 }
 
-                valbuf << "GPU-" << uuid;
-            }
-            break;
-        }
-        case DCGM_FE_GPU_I:
-        {
-            unsigned int localGIIndex = entityId % m_gpus[gpuId].maxGpcs;
-            const char *uuid          = m_gpus[gpuId].uuid;
-
-            if (std::strncmp(uuid, "GPU-", 4) == 0)
-            {
-                uuid += 4;
+                updateVgpuInfo([&buffer](dcgmcm_vgpu_info_t &node) {
+                    SafeCopyTo(node.vmId, buffer);
+                    node.haveVmId = true;
+                });
             }
 
-            valbuf << "MIG-GPU-" << uuid << "/" << m_gpus[gpuId].instances[localGIIndex].GetNvmlInstanceId().id;
-            break;
-        }
-        case DCGM_FE_GPU_CI:
-        {
-            DcgmNs::Mig::GpuInstanceId gpuInstanceId {};
-            dcgmReturn_t ret
-                = m_migManager.GetCIParentIds(DcgmNs::Mig::ComputeInstanceId { entityId }, gpuId, gpuInstanceId);
-            if (ret != DCGM_ST_OK)
+            if (fieldMeta->fieldId == DCGM_FI_DEV_VGPU_VM_ID)
             {
-                valbuf << errorString(ret);
-                DCGM_LOG_ERROR << "Cannot create CUDA_VISIBLE_DEVICES value for compute instance " << entityId << ": "
-                               << valbuf.str();
+                AppendEntityString(threadCtx, buffer, now, expireTime);
             }
             else
             {
-                unsigned int localGIIndex = gpuInstanceId.id % m_gpus[gpuId].maxGpcs;
-                dcgmcm_gpu_compute_instance_t ci {};
-                ret = m_gpus[gpuId].instances[localGIIndex].GetComputeInstanceById(
-                    DcgmNs::Mig::ComputeInstanceId { entityId }, ci);
-                if (ret == DCGM_ST_OK)
-                {
-                    const char *uuid = m_gpus[gpuId].uuid;
+#if defined(NV_VMWARE)
+                /* Command executed is specific to VMware */
+                snprintf(cmd,
+                         sizeof(cmd),
+                         "localcli vm process list | grep \"World ID: %s\" -B 1 | head -1 | cut -f1 -d ':'",
+                         buffer);
 
-                    if (std::strncmp(uuid, "GPU-", 4) == 0)
-                    {
-                        uuid += 4;
-                    }
+                if (strlen(cmd) == 0)
+                    return DCGM_ST_NO_DATA;
 
-                    valbuf << "MIG-GPU-" << uuid << "/" << m_gpus[gpuId].instances[localGIIndex].GetNvmlInstanceId().id
-                           << "/" << ci.nvmlComputeInstanceId.id;
+                if (NULL == (fp = popen(cmd, "r")))
+                {
+                    nvmlReturn = NVML_ERROR_NOT_FOUND;
+                    AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
+                    return NvmlReturnToDcgmReturn(nvmlReturn);
+                }
+                if (fgets(tmp_name, sizeof(tmp_name), fp))
+                {
+                    char *eol = strchr(tmp_name, '\n');
+                    if (eol)
+                        *eol = 0;
+                    AppendEntityString(threadCtx, tmp_name, now, expireTime);
                 }
                 else
                 {
-                    valbuf << errorString(ret);
-                    DCGM_LOG_ERROR << "Cannot create CUDA_VISIBLE_DEVICES value for compute instance " << entityId
-                                   << ": " << valbuf.str();
+                    nvmlReturn = NVML_ERROR_NOT_FOUND;
+                    AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
                 }
-            }
-            break;
-        }
-
-        default:
-            valbuf << "Unsupported";
-            break;
-    }
-}
-
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::GetCIDeviceNameAndId(nvmlDevice_t nvmlDevice,
-                                                    unsigned int ciIndex,
-                                                    std::string &ciName,
-                                                    unsigned int &ciId)
-{
-    nvmlDevice_t migDevice;
-    char ciNameBuf[NVML_DEVICE_NAME_V2_BUFFER_SIZE] = { 0 };
-    nvmlReturn_t nvmlReturn = nvmlDeviceGetMigDeviceHandleByIndex(nvmlDevice, ciIndex, &migDevice);
-    if (nvmlReturn != NVML_SUCCESS)
-    {
-        // It's not an error if no device exists or can be accessed.
-        return DCGM_ST_OK;
-    }
-
-    nvmlReturn = nvmlDeviceGetComputeInstanceId(migDevice, &ciId);
-    if (nvmlReturn != NVML_SUCCESS)
-    {
-        return NvmlReturnToDcgmReturn(nvmlReturn);
-    }
-
-    nvmlReturn = nvmlDeviceGetName(migDevice, ciNameBuf, sizeof(ciNameBuf));
-    if (nvmlReturn != NVML_SUCCESS)
-    {
-        return NvmlReturnToDcgmReturn(nvmlReturn);
-    }
-
-    return DcgmGpuInstance::TruncateCIDeviceName(ciNameBuf, ciName);
-}
-
-/*****************************************************************************/
-/* vGPU Index key space for gpuId */
-#define DCGMCM_START_VGPU_IDX_FOR_GPU(gpuId) ((gpuId)*DCGM_MAX_VGPU_INSTANCES_PER_PGPU)
-#define DCGMCM_END_VGPU_IDX_FOR_GPU(gpuId)   (((gpuId) + 1) * DCGM_MAX_VGPU_INSTANCES_PER_PGPU)
-
-/*****************************************************************************/
-dcgmReturn_t DcgmCacheManager::BufferOrCacheLatestGpuValue(dcgmcm_update_thread_t *threadCtx,
-                                                           dcgm_field_meta_p fieldMeta)
-{
-    timelib64_t now               = 0;
-    timelib64_t expireTime        = 0;
-    timelib64_t previousQueryUsec = 0;
-    nvmlReturn_t nvmlReturn;
-    nvmlDevice_t nvmlDevice = 0;
-
-    if (!threadCtx || !fieldMeta)
-        return DCGM_ST_BADPARAM;
-
-    unsigned int entityId      = threadCtx->entityKey.entityId;
-    unsigned int entityGroupId = threadCtx->entityKey.entityGroupId;
-    unsigned int gpuId         = m_numGpus; // Initialize to an invalid value for check below
-
-    dcgmReturn_t ret = GetGpuId(entityGroupId, entityId, gpuId);
-    if (ret != DCGM_ST_OK)
-    {
-        return ret;
-    }
-
-    if (fieldMeta->scope != DCGM_FS_GLOBAL)
-    {
-        if (gpuId >= m_numGpus)
-        {
-            LOG_VERBOSE << "Cannot retrieve GPU value for invalid GPU index: " << gpuId;
-            return DCGM_ST_GENERIC_ERROR;
+                pclose(fp);
+#else
+                /* Soon to be implemented for other environments. Appending error string for now. */
+                nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
+                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
+#endif
+            }
+            break;
         }
 
-        nvmlDevice = m_gpus[gpuId].nvmlDevice;
-    }
-
-    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
-
-    now = timelib_usecSince1970();
+        case DCGM_FI_DEV_VGPU_TYPE:
+        {
+            unsigned int vgpuTypeId = vgpuInfo.vgpuTypeId;
 
-    /* Expiration is either measured in absolute time or 0 */
-    if (watchInfo && watchInfo->maxAgeUsec)
-        expireTime = now - watchInfo->maxAgeUsec;
+            if (!vgpuInfo.haveVgpuTypeId)
+            {
+                nvmlReturn = nvmlVgpuInstanceGetType(vgpuId, &vgpuTypeId);
+                if (nvmlReturn != NVML_SUCCESS)
+                {
+                    PRINT_ERROR("%d %u",
+                                "nvmlVgpuInstanceGetType failed with status %d for vgpuId %u",
+                                (int)nvmlReturn,
+                                vgpuId);
+                    AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
+                    return NvmlReturnToDcgmReturn(nvmlReturn);
+                }
 
-    /* Set without lock before we possibly return on error so we don't get in a hot
-     * polling loop on something that is unsupported or errors. Not getting the lock
-     * ahead of time because we don't want to hold the lock across a driver call that
-     * could be long */
-    if (watchInfo)
-    {
-        previousQueryUsec          = watchInfo->lastQueriedUsec;
-        watchInfo->lastQueriedUsec = now;
-    }
+                updateVgpuInfo([vgpuTypeId](dcgmcm_vgpu_info_t &node) {
+                    node.vgpuTypeId     = vgpuTypeId;
+                    node.haveVgpuTypeId = true;
+                });
+            }
+            AppendEntityInt64(threadCtx, vgpuTypeId, 0, now, expireTime);
+            break;
+        }
 
-    switch (fieldMeta->fieldId)
-    {
-        case DCGM_FI_DRIVER_VERSION:
+        case DCGM_FI_DEV_VGPU_UUID:
         {
-            char buf[NVML_SYSTEM_DRIVER_VERSION_BUFFER_SIZE] = { 0 };
-            nvmlReturn                                       = nvmlSystemGetDriverVersion(buf, sizeof(buf));
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+            char buffer[DCGM_DEVICE_UUID_BUFFER_SIZE];
+            unsigned int bufferSize = DCGM_DEVICE_UUID_BUFFER_SIZE;
+
+            if (vgpuInfo.haveUuid)
             {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                SafeCopyTo(buffer, vgpuInfo.uuid);
+                if (watchInfo)
+                    watchInfo->lastStatus = NVML_SUCCESS;
             }
-            AppendEntityString(threadCtx, buf, now, expireTime);
+            else
+            {
+                nvmlReturn = nvmlVgpuInstanceGetUUID(vgpuId, buffer, bufferSize);
+                if (watchInfo)
+                    watchInfo->lastStatus = nvmlReturn;
+                if (nvmlReturn != NVML_SUCCESS)
+                {
+                    PRINT_ERROR("%d %u",
+                                "nvmlVgpuInstanceGetUUID failed with status %d for vgpuId %u",
+                                (int)nvmlReturn,
+                                vgpuId);
+                    AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
+                    return NvmlReturnToDcgmReturn(nvmlReturn);
+                }
+
+                updateVgpuInfo([&buffer](dcgmcm_vgpu_info_t &node) {
+                    SafeCopyTo(node.uuid, buffer);
+                    node.haveUuid = true;
+                });
+            }
+            AppendEntityString(threadCtx, buffer, now, expireTime);
             break;
         }
 
-        case DCGM_FI_NVML_VERSION:
+        case DCGM_FI_DEV_VGPU_DRIVER_VERSION:
         {
-            char buf[NVML_SYSTEM_NVML_VERSION_BUFFER_SIZE] = { 0 };
-            nvmlReturn                                     = nvmlSystemGetNVMLVersion(buf, sizeof(buf));
+            char buffer[DCGM_DEVICE_UUID_BUFFER_SIZE];
+            unsigned int bufferSize = DCGM_DEVICE_UUID_BUFFER_SIZE;
+
+            nvmlReturn = nvmlVgpuInstanceGetVmDriverVersion(vgpuId, buffer, bufferSize);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
             if (nvmlReturn != NVML_SUCCESS)
             {
+                PRINT_ERROR("%d %u",
+                            "nvmlVgpuInstanceGetVmDriverVersion failed with status %d for vgpuId %u",
+                            (int)nvmlReturn,
+                            vgpuId);
                 AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-            AppendEntityString(threadCtx, buf, now, expireTime);
+
+            if (strcmp("Unknown", buffer))
+            {
+                /* Updating the cache frequency to once every 15 minutes after a known driver version is fetched. */
+                if (watchInfo && watchInfo->monitorFrequencyUsec != 900000000)
+                {
+                    UpdateFieldWatch(watchInfo, 900000000, 900.0, 1, DcgmWatcher(DcgmWatcherTypeCacheManager));
+                    PRINT_ERROR(
+                        "%d %u", "UpdateFieldWatch failed for vgpuId %u and fieldId %d", vgpuId, fieldMeta->fieldId);
+                }
+            }
+
+            AppendEntityString(threadCtx, buffer, now, expireTime);
             break;
         }
 
-        case DCGM_FI_PROCESS_NAME:
+        case DCGM_FI_DEV_VGPU_MEMORY_USAGE:
         {
-            char buf[128] = { 0 };
-            nvmlReturn    = nvmlSystemGetProcessName((unsigned int)getpid(), buf, sizeof(buf) - 1);
+            unsigned long long fbUsage;
+
+            nvmlReturn = nvmlVgpuInstanceGetFbUsage(vgpuId, &fbUsage);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+            if (NVML_SUCCESS != nvmlReturn)
             {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
+                PRINT_ERROR(
+                    "%d %u", "nvmlVgpuInstanceGetFbUsage failed with status %d for vgpuId %u", (int)nvmlReturn, vgpuId);
+                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-            AppendEntityString(threadCtx, buf, now, expireTime);
+            fbUsage = fbUsage / (1024 * 1024);
+            AppendEntityInt64(threadCtx, fbUsage, 0, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_COUNT:
+        case DCGM_FI_DEV_VGPU_LICENSE_INSTANCE_STATUS:
         {
-            unsigned int deviceCount = 0;
+            unsigned int licenseState;
 
-            nvmlReturn = nvmlDeviceGetCount_v2(&deviceCount);
+            nvmlReturn = nvmlVgpuInstanceGetLicenseStatus(vgpuId, &licenseState);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+            if (NVML_SUCCESS != nvmlReturn)
             {
+                PRINT_ERROR("%d %u",
+                            "nvmlVgpuInstanceGetLicenseStatus failed with status %d for vgpuId %u",
+                            (int)nvmlReturn,
+                            vgpuId);
                 AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-            AppendEntityInt64(threadCtx, (long long)deviceCount, 0, now, expireTime);
+            AppendEntityInt64(threadCtx, licenseState, 0, now, expireTime);
             break;
         }
 
-        case DCGM_FI_CUDA_DRIVER_VERSION:
+        case DCGM_FI_DEV_VGPU_FRAME_RATE_LIMIT:
         {
-            int systemCudaVersion = 0;
-            nvmlReturn            = nvmlSystemGetCudaDriverVersion_v2(&systemCudaVersion);
+            unsigned int frameRateLimit;
 
-            if (nvmlReturn != NVML_SUCCESS)
+            nvmlReturn = nvmlVgpuInstanceGetFrameRateLimit(vgpuId, &frameRateLimit);
+            if (watchInfo)
+                watchInfo->lastStatus = nvmlReturn;
+            if (NVML_SUCCESS != nvmlReturn)
             {
+                PRINT_ERROR("%d %u",
+                            "nvmlVgpuInstanceGetFrameRateLimit failed with status %d for vgpuId %u",
+                            (int)nvmlReturn,
+                            vgpuId);
                 AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-
-            AppendEntityInt64(threadCtx, (long long)systemCudaVersion, 0, now, expireTime);
+            AppendEntityInt64(threadCtx, frameRateLimit, 0, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_NAME:
+        case DCGM_FI_DEV_VGPU_ENC_STATS:
         {
-            char buf[NVML_DEVICE_NAME_BUFFER_SIZE] = { 0 };
+            dcgmDeviceEncStats_t vgpuEncStats;
 
-            switch (entityGroupId)
+            nvmlReturn = nvmlVgpuInstanceGetEncoderStats(
+                vgpuId, &vgpuEncStats.sessionCount, &vgpuEncStats.averageFps, &vgpuEncStats.averageLatency);
+            if (watchInfo)
+                watchInfo->lastStatus = nvmlReturn;
+            if (NVML_SUCCESS != nvmlReturn)
             {
-                case DCGM_FE_GPU:
-                    nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                         : nvmlDeviceGetName(nvmlDevice, buf, sizeof(buf));
-                    if (watchInfo)
-                    {
-                        watchInfo->lastStatus = nvmlReturn;
-                    }
-
-                    if (nvmlReturn != NVML_SUCCESS)
-                    {
-                        AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                        return NvmlReturnToDcgmReturn(nvmlReturn);
-                    }
-                    AppendEntityString(threadCtx, buf, now, expireTime);
-                    break;
-
-                case DCGM_FE_GPU_I:
-                {
-                    unsigned int localGIIndex      = entityId % m_gpus[gpuId].maxGpcs;
-                    std::string const &profileName = m_gpus[gpuId].instances[localGIIndex].GetProfileName();
-                    if (profileName.empty())
-                    {
-                        snprintf(buf, sizeof(buf), "%s", DCGM_STR_BLANK);
-                    }
-                    else
-                    {
-                        snprintf(buf, sizeof(buf), "%s", profileName.c_str());
-                    }
-                    AppendEntityString(threadCtx, buf, now, expireTime);
-
-                    break;
-                }
-
-                case DCGM_FE_GPU_CI:
-                {
-                    DcgmNs::Mig::GpuInstanceId gpuInstanceId {};
-                    ret = m_migManager.GetInstanceIdFromComputeInstanceId(DcgmNs::Mig::ComputeInstanceId { entityId },
-                                                                          gpuInstanceId);
-                    if (ret != DCGM_ST_OK)
-                    {
-                        snprintf(buf, sizeof(buf), "%s", DCGM_STR_BLANK);
-                    }
-                    else
-                    {
-                        unsigned int localGIIndex = gpuInstanceId.id % m_gpus[gpuId].maxGpcs;
-                        dcgmcm_gpu_compute_instance_t ci {};
-                        ret = m_gpus[gpuId].instances[localGIIndex].GetComputeInstanceById(
-                            DcgmNs::Mig::ComputeInstanceId { entityId }, ci);
-                        if (ret != DCGM_ST_OK || ci.profileName.empty())
-                        {
-                            snprintf(buf, sizeof(buf), "%s", DCGM_STR_BLANK);
-                        }
-                        else
-                        {
-                            snprintf(buf, sizeof(buf), "%s", ci.profileName.c_str());
-                        }
-                    }
-
-                    AppendEntityString(threadCtx, buf, now, expireTime);
-                    break;
-                }
-
-                default:
-                {
-                    snprintf(buf, sizeof(buf), "Unsupported entity group");
-                    AppendEntityString(threadCtx, buf, now, expireTime);
-                    break;
-                }
+                memset(&vgpuEncStats, 0, sizeof(vgpuEncStats));
+                AppendEntityBlob(threadCtx, &vgpuEncStats, (int)(sizeof(vgpuEncStats)), now, expireTime);
+                return NvmlReturnToDcgmReturn(nvmlReturn);
             }
+            AppendEntityBlob(threadCtx, &vgpuEncStats, (int)(sizeof(vgpuEncStats)), now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_BRAND:
+        case DCGM_FI_DEV_VGPU_ENC_SESSIONS_INFO:
         {
-            nvmlBrandType_t brand;
-            char *brandString = 0;
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT : nvmlDeviceGetBrand(nvmlDevice, &brand);
+            dcgmDeviceVgpuEncSessions_t *vgpuEncSessionsInfo = NULL;
+            nvmlEncoderSessionInfo_t *sessionInfo            = NULL;
+            unsigned int i, numDeviceSessions = 0, sessionCount = 0;
+
+            /* One call per GPU per update cycle covers the sessions of all of its vGPU instances */
+            nvmlReturn = haveVgpuInfo ? GetBatchedGpuValues(
+                             threadCtx, gpuId, m_gpus[gpuId].nvmlDevice, DcgmcmBatchedEncoderSessions)
+                                      : NVML_ERROR_NOT_FOUND;
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+
+            if (nvmlReturn == NVML_SUCCESS)
             {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                sessionInfo       = threadCtx->batchedValues[gpuId].encoderSessions;
+                numDeviceSessions = threadCtx->batchedValues[gpuId].numEncoderSessions;
+                for (i = 0; i < numDeviceSessions; i++)
+                {
+                    if (sessionInfo[i].vgpuInstance == vgpuId)
+                        sessionCount++;
+                }
             }
 
-            /* String constants stolen from nvsmi/reporting.c. Using switch instead
-             * of table in case more are added */
-            switch (brand)
+            vgpuEncSessionsInfo
+                = (dcgmDeviceVgpuEncSessions_t *)malloc(sizeof(*vgpuEncSessionsInfo) * (sessionCount + 1));
+            if (!vgpuEncSessionsInfo)
             {
-                case NVML_BRAND_QUADRO:
-                    brandString = (char *)"Quadro";
-                    break;
-                case NVML_BRAND_TESLA:
-                    brandString = (char *)"Tesla";
-                    break;
-                case NVML_BRAND_NVS:
-                    brandString = (char *)"NVS";
-                    break;
-                case NVML_BRAND_GRID:
-                    brandString = (char *)"Grid";
-                    break;
-                case NVML_BRAND_GEFORCE:
-                    brandString = (char *)"GeForce";
-                    break;
-                case NVML_BRAND_TITAN:
-                    brandString = (char *)"Titan";
-                    break;
-                case NVML_BRAND_UNKNOWN:
-                default:
-                    brandString = (char *)"Unknown";
-                    break;
+                PRINT_ERROR(
+                    "%d", "malloc of %d bytes failed", (int)(sizeof(*vgpuEncSessionsInfo) * (sessionCount + 1)));
+                return DCGM_ST_MEMORY;
             }
 
-            AppendEntityString(threadCtx, brandString, now, expireTime);
-            break;
-        }
+            /* First element of the array holds the count */
+            vgpuEncSessionsInfo[0].encoderSessionInfo.sessionCount = sessionCount;
 
-        case DCGM_FI_DEV_NVML_INDEX:
-        {
-            /* There's really no point in making the call since we passed in what we want */
-            if (watchInfo)
-                watchInfo->lastStatus = NVML_SUCCESS;
-            AppendEntityInt64(threadCtx, GpuIdToNvmlIndex(gpuId), 0, now, expireTime);
+            sessionCount = 0;
+            for (i = 0; i < numDeviceSessions; i++)
+            {
+                if (sessionInfo[i].vgpuInstance != vgpuId)
+                    continue;
+
+                sessionCount++;
+                dcgmDeviceVgpuEncSessions_t &session = vgpuEncSessionsInfo[sessionCount];
+                session.encoderSessionInfo.vgpuId    = sessionInfo[i].vgpuInstance;
+                session.sessionId                    = sessionInfo[i].sessionId;
+                session.pid                          = sessionInfo[i].pid;
+                session.codecType                    = (dcgmEncoderType_t)sessionInfo[i].codecType;
+                session.hResolution                  = sessionInfo[i].hResolution;
+                session.vResolution                  = sessionInfo[i].vResolution;
+                session.averageFps                   = sessionInfo[i].averageFps;
+                session.averageLatency               = sessionInfo[i].averageLatency;
+            }
+            AppendEntityBlob(threadCtx,
+                             vgpuEncSessionsInfo,
+                             (int)(sizeof(*vgpuEncSessionsInfo) * (sessionCount + 1)),
+                             now,
+                             expireTime);
+            free(vgpuEncSessionsInfo);
+            if (nvmlReturn != NVML_SUCCESS)
+                return NvmlReturnToDcgmReturn(nvmlReturn);
             break;
         }
 
-        case DCGM_FI_DEV_SERIAL:
+        case DCGM_FI_DEV_VGPU_FBC_STATS:
         {
-            char buf[NVML_DEVICE_SERIAL_BUFFER_SIZE] = { 0 };
+            dcgmDeviceFbcStats_t vgpuFbcStats;
+            nvmlFBCStats_t fbcStats;
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetSerial(nvmlDevice, buf, sizeof(buf));
+            nvmlReturn = nvmlVgpuInstanceGetFBCStats(vgpuId, &fbcStats);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+            if (NVML_SUCCESS != nvmlReturn)
             {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
+                PRINT_ERROR("%d %u",
+                            "nvmlVgpuInstanceGetFBCStats failed with status %d for vgpuId %u",
+                            (int)nvmlReturn,
+                            vgpuId);
+                memset(&vgpuFbcStats, 0, sizeof(vgpuFbcStats));
+                AppendEntityBlob(threadCtx, &vgpuFbcStats, (int)(sizeof(vgpuFbcStats)), now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
 
-            AppendEntityString(threadCtx, buf, now, expireTime);
+            vgpuFbcStats.version        = dcgmDeviceFbcStats_version;
+            vgpuFbcStats.sessionCount   = fbcStats.sessionsCount;
+            vgpuFbcStats.averageFps     = fbcStats.averageFPS;
+            vgpuFbcStats.averageLatency = fbcStats.averageLatency;
+
+            AppendEntityBlob(threadCtx, &vgpuFbcStats, (int)(sizeof(vgpuFbcStats)), now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_CPU_AFFINITY_0:
-        case DCGM_FI_DEV_CPU_AFFINITY_1:
-        case DCGM_FI_DEV_CPU_AFFINITY_2:
-        case DCGM_FI_DEV_CPU_AFFINITY_3:
+        case DCGM_FI_DEV_VGPU_FBC_SESSIONS_INFO:
         {
-            long long saveValue = 0;
-            long long values[4] = { 0 };
-            unsigned int Nlongs = (sizeof(long) == 8) ? 4 : 8;
-            int affinityIndex   = fieldMeta->fieldId - DCGM_FI_DEV_CPU_AFFINITY_0;
-
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetCpuAffinity(nvmlDevice, Nlongs, (unsigned long *)&values[0]);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+            if (!haveVgpuInfo)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                PRINT_DEBUG("%u", "vgpuId %u isn't on any GPU's vGPU list", vgpuId);
+                return DCGM_ST_NO_DATA;
             }
 
-            /* Save the value that corresponds with the requested field */
-            saveValue = values[affinityIndex];
+            dcgmReturn_t status
+                = GetVgpuInstanceFBCSessionsInfo(vgpuId, gpuId, threadCtx, watchInfo, now, expireTime);
+            if (DCGM_ST_OK != status)
+                return status;
+            break;
+        }
 
-            AppendEntityInt64(threadCtx, saveValue, 0, now, expireTime);
+        default:
+            PRINT_WARNING("%d", "Unimplemented fieldId: %d", (int)fieldMeta->fieldId);
+            return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetGpuId(unsigned int entityGroupId, unsigned int entityId, unsigned int &gpuId)
+{
+    dcgmReturn_t ret = DCGM_ST_OK;
+
+    switch (entityGroupId)
+    {
+        case DCGM_FE_GPU_I:
+        {
+            ret = m_migManager.GetGpuIdFromInstanceId(DcgmNs::Mig::GpuInstanceId { entityId }, gpuId);
             break;
         }
 
-        case DCGM_FI_DEV_UUID:
+        case DCGM_FE_GPU_CI:
         {
-            if (m_gpus[gpuId].status == DcgmEntityStatusFake)
+            ret = m_migManager.GetGpuIdFromComputeInstanceId(DcgmNs::Mig::ComputeInstanceId { entityId }, gpuId);
+            break;
+        }
+
+        case DCGM_FE_GPU:
+        default:
+            // Just copy the entityId
+            gpuId = entityId;
+            break;
+    }
+
+    return ret;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::GenerateCudaVisibleDevicesValue(unsigned int gpuId,
+                                                       unsigned int entityGroupId,
+                                                       unsigned int entityId,
+                                                       std::stringstream &valbuf)
+{
+    valbuf.str("");
+
+    switch (entityGroupId)
+    {
+        case DCGM_FE_GPU:
+        {
+            if (entityId >= m_numGpus)
             {
-                AppendEntityString(threadCtx, m_gpus[gpuId].uuid, now, expireTime);
+                valbuf << "Invalid GPU id: " << entityId;
+                DCGM_LOG_ERROR << "Cannot create CUDA_VISIBLE_DEVICES value for GPU: " << valbuf.str();
             }
             else
             {
-                char buf[DCGM_DEVICE_UUID_BUFFER_SIZE] = { 0 };
-
-                nvmlReturn = NVML_ERROR_INVALID_ARGUMENT;
-                if (nvmlDevice != nullptr)
-                {
-                    nvmlReturn = nvmlDeviceGetUUID(nvmlDevice, buf, sizeof(buf));
-                }
+                const char *uuid = m_gpus[gpuId].uuid;
 
-                if (watchInfo)
+                if (std::strncmp(uuid, "GPU-", 4) == 0)
                 {
-                    watchInfo->lastStatus = nvmlReturn;
+                    uuid += 4;
                 }
 
-                if (nvmlReturn != NVML_SUCCESS)
+                if (IsGpuMigEnabled(gpuId))
                 {
-                    AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                    return NvmlReturnToDcgmReturn(nvmlReturn);
+                    valbuf << "MIG-";
                 }
 
-                AppendEntityString(threadCtx, buf, now, expireTime);
+                valbuf << "GPU-" << uuid;
             }
-
             break;
         }
-
-        case DCGM_FI_DEV_MINOR_NUMBER:
+        case DCGM_FE_GPU_I:
         {
-            unsigned int minorNumber = 0;
-            nvmlReturn               = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetMinorNumber(nvmlDevice, &minorNumber);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+            DcgmGpuInstance *instance = FindGpuInstance(gpuId, DcgmNs::Mig::GpuInstanceId { entityId });
+            const char *uuid          = m_gpus[gpuId].uuid;
+
+            if (instance == nullptr)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                valbuf << errorString(DCGM_ST_INSTANCE_NOT_FOUND);
+                break;
             }
 
-            AppendEntityInt64(threadCtx, (long long)minorNumber, 1, now, expireTime);
+            if (std::strncmp(uuid, "GPU-", 4) == 0)
+            {
+                uuid += 4;
+            }
+
+            valbuf << "MIG-GPU-" << uuid << "/" << instance->GetNvmlInstanceId().id;
             break;
         }
-
-        case DCGM_FI_DEV_CUDA_COMPUTE_CAPABILITY:
+        case DCGM_FE_GPU_CI:
         {
-            int major     = 0;
-            int minor     = 0;
-            long long ccc = 0;
-            nvmlReturn    = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetCudaComputeCapability(nvmlDevice, &major, &minor);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+            DcgmNs::Mig::GpuInstanceId gpuInstanceId {};
+            dcgmReturn_t ret
+                = m_migManager.GetCIParentIds(DcgmNs::Mig::ComputeInstanceId { entityId }, gpuId, gpuInstanceId);
+            if (ret != DCGM_ST_OK)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return (NvmlReturnToDcgmReturn(nvmlReturn));
+                valbuf << errorString(ret);
+                DCGM_LOG_ERROR << "Cannot create CUDA_VISIBLE_DEVICES value for compute instance " << entityId << ": "
+                               << valbuf.str();
             }
+            else
+            {
+                DcgmGpuInstance *instance = FindGpuInstance(gpuId, gpuInstanceId);
+                dcgmcm_gpu_compute_instance_t ci {};
+                ret = DCGM_ST_INSTANCE_NOT_FOUND;
+                if (instance != nullptr)
+                {
+                    ret = instance->GetComputeInstanceById(DcgmNs::Mig::ComputeInstanceId { entityId }, ci);
+                }
+                if (ret == DCGM_ST_OK)
+                {
+                    const char *uuid = m_gpus[gpuId].uuid;
 
-            // Store the major version in the upper 16 bits, and the minor version in the lower 16 bits
-            ccc = ((long long)major << 16) | minor;
-            AppendEntityInt64(threadCtx, ccc, 1, now, expireTime);
+                    if (std::strncmp(uuid, "GPU-", 4) == 0)
+                    {
+                        uuid += 4;
+                    }
+
+                    valbuf << "MIG-GPU-" << uuid << "/" << instance->GetNvmlInstanceId().id << "/"
+                           << ci.nvmlComputeInstanceId.id;
+                }
+                else
+                {
+                    valbuf << errorString(ret);
+                    DCGM_LOG_ERROR << "Cannot create CUDA_VISIBLE_DEVICES value for compute instance " << entityId
+                                   << ": " << valbuf.str();
+                }
+            }
             break;
         }
 
-        case DCGM_FI_DEV_OEM_INFOROM_VER:
-        {
-            char buf[NVML_DEVICE_INFOROM_VERSION_BUFFER_SIZE] = { 0 };
+        default:
+            valbuf << "Unsupported";
+            break;
+    }
+}
 
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetInforomVersion(nvmlDevice, NVML_INFOROM_OEM, buf, sizeof(buf));
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::GetCIDeviceNameAndId(nvmlDevice_t nvmlDevice,
+                                                    unsigned int ciIndex,
+                                                    std::string &ciName,
+                                                    unsigned int &ciId)
+{
+    nvmlDevice_t migDevice;
+    char ciNameBuf[NVML_DEVICE_NAME_V2_BUFFER_SIZE] = { 0 };
+    nvmlReturn_t nvmlReturn = nvmlDeviceGetMigDeviceHandleByIndex(nvmlDevice, ciIndex, &migDevice);
+    if (nvmlReturn != NVML_SUCCESS)
+    {
+        // It's not an error if no device exists or can be accessed.
+        return DCGM_ST_OK;
+    }
+
+    nvmlReturn = nvmlDeviceGetComputeInstanceId(migDevice, &ciId);
+    if (nvmlReturn != NVML_SUCCESS)
+    {
+        return NvmlReturnToDcgmReturn(nvmlReturn);
+    }
+
+    nvmlReturn = nvmlDeviceGetName(migDevice, ciNameBuf, sizeof(ciNameBuf));
+    if (nvmlReturn != NVML_SUCCESS)
+    {
+        return NvmlReturnToDcgmReturn(nvmlReturn);
+    }
+
+    return DcgmGpuInstance::TruncateCIDeviceName(ciNameBuf, ciName);
+}
+
+/*****************************************************************************/
+/* vGPU Index key space for gpuId */
+#define DCGMCM_START_VGPU_IDX_FOR_GPU(gpuId) ((gpuId)*DCGM_MAX_VGPU_INSTANCES_PER_PGPU)
+#define DCGMCM_END_VGPU_IDX_FOR_GPU(gpuId)   (((gpuId) + 1) * DCGM_MAX_VGPU_INSTANCES_PER_PGPU)
 
-            AppendEntityString(threadCtx, buf, now, expireTime);
-            break;
-        }
+/*****************************************************************************/
+/* Call one of NVML's device-wide session getters, growing sessions as needed */
+template <typename SessionInfo>
+static nvmlReturn_t GetDeviceSessions(nvmlReturn_t (*getter)(nvmlDevice_t, unsigned int *, SessionInfo *),
+                                      nvmlDevice_t nvmlDevice,
+                                      SessionInfo *&sessions,
+                                      unsigned int &numSessions,
+                                      unsigned int &capacity)
+{
+    numSessions             = 0;
+    nvmlReturn_t nvmlReturn = getter(nvmlDevice, &numSessions, nullptr);
+    if (nvmlReturn != NVML_SUCCESS || numSessions == 0)
+    {
+        numSessions = 0;
+        return nvmlReturn;
+    }
 
-        case DCGM_FI_DEV_ECC_INFOROM_VER:
+    if (numSessions > capacity)
+    {
+        SessionInfo *grown = (SessionInfo *)realloc(sessions, sizeof(*sessions) * numSessions);
+        if (!grown)
         {
-            char buf[NVML_DEVICE_INFOROM_VERSION_BUFFER_SIZE] = { 0 };
+            PRINT_ERROR("%d", "realloc of %d bytes failed", (int)(sizeof(*sessions) * numSessions));
+            numSessions = 0;
+            return NVML_ERROR_MEMORY;
+        }
+        sessions = grown;
+        capacity = numSessions;
+    }
 
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetInforomVersion(nvmlDevice, NVML_INFOROM_ECC, buf, sizeof(buf));
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    nvmlReturn = getter(nvmlDevice, &numSessions, sessions);
+    if (nvmlReturn != NVML_SUCCESS)
+        numSessions = 0;
+    return nvmlReturn;
+}
 
-            AppendEntityString(threadCtx, buf, now, expireTime);
-            break;
-        }
+/*****************************************************************************/
+nvmlReturn_t DcgmCacheManager::GetBatchedGpuValues(dcgmcm_update_thread_t *threadCtx,
+                                                   unsigned int gpuId,
+                                                   nvmlDevice_t nvmlDevice,
+                                                   dcgmcm_batched_getter_t getter)
+{
+    if (threadCtx->batchedValues.size() <= gpuId)
+        threadCtx->batchedValues.resize(gpuId + 1, dcgmcm_batched_gpu_values_t {});
 
-        case DCGM_FI_DEV_POWER_INFOROM_VER:
-        {
-            char buf[NVML_DEVICE_INFOROM_VERSION_BUFFER_SIZE] = { 0 };
+    dcgmcm_batched_gpu_values_t *batched = &threadCtx->batchedValues[gpuId];
+    unsigned int getterBit               = 1 << getter;
+    nvmlReturn_t nvmlReturn;
 
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetInforomVersion(nvmlDevice, NVML_INFOROM_POWER, buf, sizeof(buf));
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    /* Did another field already make this call? */
+    if (batched->validMask & getterBit)
+    {
+        threadCtx->driverCallsSaved++;
+        return batched->nvmlReturn[getter];
+    }
 
-            AppendEntityString(threadCtx, buf, now, expireTime);
-            break;
+    if (nvmlDevice == nullptr)
+        nvmlReturn = NVML_ERROR_INVALID_ARGUMENT;
+    else
+    {
+        switch (getter)
+        {
+            case DcgmcmBatchedUtilization:
+                nvmlReturn = nvmlDeviceGetUtilizationRates(nvmlDevice, &batched->utilization);
+                break;
+            case DcgmcmBatchedMemoryInfo:
+                nvmlReturn = nvmlDeviceGetMemoryInfo(nvmlDevice, &batched->memory);
+                break;
+            case DcgmcmBatchedBar1MemoryInfo:
+                nvmlReturn = nvmlDeviceGetBAR1MemoryInfo(nvmlDevice, &batched->bar1Memory);
+                break;
+            case DcgmcmBatchedFbcSessions:
+                nvmlReturn = GetDeviceSessions(nvmlDeviceGetFBCSessions,
+                                               nvmlDevice,
+                                               batched->fbcSessions,
+                                               batched->numFbcSessions,
+                                               batched->fbcSessionsCapacity);
+                break;
+            case DcgmcmBatchedEncoderSessions:
+                nvmlReturn = GetDeviceSessions(nvmlDeviceGetEncoderSessions,
+                                               nvmlDevice,
+                                               batched->encoderSessions,
+                                               batched->numEncoderSessions,
+                                               batched->encoderSessionsCapacity);
+                break;
+            case DcgmcmBatchedPciInfo:
+                nvmlReturn = nvmlDeviceGetPciInfo_v3(nvmlDevice, &batched->pciInfo);
+                break;
+            case DcgmcmBatchedPowerLimitConstraints:
+                nvmlReturn = nvmlDeviceGetPowerManagementLimitConstraints(
+                    nvmlDevice, &batched->powerLimitMin, &batched->powerLimitMax);
+                break;
+            default:
+                PRINT_ERROR("%d", "Unhandled batched getter %d", (int)getter);
+                return NVML_ERROR_INVALID_ARGUMENT;
         }
+    }
 
-        case DCGM_FI_DEV_INFOROM_IMAGE_VER:
-        {
-            char buf[NVML_DEVICE_INFOROM_VERSION_BUFFER_SIZE] = { 0 };
+    batched->nvmlReturn[getter] = nvmlReturn;
+    batched->validMask |= getterBit;
+    return nvmlReturn;
+}
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetInforomImageVersion(nvmlDevice, buf, sizeof(buf));
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::FetchGpuFieldValue(dcgmcm_update_thread_t *threadCtx,
+                                                  dcgmcm_gpu_field_fetcher_t const &fetcher,
+                                                  unsigned int gpuId,
+                                                  nvmlDevice_t nvmlDevice,
+                                                  timelib64_t now,
+                                                  timelib64_t expireTime)
+{
+    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
+    dcgmcm_fetched_value_t value {};
+    nvmlReturn_t nvmlReturn;
 
-            AppendEntityString(threadCtx, buf, now, expireTime);
-            break;
-        }
+    if (fetcher.samplingType != NVML_SAMPLINGTYPE_COUNT
+        && AppendBufferedSamples(threadCtx, nvmlDevice, fetcher.samplingType, fetcher.sampleDivisor, now, expireTime))
+    {
+        return DCGM_ST_OK;
+    }
 
-        case DCGM_FI_DEV_INFOROM_CONFIG_CHECK:
-        {
-            unsigned int checksum = 0;
+    if (fetcher.batch != DcgmcmBatchedCount)
+    {
+        nvmlReturn = GetBatchedGpuValues(threadCtx, gpuId, nvmlDevice, fetcher.batch);
+        if (nvmlReturn == NVML_SUCCESS)
+            nvmlReturn = fetcher.fetch(nvmlDevice, &threadCtx->batchedValues[gpuId], value);
+    }
+    else
+    {
+        nvmlReturn
+            = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT : fetcher.fetch(nvmlDevice, nullptr, value);
+    }
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetInforomConfigurationChecksum(nvmlDevice, &checksum);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    if (watchInfo)
+        watchInfo->lastStatus = nvmlReturn;
 
-            AppendEntityInt64(threadCtx, (long long)checksum, 0, now, expireTime);
+    /* Append a blank value of the field's type on errors */
+    switch (fetcher.fieldType)
+    {
+        case DCGM_FT_INT64:
+            AppendEntityInt64(threadCtx,
+                              (nvmlReturn == NVML_SUCCESS) ? value.i64 : NvmlErrorToInt64Value(nvmlReturn),
+                              0,
+                              now,
+                              expireTime);
             break;
-        }
-
-        case DCGM_FI_DEV_INFOROM_CONFIG_VALID:
-        {
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT : nvmlDeviceValidateInforom(nvmlDevice);
+        case DCGM_FT_DOUBLE:
+            AppendEntityDouble(threadCtx,
+                               (nvmlReturn == NVML_SUCCESS) ? value.dbl : NvmlErrorToDoubleValue(nvmlReturn),
+                               0,
+                               now,
+                               expireTime);
+            break;
+        case DCGM_FT_STRING:
+            AppendEntityString(threadCtx,
+                               (nvmlReturn == NVML_SUCCESS) ? value.str : NvmlErrorToStringValue(nvmlReturn),
+                               now,
+                               expireTime);
+            break;
+        default:
+            PRINT_ERROR("%c %u", "Unhandled field type %c of fieldId %u", fetcher.fieldType, fetcher.fieldId);
+            return DCGM_ST_GENERIC_ERROR;
+    }
 
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS && nvmlReturn != NVML_ERROR_CORRUPTED_INFOROM)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    return NvmlReturnToDcgmReturn(nvmlReturn);
+}
 
-            unsigned long long valid = ((nvmlReturn == NVML_SUCCESS) ? 1 : 0);
+/*****************************************************************************/
+static double NvmlSampleValueToDouble(nvmlValueType_t valueType, nvmlValue_t const &value)
+{
+    switch (valueType)
+    {
+        case NVML_VALUE_TYPE_DOUBLE:
+            return value.dVal;
+        case NVML_VALUE_TYPE_UNSIGNED_INT:
+            return (double)value.uiVal;
+        case NVML_VALUE_TYPE_UNSIGNED_LONG:
+            return (double)value.ulVal;
+        case NVML_VALUE_TYPE_UNSIGNED_LONG_LONG:
+            return (double)value.ullVal;
+        case NVML_VALUE_TYPE_SIGNED_LONG_LONG:
+            return (double)value.sllVal;
+        default:
+            PRINT_ERROR("%d", "Unhandled valueType: %d", (int)valueType);
+            return 0.0;
+    }
+}
 
-            AppendEntityInt64(threadCtx, valid, 0, now, expireTime);
-            break;
-        }
+/*****************************************************************************/
+bool DcgmCacheManager::AppendBufferedSamples(dcgmcm_update_thread_t *threadCtx,
+                                             nvmlDevice_t nvmlDevice,
+                                             nvmlSamplingType_t samplingType,
+                                             double divisor,
+                                             timelib64_t now,
+                                             timelib64_t expireTime)
+{
+    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
 
-        case DCGM_FI_DEV_VBIOS_VERSION:
-        {
-            char buf[NVML_DEVICE_VBIOS_VERSION_BUFFER_SIZE] = { 0 };
+    /* Samples are only worth draining into a watch's history. Snapshot passes want one value at their timestamp */
+    if (!m_bufferedSampling || !watchInfo || nvmlDevice == nullptr || threadCtx->cycleTimestamp)
+        return false;
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetVbiosVersion(nvmlDevice, buf, sizeof(buf));
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    /* Don't backfill from before the watch's first update */
+    unsigned long long lastSeen = watchInfo->lastSampleTimestamp;
+    if (!lastSeen)
+        lastSeen = (unsigned long long)std::max((timelib64_t)0, now - watchInfo->monitorFrequencyUsec);
 
-            AppendEntityString(threadCtx, buf, now, expireTime);
-            break;
-        }
+    nvmlValueType_t valueType;
+    unsigned int sampleCount = 0;
+    nvmlReturn_t nvmlReturn  = nvmlDeviceGetSamples(nvmlDevice, samplingType, lastSeen, &valueType, &sampleCount, NULL);
+    if (nvmlReturn == NVML_SUCCESS && sampleCount > 0)
+    {
+        std::vector<nvmlSample_t> samples(sampleCount);
+        nvmlReturn = nvmlDeviceGetSamples(nvmlDevice, samplingType, lastSeen, &valueType, &sampleCount, samples.data());
+        samples.resize(std::min((size_t)sampleCount, samples.size()));
 
-        case DCGM_FI_DEV_VGPU_LICENSE_STATUS:
+        if (nvmlReturn == NVML_SUCCESS)
         {
-            nvmlGridLicensableFeatures_t licFeat;
-
-            nvmlReturn = nvmlDeviceGetGridLicensableFeatures(nvmlDevice, &licFeat);
-
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+            bool isDouble = DcgmFieldGetById(threadCtx->entityKey.fieldId)->fieldType == DCGM_FT_DOUBLE;
 
-            if (!licFeat.isGridLicenseSupported)
+            for (nvmlSample_t const &sample : samples)
             {
-                AppendEntityInt64(threadCtx, (long long)0, 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+                if (sample.timeStamp <= lastSeen)
+                    continue;
 
-            for (int i = 0; i < licFeat.licensableFeaturesCount; i++)
-            {
-                if (licFeat.gridLicensableFeatures[i].featureCode == NVML_GRID_LICENSE_FEATURE_CODE_VGPU)
-                {
-                    AppendEntityInt64(threadCtx,
-                                      (long long)(licFeat.gridLicensableFeatures[i].featureState > 0) ? 1 : 0,
-                                      0,
-                                      now,
-                                      expireTime);
+                double value = NvmlSampleValueToDouble(valueType, sample.sampleValue) / divisor;
+                if (isDouble)
+                    AppendEntityDouble(threadCtx, value, 0, (timelib64_t)sample.timeStamp, expireTime);
+                else
+                    AppendEntityInt64(threadCtx, (long long)value, 0, (timelib64_t)sample.timeStamp, expireTime);
 
-                    break;
-                }
+                watchInfo->lastSampleTimestamp = std::max(watchInfo->lastSampleTimestamp, sample.timeStamp);
             }
-
-            break;
         }
+    }
 
-        case DCGM_FI_DEV_PCI_BUSID:
-        case DCGM_FI_DEV_PCI_COMBINED_ID:
-        case DCGM_FI_DEV_PCI_SUBSYS_ID:
-        {
-            nvmlPciInfo_t pciInfo;
+    /* NOT_FOUND means nothing new since lastSeen. That's only a real answer once we've read samples before */
+    if (nvmlReturn == NVML_ERROR_NOT_FOUND && watchInfo->lastSampleTimestamp)
+        nvmlReturn = NVML_SUCCESS;
+    else if (nvmlReturn == NVML_SUCCESS && !watchInfo->lastSampleTimestamp)
+        nvmlReturn = NVML_ERROR_NOT_FOUND; /* Nothing cached yet. Take an instantaneous sample */
 
-            nvmlReturn
-                = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT : nvmlDeviceGetPciInfo_v3(nvmlDevice, &pciInfo);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                /* Append a blank value of the correct type for our fieldId */
-                switch (fieldMeta->fieldType)
-                {
-                    case DCGM_FT_STRING:
-                        AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
-                        break;
-                    case DCGM_FT_INT64:
-                        AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                        break;
-                    default:
-                        PRINT_ERROR("%c", "Unhandled field type: %c", fieldMeta->fieldType);
-                        break;
-                }
+    if (nvmlReturn != NVML_SUCCESS)
+    {
+        DCGM_LOG_VERBOSE << "nvmlDeviceGetSamples type " << samplingType << " returned " << nvmlReturn
+                         << ". Reading the value instantaneously";
+        return false;
+    }
 
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    watchInfo->lastStatus = NVML_SUCCESS;
+    return true;
+}
 
-            /* Success. Append the correct value */
-            switch (fieldMeta->fieldId)
-            {
-                case DCGM_FI_DEV_PCI_BUSID:
-                    AppendEntityString(threadCtx, pciInfo.busId, now, expireTime);
-                    break;
-                case DCGM_FI_DEV_PCI_COMBINED_ID:
-                    AppendEntityInt64(threadCtx, (long long)pciInfo.pciDeviceId, 0, now, expireTime);
-                    break;
-                case DCGM_FI_DEV_PCI_SUBSYS_ID:
-                    AppendEntityInt64(threadCtx, (long long)pciInfo.pciSubSystemId, 0, now, expireTime);
-                    break;
-                default:
-                    PRINT_ERROR("%d", "Unhandled fieldId %d", (int)fieldMeta->fieldId);
-                    break;
-            }
+/*****************************************************************************/
+bool DcgmCacheManager::ReadHostengineStat(unsigned short fieldId, long long &value)
+{
+    dcgmcm_hostengine_stats_t hostengineStats {};
+    dcgmcm_hostengine_stats_f callback;
+
+    {
+        DcgmLockGuard dlg(m_mutex);
+
+        switch (fieldId)
+        {
+            case DCGM_FI_HOSTENGINE_UPDATE_LOOP_USEC:
+                value = m_runStats.lastCycleUsec;
+                return true;
+            case DCGM_FI_HOSTENGINE_UPDATE_OVERRUNS:
+                value = m_runStats.numSleepsSkipped;
+                return true;
+            case DCGM_FI_HOSTENGINE_SUBSCRIBER_CALLBACK_USEC:
+                value = m_runStats.lastSubscriberUsec;
+                return true;
+            case DCGM_FI_HOSTENGINE_CACHE_BYTES:
+                value = GetCacheBytesUsed();
+                return true;
+            default:
+                break;
+        }
 
+        if (!m_hostengineStatsCallback)
+            return false;
+        callback = m_hostengineStatsCallback;
+    }
 
-            break;
-        }
+    /* Outside of m_mutex since the callback reaches into other parts of the host engine */
+    callback(hostengineStats);
+    value = (fieldId == DCGM_FI_HOSTENGINE_IPC_QUEUE_DEPTH) ? hostengineStats.ipcQueueDepth
+                                                            : hostengineStats.numConnections;
+    return true;
+}
 
-        case DCGM_FI_DEV_GPU_TEMP:
-        {
-            unsigned int tempUint;
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::BufferOrCacheLatestGpuValue(dcgmcm_update_thread_t *threadCtx,
+                                                           dcgm_field_meta_p fieldMeta)
+{
+    timelib64_t now               = 0;
+    timelib64_t expireTime        = 0;
+    timelib64_t previousQueryUsec = 0;
+    nvmlReturn_t nvmlReturn;
+    nvmlDevice_t nvmlDevice = 0;
 
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetTemperature(nvmlDevice, NVML_TEMPERATURE_GPU, &tempUint);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    if (!threadCtx || !fieldMeta)
+        return DCGM_ST_BADPARAM;
 
-            AppendEntityInt64(threadCtx, (long long)tempUint, 0, now, expireTime);
-            break;
-        }
+    DCGM_TRACE_SCOPE("driver", "GpuFieldValue", fieldMeta->fieldId);
 
-        case DCGM_FI_DEV_GPU_MAX_OP_TEMP: // Fall through is intentional
-        case DCGM_FI_DEV_MEM_MAX_OP_TEMP: // Fall through is intentional
-        case DCGM_FI_DEV_SLOWDOWN_TEMP:   /* Fall through is intentional */
-        case DCGM_FI_DEV_SHUTDOWN_TEMP:
-        {
-            nvmlTemperatureThresholds_t thresholdType = NVML_TEMPERATURE_THRESHOLD_COUNT;
-            unsigned int temp;
+    unsigned int entityId      = threadCtx->entityKey.entityId;
+    unsigned int entityGroupId = threadCtx->entityKey.entityGroupId;
+    unsigned int gpuId         = m_numGpus; // Initialize to an invalid value for check below
 
-            switch (fieldMeta->fieldId)
-            {
-                case DCGM_FI_DEV_GPU_MAX_OP_TEMP:
-                    thresholdType = NVML_TEMPERATURE_THRESHOLD_GPU_MAX;
-                    break;
-                case DCGM_FI_DEV_MEM_MAX_OP_TEMP:
-                    thresholdType = NVML_TEMPERATURE_THRESHOLD_MEM_MAX;
-                    break;
-                case DCGM_FI_DEV_SLOWDOWN_TEMP:
-                    thresholdType = NVML_TEMPERATURE_THRESHOLD_SLOWDOWN;
-                    break;
-                case DCGM_FI_DEV_SHUTDOWN_TEMP:
-                    thresholdType = NVML_TEMPERATURE_THRESHOLD_SHUTDOWN;
-                    break;
-                default:
-                    PRINT_ERROR("%d", "Unexpected temperature threshold type: %d", fieldMeta->fieldId);
-                    AppendEntityInt64(threadCtx, 0, 0, now, expireTime);
-                    return DCGM_ST_NVML_ERROR;
-            }
+    dcgmReturn_t ret = GetGpuId(entityGroupId, entityId, gpuId);
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
+    }
+
+    if (fieldMeta->scope != DCGM_FS_GLOBAL)
+    {
+        if (gpuId >= m_numGpus)
+        {
+            LOG_VERBOSE << "Cannot retrieve GPU value for invalid GPU index: " << gpuId;
+            return DCGM_ST_GENERIC_ERROR;
+        }
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetTemperatureThreshold(nvmlDevice, thresholdType, &temp);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+        nvmlDevice = m_gpus[gpuId].nvmlDevice;
+    }
 
-            AppendEntityInt64(threadCtx, temp, 0, now, expireTime);
+    dcgmcm_watch_info_p watchInfo = threadCtx->watchInfo;
 
-            break;
-        }
+    now = timelib_fastUsecSince1970();
 
-        case DCGM_FI_DEV_POWER_USAGE:
-        {
-            unsigned int powerUint;
-            double powerDbl;
+    /* Expiration is either measured in absolute time or 0 */
+    if (watchInfo && watchInfo->maxAgeUsec)
+        expireTime = now - watchInfo->maxAgeUsec;
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetPowerUsage(nvmlDevice, &powerUint);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityDouble(threadCtx, NvmlErrorToDoubleValue(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+    /* Set without lock before we possibly return on error so we don't get in a hot
+     * polling loop on something that is unsupported or errors. Not getting the lock
+     * ahead of time because we don't want to hold the lock across a driver call that
+     * could be long */
+    if (watchInfo)
+    {
+        previousQueryUsec          = watchInfo->lastQueriedUsec;
+        watchInfo->lastQueriedUsec = now;
+    }
 
-            powerDbl = ((double)powerUint) / 1000.0; /* Convert to watts */
-            AppendEntityDouble(threadCtx, powerDbl, 0, now, expireTime);
-            break;
-        }
+    /* Fields that are one NVML call and a conversion. The switch below has the rest */
+    dcgmcm_gpu_field_fetcher_t const *fetcher = DcgmcmGetGpuFieldFetcher(fieldMeta->fieldId);
+    if (fetcher != nullptr)
+        return FetchGpuFieldValue(threadCtx, *fetcher, gpuId, nvmlDevice, now, expireTime);
 
-        case DCGM_FI_DEV_SM_CLOCK:
+    switch (fieldMeta->fieldId)
+    {
+        case DCGM_FI_DRIVER_VERSION:
         {
-            unsigned int valueI32 = 0;
-
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetClockInfo(nvmlDevice, NVML_CLOCK_SM, &valueI32);
+            char buf[NVML_SYSTEM_DRIVER_VERSION_BUFFER_SIZE] = { 0 };
+            nvmlReturn                                       = nvmlSystemGetDriverVersion(buf, sizeof(buf));
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
             if (nvmlReturn != NVML_SUCCESS)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
+                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-
-            AppendEntityInt64(threadCtx, (long long)valueI32, 0, now, expireTime);
+            AppendEntityString(threadCtx, buf, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_MEM_CLOCK:
+        case DCGM_FI_NVML_VERSION:
         {
-            unsigned int valueI32 = 0;
-
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetClockInfo(nvmlDevice, NVML_CLOCK_MEM, &valueI32);
+            char buf[NVML_SYSTEM_NVML_VERSION_BUFFER_SIZE] = { 0 };
+            nvmlReturn                                     = nvmlSystemGetNVMLVersion(buf, sizeof(buf));
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
             if (nvmlReturn != NVML_SUCCESS)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
+                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-
-            AppendEntityInt64(threadCtx, (long long)valueI32, 0, now, expireTime);
+            AppendEntityString(threadCtx, buf, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_VIDEO_CLOCK:
+        case DCGM_FI_PROCESS_NAME:
         {
-            unsigned int valueI32 = 0;
-
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetClockInfo(nvmlDevice, NVML_CLOCK_VIDEO, &valueI32);
+            char buf[128] = { 0 };
+            nvmlReturn    = nvmlSystemGetProcessName((unsigned int)getpid(), buf, sizeof(buf) - 1);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
             if (nvmlReturn != NVML_SUCCESS)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
+                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-
-            AppendEntityInt64(threadCtx, (long long)valueI32, 0, now, expireTime);
+            AppendEntityString(threadCtx, buf, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_MAX_SM_CLOCK: /* Intentional fall-through */
-        case DCGM_FI_DEV_MAX_MEM_CLOCK:
-        case DCGM_FI_DEV_MAX_VIDEO_CLOCK:
+        case DCGM_FI_DEV_COUNT:
         {
-            unsigned int valueI32 = 0;
-            nvmlClockType_t clockType;
-
-            if (fieldMeta->fieldId == DCGM_FI_DEV_MAX_SM_CLOCK)
-                clockType = NVML_CLOCK_SM;
-            else if (fieldMeta->fieldId == DCGM_FI_DEV_MAX_MEM_CLOCK)
-                clockType = NVML_CLOCK_MEM;
-            else // Assume video clock
-                clockType = NVML_CLOCK_VIDEO;
+            unsigned int deviceCount = 0;
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetMaxClockInfo(nvmlDevice, clockType, &valueI32);
+            nvmlReturn = nvmlDeviceGetCount_v2(&deviceCount);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
             if (nvmlReturn != NVML_SUCCESS)
@@ -8429,347 +11967,356 @@ dcgmReturn_t DcgmCacheManager::BufferOrCacheLatestGpuValue(dcgmcm_update_thread_
                 AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-
-            AppendEntityInt64(threadCtx, (long long)valueI32, 0, now, expireTime);
+            AppendEntityInt64(threadCtx, (long long)deviceCount, 0, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_FAN_SPEED:
+        case DCGM_FI_CUDA_DRIVER_VERSION:
         {
-            unsigned int valueI32 = 0;
+            int systemCudaVersion = 0;
+            nvmlReturn            = nvmlSystemGetCudaDriverVersion_v2(&systemCudaVersion);
 
-            nvmlReturn
-                = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT : nvmlDeviceGetFanSpeed(nvmlDevice, &valueI32);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
             if (nvmlReturn != NVML_SUCCESS)
             {
                 AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
 
-            AppendEntityInt64(threadCtx, (long long)valueI32, 0, now, expireTime);
+            AppendEntityInt64(threadCtx, (long long)systemCudaVersion, 0, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_PCIE_TX_THROUGHPUT:
+        case DCGM_FI_HOSTENGINE_UPDATE_LOOP_USEC:
+        case DCGM_FI_HOSTENGINE_UPDATE_OVERRUNS:
+        case DCGM_FI_HOSTENGINE_SUBSCRIBER_CALLBACK_USEC:
+        case DCGM_FI_HOSTENGINE_IPC_QUEUE_DEPTH:
+        case DCGM_FI_HOSTENGINE_CONNECTIONS:
+        case DCGM_FI_HOSTENGINE_CACHE_BYTES:
         {
-            /* Not supported */
-            nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-            return NvmlReturnToDcgmReturn(nvmlReturn);
-        }
+            long long value = 0;
+            if (!ReadHostengineStat(fieldMeta->fieldId, value))
+            {
+                if (watchInfo)
+                    watchInfo->lastStatus = NVML_ERROR_NOT_SUPPORTED;
+                AppendEntityInt64(threadCtx, DCGM_INT64_NOT_SUPPORTED, 0, now, expireTime);
+                return DCGM_ST_NOT_SUPPORTED;
+            }
 
-        case DCGM_FI_DEV_PCIE_RX_THROUGHPUT:
-        {
-            /* Not supported */
-            nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
             if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-            return NvmlReturnToDcgmReturn(nvmlReturn);
+                watchInfo->lastStatus = NVML_SUCCESS;
+            AppendEntityInt64(threadCtx, value, 0, now, expireTime);
+            break;
         }
 
-        case DCGM_FI_DEV_PCIE_REPLAY_COUNTER:
+        case DCGM_FI_DEV_NAME:
         {
-            unsigned int counter = 0;
+            char buf[NVML_DEVICE_NAME_BUFFER_SIZE] = { 0 };
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetPcieReplayCounter(nvmlDevice, &counter);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
+            switch (entityGroupId)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+                case DCGM_FE_GPU:
+                    nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
+                                                         : nvmlDeviceGetName(nvmlDevice, buf, sizeof(buf));
+                    if (watchInfo)
+                    {
+                        watchInfo->lastStatus = nvmlReturn;
+                    }
 
-            AppendEntityInt64(threadCtx, (long long)counter, 0, now, expireTime);
-            break;
-        }
+                    if (nvmlReturn != NVML_SUCCESS)
+                    {
+                        AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
+                        return NvmlReturnToDcgmReturn(nvmlReturn);
+                    }
+                    AppendEntityString(threadCtx, buf, now, expireTime);
+                    break;
 
-        case DCGM_FI_DEV_GPU_UTIL:
-        case DCGM_FI_DEV_MEM_COPY_UTIL:
-        {
-            nvmlUtilization_t utilization;
-            unsigned int valueI32;
+                case DCGM_FE_GPU_I:
+                {
+                    DcgmGpuInstance *instance = FindGpuInstance(gpuId, DcgmNs::Mig::GpuInstanceId { entityId });
+                    if (instance == nullptr || instance->GetProfileName().empty())
+                    {
+                        snprintf(buf, sizeof(buf), "%s", DCGM_STR_BLANK);
+                    }
+                    else
+                    {
+                        snprintf(buf, sizeof(buf), "%s", instance->GetProfileName().c_str());
+                    }
+                    AppendEntityString(threadCtx, buf, now, expireTime);
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetUtilizationRates(nvmlDevice, &utilization);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
+                    break;
+                }
 
-            if (fieldMeta->fieldId == DCGM_FI_DEV_GPU_UTIL)
-                valueI32 = utilization.gpu;
-            else
-                valueI32 = utilization.memory;
-            AppendEntityInt64(threadCtx, (long long)valueI32, 0, now, expireTime);
-            break;
-        }
+                case DCGM_FE_GPU_CI:
+                {
+                    DcgmNs::Mig::GpuInstanceId gpuInstanceId {};
+                    ret = m_migManager.GetInstanceIdFromComputeInstanceId(DcgmNs::Mig::ComputeInstanceId { entityId },
+                                                                          gpuInstanceId);
+                    if (ret != DCGM_ST_OK)
+                    {
+                        snprintf(buf, sizeof(buf), "%s", DCGM_STR_BLANK);
+                    }
+                    else
+                    {
+                        DcgmGpuInstance *instance = FindGpuInstance(gpuId, gpuInstanceId);
+                        dcgmcm_gpu_compute_instance_t ci {};
+                        ret = DCGM_ST_INSTANCE_NOT_FOUND;
+                        if (instance != nullptr)
+                        {
+                            ret = instance->GetComputeInstanceById(DcgmNs::Mig::ComputeInstanceId { entityId }, ci);
+                        }
+                        if (ret != DCGM_ST_OK || ci.profileName.empty())
+                        {
+                            snprintf(buf, sizeof(buf), "%s", DCGM_STR_BLANK);
+                        }
+                        else
+                        {
+                            snprintf(buf, sizeof(buf), "%s", ci.profileName.c_str());
+                        }
+                    }
 
-        case DCGM_FI_DEV_ENC_UTIL:
-        {
-            unsigned int encUtil;
-            unsigned int samplingPeriodUs;
+                    AppendEntityString(threadCtx, buf, now, expireTime);
+                    break;
+                }
 
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetEncoderUtilization(nvmlDevice, &encUtil, &samplingPeriodUs);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                default:
+                {
+                    snprintf(buf, sizeof(buf), "Unsupported entity group");
+                    AppendEntityString(threadCtx, buf, now, expireTime);
+                    break;
+                }
             }
-
-            AppendEntityInt64(threadCtx, encUtil, 0, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_DEC_UTIL:
+        case DCGM_FI_DEV_BRAND:
         {
-            unsigned int decUtil;
-            unsigned int samplingPeriodUs;
-
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetDecoderUtilization(nvmlDevice, &decUtil, &samplingPeriodUs);
+            nvmlBrandType_t brand;
+            char *brandString = 0;
+            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT : nvmlDeviceGetBrand(nvmlDevice, &brand);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
             if (nvmlReturn != NVML_SUCCESS)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
+                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
 
-            AppendEntityInt64(threadCtx, decUtil, 0, now, expireTime);
-            break;
-        }
-
-        case DCGM_FI_DEV_AUTOBOOST:
-        {
-            nvmlEnableState_t isEnabled, defaultIsEnabled;
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetAutoBoostedClocksEnabled(nvmlDevice, &isEnabled, &defaultIsEnabled);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
+            /* String constants stolen from nvsmi/reporting.c. Using switch instead
+             * of table in case more are added */
+            switch (brand)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                case NVML_BRAND_QUADRO:
+                    brandString = (char *)"Quadro";
+                    break;
+                case NVML_BRAND_TESLA:
+                    brandString = (char *)"Tesla";
+                    break;
+                case NVML_BRAND_NVS:
+                    brandString = (char *)"NVS";
+                    break;
+                case NVML_BRAND_GRID:
+                    brandString = (char *)"Grid";
+                    break;
+                case NVML_BRAND_GEFORCE:
+                    brandString = (char *)"GeForce";
+                    break;
+                case NVML_BRAND_TITAN:
+                    brandString = (char *)"Titan";
+                    break;
+                case NVML_BRAND_UNKNOWN:
+                default:
+                    brandString = (char *)"Unknown";
+                    break;
             }
 
-            AppendEntityInt64(threadCtx, isEnabled, 0, now, expireTime);
+            AppendEntityString(threadCtx, brandString, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_POWER_MGMT_LIMIT:
+        case DCGM_FI_DEV_NVML_INDEX:
         {
-            unsigned int powerLimitInt;
-            double powerLimitDbl;
-
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetPowerManagementLimit(nvmlDevice, &powerLimitInt);
+            /* There's really no point in making the call since we passed in what we want */
             if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                AppendEntityDouble(threadCtx, NvmlErrorToDoubleValue(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-
-            powerLimitDbl = powerLimitInt / 1000;
-            AppendEntityDouble(threadCtx, powerLimitDbl, 0, now, expireTime);
-
+                watchInfo->lastStatus = NVML_SUCCESS;
+            AppendEntityInt64(threadCtx, GpuIdToNvmlIndex(gpuId), 0, now, expireTime);
             break;
         }
 
-
-        case DCGM_FI_DEV_POWER_MGMT_LIMIT_DEF:
+        case DCGM_FI_DEV_CPU_AFFINITY_0:
+        case DCGM_FI_DEV_CPU_AFFINITY_1:
+        case DCGM_FI_DEV_CPU_AFFINITY_2:
+        case DCGM_FI_DEV_CPU_AFFINITY_3:
         {
-            unsigned int defaultPowerLimitInt;
-            double defaultPowerLimitDbl;
+            long long saveValue = 0;
+            long long values[4] = { 0 };
+            unsigned int Nlongs = (sizeof(long) == 8) ? 4 : 8;
+            int affinityIndex   = fieldMeta->fieldId - DCGM_FI_DEV_CPU_AFFINITY_0;
 
             nvmlReturn = (nvmlDevice == nullptr)
                              ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetPowerManagementDefaultLimit(nvmlDevice, &defaultPowerLimitInt);
+                             : nvmlDeviceGetCpuAffinity(nvmlDevice, Nlongs, (unsigned long *)&values[0]);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
+            if (nvmlReturn != NVML_SUCCESS)
             {
-                AppendEntityDouble(threadCtx, NvmlErrorToDoubleValue(nvmlReturn), 0, now, expireTime);
+                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
 
-            defaultPowerLimitDbl = defaultPowerLimitInt / 1000;
-            AppendEntityDouble(threadCtx, defaultPowerLimitDbl, 0, now, expireTime);
+            /* Save the value that corresponds with the requested field */
+            saveValue = values[affinityIndex];
 
+            AppendEntityInt64(threadCtx, saveValue, 0, now, expireTime);
             break;
         }
 
-
-        case DCGM_FI_DEV_POWER_MGMT_LIMIT_MAX: /* fall-through is intentional */
-        case DCGM_FI_DEV_POWER_MGMT_LIMIT_MIN:
+        case DCGM_FI_DEV_UUID:
         {
-            unsigned int maxLimitInt, minLimitInt;
-
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetPowerManagementLimitConstraints(nvmlDevice, &minLimitInt, &maxLimitInt);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                AppendEntityDouble(threadCtx, NvmlErrorToDoubleValue(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-
-            if (fieldMeta->fieldId == DCGM_FI_DEV_POWER_MGMT_LIMIT_MAX)
+            if (m_gpus[gpuId].status == DcgmEntityStatusFake)
             {
-                AppendEntityDouble(threadCtx, maxLimitInt / 1000, 0, now, expireTime);
+                AppendEntityString(threadCtx, m_gpus[gpuId].uuid, now, expireTime);
             }
             else
             {
-                AppendEntityDouble(threadCtx, minLimitInt / 1000, 0, now, expireTime);
-            }
+                char buf[DCGM_DEVICE_UUID_BUFFER_SIZE] = { 0 };
 
+                nvmlReturn = NVML_ERROR_INVALID_ARGUMENT;
+                if (nvmlDevice != nullptr)
+                {
+                    nvmlReturn = nvmlDeviceGetUUID(nvmlDevice, buf, sizeof(buf));
+                }
 
-            break;
-        }
+                if (watchInfo)
+                {
+                    watchInfo->lastStatus = nvmlReturn;
+                }
 
-        case DCGM_FI_DEV_APP_SM_CLOCK:
-        {
-            unsigned int procClk;
+                if (nvmlReturn != NVML_SUCCESS)
+                {
+                    AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
+                    return NvmlReturnToDcgmReturn(nvmlReturn);
+                }
 
-            nvmlReturn = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetApplicationsClock(nvmlDevice, NVML_CLOCK_GRAPHICS, &procClk);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                AppendEntityString(threadCtx, buf, now, expireTime);
             }
 
-            AppendEntityInt64(threadCtx, procClk, 0, now, expireTime);
-
             break;
         }
 
-        case DCGM_FI_DEV_APP_MEM_CLOCK:
+        case DCGM_FI_DEV_MINOR_NUMBER:
         {
-            unsigned int memClk;
-
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetApplicationsClock(nvmlDevice, NVML_CLOCK_MEM, &memClk);
+            unsigned int minorNumber = 0;
+            nvmlReturn               = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
+                                                 : nvmlDeviceGetMinorNumber(nvmlDevice, &minorNumber);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
+            if (nvmlReturn != NVML_SUCCESS)
             {
                 AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
 
-            AppendEntityInt64(threadCtx, memClk, 0, now, expireTime);
-
+            AppendEntityInt64(threadCtx, (long long)minorNumber, 1, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_CLOCK_THROTTLE_REASONS:
+        case DCGM_FI_DEV_CUDA_COMPUTE_CAPABILITY:
         {
-            unsigned long long clockThrottleReasons = 0;
-            nvmlReturn                              = (nvmlDevice == nullptr)
-                             ? NVML_ERROR_INVALID_ARGUMENT
-                             : nvmlDeviceGetCurrentClocksThrottleReasons(nvmlDevice, &clockThrottleReasons);
+            int major     = 0;
+            int minor     = 0;
+            long long ccc = 0;
+            nvmlReturn    = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
+                                                 : nvmlDeviceGetCudaComputeCapability(nvmlDevice, &major, &minor);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
             if (nvmlReturn != NVML_SUCCESS)
             {
                 AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
+                return (NvmlReturnToDcgmReturn(nvmlReturn));
             }
 
-            AppendEntityInt64(threadCtx, clockThrottleReasons, 0, now, expireTime);
-            break;
-        }
-
-        case DCGM_FI_DEV_SUPPORTED_CLOCKS:
-        {
-            AppendDeviceSupportedClocks(threadCtx, nvmlDevice, now, expireTime);
+            // Store the major version in the upper 16 bits, and the minor version in the lower 16 bits
+            ccc = ((long long)major << 16) | minor;
+            AppendEntityInt64(threadCtx, ccc, 1, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_BAR1_TOTAL:
-        case DCGM_FI_DEV_BAR1_USED:
-        case DCGM_FI_DEV_BAR1_FREE:
+        case DCGM_FI_DEV_INFOROM_CONFIG_VALID:
         {
-            nvmlBAR1Memory_t bar1Memory;
-            long long value;
+            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT : nvmlDeviceValidateInforom(nvmlDevice);
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetBAR1MemoryInfo(nvmlDevice, &bar1Memory);
             if (watchInfo)
                 watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
+            if (nvmlReturn != NVML_SUCCESS && nvmlReturn != NVML_ERROR_CORRUPTED_INFOROM)
             {
                 AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
 
-            if (fieldMeta->fieldId == DCGM_FI_DEV_BAR1_TOTAL)
-                value = (long long)bar1Memory.bar1Total;
-            else if (fieldMeta->fieldId == DCGM_FI_DEV_BAR1_USED)
-                value = (long long)bar1Memory.bar1Used;
-            else // DCGM_FI_DEV_BAR1_FREE
-                value = (long long)bar1Memory.bar1Free;
+            unsigned long long valid = ((nvmlReturn == NVML_SUCCESS) ? 1 : 0);
 
-            value = value / 1024 / 1024;
-            AppendEntityInt64(threadCtx, value, 0, now, expireTime);
+            AppendEntityInt64(threadCtx, valid, 0, now, expireTime);
             break;
         }
 
-        case DCGM_FI_DEV_FB_TOTAL:
-        case DCGM_FI_DEV_FB_USED:
-        case DCGM_FI_DEV_FB_FREE:
+        case DCGM_FI_DEV_VGPU_LICENSE_STATUS:
         {
-            nvmlMemory_t fbMemory;
-            unsigned int total, used, free;
+            nvmlGridLicensableFeatures_t licFeat;
 
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetMemoryInfo(nvmlDevice, &fbMemory);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
+            nvmlReturn = nvmlDeviceGetGridLicensableFeatures(nvmlDevice, &licFeat);
+
+            if (nvmlReturn != NVML_SUCCESS)
             {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
+                AppendEntityString(threadCtx, NvmlErrorToStringValue(nvmlReturn), now, expireTime);
                 return NvmlReturnToDcgmReturn(nvmlReturn);
             }
 
-            if (fieldMeta->fieldId == DCGM_FI_DEV_FB_TOTAL)
-            {
-                total = fbMemory.total / (1024 * 1024);
-                AppendEntityInt64(threadCtx, total, 0, now, expireTime);
-            }
-            else if (fieldMeta->fieldId == DCGM_FI_DEV_FB_USED)
+            if (!licFeat.isGridLicenseSupported)
             {
-                used = fbMemory.used / (1024 * 1024);
-                AppendEntityInt64(threadCtx, used, 0, now, expireTime);
+                AppendEntityInt64(threadCtx, (long long)0, 0, now, expireTime);
+                return NvmlReturnToDcgmReturn(nvmlReturn);
             }
-            else
+
+            for (int i = 0; i < licFeat.licensableFeaturesCount; i++)
             {
-                free = fbMemory.free / (1024 * 1024);
-                AppendEntityInt64(threadCtx, free, 0, now, expireTime);
+                if (licFeat.gridLicensableFeatures[i].featureCode == NVML_GRID_LICENSE_FEATURE_CODE_VGPU)
+                {
+                    AppendEntityInt64(threadCtx,
+                                      (long long)(licFeat.gridLicensableFeatures[i].featureState > 0) ? 1 : 0,
+                                      0,
+                                      now,
+                                      expireTime);
+
+                    break;
+                }
             }
+
+            break;
+        }
+
+        case DCGM_FI_DEV_PCIE_TX_THROUGHPUT:
+        {
+            /* Not supported */
+            nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
+            if (watchInfo)
+                watchInfo->lastStatus = nvmlReturn;
+            AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
+            return NvmlReturnToDcgmReturn(nvmlReturn);
+        }
+
+        case DCGM_FI_DEV_PCIE_RX_THROUGHPUT:
+        {
+            /* Not supported */
+            nvmlReturn = NVML_ERROR_NOT_SUPPORTED;
+            if (watchInfo)
+                watchInfo->lastStatus = nvmlReturn;
+            AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
+            return NvmlReturnToDcgmReturn(nvmlReturn);
+        }
+
+        case DCGM_FI_DEV_SUPPORTED_CLOCKS:
+        {
+            AppendDeviceSupportedClocks(threadCtx, nvmlDevice, now, expireTime);
             break;
         }
 
@@ -9489,27 +13036,6 @@ dcgmReturn_t DcgmCacheManager::BufferOrCacheLatestGpuValue(dcgmcm_update_thread_
             break;
         }
 
-        case DCGM_FI_DEV_ENFORCED_POWER_LIMIT:
-        {
-            unsigned int powerLimitInt;
-            double powerLimitDbl;
-
-            nvmlReturn = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetEnforcedPowerLimit(nvmlDevice, &powerLimitInt);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (NVML_SUCCESS != nvmlReturn)
-            {
-                AppendEntityDouble(threadCtx, NvmlErrorToDoubleValue(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-
-            powerLimitDbl = powerLimitInt / 1000;
-            AppendEntityDouble(threadCtx, powerLimitDbl, 0, now, expireTime);
-
-            break;
-        }
-
         case DCGM_FI_DEV_GPU_UTIL_SAMPLES:
         case DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES:
         {
@@ -9704,86 +13230,6 @@ dcgmReturn_t DcgmCacheManager::BufferOrCacheLatestGpuValue(dcgmcm_update_thread_
             break;
         }
 
-        case DCGM_FI_DEV_PCIE_MAX_LINK_GEN:
-        {
-            unsigned int value = 0;
-            nvmlReturn         = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetMaxPcieLinkGeneration(nvmlDevice, &value);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityInt64(threadCtx, (long long)value, 0, now, expireTime);
-            break;
-        }
-
-        case DCGM_FI_DEV_PCIE_MAX_LINK_WIDTH:
-        {
-            unsigned int value = 0;
-            nvmlReturn         = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetMaxPcieLinkWidth(nvmlDevice, &value);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityInt64(threadCtx, (long long)value, 0, now, expireTime);
-            break;
-        }
-
-        case DCGM_FI_DEV_PCIE_LINK_GEN:
-        {
-            unsigned int value = 0;
-            nvmlReturn         = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetCurrPcieLinkGeneration(nvmlDevice, &value);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityInt64(threadCtx, (long long)value, 0, now, expireTime);
-            break;
-        }
-
-        case DCGM_FI_DEV_PCIE_LINK_WIDTH:
-        {
-            unsigned int value = 0;
-            nvmlReturn         = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetCurrPcieLinkWidth(nvmlDevice, &value);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityInt64(threadCtx, (long long)value, 0, now, expireTime);
-            break;
-        }
-
-        case DCGM_FI_DEV_PSTATE:
-        {
-            nvmlPstates_t value = NVML_PSTATE_UNKNOWN;
-            nvmlReturn          = (nvmlDevice == nullptr) ? NVML_ERROR_INVALID_ARGUMENT
-                                                 : nvmlDeviceGetPerformanceState(nvmlDevice, &value);
-            if (watchInfo)
-                watchInfo->lastStatus = nvmlReturn;
-            if (nvmlReturn != NVML_SUCCESS)
-            {
-                AppendEntityInt64(threadCtx, NvmlErrorToInt64Value(nvmlReturn), 0, now, expireTime);
-                return NvmlReturnToDcgmReturn(nvmlReturn);
-            }
-            AppendEntityInt64(threadCtx, (long long)value, 0, now, expireTime);
-            break;
-        }
-
         case DCGM_FI_DEV_XID_ERRORS:
         case DCGM_FI_DEV_GPU_NVLINK_ERRORS:
             break; /* These are handled by the NVML event thread (m_eventThread) */
@@ -10078,7 +13524,7 @@ void DcgmCacheManager::ReadAndCacheNvLinkBandwidthTotal(dcgmcm_update_thread_t *
         return;
     }
 
-    double valueDbl = (double)(currentSum - prevValue->val2.i64);
+    double valueDbl = (double)CounterIncrease(prevValue->val2.i64, currentSum);
     valueDbl /= timeDiffSec; /* Convert to bytes/second */
     valueDbl /= 1000.0;      /* Convert to KiB/sec -> MiB/sec */
 
@@ -10132,6 +13578,7 @@ dcgmReturn_t DcgmCacheManager::ManageVgpuList(unsigned int gpuId, nvmlVgpuInstan
                 continue;
             }
 
+            memset(vgpuInfo, 0, sizeof(*vgpuInfo));
             vgpuInfo->vgpuId = vgpuInstanceIds[i + 1];
             vgpuInfo->found  = 1;
             vgpuInfo->next   = NULL;
@@ -10224,6 +13671,24 @@ dcgmReturn_t DcgmCacheManager::ManageVgpuList(unsigned int gpuId, nvmlVgpuInstan
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+dcgmcm_vgpu_info_p DcgmCacheManager::FindVgpuInfo(nvmlVgpuInstance_t vgpuId, unsigned int &gpuId)
+{
+    for (unsigned int i = 0; i < m_numGpus; i++)
+    {
+        for (dcgmcm_vgpu_info_p curr = m_gpus[i].vgpuList; curr; curr = curr->next)
+        {
+            if (curr->vgpuId == vgpuId)
+            {
+                gpuId = i;
+                return curr;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
 dcgmReturn_t DcgmCacheManager::GetDeviceFBCSessionsInfo(nvmlDevice_t nvmlDevice,
                                                         dcgmcm_update_thread_t *threadCtx,
                                                         dcgmcm_watch_info_p watchInfo,
@@ -10309,6 +13774,7 @@ dcgmReturn_t DcgmCacheManager::GetDeviceFBCSessionsInfo(nvmlDevice_t nvmlDevice,
 }
 
 dcgmReturn_t DcgmCacheManager::GetVgpuInstanceFBCSessionsInfo(nvmlVgpuInstance_t vgpuId,
+                                                              unsigned int gpuId,
                                                               dcgmcm_update_thread_t *threadCtx,
                                                               dcgmcm_watch_info_p watchInfo,
                                                               timelib64_t now,
@@ -10316,7 +13782,7 @@ dcgmReturn_t DcgmCacheManager::GetVgpuInstanceFBCSessionsInfo(nvmlVgpuInstance_t
 {
     dcgmDeviceFbcSessions_t *vgpuFbcSessions = NULL;
     nvmlFBCSessionInfo_t *sessionInfo        = NULL;
-    unsigned int i, sessionCount = 0;
+    unsigned int i, numDeviceSessions = 0;
     nvmlReturn_t nvmlReturn;
 
     vgpuFbcSessions = (dcgmDeviceFbcSessions_t *)malloc(sizeof(*vgpuFbcSessions));
@@ -10326,61 +13792,40 @@ dcgmReturn_t DcgmCacheManager::GetVgpuInstanceFBCSessionsInfo(nvmlVgpuInstance_t
         return DCGM_ST_MEMORY;
     }
 
-    nvmlReturn = nvmlVgpuInstanceGetFBCSessions(vgpuId, &sessionCount, NULL);
-    if (watchInfo)
-        watchInfo->lastStatus = nvmlReturn;
-
-    if (nvmlReturn != NVML_SUCCESS || sessionCount == 0)
-    {
-        vgpuFbcSessions->version      = dcgmDeviceFbcSessions_version;
-        vgpuFbcSessions->sessionCount = 0;
-        int payloadSize               = sizeof(*vgpuFbcSessions) - sizeof(vgpuFbcSessions->sessionInfo);
-        AppendEntityBlob(threadCtx, vgpuFbcSessions, payloadSize, now, expireTime);
-        free(vgpuFbcSessions);
-        return NvmlReturnToDcgmReturn(nvmlReturn);
-    }
-
-    sessionInfo = (nvmlFBCSessionInfo_t *)malloc(sizeof(*sessionInfo) * (sessionCount));
-    if (!sessionInfo)
-    {
-        PRINT_ERROR("%d", "malloc of %d bytes failed", (int)(sizeof(*sessionInfo) * (sessionCount)));
-        free(vgpuFbcSessions);
-        return DCGM_ST_MEMORY;
-    }
-
-    nvmlReturn = nvmlVgpuInstanceGetFBCSessions(vgpuId, &sessionCount, sessionInfo);
+    /* One call per GPU per update cycle covers the sessions of all of its vGPU instances */
+    nvmlReturn = GetBatchedGpuValues(threadCtx, gpuId, m_gpus[gpuId].nvmlDevice, DcgmcmBatchedFbcSessions);
     if (watchInfo)
         watchInfo->lastStatus = nvmlReturn;
-    if (nvmlReturn != NVML_SUCCESS)
+    if (nvmlReturn == NVML_SUCCESS)
     {
-        PRINT_ERROR(
-            "%d %u", "nvmlVgpuInstanceGetFBCSessions failed with status %d for vgpuId %u", (int)nvmlReturn, vgpuId);
-        free(sessionInfo);
-        free(vgpuFbcSessions);
-        return NvmlReturnToDcgmReturn(nvmlReturn);
+        sessionInfo       = threadCtx->batchedValues[gpuId].fbcSessions;
+        numDeviceSessions = threadCtx->batchedValues[gpuId].numFbcSessions;
     }
 
     vgpuFbcSessions->version      = dcgmDeviceFbcSessions_version;
-    vgpuFbcSessions->sessionCount = sessionCount;
+    vgpuFbcSessions->sessionCount = 0;
 
-    for (i = 0; i < sessionCount; i++)
+    for (i = 0; i < numDeviceSessions; i++)
     {
+        if (sessionInfo[i].vgpuInstance != vgpuId)
+            continue;
         if (vgpuFbcSessions->sessionCount >= DCGM_MAX_FBC_SESSIONS)
             break; /* Don't overflow data structure */
 
-        vgpuFbcSessions->sessionInfo[i].version        = dcgmDeviceFbcSessionInfo_version;
-        vgpuFbcSessions->sessionInfo[i].vgpuId         = sessionInfo[i].vgpuInstance;
-        vgpuFbcSessions->sessionInfo[i].sessionId      = sessionInfo[i].sessionId;
-        vgpuFbcSessions->sessionInfo[i].pid            = sessionInfo[i].pid;
-        vgpuFbcSessions->sessionInfo[i].displayOrdinal = sessionInfo[i].displayOrdinal;
-        vgpuFbcSessions->sessionInfo[i].sessionType    = (dcgmFBCSessionType_t)sessionInfo[i].sessionType;
-        vgpuFbcSessions->sessionInfo[i].sessionFlags   = sessionInfo[i].sessionFlags;
-        vgpuFbcSessions->sessionInfo[i].hMaxResolution = sessionInfo[i].hMaxResolution;
-        vgpuFbcSessions->sessionInfo[i].vMaxResolution = sessionInfo[i].vMaxResolution;
-        vgpuFbcSessions->sessionInfo[i].hResolution    = sessionInfo[i].hResolution;
-        vgpuFbcSessions->sessionInfo[i].vResolution    = sessionInfo[i].vResolution;
-        vgpuFbcSessions->sessionInfo[i].averageFps     = sessionInfo[i].averageFPS;
-        vgpuFbcSessions->sessionInfo[i].averageLatency = sessionInfo[i].averageLatency;
+        dcgmDeviceFbcSessionInfo_t &session = vgpuFbcSessions->sessionInfo[vgpuFbcSessions->sessionCount++];
+        session.version                     = dcgmDeviceFbcSessionInfo_version;
+        session.vgpuId                      = sessionInfo[i].vgpuInstance;
+        session.sessionId                   = sessionInfo[i].sessionId;
+        session.pid                         = sessionInfo[i].pid;
+        session.displayOrdinal              = sessionInfo[i].displayOrdinal;
+        session.sessionType                 = (dcgmFBCSessionType_t)sessionInfo[i].sessionType;
+        session.sessionFlags                = sessionInfo[i].sessionFlags;
+        session.hMaxResolution              = sessionInfo[i].hMaxResolution;
+        session.vMaxResolution              = sessionInfo[i].vMaxResolution;
+        session.hResolution                 = sessionInfo[i].hResolution;
+        session.vResolution                 = sessionInfo[i].vResolution;
+        session.averageFps                  = sessionInfo[i].averageFPS;
+        session.averageLatency              = sessionInfo[i].averageLatency;
     }
 
     /* Only store as much as is actually populated */
@@ -10388,9 +13833,8 @@ dcgmReturn_t DcgmCacheManager::GetVgpuInstanceFBCSessionsInfo(nvmlVgpuInstance_t
                       + (vgpuFbcSessions->sessionCount * sizeof(vgpuFbcSessions->sessionInfo[0]));
 
     AppendEntityBlob(threadCtx, vgpuFbcSessions, payloadSize, now, expireTime);
-    free(sessionInfo);
     free(vgpuFbcSessions);
-    return DCGM_ST_OK;
+    return NvmlReturnToDcgmReturn(nvmlReturn);
 }
 
 /*****************************************************************************/
@@ -10414,21 +13858,23 @@ dcgmReturn_t DcgmCacheManager::AppendDeviceAccountingStats(dcgmcm_update_thread_
 
     dcgm_mutex_lock(m_mutex);
 
-    /* Use startTimestamp as the 2nd key since that won't change */
-    if (HasAccountingPidBeenSeen(accountingStats.pid, (timelib64_t)accountingStats.startTimestamp))
-    {
-        dcgm_mutex_unlock(m_mutex);
-        PRINT_DEBUG("%u %llu",
-                    "Skipping pid %u, startTimestamp %llu that has already been seen",
-                    accountingStats.pid,
-                    accountingStats.startTimestamp);
-        return DCGM_ST_OK;
-    }
-
-    /* Cache the PID when the process completes as no further updates will be required for the process */
-    if (accountingStats.activeTimeUsec > 0)
+    /* Only save records that are new or changed. The startTimestamp tells apart processes that reused a PID */
+    auto latest = m_latestAccountingStats.find(DcgmcmAccountingKey(threadCtx->entityKey.entityId, pid));
+    if (latest != m_latestAccountingStats.end() && latest->second.stats.startTimestamp == accountingStats.startTimestamp)
     {
-        CacheAccountingPid(accountingStats.pid, (timelib64_t)accountingStats.startTimestamp);
+        /* A completed process won't change again, even after its record ages out of the cache */
+        bool completed = latest->second.stats.activeTimeUsec > 0;
+        bool unchanged = !memcmp(&latest->second.stats, &accountingStats, sizeof(accountingStats))
+                         && FindCachedAccountingStats(threadCtx->entityKey.entityId, pid, threadCtx->watchInfo);
+        if (completed || unchanged)
+        {
+            dcgm_mutex_unlock(m_mutex);
+            PRINT_DEBUG("%u %llu",
+                        "Skipping pid %u, startTimestamp %llu that has already been seen",
+                        accountingStats.pid,
+                        accountingStats.startTimestamp);
+            return DCGM_ST_OK;
+        }
     }
 
     dcgm_mutex_unlock(m_mutex);
@@ -10801,6 +14247,414 @@ dcgmReturn_t DcgmCacheManager::GetGpuFieldBytesUsed(unsigned int gpuId,
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+void DcgmCacheManager::SetCacheMemoryBudget(long long budgetBytes)
+{
+    DcgmLockGuard dlg(m_mutex);
+    m_cacheBudgetBytes = std::max(0LL, budgetBytes);
+}
+
+/*****************************************************************************/
+long long DcgmCacheManager::GetCacheBytesUsed()
+{
+    long long totalBytes = 0;
+
+    DcgmLockGuard dlg(m_mutex);
+
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        if (watchInfo->timeSeries)
+            totalBytes += timeseries_bytes_used(watchInfo->timeSeries);
+    }
+
+    return totalBytes;
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::SetHostengineStatsCallback(dcgmcm_hostengine_stats_f callback)
+{
+    DcgmLockGuard dlg(m_mutex);
+    m_hostengineStatsCallback = std::move(callback);
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::GetWatcherBytesUsed(std::vector<dcgmcm_watcher_bytes_t> &watcherBytes)
+{
+    watcherBytes.clear();
+
+    DcgmLockGuard dlg(m_mutex);
+
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        if (!watchInfo->timeSeries || watchInfo->watchers.empty())
+            continue;
+
+        long long share = timeseries_bytes_used(watchInfo->timeSeries) / (long long)watchInfo->watchers.size();
+        for (auto &watcherInfo : watchInfo->watchers)
+        {
+            auto it = std::find_if(watcherBytes.begin(), watcherBytes.end(), [&](dcgmcm_watcher_bytes_t &entry) {
+                return entry.watcher == watcherInfo.watcher;
+            });
+            if (it == watcherBytes.end())
+                watcherBytes.push_back({ watcherInfo.watcher, share });
+            else
+                it->bytesUsed += share;
+        }
+    }
+
+    std::sort(watcherBytes.begin(), watcherBytes.end(), [](auto const &a, auto const &b) {
+        return a.bytesUsed > b.bytesUsed;
+    });
+}
+
+/*****************************************************************************/
+/* CPU time of a fetch assumed for fields no watch has measured yet. About a simple NVML getter */
+#define DCGM_CM_DEFAULT_EXEC_USEC 100.0
+
+/* Measured totals of the watches of a field or fetch method. See EstimateWatchCost() */
+struct DcgmcmWatchCostSums
+{
+    long long execTimeUsec = 0;
+    long long fetchCount   = 0;
+    long long bytesUsed    = 0; /* Of string and blob history */
+    long long numSamples   = 0;
+};
+
+/*****************************************************************************/
+unsigned short DcgmCacheManager::GetFetchMethod(dcgm_field_meta_p fieldMeta,
+                                                dcgm_field_entity_group_t entityGroupId,
+                                                dcgm_field_eid_t entityId,
+                                                unsigned long long &batchKey)
+{
+    auto makeKey = [](unsigned long long method, unsigned long long shared, unsigned long long id) {
+        return (method << 56) | (shared << 32) | id;
+    };
+
+    /* Rate fields cost whatever fetching their counter costs */
+    unsigned short counterFieldId = GetRateCounterFieldId(fieldMeta->fieldId);
+    if (counterFieldId)
+        return GetFetchMethod(DcgmFieldGetById(counterFieldId), entityGroupId, entityId, batchKey);
+
+    /* One Collect() per update cycle covers every due watch of the entity group */
+    if (entityGroupId < DCGM_FE_COUNT && m_entityCollectors[entityGroupId])
+    {
+        batchKey = makeKey(DCGM_INTROSPECT_FETCH_COLLECTOR, 0, entityGroupId);
+        return DCGM_INTROSPECT_FETCH_COLLECTOR;
+    }
+
+    if (entityGroupId == DCGM_FE_GPU && fieldMeta->nvmlFieldId > 0)
+    {
+        batchKey = makeKey(DCGM_INTROSPECT_FETCH_FIELD_VALUES, 0, entityId);
+        return DCGM_INTROSPECT_FETCH_FIELD_VALUES;
+    }
+
+    if (entityGroupId == DCGM_FE_GPU)
+    {
+        /* Fields that GetBatchedGpuValues() fetches together */
+        dcgmcm_gpu_field_fetcher_t const *fetcher = DcgmcmGetGpuFieldFetcher(fieldMeta->fieldId);
+        if (fetcher != nullptr && fetcher->batch != DcgmcmBatchedCount)
+        {
+            batchKey = makeKey(DCGM_INTROSPECT_FETCH_SHARED, fetcher->batch, entityId);
+            return DCGM_INTROSPECT_FETCH_SHARED;
+        }
+    }
+
+    batchKey = 0;
+    return DCGM_INTROSPECT_FETCH_SINGLE;
+}
+
+/*****************************************************************************/
+long long DcgmCacheManager::GetKeptSampleCount(timelib64_t monitorFrequencyUsec,
+                                               timelib64_t maxAgeUsec,
+                                               bool isNumeric)
+{
+    if (monitorFrequencyUsec <= 0)
+        return 0;
+
+    if (!maxAgeUsec)
+        maxAgeUsec = m_maxSampleAgeUsec;
+    if (isNumeric && !m_rollupTiers.empty() && (maxAgeUsec == 0 || maxAgeUsec > m_rollupRawRetentionUsec))
+        maxAgeUsec = m_rollupRawRetentionUsec;
+
+    /* One extra sample since quota is enforced after the newest sample is appended */
+    return maxAgeUsec / monitorFrequencyUsec + 1;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::EstimateWatchCost(std::vector<dcgmGroupEntityPair_t> const &entities,
+                                                 std::vector<unsigned short> const &fieldIds,
+                                                 timelib64_t monitorFrequencyUsec,
+                                                 double maxSampleAge,
+                                                 int maxKeepSamples,
+                                                 dcgmIntrospectWatchCost_t &cost)
+{
+    if (monitorFrequencyUsec <= 0 || fieldIds.size() > DCGM_INTROSPECT_WATCH_COST_MAX_FIELDS)
+        return DCGM_ST_BADPARAM;
+
+    timelib64_t const maxAgeUsec = GetMaxAgeUsec(monitorFrequencyUsec, maxSampleAge, maxKeepSamples);
+
+    /* 0 = not watched, so no updates */
+    auto perSecond = [](timelib64_t frequencyUsec) {
+        return frequencyUsec > 0 ? 1000000.0 / (double)frequencyUsec : 0.0;
+    };
+
+    DcgmLockGuard dlg(m_mutex);
+
+    /* What has been measured so far, and the most frequent watch of each batch that shares driver calls */
+    std::unordered_map<unsigned short, DcgmcmWatchCostSums> fieldSums;
+    DcgmcmWatchCostSums methodSums[DCGM_INTROSPECT_FETCH_COLLECTOR + 1];
+    std::unordered_map<unsigned long long, timelib64_t> batchFrequencyUsec;
+
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(watchInfo->watchKey.fieldId);
+        if (!fieldMeta)
+            continue;
+
+        unsigned long long batchKey;
+        unsigned short method = GetFetchMethod(
+            fieldMeta, watchInfo->practicalEntityGroupId, watchInfo->practicalEntityId, batchKey);
+
+        DcgmcmWatchCostSums &sums = fieldSums[fieldMeta->fieldId];
+        sums.execTimeUsec += watchInfo->execTimeUsec;
+        sums.fetchCount += watchInfo->fetchCount;
+        methodSums[method].execTimeUsec += watchInfo->execTimeUsec;
+        methodSums[method].fetchCount += watchInfo->fetchCount;
+
+        if (watchInfo->timeSeries
+            && (watchInfo->timeSeries->tsType == TS_TYPE_STRING || watchInfo->timeSeries->tsType == TS_TYPE_BLOB))
+        {
+            sums.bytesUsed += timeseries_bytes_used(watchInfo->timeSeries);
+            sums.numSamples += timeseries_size(watchInfo->timeSeries);
+        }
+
+        if (batchKey && watchInfo->isWatched && watchInfo->monitorFrequencyUsec > 0)
+        {
+            auto [it, added] = batchFrequencyUsec.try_emplace(batchKey, watchInfo->monitorFrequencyUsec);
+            if (!added)
+                it->second = std::min(it->second, watchInfo->monitorFrequencyUsec);
+        }
+    }
+
+    /* Leave the proposed watch in cost as it came */
+    cost.numFields                 = 0;
+    cost.cpuUsecPerSec             = 0.0;
+    cost.driverCallsPerSec         = 0.0;
+    cost.cacheBytes                = 0;
+    cost.marginalCpuUsecPerSec     = 0.0;
+    cost.marginalDriverCallsPerSec = 0.0;
+    cost.marginalCacheBytes        = 0;
+    memset(cost.fields, 0, sizeof(cost.fields));
+
+    /* Proposed watches by the batch they would join. Each is the index of its field in cost.fields */
+    std::unordered_map<unsigned long long, std::vector<unsigned int>> batchMembers;
+
+    for (unsigned short fieldId : fieldIds)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
+            return DCGM_ST_UNKNOWN_FIELD;
+
+        unsigned int fieldIndex              = cost.numFields++;
+        dcgmIntrospectFieldCost_t &fieldCost = cost.fields[fieldIndex];
+        fieldCost.fieldId                    = fieldId;
+
+        bool isNumeric = fieldMeta->fieldType != DCGM_FT_STRING && fieldMeta->fieldType != DCGM_FT_BINARY;
+        DcgmcmWatchCostSums const &sums = fieldSums[fieldId];
+        if (isNumeric)
+            fieldCost.bytesPerSample = sizeof(timelib64_t) + sizeof(timeseries_value_t);
+        else if (sums.numSamples > 0)
+            fieldCost.bytesPerSample = sums.bytesUsed / sums.numSamples;
+        else
+        {
+            /* The most a value can take until one has been seen */
+            fieldCost.bytesPerSample = sizeof(timeseries_entry_t) + TS_SLAB_ALIGN
+                                       + (fieldMeta->fieldType == DCGM_FT_STRING ? DCGM_MAX_STR_LENGTH
+                                                                                 : DCGM_MAX_BLOB_LENGTH);
+        }
+        fieldCost.samplesKept = GetKeptSampleCount(monitorFrequencyUsec, maxAgeUsec, isNumeric);
+
+        /* Global fields are watched once no matter the entities. See AddFieldWatch() */
+        std::vector<dcgmGroupEntityPair_t> globalEntity { { DCGM_FE_NONE, 0 } };
+        auto const &fieldEntities = fieldMeta->scope == DCGM_FS_GLOBAL ? globalEntity : entities;
+
+        unsigned int methodCounts[DCGM_INTROSPECT_FETCH_COLLECTOR + 1] = {};
+        double totalExecUsec                                           = 0.0;
+
+        for (auto const &entity : fieldEntities)
+        {
+            dcgmcm_watch_info_p watchInfo = m_entityWatches.Get(entity.entityGroupId, entity.entityId, fieldId);
+
+            unsigned long long batchKey;
+            unsigned short method
+                = watchInfo ? GetFetchMethod(
+                      fieldMeta, watchInfo->practicalEntityGroupId, watchInfo->practicalEntityId, batchKey)
+                            : GetFetchMethod(fieldMeta, entity.entityGroupId, entity.entityId, batchKey);
+            methodCounts[method]++;
+
+            double execUsec = DCGM_CM_DEFAULT_EXEC_USEC;
+            if (watchInfo && watchInfo->fetchCount > 0)
+            {
+                execUsec = (double)watchInfo->execTimeUsec / (double)watchInfo->fetchCount;
+                fieldCost.numMeasured++;
+            }
+            else if (sums.fetchCount > 0)
+                execUsec = (double)sums.execTimeUsec / (double)sums.fetchCount;
+            else if (methodSums[method].fetchCount > 0)
+                execUsec = (double)methodSums[method].execTimeUsec / (double)methodSums[method].fetchCount;
+            totalExecUsec += execUsec;
+
+            /* A watch keeps raw samples at its fastest frequency for as long as its fastest watchers
+               want them. Slower watchers are kept by rollup tiers. See UpdateWatchFromWatchers() */
+            bool isWatched               = watchInfo && watchInfo->isWatched;
+            timelib64_t oldFrequencyUsec = isWatched ? watchInfo->monitorFrequencyUsec : 0;
+            timelib64_t oldMaxAgeUsec    = 0;
+            if (isWatched)
+                oldMaxAgeUsec = watchInfo->watcherTiers.empty() ? watchInfo->maxAgeUsec : watchInfo->rawRetentionUsec;
+            timelib64_t newFrequencyUsec
+                = isWatched ? std::min(oldFrequencyUsec, monitorFrequencyUsec) : monitorFrequencyUsec;
+            timelib64_t newMaxAgeUsec = maxAgeUsec;
+            if (isWatched && monitorFrequencyUsec > oldFrequencyUsec)
+                newMaxAgeUsec = oldMaxAgeUsec;
+            else if (isWatched && monitorFrequencyUsec == oldFrequencyUsec)
+                newMaxAgeUsec = (oldMaxAgeUsec && maxAgeUsec) ? std::max(oldMaxAgeUsec, maxAgeUsec) : 0;
+            fieldCost.numWatched += isWatched ? 1 : 0;
+
+            fieldCost.cpuUsecPerSec += execUsec * perSecond(monitorFrequencyUsec);
+            fieldCost.marginalCpuUsecPerSec
+                += execUsec * (perSecond(newFrequencyUsec) - perSecond(oldFrequencyUsec));
+
+            fieldCost.cacheBytes += fieldCost.samplesKept * fieldCost.bytesPerSample;
+            long long oldSamples = isWatched ? GetKeptSampleCount(oldFrequencyUsec, oldMaxAgeUsec, isNumeric) : 0;
+            fieldCost.marginalCacheBytes
+                += (GetKeptSampleCount(newFrequencyUsec, newMaxAgeUsec, isNumeric) - oldSamples)
+                   * fieldCost.bytesPerSample;
+
+            if (batchKey)
+            {
+                batchMembers[batchKey].push_back(fieldIndex);
+            }
+            else
+            {
+                fieldCost.driverCallsPerSec += perSecond(monitorFrequencyUsec);
+                fieldCost.marginalDriverCallsPerSec += perSecond(newFrequencyUsec) - perSecond(oldFrequencyUsec);
+            }
+        }
+
+        fieldCost.numEntities = fieldEntities.size();
+        fieldCost.fetchMethod
+            = std::max_element(methodCounts, methodCounts + DCGM_INTROSPECT_FETCH_COLLECTOR + 1) - methodCounts;
+        if (fieldCost.numEntities > 0)
+            fieldCost.execUsecPerFetch = totalExecUsec / fieldCost.numEntities;
+    }
+
+    /* A batch makes its calls at the rate of its most frequent watch. Split them between its proposed watches */
+    for (auto const &[batchKey, members] : batchMembers)
+    {
+        auto it                      = batchFrequencyUsec.find(batchKey);
+        timelib64_t oldFrequencyUsec = it != batchFrequencyUsec.end() ? it->second : 0;
+        timelib64_t newFrequencyUsec
+            = oldFrequencyUsec ? std::min(oldFrequencyUsec, monitorFrequencyUsec) : monitorFrequencyUsec;
+        double share = 1.0 / (double)members.size();
+
+        for (unsigned int fieldIndex : members)
+        {
+            cost.fields[fieldIndex].driverCallsPerSec += perSecond(monitorFrequencyUsec) * share;
+            cost.fields[fieldIndex].marginalDriverCallsPerSec
+                += (perSecond(newFrequencyUsec) - perSecond(oldFrequencyUsec)) * share;
+        }
+    }
+
+    for (unsigned int i = 0; i < cost.numFields; i++)
+    {
+        dcgmIntrospectFieldCost_t const &fieldCost = cost.fields[i];
+
+        cost.cpuUsecPerSec += fieldCost.cpuUsecPerSec;
+        cost.driverCallsPerSec += fieldCost.driverCallsPerSec;
+        cost.cacheBytes += fieldCost.cacheBytes;
+        cost.marginalCpuUsecPerSec += fieldCost.marginalCpuUsecPerSec;
+        cost.marginalDriverCallsPerSec += fieldCost.marginalDriverCallsPerSec;
+        cost.marginalCacheBytes += fieldCost.marginalCacheBytes;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+int DcgmCacheManager::EnforceCacheMemoryBudget(bool force)
+{
+    DcgmLockGuard dlg(m_mutex);
+
+    timelib64_t now = timelib_usecSince1970();
+    if (!m_cacheBudgetBytes || (!force && now - m_cacheBudgetLastCheckUsec < DCGM_CM_BUDGET_CHECK_USEC))
+        return 0;
+    m_cacheBudgetLastCheckUsec = now;
+
+    long long totalBytes = 0;
+    std::vector<dcgmcm_watch_info_p> candidates;
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        if (!watchInfo->timeSeries)
+            continue;
+
+        totalBytes += timeseries_bytes_used(watchInfo->timeSeries);
+        if (timeseries_size(watchInfo->timeSeries) > 1)
+            candidates.push_back(watchInfo);
+    }
+
+    if (totalBytes <= m_cacheBudgetBytes)
+        return 0;
+
+    if (now - m_cacheBudgetLastWarnUsec >= DCGM_CM_BUDGET_WARN_USEC)
+    {
+        m_cacheBudgetLastWarnUsec = now;
+
+        std::vector<dcgmcm_watcher_bytes_t> watcherBytes;
+        GetWatcherBytesUsed(watcherBytes);
+        DCGM_LOG_WARNING << "The field cache is using " << totalBytes << " bytes of its " << m_cacheBudgetBytes
+                         << " byte budget. Dropping the history of the least recently read watches.";
+        if (!watcherBytes.empty())
+        {
+            DCGM_LOG_WARNING << "The largest user of the field cache is watcher type "
+                             << watcherBytes[0].watcher.watcherType << ", connection "
+                             << watcherBytes[0].watcher.connectionId << " with " << watcherBytes[0].bytesUsed
+                             << " bytes";
+        }
+    }
+
+    /* Never-read watches sort first. Ties go to the largest watch so fewer watches lose their history */
+    std::sort(candidates.begin(), candidates.end(), [](dcgmcm_watch_info_p a, dcgmcm_watch_info_p b) {
+        if (a->lastReadUsec != b->lastReadUsec)
+            return a->lastReadUsec < b->lastReadUsec;
+        return timeseries_bytes_used(a->timeSeries) > timeseries_bytes_used(b->timeSeries);
+    });
+
+    int numTrimmed = 0;
+    for (dcgmcm_watch_info_p watchInfo : candidates)
+    {
+        if (totalBytes <= m_cacheBudgetBytes)
+            break;
+
+        /* Keep the latest sample so that latest-value readers are unaffected */
+        long long bytesBefore = timeseries_bytes_used(watchInfo->timeSeries);
+        timeseries_cursor_t cursor;
+        timeseries_entry_p latest = timeseries_last(watchInfo->timeSeries, &cursor);
+        if (latest)
+            SpillAgedSamples(watchInfo, latest->usecSince1970);
+        timeseries_enforce_quota(watchInfo->timeSeries, 0, 1);
+        timeseries_shrink(watchInfo->timeSeries, DCGM_CM_RING_MIN_CAPACITY);
+        totalBytes -= bytesBefore - timeseries_bytes_used(watchInfo->timeSeries);
+        numTrimmed++;
+
+        DCGM_LOG_DEBUG << "Dropped the history of eg " << watchInfo->watchKey.entityGroupId << ", eid "
+                       << watchInfo->watchKey.entityId << ", fieldId " << watchInfo->watchKey.fieldId
+                       << " to stay within the cache memory budget";
+    }
+
+    m_runStats.budgetTrimCount += numTrimmed;
+    return numTrimmed;
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmCacheManager::GetGlobalFieldBytesUsed(unsigned short dcgmFieldId, long long *bytesUsed)
 {
@@ -10846,67 +14700,175 @@ dcgmReturn_t DcgmCacheManager::GetGlobalFieldBytesUsed(unsigned short dcgmFieldI
             (*bytesUsed) += timeseries_bytes_used(watchInfo->timeSeries);
     }
 
-    dcgm_mutex_unlock(m_mutex);
-
+    dcgm_mutex_unlock(m_mutex);
+
+    if (DCGM_ST_OK != status)
+        return status;
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmCacheManager::CheckValidGlobalField(unsigned short dcgmFieldId)
+{
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(dcgmFieldId);
+
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
+    {
+        PRINT_ERROR("%u", "dcgmFieldId is invalid: %d", dcgmFieldId);
+        return DCGM_ST_UNKNOWN_FIELD;
+    }
+
+    if (fieldMeta->scope != DCGM_FS_GLOBAL)
+    {
+        PRINT_ERROR("%u", "field %u does not have scope DCGM_FS_GLOBAL", dcgmFieldId);
+        return DCGM_ST_BADPARAM;
+    }
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmCacheManager::CheckValidGpuField(unsigned int gpuId, unsigned short dcgmFieldId)
+{
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(dcgmFieldId);
+
+    fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
+    {
+        PRINT_ERROR("%u", "dcgmFieldId does not exist: %d", dcgmFieldId);
+        return DCGM_ST_UNKNOWN_FIELD;
+    }
+
+    if (fieldMeta->scope != DCGM_FS_DEVICE)
+    {
+        PRINT_ERROR("%u", "field %u does not have scope DCGM_FS_DEVICE", dcgmFieldId);
+        return DCGM_ST_BADPARAM;
+    }
+
+    if (gpuId >= m_numGpus)
+    {
+        PRINT_ERROR("%u", "invalid gpuId: %u", gpuId);
+        return DCGM_ST_BADPARAM;
+    }
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmCacheManager::GetGlobalFieldExecTimeUsec(unsigned short dcgmFieldId, long long *totalUsec)
+{
+    dcgmcm_watch_info_p watchInfo;
+
+    if (!totalUsec)
+    {
+        PRINT_ERROR("", "totalUsec cannot be NULL");
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmReturn_t status = CheckValidGlobalField(dcgmFieldId);
+    if (DCGM_ST_OK != status)
+        return status;
+
+    *totalUsec = 0;
+    watchInfo  = GetGlobalWatchInfo(dcgmFieldId, 0);
+    if (watchInfo)
+        *totalUsec = (long long)watchInfo->execTimeUsec;
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmCacheManager::GetGpuFieldExecTimeUsec(unsigned int gpuId,
+                                                       unsigned short dcgmFieldId,
+                                                       long long *totalUsec)
+{
+    dcgmcm_watch_info_p watchInfo;
+
+    if (!totalUsec)
+    {
+        PRINT_ERROR("", "totalUsec cannot be NULL");
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmReturn_t status = CheckValidGpuField(gpuId, dcgmFieldId);
     if (DCGM_ST_OK != status)
         return status;
 
+    *totalUsec = 0;
+    watchInfo  = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, dcgmFieldId, 0);
+    if (watchInfo)
+    {
+        *totalUsec = (long long)watchInfo->execTimeUsec;
+    }
+
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmCacheManager::CheckValidGlobalField(unsigned short dcgmFieldId)
+dcgmReturn_t DcgmCacheManager::GetGlobalFieldExecTimeHistogram(unsigned short dcgmFieldId,
+                                                               long long *maxUsec,
+                                                               long long *histogram)
 {
-    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(dcgmFieldId);
+    dcgmcm_watch_info_p watchInfo;
 
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
+    if (!maxUsec || !histogram)
     {
-        PRINT_ERROR("%u", "dcgmFieldId is invalid: %d", dcgmFieldId);
-        return DCGM_ST_UNKNOWN_FIELD;
+        PRINT_ERROR("", "maxUsec and histogram cannot be NULL");
+        return DCGM_ST_BADPARAM;
     }
 
-    if (fieldMeta->scope != DCGM_FS_GLOBAL)
+    dcgmReturn_t status = CheckValidGlobalField(dcgmFieldId);
+    if (DCGM_ST_OK != status)
+        return status;
+
+    *maxUsec = 0;
+    memset(histogram, 0, sizeof(long long) * DCGM_INTROSPECT_EXEC_TIME_BUCKETS);
+    watchInfo = GetGlobalWatchInfo(dcgmFieldId, 0);
+    if (watchInfo)
     {
-        PRINT_ERROR("%u", "field %u does not have scope DCGM_FS_GLOBAL", dcgmFieldId);
-        return DCGM_ST_BADPARAM;
+        *maxUsec = (long long)watchInfo->maxExecTimeUsec;
+        memcpy(histogram, watchInfo->execTimeHistogram, sizeof(watchInfo->execTimeHistogram));
     }
 
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmCacheManager::CheckValidGpuField(unsigned int gpuId, unsigned short dcgmFieldId)
+dcgmReturn_t DcgmCacheManager::GetGpuFieldExecTimeHistogram(unsigned int gpuId,
+                                                            unsigned short dcgmFieldId,
+                                                            long long *maxUsec,
+                                                            long long *histogram)
 {
-    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(dcgmFieldId);
-
-    fieldMeta = DcgmFieldGetById(dcgmFieldId);
-    if (!fieldMeta || fieldMeta->fieldId == DCGM_FI_UNKNOWN)
-    {
-        PRINT_ERROR("%u", "dcgmFieldId does not exist: %d", dcgmFieldId);
-        return DCGM_ST_UNKNOWN_FIELD;
-    }
+    dcgmcm_watch_info_p watchInfo;
 
-    if (fieldMeta->scope != DCGM_FS_DEVICE)
+    if (!maxUsec || !histogram)
     {
-        PRINT_ERROR("%u", "field %u does not have scope DCGM_FS_DEVICE", dcgmFieldId);
+        PRINT_ERROR("", "maxUsec and histogram cannot be NULL");
         return DCGM_ST_BADPARAM;
     }
 
-    if (gpuId >= m_numGpus)
+    dcgmReturn_t status = CheckValidGpuField(gpuId, dcgmFieldId);
+    if (DCGM_ST_OK != status)
+        return status;
+
+    *maxUsec = 0;
+    memset(histogram, 0, sizeof(long long) * DCGM_INTROSPECT_EXEC_TIME_BUCKETS);
+    watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, dcgmFieldId, 0);
+    if (watchInfo)
     {
-        PRINT_ERROR("%u", "invalid gpuId: %u", gpuId);
-        return DCGM_ST_BADPARAM;
+        *maxUsec = (long long)watchInfo->maxExecTimeUsec;
+        memcpy(histogram, watchInfo->execTimeHistogram, sizeof(watchInfo->execTimeHistogram));
     }
 
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmCacheManager::GetGlobalFieldExecTimeUsec(unsigned short dcgmFieldId, long long *totalUsec)
+dcgmReturn_t DcgmCacheManager::GetGlobalFieldSampleLagHistogram(
+    unsigned short dcgmFieldId,
+    long long maxUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT],
+    long long histogram[][DCGM_INTROSPECT_EXEC_TIME_BUCKETS])
 {
     dcgmcm_watch_info_p watchInfo;
 
-    if (!totalUsec)
+    if (!maxUsec || !histogram)
     {
-        PRINT_ERROR("", "totalUsec cannot be NULL");
+        PRINT_ERROR("", "maxUsec and histogram cannot be NULL");
         return DCGM_ST_BADPARAM;
     }
 
@@ -10914,23 +14876,28 @@ dcgmReturn_t DcgmCacheManager::GetGlobalFieldExecTimeUsec(unsigned short dcgmFie
     if (DCGM_ST_OK != status)
         return status;
 
-    *totalUsec = 0;
-    watchInfo  = GetGlobalWatchInfo(dcgmFieldId, 0);
+    memset(maxUsec, 0, sizeof(long long) * DCGM_INTROSPECT_LAG_STAGE_COUNT);
+    memset(histogram, 0, sizeof(long long) * DCGM_INTROSPECT_LAG_STAGE_COUNT * DCGM_INTROSPECT_EXEC_TIME_BUCKETS);
+    watchInfo = GetGlobalWatchInfo(dcgmFieldId, 0);
     if (watchInfo)
-        *totalUsec = (long long)watchInfo->execTimeUsec;
+    {
+        memcpy(maxUsec, watchInfo->maxSampleLagUsec, sizeof(watchInfo->maxSampleLagUsec));
+        memcpy(histogram, watchInfo->sampleLagHistogram, sizeof(watchInfo->sampleLagHistogram));
+    }
 
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmCacheManager::GetGpuFieldExecTimeUsec(unsigned int gpuId,
-                                                       unsigned short dcgmFieldId,
-                                                       long long *totalUsec)
+dcgmReturn_t DcgmCacheManager::GetGpuFieldSampleLagHistogram(unsigned int gpuId,
+                                                             unsigned short dcgmFieldId,
+                                                             long long maxUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT],
+                                                             long long histogram[][DCGM_INTROSPECT_EXEC_TIME_BUCKETS])
 {
     dcgmcm_watch_info_p watchInfo;
 
-    if (!totalUsec)
+    if (!maxUsec || !histogram)
     {
-        PRINT_ERROR("", "totalUsec cannot be NULL");
+        PRINT_ERROR("", "maxUsec and histogram cannot be NULL");
         return DCGM_ST_BADPARAM;
     }
 
@@ -10938,11 +14905,13 @@ dcgmReturn_t DcgmCacheManager::GetGpuFieldExecTimeUsec(unsigned int gpuId,
     if (DCGM_ST_OK != status)
         return status;
 
-    *totalUsec = 0;
-    watchInfo  = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, dcgmFieldId, 0);
+    memset(maxUsec, 0, sizeof(long long) * DCGM_INTROSPECT_LAG_STAGE_COUNT);
+    memset(histogram, 0, sizeof(long long) * DCGM_INTROSPECT_LAG_STAGE_COUNT * DCGM_INTROSPECT_EXEC_TIME_BUCKETS);
+    watchInfo = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, dcgmFieldId, 0);
     if (watchInfo)
     {
-        *totalUsec = (long long)watchInfo->execTimeUsec;
+        memcpy(maxUsec, watchInfo->maxSampleLagUsec, sizeof(watchInfo->maxSampleLagUsec));
+        memcpy(histogram, watchInfo->sampleLagHistogram, sizeof(watchInfo->sampleLagHistogram));
     }
 
     return DCGM_ST_OK;
@@ -10976,109 +14945,446 @@ dcgmReturn_t DcgmCacheManager::GetGpuFieldFetchCount(unsigned int gpuId,
 {
     dcgmcm_watch_info_p watchInfo;
 
-    if (!fetchCount)
+    if (!fetchCount)
+    {
+        PRINT_ERROR("", "fetchCount cannot be NULL");
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmReturn_t status = CheckValidGpuField(gpuId, dcgmFieldId);
+    if (DCGM_ST_OK != status)
+        return status;
+
+    *fetchCount = 0;
+    watchInfo   = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, dcgmFieldId, 0);
+    if (watchInfo)
+        *fetchCount = watchInfo->fetchCount;
+
+    return DCGM_ST_OK;
+}
+
+void DcgmCacheManager::GetRuntimeStats(dcgmcm_runtime_stats_p stats)
+{
+    if (!stats)
+        return;
+
+    m_runStats.lockCount = m_mutex->GetLockCount();
+    memcpy(stats, &m_runStats, sizeof(*stats));
+}
+
+void DcgmCacheManager::GetValidFieldIds(std::vector<unsigned short> &validFieldIds, bool includeModulePublished)
+{
+    if (includeModulePublished)
+    {
+        validFieldIds = m_allValidFieldIds;
+        return;
+    }
+
+    bool migEnabled = IsMigEnabledAnywhere();
+    validFieldIds.clear();
+
+    /* Filter the list for module-published field-IDs */
+    for (unsigned int i = 0; i < m_allValidFieldIds.size(); i++)
+    {
+        if (IsModulePushedFieldId(m_allValidFieldIds[i]))
+            continue;
+
+        if (migEnabled && i == DCGM_FI_DEV_ACCOUNTING_DATA)
+        {
+            continue;
+        }
+
+        validFieldIds.push_back(m_allValidFieldIds[i]);
+    }
+}
+
+dcgmReturn_t DcgmCacheManager::GetEntityWatchInfoSnapshot(dcgm_field_entity_group_t entityGroupId,
+                                                          dcgm_field_eid_t entityId,
+                                                          unsigned int fieldId,
+                                                          dcgmcm_watch_info_p watchInfo)
+{
+    dcgmReturn_t retSt = DCGM_ST_OK;
+    dcgmcm_watch_info_p foundWatchInfo;
+
+    if (!watchInfo)
+        return DCGM_ST_BADPARAM;
+
+    dcgm_mutex_lock(m_mutex);
+
+    foundWatchInfo = GetEntityWatchInfo(entityGroupId, entityId, fieldId, 0);
+    if (foundWatchInfo)
+    {
+        *watchInfo = *foundWatchInfo; /* Do a deep copy so any sub-objects get properly copied */
+    }
+
+    dcgm_mutex_unlock(m_mutex);
+
+    if (!foundWatchInfo)
+        return DCGM_ST_NOT_WATCHED;
+
+    return retSt;
+}
+
+void DcgmCacheManager::OnConnectionRemove(dcgm_connection_id_t connectionId)
+{
+    /* Remote clients watch both directly and through field value streams */
+    dcgm_watch_watcher_info_t watcherInfos[2];
+    watcherInfos[0].watcher = DcgmWatcher(DcgmWatcherTypeClient, connectionId);
+    watcherInfos[1].watcher = DcgmWatcher(DcgmWatcherTypeFvStream, connectionId);
+
+    /* Since most users of DCGM have a single daemon / user, it's easy enough just
+       to walk every watch in existence and see if the connectionId in question has
+       any watches. If we ever have a lot of different remote clients at once, we can
+       reevaluate doing this and possibly track watches for each user */
+
+    dcgm_mutex_lock(m_mutex);
+
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        for (dcgm_watch_watcher_info_t &watcherInfo : watcherInfos)
+        {
+            /* RemoveWatcher will log any failures */
+            RemoveWatcher(watchInfo, &watcherInfo);
+        }
+    }
+
+    std::vector<unsigned int> snapshotGroupIds;
+    for (auto const &group : m_snapshotGroups)
+    {
+        if (group.second.watcher.connectionId == connectionId)
+            snapshotGroupIds.push_back(group.first);
+    }
+    for (unsigned int snapshotGroupId : snapshotGroupIds)
+    {
+        RemoveSnapshotGroup(snapshotGroupId);
+    }
+
+    dcgm_mutex_unlock(m_mutex);
+}
+
+/*****************************************************************************/
+void DcgmCacheManager::GetConnectionWatches(dcgm_connection_id_t connectionId,
+                                            std::vector<dcgmcm_watcher_watch_t> &watches)
+{
+    watches.clear();
+
+    DcgmLockGuard dlg(m_mutex);
+
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        for (dcgm_watch_watcher_info_t const &watcherInfo : watchInfo->watchers)
+        {
+            if (watcherInfo.watcher.connectionId != connectionId)
+                continue;
+
+            dcgmcm_watcher_watch_t watch {};
+            watch.entityGroupId = (dcgm_field_entity_group_t)watchInfo->watchKey.entityGroupId;
+            watch.entityId      = watchInfo->watchKey.entityId;
+            watch.fieldId       = watchInfo->watchKey.fieldId;
+            watch.watcherInfo   = watcherInfo;
+            watches.push_back(watch);
+        }
+    }
+}
+
+/*****************************************************************************/
+timelib64_t DcgmCacheManager::GetWatcherDecimationUsec(dcgm_field_entity_group_t entityGroupId,
+                                                       dcgm_field_eid_t entityId,
+                                                       unsigned short fieldId,
+                                                       DcgmWatcher watcher)
+{
+    DcgmLockGuard dlg(m_mutex);
+
+    dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(entityGroupId, entityId, fieldId, 0);
+    if (!watchInfo)
+        return 0;
+
+    for (dcgm_watch_watcher_info_t const &watcherInfo : watchInfo->watchers)
+    {
+        if (watcher == watcherInfo.watcher)
+        {
+            return watcherInfo.monitorFrequencyUsec > watchInfo->monitorFrequencyUsec
+                       ? watcherInfo.monitorFrequencyUsec
+                       : 0;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::AddSnapshotGroup(std::vector<dcgmcm_entity_key_t> const &keys,
+                                                DcgmWatcher const &watcher,
+                                                unsigned int *snapshotGroupId)
+{
+    DcgmLockGuard dlg(m_mutex);
+
+    dcgmcm_snapshot_group_t group;
+    group.watcher = watcher;
+
+    unsigned int newGroupId = m_nextSnapshotGroupId;
+
+    for (dcgmcm_entity_key_t const &key : keys)
+    {
+        dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(
+            (dcgm_field_entity_group_t)key.entityGroupId, key.entityId, key.fieldId, 0);
+        if (!watchInfo || !watchInfo->isWatched || watchInfo->practicalEntityGroupId != DCGM_FE_GPU
+            || IsModulePushedFieldId(key.fieldId) || GetRateCounterFieldId(key.fieldId)
+            || IsDerivedFieldId(key.fieldId))
+        {
+            continue;
+        }
+
+        /* A watch is fetched with one group at a time */
+        auto previous = m_snapshotGroups.find(watchInfo->snapshotGroupId);
+        if (previous != m_snapshotGroups.end())
+        {
+            std::vector<dcgmcm_entity_key_t> &previousKeys = previous->second.keys;
+            previousKeys.erase(std::remove_if(previousKeys.begin(),
+                                              previousKeys.end(),
+                                              [&key](dcgmcm_entity_key_t const &previousKey) {
+                                                  return previousKey.entityGroupId == key.entityGroupId
+                                                         && previousKey.entityId == key.entityId
+                                                         && previousKey.fieldId == key.fieldId;
+                                              }),
+                               previousKeys.end());
+            if (previousKeys.empty())
+                m_snapshotGroups.erase(previous);
+        }
+
+        watchInfo->snapshotGroupId = newGroupId;
+        group.keys.push_back(key);
+    }
+
+    if (group.keys.empty())
+    {
+        DCGM_LOG_ERROR << "None of the " << keys.size() << " watches of a snapshot group are watched GPU fields";
+        return DCGM_ST_NOT_WATCHED;
+    }
+
+    DCGM_LOG_DEBUG << "Added snapshot group " << newGroupId << " of " << group.keys.size() << " watches";
+
+    m_snapshotGroups[newGroupId] = std::move(group);
+    m_nextSnapshotGroupId++;
+    if (snapshotGroupId)
+        *snapshotGroupId = newGroupId;
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::SetDerivedField(unsigned short fieldId,
+                                               std::string const &expression,
+                                               std::string &error)
+{
+    if (!IsDerivedFieldId(fieldId))
+    {
+        error = "Field " + std::to_string(fieldId) + " isn't a derived field";
+        return DCGM_ST_BADPARAM;
+    }
+
+    /* An empty expression removes the definition */
+    std::unique_ptr<DcgmDerivedField> derivedField;
+    dcgmReturn_t dcgmReturn = DCGM_ST_OK;
+    if (!expression.empty())
+        dcgmReturn = DcgmDerivedField::Compile(expression, derivedField, error);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Bad expression \"" << expression << "\" for derived field " << fieldId << ": " << error;
+        return dcgmReturn;
+    }
+
+    DcgmLockGuard dlg(m_mutex);
+
+    m_derivedFields[fieldId - DCGM_FI_FIRST_DERIVED_FIELD_ID] = std::move(derivedField);
+
+    /* Watches of the field switch to the inputs of the new expression. Watching those can add watch
+       infos, so the watches are gathered first */
+    std::vector<dcgmcm_watch_info_p> derivedWatches;
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
+    {
+        if (watchInfo->watchKey.fieldId == fieldId && watchInfo->isWatched)
+            derivedWatches.push_back(watchInfo);
+    }
+    for (dcgmcm_watch_info_p derivedInfo : derivedWatches)
+    {
+        UpdateDerivedFieldWatch(derivedInfo);
+    }
+
+    DCGM_LOG_DEBUG << "Derived field " << fieldId << " is now \"" << expression << "\"";
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::SetWatchPredicate(dcgm_field_entity_group_t entityGroupId,
+                                                 dcgm_field_eid_t entityId,
+                                                 unsigned short fieldId,
+                                                 DcgmWatcherType_t watcherType,
+                                                 dcgmcm_predicate_t const &predicate)
+{
+    if (watcherType < 0 || watcherType >= DcgmWatcherTypeCount || predicate.type < DcgmcmPredicateAll
+        || predicate.type >= DcgmcmPredicateCount)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    DcgmLockGuard dlg(m_mutex);
+
+    dcgmcm_watch_info_p watchInfo = GetEntityWatchInfo(entityGroupId, entityId, fieldId, 1);
+    if (!watchInfo)
     {
-        PRINT_ERROR("", "fetchCount cannot be NULL");
-        return DCGM_ST_BADPARAM;
+        DCGM_LOG_ERROR << "Unable to get a watch of eg " << entityGroupId << ", eid " << entityId << ", fieldId "
+                       << fieldId;
+        return DCGM_ST_MEMORY;
     }
 
-    dcgmReturn_t status = CheckValidGpuField(gpuId, dcgmFieldId);
-    if (DCGM_ST_OK != status)
-        return status;
+    /* The update threads read the old vector without m_mutex, so build a new one. Nothing of the old
+       one is copied but the predicates themselves, since the update threads may be changing the rest */
+    auto predicates = std::make_shared<std::vector<dcgmcm_watch_predicate_t>>();
+    std::shared_ptr<std::vector<dcgmcm_watch_predicate_t>> oldPredicates = watchInfo->predicates;
+    if (oldPredicates)
+    {
+        for (dcgmcm_watch_predicate_t const &oldPredicate : *oldPredicates)
+        {
+            if (oldPredicate.watcherType != watcherType)
+                predicates->push_back({ oldPredicate.watcherType, oldPredicate.predicate, false, {} });
+        }
+    }
 
-    *fetchCount = 0;
-    watchInfo   = GetEntityWatchInfo(DCGM_FE_GPU, gpuId, dcgmFieldId, 0);
-    if (watchInfo)
-        *fetchCount = watchInfo->fetchCount;
+    if (predicate.type != DcgmcmPredicateAll)
+        predicates->push_back({ watcherType, predicate, false, {} });
 
+    if (predicates->empty())
+        predicates = nullptr;
+    std::atomic_store(&watchInfo->predicates, predicates);
     return DCGM_ST_OK;
 }
 
-void DcgmCacheManager::GetRuntimeStats(dcgmcm_runtime_stats_p stats)
+/*****************************************************************************/
+void DcgmCacheManager::SetPredicatesBypassed(DcgmWatcherType_t watcherType, bool bypassed)
 {
-    if (!stats)
+    if (watcherType < 0 || watcherType >= DcgmWatcherTypeCount)
         return;
 
-    m_runStats.lockCount = m_mutex->GetLockCount();
-    memcpy(stats, &m_runStats, sizeof(*stats));
+    if (bypassed)
+        m_predicateBypassMask.fetch_or(1 << watcherType);
+    else
+        m_predicateBypassMask.fetch_and(~(1U << watcherType));
 }
 
-void DcgmCacheManager::GetValidFieldIds(std::vector<unsigned short> &validFieldIds, bool includeModulePublished)
+/*****************************************************************************/
+bool DcgmCacheManager::PredicateMatches(dcgmcm_watch_predicate_t &watchPredicate,
+                                        dcgmcm_predicate_value_t const &value)
 {
-    if (includeModulePublished)
-    {
-        validFieldIds = m_allValidFieldIds;
-        return;
-    }
+    dcgmcm_predicate_t const &predicate = watchPredicate.predicate;
 
-    bool migEnabled = IsMigEnabledAnywhere();
-    validFieldIds.clear();
+    if (predicate.type == DcgmcmPredicateAll)
+        return true;
+    if (value.isInt64 ? DCGM_INT64_IS_BLANK(value.i64) : DCGM_FP64_IS_BLANK(value.dbl))
+        return false;
 
-    /* Filter the list for module-published field-IDs */
-    for (unsigned int i = 0; i < m_allValidFieldIds.size(); i++)
+    dcgmcm_predicate_value_t const &last = watchPredicate.lastValue;
+    bool matches                         = false;
+
+    switch (predicate.type)
     {
-        if (IsModulePushedFieldId(m_allValidFieldIds[i]))
-            continue;
+        case DcgmcmPredicateGreater:
+            matches = value.isInt64 ? value.i64 > predicate.i64Threshold : value.dbl > predicate.dblThreshold;
+            break;
 
-        if (migEnabled && i == DCGM_FI_DEV_ACCOUNTING_DATA)
-        {
-            continue;
-        }
+        case DcgmcmPredicateLess:
+            matches = value.isInt64 ? value.i64 < predicate.i64Threshold : value.dbl < predicate.dblThreshold;
+            break;
 
-        validFieldIds.push_back(m_allValidFieldIds[i]);
-    }
-}
+        case DcgmcmPredicateChanged:
+            matches = !watchPredicate.haveLastValue || (value.isInt64 ? value.i64 != last.i64 : value.dbl != last.dbl);
+            break;
 
-dcgmReturn_t DcgmCacheManager::GetEntityWatchInfoSnapshot(dcgm_field_entity_group_t entityGroupId,
-                                                          dcgm_field_eid_t entityId,
-                                                          unsigned int fieldId,
-                                                          dcgmcm_watch_info_p watchInfo)
-{
-    dcgmReturn_t retSt = DCGM_ST_OK;
-    dcgmcm_watch_info_p foundWatchInfo;
+        case DcgmcmPredicateDelta:
+            if (!watchPredicate.haveLastValue)
+                matches = true;
+            else if (value.isInt64)
+                matches = std::llabs(value.i64 - last.i64) > predicate.i64Threshold;
+            else
+                matches = std::fabs(value.dbl - last.dbl) > predicate.dblThreshold;
+            break;
 
-    if (!watchInfo)
-        return DCGM_ST_BADPARAM;
+        case DcgmcmPredicateBitsSet:
+            matches = value.isInt64 && (value.i64 & predicate.mask) != 0;
+            break;
 
-    dcgm_mutex_lock(m_mutex);
+        case DcgmcmPredicateNone:
+        default:
+            return false;
+    }
 
-    foundWatchInfo = GetEntityWatchInfo(entityGroupId, entityId, fieldId, 0);
-    if (foundWatchInfo)
+    if (matches && (predicate.type == DcgmcmPredicateChanged || predicate.type == DcgmcmPredicateDelta))
     {
-        *watchInfo = *foundWatchInfo; /* Do a deep copy so any sub-objects get properly copied */
+        watchPredicate.haveLastValue = true;
+        watchPredicate.lastValue     = value;
     }
 
-    dcgm_mutex_unlock(m_mutex);
+    return matches;
+}
 
-    if (!foundWatchInfo)
-        return DCGM_ST_NOT_WATCHED;
+/*****************************************************************************/
+void DcgmCacheManager::GetGpuUuids(std::vector<std::string> &uuids)
+{
+    DcgmLockGuard dlg(m_mutex);
 
-    return retSt;
+    uuids.clear();
+    for (unsigned int i = 0; i < m_numGpus && i < DCGM_MAX_NUM_DEVICES; i++)
+        uuids.push_back(m_gpus[i].uuid);
 }
 
-void DcgmCacheManager::OnConnectionRemove(dcgm_connection_id_t connectionId)
+/*****************************************************************************/
+void DcgmCacheManager::ChangeWatcherConnection(dcgm_connection_id_t connectionId,
+                                               dcgm_connection_id_t newConnectionId)
 {
-    dcgmcm_watch_info_p watchInfo;
-    DcgmWatcher dcgmWatcher(DcgmWatcherTypeClient, connectionId);
-    dcgm_watch_watcher_info_t watcherInfo;
-    watcherInfo.watcher = dcgmWatcher;
-
-    /* Since most users of DCGM have a single daemon / user, it's easy enough just
-       to walk every watch in existence and see if the connectionId in question has
-       any watches. If we ever have a lot of different remote clients at once, we can
-       reevaluate doing this and possibly track watches for each user */
+    if (connectionId == newConnectionId)
+        return;
 
-    dcgm_mutex_lock(m_mutex);
+    DcgmLockGuard dlg(m_mutex);
 
-    for (void *hashIter = hashtable_iter(m_entityWatchHashTable); hashIter;
-         hashIter       = hashtable_iter_next(m_entityWatchHashTable, hashIter))
+    for (dcgmcm_watch_info_p watchInfo : m_entityWatches.Values())
     {
-        watchInfo = (dcgmcm_watch_info_p)hashtable_iter_value(hashIter);
-        /* RemoveWatcher will log any failures */
-        RemoveWatcher(watchInfo, &watcherInfo);
+        bool removedAny = false;
+
+        for (auto it = watchInfo->watchers.begin(); it != watchInfo->watchers.end();)
+        {
+            if (it->watcher.connectionId != connectionId)
+            {
+                ++it;
+                continue;
+            }
+
+            DcgmWatcherType_t watcherType = it->watcher.watcherType;
+            bool isDuplicate              = std::any_of(
+                watchInfo->watchers.begin(), watchInfo->watchers.end(), [&](dcgm_watch_watcher_info_t const &other) {
+                    return other.watcher.watcherType == watcherType && other.watcher.connectionId == newConnectionId;
+                });
+            if (isDuplicate)
+            {
+                it         = watchInfo->watchers.erase(it);
+                removedAny = true;
+            }
+            else
+            {
+                it->watcher.connectionId = newConnectionId;
+                ++it;
+            }
+        }
+
+        /* The watch still has the watcher that was kept, so it stays watched */
+        if (removedAny)
+            UpdateWatchFromWatchers(watchInfo);
     }
 
-    dcgm_mutex_unlock(m_mutex);
+    for (auto &group : m_snapshotGroups)
+    {
+        if (group.second.watcher.connectionId == connectionId)
+            group.second.watcher.connectionId = newConnectionId;
+    }
 }
 
 void DcgmCacheManager::WatchVgpuFields(nvmlVgpuInstance_t vgpuId)
@@ -11125,22 +15431,8 @@ void DcgmCacheManager::ConvertVectorToBitmask(std::vector<unsigned int> &gpuIds,
 /*****************************************************************************/
 dcgmReturn_t DcgmCacheManager::PopulateCpuAffinity(dcgmAffinity_t &affinity)
 {
-    dcgmcm_sample_t sample = {};
-    dcgmReturn_t ret       = GetLatestSample(DCGM_FE_GPU, 0, DCGM_FI_GPU_TOPOLOGY_AFFINITY, &sample, 0);
-
-    if (ret != DCGM_ST_OK)
-    {
-        // The information isn't saved
-        ret = PopulateTopologyAffinity(affinity);
-    }
-    else
-    {
-        dcgmAffinity_t *tmp = (dcgmAffinity_t *)sample.val.blob;
-        memcpy(&affinity, tmp, sizeof(affinity));
-        free(tmp);
-    }
-
-    return ret;
+    /* Cached until the topology changes, so there's no need to look for a watched copy */
+    return PopulateTopologyAffinity(affinity);
 }
 
 /*****************************************************************************/
@@ -11271,211 +15563,68 @@ dcgmTopology_t *DcgmCacheManager::GetNvLinkTopologyInformation()
 {
     unsigned int topologySize = 0;
     dcgmTopology_t *topPtr    = NULL;
-    dcgmcm_sample_t sample;
-
-    dcgmReturn_t ret = GetLatestSample(DCGM_FE_GPU, 0, DCGM_FI_GPU_TOPOLOGY_NVLINK, &sample, 0);
 
-    if (ret != DCGM_ST_OK)
-    {
-        PopulateTopologyNvLink(&topPtr, topologySize);
-    }
-    else
-    {
-        topPtr = (dcgmTopology_t *)sample.val.blob;
-    }
+    /* Cached until the topology changes, so there's no need to look for a watched copy */
+    if (PopulateTopologyNvLink(&topPtr, topologySize) != DCGM_ST_OK)
+        return NULL;
 
     return topPtr;
 }
 
 /*****************************************************************************/
-/*
- * Translate each bitmap into the number of NvLinks that connect the two GPUs
- */
-unsigned int DcgmCacheManager::NvLinkScore(dcgmGpuTopologyLevel_t path)
-{
-    unsigned long temp = static_cast<unsigned long>(path);
-
-    // This code relies on DCGM_TOPOLOGY_NVLINK1 equaling 0x100, so
-    // make the code fail so this gets updated if it ever changes
-    temp = temp / 256;
-    DCGM_CASSERT(DCGM_TOPOLOGY_NVLINK1 == 0x100, 1);
-    unsigned int score = 0;
-
-    for (; temp > 0; score++)
-        temp = temp / 2;
-
-    return score;
-}
-
-/*****************************************************************************/
-unsigned int DcgmCacheManager::SetIOConnectionLevels(
-    std::vector<unsigned int> &affinityGroup,
-    dcgmTopology_t *topPtr,
-    std::map<unsigned int, std::vector<DcgmGpuConnectionPair>> &connectionLevel)
-
-{
-    unsigned int highestScore = 0;
-    for (unsigned int elementIndex = 0; elementIndex < topPtr->numElements; elementIndex++)
-    {
-        unsigned int gpuA = topPtr->element[elementIndex].dcgmGpuA;
-        unsigned int gpuB = topPtr->element[elementIndex].dcgmGpuB;
-
-        // Ignore the connection if both GPUs aren't in the list
-        if ((std::find(affinityGroup.begin(), affinityGroup.end(), gpuA) != affinityGroup.end())
-            && (std::find(affinityGroup.begin(), affinityGroup.end(), gpuB) != affinityGroup.end()))
-        {
-            unsigned int score = NvLinkScore(DCGM_TOPOLOGY_PATH_NVLINK(topPtr->element[elementIndex].path));
-            DcgmGpuConnectionPair cp(gpuA, gpuB);
-
-            if (connectionLevel.find(score) == connectionLevel.end())
-            {
-                std::vector<DcgmGpuConnectionPair> temp;
-                temp.push_back(cp);
-                connectionLevel[score] = temp;
-
-                if (score > highestScore)
-                    highestScore = score;
-            }
-            else
-                connectionLevel[score].push_back(cp);
-        }
-    }
-
-    return highestScore;
-}
-
-bool DcgmCacheManager::HasStrongConnection(std::vector<DcgmGpuConnectionPair> &connections,
-                                           uint32_t numGpus,
-                                           uint64_t &outputGpus)
+std::shared_ptr<DcgmTopologySelector const> DcgmCacheManager::GetTopologySelector()
 {
-    bool strong = false;
-    //    std::set<size_t> alreadyConsidered;
+    unsigned long long generation;
 
-    // At maximum, connections can have a strong connection between it's size + 1 gpus.
-    if (connections.size() + 1 >= numGpus)
     {
-        for (size_t outer = 0; outer < connections.size(); outer++)
-        {
-            std::vector<DcgmGpuConnectionPair> list;
-            list.push_back(connections[outer]);
-            // There are two gpus in the first connection
-            unsigned int strongGpus = 2;
-
-            for (size_t inner = 0; inner < connections.size(); inner++)
-            {
-                if (strongGpus >= numGpus)
-                    break;
-
-                if (outer == inner)
-                    continue;
-
-                for (size_t i = 0; i < list.size(); i++)
-                {
-                    if (list[i].CanConnect(connections[inner]))
-                    {
-                        list.push_back(connections[inner]);
-                        // If it can connect, then we're adding one more gpu to the group
-                        strongGpus++;
-                        break;
-                    }
-                }
-            }
-
-            if (strongGpus >= numGpus)
-            {
-                strong = true;
-                for (size_t i = 0; i < list.size(); i++)
-                {
-                    // Checking for duplicates takes more time than setting a bit again
-                    outputGpus |= (std::uint64_t)0x1 << list[i].gpu1;
-                    outputGpus |= (std::uint64_t)0x1 << list[i].gpu2;
-                }
-                break;
-            }
-        }
+        DcgmLockGuard dlg(m_mutex);
+        if (m_topologySelector != nullptr)
+            return m_topologySelector;
+        generation = m_topologyGeneration;
     }
 
-    return strong;
-}
-
-/*****************************************************************************/
-unsigned int DcgmCacheManager::RecordBestPath(
-    std::vector<unsigned int> &bestPath,
-    std::map<unsigned int, std::vector<DcgmGpuConnectionPair>> &connectionLevel,
-    uint32_t numGpus,
-    unsigned int highestLevel)
-{
-    unsigned int levelIndex = highestLevel;
-    unsigned int score      = 0;
-
-    for (; bestPath.size() < numGpus && levelIndex > 0; levelIndex--)
-    {
-        // Ignore a level if not found
-        if (connectionLevel.find(levelIndex) == connectionLevel.end())
-            continue;
-
-        std::vector<DcgmGpuConnectionPair> &level = connectionLevel[levelIndex];
-
-        for (size_t i = 0; i < level.size(); i++)
-        {
-            DcgmGpuConnectionPair &cp = level[i];
-            if (std::find(bestPath.begin(), bestPath.end(), cp.gpu1) == bestPath.end())
-            {
-                bestPath.push_back(cp.gpu1);
-                score += levelIndex;
-            }
-
-            if (bestPath.size() >= numGpus)
-                break;
-
-            if (std::find(bestPath.begin(), bestPath.end(), cp.gpu2) == bestPath.end())
-            {
-                bestPath.push_back(cp.gpu2);
-                score += levelIndex;
-            }
+    dcgmTopology_t *topPtr = GetNvLinkTopologyInformation();
+    if (topPtr == NULL)
+        return nullptr;
 
-            if (bestPath.size() >= numGpus)
-                break;
-        }
-    }
+    auto selector = std::make_shared<DcgmTopologySelector const>(topPtr);
+    free(topPtr);
 
-    return score;
+    DcgmLockGuard dlg(m_mutex);
+    if (generation == m_topologyGeneration)
+        m_topologySelector = selector;
+    return selector;
 }
 
 /*****************************************************************************/
 void DcgmCacheManager::MatchByIO(std::vector<std::vector<unsigned int>> &affinityGroups,
-                                 dcgmTopology_t *topPtr,
+                                 DcgmTopologySelector const &selector,
                                  std::vector<size_t> &potentialCpuMatches,
                                  uint32_t numGpus,
                                  uint64_t &outputGpus)
 {
-    float scores[DCGM_MAX_NUM_DEVICES] = { 0 };
-    std::vector<unsigned int> bestList[DCGM_MAX_NUM_DEVICES];
+    unsigned int bestScore = 0;
 
     // Clear the output
     outputGpus = 0;
 
-    if (topPtr == NULL)
-        return;
-
     for (size_t matchIndex = 0; matchIndex < potentialCpuMatches.size(); matchIndex++)
     {
-        unsigned int highestScore;
-        std::map<unsigned int, std::vector<DcgmGpuConnectionPair>> connectionLevel;
-        highestScore = SetIOConnectionLevels(affinityGroups[potentialCpuMatches[matchIndex]], topPtr, connectionLevel);
-
-        scores[matchIndex] = RecordBestPath(bestList[matchIndex], connectionLevel, numGpus, highestScore);
-    }
+        uint64_t candidates = 0;
+        for (unsigned int gpuId : affinityGroups[potentialCpuMatches[matchIndex]])
+        {
+            candidates |= (std::uint64_t)0x1 << gpuId;
+        }
 
-    // Choose the level with the highest score and mark it's best path
-    int bestScoreIndex = 0;
-    for (int i = 1; i < DCGM_MAX_NUM_DEVICES; i++)
-    {
-        if (scores[i] > scores[bestScoreIndex])
-            bestScoreIndex = i;
+        // Ties go to the earlier group
+        unsigned int score = 0;
+        uint64_t selected  = selector.Select(candidates, numGpus, &score);
+        if (selected != 0 && (outputGpus == 0 || score > bestScore))
+        {
+            outputGpus = selected;
+            bestScore  = score;
+        }
     }
-
-    ConvertVectorToBitmask(bestList[bestScoreIndex], outputGpus, numGpus);
 }
 
 /*****************************************************************************/
@@ -11485,11 +15634,6 @@ dcgmReturn_t DcgmCacheManager::SelectGpusByTopology(std::vector<unsigned int> &g
 {
     dcgmReturn_t ret = DCGM_ST_OK;
 
-    // First, group them by cpu affinity
-    dcgmAffinity_t affinity = {};
-    std::vector<std::vector<unsigned int>> affinityGroups;
-    std::vector<size_t> potentialCpuMatches;
-
     if (gpuIds.size() <= numGpus)
     {
         // We don't have enough healthy gpus to be picky, just set the bitmap
@@ -11498,48 +15642,95 @@ dcgmReturn_t DcgmCacheManager::SelectGpusByTopology(std::vector<unsigned int> &g
         // Set an error if there aren't enough GPUs to fulfill the request
         if (gpuIds.size() < numGpus)
             ret = DCGM_ST_INSUFFICIENT_SIZE;
+
+        return ret;
     }
-    else
+
+    /* The search only depends on the candidates and the topology. Reuse it until the topology changes */
+    uint64_t candidates = 0;
+    for (unsigned int gpuId : gpuIds)
     {
-        ret = PopulateCpuAffinity(affinity);
+        candidates |= (std::uint64_t)0x1 << gpuId;
+    }
+    std::pair<uint64_t, uint32_t> selectionKey(candidates, numGpus);
+    unsigned long long generation;
 
-        if (ret != DCGM_ST_OK)
+    {
+        DcgmLockGuard dlg(m_mutex);
+        auto selection = m_topologySelections.find(selectionKey);
+        if (selection != m_topologySelections.end())
         {
-            return DCGM_ST_GENERIC_ERROR;
+            outputGpus |= selection->second.second;
+            return selection->second.first;
         }
+        generation = m_topologyGeneration;
+    }
 
-        CreateGroupsFromCpuAffinities(affinity, affinityGroups, gpuIds);
+    uint64_t selectedGpus = 0;
+    ret                   = SelectGpusByTopologyUncached(gpuIds, numGpus, selectedGpus);
+    outputGpus |= selectedGpus;
 
-        PopulatePotentialCpuMatches(affinityGroups, potentialCpuMatches, numGpus);
+    DcgmLockGuard dlg(m_mutex);
+    if (generation == m_topologyGeneration)
+    {
+        /* Bound the memory used by callers that try many candidate sets */
+        if (m_topologySelections.size() >= DCGM_CM_MAX_TOPOLOGY_SELECTIONS)
+            m_topologySelections.clear();
+        m_topologySelections[selectionKey] = std::make_pair(ret, selectedGpus);
+    }
 
-        if ((potentialCpuMatches.size() == 1) && (affinityGroups[potentialCpuMatches[0]].size() == numGpus))
-        {
-            // CPUs have already narrowed it down to one match, so go with that.
-            ConvertVectorToBitmask(affinityGroups[potentialCpuMatches[0]], outputGpus, numGpus);
-        }
-        else if (potentialCpuMatches.empty())
+    return ret;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheManager::SelectGpusByTopologyUncached(std::vector<unsigned int> &gpuIds,
+                                                            uint32_t numGpus,
+                                                            uint64_t &outputGpus)
+{
+    dcgmReturn_t ret = DCGM_ST_OK;
+
+    // First, group them by cpu affinity
+    dcgmAffinity_t affinity = {};
+    std::vector<std::vector<unsigned int>> affinityGroups;
+    std::vector<size_t> potentialCpuMatches;
+
+    ret = PopulateCpuAffinity(affinity);
+
+    if (ret != DCGM_ST_OK)
+    {
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    CreateGroupsFromCpuAffinities(affinity, affinityGroups, gpuIds);
+
+    PopulatePotentialCpuMatches(affinityGroups, potentialCpuMatches, numGpus);
+
+    if ((potentialCpuMatches.size() == 1) && (affinityGroups[potentialCpuMatches[0]].size() == numGpus))
+    {
+        // CPUs have already narrowed it down to one match, so go with that.
+        ConvertVectorToBitmask(affinityGroups[potentialCpuMatches[0]], outputGpus, numGpus);
+    }
+    else if (potentialCpuMatches.empty())
+    {
+        // Not enough GPUs with the same CPUset
+        std::vector<unsigned int> combined;
+        ret = CombineAffinityGroups(affinityGroups, combined, numGpus);
+        if (ret == DCGM_ST_OK)
+            ConvertVectorToBitmask(combined, outputGpus, numGpus);
+    }
+    else
+    {
+        // Find best interconnect within or among the matches.
+        std::shared_ptr<DcgmTopologySelector const> selector = GetTopologySelector();
+        if (selector != nullptr)
         {
-            // Not enough GPUs with the same CPUset
-            std::vector<unsigned int> combined;
-            ret = CombineAffinityGroups(affinityGroups, combined, numGpus);
-            if (ret == DCGM_ST_OK)
-                ConvertVectorToBitmask(combined, outputGpus, numGpus);
+            MatchByIO(affinityGroups, *selector, potentialCpuMatches, numGpus, outputGpus);
         }
         else
         {
-            // Find best interconnect within or among the matches.
-            dcgmTopology_t *topPtr = GetNvLinkTopologyInformation();
-            if (topPtr != NULL)
-            {
-                MatchByIO(affinityGroups, topPtr, potentialCpuMatches, numGpus, outputGpus);
-                free(topPtr);
-            }
-            else
-            {
-                // Couldn't get the NvLink information, just pick the first potential match
-                PRINT_DEBUG("", "Unable to get NvLink topology, selecting solely based on cpu affinity");
-                ConvertVectorToBitmask(affinityGroups[potentialCpuMatches[0]], outputGpus, numGpus);
-            }
+            // Couldn't get the NvLink information, just pick the first potential match
+            PRINT_DEBUG("", "Unable to get NvLink topology, selecting solely based on cpu affinity");
+            ConvertVectorToBitmask(affinityGroups[potentialCpuMatches[0]], outputGpus, numGpus);
         }
     }
 
@@ -11598,6 +15789,15 @@ dcgmReturn_t AddMigHierarchyEntry(dcgmMigHierarchy_v1 &migHierarchy,
 /*****************************************************************************/
 dcgmReturn_t DcgmCacheManager::PopulateMigHierarchy(dcgmMigHierarchy_v1 &migHierarchy)
 {
+    DcgmLockGuard dlg(m_mutex);
+
+    /* The hierarchy only changes with the instances, which invalidate this */
+    if (m_haveMigHierarchy)
+    {
+        migHierarchy = m_migHierarchy;
+        return DCGM_ST_OK;
+    }
+
     dcgmReturn_t ret = DCGM_ST_OK;
     memset(&migHierarchy, 0, sizeof(migHierarchy));
 
@@ -11638,6 +15838,9 @@ dcgmReturn_t DcgmCacheManager::PopulateMigHierarchy(dcgmMigHierarchy_v1 &migHier
         }
     }
 
+    m_migHierarchy     = migHierarchy;
+    m_haveMigHierarchy = true;
+
     return DCGM_ST_OK;
 }
 
@@ -11743,17 +15946,16 @@ dcgmReturn_t DcgmCacheManager::CreateMigEntity(const dcgmCreateMigEntity_v1 &cme
                         return DCGM_ST_BADPARAM;
                     }
 
-                    unsigned int localIndex = cme.parentId % m_gpus[gpuId].maxGpcs;
-                    if (localIndex >= m_gpus[gpuId].instances.size())
+                    DcgmGpuInstance *parent = FindGpuInstance(gpuId, DcgmNs::Mig::GpuInstanceId { cme.parentId });
+                    if (parent == nullptr)
                     {
-                        DCGM_LOG_ERROR << "Cannot create compute instance as the computed NVML GPU instance index "
-                                       << "exceeds known GPU instances on GPU. GpuId: " << gpuId
-                                       << ", computed NVML index: " << localIndex
+                        DCGM_LOG_ERROR << "Cannot create compute instance as the specified parent GPU instance is not "
+                                       << "known on GPU. GpuId: " << gpuId << ", GpuInstanceId: " << cme.parentId
                                        << ", number of known GPU instances: " << m_gpus[gpuId].instances.size();
                         return DCGM_ST_BADPARAM;
                     }
 
-                    nvmlGpuInstance_t instance = m_gpus[gpuId].instances[localIndex].GetInstanceHandle();
+                    nvmlGpuInstance_t instance = parent->GetInstanceHandle();
 
                     nvmlComputeInstanceProfileInfo_t ciProfileInfo {};
                     nvmlReturn_t nvmlRet = nvmlGpuInstanceGetComputeInstanceProfileInfo(
@@ -11819,14 +16021,14 @@ dcgmReturn_t DcgmCacheManager::DeleteMigEntity(const dcgmDeleteMigEntity_v1 &dme
                 return ret;
             }
 
-            unsigned int localIndex = dme.entityId % m_gpus[gpuId].maxGpcs;
-            if (m_gpus[gpuId].instances.size() <= localIndex)
+            DcgmGpuInstance *instance = FindGpuInstance(gpuId, DcgmNs::Mig::GpuInstanceId { dme.entityId });
+            if (instance == nullptr)
             {
                 DCGM_LOG_ERROR << "Cannot delete unknown instance id " << dme.entityId;
                 return DCGM_ST_BADPARAM;
             }
 
-            nvmlReturn_t nvmlRet = nvmlGpuInstanceDestroy(m_gpus[gpuId].instances[localIndex].GetInstanceHandle());
+            nvmlReturn_t nvmlRet = nvmlGpuInstanceDestroy(instance->GetInstanceHandle());
             return NvmlReturnToDcgmReturn(nvmlRet);
 
             break; // NOT REACHED
@@ -11844,16 +16046,16 @@ dcgmReturn_t DcgmCacheManager::DeleteMigEntity(const dcgmDeleteMigEntity_v1 &dme
                 return ret;
             }
 
-            unsigned int localInstanceIndex  = instanceId.id % m_gpus[gpuId].maxGpcs;
+            DcgmGpuInstance *instance        = FindGpuInstance(gpuId, instanceId);
             dcgmcm_gpu_compute_instance_t ci = {};
 
-            if (m_gpus[gpuId].instances.size() <= localInstanceIndex)
+            if (instance == nullptr)
             {
                 DCGM_LOG_ERROR << "Cannot delete unknown compute instance id " << dme.entityId;
                 return DCGM_ST_BADPARAM;
             }
 
-            ret = m_gpus[gpuId].instances[localInstanceIndex].GetComputeInstanceById(
+            ret = instance->GetComputeInstanceById(
                 DcgmNs::Mig::ComputeInstanceId { dme.entityId }, ci);
             if (ret != DCGM_ST_OK)
             {
@@ -11945,6 +16147,8 @@ dcgmReturn_t DcgmCacheManager::PopulateGlobalWatchInfo(std::vector<dcgmCoreWatch
 
         GetGlobalFieldExecTimeUsec(fieldId, &insertInfo.execTimeUsec);
         GetGlobalFieldFetchCount(fieldId, &insertInfo.fetchCount);
+        GetGlobalFieldExecTimeHistogram(fieldId, &insertInfo.maxExecTimeUsec, insertInfo.execTimeHistogram);
+        GetGlobalFieldSampleLagHistogram(fieldId, insertInfo.maxSampleLagUsec, insertInfo.sampleLagHistogram);
         GetGlobalFieldBytesUsed(fieldId, &insertInfo.bytesUsed);
         GetFieldWatchFreq(0, fieldId, &insertInfo.monitorFrequencyUsec);
 
@@ -12001,6 +16205,8 @@ dcgmReturn_t DcgmCacheManager::PopulateGpuWatchInfo(std::vector<dcgmCoreWatchInf
 
         GetGpuFieldExecTimeUsec(gpuId, fieldId, &insertInfo.execTimeUsec);
         GetGpuFieldFetchCount(gpuId, fieldId, &insertInfo.fetchCount);
+        GetGpuFieldExecTimeHistogram(gpuId, fieldId, &insertInfo.maxExecTimeUsec, insertInfo.execTimeHistogram);
+        GetGpuFieldSampleLagHistogram(gpuId, fieldId, insertInfo.maxSampleLagUsec, insertInfo.sampleLagHistogram);
         GetGpuFieldBytesUsed(gpuId, fieldId, &insertInfo.bytesUsed);
         GetFieldWatchFreq(gpuId, fieldId, &insertInfo.monitorFrequencyUsec);
 
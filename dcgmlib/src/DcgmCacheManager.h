@@ -15,28 +15,79 @@
  */
 #pragma once
 
+#include "DcgmCacheArena.h"
+#include "DcgmCacheRollup.h"
+#include "DcgmCacheSpill.h"
+#include "DcgmDerivedField.h"
 #include "DcgmDiscovery.h"
 #include "DcgmFvBuffer.h"
+#include "DcgmFvBufferPool.h"
 #include "DcgmGpuInstance.h"
 #include "DcgmMigManager.h"
 #include "DcgmMutex.h"
+#include "DcgmProcessIntervals.h"
+#include "DcgmQuantileSketch.h"
 #include "DcgmSettings.h"
+#include "DcgmSummaryKernels.h"
 #include "DcgmThread.h"
+#include "DcgmTopologySelector.h"
+#include "DcgmWatchIndex.hpp"
+#include "DcgmWatchSchedule.hpp"
 #include "DcgmWatchTable.h"
 #include "DcgmWatcher.h"
 #include "dcgm_fields.h"
 #include "dcgm_fields_internal.h"
 #include "dcgm_structs.h"
-#include "hashtable.h"
 #include "timelib.h"
 #include "timeseries.h"
+#include <atomic>
 #include <bitset>
+#include <cmath>
 #include <condition_variable>
 #include <dcgm_nvml.h>
+#include <functional>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sched.h>
 #include <set>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
+
+namespace DcgmNs
+{
+class ThreadPool;
+}
+
+/*****************************************************************************/
+/* Bounds on the number of samples preallocated for a numeric watch's ring buffer.
+   Rings for longer-lived watches start at the max and grow as needed */
+#define DCGM_CM_RING_MIN_CAPACITY         16
+#define DCGM_CM_RING_MAX_INITIAL_CAPACITY 4096
+
+/* Numeric watches expected to keep at least this many samples have their history
+   compressed when history compression is enabled. See SetHistoryCompression() */
+#define DCGM_CM_COMPRESS_MIN_SAMPLES 1024
+
+/* Lock-free latest-value reads. See GetLatestSampleLockFree() */
+#define DCGM_CM_WATCH_INDEX_MIN_CAPACITY_LOG2 8  /* Initial index has 256 slots */
+#define DCGM_CM_LATEST_VALUE_MAX_RETRIES      16 /* Seqlock retries before taking the lock instead */
+
+/* Cache memory budget. See SetCacheMemoryBudget() */
+#define DCGM_CM_BUDGET_CHECK_USEC 1000000  /* How often usage is checked against the budget */
+#define DCGM_CM_BUDGET_WARN_USEC  60000000 /* Minimum time between warnings about going over it */
+
+/* Adaptive sampling. See SetAdaptiveSampling() */
+#define DCGM_CM_ADAPTIVE_DEFAULT_THRESHOLD 0.01 /* Relative deviation below which a watch is quiet */
+#define DCGM_CM_ADAPTIVE_ALPHA             0.25 /* Weight of each sample in a watch's mean and variance */
+#define DCGM_CM_ADAPTIVE_TRIGGER_FIELD_ID  DCGM_FI_DEV_GPU_UTIL /* Changes put the whole GPU in burst */
+
+/* Most SelectGpusByTopology() results kept before they are all dropped */
+#define DCGM_CM_MAX_TOPOLOGY_SELECTIONS 4096
 
 /*****************************************************************************/
 /* Summary information types */
@@ -50,10 +101,280 @@ typedef enum
     DcgmcmSummaryTypeIntegral,    /* Integral of the values (area under values) */
     DcgmcmSummaryTypeDifference,  /* Difference between the first and last
                                        non-blank value (last - first) */
+    DcgmcmSummaryTypeP50,         /* Median. This and the other percentiles are estimates
+                                       within DcgmQuantileSketch::DEFAULT_RELATIVE_ACCURACY */
+    DcgmcmSummaryTypeP95,         /* 95th percentile */
+    DcgmcmSummaryTypeP99,         /* 99th percentile */
 
     DcgmcmSummaryTypeSize /* Always last entry */
 } DcgmcmSummaryType_t;
 
+/*****************************************************************************/
+/*
+ * Running state of a summary of a numeric watch, fed one sample at a time in
+ * timestamp order. T is long long for TS_TYPE_INT64 and double for
+ * TS_TYPE_DOUBLE. This is what GetInt64SummaryData() and GetFp64SummaryData()
+ * compute, so it can also be kept up to date as samples are appended. See
+ * AddSummaryWindow()
+ */
+template <typename T>
+struct DcgmcmSummaryAccumulator
+{
+    int Nseen                 = 0;       /* Samples seen, including blank ones */
+    int NseenAtLastValue      = 0;       /* Nseen as of the last non-blank sample */
+    T sumValue                = 0;       /* Sum of the non-blank samples */
+    T firstValue              = Blank(); /* First non-blank sample */
+    T lastValue               = Blank(); /* Last non-blank sample */
+    T minValue                = Blank(); /* Smallest non-blank sample */
+    T maxValue                = Blank(); /* Largest non-blank sample */
+    T integral                = Blank(); /* Area under the samples */
+    T prevValue               = 0;       /* Last sample, blank or not */
+    timelib64_t prevTimestamp = 0;       /* Timestamp of prevValue */
+    bool keepSketch           = false;   /* Feed sketch. Set before the first sample. The percentile
+                                            summaries are blank otherwise */
+    bool sketchComplete       = true;    /* false once sketch missed samples, like rolled-up ones */
+    DcgmQuantileSketch sketch;           /* Distribution of the non-blank samples */
+
+    static T Blank(void)
+    {
+        if constexpr (std::is_integral_v<T>)
+            return DCGM_INT64_BLANK;
+        else
+            return DCGM_FP64_BLANK;
+    }
+
+    static bool IsBlank(T value)
+    {
+        if constexpr (std::is_integral_v<T>)
+            return DCGM_INT64_IS_BLANK(value);
+        else
+            return DCGM_FP64_IS_BLANK(value);
+    }
+
+    static T FromDouble(double value)
+    {
+        if constexpr (std::is_integral_v<T>)
+            return (T)llround(value);
+        else
+            return (T)value;
+    }
+
+    void Add(timelib64_t timestamp, T value)
+    {
+        Nseen++;
+
+        /* All of the current summary types ignore blank values */
+        if (!IsBlank(value))
+        {
+            if (IsBlank(firstValue))
+                firstValue = value;
+
+            sumValue += value;
+            lastValue        = value;
+            NseenAtLastValue = Nseen;
+
+            if (IsBlank(minValue) || value < minValue)
+                minValue = value;
+            if (IsBlank(maxValue) || value > maxValue)
+                maxValue = value;
+            if (keepSketch)
+                sketch.Add((double)value);
+
+            /* Need a time difference to calculate an area */
+            if (!prevTimestamp)
+                integral = 0;
+            else
+                integral += ((value + prevValue) / 2) * (timestamp - prevTimestamp);
+        }
+
+        prevValue     = value;
+        prevTimestamp = timestamp;
+    }
+
+    /*
+     * Same as calling Add() for each of count samples, with everything but the
+     * integral reduced by the SIMD kernels. The integral needs the samples in
+     * order and is only kept up to date if computeIntegral. See DcgmSummaryKernels.h
+     */
+    void AddBatch(timelib64_t const *timestamps, T const *values, int count, bool computeIntegral)
+    {
+        /* The first sample of a summary starts the integral */
+        if (count > 0 && !prevTimestamp)
+        {
+            Add(timestamps[0], values[0]);
+            timestamps++;
+            values++;
+            count--;
+        }
+        if (count <= 0)
+            return;
+
+        if (computeIntegral)
+        {
+            T prev               = prevValue;
+            timelib64_t prevUsec = prevTimestamp;
+            for (int i = 0; i < count; i++)
+            {
+                if (!IsBlank(values[i]))
+                    integral += ((values[i] + prev) / 2) * (timestamps[i] - prevUsec);
+                prev     = values[i];
+                prevUsec = timestamps[i];
+            }
+        }
+
+        if (keepSketch)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                if (!IsBlank(values[i]))
+                    sketch.Add((double)values[i]);
+            }
+        }
+
+        DcgmNs::SummaryKernels::Totals<T> totals;
+        DcgmNs::SummaryKernels::Summarize(values, count, totals);
+        if (totals.count)
+        {
+            if (IsBlank(firstValue))
+                firstValue = values[totals.firstIndex];
+            if (IsBlank(minValue) || totals.min < minValue)
+                minValue = totals.min;
+            if (IsBlank(maxValue) || totals.max > maxValue)
+                maxValue = totals.max;
+
+            sumValue += totals.sum;
+            lastValue        = values[totals.lastIndex];
+            NseenAtLastValue = Nseen + totals.lastIndex + 1;
+        }
+
+        Nseen += count;
+        prevValue     = values[count - 1];
+        prevTimestamp = timestamps[count - 1];
+    }
+
+    /* Start from the totals of samples that were rolled up. See DcgmCacheRollup */
+    void AddRollup(dcgmcm_rollup_summary_t const &rollup)
+    {
+        Nseen            = (int)rollup.count;
+        NseenAtLastValue = Nseen;
+        sumValue         = FromDouble(rollup.sum);
+        firstValue       = FromDouble(rollup.first);
+        lastValue        = FromDouble(rollup.last);
+        minValue         = FromDouble(rollup.min);
+        maxValue         = FromDouble(rollup.max);
+        integral         = FromDouble(rollup.integral);
+        prevValue        = lastValue;
+        prevTimestamp    = rollup.lastUsec;
+        sketchComplete   = false; /* Rollups only keep totals */
+    }
+
+    /* Whether the percentile summaries are available */
+    bool HasPercentiles(void) const
+    {
+        return keepSketch && sketchComplete && sketch.Count() > 0;
+    }
+
+    static bool IsPercentile(DcgmcmSummaryType_t summaryType)
+    {
+        return summaryType == DcgmcmSummaryTypeP50 || summaryType == DcgmcmSummaryTypeP95
+               || summaryType == DcgmcmSummaryTypeP99;
+    }
+
+    /* Returns DCGM_ST_BADPARAM for an unknown summary type */
+    dcgmReturn_t GetSummaries(int numSummaryTypes, DcgmcmSummaryType_t const *summaryTypes, T *summaryValues) const
+    {
+        for (int stIndex = 0; stIndex < numSummaryTypes; stIndex++)
+        {
+            bool haveValue = !IsBlank(lastValue);
+            switch (summaryTypes[stIndex])
+            {
+                case DcgmcmSummaryTypeMinimum:
+                    summaryValues[stIndex] = minValue;
+                    break;
+                case DcgmcmSummaryTypeMaximum:
+                    summaryValues[stIndex] = maxValue;
+                    break;
+                case DcgmcmSummaryTypeAverage:
+                    summaryValues[stIndex] = haveValue ? sumValue / (T)NseenAtLastValue : Blank();
+                    break;
+                case DcgmcmSummaryTypeSum:
+                    summaryValues[stIndex] = haveValue ? sumValue : Blank();
+                    break;
+                case DcgmcmSummaryTypeCount:
+                    summaryValues[stIndex] = haveValue ? (T)NseenAtLastValue : Blank();
+                    break;
+                case DcgmcmSummaryTypeIntegral:
+                    summaryValues[stIndex] = integral;
+                    break;
+                case DcgmcmSummaryTypeDifference:
+                    summaryValues[stIndex] = haveValue ? lastValue - firstValue : Blank();
+                    break;
+                case DcgmcmSummaryTypeP50:
+                    summaryValues[stIndex] = HasPercentiles() ? FromDouble(sketch.Quantile(0.50)) : Blank();
+                    break;
+                case DcgmcmSummaryTypeP95:
+                    summaryValues[stIndex] = HasPercentiles() ? FromDouble(sketch.Quantile(0.95)) : Blank();
+                    break;
+                case DcgmcmSummaryTypeP99:
+                    summaryValues[stIndex] = HasPercentiles() ? FromDouble(sketch.Quantile(0.99)) : Blank();
+                    break;
+                default:
+                    return DCGM_ST_BADPARAM;
+            }
+        }
+        return DCGM_ST_OK;
+    }
+};
+
+/*****************************************************************************/
+/* A window that summaries are kept for as samples arrive. See AddSummaryWindow() */
+typedef struct
+{
+    timelib64_t startTime; /* First timestamp in the window */
+    timelib64_t endTime;   /* Last timestamp in the window. 0 = still open */
+} dcgmcm_summary_window_t;
+
+/*****************************************************************************/
+/* Latest accounting record cached for a process on a GPU. See m_latestAccountingStats */
+typedef struct
+{
+    timelib64_t timestamp;                /* Timestamp of the record in the watch's time series */
+    dcgmDevicePidAccountingStats_t stats; /* Copy of the record, for telling whether the process changed */
+} dcgmcm_accounting_entry_t;
+
+/*****************************************************************************/
+/* Running process utilization of one process on one GPU from one of
+   DCGM_FI_DEV_GPU_UTIL_SAMPLES or DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES */
+typedef struct
+{
+    double utilSum;                       /* Sum of the process's samples */
+    unsigned long long firstSampleNumber; /* Samples of every process on the GPU before the process's first one */
+    unsigned long long lastSampleNumber;  /* Samples of every process on the GPU through the process's last one */
+} dcgmcm_pid_util_t;
+
+/* What is known about a process on one GPU, kept up to date as samples are
+   appended so that it can be looked up without walking any history. See
+   GetPidStats() */
+typedef struct
+{
+    unsigned int gpuId;
+    timelib64_t firstSeenUsec;  /* Timestamp of the first sample that named the process */
+    timelib64_t lastSeenUsec;   /* Timestamp of the last sample that named the process */
+    bool haveAccounting;        /* Has an accounting record of the process been cached? */
+    bool haveSmUtil;            /* Is smUtil set? */
+    bool haveMemUtil;           /* Is memUtil set? */
+    dcgmcm_pid_util_t smUtil;   /* From DCGM_FI_DEV_GPU_UTIL_SAMPLES */
+    dcgmcm_pid_util_t memUtil;  /* From DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES */
+} dcgmcm_pid_gpu_stats_t;
+
+/* Running summary of one watch over one summary window. Only the accumulator
+   matching the watch's tsType is used */
+typedef struct
+{
+    DcgmcmSummaryAccumulator<long long> i64;
+    DcgmcmSummaryAccumulator<double> fp64;
+} dcgmcm_window_summary_t;
+
 /*****************************************************************************/
 typedef struct dcgmcm_sample_t /* This is made to look similar to timeseries_value_t
                                   since that is the underlying data anyway */
@@ -81,6 +402,16 @@ typedef struct dcgmcm_sample_t /* This is made to look similar to timeseries_val
 
 } dcgmcm_sample_t, *dcgmcm_sample_p;
 
+/*****************************************************************************/
+/* One query of DcgmCacheManager::GetMultipleSamples() */
+typedef struct
+{
+    dcgm_field_entity_group_t entityGroupId; /* Entity group of the entity to get samples of */
+    dcgm_field_eid_t entityId;               /* Entity to get samples of */
+    unsigned short fieldId;                  /* Field to get samples of */
+    dcgmOrder_t order;                       /* Which end of the time range to start from */
+} dcgmcm_sample_query_t;
+
 /*****************************************************************************/
 /* Details for a single watcher of a field. Each fieldId has a vector of these */
 typedef struct dcgm_watch_watcher_info_t
@@ -91,8 +422,68 @@ typedef struct dcgm_watch_watcher_info_t
                                            field. If 0, the class default is used */
     int isSubscribed;                 /* Does this watcher want live updates
                                            when this field value updates? */
+    timelib64_t lastBufferedUsec = 0; /* Timestamp of the last live update this watcher
+                                           was due. See IsWatcherDue() */
 } dcgm_watch_watcher_info_t, *dcgm_watch_watcher_info_p;
 
+/*****************************************************************************/
+/* Which values of a watch a watcher type's subscribers are handed. See SetWatchPredicate() */
+typedef enum
+{
+    DcgmcmPredicateAll = 0, /* Every value. The default */
+    DcgmcmPredicateNone,    /* No values */
+    DcgmcmPredicateGreater, /* Values > threshold */
+    DcgmcmPredicateLess,    /* Values < threshold */
+    DcgmcmPredicateChanged, /* Values != the last value handed over */
+    DcgmcmPredicateDelta,   /* Values more than threshold away from the last value handed over */
+    DcgmcmPredicateBitsSet, /* Integer values with any bit of mask set */
+    DcgmcmPredicateCount    /* Always keep this one last */
+} dcgmcm_predicate_type_t;
+
+typedef struct
+{
+    dcgmcm_predicate_type_t type;
+    long long i64Threshold; /* Threshold int64 values are compared to */
+    double dblThreshold;    /* Threshold double values are compared to */
+    long long mask;         /* Bits of DcgmcmPredicateBitsSet */
+} dcgmcm_predicate_t;
+
+/* A numeric value being appended to a watch, as a predicate sees it */
+typedef struct
+{
+    bool isInt64;
+    long long i64;
+    double dbl;
+} dcgmcm_predicate_value_t;
+
+/* The predicate of one watcher type on one watch */
+typedef struct
+{
+    DcgmWatcherType_t watcherType;
+    dcgmcm_predicate_t predicate;
+    bool haveLastValue;                 /* Is lastValue set? */
+    dcgmcm_predicate_value_t lastValue; /* Last value that matched. For DcgmcmPredicateChanged and Delta */
+} dcgmcm_watch_predicate_t;
+
+/*****************************************************************************/
+/* One watcher of one watch. See GetConnectionWatches() */
+typedef struct
+{
+    dcgm_field_entity_group_t entityGroupId; /* Entity group of the watch */
+    dcgm_field_eid_t entityId;               /* Entity of the watch */
+    unsigned short fieldId;                  /* Field of the watch */
+    dcgm_watch_watcher_info_t watcherInfo;   /* The watcher and what it asked for */
+} dcgmcm_watcher_watch_t;
+
+/*****************************************************************************/
+/* Cache memory attributed to one watcher. See GetWatcherBytesUsed() */
+typedef struct
+{
+    DcgmWatcher watcher; /* Who is being charged */
+    long long bytesUsed; /* Bytes of samples kept for this watcher's watches. Watches with several
+                            watchers are split evenly between them */
+} dcgmcm_watcher_bytes_t;
+
 /*****************************************************************************/
 /* Unique key for a given fieldEntityGroup + entityId + fieldId combination */
 typedef struct dcgmcm_entity_key_t
@@ -103,6 +494,65 @@ typedef struct dcgmcm_entity_key_t
                                            belongs to */
 } dcgmcm_entity_key_t;            /* 8 bytes */
 
+/* Watches that are fetched together with a shared timestamp. See AddSnapshotGroup() */
+typedef struct
+{
+    DcgmWatcher watcher;                   /* Who added the group. It goes away with watcher's connection */
+    std::vector<dcgmcm_entity_key_t> keys; /* Watches of the group */
+} dcgmcm_snapshot_group_t;
+
+/*****************************************************************************/
+/*
+ * Latest numeric sample of a watch, published with a seqlock so that readers
+ * can get it without taking the cache manager's lock. The writer holds
+ * m_mutex and makes sequence odd for the duration of each update. Readers
+ * retry if sequence was odd or changed while they were copying the value.
+ *
+ * Every member is atomic so that a racing read is never undefined behavior.
+ * Double values are stored bitwise in val and val2
+ */
+typedef struct dcgmcm_latest_value_t
+{
+    dcgmcm_latest_value_t()
+        : sequence(0)
+        , tsType(TS_TYPE_UNKNOWN)
+        , timestamp(0)
+        , val(0)
+        , val2(0)
+        , updateSequence(0)
+    {}
+
+    /* Copies are only made while holding the writer's lock, so they don't retry */
+    dcgmcm_latest_value_t(dcgmcm_latest_value_t const &other)
+        : sequence(other.sequence.load(std::memory_order_relaxed))
+        , tsType(other.tsType.load(std::memory_order_relaxed))
+        , timestamp(other.timestamp.load(std::memory_order_relaxed))
+        , val(other.val.load(std::memory_order_relaxed))
+        , val2(other.val2.load(std::memory_order_relaxed))
+        , updateSequence(other.updateSequence.load(std::memory_order_relaxed))
+    {}
+
+    dcgmcm_latest_value_t &operator=(dcgmcm_latest_value_t const &other)
+    {
+        sequence.store(other.sequence.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        tsType.store(other.tsType.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        timestamp.store(other.timestamp.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        val.store(other.val.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        val2.store(other.val2.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        updateSequence.store(other.updateSequence.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    std::atomic<unsigned int> sequence; /* Incremented before and after each update */
+    std::atomic<int> tsType;            /* TS_TYPE_? of val and val2. TS_TYPE_UNKNOWN if there is
+                                           no numeric sample to return without the lock */
+    std::atomic<long long> timestamp;   /* usecSince1970 of the sample */
+    std::atomic<long long> val;         /* i64, or bits of the double value */
+    std::atomic<long long> val2;        /* i64, or bits of the double value2 */
+    std::atomic<unsigned long long> updateSequence; /* m_updateSequence as of the last update of the watch.
+                                                       0 = never updated. See GetWatchUpdateSequence() */
+} dcgmcm_latest_value_t;
+
 /*****************************************************************************/
 /*
  * Struct to hold a single watch and its field values
@@ -120,18 +570,37 @@ typedef struct dcgmcm_watch_info_t
                                            have subscribed for notifications?. This
                                            should be the logical OR of
                                            watchers[0-n].isSubscribed */
+    short eventPending;                              /* Did an NVML event say this field changed since
+                                           it was last fetched? See RefreshEventBackedWatches() */
     nvmlReturn_t lastStatus;                         /* Last status returned from querying this
                                            value. See NVML_? values in nvml.h */
     timelib64_t lastQueriedUsec;                     /* Last time we updated this value. Used for
                                            determining if we should request an update
                                            of this field or not */
+    timelib64_t lastReadUsec;                        /* Last time a client read this watch's history.
+                                           0 = never. See SetCacheMemoryBudget() */
+    unsigned long long lastSampleTimestamp;          /* Driver timestamp of the newest buffered sample
+                                           cached. 0 = none yet. See SetBufferedSampling() */
     timelib64_t monitorFrequencyUsec;                /* How often this field should be sampled */
+    timelib64_t nextUpdateUsec;                      /* When this watch is next due in m_watchSchedule.
+                                           0 = not scheduled */
     timelib64_t maxAgeUsec;                          /* Maximum time to cache samples of this
                                            field. If 0, the class default is used */
+    timelib64_t rawRetentionUsec;                    /* How long to keep raw samples when watchers
+                                           slower than monitorFrequencyUsec keep longer
+                                           than that. 0 = maxAgeUsec */
+    std::vector<dcgmcm_rollup_tier_config_t> watcherTiers; /* Rollup tiers that keep the history of
+                                           those slower watchers. See UpdateWatchFromWatchers() */
     timelib64_t execTimeUsec;                        /* Cumulative time spent updating this
                                            field since the cache manager started */
     long long fetchCount;                            /* Number of times that this field has been
                                            fetched from the driver */
+    timelib64_t maxExecTimeUsec;                     /* Longest single fetch of this field */
+    long long execTimeHistogram[DCGM_INTROSPECT_EXEC_TIME_BUCKETS]; /* Fetches by duration. See
+                                                                       RecordWatchExecTime() */
+    timelib64_t maxSampleLagUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT];  /* Oldest sample at each stage */
+    /* Samples by how old they were at each dcgmIntrospectLagStage_t. See RecordSampleLag() */
+    long long sampleLagHistogram[DCGM_INTROSPECT_LAG_STAGE_COUNT][DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
     timeseries_p timeSeries;                         /* Time-series of values for this watch */
     std::vector<dcgm_watch_watcher_info_t> watchers; /* Info for each watcher of this
                                                        field. monitorFrequencyUsec and
@@ -142,8 +611,47 @@ typedef struct dcgmcm_watch_info_t
     dcgm_field_entity_group_t practicalEntityGroupId; /* the entity group id where data should
                                                         be polled */
     dcgm_field_eid_t practicalEntityId;               /* the entity id where data should be pulled */
+    dcgmcm_latest_value_t latestValue;                /* Lock-free copy of the last sample of timeSeries.
+                                                         See PublishLatestValue() */
+    std::shared_ptr<DcgmCacheRollup> rollup;          /* Aggregates of samples older than timeSeries keeps.
+                                                         nullptr = none. See WatchInfoUsesRollups() */
+    std::map<unsigned int, dcgmcm_window_summary_t> windowSummaries; /* Running summaries by summary window
+                                                                       ID. See AddSummaryWindow() */
+    struct dcgmcm_watch_info_t *rateWatchInfo; /* Watch of the rate field derived from this counter field.
+                                                  nullptr = none. See AppendCounterRate() */
+    long long rateLastCounter;                 /* Counter value the next rate is taken from */
+    timelib64_t rateLastUsec;                  /* Timestamp of rateLastCounter. 0 = none yet */
+    /* Watches of derived fields that use this watch as an input. See AppendDerivedFields() */
+    std::vector<struct dcgmcm_watch_info_t *> derivedWatchInfos;
+    /* Input watches of this derived field's watch, in the order of its expression's inputs */
+    std::vector<struct dcgmcm_watch_info_t *> derivedInputs;
+    /* Predicates of the watcher types whose subscribers don't want every value. Replaced as a whole
+       under m_mutex and read by the update threads without it. nullptr = none. See SetWatchPredicate() */
+    std::shared_ptr<std::vector<dcgmcm_watch_predicate_t>> predicates;
+    unsigned int snapshotGroupId; /* Snapshot group this watch is fetched with. 0 = none. See AddSnapshotGroup() */
+    /* EWMA of the samples and their variance, for adaptive sampling. See UpdateAdaptiveSampling() */
+    double adaptiveMean;
+    double adaptiveVariance;
+    unsigned int adaptiveSamples; /* Samples in adaptiveMean. Stops counting at 2 */
+    bool adaptiveQuiet;           /* Did the latest samples stay within the threshold of adaptiveMean? */
+    DcgmCacheArena *arena; /* Arena this struct and the ring of timeSeries are allocated from. nullptr = the heap.
+                              See SetCacheArenas() */
 } dcgmcm_watch_info_t, *dcgmcm_watch_info_p;
 
+/*****************************************************************************/
+/*
+ * Open-addressed table of watch infos keyed by dcgmcm_entity_key_t that can be
+ * searched without the cache manager's lock. It is only added to while holding
+ * m_mutex. When it gets too full, a larger copy is published in its place and
+ * the old one is retired but kept alive, since watch infos are never removed
+ */
+typedef struct
+{
+    unsigned int capacityLog2;                                 /* log2 of the number of slots */
+    unsigned int count;                                        /* Number of slots in use */
+    std::unique_ptr<std::atomic<dcgmcm_watch_info_p>[]> slots; /* Watch infos. nullptr = empty */
+} dcgmcm_watch_index_t;
+
 /*****************************************************************************/
 typedef struct dcgmcm_vgpu_info_t
 {
@@ -151,6 +659,16 @@ typedef struct dcgmcm_vgpu_info_t
     bool found;                      /* Flag to denote that the vGPU instance is
                                            still active */
     struct dcgmcm_vgpu_info_t *next; /* Pointer to the next node in the list */
+
+    /* Metadata that is fixed for the life of the instance. Fetched from NVML the first
+       time it is needed and dropped with the node when ManageVgpuList() sees the
+       instance go away */
+    bool haveVgpuTypeId;                     /* Whether vgpuTypeId is valid */
+    unsigned int vgpuTypeId;                 /* nvmlVgpuInstanceGetType() */
+    bool haveVmId;                           /* Whether vmId is valid */
+    char vmId[DCGM_DEVICE_UUID_BUFFER_SIZE]; /* nvmlVgpuInstanceGetVmID() */
+    bool haveUuid;                           /* Whether uuid is valid */
+    char uuid[DCGM_DEVICE_UUID_BUFFER_SIZE]; /* nvmlVgpuInstanceGetUUID() */
 } dcgmcm_vgpu_info_t, *dcgmcm_vgpu_info_p;
 
 extern const unsigned int DCGM_BLANK_ENTITY_ID;
@@ -278,11 +796,78 @@ typedef struct dcgmcm_runtime_stats_t
                                       predicate for m_condition */
     long long lockCount;           /* Number of times that the cache manager mutex has been locked. This is
                                       periodically snapshotted from the cache manager update threads */
+
+    long long driverCallsSaved;          /* Number of driver calls the update thread avoided by batching fields
+                                            that are read by the same NVML call */
+    long long lastCycleDriverCallsSaved; /* driverCallsSaved for the most recent update cycle only */
+
+    long long budgetTrimCount; /* Number of watches whose history was dropped to stay within the cache
+                                  memory budget. See SetCacheMemoryBudget() */
+
+    long long lastCycleUsec;      /* How long the most recent update cycle took in usec */
+    long long lastSubscriberUsec; /* How much of the most recent update cycle was spent in UpdateFvSubscribers() */
 } dcgmcm_runtime_stats_t, *dcgmcm_runtime_stats_p;
 
 /*****************************************************************************/
-/* Cache manager update thread context structure. This exists to prevent stack
-   overflow in the update thread by storing large objects on the heap */
+/* Host engine state that the DCGM_FI_HOSTENGINE_* fields report but the cache
+   manager can't see itself. See SetHostengineStatsCallback() */
+typedef struct
+{
+    long long ipcQueueDepth;  /* Client requests waiting for a worker */
+    long long numConnections; /* Open connections */
+} dcgmcm_hostengine_stats_t;
+
+typedef std::function<void(dcgmcm_hostengine_stats_t &)> dcgmcm_hostengine_stats_f;
+
+/*****************************************************************************/
+/* NVML getters that return the values of several fields at once */
+typedef enum
+{
+    DcgmcmBatchedUtilization = 0,       /* nvmlDeviceGetUtilizationRates() */
+    DcgmcmBatchedMemoryInfo,            /* nvmlDeviceGetMemoryInfo() */
+    DcgmcmBatchedBar1MemoryInfo,        /* nvmlDeviceGetBAR1MemoryInfo() */
+    DcgmcmBatchedFbcSessions,           /* nvmlDeviceGetFBCSessions(). Fanned out to the GPU's vGPU instances */
+    DcgmcmBatchedEncoderSessions,       /* nvmlDeviceGetEncoderSessions(). Fanned out to the GPU's vGPU instances */
+    DcgmcmBatchedPciInfo,               /* nvmlDeviceGetPciInfo_v3() */
+    DcgmcmBatchedPowerLimitConstraints, /* nvmlDeviceGetPowerManagementLimitConstraints() */
+    DcgmcmBatchedCount                  /* Always last */
+} dcgmcm_batched_getter_t;
+
+/* Results of the batched getters for one GPU. These are shared by all of the fields
+   that a getter covers until the thread context is cleared */
+typedef struct dcgmcm_batched_gpu_values_t
+{
+    unsigned int validMask;                      /* Bitmask of 1 << dcgmcm_batched_getter_t of the getters that
+                                                    have been called since the last ClearThreadCtx() */
+    nvmlReturn_t nvmlReturn[DcgmcmBatchedCount]; /* Return of each getter */
+    nvmlUtilization_t utilization;               /* DcgmcmBatchedUtilization */
+    nvmlMemory_t memory;                         /* DcgmcmBatchedMemoryInfo */
+    nvmlBAR1Memory_t bar1Memory;                 /* DcgmcmBatchedBar1MemoryInfo */
+    nvmlPciInfo_t pciInfo;                       /* DcgmcmBatchedPciInfo */
+    unsigned int powerLimitMin;                  /* DcgmcmBatchedPowerLimitConstraints. Milliwatts */
+    unsigned int powerLimitMax;                  /* DcgmcmBatchedPowerLimitConstraints. Milliwatts */
+
+    /* DcgmcmBatchedFbcSessions and DcgmcmBatchedEncoderSessions. The arrays are grown as
+       needed and kept across ClearThreadCtx() calls. FreeThreadCtx() frees them */
+    nvmlFBCSessionInfo_t *fbcSessions;
+    unsigned int numFbcSessions;
+    unsigned int fbcSessionsCapacity;
+    nvmlEncoderSessionInfo_t *encoderSessions;
+    unsigned int numEncoderSessions;
+    unsigned int encoderSessionsCapacity;
+} dcgmcm_batched_gpu_values_t;
+
+/* Watches of one GPU to update with field-value APIs rather than CacheLatest*Value().
+   The vectors keep their capacity across ClearThreadCtx() calls */
+typedef struct dcgmcm_gpu_field_values_t
+{
+    std::vector<dcgm_field_meta_p> fields;      /* Fields to update */
+    std::vector<dcgmcm_watch_info_p> watchInfo; /* Watch info of each entry of fields */
+} dcgmcm_gpu_field_values_t;
+
+/*****************************************************************************/
+/* Cache manager update thread context structure. This holds the scratch state of
+   an update cycle so it can be reused from cycle to cycle */
 typedef struct dcgmcm_update_thread_t
 {
     /* Information about the entity currently being worked on */
@@ -292,20 +877,69 @@ typedef struct dcgmcm_update_thread_t
 
     DcgmFvBuffer *fvBuffer;           /* If != NULL, this any Append* calls will result in
                                       values being appended to this structure */
+    int bufferForSubscribers;         /* If set, Append* calls will buffer values of watches with live
+                                         subscribers in subscriberFvBuffers */
+    DcgmFvBuffer *subscriberFvBuffers[DcgmWatcherTypeCount]; /* Values of each watcher type's subscribed
+                                                                watches. Allocated on first use */
     unsigned int affectedSubscribers; /* This is a bitmask of DcgmWatcherType_t bits of which watchers have
-                                         suscribed-for updates in fvBuffer. Using a bitmask here to avoid
+                                         suscribed-for updates in subscriberFvBuffers. Using a bitmask to avoid
                                          zeroing a large array of ints every update loop, also not using
                                          a std::set or list of DcgmWatcherType_t's for performance.
                                          Finally, we're not tracking clientId yet. If we ever extend this
                                          functionality to clients, we will have to track client ID as well. */
 
-    int numFieldValues[DCGM_MAX_NUM_DEVICES];                              /* Number of field values per device
-                                                                              saved in fieldValueFields and fieldValueWatchInfo*/
-    dcgm_field_meta_p fieldValueFields[DCGM_MAX_NUM_DEVICES][NVML_FI_MAX]; /* Fields to update with field-value APIs
-                                                                              rather than CacheLatest*Value() */
-    dcgmcm_watch_info_p fieldValueWatchInfo[DCGM_MAX_NUM_DEVICES][NVML_FI_MAX]; /* Watch info for field values */
+    std::vector<dcgmcm_gpu_field_values_t> fieldValues; /* Mapped fields of each gpuId, indexed by gpuId. Only grown
+                                                           as far as the highest gpuId that had any, so clearing
+                                                           it is cheap on small systems */
+
+    std::vector<dcgmcm_batched_gpu_values_t> batchedValues; /* Results of batched getters, indexed by gpuId. Grown
+                                                               on first use. See GetBatchedGpuValues() */
+    long long driverCallsSaved; /* Number of driver calls avoided by batching since the last ClearThreadCtx() */
+    timelib64_t cycleTimestamp; /* If != 0, Append* calls use this as the timestamp of every value. Set for the
+                                   snapshot pass of ActuallyUpdateAllFields(). See AddSnapshotGroup() */
+    std::vector<dcgmcm_watch_info_p> derivedWatches; /* Watches of derived fields whose inputs were appended to
+                                                        since they were last evaluated. See AppendDerivedFields() */
+    dcgmcm_watch_info_p deferQuotaWatchInfo; /* If != NULL, Append* calls to this watch leave enforcing its quota
+                                                to the caller, which does it once after appending a run of samples.
+                                                See AppendSamples() */
 } dcgmcm_update_thread_t, *dcgmcm_update_thread_p;
 
+/*****************************************************************************/
+/*
+ * Fetches the polled watches of one entity group in one call, so that entity
+ * type can batch its driver queries. The update thread runs the collectors of
+ * different entity groups on their own workers, concurrently with each other
+ * and with the GPU fetches. See DcgmCacheManager::SetEntityCollector()
+ */
+class DcgmEntityCollector
+{
+public:
+    virtual ~DcgmEntityCollector() = default;
+
+    /*************************************************************************/
+    /*
+     * Add the latest value of each of keys, which all belong to this
+     * collector's entity group, to fvBuffer. The cache manager caches and
+     * publishes everything in fvBuffer that it is watching once this returns.
+     * Values that couldn't be read should be the field type's blank value for
+     * the error, with a status other than DCGM_ST_OK.
+     *
+     * This is called from a worker thread without the cache manager locked
+     */
+    virtual void Collect(std::vector<dcgmcm_entity_key_t> const &keys, DcgmFvBuffer &fvBuffer) = 0;
+};
+
+/* One entity collector's share of an update cycle. Reused from cycle to cycle. See StartEntityCollectors() */
+typedef struct dcgmcm_collector_pass_t
+{
+    std::shared_ptr<DcgmEntityCollector> collector; /* Held for the pass in case it's replaced meanwhile */
+    std::vector<dcgmcm_watch_info_p> watches;       /* Due watches of the collector's entity group */
+    std::vector<dcgmcm_entity_key_t> keys;          /* Key of each of watches, for the collector */
+    DcgmFvBuffer fvBuffer;                          /* Values the collector returned */
+    std::shared_future<void> worker;                /* The worker running the collector */
+    timelib64_t collectUsec;                        /* How long the collector took */
+} dcgmcm_collector_pass_t;
+
 /*****************************************************************************/
 /* Callback function
  * Return True if the entry should be used for summary calculation
@@ -320,14 +954,17 @@ typedef bool (*pfUseEntryForSummary)(timeseries_entry_p entry, void *userData);
  *
  * fvBuffer        IN: Contains buffered field values that have updated that subscribers
  *                     have said they cared about. It's the the callee's job to walk the
- *                     FVs and determine if they need the updates or not.
+ *                     FVs and determine if they need the updates or not. Every subscriber
+ *                     gets the same read-only snapshot. Callees may keep a reference and
+ *                     walk it later from their own thread rather than blocking the update
+ *                     thread.
  * watcherTypes    IN: Which watchers care about the updates in fvBuffer
  * numWatcherTypes IN: How many entries in watcherTypes are valid
  *
  * userData IN: A user-supplied pointer that was passed to
  * DcgmCacheManager::SubscribeForFvUpdates
  */
-typedef void (*dcgmOnSubscribedFvUpdate_f)(DcgmFvBuffer *fvBuffer,
+typedef void (*dcgmOnSubscribedFvUpdate_f)(std::shared_ptr<DcgmFvBuffer const> const &fvBuffer,
                                            DcgmWatcherType_t *watcherTypes,
                                            int numWatcherTypes,
                                            void *userData);
@@ -360,6 +997,9 @@ typedef struct
     void *userData; // user data passed to callback function
 } dcgmcmEventSubscription_t;
 
+/*****************************************************************************/
+struct dcgmcm_gpu_field_fetcher_t; /* See DcgmGpuFieldFetchers.h */
+
 /*****************************************************************************/
 class DcgmCacheManager; /* Forward declare the cache manager so it can be
                            used by DcgmCacheManagerEventThread */
@@ -385,35 +1025,6 @@ public:
     void run(void);
 };
 
-class DcgmGpuConnectionPair
-{
-public:
-    unsigned int gpu1;
-    unsigned int gpu2;
-
-    DcgmGpuConnectionPair(unsigned int g1, unsigned int g2)
-        : gpu1(g1)
-        , gpu2(g2)
-    {}
-
-    bool operator==(const DcgmGpuConnectionPair &other) const
-    {
-        return ((other.gpu1 == this->gpu1 && other.gpu2 == this->gpu2)
-                || (other.gpu2 == this->gpu1 && other.gpu1 == this->gpu2));
-    }
-
-    bool CanConnect(const DcgmGpuConnectionPair &other) const
-    {
-        return ((this->gpu1 == other.gpu1) || (this->gpu1 == other.gpu2) || (this->gpu2 == other.gpu1)
-                || (this->gpu2 == other.gpu2));
-    }
-
-    bool operator<(const DcgmGpuConnectionPair &other) const
-    {
-        return this->gpu1 < other.gpu1;
-    }
-};
-
 /*****************************************************************************/
 /* Cache manager main class */
 class DcgmCacheManager : public DcgmThread
@@ -440,6 +1051,216 @@ public:
      */
     dcgmReturn_t Init(int pollInLockStep, double maxSampleAge);
 
+    /*************************************************************************/
+    /*
+     * Enable or disable compressed storage of sample history for long-lived
+     * numeric watches (those expected to keep DCGM_CM_COMPRESS_MIN_SAMPLES or
+     * more samples). This only affects watches whose sample storage is allocated
+     * after this call. It is off by default unless the DCGM_ENV_COMPRESS_HISTORY
+     * environment variable is set.
+     */
+    void SetHistoryCompression(bool enabled);
+
+    /*************************************************************************/
+    /*
+     * Enable or disable fetching each GPU's due watches on its own worker
+     * thread during an update cycle. When enabled, the length of an update
+     * cycle is bounded by the slowest GPU rather than the sum over all GPUs.
+     * It is off by default unless the DCGM_ENV_PARALLEL_GPU_FETCH environment
+     * variable is set.
+     */
+    void SetParallelGpuFetch(bool enabled);
+
+    /*************************************************************************/
+    /*
+     * Have collector fetch the polled watches of entityGroupId in place of the
+     * cache manager's own fetch. Passing nullptr goes back to the built-in
+     * collector of entityGroupId, if it has one. vGPUs have a built-in
+     * collector. GPU and global watches are fetched by the update loop and
+     * can't have a collector.
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM if entityGroupId can't have a collector
+     */
+    dcgmReturn_t SetEntityCollector(dcgm_field_entity_group_t entityGroupId,
+                                    std::shared_ptr<DcgmEntityCollector> collector);
+
+    /*************************************************************************/
+    /*
+     * Enable or disable pinning the cache manager's threads near the GPUs
+     * they poll. When enabled, each GPU fetch worker runs on the CPUs of its
+     * GPU's affinity while it fetches that GPU, and the update thread runs on
+     * the CPUs near any GPU. Samples are allocated by the thread that caches
+     * them, so the kernel's first touch policy puts them on the matching NUMA
+     * node. CPUs the process wasn't allowed to use at construction are never
+     * used. It is off by default unless the DCGM_ENV_THREAD_PLACEMENT
+     * environment variable is DCGM_THREAD_PLACEMENT_GPU.
+     */
+    void SetThreadPlacement(bool nearGpus);
+
+    /*************************************************************************/
+    /*
+     * Enable or disable reading watches of power and GPU, memory, encoder and
+     * decoder utilization from the driver's sample buffers. Each update then
+     * caches every sample the driver took since the previous one, with the
+     * driver's timestamps, so a slow watch still gets the driver's full
+     * resolution. Fields fall back to one instantaneous read per update on
+     * GPUs without sample buffers. It is off by default unless the
+     * DCGM_ENV_BUFFERED_SAMPLING environment variable is set.
+     */
+    void SetBufferedSampling(bool enabled);
+
+    /*************************************************************************/
+    /*
+     * Let watch deadlines move by up to jitterUsec so that they land on a tick
+     * grid shared by every watch: the GCD of their monitor frequencies. Watches
+     * that are due together are fetched in the same pass, with batched driver
+     * calls per GPU, and the polling loop wakes up less often. A watch never
+     * moves by more than a quarter of its own monitor frequency.
+     * 0 = off, which is the default unless DCGM_ENV_WATCH_COALESCE_USEC is set.
+     */
+    void SetWatchCoalescing(timelib64_t jitterUsec);
+
+    /*************************************************************************/
+    /*
+     * Update watches of fields that NVML raises events for, like ECC error
+     * counts, when the event arrives instead of at their monitor frequency.
+     * Those watches are only polled every pollUsec, or at their monitor
+     * frequency if that is longer, in case an event was missed. This only
+     * applies to GPUs that support the events.
+     * 0 = off, which is the default unless DCGM_ENV_EVENT_FIELD_POLL_USEC is set.
+     */
+    void SetEventFieldPolling(timelib64_t pollUsec);
+
+    /*************************************************************************/
+    /*
+     * Poll numeric GPU watches faster than baseUsec only while their values
+     * move. A watch's monitor frequency is its burst rate. Once its recent
+     * samples stay within threshold (relative to their mean, so 0.01 = 1%)
+     * it drops to the base rate of one sample per baseUsec, and it bursts
+     * again as soon as a sample moves past the threshold or the GPU's
+     * utilization changes. The rate a watch is actually polled at is in its
+     * pollIntervalUsec from GetCacheManagerFieldInfo(), which also sets
+     * DCGM_CMI_F_ADAPTIVE_DECIMATED while that's below the burst rate.
+     * 0 = off, which is the default unless DCGM_ENV_ADAPTIVE_SAMPLING_USEC
+     * is set. DCGM_ENV_ADAPTIVE_SAMPLING_THRESHOLD overrides the default
+     * threshold of DCGM_CM_ADAPTIVE_DEFAULT_THRESHOLD.
+     */
+    void SetAdaptiveSampling(timelib64_t baseUsec, double threshold);
+
+    /*************************************************************************/
+    /*
+     * Get the NVML event type that signals a change of fieldId, for fields
+     * that can be event-backed. See SetEventFieldPolling()
+     *
+     * Returns the nvmlEventType* bit
+     *         0 if the field has no event
+     */
+    static unsigned long long NvmlEventTypeForField(unsigned short fieldId);
+
+    /*************************************************************************/
+    /*
+     * Move dueUsec to the nearest multiple of tickUsec if that is at most
+     * jitterUsec away. Ticks shorter than jitterUsec are widened to it.
+     *
+     * Returns the aligned deadline or dueUsec if no tick is close enough
+     */
+    static timelib64_t AlignWatchDeadline(timelib64_t dueUsec, timelib64_t tickUsec, timelib64_t jitterUsec);
+
+    /*************************************************************************/
+    /*
+     * Get the bucket of a watch's execTimeHistogram that a fetch taking
+     * execTimeUsec is counted in. Bucket 0 is under 2 usec, bucket i is
+     * [2^i, 2^(i+1)) usec and the last bucket also takes everything longer.
+     */
+    static int GetExecTimeBucket(timelib64_t execTimeUsec);
+
+    /*************************************************************************/
+    /*
+     * Save the definitions and samples of every watch that has samples to a
+     * binary snapshot file. See DcgmCacheSnapshot.h for the format.
+     *
+     * If the DCGM_ENV_CACHE_SNAPSHOT environment variable names a file, this
+     * is done automatically by Shutdown() and the file is loaded by Init().
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_GENERIC_ERROR if the file couldn't be written
+     */
+    dcgmReturn_t SaveSnapshot(std::string const &filename);
+
+    /*************************************************************************/
+    /*
+     * Restore samples from a snapshot written by SaveSnapshot(). Samples are
+     * only restored into watches that don't have any yet and those older than
+     * the watch's max age are dropped. GPU samples are dropped if the GPU's
+     * UUID changed. GPU instance, compute instance and vGPU samples are always
+     * dropped since their IDs don't survive a restart.
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_NO_DATA if there is no snapshot
+     *         Other DCGM_ST_? on error. See DcgmCacheSnapshotReader::Open()
+     */
+    dcgmReturn_t LoadSnapshot(std::string const &filename);
+
+    /*************************************************************************/
+    /*
+     * Keep aggregates of numeric watches whose max age is longer than
+     * rawRetentionUsec, so that only rawRetentionUsec of their raw samples
+     * have to be kept. GetSamples() and Get*SummaryData() use the finest tier
+     * that reaches back to the start of the requested window for the part of
+     * it that is older than the raw samples.
+     *
+     * Existing watches start to roll up on their next sample. Passing no
+     * tiers turns this off. It is off by default unless the
+     * DCGM_ENV_ROLLUP_TIERS environment variable is set. See
+     * DcgmCacheRollup::ParseTiers() for its format.
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM if the tiers don't have growing bucket widths and retentions
+     */
+    dcgmReturn_t SetRollupTiers(timelib64_t rawRetentionUsec, std::vector<dcgmcm_rollup_tier_config_t> const &tiers);
+
+    /*************************************************************************/
+    /*
+     * Write the samples of numeric watches to segment files in directory as
+     * they age out of the cache, instead of dropping them, and keep them
+     * there until the files take more than budgetBytes. GetSamples() serves
+     * the part of a window that is older than the cache from the files, and
+     * from rollups only before the oldest spilled sample. See DcgmCacheSpill.
+     *
+     * Samples spilled to directory before are served too. Passing "" turns
+     * this off, keeping the files. It is off by default unless the
+     * DCGM_ENV_SPILL_DIR environment variable is set.
+     *
+     * budgetBytes IN: Most bytes the files may take. <= 0 = DCGM_CM_SPILL_DEFAULT_BUDGET_BYTES
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_GENERIC_ERROR if directory can't be created or read
+     */
+    dcgmReturn_t SetSpill(std::string const &directory, long long budgetBytes);
+
+    /*************************************************************************/
+    /*
+     * Allocate watches created from now on, and the ring buffers of their
+     * samples, from an arena per GPU rather than from the heap. Watches of
+     * GPU instances and compute instances share the arena of their GPU.
+     * Watches of other entities share one arena. See DcgmCacheArena.
+     *
+     * Existing watches stay where they were allocated. Arenas keep their
+     * memory until the cache manager is destroyed. This is off by default
+     * unless the DCGM_ENV_CACHE_ARENAS environment variable is set.
+     *
+     * useHugetlb IN: Map arena chunks from the hugetlbfs pool while it has room
+     *                rather than relying on transparent huge pages
+     */
+    void SetCacheArenas(bool enabled, bool useHugetlb);
+
+    /*************************************************************************/
+    /*
+     * Get the combined usage of the cache arenas. All zeros if none were used
+     */
+    void GetCacheArenaStats(dcgmcm_arena_stats_t &stats);
+
     /*************************************************************************/
     /*
      * Shutdown and clean up this object, including stopping the monitoring thread
@@ -832,6 +1653,53 @@ public:
      */
     dcgmReturn_t GetLatestProcessInfo(unsigned int gpuId, unsigned int pid, dcgmDevicePidAccountingStats_t *pidInfo);
 
+    /*************************************************************************/
+    /*
+     * Get what is known about pid on each GPU it was seen on by an accounting
+     * record or a process utilization sample. This is a lookup, so it takes
+     * the same time however long the history is. Process utilization is
+     * averaged like GetUniquePidUtilLists() does, over the samples of every
+     * process from the process's first sample through its last one. See
+     * PidUtilization()
+     *
+     * pid       IN: Process to look up
+     * stats    OUT: One entry per GPU, in the order the process was first seen on them
+     *
+     * Returns: DCGM_ST_OK if the process was seen on any GPU
+     *          DCGM_ST_NO_DATA if not
+     */
+    dcgmReturn_t GetPidStats(unsigned int pid, std::vector<dcgmcm_pid_gpu_stats_t> &stats);
+
+    /*************************************************************************/
+    /*
+     * Get the processes of gpuId that ran during [startTime, endTime] from
+     * an interval tree of their lifetimes, so that the time taken depends on
+     * how many processes overlap the window, not on how long the history is.
+     * Lifetimes come from accounting records for DCGM_FI_DEV_ACCOUNTING_DATA,
+     * and run from the first through the last sample naming the process for
+     * DCGM_FI_DEV_COMPUTE_PIDS and DCGM_FI_DEV_GRAPHICS_PIDS
+     *
+     * fieldId     IN: One of the three fields above
+     * startTime   IN: 0 = from the beginning
+     * endTime     IN: 0 = up until now
+     * intervals  OUT: Lifetime of each process, in order of start time
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_BADPARAM if gpuId or fieldId is out of range
+     */
+    dcgmReturn_t GetProcessesInWindow(unsigned int gpuId,
+                                      unsigned short fieldId,
+                                      timelib64_t startTime,
+                                      timelib64_t endTime,
+                                      std::vector<dcgm_process_interval_t> &intervals);
+
+    /* The average utilization util comes to. DCGM_INT32_BLANK if there were no samples */
+    static double PidUtilization(dcgmcm_pid_util_t const &util)
+    {
+        unsigned long long numSamples = util.lastSampleNumber - util.firstSampleNumber;
+        return numSamples == 0 ? (double)DCGM_INT32_BLANK : util.utilSum / numSamples;
+    }
+
     /*************************************************************************/
     /*
      * Get a list of unique graphics or compute pids
@@ -963,6 +1831,44 @@ public:
                                     pfUseEntryForSummary enumCB,
                                     void *userData);
 
+    /*************************************************************************/
+    /*
+     * Register a window whose summaries are kept up to date as samples are
+     * appended, so that GetInt64SummaryData() and GetFp64SummaryData() calls
+     * over it don't have to walk the cache. A call matches the window if it
+     * has no enumCB, the same startTime and either the same endTime or, while
+     * the window is open, an endTime at or after the newest sample.
+     *
+     * Running summaries keep counting samples that have since been evicted
+     * from the cache.
+     *
+     * startTime  IN: First timestamp in the window
+     * windowId  OUT: ID to pass to CloseSummaryWindow() and RemoveSummaryWindow()
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM if startTime isn't set
+     */
+    dcgmReturn_t AddSummaryWindow(timelib64_t startTime, unsigned int *windowId);
+
+    /*************************************************************************/
+    /*
+     * Set the last timestamp of an open summary window
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_NO_DATA if windowId isn't registered
+     *         DCGM_ST_BADPARAM if endTime is before the window starts
+     */
+    dcgmReturn_t CloseSummaryWindow(unsigned int windowId, timelib64_t endTime);
+
+    /*************************************************************************/
+    /*
+     * Stop keeping summaries for a window
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_NO_DATA if windowId isn't registered
+     */
+    dcgmReturn_t RemoveSummaryWindow(unsigned int windowId);
+
     /*************************************************************************/
     /*
      * Get samples of a time series field
@@ -987,17 +1893,104 @@ public:
      *                  DCGM_ORDER_DESCENDING = decreasing timestamps, starting from
      *                       endTime
      *
-     * Returns 0 on success
-     *        <0 on error. See DCGM_ST_? #defines
+     * Returns 0 on success
+     *        <0 on error. See DCGM_ST_? #defines
+     */
+    dcgmReturn_t GetSamples(dcgm_field_entity_group_t entityGroupId,
+                            dcgm_field_eid_t entityId,
+                            unsigned short dcgmFieldId,
+                            dcgmcm_sample_p samples,
+                            int *Msamples,
+                            timelib64_t startTime,
+                            timelib64_t endTime,
+                            dcgmOrder_t order);
+
+    /*************************************************************************/
+    /*
+     * Get the samples of a time series field that come after a position,
+     * oldest first, for reading history in pages. Unlike startTime of
+     * GetSamples(), continuing from a position doesn't search for it in the
+     * usual case, and neither returns a sample twice nor misses one as samples
+     * are added and removed in between. Rolled-up history isn't returned.
+     *
+     * entityGroupId   IN: Which entity group to get the value for
+     * entityId        IN: The entity to get the value for
+     * dcgmFieldId     IN: Which DCGM field to get the value for
+     * samples        OUT: Where to place samples. Capacity of this memory should
+     *                     be provided in Msamples
+     * Msamples        IO: When called, is the capacity that samples can hold.
+     *                     When returning, Msamples contains the number of samples
+     *                     actually stored in samples[]
+     * position        IO: Where to continue from. Zero it to start at the oldest
+     *                     sample. Set to the position after the last sample returned
+     * samplesSkipped OUT: Optional. Samples that were removed by quota enforcement
+     *                     after position before they could be returned, if known
+     *
+     * Returns 0 on success
+     *         DCGM_ST_NO_DATA if there are no samples after position
+     *        <0 on error. See DCGM_ST_? #defines
+     */
+    dcgmReturn_t GetSamplesAfter(dcgm_field_entity_group_t entityGroupId,
+                                 dcgm_field_eid_t entityId,
+                                 unsigned short dcgmFieldId,
+                                 dcgmcm_sample_p samples,
+                                 int *Msamples,
+                                 timeseries_position_t *position,
+                                 long long *samplesSkipped = nullptr);
+
+    /*************************************************************************/
+    /*
+     * Point each of views at the cached samples it asks for without copying
+     * them. This is for clients of an embedded host engine, which share our
+     * address space. See dcgmEmbeddedAcquireValueViews().
+     *
+     * The cache manager stays locked until ReleaseValueViews() is called on the
+     * same thread, so that the samples don't change underneath the caller.
+     * Calls may nest. Each view's status is set even when this returns OK.
+     *
+     * Returns DCGM_ST_OK if the views were filled and must be released
+     *         DCGM_ST_BADPARAM if views is NULL
+     */
+    dcgmReturn_t AcquireValueViews(dcgmValueView_v1 *views, unsigned int numViews);
+
+    /*************************************************************************/
+    /*
+     * Release the views of the latest AcquireValueViews() on this thread
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_UNINITIALIZED if this thread holds no views
      */
-    dcgmReturn_t GetSamples(dcgm_field_entity_group_t entityGroupId,
-                            dcgm_field_eid_t entityId,
-                            unsigned short dcgmFieldId,
-                            dcgmcm_sample_p samples,
-                            int *Msamples,
-                            timelib64_t startTime,
-                            timelib64_t endTime,
-                            dcgmOrder_t order);
+    dcgmReturn_t ReleaseValueViews(void);
+
+    /*************************************************************************/
+    /*
+     * Get the samples of a numeric time series field grouped into buckets of
+     * bucketWidth usec that start at multiples of bucketWidth. History that has
+     * been rolled up is bucketed from its rollup buckets, which are assigned to
+     * the bucket their start falls in.
+     *
+     * entityGroupId IN: Which entity group to get the value for
+     * entityId      IN: The entity to get the value for
+     * dcgmFieldId   IN: Which DCGM field to get the value for
+     * startTime     IN: Optional starting timestamp. 0=From the beginning
+     * endTime       IN: Optional ending timestamp, inclusive. 0=Up until the end
+     * bucketWidth   IN: Width of each bucket in usec
+     * maxBuckets    IN: Maximum number of buckets to return. Later buckets are
+     *                   left out
+     * buckets      OUT: Buckets that have samples in ascending time order
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_NOT_SUPPORTED if the field isn't an int64 or double
+     *         Other DCGM_ST_? #defines on error, as GetSamples()
+     */
+    dcgmReturn_t GetBucketedSamples(dcgm_field_entity_group_t entityGroupId,
+                                    dcgm_field_eid_t entityId,
+                                    unsigned short dcgmFieldId,
+                                    timelib64_t startTime,
+                                    timelib64_t endTime,
+                                    timelib64_t bucketWidth,
+                                    int maxBuckets,
+                                    std::vector<timeseries_bucket_t> &buckets);
 
 
     /*************************************************************************/
@@ -1024,22 +2017,86 @@ public:
      * Get the most recent sample of multiple entities for multiple fields into
      * a fvBuffer
      *
-     * There is both a cached version and live version of this API
+     * There is both a cached version and live version of this API. The live
+     * version reads several GPUs at once. See ParallelGetLiveSamples()
+     *
+     * The cached version holds the cache manager lock for a request of more
+     * than one sample, so the samples are all as of the same update
      *
-     * entityList    IN: Entities to fetch the latest values for
-     * fieldIds      IN: Field IDs to fetch for each entity
-     * fvBuffer     OUT: Where to place samples.
+     * entityList      IN: Entities to fetch the latest values for
+     * fieldIds        IN: Field IDs to fetch for each entity
+     * fvBuffer       OUT: Where to place samples.
+     * sinceSequence   IN: Only place samples of watches updated after this update
+     *                     sequence. 0 = all of them. Cached version only
+     * updateSequence OUT: Optional. The update sequence the samples are current as of.
+     *                     Pass it as sinceSequence to get only what changed since
      *
      * Returns 0 on success
      *        <0 on error. See DCGM_ST_? #defines
      */
     dcgmReturn_t GetMultipleLatestSamples(std::vector<dcgmGroupEntityPair_t> &entities,
                                           std::vector<unsigned short> &fieldIds,
-                                          DcgmFvBuffer *fvBuffer);
+                                          DcgmFvBuffer *fvBuffer,
+                                          unsigned long long sinceSequence    = 0,
+                                          unsigned long long *updateSequence = nullptr);
     dcgmReturn_t GetMultipleLatestLiveSamples(std::vector<dcgmGroupEntityPair_t> &entities,
                                               std::vector<unsigned short> &fieldIds,
                                               DcgmFvBuffer *fvBuffer);
 
+    /*************************************************************************/
+    /*
+     * Get the latest cached value of each field for each entity into the
+     * cells of a dense table. Numeric cells are read lock-free, like
+     * GetLatestSample() does, and the others under one hold of the lock.
+     * Cells that can't be read are blank with status bits that say why.
+     *
+     * entities  IN: Entities of the rows. At most DCGM_GROUP_MAX_ENTITIES
+     * fieldIds  IN: Fields of the columns. At most DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP
+     * matrix   OUT: Everything but version is set. Only the cells in use are written
+     *
+     * Returns 0 on success
+     *        <0 on error. See DCGM_ST_? #defines
+     */
+    dcgmReturn_t GetLatestValuesMatrix(std::vector<dcgmGroupEntityPair_t> const &entities,
+                                       std::vector<unsigned short> const &fieldIds,
+                                       dcgmLatestValuesMatrix_v1 *matrix);
+
+    /*************************************************************************/
+    /*
+     * Get the samples of several entity/field pairs in the same time range into
+     * a fvBuffer, holding the cache lock once for all of them so that every
+     * query sees the same state of the cache
+     *
+     * queries             IN: Entity, field and order of each query. See GetSamples()
+     * startTime           IN: Optional starting timestamp. 0=From the beginning
+     * endTime             IN: Optional ending timestamp, inclusive. 0=Up until the end
+     * maxSamplesPerQuery  IN: Maximum number of samples to place for each query
+     * fvBuffer           OUT: Where to place samples. They are placed in the order of
+     *                         queries with the entity and field of their query. A query
+     *                         that fails places one value with the error as its status,
+     *                         so each query places exactly one value when
+     *                         maxSamplesPerQuery is 1
+     *
+     * Returns 0 on success
+     *        <0 on error. See DCGM_ST_? #defines
+     */
+    dcgmReturn_t GetMultipleSamples(std::vector<dcgmcm_sample_query_t> const &queries,
+                                    timelib64_t startTime,
+                                    timelib64_t endTime,
+                                    int maxSamplesPerQuery,
+                                    DcgmFvBuffer *fvBuffer);
+
+    /*************************************************************************/
+    /*
+     * Get the update sequence of the last sample of a watch, or 0 if it has
+     * never been updated. Every update of any watch gets the next higher update
+     * sequence, so comparing these tells what changed since a previous read.
+     * Doesn't take m_mutex
+     */
+    unsigned long long GetWatchUpdateSequence(dcgm_field_entity_group_t entityGroupId,
+                                              dcgm_field_eid_t entityId,
+                                              unsigned short fieldId);
+
     /*************************************************************************/
     /*
      * Set value for a field
@@ -1079,7 +2136,9 @@ public:
     /*****************************************************************************/
     /*
      * AppendSamples is called from DCGM modules to batch-publish metrics into
-     * the cache manager.
+     * the cache manager. The samples of each watch are appended as one run, so the
+     * watch is looked up and has its quota enforced once per call rather than once
+     * per sample.
      *
      * fvBuffer IN: Buffer of samples to publish into the cache manager. This remains
      *              owned by the caller after this call.
@@ -1110,6 +2169,26 @@ public:
                                dcgmcm_sample_p samples,
                                int Nsamples);
 
+    /*************************************************************************/
+    /*
+     * Inject a buffer of fake values, of any number of entities and fields,
+     * into the cache manager. Unlike InjectSamples() above, the cache manager
+     * lock is taken once for the whole buffer rather than once per value.
+     *
+     * Every value is checked before any is injected, so either all of
+     * fvBuffer is injected or none of it is.
+     *
+     * fvBuffer IN: Values to inject. Their types must match their fields'.
+     *              This remains owned by the caller after this call.
+     *
+     * Returns 0 on success
+     *        DCGM_ST_BADPARAM if any value is of an unknown field, of the wrong
+     *                         type, of a bad entity group or is truncated
+     *        <0 on other errors. See DCGM_ST_? #defines
+     *
+     */
+    dcgmReturn_t InjectSamples(DcgmFvBuffer *fvBuffer);
+
     /*************************************************************************/
     /*
      * Free an array of DCGM samples, freeing any memory they might have
@@ -1134,6 +2213,108 @@ public:
      */
     dcgmReturn_t ActuallyUpdateAllFields(dcgmcm_update_thread_t *threadCtx, timelib64_t *earliestNextUpdate);
 
+    /*************************************************************************/
+    /*
+     * Fetch the due watches of every GPU in gpuWatches[gpuId] in parallel, one
+     * worker per GPU, then merge the workers' buffered values and subscriber
+     * masks into threadCtx.
+     *
+     * NOTE: This function must be called with the cache manager locked. The lock
+     *       is released while the workers run and is held again on return
+     */
+    void ParallelUpdateGpuFields(dcgmcm_update_thread_t *threadCtx, std::vector<dcgmcm_watch_info_p> *gpuWatches);
+
+    /*************************************************************************/
+    /*
+     * Schedule every watch of snapshot group snapshotGroupId for its next
+     * update after now and add the ones to fetch to gpuWatches[gpuId]. Removes
+     * the group if none of its watches remain.
+     *
+     * Returns true if the group exists
+     *
+     * NOTE: This function must be called with the cache manager locked
+     */
+    bool GatherSnapshotGroup(unsigned int snapshotGroupId,
+                             timelib64_t now,
+                             std::vector<dcgmcm_watch_info_p> *gpuWatches);
+
+    /*************************************************************************/
+    /*
+     * Remove snapshot group snapshotGroupId and take its watches out of it
+     *
+     * NOTE: This function must be called with the cache manager locked
+     */
+    void RemoveSnapshotGroup(unsigned int snapshotGroupId);
+
+    /*************************************************************************/
+    /*
+     * Fetch watches, which all belong to gpuId, using threadCtx. This is the
+     * body of a per-GPU worker in ParallelUpdateGpuFields(). The cache manager
+     * is not locked by the caller
+     */
+    void UpdateGpuWatches(dcgmcm_update_thread_t *threadCtx,
+                          unsigned int gpuId,
+                          std::vector<dcgmcm_watch_info_p> const &watches);
+
+    /*************************************************************************/
+    /*
+     * Stop the per-GPU fetch workers and free their contexts
+     */
+    void FreeGpuFetchWorkers(void);
+
+    /*************************************************************************/
+    /*
+     * Live-read fieldIds of the entities of each GPU in gpuEntities, keyed by
+     * gpuId, on a worker of m_liveFetchPool per GPU, and of otherEntities on
+     * the calling thread. Returns once every read is done. Part of
+     * GetMultipleLatestLiveSamples(), whose values are in no particular order
+     * either way
+     */
+    dcgmReturn_t ParallelGetLiveSamples(std::map<unsigned int, std::vector<dcgmGroupEntityPair_t>> &gpuEntities,
+                                        std::vector<dcgmGroupEntityPair_t> &otherEntities,
+                                        std::vector<unsigned short> &fieldIds,
+                                        DcgmFvBuffer *fvBuffer);
+
+    /*************************************************************************/
+    /*
+     * Hand the due watches in m_collectorPasses[entityGroupId].watches to the
+     * entity collector of each group on its own worker. The caller must hold
+     * the lock and call FinishEntityCollectors() afterward
+     */
+    void StartEntityCollectors(void);
+
+    /*************************************************************************/
+    /*
+     * Wait on the workers started by StartEntityCollectors(), then cache the
+     * values they collected with threadCtx so they are buffered like the
+     * update thread's own values.
+     *
+     * NOTE: This function must be called with the cache manager locked. The lock
+     *       is released while waiting and is held again on return
+     */
+    void FinishEntityCollectors(dcgmcm_update_thread_t *threadCtx);
+
+    /*************************************************************************/
+    /*
+     * Stop the entity collector workers
+     */
+    void FreeEntityCollectorWorkers(void);
+
+    /*************************************************************************/
+    /*
+     * Rebuild m_gpuCpuSets if the topology changed since they were built and
+     * pin the calling update thread to the CPUs near any GPU. Does nothing
+     * unless m_placeThreadsNearGpus is set. m_mutex must be held
+     */
+    void UpdateThreadPlacement(void);
+
+    /*************************************************************************/
+    /*
+     * Pin the calling GPU fetch worker to the CPUs near gpuId, unless it is
+     * already there
+     */
+    void PlaceGpuFetchWorker(unsigned int gpuId);
+
     /*************************************************************************/
     /*
      * Populate a cache manager field info structure
@@ -1343,6 +2524,76 @@ public:
      */
     dcgmReturn_t GetGlobalFieldBytesUsed(unsigned short dcgmFieldId, long long *bytesUsed);
 
+    /*************************************************************************/
+    /*
+     * Cap the bytes of samples kept across every watch at budgetBytes. The
+     * update thread checks usage every DCGM_CM_BUDGET_CHECK_USEC. When it is
+     * over the budget, the history of the watches whose history was least
+     * recently read (see GetSamples() and the summary getters) is dropped
+     * down to their latest sample until usage is back under the budget.
+     * 0 = no budget, which is the default unless DCGM_ENV_CACHE_MEMORY_BUDGET
+     * is set.
+     */
+    void SetCacheMemoryBudget(long long budgetBytes);
+
+    /* Bytes of samples held across every watch */
+    long long GetCacheBytesUsed();
+
+    /*************************************************************************/
+    /*
+     * Set where DCGM_FI_HOSTENGINE_IPC_QUEUE_DEPTH and DCGM_FI_HOSTENGINE_CONNECTIONS
+     * come from. Those fields are blank until this is set. Call before Start()
+     */
+    void SetHostengineStatsCallback(dcgmcm_hostengine_stats_f callback);
+
+    /*************************************************************************/
+    /*
+     * Get the approximate cache memory used on behalf of each watcher, largest
+     * first, so that the watcher responsible for most of it can be found.
+     *
+     * watcherBytes OUT: One entry for each distinct watcher
+     */
+    void GetWatcherBytesUsed(std::vector<dcgmcm_watcher_bytes_t> &watcherBytes);
+
+    /*************************************************************************/
+    /*
+     * Predict the cost of watching each of fieldIds on each of entities at
+     * monitorFrequencyUsec, maxSampleAge and maxKeepSamples (see AddFieldWatch())
+     * before the watches are made, including how much it adds to the watches
+     * that already exist. See dcgmIntrospectEstimateWatchCost().
+     *
+     * Exec times come from the measured fetches of each watch. Entities the field
+     * hasn't been fetched for yet are estimated from the field's fetches on other
+     * entities, then from other fields fetched the same way. Driver calls that a
+     * batch of watches shares (see GetFetchMethod()) are made at the rate of the
+     * batch's most frequent watch and split between the proposed watches in it.
+     * Cache bytes are of uncompressed raw samples. Rollups are not counted.
+     *
+     * cost IN: version. OUT: numFields, fields and the totals
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_BADPARAM if monitorFrequencyUsec isn't positive or there are too many fieldIds
+     *          DCGM_ST_UNKNOWN_FIELD if a field ID isn't valid
+     */
+    dcgmReturn_t EstimateWatchCost(std::vector<dcgmGroupEntityPair_t> const &entities,
+                                   std::vector<unsigned short> const &fieldIds,
+                                   timelib64_t monitorFrequencyUsec,
+                                   double maxSampleAge,
+                                   int maxKeepSamples,
+                                   dcgmIntrospectWatchCost_t &cost);
+
+    /*************************************************************************/
+    /*
+     * Check usage against the budget set with SetCacheMemoryBudget() and trim
+     * history if it is over. Normally called by the update thread.
+     *
+     * force IN: Check now, even if the last check was less than
+     *           DCGM_CM_BUDGET_CHECK_USEC ago
+     *
+     * Returns the number of watches whose history was dropped
+     */
+    int EnforceCacheMemoryBudget(bool force);
+
     /*************************************************************************/
     /*
      * Get the total amount of time, in usec, that the cache manager has spent retrieving
@@ -1361,6 +2612,69 @@ public:
      */
     dcgmReturn_t GetGlobalFieldExecTimeUsec(unsigned short dcgmFieldId, long long *totalUsec);
 
+    /*************************************************************************/
+    /*
+     * Get the distribution of how long each fetch of the given field on the given
+     * GPU took, so that occasional slow driver calls stand out from the mean.
+     *
+     * maxUsec     OUT: the longest single fetch in usec
+     * histogram   OUT: DCGM_INTROSPECT_EXEC_TIME_BUCKETS fetch counts. See GetExecTimeBucket()
+     */
+    dcgmReturn_t GetGpuFieldExecTimeHistogram(unsigned int gpuId,
+                                              unsigned short dcgmFieldId,
+                                              long long *maxUsec,
+                                              long long *histogram);
+
+    /*************************************************************************/
+    /*
+     * Same as GetGpuFieldExecTimeHistogram() for a global field
+     */
+    dcgmReturn_t GetGlobalFieldExecTimeHistogram(unsigned short dcgmFieldId, long long *maxUsec, long long *histogram);
+
+    /*************************************************************************/
+    /*
+     * Get how old the samples of the given field on the given GPU were when they
+     * reached each dcgmIntrospectLagStage_t on their way to clients
+     *
+     * maxUsec     OUT: the oldest sample at each stage in usec
+     * histogram   OUT: sample counts at each stage. See GetExecTimeBucket()
+     */
+    dcgmReturn_t GetGpuFieldSampleLagHistogram(unsigned int gpuId,
+                                               unsigned short dcgmFieldId,
+                                               long long maxUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT],
+                                               long long histogram[][DCGM_INTROSPECT_EXEC_TIME_BUCKETS]);
+
+    /*************************************************************************/
+    /*
+     * Same as GetGpuFieldSampleLagHistogram() for a global field
+     */
+    dcgmReturn_t GetGlobalFieldSampleLagHistogram(unsigned short dcgmFieldId,
+                                                  long long maxUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT],
+                                                  long long histogram[][DCGM_INTROSPECT_EXEC_TIME_BUCKETS]);
+
+    /*************************************************************************/
+    /*
+     * Account how old each sample of fvBuffer is in the watch it came from, now
+     * that the samples have reached stage. The age of a sample is nowUsec minus
+     * its timestamp. Error entries and samples of fields that aren't watched
+     * are skipped.
+     *
+     * stage       IN: Where the samples are. See dcgmIntrospectLagStage_t
+     * fvBuffer    IN: Samples that just reached stage
+     * nowUsec     IN: When they reached it. 0 = now
+     */
+    void RecordSampleLag(dcgmIntrospectLagStage_t stage, DcgmFvBuffer const &fvBuffer, timelib64_t nowUsec = 0);
+
+    /*************************************************************************/
+    /*
+     * Same as the DcgmFvBuffer version for bufferSize bytes of packed
+     * dcgmBufferedFv_t, like the values of a DCGM_MSG_FV_STREAM batch
+     */
+    void RecordSampleLag(dcgmIntrospectLagStage_t stage,
+                         char const *buffer,
+                         size_t bufferSize,
+                         timelib64_t nowUsec = 0);
+
     /*************************************************************************/
     /*
      * Get the total amount of times that the cache manager has fetched a new value
@@ -1418,10 +2732,19 @@ public:
 
     /*************************************************************************/
     /*
-     * Get the affinity information from NVML for this box
+     * Get the affinity information from NVML for this box. This is computed
+     * once and then reused until InvalidateTopology()
      */
     dcgmReturn_t PopulateTopologyAffinity(dcgmAffinity_t &affinity);
 
+    /*************************************************************************/
+    /*
+     * Drop the cached topology and SelectGpusByTopology() results. Called
+     * when GPUs are attached or detached, an NvLink changes state or a GPU's
+     * MIG configuration changes
+     */
+    void InvalidateTopology(void);
+
     /*************************************************************************/
     /*
      * Get and store the affinity information from NVML for this box
@@ -1438,6 +2761,14 @@ public:
      */
     dcgmReturn_t SelectGpusByTopology(std::vector<unsigned int> &gpuIds, uint32_t numGpus, uint64_t &outputGpus);
 
+    /*************************************************************************/
+    /*
+     * SelectGpusByTopology() without reusing earlier results
+     */
+    dcgmReturn_t SelectGpusByTopologyUncached(std::vector<unsigned int> &gpuIds,
+                                              uint32_t numGpus,
+                                              uint64_t &outputGpus);
+
     /*************************************************************************/
     /*
      * Set a bit in the bitmask for each gpu in the gpuIds vector
@@ -1491,44 +2822,25 @@ public:
 
     /*************************************************************************/
     /*
-     * Choose the first grouping that has an ideal match based on NvLink topology.
-     * This is only done if we have more than one group of GPUs that is ideal based
-     * on CPU affinity.
-     */
-    void MatchByIO(std::vector<std::vector<unsigned int>> &affinityGroups,
-                   dcgmTopology_t *topPtr,
-                   std::vector<size_t> &potentialCpuMatches,
-                   uint32_t numGpus,
-                   uint64_t &outputGpus);
-
-    /*************************************************************************/
-    /*
-     * Record the number of connections this topology has between GPUs at each level, 0-3.
-     * 0 is the fastest and 3 is the slowest.
-     */
-    unsigned int SetIOConnectionLevels(std::vector<unsigned int> &affinityGroup,
-                                       dcgmTopology_t *topPtr,
-                                       std::map<unsigned int, std::vector<DcgmGpuConnectionPair>> &connectionLevel);
-
-    unsigned int RecordBestPath(std::vector<unsigned int> &bestPath,
-                                std::map<unsigned int, std::vector<DcgmGpuConnectionPair>> &connectionLevel,
-                                uint32_t numGpus,
-                                unsigned int highestLevel);
-
-    /*************************************************************************/
-    /*
-     * Translate each path bitmap into the number of NvLinks that connect the two paths.
+     * Get the NvLink counts between GPUs. This is built once and then reused
+     * until InvalidateTopology()
+     *
+     * Returns nullptr if the NvLink topology couldn't be read
      */
-    unsigned int NvLinkScore(dcgmGpuTopologyLevel_t path);
+    std::shared_ptr<DcgmTopologySelector const> GetTopologySelector();
 
     /*************************************************************************/
     /*
-     * Determines whether or not connections has numGpus total gpus that can all be linked together.
-     * If there are, outputGpus is set with the gpus from the connection.
-     *
-     * Returns true if there are numGpus in the pairs inside connections that can be linked together.
+     * Choose the numGpus GPUs with the most NvLinks between them from any one
+     * of the potential matches. This is only done if we have more than one
+     * group of GPUs that is ideal based on CPU affinity. Of equally good
+     * groups, the first one wins.
      */
-    bool HasStrongConnection(std::vector<DcgmGpuConnectionPair> &connections, uint32_t numGpus, uint64_t &outputGpus);
+    void MatchByIO(std::vector<std::vector<unsigned int>> &affinityGroups,
+                   DcgmTopologySelector const &selector,
+                   std::vector<size_t> &potentialCpuMatches,
+                   uint32_t numGpus,
+                   uint64_t &outputGpus);
 
     /*************************************************************************/
     /*
@@ -1544,13 +2856,21 @@ public:
 
     /*************************************************************************/
     /*
-     * Set topology_np to a pointer to a struct populated with the NvLink topology information
+     * Set topology_np to a pointer to a struct populated with the NvLink topology information.
+     * The caller must free() it. This is computed once and then reused until InvalidateTopology()
      *
      * Returns 0 if ok
      *         DCGM_ST_* on module error
      */
     dcgmReturn_t PopulateTopologyNvLink(dcgmTopology_t **topology_pp, unsigned int &topologySize);
 
+    /*************************************************************************/
+    /*
+     * Query NVML for what PopulateTopologyNvLink() and PopulateTopologyAffinity() cache
+     */
+    dcgmReturn_t ComputeTopologyNvLink(dcgmTopology_t **topology_pp, unsigned int &topologySize);
+    dcgmReturn_t ComputeTopologyAffinity(dcgmAffinity_t &affinity);
+
     /*************************************************************************/
     /*
      * Check if the affinity bitmasks for the gpus at index1 and index2 match each other.
@@ -1599,6 +2919,135 @@ public:
      */
     void OnConnectionRemove(dcgm_connection_id_t connectionId);
 
+    /*************************************************************************/
+    /*
+     * Get every watch that a connection's watchers have, of any watcher type
+     *
+     * connectionId  IN: Connection to get the watches of
+     * watches      OUT: One entry per watcher of each watch
+     */
+    void GetConnectionWatches(dcgm_connection_id_t connectionId, std::vector<dcgmcm_watcher_watch_t> &watches);
+
+    /*************************************************************************/
+    /*
+     * Get how far apart the samples of a watch that a watcher is served
+     * should be. A watch is sampled at the rate of its fastest watcher, so
+     * slower watchers are only served one sample per period of their own.
+     * See IsWatcherDue()
+     *
+     * Returns: The watcher's frequency if it is slower than the watch's
+     *          0 if every sample should be served, or the watcher doesn't watch it
+     */
+    timelib64_t GetWatcherDecimationUsec(dcgm_field_entity_group_t entityGroupId,
+                                         dcgm_field_eid_t entityId,
+                                         unsigned short fieldId,
+                                         DcgmWatcher watcher);
+
+    /*************************************************************************/
+    /*
+     * Is a sample at timestamp due to a watcher that wants one every
+     * decimationUsec, given that the last one it got was at lastUsec?
+     * Samples are due once per decimationUsec-aligned period, so watchers
+     * of the same period are served the same samples. 0 = every sample
+     */
+    static bool IsWatcherDue(timelib64_t decimationUsec, timelib64_t timestamp, timelib64_t lastUsec)
+    {
+        if (decimationUsec <= 0 || timestamp <= 0 || lastUsec <= 0)
+            return true;
+        return timestamp / decimationUsec != lastUsec / decimationUsec;
+    }
+
+    /*************************************************************************/
+    /*
+     * Only hand watcherType's subscribers the values of a watch that match
+     * predicate. Values are tested as they are appended to the cache, so the
+     * ones that don't match are cached but never buffered for those
+     * subscribers. Blank values only match DcgmcmPredicateAll. String and
+     * blob values always match. Replacing a predicate forgets the last value
+     * of DcgmcmPredicateChanged and Delta.
+     *
+     * predicate IN: DcgmcmPredicateAll removes watcherType's predicate
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM if watcherType or predicate.type is out of range
+     *         DCGM_ST_MEMORY if the watch couldn't be allocated
+     */
+    dcgmReturn_t SetWatchPredicate(dcgm_field_entity_group_t entityGroupId,
+                                   dcgm_field_eid_t entityId,
+                                   unsigned short fieldId,
+                                   DcgmWatcherType_t watcherType,
+                                   dcgmcm_predicate_t const &predicate);
+
+    /*************************************************************************/
+    /*
+     * Fetch the watches of keys together as a snapshot group. Whenever one of
+     * them is due, every watch of the group is fetched in the same pass, one
+     * worker per GPU, and all of their values get the timestamp of that pass.
+     * Values of different fields and GPUs can then be joined by timestamp.
+     * Only watches of GPU fields take part, and a watch is in at most one
+     * group, so adding it to another moves it. Watches of the group fetch
+     * instantaneous values even if buffered sampling is on. The group is
+     * removed with watcher's connection or once none of its watches remain.
+     *
+     * snapshotGroupId OUT: Optional ID of the new group
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_NOT_WATCHED if none of keys are watches of GPU fields
+     */
+    dcgmReturn_t AddSnapshotGroup(std::vector<dcgmcm_entity_key_t> const &keys,
+                                  DcgmWatcher const &watcher,
+                                  unsigned int *snapshotGroupId = nullptr);
+
+    /*************************************************************************/
+    /*
+     * Define derived field fieldId, one of DCGM_FI_FIRST_DERIVED_FIELD_ID to
+     * DCGM_FI_LAST_DERIVED_FIELD_ID, as expression over other fields of the
+     * same entity. See DcgmDerivedField for what expression can be. The
+     * expression is compiled once here. Its inputs are watched for as long
+     * as fieldId is, and fieldId gets a value whenever they are updated.
+     * Existing watches of fieldId switch to the new expression. An empty
+     * expression removes the definition, and fieldId gets no more values.
+     *
+     * error OUT: Why expression isn't valid
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM if fieldId isn't a derived field or expression isn't valid
+     */
+    dcgmReturn_t SetDerivedField(unsigned short fieldId, std::string const &expression, std::string &error);
+
+    /* Is fieldId one of the derived fields defined with SetDerivedField()? */
+    static bool IsDerivedFieldId(unsigned int fieldId);
+
+    /*************************************************************************/
+    /*
+     * Hand watcherType's subscribers every value whatever their predicates
+     * until this is called again with bypassed = false. For subscribers that
+     * need the timestamps of every sample for a while. Takes no locks, so it
+     * can be called from a subscriber callback
+     */
+    void SetPredicatesBypassed(DcgmWatcherType_t watcherType, bool bypassed);
+
+    /*************************************************************************/
+    /*
+     * Does value match watchPredicate? Updates its last value when the
+     * predicate needs one
+     */
+    static bool PredicateMatches(dcgmcm_watch_predicate_t &watchPredicate, dcgmcm_predicate_value_t const &value);
+
+    /*************************************************************************/
+    /*
+     * Get the UUID of each GPU, indexed by gpuId
+     */
+    void GetGpuUuids(std::vector<std::string> &uuids);
+
+    /*************************************************************************/
+    /*
+     * Hand the watchers of connectionId over to newConnectionId, so that
+     * they are removed when newConnectionId disconnects instead. Where
+     * newConnectionId already has the same watcher, that one is kept
+     */
+    void ChangeWatcherConnection(dcgm_connection_id_t connectionId, dcgm_connection_id_t newConnectionId);
+
     /*************************************************************************/
     /*
      * Main loop thread for the event reading thread this is public so it can
@@ -1613,15 +3062,26 @@ public:
      * Find all GPUs in the system and set their state appropriately in this
      * object.
      *
-     * RETURNS: DCGM_ST_OK on success
-     *          DCGM_ST_GENERIC_ERROR on NVML error
+     * RETURNS: DCGM_ST_OK on success
+     *          DCGM_ST_GENERIC_ERROR on NVML error
+     */
+    dcgmReturn_t AttachGpus(void);
+
+    /*************************************************************************/
+    /*
+     * Read the NVML handle and static attributes (UUID, brand, PCI info, arch and
+     * virtualization mode) of the GPU at gpuInfo.nvmlIndex into gpuInfo. Sets the
+     * status to DcgmEntityStatusInaccessible if the GPU can't be opened.
+     *
+     * Only touches gpuInfo, so AttachGpus() calls this for several GPUs at once
      */
-    dcgmReturn_t AttachGpus(void);
+    void AttachGpuDevice(dcgmcm_gpu_info_t &gpuInfo);
 
     /*************************************************************************/
     /*
      * Find all GPU instances and compute instacnes in the system and set their state appropriately in this
-     * object.
+     * object. Instances that gpuInfo already knows about keep their entity IDs, so watches on them survive
+     * a MIG reconfiguration. Only added instances get new IDs.
      *
      * RETURNS: DCGM_ST_OK on success
      *          DCGM_ST_GENERIC_ERROR on NVML error
@@ -1636,6 +3096,12 @@ public:
      */
     void ClearGpuMigInfo(dcgmcm_gpu_info_t &gpuInfo);
 
+    /*************************************************************************/
+    /*
+     * Find the GPU instance with entity ID instanceId on gpuId. Returns nullptr if there isn't one
+     */
+    DcgmGpuInstance *FindGpuInstance(unsigned int gpuId, DcgmNs::Mig::GpuInstanceId const &instanceId);
+
     /*************************************************************************/
     /*
      * Adds the newly detected GPU list to our internal list by matching UUIDs
@@ -1740,6 +3206,26 @@ public:
                                          unsigned int entityId,
                                          std::stringstream &valbuf);
 
+    /*************************************************************************/
+    /*
+     * Clear a thread context variable so it's ready for next use.
+     *
+     * This should do as few memsets as possible as this is in the critical path
+     * for live field-value processing.
+     * (public for unit tests)
+     */
+    void ClearThreadCtx(dcgmcm_update_thread_t *threadCtx);
+
+    /*************************************************************************/
+    /*
+     * Set aside a mapped field of gpuId to be fetched by ActuallyUpdateGpuFieldValues()
+     * (public for unit tests)
+     */
+    static void AddGpuFieldValue(dcgmcm_update_thread_t *threadCtx,
+                                 unsigned int gpuId,
+                                 dcgm_field_meta_p fieldMeta,
+                                 dcgmcm_watch_info_p watchInfo);
+
     /*************************************************************************/
 
     /**
@@ -1787,6 +3273,88 @@ private:
 
     timelib64_t m_maxSampleAgeUsec; /* Maximum time to keep a sample of ANY field, defaults to 1 hour */
 
+    bool m_compressHistory; /* Should long-lived numeric watches compress their history?
+                               See SetHistoryCompression() */
+
+    bool m_parallelGpuFetch; /* Should GPU watches be fetched by per-GPU workers?
+                                See SetParallelGpuFetch() */
+
+    bool m_placeThreadsNearGpus; /* Should the update thread and GPU fetch workers be pinned near their GPUs?
+                                    See SetThreadPlacement() */
+
+    bool m_bufferedSampling; /* Should power and utilization be read from the driver's sample buffers?
+                                See SetBufferedSampling() */
+
+    timelib64_t m_watchCoalesceUsec;  /* How far watch deadlines may move to share a tick.
+                                         0 = off. See SetWatchCoalescing() */
+    timelib64_t m_watchTickUsec;      /* GCD of the monitor frequencies of the watches. Only ever
+                                         shrinks between rebuilds in CompactWatchSchedule() */
+    timelib64_t m_eventFieldPollUsec; /* How often event-backed watches are polled. 0 = event-backed
+                                         fields are off. See SetEventFieldPolling() */
+    timelib64_t m_adaptiveBaseUsec;   /* Interval of quiet watches. 0 = adaptive sampling is off.
+                                         See SetAdaptiveSampling() */
+    double m_adaptiveThreshold;       /* Relative deviation below which a watch is quiet */
+    timelib64_t m_adaptiveBurstUntilUsec[DCGM_MAX_NUM_DEVICES]; /* Every watch of the GPU is at its burst
+                                                                   rate until then. See UpdateAdaptiveSampling() */
+
+    long long m_cacheBudgetBytes;           /* Cap on bytes of samples across all watches. 0 = none.
+                                               See SetCacheMemoryBudget() */
+    timelib64_t m_cacheBudgetLastCheckUsec; /* When EnforceCacheMemoryBudget() last checked usage */
+    timelib64_t m_cacheBudgetLastWarnUsec;  /* When EnforceCacheMemoryBudget() last warned about it */
+
+    timelib64_t m_rollupRawRetentionUsec;                   /* Raw samples to keep for rolled-up watches */
+    std::vector<dcgmcm_rollup_tier_config_t> m_rollupTiers; /* Empty = no rollups. See SetRollupTiers() */
+
+    std::unique_ptr<DcgmCacheSpill> m_spill; /* Where aged samples go. nullptr = they are dropped. See SetSpill() */
+
+    bool m_cacheArenas;           /* Should new watches be allocated from arenas? See SetCacheArenas() */
+    bool m_cacheArenasUseHugetlb; /* Should new arenas map their chunks from the hugetlbfs pool? */
+    /* Arena of each GPU's watches, created on the first watch. Never freed before the watches in them.
+       Protected by m_mutex */
+    std::unique_ptr<DcgmCacheArena> m_gpuArenas[DCGM_MAX_NUM_DEVICES];
+    std::unique_ptr<DcgmCacheArena> m_sharedArena; /* Arena of the watches of non-GPU entities */
+
+    std::map<unsigned int, dcgmcm_summary_window_t> m_summaryWindows; /* See AddSummaryWindow() */
+    unsigned int m_nextSummaryWindowId;                               /* ID of the next summary window */
+
+    std::map<unsigned int, dcgmcm_snapshot_group_t> m_snapshotGroups; /* See AddSnapshotGroup(). Protected by
+                                                                         m_mutex */
+    unsigned int m_nextSnapshotGroupId;                               /* ID of the next snapshot group */
+
+    /* Definition of each derived field by fieldId - DCGM_FI_FIRST_DERIVED_FIELD_ID. nullptr = not defined yet.
+       See SetDerivedField(). Protected by m_mutex */
+    std::shared_ptr<DcgmDerivedField const> m_derivedFields[DCGM_FI_MAX_DERIVED_FIELDS];
+
+    std::string m_snapshotFilename; /* Snapshot to load in Init() and save in Shutdown(). Empty = none.
+                                       See SaveSnapshot() */
+
+    /* Per-GPU fetch workers and their update contexts, indexed by gpuId. These are only
+       touched by the cache manager update thread and are created on first use */
+    std::unique_ptr<DcgmNs::ThreadPool> m_gpuFetchPool;
+    std::vector<dcgmcm_update_thread_t *> m_gpuFetchCtx;
+
+    /* Workers of live reads of several GPUs. Shared by every thread that asks for live values, so it is
+       replaced rather than grown. Created on first use. See ParallelGetLiveSamples() */
+    std::shared_ptr<DcgmNs::ThreadPool> m_liveFetchPool;
+    std::mutex m_liveFetchPoolMutex; /* Protects m_liveFetchPool */
+
+    /* Entity collectors by entity group. Protected by m_mutex. See SetEntityCollector() */
+    std::shared_ptr<DcgmEntityCollector> m_entityCollectors[DCGM_FE_COUNT];
+
+    /* The collectors' work of the current update cycle. Only touched by the update thread. The pool
+       is created on first use */
+    std::unique_ptr<DcgmNs::ThreadPool> m_collectorPool;
+    dcgmcm_collector_pass_t m_collectorPasses[DCGM_FE_COUNT];
+
+    class VgpuCollector; /* Built-in collector of DCGM_FE_VGPU */
+
+    /* Where threads are pinned when m_placeThreadsNearGpus is set. The CPU sets are only
+       touched by the update thread, and by fetch workers while it waits on them */
+    cpu_set_t m_allowedCpus;                   /* CPUs the process allowed at construction */
+    std::vector<cpu_set_t> m_gpuCpuSets;       /* CPUs near each gpuId within m_allowedCpus. Empty = don't pin */
+    bool m_haveGpuCpuSets;                     /* Are m_gpuCpuSets built and threads being placed? */
+    unsigned long long m_gpuCpuSetsGeneration; /* m_topologyGeneration that m_gpuCpuSets were built at */
+
     /* The following are set by ReadAndCacheDriverVersions() */
     std::string m_driverVersion; /* Version string of the attached driver like "4184003" (418.40.03)
                                     so the strings can be compared. Set by AttachGpus() and protect by m_mutex. */
@@ -1814,14 +3382,60 @@ private:
                                          update loop has completed */
 
     /* Track per-entity watches of fields. Use GetEntityWatchInfo() method to get a
-       pointer to an element of this.
-       Is a hash of dcgmcm_entity_key_t -> entity_watch_table_t */
-    hashtable_t *m_entityWatchHashTable;
-
-    /* Cache of which PIDs we have already saved to the cache with which start times
-     * This saves us having to scan the entire accounting data structure to find
-     * which PIDs we have already saved */
-    keyedvector_p m_accountingPidsSeen;
+       pointer to an element of this. Owns its watch infos. See FreeAllWatchInfos() */
+    DcgmNs::DenseWatchIndex<dcgmcm_watch_info_t> m_entityWatches;
+
+    /* Buffers for the fvBuffer of update contexts, so that buffering live updates for
+       subscribers doesn't allocate on every cycle or injection. Shared so that snapshots
+       still held by subscribers can be returned to it after we're gone */
+    std::shared_ptr<DcgmFvBufferPool> m_fvBufferPool;
+
+    /* Lock-free index of every watch info in m_entityWatches, used by
+       latest-value readers. m_watchIndexes owns the current table and every one
+       it has replaced. Only modified while holding m_mutex */
+    std::atomic<dcgmcm_watch_index_t *> m_watchIndex;
+    std::vector<std::unique_ptr<dcgmcm_watch_index_t>> m_watchIndexes;
+    /* Threads between LookupWatchIndex() and their last use of the watch info it found.
+       FreeAllWatchInfos() waits for this to reach 0 before freeing anything they could see */
+    std::atomic<unsigned int> m_lockFreeReaders { 0 };
+
+    /* Update sequence of the newest watch update. Only written while holding m_mutex,
+       after the watch's latestValue.updateSequence. See PublishLatestValue() */
+    std::atomic<unsigned long long> m_updateSequence { 0 };
+    std::atomic<unsigned int> m_predicateBypassMask { 0 }; /* Bit N = watcher type N ignores its predicates.
+                                                              See SetPredicatesBypassed() */
+
+    /* Deadlines of the watches used by ActuallyUpdateAllFields() so that each
+       wakeup only touches watches that are due. Protected by m_mutex */
+    DcgmNs::WatchSchedule<dcgmcm_watch_info_t> m_watchSchedule;
+
+    /* Topology, which only changes when InvalidateTopology() is called. Protected by m_mutex */
+    unsigned long long m_topologyGeneration; /* Incremented by InvalidateTopology() */
+    std::vector<char> m_nvLinkTopology;      /* dcgmTopology_t from ComputeTopologyNvLink(). Empty = not cached */
+    bool m_haveCpuAffinity;                  /* Is m_cpuAffinity cached? */
+    dcgmAffinity_t m_cpuAffinity;            /* From ComputeTopologyAffinity() */
+    std::map<std::pair<uint64_t, uint32_t>, std::pair<dcgmReturn_t, uint64_t>>
+        m_topologySelections; /* SelectGpusByTopology() results keyed by (candidate GPU bitmask, numGpus) */
+    std::shared_ptr<DcgmTopologySelector const>
+        m_topologySelector; /* From GetTopologySelector(). nullptr = not cached */
+    bool m_haveMigHierarchy;                 /* Is m_migHierarchy cached? Also cleared when instances are added */
+    dcgmMigHierarchy_v1 m_migHierarchy;      /* From PopulateMigHierarchy() */
+
+    /* Latest accounting record saved to the cache for each PID per GPU, keyed by
+     * gpuId << 32 | pid. This saves us having to scan the entire accounting data
+     * structure to find which records we have already saved or to look one up.
+     * Protected by m_mutex */
+    std::unordered_map<unsigned long long, dcgmcm_accounting_entry_t> m_latestAccountingStats;
+
+    /* Each process seen by an accounting record or a process utilization sample, by PID, and the
+       number of process utilization samples of each GPU for DCGM_FI_DEV_GPU_UTIL_SAMPLES (0) and
+       DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES (1). See IndexPidSample(). Protected by m_mutex */
+    std::unordered_map<unsigned int, std::vector<dcgmcm_pid_gpu_stats_t>> m_pidStats;
+    unsigned long long m_processUtilSampleCounts[DCGM_MAX_NUM_DEVICES][2] {};
+
+    /* Lifetimes of the processes of each GPU from DCGM_FI_DEV_ACCOUNTING_DATA (0), DCGM_FI_DEV_COMPUTE_PIDS (1)
+       and DCGM_FI_DEV_GRAPHICS_PIDS (2). See ProcessIntervalsIndex(). Protected by m_mutex */
+    DcgmProcessIntervals m_processIntervals[DCGM_MAX_NUM_DEVICES][3];
 
     /* NVML events */
 
@@ -1837,6 +3451,8 @@ private:
     /* Runtime stats of the cache manager */
     dcgmcm_runtime_stats_t m_runStats;
 
+    dcgmcm_hostengine_stats_f m_hostengineStatsCallback; /* See SetHostengineStatsCallback() */
+
     DcgmCacheManagerEventThread *m_eventThread; /* Thread for reading NVML events */
 
     bool m_haveAnyLiveSubscribers; /* Has any watch registered to receive live updates? */
@@ -1852,11 +3468,25 @@ private:
 
     /*************************************************************************/
     /*
-     * Look at watchInfo's watchers and see if any have live subscriptions
+     * Buffer a value that was just fetched for watchInfo. addFn(DcgmFvBuffer &)
+     * adds the value to the buffer it's given.
+     *
+     * The value is added to threadCtx->fvBuffer if there is one. If
+     * threadCtx->bufferForSubscribers is set, it's also added to the subscriber
+     * buffer of each watcher type with a live subscription to watchInfo, so that
+     * subscribers only get the entity/field pairs they watch. Subscribers
+     * slower than the watch only get the samples they are due. See
+     * IsWatcherDue(). Watcher types with a predicate on the watch only get
+     * the values that match it. See SetWatchPredicate()
      *
-     * If any do, mark them in watchInfo->bufferedWatchers
+     * value IN: The numeric value being appended. nullptr = a string or blob
      */
-    void MarkSubscribersInThreadCtx(dcgmcm_update_thread_t *threadCtx, dcgmcm_watch_info_p watchInfo);
+    template <typename AddFn>
+    void BufferValue(dcgmcm_update_thread_t *threadCtx,
+                     dcgmcm_watch_info_p watchInfo,
+                     timelib64_t timestamp,
+                     dcgmcm_predicate_value_t const *value,
+                     AddFn addFn);
 
     /*************************************************************************/
     /*
@@ -1875,6 +3505,27 @@ private:
      */
     timelib64_t GetMaxAgeUsec(timelib64_t monitorFrequencyUsec, double maxAgeSeconds, int maxKeepSamples);
 
+    /*************************************************************************/
+    /*
+     * Get how the update loop fetches fieldMeta for entityId of entityGroupId,
+     * as a DCGM_INTROSPECT_FETCH_*. Pass the practical entity of existing watches.
+     *
+     * batchKey OUT: Identifies the batch of watches that share driver calls with
+     *               this one. 0 for DCGM_INTROSPECT_FETCH_SINGLE
+     */
+    unsigned short GetFetchMethod(dcgm_field_meta_p fieldMeta,
+                                  dcgm_field_entity_group_t entityGroupId,
+                                  dcgm_field_eid_t entityId,
+                                  unsigned long long &batchKey);
+
+    /*************************************************************************/
+    /*
+     * Get how many raw samples a watch at monitorFrequencyUsec keeps once its
+     * history is full. maxAgeUsec is as in dcgmcm_watch_info_t. Raw history of
+     * numeric fields is cut short by rollups like GetWatchInfoRingCapacity() does
+     */
+    long long GetKeptSampleCount(timelib64_t monitorFrequencyUsec, timelib64_t maxAgeUsec, bool isNumeric);
+
     /*************************************************************************/
     /*
      * Do some common pre-checks of a watchInfo before samples are processed for it
@@ -1901,6 +3552,47 @@ private:
                                        timelib64_t timestamp,
                                        timelib64_t oldestKeepTimestamp);
 
+    /*************************************************************************/
+    /*
+     * Copy the last sample of watchInfo->timeSeries into watchInfo->latestValue
+     * for lock-free readers. Non-numeric or empty time series publish
+     * TS_TYPE_UNKNOWN so that readers fall back to the locked path.
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void PublishLatestValue(dcgmcm_watch_info_p watchInfo);
+
+    /*************************************************************************/
+    /*
+     * Try to get the latest sample of a watch without taking m_mutex
+     *
+     * Returns true if the sample was written to sample or fvBuffer
+     *         false if the caller should use the locked path instead
+     */
+    bool GetLatestSampleLockFree(dcgm_field_entity_group_t entityGroupId,
+                                 dcgm_field_eid_t entityId,
+                                 unsigned short fieldId,
+                                 dcgmcm_sample_p sample,
+                                 DcgmFvBuffer *fvBuffer);
+
+    /*************************************************************************/
+    /*
+     * Add a new watch info to m_watchIndex, growing the index if needed
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void AddToWatchIndex(dcgmcm_watch_info_p watchInfo);
+
+    /*************************************************************************/
+    /*
+     * Find a watch info in m_watchIndex. Safe to call without m_mutex as long as
+     * the caller counts itself in m_lockFreeReaders until it's done with the result
+     *
+     * Returns: Pointer to the watch info if found
+     *          nullptr if not found
+     */
+    dcgmcm_watch_info_p LookupWatchIndex(dcgmcm_entity_key_t const &watchKey);
+
     /*************************************************************************/
     /*
      * Helper functions for adding or removing watch info classes
@@ -1908,6 +3600,24 @@ private:
     dcgmcm_watch_info_p AllocWatchInfo(dcgmcm_entity_key_t entityKey);
     void FreeWatchInfo(dcgmcm_watch_info_p watchInfo);
 
+    /*************************************************************************/
+    /*
+     * Get the arena to allocate a new watch of entityKey from, creating it
+     * if needed. nullptr = the heap since arenas are off
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    DcgmCacheArena *GetWatchArena(dcgmcm_entity_key_t const &entityKey);
+
+    /*************************************************************************/
+    /*
+     * Free every watch info and empty m_entityWatches and the indexes and
+     * schedule that point into it
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void FreeAllWatchInfos(void);
+
     /*************************************************************************/
     /*
      * Allocate the timeSeries part of a watchInfo
@@ -1917,6 +3627,139 @@ private:
      */
     dcgmReturn_t AllocWatchInfoTimeSeries(dcgmcm_watch_info_p watchInfo, int tsType);
 
+    /*************************************************************************/
+    /*
+     * Estimate how many samples a numeric watch will keep based on its
+     * monitorFrequencyUsec and maxAgeUsec. This is used to size its ring buffer
+     * and is clamped to DCGM_CM_RING_MIN_CAPACITY..DCGM_CM_RING_MAX_INITIAL_CAPACITY
+     */
+    int GetWatchInfoRingCapacity(dcgmcm_watch_info_p watchInfo);
+
+    /*************************************************************************/
+    /*
+     * Should this numeric watch be rolled up? See SetRollupTiers()
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    bool WatchInfoUsesRollups(dcgmcm_watch_info_p watchInfo);
+
+    /*************************************************************************/
+    /*
+     * How long a numeric watch keeps raw samples before only its rollup has
+     * them. 0 = as long as its max age. See UpdateWatchFromWatchers()
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    timelib64_t GetWatchRawRetentionUsec(dcgmcm_watch_info_p watchInfo);
+
+    /*************************************************************************/
+    /*
+     * Get the rollup tiers of a watch: those of its slower watchers and, if
+     * the watch keeps longer than m_rollupRawRetentionUsec, m_rollupTiers
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    std::vector<dcgmcm_rollup_tier_config_t> GetWatchRollupTiers(dcgmcm_watch_info_p watchInfo);
+
+    /*************************************************************************/
+    /*
+     * Add a non-blank sample to the rollup of a watch, creating or dropping
+     * the rollup if the watch started or stopped qualifying for one
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void AppendToRollup(dcgmcm_watch_info_p watchInfo, timelib64_t timestamp, double value);
+
+    /*************************************************************************/
+    /*
+     * Write rolled-up samples of the window [startTime, endTime] that are
+     * older than beforeUsec to samples. 0 means no limit for startTime and
+     * endTime. Each sample is the average of a bucket of the tier chosen by
+     * DcgmCacheRollup::FindTier().
+     *
+     * Returns the number of samples written, at most maxSamples
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    int GetRollupSamples(dcgmcm_watch_info_p watchInfo,
+                         timelib64_t startTime,
+                         timelib64_t endTime,
+                         timelib64_t beforeUsec,
+                         dcgmOrder_t order,
+                         dcgmcm_sample_p samples,
+                         int maxSamples);
+
+    /*************************************************************************/
+    /*
+     * Hand the samples of a numeric watch that are older than
+     * oldestKeepTimestamp to m_spill before they are dropped. Does nothing
+     * without a spill.
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void SpillAgedSamples(dcgmcm_watch_info_p watchInfo, timelib64_t oldestKeepTimestamp);
+
+    /*************************************************************************/
+    /*
+     * Write spilled samples of the window [startTime, endTime] that are older
+     * than beforeUsec to samples. Like GetRollupSamples()
+     *
+     * Returns the number of samples written, at most maxSamples
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    int GetSpillSamples(dcgmcm_watch_info_p watchInfo,
+                        timelib64_t startTime,
+                        timelib64_t endTime,
+                        timelib64_t beforeUsec,
+                        dcgmOrder_t order,
+                        dcgmcm_sample_p samples,
+                        int maxSamples);
+
+    /*************************************************************************/
+    /*
+     * Implementation of GetInt64SummaryData() and GetFp64SummaryData().
+     * T is long long or double
+     */
+    template <typename T>
+    dcgmReturn_t GetSummaryData(dcgm_field_entity_group_t entityGroupId,
+                                dcgm_field_eid_t entityId,
+                                unsigned short dcgmFieldId,
+                                int numSummaryTypes,
+                                DcgmcmSummaryType_t *summaryTypes,
+                                T *summaryValues,
+                                timelib64_t startTime,
+                                timelib64_t endTime,
+                                pfUseEntryForSummary pfUseEntryCB,
+                                void *userData);
+
+    /*************************************************************************/
+    /*
+     * Get the running summary of a registered window that a summary request
+     * for [startTime, endTime] of watchInfo matches. See AddSummaryWindow()
+     *
+     * Returns a pointer to the summary or nullptr if no window matches
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    template <typename T>
+    DcgmcmSummaryAccumulator<T> const *GetWindowSummary(dcgmcm_watch_info_p watchInfo,
+                                                        timelib64_t startTime,
+                                                        timelib64_t endTime);
+
+    /*************************************************************************/
+    /*
+     * Add a sample that was just appended to watchInfo to the running
+     * summaries of the windows it falls in. The sample is passed as both
+     * types. Only the one matching the watch's tsType is used
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void UpdateWindowSummaries(dcgmcm_watch_info_p watchInfo,
+                               timelib64_t timestamp,
+                               long long i64Value,
+                               double fp64Value);
+
     /*************************************************************************/
     /*
      * Add a watcher on a field or update the existing watcher if newWatcher is
@@ -1947,14 +3790,107 @@ private:
 
     /*************************************************************************/
     /*
-     * Update the update update frequency and quota based on the minimum values
-     * from all of our watchers
+     * Update the frequency and quota of a watch from all of its watchers. The
+     * watch is sampled at the fastest frequency of any watcher and kept for
+     * the longest age of any watcher. Raw samples are only kept as long as
+     * the fastest watchers want them. Slower watchers that keep longer get a
+     * rollup tier of their own frequency and age instead, so one fast watcher
+     * doesn't make every other watcher's history raw.
      *
      * NOTE: This function assumes the cache manager is already locked so that
      *       watchInfo is safe to modify
      */
     dcgmReturn_t UpdateWatchFromWatchers(dcgmcm_watch_info_p watchInfo);
 
+    /*************************************************************************/
+    /*
+     * (Re)schedule watchInfo to be updated by the polling loop at dueUsec.
+     * Any previous schedule entry for watchInfo becomes stale. Module-pushed
+     * fields are left to the module's DcgmWatchTable.
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void ScheduleWatchUpdate(dcgmcm_watch_info_p watchInfo, timelib64_t dueUsec);
+
+    /*************************************************************************/
+    /*
+     * How far watchInfo's deadline may be moved to share a tick with other
+     * watches. See SetWatchCoalescing()
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    timelib64_t GetWatchCoalesceUsec(dcgmcm_watch_info_p watchInfo) const;
+
+    /*************************************************************************/
+    /*
+     * How often watchInfo should be polled. This is its monitor frequency
+     * unless it's event-backed. See SetEventFieldPolling()
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    timelib64_t GetPollIntervalUsec(dcgmcm_watch_info_p watchInfo) const;
+
+    /*************************************************************************/
+    /*
+     * Is watchInfo polled at the base rate of adaptive sampling rather than
+     * its monitor frequency? See SetAdaptiveSampling()
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    bool IsWatchDecimated(dcgmcm_watch_info_p watchInfo) const;
+
+    /*************************************************************************/
+    /*
+     * Track how much watchInfo's samples move, given its latest sample, and
+     * pull it or its whole GPU back to the burst rate when they start to.
+     * See SetAdaptiveSampling()
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void UpdateAdaptiveSampling(dcgmcm_watch_info_p watchInfo, double value);
+
+    /*************************************************************************/
+    /*
+     * Reschedule a watch that was decimated to its monitor frequency
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void ScheduleWatchBurst(dcgmcm_watch_info_p watchInfo);
+
+    /*************************************************************************/
+    /*
+     * Mark the watches on gpuId that an NVML event of eventType says have
+     * changed and start an update cycle to fetch them. See SetEventFieldPolling()
+     */
+    void RefreshEventBackedWatches(unsigned int gpuId, unsigned long long eventType);
+
+    /*************************************************************************/
+    /*
+     * Account a fetch of watchInfo that took execTimeUsec in its totals and
+     * latency histogram
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void RecordWatchExecTime(dcgmcm_watch_info_p watchInfo, timelib64_t execTimeUsec);
+
+    /*************************************************************************/
+    /*
+     * Account a sample of watchInfo that was ageUsec old when it reached stage
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void RecordWatchSampleLag(dcgmcm_watch_info_p watchInfo, dcgmIntrospectLagStage_t stage, timelib64_t ageUsec);
+
+    /*************************************************************************/
+    /*
+     * Rebuild m_watchSchedule from m_entityWatches, dropping stale
+     * entries, and recompute m_watchTickUsec. Called when stale entries
+     * outnumber the live ones.
+     *
+     * NOTE: This function assumes the cache manager is already locked
+     */
+    void CompactWatchSchedule(void);
+
     /*************************************************************************/
     /*
      * Tell the cache manager to update its NvLink link state for a given gpuId
@@ -2022,39 +3958,53 @@ private:
 
     /*************************************************************************/
     /*
-     * Clear a thread context variable so it's ready for next use.
+     * Free the contents of a thread context variable. This does not free threadCtx
+     * itself in case it's part of another structure or on the stack
      *
-     * This should do as few memsets as possible as this is in the critical path
-     * for live field-value processing.
      */
-    void ClearThreadCtx(dcgmcm_update_thread_t *threadCtx);
+    void FreeThreadCtx(dcgmcm_update_thread_t *threadCtx);
 
     /*************************************************************************/
     /*
-     * Free the contents of a thread context variable. This does not free threadCtx
-     * itself in case it's part of another structure or on the stack
+     * Remember stats as the latest accounting record of its process after it
+     * was inserted into watchInfo's time series at timestamp
      *
+     * NOTE: This function assumes the cache manager is already locked
      */
-    void FreeThreadCtx(dcgmcm_update_thread_t *threadCtx);
+    void IndexAccountingStats(dcgmcm_watch_info_p watchInfo,
+                              dcgmDevicePidAccountingStats_t const *stats,
+                              timelib64_t timestamp);
 
     /*************************************************************************/
     /*
-     * Check to see if an accounting PID has already been cached at a given timestamp
+     * Fold a sample naming pid on gpuId into m_pidStats. fieldId is
+     * DCGM_FI_DEV_ACCOUNTING_DATA, DCGM_FI_DEV_GPU_UTIL_SAMPLES or
+     * DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES. util is only used for the latter two
      *
-     * RETURNS: 1 if PID has been cached
-     *          0 if not
+     * NOTE: This function assumes the cache manager is already locked
      */
-    int HasAccountingPidBeenSeen(unsigned int pid, timelib64_t timestamp);
+    void IndexPidSample(unsigned int gpuId,
+                        unsigned short fieldId,
+                        unsigned int pid,
+                        timelib64_t timestamp,
+                        double util);
+
+    /* Index into m_processIntervals[gpuId] of fieldId's processes. -1 = fieldId has none */
+    static int ProcessIntervalsIndex(unsigned short fieldId);
 
     /*************************************************************************/
     /*
-     * Mark a PID as having been cached
+     * Find the latest accounting record of pid on gpuId in watchInfo's time
+     * series without walking it
      *
-     * RETURNS: 0 if OK
-     *         <0 on error. See DCGM_ST_? enumerations for details.
+     * RETURNS: The record in the time series
+     *          nullptr if pid has no record or it has aged out of the time series
      *
+     * NOTE: This function assumes the cache manager is already locked
      */
-    dcgmReturn_t CacheAccountingPid(unsigned int pid, timelib64_t timestamp);
+    dcgmDevicePidAccountingStats_t const *FindCachedAccountingStats(unsigned int gpuId,
+                                                                    unsigned int pid,
+                                                                    dcgmcm_watch_info_p watchInfo);
 
     /*************************************************************************/
     /*
@@ -2075,6 +4025,62 @@ private:
      */
     dcgmReturn_t BufferOrCacheLatestGpuValue(dcgmcm_update_thread_t *threadCtx, dcgm_field_meta_p fieldMeta);
 
+    /*************************************************************************/
+    /*
+     * Read the current value of a DCGM_FI_HOSTENGINE_* field
+     *
+     * Returns false if the value isn't available, which is the case for the
+     * fields that come from SetHostengineStatsCallback() before it is set
+     */
+    bool ReadHostengineStat(unsigned short fieldId, long long &value);
+
+    /*************************************************************************/
+    /*
+     * Call the NVML getter for getter on gpuId unless a previous field already
+     * called it since threadCtx was last cleared. Either way, the getter's
+     * output is left in threadCtx->batchedValues[gpuId]. Reused results are
+     * counted in threadCtx->driverCallsSaved
+     *
+     * Returns: The nvmlReturn_t of the getter
+     */
+    nvmlReturn_t GetBatchedGpuValues(dcgmcm_update_thread_t *threadCtx,
+                                     unsigned int gpuId,
+                                     nvmlDevice_t nvmlDevice,
+                                     dcgmcm_batched_getter_t getter);
+
+    /*************************************************************************/
+    /*
+     * Read threadCtx->watchInfo's field with fetcher and append its value, or a
+     * blank value of the NVML error if it couldn't be read. The driver's
+     * buffered samples are appended instead if it has any. Called by
+     * BufferOrCacheLatestGpuValue() for every field that has a fetcher
+     *
+     * Returns: DCGM_ST_OK on success
+     *          The DCGM equivalent of the NVML error otherwise
+     */
+    dcgmReturn_t FetchGpuFieldValue(dcgmcm_update_thread_t *threadCtx,
+                                    dcgmcm_gpu_field_fetcher_t const &fetcher,
+                                    unsigned int gpuId,
+                                    nvmlDevice_t nvmlDevice,
+                                    timelib64_t now,
+                                    timelib64_t expireTime);
+
+    /*************************************************************************/
+    /*
+     * Append the samples of samplingType that the driver buffered since
+     * threadCtx->watchInfo was last updated this way. Values are divided by
+     * divisor. See SetBufferedSampling()
+     *
+     * Returns true if the driver's buffer was read, even if it had nothing new
+     *         false if the caller should read the value instantaneously instead
+     */
+    bool AppendBufferedSamples(dcgmcm_update_thread_t *threadCtx,
+                               nvmlDevice_t nvmlDevice,
+                               nvmlSamplingType_t samplingType,
+                               double divisor,
+                               timelib64_t now,
+                               timelib64_t expireTime);
+
     /*************************************************************************/
     /*
      * Cache or buffer the latest value for a watched vGPU field
@@ -2086,6 +4092,14 @@ private:
                                               nvmlVgpuInstance_t vgpuId,
                                               dcgm_field_meta_p fieldMeta);
 
+    /*************************************************************************/
+    /*
+     * Find the vgpuList node of vgpuId and the GPU it runs on. Caller holds m_mutex
+     *
+     * Returns: The node, or nullptr if vgpuId isn't in any GPU's vgpuList
+     */
+    dcgmcm_vgpu_info_p FindVgpuInfo(nvmlVgpuInstance_t vgpuId, unsigned int &gpuId);
+
     /*************************************************************************/
     /*
      * Helper method to add entity field watches
@@ -2167,6 +4181,65 @@ private:
      */
     bool IsModulePushedFieldId(unsigned int fieldId);
 
+    /*************************************************************************/
+    /*
+     * Get the counter field that a rate field like DCGM_FI_DEV_PCIE_REPLAY_RATE
+     * is derived from. Returns 0 if fieldId isn't a rate field. Rate fields are
+     * never fetched by the update loop. AppendCounterRate() fills them in
+     */
+    static unsigned short GetRateCounterFieldId(unsigned int fieldId);
+
+    /*************************************************************************/
+    /*
+     * Watch the counter of rate watch rateInfo with a cache manager watcher at
+     * rateInfo's frequency and max age, or remove that watcher once rateInfo
+     * has no watchers left. Called by UpdateWatchFromWatchers() with m_mutex
+     * held
+     */
+    void UpdateRateCounterWatch(dcgmcm_watch_info_p rateInfo);
+
+    /*************************************************************************/
+    /*
+     * Append the rate of counterInfo's counter since its previous sample to
+     * the rate watch of counterInfo. Called by AppendEntityInt64() with
+     * m_mutex held, after counter has been cached.
+     *
+     * threadCtx is pointed at the rate watch for the append and restored
+     * afterward so the rate reaches the same fvBuffer and subscribers
+     */
+    void AppendCounterRate(dcgmcm_update_thread_t *threadCtx,
+                           dcgmcm_watch_info_p counterInfo,
+                           long long counter,
+                           timelib64_t timestamp);
+
+    /*************************************************************************/
+    /*
+     * Watch the inputs of derived watch derivedInfo with a cache manager
+     * watcher at derivedInfo's frequency and max age, and link them to it.
+     * Inputs that derivedInfo no longer uses are unlinked, and all of them
+     * are once derivedInfo has no watchers left. Called by
+     * UpdateWatchFromWatchers() and SetDerivedField() with m_mutex held
+     */
+    void UpdateDerivedFieldWatch(dcgmcm_watch_info_p derivedInfo);
+
+    /*************************************************************************/
+    /*
+     * Queue the derived watches of inputInfo to be evaluated by
+     * AppendDerivedFields(). Called by AppendEntityInt64() and
+     * AppendEntityDouble() with m_mutex held
+     */
+    static void QueueDerivedFields(dcgmcm_update_thread_t *threadCtx, dcgmcm_watch_info_p inputInfo);
+
+    /*************************************************************************/
+    /*
+     * Evaluate the derived watches that threadCtx queued and append their
+     * values. Each gets the timestamp of its newest input, so it is only
+     * appended once per set of input samples, however many of them were
+     * updated. Called once the values of an update are all appended, so an
+     * expression sees every input of that update
+     */
+    void AppendDerivedFields(dcgmcm_update_thread_t *threadCtx);
+
     /*************************************************************************/
     /*
      * Helper functions to append values to our internal data structure
@@ -2306,6 +4379,8 @@ private:
     /*
      * Helpers to fetch the information of active FBC sessions on the given device/vGPU instance
      *
+     * The vGPU instance's sessions are picked out of the sessions of gpuId, which
+     * are fetched once per update cycle for all of its instances
      */
     dcgmReturn_t GetDeviceFBCSessionsInfo(nvmlDevice_t nvmlDevice,
                                           dcgmcm_update_thread_t *threadCtx,
@@ -2313,6 +4388,7 @@ private:
                                           timelib64_t now,
                                           timelib64_t expireTime);
     dcgmReturn_t GetVgpuInstanceFBCSessionsInfo(nvmlVgpuInstance_t vgpuId,
+                                                unsigned int gpuId,
                                                 dcgmcm_update_thread_t *threadCtx,
                                                 dcgmcm_watch_info_p watchInfo,
                                                 timelib64_t now,
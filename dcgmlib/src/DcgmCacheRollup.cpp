@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmCacheRollup.h"
+
+#include <DcgmStringHelpers.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+
+/*****************************************************************************/
+DcgmCacheRollup::DcgmCacheRollup(std::vector<dcgmcm_rollup_tier_config_t> const &tiers)
+{
+    m_tiers.reserve(tiers.size());
+    for (auto const &config : tiers)
+    {
+        m_tiers.push_back(Tier { config, {} });
+    }
+}
+
+/*****************************************************************************/
+static void AddToRollupBucket(dcgmcm_rollup_bucket_t &bucket, timelib64_t timestamp, double value)
+{
+    bucket.count++;
+    bucket.sum += value;
+    bucket.min = std::min(bucket.min, value);
+    bucket.max = std::max(bucket.max, value);
+
+    if (timestamp >= bucket.lastUsec)
+    {
+        bucket.integral += (bucket.last + value) / 2.0 * (double)(timestamp - bucket.lastUsec);
+        bucket.last     = value;
+        bucket.lastUsec = timestamp;
+    }
+    else if (timestamp < bucket.firstUsec)
+    {
+        bucket.integral += (value + bucket.first) / 2.0 * (double)(bucket.firstUsec - timestamp);
+        bucket.first     = value;
+        bucket.firstUsec = timestamp;
+    }
+    /* Else a late sample between existing ones. The integral is left as is */
+}
+
+/*****************************************************************************/
+void DcgmCacheRollup::Append(timelib64_t timestamp, double value)
+{
+    for (auto &tier : m_tiers)
+    {
+        timelib64_t startUsec = timestamp - (timestamp % tier.config.bucketUsec);
+        auto &buckets         = tier.buckets;
+
+        if (buckets.empty() || startUsec > buckets.back().startUsec)
+        {
+            buckets.push_back({ startUsec, timestamp, timestamp, 1, value, value, value, value, value, 0.0 });
+        }
+        else if (startUsec == buckets.back().startUsec)
+        {
+            AddToRollupBucket(buckets.back(), timestamp, value);
+        }
+        else
+        {
+            auto it = std::lower_bound(
+                buckets.begin(), buckets.end(), startUsec, [](dcgmcm_rollup_bucket_t const &bucket, timelib64_t usec) {
+                    return bucket.startUsec < usec;
+                });
+            if (it != buckets.end() && it->startUsec == startUsec)
+            {
+                AddToRollupBucket(*it, timestamp, value);
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheRollup::EnforceQuota(timelib64_t now, timelib64_t maxAgeUsec)
+{
+    for (auto &tier : m_tiers)
+    {
+        timelib64_t retentionUsec = tier.config.retentionUsec;
+        if (maxAgeUsec && maxAgeUsec < retentionUsec)
+        {
+            retentionUsec = maxAgeUsec;
+        }
+
+        while (!tier.buckets.empty() && tier.buckets.front().startUsec + tier.config.bucketUsec <= now - retentionUsec)
+        {
+            tier.buckets.pop_front();
+        }
+    }
+}
+
+/*****************************************************************************/
+int DcgmCacheRollup::FindTier(timelib64_t startTime) const
+{
+    int oldestTier = -1;
+
+    for (int i = 0; i < (int)m_tiers.size(); i++)
+    {
+        auto const &buckets = m_tiers[i].buckets;
+        if (buckets.empty())
+        {
+            continue;
+        }
+
+        if (buckets.front().firstUsec <= startTime)
+        {
+            return i; /* Finest tier that reaches back far enough */
+        }
+
+        if (oldestTier < 0 || buckets.front().firstUsec < m_tiers[oldestTier].buckets.front().firstUsec)
+        {
+            oldestTier = i;
+        }
+    }
+
+    return oldestTier;
+}
+
+/*****************************************************************************/
+std::deque<dcgmcm_rollup_bucket_t> const &DcgmCacheRollup::Buckets(int tier) const
+{
+    return m_tiers.at(tier).buckets;
+}
+
+/*****************************************************************************/
+int DcgmCacheRollup::NumTiers(void) const
+{
+    return (int)m_tiers.size();
+}
+
+/*****************************************************************************/
+dcgmcm_rollup_summary_t DcgmCacheRollup::Summarize(int tier, timelib64_t startTime, timelib64_t beforeTime) const
+{
+    dcgmcm_rollup_summary_t summary {};
+
+    for (auto const &bucket : m_tiers.at(tier).buckets)
+    {
+        if (bucket.lastUsec < startTime)
+        {
+            continue;
+        }
+        if (beforeTime && bucket.lastUsec >= beforeTime)
+        {
+            break; /* Buckets are never split */
+        }
+
+        if (!summary.count)
+        {
+            summary.min       = bucket.min;
+            summary.max       = bucket.max;
+            summary.first     = bucket.first;
+            summary.firstUsec = bucket.firstUsec;
+        }
+        else
+        {
+            /* Join this bucket to the previous one */
+            summary.integral += (summary.last + bucket.first) / 2.0 * (double)(bucket.firstUsec - summary.lastUsec);
+            summary.min = std::min(summary.min, bucket.min);
+            summary.max = std::max(summary.max, bucket.max);
+        }
+
+        summary.count += bucket.count;
+        summary.sum += bucket.sum;
+        summary.integral += bucket.integral;
+        summary.last     = bucket.last;
+        summary.lastUsec = bucket.lastUsec;
+    }
+
+    return summary;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheRollup::ParseTiers(std::string const &spec,
+                                         timelib64_t *rawRetentionUsec,
+                                         std::vector<dcgmcm_rollup_tier_config_t> *tiers)
+{
+    std::vector<std::string> tokens;
+    dcgmTokenizeString(spec, ",", tokens);
+    if (tokens.size() < 2)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    auto parseSeconds = [](std::string const &str, timelib64_t *usec) {
+        char *end        = nullptr;
+        long long number = strtoll(str.c_str(), &end, 10);
+        if (str.empty() || *end != '\0' || number <= 0)
+        {
+            return false;
+        }
+        *usec = (timelib64_t)number * 1000000;
+        return true;
+    };
+
+    if (!parseSeconds(tokens[0], rawRetentionUsec))
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    tiers->clear();
+    for (size_t i = 1; i < tokens.size(); i++)
+    {
+        size_t colon = tokens[i].find(':');
+        dcgmcm_rollup_tier_config_t config;
+        if (colon == std::string::npos || !parseSeconds(tokens[i].substr(0, colon), &config.bucketUsec)
+            || !parseSeconds(tokens[i].substr(colon + 1), &config.retentionUsec)
+            || config.retentionUsec < config.bucketUsec || config.retentionUsec <= *rawRetentionUsec)
+        {
+            return DCGM_ST_BADPARAM;
+        }
+
+        if (!tiers->empty()
+            && (config.bucketUsec <= tiers->back().bucketUsec || config.retentionUsec <= tiers->back().retentionUsec))
+        {
+            return DCGM_ST_BADPARAM;
+        }
+
+        tiers->push_back(config);
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmCacheRollup::NormalizeTiers(timelib64_t rawRetentionUsec, std::vector<dcgmcm_rollup_tier_config_t> *tiers)
+{
+    std::sort(tiers->begin(), tiers->end(), [](auto const &a, auto const &b) {
+        return a.bucketUsec < b.bucketUsec || (a.bucketUsec == b.bucketUsec && a.retentionUsec > b.retentionUsec);
+    });
+
+    std::vector<dcgmcm_rollup_tier_config_t> kept;
+    for (dcgmcm_rollup_tier_config_t const &tier : *tiers)
+    {
+        timelib64_t retainedUsec = kept.empty() ? rawRetentionUsec : kept.back().retentionUsec;
+        if (tier.bucketUsec <= 0 || tier.retentionUsec < tier.bucketUsec || tier.retentionUsec <= retainedUsec
+            || (!kept.empty() && tier.bucketUsec == kept.back().bucketUsec))
+        {
+            continue;
+        }
+        kept.push_back(tier);
+    }
+
+    tiers->swap(kept);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+#include "timelib.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+/*****************************************************************************/
+/* One level of aggregation kept for a watch in addition to its raw samples */
+typedef struct
+{
+    timelib64_t bucketUsec;    /* Width of each aggregate */
+    timelib64_t retentionUsec; /* How long to keep aggregates. Also capped by the watch's max age */
+} dcgmcm_rollup_tier_config_t;
+
+/*****************************************************************************/
+/* Aggregate of the samples whose timestamps fall in [startUsec, startUsec + bucketUsec) */
+typedef struct
+{
+    timelib64_t startUsec; /* Start of the bucket. A multiple of the tier's bucketUsec */
+    timelib64_t firstUsec; /* Timestamp of the first sample */
+    timelib64_t lastUsec;  /* Timestamp of the last sample */
+    long long count;       /* Number of samples */
+    double sum;            /* Sum of the samples */
+    double min;            /* Smallest sample */
+    double max;            /* Largest sample */
+    double first;          /* Value of the sample at firstUsec */
+    double last;           /* Value of the sample at lastUsec */
+    double integral;       /* Trapezoidal area under the samples from firstUsec to lastUsec */
+} dcgmcm_rollup_bucket_t;
+
+/*****************************************************************************/
+/* Totals over a range of buckets. See DcgmCacheRollup::Summarize() */
+typedef struct
+{
+    long long count;       /* 0 = no buckets were in range. The other fields are undefined */
+    double sum;            /* Sum of every sample */
+    double min;            /* Smallest sample */
+    double max;            /* Largest sample */
+    double first;          /* First sample */
+    double last;           /* Last sample */
+    timelib64_t firstUsec; /* Timestamp of first */
+    timelib64_t lastUsec;  /* Timestamp of last */
+    double integral;       /* Area under the samples, joining buckets with trapezoids */
+} dcgmcm_rollup_summary_t;
+
+/*****************************************************************************/
+/*
+ * Multi-resolution aggregates of a numeric watch, so that long windows can be
+ * answered without keeping every raw sample for the whole window. Every tier
+ * is updated on each append. Tiers are ordered from the finest to the coarsest.
+ *
+ * This class is not thread safe. The cache manager only touches it while
+ * holding its lock.
+ */
+class DcgmCacheRollup
+{
+public:
+    explicit DcgmCacheRollup(std::vector<dcgmcm_rollup_tier_config_t> const &tiers);
+
+    /*************************************************************************/
+    /*
+     * Add a sample to every tier. Blank values should not be passed. Samples
+     * older than the newest bucket of a tier are added to their bucket if it
+     * still exists and dropped otherwise.
+     */
+    void Append(timelib64_t timestamp, double value);
+
+    /*************************************************************************/
+    /*
+     * Drop buckets that end before now - retention of their tier. maxAgeUsec
+     * caps the retention of every tier. 0 = no cap.
+     */
+    void EnforceQuota(timelib64_t now, timelib64_t maxAgeUsec);
+
+    /*************************************************************************/
+    /*
+     * Get the finest tier that has data at or before startTime, falling back to
+     * the tier with the oldest data if none reach back that far.
+     *
+     * Returns the tier index or -1 if there are no buckets at all
+     */
+    int FindTier(timelib64_t startTime) const;
+
+    std::deque<dcgmcm_rollup_bucket_t> const &Buckets(int tier) const;
+    int NumTiers(void) const;
+
+    /*************************************************************************/
+    /*
+     * Summarize the buckets of tier that have samples at or after startTime and
+     * whose samples are all before beforeTime. 0 means no limit for either.
+     */
+    dcgmcm_rollup_summary_t Summarize(int tier, timelib64_t startTime, timelib64_t beforeTime) const;
+
+    /*************************************************************************/
+    /*
+     * Parse a tier list like "300,10:21600,60:86400": how long to keep raw
+     * samples, then <bucket>:<retention> for each tier, all in seconds. Tiers
+     * must have growing bucket widths and retentions.
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM if spec is malformed
+     */
+    static dcgmReturn_t ParseTiers(std::string const &spec,
+                                   timelib64_t *rawRetentionUsec,
+                                   std::vector<dcgmcm_rollup_tier_config_t> *tiers);
+
+    /*************************************************************************/
+    /*
+     * Turn any list of tiers into one a rollup can be built from: sort it by
+     * bucket width, then drop each tier that isn't retained longer than
+     * rawRetentionUsec, its own bucket width and every finer tier it keeps.
+     * Of tiers with the same width, the one retained longest is kept.
+     */
+    static void NormalizeTiers(timelib64_t rawRetentionUsec, std::vector<dcgmcm_rollup_tier_config_t> *tiers);
+
+private:
+    struct Tier
+    {
+        dcgmcm_rollup_tier_config_t config;
+        std::deque<dcgmcm_rollup_bucket_t> buckets; /* Ascending by startUsec */
+    };
+
+    std::vector<Tier> m_tiers;
+};
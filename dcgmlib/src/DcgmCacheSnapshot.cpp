@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmCacheSnapshot.h"
+#include "timeseries.h"
+
+#include <DcgmLogging.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/*****************************************************************************/
+DcgmCacheSnapshotWriter::DcgmCacheSnapshotWriter(std::string filename)
+    : m_filename(std::move(filename))
+    , m_tmpFilename(m_filename + ".tmp")
+    , m_fp(nullptr)
+    , m_numRecords(0)
+    , m_failed(false)
+{}
+
+/*****************************************************************************/
+DcgmCacheSnapshotWriter::~DcgmCacheSnapshotWriter()
+{
+    if (m_fp)
+    {
+        /* Never finished. Don't leave a partial file behind */
+        fclose(m_fp);
+        m_fp = nullptr;
+        unlink(m_tmpFilename.c_str());
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheSnapshotWriter::Open(void)
+{
+    m_fp = fopen(m_tmpFilename.c_str(), "wb");
+    if (!m_fp)
+    {
+        DCGM_LOG_ERROR << "Unable to create cache snapshot " << m_tmpFilename << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    dcgm_cache_snapshot_header_t header {};
+    return Write(&header, sizeof(header));
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheSnapshotWriter::Write(void const *data, size_t size)
+{
+    if (m_failed || !m_fp)
+        return DCGM_ST_GENERIC_ERROR;
+
+    if (size && fwrite(data, size, 1, m_fp) != 1)
+    {
+        DCGM_LOG_ERROR << "Error writing cache snapshot " << m_tmpFilename << ": " << strerror(errno);
+        m_failed = true;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheSnapshotWriter::Pad(size_t size)
+{
+    static const char zeros[8] = {};
+    return Write(zeros, (8 - (size & 7)) & 7);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheSnapshotWriter::AddNumericRecord(dcgm_cache_snapshot_record_t *record,
+                                                       timelib64_t const *times,
+                                                       long long const *val,
+                                                       long long const *val2)
+{
+    size_t arraySize   = sizeof(long long) * record->numSamples;
+    record->recordSize = sizeof(*record) + 3 * arraySize;
+
+    dcgmReturn_t ret = Write(record, sizeof(*record));
+    if (ret == DCGM_ST_OK)
+        ret = Write(times, arraySize);
+    if (ret == DCGM_ST_OK)
+        ret = Write(val, arraySize);
+    if (ret == DCGM_ST_OK)
+        ret = Write(val2, arraySize);
+    if (ret == DCGM_ST_OK)
+        m_numRecords++;
+    return ret;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheSnapshotWriter::AddVarRecord(dcgm_cache_snapshot_record_t *record,
+                                                   dcgm_cache_snapshot_var_t const *varHeaders,
+                                                   void const *const *varValues)
+{
+    record->recordSize = sizeof(*record);
+    for (int i = 0; i < record->numSamples; i++)
+        record->recordSize += DcgmCacheSnapshotVarSize(varHeaders[i].size);
+
+    dcgmReturn_t ret = Write(record, sizeof(*record));
+    for (int i = 0; i < record->numSamples && ret == DCGM_ST_OK; i++)
+    {
+        ret = Write(&varHeaders[i], sizeof(varHeaders[i]));
+        if (ret == DCGM_ST_OK)
+            ret = Write(varValues[i], varHeaders[i].size);
+        if (ret == DCGM_ST_OK)
+            ret = Pad(varHeaders[i].size);
+    }
+
+    if (ret == DCGM_ST_OK)
+        m_numRecords++;
+    return ret;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheSnapshotWriter::Finish(dcgm_cache_snapshot_header_t *header)
+{
+    if (m_failed || !m_fp)
+        return DCGM_ST_GENERIC_ERROR;
+
+    header->magic      = DCGM_CACHE_SNAPSHOT_MAGIC;
+    header->version    = DCGM_CACHE_SNAPSHOT_VERSION;
+    header->headerSize = sizeof(*header);
+    header->numRecords = m_numRecords;
+
+    if (fseek(m_fp, 0, SEEK_SET) != 0 || Write(header, sizeof(*header)) != DCGM_ST_OK || fflush(m_fp) != 0
+        || fsync(fileno(m_fp)) != 0)
+    {
+        DCGM_LOG_ERROR << "Error finishing cache snapshot " << m_tmpFilename << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    fclose(m_fp);
+    m_fp = nullptr;
+
+    if (rename(m_tmpFilename.c_str(), m_filename.c_str()) != 0)
+    {
+        DCGM_LOG_ERROR << "Unable to rename " << m_tmpFilename << " to " << m_filename << ": " << strerror(errno);
+        unlink(m_tmpFilename.c_str());
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+DcgmCacheSnapshotReader::DcgmCacheSnapshotReader()
+    : m_mapping(nullptr)
+    , m_size(0)
+{}
+
+/*****************************************************************************/
+DcgmCacheSnapshotReader::~DcgmCacheSnapshotReader()
+{
+    if (m_mapping)
+    {
+        munmap(m_mapping, m_size);
+        m_mapping = nullptr;
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheSnapshotReader::Open(std::string const &filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno == ENOENT)
+            return DCGM_ST_NO_DATA;
+
+        DCGM_LOG_ERROR << "Unable to open cache snapshot " << filename << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(dcgm_cache_snapshot_header_t))
+    {
+        DCGM_LOG_ERROR << "Cache snapshot " << filename << " is truncated";
+        close(fd);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    m_size    = st.st_size;
+    m_mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* The mapping stays valid */
+    if (m_mapping == MAP_FAILED)
+    {
+        DCGM_LOG_ERROR << "Unable to map cache snapshot " << filename << ": " << strerror(errno);
+        m_mapping = nullptr;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    /* Records are read front to back exactly once */
+    madvise(m_mapping, m_size, MADV_SEQUENTIAL);
+
+    dcgm_cache_snapshot_header_t const *header = Header();
+    if (header->magic != DCGM_CACHE_SNAPSHOT_MAGIC)
+    {
+        DCGM_LOG_ERROR << filename << " is not a cache snapshot";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+    if (header->version != DCGM_CACHE_SNAPSHOT_VERSION || header->headerSize != sizeof(*header))
+    {
+        DCGM_LOG_WARNING << "Ignoring cache snapshot " << filename << " of version " << header->version
+                         << ". Expected " << DCGM_CACHE_SNAPSHOT_VERSION;
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgm_cache_snapshot_header_t const *DcgmCacheSnapshotReader::Header(void) const
+{
+    return (dcgm_cache_snapshot_header_t const *)m_mapping;
+}
+
+/*****************************************************************************/
+bool DcgmCacheSnapshotReader::IsRecordValid(dcgm_cache_snapshot_record_t const *record, size_t remaining) const
+{
+    if (remaining < sizeof(*record) || record->recordSize < (long long)sizeof(*record)
+        || (size_t)record->recordSize > remaining || (record->recordSize & 7) || record->numSamples < 0)
+        return false;
+
+    long long dataSize = record->recordSize - (long long)sizeof(*record);
+
+    if (record->tsType == TS_TYPE_INT64 || record->tsType == TS_TYPE_DOUBLE)
+        return dataSize == 3 * (long long)sizeof(long long) * record->numSamples;
+
+    if (record->tsType != TS_TYPE_STRING && record->tsType != TS_TYPE_BLOB)
+        return false;
+
+    char const *cursor = (char const *)(record + 1);
+    for (int i = 0; i < record->numSamples; i++)
+    {
+        if (dataSize < (long long)sizeof(dcgm_cache_snapshot_var_t))
+            return false;
+
+        long long valueSize = ((dcgm_cache_snapshot_var_t const *)cursor)->size;
+        if (valueSize < 0 || valueSize > dataSize)
+            return false;
+
+        long long varSize = DcgmCacheSnapshotVarSize(valueSize);
+        if (varSize > dataSize)
+            return false;
+
+        /* Strings must be terminated within their value */
+        if (record->tsType == TS_TYPE_STRING
+            && (valueSize == 0 || cursor[sizeof(dcgm_cache_snapshot_var_t) + valueSize - 1] != '\0'))
+            return false;
+
+        cursor += varSize;
+        dataSize -= varSize;
+    }
+
+    return dataSize == 0;
+}
+
+/*****************************************************************************/
+dcgm_cache_snapshot_record_t const *DcgmCacheSnapshotReader::NextRecord(size_t *offset) const
+{
+    if (!m_mapping)
+        return nullptr;
+
+    if (*offset == 0)
+        *offset = sizeof(dcgm_cache_snapshot_header_t);
+
+    if (*offset >= m_size)
+        return nullptr;
+
+    dcgm_cache_snapshot_record_t const *record
+        = (dcgm_cache_snapshot_record_t const *)((char const *)m_mapping + *offset);
+    if (!IsRecordValid(record, m_size - *offset))
+    {
+        DCGM_LOG_ERROR << "Malformed cache snapshot record at offset " << *offset;
+        return nullptr;
+    }
+
+    *offset += record->recordSize;
+    return record;
+}
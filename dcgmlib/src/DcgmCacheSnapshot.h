@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+#include "timelib.h"
+#include <cstdio>
+#include <string>
+
+/*****************************************************************************/
+/*
+ * On-disk snapshot of the cache manager's watches and samples, used to carry
+ * history across hostengine restarts. See DcgmCacheManager::SaveSnapshot().
+ *
+ * The file is a header followed by one record per watch. Everything is 8-byte
+ * aligned and in host byte order so that a mapping of the file can be read in
+ * place. A record is a dcgm_cache_snapshot_record_t followed by:
+ *
+ * TS_TYPE_INT64 / TS_TYPE_DOUBLE: timelib64_t times[numSamples], then
+ *     long long val[numSamples], then long long val2[numSamples]. Doubles are
+ *     stored bitwise
+ * TS_TYPE_STRING / TS_TYPE_BLOB: numSamples of a dcgm_cache_snapshot_var_t
+ *     followed by its bytes, padded to 8 bytes. Strings include their NULL
+ *
+ * Bump DCGM_CACHE_SNAPSHOT_VERSION whenever this layout changes. Files of
+ * other versions are ignored.
+ */
+#define DCGM_CACHE_SNAPSHOT_MAGIC   0x53474344 /* "DCGS" */
+#define DCGM_CACHE_SNAPSHOT_VERSION 1
+
+typedef struct
+{
+    unsigned int magic;       /* DCGM_CACHE_SNAPSHOT_MAGIC */
+    unsigned int version;     /* DCGM_CACHE_SNAPSHOT_VERSION */
+    unsigned int headerSize;  /* sizeof(dcgm_cache_snapshot_header_t) */
+    unsigned int numGpus;     /* Number of entries in gpuUuids */
+    long long savedUsec;      /* When the snapshot was written */
+    long long numRecords;     /* Number of records after the header */
+    char gpuUuids[DCGM_MAX_NUM_DEVICES][DCGM_MAX_STR_LENGTH]; /* UUID of each gpuId when saved. GPU-scoped
+                                                                  records are dropped if it changed */
+} dcgm_cache_snapshot_header_t;
+
+typedef struct
+{
+    long long recordSize;           /* Size of this record in bytes, including this struct */
+    unsigned int entityId;          /* Entity of the watch */
+    unsigned short entityGroupId;   /* DCGM_FE_? of the watch */
+    unsigned short fieldId;         /* DCGM_FI_? of the watch */
+    int tsType;                     /* TS_TYPE_? of the samples */
+    int numSamples;                 /* Number of samples in this record */
+    long long monitorFrequencyUsec; /* Sample interval of the watch when saved */
+    long long maxAgeUsec;           /* Sample retention of the watch when saved */
+} dcgm_cache_snapshot_record_t;
+
+typedef struct
+{
+    timelib64_t timestamp; /* Sample time */
+    long long size;        /* Bytes of value that follow */
+} dcgm_cache_snapshot_var_t;
+
+/*****************************************************************************/
+/*
+ * Writes a snapshot to a temporary file next to filename and renames it into
+ * place on Finish(), so readers never see a partial snapshot
+ */
+class DcgmCacheSnapshotWriter
+{
+public:
+    explicit DcgmCacheSnapshotWriter(std::string filename);
+    ~DcgmCacheSnapshotWriter();
+
+    /*************************************************************************/
+    /*
+     * Create the temporary file and write a placeholder header
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_GENERIC_ERROR if the file couldn't be created
+     */
+    dcgmReturn_t Open(void);
+
+    /*************************************************************************/
+    /*
+     * Write one record. record->recordSize is filled in here.
+     *
+     * times/val/val2 IN: Numeric samples. Used for TS_TYPE_INT64/DOUBLE
+     * varValues      IN: Pointer to each sample's bytes and varHeaders their
+     *                    sizes and timestamps. Used for TS_TYPE_STRING/BLOB
+     */
+    dcgmReturn_t AddNumericRecord(dcgm_cache_snapshot_record_t *record,
+                                  timelib64_t const *times,
+                                  long long const *val,
+                                  long long const *val2);
+    dcgmReturn_t AddVarRecord(dcgm_cache_snapshot_record_t *record,
+                              dcgm_cache_snapshot_var_t const *varHeaders,
+                              void const *const *varValues);
+
+    /*************************************************************************/
+    /*
+     * Rewrite the header with the final record count and rename the file into
+     * place. header->numRecords is filled in here
+     */
+    dcgmReturn_t Finish(dcgm_cache_snapshot_header_t *header);
+
+private:
+    dcgmReturn_t Write(void const *data, size_t size);
+    dcgmReturn_t Pad(size_t size);
+
+    std::string m_filename;
+    std::string m_tmpFilename;
+    FILE *m_fp;
+    long long m_numRecords;
+    bool m_failed;
+};
+
+/*****************************************************************************/
+/*
+ * Maps a snapshot read-only and walks its records in place
+ */
+class DcgmCacheSnapshotReader
+{
+public:
+    DcgmCacheSnapshotReader();
+    ~DcgmCacheSnapshotReader();
+
+    /*************************************************************************/
+    /*
+     * Map filename and check its header
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_NO_DATA if the file doesn't exist
+     *         DCGM_ST_VER_MISMATCH if the file is of a different version
+     *         DCGM_ST_GENERIC_ERROR if the file is malformed or couldn't be mapped
+     */
+    dcgmReturn_t Open(std::string const &filename);
+
+    dcgm_cache_snapshot_header_t const *Header(void) const;
+
+    /*************************************************************************/
+    /*
+     * Get the next record. Pass *offset as 0 on the first call
+     *
+     * Returns a pointer into the mapping, whose size and sample arrays have been
+     *         checked against the file size
+     *         nullptr at the end of the file or on a malformed record
+     */
+    dcgm_cache_snapshot_record_t const *NextRecord(size_t *offset) const;
+
+private:
+    bool IsRecordValid(dcgm_cache_snapshot_record_t const *record, size_t remaining) const;
+
+    void *m_mapping;
+    size_t m_size;
+};
+
+/*****************************************************************************/
+/* Accessors for the numeric arrays that follow a numeric record */
+inline timelib64_t const *DcgmCacheSnapshotTimes(dcgm_cache_snapshot_record_t const *record)
+{
+    return (timelib64_t const *)(record + 1);
+}
+
+inline long long const *DcgmCacheSnapshotVal(dcgm_cache_snapshot_record_t const *record)
+{
+    return (long long const *)(DcgmCacheSnapshotTimes(record) + record->numSamples);
+}
+
+inline long long const *DcgmCacheSnapshotVal2(dcgm_cache_snapshot_record_t const *record)
+{
+    return DcgmCacheSnapshotVal(record) + record->numSamples;
+}
+
+/* Size of a var sample including its header and padding */
+inline long long DcgmCacheSnapshotVarSize(long long valueSize)
+{
+    return (long long)sizeof(dcgm_cache_snapshot_var_t) + ((valueSize + 7) & ~7LL);
+}
@@ -0,0 +1,584 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmCacheSpill.h"
+
+#include <DcgmLogging.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr std::uint32_t SPILL_BLOCK_MAGIC = 0x4c495053; /* "SPIL" */
+constexpr std::uint32_t SPILL_FLAG_DOUBLE = 0x1;
+
+/* Precedes the payload of every block. Also the time index of the block */
+struct SpillBlockHeader
+{
+    std::uint32_t magic;
+    std::uint32_t numSamples;
+    std::uint32_t payloadBytes;
+    std::uint32_t flags; /* SPILL_FLAG_? */
+    std::int64_t firstUsec;
+    std::int64_t lastUsec;
+};
+
+void PutVarint(std::uint64_t value, std::string &out)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((char)((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+bool GetVarint(unsigned char const *&pos, unsigned char const *end, std::uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7)
+    {
+        unsigned char byte = *pos++;
+        value |= (std::uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+std::uint64_t ZigZag(std::int64_t value)
+{
+    return ((std::uint64_t)value << 1) ^ (std::uint64_t)(value >> 63);
+}
+
+std::int64_t UnZigZag(std::uint64_t value)
+{
+    return (std::int64_t)(value >> 1) ^ -(std::int64_t)(value & 1);
+}
+
+std::uint64_t DoubleBits(double value)
+{
+    std::uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/* Header byte of an XOR that is 0. Real headers have fewer than 8 zero bytes in total */
+constexpr unsigned char XOR_ZERO = 0x88;
+} // namespace
+
+/*****************************************************************************/
+DcgmCacheSpill::DcgmCacheSpill(std::string directory, long long budgetBytes)
+    : m_directory(std::move(directory))
+    , m_budgetBytes(budgetBytes > 0 ? budgetBytes : DCGM_CM_SPILL_DEFAULT_BUDGET_BYTES)
+{
+    /* Enough segments that deleting the oldest one doesn't take a big bite out of the budget */
+    m_segmentBytes = std::max(64LL * 1024, std::min((long long)DCGM_CM_SPILL_MAX_SEGMENT_BYTES, m_budgetBytes / 16));
+}
+
+/*****************************************************************************/
+DcgmCacheSpill::~DcgmCacheSpill()
+{
+    Flush();
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmCacheSpill::Open()
+{
+    if (mkdir(m_directory.c_str(), 0700) != 0 && errno != EEXIST)
+    {
+        DCGM_LOG_ERROR << "Unable to create spill directory " << m_directory << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    DIR *dir = opendir(m_directory.c_str());
+    if (dir == nullptr)
+    {
+        DCGM_LOG_ERROR << "Unable to read spill directory " << m_directory << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    struct dirent *dirEntry;
+    while ((dirEntry = readdir(dir)) != nullptr)
+    {
+        unsigned int entityGroupId;
+        unsigned int entityId;
+        unsigned int fieldId;
+        long long firstUsec;
+        int nameLength = 0;
+        int numParsed  = sscanf(
+            dirEntry->d_name, "%u_%u_%u_%lld.spill%n", &entityGroupId, &entityId, &fieldId, &firstUsec, &nameLength);
+        if (numParsed != 4 || nameLength == 0 || dirEntry->d_name[nameLength] != '\0' || fieldId > USHRT_MAX)
+        {
+            continue;
+        }
+        IndexSegment(m_directory + "/" + dirEntry->d_name, entityGroupId, entityId, (unsigned short)fieldId);
+    }
+    closedir(dir);
+
+    for (auto &[key, series] : m_series)
+    {
+        std::sort(series.segments.begin(), series.segments.end(), [](Segment const &a, Segment const &b) {
+            return a.blocks.front().firstUsec < b.blocks.front().firstUsec;
+        });
+        series.lastUsec = series.segments.back().blocks.back().lastUsec;
+    }
+
+    DCGM_LOG_INFO << "Spilling aged samples to " << m_directory << ". " << m_bytesUsed << " of " << m_budgetBytes
+                  << " bytes are in use";
+    EnforceBudget();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmCacheSpill::IndexSegment(std::string const &path,
+                                  unsigned int entityGroupId,
+                                  unsigned int entityId,
+                                  unsigned short fieldId)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    Segment segment;
+    segment.path   = path;
+    bool isDouble  = false;
+    long long size = lseek(fd, 0, SEEK_END);
+    SpillBlockHeader header;
+
+    /* A block cut short by a crash ends the segment */
+    while (segment.bytes + (long long)sizeof(header) <= size
+           && pread(fd, &header, sizeof(header), segment.bytes) == (ssize_t)sizeof(header)
+           && header.magic == SPILL_BLOCK_MAGIC && header.numSamples > 0
+           && segment.bytes + (long long)sizeof(header) + header.payloadBytes <= size)
+    {
+        isDouble = (header.flags & SPILL_FLAG_DOUBLE) != 0;
+        segment.blocks.push_back(
+            Block { segment.bytes, header.numSamples, header.payloadBytes, header.firstUsec, header.lastUsec });
+        segment.bytes += sizeof(header) + header.payloadBytes;
+    }
+    close(fd);
+
+    if (segment.blocks.empty())
+    {
+        unlink(path.c_str());
+        return;
+    }
+
+    Series &series       = m_series[SeriesKey(entityGroupId, entityId, fieldId)];
+    series.entityGroupId = entityGroupId;
+    series.entityId      = entityId;
+    series.fieldId       = fieldId;
+    series.isDouble      = isDouble;
+    m_bytesUsed += size;
+    segment.bytes = size;
+    series.segments.push_back(std::move(segment));
+}
+
+/*****************************************************************************/
+void DcgmCacheSpill::Append(unsigned int entityGroupId,
+                            unsigned int entityId,
+                            unsigned short fieldId,
+                            bool isDouble,
+                            dcgmcm_spill_sample_t const *samples,
+                            int numSamples)
+{
+    Series &series = m_series[SeriesKey(entityGroupId, entityId, fieldId)];
+    if (series.segments.empty() && series.pending.empty())
+    {
+        series.entityGroupId = entityGroupId;
+        series.entityId      = entityId;
+        series.fieldId       = fieldId;
+        series.isDouble      = isDouble;
+    }
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        if (samples[i].timestamp <= series.lastUsec)
+            continue;
+
+        series.pending.push_back(samples[i]);
+        series.lastUsec = samples[i].timestamp;
+        if (series.pending.size() >= DCGM_CM_SPILL_BLOCK_SAMPLES)
+            WriteBlock(series);
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheSpill::Flush()
+{
+    for (auto &[key, series] : m_series)
+    {
+        if (!series.pending.empty())
+            WriteBlock(series);
+    }
+}
+
+/*****************************************************************************/
+void DcgmCacheSpill::WriteBlock(Series &series)
+{
+    std::string block(sizeof(SpillBlockHeader), '\0');
+    EncodeBlock(series.isDouble, series.pending.data(), (int)series.pending.size(), block);
+
+    SpillBlockHeader header {};
+    header.magic        = SPILL_BLOCK_MAGIC;
+    header.numSamples   = (std::uint32_t)series.pending.size();
+    header.payloadBytes = (std::uint32_t)(block.size() - sizeof(header));
+    header.flags        = series.isDouble ? SPILL_FLAG_DOUBLE : 0;
+    header.firstUsec    = series.pending.front().timestamp;
+    header.lastUsec     = series.pending.back().timestamp;
+    memcpy(&block[0], &header, sizeof(header));
+
+    if (series.segments.empty() || !series.segments.back().writable
+        || series.segments.back().bytes + (long long)block.size() > m_segmentBytes)
+    {
+        Segment segment;
+        segment.path = m_directory + "/" + std::to_string(series.entityGroupId) + "_"
+                       + std::to_string(series.entityId) + "_" + std::to_string(series.fieldId) + "_"
+                       + std::to_string(header.firstUsec) + ".spill";
+        segment.writable = true;
+        series.segments.push_back(std::move(segment));
+    }
+    Segment &segment = series.segments.back();
+
+    /* Samples that can't be written are dropped like they would have been without a spill */
+    series.pending.clear();
+
+    int fd = open(segment.path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0600);
+    if (fd < 0)
+    {
+        DCGM_LOG_ERROR << "Unable to open spill segment " << segment.path << ": " << strerror(errno);
+        if (segment.blocks.empty())
+            series.segments.pop_back();
+        return;
+    }
+    ssize_t written = write(fd, block.data(), block.size());
+    close(fd);
+    if (written != (ssize_t)block.size())
+    {
+        DCGM_LOG_ERROR << "Unable to write spill segment " << segment.path << ": " << strerror(errno);
+        /* Don't append after a partial block. The next block starts a new segment */
+        segment.writable = false;
+        if (written > 0)
+        {
+            segment.bytes += written;
+            m_bytesUsed += written;
+        }
+        if (segment.blocks.empty())
+        {
+            unlink(segment.path.c_str());
+            m_bytesUsed -= segment.bytes;
+            series.segments.pop_back();
+        }
+        return;
+    }
+
+    segment.blocks.push_back(
+        Block { segment.bytes, header.numSamples, header.payloadBytes, header.firstUsec, header.lastUsec });
+    segment.bytes += block.size();
+    m_bytesUsed += block.size();
+    EnforceBudget();
+}
+
+/*****************************************************************************/
+void DcgmCacheSpill::EnforceBudget()
+{
+    while (m_bytesUsed > m_budgetBytes)
+    {
+        Series *oldest = nullptr;
+        for (auto &[key, series] : m_series)
+        {
+            if (!series.segments.empty()
+                && (oldest == nullptr
+                    || series.segments.front().blocks.back().lastUsec
+                           < oldest->segments.front().blocks.back().lastUsec))
+            {
+                oldest = &series;
+            }
+        }
+        if (oldest == nullptr)
+            return;
+
+        Segment const &segment = oldest->segments.front();
+        DCGM_LOG_DEBUG << "Deleting spill segment " << segment.path << " to stay within " << m_budgetBytes
+                       << " bytes";
+        unlink(segment.path.c_str());
+        m_bytesUsed -= segment.bytes;
+        oldest->segments.pop_front();
+    }
+}
+
+/*****************************************************************************/
+DcgmCacheSpill::Series const *DcgmCacheSpill::FindSeries(unsigned int entityGroupId,
+                                                         unsigned int entityId,
+                                                         unsigned short fieldId) const
+{
+    auto it = m_series.find(SeriesKey(entityGroupId, entityId, fieldId));
+    return it == m_series.end() ? nullptr : &it->second;
+}
+
+/*****************************************************************************/
+timelib64_t DcgmCacheSpill::OldestUsec(unsigned int entityGroupId, unsigned int entityId, unsigned short fieldId) const
+{
+    Series const *series = FindSeries(entityGroupId, entityId, fieldId);
+    if (series == nullptr)
+        return 0;
+    if (!series->segments.empty())
+        return series->segments.front().blocks.front().firstUsec;
+    if (!series->pending.empty())
+        return series->pending.front().timestamp;
+    return 0;
+}
+
+/*****************************************************************************/
+long long DcgmCacheSpill::GetBytesUsed() const
+{
+    return m_bytesUsed;
+}
+
+/*****************************************************************************/
+bool DcgmCacheSpill::ReadBlock(Segment const &segment,
+                               Block const &block,
+                               bool isDouble,
+                               std::vector<dcgmcm_spill_sample_t> &samples) const
+{
+    int fd = open(segment.path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    /* Map from the page the block starts in */
+    long long pageSize  = sysconf(_SC_PAGESIZE);
+    long long mapOffset = block.offset - block.offset % pageSize;
+    size_t mapBytes     = (size_t)(block.offset - mapOffset) + sizeof(SpillBlockHeader) + block.payloadBytes;
+    void *mapping       = mmap(nullptr, mapBytes, PROT_READ, MAP_SHARED, fd, mapOffset);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+
+    unsigned char const *payload
+        = (unsigned char const *)mapping + (block.offset - mapOffset) + sizeof(SpillBlockHeader);
+    samples.clear();
+    bool decoded = DecodeBlock(isDouble, payload, block.payloadBytes, (int)block.numSamples, samples);
+    munmap(mapping, mapBytes);
+    return decoded;
+}
+
+/*****************************************************************************/
+int DcgmCacheSpill::Read(unsigned int entityGroupId,
+                         unsigned int entityId,
+                         unsigned short fieldId,
+                         timelib64_t startTime,
+                         timelib64_t endTime,
+                         timelib64_t beforeUsec,
+                         dcgmOrder_t order,
+                         int maxSamples,
+                         std::vector<dcgmcm_spill_sample_t> &samples,
+                         bool *isDouble)
+{
+    Series const *series = FindSeries(entityGroupId, entityId, fieldId);
+    if (series == nullptr || maxSamples < 1)
+        return 0;
+
+    timelib64_t firstUsec = startTime;
+    timelib64_t lastUsec  = endTime ? endTime : LLONG_MAX;
+    if (beforeUsec)
+        lastUsec = std::min(lastUsec, beforeUsec - 1);
+    if (firstUsec > lastUsec)
+        return 0;
+
+    /* Blocks in range in ascending order. The pending samples are a block of their own at the end */
+    std::vector<std::pair<Segment const *, Block const *>> blocks;
+    for (auto const &segment : series->segments)
+    {
+        if (segment.blocks.back().lastUsec < firstUsec || segment.blocks.front().firstUsec > lastUsec)
+            continue;
+        for (auto const &block : segment.blocks)
+        {
+            if (block.lastUsec >= firstUsec && block.firstUsec <= lastUsec)
+                blocks.emplace_back(&segment, &block);
+        }
+    }
+    if (!series->pending.empty())
+        blocks.emplace_back(nullptr, nullptr);
+
+    int numRead = 0;
+    std::vector<dcgmcm_spill_sample_t> blockSamples;
+    auto readBlock = [&](std::pair<Segment const *, Block const *> const &block) {
+        if (block.first == nullptr)
+        {
+            blockSamples = series->pending;
+            return;
+        }
+        if (!ReadBlock(*block.first, *block.second, series->isDouble, blockSamples))
+        {
+            DCGM_LOG_ERROR << "Skipping unreadable block at " << block.second->offset << " of spill segment "
+                           << block.first->path;
+            blockSamples.clear();
+        }
+    };
+    auto inRange = [&](dcgmcm_spill_sample_t const &sample) {
+        return sample.timestamp >= firstUsec && sample.timestamp <= lastUsec;
+    };
+
+    if (order == DCGM_ORDER_ASCENDING)
+    {
+        for (auto it = blocks.begin(); it != blocks.end() && numRead < maxSamples; ++it)
+        {
+            readBlock(*it);
+            for (auto sample = blockSamples.begin(); sample != blockSamples.end() && numRead < maxSamples; ++sample)
+            {
+                if (inRange(*sample))
+                {
+                    samples.push_back(*sample);
+                    numRead++;
+                }
+            }
+        }
+    }
+    else
+    {
+        for (auto it = blocks.rbegin(); it != blocks.rend() && numRead < maxSamples; ++it)
+        {
+            readBlock(*it);
+            for (auto sample = blockSamples.rbegin(); sample != blockSamples.rend() && numRead < maxSamples; ++sample)
+            {
+                if (inRange(*sample))
+                {
+                    samples.push_back(*sample);
+                    numRead++;
+                }
+            }
+        }
+    }
+
+    if (numRead > 0 && isDouble != nullptr)
+        *isDouble = series->isDouble;
+    return numRead;
+}
+
+/*****************************************************************************/
+void DcgmCacheSpill::EncodeBlock(bool isDouble,
+                                 dcgmcm_spill_sample_t const *samples,
+                                 int numSamples,
+                                 std::string &payload)
+{
+    std::int64_t prevUsec      = 0;
+    std::int64_t prevDeltaUsec = 0;
+    std::uint64_t prevBits     = 0;
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        /* Regular sampling makes the delta of deltas 0, one byte */
+        std::int64_t deltaUsec = (std::int64_t)((std::uint64_t)samples[i].timestamp - (std::uint64_t)prevUsec);
+        PutVarint(ZigZag((std::int64_t)((std::uint64_t)deltaUsec - (std::uint64_t)prevDeltaUsec)), payload);
+        prevUsec      = samples[i].timestamp;
+        prevDeltaUsec = deltaUsec;
+
+        if (!isDouble)
+        {
+            std::uint64_t bits = (std::uint64_t)samples[i].value.i64;
+            PutVarint(ZigZag((std::int64_t)(bits - prevBits)), payload);
+            prevBits = bits;
+            continue;
+        }
+
+        /* Close doubles share their sign, exponent and high mantissa bits, and round ones have trailing zero
+           bits. Only the bytes in between are written after a byte of how many were left out on each side */
+        std::uint64_t bits = DoubleBits(samples[i].value.dbl);
+        std::uint64_t xor_ = bits ^ prevBits;
+        prevBits           = bits;
+        if (xor_ == 0)
+        {
+            payload.push_back((char)XOR_ZERO);
+            continue;
+        }
+
+        int leading  = __builtin_clzll(xor_) / 8;
+        int trailing = __builtin_ctzll(xor_) / 8;
+        payload.push_back((char)((leading << 4) | trailing));
+        for (int byte = trailing; byte < 8 - leading; byte++)
+        {
+            payload.push_back((char)(xor_ >> (byte * 8)));
+        }
+    }
+}
+
+/*****************************************************************************/
+bool DcgmCacheSpill::DecodeBlock(bool isDouble,
+                                 unsigned char const *payload,
+                                 size_t payloadBytes,
+                                 int numSamples,
+                                 std::vector<dcgmcm_spill_sample_t> &samples)
+{
+    unsigned char const *pos = payload;
+    unsigned char const *end = payload + payloadBytes;
+    std::int64_t prevUsec      = 0;
+    std::int64_t prevDeltaUsec = 0;
+    std::uint64_t prevBits     = 0;
+
+    samples.reserve(samples.size() + numSamples);
+    for (int i = 0; i < numSamples; i++)
+    {
+        std::uint64_t encoded;
+        if (!GetVarint(pos, end, encoded))
+            return false;
+        std::int64_t deltaUsec = (std::int64_t)((std::uint64_t)prevDeltaUsec + (std::uint64_t)UnZigZag(encoded));
+        prevUsec               = (std::int64_t)((std::uint64_t)prevUsec + (std::uint64_t)deltaUsec);
+        prevDeltaUsec          = deltaUsec;
+
+        dcgmcm_spill_sample_t sample;
+        sample.timestamp = prevUsec;
+
+        if (!isDouble)
+        {
+            if (!GetVarint(pos, end, encoded))
+                return false;
+            prevBits         = prevBits + (std::uint64_t)UnZigZag(encoded);
+            sample.value.i64 = (long long)prevBits;
+            samples.push_back(sample);
+            continue;
+        }
+
+        if (pos >= end)
+            return false;
+        unsigned char header = *pos++;
+        if (header != XOR_ZERO)
+        {
+            int leading  = header >> 4;
+            int trailing = header & 0xf;
+            if (leading + trailing >= 8 || end - pos < 8 - leading - trailing)
+                return false;
+
+            std::uint64_t xor_ = 0;
+            for (int byte = trailing; byte < 8 - leading; byte++)
+            {
+                xor_ |= (std::uint64_t)(*pos++) << (byte * 8);
+            }
+            prevBits ^= xor_;
+        }
+        memcpy(&sample.value.dbl, &prevBits, sizeof(prevBits));
+        samples.push_back(sample);
+    }
+
+    return pos == end;
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+#include "timelib.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Samples of a series that are compressed and written together */
+#define DCGM_CM_SPILL_BLOCK_SAMPLES 256
+
+/* Largest a segment file grows before the next one is started. Smaller budgets get smaller segments */
+#define DCGM_CM_SPILL_MAX_SEGMENT_BYTES (4 * 1024 * 1024)
+
+/* Disk budget used when none is given */
+#define DCGM_CM_SPILL_DEFAULT_BUDGET_BYTES (1024LL * 1024 * 1024)
+
+/*****************************************************************************/
+/* A numeric sample of a spilled series */
+typedef struct
+{
+    timelib64_t timestamp; /* Sample timestamp in usec since 1970 */
+    union
+    {
+        long long i64;
+        double dbl;
+    } value;
+} dcgmcm_spill_sample_t;
+
+/*****************************************************************************/
+/*
+ * Disk tier of the cache manager's numeric watches. Samples the in-memory
+ * time series ages out are appended here, so that GetSamples() can serve
+ * history older than the cache keeps without a separate time series database.
+ *
+ * Each series (entity and field) is a list of append-only segment files in
+ * one directory, named <entityGroupId>_<entityId>_<fieldId>_<firstUsec>.spill.
+ * A segment is a sequence of blocks of up to DCGM_CM_SPILL_BLOCK_SAMPLES
+ * samples: a fixed header with the block's time range, then the timestamps
+ * as delta-of-deltas and the values as deltas (integers) or XORs (doubles).
+ * The headers are the time index. They are kept in memory and rebuilt from
+ * the files by Open(), so samples spilled before a restart can still be read.
+ * Blocks are read by mapping their segment.
+ *
+ * When the segments take more than the disk budget, the segment whose newest
+ * sample is oldest across all series is deleted first.
+ *
+ * This class is not thread safe. The cache manager only touches it while
+ * holding its lock.
+ */
+class DcgmCacheSpill
+{
+public:
+    /*************************************************************************/
+    /*
+     * directory   IN: Where the segments are kept. Created by Open() if missing
+     * budgetBytes IN: Most bytes the segments may take. <= 0 = DCGM_CM_SPILL_DEFAULT_BUDGET_BYTES
+     */
+    DcgmCacheSpill(std::string directory, long long budgetBytes);
+
+    /* Writes samples that haven't been yet. See Flush() */
+    ~DcgmCacheSpill();
+
+    /*************************************************************************/
+    /*
+     * Create the directory if needed and index the segments already in it.
+     * Later samples go to new segments, so segments cut short by a crash
+     * are only read up to their last whole block.
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_GENERIC_ERROR if the directory can't be created or read
+     */
+    dcgmReturn_t Open();
+
+    /*************************************************************************/
+    /*
+     * Add samples of a series. Samples that aren't newer than the newest one
+     * already spilled are skipped. They are kept in memory until a block is
+     * full.
+     *
+     * isDouble IN: Whether the values are dbl (true) or i64 (false)
+     */
+    void Append(unsigned int entityGroupId,
+                unsigned int entityId,
+                unsigned short fieldId,
+                bool isDouble,
+                dcgmcm_spill_sample_t const *samples,
+                int numSamples);
+
+    /*************************************************************************/
+    /*
+     * Write the samples that are still in memory as short blocks
+     */
+    void Flush();
+
+    /*************************************************************************/
+    /*
+     * Get the timestamp of the oldest sample of a series
+     *
+     * Returns 0 if nothing of the series was spilled
+     */
+    timelib64_t OldestUsec(unsigned int entityGroupId, unsigned int entityId, unsigned short fieldId) const;
+
+    /*************************************************************************/
+    /*
+     * Append samples of the window [startTime, endTime] that are older than
+     * beforeUsec to samples in order. 0 means no limit for startTime and
+     * endTime.
+     *
+     * isDouble OUT: Whether the values are dbl. Only set if samples were read
+     *
+     * Returns the number of samples appended, at most maxSamples
+     */
+    int Read(unsigned int entityGroupId,
+             unsigned int entityId,
+             unsigned short fieldId,
+             timelib64_t startTime,
+             timelib64_t endTime,
+             timelib64_t beforeUsec,
+             dcgmOrder_t order,
+             int maxSamples,
+             std::vector<dcgmcm_spill_sample_t> &samples,
+             bool *isDouble);
+
+    /* Bytes of all segments */
+    long long GetBytesUsed() const;
+
+    /*************************************************************************/
+    /*
+     * Compress samples as a block's payload and back. Public for tests
+     */
+    static void EncodeBlock(bool isDouble, dcgmcm_spill_sample_t const *samples, int numSamples, std::string &payload);
+    static bool DecodeBlock(bool isDouble,
+                            unsigned char const *payload,
+                            size_t payloadBytes,
+                            int numSamples,
+                            std::vector<dcgmcm_spill_sample_t> &samples);
+
+private:
+    struct Block
+    {
+        long long offset; /* Of the block header in its segment */
+        std::uint32_t numSamples;
+        std::uint32_t payloadBytes;
+        timelib64_t firstUsec;
+        timelib64_t lastUsec;
+    };
+
+    struct Segment
+    {
+        std::string path;
+        long long bytes = 0;
+        bool writable   = false; /* Created by this process. Blocks are appended to the newest one */
+        std::vector<Block> blocks;
+    };
+
+    struct Series
+    {
+        unsigned int entityGroupId = 0;
+        unsigned int entityId      = 0;
+        unsigned short fieldId     = 0;
+        bool isDouble              = false;
+        timelib64_t lastUsec       = 0;             /* Newest sample spilled */
+        std::deque<Segment> segments;               /* Ascending by time */
+        std::vector<dcgmcm_spill_sample_t> pending; /* Not written yet */
+    };
+
+    std::string m_directory;
+    long long m_budgetBytes;
+    long long m_segmentBytes; /* When to start a new segment */
+    long long m_bytesUsed = 0;
+    std::unordered_map<std::uint64_t, Series> m_series;
+
+    static std::uint64_t SeriesKey(unsigned int entityGroupId, unsigned int entityId, unsigned short fieldId)
+    {
+        return ((std::uint64_t)entityGroupId << 48) | ((std::uint64_t)fieldId << 32) | entityId;
+    }
+
+    Series const *FindSeries(unsigned int entityGroupId, unsigned int entityId, unsigned short fieldId) const;
+
+    /* Index the blocks of an existing segment file */
+    void IndexSegment(std::string const &path,
+                      unsigned int entityGroupId,
+                      unsigned int entityId,
+                      unsigned short fieldId);
+
+    /* Write the pending samples of series as one block */
+    void WriteBlock(Series &series);
+
+    /* Delete the segments with the oldest data until the budget is met */
+    void EnforceBudget();
+
+    /* Map segment and decode block of it into samples, ascending */
+    bool ReadBlock(Segment const &segment,
+                   Block const &block,
+                   bool isDouble,
+                   std::vector<dcgmcm_spill_sample_t> &samples) const;
+};
@@ -64,12 +64,21 @@ DcgmClientHandler::~DcgmClientHandler()
     }
 
     /* Clear all of the structures that are protected by locks */
+    std::unordered_map<dcgm_request_id_t, AsyncRequest> asyncRequests;
     {
         DcgmLockGuard dlg(&m_mutex);
         m_blockingReqs.clear();
         m_persistentReqs.clear();
+        asyncRequests.swap(m_asyncReqs);
         m_connectionRequests.clear();
     }
+
+    /* Every async request that was sent gets its callback */
+    for (auto &[requestId, asyncRequest] : asyncRequests)
+    {
+        DCGM_LOG_DEBUG << "Failing async requestId " << requestId << " at shutdown";
+        asyncRequest.callback(DCGM_ST_CONNECTION_NOT_VALID, nullptr);
+    }
 }
 
 /*****************************************************************************/
@@ -77,8 +86,15 @@ void DcgmClientHandler::ProcessDisconnect(dcgm_connection_id_t connectionId)
 {
     DCGM_LOG_VERBOSE << "ProcessDisconnect for connectionId " << connectionId;
 
+    for (auto &asyncRequest : TakeAsyncRequests(connectionId))
+    {
+        asyncRequest.callback(DCGM_ST_CONNECTION_NOT_VALID, nullptr);
+    }
+
     DcgmLockGuard dlg(&m_mutex);
 
+    m_attributeCaches.erase(connectionId);
+
     auto it = m_connectionRequests.find(connectionId);
     if (it == m_connectionRequests.end())
     {
@@ -124,9 +140,26 @@ void DcgmClientHandler::ProcessMessage(dcgm_connection_id_t connectionId, std::u
         return;
     }
 
+    /* Notifications belong to the persistent request even while the request that
+       created it is still waiting for its response, since they can arrive first */
+    bool const isNotification = msgHdr->msgType == DCGM_MSG_POLICY_NOTIFY || msgHdr->msgType == DCGM_MSG_FV_STREAM
+                                || msgHdr->msgType == DCGM_MSG_ATTRIBUTE_GENERATION
+                                || msgHdr->msgType == DCGM_MSG_REQUEST_NOTIFY;
+
+    if (!isNotification)
+    {
+        std::optional<AsyncRequest> asyncRequest = TakeAsyncRequest(connectionId, msgHdr->requestId);
+        if (asyncRequest.has_value())
+        {
+            DCGM_LOG_DEBUG << "Found async request for requestId " << msgHdr->requestId;
+            CompleteAsyncRequest(*asyncRequest, std::move(dcgmMessage));
+            return;
+        }
+    }
+
     DcgmLockGuard dlg { &m_mutex };
 
-    auto itB = m_blockingReqs.find(msgHdr->requestId);
+    auto itB = isNotification ? m_blockingReqs.end() : m_blockingReqs.find(msgHdr->requestId);
     if (itB != m_blockingReqs.end())
     {
         DCGM_LOG_DEBUG << "Found blocking request for requestId " << msgHdr->requestId;
@@ -144,6 +177,15 @@ void DcgmClientHandler::ProcessMessage(dcgm_connection_id_t connectionId, std::u
         return;
     }
 
+    if (msgHdr->msgType == DCGM_MSG_REQUEST_NOTIFY)
+    {
+        /* The host engine won't send this request anything else */
+        DCGM_LOG_DEBUG << "Removing completed persistent requestId " << msgHdr->requestId;
+        m_persistentReqs.erase(itP);
+        m_connectionRequests[connectionId].erase(msgHdr->requestId);
+        return;
+    }
+
     DCGM_LOG_DEBUG << "Processed persistent requestId " << msgHdr->requestId;
     itP->second->ProcessMessage(std::move(dcgmMessage));
 }
@@ -167,18 +209,22 @@ dcgmReturn_t DcgmClientHandler::TryConnectingToHostEngine(char identifier[],
                                                           unsigned int portNumber,
                                                           dcgmHandle_t *pDcgmHandle,
                                                           bool addressIsUnixSocket,
-                                                          int connectionTimeoutMs)
+                                                          int connectionTimeoutMs,
+                                                          bool useSharedMemory,
+                                                          unsigned int compression,
+                                                          unsigned int compressionThreshold)
 {
     dcgm_connection_id_t connectionId { DCGM_CONNECTION_ID_NONE };
     dcgmReturn_t dcgmReturn;
 
     if (addressIsUnixSocket)
     {
-        dcgmReturn = m_dcgmIpc.ConnectDomain(identifier, connectionId, connectionTimeoutMs);
+        dcgmReturn = m_dcgmIpc.ConnectDomain(identifier, connectionId, connectionTimeoutMs, useSharedMemory);
     }
     else
     {
-        dcgmReturn = m_dcgmIpc.ConnectTcp(identifier, portNumber, connectionId, connectionTimeoutMs);
+        dcgmReturn = m_dcgmIpc.ConnectTcp(
+            identifier, portNumber, connectionId, connectionTimeoutMs, compression, compressionThreshold);
     }
 
     *pDcgmHandle = (dcgmHandle_t)connectionId;
@@ -191,7 +237,10 @@ dcgmReturn_t DcgmClientHandler::TryConnectingToHostEngine(char identifier[],
 dcgmReturn_t DcgmClientHandler::GetConnHandleForHostEngine(const char *identifier,
                                                            dcgmHandle_t *pDcgmHandle,
                                                            unsigned int timeoutMs,
-                                                           bool addressIsUnixSocket)
+                                                           bool addressIsUnixSocket,
+                                                           bool useSharedMemory,
+                                                           unsigned int compression,
+                                                           unsigned int compressionThreshold)
 {
     if (!timeoutMs)
         timeoutMs = 5000; /* 5-second default timeout */
@@ -237,8 +286,14 @@ dcgmReturn_t DcgmClientHandler::GetConnHandleForHostEngine(const char *identifie
     {
         attempt++;
         if (DCGM_ST_OK
-            == TryConnectingToHostEngine(
-                identifierTemp.data(), portNumber, pDcgmHandle, addressIsUnixSocket, timeoutMs))
+            == TryConnectingToHostEngine(identifierTemp.data(),
+                                         portNumber,
+                                         pDcgmHandle,
+                                         addressIsUnixSocket,
+                                         timeoutMs,
+                                         useSharedMemory,
+                                         compression,
+                                         compressionThreshold))
         {
             connected = true;
             break;
@@ -270,6 +325,30 @@ dcgmReturn_t DcgmClientHandler::GetConnHandleForHostEngine(const char *identifie
     }
 }
 
+/*****************************************************************************/
+dcgmReturn_t DcgmClientHandler::GetSharedConnHandle(dcgmHandle_t dcgmHandle, dcgmHandle_t *pDcgmHandle)
+{
+    dcgm_connection_id_t carrierId    = (dcgm_connection_id_t)dcgmHandle;
+    dcgm_connection_id_t connectionId = DCGM_CONNECTION_ID_NONE;
+
+    if (carrierId == DCGM_CONNECTION_ID_NONE || pDcgmHandle == nullptr)
+    {
+        DCGM_LOG_ERROR << "Bad parameter";
+        return DCGM_ST_BADPARAM;
+    }
+
+    /* Responses come back tagged with connectionId, so requests of the new handle
+       are tracked and cleaned up apart from dcgmHandle's without anything else here */
+    dcgmReturn_t dcgmReturn = m_dcgmIpc.OpenMuxConnection(carrierId, connectionId);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    *pDcgmHandle = (dcgmHandle_t)connectionId;
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************
  * Closes connection to the host engine
  *****************************************************************************/
@@ -286,6 +365,40 @@ void DcgmClientHandler::CloseConnForHostEngine(dcgmHandle_t connHandle)
     m_dcgmIpc.CloseConnection(connectionId);
 }
 
+/*****************************************************************************/
+dcgmReturn_t DcgmClientHandler::GetConnectionStats(dcgmHandle_t dcgmHandle, DcgmIpcConnectionStats_t &stats)
+{
+    dcgm_connection_id_t connectionId = (dcgm_connection_id_t)dcgmHandle;
+
+    if (connectionId == DCGM_CONNECTION_ID_NONE)
+    {
+        DCGM_LOG_ERROR << "null connectionId";
+        return DCGM_ST_BADPARAM;
+    }
+
+    return m_dcgmIpc.GetConnectionStats(connectionId, stats);
+}
+
+/*****************************************************************************/
+std::shared_ptr<DcgmAttributeCache> DcgmClientHandler::GetAttributeCache(dcgmHandle_t dcgmHandle)
+{
+    DcgmLockGuard dlg(&m_mutex);
+
+    auto it = m_attributeCaches.find((dcgm_connection_id_t)dcgmHandle);
+    if (it == m_attributeCaches.end())
+        return nullptr;
+
+    return it->second;
+}
+
+/*****************************************************************************/
+void DcgmClientHandler::SetAttributeCache(dcgmHandle_t dcgmHandle, std::shared_ptr<DcgmAttributeCache> cache)
+{
+    DcgmLockGuard dlg(&m_mutex);
+
+    m_attributeCaches[(dcgm_connection_id_t)dcgmHandle] = std::move(cache);
+}
+
 /*****************************************************************************/
 dcgm_request_id_t DcgmClientHandler::GetNextRequestId()
 {
@@ -368,6 +481,107 @@ void DcgmClientHandler::RemovePersistentRequest(dcgm_connection_id_t connectionI
     m_connectionRequests[connectionId].erase(requestId);
 }
 
+/*****************************************************************************/
+std::optional<DcgmClientHandler::AsyncRequest> DcgmClientHandler::TakeAsyncRequest(dcgm_connection_id_t connectionId,
+                                                                                   dcgm_request_id_t requestId)
+{
+    DcgmLockGuard dlg(&m_mutex);
+    auto it = m_asyncReqs.find(requestId);
+    if (it == m_asyncReqs.end())
+        return std::nullopt;
+
+    AsyncRequest asyncRequest = std::move(it->second);
+    m_asyncReqs.erase(it);
+    m_connectionRequests[connectionId].erase(requestId);
+    return asyncRequest;
+}
+
+/*****************************************************************************/
+std::vector<DcgmClientHandler::AsyncRequest> DcgmClientHandler::TakeAsyncRequests(dcgm_connection_id_t connectionId)
+{
+    std::vector<AsyncRequest> asyncRequests;
+
+    DcgmLockGuard dlg(&m_mutex);
+    auto it = m_connectionRequests.find(connectionId);
+    if (it == m_connectionRequests.end())
+        return asyncRequests;
+
+    for (auto requestIt = it->second.begin(); requestIt != it->second.end();)
+    {
+        auto asyncIt = m_asyncReqs.find(*requestIt);
+        if (asyncIt == m_asyncReqs.end())
+        {
+            ++requestIt;
+            continue;
+        }
+
+        asyncRequests.push_back(std::move(asyncIt->second));
+        m_asyncReqs.erase(asyncIt);
+        requestIt = it->second.erase(requestIt);
+    }
+
+    return asyncRequests;
+}
+
+/*****************************************************************************/
+void DcgmClientHandler::CompleteAsyncRequest(AsyncRequest &asyncRequest, std::unique_ptr<DcgmMessage> response)
+{
+    dcgm_message_header_t *recvHeader = response->GetMessageHdr();
+    auto msgBytes                     = response->GetMsgBytesPtr();
+
+    if (recvHeader->msgType != DCGM_MSG_MODULE_COMMAND)
+    {
+        DCGM_LOG_ERROR << "Unexpected response type " << std::hex << recvHeader->msgType << " to module command.";
+        asyncRequest.callback(DCGM_ST_GENERIC_ERROR, nullptr);
+        return;
+    }
+
+    if (recvHeader->length < (int)sizeof(dcgm_module_command_header_t)
+        || (size_t)recvHeader->length > asyncRequest.maxResponseSize || (size_t)recvHeader->length > msgBytes->size())
+    {
+        DCGM_LOG_ERROR << "Module command response size " << recvHeader->length << " was outside of "
+                       << sizeof(dcgm_module_command_header_t) << " to " << asyncRequest.maxResponseSize;
+        asyncRequest.callback(DCGM_ST_GENERIC_ERROR, nullptr);
+        return;
+    }
+
+    asyncRequest.callback((dcgmReturn_t)recvHeader->status, (dcgm_module_command_header_t *)msgBytes->data());
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmClientHandler::SendModuleCommandAsync(dcgmHandle_t dcgmHandle,
+                                                       dcgm_module_command_header_t *moduleCommand,
+                                                       size_t maxResponseSize,
+                                                       ModuleCommandCallback callback)
+{
+    std::unique_ptr<DcgmMessage> dcgmSendMsg = std::make_unique<DcgmMessage>();
+    dcgm_connection_id_t connectionId        = (dcgm_connection_id_t)dcgmHandle;
+    dcgm_request_id_t requestId              = GetNextRequestId();
+
+    dcgmSendMsg->UpdateMsgHdr(DCGM_MSG_MODULE_COMMAND, requestId, DCGM_ST_OK, moduleCommand->length);
+    auto msgData = dcgmSendMsg->GetMsgBytesPtr();
+    msgData->resize(moduleCommand->length);
+    memcpy(msgData->data(), moduleCommand, moduleCommand->length);
+
+    {
+        DcgmLockGuard dlg(&m_mutex);
+        m_asyncReqs.insert({ requestId, AsyncRequest { maxResponseSize, std::move(callback) } });
+        m_connectionRequests[connectionId].insert(requestId);
+    }
+
+    /* Don't wait. This can be called from callbacks on the thread that processes responses */
+    dcgmReturn_t dcgmReturn = m_dcgmIpc.SendMessage(connectionId, std::move(dcgmSendMsg), false);
+    if (dcgmReturn != DCGM_ST_OK && TakeAsyncRequest(connectionId, requestId).has_value())
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " sending async requestId " << requestId
+                       << " to connectionId " << connectionId;
+        return dcgmReturn;
+    }
+
+    /* If the send failed because the connection closed, the disconnect already invoked the callback */
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmClientHandler::ExchangeModuleCommandAsync(dcgmHandle_t dcgmHandle,
                                                            dcgm_module_command_header_t *moduleCommand,
@@ -450,6 +664,66 @@ dcgmReturn_t DcgmClientHandler::ExchangeModuleCommandAsync(dcgmHandle_t dcgmHand
     return (dcgmReturn_t)recvHeader->status;
 }
 
+/*****************************************************************************/
+dcgmReturn_t DcgmClientHandler::ExchangeModuleCommandBatch(dcgmHandle_t dcgmHandle,
+                                                           std::vector<char> &batch,
+                                                           unsigned int timeoutMs)
+{
+    std::unique_ptr<DcgmMessage> dcgmSendMsg = std::make_unique<DcgmMessage>();
+    dcgm_connection_id_t connectionId        = (dcgm_connection_id_t)dcgmHandle;
+
+    dcgm_request_id_t requestId = GetNextRequestId();
+    auto requestFut             = AddBlockingRequest(connectionId, requestId);
+
+    dcgmSendMsg->UpdateMsgHdr(DCGM_MSG_MODULE_COMMAND_BATCH, requestId, DCGM_ST_OK, batch.size());
+    dcgmSendMsg->GetMsgBytesPtr()->swap(batch);
+
+    dcgmReturn_t retSt = m_dcgmIpc.SendMessage(connectionId, std::move(dcgmSendMsg), true);
+    if (retSt != DCGM_ST_OK)
+    {
+        RemoveBlockingRequest(connectionId, requestId, retSt);
+        return retSt;
+    }
+
+    auto futStatus = requestFut.wait_for(std::chrono::milliseconds(timeoutMs));
+    if (futStatus != std::future_status::ready)
+    {
+        DCGM_LOG_ERROR << "connectionId " << connectionId << " requestId " << requestId << " timed out after "
+                       << timeoutMs << " ms.";
+        RemoveBlockingRequest(connectionId, requestId, std::nullopt);
+        return DCGM_ST_TIMEOUT;
+    }
+
+    auto response = requestFut.get();
+    RemoveBlockingRequest(connectionId, requestId, std::nullopt);
+
+    if (response.dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "connectionId " << connectionId << " requestId " << requestId << " returned "
+                       << errorString(response.dcgmReturn);
+        return response.dcgmReturn;
+    }
+
+    dcgm_message_header_t *recvHeader = response.response->GetMessageHdr();
+    if (recvHeader->msgType != DCGM_MSG_MODULE_COMMAND_BATCH)
+    {
+        DCGM_LOG_ERROR << "Unexpected response type " << std::hex << recvHeader->msgType
+                       << " to module command batch.";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    if (recvHeader->status != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Module command batch returned " << errorString((dcgmReturn_t)recvHeader->status);
+        return (dcgmReturn_t)recvHeader->status;
+    }
+
+    batch.swap(*response.response->GetMsgBytesPtr());
+
+    DCGM_LOG_DEBUG << "Got module command batch response of length " << batch.size();
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmClientHandler::ExchangeMsgAsync(dcgmHandle_t dcgmHandle,
                                                  DcgmProtobuf *pEncodedObj,
@@ -535,3 +809,23 @@ dcgmReturn_t DcgmClientHandler::ExchangeMsgAsync(dcgmHandle_t dcgmHandle,
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************/
+dcgmReturn_t DcgmClientHandler::SendRawMessage(dcgmHandle_t dcgmHandle,
+                                               unsigned int msgType,
+                                               dcgm_request_id_t requestId,
+                                               void *msgData,
+                                               int msgLength)
+{
+    dcgm_connection_id_t connectionId = (dcgm_connection_id_t)dcgmHandle;
+
+    std::unique_ptr<DcgmMessage> dcgmSendMsg = std::make_unique<DcgmMessage>();
+    dcgmSendMsg->UpdateMsgHdr(msgType, requestId, DCGM_ST_OK, msgLength);
+
+    auto msgBytes = dcgmSendMsg->GetMsgBytesPtr();
+    msgBytes->resize(msgLength);
+    memcpy(msgBytes->data(), msgData, msgLength);
+
+    /* Don't wait. This can be called from the thread that processes responses */
+    return m_dcgmIpc.SendMessage(connectionId, std::move(dcgmSendMsg), false);
+}
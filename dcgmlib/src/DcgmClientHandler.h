@@ -15,12 +15,14 @@
  */
 #pragma once
 
+#include "DcgmAttributeCache.h"
 #include "DcgmIpc.h"
 #include "DcgmMutex.h"
 #include "DcgmProtobuf.h"
 #include "DcgmRequest.h"
 #include "dcgm_module_structs.h"
 #include "dcgm_structs.h"
+#include <functional>
 #include <iostream>
 
 typedef struct
@@ -33,6 +35,11 @@ typedef struct
 class DcgmClientHandler
 {
 public:
+    /* Completion of SendModuleCommandAsync. response is the host engine's reply and is
+       only valid during the call and when dcgmReturn is DCGM_ST_OK */
+    using ModuleCommandCallback
+        = std::function<void(dcgmReturn_t dcgmReturn, dcgm_module_command_header_t *response)>;
+
     /*****************************************************************************
      * Constructor/destructor
      *****************************************************************************/
@@ -46,13 +53,40 @@ public:
     dcgmReturn_t GetConnHandleForHostEngine(const char *identifier,
                                             dcgmHandle_t *pDcgmHandle,
                                             unsigned int timeoutMs,
-                                            bool addressIsUnixSocket);
+                                            bool addressIsUnixSocket,
+                                            bool useSharedMemory              = false,
+                                            unsigned int compression          = DCGM_TRANSPORT_COMPRESSION_NONE,
+                                            unsigned int compressionThreshold = 0);
+
+    /*****************************************************************************
+     * Get another handle to the host engine that dcgmHandle is connected to. It
+     * shares the socket of dcgmHandle, but the host engine tracks it as a
+     * connection of its own. Closing dcgmHandle closes it too
+     *****************************************************************************/
+    dcgmReturn_t GetSharedConnHandle(dcgmHandle_t dcgmHandle, dcgmHandle_t *pDcgmHandle);
 
     /*****************************************************************************
      * This method is used to close connection with the Host Engine
      *****************************************************************************/
     void CloseConnForHostEngine(dcgmHandle_t pConnHandle);
 
+    /*****************************************************************************
+     * Get the compression settings and traffic of a connection, as counted by
+     * this process
+     *****************************************************************************/
+    dcgmReturn_t GetConnectionStats(dcgmHandle_t dcgmHandle, DcgmIpcConnectionStats_t &stats);
+
+    /*****************************************************************************
+     * Get the attribute cache of a connection. Returns nullptr if the connection
+     * hasn't enabled one with dcgmClientCacheEnable
+     *****************************************************************************/
+    std::shared_ptr<DcgmAttributeCache> GetAttributeCache(dcgmHandle_t dcgmHandle);
+
+    /*****************************************************************************
+     * Set the attribute cache of a connection. It is dropped when the connection is
+     *****************************************************************************/
+    void SetAttributeCache(dcgmHandle_t dcgmHandle, std::shared_ptr<DcgmAttributeCache> cache);
+
     /*****************************************************************************
      * This method is used to exchange protobuf encoded commands with the Host Engine
      * Used to achieve Async functionality
@@ -77,6 +111,44 @@ public:
                                             size_t maxResponseSize,
                                             unsigned int timeoutMs = 60000);
 
+    /*****************************************************************************
+     * Send a module command without waiting for its response
+     *
+     * callback is invoked once on the thread that processes responses when the
+     * response arrives, or with DCGM_ST_CONNECTION_NOT_VALID if the connection
+     * closes first. It is never invoked when this returns an error. It may send
+     * more requests with this method but must not wait for any
+     *
+     * maxResponseSize IN: Largest response of moduleCommand to accept
+     *
+     *****************************************************************************/
+    dcgmReturn_t SendModuleCommandAsync(dcgmHandle_t dcgmHandle,
+                                        dcgm_module_command_header_t *moduleCommand,
+                                        size_t maxResponseSize,
+                                        ModuleCommandCallback callback);
+
+    /*****************************************************************************
+     * Send a DCGM_MSG_MODULE_COMMAND_BATCH and wait for its response
+     *
+     * batch IN/OUT: dcgm_msg_module_command_batch_t and its entries. Replaced with
+     *               the response on success
+     *
+     *****************************************************************************/
+    dcgmReturn_t ExchangeModuleCommandBatch(dcgmHandle_t dcgmHandle,
+                                            std::vector<char> &batch,
+                                            unsigned int timeoutMs = 60000);
+
+    /*****************************************************************************
+     * Send a message that has no response, like DCGM_MSG_FV_STREAM_ACK. Returns
+     * once the message is queued
+     *
+     *****************************************************************************/
+    dcgmReturn_t SendRawMessage(dcgmHandle_t dcgmHandle,
+                                unsigned int msgType,
+                                dcgm_request_id_t requestId,
+                                void *msgData,
+                                int msgLength);
+
 
 private:
     DcgmIpc m_dcgmIpc;
@@ -91,16 +163,31 @@ private:
        Protected by m_mutex */
     std::unordered_map<dcgm_request_id_t, std::unique_ptr<DcgmRequest>> m_persistentReqs;
 
+    /* Requests of SendModuleCommandAsync that are waiting for their response.
+       Protected by m_mutex */
+    struct AsyncRequest
+    {
+        size_t maxResponseSize;
+        ModuleCommandCallback callback;
+    };
+    std::unordered_map<dcgm_request_id_t, AsyncRequest> m_asyncReqs;
+
     /* A map of connectionId-> set of requestIds. This is here so we can delete outstanding
-        m_blockingReqs and m_persistentReqs entries when a client unexpectedly disconnects.
+        m_blockingReqs, m_persistentReqs and m_asyncReqs entries when a client unexpectedly disconnects.
         Protected by m_mutex */
     std::unordered_map<dcgm_connection_id_t, std::unordered_set<dcgm_request_id_t>> m_connectionRequests;
 
+    /* Attribute caches of the connections that enabled one. Protected by m_mutex */
+    std::unordered_map<dcgm_connection_id_t, std::shared_ptr<DcgmAttributeCache>> m_attributeCaches;
+
     dcgmReturn_t TryConnectingToHostEngine(char identifier[],
                                            unsigned int portNumber,
                                            dcgmHandle_t *pDcgmHandle,
                                            bool addressIsUnixSocket,
-                                           int connectionTimeoutMs);
+                                           int connectionTimeoutMs,
+                                           bool useSharedMemory,
+                                           unsigned int compression,
+                                           unsigned int compressionThreshold);
 
     /*************************************************************************/
     /* Callback functions for DcgmIpc to call */
@@ -129,4 +216,10 @@ private:
     /* Helpers for manipulating m_persistentReqs */
     void AddPersistentRequest(dcgm_connection_id_t connectionId, std::unique_ptr<DcgmRequest> request);
     void RemovePersistentRequest(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId);
+
+    /* Helpers for manipulating m_asyncReqs. Callbacks are invoked after these return
+       so they don't run under m_mutex */
+    std::optional<AsyncRequest> TakeAsyncRequest(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId);
+    std::vector<AsyncRequest> TakeAsyncRequests(dcgm_connection_id_t connectionId);
+    void CompleteAsyncRequest(AsyncRequest &asyncRequest, std::unique_ptr<DcgmMessage> response);
 };
@@ -16,6 +16,7 @@
 #include <chrono>
 #include <mutex>
 #include <thread>
+#include <utility>
 
 #include <dcgm_module_structs.h>
 
@@ -35,6 +36,12 @@ void DcgmCoreCommunication::Init(DcgmCacheManager *cm, DcgmGroupManager *gm)
 {
     m_cacheManagerPtr = cm;
     m_groupManagerPtr = gm;
+
+    m_cacheAccess.version             = dcgmCoreCacheAccess_version;
+    m_cacheAccess.cacheManager        = cm;
+    m_cacheAccess.getLatestSample     = CacheGetLatestSample;
+    m_cacheAccess.getSamples          = CacheGetSamples;
+    m_cacheAccess.getInt64SummaryData = CacheGetInt64SummaryData;
 }
 
 bool DcgmCoreCommunication::IsInitialized() const
@@ -42,6 +49,59 @@ bool DcgmCoreCommunication::IsInitialized() const
     return m_cacheManagerPtr != nullptr && m_groupManagerPtr != nullptr;
 }
 
+dcgmCoreCacheAccess_t const *DcgmCoreCommunication::GetCacheAccess() const
+{
+    return &m_cacheAccess;
+}
+
+dcgmReturn_t DcgmCoreCommunication::CacheGetLatestSample(void *cacheManager,
+                                                         dcgm_field_entity_group_t entityGroupId,
+                                                         dcgm_field_eid_t entityId,
+                                                         unsigned short fieldId,
+                                                         dcgmcm_sample_p sample)
+{
+    return static_cast<DcgmCacheManager *>(cacheManager)
+        ->GetLatestSample(entityGroupId, entityId, fieldId, sample, nullptr);
+}
+
+dcgmReturn_t DcgmCoreCommunication::CacheGetSamples(void *cacheManager,
+                                                    dcgm_field_entity_group_t entityGroupId,
+                                                    dcgm_field_eid_t entityId,
+                                                    unsigned short fieldId,
+                                                    dcgmcm_sample_p samples,
+                                                    int *Msamples,
+                                                    timelib64_t startTime,
+                                                    timelib64_t endTime,
+                                                    dcgmOrder_t order)
+{
+    return static_cast<DcgmCacheManager *>(cacheManager)
+        ->GetSamples(entityGroupId, entityId, fieldId, samples, Msamples, startTime, endTime, order);
+}
+
+dcgmReturn_t DcgmCoreCommunication::CacheGetInt64SummaryData(void *cacheManager,
+                                                             dcgm_field_entity_group_t entityGroupId,
+                                                             dcgm_field_eid_t entityId,
+                                                             unsigned short fieldId,
+                                                             int numSummaryTypes,
+                                                             DcgmcmSummaryType_t *summaryTypes,
+                                                             long long *summaryValues,
+                                                             timelib64_t startTime,
+                                                             timelib64_t endTime,
+                                                             pfUseEntryForSummary pfUseEntryCB,
+                                                             void *userData)
+{
+    return static_cast<DcgmCacheManager *>(cacheManager)->GetInt64SummaryData(entityGroupId,
+                                                                               entityId,
+                                                                               fieldId,
+                                                                               numSummaryTypes,
+                                                                               summaryTypes,
+                                                                               summaryValues,
+                                                                               startTime,
+                                                                               endTime,
+                                                                               pfUseEntryCB,
+                                                                               userData);
+}
+
 dcgmReturn_t DcgmCoreCommunication::ProcessGetGpuIds(dcgm_module_command_header_t *header)
 {
     dcgmCoreGetGpuList_t cgg;
@@ -181,6 +241,12 @@ dcgmReturn_t DcgmCoreCommunication::ProcessGetInt64SummaryData(dcgm_module_comma
 
     memcpy(&gisd, header, sizeof(gisd));
 
+    /* The response holds fewer values than there are summary types */
+    if (gisd.request.summaryCount > DCGM_SUMMARY_SIZE)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
     gisd.response.ret = m_cacheManagerPtr->GetInt64SummaryData(gisd.request.entityGroupId,
                                                                gisd.request.entityId,
                                                                gisd.request.fieldId,
@@ -451,6 +517,41 @@ dcgmReturn_t DcgmCoreCommunication::ProcessGetMultipleLatestLiveSamples(dcgm_mod
     return DCGM_ST_OK;
 }
 
+dcgmReturn_t DcgmCoreCommunication::ProcessGetMultipleSamples(dcgm_module_command_header_t *header)
+{
+    dcgmCoreGetMultipleSamples_t gms;
+
+    if (header == nullptr)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmReturn_t ret = DcgmModule::CheckVersion(header, dcgmCoreGetMultipleSamples_version);
+
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
+    }
+
+    memcpy(&gms, header, sizeof(gms));
+
+    if (gms.response.fvBuffer == nullptr || (gms.request.queries == nullptr && gms.request.numQueries > 0))
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    std::vector<dcgmcm_sample_query_t> queries(gms.request.queries, gms.request.queries + gms.request.numQueries);
+
+    gms.response.ret = m_cacheManagerPtr->GetMultipleSamples(queries,
+                                                             gms.request.startTime,
+                                                             gms.request.endTime,
+                                                             gms.request.maxSamplesPerQuery,
+                                                             gms.response.fvBuffer);
+
+    memcpy(header, &gms, sizeof(gms));
+    return DCGM_ST_OK;
+}
+
 dcgmReturn_t DcgmCoreCommunication::ProcessRemoveFieldWatch(dcgm_module_command_header_t *header)
 {
     dcgmCoreRemoveFieldWatch_t rfw;
@@ -528,8 +629,13 @@ dcgmReturn_t DcgmCoreCommunication::ProcessAppendSamples(dcgm_module_command_hea
     }
 
     memcpy(&as, header, sizeof(as));
-    DcgmFvBuffer fvbuf;
-    fvbuf.SetFromBuffer(as.request.buffer, as.request.bufferSize);
+    if (as.request.fvBuffer == nullptr)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    /* Take the samples so that they're freed here once they're in the cache */
+    DcgmFvBuffer fvbuf(std::move(*as.request.fvBuffer));
 
     as.ret = m_cacheManagerPtr->AppendSamples(&fvbuf);
     memcpy(header, &as, sizeof(as));
@@ -1244,6 +1350,84 @@ dcgmReturn_t DcgmCoreCommunication::ProcessNotifyRequestOfCompletion(dcgm_module
     return DCGM_ST_OK;
 }
 
+dcgmReturn_t DcgmCoreCommunication::ProcessSetModuleDispatch(dcgm_module_command_header_t *header)
+{
+    dcgmCoreSetModuleDispatch_t msg;
+    if (header == nullptr)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmReturn_t ret = DcgmModule::CheckVersion(header, dcgmCoreSetModuleDispatch_version);
+
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
+    }
+
+    memcpy(&msg, header, sizeof(msg));
+
+    msg.response = DcgmHostEngineHandler::Instance()->SetModuleDispatch(
+        msg.request.moduleId, msg.request.commandThreads, msg.request.inlineSubCommands);
+
+    memcpy(header, &msg, sizeof(msg));
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmCoreCommunication::ProcessSetWatchPredicate(dcgm_module_command_header_t *header)
+{
+    dcgmCoreSetWatchPredicate_t msg;
+    if (header == nullptr)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmReturn_t ret = DcgmModule::CheckVersion(header, dcgmCoreSetWatchPredicate_version);
+
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
+    }
+
+    memcpy(&msg, header, sizeof(msg));
+
+    msg.response = m_cacheManagerPtr->SetWatchPredicate(msg.request.entityGroupId,
+                                                        msg.request.entityId,
+                                                        msg.request.fieldId,
+                                                        msg.request.watcherType,
+                                                        msg.request.predicate);
+
+    memcpy(header, &msg, sizeof(msg));
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmCoreCommunication::ProcessSetPredicatesBypassed(dcgm_module_command_header_t *header)
+{
+    dcgmCoreSetPredicatesBypassed_t msg;
+    if (header == nullptr)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmReturn_t ret = DcgmModule::CheckVersion(header, dcgmCoreSetPredicatesBypassed_version);
+
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
+    }
+
+    memcpy(&msg, header, sizeof(msg));
+
+    m_cacheManagerPtr->SetPredicatesBypassed(msg.request.watcherType, msg.request.bypassed);
+    msg.response = DCGM_ST_OK;
+
+    memcpy(header, &msg, sizeof(msg));
+
+    return DCGM_ST_OK;
+}
+
 dcgmReturn_t DcgmCoreCommunication::ProcessPopulateFieldGroupGetAll(dcgm_module_command_header_t *header)
 {
     dcgmCorePopulateFieldGroups_t req;
@@ -1308,8 +1492,6 @@ dcgmReturn_t DcgmCoreCommunication::ProcessGetFieldGroupGetFields(dcgm_module_co
 
 dcgmReturn_t DcgmCoreCommunication::ProcessPopulateGlobalWatchInfo(dcgm_module_command_header_t *header)
 {
-    dcgmCorePopulateGlobalWatchInfo_t gwi = {};
-
     if (header == nullptr)
     {
         return DCGM_ST_BADPARAM;
@@ -1322,35 +1504,32 @@ dcgmReturn_t DcgmCoreCommunication::ProcessPopulateGlobalWatchInfo(dcgm_module_c
         return ret;
     }
 
-    memcpy(&gwi, header, sizeof(gwi));
+    /* Filled in place. The message holds every field's histograms, too much to copy to the stack */
+    auto *gwi = reinterpret_cast<dcgmCorePopulateGlobalWatchInfo_t *>(header);
 
     std::vector<dcgmCoreWatchInfo_t> fields;
 
     std::vector<unsigned short> fieldIds;
 
-    for (size_t i = 0; i < gwi.request.numFieldIds; i++)
+    for (size_t i = 0; i < gwi->request.numFieldIds; i++)
     {
-        fieldIds.push_back(gwi.request.fieldIds[i]);
+        fieldIds.push_back(gwi->request.fieldIds[i]);
     }
 
-    gwi.response.ret = m_cacheManagerPtr->PopulateGlobalWatchInfo(fields, (fieldIds.empty() ? nullptr : &fieldIds));
+    gwi->response.ret = m_cacheManagerPtr->PopulateGlobalWatchInfo(fields, (fieldIds.empty() ? nullptr : &fieldIds));
 
     for (size_t i = 0; i < fields.size(); i++)
     {
-        memcpy(&gwi.response.fields[i], &fields[i], sizeof(fields[i]));
+        memcpy(&gwi->response.fields[i], &fields[i], sizeof(fields[i]));
     }
 
-    gwi.response.numFields = fields.size();
-
-    memcpy(header, &gwi, sizeof(gwi));
+    gwi->response.numFields = fields.size();
 
     return DCGM_ST_OK;
 }
 
 dcgmReturn_t DcgmCoreCommunication::ProcessPopulateGpuWatchInfo(dcgm_module_command_header_t *header)
 {
-    dcgmCorePopulateGpuWatchInfo_t gwi = {};
-
     if (header == nullptr)
     {
         return DCGM_ST_BADPARAM;
@@ -1363,28 +1542,27 @@ dcgmReturn_t DcgmCoreCommunication::ProcessPopulateGpuWatchInfo(dcgm_module_comm
         return ret;
     }
 
-    memcpy(&gwi, header, sizeof(gwi));
+    /* Filled in place. The message holds every field's histograms, too much to copy to the stack */
+    auto *gwi = reinterpret_cast<dcgmCorePopulateGpuWatchInfo_t *>(header);
 
     std::vector<dcgmCoreWatchInfo_t> fields;
 
     std::vector<unsigned short> fieldIds;
 
-    for (size_t i = 0; i < gwi.request.numFieldIds; i++)
+    for (size_t i = 0; i < gwi->request.numFieldIds; i++)
     {
-        fieldIds.push_back(gwi.request.fieldIds[i]);
+        fieldIds.push_back(gwi->request.fieldIds[i]);
     }
 
-    gwi.response.ret = m_cacheManagerPtr->PopulateGpuWatchInfo(
-        fields, gwi.request.gpuIds[0], fieldIds.empty() ? nullptr : &fieldIds);
+    gwi->response.ret = m_cacheManagerPtr->PopulateGpuWatchInfo(
+        fields, gwi->request.gpuIds[0], fieldIds.empty() ? nullptr : &fieldIds);
 
     for (size_t i = 0; i < fields.size(); i++)
     {
-        memcpy(&gwi.response.fields[i], &fields[i], sizeof(fields[i]));
+        memcpy(&gwi->response.fields[i], &fields[i], sizeof(fields[i]));
     }
 
-    gwi.response.numFields = fields.size();
-
-    memcpy(header, &gwi, sizeof(gwi));
+    gwi->response.numFields = fields.size();
 
     return DCGM_ST_OK;
 }
@@ -1475,8 +1653,6 @@ dcgmReturn_t DcgmCoreCommunication::ProcessGetMigInstanceEntityId(dcgm_module_co
 
 dcgmReturn_t DcgmCoreCommunication::ProcessPopulateWatchInfo(dcgm_module_command_header_t *header)
 {
-    dcgmCorePopulateGpuWatchInfo_t gwi = {};
-
     if (header == nullptr)
     {
         return DCGM_ST_BADPARAM;
@@ -1489,27 +1665,26 @@ dcgmReturn_t DcgmCoreCommunication::ProcessPopulateWatchInfo(dcgm_module_command
         return ret;
     }
 
-    memcpy(&gwi, header, sizeof(gwi));
+    /* Filled in place. The message holds every field's histograms, too much to copy to the stack */
+    auto *gwi = reinterpret_cast<dcgmCorePopulateGpuWatchInfo_t *>(header);
 
     std::vector<dcgmCoreWatchInfo_t> fields;
 
     std::vector<unsigned short> fieldIds;
 
-    for (size_t i = 0; i < gwi.request.numFieldIds; i++)
+    for (size_t i = 0; i < gwi->request.numFieldIds; i++)
     {
-        fieldIds.push_back(gwi.request.fieldIds[i]);
+        fieldIds.push_back(gwi->request.fieldIds[i]);
     }
 
-    gwi.response.ret = m_cacheManagerPtr->PopulateWatchInfo(fields, fieldIds.empty() ? nullptr : &fieldIds);
+    gwi->response.ret = m_cacheManagerPtr->PopulateWatchInfo(fields, fieldIds.empty() ? nullptr : &fieldIds);
 
     for (size_t i = 0; i < fields.size(); i++)
     {
-        memcpy(&gwi.response.fields[i], &fields[i], sizeof(fields[i]));
+        memcpy(&gwi->response.fields[i], &fields[i], sizeof(fields[i]));
     }
 
-    gwi.response.numFields = fields.size();
-
-    memcpy(header, &gwi, sizeof(gwi));
+    gwi->response.numFields = fields.size();
 
     return DCGM_ST_OK;
 }
@@ -1590,6 +1765,12 @@ dcgmReturn_t DcgmCoreCommunication::ProcessRequestInCore(dcgm_module_command_hea
             break;
         }
 
+        case DcgmCoreReqIdCMGetMultipleSamples:
+        {
+            ret = ProcessGetMultipleSamples(header);
+            break;
+        }
+
         case DcgmCoreReqIdCMRemoveFieldWatch:
         {
             ret = ProcessRemoveFieldWatch(header);
@@ -1772,6 +1953,24 @@ dcgmReturn_t DcgmCoreCommunication::ProcessRequestInCore(dcgm_module_command_hea
             break;
         }
 
+        case DcgmCoreReqIdSetModuleDispatch:
+        {
+            ret = ProcessSetModuleDispatch(header);
+            break;
+        }
+
+        case DcgmCoreReqIdCMSetWatchPredicate:
+        {
+            ret = ProcessSetWatchPredicate(header);
+            break;
+        }
+
+        case DcgmCoreReqIdCMSetPredicatesBypassed:
+        {
+            ret = ProcessSetPredicatesBypassed(header);
+            break;
+        }
+
         case DcgmCoreReqIdFGMGetFieldGroupFields:
         {
             ret = ProcessGetFieldGroupGetFields(header);
@@ -38,6 +38,7 @@ public:
         , m_groupManagerPtr(nullptr)
         , m_fvBufferCache(nullptr)
         , m_fvbufferCacheSize(0)
+        , m_cacheAccess {}
     {}
 
     ~DcgmCoreCommunication()
@@ -53,6 +54,11 @@ public:
      */
     bool IsInitialized() const;
 
+    /**
+     * @return the direct cache access to pass to modules in dcgmCoreCallbacks_t. Valid once Init() was called
+     */
+    dcgmCoreCacheAccess_t const *GetCacheAccess() const;
+
     /**
      * Process the core module request.
      *
@@ -72,6 +78,37 @@ private:
     char *m_fvBufferCache;
     size_t m_fvbufferCacheSize;
 
+    dcgmCoreCacheAccess_t m_cacheAccess; // Points at m_cacheManagerPtr and the functions below
+
+    /**
+     * The functions of m_cacheAccess
+     */
+    static dcgmReturn_t CacheGetLatestSample(void *cacheManager,
+                                             dcgm_field_entity_group_t entityGroupId,
+                                             dcgm_field_eid_t entityId,
+                                             unsigned short fieldId,
+                                             dcgmcm_sample_p sample);
+    static dcgmReturn_t CacheGetSamples(void *cacheManager,
+                                        dcgm_field_entity_group_t entityGroupId,
+                                        dcgm_field_eid_t entityId,
+                                        unsigned short fieldId,
+                                        dcgmcm_sample_p samples,
+                                        int *Msamples,
+                                        timelib64_t startTime,
+                                        timelib64_t endTime,
+                                        dcgmOrder_t order);
+    static dcgmReturn_t CacheGetInt64SummaryData(void *cacheManager,
+                                                 dcgm_field_entity_group_t entityGroupId,
+                                                 dcgm_field_eid_t entityId,
+                                                 unsigned short fieldId,
+                                                 int numSummaryTypes,
+                                                 DcgmcmSummaryType_t *summaryTypes,
+                                                 long long *summaryValues,
+                                                 timelib64_t startTime,
+                                                 timelib64_t endTime,
+                                                 pfUseEntryForSummary pfUseEntryCB,
+                                                 void *userData);
+
     /**
      * Methods for handling each core module API call
      */
@@ -92,6 +129,10 @@ private:
      * then that means this is a new request and the cached buffer should not be used even if there's data in it.
      */
     dcgmReturn_t ProcessGetMultipleLatestLiveSamples(dcgm_module_command_header_t *header);
+    /*
+     * The samples are appended directly to the caller's DcgmFvBuffer, so there are no follow-on pieces
+     */
+    dcgmReturn_t ProcessGetMultipleSamples(dcgm_module_command_header_t *header);
     dcgmReturn_t ProcessRemoveFieldWatch(dcgm_module_command_header_t *header);
     dcgmReturn_t ProcessGetAllGpuInfo(dcgm_module_command_header_t *header);
     dcgmReturn_t ProcessAppendSamples(dcgm_module_command_header_t *header);
@@ -123,6 +164,9 @@ private:
     dcgmReturn_t ProcessSendModuleCommand(dcgm_module_command_header_t *header);
     dcgmReturn_t ProcessSendRawMessageToClient(dcgm_module_command_header_t *header);
     dcgmReturn_t ProcessNotifyRequestOfCompletion(dcgm_module_command_header_t *header);
+    dcgmReturn_t ProcessSetModuleDispatch(dcgm_module_command_header_t *header);
+    dcgmReturn_t ProcessSetWatchPredicate(dcgm_module_command_header_t *header);
+    dcgmReturn_t ProcessSetPredicatesBypassed(dcgm_module_command_header_t *header);
     dcgmReturn_t ProcessPopulateFieldGroupGetAll(dcgm_module_command_header_t *header);
     dcgmReturn_t ProcessGetFieldGroupGetFields(dcgm_module_command_header_t *header);
     dcgmReturn_t ProcessPopulateGlobalWatchInfo(dcgm_module_command_header_t *header);
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmDerivedField.h"
+
+#include "dcgm_fields.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+/* Deepest that parentheses and unary minuses can nest */
+#define DCGM_DERIVED_FIELD_MAX_NESTING 32
+
+/*****************************************************************************/
+/*
+ * Recursive descent parser that emits the bytecode of each operator after
+ * that of its operands:
+ *
+ *   expression := term (('+' | '-') term)*
+ *   term       := unary (('*' | '/') unary)*
+ *   unary      := '-' unary | primary
+ *   primary    := number | tag | '$' fieldId | '(' expression ')'
+ */
+struct DcgmDerivedField::Parser
+{
+    std::string const &text;
+    DcgmDerivedField &derivedField;
+    std::string &error;
+    size_t pos          = 0;
+    unsigned int depth  = 0; /* Stack depth after the code emitted so far */
+    unsigned int nested = 0;
+
+    Parser(std::string const &text, DcgmDerivedField &derivedField, std::string &error)
+        : text(text)
+        , derivedField(derivedField)
+        , error(error)
+    {}
+
+    bool Fail(std::string const &why)
+    {
+        error = why + " at offset " + std::to_string(pos);
+        return false;
+    }
+
+    char Peek()
+    {
+        while (pos < text.size() && isspace((unsigned char)text[pos]))
+        {
+            pos++;
+        }
+        return pos < text.size() ? text[pos] : '\0';
+    }
+
+    bool Emit(Op op, unsigned short operand = 0)
+    {
+        if (op == Op::PushConstant || op == Op::PushInput)
+        {
+            if (++depth > DCGM_DERIVED_FIELD_MAX_STACK)
+                return Fail("Expression is too deeply nested");
+        }
+        else if (op != Op::Negate)
+        {
+            depth--;
+        }
+
+        derivedField.m_code.push_back({ op, operand });
+        return true;
+    }
+
+    bool ParseExpression()
+    {
+        if (!ParseTerm())
+            return false;
+
+        for (char c = Peek(); c == '+' || c == '-'; c = Peek())
+        {
+            pos++;
+            if (!ParseTerm() || !Emit(c == '+' ? Op::Add : Op::Subtract))
+                return false;
+        }
+        return true;
+    }
+
+    bool ParseTerm()
+    {
+        if (!ParseUnary())
+            return false;
+
+        for (char c = Peek(); c == '*' || c == '/'; c = Peek())
+        {
+            pos++;
+            if (!ParseUnary() || !Emit(c == '*' ? Op::Multiply : Op::Divide))
+                return false;
+        }
+        return true;
+    }
+
+    bool ParseUnary()
+    {
+        if (Peek() != '-')
+            return ParsePrimary();
+
+        pos++;
+        if (++nested > DCGM_DERIVED_FIELD_MAX_NESTING)
+            return Fail("Expression is too deeply nested");
+        bool ok = ParseUnary() && Emit(Op::Negate);
+        nested--;
+        return ok;
+    }
+
+    bool ParsePrimary()
+    {
+        char c = Peek();
+
+        if (c == '(')
+        {
+            pos++;
+            if (++nested > DCGM_DERIVED_FIELD_MAX_NESTING)
+                return Fail("Expression is too deeply nested");
+            if (!ParseExpression())
+                return false;
+            nested--;
+            if (Peek() != ')')
+                return Fail("Expected )");
+            pos++;
+            return true;
+        }
+
+        if (isdigit((unsigned char)c) || c == '.')
+        {
+            char *end    = nullptr;
+            double value = strtod(text.c_str() + pos, &end);
+            if (end == text.c_str() + pos || !std::isfinite(value))
+                return Fail("Bad number");
+            pos = end - text.c_str();
+
+            derivedField.m_constants.push_back(value);
+            return Emit(Op::PushConstant, (unsigned short)(derivedField.m_constants.size() - 1));
+        }
+
+        if (c == '$')
+        {
+            size_t start = ++pos;
+            while (pos < text.size() && isdigit((unsigned char)text[pos]))
+            {
+                pos++;
+            }
+            if (pos == start || pos - start > 5)
+                return Fail("Expected a field ID after $");
+            unsigned long fieldId = strtoul(text.c_str() + start, nullptr, 10);
+            return EmitField(fieldId < DCGM_FI_MAX_FIELDS ? DcgmFieldGetById((unsigned short)fieldId) : nullptr,
+                             text.substr(start - 1, pos - start + 1));
+        }
+
+        if (isalpha((unsigned char)c) || c == '_')
+        {
+            size_t start = pos;
+            while (pos < text.size() && (isalnum((unsigned char)text[pos]) || text[pos] == '_'))
+            {
+                pos++;
+            }
+            std::string tag = text.substr(start, pos - start);
+            return EmitField(DcgmFieldGetByTag(&tag[0]), tag);
+        }
+
+        return Fail(c ? std::string("Unexpected ") + c : std::string("Unexpected end of expression"));
+    }
+
+    bool EmitField(dcgm_field_meta_p fieldMeta, std::string const &name)
+    {
+        if (!fieldMeta)
+            return Fail("Unknown field " + name);
+        if (fieldMeta->fieldType != DCGM_FT_INT64 && fieldMeta->fieldType != DCGM_FT_DOUBLE)
+            return Fail("Field " + name + " isn't numeric");
+        if (fieldMeta->fieldId >= DCGM_FI_FIRST_DERIVED_FIELD_ID && fieldMeta->fieldId <= DCGM_FI_LAST_DERIVED_FIELD_ID)
+            return Fail("Field " + name + " is a derived field");
+
+        std::vector<unsigned short> &inputFieldIds = derivedField.m_inputFieldIds;
+        auto input = std::find(inputFieldIds.begin(), inputFieldIds.end(), fieldMeta->fieldId);
+        if (input == inputFieldIds.end())
+        {
+            if (inputFieldIds.size() >= DCGM_DERIVED_FIELD_MAX_INPUTS)
+                return Fail("Too many fields");
+            input = inputFieldIds.insert(inputFieldIds.end(), fieldMeta->fieldId);
+        }
+
+        return Emit(Op::PushInput, (unsigned short)(input - inputFieldIds.begin()));
+    }
+};
+
+/*****************************************************************************/
+dcgmReturn_t DcgmDerivedField::Compile(std::string const &expression,
+                                       std::unique_ptr<DcgmDerivedField> &derivedField,
+                                       std::string &error)
+{
+    if (expression.size() >= DCGM_DERIVED_FIELD_EXPRESSION_SIZE)
+    {
+        error = "Expression is too long";
+        return DCGM_ST_BADPARAM;
+    }
+
+    auto compiled          = std::make_unique<DcgmDerivedField>();
+    compiled->m_expression = expression;
+
+    Parser parser(expression, *compiled, error);
+    if (!parser.ParseExpression())
+        return DCGM_ST_BADPARAM;
+    if (parser.Peek() != '\0')
+    {
+        parser.Fail(std::string("Unexpected ") + parser.Peek());
+        return DCGM_ST_BADPARAM;
+    }
+
+    derivedField = std::move(compiled);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+double DcgmDerivedField::Evaluate(double const *inputs) const
+{
+    double stack[DCGM_DERIVED_FIELD_MAX_STACK];
+    unsigned int top = 0; /* Number of values on the stack */
+
+    for (Instruction const &instruction : m_code)
+    {
+        switch (instruction.op)
+        {
+            case Op::PushConstant:
+                stack[top++] = m_constants[instruction.operand];
+                break;
+            case Op::PushInput:
+                stack[top++] = inputs[instruction.operand];
+                break;
+            case Op::Add:
+                top--;
+                stack[top - 1] += stack[top];
+                break;
+            case Op::Subtract:
+                top--;
+                stack[top - 1] -= stack[top];
+                break;
+            case Op::Multiply:
+                top--;
+                stack[top - 1] *= stack[top];
+                break;
+            case Op::Divide:
+                top--;
+                stack[top - 1] /= stack[top];
+                break;
+            case Op::Negate:
+                stack[top - 1] = -stack[top - 1];
+                break;
+        }
+    }
+
+    if (top != 1 || !std::isfinite(stack[0]))
+        return DCGM_FP64_BLANK;
+    return stack[0];
+}
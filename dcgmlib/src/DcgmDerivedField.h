@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Deepest the stack of an expression can get while it is evaluated */
+#define DCGM_DERIVED_FIELD_MAX_STACK 32
+
+/*****************************************************************************/
+/*
+ * The expression of a derived field, over other fields of the same entity.
+ * It is compiled once into bytecode for a small stack machine, so evaluating
+ * it on each update of its inputs doesn't parse anything.
+ *
+ * Expressions are made of numbers, + - * /, unary minus and parentheses.
+ * Fields are referred to by tag, like "power_usage / enforced_power_limit * 100",
+ * or by ID, like "$155 / $160 * 100". Only numeric fields that aren't derived
+ * fields themselves can be used.
+ */
+class DcgmDerivedField
+{
+public:
+    /*************************************************************************/
+    /*
+     * Compile expression
+     *
+     * Returns: DCGM_ST_OK with derivedField set
+     *          DCGM_ST_BADPARAM with why in error if expression isn't valid
+     */
+    static dcgmReturn_t Compile(std::string const &expression,
+                                std::unique_ptr<DcgmDerivedField> &derivedField,
+                                std::string &error);
+
+    /* Fields the expression uses, each once, in the order they first appear */
+    std::vector<unsigned short> const &GetInputFieldIds() const
+    {
+        return m_inputFieldIds;
+    }
+
+    std::string const &GetExpression() const
+    {
+        return m_expression;
+    }
+
+    /*************************************************************************/
+    /*
+     * Evaluate the expression with inputs[i] as the value of
+     * GetInputFieldIds()[i]. None of the inputs may be blank.
+     *
+     * Returns DCGM_FP64_BLANK if the result isn't a finite number, like after
+     * a division by 0
+     */
+    double Evaluate(double const *inputs) const;
+
+private:
+    enum class Op : unsigned char
+    {
+        PushConstant, /* Push m_constants[operand] */
+        PushInput,    /* Push inputs[operand] */
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Negate,
+    };
+
+    struct Instruction
+    {
+        Op op;
+        unsigned short operand;
+    };
+
+    struct Parser;
+
+    std::string m_expression;
+    std::vector<Instruction> m_code;
+    std::vector<double> m_constants;
+    std::vector<unsigned short> m_inputFieldIds;
+};
@@ -46,26 +46,26 @@ DcgmFieldGroup::~DcgmFieldGroup()
 }
 
 /*****************************************************************************/
-std::string DcgmFieldGroup::GetName()
+std::string DcgmFieldGroup::GetName() const
 {
     return m_name;
 }
 
 /*****************************************************************************/
-unsigned int DcgmFieldGroup::GetId()
+unsigned int DcgmFieldGroup::GetId() const
 {
     return m_id;
 }
 
 
 /*****************************************************************************/
-void DcgmFieldGroup::GetFieldIds(std::vector<unsigned short> &fieldIds)
+void DcgmFieldGroup::GetFieldIds(std::vector<unsigned short> &fieldIds) const
 {
     fieldIds = m_fieldIds;
 }
 
 /*****************************************************************************/
-DcgmWatcher DcgmFieldGroup::GetWatcher(void)
+DcgmWatcher DcgmFieldGroup::GetWatcher(void) const
 {
     return m_watcher;
 }
@@ -77,27 +77,17 @@ DcgmWatcher DcgmFieldGroup::GetWatcher(void)
 /*****************************************************************************/
 /*****************************************************************************/
 DcgmFieldGroupManager::DcgmFieldGroupManager()
-    : m_lock()
+    : m_fieldGroups(std::make_shared<fieldGroupMap const>())
+    , m_lock()
 {}
 
 
 /*****************************************************************************/
 DcgmFieldGroupManager::~DcgmFieldGroupManager()
 {
-    std::map<unsigned int, DcgmFieldGroup *>::iterator fieldGrpIter;
-    DcgmFieldGroup *fieldGrpObj = 0;
-
+    /* Field group objects are freed once the last snapshot of them goes away */
     Lock();
-
-    /* Free all of our field group objects */
-    for (fieldGrpIter = m_fieldGroups.begin(); fieldGrpIter != m_fieldGroups.end(); fieldGrpIter++)
-    {
-        fieldGrpObj = fieldGrpIter->second;
-
-        delete (fieldGrpObj);
-    }
-    m_fieldGroups.clear();
-
+    PublishFieldGroups(std::make_shared<fieldGroupMap const>());
     Unlock();
 }
 
@@ -115,6 +105,34 @@ int DcgmFieldGroupManager::Unlock()
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+std::shared_ptr<DcgmFieldGroupManager::fieldGroupMap const> DcgmFieldGroupManager::GetFieldGroups() const
+{
+    return std::atomic_load(&m_fieldGroups);
+}
+
+/*****************************************************************************/
+void DcgmFieldGroupManager::PublishFieldGroups(std::shared_ptr<fieldGroupMap const> fieldGroups)
+{
+    std::atomic_store(&m_fieldGroups, std::move(fieldGroups));
+}
+
+/*****************************************************************************/
+std::shared_ptr<DcgmFieldGroup const> DcgmFieldGroupManager::GetFieldGroup(dcgmFieldGrp_t fieldGrp) const
+{
+    unsigned int fieldGrpId = (unsigned int)(uintptr_t)fieldGrp;
+
+    std::shared_ptr<fieldGroupMap const> fieldGroups = GetFieldGroups();
+    fieldGroupMap::const_iterator fieldGrpIter       = fieldGroups->find(fieldGrpId);
+    if (fieldGrpIter == fieldGroups->end())
+    {
+        PRINT_DEBUG("%u", "Field group %u not found", fieldGrpId);
+        return nullptr;
+    }
+
+    return fieldGrpIter->second;
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmFieldGroupManager::AddFieldGroup(std::string name,
                                                   std::vector<unsigned short> &fieldIds,
@@ -122,12 +140,14 @@ dcgmReturn_t DcgmFieldGroupManager::AddFieldGroup(std::string name,
                                                   DcgmWatcher watcher)
 {
     unsigned int newFieldGrpId;
-    std::map<unsigned int, DcgmFieldGroup *>::iterator fieldGrpIter;
+    fieldGroupMap::const_iterator fieldGrpIter;
 
     Lock();
 
+    std::shared_ptr<fieldGroupMap const> fieldGroups = GetFieldGroups();
+
     /* Are we above the max limit for groups? */
-    if (m_fieldGroups.size() >= DCGM_MAX_NUM_FIELD_GROUPS)
+    if (fieldGroups->size() >= DCGM_MAX_NUM_FIELD_GROUPS)
     {
         Unlock();
         PRINT_WARNING("%d", "Too many field groups (%d)", (int)DCGM_MAX_NUM_FIELD_GROUPS);
@@ -135,7 +155,7 @@ dcgmReturn_t DcgmFieldGroupManager::AddFieldGroup(std::string name,
     }
 
     /* See if a field group with the same name already exists */
-    for (fieldGrpIter = m_fieldGroups.begin(); fieldGrpIter != m_fieldGroups.end(); fieldGrpIter++)
+    for (fieldGrpIter = fieldGroups->begin(); fieldGrpIter != fieldGroups->end(); fieldGrpIter++)
     {
         if (fieldGrpIter->second->GetName() == name)
         {
@@ -148,7 +168,9 @@ dcgmReturn_t DcgmFieldGroupManager::AddFieldGroup(std::string name,
     g_nextFieldGrpId++;
     newFieldGrpId = g_nextFieldGrpId;
 
-    m_fieldGroups[newFieldGrpId] = new DcgmFieldGroup(newFieldGrpId, fieldIds, name, watcher);
+    auto newFieldGroups             = std::make_shared<fieldGroupMap>(*fieldGroups);
+    (*newFieldGroups)[newFieldGrpId] = std::make_shared<DcgmFieldGroup const>(newFieldGrpId, fieldIds, name, watcher);
+    PublishFieldGroups(std::move(newFieldGroups));
     if (watcher.connectionId != DCGM_CONNECTION_ID_NONE)
     {
         m_connectionFieldGroupIds[watcher.connectionId][newFieldGrpId] = 1;
@@ -169,14 +191,16 @@ dcgmReturn_t DcgmFieldGroupManager::AddFieldGroup(std::string name,
 dcgmReturn_t DcgmFieldGroupManager::RemoveFieldGroup(dcgmFieldGrp_t fieldGrp, DcgmWatcher callerWatcher)
 {
     unsigned int fieldGrpId;
-    std::map<unsigned int, DcgmFieldGroup *>::iterator fieldGrpIter;
+    fieldGroupMap::const_iterator fieldGrpIter;
     DcgmWatcher fieldGroupWatcher;
 
     Lock();
     fieldGrpId = (unsigned int)(uintptr_t)fieldGrp;
 
-    fieldGrpIter = m_fieldGroups.find(fieldGrpId);
-    if (fieldGrpIter == m_fieldGroups.end())
+    std::shared_ptr<fieldGroupMap const> fieldGroups = GetFieldGroups();
+
+    fieldGrpIter = fieldGroups->find(fieldGrpId);
+    if (fieldGrpIter == fieldGroups->end())
     {
         Unlock();
         PRINT_DEBUG("%u", "Field group %u not found", fieldGrpId);
@@ -223,9 +247,10 @@ dcgmReturn_t DcgmFieldGroupManager::RemoveFieldGroup(dcgmFieldGrp_t fieldGrp, Dc
         }
     }
 
-    /* Remove it */
-    delete fieldGrpIter->second;
-    m_fieldGroups.erase(fieldGrpIter);
+    /* Remove it. Lookups that already have it keep using it until they are done */
+    auto newFieldGroups = std::make_shared<fieldGroupMap>(*fieldGroups);
+    newFieldGroups->erase(fieldGrpId);
+    PublishFieldGroups(std::move(newFieldGroups));
 
     Unlock();
     PRINT_DEBUG("%u", "Removed field group %u", fieldGrpId);
@@ -235,57 +260,35 @@ dcgmReturn_t DcgmFieldGroupManager::RemoveFieldGroup(dcgmFieldGrp_t fieldGrp, Dc
 /*****************************************************************************/
 dcgmReturn_t DcgmFieldGroupManager::GetFieldGroupFields(dcgmFieldGrp_t fieldGrp, std::vector<unsigned short> &fieldIds)
 {
-    unsigned int fieldGrpId;
-    std::map<unsigned int, DcgmFieldGroup *>::iterator fieldGrpIter;
-
     fieldIds.clear();
 
-    Lock();
-    fieldGrpId = (unsigned int)(uintptr_t)fieldGrp;
-
-    fieldGrpIter = m_fieldGroups.find(fieldGrpId);
-    if (fieldGrpIter == m_fieldGroups.end())
+    std::shared_ptr<DcgmFieldGroup const> fieldGrpObj = GetFieldGroup(fieldGrp);
+    if (!fieldGrpObj)
     {
-        Unlock();
-        PRINT_DEBUG("%u", "Field group %u not found", fieldGrpId);
         return DCGM_ST_NO_DATA;
     }
 
-    fieldGrpIter->second->GetFieldIds(fieldIds);
-    Unlock();
+    fieldGrpObj->GetFieldIds(fieldIds);
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
 std::string DcgmFieldGroupManager::GetFieldGroupName(dcgmFieldGrp_t fieldGrp)
 {
-    unsigned int fieldGrpId;
     std::string retStr("");
-    std::map<unsigned int, DcgmFieldGroup *>::iterator fieldGrpIter;
-
-    Lock();
-    fieldGrpId = (unsigned int)(uintptr_t)fieldGrp;
 
-    fieldGrpIter = m_fieldGroups.find(fieldGrpId);
-    if (fieldGrpIter != m_fieldGroups.end())
+    std::shared_ptr<DcgmFieldGroup const> fieldGrpObj = GetFieldGroup(fieldGrp);
+    if (fieldGrpObj)
     {
-        retStr = fieldGrpIter->second->GetName();
-    }
-    else
-    {
-        PRINT_DEBUG("%u", "Field group %u not found", fieldGrpId);
+        retStr = fieldGrpObj->GetName();
     }
 
-    Unlock();
-
     return retStr;
 }
 
 /*****************************************************************************/
 dcgmReturn_t DcgmFieldGroupManager::PopulateFieldGroupInfo(dcgmFieldGroupInfo_t *fieldGroupInfo)
 {
-    std::map<unsigned int, DcgmFieldGroup *>::iterator fieldGrpIter;
-    DcgmFieldGroup *fieldGrpObj = 0;
     std::vector<unsigned short> fieldIds;
     size_t i;
     dcgmFieldGrp_t fieldGrpIdBackup;
@@ -296,24 +299,14 @@ dcgmReturn_t DcgmFieldGroupManager::PopulateFieldGroupInfo(dcgmFieldGroupInfo_t
     fieldGroupInfo->version      = dcgmFieldGroupInfo_version;
     fieldGroupInfo->fieldGroupId = fieldGrpIdBackup;
 
-    unsigned int fieldGrpId = (unsigned int)(uintptr_t)fieldGroupInfo->fieldGroupId;
-
     fieldIds.clear();
 
-    Lock();
-
-
-    fieldGrpIter = m_fieldGroups.find(fieldGrpId);
-    if (fieldGrpIter == m_fieldGroups.end())
+    std::shared_ptr<DcgmFieldGroup const> fieldGrpObj = GetFieldGroup(fieldGroupInfo->fieldGroupId);
+    if (!fieldGrpObj)
     {
-        Unlock();
-        PRINT_DEBUG("%u", "Field group %u not found", fieldGrpId);
         return DCGM_ST_NO_DATA;
     }
 
-
-    fieldGrpObj = fieldGrpIter->second;
-
     fieldGrpObj->GetFieldIds(fieldIds);
 
     fieldGroupInfo->numFieldIds = fieldIds.size();
@@ -326,15 +319,12 @@ dcgmReturn_t DcgmFieldGroupManager::PopulateFieldGroupInfo(dcgmFieldGroupInfo_t
     }
     dcgmStrncpy(fieldGroupInfo->fieldGroupName, fieldGrpObj->GetName().c_str(), sizeof(fieldGroupInfo->fieldGroupName));
 
-    Unlock();
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
 dcgmReturn_t DcgmFieldGroupManager::PopulateFieldGroupGetAll(dcgmAllFieldGroup_t *allGroupInfo)
 {
-    std::map<unsigned int, DcgmFieldGroup *>::iterator fieldGrpIter;
-    DcgmFieldGroup *fieldGrpObj = 0;
     std::vector<unsigned short> fieldIds;
     size_t i;
 
@@ -342,13 +332,11 @@ dcgmReturn_t DcgmFieldGroupManager::PopulateFieldGroupGetAll(dcgmAllFieldGroup_t
     memset(allGroupInfo, 0, sizeof(*allGroupInfo));
     allGroupInfo->version = dcgmAllFieldGroup_version;
 
-    Lock();
+    std::shared_ptr<fieldGroupMap const> fieldGroups = GetFieldGroups();
 
     /* Populate the struct from our field group collection */
-    for (fieldGrpIter = m_fieldGroups.begin(); fieldGrpIter != m_fieldGroups.end(); fieldGrpIter++)
+    for (auto const &[fieldGrpId, fieldGrpObj] : *fieldGroups)
     {
-        fieldGrpObj = fieldGrpIter->second;
-
         fieldGrpObj->GetFieldIds(fieldIds);
 
         allGroupInfo->fieldGroups[allGroupInfo->numFieldGroups].numFieldIds = fieldIds.size();
@@ -368,13 +356,12 @@ dcgmReturn_t DcgmFieldGroupManager::PopulateFieldGroupGetAll(dcgmAllFieldGroup_t
         allGroupInfo->numFieldGroups++;
     }
 
-    Unlock();
     PRINT_DEBUG("%u", "Found %u field groups", allGroupInfo->numFieldGroups);
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-void DcgmFieldGroupManager::OnConnectionRemove(dcgm_connection_id_t connectionId)
+bool DcgmFieldGroupManager::OnConnectionRemove(dcgm_connection_id_t connectionId)
 {
     dcgmReturn_t dcgmReturn;
     fieldGroupConnectionMap::iterator outer_it;
@@ -390,7 +377,7 @@ void DcgmFieldGroupManager::OnConnectionRemove(dcgm_connection_id_t connectionId
     {
         Unlock();
         PRINT_DEBUG("%u", "No field groups found for connectionId %u", connectionId);
-        return;
+        return false;
     }
 
     /* Walk all of the group IDs of this connection and remove the groups */
@@ -413,6 +400,103 @@ void DcgmFieldGroupManager::OnConnectionRemove(dcgm_connection_id_t connectionId
             PRINT_WARNING("%u %d", "RemoveFieldGroup of fieldGroupId %u returned %d.", *uint_it, (int)dcgmReturn);
         }
     }
+
+    return !groupIdsToRemove.empty();
+}
+
+/*****************************************************************************/
+void DcgmFieldGroupManager::GetConnectionFieldGroupIds(dcgm_connection_id_t connectionId,
+                                                       std::vector<unsigned int> &fieldGroupIds)
+{
+    fieldGroupIds.clear();
+
+    std::lock_guard<std::mutex> lockGuard(m_lock);
+
+    auto connectionIt = m_connectionFieldGroupIds.find(connectionId);
+    if (connectionIt == m_connectionFieldGroupIds.end())
+        return;
+
+    for (auto const &[fieldGrpId, unused] : connectionIt->second)
+        fieldGroupIds.push_back(fieldGrpId);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmFieldGroupManager::RestoreFieldGroup(unsigned int fieldGroupId,
+                                                      std::string name,
+                                                      std::vector<unsigned short> &fieldIds,
+                                                      DcgmWatcher watcher)
+{
+    std::lock_guard<std::mutex> lockGuard(m_lock);
+
+    std::shared_ptr<fieldGroupMap const> fieldGroups = GetFieldGroups();
+
+    if (fieldGroups->size() >= DCGM_MAX_NUM_FIELD_GROUPS)
+    {
+        DCGM_LOG_WARNING << "Too many field groups (" << DCGM_MAX_NUM_FIELD_GROUPS << ") to restore " << name;
+        return DCGM_ST_MAX_LIMIT;
+    }
+
+    for (auto const &[fieldGrpId, fieldGrpObj] : *fieldGroups)
+    {
+        if (fieldGrpId == fieldGroupId || fieldGrpObj->GetName() == name)
+        {
+            DCGM_LOG_WARNING << "Can't restore field group " << fieldGroupId << " " << name
+                             << ". Field group " << fieldGrpId << " " << fieldGrpObj->GetName() << " is in the way";
+            return DCGM_ST_DUPLICATE_KEY;
+        }
+    }
+
+    /* New field groups must not reuse the ID */
+    unsigned int lastFieldGrpId = g_nextFieldGrpId;
+    while (lastFieldGrpId < fieldGroupId && !g_nextFieldGrpId.compare_exchange_weak(lastFieldGrpId, fieldGroupId))
+        ;
+
+    auto newFieldGroups = std::make_shared<fieldGroupMap>(*fieldGroups);
+    (*newFieldGroups)[fieldGroupId] = std::make_shared<DcgmFieldGroup const>(fieldGroupId, fieldIds, name, watcher);
+    PublishFieldGroups(std::move(newFieldGroups));
+    if (watcher.connectionId != DCGM_CONNECTION_ID_NONE)
+    {
+        m_connectionFieldGroupIds[watcher.connectionId][fieldGroupId] = 1;
+    }
+
+    DCGM_LOG_DEBUG << "Restored field group id " << fieldGroupId << ", name " << name << ", connectionId "
+                   << watcher.connectionId;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmFieldGroupManager::ChangeConnection(dcgm_connection_id_t connectionId, dcgm_connection_id_t newConnectionId)
+{
+    if (connectionId == newConnectionId)
+        return;
+
+    std::lock_guard<std::mutex> lockGuard(m_lock);
+
+    auto connectionIt = m_connectionFieldGroupIds.find(connectionId);
+    if (connectionIt == m_connectionFieldGroupIds.end())
+        return;
+
+    std::shared_ptr<fieldGroupMap const> fieldGroups = GetFieldGroups();
+    auto newFieldGroups                              = std::make_shared<fieldGroupMap>(*fieldGroups);
+
+    for (auto const &[fieldGrpId, unused] : connectionIt->second)
+    {
+        auto fieldGrpIter = fieldGroups->find(fieldGrpId);
+        if (fieldGrpIter == fieldGroups->end())
+            continue;
+
+        std::vector<unsigned short> fieldIds;
+        fieldGrpIter->second->GetFieldIds(fieldIds);
+        DcgmWatcher watcher  = fieldGrpIter->second->GetWatcher();
+        watcher.connectionId = newConnectionId;
+
+        (*newFieldGroups)[fieldGrpId] = std::make_shared<DcgmFieldGroup const>(
+            fieldGrpId, fieldIds, fieldGrpIter->second->GetName(), watcher);
+        m_connectionFieldGroupIds[newConnectionId][fieldGrpId] = 1;
+    }
+
+    m_connectionFieldGroupIds.erase(connectionId);
+    PublishFieldGroups(std::move(newFieldGroups));
 }
 
 /*****************************************************************************/
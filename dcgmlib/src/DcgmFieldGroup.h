@@ -19,11 +19,12 @@
 #include "DcgmWatcher.h"
 #include "dcgm_structs.h"
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
-/* DCGM field group - Locking is provided by DcgmFieldGroupManager() */
+/* DCGM field group - Immutable once DcgmFieldGroupManager() has published it */
 class DcgmFieldGroup
 {
 public:
@@ -45,28 +46,28 @@ public:
      * fieldIds OUT: Vector to hold the field IDs of this DcgmFieldGroup (passed by ref)
      *
      */
-    void GetFieldIds(std::vector<unsigned short> &fieldIds);
+    void GetFieldIds(std::vector<unsigned short> &fieldIds) const;
 
     /*************************************************************************/
     /*
      * Get the name of this field group
      *
      */
-    std::string GetName(void);
+    std::string GetName(void) const;
 
     /*************************************************************************/
     /*
      * Get the fieldGroupId of this field group
      *
      */
-    unsigned int GetId(void);
+    unsigned int GetId(void) const;
 
     /*************************************************************************/
     /*
      * Get the DcgmWatcher that created this field group
      *
      */
-    DcgmWatcher GetWatcher(void);
+    DcgmWatcher GetWatcher(void) const;
 
     /*************************************************************************/
 
@@ -77,7 +78,13 @@ private:
     DcgmWatcher m_watcher;                  /* Who created this field group */
 };
 
-/* Class for managing all of DcgmFieldGroup instances */
+/*
+ * Class for managing all of DcgmFieldGroup instances
+ *
+ * Field groups are kept in an immutable table that lookups take a snapshot of
+ * without locking. Adding and removing field groups is serialized by m_lock and
+ * publishes a new table.
+ */
 class DcgmFieldGroupManager
 {
 public:
@@ -85,8 +92,11 @@ public:
     ~DcgmFieldGroupManager();
 
 private:
-    std::map<unsigned int, DcgmFieldGroup *> m_fieldGroups;
-    std::mutex m_lock; /* Lock used for accessing table of groups and the objects within them */
+    typedef std::map<unsigned int, std::shared_ptr<DcgmFieldGroup const>> fieldGroupMap;
+
+    /* Only accessed through GetFieldGroups() and PublishFieldGroups() */
+    std::shared_ptr<fieldGroupMap const> m_fieldGroups;
+    std::mutex m_lock; /* Lock held while changing m_fieldGroups and m_connectionFieldGroupIds */
 
     /* Map of [connectionId][fieldGroupId] = 1 (value isn't relevant. if the key exists, the group does) */
     typedef std::map<dcgm_connection_id_t, std::map<unsigned int, unsigned int>> fieldGroupConnectionMap;
@@ -97,6 +107,14 @@ private:
     int Lock();
     int Unlock();
 
+    /* The current table of field groups. It never changes once published */
+    std::shared_ptr<fieldGroupMap const> GetFieldGroups() const;
+
+    /* Replace the table of field groups. Caller holds Lock() */
+    void PublishFieldGroups(std::shared_ptr<fieldGroupMap const> fieldGroups);
+
+    /* Find a field group in the current table. nullptr if it doesn't exist */
+    std::shared_ptr<DcgmFieldGroup const> GetFieldGroup(dcgmFieldGrp_t fieldGrp) const;
 
 public:
     /*************************************************************************/
@@ -170,8 +188,37 @@ public:
 
     /**************************************************************************
      * Handle a client disconnecting
+     *
+     * Returns: Whether any field groups of the client were removed
      *************************************************************************/
-    void OnConnectionRemove(dcgm_connection_id_t connectionId);
+    bool OnConnectionRemove(dcgm_connection_id_t connectionId);
+
+    /*************************************************************************/
+    /*
+     * Get the IDs of the field groups that a connection created
+     */
+    void GetConnectionFieldGroupIds(dcgm_connection_id_t connectionId, std::vector<unsigned int> &fieldGroupIds);
+
+    /*************************************************************************/
+    /*
+     * Recreate a field group under the ID it had before, like one saved in a
+     * state checkpoint.
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_DUPLICATE_KEY if the ID or name is in use
+     *          DCGM_ST_MAX_LIMIT if there are too many field groups
+     */
+    dcgmReturn_t RestoreFieldGroup(unsigned int fieldGroupId,
+                                   std::string name,
+                                   std::vector<unsigned short> &fieldIds,
+                                   DcgmWatcher watcher);
+
+    /*************************************************************************/
+    /*
+     * Hand the field groups of connectionId over to newConnectionId, so that
+     * they are removed when newConnectionId disconnects instead
+     */
+    void ChangeConnection(dcgm_connection_id_t connectionId, dcgm_connection_id_t newConnectionId);
 
     /*************************************************************************/
 };
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmFvStreamManager.h"
+#include "DcgmLogging.h"
+#include "dcgm_fields.h"
+
+#include <algorithm>
+#include <cstring>
+
+/*****************************************************************************/
+DcgmFvStreamManager::DcgmFvStreamManager(SendFn sendFn, BatchFn batchFn)
+    : m_sendFn(std::move(sendFn))
+    , m_batchFn(std::move(batchFn))
+{}
+
+/*****************************************************************************/
+uint64_t DcgmFvStreamManager::PackKey(dcgm_field_entity_group_t entityGroupId,
+                                      dcgm_field_eid_t entityId,
+                                      unsigned short fieldId)
+{
+    return ((uint64_t)(entityGroupId & 0xff) << 48) | ((uint64_t)fieldId << 32) | entityId;
+}
+
+/*****************************************************************************/
+dcgm_fv_stream_key_t DcgmFvStreamManager::UnpackKey(uint64_t key)
+{
+    dcgm_fv_stream_key_t retKey;
+    retKey.entityGroupId = (dcgm_field_entity_group_t)((key >> 48) & 0xff);
+    retKey.fieldId       = (unsigned short)(key >> 32);
+    retKey.entityId      = (dcgm_field_eid_t)key;
+    return retKey;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmFvStreamManager::AddStream(dcgm_connection_id_t connectionId,
+                                            dcgm_request_id_t requestId,
+                                            std::vector<dcgm_fv_stream_key_t> const &keys,
+                                            unsigned int maxBatchesInFlight,
+                                            unsigned int maxPendingValues)
+{
+    auto stream                = std::make_unique<Stream>();
+    stream->connectionId       = connectionId;
+    stream->requestId          = requestId;
+    stream->maxBatchesInFlight = maxBatchesInFlight ? maxBatchesInFlight : DCGM_FV_STREAM_DEFAULT_BATCHES_IN_FLIGHT;
+    stream->maxPendingValues   = maxPendingValues ? maxPendingValues : DCGM_FV_STREAM_DEFAULT_PENDING_VALUES;
+
+    for (auto const &key : keys)
+    {
+        /* The cache manager keeps global fields under DCGM_FE_NONE no matter what entity they were watched for */
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(key.fieldId);
+        if (fieldMeta != nullptr && fieldMeta->scope == DCGM_FS_GLOBAL)
+            stream->keys.push_back(PackKey(DCGM_FE_NONE, 0, key.fieldId));
+        else
+            stream->keys.push_back(PackKey(key.entityGroupId, key.entityId, key.fieldId));
+    }
+
+    std::sort(stream->keys.begin(), stream->keys.end());
+    stream->keys.erase(std::unique(stream->keys.begin(), stream->keys.end()), stream->keys.end());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    StreamId streamId { connectionId, requestId };
+    if (m_streams.count(streamId))
+    {
+        DCGM_LOG_ERROR << "connectionId " << connectionId << " already has a stream for requestId " << requestId;
+        return DCGM_ST_IN_USE;
+    }
+
+    for (uint64_t key : stream->keys)
+    {
+        m_keyToStreams[key].push_back(stream.get());
+        m_keyRefCounts[{ connectionId, key }]++;
+    }
+
+    DCGM_LOG_DEBUG << "Added a stream of " << stream->keys.size() << " keys for connectionId " << connectionId
+                   << ", requestId " << requestId;
+
+    m_streams[streamId] = std::move(stream);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmFvStreamManager::RemoveStreamLocked(std::map<StreamId, std::unique_ptr<Stream>>::iterator it,
+                                             std::vector<dcgm_fv_stream_key_t> *unusedKeys)
+{
+    Stream *stream = it->second.get();
+
+    for (uint64_t key : stream->keys)
+    {
+        auto keyIt = m_keyToStreams.find(key);
+        if (keyIt != m_keyToStreams.end())
+        {
+            auto &streams = keyIt->second;
+            streams.erase(std::remove(streams.begin(), streams.end(), stream), streams.end());
+            if (streams.empty())
+                m_keyToStreams.erase(keyIt);
+        }
+
+        auto refIt = m_keyRefCounts.find({ stream->connectionId, key });
+        if (refIt != m_keyRefCounts.end() && --refIt->second == 0)
+        {
+            m_keyRefCounts.erase(refIt);
+            if (unusedKeys != nullptr)
+                unusedKeys->push_back(UnpackKey(key));
+        }
+    }
+
+    m_streams.erase(it);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmFvStreamManager::RemoveStream(dcgm_connection_id_t connectionId,
+                                               dcgm_request_id_t requestId,
+                                               std::vector<dcgm_fv_stream_key_t> &unusedKeys)
+{
+    /* Wait out any send in progress so nothing reaches the client after this returns */
+    std::lock_guard<std::mutex> sendLock(m_sendMutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_streams.find({ connectionId, requestId });
+    if (it == m_streams.end())
+    {
+        DCGM_LOG_DEBUG << "connectionId " << connectionId << " has no stream for requestId " << requestId;
+        return DCGM_ST_NO_DATA;
+    }
+
+    RemoveStreamLocked(it, &unusedKeys);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmFvStreamManager::OnConnectionRemove(dcgm_connection_id_t connectionId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_streams.lower_bound({ connectionId, 0 });
+    while (it != m_streams.end() && it->first.first == connectionId)
+    {
+        auto next = std::next(it);
+        RemoveStreamLocked(it, nullptr); /* The cache manager removes the connection's watches */
+        it = next;
+    }
+}
+
+/*****************************************************************************/
+size_t DcgmFvStreamManager::GetStreamCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_streams.size();
+}
+
+/*****************************************************************************/
+void DcgmFvStreamManager::TakeBatches(Stream &stream, std::vector<Batch> &batches)
+{
+    dcgmBufferedFvCursor_t cursor = 0;
+    dcgmBufferedFv_t const *fv    = stream.pending.GetNextFv(&cursor);
+
+    while (fv != nullptr)
+    {
+        /* Embedded clients process batches as they are sent */
+        bool const isEmbedded = stream.connectionId == DCGM_CONNECTION_ID_NONE;
+        if (!isEmbedded && stream.batchesInFlight >= stream.maxBatchesInFlight)
+            break;
+
+        Batch batch;
+        batch.connectionId = stream.connectionId;
+        batch.requestId    = stream.requestId;
+        batch.message.resize(sizeof(dcgm_msg_fv_stream_t));
+
+        unsigned int numValues = 0;
+        while (fv != nullptr
+               && (numValues == 0
+                   || batch.message.size() - sizeof(dcgm_msg_fv_stream_t) + fv->length <= DCGM_FV_STREAM_MAX_BATCH_SIZE))
+        {
+            batch.message.insert(batch.message.end(), (char const *)fv, (char const *)fv + fv->length);
+            numValues++;
+            fv = stream.pending.GetNextFv(&cursor);
+        }
+
+        dcgm_msg_fv_stream_t header {};
+        header.version    = dcgm_msg_fv_stream_version;
+        header.numValues  = numValues;
+        header.numDropped = stream.numDropped;
+        header.bufferSize = batch.message.size() - sizeof(header);
+        memcpy(batch.message.data(), &header, sizeof(header));
+
+        stream.numDropped = 0;
+        stream.numPending -= numValues;
+        if (!isEmbedded)
+            stream.batchesInFlight++;
+
+        batches.push_back(std::move(batch));
+    }
+
+    if (fv == nullptr)
+    {
+        stream.pending.Clear();
+        return;
+    }
+
+    /* Keep what didn't fit in the window */
+    size_t bufferSize   = 0;
+    size_t elementCount = 0;
+    stream.pending.GetSize(&bufferSize, &elementCount);
+    char const *start = (char const *)fv;
+    std::vector<char> leftover(start, stream.pending.GetBuffer() + bufferSize);
+    stream.pending.SetFromBuffer(leftover.data(), leftover.size());
+}
+
+/*****************************************************************************/
+void DcgmFvStreamManager::SendBatches(std::vector<Batch> &batches)
+{
+    for (auto &batch : batches)
+    {
+        if (m_batchFn)
+        {
+            m_batchFn(batch.message.data() + sizeof(dcgm_msg_fv_stream_t),
+                      batch.message.size() - sizeof(dcgm_msg_fv_stream_t));
+        }
+
+        dcgmReturn_t dcgmReturn = m_sendFn(batch.connectionId,
+                                           DCGM_MSG_FV_STREAM,
+                                           batch.requestId,
+                                           batch.message.data(),
+                                           (int)batch.message.size(),
+                                           DCGM_ST_OK);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            /* The connection going away cleans up the stream */
+            DCGM_LOG_DEBUG << "Got " << errorString(dcgmReturn) << " sending a batch to connectionId "
+                           << batch.connectionId << ", requestId " << batch.requestId;
+        }
+    }
+}
+
+/*****************************************************************************/
+void DcgmFvStreamManager::OnFvUpdates(DcgmFvBuffer const &fvBuffer)
+{
+    std::vector<Batch> batches;
+    std::lock_guard<std::mutex> sendLock(m_sendMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_streams.empty())
+            return;
+
+        std::vector<Stream *> touched;
+
+        dcgmBufferedFvCursor_t cursor = 0;
+        for (dcgmBufferedFv_t const *fv = fvBuffer.GetNextFv(&cursor); fv != nullptr; fv = fvBuffer.GetNextFv(&cursor))
+        {
+            auto it = m_keyToStreams.find(
+                PackKey((dcgm_field_entity_group_t)fv->entityGroupId, fv->entityId, fv->fieldId));
+            if (it == m_keyToStreams.end())
+                continue;
+
+            for (Stream *stream : it->second)
+            {
+                if (stream->numPending >= stream->maxPendingValues)
+                {
+                    stream->numDropped++;
+                    continue;
+                }
+
+                if (stream->pending.AddFvCopy(fv) == nullptr)
+                {
+                    stream->numDropped++;
+                    continue;
+                }
+
+                if (stream->numPending++ == 0)
+                    touched.push_back(stream);
+            }
+        }
+
+        for (Stream *stream : touched)
+        {
+            TakeBatches(*stream, batches);
+        }
+    }
+
+    SendBatches(batches);
+}
+
+/*****************************************************************************/
+void DcgmFvStreamManager::OnAck(dcgm_connection_id_t connectionId,
+                                dcgm_request_id_t requestId,
+                                unsigned int numBatches)
+{
+    std::vector<Batch> batches;
+    std::lock_guard<std::mutex> sendLock(m_sendMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_streams.find({ connectionId, requestId });
+        if (it == m_streams.end())
+        {
+            /* Acks can cross an unsubscribe */
+            DCGM_LOG_DEBUG << "Ignoring an ack for unknown connectionId " << connectionId << ", requestId "
+                           << requestId;
+            return;
+        }
+
+        Stream &stream         = *it->second;
+        stream.batchesInFlight = numBatches >= stream.batchesInFlight ? 0 : stream.batchesInFlight - numBatches;
+
+        if (stream.numPending > 0)
+            TakeBatches(stream, batches);
+    }
+
+    SendBatches(batches);
+}
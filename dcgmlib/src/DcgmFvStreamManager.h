@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMFVSTREAMMANAGER_H
+#define DCGMFVSTREAMMANAGER_H
+
+#include "DcgmFvBuffer.h"
+#include "DcgmProtocol.h"
+#include "dcgm_structs_internal.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/* Key of one entity + field a stream carries values of */
+typedef struct
+{
+    dcgm_field_entity_group_t entityGroupId;
+    dcgm_field_eid_t entityId;
+    unsigned short fieldId;
+} dcgm_fv_stream_key_t;
+
+/*
+ * Tracks the field value streams of clients (see dcgmFieldValueStreamSubscribe)
+ * and pushes the values the cache manager publishes to them.
+ *
+ * Each stream is identified by the connection and requestId that subscribed it.
+ * Values are pushed as DCGM_MSG_FV_STREAM batches. Remote streams may only have
+ * maxBatchesInFlight batches that the client hasn't acknowledged with
+ * DCGM_MSG_FV_STREAM_ACK. Values that arrive while a stream is at that limit are
+ * held and sent together once it acks, up to maxPendingValues of them. Values
+ * past that are dropped and counted in the next batch. Embedded clients get
+ * their batches synchronously, so their streams aren't limited.
+ *
+ * This class doesn't watch fields itself. The caller watches the keys a stream
+ * needs and unwatches the ones this class reports as no longer used by any
+ * stream of a connection.
+ */
+class DcgmFvStreamManager
+{
+public:
+    /* Sends a message to a client. Has the signature of DcgmHostEngineHandler::SendRawMessageToClient */
+    using SendFn = std::function<dcgmReturn_t(dcgm_connection_id_t connectionId,
+                                              unsigned int msgType,
+                                              dcgm_request_id_t requestId,
+                                              void *msgData,
+                                              int msgLength,
+                                              dcgmReturn_t status)>;
+
+    /* Told about the packed dcgmBufferedFv_t of each batch right before it is sent */
+    using BatchFn = std::function<void(char const *fvs, size_t size)>;
+
+    explicit DcgmFvStreamManager(SendFn sendFn, BatchFn batchFn = nullptr);
+
+    /*************************************************************************/
+    /*
+     * Add a stream
+     *
+     * connectionId       IN: Connection of the client. DCGM_CONNECTION_ID_NONE = embedded
+     * requestId          IN: Request ID the client subscribed with. Batches are sent to it
+     * keys               IN: Entities + fields to send values of
+     * maxBatchesInFlight IN: Flow control window. 0 = DCGM_FV_STREAM_DEFAULT_BATCHES_IN_FLIGHT
+     * maxPendingValues   IN: Most values to hold while the window is full. 0 = DCGM_FV_STREAM_DEFAULT_PENDING_VALUES
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_IN_USE if requestId already has a stream on connectionId
+     */
+    dcgmReturn_t AddStream(dcgm_connection_id_t connectionId,
+                           dcgm_request_id_t requestId,
+                           std::vector<dcgm_fv_stream_key_t> const &keys,
+                           unsigned int maxBatchesInFlight,
+                           unsigned int maxPendingValues);
+
+    /*************************************************************************/
+    /*
+     * Remove a stream. No batch of it is sent once this returns
+     *
+     * unusedKeys OUT: Keys of the stream that no other stream of connectionId uses
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if there was no such stream
+     */
+    dcgmReturn_t RemoveStream(dcgm_connection_id_t connectionId,
+                              dcgm_request_id_t requestId,
+                              std::vector<dcgm_fv_stream_key_t> &unusedKeys);
+
+    /* Forget every stream of a connection that went away */
+    void OnConnectionRemove(dcgm_connection_id_t connectionId);
+
+    /* Handle a DCGM_MSG_FV_STREAM_ACK. Sends held values if the stream has room again */
+    void OnAck(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId, unsigned int numBatches);
+
+    /* Send the values of fvBuffer to the streams that carry them */
+    void OnFvUpdates(DcgmFvBuffer const &fvBuffer);
+
+    /* Number of streams. For tests and logging */
+    size_t GetStreamCount();
+
+private:
+    using StreamId = std::pair<dcgm_connection_id_t, dcgm_request_id_t>;
+
+    struct Stream
+    {
+        dcgm_connection_id_t connectionId;
+        dcgm_request_id_t requestId;
+        std::vector<uint64_t> keys;
+        unsigned int maxBatchesInFlight;
+        unsigned int maxPendingValues;
+        unsigned int batchesInFlight = 0; /* Sent but not acked. Always 0 for embedded clients */
+        unsigned int numPending      = 0; /* Values in pending */
+        unsigned int numDropped      = 0; /* Values dropped since the last batch */
+        DcgmFvBuffer pending;             /* Values not sent yet */
+    };
+
+    /* A batch taken out of a stream, to send once m_mutex is released */
+    struct Batch
+    {
+        dcgm_connection_id_t connectionId;
+        dcgm_request_id_t requestId;
+        std::vector<char> message; /* dcgm_msg_fv_stream_t followed by the buffered fvs */
+    };
+
+    SendFn m_sendFn;
+    BatchFn m_batchFn;
+
+    /* Protects everything below. Never held while sending, since embedded
+       clients' callbacks run inside the send */
+    std::mutex m_mutex;
+    std::map<StreamId, std::unique_ptr<Stream>> m_streams;
+
+    /* Streams by key, for routing values */
+    std::unordered_map<uint64_t, std::vector<Stream *>> m_keyToStreams;
+
+    /* Number of streams of each connection that use each key */
+    std::map<std::pair<dcgm_connection_id_t, uint64_t>, unsigned int> m_keyRefCounts;
+
+    /* Held while taking batches out of streams and sending them, so each
+       stream's batches go out in order. Taken before m_mutex */
+    std::mutex m_sendMutex;
+
+    static uint64_t PackKey(dcgm_field_entity_group_t entityGroupId, dcgm_field_eid_t entityId, unsigned short fieldId);
+    static dcgm_fv_stream_key_t UnpackKey(uint64_t key);
+
+    /* Remove stream from m_streams and the indexes. Caller holds m_mutex */
+    void RemoveStreamLocked(std::map<StreamId, std::unique_ptr<Stream>>::iterator it,
+                            std::vector<dcgm_fv_stream_key_t> *unusedKeys);
+
+    /* Move the pending values of stream into batches if its window allows. Caller holds m_mutex */
+    void TakeBatches(Stream &stream, std::vector<Batch> &batches);
+
+    /* Send batches. Caller holds m_sendMutex but not m_mutex */
+    void SendBatches(std::vector<Batch> &batches);
+};
+
+#endif // DCGMFVSTREAMMANAGER_H
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMFVSTREAMREQUEST_H
+#define DCGMFVSTREAMREQUEST_H
+
+#include "DcgmRequest.h"
+#include "dcgm_structs.h"
+#include <functional>
+
+/*
+ * Client side of a field value stream. Passes the values of each
+ * DCGM_MSG_FV_STREAM batch to the user's callback, then acknowledges the batch
+ * so the host engine can send more.
+ */
+class DcgmFvStreamRequest : public DcgmRequest
+{
+public:
+    /* Acknowledges numBatches processed batches of the stream requestId */
+    using AckFn = std::function<void(dcgm_request_id_t requestId, unsigned int numBatches)>;
+
+    DcgmFvStreamRequest(dcgmFieldValueEntityEnumeration_f callback, void *userData, AckFn ackFn);
+    ~DcgmFvStreamRequest() override = default;
+    int ProcessMessage(std::unique_ptr<DcgmMessage> msg) override;
+
+private:
+    bool m_isAckRecvd;
+    dcgmFieldValueEntityEnumeration_f m_callback;
+    void *m_userData;
+    AckFn m_ackFn;
+
+    /* Pass the values of a DCGM_MSG_FV_STREAM to the callback. Called without the lock held */
+    void DeliverBatch(DcgmMessage &msg);
+};
+
+#endif /* DCGMFVSTREAMREQUEST_H */
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmGpuFieldFetchers.h"
+
+#include <array>
+#include <cstdio>
+
+namespace
+{
+typedef dcgmcm_batched_gpu_values_t const *batched_t;
+
+/*****************************************************************************/
+/* Getters of one integer, like nvmlDeviceGetFanSpeed() */
+template <typename T, nvmlReturn_t (*Getter)(nvmlDevice_t, T *)>
+nvmlReturn_t FetchInt64(nvmlDevice_t nvmlDevice, batched_t, dcgmcm_fetched_value_t &value)
+{
+    T raw {};
+    nvmlReturn_t nvmlReturn = Getter(nvmlDevice, &raw);
+    value.i64               = (long long)raw;
+    return nvmlReturn;
+}
+
+/* Getters of one integer of a kind of thing, like the clock of a clock domain */
+template <typename Kind, Kind kind, nvmlReturn_t (*Getter)(nvmlDevice_t, Kind, unsigned int *)>
+nvmlReturn_t FetchInt64Of(nvmlDevice_t nvmlDevice, batched_t, dcgmcm_fetched_value_t &value)
+{
+    unsigned int raw        = 0;
+    nvmlReturn_t nvmlReturn = Getter(nvmlDevice, kind, &raw);
+    value.i64               = (long long)raw;
+    return nvmlReturn;
+}
+
+/* Getters of a string, like nvmlDeviceGetSerial() */
+template <nvmlReturn_t (*Getter)(nvmlDevice_t, char *, unsigned int)>
+nvmlReturn_t FetchString(nvmlDevice_t nvmlDevice, batched_t, dcgmcm_fetched_value_t &value)
+{
+    return Getter(nvmlDevice, value.str, sizeof(value.str));
+}
+
+template <nvmlInforomObject_t object>
+nvmlReturn_t FetchInforomVersion(nvmlDevice_t nvmlDevice, batched_t, dcgmcm_fetched_value_t &value)
+{
+    return nvmlDeviceGetInforomVersion(nvmlDevice, object, value.str, sizeof(value.str));
+}
+
+/* Power limits come in milliwatts and have always been reported in whole watts */
+template <nvmlReturn_t (*Getter)(nvmlDevice_t, unsigned int *)>
+nvmlReturn_t FetchPowerLimit(nvmlDevice_t nvmlDevice, batched_t, dcgmcm_fetched_value_t &value)
+{
+    unsigned int milliwatts = 0;
+    nvmlReturn_t nvmlReturn = Getter(nvmlDevice, &milliwatts);
+    value.dbl               = milliwatts / 1000;
+    return nvmlReturn;
+}
+
+nvmlReturn_t FetchPowerUsage(nvmlDevice_t nvmlDevice, batched_t, dcgmcm_fetched_value_t &value)
+{
+    unsigned int milliwatts = 0;
+    nvmlReturn_t nvmlReturn = nvmlDeviceGetPowerUsage(nvmlDevice, &milliwatts);
+    value.dbl               = ((double)milliwatts) / 1000.0; /* Convert to watts */
+    return nvmlReturn;
+}
+
+/* nvmlDeviceGetEncoderUtilization() and nvmlDeviceGetDecoderUtilization() */
+template <nvmlReturn_t (*Getter)(nvmlDevice_t, unsigned int *, unsigned int *)>
+nvmlReturn_t FetchCodecUtilization(nvmlDevice_t nvmlDevice, batched_t, dcgmcm_fetched_value_t &value)
+{
+    unsigned int utilization      = 0;
+    unsigned int samplingPeriodUs = 0;
+    nvmlReturn_t nvmlReturn       = Getter(nvmlDevice, &utilization, &samplingPeriodUs);
+    value.i64                     = utilization;
+    return nvmlReturn;
+}
+
+nvmlReturn_t FetchAutoBoost(nvmlDevice_t nvmlDevice, batched_t, dcgmcm_fetched_value_t &value)
+{
+    nvmlEnableState_t isEnabled        = NVML_FEATURE_DISABLED;
+    nvmlEnableState_t defaultIsEnabled = NVML_FEATURE_DISABLED;
+
+    nvmlReturn_t nvmlReturn = nvmlDeviceGetAutoBoostedClocksEnabled(nvmlDevice, &isEnabled, &defaultIsEnabled);
+    value.i64               = isEnabled;
+    return nvmlReturn;
+}
+
+/*****************************************************************************/
+/* Readers of the output of a batched getter */
+template <unsigned int nvmlUtilization_t::*Member>
+nvmlReturn_t FetchUtilization(nvmlDevice_t, batched_t batched, dcgmcm_fetched_value_t &value)
+{
+    value.i64 = batched->utilization.*Member;
+    return NVML_SUCCESS;
+}
+
+template <unsigned long long nvmlMemory_t::*Member>
+nvmlReturn_t FetchFbMemory(nvmlDevice_t, batched_t batched, dcgmcm_fetched_value_t &value)
+{
+    value.i64 = (long long)(batched->memory.*Member / (1024 * 1024)); /* MiB */
+    return NVML_SUCCESS;
+}
+
+template <unsigned long long nvmlBAR1Memory_t::*Member>
+nvmlReturn_t FetchBar1Memory(nvmlDevice_t, batched_t batched, dcgmcm_fetched_value_t &value)
+{
+    value.i64 = (long long)(batched->bar1Memory.*Member / (1024 * 1024)); /* MiB */
+    return NVML_SUCCESS;
+}
+
+nvmlReturn_t FetchPciBusId(nvmlDevice_t, batched_t batched, dcgmcm_fetched_value_t &value)
+{
+    snprintf(value.str, sizeof(value.str), "%s", batched->pciInfo.busId);
+    return NVML_SUCCESS;
+}
+
+template <unsigned int nvmlPciInfo_t::*Member>
+nvmlReturn_t FetchPciId(nvmlDevice_t, batched_t batched, dcgmcm_fetched_value_t &value)
+{
+    value.i64 = batched->pciInfo.*Member;
+    return NVML_SUCCESS;
+}
+
+template <unsigned int dcgmcm_batched_gpu_values_t::*Member>
+nvmlReturn_t FetchPowerLimitConstraint(nvmlDevice_t, batched_t batched, dcgmcm_fetched_value_t &value)
+{
+    value.dbl = batched->*Member / 1000; /* Whole watts like FetchPowerLimit() */
+    return NVML_SUCCESS;
+}
+
+/*****************************************************************************/
+constexpr dcgmcm_gpu_field_fetcher_t Own(unsigned short fieldId, char fieldType, dcgmcm_fetch_f fetch)
+{
+    return { fieldId, fieldType, DcgmcmBatchedCount, NVML_SAMPLINGTYPE_COUNT, 1.0, fetch };
+}
+
+constexpr dcgmcm_gpu_field_fetcher_t Shared(unsigned short fieldId,
+                                            char fieldType,
+                                            dcgmcm_batched_getter_t batch,
+                                            dcgmcm_fetch_f fetch)
+{
+    return { fieldId, fieldType, batch, NVML_SAMPLINGTYPE_COUNT, 1.0, fetch };
+}
+
+constexpr dcgmcm_gpu_field_fetcher_t Sampled(dcgmcm_gpu_field_fetcher_t fetcher,
+                                             nvmlSamplingType_t samplingType,
+                                             double sampleDivisor)
+{
+    fetcher.samplingType  = samplingType;
+    fetcher.sampleDivisor = sampleDivisor;
+    return fetcher;
+}
+
+// clang-format off
+constexpr dcgmcm_gpu_field_fetcher_t c_fetchers[] = {
+    Own(DCGM_FI_DEV_SERIAL,               DCGM_FT_STRING, FetchString<nvmlDeviceGetSerial>),
+    Own(DCGM_FI_DEV_VBIOS_VERSION,        DCGM_FT_STRING, FetchString<nvmlDeviceGetVbiosVersion>),
+    Own(DCGM_FI_DEV_INFOROM_IMAGE_VER,    DCGM_FT_STRING, FetchString<nvmlDeviceGetInforomImageVersion>),
+    Own(DCGM_FI_DEV_OEM_INFOROM_VER,      DCGM_FT_STRING, FetchInforomVersion<NVML_INFOROM_OEM>),
+    Own(DCGM_FI_DEV_ECC_INFOROM_VER,      DCGM_FT_STRING, FetchInforomVersion<NVML_INFOROM_ECC>),
+    Own(DCGM_FI_DEV_POWER_INFOROM_VER,    DCGM_FT_STRING, FetchInforomVersion<NVML_INFOROM_POWER>),
+    Own(DCGM_FI_DEV_INFOROM_CONFIG_CHECK, DCGM_FT_INT64,
+        FetchInt64<unsigned int, nvmlDeviceGetInforomConfigurationChecksum>),
+
+    Own(DCGM_FI_DEV_GPU_TEMP, DCGM_FT_INT64,
+        FetchInt64Of<nvmlTemperatureSensors_t, NVML_TEMPERATURE_GPU, nvmlDeviceGetTemperature>),
+    Own(DCGM_FI_DEV_GPU_MAX_OP_TEMP, DCGM_FT_INT64,
+        FetchInt64Of<nvmlTemperatureThresholds_t, NVML_TEMPERATURE_THRESHOLD_GPU_MAX,
+                     nvmlDeviceGetTemperatureThreshold>),
+    Own(DCGM_FI_DEV_MEM_MAX_OP_TEMP, DCGM_FT_INT64,
+        FetchInt64Of<nvmlTemperatureThresholds_t, NVML_TEMPERATURE_THRESHOLD_MEM_MAX,
+                     nvmlDeviceGetTemperatureThreshold>),
+    Own(DCGM_FI_DEV_SLOWDOWN_TEMP, DCGM_FT_INT64,
+        FetchInt64Of<nvmlTemperatureThresholds_t, NVML_TEMPERATURE_THRESHOLD_SLOWDOWN,
+                     nvmlDeviceGetTemperatureThreshold>),
+    Own(DCGM_FI_DEV_SHUTDOWN_TEMP, DCGM_FT_INT64,
+        FetchInt64Of<nvmlTemperatureThresholds_t, NVML_TEMPERATURE_THRESHOLD_SHUTDOWN,
+                     nvmlDeviceGetTemperatureThreshold>),
+    Own(DCGM_FI_DEV_FAN_SPEED, DCGM_FT_INT64, FetchInt64<unsigned int, nvmlDeviceGetFanSpeed>),
+
+    /* NVML has no call that returns several clocks, so each clock is its own call */
+    Own(DCGM_FI_DEV_SM_CLOCK, DCGM_FT_INT64,
+        FetchInt64Of<nvmlClockType_t, NVML_CLOCK_SM, nvmlDeviceGetClockInfo>),
+    Own(DCGM_FI_DEV_MEM_CLOCK, DCGM_FT_INT64,
+        FetchInt64Of<nvmlClockType_t, NVML_CLOCK_MEM, nvmlDeviceGetClockInfo>),
+    Own(DCGM_FI_DEV_VIDEO_CLOCK, DCGM_FT_INT64,
+        FetchInt64Of<nvmlClockType_t, NVML_CLOCK_VIDEO, nvmlDeviceGetClockInfo>),
+    Own(DCGM_FI_DEV_MAX_SM_CLOCK, DCGM_FT_INT64,
+        FetchInt64Of<nvmlClockType_t, NVML_CLOCK_SM, nvmlDeviceGetMaxClockInfo>),
+    Own(DCGM_FI_DEV_MAX_MEM_CLOCK, DCGM_FT_INT64,
+        FetchInt64Of<nvmlClockType_t, NVML_CLOCK_MEM, nvmlDeviceGetMaxClockInfo>),
+    Own(DCGM_FI_DEV_MAX_VIDEO_CLOCK, DCGM_FT_INT64,
+        FetchInt64Of<nvmlClockType_t, NVML_CLOCK_VIDEO, nvmlDeviceGetMaxClockInfo>),
+    Own(DCGM_FI_DEV_APP_SM_CLOCK, DCGM_FT_INT64,
+        FetchInt64Of<nvmlClockType_t, NVML_CLOCK_GRAPHICS, nvmlDeviceGetApplicationsClock>),
+    Own(DCGM_FI_DEV_APP_MEM_CLOCK, DCGM_FT_INT64,
+        FetchInt64Of<nvmlClockType_t, NVML_CLOCK_MEM, nvmlDeviceGetApplicationsClock>),
+    Own(DCGM_FI_DEV_CLOCK_THROTTLE_REASONS, DCGM_FT_INT64,
+        FetchInt64<unsigned long long, nvmlDeviceGetCurrentClocksThrottleReasons>),
+    Own(DCGM_FI_DEV_AUTOBOOST, DCGM_FT_INT64, FetchAutoBoost),
+    Own(DCGM_FI_DEV_PSTATE,    DCGM_FT_INT64, FetchInt64<nvmlPstates_t, nvmlDeviceGetPerformanceState>),
+
+    Own(DCGM_FI_DEV_PCIE_REPLAY_COUNTER, DCGM_FT_INT64, FetchInt64<unsigned int, nvmlDeviceGetPcieReplayCounter>),
+    Own(DCGM_FI_DEV_PCIE_MAX_LINK_GEN,   DCGM_FT_INT64, FetchInt64<unsigned int, nvmlDeviceGetMaxPcieLinkGeneration>),
+    Own(DCGM_FI_DEV_PCIE_MAX_LINK_WIDTH, DCGM_FT_INT64, FetchInt64<unsigned int, nvmlDeviceGetMaxPcieLinkWidth>),
+    Own(DCGM_FI_DEV_PCIE_LINK_GEN,       DCGM_FT_INT64, FetchInt64<unsigned int, nvmlDeviceGetCurrPcieLinkGeneration>),
+    Own(DCGM_FI_DEV_PCIE_LINK_WIDTH,     DCGM_FT_INT64, FetchInt64<unsigned int, nvmlDeviceGetCurrPcieLinkWidth>),
+    Shared(DCGM_FI_DEV_PCI_BUSID,        DCGM_FT_STRING, DcgmcmBatchedPciInfo, FetchPciBusId),
+    Shared(DCGM_FI_DEV_PCI_COMBINED_ID,  DCGM_FT_INT64, DcgmcmBatchedPciInfo, FetchPciId<&nvmlPciInfo_t::pciDeviceId>),
+    Shared(DCGM_FI_DEV_PCI_SUBSYS_ID,    DCGM_FT_INT64, DcgmcmBatchedPciInfo,
+           FetchPciId<&nvmlPciInfo_t::pciSubSystemId>),
+
+    Sampled(Own(DCGM_FI_DEV_POWER_USAGE, DCGM_FT_DOUBLE, FetchPowerUsage), NVML_TOTAL_POWER_SAMPLES, 1000.0),
+    Own(DCGM_FI_DEV_POWER_MGMT_LIMIT, DCGM_FT_DOUBLE, FetchPowerLimit<nvmlDeviceGetPowerManagementLimit>),
+    Own(DCGM_FI_DEV_POWER_MGMT_LIMIT_DEF, DCGM_FT_DOUBLE, FetchPowerLimit<nvmlDeviceGetPowerManagementDefaultLimit>),
+    Own(DCGM_FI_DEV_ENFORCED_POWER_LIMIT, DCGM_FT_DOUBLE, FetchPowerLimit<nvmlDeviceGetEnforcedPowerLimit>),
+    Shared(DCGM_FI_DEV_POWER_MGMT_LIMIT_MIN, DCGM_FT_DOUBLE, DcgmcmBatchedPowerLimitConstraints,
+           FetchPowerLimitConstraint<&dcgmcm_batched_gpu_values_t::powerLimitMin>),
+    Shared(DCGM_FI_DEV_POWER_MGMT_LIMIT_MAX, DCGM_FT_DOUBLE, DcgmcmBatchedPowerLimitConstraints,
+           FetchPowerLimitConstraint<&dcgmcm_batched_gpu_values_t::powerLimitMax>),
+
+    Sampled(Shared(DCGM_FI_DEV_GPU_UTIL, DCGM_FT_INT64, DcgmcmBatchedUtilization,
+                   FetchUtilization<&nvmlUtilization_t::gpu>),
+            NVML_GPU_UTILIZATION_SAMPLES, 1.0),
+    Sampled(Shared(DCGM_FI_DEV_MEM_COPY_UTIL, DCGM_FT_INT64, DcgmcmBatchedUtilization,
+                   FetchUtilization<&nvmlUtilization_t::memory>),
+            NVML_MEMORY_UTILIZATION_SAMPLES, 1.0),
+    Sampled(Own(DCGM_FI_DEV_ENC_UTIL, DCGM_FT_INT64, FetchCodecUtilization<nvmlDeviceGetEncoderUtilization>),
+            NVML_ENC_UTILIZATION_SAMPLES, 1.0),
+    Sampled(Own(DCGM_FI_DEV_DEC_UTIL, DCGM_FT_INT64, FetchCodecUtilization<nvmlDeviceGetDecoderUtilization>),
+            NVML_DEC_UTILIZATION_SAMPLES, 1.0),
+
+    Shared(DCGM_FI_DEV_FB_TOTAL,   DCGM_FT_INT64, DcgmcmBatchedMemoryInfo, FetchFbMemory<&nvmlMemory_t::total>),
+    Shared(DCGM_FI_DEV_FB_USED,    DCGM_FT_INT64, DcgmcmBatchedMemoryInfo, FetchFbMemory<&nvmlMemory_t::used>),
+    Shared(DCGM_FI_DEV_FB_FREE,    DCGM_FT_INT64, DcgmcmBatchedMemoryInfo, FetchFbMemory<&nvmlMemory_t::free>),
+    Shared(DCGM_FI_DEV_BAR1_TOTAL, DCGM_FT_INT64, DcgmcmBatchedBar1MemoryInfo,
+           FetchBar1Memory<&nvmlBAR1Memory_t::bar1Total>),
+    Shared(DCGM_FI_DEV_BAR1_USED,  DCGM_FT_INT64, DcgmcmBatchedBar1MemoryInfo,
+           FetchBar1Memory<&nvmlBAR1Memory_t::bar1Used>),
+    Shared(DCGM_FI_DEV_BAR1_FREE,  DCGM_FT_INT64, DcgmcmBatchedBar1MemoryInfo,
+           FetchBar1Memory<&nvmlBAR1Memory_t::bar1Free>),
+};
+// clang-format on
+} // namespace
+
+/*****************************************************************************/
+dcgmcm_gpu_field_fetcher_t const *DcgmcmGetGpuFieldFetcher(unsigned short fieldId)
+{
+    static std::array<dcgmcm_gpu_field_fetcher_t const *, DCGM_FI_MAX_FIELDS> const byFieldId = [] {
+        std::array<dcgmcm_gpu_field_fetcher_t const *, DCGM_FI_MAX_FIELDS> fetchers {};
+        for (auto const &fetcher : c_fetchers)
+            fetchers[fetcher.fieldId] = &fetcher;
+        return fetchers;
+    }();
+
+    if (fieldId >= DCGM_FI_MAX_FIELDS)
+        return nullptr;
+    return byFieldId[fieldId];
+}
+
+/*****************************************************************************/
+nvmlReturn_t DcgmcmGetFieldValues(nvmlDevice_t nvmlDevice,
+                                  int numFields,
+                                  nvmlFieldValue_t *values,
+                                  long long &driverCallsSaved)
+{
+    nvmlReturn_t nvmlReturn = nvmlDeviceGetFieldValues(nvmlDevice, numFields, values);
+    if (nvmlReturn == NVML_SUCCESS)
+        driverCallsSaved += numFields - 1;
+    return nvmlReturn;
+}
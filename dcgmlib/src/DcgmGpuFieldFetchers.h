@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "DcgmCacheManager.h"
+
+/*****************************************************************************/
+/* Value read by a fetcher. Only the member of the fetcher's fieldType is set */
+typedef struct
+{
+    long long i64;                 /* DCGM_FT_INT64 */
+    double dbl;                    /* DCGM_FT_DOUBLE */
+    char str[DCGM_MAX_STR_LENGTH]; /* DCGM_FT_STRING */
+} dcgmcm_fetched_value_t;
+
+/*
+ * Read one field of a GPU. If the fetcher has a batched getter, batched holds
+ * its output and the getter succeeded. Otherwise batched is nullptr and the
+ * fetcher calls NVML on nvmlDevice itself, which is then never nullptr
+ */
+typedef nvmlReturn_t (*dcgmcm_fetch_f)(nvmlDevice_t nvmlDevice,
+                                       dcgmcm_batched_gpu_values_t const *batched,
+                                       dcgmcm_fetched_value_t &value);
+
+/*****************************************************************************/
+/*
+ * How the cache manager reads one GPU field. Fields whose value is one NVML
+ * call and a conversion are read this way rather than by a case of
+ * DcgmCacheManager::BufferOrCacheLatestGpuValue(), which then takes care of
+ * the watch status, blank values on errors and appending the value for all
+ * of them
+ */
+typedef struct dcgmcm_gpu_field_fetcher_t
+{
+    unsigned short fieldId;
+    char fieldType;                  /* DCGM_FT_INT64, DCGM_FT_DOUBLE or DCGM_FT_STRING */
+    dcgmcm_batched_getter_t batch;   /* Shared driver call that fetch reads the output of, or
+                                        DcgmcmBatchedCount if fetch makes its own call */
+    nvmlSamplingType_t samplingType; /* Driver buffered samples to read before calling fetch, or
+                                        NVML_SAMPLINGTYPE_COUNT if the driver doesn't buffer the field */
+    double sampleDivisor;            /* Divisor of the buffered samples. See AppendBufferedSamples() */
+    dcgmcm_fetch_f fetch;
+} dcgmcm_gpu_field_fetcher_t;
+
+/*****************************************************************************/
+/*
+ * Get the fetcher of fieldId
+ *
+ * Returns: The fetcher of fieldId
+ *          nullptr if fieldId isn't read by a fetcher
+ */
+dcgmcm_gpu_field_fetcher_t const *DcgmcmGetGpuFieldFetcher(unsigned short fieldId);
+
+/*****************************************************************************/
+/*
+ * Read numFields NVML field values of nvmlDevice with one
+ * nvmlDeviceGetFieldValues() call. The fieldId of each of values must be set.
+ * If the call succeeds, the numFields - 1 calls it saved are added to
+ * driverCallsSaved
+ *
+ * Returns: The nvmlReturn_t of nvmlDeviceGetFieldValues()
+ */
+nvmlReturn_t DcgmcmGetFieldValues(nvmlDevice_t nvmlDevice,
+                                  int numFields,
+                                  nvmlFieldValue_t *values,
+                                  long long &driverCallsSaved);
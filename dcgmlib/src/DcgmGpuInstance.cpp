@@ -99,6 +99,12 @@ DcgmNs::Mig::GpuInstanceId const &DcgmGpuInstance::GetInstanceId() const
     return m_dcgmInstanceId;
 }
 
+/*****************************************************************************/
+void DcgmGpuInstance::SetInstanceId(DcgmNs::Mig::GpuInstanceId const &dcgmInstanceId)
+{
+    m_dcgmInstanceId = dcgmInstanceId;
+}
+
 /*****************************************************************************/
 DcgmNs::Mig::Nvml::GpuInstanceId const &DcgmGpuInstance::GetNvmlInstanceId() const
 {
@@ -169,6 +175,20 @@ dcgmReturn_t DcgmGpuInstance::GetComputeInstance(unsigned int index, dcgmcm_gpu_
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+dcgmReturn_t DcgmGpuInstance::SetComputeInstanceId(unsigned int index,
+                                                   DcgmNs::Mig::ComputeInstanceId const &dcgmComputeInstanceId)
+{
+    if (index >= m_computeInstances.size())
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    m_computeInstances[index].dcgmComputeInstanceId = dcgmComputeInstanceId;
+
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************/
 bool DcgmGpuInstance::HasComputeInstance(DcgmNs::Mig::ComputeInstanceId const &dcgmComputeInstanceId) const
 {
@@ -108,9 +108,15 @@ public:
     /*****************************************************************************/
     nvmlGpuInstanceProfileInfo_t GetProfileInfo() const;
 
+    /*****************************************************************************/
+    void SetInstanceId(DcgmNs::Mig::GpuInstanceId const &dcgmInstanceId);
+
     /*****************************************************************************/
     unsigned int GetComputeInstanceCount() const;
 
+    /*****************************************************************************/
+    dcgmReturn_t SetComputeInstanceId(unsigned int index, DcgmNs::Mig::ComputeInstanceId const &dcgmComputeInstanceId);
+
     /*****************************************************************************/
     dcgmReturn_t GetComputeInstanceById(DcgmNs::Mig::ComputeInstanceId const &ciId, dcgmcm_gpu_compute_instance_t &ci);
 
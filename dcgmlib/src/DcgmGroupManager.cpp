@@ -31,11 +31,11 @@
 
 /*****************************************************************************/
 DcgmGroupManager::DcgmGroupManager(DcgmCacheManager *cacheManager, bool createDefaultGroups)
-    : mLock()
+    : mLock(0)
     , mGroupIdSequence(0)
-    , mNumGroups(0)
     , mAllGpusGroupId(0)
     , mAllNvSwitchesGroupId(0)
+    , mGroups(std::make_shared<GroupIdMap const>())
     , mpCacheManager(cacheManager)
 {
     if (createDefaultGroups)
@@ -47,35 +47,38 @@ DcgmGroupManager::DcgmGroupManager(DcgmCacheManager *cacheManager, bool createDe
 /*****************************************************************************/
 DcgmGroupManager::~DcgmGroupManager()
 {
-    /* Go through the list of map and remove all the entries for DcgmGroupInfo */
+    /* Groups are freed once the last snapshot of them goes away */
     Lock();
-
-    GroupIdMap::iterator it;
-    for (it = mGroupIdMap.begin(); it != mGroupIdMap.end(); ++it)
-    {
-        DcgmGroupInfo *pDcgmGroup = it->second;
-        delete (pDcgmGroup);
-    }
-    mGroupIdMap.clear();
-    mNumGroups = 0;
-
+    PublishGroups(std::make_shared<GroupIdMap const>());
     Unlock();
 }
 
 /*****************************************************************************/
-int DcgmGroupManager::Lock()
+int DcgmGroupManager::Lock(const char *file, int line)
 {
-    mLock.lock();
+    mLock.Lock(1, file, line);
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-int DcgmGroupManager::Unlock()
+int DcgmGroupManager::Unlock(const char *file, int line)
 {
-    mLock.unlock();
+    mLock.Unlock(file, line);
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+std::shared_ptr<DcgmGroupManager::GroupIdMap const> DcgmGroupManager::GetGroups() const
+{
+    return std::atomic_load(&mGroups);
+}
+
+/*****************************************************************************/
+void DcgmGroupManager::PublishGroups(std::shared_ptr<GroupIdMap const> groups)
+{
+    std::atomic_store(&mGroups, std::move(groups));
+}
+
 /*****************************************************************************/
 unsigned int DcgmGroupManager::GetNextGroupId()
 {
@@ -196,7 +199,8 @@ dcgmReturn_t DcgmGroupManager::AddNewGroup(dcgm_connection_id_t connectionId,
 
     Lock();
 
-    if (mNumGroups >= DCGM_MAX_NUM_GROUPS + 2)
+    std::shared_ptr<GroupIdMap const> groups = GetGroups();
+    if (groups->size() >= DCGM_MAX_NUM_GROUPS + 2)
     {
         PRINT_ERROR("", "Add Group: Max number of groups already configured");
         Unlock();
@@ -264,9 +268,10 @@ dcgmReturn_t DcgmGroupManager::AddNewGroup(dcgm_connection_id_t connectionId,
         }
     }
 
-    mGroupIdMap[newGroupId] = pDcgmGrp;
-    *pGroupId               = newGroupId;
-    mNumGroups++;
+    auto newGroups           = std::make_shared<GroupIdMap>(*groups);
+    (*newGroups)[newGroupId] = std::shared_ptr<DcgmGroupInfo const>(pDcgmGrp);
+    PublishGroups(std::move(newGroups));
+    *pGroupId = newGroupId;
     Unlock();
 
     DCGM_LOG_DEBUG << "Added GroupId " << *pGroupId << " name " << groupName << " for connectionId " << connectionId;
@@ -276,35 +281,29 @@ dcgmReturn_t DcgmGroupManager::AddNewGroup(dcgm_connection_id_t connectionId,
 /*****************************************************************************/
 dcgmReturn_t DcgmGroupManager::RemoveGroup(dcgm_connection_id_t connectionId, unsigned int groupId)
 {
-    DcgmGroupInfo *pDcgmGrp;
-    GroupIdMap::iterator itGroup;
     std::vector<dcgmGroupRemoveCBEntry_t>::iterator removeCBIter;
 
     Lock();
 
-    itGroup = mGroupIdMap.find(groupId);
-    if (itGroup == mGroupIdMap.end())
+    std::shared_ptr<GroupIdMap const> groups = GetGroups();
+    GroupIdMap::const_iterator itGroup       = groups->find(groupId);
+    if (itGroup == groups->end())
     {
         Unlock();
         PRINT_ERROR("%d", "Delete Group: Not able to find entry corresponding to the group ID %d", groupId);
         return DCGM_ST_NOT_CONFIGURED;
     }
-    else
+    else if (!itGroup->second)
     {
-        pDcgmGrp = itGroup->second;
-        if (NULL == pDcgmGrp)
-        {
-            Unlock();
-            PRINT_ERROR("%d", "Delete Group: Invalid entry corresponding to the group ID %d", groupId);
-            return DCGM_ST_GENERIC_ERROR;
-        }
-
-        delete pDcgmGrp;
-        pDcgmGrp = NULL;
-        mGroupIdMap.erase(itGroup);
+        Unlock();
+        PRINT_ERROR("%d", "Delete Group: Invalid entry corresponding to the group ID %d", groupId);
+        return DCGM_ST_GENERIC_ERROR;
     }
 
-    mNumGroups--;
+    /* Lookups that already have the group keep using it until they are done */
+    auto newGroups = std::make_shared<GroupIdMap>(*groups);
+    newGroups->erase(groupId);
+    PublishGroups(std::move(newGroups));
 
 
     /* Leaving this inside the lock for now for consistency. We will have to revisit
@@ -323,17 +322,14 @@ dcgmReturn_t DcgmGroupManager::RemoveGroup(dcgm_connection_id_t connectionId, un
 /*****************************************************************************/
 dcgmReturn_t DcgmGroupManager::RemoveAllGroupsForConnection(dcgm_connection_id_t connectionId)
 {
-    DcgmGroupInfo *pDcgmGroup;
-    GroupIdMap::iterator itGroup;
     std::vector<unsigned int> removeGroupIds;
     std::vector<unsigned int>::iterator removeIt;
     unsigned int groupId;
 
-    Lock();
+    std::shared_ptr<GroupIdMap const> groups = GetGroups();
 
-    for (itGroup = mGroupIdMap.begin(); itGroup != mGroupIdMap.end(); ++itGroup)
+    for (auto const &[id, pDcgmGroup] : *groups)
     {
-        pDcgmGroup = itGroup->second;
         if (!pDcgmGroup)
             continue;
         groupId = pDcgmGroup->GetGroupId();
@@ -348,8 +344,6 @@ dcgmReturn_t DcgmGroupManager::RemoveAllGroupsForConnection(dcgm_connection_id_t
         }
     }
 
-    Unlock(); /* Unlock since RemoveGroup() will acquire the lock for each groupId */
-
     for (removeIt = removeGroupIds.begin(); removeIt != removeGroupIds.end(); ++removeIt)
     {
         dcgmReturn_t ret = RemoveGroup(connectionId, *removeIt);
@@ -369,28 +363,48 @@ dcgmReturn_t DcgmGroupManager::RemoveAllGroupsForConnection(dcgm_connection_id_t
 }
 
 /*****************************************************************************/
-DcgmGroupInfo *DcgmGroupManager::GetGroupById(dcgm_connection_id_t connectionId, unsigned int groupId)
+std::shared_ptr<DcgmGroupInfo const> DcgmGroupManager::GetGroupById(GroupIdMap const &groups,
+                                                                    dcgm_connection_id_t connectionId,
+                                                                    unsigned int groupId)
 {
-    DcgmGroupInfo *pDcgmGrp;
-    GroupIdMap::iterator itGroup;
-
-    itGroup = mGroupIdMap.find(groupId);
-    if (itGroup == mGroupIdMap.end())
+    GroupIdMap::const_iterator itGroup = groups.find(groupId);
+    if (itGroup == groups.end())
     {
         PRINT_ERROR("%d", "Get Group: Not able to find entry corresponding to the group ID %d", groupId);
-        return NULL;
+        return nullptr;
     }
-    else
+    else if (!itGroup->second)
     {
-        pDcgmGrp = itGroup->second;
-        if (NULL == pDcgmGrp)
-        {
-            PRINT_ERROR("%d", "Get Group: Invalid entry corresponding to the group ID %d", groupId);
-            return NULL;
-        }
+        PRINT_ERROR("%d", "Get Group: Invalid entry corresponding to the group ID %d", groupId);
+        return nullptr;
+    }
+
+    return itGroup->second;
+}
+
+/*****************************************************************************/
+template <typename Change>
+dcgmReturn_t DcgmGroupManager::ChangeGroup(dcgm_connection_id_t connectionId, unsigned int groupId, Change change)
+{
+    std::shared_ptr<GroupIdMap const> groups      = GetGroups();
+    std::shared_ptr<DcgmGroupInfo const> groupObj = GetGroupById(*groups, connectionId, groupId);
+    if (!groupObj)
+    {
+        PRINT_DEBUG("%u %u", "Group %u connectionId %u not found", groupId, connectionId);
+        return DCGM_ST_NOT_CONFIGURED;
+    }
+
+    auto newGroupObj = std::make_shared<DcgmGroupInfo>(*groupObj);
+    dcgmReturn_t ret = change(*newGroupObj);
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
     }
 
-    return pDcgmGrp;
+    auto newGroups        = std::make_shared<GroupIdMap>(*groups);
+    (*newGroups)[groupId] = std::move(newGroupObj);
+    PublishGroups(std::move(newGroups));
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
@@ -400,7 +414,6 @@ dcgmReturn_t DcgmGroupManager::GetGroupEntities(dcgm_connection_id_t connectionI
 {
     dcgmReturn_t ret;
 
-    Lock();
     /* See if this is one of the special fully-dynamic all-entity groups */
     if (groupId == mAllGpusGroupId || groupId == mAllNvSwitchesGroupId)
     {
@@ -421,22 +434,18 @@ dcgmReturn_t DcgmGroupManager::GetGroupEntities(dcgm_connection_id_t connectionI
                         "GetGroupEntities got %u entities for dynamic group %u",
                         (unsigned int)entities.size(),
                         groupId);
-        Unlock();
         return ret;
     }
 
     /* This is a regular group. Just return its list */
-    DcgmGroupInfo *groupObj = GetGroupById(connectionId, groupId);
+    std::shared_ptr<DcgmGroupInfo const> groupObj = GetGroupById(*GetGroups(), connectionId, groupId);
     if (!groupObj)
     {
-        Unlock();
         PRINT_DEBUG("%u %u", "Group %u connectionId %u not found", groupId, connectionId);
         return DCGM_ST_NOT_CONFIGURED;
     }
 
-    ret = groupObj->GetEntities(entities);
-    Unlock();
-    return ret;
+    return groupObj->GetEntities(entities);
 }
 
 /*****************************************************************************/
@@ -464,20 +473,14 @@ dcgmReturn_t DcgmGroupManager::GetGroupGpuIds(dcgm_connection_id_t connectionId,
 /*****************************************************************************/
 std::string DcgmGroupManager::GetGroupName(dcgm_connection_id_t connectionId, unsigned int groupId)
 {
-    std::string ret;
-
-    Lock();
-    DcgmGroupInfo *groupObj = GetGroupById(connectionId, groupId);
+    std::shared_ptr<DcgmGroupInfo const> groupObj = GetGroupById(*GetGroups(), connectionId, groupId);
     if (!groupObj)
     {
-        Unlock();
         PRINT_DEBUG("%u %u", "Group %u connectionId %u not found", groupId, connectionId);
-        return ret;
+        return std::string();
     }
 
-    ret = groupObj->GetGroupName();
-    Unlock();
-    return ret;
+    return groupObj->GetGroupName();
 }
 
 /*****************************************************************************/
@@ -486,18 +489,10 @@ dcgmReturn_t DcgmGroupManager::AddEntityToGroup(dcgm_connection_id_t connectionI
                                                 dcgm_field_entity_group_t entityGroupId,
                                                 dcgm_field_eid_t entityId)
 {
-    dcgmReturn_t ret;
-
     Lock();
-    DcgmGroupInfo *groupObj = GetGroupById(connectionId, groupId);
-    if (!groupObj)
-    {
-        Unlock();
-        PRINT_DEBUG("%u %u", "Group %u connectionId %u not found", groupId, connectionId);
-        return DCGM_ST_NOT_CONFIGURED;
-    }
-
-    ret = groupObj->AddEntityToGroup(entityGroupId, entityId);
+    dcgmReturn_t ret = ChangeGroup(connectionId, groupId, [&](DcgmGroupInfo &groupObj) {
+        return groupObj.AddEntityToGroup(entityGroupId, entityId);
+    });
     Unlock();
 
     PRINT_DEBUG("%u %u %u %u %d",
@@ -516,18 +511,10 @@ dcgmReturn_t DcgmGroupManager::RemoveEntityFromGroup(dcgm_connection_id_t connec
                                                      dcgm_field_entity_group_t entityGroupId,
                                                      dcgm_field_eid_t entityId)
 {
-    dcgmReturn_t ret;
-
     Lock();
-    DcgmGroupInfo *groupObj = GetGroupById(connectionId, groupId);
-    if (!groupObj)
-    {
-        Unlock();
-        PRINT_DEBUG("%u %u", "Group %u connectionId %u not found", groupId, connectionId);
-        return DCGM_ST_NOT_CONFIGURED;
-    }
-
-    ret = groupObj->RemoveEntityFromGroup(entityGroupId, entityId);
+    dcgmReturn_t ret = ChangeGroup(connectionId, groupId, [&](DcgmGroupInfo &groupObj) {
+        return groupObj.RemoveEntityFromGroup(entityGroupId, entityId);
+    });
     Unlock();
 
     PRINT_DEBUG("%u %u %u %u %d",
@@ -548,17 +535,14 @@ dcgmReturn_t DcgmGroupManager::AreAllTheSameSku(dcgm_connection_id_t connectionI
     if (!areAllSameSku)
         return DCGM_ST_BADPARAM;
 
-    Lock();
-    DcgmGroupInfo *groupObj = GetGroupById(connectionId, groupId);
+    std::shared_ptr<DcgmGroupInfo const> groupObj = GetGroupById(*GetGroups(), connectionId, groupId);
     if (!groupObj)
     {
-        Unlock();
         PRINT_DEBUG("%u %u", "Group %u connectionId %u not found", groupId, connectionId);
         return DCGM_ST_NOT_CONFIGURED;
     }
 
     *areAllSameSku = groupObj->AreAllTheSameSku();
-    Unlock();
     return DCGM_ST_OK;
 }
 
@@ -577,14 +561,11 @@ dcgmReturn_t DcgmGroupManager::verifyAndUpdateGroupId(unsigned int *groupId)
     /* Check that the groupId is actually a valid group */
     dcgmReturn_t ret = DCGM_ST_OK;
 
-    Lock();
-    DcgmGroupInfo *groupObj = GetGroupById(0, *groupId);
-    if (!groupObj)
+    if (!GetGroupById(*GetGroups(), 0, *groupId))
     {
         PRINT_DEBUG("%u", "Group %u not found", *groupId);
         ret = DCGM_ST_NOT_CONFIGURED;
     }
-    Unlock();
 
     return ret;
 }
@@ -594,18 +575,15 @@ dcgmReturn_t DcgmGroupManager::GetAllGroupIds(dcgm_connection_id_t connectionId,
                                               unsigned int groupIdList[],
                                               unsigned int *pCount)
 {
-    DcgmGroupInfo *pDcgmGrp;
-    GroupIdMap::iterator itGroup;
     unsigned int count = 0;
 
-    Lock();
+    std::shared_ptr<GroupIdMap const> groups = GetGroups();
 
-    for (itGroup = mGroupIdMap.begin(); itGroup != mGroupIdMap.end(); ++itGroup)
+    for (auto const &[groupId, pDcgmGrp] : *groups)
     {
-        pDcgmGrp = itGroup->second;
-        if (NULL == pDcgmGrp)
+        if (!pDcgmGrp)
         {
-            PRINT_ERROR("%u", "NULL DcgmGroupInfo() at groupId %u", itGroup->first);
+            PRINT_ERROR("%u", "NULL DcgmGroupInfo() at groupId %u", groupId);
             continue;
         }
 
@@ -613,7 +591,6 @@ dcgmReturn_t DcgmGroupManager::GetAllGroupIds(dcgm_connection_id_t connectionId,
     }
 
     *pCount = count;
-    Unlock();
     return DCGM_ST_OK;
 }
 
@@ -623,6 +600,92 @@ void DcgmGroupManager::OnConnectionRemove(dcgm_connection_id_t connectionId)
     RemoveAllGroupsForConnection(connectionId);
 }
 
+/*****************************************************************************/
+void DcgmGroupManager::GetConnectionGroupIds(dcgm_connection_id_t connectionId, std::vector<unsigned int> &groupIds)
+{
+    groupIds.clear();
+
+    for (auto const &[groupId, pDcgmGroup] : *GetGroups())
+    {
+        if (pDcgmGroup && pDcgmGroup->GetConnectionId() == connectionId)
+            groupIds.push_back(groupId);
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmGroupManager::RestoreGroup(dcgm_connection_id_t connectionId,
+                                            unsigned int groupId,
+                                            std::string const &groupName,
+                                            std::vector<dcgmGroupEntityPair_t> const &entities)
+{
+    auto pDcgmGrp = std::make_shared<DcgmGroupInfo>(connectionId, groupName, groupId, mpCacheManager);
+
+    for (auto const &entity : entities)
+    {
+        dcgmReturn_t ret = pDcgmGrp->AddEntityToGroup(entity.entityGroupId, entity.entityId);
+        if (ret != DCGM_ST_OK)
+        {
+            DCGM_LOG_WARNING << "Left eg " << entity.entityGroupId << " eid " << entity.entityId
+                             << " out of restored groupId " << groupId << ": " << errorString(ret);
+        }
+    }
+
+    DcgmLockGuard lockGuard(&mLock);
+
+    std::shared_ptr<GroupIdMap const> groups = GetGroups();
+    if (groups->size() >= DCGM_MAX_NUM_GROUPS + 2)
+    {
+        DCGM_LOG_ERROR << "Restore Group: Max number of groups already configured";
+        return DCGM_ST_MAX_LIMIT;
+    }
+    if (groups->count(groupId) != 0)
+    {
+        DCGM_LOG_WARNING << "Can't restore groupId " << groupId << " " << groupName << ". The ID is in use";
+        return DCGM_ST_DUPLICATE_KEY;
+    }
+
+    /* New groups must not reuse the ID */
+    unsigned int nextGroupId = mGroupIdSequence;
+    while (nextGroupId <= groupId && !mGroupIdSequence.compare_exchange_weak(nextGroupId, groupId + 1))
+        ;
+
+    auto newGroups        = std::make_shared<GroupIdMap>(*groups);
+    (*newGroups)[groupId] = std::move(pDcgmGrp);
+    PublishGroups(std::move(newGroups));
+
+    DCGM_LOG_DEBUG << "Restored GroupId " << groupId << " name " << groupName << " for connectionId "
+                   << connectionId;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmGroupManager::ChangeConnection(dcgm_connection_id_t connectionId, dcgm_connection_id_t newConnectionId)
+{
+    if (connectionId == newConnectionId)
+        return;
+
+    DcgmLockGuard lockGuard(&mLock);
+
+    std::shared_ptr<GroupIdMap const> groups = GetGroups();
+    std::shared_ptr<GroupIdMap> newGroups;
+
+    for (auto const &[groupId, pDcgmGroup] : *groups)
+    {
+        if (!pDcgmGroup || pDcgmGroup->GetConnectionId() != connectionId)
+            continue;
+
+        if (!newGroups)
+            newGroups = std::make_shared<GroupIdMap>(*groups);
+
+        auto newGroupObj = std::make_shared<DcgmGroupInfo>(*pDcgmGroup);
+        newGroupObj->SetConnectionId(newConnectionId);
+        (*newGroups)[groupId] = std::move(newGroupObj);
+    }
+
+    if (newGroups)
+        PublishGroups(std::move(newGroups));
+}
+
 /*****************************************************************************/
 void DcgmGroupManager::SubscribeForGroupEvents(dcgmOnRemoveGroup_f onRemoveCB, void *userData)
 {
@@ -721,32 +784,38 @@ dcgmReturn_t DcgmGroupInfo::RemoveEntityFromGroup(dcgm_field_entity_group_t enti
 }
 
 /*****************************************************************************/
-std::string DcgmGroupInfo::GetGroupName()
+std::string DcgmGroupInfo::GetGroupName() const
 {
     return mName;
 }
 
 /*****************************************************************************/
-unsigned int DcgmGroupInfo::GetGroupId()
+unsigned int DcgmGroupInfo::GetGroupId() const
 {
     return mGroupId;
 }
 
 /*****************************************************************************/
-dcgm_connection_id_t DcgmGroupInfo::GetConnectionId()
+dcgm_connection_id_t DcgmGroupInfo::GetConnectionId() const
 {
     return mConnectionId;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmGroupInfo::GetEntities(std::vector<dcgmGroupEntityPair_t> &entities)
+void DcgmGroupInfo::SetConnectionId(dcgm_connection_id_t connectionId)
+{
+    mConnectionId = connectionId;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmGroupInfo::GetEntities(std::vector<dcgmGroupEntityPair_t> &entities) const
 {
     entities = mEntityList;
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-int DcgmGroupInfo::AreAllTheSameSku(void)
+int DcgmGroupInfo::AreAllTheSameSku(void) const
 {
     unsigned int i;
     std::vector<unsigned int> gpuIds;
@@ -25,6 +25,7 @@
 #include <atomic>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -50,6 +51,12 @@ typedef struct
 
 class DcgmGroupInfo;
 
+/*
+ * Groups are kept in an immutable table that lookups take a snapshot of without
+ * locking, so resolving group IDs from every client doesn't serialize. Changes are
+ * serialized by Lock() and publish a copy of the table with a copy of each group
+ * they change.
+ */
 class DcgmGroupManager
 {
 public:
@@ -236,6 +243,34 @@ public:
      */
     void OnConnectionRemove(dcgm_connection_id_t connectionId);
 
+    /*****************************************************************************
+     * Get the IDs of the groups that a connection created
+     *
+     * connectionId  IN: Connection to get the groups of
+     * groupIds     OUT: IDs of its groups
+     */
+    void GetConnectionGroupIds(dcgm_connection_id_t connectionId, std::vector<unsigned int> &groupIds);
+
+    /*****************************************************************************
+     * Recreate a group under the ID it had before, like one saved in a state
+     * checkpoint. Entities that can't be added anymore are skipped and logged
+     *
+     * @return
+     * DCGM_ST_OK            :   On Success
+     * DCGM_ST_DUPLICATE_KEY :   If groupId is in use
+     * DCGM_ST_MAX_LIMIT     :   If there are too many groups
+     */
+    dcgmReturn_t RestoreGroup(dcgm_connection_id_t connectionId,
+                              unsigned int groupId,
+                              std::string const &groupName,
+                              std::vector<dcgmGroupEntityPair_t> const &entities);
+
+    /*****************************************************************************
+     * Hand the groups of connectionId over to newConnectionId, so that they are
+     * removed when newConnectionId disconnects instead
+     */
+    void ChangeConnection(dcgm_connection_id_t connectionId, dcgm_connection_id_t newConnectionId);
+
     /*****************************************************************************
      * Subscribe to be notified when events occur for a group
      *
@@ -265,19 +300,38 @@ private:
      *****************************************************************************/
     unsigned int GetNextGroupId();
 
+    typedef std::map<unsigned int, std::shared_ptr<DcgmGroupInfo const>> GroupIdMap;
+
+    /* The current table of groups. It never changes once published */
+    std::shared_ptr<GroupIdMap const> GetGroups() const;
+
+    /* Replace the table of groups. Caller holds Lock() */
+    void PublishGroups(std::shared_ptr<GroupIdMap const> groups);
+
     /******************************************************************************
      * Private helper to get a Group pointer by connectionId and groupId
      *
-     * NOTE: Assumes group manager has been locked with Lock()
-     *
+     * @param groups       IN: Table of groups to look in
      * @param connectionId IN: Connection ID
      * @param groupId      IN  Group to get gpuIds of
      *
      * @return Group pointer on success.
-     *         NULL if not found
+     *         nullptr if not found
      */
 
-    DcgmGroupInfo *GetGroupById(dcgm_connection_id_t connectionId, unsigned int groupId);
+    std::shared_ptr<DcgmGroupInfo const> GetGroupById(GroupIdMap const &groups,
+                                                      dcgm_connection_id_t connectionId,
+                                                      unsigned int groupId);
+
+    /******************************************************************************
+     * Publish a copy of the table where groupId has a copy of its group with
+     * change applied. Caller holds Lock()
+     *
+     * @return What change returned. The table is only published on DCGM_ST_OK
+     *         DCGM_ST_NOT_CONFIGURED if groupId is not a group
+     */
+    template <typename Change>
+    dcgmReturn_t ChangeGroup(dcgm_connection_id_t connectionId, unsigned int groupId, Change change);
 
     /*****************************************************************************
      * Add every entity of a given entityGroup to this group.
@@ -288,20 +342,20 @@ private:
     dcgmReturn_t AddAllEntitiesToGroup(DcgmGroupInfo *pDcgmGrp, dcgm_field_entity_group_t entityGroupId);
 
     /*****************************************************************************
-     * Lock/Unlocks methods to protect the maps for group IDs and group Names
+     * Lock/Unlocks methods to serialize changes to the groups. Lookups don't lock.
+     * file and line default to the caller's so that mutex profiles show who locked
      *****************************************************************************/
-    int Lock();
-    int Unlock();
+    int Lock(const char *file = __builtin_FILE(), int line = __builtin_LINE());
+    int Unlock(const char *file = __builtin_FILE(), int line = __builtin_LINE());
 
-    std::mutex mLock;                   /* Lock used for accessing table for the groups */
+    DcgmMutex mLock;                    /* Lock held while changing the groups */
     std::atomic_uint mGroupIdSequence;  /* Group ID sequence */
-    unsigned int mNumGroups;            /* Number of groups configured on the system */
     unsigned int mAllGpusGroupId;       /* This is a cached group ID to a group containing all GPUs */
     unsigned int mAllNvSwitchesGroupId; /* This is a cached group ID to a group containing all NvSwitches */
 
-    typedef std::map<unsigned int, DcgmGroupInfo *> GroupIdMap;
-
-    GroupIdMap mGroupIdMap; /* GroupId -> DcgmGroupInfo object map of all groups */
+    /* GroupId -> DcgmGroupInfo object map of all groups. Only accessed through
+       GetGroups() and PublishGroups() */
+    std::shared_ptr<GroupIdMap const> mGroups;
 
     DcgmCacheManager *mpCacheManager; /* Pointer to the cache manager */
 
@@ -348,21 +402,26 @@ public:
      * @return
      * Group Name
      *****************************************************************************/
-    std::string GetGroupName();
+    std::string GetGroupName() const;
 
     /*****************************************************************************
      * Get Group Id
      * @return
      * Group ID
      *****************************************************************************/
-    unsigned int GetGroupId();
+    unsigned int GetGroupId() const;
 
     /*****************************************************************************
      * Get the connection ID that created this group
      * @return
      * Connection ID
      *****************************************************************************/
-    dcgm_connection_id_t GetConnectionId();
+    dcgm_connection_id_t GetConnectionId() const;
+
+    /*****************************************************************************
+     * Change the connection that owns this group. See DcgmGroupManager::ChangeConnection()
+     *****************************************************************************/
+    void SetConnectionId(dcgm_connection_id_t connectionId);
 
     /*****************************************************************************
      * This method is used to get all of the entities of a group
@@ -376,7 +435,7 @@ public:
      * DCGM_ST_OK       :   On Success
      * DCGM_ST_?        :   On Error*
      */
-    dcgmReturn_t GetEntities(std::vector<dcgmGroupEntityPair_t> &entities);
+    dcgmReturn_t GetEntities(std::vector<dcgmGroupEntityPair_t> &entities) const;
 
     /*****************************************************************************
      * Are all of the GPUs in this group the same SKU?
@@ -384,7 +443,7 @@ public:
      * Returns 1 if all of the GPUs of this group are the same
      *         0 if any of the GPUs of this group are different from each other
      */
-    int AreAllTheSameSku(void);
+    int AreAllTheSameSku(void) const;
 
 private:
     unsigned int mGroupId;                          /* ID representing GPU group */
@@ -18,7 +18,9 @@
  */
 
 #include "DcgmHostEngineHandler.h"
+#include "DcgmBinaryLog.h"
 #include "DcgmLogging.h"
+#include "DcgmMessageBufferPool.h"
 #include "DcgmMetadataMgr.h"
 #include "DcgmModule.h"
 #include "DcgmModuleHealth.h"
@@ -26,6 +28,7 @@
 #include "DcgmModulePolicy.h"
 #include "DcgmSettings.h"
 #include "DcgmStatus.h"
+#include "DcgmTrace.h"
 #include "dcgm_health_structs.h"
 #include "dcgm_nvswitch_structs.h"
 #include "dcgm_profiling_structs.h"
@@ -33,12 +36,18 @@
 #include "dlfcn.h" //dlopen, dlsym..etc
 #include "nvcmvalue.h"
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
 
 #include "DcgmCoreCommunication.h"
 #include "DcgmGroupManager.h"
+#include "DcgmWorkerLanes.h"
 #include <dcgm_nvml.h>
 
 DcgmHostEngineHandler *DcgmHostEngineHandler::mpHostEngineHandlerInstance = nullptr;
@@ -598,6 +607,14 @@ dcgmReturn_t DcgmHostEngineHandler::GetAllEntitiesOfEntityGroup(int activeOnly,
 {
     if (entityGroupId == DCGM_FE_SWITCH)
     {
+        /* The default NvSwitch group is resolved again whenever it's used, so it can start out empty
+           rather than load the module early */
+        if (m_startingUp && m_modules[DcgmModuleIdNvSwitch].ptr == nullptr
+            && m_modules[DcgmModuleIdNvSwitch].loadPolicy != DcgmModuleLoadEager)
+        {
+            return DCGM_ST_MODULE_NOT_LOADED;
+        }
+
         dcgm_nvswitch_msg_get_switches_t nvsMsg {};
         nvsMsg.header.length     = sizeof(nvsMsg);
         nvsMsg.header.version    = dcgm_nvswitch_msg_get_switches_version;
@@ -1724,6 +1741,7 @@ dcgmReturn_t DcgmHostEngineHandler::ProcessCreateFakeEntities(dcgm::Command *pCm
     }
 
     dcgmReturn_t ret = HelperCreateFakeEntities(createFakeEntities);
+    BumpAttributeGeneration(); /* Even on failure, some may have been created */
 
     pCmd->set_status(ret);
     *pIsComplete = true;
@@ -2250,6 +2268,8 @@ dcgmReturn_t DcgmHostEngineHandler::ProcessGetMultipleLatestValues(dcgm::Command
         return ret;
     }
 
+    mpCacheManager->RecordSampleLag(DCGM_INTROSPECT_LAG_IPC_SEND, fvBufferBytes, bufferSize);
+
     /* Set pCmd->blob with the contents of the FV buffer */
     pCmd->mutable_arg(0)->set_blob(fvBufferBytes, bufferSize);
     pCmd->set_status(ret);
@@ -2329,6 +2349,14 @@ dcgmReturn_t DcgmHostEngineHandler::HelperGetFieldSummary(dcgmFieldSummaryReques
         }
     }
 
+    /* There are more summary types than fit in the response */
+    if (numSummaryTypes > DCGM_SUMMARY_SIZE)
+    {
+        DCGM_LOG_ERROR << "Requested " << numSummaryTypes << " summaries. At most " << DCGM_SUMMARY_SIZE
+                       << " fit in the response";
+        return DCGM_ST_BADPARAM;
+    }
+
     fieldSummary.response.fieldType    = fm->fieldType;
     fieldSummary.response.summaryCount = numSummaryTypes;
 
@@ -2405,6 +2433,7 @@ int DcgmHostEngineHandler::ProcessRequest(dcgm::Command *pCmd,
     int ret = 0;
 
     DCGM_LOG_DEBUG << "Processing request of type " << pCmd->cmdtype() << " for connectionId " << connectionId;
+    DCGM_TRACE_SCOPE("ipc", "ProcessRequest", pCmd->cmdtype());
 
     /* Only allow connectionId to be set if we're actually going to clean up requests */
     if (GetPersistAfterDisconnect(connectionId))
@@ -2714,6 +2743,7 @@ dcgmReturn_t DcgmHostEngineHandler::SendRawMessageToEmbeddedClient(unsigned int
     msg->UpdateMsgHdr(msgType, requestId, status, msgLength);
 
     /* Make a copy of the incoming buffer, as this could be stack-allocated or heap allocated */
+    msg->ReserveMsgBytes(msgLength);
     auto msgBytes = msg->GetMsgBytesPtr();
     msgBytes->resize(msgLength);
     memcpy(msgBytes->data(), msgData, msgLength);
@@ -2741,6 +2771,7 @@ dcgmReturn_t DcgmHostEngineHandler::SendRawMessageToClient(dcgm_connection_id_t
 
     dcgmMessage->UpdateMsgHdr(msgType, requestId, status, msgLength);
 
+    dcgmMessage->ReserveMsgBytes(msgLength);
     auto msgBytes = dcgmMessage->GetMsgBytesPtr();
     msgBytes->resize(msgLength);
     memcpy(msgBytes->data(), msgData, msgLength);
@@ -2793,6 +2824,14 @@ dcgmReturn_t DcgmHostEngineHandler::ProcessModuleCommand(dcgm_module_command_hea
         }
     }
 
+    if (moduleCommand->moduleId == DcgmModuleIdProfiling && m_profMultiplexer != nullptr)
+    {
+        if (m_profMultiplexer->InterceptCommand(moduleCommand, dcgmReturn))
+        {
+            return dcgmReturn;
+        }
+    }
+
     /* Dispatch the message */
     return SendModuleMessage(moduleCommand->moduleId, moduleCommand);
 }
@@ -2806,13 +2845,33 @@ dcgmReturn_t DcgmHostEngineHandler::GetCacheManagerFieldInfo(dcgmCacheManagerFie
 /*****************************************************************************/
 void DcgmHostEngineHandler::OnConnectionRemove(dcgm_connection_id_t connectionId)
 {
+    m_fvStreamManager.OnConnectionRemove(connectionId);
+    m_requestStats.OnConnectionRemove(connectionId);
+    if (m_proxyManager != nullptr)
+    {
+        m_proxyManager->OnConnectionRemove(connectionId);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_attributeMutex);
+        m_attributeSubscribers.erase(connectionId);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        m_sessionTokens.erase(connectionId);
+    }
+
     if (mpGroupManager != nullptr)
     {
         mpGroupManager->OnConnectionRemove(connectionId);
     }
     if (mpFieldGroupManager != nullptr)
     {
-        mpFieldGroupManager->OnConnectionRemove(connectionId);
+        if (mpFieldGroupManager->OnConnectionRemove(connectionId))
+        {
+            BumpAttributeGeneration(); /* Other clients may have cached the field groups */
+        }
     }
     /* Call the cache manager last since the rest of the modules refer to it */
     if (mpCacheManager != nullptr)
@@ -2860,17 +2919,53 @@ int DcgmHostEngineHandler::HandleCommands(std::vector<dcgm::Command *> *pVecCmds
     return 0;
 }
 
+/*****************************************************************************/
+/* Usec from start to end. 0 if start is unset, as it is for messages that weren't received by DcgmIpc */
+static unsigned long long helperUsecBetween(std::chrono::steady_clock::time_point start,
+                                            std::chrono::steady_clock::time_point end)
+{
+    if (start == std::chrono::steady_clock::time_point {} || end < start)
+    {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+/*****************************************************************************/
+/* Bytes of the first block of each thread's protobuf request arena. Most requests fit in it */
+#define DCGM_PROTOBUF_ARENA_INITIAL_BLOCK_SIZE (64 * 1024)
+
+/*****************************************************************************/
+/* Arena that the protobuf requests processed by the calling thread are parsed into. Resetting it frees a request's
+   commands and replies at once. The first block is kept across resets, so most requests don't allocate */
+static google::protobuf::Arena &helperGetRequestArena()
+{
+    thread_local std::vector<char> initialBlock(DCGM_PROTOBUF_ARENA_INITIAL_BLOCK_SIZE);
+    thread_local google::protobuf::Arena arena(initialBlock.data(), initialBlock.size());
+    return arena;
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmHostEngineHandler::ProcessProtobufMessage(dcgm_connection_id_t connectionId,
                                                            std::unique_ptr<DcgmMessage> message)
 {
     dcgmReturn_t retSt = DCGM_ST_OK;
-    DcgmProtobuf protoObj;                /* Protobuf object to send or recv the message */
-    std::vector<dcgm::Command *> vecCmds; /* To store reference to commands inside the protobuf message */
+
+    /* Declared first so that the arena is reset after everything else that uses it is gone */
+    std::unique_ptr<google::protobuf::Arena, void (*)(google::protobuf::Arena *)> arenaReset(
+        &helperGetRequestArena(), [](google::protobuf::Arena *arena) { arena->Reset(); });
+
+    DcgmProtobuf protoObj(arenaReset.get()); /* Protobuf object to send or recv the message */
+    std::vector<dcgm::Command *> vecCmds;    /* To store reference to commands inside the protobuf message */
 
     auto msgBytes  = message->GetMsgBytesPtr();
     auto msgHeader = message->GetMessageHdr();
 
+    unsigned long long queueWaitUsec
+        = helperUsecBetween(message->GetReceivedTime(), std::chrono::steady_clock::now());
+
+    DcgmMemoryCharge memoryCharge(&m_protobufMemory, msgBytes->capacity());
+
     retSt = protoObj.ParseRecvdMessage(msgBytes->data(), msgBytes->size(), &vecCmds);
     if (retSt != DCGM_ST_OK)
     {
@@ -2878,21 +2973,78 @@ dcgmReturn_t DcgmHostEngineHandler::ProcessProtobufMessage(dcgm_connection_id_t
         return retSt;
     }
 
-    HandleCommands(&vecCmds, connectionId, msgHeader->requestId);
+    /* Like HandleCommands(), but timing each command for m_requestStats */
+    std::vector<unsigned long long> processUsec(vecCmds.size());
+    bool isComplete = false;
+    for (size_t i = 0; i < vecCmds.size(); i++)
+    {
+        auto commandStart = std::chrono::steady_clock::now();
+        (void)ProcessRequest(vecCmds[i], &isComplete, connectionId, msgHeader->requestId);
+        /* Give the caller our timestamp */
+        vecCmds[i]->set_timestamp(timelib_usecSince1970());
+        processUsec[i] = helperUsecBetween(commandStart, std::chrono::steady_clock::now());
+    }
+
+    /* The commands now hold their replies too */
+    memoryCharge.Add(protoObj.GetSpaceUsed());
 
     protoObj.GetEncodedMessage(*msgBytes);
 
+    /* The commands share one reply, so each is charged an equal part of it */
+    for (size_t i = 0; i < vecCmds.size(); i++)
+    {
+        m_requestStats.Record(connectionId,
+                              DCGM_INTROSPECT_REQUEST_PROTOBUF,
+                              vecCmds[i]->cmdtype(),
+                              (dcgmReturn_t)vecCmds[i]->status(),
+                              queueWaitUsec,
+                              processUsec[i],
+                              msgBytes->size() / vecCmds.size());
+    }
+
     message->UpdateMsgHdr(DCGM_MSG_PROTO_RESPONSE, msgHeader->requestId, DCGM_ST_OK, msgBytes->size());
 
     return m_dcgmIpc.SendMessage(connectionId, std::move(message), false);
 }
 
+/*****************************************************************************/
+size_t DcgmHostEngineHandler::GetModuleCommandResponseLength(dcgm_module_command_header_t const *moduleCommand)
+{
+    if (moduleCommand->moduleId != DcgmModuleIdCore)
+        return 0;
+
+    switch (moduleCommand->subCommand)
+    {
+        case DCGM_CORE_SR_ENTITIES_GET_LATEST_VALUES:
+            return sizeof(dcgm_core_msg_entities_get_latest_values_t);
+        case DCGM_CORE_SR_GET_MULTIPLE_VALUES_FOR_FIELD:
+            return sizeof(dcgm_core_msg_get_multiple_values_for_field_t);
+        case DCGM_CORE_SR_GET_BUCKETED_VALUES_FOR_FIELD:
+            return sizeof(dcgm_core_msg_get_bucketed_values_for_field_t);
+        case DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES:
+            if (moduleCommand->length < sizeof(dcgm_core_msg_get_multiple_latest_values_t))
+                return 0; /* The module rejects it */
+            return sizeof(dcgm_core_msg_get_multiple_latest_values_t)
+                   + std::min<size_t>(((dcgm_core_msg_get_multiple_latest_values_t const *)moduleCommand)->bufferCapacity,
+                                      DCGM_FV_REPLY_MAX_BUFFER_SIZE);
+        case DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX:
+            return sizeof(dcgm_core_msg_get_latest_values_matrix_t) + DCGM_MATRIX_REPLY_MAX_BUFFER_SIZE;
+        case DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES:
+            if (moduleCommand->length < sizeof(dcgm_core_msg_get_field_multiple_values_t))
+                return 0; /* The module rejects it */
+            return sizeof(dcgm_core_msg_get_field_multiple_values_t)
+                   + std::min<size_t>(((dcgm_core_msg_get_field_multiple_values_t const *)moduleCommand)->bufferCapacity,
+                                      DCGM_FV_REPLY_MAX_BUFFER_SIZE);
+        default:
+            /* No need to resize */
+            return 0;
+    }
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmHostEngineHandler::ProcessModuleCommandMsg(dcgm_connection_id_t connectionId,
                                                             std::unique_ptr<DcgmMessage> message)
 {
-    dcgmReturn_t retSt = DCGM_ST_OK;
-
     auto msgBytes  = message->GetMsgBytesPtr();
     auto msgHeader = message->GetMessageHdr();
 
@@ -2920,24 +3072,13 @@ dcgmReturn_t DcgmHostEngineHandler::ProcessModuleCommandMsg(dcgm_connection_id_t
     }
 
     /* Resize buffer for certain commands that may have large response payloads */
-    if (moduleCommand->moduleId == DcgmModuleIdCore)
+    size_t responseLength = GetModuleCommandResponseLength(moduleCommand);
+    if (responseLength != 0)
     {
-        switch (moduleCommand->subCommand)
-        {
-            case DCGM_CORE_SR_ENTITIES_GET_LATEST_VALUES:
-                msgBytes->resize(sizeof(dcgm_core_msg_entities_get_latest_values_t));
-                moduleCommand         = (dcgm_module_command_header_t *)msgBytes->data();
-                moduleCommand->length = sizeof(dcgm_core_msg_entities_get_latest_values_t);
-                break;
-            case DCGM_CORE_SR_GET_MULTIPLE_VALUES_FOR_FIELD:
-                msgBytes->resize(sizeof(dcgm_core_msg_get_multiple_values_for_field_t));
-                moduleCommand         = (dcgm_module_command_header_t *)msgBytes->data();
-                moduleCommand->length = sizeof(dcgm_core_msg_get_multiple_values_for_field_t);
-                break;
-            default:
-                /* No need to resize */
-                break;
-        }
+        message->ReserveMsgBytes(responseLength);
+        msgBytes->resize(responseLength);
+        moduleCommand         = (dcgm_module_command_header_t *)msgBytes->data();
+        moduleCommand->length = responseLength;
     }
 
     if (moduleCommand->requestId == DCGM_REQUEST_ID_NONE)
@@ -2945,15 +3086,207 @@ dcgmReturn_t DcgmHostEngineHandler::ProcessModuleCommandMsg(dcgm_connection_id_t
 
     moduleCommand->connectionId = connectionId;
 
+    /* Modules that asked for their own thread get their commands off of this worker. The
+       module has to be loaded to know that. ProcessModuleCommand() reports load failures */
+    unsigned int moduleId   = moduleCommand->moduleId;
+    unsigned int subCommand = moduleCommand->subCommand;
+    if (moduleId > DcgmModuleIdCore && moduleId < DcgmModuleIdCount)
+    {
+        if (m_modules[moduleId].ptr == nullptr)
+        {
+            (void)LoadModule(static_cast<dcgmModuleId_t>(moduleId));
+        }
+
+        bool isInline = subCommand < 64 && (m_modules[moduleId].inlineSubCommands & (1ULL << subCommand)) != 0;
+        if (m_modules[moduleId].commandQueue != nullptr && !isInline)
+        {
+            /* Tasks have to be copyable. Dropped tasks free the message and release its
+               memory charge with the last copy */
+            auto charge = std::make_shared<DcgmMemoryCharge>(ModuleMemory(moduleId), msgBytes->capacity());
+            auto queued = std::make_shared<std::unique_ptr<DcgmMessage>>(std::move(message));
+            m_modules[moduleId].commandQueue->Enqueue([this, connectionId, queued, charge] {
+                FinishModuleCommandMsg(connectionId, std::move(*queued));
+            });
+            return DCGM_ST_OK;
+        }
+    }
+
+    DcgmMemoryCharge charge(ModuleMemory(moduleId), msgBytes->capacity());
+    FinishModuleCommandMsg(connectionId, std::move(message));
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmHostEngineHandler::FinishModuleCommandMsg(dcgm_connection_id_t connectionId,
+                                                   std::unique_ptr<DcgmMessage> message)
+{
+    auto msgBytes      = message->GetMsgBytesPtr();
+    auto moduleCommand = (dcgm_module_command_header_t *)msgBytes->data();
+
+    /* Includes the time spent in the module's command queue, if any */
+    auto processStart                = std::chrono::steady_clock::now();
+    unsigned long long queueWaitUsec = helperUsecBetween(message->GetReceivedTime(), processStart);
+
+    /* arg is moduleId * 1000 + subCommand so that the command can be read off the trace */
+    DCGM_TRACE_SCOPE("ipc", "ModuleCommand", moduleCommand->moduleId * 1000LL + moduleCommand->subCommand);
+
+    unsigned int moduleId      = moduleCommand->moduleId;
+    unsigned int subCommand    = moduleCommand->subCommand;
     dcgmReturn_t requestStatus = ProcessModuleCommand(moduleCommand);
 
     /* Resize msgBytes to whatever moduleCommand's updated size is */
     msgBytes->resize(moduleCommand->length);
 
+    m_requestStats.Record(connectionId,
+                          moduleId,
+                          subCommand,
+                          requestStatus,
+                          queueWaitUsec,
+                          helperUsecBetween(processStart, std::chrono::steady_clock::now()),
+                          moduleCommand->length);
+
     message->UpdateMsgHdr(DCGM_MSG_MODULE_COMMAND, moduleCommand->requestId, requestStatus, moduleCommand->length);
 
     m_dcgmIpc.SendMessage(connectionId, std::move(message), false);
-    return retSt;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::ProcessModuleCommandBatch(dcgm_connection_id_t connectionId,
+                                                              dcgm_request_id_t requestId,
+                                                              std::vector<char> &batch,
+                                                              unsigned long long queueWaitUsec)
+{
+    dcgm_msg_module_command_batch_t batchHeader;
+    if (batch.size() < sizeof(batchHeader))
+    {
+        DCGM_LOG_ERROR << "Module command batch of " << batch.size() << " bytes is too small";
+        return DCGM_ST_BADPARAM;
+    }
+
+    memcpy(&batchHeader, batch.data(), sizeof(batchHeader));
+    if (batchHeader.version != dcgm_msg_module_command_batch_version)
+    {
+        DCGM_LOG_ERROR << "Module command batch version " << batchHeader.version << " != "
+                       << dcgm_msg_module_command_batch_version;
+        return DCGM_ST_VER_MISMATCH;
+    }
+    if (batchHeader.numCommands > DCGM_MODULE_COMMAND_BATCH_MAX_COMMANDS)
+    {
+        DCGM_LOG_ERROR << "Module command batch has " << batchHeader.numCommands << " commands. Max is "
+                       << DCGM_MODULE_COMMAND_BATCH_MAX_COMMANDS;
+        return DCGM_ST_BADPARAM;
+    }
+
+    DCGM_TRACE_SCOPE("ipc", "ModuleCommandBatch", batchHeader.numCommands);
+
+    /* Check the whole batch before running any of it, so a batch is never half processed */
+    size_t offset = sizeof(batchHeader);
+    for (unsigned int i = 0; i < batchHeader.numCommands; i++)
+    {
+        auto moduleCommand
+            = (dcgm_module_command_header_t *)(batch.data() + offset + sizeof(dcgm_msg_module_command_batch_entry_t));
+        if (batch.size() < offset + sizeof(dcgm_msg_module_command_batch_entry_t) + sizeof(*moduleCommand)
+            || moduleCommand->length < sizeof(*moduleCommand)
+            || batch.size() < offset + sizeof(dcgm_msg_module_command_batch_entry_t) + moduleCommand->length)
+        {
+            DCGM_LOG_ERROR << "Module command " << i << " of a batch of " << batchHeader.numCommands
+                           << " is truncated or has a bad length";
+            return DCGM_ST_BADPARAM;
+        }
+        offset += sizeof(dcgm_msg_module_command_batch_entry_t) + moduleCommand->length;
+    }
+    if (offset != batch.size())
+    {
+        DCGM_LOG_ERROR << "Module command batch has " << batch.size() - offset << " extra bytes";
+        return DCGM_ST_BADPARAM;
+    }
+
+    std::vector<char> response;
+    response.reserve(batch.size());
+    response.insert(response.end(), batch.data(), batch.data() + sizeof(batchHeader));
+
+    std::vector<char> commandBytes;
+    offset = sizeof(batchHeader);
+    for (unsigned int i = 0; i < batchHeader.numCommands; i++)
+    {
+        char const *commandStart = batch.data() + offset + sizeof(dcgm_msg_module_command_batch_entry_t);
+        unsigned int length      = ((dcgm_module_command_header_t const *)commandStart)->length;
+        offset += sizeof(dcgm_msg_module_command_batch_entry_t) + length;
+
+        /* Run each command out of its own buffer, resized like ProcessModuleCommandMsg does */
+        commandBytes.assign(commandStart, commandStart + length);
+        auto moduleCommand    = (dcgm_module_command_header_t *)commandBytes.data();
+        size_t responseLength = GetModuleCommandResponseLength(moduleCommand);
+        if (responseLength != 0)
+        {
+            commandBytes.resize(responseLength);
+            moduleCommand         = (dcgm_module_command_header_t *)commandBytes.data();
+            moduleCommand->length = responseLength;
+        }
+
+        dcgm_msg_module_command_batch_entry_t entry {};
+        if (response.size() + sizeof(entry) + moduleCommand->length > DCGM_PROTO_MAX_MESSAGE_SIZE)
+        {
+            /* Return the command as it was sent rather than run it without room for its response */
+            DCGM_LOG_ERROR << "No room for the response of module command " << i << " of a batch of "
+                           << batchHeader.numCommands;
+            entry.status = DCGM_ST_INSUFFICIENT_SIZE;
+            response.insert(response.end(), (char const *)&entry, (char const *)&entry + sizeof(entry));
+            response.insert(response.end(), commandStart, commandStart + length);
+            continue;
+        }
+
+        moduleCommand->requestId    = requestId;
+        moduleCommand->connectionId = connectionId;
+
+        unsigned int moduleId   = moduleCommand->moduleId;
+        unsigned int subCommand = moduleCommand->subCommand;
+        auto processStart       = std::chrono::steady_clock::now();
+
+        DcgmMemoryCharge charge(ModuleMemory(moduleId), commandBytes.capacity());
+        entry.status = ProcessModuleCommand(moduleCommand);
+
+        /* Every command of the batch waited as long as the batch did */
+        if (connectionId != DCGM_CONNECTION_ID_NONE)
+        {
+            m_requestStats.Record(connectionId,
+                                  moduleId,
+                                  subCommand,
+                                  (dcgmReturn_t)entry.status,
+                                  queueWaitUsec,
+                                  helperUsecBetween(processStart, std::chrono::steady_clock::now()),
+                                  moduleCommand->length);
+        }
+
+        response.insert(response.end(), (char const *)&entry, (char const *)&entry + sizeof(entry));
+        response.insert(response.end(), commandBytes.data(), commandBytes.data() + moduleCommand->length);
+    }
+
+    batch.swap(response);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::ProcessModuleCommandBatchMsg(dcgm_connection_id_t connectionId,
+                                                                 std::unique_ptr<DcgmMessage> message)
+{
+    auto msgBytes = message->GetMsgBytesPtr();
+
+    unsigned long long queueWaitUsec
+        = helperUsecBetween(message->GetReceivedTime(), std::chrono::steady_clock::now());
+
+    dcgmReturn_t dcgmReturn
+        = ProcessModuleCommandBatch(connectionId, message->GetRequestId(), *msgBytes, queueWaitUsec);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        /* Still respond so the client isn't left waiting */
+        msgBytes->clear();
+    }
+
+    message->UpdateMsgHdr(DCGM_MSG_MODULE_COMMAND_BATCH, message->GetRequestId(), dcgmReturn, msgBytes->size());
+
+    m_dcgmIpc.SendMessage(connectionId, std::move(message), false);
+    return dcgmReturn;
 }
 
 /*****************************************************************************/
@@ -2970,6 +3303,28 @@ void DcgmHostEngineHandler::ProcessMessage(dcgm_connection_id_t connectionId, st
             ProcessModuleCommandMsg(connectionId, std::move(message));
             break;
 
+        case DCGM_MSG_MODULE_COMMAND_BATCH:
+            ProcessModuleCommandBatchMsg(connectionId, std::move(message));
+            break;
+
+        case DCGM_MSG_FV_STREAM_ACK:
+        {
+            /* Acks have no response */
+            auto msgBytes = message->GetMsgBytesPtr();
+            if (msgBytes->size() != sizeof(dcgm_msg_fv_stream_ack_t))
+            {
+                DCGM_LOG_ERROR << "Got a DCGM_MSG_FV_STREAM_ACK of bad size " << msgBytes->size();
+                break;
+            }
+            auto ack = (dcgm_msg_fv_stream_ack_t *)msgBytes->data();
+            m_fvStreamManager.OnAck(connectionId, message->GetRequestId(), ack->numBatches);
+            if (m_proxyManager != nullptr)
+            {
+                m_proxyManager->OnAck(connectionId, message->GetRequestId(), ack->numBatches);
+            }
+            break;
+        }
+
         default:
             DCGM_LOG_ERROR << "Unable to process msgType 0x" << std::hex << message->GetMsgType();
             break;
@@ -3119,14 +3474,15 @@ void DcgmHostEngineHandler::OnGroupRemove(unsigned int groupId)
 }
 
 /*****************************************************************************/
-void DcgmHostEngineHandler::OnFvUpdates(DcgmFvBuffer *fvBuffer,
+void DcgmHostEngineHandler::OnFvUpdates(std::shared_ptr<DcgmFvBuffer const> const &fvBuffer,
                                         DcgmWatcherType_t *watcherTypes,
                                         int numWatcherTypes,
                                         void * /*userData*/)
 {
     static dcgmModuleId_t watcherToModuleMap[DcgmWatcherTypeCount]
-        = { DcgmModuleIdCore, DcgmModuleIdCore, DcgmModuleIdHealth,  DcgmModuleIdPolicy,
-            DcgmModuleIdCore, DcgmModuleIdCore, DcgmModuleIdNvSwitch };
+        = { DcgmModuleIdCore, DcgmModuleIdCore,     DcgmModuleIdHealth, DcgmModuleIdPolicy, DcgmModuleIdCore,
+            DcgmModuleIdCore, DcgmModuleIdNvSwitch, DcgmModuleIdCore,   DcgmModuleIdCore,   DcgmModuleIdCore,
+            DcgmModuleIdCore, DcgmModuleIdCore,     DcgmModuleIdCore };
 
     /* prepare the message for sending to modules */
     dcgm_core_msg_field_values_updated_t msg;
@@ -3137,6 +3493,7 @@ void DcgmHostEngineHandler::OnFvUpdates(DcgmFvBuffer *fvBuffer,
     msg.header.subCommand  = DCGM_CORE_SR_FIELD_VALUES_UPDATED;
     msg.fieldValues.buffer = fvBuffer->GetBuffer();
     fvBuffer->GetSize(&msg.fieldValues.bufferSize, &elementCount);
+    msg.snapshot = &fvBuffer;
 
     /* Dispatch each watcher to the corresponding module */
     dcgmModuleId_t destinationModuleId;
@@ -3144,6 +3501,25 @@ void DcgmHostEngineHandler::OnFvUpdates(DcgmFvBuffer *fvBuffer,
 
     for (i = 0; i < numWatcherTypes; i++)
     {
+        if (watcherTypes[i] == DcgmWatcherTypeFvStream)
+        {
+            m_fvStreamManager.OnFvUpdates(*fvBuffer);
+            continue;
+        }
+        else if (watcherTypes[i] == DcgmWatcherTypeJobStats)
+        {
+            m_jobStatsAccumulator.OnFvUpdates(*fvBuffer);
+            continue;
+        }
+        else if (watcherTypes[i] == DcgmWatcherTypeOtlpExporter)
+        {
+            if (m_otlpExporter != nullptr)
+            {
+                m_otlpExporter->OnFvUpdates(fvBuffer);
+            }
+            continue;
+        }
+
         destinationModuleId = watcherToModuleMap[watcherTypes[i]];
         if (destinationModuleId == DcgmModuleIdCore)
         {
@@ -3164,6 +3540,8 @@ void DcgmHostEngineHandler::OnFvUpdates(DcgmFvBuffer *fvBuffer,
 /*****************************************************************************/
 void DcgmHostEngineHandler::OnMigUpdates(unsigned int gpuId)
 {
+    BumpAttributeGeneration();
+
     dcgm_core_msg_mig_updated_t msg;
     memset(&msg, 0, sizeof(msg));
     msg.header.length     = sizeof(msg);
@@ -3191,7 +3569,7 @@ void DcgmHostEngineHandler::OnMigUpdates(unsigned int gpuId)
 }
 
 /*****************************************************************************/
-static void nvHostEngineFvCallback(DcgmFvBuffer *fvBuffer,
+static void nvHostEngineFvCallback(std::shared_ptr<DcgmFvBuffer const> const &fvBuffer,
                                    DcgmWatcherType_t *watcherTypes,
                                    int numWatcherTypes,
                                    void *userData)
@@ -3207,12 +3585,67 @@ static void nvHostEngineMigCallback(unsigned int gpuId, void *userData)
     hostEngineHandler->OnMigUpdates(gpuId);
 }
 
+/*****************************************************************************/
+/* Override the load policies of modules from a DCGM_ENV_MODULE_LOAD_POLICY style list like "1=lazy,7=eager" */
+static void ParseModuleLoadPolicies(char const *value, dcgmhe_module_info_t *modules)
+{
+    if (value == nullptr || *value == '\0')
+    {
+        return;
+    }
+
+    std::stringstream ss(value);
+    std::string entry;
+    while (std::getline(ss, entry, ','))
+    {
+        size_t equals = entry.find('=');
+        if (equals == std::string::npos)
+        {
+            DCGM_LOG_WARNING << "Ignoring module load policy without '=': " << entry;
+            continue;
+        }
+
+        unsigned long moduleId = strtoul(entry.substr(0, equals).c_str(), nullptr, 10);
+        std::string_view const policy(entry.c_str() + equals + 1);
+        if (moduleId <= DcgmModuleIdCore || moduleId >= DcgmModuleIdCount)
+        {
+            DCGM_LOG_WARNING << "Ignoring module load policy of bad moduleId: " << entry;
+            continue;
+        }
+
+        if (policy == "lazy")
+        {
+            modules[moduleId].loadPolicy = DcgmModuleLoadLazy;
+        }
+        else if (policy == "eager")
+        {
+            modules[moduleId].loadPolicy = DcgmModuleLoadEager;
+        }
+        else if (policy == "prewarm")
+        {
+            modules[moduleId].loadPolicy = DcgmModuleLoadPrewarm;
+        }
+        else
+        {
+            DCGM_LOG_WARNING << "Ignoring unknown module load policy: " << entry;
+        }
+    }
+}
+
+/*****************************************************************************/
+/* Whether DCGM_ENV_IPC_WORK_STEALING asks for a work-stealing IPC worker pool */
+static bool IpcWorkStealingFromEnv(void)
+{
+    char const *workStealing = getenv(DCGM_ENV_IPC_WORK_STEALING);
+    return workStealing != nullptr && strcmp(workStealing, "1") == 0;
+}
+
 /*****************************************************************************
  Constructor for DCGM Host Engine Handler
  *****************************************************************************/
 DcgmHostEngineHandler::DcgmHostEngineHandler(dcgmStartEmbeddedV2Params_v1 params)
     : m_communicator()
-    , m_dcgmIpc(DCGM_HE_NUM_WORKERS)
+    , m_dcgmIpc(DCGM_HE_NUM_WORKERS, IpcWorkStealingFromEnv())
     , m_hostengineHealth(0)
 {
     int ret;
@@ -3247,6 +3680,15 @@ DcgmHostEngineHandler::DcgmHostEngineHandler(dcgmStartEmbeddedV2Params_v1 params
     m_modules[DcgmModuleIdDiag].filename       = "libdcgmmodulediag.so.2";
     m_modules[DcgmModuleIdProfiling].filename  = "libdcgmmoduleprofiling.so.2";
 
+    /* Multiplexed watches are sent to the profiling module directly, so they aren't intercepted again */
+    m_profMultiplexer = std::make_unique<DcgmProfMultiplexer>([this](dcgm_module_command_header_t *moduleCommand) {
+        return SendModuleMessage(DcgmModuleIdProfiling, moduleCommand);
+    });
+
+    /* Only clients that manage NvSwitches need their module, so don't hold up startup for it */
+    m_modules[DcgmModuleIdNvSwitch].loadPolicy = DcgmModuleLoadPrewarm;
+    ParseModuleLoadPolicies(getenv(DCGM_ENV_MODULE_LOAD_POLICY), m_modules);
+
     /* Apply the blacklist that was requested before we possibly load any modules */
     for (unsigned int i = 0; i < params.blackListCount; i++)
     {
@@ -3268,6 +3710,31 @@ DcgmHostEngineHandler::DcgmHostEngineHandler(dcgmStartEmbeddedV2Params_v1 params
     /* Make sure we can catch any signal sent to threads by DcgmThread */
     DcgmThread::InstallSignalHandler();
 
+    char const *traceSpans = getenv(DCGM_ENV_TRACE_SPANS);
+    if (traceSpans != nullptr)
+    {
+        DcgmNs::Tracer::Instance().Start(strtoul(traceSpans, nullptr, 10));
+    }
+
+    char const *binaryLogEntries = getenv(DCGM_ENV_BINARY_LOG_ENTRIES);
+    if (binaryLogEntries != nullptr)
+    {
+        DcgmNs::Logging::BinaryLog::Instance().Start(strtoul(binaryLogEntries, nullptr, 10));
+    }
+
+    char const *maxStoppedJobs = getenv(DCGM_ENV_MAX_STOPPED_JOBS);
+    char const *stoppedJobTtl  = getenv(DCGM_ENV_STOPPED_JOB_TTL_SEC);
+    if (maxStoppedJobs != nullptr || stoppedJobTtl != nullptr)
+    {
+        m_jobStatsAccumulator.SetRetention(
+            maxStoppedJobs ? strtoul(maxStoppedJobs, nullptr, 10) : DcgmJobStatsAccumulator::DEFAULT_MAX_STOPPED_JOBS,
+            stoppedJobTtl ? std::max(0LL, strtoll(stoppedJobTtl, nullptr, 10)) * 1000000
+                          : DcgmJobStatsAccumulator::DEFAULT_STOPPED_JOB_TTL_USEC);
+    }
+
+    /* Startup phases, logged at the end so slow starts can be tracked down */
+    timelib64_t startUsec = timelib_usecSince1970();
+
     if (NVML_SUCCESS != nvmlInit_v2())
     {
         throw std::runtime_error("Error: Failed to initialize NVML");
@@ -3315,6 +3782,8 @@ DcgmHostEngineHandler::DcgmHostEngineHandler(dcgmStartEmbeddedV2Params_v1 params
 
     /* Don't do anything before you call mpCacheManager->Init() */
 
+    timelib64_t attachStartUsec = timelib_usecSince1970();
+
     if (params.opMode == DCGM_OPERATION_MODE_AUTO)
     {
         ret = mpCacheManager->Init(0, 86400.0);
@@ -3366,10 +3835,11 @@ DcgmHostEngineHandler::DcgmHostEngineHandler(dcgmStartEmbeddedV2Params_v1 params
     mpFieldGroupManager = new DcgmFieldGroupManager();
 
     m_communicator.Init(mpCacheManager, mpGroupManager);
-    m_coreCallbacks.postfunc   = PostRequestToCore;
-    m_coreCallbacks.poster     = &m_communicator;
-    m_coreCallbacks.version    = dcgmCoreCallbacks_version;
-    m_coreCallbacks.loggerfunc = (dcgmLoggerCallback_f)DcgmLogging::appendRecordToLogger<>;
+    m_coreCallbacks.postfunc    = PostRequestToCore;
+    m_coreCallbacks.poster      = &m_communicator;
+    m_coreCallbacks.version     = dcgmCoreCallbacks_version;
+    m_coreCallbacks.loggerfunc  = (dcgmLoggerCallback_f)DcgmLogging::appendRecordToLogger<>;
+    m_coreCallbacks.cacheAccess = m_communicator.GetCacheAccess();
 
     /* Create default groups after we've set up core callbacks. This is because creating
        default groups causes the NvSwitch module to load, which in turn tries to ask m_coreCallbacks
@@ -3381,8 +3851,26 @@ DcgmHostEngineHandler::DcgmHostEngineHandler(dcgmStartEmbeddedV2Params_v1 params
         throw std::runtime_error("DCGM was unable to create default groups for the group manager.");
     }
 
+    timelib64_t modulesStartUsec = timelib_usecSince1970();
+    LoadModulesWithPolicy(DcgmModuleLoadEager);
+
+    /* The DCGM_FI_HOSTENGINE_* fields about client traffic come from the IPC layer */
+    mpCacheManager->SetHostengineStatsCallback([this](dcgmcm_hostengine_stats_t &stats) {
+        std::vector<DcgmElasticWorkerPoolParams_t> laneParams;
+        std::vector<DcgmElasticWorkerPoolStats_t> laneStats;
+        m_dcgmIpc.GetWorkerLaneStats(laneParams, laneStats);
+
+        stats.ipcQueueDepth = 0;
+        for (auto const &lane : laneStats)
+        {
+            stats.ipcQueueDepth += lane.queueDepth;
+        }
+        stats.numConnections = m_dcgmIpc.GetConnectionCount();
+    });
+
     /* Watch internal fields before we start the cache manager update thread */
-    dcgmRet = WatchHostEngineFields();
+    timelib64_t watchStartUsec = timelib_usecSince1970();
+    dcgmRet                    = WatchHostEngineFields();
     if (dcgmRet != 0)
     {
         throw std::runtime_error("WatchHostEngineFields failed.");
@@ -3398,13 +3886,24 @@ DcgmHostEngineHandler::DcgmHostEngineHandler(dcgmStartEmbeddedV2Params_v1 params
     }
 
     /* Wait for a round of updates to occur so that we can safely query values */
-    ret = mpCacheManager->UpdateAllFields(1);
+    timelib64_t updateStartUsec = timelib_usecSince1970();
+    ret                         = mpCacheManager->UpdateAllFields(1);
     if (ret != 0)
     {
         std::stringstream ss;
         ss << "CacheManager UpdateAllFields. Error: " << ret;
         throw std::runtime_error(ss.str());
     }
+
+    m_startingUp = false;
+
+    timelib64_t endUsec = timelib_usecSince1970();
+    DCGM_LOG_INFO << "Host engine started in " << (endUsec - startUsec) / 1000
+                  << " ms. NVML init: " << (attachStartUsec - startUsec) / 1000
+                  << " ms, cache manager init and GPU attach: " << (modulesStartUsec - attachStartUsec) / 1000
+                  << " ms, eager modules: " << (watchStartUsec - modulesStartUsec) / 1000
+                  << " ms, default watches: " << (updateStartUsec - watchStartUsec) / 1000
+                  << " ms, first update: " << (endUsec - updateStartUsec) / 1000 << " ms";
 }
 
 /*****************************************************************************
@@ -3417,6 +3916,46 @@ DcgmHostEngineHandler::~DcgmHostEngineHandler()
      * Always keep this first */
     m_dcgmIpc.StopAndWait(60000);
 
+    /* Disconnects from the proxied host engines */
+    m_proxyManager.reset();
+
+    /* Stops serving scrapes before the cache manager goes away */
+    m_metricsExporter.reset();
+
+    /* Unlinks the board so that readers stop using it */
+    m_latestValueBoard.reset();
+
+    /* Stops pushing. The exporter itself stays until the cache manager can't publish to it anymore */
+    if (m_otlpExporter != nullptr)
+    {
+        m_otlpExporter->StopAndWait(60000);
+    }
+
+    /* Stops rotating multiplexed profiling watches before the profiling module goes away */
+    m_profMultiplexer.reset();
+
+    if (m_prewarmThread.joinable())
+    {
+        m_prewarmThread.join();
+    }
+
+    /* Sessions still parked are saved again under their tokens */
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        m_stopSessionExpiry = true;
+    }
+    m_sessionCondition.notify_all();
+    if (m_sessionExpiryThread.joinable())
+    {
+        m_sessionExpiryThread.join();
+    }
+
+    /* While the modules can still be asked for their state */
+    SaveStateCheckpoint();
+
+    /* Without the lock, since a module command may be loading another module */
+    StopModuleCommandQueues();
+
     Lock();
     /* Free sub-modules before we unload core modules */
     for (auto &m_module : m_modules)
@@ -3438,6 +3977,7 @@ DcgmHostEngineHandler::~DcgmHostEngineHandler()
 
     deleteNotNull(mpCacheManager);
     deleteNotNull(mpFieldGroupManager);
+    m_otlpExporter.reset();
 
     for (auto &m_module : m_modules)
     {
@@ -3509,6 +4049,8 @@ dcgmReturn_t DcgmHostEngineHandler::LoadModule(dcgmModuleId_t moduleId)
     /* Get the lock so we don't try to load the module from two threads */
     Lock();
 
+    timelib64_t loadStartUsec = timelib_usecSince1970();
+
     if (m_modules[moduleId].ptr != nullptr)
     {
         /* Module was loaded by another thread while we were getting the lock */
@@ -3589,8 +4131,19 @@ dcgmReturn_t DcgmHostEngineHandler::LoadModule(dcgmModuleId_t moduleId)
     }
     else
     {
-        m_modules[moduleId].status = DcgmModuleStatusLoaded;
-        PRINT_INFO("%u", "Loaded module %u", moduleId);
+        /* The module's constructor may have asked for its own thread. See SetModuleDispatch() */
+        if (m_modules[moduleId].commandThreads > 0)
+        {
+            DcgmElasticWorkerPoolParams_t queueParams {};
+            queueParams.minWorkers = 1;
+            queueParams.maxWorkers = m_modules[moduleId].commandThreads;
+            m_modules[moduleId].commandQueue
+                = new DcgmElasticWorkerPool(queueParams, "dcgm_mod_" + std::to_string(moduleId));
+        }
+
+        m_modules[moduleId].status   = DcgmModuleStatusLoaded;
+        m_modules[moduleId].loadUsec = timelib_usecSince1970() - loadStartUsec;
+        DCGM_LOG_INFO << "Loaded module " << moduleId << " in " << m_modules[moduleId].loadUsec << " usec";
     }
 
     Unlock();
@@ -3606,20 +4159,72 @@ dcgmReturn_t DcgmHostEngineHandler::LoadModule(dcgmModuleId_t moduleId)
 
 
 /*****************************************************************************/
-int DcgmHostEngineHandler::Lock()
+dcgmReturn_t DcgmHostEngineHandler::SetModuleDispatch(dcgmModuleId_t moduleId,
+                                                      unsigned int commandThreads,
+                                                      unsigned long long inlineSubCommands)
 {
-    m_lock.lock();
+    if (moduleId <= DcgmModuleIdCore || moduleId >= DcgmModuleIdCount)
+    {
+        DCGM_LOG_ERROR << "Invalid moduleId " << moduleId;
+        return DCGM_ST_BADPARAM;
+    }
+
+    /* Only called from the module's constructor, which LoadModule() runs with our lock held.
+       LoadModule() starts the command queue once the constructor returns */
+    if (m_modules[moduleId].ptr != nullptr)
+    {
+        DCGM_LOG_ERROR << "Module " << moduleId << " can only set its dispatch while it is being loaded";
+        return DCGM_ST_NOT_SUPPORTED;
+    }
+
+    m_modules[moduleId].commandThreads    = commandThreads;
+    m_modules[moduleId].inlineSubCommands = inlineSubCommands;
+    DCGM_LOG_DEBUG << "Module " << moduleId << " commandThreads " << commandThreads << " inlineSubCommands 0x"
+                   << std::hex << inlineSubCommands;
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-int DcgmHostEngineHandler::Unlock()
+void DcgmHostEngineHandler::StopModuleCommandQueues()
 {
-    m_lock.unlock();
-    return DCGM_ST_OK;
+    for (auto &module : m_modules)
+    {
+        /* Waits for the command that is being processed. Its reply is dropped if IPC has stopped */
+        delete module.commandQueue;
+        module.commandQueue = nullptr;
+    }
 }
 
-/*
+/*****************************************************************************/
+void DcgmHostEngineHandler::LoadModulesWithPolicy(DcgmModuleLoadPolicy_t policy)
+{
+    for (unsigned int moduleId = DcgmModuleIdCore + 1; moduleId < DcgmModuleIdCount; moduleId++)
+    {
+        if (m_modules[moduleId].loadPolicy != policy || m_modules[moduleId].status != DcgmModuleStatusNotLoaded)
+        {
+            continue;
+        }
+
+        /* LoadModule() logs failures and the time each load took */
+        (void)LoadModule(static_cast<dcgmModuleId_t>(moduleId));
+    }
+}
+
+/*****************************************************************************/
+int DcgmHostEngineHandler::Lock()
+{
+    m_lock.lock();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+int DcgmHostEngineHandler::Unlock()
+{
+    m_lock.unlock();
+    return DCGM_ST_OK;
+}
+
+/*
  * Pass pointer by reference so that we can set it to NULL afterwards
  */
 template <typename T>
@@ -4427,11 +5032,25 @@ dcgmReturn_t DcgmHostEngineHandler::GetProcessInfo(unsigned int groupId, dcgmPid
     pidInfo->summary.memoryClock          = blankSummary32;
     pidInfo->summary.smClock              = blankSummary32;
 
+    /* Which GPUs the process ran on and its utilization there come from the PID index, not the history */
+    std::vector<dcgmcm_pid_gpu_stats_t> pidStats;
+    mpCacheManager->GetPidStats(pidInfo->pid, pidStats);
+
     for (gpuIdIt = gpuIds.begin(); gpuIdIt != gpuIds.end(); ++gpuIdIt)
     {
         singleInfo        = &pidInfo->gpus[pidInfo->numGpus];
         singleInfo->gpuId = *gpuIdIt;
 
+        auto gpuStats
+            = std::find_if(pidStats.begin(), pidStats.end(), [gpuIdIt](dcgmcm_pid_gpu_stats_t const &stats) {
+                  return stats.gpuId == *gpuIdIt;
+              });
+        if (gpuStats == pidStats.end() || !gpuStats->haveAccounting)
+        {
+            PRINT_DEBUG("%u %u", "Pid %u did not run on gpuId %u", pidInfo->pid, singleInfo->gpuId);
+            continue;
+        }
+
         dcgmReturn = mpCacheManager->GetLatestProcessInfo(singleInfo->gpuId, pidInfo->pid, &accountingInfo);
         if (dcgmReturn == DCGM_ST_NO_DATA)
         {
@@ -4652,33 +5271,12 @@ dcgmReturn_t DcgmHostEngineHandler::GetProcessInfo(unsigned int groupId, dcgmPid
         singleInfo->maxGpuMemoryUsed      = (long long)accountingInfo.maxMemoryUsage;
         pidInfo->summary.maxGpuMemoryUsed = (long long)accountingInfo.maxMemoryUsage;
 
-        /* Get the unique utilization sample for PIDs from the utilization Sample */
-        dcgmProcessUtilSample_t smUtil[DCGM_MAX_PID_INFO_NUM];
-        unsigned int numUniqueSmSamples = DCGM_MAX_PID_INFO_NUM;
-        mpCacheManager->GetUniquePidUtilLists(DCGM_FE_GPU,
-                                              singleInfo->gpuId,
-                                              DCGM_FI_DEV_GPU_UTIL_SAMPLES,
-                                              pidInfo->pid,
-                                              smUtil,
-                                              &numUniqueSmSamples,
-                                              startTime,
-                                              endTime);
-
-        dcgmProcessUtilSample_t memUtil[DCGM_MAX_PID_INFO_NUM];
-        unsigned int numUniqueMemSamples = DCGM_MAX_PID_INFO_NUM;
-        mpCacheManager->GetUniquePidUtilLists(DCGM_FE_GPU,
-                                              singleInfo->gpuId,
-                                              DCGM_FI_DEV_MEM_COPY_UTIL_SAMPLES,
-                                              pidInfo->pid,
-                                              memUtil,
-                                              &numUniqueMemSamples,
-                                              startTime,
-                                              endTime);
-
         /* Update the process utilization in the pidInfo*/
-        singleInfo->processUtilization.pid     = pidInfo->pid;
-        singleInfo->processUtilization.smUtil  = smUtil[0].util;
-        singleInfo->processUtilization.memUtil = memUtil[0].util;
+        singleInfo->processUtilization.pid = pidInfo->pid;
+        singleInfo->processUtilization.smUtil
+            = gpuStats->haveSmUtil ? DcgmCacheManager::PidUtilization(gpuStats->smUtil) : DCGM_INT32_BLANK;
+        singleInfo->processUtilization.memUtil
+            = gpuStats->haveMemUtil ? DcgmCacheManager::PidUtilization(gpuStats->memUtil) : DCGM_INT32_BLANK;
 
         summaryTypes[0] = DcgmcmSummaryTypeDifference;
         mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
@@ -4874,32 +5472,74 @@ dcgmReturn_t DcgmHostEngineHandler::GetProcessInfo(unsigned int groupId, dcgmPid
 }
 
 
+/*****************************************************************************/
+void DcgmHostEngineHandler::UpdateJobStatsWatches(std::vector<unsigned int> const &gpuIds)
+{
+    DcgmWatcher watcher(DcgmWatcherTypeJobStats);
+
+    /* Starting and stopping jobs on the same GPU from different threads can report the GPU as new and unused in
+       either order. Follow whether the GPU has running jobs right now rather than what was reported */
+    std::lock_guard<std::mutex> lock(m_jobStatsWatchMutex);
+
+    for (unsigned int gpuId : gpuIds)
+    {
+        bool watch = m_jobStatsAccumulator.HasRunningJobs(gpuId);
+
+        for (unsigned short fieldId : DcgmJobStatsAccumulator::GetFieldIds())
+        {
+            if (!watch)
+            {
+                mpCacheManager->RemoveFieldWatch(DCGM_FE_GPU, gpuId, fieldId, 0, watcher);
+                continue;
+            }
+
+            /* Only subscribe to the samples the user's job field watches (see WatchJobFields()) gather. The cache
+               takes the fastest frequency and shortest retention across watchers, so these must not be faster
+               or shorter */
+            dcgmReturn_t dcgmReturn
+                = mpCacheManager->AddFieldWatch(DCGM_FE_GPU, gpuId, fieldId, 3600000000, 86400.0, 0, watcher, true);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                DCGM_LOG_ERROR << "Got " << dcgmReturn << " watching fieldId " << fieldId << " of gpuId " << gpuId
+                               << " for job stats";
+            }
+        }
+    }
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmHostEngineHandler::JobStartStats(std::string const &jobId, unsigned int groupId)
 {
-    jobIdMap_t::iterator it;
+    std::vector<dcgmGroupEntityPair_t> entities;
+    std::vector<unsigned int> gpuIds;
+    std::vector<unsigned int> newGpuIds;
 
-    /* If the entry already exists return error to provide unique key. Override it with */
-    Lock();
-    it = mJobIdMap.find(jobId);
-    if (it == mJobIdMap.end())
-    {
-        /* Insert it as a record */
-        jobRecord_t record;
-        record.startTime = timelib_usecSince1970();
-        record.endTime   = 0;
-        record.groupId   = groupId;
-        mJobIdMap.insert(make_pair(jobId, record));
-        Unlock();
+    /* Job stats are only supported for GPUs */
+    dcgmReturn_t dcgmReturn = mpGroupManager->GetGroupEntities(0, groupId, entities);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        PRINT_ERROR("%d", "Error %d from GetGroupEntities()", (int)dcgmReturn);
+        return dcgmReturn;
     }
-    else
+
+    for (auto const &entity : entities)
+    {
+        if (entity.entityGroupId == DCGM_FE_GPU)
+        {
+            gpuIds.push_back(entity.entityId);
+        }
+    }
+
+    /* Fold samples into the job's stats as they arrive so JobGetStats() doesn't need to walk the whole job */
+    dcgmReturn = m_jobStatsAccumulator.AddJob(jobId, groupId, timelib_usecSince1970(), gpuIds, newGpuIds);
+    if (dcgmReturn != DCGM_ST_OK)
     {
-        Unlock();
         PRINT_ERROR("%s", "Duplicate JobId as input : %s", jobId.c_str());
-        /* Implies that the entry corresponding to the job id already exists */
-        return DCGM_ST_DUPLICATE_KEY;
+        return dcgmReturn;
     }
 
+    UpdateJobStatsWatches(newGpuIds);
+
     return DCGM_ST_OK;
 }
 
@@ -4907,22 +5547,16 @@ dcgmReturn_t DcgmHostEngineHandler::JobStartStats(std::string const &jobId, unsi
 /*****************************************************************************/
 dcgmReturn_t DcgmHostEngineHandler::JobStopStats(std::string const &jobId)
 {
-    jobIdMap_t::iterator it;
+    std::vector<unsigned int> unusedGpuIds;
 
-    /* If the entry already exists return error to provide unique key. Override it with */
-    Lock();
-    it = mJobIdMap.find(jobId);
-    if (it == mJobIdMap.end())
+    dcgmReturn_t dcgmReturn = m_jobStatsAccumulator.StopJob(jobId, timelib_usecSince1970(), unusedGpuIds);
+    if (dcgmReturn != DCGM_ST_OK)
     {
-        Unlock();
         PRINT_ERROR("%s", "Can't find entry corresponding to the Job Id : %s", jobId.c_str());
-        return DCGM_ST_NO_DATA;
+        return dcgmReturn;
     }
 
-    jobRecord_t *pRecord = &(it->second);
-    pRecord->endTime     = timelib_usecSince1970();
-
-    Unlock();
+    UpdateJobStatsWatches(unusedGpuIds);
 
     return DCGM_ST_OK;
 }
@@ -4964,14 +5598,55 @@ dcgmReturn_t DcgmHostEngineHandler::HelperHealthCheck(unsigned int groupId,
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJobInfo_t *pJobInfo)
+/* Like HelperGetInt64StatSummary() but from the accumulated stats of a job's GPU */
+static dcgmReturn_t helperGetJobInt64StatSummary(DcgmJobGpuStats const &gpuStats,
+                                                 unsigned short fieldId,
+                                                 dcgmStatSummaryInt64_t *summary)
+{
+    DcgmcmSummaryType_t summaryTypes[3]
+        = { DcgmcmSummaryTypeMinimum, DcgmcmSummaryTypeMaximum, DcgmcmSummaryTypeAverage };
+    long long summaryValues[3];
+
+    dcgmReturn_t dcgmReturn = gpuStats.GetSummaries(fieldId, 3, summaryTypes, summaryValues);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    /* Same indexes as summaryTypes[] */
+    summary->minValue = summaryValues[0];
+    summary->maxValue = summaryValues[1];
+    summary->average  = summaryValues[2];
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+/* Like HelperGetInt32StatSummary() but from the accumulated stats of a job's GPU */
+static dcgmReturn_t helperGetJobInt32StatSummary(DcgmJobGpuStats const &gpuStats,
+                                                 unsigned short fieldId,
+                                                 dcgmStatSummaryInt32_t *summary)
+{
+    dcgmStatSummaryInt64_t summary64;
+
+    dcgmReturn_t dcgmReturn = helperGetJobInt64StatSummary(gpuStats, fieldId, &summary64);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    summary->average  = nvcmvalue_int64_to_int32(summary64.average);
+    summary->maxValue = nvcmvalue_int64_to_int32(summary64.maxValue);
+    summary->minValue = nvcmvalue_int64_to_int32(summary64.minValue);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId,
+                                                dcgmJobInfo_t *pJobInfo,
+                                                unsigned long long *updateSequence)
 {
-    jobIdMap_t::iterator it;
-    jobRecord_t *pRecord;
     unsigned int groupId;
-    std::vector<dcgmGroupEntityPair_t> entities;
-    std::vector<unsigned int> gpuIds;
-    std::vector<unsigned int>::iterator gpuIdIt;
+    DcgmJobStatsSnapshot job;
     dcgmGpuUsageInfo_t *singleInfo;
     dcgmReturn_t dcgmReturn = DCGM_ST_OK;
     dcgmDevicePidAccountingStats_t accountingInfo;
@@ -4981,8 +5656,6 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
     DcgmcmSummaryType_t summaryTypes[DcgmcmSummaryTypeSize];
     int i;
     double doubleVals[DcgmcmSummaryTypeSize];
-    int Msamples = 10; /* Should match size of samples[] */
-    dcgmcm_sample_t samples[10];
     dcgmStatSummaryInt32_t blankSummary32  = { DCGM_INT32_BLANK, DCGM_INT32_BLANK, DCGM_INT32_BLANK };
     dcgmStatSummaryInt64_t blankSummary64  = { DCGM_INT64_BLANK, DCGM_INT64_BLANK, DCGM_INT64_BLANK };
     dcgmStatSummaryFp64_t blankSummaryFP64 = { DCGM_FP64_BLANK, DCGM_FP64_BLANK, DCGM_FP64_BLANK };
@@ -4994,29 +5667,29 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         return DCGM_ST_VER_MISMATCH;
     }
 
-    /* If entry can't be found then return error back to the caller */
-    Lock();
-    it = mJobIdMap.find(jobId);
-    if (it == mJobIdMap.end())
+    /* The job, the GPUs of its group when it started and what was accumulated for them since */
+    dcgmReturn = m_jobStatsAccumulator.GetJobStats(jobId, job);
+    if (dcgmReturn != DCGM_ST_OK)
     {
-        Unlock();
         PRINT_ERROR("%s", "Can't find entry corresponding to the Job Id : %s", jobId.c_str());
-        return DCGM_ST_NO_DATA;
+        return dcgmReturn;
     }
 
-    pRecord   = &it->second;
-    groupId   = pRecord->groupId;
-    startTime = pRecord->startTime;
+    groupId   = job.groupId;
+    startTime = job.startTime;
+    if (updateSequence != nullptr)
+    {
+        *updateSequence = job.updateSequence;
+    }
 
-    if (pRecord->endTime == 0)
+    if (job.endTime == 0)
     {
         endTime = (long long)timelib_usecSince1970();
     }
     else
     {
-        endTime = (long long)pRecord->endTime;
+        endTime = (long long)job.endTime;
     }
-    Unlock();
 
     if (startTime > endTime)
     {
@@ -5027,25 +5700,6 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    /* Resolve the groupId -> entities[] -> gpuIds[] */
-    dcgmReturn = mpGroupManager->GetGroupEntities(0, groupId, entities);
-    if (dcgmReturn != DCGM_ST_OK)
-    {
-        PRINT_ERROR("%d", "Error %d from GetGroupEntities()", (int)dcgmReturn);
-        return dcgmReturn;
-    }
-
-    /* Process stats are only supported for GPUs for now */
-    for (i = 0; i < (int)entities.size(); i++)
-    {
-        if (entities[i].entityGroupId != DCGM_FE_GPU)
-        {
-            continue;
-        }
-
-        gpuIds.push_back(entities[i].entityId);
-    }
-
     /* Initialize a health response to be populated later */
     dcgmHealthResponse_v4 response = {};
 
@@ -5078,10 +5732,10 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
     pJobInfo->summary.startTime = startTime;
     pJobInfo->summary.endTime   = endTime;
 
-    for (gpuIdIt = gpuIds.begin(); gpuIdIt != gpuIds.end(); ++gpuIdIt)
+    for (DcgmJobGpuStats const &gpuStats : job.gpus)
     {
         singleInfo        = &pJobInfo->gpus[pJobInfo->numGpus];
-        singleInfo->gpuId = *gpuIdIt;
+        singleInfo->gpuId = gpuStats.gpuId;
 
         /* Increment GPU count now that we know the process ran on this GPU */
         pJobInfo->numGpus++;
@@ -5091,29 +5745,11 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         summaryTypes[2] = DcgmcmSummaryTypeMaximum;
         summaryTypes[3] = DcgmcmSummaryTypeAverage;
 
-        mpCacheManager->GetFp64SummaryData(DCGM_FE_GPU,
-                                           singleInfo->gpuId,
-                                           DCGM_FI_DEV_POWER_USAGE,
-                                           4,
-                                           &summaryTypes[0],
-                                           &doubleVals[0],
-                                           startTime,
-                                           endTime,
-                                           nullptr,
-                                           nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_POWER_USAGE, 4, &summaryTypes[0], &doubleVals[0]);
 
         /* See if the energy counter is supported. If so, use that rather than integrating the power usage */
         summaryTypes[0] = DcgmcmSummaryTypeDifference;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION,
-                                            1,
-                                            &summaryTypes[0],
-                                            &i64Val,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION, 1, &summaryTypes[0], &i64Val);
         if (!DCGM_INT64_IS_BLANK(i64Val))
         {
             singleInfo->energyConsumed = i64Val;
@@ -5164,18 +5800,8 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
          * GPUS. One GPUs minimum could occur at a different time than another GPU's minimum
          */
 
-        DcgmHostEngineHandler::Instance()->HelperGetInt64StatSummary(DCGM_FE_GPU,
-                                                                     singleInfo->gpuId,
-                                                                     DCGM_FI_DEV_PCIE_RX_THROUGHPUT,
-                                                                     &singleInfo->pcieRxBandwidth,
-                                                                     startTime,
-                                                                     endTime);
-        DcgmHostEngineHandler::Instance()->HelperGetInt64StatSummary(DCGM_FE_GPU,
-                                                                     singleInfo->gpuId,
-                                                                     DCGM_FI_DEV_PCIE_TX_THROUGHPUT,
-                                                                     &singleInfo->pcieTxBandwidth,
-                                                                     startTime,
-                                                                     endTime);
+        helperGetJobInt64StatSummary(gpuStats, DCGM_FI_DEV_PCIE_RX_THROUGHPUT, &singleInfo->pcieRxBandwidth);
+        helperGetJobInt64StatSummary(gpuStats, DCGM_FI_DEV_PCIE_TX_THROUGHPUT, &singleInfo->pcieTxBandwidth);
 
         /* If the PCIE Tx BW is blank, update the average with the PCIE Tx BW value as 0 for this GPU*/
         if (DCGM_INT64_IS_BLANK(singleInfo->pcieTxBandwidth.average))
@@ -5204,16 +5830,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
             = (pJobInfo->summary.pcieRxBandwidth.average * (pJobInfo->numGpus - 1) + fieldValue) / (pJobInfo->numGpus);
 
         summaryTypes[0] = DcgmcmSummaryTypeMaximum;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
-                                            1,
-                                            &summaryTypes[0],
-                                            &singleInfo->pcieReplays,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_PCIE_REPLAY_COUNTER, 1, &summaryTypes[0], &singleInfo->pcieReplays);
         if (!DCGM_INT64_IS_BLANK(singleInfo->pcieReplays))
         {
             if (DCGM_INT64_IS_BLANK(pJobInfo->summary.pcieReplays))
@@ -5229,8 +5846,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         singleInfo->startTime = startTime;
         singleInfo->endTime   = endTime;
 
-        DcgmHostEngineHandler::Instance()->HelperGetInt32StatSummary(
-            DCGM_FE_GPU, singleInfo->gpuId, DCGM_FI_DEV_GPU_UTIL, &singleInfo->smUtilization, startTime, endTime);
+        helperGetJobInt32StatSummary(gpuStats, DCGM_FI_DEV_GPU_UTIL, &singleInfo->smUtilization);
 
         /* If the SM utilization is blank, update the average with the SM utilization value as 0 for this GPU*/
         if (DCGM_INT32_IS_BLANK(singleInfo->smUtilization.average))
@@ -5245,12 +5861,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         pJobInfo->summary.smUtilization.average
             = (pJobInfo->summary.smUtilization.average * (pJobInfo->numGpus - 1) + fieldValue) / (pJobInfo->numGpus);
 
-        DcgmHostEngineHandler::Instance()->HelperGetInt32StatSummary(DCGM_FE_GPU,
-                                                                     singleInfo->gpuId,
-                                                                     DCGM_FI_DEV_MEM_COPY_UTIL,
-                                                                     &singleInfo->memoryUtilization,
-                                                                     startTime,
-                                                                     endTime);
+        helperGetJobInt32StatSummary(gpuStats, DCGM_FI_DEV_MEM_COPY_UTIL, &singleInfo->memoryUtilization);
 
         /* If  mem utilization is blank, update the average with the mem utilization value as 0 for this GPU*/
         if (DCGM_INT32_IS_BLANK(singleInfo->memoryUtilization.average))
@@ -5267,16 +5878,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
               / (pJobInfo->numGpus);
 
         summaryTypes[0] = DcgmcmSummaryTypeMaximum;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_ECC_DBE_VOL_TOTAL,
-                                            1,
-                                            &summaryTypes[0],
-                                            &i64Val,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_ECC_DBE_VOL_TOTAL, 1, &summaryTypes[0], &i64Val);
         singleInfo->eccDoubleBit = nvcmvalue_int64_to_int32(i64Val);
 
         if (!DCGM_INT32_IS_BLANK(singleInfo->eccDoubleBit))
@@ -5291,8 +5893,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
             }
         }
 
-        DcgmHostEngineHandler::Instance()->HelperGetInt32StatSummary(
-            DCGM_FE_GPU, singleInfo->gpuId, DCGM_FI_DEV_SM_CLOCK, &singleInfo->smClock, startTime, endTime);
+        helperGetJobInt32StatSummary(gpuStats, DCGM_FI_DEV_SM_CLOCK, &singleInfo->smClock);
 
         /* If  SM clock is blank, update the average with the SM  clock value as 0 for this GPU*/
         if (DCGM_INT32_IS_BLANK(singleInfo->smClock.average))
@@ -5307,8 +5908,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         pJobInfo->summary.smClock.average
             = (pJobInfo->summary.smClock.average * (pJobInfo->numGpus - 1) + fieldValue) / (pJobInfo->numGpus);
 
-        DcgmHostEngineHandler::Instance()->HelperGetInt32StatSummary(
-            DCGM_FE_GPU, singleInfo->gpuId, DCGM_FI_DEV_MEM_CLOCK, &singleInfo->memoryClock, startTime, endTime);
+        helperGetJobInt32StatSummary(gpuStats, DCGM_FI_DEV_MEM_CLOCK, &singleInfo->memoryClock);
 
         /* If memory clock is blank, update the average with the memory clock  value as 0 for this GPU*/
         if (DCGM_INT32_IS_BLANK(singleInfo->memoryClock.average))
@@ -5324,46 +5924,23 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
             = (pJobInfo->summary.memoryClock.average * (pJobInfo->numGpus - 1) + fieldValue) / (pJobInfo->numGpus);
 
 
-        singleInfo->numXidCriticalErrors = Msamples;
-        dcgmReturn                       = mpCacheManager->GetSamples(DCGM_FE_GPU,
-                                                singleInfo->gpuId,
-                                                DCGM_FI_DEV_XID_ERRORS,
-                                                samples,
-                                                &singleInfo->numXidCriticalErrors,
-                                                startTime,
-                                                endTime,
-                                                DCGM_ORDER_ASCENDING);
-        if (dcgmReturn != DCGM_ST_OK)
-        {
-            DCGM_LOG_ERROR << "Got " << dcgmReturn << " from GetSamples()";
-            /* Keep going. We used to just ignore this return */
-        }
-
+        singleInfo->numXidCriticalErrors = (int)gpuStats.xidTimestamps.size();
         for (i = 0; i < singleInfo->numXidCriticalErrors; i++)
         {
-            singleInfo->xidCriticalErrorsTs[i] = samples[i].timestamp;
+            singleInfo->xidCriticalErrorsTs[i] = gpuStats.xidTimestamps[i];
             if (pJobInfo->summary.numXidCriticalErrors
                 < (int)DCGM_ARRAY_CAPACITY(pJobInfo->summary.xidCriticalErrorsTs))
             {
-                pJobInfo->summary.xidCriticalErrorsTs[pJobInfo->summary.numXidCriticalErrors] = samples[i].timestamp;
+                pJobInfo->summary.xidCriticalErrorsTs[pJobInfo->summary.numXidCriticalErrors]
+                    = gpuStats.xidTimestamps[i];
                 pJobInfo->summary.numXidCriticalErrors++;
             }
         }
-        mpCacheManager->FreeSamples(samples, singleInfo->numXidCriticalErrors, DCGM_FI_DEV_XID_ERRORS);
 
-        singleInfo->numComputePids = (int)DCGM_ARRAY_CAPACITY(singleInfo->computePidInfo);
-        dcgmReturn                 = mpCacheManager->GetUniquePidLists(DCGM_FE_GPU,
-                                                       singleInfo->gpuId,
-                                                       DCGM_FI_DEV_COMPUTE_PIDS,
-                                                       0,
-                                                       singleInfo->computePidInfo,
-                                                       (unsigned int *)&singleInfo->numComputePids,
-                                                       startTime,
-                                                       endTime);
-        if (dcgmReturn != DCGM_ST_OK)
+        singleInfo->numComputePids = (int)gpuStats.computePids.size();
+        for (i = 0; i < singleInfo->numComputePids; i++)
         {
-            DCGM_LOG_ERROR << "Got " << dcgmReturn << " from GetUniquePidLists()";
-            /* Keep going. We used to just ignore this return */
+            singleInfo->computePidInfo[i].pid = gpuStats.computePids[i];
         }
 
         mergeUniquePidInfo(pJobInfo->summary.computePidInfo,
@@ -5372,19 +5949,10 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
                            singleInfo->computePidInfo,
                            singleInfo->numComputePids);
 
-        singleInfo->numGraphicsPids = (int)DCGM_ARRAY_CAPACITY(singleInfo->graphicsPidInfo);
-        dcgmReturn                  = mpCacheManager->GetUniquePidLists(DCGM_FE_GPU,
-                                                       singleInfo->gpuId,
-                                                       DCGM_FI_DEV_GRAPHICS_PIDS,
-                                                       0,
-                                                       singleInfo->graphicsPidInfo,
-                                                       (unsigned int *)&singleInfo->numGraphicsPids,
-                                                       startTime,
-                                                       endTime);
-        if (dcgmReturn != DCGM_ST_OK)
+        singleInfo->numGraphicsPids = (int)gpuStats.graphicsPids.size();
+        for (i = 0; i < singleInfo->numGraphicsPids; i++)
         {
-            DCGM_LOG_ERROR << "Got " << dcgmReturn << " from GetUniquePidLists()";
-            /* Keep going. We used to just ignore this return */
+            singleInfo->graphicsPidInfo[i].pid = gpuStats.graphicsPids[i];
         }
 
         mergeUniquePidInfo(pJobInfo->summary.graphicsPidInfo,
@@ -5393,32 +5961,15 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
                            singleInfo->graphicsPidInfo,
                            singleInfo->numGraphicsPids);
 
-        /* Get the max memory usage for the GPU and summary option for compute PIDs */
-        for (i = 0; i < singleInfo->numComputePids; i++)
-        {
-            // Get max memory usage for all the processes on the GPU
-            dcgmReturn = mpCacheManager->GetLatestProcessInfo(
-                singleInfo->gpuId, singleInfo->computePidInfo[i].pid, &accountingInfo);
-            if (DCGM_ST_OK == dcgmReturn)
-            {
-                if ((long long)accountingInfo.maxMemoryUsage > singleInfo->maxGpuMemoryUsed)
-                {
-                    singleInfo->maxGpuMemoryUsed = (long long)accountingInfo.maxMemoryUsage;
-                }
-
-                if ((long long)accountingInfo.maxMemoryUsage > pJobInfo->summary.maxGpuMemoryUsed)
-                {
-                    pJobInfo->summary.maxGpuMemoryUsed = (long long)accountingInfo.maxMemoryUsage;
-                }
-            }
-        }
-
-        /* Get the max memory usage for the GPU and summary option for Graphics PIDs */
-        for (i = 0; i < singleInfo->numGraphicsPids; i++)
+        /* Get the max memory usage for the GPU and summary option from every process that ran during the job,
+         * including ones too short-lived to show up in the compute and graphics PID lists
+         */
+        std::vector<dcgm_process_interval_t> processes;
+        mpCacheManager->GetProcessesInWindow(
+            singleInfo->gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, startTime, endTime, processes);
+        for (dcgm_process_interval_t const &process : processes)
         {
-            // Get max memory usage for all the processes on the GPU
-            dcgmReturn = mpCacheManager->GetLatestProcessInfo(
-                singleInfo->gpuId, singleInfo->graphicsPidInfo[i].pid, &accountingInfo);
+            dcgmReturn = mpCacheManager->GetLatestProcessInfo(singleInfo->gpuId, process.pid, &accountingInfo);
             if (DCGM_ST_OK == dcgmReturn)
             {
                 if ((long long)accountingInfo.maxMemoryUsage > singleInfo->maxGpuMemoryUsed)
@@ -5470,16 +6021,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
 
 
         summaryTypes[0] = DcgmcmSummaryTypeDifference;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_POWER_VIOLATION,
-                                            1,
-                                            &summaryTypes[0],
-                                            &i64Val,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_POWER_VIOLATION, 1, &summaryTypes[0], &i64Val);
         singleInfo->powerViolationTime = i64Val;
         if (!DCGM_INT64_IS_BLANK(i64Val))
         {
@@ -5494,16 +6036,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         }
 
         summaryTypes[0] = DcgmcmSummaryTypeDifference;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_THERMAL_VIOLATION,
-                                            1,
-                                            &summaryTypes[0],
-                                            &i64Val,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_THERMAL_VIOLATION, 1, &summaryTypes[0], &i64Val);
         singleInfo->thermalViolationTime = i64Val;
         if (!DCGM_INT64_IS_BLANK(i64Val))
         {
@@ -5518,16 +6051,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         }
 
         summaryTypes[0] = DcgmcmSummaryTypeDifference;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_RELIABILITY_VIOLATION,
-                                            1,
-                                            &summaryTypes[0],
-                                            &i64Val,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_RELIABILITY_VIOLATION, 1, &summaryTypes[0], &i64Val);
         singleInfo->reliabilityViolationTime = i64Val;
         if (!DCGM_INT64_IS_BLANK(i64Val))
         {
@@ -5542,16 +6066,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         }
 
         summaryTypes[0] = DcgmcmSummaryTypeDifference;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_BOARD_LIMIT_VIOLATION,
-                                            1,
-                                            &summaryTypes[0],
-                                            &i64Val,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_BOARD_LIMIT_VIOLATION, 1, &summaryTypes[0], &i64Val);
         singleInfo->boardLimitViolationTime = i64Val;
         if (!DCGM_INT64_IS_BLANK(i64Val))
         {
@@ -5566,16 +6081,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         }
 
         summaryTypes[0] = DcgmcmSummaryTypeDifference;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_LOW_UTIL_VIOLATION,
-                                            1,
-                                            &summaryTypes[0],
-                                            &i64Val,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_LOW_UTIL_VIOLATION, 1, &summaryTypes[0], &i64Val);
         singleInfo->lowUtilizationTime = i64Val;
         if (!DCGM_INT64_IS_BLANK(i64Val))
         {
@@ -5590,16 +6096,7 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
         }
 
         summaryTypes[0] = DcgmcmSummaryTypeDifference;
-        mpCacheManager->GetInt64SummaryData(DCGM_FE_GPU,
-                                            singleInfo->gpuId,
-                                            DCGM_FI_DEV_SYNC_BOOST_VIOLATION,
-                                            1,
-                                            &summaryTypes[0],
-                                            &i64Val,
-                                            startTime,
-                                            endTime,
-                                            nullptr,
-                                            nullptr);
+        gpuStats.GetSummaries(DCGM_FI_DEV_SYNC_BOOST_VIOLATION, 1, &summaryTypes[0], &i64Val);
         singleInfo->syncBoostTime = i64Val;
         if (!DCGM_INT64_IS_BLANK(i64Val))
         {
@@ -5650,23 +6147,125 @@ dcgmReturn_t DcgmHostEngineHandler::JobGetStats(const std::string &jobId, dcgmJo
     return DCGM_ST_OK;
 }
 
+/*****************************************************************************/
+static void helperSetPercentiles(DcgmQuantileSketch const &sketch, dcgmStatPercentilesFp64_t &percentiles)
+{
+    /* Quantile() is blank for an empty sketch */
+    percentiles.p50 = sketch.Quantile(0.50);
+    percentiles.p95 = sketch.Quantile(0.95);
+    percentiles.p99 = sketch.Quantile(0.99);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::JobGetStatsSince(std::string const &jobId,
+                                                     unsigned long long &updateSequence,
+                                                     dcgmJobInfo_t *pJobInfo)
+{
+    if (pJobInfo->version != dcgmJobInfo_version)
+    {
+        DCGM_LOG_WARNING << "Version mismatch. expected " << dcgmJobInfo_version << ". Got " << pJobInfo->version;
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    unsigned long long jobSequence = 0;
+    dcgmReturn_t dcgmReturn        = m_jobStatsAccumulator.GetJobUpdateSequence(jobId, jobSequence);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Can't find entry corresponding to the Job Id : " << jobId;
+        return dcgmReturn;
+    }
+
+    if (jobSequence == updateSequence)
+    {
+        return DCGM_ST_OK;
+    }
+
+    return JobGetStats(jobId, pJobInfo, &updateSequence);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::JobGetPercentiles(std::string const &jobId, dcgmJobPercentiles_t &percentiles)
+{
+    using Member = dcgmStatPercentilesFp64_t dcgmGpuUsagePercentiles_t::*;
+    static std::pair<unsigned short, Member> const gauges[] = {
+        { DCGM_FI_DEV_POWER_USAGE, &dcgmGpuUsagePercentiles_t::powerUsage },
+        { DCGM_FI_DEV_PCIE_RX_THROUGHPUT, &dcgmGpuUsagePercentiles_t::pcieRxBandwidth },
+        { DCGM_FI_DEV_PCIE_TX_THROUGHPUT, &dcgmGpuUsagePercentiles_t::pcieTxBandwidth },
+        { DCGM_FI_DEV_GPU_UTIL, &dcgmGpuUsagePercentiles_t::smUtilization },
+        { DCGM_FI_DEV_MEM_COPY_UTIL, &dcgmGpuUsagePercentiles_t::memoryUtilization },
+        { DCGM_FI_DEV_MEM_CLOCK, &dcgmGpuUsagePercentiles_t::memoryClock },
+        { DCGM_FI_DEV_SM_CLOCK, &dcgmGpuUsagePercentiles_t::smClock },
+    };
+    constexpr size_t numGauges = sizeof(gauges) / sizeof(gauges[0]);
+
+    if (percentiles.version != dcgmJobPercentiles_version)
+    {
+        DCGM_LOG_WARNING << "Version mismatch. Expected " << dcgmJobPercentiles_version << ". Got "
+                         << percentiles.version;
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    DcgmJobStatsSnapshot job;
+    dcgmReturn_t dcgmReturn = m_jobStatsAccumulator.GetJobStats(jobId, job);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Can't find entry corresponding to the Job Id : " << jobId;
+        return dcgmReturn;
+    }
+
+    percentiles.numGpus = 0;
+    memset(&percentiles.summary, 0, sizeof(percentiles.summary));
+    memset(&percentiles.gpus[0], 0, sizeof(percentiles.gpus));
+    percentiles.summary.gpuId = DCGM_INT32_BLANK;
+
+    /* Sketches merge without losing accuracy, so the summary is of every sample of every GPU */
+    std::array<DcgmQuantileSketch, numGauges> merged;
+
+    for (DcgmJobGpuStats const &gpuStats : job.gpus)
+    {
+        if (percentiles.numGpus >= DCGM_MAX_NUM_DEVICES)
+        {
+            break;
+        }
+
+        dcgmGpuUsagePercentiles_t &gpuPercentiles = percentiles.gpus[percentiles.numGpus++];
+        gpuPercentiles.gpuId                      = gpuStats.gpuId;
+
+        for (size_t i = 0; i < numGauges; i++)
+        {
+            DcgmQuantileSketch const *sketch = gpuStats.GetSketch(gauges[i].first);
+            if (sketch == nullptr)
+            {
+                helperSetPercentiles(DcgmQuantileSketch(), gpuPercentiles.*gauges[i].second);
+                continue;
+            }
+
+            helperSetPercentiles(*sketch, gpuPercentiles.*gauges[i].second);
+            merged[i].Merge(*sketch);
+        }
+    }
+
+    for (size_t i = 0; i < numGauges; i++)
+    {
+        helperSetPercentiles(merged[i], percentiles.summary.*gauges[i].second);
+    }
+
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmHostEngineHandler::JobRemove(std::string const &jobId)
 {
-    jobIdMap_t::iterator it;
+    std::vector<unsigned int> unusedGpuIds;
 
-    /* If the entry already exists return error to provide unique key. Override it with */
-    Lock();
-    it = mJobIdMap.find(jobId);
-    if (it == mJobIdMap.end())
+    dcgmReturn_t dcgmReturn = m_jobStatsAccumulator.RemoveJob(jobId, unusedGpuIds);
+    if (dcgmReturn != DCGM_ST_OK)
     {
-        Unlock();
         PRINT_ERROR("%s", "JobRemove: Can't find jobId : %s", jobId.c_str());
-        return DCGM_ST_NO_DATA;
+        return dcgmReturn;
     }
 
-    mJobIdMap.erase(it);
-    Unlock();
+    UpdateJobStatsWatches(unusedGpuIds);
 
     PRINT_DEBUG("%s", "JobRemove: Removed jobId %s", jobId.c_str());
     return DCGM_ST_OK;
@@ -5675,12 +6274,10 @@ dcgmReturn_t DcgmHostEngineHandler::JobRemove(std::string const &jobId)
 /*****************************************************************************/
 dcgmReturn_t DcgmHostEngineHandler::JobRemoveAll()
 {
-    jobIdMap_t::iterator it;
+    std::vector<unsigned int> unusedGpuIds;
 
-    /* If the entry already exists return error to provide unique key. Override it with */
-    Lock();
-    mJobIdMap.clear();
-    Unlock();
+    m_jobStatsAccumulator.RemoveAllJobs(unusedGpuIds);
+    UpdateJobStatsWatches(unusedGpuIds);
 
     PRINT_DEBUG("", "JobRemoveAll: Removed all jobs");
     return DCGM_ST_OK;
@@ -5706,7 +6303,8 @@ dcgmReturn_t DcgmHostEngineHandler::WatchFieldGroup(unsigned int groupId,
                                                     timelib64_t monitorFrequencyUsec,
                                                     double maxSampleAge,
                                                     int maxKeepSamples,
-                                                    DcgmWatcher const &watcher)
+                                                    DcgmWatcher const &watcher,
+                                                    bool snapshot)
 {
     int i;
     int j;
@@ -5758,6 +6356,30 @@ dcgmReturn_t DcgmHostEngineHandler::WatchFieldGroup(unsigned int groupId,
         }
     }
 
+    if (snapshot)
+    {
+        std::vector<dcgmcm_entity_key_t> keys;
+        for (dcgmGroupEntityPair_t const &entity : entities)
+        {
+            for (unsigned short fieldId : fieldIds)
+            {
+                dcgmcm_entity_key_t key {};
+                key.entityGroupId = entity.entityGroupId;
+                key.entityId      = entity.entityId;
+                key.fieldId       = fieldId;
+                keys.push_back(key);
+            }
+        }
+
+        /* Profiling fields are sampled by their module, so they are watched but left out of the group */
+        dcgmReturn = mpCacheManager->AddSnapshotGroup(keys, watcher);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_WARNING << "None of the watches of field group " << (uintptr_t)fieldGroupId
+                             << " can be fetched as a snapshot group. Got " << errorString(dcgmReturn);
+        }
+    }
+
     /* Add profiling watches after the watches exist in the cache manager so that
        quota policy is in place */
     helper_get_prof_field_ids(fieldIds, profFieldIds);
@@ -5889,144 +6511,1020 @@ dcgmReturn_t DcgmHostEngineHandler::UnwatchFieldGroup(unsigned int groupId,
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmHostEngineHandler::WatchFieldGroupAllGpus(dcgmFieldGrp_t fieldGroupId,
-                                                           timelib64_t monitorFrequencyUsec,
-                                                           double maxSampleAge,
-                                                           int maxKeepSamples,
-                                                           int activeOnly,
-                                                           DcgmWatcher const &watcher)
+dcgmReturn_t DcgmHostEngineHandler::SubscribeFieldValueStream(dcgm_connection_id_t connectionId,
+                                                              dcgm_request_id_t requestId,
+                                                              unsigned int groupId,
+                                                              dcgmFieldGrp_t fieldGroupId,
+                                                              timelib64_t monitorFrequencyUsec,
+                                                              double maxSampleAge,
+                                                              int maxKeepSamples,
+                                                              unsigned int maxBatchesInFlight,
+                                                              unsigned int maxPendingValues)
 {
-    int i;
-    int j;
     dcgmReturn_t dcgmReturn;
-    std::vector<unsigned int> gpuIds;
+    std::vector<dcgmGroupEntityPair_t> entities;
     std::vector<unsigned short> fieldIds;
+    std::vector<dcgm_fv_stream_key_t> keys;
+    DcgmWatcher watcher(DcgmWatcherTypeFvStream, connectionId);
 
-    dcgmReturn = mpCacheManager->GetGpuIds(activeOnly, gpuIds);
+    if (requestId == DCGM_REQUEST_ID_NONE)
+    {
+        DCGM_LOG_ERROR << "A field value stream needs a requestId to send batches to";
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmReturn = mpGroupManager->GetGroupEntities(connectionId, groupId, entities);
     if (dcgmReturn != DCGM_ST_OK)
     {
-        DCGM_LOG_ERROR << "Got " << dcgmReturn << " from mpFieldGroupManager->GetGpuIds()";
+        DCGM_LOG_ERROR << "Error " << dcgmReturn << " from GetGroupEntities()";
         return dcgmReturn;
     }
 
     dcgmReturn = mpFieldGroupManager->GetFieldGroupFields(fieldGroupId, fieldIds);
     if (dcgmReturn != DCGM_ST_OK)
     {
-        PRINT_ERROR("%d", "Got %d from mpFieldGroupManager->GetFieldGroupFields()", (int)dcgmReturn);
+        DCGM_LOG_ERROR << "Got " << dcgmReturn << " from mpFieldGroupManager->GetFieldGroupFields()";
         return dcgmReturn;
     }
 
+    for (auto const &entity : entities)
+    {
+        for (unsigned short fieldId : fieldIds)
+        {
+            keys.push_back({ entity.entityGroupId, entity.entityId, fieldId });
+        }
+    }
 
-    PRINT_DEBUG("%d %d", "Got %d gpus and %d fields", (int)gpuIds.size(), (int)fieldIds.size());
+    /* Add the stream first so that no sample taken once the watches exist is missed */
+    dcgmReturn = m_fvStreamManager.AddStream(connectionId, requestId, keys, maxBatchesInFlight, maxPendingValues);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
 
-    for (i = 0; i < (int)gpuIds.size(); i++)
+    for (auto const &key : keys)
     {
-        for (j = 0; j < (int)fieldIds.size(); j++)
+        dcgmReturn = mpCacheManager->AddFieldWatch(key.entityGroupId,
+                                                   key.entityId,
+                                                   key.fieldId,
+                                                   monitorFrequencyUsec,
+                                                   maxSampleAge,
+                                                   maxKeepSamples,
+                                                   watcher,
+                                                   true);
+        if (dcgmReturn != DCGM_ST_OK)
         {
-            dcgmReturn = mpCacheManager->AddFieldWatch(DCGM_FE_GPU,
-                                                       gpuIds[i],
-                                                       fieldIds[j],
-                                                       monitorFrequencyUsec,
-                                                       maxSampleAge,
-                                                       maxKeepSamples,
-                                                       watcher,
-                                                       false);
-            if (dcgmReturn != DCGM_ST_OK)
-            {
-                PRINT_ERROR(
-                    "%d %d %d", "AddFieldWatch(%d, %d) returned %d", (int)gpuIds[i], (int)fieldIds[j], (int)dcgmReturn);
-                return DCGM_ST_GENERIC_ERROR;
-            }
+            DCGM_LOG_ERROR << "AddFieldWatch(" << key.entityGroupId << ", " << key.entityId << ", " << key.fieldId
+                           << ") returned " << errorString(dcgmReturn);
+            break;
+        }
+    }
+
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        std::vector<dcgm_fv_stream_key_t> unusedKeys;
+        m_fvStreamManager.RemoveStream(connectionId, requestId, unusedKeys);
+        for (auto const &key : unusedKeys)
+        {
+            mpCacheManager->RemoveFieldWatch(key.entityGroupId, key.entityId, key.fieldId, 0, watcher);
         }
+        return dcgmReturn;
     }
 
+    DCGM_LOG_DEBUG << "connectionId " << connectionId << " subscribed requestId " << requestId << " to "
+                   << keys.size() << " entity fields";
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmHostEngineHandler::AddRequestWatcher(std::unique_ptr<DcgmRequest> request,
-                                                      dcgm_request_id_t &requestId)
+dcgmReturn_t DcgmHostEngineHandler::UnsubscribeFieldValueStream(dcgm_connection_id_t connectionId,
+                                                                dcgm_request_id_t requestId)
 {
-    if (request == nullptr)
+    std::vector<dcgm_fv_stream_key_t> unusedKeys;
+    DcgmWatcher watcher(DcgmWatcherTypeFvStream, connectionId);
+
+    dcgmReturn_t dcgmReturn = m_fvStreamManager.RemoveStream(connectionId, requestId, unusedKeys);
+    if (dcgmReturn != DCGM_ST_OK)
     {
-        return DCGM_ST_BADPARAM;
+        return dcgmReturn;
     }
 
-    Lock();
+    for (auto const &key : unusedKeys)
+    {
+        dcgmReturn_t removeReturn
+            = mpCacheManager->RemoveFieldWatch(key.entityGroupId, key.entityId, key.fieldId, 0, watcher);
+        if (removeReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_WARNING << "RemoveFieldWatch(" << key.entityGroupId << ", " << key.entityId << ", "
+                             << key.fieldId << ") returned " << errorString(removeReturn);
+        }
+    }
 
-    m_nextWatchedRequestId++;
+    /* The client can free its request now */
+    NotifyRequestOfCompletion(connectionId, requestId);
+    return DCGM_ST_OK;
+}
 
-    /* Search for a nonzero, unused request ID. This should only take more than one
-       loop if we've served more than 4 billion requests */
-    while (m_nextWatchedRequestId == DCGM_REQUEST_ID_NONE
-           || m_watchedRequests.find(m_nextWatchedRequestId) != m_watchedRequests.end())
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::SubscribeProxyStream(dcgm_connection_id_t connectionId,
+                                                         dcgm_request_id_t requestId,
+                                                         dcgmFieldValueStreamParams_v1 const &params)
+{
+    if (m_proxyManager == nullptr)
     {
-        m_nextWatchedRequestId++;
+        DCGM_LOG_DEBUG << "Not a proxy. Start nv-hostengine with --proxy-hosts";
+        return DCGM_ST_NOT_SUPPORTED;
     }
 
-    request->SetRequestId(m_nextWatchedRequestId);
-    requestId = m_nextWatchedRequestId;
+    if (requestId == DCGM_REQUEST_ID_NONE)
+    {
+        DCGM_LOG_ERROR << "A proxy stream needs a requestId to send batches to";
+        return DCGM_ST_BADPARAM;
+    }
 
-    m_watchedRequests[m_nextWatchedRequestId] = std::move(request);
+    /* Only the special groups mean the same thing on every host engine */
+    if (params.groupId != (dcgmGpuGrp_t)DCGM_GROUP_ALL_GPUS && params.groupId != (dcgmGpuGrp_t)DCGM_GROUP_ALL_NVSWITCHES)
+    {
+        DCGM_LOG_ERROR << "Proxy streams need DCGM_GROUP_ALL_GPUS or DCGM_GROUP_ALL_NVSWITCHES, not groupId "
+                       << (uintptr_t)params.groupId;
+        return DCGM_ST_BADPARAM;
+    }
 
-    /* Log while we still have the lock */
-    DCGM_LOG_DEBUG << "Assigned requestId " << m_nextWatchedRequestId << " to request " << std::hex << request.get();
-    Unlock();
+    DcgmProxyStreamSpec_t spec {};
+    spec.groupId        = params.groupId;
+    spec.updateFreq     = params.updateFreq;
+    spec.maxKeepAge     = params.maxKeepAge;
+    spec.maxKeepSamples = params.maxKeepSamples;
 
-    return DCGM_ST_OK;
+    dcgmReturn_t dcgmReturn = mpFieldGroupManager->GetFieldGroupFields(params.fieldGroupId, spec.fieldIds);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << dcgmReturn << " from mpFieldGroupManager->GetFieldGroupFields()";
+        return dcgmReturn;
+    }
+
+    return m_proxyManager->AddStream(
+        connectionId, requestId, spec, params.maxBatchesInFlight, params.maxPendingValues);
 }
 
 /*****************************************************************************/
-void DcgmHostEngineHandler::NotifyRequestOfCompletion(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId)
+dcgmReturn_t DcgmHostEngineHandler::UnsubscribeProxyStream(dcgm_connection_id_t connectionId,
+                                                           dcgm_request_id_t requestId)
 {
-    if (connectionId == DCGM_CONNECTION_ID_NONE)
+    if (m_proxyManager == nullptr)
     {
-        /* Local request. Just remove our object */
-        Lock();
-
-        watchedRequests_t::iterator it = m_watchedRequests.find(requestId);
-        if (it == m_watchedRequests.end())
-        {
-            PRINT_ERROR("%u", "Unable to find requestId %u", requestId);
-        }
-        else
-        {
-            m_watchedRequests.erase(it);
-            PRINT_DEBUG("%u", "Removed requestId %u", requestId);
-        }
-        Unlock();
-        return;
+        return DCGM_ST_NOT_SUPPORTED;
     }
 
-    dcgm_msg_request_notify_t msg;
-    memset(&msg, 0, sizeof(msg));
-    msg.requestId = requestId;
+    dcgmReturn_t dcgmReturn = m_proxyManager->RemoveStream(connectionId, requestId);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
 
-    SendRawMessageToClient(connectionId, DCGM_MSG_REQUEST_NOTIFY, requestId, &msg, sizeof(msg), DCGM_ST_OK);
+    /* The client can free its request now */
+    NotifyRequestOfCompletion(connectionId, requestId);
+    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmHostEngineHandler::RemoveAllTrackedRequests()
+dcgmReturn_t DcgmHostEngineHandler::GetProxyHosts(dcgmProxyHosts_v1 &hosts)
 {
-    PRINT_DEBUG("", "Entering RemoveAllTrackedRequests");
-
-    Lock();
-    m_watchedRequests.clear();
-    Unlock();
+    if (m_proxyManager == nullptr)
+    {
+        return DCGM_ST_NOT_SUPPORTED;
+    }
 
+    m_proxyManager->GetHosts(hosts);
     return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-
-/*****************************************************************************
- This method is used to start DCGM Host Engine in listening mode
- *****************************************************************************/
-dcgmReturn_t DcgmHostEngineHandler::RunServer(unsigned short portNumber,
-                                              char const *socketPath,
-                                              unsigned int isConnectionTCP)
+dcgmReturn_t DcgmHostEngineHandler::GetWorkerStats(dcgmHostengineWorkerStats_v1 &stats)
 {
-    dcgmReturn_t dcgmReturn;
+    std::vector<DcgmElasticWorkerPoolParams_t> laneParams;
+    std::vector<DcgmElasticWorkerPoolStats_t> laneStats;
+    m_dcgmIpc.GetWorkerLaneStats(laneParams, laneStats);
+
+    stats.numLanes = std::min((unsigned int)laneStats.size(), (unsigned int)DCGM_MAX_WORKER_LANES);
+    for (unsigned int i = 0; i < stats.numLanes; i++)
+    {
+        dcgmWorkerLaneStats_t &lane = stats.lanes[i];
+        lane                        = {};
+        lane.minWorkers             = laneParams[i].minWorkers;
+        lane.maxWorkers             = laneParams[i].maxWorkers;
+        lane.numWorkers             = laneStats[i].numWorkers;
+        lane.busyWorkers            = laneStats[i].busyWorkers;
+        lane.peakWorkers            = laneStats[i].peakWorkers;
+        lane.queueDepth             = laneStats[i].queueDepth;
+        lane.maxQueueDepth          = laneStats[i].maxQueueDepth;
+        lane.tasksProcessed         = laneStats[i].tasksProcessed;
+        lane.totalWaitUsec          = laneStats[i].totalWaitUsec;
+        lane.maxWaitUsec            = laneStats[i].maxWaitUsec;
+        lane.workersStarted         = laneStats[i].workersStarted;
+        lane.workersStopped         = laneStats[i].workersStopped;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::GetRequestStats(dcgmIntrospectRequestStats_t &requestStats)
+{
+    m_requestStats.GetStats(requestStats);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+DcgmMemoryCounter *DcgmHostEngineHandler::ModuleMemory(unsigned int moduleId)
+{
+    if (moduleId >= DcgmModuleIdCount)
+    {
+        return nullptr;
+    }
+    return &m_moduleMemory[moduleId];
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::GetMemoryAccounting(dcgmIntrospectMemoryAccounting_t &accounting)
+{
+    unsigned int version = accounting.version;
+    memset(&accounting, 0, sizeof(accounting));
+    accounting.version = version;
+    accounting.numTags = DCGM_INTROSPECT_MEM_TAG_COUNT;
+
+    /* Measured subsystems have no high-water mark of their own */
+    auto measured = [](long long bytes) {
+        dcgmIntrospectMemoryTag_t usage {};
+        usage.bytesUsed    = bytes;
+        usage.maxBytesUsed = bytes;
+        return usage;
+    };
+
+    DcgmIpcConnectionStats_t ipcStats {};
+    if (m_dcgmIpc.GetConnectionStats(DCGM_CONNECTION_ID_NONE, ipcStats) != DCGM_ST_OK)
+    {
+        DCGM_LOG_WARNING << "Could not get the send queues of the IPC connections";
+    }
+
+    accounting.tags[DCGM_INTROSPECT_MEM_TAG_CACHE] = measured(mpCacheManager->GetCacheBytesUsed());
+    accounting.tags[DCGM_INTROSPECT_MEM_TAG_IPC_SEND_QUEUES] = measured(ipcStats.sendQueue.queuedBytes);
+    accounting.tags[DCGM_INTROSPECT_MEM_TAG_IPC_BUFFER_POOL]
+        = measured(DcgmMessageBufferPool::Global().GetStats().pooledBytes);
+    accounting.tags[DCGM_INTROSPECT_MEM_TAG_PROTOBUF] = m_protobufMemory.Get();
+
+    /* Arenas keep their chunks once mapped, so what they mapped is what the process pays for them */
+    dcgmcm_arena_stats_t arenaStats {};
+    mpCacheManager->GetCacheArenaStats(arenaStats);
+    accounting.tags[DCGM_INTROSPECT_MEM_TAG_CACHE_ARENAS].bytesUsed    = arenaStats.bytesMapped;
+    accounting.tags[DCGM_INTROSPECT_MEM_TAG_CACHE_ARENAS].maxBytesUsed = arenaStats.maxBytesMapped;
+
+    dcgmIntrospectMemoryTag_t &moduleRequests = accounting.tags[DCGM_INTROSPECT_MEM_TAG_MODULE_REQUESTS];
+    for (unsigned int moduleId = 0; moduleId < DcgmModuleIdCount; moduleId++)
+    {
+        accounting.modules[moduleId] = m_moduleMemory[moduleId].Get();
+        moduleRequests.bytesUsed += accounting.modules[moduleId].bytesUsed;
+        /* Modules didn't necessarily peak at the same time, so this is an upper bound */
+        moduleRequests.maxBytesUsed += accounting.modules[moduleId].maxBytesUsed;
+    }
+
+    std::vector<dcgmcm_watcher_bytes_t> watcherBytes;
+    mpCacheManager->GetWatcherBytesUsed(watcherBytes);
+
+    accounting.moreWatchers = watcherBytes.size() > DCGM_INTROSPECT_MEM_MAX_WATCHERS ? 1 : 0;
+    accounting.numWatchers  = std::min<size_t>(watcherBytes.size(), DCGM_INTROSPECT_MEM_MAX_WATCHERS);
+    for (unsigned int i = 0; i < accounting.numWatchers; i++)
+    {
+        dcgmIntrospectWatcherMemory_t &watcher = accounting.watchers[i];
+
+        watcher.watcherType  = watcherBytes[i].watcher.watcherType;
+        watcher.connectionId = watcherBytes[i].watcher.connectionId;
+        watcher.cacheBytes   = watcherBytes[i].bytesUsed;
+
+        DcgmIpcConnectionStats_t connectionStats {};
+        if (watcher.connectionId != DCGM_CONNECTION_ID_NONE
+            && m_dcgmIpc.GetConnectionStats(watcher.connectionId, connectionStats) == DCGM_ST_OK)
+        {
+            watcher.sendQueueBytes = connectionStats.sendQueue.queuedBytes;
+        }
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::EstimateWatchCost(dcgm_connection_id_t connectionId,
+                                                      dcgmIntrospectWatchCost_t &cost)
+{
+    unsigned int groupId = cost.groupId;
+    dcgmReturn_t ret     = mpGroupManager->verifyAndUpdateGroupId(&groupId);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Bad group ID " << cost.groupId << " for the watch cost estimate";
+        return ret;
+    }
+
+    std::vector<dcgmGroupEntityPair_t> entities;
+    ret = mpGroupManager->GetGroupEntities(connectionId, groupId, entities);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(ret) << " from GetGroupEntities() for group " << groupId;
+        return ret;
+    }
+
+    std::vector<unsigned short> fieldIds;
+    ret = mpFieldGroupManager->GetFieldGroupFields((dcgmFieldGrp_t)cost.fieldGroupId, fieldIds);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(ret) << " from GetFieldGroupFields() for field group "
+                       << cost.fieldGroupId;
+        return ret;
+    }
+
+    return mpCacheManager->EstimateWatchCost(
+        entities, fieldIds, (timelib64_t)cost.updateFreq, cost.maxKeepAge, cost.maxKeepSamples, cost);
+}
+
+/*****************************************************************************/
+/* Restored sessions are parked on connection IDs that live connections, which count up from 1, never reach */
+#define DCGM_CONNECTION_ID_PARKED_FIRST ((dcgm_connection_id_t)0xFFFF0000)
+
+/* How long restored sessions wait to be resumed. See dcgmSessionGetToken() */
+#define DCGM_SESSION_RESUME_TIMEOUT_USEC (300LL * 1000000)
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::GetSessionToken(dcgm_connection_id_t connectionId, unsigned long long &token)
+{
+    if (connectionId == DCGM_CONNECTION_ID_NONE)
+        return DCGM_ST_NOT_SUPPORTED; /* Embedded state goes away with the process */
+
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+
+    auto it = m_sessionTokens.find(connectionId);
+    if (it != m_sessionTokens.end())
+    {
+        token = it->second;
+        return DCGM_ST_OK;
+    }
+
+    /* Random so that clients can't guess each other's tokens */
+    std::random_device randomDevice;
+    do
+    {
+        token = ((unsigned long long)randomDevice() << 32) | randomDevice();
+    } while (token == 0 || m_parkedSessions.count(token) != 0);
+
+    m_sessionTokens[connectionId] = token;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::ResumeSession(dcgm_connection_id_t connectionId, unsigned long long token)
+{
+    if (connectionId == DCGM_CONNECTION_ID_NONE)
+        return DCGM_ST_NOT_SUPPORTED;
+
+    dcgm_connection_id_t parkedId;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+
+        auto it = m_parkedSessions.find(token);
+        if (it == m_parkedSessions.end())
+            return DCGM_ST_NO_DATA;
+
+        parkedId = it->second.connectionId;
+        m_parkedSessions.erase(it);
+        m_sessionTokens.erase(parkedId);
+        m_sessionTokens[connectionId] = token;
+    }
+
+    mpGroupManager->ChangeConnection(parkedId, connectionId);
+    mpFieldGroupManager->ChangeConnection(parkedId, connectionId);
+    mpCacheManager->ChangeWatcherConnection(parkedId, connectionId);
+
+    DCGM_LOG_INFO << "Connection " << connectionId << " resumed the session parked on connection " << parkedId;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmHostEngineHandler::SaveStateCheckpoint()
+{
+    char const *filename = getenv(DCGM_ENV_STATE_CHECKPOINT);
+    if (filename == nullptr || filename[0] == '\0' || mpCacheManager == nullptr)
+        return;
+
+    DcgmStateCheckpoint checkpoint;
+    checkpoint.savedUsec = timelib_usecSince1970();
+    mpCacheManager->GetGpuUuids(checkpoint.gpuUuids);
+
+    /* Policies belong to GPUs rather than to a session, so they are kept whoever set them */
+    if (m_modules[DcgmModuleIdPolicy].ptr != nullptr)
+    {
+        unsigned int allGpusGroupId = mpGroupManager->GetAllGpusGroup();
+        std::vector<dcgmGroupEntityPair_t> entities;
+
+        auto msg               = std::make_unique<dcgm_policy_msg_get_policies_t>();
+        msg->header.length     = sizeof(*msg);
+        msg->header.moduleId   = DcgmModuleIdPolicy;
+        msg->header.subCommand = DCGM_POLICY_SR_GET_POLICIES;
+        msg->header.version    = dcgm_policy_msg_get_policies_version;
+        msg->groupId           = (dcgmGpuGrp_t)allGpusGroupId;
+
+        if (mpGroupManager->GetGroupEntities(DCGM_CONNECTION_ID_NONE, allGpusGroupId, entities) == DCGM_ST_OK
+            && SendModuleMessage(DcgmModuleIdPolicy, &msg->header) == DCGM_ST_OK)
+        {
+            /* One policy per GPU of the group, in the group's order */
+            int policyIndex = 0;
+            for (auto const &entity : entities)
+            {
+                if (entity.entityGroupId != DCGM_FE_GPU)
+                    continue;
+                if (policyIndex >= msg->numPolicies)
+                    break;
+
+                dcgmPolicy_t const &policy = msg->policies[policyIndex++];
+                if (policy.condition != 0)
+                    checkpoint.policies.push_back({ entity.entityId, policy });
+            }
+        }
+    }
+
+    std::vector<std::pair<dcgm_connection_id_t, unsigned long long>> sessionTokens;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        sessionTokens.assign(m_sessionTokens.begin(), m_sessionTokens.end());
+    }
+
+    std::vector<unsigned int> ids;
+    std::vector<dcgmcm_watcher_watch_t> watches;
+    for (auto const &[connectionId, token] : sessionTokens)
+    {
+        DcgmCheckpointSession &session = checkpoint.sessions.emplace_back();
+        session.token                  = token;
+
+        mpGroupManager->GetConnectionGroupIds(connectionId, ids);
+        for (unsigned int groupId : ids)
+        {
+            DcgmCheckpointGroup group;
+            group.groupId = groupId;
+            group.name    = mpGroupManager->GetGroupName(connectionId, groupId);
+            if (mpGroupManager->GetGroupEntities(connectionId, groupId, group.entities) != DCGM_ST_OK)
+                continue; /* Removed since */
+
+            if (m_modules[DcgmModuleIdHealth].ptr != nullptr)
+            {
+                dcgm_health_msg_get_systems_t msg {};
+                msg.header.length     = sizeof(msg);
+                msg.header.moduleId   = DcgmModuleIdHealth;
+                msg.header.subCommand = DCGM_HEALTH_SR_GET_SYSTEMS;
+                msg.header.version    = dcgm_health_msg_get_systems_version;
+                msg.groupId           = (dcgmGpuGrp_t)groupId;
+                if (SendModuleMessage(DcgmModuleIdHealth, &msg.header) == DCGM_ST_OK)
+                    group.healthSystems = msg.systems;
+            }
+
+            session.groups.push_back(std::move(group));
+        }
+
+        mpFieldGroupManager->GetConnectionFieldGroupIds(connectionId, ids);
+        for (unsigned int fieldGroupId : ids)
+        {
+            DcgmCheckpointFieldGroup fieldGroup;
+            fieldGroup.fieldGroupId = fieldGroupId;
+            fieldGroup.name         = mpFieldGroupManager->GetFieldGroupName((dcgmFieldGrp_t)fieldGroupId);
+            if (mpFieldGroupManager->GetFieldGroupFields((dcgmFieldGrp_t)fieldGroupId, fieldGroup.fieldIds)
+                != DCGM_ST_OK)
+                continue; /* Removed since */
+
+            session.fieldGroups.push_back(std::move(fieldGroup));
+        }
+
+        /* Field value streams and policy callbacks are answered on requests of the old
+           connection, so their watches aren't kept. Clients set them up again after resuming */
+        mpCacheManager->GetConnectionWatches(connectionId, watches);
+        for (auto const &watch : watches)
+        {
+            DcgmWatcherType_t watcherType = watch.watcherInfo.watcher.watcherType;
+            if (watcherType != DcgmWatcherTypeClient && watcherType != DcgmWatcherTypeHealthWatch)
+                continue;
+
+            DcgmCheckpointWatch saved;
+            saved.watcherType          = watcherType;
+            saved.entityGroupId        = watch.entityGroupId;
+            saved.entityId             = watch.entityId;
+            saved.fieldId              = watch.fieldId;
+            saved.monitorFrequencyUsec = watch.watcherInfo.monitorFrequencyUsec;
+            saved.maxAgeUsec           = watch.watcherInfo.maxAgeUsec;
+            saved.isSubscribed         = watch.watcherInfo.isSubscribed != 0;
+            session.watches.push_back(saved);
+        }
+    }
+
+    if (DcgmWriteStateCheckpoint(filename, checkpoint) == DCGM_ST_OK)
+    {
+        DCGM_LOG_INFO << "Saved " << checkpoint.sessions.size() << " sessions and " << checkpoint.policies.size()
+                      << " GPU policies to " << filename;
+    }
+}
+
+/*****************************************************************************/
+void DcgmHostEngineHandler::LoadStateCheckpoint()
+{
+    char const *filename = getenv(DCGM_ENV_STATE_CHECKPOINT);
+    if (filename == nullptr || filename[0] == '\0')
+        return;
+
+    DcgmStateCheckpoint checkpoint;
+    dcgmReturn_t dcgmReturn = DcgmReadStateCheckpoint(filename, checkpoint);
+    if (dcgmReturn == DCGM_ST_NO_DATA)
+    {
+        DCGM_LOG_DEBUG << "No state checkpoint at " << filename;
+        return;
+    }
+    else if (dcgmReturn != DCGM_ST_OK)
+        return; /* Already logged */
+
+    /* GPU IDs can be reassigned if GPUs were added or removed while we were down */
+    std::vector<std::string> gpuUuids;
+    mpCacheManager->GetGpuUuids(gpuUuids);
+    auto gpuMatches = [&](unsigned int gpuId) {
+        return gpuId < gpuUuids.size() && gpuId < checkpoint.gpuUuids.size() && !gpuUuids[gpuId].empty()
+               && gpuUuids[gpuId] == checkpoint.gpuUuids[gpuId];
+    };
+    auto keepEntity = [&](dcgm_field_entity_group_t entityGroupId, dcgm_field_eid_t entityId) {
+        switch (entityGroupId)
+        {
+            case DCGM_FE_NONE:
+            case DCGM_FE_SWITCH:
+                return true;
+            case DCGM_FE_GPU:
+                return gpuMatches(entityId);
+            default:
+                return false; /* Instance and vGPU IDs are reassigned on restart */
+        }
+    };
+
+    for (auto const &policy : checkpoint.policies)
+    {
+        if (!gpuMatches(policy.gpuId))
+            continue;
+
+        /* Policies are set on groups, so set it on a group of just this GPU */
+        unsigned int groupId;
+        dcgmReturn = mpGroupManager->AddNewGroup(DCGM_CONNECTION_ID_NONE, "restore_policy", DCGM_GROUP_EMPTY, &groupId);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_ERROR << "Got error " << errorString(dcgmReturn) << " creating a group to restore policies";
+            break;
+        }
+
+        dcgm_policy_msg_set_policy_t msg {};
+        msg.header.length     = sizeof(msg);
+        msg.header.moduleId   = DcgmModuleIdPolicy;
+        msg.header.subCommand = DCGM_POLICY_SR_SET_POLICY;
+        msg.header.version    = dcgm_policy_msg_set_policy_version;
+        msg.groupId           = (dcgmGpuGrp_t)groupId;
+        msg.policy            = policy.policy;
+
+        dcgmReturn = mpGroupManager->AddEntityToGroup(DCGM_CONNECTION_ID_NONE, groupId, DCGM_FE_GPU, policy.gpuId);
+        if (dcgmReturn == DCGM_ST_OK)
+            dcgmReturn = ProcessModuleCommand(&msg.header);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_WARNING << "Unable to restore the policy of GPU " << policy.gpuId << ": "
+                             << errorString(dcgmReturn);
+        }
+
+        mpGroupManager->RemoveGroup(DCGM_CONNECTION_ID_NONE, groupId);
+    }
+
+    timelib64_t expireUsec         = timelib_usecSince1970() + DCGM_SESSION_RESUME_TIMEOUT_USEC;
+    dcgm_connection_id_t parkedId  = DCGM_CONNECTION_ID_PARKED_FIRST;
+    unsigned int numSkippedWatches = 0;
+
+    for (auto &session : checkpoint.sessions)
+    {
+        for (auto const &group : session.groups)
+        {
+            std::vector<dcgmGroupEntityPair_t> entities;
+            for (auto const &entity : group.entities)
+            {
+                if (keepEntity(entity.entityGroupId, entity.entityId))
+                    entities.push_back(entity);
+            }
+
+            dcgmReturn = mpGroupManager->RestoreGroup(parkedId, group.groupId, group.name, entities);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                DCGM_LOG_WARNING << "Unable to restore group " << group.groupId << ": " << errorString(dcgmReturn);
+                continue;
+            }
+
+            if (group.healthSystems == 0)
+                continue;
+
+            /* The update interval and sample age are set from the saved watches below */
+            dcgm_health_msg_set_systems_t msg {};
+            msg.header.length            = sizeof(msg);
+            msg.header.moduleId          = DcgmModuleIdHealth;
+            msg.header.subCommand        = DCGM_HEALTH_SR_SET_SYSTEMS_V2;
+            msg.header.version           = dcgm_health_msg_set_systems_version;
+            msg.header.connectionId      = parkedId;
+            msg.healthSet.version        = dcgmHealthSetParams_version2;
+            msg.healthSet.groupId        = (dcgmGpuGrp_t)group.groupId;
+            msg.healthSet.systems        = (dcgmHealthSystems_t)group.healthSystems;
+            msg.healthSet.updateInterval = 30000000;
+            msg.healthSet.maxKeepAge     = 600.0;
+
+            dcgmReturn = ProcessModuleCommand(&msg.header);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                DCGM_LOG_WARNING << "Unable to restore the health watches of group " << group.groupId << ": "
+                                 << errorString(dcgmReturn);
+            }
+        }
+
+        for (auto &fieldGroup : session.fieldGroups)
+        {
+            dcgmReturn = mpFieldGroupManager->RestoreFieldGroup(fieldGroup.fieldGroupId,
+                                                                fieldGroup.name,
+                                                                fieldGroup.fieldIds,
+                                                                DcgmWatcher(DcgmWatcherTypeClient, parkedId));
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                DCGM_LOG_WARNING << "Unable to restore field group " << fieldGroup.fieldGroupId << ": "
+                                 << errorString(dcgmReturn);
+            }
+        }
+
+        for (auto const &watch : session.watches)
+        {
+            if (!keepEntity(watch.entityGroupId, watch.entityId)
+                || mpCacheManager->AddFieldWatch(watch.entityGroupId,
+                                                 watch.entityId,
+                                                 watch.fieldId,
+                                                 watch.monitorFrequencyUsec,
+                                                 watch.maxAgeUsec / 1000000.0,
+                                                 0,
+                                                 DcgmWatcher(watch.watcherType, parkedId),
+                                                 watch.isSubscribed)
+                       != DCGM_ST_OK)
+            {
+                numSkippedWatches++;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        m_sessionTokens[parkedId]       = session.token;
+        m_parkedSessions[session.token] = { parkedId, expireUsec };
+        parkedId++;
+    }
+
+    DCGM_LOG_INFO << "Restored " << checkpoint.sessions.size() << " sessions and " << checkpoint.policies.size()
+                  << " GPU policies from " << filename << ". Skipped " << numSkippedWatches << " watches";
+
+    if (!checkpoint.sessions.empty() && !m_sessionExpiryThread.joinable())
+        m_sessionExpiryThread = std::thread([this] { ExpireParkedSessions(); });
+}
+
+/*****************************************************************************/
+void DcgmHostEngineHandler::ExpireParkedSessions()
+{
+    std::unique_lock<std::mutex> lock(m_sessionMutex);
+
+    while (!m_stopSessionExpiry && !m_parkedSessions.empty())
+    {
+        timelib64_t now            = timelib_usecSince1970();
+        timelib64_t nextExpireUsec = std::numeric_limits<timelib64_t>::max();
+        std::vector<dcgm_connection_id_t> expired;
+
+        for (auto it = m_parkedSessions.begin(); it != m_parkedSessions.end();)
+        {
+            if (it->second.expireUsec <= now)
+            {
+                expired.push_back(it->second.connectionId);
+                it = m_parkedSessions.erase(it);
+            }
+            else
+            {
+                nextExpireUsec = std::min(nextExpireUsec, it->second.expireUsec);
+                ++it;
+            }
+        }
+
+        if (!expired.empty())
+        {
+            lock.unlock();
+            for (dcgm_connection_id_t connectionId : expired)
+            {
+                DCGM_LOG_INFO << "Removing the session parked on connection " << connectionId
+                              << " since nobody resumed it";
+                OnConnectionRemove(connectionId);
+            }
+            lock.lock();
+            continue;
+        }
+
+        m_sessionCondition.wait_for(lock, std::chrono::microseconds(nextExpireUsec - now));
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::SubscribeAttributeGeneration(dcgm_connection_id_t connectionId,
+                                                                 dcgm_request_id_t requestId,
+                                                                 unsigned long long *generation)
+{
+    if (requestId == DCGM_REQUEST_ID_NONE || generation == nullptr)
+    {
+        DCGM_LOG_ERROR << "Attribute generation changes need a requestId to be sent to";
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgm_request_id_t oldRequestId = DCGM_REQUEST_ID_NONE;
+    {
+        std::lock_guard<std::mutex> lock(m_attributeMutex);
+
+        auto it = m_attributeSubscribers.find(connectionId);
+        if (it != m_attributeSubscribers.end())
+            oldRequestId = it->second;
+
+        m_attributeSubscribers[connectionId] = requestId;
+        *generation                          = m_attributeGeneration;
+    }
+
+    if (oldRequestId != DCGM_REQUEST_ID_NONE)
+    {
+        /* Only the latest subscription of a connection gets changes */
+        NotifyRequestOfCompletion(connectionId, oldRequestId);
+    }
+
+    DCGM_LOG_DEBUG << "connectionId " << connectionId << " subscribed requestId " << requestId
+                   << " to attribute generation " << *generation;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmHostEngineHandler::BumpAttributeGeneration()
+{
+    dcgm_msg_attribute_generation_t msg {};
+    msg.version = dcgm_msg_attribute_generation_version;
+
+    std::vector<std::pair<dcgm_connection_id_t, dcgm_request_id_t>> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(m_attributeMutex);
+        msg.generation = ++m_attributeGeneration;
+        subscribers.assign(m_attributeSubscribers.begin(), m_attributeSubscribers.end());
+    }
+
+    DCGM_LOG_DEBUG << "Attribute generation is now " << msg.generation << ". Notifying " << subscribers.size()
+                   << " clients";
+
+    for (auto const &[connectionId, requestId] : subscribers)
+    {
+        dcgmReturn_t dcgmReturn = SendRawMessageToClient(
+            connectionId, DCGM_MSG_ATTRIBUTE_GENERATION, requestId, &msg, sizeof(msg), DCGM_ST_OK);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            /* The connection going away removes the subscription */
+            DCGM_LOG_DEBUG << "Got " << errorString(dcgmReturn) << " notifying connectionId " << connectionId;
+        }
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::WatchFieldGroupAllGpus(dcgmFieldGrp_t fieldGroupId,
+                                                           timelib64_t monitorFrequencyUsec,
+                                                           double maxSampleAge,
+                                                           int maxKeepSamples,
+                                                           int activeOnly,
+                                                           DcgmWatcher const &watcher)
+{
+    int i;
+    int j;
+    dcgmReturn_t dcgmReturn;
+    std::vector<unsigned int> gpuIds;
+    std::vector<unsigned short> fieldIds;
+
+    dcgmReturn = mpCacheManager->GetGpuIds(activeOnly, gpuIds);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << dcgmReturn << " from mpFieldGroupManager->GetGpuIds()";
+        return dcgmReturn;
+    }
+
+    dcgmReturn = mpFieldGroupManager->GetFieldGroupFields(fieldGroupId, fieldIds);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        PRINT_ERROR("%d", "Got %d from mpFieldGroupManager->GetFieldGroupFields()", (int)dcgmReturn);
+        return dcgmReturn;
+    }
+
+
+    PRINT_DEBUG("%d %d", "Got %d gpus and %d fields", (int)gpuIds.size(), (int)fieldIds.size());
+
+    for (i = 0; i < (int)gpuIds.size(); i++)
+    {
+        for (j = 0; j < (int)fieldIds.size(); j++)
+        {
+            dcgmReturn = mpCacheManager->AddFieldWatch(DCGM_FE_GPU,
+                                                       gpuIds[i],
+                                                       fieldIds[j],
+                                                       monitorFrequencyUsec,
+                                                       maxSampleAge,
+                                                       maxKeepSamples,
+                                                       watcher,
+                                                       false);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                PRINT_ERROR(
+                    "%d %d %d", "AddFieldWatch(%d, %d) returned %d", (int)gpuIds[i], (int)fieldIds[j], (int)dcgmReturn);
+                return DCGM_ST_GENERIC_ERROR;
+            }
+        }
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::AddRequestWatcher(std::unique_ptr<DcgmRequest> request,
+                                                      dcgm_request_id_t &requestId)
+{
+    if (request == nullptr)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    Lock();
+
+    m_nextWatchedRequestId++;
+
+    /* Search for a nonzero, unused request ID. This should only take more than one
+       loop if we've served more than 4 billion requests */
+    while (m_nextWatchedRequestId == DCGM_REQUEST_ID_NONE
+           || m_watchedRequests.find(m_nextWatchedRequestId) != m_watchedRequests.end())
+    {
+        m_nextWatchedRequestId++;
+    }
+
+    request->SetRequestId(m_nextWatchedRequestId);
+    requestId = m_nextWatchedRequestId;
+
+    m_watchedRequests[m_nextWatchedRequestId] = std::move(request);
+
+    /* Log while we still have the lock */
+    DCGM_LOG_DEBUG << "Assigned requestId " << m_nextWatchedRequestId << " to request " << std::hex << request.get();
+    Unlock();
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmHostEngineHandler::NotifyRequestOfCompletion(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId)
+{
+    if (connectionId == DCGM_CONNECTION_ID_NONE)
+    {
+        /* Local request. Just remove our object */
+        Lock();
+
+        watchedRequests_t::iterator it = m_watchedRequests.find(requestId);
+        if (it == m_watchedRequests.end())
+        {
+            PRINT_ERROR("%u", "Unable to find requestId %u", requestId);
+        }
+        else
+        {
+            m_watchedRequests.erase(it);
+            PRINT_DEBUG("%u", "Removed requestId %u", requestId);
+        }
+        Unlock();
+        return;
+    }
+
+    dcgm_msg_request_notify_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.requestId = requestId;
+
+    SendRawMessageToClient(connectionId, DCGM_MSG_REQUEST_NOTIFY, requestId, &msg, sizeof(msg), DCGM_ST_OK);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::RemoveAllTrackedRequests()
+{
+    PRINT_DEBUG("", "Entering RemoveAllTrackedRequests");
+
+    Lock();
+    m_watchedRequests.clear();
+    Unlock();
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+/* Override workersPerLane from a DCGM_ENV_IPC_WORKER_LANES style list like "2,1,2".
+   A single number applies to every lane */
+static void ParseWorkersPerLane(char const *value, std::vector<unsigned int> &workersPerLane)
+{
+    if (value == nullptr || *value == '\0')
+    {
+        return;
+    }
+
+    std::vector<unsigned int> parsed;
+    std::stringstream ss(value);
+    std::string numWorkers;
+    while (parsed.size() < workersPerLane.size() && std::getline(ss, numWorkers, ','))
+    {
+        parsed.push_back(std::max(1UL, strtoul(numWorkers.c_str(), nullptr, 10)));
+    }
+
+    if (parsed.size() == 1)
+    {
+        parsed.resize(workersPerLane.size(), parsed[0]);
+    }
+    std::copy(parsed.begin(), parsed.end(), workersPerLane.begin());
+}
+
+/*****************************************************************************
+ This method is used to start DCGM Host Engine in listening mode
+ *****************************************************************************/
+dcgmReturn_t DcgmHostEngineHandler::RunServer(unsigned short portNumber,
+                                              char const *socketPath,
+                                              unsigned int isConnectionTCP)
+{
+    dcgmReturn_t dcgmReturn;
+
+    /* Busy hostengines with many clients can move socket work off of a single thread */
+    unsigned int numReactors = 1;
+    char const *ipcReactors  = getenv(DCGM_ENV_IPC_REACTORS);
+    if (ipcReactors != nullptr)
+    {
+        numReactors = std::max(1UL, strtoul(ipcReactors, nullptr, 10));
+    }
+
+    /* A client that stops reading shouldn't grow our memory without bound. Notifications to it are
+       dropped first since newer ones supersede them */
+    DcgmIpcSendQueueParams_t sendQueueParams {};
+    sendQueueParams.highWatermark = 64 * 1024 * 1024;
+    sendQueueParams.policy        = DCGM_IPC_SLOW_CONSUMER_DROP_OLDEST;
+
+    char const *sendQueueBytes = getenv(DCGM_ENV_IPC_SEND_QUEUE_BYTES);
+    if (sendQueueBytes != nullptr)
+    {
+        sendQueueParams.highWatermark = strtoull(sendQueueBytes, nullptr, 10);
+    }
+    sendQueueParams.lowWatermark = sendQueueParams.highWatermark / 2;
+
+    char const *slowConsumer = getenv(DCGM_ENV_IPC_SLOW_CONSUMER);
+    if (slowConsumer != nullptr)
+    {
+        std::string_view const policy(slowConsumer);
+        if (policy == "coalesce")
+        {
+            sendQueueParams.policy = DCGM_IPC_SLOW_CONSUMER_COALESCE;
+        }
+        else if (policy == "disconnect")
+        {
+            sendQueueParams.policy = DCGM_IPC_SLOW_CONSUMER_DISCONNECT;
+        }
+        else if (policy != "drop")
+        {
+            DCGM_LOG_WARNING << "Ignoring unknown " << DCGM_ENV_IPC_SLOW_CONSUMER << " " << policy;
+        }
+    }
+    m_dcgmIpc.SetSendQueueParams(sendQueueParams);
+
+    /* Keep diagnostics and other slow requests from holding up cheap reads. Each
+       lane grows while requests wait for its workers, so many concurrent clients
+       get more of the machine's cores than the minimum */
+    unsigned int numCpus = std::max(std::thread::hardware_concurrency(), 1U);
+    std::vector<unsigned int> minWorkersPerLane(DcgmWorkerLaneCount);
+    std::vector<unsigned int> maxWorkersPerLane(DcgmWorkerLaneCount);
+    minWorkersPerLane[DcgmWorkerLaneFast]  = 2;
+    minWorkersPerLane[DcgmWorkerLaneAdmin] = 1;
+    minWorkersPerLane[DcgmWorkerLaneLong]  = 2;
+    maxWorkersPerLane[DcgmWorkerLaneFast]  = std::clamp(numCpus / 4, 2U, 32U);
+    maxWorkersPerLane[DcgmWorkerLaneAdmin] = std::clamp(numCpus / 16, 1U, 4U);
+    maxWorkersPerLane[DcgmWorkerLaneLong]  = std::clamp(numCpus / 16, 2U, 8U);
+
+    ParseWorkersPerLane(getenv(DCGM_ENV_IPC_WORKER_LANES), minWorkersPerLane);
+    ParseWorkersPerLane(getenv(DCGM_ENV_IPC_MAX_WORKER_LANES), maxWorkersPerLane);
+
+    std::vector<DcgmElasticWorkerPoolParams_t> lanes(DcgmWorkerLaneCount);
+    for (unsigned int lane = 0; lane < DcgmWorkerLaneCount; lane++)
+    {
+        lanes[lane].minWorkers = minWorkersPerLane[lane];
+        lanes[lane].maxWorkers = std::max(maxWorkersPerLane[lane], minWorkersPerLane[lane]);
+        DCGM_LOG_DEBUG << "Lane " << lane << " has " << lanes[lane].minWorkers << " to " << lanes[lane].maxWorkers
+                       << " workers";
+    }
+    m_dcgmIpc.SetWorkerLanes(
+        lanes,
+        [](DcgmMessage &message, void *) { return (unsigned int)DcgmClassifyMessage(message); },
+        nullptr);
+
+    /* Before listening, so that clients can't set up anything that clashes with what is restored */
+    LoadStateCheckpoint();
 
     if (isConnectionTCP)
     {
@@ -6038,7 +7536,8 @@ dcgmReturn_t DcgmHostEngineHandler::RunServer(unsigned short portNumber,
                                     DcgmHostEngineHandler::StaticProcessMessage,
                                     this,
                                     DcgmHostEngineHandler::StaticProcessDisconnect,
-                                    this);
+                                    this,
+                                    numReactors);
     }
     else
     {
@@ -6049,7 +7548,8 @@ dcgmReturn_t DcgmHostEngineHandler::RunServer(unsigned short portNumber,
                                     DcgmHostEngineHandler::StaticProcessMessage,
                                     this,
                                     DcgmHostEngineHandler::StaticProcessDisconnect,
-                                    this);
+                                    this,
+                                    numReactors);
     }
 
     if (dcgmReturn != DCGM_ST_OK)
@@ -6058,6 +7558,84 @@ dcgmReturn_t DcgmHostEngineHandler::RunServer(unsigned short portNumber,
         return DCGM_ST_INIT_ERROR;
     }
 
+    /* Fan in other host engines for clients that would otherwise connect to each of them */
+    char const *proxyHosts = getenv(DCGM_ENV_PROXY_HOSTS);
+    if (proxyHosts != nullptr && m_proxyManager == nullptr)
+    {
+        std::vector<std::string> addresses = DcgmProxyManager::ParseHosts(proxyHosts);
+        if (!addresses.empty())
+        {
+            m_proxyManager = std::make_unique<DcgmProxyManager>(
+                std::move(addresses),
+                [this](dcgm_connection_id_t connectionId,
+                       unsigned int msgType,
+                       dcgm_request_id_t requestId,
+                       void *msgData,
+                       int msgLength,
+                       dcgmReturn_t status) {
+                    return SendRawMessageToClient(connectionId, msgType, requestId, msgData, msgLength, status);
+                });
+            m_proxyManager->Start();
+        }
+    }
+
+    /* Serve the cache's latest values to Prometheus without a client in between */
+    char const *metricsListen = getenv(DCGM_ENV_METRICS_LISTEN);
+    if (metricsListen != nullptr && m_metricsExporter == nullptr)
+    {
+        char const *metricsFields = getenv(DCGM_ENV_METRICS_FIELDS);
+        auto exporter             = std::make_unique<DcgmMetricsExporter>(
+            DcgmMetricsExporter::ParseFieldIds(metricsFields == nullptr ? "" : metricsFields),
+            DcgmMetricsExporter::CacheSource(mpCacheManager));
+        if (exporter->Listen(metricsListen) == DCGM_ST_OK)
+        {
+            m_metricsExporter = std::move(exporter);
+            m_metricsExporter->Start();
+        }
+    }
+
+    /* Push every sample of the same fields to an OpenTelemetry collector */
+    char const *otlpEndpoint = getenv(DCGM_ENV_OTLP_ENDPOINT);
+    if (otlpEndpoint != nullptr && m_otlpExporter == nullptr)
+    {
+        char const *metricsFields = getenv(DCGM_ENV_METRICS_FIELDS);
+        char const *otlpInterval  = getenv(DCGM_ENV_OTLP_INTERVAL);
+        long long intervalSec     = otlpInterval ? strtoll(otlpInterval, nullptr, 10) : 0;
+
+        auto exporter = std::make_unique<DcgmOtlpExporter>(
+            DcgmMetricsExporter::ParseFieldIds(metricsFields == nullptr ? "" : metricsFields),
+            DcgmOtlpExporter::DEFAULT_UPDATE_FREQ_USEC,
+            intervalSec > 0 ? intervalSec * 1000000 : DcgmOtlpExporter::DEFAULT_INTERVAL_USEC);
+        if (exporter->SetEndpoint(otlpEndpoint) == DCGM_ST_OK)
+        {
+            /* Published to as soon as the fields are watched */
+            m_otlpExporter = std::move(exporter);
+            m_otlpExporter->Watch(mpCacheManager);
+            m_otlpExporter->Start();
+        }
+    }
+
+    /* Publish the latest values to shared memory for local readers */
+    char const *latestBoard = getenv(DCGM_ENV_LATEST_BOARD);
+    if (latestBoard != nullptr && m_latestValueBoard == nullptr)
+    {
+        char const *boardFields = getenv(DCGM_ENV_LATEST_BOARD_FIELDS);
+        auto board              = std::make_unique<DcgmLatestValueBoard>(
+            DcgmMetricsExporter::ParseFieldIds(boardFields == nullptr ? "" : boardFields),
+            DcgmMetricsExporter::CacheSource(mpCacheManager, DcgmWatcherTypeLatestValueBoard));
+        if (board->Create(latestBoard) == DCGM_ST_OK)
+        {
+            m_latestValueBoard = std::move(board);
+            m_latestValueBoard->Start();
+        }
+    }
+
+    /* Clients can connect now. Modules they use before this gets to them are loaded on their first command */
+    if (!m_prewarmThread.joinable())
+    {
+        m_prewarmThread = std::thread([this] { LoadModulesWithPolicy(DcgmModuleLoadPrewarm); });
+    }
+
     return DCGM_ST_OK;
 }
 
@@ -22,7 +22,18 @@
 
 #include "DcgmCacheManager.h"
 #include "DcgmCoreCommunication.h"
+#include "DcgmElasticWorkerPool.h"
 #include "DcgmFieldGroup.h"
+#include "DcgmFvStreamManager.h"
+#include "DcgmJobStatsAccumulator.h"
+#include "DcgmLatestValueBoard.h"
+#include "DcgmMemoryAccounting.h"
+#include "DcgmProfMultiplexer.h"
+#include "DcgmMetricsExporter.h"
+#include "DcgmOtlpExporter.h"
+#include "DcgmProxyManager.h"
+#include "DcgmRequestStats.h"
+#include "DcgmStateCheckpoint.h"
 #include "DcgmGroupManager.h"
 #include "DcgmIpc.h"
 #include "DcgmModule.h"
@@ -32,37 +43,46 @@
 #include "dcgm_agent.h"
 #include <core/DcgmModuleCore.h>
 #include <dcgm_core_communication.h>
+#include <array>
+#include <condition_variable>
 #include <iostream>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 
+/* When a module is loaded if nothing uses it sooner. See DCGM_ENV_MODULE_LOAD_POLICY */
+typedef enum
+{
+    DcgmModuleLoadLazy    = 0, /* On its first command */
+    DcgmModuleLoadEager   = 1, /* While the host engine starts */
+    DcgmModuleLoadPrewarm = 2, /* In the background once RunServer() is listening */
+} DcgmModuleLoadPolicy_t;
+
 /* Module status structure */
 typedef struct dcgmhe_module_info_t
 {
-    dcgmModuleId_t id;                /* ID of this module  */
-    dcgmModuleStatus_t status;        /* Status of this module */
-    DcgmModule *ptr;                  /* Pointer to the loaded class of this module */
-    const char *filename;             /* Filename for this module like libdcgmmodulehealth.so */
-    void *dlopenPtr;                  /* Pointer to this loaded module returned by dlopen(). NULL if not loaded */
-    dcgmModuleAlloc_f allocCB;        /* Module function for allocating a DcgmModule object. NULL if not set */
-    dcgmModuleFree_f freeCB;          /* Module function for freeing a DcgmModule object. NULL if not set */
-    dcgmModuleProcessMessage_f msgCB; /* Module function for receiving/processing messages. NULL if not set */
+    dcgmModuleId_t id;                    /* ID of this module  */
+    dcgmModuleStatus_t status;            /* Status of this module */
+    DcgmModule *ptr;                      /* Pointer to the loaded class of this module */
+    const char *filename;                 /* Filename for this module like libdcgmmodulehealth.so */
+    void *dlopenPtr;                      /* Pointer to this loaded module returned by dlopen(). NULL if not loaded */
+    dcgmModuleAlloc_f allocCB;            /* Module function for allocating a DcgmModule object. NULL if not set */
+    dcgmModuleFree_f freeCB;              /* Module function for freeing a DcgmModule object. NULL if not set */
+    dcgmModuleProcessMessage_f msgCB;     /* Module function for receiving/processing messages. NULL if not set */
+    unsigned int commandThreads;          /* Most threads of commandQueue. 0 = client commands are processed inline */
+    unsigned long long inlineSubCommands; /* Bit N set = subCommand N is processed on the caller's thread anyway */
+    DcgmElasticWorkerPool *commandQueue;  /* Threads for client commands if commandThreads. NULL if not started */
+    DcgmModuleLoadPolicy_t loadPolicy;    /* When this module is loaded if nothing uses it sooner */
+    long long loadUsec;                   /* How long loading this module took. 0 if not loaded */
 } dcgmhe_module_info_t, *dcgmhe_module_info_p;
 
-/* Job definition */
-typedef struct
-{
-    unsigned int groupId;
-    timelib64_t startTime;
-    timelib64_t endTime;
-} jobRecord_t;
-
 
 class DcgmHostEngineHandler
 {
 private:
     static const int DCGM_HE_NUM_WORKERS = 2; /* How many worker threads to use for processing
-                                                 user data */
+                                                 disconnects. Messages are processed on the lanes
+                                                 of DcgmWorkerLanes.h */
 
 public:
     /*****************************************************************************
@@ -140,6 +160,28 @@ public:
     dcgmReturn_t ProcessProtobufMessage(dcgm_connection_id_t connectionId, std::unique_ptr<DcgmMessage> message);
     dcgmReturn_t ProcessModuleCommandMsg(dcgm_connection_id_t connectionId, std::unique_ptr<DcgmMessage> message);
     dcgmReturn_t ProcessModuleCommand(dcgm_module_command_header_t *moduleCommand);
+    dcgmReturn_t ProcessModuleCommandBatchMsg(dcgm_connection_id_t connectionId, std::unique_ptr<DcgmMessage> message);
+
+    /*****************************************************************************/
+    /*
+     * Process the module commands of a DCGM_MSG_MODULE_COMMAND_BATCH in order
+     *
+     * connectionId  IN: Connection the batch came from. DCGM_CONNECTION_ID_NONE = embedded
+     * requestId     IN: Request ID to give every command of the batch
+     * batch     IN/OUT: dcgm_msg_module_command_batch_t and its entries. Replaced with
+     *                   the response, which has each command's own status
+     * queueWaitUsec IN: How long the batch waited for a worker. Only for m_requestStats
+     *
+     * Returns: DCGM_ST_OK if every command was processed, even if some of them failed
+     *          DCGM_ST_? if the batch is malformed. Nothing was processed then
+     */
+    dcgmReturn_t ProcessModuleCommandBatch(dcgm_connection_id_t connectionId,
+                                           dcgm_request_id_t requestId,
+                                           std::vector<char> &batch,
+                                           unsigned long long queueWaitUsec = 0);
+
+    /* Size to grow a module command to for its response. 0 = the size it was sent with */
+    static size_t GetModuleCommandResponseLength(dcgm_module_command_header_t const *moduleCommand);
 
     /*****************************************************************************
      Get the status for an entity
@@ -216,7 +258,10 @@ public:
     /*****************************************************************************
      Notify this object that field values we subscribed for updated.
      *****************************************************************************/
-    void OnFvUpdates(DcgmFvBuffer *fvBuffer, DcgmWatcherType_t *watcherTypes, int numWatcherTypes, void *userData);
+    void OnFvUpdates(std::shared_ptr<DcgmFvBuffer const> const &fvBuffer,
+                     DcgmWatcherType_t *watcherTypes,
+                     int numWatcherTypes,
+                     void *userData);
 
     /*****************************************************************************
      Notify this object that mig configuration has updated.
@@ -243,6 +288,23 @@ public:
      */
     void NotifyRequestOfCompletion(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId);
 
+    /*****************************************************************************
+     * Set whether client commands to a module are processed on up to
+     * commandThreads threads of that module instead of the request worker they
+     * arrived on. 0 keeps them on the request worker. The worker hands the
+     * command off and the module's thread sends the reply once the command
+     * completes, so slow module commands don't hold up workers.
+     * Commands of the host engine itself and those of the subCommands set in
+     * inlineSubCommands are still processed on the caller's thread. Modules call
+     * this through their DcgmCoreProxy while they are being loaded.
+     *
+     * Returns DCGM_ST_OK on success
+     *         DCGM_ST_BADPARAM for a bad moduleId
+     *****************************************************************************/
+    dcgmReturn_t SetModuleDispatch(dcgmModuleId_t moduleId,
+                                   unsigned int commandThreads,
+                                   unsigned long long inlineSubCommands);
+
     /*****************************************************************************
      * Send a raw message to a connected client
      *
@@ -278,6 +340,13 @@ public:
         return it != m_persistAfterDisconnect.end();
     }
 
+    /*****************************************************************************/
+    /* Get the compression settings and traffic of a client's connection */
+    dcgmReturn_t GetConnectionStats(dcgm_connection_id_t connectionId, DcgmIpcConnectionStats_t &stats)
+    {
+        return m_dcgmIpc.GetConnectionStats(connectionId, stats);
+    }
+
     /*****************************************************************************/
     dcgmReturn_t JobStartStats(std::string const &jobId, unsigned int groupId);
 
@@ -285,7 +354,38 @@ public:
     dcgmReturn_t JobStopStats(std::string const &jobId);
 
     /*****************************************************************************/
-    dcgmReturn_t JobGetStats(const std::string &jobId, dcgmJobInfo_t *pJobInfo);
+    /*
+     * updateSequence OUT: Optional. Set to the update sequence of the job the stats are current as of
+     */
+    dcgmReturn_t JobGetStats(const std::string &jobId,
+                             dcgmJobInfo_t *pJobInfo,
+                             unsigned long long *updateSequence = nullptr);
+
+    /*****************************************************************************/
+    /*
+     * Like JobGetStats() but only fills pJobInfo if the job changed since
+     * updateSequence, which is then set to the job's. Checking costs a lookup
+     * of the job in the accumulator, so a watched job is only rebuilt when
+     * samples were folded into it or it stopped
+     *
+     * Returns: DCGM_ST_OK on success, whether or not the job changed
+     *          DCGM_ST_NO_DATA if there is no such job
+     *          DCGM_ST_VER_MISMATCH if pJobInfo->version is wrong
+     */
+    dcgmReturn_t JobGetStatsSince(std::string const &jobId,
+                                  unsigned long long &updateSequence,
+                                  dcgmJobInfo_t *pJobInfo);
+
+    /*****************************************************************************/
+    /*
+     * Get the percentiles of a job's gauges from the quantile sketches of its
+     * GPUs. The summary merges the sketches of all GPUs
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if there is no such job
+     *          DCGM_ST_VER_MISMATCH if percentiles.version is wrong
+     */
+    dcgmReturn_t JobGetPercentiles(std::string const &jobId, dcgmJobPercentiles_t &percentiles);
 
     /*****************************************************************************/
     dcgmReturn_t JobRemove(std::string const &jobId);
@@ -298,13 +398,17 @@ public:
      *
      * This helper is used both internally and externally
      *
+     * snapshot IN: Fetch the watches together with shared timestamps. See
+     *              DcgmCacheManager::AddSnapshotGroup()
+     *
      ****************************************************************************/
     dcgmReturn_t WatchFieldGroup(unsigned int groupId,
                                  dcgmFieldGrp_t fieldGroupId,
                                  timelib64_t monitorFrequencyUsec,
                                  double maxSampleAge,
                                  int maxKeepSamples,
-                                 DcgmWatcher const &watcher);
+                                 DcgmWatcher const &watcher,
+                                 bool snapshot = false);
 
     /*****************************************************************************
      * Remove a watch on a field group
@@ -314,6 +418,119 @@ public:
      ****************************************************************************/
     dcgmReturn_t UnwatchFieldGroup(unsigned int groupId, dcgmFieldGrp_t fieldGroupId, DcgmWatcher const &watcher);
 
+    /*****************************************************************************
+     * Subscribe a client to a stream of the values of a field group on a group.
+     * The stream is identified by connectionId and requestId, which batches of
+     * values are sent to. See dcgmFieldValueStreamSubscribe()
+     *
+     ****************************************************************************/
+    dcgmReturn_t SubscribeFieldValueStream(dcgm_connection_id_t connectionId,
+                                           dcgm_request_id_t requestId,
+                                           unsigned int groupId,
+                                           dcgmFieldGrp_t fieldGroupId,
+                                           timelib64_t monitorFrequencyUsec,
+                                           double maxSampleAge,
+                                           int maxKeepSamples,
+                                           unsigned int maxBatchesInFlight,
+                                           unsigned int maxPendingValues);
+
+    /*****************************************************************************
+     * Remove a stream added by SubscribeFieldValueStream() and notify the client
+     * that its request is complete
+     *
+     ****************************************************************************/
+    dcgmReturn_t UnsubscribeFieldValueStream(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId);
+
+    /*****************************************************************************
+     * Subscribe a client to the values of a field group on groupId of every host
+     * engine this one proxies. See dcgmProxyStreamSubscribe()
+     *
+     * Returns DCGM_ST_NOT_SUPPORTED if this host engine isn't a proxy
+     *
+     ****************************************************************************/
+    dcgmReturn_t SubscribeProxyStream(dcgm_connection_id_t connectionId,
+                                      dcgm_request_id_t requestId,
+                                      dcgmFieldValueStreamParams_v1 const &params);
+
+    /*****************************************************************************
+     * Remove a stream added by SubscribeProxyStream() and notify the client that
+     * its request is complete
+     *
+     ****************************************************************************/
+    dcgmReturn_t UnsubscribeProxyStream(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId);
+
+    /*****************************************************************************
+     * Get the state of the host engines this one proxies
+     *
+     * Returns DCGM_ST_NOT_SUPPORTED if this host engine isn't a proxy
+     *
+     ****************************************************************************/
+    dcgmReturn_t GetProxyHosts(dcgmProxyHosts_v1 &hosts);
+
+    /*****************************************************************************
+     * Get the worker threads of each request lane. No lanes are reported before
+     * RunServer() or when only embedded clients are served
+     *
+     ****************************************************************************/
+    dcgmReturn_t GetWorkerStats(dcgmHostengineWorkerStats_v1 &stats);
+
+    /*****************************************************************************
+     * Get the counts and latencies of each type of request remote clients sent
+     * since the host engine started. See dcgmIntrospectGetRequestStats()
+     *
+     ****************************************************************************/
+    dcgmReturn_t GetRequestStats(dcgmIntrospectRequestStats_t &requestStats);
+
+    /*****************************************************************************
+     * Get the memory of the host engine by the subsystem, module and watcher it
+     * is charged to. See dcgmIntrospectGetMemoryAccounting()
+     *
+     ****************************************************************************/
+    dcgmReturn_t GetMemoryAccounting(dcgmIntrospectMemoryAccounting_t &accounting);
+
+    /*****************************************************************************
+     * Predict the cost of watching the field group of cost on the group of cost
+     * as connectionId sees them. See dcgmIntrospectEstimateWatchCost()
+     *
+     ****************************************************************************/
+    dcgmReturn_t EstimateWatchCost(dcgm_connection_id_t connectionId, dcgmIntrospectWatchCost_t &cost);
+
+    /*****************************************************************************
+     * Get the token that connectionId can take its state back with after the
+     * host engine restarts, making one if it has none yet. See
+     * dcgmSessionGetToken()
+     *
+     ****************************************************************************/
+    dcgmReturn_t GetSessionToken(dcgm_connection_id_t connectionId, unsigned long long &token);
+
+    /*****************************************************************************
+     * Hand the state restored for token over to connectionId. See
+     * dcgmSessionResume()
+     *
+     * Returns DCGM_ST_NO_DATA if no restored state is waiting for token
+     *
+     ****************************************************************************/
+    dcgmReturn_t ResumeSession(dcgm_connection_id_t connectionId, unsigned long long token);
+
+    /*****************************************************************************
+     * Push each new attribute generation to requestId of a client until its
+     * connection closes. See dcgmClientCacheEnable()
+     *
+     * generation OUT: The current attribute generation
+     *
+     ****************************************************************************/
+    dcgmReturn_t SubscribeAttributeGeneration(dcgm_connection_id_t connectionId,
+                                              dcgm_request_id_t requestId,
+                                              unsigned long long *generation);
+
+    /*****************************************************************************
+     * Note that attributes clients may have cached changed, like the GPUs that are
+     * attached, their MIG configuration or the field groups. Pushes the new
+     * generation to subscribed clients
+     *
+     ****************************************************************************/
+    void BumpAttributeGeneration();
+
     dcgmReturn_t HelperGetTopologyIO(unsigned int groupid, dcgmTopology_t &gpuTopology);
     dcgmReturn_t HelperGetTopologyAffinity(unsigned int groupid, dcgmAffinity_t &gpuAffinity);
     dcgmReturn_t HelperSelectGpusByTopology(uint32_t numGpus, uint64_t inputGpus, uint64_t hints, uint64_t &outputGpus);
@@ -426,6 +643,18 @@ private:
 
     dcgmReturn_t SendModuleMessage(dcgmModuleId_t moduleId, dcgm_module_command_header_t *moduleCommand);
 
+    /*****************************************************************************
+     * Process a DCGM_MSG_MODULE_COMMAND that has been validated and sized by
+     * ProcessModuleCommandMsg() and send its reply
+     *****************************************************************************/
+    void FinishModuleCommandMsg(dcgm_connection_id_t connectionId, std::unique_ptr<DcgmMessage> message);
+
+    /* Stop and free the command queues of all modules. Queued commands are dropped */
+    void StopModuleCommandQueues();
+
+    /* Load the modules with a load policy of policy, logging how long each took */
+    void LoadModulesWithPolicy(DcgmModuleLoadPolicy_t policy);
+
     /*****************************************************************************/
     /* Helper methods */
     dcgmReturn_t HelperGetInt64StatSummary(dcgm_field_entity_group_t entityGroupId,
@@ -441,6 +670,10 @@ private:
                                            long long startTime,
                                            long long endTime);
 
+    /* Watch the fields of DcgmJobStatsAccumulator on those of gpuIds that have running jobs and unwatch them on
+       the others */
+    void UpdateJobStatsWatches(std::vector<unsigned int> const &gpuIds);
+
 
     /*****************************************************************************
      * Add a watch on a field group for all GPUs
@@ -577,11 +810,6 @@ private:
     DcgmHostEngineHandler(dcgmStartEmbeddedV2Params_v1 params);
     virtual ~DcgmHostEngineHandler();
 
-    /* This data structure is used to store user provided job id information and associates start
-       and stop timestamp with the user provided start/stop notification. */
-    typedef std::map<std::string, jobRecord_t> jobIdMap_t;
-    jobIdMap_t mJobIdMap;
-
     /* Core module is always loaded. We create a static object for Core with this class */
     static DcgmModuleCore mModuleCoreObj;
 
@@ -595,6 +823,90 @@ private:
 
     DcgmIpc m_dcgmIpc; /* IPC object */
 
+    /* Protects m_attributeGeneration and m_attributeSubscribers. Never held while sending */
+    std::mutex m_attributeMutex;
+    unsigned long long m_attributeGeneration = 1;
+    std::unordered_map<dcgm_connection_id_t, dcgm_request_id_t> m_attributeSubscribers;
+
+    /* Field value streams of clients. Fed by OnFvUpdates() */
+    DcgmFvStreamManager m_fvStreamManager {
+        [this](dcgm_connection_id_t connectionId,
+               unsigned int msgType,
+               dcgm_request_id_t requestId,
+               void *msgData,
+               int msgLength,
+               dcgmReturn_t status) {
+            return SendRawMessageToClient(connectionId, msgType, requestId, msgData, msgLength, status);
+        },
+        [this](char const *fvs, size_t size) {
+            mpCacheManager->RecordSampleLag(DCGM_INTROSPECT_LAG_IPC_SEND, fvs, size);
+        }
+    };
+
+    /* Jobs and their stats, kept up to date by OnFvUpdates(). See JobStartStats() */
+    DcgmJobStatsAccumulator m_jobStatsAccumulator;
+    std::mutex m_jobStatsWatchMutex; /* Serializes UpdateJobStatsWatches() */
+
+    /* Counts and latencies of the requests of remote clients by request type */
+    DcgmRequestStats m_requestStats;
+
+    /* Memory of requests being processed. Other subsystems are measured by
+       GetMemoryAccounting() rather than charged */
+    DcgmMemoryCounter m_protobufMemory;
+    std::array<DcgmMemoryCounter, DcgmModuleIdCount> m_moduleMemory; /* Module commands by moduleId */
+
+    /* Counter to charge a module command for moduleId to. nullptr if moduleId isn't a module */
+    DcgmMemoryCounter *ModuleMemory(unsigned int moduleId);
+
+    /* Collects from other host engines when this one runs as a proxy. nullptr otherwise */
+    std::unique_ptr<DcgmProxyManager> m_proxyManager;
+
+    /* Serves OpenMetrics scrapes when nv-hostengine was started with --metrics-listen. nullptr otherwise */
+    std::unique_ptr<DcgmMetricsExporter> m_metricsExporter;
+
+    /* Pushes OTLP metrics when nv-hostengine was started with --otlp-endpoint. nullptr otherwise */
+    std::unique_ptr<DcgmOtlpExporter> m_otlpExporter;
+
+    /* Publishes the latest values to shared memory when nv-hostengine was started with --latest-board. nullptr
+       otherwise */
+    std::unique_ptr<DcgmLatestValueBoard> m_latestValueBoard;
+
+    /* Rotates through multiplexed profiling watches. See DCGM_PROF_WATCH_FLAG_MULTIPLEX */
+    std::unique_ptr<DcgmProfMultiplexer> m_profMultiplexer;
+
+    /* Loads the DcgmModuleLoadPrewarm modules once RunServer() is listening. Joined by the destructor */
+    std::thread m_prewarmThread;
+
+    /*****************************************************************************/
+    /* Save the state of every connection with a session token to the file named by
+       DCGM_ENV_STATE_CHECKPOINT, along with the policies of the GPUs. Called by the
+       destructor once requests are no longer processed */
+    void SaveStateCheckpoint();
+
+    /* Restore what SaveStateCheckpoint() saved, each session under a parked connection
+       ID until it is resumed. Called by RunServer() before it starts listening */
+    void LoadStateCheckpoint();
+
+    /* Remove the state of parked sessions nobody resumed in time. Runs on m_sessionExpiryThread */
+    void ExpireParkedSessions();
+
+    struct ParkedSession
+    {
+        dcgm_connection_id_t connectionId; /* Connection the restored state belongs to until it is resumed */
+        timelib64_t expireUsec;            /* When the state is removed if not resumed by then */
+    };
+
+    /* Protects the session members below. Never held while calling the managers */
+    std::mutex m_sessionMutex;
+    std::unordered_map<dcgm_connection_id_t, unsigned long long> m_sessionTokens; /* By connection, parked ones too */
+    std::unordered_map<unsigned long long, ParkedSession> m_parkedSessions;       /* Not resumed yet, by token */
+    std::condition_variable m_sessionCondition; /* Wakes m_sessionExpiryThread to stop */
+    bool m_stopSessionExpiry = false;
+    std::thread m_sessionExpiryThread; /* Only started if sessions were restored. Joined by the destructor */
+
+    /* Set while the constructor runs so that default groups don't load modules that aren't eager */
+    bool m_startingUp = true;
+
     /* Field Groups */
     dcgmFieldGrp_t mFieldGroup1Sec;
     dcgmFieldGrp_t mFieldGroup30Sec;
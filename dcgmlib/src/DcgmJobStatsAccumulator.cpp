@@ -0,0 +1,518 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmJobStatsAccumulator.h"
+#include "DcgmLogging.h"
+#include "dcgm_fields.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+/*****************************************************************************/
+template <typename T>
+dcgmReturn_t DcgmJobGpuStats::GetSummaries(unsigned short fieldId,
+                                           int numSummaryTypes,
+                                           DcgmcmSummaryType_t const *summaryTypes,
+                                           T *summaryValues) const
+{
+    for (int stIndex = 0; stIndex < numSummaryTypes; stIndex++)
+    {
+        summaryValues[stIndex] = DcgmcmSummaryAccumulator<T>::Blank();
+    }
+
+    auto it = summaries.find(fieldId);
+    if (it == summaries.end())
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    DcgmcmSummaryAccumulator<T> const *summary;
+    if constexpr (std::is_integral_v<T>)
+        summary = &it->second.i64;
+    else
+        summary = &it->second.fp64;
+
+    if (!summary->Nseen)
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    return summary->GetSummaries(numSummaryTypes, summaryTypes, summaryValues);
+}
+
+template dcgmReturn_t DcgmJobGpuStats::GetSummaries<long long>(unsigned short,
+                                                               int,
+                                                               DcgmcmSummaryType_t const *,
+                                                               long long *) const;
+template dcgmReturn_t DcgmJobGpuStats::GetSummaries<double>(unsigned short,
+                                                            int,
+                                                            DcgmcmSummaryType_t const *,
+                                                            double *) const;
+
+/*****************************************************************************/
+DcgmQuantileSketch const *DcgmJobGpuStats::GetSketch(unsigned short fieldId) const
+{
+    auto it = summaries.find(fieldId);
+    if (it == summaries.end())
+    {
+        return nullptr;
+    }
+
+    /* Only the accumulator of the field's type keeps a sketch */
+    if (it->second.i64.HasPercentiles())
+        return &it->second.i64.sketch;
+    if (it->second.fp64.HasPercentiles())
+        return &it->second.fp64.sketch;
+    return nullptr;
+}
+
+/*****************************************************************************/
+/* Whether a job field is sampled as a level rather than counted, so that its percentiles mean something */
+static bool IsGaugeField(unsigned short fieldId)
+{
+    switch (fieldId)
+    {
+        case DCGM_FI_DEV_POWER_USAGE:
+        case DCGM_FI_DEV_PCIE_RX_THROUGHPUT:
+        case DCGM_FI_DEV_PCIE_TX_THROUGHPUT:
+        case DCGM_FI_DEV_GPU_UTIL:
+        case DCGM_FI_DEV_MEM_COPY_UTIL:
+        case DCGM_FI_DEV_SM_CLOCK:
+        case DCGM_FI_DEV_MEM_CLOCK:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*****************************************************************************/
+std::vector<unsigned short> const &DcgmJobStatsAccumulator::GetFieldIds()
+{
+    static std::vector<unsigned short> const fieldIds {
+        DCGM_FI_DEV_POWER_USAGE,
+        DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION,
+        DCGM_FI_DEV_PCIE_RX_THROUGHPUT,
+        DCGM_FI_DEV_PCIE_TX_THROUGHPUT,
+        DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
+        DCGM_FI_DEV_GPU_UTIL,
+        DCGM_FI_DEV_MEM_COPY_UTIL,
+        DCGM_FI_DEV_ECC_DBE_VOL_TOTAL,
+        DCGM_FI_DEV_SM_CLOCK,
+        DCGM_FI_DEV_MEM_CLOCK,
+        DCGM_FI_DEV_XID_ERRORS,
+        DCGM_FI_DEV_COMPUTE_PIDS,
+        DCGM_FI_DEV_GRAPHICS_PIDS,
+        DCGM_FI_DEV_POWER_VIOLATION,
+        DCGM_FI_DEV_THERMAL_VIOLATION,
+        DCGM_FI_DEV_RELIABILITY_VIOLATION,
+        DCGM_FI_DEV_BOARD_LIMIT_VIOLATION,
+        DCGM_FI_DEV_LOW_UTIL_VIOLATION,
+        DCGM_FI_DEV_SYNC_BOOST_VIOLATION,
+    };
+    return fieldIds;
+}
+
+/*****************************************************************************/
+void DcgmJobStatsAccumulator::SetRetention(unsigned int maxStoppedJobs, timelib64_t stoppedJobTtlUsec)
+{
+    m_maxStoppedJobsPerShard = (maxStoppedJobs + NUM_SHARDS - 1) / NUM_SHARDS;
+    m_stoppedJobTtlUsec      = stoppedJobTtlUsec;
+}
+
+/*****************************************************************************/
+DcgmJobStatsAccumulator::Shard &DcgmJobStatsAccumulator::GetShard(std::string const &jobId)
+{
+    return m_shards[std::hash<std::string> {}(jobId) % NUM_SHARDS];
+}
+
+/*****************************************************************************/
+std::shared_ptr<DcgmJobStatsAccumulator::Job> DcgmJobStatsAccumulator::FindJob(std::string const &jobId)
+{
+    Shard &shard = GetShard(jobId);
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+
+    auto it = shard.jobs.find(jobId);
+    if (it == shard.jobs.end())
+    {
+        return nullptr;
+    }
+    return it->second;
+}
+
+/*****************************************************************************/
+void DcgmJobStatsAccumulator::EvictStoppedJobs(Shard &shard, timelib64_t now)
+{
+    unsigned int maxStoppedJobs   = m_maxStoppedJobsPerShard;
+    timelib64_t stoppedJobTtlUsec = m_stoppedJobTtlUsec;
+
+    while (!shard.stopped.empty())
+    {
+        auto const &[endTime, jobId] = shard.stopped.front();
+
+        bool overCap = maxStoppedJobs != 0 && shard.stopped.size() > maxStoppedJobs;
+        bool pastTtl = stoppedJobTtlUsec != 0 && now - endTime > stoppedJobTtlUsec;
+        if (!overCap && !pastTtl)
+        {
+            break;
+        }
+
+        DCGM_LOG_DEBUG << "Evicting job " << jobId << " that stopped at " << endTime;
+        shard.jobs.erase(jobId);
+        shard.stopped.pop_front();
+        m_evictedJobs++;
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmJobStatsAccumulator::AddJob(std::string const &jobId,
+                                             unsigned int groupId,
+                                             timelib64_t startTime,
+                                             std::vector<unsigned int> const &gpuIds,
+                                             std::vector<unsigned int> &newGpuIds)
+{
+    newGpuIds.clear();
+
+    Shard &shard = GetShard(jobId);
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+
+    EvictStoppedJobs(shard, startTime);
+
+    if (shard.jobs.count(jobId))
+    {
+        return DCGM_ST_DUPLICATE_KEY;
+    }
+
+    auto job                  = std::make_shared<Job>();
+    job->stats.groupId        = groupId;
+    job->stats.startTime      = startTime;
+    job->stats.updateSequence = ++m_updateSequence;
+    for (unsigned int gpuId : gpuIds)
+    {
+        DcgmJobGpuStats gpuStats;
+        gpuStats.gpuId = gpuId;
+        job->stats.gpus.push_back(std::move(gpuStats));
+    }
+
+    {
+        std::lock_guard<std::mutex> runningLock(m_runningMutex);
+        for (unsigned int gpuId : gpuIds)
+        {
+            std::vector<std::shared_ptr<Job>> &runningJobs = m_runningJobsByGpu[gpuId];
+            if (runningJobs.empty())
+            {
+                newGpuIds.push_back(gpuId);
+            }
+            runningJobs.push_back(job);
+        }
+    }
+
+    shard.jobs[jobId] = std::move(job);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmJobStatsAccumulator::StopRunningJob(std::shared_ptr<Job> const &job, std::vector<unsigned int> &unusedGpuIds)
+{
+    std::lock_guard<std::mutex> runningLock(m_runningMutex);
+
+    /* gpus isn't changed after AddJob(), so it can be read without job->mutex */
+    for (DcgmJobGpuStats const &gpuStats : job->stats.gpus)
+    {
+        auto it = m_runningJobsByGpu.find(gpuStats.gpuId);
+        if (it == m_runningJobsByGpu.end())
+        {
+            continue;
+        }
+
+        std::vector<std::shared_ptr<Job>> &runningJobs = it->second;
+        runningJobs.erase(std::remove(runningJobs.begin(), runningJobs.end(), job), runningJobs.end());
+        if (runningJobs.empty())
+        {
+            m_runningJobsByGpu.erase(it);
+            unusedGpuIds.push_back(gpuStats.gpuId);
+        }
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmJobStatsAccumulator::StopJob(std::string const &jobId,
+                                              timelib64_t endTime,
+                                              std::vector<unsigned int> &unusedGpuIds)
+{
+    unusedGpuIds.clear();
+
+    Shard &shard = GetShard(jobId);
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+
+    auto it = shard.jobs.find(jobId);
+    if (it == shard.jobs.end())
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    std::shared_ptr<Job> job = it->second;
+    {
+        std::lock_guard<std::mutex> jobLock(job->mutex);
+        if (job->stats.endTime)
+        {
+            return DCGM_ST_OK; /* Already stopped */
+        }
+        job->stats.endTime        = endTime;
+        job->stats.updateSequence = ++m_updateSequence;
+    }
+
+    StopRunningJob(job, unusedGpuIds);
+
+    job->stoppedIt = shard.stopped.emplace(shard.stopped.end(), endTime, jobId);
+    EvictStoppedJobs(shard, endTime);
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmJobStatsAccumulator::RemoveJob(std::string const &jobId, std::vector<unsigned int> &unusedGpuIds)
+{
+    unusedGpuIds.clear();
+
+    Shard &shard = GetShard(jobId);
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+
+    auto it = shard.jobs.find(jobId);
+    if (it == shard.jobs.end())
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    std::shared_ptr<Job> job = it->second;
+    bool isRunning;
+    {
+        std::lock_guard<std::mutex> jobLock(job->mutex);
+        isRunning = job->stats.endTime == 0;
+    }
+
+    if (isRunning)
+    {
+        StopRunningJob(job, unusedGpuIds);
+    }
+    else
+    {
+        shard.stopped.erase(job->stoppedIt);
+    }
+
+    shard.jobs.erase(it);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmJobStatsAccumulator::RemoveAllJobs(std::vector<unsigned int> &unusedGpuIds)
+{
+    std::unordered_set<Job const *> removedJobs;
+
+    unusedGpuIds.clear();
+
+    for (Shard &shard : m_shards)
+    {
+        std::lock_guard<std::mutex> shardLock(shard.mutex);
+        for (auto const &[jobId, job] : shard.jobs)
+        {
+            removedJobs.insert(job.get());
+        }
+        shard.jobs.clear();
+        shard.stopped.clear();
+    }
+
+    /* Jobs added to a shard after it was cleared are still running. Only drop the removed ones */
+    std::lock_guard<std::mutex> runningLock(m_runningMutex);
+    for (auto it = m_runningJobsByGpu.begin(); it != m_runningJobsByGpu.end();)
+    {
+        std::vector<std::shared_ptr<Job>> &runningJobs = it->second;
+        runningJobs.erase(std::remove_if(runningJobs.begin(),
+                                         runningJobs.end(),
+                                         [&](std::shared_ptr<Job> const &job) { return removedJobs.count(job.get()); }),
+                          runningJobs.end());
+        if (runningJobs.empty())
+        {
+            unusedGpuIds.push_back(it->first);
+            it = m_runningJobsByGpu.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/*****************************************************************************/
+void DcgmJobStatsAccumulator::Fold(DcgmJobGpuStats &stats, dcgmBufferedFv_t const &fv)
+{
+    switch (fv.fieldId)
+    {
+        case DCGM_FI_DEV_XID_ERRORS:
+            if (fv.status == DCGM_ST_OK && stats.xidTimestamps.size() < MAX_XID_TIMESTAMPS)
+            {
+                stats.xidTimestamps.push_back(fv.timestamp);
+            }
+            return;
+
+        case DCGM_FI_DEV_COMPUTE_PIDS:
+        case DCGM_FI_DEV_GRAPHICS_PIDS:
+        {
+            auto const *proc = (dcgmRunningProcess_t const *)fv.value.blob;
+            if (fv.status != DCGM_ST_OK || fv.fieldType != DCGM_FT_BINARY
+                || proc->version != dcgmRunningProcess_version)
+            {
+                return;
+            }
+
+            std::vector<unsigned int> &pids
+                = fv.fieldId == DCGM_FI_DEV_COMPUTE_PIDS ? stats.computePids : stats.graphicsPids;
+            if (pids.size() < DCGM_MAX_PID_INFO_NUM && std::find(pids.begin(), pids.end(), proc->pid) == pids.end())
+            {
+                pids.push_back(proc->pid);
+            }
+            return;
+        }
+
+        default:
+            break;
+    }
+
+    if (fv.fieldType != DCGM_FT_INT64 && fv.fieldType != DCGM_FT_DOUBLE)
+    {
+        return;
+    }
+
+    auto [summaryIt, isNew]          = stats.summaries.try_emplace(fv.fieldId);
+    dcgmcm_window_summary_t &summary = summaryIt->second;
+    if (isNew && IsGaugeField(fv.fieldId))
+    {
+        summary.i64.keepSketch  = fv.fieldType == DCGM_FT_INT64;
+        summary.fp64.keepSketch = fv.fieldType == DCGM_FT_DOUBLE;
+    }
+
+    /* Summaries depend on sample order. Drop a late sample rather than the whole summary */
+    timelib64_t lastUsec
+        = fv.fieldType == DCGM_FT_INT64 ? summary.i64.prevTimestamp : summary.fp64.prevTimestamp;
+    if (fv.timestamp < lastUsec)
+    {
+        DCGM_LOG_DEBUG << "Skipping out of order sample of fieldId " << fv.fieldId << " for gpuId " << stats.gpuId;
+        return;
+    }
+
+    if (fv.fieldType == DCGM_FT_INT64)
+        summary.i64.Add(fv.timestamp, fv.value.i64);
+    else
+        summary.fp64.Add(fv.timestamp, fv.value.dbl);
+}
+
+/*****************************************************************************/
+bool DcgmJobStatsAccumulator::HasRunningJobs(unsigned int gpuId)
+{
+    std::lock_guard<std::mutex> runningLock(m_runningMutex);
+    return m_runningJobsByGpu.count(gpuId) != 0;
+}
+
+/*****************************************************************************/
+void DcgmJobStatsAccumulator::OnFvUpdates(DcgmFvBuffer const &fvBuffer)
+{
+    std::lock_guard<std::mutex> runningLock(m_runningMutex);
+
+    if (m_runningJobsByGpu.empty())
+    {
+        return;
+    }
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    for (dcgmBufferedFv_t const *fv = fvBuffer.GetNextFv(&cursor); fv != nullptr; fv = fvBuffer.GetNextFv(&cursor))
+    {
+        if (fv->entityGroupId != DCGM_FE_GPU)
+        {
+            continue;
+        }
+
+        auto it = m_runningJobsByGpu.find(fv->entityId);
+        if (it == m_runningJobsByGpu.end())
+        {
+            continue;
+        }
+
+        for (std::shared_ptr<Job> const &job : it->second)
+        {
+            std::lock_guard<std::mutex> jobLock(job->mutex);
+
+            if (fv->timestamp < job->stats.startTime)
+            {
+                continue;
+            }
+
+            for (DcgmJobGpuStats &gpuStats : job->stats.gpus)
+            {
+                if (gpuStats.gpuId == fv->entityId)
+                {
+                    Fold(gpuStats, *fv);
+                    job->stats.updateSequence = ++m_updateSequence;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmJobStatsAccumulator::GetJobStats(std::string const &jobId, DcgmJobStatsSnapshot &snapshot)
+{
+    std::shared_ptr<Job> job = FindJob(jobId);
+    if (!job)
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    std::lock_guard<std::mutex> jobLock(job->mutex);
+    snapshot = job->stats;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmJobStatsAccumulator::GetJobUpdateSequence(std::string const &jobId,
+                                                           unsigned long long &updateSequence)
+{
+    std::shared_ptr<Job> job = FindJob(jobId);
+    if (!job)
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    std::lock_guard<std::mutex> jobLock(job->mutex);
+    updateSequence = job->stats.updateSequence;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+size_t DcgmJobStatsAccumulator::GetJobCount()
+{
+    size_t jobCount = 0;
+    for (Shard &shard : m_shards)
+    {
+        std::lock_guard<std::mutex> shardLock(shard.mutex);
+        jobCount += shard.jobs.size();
+    }
+    return jobCount;
+}
+
+/*****************************************************************************/
+unsigned long long DcgmJobStatsAccumulator::GetEvictedJobCount()
+{
+    return m_evictedJobs;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMJOBSTATSACCUMULATOR_H
+#define DCGMJOBSTATSACCUMULATOR_H
+
+#include "DcgmCacheManager.h"
+#include "DcgmFvBuffer.h"
+#include "dcgm_structs.h"
+#include "timelib.h"
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Running stats of one GPU of a job. See DcgmJobStatsAccumulator */
+struct DcgmJobGpuStats
+{
+    unsigned int gpuId = 0;
+    std::map<unsigned short, dcgmcm_window_summary_t> summaries; /* Numeric job fields by fieldId */
+    std::vector<timelib64_t> xidTimestamps;                      /* Of the first XID errors */
+    std::vector<unsigned int> computePids;                       /* In the order they were first seen */
+    std::vector<unsigned int> graphicsPids;                      /* In the order they were first seen */
+
+    /*************************************************************************/
+    /*
+     * Summaries of fieldId over the job so far. Like DcgmCacheManager::GetInt64SummaryData()
+     * and GetFp64SummaryData(), summaryValues are blank unless this returns DCGM_ST_OK
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if no sample of fieldId was seen
+     *          DCGM_ST_BADPARAM for an unknown summary type
+     */
+    template <typename T>
+    dcgmReturn_t GetSummaries(unsigned short fieldId,
+                              int numSummaryTypes,
+                              DcgmcmSummaryType_t const *summaryTypes,
+                              T *summaryValues) const;
+
+    /* Distribution of fieldId over the job so far. nullptr if fieldId isn't a gauge or no sample of it was seen */
+    DcgmQuantileSketch const *GetSketch(unsigned short fieldId) const;
+};
+
+/* A job and the stats of its GPUs. See DcgmJobStatsAccumulator::GetJobStats() */
+struct DcgmJobStatsSnapshot
+{
+    unsigned int groupId  = 0; /* Group the job was started on */
+    timelib64_t startTime = 0;
+    timelib64_t endTime   = 0; /* 0 = still running */
+    std::vector<DcgmJobGpuStats> gpus;
+    unsigned long long updateSequence = 0; /* Higher after any change to the job. Unique across jobs */
+};
+
+/*
+ * Tracks jobs (see dcgmJobStartStats) and keeps their stats up to date as
+ * samples arrive, so that dcgmJobGetStats doesn't depend on how much history
+ * the cache keeps and doesn't have to walk it.
+ *
+ * Each job folds the samples of its GPUs that are timestamped from its start
+ * until it is stopped into running summaries (see DcgmcmSummaryAccumulator),
+ * the timestamps of its first XID errors and the processes that ran. The
+ * summaries of gauges, like power usage and clocks, also keep a quantile
+ * sketch for their percentiles.
+ *
+ * Jobs are hashed into shards by jobId and each job has its own lock, so
+ * operations on different jobs don't wait on each other and their cost doesn't
+ * depend on how many jobs are tracked. Stopped jobs that are never removed
+ * are evicted once they have been stopped for longer than the stopped job TTL,
+ * or oldest first once a shard holds more than its share of the stopped job
+ * cap. Running jobs are never evicted.
+ *
+ * This class doesn't watch fields itself. The caller watches GetFieldIds() on
+ * the GPUs a new job reports, subscribed for updates, passes the updates to
+ * OnFvUpdates() and unwatches the GPUs this class reports as no longer used
+ * by any running job.
+ */
+class DcgmJobStatsAccumulator
+{
+public:
+    static constexpr unsigned int MAX_XID_TIMESTAMPS = 10; /* Capacity of dcgmGpuUsageInfo_t.xidCriticalErrorsTs */
+    static constexpr unsigned int NUM_SHARDS         = 16;
+
+    static constexpr unsigned int DEFAULT_MAX_STOPPED_JOBS     = 4096;
+    static constexpr timelib64_t DEFAULT_STOPPED_JOB_TTL_USEC = 7 * 86400 * 1000000LL;
+
+    /* Fields that are folded into job stats */
+    static std::vector<unsigned short> const &GetFieldIds();
+
+    /*************************************************************************/
+    /*
+     * Set how many stopped jobs are kept and for how long. Applies from the
+     * next job that is added or stopped
+     *
+     * maxStoppedJobs     IN: Cap of stopped jobs across all shards. 0 = no cap
+     * stoppedJobTtlUsec  IN: How long after it stopped a job is kept. 0 = forever
+     */
+    void SetRetention(unsigned int maxStoppedJobs, timelib64_t stoppedJobTtlUsec);
+
+    /*************************************************************************/
+    /*
+     * Start accumulating a job
+     *
+     * jobId      IN: Job to add
+     * groupId    IN: Group the job was started on. Only kept for GetJobStats()
+     * startTime  IN: Samples before this aren't part of the job
+     * gpuIds     IN: GPUs of the job
+     * newGpuIds OUT: GPUs of the job that no other running job had
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_DUPLICATE_KEY if jobId already exists
+     */
+    dcgmReturn_t AddJob(std::string const &jobId,
+                        unsigned int groupId,
+                        timelib64_t startTime,
+                        std::vector<unsigned int> const &gpuIds,
+                        std::vector<unsigned int> &newGpuIds);
+
+    /*************************************************************************/
+    /*
+     * Stop accumulating a job. Its stats are kept until RemoveJob() or until it
+     * is evicted
+     *
+     * unusedGpuIds OUT: GPUs of the job that no other running job has
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if there is no such job
+     */
+    dcgmReturn_t StopJob(std::string const &jobId, timelib64_t endTime, std::vector<unsigned int> &unusedGpuIds);
+
+    /*************************************************************************/
+    /*
+     * Forget a job, stopping it first if it's running
+     *
+     * unusedGpuIds OUT: GPUs of the job that no other running job has
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if there is no such job
+     */
+    dcgmReturn_t RemoveJob(std::string const &jobId, std::vector<unsigned int> &unusedGpuIds);
+
+    /* Forget every job. unusedGpuIds gets the GPUs running jobs had */
+    void RemoveAllJobs(std::vector<unsigned int> &unusedGpuIds);
+
+    /* Whether any running job has gpuId */
+    bool HasRunningJobs(unsigned int gpuId);
+
+    /* Fold the values of fvBuffer into the running jobs of their GPUs */
+    void OnFvUpdates(DcgmFvBuffer const &fvBuffer);
+
+    /*************************************************************************/
+    /*
+     * Get a copy of a job and the stats of each of its GPUs
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if there is no such job
+     */
+    dcgmReturn_t GetJobStats(std::string const &jobId, DcgmJobStatsSnapshot &snapshot);
+
+    /*************************************************************************/
+    /*
+     * Get the updateSequence of a job without copying its stats, to tell
+     * whether it changed since a snapshot
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if there is no such job
+     */
+    dcgmReturn_t GetJobUpdateSequence(std::string const &jobId, unsigned long long &updateSequence);
+
+    /* Number of jobs. For tests and logging */
+    size_t GetJobCount();
+
+    /* Number of stopped jobs evicted so far. For tests and logging */
+    unsigned long long GetEvictedJobCount();
+
+private:
+    struct Job
+    {
+        std::mutex mutex; /* Protects endTime and stats. Taken after a shard's mutex or m_runningMutex */
+        DcgmJobStatsSnapshot stats;
+        std::list<std::pair<timelib64_t, std::string>>::iterator stoppedIt; /* Entry in Shard::stopped once stopped */
+    };
+
+    struct Shard
+    {
+        std::mutex mutex; /* Protects the members of this shard */
+        std::unordered_map<std::string, std::shared_ptr<Job>> jobs;
+        std::list<std::pair<timelib64_t, std::string>> stopped; /* endTime and jobId of the stopped jobs of this
+                                                                   shard, longest stopped first */
+    };
+
+    std::array<Shard, NUM_SHARDS> m_shards;
+
+    std::atomic<unsigned int> m_maxStoppedJobsPerShard {
+        (DEFAULT_MAX_STOPPED_JOBS + NUM_SHARDS - 1) / NUM_SHARDS
+    };
+    std::atomic<timelib64_t> m_stoppedJobTtlUsec { DEFAULT_STOPPED_JOB_TTL_USEC };
+    std::atomic<unsigned long long> m_evictedJobs { 0 };
+    std::atomic<unsigned long long> m_updateSequence { 0 }; /* Last updateSequence given to a job */
+
+    std::mutex m_runningMutex; /* Protects m_runningJobsByGpu. Taken after a shard's mutex */
+    std::unordered_map<unsigned int, std::vector<std::shared_ptr<Job>>> m_runningJobsByGpu; /* gpuId -> running jobs */
+
+    Shard &GetShard(std::string const &jobId);
+
+    /* Find a job. nullptr if there is no such job */
+    std::shared_ptr<Job> FindJob(std::string const &jobId);
+
+    /* Drop job from m_runningJobsByGpu and add the GPUs no running job has left to unusedGpuIds */
+    void StopRunningJob(std::shared_ptr<Job> const &job, std::vector<unsigned int> &unusedGpuIds);
+
+    /* Evict the stopped jobs of shard that are past the TTL at now, and the longest stopped ones while shard
+       has more than its share of the cap. Caller holds shard.mutex */
+    void EvictStoppedJobs(Shard &shard, timelib64_t now);
+
+    /* Fold one value into stats */
+    static void Fold(DcgmJobGpuStats &stats, dcgmBufferedFv_t const &fv);
+};
+
+#endif // DCGMJOBSTATSACCUMULATOR_H
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmLatestValueBoard.h"
+#include "DcgmLogging.h"
+#include "dcgm_fields.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*****************************************************************************/
+DcgmLatestValueBoard::DcgmLatestValueBoard(std::vector<unsigned short> fieldIds,
+                                           std::unique_ptr<DcgmMetricsSource> source,
+                                           timelib64_t updateFreqUsec)
+    : DcgmThread(false, "dcgm_latest_board")
+    , m_source(std::move(source))
+    , m_updateFreqUsec(updateFreqUsec)
+{
+    for (unsigned short fieldId : fieldIds)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        if (fieldMeta == nullptr)
+        {
+            DCGM_LOG_ERROR << "Not publishing unknown fieldId " << fieldId;
+            continue;
+        }
+        if (fieldMeta->fieldType != DCGM_FT_INT64 && fieldMeta->fieldType != DCGM_FT_DOUBLE)
+        {
+            DCGM_LOG_WARNING << "Not publishing fieldId " << fieldId << ". Only numeric fields can be published";
+            continue;
+        }
+        m_fieldIds.push_back(fieldId);
+    }
+
+    /* The entries of an entity are sorted by fieldId */
+    std::sort(m_fieldIds.begin(), m_fieldIds.end());
+    m_fieldIds.erase(std::unique(m_fieldIds.begin(), m_fieldIds.end()), m_fieldIds.end());
+}
+
+/*****************************************************************************/
+DcgmLatestValueBoard::~DcgmLatestValueBoard()
+{
+    StopAndWait(60000);
+
+    if (m_mapping == nullptr)
+    {
+        return;
+    }
+
+    /* Readers that still have it mapped see that nothing will update it anymore */
+    __atomic_store_n(&m_header->closed, 1, __ATOMIC_RELEASE);
+    munmap(m_mapping, m_size);
+    shm_unlink(m_name.c_str());
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmLatestValueBoard::Create(std::string const &name)
+{
+    if (m_mapping != nullptr)
+    {
+        return DCGM_ST_OK;
+    }
+
+    dcgmReturn_t dcgmReturn = m_source->GetEntities(m_entities);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " finding the entities to publish";
+    }
+    if (!m_entities.empty() && !m_fieldIds.empty())
+    {
+        /* Logged by the source. Fields that are watched are still published */
+        m_source->Watch(m_entities, m_fieldIds, m_updateFreqUsec);
+    }
+
+    std::sort(m_entities.begin(), m_entities.end(), [](auto const &a, auto const &b) {
+        return a.entityGroupId < b.entityGroupId || (a.entityGroupId == b.entityGroupId && a.entityId < b.entityId);
+    });
+
+    size_t numEntries = m_entities.size() * m_fieldIds.size();
+    size_t size       = sizeof(dcgmLatestBoardHeader_t) + numEntries * sizeof(dcgmLatestBoardEntry_t);
+
+    /* Don't let readers map what another host engine left behind */
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        DCGM_LOG_ERROR << "Unable to create the latest value board " << name << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    void *mapping = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+    {
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int savedErrno = errno;
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        DCGM_LOG_ERROR << "Unable to size and map the latest value board " << name << ": " << strerror(savedErrno);
+        shm_unlink(name.c_str());
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    m_name    = name;
+    m_mapping = mapping;
+    m_size    = size;
+    m_header  = static_cast<dcgmLatestBoardHeader_t *>(mapping);
+    m_entries = reinterpret_cast<dcgmLatestBoardEntry_t *>(m_header + 1);
+
+    /* ftruncate() zeroed the segment, so readers don't take it for ready before the magic is set */
+    m_header->version        = DCGM_LATEST_BOARD_VERSION;
+    m_header->numEntries     = (std::uint32_t)numEntries;
+    m_header->entrySize      = sizeof(dcgmLatestBoardEntry_t);
+    m_header->writerPid      = (std::uint32_t)getpid();
+    m_header->updateFreqUsec = (std::uint64_t)m_updateFreqUsec;
+
+    size_t index = 0;
+    for (auto const &entity : m_entities)
+    {
+        for (unsigned short fieldId : m_fieldIds)
+        {
+            dcgmLatestBoardEntry_t &entry = m_entries[index];
+            entry.entityGroupId           = entity.entityGroupId;
+            entry.entityId                = entity.entityId;
+            entry.fieldId                 = fieldId;
+            entry.fieldType               = (std::uint8_t)DcgmFieldGetById(fieldId)->fieldType;
+            entry.status                  = DCGM_ST_NO_DATA;
+            if (entry.fieldType == DCGM_FT_INT64)
+            {
+                entry.value.i64 = DCGM_INT64_BLANK;
+            }
+            else
+            {
+                entry.value.dbl = DCGM_FP64_BLANK;
+            }
+            m_entryIndex[EntryKey(entity.entityGroupId, entity.entityId, fieldId)] = index++;
+        }
+    }
+
+    __atomic_store_n(&m_header->magic, DCGM_LATEST_BOARD_MAGIC, __ATOMIC_RELEASE);
+    DCGM_LOG_INFO << "Publishing " << numEntries << " latest values to " << name;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmLatestValueBoard::WriteEntry(dcgmBufferedFv_t const &fv)
+{
+    auto it = m_entryIndex.find(EntryKey(fv.entityGroupId, fv.entityId, fv.fieldId));
+    if (it == m_entryIndex.end())
+    {
+        return;
+    }
+
+    dcgmLatestBoardEntry_t &entry = m_entries[it->second];
+
+    std::int64_t bits = fv.value.i64;
+    if (entry.fieldType == DCGM_FT_DOUBLE)
+    {
+        std::memcpy(&bits, &fv.value.dbl, sizeof(bits));
+    }
+
+    /* Readers retry while the sequence is odd or changed under them */
+    std::uint32_t sequence = entry.sequence;
+    __atomic_store_n(&entry.sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&entry.status, (std::int32_t)fv.status, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry.timestamp, (std::int64_t)fv.timestamp, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry.value.i64, bits, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry.sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+/*****************************************************************************/
+void DcgmLatestValueBoard::Publish(timelib64_t now)
+{
+    if (m_mapping == nullptr)
+    {
+        return;
+    }
+
+    if (!m_entryIndex.empty())
+    {
+        unsigned long long updateSequence = m_sequence;
+        m_fvBuffer.Clear();
+        dcgmReturn_t dcgmReturn
+            = m_source->GetLatest(m_entities, m_fieldIds, m_fvBuffer, m_sequence, updateSequence);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " reading the latest values to publish";
+        }
+        else
+        {
+            for (auto const &fv : m_fvBuffer)
+            {
+                WriteEntry(fv);
+            }
+            m_sequence = updateSequence;
+        }
+    }
+
+    __atomic_store_n(&m_header->publishUsec, (std::uint64_t)now, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&m_header->publishCount, 1, __ATOMIC_RELEASE);
+}
+
+/*****************************************************************************/
+void DcgmLatestValueBoard::run(void)
+{
+    while (!ShouldStop())
+    {
+        Publish(timelib_usecSince1970());
+        Sleep(m_updateFreqUsec);
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMLATESTVALUEBOARD_H
+#define DCGMLATESTVALUEBOARD_H
+
+#include "DcgmFvBuffer.h"
+#include "DcgmMetricsExporter.h"
+#include "DcgmThread.h"
+#include "dcgm_latest_board.h"
+#include "dcgm_structs.h"
+#include "timelib.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Publishes the latest value of some fields of every GPU to a read-only POSIX
+ * shared memory segment (see nv-hostengine --latest-board), so that local
+ * agents can read them with dcgm_latest_board.h instead of asking the host
+ * engine.
+ *
+ * The layout is fixed when the segment is created: a dcgmLatestBoardHeader_t
+ * and then one dcgmLatestBoardEntry_t per entity and field, sorted. Every
+ * update interval the thread asks the cache only for what changed since the
+ * previous interval and rewrites those entries under their sequence counters.
+ * The segment is unlinked when the board is destroyed.
+ */
+class DcgmLatestValueBoard : public DcgmThread
+{
+public:
+    static constexpr timelib64_t DEFAULT_UPDATE_FREQ_USEC = 1000000;
+
+    /*************************************************************************/
+    /*
+     * Constructor. Call Create() and then Start()
+     *
+     * fieldIds       IN: Fields to publish. Fields that aren't numeric are skipped
+     * source         IN: Where values come from. See DcgmMetricsExporter::CacheSource()
+     * updateFreqUsec IN: How often the fields are sampled and published
+     */
+    DcgmLatestValueBoard(std::vector<unsigned short> fieldIds,
+                         std::unique_ptr<DcgmMetricsSource> source,
+                         timelib64_t updateFreqUsec = DEFAULT_UPDATE_FREQ_USEC);
+
+    /* Stops the thread, marks the segment closed and unlinks it */
+    ~DcgmLatestValueBoard() override;
+
+    /*************************************************************************/
+    /*
+     * Find the entities, watch the fields and create the segment called name,
+     * like DCGM_LATEST_BOARD_DEFAULT_NAME. A segment left behind under that
+     * name is replaced. Only this process can write the segment
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_GENERIC_ERROR if the segment couldn't be created
+     */
+    dcgmReturn_t Create(std::string const &name);
+
+    /*************************************************************************/
+    /*
+     * Write the values that changed since the previous call. Public for tests,
+     * which call it instead of waiting for the thread
+     *
+     * now IN: Current time in usec since 1970
+     */
+    void Publish(timelib64_t now);
+
+    /* Entries the segment has. 0 before Create() */
+    size_t GetNumEntries() const
+    {
+        return m_entryIndex.size();
+    }
+
+    /* Inherited from DcgmThread */
+    void run(void) override;
+
+private:
+    std::vector<unsigned short> m_fieldIds;
+    std::unique_ptr<DcgmMetricsSource> m_source;
+    timelib64_t m_updateFreqUsec;
+
+    std::string m_name;
+    void *m_mapping = nullptr;
+    size_t m_size   = 0;
+    dcgmLatestBoardHeader_t *m_header = nullptr;
+    dcgmLatestBoardEntry_t *m_entries = nullptr;
+
+    /* Only used by the thread once it is started */
+    std::vector<dcgmGroupEntityPair_t> m_entities;
+    std::unordered_map<std::uint64_t, size_t> m_entryIndex; /* EntryKey() -> index into m_entries */
+    unsigned long long m_sequence = 0;                      /* Update sequence of the last Publish() */
+    DcgmFvBuffer m_fvBuffer;
+
+    static std::uint64_t EntryKey(unsigned int entityGroupId, unsigned int entityId, unsigned short fieldId)
+    {
+        return ((std::uint64_t)entityGroupId << 48) | ((std::uint64_t)fieldId << 32) | entityId;
+    }
+
+    /* Write fv into its entry, if it has one */
+    void WriteEntry(dcgmBufferedFv_t const &fv);
+};
+
+#endif // DCGMLATESTVALUEBOARD_H
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmMemoryAccounting.h"
+
+/*****************************************************************************/
+void DcgmMemoryCounter::Charge(long long bytes)
+{
+    long long bytesUsed    = m_bytesUsed.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    long long maxBytesUsed = m_maxBytesUsed.load(std::memory_order_relaxed);
+    while (bytesUsed > maxBytesUsed
+           && !m_maxBytesUsed.compare_exchange_weak(maxBytesUsed, bytesUsed, std::memory_order_relaxed))
+    {
+        /* maxBytesUsed was reloaded. Try again */
+    }
+}
+
+/*****************************************************************************/
+void DcgmMemoryCounter::Release(long long bytes)
+{
+    m_bytesUsed.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+dcgmIntrospectMemoryTag_t DcgmMemoryCounter::Get() const
+{
+    dcgmIntrospectMemoryTag_t usage {};
+    usage.bytesUsed    = m_bytesUsed.load(std::memory_order_relaxed);
+    usage.maxBytesUsed = m_maxBytesUsed.load(std::memory_order_relaxed);
+    return usage;
+}
+
+/*****************************************************************************/
+DcgmMemoryCharge::DcgmMemoryCharge(DcgmMemoryCounter *counter, long long bytes)
+    : m_counter(counter)
+    , m_bytes(0)
+{
+    Add(bytes);
+}
+
+/*****************************************************************************/
+DcgmMemoryCharge::~DcgmMemoryCharge()
+{
+    if (m_counter != nullptr)
+    {
+        m_counter->Release(m_bytes);
+    }
+}
+
+/*****************************************************************************/
+void DcgmMemoryCharge::Add(long long bytes)
+{
+    if (m_counter != nullptr)
+    {
+        m_counter->Charge(bytes);
+        m_bytes += bytes;
+    }
+}
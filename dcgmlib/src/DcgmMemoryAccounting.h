@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMMEMORYACCOUNTING_H
+#define DCGMMEMORYACCOUNTING_H
+
+#include "dcgm_structs.h"
+
+#include <atomic>
+
+/*
+ * Bytes held on behalf of one subsystem or module of the host engine, for
+ * memory that isn't measured anywhere else. Memory is charged when it is
+ * taken and released when it is given back, so Get() shows what is
+ * held right now. Can be charged from any thread.
+ */
+class DcgmMemoryCounter
+{
+public:
+    void Charge(long long bytes);
+    void Release(long long bytes);
+
+    /* Bytes held right now and the most held at once */
+    dcgmIntrospectMemoryTag_t Get() const;
+
+private:
+    std::atomic<long long> m_bytesUsed    = 0;
+    std::atomic<long long> m_maxBytesUsed = 0;
+};
+
+/*
+ * Charges bytes to a DcgmMemoryCounter for as long as it lives. A null
+ * counter charges nothing, for requests that can't be attributed
+ */
+class DcgmMemoryCharge
+{
+public:
+    DcgmMemoryCharge(DcgmMemoryCounter *counter, long long bytes);
+    ~DcgmMemoryCharge();
+
+    DcgmMemoryCharge(DcgmMemoryCharge const &) = delete;
+    DcgmMemoryCharge &operator=(DcgmMemoryCharge const &) = delete;
+
+    /* Charge more for memory taken since the charge was made */
+    void Add(long long bytes);
+
+private:
+    DcgmMemoryCounter *m_counter;
+    long long m_bytes;
+};
+
+#endif // DCGMMEMORYACCOUNTING_H
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmMetricsExporter.h"
+#include "DcgmCacheManager.h"
+#include "DcgmLogging.h"
+#include "DcgmNumberFormat.h"
+#include "DcgmWatcher.h"
+#include "dcgm_fields.h"
+
+#include <cstring>
+#include <sstream>
+#include <string_view>
+
+namespace
+{
+/* Reads the latest values of the cache manager */
+class DcgmMetricsCacheSource : public DcgmMetricsSource
+{
+public:
+    DcgmMetricsCacheSource(DcgmCacheManager *cacheManager, DcgmWatcherType_t watcherType)
+        : m_cacheManager(cacheManager)
+        , m_watcherType(watcherType)
+    {}
+
+    dcgmReturn_t GetEntities(std::vector<dcgmGroupEntityPair_t> &entities) override
+    {
+        std::vector<unsigned int> gpuIds;
+        dcgmReturn_t dcgmReturn = m_cacheManager->GetGpuIds(1, gpuIds);
+        for (unsigned int gpuId : gpuIds)
+        {
+            entities.push_back({ DCGM_FE_GPU, gpuId });
+        }
+        return dcgmReturn;
+    }
+
+    dcgmReturn_t Watch(std::vector<dcgmGroupEntityPair_t> const &entities,
+                       std::vector<unsigned short> const &fieldIds,
+                       timelib64_t updateFreqUsec) override
+    {
+        DcgmWatcher watcher(m_watcherType);
+        dcgmReturn_t retSt = DCGM_ST_OK;
+
+        for (auto const &entity : entities)
+        {
+            for (unsigned short fieldId : fieldIds)
+            {
+                /* Only the latest value is ever read */
+                dcgmReturn_t dcgmReturn = m_cacheManager->AddFieldWatch(
+                    entity.entityGroupId, entity.entityId, fieldId, updateFreqUsec, 0.0, 1, watcher, false);
+                if (dcgmReturn != DCGM_ST_OK)
+                {
+                    DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " watching fieldId " << fieldId
+                                   << " of entity " << entity.entityGroupId << ":" << entity.entityId;
+                    retSt = dcgmReturn;
+                }
+            }
+        }
+
+        return retSt;
+    }
+
+    dcgmReturn_t GetLatest(std::vector<dcgmGroupEntityPair_t> &entities,
+                           std::vector<unsigned short> &fieldIds,
+                           DcgmFvBuffer &fvBuffer,
+                           unsigned long long sinceSequence,
+                           unsigned long long &updateSequence) override
+    {
+        return m_cacheManager->GetMultipleLatestSamples(
+            entities, fieldIds, &fvBuffer, sinceSequence, &updateSequence);
+    }
+
+private:
+    DcgmCacheManager *m_cacheManager;
+    DcgmWatcherType_t m_watcherType;
+};
+} // namespace
+
+/*****************************************************************************/
+DcgmMetricsExporter::DcgmMetricsExporter(std::vector<unsigned short> fieldIds,
+                                         std::unique_ptr<DcgmMetricsSource> source,
+                                         timelib64_t updateFreqUsec)
+    : DcgmThread(false, "dcgm_metrics")
+    , m_source(std::move(source))
+    , m_updateFreqUsec(updateFreqUsec)
+    , m_server([this](std::string_view method, std::string_view target) -> std::string const & {
+        return OnRequest(method, target);
+    })
+    , m_notFound(DcgmHttpServer::StatusResponse("404 Not Found"))
+    , m_notAllowed(DcgmHttpServer::StatusResponse("405 Method Not Allowed"))
+{
+    for (unsigned short fieldId : fieldIds)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        if (fieldMeta == nullptr)
+        {
+            DCGM_LOG_ERROR << "Not exporting unknown fieldId " << fieldId;
+            continue;
+        }
+        if (fieldMeta->fieldType != DCGM_FT_INT64 && fieldMeta->fieldType != DCGM_FT_DOUBLE)
+        {
+            DCGM_LOG_WARNING << "Not exporting fieldId " << fieldId << ". Only numeric fields can be exported";
+            continue;
+        }
+        m_fieldIds.push_back(fieldId);
+    }
+}
+
+/*****************************************************************************/
+DcgmMetricsExporter::~DcgmMetricsExporter()
+{
+    StopAndWait(60000);
+}
+
+/*****************************************************************************/
+std::unique_ptr<DcgmMetricsSource> DcgmMetricsExporter::CacheSource(DcgmCacheManager *cacheManager,
+                                                                    DcgmWatcherType_t watcherType)
+{
+    return std::make_unique<DcgmMetricsCacheSource>(cacheManager, watcherType);
+}
+
+/*****************************************************************************/
+char const *DcgmMetricsExporter::EntityLabel(dcgm_field_entity_group_t entityGroupId)
+{
+    switch (entityGroupId)
+    {
+        case DCGM_FE_GPU:
+            return "gpu";
+        case DCGM_FE_VGPU:
+            return "vgpu";
+        case DCGM_FE_SWITCH:
+            return "nvswitch";
+        case DCGM_FE_GPU_I:
+            return "gpu_instance";
+        case DCGM_FE_GPU_CI:
+            return "compute_instance";
+        default:
+            return "entity";
+    }
+}
+
+/*****************************************************************************/
+std::string DcgmMetricsExporter::MetricName(dcgm_field_meta_p fieldMeta)
+{
+    std::string name = "dcgm_";
+    for (char const *c = fieldMeta->tag; *c != '\0'; c++)
+    {
+        bool const allowed = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9');
+        name += allowed ? *c : '_';
+    }
+    return name;
+}
+
+/*****************************************************************************/
+std::vector<unsigned short> DcgmMetricsExporter::ParseFieldIds(std::string const &fieldIds)
+{
+    std::vector<unsigned short> parsed;
+    std::stringstream ss(fieldIds);
+    std::string token;
+
+    while (std::getline(ss, token, ','))
+    {
+        token.erase(0, token.find_first_not_of(" \t"));
+        token.erase(token.find_last_not_of(" \t") + 1);
+        if (token.empty())
+        {
+            continue;
+        }
+
+        long long fieldId = 0;
+        if (!DcgmNs::ParseInt64(token, fieldId) || fieldId <= 0 || fieldId >= DCGM_FI_MAX_FIELDS)
+        {
+            DCGM_LOG_ERROR << "Ignoring invalid fieldId \"" << token << "\"";
+            continue;
+        }
+        parsed.push_back((unsigned short)fieldId);
+    }
+
+    if (parsed.empty())
+    {
+        return DefaultFieldIds();
+    }
+    return parsed;
+}
+
+/*****************************************************************************/
+std::vector<unsigned short> DcgmMetricsExporter::DefaultFieldIds()
+{
+    return { DCGM_FI_DEV_SM_CLOCK,
+             DCGM_FI_DEV_MEM_CLOCK,
+             DCGM_FI_DEV_GPU_TEMP,
+             DCGM_FI_DEV_POWER_USAGE,
+             DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION,
+             DCGM_FI_DEV_GPU_UTIL,
+             DCGM_FI_DEV_MEM_COPY_UTIL,
+             DCGM_FI_DEV_FB_FREE,
+             DCGM_FI_DEV_FB_USED };
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmMetricsExporter::Listen(std::string const &address)
+{
+    dcgmReturn_t dcgmReturn = m_server.Listen(address);
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        DCGM_LOG_INFO << "Serving " << m_fieldIds.size() << " fields as OpenMetrics on port " << GetPort();
+    }
+    return dcgmReturn;
+}
+
+/*****************************************************************************/
+void DcgmMetricsExporter::Initialize()
+{
+    m_initialized = true;
+
+    dcgmReturn_t dcgmReturn = m_source->GetEntities(m_entities);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " finding the entities to export";
+    }
+    if (!m_entities.empty() && !m_fieldIds.empty())
+    {
+        /* Logged by the source. Fields that are watched are still exported */
+        m_source->Watch(m_entities, m_fieldIds, m_updateFreqUsec);
+    }
+
+    for (unsigned short fieldId : m_fieldIds)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        std::string const name      = MetricName(fieldMeta);
+
+        Family family;
+        family.header = "# TYPE " + name + " gauge\n# HELP " + name + " DCGM field " + std::to_string(fieldId)
+                        + " (" + fieldMeta->tag + ")\n";
+        family.firstSeries = m_series.size();
+        family.numSeries   = m_entities.size();
+        m_families.push_back(std::move(family));
+
+        for (auto const &entity : m_entities)
+        {
+            Series series;
+            series.prefix = name + "{" + EntityLabel(entity.entityGroupId) + "=\"" + std::to_string(entity.entityId)
+                            + "\"} ";
+            m_seriesIndex[SeriesKey(entity.entityGroupId, entity.entityId, fieldId)] = m_series.size();
+            m_series.push_back(std::move(series));
+        }
+    }
+}
+
+/*****************************************************************************/
+bool DcgmMetricsExporter::UpdateSeries(dcgmBufferedFv_t const &fv)
+{
+    auto it = m_seriesIndex.find(SeriesKey(fv.entityGroupId, fv.entityId, fv.fieldId));
+    if (it == m_seriesIndex.end())
+    {
+        return false;
+    }
+
+    char buffer[DcgmNs::MaxFormattedNumberLength];
+    char *end = buffer;
+
+    if (fv.status == DCGM_ST_OK)
+    {
+        if (fv.fieldType == DCGM_FT_INT64 && !DCGM_INT64_IS_BLANK(fv.value.i64))
+        {
+            end = DcgmNs::FormatInt64(buffer, buffer + sizeof(buffer), fv.value.i64);
+        }
+        else if (fv.fieldType == DCGM_FT_DOUBLE && !DCGM_FP64_IS_BLANK(fv.value.dbl))
+        {
+            end = DcgmNs::FormatDouble(buffer, buffer + sizeof(buffer), fv.value.dbl);
+        }
+    }
+
+    std::string &value = m_series[it->second].value;
+    size_t const size  = end == nullptr ? 0 : end - buffer;
+    if (value.size() == size && memcmp(value.data(), buffer, size) == 0)
+    {
+        return false;
+    }
+    value.assign(buffer, size);
+    return true;
+}
+
+/*****************************************************************************/
+void DcgmMetricsExporter::Render()
+{
+    m_renderCount++;
+
+    m_body.clear();
+    for (auto const &family : m_families)
+    {
+        m_body += family.header;
+        for (size_t i = family.firstSeries; i < family.firstSeries + family.numSeries; i++)
+        {
+            Series const &series = m_series[i];
+            if (!series.value.empty())
+            {
+                m_body += series.prefix;
+                m_body += series.value;
+                m_body += '\n';
+            }
+        }
+    }
+    m_body += "# EOF\n";
+
+    DcgmHttpServer::BuildResponse(
+        m_response, "200 OK", "application/openmetrics-text; version=1.0.0; charset=utf-8", m_body);
+}
+
+/*****************************************************************************/
+std::string const &DcgmMetricsExporter::Scrape()
+{
+    if (!m_initialized)
+    {
+        Initialize();
+    }
+
+    bool changed = m_response.empty();
+
+    if (!m_series.empty())
+    {
+        unsigned long long updateSequence = m_sequence;
+        m_fvBuffer.Clear();
+        dcgmReturn_t dcgmReturn
+            = m_source->GetLatest(m_entities, m_fieldIds, m_fvBuffer, m_sequence, updateSequence);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " reading the latest values to export";
+        }
+        else
+        {
+            for (auto const &fv : m_fvBuffer)
+            {
+                changed |= UpdateSeries(fv);
+            }
+            m_sequence = updateSequence;
+        }
+    }
+
+    if (changed)
+    {
+        Render();
+    }
+    return m_response;
+}
+
+/*****************************************************************************/
+std::string const &DcgmMetricsExporter::OnRequest(std::string_view method, std::string_view target)
+{
+    if (method != "GET")
+    {
+        return m_notAllowed;
+    }
+    if (target != "/metrics" && target.rfind("/metrics?", 0) != 0)
+    {
+        return m_notFound;
+    }
+    return Scrape();
+}
+
+/*****************************************************************************/
+void DcgmMetricsExporter::run(void)
+{
+    while (!ShouldStop())
+    {
+        /* Wake up now and then to notice Stop() */
+        m_server.Poll(100);
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMMETRICSEXPORTER_H
+#define DCGMMETRICSEXPORTER_H
+
+#include "DcgmFvBuffer.h"
+#include "DcgmHttpServer.h"
+#include "DcgmThread.h"
+#include "dcgm_fields.h"
+#include "dcgm_structs.h"
+#include "dcgm_structs_internal.h"
+#include "timelib.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class DcgmCacheManager;
+
+/*
+ * Where the exporter gets its values. The default reads the latest values of
+ * the cache manager. Tests provide their own
+ */
+class DcgmMetricsSource
+{
+public:
+    virtual ~DcgmMetricsSource() = default;
+
+    /* Entities to export every field for */
+    virtual dcgmReturn_t GetEntities(std::vector<dcgmGroupEntityPair_t> &entities) = 0;
+
+    /* Have every field of fieldIds sampled for every entity of entities */
+    virtual dcgmReturn_t Watch(std::vector<dcgmGroupEntityPair_t> const &entities,
+                               std::vector<unsigned short> const &fieldIds,
+                               timelib64_t updateFreqUsec)
+        = 0;
+
+    /*
+     * Latest value of each entity and field that changed after sinceSequence. See
+     * DcgmCacheManager::GetMultipleLatestSamples()
+     */
+    virtual dcgmReturn_t GetLatest(std::vector<dcgmGroupEntityPair_t> &entities,
+                                   std::vector<unsigned short> &fieldIds,
+                                   DcgmFvBuffer &fvBuffer,
+                                   unsigned long long sinceSequence,
+                                   unsigned long long &updateSequence)
+        = 0;
+};
+
+/*
+ * OpenMetrics (Prometheus) endpoint of the host engine (see nv-hostengine --metrics-listen).
+ *
+ * Serves GET /metrics over HTTP/1.1 with the latest value of each configured
+ * field of each GPU as a gauge called dcgm_<field tag>, labeled with its gpu.
+ * Blank values and values that failed to be read are left out.
+ *
+ * Everything about a series but its value is rendered once when the series are
+ * first set up. A scrape asks the cache only for what changed since the previous
+ * scrape, re-renders the value of those series and reassembles the response in
+ * the same buffer. A scrape that finds nothing changed sends the previous
+ * response as is.
+ */
+class DcgmMetricsExporter : public DcgmThread
+{
+public:
+    static constexpr timelib64_t DEFAULT_UPDATE_FREQ_USEC = 1000000;
+
+    /*************************************************************************/
+    /*
+     * Constructor. Call Listen() and then Start()
+     *
+     * fieldIds       IN: Fields to export. Fields that aren't numeric are skipped
+     * source         IN: Where values come from. See CacheSource()
+     * updateFreqUsec IN: How often the fields are sampled
+     */
+    DcgmMetricsExporter(std::vector<unsigned short> fieldIds,
+                        std::unique_ptr<DcgmMetricsSource> source,
+                        timelib64_t updateFreqUsec = DEFAULT_UPDATE_FREQ_USEC);
+
+    /* Stops the thread. The sockets are closed with m_server */
+    ~DcgmMetricsExporter() override;
+
+    /* The source that reads from cacheManager, watching as watcherType */
+    static std::unique_ptr<DcgmMetricsSource> CacheSource(
+        DcgmCacheManager *cacheManager,
+        DcgmWatcherType_t watcherType = DcgmWatcherTypeMetricsExporter);
+
+    /* Split a DCGM_ENV_METRICS_FIELDS style list of field IDs. Returns DefaultFieldIds() for an empty list */
+    static std::vector<unsigned short> ParseFieldIds(std::string const &fieldIds);
+
+    /* Fields exported when none are configured: clocks, temperature, power, energy, utilization and FB usage */
+    static std::vector<unsigned short> DefaultFieldIds();
+
+    /* dcgm_<tag> with anything OpenMetrics doesn't allow in a name replaced by '_' */
+    static std::string MetricName(dcgm_field_meta_p fieldMeta);
+
+    /* Label of the entity in each series, like "gpu" */
+    static char const *EntityLabel(dcgm_field_entity_group_t entityGroupId);
+
+    /* Bind the listening socket. See DcgmHttpServer::Listen() */
+    dcgmReturn_t Listen(std::string const &address);
+
+    /* Port Listen() bound. 0 before Listen() */
+    std::uint16_t GetPort() const
+    {
+        return m_server.GetPort();
+    }
+
+    /*************************************************************************/
+    /*
+     * Bring the response up to date with the cache. Public for tests, which call it
+     * instead of scraping over HTTP
+     *
+     * Returns: The full HTTP response. Valid until the next call
+     */
+    std::string const &Scrape();
+
+    /* How many times the response was rendered. For tests */
+    unsigned int GetRenderCount() const
+    {
+        return m_renderCount;
+    }
+
+    /* Inherited from DcgmThread */
+    void run(void) override;
+
+private:
+    /* One entity and field */
+    struct Series
+    {
+        std::string prefix; /* "dcgm_gpu_temp{gpu=\"0\"} " */
+        std::string value;  /* Rendered value. "" = left out */
+    };
+
+    /* Series of one field, all next to each other in the response as OpenMetrics requires */
+    struct Family
+    {
+        std::string header; /* "# TYPE ..." and "# HELP ..." lines */
+        size_t firstSeries; /* Index into m_series */
+        size_t numSeries;
+    };
+
+    std::vector<unsigned short> m_fieldIds;
+    std::unique_ptr<DcgmMetricsSource> m_source;
+    timelib64_t m_updateFreqUsec;
+
+    /* Only used by the thread once it is started */
+    bool m_initialized = false;
+    std::vector<dcgmGroupEntityPair_t> m_entities;
+    std::vector<Family> m_families;
+    std::vector<Series> m_series;
+    std::unordered_map<std::uint64_t, size_t> m_seriesIndex; /* SeriesKey() -> index into m_series */
+    unsigned long long m_sequence = 0;                       /* Update sequence of the last scrape */
+    DcgmFvBuffer m_fvBuffer;
+    std::string m_body;
+    std::string m_response;
+    unsigned int m_renderCount = 0;
+
+    DcgmHttpServer m_server;
+    std::string m_notFound;
+    std::string m_notAllowed;
+
+    static std::uint64_t SeriesKey(unsigned int entityGroupId, unsigned int entityId, unsigned short fieldId)
+    {
+        return ((std::uint64_t)entityGroupId << 48) | ((std::uint64_t)fieldId << 32) | entityId;
+    }
+
+    /* Find the entities, watch the fields and set up m_families and m_series */
+    void Initialize();
+
+    /* Render fv into the value of its series. Returns whether the value changed */
+    bool UpdateSeries(dcgmBufferedFv_t const &fv);
+
+    /* Reassemble m_response from m_families and m_series */
+    void Render();
+
+    /* DcgmHttpServer::Handler */
+    std::string const &OnRequest(std::string_view method, std::string_view target);
+};
+
+#endif // DCGMMETRICSEXPORTER_H
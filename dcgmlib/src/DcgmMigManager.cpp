@@ -140,3 +140,17 @@ void DcgmMigManager::Clear()
     m_instanceIdToGpuId.clear();
     m_ciIdToMigInfo.clear();
 }
+
+/*************************************************************************/
+void DcgmMigManager::ClearGpu(unsigned int gpuId)
+{
+    for (auto it = m_instanceIdToGpuId.begin(); it != m_instanceIdToGpuId.end();)
+    {
+        it = (it->second == gpuId) ? m_instanceIdToGpuId.erase(it) : std::next(it);
+    }
+
+    for (auto it = m_ciIdToMigInfo.begin(); it != m_ciIdToMigInfo.end();)
+    {
+        it = (it->second.gpuId == gpuId) ? m_ciIdToMigInfo.erase(it) : std::next(it);
+    }
+}
@@ -72,6 +72,10 @@ public:
     /*************************************************************************/
     void Clear();
 
+    /*************************************************************************/
+    /* Forget the GPU instances and compute instances recorded for gpuId */
+    void ClearGpu(unsigned int gpuId);
+
 private:
     std::unordered_map<DcgmNs::Mig::GpuInstanceId, unsigned int> m_instanceIdToGpuId;
     std::unordered_map<DcgmNs::Mig::ComputeInstanceId, dcgmMigInfo_t> m_ciIdToMigInfo;
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmOtlpExporter.h"
+#include "DcgmCacheManager.h"
+#include "DcgmLogging.h"
+#include "DcgmMetricsExporter.h"
+#include "DcgmWatcher.h"
+#include "dcgm_fields.h"
+
+#include <cstring>
+#include <string_view>
+#include <unistd.h>
+
+/*
+ * Protobuf encoding of the parts of opentelemetry/proto/collector/metrics/v1
+ * that are sent. Field numbers are from the .proto files:
+ *
+ * ExportMetricsServiceRequest { repeated ResourceMetrics resource_metrics = 1; }
+ * ResourceMetrics             { Resource resource = 1; repeated ScopeMetrics scope_metrics = 2; }
+ * Resource                    { repeated KeyValue attributes = 1; }
+ * ScopeMetrics                { InstrumentationScope scope = 1; repeated Metric metrics = 2; }
+ * InstrumentationScope        { string name = 1; }
+ * Metric                      { string name = 1; string description = 2; Gauge gauge = 5; }
+ * Gauge                       { repeated NumberDataPoint data_points = 1; }
+ * NumberDataPoint             { repeated KeyValue attributes = 7; fixed64 time_unix_nano = 3;
+ *                               double as_double = 4; sfixed64 as_int = 6; }
+ * KeyValue                    { string key = 1; AnyValue value = 2; }
+ * AnyValue                    { string string_value = 1; int64 int_value = 3; }
+ */
+namespace
+{
+enum WireType
+{
+    WireTypeVarint          = 0,
+    WireTypeFixed64         = 1,
+    WireTypeLengthDelimited = 2,
+};
+
+void AppendVarint(std::string &out, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += (char)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += (char)value;
+}
+
+void AppendTag(std::string &out, unsigned int fieldNumber, WireType wireType)
+{
+    AppendVarint(out, (fieldNumber << 3) | wireType);
+}
+
+void AppendBytes(std::string &out, unsigned int fieldNumber, std::string_view bytes)
+{
+    AppendTag(out, fieldNumber, WireTypeLengthDelimited);
+    AppendVarint(out, bytes.size());
+    out += bytes;
+}
+
+void AppendFixed64(std::string &out, unsigned int fieldNumber, std::uint64_t value)
+{
+    AppendTag(out, fieldNumber, WireTypeFixed64);
+    for (int i = 0; i < 8; i++)
+    {
+        out += (char)(value >> (8 * i));
+    }
+}
+
+/* KeyValue with a string value as field fieldNumber of its parent */
+void AppendStringAttribute(std::string &out, unsigned int fieldNumber, std::string_view key, std::string_view value)
+{
+    std::string anyValue;
+    AppendBytes(anyValue, 1, value);
+
+    std::string keyValue;
+    AppendBytes(keyValue, 1, key);
+    AppendBytes(keyValue, 2, anyValue);
+
+    AppendBytes(out, fieldNumber, keyValue);
+}
+
+/* KeyValue with an int value as field fieldNumber of its parent */
+void AppendIntAttribute(std::string &out, unsigned int fieldNumber, std::string_view key, std::int64_t value)
+{
+    std::string anyValue;
+    AppendTag(anyValue, 3, WireTypeVarint);
+    AppendVarint(anyValue, (std::uint64_t)value);
+
+    std::string keyValue;
+    AppendBytes(keyValue, 1, key);
+    AppendBytes(keyValue, 2, anyValue);
+
+    AppendBytes(out, fieldNumber, keyValue);
+}
+
+std::string HostName()
+{
+    char hostName[256] = {};
+    if (gethostname(hostName, sizeof(hostName) - 1) != 0)
+    {
+        return "";
+    }
+    return hostName;
+}
+} // namespace
+
+/*****************************************************************************/
+DcgmOtlpExporter::DcgmOtlpExporter(std::vector<unsigned short> fieldIds,
+                                   timelib64_t updateFreqUsec,
+                                   timelib64_t intervalUsec,
+                                   size_t maxBufferedBytes)
+    : DcgmThread(false, "dcgm_otlp")
+    , m_updateFreqUsec(updateFreqUsec)
+    , m_intervalUsec(intervalUsec)
+    , m_maxBufferedBytes(maxBufferedBytes)
+    , m_sender([this](std::string const &request) {
+        return m_client.Post("application/x-protobuf", request, SEND_TIMEOUT_MS);
+    })
+{
+    for (unsigned short fieldId : fieldIds)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        if (fieldMeta == nullptr)
+        {
+            DCGM_LOG_ERROR << "Not pushing unknown fieldId " << fieldId;
+            continue;
+        }
+        if (fieldMeta->fieldType != DCGM_FT_INT64 && fieldMeta->fieldType != DCGM_FT_DOUBLE)
+        {
+            DCGM_LOG_WARNING << "Not pushing fieldId " << fieldId << ". Only numeric fields can be pushed";
+            continue;
+        }
+        if (m_metrics.count(fieldId) != 0)
+        {
+            continue;
+        }
+
+        Metric &metric = m_metrics[fieldId];
+        AppendBytes(metric.header, 1, DcgmMetricsExporter::MetricName(fieldMeta));
+        AppendBytes(
+            metric.header, 2, "DCGM field " + std::to_string(fieldId) + " (" + std::string(fieldMeta->tag) + ")");
+        m_fieldIds.push_back(fieldId);
+    }
+
+    std::string resource;
+    AppendStringAttribute(resource, 1, "service.name", "nv-hostengine");
+    AppendStringAttribute(resource, 1, "host.name", HostName());
+    AppendBytes(m_resource, 1, resource);
+
+    std::string scope;
+    AppendBytes(scope, 1, "dcgm");
+    AppendBytes(m_scope, 1, scope);
+}
+
+/*****************************************************************************/
+DcgmOtlpExporter::~DcgmOtlpExporter()
+{
+    StopAndWait(60000);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmOtlpExporter::SetEndpoint(std::string const &url)
+{
+    dcgmReturn_t dcgmReturn = m_client.SetUrl(url);
+    if (dcgmReturn == DCGM_ST_OK)
+    {
+        DCGM_LOG_INFO << "Pushing " << m_fieldIds.size() << " fields as OTLP metrics to " << url;
+    }
+    return dcgmReturn;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmOtlpExporter::Watch(DcgmCacheManager *cacheManager)
+{
+    std::vector<unsigned int> gpuIds;
+    dcgmReturn_t retSt = cacheManager->GetGpuIds(1, gpuIds);
+    if (retSt != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(retSt) << " finding the GPUs to push";
+        return retSt;
+    }
+
+    DcgmWatcher watcher(DcgmWatcherTypeOtlpExporter);
+    for (unsigned int gpuId : gpuIds)
+    {
+        for (unsigned short fieldId : m_fieldIds)
+        {
+            /* Samples reach OnFvUpdates() as they are taken, so the cache only needs the latest */
+            dcgmReturn_t dcgmReturn
+                = cacheManager->AddFieldWatch(DCGM_FE_GPU, gpuId, fieldId, m_updateFreqUsec, 0.0, 1, watcher, true);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " watching fieldId " << fieldId << " of GPU "
+                               << gpuId;
+                retSt = dcgmReturn;
+            }
+        }
+    }
+
+    return retSt;
+}
+
+/*****************************************************************************/
+void DcgmOtlpExporter::OnFvUpdates(std::shared_ptr<DcgmFvBuffer const> const &fvBuffer)
+{
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+
+    /* Only if the thread is stuck. Better to lose the oldest samples than to grow without a bound */
+    if (m_pending.size() >= MAX_PENDING_SNAPSHOTS)
+    {
+        m_pending.erase(m_pending.begin());
+    }
+    m_pending.push_back(fvBuffer);
+}
+
+/*****************************************************************************/
+void DcgmOtlpExporter::AddPoint(dcgmBufferedFv_t const &fv)
+{
+    auto metricIt = m_metrics.find(fv.fieldId);
+    if (metricIt == m_metrics.end() || fv.status != DCGM_ST_OK)
+    {
+        return;
+    }
+
+    bool const isInt = fv.fieldType == DCGM_FT_INT64;
+    if ((isInt && DCGM_INT64_IS_BLANK(fv.value.i64)) || (!isInt && DCGM_FP64_IS_BLANK(fv.value.dbl)))
+    {
+        return;
+    }
+
+    std::string &attributes = m_attributes[EntityKey(fv.entityGroupId, fv.entityId)];
+    if (attributes.empty())
+    {
+        AppendIntAttribute(attributes,
+                           7,
+                           DcgmMetricsExporter::EntityLabel((dcgm_field_entity_group_t)fv.entityGroupId),
+                           fv.entityId);
+    }
+
+    std::string point = attributes;
+    AppendFixed64(point, 3, (std::uint64_t)fv.timestamp * 1000);
+    if (isInt)
+    {
+        AppendFixed64(point, 6, (std::uint64_t)fv.value.i64);
+    }
+    else
+    {
+        std::uint64_t bits;
+        memcpy(&bits, &fv.value.dbl, sizeof(bits));
+        AppendFixed64(point, 4, bits);
+    }
+
+    AppendBytes(metricIt->second.points, 1, point);
+}
+
+/*****************************************************************************/
+void DcgmOtlpExporter::BuildRequest()
+{
+    std::string scopeMetrics = m_scope;
+    for (unsigned short fieldId : m_fieldIds)
+    {
+        Metric &metric = m_metrics[fieldId];
+        if (metric.points.empty())
+        {
+            continue;
+        }
+
+        std::string encoded = metric.header;
+        AppendBytes(encoded, 5, metric.points);
+        AppendBytes(scopeMetrics, 2, encoded);
+        metric.points.clear();
+    }
+
+    if (scopeMetrics.size() == m_scope.size())
+    {
+        /* No samples */
+        return;
+    }
+
+    std::string resourceMetrics = m_resource;
+    AppendBytes(resourceMetrics, 2, scopeMetrics);
+
+    std::string request;
+    AppendBytes(request, 1, resourceMetrics);
+
+    m_requestBytes += request.size();
+    m_requests.push_back(std::move(request));
+
+    /* Keep the newest requests. The one just built always stays */
+    unsigned int dropped = 0;
+    while (m_requestBytes > m_maxBufferedBytes && m_requests.size() > 1)
+    {
+        m_requestBytes -= m_requests.front().size();
+        m_requests.pop_front();
+        dropped++;
+    }
+    if (dropped > 0)
+    {
+        m_droppedRequests += dropped;
+        DCGM_LOG_WARNING << "Dropped the " << dropped << " oldest undelivered OTLP requests. Keeping at most "
+                         << m_maxBufferedBytes << " bytes";
+    }
+}
+
+/*****************************************************************************/
+void DcgmOtlpExporter::Send(timelib64_t now)
+{
+    while (!m_requests.empty() && now >= m_nextAttemptUsec)
+    {
+        int const status = m_sender(m_requests.front());
+
+        /* Per the OTLP spec, 408, 429 and 5xx are worth retrying. Other errors won't get any better */
+        bool const delivered = status >= 200 && status < 300;
+        bool const retryable = status == 0 || status == 408 || status == 429 || status >= 500;
+        if (!delivered && retryable)
+        {
+            m_retryDelayUsec  = m_retryDelayUsec == 0 ? m_intervalUsec
+                                                      : std::min(2 * m_retryDelayUsec, MAX_RETRY_DELAY_USEC);
+            m_nextAttemptUsec = now + m_retryDelayUsec;
+            DCGM_LOG_WARNING << "Unable to push OTLP metrics (HTTP status " << status << "). Retrying in "
+                             << m_retryDelayUsec / 1000000 << " s with " << m_requests.size() << " requests kept";
+            return;
+        }
+
+        if (!delivered)
+        {
+            DCGM_LOG_ERROR << "The collector rejected OTLP metrics with HTTP status " << status << ". Dropping them";
+            m_droppedRequests++;
+        }
+
+        m_requestBytes -= m_requests.front().size();
+        m_requests.pop_front();
+        m_retryDelayUsec = 0;
+    }
+}
+
+/*****************************************************************************/
+void DcgmOtlpExporter::Export(timelib64_t now)
+{
+    std::vector<std::shared_ptr<DcgmFvBuffer const>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        pending.swap(m_pending);
+    }
+
+    for (auto const &fvBuffer : pending)
+    {
+        for (auto const &fv : *fvBuffer)
+        {
+            AddPoint(fv);
+        }
+    }
+
+    BuildRequest();
+    Send(now);
+}
+
+/*****************************************************************************/
+void DcgmOtlpExporter::run(void)
+{
+    while (!ShouldStop())
+    {
+        Sleep(m_intervalUsec);
+        /* Also once more after Stop() so that the last samples go out */
+        Export(timelib_usecSince1970());
+    }
+}
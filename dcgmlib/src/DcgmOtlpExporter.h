@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMOTLPEXPORTER_H
+#define DCGMOTLPEXPORTER_H
+
+#include "DcgmFvBuffer.h"
+#include "DcgmHttpClient.h"
+#include "DcgmThread.h"
+#include "dcgm_structs.h"
+#include "timelib.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DcgmCacheManager;
+
+/*
+ * Pushes field values to an OpenTelemetry collector as OTLP/HTTP protobuf
+ * metrics (see nv-hostengine --otlp-endpoint).
+ *
+ * The fields are watched subscribed for updates under DcgmWatcherTypeOtlpExporter,
+ * so every sample the cache manager takes reaches OnFvUpdates() as it is taken.
+ * The snapshots are only queued there. Every interval the thread encodes the
+ * samples of all of them into one ExportMetricsServiceRequest with a gauge per
+ * field and a data point per sample, labeled like the OpenMetrics endpoint.
+ *
+ * Requests that couldn't be delivered are kept and retried, oldest first, with
+ * a delay that doubles up to MAX_RETRY_DELAY_USEC. The kept requests are capped
+ * at maxBufferedBytes by dropping the oldest. A request the collector rejects as
+ * malformed is dropped rather than retried.
+ */
+class DcgmOtlpExporter : public DcgmThread
+{
+public:
+    static constexpr timelib64_t DEFAULT_UPDATE_FREQ_USEC = 1000000;
+    static constexpr timelib64_t DEFAULT_INTERVAL_USEC    = 10000000;
+    static constexpr size_t DEFAULT_MAX_BUFFERED_BYTES    = 16 * 1024 * 1024;
+    static constexpr timelib64_t MAX_RETRY_DELAY_USEC     = 300000000;
+    static constexpr size_t MAX_PENDING_SNAPSHOTS         = 4096;
+    static constexpr int SEND_TIMEOUT_MS                  = 5000;
+
+    /* Deliver an encoded request. Returns its HTTP status or 0 if there was no response */
+    using Sender = std::function<int(std::string const &request)>;
+
+    /*************************************************************************/
+    /*
+     * Constructor. Call SetEndpoint() and Watch(), and then Start()
+     *
+     * fieldIds         IN: Fields to push. Fields that aren't numeric are skipped
+     * updateFreqUsec   IN: How often the fields are sampled
+     * intervalUsec     IN: How often samples are pushed
+     * maxBufferedBytes IN: Most bytes of requests kept for retries
+     */
+    DcgmOtlpExporter(std::vector<unsigned short> fieldIds,
+                     timelib64_t updateFreqUsec = DEFAULT_UPDATE_FREQ_USEC,
+                     timelib64_t intervalUsec   = DEFAULT_INTERVAL_USEC,
+                     size_t maxBufferedBytes    = DEFAULT_MAX_BUFFERED_BYTES);
+
+    /* Stops the thread after a last push */
+    ~DcgmOtlpExporter() override;
+
+    /* POST requests to url, like http://localhost:4318/v1/metrics. See DcgmHttpClient::SetUrl() */
+    dcgmReturn_t SetEndpoint(std::string const &url);
+
+    /* Deliver requests with sender instead of over HTTP. For tests */
+    void SetSender(Sender sender)
+    {
+        m_sender = std::move(sender);
+    }
+
+    /* Watch the fields of every GPU, subscribed for updates */
+    dcgmReturn_t Watch(DcgmCacheManager *cacheManager);
+
+    /*************************************************************************/
+    /*
+     * Queue a snapshot of values the cache manager published for
+     * DcgmWatcherTypeOtlpExporter. Called from the cache manager's update thread
+     */
+    void OnFvUpdates(std::shared_ptr<DcgmFvBuffer const> const &fvBuffer);
+
+    /*************************************************************************/
+    /*
+     * Encode the queued samples into a request and send what is due. Public for
+     * tests, which call it instead of waiting for the thread
+     *
+     * now IN: Current time in usec since 1970
+     */
+    void Export(timelib64_t now);
+
+    /* Requests kept for a retry. For tests */
+    size_t GetQueuedRequests() const
+    {
+        return m_requests.size();
+    }
+
+    /* Requests that were dropped undelivered. For tests */
+    unsigned long long GetDroppedRequests() const
+    {
+        return m_droppedRequests;
+    }
+
+    /* Inherited from DcgmThread */
+    void run(void) override;
+
+private:
+    /* One field */
+    struct Metric
+    {
+        std::string header; /* Encoded name and description */
+        std::string points; /* Encoded data points of the request being built */
+    };
+
+    std::unordered_map<unsigned short, Metric> m_metrics; /* By fieldId */
+    std::vector<unsigned short> m_fieldIds;
+    timelib64_t m_updateFreqUsec;
+    timelib64_t m_intervalUsec;
+    size_t m_maxBufferedBytes;
+
+    std::mutex m_pendingMutex; /* Protects m_pending */
+    std::vector<std::shared_ptr<DcgmFvBuffer const>> m_pending;
+
+    std::string m_resource; /* Encoded resource of every request */
+    std::string m_scope;    /* Encoded instrumentation scope of every request */
+
+    /* Only used by the thread once it is started */
+    std::unordered_map<std::uint64_t, std::string> m_attributes; /* Encoded attributes by EntityKey() */
+    std::deque<std::string> m_requests;                           /* Undelivered requests, oldest first */
+    size_t m_requestBytes                = 0;
+    unsigned long long m_droppedRequests = 0;
+    timelib64_t m_retryDelayUsec         = 0;
+    timelib64_t m_nextAttemptUsec        = 0;
+    DcgmHttpClient m_client;
+    Sender m_sender;
+
+    static std::uint64_t EntityKey(unsigned int entityGroupId, unsigned int entityId)
+    {
+        return ((std::uint64_t)entityGroupId << 32) | entityId;
+    }
+
+    /* Append the data point of fv to the points of its metric */
+    void AddPoint(dcgmBufferedFv_t const &fv);
+
+    /* Move the points of every metric into a new request at the back of m_requests */
+    void BuildRequest();
+
+    /* Send m_requests until one fails */
+    void Send(timelib64_t now);
+};
+
+#endif // DCGMOTLPEXPORTER_H
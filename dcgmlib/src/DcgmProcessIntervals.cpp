@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmProcessIntervals.h"
+
+#include <algorithm>
+#include <limits>
+
+/*****************************************************************************/
+timelib64_t DcgmProcessIntervals::EffectiveEnd(dcgm_process_interval_t const &interval)
+{
+    return interval.endUsec == 0 ? std::numeric_limits<timelib64_t>::max() : interval.endUsec;
+}
+
+/*****************************************************************************/
+bool DcgmProcessIntervals::Before(timelib64_t startA, unsigned int pidA, timelib64_t startB, unsigned int pidB)
+{
+    return startA < startB || (startA == startB && pidA < pidB);
+}
+
+/*****************************************************************************/
+int DcgmProcessIntervals::Height(std::unique_ptr<Node> const &node)
+{
+    return node ? node->height : 0;
+}
+
+/*****************************************************************************/
+void DcgmProcessIntervals::Update(Node &node)
+{
+    node.height = 1 + std::max(Height(node.left), Height(node.right));
+    node.maxEnd = EffectiveEnd(node.interval);
+    if (node.left)
+        node.maxEnd = std::max(node.maxEnd, node.left->maxEnd);
+    if (node.right)
+        node.maxEnd = std::max(node.maxEnd, node.right->maxEnd);
+}
+
+/*****************************************************************************/
+std::unique_ptr<DcgmProcessIntervals::Node> DcgmProcessIntervals::RotateLeft(std::unique_ptr<Node> node)
+{
+    std::unique_ptr<Node> right = std::move(node->right);
+    node->right                 = std::move(right->left);
+    Update(*node);
+    right->left = std::move(node);
+    Update(*right);
+    return right;
+}
+
+/*****************************************************************************/
+std::unique_ptr<DcgmProcessIntervals::Node> DcgmProcessIntervals::RotateRight(std::unique_ptr<Node> node)
+{
+    std::unique_ptr<Node> left = std::move(node->left);
+    node->left                 = std::move(left->right);
+    Update(*node);
+    left->right = std::move(node);
+    Update(*left);
+    return left;
+}
+
+/*****************************************************************************/
+std::unique_ptr<DcgmProcessIntervals::Node> DcgmProcessIntervals::Rebalance(std::unique_ptr<Node> node)
+{
+    Update(*node);
+    int balance = Height(node->left) - Height(node->right);
+
+    if (balance > 1)
+    {
+        if (Height(node->left->left) < Height(node->left->right))
+            node->left = RotateLeft(std::move(node->left));
+        return RotateRight(std::move(node));
+    }
+
+    if (balance < -1)
+    {
+        if (Height(node->right->right) < Height(node->right->left))
+            node->right = RotateRight(std::move(node->right));
+        return RotateLeft(std::move(node));
+    }
+
+    return node;
+}
+
+/*****************************************************************************/
+std::unique_ptr<DcgmProcessIntervals::Node> DcgmProcessIntervals::Insert(std::unique_ptr<Node> node,
+                                                                         dcgm_process_interval_t const &interval)
+{
+    if (!node)
+    {
+        node           = std::make_unique<Node>();
+        node->interval = interval;
+        Update(*node);
+        return node;
+    }
+
+    if (Before(interval.startUsec, interval.pid, node->interval.startUsec, node->interval.pid))
+        node->left = Insert(std::move(node->left), interval);
+    else
+        node->right = Insert(std::move(node->right), interval);
+
+    return Rebalance(std::move(node));
+}
+
+/*****************************************************************************/
+dcgm_process_interval_t *DcgmProcessIntervals::Find(unsigned int pid, timelib64_t startUsec)
+{
+    Node *node = m_root.get();
+
+    while (node)
+    {
+        if (node->interval.pid == pid && node->interval.startUsec == startUsec)
+            return &node->interval;
+
+        if (Before(startUsec, pid, node->interval.startUsec, node->interval.pid))
+            node = node->left.get();
+        else
+            node = node->right.get();
+    }
+
+    return nullptr;
+}
+
+/*****************************************************************************/
+void DcgmProcessIntervals::UpdatePath(Node *node, unsigned int pid, timelib64_t startUsec)
+{
+    if (!node)
+        return;
+
+    if (node->interval.pid != pid || node->interval.startUsec != startUsec)
+    {
+        if (Before(startUsec, pid, node->interval.startUsec, node->interval.pid))
+            UpdatePath(node->left.get(), pid, startUsec);
+        else
+            UpdatePath(node->right.get(), pid, startUsec);
+    }
+
+    Update(*node);
+}
+
+/*****************************************************************************/
+void DcgmProcessIntervals::Set(unsigned int pid, timelib64_t startUsec, timelib64_t endUsec)
+{
+    dcgm_process_interval_t *interval = Find(pid, startUsec);
+    if (interval)
+    {
+        if (interval->endUsec != endUsec)
+        {
+            interval->endUsec = endUsec;
+            UpdatePath(m_root.get(), pid, startUsec);
+        }
+        return;
+    }
+
+    m_root = Insert(std::move(m_root), { pid, startUsec, endUsec });
+    m_size++;
+
+    auto latestStart = m_latestStart.find(pid);
+    if (latestStart == m_latestStart.end() || latestStart->second < startUsec)
+        m_latestStart[pid] = startUsec;
+}
+
+/*****************************************************************************/
+void DcgmProcessIntervals::Extend(unsigned int pid, timelib64_t timestamp)
+{
+    auto latestStart = m_latestStart.find(pid);
+    if (latestStart != m_latestStart.end())
+    {
+        dcgm_process_interval_t *interval = Find(pid, latestStart->second);
+        if (interval && interval->endUsec != 0 && interval->endUsec < timestamp)
+        {
+            interval->endUsec = timestamp;
+            UpdatePath(m_root.get(), pid, latestStart->second);
+        }
+        if (interval)
+            return;
+    }
+
+    Set(pid, timestamp, timestamp);
+}
+
+/*****************************************************************************/
+void DcgmProcessIntervals::Query(Node const *node,
+                                 timelib64_t startUsec,
+                                 timelib64_t endUsec,
+                                 std::vector<dcgm_process_interval_t> &intervals)
+{
+    /* Everything under node ended before the window */
+    if (!node || node->maxEnd < startUsec)
+        return;
+
+    Query(node->left.get(), startUsec, endUsec, intervals);
+
+    /* node and everything right of it started after the window */
+    if (endUsec != 0 && node->interval.startUsec > endUsec)
+        return;
+
+    if (EffectiveEnd(node->interval) >= startUsec)
+        intervals.push_back(node->interval);
+
+    Query(node->right.get(), startUsec, endUsec, intervals);
+}
+
+/*****************************************************************************/
+void DcgmProcessIntervals::Query(timelib64_t startUsec,
+                                 timelib64_t endUsec,
+                                 std::vector<dcgm_process_interval_t> &intervals) const
+{
+    Query(m_root.get(), startUsec, endUsec, intervals);
+}
+
+/*****************************************************************************/
+void DcgmProcessIntervals::Collect(std::unique_ptr<Node> node,
+                                   timelib64_t usec,
+                                   std::vector<dcgm_process_interval_t> &intervals)
+{
+    if (!node)
+        return;
+
+    Collect(std::move(node->left), usec, intervals);
+    if (EffectiveEnd(node->interval) >= usec)
+        intervals.push_back(node->interval);
+    Collect(std::move(node->right), usec, intervals);
+}
+
+/*****************************************************************************/
+std::unique_ptr<DcgmProcessIntervals::Node> DcgmProcessIntervals::Build(
+    std::vector<dcgm_process_interval_t> const &intervals,
+    size_t begin,
+    size_t end)
+{
+    if (begin >= end)
+        return nullptr;
+
+    size_t middle  = begin + (end - begin) / 2;
+    auto node      = std::make_unique<Node>();
+    node->interval = intervals[middle];
+    node->left     = Build(intervals, begin, middle);
+    node->right    = Build(intervals, middle + 1, end);
+    Update(*node);
+    return node;
+}
+
+/*****************************************************************************/
+void DcgmProcessIntervals::Trim(timelib64_t usec)
+{
+    if (m_size < 2 * m_sizeAtTrim + 64)
+        return;
+
+    std::vector<dcgm_process_interval_t> intervals;
+    intervals.reserve(m_size);
+    Collect(std::move(m_root), usec, intervals);
+
+    m_root       = Build(intervals, 0, intervals.size());
+    m_size       = intervals.size();
+    m_sizeAtTrim = m_size;
+
+    m_latestStart.clear();
+    for (dcgm_process_interval_t const &interval : intervals)
+    {
+        timelib64_t &latestStart = m_latestStart[interval.pid];
+        latestStart              = std::max(latestStart, interval.startUsec);
+    }
+}
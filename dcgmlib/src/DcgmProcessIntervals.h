@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "timelib.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/* When a process ran */
+typedef struct
+{
+    unsigned int pid;
+    timelib64_t startUsec; /* When the process started or was first seen */
+    timelib64_t endUsec;   /* When the process ended or was last seen. 0 = still running */
+} dcgm_process_interval_t;
+
+/*****************************************************************************/
+/*
+ * The lifetimes of the processes of one GPU, in an interval tree so that the
+ * processes that ran during a window can be found without walking every
+ * process. The tree is an AVL tree ordered by start time, and each node
+ * knows the latest end time under it, so whole subtrees that ended before a
+ * window are skipped.
+ *
+ * A PID that is reused gets a new interval when it is Set() with a new start
+ * time. Not thread safe.
+ */
+class DcgmProcessIntervals
+{
+public:
+    DcgmProcessIntervals() = default;
+
+    /* Set the lifetime of pid's process that started at startUsec, adding it if it's new */
+    void Set(unsigned int pid, timelib64_t startUsec, timelib64_t endUsec);
+
+    /* pid was seen running at timestamp. Extends its latest interval, or starts one at timestamp */
+    void Extend(unsigned int pid, timelib64_t timestamp);
+
+    /*************************************************************************/
+    /*
+     * Get the intervals that overlap [startUsec, endUsec], in order of start
+     * time
+     *
+     * startUsec IN: 0 = from the beginning
+     * endUsec   IN: 0 = up until now
+     */
+    void Query(timelib64_t startUsec, timelib64_t endUsec, std::vector<dcgm_process_interval_t> &intervals) const;
+
+    /*************************************************************************/
+    /*
+     * Forget intervals that ended before usec, so that the tree doesn't grow
+     * without bound. Only does the work once the tree has doubled in size
+     * since it was last trimmed, so it can be called on every update
+     */
+    void Trim(timelib64_t usec);
+
+    /* Number of intervals */
+    size_t Size() const
+    {
+        return m_size;
+    }
+
+private:
+    struct Node
+    {
+        dcgm_process_interval_t interval;
+        timelib64_t maxEnd; /* Latest effective end of this subtree */
+        int height;
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+    };
+
+    std::unique_ptr<Node> m_root;
+    size_t m_size       = 0;
+    size_t m_sizeAtTrim = 0; /* m_size after the last Trim() that did work */
+    std::unordered_map<unsigned int, timelib64_t> m_latestStart; /* Start of each PID's latest interval */
+
+    /* Ends of running processes sort after every other end */
+    static timelib64_t EffectiveEnd(dcgm_process_interval_t const &interval);
+
+    /* Does a sort before b? Intervals are ordered by start time, then PID */
+    static bool Before(timelib64_t startA, unsigned int pidA, timelib64_t startB, unsigned int pidB);
+
+    static int Height(std::unique_ptr<Node> const &node);
+    static void Update(Node &node);
+    static std::unique_ptr<Node> RotateLeft(std::unique_ptr<Node> node);
+    static std::unique_ptr<Node> RotateRight(std::unique_ptr<Node> node);
+    static std::unique_ptr<Node> Rebalance(std::unique_ptr<Node> node);
+    static std::unique_ptr<Node> Insert(std::unique_ptr<Node> node, dcgm_process_interval_t const &interval);
+
+    /* Find the interval of pid that starts at startUsec. nullptr = none */
+    dcgm_process_interval_t *Find(unsigned int pid, timelib64_t startUsec);
+
+    /* Recompute maxEnd along the path to the interval of pid that starts at startUsec */
+    static void UpdatePath(Node *node, unsigned int pid, timelib64_t startUsec);
+
+    static void Query(Node const *node,
+                      timelib64_t startUsec,
+                      timelib64_t endUsec,
+                      std::vector<dcgm_process_interval_t> &intervals);
+
+    /* Append the intervals under node that end at or after usec to intervals in order, freeing the nodes */
+    static void Collect(std::unique_ptr<Node> node, timelib64_t usec, std::vector<dcgm_process_interval_t> &intervals);
+
+    /* Build a balanced tree of intervals[begin, end), which are sorted */
+    static std::unique_ptr<Node> Build(std::vector<dcgm_process_interval_t> const &intervals, size_t begin, size_t end);
+};
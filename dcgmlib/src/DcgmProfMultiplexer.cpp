@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmProfMultiplexer.h"
+#include "DcgmLogging.h"
+#include "dcgm_profiling_structs.h"
+#include "dcgm_structs_internal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+/*****************************************************************************/
+DcgmProfMultiplexer::DcgmProfMultiplexer(SendFn sendFn)
+    : m_sendFn(std::move(sendFn))
+{}
+
+/*****************************************************************************/
+DcgmProfMultiplexer::~DcgmProfMultiplexer()
+{
+    StopAndWait(60000);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmProfMultiplexer::PlanSlots(dcgmProfGetMetricGroups_t const &metricGroups,
+                                            dcgmProfWatchFields_t const &watchFields,
+                                            std::vector<DcgmProfMultiplexSlot> &slots)
+{
+    unsigned int numMetricGroups = std::min(metricGroups.numMetricGroups, (unsigned int)DCGM_PROF_MAX_NUM_GROUPS);
+    unsigned int numFieldIds
+        = std::min(watchFields.numFieldIds, (unsigned int)DCGM_ARRAY_CAPACITY(watchFields.fieldIds));
+
+    auto groupHasField = [&](unsigned int mgIndex, unsigned short fieldId) {
+        dcgmProfMetricGroupInfo_t const &mg = metricGroups.metricGroups[mgIndex];
+        unsigned int count = std::min(mg.numFieldIds, (unsigned int)DCGM_PROF_MAX_FIELD_IDS_PER_GROUP);
+        return std::find(mg.fieldIds, mg.fieldIds + count, fieldId) != mg.fieldIds + count;
+    };
+
+    /* Metric groups to collect, by majorId, in the order they are first needed. A field that is in
+       several metric groups is collected with one that is already needed for another field */
+    std::map<unsigned short, std::vector<unsigned int>> majors;
+    std::map<unsigned int, DcgmProfMultiplexSlot> fieldsOfGroup;
+    for (unsigned int i = 0; i < numFieldIds; i++)
+    {
+        unsigned short fieldId = watchFields.fieldIds[i];
+        int chosen             = -1;
+
+        for (auto const &[mgIndex, fields] : fieldsOfGroup)
+        {
+            if (groupHasField(mgIndex, fieldId))
+            {
+                chosen = mgIndex;
+                break;
+            }
+        }
+
+        for (unsigned int mgIndex = 0; chosen < 0 && mgIndex < numMetricGroups; mgIndex++)
+        {
+            if (groupHasField(mgIndex, fieldId))
+            {
+                chosen = mgIndex;
+                majors[metricGroups.metricGroups[mgIndex].majorId].push_back(mgIndex);
+            }
+        }
+
+        if (chosen < 0)
+        {
+            DCGM_LOG_ERROR << "Profiling field " << fieldId << " is not in any metric group of groupId "
+                           << (uintptr_t)watchFields.groupId;
+            return DCGM_ST_PROFILING_NOT_SUPPORTED;
+        }
+
+        DcgmProfMultiplexSlot &fields = fieldsOfGroup[chosen];
+        if (std::find(fields.begin(), fields.end(), fieldId) == fields.end())
+        {
+            fields.push_back(fieldId);
+        }
+    }
+
+    size_t numSlots = 0;
+    for (auto const &[majorId, mgIndexes] : majors)
+    {
+        numSlots = std::max(numSlots, mgIndexes.size());
+    }
+
+    /* Slot s has metric group s of each majorId, wrapping around for majorIds with fewer groups */
+    slots.assign(numSlots, DcgmProfMultiplexSlot {});
+    for (size_t s = 0; s < numSlots; s++)
+    {
+        for (auto const &[majorId, mgIndexes] : majors)
+        {
+            DcgmProfMultiplexSlot const &fields = fieldsOfGroup[mgIndexes[s % mgIndexes.size()]];
+            slots[s].insert(slots[s].end(), fields.begin(), fields.end());
+        }
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+double DcgmProfMultiplexer::Coverage(std::vector<DcgmProfMultiplexSlot> const &slots, unsigned short fieldId)
+{
+    if (slots.empty())
+    {
+        return 0.0;
+    }
+
+    size_t count = std::count_if(slots.begin(), slots.end(), [fieldId](DcgmProfMultiplexSlot const &slot) {
+        return std::find(slot.begin(), slot.end(), fieldId) != slot.end();
+    });
+    return (double)count / (double)slots.size();
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmProfMultiplexer::WatchSlot(DcgmProfMultiplexSlot const &slot)
+{
+    dcgm_profiling_msg_unwatch_fields_t unwatchMsg;
+    memset(&unwatchMsg, 0, sizeof(unwatchMsg));
+    unwatchMsg.header.length         = sizeof(unwatchMsg);
+    unwatchMsg.header.moduleId       = DcgmModuleIdProfiling;
+    unwatchMsg.header.subCommand     = DCGM_PROFILING_SR_UNWATCH_FIELDS;
+    unwatchMsg.header.version        = dcgm_profiling_msg_unwatch_fields_version;
+    unwatchMsg.unwatchFields.version = dcgmProfUnwatchFields_version;
+    unwatchMsg.unwatchFields.groupId = m_watchFields.groupId;
+
+    /* Fails harmlessly if nothing is watched yet */
+    dcgmReturn_t dcgmReturn = m_sendFn(&unwatchMsg.header);
+    DCGM_LOG_DEBUG << "Got " << dcgmReturn << " from unwatching the previous slot";
+
+    dcgm_profiling_msg_watch_fields_t watchMsg;
+    memset(&watchMsg, 0, sizeof(watchMsg));
+    watchMsg.header.length     = sizeof(watchMsg);
+    watchMsg.header.moduleId   = DcgmModuleIdProfiling;
+    watchMsg.header.subCommand = DCGM_PROFILING_SR_WATCH_FIELDS;
+    watchMsg.header.version    = dcgm_profiling_msg_watch_fields_version;
+    watchMsg.watchFields       = m_watchFields;
+
+    size_t numFieldIds               = std::min(slot.size(), DCGM_ARRAY_CAPACITY(watchMsg.watchFields.fieldIds));
+    watchMsg.watchFields.numFieldIds = numFieldIds;
+    std::copy_n(slot.begin(), numFieldIds, watchMsg.watchFields.fieldIds);
+
+    return m_sendFn(&watchMsg.header);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmProfMultiplexer::StartMultiplexing(dcgmProfWatchFields_t &watchFields)
+{
+    m_multiplexing = false;
+
+    if (watchFields.updateFreq <= 0)
+    {
+        DCGM_LOG_ERROR << "A multiplexed profiling watch needs an updateFreq. Got " << watchFields.updateFreq;
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgm_profiling_msg_get_mgs_t mgsMsg;
+    memset(&mgsMsg, 0, sizeof(mgsMsg));
+    mgsMsg.header.length        = sizeof(mgsMsg);
+    mgsMsg.header.moduleId      = DcgmModuleIdProfiling;
+    mgsMsg.header.subCommand    = DCGM_PROFILING_SR_GET_MGS;
+    mgsMsg.header.version       = dcgm_profiling_msg_get_mgs_version;
+    mgsMsg.metricGroups.version = dcgmProfGetMetricGroups_version;
+    mgsMsg.metricGroups.groupId = watchFields.groupId;
+
+    dcgmReturn_t dcgmReturn = m_sendFn(&mgsMsg.header);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " getting the metric groups to multiplex";
+        return dcgmReturn;
+    }
+
+    std::vector<DcgmProfMultiplexSlot> slots;
+    dcgmReturn = PlanSlots(mgsMsg.metricGroups, watchFields, slots);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        return dcgmReturn;
+    }
+
+    m_watchFields = watchFields;
+    m_watchFields.flags &= ~DCGM_PROF_WATCH_FLAG_MULTIPLEX;
+
+    dcgmReturn = WatchSlot(slots[0]);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " watching the first of " << slots.size()
+                       << " slots of profiling fields";
+        return dcgmReturn;
+    }
+
+    std::stringstream coverage;
+    for (unsigned int i = 0; i < m_watchFields.numFieldIds; i++)
+    {
+        coverage << " " << m_watchFields.fieldIds[i] << ":" << Coverage(slots, m_watchFields.fieldIds[i]);
+    }
+    DCGM_LOG_INFO << "Multiplexing " << m_watchFields.numFieldIds << " profiling fields over " << slots.size()
+                  << " slots of " << m_watchFields.updateFreq << " usec. Coverage by fieldId:" << coverage.str();
+
+    if (slots.size() < 2)
+    {
+        /* Everything fits in one watch. There is nothing to rotate */
+        return DCGM_ST_OK;
+    }
+
+    m_slots        = std::move(slots);
+    m_activeSlot   = 0;
+    m_multiplexing = true;
+
+    if (!HasRun())
+    {
+        Start();
+    }
+    m_wake = true;
+    m_cond.notify_all();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+bool DcgmProfMultiplexer::InterceptCommand(dcgm_module_command_header_t *moduleCommand, dcgmReturn_t &dcgmReturn)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    switch (moduleCommand->subCommand)
+    {
+        case DCGM_PROFILING_SR_WATCH_FIELDS:
+        {
+            if (moduleCommand->version != dcgm_profiling_msg_watch_fields_version)
+            {
+                return false; /* The profiling module reports the mismatch */
+            }
+
+            auto msg = (dcgm_profiling_msg_watch_fields_t *)moduleCommand;
+            if ((msg->watchFields.flags & DCGM_PROF_WATCH_FLAG_MULTIPLEX) == 0)
+            {
+                /* A plain watch replaces the rotation */
+                m_multiplexing = false;
+                return false;
+            }
+
+            dcgmReturn = StartMultiplexing(msg->watchFields);
+            return true;
+        }
+
+        case DCGM_PROFILING_SR_UNWATCH_FIELDS:
+            m_multiplexing = false;
+            return false;
+
+        case DCGM_PROFILING_SR_PAUSE_RESUME:
+        {
+            /* Pausing some GPUs leaves their rotation to the profiling module */
+            auto msg = (dcgm_profiling_msg_pause_resume_t *)moduleCommand;
+            if (moduleCommand->version == dcgm_profiling_msg_pause_resume_version1
+                || (moduleCommand->version == dcgm_profiling_msg_pause_resume_version2 && msg->numGpuIds == 0))
+            {
+                m_paused = msg->pause;
+            }
+            return false;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/*****************************************************************************/
+void DcgmProfMultiplexer::RotateOnce()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_multiplexing || m_paused)
+    {
+        return;
+    }
+
+    m_activeSlot            = (m_activeSlot + 1) % m_slots.size();
+    dcgmReturn_t dcgmReturn = WatchSlot(m_slots[m_activeSlot]);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        /* The next rotation tries again with the slot after this one */
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " watching slot " << m_activeSlot
+                       << " of profiling fields";
+    }
+}
+
+/*****************************************************************************/
+unsigned int DcgmProfMultiplexer::GetActiveSlot()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_activeSlot;
+}
+
+/*****************************************************************************/
+bool DcgmProfMultiplexer::IsMultiplexing()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_multiplexing;
+}
+
+/*****************************************************************************/
+void DcgmProfMultiplexer::OnStop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake = true;
+    }
+    m_cond.notify_all();
+}
+
+/*****************************************************************************/
+void DcgmProfMultiplexer::run(void)
+{
+    while (!ShouldStop())
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake = false;
+            if (m_multiplexing)
+            {
+                m_cond.wait_for(lock, std::chrono::microseconds(m_watchFields.updateFreq), [this] { return m_wake; });
+            }
+            else
+            {
+                m_cond.wait(lock, [this] { return m_wake; });
+            }
+
+            if (m_wake)
+            {
+                /* A new rotation was started or we're stopping. Either way, the current slot stays for now */
+                continue;
+            }
+        }
+
+        RotateOnce();
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMPROFMULTIPLEXER_H
+#define DCGMPROFMULTIPLEXER_H
+
+#include "DcgmThread.h"
+#include "dcgm_module_structs.h"
+#include "dcgm_structs.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/* Profiling fields that the profiling module can collect at the same time */
+using DcgmProfMultiplexSlot = std::vector<unsigned short>;
+
+/*
+ * Time-multiplexes profiling fields whose metric groups can't be collected at
+ * the same time (see DCGM_PROF_WATCH_FLAG_MULTIPLEX).
+ *
+ * The host engine shows every command for the profiling module to
+ * InterceptCommand() first. A multiplexed watch is split into slots, one
+ * metric group of each majorId per slot. The profiling module is then asked to
+ * watch one slot at a time, for updateFreq each, in rotation. Metric groups of
+ * a majorId with fewer groups than there are slots come around more than once
+ * per rotation. A plain watch or an unwatch of the profiling module ends the
+ * rotation, and pausing profiling on all GPUs suspends it. Other flags of the
+ * watch, like DCGM_PROF_WATCH_FLAG_BUFFERED, apply to the watch of each slot.
+ */
+class DcgmProfMultiplexer : public DcgmThread
+{
+public:
+    /* Sends a command to the profiling module and waits for it to be processed */
+    using SendFn = std::function<dcgmReturn_t(dcgm_module_command_header_t *moduleCommand)>;
+
+    explicit DcgmProfMultiplexer(SendFn sendFn);
+
+    /* Stops the rotation thread. The profiling module is left watching the current slot */
+    ~DcgmProfMultiplexer() override;
+
+    /*************************************************************************/
+    /*
+     * Split the fields of watchFields into slots of fields that can be
+     * collected together, given the metric groups of the GPUs
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_PROFILING_NOT_SUPPORTED if a field isn't in any metric group
+     */
+    static dcgmReturn_t PlanSlots(dcgmProfGetMetricGroups_t const &metricGroups,
+                                  dcgmProfWatchFields_t const &watchFields,
+                                  std::vector<DcgmProfMultiplexSlot> &slots);
+
+    /* Share of the slots that fieldId is collected in */
+    static double Coverage(std::vector<DcgmProfMultiplexSlot> const &slots, unsigned short fieldId);
+
+    /*************************************************************************/
+    /*
+     * Look at a command for the profiling module before it is sent to it
+     *
+     * Returns: true if the command was processed here. dcgmReturn is set to its result
+     *          false if the command should be sent to the profiling module
+     */
+    bool InterceptCommand(dcgm_module_command_header_t *moduleCommand, dcgmReturn_t &dcgmReturn);
+
+    /* Watch the next slot if a rotation is running and not paused. Called by the thread */
+    void RotateOnce();
+
+    /* Slot being watched. Meaningless unless IsMultiplexing() */
+    unsigned int GetActiveSlot();
+
+    bool IsMultiplexing();
+
+private:
+    SendFn m_sendFn;
+
+    std::mutex m_mutex; /* Guards everything below. Held while commands are sent to the profiling module */
+    std::condition_variable m_cond;
+    bool m_wake = false;
+
+    bool m_multiplexing = false;                /* Whether a rotation is running */
+    bool m_paused       = false;                /* Whether profiling is paused on all GPUs */
+    dcgmProfWatchFields_t m_watchFields {};     /* The multiplexed watch, without DCGM_PROF_WATCH_FLAG_MULTIPLEX */
+    std::vector<DcgmProfMultiplexSlot> m_slots; /* At least 2 while m_multiplexing */
+    unsigned int m_activeSlot = 0;
+
+    /* Replace the profiling module's watch with one of the fields of slot. Caller holds m_mutex */
+    dcgmReturn_t WatchSlot(DcgmProfMultiplexSlot const &slot);
+
+    /* Start multiplexing the fields of watchFields. Caller holds m_mutex */
+    dcgmReturn_t StartMultiplexing(dcgmProfWatchFields_t &watchFields);
+
+    void run(void) override;
+    void OnStop(void) override;
+};
+
+#endif // DCGMPROFMULTIPLEXER_H
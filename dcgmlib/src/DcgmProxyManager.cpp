@@ -0,0 +1,663 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmProxyManager.h"
+#include "DcgmLogging.h"
+#include "DcgmProtocol.h"
+#include "DcgmStringHelpers.h"
+#include "dcgm_agent.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+/* Reaches the host engines through the client API */
+class DcgmProxyApiDownstream : public DcgmProxyDownstream
+{
+public:
+    dcgmReturn_t Connect(std::string const &address, dcgmHandle_t *handle) override
+    {
+        dcgmConnectV2Params_t params {};
+        params.version   = dcgmConnectV2Params_version;
+        params.timeoutMs = 5000;
+
+        std::string target = address;
+        if (address.rfind("unix:", 0) == 0)
+        {
+            params.addressIsUnixSocket = 1;
+            target                     = address.substr(strlen("unix:"));
+        }
+        else
+        {
+            /* Batches of field values compress well */
+            params.compression = DCGM_TRANSPORT_COMPRESSION_ZLIB;
+        }
+
+        return dcgmConnect_v2(target.c_str(), &params, handle);
+    }
+
+    void Disconnect(dcgmHandle_t handle) override
+    {
+        dcgmDisconnect(handle);
+    }
+
+    dcgmReturn_t CheckHealth(dcgmHandle_t handle) override
+    {
+        dcgmHostengineHealth_t health {};
+        health.version          = dcgmHostengineHealth_version;
+        dcgmReturn_t dcgmReturn = dcgmHostengineIsHealthy(handle, &health);
+        if (dcgmReturn == DCGM_ST_OK && health.overallHealth != 0)
+        {
+            dcgmReturn = DCGM_ST_GENERIC_ERROR;
+        }
+        return dcgmReturn;
+    }
+
+    dcgmReturn_t Subscribe(dcgmHandle_t handle,
+                           std::string const &name,
+                           DcgmProxyStreamSpec_t const &spec,
+                           dcgmFieldValueEntityEnumeration_f callback,
+                           void *userData,
+                           DcgmProxySubscription_t &subscription) override
+    {
+        std::vector<unsigned short> fieldIds = spec.fieldIds;
+        std::vector<char> fieldGroupName(name.begin(), name.end());
+        fieldGroupName.push_back('\0');
+
+        dcgmReturn_t dcgmReturn = dcgmFieldGroupCreate(
+            handle, (int)fieldIds.size(), fieldIds.data(), fieldGroupName.data(), &subscription.fieldGroupId);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            return dcgmReturn;
+        }
+
+        dcgmFieldValueStreamParams_t params {};
+        params.version        = dcgmFieldValueStreamParams_version;
+        params.groupId        = spec.groupId;
+        params.fieldGroupId   = subscription.fieldGroupId;
+        params.updateFreq     = spec.updateFreq;
+        params.maxKeepAge     = spec.maxKeepAge;
+        params.maxKeepSamples = spec.maxKeepSamples;
+
+        dcgmReturn = dcgmFieldValueStreamSubscribe(handle, &params, callback, userData, &subscription.streamId);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            dcgmFieldGroupDestroy(handle, subscription.fieldGroupId);
+        }
+        return dcgmReturn;
+    }
+
+    void Unsubscribe(dcgmHandle_t handle, DcgmProxySubscription_t const &subscription) override
+    {
+        dcgmFieldValueStreamUnsubscribe(handle, subscription.streamId);
+        dcgmFieldGroupDestroy(handle, subscription.fieldGroupId);
+    }
+};
+
+/* Buffer a value received through the client API */
+dcgmBufferedFv_t *AddFv1(DcgmFvBuffer &fvBuffer,
+                         dcgm_field_entity_group_t entityGroupId,
+                         dcgm_field_eid_t entityId,
+                         dcgmFieldValue_v1 const &fv1)
+{
+    dcgmReturn_t const status = (dcgmReturn_t)fv1.status;
+
+    switch (fv1.fieldType)
+    {
+        case DCGM_FT_DOUBLE:
+            return fvBuffer.AddDoubleValue(entityGroupId, entityId, fv1.fieldId, fv1.value.dbl, fv1.ts, status);
+
+        case DCGM_FT_STRING:
+            return fvBuffer.AddStringValue(
+                entityGroupId, entityId, fv1.fieldId, (char *)fv1.value.str, fv1.ts, status);
+
+        case DCGM_FT_INT64:
+        case DCGM_FT_TIMESTAMP:
+            return fvBuffer.AddInt64Value(entityGroupId, entityId, fv1.fieldId, fv1.value.i64, fv1.ts, status);
+
+        case DCGM_FT_BINARY:
+            /* The client API doesn't pass on the size of blobs */
+            return fvBuffer.AddBlobValue(
+                entityGroupId, entityId, fv1.fieldId, (void *)fv1.value.blob, sizeof(fv1.value.blob), fv1.ts, status);
+
+        default:
+            DCGM_LOG_ERROR << "Unhandled field type " << fv1.fieldType << " of fieldId " << fv1.fieldId;
+            return nullptr;
+    }
+}
+
+/* Keep the values of fvBuffer from fv on */
+void KeepFrom(DcgmFvBuffer &fvBuffer, dcgmBufferedFv_t const *fv)
+{
+    size_t bufferSize   = 0;
+    size_t elementCount = 0;
+    fvBuffer.GetSize(&bufferSize, &elementCount);
+    char const *start = (char const *)fv;
+    std::vector<char> leftover(start, fvBuffer.GetBuffer() + bufferSize);
+    fvBuffer.SetFromBuffer(leftover.data(), leftover.size());
+}
+} // namespace
+
+/*****************************************************************************/
+DcgmProxyManager::DcgmProxyManager(std::vector<std::string> addresses,
+                                   SendFn sendFn,
+                                   std::unique_ptr<DcgmProxyDownstream> downstream,
+                                   timelib64_t flushIntervalUsec)
+    : DcgmThread(false, "dcgm_proxy")
+    , m_sendFn(std::move(sendFn))
+    , m_downstream(std::move(downstream))
+    , m_flushIntervalUsec(flushIntervalUsec)
+    , m_random(std::random_device {}())
+{
+    if (m_downstream == nullptr)
+    {
+        m_downstream = std::make_unique<DcgmProxyApiDownstream>();
+    }
+
+    if (addresses.size() > DCGM_PROXY_MAX_HOSTS)
+    {
+        DCGM_LOG_ERROR << "Only proxying the first " << DCGM_PROXY_MAX_HOSTS << " of " << addresses.size()
+                       << " host engines";
+        addresses.resize(DCGM_PROXY_MAX_HOSTS);
+    }
+
+    m_hosts.resize(addresses.size());
+    for (size_t i = 0; i < addresses.size(); i++)
+    {
+        m_hosts[i].address = addresses[i];
+        dcgmStrncpy(m_hosts[i].status.address, addresses[i].c_str(), sizeof(m_hosts[i].status.address));
+    }
+}
+
+/*****************************************************************************/
+DcgmProxyManager::~DcgmProxyManager()
+{
+    StopAndWait(60000);
+
+    for (auto &host : m_hosts)
+    {
+        if (host.status.connected)
+        {
+            m_downstream->Disconnect(host.handle);
+        }
+    }
+}
+
+/*****************************************************************************/
+std::vector<std::string> DcgmProxyManager::ParseHosts(std::string const &hosts)
+{
+    std::vector<std::string> addresses;
+    std::stringstream ss(hosts);
+    std::string address;
+
+    while (std::getline(ss, address, ','))
+    {
+        address.erase(0, address.find_first_not_of(" \t"));
+        address.erase(address.find_last_not_of(" \t") + 1);
+        if (!address.empty())
+        {
+            addresses.push_back(address);
+        }
+    }
+
+    return addresses;
+}
+
+/*****************************************************************************/
+timelib64_t DcgmProxyManager::BackoffUsec(unsigned int numFailures)
+{
+    timelib64_t backoffUsec = MIN_RECONNECT_USEC;
+    for (unsigned int i = 1; i < numFailures && backoffUsec < MAX_RECONNECT_USEC; i++)
+    {
+        backoffUsec *= 2;
+    }
+    return std::min(backoffUsec, MAX_RECONNECT_USEC);
+}
+
+/*****************************************************************************/
+timelib64_t DcgmProxyManager::ReconnectDelayUsec(unsigned int numFailures)
+{
+    /* Between half and all of the backoff, so that host engines that went away
+       together aren't retried together */
+    timelib64_t backoffUsec = BackoffUsec(numFailures);
+    return backoffUsec / 2 + (timelib64_t)(m_random() % (backoffUsec / 2 + 1));
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmProxyManager::AddStream(dcgm_connection_id_t connectionId,
+                                         dcgm_request_id_t requestId,
+                                         DcgmProxyStreamSpec_t const &spec,
+                                         unsigned int maxBatchesInFlight,
+                                         unsigned int maxPendingValues)
+{
+    auto stream                = std::make_unique<Stream>();
+    stream->connectionId       = connectionId;
+    stream->requestId          = requestId;
+    stream->spec               = spec;
+    stream->maxBatchesInFlight = maxBatchesInFlight ? maxBatchesInFlight : DCGM_FV_STREAM_DEFAULT_BATCHES_IN_FLIGHT;
+    stream->maxPendingValues   = maxPendingValues ? maxPendingValues : DCGM_FV_STREAM_DEFAULT_PENDING_VALUES;
+    stream->hosts.resize(m_hosts.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        StreamId streamId { connectionId, requestId };
+        if (m_streams.count(streamId))
+        {
+            DCGM_LOG_ERROR << "connectionId " << connectionId << " already has a proxy stream for requestId "
+                           << requestId;
+            return DCGM_ST_IN_USE;
+        }
+
+        DCGM_LOG_DEBUG << "Added a proxy stream of " << spec.fieldIds.size() << " fields for connectionId "
+                       << connectionId << ", requestId " << requestId;
+
+        m_streams[streamId] = std::move(stream);
+        m_wake              = true;
+    }
+
+    m_cond.notify_all();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmProxyManager::RemoveStream(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId)
+{
+    {
+        /* Wait out any send in progress so nothing reaches the client after this returns */
+        std::lock_guard<std::mutex> sendLock(m_sendMutex);
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_streams.erase({ connectionId, requestId }) == 0)
+        {
+            DCGM_LOG_DEBUG << "connectionId " << connectionId << " has no proxy stream for requestId " << requestId;
+            return DCGM_ST_NO_DATA;
+        }
+        m_wake = true;
+    }
+
+    m_cond.notify_all();
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::OnConnectionRemove(dcgm_connection_id_t connectionId)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_streams.lower_bound({ connectionId, 0 });
+        if (it == m_streams.end() || it->first.first != connectionId)
+            return;
+
+        while (it != m_streams.end() && it->first.first == connectionId)
+        {
+            it = m_streams.erase(it);
+        }
+        m_wake = true;
+    }
+
+    m_cond.notify_all();
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::OnAck(dcgm_connection_id_t connectionId,
+                             dcgm_request_id_t requestId,
+                             unsigned int numBatches)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_streams.find({ connectionId, requestId });
+    if (it == m_streams.end())
+        return; /* A field value stream's, or one that crossed an unsubscribe */
+
+    /* Held values go out with the next flush */
+    Stream &stream         = *it->second;
+    stream.batchesInFlight = numBatches >= stream.batchesInFlight ? 0 : stream.batchesInFlight - numBatches;
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::GetHosts(dcgmProxyHosts_v1 &hosts)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    hosts.numHosts = (unsigned int)m_hosts.size();
+    for (size_t i = 0; i < m_hosts.size(); i++)
+    {
+        hosts.hosts[i] = m_hosts[i].status;
+    }
+}
+
+/*****************************************************************************/
+size_t DcgmProxyManager::GetStreamCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_streams.size();
+}
+
+/*****************************************************************************/
+int DcgmProxyManager::OnDownstreamValues(dcgm_field_entity_group_t entityGroupId,
+                                         dcgm_field_eid_t entityId,
+                                         dcgmFieldValue_v1 *values,
+                                         int numValues,
+                                         void *userData)
+{
+    auto context = (CallbackContext *)userData;
+    context->manager->GatherValues(context->hostId, context->streamId, entityGroupId, entityId, values, numValues);
+    return 0;
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::GatherValues(unsigned int hostId,
+                                    StreamId const &streamId,
+                                    dcgm_field_entity_group_t entityGroupId,
+                                    dcgm_field_eid_t entityId,
+                                    dcgmFieldValue_v1 const *values,
+                                    int numValues)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_streams.find(streamId);
+    if (it == m_streams.end())
+        return; /* Removed. The thread unsubscribes it soon */
+
+    Stream &stream       = *it->second;
+    HostPending &pending = stream.hosts[hostId];
+    auto &status         = m_hosts[hostId].status;
+
+    for (int i = 0; i < numValues; i++)
+    {
+        if (pending.numPending >= stream.maxPendingValues
+            || AddFv1(pending.pending, entityGroupId, entityId, values[i]) == nullptr)
+        {
+            pending.numDropped++;
+            status.valuesDropped++;
+            continue;
+        }
+
+        pending.numPending++;
+        status.valuesForwarded++;
+    }
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::DisconnectHost(Host &host, dcgmReturn_t status, timelib64_t now)
+{
+    /* Ends the callbacks of every subscription, so their contexts can go */
+    m_downstream->Disconnect(host.handle);
+    host.handle = 0;
+    host.subscriptions.clear();
+    host.numFailures = 1;
+
+    timelib64_t nextConnectTime = now + ReconnectDelayUsec(host.numFailures);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    host.status.connected       = 0;
+    host.status.lastStatus      = status;
+    host.status.nextConnectTime = nextConnectTime;
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::SyncSubscriptions(unsigned int hostId)
+{
+    Host &host = m_hosts[hostId];
+
+    std::map<StreamId, DcgmProxyStreamSpec_t> specs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto const &[streamId, stream] : m_streams)
+        {
+            specs[streamId] = stream->spec;
+        }
+    }
+
+    for (auto it = host.subscriptions.begin(); it != host.subscriptions.end();)
+    {
+        if (specs.count(it->first))
+        {
+            ++it;
+            continue;
+        }
+
+        if (it->second.context != nullptr)
+        {
+            m_downstream->Unsubscribe(host.handle, it->second.subscription);
+        }
+        it = host.subscriptions.erase(it);
+    }
+
+    for (auto const &[streamId, spec] : specs)
+    {
+        if (host.subscriptions.count(streamId))
+            continue;
+
+        Subscription &subscription = host.subscriptions[streamId];
+        auto context               = std::make_unique<CallbackContext>(CallbackContext { this, hostId, streamId });
+
+        /* Unique on the host engine for as long as this connection lasts */
+        std::string name = "dcgm_proxy_" + std::to_string(streamId.first) + "_" + std::to_string(streamId.second);
+
+        dcgmReturn_t dcgmReturn = m_downstream->Subscribe(
+            host.handle, name, spec, OnDownstreamValues, context.get(), subscription.subscription);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " subscribing " << host.address
+                           << " for connectionId " << streamId.first << ", requestId " << streamId.second;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            host.status.lastStatus = dcgmReturn;
+            continue;
+        }
+
+        subscription.context = std::move(context);
+    }
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::TakeBatches(Stream &stream, std::vector<Batch> &batches)
+{
+    /* Embedded clients process batches as they are sent */
+    bool const isEmbedded = stream.connectionId == DCGM_CONNECTION_ID_NONE;
+    size_t hostId         = 0;
+
+    while (hostId < stream.hosts.size())
+    {
+        if (!isEmbedded && stream.batchesInFlight >= stream.maxBatchesInFlight)
+            return;
+
+        Batch batch;
+        batch.connectionId = stream.connectionId;
+        batch.requestId    = stream.requestId;
+        batch.message.resize(sizeof(dcgm_msg_proxy_fv_batch_t));
+
+        unsigned int numSections = 0;
+        bool isFull              = false;
+
+        for (; hostId < stream.hosts.size() && !isFull; hostId++)
+        {
+            HostPending &pending = stream.hosts[hostId];
+            if (pending.numPending == 0 && pending.numDropped == 0)
+                continue;
+
+            size_t sectionOffset = batch.message.size();
+            batch.message.resize(sectionOffset + sizeof(dcgm_msg_proxy_fv_section_t));
+
+            unsigned int numValues        = 0;
+            dcgmBufferedFvCursor_t cursor = 0;
+            dcgmBufferedFv_t const *fv    = pending.pending.GetNextFv(&cursor);
+            while (fv != nullptr)
+            {
+                bool const isFirstValue = numSections == 0 && numValues == 0;
+                if (!isFirstValue
+                    && batch.message.size() + fv->length > sizeof(dcgm_msg_proxy_fv_batch_t) + DCGM_FV_STREAM_MAX_BATCH_SIZE)
+                {
+                    isFull = true;
+                    break;
+                }
+
+                batch.message.insert(batch.message.end(), (char const *)fv, (char const *)fv + fv->length);
+                numValues++;
+                fv = pending.pending.GetNextFv(&cursor);
+            }
+
+            dcgm_msg_proxy_fv_section_t section {};
+            section.hostId     = (unsigned int)hostId;
+            section.numValues  = numValues;
+            section.numDropped = pending.numDropped;
+            section.bufferSize = batch.message.size() - sectionOffset - sizeof(section);
+            memcpy(batch.message.data() + sectionOffset, &section, sizeof(section));
+            numSections++;
+
+            pending.numDropped = 0;
+            pending.numPending -= numValues;
+            if (fv == nullptr)
+            {
+                pending.pending.Clear();
+            }
+            else
+            {
+                KeepFrom(pending.pending, fv);
+                break; /* Continue with this host in the next batch */
+            }
+        }
+
+        if (numSections == 0)
+            return;
+
+        dcgm_msg_proxy_fv_batch_t header {};
+        header.version     = dcgm_msg_proxy_fv_batch_version;
+        header.numSections = numSections;
+        memcpy(batch.message.data(), &header, sizeof(header));
+
+        if (!isEmbedded)
+            stream.batchesInFlight++;
+
+        batches.push_back(std::move(batch));
+    }
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::FlushStreams()
+{
+    std::vector<Batch> batches;
+    std::lock_guard<std::mutex> sendLock(m_sendMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &[streamId, stream] : m_streams)
+        {
+            TakeBatches(*stream, batches);
+        }
+    }
+
+    for (auto &batch : batches)
+    {
+        dcgmReturn_t dcgmReturn = m_sendFn(batch.connectionId,
+                                           DCGM_MSG_PROXY_FV_BATCH,
+                                           batch.requestId,
+                                           batch.message.data(),
+                                           (int)batch.message.size(),
+                                           DCGM_ST_OK);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            /* The connection going away cleans up the stream */
+            DCGM_LOG_DEBUG << "Got " << errorString(dcgmReturn) << " sending a proxy batch to connectionId "
+                           << batch.connectionId << ", requestId " << batch.requestId;
+        }
+    }
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::RunOnce(timelib64_t now)
+{
+    for (unsigned int hostId = 0; hostId < m_hosts.size(); hostId++)
+    {
+        Host &host = m_hosts[hostId];
+
+        if (!host.status.connected)
+        {
+            if (now < host.status.nextConnectTime)
+                continue;
+
+            dcgmHandle_t handle     = 0;
+            dcgmReturn_t dcgmReturn = m_downstream->Connect(host.address, &handle);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                host.numFailures++;
+                timelib64_t delayUsec = ReconnectDelayUsec(host.numFailures);
+
+                DCGM_LOG_WARNING << "Got " << errorString(dcgmReturn) << " connecting to " << host.address
+                                 << ". Retrying in " << delayUsec / 1000 << " ms";
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                host.status.lastStatus      = dcgmReturn;
+                host.status.nextConnectTime = now + delayUsec;
+                continue;
+            }
+
+            DCGM_LOG_INFO << "Connected to " << host.address;
+            host.handle          = handle;
+            host.numFailures     = 0;
+            host.lastHealthCheck = now;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            host.status.connected       = 1;
+            host.status.numConnects++;
+            host.status.lastStatus      = DCGM_ST_OK;
+            host.status.nextConnectTime = 0;
+        }
+        else if (now - host.lastHealthCheck >= HEALTH_CHECK_USEC)
+        {
+            host.lastHealthCheck    = now;
+            dcgmReturn_t dcgmReturn = m_downstream->CheckHealth(host.handle);
+            if (dcgmReturn != DCGM_ST_OK)
+            {
+                DCGM_LOG_WARNING << "Lost " << host.address << ": " << errorString(dcgmReturn);
+                DisconnectHost(host, dcgmReturn, now);
+                continue;
+            }
+        }
+
+        SyncSubscriptions(hostId);
+    }
+
+    FlushStreams();
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::OnStop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake = true;
+    }
+    m_cond.notify_all();
+}
+
+/*****************************************************************************/
+void DcgmProxyManager::run(void)
+{
+    DCGM_LOG_INFO << "Proxying " << m_hosts.size() << " host engines";
+
+    while (!ShouldStop())
+    {
+        RunOnce(timelib_usecSince1970());
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait_for(lock, std::chrono::microseconds(m_flushIntervalUsec), [this] { return m_wake; });
+        m_wake = false;
+    }
+}
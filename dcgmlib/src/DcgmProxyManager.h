@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMPROXYMANAGER_H
+#define DCGMPROXYMANAGER_H
+
+#include "DcgmFvBuffer.h"
+#include "DcgmFvStreamManager.h"
+#include "DcgmThread.h"
+#include "dcgm_structs.h"
+#include "timelib.h"
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+/* What a proxy stream collects from each host engine behind the proxy */
+struct DcgmProxyStreamSpec_t
+{
+    dcgmGpuGrp_t groupId; /* DCGM_GROUP_ALL_GPUS or DCGM_GROUP_ALL_NVSWITCHES. Other groups are host-specific */
+    std::vector<unsigned short> fieldIds;
+    long long updateFreq;
+    double maxKeepAge;
+    int maxKeepSamples;
+};
+
+/* A field value stream the proxy has on one host engine */
+typedef struct
+{
+    dcgmFieldGrp_t fieldGroupId; /* Field group created on the host engine for the stream */
+    unsigned int streamId;       /* From dcgmFieldValueStreamSubscribe */
+} DcgmProxySubscription_t;
+
+/*
+ * How the proxy talks to the host engines behind it. The default goes through
+ * the client API like any other client. Tests provide their own
+ */
+class DcgmProxyDownstream
+{
+public:
+    virtual ~DcgmProxyDownstream() = default;
+
+    /* address is host[:port] or unix:/path/to/socket */
+    virtual dcgmReturn_t Connect(std::string const &address, dcgmHandle_t *handle) = 0;
+
+    /* No callback of the handle's subscriptions runs once this returns */
+    virtual void Disconnect(dcgmHandle_t handle) = 0;
+
+    virtual dcgmReturn_t CheckHealth(dcgmHandle_t handle) = 0;
+
+    /* Create a field group called name for spec and stream its values to callback */
+    virtual dcgmReturn_t Subscribe(dcgmHandle_t handle,
+                                   std::string const &name,
+                                   DcgmProxyStreamSpec_t const &spec,
+                                   dcgmFieldValueEntityEnumeration_f callback,
+                                   void *userData,
+                                   DcgmProxySubscription_t &subscription)
+        = 0;
+
+    /* Undo Subscribe(). No callback of the subscription runs once this returns */
+    virtual void Unsubscribe(dcgmHandle_t handle, DcgmProxySubscription_t const &subscription) = 0;
+};
+
+/*
+ * Fan-in of several host engines for a collector that would otherwise keep a
+ * connection to each of them (see nv-hostengine --proxy-hosts).
+ *
+ * The proxy connects to each host engine as a client. A client of the proxy
+ * subscribes a proxy stream (see dcgmProxyStreamSubscribe) and the proxy keeps
+ * a field value stream with the same fields on every connected host engine.
+ * The values they push are gathered per stream and host, and sent every
+ * flush interval as DCGM_MSG_PROXY_FV_BATCH messages with one section per
+ * host engine. Batches are acked like those of DCGM_MSG_FV_STREAM, so a proxy
+ * stream only has maxBatchesInFlight unacked batches. While it is at that
+ * limit, at most maxPendingValues values of each host are held and newer ones
+ * are dropped and counted.
+ *
+ * Host engines that can't be reached are retried with exponential backoff
+ * from MIN_RECONNECT_USEC to MAX_RECONNECT_USEC. Each delay is randomized
+ * between half and all of the backoff so that a rack of host engines that
+ * restarted together isn't reconnected to in lockstep. Connected host engines
+ * are health checked every HEALTH_CHECK_USEC. On (re)connecting, every proxy
+ * stream is subscribed again.
+ */
+class DcgmProxyManager : public DcgmThread
+{
+public:
+    using SendFn = DcgmFvStreamManager::SendFn;
+
+    static constexpr timelib64_t MIN_RECONNECT_USEC = 1000000;
+    static constexpr timelib64_t MAX_RECONNECT_USEC = 60000000;
+    static constexpr timelib64_t HEALTH_CHECK_USEC  = 5000000;
+    static constexpr timelib64_t DEFAULT_FLUSH_USEC = 100000;
+
+    /*************************************************************************/
+    /*
+     * Constructor. Call Start() to start connecting
+     *
+     * addresses         IN: Host engines to collect from. Their indexes are the hostIds of the batches
+     * sendFn            IN: Sends batches to clients
+     * downstream        IN: How to reach the host engines. nullptr = the client API
+     * flushIntervalUsec IN: How long values are gathered before they are sent
+     */
+    DcgmProxyManager(std::vector<std::string> addresses,
+                     SendFn sendFn,
+                     std::unique_ptr<DcgmProxyDownstream> downstream = nullptr,
+                     timelib64_t flushIntervalUsec                   = DEFAULT_FLUSH_USEC);
+
+    /* Stops the thread and disconnects from every host engine */
+    ~DcgmProxyManager() override;
+
+    /* Split a DCGM_ENV_PROXY_HOSTS style list of addresses. Blank entries are skipped */
+    static std::vector<std::string> ParseHosts(std::string const &hosts);
+
+    /* Backoff before the next connection attempt after numFailures failed ones in a row, before jitter */
+    static timelib64_t BackoffUsec(unsigned int numFailures);
+
+    /*************************************************************************/
+    /*
+     * Add a stream. It is subscribed on the host engines by the next pass of the thread
+     *
+     * connectionId       IN: Connection of the client. DCGM_CONNECTION_ID_NONE = embedded
+     * requestId          IN: Request ID the client subscribed with. Batches are sent to it
+     * spec               IN: What to collect from each host engine
+     * maxBatchesInFlight IN: Flow control window. 0 = DCGM_FV_STREAM_DEFAULT_BATCHES_IN_FLIGHT
+     * maxPendingValues   IN: Most values of each host to hold while the window is full.
+     *                        0 = DCGM_FV_STREAM_DEFAULT_PENDING_VALUES
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_IN_USE if requestId already has a stream on connectionId
+     */
+    dcgmReturn_t AddStream(dcgm_connection_id_t connectionId,
+                           dcgm_request_id_t requestId,
+                           DcgmProxyStreamSpec_t const &spec,
+                           unsigned int maxBatchesInFlight,
+                           unsigned int maxPendingValues);
+
+    /*************************************************************************/
+    /*
+     * Remove a stream. No batch of it is sent once this returns. Its subscriptions
+     * on the host engines are removed by the next pass of the thread
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if there was no such stream
+     */
+    dcgmReturn_t RemoveStream(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId);
+
+    /* Forget every stream of a connection that went away */
+    void OnConnectionRemove(dcgm_connection_id_t connectionId);
+
+    /* Handle a DCGM_MSG_FV_STREAM_ACK. Ignores acks of streams that aren't proxy streams */
+    void OnAck(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId, unsigned int numBatches);
+
+    /* State of the host engines, for dcgmProxyGetHosts */
+    void GetHosts(dcgmProxyHosts_v1 &hosts);
+
+    /* Number of streams. For tests and logging */
+    size_t GetStreamCount();
+
+    /*************************************************************************/
+    /*
+     * One pass of the thread: connect to the host engines that are due, health
+     * check the connected ones, bring their subscriptions in line with the streams
+     * and send the values gathered since the last pass. Public for tests, which
+     * call it instead of Start()
+     *
+     * now IN: Current time in usec since 1970
+     */
+    void RunOnce(timelib64_t now);
+
+    /* Inherited from DcgmThread */
+    void run(void) override;
+    void OnStop(void) override;
+
+private:
+    using StreamId = std::pair<dcgm_connection_id_t, dcgm_request_id_t>;
+
+    /* Values of one host gathered for a stream */
+    struct HostPending
+    {
+        unsigned int numPending = 0; /* Values in pending */
+        unsigned int numDropped = 0; /* Values dropped since the last batch */
+        DcgmFvBuffer pending;
+    };
+
+    struct Stream
+    {
+        dcgm_connection_id_t connectionId;
+        dcgm_request_id_t requestId;
+        DcgmProxyStreamSpec_t spec;
+        unsigned int maxBatchesInFlight;
+        unsigned int maxPendingValues;
+        unsigned int batchesInFlight = 0; /* Sent but not acked. Always 0 for embedded clients */
+        std::vector<HostPending> hosts;   /* By hostId */
+    };
+
+    /* userData of a subscription's callback */
+    struct CallbackContext
+    {
+        DcgmProxyManager *manager;
+        unsigned int hostId;
+        StreamId streamId;
+    };
+
+    struct Subscription
+    {
+        DcgmProxySubscription_t subscription;
+        std::unique_ptr<CallbackContext> context; /* nullptr if subscribing failed. Not retried until a reconnect */
+    };
+
+    struct Host
+    {
+        std::string address;
+
+        /* Only used by the thread */
+        dcgmHandle_t handle          = 0;
+        unsigned int numFailures     = 0; /* Failed connection attempts in a row */
+        timelib64_t lastHealthCheck  = 0;
+        std::map<StreamId, Subscription> subscriptions;
+
+        /* Written by the thread with m_mutex held */
+        dcgmProxyHostStatus_v1 status {};
+    };
+
+    /* A batch taken out of a stream, to send once m_mutex is released */
+    struct Batch
+    {
+        dcgm_connection_id_t connectionId;
+        dcgm_request_id_t requestId;
+        std::vector<char> message; /* dcgm_msg_proxy_fv_batch_t followed by the sections */
+    };
+
+    SendFn m_sendFn;
+    std::unique_ptr<DcgmProxyDownstream> m_downstream;
+    timelib64_t m_flushIntervalUsec;
+    std::minstd_rand m_random; /* Reconnection jitter. Only used by the thread */
+
+    /* Protects m_streams and the status of m_hosts. Never held while calling m_downstream,
+       since subscription callbacks take it, or while sending */
+    std::mutex m_mutex;
+    std::condition_variable m_cond; /* Wakes the thread on stream changes and Stop() */
+    bool m_wake = false;            /* Protected by m_mutex */
+    std::vector<Host> m_hosts;      /* Fixed at construction */
+    std::map<StreamId, std::unique_ptr<Stream>> m_streams;
+
+    /* Held while taking batches out of streams and sending them, so each
+       stream's batches go out in order. Taken before m_mutex */
+    std::mutex m_sendMutex;
+
+    /* Subscription callback */
+    static int OnDownstreamValues(dcgm_field_entity_group_t entityGroupId,
+                                  dcgm_field_eid_t entityId,
+                                  dcgmFieldValue_v1 *values,
+                                  int numValues,
+                                  void *userData);
+
+    /* Queue the values of hostId for streamId */
+    void GatherValues(unsigned int hostId,
+                      StreamId const &streamId,
+                      dcgm_field_entity_group_t entityGroupId,
+                      dcgm_field_eid_t entityId,
+                      dcgmFieldValue_v1 const *values,
+                      int numValues);
+
+    /* BackoffUsec() with jitter */
+    timelib64_t ReconnectDelayUsec(unsigned int numFailures);
+
+    /* Drop the connection to host and schedule a reconnect */
+    void DisconnectHost(Host &host, dcgmReturn_t status, timelib64_t now);
+
+    /* Subscribe host to new streams and unsubscribe it from removed ones */
+    void SyncSubscriptions(unsigned int hostId);
+
+    /* Move the pending values of stream into batches if its window allows. Caller holds m_mutex */
+    void TakeBatches(Stream &stream, std::vector<Batch> &batches);
+
+    /* Send what every stream gathered */
+    void FlushStreams();
+};
+
+#endif // DCGMPROXYMANAGER_H
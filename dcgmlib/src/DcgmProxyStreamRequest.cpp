@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmProxyStreamRequest.h"
+#include "DcgmFvBuffer.h"
+#include "DcgmLogging.h"
+#include "DcgmProtocol.h"
+
+#include <cstring>
+#include <vector>
+
+/*****************************************************************************/
+DcgmProxyStreamRequest::DcgmProxyStreamRequest(dcgmProxyFieldValueEnumeration_f callback,
+                                               void *userData,
+                                               AckFn ackFn)
+    : DcgmRequest(0)
+    , m_isAckRecvd(false)
+    , m_callback(callback)
+    , m_userData(userData)
+    , m_ackFn(std::move(ackFn))
+{}
+
+/*****************************************************************************/
+int DcgmProxyStreamRequest::ProcessMessage(std::unique_ptr<DcgmMessage> msg)
+{
+    if (!msg)
+        return DCGM_ST_BADPARAM;
+
+    Lock();
+    /* The first response is the proxy confirming the subscription. Further
+       messages are batches of values, which can arrive before it */
+    dcgm_message_header_t *header = msg->GetMessageHdr();
+    switch (header->msgType)
+    {
+        case DCGM_MSG_PROTO_REQUEST:
+        case DCGM_MSG_PROTO_RESPONSE:
+        case DCGM_MSG_MODULE_COMMAND:
+            if (!m_isAckRecvd)
+            {
+                m_status     = DCGM_ST_OK;
+                m_isAckRecvd = true;
+                m_messages.push_back(std::move(msg));
+                m_condition.notify_all(); /* The waiting thread will wake up and read the messages */
+            }
+            else
+            {
+                DCGM_LOG_ERROR << "Ignoring unexpected duplicate ACK";
+            }
+            Unlock();
+            return DCGM_ST_OK;
+
+        case DCGM_MSG_PROXY_FV_BATCH:
+            break; /* Handled below */
+
+        default:
+            DCGM_LOG_ERROR << "Unexpected msgType 0x" << std::hex << header->msgType << " received.";
+            Unlock();
+            return DCGM_ST_OK; /* Returning an error here doesn't affect anything we want to affect */
+    }
+
+    dcgm_request_id_t requestId = m_requestId;
+    AckFn ackFn                 = m_ackFn;
+    Unlock();
+
+    DeliverBatch(*msg);
+
+    if (ackFn)
+        ackFn(requestId, 1);
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+void DcgmProxyStreamRequest::DeliverBatch(DcgmMessage &msg)
+{
+    auto msgBytes = msg.GetMsgBytesPtr();
+    if (msgBytes->size() < sizeof(dcgm_msg_proxy_fv_batch_t))
+    {
+        DCGM_LOG_ERROR << "Got a truncated DCGM_MSG_PROXY_FV_BATCH of " << msgBytes->size() << " bytes";
+        return;
+    }
+
+    dcgm_msg_proxy_fv_batch_t batchHdr;
+    memcpy(&batchHdr, msgBytes->data(), sizeof(batchHdr));
+    if (batchHdr.version != dcgm_msg_proxy_fv_batch_version)
+    {
+        DCGM_LOG_ERROR << "Got a DCGM_MSG_PROXY_FV_BATCH of unknown version " << batchHdr.version;
+        return;
+    }
+
+    size_t offset = sizeof(batchHdr);
+    for (unsigned int i = 0; i < batchHdr.numSections; i++)
+    {
+        dcgm_msg_proxy_fv_section_t section;
+        if (msgBytes->size() - offset < sizeof(section))
+        {
+            DCGM_LOG_ERROR << "DCGM_MSG_PROXY_FV_BATCH ends in section " << i << " of " << batchHdr.numSections;
+            return;
+        }
+        memcpy(&section, msgBytes->data() + offset, sizeof(section));
+        offset += sizeof(section);
+
+        if (msgBytes->size() - offset < section.bufferSize)
+        {
+            DCGM_LOG_ERROR << "Section " << i << " of a DCGM_MSG_PROXY_FV_BATCH claims " << section.bufferSize
+                           << " bytes but only " << msgBytes->size() - offset << " are left";
+            return;
+        }
+
+        if (section.numDropped > 0)
+        {
+            DCGM_LOG_WARNING << "The proxy dropped " << section.numDropped << " values of hostId " << section.hostId
+                             << " for requestId " << m_requestId << " because the client fell behind";
+        }
+
+        if (!DeliverSection(section.hostId, msgBytes->data() + offset, section.bufferSize, section.numValues))
+        {
+            DCGM_LOG_DEBUG << "Callback asked to skip the rest of the batch";
+            return;
+        }
+        offset += section.bufferSize;
+    }
+}
+
+/*****************************************************************************/
+bool DcgmProxyStreamRequest::DeliverSection(unsigned int hostId,
+                                            char const *buffer,
+                                            unsigned int bufferSize,
+                                            unsigned int numValues)
+{
+    if (bufferSize == 0 || m_callback == nullptr)
+        return true;
+
+    DcgmFvBuffer fvBuffer(bufferSize);
+    dcgmReturn_t dcgmReturn = fvBuffer.SetFromBuffer(buffer, bufferSize);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " from SetFromBuffer()";
+        return true;
+    }
+
+    /* Values are passed to the callback in runs of the same entity */
+    std::vector<dcgmFieldValue_v1> values;
+    values.reserve(numValues);
+    dcgm_field_entity_group_t entityGroupId = DCGM_FE_NONE;
+    dcgm_field_eid_t entityId               = 0;
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    for (dcgmBufferedFv_t *fv = fvBuffer.GetNextFv(&cursor);; fv = fvBuffer.GetNextFv(&cursor))
+    {
+        if (!values.empty()
+            && (fv == nullptr || fv->entityGroupId != entityGroupId || fv->entityId != entityId))
+        {
+            if (m_callback(hostId, entityGroupId, entityId, values.data(), (int)values.size(), m_userData) < 0)
+                return false;
+            values.clear();
+        }
+
+        if (fv == nullptr)
+            break;
+
+        entityGroupId = (dcgm_field_entity_group_t)fv->entityGroupId;
+        entityId      = fv->entityId;
+        values.emplace_back();
+        DcgmFvBuffer::ConvertBufferedFvToFv1(fv, &values.back());
+    }
+
+    return true;
+}
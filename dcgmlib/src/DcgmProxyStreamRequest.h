@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMPROXYSTREAMREQUEST_H
+#define DCGMPROXYSTREAMREQUEST_H
+
+#include "DcgmFvStreamRequest.h"
+#include "DcgmRequest.h"
+#include "dcgm_structs.h"
+
+/*
+ * Client side of a proxy stream. Passes the values of each host section of a
+ * DCGM_MSG_PROXY_FV_BATCH to the user's callback, then acknowledges the batch
+ * so the proxy can send more.
+ */
+class DcgmProxyStreamRequest : public DcgmRequest
+{
+public:
+    using AckFn = DcgmFvStreamRequest::AckFn;
+
+    DcgmProxyStreamRequest(dcgmProxyFieldValueEnumeration_f callback, void *userData, AckFn ackFn);
+    ~DcgmProxyStreamRequest() override = default;
+    int ProcessMessage(std::unique_ptr<DcgmMessage> msg) override;
+
+private:
+    bool m_isAckRecvd;
+    dcgmProxyFieldValueEnumeration_f m_callback;
+    void *m_userData;
+    AckFn m_ackFn;
+
+    /* Pass the values of a DCGM_MSG_PROXY_FV_BATCH to the callback. Called without the lock held */
+    void DeliverBatch(DcgmMessage &msg);
+
+    /* Pass the values of one host's section. Returns false if the callback asked to skip the rest */
+    bool DeliverSection(unsigned int hostId, char const *buffer, unsigned int bufferSize, unsigned int numValues);
+};
+
+#endif /* DCGMPROXYSTREAMREQUEST_H */
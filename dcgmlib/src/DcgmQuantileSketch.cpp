@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmQuantileSketch.h"
+
+#include <dcgm_structs.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+/*****************************************************************************/
+DcgmQuantileSketch::DcgmQuantileSketch(double relativeAccuracy, size_t maxBins)
+    : m_relativeAccuracy(relativeAccuracy)
+    , m_gamma((1.0 + relativeAccuracy) / (1.0 - relativeAccuracy))
+    , m_logGamma(std::log(m_gamma))
+    , m_maxBins(std::max<size_t>(maxBins, 1))
+{}
+
+/*****************************************************************************/
+int DcgmQuantileSketch::Key(double magnitude) const
+{
+    return (int)std::ceil(std::log(magnitude) / m_logGamma);
+}
+
+/*****************************************************************************/
+double DcgmQuantileSketch::KeyValue(int key) const
+{
+    /* Bin key holds (gamma^(key-1), gamma^key]. This is within the relative accuracy of both ends */
+    return 2.0 * std::pow(m_gamma, key) / (m_gamma + 1.0);
+}
+
+/*****************************************************************************/
+void DcgmQuantileSketch::AddToBins(Bins &bins, int key, long long count)
+{
+    if (bins.counts.empty())
+    {
+        bins.offset = key;
+        bins.counts.assign(1, count);
+        return;
+    }
+
+    int oldHigh = bins.offset + (int)bins.counts.size() - 1;
+    int low     = std::min(key, bins.offset);
+    int high    = std::max(key, oldHigh);
+
+    /* Over the cap, the lowest bins are folded into the lowest one that is kept */
+    if ((size_t)(high - low) + 1 > m_maxBins)
+        low = high - (int)m_maxBins + 1;
+
+    if (low != bins.offset || high != oldHigh)
+    {
+        std::vector<long long> counts(high - low + 1, 0);
+        for (size_t i = 0; i < bins.counts.size(); i++)
+        {
+            int oldKey = bins.offset + (int)i;
+            counts[std::max(oldKey, low) - low] += bins.counts[i];
+        }
+        bins.counts.swap(counts);
+        bins.offset = low;
+    }
+
+    bins.counts[std::max(key, low) - low] += count;
+}
+
+/*****************************************************************************/
+void DcgmQuantileSketch::Add(double value)
+{
+    if (std::isnan(value))
+        return;
+
+    if (m_count == 0)
+    {
+        m_min = value;
+        m_max = value;
+    }
+    else
+    {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+    m_count++;
+
+    if (value > MIN_INDEXABLE_VALUE)
+        AddToBins(m_positive, Key(value), 1);
+    else if (value < -MIN_INDEXABLE_VALUE)
+        AddToBins(m_negative, Key(-value), 1);
+    else
+        m_zeroCount++;
+}
+
+/*****************************************************************************/
+bool DcgmQuantileSketch::Merge(DcgmQuantileSketch const &other)
+{
+    if (other.m_relativeAccuracy != m_relativeAccuracy)
+        return false;
+    if (other.m_count == 0)
+        return true;
+
+    if (m_count == 0)
+    {
+        m_min = other.m_min;
+        m_max = other.m_max;
+    }
+    else
+    {
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+    m_count += other.m_count;
+    m_zeroCount += other.m_zeroCount;
+
+    for (size_t i = 0; i < other.m_positive.counts.size(); i++)
+    {
+        if (other.m_positive.counts[i])
+            AddToBins(m_positive, other.m_positive.offset + (int)i, other.m_positive.counts[i]);
+    }
+    for (size_t i = 0; i < other.m_negative.counts.size(); i++)
+    {
+        if (other.m_negative.counts[i])
+            AddToBins(m_negative, other.m_negative.offset + (int)i, other.m_negative.counts[i]);
+    }
+    return true;
+}
+
+/*****************************************************************************/
+double DcgmQuantileSketch::Quantile(double q) const
+{
+    if (m_count == 0 || std::isnan(q))
+        return DCGM_FP64_BLANK;
+    if (q <= 0.0)
+        return m_min;
+    if (q >= 1.0)
+        return m_max;
+
+    /* The value whose rank is the first past q of the way from the smallest to the largest */
+    double rank    = q * (double)(m_count - 1);
+    long long seen = 0;
+    double value   = m_max;
+    bool found     = false;
+
+    /* Negative values from the largest magnitude down */
+    for (size_t i = m_negative.counts.size(); i > 0 && !found; i--)
+    {
+        seen += m_negative.counts[i - 1];
+        if ((double)seen > rank)
+        {
+            value = -KeyValue(m_negative.offset + (int)(i - 1));
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        seen += m_zeroCount;
+        if ((double)seen > rank)
+        {
+            value = 0.0;
+            found = true;
+        }
+    }
+
+    for (size_t i = 0; i < m_positive.counts.size() && !found; i++)
+    {
+        seen += m_positive.counts[i];
+        if ((double)seen > rank)
+        {
+            value = KeyValue(m_positive.offset + (int)i);
+            found = true;
+        }
+    }
+
+    /* Bins are wider than the values they hold. Don't report past what was added */
+    return std::clamp(value, m_min, m_max);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*****************************************************************************/
+/*
+ * Streaming quantile sketch of doubles with relative error guarantees
+ * (DDSketch). Values are counted in logarithmically sized bins, so any
+ * quantile is within relativeAccuracy of a value that was actually added, and
+ * sketches built with the same accuracy merge without losing any.
+ *
+ * Each sign keeps at most maxBins bins. Past that, the bins of the smallest
+ * magnitudes are folded together, which only costs accuracy at the low end.
+ * Magnitudes below MIN_INDEXABLE_VALUE are counted as 0.
+ *
+ * This class is not thread safe.
+ */
+class DcgmQuantileSketch
+{
+public:
+    static constexpr double DEFAULT_RELATIVE_ACCURACY = 0.01;
+    static constexpr size_t DEFAULT_MAX_BINS          = 2048;
+    static constexpr double MIN_INDEXABLE_VALUE       = 1e-9;
+
+    DcgmQuantileSketch()
+        : DcgmQuantileSketch(DEFAULT_RELATIVE_ACCURACY)
+    {}
+
+    explicit DcgmQuantileSketch(double relativeAccuracy, size_t maxBins = DEFAULT_MAX_BINS);
+
+    /* Add one value. NaN is ignored */
+    void Add(double value);
+
+    /*************************************************************************/
+    /*
+     * Add every value of other to this sketch.
+     *
+     * Returns false and leaves this sketch as is if other has a different
+     * relative accuracy
+     */
+    bool Merge(DcgmQuantileSketch const &other);
+
+    /*************************************************************************/
+    /*
+     * Get the value at quantile q in [0, 1], like 0.95 for p95. Returns
+     * DCGM_FP64_BLANK if no values were added. q = 0 and q = 1 are the exact
+     * min and max
+     */
+    double Quantile(double q) const;
+
+    long long Count(void) const
+    {
+        return m_count;
+    }
+
+    double RelativeAccuracy(void) const
+    {
+        return m_relativeAccuracy;
+    }
+
+    /* Number of bins in use. For tests and memory accounting */
+    size_t NumBins(void) const
+    {
+        return m_positive.counts.size() + m_negative.counts.size();
+    }
+
+private:
+    /* Dense counts of consecutive bin keys */
+    struct Bins
+    {
+        int offset = 0; /* Key of counts[0] */
+        std::vector<long long> counts;
+    };
+
+    double m_relativeAccuracy;
+    double m_gamma;              /* Ratio between the bounds of a bin */
+    double m_logGamma;           /* log(m_gamma) */
+    size_t m_maxBins;            /* Of each of m_positive and m_negative */
+    long long m_count     = 0;
+    long long m_zeroCount = 0;   /* Values counted as 0 */
+    double m_min          = 0.0; /* Only valid if m_count > 0 */
+    double m_max          = 0.0; /* Only valid if m_count > 0 */
+    Bins m_positive;             /* Of positive values */
+    Bins m_negative;             /* Of the magnitudes of negative values */
+
+    int Key(double magnitude) const;
+    double KeyValue(int key) const;
+    void AddToBins(Bins &bins, int key, long long count);
+};
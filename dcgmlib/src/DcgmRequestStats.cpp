@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmRequestStats.h"
+
+#include <algorithm>
+#include <vector>
+
+/*****************************************************************************/
+unsigned int DcgmRequestStats::GetLatencyBucket(unsigned long long usec)
+{
+    unsigned int bucket = 0;
+    while (usec > 0 && bucket < DCGM_INTROSPECT_LATENCY_BUCKETS - 1)
+    {
+        usec >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/*****************************************************************************/
+void DcgmRequestStats::Add(dcgmIntrospectRequestTypeStats_t &stats,
+                           dcgmReturn_t status,
+                           unsigned long long queueWaitUsec,
+                           unsigned long long processUsec,
+                           unsigned long long replyBytes)
+{
+    stats.count++;
+    if (status != DCGM_ST_OK)
+    {
+        stats.errorCount++;
+    }
+
+    stats.totalQueueWaitUsec += queueWaitUsec;
+    stats.maxQueueWaitUsec = std::max(stats.maxQueueWaitUsec, queueWaitUsec);
+    stats.totalProcessUsec += processUsec;
+    stats.maxProcessUsec = std::max(stats.maxProcessUsec, processUsec);
+    stats.totalReplyBytes += replyBytes;
+    stats.maxReplyBytes = std::max(stats.maxReplyBytes, replyBytes);
+
+    stats.queueWaitHistogram[GetLatencyBucket(queueWaitUsec)]++;
+    stats.processHistogram[GetLatencyBucket(processUsec)]++;
+}
+
+/*****************************************************************************/
+void DcgmRequestStats::Record(dcgm_connection_id_t connectionId,
+                              unsigned int moduleId,
+                              unsigned int command,
+                              dcgmReturn_t status,
+                              unsigned long long queueWaitUsec,
+                              unsigned long long processUsec,
+                              unsigned long long replyBytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto [totalIt, totalAdded] = m_totals.try_emplace(Key { 0, moduleId, command });
+    if (totalAdded)
+    {
+        totalIt->second          = {};
+        totalIt->second.moduleId = moduleId;
+        totalIt->second.command  = command;
+    }
+    Add(totalIt->second, status, queueWaitUsec, processUsec, replyBytes);
+
+    if (connectionId == DCGM_CONNECTION_ID_NONE)
+    {
+        return;
+    }
+
+    auto [connIt, connAdded] = m_perConnection.try_emplace(Key { connectionId, moduleId, command });
+    if (connAdded)
+    {
+        connIt->second              = {};
+        connIt->second.moduleId     = moduleId;
+        connIt->second.command      = command;
+        connIt->second.connectionId = connectionId;
+    }
+    Add(connIt->second, status, queueWaitUsec, processUsec, replyBytes);
+}
+
+/*****************************************************************************/
+void DcgmRequestStats::OnConnectionRemove(dcgm_connection_id_t connectionId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    /* Keys are ordered by connectionId first */
+    auto first = m_perConnection.lower_bound(Key { connectionId, 0, 0 });
+    auto last  = first;
+    while (last != m_perConnection.end() && std::get<0>(last->first) == connectionId)
+    {
+        ++last;
+    }
+    m_perConnection.erase(first, last);
+}
+
+/*****************************************************************************/
+void DcgmRequestStats::GetStats(dcgmIntrospectRequestStats_t &requestStats)
+{
+    std::vector<dcgmIntrospectRequestTypeStats_t const *> entries;
+
+    requestStats.numEntries  = 0;
+    requestStats.moreEntries = 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto const &source
+        = (requestStats.flags & DCGM_INTROSPECT_REQUEST_STATS_PER_CONNECTION) ? m_perConnection : m_totals;
+    entries.reserve(source.size());
+    for (auto const &[key, stats] : source)
+    {
+        entries.push_back(&stats);
+    }
+
+    /* Busiest first. Keep the key order between equally busy ones so that the output is stable */
+    std::stable_sort(entries.begin(), entries.end(), [](auto const *a, auto const *b) { return a->count > b->count; });
+
+    for (auto const *stats : entries)
+    {
+        if (requestStats.numEntries >= DCGM_INTROSPECT_MAX_REQUEST_TYPES)
+        {
+            requestStats.moreEntries = 1;
+            break;
+        }
+        requestStats.entries[requestStats.numEntries++] = *stats;
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMREQUESTSTATS_H
+#define DCGMREQUESTSTATS_H
+
+#include "dcgm_structs.h"
+#include "dcgm_structs_internal.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+/*
+ * Counts the requests clients send the host engine by request type: how many
+ * there were, how many failed, how long they waited for a worker and were
+ * processed for and how big their replies were. Request types are module
+ * commands by module and subcommand and protobuf commands by command type
+ * (moduleId DCGM_INTROSPECT_REQUEST_PROTOBUF).
+ *
+ * Each request type is counted across all connections since the host engine
+ * started and, while the connection is open, per connection.
+ */
+class DcgmRequestStats
+{
+public:
+    /*************************************************************************/
+    /*
+     * Count a processed request
+     *
+     * connectionId   IN: Connection the request came from
+     * moduleId       IN: dcgmModuleId_t of a module command or DCGM_INTROSPECT_REQUEST_PROTOBUF
+     * command        IN: Subcommand of a module command or command type of a protobuf command
+     * status         IN: What processing the request returned
+     * queueWaitUsec  IN: How long the request waited for a worker
+     * processUsec    IN: How long processing the request took
+     * replyBytes     IN: Size of the reply
+     */
+    void Record(dcgm_connection_id_t connectionId,
+                unsigned int moduleId,
+                unsigned int command,
+                dcgmReturn_t status,
+                unsigned long long queueWaitUsec,
+                unsigned long long processUsec,
+                unsigned long long replyBytes);
+
+    /* Forget the per connection counts of a connection that closed */
+    void OnConnectionRemove(dcgm_connection_id_t connectionId);
+
+    /*************************************************************************/
+    /*
+     * Populate requestStats with the busiest request types, per connection if
+     * requestStats->flags has DCGM_INTROSPECT_REQUEST_STATS_PER_CONNECTION
+     */
+    void GetStats(dcgmIntrospectRequestStats_t &requestStats);
+
+    /* Histogram bucket of a latency. See DCGM_INTROSPECT_LATENCY_BUCKETS */
+    static unsigned int GetLatencyBucket(unsigned long long usec);
+
+private:
+    using Key = std::tuple<dcgm_connection_id_t, unsigned int, unsigned int>; /* connectionId, moduleId, command */
+
+    std::mutex m_mutex; /* Protects m_totals and m_perConnection */
+
+    std::map<Key, dcgmIntrospectRequestTypeStats_t> m_totals;        /* connectionId of the keys is 0 */
+    std::map<Key, dcgmIntrospectRequestTypeStats_t> m_perConnection; /* Of open connections */
+
+    static void Add(dcgmIntrospectRequestTypeStats_t &stats,
+                    dcgmReturn_t status,
+                    unsigned long long queueWaitUsec,
+                    unsigned long long processUsec,
+                    unsigned long long replyBytes);
+};
+
+#endif // DCGMREQUESTSTATS_H
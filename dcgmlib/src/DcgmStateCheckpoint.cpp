@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmStateCheckpoint.h"
+
+#include <DcgmLogging.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
+namespace
+{
+/*****************************************************************************/
+void WriteName(std::ostream &out, std::string const &name)
+{
+    out << name.size() << ' ' << name;
+}
+
+/*****************************************************************************/
+bool ReadName(std::istream &in, std::string &name)
+{
+    size_t length;
+    if (!(in >> length) || in.get() != ' ' || length > DCGM_MAX_STR_LENGTH * 4)
+        return false;
+
+    name.resize(length);
+    return length == 0 || in.read(name.data(), length);
+}
+
+/*****************************************************************************/
+void WritePolicy(std::ostream &out, dcgmPolicy_t const &policy)
+{
+    out << policy.version << ' ' << policy.condition << ' ' << policy.mode << ' ' << policy.isolation << ' '
+        << policy.action << ' ' << policy.validation << ' ' << policy.response << ' ' << DCGM_POLICY_COND_MAX;
+    for (auto const &parm : policy.parms)
+    {
+        out << ' ' << parm.tag << ' ';
+        if (parm.tag == dcgmPolicyConditionParams_t::LLONG)
+            out << parm.val.llval;
+        else
+            out << parm.val.boolean;
+    }
+}
+
+/*****************************************************************************/
+/* Only the version of policies of other versions is filled in, so they can be skipped. False if malformed */
+bool ReadPolicy(std::istream &in, dcgmPolicy_t &policy)
+{
+    unsigned int condition, mode, isolation, action, validation, response, numParms;
+    if (!(in >> policy.version >> condition >> mode >> isolation >> action >> validation >> response >> numParms)
+        || numParms > DCGM_POLICY_COND_MAX * 4)
+        return false;
+
+    bool const isLatest = policy.version == dcgmPolicy_version;
+    if (isLatest && numParms != DCGM_POLICY_COND_MAX)
+        return false;
+
+    if (isLatest)
+    {
+        policy.condition  = (dcgmPolicyCondition_t)condition;
+        policy.mode       = (dcgmPolicyMode_t)mode;
+        policy.isolation  = (dcgmPolicyIsolation_t)isolation;
+        policy.action     = (dcgmPolicyAction_t)action;
+        policy.validation = (dcgmPolicyValidation_t)validation;
+        policy.response   = (dcgmPolicyFailureResp_t)response;
+    }
+
+    for (unsigned int i = 0; i < numParms; i++)
+    {
+        unsigned int tag;
+        unsigned long long value;
+        if (!(in >> tag >> value))
+            return false;
+        if (!isLatest)
+            continue;
+
+        dcgmPolicyConditionParams_t &parm = policy.parms[i];
+        if (tag == dcgmPolicyConditionParams_t::LLONG)
+        {
+            parm.tag       = dcgmPolicyConditionParams_t::LLONG;
+            parm.val.llval = value;
+        }
+        else if (tag == dcgmPolicyConditionParams_t::BOOL && value <= UINT_MAX)
+        {
+            parm.tag         = dcgmPolicyConditionParams_t::BOOL;
+            parm.val.boolean = (unsigned int)value;
+        }
+        else
+            return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+dcgmReturn_t ParseRecords(std::istream &in, DcgmStateCheckpoint &checkpoint)
+{
+    std::string record;
+    DcgmCheckpointSession *session = nullptr;
+    DcgmCheckpointGroup *group     = nullptr;
+
+    while (in >> record)
+    {
+        bool ok = true;
+
+        if (record == "gpu")
+        {
+            unsigned int gpuId;
+            std::string uuid;
+            ok = (in >> gpuId >> uuid) && gpuId < DCGM_MAX_NUM_DEVICES;
+            if (ok)
+            {
+                if (checkpoint.gpuUuids.size() <= gpuId)
+                    checkpoint.gpuUuids.resize(gpuId + 1);
+                checkpoint.gpuUuids[gpuId] = uuid;
+            }
+        }
+        else if (record == "policy")
+        {
+            DcgmCheckpointPolicy policy;
+            ok = (in >> policy.gpuId) && ReadPolicy(in, policy.policy);
+            if (ok && policy.policy.version == dcgmPolicy_version)
+            {
+                checkpoint.policies.push_back(policy);
+            }
+            else if (ok)
+            {
+                DCGM_LOG_WARNING << "Ignoring the policy of GPU " << policy.gpuId << " of version "
+                                 << policy.policy.version;
+            }
+        }
+        else if (record == "session")
+        {
+            checkpoint.sessions.emplace_back();
+            session = &checkpoint.sessions.back();
+            group   = nullptr;
+            ok      = (bool)(in >> session->token);
+        }
+        else if (record == "group" && session)
+        {
+            session->groups.emplace_back();
+            group = &session->groups.back();
+            ok    = (in >> group->groupId >> group->healthSystems) && ReadName(in, group->name);
+        }
+        else if (record == "entity" && group)
+        {
+            unsigned int entityGroupId;
+            dcgmGroupEntityPair_t entity {};
+            ok = (in >> entityGroupId >> entity.entityId) && entityGroupId < DCGM_FE_COUNT;
+            entity.entityGroupId = (dcgm_field_entity_group_t)entityGroupId;
+            group->entities.push_back(entity);
+        }
+        else if (record == "fieldgroup" && session)
+        {
+            DcgmCheckpointFieldGroup fieldGroup;
+            size_t numFieldIds = 0;
+            ok = (in >> fieldGroup.fieldGroupId >> numFieldIds)
+                 && numFieldIds <= DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP;
+            for (size_t i = 0; ok && i < numFieldIds; i++)
+            {
+                unsigned short fieldId;
+                ok = (bool)(in >> fieldId);
+                fieldGroup.fieldIds.push_back(fieldId);
+            }
+            ok = ok && ReadName(in, fieldGroup.name);
+            session->fieldGroups.push_back(std::move(fieldGroup));
+        }
+        else if (record == "watch" && session)
+        {
+            unsigned int watcherType, entityGroupId;
+            DcgmCheckpointWatch watch;
+            ok = (in >> watcherType >> entityGroupId >> watch.entityId >> watch.fieldId >> watch.monitorFrequencyUsec
+                  >> watch.maxAgeUsec >> watch.isSubscribed)
+                 && watcherType < DcgmWatcherTypeCount && entityGroupId < DCGM_FE_COUNT;
+            watch.watcherType   = (DcgmWatcherType_t)watcherType;
+            watch.entityGroupId = (dcgm_field_entity_group_t)entityGroupId;
+            session->watches.push_back(watch);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            DCGM_LOG_ERROR << "Malformed " << record << " record in state checkpoint";
+            return DCGM_ST_GENERIC_ERROR;
+        }
+    }
+
+    return DCGM_ST_OK;
+}
+} // namespace
+
+/*****************************************************************************/
+dcgmReturn_t DcgmWriteStateCheckpoint(std::string const &filename, DcgmStateCheckpoint const &checkpoint)
+{
+    std::string tmpFilename = filename + ".tmp";
+    std::ofstream out(tmpFilename, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        DCGM_LOG_ERROR << "Unable to create state checkpoint " << tmpFilename << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    out << "dcgm-state " << DCGM_STATE_CHECKPOINT_VERSION << ' ' << checkpoint.savedUsec << '\n';
+
+    for (size_t gpuId = 0; gpuId < checkpoint.gpuUuids.size(); gpuId++)
+    {
+        if (!checkpoint.gpuUuids[gpuId].empty())
+            out << "gpu " << gpuId << ' ' << checkpoint.gpuUuids[gpuId] << '\n';
+    }
+
+    for (auto const &policy : checkpoint.policies)
+    {
+        out << "policy " << policy.gpuId << ' ';
+        WritePolicy(out, policy.policy);
+        out << '\n';
+    }
+
+    for (auto const &session : checkpoint.sessions)
+    {
+        out << "session " << session.token << '\n';
+
+        for (auto const &group : session.groups)
+        {
+            out << "group " << group.groupId << ' ' << group.healthSystems << ' ';
+            WriteName(out, group.name);
+            out << '\n';
+            for (auto const &entity : group.entities)
+                out << "entity " << (unsigned int)entity.entityGroupId << ' ' << entity.entityId << '\n';
+        }
+
+        for (auto const &fieldGroup : session.fieldGroups)
+        {
+            out << "fieldgroup " << fieldGroup.fieldGroupId << ' ' << fieldGroup.fieldIds.size();
+            for (unsigned short fieldId : fieldGroup.fieldIds)
+                out << ' ' << fieldId;
+            out << ' ';
+            WriteName(out, fieldGroup.name);
+            out << '\n';
+        }
+
+        for (auto const &watch : session.watches)
+        {
+            out << "watch " << (unsigned int)watch.watcherType << ' ' << (unsigned int)watch.entityGroupId << ' '
+                << watch.entityId << ' ' << watch.fieldId << ' ' << watch.monitorFrequencyUsec << ' '
+                << watch.maxAgeUsec << ' ' << watch.isSubscribed << '\n';
+        }
+    }
+
+    out.close();
+    if (!out)
+    {
+        DCGM_LOG_ERROR << "Error writing state checkpoint " << tmpFilename;
+        unlink(tmpFilename.c_str());
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    if (rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+        DCGM_LOG_ERROR << "Unable to rename " << tmpFilename << " to " << filename << ": " << strerror(errno);
+        unlink(tmpFilename.c_str());
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmReadStateCheckpoint(std::string const &filename, DcgmStateCheckpoint &checkpoint)
+{
+    checkpoint = DcgmStateCheckpoint {};
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+    {
+        if (errno == ENOENT)
+            return DCGM_ST_NO_DATA;
+        DCGM_LOG_ERROR << "Unable to open state checkpoint " << filename << ": " << strerror(errno);
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    std::string magic;
+    unsigned int version = 0;
+    if (!(in >> magic >> version) || magic != "dcgm-state")
+    {
+        DCGM_LOG_ERROR << filename << " is not a state checkpoint";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+    if (version != DCGM_STATE_CHECKPOINT_VERSION)
+    {
+        DCGM_LOG_WARNING << "Ignoring state checkpoint " << filename << " of version " << version << ". Expected "
+                         << DCGM_STATE_CHECKPOINT_VERSION;
+        return DCGM_ST_VER_MISMATCH;
+    }
+    if (!(in >> checkpoint.savedUsec))
+    {
+        DCGM_LOG_ERROR << "Malformed header in state checkpoint " << filename;
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    dcgmReturn_t ret = ParseRecords(in, checkpoint);
+    if (ret != DCGM_ST_OK)
+        checkpoint = DcgmStateCheckpoint {};
+    return ret;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "DcgmWatcher.h"
+#include "dcgm_structs.h"
+#include "dcgm_structs_internal.h"
+#include "timelib.h"
+
+#include <string>
+#include <vector>
+
+/*****************************************************************************/
+/*
+ * State that clients set up in the hostengine, kept across hostengine
+ * restarts so that a client can take it back with dcgmSessionResume() instead
+ * of setting it up again. See DcgmHostEngineHandler::SaveStateCheckpoint().
+ *
+ * The file is text made of records separated by whitespace:
+ *
+ *   dcgm-state <version> <savedUsec>
+ *   gpu <gpuId> <uuid>
+ *   policy <gpuId> <version> <condition> <mode> <isolation> <action> <validation> <response> <numParms>
+ *          <tag> <value> for each of the numParms parms
+ *   session <token>
+ *   group <groupId> <healthSystems> <nameLength> <name>
+ *   entity <entityGroupId> <entityId>
+ *   fieldgroup <fieldGroupId> <numFieldIds> <fieldIds...> <nameLength> <name>
+ *   watch <watcherType> <entityGroupId> <entityId> <fieldId> <monitorFrequencyUsec> <maxAgeUsec> <isSubscribed>
+ *
+ * entity records belong to the group before them. group, fieldgroup and watch
+ * records belong to the session before them. Names are their length, one
+ * space and their bytes, so they can hold anything. Bump
+ * DCGM_STATE_CHECKPOINT_VERSION whenever this format changes. Files of other
+ * versions are ignored.
+ */
+#define DCGM_STATE_CHECKPOINT_VERSION 1
+
+/* An entity group of a session. See DcgmGroupManager */
+struct DcgmCheckpointGroup
+{
+    unsigned int groupId = 0;
+    std::string name;
+    std::vector<dcgmGroupEntityPair_t> entities;
+    unsigned int healthSystems = 0; /* dcgmHealthSystems_t watched on the group. 0 = none */
+};
+
+/* A field group of a session. See DcgmFieldGroupManager */
+struct DcgmCheckpointFieldGroup
+{
+    unsigned int fieldGroupId = 0;
+    std::string name;
+    std::vector<unsigned short> fieldIds;
+};
+
+/* One watcher of a session on one field. See dcgm_watch_watcher_info_t */
+struct DcgmCheckpointWatch
+{
+    DcgmWatcherType_t watcherType           = DcgmWatcherTypeClient;
+    dcgm_field_entity_group_t entityGroupId = DCGM_FE_NONE;
+    dcgm_field_eid_t entityId               = 0;
+    unsigned short fieldId                  = 0;
+    timelib64_t monitorFrequencyUsec        = 0;
+    timelib64_t maxAgeUsec                  = 0;
+    bool isSubscribed                       = false;
+};
+
+/* Everything one client connection had set up, under the token it resumes it with */
+struct DcgmCheckpointSession
+{
+    unsigned long long token = 0;
+    std::vector<DcgmCheckpointGroup> groups;
+    std::vector<DcgmCheckpointFieldGroup> fieldGroups;
+    std::vector<DcgmCheckpointWatch> watches;
+};
+
+/* The violation policy of one GPU. Policies belong to GPUs rather than to a client */
+struct DcgmCheckpointPolicy
+{
+    unsigned int gpuId = 0;
+    dcgmPolicy_t policy {};
+};
+
+struct DcgmStateCheckpoint
+{
+    timelib64_t savedUsec = 0;
+    std::vector<std::string> gpuUuids;          /* UUID of each gpuId when saved. Only GPUs whose UUID is
+                                                   unchanged are restored */
+    std::vector<DcgmCheckpointPolicy> policies; /* Of GPUs that had a policy set */
+    std::vector<DcgmCheckpointSession> sessions;
+};
+
+/*****************************************************************************/
+/*
+ * Write checkpoint to filename. It is written to a temporary file next to
+ * filename and renamed into place, so readers never see a partial file
+ *
+ * Returns: DCGM_ST_OK on success
+ *          DCGM_ST_GENERIC_ERROR if the file couldn't be written. Already logged
+ */
+dcgmReturn_t DcgmWriteStateCheckpoint(std::string const &filename, DcgmStateCheckpoint const &checkpoint);
+
+/*****************************************************************************/
+/*
+ * Read a checkpoint written by DcgmWriteStateCheckpoint()
+ *
+ * Returns: DCGM_ST_OK on success
+ *          DCGM_ST_NO_DATA if there is no such file
+ *          DCGM_ST_VER_MISMATCH if the file is of another version
+ *          DCGM_ST_GENERIC_ERROR if the file is malformed. Already logged
+ */
+dcgmReturn_t DcgmReadStateCheckpoint(std::string const &filename, DcgmStateCheckpoint &checkpoint);
@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmSummaryKernels.h"
+#include "DcgmLogging.h"
+#include "DcgmSettings.h"
+#include "dcgm_structs.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <limits>
+#include <strings.h>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace DcgmNs::SummaryKernels
+{
+namespace
+{
+template <typename T>
+constexpr T Blank(void)
+{
+    if constexpr (std::is_integral_v<T>)
+        return DCGM_INT64_BLANK;
+    else
+        return DCGM_FP64_BLANK;
+}
+
+/* Adding in unsigned keeps int64 overflow defined. It wraps the same as the vector adds */
+inline long long AddValue(long long a, long long b)
+{
+    return (long long)((unsigned long long)a + (unsigned long long)b);
+}
+
+inline double AddValue(double a, double b)
+{
+    return a + b;
+}
+
+/*****************************************************************************/
+/* Fold the count, sum, min and max of a later part of an array into totals */
+template <typename T>
+void Merge(Totals<T> &totals, Totals<T> const &part)
+{
+    if (!part.count)
+        return;
+
+    if (!totals.count)
+    {
+        totals.min = part.min;
+        totals.max = part.max;
+    }
+    else
+    {
+        if (part.min < totals.min)
+            totals.min = part.min;
+        if (part.max > totals.max)
+            totals.max = part.max;
+    }
+
+    totals.count += part.count;
+    totals.sum = AddValue(totals.sum, part.sum);
+}
+
+/*****************************************************************************/
+template <typename T>
+void SummarizeScalar(T const *values, int count, Totals<T> &totals)
+{
+    for (int i = 0; i < count; i++)
+    {
+        T value = values[i];
+        if (!(value < Blank<T>())) /* Also true for NaN */
+            continue;
+
+        if (!totals.count || value < totals.min)
+            totals.min = value;
+        if (!totals.count || value > totals.max)
+            totals.max = value;
+        totals.count++;
+        totals.sum = AddValue(totals.sum, value);
+    }
+}
+
+#if defined(__x86_64__)
+
+/*****************************************************************************/
+/* Lanes that had no non-blank values hold the identity of min and max, so every
+   lane can be reduced as long as the vector part saw at least one value */
+template <typename T, int N>
+void ReduceLanes(long long const (&counts)[N],
+                 T const (&sums)[N],
+                 T const (&mins)[N],
+                 T const (&maxs)[N],
+                 Totals<T> &totals)
+{
+    Totals<T> part;
+    for (int lane = 0; lane < N; lane++)
+        part.count += (int)counts[lane];
+    if (!part.count)
+        return;
+
+    part.min = mins[0];
+    part.max = maxs[0];
+    for (int lane = 0; lane < N; lane++)
+    {
+        part.sum = AddValue(part.sum, sums[lane]);
+        if (mins[lane] < part.min)
+            part.min = mins[lane];
+        if (maxs[lane] > part.max)
+            part.max = maxs[lane];
+    }
+    Merge(totals, part);
+}
+
+/*****************************************************************************/
+__attribute__((target("avx2"))) void SummarizeAvx2(long long const *values, int count, Totals<long long> &totals)
+{
+    __m256i const blank   = _mm256_set1_epi64x(DCGM_INT64_BLANK);
+    __m256i const highest = _mm256_set1_epi64x(LLONG_MAX);
+    __m256i const lowest  = _mm256_set1_epi64x(LLONG_MIN);
+    __m256i vCount        = _mm256_setzero_si256();
+    __m256i vSum          = _mm256_setzero_si256();
+    __m256i vMin          = highest;
+    __m256i vMax          = lowest;
+    int i                 = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i v    = _mm256_loadu_si256((__m256i const *)&values[i]);
+        __m256i used = _mm256_cmpgt_epi64(blank, v); /* All ones in lanes that aren't blank */
+
+        vCount = _mm256_sub_epi64(vCount, used);
+        vSum   = _mm256_add_epi64(vSum, _mm256_and_si256(v, used));
+
+        /* AVX2 has no 64-bit min/max. Compare and blend instead */
+        __m256i forMin = _mm256_blendv_epi8(highest, v, used);
+        __m256i forMax = _mm256_blendv_epi8(lowest, v, used);
+        vMin           = _mm256_blendv_epi8(vMin, forMin, _mm256_cmpgt_epi64(vMin, forMin));
+        vMax           = _mm256_blendv_epi8(vMax, forMax, _mm256_cmpgt_epi64(forMax, vMax));
+    }
+
+    long long counts[4], sums[4], mins[4], maxs[4];
+    _mm256_storeu_si256((__m256i *)counts, vCount);
+    _mm256_storeu_si256((__m256i *)sums, vSum);
+    _mm256_storeu_si256((__m256i *)mins, vMin);
+    _mm256_storeu_si256((__m256i *)maxs, vMax);
+    ReduceLanes(counts, sums, mins, maxs, totals);
+
+    Totals<long long> tail;
+    SummarizeScalar(&values[i], count - i, tail);
+    Merge(totals, tail);
+}
+
+/*****************************************************************************/
+__attribute__((target("avx2"))) void SummarizeAvx2(double const *values, int count, Totals<double> &totals)
+{
+    __m256d const blank   = _mm256_set1_pd(DCGM_FP64_BLANK);
+    __m256d const highest = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    __m256d const lowest  = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    __m256i vCount        = _mm256_setzero_si256();
+    __m256d vSum          = _mm256_setzero_pd();
+    __m256d vMin          = highest;
+    __m256d vMax          = lowest;
+    int i                 = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d v    = _mm256_loadu_pd(&values[i]);
+        __m256d used = _mm256_cmp_pd(v, blank, _CMP_LT_OQ); /* Ordered, so NaN lanes are not used */
+
+        vCount = _mm256_sub_epi64(vCount, _mm256_castpd_si256(used));
+        vSum   = _mm256_add_pd(vSum, _mm256_and_pd(v, used));
+        vMin   = _mm256_min_pd(vMin, _mm256_blendv_pd(highest, v, used));
+        vMax   = _mm256_max_pd(vMax, _mm256_blendv_pd(lowest, v, used));
+    }
+
+    long long counts[4];
+    double sums[4], mins[4], maxs[4];
+    _mm256_storeu_si256((__m256i *)counts, vCount);
+    _mm256_storeu_pd(sums, vSum);
+    _mm256_storeu_pd(mins, vMin);
+    _mm256_storeu_pd(maxs, vMax);
+    ReduceLanes(counts, sums, mins, maxs, totals);
+
+    Totals<double> tail;
+    SummarizeScalar(&values[i], count - i, tail);
+    Merge(totals, tail);
+}
+
+/*****************************************************************************/
+/* The tail is read with a masked load, so there is no scalar loop */
+__attribute__((target("avx512f"))) void SummarizeAvx512(long long const *values, int count, Totals<long long> &totals)
+{
+    __m512i const blank = _mm512_set1_epi64(DCGM_INT64_BLANK);
+    __m512i vSum        = _mm512_setzero_si512();
+    __m512i vMin        = _mm512_set1_epi64(LLONG_MAX);
+    __m512i vMax        = _mm512_set1_epi64(LLONG_MIN);
+    int numUsed         = 0;
+
+    for (int i = 0; i < count; i += 8)
+    {
+        __mmask8 inRange = count - i >= 8 ? (__mmask8)0xff : (__mmask8)((1u << (count - i)) - 1);
+        __m512i v        = _mm512_maskz_loadu_epi64(inRange, &values[i]);
+        __mmask8 used    = _mm512_mask_cmplt_epi64_mask(inRange, v, blank);
+
+        numUsed += __builtin_popcount(used);
+        vSum = _mm512_mask_add_epi64(vSum, used, vSum, v);
+        vMin = _mm512_mask_min_epi64(vMin, used, vMin, v);
+        vMax = _mm512_mask_max_epi64(vMax, used, vMax, v);
+    }
+
+    if (!numUsed)
+        return;
+
+    totals.count = numUsed;
+    totals.sum   = _mm512_reduce_add_epi64(vSum);
+    totals.min   = _mm512_reduce_min_epi64(vMin);
+    totals.max   = _mm512_reduce_max_epi64(vMax);
+}
+
+/*****************************************************************************/
+__attribute__((target("avx512f"))) void SummarizeAvx512(double const *values, int count, Totals<double> &totals)
+{
+    __m512d const blank = _mm512_set1_pd(DCGM_FP64_BLANK);
+    __m512d vSum        = _mm512_setzero_pd();
+    __m512d vMin        = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+    __m512d vMax        = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+    int numUsed         = 0;
+
+    for (int i = 0; i < count; i += 8)
+    {
+        __mmask8 inRange = count - i >= 8 ? (__mmask8)0xff : (__mmask8)((1u << (count - i)) - 1);
+        __m512d v        = _mm512_maskz_loadu_pd(inRange, &values[i]);
+        __mmask8 used    = _mm512_mask_cmp_pd_mask(inRange, v, blank, _CMP_LT_OQ);
+
+        numUsed += __builtin_popcount(used);
+        vSum = _mm512_mask_add_pd(vSum, used, vSum, v);
+        vMin = _mm512_mask_min_pd(vMin, used, vMin, v);
+        vMax = _mm512_mask_max_pd(vMax, used, vMax, v);
+    }
+
+    if (!numUsed)
+        return;
+
+    totals.count = numUsed;
+    totals.sum   = _mm512_reduce_add_pd(vSum);
+    totals.min   = _mm512_reduce_min_pd(vMin);
+    totals.max   = _mm512_reduce_max_pd(vMax);
+}
+
+#elif defined(__aarch64__)
+
+/*****************************************************************************/
+void SummarizeNeon(long long const *values, int count, Totals<long long> &totals)
+{
+    int64x2_t const blank   = vdupq_n_s64(DCGM_INT64_BLANK);
+    int64x2_t const highest = vdupq_n_s64(LLONG_MAX);
+    int64x2_t const lowest  = vdupq_n_s64(LLONG_MIN);
+    int64x2_t vCount        = vdupq_n_s64(0);
+    int64x2_t vSum          = vdupq_n_s64(0);
+    int64x2_t vMin          = highest;
+    int64x2_t vMax          = lowest;
+    int i                   = 0;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        int64x2_t v     = vld1q_s64(&values[i]);
+        uint64x2_t used = vcltq_s64(v, blank);
+
+        vCount = vsubq_s64(vCount, vreinterpretq_s64_u64(used));
+        vSum   = vaddq_s64(vSum, vandq_s64(v, vreinterpretq_s64_u64(used)));
+
+        int64x2_t forMin = vbslq_s64(used, v, highest);
+        int64x2_t forMax = vbslq_s64(used, v, lowest);
+        vMin             = vbslq_s64(vcltq_s64(forMin, vMin), forMin, vMin);
+        vMax             = vbslq_s64(vcgtq_s64(forMax, vMax), forMax, vMax);
+    }
+
+    Totals<long long> part;
+    part.count = (int)vaddvq_s64(vCount);
+    if (part.count)
+    {
+        part.sum = vaddvq_s64(vSum);
+        part.min = std::min(vgetq_lane_s64(vMin, 0), vgetq_lane_s64(vMin, 1));
+        part.max = std::max(vgetq_lane_s64(vMax, 0), vgetq_lane_s64(vMax, 1));
+        Merge(totals, part);
+    }
+
+    Totals<long long> tail;
+    SummarizeScalar(&values[i], count - i, tail);
+    Merge(totals, tail);
+}
+
+/*****************************************************************************/
+void SummarizeNeon(double const *values, int count, Totals<double> &totals)
+{
+    float64x2_t const blank   = vdupq_n_f64(DCGM_FP64_BLANK);
+    float64x2_t const highest = vdupq_n_f64(std::numeric_limits<double>::infinity());
+    float64x2_t const lowest  = vdupq_n_f64(-std::numeric_limits<double>::infinity());
+    int64x2_t vCount          = vdupq_n_s64(0);
+    float64x2_t vSum          = vdupq_n_f64(0);
+    float64x2_t vMin          = highest;
+    float64x2_t vMax          = lowest;
+    int i                     = 0;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        float64x2_t v   = vld1q_f64(&values[i]);
+        uint64x2_t used = vcltq_f64(v, blank); /* False for NaN */
+
+        vCount = vsubq_s64(vCount, vreinterpretq_s64_u64(used));
+        vSum   = vaddq_f64(vSum, vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(v), used)));
+        vMin   = vminq_f64(vMin, vbslq_f64(used, v, highest));
+        vMax   = vmaxq_f64(vMax, vbslq_f64(used, v, lowest));
+    }
+
+    Totals<double> part;
+    part.count = (int)vaddvq_s64(vCount);
+    if (part.count)
+    {
+        part.sum = vaddvq_f64(vSum);
+        part.min = vminvq_f64(vMin);
+        part.max = vmaxvq_f64(vMax);
+        Merge(totals, part);
+    }
+
+    Totals<double> tail;
+    SummarizeScalar(&values[i], count - i, tail);
+    Merge(totals, tail);
+}
+
+#endif
+
+/*****************************************************************************/
+template <typename T>
+void SummarizeWith(T const *values, int count, Totals<T> &totals, Isa isa)
+{
+    totals = Totals<T> {};
+    if (!values || count <= 0)
+        return;
+
+    if (!IsSupported(isa))
+        isa = Isa::Scalar;
+
+    switch (isa)
+    {
+#if defined(__x86_64__)
+        case Isa::Avx2:
+            SummarizeAvx2(values, count, totals);
+            break;
+        case Isa::Avx512:
+            SummarizeAvx512(values, count, totals);
+            break;
+#elif defined(__aarch64__)
+        case Isa::Neon:
+            SummarizeNeon(values, count, totals);
+            break;
+#endif
+        default:
+            SummarizeScalar(values, count, totals);
+            break;
+    }
+
+    if (!totals.count)
+        return;
+
+    /* Blank samples are rare, so these scans stop almost immediately */
+    for (totals.firstIndex = 0; !(values[totals.firstIndex] < Blank<T>()); totals.firstIndex++)
+        ;
+    for (totals.lastIndex = count - 1; !(values[totals.lastIndex] < Blank<T>()); totals.lastIndex--)
+        ;
+}
+
+/*****************************************************************************/
+Isa BestIsa(void)
+{
+    for (Isa isa : { Isa::Avx512, Isa::Avx2, Isa::Neon })
+    {
+        if (IsSupported(isa))
+            return isa;
+    }
+    return Isa::Scalar;
+}
+
+} // namespace
+
+/*****************************************************************************/
+Isa SelectedIsa(void)
+{
+    static Isa const selected = []() {
+        Isa isa = BestIsa();
+
+        char const *requested = getenv(DCGM_ENV_SUMMARY_KERNEL);
+        if (requested)
+        {
+            bool found = false;
+            for (Isa candidate : { Isa::Scalar, Isa::Avx2, Isa::Avx512, Isa::Neon })
+            {
+                if (strcasecmp(requested, IsaName(candidate)) != 0)
+                    continue;
+
+                found = true;
+                if (IsSupported(candidate))
+                {
+                    isa = candidate;
+                }
+                else
+                {
+                    DCGM_LOG_WARNING << DCGM_ENV_SUMMARY_KERNEL << "=" << requested
+                                     << " is not supported on this CPU. Using " << IsaName(isa);
+                }
+            }
+
+            if (!found)
+            {
+                DCGM_LOG_WARNING << "Ignoring unknown " << DCGM_ENV_SUMMARY_KERNEL << "=" << requested;
+            }
+        }
+
+        DCGM_LOG_INFO << "Using " << IsaName(isa) << " summary kernels";
+        return isa;
+    }();
+
+    return selected;
+}
+
+/*****************************************************************************/
+bool IsSupported(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::Scalar:
+            return true;
+#if defined(__x86_64__)
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::Avx512:
+            return __builtin_cpu_supports("avx512f");
+#elif defined(__aarch64__)
+        case Isa::Neon:
+            return true; /* Part of the base aarch64 ISA */
+#endif
+        default:
+            return false;
+    }
+}
+
+/*****************************************************************************/
+char const *IsaName(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::Scalar:
+            return "scalar";
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Avx512:
+            return "avx512";
+        case Isa::Neon:
+            return "neon";
+    }
+    return "unknown";
+}
+
+/*****************************************************************************/
+void Summarize(long long const *values, int count, Totals<long long> &totals, Isa isa)
+{
+    SummarizeWith(values, count, totals, isa);
+}
+
+/*****************************************************************************/
+void Summarize(double const *values, int count, Totals<double> &totals, Isa isa)
+{
+    SummarizeWith(values, count, totals, isa);
+}
+
+} // namespace DcgmNs::SummaryKernels
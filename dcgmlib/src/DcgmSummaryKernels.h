@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+/*
+ * Reductions over contiguous arrays of samples for the cache manager's
+ * summaries. Each has a scalar version and, where the CPU has them, AVX2,
+ * AVX-512 and NEON versions that are picked at runtime. Blank values
+ * (>= DCGM_INT64_BLANK or DCGM_FP64_BLANK) are masked out of every lane.
+ *
+ * Unlike DcgmcmSummaryAccumulator::Add(), a NaN double is treated as blank.
+ * The vector versions add doubles in a different order than the scalar one,
+ * so sums of doubles can differ from it in the last bits.
+ */
+namespace DcgmNs::SummaryKernels
+{
+enum class Isa
+{
+    Scalar,
+    Avx2,
+    Avx512,
+    Neon,
+};
+
+/* Reduction of the non-blank values of an array */
+template <typename T>
+struct Totals
+{
+    int count      = 0;  /* Number of non-blank values. The other fields are only set if > 0 */
+    T sum          = 0;  /* Sum of the non-blank values. int64 sums wrap like the scalar code */
+    T min          = 0;  /* Smallest non-blank value */
+    T max          = 0;  /* Largest non-blank value */
+    int firstIndex = -1; /* Index of the first non-blank value */
+    int lastIndex  = -1; /* Index of the last non-blank value */
+};
+
+/*****************************************************************************/
+/*
+ * ISA used when Summarize() isn't passed one: the widest one the CPU supports,
+ * unless DCGM_ENV_SUMMARY_KERNEL names a supported one. Decided on first call
+ */
+Isa SelectedIsa(void);
+
+/* Whether this build and CPU can run isa */
+bool IsSupported(Isa isa);
+
+/* Lowercase name of isa, as accepted by DCGM_ENV_SUMMARY_KERNEL */
+char const *IsaName(Isa isa);
+
+/*****************************************************************************/
+/*
+ * Reduce values[0..count) into totals. An isa that isn't supported runs the
+ * scalar version
+ */
+void Summarize(long long const *values, int count, Totals<long long> &totals, Isa isa = SelectedIsa());
+void Summarize(double const *values, int count, Totals<double> &totals, Isa isa = SelectedIsa());
+
+} // namespace DcgmNs::SummaryKernels
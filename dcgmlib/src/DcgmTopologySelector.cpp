@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmTopologySelector.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+unsigned int LowestGpu(std::uint64_t gpus)
+{
+    return (unsigned int)__builtin_ctzll(gpus);
+}
+
+unsigned int NumGpus(std::uint64_t gpus)
+{
+    return (unsigned int)__builtin_popcountll(gpus);
+}
+} // namespace
+
+/*****************************************************************************/
+DcgmTopologySelector::DcgmTopologySelector(dcgmTopology_t const *topology)
+{
+    if (topology == nullptr)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < topology->numElements && i < DCGM_TOPOLOGY_MAX_ELEMENTS; i++)
+    {
+        unsigned int gpuA = topology->element[i].dcgmGpuA;
+        unsigned int gpuB = topology->element[i].dcgmGpuB;
+        if (gpuA >= DCGM_MAX_NUM_DEVICES || gpuB >= DCGM_MAX_NUM_DEVICES || gpuA == gpuB)
+        {
+            continue;
+        }
+
+        unsigned int links = NvLinkCount(DCGM_TOPOLOGY_PATH_NVLINK(topology->element[i].path));
+        m_links[gpuA][gpuB] = (unsigned char)links;
+        m_links[gpuB][gpuA] = (unsigned char)links;
+    }
+}
+
+/*****************************************************************************/
+unsigned int DcgmTopologySelector::NvLinkCount(dcgmGpuTopologyLevel_t path)
+{
+    /* The NvLink levels are consecutive bits starting at DCGM_TOPOLOGY_NVLINK1 */
+    unsigned long temp = (unsigned long)path / (unsigned long)DCGM_TOPOLOGY_NVLINK1;
+    unsigned int count = 0;
+
+    while (temp > 0)
+    {
+        count++;
+        temp = temp / 2;
+    }
+
+    return count;
+}
+
+/*****************************************************************************/
+unsigned int DcgmTopologySelector::LinksTo(unsigned int gpuId, std::uint64_t gpus) const
+{
+    unsigned int links = 0;
+
+    for (; gpus != 0; gpus &= gpus - 1)
+    {
+        links += Links(gpuId, LowestGpu(gpus));
+    }
+
+    return links;
+}
+
+/*****************************************************************************/
+unsigned int DcgmTopologySelector::Score(std::uint64_t gpus) const
+{
+    unsigned int score = 0;
+
+    for (; gpus != 0; gpus &= gpus - 1)
+    {
+        score += LinksTo(LowestGpu(gpus), gpus & (gpus - 1));
+    }
+
+    return score;
+}
+
+/*****************************************************************************/
+std::uint64_t DcgmTopologySelector::SelectGreedy(std::uint64_t candidates, unsigned int numGpus) const
+{
+    std::uint64_t chosen = 0;
+
+    for (unsigned int i = 0; i < numGpus; i++)
+    {
+        /* The first GPU is the one best connected to all of the candidates */
+        std::uint64_t to      = (chosen == 0) ? candidates : chosen;
+        unsigned int bestGpu  = 0;
+        unsigned int bestGain = 0;
+        bool found            = false;
+
+        for (std::uint64_t left = candidates & ~chosen; left != 0; left &= left - 1)
+        {
+            unsigned int gpuId = LowestGpu(left);
+            unsigned int gain  = LinksTo(gpuId, to);
+            if (!found || gain > bestGain)
+            {
+                bestGpu  = gpuId;
+                bestGain = gain;
+                found    = true;
+            }
+        }
+
+        chosen |= 1ULL << bestGpu;
+    }
+
+    return chosen;
+}
+
+/*****************************************************************************/
+void DcgmTopologySelector::Extend(Search &search,
+                                  std::uint64_t chosen,
+                                  unsigned int score,
+                                  std::uint64_t remaining) const
+{
+    unsigned int need = search.numGpus - NumGpus(chosen);
+
+    if (need == 0)
+    {
+        /* Sets are visited lowest gpuIds first, so only a higher score replaces the best */
+        if (search.best == 0 || score > search.bestScore)
+        {
+            search.best      = chosen;
+            search.bestScore = score;
+        }
+        return;
+    }
+
+    if (NumGpus(remaining) < need)
+    {
+        return;
+    }
+
+    if (search.best != 0)
+    {
+        /* Most each GPU still to add can bring: its links to chosen, plus maxLinks to each of the others added */
+        unsigned int gains[DCGM_MAX_NUM_DEVICES];
+        unsigned int numGains = 0;
+
+        for (std::uint64_t left = remaining; left != 0; left &= left - 1)
+        {
+            gains[numGains++] = LinksTo(LowestGpu(left), chosen);
+        }
+
+        std::partial_sort(gains, gains + need, gains + numGains, std::greater<unsigned int>());
+
+        unsigned int bound = score + need * (need - 1) / 2 * search.maxLinks;
+        for (unsigned int i = 0; i < need; i++)
+        {
+            bound += gains[i];
+        }
+
+        if (bound <= search.bestScore)
+        {
+            return;
+        }
+    }
+
+    unsigned int gpuId = LowestGpu(remaining);
+    std::uint64_t rest = remaining & (remaining - 1);
+
+    Extend(search, chosen | (1ULL << gpuId), score + LinksTo(gpuId, chosen), rest);
+    Extend(search, chosen, score, rest);
+}
+
+/*****************************************************************************/
+std::uint64_t DcgmTopologySelector::Select(std::uint64_t candidates, unsigned int numGpus, unsigned int *score) const
+{
+    /* Links() only knows about the first DCGM_MAX_NUM_DEVICES gpuIds */
+    candidates &= (DCGM_MAX_NUM_DEVICES >= 64) ? ~0ULL : ((1ULL << DCGM_MAX_NUM_DEVICES) - 1);
+
+    if (numGpus == 0 || NumGpus(candidates) < numGpus)
+    {
+        return 0;
+    }
+
+    unsigned int minLinks = ~0U;
+    unsigned int maxLinks = 0;
+
+    for (std::uint64_t left = candidates; left != 0; left &= left - 1)
+    {
+        unsigned int gpuA = LowestGpu(left);
+        for (std::uint64_t others = left & (left - 1); others != 0; others &= others - 1)
+        {
+            unsigned int links = Links(gpuA, LowestGpu(others));
+            minLinks           = std::min(minLinks, links);
+            maxLinks           = std::max(maxLinks, links);
+        }
+    }
+
+    std::uint64_t best = 0;
+
+    if (minLinks >= maxLinks)
+    {
+        /* Every set scores the same. Take the lowest gpuIds */
+        std::uint64_t left = candidates;
+        for (unsigned int i = 0; i < numGpus; i++)
+        {
+            best |= 1ULL << LowestGpu(left);
+            left &= left - 1;
+        }
+    }
+    else if (NumGpus(candidates) <= DCGM_TOPOLOGY_EXACT_MAX_GPUS)
+    {
+        Search search { numGpus, maxLinks, 0, 0 };
+        Extend(search, 0, 0, candidates);
+        best = search.best;
+    }
+    else
+    {
+        best = SelectGreedy(candidates, numGpus);
+    }
+
+    if (score != nullptr)
+    {
+        *score = Score(best);
+    }
+
+    return best;
+}
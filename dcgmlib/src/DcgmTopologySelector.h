@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+#include "dcgm_structs_internal.h"
+#include <cstdint>
+
+/* Most candidate GPUs that are searched exhaustively. Larger sets are picked greedily */
+#define DCGM_TOPOLOGY_EXACT_MAX_GPUS 16
+
+/*****************************************************************************/
+/*
+ * NvLink counts between every pair of GPUs, taken from a dcgmTopology_t once
+ * so that picking GPUs doesn't walk the topology elements on every request.
+ *
+ * Select() finds the set of GPUs with the most NvLinks among them. Sets of
+ * GPUs are 64-bit masks of gpuIds. Candidate sets of up to
+ * DCGM_TOPOLOGY_EXACT_MAX_GPUS GPUs are searched exhaustively, with branches
+ * that can't beat the best set found so far pruned. When every pair of
+ * candidates has the same number of NvLinks, as behind NvSwitches, any set
+ * is as good as another and the lowest gpuIds are picked without a search.
+ */
+class DcgmTopologySelector
+{
+public:
+    /* No NvLinks between any GPUs */
+    DcgmTopologySelector() = default;
+
+    /* topology IN: NvLink topology of the GPUs. nullptr = no NvLinks */
+    explicit DcgmTopologySelector(dcgmTopology_t const *topology);
+
+    /*************************************************************************/
+    /*
+     * Get the number of NvLinks that a topology path says connect two GPUs
+     */
+    static unsigned int NvLinkCount(dcgmGpuTopologyLevel_t path);
+
+    /* NvLinks between gpuA and gpuB */
+    unsigned int Links(unsigned int gpuA, unsigned int gpuB) const
+    {
+        return (gpuA < DCGM_MAX_NUM_DEVICES && gpuB < DCGM_MAX_NUM_DEVICES) ? m_links[gpuA][gpuB] : 0;
+    }
+
+    /*************************************************************************/
+    /*
+     * Get the total of the NvLinks between each pair of GPUs in gpus
+     */
+    unsigned int Score(std::uint64_t gpus) const;
+
+    /*************************************************************************/
+    /*
+     * Pick the numGpus GPUs of candidates with the highest Score(). Of sets
+     * that score the same, the one whose lowest differing gpuId is lower wins.
+     *
+     * score OUT: Optional. Score() of the returned set
+     *
+     * Returns the picked GPUs
+     *         0 if candidates has fewer than numGpus GPUs or numGpus is 0
+     */
+    std::uint64_t Select(std::uint64_t candidates, unsigned int numGpus, unsigned int *score = nullptr) const;
+
+private:
+    /* Branch and bound state of one Select() */
+    struct Search
+    {
+        unsigned int numGpus;
+        unsigned int maxLinks; /* Most NvLinks between any two candidates */
+        std::uint64_t best;
+        unsigned int bestScore;
+    };
+
+    unsigned char m_links[DCGM_MAX_NUM_DEVICES][DCGM_MAX_NUM_DEVICES] {};
+
+    /* Links to the GPUs of gpus from gpuId */
+    unsigned int LinksTo(unsigned int gpuId, std::uint64_t gpus) const;
+
+    /* Add numGpus GPUs of candidates, one at a time the one that adds the most NvLinks */
+    std::uint64_t SelectGreedy(std::uint64_t candidates, unsigned int numGpus) const;
+
+    /* Try each way of adding search.numGpus - |chosen| GPUs of remaining to chosen */
+    void Extend(Search &search, std::uint64_t chosen, unsigned int score, std::uint64_t remaining) const;
+};
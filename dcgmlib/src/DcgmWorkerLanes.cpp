@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmWorkerLanes.h"
+#include "dcgm_config_structs.h"
+#include "dcgm_core_structs.h"
+
+#include <algorithm>
+#include <cstring>
+
+/*****************************************************************************/
+static DcgmWorkerLane_t ClassifyCoreCommand(unsigned int subCommand)
+{
+    switch (subCommand)
+    {
+        case DCGM_CORE_SR_GET_GPU_STATUS:
+        case DCGM_CORE_SR_HOSTENGINE_VERSION:
+        case DCGM_CORE_SR_GET_ENTITY_GROUP_ENTITIES:
+        case DCGM_CORE_SR_GROUP_GET_ALL_IDS:
+        case DCGM_CORE_SR_GROUP_GET_INFO:
+        case DCGM_CORE_SR_ENTITIES_GET_LATEST_VALUES:
+        case DCGM_CORE_SR_GET_MULTIPLE_VALUES_FOR_FIELD:
+        case DCGM_CORE_SR_GET_CACHE_MANAGER_FIELD_INFO:
+        case DCGM_CORE_SR_GET_ALL_DEVICES:
+        case DCGM_CORE_SR_FIELDGROUP_GET_INFO:
+        case DCGM_CORE_SR_GET_FIELD_SUMMARY:
+        case DCGM_CORE_SR_GET_NVLINK_STATUS:
+        case DCGM_CORE_SR_MODULE_STATUS:
+        case DCGM_CORE_SR_HOSTENGINE_HEALTH:
+        case DCGM_CORE_SR_FIELDGROUP_GET_ALL:
+        case DCGM_CORE_SR_GET_GPU_INSTANCE_HIERARCHY:
+        case DCGM_CORE_SR_GET_BUCKETED_VALUES_FOR_FIELD:
+        case DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES:
+        case DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX:
+        case DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES:
+        case DCGM_CORE_SR_GET_TRANSPORT_STATS:
+        case DCGM_CORE_SR_PROXY_GET_HOSTS:
+        case DCGM_CORE_SR_GET_REQUEST_STATS:
+            return DcgmWorkerLaneFast;
+
+        case DCGM_CORE_SR_JOB_GET_STATS:
+        case DCGM_CORE_SR_JOB_GET_PERCENTILES:
+        case DCGM_CORE_SR_JOB_GET_STATS_SINCE:
+        case DCGM_CORE_SR_PID_GET_INFO:
+        case DCGM_CORE_SR_UPDATE_ALL_FIELDS: /* Can wait on a whole update loop */
+        case DCGM_CORE_SR_MIG_ENTITY_CREATE:
+        case DCGM_CORE_SR_MIG_ENTITY_DELETE:
+        case DCGM_CORE_SR_INJECT_FIELD_VALUES: /* Can carry megabytes of values */
+            return DcgmWorkerLaneLong;
+
+        default:
+            return DcgmWorkerLaneAdmin;
+    }
+}
+
+/*****************************************************************************/
+DcgmWorkerLane_t DcgmClassifyModuleCommand(dcgm_module_command_header_t const &moduleCommand)
+{
+    switch (moduleCommand.moduleId)
+    {
+        case DcgmModuleIdCore:
+            return ClassifyCoreCommand(moduleCommand.subCommand);
+
+        case DcgmModuleIdDiag:
+            return DcgmWorkerLaneLong;
+
+        case DcgmModuleIdConfig:
+            /* Setting and enforcing configs talks to every GPU of the group */
+            return moduleCommand.subCommand == DCGM_CONFIG_SR_GET ? DcgmWorkerLaneFast : DcgmWorkerLaneLong;
+
+        default:
+            return DcgmWorkerLaneAdmin;
+    }
+}
+
+/*****************************************************************************/
+static DcgmWorkerLane_t ClassifyModuleCommandBatch(std::vector<char> const &batch)
+{
+    dcgm_msg_module_command_batch_t batchHeader;
+    if (batch.size() < sizeof(batchHeader))
+    {
+        return DcgmWorkerLaneAdmin;
+    }
+    memcpy(&batchHeader, batch.data(), sizeof(batchHeader));
+
+    DcgmWorkerLane_t lane = DcgmWorkerLaneFast;
+    size_t offset         = sizeof(batchHeader);
+    for (unsigned int i = 0; i < batchHeader.numCommands; i++)
+    {
+        dcgm_module_command_header_t moduleCommand;
+        offset += sizeof(dcgm_msg_module_command_batch_entry_t);
+        if (batch.size() < offset + sizeof(moduleCommand))
+        {
+            return DcgmWorkerLaneAdmin;
+        }
+        memcpy(&moduleCommand, batch.data() + offset, sizeof(moduleCommand));
+        if (moduleCommand.length < sizeof(moduleCommand))
+        {
+            return DcgmWorkerLaneAdmin;
+        }
+
+        lane = std::max(lane, DcgmClassifyModuleCommand(moduleCommand));
+        offset += moduleCommand.length;
+    }
+
+    return lane;
+}
+
+/*****************************************************************************/
+DcgmWorkerLane_t DcgmClassifyMessage(DcgmMessage &message)
+{
+    std::vector<char> const &msgBytes = *message.GetMsgBytesPtr();
+
+    switch (message.GetMsgType())
+    {
+        case DCGM_MSG_MODULE_COMMAND:
+        {
+            dcgm_module_command_header_t moduleCommand;
+            if (msgBytes.size() < sizeof(moduleCommand))
+            {
+                return DcgmWorkerLaneAdmin;
+            }
+            memcpy(&moduleCommand, msgBytes.data(), sizeof(moduleCommand));
+            return DcgmClassifyModuleCommand(moduleCommand);
+        }
+
+        case DCGM_MSG_MODULE_COMMAND_BATCH:
+            return ClassifyModuleCommandBatch(msgBytes);
+
+        case DCGM_MSG_FV_STREAM_ACK:
+            return DcgmWorkerLaneFast;
+
+        default:
+            return DcgmWorkerLaneAdmin;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMWORKERLANES_H
+#define DCGMWORKERLANES_H
+
+#include "DcgmProtocol.h"
+#include "dcgm_module_structs.h"
+
+/*
+ * Worker lanes the host engine processes client messages on, so that requests
+ * that keep a worker busy for seconds don't hold up cheap reads.
+ *
+ * Ordered from cheapest to most expensive. A batch of module commands goes to
+ * the most expensive lane of its commands.
+ */
+typedef enum
+{
+    DcgmWorkerLaneFast = 0, /* Reads of cached state, like latest values and entity lists */
+    DcgmWorkerLaneAdmin,    /* Everything else: watches, groups, logins, module management */
+    DcgmWorkerLaneLong,     /* Diagnostics, config enforcement, job stats and the like */
+
+    DcgmWorkerLaneCount /* Always last */
+} DcgmWorkerLane_t;
+
+/* Lane of a single module command */
+DcgmWorkerLane_t DcgmClassifyModuleCommand(dcgm_module_command_header_t const &moduleCommand);
+
+/* Lane of a message received from a client. Malformed messages go to the admin lane,
+   where processing them will report the problem */
+DcgmWorkerLane_t DcgmClassifyMessage(DcgmMessage &message);
+
+#endif /* DCGMWORKERLANES_H */
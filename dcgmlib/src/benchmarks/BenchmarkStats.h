@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef BENCHMARKSTATS_H
+#define BENCHMARKSTATS_H
+
+#include <json/json.h>
+
+#include <algorithm>
+#include <vector>
+
+/* Count, mean and percentiles of values */
+inline Json::Value Summarize(std::vector<double> values)
+{
+    Json::Value summary;
+    summary["count"] = (Json::UInt64)values.size();
+    if (values.empty())
+    {
+        return summary;
+    }
+
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (double value : values)
+    {
+        sum += value;
+    }
+    auto percentile = [&values](double p) {
+        return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+    };
+
+    summary["mean"] = sum / values.size();
+    summary["p50"]  = percentile(0.50);
+    summary["p90"]  = percentile(0.90);
+    summary["p99"]  = percentile(0.99);
+    summary["p999"] = percentile(0.999);
+    summary["max"]  = values.back();
+    return summary;
+}
+
+#endif // BENCHMARKSTATS_H
@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * dcgm_cachemanager_benchmark: measures how the cache manager scales with the
+ * number of entities, fields, watch frequencies, readers and subscribers. Every
+ * entity is a fake GPU, GPU instance or compute instance, so no GPUs are needed.
+ * Fake entities have no NVML device, so sampling them records blank values, which
+ * leaves the cost of the cache itself.
+ *
+ * The results are written as JSON so that they can be compared release to release.
+ */
+#include "BenchmarkStats.h"
+
+#include <DcgmCacheManager.h>
+#include <DcgmFvBuffer.h>
+#include <DcgmWatcher.h>
+#include <dcgm_fields.h>
+#include <timelib.h>
+
+#include <json/json.h>
+#include <tclap/CmdLine.h>
+#include <tclap/MultiArg.h>
+#include <tclap/ValueArg.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Options
+{
+    unsigned int numGpus;
+    unsigned int numInstances; /* GPU instances per GPU. Each gets one compute instance */
+    unsigned int numFields;
+    std::vector<timelib64_t> watchFreqsUsec;
+    timelib64_t durationUsec; /* How long to run the update thread for each watch frequency */
+    unsigned int historySamples;
+    unsigned int maxReaders;
+    unsigned int maxSubscribers;
+};
+
+struct Entity
+{
+    dcgm_field_entity_group_t entityGroupId;
+    dcgm_field_eid_t entityId;
+};
+
+/* The cache manager and the entities it was given */
+struct Fixture
+{
+    std::unique_ptr<DcgmCacheManager> cacheManager = std::make_unique<DcgmCacheManager>();
+    std::vector<Entity> entities;
+    std::vector<unsigned short> fieldIds;
+};
+
+/* Up to count numeric fields of GPUs, which are what the fake entities can have */
+std::vector<unsigned short> PickFieldIds(DcgmCacheManager &cacheManager, unsigned int count)
+{
+    std::vector<unsigned short> validFieldIds;
+    cacheManager.GetValidFieldIds(validFieldIds, false);
+
+    std::vector<unsigned short> fieldIds;
+    for (unsigned short fieldId : validFieldIds)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        if (fieldMeta == nullptr || fieldMeta->scope != DCGM_FS_DEVICE
+            || (fieldMeta->fieldType != DCGM_FT_INT64 && fieldMeta->fieldType != DCGM_FT_DOUBLE))
+        {
+            continue;
+        }
+        fieldIds.push_back(fieldId);
+        if (fieldIds.size() == count)
+        {
+            break;
+        }
+    }
+    return fieldIds;
+}
+
+std::unique_ptr<Fixture> MakeFixture(Options const &options)
+{
+    auto fixture = std::make_unique<Fixture>();
+
+    for (unsigned int i = 0; i < options.numGpus; i++)
+    {
+        unsigned int gpuId = fixture->cacheManager->AddFakeGpu();
+        if (gpuId == DCGM_GPU_ID_BAD)
+        {
+            std::cerr << "Only " << i << " fake GPUs could be added" << std::endl;
+            break;
+        }
+        fixture->entities.push_back({ DCGM_FE_GPU, gpuId });
+
+        for (unsigned int j = 0; j < options.numInstances; j++)
+        {
+            dcgm_field_eid_t instanceId = fixture->cacheManager->AddFakeInstance(gpuId);
+            fixture->entities.push_back({ DCGM_FE_GPU_I, instanceId });
+            fixture->entities.push_back(
+                { DCGM_FE_GPU_CI, fixture->cacheManager->AddFakeComputeInstance(instanceId) });
+        }
+    }
+
+    fixture->fieldIds = PickFieldIds(*fixture->cacheManager, options.numFields);
+    return fixture;
+}
+
+dcgmcm_sample_t MakeSample(dcgm_field_meta_p fieldMeta, timelib64_t timestamp, long long value)
+{
+    dcgmcm_sample_t sample {};
+    sample.timestamp = timestamp;
+    if (fieldMeta->fieldType == DCGM_FT_DOUBLE)
+    {
+        sample.val.d = (double)value;
+    }
+    else
+    {
+        sample.val.i64 = value;
+    }
+    return sample;
+}
+
+/*
+ * Let the update thread run for durationUsec and record how long each cycle
+ * took and how much of it was spent publishing to subscribers. Returns the
+ * runtime stats from before and after
+ */
+std::pair<dcgmcm_runtime_stats_t, dcgmcm_runtime_stats_t> RecordCycles(DcgmCacheManager &cacheManager,
+                                                                       timelib64_t durationUsec,
+                                                                       timelib64_t watchFreqUsec,
+                                                                       std::vector<double> &cycleUsec,
+                                                                       std::vector<double> &subscriberUsec)
+{
+    /* Poll often enough to see every cycle without waking the thread up ourselves */
+    timelib64_t const pollUsec = std::clamp(watchFreqUsec / 4, (timelib64_t)1000, (timelib64_t)10000);
+
+    dcgmcm_runtime_stats_t before {};
+    cacheManager.GetRuntimeStats(&before);
+    long long lastCycle = before.updateCycleFinished;
+
+    timelib64_t const start = timelib_usecSince1970();
+    while (timelib_usecSince1970() - start < durationUsec)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(pollUsec));
+        dcgmcm_runtime_stats_t stats {};
+        cacheManager.GetRuntimeStats(&stats);
+        if (stats.updateCycleFinished != lastCycle)
+        {
+            lastCycle = stats.updateCycleFinished;
+            cycleUsec.push_back((double)stats.lastCycleUsec);
+            subscriberUsec.push_back((double)stats.lastSubscriberUsec);
+        }
+    }
+
+    dcgmcm_runtime_stats_t after {};
+    cacheManager.GetRuntimeStats(&after);
+    return { before, after };
+}
+
+/*****************************************************************************/
+/*
+ * Watch every field of every entity at each frequency and let the update
+ * thread run. Reports how long a cycle takes and how much of the time the
+ * thread is awake
+ */
+Json::Value BenchUpdateCycle(Options const &options)
+{
+    Json::Value results(Json::arrayValue);
+
+    for (timelib64_t watchFreqUsec : options.watchFreqsUsec)
+    {
+        auto fixture = MakeFixture(options);
+        DcgmWatcher watcher(DcgmWatcherTypeClient);
+
+        for (Entity const &entity : fixture->entities)
+        {
+            for (unsigned short fieldId : fixture->fieldIds)
+            {
+                fixture->cacheManager->AddFieldWatch(
+                    entity.entityGroupId, entity.entityId, fieldId, watchFreqUsec, 3600.0, 0, watcher, false);
+            }
+        }
+
+        fixture->cacheManager->Start();
+        fixture->cacheManager->UpdateAllFields(1);
+
+        std::vector<double> cycleUsec;
+        std::vector<double> subscriberUsec;
+        auto const [before, after] = RecordCycles(
+            *fixture->cacheManager, options.durationUsec, watchFreqUsec, cycleUsec, subscriberUsec);
+
+        long long const cycles    = after.updateCycleFinished - before.updateCycleFinished;
+        long long const awakeUsec = after.awakeTimeUsec - before.awakeTimeUsec;
+        Json::Value result;
+        result["entities"]      = (Json::UInt64)fixture->entities.size();
+        result["fields"]        = (Json::UInt64)fixture->fieldIds.size();
+        result["watchFreqUsec"] = (Json::Int64)watchFreqUsec;
+        result["cycles"]        = (Json::Int64)cycles;
+        result["awakePercent"]  = 100.0 * awakeUsec / options.durationUsec;
+        result["cycleUsec"]     = Summarize(std::move(cycleUsec));
+        results.append(result);
+    }
+
+    return results;
+}
+
+/*****************************************************************************/
+/*
+ * Inject historySamples samples into every field of every entity in batches,
+ * as modules publishing into the cache do. Reports the append rate and the
+ * bytes each sample takes in the cache
+ */
+Json::Value BenchAppend(Options const &options)
+{
+    static constexpr unsigned int BATCH_SIZE = 100;
+
+    auto fixture = MakeFixture(options);
+    std::vector<dcgmcm_sample_t> samples(BATCH_SIZE);
+    timelib64_t const firstTimestamp = timelib_usecSince1970() - (timelib64_t)options.historySamples * 1000;
+    unsigned long long numSamples    = 0;
+    std::vector<double> batchUsec;
+
+    long long const bytesBefore = fixture->cacheManager->GetCacheBytesUsed();
+    auto const start            = std::chrono::steady_clock::now();
+
+    for (unsigned int offset = 0; offset < options.historySamples; offset += BATCH_SIZE)
+    {
+        unsigned int const count = std::min(BATCH_SIZE, options.historySamples - offset);
+        for (Entity const &entity : fixture->entities)
+        {
+            for (unsigned short fieldId : fixture->fieldIds)
+            {
+                dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+                for (unsigned int i = 0; i < count; i++)
+                {
+                    samples[i] = MakeSample(fieldMeta, firstTimestamp + (timelib64_t)(offset + i) * 1000, offset + i);
+                }
+
+                auto const batchStart = std::chrono::steady_clock::now();
+                fixture->cacheManager->InjectSamples(
+                    entity.entityGroupId, entity.entityId, fieldId, samples.data(), count);
+                batchUsec.push_back(
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - batchStart).count());
+                numSamples += count;
+            }
+        }
+    }
+
+    double const elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long const bytesAfter = fixture->cacheManager->GetCacheBytesUsed();
+
+    Json::Value result;
+    result["entities"]       = (Json::UInt64)fixture->entities.size();
+    result["fields"]         = (Json::UInt64)fixture->fieldIds.size();
+    result["samples"]        = (Json::UInt64)numSamples;
+    result["batchSize"]      = BATCH_SIZE;
+    result["samplesPerSec"]  = elapsedSec > 0 ? numSamples / elapsedSec : 0.0;
+    result["batchUsec"]      = Summarize(std::move(batchUsec));
+    result["bytesPerSample"] = numSamples > 0 ? (double)(bytesAfter - bytesBefore) / numSamples : 0.0;
+    return result;
+}
+
+/*****************************************************************************/
+/*
+ * Have 1, 2, 4... maxReaders threads read random entities and fields while
+ * another thread keeps appending. Reports the latency of GetLatestSample()
+ * and of GetSamples() of the last 100 samples
+ */
+Json::Value BenchReadLatency(Options const &options)
+{
+    static constexpr int SAMPLES_PER_READ         = 100;
+    static constexpr unsigned int READS_PER_THREAD = 20000;
+
+    auto fixture = MakeFixture(options);
+    if (fixture->entities.empty() || fixture->fieldIds.empty())
+    {
+        return Json::Value(Json::arrayValue);
+    }
+
+    /* Give every watch its history */
+    timelib64_t const now = timelib_usecSince1970();
+    for (Entity const &entity : fixture->entities)
+    {
+        for (unsigned short fieldId : fixture->fieldIds)
+        {
+            dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+            std::vector<dcgmcm_sample_t> samples;
+            for (unsigned int i = 0; i < options.historySamples; i++)
+            {
+                samples.push_back(MakeSample(fieldMeta, now - (timelib64_t)(options.historySamples - i) * 1000, i));
+            }
+            if (!samples.empty())
+            {
+                fixture->cacheManager->InjectSamples(
+                    entity.entityGroupId, entity.entityId, fieldId, samples.data(), (int)samples.size());
+            }
+        }
+    }
+
+    Json::Value results(Json::arrayValue);
+    for (unsigned int numReaders = 1; numReaders <= options.maxReaders; numReaders *= 2)
+    {
+        std::atomic<bool> stopWriter { false };
+        std::thread writer([&fixture, &stopWriter] {
+            std::mt19937 random(1);
+            long long value = 0;
+            while (!stopWriter)
+            {
+                Entity const &entity   = fixture->entities[random() % fixture->entities.size()];
+                unsigned short fieldId = fixture->fieldIds[random() % fixture->fieldIds.size()];
+                dcgmcm_sample_t sample = MakeSample(DcgmFieldGetById(fieldId), timelib_usecSince1970(), value++);
+                fixture->cacheManager->InjectSamples(entity.entityGroupId, entity.entityId, fieldId, &sample, 1);
+            }
+        });
+
+        std::vector<std::vector<double>> latestNsec(numReaders);
+        std::vector<std::vector<double>> samplesNsec(numReaders);
+        std::vector<std::thread> readers;
+        for (unsigned int reader = 0; reader < numReaders; reader++)
+        {
+            readers.emplace_back([&fixture, &latest = latestNsec[reader], &range = samplesNsec[reader], reader] {
+                std::mt19937 random(reader + 2);
+                std::vector<dcgmcm_sample_t> samples(SAMPLES_PER_READ);
+                for (unsigned int i = 0; i < READS_PER_THREAD; i++)
+                {
+                    Entity const &entity   = fixture->entities[random() % fixture->entities.size()];
+                    unsigned short fieldId = fixture->fieldIds[random() % fixture->fieldIds.size()];
+
+                    dcgmcm_sample_t sample {};
+                    auto start = std::chrono::steady_clock::now();
+                    fixture->cacheManager->GetLatestSample(
+                        entity.entityGroupId, entity.entityId, fieldId, &sample, nullptr);
+                    latest.push_back(
+                        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+
+                    int count = SAMPLES_PER_READ;
+                    start     = std::chrono::steady_clock::now();
+                    fixture->cacheManager->GetSamples(entity.entityGroupId,
+                                                      entity.entityId,
+                                                      fieldId,
+                                                      samples.data(),
+                                                      &count,
+                                                      0,
+                                                      0,
+                                                      DCGM_ORDER_DESCENDING);
+                    range.push_back(
+                        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+                }
+            });
+        }
+
+        for (std::thread &reader : readers)
+        {
+            reader.join();
+        }
+        stopWriter = true;
+        writer.join();
+
+        std::vector<double> allLatest;
+        std::vector<double> allSamples;
+        for (unsigned int reader = 0; reader < numReaders; reader++)
+        {
+            allLatest.insert(allLatest.end(), latestNsec[reader].begin(), latestNsec[reader].end());
+            allSamples.insert(allSamples.end(), samplesNsec[reader].begin(), samplesNsec[reader].end());
+        }
+
+        Json::Value result;
+        result["readers"]              = numReaders;
+        result["entities"]             = (Json::UInt64)fixture->entities.size();
+        result["fields"]               = (Json::UInt64)fixture->fieldIds.size();
+        result["historySamples"]       = options.historySamples;
+        result["getLatestSampleNsec"]  = Summarize(std::move(allLatest));
+        result["getSamplesNsec"]       = Summarize(std::move(allSamples));
+        result["getSamplesMaxSamples"] = SAMPLES_PER_READ;
+        results.append(result);
+    }
+
+    return results;
+}
+
+/*****************************************************************************/
+void CountFvs(std::shared_ptr<DcgmFvBuffer const> const &fvBuffer,
+              DcgmWatcherType_t * /* watcherTypes */,
+              int /* numWatcherTypes */,
+              void *userData)
+{
+    size_t count = 0;
+    for (dcgmBufferedFv_t const &fv : *fvBuffer)
+    {
+        count += fv.fieldId != 0;
+    }
+    *(std::atomic<size_t> *)userData += count;
+}
+
+/*
+ * Subscribe every field of every entity for updates and register 0, 1, 2, 4...
+ * maxSubscribers callbacks that walk the snapshot like modules do. Reports how
+ * long each update cycle spends publishing to them
+ */
+Json::Value BenchSubscriberFanout(Options const &options)
+{
+    static constexpr timelib64_t WATCH_FREQ_USEC = 100000;
+
+    Json::Value results(Json::arrayValue);
+    for (unsigned int numSubscribers = 0; numSubscribers <= options.maxSubscribers;
+         numSubscribers = numSubscribers == 0 ? 1 : numSubscribers * 2)
+    {
+        auto fixture = MakeFixture(options);
+        std::atomic<size_t> fvsSeen { 0 };
+
+        for (unsigned int i = 0; i < numSubscribers; i++)
+        {
+            dcgmcmEventSubscription_t subscription {};
+            subscription.type     = DcgmcmEventTypeFvUpdate;
+            subscription.fn.fvCb  = CountFvs;
+            subscription.userData = &fvsSeen;
+            fixture->cacheManager->SubscribeForEvent(subscription);
+        }
+
+        DcgmWatcher watcher(DcgmWatcherTypeClient);
+        for (Entity const &entity : fixture->entities)
+        {
+            for (unsigned short fieldId : fixture->fieldIds)
+            {
+                fixture->cacheManager->AddFieldWatch(
+                    entity.entityGroupId, entity.entityId, fieldId, WATCH_FREQ_USEC, 3600.0, 0, watcher, true);
+            }
+        }
+
+        fixture->cacheManager->Start();
+        fixture->cacheManager->UpdateAllFields(1);
+
+        std::vector<double> cycleUsec;
+        std::vector<double> subscriberUsec;
+        RecordCycles(*fixture->cacheManager, options.durationUsec, WATCH_FREQ_USEC, cycleUsec, subscriberUsec);
+
+        Json::Value result;
+        result["subscribers"]    = numSubscribers;
+        result["entities"]       = (Json::UInt64)fixture->entities.size();
+        result["fields"]         = (Json::UInt64)fixture->fieldIds.size();
+        result["fvsDelivered"]   = (Json::UInt64)fvsSeen.load();
+        result["subscriberUsec"] = Summarize(std::move(subscriberUsec));
+        result["cycleUsec"]      = Summarize(std::move(cycleUsec));
+        results.append(result);
+    }
+
+    return results;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options {};
+    std::string outputFile;
+
+    try
+    {
+        TCLAP::CmdLine cmdLine("Benchmarks the DCGM cache manager with fake GPUs and prints the results as JSON", ' ');
+
+        TCLAP::ValueArg<unsigned int> gpusArg("g", "gpus", "Number of fake GPUs", false, 8, "N", cmdLine);
+        TCLAP::ValueArg<unsigned int> instancesArg(
+            "i", "instances", "GPU instances per GPU, each with a compute instance", false, 0, "N", cmdLine);
+        TCLAP::ValueArg<unsigned int> fieldsArg("f", "fields", "Fields per entity", false, 32, "N", cmdLine);
+        TCLAP::MultiArg<long long> freqArg("w",
+                                           "watch-freq",
+                                           "Watch frequency in usec. Can be repeated. Default 1000000 and 100000",
+                                           false,
+                                           "USEC",
+                                           cmdLine);
+        TCLAP::ValueArg<unsigned int> durationArg(
+            "d", "duration", "How long to run each update benchmark in ms", false, 2000, "MS", cmdLine);
+        TCLAP::ValueArg<unsigned int> historyArg(
+            "s", "samples", "Samples appended to each field of each entity", false, 1000, "N", cmdLine);
+        TCLAP::ValueArg<unsigned int> readersArg("r", "readers", "Most concurrent readers", false, 8, "N", cmdLine);
+        TCLAP::ValueArg<unsigned int> subscribersArg(
+            "u", "subscribers", "Most update subscribers", false, 8, "N", cmdLine);
+        TCLAP::ValueArg<std::string> outputArg(
+            "o", "output", "File to write the JSON to instead of stdout", false, "", "FILE", cmdLine);
+
+        cmdLine.parse(argc, argv);
+
+        options.numGpus        = gpusArg.getValue();
+        options.numInstances   = instancesArg.getValue();
+        options.numFields      = fieldsArg.getValue();
+        options.durationUsec   = (timelib64_t)durationArg.getValue() * 1000;
+        options.historySamples = historyArg.getValue();
+        options.maxReaders     = std::max(1u, readersArg.getValue());
+        options.maxSubscribers = subscribersArg.getValue();
+        outputFile             = outputArg.getValue();
+        for (long long freq : freqArg.getValue())
+        {
+            options.watchFreqsUsec.push_back(std::max(1000LL, freq));
+        }
+        if (options.watchFreqsUsec.empty())
+        {
+            options.watchFreqsUsec = { 1000000, 100000 };
+        }
+    }
+    catch (TCLAP::ArgException const &ex)
+    {
+        std::cerr << "Argument parsing error: " << ex.error() << " for argument " << ex.argId() << std::endl;
+        return 1;
+    }
+
+    DcgmFieldsInit();
+
+    Json::Value report;
+    report["config"]["gpus"]            = options.numGpus;
+    report["config"]["instancesPerGpu"] = options.numInstances;
+    report["config"]["fields"]          = options.numFields;
+    report["config"]["durationUsec"]    = (Json::Int64)options.durationUsec;
+    report["config"]["samples"]         = options.historySamples;
+    report["updateCycle"]               = BenchUpdateCycle(options);
+    report["append"]                    = BenchAppend(options);
+    report["readLatency"]               = BenchReadLatency(options);
+    report["subscriberFanout"]          = BenchSubscriberFanout(options);
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+
+    if (outputFile.empty())
+    {
+        writer->write(report, &std::cout);
+        std::cout << std::endl;
+        return 0;
+    }
+
+    std::ofstream output(outputFile);
+    writer->write(report, &output);
+    output << std::endl;
+    if (!output)
+    {
+        std::cerr << "Error: unable to write " << outputFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
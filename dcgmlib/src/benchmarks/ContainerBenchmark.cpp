@@ -0,0 +1,604 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * dcgm_container_benchmark: microbenchmarks of the C containers that hold every
+ * cached sample: timeseries (keyedvector, ring and compressed storage),
+ * keyedvector and hashtable.
+ *
+ * For each container, value type and size, the time per element of these is
+ * reported:
+ *   insert   Insert size elements in key order into an empty container
+ *   find     Look up each element by key in random order
+ *   iterate  Walk every element in order
+ *   quota    At size elements, insert one and remove the oldest, as the cache
+ *            manager's quota enforcement does on every sample of a full watch
+ *   destroy  Free a container of size elements
+ *
+ * Strings are 32 characters and blobs 256 bytes. Keyedvectors hold
+ * 16-byte elements and hashtables int64 keys.
+ *
+ * The results are written as JSON. Pass the results of a previous run with
+ * --baseline to have every time that is more than --tolerance percent slower
+ * than its baseline listed under "regressions" and the exit code be 2. A
+ * replacement container has to pass that against the current ones before the
+ * cache manager adopts it. A run at the default sizes takes a few minutes.
+ */
+#include "BenchmarkStats.h"
+
+#include <hashtable.h>
+#include <keyedvector.h>
+#include <timeseries.h>
+
+#include <json/json.h>
+#include <tclap/CmdLine.h>
+#include <tclap/MultiArg.h>
+#include <tclap/ValueArg.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+char const *const OP_NAMES[] = { "insert", "find", "iterate", "quota", "destroy" };
+enum Op
+{
+    OP_INSERT = 0,
+    OP_FIND,
+    OP_ITERATE,
+    OP_QUOTA,
+    OP_DESTROY,
+    OP_COUNT
+};
+
+constexpr size_t STRING_LENGTH = 32;
+constexpr size_t BLOB_SIZE     = 256;
+
+/* Each timed sample covers at least this many elements, repeating the run on small containers */
+constexpr size_t MIN_ELEMENTS_PER_SAMPLE = 100000;
+
+struct Options
+{
+    std::vector<int> sizes;
+    unsigned int samples; /* Timed samples of each op. Their median is compared to the baseline */
+};
+
+/* Nanoseconds per element of each op, one entry per sample */
+using OpTimes = std::array<std::vector<double>, OP_COUNT>;
+
+/* Accumulates the time of each op over the repetitions of one sample */
+struct SampleTimer
+{
+    std::array<Clock::duration, OP_COUNT> elapsed {};
+    Clock::time_point start;
+
+    void Start()
+    {
+        start = Clock::now();
+    }
+
+    void Stop(Op op)
+    {
+        elapsed[op] += Clock::now() - start;
+    }
+
+    void AddTo(OpTimes &times, size_t numElements) const
+    {
+        for (int op = 0; op < OP_COUNT; op++)
+        {
+            times[op].push_back(std::chrono::duration<double, std::nano>(elapsed[op]).count() / numElements);
+        }
+    }
+};
+
+/* Keys 0..size-1 in a random order that is the same for every container */
+std::vector<int> ShuffledIndices(int size)
+{
+    std::vector<int> indices(size);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::shuffle(indices.begin(), indices.end(), std::mt19937(1));
+    return indices;
+}
+
+/*****************************************************************************/
+/* Timeseries */
+
+enum class Storage
+{
+    KeyedVector,
+    Ring,
+    Compressed
+};
+
+char const *TsTypeName(int tsType)
+{
+    switch (tsType)
+    {
+        case TS_TYPE_INT64:
+            return "int64";
+        case TS_TYPE_DOUBLE:
+            return "double";
+        case TS_TYPE_STRING:
+            return "string";
+        default:
+            return "blob";
+    }
+}
+
+/* Rings are sized for size samples, as the cache manager sizes them for the samples a watch keeps */
+timeseries_p AllocTimeseries(Storage storage, int tsType, int size)
+{
+    int errorSt = 0;
+    switch (storage)
+    {
+        case Storage::Ring:
+            return timeseries_alloc_ring(tsType, size, &errorSt);
+        case Storage::Compressed:
+            return timeseries_alloc_compressed(tsType, &errorSt);
+        default:
+            return timeseries_alloc(tsType, &errorSt);
+    }
+}
+
+/* Timestamps are 1 ms apart like a fast watch */
+timelib64_t Timestamp(long long index)
+{
+    return 1000000000000000LL + index * 1000;
+}
+
+void InsertSample(timeseries_p ts, int tsType, long long index, char *string, char *blob)
+{
+    switch (tsType)
+    {
+        case TS_TYPE_INT64:
+            timeseries_insert_int64(ts, Timestamp(index), index, 0);
+            break;
+        case TS_TYPE_DOUBLE:
+            timeseries_insert_double(ts, Timestamp(index), (double)index, 0.0);
+            break;
+        case TS_TYPE_STRING:
+            string[index % STRING_LENGTH] = 'a' + index % 26;
+            timeseries_insert_string(ts, Timestamp(index), string);
+            break;
+        default:
+            memcpy(blob, &index, sizeof(index));
+            timeseries_insert_blob(ts, Timestamp(index), blob, BLOB_SIZE);
+            break;
+    }
+}
+
+OpTimes BenchTimeseries(Storage storage, int tsType, int size, Options const &options)
+{
+    std::vector<int> const lookups = ShuffledIndices(size);
+    size_t const reps              = std::max((size_t)1, MIN_ELEMENTS_PER_SAMPLE / size);
+    std::string string(STRING_LENGTH, 'x');
+    std::vector<char> blob(BLOB_SIZE, 'x');
+    long long found = 0;
+    OpTimes times;
+
+    for (unsigned int sample = 0; sample < options.samples; sample++)
+    {
+        SampleTimer timer;
+        for (size_t rep = 0; rep < reps; rep++)
+        {
+            timeseries_p ts = AllocTimeseries(storage, tsType, size);
+            if (ts == nullptr)
+            {
+                std::cerr << "Error: unable to allocate a timeseries of type " << TsTypeName(tsType) << std::endl;
+                return {};
+            }
+
+            timer.Start();
+            for (int i = 0; i < size; i++)
+            {
+                InsertSample(ts, tsType, i, string.data(), blob.data());
+            }
+            timer.Stop(OP_INSERT);
+
+            timeseries_cursor_t cursor {};
+            timer.Start();
+            for (int index : lookups)
+            {
+                found += timeseries_find(ts, Timestamp(index), TS_LGE_EQUAL, &cursor) != nullptr;
+            }
+            timer.Stop(OP_FIND);
+
+            timer.Start();
+            for (timeseries_entry_p entry = timeseries_first(ts, &cursor); entry != nullptr;
+                 entry                    = timeseries_next(ts, &cursor))
+            {
+                found += entry->usecSince1970 != 0;
+            }
+            timer.Stop(OP_ITERATE);
+
+            timer.Start();
+            for (int i = 0; i < size; i++)
+            {
+                InsertSample(ts, tsType, size + i, string.data(), blob.data());
+                timeseries_enforce_quota(ts, 0, size);
+            }
+            timer.Stop(OP_QUOTA);
+
+            timer.Start();
+            timeseries_destroy(ts);
+            timer.Stop(OP_DESTROY);
+        }
+        timer.AddTo(times, reps * size);
+    }
+
+    if (found != (long long)(options.samples * reps * size * 2))
+    {
+        std::cerr << "Warning: timeseries lookups found " << found << " entries" << std::endl;
+    }
+    return times;
+}
+
+/*****************************************************************************/
+/* Keyedvector */
+
+struct KvElement
+{
+    long long key;
+    long long value;
+};
+
+int KvCompare(void *elem1, void *elem2)
+{
+    long long const key1 = ((KvElement *)elem1)->key;
+    long long const key2 = ((KvElement *)elem2)->key;
+    return key1 < key2 ? -1 : key1 > key2 ? 1 : 0;
+}
+
+/* Keys are never inserted twice */
+int KvMerge(void * /* current */, void * /* inserting */, void * /* user */)
+{
+    return KV_ST_DUPLICATE;
+}
+
+OpTimes BenchKeyedVector(int size, Options const &options)
+{
+    std::vector<int> const lookups = ShuffledIndices(size);
+    size_t const reps              = std::max((size_t)1, MIN_ELEMENTS_PER_SAMPLE / size);
+    long long found                = 0;
+    OpTimes times;
+
+    for (unsigned int sample = 0; sample < options.samples; sample++)
+    {
+        SampleTimer timer;
+        for (size_t rep = 0; rep < reps; rep++)
+        {
+            int errorSt      = 0;
+            keyedvector_p kv = keyedvector_alloc(sizeof(KvElement), 0, KvCompare, KvMerge, nullptr, nullptr, &errorSt);
+            if (kv == nullptr)
+            {
+                std::cerr << "Error: unable to allocate a keyedvector: " << errorSt << std::endl;
+                return {};
+            }
+            kv_cursor_t cursor {};
+
+            timer.Start();
+            for (int i = 0; i < size; i++)
+            {
+                KvElement element { i, i };
+                keyedvector_insert(kv, &element, &cursor);
+            }
+            timer.Stop(OP_INSERT);
+
+            timer.Start();
+            for (int index : lookups)
+            {
+                KvElement key { index, 0 };
+                found += keyedvector_find_by_key(kv, &key, KV_LGE_EQUAL, &cursor) != nullptr;
+            }
+            timer.Stop(OP_FIND);
+
+            timer.Start();
+            for (void *element = keyedvector_first(kv, &cursor); element != nullptr;
+                 element       = keyedvector_next(kv, &cursor))
+            {
+                found += ((KvElement *)element)->value >= 0;
+            }
+            timer.Stop(OP_ITERATE);
+
+            timer.Start();
+            for (int i = 0; i < size; i++)
+            {
+                KvElement element { size + i, i };
+                keyedvector_insert(kv, &element, &cursor);
+                keyedvector_remove_first(kv, 1);
+            }
+            timer.Stop(OP_QUOTA);
+
+            timer.Start();
+            keyedvector_destroy(kv);
+            timer.Stop(OP_DESTROY);
+        }
+        timer.AddTo(times, reps * size);
+    }
+
+    if (found != (long long)(options.samples * reps * size * 2))
+    {
+        std::cerr << "Warning: keyedvector lookups found " << found << " elements" << std::endl;
+    }
+    return times;
+}
+
+/*****************************************************************************/
+/* Hashtable */
+
+unsigned int HashKey(void const *key)
+{
+    unsigned long long const value = *(long long const *)key;
+    return (unsigned int)((value ^ (value >> 32)) * 2654435761U);
+}
+
+int KeysEqual(void const *key1, void const *key2)
+{
+    return *(long long const *)key1 == *(long long const *)key2;
+}
+
+OpTimes BenchHashtable(int size, Options const &options)
+{
+    std::vector<int> const lookups = ShuffledIndices(size);
+    size_t const reps              = std::max((size_t)1, MIN_ELEMENTS_PER_SAMPLE / size);
+    std::vector<long long> keys(2 * (size_t)size);
+    std::iota(keys.begin(), keys.end(), 0);
+    long long found = 0;
+    OpTimes times;
+
+    for (unsigned int sample = 0; sample < options.samples; sample++)
+    {
+        SampleTimer timer;
+        for (size_t rep = 0; rep < reps; rep++)
+        {
+            hashtable_t *hashTable = hashtable_create(HashKey, KeysEqual, nullptr, nullptr);
+            if (hashTable == nullptr)
+            {
+                std::cerr << "Error: unable to allocate a hashtable" << std::endl;
+                return {};
+            }
+
+            timer.Start();
+            for (int i = 0; i < size; i++)
+            {
+                hashtable_set(hashTable, &keys[i], &keys[i]);
+            }
+            timer.Stop(OP_INSERT);
+
+            timer.Start();
+            for (int index : lookups)
+            {
+                found += hashtable_get(hashTable, &keys[index]) != nullptr;
+            }
+            timer.Stop(OP_FIND);
+
+            timer.Start();
+            for (void *iter = hashtable_iter(hashTable); iter != nullptr; iter = hashtable_iter_next(hashTable, iter))
+            {
+                found += hashtable_iter_value(iter) != nullptr;
+            }
+            timer.Stop(OP_ITERATE);
+
+            timer.Start();
+            for (int i = 0; i < size; i++)
+            {
+                hashtable_set(hashTable, &keys[size + i], &keys[size + i]);
+                hashtable_del(hashTable, &keys[i]);
+            }
+            timer.Stop(OP_QUOTA);
+
+            timer.Start();
+            hashtable_destroy(hashTable);
+            timer.Stop(OP_DESTROY);
+        }
+        timer.AddTo(times, reps * size);
+    }
+
+    if (found != (long long)(options.samples * reps * size * 2))
+    {
+        std::cerr << "Warning: hashtable lookups found " << found << " entries" << std::endl;
+    }
+    return times;
+}
+
+/*****************************************************************************/
+std::string ResultKey(Json::Value const &result)
+{
+    return result["container"].asString() + "/" + result["type"].asString() + "/" + result["op"].asString() + "/"
+           + result["size"].asString();
+}
+
+void AddResults(Json::Value &results, char const *container, char const *type, int size, OpTimes times)
+{
+    for (int op = 0; op < OP_COUNT; op++)
+    {
+        Json::Value result;
+        result["container"] = container;
+        result["type"]      = type;
+        result["op"]        = OP_NAMES[op];
+        result["size"]      = size;
+        result["nsPerElem"] = Summarize(std::move(times[op]));
+        results.append(result);
+    }
+}
+
+/*
+ * Compare the median of every result to the one with the same key in baseline.
+ * Returns those slower by more than tolerancePercent
+ */
+Json::Value FindRegressions(Json::Value const &results, Json::Value const &baseline, double tolerancePercent)
+{
+    std::unordered_map<std::string, double> baselineMedians;
+    for (Json::Value const &result : baseline["results"])
+    {
+        baselineMedians[ResultKey(result)] = result["nsPerElem"]["p50"].asDouble();
+    }
+
+    Json::Value regressions(Json::arrayValue);
+    for (Json::Value const &result : results)
+    {
+        auto const it       = baselineMedians.find(ResultKey(result));
+        double const median = result["nsPerElem"]["p50"].asDouble();
+        if (it == baselineMedians.end() || median <= it->second * (1.0 + tolerancePercent / 100.0))
+        {
+            continue;
+        }
+
+        Json::Value regression;
+        regression["key"]               = ResultKey(result);
+        regression["baselineNsPerElem"] = it->second;
+        regression["nsPerElem"]         = median;
+        regressions.append(regression);
+    }
+    return regressions;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options {};
+    std::string outputFile;
+    std::string baselineFile;
+    double tolerancePercent = 0;
+
+    try
+    {
+        TCLAP::CmdLine cmdLine("Benchmarks the timeseries, keyedvector and hashtable containers and prints the "
+                               "results as JSON",
+                               ' ');
+
+        TCLAP::MultiArg<int> sizeArg("s",
+                                     "size",
+                                     "Elements per container. Can be repeated. Default 10, 1000, 100000 and 1000000",
+                                     false,
+                                     "N",
+                                     cmdLine);
+        TCLAP::ValueArg<unsigned int> samplesArg("n", "samples", "Timed samples of each op", false, 5, "N", cmdLine);
+        TCLAP::ValueArg<std::string> baselineArg(
+            "b", "baseline", "Results of a previous run to compare against", false, "", "FILE", cmdLine);
+        TCLAP::ValueArg<double> toleranceArg(
+            "t", "tolerance", "Percent slower than the baseline that is a regression", false, 10.0, "PERCENT", cmdLine);
+        TCLAP::ValueArg<std::string> outputArg(
+            "o", "output", "File to write the JSON to instead of stdout", false, "", "FILE", cmdLine);
+
+        cmdLine.parse(argc, argv);
+
+        for (int size : sizeArg.getValue())
+        {
+            options.sizes.push_back(std::max(1, size));
+        }
+        if (options.sizes.empty())
+        {
+            options.sizes = { 10, 1000, 100000, 1000000 };
+        }
+        options.samples  = std::max(1u, samplesArg.getValue());
+        baselineFile     = baselineArg.getValue();
+        tolerancePercent = toleranceArg.getValue();
+        outputFile       = outputArg.getValue();
+    }
+    catch (TCLAP::ArgException const &ex)
+    {
+        std::cerr << "Argument parsing error: " << ex.error() << " for argument " << ex.argId() << std::endl;
+        return 1;
+    }
+
+    Json::Value baseline;
+    if (!baselineFile.empty())
+    {
+        std::ifstream input(baselineFile);
+        Json::CharReaderBuilder readerBuilder;
+        std::string errors;
+        if (!Json::parseFromStream(readerBuilder, input, &baseline, &errors))
+        {
+            std::cerr << "Error: unable to read the baseline " << baselineFile << ": " << errors << std::endl;
+            return 1;
+        }
+    }
+
+    Json::Value results(Json::arrayValue);
+    for (int size : options.sizes)
+    {
+        for (int tsType : { TS_TYPE_INT64, TS_TYPE_DOUBLE, TS_TYPE_STRING, TS_TYPE_BLOB })
+        {
+            AddResults(results,
+                       "timeseries_keyedvector",
+                       TsTypeName(tsType),
+                       size,
+                       BenchTimeseries(Storage::KeyedVector, tsType, size, options));
+        }
+        for (int tsType : { TS_TYPE_INT64, TS_TYPE_DOUBLE })
+        {
+            AddResults(results,
+                       "timeseries_ring",
+                       TsTypeName(tsType),
+                       size,
+                       BenchTimeseries(Storage::Ring, tsType, size, options));
+            AddResults(results,
+                       "timeseries_compressed",
+                       TsTypeName(tsType),
+                       size,
+                       BenchTimeseries(Storage::Compressed, tsType, size, options));
+        }
+        AddResults(results, "keyedvector", "int64", size, BenchKeyedVector(size, options));
+        AddResults(results, "hashtable", "int64", size, BenchHashtable(size, options));
+    }
+
+    Json::Value report;
+    report["config"]["samples"]      = options.samples;
+    report["config"]["stringLength"] = (Json::UInt64)STRING_LENGTH;
+    report["config"]["blobSize"]     = (Json::UInt64)BLOB_SIZE;
+    report["results"]                = results;
+
+    bool regressed = false;
+    if (!baselineFile.empty())
+    {
+        report["baseline"]    = baselineFile;
+        report["regressions"] = FindRegressions(results, baseline, tolerancePercent);
+        regressed             = !report["regressions"].empty();
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+
+    if (outputFile.empty())
+    {
+        writer->write(report, &std::cout);
+        std::cout << std::endl;
+        return regressed ? 2 : 0;
+    }
+
+    std::ofstream output(outputFile);
+    writer->write(report, &output);
+    output << std::endl;
+    if (!output)
+    {
+        std::cerr << "Error: unable to write " << outputFile << std::endl;
+        return 1;
+    }
+    return regressed ? 2 : 0;
+}
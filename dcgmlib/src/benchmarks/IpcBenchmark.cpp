@@ -0,0 +1,582 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * dcgm_ipc_benchmark: measures the request throughput and latency of a running
+ * host engine. K connections each run a thread that issues a weighted mix of
+ * requests back to back for a while. This is repeated for every connection count
+ * over every transport (TCP, unix socket and shared memory over the unix socket).
+ *
+ * The requests target fake GPUs that are created on the host engine with
+ * injected history, so no GPUs are needed. The fake GPUs outlive the run, as
+ * there is no way to remove them.
+ *
+ * The results are written as JSON so that they can be compared release to release.
+ */
+#include "BenchmarkStats.h"
+
+#include <dcgm_agent.h>
+#include <dcgm_fields.h>
+#include <dcgm_structs.h>
+#include <dcgm_test_apis.h>
+
+#include <json/json.h>
+#include <tclap/CmdLine.h>
+#include <tclap/MultiArg.h>
+#include <tclap/ValueArg.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+enum OpType
+{
+    OP_LATEST = 0, /* dcgmEntitiesGetLatestValues of every field of every fake GPU */
+    OP_SINCE,      /* dcgmGetValuesSince_v2 of the group and field group since the first injected sample */
+    OP_GROUP,      /* dcgmGroupCreate, dcgmGroupAddEntity and dcgmGroupDestroy. Three requests */
+    OP_HEALTH,     /* dcgmHealthCheck of the group */
+    OP_COUNT
+};
+
+char const *const OP_NAMES[OP_COUNT] = { "latest", "since", "group", "health" };
+
+/* Numeric GPU fields to watch and read, in the order they are picked */
+unsigned short const BENCH_FIELD_IDS[] = { DCGM_FI_DEV_GPU_TEMP,
+                                           DCGM_FI_DEV_POWER_USAGE,
+                                           DCGM_FI_DEV_SM_CLOCK,
+                                           DCGM_FI_DEV_MEM_CLOCK,
+                                           DCGM_FI_DEV_GPU_UTIL,
+                                           DCGM_FI_DEV_MEM_COPY_UTIL,
+                                           DCGM_FI_DEV_FB_USED,
+                                           DCGM_FI_DEV_FB_FREE,
+                                           DCGM_FI_DEV_MEMORY_TEMP,
+                                           DCGM_FI_DEV_ENC_UTIL,
+                                           DCGM_FI_DEV_DEC_UTIL,
+                                           DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
+                                           DCGM_FI_DEV_XID_ERRORS,
+                                           DCGM_FI_DEV_ECC_SBE_VOL_TOTAL,
+                                           DCGM_FI_DEV_ECC_DBE_VOL_TOTAL,
+                                           DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION };
+
+struct Options
+{
+    std::string tcpAddress;
+    std::string socketPath;
+    std::vector<std::string> transports; /* tcp, unix or shm */
+    std::vector<unsigned int> connectionCounts;
+    std::array<unsigned int, OP_COUNT> weights;
+    long long durationUsec; /* How long to run each transport and connection count */
+    unsigned int numGpus;
+    unsigned int numFields;
+    unsigned int historySamples;
+};
+
+/* What the requests are about. Each worker has a copy since the APIs take non-const arrays */
+struct Target
+{
+    std::vector<dcgmGroupEntityPair_t> entities;
+    std::vector<unsigned short> fieldIds;
+    dcgmGpuGrp_t groupId        = 0;
+    dcgmFieldGrp_t fieldGroupId = 0;
+    long long sinceTimestamp    = 0;
+};
+
+/* What one connection's thread saw */
+struct WorkerResult
+{
+    dcgmReturn_t connectRet = DCGM_ST_OK;
+    std::array<std::vector<double>, OP_COUNT> latencyUsec;
+    std::array<unsigned long long, OP_COUNT> errors {};
+};
+
+/* Parse weights like latest=4,since=2,group=1,health=1. Ops that aren't named get 0 */
+bool ParseMix(std::string const &mix, std::array<unsigned int, OP_COUNT> &weights)
+{
+    weights.fill(0);
+    std::istringstream stream(mix);
+    std::string entry;
+    unsigned int total = 0;
+
+    while (std::getline(stream, entry, ','))
+    {
+        size_t const equals    = entry.find('=');
+        std::string const name = entry.substr(0, equals);
+        char *end              = nullptr;
+        unsigned long weight   = equals == std::string::npos ? 1 : strtoul(entry.c_str() + equals + 1, &end, 10);
+        if (end != nullptr && (*end != '\0' || end == entry.c_str() + equals + 1))
+        {
+            return false;
+        }
+
+        unsigned int op = 0;
+        while (op < OP_COUNT && name != OP_NAMES[op])
+        {
+            op++;
+        }
+        if (op == OP_COUNT)
+        {
+            return false;
+        }
+        weights[op] = (unsigned int)weight;
+        total += (unsigned int)weight;
+    }
+
+    return total > 0;
+}
+
+dcgmReturn_t Connect(Options const &options, std::string const &transport, dcgmHandle_t &handle)
+{
+    dcgmConnectV2Params_t params {};
+    params.version             = dcgmConnectV2Params_version;
+    params.timeoutMs           = 5000;
+    params.addressIsUnixSocket = transport != "tcp";
+    params.useSharedMemory     = transport == "shm";
+
+    std::string const &address = params.addressIsUnixSocket ? options.socketPath : options.tcpAddress;
+    return dcgmConnect_v2(address.c_str(), &params, &handle);
+}
+
+int CountValues(dcgm_field_entity_group_t /* entityGroupId */,
+                dcgm_field_eid_t /* entityId */,
+                dcgmFieldValue_v1 * /* values */,
+                int numValues,
+                void *userData)
+{
+    *(size_t *)userData += numValues;
+    return 0;
+}
+
+/*****************************************************************************/
+/*
+ * Create the fake GPUs, a group of them and a field group, watch the fields and
+ * inject historySamples samples into each. Health watches are set if the host
+ * engine allows it; health requests fail otherwise
+ */
+dcgmReturn_t Setup(dcgmHandle_t handle, Options const &options, Target &target)
+{
+    dcgmCreateFakeEntities_t fakeEntities {};
+    fakeEntities.version     = dcgmCreateFakeEntities_version;
+    fakeEntities.numToCreate = std::min(options.numGpus, (unsigned int)DCGM_MAX_HIERARCHY_INFO);
+    for (unsigned int i = 0; i < fakeEntities.numToCreate; i++)
+    {
+        fakeEntities.entityList[i].entity.entityGroupId = DCGM_FE_GPU;
+    }
+
+    dcgmReturn_t ret = dcgmCreateFakeEntities(handle, &fakeEntities);
+    if (ret != DCGM_ST_OK)
+    {
+        std::cerr << "Error: unable to create fake GPUs: " << errorString(ret) << std::endl;
+        return ret;
+    }
+
+    char groupName[] = "ipc_benchmark";
+    ret              = dcgmGroupCreate(handle, DCGM_GROUP_EMPTY, groupName, &target.groupId);
+    for (unsigned int i = 0; ret == DCGM_ST_OK && i < fakeEntities.numToCreate; i++)
+    {
+        target.entities.push_back(fakeEntities.entityList[i].entity);
+        ret = dcgmGroupAddEntity(handle, target.groupId, DCGM_FE_GPU, fakeEntities.entityList[i].entity.entityId);
+    }
+    if (ret != DCGM_ST_OK)
+    {
+        std::cerr << "Error: unable to create a group of the fake GPUs: " << errorString(ret) << std::endl;
+        return ret;
+    }
+
+    unsigned int const numFields = std::min(options.numFields, (unsigned int)std::size(BENCH_FIELD_IDS));
+    target.fieldIds.assign(BENCH_FIELD_IDS, BENCH_FIELD_IDS + numFields);
+    ret = dcgmFieldGroupCreate(handle, (int)numFields, target.fieldIds.data(), groupName, &target.fieldGroupId);
+    if (ret == DCGM_ST_OK)
+    {
+        ret = dcgmWatchFields(handle, target.groupId, target.fieldGroupId, 1000000, 3600.0, 0);
+    }
+    if (ret != DCGM_ST_OK)
+    {
+        std::cerr << "Error: unable to watch the fields: " << errorString(ret) << std::endl;
+        return ret;
+    }
+
+    /* One sample every ms, ending now */
+    long long const now = std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+    target.sinceTimestamp = now - (long long)options.historySamples * 1000;
+    for (dcgmGroupEntityPair_t const &entity : target.entities)
+    {
+        for (unsigned short fieldId : target.fieldIds)
+        {
+            dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+            for (unsigned int i = 0; i < options.historySamples && ret == DCGM_ST_OK; i++)
+            {
+                dcgmInjectFieldValue_t value {};
+                value.version   = dcgmInjectFieldValue_version;
+                value.fieldId   = fieldId;
+                value.fieldType = fieldMeta->fieldType;
+                value.status    = DCGM_ST_OK;
+                value.ts        = target.sinceTimestamp + (long long)i * 1000;
+                if (fieldMeta->fieldType == DCGM_FT_DOUBLE)
+                {
+                    value.value.dbl = i;
+                }
+                else
+                {
+                    value.value.i64 = i;
+                }
+                ret = dcgmEntityInjectFieldValue(handle, entity.entityGroupId, entity.entityId, &value);
+            }
+        }
+    }
+    if (ret != DCGM_ST_OK)
+    {
+        std::cerr << "Error: unable to inject samples: " << errorString(ret) << std::endl;
+        return ret;
+    }
+
+    ret = dcgmHealthSet(handle, target.groupId, DCGM_HEALTH_WATCH_ALL);
+    if (ret != DCGM_ST_OK)
+    {
+        std::cerr << "Warning: unable to set health watches: " << errorString(ret) << std::endl;
+    }
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t RunOp(dcgmHandle_t handle, OpType op, Target &target, std::vector<dcgmFieldValue_v2> &values)
+{
+    switch (op)
+    {
+        case OP_LATEST:
+            return dcgmEntitiesGetLatestValues(handle,
+                                               target.entities.data(),
+                                               (unsigned int)target.entities.size(),
+                                               target.fieldIds.data(),
+                                               (unsigned int)target.fieldIds.size(),
+                                               0,
+                                               values.data());
+
+        case OP_SINCE:
+        {
+            long long nextSinceTimestamp = 0;
+            size_t numValues             = 0;
+            return dcgmGetValuesSince_v2(handle,
+                                         target.groupId,
+                                         target.fieldGroupId,
+                                         target.sinceTimestamp,
+                                         &nextSinceTimestamp,
+                                         CountValues,
+                                         &numValues);
+        }
+
+        case OP_GROUP:
+        {
+            char groupName[]     = "ipc_benchmark_tmp";
+            dcgmGpuGrp_t groupId = 0;
+            dcgmReturn_t ret     = dcgmGroupCreate(handle, DCGM_GROUP_EMPTY, groupName, &groupId);
+            if (ret != DCGM_ST_OK)
+            {
+                return ret;
+            }
+            ret                    = dcgmGroupAddEntity(handle, groupId, DCGM_FE_GPU, target.entities[0].entityId);
+            dcgmReturn_t destroyRet = dcgmGroupDestroy(handle, groupId);
+            return ret != DCGM_ST_OK ? ret : destroyRet;
+        }
+
+        case OP_HEALTH:
+        {
+            dcgmHealthResponse_t response {};
+            response.version = dcgmHealthResponse_version;
+            return dcgmHealthCheck(handle, target.groupId, &response);
+        }
+
+        default:
+            return DCGM_ST_BADPARAM;
+    }
+}
+
+/*****************************************************************************/
+/*
+ * Run numConnections connections over transport for durationUsec and report
+ * the requests per second and the latency of each op
+ */
+Json::Value BenchConnections(Options const &options,
+                             std::string const &transport,
+                             unsigned int numConnections,
+                             Target const &target)
+{
+    std::vector<WorkerResult> results(numConnections);
+    std::atomic<unsigned int> ready { 0 };
+    std::atomic<bool> go { false };
+    std::atomic<bool> stop { false };
+    std::vector<std::thread> workers;
+
+    for (unsigned int worker = 0; worker < numConnections; worker++)
+    {
+        workers.emplace_back([&, worker, workerTarget = Target(target)]() mutable {
+            WorkerResult &result = results[worker];
+            dcgmHandle_t handle  = 0;
+            result.connectRet    = Connect(options, transport, handle);
+            ready++;
+            if (result.connectRet != DCGM_ST_OK)
+            {
+                return;
+            }
+
+            std::mt19937 random(worker + 1);
+            std::discrete_distribution<unsigned int> pickOp(options.weights.begin(), options.weights.end());
+            std::vector<dcgmFieldValue_v2> values(target.entities.size() * target.fieldIds.size());
+
+            while (!go)
+            {
+                std::this_thread::yield();
+            }
+
+            while (!stop)
+            {
+                auto const op    = (OpType)pickOp(random);
+                auto const start = std::chrono::steady_clock::now();
+                dcgmReturn_t ret = RunOp(handle, op, workerTarget, values);
+                result.latencyUsec[op].push_back(
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+                result.errors[op] += ret != DCGM_ST_OK;
+            }
+
+            dcgmDisconnect(handle);
+        });
+    }
+
+    while (ready < numConnections)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto const start = std::chrono::steady_clock::now();
+    go               = true;
+    std::this_thread::sleep_for(std::chrono::microseconds(options.durationUsec));
+    stop = true;
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double const elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Json::Value result;
+    result["transport"]   = transport;
+    result["connections"] = numConnections;
+    result["elapsedSec"]  = elapsedSec;
+
+    unsigned int connectErrors    = 0;
+    unsigned long long totalCount = 0;
+    for (WorkerResult const &workerResult : results)
+    {
+        connectErrors += workerResult.connectRet != DCGM_ST_OK;
+    }
+    result["connectErrors"] = connectErrors;
+
+    for (unsigned int op = 0; op < OP_COUNT; op++)
+    {
+        if (options.weights[op] == 0)
+        {
+            continue;
+        }
+
+        std::vector<double> latencyUsec;
+        unsigned long long errors = 0;
+        for (WorkerResult &workerResult : results)
+        {
+            latencyUsec.insert(
+                latencyUsec.end(), workerResult.latencyUsec[op].begin(), workerResult.latencyUsec[op].end());
+            errors += workerResult.errors[op];
+        }
+        totalCount += latencyUsec.size();
+
+        Json::Value &opResult      = result["ops"][OP_NAMES[op]];
+        opResult["errors"]         = (Json::UInt64)errors;
+        opResult["requestsPerSec"] = elapsedSec > 0 ? latencyUsec.size() / elapsedSec : 0.0;
+        opResult["latencyUsec"]    = Summarize(std::move(latencyUsec));
+    }
+
+    result["requestsPerSec"] = elapsedSec > 0 ? totalCount / elapsedSec : 0.0;
+    return result;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options {};
+    std::string outputFile;
+
+    try
+    {
+        TCLAP::CmdLine cmdLine("Benchmarks requests to a running host engine and prints the results as JSON", ' ');
+
+        TCLAP::ValueArg<std::string> hostArg(
+            "a", "address", "Host engine TCP address, as host[:port]", false, "127.0.0.1", "ADDRESS", cmdLine);
+        TCLAP::ValueArg<std::string> socketArg(
+            "s", "socket", "Host engine unix socket, for the unix and shm transports", false, "", "PATH", cmdLine);
+        TCLAP::MultiArg<std::string> transportArg("t",
+                                                  "transport",
+                                                  "tcp, unix or shm. Can be repeated. Default tcp, and unix "
+                                                  "when --socket is given",
+                                                  false,
+                                                  "TRANSPORT",
+                                                  cmdLine);
+        TCLAP::MultiArg<unsigned int> connectionsArg(
+            "c", "connections", "Concurrent connections. Can be repeated. Default 1, 4 and 16", false, "K", cmdLine);
+        TCLAP::ValueArg<std::string> mixArg("m",
+                                            "mix",
+                                            "Weights of the requests issued",
+                                            false,
+                                            "latest=4,since=2,group=1,health=1",
+                                            "MIX",
+                                            cmdLine);
+        TCLAP::ValueArg<unsigned int> durationArg(
+            "d", "duration", "How long to run each transport and connection count in ms", false, 5000, "MS", cmdLine);
+        TCLAP::ValueArg<unsigned int> gpusArg("g", "gpus", "Number of fake GPUs to create", false, 4, "N", cmdLine);
+        TCLAP::ValueArg<unsigned int> fieldsArg("f", "fields", "Fields per GPU, at most 16", false, 8, "N", cmdLine);
+        TCLAP::ValueArg<unsigned int> historyArg(
+            "n", "samples", "Samples injected into each field of each GPU", false, 100, "N", cmdLine);
+        TCLAP::ValueArg<std::string> outputArg(
+            "o", "output", "File to write the JSON to instead of stdout", false, "", "FILE", cmdLine);
+
+        cmdLine.parse(argc, argv);
+
+        options.tcpAddress       = hostArg.getValue();
+        options.socketPath       = socketArg.getValue();
+        options.transports       = transportArg.getValue();
+        options.connectionCounts = connectionsArg.getValue();
+        options.durationUsec     = (long long)durationArg.getValue() * 1000;
+        options.numGpus          = std::max(1u, gpusArg.getValue());
+        options.numFields        = std::max(1u, fieldsArg.getValue());
+        options.historySamples   = historyArg.getValue();
+        outputFile               = outputArg.getValue();
+
+        if (!ParseMix(mixArg.getValue(), options.weights))
+        {
+            std::cerr << "Error: unable to parse the mix \"" << mixArg.getValue()
+                      << "\". Expected name=weight,... with names latest, since, group and health" << std::endl;
+            return 1;
+        }
+        if (options.transports.empty())
+        {
+            options.transports.push_back("tcp");
+            if (!options.socketPath.empty())
+            {
+                options.transports.push_back("unix");
+            }
+        }
+        for (std::string const &transport : options.transports)
+        {
+            if (transport != "tcp" && transport != "unix" && transport != "shm")
+            {
+                std::cerr << "Error: unknown transport " << transport << std::endl;
+                return 1;
+            }
+            if (transport != "tcp" && options.socketPath.empty())
+            {
+                std::cerr << "Error: the " << transport << " transport needs --socket" << std::endl;
+                return 1;
+            }
+        }
+        if (options.connectionCounts.empty())
+        {
+            options.connectionCounts = { 1, 4, 16 };
+        }
+    }
+    catch (TCLAP::ArgException const &ex)
+    {
+        std::cerr << "Argument parsing error: " << ex.error() << " for argument " << ex.argId() << std::endl;
+        return 1;
+    }
+
+    dcgmReturn_t ret = dcgmInit();
+    if (ret != DCGM_ST_OK)
+    {
+        std::cerr << "Error: unable to initialize DCGM: " << errorString(ret) << std::endl;
+        return 1;
+    }
+
+    /* The setup connection stays open so that the groups and watches last for the whole run */
+    dcgmHandle_t setupHandle = 0;
+    Target target;
+    ret = Connect(options, options.transports[0], setupHandle);
+    if (ret != DCGM_ST_OK)
+    {
+        std::cerr << "Error: unable to connect to the host engine: " << errorString(ret) << std::endl;
+        dcgmShutdown();
+        return 1;
+    }
+    if (Setup(setupHandle, options, target) != DCGM_ST_OK)
+    {
+        dcgmDisconnect(setupHandle);
+        dcgmShutdown();
+        return 1;
+    }
+
+    Json::Value report;
+    report["config"]["gpus"]         = (Json::UInt64)target.entities.size();
+    report["config"]["fields"]       = (Json::UInt64)target.fieldIds.size();
+    report["config"]["samples"]      = options.historySamples;
+    report["config"]["durationUsec"] = (Json::Int64)options.durationUsec;
+    for (unsigned int op = 0; op < OP_COUNT; op++)
+    {
+        report["config"]["mix"][OP_NAMES[op]] = options.weights[op];
+    }
+
+    report["runs"] = Json::Value(Json::arrayValue);
+    for (std::string const &transport : options.transports)
+    {
+        for (unsigned int numConnections : options.connectionCounts)
+        {
+            if (numConnections > 0)
+            {
+                report["runs"].append(BenchConnections(options, transport, numConnections, target));
+            }
+        }
+    }
+
+    dcgmFieldGroupDestroy(setupHandle, target.fieldGroupId);
+    dcgmGroupDestroy(setupHandle, target.groupId);
+    dcgmDisconnect(setupHandle);
+    dcgmShutdown();
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+
+    if (outputFile.empty())
+    {
+        writer->write(report, &std::cout);
+        std::cout << std::endl;
+        return 0;
+    }
+
+    std::ofstream output(outputFile);
+    writer->write(report, &output);
+    output << std::endl;
+    if (!output)
+    {
+        std::cerr << "Error: unable to write " << outputFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
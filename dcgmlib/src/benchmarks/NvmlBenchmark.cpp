@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * dcgm_nvml_benchmark: measures what reading each DCGM field from NVML costs on
+ * the driver and GPUs of this machine. Needs real GPUs.
+ *
+ * Every field is read through the cache manager's live sample path, so a field
+ * costs exactly the NVML calls that BufferOrCacheLatestGpuValue() makes for it,
+ * or the nvmlDeviceGetFieldValues() call of ActuallyUpdateGpuFieldValues() for
+ * fields with an nvmlFieldId. The bookkeeping around the calls is well under a
+ * microsecond, so the times are the driver's.
+ *
+ * Reported are:
+ * - The cost of each field read by itself, keyed by field ID
+ * - The cost of nvmlDeviceGetFieldValues() batches of 1, 2, 4... of the fields
+ *   with an nvmlFieldId, to show what batching saves
+ * - The throughput and latency of single field reads from 1, 2, 4... threads,
+ *   spread across the GPUs, to show how much the driver serializes
+ *
+ * The results are written as JSON so that they can be compared across drivers
+ * and SKUs, and used to plan how fields are batched.
+ */
+#include "BenchmarkStats.h"
+
+#include <DcgmCacheManager.h>
+#include <DcgmFvBuffer.h>
+#include <dcgm_fields.h>
+#include <dcgm_nvml.h>
+
+#include <json/json.h>
+#include <tclap/CmdLine.h>
+#include <tclap/ValueArg.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Options
+{
+    unsigned int gpuId; /* GPU to time fields and batches on */
+    unsigned int callsPerField;
+    unsigned int maxThreads;
+    unsigned int durationMs; /* How long to run each thread count */
+};
+
+/* A field that can be read live from a GPU or globally */
+struct Field
+{
+    dcgm_field_meta_p fieldMeta;
+    dcgm_field_entity_group_t entityGroupId;
+};
+
+/* Read fieldIds of entity live. Returns the usec it took and the status of the first value */
+double ReadLive(DcgmCacheManager &cacheManager,
+                dcgmGroupEntityPair_t entity,
+                std::vector<unsigned short> &fieldIds,
+                int &status)
+{
+    std::vector<dcgmGroupEntityPair_t> entities { entity };
+    DcgmFvBuffer fvBuffer;
+
+    auto const start = std::chrono::steady_clock::now();
+    cacheManager.GetMultipleLatestLiveSamples(entities, fieldIds, &fvBuffer);
+    double const usec
+        = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    status = DCGM_ST_NO_DATA;
+    for (dcgmBufferedFv_t const &fv : fvBuffer)
+    {
+        status = fv.status;
+        break;
+    }
+    return usec;
+}
+
+std::string ReadLiveString(DcgmCacheManager &cacheManager, dcgmGroupEntityPair_t entity, unsigned short fieldId)
+{
+    std::vector<dcgmGroupEntityPair_t> entities { entity };
+    std::vector<unsigned short> fieldIds { fieldId };
+    DcgmFvBuffer fvBuffer;
+    cacheManager.GetMultipleLatestLiveSamples(entities, fieldIds, &fvBuffer);
+    for (dcgmBufferedFv_t const &fv : fvBuffer)
+    {
+        if (fv.status == DCGM_ST_OK && fv.fieldType == DCGM_FT_STRING)
+        {
+            return fv.value.str;
+        }
+    }
+    return "";
+}
+
+/* The GPU and global fields the cache manager reads from NVML */
+std::vector<Field> ListFields(DcgmCacheManager &cacheManager)
+{
+    std::vector<unsigned short> validFieldIds;
+    cacheManager.GetValidFieldIds(validFieldIds, false);
+
+    std::vector<Field> fields;
+    for (unsigned short fieldId : validFieldIds)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        if (fieldMeta == nullptr)
+        {
+            continue;
+        }
+        if (fieldMeta->scope == DCGM_FS_GLOBAL)
+        {
+            fields.push_back({ fieldMeta, DCGM_FE_NONE });
+        }
+        else if (fieldMeta->entityLevel == DCGM_FE_GPU)
+        {
+            fields.push_back({ fieldMeta, DCGM_FE_GPU });
+        }
+    }
+    return fields;
+}
+
+/*****************************************************************************/
+/*
+ * Read each field by itself callsPerField times. Reports the cost of each by
+ * field ID. Fields that failed every time report their last status
+ */
+Json::Value BenchFields(DcgmCacheManager &cacheManager, Options const &options, std::vector<Field> const &fields)
+{
+    Json::Value results(Json::objectValue);
+
+    for (Field const &field : fields)
+    {
+        std::vector<unsigned short> fieldIds { field.fieldMeta->fieldId };
+        dcgmGroupEntityPair_t entity { field.entityGroupId, field.entityGroupId == DCGM_FE_NONE ? 0 : options.gpuId };
+        std::vector<double> usec;
+        int status = DCGM_ST_OK;
+
+        for (unsigned int i = 0; i < options.callsPerField; i++)
+        {
+            usec.push_back(ReadLive(cacheManager, entity, fieldIds, status));
+        }
+
+        Json::Value result;
+        result["tag"]         = field.fieldMeta->tag;
+        result["nvmlFieldId"] = field.fieldMeta->nvmlFieldId;
+        result["status"]      = status;
+        result["usec"]        = Summarize(std::move(usec));
+
+        results[std::to_string(field.fieldMeta->fieldId)] = result;
+    }
+
+    return results;
+}
+
+/*****************************************************************************/
+/*
+ * Read 1, 2, 4... of the fields that have an nvmlFieldId in one
+ * nvmlDeviceGetFieldValues() call, callsPerField times per batch size
+ */
+Json::Value BenchFieldValueBatches(DcgmCacheManager &cacheManager,
+                                   Options const &options,
+                                   std::vector<Field> const &fields)
+{
+    std::vector<unsigned short> batchable;
+    for (Field const &field : fields)
+    {
+        if (field.fieldMeta->nvmlFieldId > 0 && field.entityGroupId == DCGM_FE_GPU)
+        {
+            batchable.push_back(field.fieldMeta->fieldId);
+        }
+    }
+
+    std::vector<size_t> batchSizes;
+    for (size_t batchSize = 1; batchSize < batchable.size(); batchSize *= 2)
+    {
+        batchSizes.push_back(batchSize);
+    }
+    if (!batchable.empty())
+    {
+        batchSizes.push_back(batchable.size());
+    }
+
+    Json::Value results(Json::arrayValue);
+    for (size_t batchSize : batchSizes)
+    {
+        std::vector<unsigned short> fieldIds(batchable.begin(), batchable.begin() + batchSize);
+        std::vector<double> usec;
+        int status = DCGM_ST_OK;
+
+        for (unsigned int i = 0; i < options.callsPerField; i++)
+        {
+            usec.push_back(ReadLive(cacheManager, { DCGM_FE_GPU, options.gpuId }, fieldIds, status));
+        }
+
+        double mean = 0;
+        for (double value : usec)
+        {
+            mean += value;
+        }
+        mean /= std::max((size_t)1, usec.size());
+
+        Json::Value result;
+        result["batchSize"]    = (Json::UInt64)batchSize;
+        result["usecPerField"] = mean / batchSize;
+        result["usec"]         = Summarize(std::move(usec));
+        results.append(result);
+    }
+
+    return results;
+}
+
+/*****************************************************************************/
+/*
+ * Have 1, 2, 4... maxThreads threads read random supported fields one at a
+ * time for durationMs. Thread i reads from GPU i % the number of GPUs
+ */
+Json::Value BenchConcurrency(DcgmCacheManager &cacheManager,
+                             Options const &options,
+                             std::vector<unsigned int> const &gpuIds,
+                             std::vector<unsigned short> const &supportedFieldIds)
+{
+    Json::Value results(Json::arrayValue);
+    if (supportedFieldIds.empty())
+    {
+        return results;
+    }
+
+    for (unsigned int numThreads = 1; numThreads <= options.maxThreads; numThreads *= 2)
+    {
+        std::atomic<bool> stop { false };
+        std::vector<std::vector<double>> usec(numThreads);
+        std::vector<std::thread> threads;
+
+        auto const start = std::chrono::steady_clock::now();
+        for (unsigned int thread = 0; thread < numThreads; thread++)
+        {
+            threads.emplace_back([&, thread] {
+                std::mt19937 random(thread + 1);
+                dcgmGroupEntityPair_t const entity { DCGM_FE_GPU, gpuIds[thread % gpuIds.size()] };
+                std::vector<unsigned short> fieldIds(1);
+                int status = DCGM_ST_OK;
+                while (!stop)
+                {
+                    fieldIds[0] = supportedFieldIds[random() % supportedFieldIds.size()];
+                    usec[thread].push_back(ReadLive(cacheManager, entity, fieldIds, status));
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.durationMs));
+        stop = true;
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        double const elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<double> allUsec;
+        for (std::vector<double> const &threadUsec : usec)
+        {
+            allUsec.insert(allUsec.end(), threadUsec.begin(), threadUsec.end());
+        }
+
+        Json::Value result;
+        result["threads"]     = numThreads;
+        result["gpus"]        = (Json::UInt64)std::min((size_t)numThreads, gpuIds.size());
+        result["callsPerSec"] = elapsedSec > 0 ? allUsec.size() / elapsedSec : 0.0;
+        result["usec"]        = Summarize(std::move(allUsec));
+        results.append(result);
+    }
+
+    return results;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options {};
+    std::string outputFile;
+    bool gpuIdGiven = false;
+
+    try
+    {
+        TCLAP::CmdLine cmdLine("Measures what reading each DCGM field from NVML costs and prints the results as JSON",
+                               ' ');
+
+        TCLAP::ValueArg<unsigned int> gpuArg(
+            "i", "gpu-id", "GPU to time fields and batches on. Default the first one", false, 0, "ID", cmdLine);
+        TCLAP::ValueArg<unsigned int> callsArg(
+            "c", "calls", "Reads of each field and of each batch size", false, 100, "N", cmdLine);
+        TCLAP::ValueArg<unsigned int> threadsArg("t", "threads", "Most concurrent threads", false, 8, "N", cmdLine);
+        TCLAP::ValueArg<unsigned int> durationArg(
+            "d", "duration", "How long to run each thread count in ms", false, 2000, "MS", cmdLine);
+        TCLAP::ValueArg<std::string> outputArg(
+            "o", "output", "File to write the JSON to instead of stdout", false, "", "FILE", cmdLine);
+
+        cmdLine.parse(argc, argv);
+
+        options.gpuId         = gpuArg.getValue();
+        options.callsPerField = std::max(1u, callsArg.getValue());
+        options.maxThreads    = std::max(1u, threadsArg.getValue());
+        options.durationMs    = durationArg.getValue();
+        outputFile            = outputArg.getValue();
+        gpuIdGiven            = gpuArg.isSet();
+    }
+    catch (TCLAP::ArgException const &ex)
+    {
+        std::cerr << "Argument parsing error: " << ex.error() << " for argument " << ex.argId() << std::endl;
+        return 1;
+    }
+
+    DcgmFieldsInit();
+
+    nvmlReturn_t nvmlReturn = nvmlInit_v2();
+    if (nvmlReturn != NVML_SUCCESS)
+    {
+        std::cerr << "Error: unable to initialize NVML: " << nvmlErrorString(nvmlReturn) << std::endl;
+        return 1;
+    }
+
+    Json::Value report;
+    {
+        DcgmCacheManager cacheManager;
+        dcgmReturn_t ret = cacheManager.Init(1, 3600.0);
+        if (ret != DCGM_ST_OK)
+        {
+            std::cerr << "Error: unable to initialize the cache manager: " << errorString(ret) << std::endl;
+            nvmlShutdown();
+            return 1;
+        }
+
+        std::vector<unsigned int> gpuIds;
+        cacheManager.GetGpuIds(1, gpuIds);
+        if (gpuIds.empty())
+        {
+            std::cerr << "Error: no GPUs found" << std::endl;
+            nvmlShutdown();
+            return 1;
+        }
+        if (!gpuIdGiven)
+        {
+            options.gpuId = gpuIds[0];
+        }
+        else if (std::find(gpuIds.begin(), gpuIds.end(), options.gpuId) == gpuIds.end())
+        {
+            std::cerr << "Error: there is no GPU " << options.gpuId << std::endl;
+            nvmlShutdown();
+            return 1;
+        }
+
+        std::vector<Field> const fields = ListFields(cacheManager);
+
+        report["config"]["gpuId"]         = options.gpuId;
+        report["config"]["gpus"]          = (Json::UInt64)gpuIds.size();
+        report["config"]["callsPerField"] = options.callsPerField;
+        report["config"]["durationMs"]    = options.durationMs;
+        report["config"]["gpuName"]
+            = ReadLiveString(cacheManager, { DCGM_FE_GPU, options.gpuId }, DCGM_FI_DEV_NAME);
+        report["config"]["driverVersion"]
+            = ReadLiveString(cacheManager, { DCGM_FE_NONE, 0 }, DCGM_FI_DRIVER_VERSION);
+        report["fields"]                  = BenchFields(cacheManager, options, fields);
+        report["fieldValueBatches"]       = BenchFieldValueBatches(cacheManager, options, fields);
+
+        /* Only GPU fields that worked on the GPU, so that the threads don't just time errors */
+        std::vector<unsigned short> supportedFieldIds;
+        for (Field const &field : fields)
+        {
+            std::string const fieldId = std::to_string(field.fieldMeta->fieldId);
+            if (field.entityGroupId == DCGM_FE_GPU && report["fields"][fieldId]["status"].asInt() == DCGM_ST_OK)
+            {
+                supportedFieldIds.push_back(field.fieldMeta->fieldId);
+            }
+        }
+        report["concurrency"] = BenchConcurrency(cacheManager, options, gpuIds, supportedFieldIds);
+    }
+
+    nvmlShutdown();
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+
+    if (outputFile.empty())
+    {
+        writer->write(report, &std::cout);
+        std::cout << std::endl;
+        return 0;
+    }
+
+    std::ofstream output(outputFile);
+    writer->write(report, &output);
+    output << std::endl;
+    if (!output)
+    {
+        std::cerr << "Error: unable to write " << outputFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -109,6 +109,7 @@ dcgm_error_meta_t dcgmErrorMeta[DCGM_FR_ERROR_SENTINEL] = {
     DCGM_ERROR_TABLE_ENTRY(DCGM_FR_DBE_PENDING_PAGE_RETIREMENTS, DCGM_ERROR_ISOLATE),
     DCGM_ERROR_TABLE_ENTRY(DCGM_FR_UNCORRECTABLE_ROW_REMAP, DCGM_ERROR_ISOLATE),
     DCGM_ERROR_TABLE_ENTRY(DCGM_FR_PENDING_ROW_REMAP, DCGM_ERROR_ISOLATE),
+    DCGM_ERROR_TABLE_ENTRY(DCGM_FR_FIELD_ANOMALY, DCGM_ERROR_MONITOR),
 };
 
 dcgmErrorSeverity_t dcgmErrorGetPriorityByCode(unsigned int code)
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmAttributeCache.h>
+#include <dcgm_structs.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+/* Build a DCGM_MSG_ATTRIBUTE_GENERATION like the host engine would push */
+std::unique_ptr<DcgmMessage> MakeGenerationMessage(unsigned long long generation)
+{
+    dcgm_msg_attribute_generation_t body {};
+    body.version    = dcgm_msg_attribute_generation_version;
+    body.generation = generation;
+
+    auto msg = std::make_unique<DcgmMessage>();
+    msg->UpdateMsgHdr(DCGM_MSG_ATTRIBUTE_GENERATION, 1, DCGM_ST_OK, sizeof(body));
+    auto msgBytes = msg->GetMsgBytesPtr();
+    msgBytes->resize(sizeof(body));
+    memcpy(msgBytes->data(), &body, sizeof(body));
+    return msg;
+}
+} // namespace
+
+TEST_CASE("AttributeCache: lookups hit until the generation moves")
+{
+    DcgmAttributeCache cache;
+    cache.SetGeneration(5);
+
+    DcgmAttributeCache::Key const key { DcgmAttributeCacheKindAllDevices, 0, 0 };
+    std::vector<unsigned int> const gpuIds { 0, 1, 3 };
+    std::vector<char> value;
+
+    CHECK(!cache.Lookup(key, value));
+    cache.Store(key, cache.GetGeneration(), gpuIds.data(), gpuIds.size() * sizeof(unsigned int));
+    REQUIRE(cache.Lookup(key, value));
+    REQUIRE(value.size() == gpuIds.size() * sizeof(unsigned int));
+    CHECK(memcmp(value.data(), gpuIds.data(), value.size()) == 0);
+
+    /* Other keys are separate */
+    CHECK(!cache.Lookup({ DcgmAttributeCacheKindAllDevices, 1, 0 }, value));
+
+    /* Going back a generation changes nothing */
+    cache.SetGeneration(4);
+    CHECK(cache.GetGeneration() == 5);
+    CHECK(cache.GetSize() == 1);
+
+    cache.SetGeneration(6);
+    CHECK(cache.GetSize() == 0);
+    CHECK(!cache.Lookup(key, value));
+}
+
+TEST_CASE("AttributeCache: responses of an older generation aren't stored")
+{
+    DcgmAttributeCache cache;
+    cache.SetGeneration(1);
+
+    dcgmFieldGroupInfo_t info {};
+    info.version     = dcgmFieldGroupInfo_version;
+    info.numFieldIds = 2;
+
+    /* The generation moved while the request was in flight */
+    unsigned long long const generation = cache.GetGeneration();
+    cache.SetGeneration(2);
+    cache.StoreStruct({ DcgmAttributeCacheKindFieldGroupInfo, 1, info.version }, generation, info);
+    CHECK(cache.GetSize() == 0);
+
+    cache.StoreStruct({ DcgmAttributeCacheKindFieldGroupInfo, 1, info.version }, cache.GetGeneration(), info);
+    dcgmFieldGroupInfo_t cached {};
+    REQUIRE(cache.LookupStruct({ DcgmAttributeCacheKindFieldGroupInfo, 1, info.version }, cached));
+    CHECK(cached.numFieldIds == 2);
+
+    /* A struct of another size doesn't match */
+    dcgmAllFieldGroup_t all {};
+    CHECK(!cache.LookupStruct({ DcgmAttributeCacheKindFieldGroupInfo, 1, info.version }, all));
+}
+
+TEST_CASE("AttributeCache: the request moves the cache to pushed generations")
+{
+    auto cache = std::make_shared<DcgmAttributeCache>();
+    DcgmAttributeCacheRequest request(cache);
+
+    cache->SetGeneration(3);
+    cache->Store({ DcgmAttributeCacheKindFieldGroupAll, 0, 1 }, 3, "x", 1);
+
+    REQUIRE(request.ProcessMessage(MakeGenerationMessage(4)) == DCGM_ST_OK);
+    CHECK(cache->GetGeneration() == 4);
+    CHECK(cache->GetSize() == 0);
+
+    /* The subscription's response isn't a generation change */
+    auto response = std::make_unique<DcgmMessage>();
+    response->UpdateMsgHdr(DCGM_MSG_MODULE_COMMAND, 1, DCGM_ST_OK, 0);
+    REQUIRE(request.ProcessMessage(std::move(response)) == DCGM_ST_OK);
+    CHECK(request.MessageCount() == 1);
+    CHECK(cache->GetGeneration() == 4);
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmCacheArena.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+TEST_CASE("CacheArena: size classes")
+{
+    size_t classSize = 0;
+    CHECK(DcgmCacheArena::GetSizeClass(1, classSize) == 0);
+    CHECK(classSize == 64);
+    CHECK(DcgmCacheArena::GetSizeClass(64, classSize) == 0);
+    CHECK(classSize == 64);
+    CHECK(DcgmCacheArena::GetSizeClass(65, classSize) == 1);
+    CHECK(classSize == 80);
+    CHECK(DcgmCacheArena::GetSizeClass(128, classSize) == 4);
+    CHECK(classSize == 128);
+    CHECK(DcgmCacheArena::GetSizeClass(129, classSize) == 5);
+    CHECK(classSize == 160);
+
+    /* Classes are contiguous, never waste more than a quarter and keep 16 byte alignment */
+    unsigned int lastClass = 0;
+    for (size_t size = 1; size <= DCGM_CM_ARENA_MAX_SMALL_BYTES; size++)
+    {
+        unsigned int sizeClass = DcgmCacheArena::GetSizeClass(size, classSize);
+        REQUIRE(classSize >= size);
+        REQUIRE((size <= 64 || classSize - size < size / 4 + 1));
+        REQUIRE(classSize % 16 == 0);
+        REQUIRE((sizeClass == lastClass || sizeClass == lastClass + 1));
+        lastClass = sizeClass;
+    }
+}
+
+TEST_CASE("CacheArena: allocate and release")
+{
+    DcgmCacheArena arena;
+
+    std::vector<size_t> const sizes { 1, 24, 64, 100, 1000, 4096 };
+    std::vector<void *> ptrs;
+    for (size_t size : sizes)
+    {
+        void *ptr = arena.Allocate(size);
+        REQUIRE(ptr != nullptr);
+        CHECK((uintptr_t)ptr % 16 == 0);
+        memset(ptr, 0xAB, size);
+        ptrs.push_back(ptr);
+    }
+
+    dcgmcm_arena_stats_t stats {};
+    arena.AddStats(stats);
+    CHECK(stats.numChunks == 1);
+    CHECK(stats.bytesMapped == DCGM_CM_ARENA_CHUNK_BYTES);
+    CHECK(stats.numAllocations == 6);
+
+    /* Chunks are aligned so that THP can back them with a huge page */
+    CHECK((uintptr_t)ptrs[0] % DCGM_CM_ARENA_CHUNK_BYTES == 0);
+
+    /* A released allocation is reused by the next one of its class */
+    arena.Release(ptrs[3], 100);
+    CHECK(arena.Allocate(110) == ptrs[3]);
+
+    for (size_t i = 0; i < ptrs.size(); i++)
+    {
+        arena.Release(ptrs[i], sizes[i]);
+    }
+
+    /* Released memory stays mapped for the next allocations */
+    stats = {};
+    arena.AddStats(stats);
+    CHECK(stats.numAllocations == 0);
+    CHECK(stats.bytesAllocated == 0);
+    CHECK(stats.bytesMapped == DCGM_CM_ARENA_CHUNK_BYTES);
+}
+
+TEST_CASE("CacheArena: chunks and large allocations")
+{
+    DcgmCacheArena arena;
+
+    /* Fill more than one chunk */
+    size_t const size = 64 * 1024;
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < 2 * DCGM_CM_ARENA_CHUNK_BYTES / size; i++)
+    {
+        ptrs.push_back(arena.Allocate(size));
+        REQUIRE(ptrs.back() != nullptr);
+    }
+
+    dcgmcm_arena_stats_t stats {};
+    arena.AddStats(stats);
+    CHECK(stats.numChunks == 2);
+
+    void *large = arena.Allocate(3 * DCGM_CM_ARENA_CHUNK_BYTES);
+    REQUIRE(large != nullptr);
+    memset(large, 0, 3 * DCGM_CM_ARENA_CHUNK_BYTES);
+
+    stats = {};
+    arena.AddStats(stats);
+    CHECK(stats.numLargeMapped == 1);
+    CHECK(stats.bytesMapped == 5 * DCGM_CM_ARENA_CHUNK_BYTES);
+
+    /* Large allocations are unmapped when released. Chunks stay */
+    arena.Release(large, 3 * DCGM_CM_ARENA_CHUNK_BYTES);
+    for (void *ptr : ptrs)
+    {
+        arena.Release(ptr, size);
+    }
+
+    stats = {};
+    arena.AddStats(stats);
+    CHECK(stats.numLargeMapped == 0);
+    CHECK(stats.numAllocations == 0);
+    CHECK(stats.bytesMapped == 2 * DCGM_CM_ARENA_CHUNK_BYTES);
+    CHECK(stats.maxBytesMapped == 5 * DCGM_CM_ARENA_CHUNK_BYTES);
+}
+
+TEST_CASE("CacheArena: objects and timeseries")
+{
+    DcgmCacheArena arena;
+
+    auto *str = arena.New<std::string>(100, 'x');
+    REQUIRE(str != nullptr);
+    CHECK(*str == std::string(100, 'x'));
+    arena.Delete(str);
+
+    int errorSt     = 0;
+    timeseries_p ts = timeseries_alloc_ring(TS_TYPE_DOUBLE, 16, &errorSt);
+    REQUIRE(ts != nullptr);
+    REQUIRE(timeseries_set_allocator(ts, arena.GetTimeseriesAllocator()) == TS_ST_OK);
+    for (int i = 1; i <= 100; i++)
+    {
+        REQUIRE(timeseries_insert_double(ts, i, i * 0.5, 0.0) == TS_ST_OK);
+    }
+
+    dcgmcm_arena_stats_t stats {};
+    arena.AddStats(stats);
+    CHECK(stats.numAllocations == 2); /* The timestamp and value columns */
+
+    timeseries_cursor_t cursor;
+    timeseries_entry_p entry = timeseries_last(ts, &cursor);
+    REQUIRE(entry != nullptr);
+    CHECK(entry->val.dbl == 50.0);
+
+    timeseries_destroy(ts);
+    stats = {};
+    arena.AddStats(stats);
+    CHECK(stats.numAllocations == 0);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmCacheRollup.h>
+
+
+TEST_CASE("CacheRollup: ParseTiers")
+{
+    timelib64_t rawRetentionUsec = 0;
+    std::vector<dcgmcm_rollup_tier_config_t> tiers;
+
+    REQUIRE(DcgmCacheRollup::ParseTiers("300,10:21600,60:86400", &rawRetentionUsec, &tiers) == DCGM_ST_OK);
+    CHECK(rawRetentionUsec == 300000000);
+    REQUIRE(tiers.size() == 2);
+    CHECK(tiers[0].bucketUsec == 10000000);
+    CHECK(tiers[0].retentionUsec == 21600000000);
+    CHECK(tiers[1].bucketUsec == 60000000);
+    CHECK(tiers[1].retentionUsec == 86400000000);
+
+    CHECK(DcgmCacheRollup::ParseTiers("300", &rawRetentionUsec, &tiers) == DCGM_ST_BADPARAM);
+    CHECK(DcgmCacheRollup::ParseTiers("300,10", &rawRetentionUsec, &tiers) == DCGM_ST_BADPARAM);
+    CHECK(DcgmCacheRollup::ParseTiers("300,10:x", &rawRetentionUsec, &tiers) == DCGM_ST_BADPARAM);
+    CHECK(DcgmCacheRollup::ParseTiers("300,10:200", &rawRetentionUsec, &tiers) == DCGM_ST_BADPARAM);
+    CHECK(DcgmCacheRollup::ParseTiers("300,60:21600,10:86400", &rawRetentionUsec, &tiers) == DCGM_ST_BADPARAM);
+    CHECK(DcgmCacheRollup::ParseTiers("300,10:86400,60:21600", &rawRetentionUsec, &tiers) == DCGM_ST_BADPARAM);
+}
+
+TEST_CASE("CacheRollup: NormalizeTiers")
+{
+    std::vector<dcgmcm_rollup_tier_config_t> tiers { { 60, 3600 }, { 10, 600 }, { 10, 900 }, { 30, 300 }, { 5, 50 } };
+    DcgmCacheRollup::NormalizeTiers(100, &tiers);
+
+    /* { 5, 50 } is within the raw samples and { 30, 300 } is within the finer { 10, 900 } */
+    REQUIRE(tiers.size() == 2);
+    CHECK(tiers[0].bucketUsec == 10);
+    CHECK(tiers[0].retentionUsec == 900);
+    CHECK(tiers[1].bucketUsec == 60);
+    CHECK(tiers[1].retentionUsec == 3600);
+
+    tiers = { { 100, 50 } };
+    DcgmCacheRollup::NormalizeTiers(10, &tiers);
+    CHECK(tiers.empty());
+}
+
+TEST_CASE("CacheRollup: Buckets and summaries")
+{
+    DcgmCacheRollup rollup({ { 10, 100 }, { 100, 1000 } });
+    REQUIRE(rollup.NumTiers() == 2);
+    CHECK(rollup.FindTier(0) == -1);
+
+    /* Two samples a bucket, with the second one out of order */
+    for (int i = 0; i < 50; i++)
+    {
+        rollup.Append(200 + i * 10 + 5, 2.0 * i + 1);
+        rollup.Append(200 + i * 10, 2.0 * i);
+    }
+
+    auto const &fine = rollup.Buckets(0);
+    REQUIRE(fine.size() == 50);
+    CHECK(fine[0].startUsec == 200);
+    CHECK(fine[0].firstUsec == 200);
+    CHECK(fine[0].lastUsec == 205);
+    CHECK(fine[0].count == 2);
+    CHECK(fine[0].min == 0.0);
+    CHECK(fine[0].max == 1.0);
+    CHECK(fine[0].first == 0.0);
+    CHECK(fine[0].last == 1.0);
+    CHECK(fine[0].integral == Approx(2.5));
+    CHECK(rollup.Buckets(1).size() == 5);
+
+    dcgmcm_rollup_summary_t summary = rollup.Summarize(0, 0, 0);
+    CHECK(summary.count == 100);
+    CHECK(summary.sum == Approx(99.0 * 100 / 2));
+    CHECK(summary.min == 0.0);
+    CHECK(summary.max == 99.0);
+    CHECK(summary.firstUsec == 200);
+    CHECK(summary.lastUsec == 695);
+    CHECK(summary.integral == Approx(99.0 / 2 * 495));
+
+    /* Buckets are all or nothing */
+    summary = rollup.Summarize(0, 300, 405);
+    CHECK(summary.count == 20);
+    CHECK(summary.first == 20.0);
+    CHECK(summary.last == 39.0);
+
+    /* Fine buckets age out first */
+    rollup.EnforceQuota(700, 0);
+    CHECK(rollup.Buckets(0).size() == 10);
+    CHECK(rollup.Buckets(1).size() == 5);
+    CHECK(rollup.FindTier(650) == 0);
+    CHECK(rollup.FindTier(300) == 1);
+    CHECK(rollup.FindTier(0) == 1);
+
+    /* The watch's max age caps every tier */
+    rollup.EnforceQuota(700, 150);
+    CHECK(rollup.Buckets(1).size() == 2);
+}
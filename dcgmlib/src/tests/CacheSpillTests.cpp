@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmCacheSpill.h>
+
+#include <cstdlib>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+/* An empty directory that is removed with everything in it */
+class TempDir
+{
+public:
+    TempDir()
+    {
+        char path[] = "/tmp/dcgm-spill-test-XXXXXX";
+        REQUIRE(mkdtemp(path) != nullptr);
+        m_path = path;
+    }
+
+    ~TempDir()
+    {
+        DIR *dir = opendir(m_path.c_str());
+        struct dirent *dirEntry;
+        while (dir != nullptr && (dirEntry = readdir(dir)) != nullptr)
+        {
+            unlink((m_path + "/" + dirEntry->d_name).c_str());
+        }
+        if (dir != nullptr)
+            closedir(dir);
+        rmdir(m_path.c_str());
+    }
+
+    std::string const &Path() const
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+};
+
+std::vector<dcgmcm_spill_sample_t> Int64Samples(timelib64_t firstUsec, int numSamples)
+{
+    std::vector<dcgmcm_spill_sample_t> samples(numSamples);
+    for (int i = 0; i < numSamples; i++)
+    {
+        samples[i].timestamp = firstUsec + i * 1000000;
+        samples[i].value.i64 = 1000 + (i % 7) * 3 - (i % 3);
+    }
+    return samples;
+}
+} // namespace
+
+TEST_CASE("CacheSpill: Blocks round trip")
+{
+    std::vector<dcgmcm_spill_sample_t> samples = Int64Samples(1600000000000000, 100);
+    samples[50].timestamp += 17; /* A late sample */
+    samples[60].value.i64 = -5;
+
+    std::string payload;
+    DcgmCacheSpill::EncodeBlock(false, samples.data(), (int)samples.size(), payload);
+    /* Mostly one byte per timestamp and one per value */
+    CHECK(payload.size() < samples.size() * 3);
+
+    std::vector<dcgmcm_spill_sample_t> decoded;
+    REQUIRE(DcgmCacheSpill::DecodeBlock(
+        false, (unsigned char const *)payload.data(), payload.size(), (int)samples.size(), decoded));
+    REQUIRE(decoded.size() == samples.size());
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        CHECK(decoded[i].timestamp == samples[i].timestamp);
+        CHECK(decoded[i].value.i64 == samples[i].value.i64);
+    }
+
+    std::vector<double> values { 250.5, 250.5, 251.0, -3.25, 1e300, 0.0, 0.1 };
+    samples.resize(values.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        samples[i].value.dbl = values[i];
+    }
+    payload.clear();
+    DcgmCacheSpill::EncodeBlock(true, samples.data(), (int)samples.size(), payload);
+    decoded.clear();
+    REQUIRE(DcgmCacheSpill::DecodeBlock(
+        true, (unsigned char const *)payload.data(), payload.size(), (int)samples.size(), decoded));
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        CHECK(decoded[i].value.dbl == values[i]);
+    }
+
+    /* Truncated payloads don't decode */
+    decoded.clear();
+    CHECK(!DcgmCacheSpill::DecodeBlock(
+        true, (unsigned char const *)payload.data(), payload.size() - 1, (int)samples.size(), decoded));
+}
+
+TEST_CASE("CacheSpill: Reads span disk and memory")
+{
+    TempDir dir;
+    timelib64_t const firstUsec = 1600000000000000;
+    int const numSamples        = DCGM_CM_SPILL_BLOCK_SAMPLES * 2 + 10;
+    std::vector<dcgmcm_spill_sample_t> samples = Int64Samples(firstUsec, numSamples);
+
+    {
+        DcgmCacheSpill spill(dir.Path(), 0);
+        REQUIRE(spill.Open() == DCGM_ST_OK);
+        CHECK(spill.OldestUsec(1, 0, 150) == 0);
+
+        spill.Append(1, 0, 150, false, samples.data(), numSamples);
+        /* Already spilled */
+        spill.Append(1, 0, 150, false, samples.data(), 5);
+        CHECK(spill.OldestUsec(1, 0, 150) == firstUsec);
+        CHECK(spill.GetBytesUsed() > 0);
+
+        /* Ten samples are still in memory */
+        std::vector<dcgmcm_spill_sample_t> read;
+        bool isDouble = true;
+        CHECK(spill.Read(1, 0, 150, 0, 0, 0, DCGM_ORDER_ASCENDING, numSamples + 1, read, &isDouble) == numSamples);
+        CHECK(!isDouble);
+        REQUIRE(read.size() == (size_t)numSamples);
+        for (int i = 0; i < numSamples; i++)
+        {
+            CHECK(read[i].timestamp == samples[i].timestamp);
+            CHECK(read[i].value.i64 == samples[i].value.i64);
+        }
+
+        /* A window across blocks, newest first and cut off by beforeUsec */
+        read.clear();
+        timelib64_t startTime  = samples[250].timestamp;
+        timelib64_t beforeUsec = samples[270].timestamp;
+        CHECK(spill.Read(1, 0, 150, startTime, 0, beforeUsec, DCGM_ORDER_DESCENDING, 100, read, nullptr) == 20);
+        CHECK(read.front().timestamp == samples[269].timestamp);
+        CHECK(read.back().timestamp == samples[250].timestamp);
+
+        read.clear();
+        CHECK(spill.Read(1, 0, 150, 0, 0, 0, DCGM_ORDER_DESCENDING, 3, read, nullptr) == 3);
+        CHECK(read.front().timestamp == samples[numSamples - 1].timestamp);
+
+        CHECK(spill.Read(1, 0, 155, 0, 0, 0, DCGM_ORDER_ASCENDING, 10, read, nullptr) == 0);
+    }
+
+    /* Everything was flushed and is found again */
+    DcgmCacheSpill spill(dir.Path(), 0);
+    REQUIRE(spill.Open() == DCGM_ST_OK);
+    CHECK(spill.OldestUsec(1, 0, 150) == firstUsec);
+    std::vector<dcgmcm_spill_sample_t> read;
+    CHECK(spill.Read(1, 0, 150, 0, 0, 0, DCGM_ORDER_ASCENDING, numSamples, read, nullptr) == numSamples);
+    CHECK(read.back().value.i64 == samples.back().value.i64);
+
+    /* Later samples go to a new segment */
+    std::vector<dcgmcm_spill_sample_t> more = Int64Samples(samples.back().timestamp + 1000000, 10);
+    spill.Append(1, 0, 150, false, more.data(), (int)more.size());
+    spill.Flush();
+    read.clear();
+    CHECK(spill.Read(1, 0, 150, 0, 0, 0, DCGM_ORDER_ASCENDING, numSamples * 2, read, nullptr) == numSamples + 10);
+}
+
+TEST_CASE("CacheSpill: Oldest segments are deleted over budget")
+{
+    TempDir dir;
+    /* The smallest segments are 64 KiB. Doubles that change every sample take ~10 bytes each */
+    DcgmCacheSpill spill(dir.Path(), 256 * 1024);
+    REQUIRE(spill.Open() == DCGM_ST_OK);
+
+    timelib64_t const firstUsec = 1600000000000000;
+    std::vector<dcgmcm_spill_sample_t> samples(DCGM_CM_SPILL_BLOCK_SAMPLES);
+    for (int block = 0; block < 200; block++)
+    {
+        for (int i = 0; i < DCGM_CM_SPILL_BLOCK_SAMPLES; i++)
+        {
+            samples[i].timestamp = firstUsec + (block * DCGM_CM_SPILL_BLOCK_SAMPLES + i) * 1000;
+            samples[i].value.dbl = 1.0 / (block * DCGM_CM_SPILL_BLOCK_SAMPLES + i + 3);
+        }
+        spill.Append(0, block % 2, 100, true, samples.data(), (int)samples.size());
+    }
+
+    CHECK(spill.GetBytesUsed() <= 256 * 1024);
+    CHECK(spill.OldestUsec(0, 0, 100) > firstUsec);
+    CHECK(spill.OldestUsec(0, 1, 100) > firstUsec);
+
+    /* The newest samples are kept */
+    std::vector<dcgmcm_spill_sample_t> read;
+    bool isDouble = false;
+    REQUIRE(spill.Read(0, 1, 100, 0, 0, 0, DCGM_ORDER_DESCENDING, 1, read, &isDouble) == 1);
+    CHECK(isDouble);
+    CHECK(read[0].timestamp == samples.back().timestamp);
+    CHECK(read[0].value.dbl == samples.back().value.dbl);
+}
@@ -13,11 +13,19 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <atomic>
 #include <catch2/catch.hpp>
 #include <dcgm_agent.h>
+#include <dirent.h>
+#include <map>
+#include <numeric>
 #include <sstream>
+#include <unistd.h>
+#include <vector>
 
 #include <DcgmCacheManager.h>
+#include <DcgmCacheSnapshot.h>
+#include <nvml_loader/nvml_loader_hook.h>
 
 
 TEST_CASE("CacheManager: Test GetGpuId")
@@ -150,3 +158,1897 @@ TEST_CASE("CacheManager: CUDA_VISIBLE_DEVICES")
     tmp << "MIG-GPU-00000000-0000-0000-0000-000000000000/0/0"; // Dummy UUID because this is a fake GPU
     CHECK(buf.str() == tmp.str());
 }
+
+TEST_CASE("CacheManager: Lock-free latest values")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    dcgmcm_sample_t sample {};
+
+    /* No watch yet. This goes through the locked path */
+    REQUIRE(cm.GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, nullptr) == DCGM_ST_NOT_WATCHED);
+
+    sample.timestamp = 1000;
+    sample.val.i64   = 50;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    sample.timestamp = 2000;
+    sample.val.i64   = 51;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+
+    memset(&sample, 0, sizeof(sample));
+    REQUIRE(cm.GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, nullptr) == DCGM_ST_OK);
+    CHECK(sample.timestamp == 2000);
+    CHECK(sample.val.i64 == 51);
+
+    sample.timestamp = 3000;
+    sample.val.d     = 12.5;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+
+    /* Add enough watches to make the index grow a few times */
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+        sample.timestamp = 4000 + i;
+        sample.val.i64   = i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_SWITCH, i, DCGM_FI_DEV_NVSWITCH_LATENCY_LOW_P00, &sample, 1) == DCGM_ST_OK);
+    }
+
+    DcgmFvBuffer fvBuffer;
+    std::vector<dcgmGroupEntityPair_t> entities { { DCGM_FE_GPU, gpuId } };
+    std::vector<unsigned short> multiFieldIds { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE, DCGM_FI_DEV_SM_CLOCK };
+    REQUIRE(cm.GetMultipleLatestSamples(entities, multiFieldIds, &fvBuffer) == DCGM_ST_OK);
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    dcgmBufferedFv_t *fv          = fvBuffer.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldId == DCGM_FI_DEV_GPU_TEMP);
+    CHECK(fv->value.i64 == 51);
+    fv = fvBuffer.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldId == DCGM_FI_DEV_POWER_USAGE);
+    CHECK(fv->value.dbl == 12.5);
+    CHECK(fv->timestamp == 3000);
+    fv = fvBuffer.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldId == DCGM_FI_DEV_SM_CLOCK);
+    CHECK(fv->status == DCGM_ST_NOT_WATCHED);
+
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+        REQUIRE(cm.GetLatestSample(DCGM_FE_SWITCH, i, DCGM_FI_DEV_NVSWITCH_LATENCY_LOW_P00, &sample, nullptr)
+                == DCGM_ST_OK);
+        CHECK(sample.val.i64 == (long long)i);
+    }
+
+    /* Clearing the cache must not leave a stale lock-free value behind */
+    REQUIRE(cm.EmptyCache() == DCGM_ST_OK);
+    CHECK(cm.GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, nullptr) == DCGM_ST_NOT_WATCHED);
+}
+
+TEST_CASE("CacheManager: Value views")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    dcgmcm_sample_t sample {};
+
+    for (long long i = 1; i <= 10; i++)
+    {
+        sample.timestamp = i * 1000;
+        sample.val.i64   = i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    }
+
+    dcgmValueView_v1 views[4] {};
+    for (dcgmValueView_v1 &view : views)
+    {
+        view.version       = dcgmValueView_version1;
+        view.entityGroupId = DCGM_FE_GPU;
+        view.entityId      = gpuId;
+        view.fieldId       = DCGM_FI_DEV_GPU_TEMP;
+    }
+    views[1].sinceTimestamp = 7000;
+    views[2].maxCount       = 1;
+    views[3].fieldId        = DCGM_FI_DEV_POWER_USAGE;
+
+    CHECK(cm.ReleaseValueViews() == DCGM_ST_UNINITIALIZED);
+    REQUIRE(cm.AcquireValueViews(views, 4) == DCGM_ST_OK);
+
+    std::vector<long long> values;
+    REQUIRE(views[0].status == DCGM_ST_OK);
+    CHECK(views[0].fieldType == DCGM_FT_INT64);
+    for (int i = 0; i < views[0].numSpans; i++)
+    {
+        auto spanValues = static_cast<long long const *>(views[0].spans[i].values);
+        for (int j = 0; j < views[0].spans[i].count; j++)
+        {
+            CHECK(views[0].spans[i].timestamps[j] == spanValues[j] * 1000);
+            values.push_back(spanValues[j]);
+        }
+    }
+    CHECK(values == std::vector<long long> { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 });
+
+    REQUIRE(views[1].status == DCGM_ST_OK);
+    REQUIRE(views[1].numSpans == 1);
+    CHECK(views[1].spans[0].count == 3);
+    CHECK(static_cast<long long const *>(views[1].spans[0].values)[0] == 8);
+
+    REQUIRE(views[2].status == DCGM_ST_OK);
+    REQUIRE(views[2].numSpans == 1);
+    CHECK(views[2].spans[0].count == 1);
+    CHECK(views[2].spans[0].timestamps[0] == 10000);
+
+    CHECK(views[3].status == DCGM_ST_NOT_WATCHED);
+    CHECK(views[3].numSpans == 0);
+
+    /* Views nest, and the cache manager stays locked until the outer one is released */
+    REQUIRE(cm.AcquireValueViews(views, 1) == DCGM_ST_OK);
+    CHECK(cm.ReleaseValueViews() == DCGM_ST_OK);
+    CHECK(cm.ReleaseValueViews() == DCGM_ST_OK);
+    CHECK(cm.ReleaseValueViews() == DCGM_ST_UNINITIALIZED);
+
+    views[0].version = 0;
+    REQUIRE(cm.AcquireValueViews(views, 1) == DCGM_ST_OK);
+    CHECK(views[0].status == DCGM_ST_VER_MISMATCH);
+    CHECK(cm.ReleaseValueViews() == DCGM_ST_OK);
+}
+
+TEST_CASE("CacheManager: Latest values since an update sequence")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    dcgmcm_sample_t sample {};
+
+    std::vector<dcgmGroupEntityPair_t> entities { { DCGM_FE_GPU, gpuId } };
+    std::vector<unsigned short> fieldIds { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE };
+
+    sample.timestamp = 1000;
+    sample.val.i64   = 50;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    sample.val.d = 12.5;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+
+    unsigned long long updateSequence = 0;
+    size_t bufferSize = 0, elementCount = 0;
+    DcgmFvBuffer all;
+    REQUIRE(cm.GetMultipleLatestSamples(entities, fieldIds, &all, 0, &updateSequence) == DCGM_ST_OK);
+    all.GetSize(&bufferSize, &elementCount);
+    CHECK(elementCount == 2);
+    CHECK(updateSequence > 0);
+    CHECK(cm.GetWatchUpdateSequence(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP) <= updateSequence);
+    CHECK(cm.GetWatchUpdateSequence(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_SM_CLOCK) == 0);
+
+    /* Nothing changed */
+    unsigned long long sinceSequence = updateSequence;
+    DcgmFvBuffer none;
+    REQUIRE(cm.GetMultipleLatestSamples(entities, fieldIds, &none, sinceSequence, &updateSequence) == DCGM_ST_OK);
+    none.GetSize(&bufferSize, &elementCount);
+    CHECK(elementCount == 0);
+    CHECK(updateSequence == sinceSequence);
+
+    sample.timestamp = 2000;
+    sample.val.i64   = 51;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+
+    DcgmFvBuffer changed;
+    REQUIRE(cm.GetMultipleLatestSamples(entities, fieldIds, &changed, sinceSequence, &updateSequence) == DCGM_ST_OK);
+    CHECK(updateSequence > sinceSequence);
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    dcgmBufferedFv_t *fv          = changed.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldId == DCGM_FI_DEV_GPU_TEMP);
+    CHECK(fv->value.i64 == 51);
+    CHECK(changed.GetNextFv(&cursor) == nullptr);
+}
+
+TEST_CASE("CacheManager: Samples after a position")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    dcgmcm_sample_t sample {};
+
+    for (int i = 1; i <= 10; i++)
+    {
+        sample.timestamp = i * 1000;
+        sample.val.i64   = i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    }
+
+    timeseries_position_t position {};
+    dcgmcm_sample_t samples[4] {};
+    std::vector<long long> values;
+    for (;;)
+    {
+        int count = 4;
+        dcgmReturn_t dcgmReturn
+            = cm.GetSamplesAfter(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples, &count, &position);
+        if (dcgmReturn == DCGM_ST_NO_DATA)
+            break;
+        REQUIRE(dcgmReturn == DCGM_ST_OK);
+        for (int i = 0; i < count; i++)
+            values.push_back(samples[i].val.i64);
+    }
+
+    CHECK(values == std::vector<long long> { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 });
+    CHECK(position.usecSince1970 == 10000);
+
+    sample.timestamp = 11000;
+    sample.val.i64   = 11;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+
+    int count = 4;
+    REQUIRE(cm.GetSamplesAfter(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples, &count, &position) == DCGM_ST_OK);
+    REQUIRE(count == 1);
+    CHECK(samples[0].val.i64 == 11);
+
+    count = 4;
+    CHECK(cm.GetSamplesAfter(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_SM_CLOCK, samples, &count, &position)
+          == DCGM_ST_NOT_WATCHED);
+}
+
+TEST_CASE("CacheManager: Snapshot save and load")
+{
+    DcgmFieldsInit();
+    char filename[] = "/tmp/dcgmCacheSnapshotXXXXXX";
+    int fd          = mkstemp(filename);
+    REQUIRE(fd >= 0);
+    close(fd);
+
+    timelib64_t now = timelib_usecSince1970();
+    dcgmcm_sample_t sample {};
+
+    {
+        DcgmCacheManager cm;
+        unsigned int gpuId = cm.AddFakeGpu();
+
+        for (int i = 0; i < 10; i++)
+        {
+            sample.timestamp = now - 10000 + i;
+            sample.val.i64   = 100 + i;
+            REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+        }
+
+        sample.timestamp = now - 5000;
+        sample.val.d     = 250.5;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+
+        char driverVersion[] = "450.00";
+        sample.timestamp     = now - 4000;
+        sample.val.str       = driverVersion;
+        sample.val2.ptrSize  = sizeof(driverVersion);
+        REQUIRE(cm.InjectSamples(DCGM_FE_NONE, 0, DCGM_FI_DRIVER_VERSION, &sample, 1) == DCGM_ST_OK);
+
+        /* Instance IDs don't survive a restart */
+        unsigned int instanceId = cm.AddFakeInstance(gpuId);
+        sample.timestamp        = now - 3000;
+        sample.val.i64          = 7;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU_I, instanceId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+
+        REQUIRE(cm.SaveSnapshot(filename) == DCGM_ST_OK);
+    }
+
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    unsigned int instanceId = cm.AddFakeInstance(gpuId);
+    REQUIRE(cm.LoadSnapshot(filename) == DCGM_ST_OK);
+
+    dcgmcm_sample_t samples[20] {};
+    int numSamples = 20;
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples, &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    REQUIRE(numSamples == 10);
+    for (int i = 0; i < numSamples; i++)
+    {
+        CHECK(samples[i].timestamp == now - 10000 + i);
+        CHECK(samples[i].val.i64 == 100 + i);
+    }
+
+    REQUIRE(cm.GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, nullptr) == DCGM_ST_OK);
+    CHECK(sample.val.d == 250.5);
+    CHECK(sample.timestamp == now - 5000);
+
+    dcgmcm_sample_t stringSample {};
+    REQUIRE(cm.GetLatestSample(DCGM_FE_NONE, 0, DCGM_FI_DRIVER_VERSION, &stringSample, nullptr) == DCGM_ST_OK);
+    CHECK(std::string(stringSample.val.str) == "450.00");
+    free(stringSample.val.str);
+
+    CHECK(cm.GetLatestSample(DCGM_FE_GPU_I, instanceId, DCGM_FI_DEV_GPU_TEMP, &sample, nullptr) != DCGM_ST_OK);
+
+    /* Samples are never restored on top of newer ones */
+    REQUIRE(cm.LoadSnapshot(filename) == DCGM_ST_OK);
+    numSamples = 20;
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples, &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    CHECK(numSamples == 10);
+
+    /* Missing and malformed files are refused */
+    unlink(filename);
+    CHECK(cm.LoadSnapshot(filename) == DCGM_ST_NO_DATA);
+    FILE *fp = fopen(filename, "w");
+    REQUIRE(fp != nullptr);
+    fputs("not a snapshot", fp);
+    fclose(fp);
+    CHECK(cm.LoadSnapshot(filename) == DCGM_ST_GENERIC_ERROR);
+    unlink(filename);
+}
+
+TEST_CASE("CacheManager: Snapshot records of the wrong type")
+{
+    DcgmFieldsInit();
+    char filename[] = "/tmp/dcgmCacheSnapshotXXXXXX";
+    int fd          = mkstemp(filename);
+    REQUIRE(fd >= 0);
+    close(fd);
+
+    timelib64_t now      = timelib_usecSince1970();
+    timelib64_t times[2] = { now - 2000, now - 1000 };
+    long long val[2]     = { 4, 5 };
+    long long val2[2]    = { 0, 0 };
+    dcgm_cache_snapshot_header_t header {};
+    DcgmCacheSnapshotWriter writer(filename);
+    REQUIRE(writer.Open() == DCGM_ST_OK);
+
+    dcgm_cache_snapshot_record_t record {};
+    record.entityGroupId = DCGM_FE_NONE;
+    record.fieldId       = DCGM_FI_DEV_COUNT;
+    record.tsType        = TS_TYPE_INT64;
+    record.numSamples    = 2;
+    REQUIRE(writer.AddNumericRecord(&record, times, val, val2) == DCGM_ST_OK);
+
+    /* A string field with numeric samples */
+    record               = {};
+    record.entityGroupId = DCGM_FE_NONE;
+    record.fieldId       = DCGM_FI_DRIVER_VERSION;
+    record.tsType        = TS_TYPE_INT64;
+    record.numSamples    = 2;
+    REQUIRE(writer.AddNumericRecord(&record, times, val, val2) == DCGM_ST_OK);
+    REQUIRE(writer.Finish(&header) == DCGM_ST_OK);
+
+    DcgmCacheManager cm;
+    REQUIRE(cm.LoadSnapshot(filename) == DCGM_ST_OK);
+    unlink(filename);
+
+    dcgmcm_sample_t sample {};
+    REQUIRE(cm.GetLatestSample(DCGM_FE_NONE, 0, DCGM_FI_DEV_COUNT, &sample, nullptr) == DCGM_ST_OK);
+    CHECK(sample.val.i64 == 5);
+
+    CHECK(cm.GetLatestSample(DCGM_FE_NONE, 0, DCGM_FI_DRIVER_VERSION, &sample, nullptr) != DCGM_ST_OK);
+}
+
+TEST_CASE("CacheManager: Rollup tiers")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    timelib64_t const second = 1000000;
+    std::vector<dcgmcm_rollup_tier_config_t> tiers { { 1 * second, 600 * second }, { 10 * second, 1800 * second } };
+    CHECK(cm.SetRollupTiers(10 * second, { { 10 * second, 600 * second }, { 1 * second, 1800 * second } })
+          == DCGM_ST_BADPARAM);
+    REQUIRE(cm.SetRollupTiers(10 * second, tiers) == DCGM_ST_OK);
+
+    /* One sample a second for 20 minutes, lined up with the 10 second buckets */
+    timelib64_t base = (timelib_usecSince1970() / (10 * second)) * (10 * second) - 1200 * second;
+    dcgmcm_sample_t sample {};
+    for (int i = 0; i < 1200; i++)
+    {
+        sample.timestamp = base + i * second;
+        sample.val.i64   = i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    }
+
+    /* Only 10 seconds of raw samples are kept. The 1 second tier answers for the rest of the last 10 minutes */
+    std::vector<dcgmcm_sample_t> samples(1200);
+    int numSamples = (int)samples.size();
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU,
+                          gpuId,
+                          DCGM_FI_DEV_GPU_TEMP,
+                          samples.data(),
+                          &numSamples,
+                          base + 900 * second,
+                          0,
+                          DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    REQUIRE(numSamples == 300);
+    for (int i = 0; i < numSamples; i++)
+    {
+        CHECK(samples[i].timestamp == base + (900 + i) * second);
+        CHECK(samples[i].val.i64 == 900 + i);
+    }
+
+    numSamples = (int)samples.size();
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU,
+                          gpuId,
+                          DCGM_FI_DEV_GPU_TEMP,
+                          samples.data(),
+                          &numSamples,
+                          base + 900 * second,
+                          0,
+                          DCGM_ORDER_DESCENDING)
+            == DCGM_ST_OK);
+    REQUIRE(numSamples == 300);
+    CHECK(samples[0].val.i64 == 1199);
+    CHECK(samples[299].val.i64 == 900);
+
+    /* The whole window comes from the 10 second tier. Its bucket that overlaps the raw samples is left out */
+    DcgmcmSummaryType_t summaryTypes[] = { DcgmcmSummaryTypeMinimum,
+                                           DcgmcmSummaryTypeMaximum,
+                                           DcgmcmSummaryTypeCount,
+                                           DcgmcmSummaryTypeSum };
+    long long summaryValues[4] {};
+    REQUIRE(cm.GetInt64SummaryData(
+                DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 4, summaryTypes, summaryValues, 0, 0, nullptr, nullptr)
+            == DCGM_ST_OK);
+    CHECK(summaryValues[0] == 0);
+    CHECK(summaryValues[1] == 1199);
+    CHECK(summaryValues[2] == 1180 + 11);
+    CHECK(summaryValues[3] == 1179 * 1180 / 2 + (1189 + 1199) * 11 / 2);
+
+    REQUIRE(cm.GetInt64SummaryData(DCGM_FE_GPU,
+                                   gpuId,
+                                   DCGM_FI_DEV_GPU_TEMP,
+                                   4,
+                                   summaryTypes,
+                                   summaryValues,
+                                   base + 900 * second,
+                                   base + 1000 * second,
+                                   nullptr,
+                                   nullptr)
+            == DCGM_ST_OK);
+    CHECK(summaryValues[0] == 900);
+    CHECK(summaryValues[1] == 1000);
+    CHECK(summaryValues[2] == 101);
+
+    /* Turning rollups off drops them on the next sample */
+    REQUIRE(cm.SetRollupTiers(0, {}) == DCGM_ST_OK);
+    sample.timestamp = base + 1200 * second;
+    sample.val.i64   = 1200;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    numSamples = (int)samples.size();
+    REQUIRE(cm.GetSamples(
+                DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples.data(), &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    CHECK(numSamples == 12);
+}
+
+TEST_CASE("CacheManager: Spilled samples")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    char directory[] = "/tmp/dcgm-cache-spill-XXXXXX";
+    REQUIRE(mkdtemp(directory) != nullptr);
+    CHECK(cm.SetSpill("/proc/no-such-dir/spill", 0) == DCGM_ST_GENERIC_ERROR);
+    REQUIRE(cm.SetSpill(directory, 0) == DCGM_ST_OK);
+
+    /* Only 10 seconds of raw samples are kept. The rest is spilled and rolled up */
+    timelib64_t const second = 1000000;
+    REQUIRE(cm.SetRollupTiers(10 * second, { { 10 * second, 1800 * second } }) == DCGM_ST_OK);
+
+    timelib64_t base = (timelib_usecSince1970() / (10 * second)) * (10 * second) - 1200 * second;
+    dcgmcm_sample_t sample {};
+    for (int i = 0; i < 1200; i++)
+    {
+        sample.timestamp = base + i * second;
+        sample.val.i64   = i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    }
+
+    /* Every sample comes back as it was, not as the averages of the rollup */
+    std::vector<dcgmcm_sample_t> samples(1500);
+    int numSamples = (int)samples.size();
+    REQUIRE(cm.GetSamples(
+                DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples.data(), &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    REQUIRE(numSamples == 1200);
+    for (int i = 0; i < numSamples; i++)
+    {
+        CHECK(samples[i].timestamp == base + i * second);
+        CHECK(samples[i].val.i64 == i);
+    }
+
+    numSamples = 20;
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU,
+                          gpuId,
+                          DCGM_FI_DEV_GPU_TEMP,
+                          samples.data(),
+                          &numSamples,
+                          base + 100 * second,
+                          base + 1195 * second,
+                          DCGM_ORDER_DESCENDING)
+            == DCGM_ST_OK);
+    REQUIRE(numSamples == 20);
+    CHECK(samples[0].val.i64 == 1195);
+    CHECK(samples[19].val.i64 == 1176);
+
+    /* Turning the spill off keeps its files */
+    REQUIRE(cm.SetSpill("", 0) == DCGM_ST_OK);
+    REQUIRE(cm.SetSpill(directory, 0) == DCGM_ST_OK);
+    numSamples = 1;
+    REQUIRE(cm.GetSamples(
+                DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples.data(), &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    CHECK(samples[0].timestamp == base);
+
+    REQUIRE(cm.SetSpill("", 0) == DCGM_ST_OK);
+    DIR *dir = opendir(directory);
+    struct dirent *dirEntry;
+    while (dir != nullptr && (dirEntry = readdir(dir)) != nullptr)
+    {
+        unlink((std::string(directory) + "/" + dirEntry->d_name).c_str());
+    }
+    if (dir != nullptr)
+        closedir(dir);
+    rmdir(directory);
+}
+
+static bool UseAllEntries(timeseries_entry_p, void *)
+{
+    return true;
+}
+
+TEST_CASE("CacheManager: Summary windows")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    timelib64_t const second = 1000000;
+    timelib64_t base         = timelib_usecSince1970() - 1000 * second;
+    dcgmcm_sample_t sample {};
+
+    /* Before the window */
+    sample.timestamp = base - second;
+    sample.val.d     = 1000.0;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+
+    unsigned int windowId = 0;
+    CHECK(cm.AddSummaryWindow(0, &windowId) == DCGM_ST_BADPARAM);
+    REQUIRE(cm.AddSummaryWindow(base, &windowId) == DCGM_ST_OK);
+
+    for (int i = 0; i < 100; i++)
+    {
+        sample.timestamp = base + i * second;
+        sample.val.d     = (i % 10) + 0.5;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+    }
+
+    DcgmcmSummaryType_t summaryTypes[] = { DcgmcmSummaryTypeMinimum,   DcgmcmSummaryTypeMaximum,
+                                           DcgmcmSummaryTypeAverage,   DcgmcmSummaryTypeSum,
+                                           DcgmcmSummaryTypeCount,     DcgmcmSummaryTypeIntegral,
+                                           DcgmcmSummaryTypeDifference };
+    int const numSummaryTypes          = 7;
+    double windowValues[numSummaryTypes] {};
+    double walkedValues[numSummaryTypes] {};
+
+    auto getSummaries = [&](double *values, timelib64_t endTime, pfUseEntryForSummary pfUseEntryCB) {
+        return cm.GetFp64SummaryData(DCGM_FE_GPU,
+                                     gpuId,
+                                     DCGM_FI_DEV_POWER_USAGE,
+                                     numSummaryTypes,
+                                     summaryTypes,
+                                     values,
+                                     base,
+                                     endTime,
+                                     pfUseEntryCB,
+                                     nullptr);
+    };
+
+    /* The running summary matches a walk of the cache while the window is open */
+    REQUIRE(getSummaries(windowValues, timelib_usecSince1970(), nullptr) == DCGM_ST_OK);
+    REQUIRE(getSummaries(walkedValues, timelib_usecSince1970(), UseAllEntries) == DCGM_ST_OK);
+    for (int i = 0; i < numSummaryTypes; i++)
+    {
+        CHECK(windowValues[i] == Approx(walkedValues[i]));
+    }
+    CHECK(windowValues[0] == 0.5);
+    CHECK(windowValues[1] == 9.5);
+    CHECK(windowValues[4] == 100);
+
+    /* Out of order samples are picked up by rebuilding from the cache */
+    sample.timestamp = base + 50 * second + 1;
+    sample.val.d     = 20.0;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+    REQUIRE(getSummaries(windowValues, 0, nullptr) == DCGM_ST_OK);
+    CHECK(windowValues[1] == 20.0);
+    CHECK(windowValues[4] == 101);
+
+    /* Closed windows only match their own end */
+    REQUIRE(cm.CloseSummaryWindow(windowId, base + 99 * second) == DCGM_ST_OK);
+    sample.timestamp = base + 100 * second;
+    sample.val.d     = 30.0;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+    REQUIRE(getSummaries(windowValues, base + 99 * second, nullptr) == DCGM_ST_OK);
+    CHECK(windowValues[1] == 20.0);
+    CHECK(windowValues[4] == 101);
+
+    CHECK(cm.RemoveSummaryWindow(windowId) == DCGM_ST_OK);
+    CHECK(cm.RemoveSummaryWindow(windowId) == DCGM_ST_NO_DATA);
+    CHECK(cm.CloseSummaryWindow(windowId, base) == DCGM_ST_NO_DATA);
+}
+
+TEST_CASE("CacheManager: Summary windows outlive evicted samples")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    /* Rollups keep raw samples for 10 seconds, which makes eviction easy to trigger */
+    timelib64_t const second = 1000000;
+    REQUIRE(cm.SetRollupTiers(10 * second, { { 60 * second, 3600 * second } }) == DCGM_ST_OK);
+
+    timelib64_t base      = timelib_usecSince1970() - 1000 * second;
+    unsigned int windowId = 0;
+    REQUIRE(cm.AddSummaryWindow(base, &windowId) == DCGM_ST_OK);
+
+    dcgmcm_sample_t sample {};
+    for (int i = 0; i < 100; i++)
+    {
+        sample.timestamp = base + i * second;
+        sample.val.i64   = i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    }
+
+    DcgmcmSummaryType_t summaryTypes[] = { DcgmcmSummaryTypeMinimum, DcgmcmSummaryTypeCount };
+    long long summaryValues[2] {};
+    REQUIRE(cm.GetInt64SummaryData(
+                DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 2, summaryTypes, summaryValues, base, 0, nullptr, nullptr)
+            == DCGM_ST_OK);
+    CHECK(summaryValues[0] == 0);
+    CHECK(summaryValues[1] == 100);
+
+    /* Only the raw samples can be filtered */
+    REQUIRE(cm.GetInt64SummaryData(DCGM_FE_GPU,
+                                   gpuId,
+                                   DCGM_FI_DEV_GPU_TEMP,
+                                   2,
+                                   summaryTypes,
+                                   summaryValues,
+                                   base,
+                                   0,
+                                   UseAllEntries,
+                                   nullptr)
+            == DCGM_ST_OK);
+    CHECK(summaryValues[0] == 89);
+    CHECK(summaryValues[1] == 11);
+}
+
+TEST_CASE("CacheManager: Watch deadline alignment")
+{
+    timelib64_t const second = 1000000;
+    timelib64_t const base   = 1600000000 * second;
+
+    /* Off unless there is both a tick and a jitter budget */
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base + 123, second, 0) == base + 123);
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base + 123, 0, second) == base + 123);
+
+    /* Snaps to the nearest tick, in either direction, when it is within the budget */
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base, second, 1000) == base);
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base + 400, second, 1000) == base);
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base - 400, second, 1000) == base);
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base + 5000, second, 1000) == base + 5000);
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base + second / 2, second, 1000) == base + second / 2);
+
+    /* Ticks finer than the budget are widened to it */
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base + 7, 10, 1000) == base);
+    CHECK(DcgmCacheManager::AlignWatchDeadline(base + 600, 10, 1000) == base + 1000);
+}
+
+TEST_CASE("CacheManager: Event-backed fields")
+{
+    CHECK(DcgmCacheManager::NvmlEventTypeForField(DCGM_FI_DEV_ECC_SBE_VOL_TOTAL) == nvmlEventTypeSingleBitEccError);
+    CHECK(DcgmCacheManager::NvmlEventTypeForField(DCGM_FI_DEV_ECC_SBE_AGG_TOTAL) == nvmlEventTypeSingleBitEccError);
+    CHECK(DcgmCacheManager::NvmlEventTypeForField(DCGM_FI_DEV_ECC_DBE_VOL_TOTAL) == nvmlEventTypeDoubleBitEccError);
+    CHECK(DcgmCacheManager::NvmlEventTypeForField(DCGM_FI_DEV_ECC_DBE_AGG_TOTAL) == nvmlEventTypeDoubleBitEccError);
+    CHECK(DcgmCacheManager::NvmlEventTypeForField(DCGM_FI_DEV_PSTATE) == nvmlEventTypePState);
+    CHECK(DcgmCacheManager::NvmlEventTypeForField(DCGM_FI_DEV_GPU_TEMP) == 0);
+    CHECK(DcgmCacheManager::NvmlEventTypeForField(DCGM_FI_DEV_XID_ERRORS) == 0);
+}
+
+TEST_CASE("CacheManager: Indexed accounting lookups")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    auto inject = [&](unsigned int pid, unsigned int gpuUtil, timelib64_t timestamp) {
+        dcgmDevicePidAccountingStats_t stats {};
+        stats.version        = dcgmDevicePidAccountingStats_version;
+        stats.pid            = pid;
+        stats.gpuUtilization = gpuUtil;
+        stats.startTimestamp = 100;
+
+        dcgmcm_sample_t sample {};
+        sample.timestamp    = timestamp;
+        sample.val.blob     = &stats;
+        sample.val2.ptrSize = sizeof(stats);
+        return cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, &sample, 1);
+    };
+
+    REQUIRE(inject(10, 1, 1000) == DCGM_ST_OK);
+    REQUIRE(inject(11, 2, 1000) == DCGM_ST_OK); /* Moved past pid 10's record by the time series */
+    REQUIRE(inject(10, 3, 2000) == DCGM_ST_OK);
+
+    dcgmDevicePidAccountingStats_t pidInfo {};
+    REQUIRE(cm.GetLatestProcessInfo(gpuId, 10, &pidInfo) == DCGM_ST_OK);
+    CHECK(pidInfo.gpuUtilization == 3);
+    REQUIRE(cm.GetLatestProcessInfo(gpuId, 11, &pidInfo) == DCGM_ST_OK);
+    CHECK(pidInfo.gpuUtilization == 2);
+
+    dcgmReturn_t ret = cm.GetLatestProcessInfo(gpuId, 12, &pidInfo);
+    CHECK((ret == DCGM_ST_NO_DATA || ret == DCGM_ST_NOT_WATCHED));
+}
+
+TEST_CASE("CacheManager: PID stats index")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    cm.AddFakeGpu();
+    unsigned int gpuId1 = cm.AddFakeGpu();
+
+    dcgmDevicePidAccountingStats_t stats {};
+    stats.version = dcgmDevicePidAccountingStats_version;
+    stats.pid     = 10;
+
+    dcgmcm_sample_t sample {};
+    sample.timestamp    = 1000;
+    sample.val.blob     = &stats;
+    sample.val2.ptrSize = sizeof(stats);
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId1, DCGM_FI_DEV_ACCOUNTING_DATA, &sample, 1) == DCGM_ST_OK);
+
+    /* pid 10 at 40 and 60 while pid 11 runs alongside it */
+    double const utils[][2] = { { 40, 10 }, { 30, 11 }, { 60, 10 }, { 50, 11 } };
+    for (auto const &util : utils)
+    {
+        dcgmcm_sample_t utilSample {};
+        utilSample.timestamp = sample.timestamp++;
+        utilSample.val.d     = util[0];
+        utilSample.val2.d    = util[1];
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId1, DCGM_FI_DEV_GPU_UTIL_SAMPLES, &utilSample, 1) == DCGM_ST_OK);
+    }
+
+    std::vector<dcgmcm_pid_gpu_stats_t> pidStats;
+    REQUIRE(cm.GetPidStats(10, pidStats) == DCGM_ST_OK);
+    REQUIRE(pidStats.size() == 1);
+    CHECK(pidStats[0].gpuId == gpuId1);
+    CHECK(pidStats[0].haveAccounting);
+    CHECK(pidStats[0].haveSmUtil);
+    CHECK(!pidStats[0].haveMemUtil);
+    /* Averaged over every process's samples from its first through its last */
+    CHECK(DcgmCacheManager::PidUtilization(pidStats[0].smUtil) == Approx(100.0 / 3));
+    CHECK(DcgmCacheManager::PidUtilization(pidStats[0].memUtil) == DCGM_INT32_BLANK);
+
+    REQUIRE(cm.GetPidStats(11, pidStats) == DCGM_ST_OK);
+    CHECK(!pidStats[0].haveAccounting);
+    CHECK(DcgmCacheManager::PidUtilization(pidStats[0].smUtil) == Approx(80.0 / 3));
+
+    CHECK(cm.GetPidStats(12, pidStats) == DCGM_ST_NO_DATA);
+    CHECK(pidStats.empty());
+
+    cm.EmptyCache();
+    CHECK(cm.GetPidStats(10, pidStats) == DCGM_ST_NO_DATA);
+}
+
+TEST_CASE("CacheManager: Processes in a window")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    /* pid 20 ran from 1000 to 1500. pid 21 started at 3000 and is still running */
+    dcgmDevicePidAccountingStats_t stats {};
+    stats.version        = dcgmDevicePidAccountingStats_version;
+    stats.pid            = 20;
+    stats.startTimestamp = 1000;
+    stats.activeTimeUsec = 500;
+
+    dcgmcm_sample_t sample {};
+    sample.timestamp    = 1500;
+    sample.val.blob     = &stats;
+    sample.val2.ptrSize = sizeof(stats);
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, &sample, 1) == DCGM_ST_OK);
+    stats.pid            = 21;
+    stats.startTimestamp = 3000;
+    stats.activeTimeUsec = 0;
+    sample.timestamp     = 3000;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, &sample, 1) == DCGM_ST_OK);
+
+    std::vector<dcgm_process_interval_t> processes;
+    REQUIRE(cm.GetProcessesInWindow(gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, 1200, 2000, processes) == DCGM_ST_OK);
+    REQUIRE(processes.size() == 1);
+    CHECK(processes[0].pid == 20);
+    CHECK(processes[0].endUsec == 1500);
+    REQUIRE(cm.GetProcessesInWindow(gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, 1600, 0, processes) == DCGM_ST_OK);
+    REQUIRE(processes.size() == 1);
+    CHECK(processes[0].pid == 21);
+    CHECK(cm.GetProcessesInWindow(gpuId, DCGM_FI_DEV_GPU_TEMP, 0, 0, processes) == DCGM_ST_BADPARAM);
+
+    /* pid 30 is seen from 100 through 300, pid 31 only at 200 */
+    unsigned int const seen[][2] = { { 100, 30 }, { 200, 30 }, { 200, 31 }, { 300, 30 } };
+    for (auto const &pidSeen : seen)
+    {
+        dcgmRunningProcess_t proc {};
+        proc.version = dcgmRunningProcess_version;
+        proc.pid     = pidSeen[1];
+
+        dcgmcm_sample_t procSample {};
+        procSample.timestamp    = pidSeen[0];
+        procSample.val.blob     = &proc;
+        procSample.val2.ptrSize = sizeof(proc);
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_COMPUTE_PIDS, &procSample, 1) == DCGM_ST_OK);
+    }
+
+    /* No sample of pid 30 falls in the window, but it was running */
+    unsigned int pids[4];
+    unsigned int numPids = 4;
+    REQUIRE(cm.GetUniquePidLists(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_COMPUTE_PIDS, 0, pids, &numPids, 250, 280)
+            == DCGM_ST_OK);
+    REQUIRE(numPids == 1);
+    CHECK(pids[0] == 30);
+
+    numPids = 4;
+    REQUIRE(cm.GetUniquePidLists(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_COMPUTE_PIDS, 30, pids, &numPids, 0, 0)
+            == DCGM_ST_OK);
+    REQUIRE(numPids == 1);
+    CHECK(pids[0] == 31);
+
+    cm.EmptyCache();
+    REQUIRE(cm.GetProcessesInWindow(gpuId, DCGM_FI_DEV_ACCOUNTING_DATA, 0, 0, processes) == DCGM_ST_OK);
+    CHECK(processes.empty());
+}
+
+TEST_CASE("CacheManager: Snapshot groups")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId0 = cm.AddFakeGpu();
+    unsigned int gpuId1 = cm.AddFakeGpu();
+
+    DcgmWatcher watcher(DcgmWatcherTypeClient, 1);
+    std::vector<dcgmcm_entity_key_t> keys;
+    for (unsigned int gpuId : { gpuId0, gpuId1 })
+    {
+        for (unsigned short fieldId : { DCGM_FI_DEV_POWER_USAGE, DCGM_FI_DEV_SM_CLOCK })
+        {
+            REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, fieldId, 100000, 3600.0, 0, watcher, false) == DCGM_ST_OK);
+
+            dcgmcm_entity_key_t key {};
+            key.entityGroupId = DCGM_FE_GPU;
+            key.entityId      = gpuId;
+            key.fieldId       = fieldId;
+            keys.push_back(key);
+        }
+    }
+
+    /* Unwatched fields are left out */
+    dcgmcm_entity_key_t unwatched {};
+    unwatched.entityGroupId = DCGM_FE_GPU;
+    unwatched.entityId      = gpuId0;
+    unwatched.fieldId       = DCGM_FI_DEV_GPU_TEMP;
+    CHECK(cm.AddSnapshotGroup({ unwatched }, watcher) == DCGM_ST_NOT_WATCHED);
+
+    keys.push_back(unwatched);
+    unsigned int firstGroupId = 0;
+    REQUIRE(cm.AddSnapshotGroup(keys, watcher, &firstGroupId) == DCGM_ST_OK);
+    CHECK(firstGroupId != 0);
+
+    /* Moving every watch to another group leaves a new group */
+    unsigned int secondGroupId = 0;
+    REQUIRE(cm.AddSnapshotGroup(keys, watcher, &secondGroupId) == DCGM_ST_OK);
+    CHECK(secondGroupId != firstGroupId);
+
+    cm.OnConnectionRemove(1);
+    CHECK(cm.AddSnapshotGroup(keys, watcher) == DCGM_ST_NOT_WATCHED);
+}
+
+TEST_CASE("CacheManager: Memory budget")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    timelib64_t const second = 1000000;
+    DcgmWatcher tempWatcher(DcgmWatcherTypeClient, 1);
+    DcgmWatcher powerWatcher(DcgmWatcherTypeClient, 2);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, second, 3600.0, 0, tempWatcher, false)
+            == DCGM_ST_OK);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, second, 3600.0, 0, powerWatcher, false)
+            == DCGM_ST_OK);
+
+    timelib64_t base = timelib_usecSince1970() - 3000 * second;
+    dcgmcm_sample_t sample {};
+    for (int i = 0; i < 3000; i++)
+    {
+        sample.timestamp = base + i * second;
+        sample.val.i64   = i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+        sample.val.d = i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+    }
+
+    /* Only the power history has been read */
+    int numSamples = 1;
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+
+    std::vector<dcgmcm_watcher_bytes_t> watcherBytes;
+    cm.GetWatcherBytesUsed(watcherBytes);
+    REQUIRE(watcherBytes.size() == 2);
+    CHECK(watcherBytes[0].bytesUsed >= watcherBytes[1].bytesUsed);
+    CHECK(watcherBytes[1].bytesUsed > 0);
+    long long totalBytes = watcherBytes[0].bytesUsed + watcherBytes[1].bytesUsed;
+
+    /* No budget, nothing to do */
+    CHECK(cm.EnforceCacheMemoryBudget(true) == 0);
+
+    auto getFieldInfo = [&](unsigned short fieldId) {
+        dcgmCacheManagerFieldInfo_t fieldInfo {};
+        fieldInfo.version = dcgmCacheManagerFieldInfo_version;
+        fieldInfo.gpuId   = gpuId;
+        fieldInfo.fieldId = fieldId;
+        REQUIRE(cm.GetCacheManagerFieldInfo(&fieldInfo) == DCGM_ST_OK);
+        return fieldInfo;
+    };
+
+    /* Just over the budget. The temperature history was never read, so it goes first */
+    cm.SetCacheMemoryBudget(totalBytes - 1);
+    CHECK(cm.EnforceCacheMemoryBudget(true) == 1);
+
+    dcgmCacheManagerFieldInfo_t tempInfo = getFieldInfo(DCGM_FI_DEV_GPU_TEMP);
+    CHECK(tempInfo.numSamples == 1);
+    CHECK(tempInfo.newestTimestamp == base + 2999 * second);
+    CHECK(tempInfo.lastReadUsec == 0);
+    CHECK(tempInfo.bytesUsed < totalBytes / 2);
+
+    dcgmCacheManagerFieldInfo_t powerInfo = getFieldInfo(DCGM_FI_DEV_POWER_USAGE);
+    CHECK(powerInfo.numSamples == 3000);
+    CHECK(powerInfo.lastReadUsec > 0);
+    REQUIRE(powerInfo.numWatchers == 1);
+    CHECK(powerInfo.watchers[0].connectionId == 2);
+    CHECK(powerInfo.watchers[0].bytesUsed == powerInfo.bytesUsed);
+
+    /* Now under the budget */
+    CHECK(cm.EnforceCacheMemoryBudget(true) == 0);
+    CHECK(getFieldInfo(DCGM_FI_DEV_POWER_USAGE).numSamples == 3000);
+}
+
+TEST_CASE("CacheManager: Watch cost estimates")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    timelib64_t const second = 1000000;
+    std::vector<dcgmGroupEntityPair_t> entities { { DCGM_FE_GPU, gpuId } };
+    std::vector<unsigned short> tempField { DCGM_FI_DEV_GPU_TEMP };
+
+    auto estimate = [&](std::vector<unsigned short> const &fieldIds, timelib64_t frequencyUsec) {
+        dcgmIntrospectWatchCost_t cost {};
+        cost.version = dcgmIntrospectWatchCost_version;
+        REQUIRE(cm.EstimateWatchCost(entities, fieldIds, frequencyUsec, 10.0, 0, cost) == DCGM_ST_OK);
+        REQUIRE(cost.numFields == fieldIds.size());
+        return cost;
+    };
+
+    /* Nothing is watched or measured yet, so all of it is new */
+    dcgmIntrospectWatchCost_t cost = estimate(tempField, second);
+    CHECK(cost.fields[0].fieldId == DCGM_FI_DEV_GPU_TEMP);
+    CHECK(cost.fields[0].numEntities == 1);
+    CHECK(cost.fields[0].numMeasured == 0);
+    CHECK(cost.fields[0].numWatched == 0);
+    CHECK(cost.fields[0].samplesKept == 11);
+    CHECK(cost.cpuUsecPerSec > 0.0);
+    CHECK(cost.driverCallsPerSec == Approx(1.0));
+    CHECK(cost.cacheBytes == 11 * cost.fields[0].bytesPerSample);
+    CHECK(cost.marginalCpuUsecPerSec == Approx(cost.cpuUsecPerSec));
+    CHECK(cost.marginalDriverCallsPerSec == Approx(1.0));
+    CHECK(cost.marginalCacheBytes == cost.cacheBytes);
+    double const cpuUsecPerSec = cost.cpuUsecPerSec;
+
+    /* The same watch from someone else adds nothing. A faster one only adds the difference */
+    DcgmWatcher watcher(DcgmWatcherTypeClient, 1);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, second, 10.0, 0, watcher, false)
+            == DCGM_ST_OK);
+    cost = estimate(tempField, second);
+    CHECK(cost.fields[0].numWatched == 1);
+    CHECK(cost.cpuUsecPerSec == Approx(cpuUsecPerSec));
+    CHECK(cost.marginalCpuUsecPerSec == Approx(0.0));
+    CHECK(cost.marginalDriverCallsPerSec == Approx(0.0));
+    CHECK(cost.marginalCacheBytes == 0);
+
+    cost = estimate(tempField, second / 2);
+    CHECK(cost.cpuUsecPerSec == Approx(2 * cpuUsecPerSec));
+    CHECK(cost.marginalCpuUsecPerSec == Approx(cpuUsecPerSec));
+    CHECK(cost.marginalDriverCallsPerSec == Approx(1.0));
+
+    /* FB used and free come from one driver call per GPU */
+    cost = estimate({ DCGM_FI_DEV_FB_USED, DCGM_FI_DEV_FB_FREE }, second);
+    CHECK(cost.fields[0].fetchMethod != DCGM_INTROSPECT_FETCH_SINGLE);
+    CHECK(cost.fields[0].fetchMethod == cost.fields[1].fetchMethod);
+    CHECK(cost.driverCallsPerSec == Approx(1.0));
+    CHECK(cost.fields[0].driverCallsPerSec == Approx(0.5));
+
+    dcgmIntrospectWatchCost_t badCost {};
+    badCost.version = dcgmIntrospectWatchCost_version;
+    CHECK(cm.EstimateWatchCost(entities, tempField, 0, 10.0, 0, badCost) == DCGM_ST_BADPARAM);
+    CHECK(cm.EstimateWatchCost(entities, { DCGM_FI_MAX_FIELDS }, second, 10.0, 0, badCost) == DCGM_ST_UNKNOWN_FIELD);
+}
+
+TEST_CASE("CacheManager: Exec time histogram buckets")
+{
+    CHECK(DcgmCacheManager::GetExecTimeBucket(0) == 0);
+    CHECK(DcgmCacheManager::GetExecTimeBucket(1) == 0);
+    CHECK(DcgmCacheManager::GetExecTimeBucket(2) == 1);
+    CHECK(DcgmCacheManager::GetExecTimeBucket(3) == 1);
+    CHECK(DcgmCacheManager::GetExecTimeBucket(4) == 2);
+    CHECK(DcgmCacheManager::GetExecTimeBucket(1023) == 9);
+    CHECK(DcgmCacheManager::GetExecTimeBucket(1024) == 10);
+
+    /* An 80 ms driver call */
+    CHECK(DcgmCacheManager::GetExecTimeBucket(80000) == 16);
+
+    /* Everything past the last bucket is counted in it */
+    CHECK(DcgmCacheManager::GetExecTimeBucket(1LL << (DCGM_INTROSPECT_EXEC_TIME_BUCKETS - 1))
+          == DCGM_INTROSPECT_EXEC_TIME_BUCKETS - 1);
+    CHECK(DcgmCacheManager::GetExecTimeBucket(3600LL * 1000000) == DCGM_INTROSPECT_EXEC_TIME_BUCKETS - 1);
+
+    /* A watch that was never fetched has an empty histogram */
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    DcgmWatcher watcher(DcgmWatcherTypeClient, 1);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 1000000, 3600.0, 0, watcher, false)
+            == DCGM_ST_OK);
+
+    long long maxUsec = -1;
+    long long histogram[DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
+    memset(histogram, 0xff, sizeof(histogram));
+    REQUIRE(cm.GetGpuFieldExecTimeHistogram(gpuId, DCGM_FI_DEV_GPU_TEMP, &maxUsec, histogram) == DCGM_ST_OK);
+    CHECK(maxUsec == 0);
+    for (long long count : histogram)
+    {
+        CHECK(count == 0);
+    }
+    CHECK(cm.GetGpuFieldExecTimeHistogram(gpuId, DCGM_FI_DEV_GPU_TEMP, nullptr, histogram) == DCGM_ST_BADPARAM);
+}
+
+TEST_CASE("CacheManager: Sample lag histograms")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    long long maxUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT];
+    long long histogram[DCGM_INTROSPECT_LAG_STAGE_COUNT][DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
+
+    auto countSamples = [&](int stage) {
+        return std::accumulate(std::begin(histogram[stage]), std::end(histogram[stage]), 0LL);
+    };
+
+    /* A sample read 5 ms ago is at least that old once it is cached */
+    dcgmcm_sample_t sample {};
+    sample.timestamp = timelib_usecSince1970() - 5000;
+    sample.val.i64   = 50;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+
+    REQUIRE(cm.GetGpuFieldSampleLagHistogram(gpuId, DCGM_FI_DEV_GPU_TEMP, maxUsec, histogram) == DCGM_ST_OK);
+    long long insertUsec = maxUsec[DCGM_INTROSPECT_LAG_CACHE_INSERT];
+    CHECK(insertUsec >= 5000);
+    CHECK(histogram[DCGM_INTROSPECT_LAG_CACHE_INSERT][DcgmCacheManager::GetExecTimeBucket(insertUsec)] == 1);
+    CHECK(countSamples(DCGM_INTROSPECT_LAG_CACHE_INSERT) == 1);
+    CHECK(countSamples(DCGM_INTROSPECT_LAG_SUBSCRIBER_DISPATCH) == 0);
+    CHECK(countSamples(DCGM_INTROSPECT_LAG_IPC_SEND) == 0);
+
+    /* Sent 20 ms after it was read. Error entries and fields that aren't cached don't count */
+    DcgmFvBuffer fvBuffer;
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 50, sample.timestamp, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 0, sample.timestamp, DCGM_ST_NO_DATA);
+    fvBuffer.AddDoubleValue(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, 100.0, sample.timestamp, DCGM_ST_OK);
+    cm.RecordSampleLag(DCGM_INTROSPECT_LAG_IPC_SEND, fvBuffer, sample.timestamp + 20000);
+
+    REQUIRE(cm.GetGpuFieldSampleLagHistogram(gpuId, DCGM_FI_DEV_GPU_TEMP, maxUsec, histogram) == DCGM_ST_OK);
+    CHECK(maxUsec[DCGM_INTROSPECT_LAG_IPC_SEND] == 20000);
+    CHECK(histogram[DCGM_INTROSPECT_LAG_IPC_SEND][DcgmCacheManager::GetExecTimeBucket(20000)] == 1);
+    CHECK(countSamples(DCGM_INTROSPECT_LAG_IPC_SEND) == 1);
+    CHECK(maxUsec[DCGM_INTROSPECT_LAG_CACHE_INSERT] == insertUsec);
+
+    CHECK(cm.GetGpuFieldSampleLagHistogram(gpuId, DCGM_FI_DEV_GPU_TEMP, nullptr, histogram) == DCGM_ST_BADPARAM);
+}
+
+struct FvUpdatesSeen
+{
+    std::vector<DcgmWatcherType_t> watcherTypes;
+    std::vector<unsigned short> fieldIds;
+};
+
+static void OnFvUpdates(std::shared_ptr<DcgmFvBuffer const> const &fvBuffer,
+                        DcgmWatcherType_t *watcherTypes,
+                        int numWatcherTypes,
+                        void *userData)
+{
+    auto *seen = (FvUpdatesSeen *)userData;
+    for (int i = 0; i < numWatcherTypes; i++)
+    {
+        seen->watcherTypes.push_back(watcherTypes[i]);
+    }
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    for (dcgmBufferedFv_t const *fv = fvBuffer->GetNextFv(&cursor); fv; fv = fvBuffer->GetNextFv(&cursor))
+    {
+        seen->fieldIds.push_back(fv->fieldId);
+    }
+}
+
+TEST_CASE("CacheManager: Subscribers only get their own fields")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    FvUpdatesSeen seen;
+
+    dcgmcmEventSubscription_t sub {};
+    sub.type     = DcgmcmEventTypeFvUpdate;
+    sub.fn.fvCb  = OnFvUpdates;
+    sub.userData = &seen;
+    REQUIRE(cm.SubscribeForEvent(sub) == DCGM_ST_OK);
+
+    DcgmWatcher healthWatcher(DcgmWatcherTypeHealthWatch);
+    DcgmWatcher policyWatcher(DcgmWatcherTypePolicyManager);
+    DcgmWatcher clientWatcher(DcgmWatcherTypeClient, 1);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 1000000, 3600.0, 0, healthWatcher, true)
+            == DCGM_ST_OK);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 1000000, 3600.0, 0, clientWatcher, false)
+            == DCGM_ST_OK);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, 1000000, 3600.0, 0, policyWatcher, true)
+            == DCGM_ST_OK);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_MEMORY_TEMP, 1000000, 3600.0, 0, clientWatcher, false)
+            == DCGM_ST_OK);
+
+    dcgmcm_sample_t sample {};
+    sample.timestamp = timelib_usecSince1970();
+
+    /* Only the watcher type that subscribed to a field hears about it */
+    sample.val.i64 = 50;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    REQUIRE(seen.watcherTypes.size() == 1);
+    CHECK(seen.watcherTypes[0] == DcgmWatcherTypeHealthWatch);
+    CHECK(seen.fieldIds == std::vector<unsigned short> { DCGM_FI_DEV_GPU_TEMP });
+
+    sample.val.d = 100.0;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+    REQUIRE(seen.watcherTypes.size() == 2);
+    CHECK(seen.watcherTypes[1] == DcgmWatcherTypePolicyManager);
+    CHECK(seen.fieldIds == std::vector<unsigned short> { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE });
+
+    /* Nobody subscribed to this one */
+    sample.val.i64 = 40;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_MEMORY_TEMP, &sample, 1) == DCGM_ST_OK);
+    CHECK(seen.watcherTypes.size() == 2);
+    CHECK(seen.fieldIds.size() == 2);
+}
+
+TEST_CASE("CacheManager: Subscriber predicates")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    FvUpdatesSeen seen;
+
+    dcgmcmEventSubscription_t sub {};
+    sub.type     = DcgmcmEventTypeFvUpdate;
+    sub.fn.fvCb  = OnFvUpdates;
+    sub.userData = &seen;
+    REQUIRE(cm.SubscribeForEvent(sub) == DCGM_ST_OK);
+
+    DcgmWatcher healthWatcher(DcgmWatcherTypeHealthWatch);
+    DcgmWatcher policyWatcher(DcgmWatcherTypePolicyManager);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 1000000, 3600.0, 0, healthWatcher, true)
+            == DCGM_ST_OK);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 1000000, 3600.0, 0, policyWatcher, true)
+            == DCGM_ST_OK);
+
+    dcgmcm_predicate_t predicate {};
+    predicate.type         = DcgmcmPredicateGreater;
+    predicate.i64Threshold = 80;
+    REQUIRE(cm.SetWatchPredicate(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, DcgmWatcherTypePolicyManager, predicate)
+            == DCGM_ST_OK);
+
+    dcgmcm_sample_t sample {};
+    sample.timestamp = timelib_usecSince1970();
+
+    /* Only health is handed values at or under the threshold */
+    sample.val.i64 = 50;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    CHECK(seen.watcherTypes == std::vector<DcgmWatcherType_t> { DcgmWatcherTypeHealthWatch });
+
+    sample.timestamp++;
+    sample.val.i64 = 90;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    REQUIRE(seen.watcherTypes.size() == 3);
+
+    /* Bypassed, everything gets through */
+    seen = {};
+    cm.SetPredicatesBypassed(DcgmWatcherTypePolicyManager, true);
+    sample.timestamp++;
+    sample.val.i64 = 50;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    CHECK(seen.watcherTypes.size() == 2);
+    cm.SetPredicatesBypassed(DcgmWatcherTypePolicyManager, false);
+
+    /* Back to every value */
+    seen           = {};
+    predicate.type = DcgmcmPredicateAll;
+    REQUIRE(cm.SetWatchPredicate(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, DcgmWatcherTypePolicyManager, predicate)
+            == DCGM_ST_OK);
+    sample.timestamp++;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, 1) == DCGM_ST_OK);
+    CHECK(seen.watcherTypes.size() == 2);
+
+    predicate.type = DcgmcmPredicateCount;
+    CHECK(cm.SetWatchPredicate(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, DcgmWatcherTypePolicyManager, predicate)
+          == DCGM_ST_BADPARAM);
+
+    /* The rest of the predicates */
+    dcgmcm_watch_predicate_t changed {};
+    changed.predicate.type = DcgmcmPredicateChanged;
+    CHECK(DcgmCacheManager::PredicateMatches(changed, { true, 5, 0.0 }));
+    CHECK(!DcgmCacheManager::PredicateMatches(changed, { true, 5, 0.0 }));
+    CHECK(DcgmCacheManager::PredicateMatches(changed, { true, 6, 0.0 }));
+    CHECK(!DcgmCacheManager::PredicateMatches(changed, { true, DCGM_INT64_BLANK, 0.0 }));
+
+    dcgmcm_watch_predicate_t delta {};
+    delta.predicate.type         = DcgmcmPredicateDelta;
+    delta.predicate.dblThreshold = 1.0;
+    CHECK(DcgmCacheManager::PredicateMatches(delta, { false, 0, 10.0 }));
+    CHECK(!DcgmCacheManager::PredicateMatches(delta, { false, 0, 10.5 }));
+    CHECK(!DcgmCacheManager::PredicateMatches(delta, { false, 0, 10.9 }));
+    CHECK(DcgmCacheManager::PredicateMatches(delta, { false, 0, 8.5 }));
+
+    dcgmcm_watch_predicate_t bits {};
+    bits.predicate.type = DcgmcmPredicateBitsSet;
+    bits.predicate.mask = 0x6;
+    CHECK(DcgmCacheManager::PredicateMatches(bits, { true, 0x4, 0.0 }));
+    CHECK(!DcgmCacheManager::PredicateMatches(bits, { true, 0x9, 0.0 }));
+
+    dcgmcm_watch_predicate_t less {};
+    less.predicate.type         = DcgmcmPredicateLess;
+    less.predicate.dblThreshold = 2.5;
+    CHECK(DcgmCacheManager::PredicateMatches(less, { false, 0, 2.0 }));
+    CHECK(!DcgmCacheManager::PredicateMatches(less, { false, 0, DCGM_FP64_BLANK }));
+}
+
+TEST_CASE("CacheManager: Multiple samples in one query")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+    dcgmcm_sample_t sample {};
+
+    for (int i = 0; i < 4; i++)
+    {
+        sample.timestamp = 1000 * (i + 1);
+        sample.val.i64   = 10 + i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, &sample, 1) == DCGM_ST_OK);
+        sample.val.d = 100.0 + i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+    }
+
+    std::vector<dcgmcm_sample_query_t> queries {
+        { DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, DCGM_ORDER_ASCENDING },
+        { DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, DCGM_ORDER_DESCENDING },
+        { DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, DCGM_ORDER_DESCENDING },
+        { DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, DCGM_ORDER_DESCENDING },
+    };
+
+    /* One value per query, in order, with errors as statuses */
+    DcgmFvBuffer fvBuffer;
+    REQUIRE(cm.GetMultipleSamples(queries, 2000, 3000, 1, &fvBuffer) == DCGM_ST_OK);
+
+    dcgmBufferedFvCursor_t cursor = 0;
+    dcgmBufferedFv_t *fv          = fvBuffer.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldId == DCGM_FI_DEV_PCIE_REPLAY_COUNTER);
+    CHECK(fv->timestamp == 2000);
+    CHECK(fv->value.i64 == 11);
+    fv = fvBuffer.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->timestamp == 3000);
+    CHECK(fv->value.i64 == 12);
+    fv = fvBuffer.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldId == DCGM_FI_DEV_GPU_TEMP);
+    CHECK(fv->status == DCGM_ST_NOT_WATCHED);
+    fv = fvBuffer.GetNextFv(&cursor);
+    REQUIRE(fv != nullptr);
+    CHECK(fv->fieldType == DCGM_FT_DOUBLE);
+    CHECK(fv->value.dbl == 102.0);
+    CHECK(fvBuffer.GetNextFv(&cursor) == nullptr);
+
+    /* Several samples per query */
+    DcgmFvBuffer allBuffer;
+    REQUIRE(cm.GetMultipleSamples({ queries[0] }, 0, 0, 10, &allBuffer) == DCGM_ST_OK);
+    size_t bufferSize   = 0;
+    size_t elementCount = 0;
+    allBuffer.GetSize(&bufferSize, &elementCount);
+    CHECK(elementCount == 4);
+
+    CHECK(cm.GetMultipleSamples(queries, 0, 0, 0, &allBuffer) == DCGM_ST_BADPARAM);
+}
+
+TEST_CASE("CacheManager: Bulk injection")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuIds[2] = { cm.AddFakeGpu(), cm.AddFakeGpu() };
+    dcgmcm_sample_t sample {};
+    timelib64_t now = timelib_usecSince1970();
+
+    DcgmFvBuffer fvBuffer;
+    char serial[] = "fake-serial";
+    for (int i = 0; i < 100; i++)
+    {
+        for (unsigned int gpuId : gpuIds)
+        {
+            fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 40 + i, now - 1000 + i, DCGM_ST_OK);
+            fvBuffer.AddDoubleValue(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, 100.0 + i, now - 1000 + i, DCGM_ST_OK);
+        }
+    }
+    fvBuffer.AddStringValue(DCGM_FE_GPU, gpuIds[1], DCGM_FI_DEV_SERIAL, serial, now, DCGM_ST_OK);
+    REQUIRE(cm.InjectSamples(&fvBuffer) == DCGM_ST_OK);
+
+    for (unsigned int gpuId : gpuIds)
+    {
+        REQUIRE(cm.GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &sample, nullptr) == DCGM_ST_OK);
+        CHECK(sample.timestamp == now - 901);
+        CHECK(sample.val.i64 == 139);
+        REQUIRE(cm.GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, nullptr) == DCGM_ST_OK);
+        CHECK(sample.val.d == 199.0);
+    }
+
+    dcgmcm_sample_t samples[200];
+    int numSamples = 200;
+    unsigned int gpuId = gpuIds[0];
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples, &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    CHECK(numSamples == 100);
+    cm.FreeSamples(samples, numSamples, DCGM_FI_DEV_GPU_TEMP);
+
+    /* A value of the wrong type keeps the whole buffer out */
+    DcgmFvBuffer badBuffer;
+    badBuffer.AddInt64Value(DCGM_FE_GPU, gpuIds[0], DCGM_FI_DEV_GPU_TEMP, 99, now, DCGM_ST_OK);
+    badBuffer.AddInt64Value(DCGM_FE_GPU, gpuIds[0], DCGM_FI_DEV_POWER_USAGE, 99, now, DCGM_ST_OK);
+    CHECK(cm.InjectSamples(&badBuffer) == DCGM_ST_BADPARAM);
+    REQUIRE(cm.GetLatestSample(DCGM_FE_GPU, gpuIds[0], DCGM_FI_DEV_GPU_TEMP, &sample, nullptr) == DCGM_ST_OK);
+    CHECK(sample.val.i64 == 139);
+
+    DcgmFvBuffer unknownBuffer;
+    unknownBuffer.AddInt64Value(DCGM_FE_GPU, gpuIds[0], DCGM_FI_MAX_FIELDS, 1, now, DCGM_ST_OK);
+    CHECK(cm.InjectSamples(&unknownBuffer) == DCGM_ST_BADPARAM);
+    CHECK(cm.InjectSamples(nullptr) == DCGM_ST_BADPARAM);
+}
+
+TEST_CASE("CacheManager: Counter rates")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    timelib64_t const second = 1000000;
+    unsigned short const energyRate = DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION_RATE;
+    DcgmWatcher watcher(DcgmWatcherTypeClient, 1);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_RATE, second, 3600.0, 0, watcher, false)
+            == DCGM_ST_OK);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, energyRate, second, 3600.0, 0, watcher, false) == DCGM_ST_OK);
+
+    /* Watching a rate watches its counter */
+    bool isWatched = false;
+    REQUIRE(cm.IsGpuFieldWatched(gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, &isWatched) == DCGM_ST_OK);
+    CHECK(isWatched);
+
+    /* The counter is reset to 0 between the third and fourth samples */
+    long long const counters[] = { 100, 150, 250, 20, 20 };
+    timelib64_t base           = timelib_usecSince1970() - 10 * second;
+    dcgmcm_sample_t sample {};
+    for (int i = 0; i < 5; i++)
+    {
+        sample.timestamp = base + i * second;
+        sample.val.i64   = counters[i];
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, &sample, 1) == DCGM_ST_OK);
+        sample.val.i64 = 5000 * i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION, &sample, 1)
+                == DCGM_ST_OK);
+    }
+
+    dcgmcm_sample_t samples[8];
+    int numSamples = 8;
+    unsigned short const replayRate = DCGM_FI_DEV_PCIE_REPLAY_RATE;
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU, gpuId, replayRate, samples, &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    REQUIRE(numSamples == 4);
+    CHECK(samples[0].timestamp == base + second);
+    CHECK(samples[0].val.d == 50.0);
+    CHECK(samples[1].val.d == 100.0);
+    CHECK(samples[2].val.d == 20.0);
+    CHECK(samples[3].val.d == 0.0);
+
+    /* 5000 mJ per second is 5 W */
+    REQUIRE(cm.GetLatestSample(DCGM_FE_GPU, gpuId, energyRate, samples, nullptr) == DCGM_ST_OK);
+    CHECK(samples[0].val.d == 5.0);
+
+    /* Unwatching the rate unwatches a counter that nobody else watches */
+    REQUIRE(cm.RemoveFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_RATE, 0, watcher) == DCGM_ST_OK);
+    REQUIRE(cm.IsGpuFieldWatched(gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, &isWatched) == DCGM_ST_OK);
+    CHECK(!isWatched);
+}
+
+TEST_CASE("CacheManager: AppendSamples of interleaved watches")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuIds[2];
+    gpuIds[0] = cm.AddFakeGpu();
+    gpuIds[1] = cm.AddFakeGpu();
+
+    timelib64_t const second = 1000000;
+    timelib64_t base         = timelib_usecSince1970() - 10 * second;
+
+    /* One pass after another, as modules publish them, so each watch's samples are spread out */
+    DcgmFvBuffer fvBuffer;
+    for (int i = 0; i < 5; i++)
+    {
+        for (unsigned int gpuId : gpuIds)
+        {
+            timelib64_t timestamp = base + i * second;
+            fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 40 + gpuId + i, timestamp, DCGM_ST_OK);
+            fvBuffer.AddDoubleValue(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, 100.0 * i, timestamp, DCGM_ST_OK);
+        }
+    }
+    REQUIRE(cm.AppendSamples(&fvBuffer) == DCGM_ST_OK);
+
+    for (unsigned int gpuId : gpuIds)
+    {
+        dcgmcm_sample_t samples[8];
+        int numSamples = 8;
+        REQUIRE(
+            cm.GetSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, samples, &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+        REQUIRE(numSamples == 5);
+        for (int i = 0; i < 5; i++)
+        {
+            CHECK(samples[i].timestamp == base + i * second);
+            CHECK(samples[i].val.i64 == 40 + gpuId + i);
+        }
+
+        /* The newest sample of each run is published once the run is in */
+        dcgmcm_sample_t latest;
+        REQUIRE(cm.GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &latest, nullptr) == DCGM_ST_OK);
+        CHECK(latest.timestamp == base + 4 * second);
+        CHECK(latest.val.d == 400.0);
+    }
+}
+
+TEST_CASE("CacheManager: Derived fields")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    unsigned short const derivedFieldId = DCGM_FI_FIRST_DERIVED_FIELD_ID;
+    std::string error;
+    CHECK(cm.SetDerivedField(DCGM_FI_DEV_POWER_USAGE, "1", error) == DCGM_ST_BADPARAM);
+    CHECK(cm.SetDerivedField(derivedFieldId, "power_usage /", error) == DCGM_ST_BADPARAM);
+    CHECK(error == "Unexpected end of expression at offset 13");
+    REQUIRE(cm.SetDerivedField(derivedFieldId, "power_usage / enforced_power_limit * 100", error) == DCGM_ST_OK);
+
+    timelib64_t const second = 1000000;
+    DcgmWatcher watcher(DcgmWatcherTypeClient, 1);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, derivedFieldId, second, 3600.0, 0, watcher, false) == DCGM_ST_OK);
+
+    /* Watching a derived field watches its inputs */
+    bool isWatched = false;
+    REQUIRE(cm.IsGpuFieldWatched(gpuId, DCGM_FI_DEV_ENFORCED_POWER_LIMIT, &isWatched) == DCGM_ST_OK);
+    CHECK(isWatched);
+
+    /* Inputs that are updated together give one value */
+    double const powers[] = { 100.0, 150.0, DCGM_FP64_NOT_SUPPORTED };
+    timelib64_t base      = timelib_usecSince1970() - 10 * second;
+    for (int i = 0; i < 3; i++)
+    {
+        DcgmFvBuffer fvBuffer;
+        fvBuffer.AddDoubleValue(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, powers[i], base + i * second, DCGM_ST_OK);
+        fvBuffer.AddDoubleValue(
+            DCGM_FE_GPU, gpuId, DCGM_FI_DEV_ENFORCED_POWER_LIMIT, 200.0, base + i * second, DCGM_ST_OK);
+        REQUIRE(cm.AppendSamples(&fvBuffer) == DCGM_ST_OK);
+    }
+
+    dcgmcm_sample_t samples[8];
+    int numSamples = 8;
+    REQUIRE(cm.GetSamples(DCGM_FE_GPU, gpuId, derivedFieldId, samples, &numSamples, 0, 0, DCGM_ORDER_ASCENDING)
+            == DCGM_ST_OK);
+    REQUIRE(numSamples == 3);
+    CHECK(samples[0].timestamp == base);
+    CHECK(samples[0].val.d == 50.0);
+    CHECK(samples[1].val.d == 75.0);
+    /* Why an input has no value is passed on */
+    CHECK(samples[2].val.d == DCGM_FP64_NOT_SUPPORTED);
+
+    /* Redefining the field moves its watches to the new inputs */
+    REQUIRE(cm.SetDerivedField(derivedFieldId, "fb_used / fb_total", error) == DCGM_ST_OK);
+    REQUIRE(cm.IsGpuFieldWatched(gpuId, DCGM_FI_DEV_FB_TOTAL, &isWatched) == DCGM_ST_OK);
+    CHECK(isWatched);
+    REQUIRE(cm.IsGpuFieldWatched(gpuId, DCGM_FI_DEV_ENFORCED_POWER_LIMIT, &isWatched) == DCGM_ST_OK);
+    CHECK(!isWatched);
+
+    /* Removing the definition unwatches the inputs */
+    REQUIRE(cm.SetDerivedField(derivedFieldId, "", error) == DCGM_ST_OK);
+    REQUIRE(cm.IsGpuFieldWatched(gpuId, DCGM_FI_DEV_FB_USED, &isWatched) == DCGM_ST_OK);
+    CHECK(!isWatched);
+
+    /* So does unwatching the derived field */
+    REQUIRE(cm.SetDerivedField(derivedFieldId, "fb_used", error) == DCGM_ST_OK);
+    REQUIRE(cm.IsGpuFieldWatched(gpuId, DCGM_FI_DEV_FB_USED, &isWatched) == DCGM_ST_OK);
+    CHECK(isWatched);
+    REQUIRE(cm.RemoveFieldWatch(DCGM_FE_GPU, gpuId, derivedFieldId, 0, watcher) == DCGM_ST_OK);
+    REQUIRE(cm.IsGpuFieldWatched(gpuId, DCGM_FI_DEV_FB_USED, &isWatched) == DCGM_ST_OK);
+    CHECK(!isWatched);
+}
+
+TEST_CASE("CacheManager: Watchers of different rates")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    timelib64_t const second = 1000000;
+    DcgmWatcher fastWatcher(DcgmWatcherTypeClient, 1);
+    DcgmWatcher slowWatcher(DcgmWatcherTypeClient, 2);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, second / 10, 60.0, 0, fastWatcher, false)
+            == DCGM_ST_OK);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, 10 * second, 3600.0, 0, slowWatcher, false)
+            == DCGM_ST_OK);
+
+    /* Sampled for the fast watcher, kept raw for its age and rolled up for the slow one */
+    dcgmcm_watch_info_t watchInfo;
+    REQUIRE(cm.GetEntityWatchInfoSnapshot(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &watchInfo) == DCGM_ST_OK);
+    CHECK(watchInfo.monitorFrequencyUsec == second / 10);
+    CHECK(watchInfo.maxAgeUsec == 3600 * second);
+    CHECK(watchInfo.rawRetentionUsec == 60 * second);
+    REQUIRE(watchInfo.watcherTiers.size() == 1);
+    CHECK(watchInfo.watcherTiers[0].bucketUsec == 10 * second);
+    CHECK(watchInfo.watcherTiers[0].retentionUsec == 3600 * second);
+
+    CHECK(cm.GetWatcherDecimationUsec(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, fastWatcher) == 0);
+    CHECK(cm.GetWatcherDecimationUsec(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, slowWatcher) == 10 * second);
+
+    /* Without the slow watcher, everything is raw again */
+    REQUIRE(cm.RemoveFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, 0, slowWatcher) == DCGM_ST_OK);
+    REQUIRE(cm.GetEntityWatchInfoSnapshot(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &watchInfo) == DCGM_ST_OK);
+    CHECK(watchInfo.maxAgeUsec == 60 * second);
+    CHECK(watchInfo.rawRetentionUsec == 0);
+    CHECK(watchInfo.watcherTiers.empty());
+
+    /* Slow watchers get one sample per period of their own */
+    CHECK(DcgmCacheManager::IsWatcherDue(0, 15, 14));
+    CHECK(DcgmCacheManager::IsWatcherDue(10, 15, 0));
+    CHECK(!DcgmCacheManager::IsWatcherDue(10, 15, 11));
+    CHECK(DcgmCacheManager::IsWatcherDue(10, 21, 15));
+    CHECK(DcgmCacheManager::IsWatcherDue(10, 9, 15));
+}
+
+TEST_CASE("CacheManager: Adaptive sampling")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    timelib64_t const second = 1000000;
+    cm.SetAdaptiveSampling(second, 0.01);
+
+    DcgmWatcher watcher(DcgmWatcherTypeClient, 1);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, second / 10, 60.0, 0, watcher, false)
+            == DCGM_ST_OK);
+    REQUIRE(cm.AddFieldWatch(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_UTIL, second / 10, 60.0, 0, watcher, false)
+            == DCGM_ST_OK);
+
+    auto getFieldInfo = [&](unsigned short fieldId) {
+        dcgmCacheManagerFieldInfo_t fieldInfo {};
+        fieldInfo.version = dcgmCacheManagerFieldInfo_version;
+        fieldInfo.gpuId   = gpuId;
+        fieldInfo.fieldId = fieldId;
+        REQUIRE(cm.GetCacheManagerFieldInfo(&fieldInfo) == DCGM_ST_OK);
+        return fieldInfo;
+    };
+
+    timelib64_t timestamp = timelib_usecSince1970() - 10 * second;
+    auto injectPower      = [&](double power) {
+        dcgmcm_sample_t sample {};
+        sample.timestamp = timestamp;
+        sample.val.d     = power;
+        timestamp += second / 10;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, &sample, 1) == DCGM_ST_OK);
+    };
+
+    /* Unknown until there are samples */
+    dcgmCacheManagerFieldInfo_t fieldInfo = getFieldInfo(DCGM_FI_DEV_POWER_USAGE);
+    CHECK(!(fieldInfo.flags & DCGM_CMI_F_ADAPTIVE_DECIMATED));
+    CHECK(fieldInfo.pollIntervalUsec == second / 10);
+
+    /* Steady power drops to the base rate */
+    for (int i = 0; i < 5; i++)
+    {
+        injectPower(100.0 + 0.1 * (i % 2));
+    }
+    fieldInfo = getFieldInfo(DCGM_FI_DEV_POWER_USAGE);
+    CHECK((fieldInfo.flags & DCGM_CMI_F_ADAPTIVE_DECIMATED));
+    CHECK(fieldInfo.pollIntervalUsec == second);
+    CHECK(fieldInfo.monitorFrequencyUsec == second / 10);
+
+    /* A transient bursts right away, and it takes a while to settle again */
+    injectPower(150.0);
+    fieldInfo = getFieldInfo(DCGM_FI_DEV_POWER_USAGE);
+    CHECK(!(fieldInfo.flags & DCGM_CMI_F_ADAPTIVE_DECIMATED));
+    CHECK(fieldInfo.pollIntervalUsec == second / 10);
+    injectPower(150.0);
+    CHECK(!(getFieldInfo(DCGM_FI_DEV_POWER_USAGE).flags & DCGM_CMI_F_ADAPTIVE_DECIMATED));
+    for (int i = 0; i < 30; i++)
+    {
+        injectPower(150.0);
+    }
+    CHECK((getFieldInfo(DCGM_FI_DEV_POWER_USAGE).flags & DCGM_CMI_F_ADAPTIVE_DECIMATED));
+
+    /* A change of utilization bursts every watch of the GPU, while the trigger itself never drops */
+    dcgmcm_sample_t sample {};
+    sample.timestamp = timestamp;
+    sample.val.i64   = 0;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_UTIL, &sample, 1) == DCGM_ST_OK);
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_UTIL, &sample, 1) == DCGM_ST_OK);
+    CHECK(getFieldInfo(DCGM_FI_DEV_GPU_UTIL).pollIntervalUsec == second / 10);
+    CHECK(!(getFieldInfo(DCGM_FI_DEV_POWER_USAGE).flags & DCGM_CMI_F_ADAPTIVE_DECIMATED));
+
+    /* Off again */
+    cm.SetAdaptiveSampling(0, 0.01);
+    injectPower(150.0);
+    CHECK(getFieldInfo(DCGM_FI_DEV_POWER_USAGE).pollIntervalUsec == second / 10);
+}
+
+TEST_CASE("CacheManager: Latest values matrix")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    unsigned int gpuIds[2] = { cm.AddFakeGpu(), cm.AddFakeGpu() };
+    timelib64_t now        = timelib_usecSince1970();
+
+    DcgmFvBuffer fvBuffer;
+    char serial[] = "fake-serial";
+    for (unsigned int gpuId : gpuIds)
+    {
+        fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, 40 + gpuId, now, DCGM_ST_OK);
+        fvBuffer.AddDoubleValue(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, 100.5 + gpuId, now, DCGM_ST_OK);
+    }
+    fvBuffer.AddStringValue(DCGM_FE_GPU, gpuIds[1], DCGM_FI_DEV_SERIAL, serial, now, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuIds[0], DCGM_FI_DEV_MEM_CLOCK, DCGM_INT64_BLANK, now, DCGM_ST_OK);
+    REQUIRE(cm.InjectSamples(&fvBuffer) == DCGM_ST_OK);
+
+    std::vector<dcgmGroupEntityPair_t> entities { { DCGM_FE_GPU, gpuIds[0] }, { DCGM_FE_GPU, gpuIds[1] } };
+    std::vector<unsigned short> fieldIds {
+        DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE, DCGM_FI_DEV_SERIAL, DCGM_FI_DEV_MEM_CLOCK
+    };
+    auto matrix = std::make_unique<dcgmLatestValuesMatrix_v1>();
+    REQUIRE(cm.GetLatestValuesMatrix(entities, fieldIds, matrix.get()) == DCGM_ST_OK);
+    REQUIRE(matrix->numEntities == 2);
+    REQUIRE(matrix->numFields == 4);
+    CHECK(matrix->entities[1].entityId == gpuIds[1]);
+    CHECK(matrix->fieldIds[2] == DCGM_FI_DEV_SERIAL);
+    CHECK(matrix->fieldTypes[0] == DCGM_FT_INT64);
+    CHECK(matrix->fieldTypes[1] == DCGM_FT_DOUBLE);
+    CHECK(matrix->fieldTypes[2] == DCGM_FT_STRING);
+
+    for (unsigned int row = 0; row < 2; row++)
+    {
+        CHECK(matrix->status[row * 4 + 0] == 0);
+        CHECK(matrix->values[row * 4 + 0].i64 == 40 + gpuIds[row]);
+        CHECK(matrix->timestamps[row * 4 + 0] == now);
+        CHECK(matrix->status[row * 4 + 1] == 0);
+        CHECK(matrix->values[row * 4 + 1].dbl == 100.5 + gpuIds[row]);
+    }
+
+    /* Strings are in their own section. Cells without one point at an empty string */
+    CHECK(matrix->status[4 + 2] == 0);
+    CHECK(std::string(&matrix->strings[matrix->values[4 + 2].i64]) == serial);
+    CHECK(matrix->status[2] == (DCGM_MATRIX_CELL_BLANK | DCGM_MATRIX_CELL_NOT_WATCHED));
+    CHECK(matrix->strings[matrix->values[2].i64] == '\0');
+    CHECK(matrix->stringsSize == 1 + sizeof(serial));
+
+    /* Blank values are flagged as such */
+    CHECK(matrix->status[3] == DCGM_MATRIX_CELL_BLANK);
+    CHECK(matrix->status[4 + 3] == (DCGM_MATRIX_CELL_BLANK | DCGM_MATRIX_CELL_NOT_WATCHED));
+    CHECK(matrix->values[4 + 3].i64 == DCGM_INT64_BLANK);
+    CHECK(matrix->timestamps[4 + 3] == 0);
+
+    fieldIds.assign(DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP + 1, DCGM_FI_DEV_GPU_TEMP);
+    CHECK(cm.GetLatestValuesMatrix(entities, fieldIds, matrix.get()) == DCGM_ST_BADPARAM);
+}
+
+static unsigned int g_cpuAffinityCalls = 0;
+static unsigned int g_fieldValuesCalls = 0;
+
+/* Every GPU is on CPU 0 */
+static nvmlReturn_t CountCpuAffinity(nvmlDevice_t, unsigned int, unsigned long *cpuSet)
+{
+    g_cpuAffinityCalls++;
+    cpuSet[0] = 1;
+    return NVML_SUCCESS;
+}
+
+/* Read for the NvSwitch link counts of each GPU when the NvLink topology is built. None have any */
+static nvmlReturn_t CountFieldValues(nvmlDevice_t, int valuesCount, nvmlFieldValue_t *values)
+{
+    g_fieldValuesCalls++;
+    for (int i = 0; i < valuesCount; i++)
+    {
+        values[i].nvmlReturn  = NVML_SUCCESS;
+        values[i].value.uiVal = 0;
+    }
+    return NVML_SUCCESS;
+}
+
+TEST_CASE("CacheManager: Topology is cached until it changes")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    std::vector<unsigned int> gpuIds;
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        gpuIds.push_back(cm.AddFakeGpu());
+    }
+
+    set_nvmlDeviceGetCpuAffinityHook(CountCpuAffinity);
+    set_nvmlDeviceGetFieldValuesHook(CountFieldValues);
+    g_cpuAffinityCalls = 0;
+    g_fieldValuesCalls = 0;
+
+    dcgmAffinity_t affinity {};
+    REQUIRE(cm.PopulateCpuAffinity(affinity) == DCGM_ST_OK);
+    CHECK(affinity.numGpus == 3);
+    CHECK(g_cpuAffinityCalls == 3);
+    REQUIRE(cm.PopulateCpuAffinity(affinity) == DCGM_ST_OK);
+    CHECK(g_cpuAffinityCalls == 3);
+
+    /* All 3 GPUs share a CPU, so picking 2 of them needs the NvLink topology */
+    uint64_t selectedGpus = 0;
+    REQUIRE(cm.SelectGpusByTopology(gpuIds, 2, selectedGpus) == DCGM_ST_OK);
+    unsigned int fieldValuesCalls = g_fieldValuesCalls;
+    CHECK(fieldValuesCalls > 0);
+
+    uint64_t reselectedGpus = 0;
+    REQUIRE(cm.SelectGpusByTopology(gpuIds, 2, reselectedGpus) == DCGM_ST_OK);
+    CHECK(reselectedGpus == selectedGpus);
+    CHECK(g_fieldValuesCalls == fieldValuesCalls);
+    CHECK(g_cpuAffinityCalls == 3);
+
+    /* A link changing state drops what was cached. Setting it to the same state again doesn't */
+    REQUIRE(cm.SetGpuNvLinkLinkState(gpuIds[0], 0, DcgmNvLinkLinkStateUp) == DCGM_ST_OK);
+    REQUIRE(cm.PopulateCpuAffinity(affinity) == DCGM_ST_OK);
+    CHECK(g_cpuAffinityCalls == 6);
+    REQUIRE(cm.SetGpuNvLinkLinkState(gpuIds[0], 0, DcgmNvLinkLinkStateUp) == DCGM_ST_OK);
+    REQUIRE(cm.PopulateCpuAffinity(affinity) == DCGM_ST_OK);
+    CHECK(g_cpuAffinityCalls == 6);
+
+    cm.InvalidateTopology();
+    REQUIRE(cm.SelectGpusByTopology(gpuIds, 2, reselectedGpus) == DCGM_ST_OK);
+    CHECK(g_cpuAffinityCalls == 9);
+    CHECK(g_fieldValuesCalls > fieldValuesCalls);
+
+    resetAllNvmlHooks();
+}
+
+TEST_CASE("CacheManager: Update thread scratch only covers GPUs with work")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    dcgmcm_update_thread_t threadCtx {};
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(DCGM_FI_DEV_ECC_SBE_VOL_TOTAL);
+    REQUIRE(fieldMeta != nullptr);
+
+    cm.ClearThreadCtx(&threadCtx);
+    CHECK(threadCtx.fieldValues.empty());
+
+    DcgmCacheManager::AddGpuFieldValue(&threadCtx, 2, fieldMeta, nullptr);
+    DcgmCacheManager::AddGpuFieldValue(&threadCtx, 2, fieldMeta, nullptr);
+    DcgmCacheManager::AddGpuFieldValue(&threadCtx, 0, fieldMeta, nullptr);
+    REQUIRE(threadCtx.fieldValues.size() == 3);
+    CHECK(threadCtx.fieldValues[0].fields.size() == 1);
+    CHECK(threadCtx.fieldValues[1].fields.empty());
+    CHECK(threadCtx.fieldValues[2].fields.size() == 2);
+    CHECK(threadCtx.fieldValues[2].watchInfo.size() == 2);
+
+    threadCtx.batchedValues.resize(1);
+    threadCtx.batchedValues[0].validMask = 1 << DcgmcmBatchedMemoryInfo;
+    threadCtx.driverCallsSaved           = 5;
+
+    /* Clearing keeps each GPU's lists and their capacity for the next cycle */
+    size_t capacity = threadCtx.fieldValues[2].fields.capacity();
+    cm.ClearThreadCtx(&threadCtx);
+    REQUIRE(threadCtx.fieldValues.size() == 3);
+    for (dcgmcm_gpu_field_values_t const &gpuFieldValues : threadCtx.fieldValues)
+    {
+        CHECK(gpuFieldValues.fields.empty());
+        CHECK(gpuFieldValues.watchInfo.empty());
+    }
+    CHECK(threadCtx.fieldValues[2].fields.capacity() == capacity);
+    CHECK(threadCtx.batchedValues.size() == 1);
+    CHECK(threadCtx.batchedValues[0].validMask == 0);
+    CHECK(threadCtx.driverCallsSaved == 0);
+}
+
+static std::atomic<unsigned int> g_liveFieldValuesCalls = 0;
+
+/* Live reads of the mapped fields of a GPU. Every value is 42 */
+static nvmlReturn_t LiveFieldValues(nvmlDevice_t, int valuesCount, nvmlFieldValue_t *values)
+{
+    g_liveFieldValuesCalls++;
+    for (int i = 0; i < valuesCount; i++)
+    {
+        values[i].nvmlReturn   = NVML_SUCCESS;
+        values[i].timestamp    = 1000;
+        values[i].valueType    = NVML_VALUE_TYPE_UNSIGNED_LONG_LONG;
+        values[i].value.ullVal = 42;
+    }
+    return NVML_SUCCESS;
+}
+
+TEST_CASE("CacheManager: Live reads of several GPUs")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    std::vector<dcgmGroupEntityPair_t> entities;
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        entities.push_back({ DCGM_FE_GPU, cm.AddFakeGpu() });
+    }
+    /* Not a GPU. This is read on the calling thread */
+    entities.push_back({ DCGM_FE_GPU, DCGM_MAX_NUM_DEVICES - 1 });
+
+    /* Compute PIDs can't be read live */
+    std::vector<unsigned short> fieldIds { DCGM_FI_DEV_PCIE_REPLAY_COUNTER, DCGM_FI_DEV_COMPUTE_PIDS };
+
+    set_nvmlDeviceGetFieldValuesHook(LiveFieldValues);
+
+    /* The second read reuses the workers of the first */
+    for (int pass = 0; pass < 2; pass++)
+    {
+        g_liveFieldValuesCalls = 0;
+
+        DcgmFvBuffer fvBuffer;
+        REQUIRE(cm.GetMultipleLatestLiveSamples(entities, fieldIds, &fvBuffer) == DCGM_ST_OK);
+        CHECK(g_liveFieldValuesCalls == 4);
+
+        /* Status of each entity's fields, keyed by entityId then fieldId */
+        std::map<dcgm_field_eid_t, std::map<unsigned short, int>> statuses;
+        dcgmBufferedFvCursor_t cursor = 0;
+        for (dcgmBufferedFv_t *fv = fvBuffer.GetNextFv(&cursor); fv; fv = fvBuffer.GetNextFv(&cursor))
+        {
+            REQUIRE(statuses[fv->entityId].count(fv->fieldId) == 0);
+            statuses[fv->entityId][fv->fieldId] = fv->status;
+            if (fv->fieldId == DCGM_FI_DEV_PCIE_REPLAY_COUNTER && fv->status == DCGM_ST_OK)
+            {
+                CHECK(fv->value.i64 == 42);
+            }
+        }
+
+        REQUIRE(statuses.size() == entities.size());
+        for (unsigned int gpuId = 0; gpuId < 4; gpuId++)
+        {
+            CHECK(statuses[gpuId][DCGM_FI_DEV_PCIE_REPLAY_COUNTER] == DCGM_ST_OK);
+            CHECK(statuses[gpuId][DCGM_FI_DEV_COMPUTE_PIDS] == DCGM_ST_FIELD_UNSUPPORTED_BY_API);
+        }
+        CHECK(statuses[DCGM_MAX_NUM_DEVICES - 1][DCGM_FI_DEV_PCIE_REPLAY_COUNTER] == DCGM_ST_BADPARAM);
+        CHECK(statuses[DCGM_MAX_NUM_DEVICES - 1][DCGM_FI_DEV_COMPUTE_PIDS] == DCGM_ST_FIELD_UNSUPPORTED_BY_API);
+    }
+
+    resetAllNvmlHooks();
+}
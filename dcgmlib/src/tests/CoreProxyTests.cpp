@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmCacheManager.h>
+#include <DcgmCoreCommunication.h>
+#include <DcgmCoreProxy.h>
+#include <DcgmGroupManager.h>
+
+#include <vector>
+
+namespace
+{
+dcgmCoreCallbacks_t MakeCallbacks(DcgmCoreCommunication &communicator, bool withCacheAccess)
+{
+    dcgmCoreCallbacks_t dcc = {};
+    dcc.version             = dcgmCoreCallbacks_version;
+    dcc.postfunc            = PostRequestToCore;
+    dcc.poster              = &communicator;
+    dcc.cacheAccess         = withCacheAccess ? communicator.GetCacheAccess() : nullptr;
+    return dcc;
+}
+} // namespace
+
+TEST_CASE("CoreProxy: direct cache access matches posted requests")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    DcgmGroupManager gm(&cm, false);
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    dcgmcm_sample_t sample {};
+    for (int i = 0; i < 5; i++)
+    {
+        sample.timestamp = 1000 * (i + 1);
+        sample.val.i64   = 10 * i;
+        REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, &sample, 1) == DCGM_ST_OK);
+    }
+
+    DcgmCoreCommunication communicator;
+    communicator.Init(&cm, &gm);
+    REQUIRE(communicator.GetCacheAccess()->version == dcgmCoreCacheAccess_version);
+
+    DcgmCoreProxy direct(MakeCallbacks(communicator, true));
+    DcgmCoreProxy posted(MakeCallbacks(communicator, false));
+
+    for (DcgmCoreProxy *proxy : { &direct, &posted })
+    {
+        dcgmcm_sample_t latest {};
+        REQUIRE(proxy->GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, &latest, nullptr)
+                == DCGM_ST_OK);
+        CHECK(latest.timestamp == 5000);
+        CHECK(latest.val.i64 == 40);
+
+        std::vector<dcgmcm_sample_t> samples(3);
+        int count = samples.size();
+        REQUIRE(proxy->GetSamples(DCGM_FE_GPU,
+                                  gpuId,
+                                  DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
+                                  samples.data(),
+                                  &count,
+                                  2000,
+                                  0,
+                                  DCGM_ORDER_ASCENDING)
+                == DCGM_ST_OK);
+        REQUIRE(count == 3);
+        CHECK(samples[0].val.i64 == 10);
+        CHECK(samples[2].val.i64 == 30);
+
+        DcgmcmSummaryType_t summaryTypes[] = { DcgmcmSummaryTypeMinimum, DcgmcmSummaryTypeMaximum };
+        long long summaryValues[2]         = {};
+        REQUIRE(proxy->GetInt64SummaryData(DCGM_FE_GPU,
+                                           gpuId,
+                                           DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
+                                           2,
+                                           summaryTypes,
+                                           summaryValues,
+                                           0,
+                                           0,
+                                           nullptr,
+                                           nullptr)
+                == DCGM_ST_OK);
+        CHECK(summaryValues[0] == 0);
+        CHECK(summaryValues[1] == 40);
+
+        CHECK(proxy->GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, &latest, nullptr)
+              == DCGM_ST_NOT_WATCHED);
+    }
+}
+
+TEST_CASE("CoreProxy: callbacks before version 2 only post requests")
+{
+    DcgmFieldsInit();
+    DcgmCacheManager cm;
+    DcgmGroupManager gm(&cm, false);
+    unsigned int gpuId = cm.AddFakeGpu();
+
+    DcgmCoreCommunication communicator;
+    communicator.Init(&cm, &gm);
+
+    /* A version 1 core has garbage where cacheAccess would be */
+    dcgmCoreCacheAccess_t wrongAccess = {};
+    dcgmCoreCallbacks_t dcc           = MakeCallbacks(communicator, false);
+    dcc.version                       = dcgmCoreCallbacks_version1;
+    dcc.cacheAccess                   = &wrongAccess;
+
+    DcgmCoreProxy proxy(dcc);
+
+    dcgmcm_sample_t sample {};
+    sample.timestamp = 1000;
+    sample.val.i64   = 7;
+    REQUIRE(cm.InjectSamples(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, &sample, 1) == DCGM_ST_OK);
+
+    dcgmcm_sample_t latest {};
+    REQUIRE(proxy.GetLatestSample(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_PCIE_REPLAY_COUNTER, &latest, nullptr)
+            == DCGM_ST_OK);
+    CHECK(latest.val.i64 == 7);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmDerivedField.h>
+#include <dcgm_fields.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+std::unique_ptr<DcgmDerivedField> CompileOk(std::string const &expression)
+{
+    std::unique_ptr<DcgmDerivedField> derivedField;
+    std::string error;
+    REQUIRE(DcgmDerivedField::Compile(expression, derivedField, error) == DCGM_ST_OK);
+    REQUIRE(derivedField != nullptr);
+    return derivedField;
+}
+
+std::string CompileError(std::string const &expression)
+{
+    std::unique_ptr<DcgmDerivedField> derivedField;
+    std::string error;
+    CHECK(DcgmDerivedField::Compile(expression, derivedField, error) == DCGM_ST_BADPARAM);
+    CHECK(derivedField == nullptr);
+    return error;
+}
+} // namespace
+
+TEST_CASE("DerivedField: Arithmetic")
+{
+    DcgmFieldsInit();
+
+    CHECK(CompileOk("1 + 2 * 3")->Evaluate(nullptr) == 7.0);
+    CHECK(CompileOk("(1 + 2) * 3")->Evaluate(nullptr) == 9.0);
+    CHECK(CompileOk("10 - 4 - 3")->Evaluate(nullptr) == 3.0);
+    CHECK(CompileOk("64 / 4 / 2")->Evaluate(nullptr) == 8.0);
+    CHECK(CompileOk("-2 * -(3 - 5)")->Evaluate(nullptr) == -4.0);
+    CHECK(CompileOk(" 1.5e2 ")->Evaluate(nullptr) == 150.0);
+
+    /* Not finite */
+    CHECK(CompileOk("1 / 0")->Evaluate(nullptr) == DCGM_FP64_BLANK);
+    CHECK(CompileOk("0 / 0")->Evaluate(nullptr) == DCGM_FP64_BLANK);
+}
+
+TEST_CASE("DerivedField: Inputs")
+{
+    DcgmFieldsInit();
+
+    auto derivedField = CompileOk("power_usage / enforced_power_limit * 100 + 0 * $155");
+    CHECK(derivedField->GetInputFieldIds()
+          == std::vector<unsigned short> { DCGM_FI_DEV_POWER_USAGE, DCGM_FI_DEV_ENFORCED_POWER_LIMIT });
+
+    double inputs[] = { 150.0, 300.0 };
+    CHECK(derivedField->Evaluate(inputs) == 50.0);
+
+    inputs[1] = 0.0;
+    CHECK(derivedField->Evaluate(inputs) == DCGM_FP64_BLANK);
+
+    /* Int64 fields */
+    derivedField = CompileOk("fb_used / (fb_used + fb_free)");
+    CHECK(derivedField->GetInputFieldIds()
+          == std::vector<unsigned short> { DCGM_FI_DEV_FB_USED, DCGM_FI_DEV_FB_FREE });
+    double fbInputs[] = { 1.0, 3.0 };
+    CHECK(derivedField->Evaluate(fbInputs) == 0.25);
+}
+
+TEST_CASE("DerivedField: Bad expressions")
+{
+    DcgmFieldsInit();
+
+    CHECK(CompileError("") == "Unexpected end of expression at offset 0");
+    CHECK(CompileError("1 +") == "Unexpected end of expression at offset 3");
+    CHECK(CompileError("(1 + 2") == "Expected ) at offset 6");
+    CHECK(CompileError("1 2") == "Unexpected 2 at offset 2");
+    CHECK(CompileError("1 % 2") == "Unexpected % at offset 2");
+    CHECK(CompileError("not_a_field * 2") == "Unknown field not_a_field at offset 11");
+    CHECK(CompileError("$65000") == "Unknown field $65000 at offset 6");
+    CHECK(CompileError("$") == "Expected a field ID after $ at offset 1");
+    CHECK(CompileError("name") == "Field name isn't numeric at offset 4");
+    CHECK(CompileError("$" + std::to_string(DCGM_FI_FIRST_DERIVED_FIELD_ID))
+          == "Field $" + std::to_string(DCGM_FI_FIRST_DERIVED_FIELD_ID) + " is a derived field at offset 4");
+    CHECK(CompileError(std::string(DCGM_DERIVED_FIELD_EXPRESSION_SIZE, '1')) == "Expression is too long");
+
+    CHECK(CompileError("power_usage + enforced_power_limit + fb_used + fb_free + fb_total + sm_clock + memory_clock"
+                       " + gpu_temp + gpu_utilization")
+          == "Too many fields at offset 120");
+
+    std::string tooDeep = std::string(40, '(') + "1" + std::string(40, ')');
+    CHECK(CompileError(tooDeep).find("Expression is too deeply nested") == 0);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmFieldGroup.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("FieldGroupManager: add, look up and remove")
+{
+    DcgmFieldGroupManager manager;
+    std::vector<unsigned short> fieldIds { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE };
+    DcgmWatcher clientWatcher(DcgmWatcherTypeClient, 1);
+
+    dcgmFieldGrp_t fieldGrp = 0;
+    REQUIRE(manager.AddFieldGroup("temps", fieldIds, &fieldGrp, clientWatcher) == DCGM_ST_OK);
+    CHECK(manager.AddFieldGroup("temps", fieldIds, &fieldGrp, clientWatcher) == DCGM_ST_DUPLICATE_KEY);
+
+    std::vector<unsigned short> gotFieldIds;
+    REQUIRE(manager.GetFieldGroupFields(fieldGrp, gotFieldIds) == DCGM_ST_OK);
+    CHECK(gotFieldIds == fieldIds);
+    CHECK(manager.GetFieldGroupName(fieldGrp) == "temps");
+
+    dcgmAllFieldGroup_t all {};
+    REQUIRE(manager.PopulateFieldGroupGetAll(&all) == DCGM_ST_OK);
+    CHECK(all.numFieldGroups == 1);
+    CHECK(all.fieldGroups[0].numFieldIds == 2);
+
+    CHECK(manager.OnConnectionRemove(1));
+    CHECK(manager.GetFieldGroupFields(fieldGrp, gotFieldIds) == DCGM_ST_NO_DATA);
+    CHECK(manager.GetFieldGroupName(fieldGrp).empty());
+    CHECK(manager.RemoveFieldGroup(fieldGrp, clientWatcher) == DCGM_ST_NO_DATA);
+}
+
+TEST_CASE("FieldGroupManager: lookups see whole field groups while others change")
+{
+    DcgmFieldGroupManager manager;
+    std::vector<unsigned short> fieldIds { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE, DCGM_FI_DEV_SM_CLOCK };
+    DcgmWatcher watcher(DcgmWatcherTypeClient, 1);
+
+    dcgmFieldGrp_t stableGrp = 0;
+    REQUIRE(manager.AddFieldGroup("stable", fieldIds, &stableGrp, watcher) == DCGM_ST_OK);
+
+    std::atomic<bool> stop = false;
+    std::atomic<int> badLookups = 0;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++)
+    {
+        readers.emplace_back([&] {
+            std::vector<unsigned short> gotFieldIds;
+            dcgmFieldGroupInfo_t info {};
+            while (!stop)
+            {
+                if (manager.GetFieldGroupFields(stableGrp, gotFieldIds) != DCGM_ST_OK || gotFieldIds != fieldIds)
+                {
+                    badLookups++;
+                }
+
+                info.fieldGroupId = stableGrp;
+                if (manager.PopulateFieldGroupInfo(&info) != DCGM_ST_OK || info.numFieldIds != fieldIds.size())
+                {
+                    badLookups++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 500; i++)
+    {
+        dcgmFieldGrp_t churnGrp = 0;
+        std::string name        = "churn" + std::to_string(i);
+        REQUIRE(manager.AddFieldGroup(name, fieldIds, &churnGrp, watcher) == DCGM_ST_OK);
+        REQUIRE(manager.RemoveFieldGroup(churnGrp, watcher) == DCGM_ST_OK);
+    }
+
+    stop = true;
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    CHECK(badLookups == 0);
+}
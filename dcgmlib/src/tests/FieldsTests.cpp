@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+#include <dcgm_fields.h>
+
+#include <string>
+
+TEST_CASE("DcgmFields: Lookups by ID and by tag agree")
+{
+    REQUIRE(DcgmFieldsInit() == 0);
+
+    int numFields = 0;
+    for (unsigned short fieldId = 0; fieldId < DCGM_FI_MAX_FIELDS; fieldId++)
+    {
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        if (fieldMeta == nullptr)
+        {
+            continue;
+        }
+        numFields++;
+
+        CHECK(fieldMeta->fieldId == fieldId);
+        REQUIRE(fieldMeta->valueFormat != nullptr);
+        CHECK(DcgmFieldGetByTag(fieldMeta->tag) == fieldMeta);
+    }
+    CHECK(numFields > 300);
+
+    CHECK(DcgmFieldGetById(0) == nullptr);
+    CHECK(DcgmFieldGetById(DCGM_FI_MAX_FIELDS) == nullptr);
+
+    std::string unknownTag = "no_such_field";
+    CHECK(DcgmFieldGetByTag(unknownTag.data()) == nullptr);
+    CHECK(DcgmFieldGetByTag(nullptr) == nullptr);
+
+    std::string tag             = "gpu_temp";
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetByTag(tag.data());
+    REQUIRE(fieldMeta != nullptr);
+    CHECK(fieldMeta->fieldId == DCGM_FI_DEV_GPU_TEMP);
+    CHECK(fieldMeta->fieldType == DCGM_FT_INT64);
+    CHECK(fieldMeta->entityLevel == DCGM_FE_GPU);
+    CHECK(std::string(fieldMeta->valueFormat->shortName) == "TMPTR");
+    CHECK(std::string(fieldMeta->valueFormat->unit) == " C");
+    CHECK(fieldMeta->valueFormat->width == 5);
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmFvStreamManager.h>
+#include <dcgm_fields.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+struct SentBatch
+{
+    dcgm_connection_id_t connectionId;
+    dcgm_request_id_t requestId;
+    dcgm_msg_fv_stream_t header;
+    std::vector<dcgmBufferedFv_t> values; /* Only the int64 values the tests send */
+};
+
+/* Records what the manager sends instead of sending it */
+class FakeClients
+{
+public:
+    DcgmFvStreamManager::SendFn GetSendFn()
+    {
+        return [this](dcgm_connection_id_t connectionId,
+                      unsigned int msgType,
+                      dcgm_request_id_t requestId,
+                      void *msgData,
+                      int msgLength,
+                      dcgmReturn_t /* status */) {
+            REQUIRE(msgType == DCGM_MSG_FV_STREAM);
+            REQUIRE((size_t)msgLength >= sizeof(dcgm_msg_fv_stream_t));
+
+            SentBatch batch;
+            batch.connectionId = connectionId;
+            batch.requestId    = requestId;
+            memcpy(&batch.header, msgData, sizeof(batch.header));
+            REQUIRE(batch.header.bufferSize == msgLength - sizeof(dcgm_msg_fv_stream_t));
+
+            char const *fvBytes = (char const *)msgData + sizeof(dcgm_msg_fv_stream_t);
+            for (size_t offset = 0; offset < batch.header.bufferSize;)
+            {
+                auto fv = (dcgmBufferedFv_t const *)(fvBytes + offset);
+                batch.values.push_back(*fv);
+                offset += fv->length;
+            }
+            REQUIRE(batch.values.size() == batch.header.numValues);
+
+            batches.push_back(batch);
+            return DCGM_ST_OK;
+        };
+    }
+
+    std::vector<SentBatch> batches;
+};
+
+/* Publish count int64 values of a GPU field to manager, the way the cache manager would */
+void PublishValues(DcgmFvStreamManager &manager,
+                   unsigned int gpuId,
+                   unsigned short fieldId,
+                   int count,
+                   long long firstValue = 0)
+{
+    DcgmFvBuffer fvBuffer;
+    for (int i = 0; i < count; i++)
+        fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuId, fieldId, firstValue + i, 1000 + i, DCGM_ST_OK);
+    manager.OnFvUpdates(fvBuffer);
+}
+} // namespace
+
+TEST_CASE("FvStreamManager: routes values to the streams that carry them")
+{
+    FakeClients clients;
+    DcgmFvStreamManager manager(clients.GetSendFn());
+
+    REQUIRE(manager.AddStream(1, 10, { { DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP } }, 0, 0) == DCGM_ST_OK);
+    REQUIRE(manager.AddStream(2, 20, { { DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP } }, 0, 0) == DCGM_ST_OK);
+    CHECK(manager.AddStream(1, 10, {}, 0, 0) == DCGM_ST_IN_USE);
+    CHECK(manager.GetStreamCount() == 2);
+
+    PublishValues(manager, 0, DCGM_FI_DEV_GPU_TEMP, 3);
+    PublishValues(manager, 0, DCGM_FI_DEV_POWER_USAGE, 3); /* Nobody's */
+
+    REQUIRE(clients.batches.size() == 1);
+    CHECK(clients.batches[0].connectionId == 1);
+    CHECK(clients.batches[0].requestId == 10);
+    CHECK(clients.batches[0].header.numValues == 3);
+    CHECK(clients.batches[0].header.numDropped == 0);
+    CHECK(clients.batches[0].values[2].value.i64 == 2);
+
+    PublishValues(manager, 1, DCGM_FI_DEV_GPU_TEMP, 1);
+    REQUIRE(clients.batches.size() == 2);
+    CHECK(clients.batches[1].connectionId == 2);
+}
+
+TEST_CASE("FvStreamManager: flow control holds and drops values")
+{
+    FakeClients clients;
+    DcgmFvStreamManager manager(clients.GetSendFn());
+
+    REQUIRE(manager.AddStream(1, 10, { { DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP } }, 2, 5) == DCGM_ST_OK);
+
+    PublishValues(manager, 0, DCGM_FI_DEV_GPU_TEMP, 1, 0);
+    PublishValues(manager, 0, DCGM_FI_DEV_GPU_TEMP, 1, 1);
+    REQUIRE(clients.batches.size() == 2);
+
+    /* The window is full. 5 of these are held and 3 dropped */
+    PublishValues(manager, 0, DCGM_FI_DEV_GPU_TEMP, 8, 2);
+    REQUIRE(clients.batches.size() == 2);
+
+    manager.OnAck(1, 10, 1);
+    REQUIRE(clients.batches.size() == 3);
+    CHECK(clients.batches[2].header.numValues == 5);
+    CHECK(clients.batches[2].header.numDropped == 3);
+    CHECK(clients.batches[2].values[0].value.i64 == 2);
+    CHECK(clients.batches[2].values[4].value.i64 == 6);
+
+    /* Acks for unknown streams are ignored */
+    manager.OnAck(1, 11, 1);
+    manager.OnAck(3, 10, 1);
+}
+
+TEST_CASE("FvStreamManager: embedded streams aren't flow controlled")
+{
+    FakeClients clients;
+    DcgmFvStreamManager manager(clients.GetSendFn());
+
+    REQUIRE(manager.AddStream(DCGM_CONNECTION_ID_NONE, 10, { { DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP } }, 1, 1)
+            == DCGM_ST_OK);
+
+    for (int i = 0; i < 10; i++)
+        PublishValues(manager, 0, DCGM_FI_DEV_GPU_TEMP, 1, i);
+
+    CHECK(clients.batches.size() == 10);
+}
+
+TEST_CASE("FvStreamManager: global fields match any entity they were subscribed for")
+{
+    DcgmFieldsInit();
+    FakeClients clients;
+    DcgmFvStreamManager manager(clients.GetSendFn());
+
+    REQUIRE(manager.AddStream(1, 10, { { DCGM_FE_GPU, 3, DCGM_FI_DRIVER_VERSION } }, 0, 0) == DCGM_ST_OK);
+
+    DcgmFvBuffer fvBuffer;
+    fvBuffer.AddStringValue(DCGM_FE_NONE, 0, DCGM_FI_DRIVER_VERSION, (char *)"470.00", 1000, DCGM_ST_OK);
+    manager.OnFvUpdates(fvBuffer);
+
+    REQUIRE(clients.batches.size() == 1);
+    CHECK(clients.batches[0].header.numValues == 1);
+}
+
+TEST_CASE("FvStreamManager: remove reports keys no other stream of the connection uses")
+{
+    FakeClients clients;
+    DcgmFvStreamManager manager(clients.GetSendFn());
+
+    dcgm_fv_stream_key_t const temp  = { DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP };
+    dcgm_fv_stream_key_t const power = { DCGM_FE_GPU, 0, DCGM_FI_DEV_POWER_USAGE };
+
+    REQUIRE(manager.AddStream(1, 10, { temp, power }, 0, 0) == DCGM_ST_OK);
+    REQUIRE(manager.AddStream(1, 11, { temp }, 0, 0) == DCGM_ST_OK);
+    REQUIRE(manager.AddStream(2, 10, { power }, 0, 0) == DCGM_ST_OK);
+
+    std::vector<dcgm_fv_stream_key_t> unusedKeys;
+    REQUIRE(manager.RemoveStream(1, 10, unusedKeys) == DCGM_ST_OK);
+    REQUIRE(unusedKeys.size() == 1);
+    CHECK(unusedKeys[0].fieldId == DCGM_FI_DEV_POWER_USAGE);
+
+    unusedKeys.clear();
+    CHECK(manager.RemoveStream(1, 10, unusedKeys) == DCGM_ST_NO_DATA);
+
+    manager.OnConnectionRemove(1);
+    CHECK(manager.GetStreamCount() == 1);
+
+    /* Only connection 2's stream is left */
+    PublishValues(manager, 0, DCGM_FI_DEV_GPU_TEMP, 1);
+    PublishValues(manager, 0, DCGM_FI_DEV_POWER_USAGE, 1);
+    REQUIRE(clients.batches.size() == 1);
+    CHECK(clients.batches[0].connectionId == 2);
+}
+
+TEST_CASE("FvStreamManager: batch callback sees each batch before it's sent")
+{
+    FakeClients clients;
+    std::vector<size_t> batchValueCounts;
+    DcgmFvStreamManager manager(clients.GetSendFn(), [&](char const *fvs, size_t size) {
+        size_t count = 0;
+        for (size_t offset = 0; offset < size; count++)
+            offset += ((dcgmBufferedFv_t const *)(fvs + offset))->length;
+        REQUIRE(batchValueCounts.size() == clients.batches.size());
+        batchValueCounts.push_back(count);
+    });
+
+    REQUIRE(manager.AddStream(1, 10, { { DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP } }, 0, 0) == DCGM_ST_OK);
+
+    PublishValues(manager, 0, DCGM_FI_DEV_GPU_TEMP, 3);
+    PublishValues(manager, 0, DCGM_FI_DEV_POWER_USAGE, 3);
+
+    REQUIRE(clients.batches.size() == 1);
+    REQUIRE(batchValueCounts.size() == 1);
+    CHECK(batchValueCounts[0] == 3);
+}
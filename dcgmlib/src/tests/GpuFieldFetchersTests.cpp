@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmGpuFieldFetchers.h>
+#include <dcgm_fields.h>
+#include <nvml_loader/nvml_loader_hook.h>
+
+#include <cstdio>
+#include <string>
+
+TEST_CASE("GpuFieldFetchers: Fetchers match their fields")
+{
+    REQUIRE(DcgmFieldsInit() == 0);
+
+    int numFetchers = 0;
+    for (unsigned short fieldId = 0; fieldId < DCGM_FI_MAX_FIELDS; fieldId++)
+    {
+        dcgmcm_gpu_field_fetcher_t const *fetcher = DcgmcmGetGpuFieldFetcher(fieldId);
+        if (fetcher == nullptr)
+        {
+            continue;
+        }
+        numFetchers++;
+
+        CHECK(fetcher->fieldId == fieldId);
+        REQUIRE(fetcher->fetch != nullptr);
+
+        dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+        REQUIRE(fieldMeta != nullptr);
+        CHECK(fetcher->fieldType == fieldMeta->fieldType);
+        CHECK(fieldMeta->scope != DCGM_FS_GLOBAL);
+    }
+    CHECK(numFetchers > 40);
+
+    CHECK(DcgmcmGetGpuFieldFetcher(DCGM_FI_DRIVER_VERSION) == nullptr);
+    CHECK(DcgmcmGetGpuFieldFetcher(DCGM_FI_MAX_FIELDS) == nullptr);
+}
+
+TEST_CASE("GpuFieldFetchers: Fields that share a driver call read its output")
+{
+    dcgmcm_batched_gpu_values_t batched {};
+    batched.memory.total        = 16ULL * 1024 * 1024 * 1024;
+    batched.memory.used         = 3ULL * 1024 * 1024 + 1;
+    batched.bar1Memory.bar1Free = 256ULL * 1024 * 1024;
+    batched.utilization.gpu     = 42;
+    batched.powerLimitMax       = 300500;
+    snprintf(batched.pciInfo.busId, sizeof(batched.pciInfo.busId), "00000000:3B:00.0");
+
+    auto fetch = [&batched](unsigned short fieldId, dcgmcm_batched_getter_t batch) {
+        dcgmcm_fetched_value_t value {};
+        dcgmcm_gpu_field_fetcher_t const *fetcher = DcgmcmGetGpuFieldFetcher(fieldId);
+        REQUIRE(fetcher != nullptr);
+        CHECK(fetcher->batch == batch);
+        CHECK(fetcher->fetch(nullptr, &batched, value) == NVML_SUCCESS);
+        return value;
+    };
+
+    CHECK(fetch(DCGM_FI_DEV_FB_TOTAL, DcgmcmBatchedMemoryInfo).i64 == 16 * 1024);
+    CHECK(fetch(DCGM_FI_DEV_FB_USED, DcgmcmBatchedMemoryInfo).i64 == 3);
+    CHECK(fetch(DCGM_FI_DEV_FB_FREE, DcgmcmBatchedMemoryInfo).i64 == 0);
+    CHECK(fetch(DCGM_FI_DEV_BAR1_FREE, DcgmcmBatchedBar1MemoryInfo).i64 == 256);
+    CHECK(fetch(DCGM_FI_DEV_GPU_UTIL, DcgmcmBatchedUtilization).i64 == 42);
+    CHECK(fetch(DCGM_FI_DEV_POWER_MGMT_LIMIT_MAX, DcgmcmBatchedPowerLimitConstraints).dbl == 300.0);
+    CHECK(std::string(fetch(DCGM_FI_DEV_PCI_BUSID, DcgmcmBatchedPciInfo).str) == "00000000:3B:00.0");
+
+    /* Clocks have no shared driver call */
+    dcgmcm_gpu_field_fetcher_t const *fetcher = DcgmcmGetGpuFieldFetcher(DCGM_FI_DEV_SM_CLOCK);
+    REQUIRE(fetcher != nullptr);
+    CHECK(fetcher->batch == DcgmcmBatchedCount);
+
+    /* Utilization prefers the driver's buffered samples */
+    fetcher = DcgmcmGetGpuFieldFetcher(DCGM_FI_DEV_GPU_UTIL);
+    REQUIRE(fetcher != nullptr);
+    CHECK(fetcher->samplingType == NVML_GPU_UTILIZATION_SAMPLES);
+}
+
+namespace
+{
+nvmlReturn_t g_fieldValuesReturn = NVML_SUCCESS;
+
+nvmlReturn_t FakeGetFieldValues(nvmlDevice_t, int valuesCount, nvmlFieldValue_t *values)
+{
+    for (int i = 0; i < valuesCount; i++)
+    {
+        values[i].nvmlReturn = g_fieldValuesReturn;
+    }
+    return g_fieldValuesReturn;
+}
+} // namespace
+
+TEST_CASE("GpuFieldFetchers: Only successful field value batches save driver calls")
+{
+    set_nvmlDeviceGetFieldValuesHook(FakeGetFieldValues);
+
+    nvmlFieldValue_t values[3] {};
+    long long driverCallsSaved = 0;
+
+    g_fieldValuesReturn = NVML_SUCCESS;
+    CHECK(DcgmcmGetFieldValues(nullptr, 3, values, driverCallsSaved) == NVML_SUCCESS);
+    CHECK(driverCallsSaved == 2);
+
+    /* The caller falls back to blank values, so nothing was saved */
+    g_fieldValuesReturn = NVML_ERROR_GPU_IS_LOST;
+    CHECK(DcgmcmGetFieldValues(nullptr, 3, values, driverCallsSaved) == NVML_ERROR_GPU_IS_LOST);
+    CHECK(driverCallsSaved == 2);
+
+    resetAllNvmlHooks();
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmJobStatsAccumulator.h>
+#include <dcgm_fields.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+void AddProcess(DcgmFvBuffer &fvBuffer, unsigned int gpuId, unsigned short fieldId, unsigned int pid, long long ts)
+{
+    dcgmRunningProcess_t proc {};
+    proc.version = dcgmRunningProcess_version;
+    proc.pid     = pid;
+    fvBuffer.AddBlobValue(DCGM_FE_GPU, gpuId, fieldId, &proc, sizeof(proc), ts, DCGM_ST_OK);
+}
+} // namespace
+
+TEST_CASE("JobStatsAccumulator: folds samples of running jobs")
+{
+    DcgmJobStatsAccumulator accumulator;
+    std::vector<unsigned int> newGpuIds;
+    std::vector<unsigned int> unusedGpuIds;
+
+    REQUIRE(accumulator.AddJob("job1", 1, 1000, { 0, 1 }, newGpuIds) == DCGM_ST_OK);
+    CHECK(newGpuIds == std::vector<unsigned int> { 0, 1 });
+    CHECK(accumulator.AddJob("job1", 1, 1000, { 0 }, newGpuIds) == DCGM_ST_DUPLICATE_KEY);
+
+    /* GPU 0 is already watched for job1 */
+    REQUIRE(accumulator.AddJob("job2", 1, 2000, { 0, 2 }, newGpuIds) == DCGM_ST_OK);
+    CHECK(newGpuIds == std::vector<unsigned int> { 2 });
+
+    DcgmFvBuffer fvBuffer;
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_UTIL, 99, 500, DCGM_ST_OK); /* Before both jobs */
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_UTIL, 10, 1500, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_UTIL, 30, 2500, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_UTIL, 20, 2400, DCGM_ST_OK); /* Out of order */
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 3, DCGM_FI_DEV_GPU_UTIL, 50, 2500, DCGM_ST_OK); /* No job */
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 1, DCGM_FI_DEV_POWER_VIOLATION, 100, 1100, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 1, DCGM_FI_DEV_POWER_VIOLATION, 400, 1900, DCGM_ST_OK);
+    fvBuffer.AddDoubleValue(DCGM_FE_GPU, 1, DCGM_FI_DEV_POWER_USAGE, 100.0, 1000, DCGM_ST_OK);
+    fvBuffer.AddDoubleValue(DCGM_FE_GPU, 1, DCGM_FI_DEV_POWER_USAGE, 200.0, 2000, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 1, DCGM_FI_DEV_XID_ERRORS, 79, 1200, DCGM_ST_OK);
+    AddProcess(fvBuffer, 0, DCGM_FI_DEV_COMPUTE_PIDS, 42, 1300);
+    AddProcess(fvBuffer, 0, DCGM_FI_DEV_COMPUTE_PIDS, 42, 2600);
+    AddProcess(fvBuffer, 0, DCGM_FI_DEV_COMPUTE_PIDS, 43, 2700);
+    accumulator.OnFvUpdates(fvBuffer);
+
+    DcgmJobStatsSnapshot job;
+    REQUIRE(accumulator.GetJobStats("job1", job) == DCGM_ST_OK);
+    CHECK(job.groupId == 1);
+    CHECK(job.startTime == 1000);
+    CHECK(job.endTime == 0);
+    std::vector<DcgmJobGpuStats> &gpuStats = job.gpus;
+    REQUIRE(gpuStats.size() == 2);
+    CHECK(gpuStats[0].gpuId == 0);
+    CHECK(gpuStats[1].gpuId == 1);
+
+    DcgmcmSummaryType_t summaryTypes[3]
+        = { DcgmcmSummaryTypeMinimum, DcgmcmSummaryTypeMaximum, DcgmcmSummaryTypeDifference };
+    long long i64Vals[3];
+    REQUIRE(gpuStats[0].GetSummaries(DCGM_FI_DEV_GPU_UTIL, 3, summaryTypes, i64Vals) == DCGM_ST_OK);
+    CHECK(i64Vals[0] == 10);
+    CHECK(i64Vals[1] == 30);
+    CHECK(i64Vals[2] == 20);
+    CHECK(gpuStats[0].computePids == std::vector<unsigned int> { 42, 43 });
+    CHECK(gpuStats[0].graphicsPids.empty());
+    CHECK(gpuStats[0].GetSummaries(DCGM_FI_DEV_SM_CLOCK, 3, summaryTypes, i64Vals) == DCGM_ST_NO_DATA);
+    CHECK(DCGM_INT64_IS_BLANK(i64Vals[0]));
+
+    REQUIRE(gpuStats[1].GetSummaries(DCGM_FI_DEV_POWER_VIOLATION, 3, summaryTypes, i64Vals) == DCGM_ST_OK);
+    CHECK(i64Vals[2] == 300);
+    DcgmcmSummaryType_t integral = DcgmcmSummaryTypeIntegral;
+    double energy;
+    REQUIRE(gpuStats[1].GetSummaries(DCGM_FI_DEV_POWER_USAGE, 1, &integral, &energy) == DCGM_ST_OK);
+    CHECK(energy == Approx(150000.0));
+    CHECK(gpuStats[1].xidTimestamps == std::vector<timelib64_t> { 1200 });
+
+    /* job2 started later, so it only has the samples since */
+    REQUIRE(accumulator.GetJobStats("job2", job) == DCGM_ST_OK);
+    REQUIRE(gpuStats[0].GetSummaries(DCGM_FI_DEV_GPU_UTIL, 3, summaryTypes, i64Vals) == DCGM_ST_OK);
+    CHECK(i64Vals[0] == 30);
+    CHECK(i64Vals[1] == 30);
+    CHECK(gpuStats[0].computePids == std::vector<unsigned int> { 42, 43 });
+
+    /* GPU 0 is still used by job2 */
+    REQUIRE(accumulator.StopJob("job1", 3000, unusedGpuIds) == DCGM_ST_OK);
+    CHECK(unusedGpuIds == std::vector<unsigned int> { 1 });
+
+    DcgmFvBuffer laterBuffer;
+    laterBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_UTIL, 90, 3500, DCGM_ST_OK);
+    accumulator.OnFvUpdates(laterBuffer);
+
+    REQUIRE(accumulator.GetJobStats("job1", job) == DCGM_ST_OK);
+    REQUIRE(gpuStats[0].GetSummaries(DCGM_FI_DEV_GPU_UTIL, 3, summaryTypes, i64Vals) == DCGM_ST_OK);
+    CHECK(i64Vals[1] == 30);
+    REQUIRE(accumulator.GetJobStats("job2", job) == DCGM_ST_OK);
+    REQUIRE(gpuStats[0].GetSummaries(DCGM_FI_DEV_GPU_UTIL, 3, summaryTypes, i64Vals) == DCGM_ST_OK);
+    CHECK(i64Vals[1] == 90);
+
+    /* Stopped jobs keep their stats until removed */
+    REQUIRE(accumulator.RemoveJob("job1", unusedGpuIds) == DCGM_ST_OK);
+    CHECK(unusedGpuIds.empty());
+    CHECK(accumulator.GetJobStats("job1", job) == DCGM_ST_NO_DATA);
+    CHECK(accumulator.StopJob("job1", 4000, unusedGpuIds) == DCGM_ST_NO_DATA);
+
+    accumulator.RemoveAllJobs(unusedGpuIds);
+    std::sort(unusedGpuIds.begin(), unusedGpuIds.end());
+    CHECK(unusedGpuIds == std::vector<unsigned int> { 0, 2 });
+    CHECK(accumulator.GetJobCount() == 0);
+}
+
+TEST_CASE("JobStatsAccumulator: keeps the first XID errors")
+{
+    DcgmJobStatsAccumulator accumulator;
+    std::vector<unsigned int> newGpuIds;
+
+    REQUIRE(accumulator.AddJob("job", 1, 0, { 0 }, newGpuIds) == DCGM_ST_OK);
+
+    DcgmFvBuffer fvBuffer;
+    for (long long ts = 1; ts <= 2 * DcgmJobStatsAccumulator::MAX_XID_TIMESTAMPS; ts++)
+    {
+        fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_XID_ERRORS, 13, ts, DCGM_ST_OK);
+    }
+    accumulator.OnFvUpdates(fvBuffer);
+
+    DcgmJobStatsSnapshot job;
+    REQUIRE(accumulator.GetJobStats("job", job) == DCGM_ST_OK);
+    std::vector<DcgmJobGpuStats> &gpuStats = job.gpus;
+    REQUIRE(gpuStats[0].xidTimestamps.size() == DcgmJobStatsAccumulator::MAX_XID_TIMESTAMPS);
+    CHECK(gpuStats[0].xidTimestamps.front() == 1);
+    CHECK(gpuStats[0].xidTimestamps.back() == DcgmJobStatsAccumulator::MAX_XID_TIMESTAMPS);
+}
+
+TEST_CASE("JobStatsAccumulator: evicts forgotten stopped jobs")
+{
+    DcgmJobStatsAccumulator accumulator;
+    std::vector<unsigned int> gpuIds;
+    std::vector<unsigned int> unusedGpuIds;
+    DcgmJobStatsSnapshot job;
+
+    SECTION("Past the TTL")
+    {
+        accumulator.SetRetention(0, 1000);
+
+        REQUIRE(accumulator.AddJob("stopped", 1, 0, { 0 }, gpuIds) == DCGM_ST_OK);
+        REQUIRE(accumulator.AddJob("running", 1, 0, { 0 }, gpuIds) == DCGM_ST_OK);
+        REQUIRE(accumulator.StopJob("stopped", 100, unusedGpuIds) == DCGM_ST_OK);
+
+        /* A shard evicts as jobs are added to it or stopped in it. Enough jobs to reach every shard */
+        for (int i = 0; i < 100; i++)
+        {
+            REQUIRE(accumulator.AddJob("later" + std::to_string(i), 1, 5000, { 0 }, gpuIds) == DCGM_ST_OK);
+        }
+
+        CHECK(accumulator.GetJobStats("stopped", job) == DCGM_ST_NO_DATA);
+        CHECK(accumulator.GetJobStats("running", job) == DCGM_ST_OK);
+        CHECK(accumulator.GetEvictedJobCount() == 1);
+        CHECK(accumulator.HasRunningJobs(0));
+    }
+
+    SECTION("Over the cap, longest stopped first")
+    {
+        /* 1 stopped job per shard */
+        accumulator.SetRetention(DcgmJobStatsAccumulator::NUM_SHARDS, 0);
+
+        for (int i = 0; i < 200; i++)
+        {
+            std::string jobId = "job" + std::to_string(i);
+            REQUIRE(accumulator.AddJob(jobId, 1, i, { 0 }, gpuIds) == DCGM_ST_OK);
+            REQUIRE(accumulator.StopJob(jobId, i, unusedGpuIds) == DCGM_ST_OK);
+        }
+
+        CHECK(accumulator.GetJobCount() <= DcgmJobStatsAccumulator::NUM_SHARDS);
+        CHECK(accumulator.GetJobCount() + accumulator.GetEvictedJobCount() == 200);
+        CHECK(accumulator.GetJobStats("job199", job) == DCGM_ST_OK);
+        CHECK(accumulator.GetJobStats("job0", job) == DCGM_ST_NO_DATA);
+        CHECK(!accumulator.HasRunningJobs(0));
+    }
+
+    SECTION("Removed jobs aren't evicted again")
+    {
+        accumulator.SetRetention(0, 1000);
+
+        REQUIRE(accumulator.AddJob("job", 1, 0, { 0 }, gpuIds) == DCGM_ST_OK);
+        REQUIRE(accumulator.StopJob("job", 100, unusedGpuIds) == DCGM_ST_OK);
+        REQUIRE(accumulator.RemoveJob("job", unusedGpuIds) == DCGM_ST_OK);
+        REQUIRE(accumulator.AddJob("job", 1, 5000, { 0 }, gpuIds) == DCGM_ST_OK);
+
+        CHECK(accumulator.GetJobStats("job", job) == DCGM_ST_OK);
+        CHECK(accumulator.GetEvictedJobCount() == 0);
+    }
+}
+
+TEST_CASE("JobStatsAccumulator: jobs are started, read and stopped concurrently")
+{
+    DcgmJobStatsAccumulator accumulator;
+    std::atomic<bool> stop = false;
+    std::atomic<int> failures = 0;
+
+    std::thread feeder([&] {
+        long long ts = 0;
+        while (!stop)
+        {
+            DcgmFvBuffer fvBuffer;
+            for (unsigned int gpuId = 0; gpuId < 4; gpuId++)
+            {
+                fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_UTIL, 50, ++ts, DCGM_ST_OK);
+            }
+            accumulator.OnFvUpdates(fvBuffer);
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (unsigned int w = 0; w < 4; w++)
+    {
+        workers.emplace_back([&, w] {
+            std::vector<unsigned int> gpuIds;
+            DcgmJobStatsSnapshot job;
+            for (int i = 0; i < 300; i++)
+            {
+                std::string jobId = "worker" + std::to_string(w) + "job" + std::to_string(i);
+                if (accumulator.AddJob(jobId, 1, 0, { w, (w + 1) % 4 }, gpuIds) != DCGM_ST_OK
+                    || accumulator.GetJobStats(jobId, job) != DCGM_ST_OK || job.gpus.size() != 2
+                    || accumulator.StopJob(jobId, 1, gpuIds) != DCGM_ST_OK
+                    || accumulator.RemoveJob(jobId, gpuIds) != DCGM_ST_OK)
+                {
+                    failures++;
+                }
+            }
+        });
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    stop = true;
+    feeder.join();
+
+    CHECK(failures == 0);
+    CHECK(accumulator.GetJobCount() == 0);
+    for (unsigned int gpuId = 0; gpuId < 4; gpuId++)
+    {
+        CHECK(!accumulator.HasRunningJobs(gpuId));
+    }
+}
+
+TEST_CASE("JobStatsAccumulator: update sequence")
+{
+    DcgmJobStatsAccumulator accumulator;
+    std::vector<unsigned int> newGpuIds;
+    std::vector<unsigned int> unusedGpuIds;
+    unsigned long long updateSequence = 0;
+    unsigned long long otherSequence  = 0;
+
+    CHECK(accumulator.GetJobUpdateSequence("job1", updateSequence) == DCGM_ST_NO_DATA);
+
+    REQUIRE(accumulator.AddJob("job1", 1, 1000, { 0 }, newGpuIds) == DCGM_ST_OK);
+    REQUIRE(accumulator.AddJob("job2", 1, 1000, { 1 }, newGpuIds) == DCGM_ST_OK);
+    REQUIRE(accumulator.GetJobUpdateSequence("job1", updateSequence) == DCGM_ST_OK);
+    REQUIRE(accumulator.GetJobUpdateSequence("job2", otherSequence) == DCGM_ST_OK);
+    CHECK(updateSequence != 0);
+    CHECK(otherSequence != updateSequence);
+
+    DcgmJobStatsSnapshot job;
+    REQUIRE(accumulator.GetJobStats("job1", job) == DCGM_ST_OK);
+    CHECK(job.updateSequence == updateSequence);
+
+    /* Samples of other jobs' GPUs and from before the job don't change it */
+    DcgmFvBuffer fvBuffer;
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_UTIL, 10, 1500, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_UTIL, 10, 500, DCGM_ST_OK);
+    accumulator.OnFvUpdates(fvBuffer);
+    REQUIRE(accumulator.GetJobUpdateSequence("job1", job.updateSequence) == DCGM_ST_OK);
+    CHECK(job.updateSequence == updateSequence);
+
+    DcgmFvBuffer jobBuffer;
+    jobBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_UTIL, 10, 1500, DCGM_ST_OK);
+    accumulator.OnFvUpdates(jobBuffer);
+    REQUIRE(accumulator.GetJobUpdateSequence("job1", job.updateSequence) == DCGM_ST_OK);
+    CHECK(job.updateSequence > updateSequence);
+    updateSequence = job.updateSequence;
+
+    REQUIRE(accumulator.StopJob("job1", 2000, unusedGpuIds) == DCGM_ST_OK);
+    REQUIRE(accumulator.GetJobUpdateSequence("job1", job.updateSequence) == DCGM_ST_OK);
+    CHECK(job.updateSequence > updateSequence);
+
+    /* A job added again under the same id doesn't reuse a sequence of the one before */
+    updateSequence = job.updateSequence;
+    REQUIRE(accumulator.RemoveJob("job1", unusedGpuIds) == DCGM_ST_OK);
+    REQUIRE(accumulator.AddJob("job1", 1, 3000, { 0 }, newGpuIds) == DCGM_ST_OK);
+    REQUIRE(accumulator.GetJobUpdateSequence("job1", job.updateSequence) == DCGM_ST_OK);
+    CHECK(job.updateSequence > updateSequence);
+}
+
+TEST_CASE("JobStatsAccumulator: percentiles of gauges")
+{
+    DcgmJobStatsAccumulator accumulator;
+    std::vector<unsigned int> newGpuIds;
+
+    REQUIRE(accumulator.AddJob("job1", 1, 0, { 0 }, newGpuIds) == DCGM_ST_OK);
+
+    DcgmFvBuffer fvBuffer;
+    for (int i = 1; i <= 100; i++)
+    {
+        fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_SM_CLOCK, 1000 + i, i, DCGM_ST_OK);
+        fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_POWER_VIOLATION, i, i, DCGM_ST_OK);
+    }
+    accumulator.OnFvUpdates(fvBuffer);
+
+    DcgmJobStatsSnapshot snapshot;
+    REQUIRE(accumulator.GetJobStats("job1", snapshot) == DCGM_ST_OK);
+    REQUIRE(snapshot.gpus.size() == 1);
+
+    DcgmQuantileSketch const *sketch = snapshot.gpus[0].GetSketch(DCGM_FI_DEV_SM_CLOCK);
+    REQUIRE(sketch != nullptr);
+    CHECK(sketch->Count() == 100);
+    CHECK(sketch->Quantile(0.5) == Approx(1050.5).epsilon(0.01));
+
+    /* Counters aren't sketched */
+    CHECK(snapshot.gpus[0].GetSketch(DCGM_FI_DEV_POWER_VIOLATION) == nullptr);
+    CHECK(snapshot.gpus[0].GetSketch(DCGM_FI_DEV_MEM_CLOCK) == nullptr);
+
+    DcgmcmSummaryType_t summaryTypes[] = { DcgmcmSummaryTypeP50, DcgmcmSummaryTypeP99 };
+    long long summaryValues[2];
+    REQUIRE(snapshot.gpus[0].GetSummaries(DCGM_FI_DEV_SM_CLOCK, 2, summaryTypes, summaryValues) == DCGM_ST_OK);
+    CHECK(summaryValues[0] == Approx(1050).epsilon(0.01));
+    CHECK(summaryValues[1] == Approx(1099).epsilon(0.01));
+}
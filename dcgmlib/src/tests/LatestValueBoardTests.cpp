@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmLatestValueBoard.h>
+#include <dcgm_fields.h>
+#include <dcgm_latest_board.h>
+
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+struct FakeState
+{
+    std::vector<dcgmGroupEntityPair_t> entities;
+    std::vector<unsigned short> watchedFieldIds;
+    unsigned long long sequence = 1;
+    int numGetLatest            = 0;
+
+    /* Latest value and the sequence it was set at by entity and field */
+    std::map<std::pair<unsigned int, unsigned short>, std::pair<double, unsigned long long>> values;
+
+    void Set(unsigned int gpuId, unsigned short fieldId, double value)
+    {
+        values[{ gpuId, fieldId }] = { value, ++sequence };
+    }
+};
+
+/* Serves values from a FakeState the test keeps */
+class FakeSource : public DcgmMetricsSource
+{
+public:
+    explicit FakeSource(FakeState &state)
+        : m_state(state)
+    {}
+
+    dcgmReturn_t GetEntities(std::vector<dcgmGroupEntityPair_t> &entities) override
+    {
+        entities = m_state.entities;
+        return DCGM_ST_OK;
+    }
+
+    dcgmReturn_t Watch(std::vector<dcgmGroupEntityPair_t> const & /* entities */,
+                       std::vector<unsigned short> const &fieldIds,
+                       timelib64_t /* updateFreqUsec */) override
+    {
+        m_state.watchedFieldIds = fieldIds;
+        return DCGM_ST_OK;
+    }
+
+    dcgmReturn_t GetLatest(std::vector<dcgmGroupEntityPair_t> & /* entities */,
+                           std::vector<unsigned short> & /* fieldIds */,
+                           DcgmFvBuffer &fvBuffer,
+                           unsigned long long sinceSequence,
+                           unsigned long long &updateSequence) override
+    {
+        m_state.numGetLatest++;
+        for (auto const &[key, value] : m_state.values)
+        {
+            if (value.second <= sinceSequence)
+            {
+                continue;
+            }
+            if (DcgmFieldGetById(key.second)->fieldType == DCGM_FT_DOUBLE)
+            {
+                fvBuffer.AddDoubleValue(DCGM_FE_GPU, key.first, key.second, value.first, 1000, DCGM_ST_OK);
+            }
+            else
+            {
+                fvBuffer.AddInt64Value(DCGM_FE_GPU, key.first, key.second, (long long)value.first, 1000, DCGM_ST_OK);
+            }
+        }
+        updateSequence = m_state.sequence;
+        return DCGM_ST_OK;
+    }
+
+private:
+    FakeState &m_state;
+};
+
+/* A segment name no other test run uses */
+std::string BoardName()
+{
+    return "/dcgm-latest-board-test-" + std::to_string(getpid());
+}
+
+dcgmLatestBoardValue_t ReadValue(dcgmLatestBoard_t const &board, unsigned int gpuId, unsigned short fieldId)
+{
+    dcgmLatestBoardValue_t value {};
+    int index = dcgmLatestBoardFind(&board, DCGM_FE_GPU, gpuId, fieldId);
+    REQUIRE(index >= 0);
+    REQUIRE(dcgmLatestBoardRead(&board, index, &value) == 0);
+    return value;
+}
+} // namespace
+
+TEST_CASE("LatestValueBoard: Readers see published values")
+{
+    REQUIRE(DcgmFieldsInit() == 0);
+
+    FakeState state;
+    state.entities = { { DCGM_FE_GPU, 1 }, { DCGM_FE_GPU, 0 } };
+    std::string name = BoardName();
+    dcgmLatestBoard_t reader {};
+
+    {
+        /* The string field is skipped */
+        DcgmLatestValueBoard board(
+            { DCGM_FI_DEV_POWER_USAGE, DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_NAME, DCGM_FI_DEV_GPU_TEMP },
+            std::make_unique<FakeSource>(state));
+        REQUIRE(board.Create(name) == DCGM_ST_OK);
+        CHECK(board.GetNumEntries() == 4);
+        CHECK(state.watchedFieldIds == std::vector<unsigned short> { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE });
+
+        REQUIRE(dcgmLatestBoardOpen(name.c_str(), &reader) == 0);
+        CHECK(reader.header->numEntries == 4);
+        CHECK(reader.header->writerPid == (std::uint32_t)getpid());
+        CHECK(dcgmLatestBoardIsClosed(&reader) == 0);
+        CHECK(dcgmLatestBoardFind(&reader, DCGM_FE_GPU, 0, DCGM_FI_DEV_NAME) == -1);
+        CHECK(dcgmLatestBoardFind(&reader, DCGM_FE_GPU, 2, DCGM_FI_DEV_GPU_TEMP) == -1);
+        CHECK(ReadValue(reader, 0, DCGM_FI_DEV_GPU_TEMP).status == DCGM_ST_NO_DATA);
+
+        state.Set(0, DCGM_FI_DEV_GPU_TEMP, 45);
+        state.Set(1, DCGM_FI_DEV_POWER_USAGE, 250.5);
+        board.Publish(2000);
+        CHECK(reader.header->publishCount == 1);
+        CHECK(reader.header->publishUsec == 2000);
+
+        dcgmLatestBoardValue_t value = ReadValue(reader, 0, DCGM_FI_DEV_GPU_TEMP);
+        CHECK(value.status == DCGM_ST_OK);
+        CHECK(value.fieldType == DCGM_FT_INT64);
+        CHECK(value.timestamp == 1000);
+        CHECK(value.value.i64 == 45);
+
+        value = ReadValue(reader, 1, DCGM_FI_DEV_POWER_USAGE);
+        CHECK(value.status == DCGM_ST_OK);
+        CHECK(value.fieldType == DCGM_FT_DOUBLE);
+        CHECK(value.value.dbl == 250.5);
+
+        CHECK(ReadValue(reader, 1, DCGM_FI_DEV_GPU_TEMP).status == DCGM_ST_NO_DATA);
+
+        /* Only what changed is rewritten */
+        state.Set(0, DCGM_FI_DEV_GPU_TEMP, 47);
+        board.Publish(3000);
+        CHECK(ReadValue(reader, 0, DCGM_FI_DEV_GPU_TEMP).value.i64 == 47);
+        CHECK(ReadValue(reader, 1, DCGM_FI_DEV_POWER_USAGE).value.dbl == 250.5);
+        CHECK(reader.entries[dcgmLatestBoardFind(&reader, DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP)].sequence == 4);
+        CHECK(reader.entries[dcgmLatestBoardFind(&reader, DCGM_FE_GPU, 1, DCGM_FI_DEV_POWER_USAGE)].sequence == 2);
+        CHECK(state.numGetLatest == 2);
+    }
+
+    /* Readers that still have it mapped see it closed. New readers don't find it */
+    CHECK(dcgmLatestBoardIsClosed(&reader) != 0);
+    dcgmLatestBoardClose(&reader);
+
+    dcgmLatestBoard_t gone {};
+    CHECK(dcgmLatestBoardOpen(name.c_str(), &gone) == -1);
+}
+
+TEST_CASE("LatestValueBoard: A restarted writer replaces the segment")
+{
+    REQUIRE(DcgmFieldsInit() == 0);
+
+    FakeState state;
+    state.entities   = { { DCGM_FE_GPU, 0 } };
+    std::string name = BoardName();
+
+    DcgmLatestValueBoard first({ DCGM_FI_DEV_GPU_TEMP }, std::make_unique<FakeSource>(state));
+    REQUIRE(first.Create(name) == DCGM_ST_OK);
+
+    DcgmLatestValueBoard second({ DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE },
+                                std::make_unique<FakeSource>(state));
+    REQUIRE(second.Create(name) == DCGM_ST_OK);
+
+    dcgmLatestBoard_t reader {};
+    REQUIRE(dcgmLatestBoardOpen(name.c_str(), &reader) == 0);
+    CHECK(reader.header->numEntries == 2);
+    dcgmLatestBoardClose(&reader);
+}
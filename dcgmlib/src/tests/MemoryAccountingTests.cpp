@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmMemoryAccounting.h>
+
+TEST_CASE("MemoryAccounting: counter keeps the most held at once")
+{
+    DcgmMemoryCounter counter;
+    CHECK(counter.Get().bytesUsed == 0);
+    CHECK(counter.Get().maxBytesUsed == 0);
+
+    counter.Charge(100);
+    counter.Charge(50);
+    counter.Release(100);
+    counter.Charge(20);
+
+    dcgmIntrospectMemoryTag_t usage = counter.Get();
+    CHECK(usage.bytesUsed == 70);
+    CHECK(usage.maxBytesUsed == 150);
+
+    counter.Release(70);
+    CHECK(counter.Get().bytesUsed == 0);
+    CHECK(counter.Get().maxBytesUsed == 150);
+}
+
+TEST_CASE("MemoryAccounting: charge is released when it goes out of scope")
+{
+    DcgmMemoryCounter counter;
+    {
+        DcgmMemoryCharge charge(&counter, 64);
+        CHECK(counter.Get().bytesUsed == 64);
+
+        charge.Add(32);
+        CHECK(counter.Get().bytesUsed == 96);
+    }
+
+    CHECK(counter.Get().bytesUsed == 0);
+    CHECK(counter.Get().maxBytesUsed == 96);
+
+    /* Nothing to charge */
+    DcgmMemoryCharge noCharge(nullptr, 64);
+    noCharge.Add(32);
+}
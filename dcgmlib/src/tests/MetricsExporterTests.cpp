@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmMetricsExporter.h>
+#include <dcgm_fields.h>
+
+#include <arpa/inet.h>
+#include <map>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+struct FakeState
+{
+    std::vector<dcgmGroupEntityPair_t> entities;
+    std::vector<unsigned short> watchedFieldIds;
+    unsigned long long sequence = 1;
+
+    /* Latest value and the sequence it was set at by entity and field */
+    std::map<std::pair<unsigned int, unsigned short>, std::pair<double, unsigned long long>> values;
+
+    void Set(unsigned int gpuId, unsigned short fieldId, double value)
+    {
+        values[{ gpuId, fieldId }] = { value, ++sequence };
+    }
+};
+
+/* Serves values from a FakeState the test keeps */
+class FakeSource : public DcgmMetricsSource
+{
+public:
+    explicit FakeSource(FakeState &state)
+        : m_state(state)
+    {}
+
+    dcgmReturn_t GetEntities(std::vector<dcgmGroupEntityPair_t> &entities) override
+    {
+        entities = m_state.entities;
+        return DCGM_ST_OK;
+    }
+
+    dcgmReturn_t Watch(std::vector<dcgmGroupEntityPair_t> const & /* entities */,
+                       std::vector<unsigned short> const &fieldIds,
+                       timelib64_t /* updateFreqUsec */) override
+    {
+        m_state.watchedFieldIds = fieldIds;
+        return DCGM_ST_OK;
+    }
+
+    dcgmReturn_t GetLatest(std::vector<dcgmGroupEntityPair_t> & /* entities */,
+                           std::vector<unsigned short> & /* fieldIds */,
+                           DcgmFvBuffer &fvBuffer,
+                           unsigned long long sinceSequence,
+                           unsigned long long &updateSequence) override
+    {
+        for (auto const &[key, value] : m_state.values)
+        {
+            if (value.second <= sinceSequence)
+            {
+                continue;
+            }
+            if (DcgmFieldGetById(key.second)->fieldType == DCGM_FT_DOUBLE)
+            {
+                fvBuffer.AddDoubleValue(DCGM_FE_GPU, key.first, key.second, value.first, 0, DCGM_ST_OK);
+            }
+            else
+            {
+                fvBuffer.AddInt64Value(DCGM_FE_GPU, key.first, key.second, (long long)value.first, 0, DCGM_ST_OK);
+            }
+        }
+        updateSequence = m_state.sequence;
+        return DCGM_ST_OK;
+    }
+
+private:
+    FakeState &m_state;
+};
+
+std::string Body(std::string const &response)
+{
+    return response.substr(response.find("\r\n\r\n") + 4);
+}
+
+/* Send request to the exporter on port and read the response until it closes the connection */
+std::string HttpRequest(std::uint16_t port, std::string const &request)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(fd >= 0);
+
+    struct sockaddr_in addr {};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    REQUIRE(send(fd, request.data(), request.size(), 0) == (ssize_t)request.size());
+
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    {
+        response.append(buffer, received);
+    }
+    close(fd);
+    return response;
+}
+} // namespace
+
+TEST_CASE("MetricsExporter: ParseFieldIds")
+{
+    CHECK(DcgmMetricsExporter::ParseFieldIds("150, 155,,203")
+          == std::vector<unsigned short> { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE, DCGM_FI_DEV_GPU_UTIL });
+    CHECK(DcgmMetricsExporter::ParseFieldIds("150,abc,0,70000") == std::vector<unsigned short> { 150 });
+    CHECK(DcgmMetricsExporter::ParseFieldIds("") == DcgmMetricsExporter::DefaultFieldIds());
+}
+
+TEST_CASE("MetricsExporter: Rendering")
+{
+    DcgmFieldsInit();
+
+    FakeState state;
+    state.entities = { { DCGM_FE_GPU, 0 }, { DCGM_FE_GPU, 1 } };
+
+    /* The string field is skipped */
+    DcgmMetricsExporter exporter({ DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_NAME, DCGM_FI_DEV_POWER_USAGE },
+                                 std::make_unique<FakeSource>(state));
+
+    state.Set(0, DCGM_FI_DEV_GPU_TEMP, 40);
+    state.Set(1, DCGM_FI_DEV_GPU_TEMP, 41);
+    state.Set(0, DCGM_FI_DEV_POWER_USAGE, 100.5);
+    state.Set(1, DCGM_FI_DEV_POWER_USAGE, DCGM_FP64_BLANK);
+
+    std::string response = exporter.Scrape();
+    CHECK(state.watchedFieldIds == std::vector<unsigned short> { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE });
+    CHECK(response.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+    CHECK(response.find("Content-Length: " + std::to_string(Body(response).size()) + "\r\n") != std::string::npos);
+    CHECK(Body(response)
+          == "# TYPE dcgm_gpu_temp gauge\n"
+             "# HELP dcgm_gpu_temp DCGM field 150 (gpu_temp)\n"
+             "dcgm_gpu_temp{gpu=\"0\"} 40\n"
+             "dcgm_gpu_temp{gpu=\"1\"} 41\n"
+             "# TYPE dcgm_power_usage gauge\n"
+             "# HELP dcgm_power_usage DCGM field 155 (power_usage)\n"
+             "dcgm_power_usage{gpu=\"0\"} 100.5\n"
+             "# EOF\n");
+    CHECK(exporter.GetRenderCount() == 1);
+
+    /* Nothing changed */
+    exporter.Scrape();
+    CHECK(exporter.GetRenderCount() == 1);
+
+    /* A value that was set again to the same value doesn't re-render either */
+    state.Set(0, DCGM_FI_DEV_GPU_TEMP, 40);
+    exporter.Scrape();
+    CHECK(exporter.GetRenderCount() == 1);
+
+    state.Set(1, DCGM_FI_DEV_GPU_TEMP, 45);
+    state.Set(1, DCGM_FI_DEV_POWER_USAGE, 75.25);
+    response = exporter.Scrape();
+    CHECK(exporter.GetRenderCount() == 2);
+    CHECK(Body(response).find("dcgm_gpu_temp{gpu=\"1\"} 45\n") != std::string::npos);
+    CHECK(Body(response).find("dcgm_power_usage{gpu=\"1\"} 75.25\n") != std::string::npos);
+    CHECK(Body(response).find("dcgm_gpu_temp{gpu=\"0\"} 40\n") != std::string::npos);
+}
+
+TEST_CASE("MetricsExporter: HTTP")
+{
+    DcgmFieldsInit();
+
+    FakeState state;
+    state.entities = { { DCGM_FE_GPU, 0 } };
+    state.Set(0, DCGM_FI_DEV_GPU_TEMP, 50);
+
+    DcgmMetricsExporter exporter({ DCGM_FI_DEV_GPU_TEMP }, std::make_unique<FakeSource>(state));
+    CHECK(exporter.Listen("not-an-address") == DCGM_ST_BADPARAM);
+    REQUIRE(exporter.Listen("127.0.0.1:0") == DCGM_ST_OK);
+    REQUIRE(exporter.GetPort() != 0);
+    REQUIRE(exporter.Start() == 0);
+
+    std::string response = HttpRequest(exporter.GetPort(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    CHECK(response.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+    CHECK(Body(response).find("dcgm_gpu_temp{gpu=\"0\"} 50\n") != std::string::npos);
+
+    response = HttpRequest(exporter.GetPort(), "GET / HTTP/1.1\r\n\r\n");
+    CHECK(response.rfind("HTTP/1.1 404 Not Found\r\n", 0) == 0);
+
+    response = HttpRequest(exporter.GetPort(), "POST /metrics HTTP/1.1\r\n\r\n");
+    CHECK(response.rfind("HTTP/1.1 405 Method Not Allowed\r\n", 0) == 0);
+
+    exporter.StopAndWait(10000);
+}
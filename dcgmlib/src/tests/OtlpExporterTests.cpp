@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmOtlpExporter.h>
+#include <dcgm_fields.h>
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+/* Fields of one protobuf message by field number. Varints and fixed64s as numbers, the rest as bytes */
+struct Message
+{
+    std::multimap<unsigned int, std::uint64_t> numbers;
+    std::multimap<unsigned int, std::string_view> bytes;
+
+    std::vector<Message> Messages(unsigned int fieldNumber) const;
+
+    std::string_view Bytes(unsigned int fieldNumber) const
+    {
+        auto it = bytes.find(fieldNumber);
+        return it == bytes.end() ? std::string_view() : it->second;
+    }
+};
+
+std::uint64_t ReadVarint(std::string_view &in)
+{
+    std::uint64_t value = 0;
+    for (int shift = 0; !in.empty(); shift += 7)
+    {
+        unsigned char const byte = in[0];
+        in.remove_prefix(1);
+        value |= (std::uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            break;
+        }
+    }
+    return value;
+}
+
+Message Parse(std::string_view in)
+{
+    Message message;
+    while (!in.empty())
+    {
+        std::uint64_t const tag         = ReadVarint(in);
+        unsigned int const fieldNumber = tag >> 3;
+        switch (tag & 7)
+        {
+            case 0:
+                message.numbers.emplace(fieldNumber, ReadVarint(in));
+                break;
+            case 1:
+            {
+                std::uint64_t value = 0;
+                memcpy(&value, in.data(), sizeof(value));
+                message.numbers.emplace(fieldNumber, value);
+                in.remove_prefix(sizeof(value));
+                break;
+            }
+            case 2:
+            {
+                size_t const size = ReadVarint(in);
+                message.bytes.emplace(fieldNumber, in.substr(0, size));
+                in.remove_prefix(size);
+                break;
+            }
+            default:
+                FAIL("Unexpected wire type " << (tag & 7));
+        }
+    }
+    return message;
+}
+
+std::vector<Message> Message::Messages(unsigned int fieldNumber) const
+{
+    std::vector<Message> messages;
+    auto range = bytes.equal_range(fieldNumber);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        messages.push_back(Parse(it->second));
+    }
+    return messages;
+}
+
+/* Metrics of a request by name */
+std::map<std::string, Message> Metrics(std::string const &request)
+{
+    std::map<std::string, Message> metrics;
+    auto resourceMetrics = Parse(request).Messages(1);
+    REQUIRE(resourceMetrics.size() == 1);
+    auto scopeMetrics = resourceMetrics[0].Messages(2);
+    REQUIRE(scopeMetrics.size() == 1);
+    CHECK(scopeMetrics[0].Messages(1)[0].Bytes(1) == "dcgm");
+    for (auto const &metric : scopeMetrics[0].Messages(2))
+    {
+        metrics[std::string(metric.Bytes(1))] = metric;
+    }
+    return metrics;
+}
+
+std::shared_ptr<DcgmFvBuffer const> Snapshot(unsigned int gpuId, long long temp, double power, long long ts)
+{
+    auto fvBuffer = std::make_shared<DcgmFvBuffer>();
+    fvBuffer->AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, temp, ts, DCGM_ST_OK);
+    fvBuffer->AddDoubleValue(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, power, ts, DCGM_ST_OK);
+    /* Not pushed: blank, failed and not configured */
+    fvBuffer->AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_GPU_TEMP, DCGM_INT64_BLANK, ts, DCGM_ST_OK);
+    fvBuffer->AddDoubleValue(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_POWER_USAGE, 1.0, ts, DCGM_ST_NOT_SUPPORTED);
+    fvBuffer->AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_SM_CLOCK, 1000, ts, DCGM_ST_OK);
+    return fvBuffer;
+}
+} // namespace
+
+TEST_CASE("DcgmOtlpExporter: encodes every sample as a gauge data point")
+{
+    DcgmFieldsInit();
+
+    std::vector<std::string> sent;
+    DcgmOtlpExporter exporter({ DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE, DCGM_FI_DEV_NAME });
+    exporter.SetSender([&sent](std::string const &request) {
+        sent.push_back(request);
+        return 200;
+    });
+
+    /* Nothing to push */
+    exporter.Export(0);
+    CHECK(sent.empty());
+
+    exporter.OnFvUpdates(Snapshot(0, 40, 100.5, 1000));
+    exporter.OnFvUpdates(Snapshot(1, 41, 101.5, 2000));
+    exporter.Export(0);
+    REQUIRE(sent.size() == 1);
+    CHECK(exporter.GetQueuedRequests() == 0);
+
+    auto resource = Parse(sent[0]).Messages(1)[0].Messages(1)[0].Messages(1);
+    REQUIRE(resource.size() == 2);
+    CHECK(resource[0].Bytes(1) == "service.name");
+    CHECK(resource[0].Messages(2)[0].Bytes(1) == "nv-hostengine");
+
+    auto metrics = Metrics(sent[0]);
+    REQUIRE(metrics.size() == 2);
+
+    auto temp = metrics["dcgm_gpu_temp"].Messages(5)[0].Messages(1);
+    REQUIRE(temp.size() == 2);
+    CHECK(temp[0].numbers.find(3)->second == 1000000);
+    CHECK(temp[0].numbers.find(6)->second == 40);
+    auto attribute = temp[1].Messages(7);
+    REQUIRE(attribute.size() == 1);
+    CHECK(attribute[0].Bytes(1) == "gpu");
+    CHECK(attribute[0].Messages(2)[0].numbers.find(3)->second == 1);
+    CHECK(temp[1].numbers.find(6)->second == 41);
+
+    auto power = metrics["dcgm_power_usage"].Messages(5)[0].Messages(1);
+    REQUIRE(power.size() == 2);
+    double value;
+    std::uint64_t bits = power[1].numbers.find(4)->second;
+    memcpy(&value, &bits, sizeof(value));
+    CHECK(value == 101.5);
+
+    /* Each sample is pushed once */
+    exporter.Export(0);
+    CHECK(sent.size() == 1);
+}
+
+TEST_CASE("DcgmOtlpExporter: retries and drops")
+{
+    DcgmFieldsInit();
+
+    int status = 503;
+    std::vector<std::string> sent;
+    DcgmOtlpExporter exporter({ DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_POWER_USAGE }, 1000000, 1000000, 1000);
+    exporter.SetSender([&](std::string const &request) {
+        sent.push_back(request);
+        return status;
+    });
+
+    exporter.OnFvUpdates(Snapshot(0, 40, 100.5, 1000));
+    exporter.Export(0);
+    CHECK(sent.size() == 1);
+    CHECK(exporter.GetQueuedRequests() == 1);
+
+    /* Not retried before the delay is over. The next batch waits behind the first */
+    exporter.OnFvUpdates(Snapshot(0, 41, 100.5, 2000));
+    exporter.Export(999999);
+    CHECK(sent.size() == 1);
+    CHECK(exporter.GetQueuedRequests() == 2);
+
+    /* The delay doubles */
+    exporter.Export(1000000);
+    CHECK(sent.size() == 2);
+    exporter.Export(2999999);
+    CHECK(sent.size() == 2);
+
+    /* Oldest first once the collector is back */
+    status = 200;
+    exporter.Export(3000000);
+    REQUIRE(sent.size() == 4);
+    CHECK(sent[2] == sent[0]);
+    CHECK(sent[3] != sent[0]);
+    CHECK(exporter.GetQueuedRequests() == 0);
+    CHECK(exporter.GetDroppedRequests() == 0);
+
+    /* Rejected requests aren't retried */
+    status = 400;
+    exporter.OnFvUpdates(Snapshot(0, 42, 100.5, 3000));
+    exporter.Export(3000000);
+    CHECK(exporter.GetQueuedRequests() == 0);
+    CHECK(exporter.GetDroppedRequests() == 1);
+
+    /* The kept requests are capped by dropping the oldest */
+    status = 0;
+    for (int i = 0; i < 20; i++)
+    {
+        exporter.OnFvUpdates(Snapshot(0, i, 100.5, 4000 + i));
+        exporter.Export(4000000);
+    }
+    CHECK(exporter.GetQueuedRequests() < 20);
+    CHECK(exporter.GetQueuedRequests() > 1);
+    CHECK(exporter.GetDroppedRequests() == 1 + 20 - exporter.GetQueuedRequests());
+}
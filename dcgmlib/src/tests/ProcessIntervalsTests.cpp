@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmProcessIntervals.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+std::vector<unsigned int> QueryPids(DcgmProcessIntervals const &intervals, timelib64_t startUsec, timelib64_t endUsec)
+{
+    std::vector<dcgm_process_interval_t> found;
+    intervals.Query(startUsec, endUsec, found);
+
+    std::vector<unsigned int> pids;
+    for (dcgm_process_interval_t const &interval : found)
+    {
+        pids.push_back(interval.pid);
+    }
+    return pids;
+}
+} // namespace
+
+TEST_CASE("ProcessIntervals: Overlapping windows")
+{
+    DcgmProcessIntervals intervals;
+    intervals.Set(1, 100, 200);
+    intervals.Set(2, 150, 0); /* Still running */
+    intervals.Set(3, 300, 400);
+    intervals.Set(4, 50, 60);
+    CHECK(intervals.Size() == 4);
+
+    /* In order of start time */
+    CHECK(QueryPids(intervals, 0, 0) == std::vector<unsigned int> { 4, 1, 2, 3 });
+    CHECK(QueryPids(intervals, 180, 250) == std::vector<unsigned int> { 1, 2 });
+    CHECK(QueryPids(intervals, 200, 200) == std::vector<unsigned int> { 1, 2 });
+    CHECK(QueryPids(intervals, 500, 0) == std::vector<unsigned int> { 2 });
+    CHECK(QueryPids(intervals, 0, 40).empty());
+
+    /* The process ended */
+    intervals.Set(2, 150, 160);
+    CHECK(QueryPids(intervals, 180, 250) == std::vector<unsigned int> { 1 });
+    CHECK(intervals.Size() == 4);
+
+    /* The PID was reused */
+    intervals.Set(1, 1000, 0);
+    CHECK(QueryPids(intervals, 180, 0) == std::vector<unsigned int> { 1, 3, 1 });
+}
+
+TEST_CASE("ProcessIntervals: Extended by samples")
+{
+    DcgmProcessIntervals intervals;
+    intervals.Extend(7, 100);
+    intervals.Extend(7, 110);
+    intervals.Extend(8, 105);
+    intervals.Extend(7, 130);
+
+    CHECK(intervals.Size() == 2);
+    CHECK(QueryPids(intervals, 120, 125) == std::vector<unsigned int> { 7 });
+    CHECK(QueryPids(intervals, 106, 0) == std::vector<unsigned int> { 7 });
+    CHECK(QueryPids(intervals, 0, 104) == std::vector<unsigned int> { 7 });
+}
+
+TEST_CASE("ProcessIntervals: Matches a linear scan")
+{
+    DcgmProcessIntervals intervals;
+    std::vector<dcgm_process_interval_t> all;
+
+    /* Many short processes and a few long ones, out of order */
+    for (unsigned int pid = 1; pid <= 2000; pid++)
+    {
+        timelib64_t startUsec = (pid * 7919) % 100000;
+        timelib64_t endUsec   = startUsec + ((pid % 50) == 0 ? 50000 : (pid % 13) * 10);
+        if (pid % 333 == 0)
+            endUsec = 0;
+        intervals.Set(pid, startUsec, endUsec);
+        all.push_back({ pid, startUsec, endUsec });
+    }
+
+    for (timelib64_t windowStart = 0; windowStart < 100000; windowStart += 9973)
+    {
+        timelib64_t windowEnd = windowStart + 500;
+
+        std::vector<dcgm_process_interval_t> expected;
+        for (dcgm_process_interval_t const &interval : all)
+        {
+            if (interval.startUsec <= windowEnd && (interval.endUsec == 0 || interval.endUsec >= windowStart))
+                expected.push_back(interval);
+        }
+        std::sort(expected.begin(), expected.end(), [](auto const &a, auto const &b) {
+            return a.startUsec < b.startUsec || (a.startUsec == b.startUsec && a.pid < b.pid);
+        });
+
+        std::vector<dcgm_process_interval_t> found;
+        intervals.Query(windowStart, windowEnd, found);
+        REQUIRE(found.size() == expected.size());
+        for (size_t i = 0; i < found.size(); i++)
+        {
+            CHECK(found[i].pid == expected[i].pid);
+        }
+    }
+
+    /* Trimming keeps the ones that ended later and the running ones */
+    intervals.Trim(90000);
+    CHECK(intervals.Size() < all.size());
+    std::vector<dcgm_process_interval_t> found;
+    intervals.Query(0, 0, found);
+    CHECK(found.size() == intervals.Size());
+    for (dcgm_process_interval_t const &interval : found)
+    {
+        CHECK((interval.endUsec == 0 || interval.endUsec >= 90000));
+    }
+    CHECK(QueryPids(intervals, 95000, 95100).size() > 0);
+}
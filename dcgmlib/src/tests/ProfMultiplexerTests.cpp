@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmProfMultiplexer.h>
+#include <dcgm_fields.h>
+#include <dcgm_profiling_structs.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+void AddMetricGroup(dcgmProfGetMetricGroups_t &metricGroups,
+                    unsigned short majorId,
+                    unsigned short minorId,
+                    std::vector<unsigned short> const &fieldIds)
+{
+    dcgmProfMetricGroupInfo_t &mg = metricGroups.metricGroups[metricGroups.numMetricGroups++];
+    mg.majorId                    = majorId;
+    mg.minorId                    = minorId;
+    mg.numFieldIds                = fieldIds.size();
+    std::copy(fieldIds.begin(), fieldIds.end(), mg.fieldIds);
+}
+
+/* Like the metric groups of a GPU whose DRAM, PCIe and NVLink counters can't be collected together */
+dcgmProfGetMetricGroups_t MakeMetricGroups()
+{
+    dcgmProfGetMetricGroups_t metricGroups {};
+    AddMetricGroup(metricGroups, 0, 0, { DCGM_FI_PROF_GR_ENGINE_ACTIVE, DCGM_FI_PROF_SM_ACTIVE });
+    AddMetricGroup(metricGroups, 1, 0, { DCGM_FI_PROF_DRAM_ACTIVE });
+    AddMetricGroup(metricGroups, 1, 1, { DCGM_FI_PROF_PCIE_TX_BYTES, DCGM_FI_PROF_PCIE_RX_BYTES });
+    AddMetricGroup(metricGroups, 1, 2, { DCGM_FI_PROF_NVLINK_TX_BYTES, DCGM_FI_PROF_NVLINK_RX_BYTES });
+    return metricGroups;
+}
+
+dcgmProfWatchFields_t MakeWatch(std::vector<unsigned short> const &fieldIds, unsigned int flags)
+{
+    dcgmProfWatchFields_t watchFields {};
+    watchFields.version     = dcgmProfWatchFields_version;
+    watchFields.numFieldIds = fieldIds.size();
+    std::copy(fieldIds.begin(), fieldIds.end(), watchFields.fieldIds);
+    watchFields.updateFreq = 3600000000LL; /* Tests rotate by hand */
+    watchFields.flags      = flags;
+    return watchFields;
+}
+
+/* Plays the profiling module. Remembers the fields of the latest watch */
+struct FakeProfilingModule
+{
+    std::vector<unsigned short> watched;
+    unsigned int watchedFlags = 0;
+    unsigned int numUnwatches = 0;
+
+    dcgmReturn_t Process(dcgm_module_command_header_t *moduleCommand)
+    {
+        switch (moduleCommand->subCommand)
+        {
+            case DCGM_PROFILING_SR_GET_MGS:
+                ((dcgm_profiling_msg_get_mgs_t *)moduleCommand)->metricGroups = MakeMetricGroups();
+                return DCGM_ST_OK;
+
+            case DCGM_PROFILING_SR_WATCH_FIELDS:
+            {
+                auto const &watchFields = ((dcgm_profiling_msg_watch_fields_t *)moduleCommand)->watchFields;
+                if ((watchFields.flags & ~DCGM_PROF_WATCH_FLAG_BUFFERED) != 0)
+                {
+                    return DCGM_ST_BADPARAM;
+                }
+                watched.assign(watchFields.fieldIds, watchFields.fieldIds + watchFields.numFieldIds);
+                watchedFlags = watchFields.flags;
+                return DCGM_ST_OK;
+            }
+
+            case DCGM_PROFILING_SR_UNWATCH_FIELDS:
+                numUnwatches++;
+                watched.clear();
+                return DCGM_ST_OK;
+
+            default:
+                return DCGM_ST_FUNCTION_NOT_FOUND;
+        }
+    }
+};
+
+bool Intercept(DcgmProfMultiplexer &multiplexer, dcgm_profiling_msg_watch_fields_t &msg, dcgmReturn_t &dcgmReturn)
+{
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdProfiling;
+    msg.header.subCommand = DCGM_PROFILING_SR_WATCH_FIELDS;
+    msg.header.version    = dcgm_profiling_msg_watch_fields_version;
+    return multiplexer.InterceptCommand(&msg.header, dcgmReturn);
+}
+} // namespace
+
+TEST_CASE("ProfMultiplexer: planning slots")
+{
+    dcgmProfGetMetricGroups_t metricGroups = MakeMetricGroups();
+    std::vector<DcgmProfMultiplexSlot> slots;
+
+    SECTION("Fields of different majorIds share a slot")
+    {
+        auto watchFields = MakeWatch({ DCGM_FI_PROF_SM_ACTIVE, DCGM_FI_PROF_DRAM_ACTIVE }, 0);
+        REQUIRE(DcgmProfMultiplexer::PlanSlots(metricGroups, watchFields, slots) == DCGM_ST_OK);
+        REQUIRE(slots.size() == 1);
+        CHECK(slots[0] == DcgmProfMultiplexSlot { DCGM_FI_PROF_SM_ACTIVE, DCGM_FI_PROF_DRAM_ACTIVE });
+    }
+
+    SECTION("Metric groups of the same majorId get a slot each")
+    {
+        auto watchFields = MakeWatch({ DCGM_FI_PROF_GR_ENGINE_ACTIVE,
+                                       DCGM_FI_PROF_DRAM_ACTIVE,
+                                       DCGM_FI_PROF_PCIE_TX_BYTES,
+                                       DCGM_FI_PROF_NVLINK_RX_BYTES,
+                                       DCGM_FI_PROF_PCIE_RX_BYTES },
+                                     DCGM_PROF_WATCH_FLAG_MULTIPLEX);
+        REQUIRE(DcgmProfMultiplexer::PlanSlots(metricGroups, watchFields, slots) == DCGM_ST_OK);
+        REQUIRE(slots.size() == 3);
+        CHECK(slots[0] == DcgmProfMultiplexSlot { DCGM_FI_PROF_GR_ENGINE_ACTIVE, DCGM_FI_PROF_DRAM_ACTIVE });
+        CHECK(slots[1]
+              == DcgmProfMultiplexSlot {
+                  DCGM_FI_PROF_GR_ENGINE_ACTIVE, DCGM_FI_PROF_PCIE_TX_BYTES, DCGM_FI_PROF_PCIE_RX_BYTES });
+        CHECK(slots[2] == DcgmProfMultiplexSlot { DCGM_FI_PROF_GR_ENGINE_ACTIVE, DCGM_FI_PROF_NVLINK_RX_BYTES });
+
+        CHECK(DcgmProfMultiplexer::Coverage(slots, DCGM_FI_PROF_GR_ENGINE_ACTIVE) == 1.0);
+        CHECK(DcgmProfMultiplexer::Coverage(slots, DCGM_FI_PROF_PCIE_RX_BYTES) == Approx(1.0 / 3.0));
+        CHECK(DcgmProfMultiplexer::Coverage(slots, DCGM_FI_PROF_SM_OCCUPANCY) == 0.0);
+    }
+
+    SECTION("Fields that aren't in any metric group")
+    {
+        auto watchFields = MakeWatch({ DCGM_FI_PROF_SM_ACTIVE, DCGM_FI_PROF_PIPE_FP64_ACTIVE }, 0);
+        CHECK(DcgmProfMultiplexer::PlanSlots(metricGroups, watchFields, slots) == DCGM_ST_PROFILING_NOT_SUPPORTED);
+    }
+}
+
+TEST_CASE("ProfMultiplexer: rotating watches")
+{
+    FakeProfilingModule module;
+    DcgmProfMultiplexer multiplexer(
+        [&module](dcgm_module_command_header_t *moduleCommand) { return module.Process(moduleCommand); });
+
+    dcgm_profiling_msg_watch_fields_t msg {};
+    dcgmReturn_t dcgmReturn = DCGM_ST_GENERIC_ERROR;
+
+    /* Watches without the flag are left to the profiling module */
+    msg.watchFields = MakeWatch({ DCGM_FI_PROF_SM_ACTIVE }, 0);
+    CHECK(!Intercept(multiplexer, msg, dcgmReturn));
+
+    msg.watchFields = MakeWatch({ DCGM_FI_PROF_SM_ACTIVE, DCGM_FI_PROF_DRAM_ACTIVE, DCGM_FI_PROF_PCIE_TX_BYTES },
+                                DCGM_PROF_WATCH_FLAG_MULTIPLEX);
+    REQUIRE(Intercept(multiplexer, msg, dcgmReturn));
+    REQUIRE(dcgmReturn == DCGM_ST_OK);
+    CHECK(multiplexer.IsMultiplexing());
+    CHECK(module.watched == std::vector<unsigned short> { DCGM_FI_PROF_SM_ACTIVE, DCGM_FI_PROF_DRAM_ACTIVE });
+
+    multiplexer.RotateOnce();
+    CHECK(multiplexer.GetActiveSlot() == 1);
+    CHECK(module.watched == std::vector<unsigned short> { DCGM_FI_PROF_SM_ACTIVE, DCGM_FI_PROF_PCIE_TX_BYTES });
+
+    /* Pausing profiling on all GPUs holds the rotation */
+    dcgm_profiling_msg_pause_resume_t pauseMsg {};
+    pauseMsg.header.subCommand = DCGM_PROFILING_SR_PAUSE_RESUME;
+    pauseMsg.header.version    = dcgm_profiling_msg_pause_resume_version;
+    pauseMsg.pause             = true;
+    CHECK(!multiplexer.InterceptCommand(&pauseMsg.header, dcgmReturn));
+    multiplexer.RotateOnce();
+    CHECK(multiplexer.GetActiveSlot() == 1);
+
+    pauseMsg.pause = false;
+    CHECK(!multiplexer.InterceptCommand(&pauseMsg.header, dcgmReturn));
+    multiplexer.RotateOnce();
+    CHECK(multiplexer.GetActiveSlot() == 0);
+    CHECK(module.watched == std::vector<unsigned short> { DCGM_FI_PROF_SM_ACTIVE, DCGM_FI_PROF_DRAM_ACTIVE });
+
+    /* An unwatch ends the rotation */
+    dcgm_profiling_msg_unwatch_fields_t unwatchMsg {};
+    unwatchMsg.header.subCommand = DCGM_PROFILING_SR_UNWATCH_FIELDS;
+    CHECK(!multiplexer.InterceptCommand(&unwatchMsg.header, dcgmReturn));
+    CHECK(!multiplexer.IsMultiplexing());
+
+    unsigned int numUnwatches = module.numUnwatches;
+    multiplexer.RotateOnce();
+    CHECK(module.numUnwatches == numUnwatches);
+}
+
+TEST_CASE("ProfMultiplexer: buffered watches")
+{
+    FakeProfilingModule module;
+    DcgmProfMultiplexer multiplexer(
+        [&module](dcgm_module_command_header_t *moduleCommand) { return module.Process(moduleCommand); });
+
+    dcgm_profiling_msg_watch_fields_t msg {};
+    dcgmReturn_t dcgmReturn = DCGM_ST_GENERIC_ERROR;
+
+    /* Buffering alone is up to the profiling module */
+    msg.watchFields = MakeWatch({ DCGM_FI_PROF_SM_ACTIVE }, DCGM_PROF_WATCH_FLAG_BUFFERED);
+    CHECK(!Intercept(multiplexer, msg, dcgmReturn));
+
+    /* Each slot of a rotation is buffered */
+    msg.watchFields = MakeWatch({ DCGM_FI_PROF_SM_ACTIVE, DCGM_FI_PROF_DRAM_ACTIVE, DCGM_FI_PROF_PCIE_TX_BYTES },
+                                DCGM_PROF_WATCH_FLAG_MULTIPLEX | DCGM_PROF_WATCH_FLAG_BUFFERED);
+    REQUIRE(Intercept(multiplexer, msg, dcgmReturn));
+    REQUIRE(dcgmReturn == DCGM_ST_OK);
+    CHECK(module.watchedFlags == DCGM_PROF_WATCH_FLAG_BUFFERED);
+
+    multiplexer.RotateOnce();
+    CHECK(multiplexer.GetActiveSlot() == 1);
+    CHECK(module.watchedFlags == DCGM_PROF_WATCH_FLAG_BUFFERED);
+}
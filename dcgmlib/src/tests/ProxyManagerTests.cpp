@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmProxyManager.h>
+#include <dcgm_fields.h>
+
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace
+{
+struct SentSection
+{
+    dcgm_msg_proxy_fv_section_t header;
+    std::vector<dcgmBufferedFv_t> values;
+};
+
+struct SentBatch
+{
+    dcgm_connection_id_t connectionId;
+    dcgm_request_id_t requestId;
+    std::vector<SentSection> sections;
+};
+
+/* Records what the manager sends instead of sending it */
+class FakeClients
+{
+public:
+    DcgmProxyManager::SendFn GetSendFn()
+    {
+        return [this](dcgm_connection_id_t connectionId,
+                      unsigned int msgType,
+                      dcgm_request_id_t requestId,
+                      void *msgData,
+                      int msgLength,
+                      dcgmReturn_t /* status */) {
+            REQUIRE(msgType == DCGM_MSG_PROXY_FV_BATCH);
+            REQUIRE((size_t)msgLength >= sizeof(dcgm_msg_proxy_fv_batch_t));
+
+            dcgm_msg_proxy_fv_batch_t header;
+            memcpy(&header, msgData, sizeof(header));
+            REQUIRE(header.version == dcgm_msg_proxy_fv_batch_version);
+
+            SentBatch batch;
+            batch.connectionId = connectionId;
+            batch.requestId    = requestId;
+
+            char const *bytes = (char const *)msgData;
+            size_t offset     = sizeof(header);
+            for (unsigned int i = 0; i < header.numSections; i++)
+            {
+                SentSection section;
+                memcpy(&section.header, bytes + offset, sizeof(section.header));
+                offset += sizeof(section.header);
+
+                for (size_t end = offset + section.header.bufferSize; offset < end;)
+                {
+                    /* Entries are truncated to their value */
+                    dcgmBufferedFv_t fv {};
+                    memcpy(&fv, bytes + offset, sizeof(fv.length));
+                    memcpy(&fv, bytes + offset, fv.length);
+                    section.values.push_back(fv);
+                    offset += fv.length;
+                }
+                REQUIRE(section.values.size() == section.header.numValues);
+                batch.sections.push_back(section);
+            }
+            REQUIRE(offset == (size_t)msgLength);
+
+            batches.push_back(batch);
+            return DCGM_ST_OK;
+        };
+    }
+
+    std::vector<SentBatch> batches;
+};
+
+struct FakeSubscription
+{
+    std::string name;
+    dcgmFieldValueEntityEnumeration_f callback;
+    void *userData;
+};
+
+/* Host engines that are reachable or not as the test says */
+class FakeHosts : public DcgmProxyDownstream
+{
+public:
+    dcgmReturn_t Connect(std::string const &address, dcgmHandle_t *handle) override
+    {
+        connectAttempts[address]++;
+        if (unreachable.count(address))
+            return DCGM_ST_CONNECTION_NOT_VALID;
+
+        *handle          = ++lastHandle;
+        handles[address] = *handle;
+        return DCGM_ST_OK;
+    }
+
+    void Disconnect(dcgmHandle_t handle) override
+    {
+        subscriptions.erase(handle);
+    }
+
+    dcgmReturn_t CheckHealth(dcgmHandle_t handle) override
+    {
+        return unhealthy.count(handle) ? DCGM_ST_CONNECTION_NOT_VALID : DCGM_ST_OK;
+    }
+
+    dcgmReturn_t Subscribe(dcgmHandle_t handle,
+                           std::string const &name,
+                           DcgmProxyStreamSpec_t const & /* spec */,
+                           dcgmFieldValueEntityEnumeration_f callback,
+                           void *userData,
+                           DcgmProxySubscription_t &subscription) override
+    {
+        subscription.fieldGroupId = (dcgmFieldGrp_t)1;
+        subscription.streamId     = ++lastStreamId;
+        subscriptions[handle][subscription.streamId] = { name, callback, userData };
+        return DCGM_ST_OK;
+    }
+
+    void Unsubscribe(dcgmHandle_t handle, DcgmProxySubscription_t const &subscription) override
+    {
+        subscriptions[handle].erase(subscription.streamId);
+    }
+
+    /* Push count int64 values of GPU 0 from the only subscription of address */
+    void PushValues(std::string const &address, int count, long long firstValue = 0)
+    {
+        auto &handleSubscriptions = subscriptions[handles[address]];
+        REQUIRE(handleSubscriptions.size() == 1);
+        FakeSubscription const &subscription = handleSubscriptions.begin()->second;
+
+        std::vector<dcgmFieldValue_v1> values(count);
+        for (int i = 0; i < count; i++)
+        {
+            values[i].version   = dcgmFieldValue_version1;
+            values[i].fieldId   = DCGM_FI_DEV_GPU_TEMP;
+            values[i].fieldType = DCGM_FT_INT64;
+            values[i].status    = DCGM_ST_OK;
+            values[i].ts        = 1000 + i;
+            values[i].value.i64 = firstValue + i;
+        }
+        subscription.callback(DCGM_FE_GPU, 0, values.data(), count, subscription.userData);
+    }
+
+    std::set<std::string> unreachable;
+    std::set<dcgmHandle_t> unhealthy;
+    std::map<std::string, int> connectAttempts;
+    std::map<std::string, dcgmHandle_t> handles; /* Latest handle of each address */
+    std::map<dcgmHandle_t, std::map<unsigned int, FakeSubscription>> subscriptions;
+
+private:
+    uintptr_t lastHandle      = 0;
+    unsigned int lastStreamId = 0;
+};
+
+DcgmProxyStreamSpec_t TempSpec()
+{
+    DcgmProxyStreamSpec_t spec {};
+    spec.groupId    = (dcgmGpuGrp_t)DCGM_GROUP_ALL_GPUS;
+    spec.fieldIds   = { DCGM_FI_DEV_GPU_TEMP };
+    spec.updateFreq = 1000000;
+    return spec;
+}
+} // namespace
+
+TEST_CASE("ProxyManager: parses host lists")
+{
+    auto addresses = DcgmProxyManager::ParseHosts(" 10.0.0.1, 10.0.0.2:5555,,unix:/tmp/he.sock ,");
+    REQUIRE(addresses.size() == 3);
+    CHECK(addresses[0] == "10.0.0.1");
+    CHECK(addresses[1] == "10.0.0.2:5555");
+    CHECK(addresses[2] == "unix:/tmp/he.sock");
+
+    CHECK(DcgmProxyManager::ParseHosts("").empty());
+}
+
+TEST_CASE("ProxyManager: merges the values of every host into host-tagged batches")
+{
+    FakeClients clients;
+    auto fakeHosts = std::make_unique<FakeHosts>();
+    FakeHosts &hosts = *fakeHosts;
+    DcgmProxyManager manager({ "a", "b" }, clients.GetSendFn(), std::move(fakeHosts));
+
+    REQUIRE(manager.AddStream(1, 10, TempSpec(), 1, 4) == DCGM_ST_OK);
+    CHECK(manager.AddStream(1, 10, TempSpec(), 0, 0) == DCGM_ST_IN_USE);
+
+    manager.RunOnce(1000000);
+    REQUIRE(hosts.subscriptions[hosts.handles["a"]].size() == 1);
+    REQUIRE(hosts.subscriptions[hosts.handles["b"]].size() == 1);
+    CHECK(clients.batches.empty());
+
+    hosts.PushValues("b", 2, 20);
+    hosts.PushValues("a", 1, 10);
+    manager.RunOnce(1100000);
+
+    REQUIRE(clients.batches.size() == 1);
+    CHECK(clients.batches[0].connectionId == 1);
+    CHECK(clients.batches[0].requestId == 10);
+    REQUIRE(clients.batches[0].sections.size() == 2);
+    CHECK(clients.batches[0].sections[0].header.hostId == 0);
+    CHECK(clients.batches[0].sections[0].values[0].value.i64 == 10);
+    CHECK(clients.batches[0].sections[1].header.hostId == 1);
+    CHECK(clients.batches[0].sections[1].values[1].value.i64 == 21);
+
+    /* The window of 1 batch is full. 4 values of a are held and 2 dropped */
+    hosts.PushValues("a", 6, 30);
+    manager.RunOnce(1200000);
+    REQUIRE(clients.batches.size() == 1);
+
+    manager.OnAck(1, 10, 1);
+    manager.RunOnce(1300000);
+    REQUIRE(clients.batches.size() == 2);
+    REQUIRE(clients.batches[1].sections.size() == 1);
+    CHECK(clients.batches[1].sections[0].header.numValues == 4);
+    CHECK(clients.batches[1].sections[0].header.numDropped == 2);
+
+    dcgmProxyHosts_v1 status {};
+    manager.GetHosts(status);
+    REQUIRE(status.numHosts == 2);
+    CHECK(std::string(status.hosts[0].address) == "a");
+    CHECK(status.hosts[0].connected == 1);
+    CHECK(status.hosts[0].valuesForwarded == 5);
+    CHECK(status.hosts[0].valuesDropped == 2);
+    CHECK(status.hosts[1].valuesForwarded == 2);
+
+    /* Removed streams are unsubscribed from the hosts and send nothing more */
+    hosts.PushValues("b", 1);
+    REQUIRE(manager.RemoveStream(1, 10) == DCGM_ST_OK);
+    CHECK(manager.RemoveStream(1, 10) == DCGM_ST_NO_DATA);
+    manager.OnAck(1, 10, 1);
+    manager.RunOnce(1400000);
+    CHECK(clients.batches.size() == 2);
+    CHECK(hosts.subscriptions[hosts.handles["a"]].empty());
+    CHECK(hosts.subscriptions[hosts.handles["b"]].empty());
+}
+
+TEST_CASE("ProxyManager: reconnects with backoff and subscribes again")
+{
+    CHECK(DcgmProxyManager::BackoffUsec(1) == DcgmProxyManager::MIN_RECONNECT_USEC);
+    CHECK(DcgmProxyManager::BackoffUsec(2) == 2 * DcgmProxyManager::MIN_RECONNECT_USEC);
+    CHECK(DcgmProxyManager::BackoffUsec(100) == DcgmProxyManager::MAX_RECONNECT_USEC);
+
+    FakeClients clients;
+    auto fakeHosts = std::make_unique<FakeHosts>();
+    FakeHosts &hosts = *fakeHosts;
+    DcgmProxyManager manager({ "a" }, clients.GetSendFn(), std::move(fakeHosts));
+
+    REQUIRE(manager.AddStream(1, 10, TempSpec(), 0, 0) == DCGM_ST_OK);
+
+    timelib64_t now = 1000000;
+    hosts.unreachable.insert("a");
+    manager.RunOnce(now);
+    CHECK(hosts.connectAttempts["a"] == 1);
+
+    dcgmProxyHosts_v1 status {};
+    manager.GetHosts(status);
+    CHECK(status.hosts[0].connected == 0);
+    CHECK(status.hosts[0].lastStatus == DCGM_ST_CONNECTION_NOT_VALID);
+    CHECK(status.hosts[0].nextConnectTime >= now + DcgmProxyManager::MIN_RECONNECT_USEC / 2);
+    CHECK(status.hosts[0].nextConnectTime <= now + DcgmProxyManager::MIN_RECONNECT_USEC);
+
+    /* Not retried before the backoff is up */
+    manager.RunOnce(now + DcgmProxyManager::MIN_RECONNECT_USEC / 4);
+    CHECK(hosts.connectAttempts["a"] == 1);
+
+    hosts.unreachable.clear();
+    now += DcgmProxyManager::MIN_RECONNECT_USEC;
+    manager.RunOnce(now);
+    CHECK(hosts.connectAttempts["a"] == 2);
+    dcgmHandle_t firstHandle = hosts.handles["a"];
+    REQUIRE(hosts.subscriptions[firstHandle].size() == 1);
+    CHECK(hosts.subscriptions[firstHandle].begin()->second.name == "dcgm_proxy_1_10");
+
+    /* A failed health check drops the connection */
+    hosts.unhealthy.insert(firstHandle);
+    now += DcgmProxyManager::HEALTH_CHECK_USEC;
+    manager.RunOnce(now);
+    CHECK(hosts.subscriptions.count(firstHandle) == 0);
+    manager.GetHosts(status);
+    CHECK(status.hosts[0].connected == 0);
+
+    now += DcgmProxyManager::MIN_RECONNECT_USEC;
+    manager.RunOnce(now);
+    dcgmHandle_t secondHandle = hosts.handles["a"];
+    CHECK(secondHandle != firstHandle);
+    CHECK(hosts.subscriptions[secondHandle].size() == 1);
+
+    manager.GetHosts(status);
+    CHECK(status.hosts[0].connected == 1);
+    CHECK(status.hosts[0].numConnects == 2);
+
+    hosts.PushValues("a", 3);
+    manager.RunOnce(now + 1);
+    REQUIRE(clients.batches.size() == 1);
+    CHECK(clients.batches[0].sections[0].header.numValues == 3);
+
+    /* Streams of connections that went away are dropped too */
+    manager.OnConnectionRemove(1);
+    CHECK(manager.GetStreamCount() == 0);
+    manager.RunOnce(now + 2);
+    CHECK(hosts.subscriptions[secondHandle].empty());
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmQuantileSketch.h>
+#include <dcgm_structs.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+/* Exact quantile with the same rank rule as DcgmQuantileSketch::Quantile() */
+double ExactQuantile(std::vector<double> values, double q)
+{
+    std::sort(values.begin(), values.end());
+    size_t rank = (size_t)std::floor(q * (double)(values.size() - 1));
+    return values[rank];
+}
+} // namespace
+
+TEST_CASE("QuantileSketch: empty")
+{
+    DcgmQuantileSketch sketch;
+
+    CHECK(sketch.Count() == 0);
+    CHECK(sketch.Quantile(0.5) == DCGM_FP64_BLANK);
+
+    sketch.Add(NAN);
+    CHECK(sketch.Count() == 0);
+}
+
+TEST_CASE("QuantileSketch: relative accuracy")
+{
+    std::mt19937 gen(1234);
+    std::lognormal_distribution<double> dist(5.0, 2.0);
+    std::vector<double> values;
+    DcgmQuantileSketch sketch;
+
+    for (int i = 0; i < 100000; i++)
+    {
+        double value = dist(gen);
+        if (i % 10 == 0)
+            value = -value;
+        else if (i % 10 == 1)
+            value = 0.0;
+        values.push_back(value);
+        sketch.Add(value);
+    }
+
+    CHECK(sketch.Count() == (long long)values.size());
+    CHECK(sketch.Quantile(0.0) == *std::min_element(values.begin(), values.end()));
+    CHECK(sketch.Quantile(1.0) == *std::max_element(values.begin(), values.end()));
+
+    for (double q : { 0.01, 0.05, 0.1, 0.15, 0.25, 0.5, 0.9, 0.95, 0.99, 0.999 })
+    {
+        double exact = ExactQuantile(values, q);
+        CHECK(std::abs(sketch.Quantile(q) - exact) <= std::abs(exact) * sketch.RelativeAccuracy() + 1e-9);
+    }
+}
+
+TEST_CASE("QuantileSketch: merge")
+{
+    DcgmQuantileSketch low;
+    DcgmQuantileSketch high;
+    DcgmQuantileSketch all;
+
+    for (int i = 1; i <= 1000; i++)
+    {
+        (i <= 500 ? low : high).Add(i);
+        all.Add(i);
+    }
+
+    REQUIRE(low.Merge(high));
+    CHECK(low.Count() == all.Count());
+    CHECK(low.NumBins() == all.NumBins());
+    for (double q : { 0.0, 0.25, 0.5, 0.95, 0.99, 1.0 })
+    {
+        CHECK(low.Quantile(q) == all.Quantile(q));
+    }
+
+    /* Bins of different accuracies don't line up */
+    DcgmQuantileSketch coarse(0.05);
+    coarse.Add(1.0);
+    CHECK(!low.Merge(coarse));
+    CHECK(low.Count() == all.Count());
+}
+
+TEST_CASE("QuantileSketch: bin cap")
+{
+    DcgmQuantileSketch sketch(0.01, 64);
+    std::vector<double> values;
+
+    /* Spans far more than 64 bins */
+    for (int i = 0; i < 1000; i++)
+    {
+        values.push_back(std::pow(1.1, i % 200));
+        sketch.Add(values.back());
+    }
+
+    CHECK(sketch.NumBins() <= 64);
+    CHECK(sketch.Count() == 1000);
+
+    /* Only the low end is folded */
+    CHECK(sketch.Quantile(0.99) == Approx(ExactQuantile(values, 0.99)).epsilon(0.01));
+    CHECK(sketch.Quantile(1.0) == std::pow(1.1, 199));
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmRequestStats.h>
+
+#include <memory>
+
+TEST_CASE("RequestStats: latency buckets")
+{
+    CHECK(DcgmRequestStats::GetLatencyBucket(0) == 0);
+    CHECK(DcgmRequestStats::GetLatencyBucket(1) == 1);
+    CHECK(DcgmRequestStats::GetLatencyBucket(2) == 2);
+    CHECK(DcgmRequestStats::GetLatencyBucket(3) == 2);
+    CHECK(DcgmRequestStats::GetLatencyBucket(4) == 3);
+    CHECK(DcgmRequestStats::GetLatencyBucket(1000) == 10);
+    CHECK(DcgmRequestStats::GetLatencyBucket(~0ULL) == DCGM_INTROSPECT_LATENCY_BUCKETS - 1);
+}
+
+TEST_CASE("RequestStats: totals and per connection")
+{
+    DcgmRequestStats requestStats;
+    auto out = std::make_unique<dcgmIntrospectRequestStats_t>();
+
+    requestStats.Record(1, DcgmModuleIdCore, 5, DCGM_ST_OK, 10, 100, 64);
+    requestStats.Record(1, DcgmModuleIdCore, 5, DCGM_ST_BADPARAM, 30, 300, 16);
+    requestStats.Record(2, DcgmModuleIdCore, 5, DCGM_ST_OK, 20, 200, 32);
+    requestStats.Record(2, DCGM_INTROSPECT_REQUEST_PROTOBUF, 7, DCGM_ST_OK, 0, 50, 8);
+
+    requestStats.GetStats(*out);
+    REQUIRE(out->numEntries == 2);
+    CHECK(out->moreEntries == 0);
+
+    /* Busiest first */
+    auto const &core = out->entries[0];
+    CHECK(core.moduleId == DcgmModuleIdCore);
+    CHECK(core.command == 5);
+    CHECK(core.connectionId == 0);
+    CHECK(core.count == 3);
+    CHECK(core.errorCount == 1);
+    CHECK(core.totalQueueWaitUsec == 60);
+    CHECK(core.maxQueueWaitUsec == 30);
+    CHECK(core.totalProcessUsec == 600);
+    CHECK(core.maxProcessUsec == 300);
+    CHECK(core.totalReplyBytes == 112);
+    CHECK(core.maxReplyBytes == 64);
+    CHECK(core.processHistogram[DcgmRequestStats::GetLatencyBucket(100)] == 1);
+    CHECK(core.processHistogram[DcgmRequestStats::GetLatencyBucket(200)] == 1);
+    CHECK(core.processHistogram[DcgmRequestStats::GetLatencyBucket(300)] == 1);
+    CHECK(core.processHistogram[DcgmRequestStats::GetLatencyBucket(310)] == 1); /* 256 to 511 share a bucket */
+
+    CHECK(out->entries[1].moduleId == DCGM_INTROSPECT_REQUEST_PROTOBUF);
+    CHECK(out->entries[1].queueWaitHistogram[0] == 1);
+
+    out->flags = DCGM_INTROSPECT_REQUEST_STATS_PER_CONNECTION;
+    requestStats.GetStats(*out);
+    REQUIRE(out->numEntries == 3);
+    CHECK(out->entries[0].connectionId == 1);
+    CHECK(out->entries[0].count == 2);
+
+    /* Closed connections only drop out of the per connection view */
+    requestStats.OnConnectionRemove(1);
+    requestStats.GetStats(*out);
+    REQUIRE(out->numEntries == 2);
+    CHECK(out->entries[0].connectionId == 2);
+    CHECK(out->entries[1].connectionId == 2);
+
+    out->flags = 0;
+    requestStats.GetStats(*out);
+    REQUIRE(out->numEntries == 2);
+    CHECK(out->entries[0].count == 3);
+}
+
+TEST_CASE("RequestStats: caps the number of entries")
+{
+    DcgmRequestStats requestStats;
+    auto out = std::make_unique<dcgmIntrospectRequestStats_t>();
+
+    for (unsigned int command = 0; command < DCGM_INTROSPECT_MAX_REQUEST_TYPES + 10; command++)
+    {
+        requestStats.Record(DCGM_CONNECTION_ID_NONE, DcgmModuleIdCore, command, DCGM_ST_OK, 0, 0, 0);
+    }
+    requestStats.Record(DCGM_CONNECTION_ID_NONE, DcgmModuleIdCore, 137, DCGM_ST_OK, 0, 0, 0);
+
+    requestStats.GetStats(*out);
+    CHECK(out->numEntries == DCGM_INTROSPECT_MAX_REQUEST_TYPES);
+    CHECK(out->moreEntries == 1);
+    CHECK(out->entries[0].command == 137);
+
+    /* Requests without a connection only count towards the totals */
+    out->flags = DCGM_INTROSPECT_REQUEST_STATS_PER_CONNECTION;
+    requestStats.GetStats(*out);
+    CHECK(out->numEntries == 0);
+    CHECK(out->moreEntries == 0);
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmStateCheckpoint.h>
+
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
+namespace
+{
+std::string TempFilename()
+{
+    char filename[] = "/tmp/dcgmStateCheckpointXXXXXX";
+    int fd          = mkstemp(filename);
+    REQUIRE(fd >= 0);
+    close(fd);
+    return filename;
+}
+} // namespace
+
+TEST_CASE("StateCheckpoint: write and read")
+{
+    std::string filename = TempFilename();
+
+    DcgmStateCheckpoint saved;
+    saved.savedUsec = 1234567;
+    saved.gpuUuids  = { "GPU-aaaa", "", "GPU-cccc" };
+
+    DcgmCheckpointPolicy policy;
+    policy.gpuId                       = 2;
+    policy.policy.version              = dcgmPolicy_version;
+    policy.policy.condition            = DCGM_POLICY_COND_DBE;
+    policy.policy.mode                 = DCGM_POLICY_MODE_MANUAL;
+    policy.policy.parms[0].tag         = dcgmPolicyConditionParams_t::BOOL;
+    policy.policy.parms[0].val.boolean = 1;
+    policy.policy.parms[2].tag         = dcgmPolicyConditionParams_t::LLONG;
+    policy.policy.parms[2].val.llval   = 0x123456789ULL;
+    saved.policies.push_back(policy);
+
+    DcgmCheckpointSession session;
+    session.token = 0xfedcba9876543210ULL;
+
+    DcgmCheckpointGroup group;
+    group.groupId       = 5;
+    group.name          = "two words\nand a newline";
+    group.healthSystems = DCGM_HEALTH_WATCH_PCIE;
+    group.entities.push_back({ DCGM_FE_GPU, 0 });
+    group.entities.push_back({ DCGM_FE_SWITCH, 7 });
+    session.groups.push_back(group);
+
+    DcgmCheckpointGroup emptyGroup;
+    emptyGroup.groupId = 6;
+    session.groups.push_back(emptyGroup);
+
+    DcgmCheckpointFieldGroup fieldGroup;
+    fieldGroup.fieldGroupId = 9;
+    fieldGroup.name         = "temps";
+    fieldGroup.fieldIds     = { DCGM_FI_DEV_GPU_TEMP, DCGM_FI_DEV_MEMORY_TEMP };
+    session.fieldGroups.push_back(fieldGroup);
+
+    DcgmCheckpointWatch watch;
+    watch.watcherType          = DcgmWatcherTypeHealthWatch;
+    watch.entityGroupId        = DCGM_FE_GPU;
+    watch.entityId             = 2;
+    watch.fieldId              = DCGM_FI_DEV_GPU_TEMP;
+    watch.monitorFrequencyUsec = 1000000;
+    watch.maxAgeUsec           = 60000000;
+    watch.isSubscribed         = true;
+    session.watches.push_back(watch);
+
+    saved.sessions.push_back(session);
+
+    DcgmCheckpointSession emptySession {};
+    emptySession.token = 42;
+    saved.sessions.push_back(emptySession);
+
+    REQUIRE(DcgmWriteStateCheckpoint(filename, saved) == DCGM_ST_OK);
+
+    DcgmStateCheckpoint loaded;
+    REQUIRE(DcgmReadStateCheckpoint(filename, loaded) == DCGM_ST_OK);
+    unlink(filename.c_str());
+
+    CHECK(loaded.savedUsec == saved.savedUsec);
+    CHECK(loaded.gpuUuids == saved.gpuUuids);
+
+    REQUIRE(loaded.policies.size() == 1);
+    CHECK(loaded.policies[0].gpuId == 2);
+    dcgmPolicy_t const &p = loaded.policies[0].policy;
+    CHECK(p.version == dcgmPolicy_version);
+    CHECK(p.condition == DCGM_POLICY_COND_DBE);
+    CHECK(p.mode == DCGM_POLICY_MODE_MANUAL);
+    CHECK(p.parms[0].tag == dcgmPolicyConditionParams_t::BOOL);
+    CHECK(p.parms[0].val.boolean == 1);
+    CHECK(p.parms[2].tag == dcgmPolicyConditionParams_t::LLONG);
+    CHECK(p.parms[2].val.llval == 0x123456789ULL);
+
+    REQUIRE(loaded.sessions.size() == 2);
+    CHECK(loaded.sessions[1].token == 42);
+    CHECK(loaded.sessions[1].groups.empty());
+
+    DcgmCheckpointSession const &s = loaded.sessions[0];
+    CHECK(s.token == session.token);
+    REQUIRE(s.groups.size() == 2);
+    CHECK(s.groups[0].groupId == 5);
+    CHECK(s.groups[0].name == group.name);
+    CHECK(s.groups[0].healthSystems == DCGM_HEALTH_WATCH_PCIE);
+    REQUIRE(s.groups[0].entities.size() == 2);
+    CHECK(s.groups[0].entities[1].entityGroupId == DCGM_FE_SWITCH);
+    CHECK(s.groups[0].entities[1].entityId == 7);
+    CHECK(s.groups[1].groupId == 6);
+    CHECK(s.groups[1].name.empty());
+    CHECK(s.groups[1].entities.empty());
+
+    REQUIRE(s.fieldGroups.size() == 1);
+    CHECK(s.fieldGroups[0].fieldGroupId == 9);
+    CHECK(s.fieldGroups[0].name == "temps");
+    CHECK(s.fieldGroups[0].fieldIds == fieldGroup.fieldIds);
+
+    REQUIRE(s.watches.size() == 1);
+    CHECK(s.watches[0].watcherType == DcgmWatcherTypeHealthWatch);
+    CHECK(s.watches[0].entityGroupId == DCGM_FE_GPU);
+    CHECK(s.watches[0].entityId == 2);
+    CHECK(s.watches[0].fieldId == DCGM_FI_DEV_GPU_TEMP);
+    CHECK(s.watches[0].monitorFrequencyUsec == 1000000);
+    CHECK(s.watches[0].maxAgeUsec == 60000000);
+    CHECK(s.watches[0].isSubscribed);
+}
+
+TEST_CASE("StateCheckpoint: missing, malformed and other versions")
+{
+    DcgmStateCheckpoint loaded;
+    CHECK(DcgmReadStateCheckpoint("/tmp/dcgmStateCheckpointThatDoesNotExist", loaded) == DCGM_ST_NO_DATA);
+
+    std::string filename = TempFilename();
+
+    std::ofstream(filename) << "dcgm-state " << DCGM_STATE_CHECKPOINT_VERSION + 1 << " 0\n";
+    CHECK(DcgmReadStateCheckpoint(filename, loaded) == DCGM_ST_VER_MISMATCH);
+
+    std::ofstream(filename) << "something else\n";
+    CHECK(DcgmReadStateCheckpoint(filename, loaded) == DCGM_ST_GENERIC_ERROR);
+
+    /* Groups have to follow a session */
+    std::ofstream(filename) << "dcgm-state " << DCGM_STATE_CHECKPOINT_VERSION << " 0\ngroup 1 0 0 \n";
+    CHECK(DcgmReadStateCheckpoint(filename, loaded) == DCGM_ST_GENERIC_ERROR);
+    CHECK(loaded.sessions.empty());
+
+    /* Policies of other versions are dropped without dropping the rest of the file */
+    std::ofstream(filename) << "dcgm-state " << DCGM_STATE_CHECKPOINT_VERSION << " 0\npolicy 0 "
+                            << dcgmPolicy_version + 1 << " 0 0 0 0 0 0 2 0 1 1 99\nsession 3\n";
+    CHECK(DcgmReadStateCheckpoint(filename, loaded) == DCGM_ST_OK);
+    CHECK(loaded.policies.empty());
+    CHECK(loaded.sessions.size() == 1);
+
+    /* A policy with a parameter of an unknown type */
+    std::ofstream(filename) << "dcgm-state " << DCGM_STATE_CHECKPOINT_VERSION << " 0\npolicy 0 " << dcgmPolicy_version
+                            << " 0 0 0 0 0 0 1 7 0\n";
+    CHECK(DcgmReadStateCheckpoint(filename, loaded) == DCGM_ST_GENERIC_ERROR);
+
+    /* A name longer than what is left */
+    std::ofstream(filename) << "dcgm-state " << DCGM_STATE_CHECKPOINT_VERSION << " 0\nsession 1\ngroup 1 0 99 abc";
+    CHECK(DcgmReadStateCheckpoint(filename, loaded) == DCGM_ST_GENERIC_ERROR);
+
+    unlink(filename.c_str());
+}
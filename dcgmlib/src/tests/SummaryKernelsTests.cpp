@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmCacheManager.h>
+#include <DcgmSummaryKernels.h>
+
+#include <random>
+#include <vector>
+
+using namespace DcgmNs::SummaryKernels;
+
+static Isa const c_allIsas[] = { Isa::Scalar, Isa::Avx2, Isa::Avx512, Isa::Neon };
+
+/* Values in [-1000, 1000] with about one in eight blank */
+template <typename T>
+static std::vector<T> RandomValues(std::mt19937 &rng, int count)
+{
+    std::uniform_int_distribution<int> blankDist(0, 7);
+    std::uniform_int_distribution<int> valueDist(-1000, 1000);
+    std::vector<T> values(count);
+
+    for (auto &value : values)
+    {
+        if (!blankDist(rng))
+            value = DcgmcmSummaryAccumulator<T>::Blank() + blankDist(rng); /* Also the NOT_FOUND... markers */
+        else if constexpr (std::is_integral_v<T>)
+            value = valueDist(rng);
+        else
+            value = valueDist(rng) / 8.0;
+    }
+    return values;
+}
+
+TEST_CASE("SummaryKernels: selection")
+{
+    CHECK(IsSupported(Isa::Scalar));
+    CHECK(IsSupported(SelectedIsa()));
+    CHECK(std::string(IsaName(Isa::Avx512)) == "avx512");
+}
+
+TEST_CASE("SummaryKernels: every ISA matches scalar")
+{
+    std::mt19937 rng(1234);
+
+    for (int count : { 0, 1, 3, 4, 7, 8, 9, 16, 17, 100, 1023 })
+    {
+        auto i64Values = RandomValues<long long>(rng, count);
+        auto fp64Values = RandomValues<double>(rng, count);
+
+        Totals<long long> i64Expected;
+        Totals<double> fp64Expected;
+        Summarize(i64Values.data(), count, i64Expected, Isa::Scalar);
+        Summarize(fp64Values.data(), count, fp64Expected, Isa::Scalar);
+
+        for (Isa isa : c_allIsas)
+        {
+            if (!IsSupported(isa))
+                continue;
+
+            INFO("isa " << IsaName(isa) << " count " << count);
+
+            Totals<long long> i64Totals;
+            Summarize(i64Values.data(), count, i64Totals, isa);
+            CHECK(i64Totals.count == i64Expected.count);
+            CHECK(i64Totals.firstIndex == i64Expected.firstIndex);
+            CHECK(i64Totals.lastIndex == i64Expected.lastIndex);
+            if (i64Expected.count)
+            {
+                CHECK(i64Totals.sum == i64Expected.sum);
+                CHECK(i64Totals.min == i64Expected.min);
+                CHECK(i64Totals.max == i64Expected.max);
+            }
+
+            Totals<double> fp64Totals;
+            Summarize(fp64Values.data(), count, fp64Totals, isa);
+            CHECK(fp64Totals.count == fp64Expected.count);
+            CHECK(fp64Totals.firstIndex == fp64Expected.firstIndex);
+            CHECK(fp64Totals.lastIndex == fp64Expected.lastIndex);
+            if (fp64Expected.count)
+            {
+                CHECK(fp64Totals.sum == Approx(fp64Expected.sum));
+                CHECK(fp64Totals.min == fp64Expected.min);
+                CHECK(fp64Totals.max == fp64Expected.max);
+            }
+        }
+    }
+}
+
+TEST_CASE("SummaryKernels: all blank")
+{
+    std::vector<long long> values(37, DCGM_INT64_BLANK);
+
+    for (Isa isa : c_allIsas)
+    {
+        if (!IsSupported(isa))
+            continue;
+
+        Totals<long long> totals;
+        Summarize(values.data(), (int)values.size(), totals, isa);
+        CHECK(totals.count == 0);
+        CHECK(totals.firstIndex == -1);
+        CHECK(totals.lastIndex == -1);
+    }
+}
+
+TEST_CASE("SummaryKernels: AddBatch matches Add")
+{
+    std::mt19937 rng(42);
+    std::vector<timelib64_t> timestamps(500);
+    for (size_t i = 0; i < timestamps.size(); i++)
+        timestamps[i] = 1000 + 10 * (timelib64_t)i;
+
+    DcgmcmSummaryType_t summaryTypes[] = { DcgmcmSummaryTypeMinimum, DcgmcmSummaryTypeMaximum,
+                                           DcgmcmSummaryTypeAverage, DcgmcmSummaryTypeSum,
+                                           DcgmcmSummaryTypeCount,   DcgmcmSummaryTypeDifference,
+                                           DcgmcmSummaryTypeIntegral };
+
+    /* The integral of a value next to a blank one overflows, so it is only compared without blanks */
+    for (bool withBlanks : { true, false })
+    {
+        auto values = RandomValues<long long>(rng, (int)timestamps.size());
+        if (!withBlanks)
+        {
+            for (auto &value : values)
+                value = DCGM_INT64_IS_BLANK(value) ? 7 : value;
+        }
+        int numSummaryTypes = withBlanks ? 6 : 7;
+
+        DcgmcmSummaryAccumulator<long long> expected;
+        for (size_t i = 0; i < values.size(); i++)
+            expected.Add(timestamps[i], values[i]);
+
+        /* Split into batches the way timeseries_for_each_span() would */
+        DcgmcmSummaryAccumulator<long long> batched;
+        batched.AddBatch(timestamps.data(), values.data(), 1, !withBlanks);
+        batched.AddBatch(&timestamps[1], &values[1], 200, !withBlanks);
+        batched.AddBatch(&timestamps[201], &values[201], 299, !withBlanks);
+
+        long long expectedValues[7];
+        long long batchedValues[7];
+        REQUIRE(expected.GetSummaries(numSummaryTypes, summaryTypes, expectedValues) == DCGM_ST_OK);
+        REQUIRE(batched.GetSummaries(numSummaryTypes, summaryTypes, batchedValues) == DCGM_ST_OK);
+        for (int i = 0; i < numSummaryTypes; i++)
+        {
+            INFO("summary type " << summaryTypes[i]);
+            CHECK(batchedValues[i] == expectedValues[i]);
+        }
+        CHECK(batched.Nseen == expected.Nseen);
+        CHECK(batched.prevTimestamp == expected.prevTimestamp);
+    }
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmTopologySelector.h>
+
+#include <cstdint>
+
+namespace
+{
+void AddLink(dcgmTopology_t &topology, unsigned int gpuA, unsigned int gpuB, dcgmGpuTopologyLevel_t path)
+{
+    topology.element[topology.numElements].dcgmGpuA = gpuA;
+    topology.element[topology.numElements].dcgmGpuB = gpuB;
+    topology.element[topology.numElements].path     = path;
+    topology.numElements++;
+}
+
+/* The best set of numGpus of candidates by trying every one, lowest gpuIds first */
+std::uint64_t BruteForce(DcgmTopologySelector const &selector, std::uint64_t candidates, unsigned int numGpus)
+{
+    std::uint64_t best     = 0;
+    unsigned int bestScore = 0;
+    unsigned int gpuIds[64];
+    unsigned int numCandidates = 0;
+
+    for (unsigned int gpuId = 0; gpuId < 64; gpuId++)
+    {
+        if (candidates & (1ULL << gpuId))
+        {
+            gpuIds[numCandidates++] = gpuId;
+        }
+    }
+
+    /* Visit subsets so that ones holding lower gpuIds come first */
+    for (std::uint64_t subset = (1ULL << numCandidates) - 1;; subset--)
+    {
+        if ((unsigned int)__builtin_popcountll(subset) == numGpus)
+        {
+            std::uint64_t gpus = 0;
+            for (unsigned int i = 0; i < numCandidates; i++)
+            {
+                if (subset & (1ULL << (numCandidates - 1 - i)))
+                {
+                    gpus |= 1ULL << gpuIds[i];
+                }
+            }
+            if (best == 0 || selector.Score(gpus) > bestScore)
+            {
+                best      = gpus;
+                bestScore = selector.Score(gpus);
+            }
+        }
+        if (subset == 0)
+        {
+            break;
+        }
+    }
+
+    return best;
+}
+} // namespace
+
+TEST_CASE("TopologySelector: Link counts")
+{
+    CHECK(DcgmTopologySelector::NvLinkCount(DCGM_TOPOLOGY_UNINITIALIZED) == 0);
+    CHECK(DcgmTopologySelector::NvLinkCount(DCGM_TOPOLOGY_NVLINK1) == 1);
+    CHECK(DcgmTopologySelector::NvLinkCount(DCGM_TOPOLOGY_NVLINK6) == 6);
+    CHECK(DcgmTopologySelector::NvLinkCount(DCGM_TOPOLOGY_NVLINK12) == 12);
+
+    dcgmTopology_t topology {};
+    AddLink(topology, 0, 1, (dcgmGpuTopologyLevel_t)(DCGM_TOPOLOGY_NVLINK2 | DCGM_TOPOLOGY_SYSTEM));
+    AddLink(topology, 1, 2, DCGM_TOPOLOGY_NVLINK1);
+    AddLink(topology, 2, 40, DCGM_TOPOLOGY_NVLINK1); /* Not a gpuId. Ignored */
+
+    DcgmTopologySelector selector(&topology);
+    CHECK(selector.Links(0, 1) == 2);
+    CHECK(selector.Links(1, 0) == 2);
+    CHECK(selector.Links(0, 2) == 0);
+    CHECK(selector.Links(2, 40) == 0);
+    CHECK(selector.Score(0x7) == 3);
+
+    DcgmTopologySelector none(nullptr);
+    CHECK(none.Score(0x7) == 0);
+}
+
+TEST_CASE("TopologySelector: Picks the most NvLinks")
+{
+    /* Two quads joined by weak links. Each quad has one strong pair */
+    dcgmTopology_t topology {};
+    for (unsigned int gpuA = 0; gpuA < 8; gpuA++)
+    {
+        for (unsigned int gpuB = gpuA + 1; gpuB < 8; gpuB++)
+        {
+            bool sameQuad = (gpuA / 4) == (gpuB / 4);
+            AddLink(topology, gpuA, gpuB, sameQuad ? DCGM_TOPOLOGY_NVLINK2 : DCGM_TOPOLOGY_NVLINK1);
+        }
+    }
+    topology.element[(7 + 6 + 5 + 4) + 2].path = DCGM_TOPOLOGY_NVLINK4; /* 4 - 7 */
+
+    DcgmTopologySelector selector(&topology);
+    unsigned int score = 0;
+
+    CHECK(selector.Select(0xFF, 2, &score) == 0x90);
+    CHECK(score == 4);
+    CHECK(selector.Select(0xFF, 4, &score) == 0xF0);
+    CHECK(score == 14);
+    CHECK(selector.Select(0x6F, 4) == 0x0F);
+
+    for (unsigned int numGpus = 1; numGpus <= 8; numGpus++)
+    {
+        CHECK(selector.Select(0xFF, numGpus) == BruteForce(selector, 0xFF, numGpus));
+        CHECK(selector.Select(0xB7, numGpus) == BruteForce(selector, 0xB7, numGpus));
+    }
+
+    CHECK(selector.Select(0xFF, 0) == 0);
+    CHECK(selector.Select(0x3, 3) == 0);
+}
+
+TEST_CASE("TopologySelector: Uniform NvSwitch topology")
+{
+    dcgmTopology_t topology {};
+    for (unsigned int gpuA = 0; gpuA < 32; gpuA++)
+    {
+        for (unsigned int gpuB = gpuA + 1; gpuB < 32; gpuB++)
+        {
+            AddLink(topology, gpuA, gpuB, DCGM_TOPOLOGY_NVLINK12);
+        }
+    }
+
+    DcgmTopologySelector selector(&topology);
+    unsigned int score = 0;
+
+    CHECK(selector.Select(0xFFFFFFFF, 8, &score) == 0xFF);
+    CHECK(score == 28 * 12);
+    CHECK(selector.Select(0xFFFF0000, 3) == 0x70000);
+}
+
+TEST_CASE("TopologySelector: Greedy above the exact limit")
+{
+    /* 20 GPUs in a ring, each with more NvLinks to its next neighbor */
+    dcgmTopology_t topology {};
+    for (unsigned int gpuA = 0; gpuA < 20; gpuA++)
+    {
+        for (unsigned int gpuB = gpuA + 1; gpuB < 20; gpuB++)
+        {
+            bool neighbors = gpuB == gpuA + 1 || (gpuA == 0 && gpuB == 19);
+            AddLink(topology, gpuA, gpuB, neighbors ? DCGM_TOPOLOGY_NVLINK4 : DCGM_TOPOLOGY_NVLINK1);
+        }
+    }
+
+    DcgmTopologySelector selector(&topology);
+    std::uint64_t selected = selector.Select((1ULL << 20) - 1, 3);
+    CHECK(__builtin_popcountll(selected) == 3);
+    CHECK(selector.Score(selected) == 4 + 4 + 1);
+}
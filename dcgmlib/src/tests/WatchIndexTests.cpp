@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmWatchIndex.hpp>
+#include <MurmurHash3.h>
+#include <hashtable.h>
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+struct TestWatch
+{
+    unsigned int entityGroupId;
+    unsigned int entityId;
+    unsigned int fieldId;
+};
+
+/* Same key packing and callbacks the cache manager used with hashtable.c */
+void *PackKey(unsigned int entityGroupId, unsigned int entityId, unsigned int fieldId)
+{
+    struct
+    {
+        unsigned int entityId;
+        unsigned short fieldId;
+        unsigned short entityGroupId;
+    } key { entityId, (unsigned short)fieldId, (unsigned short)entityGroupId };
+    void *packed = nullptr;
+    static_assert(sizeof(key) == sizeof(packed));
+    memcpy(&packed, &key, sizeof(key));
+    return packed;
+}
+
+unsigned int KeyHashCB(const void *key)
+{
+    unsigned int retVal = 0;
+    MurmurHash3_x86_32(&key, sizeof(key), 0, &retVal);
+    return retVal;
+}
+
+int KeyCmpCB(const void *key1, const void *key2)
+{
+    return key1 == key2 ? 1 : 0;
+}
+
+/* A plausible host: 8 GPUs with 16 MIG slices each, ~100 fields per entity, plus vGPUs */
+std::vector<TestWatch> MakeWatches()
+{
+    std::vector<TestWatch> watches;
+    for (unsigned int fieldId = 100; fieldId < 200; fieldId++)
+    {
+        for (unsigned int gpuId = 0; gpuId < 8; gpuId++)
+        {
+            watches.push_back({ DCGM_FE_GPU, gpuId, fieldId });
+        }
+        for (unsigned int instanceId = 0; instanceId < 128; instanceId++)
+        {
+            watches.push_back({ DCGM_FE_GPU_I, instanceId, fieldId });
+        }
+        for (unsigned int vgpuId = 0; vgpuId < 4; vgpuId++)
+        {
+            watches.push_back({ DCGM_FE_VGPU, 0x10000 + vgpuId, fieldId });
+        }
+    }
+    return watches;
+}
+} // namespace
+
+TEST_CASE("DenseWatchIndex: Lookups")
+{
+    DcgmNs::DenseWatchIndex<TestWatch> index;
+    std::vector<TestWatch> watches = MakeWatches();
+
+    for (auto &watch : watches)
+    {
+        REQUIRE(index.Insert(watch.entityGroupId, watch.entityId, watch.fieldId, &watch));
+    }
+    REQUIRE(index.Size() == watches.size());
+
+    for (auto &watch : watches)
+    {
+        REQUIRE(index.Get(watch.entityGroupId, watch.entityId, watch.fieldId) == &watch);
+    }
+
+    /* Iteration is in insertion order */
+    for (size_t i = 0; i < watches.size(); i++)
+    {
+        REQUIRE(index.Values()[i] == &watches[i]);
+    }
+
+    /* Duplicates and out of range keys are refused */
+    CHECK_FALSE(index.Insert(DCGM_FE_GPU, 0, 100, &watches[1]));
+    CHECK_FALSE(index.Insert(DCGM_FE_COUNT, 0, 100, &watches[1]));
+    CHECK_FALSE(index.Insert(DCGM_FE_GPU, 0, DCGM_FI_MAX_FIELDS, &watches[1]));
+    CHECK_FALSE(index.Insert(DCGM_FE_GPU, 0, 1, nullptr));
+    CHECK(index.Size() == watches.size());
+
+    /* Misses in existing and missing entities, dense and sparse */
+    CHECK(index.Get(DCGM_FE_GPU, 0, 99) == nullptr);
+    CHECK(index.Get(DCGM_FE_GPU, 8, 100) == nullptr);
+    CHECK(index.Get(DCGM_FE_VGPU, 0x10004, 100) == nullptr);
+    CHECK(index.Get(DCGM_FE_SWITCH, 0, 100) == nullptr);
+    CHECK(index.Get(DCGM_FE_COUNT, 0, 100) == nullptr);
+    CHECK(index.Get(DCGM_FE_GPU, 0, DCGM_FI_MAX_FIELDS) == nullptr);
+
+    index.Clear();
+    CHECK(index.Size() == 0);
+    CHECK(index.Get(DCGM_FE_GPU, 0, 100) == nullptr);
+    CHECK(index.Insert(DCGM_FE_GPU, 0, 100, &watches[0]));
+}
+
+/* Microbenchmark against the hashtable.c table that DenseWatchIndex replaced in the
+   cache manager. Hidden from the default run. Use: dcgmlibtests "[benchmark]" */
+TEST_CASE("DenseWatchIndex: Benchmark against hashtable", "[.][benchmark]")
+{
+    using Clock = std::chrono::steady_clock;
+    std::vector<TestWatch> watches = MakeWatches();
+    int const numRounds            = 200;
+    size_t found                   = 0;
+
+    hashtable_t *hashTable = hashtable_create(KeyHashCB, KeyCmpCB, 0, 0);
+    REQUIRE(hashTable != nullptr);
+    DcgmNs::DenseWatchIndex<TestWatch> index;
+
+    auto start = Clock::now();
+    for (auto &watch : watches)
+    {
+        hashtable_set(hashTable, PackKey(watch.entityGroupId, watch.entityId, watch.fieldId), &watch);
+    }
+    auto hashInsert = Clock::now() - start;
+
+    start = Clock::now();
+    for (auto &watch : watches)
+    {
+        index.Insert(watch.entityGroupId, watch.entityId, watch.fieldId, &watch);
+    }
+    auto denseInsert = Clock::now() - start;
+
+    start = Clock::now();
+    for (int round = 0; round < numRounds; round++)
+    {
+        for (auto const &watch : watches)
+        {
+            found += hashtable_get(hashTable, PackKey(watch.entityGroupId, watch.entityId, watch.fieldId)) != nullptr;
+        }
+    }
+    auto hashLookup = Clock::now() - start;
+
+    start = Clock::now();
+    for (int round = 0; round < numRounds; round++)
+    {
+        for (auto const &watch : watches)
+        {
+            found += index.Get(watch.entityGroupId, watch.entityId, watch.fieldId) != nullptr;
+        }
+    }
+    auto denseLookup = Clock::now() - start;
+
+    start = Clock::now();
+    for (int round = 0; round < numRounds; round++)
+    {
+        for (void *hashIter = hashtable_iter(hashTable); hashIter; hashIter = hashtable_iter_next(hashTable, hashIter))
+        {
+            found += ((TestWatch *)hashtable_iter_value(hashIter))->fieldId != 0;
+        }
+    }
+    auto hashIterate = Clock::now() - start;
+
+    start = Clock::now();
+    for (int round = 0; round < numRounds; round++)
+    {
+        for (TestWatch *watch : index.Values())
+        {
+            found += watch->fieldId != 0;
+        }
+    }
+    auto denseIterate = Clock::now() - start;
+
+    hashtable_destroy(hashTable);
+
+    CHECK(found == 4 * numRounds * watches.size());
+
+    auto perOp = [](Clock::duration elapsed, size_t numOps) {
+        return std::chrono::duration<double, std::nano>(elapsed).count() / numOps;
+    };
+    size_t numLookups = numRounds * watches.size();
+    WARN("Watches: " << watches.size() << ". ns/op hashtable vs dense: insert " << perOp(hashInsert, watches.size())
+                     << " vs " << perOp(denseInsert, watches.size()) << ", lookup " << perOp(hashLookup, numLookups)
+                     << " vs " << perOp(denseLookup, numLookups) << ", iterate " << perOp(hashIterate, numLookups)
+                     << " vs " << perOp(denseIterate, numLookups));
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmWorkerLanes.h>
+#include <dcgm_core_structs.h>
+#include <dcgm_diag_structs.h>
+
+#include <cstring>
+
+namespace
+{
+dcgm_module_command_header_t MakeCommand(dcgmModuleId_t moduleId, unsigned int subCommand)
+{
+    dcgm_module_command_header_t moduleCommand {};
+    moduleCommand.length     = sizeof(moduleCommand);
+    moduleCommand.moduleId   = moduleId;
+    moduleCommand.subCommand = subCommand;
+    return moduleCommand;
+}
+
+std::unique_ptr<DcgmMessage> MakeBatch(std::vector<dcgm_module_command_header_t> const &moduleCommands)
+{
+    std::vector<char> body(sizeof(dcgm_msg_module_command_batch_t));
+    dcgm_msg_module_command_batch_t batchHeader {};
+    batchHeader.version     = dcgm_msg_module_command_batch_version;
+    batchHeader.numCommands = moduleCommands.size();
+    memcpy(body.data(), &batchHeader, sizeof(batchHeader));
+
+    for (auto const &moduleCommand : moduleCommands)
+    {
+        dcgm_msg_module_command_batch_entry_t entry {};
+        body.insert(body.end(), (char const *)&entry, (char const *)&entry + sizeof(entry));
+        body.insert(body.end(), (char const *)&moduleCommand, (char const *)&moduleCommand + sizeof(moduleCommand));
+    }
+
+    auto message = std::make_unique<DcgmMessage>();
+    message->UpdateMsgHdr(DCGM_MSG_MODULE_COMMAND_BATCH, 1, DCGM_ST_OK, body.size());
+    *message->GetMsgBytesPtr() = body;
+    return message;
+}
+} // namespace
+
+TEST_CASE("WorkerLanes: module commands")
+{
+    CHECK(DcgmClassifyModuleCommand(MakeCommand(DcgmModuleIdCore, DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES))
+          == DcgmWorkerLaneFast);
+    CHECK(DcgmClassifyModuleCommand(MakeCommand(DcgmModuleIdCore, DCGM_CORE_SR_JOB_GET_STATS)) == DcgmWorkerLaneLong);
+    CHECK(DcgmClassifyModuleCommand(MakeCommand(DcgmModuleIdCore, DCGM_CORE_SR_WATCH_FIELDS)) == DcgmWorkerLaneAdmin);
+    CHECK(DcgmClassifyModuleCommand(MakeCommand(DcgmModuleIdDiag, DCGM_DIAG_SR_RUN)) == DcgmWorkerLaneLong);
+    CHECK(DcgmClassifyModuleCommand(MakeCommand(DcgmModuleIdPolicy, 1)) == DcgmWorkerLaneAdmin);
+}
+
+TEST_CASE("WorkerLanes: messages")
+{
+    auto message = std::make_unique<DcgmMessage>();
+    auto command = MakeCommand(DcgmModuleIdCore, DCGM_CORE_SR_ENTITIES_GET_LATEST_VALUES);
+    message->UpdateMsgHdr(DCGM_MSG_MODULE_COMMAND, 1, DCGM_ST_OK, sizeof(command));
+    message->GetMsgBytesPtr()->assign((char const *)&command, (char const *)&command + sizeof(command));
+    CHECK(DcgmClassifyMessage(*message) == DcgmWorkerLaneFast);
+
+    /* Truncated commands are left to the admin lane to reject */
+    message->GetMsgBytesPtr()->resize(sizeof(command) - 1);
+    CHECK(DcgmClassifyMessage(*message) == DcgmWorkerLaneAdmin);
+
+    /* Batches go to their slowest command's lane */
+    auto fast = MakeCommand(DcgmModuleIdCore, DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES);
+    auto diag = MakeCommand(DcgmModuleIdDiag, DCGM_DIAG_SR_RUN);
+    CHECK(DcgmClassifyMessage(*MakeBatch({ fast, fast })) == DcgmWorkerLaneFast);
+    CHECK(DcgmClassifyMessage(*MakeBatch({ fast, diag })) == DcgmWorkerLaneLong);
+
+    message->UpdateMsgHdr(DCGM_MSG_PROTO_REQUEST, 1, DCGM_ST_OK, 0);
+    CHECK(DcgmClassifyMessage(*message) == DcgmWorkerLaneAdmin);
+}
@@ -127,6 +127,11 @@ dcgmReturn_t ArgumentSet_t::ProcessFieldIds(void)
     arguments->m_parameters.m_targetMaxValue    = m_targetMaxValue.Value();
     arguments->m_parameters.m_noDcgmValidation  = m_noDcgmValidation.Value();
     arguments->m_parameters.m_dvsOutput         = m_dvsOutput.Value();
+    arguments->m_parameters.m_loadProfile       = m_loadProfileString.Value();
+    arguments->m_parameters.m_tensorPrecision   = m_tensorPrecisionString.Value();
+    arguments->m_parameters.m_nvLinkAllPeers    = (m_nvLinkPeersString.Value() == "all");
+    arguments->m_parameters.m_nvLinkMessageKiB  = m_nvLinkMessageKiB.Value();
+    arguments->m_parameters.m_nvLinkDirection   = m_nvLinkDirectionString.Value();
 
     double minValue;
     double maxValue;
@@ -217,6 +222,21 @@ dcgmReturn_t ArgumentSet_t::ProcessFieldIds(void)
                            });
     }
 
+    if ((m_nvLinkPeersString.Value() != "best") && !arguments->m_parameters.m_nvLinkAllPeers)
+    {
+        ProcessIntegerList(m_nvLinkPeersString.Value(),
+                           arguments,
+                           false,
+                           [](ArgumentSet_t &self,
+                              std::shared_ptr<Arguments_t> arguments,
+                              bool useDefaults,
+                              unsigned int gpuId) mutable -> dcgmReturn_t {
+                               arguments->m_parameters.m_nvLinkPeerIds.push_back(gpuId);
+
+                               return DCGM_ST_OK;
+                           });
+    }
+
     ProcessStringList(m_modeString.Value(),
                       arguments,
                       false,
@@ -249,6 +269,10 @@ dcgmReturn_t ArgumentSet_t::ProcessFieldIds(void)
                           {
                               arguments->m_parameters.m_fast = setting;
                           }
+                          else if (mode.compare(pos, std::string::npos, "threads") == 0)
+                          {
+                              arguments->m_parameters.m_threads = setting;
+                          }
                           else
                           {
                               DCGM_LOG_ERROR << "Arguments -- bad mode " << mode;
@@ -485,6 +509,11 @@ dcgmReturn_t ArgumentSet_t::Parse(int argc, char *argv[])
             m_logFileString.ArgReset();
             m_logLevelString.ArgReset();
             m_configFile.ArgReset();
+            m_loadProfileString.ArgReset();
+            m_tensorPrecisionString.ArgReset();
+            m_nvLinkPeersString.ArgReset();
+            m_nvLinkMessageKiB.ArgReset();
+            m_nvLinkDirectionString.ArgReset();
         }
         catch (TCLAP::ArgException const &ex)
         {
@@ -43,14 +43,21 @@ public:
         bool m_percentTolerance; // if tolerance is a percentage (or absolute)
         double m_tolerance;      // tolerance (if m_valueValid is false)
 
-        uint8_t m_waitToCheck;       // [0-100] 0 10      wait a percentage of the tests before comparing
-        uint8_t m_maxGpusInParallel; // [0-255] 4 all  max GPU proc. in parallel
-        double m_duration;           // <value> 30.0 2.00 duration of the test in seconds
-        double m_reportInterval;     // <value> 1.00 0.01 rate of report gathering in seconds
-        unsigned int m_syncCount;    // maximum activity synchronization count
-        bool m_targetMaxValue;       // bool    false false   target maximum value
-        bool m_noDcgmValidation;     // bool    false false   if set, we will NOT self-validate DCGM metrics.
-        bool m_dvsOutput;            // bool    false false   if set, we will append DVS tags to our stdout.
+        uint8_t m_waitToCheck;           // [0-100] 0 10      wait a percentage of the tests before comparing
+        uint8_t m_maxGpusInParallel;     // [0-255] 4 all  max GPU proc. in parallel
+        double m_duration;               // <value> 30.0 2.00 duration of the test in seconds
+        double m_reportInterval;         // <value> 1.00 0.01 rate of report gathering in seconds
+        unsigned int m_syncCount;        // maximum activity synchronization count
+        bool m_targetMaxValue;           // bool    false false   target maximum value
+        bool m_noDcgmValidation;         // bool    false false   if set, we will NOT self-validate DCGM metrics.
+        bool m_dvsOutput;                // bool    false false   if set, we will append DVS tags to our stdout.
+        std::string m_loadProfile;       // string  ""    ""      target activity curve (see LoadProfile.h)
+        std::string m_tensorPrecision;   // string  fp16  fp16    tensor GEMM input precision
+        bool m_nvLinkAllPeers;           // bool    false false   copy to all NvLink peers (else m_nvLinkPeerIds)
+        unsigned int m_nvLinkMessageKiB; // <value> 102400 ---  NvLink copy size in KiB
+        std::string m_nvLinkDirection;   // string  auto  auto    NvLink copy direction: auto, tx, rx or both
+
+        std::vector<unsigned int> m_nvLinkPeerIds; // NvLink peers (empty and not m_nvLinkAllPeers: best peer)
 
         // Log Control
         std::string m_logFile;            // string  dcgmproftester.log --- log file
@@ -62,6 +69,7 @@ public:
         bool m_report { true };    // whether to produce report
         bool m_validate { false }; // whether to validate
         bool m_fast { false };     // whether to finish as soon as possible
+        bool m_threads { false };  // whether to run workers as threads
 
         unsigned int m_fieldId; // <value> --- ---  profiling FieldId
     } m_parameters;
@@ -300,6 +308,11 @@ private:
     Argument_t<std::string> m_logFileString;
     Argument_t<std::string> m_logLevelString;
     Argument_t<std::string> m_configFile;
+    Argument_t<std::string> m_loadProfileString;
+    Argument_t<std::string> m_tensorPrecisionString;
+    Argument_t<std::string> m_nvLinkPeersString;
+    Argument_t<unsigned int> m_nvLinkMessageKiB;
+    Argument_t<std::string> m_nvLinkDirectionString;
 
     std::vector<std::shared_ptr<Arguments_t>> m_arguments;
     bool m_snapshotReady { false };
@@ -564,8 +577,9 @@ public:
             std::string(""),
             std::string("mode"),
             std::string("operational mode"),
-            std::string("operational mode: fast, generate load, report, validate"),
-            std::string("operational mode must be one of [no]fast, [no]generateload, [no]report, [no]validate"),
+            std::string("operational mode: fast, generate load, report, threads, validate"),
+            std::string(
+                "operational mode must be one of [no]fast, [no]generateload, [no]report, [no]threads, [no]validate"),
             [](decltype(m_modeString) &arg, const decltype(m_modeString)::ArgType &value) { return true; })
         ,
 
@@ -617,6 +631,84 @@ public:
                      std::string("Configuration file must be in YAML or JSON format"),
 
                      [](decltype(m_configFile) &arg, const decltype(m_configFile)::ArgType &value) { return true; })
+        ,
+
+        m_loadProfileString(
+            m_cmd,
+            std::string(""),
+            false,
+            std::string(""),
+            std::string("load-profile"),
+            std::string("load profile"),
+            std::string("Target activity curve for SM and graphics activity tests: "
+                        "square:<period>:<duty>[:<low>:<high>], ramp:<period>[:<low>:<high>] or trace:<file>"),
+            std::string("Load profile must be square:..., ramp:... or trace:<file>"),
+
+            [](decltype(m_loadProfileString) &arg, const decltype(m_loadProfileString)::ArgType &value) {
+                return value.find(' ') == std::string::npos;
+            })
+        ,
+
+        m_tensorPrecisionString(
+            m_cmd,
+            std::string("fp16"),
+            false,
+            std::string(""),
+            std::string("tensor-precision"),
+            std::string("tensor precision"),
+            std::string("Input precision of the tensor activity GEMM: fp16, bf16, tf32 or int8"),
+            std::string("Tensor precision must be one of fp16, bf16, tf32 or int8"),
+
+            [](decltype(m_tensorPrecisionString) &arg, const decltype(m_tensorPrecisionString)::ArgType &value) {
+                return (value == "fp16") || (value == "bf16") || (value == "tf32") || (value == "int8");
+            })
+        ,
+
+        m_nvLinkPeersString(
+            m_cmd,
+            std::string("best"),
+            false,
+            std::string(""),
+            std::string("nvlink-peers"),
+            std::string("NvLink peers"),
+            std::string("NvLink peers to copy to concurrently: best (the peer with the most links), all, or a "
+                        "comma-separated list of GPU ids"),
+            std::string("NvLink peers must be best, all or a comma-separated list of GPU ids"),
+
+            [](decltype(m_nvLinkPeersString) &arg, const decltype(m_nvLinkPeersString)::ArgType &value) {
+                return (value == "best") || (value == "all")
+                       || (!value.empty() && (value.find_first_not_of("0123456789,") == std::string::npos));
+            })
+        ,
+
+        m_nvLinkMessageKiB(
+            m_cmd,
+            102400,
+            false,
+            std::string(""),
+            std::string("nvlink-message-size"),
+            std::string("NvLink message size"),
+            std::string("Size of each NvLink copy in KiB"),
+            std::string("NvLink message size should be between 4 and 1048576 KiB"),
+
+            [](decltype(m_nvLinkMessageKiB) &arg, const decltype(m_nvLinkMessageKiB)::ArgType &value) {
+                return (value >= 4) && (value <= 1048576);
+            })
+        ,
+
+        m_nvLinkDirectionString(
+            m_cmd,
+            std::string("auto"),
+            false,
+            std::string(""),
+            std::string("nvlink-direction"),
+            std::string("NvLink direction"),
+            std::string("Direction of NvLink copies: auto (that of the field tested), tx, rx or both"),
+            std::string("NvLink direction must be one of auto, tx, rx or both"),
+
+            [](decltype(m_nvLinkDirectionString) &arg, const decltype(m_nvLinkDirectionString)::ArgType &value) {
+                return (value == "auto") || (value == "tx") || (value == "rx") || (value == "both");
+            })
 
             {};
 
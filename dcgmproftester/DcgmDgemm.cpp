@@ -27,27 +27,55 @@
 
 namespace DcgmNs
 {
-/**
- * @brief This function is a replication of the cublasDgemm for FP64 without Tensor Cores
- */
-cublasStatus_t DcgmDgemm(cublasLtHandle_t ltHandle,
-                         cublasOperation_t transa,
-                         cublasOperation_t transb,
-                         int m,
-                         int n,
-                         int k,
-                         const double *alpha, /* host or device pointer */
-                         const double *A,
-                         int lda,
-                         const double *B,
-                         int ldb,
-                         const double *beta, /* host or device pointer */
-                         double *C,
-                         int ldc)
+namespace
+{
+struct GemmTypes
+{
+    cublasComputeType_t computeType;
+    cudaDataType_t scaleType;
+    cudaDataType_t abType;
+    cudaDataType_t cType;
+    bool tensorCores;
+};
+
+GemmTypes GetGemmTypes(DcgmGemmPrecision precision)
+{
+    switch (precision)
+    {
+        case DcgmGemmPrecision::Fp16:
+            return { CUBLAS_COMPUTE_32F, CUDA_R_32F, CUDA_R_16F, CUDA_R_16F, true };
+        case DcgmGemmPrecision::Bf16:
+            return { CUBLAS_COMPUTE_32F, CUDA_R_32F, CUDA_R_16BF, CUDA_R_16BF, true };
+        case DcgmGemmPrecision::Tf32:
+            return { CUBLAS_COMPUTE_32F_FAST_TF32, CUDA_R_32F, CUDA_R_32F, CUDA_R_32F, true };
+        case DcgmGemmPrecision::Int8:
+            return { CUBLAS_COMPUTE_32I, CUDA_R_32I, CUDA_R_8I, CUDA_R_32I, true };
+        case DcgmGemmPrecision::Fp64:
+        default:
+            return { CUBLAS_COMPUTE_64F_PEDANTIC, CUDA_R_64F, CUDA_R_64F, CUDA_R_64F, false };
+    }
+}
+} // namespace
+
+cublasStatus_t DcgmGemm(cublasLtHandle_t ltHandle,
+                        DcgmGemmPrecision precision,
+                        cublasOperation_t transa,
+                        cublasOperation_t transb,
+                        int m,
+                        int n,
+                        int k,
+                        const void *alpha, /* host or device pointer */
+                        const void *A,
+                        int lda,
+                        const void *B,
+                        int ldb,
+                        const void *beta, /* host or device pointer */
+                        void *C,
+                        int ldc,
+                        void *workspace,
+                        size_t workspaceSize)
 {
     using namespace Dcgm;
-    void *workspace      = nullptr;
-    size_t workspaceSize = 0;
 
     cublasLtMatmulDesc_t operationDesc    = nullptr;
     cublasLtMatrixLayout_t Adesc          = nullptr;
@@ -59,34 +87,47 @@ cublasStatus_t DcgmDgemm(cublasLtHandle_t ltHandle,
     cublasLtMatmulHeuristicResult_t heuristicResult = {};
 
     cublasLtOrder_t rowOrder = CUBLASLT_ORDER_ROW;
+    GemmTypes types          = GetGemmTypes(precision);
+
+    if (precision == DcgmGemmPrecision::Int8)
+    {
+        transa = CUBLAS_OP_T;
+        transb = CUBLAS_OP_N;
+    }
 
-    CU_CHK(CublasProxy::CublasLtMatmulDescCreate(&operationDesc, CUBLAS_COMPUTE_64F_PEDANTIC, CUDA_R_64F));
+    CU_CHK(CublasProxy::CublasLtMatmulDescCreate(&operationDesc, types.computeType, types.scaleType));
     CU_CHK(CublasProxy::CublasLtMatmulDescSetAttribute(
         operationDesc, CUBLASLT_MATMUL_DESC_TRANSA, &transa, sizeof(transa)));
     CU_CHK(CublasProxy::CublasLtMatmulDescSetAttribute(
         operationDesc, CUBLASLT_MATMUL_DESC_TRANSB, &transb, sizeof(transa)));
 
     CU_CHK(CublasProxy::CublasLtMatrixLayoutCreate(
-        &Adesc, CUDA_R_64F, transa == CUBLAS_OP_N ? m : k, transa == CUBLAS_OP_N ? k : m, lda));
+        &Adesc, types.abType, transa == CUBLAS_OP_N ? m : k, transa == CUBLAS_OP_N ? k : m, lda));
     CU_CHK(CublasProxy::CublasLtMatrixLayoutCreate(
-        &Bdesc, CUDA_R_64F, transb == CUBLAS_OP_N ? k : n, transb == CUBLAS_OP_N ? n : k, ldb));
-    CU_CHK(CublasProxy::CublasLtMatrixLayoutCreate(&Cdesc, CUDA_R_64F, m, n, ldc));
+        &Bdesc, types.abType, transb == CUBLAS_OP_N ? k : n, transb == CUBLAS_OP_N ? n : k, ldb));
+    CU_CHK(CublasProxy::CublasLtMatrixLayoutCreate(&Cdesc, types.cType, m, n, ldc));
 
-    CU_CHK(CublasProxy::CublasLtMatrixLayoutSetAttribute(
-        Adesc, CUBLASLT_MATRIX_LAYOUT_ORDER, &rowOrder, sizeof(rowOrder)));
-    CU_CHK(CublasProxy::CublasLtMatrixLayoutSetAttribute(
-        Bdesc, CUBLASLT_MATRIX_LAYOUT_ORDER, &rowOrder, sizeof(rowOrder)));
-    CU_CHK(CublasProxy::CublasLtMatrixLayoutSetAttribute(
-        Cdesc, CUBLASLT_MATRIX_LAYOUT_ORDER, &rowOrder, sizeof(rowOrder)));
+    if (precision != DcgmGemmPrecision::Int8)
+    {
+        CU_CHK(CublasProxy::CublasLtMatrixLayoutSetAttribute(
+            Adesc, CUBLASLT_MATRIX_LAYOUT_ORDER, &rowOrder, sizeof(rowOrder)));
+        CU_CHK(CublasProxy::CublasLtMatrixLayoutSetAttribute(
+            Bdesc, CUBLASLT_MATRIX_LAYOUT_ORDER, &rowOrder, sizeof(rowOrder)));
+        CU_CHK(CublasProxy::CublasLtMatrixLayoutSetAttribute(
+            Cdesc, CUBLASLT_MATRIX_LAYOUT_ORDER, &rowOrder, sizeof(rowOrder)));
+    }
 
     CU_CHK(CublasProxy::CublasLtMatmulPreferenceCreate(&preference));
     CU_CHK(CublasProxy::CublasLtMatmulPreferenceSetAttribute(
         preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspaceSize, sizeof(workspaceSize)));
 
-    // Exclude algorithms that are using Tensor cores
-    std::uint64_t mMask = static_cast<std::uint64_t>(-1) & (~CUBLASLT_NUMERICAL_IMPL_FLAGS_TENSOR_OP_MASK);
-    CU_CHK(CublasProxy::CublasLtMatmulPreferenceSetAttribute(
-        preference, CUBLASLT_MATMUL_PREF_IMPL_MASK, &mMask, sizeof(mMask)));
+    if (!types.tensorCores)
+    {
+        // Exclude algorithms that are using Tensor cores
+        std::uint64_t mMask = static_cast<std::uint64_t>(-1) & (~CUBLASLT_NUMERICAL_IMPL_FLAGS_TENSOR_OP_MASK);
+        CU_CHK(CublasProxy::CublasLtMatmulPreferenceSetAttribute(
+            preference, CUBLASLT_MATMUL_PREF_IMPL_MASK, &mMask, sizeof(mMask)));
+    }
 
     CU_CHK(CublasProxy::CublasLtMatmulAlgoGetHeuristic(
         ltHandle, operationDesc, Adesc, Bdesc, Cdesc, Cdesc, preference, 1, &heuristicResult, &returnedResults));
@@ -122,4 +163,26 @@ cublasStatus_t DcgmDgemm(cublasLtHandle_t ltHandle,
     return CUBLAS_STATUS_SUCCESS;
 }
 
+/**
+ * @brief This function is a replication of the cublasDgemm for FP64 without Tensor Cores
+ */
+cublasStatus_t DcgmDgemm(cublasLtHandle_t ltHandle,
+                         cublasOperation_t transa,
+                         cublasOperation_t transb,
+                         int m,
+                         int n,
+                         int k,
+                         const double *alpha, /* host or device pointer */
+                         const double *A,
+                         int lda,
+                         const double *B,
+                         int ldb,
+                         const double *beta, /* host or device pointer */
+                         double *C,
+                         int ldc)
+{
+    return DcgmGemm(
+        ltHandle, DcgmGemmPrecision::Fp64, transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
 } // namespace DcgmNs
\ No newline at end of file
@@ -19,6 +19,47 @@
 
 namespace DcgmNs
 {
+/**
+ * @brief Input and compute precisions supported by DcgmGemm
+ */
+enum class DcgmGemmPrecision
+{
+    Fp64, //!< FP64 without Tensor Cores. alpha and beta are double
+    Fp16, //!< FP16 A, B and C with FP32 accumulation on Tensor Cores. alpha and beta are float
+    Bf16, //!< BF16 A, B and C with FP32 accumulation on Tensor Cores. alpha and beta are float
+    Tf32, //!< FP32 A, B and C computed as TF32 on Tensor Cores. alpha and beta are float
+    Int8, //!< INT8 A and B, INT32 C and accumulation on Tensor Cores. alpha and beta are int32_t
+};
+
+/**
+ * @brief A row-major cublasLt GEMM in the given precision
+ *
+ * For Int8, A is always used transposed and B non-transposed (the only form
+ * cublasLt runs on Tensor Cores with regular data ordering), in column-major
+ * order. Callers only use square matrices, so this does not change the
+ * amount of work.
+ *
+ * workspace is device memory cublasLt may use, such as the one that comes with
+ * CublasLtGetCachedHandle(). Without one fewer algorithms are available.
+ */
+cublasStatus_t DcgmGemm(cublasLtHandle_t ltHandle,
+                        DcgmGemmPrecision precision,
+                        cublasOperation_t transa,
+                        cublasOperation_t transb,
+                        int m,
+                        int n,
+                        int k,
+                        const void *alpha, /* host or device pointer */
+                        const void *A,
+                        int lda,
+                        const void *B,
+                        int ldb,
+                        const void *beta, /* host or device pointer */
+                        void *C,
+                        int ldc,
+                        void *workspace      = nullptr,
+                        size_t workspaceSize = 0);
+
 cublasStatus_t DcgmDgemm(cublasLtHandle_t ltHandle,
                          cublasOperation_t transa,
                          cublasOperation_t transb,
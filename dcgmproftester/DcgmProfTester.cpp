@@ -539,6 +539,21 @@ void DcgmProfTester::SetNextPart(unsigned int value)
 }
 
 
+/*****************************************************************************/
+bool DcgmProfTester::IsMigInUse(void) const
+{
+    for (auto &gpuInstance : m_gpuInstances)
+    {
+        if (gpuInstance.m_isMig)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 /*****************************************************************************/
 void DcgmProfTester::ReportWorkerStarted(std::shared_ptr<DistributedCudaContext> worker)
 {
@@ -110,6 +110,14 @@ public:
     unsigned int GetNextPart(void) const;
     void SetNextPart(unsigned int value);
 
+    /*************************************************************************/
+    /*
+     * Reports whether any MIG compute instance is under test. Workers for MIG
+     * instances must be forked before the CUDA driver is initialized in this
+     * process, so worker threads are not used when this returns true.
+     */
+    bool IsMigInUse(void) const;
+
     /* Physical GPU and CUDA context management */
     dcgmReturn_t InitializeGpus(const DcgmNs::ProfTester::Arguments_t &arguments);
     dcgmReturn_t ShutdownGpus(void);
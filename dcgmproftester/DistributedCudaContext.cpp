@@ -26,6 +26,8 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
@@ -33,6 +35,7 @@
 #include <iomanip>
 #include <iostream> // for debugging
 #include <libgen.h> // for dirname
+#include <signal.h>
 #include <sys/prctl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -348,6 +351,11 @@ void DistributedCudaContext::Reset(bool keepDcgmGroups)
 {
     if (m_context != nullptr)
     {
+        /* The cached cuBLAS handles belong to this context */
+        cuCtxPushCurrent(m_context);
+        CublasProxy::CublasReleaseCachedHandles(m_device);
+        cuCtxPopCurrent(nullptr);
+
         cuCtxDestroy(m_context);
         cuCtxSynchronize();
         m_context = nullptr;
@@ -587,8 +595,9 @@ bool DistributedCudaContext::IsFirstTick(void) const
 // Request early test termination. Call from main process.
 void DistributedCudaContext::Exit(void)
 {
-    Command("X\nX\n"); // Request exit;
-    m_pid = 0;         // Forget about child.
+    Command("X\nX\n");  // Request exit;
+    m_pid       = 0;     // Forget about child.
+    m_inProcess = false; // Forget about worker thread (joined later).
 }
 
 // Tell this worker it is finished processing data.
@@ -697,6 +706,13 @@ void DistributedCudaContext::MoveFrom(DistributedCudaContext &&other)
     m_wait             = other.m_wait;
     m_buffered         = other.m_buffered;
     m_finished         = other.m_finished;
+    m_inProcess        = other.m_inProcess;
+
+    JoinWorkerThread();
+    m_worker       = std::move(other.m_worker);
+    m_workerThread = std::move(other.m_workerThread);
+
+    other.m_inProcess = false;
 
     other.Reset();
 }
@@ -714,6 +730,16 @@ DistributedCudaContext::DistributedCudaContext(
 }
 
 
+DistributedCudaContext::DistributedCudaContext(
+    std::shared_ptr<PhysicalGpu> physicalGpu,
+    std::shared_ptr<std::map<dcgm_field_entity_group_t, dcgm_field_eid_t>> entities,
+    const dcgmGroupEntityPair_t &entity)
+    : m_physicalGpu(physicalGpu)
+    , m_entity(entity)
+    , m_entities(std::move(entities))
+{}
+
+
 DistributedCudaContext::DistributedCudaContext(DistributedCudaContext &&other) noexcept
     : m_entity({})
 {
@@ -737,6 +763,12 @@ DistributedCudaContext::~DistributedCudaContext()
             kill(m_pid, SIGKILL);
         }
     }
+
+    /**
+     * Our pipe ends are closed, so a worker thread will fail its next
+     * response, or notice the stop request while waiting for a command.
+     */
+    JoinWorkerThread();
 }
 
 
@@ -1556,7 +1588,22 @@ CLEANUP:
 /*****************************************************************************/
 int DistributedCudaContext::RunSubtestNvLinkBandwidth(void)
 {
-    CUdevice peerCuDevice = 0;
+    /* One NvLink peer, with everything we need to copy to and from it. */
+    struct NvLinkPeer
+    {
+        std::string busId;
+        CUcontext context { nullptr };
+        CUdeviceptr txBuffer { 0 };      /* On the peer: written by our TX copies */
+        CUdeviceptr rxBuffer { 0 };      /* On the peer: read by our RX copies */
+        CUdeviceptr localRxBuffer { 0 }; /* Ours: written by our RX copies */
+        CUstream txStream { nullptr };
+        CUstream rxStream { nullptr };
+        unsigned int txInFlight { 0 };
+        unsigned int rxInFlight { 0 };
+        size_t txBytes { 0 }; /* Completed this interval */
+        size_t rxBytes { 0 };
+    };
+
     int retSt { 0 };
     CUresult cuSt;
 
@@ -1564,58 +1611,128 @@ int DistributedCudaContext::RunSubtestNvLinkBandwidth(void)
     double prevPerSecond, oneMiB, startTime, tick, now;
     unsigned int activities = (duration + m_reportInterval / 2.0) / m_reportInterval;
 
-    /* Get our best peer to do NvLink copies to. Copy in rest of request line
-     * and parse it.
+    /* The rest of the request line is the direction, message size and the
+     * bus IDs of the peers to copy to.
      */
+    std::string line;
+    std::string direction;
+    size_t messageSize { 0 };
+    std::string busId;
+    std::vector<NvLinkPeer> peers;
+    CUdeviceptr localTxBuffer = (CUdeviceptr)NULL;
+    unsigned int copiesPerQuery;
+    bool doTx;
+    bool doRx;
 
-    std::string PeerBusId;
+    std::getline(m_input, line);
 
-    m_input >> PeerBusId;
-    m_input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::stringstream params(line);
 
-    /* Find the corresponding cuda device to our peer DCGM device */
-    cuSt = cuDeviceGetByPCIBusId(&peerCuDevice, PeerBusId.c_str());
-    if (cuSt)
+    params >> direction >> messageSize;
+
+    while (params >> busId)
+    {
+        peers.emplace_back();
+        peers.back().busId = busId;
+    }
+
+    if ((messageSize == 0) || peers.empty())
     {
-        m_error << "cuDeviceGetByPCIBusId returned " << cuSt << " for busId " << PeerBusId << '\n';
+        m_error << "bad NvLink parameters: " << line << '\n';
         Respond("F\n");
 
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    /* Create a context on the other GPU */
-    CUcontext deviceCtx1;
-    cuSt = cuCtxCreate(&deviceCtx1, CU_CTX_SCHED_BLOCKING_SYNC, peerCuDevice);
-    if (cuSt)
+    if (direction == "auto")
     {
-        m_error << "cuCtxCreate returned " << cuSt << '\n';
+        direction = (m_testFieldId == DCGM_FI_PROF_NVLINK_RX_BYTES) ? "rx" : "tx";
+    }
+
+    doTx = (direction == "tx") || (direction == "both");
+    doRx = (direction == "rx") || (direction == "both");
+
+    if (!doTx && !doRx)
+    {
+        m_error << "bad NvLink direction " << direction << '\n';
         Respond("F\n");
 
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    /* Allocate 100 MB of FB memory on both devices */
-    const size_t bufferSize = 100 * 1024 * 1024;
-    CUdeviceptr deviceMem0  = (CUdeviceptr)NULL;
-    CUdeviceptr deviceMem1  = (CUdeviceptr)NULL;
+    /**
+     * Keep enough copies queued on each stream that it does not run dry
+     * between our polls, even with small messages.
+     */
+    copiesPerQuery = std::clamp<size_t>((16 * 1024 * 1024) / messageSize, 2, 256);
+
+    /* Once we've created contexts or allocated memory, goto CLEANUP instead of returning  */
+
+    for (auto &peer : peers)
+    {
+        CUdevice peerCuDevice = 0;
+
+        /* Find the corresponding cuda device to our peer DCGM device */
+        cuSt = cuDeviceGetByPCIBusId(&peerCuDevice, peer.busId.c_str());
+        if (cuSt)
+        {
+            m_error << "cuDeviceGetByPCIBusId returned " << cuSt << " for busId " << peer.busId << '\n';
+            retSt = -1;
+            goto CLEANUP;
+        }
+
+        /* Create a context on the other GPU */
+        cuSt = cuCtxCreate(&peer.context, CU_CTX_SCHED_BLOCKING_SYNC, peerCuDevice);
+        if (cuSt)
+        {
+            m_error << "cuCtxCreate returned " << cuSt << " for busId " << peer.busId << '\n';
+            retSt = -1;
+            goto CLEANUP;
+        }
+
+        m_message << "Allocating peer " << peer.busId << " mem" << '\n';
+
+        if (doTx && (cuSt = cuMemAlloc(&peer.txBuffer, messageSize)) == CUDA_SUCCESS)
+        {
+            cuSt = cuMemsetD8(peer.txBuffer, 0, messageSize);
+        }
+
+        if (doRx && (cuSt == CUDA_SUCCESS) && (cuSt = cuMemAlloc(&peer.rxBuffer, messageSize)) == CUDA_SUCCESS)
+        {
+            cuSt = cuMemsetD8(peer.rxBuffer, 0, messageSize);
+        }
+
+        if (cuSt)
+        {
+            m_error << "cuMemAlloc returned " << cuSt << " for busId " << peer.busId << '\n';
+            retSt = -1;
+            goto CLEANUP;
+        }
+    }
 
     cuCtxSetCurrent(m_context);
 
-    m_message << "Allocating device 0 mem" << '\n';
-    cuSt = cuMemAlloc(&deviceMem0, bufferSize);
-    if (cuSt)
+    m_message << "Allocating local mem" << '\n';
+
+    cuSt = cuMemAlloc(&localTxBuffer, messageSize);
+    if (cuSt == CUDA_SUCCESS)
     {
-        m_error << "cuMemAlloc returned " << cuSt << '\n';
-        retSt = -1;
-        goto CLEANUP;
+        cuSt = cuMemsetD8(localTxBuffer, 0, messageSize);
     }
-    m_message << "Clearing device 0 mem" << '\n';
-    cuMemsetD32(deviceMem0, 0, bufferSize);
 
-    cuCtxSetCurrent(deviceCtx1);
+    for (auto &peer : peers)
+    {
+        if (cuSt)
+        {
+            break;
+        }
+
+        if (doRx && (cuSt = cuMemAlloc(&peer.localRxBuffer, messageSize)) == CUDA_SUCCESS)
+        {
+            cuSt = cuMemsetD8(peer.localRxBuffer, 0, messageSize);
+        }
+    }
 
-    printf("Allocating device 1 mem\n");
-    cuSt = cuMemAlloc(&deviceMem1, bufferSize);
     if (cuSt)
     {
         m_error << "cuMemAlloc returned " << cuSt << '\n';
@@ -1623,23 +1740,37 @@ int DistributedCudaContext::RunSubtestNvLinkBandwidth(void)
         goto CLEANUP;
     }
 
-    m_message << "Clearing device 1 mem" << '\n';
-    cuMemsetD32(deviceMem1, 0, bufferSize);
+    for (auto &peer : peers)
+    {
+        cuSt = cuCtxEnablePeerAccess(peer.context, 0);
+        if (cuSt)
+        {
+            m_error << "cuCtxEnablePeerAccess returned " << cuSt << " for busId " << peer.busId << '\n';
+            retSt = -1;
+            goto CLEANUP;
+        }
 
-    cuCtxSetCurrent(m_context);
+        /* Separate streams let all of the copies run at once. */
+        cuSt = cuStreamCreate(&peer.txStream, CU_STREAM_NON_BLOCKING);
+        if (cuSt == CUDA_SUCCESS)
+        {
+            cuSt = cuStreamCreate(&peer.rxStream, CU_STREAM_NON_BLOCKING);
+        }
 
-    cuSt = cuCtxEnablePeerAccess(deviceCtx1, 0);
-    if (cuSt)
-    {
-        m_error << "cuCtxEnablePeerAccess returned " << cuSt << '\n';
-        retSt = -1;
-        goto CLEANUP;
+        if (cuSt)
+        {
+            m_error << "cuStreamCreate returned " << cuSt << '\n';
+            retSt = -1;
+            goto CLEANUP;
+        }
     }
 
-    now       = timelib_dsecSince1970();
-    startTime = timelib_dsecSince1970();
-    tick      = startTime + m_reportInterval;
-    unsigned int i;
+    m_message << "Copying " << messageSize << " byte messages (" << direction << ") with " << peers.size()
+              << " peer(s)" << '\n';
+
+    now           = timelib_dsecSince1970();
+    startTime     = timelib_dsecSince1970();
+    tick          = startTime + m_reportInterval;
     prevPerSecond = 0.0;
     oneMiB        = 1000000;
 
@@ -1647,41 +1778,102 @@ int DistributedCudaContext::RunSubtestNvLinkBandwidth(void)
 
     for (unsigned int activity = 0; activity < activities; activity++)
     {
-        double howFarIn                 = 1.0 * activity / activities;
-        size_t bytesTransferred         = 0;
-        double startLoop                = now;
-        unsigned int copiesPerIteration = 10000; /* Set high. We are going to drop out every second anyway */
+        double howFarIn  = 1.0 * activity / activities;
+        double startLoop = now;
 
-        for (i = 0; i < copiesPerIteration && now - startLoop < m_reportInterval; i++)
+        for (auto &peer : peers)
         {
-            if (m_testFieldId == DCGM_FI_PROF_NVLINK_RX_BYTES)
+            peer.txBytes = 0;
+            peer.rxBytes = 0;
+        }
+
+        /**
+         * Refill each stream once it has drained. Bytes are counted when
+         * their copies complete, so copies still in flight at the end of an
+         * interval count toward the next one.
+         */
+        auto pump = [&](CUstream stream, unsigned int &inFlight, size_t &bytes, CUdeviceptr dst, CUdeviceptr src) {
+            CUresult queryCuSt = cuStreamQuery(stream);
+
+            if (queryCuSt == CUDA_ERROR_NOT_READY)
             {
-                cuSt = cuMemcpyDtoD(deviceMem0, deviceMem1, bufferSize);
+                return CUDA_SUCCESS;
             }
-            else /* DCGM_FI_PROF_NVLINK_TX_BYTES */
+
+            if (queryCuSt != CUDA_SUCCESS)
             {
-                cuSt = cuMemcpyDtoD(deviceMem1, deviceMem0, bufferSize);
+                return queryCuSt;
             }
 
-            bytesTransferred += bufferSize;
+            bytes += inFlight * messageSize;
+            inFlight = 0;
 
-            if (cuSt)
+            for (unsigned int copy = 0; copy < copiesPerQuery; copy++)
             {
-                m_error << "cuMemcpy returned " << cuSt << '\n';
-                retSt = -1;
-                goto CLEANUP;
+                CUresult copyCuSt = cuMemcpyDtoDAsync(dst, src, messageSize, stream);
+
+                if (copyCuSt != CUDA_SUCCESS)
+                {
+                    return copyCuSt;
+                }
+
+                inFlight++;
             }
 
+            return CUDA_SUCCESS;
+        };
+
+        while (now - startLoop < m_reportInterval)
+        {
+            for (auto &peer : peers)
+            {
+                cuSt = CUDA_SUCCESS;
+
+                if (doTx)
+                {
+                    cuSt = pump(peer.txStream, peer.txInFlight, peer.txBytes, peer.txBuffer, localTxBuffer);
+                }
+
+                if (doRx && (cuSt == CUDA_SUCCESS))
+                {
+                    cuSt = pump(peer.rxStream, peer.rxInFlight, peer.rxBytes, peer.localRxBuffer, peer.rxBuffer);
+                }
+
+                if (cuSt)
+                {
+                    m_error << "cuMemcpyDtoDAsync returned " << cuSt << " for busId " << peer.busId << '\n';
+                    retSt = -1;
+                    goto CLEANUP;
+                }
+            }
+
+            std::this_thread::yield();
+
             now = timelib_dsecSince1970();
         }
 
-
         double afterLoopDsec = timelib_dsecSince1970();
-        double perSecond     = (double)bytesTransferred / (afterLoopDsec - startLoop) / oneMiB;
+        double elapsed       = afterLoopDsec - startLoop;
+        double txPerSecond { 0.0 };
+        double rxPerSecond { 0.0 };
+        std::stringstream perLink;
+
+        for (auto &peer : peers)
+        {
+            double peerTx = (double)peer.txBytes / elapsed / oneMiB;
+            double peerRx = (double)peer.rxBytes / elapsed / oneMiB;
+
+            txPerSecond += peerTx;
+            rxPerSecond += peerRx;
+
+            perLink << std::fixed << std::setprecision(3) << " " << peerTx << " " << peerRx;
+        }
+
+        double perSecond = (m_testFieldId == DCGM_FI_PROF_NVLINK_RX_BYTES) ? rxPerSecond : txPerSecond;
 
         if (now > tick)
         {
-            Respond("T %0.3f %0.3f %0.3f\n", howFarIn, prevPerSecond, perSecond);
+            Respond("T %0.3f %0.3f %0.3f%s\n", howFarIn, prevPerSecond, perSecond, perLink.str().c_str());
 
             tick = now + m_reportInterval;
         }
@@ -1699,17 +1891,37 @@ int DistributedCudaContext::RunSubtestNvLinkBandwidth(void)
     }
 
 CLEANUP:
-    cuCtxDestroy(deviceCtx1);
+    cuCtxSetCurrent(m_context);
+    cuCtxSynchronize();
 
-    if (deviceMem0)
+    for (auto &peer : peers)
     {
-        cuMemFree(deviceMem0);
+        if (peer.txStream)
+        {
+            cuStreamDestroy(peer.txStream);
+        }
+        if (peer.rxStream)
+        {
+            cuStreamDestroy(peer.rxStream);
+        }
+        if (peer.localRxBuffer)
+        {
+            cuMemFree(peer.localRxBuffer);
+        }
+        if (peer.context)
+        {
+            /* Frees the peer buffers too */
+            cuCtxDestroy(peer.context);
+        }
     }
-    if (deviceMem1)
+
+    if (localTxBuffer)
     {
-        cuMemFree(deviceMem1);
+        cuMemFree(localTxBuffer);
     }
 
+    cuCtxSetCurrent(m_context);
+
     Respond((retSt == 0) ? "D 1 1\nP\n" : "F\n");
 
     return retSt;
@@ -1850,7 +2062,7 @@ int DistributedCudaContext::RunSubtestGemmUtil(void)
 {
     int retSt = 0;
 
-    size_t arrayDim     = 4096; /* Note that this is adjusted below for DCGM_FI_PROF_PIPE_TENSOR_ACTIVE */
+    size_t arrayDim     = 4096; /* Grown below until a single GEMM keeps the pipe busy long enough */
     CUdeviceptr deviceA = (CUdeviceptr)NULL;
     CUdeviceptr deviceB = (CUdeviceptr)NULL;
     CUdeviceptr deviceC = (CUdeviceptr)NULL;
@@ -1858,22 +2070,47 @@ int DistributedCudaContext::RunSubtestGemmUtil(void)
     void *hostB         = NULL;
     CUresult cuSt, cuSt2, cuSt3;
     cublasStatus_t cubSt;
+    cublasStatus_t cubLtSt      = CUBLAS_STATUS_SUCCESS;
     cublasHandle_t cublasHandle = NULL;
 
 #if (CUDA_VERSION_USED >= 11)
     cublasLtHandle_t cublasLtHandle = nullptr;
+    void *ltWorkspace               = nullptr;
+    size_t ltWorkspaceSize          = 0;
+    bool useLt { false };
+    DcgmNs::DcgmGemmPrecision ltPrecision { DcgmNs::DcgmGemmPrecision::Fp64 };
 #endif
 
-    size_t valueSize = 0;
+    size_t valueSize  = 0; /* A and B element size */
+    size_t outputSize = 0; /* C element size */
+    size_t arrayCount;
+    size_t arrayByteSize;
+    size_t outputByteSize;
+    size_t freeBytes { 0 };
+    size_t totalBytes { 0 };
+    double flopsPerOp { 0.0 };
+    double gemmSeconds { 0.0 };
+    std::string line;
+    std::string tensorPrecision { "fp16" };
     unsigned int i;
     auto duration           = m_duration;
     unsigned int activities = (duration + m_reportInterval / 2.0) / m_reportInterval;
 
+    /**
+     * A GEMM should run at least this long so that the gaps between them
+     * (launch and synchronization) cost little activity, on whole GPUs and
+     * small MIG slices alike.
+     */
+    const double minGemmSeconds = 0.01;
+    const size_t maxArrayDim    = 16384;
+
     double now, startTime, tick;
     double alpha     = 1.01 + ((double)(rand() % 100) / 10.0);
     double beta      = 1.01 + ((double)(rand() % 100) / 10.0);
     float floatAlpha = (float)alpha;
     float floatBeta  = (float)beta;
+    int32_t intAlpha = 1;
+    int32_t intBeta  = 1;
 
     /* Used https://en.wikipedia.org/wiki/Half-precision_floating-point_format
        to make these constants, as the cuda functions are device-side only */
@@ -1882,23 +2119,181 @@ int DistributedCudaContext::RunSubtestGemmUtil(void)
     __half fp16Alpha = oneAsHalf;
     __half fp16Beta  = oneAsHalf;
 
-    m_input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    /* Run one GEMM of the type under test. Returns false on error. */
+    auto runGemm = [&]() -> bool {
+#if (CUDA_VERSION_USED >= 11)
+        if (useLt)
+        {
+            bool isFp64 = (ltPrecision == DcgmNs::DcgmGemmPrecision::Fp64);
+            bool isInt8 = (ltPrecision == DcgmNs::DcgmGemmPrecision::Int8);
+
+            const void *ltAlpha = isFp64 ? (const void *)&alpha : isInt8 ? (const void *)&intAlpha : &floatAlpha;
+            const void *ltBeta  = isFp64 ? (const void *)&beta : isInt8 ? (const void *)&intBeta : &floatBeta;
+
+            cubLtSt = DcgmNs::DcgmGemm(cublasLtHandle,
+                                       ltPrecision,
+                                       CUBLAS_OP_N,
+                                       CUBLAS_OP_N,
+                                       arrayDim,
+                                       arrayDim,
+                                       arrayDim,
+                                       ltAlpha,
+                                       (void *)deviceA,
+                                       arrayDim,
+                                       (void *)deviceB,
+                                       arrayDim,
+                                       ltBeta,
+                                       (void *)deviceC,
+                                       arrayDim,
+                                       ltWorkspace,
+                                       ltWorkspaceSize);
+
+            if (cubLtSt != CUBLAS_STATUS_SUCCESS)
+            {
+                m_error << "cublasLt gemm returned " << cubLtSt << '\n';
+                return false;
+            }
+
+            return true;
+        }
+#endif
+
+        switch (m_testFieldId)
+        {
+            case DCGM_FI_PROF_PIPE_FP32_ACTIVE:
+                cubSt = CublasProxy::CublasSgemm(cublasHandle,
+                                                 CUBLAS_OP_N,
+                                                 CUBLAS_OP_N,
+                                                 arrayDim,
+                                                 arrayDim,
+                                                 arrayDim,
+                                                 &floatAlpha,
+                                                 (float *)deviceA,
+                                                 arrayDim,
+                                                 (float *)deviceB,
+                                                 arrayDim,
+                                                 &floatBeta,
+                                                 (float *)deviceC,
+                                                 arrayDim);
+                break;
+
+            case DCGM_FI_PROF_PIPE_FP64_ACTIVE:
+                cubSt = CublasProxy::CublasDgemm(cublasHandle,
+                                                 CUBLAS_OP_N,
+                                                 CUBLAS_OP_N,
+                                                 arrayDim,
+                                                 arrayDim,
+                                                 arrayDim,
+                                                 &alpha,
+                                                 (double *)deviceA,
+                                                 arrayDim,
+                                                 (double *)deviceB,
+                                                 arrayDim,
+                                                 &beta,
+                                                 (double *)deviceC,
+                                                 arrayDim);
+                break;
+
+            case DCGM_FI_PROF_PIPE_FP16_ACTIVE:
+            case DCGM_FI_PROF_PIPE_TENSOR_ACTIVE:
+                cubSt = CublasProxy::CublasHgemm(cublasHandle,
+                                                 CUBLAS_OP_N,
+                                                 CUBLAS_OP_N,
+                                                 arrayDim,
+                                                 arrayDim,
+                                                 arrayDim,
+                                                 &fp16Alpha,
+                                                 (__half *)deviceA,
+                                                 arrayDim,
+                                                 (__half *)deviceB,
+                                                 arrayDim,
+                                                 &fp16Beta,
+                                                 (__half *)deviceC,
+                                                 arrayDim);
+                break;
+
+            default:
+                m_error << "Shouldn't get here." << '\n';
+                return false;
+        }
+
+        if (cubSt != CUBLAS_STATUS_SUCCESS)
+        {
+            m_error << "cublas gemm returned " << cubSt << '\n';
+            return false;
+        }
+
+        return true;
+    };
+
+    /* An optional tensor precision follows the common parameters. */
+    std::getline(m_input, line);
+    {
+        std::stringstream params(line);
+        params >> tensorPrecision;
+    }
 
     switch (m_testFieldId)
     {
         case DCGM_FI_PROF_PIPE_FP32_ACTIVE:
-            valueSize = sizeof(float);
+            valueSize  = sizeof(float);
+            outputSize = sizeof(float);
             break;
         case DCGM_FI_PROF_PIPE_FP64_ACTIVE:
-            valueSize = sizeof(double);
+            valueSize  = sizeof(double);
+            outputSize = sizeof(double);
+#if (CUDA_VERSION_USED >= 11)
+            useLt       = true;
+            ltPrecision = DcgmNs::DcgmGemmPrecision::Fp64;
+#endif
             break;
         case DCGM_FI_PROF_PIPE_FP16_ACTIVE:
-            valueSize = sizeof(unsigned short);
+            valueSize  = sizeof(unsigned short);
+            outputSize = sizeof(unsigned short);
             break;
         case DCGM_FI_PROF_PIPE_TENSOR_ACTIVE:
-            arrayDim *= 2; /* Needed to saturate V100, A100 on cuda 11.1 */
-            valueSize = sizeof(unsigned short);
+            if (tensorPrecision == "fp16")
+            {
+                // cublasHgemm with Tensor Core math
+                valueSize  = sizeof(unsigned short);
+                outputSize = sizeof(unsigned short);
+                break;
+            }
+#if (CUDA_VERSION_USED >= 11)
+            else if (tensorPrecision == "bf16")
+            {
+                valueSize   = sizeof(unsigned short);
+                outputSize  = sizeof(unsigned short);
+                ltPrecision = DcgmNs::DcgmGemmPrecision::Bf16;
+            }
+            else if (tensorPrecision == "tf32")
+            {
+                valueSize   = sizeof(float);
+                outputSize  = sizeof(float);
+                ltPrecision = DcgmNs::DcgmGemmPrecision::Tf32;
+            }
+            else if (tensorPrecision == "int8")
+            {
+                valueSize   = sizeof(int8_t);
+                outputSize  = sizeof(int32_t);
+                ltPrecision = DcgmNs::DcgmGemmPrecision::Int8;
+            }
+            else
+            {
+                m_error << "tensor precision " << tensorPrecision << " is unhandled." << '\n';
+                Respond("F\n");
+
+                return -1;
+            }
+
+            useLt = true;
             break;
+#else
+            m_error << "tensor precision " << tensorPrecision << " requires CUDA 11." << '\n';
+            Respond("F\n");
+
+            return -1;
+#endif
         default:
             m_error << "fieldId " << m_testFieldId << " is unhandled." << '\n';
             Respond("F\n");
@@ -1906,13 +2301,10 @@ int DistributedCudaContext::RunSubtestGemmUtil(void)
             return -1;
     }
 
-    double flopsPerOp    = 2.0 * (double)arrayDim * (double)arrayDim * (double)arrayDim;
-    size_t arrayCount    = arrayDim * arrayDim;
-    size_t arrayByteSize = valueSize * arrayCount;
-
-    cubSt = CublasProxy::CublasCreate(&cublasHandle);
+    /* Cached by the proxy, so later subtests on this device reuse them */
+    cubSt = CublasProxy::CublasGetCachedHandle(nullptr, &cublasHandle);
 #if (CUDA_VERSION_USED >= 11)
-    auto cubLtSt = CublasProxy::CublasLtCreate(&cublasLtHandle);
+    cubLtSt = CublasProxy::CublasLtGetCachedHandle(nullptr, &cublasLtHandle, &ltWorkspace, &ltWorkspaceSize);
 #endif
 
     if (cubSt != CUBLAS_STATUS_SUCCESS)
@@ -1931,43 +2323,60 @@ int DistributedCudaContext::RunSubtestGemmUtil(void)
     }
 #endif
 
-    /* Once we've allocated memory, goto CLEANUP instead of returning  */
-
-    cuSt  = cuMemAlloc(&deviceA, arrayByteSize);
-    cuSt2 = cuMemAlloc(&deviceB, arrayByteSize);
-    cuSt3 = cuMemAlloc(&deviceC, arrayByteSize);
-    if (cuSt || cuSt2 || cuSt3)
+    /* Should we enable tensor cores? */
+    if (m_testFieldId == DCGM_FI_PROF_PIPE_TENSOR_ACTIVE)
     {
-        m_error << "cuMemAlloc returned " << cuSt << " " << cuSt2 << " " << cuSt3 << " for " << (int)arrayByteSize
-                << '\n';
-        retSt = -1;
-        goto CLEANUP;
+        cubSt = CublasProxy::CublasSetMathMode(cublasHandle, CUBLAS_TENSOR_OP_MATH);
     }
-
-    hostA = malloc(arrayByteSize);
-    hostB = malloc(arrayByteSize);
-    if (!hostA || !hostB)
+    else
     {
-        m_error << "Unable to allocate " << (int)arrayByteSize << " bytes x2" << '\n';
+#if (CUDA_VERSION_USED < 11)
+        cubSt = CublasProxy::CublasSetMathMode(cublasHandle, CUBLAS_DEFAULT_MATH);
+#else
+        cubSt = CublasProxy::CublasSetMathMode(cublasHandle, CUBLAS_PEDANTIC_MATH);
+#endif
+    }
+    if (cubSt != CUBLAS_STATUS_SUCCESS)
+    {
+        m_error << "cublasSetMathMode returned " << cubSt << '\n';
         retSt = -1;
         goto CLEANUP;
     }
 
-    switch (m_testFieldId)
+    /**
+     * Size the matrices. We double the dimension until a GEMM takes
+     * minGemmSeconds, or the next size would not fit in half of the free
+     * memory.
+     */
+    for (;;)
     {
-        case DCGM_FI_PROF_PIPE_FP32_ACTIVE:
+        arrayCount     = arrayDim * arrayDim;
+        arrayByteSize  = valueSize * arrayCount;
+        outputByteSize = outputSize * arrayCount;
+
+        /* Once we've allocated memory, goto CLEANUP instead of returning  */
+
+        cuSt  = cuMemAlloc(&deviceA, arrayByteSize);
+        cuSt2 = cuMemAlloc(&deviceB, arrayByteSize);
+        cuSt3 = cuMemAlloc(&deviceC, outputByteSize);
+        if (cuSt || cuSt2 || cuSt3)
         {
-            float *floatHostA = (float *)hostA;
-            float *floatHostB = (float *)hostB;
-            for (i = 0; i < arrayCount; i++)
-            {
-                floatHostA[i] = (float)rand() / 100.0;
-                floatHostB[i] = (float)rand() / 100.0;
-            }
-            break;
+            m_error << "cuMemAlloc returned " << cuSt << " " << cuSt2 << " " << cuSt3 << " for " << (int)arrayByteSize
+                    << '\n';
+            retSt = -1;
+            goto CLEANUP;
         }
 
-        case DCGM_FI_PROF_PIPE_FP64_ACTIVE:
+        hostA = malloc(arrayByteSize);
+        hostB = malloc(arrayByteSize);
+        if (!hostA || !hostB)
+        {
+            m_error << "Unable to allocate " << (int)arrayByteSize << " bytes x2" << '\n';
+            retSt = -1;
+            goto CLEANUP;
+        }
+
+        if (valueSize == sizeof(double))
         {
             double *doubleHostA = (double *)hostA;
             double *doubleHostB = (double *)hostB;
@@ -1977,66 +2386,95 @@ int DistributedCudaContext::RunSubtestGemmUtil(void)
                 doubleHostA[i] = (double)rand() / 100.0;
                 doubleHostB[i] = (double)rand() / 100.0;
             }
-            break;
         }
-
-        case DCGM_FI_PROF_PIPE_FP16_ACTIVE:
-        case DCGM_FI_PROF_PIPE_TENSOR_ACTIVE:
+        else if (valueSize == sizeof(float))
         {
-            __half *halfHostA = (__half *)hostA;
-            __half *halfHostB = (__half *)hostB;
-            __half_raw rawA, rawB;
+            float *floatHostA = (float *)hostA;
+            float *floatHostB = (float *)hostB;
 
             for (i = 0; i < arrayCount; i++)
             {
-                rawA.x = rand() % 65536;
-                rawB.x = rand() % 65536;
+                floatHostA[i] = (float)rand() / 100.0;
+                floatHostB[i] = (float)rand() / 100.0;
+            }
+        }
+        else
+        {
+            /* FP16, BF16 and INT8: any bit pattern will do */
+            unsigned char *byteHostA = (unsigned char *)hostA;
+            unsigned char *byteHostB = (unsigned char *)hostB;
 
-                halfHostA[i] = rawA;
-                halfHostB[i] = rawB;
+            for (i = 0; i < arrayByteSize; i++)
+            {
+                byteHostA[i] = rand() % 256;
+                byteHostB[i] = rand() % 256;
             }
-            break;
         }
 
-        default:
-            m_error << "fieldId " << m_testFieldId << "  is unhandled." << '\n';
+        /* Just zero the output array */
+        cuMemsetD8(deviceC, 0, outputByteSize);
+
+        /* Copy A and B to the device */
+        cuSt  = cuMemcpyHtoD(deviceA, hostA, arrayByteSize);
+        cuSt2 = cuMemcpyHtoD(deviceB, hostB, arrayByteSize);
+        if (cuSt || cuSt2)
+        {
+            m_error << "cuMemcpyHtoD failed " << cuSt << " " << cuSt2 << '\n';
             retSt = -1;
             goto CLEANUP;
-    }
+        }
 
-    /* Just zero the output array */
-    cuMemsetD32(deviceC, 0, arrayByteSize);
+        /* Time one GEMM, after a warm-up one */
+        if (!runGemm())
+        {
+            retSt = -1;
+            goto CLEANUP;
+        }
 
-    /* Copy A and B to the device */
-    cuSt  = cuMemcpyHtoD(deviceA, hostA, arrayByteSize);
-    cuSt2 = cuMemcpyHtoD(deviceB, hostB, arrayByteSize);
-    if (cuSt || cuSt2)
-    {
-        m_error << "cuMemcpyHtoD failed " << cuSt << " " << cuSt2 << '\n';
-        retSt = -1;
-        goto CLEANUP;
-    }
+        cuCtxSynchronize();
+        now = timelib_dsecSince1970();
 
-    /* Should we enable tensor cores? */
-    if (m_testFieldId == DCGM_FI_PROF_PIPE_TENSOR_ACTIVE)
-    {
-        cubSt = CublasProxy::CublasSetMathMode(cublasHandle, CUBLAS_TENSOR_OP_MATH);
-    }
-    else
-    {
-#if (CUDA_VERSION_USED < 11)
-        cubSt = CublasProxy::CublasSetMathMode(cublasHandle, CUBLAS_DEFAULT_MATH);
-#else
-        cubSt = CublasProxy::CublasSetMathMode(cublasHandle, CUBLAS_PEDANTIC_MATH);
-#endif
-    }
-    if (cubSt != CUBLAS_STATUS_SUCCESS)
-    {
-        m_error << "cublasSetMathMode returned " << cubSt << '\n';
-        retSt = -1;
-        goto CLEANUP;
+        if (!runGemm())
+        {
+            retSt = -1;
+            goto CLEANUP;
+        }
+
+        cuCtxSynchronize();
+        gemmSeconds = timelib_dsecSince1970() - now;
+
+        if ((gemmSeconds >= minGemmSeconds) || (arrayDim >= maxArrayDim))
+        {
+            break;
+        }
+
+        /* The next size needs four times the memory we have now. */
+        size_t inUse = 2 * arrayByteSize + outputByteSize;
+
+        if ((cuMemGetInfo(&freeBytes, &totalBytes) != CUDA_SUCCESS) || (4 * inUse > (freeBytes + inUse) / 2))
+        {
+            break;
+        }
+
+        cuMemFree(deviceA);
+        cuMemFree(deviceB);
+        cuMemFree(deviceC);
+        free(hostA);
+        free(hostB);
+        deviceA = (CUdeviceptr)NULL;
+        deviceB = (CUdeviceptr)NULL;
+        deviceC = (CUdeviceptr)NULL;
+        hostA   = NULL;
+        hostB   = NULL;
+
+        arrayDim *= 2;
     }
 
+    flopsPerOp = 2.0 * (double)arrayDim * (double)arrayDim * (double)arrayDim;
+
+    m_message << "GEMM dimension " << arrayDim << " (" << tensorPrecision << " tensor precision) takes " << std::fixed
+              << std::setprecision(3) << gemmSeconds * 1000.0 << " ms." << '\n';
+
     /* deviceA and deviceB now have our matricies. Run our test */
 
     now       = timelib_dsecSince1970();
@@ -2051,98 +2489,11 @@ int DistributedCudaContext::RunSubtestGemmUtil(void)
 
         for (i = 0; i < opsPerIteration && now - startLoop < m_reportInterval; i++)
         {
-            switch (m_testFieldId)
-            {
-                case DCGM_FI_PROF_PIPE_FP32_ACTIVE:
-                    cubSt = CublasProxy::CublasSgemm(cublasHandle,
-                                                     CUBLAS_OP_N,
-                                                     CUBLAS_OP_N,
-                                                     arrayDim,
-                                                     arrayDim,
-                                                     arrayDim,
-                                                     &floatAlpha,
-                                                     (float *)deviceA,
-                                                     arrayDim,
-                                                     (float *)deviceB,
-                                                     arrayDim,
-                                                     &floatBeta,
-                                                     (float *)deviceC,
-                                                     arrayDim);
-                    break;
-
-                case DCGM_FI_PROF_PIPE_FP64_ACTIVE:
-#if (CUDA_VERSION_USED >= 11)
-                    cubLtSt = DcgmNs::DcgmDgemm(cublasLtHandle,
-                                                CUBLAS_OP_N,
-                                                CUBLAS_OP_N,
-                                                arrayDim,
-                                                arrayDim,
-                                                arrayDim,
-                                                &alpha,
-                                                (double *)deviceA,
-                                                arrayDim,
-                                                (double *)deviceB,
-                                                arrayDim,
-                                                &beta,
-                                                (double *)deviceC,
-                                                arrayDim);
-#else
-                    cubSt = CublasProxy::CublasDgemm(cublasHandle,
-                                                     CUBLAS_OP_N,
-                                                     CUBLAS_OP_N,
-                                                     arrayDim,
-                                                     arrayDim,
-                                                     arrayDim,
-                                                     &alpha,
-                                                     (double *)deviceA,
-                                                     arrayDim,
-                                                     (double *)deviceB,
-                                                     arrayDim,
-                                                     &beta,
-                                                     (double *)deviceC,
-                                                     arrayDim);
-#endif
-                    break;
-
-                case DCGM_FI_PROF_PIPE_FP16_ACTIVE:
-                case DCGM_FI_PROF_PIPE_TENSOR_ACTIVE:
-                    cubSt = CublasProxy::CublasHgemm(cublasHandle,
-                                                     CUBLAS_OP_N,
-                                                     CUBLAS_OP_N,
-                                                     arrayDim,
-                                                     arrayDim,
-                                                     arrayDim,
-                                                     &fp16Alpha,
-                                                     (__half *)deviceA,
-                                                     arrayDim,
-                                                     (__half *)deviceB,
-                                                     arrayDim,
-                                                     &fp16Beta,
-                                                     (__half *)deviceC,
-                                                     arrayDim);
-                    break;
-
-                default:
-                    m_error << "Shouldn't get here." << '\n';
-                    retSt = -1;
-                    goto CLEANUP;
-            }
-
-            if (cubSt != CUBLAS_STATUS_SUCCESS)
-            {
-                m_error << "cublas gemm returned " << cubSt << '\n';
-                retSt = -1;
-                goto CLEANUP;
-            }
-
-#if (CUDA_VERSION_USED >= 11)
-            if (cubLtSt != CUBLAS_STATUS_SUCCESS)
+            if (!runGemm())
             {
-                m_error << "cublasLt gemm returned " << cubLtSt << '\n';
                 retSt = -1;
                 goto CLEANUP;
             }
-#endif
 
             /* Wait for this kernel to finish */
             cuCtxSynchronize();
@@ -2183,17 +2534,153 @@ CLEANUP:
     if (hostB)
         free(hostB);
 
-    CublasProxy::CublasDestroy(cublasHandle);
-
-#if (CUDA_VERSION_USED >= 11)
-    CublasProxy::CublasLtDestroy(cublasLtHandle);
-#endif
-
     Respond((retSt == 0) ? "D 1 1\nP\n" : "F\n");
 
     return retSt;
 }
 
+// Follow a load profile.
+int DistributedCudaContext::RunSubtestLoadProfile(void)
+{
+    /* Generate SM activity following a target curve */
+
+    using Clock   = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    CUevent startEvent { nullptr };
+    CUevent stopEvent { nullptr };
+    int retSt { 0 };
+
+    Respond("S\nD 0 1\n");
+
+    if ((cuEventCreate(&startEvent, CU_EVENT_DEFAULT) != CUDA_SUCCESS)
+        || (cuEventCreate(&stopEvent, CU_EVENT_DEFAULT) != CUDA_SUCCESS))
+    {
+        m_error << "cuEventCreate failed for load profile " << m_loadProfile.Spec() << '\n';
+
+        if (startEvent != nullptr)
+        {
+            cuEventDestroy(startEvent);
+        }
+
+        Respond("F\n");
+
+        return -1;
+    }
+
+    /**
+     * Time is divided into slots. In each, a kernel runs on all SMs for the
+     * target fraction of the slot, and we then wait for the end of the slot.
+     * Slot deadlines are absolute on a monotonic clock so launch and
+     * synchronization overheads do not accumulate as drift. Kernel run time
+     * is measured with events, so the achieved activity excludes launch
+     * latency.
+     */
+    double slot       = std::min(0.01, std::max(0.001, m_reportInterval / 100.0));
+    auto slotDuration = std::chrono::duration_cast<Clock::duration>(Seconds(slot));
+    auto startTime    = Clock::now();
+    auto endTime      = startTime + std::chrono::duration_cast<Clock::duration>(Seconds(m_duration));
+    auto reportTime   = std::chrono::duration_cast<Clock::duration>(Seconds(m_reportInterval));
+    auto deadline     = startTime;
+    auto tick         = startTime + reportTime;
+    auto tickStart    = startTime;
+
+    double tickTarget { 0.0 }; // target activity-seconds this report interval
+    double tickBusy { 0.0 };   // achieved activity-seconds this report interval
+    unsigned int tickSlots { 0 };
+    unsigned int slots { 0 };
+    unsigned int lateSlots { 0 };
+
+    unsigned int reports { 0 };
+    double sumError { 0.0 };
+    double sumSquaredError { 0.0 };
+    double maxError { 0.0 };
+
+    while (deadline < endTime)
+    {
+        double target              = m_loadProfile.TargetAt(Seconds(deadline - startTime).count());
+        unsigned int runKernelUsec = (unsigned int)(target * slot * 1000000.0);
+
+        if (runKernelUsec > 0)
+        {
+            cuEventRecord(startEvent, nullptr);
+
+            if ((retSt = RunSleepKernel(m_attributes.m_multiProcessorCount, 1, runKernelUsec)) != 0)
+            {
+                break;
+            }
+
+            cuEventRecord(stopEvent, nullptr);
+        }
+
+        tickTarget += target * slot;
+        tickSlots++;
+        slots++;
+        deadline += slotDuration;
+
+        std::this_thread::sleep_until(deadline);
+
+        if (runKernelUsec > 0)
+        {
+            float ms { 0.0 };
+
+            cuEventSynchronize(stopEvent);
+            cuEventElapsedTime(&ms, startEvent, stopEvent);
+            tickBusy += ms / 1000.0;
+        }
+
+        auto now = Clock::now();
+
+        // A kernel overran its slot. Resume the schedule rather than burst.
+        if (now > (deadline + slotDuration))
+        {
+            deadline = now;
+            lateSlots++;
+        }
+
+        if (now >= tick)
+        {
+            double targetActivity   = tickTarget / (tickSlots * slot);
+            double achievedActivity = std::min(1.0, tickBusy / Seconds(now - tickStart).count());
+            double error            = achievedActivity - targetActivity;
+
+            Respond("T %0.3f %0.3f %0.3f\n", targetActivity, achievedActivity, Seconds(now - startTime).count());
+
+            reports++;
+            sumError += error;
+            sumSquaredError += error * error;
+            maxError = std::max(maxError, std::fabs(error));
+
+            tickTarget = 0.0;
+            tickBusy   = 0.0;
+            tickSlots  = 0;
+            tickStart  = now;
+            tick       = now + reportTime;
+        }
+    }
+
+    cuCtxSynchronize();
+    cuEventDestroy(startEvent);
+    cuEventDestroy(stopEvent);
+
+    if (retSt)
+    {
+        return retSt;
+    }
+
+    if (reports > 0)
+    {
+        m_message << "Load profile " << m_loadProfile.Spec() << ": achieved-target error mean " << std::fixed
+                  << std::setprecision(4) << sumError / reports << ", RMS " << std::sqrt(sumSquaredError / reports)
+                  << ", max " << maxError << " over " << reports << " reports; " << lateSlots << " of " << slots
+                  << " slots overran." << '\n';
+    }
+
+    Respond("D 1 1\nP\n");
+
+    return 0;
+}
+
 // Dispatch test to be run.
 int DistributedCudaContext::RunTest(void)
 {
@@ -2222,6 +2709,19 @@ int DistributedCudaContext::RunTest(void)
 
     m_message << "CU_DEVICE_ATTRIBUTE_ECC_SUPPORT: " << ((m_attributes.m_eccSupport > 0) ? "true" : "false") << '\n';
 
+    if ((retSt = ParseLoadProfile()) < 0)
+    {
+        m_error << "bad load profile for test " << m_testFieldId << '\n';
+        Respond("F\n");
+
+        return retSt;
+    }
+
+    if (m_loadProfile.IsEnabled())
+    {
+        return RunSubtestLoadProfile();
+    }
+
     switch (m_testFieldId)
     {
         case DCGM_FI_PROF_GR_ENGINE_ACTIVE:
@@ -2277,15 +2777,38 @@ int DistributedCudaContext::RunTest(void)
 }
 
 
+// Parse an optional load profile following the common test parameters.
+int DistributedCudaContext::ParseLoadProfile(void)
+{
+    auto pos = m_input.tellg();
+    std::string keyword;
+    std::string spec;
+
+    if ((m_input >> keyword) && (keyword == "profile") && (m_input >> spec))
+    {
+        m_input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+        return (m_loadProfile.Parse(spec) == DCGM_ST_OK) ? 0 : -1;
+    }
+
+    // Not ours: leave the test-specific parameters for the subtest.
+    m_input.clear();
+    m_input.seekg(pos);
+    m_loadProfile.Parse("");
+
+    return 0;
+}
+
+
 // Are we already running?
 bool DistributedCudaContext::IsRunning(void) const
 {
-    return m_pid != 0;
+    return (m_pid != 0) || m_inProcess;
 }
 
 
-// Run a test in a sub-process.
-int DistributedCudaContext::Run(void)
+// Run a test in a sub-process, or a worker thread if requested.
+int DistributedCudaContext::Run(bool inProcess)
 {
     int retSt = 0;
     int toChildPipe[2];  // parent writes to this, child reads from this
@@ -2311,6 +2834,16 @@ int DistributedCudaContext::Run(void)
      */
     Reset(true);
 
+    /**
+     * CUDA_VISIBLE_DEVICES must be set before cuInit() to select a MIG
+     * instance and applies to the whole process, so MIG workers are always
+     * forked.
+     */
+    if (inProcess && m_cudaVisibleDevices.empty())
+    {
+        return RunThread(toChildPipe, toParentPipe);
+    }
+
     pid_t pid = fork();
 
     if (pid < 0) // error
@@ -2371,6 +2904,22 @@ int DistributedCudaContext::Run(void)
         m_failed = true;
     }
 
+    if ((retSt = ProcessCommands()) < 0)
+    {
+        return retSt;
+    }
+
+    Reset();
+
+    exit(0);
+}
+
+
+// Run worker commands until told to exit. Called in the worker.
+int DistributedCudaContext::ProcessCommands(void)
+{
+    int retSt = 0;
+
     try
     {
         /* Tell parent we are ready for commands and convey our initialization
@@ -2396,6 +2945,12 @@ int DistributedCudaContext::Run(void)
             }
             else if (retSt == 0)
             {
+                if (m_stop)
+                {
+                    // Our parent (in this process) went away.
+                    return 0;
+                }
+
                 usleep(50);
 
                 continue;
@@ -2466,9 +3021,99 @@ int DistributedCudaContext::Run(void)
         return -((int)DCGM_ST_GENERIC_ERROR);
     }
 
-    Reset();
+    return 0;
+}
 
-    exit(0);
+
+// Run a test on a worker thread in this process.
+int DistributedCudaContext::RunThread(int toChildPipe[2], int toParentPipe[2])
+{
+    int st = 0;
+
+    // A previous worker thread was told to exit. Wait for it.
+    JoinWorkerThread();
+
+    /**
+     * Both ends of the pipes are in this process. Ignore SIGPIPE so that a
+     * worker thread whose parent side was reset fails its next response
+     * instead of killing us.
+     */
+    struct sigaction sa;
+    sa.sa_handler = SIG_IGN;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    if (sigaction(SIGPIPE, &sa, 0) == -1)
+    {
+        st = -1;
+    }
+
+    m_inFd  = toParentPipe[0];
+    m_outFd = toChildPipe[1];
+
+    // Make I/O in parent non-blocking.
+    if ((st == 0) && ((fcntl(m_inFd, F_SETFL, O_NONBLOCK) == -1) || (fcntl(m_outFd, F_SETFL, O_NONBLOCK) == -1)))
+    {
+        st = -1;
+    }
+
+    if (st == 0)
+    {
+        try
+        {
+            m_worker.reset(new DistributedCudaContext(m_physicalGpu, m_entities, m_entity));
+
+            int inFd  = toChildPipe[0];
+            int outFd = toParentPipe[1];
+
+            m_workerThread = std::thread([worker = m_worker.get(), inFd, outFd]() {
+                if (worker->Init(inFd, outFd) != DCGM_ST_OK)
+                {
+                    worker->m_error << "failed to initialize, waiting to be told to exit." << '\n';
+                    worker->m_failed = true;
+                }
+
+                worker->ProcessCommands();
+                worker->Reset();
+            });
+        }
+        catch (...)
+        {
+            m_worker = nullptr;
+            st       = -1;
+        }
+    }
+
+    if (st != 0)
+    {
+        close(toChildPipe[0]);
+        close(toParentPipe[1]);
+
+        return st;
+    }
+
+    m_inProcess = true;
+    m_input.str("");
+    m_input.clear();
+
+    return 0; // monitor and wait for worker thread
+}
+
+
+// Stop and join the worker thread, if any. Called in the parent.
+void DistributedCudaContext::JoinWorkerThread(void)
+{
+    if (m_worker != nullptr)
+    {
+        m_worker->m_stop = true;
+    }
+
+    if (m_workerThread.joinable())
+    {
+        m_workerThread.join();
+    }
+
+    m_worker    = nullptr;
+    m_inProcess = false;
 }
 
 } // namespace DcgmNs::ProfTester
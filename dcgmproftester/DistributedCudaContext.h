@@ -15,8 +15,10 @@
  */
 #pragma once
 
+#include "LoadProfile.h"
 #include <dcgm_structs.h>
 
+#include <atomic>
 #include <cstdarg>
 #include <cuda.h>
 #include <map>
@@ -24,6 +26,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 /* DCGM Distributed Cuda Context
@@ -96,6 +99,14 @@
  * signal, uncerimoniously closing the pipe (say on the unexpected exit of a
  * crashed peer process) will cause the current process to crash instead of
  * leaving behind a zombie. This is currently intentional. It should not happen.
+ *
+ * Alternatively, the worker can be run on a thread in the DCGM parent process
+ * (one thread and CUDA context per entity). The same pipe protocol is used,
+ * so the parent side is unchanged, but no process is forked and the CUDA
+ * driver is only initialized once. Because CUDA_VISIBLE_DEVICES can not be
+ * set per thread, MIG entities are always run in a forked worker process.
+ * SIGPIPE is ignored in thread mode, so a closed pipe is reported as an
+ * error on the peer instead.
  */
 
 namespace DcgmNs::ProfTester
@@ -218,10 +229,15 @@ public:
      * the worker process. It establishes the communication pipes and file
      * descriptors in both parent and worker process.
      *
+     * @param inProcess A bool to run the worker on a thread in this process
+     *                  instead of forking a worker process. It is ignored for
+     *                  MIG entities. Default is false.
+     *
      * @return An int is returned, negative for error, zero in the worker
-     *          process, and the process ID in the parent process.
+     *          process, and the process ID (or zero for a worker thread) in
+     *          the parent process.
      */
-    int Run(void);
+    int Run(bool inProcess = false);
 
     /**
      * \brief Is the worker already running?
@@ -616,6 +632,7 @@ private:
     int RunSubtestNvLinkBandwidth(void);
     int RunSubtestDramUtil(void);
     int RunSubtestGemmUtil(void);
+    int RunSubtestLoadProfile(void);
 
     /**@}*/
 
@@ -630,6 +647,37 @@ private:
      */
     int RunTest(void);
 
+    /**
+     * \brief Parse an optional "profile <spec>" after the common parameters.
+     *
+     * @return An int is returned, negative if the profile is malformed, zero
+     *          otherwise.
+     */
+    int ParseLoadProfile(void);
+
+    /**@}*/
+
+    /** @name WorkerLoop
+     * Worker command loop, shared by worker processes and worker threads.
+     * @{
+     */
+
+    // Worker-side context for a worker thread. No DCGM groups are created.
+    DistributedCudaContext(std::shared_ptr<DcgmNs::ProfTester::PhysicalGpu>,
+                           std::shared_ptr<std::map<dcgm_field_entity_group_t, dcgm_field_eid_t>>,
+                           const dcgmGroupEntityPair_t &);
+
+    /**
+     * \brief Process commands from the parent until told to exit.
+     *
+     * @return An int is returned, negative on a catastrophic error, zero
+     *          otherwise.
+     */
+    int ProcessCommands(void);
+
+    int RunThread(int toChildPipe[2], int toParentPipe[2]); // Start worker thread
+    void JoinWorkerThread(void);                            // Stop & join worker thread
+
     /**@}*/
 
     /** @name DataMembers
@@ -697,6 +745,7 @@ private:
 
     // These only make sense on the parent side, controlling the worker.
     int m_pid { 0 };            //<! worker process pid
+    bool m_inProcess { false }; //<! worker is a thread in this process
     unsigned int m_tries { 0 }; //<! synchronous tries available
     unsigned int m_part { 0 };  //<! worker process part complete
     unsigned int m_parts { 0 }; //<! worker process total parts
@@ -706,6 +755,11 @@ private:
     bool m_buffered { false };  //<! we have buffered data to process.
     bool m_finished { false };  //<! worker is finished
 
+    // These only make sense in thread mode.
+    std::unique_ptr<DistributedCudaContext> m_worker; //<! worker-side context
+    std::thread m_workerThread {};                    //<! worker thread
+    std::atomic<bool> m_stop { false };               //<! worker should exit
+
     /**@}*/
 
     /** @name PerTestParameters
@@ -729,6 +783,12 @@ private:
      */
     bool m_targetMaxValue { false };
 
+    /**
+     * Target activity curve to follow instead of the usual stair steps, if
+     * the test command specified one.
+     */
+    LoadProfile m_loadProfile {};
+
     /**@}*/
 };
 
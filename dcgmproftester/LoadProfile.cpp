@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "LoadProfile.h"
+
+#include "DcgmLogging.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace DcgmNs::ProfTester
+{
+namespace
+{
+/* Parse a number, requiring the whole token to be consumed. */
+bool ParseNumber(const std::string &token, double &value)
+{
+    char *end { nullptr };
+
+    value = strtod(token.c_str(), &end);
+
+    return !token.empty() && (*end == '\0') && std::isfinite(value);
+}
+} // namespace
+
+
+dcgmReturn_t LoadProfile::Parse(const std::string &spec)
+{
+    m_shape = Shape::None;
+    m_spec  = spec;
+    m_trace.clear();
+
+    if (spec.empty())
+    {
+        return DCGM_ST_OK;
+    }
+
+    std::vector<std::string> tokens;
+    std::stringstream ss(spec);
+    std::string token;
+
+    while (std::getline(ss, token, ':'))
+    {
+        tokens.push_back(token);
+    }
+
+    if (tokens[0] == "trace")
+    {
+        if (tokens.size() < 2)
+        {
+            DCGM_LOG_ERROR << "Load profile " << spec << " does not name a trace file";
+
+            return DCGM_ST_BADPARAM;
+        }
+
+        // The path may itself contain colons.
+        dcgmReturn_t ret = LoadTrace(spec.substr(tokens[0].length() + 1));
+
+        if (ret == DCGM_ST_OK)
+        {
+            m_shape = Shape::Trace;
+        }
+
+        return ret;
+    }
+
+    std::vector<double> values;
+
+    for (size_t i = 1; i < tokens.size(); i++)
+    {
+        double value;
+
+        if (!ParseNumber(tokens[i], value))
+        {
+            DCGM_LOG_ERROR << "Load profile " << spec << " has a bad number " << tokens[i];
+
+            return DCGM_ST_BADPARAM;
+        }
+
+        values.push_back(value);
+    }
+
+    size_t levels { 0 };
+
+    if ((tokens[0] == "square") && ((values.size() == 2) || (values.size() == 4)))
+    {
+        m_duty = values[1];
+        levels = 2;
+    }
+    else if ((tokens[0] == "ramp") && ((values.size() == 1) || (values.size() == 3)))
+    {
+        m_duty = 1.0;
+        levels = 1;
+    }
+    else
+    {
+        DCGM_LOG_ERROR << "Load profile " << spec
+                       << " must be one of square:<period>:<duty>[:<low>:<high>], ramp:<period>[:<low>:<high>]"
+                       << " or trace:<file>";
+
+        return DCGM_ST_BADPARAM;
+    }
+
+    m_period = values[0];
+    m_low    = (values.size() > levels) ? values[levels] : 0.0;
+    m_high   = (values.size() > levels) ? values[levels + 1] : 1.0;
+
+    if ((m_period <= 0.0) || (m_duty < 0.0) || (m_duty > 1.0) || (m_low < 0.0) || (m_high > 1.0) || (m_low > m_high))
+    {
+        DCGM_LOG_ERROR << "Load profile " << spec << " needs a positive period, a duty in [0, 1] and"
+                       << " levels 0 <= low <= high <= 1";
+
+        return DCGM_ST_BADPARAM;
+    }
+
+    m_shape = (tokens[0] == "square") ? Shape::Square : Shape::Ramp;
+
+    return DCGM_ST_OK;
+}
+
+
+dcgmReturn_t LoadProfile::LoadTrace(const std::string &path)
+{
+    std::ifstream file(path);
+
+    if (!file)
+    {
+        DCGM_LOG_ERROR << "Could not open load profile trace " << path;
+
+        return DCGM_ST_BADPARAM;
+    }
+
+    std::string line;
+    unsigned int lineNumber { 0 };
+
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+
+        auto first = line.find_first_not_of(" \t\r");
+
+        if ((first == std::string::npos) || (line[first] == '#'))
+        {
+            continue; // blank line or comment
+        }
+
+        std::replace(line.begin(), line.end(), ',', ' ');
+
+        std::stringstream ss(line);
+        double seconds;
+        double level;
+
+        if (!(ss >> seconds >> level) || (level < 0.0) || (level > 1.0)
+            || (!m_trace.empty() && (seconds <= m_trace.back().first)))
+        {
+            DCGM_LOG_ERROR << "Load profile trace " << path << ":" << lineNumber
+                           << " is not an increasing \"<seconds> <level>\" sample with level in [0, 1]";
+
+            return DCGM_ST_BADPARAM;
+        }
+
+        m_trace.emplace_back(seconds, level);
+    }
+
+    if (m_trace.empty())
+    {
+        DCGM_LOG_ERROR << "Load profile trace " << path << " has no samples";
+
+        return DCGM_ST_BADPARAM;
+    }
+
+    m_period = m_trace.back().first;
+
+    return DCGM_ST_OK;
+}
+
+
+bool LoadProfile::IsEnabled(void) const
+{
+    return m_shape != Shape::None;
+}
+
+
+double LoadProfile::TargetAt(double seconds) const
+{
+    switch (m_shape)
+    {
+        case Shape::Square:
+            return (std::fmod(seconds, m_period) < (m_duty * m_period)) ? m_high : m_low;
+
+        case Shape::Ramp:
+            return m_low + (m_high - m_low) * std::fmod(seconds, m_period) / m_period;
+
+        case Shape::Trace:
+        {
+            if ((m_trace.size() == 1) || (m_period <= 0.0))
+            {
+                return m_trace.back().second;
+            }
+
+            double t = std::fmod(seconds, m_period);
+
+            // First sample after t. Before the first sample we hold its level.
+            auto next = std::upper_bound(m_trace.begin(), m_trace.end(), t, [](double value, const auto &sample) {
+                return value < sample.first;
+            });
+
+            if (next == m_trace.begin())
+            {
+                return next->second;
+            }
+
+            if (next == m_trace.end())
+            {
+                return m_trace.back().second;
+            }
+
+            auto prev = std::prev(next);
+
+            return prev->second + (next->second - prev->second) * (t - prev->first) / (next->first - prev->first);
+        }
+
+        case Shape::None:
+        default:
+            return 0.0;
+    }
+}
+
+
+const std::string &LoadProfile::Spec(void) const
+{
+    return m_spec;
+}
+
+} // namespace DcgmNs::ProfTester
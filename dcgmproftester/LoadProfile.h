@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace DcgmNs::ProfTester
+{
+/* Target activity curve for load profile tests.
+ *
+ * A profile is described by a specification string, one of:
+ *
+ *   square:<period>:<duty>[:<low>:<high>]  square wave of <period> seconds,
+ *                                          at <high> for <duty> of it
+ *   ramp:<period>[:<low>:<high>]           sawtooth from <low> to <high>
+ *                                          every <period> seconds
+ *   trace:<file>                           replay of "<seconds> <level>"
+ *                                          lines, linearly interpolated and
+ *                                          looped after the last sample
+ *
+ * Levels are fractions of full activity in [0, 1]; <low> and <high> default
+ * to 0 and 1. The specification must not contain spaces as it is passed to
+ * workers on their command line.
+ */
+class LoadProfile
+{
+public:
+    enum class Shape
+    {
+        None,
+        Square,
+        Ramp,
+        Trace
+    };
+
+    /**
+     * \brief Parse a profile specification, loading the trace file if any.
+     *
+     * @param spec Profile specification. An empty string disables the
+     *             profile.
+     *
+     * @return DCGM_ST_OK on success, DCGM_ST_BADPARAM if the specification
+     *         or trace file is malformed.
+     */
+    dcgmReturn_t Parse(const std::string &spec);
+
+    /**
+     * \brief Whether a profile has been parsed.
+     */
+    bool IsEnabled(void) const;
+
+    /**
+     * \brief Return the target activity level.
+     *
+     * @param seconds Time since the start of the profile.
+     *
+     * @return The target level in [0, 1].
+     */
+    double TargetAt(double seconds) const;
+
+    const std::string &Spec(void) const;
+
+private:
+    dcgmReturn_t LoadTrace(const std::string &path);
+
+    Shape m_shape { Shape::None };
+    std::string m_spec {};
+    double m_period { 0.0 }; //!< period in seconds
+    double m_duty { 0.0 };   //!< square wave fraction of period at high level
+    double m_low { 0.0 };    //!< low level
+    double m_high { 1.0 };   //!< high level
+
+    std::vector<std::pair<double, double>> m_trace {}; //!< (seconds, level)
+};
+
+} // namespace DcgmNs::ProfTester
@@ -39,6 +39,7 @@
 #include <tclap/ValueArg.h>
 #include <tclap/ValuesConstraint.h>
 
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <cstdint>
@@ -601,12 +602,13 @@ dcgmReturn_t PhysicalGpu::StartTests(void)
     m_reportedWorkers = 0;
 
     size_t workers { 0 };
+    bool inProcess = m_parameters.m_threads && !m_tester->IsMigInUse();
 
     for (auto &worker : m_dcgmCudaContexts)
     {
         if (!worker->IsRunning())
         {
-            if (worker->Run() < 0)
+            if (worker->Run(inProcess) < 0)
             {
                 if (workers > 0)
                 {
@@ -648,6 +650,14 @@ dcgmReturn_t PhysicalGpu::RunTests(void)
     m_exitRequested = false;
     m_valid         = true;
 
+    if (!m_parameters.m_loadProfile.empty() && (m_parameters.m_fieldId != DCGM_FI_PROF_GR_ENGINE_ACTIVE)
+        && (m_parameters.m_fieldId != DCGM_FI_PROF_SM_ACTIVE))
+    {
+        warn_reporter << "Load profiles only apply to fields " << DCGM_FI_PROF_GR_ENGINE_ACTIVE << " and "
+                      << DCGM_FI_PROF_SM_ACTIVE << ". Ignoring it for field " << m_parameters.m_fieldId << "."
+                      << warn_reporter.new_line;
+    }
+
     switch (m_parameters.m_fieldId)
     {
         case DCGM_FI_PROF_GR_ENGINE_ACTIVE:
@@ -1922,6 +1932,11 @@ dcgmReturn_t PhysicalGpu::RunSubtestSmActivity(void)
 {
     dcgmReturn_t rtSt;
 
+    if (!m_parameters.m_loadProfile.empty())
+    {
+        return RunSubtestLoadProfile();
+    }
+
     SetTickHandler([this, firstTick = false, nextPart = 0](size_t index,
                                                            bool valid,
                                                            std::map<Entity, dcgmFieldValue_v1> &values,
@@ -2129,6 +2144,11 @@ dcgmReturn_t PhysicalGpu::RunSubtestGrActivity(void)
 {
     dcgmReturn_t rtSt;
 
+    if (!m_parameters.m_loadProfile.empty())
+    {
+        return RunSubtestLoadProfile();
+    }
+
     SetTickHandler([this, firstTick = false](size_t index,
                                              bool valid,
                                              std::map<Entity, dcgmFieldValue_v1> &values,
@@ -2207,6 +2227,104 @@ dcgmReturn_t PhysicalGpu::RunSubtestGrActivity(void)
     return rtSt;
 }
 
+/*****************************************************************************/
+dcgmReturn_t PhysicalGpu::RunSubtestLoadProfile(void)
+{
+    dcgmReturn_t rtSt = m_loadProfile.Parse(m_parameters.m_loadProfile);
+
+    if (rtSt != DCGM_ST_OK)
+    {
+        error_reporter << "Invalid load profile " << m_parameters.m_loadProfile << "." << error_reporter.new_line;
+
+        return rtSt;
+    }
+
+    /**
+     * Workers follow the profile on all SMs and report the target and
+     * achieved activity averaged over each report interval. DCGM should
+     * see the achieved activity.
+     */
+    SetTickHandler([this, firstTick = false, prevAchieved = std::map<size_t, double> {}](
+                       size_t index,
+                       bool valid,
+                       std::map<Entity, dcgmFieldValue_v1> &values,
+                       DistributedCudaContext &worker) mutable -> dcgmReturn_t {
+        bool validated { true };
+
+        if (worker.IsFirstTick())
+        {
+            if (!firstTick) // First per-test per-GPU code here.
+            {
+                firstTick = true;
+
+                BeginSubtest("Load Profile " + m_loadProfile.Spec(), "load_profile", false);
+            }
+
+            if (!m_tester->IsFirstTick()) // Add first per test code here.
+            {
+                m_tester->SetFirstTick();
+            }
+        }
+
+        double target;
+        double achieved;
+        double timeOffset;
+
+        worker.Input() >> target;
+        worker.Input() >> achieved;
+        worker.Input() >> timeOffset;
+        worker.Input().ignore(MaxStreamLength, '\n');
+
+        if (prevAchieved.find(index) == prevAchieved.end())
+        {
+            prevAchieved[index] = achieved;
+        }
+
+        if (valid)
+        {
+            if (m_parameters.m_report)
+            {
+                auto ss    = std::cout.precision();
+                auto flags = std::cout.flags();
+
+                info_reporter << std::fixed << std::setprecision(3);
+
+                info_reporter << "Worker " << m_gpuId << ":" << index << "[" << m_parameters.m_fieldId
+                              << "]: LoadProfile: target " << target << ", achieved " << achieved << ", error "
+                              << achieved - target << ", dcgm ";
+
+                ValuesDump(values, ValueType::Double, 1.0); //<< value.value.dbl
+
+                info_reporter << " at " << std::setprecision(3) << timeOffset << " seconds." << info_reporter.new_line;
+
+                std::cout.precision(ss);
+                std::cout.flags(flags);
+            }
+
+            double value;
+
+            validated &= ValueGet(values, worker.Entities(), DCGM_FE_GPU_CI, ValueType::Double, 1.0, value)
+                         && Validate(prevAchieved[index], achieved, value, timeOffset / m_parameters.m_duration);
+
+            AppendSubtestRecord(target, value);
+        }
+
+        prevAchieved[index] = achieved;
+
+        return validated ? DCGM_ST_OK : DCGM_ST_PENDING;
+    });
+
+    rtSt = CommandAll(false,
+                      "R %u %.3f %.3f %s profile %s\n",
+                      m_parameters.m_fieldId,
+                      m_parameters.m_duration,
+                      m_parameters.m_reportInterval,
+                      m_parameters.m_targetMaxValue ? "true" : "false",
+                      m_loadProfile.Spec().c_str());
+
+    return rtSt;
+}
+
 /*****************************************************************************/
 dcgmReturn_t PhysicalGpu::RunSubtestPcieBandwidth(void)
 {
@@ -2375,7 +2493,8 @@ dcgmReturn_t PhysicalGpu::RunSubtestPcieBandwidth(void)
 }
 
 /*****************************************************************************/
-dcgmReturn_t PhysicalGpu::HelperGetBestNvLinkPeer(std::string &peerPciBusId, unsigned int &nvLinks)
+dcgmReturn_t PhysicalGpu::HelperGetNvLinkPeers(std::vector<std::pair<unsigned int, std::string>> &peers,
+                                               unsigned int &nvLinks)
 {
     int i;
 
@@ -2397,7 +2516,8 @@ dcgmReturn_t PhysicalGpu::HelperGetBestNvLinkPeer(std::string &peerPciBusId, uns
                       | DCGM_TOPOLOGY_NVLINK9 | DCGM_TOPOLOGY_NVLINK10 | DCGM_TOPOLOGY_NVLINK11
                       | DCGM_TOPOLOGY_NVLINK12;
 
-    /* Find the GPU we have the most NvLink connections to */
+    /* Gather the GPUs we have NvLink connections to, and the local links used */
+    std::map<unsigned int, unsigned int> linkedGpus;
     unsigned int bestGpuId   = 0;
     unsigned int maxNumLinks = 0;
     for (i = 0; i < (int)deviceTopo.numGpus; i++)
@@ -2405,6 +2525,8 @@ dcgmReturn_t PhysicalGpu::HelperGetBestNvLinkPeer(std::string &peerPciBusId, uns
         if (!(deviceTopo.gpuPaths[i].path & nvLinkMasks))
             continue;
 
+        linkedGpus[deviceTopo.gpuPaths[i].gpuId] = deviceTopo.gpuPaths[i].localNvLinkIds;
+
         /* More links = higher mask value */
         unsigned int numNvLinks = __builtin_popcount(deviceTopo.gpuPaths[i].localNvLinkIds);
 
@@ -2422,22 +2544,74 @@ dcgmReturn_t PhysicalGpu::HelperGetBestNvLinkPeer(std::string &peerPciBusId, uns
         return DCGM_ST_NOT_SUPPORTED;
     }
 
-    dcgmDeviceAttributes_v2 peerDeviceAttr;
-    memset(&peerDeviceAttr, 0, sizeof(peerDeviceAttr));
-    peerDeviceAttr.version = dcgmDeviceAttributes_version2;
-    dcgmReturn             = dcgmGetDeviceAttributes(m_dcgmHandle, bestGpuId, &peerDeviceAttr);
-    if (dcgmReturn != DCGM_ST_OK)
+    std::vector<unsigned int> peerGpuIds;
+
+    if (m_parameters.m_nvLinkAllPeers)
+    {
+        for (auto const &[gpuId, linkIds] : linkedGpus)
+        {
+            peerGpuIds.push_back(gpuId);
+        }
+    }
+    else if (!m_parameters.m_nvLinkPeerIds.empty())
     {
-        error_reporter << "dcgmGetDeviceAttributes failed with " << dcgmReturn << " for gpuId " << bestGpuId << "."
-                       << error_reporter.new_line;
+        for (auto gpuId : m_parameters.m_nvLinkPeerIds)
+        {
+            if (linkedGpus.find(gpuId) == linkedGpus.end())
+            {
+                warn_reporter << "gpuId " << gpuId << " is not an NvLink peer of gpuId " << m_gpuId << ". Skipping it."
+                              << warn_reporter.new_line;
 
-        return dcgmReturn;
+                continue;
+            }
+
+            if (std::find(peerGpuIds.begin(), peerGpuIds.end(), gpuId) == peerGpuIds.end())
+            {
+                peerGpuIds.push_back(gpuId);
+            }
+        }
+
+        if (peerGpuIds.empty())
+        {
+            warn_reporter << "gpuId " << m_gpuId << " has none of the requested NvLink peers. Skipping test."
+                          << warn_reporter.new_line;
+
+            return DCGM_ST_NOT_SUPPORTED;
+        }
+    }
+    else
+    {
+        peerGpuIds.push_back(bestGpuId);
     }
 
-    peerPciBusId = std::string(peerDeviceAttr.identifiers.pciBusId);
-    nvLinks      = maxNumLinks;
+    unsigned int localNvLinkIds { 0 };
 
-    DCGM_LOG_INFO << "The best peer of gpuId %u is gpuId " << bestGpuId << ", numLinks " << nvLinks << ".";
+    peers.clear();
+
+    for (auto gpuId : peerGpuIds)
+    {
+        dcgmDeviceAttributes_v2 peerDeviceAttr;
+        memset(&peerDeviceAttr, 0, sizeof(peerDeviceAttr));
+        peerDeviceAttr.version = dcgmDeviceAttributes_version2;
+        dcgmReturn             = dcgmGetDeviceAttributes(m_dcgmHandle, gpuId, &peerDeviceAttr);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            error_reporter << "dcgmGetDeviceAttributes failed with " << dcgmReturn << " for gpuId " << gpuId << "."
+                           << error_reporter.new_line;
+
+            return dcgmReturn;
+        }
+
+        peers.emplace_back(gpuId, std::string(peerDeviceAttr.identifiers.pciBusId));
+
+        /* Peers behind an NvSwitch share the same local links */
+        localNvLinkIds |= linkedGpus[gpuId];
+    }
+
+    nvLinks = __builtin_popcount(localNvLinkIds);
+
+    DCGM_LOG_INFO << "gpuId " << m_gpuId << " copies to " << peers.size() << " NvLink peer(s) (best gpuId " << bestGpuId
+                  << "), numLinks " << nvLinks << ".";
 
     return DCGM_ST_OK;
 }
@@ -2454,17 +2628,24 @@ dcgmReturn_t PhysicalGpu::RunSubtestNvLinkBandwidth(void)
         return DCGM_ST_GENERIC_ERROR;
     }
 
-    std::string peerPciBusId;
+    std::vector<std::pair<unsigned int, std::string>> peers;
     unsigned int nvLinks;
 
-    /* Get our best peer to do NvLink copies to */
-    rtSt = HelperGetBestNvLinkPeer(peerPciBusId, nvLinks);
+    /* Get the peers to do NvLink copies to */
+    rtSt = HelperGetNvLinkPeers(peers, nvLinks);
     if (rtSt != DCGM_ST_OK)
     {
         return rtSt;
     }
 
-    SetTickHandler([this, nvLinks, firstTick = false, fieldHeading = "", subtestTag = ""](
+    std::string peerPciBusIds;
+
+    for (auto const &[gpuId, busId] : peers)
+    {
+        peerPciBusIds += " " + busId;
+    }
+
+    SetTickHandler([this, nvLinks, peers, firstTick = false, fieldHeading = "", subtestTag = ""](
                        size_t index,
                        bool valid,
                        std::map<Entity, dcgmFieldValue_v1> &values,
@@ -2535,10 +2716,17 @@ dcgmReturn_t PhysicalGpu::RunSubtestNvLinkBandwidth(void)
         double howFarIn;
         double prevPerSecond;
         double curPerSecond;
+        std::vector<std::pair<double, double>> perLink(peers.size()); // TX and RX per peer
 
         worker.Input() >> howFarIn;
         worker.Input() >> prevPerSecond;
         worker.Input() >> curPerSecond;
+
+        for (auto &[txPerSecond, rxPerSecond] : perLink)
+        {
+            worker.Input() >> txPerSecond >> rxPerSecond;
+        }
+
         worker.Input().ignore(MaxStreamLength, '\n');
 
         if (valid)
@@ -2579,6 +2767,27 @@ dcgmReturn_t PhysicalGpu::RunSubtestNvLinkBandwidth(void)
 
                 info_reporter << 100.0 * value / nvLinkMbPerSec << "% speed-of-light)." << info_reporter.new_line;
 
+                if (peers.size() > 1)
+                {
+                    double txAggregate { 0.0 };
+                    double rxAggregate { 0.0 };
+
+                    info_reporter << "Worker " << m_gpuId << ":" << index << "[" << m_parameters.m_fieldId
+                                  << "]: per peer tx/rx MiB/sec:";
+
+                    for (size_t peer = 0; peer < peers.size(); peer++)
+                    {
+                        info_reporter << " " << peers[peer].first << ":" << perLink[peer].first << "/"
+                                      << perLink[peer].second;
+
+                        txAggregate += perLink[peer].first;
+                        rxAggregate += perLink[peer].second;
+                    }
+
+                    info_reporter << ", aggregate " << txAggregate << "/" << rxAggregate << "."
+                                  << info_reporter.new_line;
+                }
+
                 std::cout.precision(ss);
                 std::cout.flags(flags);
             }
@@ -2588,12 +2797,14 @@ dcgmReturn_t PhysicalGpu::RunSubtestNvLinkBandwidth(void)
     });
 
     rtSt = CommandAll(false,
-                      "R %u %.3f %.3f %s %s\n",
+                      "R %u %.3f %.3f %s %s %zu%s\n",
                       m_parameters.m_fieldId,
                       m_parameters.m_duration,
                       m_parameters.m_reportInterval,
                       m_parameters.m_targetMaxValue ? "true" : "false",
-                      peerPciBusId.c_str());
+                      m_parameters.m_nvLinkDirection.c_str(),
+                      (size_t)m_parameters.m_nvLinkMessageKiB * 1024,
+                      peerPciBusIds.c_str());
 
     return rtSt;
 }
@@ -2768,12 +2979,19 @@ dcgmReturn_t PhysicalGpu::RunSubtestGemmUtil(void)
             return DCGM_ST_GENERIC_ERROR;
     }
 
+    std::string testTitle { testHeader };
+
+    if (m_parameters.m_fieldId == DCGM_FI_PROF_PIPE_TENSOR_ACTIVE)
+    {
+        testTitle += " (" + m_parameters.m_tensorPrecision + ")";
+    }
+
     double limit = IsComputeUnoptimized(m_parameters.m_fieldId) ? 0.4 : 0.5;
 
     limit = IsHardwareNonDeterministic(m_parameters.m_fieldId) ? 0.2 : limit;
 
     SetTickHandler(
-        [this, firstTick = false, testHeader, testTag, limit](size_t index,
+        [this, firstTick = false, testTitle, testTag, limit](size_t index,
                                                               bool valid,
                                                               std::map<Entity, dcgmFieldValue_v1> &values,
                                                               DistributedCudaContext &worker) mutable -> dcgmReturn_t {
@@ -2790,7 +3008,7 @@ dcgmReturn_t PhysicalGpu::RunSubtestGemmUtil(void)
                 {
                     firstTick = true;
 
-                    BeginSubtest(testHeader, testTag, false);
+                    BeginSubtest(testTitle, testTag, false);
                 }
 
                 if (!m_tester->IsFirstTick()) // Add first per test code here.
@@ -2818,7 +3036,7 @@ dcgmReturn_t PhysicalGpu::RunSubtestGemmUtil(void)
                     info_reporter << std::fixed << std::setprecision(3);
 
                     info_reporter << "Worker " << m_gpuId << ":" << index << "[" << m_parameters.m_fieldId
-                                  << "]: " << testHeader << ": generated ???, dcgm ";
+                                  << "]: " << testTitle << ": generated ???, dcgm ";
 
                     ValuesDump(values, ValueType::Double, 1.0); //<< value.value.dbl
 
@@ -2842,11 +3060,12 @@ dcgmReturn_t PhysicalGpu::RunSubtestGemmUtil(void)
         });
 
     rtSt = CommandAll(false,
-                      "R %u %.3f %.3f %s\n",
+                      "R %u %.3f %.3f %s %s\n",
                       m_parameters.m_fieldId,
                       m_parameters.m_duration,
                       m_parameters.m_reportInterval,
-                      m_parameters.m_targetMaxValue ? "true" : "false");
+                      m_parameters.m_targetMaxValue ? "true" : "false",
+                      m_parameters.m_tensorPrecision.c_str());
 
     return rtSt;
 }
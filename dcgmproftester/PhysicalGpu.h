@@ -19,6 +19,7 @@
 #include "DcgmProfTester.h"
 #include "DistributedCudaContext.h"
 #include "Entity.h"
+#include "LoadProfile.h"
 
 #include <cuda.h>
 #include <dcgm_structs.h>
@@ -203,17 +204,20 @@ private:
     dcgmReturn_t RunSubtestGemmUtil(void);
     dcgmReturn_t RunSubtestNvLinkBandwidth(void);
     dcgmReturn_t RunSubtestSmOccupancyTargetMax(void);
+    dcgmReturn_t RunSubtestLoadProfile(void);
 
     /*************************************************************************/
     /*
-     * Method to get the best linked peer.
+     * Method to get the NvLink peers to copy to: the best linked peer, all
+     * peers, or those requested, as selected by the parameters.
      *
-     * @param peerPciBusId  - peer Bus Id.
-     * @param nvLinks       - links available.
+     * @param peers         - peer GPU Ids and Bus Ids.
+     * @param nvLinks       - local links leading to these peers.
      *
      * @return DCGM_ST_OK if it succeeded, something else otherwise.
      */
-    dcgmReturn_t HelperGetBestNvLinkPeer(std::string &peerPciBusId, unsigned int &nvLinks);
+    dcgmReturn_t HelperGetNvLinkPeers(std::vector<std::pair<unsigned int, std::string>> &peers,
+                                      unsigned int &nvLinks);
 
     /*************************************************************************/
     /*
@@ -306,6 +310,8 @@ private:
 
     Arguments_t::Parameters m_parameters; /* Operational test parameters */
 
+    LoadProfile m_loadProfile; /* Target activity curve, if one was given */
+
     /* CUDA contexts (one per MIG slice or one per whole GPU) */
     std::vector<std::shared_ptr<DistributedCudaContext>> m_dcgmCudaContexts;
 
@@ -18,7 +18,9 @@
 #include "HostEngineOutput.h"
 
 #include <DcgmBuildInfo.hpp>
+#include <DcgmCpuPlacement.h>
 #include <DcgmLogging.h>
+#include <DcgmSettings.h>
 #include <DcgmStringHelpers.h>
 #include <dcgm_structs_internal.h>
 
@@ -40,10 +42,27 @@ struct HostEngineCommandLine::Impl
     std::string m_logFileName;               /*!< Log file name */
     //! PID filename to use to prevent more than one nv-hostengine daemon instance from running
     std::string m_pidFilePath;
+    std::string m_proxyHosts;        /*!< Host engines to collect from as a proxy. "" = not a proxy */
+    std::string m_minWorkers;        /*!< Minimum workers of each request lane. "" = default */
+    std::string m_maxWorkers;        /*!< Most workers of each request lane. "" = default */
+    std::string m_moduleLoadPolicy;  /*!< When to load modules, like "1=prewarm". "" = default */
+    std::string m_metricsListen;     /*!< [ip:]port of the OpenMetrics endpoint. "" = none */
+    std::string m_metricsFields;     /*!< Field IDs the OpenMetrics endpoint and OTLP push serve. "" = default */
+    std::string m_otlpEndpoint;      /*!< URL to push OTLP metrics to. "" = none */
+    std::string m_latestBoard;       /*!< Shared memory segment to publish the latest values to. "" = none */
+    std::string m_latestBoardFields; /*!< Field IDs the latest value board publishes. "" = default */
+    std::string m_threadPlacement;   /*!< Where to run cache manager threads, like "gpu" */
+    std::string m_cacheArenas;       /*!< What backs cached watches and samples, like "thp" */
+    std::string m_reservedCpus;      /*!< CPUs to keep all threads off of, like "0-3". "" = none */
+    std::string m_stateFile;         /*!< File to keep client state in across restarts. "" = none */
+    std::string m_spillDir;          /*!< Directory to spill aged samples to. "" = none */
+    std::uint32_t m_otlpInterval;    /*!< Seconds between OTLP pushes */
 
     std::set<dcgmModuleId_t> m_blacklistModules; /*!< Modules to blacklist */
 
-    std::uint16_t m_hostEnginePort; /*!< Host engine port number */
+    std::uint64_t m_cacheMemoryBudget; /*!< Bytes of field samples to cache at most. 0 = unlimited */
+    std::uint64_t m_spillBudget;       /*!< Bytes of spilled samples to keep at most. 0 = default */
+    std::uint16_t m_hostEnginePort;    /*!< Host engine port number */
 
     bool m_isHostEngineConnTCP; /*!< Flag to indicate that connection is TCP */
     bool m_isTermHostEngine;    /*!< Terminate Daemon */
@@ -111,6 +130,91 @@ std::set<dcgmModuleId_t> const &HostEngineCommandLine::GetBlacklistedModules() c
     return m_pimpl->m_blacklistModules;
 }
 
+std::uint64_t HostEngineCommandLine::GetCacheMemoryBudget() const
+{
+    return m_pimpl->m_cacheMemoryBudget;
+}
+
+std::string const &HostEngineCommandLine::GetSpillDir() const
+{
+    return m_pimpl->m_spillDir;
+}
+
+std::uint64_t HostEngineCommandLine::GetSpillBudget() const
+{
+    return m_pimpl->m_spillBudget;
+}
+
+std::string const &HostEngineCommandLine::GetProxyHosts() const
+{
+    return m_pimpl->m_proxyHosts;
+}
+
+std::string const &HostEngineCommandLine::GetMetricsListen() const
+{
+    return m_pimpl->m_metricsListen;
+}
+
+std::string const &HostEngineCommandLine::GetMetricsFields() const
+{
+    return m_pimpl->m_metricsFields;
+}
+
+std::string const &HostEngineCommandLine::GetOtlpEndpoint() const
+{
+    return m_pimpl->m_otlpEndpoint;
+}
+
+std::uint32_t HostEngineCommandLine::GetOtlpInterval() const
+{
+    return m_pimpl->m_otlpInterval;
+}
+
+std::string const &HostEngineCommandLine::GetLatestBoard() const
+{
+    return m_pimpl->m_latestBoard;
+}
+
+std::string const &HostEngineCommandLine::GetLatestBoardFields() const
+{
+    return m_pimpl->m_latestBoardFields;
+}
+
+std::string const &HostEngineCommandLine::GetMinWorkers() const
+{
+    return m_pimpl->m_minWorkers;
+}
+
+std::string const &HostEngineCommandLine::GetMaxWorkers() const
+{
+    return m_pimpl->m_maxWorkers;
+}
+
+std::string const &HostEngineCommandLine::GetModuleLoadPolicy() const
+{
+    return m_pimpl->m_moduleLoadPolicy;
+}
+
+std::string const &HostEngineCommandLine::GetThreadPlacement() const
+{
+    return m_pimpl->m_threadPlacement;
+}
+
+std::string const &HostEngineCommandLine::GetCacheArenas() const
+{
+    return m_pimpl->m_cacheArenas;
+}
+
+std::string const &HostEngineCommandLine::GetReservedCpus() const
+{
+    return m_pimpl->m_reservedCpus;
+}
+
+std::string const &HostEngineCommandLine::GetStateFile() const
+{
+    return m_pimpl->m_stateFile;
+}
+
 namespace
 {
 using namespace std::string_literals;
@@ -171,6 +275,110 @@ public:
     }
 };
 
+class ModuleLoadPolicyConstraint : public TCLAP::Constraint<std::string>
+{
+public:
+    std::string description() const override
+    {
+        return "Validate that --module-load-policy has proper format and values"s;
+    }
+
+    std::string shortID() const override
+    {
+        return "MODULEID=POLICY[,MODULEID=POLICY...]"s;
+    }
+
+    bool check(std::string const &value) const override
+    {
+        auto tokens = dcgmTokenizeString(value, ",");
+        if (tokens.empty())
+        {
+            return false;
+        }
+
+        for (auto const &token : tokens)
+        {
+            auto equals = token.find('=');
+            if (equals == std::string::npos)
+            {
+                return false;
+            }
+
+            auto moduleId = std::stoi(token.substr(0, equals));
+            if (moduleId <= 0 || moduleId >= DcgmModuleIdCount)
+            {
+                return false;
+            }
+
+            auto policy = token.substr(equals + 1);
+            if (policy != "eager"s && policy != "lazy"s && policy != "prewarm"s)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+class ThreadPlacementConstraint : public TCLAP::Constraint<std::string>
+{
+public:
+    std::string description() const override
+    {
+        return "Validate that --thread-placement is a known policy"s;
+    }
+
+    std::string shortID() const override
+    {
+        return std::string(DCGM_THREAD_PLACEMENT_NONE "|" DCGM_THREAD_PLACEMENT_GPU);
+    }
+
+    bool check(std::string const &value) const override
+    {
+        return value == DCGM_THREAD_PLACEMENT_NONE || value == DCGM_THREAD_PLACEMENT_GPU;
+    }
+};
+
+class CacheArenasConstraint : public TCLAP::Constraint<std::string>
+{
+public:
+    std::string description() const override
+    {
+        return "Validate that --cache-arenas is a known kind of memory"s;
+    }
+
+    std::string shortID() const override
+    {
+        return std::string(DCGM_CACHE_ARENAS_NONE "|" DCGM_CACHE_ARENAS_THP "|" DCGM_CACHE_ARENAS_HUGETLB);
+    }
+
+    bool check(std::string const &value) const override
+    {
+        return value == DCGM_CACHE_ARENAS_NONE || value == DCGM_CACHE_ARENAS_THP
+               || value == DCGM_CACHE_ARENAS_HUGETLB;
+    }
+};
+
+class CpuListConstraint : public TCLAP::Constraint<std::string>
+{
+public:
+    std::string description() const override
+    {
+        return "Validate that --reserved-cpus is a list of CPUs"s;
+    }
+
+    std::string shortID() const override
+    {
+        return "CPU[-CPU][,CPU[-CPU]...]"s;
+    }
+
+    bool check(std::string const &value) const override
+    {
+        cpu_set_t cpus;
+        return DcgmNs::ParseCpuList(value, cpus);
+    }
+};
 
 } // namespace
 
@@ -435,6 +643,215 @@ HostEngineCommandLine ParseCommandLine(int argc, char *argv[])
                                     &blacklistConstraint,
                                     cmdLine);
 
+        auto cacheBudgetArg
+            = ValueArg<std::uint64_t>("",
+                                      "max-cache-bytes",
+                                      "Limit the memory used to cache field samples across all watches."
+                                      "\nWhen the limit is reached, the history of the least recently read"
+                                      " fields is dropped first.\nDefault: 0 = unlimited.",
+                                      /*req*/ false,
+                                      /*default*/ 0,
+                                      /*typedesc*/ "BYTES",
+                                      cmdLine);
+
+        auto spillDirArg
+            = ValueArg<std::string>("",
+                                    "spill-dir",
+                                    "Write the samples of numeric fields that age out of the cache to compressed"
+                                    " files in this directory instead of dropping them.\nQueries for older"
+                                    " samples than the cache keeps are answered from the files, including files"
+                                    " left by an earlier run.\nDefault: no spill.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "DIR",
+                                    cmdLine);
+
+        auto spillBudgetArg
+            = ValueArg<std::uint64_t>("",
+                                      "spill-budget",
+                                      "Limit the disk space used by --spill-dir. When the limit is reached, the"
+                                      " oldest samples are deleted first.\nDefault: 0 = 1 GiB.",
+                                      /*req*/ false,
+                                      /*default*/ 0,
+                                      /*typedesc*/ "BYTES",
+                                      cmdLine);
+
+        auto proxyHostsArg
+            = ValueArg<std::string>("",
+                                    "proxy-hosts",
+                                    "Run as a proxy that collects from other host engines, so that a collector"
+                                    " gets their values over one connection.\nPass a comma-separated list of"
+                                    " host engines like 10.0.0.1,10.0.0.2:5555,unix:/tmp/nv-hostengine.sock."
+                                    "\nSee dcgmProxyStreamSubscribe.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "HOSTS",
+                                    cmdLine);
+
+        auto metricsListenArg
+            = ValueArg<std::string>("",
+                                    "metrics-listen",
+                                    "Serve the latest field values to Prometheus in OpenMetrics format at"
+                                    " http://ADDRESS/metrics.\nPass a port like 9400 or an IP and port like"
+                                    " 127.0.0.1:9400.\nDefault: no endpoint.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "ADDRESS",
+                                    cmdLine);
+
+        auto metricsFieldsArg
+            = ValueArg<std::string>("",
+                                    "metrics-fields",
+                                    "Fields to serve with --metrics-listen and push with --otlp-endpoint.\nPass a"
+                                    " comma-separated list of numeric field IDs like 150,155,203. Field IDs are"
+                                    " available in dcgm_fields.h as DCGM_FI_ constants.\nDefault: clocks,"
+                                    " temperature, power, energy, utilization and framebuffer usage.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "FIELDS",
+                                    cmdLine);
+
+        auto otlpEndpointArg
+            = ValueArg<std::string>("",
+                                    "otlp-endpoint",
+                                    "Push every sample of the --metrics-fields to an OpenTelemetry collector as"
+                                    " OTLP/HTTP protobuf metrics.\nPass the URL of its metrics receiver like"
+                                    " http://localhost:4318/v1/metrics. Only http:// is supported.\nDefault: no"
+                                    " push.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "URL",
+                                    cmdLine);
+
+        auto otlpIntervalArg = ValueArg<std::uint32_t>("",
+                                                       "otlp-interval",
+                                                       "Seconds between pushes to --otlp-endpoint. Samples taken"
+                                                       " in between are batched into one push.",
+                                                       /*req*/ false,
+                                                       /*default*/ 10,
+                                                       /*typedesc*/ "SECONDS",
+                                                       cmdLine);
+
+        auto latestBoardArg
+            = ValueArg<std::string>("",
+                                    "latest-board",
+                                    "Publish the latest value of the --latest-board-fields of every GPU to a"
+                                    " read-only POSIX shared memory segment that local agents read with"
+                                    " dcgm_latest_board.h.\nPass the segment name like /nvidia-dcgm-latest."
+                                    "\nDefault: no board.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "NAME",
+                                    cmdLine);
+
+        auto latestBoardFieldsArg
+            = ValueArg<std::string>("",
+                                    "latest-board-fields",
+                                    "Fields to publish with --latest-board.\nPass a comma-separated list of numeric"
+                                    " field IDs like 150,155,203. Only integer and floating point fields are"
+                                    " published.\nDefault: the --metrics-fields default.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "FIELDS",
+                                    cmdLine);
+
+        auto minWorkersArg
+            = ValueArg<std::string>("",
+                                    "min-workers",
+                                    "Worker threads that process client requests at all times."
+                                    "\nPass one number for every request lane, or a comma-separated list for"
+                                    " the fast, admin and long-running lanes like 2,1,2.\nDefault: 2,1,2.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "WORKERS",
+                                    cmdLine);
+
+        auto maxWorkersArg
+            = ValueArg<std::string>("",
+                                    "max-workers",
+                                    "Most worker threads each request lane grows to while requests wait for a"
+                                    " worker. Idle workers past --min-workers stop after 30 seconds."
+                                    "\nSame form as --min-workers.\nDefault: scaled with the number of CPUs.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "WORKERS",
+                                    cmdLine);
+
+        auto moduleLoadPolicyConstraint = ModuleLoadPolicyConstraint {};
+
+        auto moduleLoadPolicyArg
+            = ValueArg<std::string>("",
+                                    "module-load-policy",
+                                    "When the hostengine loads DCGM modules that nothing used yet."
+                                    "\nPass a comma-separated list of module IDs and policies like 1=lazy,7=eager."
+                                    " eager modules are loaded at startup, prewarm modules in the background once"
+                                    " the hostengine is listening and lazy modules on their first use."
+                                    "\nDefault: prewarm for the NvSwitch module and lazy for the others.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    &moduleLoadPolicyConstraint,
+                                    cmdLine);
+
+        auto threadPlacementConstraint = ThreadPlacementConstraint {};
+
+        auto threadPlacementArg
+            = ValueArg<std::string>("",
+                                    "thread-placement",
+                                    "Where the hostengine runs the threads that poll GPUs."
+                                    "
+Pass gpu to fetch each GPU's fields on its own thread, pinned to the CPUs"
+                                    " nearest that GPU, so its samples are also cached in the nearest memory."
+                                    " The thread that schedules the fetches is pinned to the CPUs near any GPU."
+                                    "
+Default: none, which leaves placement to the OS.",
+                                    /*req*/ false,
+                                    /*default*/ DCGM_THREAD_PLACEMENT_NONE,
+                                    &threadPlacementConstraint,
+                                    cmdLine);
+
+        auto cacheArenasConstraint = CacheArenasConstraint {};
+
+        auto cacheArenasArg
+            = ValueArg<std::string>("",
+                                    "cache-arenas",
+                                    "What backs the watches and samples the hostengine caches."
+                                    "\nPass thp to allocate each GPU's watches from arenas of 2 MiB chunks that"
+                                    " transparent huge pages can back, which cuts TLB misses while sampling and"
+                                    " reading many fields. Pass hugetlb to map the chunks from the hugetlbfs pool"
+                                    " while it has room, falling back to thp after."
+                                    "\nDefault: none, which uses the heap.",
+                                    /*req*/ false,
+                                    /*default*/ DCGM_CACHE_ARENAS_NONE,
+                                    &cacheArenasConstraint,
+                                    cmdLine);
+
+        auto reservedCpusConstraint = CpuListConstraint {};
+
+        auto reservedCpusArg
+            = ValueArg<std::string>("",
+                                    "reserved-cpus",
+                                    "CPUs that no hostengine thread may run on, like those reserved for tenant"
+                                    " workloads.
+Pass a list like 0-3,8 in the format of"
+                                    " /sys/devices/system/cpu/online.
+Default: none.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    &reservedCpusConstraint,
+                                    cmdLine);
+
+        auto stateFileArg
+            = ValueArg<std::string>("",
+                                    "state-file",
+                                    "File to save the groups, field groups, watches, health watches and policies"
+                                    " of clients in when the hostengine stops, and to restore them from when it"
+                                    " starts. Clients that got a session token take theirs back with"
+                                    " dcgmSessionResume after reconnecting.\nDefault: none.",
+                                    /*req*/ false,
+                                    /*default*/ "",
+                                    /*typedesc*/ "FILE",
+                                    cmdLine);
+
         cmdLine.parse(argc, argv);
 
         impl->m_hostEngineSockPath        = domainSockArg.getValue();
@@ -444,6 +861,23 @@ HostEngineCommandLine ParseCommandLine(int argc, char *argv[])
         impl->m_pidFilePath               = pidFileArg.getValue();
         impl->m_blacklistModules          = ParseBlacklist(blacklistArg.getValue());
         impl->m_hostEnginePort            = portArg.getValue();
+        impl->m_cacheMemoryBudget         = cacheBudgetArg.getValue();
+        impl->m_spillDir                  = spillDirArg.getValue();
+        impl->m_spillBudget               = spillBudgetArg.getValue();
+        impl->m_proxyHosts                = proxyHostsArg.getValue();
+        impl->m_metricsListen             = metricsListenArg.getValue();
+        impl->m_metricsFields             = metricsFieldsArg.getValue();
+        impl->m_otlpEndpoint              = otlpEndpointArg.getValue();
+        impl->m_otlpInterval              = otlpIntervalArg.getValue();
+        impl->m_latestBoard               = latestBoardArg.getValue();
+        impl->m_latestBoardFields         = latestBoardFieldsArg.getValue();
+        impl->m_minWorkers                = minWorkersArg.getValue();
+        impl->m_maxWorkers                = maxWorkersArg.getValue();
+        impl->m_moduleLoadPolicy          = moduleLoadPolicyArg.getValue();
+        impl->m_threadPlacement           = threadPlacementArg.getValue();
+        impl->m_cacheArenas               = cacheArenasArg.getValue();
+        impl->m_reservedCpus              = reservedCpusArg.getValue();
+        impl->m_stateFile                 = stateFileArg.getValue();
         impl->m_isHostEngineConnTCP       = not domainSockArg.isSet();
         impl->m_isTermHostEngine          = termArg.getValue();
         impl->m_shouldDaemonize           = not daemonizeArg.getValue();
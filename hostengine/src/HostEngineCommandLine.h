@@ -50,6 +50,55 @@ public:
     [[nodiscard]] std::string const &GetLogFileName() const; //!< Log file name
     [[nodiscard]] bool IsLogRotate() const;                  //!< Flag to rotate log file
 
+    //! Bytes of field samples the cache may keep across all watches. 0 = unlimited
+    [[nodiscard]] std::uint64_t GetCacheMemoryBudget() const;
+
+    //! Directory to spill samples that age out of the cache to. "" = no spill
+    [[nodiscard]] std::string const &GetSpillDir() const;
+
+    //! Bytes of spilled samples to keep at most. 0 = default
+    [[nodiscard]] std::uint64_t GetSpillBudget() const;
+
+    //! Comma-separated host engines to collect from as a proxy. "" = not a proxy
+    [[nodiscard]] std::string const &GetProxyHosts() const;
+
+    //! [ip:]port to serve OpenMetrics scrapes on. "" = no endpoint
+    [[nodiscard]] std::string const &GetMetricsListen() const;
+
+    //! Comma-separated field IDs to serve on the OpenMetrics endpoint and push over OTLP. "" = default
+    [[nodiscard]] std::string const &GetMetricsFields() const;
+
+    //! URL to push OTLP metrics to. "" = no push
+    [[nodiscard]] std::string const &GetOtlpEndpoint() const;
+
+    //! Seconds between OTLP pushes
+    [[nodiscard]] std::uint32_t GetOtlpInterval() const;
+
+    //! Name of the shared memory segment to publish the latest values to. "" = no board
+    [[nodiscard]] std::string const &GetLatestBoard() const;
+
+    //! Comma-separated field IDs to publish to the latest value board. "" = default
+    [[nodiscard]] std::string const &GetLatestBoardFields() const;
+
+    //! Minimum and most workers of each request lane, like "2,1,2". "" = default
+    [[nodiscard]] std::string const &GetMinWorkers() const;
+    [[nodiscard]] std::string const &GetMaxWorkers() const;
+
+    //! When to load modules, like "1=prewarm,7=eager". "" = default
+    [[nodiscard]] std::string const &GetModuleLoadPolicy() const;
+
+    //! Where to run cache manager threads. DCGM_THREAD_PLACEMENT_NONE or DCGM_THREAD_PLACEMENT_GPU
+    [[nodiscard]] std::string const &GetThreadPlacement() const;
+
+    //! What backs cached watches and samples. DCGM_CACHE_ARENAS_NONE, _THP or _HUGETLB
+    [[nodiscard]] std::string const &GetCacheArenas() const;
+
+    //! CPUs to keep every Host Engine thread off of, like "0-3,8". "" = none
+    [[nodiscard]] std::string const &GetReservedCpus() const;
+
+    //! File to keep client state in across restarts. "" = none
+    [[nodiscard]] std::string const &GetStateFile() const;
+
     //! Get modules to blacklist
     [[nodiscard]] std::set<dcgmModuleId_t> const &GetBlacklistedModules() const;
 
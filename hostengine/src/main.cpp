@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "DcgmCpuPlacement.h"
 #include "DcgmLogging.h"
 #include "DcgmSettings.h"
 #include "HostEngineCommandLine.h"
@@ -38,6 +39,7 @@
 
 
 int g_stopLoop = 0;
+volatile sig_atomic_t g_dumpTrace = 0; /* Set by SIGUSR2. See dumpTrace() */
 
 // Forward declarations
 void daemonCloseConsoleOutput(pid_t parentPid);
@@ -353,10 +355,37 @@ void sig_handler(int signum)
     g_stopLoop = 1;
 }
 
+/*****************************************************************************/
+void trace_sig_handler(int signum)
+{
+    g_dumpTrace = 1;
+}
+
+/*****************************************************************************
+ * Write the update-loop trace to a file on SIGUSR2. Tracing is started by
+ * __DCGM_TRACE_SPANS or dcgmi introspect --trace start
+ *****************************************************************************/
+void dumpTrace(dcgmHandle_t dcgmHandle)
+{
+    dcgmTraceControl_t traceControl {};
+    traceControl.version = dcgmTraceControl_version;
+    traceControl.action  = DCGM_TRACE_ACTION_DUMP;
+
+    dcgmReturn_t ret = dcgmTraceControl(dcgmHandle, &traceControl);
+    if (ret == DCGM_ST_OK)
+    {
+        syslog(LOG_NOTICE, "nv-hostengine wrote its trace to %s", traceControl.filename);
+    }
+    else
+    {
+        syslog(LOG_NOTICE, "nv-hostengine could not write its trace: %s", errorString(ret));
+    }
+}
+
 
 /*****************************************************************************
  * This method provides mechanism to register Sighandler callbacks for
- * SIGHUP, SIGINT, SIGQUIT, and SIGTERM
+ * SIGHUP, SIGINT, SIGQUIT, SIGTERM and SIGUSR2
  *****************************************************************************/
 int InstallCtrlHandler()
 {
@@ -368,6 +397,8 @@ int InstallCtrlHandler()
         return -1;
     if (signal(SIGTERM, sig_handler) == SIG_ERR)
         return -1;
+    if (signal(SIGUSR2, trace_sig_handler) == SIG_ERR)
+        return -1;
 
     /* Ignore SIGPIPE so that socket hang-ups don't cause us to crash */
     if (signal(SIGPIPE, SIG_IGN) == SIG_ERR)
@@ -444,6 +475,20 @@ int main(int argc, char **argv)
         update_daemon_pid_file(cmdLine.GetPidFilePath().c_str(), parentPid);
     }
 
+    /* Every thread started from here on inherits this thread's affinity, so this keeps them all off the
+       reserved CPUs */
+    if (!cmdLine.GetReservedCpus().empty())
+    {
+        cpu_set_t reservedCpus;
+        if (!DcgmNs::ParseCpuList(cmdLine.GetReservedCpus(), reservedCpus)
+            || !DcgmNs::ExcludeCpusFromCurrentThread(reservedCpus))
+        {
+            syslog(LOG_ERR, "Error: unable to keep nv-hostengine off of CPUs %s", cmdLine.GetReservedCpus().c_str());
+            fprintf(stderr, "Error: unable to keep nv-hostengine off of CPUs %s\n", cmdLine.GetReservedCpus().c_str());
+            return cleanup(dcgmHandle, -1, parentPid);
+        }
+    }
+
     /* Initialize DCGM Host Engine */
     ret = dcgmInit();
     if (DCGM_ST_OK != ret)
@@ -453,6 +498,82 @@ int main(int argc, char **argv)
         return cleanup(dcgmHandle, -1, parentPid);
     }
 
+    /* The cache manager picks this up when the embedded engine starts */
+    if (cmdLine.GetCacheMemoryBudget() > 0)
+    {
+        setenv(DCGM_ENV_CACHE_MEMORY_BUDGET, std::to_string(cmdLine.GetCacheMemoryBudget()).c_str(), 1);
+    }
+    if (!cmdLine.GetSpillDir().empty())
+    {
+        setenv(DCGM_ENV_SPILL_DIR, cmdLine.GetSpillDir().c_str(), 1);
+        setenv(DCGM_ENV_SPILL_BUDGET, std::to_string(cmdLine.GetSpillBudget()).c_str(), 1);
+    }
+
+    /* The host engine handler starts proxying once it is listening */
+    if (!cmdLine.GetProxyHosts().empty())
+    {
+        setenv(DCGM_ENV_PROXY_HOSTS, cmdLine.GetProxyHosts().c_str(), 1);
+    }
+
+    /* The host engine handler starts serving scrapes once it is listening */
+    if (!cmdLine.GetMetricsListen().empty())
+    {
+        setenv(DCGM_ENV_METRICS_LISTEN, cmdLine.GetMetricsListen().c_str(), 1);
+    }
+
+    /* ...and pushing OTLP metrics */
+    if (!cmdLine.GetOtlpEndpoint().empty())
+    {
+        setenv(DCGM_ENV_OTLP_ENDPOINT, cmdLine.GetOtlpEndpoint().c_str(), 1);
+        setenv(DCGM_ENV_OTLP_INTERVAL, std::to_string(cmdLine.GetOtlpInterval()).c_str(), 1);
+    }
+    if (!cmdLine.GetMetricsListen().empty() || !cmdLine.GetOtlpEndpoint().empty())
+    {
+        setenv(DCGM_ENV_METRICS_FIELDS, cmdLine.GetMetricsFields().c_str(), 1);
+    }
+
+    /* ...and publishing the latest values to shared memory */
+    if (!cmdLine.GetLatestBoard().empty())
+    {
+        setenv(DCGM_ENV_LATEST_BOARD, cmdLine.GetLatestBoard().c_str(), 1);
+        setenv(DCGM_ENV_LATEST_BOARD_FIELDS, cmdLine.GetLatestBoardFields().c_str(), 1);
+    }
+
+    /* Picked up when the host engine handler sets up its request lanes */
+    if (!cmdLine.GetMinWorkers().empty())
+    {
+        setenv(DCGM_ENV_IPC_WORKER_LANES, cmdLine.GetMinWorkers().c_str(), 1);
+    }
+    if (!cmdLine.GetMaxWorkers().empty())
+    {
+        setenv(DCGM_ENV_IPC_MAX_WORKER_LANES, cmdLine.GetMaxWorkers().c_str(), 1);
+    }
+
+    /* Picked up by the cache manager. Placing threads per GPU needs a thread per GPU */
+    if (cmdLine.GetThreadPlacement() == DCGM_THREAD_PLACEMENT_GPU)
+    {
+        setenv(DCGM_ENV_THREAD_PLACEMENT, DCGM_THREAD_PLACEMENT_GPU, 1);
+        setenv(DCGM_ENV_PARALLEL_GPU_FETCH, "1", 1);
+    }
+
+    /* Picked up by the cache manager */
+    if (cmdLine.GetCacheArenas() != DCGM_CACHE_ARENAS_NONE)
+    {
+        setenv(DCGM_ENV_CACHE_ARENAS, cmdLine.GetCacheArenas().c_str(), 1);
+    }
+
+    /* Picked up when the host engine handler sets up its modules */
+    if (!cmdLine.GetModuleLoadPolicy().empty())
+    {
+        setenv(DCGM_ENV_MODULE_LOAD_POLICY, cmdLine.GetModuleLoadPolicy().c_str(), 1);
+    }
+
+    /* Picked up by the host engine handler before it starts listening and when it stops */
+    if (!cmdLine.GetStateFile().empty())
+    {
+        setenv(DCGM_ENV_STATE_CHECKPOINT, cmdLine.GetStateFile().c_str(), 1);
+    }
+
     dcgmStartEmbeddedV2Params_v1 params {};
     params.version  = dcgmStartEmbeddedV2Params_version1;
     params.opMode   = DCGM_OPERATION_MODE_AUTO;
@@ -528,6 +649,12 @@ int main(int argc, char **argv)
     while (g_stopLoop == 0)
     {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        if (g_dumpTrace)
+        {
+            g_dumpTrace = 0;
+            dumpTrace(dcgmHandle);
+        }
     }
 
     return cleanup(dcgmHandle, 0, parentPid);
@@ -22,6 +22,7 @@
 #include <DcgmCoreProxy.h>
 #include <DcgmFvBuffer.h>
 #include <DcgmProtobuf.h>
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 
@@ -126,6 +127,28 @@ public:
     }
 
 protected:
+    /*
+     * Have the host engine process the commands clients send to this module on a
+     * dedicated thread, one at a time and in the order they arrived, instead of on
+     * the request worker they arrived on. The reply to each is sent once it
+     * completes. Commands from the host engine itself and the subCommands whose bit
+     * is set in inlineSubCommands, like one that cancels a queued command, still
+     * arrive on the caller's thread. Only takes effect from a module's constructor.
+     * With maxThreads > 1, commands that would wait behind a busy thread are
+     * processed on up to maxThreads threads instead, in no particular order
+     */
+    dcgmReturn_t ProcessClientCommandsOnOwnThread(unsigned long long inlineSubCommands = 0, unsigned int maxThreads = 1)
+    {
+        dcgmReturn_t dcgmReturn = m_coreProxy.SetModuleDispatch(
+            static_cast<dcgmModuleId_t>(moduleId), std::max(maxThreads, 1U), inlineSubCommands);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            DCGM_LOG_ERROR << "Got " << errorString(dcgmReturn) << " asking for a command thread for module "
+                           << moduleId;
+        }
+        return dcgmReturn;
+    }
+
     dcgmCoreCallbacks_t m_coreCallbacks;
     DcgmCoreProxy m_coreProxy;
 };
@@ -13,13 +13,13 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-
-
+#include "DcgmModuleApi.h"
 #include "DcgmLogging.h"
 #include "DcgmProtobuf.h"
 #include "DcgmRequest.h"
 #include "dcgm_module_structs.h"
 #include "dcgm_test_apis.h" /* DCGM_EMBEDDED_HANDLE */
+#include <cstring>
 #include <vector>
 
 /*****************************************************************************/
@@ -29,6 +29,9 @@ dcgmReturn_t processModuleCommandAtHostEngine(dcgmHandle_t pDcgmHandle,
                                               size_t maxResponseSize               = 0,
                                               std::unique_ptr<DcgmRequest> request = nullptr,
                                               unsigned int timeout                 = 60000);
+dcgmReturn_t processModuleCommandBatchAtHostEngine(dcgmHandle_t pDcgmHandle,
+                                                   std::vector<char> &batch,
+                                                   unsigned int timeout);
 
 /*****************************************************************************/
 DCGM_PUBLIC_API dcgmReturn_t dcgmModuleSendBlockingFixedRequest(dcgmHandle_t pDcgmHandle,
@@ -55,3 +58,157 @@ DCGM_PUBLIC_API dcgmReturn_t dcgmModuleSendBlockingFixedRequest(dcgmHandle_t pDc
 }
 
 /*****************************************************************************/
+namespace
+{
+struct BatchEntry
+{
+    dcgm_module_command_header_t *moduleCommand;
+    size_t maxResponseSize;
+    dcgmReturn_t *status;
+};
+} // namespace
+
+struct dcgm_module_batch_st
+{
+    dcgmHandle_t dcgmHandle;
+    std::vector<BatchEntry> entries;
+    size_t requestSize;  /* Bytes of the DCGM_MSG_MODULE_COMMAND_BATCH so far */
+    size_t responseSize; /* Most bytes its response can be */
+};
+
+/*****************************************************************************/
+DCGM_PUBLIC_API dcgmReturn_t dcgmModuleBatchBegin(dcgmHandle_t pDcgmHandle, dcgmModuleBatch_t *batch)
+{
+    if (!batch)
+        return DCGM_ST_BADPARAM;
+
+    *batch                 = new dcgm_module_batch_st;
+    (*batch)->dcgmHandle   = pDcgmHandle;
+    (*batch)->requestSize  = sizeof(dcgm_msg_module_command_batch_t);
+    (*batch)->responseSize = sizeof(dcgm_msg_module_command_batch_t);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+DCGM_PUBLIC_API dcgmReturn_t dcgmModuleBatchAdd(dcgmModuleBatch_t batch,
+                                                dcgm_module_command_header_t *moduleCommand,
+                                                size_t maxResponseSize,
+                                                dcgmReturn_t *status)
+{
+    if (!batch || !moduleCommand || !status)
+        return DCGM_ST_BADPARAM;
+
+    if (moduleCommand->length < sizeof(*moduleCommand) || maxResponseSize < moduleCommand->length)
+    {
+        DCGM_LOG_ERROR << "Bad module param length " << moduleCommand->length << " or maxResponseSize "
+                       << maxResponseSize;
+        return DCGM_ST_BADPARAM;
+    }
+    if (moduleCommand->moduleId >= DcgmModuleIdCount)
+    {
+        PRINT_ERROR("%u", "Bad module ID %u", moduleCommand->moduleId);
+        return DCGM_ST_BADPARAM;
+    }
+
+    size_t const requestSize  = batch->requestSize + sizeof(dcgm_msg_module_command_batch_entry_t) + moduleCommand->length;
+    size_t const responseSize = batch->responseSize + sizeof(dcgm_msg_module_command_batch_entry_t) + maxResponseSize;
+    if (batch->entries.size() >= DCGM_MODULE_COMMAND_BATCH_MAX_COMMANDS || requestSize > DCGM_PROTO_MAX_MESSAGE_SIZE
+        || responseSize > DCGM_PROTO_MAX_MESSAGE_SIZE)
+    {
+        return DCGM_ST_INSUFFICIENT_SIZE;
+    }
+
+    batch->requestSize  = requestSize;
+    batch->responseSize = responseSize;
+    batch->entries.push_back({ moduleCommand, maxResponseSize, status });
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+static dcgmReturn_t SubmitBatch(dcgmModuleBatch_t batch, unsigned int timeout)
+{
+    if (batch->entries.empty())
+        return DCGM_ST_OK;
+
+    std::vector<char> message;
+    message.reserve(batch->requestSize);
+
+    dcgm_msg_module_command_batch_t batchHeader {};
+    batchHeader.version     = dcgm_msg_module_command_batch_version;
+    batchHeader.numCommands = batch->entries.size();
+    message.insert(message.end(), (char const *)&batchHeader, (char const *)&batchHeader + sizeof(batchHeader));
+
+    dcgm_msg_module_command_batch_entry_t entry {};
+    for (auto const &batchEntry : batch->entries)
+    {
+        char const *commandStart = (char const *)batchEntry.moduleCommand;
+        message.insert(message.end(), (char const *)&entry, (char const *)&entry + sizeof(entry));
+        message.insert(message.end(), commandStart, commandStart + batchEntry.moduleCommand->length);
+    }
+
+    dcgmReturn_t dcgmReturn = processModuleCommandBatchAtHostEngine(batch->dcgmHandle, message, timeout);
+    if (dcgmReturn != DCGM_ST_OK)
+        return dcgmReturn;
+
+    /* The response has the same layout as the request */
+    if (message.size() < sizeof(batchHeader)
+        || ((dcgm_msg_module_command_batch_t *)message.data())->numCommands != batch->entries.size())
+    {
+        DCGM_LOG_ERROR << "Module command batch response of " << message.size() << " bytes doesn't match the "
+                       << batch->entries.size() << " commands sent";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    size_t offset = sizeof(batchHeader);
+    for (auto const &batchEntry : batch->entries)
+    {
+        auto moduleCommand = (dcgm_module_command_header_t *)(message.data() + offset + sizeof(entry));
+        if (message.size() < offset + sizeof(entry) + sizeof(*moduleCommand)
+            || message.size() < offset + sizeof(entry) + moduleCommand->length)
+        {
+            DCGM_LOG_ERROR << "Module command batch response is truncated";
+            return DCGM_ST_GENERIC_ERROR;
+        }
+
+        memcpy(&entry, message.data() + offset, sizeof(entry));
+        offset += sizeof(entry) + moduleCommand->length;
+
+        if (moduleCommand->length > batchEntry.maxResponseSize)
+        {
+            DCGM_LOG_ERROR << "Module command response size " << moduleCommand->length
+                           << " was bigger than max allowed of " << batchEntry.maxResponseSize;
+            *batchEntry.status = DCGM_ST_GENERIC_ERROR;
+            continue;
+        }
+
+        memcpy(batchEntry.moduleCommand, moduleCommand, moduleCommand->length);
+        *batchEntry.status = (dcgmReturn_t)entry.status;
+    }
+
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+DCGM_PUBLIC_API dcgmReturn_t dcgmModuleBatchSubmit(dcgmModuleBatch_t batch, unsigned int timeout)
+{
+    if (!batch)
+        return DCGM_ST_BADPARAM;
+
+    dcgmReturn_t dcgmReturn = SubmitBatch(batch, timeout);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        for (auto const &batchEntry : batch->entries)
+        {
+            *batchEntry.status = dcgmReturn;
+        }
+    }
+
+    delete batch;
+    return dcgmReturn;
+}
+
+/*****************************************************************************/
+DCGM_PUBLIC_API void dcgmModuleBatchAbandon(dcgmModuleBatch_t batch)
+{
+    delete batch;
+}
@@ -42,6 +42,71 @@ DCGM_PUBLIC_API dcgmReturn_t dcgmModuleSendBlockingFixedRequest(dcgmHandle_t pDc
                                                                 std::unique_ptr<DcgmRequest> request = nullptr,
                                                                 unsigned int timeout                 = 60000);
 
+/*****************************************************************************/
+/*
+ * Batches of module commands
+ *
+ * Commands added to a batch are sent to the host engine together in one
+ * DCGM_MSG_MODULE_COMMAND_BATCH when the batch is submitted, which costs one
+ * round trip instead of one per command. The host engine processes them in the
+ * order they were added. Each command gets its own status, so one failing
+ * doesn't affect the others.
+ *
+ * Ex:
+ *     dcgmModuleBatch_t batch;
+ *     dcgmModuleBatchBegin(dcgmHandle, &batch);
+ *     dcgmModuleBatchAdd(batch, &msg1.header, sizeof(msg1), &status1);
+ *     dcgmModuleBatchAdd(batch, &msg2.header, sizeof(msg2), &status2);
+ *     dcgmReturn = dcgmModuleBatchSubmit(batch);
+ *
+ * Commands that need a DcgmRequest (see dcgmModuleSendBlockingFixedRequest)
+ * can't be batched.
+ */
+typedef struct dcgm_module_batch_st *dcgmModuleBatch_t;
+
+/*****************************************************************************/
+/*
+ * Start a batch of module commands for pDcgmHandle
+ *
+ * batch OUT: The new batch. Freed by dcgmModuleBatchSubmit or dcgmModuleBatchAbandon
+ */
+DCGM_PUBLIC_API dcgmReturn_t dcgmModuleBatchBegin(dcgmHandle_t pDcgmHandle, dcgmModuleBatch_t *batch);
+
+/*****************************************************************************/
+/*
+ * Add a command to a batch. Like with dcgmModuleSendBlockingFixedRequest,
+ * moduleCommand is updated with the response in place, which happens when the
+ * batch is submitted. moduleCommand and status must stay valid until then.
+ *
+ * status OUT: Set to what the command returned when the batch is submitted
+ *
+ * Returns: DCGM_ST_OK if the command was added
+ *          DCGM_ST_INSUFFICIENT_SIZE if the batch is full. Submit it and start another
+ *          DCGM_ST_BADPARAM if moduleCommand or maxResponseSize is invalid
+ */
+DCGM_PUBLIC_API dcgmReturn_t dcgmModuleBatchAdd(dcgmModuleBatch_t batch,
+                                                dcgm_module_command_header_t *moduleCommand,
+                                                size_t maxResponseSize,
+                                                dcgmReturn_t *status);
+
+/*****************************************************************************/
+/*
+ * Send the commands of a batch to the host engine and wait for their responses.
+ * Frees batch, even on failure.
+ *
+ * Returns: DCGM_ST_OK if the batch was processed. See each command's status for
+ *          how it went
+ *          DCGM_ST_? if the batch couldn't be processed. Every command's status
+ *          is set to this as well
+ */
+DCGM_PUBLIC_API dcgmReturn_t dcgmModuleBatchSubmit(dcgmModuleBatch_t batch, unsigned int timeout = 60000);
+
+/*****************************************************************************/
+/*
+ * Free a batch without sending it
+ */
+DCGM_PUBLIC_API void dcgmModuleBatchAbandon(dcgmModuleBatch_t batch);
+
 /*****************************************************************************/
 
 #endif // DCGMMODULEAPI_H
@@ -21,7 +21,18 @@
 
 DcgmCoreProxy::DcgmCoreProxy(const dcgmCoreCallbacks_t coreCallbacks)
     : m_coreCallbacks(coreCallbacks)
-{}
+{
+    /* Cores before version 2 of the callbacks don't have cacheAccess at all */
+    if (m_coreCallbacks.version < dcgmCoreCallbacks_version2)
+    {
+        m_coreCallbacks.cacheAccess = nullptr;
+    }
+    else if (m_coreCallbacks.cacheAccess != nullptr
+             && m_coreCallbacks.cacheAccess->version == dcgmCoreCacheAccess_version)
+    {
+        m_cacheAccess = m_coreCallbacks.cacheAccess;
+    }
+}
 
 void initializeCoreHeader(dcgm_module_command_header_t &header,
                           dcgmCoreReqCmd_t cmd,
@@ -626,6 +637,21 @@ dcgmReturn_t DcgmCoreProxy::GetInt64SummaryData(dcgm_field_entity_group_t entity
                                                 pfUseEntryForSummary pfUseEntryCB,
                                                 void *userData)
 {
+    if (m_cacheAccess != nullptr)
+    {
+        return m_cacheAccess->getInt64SummaryData(m_cacheAccess->cacheManager,
+                                                  entityGroupId,
+                                                  entityId,
+                                                  fieldId,
+                                                  numSummaryTypes,
+                                                  summaryTypes,
+                                                  summaryValues,
+                                                  startTime,
+                                                  endTime,
+                                                  pfUseEntryCB,
+                                                  userData);
+    }
+
     dcgmCoreGetInt64SummaryData_t gisd = {};
     gisd.request.entityGroupId         = entityGroupId;
     gisd.request.entityId              = entityId;
@@ -667,6 +693,12 @@ dcgmReturn_t DcgmCoreProxy::GetLatestSample(dcgm_field_entity_group_t entityGrou
                                             dcgmcm_sample_p sample,
                                             DcgmFvBuffer *fvBuffer)
 {
+    /* FvBuffers are only filled through requests */
+    if (m_cacheAccess != nullptr && fvBuffer == nullptr)
+    {
+        return m_cacheAccess->getLatestSample(m_cacheAccess->cacheManager, entityGroupId, entityId, fieldId, sample);
+    }
+
     dcgmCoreGetLatestSample_t gls = {};
     gls.request.entityGroupId     = entityGroupId;
     gls.request.entityId          = entityId;
@@ -709,6 +741,19 @@ dcgmReturn_t DcgmCoreProxy::GetSamples(dcgm_field_entity_group_t entityGroupId,
                                        timelib64_t endTime,
                                        dcgmOrder_t order)
 {
+    if (m_cacheAccess != nullptr)
+    {
+        return m_cacheAccess->getSamples(m_cacheAccess->cacheManager,
+                                         entityGroupId,
+                                         entityId,
+                                         fieldId,
+                                         samples,
+                                         Msamples,
+                                         startTime,
+                                         endTime,
+                                         order);
+    }
+
     dcgmCoreGetSamples_t gs = {};
     initializeCoreHeader(gs.header, DcgmCoreReqIdCMGetSamples, dcgmCoreGetSamples_version, sizeof(gs));
     gs.request.entityGroupId = entityGroupId;
@@ -863,6 +908,38 @@ dcgmReturn_t DcgmCoreProxy::GetMultipleLatestLiveSamples(std::vector<dcgmGroupEn
     return ret;
 }
 
+dcgmReturn_t DcgmCoreProxy::GetMultipleSamples(std::vector<dcgmcm_sample_query_t> const &queries,
+                                               timelib64_t startTime,
+                                               timelib64_t endTime,
+                                               int maxSamplesPerQuery,
+                                               DcgmFvBuffer *fvBuffer)
+{
+    dcgmCoreGetMultipleSamples_t gms = {};
+
+    initializeCoreHeader(
+        gms.header, DcgmCoreReqIdCMGetMultipleSamples, dcgmCoreGetMultipleSamples_version, sizeof(gms));
+    gms.request.queries            = queries.data();
+    gms.request.numQueries         = queries.size();
+    gms.request.startTime          = startTime;
+    gms.request.endTime            = endTime;
+    gms.request.maxSamplesPerQuery = maxSamplesPerQuery;
+    gms.response.fvBuffer          = fvBuffer;
+
+    dcgmReturn_t ret = m_coreCallbacks.postfunc(&gms.header, m_coreCallbacks.poster);
+
+    if (ret == DCGM_ST_OK)
+    {
+        ret = gms.response.ret;
+    }
+    else
+    {
+        DCGM_LOG_ERROR << "Error '" << errorString(ret) << "' while attempting to get samples of " << queries.size()
+                       << " entity/field pairs";
+    }
+
+    return ret;
+}
+
 dcgmReturn_t DcgmCoreProxy::RemoveFieldWatch(dcgm_field_entity_group_t entityGroupId,
                                              dcgm_field_eid_t entityId,
                                              unsigned short fieldId,
@@ -896,14 +973,15 @@ dcgmReturn_t DcgmCoreProxy::RemoveFieldWatch(dcgm_field_entity_group_t entityGro
     return ret;
 }
 
-dcgmReturn_t DcgmCoreProxy::AppendSamples(DcgmFvBuffer *fvBuffer)
+dcgmReturn_t DcgmCoreProxy::AppendSamples(DcgmFvBuffer &&fvBuffer)
 {
     dcgmCoreAppendSamples_t as = {};
-    as.request.buffer          = fvBuffer->GetBuffer();
+    as.request.fvBuffer        = &fvBuffer;
+    size_t bufferSize          = 0;
     size_t elementCount        = 0;
-    fvBuffer->GetSize(&as.request.bufferSize, &elementCount);
+    fvBuffer.GetSize(&bufferSize, &elementCount);
 
-    if (as.request.bufferSize < 1)
+    if (bufferSize < 1)
     {
         DCGM_LOG_ERROR << "AppendSamples got an empty fvBuffer";
         return DCGM_ST_BADPARAM;
@@ -1169,6 +1247,71 @@ dcgmReturn_t DcgmCoreProxy::NotifyRequestOfCompletion(dcgm_connection_id_t conne
     return ret;
 }
 
+dcgmReturn_t DcgmCoreProxy::SetModuleDispatch(dcgmModuleId_t moduleId,
+                                              unsigned int commandThreads,
+                                              unsigned long long inlineSubCommands)
+{
+    dcgmCoreSetModuleDispatch_t req = {};
+
+    initializeCoreHeader(req.header, DcgmCoreReqIdSetModuleDispatch, dcgmCoreSetModuleDispatch_version, sizeof(req));
+    req.request.moduleId          = moduleId;
+    req.request.commandThreads    = commandThreads;
+    req.request.inlineSubCommands = inlineSubCommands;
+
+    dcgmReturn_t ret = m_coreCallbacks.postfunc(&req.header, m_coreCallbacks.poster);
+
+    if (ret == DCGM_ST_OK)
+    {
+        return req.response;
+    }
+
+    return ret;
+}
+
+dcgmReturn_t DcgmCoreProxy::SetWatchPredicate(dcgm_field_entity_group_t entityGroupId,
+                                              dcgm_field_eid_t entityId,
+                                              unsigned short fieldId,
+                                              DcgmWatcherType_t watcherType,
+                                              dcgmcm_predicate_t const &predicate)
+{
+    dcgmCoreSetWatchPredicate_t req = {};
+
+    initializeCoreHeader(req.header, DcgmCoreReqIdCMSetWatchPredicate, dcgmCoreSetWatchPredicate_version, sizeof(req));
+    req.request.entityGroupId = entityGroupId;
+    req.request.entityId      = entityId;
+    req.request.fieldId       = fieldId;
+    req.request.watcherType   = watcherType;
+    req.request.predicate     = predicate;
+
+    dcgmReturn_t ret = m_coreCallbacks.postfunc(&req.header, m_coreCallbacks.poster);
+
+    if (ret == DCGM_ST_OK)
+    {
+        return req.response;
+    }
+
+    return ret;
+}
+
+dcgmReturn_t DcgmCoreProxy::SetPredicatesBypassed(DcgmWatcherType_t watcherType, bool bypassed)
+{
+    dcgmCoreSetPredicatesBypassed_t req = {};
+
+    initializeCoreHeader(
+        req.header, DcgmCoreReqIdCMSetPredicatesBypassed, dcgmCoreSetPredicatesBypassed_version, sizeof(req));
+    req.request.watcherType = watcherType;
+    req.request.bypassed    = bypassed;
+
+    dcgmReturn_t ret = m_coreCallbacks.postfunc(&req.header, m_coreCallbacks.poster);
+
+    if (ret == DCGM_ST_OK)
+    {
+        return req.response;
+    }
+
+    return ret;
+}
+
 dcgmReturn_t DcgmCoreProxy::PopulateFieldGroupGetAll(dcgmAllFieldGroup_t *allGroupInfo)
 {
     dcgmCorePopulateFieldGroups_t req = {};
@@ -1220,28 +1363,30 @@ dcgmReturn_t DcgmCoreProxy::GetFieldGroupFields(dcgmFieldGrp_t fieldGrp, std::ve
 dcgmReturn_t DcgmCoreProxy::PopulateWatchInfo(std::vector<dcgmCoreWatchInfo_t> &watchInfo,
                                               std::vector<unsigned short> *fieldIds)
 {
-    dcgmCorePopulateGlobalWatchInfo_t pwi = {};
+    /* The response holds every field's histograms. Too big for the stack */
+    auto pwi = std::make_unique<dcgmCorePopulateGlobalWatchInfo_t>();
 
     if (nullptr != fieldIds)
     {
-        pwi.request.fieldIds    = fieldIds->data();
-        pwi.request.numFieldIds = fieldIds->size();
+        pwi->request.fieldIds    = fieldIds->data();
+        pwi->request.numFieldIds = fieldIds->size();
     }
 
     watchInfo.clear();
-    initializeCoreHeader(pwi.header, DcgmCoreReqIdCMPopulateWatchInfo, dcgmCorePopulateWatchInfo_version, sizeof(pwi));
+    initializeCoreHeader(
+        pwi->header, DcgmCoreReqIdCMPopulateWatchInfo, dcgmCorePopulateWatchInfo_version, sizeof(*pwi));
 
     // coverity[overrun-buffer-val]
-    dcgmReturn_t ret = m_coreCallbacks.postfunc(&pwi.header, m_coreCallbacks.poster);
+    dcgmReturn_t ret = m_coreCallbacks.postfunc(&pwi->header, m_coreCallbacks.poster);
 
     if (ret == DCGM_ST_OK)
     {
-        for (unsigned int i = 0; i < pwi.response.numFields; i++)
+        for (unsigned int i = 0; i < pwi->response.numFields; i++)
         {
-            watchInfo.push_back(pwi.response.fields[i]);
+            watchInfo.push_back(pwi->response.fields[i]);
         }
 
-        ret = pwi.response.ret;
+        ret = pwi->response.ret;
     }
     else
     {
@@ -1254,29 +1399,30 @@ dcgmReturn_t DcgmCoreProxy::PopulateWatchInfo(std::vector<dcgmCoreWatchInfo_t> &
 dcgmReturn_t DcgmCoreProxy::PopulateGlobalWatchInfo(std::vector<dcgmCoreWatchInfo_t> &watchInfo,
                                                     std::vector<unsigned short> *fieldIds)
 {
-    dcgmCorePopulateGlobalWatchInfo_t pwi = {};
+    /* The response holds every field's histograms. Too big for the stack */
+    auto pwi = std::make_unique<dcgmCorePopulateGlobalWatchInfo_t>();
 
     if (nullptr != fieldIds)
     {
-        pwi.request.fieldIds    = fieldIds->data();
-        pwi.request.numFieldIds = fieldIds->size();
+        pwi->request.fieldIds    = fieldIds->data();
+        pwi->request.numFieldIds = fieldIds->size();
     }
 
     watchInfo.clear();
     initializeCoreHeader(
-        pwi.header, DcgmCoreReqIdCMPopulateGlobalWatchInfo, dcgmCorePopulateGlobalWatchInfo_version, sizeof(pwi));
+        pwi->header, DcgmCoreReqIdCMPopulateGlobalWatchInfo, dcgmCorePopulateGlobalWatchInfo_version, sizeof(*pwi));
 
     // coverity[overrun-buffer-val]
-    dcgmReturn_t ret = m_coreCallbacks.postfunc(&pwi.header, m_coreCallbacks.poster);
+    dcgmReturn_t ret = m_coreCallbacks.postfunc(&pwi->header, m_coreCallbacks.poster);
 
     if (ret == DCGM_ST_OK)
     {
-        for (unsigned int i = 0; i < pwi.response.numFields; i++)
+        for (unsigned int i = 0; i < pwi->response.numFields; i++)
         {
-            watchInfo.push_back(pwi.response.fields[i]);
+            watchInfo.push_back(pwi->response.fields[i]);
         }
 
-        ret = pwi.response.ret;
+        ret = pwi->response.ret;
     }
     else
     {
@@ -1290,33 +1436,34 @@ dcgmReturn_t DcgmCoreProxy::PopulateGpuWatchInfo(std::vector<dcgmCoreWatchInfo_t
                                                  unsigned int gpuId,
                                                  std::vector<unsigned short> *fieldIds)
 {
-    dcgmCorePopulateGpuWatchInfo_t pwi = {};
+    /* The response holds every field's histograms. Too big for the stack */
+    auto pwi = std::make_unique<dcgmCorePopulateGpuWatchInfo_t>();
 
-    pwi.request.gpuIds[0] = gpuId;
-    pwi.request.gpuCount  = 1;
+    pwi->request.gpuIds[0] = gpuId;
+    pwi->request.gpuCount  = 1;
 
     if (nullptr != fieldIds)
     {
-        pwi.request.fieldIds    = fieldIds->data();
-        pwi.request.numFieldIds = fieldIds->size();
+        pwi->request.fieldIds    = fieldIds->data();
+        pwi->request.numFieldIds = fieldIds->size();
     }
 
     watchInfo.clear();
 
     initializeCoreHeader(
-        pwi.header, DcgmCoreReqIdCMPopulateGpuWatchInfo, dcgmCorePopulateGpuWatchInfo_version, sizeof(pwi));
+        pwi->header, DcgmCoreReqIdCMPopulateGpuWatchInfo, dcgmCorePopulateGpuWatchInfo_version, sizeof(*pwi));
 
     // coverity[overrun-buffer-val]
-    dcgmReturn_t ret = m_coreCallbacks.postfunc(&pwi.header, m_coreCallbacks.poster);
+    dcgmReturn_t ret = m_coreCallbacks.postfunc(&pwi->header, m_coreCallbacks.poster);
 
     if (ret == DCGM_ST_OK)
     {
-        for (unsigned int i = 0; i < pwi.response.numFields; i++)
+        for (unsigned int i = 0; i < pwi->response.numFields; i++)
         {
-            watchInfo.push_back(pwi.response.fields[i]);
+            watchInfo.push_back(pwi->response.fields[i]);
         }
 
-        ret = pwi.response.ret;
+        ret = pwi->response.ret;
     }
     else
     {
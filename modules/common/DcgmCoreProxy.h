@@ -30,6 +30,9 @@ class DcgmCoreProxy
 public:
     /**
      * Constructor
+     *
+     * GetLatestSample(), GetSamples() and GetInt64SummaryData() read the cache directly if coreCallbacks has
+     * a dcgmCoreCacheAccess_t this was built for, and post requests to the core otherwise
      */
     explicit DcgmCoreProxy(dcgmCoreCallbacks_t coreCallbacks);
 
@@ -171,6 +174,37 @@ public:
      */
     dcgmReturn_t NotifyRequestOfCompletion(dcgm_connection_id_t connectionId, dcgm_request_id_t requestId);
 
+    /**
+     * @param[in] moduleId - the module that is setting how it is dispatched to
+     * @param[in] commandThreads - most threads of its own that process client commands to the module. 0 = inline
+     * @param[in] inlineSubCommands - bit N set = subCommand N is still processed on the caller's thread
+     */
+    dcgmReturn_t SetModuleDispatch(dcgmModuleId_t moduleId,
+                                   unsigned int commandThreads,
+                                   unsigned long long inlineSubCommands);
+
+    /**
+     * Only hands watcherType's subscribers the values of a watch that match predicate. See
+     * DcgmCacheManager::SetWatchPredicate()
+     *
+     * @param[in] entityGroupId - entity group of the watch
+     * @param[in] entityId - entity of the watch
+     * @param[in] fieldId - field of the watch
+     * @param[in] watcherType - watcher type whose subscribers the predicate filters for
+     * @param[in] predicate - which values are handed over. DcgmcmPredicateAll = every value
+     */
+    dcgmReturn_t SetWatchPredicate(dcgm_field_entity_group_t entityGroupId,
+                                   dcgm_field_eid_t entityId,
+                                   unsigned short fieldId,
+                                   DcgmWatcherType_t watcherType,
+                                   dcgmcm_predicate_t const &predicate);
+
+    /**
+     * @param[in] watcherType - watcher type whose predicates are bypassed or not
+     * @param[in] bypassed - hand watcherType's subscribers every value whatever their predicates?
+     */
+    dcgmReturn_t SetPredicatesBypassed(DcgmWatcherType_t watcherType, bool bypassed);
+
     /**
      * @param[out] allGroupInfo - populated on success
      */
@@ -276,6 +310,23 @@ public:
                                               std::vector<unsigned short> const &fieldIds,
                                               DcgmFvBuffer *fvBuffer);
 
+    /**
+     * Gets the samples of several entity/field pairs in one request to the core. See
+     * DcgmCacheManager::GetMultipleSamples()
+     *
+     * @param[in]  queries - the entity, field and order of each query
+     * @param[in]  startTime - the earliest timestamp a sample may have. 0 = from the beginning
+     * @param[in]  endTime - the latest timestamp a sample may have. 0 = up until the end
+     * @param[in]  maxSamplesPerQuery - the maximum number of samples to get for each query
+     * @param[out] fvBuffer - the buffer the samples are appended to in the order of queries. A query that
+     *                        fails appends one value with the error as its status
+     */
+    dcgmReturn_t GetMultipleSamples(std::vector<dcgmcm_sample_query_t> const &queries,
+                                    timelib64_t startTime,
+                                    timelib64_t endTime,
+                                    int maxSamplesPerQuery,
+                                    DcgmFvBuffer *fvBuffer);
+
     /**
      * @param[in] entityGroupId - which entity group we are dealing with
      * @param[in] entityId - the id of that entity
@@ -291,9 +342,10 @@ public:
                                   DcgmWatcher watcher);
 
     /**
-     * @param[in] fvBuffer - buffer of field values to add to the cache
+     * @param[in] fvBuffer - buffer of field values to add to the cache. The cache takes its samples
+     *                       without copying them, so it is left empty
      */
-    dcgmReturn_t AppendSamples(DcgmFvBuffer *fvBuffer);
+    dcgmReturn_t AppendSamples(DcgmFvBuffer &&fvBuffer);
 
     /**
      * @param[in] gpuId - the id of the GPU whose calue is being set
@@ -450,6 +502,7 @@ public:
 
 private:
     dcgmCoreCallbacks_t m_coreCallbacks;
+    dcgmCoreCacheAccess_t const *m_cacheAccess = nullptr; // Direct cache access. nullptr = post requests instead
 
     dcgmReturn_t GetMigInstanceEntityIdHelper(unsigned int gpuId,
                                               DcgmNs::Mig::Nvml::GpuInstanceId const &instanceId,
@@ -23,6 +23,8 @@
 
 #include "DcgmLogging.h"
 #include <dcgm_nvml.h>
+#include <system_error>
+#include <thread>
 
 DcgmConfigManager::DcgmConfigManager(dcgmCoreCallbacks_t &dcc)
     : mpCoreProxy(dcc)
@@ -276,7 +278,14 @@ static void dcmBlankConfig(dcgmConfig_t *config, unsigned int gpuId)
 /*****************************************************************************/
 dcgmConfig_t *DcgmConfigManager::HelperGetTargetConfig(unsigned int gpuId)
 {
-    dcgmConfig_t *retVal = 0;
+    dcgmConfig_t *retVal = m_activeConfig[gpuId];
+
+    /* Target configs aren't freed until we are destroyed, so an existing one can be used without the lock.
+       This is how per-GPU threads get theirs while the thread that started them holds m_mutex */
+    if (retVal)
+    {
+        return retVal;
+    }
 
     dcgmMutexReturn_t mutexSt = dcgm_mutex_lock_me(m_mutex);
 
@@ -675,6 +684,40 @@ dcgmReturn_t DcgmConfigManager::GetTargetConfig(unsigned int groupId,
     return multiRetCode;
 }
 
+/*****************************************************************************/
+/* Does enforcing target need a set call, given the current value? Blank targets are never enforced */
+static bool dcmValueDiffers(int target, int current)
+{
+    return !DCGM_INT32_IS_BLANK(target) && target != current;
+}
+
+/*****************************************************************************/
+unsigned int DcgmConfigSettingsToEnforce(dcgmConfig_t const &target, dcgmConfig_t const &current)
+{
+    unsigned int settings = 0;
+
+    if (dcmValueDiffers(target.powerLimit.val, current.powerLimit.val))
+    {
+        settings |= DCM_SETTING_POWER_LIMIT;
+    }
+
+    dcgmClockSet_t const &targetClocks  = target.perfState.targetClocks;
+    dcgmClockSet_t const &currentClocks = current.perfState.targetClocks;
+    if ((targetClocks.memClock == 0 && targetClocks.smClock == 0)
+        || dcmValueDiffers(targetClocks.memClock, currentClocks.memClock)
+        || dcmValueDiffers(targetClocks.smClock, currentClocks.smClock))
+    {
+        settings |= DCM_SETTING_CLOCKS;
+    }
+
+    if (dcmValueDiffers(target.computeMode, current.computeMode))
+    {
+        settings |= DCM_SETTING_COMPUTE_MODE;
+    }
+
+    return settings;
+}
+
 /*****************************************************************************/
 dcgmReturn_t DcgmConfigManager::HelperEnforceConfig(unsigned int gpuId, DcgmConfigManagerStatusList *statusList)
 {
@@ -701,6 +744,11 @@ dcgmReturn_t DcgmConfigManager::HelperEnforceConfig(unsigned int gpuId, DcgmConf
         return DCGM_ST_GENERIC_ERROR;
     }
 
+    /* Only make the set calls whose target differs from the current state. Usually nothing does.
+       changes lists what we set for the log */
+    unsigned int settingsToSet = DcgmConfigSettingsToEnforce(*activeConfig, currentConfig);
+    std::stringstream changes;
+
     /* Set Ecc Mode */
     /* Always keep setting ECC mode as first. (might trigger GPU reset) */
     bool isResetNeeded = false;
@@ -714,34 +762,62 @@ dcgmReturn_t DcgmConfigManager::HelperEnforceConfig(unsigned int gpuId, DcgmConf
     if (isResetNeeded)
     {
         PRINT_WARNING("%d %d", "For GPU ID %d, reset can't be performed: %d", gpuId, dcgmReturn);
+        changes << " ECC mode " << currentConfig.eccMode << " -> " << activeConfig->eccMode << " (pending);";
 
         multiPropertyRetCode++;
         statusList->AddStatus(gpuId, DCGM_FI_DEV_ECC_CURRENT, DCGM_ST_RESET_REQUIRED);
     }
 
     /* Set Power Limit */
-    dcgmReturn = HelperSetPowerLimit(gpuId, activeConfig);
-    if (DCGM_ST_OK != dcgmReturn)
+    if (settingsToSet & DCM_SETTING_POWER_LIMIT)
     {
-        multiPropertyRetCode++;
-        statusList->AddStatus(gpuId, DCGM_FI_DEV_POWER_MGMT_LIMIT, dcgmReturn);
+        changes << " power limit " << currentConfig.powerLimit.val << " -> " << activeConfig->powerLimit.val << ";";
+
+        dcgmReturn = HelperSetPowerLimit(gpuId, activeConfig);
+        if (DCGM_ST_OK != dcgmReturn)
+        {
+            multiPropertyRetCode++;
+            statusList->AddStatus(gpuId, DCGM_FI_DEV_POWER_MGMT_LIMIT, dcgmReturn);
+        }
     }
 
     /* Set Perf States */
-    dcgmReturn = HelperSetPerfState(gpuId, activeConfig);
-    if (DCGM_ST_OK != dcgmReturn)
+    if (settingsToSet & DCM_SETTING_CLOCKS)
     {
-        multiPropertyRetCode++;
-        statusList->AddStatus(gpuId, DCGM_FI_DEV_APP_SM_CLOCK, dcgmReturn);
-        statusList->AddStatus(gpuId, DCGM_FI_DEV_APP_MEM_CLOCK, dcgmReturn);
+        dcgmClockSet_t const &targetClocks  = activeConfig->perfState.targetClocks;
+        dcgmClockSet_t const &currentClocks = currentConfig.perfState.targetClocks;
+        changes << " clocks " << currentClocks.memClock << "," << currentClocks.smClock << " -> "
+                << targetClocks.memClock << "," << targetClocks.smClock << ";";
+
+        dcgmReturn = HelperSetPerfState(gpuId, activeConfig);
+        if (DCGM_ST_OK != dcgmReturn)
+        {
+            multiPropertyRetCode++;
+            statusList->AddStatus(gpuId, DCGM_FI_DEV_APP_SM_CLOCK, dcgmReturn);
+            statusList->AddStatus(gpuId, DCGM_FI_DEV_APP_MEM_CLOCK, dcgmReturn);
+        }
     }
 
     /* Set Compute Mode */
-    dcgmReturn = HelperSetComputeMode(gpuId, activeConfig);
-    if (DCGM_ST_OK != dcgmReturn)
+    if (settingsToSet & DCM_SETTING_COMPUTE_MODE)
     {
-        multiPropertyRetCode++;
-        statusList->AddStatus(gpuId, DCGM_FI_DEV_COMPUTE_MODE, dcgmReturn);
+        changes << " compute mode " << currentConfig.computeMode << " -> " << activeConfig->computeMode << ";";
+
+        dcgmReturn = HelperSetComputeMode(gpuId, activeConfig);
+        if (DCGM_ST_OK != dcgmReturn)
+        {
+            multiPropertyRetCode++;
+            statusList->AddStatus(gpuId, DCGM_FI_DEV_COMPUTE_MODE, dcgmReturn);
+        }
+    }
+
+    if (changes.str().empty())
+    {
+        DCGM_LOG_DEBUG << "The configuration of gpuId " << gpuId << " already matches. Nothing was set.";
+    }
+    else
+    {
+        DCGM_LOG_INFO << "Enforced the configuration of gpuId " << gpuId << ":" << changes.str();
     }
 
     /* If any of the operation failed. Return it as an generic error */
@@ -755,6 +831,15 @@ dcgmReturn_t DcgmConfigManager::HelperEnforceConfig(unsigned int gpuId, DcgmConf
 
 /*****************************************************************************/
 dcgmReturn_t DcgmConfigManager::EnforceConfigGpu(unsigned int gpuId, DcgmConfigManagerStatusList *statusList)
+{
+    /* Get the lock for the remainder of this call */
+    DcgmLockGuard lockGuard(m_mutex);
+
+    return HelperEnforceConfigGpu(gpuId, statusList);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmConfigManager::HelperEnforceConfigGpu(unsigned int gpuId, DcgmConfigManagerStatusList *statusList)
 {
     dcgmReturn_t dcgmRet;
 
@@ -772,9 +857,6 @@ dcgmReturn_t DcgmConfigManager::EnforceConfigGpu(unsigned int gpuId, DcgmConfigM
         return DCGM_ST_BADPARAM;
     }
 
-    /* Get the lock for the remainder of this call */
-    DcgmLockGuard lockGuard(m_mutex);
-
     dcgmRet = HelperEnforceConfig(gpuId, statusList);
     if (DCGM_ST_OK != dcgmRet)
     {
@@ -866,17 +948,20 @@ dcgmReturn_t DcgmConfigManager::SetConfig(unsigned int groupId,
         }
     }
 
-    /* Loop through the group to set configuration for each GPU */
+    /* Set configuration for each GPU. The threads can't create target configs themselves while we hold the lock */
     for (index = 0; index < gpuIds.size(); index++)
     {
-        unsigned int gpuId = gpuIds[index];
-        dcgmReturn         = SetConfigGpu(gpuId, setConfig, statusList);
-        if (DCGM_ST_OK != dcgmReturn)
+        HelperGetTargetConfig(gpuIds[index]);
+    }
+
+    grpRetCode += HelperForEachGpu(gpuIds, statusList, [this, setConfig](unsigned int gpuId, auto *gpuStatusList) {
+        dcgmReturn_t ret = SetConfigGpu(gpuId, setConfig, gpuStatusList);
+        if (DCGM_ST_OK != ret)
         {
-            PRINT_ERROR("%d %u", "SetConfig failed with %d for gpuId %u", dcgmReturn, gpuId);
-            grpRetCode++;
+            PRINT_ERROR("%d %u", "SetConfig failed with %d for gpuId %u", ret, gpuId);
         }
-    }
+        return ret;
+    });
 
     /* Special handling for sync boost */
     dcgmReturn = SetSyncBoost(&gpuIds[0], gpuIds.size(), setConfig, statusList);
@@ -928,15 +1013,10 @@ dcgmReturn_t DcgmConfigManager::EnforceConfigGroup(unsigned int groupId, DcgmCon
     /* Acquire the lock for the remainder of the function */
     DcgmLockGuard lockGuard(m_mutex);
 
-    /* Loop through the group to set configuration for each GPU */
-    for (index = 0; index < (int)gpuIds.size(); index++)
-    {
-        unsigned int gpuId;
-        gpuId      = gpuIds[index];
-        dcgmReturn = EnforceConfigGpu(gpuId, statusList);
-        if (DCGM_ST_OK != dcgmReturn)
-            grpRetCode++;
-    }
+    /* Enforce the configuration of each GPU. Enforcing only reads existing target configs */
+    grpRetCode = HelperForEachGpu(gpuIds, statusList, [this](unsigned int gpuId, auto *gpuStatusList) {
+        return HelperEnforceConfigGpu(gpuId, gpuStatusList);
+    });
 
     if (0 == grpRetCode)
         return DCGM_ST_OK;
@@ -945,3 +1025,70 @@ dcgmReturn_t DcgmConfigManager::EnforceConfigGroup(unsigned int groupId, DcgmCon
 }
 
 /*****************************************************************************/
+unsigned int DcgmConfigManager::HelperForEachGpu(
+    std::vector<unsigned int> const &gpuIds,
+    DcgmConfigManagerStatusList *statusList,
+    std::function<dcgmReturn_t(unsigned int, DcgmConfigManagerStatusList *)> perGpu)
+{
+    struct GpuWork
+    {
+        std::vector<dcgm_config_status_t> statuses;
+        unsigned int statusCount = 0;
+        dcgmReturn_t ret         = DCGM_ST_OK;
+    };
+
+    std::vector<GpuWork> work(gpuIds.size());
+    std::vector<std::thread> threads;
+    threads.reserve(gpuIds.size());
+
+    for (size_t i = 0; i < gpuIds.size(); i++)
+    {
+        work[i].statuses.resize(statusList->m_maxNumErrors);
+        auto runGpu = [&, i] {
+            DcgmConfigManagerStatusList gpuStatusList(
+                statusList->m_maxNumErrors, &work[i].statusCount, work[i].statuses.data());
+            work[i].ret = perGpu(gpuIds[i], &gpuStatusList);
+        };
+
+        if (gpuIds.size() == 1)
+        {
+            runGpu();
+            continue;
+        }
+
+        try
+        {
+            threads.emplace_back(runGpu);
+        }
+        catch (std::system_error const &e)
+        {
+            DCGM_LOG_WARNING << "Couldn't start a thread for gpuId " << gpuIds[i] << ": " << e.what()
+                             << ". Configuring it from this thread.";
+            runGpu();
+        }
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    unsigned int failedCount = 0;
+    for (auto const &gpuWork : work)
+    {
+        for (unsigned int i = 0; i < gpuWork.statusCount; i++)
+        {
+            dcgm_config_status_t const &status = gpuWork.statuses[i];
+            statusList->AddStatus(status.gpuId, status.fieldId, status.errorCode);
+        }
+
+        if (gpuWork.ret != DCGM_ST_OK)
+        {
+            failedCount++;
+        }
+    }
+
+    return failedCount;
+}
+
+/*****************************************************************************/
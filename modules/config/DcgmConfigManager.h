@@ -26,8 +26,11 @@
 #include "dcgm_agent.h"
 #include "dcgm_config_structs.h"
 #include <DcgmCoreProxy.h>
+#include <atomic>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <vector>
 
 
 #include <DcgmModule.h>
@@ -62,6 +65,21 @@ public:
     }
 };
 
+/* Settings of a configuration, as bits of the mask DcgmConfigSettingsToEnforce() returns */
+#define DCM_SETTING_POWER_LIMIT  0x1
+#define DCM_SETTING_CLOCKS       0x2
+#define DCM_SETTING_COMPUTE_MODE 0x4
+
+/*****************************************************************************
+ * Which settings of target have to be set to enforce it on a GPU that is
+ * configured as current. Those are the ones that differ from current, except
+ * that blank targets are never set. 0,0 clocks reset the clocks to defaults
+ * we can't compare against, so they are always set. ECC isn't included:
+ * HelperSetEccMode() compares it itself
+ *
+ * Returns: A mask of DCM_SETTING_*
+ *****************************************************************************/
+unsigned int DcgmConfigSettingsToEnforce(dcgmConfig_t const &target, dcgmConfig_t const &current);
 
 class DcgmConfigManager
 {
@@ -170,6 +188,27 @@ private:
      *****************************************************************************/
     dcgmReturn_t HelperEnforceConfig(unsigned int gpuId, DcgmConfigManagerStatusList *statusList);
 
+    /*****************************************************************************
+     * EnforceConfigGpu() for a caller that already holds m_mutex, directly or
+     * through the thread that handed it this GPU
+     *****************************************************************************/
+    dcgmReturn_t HelperEnforceConfigGpu(unsigned int gpuId, DcgmConfigManagerStatusList *statusList);
+
+    /*****************************************************************************
+     * Call perGpu for each of gpuIds, each GPU on its own thread, so that the slow
+     * NVML set calls of different GPUs overlap. The calls for one GPU still happen
+     * in order. Each GPU gets its own status list; these are added to statusList
+     * in the order of gpuIds once all GPUs are done.
+     *
+     * The caller holds m_mutex for the duration and must have created the target
+     * configs of gpuIds, since perGpu can't take m_mutex itself.
+     *
+     * Returns the number of GPUs for which perGpu didn't return DCGM_ST_OK
+     *****************************************************************************/
+    unsigned int HelperForEachGpu(std::vector<unsigned int> const &gpuIds,
+                                  DcgmConfigManagerStatusList *statusList,
+                                  std::function<dcgmReturn_t(unsigned int, DcgmConfigManagerStatusList *)> perGpu);
+
     /*****************************************************************************
      * Populate a dcgmConfig_t with the current LIVE config for a GPU from the cache manager
      *****************************************************************************/
@@ -190,7 +229,7 @@ private:
     dcgmConfig_t *m_activeConfig[DCGM_MAX_NUM_DEVICES];
 
     DcgmCoreProxy mpCoreProxy;
-    unsigned int mClocksConfigured;
+    std::atomic<unsigned int> mClocksConfigured;
 
     DcgmMutex *m_mutex; /* Lock used for accessing default config data structure */
 };
@@ -25,6 +25,9 @@ DcgmModuleConfig::DcgmModuleConfig(dcgmCoreCallbacks_t &dcc)
     : DcgmModuleWithCoreProxy(dcc)
 {
     mpConfigManager = std::make_unique<DcgmConfigManager>(dcc);
+
+    /* Setting and enforcing configs makes slow NVML calls for every GPU */
+    ProcessClientCommandsOnOwnThread();
 }
 
 /*****************************************************************************/
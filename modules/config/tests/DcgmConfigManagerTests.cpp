@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmConfigManager.h>
+
+namespace
+{
+/* A GPU at 250 W, clocks 877,1380 and compute mode 0 */
+dcgmConfig_t CurrentConfig()
+{
+    dcgmConfig_t config {};
+    config.version                         = dcgmConfig_version;
+    config.eccMode                         = 1;
+    config.computeMode                     = 0;
+    config.perfState.syncBoost             = DCGM_INT32_BLANK;
+    config.perfState.targetClocks.version  = dcgmClockSet_version;
+    config.perfState.targetClocks.memClock = 877;
+    config.perfState.targetClocks.smClock  = 1380;
+    config.powerLimit.type                 = DCGM_CONFIG_POWER_CAP_INDIVIDUAL;
+    config.powerLimit.val                  = 250;
+    return config;
+}
+
+/* A target that doesn't set anything */
+dcgmConfig_t BlankConfig()
+{
+    dcgmConfig_t config {};
+    config.version                         = dcgmConfig_version;
+    config.eccMode                         = DCGM_INT32_BLANK;
+    config.computeMode                     = DCGM_INT32_BLANK;
+    config.perfState.syncBoost             = DCGM_INT32_BLANK;
+    config.perfState.targetClocks.version  = dcgmClockSet_version;
+    config.perfState.targetClocks.memClock = DCGM_INT32_BLANK;
+    config.perfState.targetClocks.smClock  = DCGM_INT32_BLANK;
+    config.powerLimit.type                 = DCGM_CONFIG_POWER_CAP_INDIVIDUAL;
+    config.powerLimit.val                  = DCGM_INT32_BLANK;
+    return config;
+}
+} // namespace
+
+TEST_CASE("ConfigManager: Enforcing a matching configuration sets nothing")
+{
+    dcgmConfig_t current = CurrentConfig();
+
+    CHECK(DcgmConfigSettingsToEnforce(current, current) == 0);
+    CHECK(DcgmConfigSettingsToEnforce(BlankConfig(), current) == 0);
+}
+
+TEST_CASE("ConfigManager: Only settings that differ are enforced")
+{
+    dcgmConfig_t current = CurrentConfig();
+    dcgmConfig_t target  = BlankConfig();
+
+    target.powerLimit.val = 200;
+    CHECK(DcgmConfigSettingsToEnforce(target, current) == DCM_SETTING_POWER_LIMIT);
+
+    /* Either clock differing sets both */
+    target                                 = BlankConfig();
+    target.perfState.targetClocks.memClock = 877;
+    target.perfState.targetClocks.smClock  = 1530;
+    CHECK(DcgmConfigSettingsToEnforce(target, current) == DCM_SETTING_CLOCKS);
+    target.perfState.targetClocks.smClock = DCGM_INT32_BLANK;
+    CHECK(DcgmConfigSettingsToEnforce(target, current) == 0);
+
+    target             = BlankConfig();
+    target.computeMode = 2;
+    CHECK(DcgmConfigSettingsToEnforce(target, current) == DCM_SETTING_COMPUTE_MODE);
+
+    /* ECC is left to HelperSetEccMode() */
+    target         = BlankConfig();
+    target.eccMode = 0;
+    CHECK(DcgmConfigSettingsToEnforce(target, current) == 0);
+
+    target                = CurrentConfig();
+    target.powerLimit.val = 300;
+    target.computeMode    = 1;
+    CHECK(DcgmConfigSettingsToEnforce(target, current) == (DCM_SETTING_POWER_LIMIT | DCM_SETTING_COMPUTE_MODE));
+}
+
+TEST_CASE("ConfigManager: Resetting the clocks is always enforced")
+{
+    dcgmConfig_t current = CurrentConfig();
+    dcgmConfig_t target  = BlankConfig();
+
+    target.perfState.targetClocks.memClock = 0;
+    target.perfState.targetClocks.smClock  = 0;
+    CHECK(DcgmConfigSettingsToEnforce(target, current) == DCM_SETTING_CLOCKS);
+
+    /* Even if the GPU reports 0,0 itself */
+    current.perfState.targetClocks.memClock = 0;
+    current.perfState.targetClocks.smClock  = 0;
+    CHECK(DcgmConfigSettingsToEnforce(target, current) == DCM_SETTING_CLOCKS);
+}
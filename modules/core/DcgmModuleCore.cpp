@@ -14,12 +14,18 @@
  * limitations under the License.
  */
 #include "DcgmModuleCore.h"
+#include "DcgmBinaryLog.h"
 #include "DcgmLogging.h"
+#include "DcgmMutex.h"
+#include "DcgmSettings.h"
+#include "DcgmTrace.h"
 #include "nvswitch/dcgm_nvswitch_structs.h"
 #include <DcgmGroupManager.h>
 #include <DcgmHostEngineHandler.h>
 #include <DcgmStringHelpers.h>
 #include <DcgmVersion.hpp>
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
 extern "C" dcgmReturn_t dcgm_core_process_message(DcgmModule *module, dcgm_module_command_header_t *moduleCommand)
@@ -110,6 +116,29 @@ dcgmReturn_t DcgmModuleCore::ProcessMessage(dcgm_module_command_header_t *module
                 dcgmReturn
                     = ProcessGetMultipleValuesForField(*(dcgm_core_msg_get_multiple_values_for_field_t *)moduleCommand);
                 break;
+            case DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES:
+                dcgmReturn
+                    = ProcessGetMultipleLatestValues(*(dcgm_core_msg_get_multiple_latest_values_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX:
+                dcgmReturn
+                    = ProcessGetLatestValuesMatrix(*(dcgm_core_msg_get_latest_values_matrix_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES:
+                dcgmReturn
+                    = ProcessGetFieldMultipleValues(*(dcgm_core_msg_get_field_multiple_values_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_GET_TRANSPORT_STATS:
+                dcgmReturn = ProcessGetTransportStats(*(dcgm_core_msg_get_transport_stats_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_ATTRIBUTE_CACHE_SUBSCRIBE:
+                dcgmReturn
+                    = ProcessAttributeCacheSubscribe(*(dcgm_core_msg_attribute_cache_subscribe_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_GET_BUCKETED_VALUES_FOR_FIELD:
+                dcgmReturn
+                    = ProcessGetBucketedValuesForField(*(dcgm_core_msg_get_bucketed_values_for_field_t *)moduleCommand);
+                break;
             case DCGM_CORE_SR_WATCH_FIELD_VALUE:
                 dcgmReturn = ProcessWatchFieldValue(*(dcgm_core_msg_watch_field_value_t *)moduleCommand);
                 break;
@@ -132,6 +161,9 @@ dcgmReturn_t DcgmModuleCore::ProcessMessage(dcgm_module_command_header_t *module
             case DCGM_CORE_SR_UNWATCH_FIELDS:
                 dcgmReturn = ProcessUnwatchFields(*(dcgm_core_msg_watch_fields_t *)moduleCommand);
                 break;
+            case DCGM_CORE_SR_WATCH_FIELDS_SNAPSHOT:
+                dcgmReturn = ProcessWatchFields(*(dcgm_core_msg_watch_fields_t *)moduleCommand, true);
+                break;
             case DCGM_CORE_SR_GET_TOPOLOGY:
                 dcgmReturn = ProcessGetTopology(*(dcgm_core_msg_get_topology_t *)moduleCommand);
                 break;
@@ -186,6 +218,53 @@ dcgmReturn_t DcgmModuleCore::ProcessMessage(dcgm_module_command_header_t *module
                 dcgmReturn
                     = ProcessGetGpuInstanceHierarchy(*(dcgm_core_msg_get_gpu_instance_hierarchy_t *)moduleCommand);
                 break;
+            case DCGM_CORE_SR_TRACE_CONTROL:
+                dcgmReturn = ProcessTraceControl(*(dcgm_core_msg_trace_control_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_FV_STREAM_SUBSCRIBE:
+                dcgmReturn = ProcessFvStreamSubscribe(*(dcgm_core_msg_fv_stream_subscribe_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_FV_STREAM_UNSUBSCRIBE:
+                dcgmReturn = ProcessFvStreamUnsubscribe(*(dcgm_core_msg_fv_stream_unsubscribe_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_PROXY_STREAM_SUBSCRIBE:
+                dcgmReturn = ProcessProxyStreamSubscribe(*(dcgm_core_msg_proxy_stream_subscribe_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_PROXY_STREAM_UNSUBSCRIBE:
+                dcgmReturn
+                    = ProcessProxyStreamUnsubscribe(*(dcgm_core_msg_proxy_stream_unsubscribe_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_PROXY_GET_HOSTS:
+                dcgmReturn = ProcessProxyGetHosts(*(dcgm_core_msg_proxy_get_hosts_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_GET_WORKER_STATS:
+                dcgmReturn = ProcessGetWorkerStats(*(dcgm_core_msg_get_worker_stats_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_GET_REQUEST_STATS:
+                dcgmReturn = ProcessGetRequestStats(*(dcgm_core_msg_get_request_stats_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_GET_MEMORY_ACCOUNTING:
+                dcgmReturn = ProcessGetMemoryAccounting(*(dcgm_core_msg_get_memory_accounting_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_SESSION_GET_TOKEN:
+            case DCGM_CORE_SR_SESSION_RESUME:
+                dcgmReturn = ProcessSession(moduleCommand->subCommand, *(dcgm_core_msg_session_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_ESTIMATE_WATCH_COST:
+                dcgmReturn = ProcessEstimateWatchCost(*(dcgm_core_msg_estimate_watch_cost_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_INJECT_FIELD_VALUES:
+                dcgmReturn = ProcessInjectFieldValues(*(dcgm_core_msg_inject_field_values_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_JOB_GET_PERCENTILES:
+                dcgmReturn = ProcessJobGetPercentiles(*(dcgm_core_msg_job_get_percentiles_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_JOB_GET_STATS_SINCE:
+                dcgmReturn = ProcessJobGetStatsSince(*(dcgm_core_msg_job_get_stats_since_t *)moduleCommand);
+                break;
+            case DCGM_CORE_SR_SET_DERIVED_FIELD:
+                dcgmReturn = ProcessSetDerivedField(*(dcgm_core_msg_set_derived_field_t *)moduleCommand);
+                break;
             default:
                 DCGM_LOG_DEBUG << "Unknown subcommand: " << static_cast<int>(moduleCommand->subCommand);
                 return DCGM_ST_FUNCTION_NOT_FOUND;
@@ -494,7 +573,7 @@ dcgmReturn_t DcgmModuleCore::ProcessJobStartStats(dcgm_core_msg_job_cmd_t &msg)
         return DCGM_ST_OK;
     }
 
-    std::string jobName(msg.jc.jobId, sizeof(msg.jc.jobId));
+    std::string jobName(msg.jc.jobId, strnlen(msg.jc.jobId, sizeof(msg.jc.jobId)));
 
     ret = DcgmHostEngineHandler::Instance()->JobStartStats(jobName, groupId);
 
@@ -513,7 +592,7 @@ dcgmReturn_t DcgmModuleCore::ProcessJobStopStats(dcgm_core_msg_job_cmd_t &msg)
         return ret;
     }
 
-    std::string jobName(msg.jc.jobId, sizeof(msg.jc.jobId));
+    std::string jobName(msg.jc.jobId, strnlen(msg.jc.jobId, sizeof(msg.jc.jobId)));
 
     msg.jc.cmdRet = DcgmHostEngineHandler::Instance()->JobStopStats(jobName);
 
@@ -530,12 +609,44 @@ dcgmReturn_t DcgmModuleCore::ProcessJobGetStats(dcgm_core_msg_job_get_stats_t &m
         return ret;
     }
 
-    std::string jobName(msg.jc.jobId, sizeof(msg.jc.jobId));
+    std::string jobName(msg.jc.jobId, strnlen(msg.jc.jobId, sizeof(msg.jc.jobId)));
 
     msg.jc.cmdRet = DcgmHostEngineHandler::Instance()->JobGetStats(jobName, &msg.jc.jobStats);
     return DCGM_ST_OK;
 }
 
+dcgmReturn_t DcgmModuleCore::ProcessJobGetStatsSince(dcgm_core_msg_job_get_stats_since_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_job_get_stats_since_version);
+
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    std::string jobName(msg.jobId, strnlen(msg.jobId, sizeof(msg.jobId)));
+
+    msg.cmdRet = DcgmHostEngineHandler::Instance()->JobGetStatsSince(jobName, msg.updateSequence, &msg.jobStats);
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessJobGetPercentiles(dcgm_core_msg_job_get_percentiles_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_job_get_percentiles_version);
+
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    std::string jobName(msg.jobId, strnlen(msg.jobId, sizeof(msg.jobId)));
+
+    msg.cmdRet = DcgmHostEngineHandler::Instance()->JobGetPercentiles(jobName, msg.percentiles);
+    return DCGM_ST_OK;
+}
+
 dcgmReturn_t DcgmModuleCore::ProcessJobRemove(dcgm_core_msg_job_cmd_t &msg)
 {
     dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_job_cmd_version);
@@ -546,7 +657,7 @@ dcgmReturn_t DcgmModuleCore::ProcessJobRemove(dcgm_core_msg_job_cmd_t &msg)
         return ret;
     }
 
-    std::string jobName(msg.jc.jobId, sizeof(msg.jc.jobId));
+    std::string jobName(msg.jc.jobId, strnlen(msg.jc.jobId, sizeof(msg.jc.jobId)));
 
     msg.jc.cmdRet = DcgmHostEngineHandler::Instance()->JobRemove(jobName);
 
@@ -580,87 +691,138 @@ dcgmReturn_t DcgmModuleCore::ProcessHostengineVersion(dcgm_core_msg_hostengine_v
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmModuleCore::ProcessEntitiesGetLatestValues(dcgm_core_msg_entities_get_latest_values_t &msg)
+dcgmReturn_t DcgmModuleCore::ResolveEntitiesAndFields(unsigned int groupId,
+                                                      dcgmGroupEntityPair_t const *entityList,
+                                                      unsigned int entitiesCount,
+                                                      unsigned int fieldGroupId,
+                                                      unsigned short const *fieldIdList,
+                                                      unsigned int fieldIdCount,
+                                                      std::vector<dcgmGroupEntityPair_t> &entities,
+                                                      std::vector<unsigned short> &fieldIds)
 {
-    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_entities_get_latest_values_version);
-    if (DCGM_ST_OK != ret)
-    {
-        DCGM_LOG_ERROR << "Version mismatch";
-        return ret;
-    }
-
-    /* initialize length of response to handle failure cases */
-    msg.header.length = sizeof(dcgm_core_msg_entities_get_latest_values_t) - SAMPLES_BUFFER_SIZE;
-
-    std::vector<dcgmGroupEntityPair_t> entities;
-    std::vector<unsigned short> fieldIds;
+    dcgmReturn_t ret;
 
     /* Convert the entity group to a list of entities */
-    if (msg.ev.entitiesCount == 0)
+    if (entitiesCount == 0)
     {
-        unsigned int groupId = msg.ev.groupId;
+        unsigned int realGroupId = groupId;
 
         /* If this is a special group ID, convert it to a real one */
-        ret = m_groupManager->verifyAndUpdateGroupId(&groupId);
+        ret = m_groupManager->verifyAndUpdateGroupId(&realGroupId);
         if (ret != DCGM_ST_OK)
         {
-            DCGM_LOG_ERROR << "Got ret " << ret << " from verifyAndUpdateGroupId. groupId " << msg.ev.groupId;
-            msg.ev.cmdRet = ret;
-            return DCGM_ST_OK;
+            DCGM_LOG_ERROR << "Got ret " << ret << " from verifyAndUpdateGroupId. groupId " << groupId;
+            return ret;
         }
 
-        ret = m_groupManager->GetGroupEntities(0, groupId, entities);
+        ret = m_groupManager->GetGroupEntities(0, realGroupId, entities);
         if (ret != DCGM_ST_OK)
         {
-            DCGM_LOG_ERROR << "Got ret " << ret << " from GetGroupEntities. groupId " << msg.ev.groupId;
-            msg.ev.cmdRet = ret;
-            return DCGM_ST_OK;
+            DCGM_LOG_ERROR << "Got ret " << ret << " from GetGroupEntities. groupId " << groupId;
+            return ret;
         }
     }
-    else if (msg.ev.entitiesCount > DCGM_GROUP_MAX_ENTITIES)
+    else if (entitiesCount > DCGM_GROUP_MAX_ENTITIES)
     {
-        DCGM_LOG_ERROR << "Invalid entities count: " << msg.ev.entitiesCount << " > MAX:" << DCGM_GROUP_MAX_ENTITIES;
-        msg.ev.cmdRet = DCGM_ST_BADPARAM;
-        return DCGM_ST_OK;
+        DCGM_LOG_ERROR << "Invalid entities count: " << entitiesCount << " > MAX:" << DCGM_GROUP_MAX_ENTITIES;
+        return DCGM_ST_BADPARAM;
     }
     else
     {
         /* Use the list from the message */
-        entities.insert(entities.end(), &msg.ev.entities[0], &msg.ev.entities[msg.ev.entitiesCount]);
+        entities.insert(entities.end(), &entityList[0], &entityList[entitiesCount]);
     }
 
     /* Convert the fieldGroupId to a list of field IDs */
-    if (msg.ev.fieldIdCount == 0)
+    if (fieldIdCount == 0)
     {
         DcgmFieldGroupManager *mpFieldGroupManager = DcgmHostEngineHandler::Instance()->GetFieldGroupManager();
 
-        ret = mpFieldGroupManager->GetFieldGroupFields(msg.ev.fieldGroupId, fieldIds);
+        ret = mpFieldGroupManager->GetFieldGroupFields(fieldGroupId, fieldIds);
         if (ret != DCGM_ST_OK)
         {
-            DCGM_LOG_ERROR << "Got ret " << ret << " from GetFieldGroupFields. fieldGroupId " << msg.ev.fieldGroupId;
-            msg.ev.cmdRet = ret;
-            return DCGM_ST_OK;
+            DCGM_LOG_ERROR << "Got ret " << ret << " from GetFieldGroupFields. fieldGroupId " << fieldGroupId;
+            return ret;
         }
     }
+    else if (fieldIdCount > DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP)
+    {
+        DCGM_LOG_ERROR << "Invalid field ID count: " << fieldIdCount << " > MAX:" << DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP;
+        return DCGM_ST_BADPARAM;
+    }
     else
     {
         /* Use the list from the message */
-        fieldIds.insert(fieldIds.end(), &msg.ev.fieldIdList[0], &msg.ev.fieldIdList[msg.ev.fieldIdCount]);
+        fieldIds.insert(fieldIds.end(), &fieldIdList[0], &fieldIdList[fieldIdCount]);
+    }
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::GetLatestValues(unsigned int groupId,
+                                             dcgmGroupEntityPair_t const *entityList,
+                                             unsigned int entitiesCount,
+                                             unsigned int fieldGroupId,
+                                             unsigned short const *fieldIdList,
+                                             unsigned int fieldIdCount,
+                                             unsigned int flags,
+                                             DcgmFvBuffer &fvBuffer,
+                                             unsigned long long sinceSequence,
+                                             unsigned long long *updateSequence)
+{
+    std::vector<dcgmGroupEntityPair_t> entities;
+    std::vector<unsigned short> fieldIds;
+
+    dcgmReturn_t ret = ResolveEntitiesAndFields(
+        groupId, entityList, entitiesCount, fieldGroupId, fieldIdList, fieldIdCount, entities, fieldIds);
+    if (ret != DCGM_ST_OK)
+    {
+        return ret;
     }
 
-    /* Create the fvBuffer after we know how many field IDs we'll be retrieving */
-    size_t initialCapacity = FVBUFFER_GUESS_INITIAL_CAPACITY(entities.size(), fieldIds.size());
-    DcgmFvBuffer fvBuffer(initialCapacity);
+    /* Size the fvBuffer after we know how many field IDs we'll be retrieving */
+    fvBuffer.Reserve(FVBUFFER_GUESS_INITIAL_CAPACITY(entities.size(), fieldIds.size()));
 
     /* Make a batch request to the cache manager to fill a fvBuffer with all of the values */
-    if ((msg.ev.flags & DCGM_FV_FLAG_LIVE_DATA) != 0)
+    if ((flags & DCGM_FV_FLAG_LIVE_DATA) != 0)
     {
         ret = m_cacheManager->GetMultipleLatestLiveSamples(entities, fieldIds, &fvBuffer);
     }
     else
     {
-        ret = m_cacheManager->GetMultipleLatestSamples(entities, fieldIds, &fvBuffer);
+        ret = m_cacheManager->GetMultipleLatestSamples(entities, fieldIds, &fvBuffer, sinceSequence, updateSequence);
     }
+
+    /* The values are about to be sent to the client */
+    if (ret == DCGM_ST_OK)
+    {
+        m_cacheManager->RecordSampleLag(DCGM_INTROSPECT_LAG_IPC_SEND, fvBuffer);
+    }
+
+    return ret;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessEntitiesGetLatestValues(dcgm_core_msg_entities_get_latest_values_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_entities_get_latest_values_version);
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    /* initialize length of response to handle failure cases */
+    msg.header.length = sizeof(dcgm_core_msg_entities_get_latest_values_t) - SAMPLES_BUFFER_SIZE;
+
+    DcgmFvBuffer fvBuffer(0);
+    ret = GetLatestValues(msg.ev.groupId,
+                          msg.ev.entities,
+                          msg.ev.entitiesCount,
+                          msg.ev.fieldGroupId,
+                          msg.ev.fieldIdList,
+                          msg.ev.fieldIdCount,
+                          msg.ev.flags,
+                          fvBuffer);
     if (ret != DCGM_ST_OK)
     {
         msg.ev.cmdRet = ret;
@@ -697,90 +859,202 @@ dcgmReturn_t DcgmModuleCore::ProcessEntitiesGetLatestValues(dcgm_core_msg_entiti
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmModuleCore::ProcessGetMultipleValuesForField(dcgm_core_msg_get_multiple_values_for_field_t &msg)
+dcgmReturn_t DcgmModuleCore::ProcessGetMultipleLatestValues(dcgm_core_msg_get_multiple_latest_values_t &msg)
 {
-    dcgmReturn_t ret;
-    int i;
-    int fieldId                  = 0;
-    dcgm_field_meta_p fieldMeta  = nullptr;
-    int MsampleBuffer            = 0; /* Allocated count of sampleBuffer[] */
-    int NsampleBuffer            = 0; /* Number of values in sampleBuffer[] that are valid */
-    dcgmcm_sample_p sampleBuffer = nullptr;
-    timelib64_t startTs          = 0;
-    timelib64_t endTs            = 0;
-    const char *fvBufferBytes    = nullptr;
-    size_t elementCount          = 0;
-    dcgmOrder_t order;
-    DcgmFvBuffer fvBuffer(0);
-
-    ret = CheckVersion(&msg.header, dcgm_core_msg_get_multiple_values_for_field_version);
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_multiple_latest_values_version);
     if (DCGM_ST_OK != ret)
     {
         DCGM_LOG_ERROR << "Version mismatch";
         return ret;
     }
 
-    /* initialize length of response to handle failure cases */
-    msg.header.length = sizeof(dcgm_core_msg_get_multiple_values_for_field_t) - SAMPLES_BUFFER_SIZE;
+    /* The host engine sized the message for bufferCapacity bytes of buffer, up to the max */
+    size_t const bufferCapacity = std::min<size_t>(msg.bufferCapacity, DCGM_FV_REPLY_MAX_BUFFER_SIZE);
+    msg.header.length           = sizeof(msg);
+    msg.bufferSize              = 0;
+    msg.updateSequence          = 0;
 
-    fieldId = msg.fv.fieldId;
+    DcgmFvBuffer fvBuffer(0);
+    ret = GetLatestValues(msg.request.groupId,
+                          msg.request.entities,
+                          msg.request.entitiesCount,
+                          msg.request.fieldGroupId,
+                          msg.request.fieldIds,
+                          msg.request.fieldIdCount,
+                          msg.request.flags,
+                          fvBuffer,
+                          msg.sinceSequence,
+                          &msg.updateSequence);
+    if (ret != DCGM_ST_OK)
+    {
+        msg.cmdRet = ret;
+        return DCGM_ST_OK;
+    }
 
-    /* Get Meta data corresponding to the fieldID */
-    fieldMeta = DcgmFieldGetById(fieldId);
-    if (fieldMeta == nullptr)
+    size_t bufferSize   = 0;
+    size_t elementCount = 0;
+    fvBuffer.GetSize(&bufferSize, &elementCount);
+
+    /* Let the client retry with a big enough buffer rather than return part of the values */
+    msg.bufferSize = bufferSize;
+    if (bufferSize > bufferCapacity)
     {
-        msg.fv.cmdRet = DCGM_ST_UNKNOWN_FIELD;
+        DCGM_LOG_DEBUG << "Latest values need " << bufferSize << " bytes. The client has room for " << bufferCapacity;
+        msg.cmdRet = DCGM_ST_INSUFFICIENT_SIZE;
         return DCGM_ST_OK;
     }
 
-    dcgm_field_entity_group_t entityGroupId = (dcgm_field_entity_group_t)msg.fv.entityGroupId;
-    dcgm_field_eid_t entityId               = msg.fv.entityId;
+    if (bufferSize > 0)
+        memcpy((char *)&msg + sizeof(msg), fvBuffer.GetBuffer(), bufferSize);
 
-    if (fieldMeta->scope == DCGM_FS_GLOBAL && entityGroupId != DCGM_FE_NONE)
+    msg.header.length = sizeof(msg) + bufferSize;
+    msg.cmdRet        = DCGM_ST_OK;
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessGetLatestValuesMatrix(dcgm_core_msg_get_latest_values_matrix_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_latest_values_matrix_version);
+    if (DCGM_ST_OK != ret)
     {
-        DCGM_LOG_WARNING << "Fixing entityGroupId to be NONE";
-        entityGroupId = DCGM_FE_NONE;
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
     }
 
-    if (msg.fv.startTs != 0)
+    /* The host engine sized the message for DCGM_MATRIX_REPLY_MAX_BUFFER_SIZE bytes after it */
+    msg.header.length = sizeof(msg);
+    msg.numEntities   = 0;
+    msg.numFields     = 0;
+    msg.stringsSize   = 0;
+
+    std::vector<dcgmGroupEntityPair_t> entities;
+    std::vector<unsigned short> fieldIds;
+    ret = ResolveEntitiesAndFields(msg.groupId, nullptr, 0, msg.fieldGroupId, nullptr, 0, entities, fieldIds);
+    if (ret == DCGM_ST_OK
+        && (entities.size() > DCGM_GROUP_MAX_ENTITIES || fieldIds.size() > DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP))
     {
-        startTs = (timelib64_t)msg.fv.startTs;
+        DCGM_LOG_ERROR << "Group " << msg.groupId << " of " << entities.size() << " entities and field group "
+                       << msg.fieldGroupId << " of " << fieldIds.size() << " fields don't fit in a matrix";
+        ret = DCGM_ST_BADPARAM;
     }
-    if (msg.fv.endTs != 0)
+    if (ret != DCGM_ST_OK)
     {
-        endTs = (timelib64_t)msg.fv.endTs;
+        msg.cmdRet = ret;
+        return DCGM_ST_OK;
     }
-    order = (dcgmOrder_t)msg.fv.order;
 
-    MsampleBuffer = msg.fv.count;
-    if (MsampleBuffer < 1)
+    /* Not value-initialized. Only the cells in use are written and sent */
+    std::unique_ptr<dcgmLatestValuesMatrix_v1> matrix(new dcgmLatestValuesMatrix_v1);
+    ret = m_cacheManager->GetLatestValuesMatrix(entities, fieldIds, matrix.get());
+    if (ret != DCGM_ST_OK)
     {
-        msg.fv.cmdRet = DCGM_ST_BADPARAM;
+        msg.cmdRet = ret;
         return DCGM_ST_OK;
     }
 
-    sampleBuffer = (dcgmcm_sample_p)malloc(MsampleBuffer * sizeof(sampleBuffer[0]));
+    msg.numEntities = matrix->numEntities;
+    msg.numFields   = matrix->numFields;
+    msg.stringsSize = matrix->stringsSize;
+    memcpy(msg.entities, matrix->entities, msg.numEntities * sizeof(msg.entities[0]));
+    memcpy(msg.fieldIds, matrix->fieldIds, msg.numFields * sizeof(msg.fieldIds[0]));
+    memcpy(msg.fieldTypes, matrix->fieldTypes, msg.numFields * sizeof(msg.fieldTypes[0]));
+
+    size_t const numCells = (size_t)msg.numEntities * msg.numFields;
+    char *buffer          = (char *)&msg + sizeof(msg);
+    memcpy(buffer, matrix->values, numCells * sizeof(matrix->values[0]));
+    buffer += numCells * sizeof(matrix->values[0]);
+    memcpy(buffer, matrix->timestamps, numCells * sizeof(matrix->timestamps[0]));
+    buffer += numCells * sizeof(matrix->timestamps[0]);
+    memcpy(buffer, matrix->status, numCells * sizeof(matrix->status[0]));
+    buffer += numCells * sizeof(matrix->status[0]);
+    memcpy(buffer, matrix->strings, msg.stringsSize);
+
+    msg.header.length = sizeof(msg) + DCGM_MATRIX_REPLY_BUFFER_SIZE(numCells, msg.stringsSize);
+    msg.cmdRet        = DCGM_ST_OK;
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::GetFieldSamples(dcgm_field_entity_group_t entityGroupId,
+                                             dcgm_field_eid_t entityId,
+                                             unsigned short fieldId,
+                                             long long startTs,
+                                             long long endTs,
+                                             dcgmOrder_t order,
+                                             int maxCount,
+                                             DcgmFvBuffer &fvBuffer,
+                                             timeseries_position_t *position,
+                                             long long *samplesSkipped,
+                                             DcgmWatcher const *watcher)
+{
+    dcgmReturn_t ret;
+    int i;
+    int NsampleBuffer = 0; /* Number of values in sampleBuffer[] that are valid */
+    timelib64_t decimationUsec = 0;
+    timelib64_t lastTimestamp  = 0; /* Of the last value added to fvBuffer */
+
+    /* Get Meta data corresponding to the fieldID */
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+    if (fieldMeta == nullptr)
+    {
+        return DCGM_ST_UNKNOWN_FIELD;
+    }
+
+    if (fieldMeta->scope == DCGM_FS_GLOBAL && entityGroupId != DCGM_FE_NONE)
+    {
+        DCGM_LOG_WARNING << "Fixing entityGroupId to be NONE";
+        entityGroupId = DCGM_FE_NONE;
+    }
+
+    if (maxCount < 1)
+    {
+        return DCGM_ST_BADPARAM;
+    }
+
+    dcgmcm_sample_p sampleBuffer = (dcgmcm_sample_p)malloc(maxCount * sizeof(sampleBuffer[0]));
     if (sampleBuffer == nullptr)
     {
-        DCGM_LOG_ERROR << "failed malloc for " << MsampleBuffer * sizeof(sampleBuffer[0]) << " bytes";
-        msg.fv.cmdRet = DCGM_ST_MEMORY;
-        return DCGM_ST_OK;
+        DCGM_LOG_ERROR << "failed malloc for " << maxCount * sizeof(sampleBuffer[0]) << " bytes";
+        return DCGM_ST_MEMORY;
     }
     /* GOTO CLEANUP BELOW THIS POINT */
 
-    NsampleBuffer = MsampleBuffer;
-    ret           = m_cacheManager->GetSamples(
-        entityGroupId, entityId, fieldId, sampleBuffer, &NsampleBuffer, startTs, endTs, order);
+    NsampleBuffer = maxCount;
+    if (position != nullptr)
+    {
+        ret = m_cacheManager->GetSamplesAfter(
+            entityGroupId, entityId, fieldId, sampleBuffer, &NsampleBuffer, position, samplesSkipped);
+    }
+    else
+    {
+        ret = m_cacheManager->GetSamples(entityGroupId,
+                                         entityId,
+                                         fieldId,
+                                         sampleBuffer,
+                                         &NsampleBuffer,
+                                         (timelib64_t)startTs,
+                                         (timelib64_t)endTs,
+                                         order);
+    }
     if (ret != DCGM_ST_OK)
     {
-        msg.fv.cmdRet = ret;
         goto CLEANUP;
     }
     /* NsampleBuffer now contains the number of valid records returned from our query */
 
+    if (watcher != nullptr)
+    {
+        decimationUsec = m_cacheManager->GetWatcherDecimationUsec(entityGroupId, entityId, fieldId, *watcher);
+    }
+
     /* Add each of the samples to the return type */
     for (i = 0; i < NsampleBuffer; i++)
     {
+        if (!DcgmCacheManager::IsWatcherDue(decimationUsec, sampleBuffer[i].timestamp, lastTimestamp))
+        {
+            continue;
+        }
+        lastTimestamp = sampleBuffer[i].timestamp;
+
         switch (fieldMeta->fieldType)
         {
             case DCGM_FT_DOUBLE:
@@ -811,20 +1085,70 @@ dcgmReturn_t DcgmModuleCore::ProcessGetMultipleValuesForField(dcgm_core_msg_get_
 
             default:
                 DCGM_LOG_ERROR << "Update code to support additional Field Types";
-                fvBuffer.AddInt64Value(entityGroupId, entityId, fieldId, 0, 0, DCGM_ST_GENERIC_ERROR);
+                ret = DCGM_ST_GENERIC_ERROR;
                 goto CLEANUP;
         }
     }
 
+CLEANUP:
+    if (NsampleBuffer != 0)
+    {
+        m_cacheManager->FreeSamples(sampleBuffer, NsampleBuffer, fieldId);
+    }
+    free(sampleBuffer);
+
+    return ret;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessGetMultipleValuesForField(dcgm_core_msg_get_multiple_values_for_field_t &msg)
+{
+    dcgmReturn_t ret;
+    const char *fvBufferBytes = nullptr;
+    size_t elementCount       = 0;
+    DcgmFvBuffer fvBuffer(0);
+
+    ret = CheckVersion(&msg.header, dcgm_core_msg_get_multiple_values_for_field_version);
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    /* initialize length of response to handle failure cases */
+    msg.header.length = sizeof(dcgm_core_msg_get_multiple_values_for_field_t) - SAMPLES_BUFFER_SIZE;
+
+    dcgm_connection_id_t connectionId = msg.header.connectionId;
+    if (DcgmHostEngineHandler::Instance()->GetPersistAfterDisconnect(msg.header.connectionId))
+    {
+        connectionId = DCGM_CONNECTION_ID_NONE;
+    }
+    DcgmWatcher dcgmWatcher(DcgmWatcherTypeClient, connectionId);
+
+    ret = GetFieldSamples((dcgm_field_entity_group_t)msg.fv.entityGroupId,
+                          msg.fv.entityId,
+                          msg.fv.fieldId,
+                          msg.fv.startTs,
+                          msg.fv.endTs,
+                          (dcgmOrder_t)msg.fv.order,
+                          msg.fv.count,
+                          fvBuffer,
+                          nullptr,
+                          nullptr,
+                          &dcgmWatcher);
+    if (ret != DCGM_ST_OK)
+    {
+        msg.fv.cmdRet = ret;
+        return DCGM_ST_OK;
+    }
+
     fvBufferBytes = fvBuffer.GetBuffer();
     fvBuffer.GetSize((size_t *)&msg.fv.bufferSize, &elementCount);
 
     if ((fvBufferBytes == nullptr) || (msg.fv.bufferSize == 0))
     {
         DCGM_LOG_ERROR << "Unexpected fvBuffer " << (void *)fvBufferBytes << ", fvBufferBytes " << msg.fv.bufferSize;
-        ret           = DCGM_ST_GENERIC_ERROR;
-        msg.fv.cmdRet = ret;
-        goto CLEANUP;
+        msg.fv.cmdRet = DCGM_ST_GENERIC_ERROR;
+        return DCGM_ST_OK;
     }
 
     if (msg.fv.bufferSize > sizeof(msg.fv.buffer))
@@ -834,24 +1158,271 @@ dcgmReturn_t DcgmModuleCore::ProcessGetMultipleValuesForField(dcgm_core_msg_get_
         msg.fv.bufferSize = sizeof(msg.fv.buffer);
     }
 
-    memcpy(&msg.fv.buffer, fvBufferBytes, (size_t)msg.fv.bufferSize);
+    memcpy(&msg.fv.buffer, fvBufferBytes, (size_t)msg.fv.bufferSize);
+
+    /* calculate actual message size to avoid transferring extra data */
+    msg.header.length = sizeof(dcgm_core_msg_get_multiple_values_for_field_t) - SAMPLES_BUFFER_SIZE + msg.fv.bufferSize;
+    msg.fv.count      = elementCount;
+    msg.fv.cmdRet     = DCGM_ST_OK;
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessGetFieldMultipleValues(dcgm_core_msg_get_field_multiple_values_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_field_multiple_values_version);
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    /* The host engine sized the message for bufferCapacity bytes of buffer, up to the max */
+    size_t const bufferCapacity = std::min<size_t>(msg.bufferCapacity, DCGM_FV_REPLY_MAX_BUFFER_SIZE);
+    msg.header.length           = sizeof(msg);
+    msg.bufferSize              = 0;
+    msg.valuesSkipped           = 0;
+
+    timeseries_position_t position;
+    position.usecSince1970 = msg.cursor.opaque[0];
+    position.serial        = msg.cursor.opaque[1];
+
+    dcgm_connection_id_t connectionId = msg.header.connectionId;
+    if (DcgmHostEngineHandler::Instance()->GetPersistAfterDisconnect(msg.header.connectionId))
+    {
+        connectionId = DCGM_CONNECTION_ID_NONE;
+    }
+    DcgmWatcher dcgmWatcher(DcgmWatcherTypeClient, connectionId);
+
+    DcgmFvBuffer fvBuffer(0);
+    ret = GetFieldSamples((dcgm_field_entity_group_t)msg.entityGroupId,
+                          msg.entityId,
+                          msg.fieldId,
+                          msg.startTs,
+                          msg.endTs,
+                          (dcgmOrder_t)msg.order,
+                          msg.count,
+                          fvBuffer,
+                          msg.useCursor ? &position : nullptr,
+                          &msg.valuesSkipped,
+                          &dcgmWatcher);
+    if (ret != DCGM_ST_OK)
+    {
+        msg.count  = 0;
+        msg.cmdRet = ret;
+        return DCGM_ST_OK;
+    }
+
+    /* Return the whole values that fit. The rest are left for the client to ask for by timestamp or cursor */
+    dcgmBufferedFvCursor_t cursor = 0;
+    size_t bufferSize             = 0;
+    unsigned int count            = 0;
+    size_t elementCount           = 0;
+    long long lastTimestamp       = 0;
+    fvBuffer.GetSize(&bufferSize, &elementCount);
+    bufferSize = 0;
+    for (dcgmBufferedFv_t const *fv = fvBuffer.GetNextFv(&cursor); fv != nullptr; fv = fvBuffer.GetNextFv(&cursor))
+    {
+        if (bufferSize + fv->length > bufferCapacity)
+        {
+            DCGM_LOG_DEBUG << "Only " << count << " values of fieldId " << msg.fieldId << " fit in " << bufferCapacity
+                           << " bytes";
+            break;
+        }
+        bufferSize += fv->length;
+        lastTimestamp = fv->timestamp;
+        count++;
+    }
+
+    if (msg.useCursor && count > 0)
+    {
+        /* Values are consecutive, so the ones left out are the last ones the cursor moved past */
+        position.usecSince1970 = lastTimestamp;
+        if (position.serial >= 0)
+            position.serial -= elementCount - count;
+        msg.cursor.opaque[0] = position.usecSince1970;
+        msg.cursor.opaque[1] = position.serial;
+    }
+
+    if (bufferSize > 0)
+        memcpy((char *)&msg + sizeof(msg), fvBuffer.GetBuffer(), bufferSize);
+
+    msg.header.length = sizeof(msg) + bufferSize;
+    msg.bufferSize    = bufferSize;
+    msg.count         = count;
+    msg.cmdRet        = DCGM_ST_OK;
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessGetTransportStats(dcgm_core_msg_get_transport_stats_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_transport_stats_version);
+
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    msg.counters  = {};
+    msg.sendQueue = {};
+
+    /* Embedded clients don't have a connection */
+    if (msg.header.connectionId == DCGM_CONNECTION_ID_NONE)
+    {
+        msg.cmdRet = DCGM_ST_NOT_SUPPORTED;
+        return DCGM_ST_OK;
+    }
+
+    DcgmIpcConnectionStats_t stats {};
+    ret = DcgmHostEngineHandler::Instance()->GetConnectionStats(msg.header.connectionId, stats);
+    if (ret == DCGM_ST_OK)
+    {
+        msg.counters  = stats.counters;
+        msg.sendQueue = stats.sendQueue;
+    }
+    msg.cmdRet = ret;
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessAttributeCacheSubscribe(dcgm_core_msg_attribute_cache_subscribe_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_attribute_cache_subscribe_version);
+
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    msg.generation = 0;
+
+    /* Embedded clients have nothing to cache */
+    if (msg.header.connectionId == DCGM_CONNECTION_ID_NONE)
+    {
+        msg.cmdRet = DCGM_ST_NOT_SUPPORTED;
+    }
+    else
+    {
+        msg.cmdRet = DcgmHostEngineHandler::Instance()->SubscribeAttributeGeneration(
+            msg.header.connectionId, msg.header.requestId, &msg.generation);
+    }
+
+    if (msg.cmdRet != DCGM_ST_OK && msg.header.requestId != DCGM_REQUEST_ID_NONE)
+    {
+        /* Let the client free the request it made for the subscription */
+        DcgmHostEngineHandler::Instance()->NotifyRequestOfCompletion(msg.header.connectionId, msg.header.requestId);
+    }
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessGetBucketedValuesForField(dcgm_core_msg_get_bucketed_values_for_field_t &msg)
+{
+    /* Numeric fvs are the fixed part of dcgmBufferedFv_t plus an 8-byte value */
+    constexpr size_t bucketFvSize = offsetof(dcgmBufferedFv_t, value) + sizeof(int64_t);
+    static_assert(DCGM_MAX_BUCKETS_PER_REQUEST * bucketFvSize <= SAMPLES_BUFFER_SIZE);
+
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_bucketed_values_for_field_version);
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    /* initialize length of response to handle failure cases */
+    msg.header.length = sizeof(dcgm_core_msg_get_bucketed_values_for_field_t) - SAMPLES_BUFFER_SIZE;
+    msg.fv.bufferSize = 0;
+
+    unsigned short fieldId      = msg.fv.fieldId;
+    dcgm_field_meta_p fieldMeta = DcgmFieldGetById(fieldId);
+    if (fieldMeta == nullptr)
+    {
+        msg.fv.cmdRet = DCGM_ST_UNKNOWN_FIELD;
+        return DCGM_ST_OK;
+    }
+
+    if (msg.fv.count < 1 || msg.fv.bucketWidth <= 0 || msg.fv.aggregation < DCGM_BUCKET_AGG_MIN
+        || msg.fv.aggregation > DCGM_BUCKET_AGG_COUNT)
+    {
+        msg.fv.cmdRet = DCGM_ST_BADPARAM;
+        return DCGM_ST_OK;
+    }
+
+    dcgm_field_entity_group_t entityGroupId = (dcgm_field_entity_group_t)msg.fv.entityGroupId;
+    dcgm_field_eid_t entityId               = msg.fv.entityId;
+    std::vector<timeseries_bucket_t> buckets;
+
+    ret = m_cacheManager->GetBucketedSamples(entityGroupId,
+                                             entityId,
+                                             fieldId,
+                                             msg.fv.startTs,
+                                             msg.fv.endTs,
+                                             msg.fv.bucketWidth,
+                                             std::min(msg.fv.count, (unsigned int)DCGM_MAX_BUCKETS_PER_REQUEST),
+                                             buckets);
+    if (ret != DCGM_ST_OK)
+    {
+        msg.fv.cmdRet = ret;
+        return DCGM_ST_OK;
+    }
+
+    if (fieldMeta->scope == DCGM_FS_GLOBAL)
+        entityGroupId = DCGM_FE_NONE;
+
+    bool isDouble = fieldMeta->fieldType == DCGM_FT_DOUBLE;
+    DcgmFvBuffer fvBuffer(buckets.size() * bucketFvSize);
+
+    for (timeseries_bucket_t const &bucket : buckets)
+    {
+        timeseries_value_t value {};
+
+        switch (msg.fv.aggregation)
+        {
+            case DCGM_BUCKET_AGG_MIN:
+                value = bucket.min;
+                break;
+            case DCGM_BUCKET_AGG_MAX:
+                value = bucket.max;
+                break;
+            case DCGM_BUCKET_AGG_LAST:
+                value = bucket.last;
+                break;
+            case DCGM_BUCKET_AGG_AVG:
+                fvBuffer.AddDoubleValue(
+                    entityGroupId, entityId, fieldId, bucket.sum / bucket.count, bucket.startUsec, DCGM_ST_OK);
+                continue;
+            case DCGM_BUCKET_AGG_COUNT:
+                fvBuffer.AddInt64Value(entityGroupId, entityId, fieldId, bucket.count, bucket.startUsec, DCGM_ST_OK);
+                continue;
+        }
+
+        if (isDouble)
+            fvBuffer.AddDoubleValue(entityGroupId, entityId, fieldId, value.dbl, bucket.startUsec, DCGM_ST_OK);
+        else
+            fvBuffer.AddInt64Value(entityGroupId, entityId, fieldId, value.i64, bucket.startUsec, DCGM_ST_OK);
+    }
+
+    size_t bufferSize   = 0;
+    size_t elementCount = 0;
+    fvBuffer.GetSize(&bufferSize, &elementCount);
+    if (bufferSize > sizeof(msg.fv.buffer))
+    {
+        /* DCGM_MAX_BUCKETS_PER_REQUEST should have prevented this */
+        DCGM_LOG_ERROR << "Bucketed values " << bufferSize << " > " << sizeof(msg.fv.buffer);
+        msg.fv.cmdRet = DCGM_ST_GENERIC_ERROR;
+        return DCGM_ST_OK;
+    }
+
+    if (bufferSize > 0)
+        memcpy(msg.fv.buffer, fvBuffer.GetBuffer(), bufferSize);
 
     /* calculate actual message size to avoid transferring extra data */
-    msg.header.length = sizeof(dcgm_core_msg_get_multiple_values_for_field_t) - SAMPLES_BUFFER_SIZE + msg.fv.bufferSize;
-    msg.fv.count      = i;
+    msg.fv.bufferSize = bufferSize;
+    msg.fv.count      = elementCount;
+    msg.header.length = sizeof(dcgm_core_msg_get_bucketed_values_for_field_t) - SAMPLES_BUFFER_SIZE + bufferSize;
     msg.fv.cmdRet     = DCGM_ST_OK;
 
-CLEANUP:
-    if (sampleBuffer != nullptr)
-    {
-        if (NsampleBuffer != 0)
-        {
-            m_cacheManager->FreeSamples(sampleBuffer, NsampleBuffer, (unsigned short)fieldId);
-        }
-        free(sampleBuffer);
-        sampleBuffer = nullptr;
-    }
-
     return DCGM_ST_OK;
 }
 
@@ -994,6 +1565,55 @@ dcgmReturn_t DcgmModuleCore::ProcessInjectFieldValue(dcgm_core_msg_inject_field_
     return DCGM_ST_OK;
 }
 
+dcgmReturn_t DcgmModuleCore::ProcessInjectFieldValues(dcgm_core_msg_inject_field_values_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_inject_field_values_version);
+    if (DCGM_ST_OK != ret)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    if (msg.header.length < sizeof(msg))
+    {
+        DCGM_LOG_ERROR << "DCGM_CORE_SR_INJECT_FIELD_VALUES request of length " << msg.header.length;
+        return DCGM_ST_BADPARAM;
+    }
+
+    size_t const bufferSize = msg.header.length - sizeof(msg);
+
+    /* Only the struct goes back to the client */
+    msg.header.length = sizeof(msg);
+    msg.numValues     = 0;
+
+    if (bufferSize == 0 || bufferSize != msg.bufferSize || bufferSize > DCGM_FV_INJECT_MAX_BUFFER_SIZE)
+    {
+        DCGM_LOG_ERROR << "Malformed DCGM_CORE_SR_INJECT_FIELD_VALUES request. bufferSize " << msg.bufferSize
+                       << ", " << bufferSize << " bytes sent";
+        msg.cmdRet = DCGM_ST_BADPARAM;
+        return DCGM_ST_OK;
+    }
+
+    DcgmFvBuffer fvBuffer(0);
+    ret = fvBuffer.SetFromBuffer((char const *)&msg + sizeof(msg), bufferSize);
+    if (ret != DCGM_ST_OK)
+    {
+        msg.cmdRet = DCGM_ST_BADPARAM;
+        return DCGM_ST_OK;
+    }
+
+    msg.cmdRet = m_cacheManager->InjectSamples(&fvBuffer);
+    if (msg.cmdRet == DCGM_ST_OK)
+    {
+        size_t usedSize     = 0;
+        size_t elementCount = 0;
+        fvBuffer.GetSize(&usedSize, &elementCount);
+        msg.numValues = elementCount;
+    }
+
+    return DCGM_ST_OK;
+}
+
 dcgmReturn_t DcgmModuleCore::ProcessGetCacheManagerFieldInfo(dcgm_core_msg_get_cache_manager_field_info_t &msg)
 {
     dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_cache_manager_field_info_version);
@@ -1008,7 +1628,7 @@ dcgmReturn_t DcgmModuleCore::ProcessGetCacheManagerFieldInfo(dcgm_core_msg_get_c
     return DCGM_ST_OK;
 }
 
-dcgmReturn_t DcgmModuleCore::ProcessWatchFields(dcgm_core_msg_watch_fields_t &msg)
+dcgmReturn_t DcgmModuleCore::ProcessWatchFields(dcgm_core_msg_watch_fields_t &msg, bool snapshot)
 {
     dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_watch_fields_version);
     if (ret != DCGM_ST_OK)
@@ -1040,7 +1660,8 @@ dcgmReturn_t DcgmModuleCore::ProcessWatchFields(dcgm_core_msg_watch_fields_t &ms
                                                                               msg.watchInfo.updateFreq,
                                                                               msg.watchInfo.maxKeepAge,
                                                                               msg.watchInfo.maxKeepSamples,
-                                                                              dcgmWatcher);
+                                                                              dcgmWatcher,
+                                                                              snapshot);
 
     return DCGM_ST_OK;
 }
@@ -1078,6 +1699,251 @@ dcgmReturn_t DcgmModuleCore::ProcessUnwatchFields(dcgm_core_msg_watch_fields_t &
     return DCGM_ST_OK;
 }
 
+dcgmReturn_t DcgmModuleCore::ProcessFvStreamSubscribe(dcgm_core_msg_fv_stream_subscribe_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_fv_stream_subscribe_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    unsigned int groupId = (unsigned int)(uintptr_t)msg.params.groupId;
+
+    if (msg.params.version != dcgmFieldValueStreamParams_version1)
+    {
+        DCGM_LOG_ERROR << "Params version mismatch " << msg.params.version;
+        msg.cmdRet = DCGM_ST_VER_MISMATCH;
+    }
+    else if ((ret = m_groupManager->verifyAndUpdateGroupId(&groupId)) != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Error: Bad group id parameter";
+        msg.cmdRet = ret;
+    }
+    else
+    {
+        /* Streams always end with their connection, even one that persists its watches */
+        msg.cmdRet = DcgmHostEngineHandler::Instance()->SubscribeFieldValueStream(msg.header.connectionId,
+                                                                                  msg.header.requestId,
+                                                                                  groupId,
+                                                                                  msg.params.fieldGroupId,
+                                                                                  msg.params.updateFreq,
+                                                                                  msg.params.maxKeepAge,
+                                                                                  msg.params.maxKeepSamples,
+                                                                                  msg.params.maxBatchesInFlight,
+                                                                                  msg.params.maxPendingValues);
+    }
+
+    if (msg.cmdRet != DCGM_ST_OK && msg.header.requestId != DCGM_REQUEST_ID_NONE)
+    {
+        /* Let the client free the request it made for the stream */
+        DcgmHostEngineHandler::Instance()->NotifyRequestOfCompletion(msg.header.connectionId, msg.header.requestId);
+    }
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessFvStreamUnsubscribe(dcgm_core_msg_fv_stream_unsubscribe_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_fv_stream_unsubscribe_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    msg.cmdRet = DcgmHostEngineHandler::Instance()->UnsubscribeFieldValueStream(msg.header.connectionId, msg.streamId);
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessProxyStreamSubscribe(dcgm_core_msg_proxy_stream_subscribe_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_proxy_stream_subscribe_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    if (msg.params.version != dcgmFieldValueStreamParams_version1)
+    {
+        DCGM_LOG_ERROR << "Params version mismatch " << msg.params.version;
+        msg.cmdRet = DCGM_ST_VER_MISMATCH;
+    }
+    else
+    {
+        msg.cmdRet = DcgmHostEngineHandler::Instance()->SubscribeProxyStream(
+            msg.header.connectionId, msg.header.requestId, msg.params);
+    }
+
+    if (msg.cmdRet != DCGM_ST_OK && msg.header.requestId != DCGM_REQUEST_ID_NONE)
+    {
+        /* Let the client free the request it made for the stream */
+        DcgmHostEngineHandler::Instance()->NotifyRequestOfCompletion(msg.header.connectionId, msg.header.requestId);
+    }
+
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessProxyStreamUnsubscribe(dcgm_core_msg_proxy_stream_unsubscribe_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_proxy_stream_unsubscribe_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    msg.cmdRet = DcgmHostEngineHandler::Instance()->UnsubscribeProxyStream(msg.header.connectionId, msg.streamId);
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessProxyGetHosts(dcgm_core_msg_proxy_get_hosts_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_proxy_get_hosts_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    msg.hosts.version = dcgmProxyHosts_version1;
+    msg.cmdRet        = DcgmHostEngineHandler::Instance()->GetProxyHosts(msg.hosts);
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessGetWorkerStats(dcgm_core_msg_get_worker_stats_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_worker_stats_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    msg.stats         = {};
+    msg.stats.version = dcgmHostengineWorkerStats_version1;
+    msg.cmdRet        = DcgmHostEngineHandler::Instance()->GetWorkerStats(msg.stats);
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessGetRequestStats(dcgm_core_msg_get_request_stats_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_request_stats_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    if (msg.stats.version != dcgmIntrospectRequestStats_version1)
+    {
+        DCGM_LOG_ERROR << "Request stats version mismatch " << msg.stats.version
+                       << " != " << dcgmIntrospectRequestStats_version1;
+        msg.cmdRet = DCGM_ST_VER_MISMATCH;
+        return DCGM_ST_OK;
+    }
+
+    msg.cmdRet = DcgmHostEngineHandler::Instance()->GetRequestStats(msg.stats);
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessGetMemoryAccounting(dcgm_core_msg_get_memory_accounting_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_get_memory_accounting_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    if (msg.accounting.version != dcgmIntrospectMemoryAccounting_version1)
+    {
+        DCGM_LOG_ERROR << "Memory accounting version mismatch " << msg.accounting.version
+                       << " != " << dcgmIntrospectMemoryAccounting_version1;
+        msg.cmdRet = DCGM_ST_VER_MISMATCH;
+        return DCGM_ST_OK;
+    }
+
+    msg.cmdRet = DcgmHostEngineHandler::Instance()->GetMemoryAccounting(msg.accounting);
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessSession(unsigned int subCommand, dcgm_core_msg_session_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_session_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    if (subCommand == DCGM_CORE_SR_SESSION_GET_TOKEN)
+    {
+        msg.token  = 0;
+        msg.cmdRet = DcgmHostEngineHandler::Instance()->GetSessionToken(msg.header.connectionId, msg.token);
+    }
+    else
+    {
+        msg.cmdRet = DcgmHostEngineHandler::Instance()->ResumeSession(msg.header.connectionId, msg.token);
+    }
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessEstimateWatchCost(dcgm_core_msg_estimate_watch_cost_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_estimate_watch_cost_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    if (msg.cost.version != dcgmIntrospectWatchCost_version1)
+    {
+        DCGM_LOG_ERROR << "Watch cost version mismatch " << msg.cost.version
+                       << " != " << dcgmIntrospectWatchCost_version1;
+        msg.cmdRet = DCGM_ST_VER_MISMATCH;
+        return DCGM_ST_OK;
+    }
+
+    msg.cmdRet = DcgmHostEngineHandler::Instance()->EstimateWatchCost(msg.header.connectionId, msg.cost);
+    return DCGM_ST_OK;
+}
+
+dcgmReturn_t DcgmModuleCore::ProcessSetDerivedField(dcgm_core_msg_set_derived_field_t &msg)
+{
+    if (m_cacheManager == nullptr)
+    {
+        DCGM_LOG_ERROR << "m_cacheManager not initialized.";
+        return DCGM_ST_UNINITIALIZED;
+    }
+
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_set_derived_field_version);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    dcgmDerivedField_v1 &derivedField = msg.derivedField;
+    if (derivedField.version != dcgmDerivedField_version1)
+    {
+        DCGM_LOG_ERROR << "Derived field version mismatch " << derivedField.version
+                       << " != " << dcgmDerivedField_version1;
+        msg.cmdRet = DCGM_ST_VER_MISMATCH;
+        return DCGM_ST_OK;
+    }
+
+    /* The expression may not be terminated */
+    std::string expression(derivedField.expression,
+                           strnlen(derivedField.expression, sizeof(derivedField.expression)));
+    std::string error;
+    msg.cmdRet = m_cacheManager->SetDerivedField(derivedField.fieldId, expression, error);
+    SafeCopyTo(derivedField.error, error.c_str());
+    return DCGM_ST_OK;
+}
+
 dcgmReturn_t DcgmModuleCore::ProcessGetGpuStatus(dcgm_core_msg_get_gpu_status_t &msg)
 {
     if (m_cacheManager == nullptr)
@@ -1330,6 +2196,12 @@ dcgmReturn_t DcgmModuleCore::ProcessFieldgroupOp(dcgm_core_msg_fieldgroup_op_t &
         ret = mpFieldGroupManager->PopulateFieldGroupInfo(&msg.info.fg);
     }
 
+    if (ret == DCGM_ST_OK && msg.header.subCommand != DCGM_CORE_SR_FIELDGROUP_GET_INFO)
+    {
+        /* Clients may have cached the field groups */
+        DcgmHostEngineHandler::Instance()->BumpAttributeGeneration();
+    }
+
     msg.info.cmdRet = ret;
     return DCGM_ST_OK;
 }
@@ -1407,6 +2279,7 @@ dcgmReturn_t DcgmModuleCore::ProcessCreateFakeEntities(dcgm_core_msg_create_fake
     }
 
     msg.info.cmdRet = DcgmHostEngineHandler::Instance()->HelperCreateFakeEntities(&msg.info.fe);
+    DcgmHostEngineHandler::Instance()->BumpAttributeGeneration(); /* Even on failure, some may have been created */
 
     return DCGM_ST_OK;
 }
@@ -1544,6 +2417,104 @@ dcgmReturn_t DcgmModuleCore::ProcessGetGpuInstanceHierarchy(dcgm_core_msg_get_gp
     return DCGM_ST_GENERIC_ERROR;
 }
 
+dcgmReturn_t DcgmModuleCore::ProcessTraceControl(dcgm_core_msg_trace_control_t &msg)
+{
+    dcgmReturn_t ret = CheckVersion(&msg.header, dcgm_core_msg_trace_control_version);
+
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Version mismatch";
+        return ret;
+    }
+
+    if (msg.info.tc.version != dcgmTraceControl_version1)
+    {
+        DCGM_LOG_ERROR << "Struct version1 mismatch";
+        msg.info.cmdRet = DCGM_ST_VER_MISMATCH;
+        return DCGM_ST_OK;
+    }
+
+    DcgmNs::Tracer &tracer  = DcgmNs::Tracer::Instance();
+    msg.info.cmdRet         = DCGM_ST_OK;
+    msg.info.tc.filename[0] = '\0';
+
+    switch (msg.info.tc.action)
+    {
+        case DCGM_TRACE_ACTION_START:
+            tracer.Start(msg.info.tc.numSpans);
+            break;
+
+        case DCGM_TRACE_ACTION_STOP:
+            tracer.Stop();
+            break;
+
+        case DCGM_TRACE_ACTION_DUMP:
+        {
+            /* The directory is the hostengine's to choose. Clients only learn where the file went */
+            char const *directory = getenv(DCGM_ENV_TRACE_DIR);
+            std::string filename;
+
+            msg.info.cmdRet = tracer.WriteChromeTrace(directory ? directory : "/tmp", filename);
+            if (msg.info.cmdRet == DCGM_ST_OK)
+            {
+                SafeCopyTo(msg.info.tc.filename, filename.c_str());
+                DCGM_LOG_INFO << "Wrote trace to " << filename;
+            }
+
+            /* The binary log goes next to the trace. Its path is only logged */
+            std::string binaryLogFilename;
+            DcgmNs::Logging::BinaryLog const &binaryLog = DcgmNs::Logging::BinaryLog::Instance();
+            if (binaryLog.Capacity() != 0
+                && binaryLog.WriteBinaryLog(directory ? directory : "/tmp", binaryLogFilename) == DCGM_ST_OK)
+            {
+                DCGM_LOG_INFO << "Wrote binary log to " << binaryLogFilename;
+            }
+            break;
+        }
+
+        case DCGM_TRACE_ACTION_MUTEX_PROFILE_START:
+            DcgmMutex::ResetProfile();
+            DcgmMutex::EnableProfiling(true);
+            break;
+
+        case DCGM_TRACE_ACTION_MUTEX_PROFILE_STOP:
+            DcgmMutex::EnableProfiling(false);
+            break;
+
+        case DCGM_TRACE_ACTION_MUTEX_PROFILE_DUMP:
+        {
+            char const *directory = getenv(DCGM_ENV_TRACE_DIR);
+            std::string filename;
+
+            msg.info.cmdRet = DcgmNs::WriteDumpFile(directory ? directory : "/tmp",
+                                                    "dcgm-mutex-XXXXXX.json",
+                                                    5,
+                                                    DcgmMutex::ProfileToJson(DcgmMutex::GetProfile()),
+                                                    filename);
+            if (msg.info.cmdRet == DCGM_ST_OK)
+            {
+                SafeCopyTo(msg.info.tc.filename, filename.c_str());
+                DCGM_LOG_INFO << "Wrote mutex profile to " << filename;
+            }
+            break;
+        }
+
+        default:
+            DCGM_LOG_ERROR << "Unknown trace action " << msg.info.tc.action;
+            msg.info.cmdRet = DCGM_ST_BADPARAM;
+            break;
+    }
+
+    msg.info.tc.numSpans  = tracer.Capacity();
+    msg.info.tc.isEnabled = tracer.IsEnabled() ? 1 : 0;
+    if (msg.info.tc.action >= DCGM_TRACE_ACTION_MUTEX_PROFILE_START)
+    {
+        msg.info.tc.isEnabled = DcgmMutex::IsProfilingEnabled() ? 1 : 0;
+    }
+
+    return DCGM_ST_OK;
+}
+
 dcgmReturn_t DcgmModuleCore::ProcessSetLoggingSeverity(dcgm_core_msg_set_severity_t &msg)
 {
     int retSt                                 = 0; // Used for logging return
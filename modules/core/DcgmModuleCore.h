@@ -47,16 +47,25 @@ public:
     dcgmReturn_t ProcessJobStartStats(dcgm_core_msg_job_cmd_t &msg);
     dcgmReturn_t ProcessJobStopStats(dcgm_core_msg_job_cmd_t &msg);
     dcgmReturn_t ProcessJobGetStats(dcgm_core_msg_job_get_stats_t &msg);
+    dcgmReturn_t ProcessJobGetStatsSince(dcgm_core_msg_job_get_stats_since_t &msg);
+    dcgmReturn_t ProcessJobGetPercentiles(dcgm_core_msg_job_get_percentiles_t &msg);
     dcgmReturn_t ProcessJobRemove(dcgm_core_msg_job_cmd_t &msg);
     dcgmReturn_t ProcessJobRemoveAll(dcgm_core_msg_job_cmd_t &msg);
     dcgmReturn_t ProcessEntitiesGetLatestValues(dcgm_core_msg_entities_get_latest_values_t &msg);
     dcgmReturn_t ProcessGetMultipleValuesForField(dcgm_core_msg_get_multiple_values_for_field_t &msg);
+    dcgmReturn_t ProcessGetMultipleLatestValues(dcgm_core_msg_get_multiple_latest_values_t &msg);
+    dcgmReturn_t ProcessGetLatestValuesMatrix(dcgm_core_msg_get_latest_values_matrix_t &msg);
+    dcgmReturn_t ProcessGetFieldMultipleValues(dcgm_core_msg_get_field_multiple_values_t &msg);
+    dcgmReturn_t ProcessGetTransportStats(dcgm_core_msg_get_transport_stats_t &msg);
+    dcgmReturn_t ProcessAttributeCacheSubscribe(dcgm_core_msg_attribute_cache_subscribe_t &msg);
+    dcgmReturn_t ProcessGetBucketedValuesForField(dcgm_core_msg_get_bucketed_values_for_field_t &msg);
     dcgmReturn_t ProcessWatchFieldValue(dcgm_core_msg_watch_field_value_t &msg);
     dcgmReturn_t ProcessUpdateAllFields(dcgm_core_msg_update_all_fields_t &msg);
     dcgmReturn_t ProcessUnwatchFieldValue(dcgm_core_msg_unwatch_field_value_t &msg);
     dcgmReturn_t ProcessInjectFieldValue(dcgm_core_msg_inject_field_value_t &msg);
+    dcgmReturn_t ProcessInjectFieldValues(dcgm_core_msg_inject_field_values_t &msg);
     dcgmReturn_t ProcessGetCacheManagerFieldInfo(dcgm_core_msg_get_cache_manager_field_info_t &msg);
-    dcgmReturn_t ProcessWatchFields(dcgm_core_msg_watch_fields_t &msg);
+    dcgmReturn_t ProcessWatchFields(dcgm_core_msg_watch_fields_t &msg, bool snapshot = false);
     dcgmReturn_t ProcessUnwatchFields(dcgm_core_msg_watch_fields_t &msg);
     dcgmReturn_t ProcessGetTopology(dcgm_core_msg_get_topology_t &msg);
     dcgmReturn_t ProcessGetTopologyAffinity(dcgm_core_msg_get_topology_affinity_t &msg);
@@ -75,6 +84,18 @@ public:
     dcgmReturn_t ProcessHostEngineHealth(dcgm_core_msg_hostengine_health_t &msg);
     dcgmReturn_t ProcessFieldGroupGetAll(dcgm_core_msg_fieldgroup_get_all_t &msg);
     dcgmReturn_t ProcessGetGpuInstanceHierarchy(dcgm_core_msg_get_gpu_instance_hierarchy_t &msg);
+    dcgmReturn_t ProcessTraceControl(dcgm_core_msg_trace_control_t &msg);
+    dcgmReturn_t ProcessFvStreamSubscribe(dcgm_core_msg_fv_stream_subscribe_t &msg);
+    dcgmReturn_t ProcessFvStreamUnsubscribe(dcgm_core_msg_fv_stream_unsubscribe_t &msg);
+    dcgmReturn_t ProcessProxyStreamSubscribe(dcgm_core_msg_proxy_stream_subscribe_t &msg);
+    dcgmReturn_t ProcessProxyStreamUnsubscribe(dcgm_core_msg_proxy_stream_unsubscribe_t &msg);
+    dcgmReturn_t ProcessProxyGetHosts(dcgm_core_msg_proxy_get_hosts_t &msg);
+    dcgmReturn_t ProcessGetWorkerStats(dcgm_core_msg_get_worker_stats_t &msg);
+    dcgmReturn_t ProcessGetRequestStats(dcgm_core_msg_get_request_stats_t &msg);
+    dcgmReturn_t ProcessGetMemoryAccounting(dcgm_core_msg_get_memory_accounting_t &msg);
+    dcgmReturn_t ProcessSession(unsigned int subCommand, dcgm_core_msg_session_t &msg);
+    dcgmReturn_t ProcessEstimateWatchCost(dcgm_core_msg_estimate_watch_cost_t &msg);
+    dcgmReturn_t ProcessSetDerivedField(dcgm_core_msg_set_derived_field_t &msg);
 
     dcgmModuleProcessMessage_f GetMessageProcessingCallback() const;
 
@@ -82,4 +103,43 @@ private:
     DcgmCacheManager *m_cacheManager;
     DcgmGroupManager *m_groupManager;
     dcgmModuleProcessMessage_f m_processMsgCB;
+
+    /* Get the given entities (or those of groupId) and fields (or those of fieldGroupId) */
+    dcgmReturn_t ResolveEntitiesAndFields(unsigned int groupId,
+                                          dcgmGroupEntityPair_t const *entityList,
+                                          unsigned int entitiesCount,
+                                          unsigned int fieldGroupId,
+                                          unsigned short const *fieldIdList,
+                                          unsigned int fieldIdCount,
+                                          std::vector<dcgmGroupEntityPair_t> &entities,
+                                          std::vector<unsigned short> &fieldIds);
+
+    /* Get the latest values of the given entities (or groupId) and fields (or fieldGroupId) into fvBuffer.
+       sinceSequence and updateSequence are as for DcgmCacheManager::GetMultipleLatestSamples() */
+    dcgmReturn_t GetLatestValues(unsigned int groupId,
+                                 dcgmGroupEntityPair_t const *entityList,
+                                 unsigned int entitiesCount,
+                                 unsigned int fieldGroupId,
+                                 unsigned short const *fieldIdList,
+                                 unsigned int fieldIdCount,
+                                 unsigned int flags,
+                                 DcgmFvBuffer &fvBuffer,
+                                 unsigned long long sinceSequence    = 0,
+                                 unsigned long long *updateSequence = nullptr);
+
+    /* Get up to maxCount cached values of one field of an entity into fvBuffer. If position is given, the
+       values after it are returned instead of by startTs, endTs and order. See
+       DcgmCacheManager::GetSamplesAfter(). If watcher watches the field slower than it is sampled, only
+       the values it is due are returned. See DcgmCacheManager::GetWatcherDecimationUsec() */
+    dcgmReturn_t GetFieldSamples(dcgm_field_entity_group_t entityGroupId,
+                                 dcgm_field_eid_t entityId,
+                                 unsigned short fieldId,
+                                 long long startTs,
+                                 long long endTs,
+                                 dcgmOrder_t order,
+                                 int maxCount,
+                                 DcgmFvBuffer &fvBuffer,
+                                 timeseries_position_t *position = nullptr,
+                                 long long *samplesSkipped       = nullptr,
+                                 DcgmWatcher const *watcher      = nullptr);
 };
@@ -75,6 +75,10 @@ typedef enum
     DcgmCoreReqIdCMPopulateWatchInfo           = 44, // DcgmCacheManager::PopulateGpuInfo()
     DcgmCoreReqIdGetMigInstanceEntityId        = 45, // DcgmCacheManager::GetComputeInstanceEntityId()
     DcgmCoreReqIdGetMigUtilization             = 46, // DcgmCacheManager::GetMigUtilization()
+    DcgmCoreReqIdCMGetMultipleSamples          = 47, // DcgmCacheManager::GetMultipleSamples()
+    DcgmCoreReqIdSetModuleDispatch             = 48, // DcgmHostEngineHandler::SetModuleDispatch()
+    DcgmCoreReqIdCMSetWatchPredicate           = 49, // DcgmCacheManager::SetWatchPredicate()
+    DcgmCoreReqIdCMSetPredicatesBypassed       = 50, // DcgmCacheManager::SetPredicatesBypassed()
     DcgmCoreReqIdCount                               // Always keep this one last
 } dcgmCoreReqCmd_t;
 
@@ -83,6 +87,54 @@ typedef enum
 typedef dcgmReturn_t (*dcgmCoreReqPost_f)(dcgm_module_command_header_t *req, void *);
 typedef dcgmReturn_t (*dcgmCoreGetResponse_f)(dcgmCoreReqId_t reqId, unsigned int timeout);
 typedef void (*dcgmLoggerCallback_f)(const void *);
+/* Functions of dcgmCoreCacheAccess_v1. Each takes its cacheManager as the first argument and otherwise
+   matches the DcgmCacheManager method of the same name */
+typedef dcgmReturn_t (*dcgmCoreGetLatestSample_f)(void *cacheManager,
+                                                  dcgm_field_entity_group_t entityGroupId,
+                                                  dcgm_field_eid_t entityId,
+                                                  unsigned short fieldId,
+                                                  dcgmcm_sample_p sample);
+typedef dcgmReturn_t (*dcgmCoreGetSamples_f)(void *cacheManager,
+                                             dcgm_field_entity_group_t entityGroupId,
+                                             dcgm_field_eid_t entityId,
+                                             unsigned short fieldId,
+                                             dcgmcm_sample_p samples,
+                                             int *Msamples,
+                                             timelib64_t startTime,
+                                             timelib64_t endTime,
+                                             dcgmOrder_t order);
+typedef dcgmReturn_t (*dcgmCoreGetInt64SummaryData_f)(void *cacheManager,
+                                                      dcgm_field_entity_group_t entityGroupId,
+                                                      dcgm_field_eid_t entityId,
+                                                      unsigned short fieldId,
+                                                      int numSummaryTypes,
+                                                      DcgmcmSummaryType_t *summaryTypes,
+                                                      long long *summaryValues,
+                                                      timelib64_t startTime,
+                                                      timelib64_t endTime,
+                                                      pfUseEntryForSummary pfUseEntryCB,
+                                                      void *userData);
+
+/**
+ * Read-only access to the cache of libdcgm for modules that are loaded into the same process as it.
+ * The results land straight in the caller's buffers instead of being marshalled through a request struct
+ * and postfunc. Modules fall back to postfunc if the core doesn't provide this or has a different version
+ */
+typedef struct
+{
+    unsigned int version;                              // !< the version of this structure
+    void *cacheManager;                                // !< passed back to each of the functions below
+    dcgmCoreGetLatestSample_f getLatestSample;         // !< DcgmCacheManager::GetLatestSample() without an FvBuffer
+    dcgmCoreGetSamples_f getSamples;                   // !< DcgmCacheManager::GetSamples()
+    dcgmCoreGetInt64SummaryData_f getInt64SummaryData; // !< DcgmCacheManager::GetInt64SummaryData()
+} dcgmCoreCacheAccess_v1;
+
+#define dcgmCoreCacheAccess_version1 MAKE_DCGM_VERSION(dcgmCoreCacheAccess_v1, 1)
+
+#define dcgmCoreCacheAccess_version dcgmCoreCacheAccess_version1
+
+typedef dcgmCoreCacheAccess_v1 dcgmCoreCacheAccess_t;
+
 /**
  * Contains the callbacks that should be used for communicating between the modules and libdcgm
  */
@@ -94,11 +146,24 @@ typedef struct
     dcgmLoggerCallback_f loggerfunc; // !< function pointer to send logging messages to the hostengine
 } dcgmCoreCallbacks_v1;
 
+/**
+ * Version 2 adds direct cache access. Starts with the members of dcgmCoreCallbacks_v1
+ */
+typedef struct
+{
+    unsigned int version;                     // !< the version of the callback structure
+    dcgmCoreReqPost_f postfunc;               // !< function pointer to post a request to the core library
+    void *poster;                             // !< pointer to the object that will forward the request to the core
+    dcgmLoggerCallback_f loggerfunc;          // !< function pointer to send logging messages to the hostengine
+    dcgmCoreCacheAccess_t const *cacheAccess; // !< direct cache access, or nullptr to only use postfunc
+} dcgmCoreCallbacks_v2;
+
 #define dcgmCoreCallbacks_version1 MAKE_DCGM_VERSION(dcgmCoreCallbacks_v1, 1)
+#define dcgmCoreCallbacks_version2 MAKE_DCGM_VERSION(dcgmCoreCallbacks_v2, 2)
 
-#define dcgmCoreCallbacks_version dcgmCoreCallbacks_version1
+#define dcgmCoreCallbacks_version dcgmCoreCallbacks_version2
 
-typedef dcgmCoreCallbacks_v1 dcgmCoreCallbacks_t;
+typedef dcgmCoreCallbacks_v2 dcgmCoreCallbacks_t;
 
 /**
  * Basic information covering simple requests that just specify an ID and maybe an entity group as well
@@ -134,6 +199,28 @@ typedef struct
 
 } dcgmCoreNotifyRequestMessage_t;
 
+typedef struct
+{
+    dcgmModuleId_t moduleId;              // !< The module that is setting how it is dispatched to
+    unsigned int commandThreads;          // !< Up to N threads process client commands. 0 = inline
+    unsigned long long inlineSubCommands; // !< Bit N set = subCommand N stays inline even with commandThreads
+} dcgmCoreSetModuleDispatchParams_t;
+
+typedef struct
+{
+    dcgm_field_entity_group_t entityGroupId; // !< Entity group of the watch
+    dcgm_field_eid_t entityId;               // !< Entity of the watch
+    unsigned short fieldId;                  // !< Field of the watch
+    DcgmWatcherType_t watcherType;           // !< Watcher type whose subscribers the predicate filters for
+    dcgmcm_predicate_t predicate;            // !< Which values those subscribers are handed
+} dcgmCoreSetWatchPredicateParams_t;
+
+typedef struct
+{
+    DcgmWatcherType_t watcherType; // !< Watcher type whose predicates are bypassed or not
+    bool bypassed;                 // !< Hand over every value whatever the predicates?
+} dcgmCoreSetPredicatesBypassedParams_t;
+
 typedef struct
 {
     dcgmAllFieldGroup_t groups;
@@ -269,6 +356,18 @@ typedef struct
     size_t bufferPosition;                                      // !< The start position for buffer copying
 } dcgmCoreGetMultipleLatestLiveSamplesParams_t;
 
+/**
+ * This struct holds all of the parameters necessary to call GetMultipleSamples()
+ */
+typedef struct
+{
+    dcgmcm_sample_query_t const *queries; // !< Entity, field and order of each query
+    size_t numQueries;                    // !< The number of queries
+    timelib64_t startTime;                // !< the earliest timestamp a sample may have
+    timelib64_t endTime;                  // !< the latest timestamp a sample may have
+    int maxSamplesPerQuery;               // !< the maximum number of samples to get for each query
+} dcgmCoreGetMultipleSamplesParams_t;
+
 /**
  * This struct holds all of the parameters necessary to call RemoveFieldWatch()
  */
@@ -293,11 +392,13 @@ typedef struct
 
 /**
  * This struct holds all of the parameters necessary to call AppendSamples()
+ *
+ * Modules are loaded into the process of libdcgm, so the buffer is handed over as is rather than
+ * serialized into the request. The core moves the samples out of it, leaving it empty
  */
 typedef struct
 {
-    const char *buffer; // !< Pointer to a raw DcgmFvBuffer. Owned by the object.
-    size_t bufferSize;  // !< Size of the buffer
+    DcgmFvBuffer *fvBuffer; // !< The samples to append. Emptied by the core
 } dcgmCoreAppendSamplesParams_t;
 
 /**
@@ -381,6 +482,12 @@ typedef struct
     int numSamples;          // !< The number of samples stored at that address.
 } dcgmCoreGetSamplesResponse_t;
 
+typedef struct
+{
+    dcgmReturn_t ret;       // !< The status of the function call
+    DcgmFvBuffer *fvBuffer; // !< The caller's buffer that the samples are appended to
+} dcgmCoreGetMultipleSamplesResponse_t;
+
 #define SAMPLES_BUFFER_SIZE 16384
 
 typedef struct
@@ -446,6 +553,39 @@ typedef struct
 #define dcgmCoreNotifyRequestOfCompletion_version  dcgmCoreNotifyRequestOfCompletion_version1
 typedef dcgmCoreNotifyRequestOfCompletion_v1 dcgmCoreNotifyRequestOfCompletion_t;
 
+typedef struct
+{
+    dcgm_module_command_header_t header; // Command header
+    dcgmCoreSetModuleDispatchParams_t request;
+    dcgmReturn_t response;
+} dcgmCoreSetModuleDispatch_v1;
+
+#define dcgmCoreSetModuleDispatch_version1 MAKE_DCGM_VERSION(dcgmCoreSetModuleDispatch_v1, 1)
+#define dcgmCoreSetModuleDispatch_version  dcgmCoreSetModuleDispatch_version1
+typedef dcgmCoreSetModuleDispatch_v1 dcgmCoreSetModuleDispatch_t;
+
+typedef struct
+{
+    dcgm_module_command_header_t header; // Command header
+    dcgmCoreSetWatchPredicateParams_t request;
+    dcgmReturn_t response;
+} dcgmCoreSetWatchPredicate_v1;
+
+#define dcgmCoreSetWatchPredicate_version1 MAKE_DCGM_VERSION(dcgmCoreSetWatchPredicate_v1, 1)
+#define dcgmCoreSetWatchPredicate_version  dcgmCoreSetWatchPredicate_version1
+typedef dcgmCoreSetWatchPredicate_v1 dcgmCoreSetWatchPredicate_t;
+
+typedef struct
+{
+    dcgm_module_command_header_t header; // Command header
+    dcgmCoreSetPredicatesBypassedParams_t request;
+    dcgmReturn_t response;
+} dcgmCoreSetPredicatesBypassed_v1;
+
+#define dcgmCoreSetPredicatesBypassed_version1 MAKE_DCGM_VERSION(dcgmCoreSetPredicatesBypassed_v1, 1)
+#define dcgmCoreSetPredicatesBypassed_version  dcgmCoreSetPredicatesBypassed_version1
+typedef dcgmCoreSetPredicatesBypassed_v1 dcgmCoreSetPredicatesBypassed_t;
+
 typedef struct
 {
     dcgm_module_command_header_t header; // Command header
@@ -656,6 +796,17 @@ typedef struct
 #define dcgmCoreGetMultipleLatestLiveSamples_version  dcgmCoreGetMultipleLatestLiveSamples_version1
 typedef dcgmCoreGetMultipleLatestLiveSamples_v1 dcgmCoreGetMultipleLatestLiveSamples_t;
 
+typedef struct
+{
+    dcgm_module_command_header_t header; // Command header
+    dcgmCoreGetMultipleSamplesParams_t request;
+    dcgmCoreGetMultipleSamplesResponse_t response;
+} dcgmCoreGetMultipleSamples_v1;
+
+#define dcgmCoreGetMultipleSamples_version1 MAKE_DCGM_VERSION(dcgmCoreGetMultipleSamples_v1, 1)
+#define dcgmCoreGetMultipleSamples_version  dcgmCoreGetMultipleSamples_version1
+typedef dcgmCoreGetMultipleSamples_v1 dcgmCoreGetMultipleSamples_t;
+
 typedef struct
 {
     dcgm_module_command_header_t header; // Command header
@@ -672,11 +823,11 @@ typedef struct
     dcgm_module_command_header_t header; // Command header
     dcgmCoreAppendSamplesParams_t request;
     dcgmReturn_t ret;
-} dcgmCoreAppendSamples_v1;
+} dcgmCoreAppendSamples_v2;
 
-#define dcgmCoreAppendSamples_version1 MAKE_DCGM_VERSION(dcgmCoreAppendSamples_v1, 1)
-#define dcgmCoreAppendSamples_version  dcgmCoreAppendSamples_version1
-typedef dcgmCoreAppendSamples_v1 dcgmCoreAppendSamples_t;
+#define dcgmCoreAppendSamples_version2 MAKE_DCGM_VERSION(dcgmCoreAppendSamples_v2, 2)
+#define dcgmCoreAppendSamples_version  dcgmCoreAppendSamples_version2
+typedef dcgmCoreAppendSamples_v2 dcgmCoreAppendSamples_t;
 
 typedef struct
 {
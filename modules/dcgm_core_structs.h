@@ -18,6 +18,9 @@
 /* DCGM Module messages used for communicating with core DCGM */
 
 #include "dcgm_module_structs.h"
+#include <memory>
+
+class DcgmFvBuffer;
 
 /*****************************************************************************/
 /* Core Subrequest IDs */
@@ -71,6 +74,29 @@
 #define DCGM_CORE_SR_HOSTENGINE_HEALTH             48 /* Get health of hostengine */
 #define DCGM_CORE_SR_FIELDGROUP_GET_ALL            49 /* Get all fieldgroup info */
 #define DCGM_CORE_SR_GET_GPU_INSTANCE_HIERARCHY    50 /* Get gpu instance hierarchy */
+#define DCGM_CORE_SR_TRACE_CONTROL                 51 /* Start, stop or dump update-loop tracing */
+#define DCGM_CORE_SR_GET_BUCKETED_VALUES_FOR_FIELD 52 /* Get the values of a field combined into time buckets */
+#define DCGM_CORE_SR_FV_STREAM_SUBSCRIBE           53 /* Start streaming field values to the client */
+#define DCGM_CORE_SR_FV_STREAM_UNSUBSCRIBE         54 /* Stop streaming field values to the client */
+#define DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES    55 /* Get the latest values of fields as a DcgmFvBuffer */
+#define DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES     56 /* Get the values of a field over time as a DcgmFvBuffer */
+#define DCGM_CORE_SR_GET_TRANSPORT_STATS           57 /* Get the traffic of the client's connection */
+#define DCGM_CORE_SR_ATTRIBUTE_CACHE_SUBSCRIBE     58 /* Push attribute generation changes to the client */
+#define DCGM_CORE_SR_PROXY_STREAM_SUBSCRIBE        59 /* Start streaming values of the proxied host engines */
+#define DCGM_CORE_SR_PROXY_STREAM_UNSUBSCRIBE      60 /* Stop streaming values of the proxied host engines */
+#define DCGM_CORE_SR_PROXY_GET_HOSTS               61 /* Get the state of the proxied host engines */
+#define DCGM_CORE_SR_GET_WORKER_STATS              62 /* Get the worker threads of the request lanes */
+#define DCGM_CORE_SR_GET_REQUEST_STATS             63 /* Get the counts and latencies of requests by type */
+#define DCGM_CORE_SR_GET_MEMORY_ACCOUNTING         64 /* Get memory by subsystem, module and watcher */
+#define DCGM_CORE_SR_SESSION_GET_TOKEN             65 /* Get the token to resume the client's state with */
+#define DCGM_CORE_SR_SESSION_RESUME                66 /* Take over the state restored for a session token */
+#define DCGM_CORE_SR_ESTIMATE_WATCH_COST           67 /* Predict the cost of a watch before making it */
+#define DCGM_CORE_SR_INJECT_FIELD_VALUES           68 /* Inject a DcgmFvBuffer of values in one request */
+#define DCGM_CORE_SR_JOB_GET_PERCENTILES           69 /* Get the percentiles of a job's gauges */
+#define DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX      70 /* Get the latest values of a group as a dense table */
+#define DCGM_CORE_SR_WATCH_FIELDS_SNAPSHOT         71 /* Watch a group of fields as a snapshot group */
+#define DCGM_CORE_SR_SET_DERIVED_FIELD             72 /* Define a derived field */
+#define DCGM_CORE_SR_JOB_GET_STATS_SINCE           73 /* Get the stats of a job if it changed */
 
 /*****************************************************************************/
 /* Subrequest message definitions */
@@ -137,9 +163,21 @@ typedef struct dcgm_core_msg_field_values_updated_v1
 } dcgm_core_msg_field_values_updated_v1;
 
 #define dcgm_core_msg_field_values_updated_version1 MAKE_DCGM_VERSION(dcgm_core_msg_field_values_updated_v1, 1)
-#define dcgm_core_msg_field_values_updated_version  dcgm_core_msg_field_values_updated_version1
 
-typedef dcgm_core_msg_field_values_updated_v1 dcgm_core_msg_field_values_updated_t;
+typedef struct dcgm_core_msg_field_values_updated_v2
+{
+    dcgm_module_command_header_t header; /* Command header */
+    dcgm_core_msg_fvbuffer_v1 fieldValues;
+    /* The buffer behind fieldValues, shared by every module that gets this update. Modules
+       can keep a copy of it to walk later from their own thread instead of copying
+       fieldValues. Only valid for the duration of the call */
+    std::shared_ptr<DcgmFvBuffer const> const *snapshot;
+} dcgm_core_msg_field_values_updated_v2;
+
+#define dcgm_core_msg_field_values_updated_version2 MAKE_DCGM_VERSION(dcgm_core_msg_field_values_updated_v2, 2)
+#define dcgm_core_msg_field_values_updated_version  dcgm_core_msg_field_values_updated_version2
+
+typedef dcgm_core_msg_field_values_updated_v2 dcgm_core_msg_field_values_updated_t;
 
 typedef struct dcgm_core_msg_set_severity_v1
 {
@@ -310,6 +348,18 @@ typedef struct
 
 typedef dcgm_core_msg_get_multiple_values_for_field_v1 dcgm_core_msg_get_multiple_values_for_field_t;
 
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmGetBucketedValuesForField_v1 fv;
+} dcgm_core_msg_get_bucketed_values_for_field_v1;
+
+#define dcgm_core_msg_get_bucketed_values_for_field_version1 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_get_bucketed_values_for_field_v1, 1)
+#define dcgm_core_msg_get_bucketed_values_for_field_version dcgm_core_msg_get_bucketed_values_for_field_version1
+
+typedef dcgm_core_msg_get_bucketed_values_for_field_v1 dcgm_core_msg_get_bucketed_values_for_field_t;
+
 typedef struct
 {
     dcgm_module_command_header_t header;
@@ -358,13 +408,13 @@ typedef struct
 {
     dcgm_module_command_header_t header;
     dcgmGetCacheManagerFieldInfo_v1 fi;
-} dcgm_core_msg_get_cache_manager_field_info_v1;
+} dcgm_core_msg_get_cache_manager_field_info_v3;
 
-#define dcgm_core_msg_get_cache_manager_field_info_version1 \
-    MAKE_DCGM_VERSION(dcgm_core_msg_get_cache_manager_field_info_v1, 1)
-#define dcgm_core_msg_get_cache_manager_field_info_version dcgm_core_msg_get_cache_manager_field_info_version1
+#define dcgm_core_msg_get_cache_manager_field_info_version3 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_get_cache_manager_field_info_v3, 3)
+#define dcgm_core_msg_get_cache_manager_field_info_version dcgm_core_msg_get_cache_manager_field_info_version3
 
-typedef dcgm_core_msg_get_cache_manager_field_info_v1 dcgm_core_msg_get_cache_manager_field_info_t;
+typedef dcgm_core_msg_get_cache_manager_field_info_v3 dcgm_core_msg_get_cache_manager_field_info_t;
 
 typedef struct
 {
@@ -566,11 +616,410 @@ typedef struct
 
 typedef dcgm_core_msg_get_gpu_instance_hierarchy_v1 dcgm_core_msg_get_gpu_instance_hierarchy_t;
 
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmMsgTraceControl_v1 info;
+} dcgm_core_msg_trace_control_v1;
+
+#define dcgm_core_msg_trace_control_version1 MAKE_DCGM_VERSION(dcgm_core_msg_trace_control_v1, 1)
+#define dcgm_core_msg_trace_control_version  dcgm_core_msg_trace_control_version1
+
+typedef dcgm_core_msg_trace_control_v1 dcgm_core_msg_trace_control_t;
+
+typedef struct
+{
+    dcgm_module_command_header_t header; /* header.requestId is the ID of the stream */
+    dcgmFieldValueStreamParams_v1 params;
+    unsigned int cmdRet; /* OUT: Error code generated */
+} dcgm_core_msg_fv_stream_subscribe_v1;
+
+#define dcgm_core_msg_fv_stream_subscribe_version1 MAKE_DCGM_VERSION(dcgm_core_msg_fv_stream_subscribe_v1, 1)
+#define dcgm_core_msg_fv_stream_subscribe_version  dcgm_core_msg_fv_stream_subscribe_version1
+
+typedef dcgm_core_msg_fv_stream_subscribe_v1 dcgm_core_msg_fv_stream_subscribe_t;
+
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    unsigned int streamId; /* IN: requestId the stream was subscribed with */
+    unsigned int cmdRet;   /* OUT: Error code generated */
+} dcgm_core_msg_fv_stream_unsubscribe_v1;
+
+#define dcgm_core_msg_fv_stream_unsubscribe_version1 MAKE_DCGM_VERSION(dcgm_core_msg_fv_stream_unsubscribe_v1, 1)
+#define dcgm_core_msg_fv_stream_unsubscribe_version  dcgm_core_msg_fv_stream_unsubscribe_version1
+
+typedef dcgm_core_msg_fv_stream_unsubscribe_v1 dcgm_core_msg_fv_stream_unsubscribe_t;
+
+/*
+ * Field value replies that carry a DcgmFvBuffer of any size after the struct,
+ * rather than in a fixed SAMPLES_BUFFER_SIZE array. The client allocates
+ * sizeof(struct) + bufferCapacity bytes and sends just the struct. The host
+ * engine grows the message to that size, capped at DCGM_FV_REPLY_MAX_BUFFER_SIZE
+ * of buffer, and the response's buffer is read in place with GetNextFv().
+ */
+
+/* Most bytes of DcgmFvBuffer a field value reply can carry. Leaves room for the
+   reply's struct in a DCGM_PROTO_MAX_MESSAGE_SIZE message */
+#define DCGM_FV_REPLY_MAX_BUFFER_SIZE (4 * 1024 * 1024 - 4096)
+
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmGetMultipleLatestValues_v1 request; /* IN: Entities and fields to get the latest values of */
+    unsigned int bufferCapacity;            /* IN: Bytes after this struct the client can receive */
+    unsigned int cmdRet;                    /* OUT: Error code generated. DCGM_ST_INSUFFICIENT_SIZE if
+                                                    the values didn't fit. bufferSize is the size needed then */
+    unsigned int bufferSize;                /* OUT: Bytes of DcgmFvBuffer after this struct */
+} dcgm_core_msg_get_multiple_latest_values_v1;
+
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmGetMultipleLatestValues_v1 request; /* IN: Entities and fields to get the latest values of */
+    unsigned int bufferCapacity;            /* IN: Bytes after this struct the client can receive */
+    unsigned int cmdRet;                    /* OUT: Error code generated. DCGM_ST_INSUFFICIENT_SIZE if
+                                                    the values didn't fit. bufferSize is the size needed then */
+    unsigned int bufferSize;                /* OUT: Bytes of DcgmFvBuffer after this struct */
+    unsigned int unused;                    /* Unused. Aligns sinceSequence */
+    unsigned long long sinceSequence;       /* IN: Only return values updated after this update sequence.
+                                                   0 = all values. Ignored for DCGM_FV_FLAG_LIVE_DATA */
+    unsigned long long updateSequence;      /* OUT: Update sequence the values are current as of. Pass it
+                                                    as sinceSequence next time to only get what changed */
+} dcgm_core_msg_get_multiple_latest_values_v2;
+
+#define dcgm_core_msg_get_multiple_latest_values_version1 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_get_multiple_latest_values_v1, 1)
+#define dcgm_core_msg_get_multiple_latest_values_version2 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_get_multiple_latest_values_v2, 2)
+#define dcgm_core_msg_get_multiple_latest_values_version dcgm_core_msg_get_multiple_latest_values_version2
+
+typedef dcgm_core_msg_get_multiple_latest_values_v2 dcgm_core_msg_get_multiple_latest_values_t;
+
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    unsigned int entityGroupId;  /* IN: Entity group of the entity to fetch values for */
+    unsigned int entityId;       /* IN: Entity to fetch values for */
+    unsigned int fieldId;        /* IN: Field to fetch */
+    unsigned int order;          /* IN: Order of the values. See dcgmOrder_t */
+    long long startTs;           /* IN: Starting timestamp. 0 = the oldest value */
+    long long endTs;             /* IN: End timestamp. 0 = now */
+    unsigned int count;          /* IN: Most values to return. OUT: Number of values in the buffer, which is
+                                        less than asked for if that's all that fit in bufferCapacity */
+    unsigned int bufferCapacity; /* IN: Bytes after this struct the client can receive */
+    unsigned int cmdRet;         /* OUT: Error code generated */
+    unsigned int bufferSize;     /* OUT: Bytes of DcgmFvBuffer after this struct */
+} dcgm_core_msg_get_field_multiple_values_v1;
+
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    unsigned int entityGroupId;  /* IN: Entity group of the entity to fetch values for */
+    unsigned int entityId;       /* IN: Entity to fetch values for */
+    unsigned int fieldId;        /* IN: Field to fetch */
+    unsigned int order;          /* IN: Order of the values. See dcgmOrder_t */
+    long long startTs;           /* IN: Starting timestamp. 0 = the oldest value */
+    long long endTs;             /* IN: End timestamp. 0 = now */
+    unsigned int count;          /* IN: Most values to return. OUT: Number of values in the buffer, which is
+                                        less than asked for if that's all that fit in bufferCapacity */
+    unsigned int bufferCapacity; /* IN: Bytes after this struct the client can receive */
+    unsigned int cmdRet;         /* OUT: Error code generated */
+    unsigned int bufferSize;     /* OUT: Bytes of DcgmFvBuffer after this struct */
+    unsigned int useCursor;      /* IN: 1 = return the values after cursor, oldest first. order, startTs
+                                        and endTs are ignored then */
+    unsigned int unused;         /* Unused. Aligns cursor */
+    dcgmValuesCursor_t cursor;   /* IN/OUT: Where to continue from. Set to after the last value returned */
+    long long valuesSkipped;     /* OUT: Values removed from the cache after cursor before they were returned */
+} dcgm_core_msg_get_field_multiple_values_v2;
+
+#define dcgm_core_msg_get_field_multiple_values_version1 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_get_field_multiple_values_v1, 1)
+#define dcgm_core_msg_get_field_multiple_values_version2 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_get_field_multiple_values_v2, 2)
+#define dcgm_core_msg_get_field_multiple_values_version dcgm_core_msg_get_field_multiple_values_version2
+
+typedef dcgm_core_msg_get_field_multiple_values_v2 dcgm_core_msg_get_field_multiple_values_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_GET_TRANSPORT_STATS
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmTransportCounters_t counters; /* OUT: Traffic of the requesting connection as counted by the host engine */
+    unsigned int cmdRet;              /* OUT: Error code generated */
+} dcgm_core_msg_get_transport_stats_v1;
+
+#define dcgm_core_msg_get_transport_stats_version1 MAKE_DCGM_VERSION(dcgm_core_msg_get_transport_stats_v1, 1)
+
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmTransportCounters_t counters; /* OUT: Traffic of the requesting connection as counted by the host engine */
+    dcgmSendQueueStats_t sendQueue;   /* OUT: Messages the host engine is waiting to send to the connection */
+    unsigned int cmdRet;              /* OUT: Error code generated */
+} dcgm_core_msg_get_transport_stats_v2;
+
+#define dcgm_core_msg_get_transport_stats_version2 MAKE_DCGM_VERSION(dcgm_core_msg_get_transport_stats_v2, 2)
+#define dcgm_core_msg_get_transport_stats_version  dcgm_core_msg_get_transport_stats_version2
+
+typedef dcgm_core_msg_get_transport_stats_v2 dcgm_core_msg_get_transport_stats_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_ATTRIBUTE_CACHE_SUBSCRIBE. Changes are pushed to the
+ * header requestId as DCGM_MSG_ATTRIBUTE_GENERATION until the connection closes
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    unsigned long long generation; /* OUT: The host engine's current attribute generation */
+    unsigned int cmdRet;           /* OUT: Error code generated */
+} dcgm_core_msg_attribute_cache_subscribe_v1;
+
+#define dcgm_core_msg_attribute_cache_subscribe_version1 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_attribute_cache_subscribe_v1, 1)
+#define dcgm_core_msg_attribute_cache_subscribe_version dcgm_core_msg_attribute_cache_subscribe_version1
+
+typedef dcgm_core_msg_attribute_cache_subscribe_v1 dcgm_core_msg_attribute_cache_subscribe_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_PROXY_STREAM_SUBSCRIBE. params.groupId is looked up on each
+ * proxied host engine and params.fieldGroupId on this one
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header; /* header.requestId is the ID of the stream */
+    dcgmFieldValueStreamParams_v1 params;
+    unsigned int cmdRet; /* OUT: Error code generated */
+} dcgm_core_msg_proxy_stream_subscribe_v1;
+
+#define dcgm_core_msg_proxy_stream_subscribe_version1 MAKE_DCGM_VERSION(dcgm_core_msg_proxy_stream_subscribe_v1, 1)
+#define dcgm_core_msg_proxy_stream_subscribe_version  dcgm_core_msg_proxy_stream_subscribe_version1
+
+typedef dcgm_core_msg_proxy_stream_subscribe_v1 dcgm_core_msg_proxy_stream_subscribe_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_PROXY_STREAM_UNSUBSCRIBE
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    unsigned int streamId; /* IN: requestId the stream was subscribed with */
+    unsigned int cmdRet;   /* OUT: Error code generated */
+} dcgm_core_msg_proxy_stream_unsubscribe_v1;
+
+#define dcgm_core_msg_proxy_stream_unsubscribe_version1 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_proxy_stream_unsubscribe_v1, 1)
+#define dcgm_core_msg_proxy_stream_unsubscribe_version dcgm_core_msg_proxy_stream_unsubscribe_version1
+
+typedef dcgm_core_msg_proxy_stream_unsubscribe_v1 dcgm_core_msg_proxy_stream_unsubscribe_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_PROXY_GET_HOSTS
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmProxyHosts_v1 hosts; /* OUT: State of the proxied host engines */
+    unsigned int cmdRet;     /* OUT: Error code generated */
+} dcgm_core_msg_proxy_get_hosts_v1;
+
+#define dcgm_core_msg_proxy_get_hosts_version1 MAKE_DCGM_VERSION(dcgm_core_msg_proxy_get_hosts_v1, 1)
+#define dcgm_core_msg_proxy_get_hosts_version  dcgm_core_msg_proxy_get_hosts_version1
+
+typedef dcgm_core_msg_proxy_get_hosts_v1 dcgm_core_msg_proxy_get_hosts_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_GET_WORKER_STATS
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmHostengineWorkerStats_v1 stats; /* OUT: Workers of each request lane */
+    unsigned int cmdRet;                /* OUT: Error code generated */
+} dcgm_core_msg_get_worker_stats_v1;
+
+#define dcgm_core_msg_get_worker_stats_version1 MAKE_DCGM_VERSION(dcgm_core_msg_get_worker_stats_v1, 1)
+#define dcgm_core_msg_get_worker_stats_version  dcgm_core_msg_get_worker_stats_version1
+
+typedef dcgm_core_msg_get_worker_stats_v1 dcgm_core_msg_get_worker_stats_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_GET_REQUEST_STATS
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmIntrospectRequestStats_v1 stats; /* IN/OUT: flags in, requests by type out */
+    unsigned int cmdRet;                 /* OUT: Error code generated */
+} dcgm_core_msg_get_request_stats_v1;
+
+#define dcgm_core_msg_get_request_stats_version1 MAKE_DCGM_VERSION(dcgm_core_msg_get_request_stats_v1, 1)
+#define dcgm_core_msg_get_request_stats_version  dcgm_core_msg_get_request_stats_version1
+
+typedef dcgm_core_msg_get_request_stats_v1 dcgm_core_msg_get_request_stats_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_GET_MEMORY_ACCOUNTING
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmIntrospectMemoryAccounting_v1 accounting; /* IN/OUT: version in, memory by subsystem out */
+    unsigned int cmdRet;                          /* OUT: Error code generated */
+} dcgm_core_msg_get_memory_accounting_v1;
+
+#define dcgm_core_msg_get_memory_accounting_version1 MAKE_DCGM_VERSION(dcgm_core_msg_get_memory_accounting_v1, 1)
+#define dcgm_core_msg_get_memory_accounting_version  dcgm_core_msg_get_memory_accounting_version1
+
+typedef dcgm_core_msg_get_memory_accounting_v1 dcgm_core_msg_get_memory_accounting_t;
+
+/**
+ * Subrequests DCGM_CORE_SR_SESSION_GET_TOKEN and DCGM_CORE_SR_SESSION_RESUME
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    unsigned long long token; /* OUT: for GET_TOKEN. IN: for RESUME */
+    unsigned int cmdRet;      /* OUT: Error code generated */
+} dcgm_core_msg_session_v1;
+
+#define dcgm_core_msg_session_version1 MAKE_DCGM_VERSION(dcgm_core_msg_session_v1, 1)
+#define dcgm_core_msg_session_version  dcgm_core_msg_session_version1
+
+typedef dcgm_core_msg_session_v1 dcgm_core_msg_session_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_ESTIMATE_WATCH_COST
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmIntrospectWatchCost_v1 cost; /* IN/OUT: proposed watch in, predicted cost out */
+    unsigned int cmdRet;             /* OUT: Error code generated */
+} dcgm_core_msg_estimate_watch_cost_v1;
+
+#define dcgm_core_msg_estimate_watch_cost_version1 MAKE_DCGM_VERSION(dcgm_core_msg_estimate_watch_cost_v1, 1)
+#define dcgm_core_msg_estimate_watch_cost_version  dcgm_core_msg_estimate_watch_cost_version1
+
+typedef dcgm_core_msg_estimate_watch_cost_v1 dcgm_core_msg_estimate_watch_cost_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_INJECT_FIELD_VALUES
+ *
+ * The request carries bufferSize bytes of DcgmFvBuffer after the struct. The
+ * response is just the struct.
+ */
+
+/* Most bytes of DcgmFvBuffer an injection request can carry */
+#define DCGM_FV_INJECT_MAX_BUFFER_SIZE DCGM_FV_REPLY_MAX_BUFFER_SIZE
+
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    unsigned int bufferSize; /* IN: Bytes of DcgmFvBuffer after this struct */
+    unsigned int numValues;  /* OUT: Number of values injected */
+    unsigned int cmdRet;     /* OUT: Error code generated. Nothing is injected unless this is DCGM_ST_OK */
+    unsigned int unused;     /* Unused. Keeps the buffer 8-byte aligned */
+} dcgm_core_msg_inject_field_values_v1;
+
+#define dcgm_core_msg_inject_field_values_version1 MAKE_DCGM_VERSION(dcgm_core_msg_inject_field_values_v1, 1)
+#define dcgm_core_msg_inject_field_values_version  dcgm_core_msg_inject_field_values_version1
+
+typedef dcgm_core_msg_inject_field_values_v1 dcgm_core_msg_inject_field_values_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_JOB_GET_PERCENTILES
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    char jobId[64];                    /* IN: job id */
+    dcgmJobPercentiles_v1 percentiles; /* OUT: percentiles of the job */
+    unsigned int cmdRet;               /* OUT: Error code generated */
+} dcgm_core_msg_job_get_percentiles_v1;
+
+#define dcgm_core_msg_job_get_percentiles_version1 MAKE_DCGM_VERSION(dcgm_core_msg_job_get_percentiles_v1, 1)
+#define dcgm_core_msg_job_get_percentiles_version  dcgm_core_msg_job_get_percentiles_version1
+
+typedef dcgm_core_msg_job_get_percentiles_v1 dcgm_core_msg_job_get_percentiles_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX
+ *
+ * Like the field value replies above, the client allocates sizeof(struct) +
+ * DCGM_MATRIX_REPLY_MAX_BUFFER_SIZE bytes and sends just the struct. The
+ * response carries the numEntities * numFields cells of a
+ * dcgmLatestValuesMatrix_v1 after the struct, as their values, then their
+ * timestamps, then their status bytes, followed by stringsSize bytes of
+ * strings.
+ */
+
+/* Bytes after the struct of a reply with numCells cells and stringsSize bytes of strings */
+#define DCGM_MATRIX_REPLY_BUFFER_SIZE(numCells, stringsSize) \
+    ((numCells) * (sizeof(dcgmMatrixValue_t) + sizeof(long long) + 1) + (stringsSize))
+
+#define DCGM_MATRIX_REPLY_MAX_BUFFER_SIZE DCGM_MATRIX_REPLY_BUFFER_SIZE(DCGM_MATRIX_MAX_CELLS, DCGM_MATRIX_STRINGS_SIZE)
+
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    unsigned int groupId;                                         /* IN: Group of the entities of the rows */
+    unsigned int fieldGroupId;                                    /* IN: Field group of the fields of the columns */
+    unsigned int cmdRet;                                          /* OUT: Error code generated */
+    unsigned int numEntities;                                     /* OUT: Number of rows */
+    unsigned int numFields;                                       /* OUT: Number of columns */
+    unsigned int stringsSize;                                     /* OUT: Bytes of strings after the cells */
+    dcgmGroupEntityPair_t entities[DCGM_GROUP_MAX_ENTITIES];      /* OUT: Entity of each row */
+    unsigned short fieldIds[DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP];  /* OUT: Field of each column */
+    unsigned char fieldTypes[DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP]; /* OUT: DCGM_FT_? of each column */
+} dcgm_core_msg_get_latest_values_matrix_v1;
+
+#define dcgm_core_msg_get_latest_values_matrix_version1 \
+    MAKE_DCGM_VERSION(dcgm_core_msg_get_latest_values_matrix_v1, 1)
+#define dcgm_core_msg_get_latest_values_matrix_version dcgm_core_msg_get_latest_values_matrix_version1
+
+typedef dcgm_core_msg_get_latest_values_matrix_v1 dcgm_core_msg_get_latest_values_matrix_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_SET_DERIVED_FIELD
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    dcgmDerivedField_v1 derivedField; /* IN/OUT: field and expression in, why the expression is bad out */
+    unsigned int cmdRet;              /* OUT: Error code generated */
+} dcgm_core_msg_set_derived_field_v1;
+
+#define dcgm_core_msg_set_derived_field_version1 MAKE_DCGM_VERSION(dcgm_core_msg_set_derived_field_v1, 1)
+#define dcgm_core_msg_set_derived_field_version  dcgm_core_msg_set_derived_field_version1
+
+typedef dcgm_core_msg_set_derived_field_v1 dcgm_core_msg_set_derived_field_t;
+
+/**
+ * Subrequest DCGM_CORE_SR_JOB_GET_STATS_SINCE
+ */
+typedef struct
+{
+    dcgm_module_command_header_t header;
+    char jobId[64];                    /* IN: job id */
+    unsigned long long updateSequence; /* IN/OUT: Update sequence of the caller's copy of the stats, then of the job */
+    dcgmJobInfo_t jobStats;            /* OUT: job stats. Only set if updateSequence changed */
+    unsigned int cmdRet;               /* OUT: Error code generated */
+} dcgm_core_msg_job_get_stats_since_v1;
+
+#define dcgm_core_msg_job_get_stats_since_version1 MAKE_DCGM_VERSION(dcgm_core_msg_job_get_stats_since_v1, 1)
+#define dcgm_core_msg_job_get_stats_since_version  dcgm_core_msg_job_get_stats_since_version1
+
+typedef dcgm_core_msg_job_get_stats_since_v1 dcgm_core_msg_job_get_stats_since_t;
+
 DCGM_CASSERT(dcgm_core_msg_client_disconnect_version1 == (long)0x100001c, 1);
 DCGM_CASSERT(dcgm_core_msg_logging_changed_version1 == (long)0x1000018, 1);
 DCGM_CASSERT(dcgm_core_msg_mig_updated_version1 == (long)0x100001c, 1);
 DCGM_CASSERT(dcgm_core_msg_group_removed_version1 == (long)0x100001c, 1);
 DCGM_CASSERT(dcgm_core_msg_field_values_updated_version1 == (long)0x1000028, 1);
+DCGM_CASSERT(dcgm_core_msg_field_values_updated_version2 == (long)0x2000030, 2);
 DCGM_CASSERT(dcgm_core_msg_set_severity_version1 == (long)0x1000020, 1);
 DCGM_CASSERT(dcgm_core_msg_create_mig_entity_version1 == (long)0x100002c, 1);
 DCGM_CASSERT(dcgm_core_msg_delete_mig_entity_version1 == (long)0x1000028, 1);
@@ -585,11 +1034,31 @@ DCGM_CASSERT(dcgm_core_msg_job_cmd_version1 == (long)0x1000060, 1);
 DCGM_CASSERT(dcgm_core_msg_job_get_stats_version1 == (long)0x1009908, 1);
 DCGM_CASSERT(dcgm_core_msg_entities_get_latest_values_version1 == (long)0x1004334, 1);
 DCGM_CASSERT(dcgm_core_msg_get_multiple_values_for_field_version1 == (long)0x1004048, 1);
+DCGM_CASSERT(dcgm_core_msg_get_bucketed_values_for_field_version1 == (long)0x1004050, 1);
+DCGM_CASSERT(dcgm_core_msg_get_multiple_latest_values_version1 == (long)0x1000350, 1);
+DCGM_CASSERT(dcgm_core_msg_get_multiple_latest_values_version2 == (long)0x2000360, 2);
+DCGM_CASSERT(dcgm_core_msg_get_field_multiple_values_version1 == (long)0x1000048, 1);
+DCGM_CASSERT(dcgm_core_msg_get_field_multiple_values_version2 == (long)0x2000068, 2);
+DCGM_CASSERT(dcgm_core_msg_get_transport_stats_version1 == (long)0x1000068, 1);
+DCGM_CASSERT(dcgm_core_msg_get_transport_stats_version2 == (long)0x2000098, 2);
+DCGM_CASSERT(dcgm_core_msg_attribute_cache_subscribe_version1 == (long)0x1000028, 1);
+DCGM_CASSERT(dcgm_core_msg_proxy_stream_subscribe_version1 == (long)0x1000058, 1);
+DCGM_CASSERT(dcgm_core_msg_proxy_stream_unsubscribe_version1 == (long)0x1000020, 1);
+DCGM_CASSERT(dcgm_core_msg_proxy_get_hosts_version1 == (long)0x1009428, 1);
+DCGM_CASSERT(dcgm_core_msg_get_worker_stats_version1 == (long)0x1000268, 1);
+DCGM_CASSERT(dcgm_core_msg_get_request_stats_version1 == (long)0x100e830, 1);
+DCGM_CASSERT(dcgm_core_msg_get_memory_accounting_version1 == (long)0x1000e30, 1);
+DCGM_CASSERT(dcgm_core_msg_session_version1 == (long)0x1000028, 1);
+DCGM_CASSERT(dcgm_core_msg_estimate_watch_cost_version1 == (long)0x1002c78, 1);
+DCGM_CASSERT(dcgm_core_msg_inject_field_values_version1 == (long)0x1000028, 1);
+DCGM_CASSERT(dcgm_core_msg_job_get_percentiles_version1 == (long)0x1001718, 1);
+DCGM_CASSERT(dcgm_core_msg_job_get_stats_since_version1 == (long)0x1009910, 1);
+DCGM_CASSERT(dcgm_core_msg_get_latest_values_matrix_version1 == (long)0x10003b0, 1);
 DCGM_CASSERT(dcgm_core_msg_watch_field_value_version1 == (long)0x1000040, 1);
 DCGM_CASSERT(dcgm_core_msg_update_all_fields_version1 == (long)0x1000020, 1);
 DCGM_CASSERT(dcgm_core_msg_unwatch_field_value_version1 == (long)0x100002c, 1);
 DCGM_CASSERT(dcgm_core_msg_inject_field_value_version1 == (long)0x1001040, 1);
-DCGM_CASSERT(dcgm_core_msg_get_cache_manager_field_info_version1 == (long)0x1000158, 1);
+DCGM_CASSERT(dcgm_core_msg_get_cache_manager_field_info_version3 == (long)0x30001c0, 3);
 DCGM_CASSERT(dcgm_core_msg_watch_fields_version1 == (long)0x1000038, 1);
 DCGM_CASSERT(dcgm_core_msg_get_topology_version1 == (long)0x10026e8, 1);
 DCGM_CASSERT(dcgm_core_msg_get_topology_affinity_version1 == (long)0x1000930, 1);
@@ -609,4 +1078,5 @@ DCGM_CASSERT(dcgm_core_msg_hostengine_health_version1 == (long)0x1000020, 1);
 DCGM_CASSERT(dcgm_core_msg_fieldgroup_get_all_version1 == (long)0x1008428, 1);
 DCGM_CASSERT(dcgm_core_msg_fieldgroup_get_all_version == (long)0x1008428, 1);
 DCGM_CASSERT(dcgm_core_msg_get_gpu_instance_hierarchy_version1 == (long)0x1011f28, 1);
-DCGM_CASSERT(dcgm_core_msg_get_gpu_instance_hierarchy_version == (long)0x1011f28, 1);
\ No newline at end of file
+DCGM_CASSERT(dcgm_core_msg_get_gpu_instance_hierarchy_version == (long)0x1011f28, 1);
+DCGM_CASSERT(dcgm_core_msg_trace_control_version1 == (long)0x100012c, 1);
\ No newline at end of file
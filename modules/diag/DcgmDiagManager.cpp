@@ -21,6 +21,7 @@
 #include "NvvsJsonStrings.h"
 #include "dcgm_config_structs.h"
 #include "dcgm_diag_structs.h"
+#include "dcgm_profiling_structs.h"
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
@@ -34,47 +35,53 @@
 /*****************************************************************************/
 DcgmDiagManager::DcgmDiagManager(dcgmCoreCallbacks_t &dcc)
     : m_nvvsPath(GetNvvsBinPath())
+    , m_useWorker(getenv(NVVS_USE_WORKER) != nullptr && std::string(getenv(NVVS_USE_WORKER)) == "1")
+    , m_worker(m_nvvsPath)
     , m_mutex(0)
-    , m_nvvsPID(-1)
     , m_ticket(0)
+    , m_workerBusy(false)
     , m_coreProxy(dcc)
     , m_amShuttingDown(false)
+    , m_resultCache()
 {}
 
 DcgmDiagManager::~DcgmDiagManager()
 {
     DcgmLockGuard lock(&m_mutex);
     m_amShuttingDown = true;
-    if (m_nvvsPID >= 0)
+    for (auto const &[ticket, run] : m_activeRuns)
     {
-        DCGM_LOG_DEBUG << "Cleaning up leftover nvvs process with pid " << m_nvvsPID;
-        KillActiveNvvs((unsigned int)-1); // don't stop until it's dead
+        if (run.pid >= 0)
+        {
+            DCGM_LOG_DEBUG << "Cleaning up leftover nvvs process with pid " << run.pid;
+            KillActiveNvvs(run.pid, (unsigned int)-1); // don't stop until it's dead
+        }
     }
 }
 
-dcgmReturn_t DcgmDiagManager::KillActiveNvvs(unsigned int maxRetries)
+dcgmReturn_t DcgmDiagManager::KillActiveNvvs(pid_t pid, unsigned int maxRetries)
 {
     static const unsigned int MAX_SIGTERM_ATTEMPTS = 3;
 
     unsigned int kill_count = 0;
     bool sigkilled          = false;
 
-    while (kill(m_nvvsPID, 0) == 0 && kill_count <= maxRetries)
+    while (kill(pid, 0) == 0 && kill_count <= maxRetries)
     {
         // As long as the process exists, keep killing it
         if (kill_count < MAX_SIGTERM_ATTEMPTS)
         {
-            kill(m_nvvsPID, SIGTERM);
+            kill(pid, SIGTERM);
         }
         else
         {
             if (sigkilled == false)
             {
                 DCGM_LOG_ERROR << "Unable to kill nvvs with 3 SIGTERM attempts, escalating to SIGKILL. pid: "
-                               << m_nvvsPID;
+                               << pid;
             }
 
-            kill(m_nvvsPID, SIGKILL);
+            kill(pid, SIGKILL);
             sigkilled = true;
         }
         kill_count++;
@@ -83,7 +90,7 @@ dcgmReturn_t DcgmDiagManager::KillActiveNvvs(unsigned int maxRetries)
 
     if (kill_count > maxRetries)
     {
-        DCGM_LOG_ERROR << "Giving up attempting to kill NVVS process " << m_nvvsPID << " after " << maxRetries
+        DCGM_LOG_ERROR << "Giving up attempting to kill NVVS process " << pid << " after " << maxRetries
                        << " retries.";
         return DCGM_ST_CHILD_NOT_KILLED;
     }
@@ -396,9 +403,17 @@ void DcgmDiagManager::AddMiscellaneousNvvsOptions(std::vector<std::string> &cmdA
         cmdArgs.push_back(std::string(drd->throttleMask));
     }
 
-    if (drd->flags & DCGM_RUN_FLAGS_FAIL_EARLY)
+    if (drd->flags & DCGM_RUN_FLAGS_FAIL_FAST)
+    {
+        cmdArgs.push_back("--fail-fast");
+    }
+
+    if (drd->flags & (DCGM_RUN_FLAGS_FAIL_EARLY | DCGM_RUN_FLAGS_FAIL_FAST))
     {
-        cmdArgs.push_back("--fail-early");
+        if (drd->flags & DCGM_RUN_FLAGS_FAIL_EARLY)
+        {
+            cmdArgs.push_back("--fail-early");
+        }
         if (drd->failCheckInterval)
         {
             cmdArgs.push_back("--check-interval");
@@ -450,7 +465,10 @@ dcgmReturn_t DcgmDiagManager::CreateNvvsCommand(std::vector<std::string> &cmdArg
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmDiagManager::PerformNVVSExecute(std::string *out, dcgmRunDiag_t *drd, std::string gpuIds)
+dcgmReturn_t DcgmDiagManager::PerformNVVSExecute(std::string *out,
+                                                 dcgmRunDiag_t *drd,
+                                                 std::string gpuIds,
+                                                 DcgmNvvsOutputCallback const &onOutput)
 {
     std::vector<std::string> temp;
     dcgmReturn_t ret = DCGM_ST_OK;
@@ -459,7 +477,14 @@ dcgmReturn_t DcgmDiagManager::PerformNVVSExecute(std::string *out, dcgmRunDiag_t
     if (ret != DCGM_ST_OK)
         return ret;
 
-    ret = PerformExternalCommand(temp, out);
+    if (m_useWorker)
+    {
+        ret = PerformWorkerCommand(temp, out, onOutput, ParseGpuIdSet(gpuIds));
+    }
+    else
+    {
+        ret = PerformExternalCommand(temp, out, onOutput, ParseGpuIdSet(gpuIds));
+    }
     if (ret != DCGM_ST_OK)
         return ret;
 #if 0
@@ -485,7 +510,14 @@ dcgmReturn_t DcgmDiagManager::PerformNVVSExecute(std::string *out, dcgmPolicyVal
         return ret;
     }
 
-    ret = PerformExternalCommand(temp, out);
+    if (m_useWorker)
+    {
+        ret = PerformWorkerCommand(temp, out, nullptr, ParseGpuIdSet(gpuIds));
+    }
+    else
+    {
+        ret = PerformExternalCommand(temp, out, nullptr, ParseGpuIdSet(gpuIds));
+    }
     if (ret != DCGM_ST_OK)
         return ret;
 #if 0
@@ -504,32 +536,148 @@ dcgmReturn_t DcgmDiagManager::PerformDummyTestExecute(std::string *out)
 }
 
 /****************************************************************************/
-uint64_t DcgmDiagManager::GetTicket()
+std::set<unsigned int> DcgmDiagManager::ParseGpuIdSet(std::string const &gpuIds)
 {
-    // It is assumed that the calling thread has locked m_mutex so we can safely modify shared variables
+    std::set<unsigned int> gpuIdSet;
+    std::vector<std::string> gpuIdStrs;
+    dcgmTokenizeString(gpuIds, ",", gpuIdStrs);
+
+    for (auto const &gpuIdStr : gpuIdStrs)
+    {
+        gpuIdSet.insert(strtoul(gpuIdStr.c_str(), nullptr, 10));
+    }
+
+    return gpuIdSet;
+}
+
+/****************************************************************************/
+dcgmReturn_t DcgmDiagManager::AdmitRun(std::set<unsigned int> const &gpuIdSet, uint64_t &ticket)
+{
+    DcgmLockGuard lock(&m_mutex);
+    if (m_amShuttingDown)
+    {
+        DCGM_LOG_WARNING << "Not running diag due to DCGM shutting down.";
+        return DCGM_ST_DIAG_ALREADY_RUNNING; /* Not perfect but seems to be the most sane return that already exists */
+    }
+
+    for (auto const &[otherTicket, run] : m_activeRuns)
+    {
+        bool overlaps = gpuIdSet.empty() || run.gpuIdSet.empty();
+        for (auto it = gpuIdSet.begin(); !overlaps && it != gpuIdSet.end(); ++it)
+        {
+            overlaps = run.gpuIdSet.count(*it) > 0;
+        }
+
+        if (overlaps)
+        {
+            // nvvs instance already running on one of the GPUs - do not launch a new one
+            DCGM_LOG_WARNING << "Previous instance of nvvs is still running on the requested GPUs. PID: " << run.pid;
+            return DCGM_ST_DIAG_ALREADY_RUNNING;
+        }
+    }
+
     m_ticket += 1;
-    return m_ticket;
+    ticket = m_ticket;
+    m_activeRuns[ticket].gpuIdSet = gpuIdSet;
+    return DCGM_ST_OK;
+}
+
+/****************************************************************************/
+void DcgmDiagManager::RetireRun(uint64_t ticket)
+{
+    DcgmLockGuard lock(&m_mutex);
+    m_activeRuns.erase(ticket);
 }
 
 /****************************************************************************/
 void DcgmDiagManager::UpdateChildPID(pid_t value, uint64_t myTicket)
 {
     DcgmLockGuard lock(&m_mutex);
-    // Check to see if another thread has updated the pid
-    if (myTicket != m_ticket)
+    auto it = m_activeRuns.find(myTicket);
+    if (it != m_activeRuns.end())
     {
-        // If another thread has updated the PID, do not update the pid
-        return;
+        it->second.pid = value;
+    }
+}
+
+/****************************************************************************/
+dcgmReturn_t DcgmDiagManager::PauseResumeProfiling(std::vector<unsigned int> const &gpuIds, bool pause)
+{
+    bool isWatched = false;
+    for (unsigned short fieldId = DCGM_FI_PROF_GR_ENGINE_ACTIVE; fieldId <= DCGM_FI_PROF_NVLINK_RX_BYTES && !isWatched;
+         fieldId++)
+    {
+        m_coreProxy.IsGpuFieldWatchedOnAnyGpu(fieldId, &isWatched);
+    }
+
+    DcgmLockGuard lock(&m_mutex);
+    if (!isWatched && m_profilingPauses.empty())
+    {
+        return DCGM_ST_NOT_WATCHED;
+    }
+
+    dcgm_profiling_msg_pause_resume_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.header.length     = sizeof(msg);
+    msg.header.moduleId   = DcgmModuleIdProfiling;
+    msg.header.subCommand = DCGM_PROFILING_SR_PAUSE_RESUME;
+    msg.header.version    = dcgm_profiling_msg_pause_resume_version;
+    msg.pause             = pause;
+
+    /* Only the first run to pause a GPU and the last one to resume it tell the profiling module */
+    std::set<unsigned int> gpuIdSet(gpuIds.begin(), gpuIds.end());
+    for (unsigned int gpuId : gpuIdSet)
+    {
+        unsigned int &pauses = m_profilingPauses[gpuId];
+        if (((pause && pauses++ == 0) || (!pause && pauses > 0 && --pauses == 0))
+            && msg.numGpuIds < DCGM_MAX_NUM_DEVICES)
+        {
+            msg.gpuIds[msg.numGpuIds++] = gpuId;
+        }
+
+        if (pauses == 0)
+        {
+            m_profilingPauses.erase(gpuId);
+        }
     }
-    m_nvvsPID = value;
+
+    if (msg.numGpuIds == 0)
+    {
+        return DCGM_ST_OK;
+    }
+
+    dcgmReturn_t dcgmReturn = m_coreProxy.SendModuleCommand(&msg);
+    if (dcgmReturn != DCGM_ST_OK)
+    {
+        DCGM_LOG_WARNING << "Got " << errorString(dcgmReturn) << " from " << (pause ? "pausing" : "resuming")
+                         << " profiling of " << msg.numGpuIds << " GPUs";
+        if (pause)
+        {
+            /* The caller won't resume what didn't pause */
+            for (unsigned int gpuId : gpuIdSet)
+            {
+                if (--m_profilingPauses[gpuId] == 0)
+                {
+                    m_profilingPauses.erase(gpuId);
+                }
+            }
+        }
+        return dcgmReturn;
+    }
+
+    DCGM_LOG_DEBUG << (pause ? "Paused" : "Resumed") << " profiling of " << msg.numGpuIds << " GPUs";
+    return DCGM_ST_OK;
 }
 
 /****************************************************************************/
-dcgmReturn_t DcgmDiagManager::PerformExternalCommand(std::vector<std::string> &args, std::string *output)
+dcgmReturn_t DcgmDiagManager::PerformExternalCommand(std::vector<std::string> &args,
+                                                     std::string *output,
+                                                     DcgmNvvsOutputCallback const &onOutput,
+                                                     std::set<unsigned int> const &gpuIdSet)
 {
     char buff[512];
     std::string filename;
-    std::stringstream outputStream;
+    std::string outputSoFar;
     struct stat fileStat = {};
     int statSt;
     int childStatus;
@@ -561,26 +709,17 @@ dcgmReturn_t DcgmDiagManager::PerformExternalCommand(std::vector<std::string> &a
         return DCGM_ST_NVVS_BINARY_NOT_FOUND;
     }
 
-    // Check for previous run of nvvs and launch new one if previous one is no longer running
+    // Check for runs of nvvs on the same GPUs and launch a new one if there are none
     {
         DcgmLockGuard lock(&m_mutex); // RAII
-        if (m_amShuttingDown)
-        {
-            DCGM_LOG_WARNING << "Not running diag due to DCGM shutting down.";
-            return DCGM_ST_DIAG_ALREADY_RUNNING; /* Not perfect but seems to be the most sane return that already exists
-                                                  */
-        }
-
-        if (m_nvvsPID > 0)
+        dcgmReturn_t ret = AdmitRun(gpuIdSet, myTicket);
+        if (ret != DCGM_ST_OK)
         {
-            // nvvs instance already running - do not launch a new one
-            PRINT_WARNING("%d", "Previous instance of nvvs is still running. PID: %d", m_nvvsPID);
-            return DCGM_ST_DIAG_ALREADY_RUNNING;
+            return ret;
         }
         // Run command
         pid = DcgmUtilForkAndExecCommand(args, NULL, &fd, NULL, true);
         // Update the nvvs pid
-        myTicket = GetTicket();
         UpdateChildPID(pid, myTicket);
     }
 
@@ -591,17 +730,20 @@ dcgmReturn_t DcgmDiagManager::PerformExternalCommand(std::vector<std::string> &a
         {
             close(fd);
         }
+        RetireRun(myTicket);
         return DCGM_ST_DIAG_BAD_LAUNCH;
     }
     /* Do not return DCGM_ST_DIAG_BAD_LAUNCH for errors after this point since the child has been launched - use
        DCGM_ST_NVVS_ERROR or DCGM_ST_GENERIC_ERROR instead */
     PRINT_DEBUG("%s %d", "Launched external command '%s' (PID: %d)", args[0].c_str(), pid);
 
-    while ((bytesRead = read(fd, buff, sizeof(buff) - 1)) > 0)
+    while ((bytesRead = read(fd, buff, sizeof(buff))) > 0)
     {
-        // Insert null after the number of bytes read to avoid emptying buffer after every read
-        buff[bytesRead] = '\0';
-        outputStream << buff;
+        outputSoFar.append(buff, bytesRead);
+        if (onOutput)
+        {
+            onOutput(outputSoFar);
+        }
     }
 
     if (close(fd))
@@ -609,12 +751,14 @@ dcgmReturn_t DcgmDiagManager::PerformExternalCommand(std::vector<std::string> &a
         errno_cached = errno;
         DCGM_LOG_ERROR << "There was an error closing the pipe to the external command '" << args[0].c_str()
                        << "' : " << strerror(errno_cached);
+        waitpid(pid, NULL, 0);
+        RetireRun(myTicket);
         return DCGM_ST_GENERIC_ERROR;
     }
 
     // Set output string in caller's context
     // Do this before the error check so that if there are errors, we have more useful error messages
-    *output = outputStream.str();
+    *output = outputSoFar;
     // Check for errors in reading output
     if (bytesRead == -1)
     {
@@ -624,7 +768,7 @@ dcgmReturn_t DcgmDiagManager::PerformExternalCommand(std::vector<std::string> &a
         kill(pid, SIGTERM);
         // Prevent zombie child
         waitpid(pid, NULL, 0);
-        UpdateChildPID(-1, myTicket);
+        RetireRun(myTicket);
         return DCGM_ST_GENERIC_ERROR;
     }
 
@@ -641,12 +785,12 @@ dcgmReturn_t DcgmDiagManager::PerformExternalCommand(std::vector<std::string> &a
         std::string test = *output;
         std::replace(test.begin(), test.end(), '\n', '\t');
         PRINT_DEBUG("%s", "External command output: %s", test.c_str());
-        UpdateChildPID(-1, myTicket);
+        RetireRun(myTicket);
         return DCGM_ST_NVVS_ERROR;
     }
 
-    // Reset pid so that future runs know that nvvs is no longer running
-    UpdateChildPID(-1, myTicket);
+    // Retire the run so that future runs on its GPUs know that nvvs is no longer running
+    RetireRun(myTicket);
 
     // Check exit status
     if (WIFEXITED(childStatus))
@@ -686,21 +830,94 @@ dcgmReturn_t DcgmDiagManager::PerformExternalCommand(std::vector<std::string> &a
     return DCGM_ST_OK;
 }
 
+/****************************************************************************/
+dcgmReturn_t DcgmDiagManager::PerformWorkerCommand(std::vector<std::string> &args,
+                                                   std::string *output,
+                                                   DcgmNvvsOutputCallback const &onOutput,
+                                                   std::set<unsigned int> const &gpuIdSet)
+{
+    struct stat fileStat = {};
+    pid_t pid;
+    uint64_t myTicket;
+    bool workerBusy;
+
+    if (stat(args[0].c_str(), &fileStat))
+    {
+        DCGM_LOG_ERROR << "stat of " << args[0] << " failed. errno " << errno;
+        return DCGM_ST_NVVS_BINARY_NOT_FOUND;
+    }
+
+    {
+        DcgmLockGuard lock(&m_mutex);
+        workerBusy = m_workerBusy;
+        if (!workerBusy)
+        {
+            dcgmReturn_t ret = AdmitRun(gpuIdSet, myTicket);
+            if (ret != DCGM_ST_OK)
+            {
+                return ret;
+            }
+
+            pid = m_worker.Start();
+            if (pid < 0)
+            {
+                RetireRun(myTicket);
+                return DCGM_ST_DIAG_BAD_LAUNCH;
+            }
+
+            /* StopRunningDiag() kills the worker like it would a one-off nvvs. The next run starts a new one */
+            m_workerBusy = true;
+            UpdateChildPID(pid, myTicket);
+        }
+    }
+
+    if (workerBusy)
+    {
+        /* Runs on other GPUs don't wait for the worker to be free */
+        DCGM_LOG_DEBUG << "The nvvs worker is busy with another run. Running a separate nvvs instead";
+        return PerformExternalCommand(args, output, onOutput, gpuIdSet);
+    }
+
+    std::vector<std::string> workerArgs(args.begin() + 1, args.end());
+    dcgmReturn_t ret = m_worker.Run(workerArgs, *output, onOutput);
+    {
+        DcgmLockGuard lock(&m_mutex);
+        m_workerBusy = false;
+        RetireRun(myTicket);
+    }
+
+    if (ret != DCGM_ST_OK)
+    {
+        std::string test = *output;
+        std::replace(test.begin(), test.end(), '\n', '\t');
+        DCGM_LOG_DEBUG << "nvvs worker output: " << test;
+    }
+
+    return ret;
+}
+
 /****************************************************************************/
 dcgmReturn_t DcgmDiagManager::StopRunningDiag()
 {
     DcgmLockGuard lock(&m_mutex);
-    if (m_nvvsPID < 0)
+    if (m_activeRuns.empty())
     {
         PRINT_DEBUG("", "No diagnostic is running.");
         return DCGM_ST_OK;
     }
-    // Stop the running diagnostic
-    PRINT_DEBUG("%d", "Stopping diagnostic with PID: %d.", m_nvvsPID);
-    KillActiveNvvs(5);
-    /* Do not wait for child - let the thread that originally launched the diagnostic manage the child and reset pid.
-       We do not reset the PID here because it can result in multiple nvvs processes running (e.g. previous nvvs
-       process has not stopped yet, and a new one is launched because we've reset the pid).
+    // Stop the running diagnostics
+    for (auto const &[ticket, run] : m_activeRuns)
+    {
+        if (run.pid < 0)
+        {
+            continue;
+        }
+        PRINT_DEBUG("%d", "Stopping diagnostic with PID: %d.", run.pid);
+        KillActiveNvvs(run.pid, 5);
+    }
+    /* Do not wait for children - let the threads that originally launched the diagnostics manage the children and
+       retire their runs. We do not retire them here because it can result in multiple nvvs processes running on the
+       same GPUs (e.g. previous nvvs process has not stopped yet, and a new one is launched because we've retired it).
     */
     return DCGM_ST_OK;
 }
@@ -815,7 +1032,82 @@ dcgmReturn_t DcgmDiagManager::RunDiag(dcgmRunDiag_t *drd, DcgmDiagResponseWrappe
     }
     else
     {
-        ret = PerformNVVSExecute(&output, drd, indexList.str());
+        /* Results of fake GPUs and of training runs are never reused. Health is read before the tests run so that
+           anything that happens to a GPU while they run invalidates its results */
+        bool reuseResults = (drd->flags & DCGM_RUN_FLAGS_REUSE_RESULTS) && strlen(drd->fakeGpuList) == 0
+                            && (drd->flags & DCGM_RUN_FLAGS_TRAIN) == 0;
+        timelib64_t runStart = timelib_usecSince1970();
+        std::string signature;
+        std::map<unsigned int, DcgmDiagHealthSnapshot> health;
+        std::map<unsigned int, DcgmDiagCachedResult> reused;
+        std::vector<unsigned int> runGpuIds = gpuIds;
+
+        if (reuseResults)
+        {
+            signature = GetResultSignature(drd);
+            WatchHealthFields(gpuIds);
+            m_coreProxy.UpdateAllFields(1);
+
+            runGpuIds.clear();
+            for (unsigned int gpuId : gpuIds)
+            {
+                /* Without its health, the results of a GPU are neither reused nor kept */
+                DcgmDiagCachedResult result;
+                if (GetHealthSnapshot(gpuId, health[gpuId]) == false)
+                {
+                    health.erase(gpuId);
+                    runGpuIds.push_back(gpuId);
+                }
+                else if (m_resultCache.Lookup(signature, gpuId, runStart, health[gpuId], result))
+                {
+                    MarkReused(result, runStart - result.resultTime);
+                    reused[gpuId] = result;
+                }
+                else
+                {
+                    runGpuIds.push_back(gpuId);
+                }
+            }
+        }
+
+        response.InitializeResponseStruct(m_coreProxy.GetGpuCount((unsigned long long)drd->groupId));
+
+        if (reuseResults && runGpuIds.empty())
+        {
+            DCGM_LOG_DEBUG << "Reusing the diagnostic results of all " << reused.size() << " GPUs";
+            for (auto const &[gpuId, result] : reused)
+            {
+                response.SetCachedResult(gpuId, result, gpuId == reused.begin()->first);
+            }
+            response.SetGpuCount(reused.size());
+            return DCGM_ST_OK;
+        }
+
+        if (!reused.empty())
+        {
+            indexList.str("");
+            for (size_t i = 0; i < runGpuIds.size(); i++)
+            {
+                indexList << (i > 0 ? "," : "") << runGpuIds[i];
+            }
+            DCGM_LOG_DEBUG << "Reusing the diagnostic results of " << reused.size() << " GPUs and running GPUs "
+                           << indexList.str();
+        }
+
+        /* Fill in each test's results as nvvs finishes it, so they're kept even if nvvs doesn't finish */
+        DcgmDiagStreamState streamState;
+        auto onOutput = [&](std::string &soFar) { ProcessStreamedResults(soFar, streamState, response); };
+
+        /* Profiling of the GPUs under test would compete with nvvs for their counters. The other GPUs
+           keep all their telemetry. Fake GPUs have no counters */
+        bool pausedProfiling = strlen(drd->fakeGpuList) == 0 && PauseResumeProfiling(runGpuIds, true) == DCGM_ST_OK;
+
+        ret = PerformNVVSExecute(&output, drd, indexList.str(), onOutput);
+
+        if (pausedProfiling)
+        {
+            PauseResumeProfiling(runGpuIds, false);
+        }
         if (ret != DCGM_ST_OK)
         {
             // Record a system error here even though it may be overwritten with a more specific one later
@@ -836,11 +1128,156 @@ dcgmReturn_t DcgmDiagManager::RunDiag(dcgmRunDiag_t *drd, DcgmDiagResponseWrappe
         // better information than just DCGM_ST_NOT_CONFIGURED if NVVS had an error.
         ret = FillResponseStructure(output, response, (unsigned long long)drd->groupId, ret);
         PRINT_DEBUG("%d %s", "ret %d. output %s", (int)ret, output.c_str());
+
+        if (ret == DCGM_ST_DIAG_BAD_JSON && streamState.testCount > 0)
+        {
+            // nvvs didn't get to write its full results. Keep the ones it streamed
+            DCGM_LOG_WARNING << "Returning the " << streamState.testCount
+                             << " streamed test results from an nvvs run without full results";
+            response.SetGpuCount(streamState.gpuIdSet.size());
+        }
+
+        if (strlen(drd->fakeGpuList) == 0 && (drd->flags & DCGM_RUN_FLAGS_TRAIN) == 0)
+        {
+            bool complete = ret == DCGM_ST_OK && !response.HasSystemError();
+            for (unsigned int gpuId : runGpuIds)
+            {
+                DcgmDiagCachedResult result;
+                if (!complete || !response.GetCachedResult(gpuId, result))
+                {
+                    /* Only whole runs that passed can be reused */
+                    m_resultCache.Invalidate(gpuId);
+                    continue;
+                }
+
+                if (reuseResults && health.count(gpuId) > 0)
+                {
+                    result.resultTime = runStart;
+                    result.health     = health[gpuId];
+                    m_resultCache.Store(signature, gpuId, result);
+                }
+                else if (reuseResults || !DcgmDiagResultCache::IsPassing(result))
+                {
+                    m_resultCache.Invalidate(gpuId);
+                }
+            }
+
+            if (complete && !reused.empty())
+            {
+                for (auto const &[gpuId, result] : reused)
+                {
+                    response.SetCachedResult(gpuId, result, false);
+                }
+                response.SetGpuCount(response.GetGpuCount() + reused.size());
+            }
+        }
     }
 
     return ret;
 }
 
+std::string DcgmDiagManager::GetResultSignature(dcgmRunDiag_t const *drd)
+{
+    std::stringstream signature;
+
+    /* Verbose runs have more info in their results */
+    signature << "validate=" << drd->validate << "\nverbose=" << ((drd->flags & DCGM_RUN_FLAGS_VERBOSE) != 0);
+    for (unsigned int i = 0; i < DCGM_MAX_TEST_NAMES && drd->testNames[i][0] != '\0'; i++)
+    {
+        signature << "\ntest=" << drd->testNames[i];
+    }
+    for (unsigned int i = 0; i < DCGM_MAX_TEST_PARMS && drd->testParms[i][0] != '\0'; i++)
+    {
+        signature << "\nparm=" << drd->testParms[i];
+    }
+    signature << "\nthrottleMask=" << drd->throttleMask << "\npluginPath=" << drd->pluginPath
+              << "\nconfig=" << drd->configFileContents;
+
+    return signature.str();
+}
+
+void DcgmDiagManager::MarkReused(DcgmDiagCachedResult &result, timelib64_t age)
+{
+    std::stringstream note;
+    note << "Reused the result of a run " << age / 1000000 << " seconds ago.";
+
+    auto mark = [&note](dcgmDiagTestResult_v2 &test) {
+        if (test.status == DCGM_DIAG_RESULT_NOT_RUN)
+        {
+            return;
+        }
+
+        std::string info = note.str();
+        if (test.info[0] != '\0')
+        {
+            info += std::string(" ") + test.info;
+        }
+        snprintf(test.info, sizeof(test.info), "%s", info.c_str());
+    };
+
+    for (auto &test : result.perGpu.results)
+    {
+        mark(test);
+    }
+    for (auto &test : result.levelOneResults)
+    {
+        mark(test);
+    }
+}
+
+/* Fields whose change since a run means something happened to the GPU. See DcgmDiagHealthSnapshot */
+static const unsigned short resultHealthFields[]
+    = { DCGM_FI_DEV_XID_ERRORS,      DCGM_FI_DEV_ECC_DBE_VOL_TOTAL, DCGM_FI_DEV_RETIRED_DBE,
+        DCGM_FI_DEV_RETIRED_PENDING, DCGM_FI_DEV_ROW_REMAP_FAILURE };
+
+void DcgmDiagManager::WatchHealthFields(std::vector<unsigned int> const &gpuIds)
+{
+    DcgmWatcher watcher(DcgmWatcherTypeDiagResultCache);
+
+    for (unsigned int gpuId : gpuIds)
+    {
+        for (unsigned short fieldId : resultHealthFields)
+        {
+            /* Only the latest value is needed, so keep a single sample */
+            dcgmReturn_t ret = m_coreProxy.AddFieldWatch(DCGM_FE_GPU, gpuId, fieldId, 10000000, 0, 1, watcher, false);
+            if (ret != DCGM_ST_OK)
+            {
+                DCGM_LOG_WARNING << "Unable to watch field " << fieldId << " of GPU " << gpuId
+                                 << " for reusing diagnostic results: " << errorString(ret);
+            }
+        }
+    }
+}
+
+bool DcgmDiagManager::GetHealthSnapshot(unsigned int gpuId, DcgmDiagHealthSnapshot &health)
+{
+    for (unsigned short fieldId : resultHealthFields)
+    {
+        dcgmcm_sample_t sample {};
+        dcgmReturn_t ret = m_coreProxy.GetLatestSample(DCGM_FE_GPU, gpuId, fieldId, &sample, nullptr);
+        if (ret == DCGM_ST_NO_DATA)
+        {
+            /* Fields like XIDs have no value until something happens */
+            health[fieldId] = DCGM_INT64_BLANK;
+        }
+        else if (ret != DCGM_ST_OK)
+        {
+            DCGM_LOG_DEBUG << "Unable to read field " << fieldId << " of GPU " << gpuId << ": " << errorString(ret);
+            return false;
+        }
+        else if (fieldId == DCGM_FI_DEV_XID_ERRORS)
+        {
+            health[fieldId] = sample.timestamp;
+        }
+        else
+        {
+            health[fieldId] = sample.val.i64;
+        }
+    }
+
+    return true;
+}
+
 std::string DcgmDiagManager::GetCompareTestName(const std::string &testname)
 {
     std::string compareName(testname);
@@ -1172,13 +1609,7 @@ dcgmReturn_t DcgmDiagManager::FillResponseStructure(const std::string &output,
             else if (jv[NVVS_NAME][NVVS_HEADERS].empty() == false)
             {
                 // Get nvvs version
-                double nvvsVersion;
-                nvvsVersion = strtod(jv[NVVS_NAME][NVVS_VERSION_STR].asString().c_str(), NULL);
-                if (nvvsVersion < 0.1 || nvvsVersion > 10)
-                {
-                    // Default to version 1.3
-                    nvvsVersion = 1.3;
-                }
+                double nvvsVersion = GetNvvsVersion(jv[NVVS_NAME][NVVS_VERSION_STR]);
 
                 for (Json::ArrayIndex i = 0; i < jv[NVVS_NAME][NVVS_HEADERS].size(); i++)
                 {
@@ -1207,6 +1638,61 @@ dcgmReturn_t DcgmDiagManager::FillResponseStructure(const std::string &output,
     return oldRet;
 }
 
+double DcgmDiagManager::GetNvvsVersion(const Json::Value &version)
+{
+    double nvvsVersion = strtod(version.asString().c_str(), NULL);
+    if (nvvsVersion < 0.1 || nvvsVersion > 10)
+    {
+        // Default to version 1.3
+        nvvsVersion = 1.3;
+    }
+
+    return nvvsVersion;
+}
+
+void DcgmDiagManager::ProcessStreamedResults(std::string &output,
+                                             DcgmDiagStreamState &state,
+                                             DcgmDiagResponseWrapper &response)
+{
+    static const std::string prefix = NVVS_STREAM_RESULT " ";
+    size_t lineEnd;
+
+    while ((lineEnd = output.find('\n', state.scanned)) != std::string::npos)
+    {
+        if (output.compare(state.scanned, prefix.size(), prefix) != 0)
+        {
+            state.scanned = lineEnd + 1;
+            continue;
+        }
+
+        // Streamed results are taken out so the rest of the output parses as before
+        std::string record = output.substr(state.scanned + prefix.size(), lineEnd - state.scanned - prefix.size());
+        output.erase(state.scanned, lineEnd + 1 - state.scanned);
+
+        Json::Value jv;
+        Json::CharReaderBuilder rBuilder;
+        std::string jsonError;
+        std::stringstream recordStream(record);
+
+        try
+        {
+            if (!Json::parseFromStream(rBuilder, recordStream, &jv, &jsonError))
+            {
+                DCGM_LOG_ERROR << "Couldn't parse streamed result '" << record << "': " << jsonError;
+                continue;
+            }
+
+            FillTestResult(jv[NVVS_STREAM_TEST], response, state.gpuIdSet, GetNvvsVersion(jv[NVVS_VERSION_STR]));
+            state.testCount++;
+            DCGM_LOG_DEBUG << "Got streamed results for test " << jv[NVVS_STREAM_TEST][NVVS_TEST_NAME].asString();
+        }
+        catch (Json::Exception &err)
+        {
+            DCGM_LOG_ERROR << "Could not parse streamed result '" << record << "': " << err.what();
+        }
+    }
+}
+
 dcgmDiagResult_t DcgmDiagManager::StringToDiagResponse(std::string result)
 {
     if (result == "PASS")
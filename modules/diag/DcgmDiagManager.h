@@ -15,18 +15,38 @@
  */
 #pragma once
 
+#include <map>
 #include <set>
 #include <stdexcept>
 #include <vector>
 
 #include "DcgmDiagResponseWrapper.h"
+#include "DcgmDiagResultCache.h"
 #include "DcgmMutex.h"
+#include "DcgmNvvsWorker.h"
 #include "dcgm_agent.h"
 #include "dcgm_structs.h"
 #include <DcgmCoreProxy.h>
 #include <json/json.h>
 
 #define NVVS_PLUGIN_DIR "NVVS_PLUGIN_DIR"
+/* Set to 1 to run diagnostics in a long-lived nvvs worker instead of a new nvvs process each time */
+#define NVVS_USE_WORKER "NVVS_USE_WORKER"
+
+/* Results nvvs streamed while it runs. See NVVS_STREAM_RESULT */
+struct DcgmDiagStreamState
+{
+    size_t scanned         = 0; /* Output before this has no streamed results left */
+    unsigned int testCount = 0; /* Number of streamed results filled into the response */
+    std::set<unsigned int> gpuIdSet;
+};
+
+/* A diagnostic run that was admitted and hasn't finished yet */
+struct DcgmDiagRun
+{
+    pid_t pid = -1;                  /* nvvs or the nvvs worker running it. -1 until it's launched */
+    std::set<unsigned int> gpuIdSet; /* GPUs it runs on. Empty = all of them */
+};
 
 class DcgmDiagManager
 {
@@ -84,7 +104,10 @@ public:
      * Currently output is stored in a local variable and JSON output is not collected but
      * place holders are there for when these pieces should be inserted
      */
-    dcgmReturn_t PerformNVVSExecute(std::string *out, dcgmRunDiag_t *drd, std::string gpuIds = "");
+    dcgmReturn_t PerformNVVSExecute(std::string *out,
+                                    dcgmRunDiag_t *drd,
+                                    std::string gpuIds                     = "",
+                                    DcgmNvvsOutputCallback const &onOutput = nullptr);
     dcgmReturn_t PerformNVVSExecute(std::string *out, dcgmPolicyValidation_t validation, std::string gpuIds = "");
 
     /* Should not be made public... for testing purposes only */
@@ -127,17 +150,73 @@ public:
                         std::set<unsigned int> &gpuIdSet,
                         double nvvsVersion);
 
-    /* perform external command - switched to public for testing*/
-    dcgmReturn_t PerformExternalCommand(std::vector<std::string> &args, std::string *output);
+    /*
+     * Take the complete NVVS_STREAM_RESULT lines out of output and fill their results into response,
+     * so that what finished is known before nvvs exits - made public for unit testing
+     *
+     * @param output   - the nvvs output read so far
+     * @param state    - where the previous call on this output left off
+     * @param response - the response structure we are filling in. It must already be initialized
+     */
+    void ProcessStreamedResults(std::string &output, DcgmDiagStreamState &state, DcgmDiagResponseWrapper &response);
+
+    /* perform external command on the GPUs in gpuIdSet (empty = all) - switched to public for testing*/
+    dcgmReturn_t PerformExternalCommand(std::vector<std::string> &args,
+                                        std::string *output,
+                                        DcgmNvvsOutputCallback const &onOutput = nullptr,
+                                        std::set<unsigned int> const &gpuIdSet = {});
+
+    /*
+     * Run the nvvs command given by args in the nvvs worker, starting the worker if needed. If the
+     * worker is busy with another run, a separate nvvs is run instead.
+     * Returns the same as PerformExternalCommand
+     */
+    dcgmReturn_t PerformWorkerCommand(std::vector<std::string> &args,
+                                      std::string *output,
+                                      DcgmNvvsOutputCallback const &onOutput = nullptr,
+                                      std::set<unsigned int> const &gpuIdSet = {});
+
+    /*
+     * Admit a diagnostic run on the GPUs in gpuIdSet. An empty gpuIdSet stands for all GPUs. Runs on
+     * disjoint sets of GPUs can be active at the same time. Every admitted run must be retired with
+     * RetireRun() - made public for unit testing
+     *
+     * @param gpuIdSet - the GPUs the run will use
+     * @param ticket   - set to the ticket identifying the run on success
+     * @return DCGM_ST_OK if the run was admitted
+     *         DCGM_ST_DIAG_ALREADY_RUNNING if an active run uses one of the GPUs or DCGM is shutting down
+     */
+    dcgmReturn_t AdmitRun(std::set<unsigned int> const &gpuIdSet, uint64_t &ticket);
+
+    /* Forget the run identified by ticket once its nvvs is done */
+    void RetireRun(uint64_t ticket);
+
+    /* Parse a csv list of GPU ids like "0,1,2" */
+    static std::set<unsigned int> ParseGpuIdSet(std::string const &gpuIds);
+
+    /*
+     * The signature of the results of a run: its tests and everything that changes how they run, but not its GPUs.
+     * Results are only reused for runs of the same signature - made public for unit testing
+     */
+    static std::string GetResultSignature(dcgmRunDiag_t const *drd);
+
+    /* Note in the info of each result that it was reused from a run age microseconds ago */
+    static void MarkReused(DcgmDiagCachedResult &result, timelib64_t age);
 
 private:
     /* variables */
     const std::string m_nvvsPath;
+    const bool m_useWorker;  /* Run nvvs commands in m_worker. See NVVS_USE_WORKER */
+    DcgmNvvsWorker m_worker; /* Only used by the thread that set m_workerBusy */
+
+    /* Variables for ensuring that no two instances of nvvs run on the same GPU */
+    DcgmMutex m_mutex;                            // mutex for m_activeRuns, m_ticket and m_workerBusy
+    std::map<uint64_t, DcgmDiagRun> m_activeRuns; // ticket -> run. Use AdmitRun, UpdateChildPID and RetireRun
+    uint64_t m_ticket;                            // Ticket of the latest admitted run
+    bool m_workerBusy;                            // Whether a run is using m_worker
 
-    /* Variables for ensuring only one instance of nvvs is running at a time */
-    DcgmMutex m_mutex; // mutex for m_nvvsPid and m_ticket
-    pid_t m_nvvsPID;   // Do not directly modify this variable. Use UpdateChildPID instead.
-    uint64_t m_ticket; // Ticket used to prevent invalid updates to pid of child process.
+    // gpuId -> number of runs that need its profiling paused. Guarded by m_mutex
+    std::map<unsigned int, unsigned int> m_profilingPauses;
 
     /* pointers to libdcgm callback functions */
     DcgmCoreProxy m_coreProxy;
@@ -145,8 +224,16 @@ private:
     bool m_amShuttingDown; /* Is the diag manager in the process of shutting down?. This
                               is guarded by m_mutex and only set by ~DcgmDiagManager() */
 
+    DcgmDiagResultCache m_resultCache; /* Passing results of GPUs. See DCGM_RUN_FLAGS_REUSE_RESULTS */
+
     /* methods */
 
+    /* Watch the health fields of the GPUs that invalidate their reusable results. See DcgmDiagHealthSnapshot */
+    void WatchHealthFields(std::vector<unsigned int> const &gpuIds);
+
+    /* Read the health fields of a GPU. Returns false if one of them couldn't be read */
+    bool GetHealthSnapshot(unsigned int gpuId, DcgmDiagHealthSnapshot &health);
+
     /* convert a string to a dcgmDiagResponse_t */
     dcgmDiagResult_t StringToDiagResponse(std::string);
 
@@ -154,24 +241,30 @@ private:
 
     unsigned int GetTestIndex(const std::string &testName);
 
+    /* Get the nvvs version from the version string in its json, defaulting to 1.3 if it can't be read */
+    static double GetNvvsVersion(const Json::Value &version);
+
     /* Converts the given JSON array to a CSV string using the values in the array */
     static std::string JsonStringArrayToCsvString(Json::Value &array,
                                                   unsigned int testIndex,
                                                   const std::string &gpuMsg);
 
     /*
-     * Get a ticket for updating the PID of nvvs child. The ticket helps ensure that updates to the child PID are valid.
-     *
-     * Caller MUST ensure that m_mutex is locked by the calling thread before calling this method.
+     * Updates the PID of the nvvs child of the run identified by myTicket.
      */
-    uint64_t GetTicket();
+    void UpdateChildPID(pid_t value, uint64_t myTicket);
 
     /*
-     * Updates the PID of the nvvs child.
-     * myTicket is used to ensure that the current thread is allowed to update the pid. (e.g. ensure another thread
-     * has not modified the PID since the calling thread last updated it.)
+     * Pause or resume the profiling module's sampling of just the GPUs in gpuIds, since its counters
+     * conflict with the tests. Pauses are counted per GPU. Profiling of all other GPUs and all other
+     * telemetry keeps going. Nothing is sent when no profiling fields are watched, so that the
+     * profiling module isn't loaded only to be paused.
+     *
+     * @return DCGM_ST_OK if the profiling of the GPUs was paused or resumed
+     *         DCGM_ST_NOT_WATCHED if no profiling fields are watched
+     *         the error from the profiling module otherwise
      */
-    void UpdateChildPID(pid_t value, uint64_t myTicket);
+    dcgmReturn_t PauseResumeProfiling(std::vector<unsigned int> const &gpuIds, bool pause);
 
     /*
      * Adds the training related options to the command argument array for NVVS based on the contents of the
@@ -206,11 +299,12 @@ private:
     /*
      * Kill an active NVVS process within the specified number of retries.
      *
+     * @param pid[in] - the NVVS process to kill
      * @param maxRetires[in] - number of times to retry killing NVVS. NOTE: must be at least 3 to send a SIGKILL
      * @return DCGM_ST_OK if the process was killed
      *         DCGM_ST_NOT_KILLED if the process wouldn't die
      */
-    dcgmReturn_t KillActiveNvvs(unsigned int maxRetries);
+    dcgmReturn_t KillActiveNvvs(pid_t pid, unsigned int maxRetries);
 
     std::string GetCompareTestName(const std::string &testname);
 
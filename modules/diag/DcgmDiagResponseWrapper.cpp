@@ -352,3 +352,63 @@ dcgmReturn_t DcgmDiagResponseWrapper::RecordTrainingMessage(const std::string &t
 
     return DCGM_ST_OK;
 }
+
+/*****************************************************************************/
+bool DcgmDiagResponseWrapper::GetCachedResult(unsigned int gpuId, DcgmDiagCachedResult &result) const
+{
+    if (m_version != dcgmDiagResponse_version6 || gpuId >= DCGM_MAX_NUM_DEVICES)
+    {
+        return false;
+    }
+
+    result.perGpu = m_response.v6ptr->perGpuResponses[gpuId];
+    for (unsigned int i = 0; i < DCGM_SWTEST_COUNT; i++)
+    {
+        result.levelOneResults[i] = m_response.v6ptr->levelOneResults[i];
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+void DcgmDiagResponseWrapper::SetCachedResult(unsigned int gpuId, DcgmDiagCachedResult const &result, bool levelOne)
+{
+    if (m_version != dcgmDiagResponse_version6 || gpuId >= DCGM_MAX_NUM_DEVICES)
+    {
+        DCGM_LOG_ERROR << "Can't set the reused results of GPU " << gpuId << " in version " << m_version;
+        return;
+    }
+
+    m_response.v6ptr->perGpuResponses[gpuId]       = result.perGpu;
+    m_response.v6ptr->perGpuResponses[gpuId].gpuId = gpuId;
+
+    if (levelOne)
+    {
+        for (unsigned int i = 0; i < DCGM_SWTEST_COUNT; i++)
+        {
+            m_response.v6ptr->levelOneResults[i] = result.levelOneResults[i];
+        }
+    }
+}
+
+/*****************************************************************************/
+bool DcgmDiagResponseWrapper::HasSystemError() const
+{
+    if (m_version == dcgmDiagResponse_version6)
+    {
+        return m_response.v6ptr->systemError.msg[0] != '\0';
+    }
+
+    return false;
+}
+
+/*****************************************************************************/
+unsigned int DcgmDiagResponseWrapper::GetGpuCount() const
+{
+    if (m_version == dcgmDiagResponse_version6)
+    {
+        return m_response.v6ptr->gpuCount;
+    }
+
+    return 0;
+}
@@ -18,6 +18,7 @@
 
 #include <string>
 
+#include "DcgmDiagResultCache.h"
 #include "dcgm_structs.h"
 #include "json/json.h"
 
@@ -84,6 +85,20 @@ public:
     /*****************************************************************************/
     bool IsValidGpuIndex(unsigned int gpuIndex);
 
+    /*****************************************************************************/
+    /* Copy the results of gpuId and of the software tests for the cache of reusable results */
+    bool GetCachedResult(unsigned int gpuId, DcgmDiagCachedResult &result) const;
+
+    /*****************************************************************************/
+    /* Put reused results of gpuId in the response, along with its software tests if levelOne is set */
+    void SetCachedResult(unsigned int gpuId, DcgmDiagCachedResult const &result, bool levelOne);
+
+    /*****************************************************************************/
+    bool HasSystemError() const;
+
+    /*****************************************************************************/
+    unsigned int GetGpuCount() const;
+
 private:
     union
     {
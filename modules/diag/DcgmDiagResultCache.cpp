@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmDiagResultCache.h"
+#include "DcgmLogging.h"
+
+/*****************************************************************************/
+DcgmDiagResultCache::DcgmDiagResultCache(timelib64_t validityUsec)
+    : m_validityUsec(validityUsec)
+{}
+
+/*****************************************************************************/
+bool DcgmDiagResultCache::IsPassing(DcgmDiagCachedResult const &result)
+{
+    bool ranAny = false;
+
+    for (unsigned int i = 0; i < DCGM_PER_GPU_TEST_COUNT; i++)
+    {
+        switch (result.perGpu.results[i].status)
+        {
+            case DCGM_DIAG_RESULT_PASS:
+                ranAny = true;
+                break;
+            case DCGM_DIAG_RESULT_SKIP:
+            case DCGM_DIAG_RESULT_NOT_RUN:
+                break;
+            default:
+                return false;
+        }
+    }
+
+    for (unsigned int i = 0; i < DCGM_SWTEST_COUNT; i++)
+    {
+        if (result.levelOneResults[i].status == DCGM_DIAG_RESULT_FAIL
+            || result.levelOneResults[i].status == DCGM_DIAG_RESULT_WARN)
+        {
+            return false;
+        }
+
+        ranAny = ranAny || result.levelOneResults[i].status == DCGM_DIAG_RESULT_PASS;
+    }
+
+    return ranAny;
+}
+
+/*****************************************************************************/
+void DcgmDiagResultCache::Store(std::string const &signature, unsigned int gpuId, DcgmDiagCachedResult const &result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!IsPassing(result))
+    {
+        DCGM_LOG_DEBUG << "Forgetting the diagnostic results of GPU " << gpuId << " after a run that didn't pass";
+        m_results.erase(gpuId);
+        return;
+    }
+
+    m_results[gpuId][signature] = result;
+}
+
+/*****************************************************************************/
+bool DcgmDiagResultCache::Lookup(std::string const &signature,
+                                 unsigned int gpuId,
+                                 timelib64_t now,
+                                 DcgmDiagHealthSnapshot const &health,
+                                 DcgmDiagCachedResult &result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto gpuIt = m_results.find(gpuId);
+    if (gpuIt == m_results.end())
+    {
+        return false;
+    }
+
+    auto it = gpuIt->second.find(signature);
+    if (it == gpuIt->second.end())
+    {
+        return false;
+    }
+
+    if (now - it->second.resultTime > m_validityUsec)
+    {
+        DCGM_LOG_DEBUG << "The diagnostic results of GPU " << gpuId << " are too old to be reused";
+        gpuIt->second.erase(it);
+        return false;
+    }
+
+    if (it->second.health != health)
+    {
+        /* Whatever happened to the GPU applies to the results of all of its runs */
+        DCGM_LOG_DEBUG << "Forgetting the diagnostic results of GPU " << gpuId << " since its health changed";
+        m_results.erase(gpuIt);
+        return false;
+    }
+
+    result = it->second;
+    return true;
+}
+
+/*****************************************************************************/
+void DcgmDiagResultCache::Invalidate(unsigned int gpuId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_results.erase(gpuId);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "dcgm_structs.h"
+#include "timelib.h"
+
+/* How long the passing results of a GPU can be reused. See DCGM_RUN_FLAGS_REUSE_RESULTS */
+#define DCGM_DIAG_RESULT_REUSE_USEC (10LL * 60 * 1000000)
+
+/*
+ * Values of the health fields of a GPU, keyed by field id, when its results were produced. Any change means something
+ * happened to the GPU since then, like an XID or an ECC error, and its results can't be reused. XIDs are recorded by
+ * the timestamp of the latest one since their value alone doesn't tell a new XID from an old one.
+ */
+typedef std::map<unsigned short, long long> DcgmDiagHealthSnapshot;
+
+/* The results of one GPU from a diagnostic run */
+struct DcgmDiagCachedResult
+{
+    timelib64_t resultTime = 0; /* When the run started */
+    DcgmDiagHealthSnapshot health;
+    dcgmDiagResponsePerGpu_v2 perGpu {};
+    dcgmDiagTestResult_v2 levelOneResults[DCGM_SWTEST_COUNT] {}; /* The software tests of the same run */
+};
+
+/*
+ * Passing diagnostic results of each GPU that later runs of the same tests can return instead of running the tests
+ * again. Results are keyed by the GPU and by the signature of the run, meaning its tests and everything that changes
+ * how they run. See DcgmDiagManager::GetResultSignature().
+ *
+ * Results are reused only while they are younger than the validity window and the health of the GPU hasn't changed.
+ * Any run that doesn't pass on a GPU forgets the results of that GPU.
+ */
+class DcgmDiagResultCache
+{
+public:
+    explicit DcgmDiagResultCache(timelib64_t validityUsec = DCGM_DIAG_RESULT_REUSE_USEC);
+
+    /*
+     * Keep the results of a run on a GPU. Only passing results are kept. Results that didn't pass forget all of
+     * the results of the GPU instead
+     */
+    void Store(std::string const &signature, unsigned int gpuId, DcgmDiagCachedResult const &result);
+
+    /*
+     * Get the results of a GPU for signature if they can still be reused as of now given the current health of the
+     * GPU. Results that can't be reused anymore are forgotten
+     *
+     * Returns true if result was filled in
+     */
+    bool Lookup(std::string const &signature,
+                unsigned int gpuId,
+                timelib64_t now,
+                DcgmDiagHealthSnapshot const &health,
+                DcgmDiagCachedResult &result);
+
+    /* Forget all of the results of a GPU */
+    void Invalidate(unsigned int gpuId);
+
+    /*
+     * Returns true if the results of a GPU passed: each test that ran passed or was skipped, at least one test ran,
+     * and the software tests didn't fail or warn
+     */
+    static bool IsPassing(DcgmDiagCachedResult const &result);
+
+private:
+    timelib64_t m_validityUsec;
+    std::mutex m_mutex; /* Protects m_results since runs on different GPUs can finish concurrently */
+    std::map<unsigned int, std::map<std::string, DcgmDiagCachedResult>> m_results; /* GPU id -> signature -> results */
+};
@@ -27,6 +27,10 @@ DcgmModuleDiag::DcgmModuleDiag(dcgmCoreCallbacks_t &dcc)
     : DcgmModuleWithCoreProxy(dcc)
 {
     mpDiagManager = std::make_unique<DcgmDiagManager>(dcc);
+
+    /* A run can take many minutes. Stopping it can't wait behind it, and neither can runs on other GPUs.
+       Runs on disjoint GPUs number at most one per GPU. DcgmDiagManager turns away overlapping ones */
+    ProcessClientCommandsOnOwnThread(1ULL << DCGM_DIAG_SR_STOP, DCGM_MAX_NUM_DEVICES);
 }
 
 /*****************************************************************************/
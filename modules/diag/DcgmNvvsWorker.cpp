@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmNvvsWorker.h"
+#include "DcgmLogging.h"
+#include "DcgmUtilities.h"
+#include "NvvsJsonStrings.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <json/json.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+/*****************************************************************************/
+DcgmNvvsWorker::DcgmNvvsWorker(std::string nvvsPath)
+    : m_nvvsPath(std::move(nvvsPath))
+    , m_pid(-1)
+    , m_toWorker(-1)
+    , m_fromWorker(-1)
+{}
+
+/*****************************************************************************/
+DcgmNvvsWorker::~DcgmNvvsWorker()
+{
+    Stop();
+}
+
+/*****************************************************************************/
+pid_t DcgmNvvsWorker::Start()
+{
+    if (m_pid > 0)
+    {
+        /* It may have exited on its own since the last run, like after a SIGTERM */
+        if (waitpid(m_pid, nullptr, WNOHANG) == 0)
+        {
+            return m_pid;
+        }
+
+        DCGM_LOG_DEBUG << "nvvs worker " << m_pid << " exited since its last run";
+        m_pid = -1;
+        Reap(0);
+    }
+
+    std::vector<std::string> args { m_nvvsPath, NVVS_WORKER_ARG };
+    m_pid = DcgmUtilForkAndExecCommand(args, &m_toWorker, &m_fromWorker, nullptr, true);
+    if (m_pid < 0)
+    {
+        DCGM_LOG_ERROR << "Unable to start the nvvs worker " << m_nvvsPath;
+        m_pid = -1;
+        Reap(0);
+        return -1;
+    }
+
+    DCGM_LOG_DEBUG << "Started nvvs worker with pid " << m_pid;
+    return m_pid;
+}
+
+/*****************************************************************************/
+std::string DcgmNvvsWorker::FormatRequest(std::vector<std::string> const &args)
+{
+    Json::Value request(Json::arrayValue);
+    for (auto const &arg : args)
+    {
+        request.append(arg);
+    }
+
+    Json::StreamWriterBuilder wBuilder;
+    wBuilder["indentation"] = "";
+    return Json::writeString(wBuilder, request) + "\n";
+}
+
+/*****************************************************************************/
+bool DcgmNvvsWorker::ParseEndOfRun(std::string &output, int &returnCode)
+{
+    if (output.empty() || output.back() != '\n')
+    {
+        return false;
+    }
+
+    size_t lineStart = output.rfind('\n', output.size() - 2);
+    lineStart        = (lineStart == std::string::npos) ? 0 : lineStart + 1;
+
+    static const std::string marker = NVVS_WORKER_END_OF_RUN " ";
+    if (output.compare(lineStart, marker.size(), marker) != 0)
+    {
+        return false;
+    }
+
+    returnCode = strtol(output.c_str() + lineStart + marker.size(), nullptr, 10);
+    output.erase(lineStart);
+    return true;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmNvvsWorker::Run(std::vector<std::string> const &args,
+                                 std::string &output,
+                                 DcgmNvvsOutputCallback const &onOutput)
+{
+    std::string request = FormatRequest(args);
+    char buff[512];
+    ssize_t bytesRead;
+    int returnCode = 0;
+
+    output.clear();
+
+    if (m_pid < 0)
+    {
+        DCGM_LOG_ERROR << "The nvvs worker is not running";
+        return DCGM_ST_GENERIC_ERROR;
+    }
+
+    for (size_t written = 0; written < request.size();)
+    {
+        ssize_t ret = write(m_toWorker, request.data() + written, request.size() - written);
+        if (ret < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ret < 0)
+        {
+            DCGM_LOG_ERROR << "Couldn't send a run to the nvvs worker " << m_pid << ": " << strerror(errno);
+            Stop();
+            return DCGM_ST_GENERIC_ERROR;
+        }
+        written += ret;
+    }
+
+    while ((bytesRead = read(m_fromWorker, buff, sizeof(buff))) != 0)
+    {
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytesRead < 0)
+        {
+            DCGM_LOG_ERROR << "Error reading output of the nvvs worker " << m_pid << ": " << strerror(errno);
+            Stop();
+            return DCGM_ST_GENERIC_ERROR;
+        }
+
+        output.append(buff, bytesRead);
+        if (onOutput)
+        {
+            onOutput(output);
+        }
+        if (ParseEndOfRun(output, returnCode))
+        {
+            if (returnCode != 0)
+            {
+                DCGM_LOG_ERROR << "The nvvs worker run exited with non-zero code " << returnCode;
+                return DCGM_ST_NVVS_ERROR;
+            }
+            return DCGM_ST_OK;
+        }
+    }
+
+    /* The worker died during the run. The next run starts a new one */
+    int childStatus = 0;
+    waitpid(m_pid, &childStatus, 0);
+    if (WIFSIGNALED(childStatus))
+    {
+        DCGM_LOG_ERROR << "The nvvs worker " << m_pid << " was terminated due to signal " << WTERMSIG(childStatus);
+    }
+    else
+    {
+        DCGM_LOG_ERROR << "The nvvs worker " << m_pid << " exited during a run with code "
+                       << WEXITSTATUS(childStatus);
+    }
+    m_pid = -1;
+    Reap(0);
+    return DCGM_ST_NVVS_ERROR;
+}
+
+/*****************************************************************************/
+void DcgmNvvsWorker::Stop()
+{
+    Reap(5000);
+}
+
+/*****************************************************************************/
+void DcgmNvvsWorker::Reap(unsigned int timeoutMs)
+{
+    if (m_toWorker >= 0)
+    {
+        close(m_toWorker);
+        m_toWorker = -1;
+    }
+
+    if (m_pid > 0)
+    {
+        /* The worker exits once its stdin is closed. Keep reading so it can't block on a full pipe */
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        int flags     = fcntl(m_fromWorker, F_GETFL);
+        fcntl(m_fromWorker, F_SETFL, flags | O_NONBLOCK);
+
+        char buff[512];
+        while (waitpid(m_pid, nullptr, WNOHANG) == 0)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                DCGM_LOG_WARNING << "Killing nvvs worker " << m_pid << " which did not exit";
+                kill(m_pid, SIGKILL);
+                waitpid(m_pid, nullptr, 0);
+                break;
+            }
+
+            while (read(m_fromWorker, buff, sizeof(buff)) > 0)
+            {
+                ;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        m_pid = -1;
+    }
+
+    if (m_fromWorker >= 0)
+    {
+        close(m_fromWorker);
+        m_fromWorker = -1;
+    }
+}
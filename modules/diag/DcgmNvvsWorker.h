@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "dcgm_structs.h"
+
+#include <functional>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/* Called with all of the nvvs output read so far each time more of it is read. It may take lines out of output */
+using DcgmNvvsOutputCallback = std::function<void(std::string &output)>;
+
+/*
+ * A long-lived nvvs process that runs one diagnostic after another.
+ *
+ * Starting nvvs, loading its libraries and connecting it to the host engine is
+ * done once instead of for every diagnostic. Each run sends the nvvs command
+ * line as a JSON array on the worker's stdin and reads its output up to the
+ * NVVS_WORKER_END_OF_RUN line. If the worker dies, the run fails the way a
+ * crashed nvvs would and the next run starts a new worker.
+ *
+ * Not thread safe. DcgmDiagManager only lets one diagnostic run at a time.
+ */
+class DcgmNvvsWorker
+{
+public:
+    explicit DcgmNvvsWorker(std::string nvvsPath);
+
+    /* Stops the worker if it is running */
+    ~DcgmNvvsWorker();
+
+    /*************************************************************************/
+    /*
+     * Start the worker unless it is already running
+     *
+     * Returns: the pid of the worker
+     *          -1 if it couldn't be started
+     */
+    pid_t Start();
+
+    /*************************************************************************/
+    /*
+     * Run the diagnostic for args, the nvvs command line without the program name.
+     * Start() must have been called first. onOutput, if set, sees the output as it is read
+     *
+     * Returns: DCGM_ST_OK if the run returned 0
+     *          DCGM_ST_NVVS_ERROR if the run failed or the worker died. output has what was read
+     *          DCGM_ST_GENERIC_ERROR if the worker couldn't be talked to
+     */
+    dcgmReturn_t Run(std::vector<std::string> const &args,
+                     std::string &output,
+                     DcgmNvvsOutputCallback const &onOutput = nullptr);
+
+    /*************************************************************************/
+    /*
+     * Stop the worker. It exits once it sees the end of its stdin and is
+     * killed if it doesn't do so within a few seconds
+     */
+    void Stop();
+
+    /*************************************************************************/
+    /*
+     * Format args as a single-line request for the worker
+     */
+    static std::string FormatRequest(std::vector<std::string> const &args);
+
+    /*************************************************************************/
+    /*
+     * Look for the end of a run at the end of output. If found, it is removed
+     * from output and its return code stored in returnCode
+     *
+     * Returns: true if output ends with the end of a run
+     *          false otherwise
+     */
+    static bool ParseEndOfRun(std::string &output, int &returnCode);
+
+private:
+    std::string m_nvvsPath;
+    pid_t m_pid;      /* -1 when not running */
+    int m_toWorker;   /* Worker's stdin */
+    int m_fromWorker; /* Worker's stdout and stderr */
+
+    /* Close our ends of the pipes and wait for the worker to exit, killing it after timeoutMs */
+    void Reap(unsigned int timeoutMs);
+};
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmHealthDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*****************************************************************************/
+DcgmHealthDetector::DcgmHealthDetector(int direction, double minDeviation)
+    : m_direction(direction)
+    , m_minDeviation(minDeviation)
+    , m_samples(0)
+    , m_mean(0.0)
+    , m_variance(0.0)
+    , m_recent(0.0)
+    , m_sum(0.0)
+    , m_anomalous(false)
+{}
+
+/*****************************************************************************/
+void DcgmHealthDetector::UpdateBaseline(double value)
+{
+    if (m_samples == 0)
+    {
+        m_mean = value;
+        return;
+    }
+
+    double diff = value - m_mean;
+    m_mean += DHD_BASELINE_ALPHA * diff;
+    m_variance = (1.0 - DHD_BASELINE_ALPHA) * (m_variance + DHD_BASELINE_ALPHA * diff * diff);
+}
+
+/*****************************************************************************/
+bool DcgmHealthDetector::AddSample(double value)
+{
+    m_recent = m_samples == 0 ? value : m_recent + DHD_RECENT_ALPHA * (value - m_recent);
+
+    if (m_samples < DHD_WARMUP_SAMPLES)
+    {
+        UpdateBaseline(value);
+        m_samples++;
+        return false;
+    }
+
+    double deviation = std::max(std::sqrt(m_variance), m_minDeviation);
+    double shift     = m_direction * (value - m_mean) / deviation;
+    m_sum            = std::max(0.0, m_sum + shift - DHD_CUSUM_SLACK);
+
+    if (m_anomalous)
+    {
+        /* Capped so that however long the anomaly lasted, it clears about as fast as it was raised */
+        m_sum       = std::min(m_sum, DHD_CUSUM_THRESHOLD);
+        m_anomalous = m_sum > 0.0;
+        return false;
+    }
+
+    if (m_sum >= DHD_CUSUM_THRESHOLD)
+    {
+        m_anomalous = true;
+        return true;
+    }
+
+    UpdateBaseline(value);
+    return false;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGM_HEALTH_DETECTOR_H
+#define DCGM_HEALTH_DETECTOR_H
+
+// Samples a detector learns its baseline from before it flags anything
+#define DHD_WARMUP_SAMPLES 30
+
+// Weight of each sample in the baseline mean and variance. Small so the baseline follows hours, not minutes
+#define DHD_BASELINE_ALPHA 0.02
+
+// Weight of each sample in the recent level that an anomaly is reported with
+#define DHD_RECENT_ALPHA 0.3
+
+// Standard deviations past the baseline a sample may be without adding to the sum
+#define DHD_CUSUM_SLACK 0.5
+
+// Sum of standard deviations past the baseline that raises an anomaly
+#define DHD_CUSUM_THRESHOLD 8.0
+
+/*
+ * Streaming detector of a sustained shift of one field of one entity away from its
+ * usual level in one direction.
+ *
+ * An EWMA of the samples is the baseline, and a one-sided CUSUM of how far each sample
+ * is past it, in standard deviations of the baseline, raises the anomaly. A slow creep
+ * that no single sample would give away adds up. The state is a handful of numbers,
+ * updated in O(1) per sample.
+ *
+ * The baseline doesn't learn from samples while an anomaly is raised. The anomaly
+ * clears once the samples are back near the baseline long enough to drain the sum,
+ * which is capped at the threshold meanwhile.
+ */
+class DcgmHealthDetector
+{
+public:
+    /*
+     * direction:    1 to detect rises, -1 to detect drops
+     * minDeviation: Least standard deviation assumed, in units of the field, so that a
+     *               flat baseline doesn't turn noise into anomalies
+     */
+    DcgmHealthDetector(int direction, double minDeviation);
+
+    /* Add the next sample. Returns true if this sample raised the anomaly */
+    bool AddSample(double value);
+
+    bool IsAnomalous() const
+    {
+        return m_anomalous;
+    }
+
+    double GetBaseline() const
+    {
+        return m_mean;
+    }
+
+    /* Smoothed level of the latest samples */
+    double GetRecent() const
+    {
+        return m_recent;
+    }
+
+private:
+    int m_direction;
+    double m_minDeviation;
+    unsigned int m_samples; /* Samples seen, up to DHD_WARMUP_SAMPLES */
+    double m_mean;
+    double m_variance;
+    double m_recent;
+    double m_sum; /* CUSUM of standard deviations past the baseline, less the slack */
+    bool m_anomalous;
+
+    void UpdateBaseline(double value);
+};
+
+#endif // DCGM_HEALTH_DETECTOR_H
@@ -33,6 +33,12 @@ void DcgmHealthResponse::AddIncident(dcgmHealthSystems_t system,
     m_incidents.push_back(ii);
 }
 
+/*****************************************************************************/
+void DcgmHealthResponse::AddIncidents(DcgmHealthResponse const &other)
+{
+    m_incidents.insert(m_incidents.end(), other.m_incidents.begin(), other.m_incidents.end());
+}
+
 /*****************************************************************************/
 void DcgmHealthResponse::PopulateHealthResponse(dcgmHealthResponse_v4 &response) const
 {
@@ -34,6 +34,11 @@ public:
                      dcgm_field_entity_group_t entityGroupId,
                      dcgm_field_eid_t entityId);
 
+    /*
+     * Record the incidents of other after the incidents of this response
+     */
+    void AddIncidents(DcgmHealthResponse const &other);
+
     /*
      * Populate the health response version 4 struct based on the incidents recorded
      */
@@ -18,6 +18,10 @@
 #include "dcgm_errors.h"
 #include "dcgm_test_apis.h"
 #include "timelib.h"
+#include <algorithm>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 
@@ -42,12 +46,13 @@ const char *EntityToString(dcgm_field_entity_group_t entityGroupId)
     return "";
 }
 
-// Adds a watch for the specified field that will poll every 10 seconds for the last hour's events
+// Adds a watch for the specified field that will poll every 10 seconds for the last hour's events. Its updates
+// feed the sample windows that checks are served from
 #define ADD_WATCH(fieldId)                                                                                           \
     do                                                                                                               \
     {                                                                                                                \
         ret = mpCoreProxy.AddFieldWatch(                                                                             \
-            entityGroupId, entityId, fieldId, updateInterval, maxKeepAge, 0, watcher, false);                        \
+            entityGroupId, entityId, fieldId, updateInterval, maxKeepAge, 0, watcher, true);                         \
         if (DCGM_ST_OK != ret)                                                                                       \
         {                                                                                                            \
             std::stringstream ss;                                                                                    \
@@ -58,12 +63,50 @@ const char *EntityToString(dcgm_field_entity_group_t entityGroupId)
         }                                                                                                            \
     } while (0)
 
+/* A field whose sustained drifts the health checks report. See DcgmHealthDetector */
+typedef struct
+{
+    unsigned short fieldId;
+    dcgmHealthSystems_t system; /* Health system the anomalies are reported under */
+    int direction;              /* 1 = rises are anomalies, -1 = drops are */
+    double minDeviation;        /* Least standard deviation assumed, in units of the field */
+    bool perMinute;             /* Detect on the per minute rate of a counter rather than its value */
+    unsigned short gateFieldId; /* Only detect while this field is at least gateMin. 0 = always */
+    long long gateMin;
+    char const *description; /* What is detected, for the incident */
+} dhw_detector_config_t;
+
+static dhw_detector_config_t const c_detectorConfigs[] = {
+    { DCGM_FI_DEV_GPU_TEMP, DCGM_HEALTH_WATCH_THERMAL, 1, 2.0, false, 0, 0, "temperature (C)" },
+    /* Clocks are only comparable while the GPU is busy */
+    { DCGM_FI_DEV_SM_CLOCK, DCGM_HEALTH_WATCH_THERMAL, -1, 50.0, false, DCGM_FI_DEV_GPU_UTIL, 90, "SM clock (MHz)" },
+    { DCGM_FI_DEV_ECC_SBE_VOL_TOTAL, DCGM_HEALTH_WATCH_MEM, 1, 1.0, true, 0, 0, "single bit ECC errors per minute" },
+};
+
+static dhw_detector_config_t const *GetDetectorConfig(unsigned short fieldId)
+{
+    for (dhw_detector_config_t const &config : c_detectorConfigs)
+    {
+        if (config.fieldId == fieldId)
+        {
+            return &config;
+        }
+    }
+    return nullptr;
+}
+
 /*****************************************************************************/
 DcgmHealthWatch::DcgmHealthWatch(dcgmCoreCallbacks_t &dcc)
     : mpCoreProxy(dcc)
 {
     m_mutex = new DcgmMutex(0);
 
+    DcgmElasticWorkerPoolParams_t poolParams {};
+    poolParams.minWorkers   = 1;
+    poolParams.maxWorkers   = DHW_MAX_CHECK_WORKERS;
+    poolParams.growWaitUsec = 0;
+    m_checkPool             = std::make_unique<DcgmElasticWorkerPool>(poolParams, "dcgm_health");
+
     mGroupWatchState.clear();
 
     BuildFieldLists();
@@ -72,6 +115,8 @@ DcgmHealthWatch::DcgmHealthWatch(dcgmCoreCallbacks_t &dcc)
 /*****************************************************************************/
 DcgmHealthWatch::~DcgmHealthWatch()
 {
+    m_checkPool.reset();
+
     if (m_mutex)
     {
         delete (m_mutex);
@@ -113,7 +158,7 @@ dcgmReturn_t DcgmHealthWatch::SetNvSwitchWatches(std::vector<unsigned int> &grou
                                                        maxKeepAge,
                                                        0,
                                                        watcher,
-                                                       false);
+                                                       true);
                 if (dcgmReturn != DCGM_ST_OK)
                 {
                     PRINT_ERROR("%d", "Error %d from AddEntityFieldWatch() for NvSwitch fields", (int)dcgmReturn);
@@ -133,7 +178,7 @@ dcgmReturn_t DcgmHealthWatch::SetNvSwitchWatches(std::vector<unsigned int> &grou
                                                        maxKeepAge,
                                                        0,
                                                        watcher,
-                                                       false);
+                                                       true);
                 if (dcgmReturn != DCGM_ST_OK)
                 {
                     PRINT_ERROR("%d", "Error %d from AddEntityFieldWatch() for NvSwitch fields", (int)dcgmReturn);
@@ -352,6 +397,33 @@ dcgmReturn_t DcgmHealthWatch::MonitorWatchesForGpu(unsigned int gpuId,
     return ret;
 }
 
+/*****************************************************************************/
+dcgmReturn_t DcgmHealthWatch::MonitorWatchesForGpus(std::vector<unsigned int> const &gpuIds,
+                                                    long long startTime,
+                                                    long long endTime,
+                                                    dcgmHealthSystems_t healthSystemsMask,
+                                                    DcgmHealthResponse &response)
+{
+    std::vector<DcgmHealthResponse> gpuResponses(gpuIds.size());
+    std::vector<dcgmReturn_t> gpuRets(gpuIds.size(), DCGM_ST_OK);
+
+    RunChecks(gpuIds.size(), [&](size_t gpuIndex) {
+        gpuRets[gpuIndex]
+            = MonitorWatchesForGpu(gpuIds[gpuIndex], startTime, endTime, healthSystemsMask, gpuResponses[gpuIndex]);
+    });
+
+    for (size_t gpuIndex = 0; gpuIndex < gpuIds.size(); gpuIndex++)
+    {
+        response.AddIncidents(gpuResponses[gpuIndex]);
+        if (gpuRets[gpuIndex] != DCGM_ST_OK)
+        {
+            return gpuRets[gpuIndex];
+        }
+    }
+
+    return DCGM_ST_OK;
+}
+
 bool DcgmHealthWatch::FitsGpuHardwareCheck(dcgm_field_entity_group_t entityGroupId)
 {
     return (entityGroupId == DCGM_FE_GPU || entityGroupId == DCGM_FE_GPU_I || entityGroupId == DCGM_FE_GPU_CI);
@@ -363,7 +435,6 @@ dcgmReturn_t DcgmHealthWatch::MonitorWatches(unsigned int groupId,
                                              long long endTime,
                                              DcgmHealthResponse &response)
 {
-    unsigned int index;
     dcgmReturn_t ret = DCGM_ST_OK;
     std::vector<dcgmGroupEntityPair_t> entities;
     dcgmHealthSystems_t healthSystemsMask = (dcgmHealthSystems_t)0; /* Cached version of this group's watch mask */
@@ -398,61 +469,176 @@ dcgmReturn_t DcgmHealthWatch::MonitorWatches(unsigned int groupId,
     if (healthSystemsMask == 0)
         return DCGM_ST_OK; /* This is the same as walking over the loops below and doing nothing */
 
-    for (size_t entityIndex = 0; entityIndex < entities.size(); entityIndex++)
+    /* Each entity is checked into its own response. Merging those in order gives the same
+       incidents as checking the entities one after the other */
+    struct EntityCheck
+    {
+        DcgmHealthResponse response;
+        dcgmReturn_t ret = DCGM_ST_OK;
+        bool checked     = false;
+    };
+    std::vector<EntityCheck> checks(entities.size());
+
+    RunChecks(entities.size(), [&](size_t entityIndex) {
+        EntityCheck &check = checks[entityIndex];
+        check.ret          = MonitorEntity(entities[entityIndex].entityGroupId,
+                                  entities[entityIndex].entityId,
+                                  healthSystemsMask,
+                                  startTime,
+                                  endTime,
+                                  check.response,
+                                  check.checked);
+    });
+
+    for (auto const &check : checks)
+    {
+        response.AddIncidents(check.response);
+        if (check.checked)
+        {
+            ret = check.ret;
+        }
+    }
+
+    return ret;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHealthWatch::MonitorEntity(dcgm_field_entity_group_t entityGroupId,
+                                            dcgm_field_eid_t entityId,
+                                            dcgmHealthSystems_t healthSystemsMask,
+                                            long long startTime,
+                                            long long endTime,
+                                            DcgmHealthResponse &response,
+                                            bool &checked)
+{
+    dcgmReturn_t ret = DCGM_ST_OK;
+    bool gpuEntity   = FitsGpuHardwareCheck(entityGroupId);
+
+    checked = false;
+
+    for (unsigned int index = 0; index < DCGM_HEALTH_WATCH_COUNT_V2; index++)
     {
-        dcgm_field_entity_group_t entityGroupId = entities[entityIndex].entityGroupId;
-        dcgm_field_eid_t entityId               = entities[entityIndex].entityId;
+        unsigned int bit = 1 << index;
 
-        for (index = 0; index < DCGM_HEALTH_WATCH_COUNT_V2; index++)
+        if (!(bit & healthSystemsMask))
         {
-            unsigned int bit = 1 << index;
+            continue;
+        }
 
-            switch (bit)
-            {
-                case DCGM_HEALTH_WATCH_PCIE:
-                    if (bit & healthSystemsMask && FitsGpuHardwareCheck(entityGroupId))
-                        ret = MonitorPcie(entityGroupId, entityId, startTime, endTime, response);
-                    break;
-                case DCGM_HEALTH_WATCH_MEM:
-                    if (bit & healthSystemsMask && FitsGpuHardwareCheck(entityGroupId))
-                        ret = MonitorMem(entityGroupId, entityId, startTime, endTime, response);
-                    break;
-                case DCGM_HEALTH_WATCH_INFOROM:
-                    if (bit & healthSystemsMask && FitsGpuHardwareCheck(entityGroupId))
-                        ret = MonitorInforom(entityGroupId, entityId, startTime, endTime, response);
-                    break;
-                case DCGM_HEALTH_WATCH_THERMAL:
-                    if (bit & healthSystemsMask && FitsGpuHardwareCheck(entityGroupId))
-                        ret = MonitorThermal(entityGroupId, entityId, startTime, endTime, response);
-                    break;
-                case DCGM_HEALTH_WATCH_POWER:
-                    if (bit & healthSystemsMask && FitsGpuHardwareCheck(entityGroupId))
-                        ret = MonitorPower(entityGroupId, entityId, startTime, endTime, response);
-                    break;
-                case DCGM_HEALTH_WATCH_NVLINK:
-                    if (bit & healthSystemsMask && FitsGpuHardwareCheck(entityGroupId))
-                        ret = MonitorNVLink(entityGroupId, entityId, startTime, endTime, response);
-                    break;
-                case DCGM_HEALTH_WATCH_NVSWITCH_NONFATAL:
-                    if (bit & healthSystemsMask && entityGroupId == DCGM_FE_SWITCH)
-                        ret = MonitorNvSwitchErrorCounts(false, entityGroupId, entityId, startTime, endTime, response);
-                    break;
-                case DCGM_HEALTH_WATCH_NVSWITCH_FATAL:
-                    if (bit & healthSystemsMask && entityGroupId == DCGM_FE_SWITCH)
-                        ret = MonitorNvSwitchErrorCounts(true, entityGroupId, entityId, startTime, endTime, response);
-                    break;
-                default:
-                    // reduce the logging level as this may pollute the log file if unsupported fields are watched
-                    // continuously.
-                    PRINT_DEBUG("%u", "Unhandled health bit %u", bit);
-                    break;
-            }
+        switch (bit)
+        {
+            case DCGM_HEALTH_WATCH_PCIE:
+                if (gpuEntity)
+                {
+                    ret     = MonitorPcie(entityGroupId, entityId, startTime, endTime, response);
+                    checked = true;
+                }
+                break;
+            case DCGM_HEALTH_WATCH_MEM:
+                if (gpuEntity)
+                {
+                    ret     = MonitorMem(entityGroupId, entityId, startTime, endTime, response);
+                    checked = true;
+                }
+                break;
+            case DCGM_HEALTH_WATCH_INFOROM:
+                if (gpuEntity)
+                {
+                    ret     = MonitorInforom(entityGroupId, entityId, startTime, endTime, response);
+                    checked = true;
+                }
+                break;
+            case DCGM_HEALTH_WATCH_THERMAL:
+                if (gpuEntity)
+                {
+                    ret     = MonitorThermal(entityGroupId, entityId, startTime, endTime, response);
+                    checked = true;
+                }
+                break;
+            case DCGM_HEALTH_WATCH_POWER:
+                if (gpuEntity)
+                {
+                    ret     = MonitorPower(entityGroupId, entityId, startTime, endTime, response);
+                    checked = true;
+                }
+                break;
+            case DCGM_HEALTH_WATCH_NVLINK:
+                if (gpuEntity)
+                {
+                    ret     = MonitorNVLink(entityGroupId, entityId, startTime, endTime, response);
+                    checked = true;
+                }
+                break;
+            case DCGM_HEALTH_WATCH_NVSWITCH_NONFATAL:
+                if (entityGroupId == DCGM_FE_SWITCH)
+                {
+                    ret     = MonitorNvSwitchErrorCounts(false, entityGroupId, entityId, startTime, endTime, response);
+                    checked = true;
+                }
+                break;
+            case DCGM_HEALTH_WATCH_NVSWITCH_FATAL:
+                if (entityGroupId == DCGM_FE_SWITCH)
+                {
+                    ret     = MonitorNvSwitchErrorCounts(true, entityGroupId, entityId, startTime, endTime, response);
+                    checked = true;
+                }
+                break;
+            default:
+                // reduce the logging level as this may pollute the log file if unsupported fields are watched
+                // continuously.
+                PRINT_DEBUG("%u", "Unhandled health bit %u", bit);
+                break;
         }
     }
 
+    if (gpuEntity)
+    {
+        AddAnomalyIncidents(entityGroupId, entityId, healthSystemsMask, response);
+    }
+
     return ret;
 }
 
+/*****************************************************************************/
+void DcgmHealthWatch::RunChecks(size_t count, std::function<void(size_t)> const &check)
+{
+    std::mutex doneMutex;
+    std::condition_variable doneCond;
+    size_t remaining = count;
+
+    auto runCheck = [&](size_t index) {
+        try
+        {
+            check(index);
+        }
+        catch (std::exception const &e)
+        {
+            DCGM_LOG_ERROR << "Health check " << index << " threw " << e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (--remaining == 0)
+        {
+            doneCond.notify_one();
+        }
+    };
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    /* The calling thread takes the first check rather than only waiting */
+    for (size_t index = 1; index < count; index++)
+    {
+        m_checkPool->Enqueue([&runCheck, index] { runCheck(index); });
+    }
+    runCheck(0);
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCond.wait(lock, [&remaining] { return remaining == 0; });
+}
+
 /*****************************************************************************/
 void DcgmHealthWatch::SetResponse(dcgm_field_entity_group_t entityGroupId,
                                   dcgm_field_eid_t entityId,
@@ -502,6 +688,7 @@ dcgmReturn_t DcgmHealthWatch::SetMem(dcgm_field_entity_group_t entityGroupId,
         return ret;
 
     ADD_WATCH(DCGM_FI_DEV_ECC_DBE_VOL_TOTAL);
+    ADD_WATCH(DCGM_FI_DEV_ECC_SBE_VOL_TOTAL); /* For anomaly detection */
 
     // the sampling of 1 second is fine for the above, these however should have a longer sampling rate
     updateInterval = DCGM_MAX(30000000, updateInterval);
@@ -509,7 +696,7 @@ dcgmReturn_t DcgmHealthWatch::SetMem(dcgm_field_entity_group_t entityGroupId,
     // single and double bit retired pages
 
     ret = mpCoreProxy.AddFieldWatch(
-        entityGroupId, entityId, DCGM_FI_DEV_RETIRED_SBE, updateInterval, maxKeepAge, 0, watcher, false);
+        entityGroupId, entityId, DCGM_FI_DEV_RETIRED_SBE, updateInterval, maxKeepAge, 0, watcher, true);
     if (DCGM_ST_OK != ret)
     {
         std::stringstream ss;
@@ -520,7 +707,7 @@ dcgmReturn_t DcgmHealthWatch::SetMem(dcgm_field_entity_group_t entityGroupId,
     }
 
     ret = mpCoreProxy.AddFieldWatch(
-        entityGroupId, entityId, DCGM_FI_DEV_RETIRED_DBE, updateInterval, maxKeepAge, 0, watcher, false);
+        entityGroupId, entityId, DCGM_FI_DEV_RETIRED_DBE, updateInterval, maxKeepAge, 0, watcher, true);
     if (DCGM_ST_OK != ret)
     {
         std::stringstream ss;
@@ -531,7 +718,7 @@ dcgmReturn_t DcgmHealthWatch::SetMem(dcgm_field_entity_group_t entityGroupId,
     }
 
     ret = mpCoreProxy.AddFieldWatch(
-        entityGroupId, entityId, DCGM_FI_DEV_RETIRED_PENDING, updateInterval, maxKeepAge, 0, watcher, false);
+        entityGroupId, entityId, DCGM_FI_DEV_RETIRED_PENDING, updateInterval, maxKeepAge, 0, watcher, true);
     if (DCGM_ST_OK != ret)
     {
         std::stringstream ss;
@@ -555,7 +742,7 @@ dcgmReturn_t DcgmHealthWatch::SetMem(dcgm_field_entity_group_t entityGroupId,
     }
 
     ret = mpCoreProxy.AddFieldWatch(
-        entityGroupId, entityId, DCGM_FI_DEV_ROW_REMAP_FAILURE, updateInterval, maxKeepAge, 0, watcher, false);
+        entityGroupId, entityId, DCGM_FI_DEV_ROW_REMAP_FAILURE, updateInterval, maxKeepAge, 0, watcher, true);
     if (DCGM_ST_OK != ret)
     {
         std::stringstream ss;
@@ -587,7 +774,7 @@ dcgmReturn_t DcgmHealthWatch::SetInforom(dcgm_field_entity_group_t entityGroupId
     maxKeepAge     = DCGM_MAX(7200.0, maxKeepAge); /* Keep at least 2 hours of data so we can get a sample */
 
     ret = mpCoreProxy.AddFieldWatch(
-        entityGroupId, entityId, DCGM_FI_DEV_INFOROM_CONFIG_VALID, updateInterval, maxKeepAge, 0, watcher, false);
+        entityGroupId, entityId, DCGM_FI_DEV_INFOROM_CONFIG_VALID, updateInterval, maxKeepAge, 0, watcher, true);
     if (DCGM_ST_OK != ret)
     {
         std::stringstream ss;
@@ -620,7 +807,7 @@ dcgmReturn_t DcgmHealthWatch::SetThermal(dcgm_field_entity_group_t entityGroupId
     updateInterval = DCGM_MAX(30000000, updateInterval);
 
     ret = mpCoreProxy.AddFieldWatch(
-        entityGroupId, entityId, DCGM_FI_DEV_THERMAL_VIOLATION, updateInterval, maxKeepAge, 0, watcher, false);
+        entityGroupId, entityId, DCGM_FI_DEV_THERMAL_VIOLATION, updateInterval, maxKeepAge, 0, watcher, true);
     if (DCGM_ST_OK != ret)
     {
         std::stringstream ss;
@@ -630,6 +817,11 @@ dcgmReturn_t DcgmHealthWatch::SetThermal(dcgm_field_entity_group_t entityGroupId
         return ret;
     }
 
+    /* For anomaly detection */
+    ADD_WATCH(DCGM_FI_DEV_GPU_TEMP);
+    ADD_WATCH(DCGM_FI_DEV_SM_CLOCK);
+    ADD_WATCH(DCGM_FI_DEV_GPU_UTIL);
+
     return DCGM_ST_OK;
 }
 
@@ -652,7 +844,7 @@ dcgmReturn_t DcgmHealthWatch::SetPower(dcgm_field_entity_group_t entityGroupId,
     updateInterval = DCGM_MAX(30000000, updateInterval);
 
     ret = mpCoreProxy.AddFieldWatch(
-        entityGroupId, entityId, DCGM_FI_DEV_POWER_VIOLATION, updateInterval, maxKeepAge, 0, watcher, false);
+        entityGroupId, entityId, DCGM_FI_DEV_POWER_VIOLATION, updateInterval, maxKeepAge, 0, watcher, true);
     if (DCGM_ST_OK != ret)
     {
         std::stringstream ss;
@@ -663,7 +855,7 @@ dcgmReturn_t DcgmHealthWatch::SetPower(dcgm_field_entity_group_t entityGroupId,
     }
 
     ret = mpCoreProxy.AddFieldWatch(
-        entityGroupId, entityId, DCGM_FI_DEV_POWER_USAGE, updateInterval, maxKeepAge, 0, watcher, false);
+        entityGroupId, entityId, DCGM_FI_DEV_POWER_USAGE, updateInterval, maxKeepAge, 0, watcher, true);
     if (DCGM_ST_OK != ret)
     {
         std::stringstream ss;
@@ -706,12 +898,11 @@ dcgmReturn_t DcgmHealthWatch::MonitorPcie(dcgm_field_entity_group_t entityGroupI
                                           long long endTime,
                                           DcgmHealthResponse &response)
 {
-    dcgmReturn_t ret           = DCGM_ST_OK;
-    unsigned short fieldId     = DCGM_FI_DEV_PCIE_REPLAY_COUNTER;
-    dcgmcm_sample_t startValue = {};
-    dcgmcm_sample_t endValue   = {};
+    dcgmReturn_t ret       = DCGM_ST_OK;
+    unsigned short fieldId = DCGM_FI_DEV_PCIE_REPLAY_COUNTER;
+    std::vector<dcgmReturn_t> rets;
+    std::vector<dcgmcm_sample_t> samples;
 
-    int count                    = 0;
     unsigned int oneMinuteInUsec = 60000000;
     timelib64_t now              = timelib_usecSince1970();
 
@@ -722,10 +913,17 @@ dcgmReturn_t DcgmHealthWatch::MonitorPcie(dcgm_field_entity_group_t entityGroupI
         startTime = now - oneMinuteInUsec;
     }
 
-    /* Get the value of the field at the StartTime*/
-    count = 1;
-    ret   = mpCoreProxy.GetSamples(
-        entityGroupId, entityId, fieldId, &startValue, &count, startTime, endTime, DCGM_ORDER_ASCENDING);
+    /* Get the values of the field at the startTime and at the endTime together */
+    GetSamples({ { entityGroupId, entityId, fieldId, DCGM_ORDER_ASCENDING },
+                 { entityGroupId, entityId, fieldId, DCGM_ORDER_DESCENDING } },
+               startTime,
+               endTime,
+               rets,
+               samples);
+    dcgmcm_sample_t const &startValue = samples[0];
+    dcgmcm_sample_t const &endValue   = samples[1];
+
+    ret = rets[0];
 
     if (DCGM_ST_NO_DATA == ret)
     {
@@ -746,10 +944,7 @@ dcgmReturn_t DcgmHealthWatch::MonitorPcie(dcgm_field_entity_group_t entityGroupI
     if (DCGM_INT64_IS_BLANK(startValue.val.i64))
         return DCGM_ST_OK;
 
-    /* Get the value of the field at the endTime*/
-    count = 1;
-    ret   = mpCoreProxy.GetSamples(
-        entityGroupId, entityId, fieldId, &endValue, &count, startTime, endTime, DCGM_ORDER_DESCENDING);
+    ret = rets[1];
     if (DCGM_ST_NO_DATA == ret)
     {
         PRINT_DEBUG("%u", "No data for PCIe for gpuId %u", entityId);
@@ -811,17 +1006,15 @@ dcgmReturn_t DcgmHealthWatch::MonitorMemVolatileDbes(dcgm_field_entity_group_t e
     // if our stored value is greater than the returned value then someone likely
     // reset the volatile counter.  Just reset ours
     dcgmReturn_t ret;
-    int count              = 1;
     dcgmcm_sample_t sample = {};
 
-    ret = mpCoreProxy.GetSamples(entityGroupId,
-                                 entityId,
-                                 DCGM_FI_DEV_ECC_DBE_VOL_TOTAL,
-                                 &sample,
-                                 &count,
-                                 startTime,
-                                 endTime,
-                                 DCGM_ORDER_DESCENDING);
+    ret = GetSample(entityGroupId,
+                    entityId,
+                    DCGM_FI_DEV_ECC_DBE_VOL_TOTAL,
+                    startTime,
+                    endTime,
+                    DCGM_ORDER_DESCENDING,
+                    &sample);
 
     if (ret != DCGM_ST_OK && ret != DCGM_ST_NO_DATA && ret != DCGM_ST_NOT_WATCHED)
     {
@@ -855,15 +1048,13 @@ dcgmReturn_t DcgmHealthWatch::MonitorMemRetiredPending(dcgm_field_entity_group_t
                                                        DcgmHealthResponse &response)
 {
     dcgmcm_sample_t retiredPending = {};
-    int count                      = 1;
-    dcgmReturn_t ret               = mpCoreProxy.GetSamples(entityGroupId,
-                                              entityId,
-                                              DCGM_FI_DEV_RETIRED_PENDING,
-                                              &retiredPending,
-                                              &count,
-                                              startTime,
-                                              endTime,
-                                              DCGM_ORDER_DESCENDING);
+    dcgmReturn_t ret               = GetSample(entityGroupId,
+                                 entityId,
+                                 DCGM_FI_DEV_RETIRED_PENDING,
+                                 startTime,
+                                 endTime,
+                                 DCGM_ORDER_DESCENDING,
+                                 &retiredPending);
 
     if (ret != DCGM_ST_OK && ret != DCGM_ST_NO_DATA && ret != DCGM_ST_NOT_WATCHED)
     {
@@ -891,14 +1082,13 @@ dcgmReturn_t DcgmHealthWatch::MonitorMemSbeDbeRetiredPages(dcgm_field_entity_gro
     dcgmcm_sample_t sbeRetiredPage = {};
     dcgmcm_sample_t dbeRetiredPage = {};
     int count                      = 1;
-    dcgmReturn_t ret               = mpCoreProxy.GetSamples(entityGroupId,
-                                              entityId,
-                                              DCGM_FI_DEV_RETIRED_DBE,
-                                              &dbeRetiredPage,
-                                              &count,
-                                              startTime,
-                                              endTime,
-                                              DCGM_ORDER_DESCENDING);
+    dcgmReturn_t ret               = GetSample(entityGroupId,
+                                 entityId,
+                                 DCGM_FI_DEV_RETIRED_DBE,
+                                 startTime,
+                                 endTime,
+                                 DCGM_ORDER_DESCENDING,
+                                 &dbeRetiredPage);
 
     if (ret != DCGM_ST_OK && ret != DCGM_ST_NO_DATA && ret != DCGM_ST_NOT_WATCHED)
     {
@@ -906,15 +1096,13 @@ dcgmReturn_t DcgmHealthWatch::MonitorMemSbeDbeRetiredPages(dcgm_field_entity_gro
         return ret;
     }
 
-    count = 1;
-    ret   = mpCoreProxy.GetSamples(entityGroupId,
-                                 entityId,
-                                 DCGM_FI_DEV_RETIRED_SBE,
-                                 &sbeRetiredPage,
-                                 &count,
-                                 startTime,
-                                 endTime,
-                                 DCGM_ORDER_DESCENDING);
+    ret = GetSample(entityGroupId,
+                    entityId,
+                    DCGM_FI_DEV_RETIRED_SBE,
+                    startTime,
+                    endTime,
+                    DCGM_ORDER_DESCENDING,
+                    &sbeRetiredPage);
 
     if (ret != DCGM_ST_OK && ret != DCGM_ST_NO_DATA && ret != DCGM_ST_NOT_WATCHED)
     {
@@ -1003,17 +1191,15 @@ dcgmReturn_t DcgmHealthWatch::MonitorMemRowRemapFailures(dcgm_field_entity_group
     // if our stored value is greater than the returned value then someone likely
     // reset the volatile counter.  Just reset ours
     dcgmReturn_t ret;
-    int count              = 1;
     dcgmcm_sample_t sample = {};
 
-    ret = mpCoreProxy.GetSamples(entityGroupId,
-                                 entityId,
-                                 DCGM_FI_DEV_ROW_REMAP_FAILURE,
-                                 &sample,
-                                 &count,
-                                 startTime,
-                                 endTime,
-                                 DCGM_ORDER_DESCENDING);
+    ret = GetSample(entityGroupId,
+                    entityId,
+                    DCGM_FI_DEV_ROW_REMAP_FAILURE,
+                    startTime,
+                    endTime,
+                    DCGM_ORDER_DESCENDING,
+                    &sample);
 
     if (ret != DCGM_ST_OK && ret != DCGM_ST_NO_DATA && ret != DCGM_ST_NOT_WATCHED)
     {
@@ -1136,7 +1322,7 @@ dcgmReturn_t DcgmHealthWatch::MonitorInforom(dcgm_field_entity_group_t entityGro
     /* Note: Allow endTime to be in the future. 0 = blank = most recent record in time series */
 
     /* check for the fieldValue at the endTime*/
-    ret = mpCoreProxy.GetLatestSample(entityGroupId, entityId, fieldId, &sample, 0);
+    ret = GetLatestSample(entityGroupId, entityId, fieldId, &sample);
 
     if (DCGM_ST_NO_DATA == ret)
     {
@@ -1178,7 +1364,6 @@ dcgmReturn_t DcgmHealthWatch::MonitorThermal(dcgm_field_entity_group_t entityGro
     unsigned short fieldId      = DCGM_FI_DEV_THERMAL_VIOLATION;
     dcgmcm_sample_t startValue  = {};
     dcgmcm_sample_t endValue    = {};
-    int count                   = 1;
     long long int violationTime = 0;
 
     timelib64_t now              = timelib_usecSince1970();
@@ -1193,8 +1378,7 @@ dcgmReturn_t DcgmHealthWatch::MonitorThermal(dcgm_field_entity_group_t entityGro
     /* Note: Allow endTime to be in the future. 0 = blank = most recent record in time series */
 
     /* Get the value at the startTime */
-    ret = mpCoreProxy.GetSamples(
-        entityGroupId, entityId, fieldId, &startValue, &count, startTime, endTime, DCGM_ORDER_ASCENDING);
+    ret = GetSample(entityGroupId, entityId, fieldId, startTime, endTime, DCGM_ORDER_ASCENDING, &startValue);
 
     if (DCGM_ST_NO_DATA == ret)
         return DCGM_ST_OK;
@@ -1205,7 +1389,7 @@ dcgmReturn_t DcgmHealthWatch::MonitorThermal(dcgm_field_entity_group_t entityGro
 
 
     /* Get the value at the endTime*/
-    ret = mpCoreProxy.GetLatestSample(entityGroupId, entityId, fieldId, &endValue, 0);
+    ret = GetLatestSample(entityGroupId, entityId, fieldId, &endValue);
 
     if (DCGM_ST_NO_DATA == ret)
         return DCGM_ST_OK;
@@ -1241,7 +1425,6 @@ dcgmReturn_t DcgmHealthWatch::MonitorPower(dcgm_field_entity_group_t entityGroup
     dcgmcm_sample_t startValue   = {};
     dcgmcm_sample_t endValue     = {};
     unsigned int oneMinuteInUsec = 60000000;
-    int count                    = 0;
     long long int violationTime  = 0;
     dcgmcm_sample_t sample       = {};
 
@@ -1250,7 +1433,7 @@ dcgmReturn_t DcgmHealthWatch::MonitorPower(dcgm_field_entity_group_t entityGroup
     // Warn if we cannot read the power on this entity
     if (entityGroupId == DCGM_FE_GPU)
     {
-        ret = mpCoreProxy.GetLatestSample(entityGroupId, entityId, DCGM_FI_DEV_POWER_USAGE, &sample, 0);
+        ret = GetLatestSample(entityGroupId, entityId, DCGM_FI_DEV_POWER_USAGE, &sample);
         if (ret == DCGM_ST_OK && DCGM_FP64_IS_BLANK(sample.val.d) && sample.val.d != DCGM_FP64_NOT_SUPPORTED)
         {
             // We aren't successfully reading the power for this GPU, add a warning
@@ -1269,9 +1452,7 @@ dcgmReturn_t DcgmHealthWatch::MonitorPower(dcgm_field_entity_group_t entityGroup
     /* Note: Allow endTime to be in the future. 0 = blank = most recent record in time series */
 
     /* Update the value at the start time*/
-    count = 1;
-    ret   = mpCoreProxy.GetSamples(
-        entityGroupId, entityId, fieldId, &startValue, &count, startTime, endTime, DCGM_ORDER_ASCENDING);
+    ret = GetSample(entityGroupId, entityId, fieldId, startTime, endTime, DCGM_ORDER_ASCENDING, &startValue);
 
     if (DCGM_ST_NO_DATA == ret)
         return DCGM_ST_OK;
@@ -1282,9 +1463,7 @@ dcgmReturn_t DcgmHealthWatch::MonitorPower(dcgm_field_entity_group_t entityGroup
 
 
     /* Update the value at the end time */
-    count = 1;
-    ret   = mpCoreProxy.GetSamples(
-        entityGroupId, entityId, fieldId, &endValue, &count, startTime, endTime, DCGM_ORDER_DESCENDING);
+    ret = GetSample(entityGroupId, entityId, fieldId, startTime, endTime, DCGM_ORDER_DESCENDING, &endValue);
     if (DCGM_ST_NO_DATA == ret)
         return DCGM_ST_OK;
     if (DCGM_ST_OK != ret)
@@ -1316,9 +1495,6 @@ dcgmReturn_t DcgmHealthWatch::MonitorNVLink(dcgm_field_entity_group_t entityGrou
 {
     dcgmReturn_t ret                                                   = DCGM_ST_OK;
     unsigned short fieldIds[DCGM_HEALTH_WATCH_NVLINK_ERROR_NUM_FIELDS] = { 0 };
-    dcgmcm_sample_t startValue                                         = {};
-    dcgmcm_sample_t endValue                                           = {};
-    int count                                                          = 0;
 
     /* Various NVLink error counters to be monitored */
     fieldIds[0] = DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_COUNT_TOTAL;
@@ -1337,17 +1513,24 @@ dcgmReturn_t DcgmHealthWatch::MonitorNVLink(dcgm_field_entity_group_t entityGrou
 
     /* Note: Allow endTime to be in the future. 0 = blank = most recent record in time series */
 
+    /* Get the first and the last value of every counter together */
+    std::vector<dcgmcm_sample_query_t> queries;
+    for (unsigned int nvLinkField = 0; nvLinkField < DCGM_HEALTH_WATCH_NVLINK_ERROR_NUM_FIELDS; nvLinkField++)
+    {
+        queries.push_back({ entityGroupId, entityId, fieldIds[nvLinkField], DCGM_ORDER_ASCENDING });
+        queries.push_back({ entityGroupId, entityId, fieldIds[nvLinkField], DCGM_ORDER_DESCENDING });
+    }
+
+    std::vector<dcgmReturn_t> rets;
+    std::vector<dcgmcm_sample_t> samples;
+    GetSamples(queries, startTime, endTime, rets, samples);
+
     for (unsigned int nvLinkField = 0; nvLinkField < DCGM_HEALTH_WATCH_NVLINK_ERROR_NUM_FIELDS; nvLinkField++)
     {
-        count = 1;
-        ret   = mpCoreProxy.GetSamples(entityGroupId,
-                                     entityId,
-                                     fieldIds[nvLinkField],
-                                     &startValue,
-                                     &count,
-                                     startTime,
-                                     endTime,
-                                     DCGM_ORDER_ASCENDING);
+        dcgmcm_sample_t const &startValue = samples[2 * nvLinkField];
+        dcgmcm_sample_t const &endValue   = samples[2 * nvLinkField + 1];
+
+        ret = rets[2 * nvLinkField];
 
         if (ret != DCGM_ST_OK && ret != DCGM_ST_NO_DATA && ret != DCGM_ST_NOT_WATCHED)
             return ret;
@@ -1357,15 +1540,7 @@ dcgmReturn_t DcgmHealthWatch::MonitorNVLink(dcgm_field_entity_group_t entityGrou
             || DCGM_INT64_IS_BLANK(startValue.val.i64))
             continue;
 
-        count = 1;
-        ret   = mpCoreProxy.GetSamples(entityGroupId,
-                                     entityId,
-                                     fieldIds[nvLinkField],
-                                     &endValue,
-                                     &count,
-                                     startTime,
-                                     endTime,
-                                     DCGM_ORDER_DESCENDING);
+        ret = rets[2 * nvLinkField + 1];
 
         if (ret != DCGM_ST_OK && ret != DCGM_ST_NO_DATA)
             return ret;
@@ -1471,7 +1646,6 @@ dcgmReturn_t DcgmHealthWatch::MonitorNvSwitchErrorCounts(bool fatal,
     std::vector<unsigned int>::iterator fieldIdIter;
     dcgmReturn_t dcgmReturn;
     std::vector<unsigned int> *fieldIds;
-    dcgmcm_sample_t sample = {};
     dcgmHealthWatchResults_t healthWatchResult;
     dcgmHealthSystems_t healthWatchSystems;
     std::string errorTypeString;
@@ -1502,13 +1676,24 @@ dcgmReturn_t DcgmHealthWatch::MonitorNvSwitchErrorCounts(bool fatal,
         errorTypeString    = "nonfatal";
     }
 
-    memset(&sample, 0, sizeof(sample));
+    /* Get the latest value of every counter together */
+    std::vector<dcgmcm_sample_query_t> queries;
+    for (fieldIdIter = fieldIds->begin(); fieldIdIter != fieldIds->end(); ++fieldIdIter)
+    {
+        unsigned short fieldId = *fieldIdIter;
+        queries.push_back({ entityGroupId, entityId, fieldId, DCGM_ORDER_DESCENDING });
+    }
+
+    std::vector<dcgmReturn_t> rets;
+    std::vector<dcgmcm_sample_t> samples;
+    GetSamples(queries, startTime, endTime, rets, samples);
 
     for (fieldIdIter = fieldIds->begin(); fieldIdIter != fieldIds->end(); ++fieldIdIter)
     {
-        int count  = 1;
-        dcgmReturn = mpCoreProxy.GetSamples(
-            entityGroupId, entityId, *fieldIdIter, &sample, &count, startTime, endTime, DCGM_ORDER_DESCENDING);
+        size_t queryIndex             = fieldIdIter - fieldIds->begin();
+        dcgmcm_sample_t const &sample = samples[queryIndex];
+
+        dcgmReturn = rets[queryIndex];
         if (dcgmReturn != DCGM_ST_OK)
         {
             PRINT_DEBUG("%d %u %u %u %lld %lld",
@@ -1587,7 +1772,7 @@ void DcgmHealthWatch::OnGroupRemove(unsigned int groupId)
 }
 
 /*****************************************************************************/
-void DcgmHealthWatch::ProcessXidFv(dcgmBufferedFv_t *fv)
+void DcgmHealthWatch::ProcessXidFv(dcgmBufferedFv_t const *fv)
 {
     switch (fv->value.i64)
     {
@@ -1606,33 +1791,345 @@ void DcgmHealthWatch::ProcessXidFv(dcgmBufferedFv_t *fv)
 }
 
 /*****************************************************************************/
-void DcgmHealthWatch::OnFieldValuesUpdate(DcgmFvBuffer *fvBuffer)
+unsigned long long DcgmHealthWatch::SampleWindowKey(dcgm_field_entity_group_t entityGroupId,
+                                                    dcgm_field_eid_t entityId,
+                                                    unsigned short fieldId)
 {
-    dcgmBufferedFv_t *fv;
-    dcgmBufferedFvCursor_t cursor = 0;
+    return ((unsigned long long)entityGroupId << 48) | ((unsigned long long)fieldId << 32) | entityId;
+}
 
-    /* This is a bit coarse-grained for now, but it's clean */
-    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock(m_mutex);
+/*****************************************************************************/
+void DcgmHealthWatch::AppendToSampleWindow(dcgmBufferedFv_t const *fv, timelib64_t now)
+{
+    unsigned long long key
+        = SampleWindowKey(static_cast<dcgm_field_entity_group_t>(fv->entityGroupId), fv->entityId, fv->fieldId);
+    auto it = m_sampleWindows.find(key);
+    if (it == m_sampleWindows.end())
+    {
+        /* Samples from before the subscription may still be in the cache. Only claim what we see from here on */
+        it = m_sampleWindows.emplace(key, dhw_sample_window_t { fv->timestamp, {} }).first;
+    }
 
-    for (fv = fvBuffer->GetNextFv(&cursor); fv; fv = fvBuffer->GetNextFv(&cursor))
+    dhw_sample_window_t &window = it->second;
+    if (fv->timestamp < window.coveredSince)
     {
-        /* Policy only pertains to GPUs for now */
-        if (fv->entityGroupId != DCGM_FE_GPU)
+        return; /* Already pruned past this. Checks that reach back this far go to the cache */
+    }
+
+    dcgmcm_sample_t sample = {};
+    sample.timestamp       = fv->timestamp;
+    if (fv->fieldType == DCGM_FT_DOUBLE)
+    {
+        sample.val.d = fv->value.dbl;
+    }
+    else
+    {
+        sample.val.i64 = fv->value.i64;
+    }
+
+    /* Samples arrive in order unless they were injected */
+    auto insertIt = window.samples.end();
+    while (insertIt != window.samples.begin() && std::prev(insertIt)->timestamp > sample.timestamp)
+    {
+        --insertIt;
+    }
+    window.samples.insert(insertIt, sample);
+
+    timelib64_t oldestKeepTime = now - DHW_SAMPLE_WINDOW_USEC;
+    while (window.samples.size() > 1
+           && (window.samples.front().timestamp < oldestKeepTime || window.samples.size() > DHW_MAX_WINDOW_SAMPLES))
+    {
+        window.coveredSince = std::max(window.coveredSince, window.samples.front().timestamp + 1);
+        window.samples.pop_front();
+    }
+}
+
+/*****************************************************************************/
+bool DcgmHealthWatch::GetWindowSample(dcgm_field_entity_group_t entityGroupId,
+                                      dcgm_field_eid_t entityId,
+                                      unsigned short fieldId,
+                                      long long startTime,
+                                      long long endTime,
+                                      dcgmOrder_t order,
+                                      dcgmcm_sample_t *sample,
+                                      dcgmReturn_t &ret)
+{
+    /* The windows only cover open-ended ranges that start after they were last pruned */
+    if (endTime != 0)
+    {
+        return false;
+    }
+
+    DcgmLockGuard dlg(m_mutex);
+    auto it = m_sampleWindows.find(SampleWindowKey(entityGroupId, entityId, fieldId));
+    if (it == m_sampleWindows.end() || startTime < it->second.coveredSince)
+    {
+        return false;
+    }
+
+    std::deque<dcgmcm_sample_t> const &samples = it->second.samples;
+    if (samples.empty() || samples.back().timestamp < startTime)
+    {
+        ret = DCGM_ST_NO_DATA;
+    }
+    else if (order == DCGM_ORDER_DESCENDING)
+    {
+        *sample = samples.back();
+        ret     = DCGM_ST_OK;
+    }
+    else
+    {
+        *sample = *std::lower_bound(
+            samples.begin(), samples.end(), startTime, [](dcgmcm_sample_t const &s, long long timestamp) {
+                return s.timestamp < timestamp;
+            });
+        ret = DCGM_ST_OK;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHealthWatch::GetSample(dcgm_field_entity_group_t entityGroupId,
+                                        dcgm_field_eid_t entityId,
+                                        unsigned short fieldId,
+                                        long long startTime,
+                                        long long endTime,
+                                        dcgmOrder_t order,
+                                        dcgmcm_sample_t *sample)
+{
+    dcgmReturn_t ret;
+    if (GetWindowSample(entityGroupId, entityId, fieldId, startTime, endTime, order, sample, ret))
+    {
+        return ret;
+    }
+
+    int count = 1;
+    return mpCoreProxy.GetSamples(entityGroupId, entityId, fieldId, sample, &count, startTime, endTime, order);
+}
+
+/*****************************************************************************/
+void DcgmHealthWatch::GetSamples(std::vector<dcgmcm_sample_query_t> const &queries,
+                                 long long startTime,
+                                 long long endTime,
+                                 std::vector<dcgmReturn_t> &rets,
+                                 std::vector<dcgmcm_sample_t> &samples)
+{
+    rets.assign(queries.size(), DCGM_ST_OK);
+    samples.assign(queries.size(), dcgmcm_sample_t {});
+
+    std::vector<dcgmcm_sample_query_t> misses;
+    std::vector<size_t> missIndexes;
+
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+        dcgmcm_sample_query_t const &query = queries[i];
+        if (!GetWindowSample(query.entityGroupId,
+                             query.entityId,
+                             query.fieldId,
+                             startTime,
+                             endTime,
+                             query.order,
+                             &samples[i],
+                             rets[i]))
         {
-            PRINT_DEBUG("%u", "Ignored non-GPU eg %u", fv->entityGroupId);
+            misses.push_back(query);
+            missIndexes.push_back(i);
+        }
+    }
+
+    if (misses.empty())
+    {
+        return;
+    }
+
+    DcgmFvBuffer fvBuffer;
+    dcgmReturn_t ret = mpCoreProxy.GetMultipleSamples(misses, startTime, endTime, 1, &fvBuffer);
+
+    /* With one sample per query, the cache answers each query with exactly one value in order */
+    dcgmBufferedFvCursor_t cursor = 0;
+    for (size_t index : missIndexes)
+    {
+        dcgmBufferedFv_t const *fv = (ret == DCGM_ST_OK) ? fvBuffer.GetNextFv(&cursor) : nullptr;
+        if (fv == nullptr)
+        {
+            rets[index] = (ret == DCGM_ST_OK) ? DCGM_ST_GENERIC_ERROR : ret;
             continue;
         }
 
+        rets[index] = static_cast<dcgmReturn_t>(fv->status);
+        if (rets[index] != DCGM_ST_OK)
+        {
+            continue;
+        }
+
+        samples[index].timestamp = fv->timestamp;
+        if (fv->fieldType == DCGM_FT_DOUBLE)
+        {
+            samples[index].val.d = fv->value.dbl;
+        }
+        else
+        {
+            samples[index].val.i64 = fv->value.i64;
+        }
+    }
+}
+
+/*****************************************************************************/
+void DcgmHealthWatch::AddToDetector(dcgmBufferedFv_t const *fv)
+{
+    dhw_detector_config_t const *config = GetDetectorConfig(fv->fieldId);
+    if (config == nullptr)
+    {
+        return;
+    }
+
+    auto entityGroupId = static_cast<dcgm_field_entity_group_t>(fv->entityGroupId);
+    if (config->gateFieldId != 0)
+    {
+        auto gateIt = m_sampleWindows.find(SampleWindowKey(entityGroupId, fv->entityId, config->gateFieldId));
+        if (gateIt == m_sampleWindows.end() || gateIt->second.samples.empty()
+            || DCGM_INT64_IS_BLANK(gateIt->second.samples.back().val.i64)
+            || gateIt->second.samples.back().val.i64 < config->gateMin)
+        {
+            return;
+        }
+    }
+
+    double value;
+    if (fv->fieldType == DCGM_FT_DOUBLE)
+    {
+        if (DCGM_FP64_IS_BLANK(fv->value.dbl))
+            return;
+        value = fv->value.dbl;
+    }
+    else
+    {
+        if (DCGM_INT64_IS_BLANK(fv->value.i64))
+            return;
+        value = (double)fv->value.i64;
+    }
+
+    unsigned long long key = SampleWindowKey(entityGroupId, fv->entityId, fv->fieldId);
+    auto it                = m_detectors.find(key);
+    if (it == m_detectors.end())
+    {
+        dhw_detector_state_t state { DcgmHealthDetector(config->direction, config->minDeviation), 0, 0 };
+        it = m_detectors.emplace(key, state).first;
+    }
+
+    dhw_detector_state_t &state = it->second;
+    if (config->perMinute)
+    {
+        long long counter = fv->value.i64;
+        if (state.lastCounterTime != 0 && fv->timestamp <= state.lastCounterTime)
+        {
+            return; /* Injected out of order or a repeat */
+        }
+
+        bool haveRate = state.lastCounterTime != 0 && counter >= state.lastCounter;
+        value = haveRate ? (counter - state.lastCounter) * 60000000.0 / (fv->timestamp - state.lastCounterTime) : 0.0;
+        state.lastCounter     = counter;
+        state.lastCounterTime = fv->timestamp;
+        if (!haveRate)
+        {
+            return; /* First sample or the counter was reset */
+        }
+    }
+
+    if (state.detector.AddSample(value))
+    {
+        DCGM_LOG_DEBUG << "Anomaly in field " << fv->fieldId << " of " << EntityToString(entityGroupId) << " "
+                       << fv->entityId << ": " << state.detector.GetRecent() << " against a baseline of "
+                       << state.detector.GetBaseline();
+    }
+}
+
+/*****************************************************************************/
+void DcgmHealthWatch::AddAnomalyIncidents(dcgm_field_entity_group_t entityGroupId,
+                                          dcgm_field_eid_t entityId,
+                                          dcgmHealthSystems_t healthSystemsMask,
+                                          DcgmHealthResponse &response)
+{
+    std::vector<std::pair<dhw_detector_config_t const *, DcgmHealthDetector>> anomalies;
+
+    {
+        DcgmLockGuard dlg(m_mutex);
+        for (dhw_detector_config_t const &config : c_detectorConfigs)
+        {
+            if (!(config.system & healthSystemsMask))
+            {
+                continue;
+            }
+
+            auto it = m_detectors.find(SampleWindowKey(entityGroupId, entityId, config.fieldId));
+            if (it != m_detectors.end() && it->second.detector.IsAnomalous())
+            {
+                anomalies.emplace_back(&config, it->second.detector);
+            }
+        }
+    }
+
+    for (auto const &[config, detector] : anomalies)
+    {
+        DcgmError d { entityId };
+        DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_FIELD_ANOMALY,
+                                  d,
+                                  config->description,
+                                  entityId,
+                                  config->direction > 0 ? "risen" : "fallen",
+                                  detector.GetBaseline(),
+                                  detector.GetRecent());
+        SetResponse(entityGroupId, entityId, DCGM_HEALTH_RESULT_WARN, config->system, d, response);
+    }
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmHealthWatch::GetLatestSample(dcgm_field_entity_group_t entityGroupId,
+                                              dcgm_field_eid_t entityId,
+                                              unsigned short fieldId,
+                                              dcgmcm_sample_t *sample)
+{
+    {
+        DcgmLockGuard dlg(m_mutex);
+        auto it = m_sampleWindows.find(SampleWindowKey(entityGroupId, entityId, fieldId));
+        if (it != m_sampleWindows.end() && !it->second.samples.empty())
+        {
+            *sample = it->second.samples.back();
+            return DCGM_ST_OK;
+        }
+    }
+
+    return mpCoreProxy.GetLatestSample(entityGroupId, entityId, fieldId, sample, 0);
+}
+
+/*****************************************************************************/
+void DcgmHealthWatch::OnFieldValuesUpdate(DcgmFvBuffer const *fvBuffer)
+{
+    dcgmBufferedFv_t const *fv;
+    dcgmBufferedFvCursor_t cursor = 0;
+    timelib64_t now               = timelib_usecSince1970();
+
+    /* This is a bit coarse-grained for now, but it's clean */
+    dcgmMutexReturn_t mutexSt = dcgm_mutex_lock(m_mutex);
+
+    for (fv = fvBuffer->GetNextFv(&cursor); fv; fv = fvBuffer->GetNextFv(&cursor))
+    {
         switch (fv->fieldId)
         {
             case DCGM_FI_DEV_XID_ERRORS:
-                ProcessXidFv(fv);
+                /* XIDs only pertain to GPUs for now */
+                if (fv->entityGroupId == DCGM_FE_GPU)
+                {
+                    ProcessXidFv(fv);
+                }
                 break;
 
             default:
-                /* This is partially expected since the cache manager will broadcast
-                   any FVs that updated during the same loop as FVs we care about */
-                DCGM_LOG_DEBUG << "Ignoring unhandled field " << fv->fieldId;
+                /* The cache manager only sends us the fields we subscribed to, which are
+                   the fields the health checks read */
+                AppendToSampleWindow(fv, now);
+                AddToDetector(fv);
                 break;
         }
     }
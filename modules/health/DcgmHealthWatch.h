@@ -17,21 +17,55 @@
 #define _DCGM_HEALTH_WATCH_H
 
 #include "DcgmCoreProxy.h"
+#include "DcgmElasticWorkerPool.h"
 #include "DcgmError.h"
 #include "DcgmGPUHardwareLimits.h"
+#include "DcgmHealthDetector.h"
 #include "DcgmHealthResponse.h"
 #include "dcgm_core_communication.h"
 #include "dcgm_test_apis.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 // Number of nvlink error counter types
 #define DCGM_HEALTH_WATCH_NVLINK_ERROR_NUM_FIELDS NVML_NVLINK_ERROR_COUNT
 
+// How long samples of the watched fields are kept for checks. Twice the default check window of a minute
+#define DHW_SAMPLE_WINDOW_USEC 120000000LL
+
+// Most samples kept per field. Faster watches only keep the newest ones and fall back to the cache for older ones
+#define DHW_MAX_WINDOW_SAMPLES 256
+
+// Most workers that check entities at once. A check mostly waits on the cache manager, so a few are plenty
+#define DHW_MAX_CHECK_WORKERS 8
+
+/* Recent samples of one watched field of one entity, as they arrived from the field value subscription */
+typedef struct
+{
+    timelib64_t coveredSince;            /* Every sample of the field from here on is in samples */
+    std::deque<dcgmcm_sample_t> samples; /* Sorted by timestamp. Always holds at least the latest sample */
+} dhw_sample_window_t;
+
+/* Anomaly detection of one watched field of one entity, fed from the field value subscription */
+typedef struct
+{
+    DcgmHealthDetector detector;
+    long long lastCounter;       /* Previous sample of a counter that the detector gets the rate of */
+    timelib64_t lastCounterTime; /* Timestamp of lastCounter. 0 = none yet */
+} dhw_detector_state_t;
+
 /* This class is implements the background health check methods
  * within the hostengine
  * It is intended to set watches, monitor them on demand, and
  * inform a user of any specific problems for watches that have
  * been requested.
+ * The watched fields are subscribed to and their recent samples kept
+ * per entity and field, so checks of the default window read those
+ * instead of querying the cache for every field of every entity.
  */
 class DcgmHealthWatch
 {
@@ -63,6 +97,16 @@ public:
                                       dcgmHealthSystems_t healthResponse,
                                       DcgmHealthResponse &response);
 
+    /*
+     * Check several gpus' health watches at once. Stops at the first gpu that fails to be
+     * checked, like calling MonitorWatchesForGpu() for each of them in order would
+     */
+    dcgmReturn_t MonitorWatchesForGpus(std::vector<unsigned int> const &gpuIds,
+                                       long long startTime,
+                                       long long endTime,
+                                       dcgmHealthSystems_t healthSystemsMask,
+                                       DcgmHealthResponse &response);
+
     /*
      * This method is used to trigger a monitoring of the configured watches for a group
      */
@@ -79,12 +123,12 @@ public:
     /*
     Notify this module that a watched field value updated
     */
-    void OnFieldValuesUpdate(DcgmFvBuffer *fvBuffer);
+    void OnFieldValuesUpdate(DcgmFvBuffer const *fvBuffer);
 
     /*
     Process a buffered fv for an XID. Called by OnFieldValuesUpdate()
     */
-    void ProcessXidFv(dcgmBufferedFv_t *fv);
+    void ProcessXidFv(dcgmBufferedFv_t const *fv);
 
 private:
     DcgmCoreProxy mpCoreProxy;
@@ -94,6 +138,16 @@ private:
 
     DcgmMutex *m_mutex;
 
+    std::unique_ptr<DcgmElasticWorkerPool> m_checkPool; /* Checks the entities of a group concurrently */
+
+    std::unordered_map<unsigned long long, dhw_sample_window_t>
+        m_sampleWindows; /* Key from SampleWindowKey() -> recent samples of that field. Kept up to date by
+                            OnFieldValuesUpdate() so checks don't query the cache. Protected by m_mutex */
+
+    std::unordered_map<unsigned long long, dhw_detector_state_t>
+        m_detectors; /* Key from SampleWindowKey() -> anomaly detection of that field. Fed by
+                        OnFieldValuesUpdate(). Protected by m_mutex */
+
     std::unordered_set<dcgm_field_eid_t>
         m_gpuHadUncontainedErrorXid; /* If a GPU has had an XID 95, its value is set here.
                                        This data structure is protected by m_mutex. */
@@ -223,6 +277,81 @@ private:
                                           DcgmHealthResponse &response);
 
     bool FitsGpuHardwareCheck(dcgm_field_entity_group_t entityGroupId);
+
+    /*
+     * Check the watched systems of one entity of a group. Called by MonitorWatches()
+     *
+     * checked OUT: Whether any system applied to the entity. Returns DCGM_ST_OK if not
+     *
+     * Returns: What checking the last system that applied returned
+     */
+    dcgmReturn_t MonitorEntity(dcgm_field_entity_group_t entityGroupId,
+                               dcgm_field_eid_t entityId,
+                               dcgmHealthSystems_t healthSystemsMask,
+                               long long startTime,
+                               long long endTime,
+                               DcgmHealthResponse &response,
+                               bool &checked);
+
+    /* Call check(0) to check(count - 1) on m_checkPool and the calling thread, and wait for all of them */
+    void RunChecks(size_t count, std::function<void(size_t)> const &check);
+
+    static unsigned long long SampleWindowKey(dcgm_field_entity_group_t entityGroupId,
+                                              dcgm_field_eid_t entityId,
+                                              unsigned short fieldId);
+
+    /* Add a buffered fv to the sample window of its field. Caller holds m_mutex */
+    void AppendToSampleWindow(dcgmBufferedFv_t const *fv, timelib64_t now);
+
+    /* Feed a buffered fv to the anomaly detector of its field, if it has one. Caller holds m_mutex */
+    void AddToDetector(dcgmBufferedFv_t const *fv);
+
+    /* Add an incident for each anomaly currently raised on a field of a GPU that belongs to a system in
+       healthSystemsMask. Called by MonitorEntity() */
+    void AddAnomalyIncidents(dcgm_field_entity_group_t entityGroupId,
+                             dcgm_field_eid_t entityId,
+                             dcgmHealthSystems_t healthSystemsMask,
+                             DcgmHealthResponse &response);
+
+    /*
+     * Get the first (DCGM_ORDER_ASCENDING) or last (DCGM_ORDER_DESCENDING) sample of a field between
+     * startTime and endTime, like DcgmCoreProxy::GetSamples() with a count of 1. Served from the sample
+     * window of the field when it covers the range and from the cache otherwise
+     */
+    dcgmReturn_t GetSample(dcgm_field_entity_group_t entityGroupId,
+                           dcgm_field_eid_t entityId,
+                           unsigned short fieldId,
+                           long long startTime,
+                           long long endTime,
+                           dcgmOrder_t order,
+                           dcgmcm_sample_t *sample);
+
+    /*
+     * GetSample() for each of queries of a numeric field. The queries the sample windows don't cover are
+     * answered by one request to the core. rets and samples get the result of each query in order
+     */
+    void GetSamples(std::vector<dcgmcm_sample_query_t> const &queries,
+                    long long startTime,
+                    long long endTime,
+                    std::vector<dcgmReturn_t> &rets,
+                    std::vector<dcgmcm_sample_t> &samples);
+
+    /* The part of GetSample() served from the sample windows. Returns false if they don't cover the range */
+    bool GetWindowSample(dcgm_field_entity_group_t entityGroupId,
+                         dcgm_field_eid_t entityId,
+                         unsigned short fieldId,
+                         long long startTime,
+                         long long endTime,
+                         dcgmOrder_t order,
+                         dcgmcm_sample_t *sample,
+                         dcgmReturn_t &ret);
+
+    /* Get the latest sample of a field, like DcgmCoreProxy::GetLatestSample(). Served from the sample window
+       of the field once it has one */
+    dcgmReturn_t GetLatestSample(dcgm_field_entity_group_t entityGroupId,
+                                 dcgm_field_eid_t entityId,
+                                 unsigned short fieldId,
+                                 dcgmcm_sample_t *sample);
 };
 
 #endif //_DCGM_HEALTH_WATCH_H
@@ -24,11 +24,20 @@ DcgmModuleHealth::DcgmModuleHealth(dcgmCoreCallbacks_t &dcc)
     : DcgmModuleWithCoreProxy(dcc)
 {
     mpHealthWatch = std::make_unique<DcgmHealthWatch>(dcc);
+
+    DcgmHealthWatch *healthWatch = mpHealthWatch.get();
+    m_fvUpdateWorker             = std::make_unique<DcgmFvUpdateWorker>(
+        [healthWatch](DcgmFvBuffer const &fvBuffer) { healthWatch->OnFieldValuesUpdate(&fvBuffer); },
+        "health_fv_updates");
+    m_fvUpdateWorker->Start();
 }
 
 /*****************************************************************************/
 DcgmModuleHealth::~DcgmModuleHealth()
-{}
+{
+    /* Stop feeding updates before mpHealthWatch goes away */
+    m_fvUpdateWorker.reset();
+}
 
 /*****************************************************************************/
 dcgmReturn_t DcgmModuleHealth::ProcessSetSystems(dcgm_health_msg_set_systems_t *msg)
@@ -126,7 +135,6 @@ dcgmReturn_t DcgmModuleHealth::ProcessCheckV4(dcgm_health_msg_check_v4 *msg)
 /*****************************************************************************/
 dcgmReturn_t DcgmModuleHealth::ProcessCheckGpus(dcgm_health_msg_check_gpus_t *msg)
 {
-    unsigned int gpuIdIndex;
     dcgmReturn_t dcgmReturn;
 
     dcgmReturn = CheckVersion(&msg->header, dcgm_health_msg_check_gpus_version);
@@ -150,13 +158,8 @@ dcgmReturn_t DcgmModuleHealth::ProcessCheckGpus(dcgm_health_msg_check_gpus_t *ms
     msg->response.version = dcgmHealthResponse_version4;
     DcgmHealthResponse response;
 
-    for (gpuIdIndex = 0; gpuIdIndex < msg->numGpuIds; gpuIdIndex++)
-    {
-        dcgmReturn = mpHealthWatch->MonitorWatchesForGpu(
-            msg->gpuIds[gpuIdIndex], msg->startTime, msg->endTime, msg->systems, response);
-        if (dcgmReturn != DCGM_ST_OK)
-            break;
-    }
+    std::vector<unsigned int> gpuIds(msg->gpuIds, msg->gpuIds + msg->numGpuIds);
+    dcgmReturn = mpHealthWatch->MonitorWatchesForGpus(gpuIds, msg->startTime, msg->endTime, msg->systems, response);
 
     response.PopulateHealthResponse(msg->response);
 
@@ -186,10 +189,14 @@ dcgmReturn_t DcgmModuleHealth::ProcessFieldValuesUpdated(dcgm_core_msg_field_val
         return dcgmReturn; /* Logging handled by helper method */
     }
 
-    DcgmFvBuffer fvbuf;
-    fvbuf.SetFromBuffer(msg->fieldValues.buffer, msg->fieldValues.bufferSize);
+    if (msg->snapshot == nullptr)
+    {
+        DCGM_LOG_ERROR << "Field value update was missing its snapshot";
+        return DCGM_ST_BADPARAM;
+    }
 
-    mpHealthWatch->OnFieldValuesUpdate(&fvbuf);
+    /* Walked by m_fvUpdateWorker so that the cache manager doesn't wait on us */
+    m_fvUpdateWorker->Post(*msg->snapshot);
 
     return DCGM_ST_OK;
 }
@@ -227,6 +234,9 @@ dcgmReturn_t DcgmModuleHealth::ProcessMessage(dcgm_module_command_header_t *modu
     }
     else
     {
+        /* Requests should see every field value update that came before them */
+        m_fvUpdateWorker->Flush();
+
         switch (moduleCommand->subCommand)
         {
             case DCGM_HEALTH_SR_GET_SYSTEMS:
@@ -16,6 +16,7 @@
 #ifndef DCGMMODULEHEALTH_H
 #define DCGMMODULEHEALTH_H
 
+#include "DcgmFvUpdateWorker.h"
 #include "DcgmHealthWatch.h"
 #include "DcgmModule.h"
 #include "dcgm_health_structs.h"
@@ -52,7 +53,8 @@ private:
 
     /*************************************************************************/
     /* Private member variables */
-    std::unique_ptr<DcgmHealthWatch> mpHealthWatch; /* Pointer to the worker class for this module */
+    std::unique_ptr<DcgmHealthWatch> mpHealthWatch;       /* Pointer to the worker class for this module */
+    std::unique_ptr<DcgmFvUpdateWorker> m_fvUpdateWorker; /* Feeds field value updates to mpHealthWatch */
 };
 
 
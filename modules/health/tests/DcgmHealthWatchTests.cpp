@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmFvBuffer.h>
+#include <DcgmHealthWatch.h>
+#include <dcgm_core_communication.h>
+#include <timelib.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+/* More GPUs than the health watch has check workers */
+unsigned int const c_gpuCount = DHW_MAX_CHECK_WORKERS + 4;
+
+/* Stands in for the host engine. Group 0 holds every GPU. The cache has no samples */
+dcgmReturn_t FakeCorePost(dcgm_module_command_header_t *header, void * /* poster */)
+{
+    switch (header->subCommand)
+    {
+        case DcgmCoreReqIdGMGetGroupEntities:
+        {
+            dcgmCoreGetGroupEntities_t *gge = (dcgmCoreGetGroupEntities_t *)header;
+            gge->response.entityPairsCount  = c_gpuCount;
+            for (unsigned int i = 0; i < c_gpuCount; i++)
+            {
+                gge->response.entityPairs[i].entityGroupId = DCGM_FE_GPU;
+                gge->response.entityPairs[i].entityId      = i;
+            }
+            break;
+        }
+
+        case DcgmCoreReqIdCMGetLatestSample:
+            ((dcgmCoreGetLatestSample_t *)header)->response.ret = DCGM_ST_NO_DATA;
+            break;
+
+        case DcgmCoreReqIdCMGetSamples:
+            ((dcgmCoreGetSamples_t *)header)->response.ret = DCGM_ST_NO_DATA;
+            break;
+
+        default:
+            /* Watches. Their zeroed responses are DCGM_ST_OK */
+            break;
+    }
+
+    return DCGM_ST_OK;
+}
+
+dcgmCoreCallbacks_t FakeCoreCallbacks()
+{
+    dcgmCoreCallbacks_t dcc = {};
+    dcc.version             = dcgmCoreCallbacks_version;
+    dcc.postfunc            = FakeCorePost;
+    dcc.poster              = nullptr;
+    return dcc;
+}
+
+/* Every odd GPU's thermal violation time grows between startTime and now */
+void AddThermalViolations(DcgmHealthWatch &healthWatch, long long startTime)
+{
+    DcgmFvBuffer fvBuffer;
+    for (unsigned int gpuId = 0; gpuId < c_gpuCount; gpuId++)
+    {
+        fvBuffer.AddInt64Value(DCGM_FE_GPU, gpuId, DCGM_FI_DEV_THERMAL_VIOLATION, 100, startTime, DCGM_ST_OK);
+        fvBuffer.AddInt64Value(
+            DCGM_FE_GPU, gpuId, DCGM_FI_DEV_THERMAL_VIOLATION, 100 + (gpuId % 2), startTime + 1000, DCGM_ST_OK);
+    }
+    healthWatch.OnFieldValuesUpdate(&fvBuffer);
+}
+
+std::vector<dcgm_field_eid_t> IncidentEntityIds(DcgmHealthResponse const &response)
+{
+    auto healthResponse = std::make_unique<dcgmHealthResponse_v4>();
+    response.PopulateHealthResponse(*healthResponse);
+
+    std::vector<dcgm_field_eid_t> entityIds;
+    for (unsigned int i = 0; i < healthResponse->incidentCount; i++)
+    {
+        CHECK(healthResponse->incidents[i].system == DCGM_HEALTH_WATCH_THERMAL);
+        entityIds.push_back(healthResponse->incidents[i].entityInfo.entityId);
+    }
+    return entityIds;
+}
+} // namespace
+
+TEST_CASE("HealthWatch: Concurrent checks report incidents in entity order")
+{
+    dcgmCoreCallbacks_t dcc = FakeCoreCallbacks();
+    DcgmHealthWatch healthWatch(dcc);
+    long long startTime = timelib_usecSince1970();
+
+    REQUIRE(healthWatch.SetWatches(0, DCGM_HEALTH_WATCH_THERMAL, 1, 1000000, 60.0) == DCGM_ST_OK);
+    AddThermalViolations(healthWatch, startTime);
+
+    std::vector<dcgm_field_eid_t> expected;
+    for (unsigned int gpuId = 1; gpuId < c_gpuCount; gpuId += 2)
+    {
+        expected.push_back(gpuId);
+    }
+
+    /* Repeat so that the checks finish in different orders */
+    for (int i = 0; i < 20; i++)
+    {
+        DcgmHealthResponse response;
+        REQUIRE(healthWatch.MonitorWatches(0, startTime, 0, response) == DCGM_ST_OK);
+        CHECK(IncidentEntityIds(response) == expected);
+    }
+}
+
+TEST_CASE("HealthWatch: Checking GPUs stops at the first GPU that fails")
+{
+    dcgmCoreCallbacks_t dcc = FakeCoreCallbacks();
+    DcgmHealthWatch healthWatch(dcc);
+    long long startTime = timelib_usecSince1970();
+
+    AddThermalViolations(healthWatch, startTime);
+
+    DcgmHealthResponse response;
+    CHECK(healthWatch.MonitorWatchesForGpus({ 0, 1, 2, 3 }, startTime, 0, DCGM_HEALTH_WATCH_THERMAL, response)
+          == DCGM_ST_OK);
+    CHECK(IncidentEntityIds(response) == std::vector<dcgm_field_eid_t> { 1, 3 });
+
+    /* GPUs after the bad one are checked but not reported */
+    DcgmHealthResponse badResponse;
+    CHECK(healthWatch.MonitorWatchesForGpus(
+              { 1, DCGM_MAX_NUM_DEVICES, 3 }, startTime, 0, DCGM_HEALTH_WATCH_THERMAL, badResponse)
+          == DCGM_ST_BADPARAM);
+    CHECK(IncidentEntityIds(badResponse) == std::vector<dcgm_field_eid_t> { 1 });
+
+    DcgmHealthResponse emptyResponse;
+    CHECK(healthWatch.MonitorWatchesForGpus({}, startTime, 0, DCGM_HEALTH_WATCH_THERMAL, emptyResponse)
+          == DCGM_ST_OK);
+    CHECK(IncidentEntityIds(emptyResponse).empty());
+}
@@ -18,7 +18,6 @@
 #include "DcgmMutex.h"
 #include "DcgmStringConversions.h"
 #include "DcgmWatchTable.h"
-#include "timeseries.h"
 
 #include <algorithm>
 #include <ctime>
@@ -97,12 +96,22 @@ const std::string DcgmMetadataManager::STAT_CONTEXT_STRINGS[STAT_CONTEXT_COUNT]
 const std::string DcgmMetadataManager::FIELD_METADATA_TYPE_STRINGS[FIELD_MT_COUNT] = {
     "total-bytes-used",      "total-exec-time",  "total-fetch-count",
     "mean-update-freq-usec", "recent-exec-time", "aggregate-instance-count",
+    "max-exec-time",         "exec-time-hist",   "max-insert-lag",
+    "max-dispatch-lag",      "max-ipc-send-lag", "insert-lag-hist",
+    "dispatch-lag-hist",     "ipc-send-lag-hist",
 };
+static_assert(DCGM_INTROSPECT_LAG_STAGE_COUNT == 3, "Update FIELD_METADATA_TYPE_STRINGS");
 
-const std::string DcgmMetadataManager::PROCESS_METADATA_TYPE_STRINGS[PROCESS_MT_COUNT] = {
-    "VM_RSS_KB",           "VM_SWAP_KB",         "REAL_RAM_KB",    "PROCESS_TICKS_UTIME",
-    "PROCESS_TICKS_STIME", "DEVICE_TICKS_TOTAL", "CPU_UTIL_UTIME", "CPU_UTIL_STIME",
-};
+/* Upper bounds of the exec time histogram buckets but the last. See DcgmCacheManager::GetExecTimeBucket */
+static std::vector<double> ExecTimeBucketBounds()
+{
+    std::vector<double> bounds;
+    for (int i = 1; i < DCGM_INTROSPECT_EXEC_TIME_BUCKETS; i++)
+    {
+        bounds.push_back((double)(1LL << i));
+    }
+    return bounds;
+}
 
 template <typename T>
 void deleteNotNull(T *&obj)
@@ -119,26 +128,27 @@ DcgmMetadataManager::DcgmMetadataManager(DcgmCoreProxy *dcc)
     , m_coreProxy(dcc)
 {
     m_startUpdateTriggered = true;
-    m_statCollection       = new DcgmStatCollection(false);
 
     m_currentlyUpdating = false;
     m_updateLoopId      = 1; // not necessary, but easier to read logs if it starts at 1
 
     m_startOfCurUpdateLoop = timelib_usecSince1970();
 
-    m_processTypeToOldestKeepTimestamp[PROCESS_MT_TICKS_UTIME]        = CPU_AVG_INTERVAL_USEC;
-    m_processTypeToOldestKeepTimestamp[PROCESS_MT_TICKS_STIME]        = CPU_AVG_INTERVAL_USEC;
-    m_processTypeToOldestKeepTimestamp[PROCESS_MT_DEVICE_TICKS_TOTAL] = CPU_AVG_INTERVAL_USEC;
-
-    m_processTypeToMaxKeepEntries[PROCESS_MT_TICKS_UTIME]        = 0;
-    m_processTypeToMaxKeepEntries[PROCESS_MT_TICKS_STIME]        = 0;
-    m_processTypeToMaxKeepEntries[PROCESS_MT_DEVICE_TICKS_TOTAL] = 0;
-
     m_aggregationFunctors.push_back(new AggregateSumFunctor<long long>(this, FIELD_MT_CUR_BYTES_USED));
     m_aggregationFunctors.push_back(new AggregateSumFunctor<long long>(this, FIELD_MT_TOTAL_EXEC_TIME_USEC));
     m_aggregationFunctors.push_back(new AggregateSumFunctor<long long>(this, FIELD_MT_TOTAL_FETCH_COUNT));
     m_aggregationFunctors.push_back(new AggregateSumFunctor<long long>(this, FIELD_MT_AGGR_INSTANCE_COUNT));
     m_aggregationFunctors.push_back(new AggregateMeanFunctor<long long>(this, FIELD_MT_MEAN_UPDATE_FREQ_USEC));
+    m_aggregationFunctors.push_back(new AggregateMaxFunctor<long long>(this, FIELD_MT_MAX_EXEC_TIME_USEC));
+    m_aggregationFunctors.push_back(new AggregateHistogramSumFunctor(this, FIELD_MT_EXEC_TIME_HISTOGRAM));
+    for (int mType = FIELD_MT_MAX_SAMPLE_LAG_USEC_FIRST; mType <= FIELD_MT_MAX_SAMPLE_LAG_USEC_LAST; mType++)
+    {
+        m_aggregationFunctors.push_back(new AggregateMaxFunctor<long long>(this, (FieldMetadataType)mType));
+    }
+    for (int mType = FIELD_MT_SAMPLE_LAG_HISTOGRAM_FIRST; mType <= FIELD_MT_SAMPLE_LAG_HISTOGRAM_LAST; mType++)
+    {
+        m_aggregationFunctors.push_back(new AggregateHistogramSumFunctor(this, (FieldMetadataType)mType));
+    }
 
     // this aggregator must come after the aggregator for FIELD_MT_MEAN_UPDATE_FREQ_USEC
     m_aggregationFunctors.push_back(new AggregateNormalizedSumFunctor<double, long long>(
@@ -147,8 +157,6 @@ DcgmMetadataManager::DcgmMetadataManager(DcgmCoreProxy *dcc)
 
 DcgmMetadataManager::~DcgmMetadataManager()
 {
-    delete m_statCollection;
-
     for (auto &&functor : m_aggregationFunctors)
     {
         delete functor;
@@ -192,6 +200,9 @@ void DcgmMetadataManager::retrieveFieldInstanceData()
                        FIELD_MT_AGGR_INSTANCE_COUNT);
 
         st = recordStat(sKeyIC, (long long)1);
+
+        recordFieldHistograms(ContextKey(STAT_CONTEXT_FIELD, fields[i].fieldId, false, fields[i].scope, 0),
+                                     fields[i]);
     }
 
     std::vector<unsigned int> gpuIds;
@@ -238,11 +249,28 @@ void DcgmMetadataManager::retrieveFieldInstanceData()
                                FIELD_MT_AGGR_INSTANCE_COUNT);
 
                 st = recordStat(sKeyIC, (long long)1);
+
+                recordFieldHistograms(
+                    ContextKey(STAT_CONTEXT_FIELD, fields[i].fieldId, false, fields[i].scope, gpuId), fields[i]);
             }
         }
     }
 }
 
+void DcgmMetadataManager::recordFieldHistograms(ContextKey const &context, dcgmCoreWatchInfo_t const &field)
+{
+    recordStat(StatKey(context, FIELD_MT_MAX_EXEC_TIME_USEC), field.maxExecTimeUsec);
+    recordStatBuckets(StatKey(context, FIELD_MT_EXEC_TIME_HISTOGRAM), field.execTimeHistogram);
+
+    for (int stage = 0; stage < DCGM_INTROSPECT_LAG_STAGE_COUNT; stage++)
+    {
+        recordStat(StatKey(context, (FieldMetadataType)(FIELD_MT_MAX_SAMPLE_LAG_USEC_FIRST + stage)),
+                   field.maxSampleLagUsec[stage]);
+        recordStatBuckets(StatKey(context, (FieldMetadataType)(FIELD_MT_SAMPLE_LAG_HISTOGRAM_FIRST + stage)),
+                          field.sampleLagHistogram[stage]);
+    }
+}
+
 void DcgmMetadataManager::postProcessFieldInstanceData()
 {
     dcgmReturn_t st;
@@ -364,14 +392,13 @@ void DcgmMetadataManager::postProcessAllFieldsData()
 
 void DcgmMetadataManager::retrieveProcessData()
 {
-    retrieveOSInfo();
+    m_processStats.Update();
     PRINT_DEBUG("", "done retrieving OS process data");
 }
 
 void DcgmMetadataManager::postProcessProcessData()
 {
-    generateCpuUtilization();
-    PRINT_DEBUG("", "done post-processing OS process data");
+    /* DcgmProcessStats works out CPU utilization as it records samples */
 }
 
 template <typename Fn>
@@ -624,65 +651,39 @@ dcgmReturn_t DcgmMetadataManager::aggregateOverFields(ContextKey partialAggregat
 
 dcgmReturn_t DcgmMetadataManager::lastUpdateTime(StatKey sKey, timelib64_t *updateTimeUsec)
 {
-    mcollect_value_p measurement = getStatMeasurement(sKey);
+    DcgmNs::MetricHandle handle = getStatHandle(sKey, false);
 
-    if (measurement == NULL)
+    if (m_metrics.GetUpdateCount(handle) == 0)
     {
         PRINT_DEBUG("%s", "measurement for stat \"%s\" has no records", sKey.str().c_str());
         return DCGM_ST_NO_DATA;
     }
-    else if (measurement->type != MC_TYPE_TIMESERIES_DOUBLE && measurement->type != MC_TYPE_TIMESERIES_INT64
-             && measurement->type != MC_TYPE_TIMESERIES_STRING && measurement->type != MC_TYPE_TIMESERIES_BLOB)
-    {
-        PRINT_ERROR("", "measurement is not a timeseries");
-        return DCGM_ST_BADPARAM;
-    }
 
-    int measurementCount = timeseries_size(measurement->val.tseries);
-    if (measurementCount == 0)
-    {
-        PRINT_DEBUG("%s", "measurement for stat \"%s\" has no records", sKey.str().c_str());
-        return DCGM_ST_NO_DATA;
-    }
-
-    *updateTimeUsec = timeseries_last(measurement->val.tseries, NULL)->usecSince1970;
+    *updateTimeUsec = m_metrics.GetLastUpdate(handle);
     return DCGM_ST_OK;
 }
 
 dcgmReturn_t DcgmMetadataManager::generateFieldRecentUpdateTime(unsigned short fieldId, unsigned int gpuId, int scope)
 {
-    dcgmReturn_t st;
-
     StatKey totalExecTimeKey(ContextKey(STAT_CONTEXT_FIELD, fieldId, false, scope, gpuId),
                              FIELD_MT_TOTAL_EXEC_TIME_USEC);
 
-    mcollect_value_p measurement = getStatMeasurement(totalExecTimeKey);
-
-    st = validateMcollectType(measurement, FIELD_MT_TOTAL_EXEC_TIME_USEC);
-    if (DCGM_ST_OK != st)
-        return st;
-
-    long long recentExecTime;
-    int measurementCount = timeseries_size(measurement->val.tseries);
-    if (measurementCount == 0)
+    DcgmNs::MetricHandle handle = getStatHandle(totalExecTimeKey, false);
+    if (handle == DcgmNs::InvalidMetricHandle)
     {
-        return DCGM_ST_OK; // field never retrieved, nothing to do
+        return DCGM_ST_NO_DATA;
     }
-    else if (measurementCount == 1)
+
+    if (m_metrics.GetUpdateCount(handle) == 0)
     {
-        recentExecTime = timeseries_last(measurement->val.tseries, NULL)->val.i64;
+        return DCGM_ST_OK; // field never retrieved, nothing to do
     }
-    else
+
+    // the whole total the first time around, otherwise the time spent since the last update loop
+    long long recentExecTime = m_metrics.GetCounterDelta(handle);
+    if (m_metrics.GetUpdateCount(handle) > 1 && recentExecTime == 0)
     {
-        st = getRecentStatDiff(measurement->val.tseries, &recentExecTime);
-        if (DCGM_ST_OK != st)
-        {
-            return st;
-        }
-        if (recentExecTime == 0)
-        {
-            return DCGM_ST_OK; // when last execution time was retrieved, no update had been done
-        }
+        return DCGM_ST_OK; // when last execution time was retrieved, no update had been done
     }
 
     // store recent exec time as a double because it will get normalized when it is aggregated later
@@ -694,74 +695,6 @@ dcgmReturn_t DcgmMetadataManager::generateFieldRecentUpdateTime(unsigned short f
     return DCGM_ST_OK;
 }
 
-timelib64_t DcgmMetadataManager::getOldestKeepTimestamp(ProcessMetadataType mType)
-{
-    if (m_processTypeToOldestKeepTimestamp.count(mType) == 1)
-    {
-        return m_processTypeToOldestKeepTimestamp[mType];
-    }
-    else
-    {
-        return DEFAULT_OLDEST_KEEP_TIMESTAMP;
-    }
-}
-
-timelib64_t DcgmMetadataManager::getOldestKeepTimestamp(FieldMetadataType mType)
-{
-    if (m_fieldTypeToOldestKeepTimestamp.count(mType) == 1)
-    {
-        return m_fieldTypeToOldestKeepTimestamp[mType];
-    }
-    else
-    {
-        return DEFAULT_OLDEST_KEEP_TIMESTAMP;
-    }
-}
-
-int DcgmMetadataManager::getMaxKeepEntries(ProcessMetadataType mType)
-{
-    if (m_processTypeToMaxKeepEntries.count(mType) == 1)
-    {
-        return m_processTypeToMaxKeepEntries[mType];
-    }
-    else
-    {
-        return DEFAULT_MAX_KEEP_ENTRIES;
-    }
-}
-
-int DcgmMetadataManager::getMaxKeepEntries(FieldMetadataType mType)
-{
-    if (m_fieldTypeToMaxKeepEntries.count(mType) == 1)
-    {
-        return m_fieldTypeToMaxKeepEntries[mType];
-    }
-    else
-    {
-        return DEFAULT_MAX_KEEP_ENTRIES;
-    }
-}
-
-dcgmReturn_t DcgmMetadataManager::getRecentStatDiff(timeseries_p ts, long long *diff)
-{
-    timeseries_cursor_t cursor;
-    timeseries_entry_p lastStatEntry = timeseries_last(ts, &cursor);
-    if (lastStatEntry == NULL)
-    {
-        return DCGM_ST_NO_DATA;
-    }
-
-    timeseries_entry_p prevStatEntry = timeseries_prev(ts, &cursor);
-    if (prevStatEntry == NULL)
-    {
-        return DCGM_ST_NO_DATA;
-    }
-
-    *diff = lastStatEntry->val.i64 - prevStatEntry->val.i64;
-
-    return DCGM_ST_OK;
-}
-
 template <typename StatT, typename NormT, typename RetT>
 dcgmReturn_t DcgmMetadataManager::getNormalizedLatestStat(const StatKey &statKey,
                                                           const StatKey &normFromStatKey,
@@ -828,14 +761,7 @@ std::string DcgmMetadataManager::StatKey::str() const
         contextIdStr = "";
     }
 
-    if (cKey.context == STAT_CONTEXT_PROCESS)
-    {
-        mTypeStr = PROCESS_METADATA_TYPE_STRINGS[mType.process];
-    }
-    else
-    {
-        mTypeStr = FIELD_METADATA_TYPE_STRINGS[mType.field];
-    }
+    mTypeStr = FIELD_METADATA_TYPE_STRINGS[mType];
 
     aggregateStr.append(":");
     aggregateStr.append(contextStr);
@@ -870,201 +796,116 @@ dcgmReturn_t DcgmMetadataManager::getRecentStat(StatKey sKey, T *metadata)
 template <typename T>
 dcgmReturn_t DcgmMetadataManager::getStat(StatKey sKey, T *metadata)
 {
-    dcgmReturn_t retSt;
-
     if (metadata == NULL)
     {
         PRINT_ERROR("", "param cannot be NULL");
         return DCGM_ST_BADPARAM;
     }
 
-    std::string statKey = sKey.str();
-
+    DcgmNs::MetricHandle handle = getStatHandle(sKey, false);
+    if (m_metrics.GetUpdateCount(handle) == 0)
     {
-        mcollect_value_p measurement = getStatMeasurement(sKey);
-
-        if (sKey.cKey.context == STAT_CONTEXT_PROCESS)
-        {
-            retSt = validateMcollectType(measurement, sKey.mType.process);
-        }
-        else
-        {
-            retSt = validateMcollectType(measurement, sKey.mType.field);
-        }
-
-        if (retSt != DCGM_ST_OK)
-        {
-            PRINT_DEBUG("%s", "no metadata found for key %s", statKey.c_str());
-            return retSt;
-        }
-
-        timeseries_p ts = measurement->val.tseries;
-        timeseries_cursor_t tsCursor;
-        timeseries_entry_p tsVal = timeseries_last(ts, &tsCursor);
-        if (tsVal == NULL)
-        {
-            PRINT_DEBUG("%s", "no metadata found for key %s", statKey.c_str());
-            return DCGM_ST_NO_DATA;
-        }
-
-        if (sKey.cKey.context == STAT_CONTEXT_PROCESS)
-        {
-            extractTimeseriesVal(metadata, tsVal, sKey.mType.process);
-        }
-        else
-        {
-            extractTimeseriesVal(metadata, tsVal, sKey.mType.field);
-        }
+        PRINT_DEBUG("%s", "no metadata found for key %s", sKey.str().c_str());
+        return DCGM_ST_NO_DATA;
     }
 
-    return DCGM_ST_OK;
+    switch (m_metrics.GetKind(handle))
+    {
+        case DcgmNs::MetricKind::Counter:
+            *metadata = static_cast<T>(m_metrics.GetCounter(handle));
+            return DCGM_ST_OK;
+        case DcgmNs::MetricKind::Gauge:
+            *metadata = static_cast<T>(m_metrics.GetGauge(handle));
+            return DCGM_ST_OK;
+        default:
+            PRINT_ERROR("%d", "INTERNAL ERROR: metadata type %d is not a single value", (int)sKey.mType);
+            return DCGM_ST_GENERIC_ERROR;
+    }
 }
 
 template <typename T>
 dcgmReturn_t DcgmMetadataManager::recordStat(StatKey sKey, const T &val)
 {
-    dcgmReturn_t retSt = DCGM_ST_OK;
-    timelib64_t oldestKeepTimestamp;
-    int maxKeepEntries;
-    std::string statKey = sKey.str();
-
-    if (sKey.cKey.context == STAT_CONTEXT_PROCESS)
-    {
-        oldestKeepTimestamp = getOldestKeepTimestamp(sKey.mType.process);
-        maxKeepEntries      = getMaxKeepEntries(sKey.mType.process);
-    }
-    else
+    DcgmNs::MetricHandle handle = getStatHandle(sKey, true);
+    if (handle == DcgmNs::InvalidMetricHandle)
     {
-        oldestKeepTimestamp = getOldestKeepTimestamp(sKey.mType.field);
-        maxKeepEntries      = getMaxKeepEntries(sKey.mType.field);
+        PRINT_ERROR("%s", "invalid stat context, %s", sKey.cKey.str().c_str());
+        return DCGM_ST_BADPARAM;
     }
 
     timelib64_t now = timelib_usecSince1970();
 
-    if (sKey.cKey.isGpuStat())
-    {
-        m_statCollection->AppendEntityStat(
-            SC_ENTITY_GROUP_GPU, m_coreProxy->GpuIdToNvmlIndex(sKey.cKey.gpuId), statKey, val, 0, now);
-        m_statCollection->EnforceEntityStatQuota(SC_ENTITY_GROUP_GPU,
-                                                 m_coreProxy->GpuIdToNvmlIndex(sKey.cKey.gpuId),
-                                                 statKey,
-                                                 oldestKeepTimestamp,
-                                                 maxKeepEntries);
-        PRINT_DEBUG("%u %s %f %lld",
-                    "Recorded metadata stat gpuId %u, key %s, val %f, now %lld",
-                    sKey.cKey.gpuId,
-                    statKey.c_str(),
-                    (double)val,
-                    (long long)now);
-    }
-    else if (sKey.cKey.isGlobalStat())
-    {
-        m_statCollection->AppendGlobalStat(statKey, val, now);
-        m_statCollection->EnforceGlobalStatQuota(statKey, oldestKeepTimestamp, maxKeepEntries);
-        PRINT_DEBUG("%s %f %lld",
-                    "Recorded metadata stat (global), key %s, val %f, now %lld",
-                    statKey.c_str(),
-                    (double)val,
-                    (long long)now);
+    if (m_metrics.GetKind(handle) == DcgmNs::MetricKind::Counter)
+    {
+        m_metrics.SetCounter(handle, (long long)val, now);
     }
     else
     {
-        PRINT_ERROR("%s", "invalid stat context, %s", sKey.cKey.str().c_str());
-        retSt = DCGM_ST_BADPARAM;
+        m_metrics.SetGauge(handle, (double)val, now);
     }
 
-    return retSt;
+    PRINT_DEBUG("%u %s %f %lld",
+                "Recorded metadata stat gpuId %u, key %s, val %f, now %lld",
+                sKey.cKey.gpuId,
+                sKey.str().c_str(),
+                (double)val,
+                (long long)now);
+    return DCGM_ST_OK;
 }
 
-template <typename MetadataType>
-void DcgmMetadataManager::extractTimeseriesVal(void *val, timeseries_entry_p tsVal, MetadataType mType)
+dcgmReturn_t DcgmMetadataManager::getStatBuckets(StatKey sKey, long long *buckets, bool recentOnly)
 {
-    int mcType = mcollectTypeForMetadataType(mType);
-    if (mcType == MC_TYPE_TIMESERIES_INT64)
+    DcgmNs::MetricHandle handle = getStatHandle(sKey, false);
+    if (m_metrics.GetUpdateCount(handle) == 0)
     {
-        *(long long *)val = tsVal->val.i64;
-    }
-    else if (mcType == MC_TYPE_TIMESERIES_DOUBLE)
-    {
-        *(double *)val = tsVal->val.dbl;
-    }
-    else if (mcType == MC_TYPE_TIMESERIES_BLOB)
-    {
-        memcpy(val, tsVal->val.ptr, (size_t)tsVal->val2.ptrSize);
-    }
-    else
-    {
-        PRINT_ERROR("%d %d", "unknown mcType \"%d\" from metadata type %d, see MC_TYPE_? for values", mcType, mType);
+        PRINT_DEBUG("%s", "no metadata found for key %s", sKey.str().c_str());
+        return DCGM_ST_NO_DATA;
     }
-}
 
-template <typename MetadataType>
-dcgmReturn_t DcgmMetadataManager::validateMcollectType(mcollect_value_p measurement, MetadataType mType)
-{
-    if (NULL == measurement)
+    if (recentOnly && m_metrics.GetLastUpdate(handle) < m_startOfCurUpdateLoop)
     {
-        return DCGM_ST_NO_DATA;
+        return DCGM_ST_STALE_DATA;
     }
 
-    int expectedType = mcollectTypeForMetadataType(mType);
-    if (measurement->type != expectedType)
+    long long const *stored = m_metrics.GetBuckets(handle);
+    if (stored == nullptr || m_metrics.GetBucketCount(handle) != DCGM_INTROSPECT_EXEC_TIME_BUCKETS)
     {
-        PRINT_ERROR("%d %d %d",
-                    "INTERNAL ERROR: measurement with MetadataType \"%d\"did not have expected type of %d. "
-                    "Got %d.  See MC_TYPE_? for types.",
-                    (int)mType,
-                    expectedType,
-                    measurement->type);
+        PRINT_ERROR("%d", "INTERNAL ERROR: metadata type %d is not a histogram", (int)sKey.mType);
         return DCGM_ST_GENERIC_ERROR;
     }
+
+    std::copy(stored, stored + DCGM_INTROSPECT_EXEC_TIME_BUCKETS, buckets);
     return DCGM_ST_OK;
 }
 
-int DcgmMetadataManager::mcollectTypeForMetadataType(FieldMetadataType mType) const
+dcgmReturn_t DcgmMetadataManager::recordStatBuckets(StatKey sKey, long long const *buckets)
 {
-    switch (mType)
+    DcgmNs::MetricHandle handle = getStatHandle(sKey, true);
+    if (handle == DcgmNs::InvalidMetricHandle)
     {
-        case FIELD_MT_CUR_BYTES_USED:
-            return MC_TYPE_TIMESERIES_INT64;
-        case FIELD_MT_TOTAL_EXEC_TIME_USEC:
-            return MC_TYPE_TIMESERIES_INT64;
-        case FIELD_MT_TOTAL_FETCH_COUNT:
-            return MC_TYPE_TIMESERIES_INT64;
-        case FIELD_MT_MEAN_UPDATE_FREQ_USEC:
-            return MC_TYPE_TIMESERIES_INT64;
-        case FIELD_MT_RECENT_EXEC_TIME_USEC:
-            return MC_TYPE_TIMESERIES_DOUBLE;
-        case FIELD_MT_AGGR_INSTANCE_COUNT:
-            return MC_TYPE_TIMESERIES_INT64;
-        default:
-            PRINT_ERROR("%d", "invalid metadata type of %d", mType);
-            return MC_TYPE_UNKNOWN;
+        PRINT_ERROR("%s", "invalid stat context, %s", sKey.cKey.str().c_str());
+        return DCGM_ST_BADPARAM;
     }
+
+    m_metrics.SetBuckets(handle, buckets, timelib_usecSince1970());
+    return DCGM_ST_OK;
 }
 
-int DcgmMetadataManager::mcollectTypeForMetadataType(ProcessMetadataType mType) const
+DcgmNs::MetricKind DcgmMetadataManager::metricKindForMetadataType(FieldMetadataType mType)
 {
     switch (mType)
     {
-        case PROCESS_MT_VM_RSS_KB:
-            return MC_TYPE_TIMESERIES_INT64;
-        case PROCESS_MT_VM_SWAP_KB:
-            return MC_TYPE_TIMESERIES_INT64;
-        case PROCESS_MT_REAL_RAM_KB:
-            return MC_TYPE_TIMESERIES_INT64;
-        case PROCESS_MT_TICKS_UTIME:
-            return MC_TYPE_TIMESERIES_INT64;
-        case PROCESS_MT_TICKS_STIME:
-            return MC_TYPE_TIMESERIES_INT64;
-        case PROCESS_MT_DEVICE_TICKS_TOTAL:
-            return MC_TYPE_TIMESERIES_INT64;
-        case PROCESS_MT_CPU_UTIL_UTIME:
-            return MC_TYPE_TIMESERIES_DOUBLE;
-        case PROCESS_MT_CPU_UTIL_STIME:
-            return MC_TYPE_TIMESERIES_DOUBLE;
+        case FIELD_MT_TOTAL_EXEC_TIME_USEC:
+        case FIELD_MT_TOTAL_FETCH_COUNT:
+            return DcgmNs::MetricKind::Counter;
+        case FIELD_MT_EXEC_TIME_HISTOGRAM:
+            return DcgmNs::MetricKind::Histogram;
         default:
-            PRINT_ERROR("%d", "invalid metadata type of %d", mType);
-            return MC_TYPE_UNKNOWN;
+            if (mType >= FIELD_MT_SAMPLE_LAG_HISTOGRAM_FIRST && mType <= FIELD_MT_SAMPLE_LAG_HISTOGRAM_LAST)
+            {
+                return DcgmNs::MetricKind::Histogram;
+            }
+            return DcgmNs::MetricKind::Gauge;
     }
 }
 
@@ -1277,7 +1118,7 @@ dcgmReturn_t DcgmMetadataManager::GetBytesUsed(ContextKey context, long long *pT
 
     if (context.context == STAT_CONTEXT_PROCESS)
     {
-        return getHostengineBytesUsed(context, pTotalBytesUsed, waitIfNoData);
+        return getHostengineBytesUsed(pTotalBytesUsed, waitIfNoData);
     }
     else
     {
@@ -1285,14 +1126,13 @@ dcgmReturn_t DcgmMetadataManager::GetBytesUsed(ContextKey context, long long *pT
     }
 }
 
-dcgmReturn_t DcgmMetadataManager::getHostengineBytesUsed(ContextKey context, long long *bytesUsed, bool waitIfNoData)
+dcgmReturn_t DcgmMetadataManager::getHostengineBytesUsed(long long *bytesUsed, bool /*waitIfNoData*/)
 {
-    StatKey sKey(context, PROCESS_MT_REAL_RAM_KB);
-    GetStatFunctor<long long> functor(this, sKey, bytesUsed);
-    dcgmReturn_t st = getMetadataWithWait(functor, waitIfNoData);
+    DcgmProcessSample sample;
+    dcgmReturn_t st = m_processStats.GetLatest(sample);
     if (DCGM_ST_OK == st)
     {
-        *bytesUsed = *bytesUsed * 1024;
+        *bytesUsed = (sample.rssKb + sample.swapKb) * 1024;
     }
     return st;
 }
@@ -1345,6 +1185,34 @@ dcgmReturn_t DcgmMetadataManager::GetExecTime(ContextKey context, ExecTimeInfo *
     if (DCGM_ST_OK != st)
         return st;
 
+    GetStatFunctor<long long> maxExecTimeFn(
+        this, StatKey(context, FIELD_MT_MAX_EXEC_TIME_USEC), &execTime->maxUpdateUsec);
+    st = getMetadataWithWait(maxExecTimeFn, waitIfNoData);
+    if (DCGM_ST_OK != st)
+        return st;
+
+    StatKey histogramKey(context, FIELD_MT_EXEC_TIME_HISTOGRAM);
+    st = getMetadataWithWait(
+        [&]() { return getStatBuckets(histogramKey, execTime->updateUsecHistogram, false); }, waitIfNoData);
+    if (DCGM_ST_OK != st)
+        return st;
+
+    for (int stage = 0; stage < DCGM_INTROSPECT_LAG_STAGE_COUNT; stage++)
+    {
+        StatKey maxLagKey(context, (FieldMetadataType)(FIELD_MT_MAX_SAMPLE_LAG_USEC_FIRST + stage));
+        GetStatFunctor<long long> maxLagFn(this, maxLagKey, &execTime->maxSampleLagUsec[stage]);
+        st = getMetadataWithWait(maxLagFn, waitIfNoData);
+        if (DCGM_ST_OK != st)
+            return st;
+
+        StatKey lagHistogramKey(context, (FieldMetadataType)(FIELD_MT_SAMPLE_LAG_HISTOGRAM_FIRST + stage));
+        st = getMetadataWithWait(
+            [&]() { return getStatBuckets(lagHistogramKey, execTime->sampleLagUsecHistogram[stage], false); },
+            waitIfNoData);
+        if (DCGM_ST_OK != st)
+            return st;
+    }
+
     return DCGM_ST_OK;
 }
 
@@ -1362,29 +1230,26 @@ dcgmReturn_t DcgmMetadataManager::GetCpuUtilization(CpuUtil *cpuUtil, bool waitI
 
 dcgmReturn_t DcgmMetadataManager::getCpuUtilizationForHostengine(CpuUtil *cpuUtil)
 {
-    dcgmReturn_t status;
-
-    StatKey uTimeKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_CPU_UTIL_UTIME);
-    StatKey sTimeKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_CPU_UTIL_STIME);
+    double user   = .0;
+    double kernel = .0;
 
-    double cpuUtilUtime = .0;
-    double cpuUtilStime = .0;
-
-    status = getStat(uTimeKey, &cpuUtilUtime);
+    dcgmReturn_t status = m_processStats.GetCpuUtil(CPU_AVG_INTERVAL_USEC, user, kernel);
     if (DCGM_ST_OK != status)
         return status;
 
-    status = getStat(sTimeKey, &cpuUtilStime);
-    if (DCGM_ST_OK != status)
-        return status;
-
-    cpuUtil->kernel = cpuUtilStime;
-    cpuUtil->user   = cpuUtilUtime;
-    cpuUtil->total  = cpuUtilStime + cpuUtilUtime;
+    cpuUtil->kernel = kernel;
+    cpuUtil->user   = user;
+    cpuUtil->total  = kernel + user;
 
     return DCGM_ST_OK;
 }
 
+dcgmReturn_t DcgmMetadataManager::GetThreadCpuUtilization(std::vector<DcgmThreadCpuUtil> &threads,
+                                                          bool /*waitIfNoData*/)
+{
+    return m_processStats.GetThreadCpuUtil(threads);
+}
+
 dcgmReturn_t DcgmMetadataManager::UpdateAll(int waitForUpdate)
 {
     m_startOfCurUpdateLoop = timelib_usecSince1970();
@@ -1418,221 +1283,62 @@ dcgmReturn_t DcgmMetadataManager::UpdateAll(int waitForUpdate)
     return DCGM_ST_OK;
 }
 
-void DcgmMetadataManager::retrieveOSInfo()
-{
-    retrieveOSInfoFromProcSelfStatus();
-    retrieveOSInfoFromProcSelfStat();
-    retrieveOSInfoFromProcStat();
-}
-
-void DcgmMetadataManager::retrieveOSInfoFromProcSelfStatus()
-{
-    // parse /proc/self/status instead of /proc/self/stat since the swap related
-    // fields in "man proc" for /proc/self/stat say (not maintained)
-    // /status is also displayed in KB values instead of pages for RSS which is easier to use
-    std::ifstream statusStream("/proc/self/status");
-
-    long long rss = 0;
-    long long swp = 0;
-
-    std::string line;
-    while (getline(statusStream, line))
-    {
-        std::stringstream ss(line);
-        std::string first, second;
-
-        ss >> first >> second;
-
-        if (first == "VmRSS:")
-        {
-            rss = strTo<long long>(second);
-        }
-        // VmSwap shows up but is no longer documented in "man proc" so we might not always get this
-        else if (first == "VmSwap:")
-        {
-            swp = strTo<long long>(second);
-        }
-    }
-    statusStream.close();
-
-    recordStat(StatKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_VM_RSS_KB), rss);
-    recordStat(StatKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_VM_SWAP_KB), swp);
-    recordStat(StatKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_REAL_RAM_KB), rss + swp);
-}
-
-void DcgmMetadataManager::retrieveOSInfoFromProcSelfStat()
-{
-    // parse /proc/self/stat for this process's CPU usage
-    std::ifstream statStream("/proc/self/stat");
-
-    std::vector<std::string> stats;
-    std::string statVal;
-    while (statStream >> statVal)
-    {
-        stats.push_back(statVal);
-    }
-    statStream.close();
-
-    if (stats.size() <= 14)
-    {
-        PRINT_ERROR("", "could not retrieve expected fields from /proc/self/stat");
-        return;
-    }
-
-    // use indices from "man 5 proc" section "/proc/[pid]/stat" minus 1 (they start at 1 instead of 0)
-    // user and system (kernel) time of the process in clock ticks
-    unsigned long utimeProc = strTo<unsigned long>(stats.at(13));
-    unsigned long stimeProc = strTo<unsigned long>(stats.at(14));
-
-    StatKey uTimeKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_TICKS_UTIME);
-    StatKey sTimeKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_TICKS_STIME);
-    recordStat(uTimeKey, (long long)utimeProc);
-    recordStat(sTimeKey, (long long)stimeProc);
-}
-
-void DcgmMetadataManager::retrieveOSInfoFromProcStat()
+std::uint64_t DcgmMetadataManager::StatKey::packed() const
 {
-    std::ifstream sysStatStream("/proc/stat");
-    std::string line;
-
-    long long totDevTicks = 0;
-
-    while (getline(sysStatStream, line))
-    {
-        std::stringstream ss(line);
-        std::string entry;
-
-        ss >> entry;
-
-        if (entry == "cpu")
-        {
-            // sum all the different break-downs of cpu time
-            unsigned long long ticks;
-            while (ss >> ticks)
-            {
-                totDevTicks += ticks;
-            }
-        }
-    }
-    sysStatStream.close();
-
-    StatKey sKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_DEVICE_TICKS_TOTAL);
-    recordStat(sKey, totDevTicks);
+    // field group IDs are handed out sequentially, so 32 bits of contextId tell any two apart.
+    // gpuId and fieldScope only tell stats apart for GPU stats. See getStatHandle()
+    bool const gpuStat = !cKey.isGlobalStat() && cKey.isGpuStat();
+    return ((cKey.contextId & 0xffffffffULL) << 32) | ((std::uint64_t)cKey.context << 24)
+           | ((std::uint64_t)cKey.aggregate << 23) | ((std::uint64_t)gpuStat << 22)
+           | ((std::uint64_t)(gpuStat ? cKey.gpuId & 0x3fff : 0) << 8) | (std::uint64_t)mType;
 }
 
-// it is assumed that a stat lock is held when calling this function
-template <typename T>
-dcgmReturn_t DcgmMetadataManager::getFullStatDiffForType(StatKey sKey, T *dStat)
+DcgmNs::MetricHandle DcgmMetadataManager::getStatHandle(StatKey const &sKey, bool create)
 {
-    dcgmReturn_t status;
-
-    mcollect_value_p measurement = getStatMeasurement(sKey);
-
-    if (sKey.cKey.context == STAT_CONTEXT_PROCESS)
-    {
-        status = validateMcollectType(measurement, sKey.mType.process);
-    }
-    else
-    {
-        status = validateMcollectType(measurement, sKey.mType.field);
-    }
+    std::uint64_t const key = sKey.packed();
 
-    if (DCGM_ST_OK != status)
+    auto it = m_statHandles.find(key);
+    if (it != m_statHandles.end())
     {
-        return status;
+        return it->second;
     }
-
-    status = getFullStatDiff(measurement->val.tseries, dStat);
-    if (DCGM_ST_NO_DATA == status)
+    if (!create)
     {
-        PRINT_DEBUG(
-            "%s", "metadata has not been gathered for long enough to take an average for stat %s", sKey.str().c_str());
+        return DcgmNs::InvalidMetricHandle;
     }
 
-    return status;
-}
-
-mcollect_value_p DcgmMetadataManager::getStatMeasurement(StatKey sKey)
-{
+    DcgmNs::MetricScope scope;
     if (sKey.cKey.isGlobalStat())
     {
-        return m_statCollection->GetGlobalStat(sKey.str());
+        scope = DcgmNs::MetricScope::Global;
     }
     else if (sKey.cKey.isGpuStat())
     {
-        return m_statCollection->GetGpuStat(m_coreProxy->GpuIdToNvmlIndex(sKey.cKey.gpuId), sKey.str());
+        scope = DcgmNs::MetricScope::Gpu;
     }
     else
     {
-        PRINT_ERROR("%s", "%s is an invalid context", sKey.cKey.str().c_str());
-        return NULL;
+        return DcgmNs::InvalidMetricHandle;
     }
-}
-
-/**
- * Should run after "generateProcessInfo" so that required fields are gathered recently
- */
-void DcgmMetadataManager::generateCpuUtilization()
-{
-    dcgmReturn_t status;
-
-    long long dProcTicksUtime;
-    long long dProcTicksStime;
-    long long dDevTicks;
-
-    StatKey uTimeProcKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_TICKS_UTIME);
-    StatKey sTimeProcKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_TICKS_STIME);
-    StatKey totalTimeDevKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_DEVICE_TICKS_TOTAL);
 
+    unsigned int entityId = scope == DcgmNs::MetricScope::Gpu ? sKey.cKey.gpuId : 0;
+    DcgmNs::MetricHandle handle;
+    switch (metricKindForMetadataType(sKey.mType))
     {
-        status = getFullStatDiffForType(uTimeProcKey, &dProcTicksUtime);
-        if (DCGM_ST_OK != status)
-        {
-            return;
-        }
-
-        status = getFullStatDiffForType(sTimeProcKey, &dProcTicksStime);
-        if (DCGM_ST_OK != status)
-        {
-            return;
-        }
-
-        status = getFullStatDiffForType(totalTimeDevKey, &dDevTicks);
-        if (DCGM_ST_OK != status)
-        {
-            return;
-        }
-    }
-
-    if (dDevTicks == 0)
-    {
-        PRINT_ERROR("", "somehow got no change in device ticks over sampling interval");
-        return;
+        case DcgmNs::MetricKind::Counter:
+            handle = m_metrics.RegisterCounter(sKey.str(), scope, entityId);
+            break;
+        case DcgmNs::MetricKind::Histogram:
+            handle = m_metrics.RegisterHistogram(sKey.str(), ExecTimeBucketBounds(), scope, entityId);
+            break;
+        default:
+            handle = m_metrics.RegisterGauge(sKey.str(), scope, entityId);
+            break;
     }
 
-    StatKey uTimeCpuUtilKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_CPU_UTIL_UTIME);
-    StatKey sTimeCpuUtilKey(ContextKey(STAT_CONTEXT_PROCESS), PROCESS_MT_CPU_UTIL_STIME);
-
-    double recentCpuUtilUtime = (double)dProcTicksUtime / (double)dDevTicks;
-    double recentCpuUtilStime = (double)dProcTicksStime / (double)dDevTicks;
-    recordStat(uTimeCpuUtilKey, recentCpuUtilUtime);
-    recordStat(sTimeCpuUtilKey, recentCpuUtilStime);
-}
-
-/**
- * This function is a critical section for the mcollect and should be locked when called.
- */
-dcgmReturn_t DcgmMetadataManager::getFullStatDiff(timeseries_p ts, long long *diff)
-{
-    timeseries_entry_p last  = timeseries_last(ts, NULL);
-    timeseries_entry_p first = timeseries_first(ts, NULL);
-
-    if (NULL == last || NULL == first || first == last)
+    if (handle != DcgmNs::InvalidMetricHandle)
     {
-        PRINT_DEBUG("", "not enough metadata has been gathered to calculate a diff");
-        return DCGM_ST_NO_DATA;
+        m_statHandles.emplace(key, handle);
     }
-
-    *diff = last->val.i64 - first->val.i64;
-    return DCGM_ST_OK;
+    return handle;
 }
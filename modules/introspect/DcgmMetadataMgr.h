@@ -17,13 +17,16 @@
 #define _NVCM_METADATA_H
 
 #include "DcgmCoreProxy.h"
+#include "DcgmMetricRegistry.h"
 #include "DcgmMutex.h"
-#include "DcgmStatCollection.h"
+#include "DcgmProcessStats.h"
+#include <algorithm>
 #include <condition_variable>
 #include <map>
 #include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 
 /******************************************************************
@@ -110,6 +113,20 @@ public:
         // has been normalized to "frequencyUsec".
         // This is roughly how long it takes to update all specified fields every "meanFrequencyUsec"
         double recentUpdateUsec;
+
+        // the longest single update of any specified field
+        long long maxUpdateUsec;
+
+        // the number of updates of all specified fields by how long they took.
+        // See dcgmIntrospectFieldsExecTime_v3 for the bucket boundaries
+        long long updateUsecHistogram[DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
+
+        // the oldest sample of any specified field at each dcgmIntrospectLagStage_t
+        long long maxSampleLagUsec[DCGM_INTROSPECT_LAG_STAGE_COUNT];
+
+        // the number of samples of all specified fields by how old they were at each
+        // dcgmIntrospectLagStage_t. Same buckets as updateUsecHistogram
+        long long sampleLagUsecHistogram[DCGM_INTROSPECT_LAG_STAGE_COUNT][DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
     } ExecTimeInfo;
 
     explicit DcgmMetadataManager(DcgmCoreProxy *dcc);
@@ -178,6 +195,19 @@ public:
      */
     dcgmReturn_t GetCpuUtilization(CpuUtil *cpuUtil, bool waitIfNoData = true);
 
+    /*************************************************************************/
+    /**
+     * Get the CPU utilization of each thread of the DCGM host engine process
+     * over the last update interval, busiest first.
+     *
+     * threads                      OUT: Each thread. user and kernel are fractions of the device's CPU resources
+     * waitIfNoData                  IN: if no metadata is gathered wait till this occurs (!0)
+     *                                   or return DCGM_ST_NO_DATA (0)
+     * Returns: 0 on success
+     *         <0 on error. See DCGM_ST_? enums
+     */
+    dcgmReturn_t GetThreadCpuUtilization(std::vector<DcgmThreadCpuUtil> &threads, bool waitIfNoData = true);
+
     /**
      * This method is used to manually tell the the metadata manager to update all DCGM metadata.
      * This is normally performed automatically on an interval that can be set with \ref SetRunInterval.
@@ -209,25 +239,24 @@ private:
         // ex: with a field group with 2 fields, each watched on 2 gpus, this count would be 4
         FIELD_MT_AGGR_INSTANCE_COUNT,
 
+        FIELD_MT_MAX_EXEC_TIME_USEC,
+
+        // the field instances' execution time histogram. DCGM_INTROSPECT_EXEC_TIME_BUCKETS buckets
+        FIELD_MT_EXEC_TIME_HISTOGRAM,
+
+        // the oldest sample of the field instances at each dcgmIntrospectLagStage_t
+        FIELD_MT_MAX_SAMPLE_LAG_USEC_FIRST,
+        FIELD_MT_MAX_SAMPLE_LAG_USEC_LAST = FIELD_MT_MAX_SAMPLE_LAG_USEC_FIRST + DCGM_INTROSPECT_LAG_STAGE_COUNT - 1,
+
+        // the field instances' sample age histogram at each dcgmIntrospectLagStage_t.
+        // DCGM_INTROSPECT_EXEC_TIME_BUCKETS buckets each
+        FIELD_MT_SAMPLE_LAG_HISTOGRAM_FIRST,
+        FIELD_MT_SAMPLE_LAG_HISTOGRAM_LAST = FIELD_MT_SAMPLE_LAG_HISTOGRAM_FIRST + DCGM_INTROSPECT_LAG_STAGE_COUNT - 1,
+
         FIELD_MT_COUNT,
     };
     static const std::string FIELD_METADATA_TYPE_STRINGS[FIELD_MT_COUNT];
 
-    enum ProcessMetadataType
-    {
-        PROCESS_MT_VM_RSS_KB = 0,
-        PROCESS_MT_VM_SWAP_KB,
-        PROCESS_MT_REAL_RAM_KB,
-        PROCESS_MT_TICKS_UTIME,
-        PROCESS_MT_TICKS_STIME,
-        PROCESS_MT_DEVICE_TICKS_TOTAL,
-        PROCESS_MT_CPU_UTIL_UTIME,
-        PROCESS_MT_CPU_UTIL_STIME,
-
-        PROCESS_MT_COUNT,
-    };
-    static const std::string PROCESS_METADATA_TYPE_STRINGS[PROCESS_MT_COUNT];
-
     /*************************************************************************/
     /*
      * Execute function (usually a functor) for each GPU field that is currently watched.
@@ -320,41 +349,27 @@ private:
     dcgmReturn_t ForEachWatchedField(std::vector<Fn *> const &callbackFns,
                                      std::vector<unsigned short> *fieldIds = nullptr);
 
-    // A key that uniquely identifies a metadata stat in a stat collection.
-    // it can be translated into the string key that the stat collection uses.
+    // A key that uniquely identifies a metadata stat in the metric registry.
+    // str() is the name the stat is registered under.
     class StatKey
     {
     public:
         ContextKey cKey;
-        union _mType
-        {
-            FieldMetadataType field;
-            ProcessMetadataType process;
-
-            _mType(FieldMetadataType field)
-                : field(field) {};
-            _mType(ProcessMetadataType process)
-                : process(process) {};
-        } mType;
+        FieldMetadataType mType;
 
-        template <typename MetadataType>
-        StatKey(ContextKey cKey, MetadataType mType)
+        StatKey(ContextKey cKey, FieldMetadataType mType)
             : cKey(cKey)
             , mType(mType)
         {}
         std::string str() const;
+
+        // Pack everything that tells stats apart in the registry into one integer for m_statHandles
+        std::uint64_t packed() const;
     };
 
     /* constants */
     static const timelib64_t CPU_AVG_INTERVAL_USEC = 1000000; // 1 second, interval to average CPU utilization
 
-    // how many pieces of a single metadata type we should store.
-    // 1 = only present value, 2 = 1 past, 1 present, etc
-    static const unsigned int DEFAULT_MAX_KEEP_ENTRIES = 2;
-
-    // by default, don't limit metadata storage by timestamp.  Rely on count instead.
-    static const unsigned int DEFAULT_OLDEST_KEEP_TIMESTAMP = 0;
-
     /* variables */
     unsigned int m_runIntervalMs; // how often to wait between cycles of metadata gathering
     bool m_currentlyUpdating;     // set to true when an update loop is occuring and false when the
@@ -365,15 +380,12 @@ private:
 
     timelib64_t m_startOfCurUpdateLoop;
 
-    // If a metadata type should store more than the default entries we store it here.
-    // storing more metadata is needed for some fields that are used to calculate averages
-    std::map<ProcessMetadataType, timelib64_t> m_processTypeToOldestKeepTimestamp;
-    std::map<ProcessMetadataType, int> m_processTypeToMaxKeepEntries;
-    std::map<FieldMetadataType, timelib64_t> m_fieldTypeToOldestKeepTimestamp;
-    std::map<FieldMetadataType, int> m_fieldTypeToMaxKeepEntries;
-
     DcgmCoreProxy *m_coreProxy; /* Cached pointer to the core proxy manager. Not owned by this class */
-    DcgmStatCollection *m_statCollection;
+
+    // Every metadata stat. Each keeps its latest and previous value
+    DcgmNs::MetricRegistry m_metrics;
+    std::unordered_map<std::uint64_t, DcgmNs::MetricHandle> m_statHandles; // StatKey::packed() -> handle
+    DcgmProcessStats m_processStats; /* Memory and CPU use of the host engine and its threads */
 
     // the functors that are used for performing aggregations
     // they will be executed in the same order that they are in this vector so
@@ -384,10 +396,14 @@ private:
     /* functions */
 
     dcgmReturn_t getCpuUtilizationForHostengine(CpuUtil *cpuUtil);
-    dcgmReturn_t getHostengineBytesUsed(ContextKey context, long long *bytesUsed, bool waitIfNoData);
+    dcgmReturn_t getHostengineBytesUsed(long long *bytesUsed, bool waitIfNoData);
     dcgmReturn_t getFieldStatBytesUsed(ContextKey context, long long *bytesUsed, bool waitIfNoData);
 
-    mcollect_value_p getStatMeasurement(StatKey sKey);
+    /**
+     * Handle of the stat in m_metrics. Registers the stat if create is true and it is not registered yet.
+     * Returns DcgmNs::InvalidMetricHandle if the stat is not registered or the context cannot hold stats
+     */
+    DcgmNs::MetricHandle getStatHandle(StatKey const &sKey, bool create);
 
     // same as "getStat" but returns DCGM_ST_STALE_DATA if the stat trying to be retrieved
     // hasn't been updated since the start of the last update loop.  This is useful in making
@@ -401,11 +417,10 @@ private:
     template <typename T>
     dcgmReturn_t recordStat(StatKey sKey, const T &val);
 
-    timelib64_t getOldestKeepTimestamp(ProcessMetadataType mType);
-    timelib64_t getOldestKeepTimestamp(FieldMetadataType mType);
-
-    int getMaxKeepEntries(ProcessMetadataType mType);
-    int getMaxKeepEntries(FieldMetadataType mType);
+    // same as getStat and recordStat for FIELD_MT_EXEC_TIME_HISTOGRAM and FIELD_MT_SAMPLE_LAG_HISTOGRAM_*.
+    // buckets has DCGM_INTROSPECT_EXEC_TIME_BUCKETS entries
+    dcgmReturn_t getStatBuckets(StatKey sKey, long long *buckets, bool recentOnly);
+    dcgmReturn_t recordStatBuckets(StatKey sKey, long long const *buckets);
 
     /**
      * returns true if the context can be used to identify a stat
@@ -426,6 +441,7 @@ private:
      * Methods used for updating the metadata stat collection that are run from the main update loop
      */
     void retrieveFieldInstanceData();
+    void recordFieldHistograms(ContextKey const &context, dcgmCoreWatchInfo_t const &field);
     void postProcessFieldInstanceData();
 
     void aggregateFieldData();
@@ -542,12 +558,6 @@ private:
     void retrieveFieldTotalExecTimeInfo();
     void retrieveFieldFetchCountInfo();
 
-    // all private methods with prefix "retrieve" populate metadata without using existing metadata
-    void retrieveOSInfo();
-    void retrieveOSInfoFromProcSelfStatus();
-    void retrieveOSInfoFromProcSelfStat();
-    void retrieveOSInfoFromProcStat();
-
     // uses the total execution time of a field
     void generateFieldAvgExecTimeInfo();
     dcgmReturn_t generateAvgExecTimeForGlobalField(dcgm_field_meta_p fieldMeta, long long *fieldAvgExecTime);
@@ -557,34 +567,10 @@ private:
 
     dcgmReturn_t generateFieldRecentUpdateTime(unsigned short fieldId, unsigned int gpuId, int scope);
 
-    void generateCpuUtilization();
-
     /**
-     * Return the type that all measurement collections for the given metadata type should have
+     * Return the kind of metric that stats of the given metadata type are stored as
      */
-    int mcollectTypeForMetadataType(FieldMetadataType mType) const;
-    int mcollectTypeForMetadataType(ProcessMetadataType mType) const;
-
-    /**
-     * mType is something that maps to a MC_TYPE_? define via \ref mcollectTypeForMetadataType
-     */
-    template <typename MetadataType>
-    dcgmReturn_t validateMcollectType(mcollect_value_p measurement, MetadataType mType);
-
-    /*
-     * Given a timeseries, get the diff from the second last value to the last value.
-     * Returns DCGM_ST_NO_DATA when there is not at least two values in the timeseries.
-     */
-    static dcgmReturn_t getRecentStatDiff(timeseries_p ts, long long *diff);
-
-    /*
-     * Get the diff from the first value to the last value of a timeseries
-     * Returns DCGM_ST_NO_DATA when there is not at least two values in the timeseries.
-     */
-    static dcgmReturn_t getFullStatDiff(timeseries_p ts, long long *diff);
-
-    template <typename T>
-    dcgmReturn_t getFullStatDiffForType(StatKey sKey, T *dStat);
+    static DcgmNs::MetricKind metricKindForMetadataType(FieldMetadataType mType);
 
 
     template <typename StatT, typename NormT, typename RetT>
@@ -593,10 +579,6 @@ private:
                                          const StatKey &normToStatKey,
                                          RetT *normalizedStat);
 
-
-    template <typename MetadataType>
-    void extractTimeseriesVal(void *val, timeseries_entry_p tsVal, MetadataType mType);
-
     /******************************************************************
      * Functors for aggregating
      ******************************************************************/
@@ -772,6 +754,109 @@ private:
         unsigned int count;
     };
 
+    /**
+     * Keep the largest "mType" of all the aggregated contexts
+     */
+    template <typename ValType>
+    class AggregateMaxFunctor : public AggregateSumFunctor<ValType>
+    {
+    public:
+        AggregateMaxFunctor(DcgmMetadataManager *mm, FieldMetadataType mType)
+            : AggregateSumFunctor<ValType>(mm, mType)
+        {}
+
+        dcgmReturn_t operator()(ContextKey cKey)
+        {
+            // fail early if any previous iteration failed
+            if (this->wasCalled && DCGM_ST_OK != this->status)
+                return this->status;
+
+            this->wasCalled = true;
+
+            ValType metadata;
+            this->status = this->mm->getRecentStat(StatKey(cKey, this->mType), &metadata);
+            if (DCGM_ST_OK != this->status)
+            {
+                return this->status;
+            }
+
+            this->total = std::max(this->total, metadata);
+            return this->status;
+        }
+    };
+
+    /**
+     * Sum the buckets of histogram "mType" of all the aggregated contexts
+     */
+    class AggregateHistogramSumFunctor : public AggregateFunctor
+    {
+    public:
+        AggregateHistogramSumFunctor(DcgmMetadataManager *mm, FieldMetadataType mType)
+            : mm(mm)
+            , mType(mType)
+        {
+            reset();
+        }
+
+        virtual dcgmReturn_t operator()(ContextKey cKey)
+        {
+            // fail early if any previous iteration failed
+            if (wasCalled && DCGM_ST_OK != status)
+                return status;
+
+            wasCalled = true;
+
+            long long buckets[DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
+            status = mm->getStatBuckets(StatKey(cKey, mType), buckets, true);
+            if (DCGM_ST_OK != status)
+            {
+                return status;
+            }
+
+            for (int i = 0; i < DCGM_INTROSPECT_EXEC_TIME_BUCKETS; i++)
+            {
+                total[i] += buckets[i];
+            }
+            return status;
+        }
+
+        virtual void reset()
+        {
+            status    = DCGM_ST_NO_DATA;
+            wasCalled = false;
+            std::fill(std::begin(total), std::end(total), 0);
+        }
+
+        virtual dcgmReturn_t recordIfOkay()
+        {
+            if (this->m_storageContext == ContextKey())
+            {
+                PRINT_ERROR("", "aggregation was never initialized");
+                return DCGM_ST_UNINITIALIZED;
+            }
+
+            // see AggregateSumFunctor::recordIfOkay
+            if (!wasCalled)
+            {
+                return DCGM_ST_OK;
+            }
+
+            if (DCGM_ST_OK != status)
+            {
+                return status;
+            }
+
+            return mm->recordStatBuckets(StatKey(this->m_storageContext, mType), total);
+        }
+
+    private:
+        DcgmMetadataManager *mm;
+        FieldMetadataType mType;
+        long long total[DCGM_INTROSPECT_EXEC_TIME_BUCKETS];
+        dcgmReturn_t status;
+        bool wasCalled;
+    };
+
     /**
      * Calculate a normalized sum of all "mType" of a field where each stored instance of "mType"
      * is first normalized to "normalizeTo" based on that instance's "normalizeWithMType".
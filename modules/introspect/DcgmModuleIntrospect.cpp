@@ -15,14 +15,18 @@
  */
 #include "DcgmModuleIntrospect.h"
 #include "DcgmLogging.h"
+#include "DcgmStringHelpers.h"
 #include "DcgmTaskRunner.h"
 #include "TaskRunner.hpp"
 #include "dcgm_introspect_structs.h"
 #include "dcgm_structs.h"
 #include <dcgm_api_export.h>
 
+#include <algorithm>
+#include <cstring>
 #include <exception>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <tuple>
 
@@ -31,10 +35,16 @@ const unsigned int DcgmModuleIntrospect::DEFAULT_RUN_INTERVAL_MS = 1000;
 /*****************************************************************************/
 DcgmModuleIntrospect::DcgmModuleIntrospect(dcgmCoreCallbacks_t &dcc)
     : DcgmModuleWithCoreProxy(dcc)
-    , DcgmTaskRunner()
+    , DcgmTaskRunner(DcgmNs::TaskQueueKind::LockFree)
     , mpMetadataManager {}
 {
     SetRunInterval(std::chrono::milliseconds(DEFAULT_RUN_INTERVAL_MS));
+    EnqueueEvery(std::chrono::milliseconds(DEFAULT_RUN_INTERVAL_MS), [this] {
+        if (mpMetadataManager)
+        {
+            mpMetadataManager->UpdateAll(0);
+        }
+    });
 
     IF_LOG_(BASE_LOGGER, plog::debug)
     {
@@ -59,10 +69,6 @@ void DcgmModuleIntrospect::run()
         {
             break;
         }
-        if (mpMetadataManager)
-        {
-            mpMetadataManager->UpdateAll(0);
-        }
     }
 }
 
@@ -216,7 +222,7 @@ std::optional<dcgmReturn_t> DcgmModuleIntrospect::GetExecTimeForFields(dcgmIntro
 
     // get aggregate info
     DcgmMetadataManager::ContextKey aggrContext(statContext, context->contextId, true);
-    DcgmMetadataManager::ExecTimeInfo aggrExecTime;
+    DcgmMetadataManager::ExecTimeInfo aggrExecTime {};
 
     st = mpMetadataManager->GetExecTime(aggrContext, &aggrExecTime, waitIfNoData);
     if (DCGM_ST_NO_DATA == st && waitIfNoData)
@@ -235,7 +241,7 @@ std::optional<dcgmReturn_t> DcgmModuleIntrospect::GetExecTimeForFields(dcgmIntro
     if (statContext != DcgmMetadataManager::STAT_CONTEXT_FIELD || (fieldScope == DCGM_FS_GLOBAL))
     {
         DcgmMetadataManager::ContextKey globalContext(statContext, context->contextId, false, DCGM_FS_GLOBAL);
-        DcgmMetadataManager::ExecTimeInfo globalExecTime;
+        DcgmMetadataManager::ExecTimeInfo globalExecTime {};
 
         st = mpMetadataManager->GetExecTime(globalContext, &globalExecTime, waitIfNoData);
 
@@ -259,7 +265,7 @@ std::optional<dcgmReturn_t> DcgmModuleIntrospect::GetExecTimeForFields(dcgmIntro
         {
             unsigned int gpuId = gpuIds.at(i);
             DcgmMetadataManager::ContextKey gpuContext(statContext, context->contextId, false, DCGM_FS_DEVICE, gpuId);
-            DcgmMetadataManager::ExecTimeInfo gpuExecTime;
+            DcgmMetadataManager::ExecTimeInfo gpuExecTime {};
 
             st = mpMetadataManager->GetExecTime(gpuContext, &gpuExecTime, waitIfNoData);
 
@@ -318,26 +324,79 @@ std::optional<dcgmReturn_t> DcgmModuleIntrospect::GetCpuUtilizationForHostengine
     return DCGM_ST_OK;
 }
 
+std::optional<dcgmReturn_t> DcgmModuleIntrospect::GetThreadCpuUtilizationForHostengine(
+    dcgmIntrospectThreadCpuUtil_t *cpuUtil,
+    int waitIfNoData)
+{
+    std::vector<DcgmThreadCpuUtil> threads;
+    dcgmReturn_t st = mpMetadataManager->GetThreadCpuUtilization(threads, waitIfNoData);
+
+    if (DCGM_ST_NO_DATA == st && waitIfNoData)
+    {
+        return std::nullopt;
+    }
+
+    if (DCGM_ST_OK != st)
+    {
+        return st;
+    }
+
+    cpuUtil->numThreads  = std::min<size_t>(threads.size(), DCGM_INTROSPECT_MAX_THREADS);
+    cpuUtil->moreThreads = threads.size() > DCGM_INTROSPECT_MAX_THREADS ? 1 : 0;
+
+    for (unsigned int i = 0; i < cpuUtil->numThreads; i++)
+    {
+        dcgmIntrospectThreadCpuUtilEntry_t &entry = cpuUtil->threads[i];
+
+        entry.tid = threads[i].tid;
+        SafeCopyTo(entry.name, threads[i].name.c_str());
+        entry.kernel = threads[i].kernel;
+        entry.user   = threads[i].user;
+        entry.total  = threads[i].kernel + threads[i].user;
+    }
+
+    return DCGM_ST_OK;
+}
+
 void DcgmModuleIntrospect::CopyFieldsExecTime(dcgmIntrospectFieldsExecTime_t &execTime,
                                               const DcgmMetadataManager::ExecTimeInfo &metadataExecTime)
 {
     execTime.meanUpdateFreqUsec  = metadataExecTime.meanFrequencyUsec;
     execTime.recentUpdateUsec    = metadataExecTime.recentUpdateUsec;
     execTime.totalEverUpdateUsec = metadataExecTime.totalEverUpdateUsec;
+    execTime.maxUpdateUsec       = metadataExecTime.maxUpdateUsec;
+    memcpy(execTime.updateUsecHistogram, metadataExecTime.updateUsecHistogram, sizeof(execTime.updateUsecHistogram));
+    memcpy(execTime.maxSampleLagUsec, metadataExecTime.maxSampleLagUsec, sizeof(execTime.maxSampleLagUsec));
+    memcpy(execTime.sampleLagUsecHistogram,
+           metadataExecTime.sampleLagUsecHistogram,
+           sizeof(execTime.sampleLagUsecHistogram));
 }
 
 /*****************************************************************************/
 std::optional<dcgmReturn_t> DcgmModuleIntrospect::ProcessMetadataFieldsExecTime(
-    dcgm_introspect_msg_fields_exec_time_t *msg)
+    dcgm_module_command_header_t *moduleCommand)
 {
     dcgmReturn_t dcgmReturn = VerifyMetadataEnabled();
     if (DCGM_ST_OK != dcgmReturn)
         return dcgmReturn;
 
-    dcgmReturn = CheckVersion(&msg->header, dcgm_introspect_msg_fields_exec_time_version);
+    if (moduleCommand->version == dcgm_introspect_msg_fields_exec_time_version1)
+    {
+        return ProcessOlderMetadataFieldsExecTime((dcgm_introspect_msg_fields_exec_time_v1 *)moduleCommand,
+                                                  dcgmIntrospectFullFieldsExecTime_version2);
+    }
+    if (moduleCommand->version == dcgm_introspect_msg_fields_exec_time_version2)
+    {
+        return ProcessOlderMetadataFieldsExecTime((dcgm_introspect_msg_fields_exec_time_v2 *)moduleCommand,
+                                                  dcgmIntrospectFullFieldsExecTime_version3);
+    }
+
+    dcgmReturn = CheckVersion(moduleCommand, dcgm_introspect_msg_fields_exec_time_version);
     if (DCGM_ST_OK != dcgmReturn)
         return dcgmReturn; /* Logging handled by helper method */
 
+    auto *msg = (dcgm_introspect_msg_fields_exec_time_t *)moduleCommand;
+
     if (msg->execTime.version != dcgmIntrospectFullFieldsExecTime_version)
     {
         PRINT_WARNING("%d %d",
@@ -350,6 +409,39 @@ std::optional<dcgmReturn_t> DcgmModuleIntrospect::ProcessMetadataFieldsExecTime(
     return GetExecTimeForFields(&msg->context, &msg->execTime, msg->waitIfNoData);
 }
 
+/*****************************************************************************/
+template <typename MsgT>
+std::optional<dcgmReturn_t> DcgmModuleIntrospect::ProcessOlderMetadataFieldsExecTime(MsgT *msg,
+                                                                                     unsigned int execTimeVersion)
+{
+    if (msg->execTime.version != execTimeVersion)
+    {
+        PRINT_WARNING(
+            "%d %d", "Version mismatch. expected %d. Got %d", execTimeVersion, msg->execTime.version);
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    auto execTime     = std::make_unique<dcgmIntrospectFullFieldsExecTime_t>();
+    execTime->version = dcgmIntrospectFullFieldsExecTime_version;
+
+    std::optional<dcgmReturn_t> ret = GetExecTimeForFields(&msg->context, execTime.get(), msg->waitIfNoData);
+    if (!ret.has_value() || *ret != DCGM_ST_OK)
+        return ret;
+
+    /* Each version of dcgmIntrospectFieldsExecTime only appended fields, so older ones are a prefix of the latest */
+    memcpy(&msg->execTime.aggregateInfo, &execTime->aggregateInfo, sizeof(msg->execTime.aggregateInfo));
+    msg->execTime.hasGlobalInfo = execTime->hasGlobalInfo;
+    memcpy(&msg->execTime.globalInfo, &execTime->globalInfo, sizeof(msg->execTime.globalInfo));
+    msg->execTime.gpuInfoCount = execTime->gpuInfoCount;
+    memcpy(msg->execTime.gpuIdsForGpuInfo, execTime->gpuIdsForGpuInfo, sizeof(msg->execTime.gpuIdsForGpuInfo));
+    for (unsigned int i = 0; i < DCGM_MAX_NUM_DEVICES; i++)
+    {
+        memcpy(&msg->execTime.gpuInfo[i], &execTime->gpuInfo[i], sizeof(msg->execTime.gpuInfo[i]));
+    }
+
+    return DCGM_ST_OK;
+}
+
 /*****************************************************************************/
 std::optional<dcgmReturn_t> DcgmModuleIntrospect::ProcessMetadataFieldsMemUsage(
     dcgm_introspect_msg_fields_mem_usage_t *msg)
@@ -400,6 +492,32 @@ std::optional<dcgmReturn_t> DcgmModuleIntrospect::ProcessMetadataHostEngineCpuUt
     return GetCpuUtilizationForHostengine(&msg->cpuUtil, msg->waitIfNoData);
 }
 
+/*****************************************************************************/
+std::optional<dcgmReturn_t> DcgmModuleIntrospect::ProcessMetadataHostEngineThreadCpuUtil(
+    dcgm_introspect_msg_he_thread_cpu_util_t *msg)
+{
+    dcgmReturn_t dcgmReturn = VerifyMetadataEnabled();
+    if (DCGM_ST_OK != dcgmReturn)
+    {
+        return dcgmReturn;
+    }
+
+    dcgmReturn = CheckVersion(&msg->header, dcgm_introspect_msg_he_thread_cpu_util_version);
+    if (DCGM_ST_OK != dcgmReturn)
+    {
+        return dcgmReturn; /* Logging handled by helper method */
+    }
+
+    if (msg->cpuUtil.version != dcgmIntrospectThreadCpuUtil_version)
+    {
+        DCGM_LOG_WARNING << "Version mismatch. expected " << dcgmIntrospectThreadCpuUtil_version << ". Got "
+                         << msg->cpuUtil.version;
+        return DCGM_ST_VER_MISMATCH;
+    }
+
+    return GetThreadCpuUtilizationForHostengine(&msg->cpuUtil, msg->waitIfNoData);
+}
+
 /*****************************************************************************/
 std::optional<dcgmReturn_t> DcgmModuleIntrospect::ProcessMetadataHostEngineMemUsage(
     dcgm_introspect_msg_he_mem_usage_t *msg)
@@ -618,6 +736,13 @@ dcgmReturn_t DcgmModuleIntrospect::ProcessMessage(dcgm_module_command_header_t *
                 });
                 break;
 
+            case DCGM_INTROSPECT_SR_HOSTENGINE_THREAD_CPU_UTIL:
+                retSt = ProcessInTaskRunnerWithAttempts(5, [this, moduleCommand]() mutable {
+                    return ProcessMetadataHostEngineThreadCpuUtil(
+                        (dcgm_introspect_msg_he_thread_cpu_util_t *)moduleCommand);
+                });
+                break;
+
             case DCGM_INTROSPECT_SR_FIELDS_MEM_USAGE:
                 retSt = ProcessInTaskRunnerWithAttempts(5, [this, moduleCommand]() mutable {
                     return ProcessMetadataFieldsMemUsage((dcgm_introspect_msg_fields_mem_usage_t *)moduleCommand);
@@ -626,7 +751,7 @@ dcgmReturn_t DcgmModuleIntrospect::ProcessMessage(dcgm_module_command_header_t *
 
             case DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME:
                 retSt = ProcessInTaskRunnerWithAttempts(5, [this, moduleCommand]() mutable {
-                    return ProcessMetadataFieldsExecTime((dcgm_introspect_msg_fields_exec_time_t *)moduleCommand);
+                    return ProcessMetadataFieldsExecTime(moduleCommand);
                 });
                 break;
 
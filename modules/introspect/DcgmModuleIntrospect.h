@@ -60,6 +60,8 @@ private:
                                                      int waitIfNoData);
     std::optional<dcgmReturn_t> GetMemUsageForHostengine(dcgmIntrospectMemory_t *memInfo, int waitIfNoData);
     std::optional<dcgmReturn_t> GetCpuUtilizationForHostengine(dcgmIntrospectCpuUtil_t *cpuUtil, int waitIfNoData);
+    std::optional<dcgmReturn_t> GetThreadCpuUtilizationForHostengine(dcgmIntrospectThreadCpuUtil_t *cpuUtil,
+                                                                      int waitIfNoData);
 
     void CopyFieldsExecTime(dcgmIntrospectFieldsExecTime_t &execTime,
                             const DcgmMetadataManager::ExecTimeInfo &metadataExecTime);
@@ -67,10 +69,13 @@ private:
     /*************************************************************************/
     /* Subrequest helpers
      */
-    std::optional<dcgmReturn_t> ProcessMetadataFieldsExecTime(dcgm_introspect_msg_fields_exec_time_t *msg);
+    std::optional<dcgmReturn_t> ProcessMetadataFieldsExecTime(dcgm_module_command_header_t *moduleCommand);
+    template <typename MsgT>
+    std::optional<dcgmReturn_t> ProcessOlderMetadataFieldsExecTime(MsgT *msg, unsigned int execTimeVersion);
     std::optional<dcgmReturn_t> ProcessMetadataFieldsMemUsage(dcgm_introspect_msg_fields_mem_usage_t *msg);
     std::optional<dcgmReturn_t> ProcessMetadataHostEngineCpuUtil(dcgm_introspect_msg_he_cpu_util_t *msg);
     std::optional<dcgmReturn_t> ProcessMetadataHostEngineMemUsage(dcgm_introspect_msg_he_mem_usage_t *msg);
+    std::optional<dcgmReturn_t> ProcessMetadataHostEngineThreadCpuUtil(dcgm_introspect_msg_he_thread_cpu_util_t *msg);
 
     dcgmReturn_t ProcessMetadataStateSetRunInterval(dcgm_introspect_msg_set_interval_t *msg);
     dcgmReturn_t ProcessMetadataStateToggle(dcgm_introspect_msg_toggle_t *msg);
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmProcessStats.h"
+#include "DcgmLogging.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+
+/*****************************************************************************/
+void DcgmProcessStats::Update()
+{
+    DcgmProcessSample sample {};
+    std::vector<DcgmThreadTicks> threads;
+
+    sample.timestamp = timelib_usecSince1970();
+    ReadProcSelfStatus(sample);
+    ReadProcSelfStat(sample);
+    ReadProcStat(sample);
+    ReadThreads(threads);
+
+    Record(sample, threads);
+}
+
+/*****************************************************************************/
+void DcgmProcessStats::Record(DcgmProcessSample const &sample, std::vector<DcgmThreadTicks> const &threads)
+{
+    m_threadUtil.clear();
+
+    long long dDevTicks = m_count > 0 ? sample.deviceTicks - GetSample(0).deviceTicks : 0;
+    if (dDevTicks > 0)
+    {
+        m_threadUtil.reserve(threads.size());
+        for (auto const &thread : threads)
+        {
+            /* Threads that started since the previous sample used all of their ticks since then */
+            DcgmThreadTicks previous {};
+            auto it = m_lastThreadTicks.find(thread.tid);
+            if (it != m_lastThreadTicks.end())
+            {
+                previous = it->second;
+            }
+
+            DcgmThreadCpuUtil util {};
+            util.tid    = thread.tid;
+            util.name   = thread.name;
+            util.user   = (double)std::max(0LL, thread.utimeTicks - previous.utimeTicks) / (double)dDevTicks;
+            util.kernel = (double)std::max(0LL, thread.stimeTicks - previous.stimeTicks) / (double)dDevTicks;
+            m_threadUtil.push_back(std::move(util));
+        }
+
+        std::sort(m_threadUtil.begin(), m_threadUtil.end(), [](auto const &a, auto const &b) {
+            return a.user + a.kernel > b.user + b.kernel;
+        });
+    }
+
+    m_lastThreadTicks.clear();
+    for (auto const &thread : threads)
+    {
+        m_lastThreadTicks[thread.tid] = thread;
+    }
+
+    m_samples[m_next] = sample;
+    m_next            = (m_next + 1) % CAPACITY;
+    m_count           = std::min(m_count + 1, CAPACITY);
+}
+
+/*****************************************************************************/
+DcgmProcessSample const &DcgmProcessStats::GetSample(unsigned int i) const
+{
+    return m_samples[(m_next + CAPACITY - 1 - i) % CAPACITY];
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmProcessStats::GetLatest(DcgmProcessSample &sample) const
+{
+    if (m_count == 0)
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    sample = GetSample(0);
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmProcessStats::GetCpuUtil(timelib64_t intervalUsec, double &user, double &kernel) const
+{
+    if (m_count < 2)
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    DcgmProcessSample const &latest = GetSample(0);
+
+    /* The oldest sample within intervalUsec of the latest, or the one before the latest */
+    unsigned int oldest = 1;
+    while (oldest + 1 < m_count && GetSample(oldest + 1).timestamp >= latest.timestamp - intervalUsec)
+    {
+        oldest++;
+    }
+    DcgmProcessSample const &first = GetSample(oldest);
+
+    long long dDevTicks = latest.deviceTicks - first.deviceTicks;
+    if (dDevTicks <= 0)
+    {
+        DCGM_LOG_ERROR << "Got no change in device ticks over the sampling interval";
+        return DCGM_ST_NO_DATA;
+    }
+
+    user   = (double)(latest.utimeTicks - first.utimeTicks) / (double)dDevTicks;
+    kernel = (double)(latest.stimeTicks - first.stimeTicks) / (double)dDevTicks;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmProcessStats::GetThreadCpuUtil(std::vector<DcgmThreadCpuUtil> &threads) const
+{
+    if (m_count < 2 || m_threadUtil.empty())
+    {
+        return DCGM_ST_NO_DATA;
+    }
+
+    threads = m_threadUtil;
+    return DCGM_ST_OK;
+}
+
+/*****************************************************************************/
+bool DcgmProcessStats::ParseStatLine(std::string const &line, DcgmThreadTicks &ticks)
+{
+    size_t open  = line.find('(');
+    size_t close = line.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close < open)
+    {
+        return false;
+    }
+
+    ticks.tid  = strtoul(line.c_str(), nullptr, 10);
+    ticks.name = line.substr(open + 1, close - open - 1);
+
+    /* See "man 5 proc". Field 3 (state) follows the name. utime and stime are fields 14 and 15 */
+    std::stringstream ss(line.substr(close + 1));
+    std::string field;
+    for (int fieldIndex = 3; fieldIndex <= 15; fieldIndex++)
+    {
+        if (!(ss >> field))
+        {
+            return false;
+        }
+
+        if (fieldIndex == 14)
+        {
+            ticks.utimeTicks = strtoll(field.c_str(), nullptr, 10);
+        }
+        else if (fieldIndex == 15)
+        {
+            ticks.stimeTicks = strtoll(field.c_str(), nullptr, 10);
+        }
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+void DcgmProcessStats::ReadProcSelfStatus(DcgmProcessSample &sample)
+{
+    // parse /proc/self/status instead of /proc/self/stat since the swap related
+    // fields in "man proc" for /proc/self/stat say (not maintained)
+    // /status is also displayed in KB values instead of pages for RSS which is easier to use
+    std::ifstream statusStream("/proc/self/status");
+
+    std::string line;
+    while (getline(statusStream, line))
+    {
+        std::stringstream ss(line);
+        std::string first, second;
+
+        ss >> first >> second;
+
+        if (first == "VmRSS:")
+        {
+            sample.rssKb = strtoll(second.c_str(), nullptr, 10);
+        }
+        // VmSwap shows up but is no longer documented in "man proc" so we might not always get this
+        else if (first == "VmSwap:")
+        {
+            sample.swapKb = strtoll(second.c_str(), nullptr, 10);
+        }
+    }
+}
+
+/*****************************************************************************/
+void DcgmProcessStats::ReadProcSelfStat(DcgmProcessSample &sample)
+{
+    std::ifstream statStream("/proc/self/stat");
+    std::string line;
+    DcgmThreadTicks ticks;
+
+    if (!getline(statStream, line) || !ParseStatLine(line, ticks))
+    {
+        DCGM_LOG_ERROR << "Could not retrieve expected fields from /proc/self/stat";
+        return;
+    }
+
+    sample.utimeTicks = ticks.utimeTicks;
+    sample.stimeTicks = ticks.stimeTicks;
+}
+
+/*****************************************************************************/
+void DcgmProcessStats::ReadProcStat(DcgmProcessSample &sample)
+{
+    std::ifstream sysStatStream("/proc/stat");
+    std::string line;
+
+    while (getline(sysStatStream, line))
+    {
+        std::stringstream ss(line);
+        std::string entry;
+
+        ss >> entry;
+
+        if (entry == "cpu")
+        {
+            // sum all the different break-downs of cpu time
+            unsigned long long ticks;
+            while (ss >> ticks)
+            {
+                sample.deviceTicks += ticks;
+            }
+            break;
+        }
+    }
+}
+
+/*****************************************************************************/
+void DcgmProcessStats::ReadThreads(std::vector<DcgmThreadTicks> &threads)
+{
+    DIR *taskDir = opendir("/proc/self/task");
+    if (taskDir == nullptr)
+    {
+        DCGM_LOG_ERROR << "Could not open /proc/self/task";
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(taskDir)) != nullptr)
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        /* Threads can exit while we're reading */
+        std::ifstream statStream(std::string("/proc/self/task/") + entry->d_name + "/stat");
+        std::string line;
+        DcgmThreadTicks ticks;
+        if (getline(statStream, line) && ParseStatLine(line, ticks))
+        {
+            threads.push_back(std::move(ticks));
+        }
+    }
+
+    closedir(taskDir);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef DCGMPROCESSSTATS_H
+#define DCGMPROCESSSTATS_H
+
+#include "dcgm_structs.h"
+#include "timelib.h"
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* One reading of the host engine process. See DcgmProcessStats */
+struct DcgmProcessSample
+{
+    timelib64_t timestamp = 0;
+    long long rssKb       = 0;
+    long long swapKb      = 0;
+    long long utimeTicks  = 0; /* User time of the process */
+    long long stimeTicks  = 0; /* Kernel time of the process */
+    long long deviceTicks = 0; /* Time of all CPUs of the machine */
+};
+
+/* CPU time one thread of the host engine has used so far */
+struct DcgmThreadTicks
+{
+    unsigned int tid = 0;
+    std::string name; /* As set with pthread_setname_np(), like cache_mgr_main */
+    long long utimeTicks = 0;
+    long long stimeTicks = 0;
+};
+
+/* Share of the machine's CPU time that one thread of the host engine used between the last two samples */
+struct DcgmThreadCpuUtil
+{
+    unsigned int tid = 0;
+    std::string name;
+    double user   = 0.0;
+    double kernel = 0.0;
+};
+
+/*
+ * Memory and CPU use of the host engine process and of each of its threads.
+ *
+ * Samples are kept in a fixed-size ring, so recording one neither allocates
+ * nor looks anything up by name. Per-thread CPU use is worked out as samples
+ * are recorded, from the ticks each thread gained since the previous sample.
+ * Not thread safe. The introspect module only uses it from its task runner.
+ */
+class DcgmProcessStats
+{
+public:
+    static constexpr unsigned int CAPACITY = 64;
+
+    /* Read /proc for the process and its threads and record a sample */
+    void Update();
+
+    /*************************************************************************/
+    /*
+     * Record a sample and the ticks of each thread at the time of the sample
+     */
+    void Record(DcgmProcessSample const &sample, std::vector<DcgmThreadTicks> const &threads);
+
+    /*************************************************************************/
+    /*
+     * Get the latest sample
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if nothing was recorded yet
+     */
+    dcgmReturn_t GetLatest(DcgmProcessSample &sample) const;
+
+    /*************************************************************************/
+    /*
+     * Get the share of the machine's CPU time the process used over about the
+     * last intervalUsec, going back at least one sample
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if fewer than two samples were recorded
+     */
+    dcgmReturn_t GetCpuUtil(timelib64_t intervalUsec, double &user, double &kernel) const;
+
+    /*************************************************************************/
+    /*
+     * Get the CPU use of each thread between the last two samples, busiest first
+     *
+     * Returns: DCGM_ST_OK on success
+     *          DCGM_ST_NO_DATA if fewer than two samples were recorded
+     */
+    dcgmReturn_t GetThreadCpuUtil(std::vector<DcgmThreadCpuUtil> &threads) const;
+
+    /*************************************************************************/
+    /*
+     * Parse a /proc/<pid>/stat or /proc/<pid>/task/<tid>/stat line. The name
+     * may contain spaces and parentheses, so fields are counted from the last ')'
+     *
+     * Returns: true on success
+     *          false if line is too short
+     */
+    static bool ParseStatLine(std::string const &line, DcgmThreadTicks &ticks);
+
+private:
+    std::array<DcgmProcessSample, CAPACITY> m_samples {};
+    unsigned int m_next  = 0; /* Where the next sample goes */
+    unsigned int m_count = 0; /* Samples in m_samples */
+
+    std::unordered_map<unsigned int, DcgmThreadTicks> m_lastThreadTicks; /* tid -> ticks at the latest sample */
+    std::vector<DcgmThreadCpuUtil> m_threadUtil; /* Between the last two samples, busiest first */
+
+    /* i = 0 is the latest sample. Caller makes sure i < m_count */
+    DcgmProcessSample const &GetSample(unsigned int i) const;
+
+    static void ReadProcSelfStatus(DcgmProcessSample &sample);
+    static void ReadProcSelfStat(DcgmProcessSample &sample);
+    static void ReadProcStat(DcgmProcessSample &sample);
+    static void ReadThreads(std::vector<DcgmThreadTicks> &threads);
+};
+
+#endif // DCGMPROCESSSTATS_H
@@ -20,14 +20,15 @@
 
 /*****************************************************************************/
 /* Introspect Subrequest IDs */
-#define DCGM_INTROSPECT_SR_STATE_TOGGLE           1
-#define DCGM_INTROSPECT_SR_STATE_SET_RUN_INTERVAL 2
-#define DCGM_INTROSPECT_SR_UPDATE_ALL             3
-#define DCGM_INTROSPECT_SR_HOSTENGINE_MEM_USAGE   4
-#define DCGM_INTROSPECT_SR_HOSTENGINE_CPU_UTIL    5
-#define DCGM_INTROSPECT_SR_FIELDS_MEM_USAGE       6
-#define DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME       7
-#define DCGM_INTROSPECT_SR_COUNT                  8 /* Keep as last entry and 1 greater */
+#define DCGM_INTROSPECT_SR_STATE_TOGGLE               1
+#define DCGM_INTROSPECT_SR_STATE_SET_RUN_INTERVAL     2
+#define DCGM_INTROSPECT_SR_UPDATE_ALL                 3
+#define DCGM_INTROSPECT_SR_HOSTENGINE_MEM_USAGE       4
+#define DCGM_INTROSPECT_SR_HOSTENGINE_CPU_UTIL        5
+#define DCGM_INTROSPECT_SR_FIELDS_MEM_USAGE           6
+#define DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME           7
+#define DCGM_INTROSPECT_SR_HOSTENGINE_THREAD_CPU_UTIL 8
+#define DCGM_INTROSPECT_SR_COUNT                      9 /* Keep as last entry and 1 greater */
 
 /*****************************************************************************/
 /* Subrequest message definitions */
@@ -131,21 +132,66 @@ typedef struct dcgm_introspect_msg_fields_mem_usage_v1
 typedef dcgm_introspect_msg_fields_mem_usage_v1 dcgm_introspect_msg_fields_mem_usage_t;
 
 /**
- * Subrequest DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME
+ * Subrequest DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME from clients built against dcgmIntrospectFullFieldsExecTime_v2
  */
 typedef struct dcgm_introspect_msg_fields_exec_time_v1
+{
+    dcgm_module_command_header_t header;          /* Command header */
+    dcgmIntrospectContext_t context;              /* Info about the nature of this request */
+    dcgmIntrospectFullFieldsExecTime_v2 execTime; /* Info about field execution time */
+    int waitIfNoData; /* Should this request return immediately (0) or wait for data to be present if there is none (1)
+                       */
+} dcgm_introspect_msg_fields_exec_time_v1;
+
+#define dcgm_introspect_msg_fields_exec_time_version1 MAKE_DCGM_VERSION(dcgm_introspect_msg_fields_exec_time_v1, 1)
+
+/**
+ * Subrequest DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME from clients built against dcgmIntrospectFullFieldsExecTime_v3
+ */
+typedef struct dcgm_introspect_msg_fields_exec_time_v2
+{
+    dcgm_module_command_header_t header;          /* Command header */
+    dcgmIntrospectContext_t context;              /* Info about the nature of this request */
+    dcgmIntrospectFullFieldsExecTime_v3 execTime; /* Info about field execution time */
+    int waitIfNoData; /* Should this request return immediately (0) or wait for data to be present if there is none (1)
+                       */
+} dcgm_introspect_msg_fields_exec_time_v2;
+
+#define dcgm_introspect_msg_fields_exec_time_version2 MAKE_DCGM_VERSION(dcgm_introspect_msg_fields_exec_time_v2, 2)
+
+/**
+ * Subrequest DCGM_INTROSPECT_SR_FIELDS_EXEC_TIME
+ */
+typedef struct dcgm_introspect_msg_fields_exec_time_v3
 {
     dcgm_module_command_header_t header;         /* Command header */
     dcgmIntrospectContext_t context;             /* Info about the nature of this request */
     dcgmIntrospectFullFieldsExecTime_t execTime; /* Info about field execution time */
     int waitIfNoData; /* Should this request return immediately (0) or wait for data to be present if there is none (1)
                        */
-} dcgm_introspect_msg_fields_exec_time_v1;
+} dcgm_introspect_msg_fields_exec_time_v3;
 
-#define dcgm_introspect_msg_fields_exec_time_version1 MAKE_DCGM_VERSION(dcgm_introspect_msg_fields_exec_time_v1, 1)
-#define dcgm_introspect_msg_fields_exec_time_version  dcgm_introspect_msg_fields_exec_time_version1
+#define dcgm_introspect_msg_fields_exec_time_version3 MAKE_DCGM_VERSION(dcgm_introspect_msg_fields_exec_time_v3, 3)
+#define dcgm_introspect_msg_fields_exec_time_version  dcgm_introspect_msg_fields_exec_time_version3
+
+typedef dcgm_introspect_msg_fields_exec_time_v3 dcgm_introspect_msg_fields_exec_time_t;
+
+/**
+ * Subrequest DCGM_INTROSPECT_SR_HOSTENGINE_THREAD_CPU_UTIL
+ */
+typedef struct dcgm_introspect_msg_he_thread_cpu_util_v1
+{
+    dcgm_module_command_header_t header; /* Command header */
+
+    dcgmIntrospectThreadCpuUtil_t cpuUtil; /* CPU utilization of each host engine thread */
+    int waitIfNoData; /* Should this request return immediately (0) or wait for data to be present if there is none (1)
+                       */
+} dcgm_introspect_msg_he_thread_cpu_util_v1;
+
+#define dcgm_introspect_msg_he_thread_cpu_util_version1 MAKE_DCGM_VERSION(dcgm_introspect_msg_he_thread_cpu_util_v1, 1)
+#define dcgm_introspect_msg_he_thread_cpu_util_version  dcgm_introspect_msg_he_thread_cpu_util_version1
 
-typedef dcgm_introspect_msg_fields_exec_time_v1 dcgm_introspect_msg_fields_exec_time_t;
+typedef dcgm_introspect_msg_he_thread_cpu_util_v1 dcgm_introspect_msg_he_thread_cpu_util_t;
 
 /*****************************************************************************/
 
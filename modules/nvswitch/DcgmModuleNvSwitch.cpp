@@ -34,6 +34,13 @@ DcgmModuleNvSwitch::DcgmModuleNvSwitch(dcgmCoreCallbacks_t &dcc)
         DCGM_LOG_ERROR << "Could not initialize switch manager. Ret: " << errorString(ret);
     }
 
+    m_updateThread = std::make_unique<DcgmNvSwitchUpdateThread>(m_switchMgr);
+    if (m_updateThread->Start())
+    {
+        DCGM_LOG_ERROR << "Unable to start the NvSwitch update thread";
+        throw std::runtime_error("Unable to start the NvSwitch update thread");
+    }
+
     /* Start our TaskRunner now that we've survived initialization
      *
      * Start **must** come after Init. Otherwise two threads will attempt to
@@ -51,6 +58,8 @@ DcgmModuleNvSwitch::DcgmModuleNvSwitch(dcgmCoreCallbacks_t &dcc)
 
 DcgmModuleNvSwitch::~DcgmModuleNvSwitch()
 {
+    m_updateThread.reset();
+
     if (StopAndWait(60000))
     {
         DCGM_LOG_WARNING << "Not all threads for the NVSwitch module exited correctly; exiting anyway";
@@ -279,14 +288,21 @@ dcgmReturn_t DcgmModuleNvSwitch::ProcessWatchField(const dcgm_nvswitch_msg_watch
         return DCGM_ST_BADPARAM;
     }
 
-    return m_switchMgr.WatchField(msg->entityGroupId,
-                                  msg->entityId,
-                                  msg->numFieldIds,
-                                  msg->fieldIds,
-                                  msg->updateIntervalUsec,
-                                  msg->watcherType,
-                                  msg->connectionId,
-                                  false);
+    dcgmReturn_t ret = m_switchMgr.WatchField(msg->entityGroupId,
+                                              msg->entityId,
+                                              msg->numFieldIds,
+                                              msg->fieldIds,
+                                              msg->updateIntervalUsec,
+                                              msg->watcherType,
+                                              msg->connectionId,
+                                              false);
+    if (ret == DCGM_ST_OK)
+    {
+        /* The new watch may be due sooner than whatever the update thread is waiting for */
+        m_updateThread->Wake();
+    }
+
+    return ret;
 }
 
 /*****************************************************************************/
@@ -365,20 +381,12 @@ dcgmReturn_t DcgmModuleNvSwitch::ProcessCoreMessage(dcgm_module_command_header_t
 unsigned int DcgmModuleNvSwitch::RunOnce()
 {
     dcgmReturn_t dcgmReturn;
-    timelib64_t nextUpdateTimeUsec;
-    timelib64_t untilNextLinkStatusUsec;                 /* How long until our next switch status rescan */
-    timelib64_t linkStatusRescanIntervalUsec = 30000000; /* How long until our next switch status rescan */
-
-    m_switchMgr.UpdateFields(nextUpdateTimeUsec);
-
-    if (nextUpdateTimeUsec == 0)
-    {
-        nextUpdateTimeUsec = linkStatusRescanIntervalUsec;
-    }
+    timelib64_t linkStatusRescanIntervalUsec = 30000000; /* How often we rescan switch statuses */
 
     /* Update link statuses every 30 seconds */
-    timelib64_t now         = timelib_usecSince1970();
-    untilNextLinkStatusUsec = -((now - m_lastLinkStatusUpdateUsec) - linkStatusRescanIntervalUsec);
+    timelib64_t now = timelib_usecSince1970();
+    /* How long until our next switch status rescan */
+    timelib64_t untilNextLinkStatusUsec = m_lastLinkStatusUpdateUsec + linkStatusRescanIntervalUsec - now;
     if (untilNextLinkStatusUsec <= 0)
     {
         DCGM_LOG_DEBUG << "Rescanning switch states";
@@ -392,15 +400,8 @@ unsigned int DcgmModuleNvSwitch::RunOnce()
         untilNextLinkStatusUsec    = linkStatusRescanIntervalUsec;
     }
 
-    /* Adjust our nextUpdateTimeUsec for whichever is sooner between when watches will
-      update again or when we need to rescan links */
-    if (untilNextLinkStatusUsec > 0)
-    {
-        nextUpdateTimeUsec = DCGM_MIN(nextUpdateTimeUsec, untilNextLinkStatusUsec);
-    }
-
-    DCGM_LOG_VERBOSE << "Next update " << nextUpdateTimeUsec;
-    return nextUpdateTimeUsec / 1000;
+    DCGM_LOG_VERBOSE << "Next update " << untilNextLinkStatusUsec;
+    return untilNextLinkStatusUsec / 1000;
 }
 
 /*****************************************************************************/
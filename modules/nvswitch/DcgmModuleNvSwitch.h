@@ -18,8 +18,10 @@
 #include <DcgmModule.h>
 #include <DcgmTaskRunner.h>
 #include <dcgm_core_structs.h>
+#include <memory>
 
 #include "DcgmNvSwitchManager.h"
+#include "DcgmNvSwitchUpdateThread.h"
 #include "dcgm_nvswitch_structs.h"
 
 namespace DcgmNs
@@ -49,7 +51,8 @@ public:
 
     /*************************************************************************/
     /*
-     * This is the main background worker function of the module.
+     * This is the main background worker function of the module. It rescans
+     * switch and link statuses. Watched fields are updated by m_updateThread.
      *
      * Returns: Minimum ms before we should call this function again. This will
      *          be how long we block on QueueTask() being called again.
@@ -59,6 +62,7 @@ public:
 
 private:
     DcgmNvSwitchManager m_switchMgr;
+    std::unique_ptr<DcgmNvSwitchUpdateThread> m_updateThread; /* Updates the fields watched in m_switchMgr */
     std::chrono::system_clock::time_point m_nextWakeup
         = std::chrono::system_clock::time_point::min(); /*!< Next time when RunOnce should be called. */
     std::chrono::milliseconds m_runInterval {}; /*!< Last result of the latest successful RunOnce function call made in
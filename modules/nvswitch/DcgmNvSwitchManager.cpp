@@ -15,6 +15,7 @@
  */
 #include <DcgmLogging.h>
 #include <DcgmSettings.h>
+#include <utility>
 
 #include "DcgmNvSwitchManager.h"
 
@@ -111,6 +112,8 @@ dcgmReturn_t DcgmNvSwitchManager::CreateFakeSwitches(unsigned int &count, unsign
     unsigned int numToCreate = count;
     count                    = 0;
 
+    std::lock_guard<std::mutex> guard(m_nscqMutex);
+
     while (count < numToCreate)
     {
         unsigned int entityId = AddFakeNvSwitch();
@@ -241,14 +244,13 @@ dcgmReturn_t DcgmNvSwitchManager::UpdateFields(timelib64_t &nextUpdateTime)
 
     DcgmFvBuffer buf;
 
+    std::unique_lock<std::mutex> nscqLock(m_nscqMutex);
+
     for (size_t i = 0; i < toUpdate.size(); i++)
     {
-        /* aalsudani: here's where we can read other fields. We probably need a map
-           of DCGM_FI_DEV_? to NSCQ_DEF_PATH define. Then you can change the blank values
-           below to the appropriate real value */
-
-        // nscq.GetFieldInfo(toUpdate[i].entityGroupId, toUpdate[i].entityId, toUpdate[i].fieldMeta->fieldId);
-        // For now, add a blank value and force things to sleep for a long time
+        /* The NSCQ we build against has no paths for the NvSwitch fields yet. Once it does,
+           read each field for every switch with one ObserveAllSwitches() or ObserveAllPorts()
+           call rather than per entity. For now, add a blank value */
         switch (toUpdate[i].fieldMeta->fieldType)
         {
             case DCGM_FT_INT64:
@@ -271,8 +273,10 @@ dcgmReturn_t DcgmNvSwitchManager::UpdateFields(timelib64_t &nextUpdateTime)
         }
     }
 
+    nscqLock.unlock();
+
     // Push buf to the cache manager
-    ret = m_coreProxy.AppendSamples(&buf);
+    ret = m_coreProxy.AppendSamples(std::move(buf));
     if (ret != DCGM_ST_OK)
     {
         DCGM_LOG_ERROR << "Failed to append NvSwitch Samples to the cache: " << errorString(ret);
@@ -468,19 +472,51 @@ dcgmReturn_t DcgmNvSwitchManager::DetachFromNscq()
 }
 
 /*************************************************************************/
-dcgmReturn_t DcgmNvSwitchManager::AttachNvSwitches()
+template <typename T>
+dcgmReturn_t DcgmNvSwitchManager::ObserveAllSwitches(char const *path, std::vector<NscqSwitchValue<T>> &values)
 {
-    DCGM_LOG_DEBUG << "Attaching to NvSwitches";
+    using collector_t = NscqDataCollector<std::vector<NscqSwitchValue<T>>>;
+    collector_t collector;
 
-    struct IdPair
-    {
-        uuid_p device;
-        phys_id_t physId;
+    auto cb = [](const uuid_p device, nscq_rc_t rc, const T in, collector_t *dest) {
+        if (dest == nullptr)
+        {
+            DCGM_LOG_ERROR << "NSCQ passed dest = nullptr";
+            return;
+        }
+        dest->callCounter++;
+
+        if (NSCQ_ERROR(rc))
+        {
+            DCGM_LOG_ERROR << "NSCQ passed error " << int(rc) << " for device " << device;
+            return;
+        }
+
+        dest->data.push_back({ device, in });
     };
 
-    NscqDataCollector<std::vector<IdPair>> collector;
+    nscq_rc_t ret = nscq_session_path_observe(m_nscqSession, path, NSCQ_FN(*cb), &collector, 0);
+
+    DCGM_LOG_DEBUG << "Callback for " << path << " called " << collector.callCounter << " times";
+
+    if (NSCQ_ERROR(ret))
+    {
+        DCGM_LOG_ERROR << "Could not observe " << path << ". NSCQ ret: " << int(ret);
+        return DCGM_ST_3RD_PARTY_LIBRARY_ERROR;
+    }
+
+    values = std::move(collector.data);
+    return DCGM_ST_OK;
+}
+
+/*************************************************************************/
+template <typename T>
+dcgmReturn_t DcgmNvSwitchManager::ObserveAllPorts(char const *path, std::vector<NscqPortValue<T>> &values)
+{
+    using collector_t = NscqDataCollector<std::vector<NscqPortValue<T>>>;
+    collector_t collector;
 
-    auto cb = [](const uuid_p device, nscq_rc_t rc, const phys_id_t in, NscqDataCollector<std::vector<IdPair>> *dest) {
+    auto cb = [](const uuid_p device, const link_id_t port, nscq_rc_t rc, const T in, collector_t *dest) {
         if (dest == nullptr)
         {
             DCGM_LOG_ERROR << "NSCQ passed dest = nullptr";
@@ -490,44 +526,58 @@ dcgmReturn_t DcgmNvSwitchManager::AttachNvSwitches()
 
         if (NSCQ_ERROR(rc))
         {
-            DCGM_LOG_ERROR << "NSCQ passed error " << rc << " for phys id " << in;
+            DCGM_LOG_ERROR << "NSCQ passed error " << int(rc) << " for device " << device << " port " << int(port);
             return;
         }
-        DCGM_LOG_DEBUG << "Received device " << device << " phys id " << in;
-        IdPair item;
 
-        item.device = device;
-        item.physId = in;
-
-        dest->data.push_back(item);
+        dest->data.push_back({ device, port, in });
     };
 
-    nscq_rc_t ret = nscq_session_path_observe(m_nscqSession, NSCQ_PATH(nvswitch_phys_id), NSCQ_FN(*cb), &collector, 0);
+    nscq_rc_t ret = nscq_session_path_observe(m_nscqSession, path, NSCQ_FN(*cb), &collector, 0);
 
-    DCGM_LOG_DEBUG << "Callback called " << collector.callCounter << " times";
+    DCGM_LOG_DEBUG << "Callback for " << path << " called " << collector.callCounter << " times";
 
     if (NSCQ_ERROR(ret))
     {
-        DCGM_LOG_ERROR << "Could not enumerate physical IDs. NSCQ return: " << ret;
+        DCGM_LOG_ERROR << "Could not observe " << path << ". NSCQ ret: " << int(ret);
         return DCGM_ST_3RD_PARTY_LIBRARY_ERROR;
     }
 
-    for (auto const &item : collector.data)
+    values = std::move(collector.data);
+    return DCGM_ST_OK;
+}
+
+/*************************************************************************/
+dcgmReturn_t DcgmNvSwitchManager::AttachNvSwitches()
+{
+    DCGM_LOG_DEBUG << "Attaching to NvSwitches";
+
+    std::vector<NscqSwitchValue<phys_id_t>> physIds;
+
+    dcgmReturn_t st = ObserveAllSwitches(NSCQ_PATH(nvswitch_phys_id), physIds);
+    if (st != DCGM_ST_OK)
     {
-        int index = FindSwitchByPhysId(item.physId);
+        DCGM_LOG_ERROR << "Could not enumerate physical IDs";
+        return st;
+    }
+
+    for (auto const &item : physIds)
+    {
+        DCGM_LOG_DEBUG << "Received device " << item.device << " phys id " << item.value;
+        int index = FindSwitchByPhysId(item.value);
         if (index == -1)
         {
-            DCGM_LOG_DEBUG << "Not found: phys id " << item.physId << ". Adding new switch";
+            DCGM_LOG_DEBUG << "Not found: phys id " << item.value << ". Adding new switch";
 
             if (m_numNvSwitches >= DCGM_MAX_NUM_SWITCHES)
             {
-                DCGM_LOG_ERROR << "Could not add switch with phys id " << item.physId
+                DCGM_LOG_ERROR << "Could not add switch with phys id " << item.value
                                << ". Reached maximum number of switches";
                 return DCGM_ST_INSUFFICIENT_SIZE;
             }
 
             label_t label;
-            ret = nscq_uuid_to_label(item.device, &label, 0);
+            nscq_rc_t ret = nscq_uuid_to_label(item.device, &label, 0);
 
             if (NSCQ_ERROR(ret))
             {
@@ -538,15 +588,15 @@ dcgmReturn_t DcgmNvSwitchManager::AttachNvSwitches()
             index = m_numNvSwitches;
 
             m_numNvSwitches++;
-            m_nvSwitches[index].physicalId = item.physId;
+            m_nvSwitches[index].physicalId = item.value;
             m_nvSwitchNscqDevices[index]   = item.device;
             m_nvSwitchUuids[index]         = label;
 
-            DCGM_LOG_DEBUG << "Added switch: phys id " << item.physId << " at index " << index;
+            DCGM_LOG_DEBUG << "Added switch: phys id " << item.value << " at index " << index;
         }
     }
 
-    dcgmReturn_t st = ReadNvSwitchStatusAllSwitches();
+    st = ReadNvSwitchStatusAllSwitches();
     if (st != DCGM_ST_OK)
     {
         DCGM_LOG_ERROR << "Could not read NvSwitch status";
@@ -587,63 +637,33 @@ dcgmReturn_t DcgmNvSwitchManager::ReadNvSwitchStatusAllSwitches()
 {
     DCGM_LOG_DEBUG << "Reading switch status for all switches";
 
+    std::lock_guard<std::mutex> guard(m_nscqMutex);
+
     if (!m_attachedToNscq)
     {
         DCGM_LOG_DEBUG << "Not attached to NvSwitches. Aborting";
         return DCGM_ST_UNINITIALIZED;
     }
 
-    const char path[] = "/drv/nvswitch/{device}/blacklisted";
-    struct DeviceStatePair
-    {
-        uuid_p device;
-        bool state;
-    };
-
-    NscqDataCollector<std::vector<DeviceStatePair>> collector;
-
-    auto cb
-        = [](const uuid_p device, nscq_rc_t rc, const bool in, NscqDataCollector<std::vector<DeviceStatePair>> *dest) {
-              if (dest == nullptr)
-              {
-                  DCGM_LOG_ERROR << "NSCQ passed dest = nullptr";
-                  return;
-              }
-              dest->callCounter++;
-
-              if (NSCQ_ERROR(rc))
-              {
-                  DCGM_LOG_ERROR << "NSCQ passed error " << rc << " for device " << device;
-                  return;
-              }
-              DCGM_LOG_DEBUG << "Received device " << device << " blacklist " << in;
-
-              DeviceStatePair item;
-              item.device = device;
-              item.state  = in;
-
-              dest->data.push_back(item);
-          };
+    std::vector<NscqSwitchValue<bool>> blacklisted;
 
-    nscq_rc_t ret = nscq_session_path_observe(m_nscqSession, path, NSCQ_FN(*cb), &collector, 0);
-
-    DCGM_LOG_DEBUG << "Callback called " << collector.callCounter << " times";
-
-    if (NSCQ_ERROR(ret))
+    dcgmReturn_t st = ObserveAllSwitches("/drv/nvswitch/{device}/blacklisted", blacklisted);
+    if (st != DCGM_ST_OK)
     {
-        DCGM_LOG_ERROR << "Could not read Switch status. NSCQ ret: " << ret;
-        return DCGM_ST_3RD_PARTY_LIBRARY_ERROR;
+        DCGM_LOG_ERROR << "Could not read Switch status";
+        return st;
     }
 
-    for (const auto &pair : collector.data)
+    for (const auto &item : blacklisted)
     {
-        auto index = FindSwitchByDevice(pair.device);
+        DCGM_LOG_DEBUG << "Received device " << item.device << " blacklist " << item.value;
+        auto index = FindSwitchByDevice(item.device);
         if (index == -1)
         {
-            DCGM_LOG_ERROR << "Could not find device " << pair.device << ". Skipping";
+            DCGM_LOG_ERROR << "Could not find device " << item.device << ". Skipping";
             continue;
         }
-        m_nvSwitches[index].status = pair.state ? DcgmEntityStatusDisabled : DcgmEntityStatusOk;
+        m_nvSwitches[index].status = item.value ? DcgmEntityStatusDisabled : DcgmEntityStatusOk;
         DCGM_LOG_DEBUG << "Loaded status for switch at index " << index;
     }
 
@@ -663,57 +683,19 @@ dcgmReturn_t DcgmNvSwitchManager::ReadLinkStatesAllSwitches()
 
     dcgmReturn_t dcgmRet = DCGM_ST_NO_DATA;
 
-    struct StateTriplet
-    {
-        uuid_p device;
-        link_id_t linkId;
-        nscq_nvlink_state_t state;
-    };
-
-    const char *path = "/{nvswitch}/nvlink/{port}/status/link";
+    std::vector<NscqPortValue<nscq_nvlink_state_t>> states;
 
-    using collector_t = NscqDataCollector<std::vector<StateTriplet>>;
-    collector_t collector;
-
-    auto cb = [](const uuid_p device,
-                 const link_id_t linkId,
-                 nscq_rc_t rc,
-                 const nscq_nvlink_state_t state,
-                 collector_t *dest) {
-        if (dest == nullptr)
-        {
-            DCGM_LOG_ERROR << "NSCQ passed dest = nullptr";
-            return;
-        }
-        dest->callCounter++;
-
-        if (NSCQ_ERROR(rc))
-        {
-            DCGM_LOG_ERROR << "NSCQ passed error " << rc << " for device " << device;
-            return;
-        }
-        DCGM_LOG_DEBUG << "Received device " << device << " linkId " << int(linkId) << " state " << int(state);
-
-        StateTriplet item;
-        item.device = device;
-        item.linkId = linkId;
-        item.state  = state;
-
-        dest->data.push_back(item);
-    };
-
-    nscq_rc_t ret = nscq_session_path_observe(m_nscqSession, path, NSCQ_FN(*cb), &collector, 0);
-
-    if (NSCQ_ERROR(ret))
+    dcgmReturn_t st = ObserveAllPorts("/{nvswitch}/nvlink/{port}/status/link", states);
+    if (st != DCGM_ST_OK)
     {
-        DCGM_LOG_ERROR << "Could not read NvLink states. NSCQ ret: " << ret;
-        return DCGM_ST_3RD_PARTY_LIBRARY_ERROR;
+        DCGM_LOG_ERROR << "Could not read NvLink states";
+        return st;
     }
 
-    DCGM_LOG_DEBUG << "Callback called " << collector.callCounter << " times";
-
-    for (const StateTriplet &item : collector.data)
+    for (const auto &item : states)
     {
+        DCGM_LOG_DEBUG << "Received device " << item.device << " linkId " << int(item.port) << " state "
+                       << int(item.value);
         unsigned int index = FindSwitchByDevice(item.device);
         if (index == -1)
         {
@@ -721,7 +703,7 @@ dcgmReturn_t DcgmNvSwitchManager::ReadLinkStatesAllSwitches()
             continue;
         }
 
-        dcgmReturn_t st = UpdateLinkState(index, item.linkId, item.state);
+        st = UpdateLinkState(index, item.port, item.value);
         if (st == DCGM_ST_OK)
         {
             dcgmRet = DCGM_ST_OK;
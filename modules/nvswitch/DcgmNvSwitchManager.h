@@ -22,6 +22,7 @@
 #include <DcgmWatchTable.h>
 #include <dcgm_nscq.h>
 #include <dcgm_structs.h>
+#include <mutex>
 
 namespace DcgmNs
 {
@@ -157,10 +158,13 @@ public:
 
     /*************************************************************************/
     /**
-     * Updates the watched fields for this module
+     * Updates the watched fields for this module. Called from the module's
+     * DcgmNvSwitchUpdateThread. NSCQ and the switch table are only used with
+     * m_nscqMutex locked.
      *
      * @param nextUpdateTime[out]  - the earliest next time we should wake up
-     *                               to update the fields
+     *                               to update the fields, in usec since 1970.
+     *                               0 if no fields are watched
      *
      * @return DCGM_ST_OK:            Fields pushed correctly to the cache
      *         DCGM_ST_*:             Indicating any other return
@@ -200,6 +204,23 @@ public:
     dcgmReturn_t Init();
 
 protected:
+    /* Value NSCQ reported for one NvSwitch */
+    template <typename T>
+    struct NscqSwitchValue
+    {
+        uuid_p device;
+        T value;
+    };
+
+    /* Value NSCQ reported for one port of an NvSwitch */
+    template <typename T>
+    struct NscqPortValue
+    {
+        uuid_p device;
+        link_id_t port;
+        T value;
+    };
+
     unsigned int m_numNvSwitches;                             // Number of entries in m_nvSwitches that are valid
     dcgm_nvswitch_info_t m_nvSwitches[DCGM_MAX_NUM_SWITCHES]; // All of the NvSwitches we know about
     uuid_p m_nvSwitchNscqDevices[DCGM_MAX_NUM_SWITCHES];      // Pointers to NSCQ device objects
@@ -208,6 +229,7 @@ protected:
     DcgmCoreProxy m_coreProxy;                                // Proxy class for communication with DCGM core
     nscq_session_t m_nscqSession;                             // NSCQ session for communicating with driver
     bool m_attachedToNscq = false;                            // Have we attached to nscq yet? */
+    std::mutex m_nscqMutex;                                   // Serializes NSCQ use with the update thread
 
     /*************************************************************************/
     /**
@@ -272,5 +294,25 @@ protected:
      * Sets link state for single link. Does not query for data
      */
     dcgmReturn_t UpdateLinkState(unsigned int, link_id_t, nvlink_state_t);
+
+    /*************************************************************************/
+    /**
+     * Read a path with one {nvswitch} or {device} placeholder for every NvSwitch
+     * with a single NSCQ observe call. Switches NSCQ reported an error for are
+     * logged and left out of values
+     *
+     * @return DCGM_ST_OK:                       values populated
+     *         DCGM_ST_3RD_PARTY_LIBRARY_ERROR:  NSCQ could not observe path
+     */
+    template <typename T>
+    dcgmReturn_t ObserveAllSwitches(char const *path, std::vector<NscqSwitchValue<T>> &values);
+
+    /*************************************************************************/
+    /**
+     * Read a path with {nvswitch} and {port} placeholders for every port of
+     * every NvSwitch with a single NSCQ observe call. See ObserveAllSwitches
+     */
+    template <typename T>
+    dcgmReturn_t ObserveAllPorts(char const *path, std::vector<NscqPortValue<T>> &values);
 };
 } // namespace DcgmNs
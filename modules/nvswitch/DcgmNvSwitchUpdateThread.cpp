@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DcgmNvSwitchUpdateThread.h"
+
+#include <DcgmLogging.h>
+#include <chrono>
+
+namespace DcgmNs
+{
+/*****************************************************************************/
+DcgmNvSwitchUpdateThread::DcgmNvSwitchUpdateThread(DcgmNvSwitchManager &switchMgr)
+    : DcgmThread(false, "nvswitch_update")
+    , m_switchMgr(switchMgr)
+{}
+
+/*****************************************************************************/
+DcgmNvSwitchUpdateThread::~DcgmNvSwitchUpdateThread()
+{
+    StopAndWait(60000);
+}
+
+/*****************************************************************************/
+void DcgmNvSwitchUpdateThread::Wake()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_wake = true;
+    }
+    m_cond.notify_all();
+}
+
+/*****************************************************************************/
+void DcgmNvSwitchUpdateThread::OnStop()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stopped = true;
+    }
+    m_cond.notify_all();
+}
+
+/*****************************************************************************/
+void DcgmNvSwitchUpdateThread::run()
+{
+    auto wakeUp = [this] { return m_wake || m_stopped; };
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopped)
+    {
+        m_wake = false;
+        lock.unlock();
+
+        /* Absolute time in usec since 1970 when the next watch is due. 0 if nothing is watched */
+        timelib64_t nextUpdateTime = 0;
+        m_switchMgr.UpdateFields(nextUpdateTime);
+
+        lock.lock();
+        if (nextUpdateTime == 0)
+        {
+            m_cond.wait(lock, wakeUp);
+            continue;
+        }
+
+        timelib64_t untilNextUpdateUsec = nextUpdateTime - timelib_usecSince1970();
+        if (untilNextUpdateUsec > 0)
+        {
+            DCGM_LOG_VERBOSE << "Next NvSwitch field update in " << untilNextUpdateUsec << " usec";
+            m_cond.wait_for(lock, std::chrono::microseconds(untilNextUpdateUsec), wakeUp);
+        }
+    }
+}
+} // namespace DcgmNs
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "DcgmNvSwitchManager.h"
+
+#include <DcgmThread.h>
+#include <condition_variable>
+#include <mutex>
+
+namespace DcgmNs
+{
+/*
+ * Thread that updates the fields watched on NvSwitches and pushes them to the
+ * cache. It sleeps until the earliest watch is due, so watch intervals are
+ * kept however long the module's task runner spends on requests and link
+ * status rescans.
+ */
+class DcgmNvSwitchUpdateThread : public DcgmThread
+{
+public:
+    /**************************************************************************
+     * Constructor. Call Start() to start updating
+     *
+     * switchMgr IN: Manager whose watched fields are updated. Must outlive this thread
+     */
+    explicit DcgmNvSwitchUpdateThread(DcgmNvSwitchManager &switchMgr);
+
+    ~DcgmNvSwitchUpdateThread() override;
+
+    /**************************************************************************
+     * Update the watched fields now rather than when the next one is due, for
+     * instance after a watch was added with a shorter interval
+     */
+    void Wake();
+
+    /* Inherited from DcgmThread */
+    void run() override;
+    void OnStop() override;
+
+private:
+    DcgmNvSwitchManager &m_switchMgr;
+    std::mutex m_mutex;
+    std::condition_variable m_cond; /* Signalled on Wake() and stop */
+    bool m_wake    = false;         /* Has Wake() been called since the last update? Protected by m_mutex */
+    bool m_stopped = false;         /* Has Stop() been called? Protected by m_mutex */
+};
+} // namespace DcgmNs
@@ -16,6 +16,12 @@
 #include <catch2/catch.hpp>
 
 #include <DcgmNvSwitchManager.h>
+#include <DcgmNvSwitchUpdateThread.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
 
 using namespace DcgmNs;
 
@@ -187,8 +193,7 @@ dcgmReturn_t CustomPost(dcgm_module_command_header_t *req, void *poster)
         {
             dcgmCoreAppendSamples_t as;
             memcpy(&as, req, sizeof(as));
-            DcgmFvBuffer fvbuf;
-            fvbuf.SetFromBuffer(as.request.buffer, as.request.bufferSize);
+            DcgmFvBuffer fvbuf(std::move(*as.request.fvBuffer));
             dcgmFieldValue_v1 values[128];
             size_t num_stored = 0;
             fvbuf.GetAllAsFv1(values, 128, &num_stored);
@@ -225,7 +230,7 @@ void LoggerCallback(const void * /*unused*/)
 SCENARIO("Appending Samples")
 {
     std::set<unsigned short> fieldIdSet;
-    dcgmCoreCallbacks_v1 dcc = { dcgmCoreCallbacks_version, CustomPost, &fieldIdSet, LoggerCallback };
+    dcgmCoreCallbacks_t dcc = { dcgmCoreCallbacks_version, CustomPost, &fieldIdSet, LoggerCallback, nullptr };
     DcgmNvSwitchManager nsm(&dcc);
 
     unsigned int fakeCount = 4;
@@ -272,3 +277,65 @@ SCENARIO("Appending Samples")
     }
     REQUIRE(fieldIdSet.size() == 0);
 }
+
+struct UpdateCounter
+{
+    std::mutex mutex;
+    std::condition_variable appended;
+    unsigned int numAppends = 0;
+};
+
+dcgmReturn_t CountingPost(dcgm_module_command_header_t *req, void *poster)
+{
+    if (req->subCommand == DcgmCoreReqIdCMAppendSamples)
+    {
+        auto counter = static_cast<UpdateCounter *>(poster);
+        {
+            std::lock_guard<std::mutex> guard(counter->mutex);
+            counter->numAppends++;
+        }
+        counter->appended.notify_all();
+    }
+
+    return DCGM_ST_OK;
+}
+
+SCENARIO("Updating fields from the update thread")
+{
+    UpdateCounter counter;
+    dcgmCoreCallbacks_t dcc = { dcgmCoreCallbacks_version, CountingPost, &counter, LoggerCallback, nullptr };
+    DcgmNvSwitchManager nsm(&dcc);
+    DcgmNvSwitchUpdateThread updateThread(nsm);
+    REQUIRE(updateThread.Start() == 0);
+
+    unsigned int fakeCount = 2;
+    unsigned int fakeSwitchIds[2];
+    REQUIRE(nsm.CreateFakeSwitches(fakeCount, fakeSwitchIds) == DCGM_ST_OK);
+
+    DcgmFieldsInit();
+    DcgmWatcher watcher;
+    unsigned short fieldId = DCGM_FI_DEV_NVSWITCH_LATENCY_LOW_P00;
+
+    REQUIRE(nsm.WatchField(DCGM_FE_SWITCH,
+                           fakeSwitchIds[0], // entity ID
+                           1,                // numFieldIds
+                           &fieldId,         // field IDs
+                           10000,            // watch interval in Usec
+                           watcher.watcherType,
+                           watcher.connectionId,
+                           true)
+            == DCGM_ST_OK);
+
+    /* Nothing was watched when the thread started, so it waits until woken */
+    updateThread.Wake();
+
+    /* The watch is due every 10 ms, so the thread keeps updating it without being woken again */
+    {
+        std::unique_lock<std::mutex> lock(counter.mutex);
+        CHECK(counter.appended.wait_for(lock, std::chrono::seconds(5), [&counter] {
+            return counter.numAppends >= 3;
+        }));
+    }
+
+    updateThread.StopAndWait(10000);
+}
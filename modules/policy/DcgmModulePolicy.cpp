@@ -23,11 +23,19 @@ DcgmModulePolicy::DcgmModulePolicy(dcgmCoreCallbacks_t &dcc)
     : DcgmModuleWithCoreProxy(dcc)
 {
     mpPolicyManager = std::make_unique<DcgmPolicyManager>(dcc);
+
+    DcgmPolicyManager *policyManager = mpPolicyManager.get();
+    m_fvUpdateWorker                 = std::make_unique<DcgmFvUpdateWorker>(
+        [policyManager](DcgmFvBuffer const &fvBuffer) { policyManager->OnFieldValuesUpdate(&fvBuffer); },
+        "policy_fv_updates");
+    m_fvUpdateWorker->Start();
 }
 
 /*****************************************************************************/
 DcgmModulePolicy::~DcgmModulePolicy()
 {
+    /* Stop feeding updates before mpPolicyManager goes away */
+    m_fvUpdateWorker.reset();
     mpPolicyManager = 0;
 }
 
@@ -64,7 +72,25 @@ dcgmReturn_t DcgmModulePolicy::ProcessRegister(dcgm_policy_msg_register_t *msg)
     if (DCGM_ST_OK != dcgmReturn)
         return dcgmReturn; /* Logging handled by helper method */
 
-    return mpPolicyManager->RegisterForPolicy(msg);
+    dcgm_policy_msg_register_v2 registerV2 {};
+    registerV2.header             = msg->header;
+    registerV2.groupId            = msg->groupId;
+    registerV2.condition          = msg->condition;
+    registerV2.coalesceWindowUsec = DCGM_POLICY_DEFAULT_COALESCE_USEC;
+
+    return mpPolicyManager->RegisterForPolicy(&registerV2, dcgmPolicyCallbackResponse_version1);
+}
+
+/*****************************************************************************/
+dcgmReturn_t DcgmModulePolicy::ProcessRegisterV2(dcgm_policy_msg_register_v2 *msg)
+{
+    dcgmReturn_t dcgmReturn;
+
+    dcgmReturn = CheckVersion(&msg->header, dcgm_policy_msg_register_version2);
+    if (DCGM_ST_OK != dcgmReturn)
+        return dcgmReturn; /* Logging handled by helper method */
+
+    return mpPolicyManager->RegisterForPolicy(msg, dcgmPolicyCallbackResponse_version2);
 }
 
 /*****************************************************************************/
@@ -100,10 +126,14 @@ dcgmReturn_t DcgmModulePolicy::ProcessFieldValuesUpdated(dcgm_core_msg_field_val
         return dcgmReturn; /* Logging handled by helper method */
     }
 
-    DcgmFvBuffer fvbuf;
-    fvbuf.SetFromBuffer(msg->fieldValues.buffer, msg->fieldValues.bufferSize);
+    if (msg->snapshot == nullptr)
+    {
+        DCGM_LOG_ERROR << "Field value update was missing its snapshot";
+        return DCGM_ST_BADPARAM;
+    }
 
-    mpPolicyManager->OnFieldValuesUpdate(&fvbuf);
+    /* Walked by m_fvUpdateWorker so that the cache manager doesn't wait on us */
+    m_fvUpdateWorker->Post(*msg->snapshot);
 
     return DCGM_ST_OK;
 }
@@ -145,6 +175,9 @@ dcgmReturn_t DcgmModulePolicy::ProcessMessage(dcgm_module_command_header_t *modu
     }
     else
     {
+        /* Requests should see every field value update that came before them */
+        m_fvUpdateWorker->Flush();
+
         switch (moduleCommand->subCommand)
         {
             case DCGM_POLICY_SR_GET_POLICIES:
@@ -163,6 +196,10 @@ dcgmReturn_t DcgmModulePolicy::ProcessMessage(dcgm_module_command_header_t *modu
                 retSt = ProcessUnregister((dcgm_policy_msg_unregister_t *)moduleCommand);
                 break;
 
+            case DCGM_POLICY_SR_REGISTER_V2:
+                retSt = ProcessRegisterV2((dcgm_policy_msg_register_v2 *)moduleCommand);
+                break;
+
             default:
                 DCGM_LOG_DEBUG << "Unknown subcommand: " << static_cast<int>(moduleCommand->subCommand);
                 return DCGM_ST_FUNCTION_NOT_FOUND;
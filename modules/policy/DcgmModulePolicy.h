@@ -16,6 +16,7 @@
 #ifndef DCGMMODULEPOLICY_H
 #define DCGMMODULEPOLICY_H
 
+#include "DcgmFvUpdateWorker.h"
 #include "DcgmModule.h"
 #include "DcgmPolicyManager.h"
 #include "dcgm_policy_structs.h"
@@ -51,6 +52,7 @@ private:
     dcgmReturn_t ProcessGetPolicies(dcgm_policy_msg_get_policies_t *msg);
     dcgmReturn_t ProcessSetPolicy(dcgm_policy_msg_set_policy_t *msg);
     dcgmReturn_t ProcessRegister(dcgm_policy_msg_register_t *msg);
+    dcgmReturn_t ProcessRegisterV2(dcgm_policy_msg_register_v2 *msg);
     dcgmReturn_t ProcessUnregister(dcgm_policy_msg_unregister_t *msg);
     dcgmReturn_t ProcessCoreMessage(dcgm_module_command_header_t *moduleCommand);
     dcgmReturn_t ProcessFieldValuesUpdated(dcgm_core_msg_field_values_updated_t *msg);
@@ -58,7 +60,8 @@ private:
 
     /*************************************************************************/
     /* Private member variables */
-    std::unique_ptr<DcgmPolicyManager> mpPolicyManager; /* Pointer to the worker class for this module */
+    std::unique_ptr<DcgmPolicyManager> mpPolicyManager;   /* Pointer to the worker class for this module */
+    std::unique_ptr<DcgmFvUpdateWorker> m_fvUpdateWorker; /* Feeds field value updates to mpPolicyManager */
 };
 
 
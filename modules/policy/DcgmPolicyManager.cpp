@@ -15,18 +15,41 @@
  */
 #include "DcgmPolicyManager.h"
 #include "DcgmLogging.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
 
+/* Fields policies are evaluated on. CompileRules() knows the rule of each of them */
+const unsigned short DcgmPolicyManager::s_ruleFieldIds[DPM_NUM_RULE_FIELDS]
+    = { DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_COUNT_TOTAL,
+        DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_COUNT_TOTAL,
+        DCGM_FI_DEV_NVLINK_REPLAY_ERROR_COUNT_TOTAL,
+        DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_COUNT_TOTAL,
+        DCGM_FI_DEV_ECC_DBE_VOL_DEV,
+        DCGM_FI_DEV_RETIRED_SBE,
+        DCGM_FI_DEV_RETIRED_DBE,
+        DCGM_FI_DEV_GPU_TEMP,
+        DCGM_FI_DEV_XID_ERRORS,
+        DCGM_FI_DEV_POWER_USAGE,
+        DCGM_FI_DEV_PCIE_REPLAY_COUNTER };
+
 /*****************************************************************************
  * ctor
  *****************************************************************************/
 DcgmPolicyManager::DcgmPolicyManager(dcgmCoreCallbacks_t &dcc)
     : mpCoreProxy(dcc)
+    , m_havePending(false)
+    , m_predicatesBypassed(false)
 {
     m_mutex = new DcgmMutex(0);
 
+    memset(m_ruleIndex, DPM_NO_RULE, sizeof(m_ruleIndex));
+    for (unsigned int i = 0; i < DPM_NUM_RULE_FIELDS; i++)
+    {
+        m_ruleIndex[s_ruleFieldIds[i]] = (unsigned char)i;
+    }
+
     Init();
 }
 
@@ -60,6 +83,7 @@ dcgmReturn_t DcgmPolicyManager::Init(void)
         m_gpus[i].currentPolicies.version = dcgmPolicy_version;
 
         m_gpus[i].watchers.clear();
+        memset(m_gpus[i].rules, 0, sizeof(m_gpus[i].rules));
     }
     m_numGpus = deviceCount;
 
@@ -69,70 +93,200 @@ dcgmReturn_t DcgmPolicyManager::Init(void)
 }
 
 /*****************************************************************************/
-void DcgmPolicyManager::OnFieldValuesUpdate(DcgmFvBuffer *fvBuffer)
+void DcgmPolicyManager::OnFieldValuesUpdate(DcgmFvBuffer const *fvBuffer)
 {
-    dcgmBufferedFv_t *fv;
+    dcgmBufferedFv_t const *fv;
     dcgmBufferedFvCursor_t cursor = 0;
 
+    int64_t latestTimestamp       = 0;
+
     /* This is a bit coarse-grained for now, but it's clean */
     dcgmMutexReturn_t mutexSt = dcgm_mutex_lock(m_mutex);
 
     for (fv = fvBuffer->GetNextFv(&cursor); fv; fv = fvBuffer->GetNextFv(&cursor))
     {
+        latestTimestamp = std::max(latestTimestamp, fv->timestamp);
+
         /* Policy only pertains to GPUs for now */
-        if (fv->entityGroupId != DCGM_FE_GPU)
+        if (fv->entityGroupId != DCGM_FE_GPU || fv->entityId >= DCGM_MAX_NUM_DEVICES
+            || fv->fieldId >= DCGM_FI_MAX_FIELDS)
+        {
+            continue;
+        }
+
+        unsigned char ruleIndex = m_ruleIndex[fv->fieldId];
+        if (ruleIndex == DPM_NO_RULE)
         {
-            PRINT_DEBUG("%u", "Ignored non-GPU eg %u", fv->entityGroupId);
             continue;
         }
 
-        /* Does this GPU have an active policy? */
-        if (!m_gpus[fv->entityId].policiesHaveBeenSet)
+        /* Inactive unless this GPU has a policy with the rule's condition */
+        dpm_rule_t const &rule = m_gpus[fv->entityId].rules[ruleIndex];
+        if (!rule.active || fv->status != DCGM_ST_OK)
         {
-            PRINT_DEBUG("%u", "Ignored gpuId %u without policies set", fv->entityId);
             continue;
         }
 
-        switch (fv->fieldId)
+        long long value;
+        if (rule.fp64)
+        {
+            if (DCGM_FP64_IS_BLANK(fv->value.dbl))
+            {
+                continue;
+            }
+            value = (long long)fv->value.dbl;
+        }
+        else
+        {
+            if (DCGM_INT64_IS_BLANK(fv->value.i64))
+            {
+                continue;
+            }
+            value = fv->value.i64;
+        }
+
+        if (value > rule.threshold)
+        {
+            OnRuleViolated(rule, fv);
+        }
+    }
+
+    /* Samples keep arriving at the watch interval, so their timestamps also close
+       the coalescing windows of violations that stopped */
+    if (m_havePending)
+    {
+        FlushPending(latestTimestamp);
+    }
+
+    /* While violations are pending, every sample is needed for its timestamp */
+    if (m_havePending != m_predicatesBypassed)
+    {
+        mpCoreProxy.SetPredicatesBypassed(DcgmWatcherTypePolicyManager, m_havePending);
+        m_predicatesBypassed = m_havePending;
+    }
+
+    if (mutexSt != DCGM_MUTEX_ST_LOCKEDBYME)
+        dcgm_mutex_unlock(m_mutex);
+}
+
+/*****************************************************************************/
+void DcgmPolicyManager::CompileRules(unsigned int gpuId)
+{
+    dpm_gpu_t &gpu             = m_gpus[gpuId];
+    dcgmPolicy_t const &policy = gpu.currentPolicies;
+
+    for (unsigned int i = 0; i < DPM_NUM_RULE_FIELDS; i++)
+    {
+        dpm_rule_t &rule = gpu.rules[i];
+        rule             = {};
+
+        switch (s_ruleFieldIds[i])
         {
             case DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_COUNT_TOTAL:
             case DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_COUNT_TOTAL:
             case DCGM_FI_DEV_NVLINK_REPLAY_ERROR_COUNT_TOTAL:
             case DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_COUNT_TOTAL:
-                CheckNVLinkErrors(fv);
+                rule.alertType = DCGM_VIOLATION_POLICY_FAIL_NVLINK;
                 break;
 
             case DCGM_FI_DEV_ECC_DBE_VOL_DEV:
-                CheckEccErrors(fv);
+                rule.alertType = DCGM_VIOLATION_POLICY_FAIL_ECC_DBE;
                 break;
 
             case DCGM_FI_DEV_RETIRED_SBE:
             case DCGM_FI_DEV_RETIRED_DBE:
-                CheckRetiredPages(fv);
+                /* The limit is on SBE + DBE pages, which ReportRetiredPages() checks. Both page counts
+                   are updated together, so one of them is > 0 whenever their sum is over the limit */
+                rule.alertType = DCGM_VIOLATION_POLICY_FAIL_MAX_RETIRED_PAGES;
                 break;
 
             case DCGM_FI_DEV_GPU_TEMP:
-                CheckThermalValues(fv);
+                rule.alertType = DCGM_VIOLATION_POLICY_FAIL_THERMAL;
+                rule.threshold = (unsigned int)policy.parms[DCGM_VIOLATION_POLICY_FAIL_THERMAL].val.llval;
                 break;
 
             case DCGM_FI_DEV_XID_ERRORS:
-                CheckXIDErrors(fv);
+                rule.alertType = DCGM_VIOLATION_POLICY_FAIL_XID;
+                rule.threshold = -1; /* Every XID is a violation */
+                break;
+
+            case DCGM_FI_DEV_POWER_USAGE:
+                rule.alertType = DCGM_VIOLATION_POLICY_FAIL_POWER;
+                rule.fp64      = true;
+                rule.threshold = (unsigned int)policy.parms[DCGM_VIOLATION_POLICY_FAIL_POWER].val.llval;
                 break;
 
             case DCGM_FI_DEV_PCIE_REPLAY_COUNTER:
-                CheckPcieErrors(fv);
+                rule.alertType = DCGM_VIOLATION_POLICY_FAIL_PCIE;
                 break;
 
             default:
-                /* This is partially expected since the cache manager will broadcast
-                   any FVs that updated during the same loop as FVs we care about */
-                PRINT_DEBUG("%u", "Ignoring unhandled field %u", fv->fieldId);
-                break;
+                PRINT_ERROR("%u", "Missing rule for policy fieldId %u", s_ruleFieldIds[i]);
+                continue;
+        }
+
+        /* DCGM_POLICY_COND_* bit n is the condition of alert type n */
+        rule.active = gpu.policiesHaveBeenSet && (policy.condition & (1 << rule.alertType));
+
+        /* Have the cache manager drop the values that can't break the rule before they are buffered for us.
+           Double values are compared before they are truncated, so the ones that pass are still checked */
+        dcgmcm_predicate_t predicate {};
+        predicate.type         = rule.active ? DcgmcmPredicateGreater : DcgmcmPredicateNone;
+        predicate.i64Threshold = rule.threshold;
+        predicate.dblThreshold = (double)rule.threshold;
+        dcgmReturn_t dcgmReturn = mpCoreProxy.SetWatchPredicate(
+            DCGM_FE_GPU, gpuId, s_ruleFieldIds[i], DcgmWatcherTypePolicyManager, predicate);
+        if (dcgmReturn != DCGM_ST_OK)
+        {
+            PRINT_ERROR("%d %u %u",
+                        "Error %d setting the predicate of fieldId %u, gpuId %u",
+                        (int)dcgmReturn,
+                        s_ruleFieldIds[i],
+                        gpuId);
         }
     }
+}
 
-    if (mutexSt != DCGM_MUTEX_ST_LOCKEDBYME)
-        dcgm_mutex_unlock(m_mutex);
+/*****************************************************************************/
+void DcgmPolicyManager::OnRuleViolated(dpm_rule_t const &rule, dcgmBufferedFv_t const *fv)
+{
+    switch (rule.alertType)
+    {
+        case DCGM_VIOLATION_POLICY_FAIL_ECC_DBE:
+            ReportEccErrors(fv);
+            break;
+
+        case DCGM_VIOLATION_POLICY_FAIL_PCIE:
+            ReportPcieErrors(fv);
+            break;
+
+        case DCGM_VIOLATION_POLICY_FAIL_MAX_RETIRED_PAGES:
+        {
+            dcgmPolicy_t const &policy = m_gpus[fv->entityId].currentPolicies;
+            ReportRetiredPages(fv, (unsigned int)policy.parms[DCGM_VIOLATION_POLICY_FAIL_MAX_RETIRED_PAGES].val.llval);
+            break;
+        }
+
+        case DCGM_VIOLATION_POLICY_FAIL_THERMAL:
+            ReportThermalValues(fv, (unsigned int)rule.threshold);
+            break;
+
+        case DCGM_VIOLATION_POLICY_FAIL_POWER:
+            ReportPowerValues(fv, (unsigned int)rule.threshold);
+            break;
+
+        case DCGM_VIOLATION_POLICY_FAIL_NVLINK:
+            ReportNVLinkErrors(fv);
+            break;
+
+        case DCGM_VIOLATION_POLICY_FAIL_XID:
+            ReportXIDErrors(fv);
+            break;
+
+        default:
+            PRINT_ERROR("%u", "Unhandled alertType %u", rule.alertType);
+            break;
+    }
 }
 
 /****************************************************************************/
@@ -143,53 +297,118 @@ void DcgmPolicyManager::SetViolation(DcgmViolationPolicyAlert_t alertType,
 {
     PRINT_DEBUG("%u %u", "Setting a violation of type %u for gpuId %u", alertType, gpuId);
 
-    dcgm_msg_policy_notify_t notify;
+    /* Fold the violation into each watcher of this gpuId that matches our mask, then notify
+       the ones whose coalescing window is over. Note that you can bypass the windows with
+       injection since we use the fv timestamp and not the system time */
+    for (auto &watcher : m_gpus[gpuId].watchers)
+    {
+        if (!(watcher.conditions & response->condition))
+            continue;
+
+        dpm_pending_t &pending = watcher.pending[alertType];
+        if (pending.numViolations == 0)
+        {
+            pending.firstTimestamp = timestamp;
+        }
+        pending.numViolations++;
+        pending.lastTimestamp = timestamp;
+        memcpy(&pending.response, response, sizeof(*response));
 
-    memcpy(&notify.response, response, sizeof(notify.response));
+        if (NotifyPending(watcher, alertType, timestamp))
+        {
+            m_havePending = true;
+        }
+    }
+}
 
-    int64_t minimumSignalTimeDiff = 5000000; /* Only signal every 5 seconds at worst. Note that you
-                                                can bypass this with injection since we use the fv timestamp
-                                                and not the system time */
-    std::vector<dpm_watcher_t>::iterator watcherIt;
+/****************************************************************************/
+bool DcgmPolicyManager::NotifyPending(dpm_watcher_t &watcher, DcgmViolationPolicyAlert_t alertType, int64_t now)
+{
+    dpm_pending_t &pending = watcher.pending[alertType];
+    if (pending.numViolations == 0)
+    {
+        return false;
+    }
 
-    /* Walk the callbacks for this gpuId and trigger any that match our mask */
-    for (watcherIt = m_gpus[gpuId].watchers.begin(); watcherIt != m_gpus[gpuId].watchers.end(); ++watcherIt)
+    if (pending.windowStart != 0 && now - pending.windowStart < watcher.coalesceWindowUsec)
     {
-        if (!(watcherIt->conditions & response->condition))
-            continue;
+        return true;
+    }
 
-        if (timestamp - watcherIt->lastSentTimestamp[alertType] < minimumSignalTimeDiff)
+    if (watcher.maxNotificationsPerSec != 0)
+    {
+        dpm_rate_limit_t &rateLimit = *watcher.rateLimit;
+        if (now > rateLimit.lastRefill)
+        {
+            double refill        = (now - rateLimit.lastRefill) * watcher.maxNotificationsPerSec / 1000000.0;
+            rateLimit.tokens     = std::min(rateLimit.tokens + refill, (double)watcher.maxNotificationsPerSec);
+            rateLimit.lastRefill = now;
+        }
+
+        if (rateLimit.tokens < 1.0)
         {
-            PRINT_DEBUG("%u %lld",
-                        "Not violating type %u due to timestamp difference being < %lld",
+            PRINT_DEBUG("%u %u %u",
+                        "Rate limited alertType %u for connectionId %u, requestId %u",
                         alertType,
-                        (long long)minimumSignalTimeDiff);
-            continue;
+                        watcher.connectionId,
+                        watcher.requestId);
+            return true;
         }
+        rateLimit.tokens -= 1.0;
+    }
 
-        /* OK. We're going to signal this watcher */
-        PRINT_DEBUG("%u %u %u %u %lld",
-                    "Notifying alertType %u, gpuId %u, connectionId %u, requestId %u, ts %lld",
-                    alertType,
-                    gpuId,
-                    watcherIt->connectionId,
-                    watcherIt->requestId,
-                    (long long)timestamp);
+    dcgm_msg_policy_notify_t notify {};
+    notify.response         = pending.response;
+    notify.response.version = watcher.responseVersion;
+    if (watcher.responseVersion == dcgmPolicyCallbackResponse_version2)
+    {
+        notify.response.numViolations  = pending.numViolations;
+        notify.response.firstTimestamp = pending.firstTimestamp;
+        notify.response.lastTimestamp  = pending.lastTimestamp;
+    }
+
+    PRINT_DEBUG("%u %u %u %u %lld",
+                "Notifying alertType %u, connectionId %u, requestId %u, numViolations %u, ts %lld",
+                alertType,
+                watcher.connectionId,
+                watcher.requestId,
+                pending.numViolations,
+                (long long)pending.lastTimestamp);
+
+    notify.begin = 1;
+    mpCoreProxy.SendRawMessageToClient(
+        watcher.connectionId, DCGM_MSG_POLICY_NOTIFY, watcher.requestId, &notify, sizeof(notify), DCGM_ST_OK);
 
-        notify.begin = 1;
-        mpCoreProxy.SendRawMessageToClient(
-            watcherIt->connectionId, DCGM_MSG_POLICY_NOTIFY, watcherIt->requestId, &notify, sizeof(notify), DCGM_ST_OK);
+    /* Note: we used to sometimes reset the GPU here or run a diagnostic, but that proved to just
+             cause more problems than anything. Instead, we'll just call the callback twice to
+             not regress behavior */
 
-        /* Note: we used to sometimes reset the GPU here or run a diagnostic, but that proved to just
-                 cause more problems than anything. Instead, we'll just call the callback twice to
-                 not regress behavior */
+    notify.begin = 0;
+    mpCoreProxy.SendRawMessageToClient(
+        watcher.connectionId, DCGM_MSG_POLICY_NOTIFY, watcher.requestId, &notify, sizeof(notify), DCGM_ST_OK);
 
-        notify.begin = 0;
-        mpCoreProxy.SendRawMessageToClient(
-            watcherIt->connectionId, DCGM_MSG_POLICY_NOTIFY, watcherIt->requestId, &notify, sizeof(notify), DCGM_ST_OK);
+    pending.windowStart   = now;
+    pending.numViolations = 0;
+    return false;
+}
+
+/****************************************************************************/
+void DcgmPolicyManager::FlushPending(int64_t now)
+{
+    m_havePending = false;
 
-        /* Set the last seen time so we don't spam this watcher */
-        watcherIt->lastSentTimestamp[alertType] = timestamp;
+    for (int i = 0; i < m_numGpus; i++)
+    {
+        for (auto &watcher : m_gpus[i].watchers)
+        {
+            for (unsigned int alertType = 0; alertType < DCGM_VIOLATION_POLICY_FAIL_COUNT; alertType++)
+            {
+                if (NotifyPending(watcher, (DcgmViolationPolicyAlert_t)alertType, now))
+                {
+                    m_havePending = true;
+                }
+            }
+        }
     }
 }
 
@@ -215,114 +434,50 @@ dcgmReturn_t DcgmPolicyManager::UnregisterForPolicy(dcgm_policy_msg_unregister_t
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmPolicyManager::CheckEccErrors(dcgmBufferedFv_t *fv)
+void DcgmPolicyManager::ReportEccErrors(dcgmBufferedFv_t const *fv)
 {
-    if (fv->status != DCGM_ST_OK || DCGM_INT64_IS_BLANK(fv->value.i64))
-    {
-        PRINT_DEBUG(
-            "%u %u %d", "Skipping gpuId %u ECC fieldId %u with status %d", fv->entityId, fv->fieldId, fv->status);
-        return DCGM_ST_OK;
-    }
-
-    if (!(m_gpus[fv->entityId].currentPolicies.condition & DCGM_POLICY_COND_DBE))
-    {
-        PRINT_DEBUG("%u %u %X",
-                    "Skipping gpuId %u ECC fieldId %u with condition mask x%X",
-                    fv->entityId,
-                    fv->fieldId,
-                    m_gpus[fv->entityId].currentPolicies.condition);
-        return DCGM_ST_OK;
-    }
-
     unsigned int errorCount = fv->value.i64;
-    PRINT_DEBUG("%u %u", "CheckEccErrors gpuId %u, errorCount %u", fv->entityId, errorCount);
 
-    if (errorCount > 0) // violation has occurred
-    {
-        dcgmPolicyCallbackResponse_t callbackResponse;
-        dcgmPolicyConditionDbe_t dbeResponse;
-
-        callbackResponse.version   = dcgmPolicyCallbackResponse_version;
-        callbackResponse.condition = DCGM_POLICY_COND_DBE;
-        dbeResponse.timestamp      = fv->timestamp;
-        dbeResponse.location       = dcgmPolicyConditionDbe_t::DEVICE;
-        dbeResponse.numerrors      = errorCount;
+    dcgmPolicyCallbackResponse_t callbackResponse;
+    dcgmPolicyConditionDbe_t dbeResponse;
 
-        callbackResponse.val.dbe = dbeResponse;
+    callbackResponse.version   = dcgmPolicyCallbackResponse_version;
+    callbackResponse.condition = DCGM_POLICY_COND_DBE;
+    dbeResponse.timestamp      = fv->timestamp;
+    dbeResponse.location       = dcgmPolicyConditionDbe_t::DEVICE;
+    dbeResponse.numerrors      = errorCount;
 
-        PRINT_ERROR("%u %u", "gpuId %u has > 0 ECC double-bit errors: %u", fv->entityId, errorCount);
-        SetViolation(DCGM_VIOLATION_POLICY_FAIL_ECC_DBE, fv->entityId, fv->timestamp, &callbackResponse);
-    }
+    callbackResponse.val.dbe = dbeResponse;
 
-    return DCGM_ST_OK;
+    PRINT_ERROR("%u %u", "gpuId %u has > 0 ECC double-bit errors: %u", fv->entityId, errorCount);
+    SetViolation(DCGM_VIOLATION_POLICY_FAIL_ECC_DBE, fv->entityId, fv->timestamp, &callbackResponse);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmPolicyManager::CheckPcieErrors(dcgmBufferedFv_t *fv)
+void DcgmPolicyManager::ReportPcieErrors(dcgmBufferedFv_t const *fv)
 {
-    if (fv->status != DCGM_ST_OK || DCGM_INT64_IS_BLANK(fv->value.i64))
-    {
-        PRINT_DEBUG(
-            "%u %u %d", "Skipping gpuId %u PCIe fieldId %u with status %d", fv->entityId, fv->fieldId, fv->status);
-        return DCGM_ST_OK;
-    }
-
-    if (!(m_gpus[fv->entityId].currentPolicies.condition & DCGM_POLICY_COND_PCI))
-    {
-        PRINT_DEBUG("%u %u %X",
-                    "Skipping gpuId %u PCIe fieldId %u with condition mask x%X",
-                    fv->entityId,
-                    fv->fieldId,
-                    m_gpus[fv->entityId].currentPolicies.condition);
-        return DCGM_ST_OK;
-    }
-
     unsigned int errorCount = (unsigned int)fv->value.i64;
-    if (errorCount > 0)
-    {
-        dcgmPolicyCallbackResponse_t callbackResponse;
-        dcgmPolicyConditionPci_t pciResponse;
 
-        callbackResponse.version   = dcgmPolicyCallbackResponse_version;
-        callbackResponse.condition = DCGM_POLICY_COND_PCI;
-        pciResponse.timestamp      = fv->timestamp;
-        pciResponse.counter        = errorCount;
+    dcgmPolicyCallbackResponse_t callbackResponse;
+    dcgmPolicyConditionPci_t pciResponse;
 
-        callbackResponse.val.pci = pciResponse;
+    callbackResponse.version   = dcgmPolicyCallbackResponse_version;
+    callbackResponse.condition = DCGM_POLICY_COND_PCI;
+    pciResponse.timestamp      = fv->timestamp;
+    pciResponse.counter        = errorCount;
 
-        PRINT_ERROR("%u %u",
-                    "gpuId %u has > 0 PCIe replays: %u. This may be causing throughput issues.",
-                    fv->entityId,
-                    errorCount);
-        SetViolation(DCGM_VIOLATION_POLICY_FAIL_PCIE, fv->entityId, fv->timestamp, &callbackResponse);
-    }
+    callbackResponse.val.pci = pciResponse;
 
-    return DCGM_ST_OK;
+    PRINT_ERROR("%u %u",
+                "gpuId %u has > 0 PCIe replays: %u. This may be causing throughput issues.",
+                fv->entityId,
+                errorCount);
+    SetViolation(DCGM_VIOLATION_POLICY_FAIL_PCIE, fv->entityId, fv->timestamp, &callbackResponse);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmPolicyManager::CheckRetiredPages(dcgmBufferedFv_t *fv)
+void DcgmPolicyManager::ReportRetiredPages(dcgmBufferedFv_t const *fv, unsigned int maxRetiredPages)
 {
-    if (fv->status != DCGM_ST_OK || DCGM_INT64_IS_BLANK(fv->value.i64))
-    {
-        PRINT_DEBUG("%u %u %d",
-                    "Skipping gpuId %u retired pages fieldId %u with status %d",
-                    fv->entityId,
-                    fv->fieldId,
-                    fv->status);
-        return DCGM_ST_OK;
-    }
-
-    if (!(m_gpus[fv->entityId].currentPolicies.condition & DCGM_POLICY_COND_MAX_PAGES_RETIRED))
-    {
-        PRINT_DEBUG("%u %u %X",
-                    "Skipping gpuId %u retired pages fieldId %u with condition mask x%X",
-                    fv->entityId,
-                    fv->fieldId,
-                    m_gpus[fv->entityId].currentPolicies.condition);
-        return DCGM_ST_OK;
-    }
-
     unsigned int pageCountSbe = 0, pageCountDbe = 0;
     dcgmcm_sample_t sample;
     dcgmReturn_t dcgmReturn;
@@ -340,17 +495,17 @@ dcgmReturn_t DcgmPolicyManager::CheckRetiredPages(dcgmBufferedFv_t *fv)
             if (dcgmReturn == DCGM_ST_NOT_SUPPORTED)
             {
                 PRINT_DEBUG("", "Retired SBE pages not supported");
-                return DCGM_ST_OK;
+                return;
             }
 
             PRINT_WARNING("%d", "Get latest sample of SBE pending retired pages failed with error %d", (int)dcgmReturn);
-            return DCGM_ST_GENERIC_ERROR;
+            return;
         }
 
         if (DCGM_INT64_NOT_SUPPORTED == sample.val.i64)
         {
             PRINT_DEBUG("", "Retired SBE pages not supported");
-            return DCGM_ST_OK; /* Retired SBE pages not supported */
+            return; /* Retired SBE pages not supported */
         }
 
         pageCountSbe = (unsigned int)sample.val.i64;
@@ -365,13 +520,13 @@ dcgmReturn_t DcgmPolicyManager::CheckRetiredPages(dcgmBufferedFv_t *fv)
         if (dcgmReturn)
         {
             PRINT_WARNING("%d", "Get latest sample of DBE pending retired pages failed with error %d", (int)dcgmReturn);
-            return DCGM_ST_GENERIC_ERROR;
+            return;
         }
 
         if (DCGM_INT64_NOT_SUPPORTED == sample.val.i64)
         {
             PRINT_DEBUG("", "Retired DBE pages not supported");
-            return DCGM_ST_OK; /* Retired DBE pages not supported */
+            return; /* Retired DBE pages not supported */
         }
 
         pageCountDbe = (unsigned int)sample.val.i64;
@@ -381,10 +536,6 @@ dcgmReturn_t DcgmPolicyManager::CheckRetiredPages(dcgmBufferedFv_t *fv)
     // use the oldest error timestamp
     timestamp = DCGM_MIN(sbeTimestamp, dbeTimestamp);
 
-    unsigned int maxRetiredPages = (unsigned int)m_gpus[fv->entityId]
-                                       .currentPolicies.parms[DCGM_VIOLATION_POLICY_FAIL_MAX_RETIRED_PAGES]
-                                       .val.llval;
-
     if (pageCountDbe + pageCountSbe > maxRetiredPages)
     {
         dcgmPolicyCallbackResponse_t callbackResponse;
@@ -405,168 +556,76 @@ dcgmReturn_t DcgmPolicyManager::CheckRetiredPages(dcgmBufferedFv_t *fv)
                     maxRetiredPages);
         SetViolation(DCGM_VIOLATION_POLICY_FAIL_MAX_RETIRED_PAGES, fv->entityId, fv->timestamp, &callbackResponse);
     }
-
-    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmPolicyManager::CheckThermalValues(dcgmBufferedFv_t *fv)
+void DcgmPolicyManager::ReportThermalValues(dcgmBufferedFv_t const *fv, unsigned int maxTemp)
 {
-    if (fv->status != DCGM_ST_OK || DCGM_INT64_IS_BLANK(fv->value.i64))
-    {
-        PRINT_DEBUG("%u %u %d",
-                    "Skipping gpuId %u temperature fieldId %u with status %d",
-                    fv->entityId,
-                    fv->fieldId,
-                    fv->status);
-        return DCGM_ST_OK;
-    }
-
-    if (!(m_gpus[fv->entityId].currentPolicies.condition & DCGM_POLICY_COND_THERMAL))
-    {
-        PRINT_DEBUG("%u %u %X",
-                    "Skipping gpuId %u temperature fieldId %u with condition mask x%X",
-                    fv->entityId,
-                    fv->fieldId,
-                    m_gpus[fv->entityId].currentPolicies.condition);
-        return DCGM_ST_OK;
-    }
-
     unsigned int gpuTemp = (unsigned int)fv->value.i64;
-    unsigned int maxTemp
-        = (unsigned int)m_gpus[fv->entityId].currentPolicies.parms[DCGM_VIOLATION_POLICY_FAIL_THERMAL].val.llval;
-    if ((unsigned int)gpuTemp > maxTemp)
-    {
-        dcgmPolicyCallbackResponse_t callbackResponse;
-        dcgmPolicyConditionThermal_t thermalResponse;
 
-        callbackResponse.version         = dcgmPolicyCallbackResponse_version;
-        callbackResponse.condition       = DCGM_POLICY_COND_THERMAL;
-        thermalResponse.timestamp        = fv->timestamp;
-        thermalResponse.thermalViolation = gpuTemp;
+    dcgmPolicyCallbackResponse_t callbackResponse;
+    dcgmPolicyConditionThermal_t thermalResponse;
 
-        callbackResponse.val.thermal = thermalResponse;
+    callbackResponse.version         = dcgmPolicyCallbackResponse_version;
+    callbackResponse.condition       = DCGM_POLICY_COND_THERMAL;
+    thermalResponse.timestamp        = fv->timestamp;
+    thermalResponse.thermalViolation = gpuTemp;
 
-        PRINT_ERROR("%u %u %u",
-                    "gpuId %u has violated thermal settings: %u > max allowed temp %u.",
-                    fv->entityId,
-                    gpuTemp,
-                    maxTemp);
-        SetViolation(DCGM_VIOLATION_POLICY_FAIL_THERMAL, fv->entityId, fv->timestamp, &callbackResponse);
-    }
+    callbackResponse.val.thermal = thermalResponse;
 
-    return DCGM_ST_OK;
+    PRINT_ERROR("%u %u %u",
+                "gpuId %u has violated thermal settings: %u > max allowed temp %u.",
+                fv->entityId,
+                gpuTemp,
+                maxTemp);
+    SetViolation(DCGM_VIOLATION_POLICY_FAIL_THERMAL, fv->entityId, fv->timestamp, &callbackResponse);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmPolicyManager::CheckPowerValues(dcgmBufferedFv_t *fv)
+void DcgmPolicyManager::ReportPowerValues(dcgmBufferedFv_t const *fv, unsigned int maxPower)
 {
-    if (fv->status != DCGM_ST_OK || DCGM_INT64_IS_BLANK(fv->value.i64))
-    {
-        PRINT_DEBUG(
-            "%u %u %d", "Skipping gpuId %u power fieldId %u with status %d", fv->entityId, fv->fieldId, fv->status);
-        return DCGM_ST_OK;
-    }
-
-    if (!(m_gpus[fv->entityId].currentPolicies.condition & DCGM_POLICY_COND_POWER))
-    {
-        PRINT_DEBUG("%u %u %X",
-                    "Skipping gpuId %u power fieldId %u with condition mask x%X",
-                    fv->entityId,
-                    fv->fieldId,
-                    m_gpus[fv->entityId].currentPolicies.condition);
-        return DCGM_ST_OK;
-    }
-
     unsigned int gpuPower = (unsigned int)fv->value.dbl;
-    unsigned int maxPower
-        = (unsigned int)m_gpus[fv->entityId].currentPolicies.parms[DCGM_VIOLATION_POLICY_FAIL_POWER].val.llval;
-    if (gpuPower > maxPower)
-    {
-        dcgmPolicyCallbackResponse_t callbackResponse;
-        dcgmPolicyConditionPower_t powerResponse;
 
-        callbackResponse.version     = dcgmPolicyCallbackResponse_version;
-        callbackResponse.condition   = DCGM_POLICY_COND_POWER;
-        powerResponse.timestamp      = fv->timestamp;
-        powerResponse.powerViolation = gpuPower;
+    dcgmPolicyCallbackResponse_t callbackResponse;
+    dcgmPolicyConditionPower_t powerResponse;
 
-        callbackResponse.val.power = powerResponse;
+    callbackResponse.version     = dcgmPolicyCallbackResponse_version;
+    callbackResponse.condition   = DCGM_POLICY_COND_POWER;
+    powerResponse.timestamp      = fv->timestamp;
+    powerResponse.powerViolation = gpuPower;
 
-        PRINT_ERROR(
-            "%u %u %u", "gpuId %u has violated power settings: %u > max allowed %u", fv->entityId, gpuPower, maxPower);
-        SetViolation(DCGM_VIOLATION_POLICY_FAIL_POWER, fv->entityId, fv->timestamp, &callbackResponse);
-    }
+    callbackResponse.val.power = powerResponse;
 
-    return DCGM_ST_OK;
+    PRINT_ERROR(
+        "%u %u %u", "gpuId %u has violated power settings: %u > max allowed %u", fv->entityId, gpuPower, maxPower);
+    SetViolation(DCGM_VIOLATION_POLICY_FAIL_POWER, fv->entityId, fv->timestamp, &callbackResponse);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmPolicyManager::CheckNVLinkErrors(dcgmBufferedFv_t *fv)
+void DcgmPolicyManager::ReportNVLinkErrors(dcgmBufferedFv_t const *fv)
 {
-    if (fv->status != DCGM_ST_OK || DCGM_INT64_IS_BLANK(fv->value.i64))
-    {
-        PRINT_DEBUG("%u %u %d",
-                    "Skipping gpuId %u NvLink counter fieldId %u with status %d",
-                    fv->entityId,
-                    fv->fieldId,
-                    fv->status);
-        return DCGM_ST_OK;
-    }
-
-    if (!(m_gpus[fv->entityId].currentPolicies.condition & DCGM_POLICY_COND_NVLINK))
-    {
-        PRINT_DEBUG("%u %u %X",
-                    "Skipping gpuId %u NvLink counter fieldId %u with condition mask x%X",
-                    fv->entityId,
-                    fv->fieldId,
-                    m_gpus[fv->entityId].currentPolicies.condition);
-        return DCGM_ST_OK;
-    }
-
-    if (fv->value.i64 > 0)
-    {
-        dcgmPolicyCallbackResponse_t callbackResponse;
-        dcgmPolicyConditionNvlink_t nvlinkResponse;
-
-        callbackResponse.version   = dcgmPolicyCallbackResponse_version;
-        callbackResponse.condition = DCGM_POLICY_COND_NVLINK;
-        nvlinkResponse.timestamp   = fv->timestamp;
-        nvlinkResponse.fieldId     = (unsigned short)fv->fieldId;
-        nvlinkResponse.counter     = fv->value.i64;
-
-        callbackResponse.val.nvlink = nvlinkResponse;
+    dcgmPolicyCallbackResponse_t callbackResponse;
+    dcgmPolicyConditionNvlink_t nvlinkResponse;
 
-        PRINT_ERROR("%u %s %lld",
-                    "gpuId %u has > 0 Nvlink %s: %lld. This may be causing throughput issues.",
-                    fv->entityId,
-                    ConvertNVLinkCounterTypeToString(fv->fieldId),
-                    (long long)fv->value.i64);
-        SetViolation(DCGM_VIOLATION_POLICY_FAIL_NVLINK, fv->entityId, fv->timestamp, &callbackResponse);
-    }
-    return DCGM_ST_OK;
+    callbackResponse.version   = dcgmPolicyCallbackResponse_version;
+    callbackResponse.condition = DCGM_POLICY_COND_NVLINK;
+    nvlinkResponse.timestamp   = fv->timestamp;
+    nvlinkResponse.fieldId     = (unsigned short)fv->fieldId;
+    nvlinkResponse.counter     = fv->value.i64;
+
+    callbackResponse.val.nvlink = nvlinkResponse;
+
+    PRINT_ERROR("%u %s %lld",
+                "gpuId %u has > 0 Nvlink %s: %lld. This may be causing throughput issues.",
+                fv->entityId,
+                ConvertNVLinkCounterTypeToString(fv->fieldId),
+                (long long)fv->value.i64);
+    SetViolation(DCGM_VIOLATION_POLICY_FAIL_NVLINK, fv->entityId, fv->timestamp, &callbackResponse);
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmPolicyManager::CheckXIDErrors(dcgmBufferedFv_t *fv)
+void DcgmPolicyManager::ReportXIDErrors(dcgmBufferedFv_t const *fv)
 {
-    if (fv->status != DCGM_ST_OK || DCGM_INT64_IS_BLANK(fv->value.i64))
-    {
-        PRINT_DEBUG(
-            "%u %u %d", "Skipping gpuId %u XID fieldId %u with status %d", fv->entityId, fv->fieldId, fv->status);
-        return DCGM_ST_OK;
-    }
-
-    if (!(m_gpus[fv->entityId].currentPolicies.condition & DCGM_POLICY_COND_XID))
-    {
-        PRINT_DEBUG("%u %u %X",
-                    "Skipping gpuId %u XID fieldId %u with condition mask x%X",
-                    fv->entityId,
-                    fv->fieldId,
-                    m_gpus[fv->entityId].currentPolicies.condition);
-        return DCGM_ST_OK;
-    }
-
     dcgmPolicyCallbackResponse_t callbackResponse;
     dcgmPolicyConditionXID_t xidResponse;
 
@@ -579,7 +638,6 @@ dcgmReturn_t DcgmPolicyManager::CheckXIDErrors(dcgmBufferedFv_t *fv)
 
     PRINT_ERROR("%u %d", "gpuId %u has XID error: %d.", fv->entityId, (int)fv->value.i64);
     SetViolation(DCGM_VIOLATION_POLICY_FAIL_XID, fv->entityId, fv->timestamp, &callbackResponse);
-    return DCGM_ST_OK;
 }
 
 /*****************************************************************************/
@@ -604,18 +662,8 @@ char *DcgmPolicyManager::ConvertNVLinkCounterTypeToString(unsigned short fieldId
 /*****************************************************************************/
 dcgmReturn_t DcgmPolicyManager::WatchFields(dcgm_connection_id_t connectionId)
 {
-    int numFieldIds                    = 11; /* Should be same value as size of fieldIds */
-    static unsigned short fieldIds[11] = { DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_COUNT_TOTAL,
-                                           DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_COUNT_TOTAL,
-                                           DCGM_FI_DEV_NVLINK_REPLAY_ERROR_COUNT_TOTAL,
-                                           DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_COUNT_TOTAL,
-                                           DCGM_FI_DEV_ECC_DBE_VOL_DEV,
-                                           DCGM_FI_DEV_RETIRED_SBE,
-                                           DCGM_FI_DEV_RETIRED_DBE,
-                                           DCGM_FI_DEV_GPU_TEMP,
-                                           DCGM_FI_DEV_XID_ERRORS,
-                                           DCGM_FI_DEV_POWER_USAGE,
-                                           DCGM_FI_DEV_PCIE_REPLAY_COUNTER };
+    int numFieldIds                = DPM_NUM_RULE_FIELDS;
+    unsigned short const *fieldIds = s_ruleFieldIds;
     int i;
     unsigned int gpuId;
     dcgmReturn_t dcgmReturn;
@@ -666,7 +714,7 @@ dcgmReturn_t DcgmPolicyManager::WatchFields(dcgm_connection_id_t connectionId)
 }
 
 /*****************************************************************************/
-dcgmReturn_t DcgmPolicyManager::RegisterForPolicy(dcgm_policy_msg_register_t *msg)
+dcgmReturn_t DcgmPolicyManager::RegisterForPolicy(dcgm_policy_msg_register_v2 *msg, unsigned int responseVersion)
 {
     unsigned int groupId = (uintptr_t)msg->groupId;
     dcgmReturn_t dcgmReturn;
@@ -678,6 +726,12 @@ dcgmReturn_t DcgmPolicyManager::RegisterForPolicy(dcgm_policy_msg_register_t *ms
         return DCGM_ST_BADPARAM;
     }
 
+    if (msg->coalesceWindowUsec < 0)
+    {
+        PRINT_ERROR("%lld", "Bad coalesceWindowUsec %lld", msg->coalesceWindowUsec);
+        return DCGM_ST_BADPARAM;
+    }
+
     /* Verify group id is valid */
     dcgmReturn = mpCoreProxy.VerifyAndUpdateGroupId(&groupId);
     if (DCGM_ST_OK != dcgmReturn)
@@ -693,11 +747,15 @@ dcgmReturn_t DcgmPolicyManager::RegisterForPolicy(dcgm_policy_msg_register_t *ms
         return dcgmReturn;
     }
 
-    dpm_watcher_t newWatcher;
-    newWatcher.connectionId = msg->header.connectionId;
-    newWatcher.requestId    = msg->header.requestId;
-    memset(&newWatcher.lastSentTimestamp, 0, sizeof(newWatcher.lastSentTimestamp));
-    newWatcher.conditions = msg->condition;
+    dpm_watcher_t newWatcher {};
+    newWatcher.connectionId           = msg->header.connectionId;
+    newWatcher.requestId              = msg->header.requestId;
+    newWatcher.conditions             = msg->condition;
+    newWatcher.responseVersion        = responseVersion;
+    newWatcher.coalesceWindowUsec     = msg->coalesceWindowUsec;
+    newWatcher.maxNotificationsPerSec = msg->maxNotificationsPerSec;
+    newWatcher.rateLimit              = std::make_shared<dpm_rate_limit_t>();
+    newWatcher.rateLimit->tokens      = msg->maxNotificationsPerSec;
 
     dcgm_mutex_lock(m_mutex);
 
@@ -770,6 +828,7 @@ dcgmReturn_t DcgmPolicyManager::ProcessSetPolicy(dcgm_policy_msg_set_policy_t *m
         m_gpus[gpuId].policiesHaveBeenSet = true;
 
         memcpy(&m_gpus[gpuId].currentPolicies, &msg->policy, sizeof(m_gpus[gpuId].currentPolicies));
+        CompileRules(gpuId);
 
         PRINT_DEBUG("%u %X %u",
                     "connectionId %u set policy mask x%X for gpuId %u",
@@ -20,6 +20,7 @@
 #include "DcgmProtocol.h"
 #include "dcgm_policy_structs.h"
 #include <DcgmCoreProxy.h>
+#include <memory>
 
 /* These are array indexes that correspond with DCGM_POLICY_COND_* bitmasks */
 typedef enum DcgmViolationPolicyAlert_enum
@@ -39,6 +40,24 @@ typedef enum DcgmViolationPolicyAlert_enum
 /* The number of bitmask entries and the count of their corresponding indexes must be the same */
 DCGM_CASSERT(DCGM_POLICY_COND_MAX == DCGM_VIOLATION_POLICY_FAIL_COUNT, DCGM_POLICY_COND_MAX);
 
+/* Violations of one kind on one GPU that a watcher hasn't been notified of yet */
+typedef struct
+{
+    int64_t windowStart;                    /* Timestamp of the last notification. Violations are folded in
+                                               here until coalesceWindowUsec after it */
+    unsigned int numViolations;             /* Violations folded in since the last notification */
+    int64_t firstTimestamp;                 /* Of the first folded violation */
+    int64_t lastTimestamp;                  /* Of the last folded violation */
+    dcgmPolicyCallbackResponse_v2 response; /* Of the last folded violation */
+} dpm_pending_t;
+
+/* Notification budget of a registration, shared by the per-GPU copies of its watcher */
+typedef struct
+{
+    double tokens;      /* Notifications that can be sent right away */
+    int64_t lastRefill; /* Timestamp tokens were last topped up at */
+} dpm_rate_limit_t;
+
 /* A watcher of policy */
 typedef struct
 {
@@ -46,15 +65,30 @@ typedef struct
     dcgm_connection_id_t connectionId; /* Associated connection */
     dcgm_request_id_t requestId;       /* Request ID that owns this watch */
     /* Attributes */
-    int64_t lastSentTimestamp[DCGM_VIOLATION_POLICY_FAIL_COUNT];
-    /* What was the timestamp of the last
-                                          fv that caused us to trigger this.
-                                          Use this to make sure we don't spam
-                                          notifications */
-    dcgmPolicyCondition_t conditions; /* A mask of policy conditions that this
-                                          connection+request wants callbacks for */
+    dcgmPolicyCondition_t conditions;      /* A mask of policy conditions that this
+                                              connection+request wants callbacks for */
+    unsigned int responseVersion;          /* dcgmPolicyCallbackResponse_version1 or 2 */
+    int64_t coalesceWindowUsec;            /* See dcgmPolicyRegisterParams_v1 */
+    unsigned int maxNotificationsPerSec;   /* See dcgmPolicyRegisterParams_v1 */
+    std::shared_ptr<dpm_rate_limit_t> rateLimit;
+    dpm_pending_t pending[DCGM_VIOLATION_POLICY_FAIL_COUNT]; /* By alert type. Timestamps are of the fvs
+                                                                that caused the violations, so that
+                                                                windows line up with the samples */
 } dpm_watcher_t;
 
+/* Fields that policies are evaluated on. See DcgmPolicyManager::WatchFields() */
+#define DPM_NUM_RULE_FIELDS 11
+#define DPM_NO_RULE         0xFF /* Index of fields without a rule */
+
+/* A policy threshold compiled for one field of one GPU. See DcgmPolicyManager::CompileRules() */
+typedef struct
+{
+    bool active;                          /* Does the GPU's policy check this field? */
+    bool fp64;                            /* Is the value fp64 rather than int64? */
+    long long threshold;                  /* Values > this are violations */
+    DcgmViolationPolicyAlert_t alertType; /* What kind of violation it is */
+} dpm_rule_t;
+
 /* Per-GPU Policy context information */
 typedef struct
 {
@@ -66,6 +100,8 @@ typedef struct
                                      Conditions are global to a GPU. Which conditions
                                      trigger callbacks are per-watcher in watchers[] */
     std::vector<dpm_watcher_t> watchers; /* connectionId+requestIds that care about this */
+    dpm_rule_t rules[DPM_NUM_RULE_FIELDS]; /* currentPolicies compiled by rule field index. Inactive until
+                                              policies have been set */
 } dpm_gpu_t;
 
 /******************************************************************
@@ -81,9 +117,10 @@ public:
 
     /*************************************************************************/
     /*
-     * Register for policy updates if a violation occurs
+     * Register for policy updates if a violation occurs. responseVersion is the
+     * dcgmPolicyCallbackResponse_t version the registration's notifications use
      */
-    dcgmReturn_t RegisterForPolicy(dcgm_policy_msg_register_t *msg);
+    dcgmReturn_t RegisterForPolicy(dcgm_policy_msg_register_v2 *msg, unsigned int responseVersion);
 
     /*************************************************************************/
     /*
@@ -119,7 +156,7 @@ public:
     /*
      * Process a field value we care about being updated
      */
-    void OnFieldValuesUpdate(DcgmFvBuffer *fvBuffer);
+    void OnFieldValuesUpdate(DcgmFvBuffer const *fvBuffer);
 
     /*************************************************************************/
 
@@ -138,20 +175,53 @@ private:
     int m_numGpus;
     dpm_gpu_t m_gpus[DCGM_MAX_NUM_DEVICES]; /* Per-GPU information */
 
+    /* The fields in the rules of each GPU and the index of each of them in dpm_gpu_t.rules,
+       or DPM_NO_RULE for fields policies don't look at */
+    static const unsigned short s_ruleFieldIds[DPM_NUM_RULE_FIELDS];
+    unsigned char m_ruleIndex[DCGM_FI_MAX_FIELDS];
+
+    /* Are there violations that were folded into dpm_watcher_t.pending but not notified yet? */
+    bool m_havePending;
+
+    /* Are the cache manager's predicates on our rule fields bypassed, since m_havePending was set? */
+    bool m_predicatesBypassed;
+
     /* methods */
     void SetViolation(DcgmViolationPolicyAlert_t alertType,
                       unsigned int gpuId,
                       int64_t timestamp,
                       dcgmPolicyCallbackResponse_t *callbackResponse);
 
-    /* error checking functions */
-    dcgmReturn_t CheckEccErrors(dcgmBufferedFv_t *fv);
-    dcgmReturn_t CheckPcieErrors(dcgmBufferedFv_t *fv);
-    dcgmReturn_t CheckRetiredPages(dcgmBufferedFv_t *fv);
-    dcgmReturn_t CheckThermalValues(dcgmBufferedFv_t *fv);
-    dcgmReturn_t CheckPowerValues(dcgmBufferedFv_t *fv);
-    dcgmReturn_t CheckNVLinkErrors(dcgmBufferedFv_t *fv);
-    dcgmReturn_t CheckXIDErrors(dcgmBufferedFv_t *fv);
+    /*************************************************************************/
+    /*
+     * Notify watcher of its pending violations of alertType if any, its
+     * coalescing window is over at now and its rate limit allows it
+     *
+     * Returns: Whether violations are still pending
+     */
+    bool NotifyPending(dpm_watcher_t &watcher, DcgmViolationPolicyAlert_t alertType, int64_t now);
+
+    /* Notify the watchers of all GPUs of the violations they can be notified of at now */
+    void FlushPending(int64_t now);
+
+    /*************************************************************************/
+    /*
+     * Compile the current policies of gpuId into its rules, so that evaluating
+     * a field value is a lookup and a compare. Caller holds m_mutex
+     */
+    void CompileRules(unsigned int gpuId);
+
+    /* Report fv, which broke rule. Called with m_mutex held */
+    void OnRuleViolated(dpm_rule_t const &rule, dcgmBufferedFv_t const *fv);
+
+    /* violation reporting functions. fv is past the threshold of its rule */
+    void ReportEccErrors(dcgmBufferedFv_t const *fv);
+    void ReportPcieErrors(dcgmBufferedFv_t const *fv);
+    void ReportRetiredPages(dcgmBufferedFv_t const *fv, unsigned int maxRetiredPages);
+    void ReportThermalValues(dcgmBufferedFv_t const *fv, unsigned int maxTemp);
+    void ReportPowerValues(dcgmBufferedFv_t const *fv, unsigned int maxPower);
+    void ReportNVLinkErrors(dcgmBufferedFv_t const *fv);
+    void ReportXIDErrors(dcgmBufferedFv_t const *fv);
 
     /* Helper function to convert Nvlink counters fieldIds to string */
     char *ConvertNVLinkCounterTypeToString(unsigned short fieldId);
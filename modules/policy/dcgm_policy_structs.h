@@ -24,7 +24,8 @@
 #define DCGM_POLICY_SR_SET_POLICY   2
 #define DCGM_POLICY_SR_REGISTER     3
 #define DCGM_POLICY_SR_UNREGISTER   4
-#define DCGM_POLICY_SR_COUNT        5 /* Keep as last entry and 1 greater */
+#define DCGM_POLICY_SR_REGISTER_V2  5
+#define DCGM_POLICY_SR_COUNT        6 /* Keep as last entry and 1 greater */
 
 /*****************************************************************************/
 /* Subrequest message definitions */
@@ -84,6 +85,28 @@ typedef struct dcgm_policy_msg_register_v1
 
 typedef dcgm_policy_msg_register_v1 dcgm_policy_msg_register_t;
 
+/*****************************************************************************/
+/**
+ * Subrequest DCGM_POLICY_SR_REGISTER_V2
+ *
+ * Registrations made with DCGM_POLICY_SR_REGISTER coalesce violations over
+ * DCGM_POLICY_DEFAULT_COALESCE_USEC and get dcgmPolicyCallbackResponse_v1 notifications
+ */
+typedef struct dcgm_policy_msg_register_v2
+{
+    dcgm_module_command_header_t header; /* Command header */
+
+    dcgmGpuGrp_t groupId;                /*  IN: Group ID to register for policy updates from */
+    dcgmPolicyCondition_t condition;     /*  IN: Policy condition to register for */
+    long long coalesceWindowUsec;        /*  IN: See dcgmPolicyRegisterParams_v1 */
+    unsigned int maxNotificationsPerSec; /*  IN: See dcgmPolicyRegisterParams_v1 */
+    unsigned int unused;                 /* Unused. Here to make the struct a multiple of 8 bytes */
+} dcgm_policy_msg_register_v2;
+
+#define dcgm_policy_msg_register_version2 MAKE_DCGM_VERSION(dcgm_policy_msg_register_v2, 2)
+
+#define DCGM_POLICY_DEFAULT_COALESCE_USEC 5000000 /* Only notify every 5 seconds at worst */
+
 /*****************************************************************************/
 /**
  * Subrequest DCGM_POLICY_SR_UNREGISTER
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <DcgmFvBuffer.h>
+#include <DcgmPolicyManager.h>
+#include <dcgm_core_communication.h>
+
+#include <vector>
+
+namespace
+{
+/* Stands in for the host engine. Group 0 holds GPU 0 and group 1 holds GPUs 0 and 1 */
+struct FakeCore
+{
+    std::vector<dcgm_msg_policy_notify_t> notifications;
+};
+
+dcgmReturn_t FakeCorePost(dcgm_module_command_header_t *header, void *poster)
+{
+    FakeCore *core = (FakeCore *)poster;
+
+    switch (header->subCommand)
+    {
+        case DcgmCoreReqIdCMGetGpuCount:
+        {
+            dcgmCoreGetGpuCount_t *ggc = (dcgmCoreGetGpuCount_t *)header;
+            ggc->response.uintAnswer   = 2;
+            break;
+        }
+
+        case DcgmCoreReqIdGMVerifyAndUpdateGroupId:
+        {
+            dcgmCoreBasicQuery_t *bq = (dcgmCoreBasicQuery_t *)header;
+            bq->response.uintAnswer  = bq->request.entityId;
+            break;
+        }
+
+        case DcgmCoreReqIdGMGetGroupEntities:
+        {
+            dcgmCoreGetGroupEntities_t *gge = (dcgmCoreGetGroupEntities_t *)header;
+            gge->response.entityPairsCount  = gge->request.groupId + 1;
+            for (unsigned int i = 0; i < gge->response.entityPairsCount; i++)
+            {
+                gge->response.entityPairs[i].entityGroupId = DCGM_FE_GPU;
+                gge->response.entityPairs[i].entityId      = i;
+            }
+            break;
+        }
+
+        case DcgmCoreReqIdSendRawMessage:
+        {
+            dcgmCoreSendRawMessage_t *msg = (dcgmCoreSendRawMessage_t *)header;
+            REQUIRE(msg->request.msgSize == sizeof(dcgm_msg_policy_notify_t));
+            core->notifications.push_back(*(dcgm_msg_policy_notify_t *)msg->request.msgData);
+            break;
+        }
+
+        default:
+            /* Watches, predicates and updates. Their zeroed responses are DCGM_ST_OK */
+            break;
+    }
+
+    return DCGM_ST_OK;
+}
+
+dcgmCoreCallbacks_t FakeCoreCallbacks(FakeCore &core)
+{
+    dcgmCoreCallbacks_t dcc = {};
+    dcc.version             = dcgmCoreCallbacks_version;
+    dcc.postfunc            = FakeCorePost;
+    dcc.poster              = &core;
+    return dcc;
+}
+
+/* Set a policy with thresholds for thermal and power on GPU 0 */
+void SetPolicy(DcgmPolicyManager &policyManager, dcgmPolicyCondition_t condition)
+{
+    dcgm_policy_msg_set_policy_t msg {};
+    msg.groupId          = (dcgmGpuGrp_t)0;
+    msg.policy.version   = dcgmPolicy_version;
+    msg.policy.condition = condition;
+
+    dcgmPolicyConditionParams_t &thermal = msg.policy.parms[DCGM_VIOLATION_POLICY_FAIL_THERMAL];
+    thermal.tag                          = dcgmPolicyConditionParams_t::LLONG;
+    thermal.val.llval                    = 80;
+
+    dcgmPolicyConditionParams_t &power = msg.policy.parms[DCGM_VIOLATION_POLICY_FAIL_POWER];
+    power.tag                          = dcgmPolicyConditionParams_t::LLONG;
+    power.val.llval                    = 200;
+
+    REQUIRE(policyManager.ProcessSetPolicy(&msg) == DCGM_ST_OK);
+}
+
+/* Register for every condition on GPUs 0 and 1, notified of each violation as it happens */
+void Register(DcgmPolicyManager &policyManager)
+{
+    dcgm_policy_msg_register_v2 msg {};
+    msg.header.connectionId = 1;
+    msg.header.requestId    = 1;
+    msg.groupId             = (dcgmGpuGrp_t)1;
+    msg.condition           = (dcgmPolicyCondition_t)0xFF;
+    REQUIRE(policyManager.RegisterForPolicy(&msg, dcgmPolicyCallbackResponse_version2) == DCGM_ST_OK);
+}
+} // namespace
+
+TEST_CASE("PolicyManager: Only values past a threshold are violations")
+{
+    FakeCore core;
+    dcgmCoreCallbacks_t dcc = FakeCoreCallbacks(core);
+    DcgmPolicyManager policyManager(dcc);
+
+    SetPolicy(policyManager, (dcgmPolicyCondition_t)(DCGM_POLICY_COND_THERMAL | DCGM_POLICY_COND_POWER));
+    Register(policyManager);
+
+    DcgmFvBuffer fvBuffer;
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 80, 1000, DCGM_ST_OK);
+    fvBuffer.AddDoubleValue(DCGM_FE_GPU, 0, DCGM_FI_DEV_POWER_USAGE, 150.0, 1000, DCGM_ST_OK);
+    policyManager.OnFieldValuesUpdate(&fvBuffer);
+    CHECK(core.notifications.empty());
+
+    /* Each violation is notified twice: once for the begin callback and once for the finish callback */
+    fvBuffer.Clear();
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 81, 2000, DCGM_ST_OK);
+    policyManager.OnFieldValuesUpdate(&fvBuffer);
+    REQUIRE(core.notifications.size() == 2);
+    CHECK(core.notifications[0].begin == 1);
+    CHECK(core.notifications[1].begin == 0);
+    CHECK(core.notifications[0].response.condition == DCGM_POLICY_COND_THERMAL);
+    CHECK(core.notifications[0].response.val.thermal.thermalViolation == 81);
+    CHECK(core.notifications[0].response.val.thermal.timestamp == 2000);
+
+    /* Power is evaluated on its fp64 value */
+    core.notifications.clear();
+    fvBuffer.Clear();
+    fvBuffer.AddDoubleValue(DCGM_FE_GPU, 0, DCGM_FI_DEV_POWER_USAGE, 250.0, 3000, DCGM_ST_OK);
+    policyManager.OnFieldValuesUpdate(&fvBuffer);
+    REQUIRE(core.notifications.size() == 2);
+    CHECK(core.notifications[0].response.condition == DCGM_POLICY_COND_POWER);
+    CHECK(core.notifications[0].response.val.power.powerViolation == 250);
+}
+
+TEST_CASE("PolicyManager: Values without an active rule are ignored")
+{
+    FakeCore core;
+    dcgmCoreCallbacks_t dcc = FakeCoreCallbacks(core);
+    DcgmPolicyManager policyManager(dcc);
+
+    SetPolicy(policyManager, DCGM_POLICY_COND_THERMAL);
+    Register(policyManager);
+
+    DcgmFvBuffer fvBuffer;
+
+    /* The policy's condition doesn't have XIDs, which are violations at any value */
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_XID_ERRORS, 31, 1000, DCGM_ST_OK);
+    /* GPU 1 has a watcher but no policy */
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 1, DCGM_FI_DEV_GPU_TEMP, 90, 1000, DCGM_ST_OK);
+    /* Blank and failed values */
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, DCGM_INT64_BLANK, 1000, DCGM_ST_OK);
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 90, 1000, DCGM_ST_NOT_SUPPORTED);
+    /* A field policies don't look at */
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_SM_CLOCK, 90, 1000, DCGM_ST_OK);
+    /* Not a GPU */
+    fvBuffer.AddInt64Value(DCGM_FE_SWITCH, 0, DCGM_FI_DEV_GPU_TEMP, 90, 1000, DCGM_ST_OK);
+    policyManager.OnFieldValuesUpdate(&fvBuffer);
+    CHECK(core.notifications.empty());
+
+    /* Setting a policy without thermal deactivates the thermal rule */
+    SetPolicy(policyManager, DCGM_POLICY_COND_POWER);
+    fvBuffer.Clear();
+    fvBuffer.AddInt64Value(DCGM_FE_GPU, 0, DCGM_FI_DEV_GPU_TEMP, 90, 2000, DCGM_ST_OK);
+    policyManager.OnFieldValuesUpdate(&fvBuffer);
+    CHECK(core.notifications.empty());
+}
@@ -89,9 +89,20 @@ typedef struct dcgm_profiling_msg_pause_resume_v1
 } dcgm_profiling_msg_pause_resume_v1;
 
 #define dcgm_profiling_msg_pause_resume_version1 MAKE_DCGM_VERSION(dcgm_profiling_msg_pause_resume_v1, 1)
-#define dcgm_profiling_msg_pause_resume_version  dcgm_profiling_msg_pause_resume_version1
 
-typedef dcgm_profiling_msg_pause_resume_v1 dcgm_profiling_msg_pause_resume_t;
+typedef struct dcgm_profiling_msg_pause_resume_v2
+{
+    dcgm_module_command_header_t header; /* Command header */
+
+    bool pause;                                /* True if we should pause profiling. False if not (resume) */
+    unsigned int numGpuIds;                    /* Number of entries in gpuIds. 0 = all GPUs, like version 1 */
+    unsigned int gpuIds[DCGM_MAX_NUM_DEVICES]; /* GPUs to pause or resume. Profiling of the others is left as is */
+} dcgm_profiling_msg_pause_resume_v2;
+
+#define dcgm_profiling_msg_pause_resume_version2 MAKE_DCGM_VERSION(dcgm_profiling_msg_pause_resume_v2, 2)
+#define dcgm_profiling_msg_pause_resume_version  dcgm_profiling_msg_pause_resume_version2
+
+typedef dcgm_profiling_msg_pause_resume_v2 dcgm_profiling_msg_pause_resume_t;
 
 /*****************************************************************************/
 
@@ -160,6 +160,13 @@ public:
         Init();
     }
 
+    /***************************************************************/
+    /* The text of the config file as of the last Init(). Empty if it couldn't be read */
+    std::string const &GetConfigContents() const
+    {
+        return m_configContents;
+    }
+
     FrameworkConfig &_test_getConfig()
     {
         return m_fwcfg;
@@ -178,6 +185,7 @@ private:
     FrameworkConfig m_fwcfg;
     std::string m_configFile;
     std::ifstream m_inputstream;
+    std::string m_configContents;
     YAML::Node m_yamltoplevelnode;
 
     std::vector<std::unique_ptr<GpuSet>> gpuSets;
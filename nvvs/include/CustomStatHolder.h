@@ -22,6 +22,7 @@
 
 #include "json/json.h"
 #include <DcgmMutex.h>
+#include <JsonStreamWriter.h>
 #include <PluginInterface.h>
 #include <dcgm_structs.h>
 
@@ -44,6 +45,9 @@ typedef struct
     long long timestamp;
 } dcgmTimeseriesInfo_t;
 
+/* An interned custom stat name, see CustomStatHolder::RegisterStat() */
+typedef unsigned int customStatHandle_t;
+
 class CustomStatHolder
 {
 public:
@@ -65,6 +69,21 @@ public:
      */
     void AddCustomData(Json::Value &jv);
 
+    /*
+     * Write the stats of the specified GPU as members of the object writer is in
+     */
+    void WriteGpuDataJson(unsigned int gpuId, JsonStreamWriter &writer);
+
+    /*
+     * Write the grouped and single stats as members of the object writer is in, one member per group name
+     */
+    void WriteNonGpuDataJson(JsonStreamWriter &writer);
+
+    /*
+     * Returns the ids of the GPUs that have stats, in ascending order
+     */
+    std::vector<unsigned int> GetGpusWithData();
+
     /*
      * Add the vector of timeseries information to the json value
      */
@@ -97,6 +116,19 @@ public:
      */
     void SetGroupedStat(const std::string &groupName, const std::string &name, long long value);
 
+    /*
+     * Intern a GPU stat name. Values are appended to the stat through a CustomGpuStatBuffer using the returned
+     * handle, which saves hashing the name and locking the holder on every append. Registering the same name
+     * again returns the same handle.
+     */
+    customStatHandle_t RegisterStat(const std::string &name);
+
+    /*
+     * Append the buffered values of gpuId to the GPU stats and clear them. valuesByHandle is indexed by the
+     * handles from RegisterStat(). Used by CustomGpuStatBuffer::Flush()
+     */
+    void MergeGpuStats(unsigned int gpuId, std::vector<std::vector<dcgmTimeseriesInfo_t>> &valuesByHandle);
+
     /*
      * Retrieve the timeseries for a custom GPU stat
      */
@@ -136,9 +168,13 @@ private:
     std::unordered_map<std::string, std::unordered_map<std::string, std::vector<dcgmTimeseriesInfo_t>>> m_groupedData;
     // gpu as string -> stat name -> string value
     std::unordered_map<std::string, std::unordered_map<std::string, std::string>> m_groupSingleData;
+    // stat handle -> stat name, and back
+    std::vector<std::string> m_statNames;
+    std::unordered_map<std::string, customStatHandle_t> m_statHandles;
     DcgmMutex m_groupedDataMutex;
     DcgmMutex m_gpuDataMutex;
     DcgmMutex m_groupSingleDataMutex;
+    DcgmMutex m_statNamesMutex; // Taken before m_gpuDataMutex when both are needed
 
     // All these members are for holding state across calls to PopulateCustomStats(). They are needed because the buffer
     // is a fixed size, and the interface calling them is C, so we maintain the state on the Plugin end.
@@ -156,6 +192,7 @@ private:
     void AddGpuDataToJson(Json::Value &jv);
     void AddNonTimeseriesDataToJson(Json::Value &jv);
     void AddGroupedDataToJson(Json::Value &jv);
+    void WriteTimeseriesVector(JsonStreamWriter &writer, const std::vector<dcgmTimeseriesInfo_t> &vec);
     dcgmReturn_t InsertGroupedData(const std::string &groupName, const std::string &name, dcgmTimeseriesInfo_t &data);
     dcgmReturn_t InsertCustomData(unsigned int gpuId, const std::string &name, dcgmTimeseriesInfo_t &data);
     dcgmReturn_t InsertSingleData(const std::string &gpuId, const std::string &name, const std::string &value);
@@ -174,3 +211,36 @@ private:
     void AddGroupedStatValues(const dcgmDiagCustomStat_t &stat);
     void AddSingleStatValues(const dcgmDiagCustomStat_t &stat);
 };
+
+/*
+ * Buffers the custom stat values that one thread records for one GPU, so that per-GPU worker threads don't
+ * contend on the CustomStatHolder. Appending takes no lock. The values are moved to the holder by Flush(),
+ * which is also done when the buffer is destroyed, so flush before anything reads the stats back mid-test.
+ *
+ * Only the thread that owns the buffer may use it.
+ */
+class CustomGpuStatBuffer
+{
+public:
+    CustomGpuStatBuffer(CustomStatHolder &holder, unsigned int gpuId);
+    ~CustomGpuStatBuffer();
+
+    CustomGpuStatBuffer(const CustomGpuStatBuffer &)            = delete;
+    CustomGpuStatBuffer &operator=(const CustomGpuStatBuffer &) = delete;
+
+    /*
+     * Append a value, timestamped now, to the stat registered as handle
+     */
+    void Append(customStatHandle_t handle, double value);
+    void Append(customStatHandle_t handle, long long value);
+
+    /*
+     * Move the values appended so far to the CustomStatHolder
+     */
+    void Flush();
+
+private:
+    CustomStatHolder &m_holder;
+    unsigned int m_gpuId;
+    std::vector<std::vector<dcgmTimeseriesInfo_t>> m_values; // indexed by stat handle
+};
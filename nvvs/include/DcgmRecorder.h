@@ -49,7 +49,8 @@ public:
 
     /*
      * Adds watches to the specified field list by creating field groups and gpu groups with the specified
-     * names.
+     * names. Fields that the host engine already watches often enough and keeps long enough on every GPU
+     * aren't watched again. Their history is read from the host engine's cache like that of the others.
      *
      * Returns an empty string on SUCCESS or a string with an error message in it on failure
      */
@@ -96,6 +97,12 @@ public:
      */
     static void GetTagFromFieldId(unsigned short fieldId, std::string &tag);
 
+    /*
+     * Returns true if the watch described by fieldInfo samples at least every frequencyUsec and keeps the
+     * samples for at least keepAge seconds, so that the test window can be read from the host engine's cache
+     */
+    static bool WatchCoversTest(const dcgmCacheManagerFieldInfo_t &fieldInfo, long long frequencyUsec, double keepAge);
+
     /*
      * Adds a custom timeseries statistic for GPU gpuId with the specified name and value
      */
@@ -296,7 +303,7 @@ public:
 private:
     std::vector<unsigned short> m_fieldIds;
     std::vector<unsigned int> m_gpuIds;
-    dcgmFieldGrp_t m_fieldGroupId;
+    dcgmFieldGrp_t m_fieldGroupId; // The fields we watch ourselves. The group's field group has all of m_fieldIds
     std::map<std::string, std::map<std::string, std::string>> m_groupSingleData;
 
     DcgmHandle m_dcgmHandle;
@@ -329,6 +336,24 @@ private:
      */
     std::string GetWatchedFieldsAsJson(Json::Value &jv, long long ts);
 
+    /*
+     * Helper method to write the watched fields as json to out without building a json object
+     */
+    std::string WriteWatchedFieldsAsJson(std::ostream &out, long long ts);
+
+    /*
+     * Helper method to query the values of the watched fields since ts
+     */
+    std::string QueryWatchedFields(long long ts);
+
+    /*
+     * Helper method to get the fields of fieldIds that the host engine doesn't already watch for all of
+     * gpuIds in a way that covers the test. See WatchCoversTest()
+     */
+    std::vector<unsigned short> GetUnwatchedFieldIds(const std::vector<unsigned short> &fieldIds,
+                                                     const std::vector<unsigned int> &gpuIds,
+                                                     double keepAge);
+
     /*
      * Helper method to create a group in DCGM
      */
@@ -106,6 +106,16 @@ public:
                                         dcgmFieldValueEntityEnumeration_f checker,
                                         void *userData);
 
+    /*
+     * Populates fieldInfo with how the host engine watches and caches fieldId for GPU gpuId
+     * @return:
+     *
+     * DCGM_ST_OK       : success
+     * DCGM_ST_BADPARAM : if the handle hasn't been initialized
+     * DCGM_ST_*        : if returned from calls to DCGM
+     */
+    dcgmReturn_t GetFieldWatchInfo(unsigned int gpuId, unsigned short fieldId, dcgmCacheManagerFieldInfo_t &fieldInfo);
+
     /*
      * @return:
      *
@@ -16,18 +16,62 @@
 #ifndef DCGM_VALUES_SINCE_HOLDER_H
 #define DCGM_VALUES_SINCE_HOLDER_H
 
+#include <cstdint>
 #include <map>
 #include <stdlib.h>
 #include <string.h>
+#include <unordered_map>
 #include <vector>
 
 #include "DcgmError.h"
+#include "JsonStreamWriter.h"
 #include "dcgm_agent.h"
 #include "dcgm_fields.h"
 #include "dcgm_structs.h"
 #include "timelib.h"
 #include "json/json.h"
 
+/*
+ * The samples of one field in timestamp order, stored as parallel arrays of timestamps and values.
+ * Only int64 and double samples are kept: they are the only ones the checks and the stats output use, and keeping
+ * a whole dcgmFieldValue_v1 per sample costs the size of its blob for every sample.
+ */
+class DcgmFieldSamples
+{
+public:
+    /*
+     * Append val, or insert it in timestamp order if it is older than the latest sample.
+     * Samples of a type other than the one of the first sample are ignored
+     */
+    void Add(const dcgmFieldValue_v1 &val);
+
+    size_t Size() const;
+
+    /* DCGM_FT_* type of the samples. 0 until a sample has been added */
+    unsigned short GetFieldType() const;
+
+    timelib64_t GetTimestamp(size_t index) const;
+    int64_t GetInt64(size_t index) const;
+    double GetDouble(size_t index) const;
+
+    /* Index of the first sample at or after ts, or Size() if there is none */
+    size_t LowerBound(timelib64_t ts) const;
+
+    /* Fill dfv with sample index of fieldId */
+    void GetFieldValue(size_t index, unsigned short fieldId, dcgmFieldValue_v1 &dfv) const;
+
+private:
+    union Value
+    {
+        int64_t i64;
+        double dbl;
+    };
+
+    unsigned short m_fieldType = 0;
+    std::vector<timelib64_t> m_timestamps;
+    std::vector<Value> m_values;
+};
+
 class DcgmEntityTimeSeries
 {
 public:
@@ -60,12 +104,17 @@ public:
      */
     void AddToJson(Json::Value &jv, unsigned int jsonIndex);
 
+    /*
+     * Write each field of this timeseries as a member of the object writer is in
+     */
+    void WriteJson(JsonStreamWriter &writer) const;
+
     friend class DcgmValuesSinceHolder;
 
 private:
     dcgm_field_eid_t m_entityId; // entity id that we're dealing with
     // Map of fieldIds to values in timeseries order
-    std::map<unsigned short, std::vector<dcgmFieldValue_v1>> m_fieldValueTimeSeries;
+    std::unordered_map<unsigned short, DcgmFieldSamples> m_fieldValueTimeSeries;
 };
 
 class DcgmValuesSinceHolder
@@ -106,8 +155,14 @@ public:
     void AddToJson(Json::Value &jv);
 
     /*
-     * Returns true if the specified field value for the specified GPU ever meets or exceeds the threshold given
-     * in the field value
+     * Write the timeseries of the specified GPU as members of the object writer is in.
+     * Writes nothing if there are no values for the GPU
+     */
+    void WriteGpuJson(unsigned int gpuId, JsonStreamWriter &writer) const;
+
+    /*
+     * Returns true if the specified field value for the specified GPU meets or exceeds the threshold given
+     * in the field value at or after startTime
      */
     bool DoesValuePassPerSecondThreshold(unsigned short fieldId,
                                          const dcgmFieldValue_v1 &dfv,
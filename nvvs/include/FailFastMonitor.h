@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef FAILFASTMONITOR_H
+#define FAILFASTMONITOR_H
+
+#include "DcgmRecorder.h"
+#include "NvvsThread.h"
+#include "dcgm_structs.h"
+#include "timelib.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+/*
+ * Watches the GPUs of a run for fatal errors (double bit ECC errors and XIDs) while a test is running.
+ *
+ * Used for --fail-fast: the first fatal error on any of the GPUs sets main_should_stop to MAIN_STOP_FAIL_FAST,
+ * which makes the running plugin stop early, and the test framework then skips the remaining tests.
+ */
+class FailFastMonitor : public NvvsThread
+{
+public:
+    /*************************************************************************/
+    /*
+     * handle        IN: connection to the host engine
+     * gpuIds        IN: GPUs to watch
+     * checkInterval IN: seconds between checks
+     */
+    FailFastMonitor(dcgmHandle_t handle, std::vector<unsigned int> const &gpuIds, unsigned int checkInterval);
+
+    /*************************************************************************/
+    /*
+     * Look for fatal errors on the GPUs since the monitor was created. Sets main_should_stop on the first one
+     *
+     * RETURNS: true if a fatal error has been found, now or by an earlier check
+     */
+    bool CheckForFatalErrors();
+
+    bool FoundFatalError() const;
+
+    /* Description of the first fatal error found. Empty unless FoundFatalError() */
+    std::string GetFatalError() const;
+
+    void run(void) override;
+
+private:
+    DcgmRecorder m_dcgmRecorder;
+    std::vector<unsigned int> m_gpuIds;
+    unsigned int m_checkInterval;
+    timelib64_t m_startTime;
+
+    std::atomic<bool> m_foundFatalError;
+    std::string m_fatalError; /* Written once, before m_foundFatalError is set */
+};
+
+#endif // FAILFASTMONITOR_H
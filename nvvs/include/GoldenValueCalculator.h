@@ -18,6 +18,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Plugin.h"
@@ -35,26 +36,83 @@ typedef struct
     valueWithVariance_t calculatedValue; //!< The value and its variance
 } dcgmGpuToValue_t;
 
-typedef std::map<std::string, std::map<unsigned int, std::vector<double>>> paramToGpuToValues_t;
-typedef std::map<std::string, std::vector<double>> paramToValues_t;
+/*
+ * Running count, mean and variance of the values observed for a parameter, updated one value at a time
+ * (Welford's algorithm) so that training doesn't have to keep every value around
+ */
+class GoldenValueStats
+{
+public:
+    void Add(double value);
+
+    /*************************************************************************/
+    /*
+     * Fold in the values counted by other, as if they had been added here. Used to combine the statistics
+     * gathered by several calculators, e.g. by training on several nodes
+     */
+    void Merge(const GoldenValueStats &other);
+
+    size_t GetCount() const
+    {
+        return m_count;
+    }
+
+    double GetMin() const
+    {
+        return m_min;
+    }
+
+    double GetMax() const
+    {
+        return m_max;
+    }
+
+    /*************************************************************************/
+    /*
+     * Returns the mean and the sample variance of the values. The variance is 0 for fewer than 2 values
+     */
+    valueWithVariance_t GetMeanAndVariance() const;
+
+private:
+    size_t m_count = 0;
+    double m_mean  = 0.0;
+    double m_m2    = 0.0; //!< Sum of the squared differences from the mean
+    double m_min   = 0.0;
+    double m_max   = 0.0;
+};
+
+/* Statistics of a test parameter, overall and per GPU */
+typedef struct
+{
+    std::string testname;
+    std::string paramName;
+    GoldenValueStats all;
+    std::map<unsigned int, GoldenValueStats> perGpu;
+} goldenValueParam_t;
 
 class GoldenValueCalculator
 {
 public:
     /*************************************************************************/
     GoldenValueCalculator()
-        : m_inputs()
-        , m_inputsPerGpu()
+        : m_params()
+        , m_paramIds()
         , m_averageGpuValues()
         , m_calculatedGoldenValues()
     {}
 
     /*************************************************************************/
     /*
-     * Store the values observed from the test in m_inputs and m_inputsPerGpu
+     * Add the values observed from the test to the statistics of its parameters
      */
     void RecordGoldenValueInputs(const std::string &testName, const observedMetrics_t &metrics);
 
+    /*************************************************************************/
+    /*
+     * Add the statistics recorded by other to the ones recorded here, as if its inputs had been recorded here
+     */
+    void Merge(const GoldenValueCalculator &other);
+
     /*************************************************************************/
     /*
      * Calculate and write the golden values and store them in m_calculatedGoldenValues using the inputs
@@ -67,10 +125,10 @@ public:
     dcgmReturn_t CalculateAndWriteGoldenValues(const std::string &filename);
 
 protected:
-    // "testname.parameter" -> array of values
-    std::map<std::string, paramToValues_t> m_inputs;
-    // "testname.parameter" -> gpuId -> array of values
-    std::map<std::string, paramToGpuToValues_t> m_inputsPerGpu;
+    // Parameter id -> statistics of "testname.parameter"
+    std::vector<goldenValueParam_t> m_params;
+    // "testname.parameter" -> parameter id
+    std::unordered_map<std::string, unsigned int> m_paramIds;
     // "testname.parameter" -> gpuId -> average value
     std::map<std::string, std::map<std::string, dcgmGpuToValue_t>> m_averageGpuValues;
     // "testname.parameter" -> average value
@@ -92,30 +150,33 @@ protected:
 
     /*************************************************************************/
     /*
-     * Records the value for the given parameter in our map of inputs
+     * Returns the id of the given parameter of testname, adding it if it hasn't been seen yet
+     */
+    unsigned int GetParamId(const std::string &testname, const std::string &paramName);
+
+    /*************************************************************************/
+    /*
+     * Records the value for the given parameter in its overall statistics
      */
-    inline void AddToAllInputs(const std::string &testname, const std::string &paramName, double value)
+    inline void AddToAllInputs(unsigned int paramId, double value)
     {
-        m_inputs[testname][paramName].push_back(value);
+        m_params[paramId].all.Add(value);
     }
 
     /*************************************************************************/
     /*
-     * Records the value for the given parameter in our map of inputs which records gpu Id
+     * Records the value for the given parameter in the statistics of gpuId
      */
-    inline void AddToInputsPerGpu(const std::string &testname,
-                                  const std::string &paramName,
-                                  unsigned int gpuId,
-                                  double value)
+    inline void AddToInputsPerGpu(unsigned int paramId, unsigned int gpuId, double value)
     {
-        m_inputsPerGpu[testname][paramName][gpuId].push_back(value);
+        m_params[paramId].perGpu[gpuId].Add(value);
     }
 
     /*************************************************************************/
     /*
      * Returns a calculated mean and variance for the data in the vector
      */
-    valueWithVariance_t CalculateMeanAndVariance(std::vector<double> &data) const;
+    valueWithVariance_t CalculateMeanAndVariance(const std::vector<double> &data) const;
 
     /*************************************************************************/
     /*
@@ -142,19 +203,19 @@ protected:
 
     /*************************************************************************/
     /*
-     * Dumps all of the metrics we've recorded into a CSV file for inspection
+     * Dumps the statistics of all of the metrics we've recorded into CSV files for inspection
      */
     void DumpObservedMetrics() const;
 
     /*************************************************************************/
     /*
-     * Dumps all of the metrics we've recorded, but dumps the information per GPU
+     * Dumps the statistics of all of the metrics we've recorded per GPU
      */
     void DumpObservedMetricsWithGpuIds(int64_t timestamp) const;
 
     /*************************************************************************/
     /*
-     * Dumps all of the metrics we've recorded with no information about which GPU it came from
+     * Dumps the statistics of all of the metrics we've recorded across all GPUs
      */
     void DumpObservedMetricsAll(int64_t timestamp) const;
 };
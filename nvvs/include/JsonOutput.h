@@ -81,6 +81,9 @@ private:
 
     void AppendError(const dcgmDiagEvent_t &error, Json::Value &resultField, const std::string &prefix = "");
     void AppendInfo(const dcgmDiagEvent_t &info, Json::Value &resultField, const std::string &prefix = "");
+
+    /* Write the results of test so far as one NVVS_STREAM_RESULT line so DCGM can use them before the run ends */
+    void StreamTestResult(const Json::Value &test);
 };
 
 #endif // _NVVS_NVVS_JsonOutput_H
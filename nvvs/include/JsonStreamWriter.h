@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NVVS_NVVS_JsonStreamWriter_H
+#define _NVVS_NVVS_JsonStreamWriter_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Writes a JSON document to a stream as it is produced, without building a Json::Value tree first.
+ * Used for the stats files, whose timeseries can hold millions of samples with verbose stats enabled.
+ *
+ * The caller is responsible for well-formedness: keys only inside objects, every Start matched by an End.
+ * Output is indented like Json::Value::toStyledString() and values are formatted the same way.
+ */
+class JsonStreamWriter
+{
+public:
+    explicit JsonStreamWriter(std::ostream &out);
+
+    void StartObject();
+    void EndObject();
+    void StartArray();
+    void EndArray();
+
+    /*
+     * Write the key of the next member of the current object
+     */
+    void Key(const std::string &key);
+
+    void Value(int64_t value);
+    void Value(double value);
+    void Value(const std::string &value);
+
+private:
+    std::ostream &m_out;
+    std::vector<bool> m_hasMembers; /* One entry per open object or array */
+    bool m_afterKey;
+
+    void BeforeValue();
+    void NewLine();
+    void EndContainer(char closer);
+};
+
+#endif // _NVVS_NVVS_JsonStreamWriter_H
@@ -32,6 +32,7 @@
 #include "Test.h"
 #include "TestFramework.h"
 #include "TestParameters.h"
+#include "TestPlanCache.h"
 #include "Whitelist.h"
 #include <algorithm>
 #include <iostream>
@@ -47,7 +48,11 @@ class NvidiaValidationSuite
 {
 public:
     // ctor/dtor
-    NvidiaValidationSuite();
+    /*
+     * @param keepDcgmConnection - reuse the connection to DCGM left by a previous instance and leave it open
+     *                             when done. Set by the NVVS worker, which runs many diagnostics in one process
+     */
+    explicit NvidiaValidationSuite(bool keepDcgmConnection = false);
     ~NvidiaValidationSuite();
 
     /*
@@ -97,6 +102,15 @@ protected:
     void InitializeAndCheckGpuObjs(std::vector<std::unique_ptr<GpuSet>> &gpuSets);
     void InitializeParameters(const std::string &parms, const ParameterValidator &pv);
 
+    /* The key of the test plan: everything the parameters of the tests are resolved from. See TestPlanCache */
+    std::string BuildTestPlanKey();
+
+    /*
+     * Copy the parameters of entry from the loaded test plan into tp, making the global changes of deviceId
+     * that resolving them would have made. Returns false if the plan doesn't have entry
+     */
+    bool GetPlannedParameters(const std::string &entry, const std::string &deviceId, TestParameters &tp);
+
     // vars
     bool logInit;
     std::vector<Gpu *> m_gpuVect;
@@ -108,6 +122,7 @@ protected:
     // classes
     ConfigFileParser_v2 *parser;
     TestFramework *m_tf;
+    TestPlanCache m_planCache;
 
     // parsing variables
     std::string configFile;
@@ -122,6 +137,7 @@ protected:
     unsigned int initWaitTime;
     NvvsSystemChecker m_sysCheck;
     ParameterValidator m_pv;
+    bool m_keepDcgmConnection;
 
     /***************************PROTECTED********************************/
 protected:
@@ -38,6 +38,10 @@
 /* Has the user requested a stop? 1=yes. 0=no. Defined in main.cpp */
 extern int main_should_stop;
 
+/* Value of main_should_stop when the run was stopped by a fatal error in fail-fast mode rather than
+   by the user. It only applies to the current run. See FailFastMonitor */
+#define MAIN_STOP_FAIL_FAST 2
+
 enum suiteNames_enum
 {
     NVVS_SUITE_QUICK,
@@ -124,7 +128,9 @@ public:
     std::string goldenValuesFile;    // Filename where golden values should be saved
     bool failEarly;             // enable failure checks throughout test rather than at the end so we stop test sooner
     uint64_t failCheckInterval; /* how often failure checks should occur when running tests (in seconds). Only
-                                       applies if failEarly is enabled. */
+                                       applies if failEarly or failFast is enabled. */
+    bool failFast;              // stop the whole run at the first fatal error on any GPU
+    std::string testPlanCacheDir; // directory of the saved test plans. Empty disables them. See TestPlanCache
     Gpu *m_gpus[DCGM_MAX_NUM_DEVICES]; // Pointers to the gpu objects that are active for this run
 };
 
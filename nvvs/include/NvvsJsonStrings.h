@@ -34,4 +34,16 @@
 #define NVVS_TRAINING_MSG  "Training Result"
 #define NVVS_ERROR_ID      "error_id"
 
+/* When run by DCGM, each result is also written as soon as it is known on a line of its own:
+ * NVVS_STREAM_RESULT {"version" : "<version_str>", "test" : { <the test as in test_categories> }}
+ * A test with per-GPU results is written again as the results of each GPU are added */
+#define NVVS_STREAM_RESULT "NVVS_STREAM_RESULT"
+#define NVVS_STREAM_TEST   "test"
+
+/* Run as a worker: read one JSON array of command line arguments per line from stdin and run the
+ * diagnostic for each. The output of each run is followed by a line with NVVS_WORKER_END_OF_RUN
+ * and the return code of the run */
+#define NVVS_WORKER_ARG        "--worker"
+#define NVVS_WORKER_END_OF_RUN "NVVS_WORKER_END_OF_RUN"
+
 #endif
@@ -275,6 +275,12 @@ public:
      */
     std::vector<dcgmTimeseriesInfo_t> GetCustomGpuStat(unsigned int gpuId, const std::string &name);
 
+    /*
+     * Get the holder of this plugin's custom stats, to register stats and create CustomGpuStatBuffers for
+     * per-GPU worker threads
+     */
+    CustomStatHolder &GetCustomStatHolder();
+
     /*
      * Populate the struct with statistics from where we've left off in iteration. It could be from the beginning.
      */
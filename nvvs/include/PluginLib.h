@@ -55,6 +55,9 @@ public:
     /*****************************************************************************/
     std::string GetName() const;
 
+    /*****************************************************************************/
+    const std::string &GetPath() const;
+
     /*****************************************************************************/
     std::vector<dcgmDiagPluginParameterInfo_t> GetParameterInfo() const;
 
@@ -101,6 +104,7 @@ private:
     dcgmDiagRetrieveResults_f m_retrieveResultsCB;
     void *m_userData;
     std::string m_pluginName;
+    std::string m_pluginPath;
     std::vector<dcgmDiagCustomStats_t> m_customStats;
     std::vector<dcgmDiagEvent_t> m_errors;
     std::vector<dcgmDiagEvent_t> m_info;
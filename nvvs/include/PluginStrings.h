@@ -48,6 +48,7 @@
 #define PCIE_STR_TEST_P2P_ON              "test_p2p_on"
 #define PCIE_STR_TEST_P2P_OFF             "test_p2p_off"
 #define PCIE_STR_NVSWITCH_NON_FATAL_CHECK "check_non_fatal"
+#define PCIE_STR_TEST_PER_SWITCH          "test_per_switch" /* Run the concurrent tests one PCIe switch at a time */
 
 /* Private parameters */
 #define PCIE_STR_IS_ALLOWED "is_allowed" /* Is the busgrind plugin allowed to run? */
@@ -114,6 +115,9 @@
 #define PCIE_SUBTEST_P2P_LATENCY_P2P_ENABLED  "p2p_latency_p2p_enabled"
 #define PCIE_SUBTEST_P2P_LATENCY_P2P_DISABLED "p2p_latency_p2p_disabled"
 
+#define PCIE_SUBTEST_P2P_BW_ALL_PAIRS        "p2p_bw_all_pairs"
+#define PCIE_SUBTEST_P2P_LATENCY_PERCENTILES "p2p_latency_percentiles"
+
 /******************************************************************************
  * TARGETED POWER PLUGIN
  *****************************************************************************/
@@ -130,7 +134,7 @@
  */
 #define TP_STR_USE_DGEMM               "use_dgemm"
 #define TP_STR_CUDA_STREAMS_PER_GPU    "cuda_streams_per_gpu"
-#define TP_STR_READJUST_INTERVAL       "readjust_interval"
+#define TP_STR_READJUST_INTERVAL       "readjust_interval" /* Seconds between power controller updates */
 #define TP_STR_PRINT_INTERVAL          "print_interval"
 #define TP_STR_TARGET_POWER_MIN_RATIO  "target_power_min_ratio"
 #define TP_STR_TARGET_POWER_MAX_RATIO  "target_power_max_ratio"
@@ -158,6 +162,12 @@
                                                             our power target. */
 #define TP_STR_IS_ALLOWED          "is_allowed"     /* Is the targeted power plugin allowed to run? */
 #define TP_STR_SBE_ERROR_THRESHOLD "max_sbe_errors" /* Threshold beyond which sbe's are treated as errors */
+#define TP_STR_CONTROLLER_KP                                                                            \
+    "power_controller_kp" /* Proportional gain of the power controller: change in log(matrix work) per \
+                             unit of relative power error */
+#define TP_STR_CONTROLLER_KI                                                                        \
+    "power_controller_ki" /* Integral gain of the power controller: change in log(matrix work) per \
+                             second per unit of relative power error */
 
 /******************************************************************************
  * TARGETED STRESS PLUGIN
@@ -177,6 +187,11 @@
 #define TS_STR_USE_DGEMM            "use_dgemm"
 #define TS_STR_CUDA_STREAMS_PER_GPU "cuda_streams_per_gpu"
 #define TS_STR_CUDA_OPS_PER_STREAM  "ops_per_stream_queue"
+#define TS_STR_TENSOR_PRECISION                                                                                  \
+    "tensor_precision" /* Run tensor core GEMMs of this type (TF32, FP16, BF16 or INT8) instead of S/Dgemm. Only \
+                          allowed on SKUs whose whitelist sets tensor_target_stress */
+#define TS_STR_TENSOR_TARGET_PERF                                                                      \
+    "tensor_target_stress" /* target_stress for the tensor core GEMMs. 0 if they aren't qualified for the SKU */
 
 #define TS_STR_MAX_PCIE_REPLAYS                                                                                     \
     "max_pcie_replays" /* Maximum PCIe replays allowed per device while the plugin runs. If more replays occur than \
@@ -209,7 +224,10 @@
  *****************************************************************************/
 #define MEMORY_PLUGIN_NAME "memory"
 
-#define MEMORY_STR_IS_ALLOWED "is_allowed" /* Is the memory plugin allowed to run? */
+#define MEMORY_STR_IS_ALLOWED    "is_allowed"    /* Is the memory plugin allowed to run? */
+#define MEMORY_STR_PIPELINED     "pipelined"     /* Test the framebuffer in chunks on several streams at once */
+#define MEMORY_STR_NUM_STREAMS   "num_streams"   /* Number of streams for the pipelined test */
+#define MEMORY_STR_CHUNK_SIZE_MB "chunk_size_mb" /* Size of each chunk of the pipelined test */
 
 // Parameters controlling the cache subtest
 #define MEMORY_SUBTEST_L1TAG                     "gpu_memory_cache"
@@ -220,6 +238,8 @@
 #define MEMORY_L1TAG_STR_ERROR_LOG_LEN           "log_len"
 #define MEMORY_L1TAG_STR_DUMP_MISCOMPARES        "dump_miscompares"
 #define MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM "l1cache_size_kb_per_sm"
+#define MEMORY_L1TAG_STR_CONCURRENT                                                                                    \
+    "concurrent" /* Test every GPU at once, each GPU's L1 tag subtest on its own stream alongside its memory test */
 
 /******************************************************************************
  * HARDWARE PLUGIN
@@ -254,6 +274,9 @@
     "max_graphics_clock" /* Maximum graphics clock in MHZ to use when locking application clocks to max while smstress \
                             runs */
 #define SMSTRESS_STR_MATRIX_DIM "matrix_dim" /* The dimension of the matrix used for S/Dgemm */
+#define SMSTRESS_STR_OCCUPANCY_MODE                                                                                    \
+    "occupancy_mode" /* Keep every SM busy with concurrent streams sized from the device instead of throttling to      \
+                        target_stress */
 
 /****************************************************************************
  * GPU BURN PLUGIN
@@ -267,6 +290,9 @@
 #define DIAGNOSTIC_STR_TEMPERATURE_MAX     "temperature_max" /* Max temperature allowed during test */
 #define DIAGNOSTIC_STR_IS_ALLOWED          "is_allowed"      /* Is this plugin allowed to run? */
 #define DIAGNOSTIC_STR_MATRIX_DIM          "matrix_dim"      /* The starting dimension of the matrix used for S/Dgemm */
+#define DIAGNOSTIC_STR_TENSOR_PRECISION                                                                         \
+    "tensor_precision" /* Run tensor core GEMMs of this type (TF32, FP16, BF16 or INT8) instead of S/Dgemm. \
+                          None to disable */
 
 /****************************************************************************
  * CONTEXT CREATE PLUGIN
@@ -22,6 +22,7 @@
 #ifndef _NVVS_NVVS_TestFramework_H
 #define _NVVS_NVVS_TestFramework_H
 
+#include <memory>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -99,7 +100,12 @@ protected:
     std::string GetTestDisplayName(dcgmPerGpuTestIndices_t index);
     void insertIntoTestGroup(std::string, Test *);
     void goList(Test::testClasses_enum suite, std::vector<Test *> testsList, std::vector<Gpu *> gpuList);
+    void goSoftwareList(std::vector<Test *> &testsList);
+    void RunTestFailFast(int pluginIndex, TestParameters *tp, std::vector<Gpu *> const &gpuList);
+    void ReportMissingPlugin(const std::string &name);
+    void AddSoftwareTestParameters(const std::string &name, TestParameters *tp);
     void LoadLibrary(const char *libPath, const char *libName);
+    std::unique_ptr<PluginLib> LoadPluginInstance(const std::string &libraryPath, const std::string &libraryName);
     void ReportTrainingError(Test *test);
     void EvaluateTestTraining(Test *test);
     void GetAndOutputHeader(Test::testClasses_enum classNum);
@@ -66,6 +66,8 @@ public:
     /*************************************************************************/
 
 private:
+    friend class TestPlanCache;
+
     int m_valueType; /* TP_T_? #define of the value type */
 
     /* Actual parameter value */
@@ -132,6 +134,8 @@ public:
     /*************************************************************************/
 
 private:
+    friend class TestPlanCache;
+
     std::map<std::string, TestParameterValue *> m_globalParameters;
     std::map<std::string, std::map<std::string, TestParameterValue *>> m_subTestParameters;
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TESTPLANCACHE_H
+#define TESTPLANCACHE_H
+
+#include "TestParameters.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+/* Default directory of the plan files. See --plan-cache */
+#define TPC_DEFAULT_DIRECTORY "/var/cache/nvidia-validation-suite"
+
+/* Plan files kept in the directory. The least recently used ones past this are removed when a plan is saved */
+#define TPC_MAX_PLANS 64
+
+/*
+ * Keeps the resolved parameters of each test of a run, meaning the whitelist defaults for the SKU with the
+ * overrides of the config file and of --parms applied, in a binary file per test plan.
+ *
+ * The key of a plan is everything the parameters are resolved from: the NVVS build, the contents of the config
+ * file, the parameters given on the command line and the SKUs of the GPUs. A later run with the same key loads
+ * the parameters from the file instead of walking the whitelist and the YAML of the config file for each test.
+ * The file name is a hash of the key, and the file holds the whole key, so a collision is a miss.
+ *
+ * Plan files are only a cache. Failing to read or write one is logged and the parameters are resolved as usual.
+ */
+class TestPlanCache
+{
+public:
+    /* directory: Where the plan files are kept. Empty disables the cache */
+    explicit TestPlanCache(std::string directory = "");
+
+    /*************************************************************************/
+    /*
+     * Read the plan of key if a run saved one. Entries that are Put() are saved
+     * under key
+     *
+     * Returns true if the plan was found
+     */
+    bool Load(std::string const &key);
+
+    /*************************************************************************/
+    /*
+     * Copy the parameters of an entry into tp, which should be empty
+     *
+     * Returns false if the plan doesn't have the entry
+     */
+    bool Get(std::string const &entry, TestParameters &tp) const;
+
+    /* Add the parameters of an entry to the plan */
+    void Put(std::string const &entry, TestParameters const &tp);
+
+    /*************************************************************************/
+    /*
+     * Write the plan if entries were added since it was loaded, and remove the
+     * least recently used plan files past TPC_MAX_PLANS
+     */
+    void Save();
+
+    /* Path of the plan file of the loaded key. Empty if the cache is disabled. For tests and logging */
+    std::string const &GetPath() const
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_directory;
+    std::string m_key;
+    std::string m_path;
+    std::map<std::string, std::unique_ptr<TestParameters>> m_entries;
+    bool m_dirty;
+
+    /* Remove the plan files of m_directory that were used least recently, past TPC_MAX_PLANS */
+    void PruneOldPlans();
+
+    static void SerializeParameters(TestParameters const &tp, std::string &out);
+    static bool DeserializeParameters(std::string const &in, size_t &offset, TestParameters &tp);
+};
+
+#endif // TESTPLANCACHE_H
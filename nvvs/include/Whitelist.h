@@ -21,7 +21,6 @@
 #include "TestParameters.h"
 #include <iostream>
 #include <map>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -36,6 +35,13 @@ public:
     bool isWhitelisted(std::string deviceId);
     void getDefaultsByDeviceId(const std::string &testName, const std::string &deviceId, TestParameters *tp);
 
+    /****************************************************************/
+    /*
+     * Make the global changes getDefaultsByDeviceId() makes for deviceId without looking up any parameters.
+     * For when the parameters of a test come from a saved test plan.
+     */
+    void ApplyGlobalChanges(const std::string &deviceId);
+
     /****************************************************************/
     /*
      * Adjust the whitelist values once GPUs have been read from DCGM.
@@ -54,14 +60,16 @@ protected:
 
     /***************************PRIVATE**********************************/
 private:
-    void FillMap();
+    /****************************************************************/
+    /*
+     * Returns the whitelist parameters of deviceId keyed by plugin name, making them from the compiled-in
+     * whitelist the first time the device is looked up. Empty if deviceId isn't whitelisted.
+     */
+    std::map<std::string, TestParameters *> &GetDeviceParameters(const std::string &deviceId);
 
-    /* Per-hardware whitelist parameters database keyed by deviceId and
+    /* Per-hardware whitelist parameters of the devices looked up so far, keyed by deviceId and
      * then plugin name */
     std::map<std::string, std::map<std::string, TestParameters *>> m_featureDb;
-
-    /* Set of hardware deviceIds which require global configuration changes. */
-    std::set<std::string> m_globalChanges;
 };
 
 
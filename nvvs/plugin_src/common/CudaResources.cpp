@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "CudaResources.h"
+#include "DcgmLogging.h"
+#include "cublas_proxy.hpp"
+#include "cuda_runtime.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+/* What cudaMalloc guarantees. Chunks and ranges are kept multiples of it */
+const size_t allocAlignment = 512;
+
+size_t AlignUp(size_t bytes)
+{
+    return (bytes + allocAlignment - 1) / allocAlignment * allocAlignment;
+}
+
+size_t AlignDown(size_t bytes)
+{
+    return bytes / allocAlignment * allocAlignment;
+}
+
+/* Makes a context current for the lifetime of the object */
+class ScopedContext
+{
+public:
+    explicit ScopedContext(CUcontext context)
+        : m_pushed(cuCtxPushCurrent(context) == CUDA_SUCCESS)
+    {}
+
+    ~ScopedContext()
+    {
+        if (m_pushed)
+        {
+            CUcontext popped;
+            cuCtxPopCurrent(&popped);
+        }
+    }
+
+private:
+    bool m_pushed;
+};
+} // namespace
+
+/*****************************************************************************/
+CudaResources &CudaResources::Instance()
+{
+    static CudaResources instance;
+    return instance;
+}
+
+/*****************************************************************************/
+CudaResources::~CudaResources()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &[device, resources] : m_devices)
+    {
+        ReleaseLocked(device, resources, false);
+    }
+    m_devices.clear();
+}
+
+/*****************************************************************************/
+CUresult CudaResources::GetContextLocked(CUdevice device, DeviceResources &resources)
+{
+    if (resources.context != nullptr)
+    {
+        return CUDA_SUCCESS;
+    }
+
+    CUresult cuRes = cuInit(0);
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    return cuDevicePrimaryCtxRetain(&resources.context, device);
+}
+
+/*****************************************************************************/
+CUresult CudaResources::GetContext(CUdevice device, CUcontext &context)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DeviceResources &resources = m_devices[device];
+
+    CUresult cuRes = GetContextLocked(device, resources);
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    context = resources.context;
+    return cuCtxSetCurrent(context);
+}
+
+/*****************************************************************************/
+cublasStatus_t CudaResources::GetCublasHandle(CUdevice device, cublasHandle_t &handle)
+{
+    using namespace Dcgm;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DeviceResources &resources = m_devices[device];
+
+    if (GetContextLocked(device, resources) != CUDA_SUCCESS)
+    {
+        return CUBLAS_STATUS_NOT_INITIALIZED;
+    }
+
+    ScopedContext scopedContext(resources.context);
+    return CublasProxy::CublasGetCachedHandle(nullptr, &handle);
+}
+
+/*****************************************************************************/
+bool CudaResources::CarveLocked(DeviceResources &resources, size_t bytes, CUdeviceptr &ptr)
+{
+    /* Best fit, to leave the large ranges for large allocations */
+    auto best = resources.freeRanges.end();
+    for (auto it = resources.freeRanges.begin(); it != resources.freeRanges.end(); ++it)
+    {
+        if (it->second >= bytes && (best == resources.freeRanges.end() || it->second < best->second))
+        {
+            best = it;
+        }
+    }
+
+    if (best == resources.freeRanges.end())
+    {
+        return false;
+    }
+
+    ptr              = best->first;
+    size_t remainder = best->second - bytes;
+    resources.freeRanges.erase(best);
+    if (remainder > 0)
+    {
+        resources.freeRanges[ptr + bytes] = remainder;
+    }
+    resources.allocations[ptr] = bytes;
+    return true;
+}
+
+/*****************************************************************************/
+CUresult CudaResources::AddChunkLocked(DeviceResources &resources, size_t bytes)
+{
+    ScopedContext scopedContext(resources.context);
+
+    CUdeviceptr base;
+    CUresult cuRes = cuMemAlloc(&base, bytes);
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    resources.chunks.push_back({ base, bytes });
+    resources.freeRanges[base] = bytes;
+    return CUDA_SUCCESS;
+}
+
+/*****************************************************************************/
+void CudaResources::TrimLocked(DeviceResources &resources)
+{
+    ScopedContext scopedContext(resources.context);
+
+    for (auto it = resources.chunks.begin(); it != resources.chunks.end();)
+    {
+        auto range = resources.freeRanges.find(it->base);
+        if (range == resources.freeRanges.end() || range->second != it->size)
+        {
+            ++it;
+            continue;
+        }
+
+        cuMemFree(it->base);
+        resources.freeRanges.erase(range);
+        it = resources.chunks.erase(it);
+    }
+}
+
+/*****************************************************************************/
+size_t CudaResources::LargestFreeRangeLocked(DeviceResources const &resources) const
+{
+    size_t largest = 0;
+    for (auto const &[ptr, size] : resources.freeRanges)
+    {
+        largest = std::max(largest, size);
+    }
+    return largest;
+}
+
+/*****************************************************************************/
+CUresult CudaResources::Allocate(CUdevice device, size_t bytes, CUdeviceptr &ptr)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DeviceResources &resources = m_devices[device];
+
+    CUresult cuRes = GetContextLocked(device, resources);
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    bytes = AlignUp(bytes == 0 ? 1 : bytes);
+    if (CarveLocked(resources, bytes, ptr))
+    {
+        return CUDA_SUCCESS;
+    }
+
+    cuRes = AddChunkLocked(resources, bytes);
+    if (cuRes == CUDA_ERROR_OUT_OF_MEMORY)
+    {
+        /* The pool may be holding on to what the driver is missing */
+        TrimLocked(resources);
+        cuRes = AddChunkLocked(resources, bytes);
+    }
+
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    CarveLocked(resources, bytes, ptr);
+    return CUDA_SUCCESS;
+}
+
+/*****************************************************************************/
+CUresult CudaResources::AllocateLargest(CUdevice device, size_t minBytes, CUdeviceptr &ptr, size_t &bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DeviceResources &resources = m_devices[device];
+
+    CUresult cuRes = GetContextLocked(device, resources);
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    size_t driverFree;
+    size_t total;
+    {
+        ScopedContext scopedContext(resources.context);
+        cuRes = cuMemGetInfo(&driverFree, &total);
+    }
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    size_t largest = LargestFreeRangeLocked(resources);
+    if (largest >= driverFree && largest >= minBytes)
+    {
+        bytes = largest;
+        CarveLocked(resources, bytes, ptr);
+        return CUDA_SUCCESS;
+    }
+
+    /* The driver doesn't hand out all of its free memory in one piece. Back off until it does */
+    bytes = driverFree;
+    do
+    {
+        bytes = AlignDown(bytes / 100 * 99);
+        if (bytes < minBytes || bytes == 0)
+        {
+            return CUDA_ERROR_OUT_OF_MEMORY;
+        }
+        cuRes = AddChunkLocked(resources, bytes);
+    } while (cuRes == CUDA_ERROR_OUT_OF_MEMORY);
+
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    CarveLocked(resources, bytes, ptr);
+    return CUDA_SUCCESS;
+}
+
+/*****************************************************************************/
+void CudaResources::Free(CUdevice device, CUdeviceptr ptr)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto deviceIt = m_devices.find(device);
+    if (deviceIt == m_devices.end())
+    {
+        return;
+    }
+    DeviceResources &resources = deviceIt->second;
+
+    auto allocation = resources.allocations.find(ptr);
+    if (allocation == resources.allocations.end())
+    {
+        DCGM_LOG_DEBUG << "Ignoring free of unknown pointer " << (void *)ptr << " on CUDA device " << device;
+        return;
+    }
+    size_t size = allocation->second;
+    resources.allocations.erase(allocation);
+
+    /* Merge with the neighbouring free ranges of the same chunk */
+    auto chunk = std::find_if(resources.chunks.begin(), resources.chunks.end(), [ptr](Chunk const &c) {
+        return ptr >= c.base && ptr < c.base + c.size;
+    });
+    CUdeviceptr chunkBase = chunk != resources.chunks.end() ? chunk->base : ptr;
+    CUdeviceptr chunkEnd  = chunk != resources.chunks.end() ? chunk->base + chunk->size : ptr + size;
+
+    auto next = resources.freeRanges.lower_bound(ptr);
+    if (next != resources.freeRanges.end() && next->first == ptr + size && next->first < chunkEnd)
+    {
+        size += next->second;
+        next = resources.freeRanges.erase(next);
+    }
+
+    if (next != resources.freeRanges.begin() && ptr > chunkBase)
+    {
+        auto prev = std::prev(next);
+        if (prev->first >= chunkBase && prev->first + prev->second == ptr)
+        {
+            prev->second += size;
+            return;
+        }
+    }
+
+    resources.freeRanges[ptr] = size;
+}
+
+/*****************************************************************************/
+CUresult CudaResources::GetFreeMemory(CUdevice device, size_t &freeBytes, size_t &totalBytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DeviceResources &resources = m_devices[device];
+
+    CUresult cuRes = GetContextLocked(device, resources);
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    {
+        ScopedContext scopedContext(resources.context);
+        cuRes = cuMemGetInfo(&freeBytes, &totalBytes);
+    }
+    if (cuRes != CUDA_SUCCESS)
+    {
+        return cuRes;
+    }
+
+    for (auto const &[ptr, size] : resources.freeRanges)
+    {
+        freeBytes += size;
+    }
+    return CUDA_SUCCESS;
+}
+
+/*****************************************************************************/
+void CudaResources::ReleaseLocked(CUdevice device, DeviceResources &resources, bool reset)
+{
+    using namespace Dcgm;
+
+    if (resources.context == nullptr)
+    {
+        return;
+    }
+
+    {
+        ScopedContext scopedContext(resources.context);
+        CublasProxy::CublasReleaseCachedHandles(device);
+        for (auto const &chunk : resources.chunks)
+        {
+            cuMemFree(chunk.base);
+        }
+    }
+    resources.chunks.clear();
+    resources.freeRanges.clear();
+    resources.allocations.clear();
+
+    if (reset)
+    {
+        cudaSetDevice(device);
+        cudaDeviceReset();
+    }
+
+    cuDevicePrimaryCtxRelease(device);
+    resources.context = nullptr;
+}
+
+/*****************************************************************************/
+void CudaResources::ResetDevices()
+{
+    int cudaDeviceCount;
+    if (cudaGetDeviceCount(&cudaDeviceCount) != cudaSuccess)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
+    {
+        auto it = m_devices.find(deviceIdx);
+        if (it == m_devices.end() || it->second.context == nullptr)
+        {
+            Dcgm::CublasProxy::CublasReleaseCachedHandles(deviceIdx);
+            cudaSetDevice(deviceIdx);
+            cudaDeviceReset();
+            continue;
+        }
+
+        DeviceResources &resources = it->second;
+        CUresult cuRes;
+        {
+            ScopedContext scopedContext(resources.context);
+            cuRes = cuCtxSynchronize();
+        }
+
+        if (cuRes != CUDA_SUCCESS)
+        {
+            DCGM_LOG_WARNING << "Resetting CUDA device " << deviceIdx << " after error " << cuRes;
+            ReleaseLocked(deviceIdx, resources, true);
+            m_devices.erase(it);
+            continue;
+        }
+
+        /* Take back what the previous plugin didn't free */
+        if (!resources.allocations.empty())
+        {
+            DCGM_LOG_DEBUG << "Returning " << resources.allocations.size() << " leftover allocations to the pool of "
+                           << "CUDA device " << deviceIdx;
+            resources.allocations.clear();
+            resources.freeRanges.clear();
+            for (auto const &chunk : resources.chunks)
+            {
+                resources.freeRanges[chunk.base] = chunk.size;
+            }
+        }
+    }
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TensorGemm.h"
+
+#include <cublas_proxy.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <strings.h>
+
+#if (CUDA_VERSION_USED > 10)
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#endif
+
+namespace
+{
+struct TensorGemmTypeInfo
+{
+    TensorGemmType type;
+    const char *name;
+    int minComputeCapability; /* major * 10 + minor */
+    size_t inputSize;
+};
+
+constexpr TensorGemmTypeInfo c_typeInfo[] = {
+    { TensorGemmType::None, "None", 0, 0 },
+    { TensorGemmType::Tf32, "TF32", 80, sizeof(float) },
+    { TensorGemmType::Fp16, "FP16", 70, 2 },
+    { TensorGemmType::Bf16, "BF16", 80, 2 },
+    { TensorGemmType::Int8, "INT8", 72, sizeof(int8_t) },
+};
+
+const TensorGemmTypeInfo &GetInfo(TensorGemmType type)
+{
+    return c_typeInfo[static_cast<int>(type)];
+}
+} // namespace
+
+/*****************************************************************************/
+bool ParseTensorGemmType(const std::string &name, TensorGemmType &type)
+{
+    if (name.empty())
+    {
+        type = TensorGemmType::None;
+        return true;
+    }
+
+    for (const TensorGemmTypeInfo &info : c_typeInfo)
+    {
+        if (strcasecmp(name.c_str(), info.name) == 0)
+        {
+            type = info.type;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*****************************************************************************/
+const char *TensorGemmTypeName(TensorGemmType type)
+{
+    return GetInfo(type).name;
+}
+
+/*****************************************************************************/
+bool TensorGemmSupported(TensorGemmType type, int computeCapabilityMajor, int computeCapabilityMinor)
+{
+    if (type == TensorGemmType::None)
+    {
+        return true;
+    }
+
+#if (CUDA_VERSION_USED > 10)
+    return computeCapabilityMajor * 10 + computeCapabilityMinor >= GetInfo(type).minComputeCapability;
+#else
+    return false;
+#endif
+}
+
+/*****************************************************************************/
+size_t TensorGemmInputSize(TensorGemmType type)
+{
+    return GetInfo(type).inputSize;
+}
+
+/*****************************************************************************/
+void TensorGemmFillRandom(TensorGemmType type, void *buffer, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        // Multiples of 1/16 in [-2, 2) are exact in every floating point type
+        float value = (float)(rand() % 64) / 16.0f - 2.0f;
+
+        switch (type)
+        {
+            case TensorGemmType::Tf32:
+                static_cast<float *>(buffer)[i] = value;
+                break;
+#if (CUDA_VERSION_USED > 10)
+            case TensorGemmType::Fp16:
+                static_cast<__half *>(buffer)[i] = __float2half(value);
+                break;
+            case TensorGemmType::Bf16:
+                static_cast<__nv_bfloat16 *>(buffer)[i] = __float2bfloat16(value);
+                break;
+#endif
+            case TensorGemmType::Int8:
+                static_cast<int8_t *>(buffer)[i] = (int8_t)(rand() % 16 - 8);
+                break;
+            default:
+                return;
+        }
+    }
+}
+
+/*****************************************************************************/
+cublasStatus_t TensorGemm(cublasHandle_t handle,
+                          TensorGemmType type,
+                          int n,
+                          const void *A,
+                          const void *B,
+                          void *C,
+                          double alpha,
+                          double beta)
+{
+#if (CUDA_VERSION_USED > 10)
+    using namespace Dcgm;
+    float floatAlpha    = (float)alpha;
+    float floatBeta     = (float)beta;
+    int32_t intAlpha    = (int32_t)alpha;
+    int32_t intBeta     = (int32_t)beta;
+    cudaDataType inType = CUDA_R_32F;
+
+    switch (type)
+    {
+        case TensorGemmType::Tf32:
+            inType = CUDA_R_32F;
+            break;
+        case TensorGemmType::Fp16:
+            inType = CUDA_R_16F;
+            break;
+        case TensorGemmType::Bf16:
+            inType = CUDA_R_16BF;
+            break;
+        case TensorGemmType::Int8:
+            return CublasProxy::CublasGemmEx(handle,
+                                             CUBLAS_OP_N,
+                                             CUBLAS_OP_N,
+                                             n,
+                                             n,
+                                             n,
+                                             &intAlpha,
+                                             A,
+                                             CUDA_R_8I,
+                                             n,
+                                             B,
+                                             CUDA_R_8I,
+                                             n,
+                                             &intBeta,
+                                             C,
+                                             CUDA_R_32I,
+                                             n,
+                                             CUBLAS_COMPUTE_32I,
+                                             CUBLAS_GEMM_DEFAULT_TENSOR_OP);
+        default:
+            return CUBLAS_STATUS_NOT_SUPPORTED;
+    }
+
+    return CublasProxy::CublasGemmEx(handle,
+                                     CUBLAS_OP_N,
+                                     CUBLAS_OP_N,
+                                     n,
+                                     n,
+                                     n,
+                                     &floatAlpha,
+                                     A,
+                                     inType,
+                                     n,
+                                     B,
+                                     inType,
+                                     n,
+                                     &floatBeta,
+                                     C,
+                                     CUDA_R_32F,
+                                     n,
+                                     type == TensorGemmType::Tf32 ? CUBLAS_COMPUTE_32F_FAST_TF32 : CUBLAS_COMPUTE_32F,
+                                     CUBLAS_GEMM_DEFAULT_TENSOR_OP);
+#else
+    return CUBLAS_STATUS_NOT_SUPPORTED;
+#endif
+}
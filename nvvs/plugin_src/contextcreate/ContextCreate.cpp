@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include <sstream>
+#include <thread>
 
 #include "ContextCreate.h"
 #include "ContextCreatePlugin.h"
@@ -134,17 +135,36 @@ void ContextCreate::Cleanup()
 int ContextCreate::CanCreateContext()
 {
     int created = CTX_CREATED;
-    CUresult cuSt;
     std::stringstream err;
     std::string error;
+    std::vector<CUresult> results(m_device.size(), CUDA_SUCCESS);
+    std::vector<std::thread> threads;
 
+    /* Context creation dominates this test and doesn't depend on the other GPUs, so do every GPU at once */
+    threads.reserve(m_device.size());
     for (size_t i = 0; i < m_device.size(); i++)
     {
-        cuSt = cuCtxCreate(&m_device[i]->cuContext, 0, m_device[i]->cuDevice);
+        threads.emplace_back([this, i, &results]() {
+            results[i] = cuCtxCreate(&m_device[i]->cuContext, 0, m_device[i]->cuDevice);
+            if (results[i] == CUDA_SUCCESS)
+            {
+                cuCtxDestroy(m_device[i]->cuContext);
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    /* Report in GPU order, the same as when the contexts were created one at a time */
+    for (size_t i = 0; i < m_device.size(); i++)
+    {
+        CUresult cuSt = results[i];
 
         if (cuSt == CUDA_SUCCESS)
         {
-            cuCtxDestroy(m_device[i]->cuContext);
             continue;
         }
         else if (cuSt == CUDA_ERROR_UNKNOWN)
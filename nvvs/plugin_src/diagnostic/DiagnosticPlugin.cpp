@@ -75,6 +75,7 @@ GpuBurnPlugin::GpuBurnPlugin(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuIn
     , m_testDuration(.0)
     , m_sbeFailureThreshold(.0)
     , m_useDoubles(false)
+    , m_tensorType(TensorGemmType::None)
     , m_matrixDim(2048)
     , m_gpuInfo()
 {
@@ -92,6 +93,7 @@ GpuBurnPlugin::GpuBurnPlugin(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuIn
     m_testParameters->AddDouble(DIAGNOSTIC_STR_SBE_ERROR_THRESHOLD, DCGM_FP64_BLANK, 0.0, DCGM_FP64_BLANK);
     m_testParameters->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "False");
     m_testParameters->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 2048.0, 512.0, 8196.0);
+    m_testParameters->AddString(DIAGNOSTIC_STR_TENSOR_PRECISION, "None");
     m_testParameters->AddString(PS_LOGFILE, "stats_diagnostic.json");
     m_testParameters->AddDouble(PS_LOGFILE_TYPE, 0.0, NVVS_LOGFILE_TYPE_JSON, NVVS_LOGFILE_TYPE_BINARY);
 
@@ -141,19 +143,14 @@ bool GpuBurnPlugin::Init(dcgmDiagPluginGpuList_t &gpuInfo)
 
     PRINT_DEBUG("", "Begin Init");
 
-    // Attach to every device by index and reset it in case a previous plugin
-    // didn't clean up after itself.
+    // See CudaResources::ResetDevices()
     int cudaDeviceCount;
 
     cudaSt = cudaGetDeviceCount(&cudaDeviceCount);
     if (cudaSt == cudaSuccess)
     {
-        for (int deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
-        {
-            cudaSetDevice(deviceIdx);
-            cudaDeviceReset();
-            PRINT_DEBUG("%d", "Reset device %d", deviceIdx);
-        }
+        CudaResources::Instance().ResetDevices();
+        PRINT_DEBUG("%d", "Reset %d devices", cudaDeviceCount);
     }
     else
     {
@@ -231,7 +228,41 @@ void GpuBurnPlugin::Go(unsigned int numParameters, const dcgmDiagPluginTestParam
         }
     }
 
-    if (m_useDoubles)
+    std::string tensorPrecision = m_testParameters->GetString(DIAGNOSTIC_STR_TENSOR_PRECISION);
+    if (!ParseTensorGemmType(tensorPrecision, m_tensorType))
+    {
+        std::stringstream ss;
+        ss << "Ignoring unknown " << DIAGNOSTIC_STR_TENSOR_PRECISION << " '" << tensorPrecision << "'";
+        AddInfo(ss.str());
+        m_tensorType = TensorGemmType::None;
+    }
+
+    /* All of the GPUs run the same GEMM, so every one of them needs the tensor cores */
+    for (unsigned int i = 0; i < m_gpuInfo.numGpus && m_tensorType != TensorGemmType::None; i++)
+    {
+        int cudaDevice = 0;
+        int major      = 0;
+        int minor      = 0;
+
+        if (cudaDeviceGetByPCIBusId(&cudaDevice, m_gpuInfo.gpus[i].attributes.identifiers.pciBusId) != cudaSuccess
+            || cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, cudaDevice) != cudaSuccess
+            || cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, cudaDevice) != cudaSuccess
+            || !TensorGemmSupported(m_tensorType, major, minor))
+        {
+            std::stringstream ss;
+            ss << "GPU " << m_gpuInfo.gpus[i].gpuId << " can't run " << TensorGemmTypeName(m_tensorType)
+               << " tensor core GEMMs. Running " << (m_useDoubles ? "DGEMM" : "SGEMM") << " instead.";
+            AddInfo(ss.str());
+            m_tensorType = TensorGemmType::None;
+        }
+    }
+
+    if (m_tensorType != TensorGemmType::None)
+    {
+        /* Tensor core GEMMs have 4-byte results, so the worker's element type is float */
+        result = RunTest<float>();
+    }
+    else if (m_useDoubles)
     {
         result = RunTest<double>();
     }
@@ -288,6 +319,7 @@ public:
     GpuBurnWorker(GpuBurnDevice *gpuBurnDevice,
                   GpuBurnPlugin &plugin,
                   bool useDoubles,
+                  TensorGemmType tensorType,
                   double testDuration,
                   unsigned int matrixDim,
                   DcgmRecorder &dcgmRecorder,
@@ -350,6 +382,16 @@ public:
         m_B = std::make_unique<T[]>(m_matrixDim * m_matrixDim);
 
         srand(10);
+        if (m_tensorType != TensorGemmType::None)
+        {
+            size_t elems = (size_t)m_matrixDim * m_matrixDim;
+            m_tensorA    = std::make_unique<char[]>(elems * TensorGemmInputSize(m_tensorType));
+            m_tensorB    = std::make_unique<char[]>(elems * TensorGemmInputSize(m_tensorType));
+            TensorGemmFillRandom(m_tensorType, m_tensorA.get(), elems);
+            TensorGemmFillRandom(m_tensorType, m_tensorB.get(), elems);
+            return;
+        }
+
         for (size_t i = 0; i < m_matrixDim * m_matrixDim; ++i)
         {
             m_A[i] = (T)((double)(rand() % 1000000) / 100000.0);
@@ -391,6 +433,7 @@ private:
     GpuBurnDevice *m_device;
     GpuBurnPlugin &m_plugin;
     bool m_useDoubles;
+    TensorGemmType m_tensorType;
     double m_testDuration;
     cublasHandle_t m_cublas;
     long long int m_error;
@@ -412,6 +455,8 @@ private:
     CUdeviceptr m_faultyElemData;
     std::unique_ptr<T[]> m_A;
     std::unique_ptr<T[]> m_B;
+    std::unique_ptr<char[]> m_tensorA; /* A and B for the tensor core GEMMs, in their input type */
+    std::unique_ptr<char[]> m_tensorB;
     timelib64_t m_stopTime;
     long long m_totalOperations;
     long long m_totalErrors;
@@ -458,6 +503,7 @@ bool GpuBurnPlugin::RunTest()
             workerThreads[i] = new GpuBurnWorker<T>(m_device[i],
                                                     *this,
                                                     m_useDoubles,
+                                                    m_tensorType,
                                                     m_testDuration,
                                                     m_matrixDim,
                                                     m_dcgmRecorder,
@@ -561,9 +607,11 @@ bool GpuBurnPlugin::RunTest()
         char buf[1024];
         snprintf(buf,
                  sizeof(buf),
-                 "GPU %u calculated at approximately %.2f gigaflops during this test",
+                 "GPU %u calculated at approximately %.2f gigaflops during this test (%s)",
                  m_device[i]->gpuId,
-                 gigaflops);
+                 gigaflops,
+                 m_tensorType != TensorGemmType::None ? TensorGemmTypeName(m_tensorType)
+                                                      : (m_useDoubles ? "FP64" : "FP32"));
         AddInfoVerboseForGpu(m_device[i]->gpuId, buf);
     }
 
@@ -586,6 +634,7 @@ template <class T>
 GpuBurnWorker<T>::GpuBurnWorker(GpuBurnDevice *device,
                                 GpuBurnPlugin &plugin,
                                 bool useDoubles,
+                                TensorGemmType tensorType,
                                 double testDuration,
                                 unsigned int matrixDim,
                                 DcgmRecorder &dr,
@@ -594,6 +643,7 @@ GpuBurnWorker<T>::GpuBurnWorker(GpuBurnDevice *device,
     : m_device(device)
     , m_plugin(plugin)
     , m_useDoubles(useDoubles)
+    , m_tensorType(tensorType)
     , m_testDuration(testDuration)
     , m_cublas(0)
     , m_error(0)
@@ -608,6 +658,8 @@ GpuBurnWorker<T>::GpuBurnWorker(GpuBurnDevice *device,
     , m_faultyElemData(0)
     , m_A(0)
     , m_B(0)
+    , m_tensorA()
+    , m_tensorB()
     , m_stopTime(0)
     , m_totalOperations(0)
     , m_totalErrors(0)
@@ -647,42 +699,25 @@ GpuBurnWorker<T>::GpuBurnWorker(GpuBurnDevice *device,
 template <class T>
 GpuBurnWorker<T>::~GpuBurnWorker()
 {
-    using namespace Dcgm;
     int st = bind();
     if (st != 0)
     {
         DCGM_LOG_ERROR << "bind returned " << st;
     }
 
-    CUresult cuSt;
-    if (m_Adata)
-    {
-        cuSt = cuMemFree(m_Adata);
-        if (cuSt != CUDA_SUCCESS)
-        {
-            LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cuMemFree", cuSt, m_device->gpuId);
-        }
-    }
-    if (m_Bdata)
-    {
-        cuSt = cuMemFree(m_Bdata);
-        if (cuSt != CUDA_SUCCESS)
-        {
-            LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cuMemFree", cuSt, m_device->gpuId);
-        }
-    }
-    if (m_Cdata)
+    /* The buffers go back to the pool and the cuBLAS handle belongs to CudaResources */
+    for (CUdeviceptr devicePtr : { m_Adata, m_Bdata, m_Cdata, m_faultyElemData })
     {
-        cuSt = cuMemFree(m_Cdata);
-        if (cuSt != CUDA_SUCCESS)
+        if (devicePtr)
         {
-            LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cuMemFree", cuSt, m_device->gpuId);
+            CudaResources::Instance().Free(m_device->cuDevice, devicePtr);
         }
     }
 
-    if (m_cublas)
+    /* The context outlives the plugin */
+    if (m_module)
     {
-        CublasProxy::CublasDestroy(m_cublas);
+        cuModuleUnload(m_module);
     }
 }
 
@@ -724,7 +759,7 @@ size_t GpuBurnWorker<T>::availMemory(int &st)
     }
     size_t freeMem;
     size_t totalMem;
-    CUresult cuSt = cuMemGetInfo(&freeMem, &totalMem);
+    CUresult cuSt = CudaResources::Instance().GetFreeMemory(m_device->cuDevice, freeMem, totalMem);
     if (cuSt != CUDA_SUCCESS)
     {
         LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cuMemGetInfo", cuSt, m_device->gpuId);
@@ -752,16 +787,26 @@ int GpuBurnWorker<T>::initBuffers()
         return st;
     }
     size_t resultSize = sizeof(T) * m_matrixDim * m_matrixDim;
-    m_iters           = (useBytes - 2 * resultSize) / resultSize; // We remove A and B sizes
-    CHECK_CUDA_ERROR("cuMemAlloc", cuMemAlloc(&m_Cdata, m_iters * resultSize));
-    CHECK_CUDA_ERROR("cuMemAlloc", cuMemAlloc(&m_Adata, resultSize));
-    CHECK_CUDA_ERROR("cuMemAlloc", cuMemAlloc(&m_Bdata, resultSize));
+    size_t inputSize  = resultSize;
+    const void *hostA = m_A.get();
+    const void *hostB = m_B.get();
+    if (m_tensorType != TensorGemmType::None)
+    {
+        inputSize = TensorGemmInputSize(m_tensorType) * m_matrixDim * m_matrixDim;
+        hostA     = m_tensorA.get();
+        hostB     = m_tensorB.get();
+    }
+    m_iters = (useBytes - 2 * inputSize) / resultSize; // We remove A and B sizes
+    CudaResources &cudaResources = CudaResources::Instance();
+    CHECK_CUDA_ERROR("cuMemAlloc", cudaResources.Allocate(m_device->cuDevice, m_iters * resultSize, m_Cdata));
+    CHECK_CUDA_ERROR("cuMemAlloc", cudaResources.Allocate(m_device->cuDevice, inputSize, m_Adata));
+    CHECK_CUDA_ERROR("cuMemAlloc", cudaResources.Allocate(m_device->cuDevice, inputSize, m_Bdata));
 
-    CHECK_CUDA_ERROR("cuMemAlloc", cuMemAlloc(&m_faultyElemData, sizeof(int)));
+    CHECK_CUDA_ERROR("cuMemAlloc", cudaResources.Allocate(m_device->cuDevice, sizeof(int), m_faultyElemData));
 
     // Populating matrices A and B
-    CHECK_CUDA_ERROR("cuMemcpyHtoD", cuMemcpyHtoD(m_Adata, m_A.get(), resultSize));
-    CHECK_CUDA_ERROR("cuMemcpyHtoD", cuMemcpyHtoD(m_Bdata, m_B.get(), resultSize));
+    CHECK_CUDA_ERROR("cuMemcpyHtoD", cuMemcpyHtoD(m_Adata, hostA, inputSize));
+    CHECK_CUDA_ERROR("cuMemcpyHtoD", cuMemcpyHtoD(m_Bdata, hostB, inputSize));
 
     return initCompareKernel();
 }
@@ -771,8 +816,12 @@ template <class T>
 int GpuBurnWorker<T>::initCompareKernel()
 {
     CHECK_CUDA_ERROR("cuModuleLoadData", cuModuleLoadData(&m_module, (const char *)gpuburn_ptx_string));
-    CHECK_CUDA_ERROR("cuModuleGetFunction",
-                     cuModuleGetFunction(&m_function, m_module, m_useDoubles ? "compareDP64" : "compareFP64"));
+    const char *compareFunction = m_useDoubles ? compareDP64_func_name : compareFP64_func_name;
+    if (m_tensorType == TensorGemmType::Int8)
+    {
+        compareFunction = compareINT32_func_name;
+    }
+    CHECK_CUDA_ERROR("cuModuleGetFunction", cuModuleGetFunction(&m_function, m_module, compareFunction));
 
     CHECK_CUDA_ERROR("cuFuncSetCacheConfig", cuFuncSetCacheConfig(m_function, CU_FUNC_CACHE_PREFER_L1));
     m_params[0] = &m_Cdata;
@@ -836,7 +885,19 @@ int GpuBurnWorker<T>::compute()
 
     for (size_t i = 0; i < m_iters; i++)
     {
-        if (m_useDoubles)
+        if (m_tensorType != TensorGemmType::None)
+        {
+            CHECK_CUBLAS_ERROR("cublasGemmEx",
+                               TensorGemm(m_cublas,
+                                          m_tensorType,
+                                          m_matrixDim,
+                                          (const void *)m_Adata,
+                                          (const void *)m_Bdata,
+                                          (float *)m_Cdata + i * m_matrixDim * m_matrixDim,
+                                          1.0,
+                                          0.0));
+        }
+        else if (m_useDoubles)
         {
             CHECK_CUBLAS_ERROR("cublasDgemm",
                                CublasProxy::CublasDgemm(m_cublas,
@@ -883,7 +944,8 @@ void GpuBurnWorker<T>::run()
     using namespace Dcgm;
     double startTime;
     double iterEnd;
-    std::string gflopsKey(PERF_STAT_NAME);
+    CustomGpuStatBuffer stats(m_plugin.GetCustomStatHolder(), m_device->gpuId);
+    customStatHandle_t perfStat = m_plugin.GetCustomStatHolder().RegisterStat(PERF_STAT_NAME);
 
     int st = bind();
     if (st)
@@ -892,7 +954,7 @@ void GpuBurnWorker<T>::run()
         return;
     }
 
-    cublasStatus_t cubSt = CublasProxy::CublasCreate(&m_cublas);
+    cublasStatus_t cubSt = CudaResources::Instance().GetCublasHandle(m_device->cuDevice, m_cublas);
     if (cubSt != CUBLAS_STATUS_SUCCESS)
     {
         LOG_CUBLAS_ERROR_FOR_PLUGIN(&m_plugin, "cublasCreate", cubSt, 0, 0, false);
@@ -927,7 +989,7 @@ void GpuBurnWorker<T>::run()
         iterEnd = timelib_dsecSince1970();
 
         double gflops = m_iters * OPS_PER_MUL / (1024 * 1024 * 1024) / (iterEnd - iterStart);
-        m_plugin.SetGpuStat(m_device->gpuId, gflopsKey, gflops);
+        stats.Append(perfStat, gflops);
 
     } while (iterEnd - startTime < m_testDuration && !ShouldStop());
     m_stopTime = timelib_usecSince1970();
@@ -17,12 +17,14 @@
 #define DIAGNOSTICPLUGIN_H
 
 #include "CudaCommon.h"
+#include "CudaResources.h"
 #include "DcgmError.h"
 #include "DcgmRecorder.h"
 #include "Plugin.h"
 #include "PluginCommon.h"
 #include "PluginDevice.h"
 #include "PluginStrings.h"
+#include "TensorGemm.h"
 #include <PluginInterface.h>
 
 #include <cublas_proxy.hpp>
@@ -204,6 +206,7 @@ private:
     double m_testDuration;             /* test length, in seconds */
     double m_sbeFailureThreshold;      /* Failure threshold for SBEs. Below this it's a warning */
     bool m_useDoubles;                 /* true if we should use doubles instead of floats */
+    TensorGemmType m_tensorType;       /* Tensor core GEMM to run instead of S/Dgemm */
     unsigned int m_matrixDim;          /* The dimension size of the matrix */
     dcgmDiagPluginGpuList_t m_gpuInfo; // The information about each GPU
 };
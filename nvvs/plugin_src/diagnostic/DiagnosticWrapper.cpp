@@ -30,10 +30,11 @@ dcgmReturn_t GetPluginInfo(unsigned int pluginInterfaceVersion, dcgmDiagPluginIn
                                      DIAGNOSTIC_STR_TEMPERATURE_MAX,
                                      DIAGNOSTIC_STR_IS_ALLOWED,
                                      DIAGNOSTIC_STR_MATRIX_DIM,
+                                     DIAGNOSTIC_STR_TENSOR_PRECISION,
                                      nullptr };
     const dcgmPluginValue_t paramTypes[]
-        = { DcgmPluginParamInt,  DcgmPluginParamInt, DcgmPluginParamBool, DcgmPluginParamFloat,
-            DcgmPluginParamBool, DcgmPluginParamInt, DcgmPluginParamNone };
+        = { DcgmPluginParamInt,  DcgmPluginParamInt, DcgmPluginParamBool,   DcgmPluginParamFloat,
+            DcgmPluginParamBool, DcgmPluginParamInt, DcgmPluginParamString, DcgmPluginParamNone };
     DCGM_CASSERT(sizeof(parameterNames) / sizeof(const char *) == sizeof(paramTypes) / sizeof(const dcgmPluginValue_t),
                  1);
 
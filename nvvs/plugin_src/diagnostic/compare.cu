@@ -59,3 +59,18 @@ extern "C" __global__ void compareDP64(double *C, int *faultyElems, size_t iters
 
 	atomicAdd(faultyElems, myFaulty);
 }
+
+// Integer results of the INT8 tensor core GEMMs are exact
+extern "C" __global__ void compareINT32(int *C, int *faultyElems, size_t iters) {
+	size_t iterStep = blockDim.x*blockDim.y*gridDim.x*gridDim.y;
+	size_t myIndex = (blockIdx.y*blockDim.y + threadIdx.y)* // Y
+		gridDim.x*blockDim.x + // W
+		blockIdx.x*blockDim.x + threadIdx.x; // X
+
+	int myFaulty = 0;
+	for (size_t i = 1; i < iters; ++i)
+		if (C[myIndex] != C[myIndex + i*iterStep])
+			myFaulty++;
+
+	atomicAdd(faultyElems, myFaulty);
+}
@@ -199,7 +199,89 @@ unsigned char gpuburn_ptx_string[] = {
     0x75, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x38, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x38, 0x3b, 0x0a, 0x09,
     0x61, 0x74, 0x6f, 0x6d, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61, 0x6c, 0x2e, 0x61, 0x64, 0x64, 0x2e, 0x75, 0x33, 0x32,
     0x20, 0x09, 0x25, 0x72, 0x32, 0x33, 0x2c, 0x20, 0x5b, 0x25, 0x72, 0x64, 0x31, 0x38, 0x5d, 0x2c, 0x20, 0x25, 0x72,
-    0x32, 0x34, 0x3b, 0x0a, 0x09, 0x72, 0x65, 0x74, 0x3b, 0x0a, 0x7d, 0x0a, 0x0a, 0x0a, 0x00
+    0x32, 0x34, 0x3b, 0x0a, 0x09, 0x72, 0x65, 0x74, 0x3b, 0x0a, 0x7d, 0x0a, 0x0a, 0x09, 0x2f, 0x2f, 0x20, 0x2e, 0x67,
+    0x6c, 0x6f, 0x62, 0x6c, 0x09, 0x63, 0x6f, 0x6d, 0x70, 0x61, 0x72, 0x65, 0x49, 0x4e, 0x54, 0x33, 0x32, 0x0a, 0x2e,
+    0x76, 0x69, 0x73, 0x69, 0x62, 0x6c, 0x65, 0x20, 0x2e, 0x65, 0x6e, 0x74, 0x72, 0x79, 0x20, 0x63, 0x6f, 0x6d, 0x70,
+    0x61, 0x72, 0x65, 0x49, 0x4e, 0x54, 0x33, 0x32, 0x28, 0x0a, 0x09, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x20, 0x2e,
+    0x75, 0x36, 0x34, 0x20, 0x63, 0x6f, 0x6d, 0x70, 0x61, 0x72, 0x65, 0x49, 0x4e, 0x54, 0x33, 0x32, 0x5f, 0x70, 0x61,
+    0x72, 0x61, 0x6d, 0x5f, 0x30, 0x2c, 0x0a, 0x09, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x20, 0x2e, 0x75, 0x36, 0x34,
+    0x20, 0x63, 0x6f, 0x6d, 0x70, 0x61, 0x72, 0x65, 0x49, 0x4e, 0x54, 0x33, 0x32, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d,
+    0x5f, 0x31, 0x2c, 0x0a, 0x09, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x20, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x63, 0x6f,
+    0x6d, 0x70, 0x61, 0x72, 0x65, 0x49, 0x4e, 0x54, 0x33, 0x32, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x5f, 0x32, 0x0a,
+    0x29, 0x0a, 0x7b, 0x0a, 0x09, 0x2e, 0x72, 0x65, 0x67, 0x20, 0x2e, 0x70, 0x72, 0x65, 0x64, 0x20, 0x09, 0x25, 0x70,
+    0x3c, 0x34, 0x3e, 0x3b, 0x0a, 0x09, 0x2e, 0x72, 0x65, 0x67, 0x20, 0x2e, 0x62, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72,
+    0x3c, 0x32, 0x35, 0x3e, 0x3b, 0x0a, 0x09, 0x2e, 0x72, 0x65, 0x67, 0x20, 0x2e, 0x62, 0x36, 0x34, 0x20, 0x09, 0x25,
+    0x72, 0x64, 0x3c, 0x32, 0x31, 0x3e, 0x3b, 0x0a, 0x0a, 0x0a, 0x09, 0x6c, 0x64, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d,
+    0x2e, 0x75, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x37, 0x2c, 0x20, 0x5b, 0x63, 0x6f, 0x6d, 0x70, 0x61, 0x72,
+    0x65, 0x49, 0x4e, 0x54, 0x33, 0x32, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x5f, 0x30, 0x5d, 0x3b, 0x0a, 0x09, 0x6c,
+    0x64, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x38, 0x2c, 0x20,
+    0x5b, 0x63, 0x6f, 0x6d, 0x70, 0x61, 0x72, 0x65, 0x49, 0x4e, 0x54, 0x33, 0x32, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d,
+    0x5f, 0x31, 0x5d, 0x3b, 0x0a, 0x09, 0x6c, 0x64, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x2e, 0x75, 0x36, 0x34, 0x20,
+    0x09, 0x25, 0x72, 0x64, 0x39, 0x2c, 0x20, 0x5b, 0x63, 0x6f, 0x6d, 0x70, 0x61, 0x72, 0x65, 0x49, 0x4e, 0x54, 0x33,
+    0x32, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x5f, 0x32, 0x5d, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33,
+    0x32, 0x20, 0x09, 0x25, 0x72, 0x32, 0x34, 0x2c, 0x20, 0x30, 0x3b, 0x0a, 0x09, 0x73, 0x65, 0x74, 0x70, 0x2e, 0x6c,
+    0x74, 0x2e, 0x75, 0x36, 0x34, 0x09, 0x25, 0x70, 0x31, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x39, 0x2c, 0x20, 0x32, 0x3b,
+    0x0a, 0x09, 0x40, 0x25, 0x70, 0x31, 0x20, 0x62, 0x72, 0x61, 0x20, 0x09, 0x42, 0x42, 0x32, 0x5f, 0x33, 0x3b, 0x0a,
+    0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x36, 0x2c, 0x20, 0x25, 0x6e, 0x63,
+    0x74, 0x61, 0x69, 0x64, 0x2e, 0x79, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25,
+    0x72, 0x37, 0x2c, 0x20, 0x25, 0x63, 0x74, 0x61, 0x69, 0x64, 0x2e, 0x79, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e,
+    0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x38, 0x2c, 0x20, 0x25, 0x6e, 0x74, 0x69, 0x64, 0x2e, 0x79, 0x3b, 0x0a,
+    0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x39, 0x2c, 0x20, 0x25, 0x74, 0x69, 0x64,
+    0x2e, 0x79, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x30, 0x2c,
+    0x20, 0x25, 0x6e, 0x63, 0x74, 0x61, 0x69, 0x64, 0x2e, 0x78, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33,
+    0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x31, 0x2c, 0x20, 0x25, 0x63, 0x74, 0x61, 0x69, 0x64, 0x2e, 0x78, 0x3b, 0x0a,
+    0x09, 0x6d, 0x61, 0x64, 0x2e, 0x6c, 0x6f, 0x2e, 0x73, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x32, 0x2c, 0x20,
+    0x25, 0x72, 0x37, 0x2c, 0x20, 0x25, 0x72, 0x38, 0x2c, 0x20, 0x25, 0x72, 0x39, 0x3b, 0x0a, 0x09, 0x6d, 0x61, 0x64,
+    0x2e, 0x6c, 0x6f, 0x2e, 0x73, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x33, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x32,
+    0x2c, 0x20, 0x25, 0x72, 0x31, 0x30, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x31, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e,
+    0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x34, 0x2c, 0x20, 0x25, 0x6e, 0x74, 0x69, 0x64, 0x2e, 0x78, 0x3b,
+    0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x35, 0x2c, 0x20, 0x25, 0x74,
+    0x69, 0x64, 0x2e, 0x78, 0x3b, 0x0a, 0x09, 0x6d, 0x61, 0x64, 0x2e, 0x6c, 0x6f, 0x2e, 0x73, 0x33, 0x32, 0x20, 0x09,
+    0x25, 0x72, 0x31, 0x36, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x33, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x34, 0x2c, 0x20, 0x25,
+    0x72, 0x31, 0x35, 0x3b, 0x0a, 0x09, 0x63, 0x76, 0x74, 0x61, 0x2e, 0x74, 0x6f, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61,
+    0x6c, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x31, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x37, 0x3b,
+    0x0a, 0x09, 0x6d, 0x75, 0x6c, 0x2e, 0x77, 0x69, 0x64, 0x65, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x64,
+    0x31, 0x32, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x36, 0x2c, 0x20, 0x34, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64, 0x2e, 0x73,
+    0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x33, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x31, 0x2c, 0x20, 0x25,
+    0x72, 0x64, 0x31, 0x32, 0x3b, 0x0a, 0x09, 0x6c, 0x64, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61, 0x6c, 0x2e, 0x75, 0x33,
+    0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x2c, 0x20, 0x5b, 0x25, 0x72, 0x64, 0x31, 0x33, 0x5d, 0x3b, 0x0a, 0x09, 0x6d,
+    0x75, 0x6c, 0x2e, 0x6c, 0x6f, 0x2e, 0x73, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x37, 0x2c, 0x20, 0x25, 0x72,
+    0x38, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x34, 0x3b, 0x0a, 0x09, 0x6d, 0x75, 0x6c, 0x2e, 0x6c, 0x6f, 0x2e, 0x73, 0x33,
+    0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x38, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x37, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x30,
+    0x3b, 0x0a, 0x09, 0x6d, 0x75, 0x6c, 0x2e, 0x6c, 0x6f, 0x2e, 0x73, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x39,
+    0x2c, 0x20, 0x25, 0x72, 0x31, 0x38, 0x2c, 0x20, 0x25, 0x72, 0x36, 0x3b, 0x0a, 0x09, 0x63, 0x76, 0x74, 0x2e, 0x75,
+    0x36, 0x34, 0x2e, 0x75, 0x33, 0x32, 0x09, 0x25, 0x72, 0x64, 0x31, 0x34, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x39, 0x3b,
+    0x0a, 0x09, 0x6d, 0x61, 0x64, 0x2e, 0x6c, 0x6f, 0x2e, 0x73, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x32, 0x30, 0x2c,
+    0x20, 0x25, 0x72, 0x31, 0x30, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x32, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x31, 0x3b, 0x0a,
+    0x09, 0x6d, 0x61, 0x64, 0x2e, 0x6c, 0x6f, 0x2e, 0x73, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x32, 0x31, 0x2c, 0x20,
+    0x25, 0x72, 0x31, 0x34, 0x2c, 0x20, 0x25, 0x72, 0x32, 0x30, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x35, 0x3b, 0x0a, 0x09,
+    0x63, 0x76, 0x74, 0x2e, 0x75, 0x36, 0x34, 0x2e, 0x75, 0x33, 0x32, 0x09, 0x25, 0x72, 0x64, 0x31, 0x35, 0x2c, 0x20,
+    0x25, 0x72, 0x32, 0x31, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64, 0x2e, 0x73, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64,
+    0x31, 0x36, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x34, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x35, 0x3b, 0x0a, 0x09,
+    0x73, 0x68, 0x6c, 0x2e, 0x62, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x37, 0x2c, 0x20, 0x25, 0x72, 0x64,
+    0x31, 0x36, 0x2c, 0x20, 0x32, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64, 0x2e, 0x73, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72,
+    0x64, 0x31, 0x39, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x31, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x37, 0x3b, 0x0a,
+    0x09, 0x6d, 0x75, 0x6c, 0x2e, 0x77, 0x69, 0x64, 0x65, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x64, 0x32,
+    0x2c, 0x20, 0x25, 0x72, 0x31, 0x39, 0x2c, 0x20, 0x34, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32,
+    0x20, 0x09, 0x25, 0x72, 0x32, 0x34, 0x2c, 0x20, 0x30, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x36, 0x34,
+    0x20, 0x09, 0x25, 0x72, 0x64, 0x32, 0x30, 0x2c, 0x20, 0x31, 0x3b, 0x0a, 0x0a, 0x42, 0x42, 0x32, 0x5f, 0x32, 0x3a,
+    0x0a, 0x09, 0x6c, 0x64, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61, 0x6c, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72,
+    0x32, 0x2c, 0x20, 0x5b, 0x25, 0x72, 0x64, 0x31, 0x39, 0x5d, 0x3b, 0x0a, 0x09, 0x73, 0x65, 0x74, 0x70, 0x2e, 0x6e,
+    0x65, 0x2e, 0x73, 0x33, 0x32, 0x09, 0x25, 0x70, 0x32, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x2c, 0x20, 0x25, 0x72, 0x32,
+    0x3b, 0x0a, 0x09, 0x73, 0x65, 0x6c, 0x70, 0x2e, 0x75, 0x33, 0x32, 0x09, 0x25, 0x72, 0x32, 0x32, 0x2c, 0x20, 0x31,
+    0x2c, 0x20, 0x30, 0x2c, 0x20, 0x25, 0x70, 0x32, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64, 0x2e, 0x73, 0x33, 0x32, 0x20,
+    0x09, 0x25, 0x72, 0x32, 0x34, 0x2c, 0x20, 0x25, 0x72, 0x32, 0x32, 0x2c, 0x20, 0x25, 0x72, 0x32, 0x34, 0x3b, 0x0a,
+    0x09, 0x61, 0x64, 0x64, 0x2e, 0x73, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x39, 0x2c, 0x20, 0x25, 0x72,
+    0x64, 0x31, 0x39, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x32, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64, 0x2e, 0x73, 0x36, 0x34,
+    0x20, 0x09, 0x25, 0x72, 0x64, 0x32, 0x30, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x32, 0x30, 0x2c, 0x20, 0x31, 0x3b, 0x0a,
+    0x09, 0x73, 0x65, 0x74, 0x70, 0x2e, 0x6c, 0x74, 0x2e, 0x75, 0x36, 0x34, 0x09, 0x25, 0x70, 0x33, 0x2c, 0x20, 0x25,
+    0x72, 0x64, 0x32, 0x30, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x39, 0x3b, 0x0a, 0x09, 0x40, 0x25, 0x70, 0x33, 0x20, 0x62,
+    0x72, 0x61, 0x20, 0x09, 0x42, 0x42, 0x32, 0x5f, 0x32, 0x3b, 0x0a, 0x0a, 0x42, 0x42, 0x32, 0x5f, 0x33, 0x3a, 0x0a,
+    0x09, 0x63, 0x76, 0x74, 0x61, 0x2e, 0x74, 0x6f, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61, 0x6c, 0x2e, 0x75, 0x36, 0x34,
+    0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x38, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x38, 0x3b, 0x0a, 0x09, 0x61, 0x74, 0x6f,
+    0x6d, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61, 0x6c, 0x2e, 0x61, 0x64, 0x64, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25,
+    0x72, 0x32, 0x33, 0x2c, 0x20, 0x5b, 0x25, 0x72, 0x64, 0x31, 0x38, 0x5d, 0x2c, 0x20, 0x25, 0x72, 0x32, 0x34, 0x3b,
+    0x0a, 0x09, 0x72, 0x65, 0x74, 0x3b, 0x0a, 0x7d, 0x0a, 0x0a, 0x0a, 0x00
 };
 
 #ifdef __cplusplus
@@ -209,3 +291,4 @@ unsigned char gpuburn_ptx_string[] = {
 
 const char *compareFP64_func_name = "compareFP64";
 const char *compareDP64_func_name = "compareDP64";
+const char *compareINT32_func_name = "compareINT32";
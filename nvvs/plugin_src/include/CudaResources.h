@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NVVS_NVVS_Cuda_resources_H_
+#define _NVVS_NVVS_Cuda_resources_H_
+
+#include <cublas_v2.h>
+#include <cuda.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+/*
+ * CUDA resources shared by the plugins of a run: the primary context of each device, a cuBLAS handle per device
+ * (kept by cublas_proxy) and a pool of device memory that plugins carve their buffers from.
+ *
+ * Creating contexts and allocating most of the framebuffer takes seconds on large GPUs. The instance lives in
+ * libpluginCommon, which stays loaded for as long as the framework keeps the plugins loaded, so all of this is
+ * set up once per run instead of once per plugin. Memory freed with Free() goes back to the pool, not to the
+ * driver.
+ *
+ * Everything is keyed by CUdevice, which is also the CUDA runtime device index. The contexts, cuBLAS handles and
+ * device pointers plugins get from here belong to CudaResources: plugins give buffers back with Free() and never
+ * destroy the others.
+ */
+class CudaResources
+{
+public:
+    static CudaResources &Instance();
+
+    /* Frees the pool, destroys the cuBLAS handles and releases the contexts */
+    ~CudaResources();
+
+    /*************************************************************************/
+    /*
+     * Get the primary context of device, retaining it for the rest of the run, and make it current
+     */
+    CUresult GetContext(CUdevice device, CUcontext &context);
+
+    /*************************************************************************/
+    /*
+     * Get the cuBLAS handle of device, cached by cublas_proxy for the rest of the run. Its stream and math mode
+     * are reset to the defaults. Callers must not destroy it
+     */
+    cublasStatus_t GetCublasHandle(CUdevice device, cublasHandle_t &handle);
+
+    /*************************************************************************/
+    /*
+     * Get bytes of device memory from the pool, growing the pool if it has no free range big enough
+     */
+    CUresult Allocate(CUdevice device, size_t bytes, CUdeviceptr &ptr);
+
+    /*************************************************************************/
+    /*
+     * Get as much device memory as possible, but at least minBytes. Reuses the largest free range of the pool if
+     * the driver has less free memory than that. bytes is set to the size that was allocated
+     */
+    CUresult AllocateLargest(CUdevice device, size_t minBytes, CUdeviceptr &ptr, size_t &bytes);
+
+    /*************************************************************************/
+    /*
+     * Return memory from Allocate() or AllocateLargest() to the pool. Unknown pointers are ignored
+     */
+    void Free(CUdevice device, CUdeviceptr ptr);
+
+    /*************************************************************************/
+    /*
+     * Free memory of device: what the driver has free plus what is free in the pool
+     */
+    CUresult GetFreeMemory(CUdevice device, size_t &freeBytes, size_t &totalBytes);
+
+    /*************************************************************************/
+    /*
+     * Replaces resetting every device at the start and end of a plugin. Plugins call it when they start, in case
+     * a previous plugin didn't clean up after itself, and when they are done with their devices.
+     *
+     * Devices with shared resources keep them for the plugins that run next, minus anything a plugin left
+     * allocated in the pool. They are only reset if their context has a sticky error. The other devices are reset
+     * with cudaDeviceReset()
+     */
+    void ResetDevices();
+
+private:
+    struct Chunk
+    {
+        CUdeviceptr base;
+        size_t size;
+    };
+
+    struct DeviceResources
+    {
+        CUcontext context = nullptr;
+        std::vector<Chunk> chunks;                  /* Driver allocations backing the pool */
+        std::map<CUdeviceptr, size_t> freeRanges;   /* Address-ordered free ranges of the chunks */
+        std::map<CUdeviceptr, size_t> allocations;  /* Ranges handed out */
+    };
+
+    std::mutex m_mutex; /* Guards m_devices */
+    std::map<CUdevice, DeviceResources> m_devices;
+
+    CudaResources() = default;
+
+    /* Caller holds m_mutex */
+    CUresult GetContextLocked(CUdevice device, DeviceResources &resources);
+    bool CarveLocked(DeviceResources &resources, size_t bytes, CUdeviceptr &ptr);
+    CUresult AddChunkLocked(DeviceResources &resources, size_t bytes);
+    void TrimLocked(DeviceResources &resources);
+    size_t LargestFreeRangeLocked(DeviceResources const &resources) const;
+    void ReleaseLocked(CUdevice device, DeviceResources &resources, bool reset);
+};
+
+#endif // _NVVS_NVVS_Cuda_resources_H_
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NVVS_NVVS_TensorGemm_H_
+#define _NVVS_NVVS_TensorGemm_H_
+
+#include <cublas_v2.h>
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Tensor core GEMMs for the plugins that otherwise only run cublasSgemm/cublasDgemm. They go through
+ * cublasGemmEx, which needs the CUDA 11 cuBLAS: with older CUDA versions only TensorGemmType::None is supported.
+ *
+ * A and B hold TensorGemmInputSize() bytes per element. C always holds 4 bytes per element: floats for the
+ * floating point types and 32-bit integers for Int8.
+ */
+enum class TensorGemmType
+{
+    None, /* Not a tensor core GEMM: the plugin's own S/Dgemm */
+    Tf32, /* float inputs, TF32 multiplies */
+    Fp16, /* half inputs, float accumulation */
+    Bf16, /* bfloat16 inputs, float accumulation */
+    Int8, /* 8-bit integer inputs, 32-bit integer accumulation */
+};
+
+/*****************************************************************************/
+/*
+ * Parse a tensor_precision parameter value, ignoring case. An empty string is None.
+ * Returns false if name isn't a known type
+ */
+bool ParseTensorGemmType(const std::string &name, TensorGemmType &type);
+
+/*****************************************************************************/
+const char *TensorGemmTypeName(TensorGemmType type);
+
+/*****************************************************************************/
+/*
+ * Whether the GPU has tensor cores for type and this build can drive them
+ */
+bool TensorGemmSupported(TensorGemmType type, int computeCapabilityMajor, int computeCapabilityMinor);
+
+/*****************************************************************************/
+size_t TensorGemmInputSize(TensorGemmType type);
+
+/*****************************************************************************/
+/*
+ * Fill a host buffer of count A or B elements with rand() values small enough that the products can't overflow
+ */
+void TensorGemmFillRandom(TensorGemmType type, void *buffer, size_t count);
+
+/*****************************************************************************/
+/*
+ * C = alpha * A * B + beta * C for column major n x n matrices on the handle's current stream.
+ * alpha and beta are truncated to integers for Int8
+ */
+cublasStatus_t TensorGemm(cublasHandle_t handle,
+                          TensorGemmType type,
+                          int n,
+                          const void *A,
+                          const void *B,
+                          void *C,
+                          double alpha,
+                          double beta);
+
+#endif // _NVVS_NVVS_TensorGemm_H_
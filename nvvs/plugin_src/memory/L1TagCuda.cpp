@@ -27,40 +27,46 @@ void L1TagCuda::Cleanup(void)
 {
     CUresult cuRes;
 
-    if (m_cuMod)
+    // Everything is allocated after the module is loaded
+    if (!m_cuMod)
     {
         return;
     }
 
-    if (m_hostErrorLog)
+    // The objects of several GPUs may be cleaned up from one thread
+    cuCtxSetCurrent(m_cuCtx);
+
+    if (m_stream)
     {
-        delete[] m_hostErrorLog;
+        cuStreamDestroy(m_stream);
+        m_stream = NULL;
     }
 
-    if (m_l1Data)
+    for (CUevent *event : { &m_startEvent, &m_stopEvent })
     {
-        cuRes = cuMemFree(m_l1Data);
-        if (CUDA_SUCCESS != cuRes)
+        if (*event)
         {
-            LOG_CUDA_ERROR_FOR_PLUGIN(m_plugin, "cuMemFree", cuRes, m_gpuIndex);
+            cuEventDestroy(*event);
+            *event = NULL;
         }
     }
 
-    if (m_devMiscompareCount)
+    if (m_hostErrorLog)
     {
-        cuRes = cuMemFree(m_devMiscompareCount);
-        if (CUDA_SUCCESS != cuRes)
-        {
-            LOG_CUDA_ERROR_FOR_PLUGIN(m_plugin, "cuMemFree", cuRes, m_gpuIndex);
-        }
+        delete[] m_hostErrorLog;
+        m_hostErrorLog = NULL;
     }
 
-    if (m_devErrorLog)
+    for (CUdeviceptr *devicePtr : { &m_l1Data, &m_devMiscompareCount, &m_devErrorLog })
     {
-        cuRes = cuMemFree(m_devErrorLog);
-        if (CUDA_SUCCESS != cuRes)
+        if (*devicePtr)
         {
-            LOG_CUDA_ERROR_FOR_PLUGIN(m_plugin, "cuMemFree", cuRes, m_gpuIndex);
+            cuRes = cuMemFree(*devicePtr);
+            if (CUDA_SUCCESS != cuRes)
+            {
+                LOG_CUDA_ERROR_FOR_PLUGIN(m_plugin, "cuMemFree", cuRes, m_gpuIndex);
+            }
+            *devicePtr = (CUdeviceptr)NULL;
         }
     }
 
@@ -69,6 +75,7 @@ void L1TagCuda::Cleanup(void)
     {
         LOG_CUDA_ERROR_FOR_PLUGIN(m_plugin, "cuModuleUnload", cuRes, m_gpuIndex);
     }
+    m_cuMod = NULL;
 }
 
 int L1TagCuda::AllocDeviceMem(int size, CUdeviceptr *ptr)
@@ -149,11 +156,19 @@ nvvsPluginResult_t L1TagCuda::LogCudaFail(const char *msg, const char *cudaFuncS
     return NVVS_RESULT_FAIL;
 }
 
-nvvsPluginResult_t L1TagCuda::RunTest(void)
+nvvsPluginResult_t L1TagCuda::Setup(unsigned int dcgmGpuIndex)
 {
     CUresult cuRes;
     int attr;
 
+    m_gpuIndex = dcgmGpuIndex;
+
+    m_runtimeMs       = 1000 * (uint32_t)m_testParameters->GetDouble(MEMORY_L1TAG_STR_TEST_DURATION);
+    m_testLoops       = (uint64_t)m_testParameters->GetDouble(MEMORY_L1TAG_STR_TEST_LOOPS);
+    m_innerIterations = (uint64_t)m_testParameters->GetDouble(MEMORY_L1TAG_STR_INNER_ITERATIONS);
+    m_errorLogLen     = (uint32_t)m_testParameters->GetDouble(MEMORY_L1TAG_STR_ERROR_LOG_LEN);
+    m_dumpMiscompares = m_testParameters->GetBoolFromString(MEMORY_L1TAG_STR_DUMP_MISCOMPARES);
+
     cuRes = cuModuleLoadData(&m_cuMod, l1tag_ptx_string);
     if (CUDA_SUCCESS != cuRes)
     {
@@ -180,14 +195,12 @@ nvvsPluginResult_t L1TagCuda::RunTest(void)
         return NVVS_RESULT_SKIP;
     }
 
-    uint32_t numBlocks = 0;
-
     cuRes = cuDeviceGetAttribute(&attr, CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT, m_cuDevice);
     if (CUDA_SUCCESS != cuRes)
     {
         return LogCudaFail("Unable to get multiprocessor count", "cuDeviceGetAttribute", cuRes);
     }
-    numBlocks = (uint32_t)attr;
+    m_numBlocks = (uint32_t)attr;
 
     // Get Compute capability
     int cuMajor;
@@ -213,7 +226,6 @@ nvvsPluginResult_t L1TagCuda::RunTest(void)
     }
 
     // Set number of threads.
-    uint32_t numThreads = 0;
     uint32_t maxThreads;
 
     cuRes = cuDeviceGetAttribute(&attr, CU_DEVICE_ATTRIBUTE_MAX_THREADS_PER_BLOCK, m_cuDevice);
@@ -223,16 +235,15 @@ nvvsPluginResult_t L1TagCuda::RunTest(void)
     }
     maxThreads = (uint32_t)attr;
 
-    numThreads = l1PerSMBytes / L1_LINE_SIZE_BYTES;
-    if (numThreads > maxThreads)
+    m_numThreads = l1PerSMBytes / L1_LINE_SIZE_BYTES;
+    if (m_numThreads > maxThreads)
     {
-        numThreads = maxThreads;
+        m_numThreads = maxThreads;
     }
     assert(l1PerSMBytes % L1_LINE_SIZE_BYTES == 0);
 
     // Allocate memory for L1
-    int l1Size = numBlocks * l1PerSMBytes;
-    uint64_t hostMiscompareCount;
+    int l1Size = m_numBlocks * l1PerSMBytes;
 
     if (AllocDeviceMem(l1Size, &m_l1Data))
     {
@@ -259,52 +270,61 @@ nvvsPluginResult_t L1TagCuda::RunTest(void)
     m_kernelParams.errorLogLen   = m_errorLogLen;
     m_kernelParams.iterations    = m_innerIterations;
 
-    PRINT_INFO("%u", "L1tag #processor = %u\n", numBlocks);
+    PRINT_INFO("%u", "L1tag #processor = %u\n", m_numBlocks);
     PRINT_INFO("%d %d", "Compute cap=%d.%d\n", cuMajor, cuMinor);
-    PRINT_INFO("%u %u", "Threads = %u, %u max\n", numThreads, maxThreads);
+    PRINT_INFO("%u %u", "Threads = %u, %u max\n", m_numThreads, maxThreads);
     PRINT_INFO("%d", "L1 Size = %d\n", l1Size);
 
-    double durationMs = 0.0;
-
     // Get Init function
-    CUfunction initL1DataFunc;
-    cuRes = cuModuleGetFunction(&initL1DataFunc, m_cuMod, InitL1Data_func_name);
+    cuRes = cuModuleGetFunction(&m_initL1DataFunc, m_cuMod, InitL1Data_func_name);
     if (CUDA_SUCCESS != cuRes)
     {
         return LogCudaFail("Unable to load module function InitL1Data", "cuModuleGetFunction", cuRes);
     }
 
     // Get tag test (run) function.
-    CUfunction testRunDataFunc;
-    cuRes = cuModuleGetFunction(&testRunDataFunc, m_cuMod, L1TagTest_func_name);
+    cuRes = cuModuleGetFunction(&m_testRunDataFunc, m_cuMod, L1TagTest_func_name);
     if (CUDA_SUCCESS != cuRes)
     {
         return LogCudaFail("Unable to load module function L1TagTest", "cuModuleGetFunction", cuRes);
     }
 
     // Create events for timing kernel
-    CUevent startEvent;
-    cuRes = cuEventCreate(&startEvent, CU_EVENT_DEFAULT);
+    cuRes = cuEventCreate(&m_startEvent, CU_EVENT_DEFAULT);
     if (CUDA_SUCCESS != cuRes)
     {
         return LogCudaFail("Unable create CUDA event", "cuEventCreate", cuRes);
     }
 
-    CUevent stopEvent;
-    cuRes = cuEventCreate(&stopEvent, CU_EVENT_DEFAULT);
+    cuRes = cuEventCreate(&m_stopEvent, CU_EVENT_DEFAULT);
     if (CUDA_SUCCESS != cuRes)
     {
         return LogCudaFail("Unable create CUDA event", "cuEventCreate", cuRes);
     }
 
-    // Create stream to synchronize accesses
-    CUstream stream;
-    cuRes = cuStreamCreate(&stream, CU_STREAM_NON_BLOCKING);
+    // Create stream to synchronize accesses. It doesn't wait for the memory test's work on the default stream
+    cuRes = cuStreamCreate(&m_stream, CU_STREAM_NON_BLOCKING);
     if (CUDA_SUCCESS != cuRes)
     {
         return LogCudaFail("Unable create CUDA stream", "cuStreamCreate", cuRes);
     }
 
+    return NVVS_RESULT_PASS;
+}
+
+nvvsPluginResult_t L1TagCuda::RunTest(void)
+{
+    CUresult cuRes;
+    uint64_t hostMiscompareCount;
+    double durationMs = 0.0;
+
+    // Each GPU's test may run on a thread of its own
+    cuRes = cuCtxSetCurrent(m_cuCtx);
+    if (CUDA_SUCCESS != cuRes)
+    {
+        return LogCudaFail("Unable to make the CUDA context current", "cuCtxSetCurrent", cuRes);
+    }
+
     // Run for runtimeMs if it is nonzero.
     // Otherwise run for m_testLoops loops.
     uint64_t totalNumErrors  = 0;
@@ -313,7 +333,7 @@ nvvsPluginResult_t L1TagCuda::RunTest(void)
     {
         // Clear error counter
         uint64_t zeroVal = 0;
-        cuRes            = cuMemcpyHtoDAsync(m_devMiscompareCount, &zeroVal, sizeof(uint64_t), stream);
+        cuRes            = cuMemcpyHtoDAsync(m_devMiscompareCount, &zeroVal, sizeof(uint64_t), m_stream);
         if (CUDA_SUCCESS != cuRes)
         {
             return LogCudaFail("Failed to clear m_devMiscompareCount", "cuMemsetD32Async", cuRes);
@@ -324,15 +344,15 @@ nvvsPluginResult_t L1TagCuda::RunTest(void)
 
         // Run the init data buffer kernel
         void *paramPtrs[] = { &m_kernelParams };
-        cuRes             = cuLaunchKernel(initL1DataFunc,
-                               numBlocks,  // gridDimX
-                               1,          // gridDimY
-                               1,          // gridDimZ
-                               numThreads, // blockDimX
-                               1,          // blockDimY
-                               1,          // blockDimZ
-                               0,          // sharedMemSize
-                               stream,
+        cuRes             = cuLaunchKernel(m_initL1DataFunc,
+                               m_numBlocks,  // gridDimX
+                               1,            // gridDimY
+                               1,            // gridDimZ
+                               m_numThreads, // blockDimX
+                               1,            // blockDimY
+                               1,            // blockDimZ
+                               0,            // sharedMemSize
+                               m_stream,
                                paramPtrs,
                                NULL);
         if (CUDA_SUCCESS != cuRes)
@@ -341,21 +361,21 @@ nvvsPluginResult_t L1TagCuda::RunTest(void)
         }
 
         // The run the test kernel, recording elaspsed time with events
-        cuRes = cuEventRecord(startEvent, stream);
+        cuRes = cuEventRecord(m_startEvent, m_stream);
         if (CUDA_SUCCESS != cuRes)
         {
             return LogCudaFail("Failed to record start event", "cuEventRecord", cuRes);
         }
 
-        cuRes = cuLaunchKernel(testRunDataFunc,
-                               numBlocks,  // gridDimX
-                               1,          // gridDimY
-                               1,          // gridDimZ
-                               numThreads, // blockDimX
-                               1,          // blockDimY
-                               1,          // blockDimZ
-                               0,          // sharedMemSize
-                               stream,
+        cuRes = cuLaunchKernel(m_testRunDataFunc,
+                               m_numBlocks,  // gridDimX
+                               1,            // gridDimY
+                               1,            // gridDimZ
+                               m_numThreads, // blockDimX
+                               1,            // blockDimY
+                               1,            // blockDimZ
+                               0,            // sharedMemSize
+                               m_stream,
                                paramPtrs,
                                NULL);
         if (CUDA_SUCCESS != cuRes)
@@ -364,28 +384,28 @@ nvvsPluginResult_t L1TagCuda::RunTest(void)
         }
         kernLaunchCount++;
 
-        cuRes = cuEventRecord(stopEvent, stream);
+        cuRes = cuEventRecord(m_stopEvent, m_stream);
         if (CUDA_SUCCESS != cuRes)
         {
             return LogCudaFail("Failed to record stop event", "cuEventRecord", cuRes);
         }
 
         // Get error count
-        cuRes = cuMemcpyDtoHAsync(&hostMiscompareCount, m_devMiscompareCount, sizeof(uint64_t), stream);
+        cuRes = cuMemcpyDtoHAsync(&hostMiscompareCount, m_devMiscompareCount, sizeof(uint64_t), m_stream);
         if (CUDA_SUCCESS != cuRes)
         {
             return LogCudaFail("Failed to schedule miscompareCount copy", "cuMemcpyDtoHAsync", cuRes);
         }
 
         // Synchronize and get time for kernel completion
-        cuRes = cuStreamSynchronize(stream);
+        cuRes = cuStreamSynchronize(m_stream);
         if (CUDA_SUCCESS != cuRes)
         {
             return LogCudaFail("Failed to synchronize", "cuStreamSynchronize", cuRes);
         }
 
         float elapsedMs;
-        cuRes = cuEventElapsedTime(&elapsedMs, startEvent, stopEvent);
+        cuRes = cuEventElapsedTime(&elapsedMs, m_startEvent, m_stopEvent);
         if (CUDA_SUCCESS != cuRes)
         {
             return LogCudaFail("Failed elapsed time calculation", "cuEventElapsedTime", cuRes);
@@ -477,15 +497,11 @@ nvvsPluginResult_t L1TagCuda::TestMain(unsigned int dcgmGpuIndex)
 {
     nvvsPluginResult_t result;
 
-    m_gpuIndex = dcgmGpuIndex;
-
-    m_runtimeMs       = 1000 * (uint32_t)m_testParameters->GetDouble(MEMORY_L1TAG_STR_TEST_DURATION);
-    m_testLoops       = (uint64_t)m_testParameters->GetDouble(MEMORY_L1TAG_STR_TEST_LOOPS);
-    m_innerIterations = (uint64_t)m_testParameters->GetDouble(MEMORY_L1TAG_STR_INNER_ITERATIONS);
-    m_errorLogLen     = (uint32_t)m_testParameters->GetDouble(MEMORY_L1TAG_STR_ERROR_LOG_LEN);
-    m_dumpMiscompares = m_testParameters->GetBoolFromString(MEMORY_L1TAG_STR_DUMP_MISCOMPARES);
-
-    result = RunTest();
+    result = Setup(dcgmGpuIndex);
+    if (result == NVVS_RESULT_PASS)
+    {
+        result = RunTest();
+    }
 
     Cleanup();
 
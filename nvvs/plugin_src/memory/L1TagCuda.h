@@ -79,16 +79,42 @@ public:
         , m_innerIterations(0)
         , m_errorLogLen(0)
         , m_dumpMiscompares(false)
+        , m_numBlocks(0)
+        , m_numThreads(0)
+        , m_initL1DataFunc(NULL)
+        , m_testRunDataFunc(NULL)
+        , m_startEvent(NULL)
+        , m_stopEvent(NULL)
+        , m_stream(NULL)
     {
         memset(&m_kernelParams, 0, sizeof(m_kernelParams));
     }
 
+    ~L1TagCuda()
+    {
+        Cleanup();
+    }
+
+    /* Setup() and RunTest() one after the other */
     nvvsPluginResult_t TestMain(unsigned int dcgmGpuIndex);
 
+    /*
+     * Load the kernels and allocate the test's buffers, events and stream in
+     * the GPU's context, which must be current.
+     *
+     * Returns NVVS_RESULT_PASS if RunTest() can be called
+     */
+    nvvsPluginResult_t Setup(unsigned int dcgmGpuIndex);
+
+    /*
+     * Run the test on the stream made by Setup(). Makes the GPU's context
+     * current, so it can run on its own thread while other GPUs run theirs
+     * and while the memory test runs on the same GPU.
+     */
+    nvvsPluginResult_t RunTest(void);
+
 private:
-    int Setup(void);
     void Cleanup(void);
-    nvvsPluginResult_t RunTest(void);
 
     int AllocDeviceMem(int size, CUdeviceptr *ptr);
     int AllocHostMem(int size, void **ptr);
@@ -122,6 +148,15 @@ private:
     bool m_dumpMiscompares;
 
     L1TagParams m_kernelParams;
+
+    // Set by Setup()
+    uint32_t m_numBlocks;
+    uint32_t m_numThreads;
+    CUfunction m_initL1DataFunc;
+    CUfunction m_testRunDataFunc;
+    CUevent m_startEvent;
+    CUevent m_stopEvent;
+    CUstream m_stream;
 };
 
 #endif
@@ -25,6 +25,9 @@ dcgmReturn_t GetPluginInfo(unsigned int pluginInterfaceVersion, dcgmDiagPluginIn
     // TODO: Add a version check
     // parameterNames must be null terminated
     const char *parameterNames[] = { MEMORY_STR_IS_ALLOWED,
+                                     MEMORY_STR_PIPELINED,
+                                     MEMORY_STR_NUM_STREAMS,
+                                     MEMORY_STR_CHUNK_SIZE_MB,
                                      MEMORY_L1TAG_STR_IS_ALLOWED,
                                      MEMORY_L1TAG_STR_TEST_DURATION,
                                      MEMORY_L1TAG_STR_TEST_LOOPS,
@@ -32,11 +35,14 @@ dcgmReturn_t GetPluginInfo(unsigned int pluginInterfaceVersion, dcgmDiagPluginIn
                                      MEMORY_L1TAG_STR_ERROR_LOG_LEN,
                                      MEMORY_L1TAG_STR_DUMP_MISCOMPARES,
                                      MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM,
+                                     MEMORY_L1TAG_STR_CONCURRENT,
                                      nullptr };
 
     const dcgmPluginValue_t paramTypes[]
-        = { DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamInt, DcgmPluginParamInt, DcgmPluginParamInt,
-            DcgmPluginParamInt,  DcgmPluginParamBool, DcgmPluginParamInt, DcgmPluginParamNone };
+        = { DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamInt, DcgmPluginParamInt,
+            DcgmPluginParamBool, DcgmPluginParamInt,  DcgmPluginParamInt, DcgmPluginParamInt,
+            DcgmPluginParamInt,  DcgmPluginParamBool, DcgmPluginParamInt, DcgmPluginParamBool,
+            DcgmPluginParamNone };
     DCGM_CASSERT(sizeof(parameterNames) / sizeof(const char *) == sizeof(paramTypes) / sizeof(const dcgmPluginValue_t),
                  1);
 
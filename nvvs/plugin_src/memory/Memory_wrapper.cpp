@@ -32,6 +32,9 @@ Memory::Memory(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuInfo)
     TestParameters *tp = new TestParameters();
     tp->AddString(PS_RUN_IF_GOM_ENABLED, "True");
     tp->AddString(MEMORY_STR_IS_ALLOWED, "False");
+    tp->AddString(MEMORY_STR_PIPELINED, "False");
+    tp->AddDouble(MEMORY_STR_NUM_STREAMS, 4.0, 1.0, 32.0);
+    tp->AddDouble(MEMORY_STR_CHUNK_SIZE_MB, 256.0, 1.0, 16384.0);
     tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "False");
     tp->AddDouble(MEMORY_L1TAG_STR_TEST_DURATION, 1.0, 0.0, 10800.0);
     tp->AddDouble(MEMORY_L1TAG_STR_TEST_LOOPS, 0, 0, 1000000);
@@ -39,6 +42,7 @@ Memory::Memory(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuInfo)
     tp->AddDouble(MEMORY_L1TAG_STR_ERROR_LOG_LEN, 8192, 8192, 32768);
     tp->AddString(MEMORY_L1TAG_STR_DUMP_MISCOMPARES, "True");
     tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 0.0, 0.0, 1024.0);
+    tp->AddString(MEMORY_L1TAG_STR_CONCURRENT, "False");
     tp->AddString(PS_LOGFILE, "stats_memory.json");
     tp->AddDouble(PS_LOGFILE_TYPE, 0.0, NVVS_LOGFILE_TYPE_JSON, NVVS_LOGFILE_TYPE_BINARY);
     m_infoStruct.defaultTestParameters = tp;
@@ -99,6 +103,12 @@ void Memory::Go(unsigned int numParameters, const dcgmDiagPluginTestParameter_t
         return;
     }
 
+    if (testParameters.GetBoolFromString(MEMORY_L1TAG_STR_CONCURRENT))
+    {
+        main_entry_concurrent(m_gpuInfo, this, &testParameters);
+        return;
+    }
+
     for (unsigned int i = 0; i < m_gpuInfo.numGpus; i++)
     {
         main_entry(m_gpuInfo.gpus[i], this, &testParameters);
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "CudaCommon.h"
+#include "CudaResources.h"
 #include "Plugin.h"
 #include "PluginCommon.h"
 #include "TestParameters.h"
@@ -19,9 +19,13 @@
 #include "timelib.h"
 #include <CudaCommon.h>
 #include <PluginCommon.h>
+#include <algorithm>
 #include <assert.h>
 #include <cuda.h>
+#include <memory>
 #include <string.h>
+#include <thread>
+#include <vector>
 
 #define PCIE_ONE_BW   250.0f  /* PCIe 1.0 - 250 MB/s per lane */
 #define PCIE_TWO_BW   500.0f  /* PCIe 2.x - 500 MB/s per lane */
@@ -72,6 +76,162 @@ typedef enum testResult
     TEST_RESULT_COUNT,
 } testResult_t;
 
+/*****************************************************************************/
+// Writes and verifies every pattern chunk by chunk, with the chunks spread over several streams so that the
+// kernels of one chunk run while the host checks the result of another. A chunk always runs on the same stream,
+// so its patterns are written and checked in order.
+// Sets memoryMismatchOccurred and returns as soon as a stream reports a mismatch
+static CUresult runPipelinedPatterns(mem_globals_p memGlobals,
+                                     CUdevice cuDevice,
+                                     CUfunction memsetval,
+                                     CUfunction memcheckval,
+                                     CUdeviceptr errors,
+                                     CUdeviceptr alloc,
+                                     size_t size,
+                                     const char *testVals,
+                                     size_t numTestVals,
+                                     unsigned int &memoryMismatchOccurred)
+{
+    unsigned int numStreams = (unsigned int)memGlobals->testParameters->GetDouble(MEMORY_STR_NUM_STREAMS);
+    size_t chunkSize        = (size_t)memGlobals->testParameters->GetDouble(MEMORY_STR_CHUNK_SIZE_MB) << 20;
+    size_t numChunks        = (size + chunkSize - 1) / chunkSize;
+    std::vector<CUstream> streams(numStreams, nullptr);
+    std::vector<CUevent> done(numStreams, nullptr);
+    std::vector<bool> pending(numStreams, false);
+    unsigned int *errorsHost = nullptr; /* One pinned flag per stream, copied after each chunk's check */
+    int numSms               = 0;
+    CUresult cuRes;
+
+    cuRes = cuDeviceGetAttribute(&numSms, CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT, cuDevice);
+    if (CUDA_SUCCESS != cuRes)
+        return cuRes;
+
+    // Enough blocks to keep every SM busy with one chunk, since each stream's kernels share the GPU
+    dim3 blockDim = { 256, 1, 1 };
+    dim3 gridDim  = { (unsigned int)std::max(1, 4 * numSms / (int)numStreams), 1, 1 };
+
+    cuRes = cuMemAllocHost((void **)&errorsHost, numStreams * sizeof(unsigned int));
+    if (CUDA_SUCCESS != cuRes)
+        return cuRes;
+
+    for (unsigned int i = 0; i < numStreams && CUDA_SUCCESS == cuRes; i++)
+    {
+        errorsHost[i] = 0;
+        cuRes         = cuStreamCreate(&streams[i], CU_STREAM_NON_BLOCKING);
+        if (CUDA_SUCCESS == cuRes)
+        {
+            cuRes = cuEventCreate(&done[i], CU_EVENT_DEFAULT);
+        }
+    }
+
+    timelib64_t start = timelib_usecSince1970();
+
+    for (size_t j = 0; j < numTestVals && CUDA_SUCCESS == cuRes && !memoryMismatchOccurred; ++j)
+    {
+        for (size_t c = 0; c < numChunks && CUDA_SUCCESS == cuRes && !main_should_stop; ++c)
+        {
+            unsigned int st = c % numStreams;
+            void *ptr       = (void *)(alloc + c * chunkSize);
+            size_t len      = std::min(chunkSize, size - c * chunkSize);
+            char val        = testVals[j];
+            void *params[3] = { &ptr, &len, &val };
+
+            if (pending[st])
+            {
+                // Check the stream's previous chunk while the other streams keep the GPU busy
+                cuRes = cuEventSynchronize(done[st]);
+                if (CUDA_SUCCESS != cuRes)
+                    break;
+                if (errorsHost[st])
+                {
+                    memoryMismatchOccurred = 1;
+                    break;
+                }
+            }
+
+            cuRes = cuLaunchKernel(memsetval,
+                                   gridDim.x,
+                                   gridDim.y,
+                                   gridDim.z,
+                                   blockDim.x,
+                                   blockDim.y,
+                                   blockDim.z,
+                                   0,
+                                   streams[st],
+                                   params,
+                                   0);
+            if (CUDA_SUCCESS == cuRes)
+            {
+                cuRes = cuLaunchKernel(memcheckval,
+                                       gridDim.x,
+                                       gridDim.y,
+                                       gridDim.z,
+                                       blockDim.x,
+                                       blockDim.y,
+                                       blockDim.z,
+                                       0,
+                                       streams[st],
+                                       params,
+                                       0);
+            }
+            if (CUDA_SUCCESS == cuRes)
+            {
+                cuRes = cuMemcpyDtoHAsync(&errorsHost[st], errors, sizeof(unsigned int), streams[st]);
+            }
+            if (CUDA_SUCCESS == cuRes)
+            {
+                cuRes = cuEventRecord(done[st], streams[st]);
+            }
+            pending[st] = true;
+        }
+    }
+
+    // Drain the streams and check the chunks that are still in flight
+    for (unsigned int i = 0; i < numStreams; i++)
+    {
+        if (pending[i] && CUDA_SUCCESS == cuRes)
+        {
+            cuRes = cuEventSynchronize(done[i]);
+            if (CUDA_SUCCESS == cuRes && errorsHost[i])
+            {
+                memoryMismatchOccurred = 1;
+            }
+        }
+    }
+
+    if (CUDA_SUCCESS == cuRes && !memoryMismatchOccurred && !main_should_stop)
+    {
+        // Every pattern is written once and read once
+        double seconds = (timelib_usecSince1970() - start) / 1000000.0;
+        double gb      = 2.0 * size * numTestVals / 1e9;
+        if (seconds > 0.0)
+        {
+            memGlobals->memory->SetGpuStat(memGlobals->dcgmGpuIndex, "pipelined_bandwidth_gbps", gb / seconds);
+
+            std::stringstream ss;
+            ss.setf(std::ios::fixed, std::ios::floatfield);
+            ss.precision(1);
+            ss << "Tested " << numChunks << " chunks on " << numStreams << " streams at " << gb / seconds << " GB/s";
+            memGlobals->memory->AddInfoVerboseForGpu(memGlobals->dcgmGpuIndex, ss.str());
+        }
+    }
+
+    for (unsigned int i = 0; i < numStreams; i++)
+    {
+        if (done[i] != nullptr)
+        {
+            cuEventDestroy(done[i]);
+        }
+        if (streams[i] != nullptr)
+        {
+            cuStreamDestroy(streams[i]);
+        }
+    }
+    cuMemFreeHost(errorsHost);
+
+    return cuRes;
+}
+
 static nvvsPluginResult_t runTestDeviceMemory(mem_globals_p memGlobals, CUdevice cuDevice, CUcontext /*ctx*/)
 {
     int attr;
@@ -79,7 +239,7 @@ static nvvsPluginResult_t runTestDeviceMemory(mem_globals_p memGlobals, CUdevice
     size_t total, free;
     size_t size;
     CUdeviceptr alloc, errors;
-    CUmodule mod;
+    CUmodule mod = NULL;
     CUfunction memsetval, memcheckval;
     CUresult cuRes;
     void *ptr;
@@ -115,25 +275,20 @@ static nvvsPluginResult_t runTestDeviceMemory(mem_globals_p memGlobals, CUdevice
     if (CUDA_SUCCESS != cuRes)
         goto error_no_cleanup;
 
-    cuRes = cuMemGetInfo(&free, &total);
+    cuRes = CudaResources::Instance().GetFreeMemory(cuDevice, free, total);
     if (CUDA_SUCCESS != cuRes)
         goto error_no_cleanup;
 
-    // alloc as much memory as possible
-    size = free;
-    do
+    // alloc as much memory as possible. The pool keeps it for the plugins that run after this one
+    cuRes = CudaResources::Instance().AllocateLargest(cuDevice, (size_t)(total * minMemoryTest), alloc, size);
+    if (CUDA_ERROR_OUT_OF_MEMORY == cuRes)
     {
-        size = (size / 100) * 99;
-        if (size < (total * minMemoryTest))
-        {
-            DcgmError d { memGlobals->dcgmGpuIndex };
-            DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_MEMORY_ALLOC, d, minMemoryTest * 100, memGlobals->dcgmGpuIndex);
-            memGlobals->memory->AddErrorForGpu(memGlobals->dcgmGpuIndex, d);
-            PRINT_ERROR("%s", "%s", d.GetMessage().c_str());
-            goto error_no_cleanup;
-        }
-        cuRes = cuMemAlloc(&alloc, size);
-    } while (CUDA_ERROR_OUT_OF_MEMORY == cuRes);
+        DcgmError d { memGlobals->dcgmGpuIndex };
+        DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_MEMORY_ALLOC, d, minMemoryTest * 100, memGlobals->dcgmGpuIndex);
+        memGlobals->memory->AddErrorForGpu(memGlobals->dcgmGpuIndex, d);
+        PRINT_ERROR("%s", "%s", d.GetMessage().c_str());
+        goto error_no_cleanup;
+    }
 
 
     if (CUDA_SUCCESS != cuRes)
@@ -158,6 +313,21 @@ static nvvsPluginResult_t runTestDeviceMemory(mem_globals_p memGlobals, CUdevice
     //    memGlobals->memory->AddInfoVerbose(os.str());
     //    PRINT_INFO("%zu %.1f", "Allocated %zu bytes (%.1f%%)", size, (float) (size * 100.0f / total));
 
+    if (memGlobals->testParameters->GetBoolFromString(MEMORY_STR_PIPELINED))
+    {
+        cuRes = runPipelinedPatterns(memGlobals,
+                                     cuDevice,
+                                     memsetval,
+                                     memcheckval,
+                                     errors,
+                                     alloc,
+                                     size,
+                                     testVals,
+                                     NUMELMS(testVals),
+                                     memoryMismatchOccurred);
+        goto cleanup;
+    }
+
     {
         dim3 blockDim   = { 256, 1, 1 };
         dim3 gridDim    = { 128, 1, 1 };
@@ -216,7 +386,7 @@ static nvvsPluginResult_t runTestDeviceMemory(mem_globals_p memGlobals, CUdevice
 
 cleanup:
     // Release resources
-    if (CUDA_ERROR_ECC_UNCORRECTABLE == cuMemFree(alloc))
+    if (CUDA_ERROR_ECC_UNCORRECTABLE == cuCtxSynchronize())
     {
         //
         // Ignore other errors, outside the scope of the memory test
@@ -224,8 +394,14 @@ cleanup:
         //
         cuRes = CUDA_ERROR_ECC_UNCORRECTABLE;
     }
+    CudaResources::Instance().Free(cuDevice, alloc);
 
 error_no_cleanup:
+    if (mod != NULL)
+    {
+        cuModuleUnload(mod);
+    }
+
     //
     // Remember, many CUDA calls may return errors from previous async launches
     // Check the last CUDA call's return code
@@ -324,24 +500,12 @@ testResult_t testUtilGetCuDevice(const dcgmDiagPluginGpuInfo_t &gpuInfo, CUdevic
 /*****************************************************************************/
 void mem_cleanup(mem_globals_p memGlobals)
 {
-    CUresult cuRes;
-
     if (memGlobals->m_dcgmRecorder)
     {
         delete (memGlobals->m_dcgmRecorder);
         memGlobals->m_dcgmRecorder = 0;
     }
 
-    if (memGlobals->cuCtxCreated)
-    {
-        cuRes = cuCtxDestroy(memGlobals->cuCtx);
-        if (CUDA_SUCCESS != cuRes)
-        {
-            LOG_CUDA_ERROR_FOR_PLUGIN(memGlobals->memory, "cuCtxDestroy", cuRes, memGlobals->dcgmGpuIndex);
-        }
-    }
-    memGlobals->cuCtxCreated = 0;
-
     if (memGlobals->nvvsDevice)
     {
         memGlobals->nvvsDevice->RestoreState();
@@ -399,35 +563,30 @@ int mem_init(mem_globals_p memGlobals, const dcgmDiagPluginGpuInfo_t &gpuInfo)
         return 1;
     }
 
-    cuRes = cuCtxCreate(&memGlobals->cuCtx, 0, memGlobals->cuDevice);
+    cuRes = CudaResources::Instance().GetContext(memGlobals->cuDevice, memGlobals->cuCtx);
     if (CUDA_SUCCESS != cuRes)
     {
         std::string error = AppendCudaDriverError("Unable to create CUDA context", cuRes);
         DcgmError d { memGlobals->dcgmGpuIndex };
-        DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_CUDA_API, d, "cuCtxCreate");
+        DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_CUDA_API, d, "cuDevicePrimaryCtxRetain");
         d.AddDetail(error);
         memGlobals->memory->AddErrorForGpu(memGlobals->dcgmGpuIndex, d);
         return 1;
     }
-    memGlobals->cuCtxCreated = 1;
-
     return 0;
 }
 
 /*****************************************************************************/
-int main_entry(const dcgmDiagPluginGpuInfo_t &gpuInfo, Memory *memory, TestParameters *tp)
+// Watches the GPU, initializes CUDA for it and checks that ECC is enabled. memGlobals->memory and
+// memGlobals->testParameters must be set.
+// Returns NVVS_RESULT_PASS if the GPU can be tested. Otherwise the reason has been added to the plugin
+static nvvsPluginResult_t mem_setup(mem_globals_p memGlobals, const dcgmDiagPluginGpuInfo_t &gpuInfo)
 {
-    nvvsPluginResult_t result;
     int st;
 
-    unsigned int gpuId       = gpuInfo.gpuId;
-    mem_globals_p memGlobals = &g_memGlobals;
-
-    memset(memGlobals, 0, sizeof(*memGlobals));
-    memGlobals->memory         = memory;
-    memGlobals->testParameters = tp;
+    unsigned int gpuId = gpuInfo.gpuId;
 
-    memGlobals->m_dcgmRecorder = new DcgmRecorder(memory->GetHandle());
+    memGlobals->m_dcgmRecorder = new DcgmRecorder(memGlobals->memory->GetHandle());
 
     char fieldGroupName[128];
     char groupName[128];
@@ -446,9 +605,7 @@ int main_entry(const dcgmDiagPluginGpuInfo_t &gpuInfo, Memory *memory, TestParam
     st = mem_init(memGlobals, gpuInfo);
     if (st)
     {
-        memGlobals->memory->SetResult(NVVS_RESULT_FAIL);
-        mem_cleanup(memGlobals);
-        return 1;
+        return NVVS_RESULT_FAIL;
     }
 
     // check if this card supports ECC and be good about skipping/warning etc.
@@ -464,18 +621,14 @@ int main_entry(const dcgmDiagPluginGpuInfo_t &gpuInfo, Memory *memory, TestParam
         d.AddDcgmError(ret);
         PRINT_ERROR("%s", "%s", d.GetMessage().c_str());
         memGlobals->memory->AddError(d);
-        memGlobals->memory->SetResult(NVVS_RESULT_FAIL);
-        mem_cleanup(memGlobals);
-        return 1;
+        return NVVS_RESULT_FAIL;
     }
     else if (eccCurrentVal.status == DCGM_ST_NOT_SUPPORTED)
     {
         DcgmError d { memGlobals->dcgmGpuIndex };
         DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_ECC_UNSUPPORTED, d);
         memGlobals->memory->AddInfo(d.GetMessage());
-        memGlobals->memory->SetResult(NVVS_RESULT_SKIP);
-        mem_cleanup(memGlobals);
-        return 1;
+        return NVVS_RESULT_SKIP;
     }
 
     if (eccCurrentVal.value.i64 == 0)
@@ -484,7 +637,28 @@ int main_entry(const dcgmDiagPluginGpuInfo_t &gpuInfo, Memory *memory, TestParam
         DcgmError d { memGlobals->dcgmGpuIndex };
         DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_ECC_DISABLED, d, "Memory", gpuId);
         memGlobals->memory->AddInfo(d.GetMessage());
-        memGlobals->memory->SetResult(NVVS_RESULT_SKIP);
+        return NVVS_RESULT_SKIP;
+    }
+
+    return NVVS_RESULT_PASS;
+}
+
+/*****************************************************************************/
+int main_entry(const dcgmDiagPluginGpuInfo_t &gpuInfo, Memory *memory, TestParameters *tp)
+{
+    nvvsPluginResult_t result;
+
+    unsigned int gpuId       = gpuInfo.gpuId;
+    mem_globals_p memGlobals = &g_memGlobals;
+
+    memset(memGlobals, 0, sizeof(*memGlobals));
+    memGlobals->memory         = memory;
+    memGlobals->testParameters = tp;
+
+    result = mem_setup(memGlobals, gpuInfo);
+    if (result != NVVS_RESULT_PASS)
+    {
+        memGlobals->memory->SetResult(result);
         mem_cleanup(memGlobals);
         return 1;
     }
@@ -539,3 +713,92 @@ int main_entry(const dcgmDiagPluginGpuInfo_t &gpuInfo, Memory *memory, TestParam
     mem_cleanup(memGlobals);
     return 0;
 }
+
+/*****************************************************************************/
+int main_entry_concurrent(const dcgmDiagPluginGpuList_t &gpuList, Memory *memory, TestParameters *tp)
+{
+    unsigned int numGpus = gpuList.numGpus;
+    bool runL1Tag        = tp->GetBoolFromString(MEMORY_L1TAG_STR_IS_ALLOWED);
+    std::vector<mem_globals_t> memGlobals(numGpus);
+    std::vector<std::unique_ptr<L1TagCuda>> l1Tags(numGpus);
+    std::vector<nvvsPluginResult_t> results(numGpus, NVVS_RESULT_SKIP);
+    std::vector<nvvsPluginResult_t> l1TagResults(numGpus, NVVS_RESULT_SKIP);
+    std::vector<std::thread> threads;
+    int ret = 0;
+
+    // Set the GPUs up one at a time. Each L1 tag subtest allocates its buffers before the memory test takes
+    // all the memory that is left
+    for (unsigned int i = 0; i < numGpus; i++)
+    {
+        memGlobals[i].memory         = memory;
+        memGlobals[i].testParameters = tp;
+
+        results[i] = mem_setup(&memGlobals[i], gpuList.gpus[i]);
+        if (results[i] == NVVS_RESULT_PASS && runL1Tag)
+        {
+            l1Tags[i]       = std::make_unique<L1TagCuda>(memory, tp, &memGlobals[i]);
+            l1TagResults[i] = l1Tags[i]->Setup(gpuList.gpus[i].gpuId);
+        }
+    }
+
+    // Each thread only writes the results of its own GPU
+    auto runMemoryTest = [&memGlobals, &results](unsigned int i) {
+        mem_globals_p gpuGlobals = &memGlobals[i];
+        try
+        {
+            cuCtxSetCurrent(gpuGlobals->cuCtx);
+            results[i] = runTestDeviceMemory(gpuGlobals, gpuGlobals->cuDevice, gpuGlobals->cuCtx);
+        }
+        catch (std::runtime_error &e)
+        {
+            PRINT_ERROR("%s", "Caught runtime_error %s", e.what());
+            DcgmError d { gpuGlobals->dcgmGpuIndex };
+            DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_INTERNAL, d, e.what());
+            gpuGlobals->memory->AddError(d);
+            results[i] = NVVS_RESULT_FAIL;
+        }
+    };
+
+    for (unsigned int i = 0; i < numGpus; i++)
+    {
+        if (results[i] != NVVS_RESULT_PASS)
+        {
+            continue;
+        }
+
+        threads.emplace_back(runMemoryTest, i);
+        if (l1Tags[i] != nullptr && l1TagResults[i] == NVVS_RESULT_PASS)
+        {
+            threads.emplace_back([&l1Tags, &l1TagResults, i]() { l1TagResults[i] = l1Tags[i]->RunTest(); });
+        }
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    // Same outcome per GPU as main_entry()
+    for (unsigned int i = 0; i < numGpus; i++)
+    {
+        nvvsPluginResult_t result = results[i];
+        if (l1Tags[i] != nullptr && result != NVVS_RESULT_SKIP)
+        {
+            result = combine_results(result, l1TagResults[i]);
+        }
+        if (result == NVVS_RESULT_PASS && main_should_stop)
+        {
+            result = NVVS_RESULT_SKIP;
+        }
+        if (result != NVVS_RESULT_PASS)
+        {
+            ret = 1;
+        }
+
+        memory->SetResultForGpu(gpuList.gpus[i].gpuId, result);
+        l1Tags[i].reset();
+        mem_cleanup(&memGlobals[i]);
+    }
+
+    return ret;
+}
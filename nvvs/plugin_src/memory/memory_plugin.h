@@ -51,8 +51,7 @@ typedef struct mem_globals_t
     unsigned int dcgmGpuIndex; /* DCGM gpu index for the GPU */
     CUdevice cuDevice;         /* Cuda device handle to dispatch work to */
 
-    CUcontext cuCtx;  /* Cuda context to dispatch work to */
-    int cuCtxCreated; /* Does cuCtx need to be freed? */
+    CUcontext cuCtx; /* Cuda context to dispatch work to */
 
     NvvsDevice *nvvsDevice; /* NVVS device object for controlling/querying this device */
 
@@ -63,6 +62,16 @@ typedef struct mem_globals_t
 /*****************************************************************************/
 int main_entry(const dcgmDiagPluginGpuInfo_t &gpu, Memory *memObj, TestParameters *testParameters);
 
+/*****************************************************************************/
+/*
+ * Test every GPU of gpuList at once, setting the result of each GPU. Each GPU's
+ * memory test and L1 tag subtest run on threads of their own, so the L1 tag
+ * subtest runs on its stream while the memory test runs.
+ *
+ * Returns 0 if every GPU passed
+ */
+int main_entry_concurrent(const dcgmDiagPluginGpuList_t &gpuList, Memory *memObj, TestParameters *testParameters);
+
 /*****************************************************************************/
 
 #endif // MEMORY_H
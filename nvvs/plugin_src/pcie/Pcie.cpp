@@ -41,6 +41,7 @@ BusGrind::BusGrind(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuInfo)
     tp->AddString(PCIE_STR_TEST_UNPINNED, "True");
     tp->AddString(PCIE_STR_TEST_P2P_ON, "True");
     tp->AddString(PCIE_STR_TEST_P2P_OFF, "True");
+    tp->AddString(PCIE_STR_TEST_PER_SWITCH, "False");
     tp->AddString(PS_LOGFILE, "stats_pcie.json");
     tp->AddDouble(PS_LOGFILE_TYPE, 0.0, NVVS_LOGFILE_TYPE_JSON, NVVS_LOGFILE_TYPE_BINARY);
 
@@ -146,6 +147,15 @@ BusGrind::BusGrind(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuInfo)
     tp->AddSubTestDouble(
         PCIE_SUBTEST_P2P_LATENCY_P2P_DISABLED, PCIE_STR_ITERATIONS, 5000.0, minLatIterations, maxLatIterations);
 
+    tp->AddSubTestDouble(
+        PCIE_SUBTEST_P2P_BW_ALL_PAIRS, PCIE_STR_INTS_PER_COPY, 10000000.0, minBwIntsPerCopy, maxBwIntsPerCopy);
+    tp->AddSubTestDouble(PCIE_SUBTEST_P2P_BW_ALL_PAIRS, PCIE_STR_ITERATIONS, 50.0, minBwIterations, maxBwIterations);
+
+    tp->AddSubTestDouble(
+        PCIE_SUBTEST_P2P_LATENCY_PERCENTILES, PCIE_STR_INTS_PER_COPY, 1.0, minBwIntsPerCopy, maxBwIntsPerCopy);
+    tp->AddSubTestDouble(
+        PCIE_SUBTEST_P2P_LATENCY_PERCENTILES, PCIE_STR_ITERATIONS, 1000.0, minLatIterations, maxLatIterations);
+
 
     m_infoStruct.defaultTestParameters = tp;
 
@@ -16,13 +16,20 @@
 
 #include "PcieMain.h"
 #include "CudaCommon.h"
+#include "CudaResources.h"
 #include "PluginCommon.h"
 #include "cuda.h"
 #include "cuda_runtime.h"
+#include "p2p_copy_ptx_string.h"
 #include "timelib.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <errno.h>
+#include <map>
 #include <omp.h>
+#include <pthread.h>
 #include <sstream>
 #include <unistd.h>
 #include <vector>
@@ -512,7 +519,39 @@ int outputHostDeviceBandwidthMatrix(BusGrindGlobals *bgGlobals, bool pinned)
 }
 
 /*****************************************************************************/
-// this test measures the bus bandwidth between the host and each GPU concurrently
+// binds the calling thread to the CPUs local to a GPU so that the host memory it touches next is allocated
+// on the GPU's NUMA node
+// inputs:
+//        size_t gpuIdx:      Index of the GPU in bgGlobals->gpu
+//        cpu_set_t &oldCpus: Set to the CPUs the thread was bound to before
+// returns true if the thread was bound, false if it was left as it was
+bool bg_bind_to_local_cpus(BusGrindGlobals *bgGlobals, size_t gpuIdx, cpu_set_t &oldCpus)
+{
+    if (gpuIdx >= bgGlobals->localCpus.size() || CPU_COUNT(&bgGlobals->localCpus[gpuIdx]) == 0)
+    {
+        return false;
+    }
+
+    if (pthread_getaffinity_np(pthread_self(), sizeof(oldCpus), &oldCpus) != 0)
+    {
+        return false;
+    }
+
+    int st = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &bgGlobals->localCpus[gpuIdx]);
+    if (st != 0)
+    {
+        DCGM_LOG_DEBUG << "Cannot bind to the CPUs local to GPU " << bgGlobals->gpu[gpuIdx]->gpuId << ": "
+                       << strerror(st);
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+// this test measures the bus bandwidth between the host and each GPU concurrently. With test_per_switch, the
+// GPUs behind each PCIe switch are measured together, one switch after the other. Host buffers are allocated
+// on the NUMA node of their GPU.
 // inputs:
 //        int numGPUs:  The number of GPUs to test
 //        bool pinned:   Indicates if the host memory should be pinned or not
@@ -534,7 +573,28 @@ int outputConcurrentHostDeviceBandwidthMatrix(BusGrindGlobals *bgGlobals, bool p
         stream2[i]   = 0;
     }
 
-    omp_set_num_threads(bgGlobals->gpu.size());
+    /* GPUs in the same batch are measured at the same time */
+    std::vector<std::vector<size_t>> batches;
+    if (bgGlobals->test_per_switch && bgGlobals->pcieSwitchGroup.size() == bgGlobals->gpu.size())
+    {
+        std::map<unsigned int, std::vector<size_t>> switchGpus;
+        for (size_t i = 0; i < bgGlobals->gpu.size(); i++)
+        {
+            switchGpus[bgGlobals->pcieSwitchGroup[i]].push_back(i);
+        }
+        for (auto &entry : switchGpus)
+        {
+            batches.push_back(std::move(entry.second));
+        }
+    }
+    else
+    {
+        batches.emplace_back();
+        for (size_t i = 0; i < bgGlobals->gpu.size(); i++)
+        {
+            batches[0].push_back(i);
+        }
+    }
 
     std::string key;
     std::string groupName;
@@ -551,77 +611,100 @@ int outputConcurrentHostDeviceBandwidthMatrix(BusGrindGlobals *bgGlobals, bool p
     int numElems = (int)bgGlobals->testParameters->GetSubTestDouble(groupName, PCIE_STR_INTS_PER_COPY);
     int repeat   = (int)bgGlobals->testParameters->GetSubTestDouble(groupName, PCIE_STR_ITERATIONS);
 
-    // one thread per GPU
-#pragma omp parallel
+    for (auto const &batch : batches)
     {
-        int d = omp_get_thread_num();
-        cudaSetDevice(bgGlobals->gpu[d]->cudaDeviceIdx);
+        omp_set_num_threads(batch.size());
 
-        if (pinned)
-            cudaMallocHost(&buffers[d], numElems * sizeof(int));
-        else
-            buffers[d] = (int *)malloc(numElems * sizeof(int));
-        cudaCheckErrorOmp(cudaMalloc, (&d_buffers[d], numElems * sizeof(int)), PCIE_ERR_CUDA_ALLOC_FAIL, d);
-        cudaCheckErrorOmp(cudaEventCreate, (&start[d]), PCIE_ERR_CUDA_EVENT_FAIL, d);
-        cudaCheckErrorOmp(cudaEventCreate, (&stop[d]), PCIE_ERR_CUDA_EVENT_FAIL, d);
-        cudaCheckErrorOmp(cudaStreamCreate, (&stream1[d]), PCIE_ERR_CUDA_STREAM_FAIL, d);
-        cudaCheckErrorOmp(cudaStreamCreate, (&stream2[d]), PCIE_ERR_CUDA_STREAM_FAIL, d);
+        // one thread per GPU
+#pragma omp parallel
+        {
+            size_t d = batch[omp_get_thread_num()];
+            cudaSetDevice(bgGlobals->gpu[d]->cudaDeviceIdx);
 
-        cudaDeviceSynchronize();
+            /* Stay on the GPU's CPUs for the copies too, unpinned copies are staged by this thread */
+            cpu_set_t oldCpus;
+            bool bound = bg_bind_to_local_cpus(bgGlobals, d, oldCpus);
+
+            if (pinned)
+            {
+                cudaMallocHost(&buffers[d], numElems * sizeof(int));
+            }
+            else
+            {
+                buffers[d] = (int *)malloc(numElems * sizeof(int));
+                if (buffers[d] != nullptr)
+                {
+                    /* Fault the pages in from this thread so they come from the local node */
+                    memset(buffers[d], 0, numElems * sizeof(int));
+                }
+            }
+            cudaCheckErrorOmp(cudaMalloc, (&d_buffers[d], numElems * sizeof(int)), PCIE_ERR_CUDA_ALLOC_FAIL, d);
+            cudaCheckErrorOmp(cudaEventCreate, (&start[d]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+            cudaCheckErrorOmp(cudaEventCreate, (&stop[d]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+            cudaCheckErrorOmp(cudaStreamCreate, (&stream1[d]), PCIE_ERR_CUDA_STREAM_FAIL, d);
+            cudaCheckErrorOmp(cudaStreamCreate, (&stream2[d]), PCIE_ERR_CUDA_STREAM_FAIL, d);
+
+            cudaDeviceSynchronize();
 
 #pragma omp barrier
-        cudaEventRecord(start[d]);
-        // initiate H2D copies
-        for (int r = 0; r < repeat; r++)
-        {
-            cudaMemcpyAsync(d_buffers[d], buffers[d], sizeof(int) * numElems, cudaMemcpyHostToDevice, stream1[d]);
-        }
-        cudaEventRecord(stop[d]);
-        cudaCheckErrorOmp(cudaDeviceSynchronize, (), PCIE_ERR_CUDA_SYNC_FAIL, d);
+            cudaEventRecord(start[d]);
+            // initiate H2D copies
+            for (int r = 0; r < repeat; r++)
+            {
+                cudaMemcpyAsync(d_buffers[d], buffers[d], sizeof(int) * numElems, cudaMemcpyHostToDevice, stream1[d]);
+            }
+            cudaEventRecord(stop[d]);
+            cudaCheckErrorOmp(cudaDeviceSynchronize, (), PCIE_ERR_CUDA_SYNC_FAIL, d);
 
-        float time_ms;
-        cudaEventElapsedTime(&time_ms, start[d], stop[d]);
-        double time_s = time_ms / 1e3;
-        double gb     = numElems * sizeof(int) * repeat / (double)1e9;
+            float time_ms;
+            cudaEventElapsedTime(&time_ms, start[d], stop[d]);
+            double time_s = time_ms / 1e3;
+            double gb     = numElems * sizeof(int) * repeat / (double)1e9;
 
-        bandwidthMatrix[0 * bgGlobals->gpu.size() + d] = gb / time_s;
+            bandwidthMatrix[0 * bgGlobals->gpu.size() + d] = gb / time_s;
 
-        cudaDeviceSynchronize();
+            cudaDeviceSynchronize();
 #pragma omp barrier
-        cudaEventRecord(start[d]);
-        for (int r = 0; r < repeat; r++)
-        {
-            cudaMemcpyAsync(buffers[d], d_buffers[d], sizeof(int) * numElems, cudaMemcpyDeviceToHost, stream1[d]);
-        }
-        cudaEventRecord(stop[d]);
-        cudaCheckErrorOmp(cudaDeviceSynchronize, (), PCIE_ERR_CUDA_SYNC_FAIL, d);
+            cudaEventRecord(start[d]);
+            for (int r = 0; r < repeat; r++)
+            {
+                cudaMemcpyAsync(buffers[d], d_buffers[d], sizeof(int) * numElems, cudaMemcpyDeviceToHost, stream1[d]);
+            }
+            cudaEventRecord(stop[d]);
+            cudaCheckErrorOmp(cudaDeviceSynchronize, (), PCIE_ERR_CUDA_SYNC_FAIL, d);
 
-        cudaEventElapsedTime(&time_ms, start[d], stop[d]);
-        time_s = time_ms / 1e3;
-        gb     = numElems * sizeof(int) * repeat / (double)1e9;
+            cudaEventElapsedTime(&time_ms, start[d], stop[d]);
+            time_s = time_ms / 1e3;
+            gb     = numElems * sizeof(int) * repeat / (double)1e9;
 
-        bandwidthMatrix[1 * bgGlobals->gpu.size() + d] = gb / time_s;
+            bandwidthMatrix[1 * bgGlobals->gpu.size() + d] = gb / time_s;
 
-        cudaDeviceSynchronize();
+            cudaDeviceSynchronize();
 #pragma omp barrier
-        cudaEventRecord(start[d]);
-        // Bidirectional
-        for (int r = 0; r < repeat; r++)
-        {
-            cudaMemcpyAsync(d_buffers[d], buffers[d], sizeof(int) * numElems, cudaMemcpyHostToDevice, stream1[d]);
-            cudaMemcpyAsync(buffers[d], d_buffers[d], sizeof(int) * numElems, cudaMemcpyDeviceToHost, stream2[d]);
-        }
+            cudaEventRecord(start[d]);
+            // Bidirectional
+            for (int r = 0; r < repeat; r++)
+            {
+                cudaMemcpyAsync(d_buffers[d], buffers[d], sizeof(int) * numElems, cudaMemcpyHostToDevice, stream1[d]);
+                cudaMemcpyAsync(buffers[d], d_buffers[d], sizeof(int) * numElems, cudaMemcpyDeviceToHost, stream2[d]);
+            }
 
-        cudaEventRecord(stop[d]);
-        cudaCheckErrorOmp(cudaDeviceSynchronize, (), PCIE_ERR_CUDA_SYNC_FAIL, d);
+            cudaEventRecord(stop[d]);
+            cudaCheckErrorOmp(cudaDeviceSynchronize, (), PCIE_ERR_CUDA_SYNC_FAIL, d);
 #pragma omp barrier
 
-        cudaEventElapsedTime(&time_ms, start[d], stop[d]);
-        time_s = time_ms / 1e3;
-        gb     = 2.0 * numElems * sizeof(int) * repeat / (double)1e9;
+            cudaEventElapsedTime(&time_ms, start[d], stop[d]);
+            time_s = time_ms / 1e3;
+            gb     = 2.0 * numElems * sizeof(int) * repeat / (double)1e9;
 
-        bandwidthMatrix[2 * bgGlobals->gpu.size() + d] = gb / time_s;
-    } // end omp parallel
+            bandwidthMatrix[2 * bgGlobals->gpu.size() + d] = gb / time_s;
+
+            if (bound)
+            {
+                pthread_setaffinity_np(pthread_self(), sizeof(oldCpus), &oldCpus);
+            }
+        } // end omp parallel
+    }
 
 
     char labels[][20] = { "h2d", "d2h", "bidir" };
@@ -632,9 +715,16 @@ int outputConcurrentHostDeviceBandwidthMatrix(BusGrindGlobals *bgGlobals, bool p
     for (int i = 0; i < 3; i++)
     {
         double sum = 0.0;
+        std::map<unsigned int, double> switchSums;
+        std::map<unsigned int, double> cpuSums;
         for (size_t j = 0; j < bgGlobals->gpu.size(); j++)
         {
             sum += bandwidthMatrix[i * bgGlobals->gpu.size() + j];
+            if (j < bgGlobals->pcieSwitchGroup.size())
+            {
+                switchSums[bgGlobals->pcieSwitchGroup[j]] += bandwidthMatrix[i * bgGlobals->gpu.size() + j];
+                cpuSums[bgGlobals->cpuGroup[j]] += bandwidthMatrix[i * bgGlobals->gpu.size() + j];
+            }
             ss.str("");
             ss << bgGlobals->gpu[j]->gpuId;
             ss << "_";
@@ -656,9 +746,33 @@ int outputConcurrentHostDeviceBandwidthMatrix(BusGrindGlobals *bgGlobals, bool p
             }
         }
 
-        key = "sum_";
-        key += labels[i];
-        bgGlobals->busGrind->SetGroupedStat(groupName, key, sum);
+        /* The sum is only meaningful if all GPUs were measured at the same time */
+        if (batches.size() == 1)
+        {
+            key = "sum_";
+            key += labels[i];
+            bgGlobals->busGrind->SetGroupedStat(groupName, key, sum);
+        }
+
+        /* Groups are named after the id of their first GPU */
+        if (switchSums.size() > 1)
+        {
+            for (auto const &[group, groupSum] : switchSums)
+            {
+                ss.str("");
+                ss << "pcie_switch_" << bgGlobals->gpu[group]->gpuId << "_sum_" << labels[i];
+                bgGlobals->busGrind->SetGroupedStat(groupName, ss.str(), groupSum);
+            }
+        }
+        if (cpuSums.size() > 1)
+        {
+            for (auto const &[group, groupSum] : cpuSums)
+            {
+                ss.str("");
+                ss << "cpu_" << bgGlobals->gpu[group]->gpuId << "_sum_" << labels[i];
+                bgGlobals->busGrind->SetGroupedStat(groupName, ss.str(), groupSum);
+            }
+        }
     }
 
     for (int d = 0; d < bgGlobals->gpu.size(); d++)
@@ -1516,14 +1630,332 @@ int outputP2PLatencyMatrix(BusGrindGlobals *bgGlobals, bool p2p)
     return 0;
 }
 
+/*****************************************************************************/
+// this test has every GPU copy to every other GPU at the same time, with a stream per peer so that all of the
+// copy engines of a GPU are busy. The copies are done once by the copy engines with cudaMemcpyPeerAsync and
+// once by the SMs with a copy kernel writing to the peer's memory, which needs P2P access.
+// The bandwidth of each pair is also reported per NvLink between the two GPUs
+int outputAllPairsP2PBandwidthMatrix(BusGrindGlobals *bgGlobals)
+{
+    size_t numGpus = bgGlobals->gpu.size();
+    std::string groupName(PCIE_SUBTEST_P2P_BW_ALL_PAIRS);
+
+    if (numGpus < 2)
+    {
+        if (!bgGlobals->m_printedConcurrentGpuErrorMessage)
+        {
+            DcgmError d { DcgmError::GpuIdTag::Unknown };
+            DCGM_ERROR_FORMAT_MESSAGE(DCGM_FR_CONCURRENT_GPUS, d);
+            bgGlobals->busGrind->AddInfo(d.GetMessage());
+            bgGlobals->m_printedConcurrentGpuErrorMessage = true;
+        }
+
+        return 0;
+    }
+
+    enableP2P(bgGlobals);
+
+    int numElems = (int)bgGlobals->testParameters->GetSubTestDouble(groupName, PCIE_STR_INTS_PER_COPY);
+    int repeat   = (int)bgGlobals->testParameters->GetSubTestDouble(groupName, PCIE_STR_ITERATIONS);
+    size_t bytes = numElems * sizeof(int);
+
+    /* Every GPU has one buffer to send from and one that all of its peers write to */
+    std::vector<int *> srcBuffers(numGpus, nullptr);
+    std::vector<int *> dstBuffers(numGpus, nullptr);
+    std::vector<CUmodule> modules(numGpus, nullptr);
+    std::vector<CUfunction> copyFuncs(numGpus, nullptr);
+    std::vector<int> copyBlocks(numGpus, 1);
+
+    /* Per pair, indexed by sender * numGpus + receiver */
+    std::vector<cudaStream_t> streams(numGpus * numGpus, nullptr);
+    std::vector<cudaEvent_t> start(numGpus * numGpus, nullptr);
+    std::vector<cudaEvent_t> stop(numGpus * numGpus, nullptr);
+    std::vector<int> canAccessPeer(numGpus * numGpus, 0);
+    std::vector<double> ceBandwidth(numGpus * numGpus, 0.0);
+    std::vector<double> smBandwidth(numGpus * numGpus, 0.0);
+
+    for (size_t d = 0; d < numGpus; d++)
+    {
+        cudaSetDevice(bgGlobals->gpu[d]->cudaDeviceIdx);
+        cudaCheckError(cudaMalloc, (&srcBuffers[d], bytes), PCIE_ERR_CUDA_ALLOC_FAIL, d);
+        cudaCheckError(cudaMalloc, (&dstBuffers[d], bytes), PCIE_ERR_CUDA_ALLOC_FAIL, d);
+
+        for (size_t p = 0; p < numGpus; p++)
+        {
+            if (p == d)
+            {
+                continue;
+            }
+
+            cudaDeviceCanAccessPeer(
+                &canAccessPeer[d * numGpus + p], bgGlobals->gpu[d]->cudaDeviceIdx, bgGlobals->gpu[p]->cudaDeviceIdx);
+            cudaCheckError(cudaStreamCreate, (&streams[d * numGpus + p]), PCIE_ERR_CUDA_STREAM_FAIL, d);
+            cudaCheckError(cudaEventCreate, (&start[d * numGpus + p]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+            cudaCheckError(cudaEventCreate, (&stop[d * numGpus + p]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+        }
+
+        /* A GPU that can't load the copy kernel only does the copy engine half of the test */
+        CUresult cuRes = cuModuleLoadData(&modules[d], p2p_copy_ptx_string);
+        if (cuRes == CUDA_SUCCESS)
+        {
+            cuRes = cuModuleGetFunction(&copyFuncs[d], modules[d], P2PCopy_func_name);
+        }
+        if (cuRes != CUDA_SUCCESS)
+        {
+            LOG_CUDA_ERROR_FOR_PLUGIN(bgGlobals->busGrind, "cuModuleLoadData", cuRes, bgGlobals->gpu[d]->gpuId);
+            copyFuncs[d] = nullptr;
+        }
+
+        /* Split the SMs between the peers so that all of the copy kernels run at once */
+        int numSms = 0;
+        cudaDeviceGetAttribute(&numSms, cudaDevAttrMultiProcessorCount, bgGlobals->gpu[d]->cudaDeviceIdx);
+        copyBlocks[d] = std::max(1, numSms / (int)(numGpus - 1));
+    }
+
+    for (int smCopies = 0; smCopies < 2; smCopies++)
+    {
+        std::vector<double> &bandwidth = smCopies ? smBandwidth : ceBandwidth;
+
+        omp_set_num_threads(numGpus);
+#pragma omp parallel
+        {
+            size_t d = omp_get_thread_num();
+            cudaSetDevice(bgGlobals->gpu[d]->cudaDeviceIdx);
+            cudaDeviceSynchronize();
+
+#pragma omp barrier
+            for (size_t p = 0; p < numGpus; p++)
+            {
+                size_t pair = d * numGpus + p;
+                if (p == d || (smCopies && (!canAccessPeer[pair] || copyFuncs[d] == nullptr)))
+                {
+                    continue;
+                }
+
+                cudaEventRecord(start[pair], streams[pair]);
+                for (int r = 0; r < repeat; r++)
+                {
+                    if (smCopies)
+                    {
+                        void *dst    = dstBuffers[p];
+                        void *src    = srcBuffers[d];
+                        size_t count = bytes / 16; /* The kernel copies uint4s */
+                        void *args[] = { &dst, &src, &count };
+                        cuLaunchKernel(
+                            copyFuncs[d], copyBlocks[d], 1, 1, 256, 1, 1, 0, (CUstream)streams[pair], args, nullptr);
+                    }
+                    else
+                    {
+                        cudaMemcpyPeerAsync(dstBuffers[p],
+                                            bgGlobals->gpu[p]->cudaDeviceIdx,
+                                            srcBuffers[d],
+                                            bgGlobals->gpu[d]->cudaDeviceIdx,
+                                            bytes,
+                                            streams[pair]);
+                    }
+                }
+                cudaEventRecord(stop[pair], streams[pair]);
+            }
+            cudaCheckErrorOmp(cudaDeviceSynchronize, (), PCIE_ERR_CUDA_SYNC_FAIL, d);
+
+            for (size_t p = 0; p < numGpus; p++)
+            {
+                size_t pair = d * numGpus + p;
+                if (p == d || (smCopies && (!canAccessPeer[pair] || copyFuncs[d] == nullptr)))
+                {
+                    continue;
+                }
+
+                float time_ms;
+                cudaEventElapsedTime(&time_ms, start[pair], stop[pair]);
+                double gb = (smCopies ? bytes / 16 * 16 : bytes) * (double)repeat / 1e9;
+
+                bandwidth[pair] = gb / (time_ms / 1e3);
+            }
+        } // end omp parallel
+    }
+
+    char labels[][20] = { "ce", "sm" };
+    std::stringstream ss;
+
+    for (int i = 0; i < 2; i++)
+    {
+        std::vector<double> &bandwidth = i ? smBandwidth : ceBandwidth;
+        double sum                     = 0.0;
+
+        for (size_t d = 0; d < numGpus; d++)
+        {
+            for (size_t p = 0; p < numGpus; p++)
+            {
+                size_t pair = d * numGpus + p;
+                if (p == d || (i == 1 && (!canAccessPeer[pair] || copyFuncs[d] == nullptr)))
+                {
+                    continue;
+                }
+
+                sum += bandwidth[pair];
+
+                ss.str("");
+                ss << bgGlobals->gpu[d]->gpuId << "_" << bgGlobals->gpu[p]->gpuId << "_" << labels[i];
+                bgGlobals->busGrind->SetGroupedStat(groupName, ss.str(), bandwidth[pair]);
+
+                if (bgGlobals->nvLinks.size() == numGpus * numGpus && bgGlobals->nvLinks[pair] > 0)
+                {
+                    ss << "_per_nvlink";
+                    bgGlobals->busGrind->SetGroupedStat(
+                        groupName, ss.str(), bandwidth[pair] / bgGlobals->nvLinks[pair]);
+                }
+            }
+        }
+
+        ss.str("");
+        ss << "sum_" << labels[i];
+        bgGlobals->busGrind->SetGroupedStat(groupName, ss.str(), sum);
+    }
+
+    disableP2P(bgGlobals);
+
+    for (size_t d = 0; d < numGpus; d++)
+    {
+        cudaSetDevice(bgGlobals->gpu[d]->cudaDeviceIdx);
+        if (modules[d] != nullptr)
+        {
+            cuModuleUnload(modules[d]);
+        }
+        cudaCheckError(cudaFree, (srcBuffers[d]), PCIE_ERR_CUDA_ALLOC_FAIL, d);
+        cudaCheckError(cudaFree, (dstBuffers[d]), PCIE_ERR_CUDA_ALLOC_FAIL, d);
+
+        for (size_t p = 0; p < numGpus; p++)
+        {
+            if (p == d)
+            {
+                continue;
+            }
+
+            cudaCheckError(cudaStreamDestroy, (streams[d * numGpus + p]), PCIE_ERR_CUDA_STREAM_FAIL, d);
+            cudaCheckError(cudaEventDestroy, (start[d * numGpus + p]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+            cudaCheckError(cudaEventDestroy, (stop[d * numGpus + p]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+// returns the nearest-rank percentile of samples, which must be sorted and not empty
+double bg_percentile(const std::vector<double> &samples, double percentile)
+{
+    size_t rank = (size_t)std::ceil(percentile / 100.0 * samples.size());
+    return samples[rank > 0 ? rank - 1 : 0];
+}
+
+/*****************************************************************************/
+// this test times every small copy between each pair of GPUs on its own and reports latency percentiles in
+// microseconds, so that occasional slow transfers aren't hidden in an average
+int outputP2PLatencyPercentiles(BusGrindGlobals *bgGlobals)
+{
+    size_t numGpus = bgGlobals->gpu.size();
+    std::string groupName(PCIE_SUBTEST_P2P_LATENCY_PERCENTILES);
+
+    int numElems = (int)bgGlobals->testParameters->GetSubTestDouble(groupName, PCIE_STR_INTS_PER_COPY);
+    int repeat   = (int)bgGlobals->testParameters->GetSubTestDouble(groupName, PCIE_STR_ITERATIONS);
+
+    std::vector<int *> buffers(numGpus, nullptr);
+    std::vector<cudaStream_t> streams(numGpus, nullptr);
+    std::vector<cudaEvent_t> start(numGpus, nullptr);
+    std::vector<cudaEvent_t> stop(numGpus, nullptr);
+
+    enableP2P(bgGlobals);
+
+    for (size_t d = 0; d < numGpus; d++)
+    {
+        cudaSetDevice(bgGlobals->gpu[d]->cudaDeviceIdx);
+        cudaCheckError(cudaMalloc, (&buffers[d], numElems * sizeof(int)), PCIE_ERR_CUDA_ALLOC_FAIL, d);
+        cudaCheckError(cudaStreamCreate, (&streams[d]), PCIE_ERR_CUDA_STREAM_FAIL, d);
+        cudaCheckError(cudaEventCreate, (&start[d]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+        cudaCheckError(cudaEventCreate, (&stop[d]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+    }
+
+    double percentiles[] = { 50.0, 90.0, 99.0 };
+    char labels[][20]    = { "p50", "p90", "p99" };
+    std::vector<double> allSamples;
+    std::vector<double> samples(repeat);
+    std::stringstream ss;
+
+    for (size_t i = 0; i < numGpus; i++)
+    {
+        cudaSetDevice(bgGlobals->gpu[i]->cudaDeviceIdx);
+
+        for (size_t j = 0; j < numGpus; j++)
+        {
+            if (i == j)
+            {
+                continue;
+            }
+
+            for (int r = 0; r < repeat; r++)
+            {
+                cudaEventRecord(start[i], streams[i]);
+                cudaMemcpyPeerAsync(buffers[j],
+                                    bgGlobals->gpu[j]->cudaDeviceIdx,
+                                    buffers[i],
+                                    bgGlobals->gpu[i]->cudaDeviceIdx,
+                                    numElems * sizeof(int),
+                                    streams[i]);
+                cudaEventRecord(stop[i], streams[i]);
+                cudaCheckError(cudaEventSynchronize, (stop[i]), PCIE_ERR_CUDA_SYNC_FAIL, i);
+
+                float time_ms;
+                cudaEventElapsedTime(&time_ms, start[i], stop[i]);
+                samples[r] = time_ms * 1e3;
+            }
+
+            std::sort(samples.begin(), samples.end());
+            allSamples.insert(allSamples.end(), samples.begin(), samples.end());
+
+            for (int p = 0; p < 3; p++)
+            {
+                ss.str("");
+                ss << bgGlobals->gpu[i]->gpuId << "_" << bgGlobals->gpu[j]->gpuId << "_" << labels[p];
+                bgGlobals->busGrind->SetGroupedStat(groupName, ss.str(), bg_percentile(samples, percentiles[p]));
+            }
+        }
+    }
+
+    if (!allSamples.empty())
+    {
+        std::sort(allSamples.begin(), allSamples.end());
+        for (int p = 0; p < 3; p++)
+        {
+            ss.str("");
+            ss << "all_" << labels[p];
+            bgGlobals->busGrind->SetGroupedStat(groupName, ss.str(), bg_percentile(allSamples, percentiles[p]));
+        }
+    }
+
+    disableP2P(bgGlobals);
+
+    for (size_t d = 0; d < numGpus; d++)
+    {
+        cudaSetDevice(bgGlobals->gpu[d]->cudaDeviceIdx);
+        cudaCheckError(cudaFree, (buffers[d]), PCIE_ERR_CUDA_ALLOC_FAIL, d);
+        cudaCheckError(cudaStreamDestroy, (streams[d]), PCIE_ERR_CUDA_STREAM_FAIL, d);
+        cudaCheckError(cudaEventDestroy, (start[d]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+        cudaCheckError(cudaEventDestroy, (stop[d]), PCIE_ERR_CUDA_EVENT_FAIL, d);
+    }
+
+    return 0;
+}
+
 /*****************************************************************************/
 int bg_cache_and_check_parameters(BusGrindGlobals *bgGlobals)
 {
     /* Set defaults before we parse parameters */
-    bgGlobals->test_pinned   = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_PINNED);
-    bgGlobals->test_unpinned = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_UNPINNED);
-    bgGlobals->test_p2p_on   = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_P2P_ON);
-    bgGlobals->test_p2p_off  = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_P2P_OFF);
+    bgGlobals->test_pinned     = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_PINNED);
+    bgGlobals->test_unpinned   = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_UNPINNED);
+    bgGlobals->test_p2p_on     = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_P2P_ON);
+    bgGlobals->test_p2p_off    = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_P2P_OFF);
+    bgGlobals->test_per_switch = bgGlobals->testParameters->GetBoolFromString(PCIE_STR_TEST_PER_SWITCH);
     return 0;
 }
 
@@ -1548,19 +1980,8 @@ void bg_cleanup(BusGrindGlobals *bgGlobals)
 
     bgGlobals->gpu.clear();
 
-    /* Unload our cuda context for each gpu in the current process. We enumerate all GPUs because
-       cuda opens a context on all GPUs, even if we don't use them */
-    int deviceIdx, cudaDeviceCount;
-    cudaError_t cuSt;
-    cuSt = cudaGetDeviceCount(&cudaDeviceCount);
-    if (cuSt == cudaSuccess)
-    {
-        for (deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
-        {
-            cudaSetDevice(deviceIdx);
-            cudaDeviceReset();
-        }
-    }
+    /* See CudaResources::ResetDevices() */
+    CudaResources::Instance().ResetDevices();
 }
 
 /*****************************************************************************/
@@ -1598,6 +2019,105 @@ int bg_init(BusGrindGlobals *bgGlobals, const dcgmDiagPluginGpuList_t &gpuInfo)
     return 0;
 }
 
+/*****************************************************************************/
+// returns true if topology says its GPU reaches gpuId without going through a host bridge
+bool bg_shares_pcie_switch(const dcgmDeviceTopology_t &topology, unsigned int gpuId)
+{
+    for (unsigned int i = 0; i < topology.numGpus; i++)
+    {
+        if (topology.gpuPaths[i].gpuId != gpuId)
+        {
+            continue;
+        }
+
+        dcgmGpuTopologyLevel_t path = DCGM_TOPOLOGY_PATH_PCI(topology.gpuPaths[i].path);
+        return path == DCGM_TOPOLOGY_BOARD || path == DCGM_TOPOLOGY_SINGLE || path == DCGM_TOPOLOGY_MULTIPLE;
+    }
+
+    return false;
+}
+
+/*****************************************************************************/
+// reads the local CPUs and NvLinks of each GPU and groups the GPUs by PCIe switch and by local CPUs. A group
+// is identified by the index of its first GPU. GPUs whose topology can't be read are in groups of their own
+void bg_init_host_topology(BusGrindGlobals *bgGlobals, dcgmHandle_t handle)
+{
+    size_t numGpus = bgGlobals->gpu.size();
+    cpu_set_t noCpus;
+    CPU_ZERO(&noCpus);
+
+    bgGlobals->localCpus.assign(numGpus, noCpus);
+    bgGlobals->pcieSwitchGroup.resize(numGpus);
+    bgGlobals->cpuGroup.resize(numGpus);
+    bgGlobals->nvLinks.assign(numGpus * numGpus, 0);
+
+    std::vector<dcgmDeviceTopology_t> topologies(numGpus);
+    const unsigned int bitsPerMask = 8 * sizeof(topologies[0].cpuAffinityMask[0]);
+
+    for (size_t i = 0; i < numGpus; i++)
+    {
+        memset(&topologies[i], 0, sizeof(topologies[i]));
+        topologies[i].version = dcgmDeviceTopology_version1;
+
+        dcgmReturn_t ret = dcgmGetDeviceTopology(handle, bgGlobals->gpu[i]->gpuId, &topologies[i]);
+        if (ret != DCGM_ST_OK)
+        {
+            DCGM_LOG_WARNING << "Cannot read the topology of GPU " << bgGlobals->gpu[i]->gpuId << ": "
+                             << errorString(ret) << ". Its host buffers won't be NUMA-local.";
+            topologies[i].numGpus = 0;
+            continue;
+        }
+
+        for (unsigned int word = 0; word < DCGM_AFFINITY_BITMASK_ARRAY_SIZE; word++)
+        {
+            for (unsigned int bit = 0; bit < bitsPerMask; bit++)
+            {
+                unsigned int cpu = word * bitsPerMask + bit;
+                if (((topologies[i].cpuAffinityMask[word] >> bit) & 1) && cpu < CPU_SETSIZE)
+                {
+                    CPU_SET(cpu, &bgGlobals->localCpus[i]);
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < numGpus; i++)
+    {
+        bgGlobals->pcieSwitchGroup[i] = i;
+        bgGlobals->cpuGroup[i]        = i;
+
+        for (unsigned int k = 0; k < topologies[i].numGpus; k++)
+        {
+            if (DCGM_TOPOLOGY_PATH_NVLINK(topologies[i].gpuPaths[k].path) == 0)
+            {
+                continue;
+            }
+
+            for (size_t j = 0; j < numGpus; j++)
+            {
+                if (bgGlobals->gpu[j]->gpuId == topologies[i].gpuPaths[k].gpuId)
+                {
+                    bgGlobals->nvLinks[i * numGpus + j] = __builtin_popcount(topologies[i].gpuPaths[k].localNvLinkIds);
+                }
+            }
+        }
+
+        for (size_t j = 0; j < i; j++)
+        {
+            if (bgGlobals->pcieSwitchGroup[i] == i && bg_shares_pcie_switch(topologies[j], bgGlobals->gpu[i]->gpuId))
+            {
+                bgGlobals->pcieSwitchGroup[i] = bgGlobals->pcieSwitchGroup[j];
+            }
+
+            if (bgGlobals->cpuGroup[i] == i && CPU_COUNT(&bgGlobals->localCpus[i]) > 0
+                && CPU_EQUAL(&bgGlobals->localCpus[i], &bgGlobals->localCpus[j]))
+            {
+                bgGlobals->cpuGroup[i] = bgGlobals->cpuGroup[j];
+            }
+        }
+    }
+}
+
 /*****************************************************************************/
 void bg_record_cliques(BusGrindGlobals *bgGlobals)
 {
@@ -1851,6 +2371,7 @@ int main_entry_wrapped(BusGrindGlobals *bgGlobals, const dcgmDiagPluginGpuList_t
     bgGlobals->m_dcgmRecorder->AddWatches(fieldIds, gpuVec, false, fieldGroupName, groupName, 300.0);
 
     bg_record_cliques(bgGlobals);
+    bg_init_host_topology(bgGlobals, handle);
 
     /* For the following tests, a return of 0 is success. > 0 is
      * a failure of a test condition, and a < 0 is a fatal error
@@ -1945,6 +2466,15 @@ int main_entry_wrapped(BusGrindGlobals *bgGlobals, const dcgmDiagPluginGpuList_t
         }
     }
 
+    if (bgGlobals->test_p2p_on && !bg_should_stop(bgGlobals))
+    {
+        st = outputAllPairsP2PBandwidthMatrix(bgGlobals);
+        if (st < 0)
+        {
+            goto NO_MORE_TESTS;
+        }
+    }
+
     /******************Latency Tests****************************/
     if (bgGlobals->test_pinned && !bg_should_stop(bgGlobals))
     {
@@ -1982,6 +2512,15 @@ int main_entry_wrapped(BusGrindGlobals *bgGlobals, const dcgmDiagPluginGpuList_t
         }
     }
 
+    if (bgGlobals->test_p2p_on && !bg_should_stop(bgGlobals))
+    {
+        st = outputP2PLatencyPercentiles(bgGlobals);
+        if (st < 0)
+        {
+            goto NO_MORE_TESTS;
+        }
+    }
+
 /* This should come after all of the tests have run */
 NO_MORE_TESTS:
 
@@ -24,6 +24,7 @@
 #include "TestParameters.h"
 #include "cuda_runtime.h"
 #include <PluginDevice.h>
+#include <sched.h>
 
 #define PCIE_MAX_GPUS 16
 
@@ -40,10 +41,15 @@ public:
     bool test_unpinned;
     bool test_p2p_on;
     bool test_p2p_off;
+    bool test_per_switch;
 
     BusGrind *busGrind; /* Plugin handle for setting status */
 
-    std::vector<PluginDevice *> gpu; /* Per-gpu information */
+    std::vector<PluginDevice *> gpu;           /* Per-gpu information */
+    std::vector<cpu_set_t> localCpus;          /* Per-gpu CPUs local to the GPU. Empty sets if unknown */
+    std::vector<unsigned int> pcieSwitchGroup; /* Per-gpu group of GPUs behind the same PCIe switches */
+    std::vector<unsigned int> cpuGroup;        /* Per-gpu group of GPUs with the same local CPUs */
+    std::vector<unsigned int> nvLinks;         /* NvLinks from gpu i to gpu j at [i * gpu.size() + j] */
     DcgmRecorder *m_dcgmRecorder;
 
     bool m_dcgmCommErrorOccurred;
@@ -55,8 +61,13 @@ public:
         , test_unpinned(false)
         , test_p2p_on(false)
         , test_p2p_off(false)
+        , test_per_switch(false)
         , busGrind(nullptr)
         , gpu()
+        , localCpus()
+        , pcieSwitchGroup()
+        , cpuGroup()
+        , nvLinks()
         , m_dcgmRecorder(nullptr)
         , m_dcgmCommErrorOccurred(false)
         , m_printedConcurrentGpuErrorMessage(false)
@@ -54,6 +54,9 @@ dcgmReturn_t GetPluginInfo(unsigned int pluginInterfaceVersion, dcgmDiagPluginIn
                                      PCIE_SUBTEST_1D_EXCH_BW_P2P_DISABLED,
                                      PCIE_SUBTEST_P2P_LATENCY_P2P_ENABLED,
                                      PCIE_SUBTEST_P2P_LATENCY_P2P_DISABLED,
+                                     PCIE_STR_TEST_PER_SWITCH,
+                                     PCIE_SUBTEST_P2P_BW_ALL_PAIRS,
+                                     PCIE_SUBTEST_P2P_LATENCY_PERCENTILES,
                                      nullptr };
 
     const dcgmPluginValue_t paramTypes[]
@@ -63,7 +66,7 @@ dcgmReturn_t GetPluginInfo(unsigned int pluginInterfaceVersion, dcgmDiagPluginIn
             DcgmPluginParamInt,  DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamBool,  DcgmPluginParamBool,
             DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamBool,  DcgmPluginParamBool,
             DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamBool,  DcgmPluginParamBool,
-            DcgmPluginParamNone };
+            DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamBool, DcgmPluginParamNone };
     DCGM_CASSERT(sizeof(parameterNames) / sizeof(const char *) == sizeof(paramTypes) / sizeof(const dcgmPluginValue_t),
                  1);
 
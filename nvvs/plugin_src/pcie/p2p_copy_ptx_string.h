@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned char p2p_copy_ptx_string[] = {
+    0x2e, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x36, 0x2e, 0x30, 0x0a, 0x2e, 0x74, 0x61, 0x72, 0x67, 0x65,
+    0x74, 0x20, 0x73, 0x6d, 0x5f, 0x33, 0x30, 0x0a, 0x2e, 0x61, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73, 0x5f, 0x73, 0x69,
+    0x7a, 0x65, 0x20, 0x36, 0x34, 0x0a, 0x0a, 0x09, 0x2f, 0x2f, 0x20, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x6c, 0x09, 0x50,
+    0x32, 0x50, 0x43, 0x6f, 0x70, 0x79, 0x0a, 0x0a, 0x2e, 0x76, 0x69, 0x73, 0x69, 0x62, 0x6c, 0x65, 0x20, 0x2e, 0x65,
+    0x6e, 0x74, 0x72, 0x79, 0x20, 0x50, 0x32, 0x50, 0x43, 0x6f, 0x70, 0x79, 0x28, 0x0a, 0x09, 0x2e, 0x70, 0x61, 0x72,
+    0x61, 0x6d, 0x20, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x50, 0x32, 0x50, 0x43, 0x6f, 0x70, 0x79, 0x5f, 0x70, 0x61, 0x72,
+    0x61, 0x6d, 0x5f, 0x30, 0x2c, 0x0a, 0x09, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x20, 0x2e, 0x75, 0x36, 0x34, 0x20,
+    0x50, 0x32, 0x50, 0x43, 0x6f, 0x70, 0x79, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x5f, 0x31, 0x2c, 0x0a, 0x09, 0x2e,
+    0x70, 0x61, 0x72, 0x61, 0x6d, 0x20, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x50, 0x32, 0x50, 0x43, 0x6f, 0x70, 0x79, 0x5f,
+    0x70, 0x61, 0x72, 0x61, 0x6d, 0x5f, 0x32, 0x0a, 0x29, 0x0a, 0x7b, 0x0a, 0x09, 0x2e, 0x72, 0x65, 0x67, 0x20, 0x2e,
+    0x70, 0x72, 0x65, 0x64, 0x20, 0x09, 0x25, 0x70, 0x3c, 0x33, 0x3e, 0x3b, 0x0a, 0x09, 0x2e, 0x72, 0x65, 0x67, 0x20,
+    0x2e, 0x62, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x3c, 0x31, 0x30, 0x3e, 0x3b, 0x0a, 0x09, 0x2e, 0x72, 0x65, 0x67,
+    0x20, 0x2e, 0x62, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x3c, 0x31, 0x34, 0x3e, 0x3b, 0x0a, 0x0a, 0x0a, 0x09,
+    0x6c, 0x64, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x35, 0x2c,
+    0x20, 0x5b, 0x50, 0x32, 0x50, 0x43, 0x6f, 0x70, 0x79, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x5f, 0x30, 0x5d, 0x3b,
+    0x0a, 0x09, 0x6c, 0x64, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64,
+    0x36, 0x2c, 0x20, 0x5b, 0x50, 0x32, 0x50, 0x43, 0x6f, 0x70, 0x79, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x5f, 0x31,
+    0x5d, 0x3b, 0x0a, 0x09, 0x6c, 0x64, 0x2e, 0x70, 0x61, 0x72, 0x61, 0x6d, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x09, 0x25,
+    0x72, 0x64, 0x37, 0x2c, 0x20, 0x5b, 0x50, 0x32, 0x50, 0x43, 0x6f, 0x70, 0x79, 0x5f, 0x70, 0x61, 0x72, 0x61, 0x6d,
+    0x5f, 0x32, 0x5d, 0x3b, 0x0a, 0x09, 0x63, 0x76, 0x74, 0x61, 0x2e, 0x74, 0x6f, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61,
+    0x6c, 0x2e, 0x75, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x35, 0x3b, 0x0a,
+    0x09, 0x63, 0x76, 0x74, 0x61, 0x2e, 0x74, 0x6f, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61, 0x6c, 0x2e, 0x75, 0x36, 0x34,
+    0x20, 0x09, 0x25, 0x72, 0x64, 0x32, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x36, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e,
+    0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x31, 0x2c, 0x20, 0x25, 0x6e, 0x74, 0x69, 0x64, 0x2e, 0x78, 0x3b, 0x0a,
+    0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x32, 0x2c, 0x20, 0x25, 0x63, 0x74, 0x61,
+    0x69, 0x64, 0x2e, 0x78, 0x3b, 0x0a, 0x09, 0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x33,
+    0x2c, 0x20, 0x25, 0x74, 0x69, 0x64, 0x2e, 0x78, 0x3b, 0x0a, 0x09, 0x6d, 0x75, 0x6c, 0x2e, 0x77, 0x69, 0x64, 0x65,
+    0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x64, 0x38, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x2c, 0x20, 0x25, 0x72,
+    0x32, 0x3b, 0x0a, 0x09, 0x63, 0x76, 0x74, 0x2e, 0x75, 0x36, 0x34, 0x2e, 0x75, 0x33, 0x32, 0x09, 0x25, 0x72, 0x64,
+    0x39, 0x2c, 0x20, 0x25, 0x72, 0x33, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64, 0x2e, 0x73, 0x36, 0x34, 0x20, 0x09, 0x25,
+    0x72, 0x64, 0x31, 0x33, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x38, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x39, 0x3b, 0x0a, 0x09,
+    0x6d, 0x6f, 0x76, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x25, 0x72, 0x34, 0x2c, 0x20, 0x25, 0x6e, 0x63, 0x74, 0x61,
+    0x69, 0x64, 0x2e, 0x78, 0x3b, 0x0a, 0x09, 0x6d, 0x75, 0x6c, 0x2e, 0x77, 0x69, 0x64, 0x65, 0x2e, 0x75, 0x33, 0x32,
+    0x20, 0x09, 0x25, 0x72, 0x64, 0x33, 0x2c, 0x20, 0x25, 0x72, 0x34, 0x2c, 0x20, 0x25, 0x72, 0x31, 0x3b, 0x0a, 0x09,
+    0x73, 0x65, 0x74, 0x70, 0x2e, 0x67, 0x65, 0x2e, 0x75, 0x36, 0x34, 0x09, 0x25, 0x70, 0x31, 0x2c, 0x20, 0x25, 0x72,
+    0x64, 0x31, 0x33, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x37, 0x3b, 0x0a, 0x09, 0x40, 0x25, 0x70, 0x31, 0x20, 0x62, 0x72,
+    0x61, 0x20, 0x09, 0x42, 0x42, 0x30, 0x5f, 0x32, 0x3b, 0x0a, 0x0a, 0x42, 0x42, 0x30, 0x5f, 0x31, 0x3a, 0x0a, 0x09,
+    0x73, 0x68, 0x6c, 0x2e, 0x62, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x30, 0x2c, 0x20, 0x25, 0x72, 0x64,
+    0x31, 0x33, 0x2c, 0x20, 0x34, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64, 0x2e, 0x73, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72,
+    0x64, 0x31, 0x31, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x32, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x30, 0x3b, 0x0a, 0x09,
+    0x6c, 0x64, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61, 0x6c, 0x2e, 0x76, 0x34, 0x2e, 0x75, 0x33, 0x32, 0x20, 0x09, 0x7b,
+    0x25, 0x72, 0x35, 0x2c, 0x20, 0x25, 0x72, 0x36, 0x2c, 0x20, 0x25, 0x72, 0x37, 0x2c, 0x20, 0x25, 0x72, 0x38, 0x7d,
+    0x2c, 0x20, 0x5b, 0x25, 0x72, 0x64, 0x31, 0x31, 0x5d, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64, 0x2e, 0x73, 0x36, 0x34,
+    0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x32, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31,
+    0x30, 0x3b, 0x0a, 0x09, 0x73, 0x74, 0x2e, 0x67, 0x6c, 0x6f, 0x62, 0x61, 0x6c, 0x2e, 0x76, 0x34, 0x2e, 0x75, 0x33,
+    0x32, 0x20, 0x09, 0x5b, 0x25, 0x72, 0x64, 0x31, 0x32, 0x5d, 0x2c, 0x20, 0x7b, 0x25, 0x72, 0x35, 0x2c, 0x20, 0x25,
+    0x72, 0x36, 0x2c, 0x20, 0x25, 0x72, 0x37, 0x2c, 0x20, 0x25, 0x72, 0x38, 0x7d, 0x3b, 0x0a, 0x09, 0x61, 0x64, 0x64,
+    0x2e, 0x73, 0x36, 0x34, 0x20, 0x09, 0x25, 0x72, 0x64, 0x31, 0x33, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x33, 0x2c,
+    0x20, 0x25, 0x72, 0x64, 0x33, 0x3b, 0x0a, 0x09, 0x73, 0x65, 0x74, 0x70, 0x2e, 0x6c, 0x74, 0x2e, 0x75, 0x36, 0x34,
+    0x09, 0x25, 0x70, 0x32, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x31, 0x33, 0x2c, 0x20, 0x25, 0x72, 0x64, 0x37, 0x3b, 0x0a,
+    0x09, 0x40, 0x25, 0x70, 0x32, 0x20, 0x62, 0x72, 0x61, 0x20, 0x09, 0x42, 0x42, 0x30, 0x5f, 0x31, 0x3b, 0x0a, 0x0a,
+    0x42, 0x42, 0x30, 0x5f, 0x32, 0x3a, 0x0a, 0x09, 0x72, 0x65, 0x74, 0x3b, 0x0a, 0x7d, 0x0a, 0x0a, 0x0a, 0x00
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+
+const char *P2PCopy_func_name = "P2PCopy";
@@ -15,6 +15,8 @@
  */
 #include <unistd.h>
 #define __STDC_LIMIT_MACROS
+#include <algorithm>
+#include <cmath>
 #include <stdint.h>
 
 #include "SmStressPlugin.h"
@@ -35,6 +37,7 @@ SmPerfPlugin::SmPerfPlugin(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuInfo
     , m_useDgemm(0)
     , m_sbeFailureThreshold(.0)
     , m_matrixDim(0)
+    , m_occupancyMode(false)
     , m_handle(handle)
 {
     TestParameters *tp;
@@ -50,6 +53,7 @@ SmPerfPlugin::SmPerfPlugin(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuInfo
     tp->AddString(PS_RUN_IF_GOM_ENABLED, "False");
     tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
     tp->AddString(SMSTRESS_STR_IS_ALLOWED, "False");
+    tp->AddString(SMSTRESS_STR_OCCUPANCY_MODE, "False");
     tp->AddDouble(SMSTRESS_STR_TEST_DURATION, 90.0, 1.0, 86400.0);
     tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 100.0, 1.0, 100000.0);
     tp->AddDouble(SMSTRESS_STR_TARGET_PERF_MIN_RATIO, 0.95, 0.5, 1.0);
@@ -102,19 +106,8 @@ void SmPerfPlugin::Cleanup(void)
     }
     m_dcgmRecorderInitialized = false;
 
-    /* Unload our cuda context for each gpu in the current process. We enumerate all GPUs because
-       cuda opens a context on all GPUs, even if we don't use them */
-    int cudaDeviceCount;
-    cudaError_t cuSt;
-    cuSt = cudaGetDeviceCount(&cudaDeviceCount);
-    if (cuSt == cudaSuccess)
-    {
-        for (int deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
-        {
-            cudaSetDevice(deviceIdx);
-            cudaDeviceReset();
-        }
-    }
+    /* See CudaResources::ResetDevices() */
+    CudaResources::Instance().ResetDevices();
 }
 
 /*****************************************************************************/
@@ -122,7 +115,6 @@ bool SmPerfPlugin::Init(dcgmDiagPluginGpuList_t *gpuInfo)
 {
     int gpuListIndex;
     SmPerfDevice *smDevice = 0;
-    cudaError_t cuSt;
 
     if (gpuInfo == nullptr)
     {
@@ -139,18 +131,8 @@ bool SmPerfPlugin::Init(dcgmDiagPluginGpuList_t *gpuInfo)
         return true;
     }
 
-    /* Attach to every device by index and reset it in case a previous plugin
-       didn't clean up after itself */
-    int cudaDeviceCount, deviceIdx;
-    cuSt = cudaGetDeviceCount(&cudaDeviceCount);
-    if (cuSt == cudaSuccess)
-    {
-        for (deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
-        {
-            cudaSetDevice(deviceIdx);
-            cudaDeviceReset();
-        }
-    }
+    /* See CudaResources::ResetDevices() */
+    CudaResources::Instance().ResetDevices();
 
     for (gpuListIndex = 0; gpuListIndex < gpuInfo->numGpus; gpuListIndex++)
     {
@@ -172,10 +154,42 @@ bool SmPerfPlugin::Init(dcgmDiagPluginGpuList_t *gpuInfo)
     return true;
 }
 
+/*****************************************************************************/
+void SmStressOccupancyTarget(const cudaDeviceProp &prop,
+                             bool useDgemm,
+                             unsigned int minDim,
+                             unsigned int &numStreams,
+                             unsigned int &matrixDim)
+{
+    unsigned int smCount      = std::max(prop.multiProcessorCount, 1);
+    numStreams                = std::clamp(smCount / SMSTRESS_SMS_PER_STREAM, 1U, SMSTRESS_MAX_STREAMS_PER_DEVICE);
+    unsigned int smsPerStream = (smCount + numStreams - 1) / numStreams;
+
+    /* cuBLAS computes the output in tiles of about 128x128 for sgemm and 64x64 for dgemm, one tile per SM at a time.
+       Give each GEMM enough tiles for a few waves on its share of the SMs, in multiples of 256 */
+    unsigned int tileDim      = useDgemm ? 64 : 128;
+    unsigned int tilesPerSide = (unsigned int)std::ceil(std::sqrt((double)SMSTRESS_WAVES_PER_GEMM * smsPerStream));
+    matrixDim                 = std::max(minDim, tilesPerSide * tileDim);
+    matrixDim                 = std::min((matrixDim + 255) / 256 * 256, 8192U);
+
+    /* A and B are shared by the streams */
+    size_t valueSize     = useDgemm ? sizeof(double) : sizeof(float);
+    size_t budget        = prop.totalGlobalMem / 4;
+    auto bytesNeeded     = [&]() { return (2 + numStreams) * valueSize * matrixDim * matrixDim; };
+    unsigned int minSize = std::max(minDim, 256U);
+    while (matrixDim > minSize && bytesNeeded() > budget)
+    {
+        matrixDim = std::max(matrixDim - 256, minSize);
+    }
+    while (numStreams > 1 && bytesNeeded() > budget)
+    {
+        numStreams--;
+    }
+}
+
 /*****************************************************************************/
 int SmPerfPlugin::CudaInit(void)
 {
-    using namespace Dcgm;
     int j, count, valueSize;
     size_t arrayByteSize, arrayNelem;
     cudaError_t cuSt;
@@ -198,9 +212,6 @@ int SmPerfPlugin::CudaInit(void)
         valueSize = sizeof(float);
     }
 
-    arrayByteSize = valueSize * m_matrixDim * m_matrixDim;
-    arrayNelem    = m_matrixDim * m_matrixDim;
-
     /* Do per-device initialization */
     for (size_t deviceIdx = 0; deviceIdx < m_device.size(); deviceIdx++)
     {
@@ -222,6 +233,17 @@ int SmPerfPlugin::CudaInit(void)
             return -1;
         }
 
+        device->matrixDim = m_matrixDim;
+        if (m_occupancyMode)
+        {
+            SmStressOccupancyTarget(device->cudaDevProp, m_useDgemm, m_matrixDim, device->Nstreams, device->matrixDim);
+            DCGM_LOG_DEBUG << "GPU " << device->gpuId << " has " << device->cudaDevProp.multiProcessorCount
+                           << " SMs. Running " << device->Nstreams << " streams of " << device->matrixDim << "^2 GEMMs";
+        }
+
+        arrayByteSize = valueSize * device->matrixDim * device->matrixDim;
+        arrayNelem    = device->matrixDim * device->matrixDim;
+
         /* Fill the arrays with random values */
         srand(time(NULL));
 
@@ -273,7 +295,7 @@ int SmPerfPlugin::CudaInit(void)
         }
 
         /* Initialize cublas */
-        cubSt = CublasProxy::CublasCreate(&device->cublasHandle);
+        cubSt = CudaResources::Instance().GetCublasHandle(device->cudaDeviceIdx, device->cublasHandle);
         if (cubSt != CUBLAS_STATUS_SUCCESS)
         {
             LOG_CUBLAS_ERROR("cublasCreate", cubSt, device->gpuId);
@@ -281,26 +303,47 @@ int SmPerfPlugin::CudaInit(void)
         }
         PRINT_DEBUG(
             "%d %p", "cublasCreate cudaDeviceIdx %d, handle %p", device->cudaDeviceIdx, (void *)device->cublasHandle);
-        device->allocatedCublasHandle = 1;
 
-        /* Allocate device memory */
-        cuSt = cudaMalloc((void **)&device->deviceA, arrayByteSize);
-        if (cuSt != cudaSuccess)
+        /* Allocate device memory. In occupancy mode each stream has its own C instead of deviceC */
+        std::vector<void **> devicePtrs { &device->deviceA, &device->deviceB };
+        if (m_occupancyMode)
         {
-            LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
-            return -1;
+            for (unsigned int i = 0; i < device->Nstreams; i++)
+            {
+                devicePtrs.push_back(&device->streamC[i]);
+            }
         }
-        cuSt = cudaMalloc((void **)&device->deviceB, arrayByteSize);
-        if (cuSt != cudaSuccess)
+        else
         {
-            LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
-            return -1;
+            devicePtrs.push_back(&device->deviceC);
         }
-        cuSt = cudaMalloc((void **)&device->deviceC, arrayByteSize);
-        if (cuSt != cudaSuccess)
+
+        for (void **devicePtr : devicePtrs)
         {
-            LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
-            return -1;
+            CUdeviceptr ptr;
+            CUresult cuRes = CudaResources::Instance().Allocate(device->cudaDeviceIdx, arrayByteSize, ptr);
+            if (cuRes != CUDA_SUCCESS)
+            {
+                LOG_CUDA_ERROR("cuMemAlloc", cuRes, device->gpuId, arrayByteSize);
+                return -1;
+            }
+            *devicePtr = (void *)ptr;
+        }
+
+        for (unsigned int i = 0; i < device->Nstreams; i++)
+        {
+            cuSt = cudaStreamCreate(&device->streams[i]);
+            if (cuSt != cudaSuccess)
+            {
+                LOG_CUDA_ERROR("cudaStreamCreate", cuSt, device->gpuId);
+                return -1;
+            }
+            cuSt = cudaEventCreateWithFlags(&device->afterWorkBlock[i], cudaEventDisableTiming);
+            if (cuSt != cudaSuccess)
+            {
+                LOG_CUDA_ERROR("cudaEventCreate", cuSt, device->gpuId);
+                return -1;
+            }
         }
     }
 
@@ -338,6 +381,7 @@ void SmPerfPlugin::Go(unsigned int numParameters, const dcgmDiagPluginTestParame
     m_useDgemm            = m_testParameters->GetBoolFromString(SMSTRESS_STR_USE_DGEMM);
     m_sbeFailureThreshold = m_testParameters->GetDouble(SMSTRESS_STR_SBE_ERROR_THRESHOLD);
     m_matrixDim           = m_testParameters->GetDouble(SMSTRESS_STR_MATRIX_DIM);
+    m_occupancyMode       = m_testParameters->GetBoolFromString(SMSTRESS_STR_OCCUPANCY_MODE);
 
     result = RunTest();
     if (main_should_stop)
@@ -466,6 +510,7 @@ private:
     bool m_failEarly; /* true if we should check for failures while running and abort after the first one */
     unsigned long m_failCheckInterval; /* seconds between checks for failures */
     unsigned int m_matrixDim;          /* the size of the matrix dimensions */
+    bool m_blockQueued[SMSTRESS_MAX_STREAMS_PER_DEVICE]; /* Occupancy mode: has GEMMs queued on each stream */
 
 public:
     /*************************************************************************/
@@ -502,7 +547,35 @@ private:
      *        <0 on error
      *
      */
-    int DoOneMatrixMultiplication(float *floatAlpha, double *doubleAlpha, float *floatBeta, double *doubleBeta);
+    int DoOneMatrixMultiplication(float *floatAlpha,
+                                  double *doubleAlpha,
+                                  float *floatBeta,
+                                  double *doubleBeta,
+                                  void *deviceC);
+
+    /*************************************************************************/
+    /*
+     * Occupancy mode. Count the GEMMs of streams whose last block has completed
+     * in Nops and queue another block of SMSTRESS_OPS_PER_STREAM_QUEUE GEMMs on
+     * each of those streams.
+     *
+     * Returns 0 if OK
+     *        <0 on error
+     *
+     */
+    int QueueOnIdleStreams(float *floatAlpha,
+                           double *doubleAlpha,
+                           float *floatBeta,
+                           double *doubleBeta,
+                           long long &Nops);
+
+    /*************************************************************************/
+    /*
+     * Occupancy mode. Wait for the queued GEMMs, count them in Nops and put the
+     * shared cuBLAS handle back on the default stream.
+     *
+     */
+    void FinishStreams(long long &Nops);
 };
 
 /****************************************************************************/
@@ -631,18 +704,20 @@ SmPerfWorker::SmPerfWorker(SmPerfDevice *device,
     , m_dcgmRecorder(dr)
     , m_failEarly(failEarly)
     , m_failCheckInterval(failCheckInterval)
+    , m_blockQueued()
 {
     m_useDgemm     = m_testParameters->GetBoolFromString(SMSTRESS_STR_USE_DGEMM);
     m_targetPerf   = m_testParameters->GetDouble(SMSTRESS_STR_TARGET_PERF);
     m_testDuration = m_testParameters->GetDouble(SMSTRESS_STR_TEST_DURATION);
-    m_matrixDim    = static_cast<unsigned int>(m_testParameters->GetDouble(SMSTRESS_STR_MATRIX_DIM));
+    m_matrixDim    = m_device->matrixDim;
 }
 
 /*****************************************************************************/
 int SmPerfWorker::DoOneMatrixMultiplication(float *floatAlpha,
                                             double *doubleAlpha,
                                             float *floatBeta,
-                                            double *doubleBeta)
+                                            double *doubleBeta,
+                                            void *deviceC)
 {
     using namespace Dcgm;
     cublasStatus_t cublasSt;
@@ -661,7 +736,7 @@ int SmPerfWorker::DoOneMatrixMultiplication(float *floatAlpha,
                                             (double *)m_device->deviceB,
                                             m_matrixDim,
                                             doubleBeta,
-                                            (double *)m_device->deviceC,
+                                            (double *)deviceC,
                                             m_matrixDim);
         if (cublasSt != CUBLAS_STATUS_SUCCESS)
         {
@@ -684,7 +759,7 @@ int SmPerfWorker::DoOneMatrixMultiplication(float *floatAlpha,
                                             (float *)m_device->deviceB,
                                             m_matrixDim,
                                             floatBeta,
-                                            (float *)m_device->deviceC,
+                                            (float *)deviceC,
                                             m_matrixDim);
         if (cublasSt != CUBLAS_STATUS_SUCCESS)
         {
@@ -697,6 +772,81 @@ int SmPerfWorker::DoOneMatrixMultiplication(float *floatAlpha,
     return 0;
 }
 
+/*****************************************************************************/
+int SmPerfWorker::QueueOnIdleStreams(float *floatAlpha,
+                                     double *doubleAlpha,
+                                     float *floatBeta,
+                                     double *doubleBeta,
+                                     long long &Nops)
+{
+    using namespace Dcgm;
+    cudaError_t cuSt;
+    cublasStatus_t cublasSt;
+
+    for (unsigned int i = 0; i < m_device->Nstreams; i++)
+    {
+        if (m_blockQueued[i])
+        {
+            cuSt = cudaEventQuery(m_device->afterWorkBlock[i]);
+            if (cuSt == cudaErrorNotReady)
+            {
+                continue;
+            }
+            if (cuSt != cudaSuccess)
+            {
+                LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cudaEventQuery", cuSt, m_device->gpuId);
+                return -1;
+            }
+            Nops += SMSTRESS_OPS_PER_STREAM_QUEUE;
+            m_blockQueued[i] = false;
+        }
+
+        cublasSt = CublasProxy::CublasSetStream(m_device->cublasHandle, m_device->streams[i]);
+        if (cublasSt != CUBLAS_STATUS_SUCCESS)
+        {
+            LOG_CUBLAS_ERROR_FOR_PLUGIN(&m_plugin, "cublasSetStream", cublasSt, m_device->gpuId);
+            return -1;
+        }
+
+        for (int j = 0; j < SMSTRESS_OPS_PER_STREAM_QUEUE; j++)
+        {
+            if (DoOneMatrixMultiplication(floatAlpha, doubleAlpha, floatBeta, doubleBeta, m_device->streamC[i]))
+            {
+                return -1;
+            }
+        }
+
+        cuSt = cudaEventRecord(m_device->afterWorkBlock[i], m_device->streams[i]);
+        if (cuSt != cudaSuccess)
+        {
+            LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cudaEventRecord", cuSt, m_device->gpuId);
+            return -1;
+        }
+        m_blockQueued[i] = true;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************/
+void SmPerfWorker::FinishStreams(long long &Nops)
+{
+    for (unsigned int i = 0; i < m_device->Nstreams; i++)
+    {
+        if (m_blockQueued[i] && cudaStreamSynchronize(m_device->streams[i]) == cudaSuccess)
+        {
+            Nops += SMSTRESS_OPS_PER_STREAM_QUEUE;
+        }
+        m_blockQueued[i] = false;
+    }
+
+    if (m_device->Nstreams > 0)
+    {
+        /* The handle is shared with the plugins that run after this one */
+        Dcgm::CublasProxy::CublasSetStream(m_device->cublasHandle, 0);
+    }
+}
+
 /*****************************************************************************/
 void SmPerfWorker::run(void)
 {
@@ -754,8 +904,10 @@ void SmPerfWorker::run(void)
     floatAlpha  = (float)doubleAlpha;
     floatBeta   = (float)doubleBeta;
 
-    std::string gflopsKey;
-    gflopsKey = std::string(PERF_STAT_NAME);
+    CustomStatHolder &statHolder = m_plugin.GetCustomStatHolder();
+    CustomGpuStatBuffer stats(statHolder, m_device->gpuId);
+    customStatHandle_t perfStat = statHolder.RegisterStat(PERF_STAT_NAME);
+    customStatHandle_t nopsStat = statHolder.RegisterStat("nops_so_far");
 
     /* Record some of our static calculated parameters in case we need them for debugging */
     m_plugin.SetGpuStat(m_device->gpuId, "flops_per_op", flopsPerOp);
@@ -781,10 +933,23 @@ void SmPerfWorker::run(void)
         maxOpsSoFar = (long long)(elapsed * opsPerSec);
         NopsBefore  = Nops;
 
+        if (m_device->Nstreams > 0)
+        {
+            /* Occupancy mode isn't throttled. Nops only counts GEMMs that have completed */
+            st = QueueOnIdleStreams(&floatAlpha, &doubleAlpha, &floatBeta, &doubleBeta, Nops);
+            if (st)
+            {
+                // There was an error - stop test
+                FinishStreams(Nops);
+                m_stopTime = timelib_usecSince1970();
+                return;
+            }
+        }
+
         // If we're training, don't check maxOpsSoFar or we can't train past the target
-        for (int i = 0; i < opsPerResync && Nops < maxOpsSoFar; i++)
+        for (int i = 0; m_device->Nstreams == 0 && i < opsPerResync && Nops < maxOpsSoFar; i++)
         {
-            st = DoOneMatrixMultiplication(&floatAlpha, &doubleAlpha, &floatBeta, &doubleBeta);
+            st = DoOneMatrixMultiplication(&floatAlpha, &doubleAlpha, &floatBeta, &doubleBeta, m_device->deviceC);
             if (st)
             {
                 // There was an error - stop test
@@ -794,7 +959,7 @@ void SmPerfWorker::run(void)
             Nops++;
         }
 
-        /* If we didn't queue any work, sleep a bit so we don't busy wait */
+        /* If we didn't queue or complete any work, sleep a bit so we don't busy wait */
         if (NopsBefore == Nops)
         {
             usleep(1000);
@@ -807,8 +972,8 @@ void SmPerfWorker::run(void)
             elapsed       = now - startTime;
             double gflops = (flopsPerOp * (double)Nops) / (1000000000.0 * elapsed);
 
-            m_plugin.SetGpuStat(m_device->gpuId, gflopsKey, gflops);
-            m_plugin.SetGpuStat(m_device->gpuId, "nops_so_far", Nops);
+            stats.Append(perfStat, gflops);
+            stats.Append(nopsStat, Nops);
 
             ss.str("");
             ss << "GPU " << m_device->gpuId << ", ops " << Nops << ", gflops " << gflops;
@@ -819,6 +984,7 @@ void SmPerfWorker::run(void)
         /* Time to check for failure? */
         if (m_failEarly && now - lastFailureCheckTime > m_failCheckInterval)
         {
+            stats.Flush();
             bool result = m_plugin.CheckPassFailSingleGpu(
                 m_device, errorList, lastFailureCheckTime * 1000000, now * 1000000, false);
             if (!result)
@@ -831,6 +997,26 @@ void SmPerfWorker::run(void)
         }
     }
 
+    if (m_device->Nstreams > 0)
+    {
+        FinishStreams(Nops);
+        elapsed = timelib_dsecSince1970() - startTime;
+        if (elapsed > 0.0)
+        {
+            /* A MIG instance is its own CUDA device, named after its profile */
+            double tflops = (flopsPerOp * (double)Nops) / (1000000000000.0 * elapsed);
+            m_plugin.SetGpuStat(m_device->gpuId, SUSTAINED_PERF_STAT_NAME, tflops);
+
+            ss.str("");
+            ss.setf(std::ios::fixed, std::ios::floatfield);
+            ss.precision(2);
+            ss << "GPU " << m_device->gpuId << " (" << m_device->cudaDevProp.name << ", "
+               << m_device->cudaDevProp.multiProcessorCount << " SMs) sustained " << tflops << " TFLOPS across "
+               << m_device->Nstreams << " streams";
+            m_plugin.AddInfoVerboseForGpu(m_device->gpuId, ss.str());
+        }
+    }
+
     m_stopTime = timelib_usecSince1970();
     PRINT_DEBUG("%d %lld", "SmPerfWorker deviceIndex %d finished at %lld", m_device->gpuId, (long long)m_stopTime);
 }
@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "CudaCommon.h"
+#include "CudaResources.h"
 #include "DcgmError.h"
 #include "DcgmRecorder.h"
 #include "Plugin.h"
@@ -42,18 +43,39 @@
 
 #define SMSTRESS_MAX_DEVICES 32 /* Maximum number of devices to run this on concurrently */
 
+/* Occupancy mode. See SmStressOccupancyTarget() */
+#define SMSTRESS_MAX_STREAMS_PER_DEVICE 8U /* Maximum concurrent streams per device */
+#define SMSTRESS_SMS_PER_STREAM         12 /* SMs to give each stream before adding another one */
+#define SMSTRESS_WAVES_PER_GEMM         4  /* Waves of output tiles each GEMM runs on its share of the SMs */
+#define SMSTRESS_OPS_PER_STREAM_QUEUE   4  /* GEMMs queued on a stream between checks for their completion */
+
 /*****************************************************************************/
 /* String constants */
 
 /* Stat names in the JSON output */
-#define PERF_STAT_NAME "perf_gflops"
+#define PERF_STAT_NAME           "perf_gflops"
+#define SUSTAINED_PERF_STAT_NAME "sustained_tflops"
+
+/*****************************************************************************/
+/*
+ * Pick how many streams to run concurrently on a device in occupancy mode and
+ * the matrix dimension of their GEMMs, so that the streams together keep all
+ * of the device's SMs busy. A MIG instance is sized by its own SM count.
+ *
+ * minDim is the smallest dimension to use. The matrices of all streams are
+ * kept within a quarter of the device's memory.
+ */
+void SmStressOccupancyTarget(const cudaDeviceProp &prop,
+                             bool useDgemm,
+                             unsigned int minDim,
+                             unsigned int &numStreams,
+                             unsigned int &matrixDim);
 
 /*****************************************************************************/
 /* Class for a single sm perf device */
 class SmPerfDevice : public PluginDevice
 {
 public:
-    int allocatedCublasHandle;   /* Have we allocated cublasHandle yet? */
     cublasHandle_t cublasHandle; /* Handle to cuBlas */
 
     /* Device pointers */
@@ -66,9 +88,16 @@ public:
     void *hostB;
     void *hostC;
 
+    unsigned int matrixDim; /* Dimension of the matrices on this device */
+
+    /* Occupancy mode. Each stream writes its own C */
+    unsigned int Nstreams;
+    cudaStream_t streams[SMSTRESS_MAX_STREAMS_PER_DEVICE];
+    cudaEvent_t afterWorkBlock[SMSTRESS_MAX_STREAMS_PER_DEVICE]; /* Recorded after each block of queued GEMMs */
+    void *streamC[SMSTRESS_MAX_STREAMS_PER_DEVICE];
+
     SmPerfDevice(unsigned int ndi, const char *pciBusId, Plugin *p)
         : PluginDevice(ndi, pciBusId, p)
-        , allocatedCublasHandle(0)
         , cublasHandle(0)
         , deviceA(0)
         , deviceB(0)
@@ -76,18 +105,43 @@ public:
         , hostA(0)
         , hostB(0)
         , hostC(0)
+        , matrixDim(0)
+        , Nstreams(0)
+        , streams()
+        , afterWorkBlock()
+        , streamC()
     {}
 
     ~SmPerfDevice()
     {
-        using namespace Dcgm;
-        if (allocatedCublasHandle != 0)
+        for (void **devicePtr : { &deviceA, &deviceB, &deviceC })
+        {
+            if (*devicePtr)
+            {
+                CudaResources::Instance().Free(cudaDeviceIdx, (CUdeviceptr)*devicePtr);
+                *devicePtr = 0;
+            }
+        }
+
+        for (unsigned int i = 0; i < Nstreams; i++)
         {
-            PRINT_DEBUG("%d %p", "cublasDestroy cudaDeviceIdx %d, handle %p", cudaDeviceIdx, (void *)cublasHandle);
-            CublasProxy::CublasDestroy(cublasHandle);
-            cublasHandle          = 0;
-            allocatedCublasHandle = 0;
+            if (streamC[i])
+            {
+                CudaResources::Instance().Free(cudaDeviceIdx, (CUdeviceptr)streamC[i]);
+                streamC[i] = 0;
+            }
+            if (afterWorkBlock[i])
+            {
+                cudaEventDestroy(afterWorkBlock[i]);
+                afterWorkBlock[i] = 0;
+            }
+            if (streams[i])
+            {
+                cudaStreamDestroy(streams[i]);
+                streams[i] = 0;
+            }
         }
+        Nstreams = 0;
 
         if (hostA)
         {
@@ -216,6 +270,7 @@ private:
     int m_useDgemm;               /* Whether or not to use dgemm (or sgemm) 1=use dgemm */
     double m_sbeFailureThreshold; /* how many SBEs constitutes a failure */
     unsigned int m_matrixDim;     /* dimension for the matrix used */
+    bool m_occupancyMode;         /* Saturate the SMs with concurrent streams instead of targeting m_targetPerf */
     dcgmHandle_t m_handle;
     dcgmDiagPluginGpuList_t m_gpuInfo;
 };
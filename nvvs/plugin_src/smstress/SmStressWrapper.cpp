@@ -34,11 +34,12 @@ dcgmReturn_t GetPluginInfo(unsigned int pluginInterfaceVersion, dcgmDiagPluginIn
                                      SMSTRESS_STR_MAX_MEMORY_CLOCK,
                                      SMSTRESS_STR_MAX_GRAPHICS_CLOCK,
                                      SMSTRESS_STR_MATRIX_DIM,
+                                     SMSTRESS_STR_OCCUPANCY_MODE,
                                      nullptr };
     const dcgmPluginValue_t paramTypes[]
         = { DcgmPluginParamInt,   DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamInt,
             DcgmPluginParamInt,   DcgmPluginParamBool,  DcgmPluginParamBool,  DcgmPluginParamFloat,
-            DcgmPluginParamFloat, DcgmPluginParamInt,   DcgmPluginParamNone };
+            DcgmPluginParamFloat, DcgmPluginParamInt,   DcgmPluginParamBool,  DcgmPluginParamNone };
     DCGM_CASSERT(sizeof(parameterNames) / sizeof(const char *) == sizeof(paramTypes) / sizeof(const dcgmPluginValue_t),
                  1);
 
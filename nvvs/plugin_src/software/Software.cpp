@@ -25,6 +25,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <string.h>
+#include <thread>
 #include <unistd.h>
 
 #ifdef __x86_64__
@@ -377,17 +378,17 @@ bool Software::findLib(std::string library, std::string &error)
 
 int Software::checkForGraphicsProcesses()
 {
-    std::vector<unsigned int>::const_iterator gpuIt;
     unsigned int gpuId;
     unsigned int flags = DCGM_FV_FLAG_LIVE_DATA;
-    dcgmFieldValue_v2 graphicsPidsVal;
 
-    for (gpuIt = m_gpuList.begin(); gpuIt != m_gpuList.end(); gpuIt++)
+    std::vector<GpuFieldValues> gpuValues = GetCurrentFieldValues({ DCGM_FI_DEV_GRAPHICS_PIDS }, flags);
+
+    for (size_t gpuIndex = 0; gpuIndex < m_gpuList.size(); gpuIndex++)
     {
-        gpuId = *gpuIt;
+        gpuId = m_gpuList[gpuIndex];
 
-        dcgmReturn_t ret
-            = m_dcgmRecorder.GetCurrentFieldValue(gpuId, DCGM_FI_DEV_GRAPHICS_PIDS, graphicsPidsVal, flags);
+        dcgmReturn_t ret                   = gpuValues[gpuIndex].ret[0];
+        dcgmFieldValue_v2 &graphicsPidsVal = gpuValues[gpuIndex].value[0];
 
         if (ret != DCGM_ST_OK)
         {
@@ -454,10 +455,6 @@ int Software::checkPersistenceMode()
 int Software::checkPageRetirement()
 {
     unsigned int gpuId;
-    std::vector<unsigned int>::const_iterator gpuIt;
-    dcgmFieldValue_v2 pendingRetirementsFieldValue;
-    dcgmFieldValue_v2 dbeFieldValue;
-    dcgmFieldValue_v2 sbeFieldValue;
     dcgmReturn_t ret;
     int64_t retiredPagesTotal;
 
@@ -471,12 +468,22 @@ int Software::checkPageRetirement()
         flags = 0;
     }
 
-    for (gpuIt = m_gpuList.begin(); gpuIt != m_gpuList.end(); gpuIt++)
+    /* The volatile DBE count is only needed when there are pending retirements, but reading it with the rest
+     * keeps this to one round of queries */
+    std::vector<unsigned short> fieldIds = {
+        DCGM_FI_DEV_RETIRED_PENDING, DCGM_FI_DEV_ECC_DBE_VOL_TOTAL, DCGM_FI_DEV_RETIRED_DBE, DCGM_FI_DEV_RETIRED_SBE
+    };
+    std::vector<GpuFieldValues> gpuValues = GetCurrentFieldValues(fieldIds, flags);
+
+    for (size_t gpuIndex = 0; gpuIndex < m_gpuList.size(); gpuIndex++)
     {
-        gpuId = *gpuIt;
+        gpuId                                           = m_gpuList[gpuIndex];
+        dcgmFieldValue_v2 &pendingRetirementsFieldValue = gpuValues[gpuIndex].value[0];
+        dcgmFieldValue_v2 &dbeFieldValue                = gpuValues[gpuIndex].value[2];
+        dcgmFieldValue_v2 &sbeFieldValue                = gpuValues[gpuIndex].value[3];
+
         // Check for pending page retirements
-        ret = m_dcgmRecorder.GetCurrentFieldValue(
-            gpuId, DCGM_FI_DEV_RETIRED_PENDING, pendingRetirementsFieldValue, flags);
+        ret = gpuValues[gpuIndex].ret[0];
         if (ret != DCGM_ST_OK)
         {
             DcgmError d { gpuId };
@@ -495,8 +502,8 @@ int Software::checkPageRetirement()
         }
         else if (pendingRetirementsFieldValue.value.i64 > 0)
         {
-            dcgmFieldValue_v2 volDbeVal = {};
-            ret = m_dcgmRecorder.GetCurrentFieldValue(gpuId, DCGM_FI_DEV_ECC_DBE_VOL_TOTAL, volDbeVal, flags);
+            dcgmFieldValue_v2 &volDbeVal = gpuValues[gpuIndex].value[1];
+            ret                          = gpuValues[gpuIndex].ret[1];
             if (ret == DCGM_ST_OK && (volDbeVal.value.i64 > 0 && !DCGM_INT64_IS_BLANK(volDbeVal.value.i64)))
             {
                 DcgmError d { gpuId };
@@ -518,7 +525,7 @@ int Software::checkPageRetirement()
         retiredPagesTotal = 0;
 
         // DBE retired pages
-        ret = m_dcgmRecorder.GetCurrentFieldValue(gpuId, DCGM_FI_DEV_RETIRED_DBE, dbeFieldValue, flags);
+        ret = gpuValues[gpuIndex].ret[2];
         if (ret != DCGM_ST_OK)
         {
             DcgmError d { gpuId };
@@ -539,7 +546,7 @@ int Software::checkPageRetirement()
         }
 
         // SBE retired pages
-        ret = m_dcgmRecorder.GetCurrentFieldValue(gpuId, DCGM_FI_DEV_RETIRED_SBE, sbeFieldValue, flags);
+        ret = gpuValues[gpuIndex].ret[3];
         if (ret != DCGM_ST_OK)
         {
             DcgmError d { gpuId };
@@ -575,9 +582,6 @@ int Software::checkPageRetirement()
 int Software::checkRowRemapping()
 {
     unsigned int gpuId;
-    std::vector<unsigned int>::const_iterator gpuIt;
-    dcgmFieldValue_v2 pendingRowRemap;
-    dcgmFieldValue_v2 rowRemapFailure;
     dcgmReturn_t ret;
 
     /* Flags to pass to dcgmRecorder.GetCurrentFieldValue. Get live data since we're not watching the fields ahead of
@@ -590,14 +594,18 @@ int Software::checkRowRemapping()
         flags = 0;
     }
 
-    for (gpuIt = m_gpuList.begin(); gpuIt != m_gpuList.end(); gpuIt++)
-    {
-        gpuId = *gpuIt;
+    std::vector<unsigned short> fieldIds
+        = { DCGM_FI_DEV_ROW_REMAP_FAILURE, DCGM_FI_DEV_ROW_REMAP_PENDING, DCGM_FI_DEV_UNCORRECTABLE_REMAPPED_ROWS };
+    std::vector<GpuFieldValues> gpuValues = GetCurrentFieldValues(fieldIds, flags);
 
-        memset(&rowRemapFailure, 0, sizeof(rowRemapFailure));
+    for (size_t gpuIndex = 0; gpuIndex < m_gpuList.size(); gpuIndex++)
+    {
+        gpuId                              = m_gpuList[gpuIndex];
+        dcgmFieldValue_v2 &rowRemapFailure = gpuValues[gpuIndex].value[0];
+        dcgmFieldValue_v2 &pendingRowRemap = gpuValues[gpuIndex].value[1];
 
         // Row remap failure
-        ret = m_dcgmRecorder.GetCurrentFieldValue(gpuId, DCGM_FI_DEV_ROW_REMAP_FAILURE, rowRemapFailure, flags);
+        ret = gpuValues[gpuIndex].ret[0];
         if (ret != DCGM_ST_OK)
         {
             DcgmError d { gpuId };
@@ -622,10 +630,8 @@ int Software::checkRowRemapping()
             continue;
         }
 
-        memset(&pendingRowRemap, 0, sizeof(pendingRowRemap));
-
         // Check for pending row remappings
-        ret = m_dcgmRecorder.GetCurrentFieldValue(gpuId, DCGM_FI_DEV_ROW_REMAP_PENDING, pendingRowRemap, flags);
+        ret = gpuValues[gpuIndex].ret[1];
         if (ret != DCGM_ST_OK)
         {
             DcgmError d { gpuId };
@@ -642,8 +648,8 @@ int Software::checkRowRemapping()
         }
         else if (pendingRowRemap.value.i64 > 0)
         {
-            dcgmFieldValue_v2 uncRemap = {};
-            ret = m_dcgmRecorder.GetCurrentFieldValue(gpuId, DCGM_FI_DEV_UNCORRECTABLE_REMAPPED_ROWS, uncRemap, flags);
+            dcgmFieldValue_v2 &uncRemap = gpuValues[gpuIndex].value[2];
+            ret                         = gpuValues[gpuIndex].ret[2];
             if (ret == DCGM_ST_OK && (uncRemap.value.i64 > 0 && !DCGM_INT64_IS_BLANK(uncRemap.value.i64)))
             {
                 DcgmError d { gpuId };
@@ -666,16 +672,16 @@ int Software::checkRowRemapping()
 
 int Software::checkInforom()
 {
-    std::vector<unsigned int>::const_iterator gpuIt;
     unsigned int flags = DCGM_FV_FLAG_LIVE_DATA;
-    dcgmFieldValue_v2 inforomValidVal;
 
-    for (gpuIt = m_gpuList.begin(); gpuIt != m_gpuList.end(); gpuIt++)
+    std::vector<GpuFieldValues> gpuValues = GetCurrentFieldValues({ DCGM_FI_DEV_INFOROM_CONFIG_VALID }, flags);
+
+    for (size_t gpuIndex = 0; gpuIndex < m_gpuList.size(); gpuIndex++)
     {
-        unsigned int gpuId = *gpuIt;
+        unsigned int gpuId = m_gpuList[gpuIndex];
 
-        dcgmReturn_t ret
-            = m_dcgmRecorder.GetCurrentFieldValue(gpuId, DCGM_FI_DEV_INFOROM_CONFIG_VALID, inforomValidVal, flags);
+        dcgmReturn_t ret                   = gpuValues[gpuIndex].ret[0];
+        dcgmFieldValue_v2 &inforomValidVal = gpuValues[gpuIndex].value[0];
 
         if (ret != DCGM_ST_OK)
         {
@@ -760,3 +766,34 @@ int Software::checkForBadEnvVaribles()
 
     return 0;
 }
+
+std::vector<Software::GpuFieldValues> Software::GetCurrentFieldValues(const std::vector<unsigned short> &fieldIds,
+                                                                      unsigned int flags)
+{
+    std::vector<GpuFieldValues> gpuValues(m_gpuList.size());
+    std::vector<std::thread> threads;
+
+    threads.reserve(m_gpuList.size());
+    for (size_t gpuIndex = 0; gpuIndex < m_gpuList.size(); gpuIndex++)
+    {
+        threads.emplace_back([this, gpuIndex, flags, &fieldIds, &gpuValues]() {
+            GpuFieldValues &values = gpuValues[gpuIndex];
+            values.ret.resize(fieldIds.size(), DCGM_ST_OK);
+            values.value.resize(fieldIds.size());
+
+            for (size_t i = 0; i < fieldIds.size(); i++)
+            {
+                values.ret[i]
+                    = m_dcgmRecorder.GetCurrentFieldValue(m_gpuList[gpuIndex], fieldIds[i], values.value[i], flags);
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    /* The callers report in GPU order from here, so the results don't depend on which thread finished first */
+    return gpuValues;
+}
@@ -57,6 +57,13 @@ private:
         CHECK_CUDATK, // CUDA toolkit libraries (blas, fft, etc.)
     };
 
+    /* The current values of some fields for one GPU, indexed like the field ids they were requested with */
+    struct GpuFieldValues
+    {
+        std::vector<dcgmReturn_t> ret;
+        std::vector<dcgmFieldValue_v2> value;
+    };
+
     // variables
     std::string myArgs;
     TestParameters *tp;
@@ -78,6 +85,14 @@ private:
     int checkPageRetirement();
     int checkRowRemapping();
     int checkInforom();
+
+    /*
+     * Read the current values of fieldIds for every GPU in m_gpuList. The GPUs are queried concurrently, one
+     * thread each, so a check costs about as much on a 16 GPU node as on a single GPU.
+     *
+     * @return one entry per GPU, in m_gpuList order
+     */
+    std::vector<GpuFieldValues> GetCurrentFieldValues(const std::vector<unsigned short> &fieldIds, unsigned int flags);
 };
 
 
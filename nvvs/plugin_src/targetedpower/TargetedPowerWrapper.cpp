@@ -43,15 +43,17 @@ dcgmReturn_t GetPluginInfo(unsigned int pluginInterfaceVersion, dcgmDiagPluginIn
                                      TP_STR_STARTING_MATRIX_DIM,
                                      TP_STR_IS_ALLOWED,
                                      TP_STR_SBE_ERROR_THRESHOLD,
+                                     TP_STR_CONTROLLER_KP,
+                                     TP_STR_CONTROLLER_KI,
                                      nullptr };
 
     const dcgmPluginValue_t paramTypes[]
         = { DcgmPluginParamInt,   DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamBool,
-            DcgmPluginParamBool,  DcgmPluginParamInt,   DcgmPluginParamInt,   DcgmPluginParamInt,
+            DcgmPluginParamBool,  DcgmPluginParamInt,   DcgmPluginParamFloat, DcgmPluginParamInt,
             DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamInt,   DcgmPluginParamFloat,
             DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamFloat,
             DcgmPluginParamInt,   DcgmPluginParamInt,   DcgmPluginParamBool,  DcgmPluginParamInt,
-            DcgmPluginParamNone };
+            DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamNone };
     DCGM_CASSERT(sizeof(parameterNames) / sizeof(const char *) == sizeof(paramTypes) / sizeof(const dcgmPluginValue_t),
                  1);
 
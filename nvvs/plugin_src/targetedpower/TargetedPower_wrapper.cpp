@@ -17,6 +17,8 @@
 #include <stdint.h>
 
 #include "TargetedPower_wrapper.h"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 #include "NvvsThread.h"
@@ -53,7 +55,7 @@ ConstantPower::ConstantPower(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuIn
     tp->AddDouble(TP_STR_TEST_DURATION, 120.0, 1.0, 86400.0);
     tp->AddDouble(TP_STR_TARGET_POWER, 100.0, 1.0, 500.0);
     tp->AddDouble(TP_STR_CUDA_STREAMS_PER_GPU, 4.0, 1.0, (double)TP_MAX_STREAMS_PER_DEVICE);
-    tp->AddDouble(TP_STR_READJUST_INTERVAL, 2.0, 1.0, 10.0);
+    tp->AddDouble(TP_STR_READJUST_INTERVAL, 0.1, 0.05, 10.0);
     tp->AddDouble(TP_STR_PRINT_INTERVAL, 1.0, 1.0, 300.0);
     tp->AddDouble(TP_STR_TARGET_POWER_MIN_RATIO, 0.75, 0.5, 1.0);
     tp->AddDouble(TP_STR_TARGET_POWER_MAX_RATIO, 1.2, 1.0, 2.0);
@@ -66,6 +68,8 @@ ConstantPower::ConstantPower(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuIn
     tp->AddDouble(TP_STR_OPS_PER_REQUEUE, 1.0, 1.0, 32.0);
     tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1.0, 1.0, 1024.0);
     tp->AddDouble(TP_STR_SBE_ERROR_THRESHOLD, DCGM_FP64_BLANK, 0.0, DCGM_FP64_BLANK);
+    tp->AddDouble(TP_STR_CONTROLLER_KP, 1.0, 0.0, 10.0);
+    tp->AddDouble(TP_STR_CONTROLLER_KI, 2.0, 0.0, 100.0);
     tp->AddString(TP_STR_IS_ALLOWED, "False");
     tp->AddString(PS_LOGFILE, "stats_targeted_power.json");
     tp->AddDouble(PS_LOGFILE_TYPE, 0.0, NVVS_LOGFILE_TYPE_JSON, NVVS_LOGFILE_TYPE_BINARY);
@@ -131,26 +135,14 @@ void ConstantPower::Cleanup()
     }
     m_dcgmRecorderInitialized = false;
 
-    /* Unload our cuda context for each gpu in the current process. We enumerate all GPUs because
-       cuda opens a context on all GPUs, even if we don't use them */
-    int cudaDeviceCount;
-    cudaError_t cuSt;
-    cuSt = cudaGetDeviceCount(&cudaDeviceCount);
-    if (cuSt == cudaSuccess)
-    {
-        for (int deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
-        {
-            cudaSetDevice(deviceIdx);
-            cudaDeviceReset();
-        }
-    }
+    /* See CudaResources::ResetDevices() */
+    CudaResources::Instance().ResetDevices();
 }
 
 /*************************************************************************/
 bool ConstantPower::Init(dcgmDiagPluginGpuList_t *gpuInfo)
 {
     std::unique_ptr<CPDevice> device;
-    cudaError_t cuSt;
 
     if (gpuInfo == nullptr)
     {
@@ -160,18 +152,8 @@ bool ConstantPower::Init(dcgmDiagPluginGpuList_t *gpuInfo)
 
     m_gpuInfo = *gpuInfo;
 
-    /* Attach to every device by index and reset it in case a previous plugin
-       didn't clean up after itself */
-    int cudaDeviceCount;
-    cuSt = cudaGetDeviceCount(&cudaDeviceCount);
-    if (cuSt == cudaSuccess)
-    {
-        for (int deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
-        {
-            cudaSetDevice(deviceIdx);
-            cudaDeviceReset();
-        }
-    }
+    /* See CudaResources::ResetDevices() */
+    CudaResources::Instance().ResetDevices();
 
     for (int gpuListIndex = 0; gpuListIndex < gpuInfo->numGpus; gpuListIndex++)
     {
@@ -221,7 +203,6 @@ bool ConstantPower::Init(dcgmDiagPluginGpuList_t *gpuInfo)
 /*************************************************************************/
 int ConstantPower::CudaInit()
 {
-    using namespace Dcgm;
     int count, valueSize;
     size_t arrayByteSize, arrayNelem;
     cudaError_t cuSt;
@@ -293,8 +274,7 @@ int ConstantPower::CudaInit()
     /* Do per-device initialization */
     for (size_t deviceIdx = 0; deviceIdx < m_device.size(); deviceIdx++)
     {
-        device               = m_device[deviceIdx];
-        device->minMatrixDim = 1;
+        device = m_device[deviceIdx];
 
         /* Make all subsequent cuda calls link to this device */
         cudaSetDevice(device->cudaDeviceIdx);
@@ -324,36 +304,40 @@ int ConstantPower::CudaInit()
         }
 
         /* Initialize cublas */
-        cubSt = CublasProxy::CublasCreate(&device->cublasHandle);
+        cubSt = CudaResources::Instance().GetCublasHandle(device->cudaDeviceIdx, device->cublasHandle);
         if (cubSt != CUBLAS_STATUS_SUCCESS)
         {
             LOG_CUBLAS_ERROR("cublasCreate", cubSt, device->gpuId);
             return -1;
         }
-        device->allocatedCublasHandle = 1;
 
-        cuSt = cudaMalloc((void **)&device->deviceA, arrayByteSize);
-        if (cuSt != cudaSuccess)
+        CUdeviceptr ptr;
+        CUresult cuRes = CudaResources::Instance().Allocate(device->cudaDeviceIdx, arrayByteSize, ptr);
+        if (cuRes != CUDA_SUCCESS)
         {
-            LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
+            LOG_CUDA_ERROR("cuMemAlloc", cuRes, device->gpuId, arrayByteSize);
             return -1;
         }
-        cuSt = cudaMalloc((void **)&device->deviceB, arrayByteSize);
-        if (cuSt != cudaSuccess)
+        device->deviceA = (void *)ptr;
+
+        cuRes = CudaResources::Instance().Allocate(device->cudaDeviceIdx, arrayByteSize, ptr);
+        if (cuRes != CUDA_SUCCESS)
         {
-            LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
+            LOG_CUDA_ERROR("cuMemAlloc", cuRes, device->gpuId, arrayByteSize);
             return -1;
         }
+        device->deviceB = (void *)ptr;
 
         device->NdeviceC = 0;
         for (int i = 0; i < TP_MAX_OUTPUT_MATRICES; i++)
         {
-            cuSt = cudaMalloc((void **)&device->deviceC[i], arrayByteSize);
-            if (cuSt != cudaSuccess)
+            cuRes = CudaResources::Instance().Allocate(device->cudaDeviceIdx, arrayByteSize, ptr);
+            if (cuRes != CUDA_SUCCESS)
             {
-                LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
+                LOG_CUDA_ERROR("cuMemAlloc", cuRes, device->gpuId, arrayByteSize);
                 return -1;
             }
+            device->deviceC[i] = (void *)ptr;
             device->NdeviceC++;
         }
 
@@ -611,6 +595,11 @@ private:
     double m_testDuration;             /* Target test duration in seconds */
     timelib64_t m_stopTime;            /* Timestamp when run() finished */
     double m_reAdjustInterval;         /* How often to change the matrix size in seconds */
+    double m_kp;                       /* Proportional gain of the power controller */
+    double m_ki;                       /* Integral gain of the power controller, per second */
+    double m_logWork;                  /* Controller output: log(matrixDim^2) */
+    double m_lastError;                /* Relative power error at the previous controller update */
+    double m_filteredPower;            /* Smoothed power reading in watts. < 0 until the first reading */
     double m_printInterval;            /* How often to print out status to stdout */
     int m_opsPerRequeue;               /* How many cublas operations to queue to each stream each time we queue work
                                                    to it */
@@ -654,15 +643,13 @@ private:
 
     /*****************************************************************************/
     /*
-     * Calculate the percent difference between a and b
-     */
-    static double PercentDiff(double a, double b);
-
-    /*****************************************************************************/
-    /*
-     * Return the new matrix dimension to use for ramping up to the target power.
+     * Return the new matrix dimension to use for ramping up to and holding the target power.
+     *
+     * This is a PI controller in velocity form over log(matrixDim^2), the work per GEMM. Working in log space
+     * makes a relative power error produce the same relative change in work at any matrix size, and the
+     * velocity form can't wind up while the output is clamped. dt is the time since the previous update.
      */
-    int RecalcMatrixDim(int currentMatrixDim, double power);
+    int RecalcMatrixDim(double power, double dt);
 };
 
 /****************************************************************************/
@@ -814,6 +801,11 @@ ConstantPowerWorker::ConstantPowerWorker(CPDevice *device,
     , m_testParameters(tp)
     , m_dcgmRecorder(dr)
     , m_stopTime(0)
+    , m_kp(0.0)
+    , m_ki(0.0)
+    , m_logWork(0.0)
+    , m_lastError(0.0)
+    , m_filteredPower(-1.0)
     , m_failEarly(failEarly)
     , m_failCheckInterval(failCheckInterval)
 {
@@ -824,6 +816,9 @@ ConstantPowerWorker::ConstantPowerWorker(CPDevice *device,
     m_printInterval     = tp->GetDouble(TP_STR_PRINT_INTERVAL);
     m_opsPerRequeue     = (int)tp->GetDouble(TP_STR_OPS_PER_REQUEUE);
     m_startingMatrixDim = (int)tp->GetDouble(TP_STR_STARTING_MATRIX_DIM);
+    m_kp                = tp->GetDouble(TP_STR_CONTROLLER_KP);
+    m_ki                = tp->GetDouble(TP_STR_CONTROLLER_KI);
+    m_logWork           = 2.0 * log((double)m_startingMatrixDim);
 }
 
 /****************************************************************************/
@@ -832,7 +827,9 @@ double ConstantPowerWorker::ReadPower()
     dcgmReturn_t st;
     dcgmFieldValue_v2 powerUsage;
 
-    st = m_dcgmRecorder.GetCurrentFieldValue(m_device->gpuId, DCGM_FI_DEV_POWER_USAGE, powerUsage, 0);
+    /* Read from the driver rather than the cache so the controller isn't limited to the watch frequency */
+    st = m_dcgmRecorder.GetCurrentFieldValue(
+        m_device->gpuId, DCGM_FI_DEV_POWER_USAGE, powerUsage, DCGM_FV_FLAG_LIVE_DATA);
     if (st)
     {
         // We do not add a warning or stop the test because we want to allow some tolerance for when we cannot
@@ -848,19 +845,9 @@ double ConstantPowerWorker::ReadPower()
 }
 
 /****************************************************************************/
-double ConstantPowerWorker::PercentDiff(double a, double b)
-{
-    double retVal = a - b;
-    retVal /= (a + b);
-    retVal *= 200.0;
-    return retVal;
-}
-
-/****************************************************************************/
-int ConstantPowerWorker::RecalcMatrixDim(int currentMatrixDim, double power)
+int ConstantPowerWorker::RecalcMatrixDim(double power, double dt)
 {
-    int matrixDim;
-    double pctDiff, workPctDiff;
+    const double maxLogWork = 2.0 * log((double)TP_MAX_DIMENSION);
 
     /* if we're targeting close to max power, just go for it  */
     if (m_targetPower >= (0.90 * m_device->maxPowerTarget))
@@ -868,54 +855,21 @@ int ConstantPowerWorker::RecalcMatrixDim(int currentMatrixDim, double power)
         return TP_MAX_DIMENSION;
     }
 
-    pctDiff = PercentDiff(power, m_targetPower);
-
-    matrixDim = currentMatrixDim;
-
-    /* If we are below our target power, set a floor so that we never go below this matrix size */
-    if (pctDiff < 0.0)
-    {
-        m_device->minMatrixDim = MAX(currentMatrixDim, m_device->minMatrixDim);
-        PRINT_DEBUG("%d %d", "device %u, minMatrixDim: %d\n", m_device->gpuId, currentMatrixDim);
-    }
-
-    /* Ramp up */
-    if (!m_device->onlySmallAdjustments && pctDiff <= -50.0)
-    {
-        matrixDim += 20; /* Ramp up */
-    }
-    else if (!m_device->onlySmallAdjustments && (pctDiff <= -5.0 || pctDiff >= 5.0))
-    {
-        /* Try to guess jump in load based on pct change desired and pct change in matrix ops */
-        if (pctDiff < 0.0)
-        {
-            for (workPctDiff = 0.0; workPctDiff < (-pctDiff) && matrixDim < TP_MAX_DIMENSION; matrixDim++)
-            {
-                workPctDiff = PercentDiff(matrixDim * matrixDim, currentMatrixDim * currentMatrixDim);
-                // printf("loop pctdiff %.2f. workPctDiff %.2f\n", pctDiff, workPctDiff);
-            }
-        }
-        else
-        {
-            for (workPctDiff = 0.0; workPctDiff > (-pctDiff) && matrixDim > m_device->minMatrixDim; matrixDim--)
-            {
-                workPctDiff = PercentDiff(matrixDim * matrixDim, currentMatrixDim * currentMatrixDim);
-                // printf("loop2 pctdiff %.2f. workPctDiff %.2f\n", pctDiff, workPctDiff);
-            }
-        }
-    }
-    else if (pctDiff < 0.0)
-    {
-        matrixDim++; /* Very small adjustment */
-        // m_device->onlySmallAdjustments = 1; /* Continue to make large adjustments if need be */
-    }
-    else
+    /* Hold the current work if we couldn't read the power */
+    if (power >= 0.0)
     {
-        matrixDim--; /* Very small adjustment */
-        // m_device->onlySmallAdjustments = 1; /* Continue to make large adjustments if need be */
+        /* Smooth out sample to sample noise without adding much lag at the controller's update rate */
+        m_filteredPower = (m_filteredPower < 0.0) ? power : 0.5 * (m_filteredPower + power);
+
+        /* Limit each step to a 1.6x change in work so a long interval on a slow SKU can't overshoot wildly */
+        double error = (m_targetPower - m_filteredPower) / m_targetPower;
+        double step  = m_kp * (error - m_lastError) + m_ki * error * dt;
+        m_logWork += std::min(std::max(step, -0.5), 0.5);
+        m_logWork   = std::min(std::max(m_logWork, 0.0), maxLogWork);
+        m_lastError = error;
     }
 
-    // printf("pctdiff %.2f\n", pctDiff);
+    int matrixDim = (int)(exp(m_logWork / 2.0) + 0.5);
 
     if (matrixDim < 1)
     {
@@ -1049,7 +1003,7 @@ void ConstantPowerWorker::run()
         if (now - lastAdjustTime > m_reAdjustInterval)
         {
             power          = ReadPower();
-            matrixDim      = RecalcMatrixDim(matrixDim, power);
+            matrixDim      = RecalcMatrixDim(power, lastAdjustTime > 0.0 ? now - lastAdjustTime : m_reAdjustInterval);
             lastAdjustTime = now;
         }
 
@@ -1057,12 +1011,12 @@ void ConstantPowerWorker::run()
         if (now - lastPrintTime > m_printInterval)
         {
             power = ReadPower();
-            PRINT_DEBUG("%d %f %d %d",
-                        "DeviceIdx %d, Power %.2f W. dim: %d. minDim: %d\n",
+            PRINT_DEBUG("%d %f %d %f",
+                        "DeviceIdx %d, Power %.2f W. dim: %d. filtered power: %.2f W\n",
                         m_device->gpuId,
                         power,
                         matrixDim,
-                        m_device->minMatrixDim);
+                        m_filteredPower);
             lastPrintTime = now;
         }
         /* Time to check for failure? */
@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "CudaCommon.h"
+#include "CudaResources.h"
 #include "DcgmError.h"
 #include "DcgmRecorder.h"
 #include "Plugin.h"
@@ -54,18 +55,8 @@ public:
     int NcudaStreams;                                   /* Number of cudaStream[] entries that are valid */
     cudaStream_t cudaStream[TP_MAX_STREAMS_PER_DEVICE]; /* Cuda streams */
 
-    int allocatedCublasHandle;   /* Have we allocated cublasHandle yet? */
     cublasHandle_t cublasHandle; /* Handle to cuBlas */
 
-    /* Minimum adjusted value for our matrix dimension. 1 <= X <= MAX_DIMENSION */
-    int minMatrixDim;
-
-    /* Should we only make small adjustments in matrix size? This is set to 1 after
-     * cp_recalc_matrix_dim has gotten close enough that it thinks it's in the right
-     * range
-     */
-    int onlySmallAdjustments;
-
     /* Device pointers */
     void *deviceA;
     void *deviceB;
@@ -79,10 +70,7 @@ public:
         : PluginDevice(ndi, pciBusId, p)
         , maxPowerTarget(0)
         , NcudaStreams(0)
-        , allocatedCublasHandle(0)
         , cublasHandle(0)
-        , minMatrixDim(0)
-        , onlySmallAdjustments(0)
         , deviceA(0)
         , deviceB(0)
         , NdeviceC(0)
@@ -94,14 +82,6 @@ public:
 
     ~CPDevice()
     {
-        using namespace Dcgm;
-        if (allocatedCublasHandle)
-        {
-            CublasProxy::CublasDestroy(cublasHandle);
-            cublasHandle          = 0;
-            allocatedCublasHandle = 0;
-        }
-
         for (int i = 0; i < NcudaStreams; i++)
         {
             cudaError_t cuSt = cudaStreamDestroy(cudaStream[i]);
@@ -113,24 +93,22 @@ public:
 
         NcudaStreams = 0;
 
-        if (deviceA)
-        {
-            cudaFree(deviceA);
-            deviceA = 0;
-        }
-        if (deviceB)
+        FreeDeviceMemory(deviceA);
+        FreeDeviceMemory(deviceB);
+
+        for (int i = 0; i < NdeviceC; i++)
         {
-            cudaFree(deviceB);
-            deviceB = 0;
+            FreeDeviceMemory(deviceC[i]);
         }
+    }
 
-        for (int i = 0; i < NdeviceC; i++)
+    /* Return a device pointer to the CudaResources pool */
+    void FreeDeviceMemory(void *&devicePtr)
+    {
+        if (devicePtr)
         {
-            if (deviceC[i])
-            {
-                cudaFree(deviceC[i]);
-                deviceC[i] = 0;
-            }
+            CudaResources::Instance().Free(cudaDeviceIdx, (CUdeviceptr)devicePtr);
+            devicePtr = 0;
         }
     }
 };
@@ -36,13 +36,15 @@ dcgmReturn_t GetPluginInfo(unsigned int pluginInterfaceVersion, dcgmDiagPluginIn
                                      TS_STR_MAX_MEMORY_CLOCK,
                                      TS_STR_MAX_GRAPHICS_CLOCK,
                                      TS_STR_SBE_ERROR_THRESHOLD,
+                                     TS_STR_TENSOR_PRECISION,
+                                     TS_STR_TENSOR_TARGET_PERF,
                                      nullptr };
 
     const dcgmPluginValue_t paramTypes[]
-        = { DcgmPluginParamInt,  DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamFloat,
-            DcgmPluginParamBool, DcgmPluginParamBool,  DcgmPluginParamInt,   DcgmPluginParamInt,
-            DcgmPluginParamInt,  DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamInt,
-            DcgmPluginParamNone };
+        = { DcgmPluginParamInt,    DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamFloat,
+            DcgmPluginParamBool,   DcgmPluginParamBool,  DcgmPluginParamInt,   DcgmPluginParamInt,
+            DcgmPluginParamInt,    DcgmPluginParamFloat, DcgmPluginParamFloat, DcgmPluginParamInt,
+            DcgmPluginParamString, DcgmPluginParamFloat, DcgmPluginParamNone };
     DCGM_CASSERT(sizeof(parameterNames) / sizeof(const char *) == sizeof(paramTypes) / sizeof(const dcgmPluginValue_t),
                  1);
 
@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include "TargetedStress_wrapper.h"
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -34,6 +35,7 @@ ConstantPerf::ConstantPerf(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuInfo
     , m_testDuration(.0)
     , m_targetPerf(.0)
     , m_useDgemm(0)
+    , m_tensorType(TensorGemmType::None)
     , m_atATime(0)
     , m_sbeFailureThreshold(.0)
     , m_handle(handle)
@@ -59,6 +61,8 @@ ConstantPerf::ConstantPerf(dcgmHandle_t handle, dcgmDiagPluginGpuList_t *gpuInfo
     m_testParameters->AddDouble(TS_STR_MAX_MEMORY_CLOCK, 0.0, 0.0, 100000.0);
     m_testParameters->AddDouble(TS_STR_MAX_GRAPHICS_CLOCK, 0.0, 0.0, 100000.0);
     m_testParameters->AddDouble(TS_STR_SBE_ERROR_THRESHOLD, DCGM_FP64_BLANK, 0.0, DCGM_FP64_BLANK);
+    m_testParameters->AddString(TS_STR_TENSOR_PRECISION, "None");
+    m_testParameters->AddDouble(TS_STR_TENSOR_TARGET_PERF, 0.0, 0.0, 100000.0);
     m_testParameters->AddString(PS_LOGFILE, "stats_targeted_stress.json");
     m_testParameters->AddDouble(PS_LOGFILE_TYPE, 0.0, NVVS_LOGFILE_TYPE_JSON, NVVS_LOGFILE_TYPE_BINARY);
     m_infoStruct.defaultTestParameters = new TestParameters(*m_testParameters);
@@ -103,25 +107,13 @@ void ConstantPerf::Cleanup()
     }
     m_dcgmRecorderInitialized = false;
 
-    /* Unload our cuda context for each gpu in the current process. We enumerate all GPUs because
-       cuda opens a context on all GPUs, even if we don't use them */
-    int cudaDeviceCount;
-    cudaError_t cuSt;
-    cuSt = cudaGetDeviceCount(&cudaDeviceCount);
-    if (cuSt == cudaSuccess)
-    {
-        for (int deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
-        {
-            cudaSetDevice(deviceIdx);
-            cudaDeviceReset();
-        }
-    }
+    /* See CudaResources::ResetDevices() */
+    CudaResources::Instance().ResetDevices();
 }
 
 /*****************************************************************************/
 bool ConstantPerf::Init(dcgmDiagPluginGpuList_t *gpuInfo)
 {
-    cudaError_t cuSt;
     CPerfDevice *cpDevice = 0;
 
     if (gpuInfo == nullptr)
@@ -132,18 +124,8 @@ bool ConstantPerf::Init(dcgmDiagPluginGpuList_t *gpuInfo)
 
     m_gpuInfo = *gpuInfo;
 
-    /* Attach to every device by index and reset it in case a previous plugin
-       didn't clean up after itself */
-    int cudaDeviceCount;
-    cuSt = cudaGetDeviceCount(&cudaDeviceCount);
-    if (cuSt == cudaSuccess)
-    {
-        for (int deviceIdx = 0; deviceIdx < cudaDeviceCount; deviceIdx++)
-        {
-            cudaSetDevice(deviceIdx);
-            cudaDeviceReset();
-        }
-    }
+    /* See CudaResources::ResetDevices() */
+    CudaResources::Instance().ResetDevices();
 
     for (unsigned int gpuListIndex = 0; gpuListIndex < gpuInfo->numGpus; gpuListIndex++)
     {
@@ -167,7 +149,6 @@ bool ConstantPerf::Init(dcgmDiagPluginGpuList_t *gpuInfo)
 /*****************************************************************************/
 int ConstantPerf::CudaInit()
 {
-    using namespace Dcgm;
     cudaError_t cuSt;
     int i, j, count, valueSize;
     size_t arrayByteSize, arrayNelem;
@@ -182,7 +163,12 @@ int ConstantPerf::CudaInit()
         return -1;
     }
 
-    if (m_useDgemm)
+    if (m_tensorType != TensorGemmType::None)
+    {
+        /* The result of every tensor core GEMM is 4 bytes wide, and never smaller than the inputs */
+        valueSize = sizeof(float);
+    }
+    else if (m_useDgemm)
     {
         valueSize = sizeof(double);
     }
@@ -302,7 +288,13 @@ int ConstantPerf::CudaInit()
                 return -1;
             }
 
-            if (m_useDgemm)
+            if (m_tensorType != TensorGemmType::None)
+            {
+                TensorGemmFillRandom(m_tensorType, cpStream->hostA, arrayNelem);
+                TensorGemmFillRandom(m_tensorType, cpStream->hostB, arrayNelem);
+                memset(cpStream->hostC, 0, arrayByteSize);
+            }
+            else if (m_useDgemm)
             {
                 double *doubleHostA = (double *)cpStream->hostA;
                 double *doubleHostB = (double *)cpStream->hostB;
@@ -334,37 +326,27 @@ int ConstantPerf::CudaInit()
         }
 
         /* Initialize cublas */
-        cubSt = CublasProxy::CublasCreate(&device->cublasHandle);
+        cubSt = CudaResources::Instance().GetCublasHandle(device->cudaDeviceIdx, device->cublasHandle);
         if (cubSt != CUBLAS_STATUS_SUCCESS)
         {
             LOG_CUBLAS_ERROR("cublasCreate", cubSt, device->gpuId);
             return -1;
         }
-        device->allocatedCublasHandle = 1;
 
         for (i = 0; i < device->Nstreams; i++)
         {
             cperf_stream_p cpStream = &device->streams[i];
 
-            cuSt = cudaMalloc((void **)&cpStream->deviceA, arrayByteSize);
-            if (cuSt != cudaSuccess)
-            {
-                LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
-                return -1;
-            }
-
-            cuSt = cudaMalloc((void **)&cpStream->deviceB, arrayByteSize);
-            if (cuSt != cudaSuccess)
-            {
-                LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
-                return -1;
-            }
-
-            cuSt = cudaMalloc((void **)&cpStream->deviceC, arrayByteSize);
-            if (cuSt != cudaSuccess)
+            for (void **devicePtr : { &cpStream->deviceA, &cpStream->deviceB, &cpStream->deviceC })
             {
-                LOG_CUDA_ERROR("cudaMalloc", cuSt, device->gpuId, arrayByteSize);
-                return -1;
+                CUdeviceptr ptr;
+                CUresult cuRes = CudaResources::Instance().Allocate(device->cudaDeviceIdx, arrayByteSize, ptr);
+                if (cuRes != CUDA_SUCCESS)
+                {
+                    LOG_CUDA_ERROR("cuMemAlloc", cuRes, device->gpuId, arrayByteSize);
+                    return -1;
+                }
+                *devicePtr = (void *)ptr;
             }
         }
     }
@@ -404,6 +386,7 @@ void ConstantPerf::Go(unsigned int numParameters, const dcgmDiagPluginTestParame
     m_targetPerf          = m_testParameters->GetDouble(TS_STR_TARGET_PERF);
     m_atATime             = m_testParameters->GetDouble(TS_STR_CUDA_OPS_PER_STREAM);
     m_sbeFailureThreshold = m_testParameters->GetDouble(TS_STR_SBE_ERROR_THRESHOLD);
+    SelectTensorType();
 
     result = RunTest();
     if (main_should_stop)
@@ -420,6 +403,56 @@ void ConstantPerf::Go(unsigned int numParameters, const dcgmDiagPluginTestParame
     }
 }
 
+/*****************************************************************************/
+void ConstantPerf::SelectTensorType()
+{
+    std::string tensorPrecision = m_testParameters->GetString(TS_STR_TENSOR_PRECISION);
+    std::stringstream ss;
+
+    m_tensorType = TensorGemmType::None;
+    if (!ParseTensorGemmType(tensorPrecision, m_tensorType))
+    {
+        ss << "Ignoring unknown " << TS_STR_TENSOR_PRECISION << " '" << tensorPrecision << "'";
+        AddInfo(ss.str());
+        return;
+    }
+
+    if (m_tensorType == TensorGemmType::None)
+    {
+        return;
+    }
+
+    double tensorTargetPerf = m_testParameters->GetDouble(TS_STR_TENSOR_TARGET_PERF);
+    if (tensorTargetPerf <= 0.0)
+    {
+        ss << TensorGemmTypeName(m_tensorType) << " tensor core GEMMs have no " << TS_STR_TENSOR_TARGET_PERF
+           << " for this SKU. Running " << (m_useDgemm ? "DGEMM" : "SGEMM") << " instead.";
+        AddInfo(ss.str());
+        m_tensorType = TensorGemmType::None;
+        return;
+    }
+
+    for (size_t deviceIdx = 0; deviceIdx < m_device.size(); deviceIdx++)
+    {
+        CPerfDevice *device = m_device[deviceIdx];
+        int major           = 0;
+        int minor           = 0;
+
+        if (cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device->cudaDeviceIdx) != cudaSuccess
+            || cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device->cudaDeviceIdx) != cudaSuccess
+            || !TensorGemmSupported(m_tensorType, major, minor))
+        {
+            ss << "GPU " << device->gpuId << " can't run " << TensorGemmTypeName(m_tensorType)
+               << " tensor core GEMMs. Running " << (m_useDgemm ? "DGEMM" : "SGEMM") << " instead.";
+            AddInfo(ss.str());
+            m_tensorType = TensorGemmType::None;
+            return;
+        }
+    }
+
+    m_targetPerf = tensorTargetPerf;
+}
+
 /*****************************************************************************/
 bool ConstantPerf::CheckGpuPerf(CPerfDevice *device,
                                 std::vector<DcgmError> &errorList,
@@ -541,6 +574,7 @@ private:
     ConstantPerf &m_plugin;            /* ConstantPerf plugin for logging and failure checks */
     TestParameters *m_testParameters;  /* Read-only test parameters */
     int m_useDgemm;                    /* Wheter to use dgemm (1) or sgemm (0) for operations */
+    TensorGemmType m_tensorType;       /* Tensor core GEMM to use instead, if not None */
     double m_targetPerf;               /* Target stress in gflops */
     double m_testDuration;             /* Target test duration in seconds */
     timelib64_t m_stopTime;            /* Timestamp when run() finished */
@@ -734,7 +768,12 @@ ConstantPerfWorker::ConstantPerfWorker(CPerfDevice *device,
     , m_failCheckInterval(failCheckInterval)
 {
     m_useDgemm     = tp->GetBoolFromString(TS_STR_USE_DGEMM);
+    m_tensorType   = plugin.GetTensorType();
     m_targetPerf   = tp->GetDouble(TS_STR_TARGET_PERF);
+    if (m_tensorType != TensorGemmType::None)
+    {
+        m_targetPerf = tp->GetDouble(TS_STR_TENSOR_TARGET_PERF);
+    }
     m_testDuration = tp->GetDouble(TS_STR_TEST_DURATION);
     m_atATime      = tp->GetDouble(TS_STR_CUDA_OPS_PER_STREAM);
 }
@@ -793,12 +832,16 @@ int ConstantPerfWorker::QueueOne(int streamIdx,
                                  double *doubleBeta)
 {
     using namespace Dcgm;
-    int valueSize, arrayByteSize;
+    int valueSize, arrayByteSize, inputByteSize;
     cudaError_t cuSt;
     cublasStatus_t cubSt;
     cperf_stream_p cpStream = &m_device->streams[streamIdx];
 
-    if (m_useDgemm)
+    if (m_tensorType != TensorGemmType::None)
+    {
+        valueSize = sizeof(float);
+    }
+    else if (m_useDgemm)
     {
         valueSize = sizeof(double);
     }
@@ -808,6 +851,11 @@ int ConstantPerfWorker::QueueOne(int streamIdx,
     }
 
     arrayByteSize = valueSize * TS_TEST_DIMENSION * TS_TEST_DIMENSION;
+    inputByteSize = arrayByteSize;
+    if (m_tensorType != TensorGemmType::None)
+    {
+        inputByteSize = TensorGemmInputSize(m_tensorType) * TS_TEST_DIMENSION * TS_TEST_DIMENSION;
+    }
 
     cuSt = cudaEventRecord(cpStream->beforeCopyH2D[opIdx], cpStream->cudaStream);
     if (cuSt != cudaSuccess)
@@ -818,17 +866,17 @@ int ConstantPerfWorker::QueueOne(int streamIdx,
 
     /* Copy the host arrays to the device arrays */
     cuSt = cudaMemcpyAsync(
-        cpStream->deviceA, cpStream->hostA, arrayByteSize, cudaMemcpyHostToDevice, cpStream->cudaStream);
+        cpStream->deviceA, cpStream->hostA, inputByteSize, cudaMemcpyHostToDevice, cpStream->cudaStream);
     if (cuSt != cudaSuccess)
     {
-        LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cudaMemcpyAsync", cuSt, m_device->gpuId, arrayByteSize);
+        LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cudaMemcpyAsync", cuSt, m_device->gpuId, inputByteSize);
         return -1;
     }
     cuSt = cudaMemcpyAsync(
-        cpStream->deviceB, cpStream->hostB, arrayByteSize, cudaMemcpyHostToDevice, cpStream->cudaStream);
+        cpStream->deviceB, cpStream->hostB, inputByteSize, cudaMemcpyHostToDevice, cpStream->cudaStream);
     if (cuSt != cudaSuccess)
     {
-        LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cudaMemcpyAsync", cuSt, m_device->gpuId, arrayByteSize);
+        LOG_CUDA_ERROR_FOR_PLUGIN(&m_plugin, "cudaMemcpyAsync", cuSt, m_device->gpuId, inputByteSize);
         return -1;
     }
 
@@ -846,7 +894,23 @@ int ConstantPerfWorker::QueueOne(int streamIdx,
         return -1;
     }
 
-    if (m_useDgemm)
+    if (m_tensorType != TensorGemmType::None)
+    {
+        cubSt = TensorGemm(m_device->cublasHandle,
+                           m_tensorType,
+                           TS_TEST_DIMENSION,
+                           cpStream->deviceA,
+                           cpStream->deviceB,
+                           cpStream->deviceC,
+                           *doubleAlpha,
+                           *doubleBeta);
+        if (cubSt != CUBLAS_STATUS_SUCCESS)
+        {
+            LOG_CUBLAS_ERROR_FOR_PLUGIN(&m_plugin, "cublasGemmEx", cubSt, m_device->gpuId);
+            return -1;
+        }
+    }
+    else if (m_useDgemm)
     {
         cubSt = CublasProxy::CublasDgemm(m_device->cublasHandle,
                                          CUBLAS_OP_N,
@@ -943,7 +1007,13 @@ void ConstantPerfWorker::run(void)
         valueSize = sizeof(float);
     }
 
+    /* A and B in the input type, C in 4-byte results */
     double copyBytesPerOp = 3.0 * (double)valueSize * (double)TS_TEST_DIMENSION * (double)TS_TEST_DIMENSION;
+    if (m_tensorType != TensorGemmType::None)
+    {
+        copyBytesPerOp = (2.0 * TensorGemmInputSize(m_tensorType) + sizeof(float)) * (double)TS_TEST_DIMENSION
+                         * (double)TS_TEST_DIMENSION;
+    }
     double flopsPerOp     = 2.0 * (double)TS_TEST_DIMENSION * (double)TS_TEST_DIMENSION * (double)TS_TEST_DIMENSION;
     double opsPerSec      = m_targetPerf / (flopsPerOp / 1000000000.0);
     long long maxOpsSoFar;
@@ -955,8 +1025,10 @@ void ConstantPerfWorker::run(void)
     floatAlpha  = (float)doubleAlpha;
     floatBeta   = (float)doubleBeta;
 
-    std::string gflopsKey;
-    gflopsKey = std::string(PERF_STAT_NAME);
+    CustomStatHolder &statHolder = m_plugin.GetCustomStatHolder();
+    CustomGpuStatBuffer stats(statHolder, m_device->gpuId);
+    customStatHandle_t perfStat = statHolder.RegisterStat(PERF_STAT_NAME);
+    customStatHandle_t nopsStat = statHolder.RegisterStat("nops_so_far");
 
     /* Record some of our static calculated parameters in case we need them for debugging */
     m_plugin.SetGpuStat(m_device->gpuId, std::string("flops_per_op"), flopsPerOp);
@@ -1054,8 +1126,8 @@ void ConstantPerfWorker::run(void)
             elapsed       = now - startTime;
             double gflops = (flopsPerOp * (double)Nops) / (1000000000.0 * elapsed);
 
-            m_plugin.SetGpuStat(m_device->gpuId, gflopsKey, gflops);
-            m_plugin.SetGpuStat(m_device->gpuId, "nops_so_far", (long long)Nops);
+            stats.Append(perfStat, gflops);
+            stats.Append(nopsStat, (long long)Nops);
             ss.str("");
             ss << "DeviceIdx " << m_device->gpuId << ", ops " << Nops << ", gflops " << gflops;
             m_plugin.AddInfo(ss.str());
@@ -1064,6 +1136,7 @@ void ConstantPerfWorker::run(void)
         /* Time to check for failure? */
         if (m_failEarly && now - lastFailureCheckTime > m_failCheckInterval)
         {
+            stats.Flush();
             bool result = m_plugin.CheckPassFailSingleGpu(
                 m_device, errorList, lastFailureCheckTime * 1000000, now * 1000000, false);
             if (!result)
@@ -22,11 +22,13 @@
 #include <vector>
 
 #include "CudaCommon.h"
+#include "CudaResources.h"
 #include "DcgmError.h"
 #include "DcgmRecorder.h"
 #include "Plugin.h"
 #include "PluginCommon.h"
 #include "PluginDevice.h"
+#include "TensorGemm.h"
 
 #include <DcgmRecorder.h>
 #include <NvvsStructs.h>
@@ -96,7 +98,6 @@ public:
     int Nstreams; /* Number of stream[] entries that are valid */
     cperf_stream_t streams[TS_MAX_STREAMS_PER_DEVICE];
 
-    int allocatedCublasHandle;   /* Have we allocated cublasHandle yet? */
     cublasHandle_t cublasHandle; /* Handle to cuBlas */
 
     /* Timing accumulators */
@@ -106,7 +107,6 @@ public:
     CPerfDevice(unsigned int ndi, const char *pciBusId, Plugin *p)
         : PluginDevice(ndi, pciBusId, p)
         , Nstreams(0)
-        , allocatedCublasHandle(0)
         , cublasHandle(0)
         , usecInCopies(.0)
         , usecInGemm(.0)
@@ -116,14 +116,6 @@ public:
 
     ~CPerfDevice()
     {
-        using namespace Dcgm;
-        if (allocatedCublasHandle)
-        {
-            CublasProxy::CublasDestroy(cublasHandle);
-            cublasHandle          = 0;
-            allocatedCublasHandle = 0;
-        }
-
         for (int i = 0; i < Nstreams; i++)
         {
             cperf_stream_p cpStream = &streams[i];
@@ -151,20 +143,13 @@ public:
                 cpStream->hostC = 0;
             }
 
-            if (cpStream->deviceA)
-            {
-                cudaFree(cpStream->deviceA);
-                cpStream->deviceA = 0;
-            }
-            if (cpStream->deviceB)
+            for (void **devicePtr : { &cpStream->deviceA, &cpStream->deviceB, &cpStream->deviceC })
             {
-                cudaFree(cpStream->deviceB);
-                cpStream->deviceB = 0;
-            }
-            if (cpStream->deviceC)
-            {
-                cudaFree(cpStream->deviceC);
-                cpStream->deviceC = 0;
+                if (*devicePtr)
+                {
+                    CudaResources::Instance().Free(cudaDeviceIdx, (CUdeviceptr)*devicePtr);
+                    *devicePtr = 0;
+                }
             }
 
             for (int j = 0; j < cpStream->NeventsInitalized; j++)
@@ -207,6 +192,14 @@ public:
                                 timelib64_t earliestStopTime,
                                 bool testFinished = true);
 
+    /*************************************************************************/
+    /*
+     * Tensor core GEMM the worker threads should queue instead of S/Dgemm, or TensorGemmType::None
+     */
+    TensorGemmType GetTensorType() const
+    {
+        return m_tensorType;
+    }
 
     /*************************************************************************/
 
@@ -229,6 +222,16 @@ private:
      */
     int CudaInit();
 
+    /*************************************************************************/
+    /*
+     * Decide whether the tensor core GEMMs requested by tensor_precision can run. They need a
+     * tensor_target_stress for the SKU and tensor cores of that type on every GPU; otherwise the test
+     * falls back to S/Dgemm and target_stress.
+     *
+     * Sets m_tensorType and m_targetPerf
+     */
+    void SelectTensorType();
+
     /*************************************************************************/
     /*
      * Runs the Targeted Stress test
@@ -281,6 +284,7 @@ private:
     double m_testDuration;        /* Test duration in seconds */
     double m_targetPerf;          /* Performance we are trying to target in gigaflops */
     int m_useDgemm;               /* Whether or not to use dgemm (or sgemm) 1=use dgemm */
+    TensorGemmType m_tensorType;  /* Tensor core GEMM to use instead, if not None */
     int m_atATime;                /* Number of ops to queue to the stream at a time */
     double m_sbeFailureThreshold; /* how many SBEs constitutes a failure */
     dcgmHandle_t m_handle;        /* Dcgm handle*/
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <unordered_set>
@@ -196,13 +197,15 @@ bool ConfigFileParser_v2::Init()
 {
     if (m_inputstream.is_open())
         m_inputstream.close();
+    m_configContents.clear();
 
     m_inputstream.open(m_configFile.c_str());
     if (!m_inputstream.good())
     {
         return false;
     }
-    m_yamltoplevelnode = YAML::Load(m_inputstream);
+    m_configContents.assign(std::istreambuf_iterator<char>(m_inputstream), std::istreambuf_iterator<char>());
+    m_yamltoplevelnode = YAML::Load(m_configContents);
 
 
     return true;
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include <CustomStatHolder.h>
+#include <algorithm>
+#include <set>
 #include <timelib.h>
 
 CustomStatHolder::CustomStatHolder()
@@ -21,9 +23,12 @@ CustomStatHolder::CustomStatHolder()
     , m_gpuData()
     , m_groupedData()
     , m_groupSingleData()
+    , m_statNames()
+    , m_statHandles()
     , m_groupedDataMutex(0)
     , m_gpuDataMutex(0)
     , m_groupSingleDataMutex(0)
+    , m_statNamesMutex(0)
     , m_currentlyIterating(false)
     , m_statPopulationType(0)
 {}
@@ -130,6 +135,45 @@ dcgmReturn_t CustomStatHolder::InsertCustomData(unsigned int gpuId, const std::s
     return DCGM_ST_OK;
 }
 
+customStatHandle_t CustomStatHolder::RegisterStat(const std::string &name)
+{
+    DcgmLockGuard lock(&m_statNamesMutex);
+    auto it = m_statHandles.find(name);
+    if (it != m_statHandles.end())
+    {
+        return it->second;
+    }
+
+    customStatHandle_t handle = m_statNames.size();
+    m_statNames.push_back(name);
+    m_statHandles[name] = handle;
+    return handle;
+}
+
+void CustomStatHolder::MergeGpuStats(unsigned int gpuId, std::vector<std::vector<dcgmTimeseriesInfo_t>> &valuesByHandle)
+{
+    DcgmLockGuard namesLock(&m_statNamesMutex);
+    DcgmLockGuard lock(&m_gpuDataMutex);
+    if (m_currentlyIterating)
+    {
+        DCGM_LOG_ERROR << "Cannot insert data because we're in the middle of reporting on the data";
+        return;
+    }
+
+    for (customStatHandle_t handle = 0; handle < valuesByHandle.size() && handle < m_statNames.size(); handle++)
+    {
+        std::vector<dcgmTimeseriesInfo_t> &values = valuesByHandle[handle];
+        if (values.empty())
+        {
+            continue;
+        }
+
+        std::vector<dcgmTimeseriesInfo_t> &stat = m_gpuData[gpuId][m_statNames[handle]];
+        stat.insert(stat.end(), values.begin(), values.end());
+        values.clear();
+    }
+}
+
 dcgmReturn_t CustomStatHolder::InsertSingleData(const std::string &gpuId,
                                                 const std::string &name,
                                                 const std::string &value)
@@ -197,6 +241,103 @@ void CustomStatHolder::AddGroupedDataToJson(Json::Value &jv)
     }
 }
 
+void CustomStatHolder::WriteTimeseriesVector(JsonStreamWriter &writer, const std::vector<dcgmTimeseriesInfo_t> &vec)
+{
+    writer.StartArray();
+    for (auto const &data : vec)
+    {
+        writer.StartObject();
+        writer.Key("timestamp");
+        writer.Value(static_cast<int64_t>(data.timestamp));
+        writer.Key("value");
+        if (data.isInt)
+        {
+            writer.Value(static_cast<int64_t>(data.val.i64));
+        }
+        else
+        {
+            writer.Value(data.val.fp64);
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+}
+
+void CustomStatHolder::WriteGpuDataJson(unsigned int gpuId, JsonStreamWriter &writer)
+{
+    DcgmLockGuard lock(&m_gpuDataMutex);
+    auto gpuIt = m_gpuData.find(gpuId);
+    if (gpuIt == m_gpuData.end())
+    {
+        return;
+    }
+
+    for (auto const &[name, vec] : gpuIt->second)
+    {
+        writer.Key(name);
+        WriteTimeseriesVector(writer, vec);
+    }
+}
+
+void CustomStatHolder::WriteNonGpuDataJson(JsonStreamWriter &writer)
+{
+    // A name can be used by both single and grouped stats; they have to share one object then
+    DcgmLockGuard singleLock(&m_groupSingleDataMutex);
+    DcgmLockGuard groupedLock(&m_groupedDataMutex);
+
+    std::set<std::string> names;
+    for (auto const &entry : m_groupSingleData)
+    {
+        names.insert(entry.first);
+    }
+    for (auto const &entry : m_groupedData)
+    {
+        names.insert(entry.first);
+    }
+
+    for (auto const &name : names)
+    {
+        writer.Key(name);
+        writer.StartObject();
+
+        auto singleIt = m_groupSingleData.find(name);
+        if (singleIt != m_groupSingleData.end())
+        {
+            for (auto const &[gpuId, value] : singleIt->second)
+            {
+                writer.Key(gpuId);
+                writer.Value(value);
+            }
+        }
+
+        auto groupedIt = m_groupedData.find(name);
+        if (groupedIt != m_groupedData.end())
+        {
+            for (auto const &[statName, vec] : groupedIt->second)
+            {
+                writer.Key(statName);
+                WriteTimeseriesVector(writer, vec);
+            }
+        }
+
+        writer.EndObject();
+    }
+}
+
+std::vector<unsigned int> CustomStatHolder::GetGpusWithData()
+{
+    std::vector<unsigned int> gpuIds;
+
+    DcgmLockGuard lock(&m_gpuDataMutex);
+    for (auto const &entry : m_gpuData)
+    {
+        gpuIds.push_back(entry.first);
+    }
+    std::sort(gpuIds.begin(), gpuIds.end());
+
+    return gpuIds;
+}
+
 std::vector<dcgmTimeseriesInfo_t> CustomStatHolder::GetGroupedStat(const std::string &groupName,
                                                                    const std::string &name)
 {
@@ -538,3 +679,52 @@ void CustomStatHolder::InitGpus(const std::vector<unsigned int> &gpus)
 {
     m_gpus = gpus;
 }
+
+CustomGpuStatBuffer::CustomGpuStatBuffer(CustomStatHolder &holder, unsigned int gpuId)
+    : m_holder(holder)
+    , m_gpuId(gpuId)
+    , m_values()
+{}
+
+CustomGpuStatBuffer::~CustomGpuStatBuffer()
+{
+    Flush();
+}
+
+void CustomGpuStatBuffer::Append(customStatHandle_t handle, double value)
+{
+    if (handle >= m_values.size())
+    {
+        m_values.resize(handle + 1);
+    }
+
+    dcgmTimeseriesInfo_t data {};
+    data.val.fp64  = value;
+    data.isInt     = false;
+    data.timestamp = timelib_usecSince1970();
+    m_values[handle].push_back(data);
+}
+
+void CustomGpuStatBuffer::Append(customStatHandle_t handle, long long value)
+{
+    if (handle >= m_values.size())
+    {
+        m_values.resize(handle + 1);
+    }
+
+    dcgmTimeseriesInfo_t data {};
+    data.val.i64   = value;
+    data.isInt     = true;
+    data.timestamp = timelib_usecSince1970();
+    m_values[handle].push_back(data);
+}
+
+void CustomGpuStatBuffer::Flush()
+{
+    if (m_values.empty())
+    {
+        return;
+    }
+
+    m_holder.MergeGpuStats(m_gpuId, m_values);
+}
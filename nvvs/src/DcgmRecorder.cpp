@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
@@ -67,7 +68,9 @@ DcgmRecorder::DcgmRecorder(DcgmRecorder &&other) noexcept
     , m_dcgmSystem(other.m_dcgmSystem)
     , m_valuesHolder(other.m_valuesHolder)
     , m_nextValuesSinceTs(other.m_nextValuesSinceTs)
-{}
+{
+    other.m_fieldGroupId = 0;
+}
 
 DcgmRecorder::~DcgmRecorder()
 {
@@ -115,6 +118,7 @@ std::string DcgmRecorder::AddWatches(const std::vector<unsigned short> &fieldIds
     if (errStr.size() != 0)
         return errStr;
 
+    // The group's field group is only used to read back the history of every field
     ret = m_dcgmGroup.FieldGroupCreate(fieldIds, fieldGroupName);
     if (ret != DCGM_ST_OK)
     {
@@ -122,7 +126,27 @@ std::string DcgmRecorder::AddWatches(const std::vector<unsigned short> &fieldIds
         return errStr;
     }
 
-    ret = m_dcgmGroup.WatchFields(defaultFrequency, testDuration + 30);
+    double keepAge                            = testDuration + 30;
+    std::vector<unsigned short> watchFieldIds = GetUnwatchedFieldIds(fieldIds, gpuIds, keepAge);
+    if (watchFieldIds.empty())
+    {
+        DCGM_LOG_DEBUG << "All " << fieldIds.size() << " fields of " << fieldGroupName
+                       << " are already watched by the host engine";
+        return errStr;
+    }
+
+    char watchGroupName[128];
+    snprintf(watchGroupName, sizeof(watchGroupName), "%s_watch", fieldGroupName.c_str());
+    ret = dcgmFieldGroupCreate(
+        m_dcgmHandle.GetHandle(), watchFieldIds.size(), watchFieldIds.data(), watchGroupName, &m_fieldGroupId);
+    if (ret != DCGM_ST_OK)
+    {
+        GetErrorString(ret, errStr);
+        return errStr;
+    }
+
+    ret = dcgmWatchFields(
+        m_dcgmHandle.GetHandle(), m_dcgmGroup.GetGroupId(), m_fieldGroupId, defaultFrequency, keepAge, 0);
     if (ret != DCGM_ST_OK)
     {
         GetErrorString(ret, errStr);
@@ -131,6 +155,43 @@ std::string DcgmRecorder::AddWatches(const std::vector<unsigned short> &fieldIds
     return errStr;
 }
 
+bool DcgmRecorder::WatchCoversTest(const dcgmCacheManagerFieldInfo_t &fieldInfo,
+                                   long long frequencyUsec,
+                                   double keepAge)
+{
+    if ((fieldInfo.flags & DCGM_CMI_F_WATCHED) == 0 || fieldInfo.monitorFrequencyUsec <= 0)
+    {
+        return false;
+    }
+
+    // A max age of 0 keeps the samples as long as the GPU is there
+    return fieldInfo.monitorFrequencyUsec <= frequencyUsec
+           && (fieldInfo.maxAgeUsec == 0 || fieldInfo.maxAgeUsec >= static_cast<long long>(keepAge * 1000000));
+}
+
+std::vector<unsigned short> DcgmRecorder::GetUnwatchedFieldIds(const std::vector<unsigned short> &fieldIds,
+                                                               const std::vector<unsigned int> &gpuIds,
+                                                               double keepAge)
+{
+    std::vector<unsigned short> unwatched;
+
+    for (auto fieldId : fieldIds)
+    {
+        for (auto gpuId : gpuIds)
+        {
+            dcgmCacheManagerFieldInfo_t fieldInfo;
+            if (m_dcgmSystem.GetFieldWatchInfo(gpuId, fieldId, fieldInfo) != DCGM_ST_OK
+                || !WatchCoversTest(fieldInfo, defaultFrequency, keepAge))
+            {
+                unwatched.push_back(fieldId);
+                break;
+            }
+        }
+    }
+
+    return unwatched;
+}
+
 void DcgmRecorder::GetErrorString(dcgmReturn_t ret, std::string &err)
 {
     std::stringstream err_stream;
@@ -181,7 +242,8 @@ std::string DcgmRecorder::Shutdown()
 
     if (m_fieldGroupId != 0)
     {
-        // Ignore errors
+        // Ignore errors. Our watches are only for the test
+        dcgmUnwatchFields(m_dcgmHandle.GetHandle(), m_dcgmGroup.GetGroupId(), m_fieldGroupId);
         dcgmFieldGroupDestroy(m_dcgmHandle.GetHandle(), m_fieldGroupId);
         m_fieldGroupId = 0;
     }
@@ -279,32 +341,81 @@ dcgmReturn_t DcgmRecorder::GetFieldValuesSince(dcgm_field_entity_group_t /*entit
     return ret;
 }
 
-std::string DcgmRecorder::GetWatchedFieldsAsJson(Json::Value &jv, long long ts)
+std::string DcgmRecorder::QueryWatchedFields(long long ts)
 {
     std::string errStr;
     dcgmReturn_t ret = DCGM_ST_OK;
 
-    // Make sure we have all of our values queried
-    for (size_t i = 0; i < m_gpuIds.size(); i++)
+    if (m_gpuIds.empty() || m_fieldIds.empty())
     {
-        for (size_t j = 0; j < m_fieldIds.size(); j++)
-        {
-            ret = GetFieldValuesSince(DCGM_FE_GPU, m_gpuIds[i], m_fieldIds[j], ts, true);
+        return errStr;
+    }
 
-            if (ret != DCGM_ST_OK)
-            {
-                GetErrorString(ret, errStr);
-                return errStr;
-            }
-        }
+    // One request reads the history of every GPU and field of the group
+    ret = GetFieldValuesSince(DCGM_FE_GPU, m_gpuIds[0], m_fieldIds[0], ts, true);
+    if (ret != DCGM_ST_OK)
+    {
+        GetErrorString(ret, errStr);
     }
 
+    return errStr;
+}
+
+std::string DcgmRecorder::GetWatchedFieldsAsJson(Json::Value &jv, long long ts)
+{
+    std::string errStr = QueryWatchedFields(ts);
+    if (errStr.size() > 0)
+        return errStr;
+
     m_valuesHolder.AddToJson(jv);
     m_customStatHolder.AddCustomData(jv);
 
     return errStr;
 }
 
+/*
+ * Writes the same document as GetWatchedFieldsAsJson() straight to out, one sample at a time, so that
+ * the timeseries are never held twice
+ */
+std::string DcgmRecorder::WriteWatchedFieldsAsJson(std::ostream &out, long long ts)
+{
+    std::string errStr = QueryWatchedFields(ts);
+    if (errStr.size() > 0)
+        return errStr;
+
+    // GPUs that only have custom stats go after the ones in the run
+    std::vector<unsigned int> gpuIds = m_gpuIds;
+    for (auto gpuId : m_customStatHolder.GetGpusWithData())
+    {
+        if (std::find(gpuIds.begin(), gpuIds.end(), gpuId) == gpuIds.end())
+        {
+            gpuIds.push_back(gpuId);
+        }
+    }
+
+    JsonStreamWriter writer(out);
+    writer.StartObject();
+
+    writer.Key(GPUS);
+    writer.StartArray();
+    for (auto gpuId : gpuIds)
+    {
+        writer.StartObject();
+        writer.Key("gpuId");
+        writer.Value(static_cast<int64_t>(gpuId));
+        m_valuesHolder.WriteGpuJson(gpuId, writer);
+        m_customStatHolder.WriteGpuDataJson(gpuId, writer);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    m_customStatHolder.WriteNonGpuDataJson(writer);
+
+    writer.EndObject();
+
+    return errStr;
+}
+
 /*
  * GPUs Json is in the format:
  *
@@ -376,12 +487,9 @@ int DcgmRecorder::WriteToFile(const std::string &filename, int logFileType, long
         case NVVS_LOGFILE_TYPE_JSON:
         default:
         {
-            Json::Value jv;
-            std::string error = GetWatchedFieldsAsJson(jv, testStart);
+            std::string error = WriteWatchedFieldsAsJson(f, testStart);
 
-            if (error.size() == 0)
-                f << jv.toStyledString();
-            else
+            if (error.size() != 0)
                 f << error;
         }
 
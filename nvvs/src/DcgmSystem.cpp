@@ -156,6 +156,24 @@ dcgmReturn_t DcgmSystem::GetGpuLatestValue(unsigned int gpuId,
     return ret;
 }
 
+dcgmReturn_t DcgmSystem::GetFieldWatchInfo(unsigned int gpuId,
+                                            unsigned short fieldId,
+                                            dcgmCacheManagerFieldInfo_t &fieldInfo)
+{
+    if (m_handle == 0)
+    {
+        PRINT_ERROR("", "Cannot get field watch info without a valid DCGM handle");
+        return DCGM_ST_BADPARAM;
+    }
+
+    memset(&fieldInfo, 0, sizeof(fieldInfo));
+    fieldInfo.version = dcgmCacheManagerFieldInfo_version;
+    fieldInfo.gpuId   = gpuId;
+    fieldInfo.fieldId = fieldId;
+
+    return dcgmGetCacheManagerFieldInfo(m_handle, &fieldInfo);
+}
+
 dcgmReturn_t DcgmSystem::GetLatestValuesForGpus(const std::vector<unsigned int> &gpuIds,
                                                 std::vector<unsigned short> &fieldIds,
                                                 unsigned int flags,
@@ -17,8 +17,96 @@
 #include "DcgmError.h"
 #include "DcgmRecorder.h"
 
+#include <algorithm>
 #include <sstream>
 
+void DcgmFieldSamples::Add(const dcgmFieldValue_v1 &val)
+{
+    if (val.fieldType != DCGM_FT_INT64 && val.fieldType != DCGM_FT_DOUBLE)
+    {
+        return;
+    }
+
+    if (m_fieldType == 0)
+    {
+        m_fieldType = val.fieldType;
+    }
+    else if (val.fieldType != m_fieldType)
+    {
+        return;
+    }
+
+    Value value;
+    if (val.fieldType == DCGM_FT_INT64)
+    {
+        value.i64 = val.value.i64;
+    }
+    else
+    {
+        value.dbl = val.value.dbl;
+    }
+
+    // Values arrive in timestamp order, except for the odd latest value fetched after a values-since query
+    if (m_timestamps.empty() || val.ts >= m_timestamps.back())
+    {
+        m_timestamps.push_back(val.ts);
+        m_values.push_back(value);
+        return;
+    }
+
+    size_t index = std::upper_bound(m_timestamps.begin(), m_timestamps.end(), val.ts) - m_timestamps.begin();
+    m_timestamps.insert(m_timestamps.begin() + index, val.ts);
+    m_values.insert(m_values.begin() + index, value);
+}
+
+size_t DcgmFieldSamples::Size() const
+{
+    return m_timestamps.size();
+}
+
+unsigned short DcgmFieldSamples::GetFieldType() const
+{
+    return m_fieldType;
+}
+
+timelib64_t DcgmFieldSamples::GetTimestamp(size_t index) const
+{
+    return m_timestamps[index];
+}
+
+int64_t DcgmFieldSamples::GetInt64(size_t index) const
+{
+    return m_values[index].i64;
+}
+
+double DcgmFieldSamples::GetDouble(size_t index) const
+{
+    return m_values[index].dbl;
+}
+
+size_t DcgmFieldSamples::LowerBound(timelib64_t ts) const
+{
+    return std::lower_bound(m_timestamps.begin(), m_timestamps.end(), ts) - m_timestamps.begin();
+}
+
+void DcgmFieldSamples::GetFieldValue(size_t index, unsigned short fieldId, dcgmFieldValue_v1 &dfv) const
+{
+    memset(&dfv, 0, sizeof(dfv));
+    dfv.version   = dcgmFieldValue_version1;
+    dfv.fieldId   = fieldId;
+    dfv.fieldType = m_fieldType;
+    dfv.status    = DCGM_ST_OK;
+    dfv.ts        = m_timestamps[index];
+    if (m_fieldType == DCGM_FT_INT64)
+    {
+        dfv.value.i64 = m_values[index].i64;
+    }
+    else
+    {
+        dfv.value.dbl = m_values[index].dbl;
+    }
+}
+
 DcgmEntityTimeSeries::DcgmEntityTimeSeries()
     : m_entityId(0)
     , m_fieldValueTimeSeries()
@@ -53,7 +141,7 @@ bool DcgmEntityTimeSeries::operator==(const DcgmEntityTimeSeries &ets)
 
 void DcgmEntityTimeSeries::AddValue(unsigned short fieldId, dcgmFieldValue_v1 &val)
 {
-    m_fieldValueTimeSeries[fieldId].push_back(val);
+    m_fieldValueTimeSeries[fieldId].Add(val);
 }
 
 bool DcgmEntityTimeSeries::IsFieldStored(unsigned short fieldId)
@@ -63,31 +151,43 @@ bool DcgmEntityTimeSeries::IsFieldStored(unsigned short fieldId)
 
 void DcgmEntityTimeSeries::GetFirstNonZero(unsigned short fieldId, dcgmFieldValue_v1 &dfv, uint64_t mask)
 {
-    for (size_t i = 0; i < m_fieldValueTimeSeries[fieldId].size(); i++)
+    auto it = m_fieldValueTimeSeries.find(fieldId);
+    if (it == m_fieldValueTimeSeries.end())
     {
-        const dcgmFieldValue_v1 &val = m_fieldValueTimeSeries[fieldId][i];
-        switch (val.fieldType)
+        return;
+    }
+
+    const DcgmFieldSamples &samples = it->second;
+    for (size_t i = 0; i < samples.Size(); i++)
+    {
+        switch (samples.GetFieldType())
         {
             case DCGM_FT_DOUBLE:
-                if (val.value.dbl != 0.0 && !DCGM_FP64_IS_BLANK(val.value.dbl))
+            {
+                double value = samples.GetDouble(i);
+                if (value != 0.0 && !DCGM_FP64_IS_BLANK(value))
                 {
-                    memcpy(&dfv, &val, sizeof(dfv));
+                    samples.GetFieldValue(i, fieldId, dfv);
                     return;
                 }
                 break;
+            }
             case DCGM_FT_INT64:
+            {
+                int64_t value = samples.GetInt64(i);
                 // Ignore values that are 0 after applying the mask
-                if (mask != 0 && (val.value.i64 & mask) == 0)
+                if (mask != 0 && (value & mask) == 0)
                 {
                     continue;
                 }
 
-                if (val.value.i64 != 0 && !DCGM_INT64_IS_BLANK(val.value.i64))
+                if (value != 0 && !DCGM_INT64_IS_BLANK(value))
                 {
-                    memcpy(&dfv, &val, sizeof(dfv));
+                    samples.GetFieldValue(i, fieldId, dfv);
                     return;
                 }
                 break;
+            }
             default:
                 // Unsupported type, return immediately
                 return;
@@ -100,32 +200,57 @@ void DcgmEntityTimeSeries::GetFirstNonZero(unsigned short fieldId, dcgmFieldValu
 void DcgmEntityTimeSeries::AddToJson(Json::Value &jv, unsigned int jsonIndex)
 {
     jv[GPUS][jsonIndex]["gpuId"] = m_entityId;
-    for (std::map<unsigned short, std::vector<dcgmFieldValue_v1>>::iterator iter = m_fieldValueTimeSeries.begin();
-         iter != m_fieldValueTimeSeries.end();
-         iter++)
+    for (auto const &[fieldId, samples] : m_fieldValueTimeSeries)
     {
         std::string tag;
-        DcgmRecorder::GetTagFromFieldId(iter->first, tag);
+        DcgmRecorder::GetTagFromFieldId(fieldId, tag);
 
-        jv[GPUS][jsonIndex][tag] = Json::Value(Json::arrayValue);
+        Json::Value &series = jv[GPUS][jsonIndex][tag];
+        series              = Json::Value(Json::arrayValue);
+        series.resize(samples.Size());
 
-        for (size_t i = 0; i < iter->second.size(); i++)
+        for (size_t i = 0; i < samples.Size(); i++)
         {
-            Json::Value entry;
-            entry["timestamp"] = iter->second[i].ts;
-            switch (iter->second[i].fieldType)
+            Json::Value &entry = series[(Json::ArrayIndex)i];
+            entry["timestamp"] = (Json::Int64)samples.GetTimestamp(i);
+            if (samples.GetFieldType() == DCGM_FT_INT64)
             {
-                case DCGM_FT_INT64:
-                    entry["value"] = iter->second[i].value.i64;
-                    break;
-
-                case DCGM_FT_DOUBLE:
-                    entry["value"] = iter->second[i].value.dbl;
-                    break;
+                entry["value"] = (Json::Int64)samples.GetInt64(i);
+            }
+            else
+            {
+                entry["value"] = samples.GetDouble(i);
             }
+        }
+    }
+}
+
+void DcgmEntityTimeSeries::WriteJson(JsonStreamWriter &writer) const
+{
+    for (auto const &[fieldId, samples] : m_fieldValueTimeSeries)
+    {
+        std::string tag;
+        DcgmRecorder::GetTagFromFieldId(fieldId, tag);
 
-            jv[GPUS][jsonIndex][tag].append(entry);
+        writer.Key(tag);
+        writer.StartArray();
+        for (size_t i = 0; i < samples.Size(); i++)
+        {
+            writer.StartObject();
+            writer.Key("timestamp");
+            writer.Value(static_cast<int64_t>(samples.GetTimestamp(i)));
+            writer.Key("value");
+            if (samples.GetFieldType() == DCGM_FT_INT64)
+            {
+                writer.Value(samples.GetInt64(i));
+            }
+            else
+            {
+                writer.Value(samples.GetDouble(i));
+            }
+            writer.EndObject();
         }
+        writer.EndArray();
     }
 }
 
@@ -187,6 +312,21 @@ void DcgmValuesSinceHolder::AddToJson(Json::Value &jv)
     }
 }
 
+void DcgmValuesSinceHolder::WriteGpuJson(unsigned int gpuId, JsonStreamWriter &writer) const
+{
+    auto entities = m_values.find(DCGM_FE_GPU);
+    if (entities == m_values.end())
+    {
+        return;
+    }
+
+    auto entity = entities->second.find(gpuId);
+    if (entity != entities->second.end())
+    {
+        entity->second.WriteJson(writer);
+    }
+}
+
 bool DcgmValuesSinceHolder::DoesValuePassPerSecondThreshold(unsigned short fieldId,
                                                             const dcgmFieldValue_v1 &dfv,
                                                             unsigned int gpuId,
@@ -194,8 +334,24 @@ bool DcgmValuesSinceHolder::DoesValuePassPerSecondThreshold(unsigned short field
                                                             std::vector<DcgmError> &errorList,
                                                             timelib64_t startTime)
 {
-    std::vector<dcgmFieldValue_v1> &values = m_values[DCGM_FE_GPU][gpuId].m_fieldValueTimeSeries[fieldId];
-    for (size_t i = 1; i < values.size(); i++)
+    auto entities = m_values.find(DCGM_FE_GPU);
+    if (entities == m_values.end())
+    {
+        return false;
+    }
+    auto entity = entities->second.find(gpuId);
+    if (entity == entities->second.end())
+    {
+        return false;
+    }
+    auto field = entity->second.m_fieldValueTimeSeries.find(fieldId);
+    if (field == entity->second.m_fieldValueTimeSeries.end())
+    {
+        return false;
+    }
+
+    const DcgmFieldSamples &values = field->second;
+    for (size_t i = std::max<size_t>(1, values.LowerBound(startTime)); i < values.Size(); i++)
     {
         // These values are watched with a refresh of once per second, so comparing with the previous value
         // should be sufficient.
@@ -203,10 +359,10 @@ bool DcgmValuesSinceHolder::DoesValuePassPerSecondThreshold(unsigned short field
         {
             case DCGM_FT_DOUBLE:
             {
-                double delta = values[i].value.dbl - values[i - 1].value.dbl;
+                double delta = values.GetDouble(i) - values.GetDouble(i - 1);
                 if (delta >= dfv.value.dbl)
                 {
-                    double timeDelta = (values[i].ts - startTime) / 1000000.0;
+                    double timeDelta = (values.GetTimestamp(i) - startTime) / 1000000.0;
                     DcgmError d { gpuId };
                     DCGM_ERROR_FORMAT_MESSAGE(
                         DCGM_FR_FIELD_THRESHOLD_TS_DBL, d, fieldName, dfv.value.dbl, delta, timeDelta);
@@ -218,10 +374,10 @@ bool DcgmValuesSinceHolder::DoesValuePassPerSecondThreshold(unsigned short field
 
             case DCGM_FT_INT64:
             {
-                int delta = values[i].value.i64 - values[i - 1].value.i64;
+                int delta = values.GetInt64(i) - values.GetInt64(i - 1);
                 if (delta >= dfv.value.i64)
                 {
-                    double timeDelta = (values[i].ts - startTime) / 1000000.0;
+                    double timeDelta = (values.GetTimestamp(i) - startTime) / 1000000.0;
                     DcgmError d { gpuId };
                     DCGM_ERROR_FORMAT_MESSAGE(
                         DCGM_FR_FIELD_THRESHOLD_TS, d, fieldName, dfv.value.i64, delta, timeDelta);
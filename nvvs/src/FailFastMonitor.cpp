@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "FailFastMonitor.h"
+#include "DcgmLogging.h"
+#include "NvvsCommon.h"
+#include "dcgm_fields.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+/* Errors that fail a test whatever its configuration. DIFF for counters, MAX for the last XID seen */
+struct FatalErrorField
+{
+    unsigned short fieldId;
+    int summaryType;
+};
+
+const FatalErrorField fatalErrorFields[] = {
+    { DCGM_FI_DEV_ECC_DBE_VOL_TOTAL, DCGM_SUMMARY_DIFF },
+    { DCGM_FI_DEV_XID_ERRORS, DCGM_SUMMARY_MAX },
+};
+
+/* Sleep in slices this long so that Stop() is noticed quickly */
+const long long sleepSliceUsec = 100000;
+} // namespace
+
+/*****************************************************************************/
+FailFastMonitor::FailFastMonitor(dcgmHandle_t handle,
+                                 std::vector<unsigned int> const &gpuIds,
+                                 unsigned int checkInterval)
+    : m_dcgmRecorder(handle)
+    , m_gpuIds(gpuIds)
+    , m_checkInterval(checkInterval == 0 ? 1 : checkInterval)
+    , m_startTime(timelib_usecSince1970())
+    , m_foundFatalError(false)
+    , m_fatalError()
+{
+    std::vector<unsigned short> fieldIds;
+    for (auto const &field : fatalErrorFields)
+    {
+        fieldIds.push_back(field.fieldId);
+    }
+
+    /* The plugins watch these too. Watch them here in case a plugin doesn't */
+    std::string errStr
+        = m_dcgmRecorder.AddWatches(fieldIds, m_gpuIds, false, "nvvs_fail_fast_fields", "nvvs_fail_fast_group", 600);
+    if (!errStr.empty())
+    {
+        DCGM_LOG_WARNING << "Could not watch the fatal error fields for fail fast: " << errStr;
+    }
+}
+
+/*****************************************************************************/
+bool FailFastMonitor::CheckForFatalErrors()
+{
+    if (m_foundFatalError)
+    {
+        return true;
+    }
+
+    for (unsigned int gpuId : m_gpuIds)
+    {
+        for (auto const &field : fatalErrorFields)
+        {
+            dcgmFieldSummaryRequest_t fsr;
+            memset(&fsr, 0, sizeof(fsr));
+            fsr.fieldId         = field.fieldId;
+            fsr.entityGroupId   = DCGM_FE_GPU;
+            fsr.entityId        = gpuId;
+            fsr.summaryTypeMask = field.summaryType;
+            fsr.startTime       = m_startTime;
+            fsr.endTime         = 0;
+
+            if (m_dcgmRecorder.GetFieldSummary(fsr) != DCGM_ST_OK)
+            {
+                continue;
+            }
+
+            long long value = fsr.response.values[0].i64;
+            if (value <= 0 || DCGM_INT64_IS_BLANK(value))
+            {
+                continue;
+            }
+
+            std::string tag;
+            DcgmRecorder::GetTagFromFieldId(field.fieldId, tag);
+
+            std::stringstream ss;
+            ss << "Fail fast: stopping the run after " << tag << " reported " << value << " on GPU " << gpuId;
+            m_fatalError = ss.str();
+            DCGM_LOG_ERROR << m_fatalError;
+
+            m_foundFatalError = true;
+            if (main_should_stop == 0)
+            {
+                main_should_stop = MAIN_STOP_FAIL_FAST;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*****************************************************************************/
+bool FailFastMonitor::FoundFatalError() const
+{
+    return m_foundFatalError;
+}
+
+/*****************************************************************************/
+std::string FailFastMonitor::GetFatalError() const
+{
+    if (!m_foundFatalError)
+    {
+        return "";
+    }
+
+    return m_fatalError;
+}
+
+/*****************************************************************************/
+void FailFastMonitor::run(void)
+{
+    const long long intervalUsec = m_checkInterval * 1000000LL;
+
+    while (!ShouldStop() && !CheckForFatalErrors())
+    {
+        for (long long slept = 0; slept < intervalUsec && !ShouldStop(); slept += sleepSliceUsec)
+        {
+            Sleep(sleepSliceUsec);
+        }
+    }
+}
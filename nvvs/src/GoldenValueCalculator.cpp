@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include <fstream>
 
 #include "GoldenValueCalculator.h"
@@ -23,52 +24,131 @@
 
 
 /*************************************************************************/
-void GoldenValueCalculator::RecordGoldenValueInputs(const std::string &testname, const observedMetrics_t &metrics)
+void GoldenValueStats::Add(double value)
 {
-    for (observedMetrics_t::const_iterator outer = metrics.begin(); outer != metrics.end(); ++outer)
+    m_count++;
+    if (m_count == 1)
     {
-        for (std::map<unsigned int, double>::const_iterator inner = outer->second.begin(); inner != outer->second.end();
-             ++inner)
-        {
-            std::string paramName = GetParameterName(testname, outer->first);
-            AddToAllInputs(testname, paramName, inner->second);
-            AddToInputsPerGpu(testname, paramName, inner->first, inner->second);
-        }
+        m_min = value;
+        m_max = value;
+    }
+    else
+    {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    double delta = value - m_mean;
+    m_mean += delta / static_cast<double>(m_count);
+    m_m2 += delta * (value - m_mean);
+}
+
+/*************************************************************************/
+void GoldenValueStats::Merge(const GoldenValueStats &other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+    else if (m_count == 0)
+    {
+        *this = other;
+        return;
     }
+
+    size_t count = m_count + other.m_count;
+    double delta = other.m_mean - m_mean;
+
+    double weight = static_cast<double>(m_count) * static_cast<double>(other.m_count) / static_cast<double>(count);
+
+    m_mean += delta * static_cast<double>(other.m_count) / static_cast<double>(count);
+    m_m2 += other.m_m2 + delta * delta * weight;
+    m_min   = std::min(m_min, other.m_min);
+    m_max   = std::max(m_max, other.m_max);
+    m_count = count;
 }
 
 /*************************************************************************/
-valueWithVariance_t GoldenValueCalculator::CalculateMeanAndVariance(std::vector<double> &data) const
+valueWithVariance_t GoldenValueStats::GetMeanAndVariance() const
 {
-    double total = 0.0;
     valueWithVariance_t output;
 
-    for (size_t i = 0; i < data.size(); i++)
+    output.value = m_mean;
+    if (m_count > 1)
+    {
+        output.variance = m_m2 / static_cast<double>(m_count - 1);
+    }
+    else
     {
-        total += data[i];
+        output.variance = 0.0;
     }
 
-    double avg   = total / static_cast<double>(data.size());
-    output.value = avg;
+    return output;
+}
+
+/*************************************************************************/
+unsigned int GoldenValueCalculator::GetParamId(const std::string &testname, const std::string &paramName)
+{
+    // Test names never contain a '.', so this can't be mistaken for another test's parameter
+    std::string key = testname + "." + paramName;
 
-    if (data.size() > 1)
+    auto it = m_paramIds.find(key);
+    if (it != m_paramIds.end())
     {
-        double scratchVariance = 0.0;
+        return it->second;
+    }
+
+    unsigned int paramId = m_params.size();
+    m_params.emplace_back();
+    m_params[paramId].testname  = testname;
+    m_params[paramId].paramName = paramName;
+    m_paramIds[key]             = paramId;
+
+    return paramId;
+}
 
-        for (size_t i = 0; i < data.size(); i++)
+/*************************************************************************/
+void GoldenValueCalculator::RecordGoldenValueInputs(const std::string &testname, const observedMetrics_t &metrics)
+{
+    for (observedMetrics_t::const_iterator outer = metrics.begin(); outer != metrics.end(); ++outer)
+    {
+        unsigned int paramId = GetParamId(testname, GetParameterName(testname, outer->first));
+
+        for (std::map<unsigned int, double>::const_iterator inner = outer->second.begin(); inner != outer->second.end();
+             ++inner)
         {
-            double diff = data[i] - avg;
-            scratchVariance += diff * diff;
+            AddToAllInputs(paramId, inner->second);
+            AddToInputsPerGpu(paramId, inner->first, inner->second);
         }
+    }
+}
 
-        output.variance = scratchVariance / static_cast<double>(data.size() - 1);
+/*************************************************************************/
+void GoldenValueCalculator::Merge(const GoldenValueCalculator &other)
+{
+    for (const goldenValueParam_t &otherParam : other.m_params)
+    {
+        goldenValueParam_t &param = m_params[GetParamId(otherParam.testname, otherParam.paramName)];
+
+        param.all.Merge(otherParam.all);
+        for (const auto &[gpuId, stats] : otherParam.perGpu)
+        {
+            param.perGpu[gpuId].Merge(stats);
+        }
     }
-    else
+}
+
+/*************************************************************************/
+valueWithVariance_t GoldenValueCalculator::CalculateMeanAndVariance(const std::vector<double> &data) const
+{
+    GoldenValueStats stats;
+
+    for (size_t i = 0; i < data.size(); i++)
     {
-        output.variance = 0.0;
+        stats.Add(data[i]);
     }
 
-    return output;
+    return stats.GetMeanAndVariance();
 }
 
 /*************************************************************************/
@@ -116,24 +196,15 @@ void GoldenValueCalculator::DumpObservedMetricsWithGpuIds(int64_t timestamp) con
 
     fileWithGpuIds.open(dataWithGpuIdsFilename.str().c_str(), std::ofstream::out);
 
-    for (std::map<std::string, paramToGpuToValues_t>::const_iterator testIt = m_inputsPerGpu.begin();
-         testIt != m_inputsPerGpu.end();
-         ++testIt)
+    // Each line is testname.parameter.gpuId,count,mean,variance,min,max
+    for (const goldenValueParam_t &param : m_params)
     {
-        for (paramToGpuToValues_t::const_iterator paramsIt = testIt->second.begin(); paramsIt != testIt->second.end();
-             ++paramsIt)
+        for (const auto &[gpuId, stats] : param.perGpu)
         {
-            for (std::map<unsigned int, std::vector<double>>::const_iterator gpusIt = paramsIt->second.begin();
-                 gpusIt != paramsIt->second.end();
-                 ++gpusIt)
-            {
-                fileWithGpuIds << testIt->first << "." << paramsIt->first << "." << gpusIt->first;
-                for (size_t i = 0; i < gpusIt->second.size(); i++)
-                {
-                    fileWithGpuIds << "," << gpusIt->second[i];
-                }
-                fileWithGpuIds << "\n";
-            }
+            valueWithVariance_t vwv = stats.GetMeanAndVariance();
+            fileWithGpuIds << param.testname << "." << param.paramName << "." << gpuId << "," << stats.GetCount()
+                           << "," << vwv.value << "," << vwv.variance << "," << stats.GetMin() << ","
+                           << stats.GetMax() << "\n";
         }
     }
 
@@ -149,19 +220,12 @@ void GoldenValueCalculator::DumpObservedMetricsAll(int64_t timestamp) const
     std::ofstream file;
     file.open(dataFilename.str().c_str(), std::ofstream::out);
 
-    for (std::map<std::string, paramToValues_t>::const_iterator testIt = m_inputs.begin(); testIt != m_inputs.end();
-         ++testIt)
+    // Each line is testname.parameter,count,mean,variance,min,max
+    for (const goldenValueParam_t &param : m_params)
     {
-        for (paramToValues_t::const_iterator paramsIt = testIt->second.begin(); paramsIt != testIt->second.end();
-             ++paramsIt)
-        {
-            file << testIt->first << "." << paramsIt->first;
-            for (size_t i = 0; i < paramsIt->second.size(); i++)
-            {
-                file << "," << paramsIt->second[i];
-            }
-            file << "\n";
-        }
+        valueWithVariance_t vwv = param.all.GetMeanAndVariance();
+        file << param.testname << "." << param.paramName << "," << param.all.GetCount() << "," << vwv.value << ","
+             << vwv.variance << "," << param.all.GetMin() << "," << param.all.GetMax() << "\n";
     }
 
     file.close();
@@ -208,35 +272,26 @@ dcgmReturn_t GoldenValueCalculator::CalculateAndWriteGoldenValues(const std::str
     m_calculatedGoldenValues.clear();
     m_averageGpuValues.clear();
 
-    for (std::map<std::string, paramToValues_t>::iterator testIt = m_inputs.begin(); testIt != m_inputs.end(); ++testIt)
+    for (const goldenValueParam_t &param : m_params)
     {
-        for (paramToValues_t::iterator paramIt = testIt->second.begin(); paramIt != testIt->second.end(); ++paramIt)
-        {
-            m_calculatedGoldenValues[testIt->first][paramIt->first] = CalculateMeanAndVariance(paramIt->second);
-
-            ret = IsVarianceAcceptable(
-                testIt->first, paramIt->first, m_calculatedGoldenValues[testIt->first][paramIt->first]);
+        valueWithVariance_t &vwv = m_calculatedGoldenValues[param.testname][param.paramName];
+        vwv                      = param.all.GetMeanAndVariance();
 
-            AdjustGoldenValue(testIt->first, paramIt->first);
+        // Report the first parameter that doesn't converge
+        dcgmReturn_t varianceRet = IsVarianceAcceptable(param.testname, param.paramName, vwv);
+        if (ret == DCGM_ST_OK)
+        {
+            ret = varianceRet;
         }
-    }
 
-    for (std::map<std::string, paramToGpuToValues_t>::iterator testIt = m_inputsPerGpu.begin();
-         testIt != m_inputsPerGpu.end();
-         ++testIt)
-    {
-        for (paramToGpuToValues_t::iterator paramsIt = testIt->second.begin(); paramsIt != testIt->second.end();
-             ++paramsIt)
+        AdjustGoldenValue(param.testname, param.paramName);
+
+        for (const auto &[gpuId, stats] : param.perGpu)
         {
-            for (std::map<unsigned int, std::vector<double>>::iterator gpusIt = paramsIt->second.begin();
-                 gpusIt != paramsIt->second.end();
-                 ++gpusIt)
-            {
-                dcgmGpuToValue_t tmp;
-                tmp.gpuId                                          = gpusIt->first;
-                tmp.calculatedValue                                = CalculateMeanAndVariance(gpusIt->second);
-                m_averageGpuValues[testIt->first][paramsIt->first] = tmp;
-            }
+            dcgmGpuToValue_t tmp;
+            tmp.gpuId                                           = gpuId;
+            tmp.calculatedValue                                 = stats.GetMeanAndVariance();
+            m_averageGpuValues[param.testname][param.paramName] = tmp;
         }
     }
 
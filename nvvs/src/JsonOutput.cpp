@@ -170,7 +170,8 @@ void JsonOutput::Result(nvvsPluginResult_t overallResult,
     }
 
     char buf[26];
-    std::string resultStr = resultEnumToString(overallResult);
+    std::string resultStr  = resultEnumToString(overallResult);
+    unsigned int testIndex = m_testIndex;
 
     if (overallResult == NVVS_RESULT_SKIP)
     {
@@ -254,6 +255,23 @@ void JsonOutput::Result(nvvsPluginResult_t overallResult,
     {
         m_testIndex++;
     }
+
+    if (nvvsCommon.fromDcgm)
+    {
+        StreamTestResult(jv[NVVS_HEADERS][headerIndex][NVVS_TESTS][testIndex]);
+    }
+}
+
+/*****************************************************************************/
+void JsonOutput::StreamTestResult(const Json::Value &test)
+{
+    Json::Value record;
+    record[NVVS_VERSION_STR] = jv[NVVS_VERSION_STR];
+    record[NVVS_STREAM_TEST] = test;
+
+    Json::StreamWriterBuilder wBuilder;
+    wBuilder["indentation"] = "";
+    m_out << NVVS_STREAM_RESULT << " " << Json::writeString(wBuilder, record) << std::endl;
 }
 
 void JsonOutput::updatePluginProgress(unsigned int progress, bool clear)
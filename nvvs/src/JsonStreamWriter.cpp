@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "JsonStreamWriter.h"
+
+#include <DcgmNumberFormat.h>
+#include <json/json.h>
+
+#include <cmath>
+
+JsonStreamWriter::JsonStreamWriter(std::ostream &out)
+    : m_out(out)
+    , m_hasMembers()
+    , m_afterKey(false)
+{}
+
+void JsonStreamWriter::NewLine()
+{
+    m_out << '\n' << std::string(m_hasMembers.size() * 3, ' ');
+}
+
+void JsonStreamWriter::BeforeValue()
+{
+    if (m_afterKey)
+    {
+        // The key already placed the separator
+        m_afterKey = false;
+        return;
+    }
+
+    if (m_hasMembers.empty())
+    {
+        return;
+    }
+
+    if (m_hasMembers.back())
+    {
+        m_out << ',';
+    }
+    m_hasMembers.back() = true;
+    NewLine();
+}
+
+void JsonStreamWriter::EndContainer(char closer)
+{
+    bool hasMembers = m_hasMembers.back();
+    m_hasMembers.pop_back();
+    if (hasMembers)
+    {
+        NewLine();
+    }
+    m_out << closer;
+
+    if (m_hasMembers.empty())
+    {
+        m_out << '\n';
+    }
+}
+
+void JsonStreamWriter::StartObject()
+{
+    BeforeValue();
+    m_out << '{';
+    m_hasMembers.push_back(false);
+}
+
+void JsonStreamWriter::EndObject()
+{
+    EndContainer('}');
+}
+
+void JsonStreamWriter::StartArray()
+{
+    BeforeValue();
+    m_out << '[';
+    m_hasMembers.push_back(false);
+}
+
+void JsonStreamWriter::EndArray()
+{
+    EndContainer(']');
+}
+
+void JsonStreamWriter::Key(const std::string &key)
+{
+    BeforeValue();
+    m_out << Json::valueToQuotedString(key.c_str()) << " : ";
+    m_afterKey = true;
+}
+
+void JsonStreamWriter::Value(int64_t value)
+{
+    BeforeValue();
+    char buffer[DcgmNs::MaxFormattedNumberLength];
+    char const *end = DcgmNs::FormatInt64(buffer, buffer + sizeof(buffer), value);
+    m_out.write(buffer, end - buffer);
+}
+
+void JsonStreamWriter::Value(double value)
+{
+    BeforeValue();
+    if (!std::isfinite(value))
+    {
+        // JSON has no spelling for these. Write what jsoncpp does
+        m_out << Json::valueToString(value);
+        return;
+    }
+
+    char buffer[DcgmNs::MaxFormattedNumberLength];
+    char const *end = DcgmNs::FormatDouble(buffer, buffer + sizeof(buffer), value);
+    m_out.write(buffer, end - buffer);
+
+    // Keep whole numbers doubles for readers that tell 5 from 5.0, as jsoncpp does
+    if (std::string_view(buffer, end - buffer).find_first_of(".e") == std::string_view::npos)
+    {
+        m_out << ".0";
+    }
+}
+
+void JsonStreamWriter::Value(const std::string &value)
+{
+    BeforeValue();
+    m_out << Json::valueToQuotedString(value.c_str());
+}
@@ -23,6 +23,7 @@
 #include "ParsingUtility.h"
 #include "PluginStrings.h"
 #include "dcgm_structs_internal.h"
+#include <DcgmBuildInfo.hpp>
 #include <DcgmStringHelpers.h>
 #include <PluginInterface.h>
 #include <cstdlib>
@@ -43,7 +44,7 @@ bool initTimedOut = false;
 jmp_buf exitInitialization;
 
 /*****************************************************************************/
-NvidiaValidationSuite::NvidiaValidationSuite()
+NvidiaValidationSuite::NvidiaValidationSuite(bool keepDcgmConnection)
     : logInit(false)
     , m_gpuVect()
     , testVect()
@@ -51,6 +52,7 @@ NvidiaValidationSuite::NvidiaValidationSuite()
     , whitelist(0)
     , fwcfg()
     , m_tf(nullptr)
+    , m_planCache()
     , configFile()
     , debugFile(NVVS_LOGGING_DEFAULT_NVVS_LOGFILE)
     , debugLogLevel("")
@@ -62,6 +64,7 @@ NvidiaValidationSuite::NvidiaValidationSuite()
     , initWaitTime(120)
     , m_sysCheck()
     , m_pv()
+    , m_keepDcgmConnection(keepDcgmConnection)
 {
     parser = new ConfigFileParser_v2("/etc/nvidia-validation-suite/nvvs.conf", fwcfg);
 
@@ -85,7 +88,10 @@ NvidiaValidationSuite::~NvidiaValidationSuite()
     delete whitelist;
     delete parser;
 
-    dcgmShutdown();
+    if (!m_keepDcgmConnection)
+    {
+        dcgmShutdown();
+    }
 }
 
 /*****************************************************************************/
@@ -337,7 +343,11 @@ std::string NvidiaValidationSuite::Go(int argc, char *argv[])
     }
     */
 
-    dcgmReturn_t ret = dcgmHandle.ConnectToDcgm(nvvsCommon.dcgmHostname);
+    dcgmReturn_t ret = DCGM_ST_OK;
+    if (!m_keepDcgmConnection || dcgmHandle.GetHandle() == 0)
+    {
+        ret = dcgmHandle.ConnectToDcgm(nvvsCommon.dcgmHostname);
+    }
     if (ret != DCGM_ST_OK)
     {
         std::stringstream buf;
@@ -450,6 +460,9 @@ std::string NvidiaValidationSuite::Go(int argc, char *argv[])
         return "";
     }
 
+    m_planCache = TestPlanCache(nvvsCommon.testPlanCacheDir);
+    m_planCache.Load(BuildTestPlanKey());
+
     if (nvvsCommon.training)
     {
         unsigned int iterations = nvvsCommon.trainingIterations;
@@ -465,6 +478,7 @@ std::string NvidiaValidationSuite::Go(int argc, char *argv[])
                 fillTestVectors(NVVS_SUITE_LONG, Test::NVVS_CLASS_PERFORMANCE, gpuSets[setIndex].get());
             }
 
+            m_planCache.Save();
             m_tf->go(gpuSets);
 
             float pcnt = static_cast<float>(i + 1) / static_cast<float>(iterations);
@@ -480,6 +494,7 @@ std::string NvidiaValidationSuite::Go(int argc, char *argv[])
     else
     {
         CheckGpuSetTests(gpuSets);
+        m_planCache.Save();
 
         // Execute the tests... let the TF catch all exceptions and decide
         // whether to throw them higher.
@@ -647,6 +662,45 @@ void NvidiaValidationSuite::overrideParameters(TestParameters *tp, const std::st
     }
 }
 
+/*****************************************************************************/
+std::string NvidiaValidationSuite::BuildTestPlanKey()
+{
+    std::stringstream key;
+
+    key << DcgmNs::DcgmBuildInfo().GetBuildInfoStr() << "\n";
+    key << "plugins=" << nvvsCommon.pluginPath << "\n";
+    key << "configless=" << nvvsCommon.configless << "\n";
+    key << "overrideMinMax=" << nvvsCommon.overrideMinMax << "\n";
+    key << "parms=" << nvvsCommon.parmsString << "\n";
+
+    /* The whitelist is adjusted for the memory clocks of the GPUs. See Whitelist::postProcessWhitelist() */
+    for (auto gpu : m_gpuVect)
+    {
+        key << "gpu=" << gpu->getDevicePciDeviceId() << "," << gpu->getMaxMemoryClock() << "\n";
+    }
+
+    if (!nvvsCommon.configless)
+    {
+        key << "config=" << parser->GetConfigContents();
+    }
+
+    return key.str();
+}
+
+/*****************************************************************************/
+bool NvidiaValidationSuite::GetPlannedParameters(const std::string &entry,
+                                                 const std::string &deviceId,
+                                                 TestParameters &tp)
+{
+    if (!m_planCache.Get(entry, tp))
+    {
+        return false;
+    }
+
+    whitelist->ApplyGlobalChanges(deviceId);
+    return true;
+}
+
 /*****************************************************************************/
 void NvidiaValidationSuite::InitializeAndCheckGpuObjs(std::vector<std::unique_ptr<GpuSet>> &gpuSets)
 {
@@ -783,17 +837,23 @@ void NvidiaValidationSuite::CheckGpuSetTests(std::vector<std::unique_ptr<GpuSet>
                             tpVect.push_back(tp); // purely for accounting when we go to cleanup
 
 
-                            whitelist->getDefaultsByDeviceId(
-                                compareRequestedName, gpuSets[i]->gpuObjs[0]->getDevicePciDeviceId(), tp);
-
-                            if (!nvvsCommon.configless)
+                            std::string deviceId  = gpuSets[i]->gpuObjs[0]->getDevicePciDeviceId();
+                            std::string planEntry = "custom/" + deviceId + "/" + compareRequestedName;
+                            if (!GetPlannedParameters(planEntry, deviceId, *tp))
                             {
-                                parser->ParseTestOverrides(compareRequestedName, *tp);
-                            }
+                                whitelist->getDefaultsByDeviceId(compareRequestedName, deviceId, tp);
 
-                            if (nvvsCommon.parms.size() > 0)
-                            {
-                                overrideParameters(tp, compareRequestedName);
+                                if (!nvvsCommon.configless)
+                                {
+                                    parser->ParseTestOverrides(compareRequestedName, *tp);
+                                }
+
+                                if (nvvsCommon.parms.size() > 0)
+                                {
+                                    overrideParameters(tp, compareRequestedName);
+                                }
+
+                                m_planCache.Put(planEntry, *tp);
                             }
 
                             tp->AddString(PS_PLUGIN_NAME, (*testIt)->GetTestName());
@@ -909,12 +969,19 @@ void NvidiaValidationSuite::fillTestVectors(suiteNames_enum suite, Test::testCla
                 */
 
                 // pull just the first GPU device ID since they are all meant to be the same at this point
-                whitelist->getDefaultsByDeviceId(*it, set->gpuObjs[0]->getDevicePciDeviceId(), tp);
+                std::string deviceId  = set->gpuObjs[0]->getDevicePciDeviceId();
+                std::string planEntry = std::to_string(testClass) + "/" + deviceId + "/" + *it;
+                if (!GetPlannedParameters(planEntry, deviceId, *tp))
+                {
+                    whitelist->getDefaultsByDeviceId(*it, deviceId, tp);
 
-                if (nvvsCommon.parms.size() > 0)
-                    overrideParameters(tp, *it);
-                else if (!nvvsCommon.configless)
-                    parser->ParseTestOverrides(*it, *tp);
+                    if (nvvsCommon.parms.size() > 0)
+                        overrideParameters(tp, *it);
+                    else if (!nvvsCommon.configless)
+                        parser->ParseTestOverrides(*it, *tp);
+
+                    m_planCache.Put(planEntry, *tp);
+                }
             }
 
             tp->AddString(PS_PLUGIN_NAME, (*it));
@@ -1322,6 +1389,27 @@ void NvidiaValidationSuite::processCommandLine(int argc, char *argv[])
             "failure check interval",
             cmd);
 
+        TCLAP::SwitchArg failFast(
+            "",
+            "fail-fast",
+            "Stop the whole run at the first fatal error (a double bit ECC error or an XID) on any GPU being tested. "
+            "Running tests are cancelled and the remaining tests are skipped. The GPUs are checked for fatal errors "
+            "once every 5 seconds while a test is running (can be modified by the --check-interval parameter). "
+            "Disabled by default.",
+            cmd,
+            false);
+
+        TCLAP::ValueArg<std::string> planCacheArg(
+            "",
+            "plan-cache",
+            "Directory where the resolved parameters of each test are saved so that later runs with the same "
+            "configuration, parameters and GPUs skip resolving them. An empty value disables the cache. "
+            "Default is " TPC_DEFAULT_DIRECTORY ".",
+            false,
+            TPC_DEFAULT_DIRECTORY,
+            "plan cache directory",
+            cmd);
+
 
         cmd.parse(argc, argv);
 
@@ -1351,6 +1439,7 @@ void NvidiaValidationSuite::processCommandLine(int argc, char *argv[])
         nvvsCommon.trainingVariancePcnt  = trainingVariance.getValue() / 100.0;
         nvvsCommon.trainingTolerancePcnt = trainingTolerance.getValue() / 100.0;
         nvvsCommon.goldenValuesFile      = goldenValuesFile.getValue();
+        nvvsCommon.testPlanCacheDir      = planCacheArg.getValue();
         nvvsCommon.SetStatsPath(statsPathArg.getValue());
 
         this->initWaitTime = initializationWaitTime.getValue();
@@ -1382,13 +1471,11 @@ void NvidiaValidationSuite::processCommandLine(int argc, char *argv[])
         }
 
         // Enable early failure checks if requested
-        if (failEarly.isSet())
+        nvvsCommon.failEarly = failEarly.isSet();
+        nvvsCommon.failFast  = failFast.isSet();
+        if ((nvvsCommon.failEarly || nvvsCommon.failFast) && failCheckInterval.isSet())
         {
-            nvvsCommon.failEarly = true;
-            if (failCheckInterval.isSet())
-            {
-                nvvsCommon.failCheckInterval = failCheckInterval.getValue();
-            }
+            nvvsCommon.failCheckInterval = failCheckInterval.getValue();
         }
     }
     catch (TCLAP::ArgException &e)
@@ -54,6 +54,8 @@ NvvsCommon::NvvsCommon()
     , trainingTolerancePcnt(.0)
     , failEarly(false)
     , failCheckInterval(5)
+    , failFast(false)
+    , testPlanCacheDir()
 
 {
     memset(m_gpus, 0, sizeof(m_gpus));
@@ -90,6 +92,8 @@ NvvsCommon::NvvsCommon(const NvvsCommon &other)
     , trainingTolerancePcnt(other.trainingTolerancePcnt)
     , failEarly(other.failEarly)
     , failCheckInterval(other.failCheckInterval)
+    , failFast(other.failFast)
+    , testPlanCacheDir(other.testPlanCacheDir)
 {
     memset(m_gpus, 0, sizeof(m_gpus));
 }
@@ -123,6 +127,8 @@ NvvsCommon &NvvsCommon::operator=(const NvvsCommon &other)
     throttleIgnoreMask     = other.throttleIgnoreMask;
     failEarly              = other.failEarly;
     failCheckInterval      = other.failCheckInterval;
+    failFast               = other.failFast;
+    testPlanCacheDir       = other.testPlanCacheDir;
 
     return *this;
 }
@@ -156,6 +162,8 @@ void NvvsCommon::Init()
     throttleIgnoreMask = DCGM_INT64_BLANK;
     failEarly          = false;
     failCheckInterval  = 5;
+    failFast           = false;
+    testPlanCacheDir   = "";
 }
 
 void NvvsCommon::SetStatsPath(const std::string &statsPath)
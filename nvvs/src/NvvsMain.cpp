@@ -17,7 +17,9 @@
 #include "NvidiaValidationSuite.h"
 #include "NvvsCommon.h"
 #include "Plugin.h"
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace
 {
@@ -79,25 +81,19 @@ void OutputMainError(const std::string &error)
 }
 
 /*****************************************************************************/
-int main(int argc, char **argv)
+/*
+ * Run the diagnostic once for the given command line
+ *
+ * Returns the MAIN_RET_? code of the run
+ */
+static int RunNvvs(int argc, char **argv, bool keepDcgmConnection)
 {
     NvidiaValidationSuite *nvvs = NULL;
 
-    struct sigaction sigHandler;
-    sigHandler.sa_handler = main_sig_handler;
-    sigemptyset(&sigHandler.sa_mask);
-    sigHandler.sa_flags       = 0;
-    nvvsCommon.mainReturnCode = MAIN_RET_OK; /* Gets set by NvidiaValidationSuite constructor, but not until later */
-
-    /* Install signal handlers */
-    sigaction(SIGINT, &sigHandler, NULL);
-    sigaction(SIGTERM, &sigHandler, NULL);
-
-
     try
     {
         // declare new NVVS object
-        nvvs              = new NvidiaValidationSuite();
+        nvvs              = new NvidiaValidationSuite(keepDcgmConnection);
         std::string error = nvvs->Go(argc, argv);
         if (error.size())
         {
@@ -126,3 +122,72 @@ int main(int argc, char **argv)
     delete nvvs; /* This deletes the logger, so no more PRINT_ macros after this */
     return nvvsCommon.mainReturnCode;
 }
+
+/*****************************************************************************/
+/*
+ * Run the diagnostic for each request read from stdin until stdin is closed or we are asked to stop.
+ * The process, its libraries and its connection to DCGM are kept between runs so that the host
+ * engine doesn't pay for them on every diagnostic. See NVVS_WORKER_ARG
+ */
+static int RunWorker(char *argv0)
+{
+    std::string line;
+
+    while (!main_should_stop && std::getline(std::cin, line))
+    {
+        Json::Value request;
+        Json::CharReaderBuilder rBuilder;
+        std::stringstream requestStream(line);
+        int ret;
+
+        if (!Json::parseFromStream(rBuilder, requestStream, &request, nullptr) || !request.isArray())
+        {
+            OutputMainError("Couldn't parse the worker request '" + line + "'.");
+            ret = MAIN_RET_ERROR;
+        }
+        else
+        {
+            std::vector<std::string> args { argv0 };
+            for (Json::ArrayIndex i = 0; i < request.size(); i++)
+            {
+                args.push_back(request[i].asString());
+            }
+
+            std::vector<char *> runArgv;
+            for (auto &arg : args)
+            {
+                runArgv.push_back(&arg[0]);
+            }
+            runArgv.push_back(nullptr);
+
+            ret = RunNvvs(args.size(), runArgv.data(), true);
+        }
+
+        std::cerr.flush();
+        std::cout.clear(); /* Quiet mode leaves cout failed */
+        std::cout << std::endl << NVVS_WORKER_END_OF_RUN << " " << ret << std::endl;
+    }
+
+    return MAIN_RET_OK;
+}
+
+/*****************************************************************************/
+int main(int argc, char **argv)
+{
+    struct sigaction sigHandler;
+    sigHandler.sa_handler = main_sig_handler;
+    sigemptyset(&sigHandler.sa_mask);
+    sigHandler.sa_flags       = 0;
+    nvvsCommon.mainReturnCode = MAIN_RET_OK; /* Gets set by NvidiaValidationSuite constructor, but not until later */
+
+    /* Install signal handlers */
+    sigaction(SIGINT, &sigHandler, NULL);
+    sigaction(SIGTERM, &sigHandler, NULL);
+
+    if (argc == 2 && std::string(argv[1]) == NVVS_WORKER_ARG)
+    {
+        return RunWorker(argv[0]);
+    }
+
+    return RunNvvs(argc, argv, false);
+}
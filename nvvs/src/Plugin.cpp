@@ -345,6 +345,11 @@ long long Plugin::DetermineMaxTemp(unsigned int gpuId,
     return static_cast<long long>(parameterValue);
 }
 
+CustomStatHolder &Plugin::GetCustomStatHolder()
+{
+    return m_customStatHolder;
+}
+
 void Plugin::SetGpuStat(unsigned int gpuId, const std::string &name, double value)
 {
     m_customStatHolder.SetGpuStat(gpuId, name, value);
@@ -30,6 +30,7 @@ PluginLib::PluginLib()
     , m_retrieveResultsCB(nullptr)
     , m_userData(nullptr)
     , m_pluginName()
+    , m_pluginPath()
     , m_customStats()
     , m_errors()
     , m_info()
@@ -53,6 +54,7 @@ PluginLib::PluginLib(PluginLib &&other) noexcept
     , m_retrieveResultsCB(other.m_retrieveResultsCB)
     , m_userData(other.m_userData)
     , m_pluginName(other.m_pluginName)
+    , m_pluginPath(other.m_pluginPath)
     , m_customStats(other.m_customStats)
     , m_errors(other.m_errors)
     , m_info(other.m_info)
@@ -86,6 +88,7 @@ PluginLib &PluginLib::operator=(PluginLib &&other) noexcept
         m_retrieveResultsCB = other.m_retrieveResultsCB;
         m_userData          = other.m_userData;
         m_pluginName        = other.m_pluginName;
+        m_pluginPath        = other.m_pluginPath;
         m_customStats       = std::move(other.m_customStats);
         m_errors            = std::move(other.m_errors);
         m_info              = std::move(other.m_info);
@@ -110,6 +113,7 @@ PluginLib &PluginLib::operator=(PluginLib &&other) noexcept
 dcgmReturn_t PluginLib::LoadPlugin(const std::string &path, const std::string &name)
 {
     m_pluginName = name;
+    m_pluginPath = path;
     m_pluginPtr  = dlopen(path.c_str(), RTLD_LAZY);
 
     if (m_pluginPtr == nullptr)
@@ -308,6 +312,12 @@ std::string PluginLib::GetName() const
     return m_pluginName;
 }
 
+/*****************************************************************************/
+const std::string &PluginLib::GetPath() const
+{
+    return m_pluginPath;
+}
+
 /*****************************************************************************/
 void PluginLib::RunTest(unsigned int timeout, TestParameters *tp)
 {
@@ -17,6 +17,7 @@
 #include <DcgmHandle.h>
 #include <DcgmRecorder.h>
 #include <DcgmSystem.h>
+#include <FailFastMonitor.h>
 #include <Gpu.h>
 #include <JsonOutput.h>
 #include <NvvsCommon.h>
@@ -30,6 +31,7 @@
 #include <cstring>
 #include <dirent.h>
 #include <dlfcn.h>
+#include <future>
 #include <iostream>
 #include <list>
 #include <sstream>
@@ -265,38 +267,45 @@ void TestFramework::LoadLibrary(const char *libraryPath, const char *libraryName
     }
     else
     {
-        auto pl = std::make_unique<PluginLib>();
-
-        dcgmReturn_t ret = pl->LoadPlugin(libraryPath, libraryName);
-        if (ret == DCGM_ST_OK)
-        {
-            ret = pl->InitializePlugin(dcgmHandle.GetHandle(), m_gpuInfo);
-            if (ret == DCGM_ST_OK)
-            {
-                ret = pl->GetPluginInfo();
-                if (ret == DCGM_ST_OK)
-                {
-                    m_plugins.push_back(std::move(pl));
-                }
-                else
-                {
-                    DCGM_LOG_ERROR << "Ignoring plugin '" << libraryName
-                                   << "' because we can't retrieve information about it: " << errorString(ret);
-                }
-            }
-            else
-            {
-                DCGM_LOG_ERROR << "Ignoring plugin '" << libraryName
-                               << "' which cannot be initialized: " << errorString(ret);
-            }
-        }
-        else
+        auto pl = LoadPluginInstance(libraryPath, libraryName);
+        if (pl != nullptr)
         {
-            DCGM_LOG_ERROR << "Ignoring unloadable plugin '" << libraryName << "': " << errorString(ret);
+            m_plugins.push_back(std::move(pl));
         }
     }
 }
 
+/*****************************************************************************/
+std::unique_ptr<PluginLib> TestFramework::LoadPluginInstance(const std::string &libraryPath,
+                                                             const std::string &libraryName)
+{
+    auto pl = std::make_unique<PluginLib>();
+
+    dcgmReturn_t ret = pl->LoadPlugin(libraryPath, libraryName);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Ignoring unloadable plugin '" << libraryName << "': " << errorString(ret);
+        return nullptr;
+    }
+
+    ret = pl->InitializePlugin(dcgmHandle.GetHandle(), m_gpuInfo);
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Ignoring plugin '" << libraryName << "' which cannot be initialized: " << errorString(ret);
+        return nullptr;
+    }
+
+    ret = pl->GetPluginInfo();
+    if (ret != DCGM_ST_OK)
+    {
+        DCGM_LOG_ERROR << "Ignoring plugin '" << libraryName
+                       << "' because we can't retrieve information about it: " << errorString(ret);
+        return nullptr;
+    }
+
+    return pl;
+}
+
 /*****************************************************************************/
 bool TestFramework::PluginPermissionsMatch(const std::string &pluginDir, const std::string &plugin)
 {
@@ -469,6 +478,12 @@ void TestFramework::go(std::vector<std::unique_ptr<GpuSet>> &gpuSet)
             goList(Test::NVVS_CLASS_CUSTOM, testList, gpuList);
     }
 
+    /* A fail fast stop only ends this run. Don't let it shut down a persistent worker */
+    if (main_should_stop == MAIN_STOP_FAIL_FAST)
+    {
+        main_should_stop = 0;
+    }
+
     if (!nvvsCommon.training)
         output->print();
 }
@@ -642,11 +657,160 @@ std::string TestFramework::GetTestDisplayName(dcgmPerGpuTestIndices_t index)
     }
 }
 
+/*****************************************************************************/
+void TestFramework::ReportMissingPlugin(const std::string &name)
+{
+    DCGM_LOG_ERROR << "Couldn't find the plugin '" << name << "'";
+    std::vector<dcgmDiagSimpleResult_t> perGpuResults;
+    std::vector<dcgmDiagEvent_t> errors;
+    std::vector<dcgmDiagEvent_t> info;
+    dcgmDiagEvent_t error = {};
+    error.errorCode       = -1;
+    error.gpuId           = -1;
+    snprintf(error.msg, sizeof(error.msg), "Unable to find plugin '%s'", name.c_str());
+    errors.push_back(error);
+
+    output->Result(NVVS_RESULT_FAIL, perGpuResults, errors, info);
+}
+
+/*****************************************************************************/
+void TestFramework::AddSoftwareTestParameters(const std::string &name, TestParameters *tp)
+{
+    if (!nvvsCommon.requirePersistenceMode)
+        tp->AddString(SW_STR_REQUIRE_PERSISTENCE, "False");
+    if (name == "Blacklist")
+        tp->AddString(SW_STR_DO_TEST, "blacklist");
+    else if (name == "NVML Library")
+        tp->AddString(SW_STR_DO_TEST, "libraries_nvml");
+    else if (name == "CUDA Main Library")
+        tp->AddString(SW_STR_DO_TEST, "libraries_cuda");
+    else if (name == "CUDA Toolkit Libraries")
+        tp->AddString(SW_STR_DO_TEST, "libraries_cudatk");
+    else if (name == "Permissions and OS-related Blocks")
+        tp->AddString(SW_STR_DO_TEST, "permissions");
+    else if (name == "Persistence Mode")
+        tp->AddString(SW_STR_DO_TEST, "persistence_mode");
+    else if (name == "Environmental Variables")
+        tp->AddString(SW_STR_DO_TEST, "env_variables");
+    else if (name == "Page Retirement/Row Remap")
+        tp->AddString(SW_STR_DO_TEST, "page_retirement");
+    else if (name == "Graphics Processes")
+        tp->AddString(SW_STR_DO_TEST, "graphics_processes");
+    else if (name == "Inforom")
+        tp->AddString(SW_STR_DO_TEST, "inforom");
+}
+
+/*****************************************************************************/
+void TestFramework::goSoftwareList(std::vector<Test *> &testsList)
+{
+    struct SoftwareRun
+    {
+        std::string name;
+        Test *test         = nullptr;
+        TestParameters *tp = nullptr;
+        int pluginIndex    = -1;
+        bool runHere       = false;        /* Run on the shared plugin instance when it's reported */
+        std::unique_ptr<PluginLib> plugin; /* This run's own instance of the software plugin */
+        std::future<void> done;
+    };
+    std::vector<SoftwareRun> runs;
+
+    /* The software checks only read the state of the system and don't depend on each other, so they
+     * are all started at once, each on its own instance of the plugin. Their results are reported
+     * in order below */
+    for (Test *test : testsList)
+    {
+        unsigned int vecSize = test->getArgVectorSize(Test::NVVS_CLASS_SOFTWARE);
+        for (unsigned int i = 0; i < vecSize; i++)
+        {
+            SoftwareRun run;
+            run.test        = test;
+            run.tp          = test->popArgVectorElement(Test::NVVS_CLASS_SOFTWARE);
+            run.name        = run.tp->GetString(PS_PLUGIN_NAME);
+            run.pluginIndex = GetPluginIndex(Test::NVVS_CLASS_SOFTWARE, run.name);
+
+            if (run.pluginIndex != -1 && !skipRest && !main_should_stop)
+            {
+                AddSoftwareTestParameters(run.name, run.tp);
+
+                PluginLib const &shared = *m_plugins[run.pluginIndex];
+                run.plugin              = LoadPluginInstance(shared.GetPath(), shared.GetName());
+                if (run.plugin != nullptr)
+                {
+                    run.done = std::async(
+                        std::launch::async, [p = run.plugin.get(), tp = run.tp]() { p->RunTest(600, tp); });
+                }
+                else
+                {
+                    run.runHere = true;
+                }
+            }
+
+            runs.push_back(std::move(run));
+        }
+    }
+
+    for (SoftwareRun &run : runs)
+    {
+        if (run.pluginIndex == -1)
+        {
+            // Error! Didn't find the named plugin. Report fake results for it
+            ReportMissingPlugin(run.name);
+            continue;
+        }
+
+        output->prep(run.name);
+
+        /* If the test hasn't been run, the shared instance's results are empty, which is treated
+         * as the test being skipped */
+        PluginLib *plugin = m_plugins[run.pluginIndex].get();
+        bool ran          = false;
+        if (run.done.valid())
+        {
+            run.done.wait();
+            plugin = run.plugin.get();
+            ran    = true;
+        }
+        else if (run.runHere && !main_should_stop)
+        {
+            plugin->RunTest(600, run.tp);
+            ran = true;
+        }
+
+        if (ran && nvvsCommon.training)
+        {
+            EvaluateTestTraining(run.test);
+        }
+        else
+        {
+            output->Result(plugin->GetResult(), plugin->GetResults(), plugin->GetErrors(), plugin->GetInfo());
+        }
+
+        if (ran && plugin == m_plugins[run.pluginIndex].get())
+        {
+            /* reinitialize plugin, reset errors between software runs */
+            plugin->InitializePlugin(dcgmHandle.GetHandle(), m_gpuInfo);
+        }
+
+        DCGM_LOG_DEBUG << "Test " << run.name << " had over result " << plugin->GetResult() << ". Configless is "
+                       << nvvsCommon.configless;
+
+        /* Software failures don't set skipRest. When these ran one by one, the plugin was reinitialized,
+         * clearing its results, before its result was checked */
+    }
+}
+
 /*****************************************************************************/
 void TestFramework::goList(Test::testClasses_enum classNum, std::vector<Test *> testsList, std::vector<Gpu *> gpuList)
 {
     GetAndOutputHeader(classNum);
 
+    if (classNum == Test::NVVS_CLASS_SOFTWARE)
+    {
+        goSoftwareList(testsList);
+        return;
+    }
+
     // iterate through all tests giving them the GPU objects needed
     for (std::vector<Test *>::iterator testItr = testsList.begin(); testItr != testsList.end(); testItr++)
     {
@@ -663,52 +827,23 @@ void TestFramework::goList(Test::testClasses_enum classNum, std::vector<Test *>
             if (pluginIndex == -1)
             {
                 // Error! Didn't find the named plugin. Report fake results for it
-                DCGM_LOG_ERROR << "Couldn't find the plugin '" << name << "'";
-                std::vector<dcgmDiagSimpleResult_t> perGpuResults;
-                std::vector<dcgmDiagEvent_t> errors;
-                std::vector<dcgmDiagEvent_t> info;
-                dcgmDiagEvent_t error = {};
-                error.errorCode       = -1;
-                error.gpuId           = -1;
-                snprintf(error.msg, sizeof(error.msg), "Unable to find plugin '%s'", name.c_str());
-                errors.push_back(error);
-
-                output->Result(NVVS_RESULT_FAIL, perGpuResults, errors, info);
+                ReportMissingPlugin(name);
                 continue;
             }
 
             output->prep(name);
             if (!skipRest && !main_should_stop)
             {
-                if (classNum == Test::NVVS_CLASS_SOFTWARE)
-                {
-                    if (!nvvsCommon.requirePersistenceMode)
-                        tp->AddString(SW_STR_REQUIRE_PERSISTENCE, "False");
-                    if (name == "Blacklist")
-                        tp->AddString(SW_STR_DO_TEST, "blacklist");
-                    else if (name == "NVML Library")
-                        tp->AddString(SW_STR_DO_TEST, "libraries_nvml");
-                    else if (name == "CUDA Main Library")
-                        tp->AddString(SW_STR_DO_TEST, "libraries_cuda");
-                    else if (name == "CUDA Toolkit Libraries")
-                        tp->AddString(SW_STR_DO_TEST, "libraries_cudatk");
-                    else if (name == "Permissions and OS-related Blocks")
-                        tp->AddString(SW_STR_DO_TEST, "permissions");
-                    else if (name == "Persistence Mode")
-                        tp->AddString(SW_STR_DO_TEST, "persistence_mode");
-                    else if (name == "Environmental Variables")
-                        tp->AddString(SW_STR_DO_TEST, "env_variables");
-                    else if (name == "Page Retirement/Row Remap")
-                        tp->AddString(SW_STR_DO_TEST, "page_retirement");
-                    else if (name == "Graphics Processes")
-                        tp->AddString(SW_STR_DO_TEST, "graphics_processes");
-                    else if (name == "Inforom")
-                        tp->AddString(SW_STR_DO_TEST, "inforom");
-                }
-
                 DcgmRecorder dcgmRecorder(dcgmHandle.GetHandle());
 
-                m_plugins[pluginIndex]->RunTest(600, tp);
+                if (nvvsCommon.failFast)
+                {
+                    RunTestFailFast(pluginIndex, tp, gpuList);
+                }
+                else
+                {
+                    m_plugins[pluginIndex]->RunTest(600, tp);
+                }
 
                 if (nvvsCommon.training)
                 {
@@ -721,12 +856,6 @@ void TestFramework::goList(Test::testClasses_enum classNum, std::vector<Test *>
                                    m_plugins[pluginIndex]->GetErrors(),
                                    m_plugins[pluginIndex]->GetInfo());
                 }
-
-                if (classNum == Test::NVVS_CLASS_SOFTWARE)
-                {
-                    /* reinitialize plugin, reset errors between software runs */
-                    m_plugins[pluginIndex]->InitializePlugin(dcgmHandle.GetHandle(), m_gpuInfo);
-                }
             }
             else
             {
@@ -750,6 +879,35 @@ void TestFramework::goList(Test::testClasses_enum classNum, std::vector<Test *>
     }
 }
 
+/*****************************************************************************/
+void TestFramework::RunTestFailFast(int pluginIndex, TestParameters *tp, std::vector<Gpu *> const &gpuList)
+{
+    std::vector<unsigned int> gpuIds;
+    for (auto const &gpu : gpuList)
+    {
+        gpuIds.push_back(gpu->GetGpuId());
+    }
+
+    FailFastMonitor monitor(dcgmHandle.GetHandle(), gpuIds, nvvsCommon.failCheckInterval);
+    if (monitor.Start() != 0)
+    {
+        DCGM_LOG_ERROR << "Could not start the fail fast monitor. Fatal errors will only be checked for after "
+                       << m_plugins[pluginIndex]->GetName() << " finishes";
+    }
+
+    m_plugins[pluginIndex]->RunTest(600, tp);
+
+    monitor.StopAndWait(0);
+
+    /* Catch errors that came in after the last check */
+    if (monitor.CheckForFatalErrors())
+    {
+        output->addInfoStatement(monitor.GetFatalError());
+        skipRest = true;
+    }
+}
+
+/*****************************************************************************/
 void TestFramework::addInfoStatement(const std::string &info)
 {
     output->addInfoStatement(info);
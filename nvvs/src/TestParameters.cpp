@@ -16,6 +16,7 @@
 #include "TestParameters.h"
 #include "NvvsCommon.h"
 #include "float.h"
+#include <DcgmNumberFormat.h>
 #include <cstdlib>
 #include <sstream>
 
@@ -73,11 +74,9 @@ int TestParameterValue::Set(std::string value)
         return 0;
     }
 
-    m_doubleValue = atof(value.c_str());
-    if (m_doubleValue == 0.0 && value.c_str()[0] != '0')
+    if (!DcgmNs::ParseDouble(value, m_doubleValue))
     {
-        m_doubleValue = beforeDoubleValue;
-        return TP_ST_CANTCOERCE; /* atof failed. Must be a bad value */
+        return TP_ST_CANTCOERCE; /* Not a number. m_doubleValue is untouched */
     }
     else if ((m_doubleValue < m_doubleMinValue || m_doubleValue > m_doubleMaxValue) && !nvvsCommon.overrideMinMax)
     {
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TestPlanCache.h"
+#include "DcgmLogging.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <utility>
+#include <vector>
+
+namespace
+{
+char const planMagic[8]          = { 'N', 'V', 'V', 'S', 'P', 'L', 'A', 'N' };
+std::uint32_t const planFormat   = 1; /* Bump when the layout below changes */
+char const planFileExtension[]   = ".plan";
+unsigned char const globalScope  = 0; /* A parameter of the test rather than of a subtest */
+unsigned char const subTestScope = 1;
+
+/*
+ * A plan file is the magic, the format, the key, then each entry as its name and
+ * its parameters. Numbers are in host byte order since a plan never leaves the
+ * machine. Strings are their length followed by their bytes
+ */
+template <typename T>
+void AppendValue(std::string &out, T value)
+{
+    out.append(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+void AppendString(std::string &out, std::string const &value)
+{
+    AppendValue(out, (std::uint32_t)value.size());
+    out.append(value);
+}
+
+template <typename T>
+bool ReadValue(std::string const &in, size_t &offset, T &value)
+{
+    if (in.size() - offset < sizeof(value))
+    {
+        return false;
+    }
+    memcpy(&value, in.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+bool ReadString(std::string const &in, size_t &offset, std::string &value)
+{
+    std::uint32_t size;
+    if (!ReadValue(in, offset, size) || in.size() - offset < size)
+    {
+        return false;
+    }
+    value.assign(in, offset, size);
+    offset += size;
+    return true;
+}
+
+/* 64-bit FNV-1a */
+std::uint64_t HashKey(std::string const &key)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool IsPlanFile(std::string const &name)
+{
+    size_t const extensionLength = sizeof(planFileExtension) - 1;
+    return name.size() > extensionLength
+           && name.compare(name.size() - extensionLength, extensionLength, planFileExtension) == 0;
+}
+} // namespace
+
+/*****************************************************************************/
+TestPlanCache::TestPlanCache(std::string directory)
+    : m_directory(std::move(directory))
+    , m_key()
+    , m_path()
+    , m_entries()
+    , m_dirty(false)
+{}
+
+/*****************************************************************************/
+void TestPlanCache::SerializeParameters(TestParameters const &tp, std::string &out)
+{
+    auto appendValue = [&out](unsigned char scope,
+                              std::string const &subTest,
+                              std::string const &name,
+                              TestParameterValue const &value) {
+        AppendValue(out, scope);
+        AppendString(out, subTest);
+        AppendString(out, name);
+        AppendValue(out, (std::int32_t)value.m_valueType);
+        if (value.m_valueType == TP_T_STRING)
+        {
+            AppendString(out, value.m_stringValue);
+        }
+        else
+        {
+            AppendValue(out, value.m_doubleValue);
+            AppendValue(out, value.m_doubleMinValue);
+            AppendValue(out, value.m_doubleMaxValue);
+        }
+    };
+
+    std::uint32_t numValues = tp.m_globalParameters.size();
+    for (auto const &[subTest, parameters] : tp.m_subTestParameters)
+    {
+        numValues += parameters.size();
+    }
+    AppendValue(out, numValues);
+
+    for (auto const &[name, value] : tp.m_globalParameters)
+    {
+        appendValue(globalScope, "", name, *value);
+    }
+    for (auto const &[subTest, parameters] : tp.m_subTestParameters)
+    {
+        for (auto const &[name, value] : parameters)
+        {
+            appendValue(subTestScope, subTest, name, *value);
+        }
+    }
+}
+
+/*****************************************************************************/
+bool TestPlanCache::DeserializeParameters(std::string const &in, size_t &offset, TestParameters &tp)
+{
+    std::uint32_t numValues;
+    if (!ReadValue(in, offset, numValues))
+    {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < numValues; i++)
+    {
+        unsigned char scope;
+        std::string subTest;
+        std::string name;
+        std::int32_t valueType;
+        if (!ReadValue(in, offset, scope) || !ReadString(in, offset, subTest) || !ReadString(in, offset, name)
+            || !ReadValue(in, offset, valueType))
+        {
+            return false;
+        }
+
+        std::unique_ptr<TestParameterValue> value;
+        if (valueType == TP_T_STRING)
+        {
+            std::string stringValue;
+            if (!ReadString(in, offset, stringValue))
+            {
+                return false;
+            }
+            value = std::make_unique<TestParameterValue>(stringValue);
+        }
+        else if (valueType == TP_T_DOUBLE)
+        {
+            double doubleValue;
+            double minValue;
+            double maxValue;
+            if (!ReadValue(in, offset, doubleValue) || !ReadValue(in, offset, minValue)
+                || !ReadValue(in, offset, maxValue))
+            {
+                return false;
+            }
+            /* Set directly since --parms may have put the value out of its range with overrideMinMax */
+            value = std::make_unique<TestParameterValue>(doubleValue, minValue, maxValue);
+        }
+        else
+        {
+            return false;
+        }
+
+        TestParameterValue *&slot
+            = (scope == globalScope) ? tp.m_globalParameters[name] : tp.m_subTestParameters[subTest][name];
+        delete slot;
+        slot = value.release();
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+bool TestPlanCache::Load(std::string const &key)
+{
+    m_key = key;
+    m_entries.clear();
+    m_dirty = false;
+
+    if (m_directory.empty())
+    {
+        return false;
+    }
+
+    std::stringstream path;
+    path << m_directory << "/" << std::hex << std::setw(16) << std::setfill('0') << HashKey(key)
+         << planFileExtension;
+    m_path = path.str();
+
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file.good())
+    {
+        DCGM_LOG_DEBUG << "No test plan at " << m_path;
+        return false;
+    }
+
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    size_t offset = 0;
+    std::uint32_t format;
+    std::string fileKey;
+    std::uint32_t numEntries;
+
+    if (contents.compare(0, sizeof(planMagic), planMagic, sizeof(planMagic)) != 0)
+    {
+        DCGM_LOG_WARNING << "Ignoring test plan " << m_path << " that isn't a plan file";
+        return false;
+    }
+    offset = sizeof(planMagic);
+
+    if (!ReadValue(contents, offset, format) || format != planFormat)
+    {
+        DCGM_LOG_DEBUG << "Ignoring test plan " << m_path << " of another format";
+        return false;
+    }
+
+    if (!ReadString(contents, offset, fileKey) || fileKey != key)
+    {
+        DCGM_LOG_DEBUG << "Ignoring test plan " << m_path << " of another key";
+        return false;
+    }
+
+    if (!ReadValue(contents, offset, numEntries))
+    {
+        DCGM_LOG_WARNING << "Ignoring truncated test plan " << m_path;
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < numEntries; i++)
+    {
+        std::string entry;
+        auto tp = std::make_unique<TestParameters>();
+        if (!ReadString(contents, offset, entry) || !DeserializeParameters(contents, offset, *tp))
+        {
+            DCGM_LOG_WARNING << "Ignoring truncated test plan " << m_path;
+            m_entries.clear();
+            return false;
+        }
+        m_entries[entry] = std::move(tp);
+    }
+
+    /* Mark the plan as used so that it is pruned last */
+    utime(m_path.c_str(), nullptr);
+
+    DCGM_LOG_DEBUG << "Loaded " << m_entries.size() << " test plan entries from " << m_path;
+    return true;
+}
+
+/*****************************************************************************/
+bool TestPlanCache::Get(std::string const &entry, TestParameters &tp) const
+{
+    auto it = m_entries.find(entry);
+    if (it == m_entries.end())
+    {
+        return false;
+    }
+
+    tp = *it->second;
+    return true;
+}
+
+/*****************************************************************************/
+void TestPlanCache::Put(std::string const &entry, TestParameters const &tp)
+{
+    if (m_directory.empty())
+    {
+        return;
+    }
+
+    auto copy = std::make_unique<TestParameters>();
+    *copy     = tp;
+
+    m_entries[entry] = std::move(copy);
+    m_dirty          = true;
+}
+
+/*****************************************************************************/
+void TestPlanCache::Save()
+{
+    if (!m_dirty || m_path.empty())
+    {
+        return;
+    }
+
+    if (mkdir(m_directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        DCGM_LOG_DEBUG << "Not saving the test plan since " << m_directory << " can't be created: " << strerror(errno);
+        return;
+    }
+
+    std::string contents(planMagic, sizeof(planMagic));
+    AppendValue(contents, planFormat);
+    AppendString(contents, m_key);
+    AppendValue(contents, (std::uint32_t)m_entries.size());
+    for (auto const &[entry, tp] : m_entries)
+    {
+        AppendString(contents, entry);
+        SerializeParameters(*tp, contents);
+    }
+
+    /* Written aside and renamed so that a concurrent run never reads half a plan */
+    std::stringstream tmpPath;
+    tmpPath << m_path << "." << getpid() << ".tmp";
+    {
+        std::ofstream file(tmpPath.str(), std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), contents.size());
+        if (!file.good())
+        {
+            DCGM_LOG_DEBUG << "Unable to write the test plan to " << tmpPath.str();
+            file.close();
+            unlink(tmpPath.str().c_str());
+            return;
+        }
+    }
+
+    if (rename(tmpPath.str().c_str(), m_path.c_str()) != 0)
+    {
+        DCGM_LOG_DEBUG << "Unable to rename " << tmpPath.str() << " to " << m_path << ": " << strerror(errno);
+        unlink(tmpPath.str().c_str());
+        return;
+    }
+
+    m_dirty = false;
+    DCGM_LOG_DEBUG << "Saved " << m_entries.size() << " test plan entries to " << m_path;
+
+    PruneOldPlans();
+}
+
+/*****************************************************************************/
+void TestPlanCache::PruneOldPlans()
+{
+    DIR *dir = opendir(m_directory.c_str());
+    if (dir == nullptr)
+    {
+        return;
+    }
+
+    std::vector<std::pair<time_t, std::string>> plans; /* Last use and path */
+    struct dirent *dirent;
+    while ((dirent = readdir(dir)) != nullptr)
+    {
+        std::string name(dirent->d_name);
+        if (!IsPlanFile(name))
+        {
+            continue;
+        }
+
+        std::string path = m_directory + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0)
+        {
+            plans.emplace_back(st.st_mtime, std::move(path));
+        }
+    }
+    closedir(dir);
+
+    if (plans.size() <= TPC_MAX_PLANS)
+    {
+        return;
+    }
+
+    std::sort(plans.begin(), plans.end());
+    for (size_t i = 0; i < plans.size() - TPC_MAX_PLANS; i++)
+    {
+        DCGM_LOG_DEBUG << "Removing least recently used test plan " << plans[i].second;
+        unlink(plans[i].second.c_str());
+    }
+}
@@ -13,6 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <stdexcept>
 
 #include "ParsingUtility.h"
@@ -20,12 +23,1592 @@
 #include "Whitelist.h"
 #include <dcgm_fields.h>
 
+namespace
+{
+/*
+ * The whitelist is compiled in as constant tables, one per SKU, so that NVVS doesn't have to build the test
+ * parameters of every known SKU at startup. TestParameters are only made for the SKUs that are looked up.
+ */
+
+/* A whitelisted test parameter. stringValue is nullptr for doubles, subtest is nullptr for test-wide parameters */
+struct WhitelistParameter
+{
+    const char *testName;
+    const char *subtest;
+    const char *name;
+    const char *stringValue;
+    double value;
+    double min;
+    double max;
+};
+
+struct WhitelistSku
+{
+    const char *deviceId;
+    const WhitelistParameter *parameters;
+    size_t numParameters;
+    bool requiresGlobalChanges; /* See Whitelist::UpdateGlobalsForDeviceId() */
+};
+
+constexpr WhitelistParameter String(const char *testName, const char *name, const char *value)
+{
+    return { testName, nullptr, name, value, 0.0, 0.0, 0.0 };
+}
+
+constexpr WhitelistParameter Double(const char *testName, const char *name, double value, double min, double max)
+{
+    return { testName, nullptr, name, nullptr, value, min, max };
+}
+
+constexpr WhitelistParameter SubTestDouble(const char *testName,
+                                           const char *subtest,
+                                           const char *name,
+                                           double value,
+                                           double min,
+                                           double max)
+{
+    return { testName, subtest, name, nullptr, value, min, max };
+}
+
+// Tesla K8
+constexpr WhitelistParameter c_params1194[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 75.0, 65.0, 115.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 330.0, 30.0, 500.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 330.0, 30.0, 500.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K80 ("Stella Duo" Gemini)
+constexpr WhitelistParameter c_params102d[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 148.0, 70.0, 149.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 950.0, 30.0, 1200.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 950.0, 30.0, 1200.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// GP100 SKU 201 - (based on
+// http://teams.nvidia.com/sites/gpu/ae/Tesla/Lists/Pascal%20Board%20Lineup/Standard%20View1.aspx)
+constexpr WhitelistParameter c_params15fa[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 70.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// GP100 SKU 200 - (based on
+// http://teams.nvidia.com/sites/gpu/ae/Tesla/Lists/Pascal%20Board%20Lineup/Standard%20View1.aspx)
+constexpr WhitelistParameter c_params15fb[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 70.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// GP100 SKU 201 - (based on
+// http://teams.nvidia.com/sites/gpu/ae/Tesla/Lists/Pascal%20Board%20Lineup/Standard%20View1.aspx) DGX Station GP100
+constexpr WhitelistParameter c_params15fc[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 700.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 150.0, 300.0),
+    Double(TP_PLUGIN_NAME, TP_STR_OPS_PER_REQUEUE, 16.0, 1.0, 32.0),
+    // Can't achieve target without higher concurrency
+    // Double(TP_PLUGIN_NAME, TP_STR_CUDA_STREAMS_PER_GPU, 8.0, 1.0, 48.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// COPIED from -- GP100 SKU 203 - DB2 HBM2
+// Tesla P100-PCIE-16GB
+// Serial Number : PH400-C01-P0203
+constexpr WhitelistParameter c_params15f8[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 400.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 70.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla P100-PCIE-12GB
+// Serial Number : PH400 SKU 202
+constexpr WhitelistParameter c_params15f7[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 400.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 70.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// GP100 Bringup - eris-l64-test12*
+constexpr WhitelistParameter c_params15ff[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 70.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla P100-SXM2-16GB
+constexpr WhitelistParameter c_params15f9[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 70.0, 300.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla Stella Solo - Internal only
+constexpr WhitelistParameter c_params102f[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 234.0, 150.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 900.0, 200.0, 1700.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 1000.0, 100.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K40d ("Stella" DFF)
+constexpr WhitelistParameter c_params102e[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 234.0, 120.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 200.0, 100.0, 210.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 200.0, 100.0, 210.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K40m
+constexpr WhitelistParameter c_params1023[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 200.0, 150.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 10.0),
+    // Change max if TP_MAX_DIMENSION changes in TargetedPower
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 600.0, 1.0, 1024.0),
+    Double(TP_PLUGIN_NAME, TP_STR_MAX_GRAPHICS_CLOCK, 811.0, 666.0, 876.0),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 1300.0, 200.0, 1500.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 200.0, 150.0, 235.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K40c
+constexpr WhitelistParameter c_params1024[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 134.0, 100.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 1300.0, 200.0, 1500.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 1300.0, 200.0, 1500.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K40t ("Atlas" TTP) - values copied from Tesla K40c
+constexpr WhitelistParameter c_params102a[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 234.0, 120.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 900.0, 200.0, 1500.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1500.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K40s - values copied from Tesla K40c
+constexpr WhitelistParameter c_params1029[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 234.0, 150.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 550.0, 200.0, 630.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 550.0, 200.0, 630.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K20X - values copied from Tesla K20xm
+constexpr WhitelistParameter c_params101e[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 234.0, 150.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K20Xm
+constexpr WhitelistParameter c_params1021[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 234.0, 150.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K20c - values copied from Tesla K20xm (except power)
+constexpr WhitelistParameter c_params1022[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 224.0, 150.0, 225.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K20m - values copied from Tesla K20xm
+constexpr WhitelistParameter c_params1028[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 234.0, 150.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K20X
+constexpr WhitelistParameter c_params1020[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 234.0, 150.0, 235.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla K10
+constexpr WhitelistParameter c_params118f[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 116.0, 80.0, 117.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 700.0, 100.0, 900.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 700.0, 100.0, 900.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Quadro M6000 //Not supported officially for NVVS
+constexpr WhitelistParameter c_params17f0[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 80.0, 250.0),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 1000.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 4000.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 200000.0, 1.0, 1000000.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+};
+
+// Quadro M5000
+constexpr WhitelistParameter c_params13f0[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 149.0, 10.0, 150.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 1000.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 4000.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// GeForce GTX TITAN X
+constexpr WhitelistParameter c_params17c2[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 80.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    // Can't achieve target without higher concurrency
+    Double(TP_PLUGIN_NAME, TP_STR_CUDA_STREAMS_PER_GPU, 8.0, 1.0, 48.0),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 1000.0, 100.0, 900000.0),
+    Double(TS_PLUGIN_NAME, TS_STR_MAX_MEMORY_CLOCK, 3301.0, 0.0, 3600.0),
+    Double(TS_PLUGIN_NAME, TS_STR_MAX_GRAPHICS_CLOCK, 0.0, 0.0, 1500.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 2000.0, 100.0, 9000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MAX_MEMORY_CLOCK, 3301.0, 0.0, 3600.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MAX_GRAPHICS_CLOCK, 0.0, 0.0, 1500.0),
+    Double(PCIE_PLUGIN_NAME, PCIE_STR_MAX_MEMORY_CLOCK, 3301.0, 0.0, 3600.0),
+    Double(PCIE_PLUGIN_NAME, PCIE_STR_MAX_GRAPHICS_CLOCK, 0.0, 0.0, 1500.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla M60
+constexpr WhitelistParameter c_params13f2[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 161.0, 80.0, 162.0),
+    Double(TP_PLUGIN_NAME, TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0),
+    Double(TP_PLUGIN_NAME, TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0),
+    Double(TP_PLUGIN_NAME, TP_STR_CONTROLLER_KI, 0.5, 0.0, 100.0), // Power lags the load on this SKU
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    // Can't achieve target without higher concurrency
+    // Double(TP_PLUGIN_NAME, TP_STR_CUDA_STREAMS_PER_GPU, 8.0, 1.0, 48.0),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla M6 (Copied from Tesla M60)
+constexpr WhitelistParameter c_params13f3[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 161.0, 80.0, 162.0),
+    Double(TP_PLUGIN_NAME, TP_STR_MAX_GRAPHICS_CLOCK, 1130.0, 0.0, 1200.0), /* 1177 max so far */
+    Double(TP_PLUGIN_NAME, TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0),
+    Double(TP_PLUGIN_NAME, TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0),
+    Double(TP_PLUGIN_NAME, TP_STR_CONTROLLER_KI, 0.5, 0.0, 100.0), // Power lags the load on this SKU
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla M40
+constexpr WhitelistParameter c_params17fd[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 100.0, 250.0),
+    Double(TP_PLUGIN_NAME, TP_STR_MAX_GRAPHICS_CLOCK, 1113.0, 0.0, 1200.0),
+    Double(TP_PLUGIN_NAME, TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0),
+    Double(TP_PLUGIN_NAME, TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0),
+    Double(TP_PLUGIN_NAME, TP_STR_CONTROLLER_KI, 0.5, 0.0, 100.0), // Power lags the load on this SKU
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla M4
+constexpr WhitelistParameter c_params1431[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 74.0, 20.0, 75.0),
+    Double(TP_PLUGIN_NAME, TP_STR_MAX_GRAPHICS_CLOCK, 1113.0, 0.0, 1200.0),
+    Double(TP_PLUGIN_NAME, TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0),
+    Double(TP_PLUGIN_NAME, TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0),
+    Double(TP_PLUGIN_NAME, TP_STR_CONTROLLER_KI, 0.5, 0.0, 100.0), // Power lags the load on this SKU
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla M10
+// Mostly copied from Tesla M40
+constexpr WhitelistParameter c_params13bd[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 53.0, 26.5, 53.0),
+    Double(TP_PLUGIN_NAME, TP_STR_MAX_GRAPHICS_CLOCK, 1032.0, 0.0, 1202.0),
+    Double(TP_PLUGIN_NAME, TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0),
+    Double(TP_PLUGIN_NAME, TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0),
+    Double(TP_PLUGIN_NAME, TP_STR_CONTROLLER_KI, 0.5, 0.0, 100.0), // Power lags the load on this SKU
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla GV100 DGX1-V
+// Serial Number: PG503-A00-P0447
+constexpr WhitelistParameter c_params1dbd[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_MAX_GRAPHICS_CLOCK, 1140.0, 0.0, 1455.0),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 50.0, 300.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla GV100 DGX Station - Part number 692-2G500-0201-300
+constexpr WhitelistParameter c_params1db2[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 100.0, 300.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3350.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla GV100 SXM2-32GB SKU 895
+constexpr WhitelistParameter c_params1db1[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 100.0, 300.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3350.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3500.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla GV100 SXM2-16GB SKU 890
+constexpr WhitelistParameter c_params1db0[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 100.0, 300.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3500.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla GV100 PCIE-16GB SKU 893
+constexpr WhitelistParameter c_params1db4[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 100.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3500.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla V100 PCI-E-32GB (Passive) - PG500 SKU 202
+constexpr WhitelistParameter c_params1db6[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 100.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3500.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla P40
+constexpr WhitelistParameter c_params1b38[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 125.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3500.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 6000.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla P10
+// "Same as Tesla P40 (PG610 SKU200 GP102-895) but with a lower power target (150W vs 250W))"
+// https://confluence.nvidia.com/display/CSWPM/Pascal+Board+Schedule
+constexpr WhitelistParameter c_params1b39[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 149.0, 75.0, 150.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 2100.0, 30.0, 10000.0), // P40 perf 3500 adjusted for 250->150 TDP
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // P40 perf 6000 adjusted for 250->150 TDP
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3600.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla P6
+constexpr WhitelistParameter c_params1bb4[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 89.0, 70.0, 90.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3750.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // Got 152.35 consistently in testing. taking 25% off this
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 114263.0, 1.0, 1000000.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla P4
+constexpr WhitelistParameter c_params1bb3[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 50.0, 45.0, 50.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3750.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // 1273750 = .75 * 165000. Was higher previously, see http://nvbugs/200480825 for details.
+    // Lowered to 123750 as part of standardizing at 75%
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 123750.0, 1.0, 1000000.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla V100-HS
+constexpr WhitelistParameter c_params1db3[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 149.0, 75.0, 150.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 2250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // V100 has a DGEMM performance of 7000 and max power level of 250, so
+    // we'll set this to 7000 * .75 (to back off) * 3/5 (relative power ratio)
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 3150.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla V100 32GB
+constexpr WhitelistParameter c_params1db5[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 100.0, 300.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 4250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // V100 has a DGEMM performance of 7000 and max power level of 250, close enough
+    // to 300 given Max Q, so we'll set this to 5250 = 7000 * .75 to backs off to 75%.
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 5250.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0),
+};
+
+// Tesla V100 DGX-Station 32GB
+constexpr WhitelistParameter c_params1db7[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 100.0, 300.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 4250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // V100 has a DGEMM performance of 7000 and max power level of 250, close enough
+    // to 300 given Max Q, so we'll set this to 5250 = 7000 * .75 to backs off to 75%.
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 5250.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla V100 DGX-Station 32GB
+constexpr WhitelistParameter c_params1db8[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 349.0, 100.0, 350.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 4250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // V100 has a DGEMM performance of 7000 and max power level of 250, close enough
+    // to 350 given Max Q, so we'll set this to 5250 = 7000 * .75 to backs off to 75%.
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 5250.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // Datasheet states 900 as the max. 900 * 0.75 = 675
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 675000.0, 1.0, 1000000.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+};
+
+// Tesla T4 - TU104_PG183_SKU200
+constexpr WhitelistParameter c_params1eb8[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 65.0, 60.0, 70.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3150.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // T4 has an SGEMM performance of 5500 * .75 backs it off to 4125
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 4125.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 8.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 8.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // Spec sheet says 672000, but experimentally we get about 244000 MB/s so we'll go with .75 of that
+    // Update value when bug 200480825 is fully root caused and resolved
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 183000.0, 1.0, 1000000.0),
+};
+
+// Tesla T40 - TU102-895
+constexpr WhitelistParameter c_params1e38[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 200.0, 250.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 5250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // T40 has an SGEMM performance of 14746; multiply by .85 to get 12534
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 12534.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // Spec sheet says 448000, multiply by .75 to 336000
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 336000.0, 1.0, 1000000.0),
+};
+
+// Tesla T10 - PG150 SKU 220
+constexpr WhitelistParameter c_params1e37[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 149.0, 100.0, 150.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 7295.0, 30.0, 10000.0), // Copied from SMSTRESS_STR_TARGET_PERF
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // T10 has an SGEMM performance of 8583 in dcgmproftester -t 1007; multiply by .85 to get 7295
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 7295.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // Got 304500 GB/s with dcgmproftester -t 1005, multiply by .75 to 228375
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 228375.0, 1.0, 403264.0),
+};
+
+// V100S
+constexpr WhitelistParameter c_params1df6[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 200.0, 250.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 87.0, 40.0, 90.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // V100S has a DGEMM performance of 7000; multiply by .75 to get 5250
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 5250.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 87.0, 40.0, 90.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // Spec sheet says 900000, multiply by .75 to 675000
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 675000.0, 1.0, 1000000.0),
+};
+
+// RTX 8000 and 6000 (Quadro)
+// This whitelist covers both because they use the same PCI Device Id, so the settings are the
+// lowest value between the two
+constexpr WhitelistParameter c_params1e30[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 259.0, 200.0, 260.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 3250.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // RTX 6000 and 8000 had a SGEMM performance of 13000 in dcgmproftester -t 1007; multiply by .75 to get 9750
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 9750.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1005 for the 8000 says 553700, multiply by .75 to 415275 (6000 was 672100, but we take
+    // the lower value)
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 415275.0, 1.0, 1000000.0),
+};
+
+// GA100 available through QA
+constexpr WhitelistParameter c_params20bf[] = {
+    // The targeted power test is not working due to http://nvbugs/2808294. This test should be allowed once
+    // that bug is fixed.
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 199.0, 150.0, 200.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 5000.0, 30.0, 10000.0),
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 5000.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // dcgmproftester measured -t 1006 at 10900; multiply by .75 to get 8175
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 8175.0, 30.0, 50000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // Measured ~1495000. Multiple by .75 to get 1121250
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 1121250.0, 1.0, 1000000.0),
+};
+
+// GA100 on luna systems
+constexpr WhitelistParameter c_params20b0[] = {
+    // Skip the targeted power test for the same reason as 20bf. Once this is fixed we can allow it.
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 399.0, 100.0, 400.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 89.0, 40.0, 92.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 5000.0, 30.0, 10000.0),
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 5000.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // proftester -t 1006 measures at 18300, multiply by .75 to get 13725
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 13725.0, 30.0, 50000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 89.0, 40.0, 92.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // proftester -t 1005 shows ~1830000. Multiply by .75 to get 1372500
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 137500.0, 1.0, 4000000.0),
+};
+
+// RTX 6000/8000 passive SKUs
+constexpr WhitelistParameter c_params1e78[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 249.0, 200.0, 250.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 9450.0, 30.0, 10000.0), // Copied from sm perf target
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // RTX 6000 and 8000 passive had a SGEMM performance of 12600 in dcgmproftester -t 1007; multiply by .75 to get 9450
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 9450.0, 30.0, 20000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1005 for the 8000 says 480300, multiply by .75 to 360225
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 360225.0, 1.0, 1000000.0),
+};
+
+// A100 PCIe
+constexpr WhitelistParameter c_params20f1[] = {
+    // Skip the targeted power test for the same reason as 20bf. Once this is fixed we can allow it.
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 100.0, 300.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 5963.0, 30.0, 10000.0), // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 5963.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // proftester -t 1006 measures at 7950, multiply by .75 to get 5963
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 5963.0, 30.0, 50000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // proftester -t 1005 shows ~1293000. Multiply by .75 to get 969750
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 969750.0, 1.0, 4000000.0),
+};
+
+// A100-SXM4-80GB
+constexpr WhitelistParameter c_params20b2[] = {
+    // Skip the targeted power test for the same reason as 20bf. Once this is fixed we can allow it.
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 399.0, 100.0, 400.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 85.0, 40.0, 92.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "True"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 6975.0, 30.0, 10000.0), // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 6975.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // proftester -t 1006 measures at ~9300, multiply by .75 to get 6975
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 6975.0, 30.0, 50000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "True"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // proftester -t 1005 shows ~1564000 GiB/sec. Multiply by .75 to get 1173000
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 1173000.0, 1.0, 4000000.0),
+};
+
+// A40
+constexpr WhitelistParameter c_params2235[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 100.0, 300.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 88.0, 40.0, 95.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 14250.0, 30.0, 10000.0), // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 14250.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // proftester -t 1007 measures at ~19000, multiply by .75 to get 14250
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 14250.0, 30.0, 50000.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 88.0, 40.0, 95.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // proftester -t 1005 shows ~564900 GiB/sec. Multiply by .75 to get 423675
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 423675.0, 1.0, 4000000.0),
+};
+
+// A10c/noc - PG133 SKU215
+constexpr WhitelistParameter c_params2236[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 149.0, 100.0, 150.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 90.0, 40.0, 98.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 6075.0, 30.0, 10000.0), // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 6075.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // proftester -t 1007 measures at ~8100, multiply by .75 to get 6075
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 6075.0, 30.0, 50000.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 90.0, 40.0, 98.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // proftester -t 1005 shows ~640700 GiB/sec. Multiply by .75 to get 480525
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 480525.0, 1.0, 4000000.0),
+};
+
+// A10g - PG133 SKU210
+constexpr WhitelistParameter c_params2237[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 100.0, 300.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 95.0, 40.0, 98.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 12750.0, 30.0, 10000.0), // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 12750.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // proftester -t 1007 measures at ~17000, multiply by .75 to get 12750
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 12750.0, 30.0, 50000.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 95.0, 40.0, 98.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // proftester -t 1005 shows ~483600 GiB/sec. Multiply by .75 to get 362700
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 362700.0, 1.0, 4000000.0),
+};
+
+// T4G
+constexpr WhitelistParameter c_params1eb4[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 69.0, 30.0, 70.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 85.0, 40.0, 93.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 2850.0, 30.0, 10000.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // proftester -t 1007 measures at ~3800, multiply by .75 to get 2850
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 2850.0, 30.0, 50000.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 85.0, 40.0, 93.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 8.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 8.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 4096.0, 1024.0, 4096.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // proftester -t 1005 shows ~243500 GiB/sec. Multiply by .75 to get ~182600
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 182600.0, 1.0, 4000000.0),
+};
+
+// A30
+constexpr WhitelistParameter c_params20b7[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 194.0, 100.0, 195.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 7050.0, 30.0, 10000.0), // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 7050.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1007 =~ 9400. 9400 * 0.75 = 7050
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 7050.5, 30.0, 50000.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1005 shows ~780000 MiB/sec. Multiply by .75 to get 585000
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 585000.0, 1.0, 4000000.0),
+};
+
+// Nvidia Turing Auto Module
+constexpr WhitelistParameter c_params1eba[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 188.0, 50.0, 189.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 105.0, 40.0, 105.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 5625.0, 30.0, 10000.0), // Copied from sm perf target
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1007 =~ 7500. 7500 * 0.75 = 5625
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 5625.0, 30.0, 50000.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 105.0, 40.0, 105.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 4096.0, 1024.0, 4096.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1005 shows ~298900 MiB/sec. Multiply by .75 to get 224000
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 224000.0, 1.0, 4000000.0),
+};
+
+// A6000 PCIe
+constexpr WhitelistParameter c_params2230[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 299.0, 50.0, 300.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 93.0, 40.0, 95.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 11475.0, 30.0, 10000.0), // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 11475.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1007 =~ 15300. 15300 * 0.75 = 11475
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 11475.0, 30.0, 50000.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 93.0, 40.0, 95.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 4096.0, 1024.0, 4096.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1005 shows ~674500 MiB/sec. Multiply by .75 to get ~506000
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 506000.0, 1.0, 4000000.0),
+};
+
+// PG506-230
+constexpr WhitelistParameter c_params20b6[] = {
+    String(TP_PLUGIN_NAME, TP_STR_IS_ALLOWED, "True"),
+    Double(TP_PLUGIN_NAME, TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TARGET_POWER, 194.0, 100.0, 195.0),
+    Double(TP_PLUGIN_NAME, TP_STR_TEMPERATURE_MAX, 82.0, 40.0, 85.0),
+    String(TP_PLUGIN_NAME, TP_STR_USE_DGEMM, "False"),
+    String(TS_PLUGIN_NAME, TS_STR_IS_ALLOWED, "True"),
+    String(TS_PLUGIN_NAME, TS_STR_USE_DGEMM, "False"),
+    Double(TS_PLUGIN_NAME, TS_STR_TARGET_PERF, 15750.0, 30.0, 10000.0), // Copied from sm perf target
+    Double(TS_PLUGIN_NAME, TS_STR_TENSOR_TARGET_PERF, 15750.0, 30.0, 100000.0), // Copied from target_stress
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1007 =~ 21000. 21000 * 0.75 = 15750
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TARGET_PERF, 15750.0, 30.0, 50000.0),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0),
+    String(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_USE_DGEMM, "False"),
+    Double(SMSTRESS_PLUGIN_NAME, SMSTRESS_STR_TEMPERATURE_MAX, 82.0, 40.0, 85.0),
+    String(PCIE_PLUGIN_NAME, PCIE_STR_IS_ALLOWED, "True"),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0),
+    SubTestDouble(PCIE_PLUGIN_NAME, PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0),
+    String(MEMORY_PLUGIN_NAME, MEMORY_STR_IS_ALLOWED, "True"),
+    Double(MEMORY_PLUGIN_NAME, MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0),
+    String(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_IS_ALLOWED, "True"),
+    Double(DIAGNOSTIC_PLUGIN_NAME, DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0),
+    String(MEMBW_PLUGIN_NAME, MEMBW_STR_IS_ALLOWED, "True"),
+    // dcgmproftester -t 1005 shows ~1829800 MiB/sec. Multiply by .75 to get 1372350
+    Double(MEMBW_PLUGIN_NAME, MEMBW_STR_MINIMUM_BANDWIDTH, 1372350.0, 1.0, 4000000.0),
+};
+
+/* Sorted by device ID */
+constexpr WhitelistSku c_whitelist[] = {
+    { "101e", c_params101e, std::size(c_params101e), false },
+    { "1020", c_params1020, std::size(c_params1020), false },
+    { "1021", c_params1021, std::size(c_params1021), false },
+    { "1022", c_params1022, std::size(c_params1022), false },
+    { "1023", c_params1023, std::size(c_params1023), false },
+    { "1024", c_params1024, std::size(c_params1024), false },
+    { "1028", c_params1028, std::size(c_params1028), false },
+    { "1029", c_params1029, std::size(c_params1029), false },
+    { "102a", c_params102a, std::size(c_params102a), false },
+    { "102d", c_params102d, std::size(c_params102d), true },
+    { "102e", c_params102e, std::size(c_params102e), false },
+    { "102f", c_params102f, std::size(c_params102f), false },
+    { "118f", c_params118f, std::size(c_params118f), false },
+    { "1194", c_params1194, std::size(c_params1194), false },
+    { "13bd", c_params13bd, std::size(c_params13bd), false },
+    { "13f0", c_params13f0, std::size(c_params13f0), false },
+    { "13f2", c_params13f2, std::size(c_params13f2), false },
+    { "13f3", c_params13f3, std::size(c_params13f3), false },
+    { "1431", c_params1431, std::size(c_params1431), false },
+    { "15f7", c_params15f7, std::size(c_params15f7), false },
+    { "15f8", c_params15f8, std::size(c_params15f8), false },
+    { "15f9", c_params15f9, std::size(c_params15f9), false },
+    { "15fa", c_params15fa, std::size(c_params15fa), false },
+    { "15fb", c_params15fb, std::size(c_params15fb), false },
+    { "15fc", c_params15fc, std::size(c_params15fc), false },
+    { "15ff", c_params15ff, std::size(c_params15ff), false },
+    { "17c2", c_params17c2, std::size(c_params17c2), false },
+    { "17f0", c_params17f0, std::size(c_params17f0), false },
+    { "17fd", c_params17fd, std::size(c_params17fd), false },
+    { "1b38", c_params1b38, std::size(c_params1b38), false },
+    { "1b39", c_params1b39, std::size(c_params1b39), false },
+    { "1bb3", c_params1bb3, std::size(c_params1bb3), false },
+    { "1bb4", c_params1bb4, std::size(c_params1bb4), false },
+    { "1db0", c_params1db0, std::size(c_params1db0), false },
+    { "1db1", c_params1db1, std::size(c_params1db1), false },
+    { "1db2", c_params1db2, std::size(c_params1db2), false },
+    { "1db3", c_params1db3, std::size(c_params1db3), false },
+    { "1db4", c_params1db4, std::size(c_params1db4), false },
+    { "1db5", c_params1db5, std::size(c_params1db5), false },
+    { "1db6", c_params1db6, std::size(c_params1db6), false },
+    { "1db7", c_params1db7, std::size(c_params1db7), false },
+    { "1db8", c_params1db8, std::size(c_params1db8), false },
+    { "1dbd", c_params1dbd, std::size(c_params1dbd), false },
+    { "1df6", c_params1df6, std::size(c_params1df6), true },
+    { "1e30", c_params1e30, std::size(c_params1e30), true },
+    { "1e37", c_params1e37, std::size(c_params1e37), true },
+    { "1e38", c_params1e38, std::size(c_params1e38), true },
+    { "1e78", c_params1e78, std::size(c_params1e78), true },
+    { "1eb4", c_params1eb4, std::size(c_params1eb4), true },
+    { "1eb8", c_params1eb8, std::size(c_params1eb8), true },
+    { "1eba", c_params1eba, std::size(c_params1eba), false },
+    { "20b0", c_params20b0, std::size(c_params20b0), true },
+    { "20b2", c_params20b2, std::size(c_params20b2), true },
+    { "20b6", c_params20b6, std::size(c_params20b6), false },
+    { "20b7", c_params20b7, std::size(c_params20b7), false },
+    { "20bf", c_params20bf, std::size(c_params20bf), false },
+    { "20f1", c_params20f1, std::size(c_params20f1), true },
+    { "2230", c_params2230, std::size(c_params2230), false },
+    { "2235", c_params2235, std::size(c_params2235), true },
+    { "2236", c_params2236, std::size(c_params2236), true },
+    { "2237", c_params2237, std::size(c_params2237), true },
+};
+
+constexpr int CompareDeviceIds(const char *a, const char *b)
+{
+    while (*a != '\0' && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+}
+
+constexpr bool IsWhitelistSorted()
+{
+    for (size_t i = 1; i < std::size(c_whitelist); i++)
+    {
+        if (CompareDeviceIds(c_whitelist[i - 1].deviceId, c_whitelist[i].deviceId) >= 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(IsWhitelistSorted(), "c_whitelist must be sorted by device ID without duplicates");
+
 /*****************************************************************************/
-Whitelist::Whitelist()
+const WhitelistSku *FindSku(const std::string &deviceId)
 {
-    // initialize map of maps
-    FillMap();
+    auto isBefore = [](const WhitelistSku &entry, const std::string &id) {
+        return strcmp(entry.deviceId, id.c_str()) < 0;
+    };
+
+    const WhitelistSku *end = std::end(c_whitelist);
+    const WhitelistSku *sku = std::lower_bound(std::begin(c_whitelist), end, deviceId, isBefore);
+
+    if (sku == end || deviceId != sku->deviceId)
+    {
+        return nullptr;
+    }
+
+    return sku;
 }
+} // namespace
+
+/*****************************************************************************/
+Whitelist::Whitelist()
+    : m_featureDb()
+{}
 
 /*****************************************************************************/
 Whitelist::~Whitelist()
@@ -57,10 +1640,7 @@ Whitelist::~Whitelist()
 /*****************************************************************************/
 bool Whitelist::isWhitelisted(std::string deviceId)
 {
-    std::map<std::string, std::map<std::string, TestParameters *>>::const_iterator outerIt = m_featureDb.find(deviceId);
-    std::set<std::string>::const_iterator globalChangesIt = m_globalChanges.find(deviceId);
-
-    if (outerIt == m_featureDb.end() && globalChangesIt == m_globalChanges.end())
+    if (FindSku(deviceId) == nullptr)
     {
         PRINT_INFO("%s", "DeviceId %s is NOT whitelisted", deviceId.c_str());
         return false;
@@ -72,20 +1652,65 @@ bool Whitelist::isWhitelisted(std::string deviceId)
     }
 }
 
+/*****************************************************************************/
+std::map<std::string, TestParameters *> &Whitelist::GetDeviceParameters(const std::string &deviceId)
+{
+    auto it = m_featureDb.find(deviceId);
+    if (it != m_featureDb.end())
+    {
+        return it->second;
+    }
+
+    std::map<std::string, TestParameters *> &testParameters = m_featureDb[deviceId];
+    const WhitelistSku *sku                                 = FindSku(deviceId);
+    if (sku == nullptr)
+    {
+        return testParameters;
+    }
+
+    for (size_t i = 0; i < sku->numParameters; i++)
+    {
+        const WhitelistParameter &param = sku->parameters[i];
+        TestParameters *&tp             = testParameters[param.testName];
+        if (tp == nullptr)
+        {
+            tp = new TestParameters();
+        }
+
+        if (param.stringValue != nullptr)
+        {
+            tp->AddString(param.name, param.stringValue);
+        }
+        else if (param.subtest != nullptr)
+        {
+            tp->AddSubTestDouble(param.subtest, param.name, param.value, param.min, param.max);
+        }
+        else
+        {
+            tp->AddDouble(param.name, param.value, param.min, param.max);
+        }
+    }
+
+    return testParameters;
+}
+
 /*****************************************************************************/
 void Whitelist::getDefaultsByDeviceId(const std::string &testName, const std::string &deviceId, TestParameters *tp)
 {
     int st;
-    TestParameters *testDeviceTp = m_featureDb[deviceId][testName];
-    bool requiresGlobalChanges   = m_globalChanges.find(deviceId) != m_globalChanges.end();
-    if (testDeviceTp == nullptr)
+    std::map<std::string, TestParameters *> &deviceTps = GetDeviceParameters(deviceId);
+    auto testIt                                        = deviceTps.find(testName);
+    const WhitelistSku *sku                            = FindSku(deviceId);
+    bool requiresGlobalChanges                         = sku != nullptr && sku->requiresGlobalChanges;
+    if (testIt == deviceTps.end())
     {
         // WAR: Replace any '_' in testName with a ' ' to make sure it really isn't found (DCGM-1774)
         std::string replaced(testName);
         std::replace(replaced.begin(), replaced.end(), '_', ' ');
-        testDeviceTp = m_featureDb[deviceId][replaced];
+        testIt = deviceTps.find(replaced);
     }
 
+    TestParameters *testDeviceTp = testIt == deviceTps.end() ? nullptr : testIt->second;
     if (!testDeviceTp && !requiresGlobalChanges)
     {
         PRINT_INFO("%s %s", "No whitelist overrides found for deviceId %s test %s", deviceId.c_str(), testName.c_str());
@@ -107,6 +1732,16 @@ void Whitelist::getDefaultsByDeviceId(const std::string &testName, const std::st
     }
 }
 
+/*****************************************************************************/
+void Whitelist::ApplyGlobalChanges(const std::string &deviceId)
+{
+    const WhitelistSku *sku = FindSku(deviceId);
+    if (sku != nullptr && sku->requiresGlobalChanges)
+    {
+        UpdateGlobalsForDeviceId(deviceId);
+    }
+}
+
 /*****************************************************************************/
 void Whitelist::postProcessWhitelist(std::vector<Gpu *> &gpus)
 {
@@ -152,9 +1787,10 @@ void Whitelist::postProcessWhitelist(std::vector<Gpu *> &gpus)
 
     double ratio = (double)minMemClockSeen / (double)TESLA_V100_BASE_SKU_MEM_CLOCK;
 
-    double existingValue   = m_featureDb[TESLA_V100_ID][MEMBW_PLUGIN_NAME]->GetDouble(MEMBW_STR_MINIMUM_BANDWIDTH);
+    TestParameters *tp     = GetDeviceParameters(TESLA_V100_ID)[MEMBW_PLUGIN_NAME];
+    double existingValue   = tp->GetDouble(MEMBW_STR_MINIMUM_BANDWIDTH);
     double discountedValue = ratio * existingValue;
-    m_featureDb[TESLA_V100_ID][MEMBW_PLUGIN_NAME]->SetDouble(MEMBW_STR_MINIMUM_BANDWIDTH, discountedValue);
+    tp->SetDouble(MEMBW_STR_MINIMUM_BANDWIDTH, discountedValue);
     PRINT_DEBUG("%f %f %u",
                 "Updated whitelist for minimium_bandwidth from %f -> %f due to memory clock %u.",
                 existingValue,
@@ -162,2250 +1798,6 @@ void Whitelist::postProcessWhitelist(std::vector<Gpu *> &gpus)
                 minMemClockSeen);
 }
 
-/*****************************************************************************/
-void Whitelist::FillMap()
-{
-    std::string id;
-    TestParameters *tp;
-
-    // Tesla K8
-    id = "1194";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 75.0, 65.0, 115.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 330.0, 30.0, 500.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 330.0, 30.0, 500.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla K80 ("Stella Duo" Gemini)
-    id = "102d";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 148.0, 70.0, 149.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 950.0, 30.0, 1200.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 950.0, 30.0, 1200.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // GP100 SKU 201 - (based on
-    // http://teams.nvidia.com/sites/gpu/ae/Tesla/Lists/Pascal%20Board%20Lineup/Standard%20View1.aspx)
-    id = "15fa";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 70.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // GP100 SKU 200 - (based on
-    // http://teams.nvidia.com/sites/gpu/ae/Tesla/Lists/Pascal%20Board%20Lineup/Standard%20View1.aspx)
-    id = "15fb";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 70.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // GP100 SKU 201 - (based on
-    // http://teams.nvidia.com/sites/gpu/ae/Tesla/Lists/Pascal%20Board%20Lineup/Standard%20View1.aspx) DGX Station GP100
-    id = "15fc";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 700.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 150.0, 300.0);
-    tp->AddDouble(TP_STR_OPS_PER_REQUEUE, 16.0, 1.0, 32.0);
-    // tp->AddDouble(TP_STR_CUDA_STREAMS_PER_GPU, 8.0, 1.0, 48.0); //Can't achieve target without higher concurrency
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // COPIED from -- GP100 SKU 203 - DB2 HBM2
-    // Tesla P100-PCIE-16GB
-    // Serial Number : PH400-C01-P0203
-    id = "15f8";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 400.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 70.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla P100-PCIE-12GB
-    // Serial Number : PH400 SKU 202
-    id = "15f7";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 400.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 70.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-
-    // GP100 Bringup - eris-l64-test12*
-    id = "15ff";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 70.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla P100-SXM2-16GB
-    id = "15f9";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 70.0, 300.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 8000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla Stella Solo - Internal only
-    id = "102f";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 234.0, 150.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 900.0, 200.0, 1700.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 1000.0, 100.0, 10000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla K40d ("Stella" DFF)
-    id = "102e";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 234.0, 120.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 200.0, 100.0, 210.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 200.0, 100.0, 210.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-
-    // Tesla K40m
-    id = "1023";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 200.0, 150.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    tp->AddDouble(TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 10.0);
-    tp->AddDouble(
-        TP_STR_STARTING_MATRIX_DIM, 600.0, 1.0, 1024.0); // Change max if TP_MAX_DIMENSION changes in TargetedPower
-    tp->AddDouble(TP_STR_MAX_GRAPHICS_CLOCK, 811.0, 666.0, 876.0);
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 1300.0, 200.0, 1500.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 200.0, 150.0, 235.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla K40c
-    id = "1024";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 134.0, 100.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 1300.0, 200.0, 1500.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 1300.0, 200.0, 1500.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-
-    // Tesla K40t ("Atlas" TTP) - values copied from Tesla K40c
-    id = "102a";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 234.0, 120.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 900.0, 200.0, 1500.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1500.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla K40s - values copied from Tesla K40c
-    id = "1029";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 234.0, 150.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 550.0, 200.0, 630.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 550.0, 200.0, 630.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla K20X - values copied from Tesla K20xm
-    id = "101e";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 234.0, 150.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla K20Xm
-    id = "1021";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 234.0, 150.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla K20c - values copied from Tesla K20xm (except power)
-    id = "1022";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 224.0, 150.0, 225.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-
-    // Tesla K20m - values copied from Tesla K20xm
-    id = "1028";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 234.0, 150.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-
-    // Tesla K20X
-    id = "1020";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 234.0, 150.0, 235.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 900.0, 200.0, 1400.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-
-    // Tesla K10
-    id = "118f";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 116.0, 80.0, 117.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 700.0, 100.0, 900.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 700.0, 100.0, 900.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-
-    // Quadro M6000 //Not supported officially for NVVS
-#if 1
-    id = "17f0";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 80.0, 250.0);
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 1000.0, 100.0, 900000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 4000.0, 100.0, 900000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 200000.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = 0;
-#endif
-
-    // Quadro M5000
-    id = "13f0";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 149.0, 10.0, 150.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 1000.0, 100.0, 900000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 4000.0, 100.0, 900000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // GeForce GTX TITAN X
-    id = "17c2";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 80.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    tp->AddDouble(TP_STR_CUDA_STREAMS_PER_GPU, 8.0, 1.0, 48.0); // Can't achieve target without higher concurrency
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 1000.0, 100.0, 900000.0);
-    tp->AddDouble(TS_STR_MAX_MEMORY_CLOCK, 3301.0, 0.0, 3600.0);
-    tp->AddDouble(TS_STR_MAX_GRAPHICS_CLOCK, 0.0, 0.0, 1500.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 2000.0, 100.0, 9000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_MAX_MEMORY_CLOCK, 3301.0, 0.0, 3600.0);
-    tp->AddDouble(SMSTRESS_STR_MAX_GRAPHICS_CLOCK, 0.0, 0.0, 1500.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddDouble(PCIE_STR_MAX_MEMORY_CLOCK, 3301.0, 0.0, 3600.0);
-    tp->AddDouble(PCIE_STR_MAX_GRAPHICS_CLOCK, 0.0, 0.0, 1500.0);
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla M60
-    id = "13f2";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 161.0, 80.0, 162.0);
-    tp->AddDouble(TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0);
-    tp->AddDouble(TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    // tp->AddDouble(TP_STR_CUDA_STREAMS_PER_GPU, 8.0, 1.0, 48.0); //Can't achieve target without higher concurrency
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla M6 (Copied from Tesla M60)
-    id = "13f3";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 161.0, 80.0, 162.0);
-    tp->AddDouble(TP_STR_MAX_GRAPHICS_CLOCK, 1130.0, 0.0, 1200.0); /* 1177 max so far */
-    tp->AddDouble(TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0);
-    tp->AddDouble(TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla M40
-    id = "17fd";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 100.0, 250.0);
-    tp->AddDouble(TP_STR_MAX_GRAPHICS_CLOCK, 1113.0, 0.0, 1200.0);
-    tp->AddDouble(TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0);
-    tp->AddDouble(TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla M4
-    id = "1431";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 74.0, 20.0, 75.0);
-    tp->AddDouble(TP_STR_MAX_GRAPHICS_CLOCK, 1113.0, 0.0, 1200.0);
-    tp->AddDouble(TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0);
-    tp->AddDouble(TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla M10
-    // Mostly copied from Tesla M40
-    id = "13bd";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_TARGET_POWER, 53.0, 26.5, 53.0);
-    tp->AddDouble(TP_STR_MAX_GRAPHICS_CLOCK, 1032.0, 0.0, 1202.0);
-    tp->AddDouble(TP_STR_OPS_PER_REQUEUE, 4.0, 1.0, 32.0);
-    tp->AddDouble(TP_STR_READJUST_INTERVAL, 3.0, 1.0, 10.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MIN_RATIO, 0.9, 0.5, 1.0);
-    tp->AddDouble(TP_STR_TARGET_MOVAVG_MAX_RATIO, 1.1, 1.0, 2.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 2500.0, 100.0, 900000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 2500.0, 100.0, 9000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla GV100 DGX1-V
-    // Serial Number: PG503-A00-P0447
-    id = "1dbd";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_MAX_GRAPHICS_CLOCK, 1140.0, 0.0, 1455.0);
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 50.0, 300.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla GV100 DGX Station - Part number 692-2G500-0201-300
-    id = "1db2";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 100.0, 300.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3350.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3000.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla GV100 SXM2-32GB SKU 895
-    id = "1db1";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 100.0, 300.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3350.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3500.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla GV100 SXM2-16GB SKU 890
-    id = "1db0";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 100.0, 300.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3500.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla GV100 PCIE-16GB SKU 893
-    id = "1db4";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 100.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3500.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla V100 PCI-E-32GB (Passive) - PG500 SKU 202
-    id = "1db6";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 100.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3000.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3500.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla P40
-    id = "1b38";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 125.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3500.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 6000.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla P10
-    // "Same as Tesla P40 (PG610 SKU200 GP102-895) but with a lower power target (150W vs 250W))"
-    // https://confluence.nvidia.com/display/CSWPM/Pascal+Board+Schedule
-    id = "1b39";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 149.0, 75.0, 150.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 2100.0, 30.0, 10000.0); // P40 perf 3500 adjusted for 250->150 TDP
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3600.0, 30.0, 20000.0); // P40 perf 6000 adjusted for 250->150 TDP
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla P6
-    id = "1bb4";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 89.0, 70.0, 90.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3750.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH,
-                  114263.0,
-                  1.0,
-                  1000000.0); /* Got 152.35 consistently in testing. taking 25% off this */
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla P4
-    id = "1bb3";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 50.0, 45.0, 50.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3750.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // 1273750 = .75 * 165000. Was higher previously, see http://nvbugs/200480825 for details.
-    // Lowered to 123750 as part of standardizing at 75%
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 123750.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla V100-HS
-    id = "1db3";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 149.0, 75.0, 150.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 2250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // V100 has a DGEMM performance of 7000 and max power level of 250, so
-    // we'll set this to 7000 * .75 (to back off) * 3/5 (relative power ratio)
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 3150.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla V100 32GB
-    id = "1db5";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 100.0, 300.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 4250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // V100 has a DGEMM performance of 7000 and max power level of 250, close enough
-    // to 300 given Max Q, so we'll set this to 5250 = 7000 * .75 to backs off to 75%.
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 5250.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = 0;
-
-    // Tesla V100 DGX-Station 32GB
-    id = "1db7";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 100.0, 300.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 4250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // V100 has a DGEMM performance of 7000 and max power level of 250, close enough
-    // to 300 given Max Q, so we'll set this to 5250 = 7000 * .75 to backs off to 75%.
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 5250.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 607500.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla V100 DGX-Station 32GB
-    id = "1db8";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 349.0, 100.0, 350.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 4250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // V100 has a DGEMM performance of 7000 and max power level of 250, close enough
-    // to 350 given Max Q, so we'll set this to 5250 = 7000 * .75 to backs off to 75%.
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 5250.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddString(MEMORY_L1TAG_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // Datasheet states 900 as the max. 900 * 0.75 = 675
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 675000.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = 0;
-
-    // Tesla T4 - TU104_PG183_SKU200
-    id = "1eb8";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 550.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 65.0, 60.0, 70.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3150.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // T4 has an SGEMM performance of 5500 * .75 backs it off to 4125
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 4125.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 8.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 8.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // Spec sheet says 672000, but experimentally we get about 244000 MB/s so we'll go with .75 of that
-    // Update value when bug 200480825 is fully root caused and resolved
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 183000.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // Tesla T40 - TU102-895
-    id = "1e38";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 200.0, 250.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 5250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // T40 has an SGEMM performance of 14746; multiply by .85 to get 12534
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 12534.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // Spec sheet says 448000, multiply by .75 to 336000
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 336000.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // Tesla T10 - PG150 SKU 220
-    id = "1e37";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 149.0, 100.0, 150.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 7295.0, 30.0, 10000.0); // Copied from SMSTRESS_STR_TARGET_PERF
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // T10 has an SGEMM performance of 8583 in dcgmproftester -t 1007; multiply by .85 to get 7295
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 7295.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // Got 304500 GB/s with dcgmproftester -t 1005, multiply by .75 to 228375
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 228375.0, 1.0, 403264.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // V100S
-    id = "1df6";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 200.0, 250.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 87.0, 40.0, 90.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // V100S has a DGEMM performance of 7000; multiply by .75 to get 5250
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 5250.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 87.0, 40.0, 90.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // Spec sheet says 900000, multiply by .75 to 675000
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 675000.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // RTX 8000 and 6000 (Quadro)
-    // This whitelist covers both because they use the same PCI Device Id, so the settings are the
-    // lowest value between the two
-    id = "1e30";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 259.0, 200.0, 260.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 3250.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // RTX 6000 and 8000 had a SGEMM performance of 13000 in dcgmproftester -t 1007; multiply by .75 to get 9750
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 9750.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1005 for the 8000 says 553700, multiply by .75 to 415275 (6000 was 672100, but we take
-    // the lower value)
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 415275.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // GA100 available through QA
-    id = "20bf";
-    tp = new TestParameters();
-    // The targeted power test is not working due to http://nvbugs/2808294. This test should be allowed once
-    // that bug is fixed.
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 199.0, 150.0, 200.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 5000.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // dcgmproftester measured -t 1006 at 10900; multiply by .75 to get 8175
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 8175.0, 30.0, 50000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // Measured ~1495000. Multiple by .75 to get 1121250
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 1121250.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = 0;
-
-    // GA100 on luna systems
-    id = "20b0";
-    tp = new TestParameters();
-    // Skip the targeted power test for the same reason as 20bf. Once this is fixed we can allow it.
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 399.0, 100.0, 400.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 89.0, 40.0, 92.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 5000.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // proftester -t 1006 measures at 18300, multiply by .75 to get 13725
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 13725.0, 30.0, 50000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 89.0, 40.0, 92.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // proftester -t 1005 shows ~1830000. Multiply by .75 to get 1372500
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 137500.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // RTX 6000/8000 passive SKUs
-    id = "1e78";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 249.0, 200.0, 250.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 9450.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // RTX 6000 and 8000 passive had a SGEMM performance of 12600 in dcgmproftester -t 1007; multiply by .75 to get 9450
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 9450.0, 30.0, 20000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 89.0, 40.0, 94.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1005 for the 8000 says 480300, multiply by .75 to 360225
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 360225.0, 1.0, 1000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // A100 PCIe
-    id = "20f1";
-    tp = new TestParameters();
-    // Skip the targeted power test for the same reason as 20bf. Once this is fixed we can allow it.
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 100.0, 300.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 5963.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // proftester -t 1006 measures at 7950, multiply by .75 to get 5963
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 5963.0, 30.0, 50000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // proftester -t 1005 shows ~1293000. Multiply by .75 to get 969750
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 969750.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // A100-SXM4-80GB
-    id = "20b2";
-    tp = new TestParameters();
-    // Skip the targeted power test for the same reason as 20bf. Once this is fixed we can allow it.
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 399.0, 100.0, 400.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 85.0, 40.0, 92.0);
-    tp->AddString(TP_STR_USE_DGEMM, "True");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "True");
-    tp->AddDouble(TS_STR_TARGET_PERF, 6975.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // proftester -t 1006 measures at ~9300, multiply by .75 to get 6975
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 6975.0, 30.0, 50000.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "True");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // proftester -t 1005 shows ~1564000 GiB/sec. Multiply by .75 to get 1173000
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 1173000.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // A40
-    id = "2235";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 100.0, 300.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 88.0, 40.0, 95.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 14250.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // proftester -t 1007 measures at ~19000, multiply by .75 to get 14250
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 14250.0, 30.0, 50000.0);
-    tp->AddDouble(SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 88.0, 40.0, 95.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // proftester -t 1005 shows ~564900 GiB/sec. Multiply by .75 to get 423675
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 423675.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // A10c/noc - PG133 SKU215
-    id = "2236";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 149.0, 100.0, 150.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 90.0, 40.0, 98.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 6075.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // proftester -t 1007 measures at ~8100, multiply by .75 to get 6075
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 6075.0, 30.0, 50000.0);
-    tp->AddDouble(SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 90.0, 40.0, 98.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // proftester -t 1005 shows ~640700 GiB/sec. Multiply by .75 to get 480525
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 480525.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // A10g - PG133 SKU210
-    id = "2237";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 100.0, 300.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 95.0, 40.0, 98.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 12750.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // proftester -t 1007 measures at ~17000, multiply by .75 to get 12750
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 12750.0, 30.0, 50000.0);
-    tp->AddDouble(SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 95.0, 40.0, 98.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // proftester -t 1005 shows ~483600 GiB/sec. Multiply by .75 to get 362700
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 362700.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // T4G
-    id = "1eb4";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 69.0, 30.0, 70.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 85.0, 40.0, 93.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    // Copied from sm perf target
-    tp->AddDouble(TS_STR_TARGET_PERF, 2850.0, 30.0, 10000.0);
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // proftester -t 1007 measures at ~3800, multiply by .75 to get 2850
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 2850.0, 30.0, 50000.0);
-    tp->AddDouble(SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 85.0, 40.0, 93.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 8.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 8.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 4096.0, 1024.0, 4096.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // proftester -t 1005 shows ~243500 GiB/sec. Multiply by .75 to get ~182600
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 182600.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    // Add device id to m_globalChanges since this device requires a throttle mask
-    m_globalChanges.insert(id);
-    tp = 0;
-
-    // A30
-    id = "20b7";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 194.0, 100.0, 195.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 7050.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1007 =~ 9400. 9400 * 0.75 = 7050
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 7050.5, 30.0, 50000.0);
-    tp->AddDouble(SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 92.0, 40.0, 95.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1005 shows ~780000 MiB/sec. Multiply by .75 to get 585000
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 585000.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = 0;
-
-    // Nvidia Turing Auto Module
-    id = "1eba";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 188.0, 50.0, 189.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 105.0, 40.0, 105.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 5625.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1007 =~ 7500. 7500 * 0.75 = 5625
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 5625.0, 30.0, 50000.0);
-    tp->AddDouble(SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 105.0, 40.0, 105.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 4096.0, 1024.0, 4096.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1005 shows ~298900 MiB/sec. Multiply by .75 to get 224000
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 224000.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = 0;
-
-    // A6000 PCIe
-    id = "2230";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 299.0, 50.0, 300.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 93.0, 40.0, 95.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 11475.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1007 =~ 15300. 15300 * 0.75 = 11475
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 11475.0, 30.0, 50000.0);
-    tp->AddDouble(SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 93.0, 40.0, 95.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 4096.0, 1024.0, 4096.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1005 shows ~674500 MiB/sec. Multiply by .75 to get ~506000
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 506000.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = 0;
-
-    // PG506-230
-    id = "20b6";
-    tp = new TestParameters();
-    tp->AddString(TP_STR_IS_ALLOWED, "True");
-    tp->AddDouble(TP_STR_STARTING_MATRIX_DIM, 1024.0, 1.0, 2048.0);
-    tp->AddDouble(TP_STR_TARGET_POWER, 194.0, 100.0, 195.0);
-    tp->AddDouble(TP_STR_TEMPERATURE_MAX, 82.0, 40.0, 85.0);
-    tp->AddString(TP_STR_USE_DGEMM, "False");
-    m_featureDb[id][TP_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(TS_STR_IS_ALLOWED, "True");
-    tp->AddString(TS_STR_USE_DGEMM, "False");
-    tp->AddDouble(TS_STR_TARGET_PERF, 15750.0, 30.0, 10000.0); // Copied from sm perf target
-    m_featureDb[id][TS_PLUGIN_NAME] = tp;
-    tp                              = new TestParameters();
-    tp->AddString(SMSTRESS_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1007 =~ 21000. 21000 * 0.75 = 15750
-    tp->AddDouble(SMSTRESS_STR_TARGET_PERF, 15750.0, 30.0, 50000.0);
-    tp->AddDouble(SMSTRESS_STR_MATRIX_DIM, 1024.0, 1024.0, 9182.0);
-    tp->AddString(SMSTRESS_STR_USE_DGEMM, "False");
-    tp->AddDouble(SMSTRESS_STR_TEMPERATURE_MAX, 82.0, 40.0, 85.0);
-    m_featureDb[id][SMSTRESS_PLUGIN_NAME] = tp;
-    tp                                    = new TestParameters();
-    tp->AddString(PCIE_STR_IS_ALLOWED, "True");
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN, 3.0, 0.0, 3.0);
-    tp->AddSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_WIDTH, 16.0, 1.0, 16.0);
-    m_featureDb[id][PCIE_PLUGIN_NAME] = tp;
-    tp                                = new TestParameters();
-    tp->AddString(MEMORY_STR_IS_ALLOWED, "True");
-    tp->AddDouble(MEMORY_L1TAG_STR_L1_CACHE_SIZE_KB_PER_SM, 192.0, 0.0, 192.0);
-    m_featureDb[id][MEMORY_PLUGIN_NAME] = tp;
-    tp                                  = new TestParameters();
-    tp->AddString(DIAGNOSTIC_STR_IS_ALLOWED, "True");
-    tp->AddDouble(DIAGNOSTIC_STR_MATRIX_DIM, 8192.0, 1024.0, 8192.0);
-    m_featureDb[id][DIAGNOSTIC_PLUGIN_NAME] = tp;
-    tp                                      = new TestParameters();
-    tp->AddString(MEMBW_STR_IS_ALLOWED, "True");
-    // dcgmproftester -t 1005 shows ~1829800 MiB/sec. Multiply by .75 to get 1372350
-    tp->AddDouble(MEMBW_STR_MINIMUM_BANDWIDTH, 1372350.0, 1.0, 4000000.0);
-    m_featureDb[id][MEMBW_PLUGIN_NAME] = tp;
-    tp                                 = 0;
-}
-
 void Whitelist::UpdateGlobalsForDeviceId(const std::string &deviceId)
 {
     /* NOTE: As this function is updated we need to update testing/python/test_utils.py's is_throttling_masked()
@@ -181,3 +181,47 @@ TEST_CASE("CustomStatHolder : Storing Values and Outputting in structs / JSON")
         CHECK(jv[bridgemen][lost][i]["value"].asInt64() == i);
     }
 }
+
+TEST_CASE("CustomStatHolder : Appending through per-GPU buffers")
+{
+    CustomStatHolder cdh;
+
+    customStatHandle_t investHandle  = cdh.RegisterStat(investiture);
+    customStatHandle_t breathsHandle = cdh.RegisterStat(breaths);
+    CHECK(investHandle != breathsHandle);
+    CHECK(cdh.RegisterStat(investiture) == investHandle);
+
+    // The string-keyed calls and the buffers feed the same stats
+    cdh.SetGpuStat(1, investiture, -1.0);
+
+    {
+        CustomGpuStatBuffer gpu0(cdh, 0);
+        CustomGpuStatBuffer gpu1(cdh, 1);
+
+        for (long long i = 0; i < 10; i++)
+        {
+            gpu0.Append(breathsHandle, i);
+            gpu1.Append(investHandle, 0.5 * i);
+        }
+
+        // Nothing is visible until the buffer is flushed
+        CHECK(cdh.GetCustomGpuStat(0, breaths).empty());
+        gpu0.Flush();
+        CHECK(cdh.GetCustomGpuStat(0, breaths).size() == 10);
+        CHECK(cdh.GetCustomGpuStat(1, investiture).size() == 1);
+
+        // gpu1 is flushed when it goes out of scope
+    }
+
+    std::vector<dcgmTimeseriesInfo_t> invest = cdh.GetCustomGpuStat(1, investiture);
+    REQUIRE(invest.size() == 11);
+    CHECK(invest[0].val.fp64 == -1.0);
+    CHECK(invest[10].val.fp64 == 4.5);
+    CHECK(!invest[10].isInt);
+
+    std::vector<dcgmTimeseriesInfo_t> breathsStat = cdh.GetCustomGpuStat(0, breaths);
+    REQUIRE(breathsStat.size() == 10);
+    CHECK(breathsStat[9].val.i64 == 9);
+    CHECK(breathsStat[9].isInt);
+    CHECK(cdh.GetCustomGpuStat(0, investiture).empty());
+}
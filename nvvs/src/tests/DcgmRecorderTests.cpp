@@ -85,6 +85,27 @@ SCENARIO("void DcgmRecorder::GetTagFromFieldId(unsigned short fieldId, std::stri
     CHECK(str == "0");
 }
 
+SCENARIO("bool DcgmRecorder::WatchCoversTest(const dcgmCacheManagerFieldInfo_t &fieldInfo, long long "
+         "frequencyUsec, double keepAge)")
+{
+    dcgmCacheManagerFieldInfo_t fieldInfo {};
+    fieldInfo.monitorFrequencyUsec = 1000000;
+    fieldInfo.maxAgeUsec           = 600000000;
+
+    // Not watched
+    CHECK(!DcgmRecorder::WatchCoversTest(fieldInfo, 1000000, 330));
+
+    fieldInfo.flags = DCGM_CMI_F_WATCHED;
+    CHECK(DcgmRecorder::WatchCoversTest(fieldInfo, 1000000, 330));
+    // Too slow
+    CHECK(!DcgmRecorder::WatchCoversTest(fieldInfo, 100000, 330));
+    // Not kept long enough
+    CHECK(!DcgmRecorder::WatchCoversTest(fieldInfo, 1000000, 630));
+
+    fieldInfo.maxAgeUsec = 0;
+    CHECK(DcgmRecorder::WatchCoversTest(fieldInfo, 1000000, 630));
+}
+
 // List of private/protected functions tested as part of the block below:
 // void DcgmRecorder::InsertCustomData(unsigned int gpuId, const std::string &name, dcgmTimeseriesInfo_t &data)
 // std::vector<dcgmTimeseriesInfo_t> DcgmRecorder::GetCustomGpuStat(unsigned int gpuId, const std::string &name)
@@ -303,3 +303,43 @@ SCENARIO("bool DcgmValuesSinceHolder::DoesValuePassPerSecondThreshold(unsigned s
     dvsh.AddValue(DCGM_FE_GPU, entityId, fieldId, fv);
     CHECK(dvsh.DoesValuePassPerSecondThreshold(fieldId, threshold, entityId, "field name", errorList, 0));
 }
+
+SCENARIO("DoesValuePassPerSecondThreshold only looks at values at or after startTime")
+{
+    std::vector<DcgmError> errorList;
+    DcgmValuesSinceHolder dvsh;
+    dcgmFieldValue_v1 fv         = {};
+    dcgmFieldValue_v1 threshold  = {};
+    const unsigned short fieldId = 1;
+    const unsigned int entityId  = 0;
+
+    threshold.fieldId   = fieldId;
+    threshold.fieldType = DCGM_FT_INT64;
+    threshold.value.i64 = 2;
+
+    fv.fieldId   = fieldId;
+    fv.fieldType = DCGM_FT_INT64;
+
+    // A jump of 10 before startTime, then increments of 1. The sample at 3000000 is added out of order
+    fv.ts        = 1000000;
+    fv.value.i64 = 0;
+    dvsh.AddValue(DCGM_FE_GPU, entityId, fieldId, fv);
+    fv.ts        = 2000000;
+    fv.value.i64 = 10;
+    dvsh.AddValue(DCGM_FE_GPU, entityId, fieldId, fv);
+    fv.ts        = 4000000;
+    fv.value.i64 = 12;
+    dvsh.AddValue(DCGM_FE_GPU, entityId, fieldId, fv);
+    fv.ts        = 3000000;
+    fv.value.i64 = 11;
+    dvsh.AddValue(DCGM_FE_GPU, entityId, fieldId, fv);
+
+    CHECK(dvsh.DoesValuePassPerSecondThreshold(fieldId, threshold, entityId, "field name", errorList, 0));
+    errorList.clear();
+    CHECK(!dvsh.DoesValuePassPerSecondThreshold(fieldId, threshold, entityId, "field name", errorList, 3000000));
+    CHECK(errorList.empty());
+
+    // Unknown GPUs and fields don't pass
+    CHECK(!dvsh.DoesValuePassPerSecondThreshold(fieldId, threshold, 1, "field name", errorList, 0));
+    CHECK(!dvsh.DoesValuePassPerSecondThreshold(2, threshold, entityId, "field name", errorList, 0));
+}
@@ -21,8 +21,10 @@
 class WrapperGoldenValueCalculator : protected GoldenValueCalculator
 {
 public:
-    std::map<std::string, paramToValues_t> &WrapperGetInputs();
-    std::map<std::string, paramToGpuToValues_t> &WrapperGetInputsPerGpu();
+    const GoldenValueStats &WrapperGetStats(const std::string &testname, const std::string &paramName);
+    const GoldenValueStats &WrapperGetStats(const std::string &testname,
+                                            const std::string &paramName,
+                                            unsigned int gpuId);
 
     std::map<std::string, std::map<std::string, dcgmGpuToValue_t>> m_averageGpuValues;
 
@@ -30,6 +32,8 @@ public:
 
     void WrapperRecordGoldenValueInputs(const std::string &testname, const observedMetrics_t &metrics);
 
+    void WrapperMerge(const WrapperGoldenValueCalculator &other);
+
     void WrapperWriteConfigFile(const std::string &filename);
 
     std::string WrapperGetParameterName(const std::string &testname, const std::string &metricName) const;
@@ -41,7 +45,7 @@ public:
                                   unsigned int gpuId,
                                   double value);
 
-    valueWithVariance_t WrapperCalculateMeanAndVariance(std::vector<double> &data) const;
+    valueWithVariance_t WrapperCalculateMeanAndVariance(const std::vector<double> &data) const;
 
     double WrapperToleranceAdjustFactor(const std::string &paramName) const;
 
@@ -58,14 +62,17 @@ public:
     void WrapperDumpObservedMetricsAll(int64_t timestamp) const;
 };
 
-std::map<std::string, paramToValues_t> &WrapperGoldenValueCalculator::WrapperGetInputs()
+const GoldenValueStats &WrapperGoldenValueCalculator::WrapperGetStats(const std::string &testname,
+                                                                      const std::string &paramName)
 {
-    return m_inputs;
+    return m_params[GetParamId(testname, paramName)].all;
 }
 
-std::map<std::string, paramToGpuToValues_t> &WrapperGoldenValueCalculator::WrapperGetInputsPerGpu()
+const GoldenValueStats &WrapperGoldenValueCalculator::WrapperGetStats(const std::string &testname,
+                                                                      const std::string &paramName,
+                                                                      unsigned int gpuId)
 {
-    return m_inputsPerGpu;
+    return m_params[GetParamId(testname, paramName)].perGpu[gpuId];
 }
 
 std::map<std::string, std::map<std::string, valueWithVariance_t>> WrapperGoldenValueCalculator::
@@ -88,6 +95,11 @@ void WrapperGoldenValueCalculator::WrapperRecordGoldenValueInputs(const std::str
     RecordGoldenValueInputs(testname, metrics);
 }
 
+void WrapperGoldenValueCalculator::WrapperMerge(const WrapperGoldenValueCalculator &other)
+{
+    Merge(other);
+}
+
 std::string WrapperGoldenValueCalculator::WrapperGetParameterName(const std::string &testname,
                                                                   const std::string &metricName) const
 
@@ -99,7 +111,7 @@ void WrapperGoldenValueCalculator::WrapperAddToAllInputs(const std::string &test
                                                          const std::string &paramName,
                                                          double value)
 {
-    AddToAllInputs(testname, paramName, value);
+    AddToAllInputs(GetParamId(testname, paramName), value);
 }
 
 void WrapperGoldenValueCalculator::WrapperAddToInputsPerGpu(const std::string &testname,
@@ -107,10 +119,11 @@ void WrapperGoldenValueCalculator::WrapperAddToInputsPerGpu(const std::string &t
                                                             unsigned int gpuId,
                                                             double value)
 {
-    AddToInputsPerGpu(testname, paramName, gpuId, value);
+    AddToInputsPerGpu(GetParamId(testname, paramName), gpuId, value);
 }
 
-valueWithVariance_t WrapperGoldenValueCalculator::WrapperCalculateMeanAndVariance(std::vector<double> &data) const
+valueWithVariance_t WrapperGoldenValueCalculator::WrapperCalculateMeanAndVariance(
+    const std::vector<double> &data) const
 {
     return CalculateMeanAndVariance(data);
 }
@@ -165,48 +178,82 @@ SCENARIO("GoldenValueCalculator records inputs correctly for GPU and aggregate m
 
     gv.WrapperRecordGoldenValueInputs("test2", metrics);
 
-    auto inputs       = gv.WrapperGetInputs();
-    auto inputsPerGpu = gv.WrapperGetInputsPerGpu();
-
-    CHECK(inputs["test1"]["1"][0] == 1);
-    CHECK(inputs["test1"]["1"][1] == 2);
-    CHECK(inputs["test1"]["1"][2] == 3);
-    CHECK(inputs["test1"]["1"][3] == 4);
-
-    CHECK(inputs["test1"]["2"][0] == 2);
-    CHECK(inputs["test1"]["2"][1] == 4);
-    CHECK(inputs["test1"]["2"][2] == 6);
-    CHECK(inputs["test1"]["2"][3] == 8);
-
-    CHECK(inputs["test2"]["1"][0] == 3);
-    CHECK(inputs["test2"]["1"][1] == 4);
-    CHECK(inputs["test2"]["1"][2] == 5);
-    CHECK(inputs["test2"]["1"][3] == 6);
-
-    CHECK(inputs["test2"]["2"][0] == 4);
-    CHECK(inputs["test2"]["2"][1] == 6);
-    CHECK(inputs["test2"]["2"][2] == 8);
-    CHECK(inputs["test2"]["2"][3] == 10);
-
-    CHECK(inputsPerGpu["test1"]["1"][0][0] == 1);
-    CHECK(inputsPerGpu["test1"]["1"][1][0] == 2);
-    CHECK(inputsPerGpu["test1"]["1"][2][0] == 3);
-    CHECK(inputsPerGpu["test1"]["1"][3][0] == 4);
-
-    CHECK(inputsPerGpu["test1"]["2"][0][0] == 2);
-    CHECK(inputsPerGpu["test1"]["2"][1][0] == 4);
-    CHECK(inputsPerGpu["test1"]["2"][2][0] == 6);
-    CHECK(inputsPerGpu["test1"]["2"][3][0] == 8);
-
-    CHECK(inputsPerGpu["test2"]["1"][0][0] == 3);
-    CHECK(inputsPerGpu["test2"]["1"][1][0] == 4);
-    CHECK(inputsPerGpu["test2"]["1"][2][0] == 5);
-    CHECK(inputsPerGpu["test2"]["1"][3][0] == 6);
-
-    CHECK(inputsPerGpu["test2"]["2"][0][0] == 4);
-    CHECK(inputsPerGpu["test2"]["2"][1][0] == 6);
-    CHECK(inputsPerGpu["test2"]["2"][2][0] == 8);
-    CHECK(inputsPerGpu["test2"]["2"][3][0] == 10);
+    auto stats = gv.WrapperGetStats("test1", "1");
+    CHECK(stats.GetCount() == 4);
+    CHECK(stats.GetMeanAndVariance().value == 2.5);
+    CHECK(stats.GetMin() == 1);
+    CHECK(stats.GetMax() == 4);
+
+    stats = gv.WrapperGetStats("test1", "2");
+    CHECK(stats.GetCount() == 4);
+    CHECK(stats.GetMeanAndVariance().value == 5);
+
+    stats = gv.WrapperGetStats("test2", "1");
+    CHECK(stats.GetCount() == 4);
+    CHECK(stats.GetMeanAndVariance().value == 4.5);
+
+    stats = gv.WrapperGetStats("test2", "2");
+    CHECK(stats.GetCount() == 4);
+    CHECK(stats.GetMeanAndVariance().value == 7);
+
+    stats = gv.WrapperGetStats("test1", "1", 0);
+    CHECK(stats.GetCount() == 1);
+    CHECK(stats.GetMeanAndVariance().value == 1);
+
+    stats = gv.WrapperGetStats("test1", "2", 3);
+    CHECK(stats.GetCount() == 1);
+    CHECK(stats.GetMeanAndVariance().value == 8);
+
+    stats = gv.WrapperGetStats("test2", "1", 2);
+    CHECK(stats.GetCount() == 1);
+    CHECK(stats.GetMeanAndVariance().value == 5);
+
+    // Recording again adds to the same statistics
+    gv.WrapperRecordGoldenValueInputs("test2", metrics);
+    stats = gv.WrapperGetStats("test2", "2", 1);
+    CHECK(stats.GetCount() == 2);
+    CHECK(stats.GetMeanAndVariance().value == 6);
+    CHECK(stats.GetMeanAndVariance().variance == 0);
+}
+
+SCENARIO("Merged calculators match a calculator that recorded all of the inputs")
+{
+    WrapperGoldenValueCalculator all;
+    WrapperGoldenValueCalculator node1;
+    WrapperGoldenValueCalculator node2;
+
+    const std::vector<double> values = { 3, 8, 1, 9, 4, 4, 7 };
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        all.WrapperAddToAllInputs("test", "param", values[i]);
+        all.WrapperAddToInputsPerGpu("test", "param", i % 2, values[i]);
+        WrapperGoldenValueCalculator &node = i < 3 ? node1 : node2;
+        node.WrapperAddToAllInputs("test", "param", values[i]);
+        node.WrapperAddToInputsPerGpu("test", "param", i % 2, values[i]);
+    }
+    node2.WrapperAddToAllInputs("test", "other", 5);
+
+    WrapperGoldenValueCalculator merged;
+    merged.WrapperMerge(node1);
+    merged.WrapperMerge(node2);
+
+    valueWithVariance_t expected = all.WrapperCalculateMeanAndVariance(values);
+    valueWithVariance_t actual   = merged.WrapperGetStats("test", "param").GetMeanAndVariance();
+    CHECK(merged.WrapperGetStats("test", "param").GetCount() == values.size());
+    CHECK(actual.value == Approx(expected.value));
+    CHECK(actual.variance == Approx(expected.variance));
+    CHECK(merged.WrapperGetStats("test", "param").GetMin() == 1);
+    CHECK(merged.WrapperGetStats("test", "param").GetMax() == 9);
+
+    for (unsigned int gpuId = 0; gpuId < 2; gpuId++)
+    {
+        expected = all.WrapperGetStats("test", "param", gpuId).GetMeanAndVariance();
+        actual   = merged.WrapperGetStats("test", "param", gpuId).GetMeanAndVariance();
+        CHECK(actual.value == Approx(expected.value));
+        CHECK(actual.variance == Approx(expected.variance));
+    }
+
+    CHECK(merged.WrapperGetStats("test", "other").GetCount() == 1);
 }
 
 SCENARIO("CalculateMeanAndVariance calculates the correct mean and variance")
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <sstream>
+
+#include <JsonStreamWriter.h>
+#include <json/json.h>
+
+SCENARIO("JsonStreamWriter writes documents that parse back to the same values")
+{
+    std::stringstream out;
+    JsonStreamWriter writer(out);
+
+    writer.StartObject();
+    writer.Key("GPUS");
+    writer.StartArray();
+    for (int64_t gpuId = 0; gpuId < 2; gpuId++)
+    {
+        writer.StartObject();
+        writer.Key("gpuId");
+        writer.Value(gpuId);
+        writer.Key("power_usage");
+        writer.StartArray();
+        writer.StartObject();
+        writer.Key("timestamp");
+        writer.Value(static_cast<int64_t>(1600000000000000LL));
+        writer.Key("value");
+        writer.Value(123.25);
+        writer.Key("whole");
+        writer.Value(5.0);
+        writer.EndObject();
+        writer.EndArray();
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Key("empty");
+    writer.StartObject();
+    writer.EndObject();
+    writer.Key("quoted \"name\"");
+    writer.Value(std::string("line\nbreak"));
+    writer.EndObject();
+
+    Json::Value jv;
+    out >> jv;
+
+    REQUIRE(jv["GPUS"].size() == 2);
+    CHECK(jv["GPUS"][1]["gpuId"].asInt() == 1);
+    CHECK(jv["GPUS"][1]["power_usage"][0]["timestamp"].asInt64() == 1600000000000000LL);
+    CHECK(jv["GPUS"][1]["power_usage"][0]["value"].asDouble() == 123.25);
+    CHECK(jv["GPUS"][1]["power_usage"][0]["whole"].isDouble());
+    CHECK(jv["GPUS"][1]["power_usage"][0]["whole"].asDouble() == 5.0);
+    CHECK(jv["empty"].isObject());
+    CHECK(jv["empty"].empty());
+    CHECK(jv["quoted \"name\""].asString() == "line\nbreak");
+}
@@ -272,6 +272,7 @@ SCENARIO("NVVS correctly processes command line arguments")
         add_argument("goldenvalues");
         add_argument("--throttle-mask");
         add_argument("--fail-early");
+        add_argument("--fail-fast");
         add_argument("--check-interval");
         add_argument("3");
         add_argument("-l");
@@ -297,6 +298,9 @@ SCENARIO("NVVS correctly processes command line arguments")
         CHECK(nvvsCommon.trainingTolerancePcnt == 0.07);
         CHECK(nvvsCommon.goldenValuesFile == "goldenvalues");
         CHECK(nvvsCommon.m_statsPath == statsDir);
+        CHECK(nvvsCommon.failEarly == true);
+        CHECK(nvvsCommon.failFast == true);
+        CHECK(nvvsCommon.failCheckInterval == 3);
 
         rmdir(statsDir);
         CLEANUP();
@@ -54,3 +54,31 @@ TEST_CASE("PluginLib: General")
     result = pl.GetResult();
     CHECK(result == NVVS_RESULT_FAIL);
 }
+
+TEST_CASE("PluginLib: Instances of the same plugin keep their own results")
+{
+    std::vector<dcgmDiagPluginGpuInfo_t> gpuInfo;
+    dcgmDiagPluginGpuInfo_t gi = {};
+    dcgmHandle_t handle        = {};
+    gpuInfo.push_back(gi);
+
+    PluginLib first;
+    REQUIRE(first.LoadPlugin("./libtestplugin.so", "software") == DCGM_ST_OK);
+    CHECK(first.GetPath() == "./libtestplugin.so");
+    REQUIRE(first.InitializePlugin(handle, gpuInfo) == DCGM_ST_OK);
+
+    /* A second instance is loaded the way TestFramework does for each software test */
+    PluginLib second;
+    REQUIRE(second.LoadPlugin(first.GetPath(), first.GetName()) == DCGM_ST_OK);
+    REQUIRE(second.InitializePlugin(handle, gpuInfo) == DCGM_ST_OK);
+
+    TestParameters tp;
+    tp.AddDouble(PS_LOGFILE_TYPE, 0.0, 0.0, 10.0);
+    setenv("result", "pass", 1);
+    first.RunTest(10, &tp);
+    setenv("result", "fail", 1);
+    second.RunTest(10, &tp);
+
+    CHECK(first.GetResult() == NVVS_RESULT_PASS);
+    CHECK(second.GetResult() == NVVS_RESULT_FAIL);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <catch2/catch.hpp>
+
+#include <NvvsCommon.h>
+#include <TestParameters.h>
+#include <TestPlanCache.h>
+
+#include <cstdlib>
+#include <unistd.h>
+
+TEST_CASE("TestPlanCache: round trip")
+{
+    char planDir[] = "/tmp/dcgm-diag-test-plans-XXXXXX";
+    REQUIRE(mkdtemp(planDir) != nullptr);
+
+    TestParameters tp;
+    tp.AddString("name", "targeted stress");
+    tp.AddDouble("test_duration", 30.0, 1.0, 86400.0);
+    tp.AddSubTestDouble("bridge", "number", 4.0, 0.0, 8.0);
+    tp.AddSubTestString("bridge", "leader", "kdin");
+
+    // --parms with overrideMinMax can leave a value outside of its range
+    nvvsCommon.overrideMinMax = true;
+    REQUIRE(tp.SetDouble("test_duration", 100000.0) == 0);
+    nvvsCommon.overrideMinMax = false;
+
+    TestPlanCache saved(planDir);
+    CHECK(saved.Load("key") == false);
+    saved.Put("1/1db1/targeted stress", tp);
+    saved.Save();
+    CHECK(access(saved.GetPath().c_str(), R_OK) == 0);
+
+    TestPlanCache loaded(planDir);
+    REQUIRE(loaded.Load("key") == true);
+
+    TestParameters planned;
+    REQUIRE(loaded.Get("1/1db1/targeted stress", planned) == true);
+    CHECK(planned.GetString("name") == "targeted stress");
+    CHECK(planned.GetDouble("test_duration") == 100000.0);
+    CHECK(planned.GetSubTestDouble("bridge", "number") == 4.0);
+    CHECK(planned.GetSubTestString("bridge", "leader") == "kdin");
+
+    // The range is kept too
+    CHECK(planned.SetDouble("test_duration", 0.5) == TP_ST_OUTOFRANGE);
+
+    TestParameters missing;
+    CHECK(loaded.Get("1/1db1/sm stress", missing) == false);
+
+    // Another key is another plan
+    TestPlanCache other(planDir);
+    CHECK(other.Load("other key") == false);
+    CHECK(other.Get("1/1db1/targeted stress", missing) == false);
+
+    std::string cmd = std::string("rm -rf ") + planDir;
+    system(cmd.c_str());
+}
+
+TEST_CASE("TestPlanCache: disabled")
+{
+    TestParameters tp;
+    tp.AddString("name", "diagnostic");
+
+    TestPlanCache cache;
+    CHECK(cache.Load("key") == false);
+    cache.Put("1/1db1/diagnostic", tp);
+    cache.Save();
+    CHECK(cache.GetPath().empty());
+
+    TestParameters planned;
+    CHECK(cache.Get("1/1db1/diagnostic", planned) == false);
+}
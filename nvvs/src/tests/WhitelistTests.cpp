@@ -163,6 +163,26 @@ SCENARIO("Whitelist provides default values for device")
         CHECK(tp.GetString(SMSTRESS_STR_USE_DGEMM) == "False");
         CHECK(tp.GetDouble(SMSTRESS_STR_TEMPERATURE_MAX) == 0.0);
     }
+
+    GIVEN("valid id, test with subtests")
+    {
+        tp.AddString(PCIE_STR_IS_ALLOWED, "False");
+
+        wl.getDefaultsByDeviceId(PCIE_PLUGIN_NAME, "15fa", &tp);
+
+        CHECK(tp.GetString(PCIE_STR_IS_ALLOWED) == "True");
+        CHECK(tp.GetSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_PINNED, PCIE_STR_MIN_PCI_WIDTH) == 16.0);
+        CHECK(tp.GetSubTestDouble(PCIE_SUBTEST_H2D_D2H_SINGLE_UNPINNED, PCIE_STR_MIN_PCI_GEN) == 3.0);
+    }
+
+    GIVEN("invalid id")
+    {
+        tp.AddString(SMSTRESS_STR_IS_ALLOWED, "False");
+
+        wl.getDefaultsByDeviceId(SMSTRESS_PLUGIN_NAME, INVALID_ID, &tp);
+
+        CHECK(tp.GetString(SMSTRESS_STR_IS_ALLOWED) == "False");
+    }
 }
 
 SCENARIO("UpdateGlobalsForDeviceId sets the appropriate global flags")
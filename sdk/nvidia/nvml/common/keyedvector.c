@@ -1038,6 +1038,169 @@ int keyedvector_remove_range_by_cursor(keyedvector_p kv, kv_cursor_p startCursor
     return KV_ST_OK;
 }
 
+/*****************************************************************************/
+int keyedvector_remove_first(keyedvector_p kv, int count)
+{
+    kv_cursor_t endCursor;
+
+    if (!kv || count < 0)
+        return KV_ST_BADPARAM;
+
+    if (!count || !kv->Nelem)
+        return KV_ST_OK; /* Nothing to do */
+    if (count >= kv->Nelem)
+        return keyedvector_remove_range_by_cursor(kv, NULL, NULL);
+
+    if (!keyedvector_find_by_index(kv, count - 1, &endCursor))
+        return KV_ST_CORRUPT; /* Nelem disagrees with blockNelem */
+
+    return keyedvector_remove_range_by_cursor(kv, NULL, &endCursor);
+}
+
+/*****************************************************************************/
+int keyedvector_append(keyedvector_p kv, void *elements, int count)
+{
+    kv_cursor_t cursor;
+    char *src = (char *)elements;
+    char *prev, *block;
+    int elementsPerBlock, spaceLeft, neededBlocks, newMaxBlocks;
+    int Nappend, Ncopied, NtoCopy;
+    int blockIndex;
+    int st;
+
+    if (!kv || count < 0 || (count && !elements))
+        return KV_ST_BADPARAM;
+
+    /* Find the run of elements that sorts past the end */
+    prev = (char *)keyedvector_last(kv, &cursor);
+    for (Nappend = 0; Nappend < count; Nappend++)
+    {
+        if (prev && kv->compareCB(&src[Nappend * kv->elemSize], prev) <= 0)
+            break;
+        prev = &src[Nappend * kv->elemSize];
+    }
+
+    if (!Nappend)
+        return 0;
+
+    /* Make room in kv->blocks for every block we'll need up front */
+    elementsPerBlock = kv->subBlockSize / kv->elemSize;
+    blockIndex       = kv->Nblocks - 1;
+    spaceLeft        = elementsPerBlock - kv->blockNelem[blockIndex];
+    if (Nappend > spaceLeft)
+    {
+        neededBlocks = kv->Nblocks + (Nappend - spaceLeft + elementsPerBlock - 1) / elementsPerBlock;
+        newMaxBlocks = kv->maxBlocks;
+        while (newMaxBlocks < neededBlocks)
+            newMaxBlocks *= 2;
+
+        st = keyedvector_grow_blocks(kv, newMaxBlocks);
+        if (st)
+            return st;
+    }
+
+    for (Ncopied = 0; Ncopied < Nappend; Ncopied += NtoCopy)
+    {
+        if (kv->blockNelem[blockIndex] >= elementsPerBlock)
+        {
+            block = (char *)kv_malloc(kv->subBlockSize);
+            if (!block)
+                return KV_ST_MEMORY;
+
+            blockIndex++;
+            kv->blocks[blockIndex]     = block;
+            kv->blockNelem[blockIndex] = 0;
+            kv->Nblocks++;
+        }
+
+        NtoCopy = elementsPerBlock - kv->blockNelem[blockIndex];
+        if (NtoCopy > Nappend - Ncopied)
+            NtoCopy = Nappend - Ncopied;
+
+        block = (char *)kv->blocks[blockIndex];
+        memcpy(&block[kv->blockNelem[blockIndex] * kv->elemSize],
+               &src[Ncopied * kv->elemSize],
+               NtoCopy * kv->elemSize);
+        kv->blockNelem[blockIndex] += NtoCopy;
+        kv->Nelem += NtoCopy;
+    }
+
+    return Nappend;
+}
+
+/*****************************************************************************/
+int keyedvector_copy_range(keyedvector_p kv,
+                           kv_cursor_p startCursor,
+                           kv_cursor_p endCursor,
+                           void *elements,
+                           int maxElements)
+{
+    kv_cursor_t startCursorLocal;
+    kv_cursor_t endCursorLocal;
+    char *dest = (char *)elements;
+    int blockIdx, startSubIdx, endSubIdx;
+    int Ncopied, NtoCopy;
+
+    if (!kv || maxElements < 0)
+        return KV_ST_BADPARAM;
+
+    /* Validate cursors the same way keyedvector_remove_range_by_cursor() does */
+    if (startCursor)
+    {
+        if (startCursor->blockIndex < 0 || startCursor->blockIndex >= kv->Nblocks || startCursor->subIndex < 0
+            || startCursor->subIndex >= kv->blockNelem[startCursor->blockIndex])
+            return KV_ST_BADPARAM;
+    }
+    else
+    {
+        startCursor = &startCursorLocal;
+        if (!keyedvector_first(kv, startCursor))
+            return 0; /* No elements */
+    }
+
+    if (endCursor)
+    {
+        if (endCursor->blockIndex < 0 || endCursor->blockIndex >= kv->Nblocks || endCursor->subIndex < 0
+            || endCursor->subIndex >= kv->blockNelem[endCursor->blockIndex])
+            return KV_ST_BADPARAM;
+    }
+    else
+    {
+        endCursor = &endCursorLocal;
+        if (!keyedvector_last(kv, endCursor))
+            return 0; /* No elements */
+    }
+
+    Ncopied = 0;
+    for (blockIdx = startCursor->blockIndex; blockIdx <= endCursor->blockIndex && Ncopied < maxElements;
+         blockIdx++)
+    {
+        startSubIdx = 0;
+        if (blockIdx == startCursor->blockIndex)
+            startSubIdx = startCursor->subIndex;
+
+        endSubIdx = kv->blockNelem[blockIdx] - 1;
+        if (blockIdx == endCursor->blockIndex)
+            endSubIdx = endCursor->subIndex;
+
+        NtoCopy = (endSubIdx + 1) - startSubIdx;
+        if (NtoCopy <= 0)
+            continue; /* endCursor is before startCursor */
+        if (NtoCopy > maxElements - Ncopied)
+            NtoCopy = maxElements - Ncopied;
+
+        if (dest)
+        {
+            memcpy(&dest[Ncopied * kv->elemSize],
+                   &((char *)kv->blocks[blockIdx])[startSubIdx * kv->elemSize],
+                   NtoCopy * kv->elemSize);
+        }
+        Ncopied += NtoCopy;
+    }
+
+    return Ncopied;
+}
+
 /*****************************************************************************/
 int keyedvector_remove(keyedvector_p kv, void *key)
 {
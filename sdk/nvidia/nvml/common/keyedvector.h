@@ -246,6 +246,53 @@ Returns: 0 if OK
         <0 KV_ST_? #define on error
 */
 
+    /*************************************************************************/
+    int keyedvector_remove_first(keyedvector_p kv, int count);
+    /*
+Remove the first count elements. Blocks that only hold removed elements are
+freed as a whole and only the elements left in the last partial block are
+moved. Removing more elements than there are empties the collection.
+
+Returns: 0 if OK
+        <0 KV_ST_? #define on error
+*/
+
+    /*************************************************************************/
+    int keyedvector_append(keyedvector_p kv, void *elements, int count);
+    /*
+Append elements, an array of count elements, past the last element. Elements are
+copied into the last block and new blocks a block at a time rather than inserted
+one by one.
+
+Appending stops at the first element that does not sort after both the last
+element of the collection and the element before it in the array. The caller
+can keyedvector_insert() that element and append the rest.
+
+Note that this operation invalidates other cursors
+
+Returns: >= 0 Number of elements appended from the front of elements
+          < 0 KV_ST_? #define on error. Some elements may have been appended
+*/
+
+    /*************************************************************************/
+    int keyedvector_copy_range(keyedvector_p kv,
+                               kv_cursor_p startCursor,
+                               kv_cursor_p endCursor,
+                               void *elements,
+                               int maxElements);
+    /*
+Copy the elements between and including two cursors to elements, a block of
+memory at a time.
+
+startCursor     IN: Starting position to copy from. NULL=beginning of dataset
+endCursor       IN: Ending position to copy until. NULL=end of dataset
+elements       OUT: Array of at least maxElements elements. NULL to just count
+maxElements     IN: Maximum number of elements to copy
+
+Returns: >= 0 Number of elements copied. 0 if endCursor is before startCursor
+          < 0 KV_ST_? #define on error
+*/
+
     /*************************************************************************/
     /*
 Return the number of elements in the collection
@@ -9,6 +9,7 @@
 #include <limits.h>
 #include <memory.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 /*****************************************************************************/
@@ -98,6 +99,19 @@ unsigned long timelib_getMillis(void)
     return GetTickCount();
 }
 
+/*****************************************************************************/
+/* timelib_usecSince1970() is already read from the performance counter here */
+timelib64_t timelib_monotonicUsec(void)
+{
+    return timelib_usecSince1970();
+}
+
+/*****************************************************************************/
+timelib64_t timelib_fastUsecSince1970(void)
+{
+    return timelib_usecSince1970();
+}
+
 /*****************************************************************************/
 #else //Linux
 /*****************************************************************************/
@@ -113,6 +127,178 @@ timelib64_t timelib_usecSince1970(void)
     return retTime;
 }
 
+/*****************************************************************************/
+/* Constant rate counter behind timelib_monotonicUsec(), where the CPU has one */
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define TIMELIB_HAVE_COUNTER 1
+static inline unsigned long long timelib_readCounter(void)
+{
+    return __rdtsc();
+}
+#elif defined(__aarch64__)
+#define TIMELIB_HAVE_COUNTER 1
+static inline unsigned long long timelib_readCounter(void)
+{
+    unsigned long long value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+}
+#elif defined(__powerpc64__)
+#define TIMELIB_HAVE_COUNTER 1
+static inline unsigned long long timelib_readCounter(void)
+{
+    return __builtin_ppc_get_timebase();
+}
+#endif
+
+#define TIMELIB_CALIBRATE_USEC 10000 /* How long a thread measures the counter rate before using it */
+
+/* Per-thread calibration of the counter, so that reading it needs no locking */
+typedef struct
+{
+    int haveSynced;                    /* first* are set */
+    int calibrated;                    /* usecPerCycle is set */
+    unsigned long long firstCycles;    /* Counter at the first sync. The rate is measured from here */
+    timelib64_t firstMonoUsec;         /* CLOCK_MONOTONIC at the first sync */
+    unsigned long long syncCycles;     /* Counter at the last sync */
+    timelib64_t syncMonoUsec;          /* CLOCK_MONOTONIC at the last sync */
+    unsigned long long nextSyncCycles; /* Sync again once the counter gets here */
+    double usecPerCycle;               /* Measured rate of the counter */
+    timelib64_t wallOffsetUsec;        /* usec since 1970 minus CLOCK_MONOTONIC at the last sync */
+    timelib64_t lastMonoUsec;          /* Last value timelib_monotonicUsec() returned */
+} timelib_counterClock_t;
+
+static __thread timelib_counterClock_t counterClock;
+static int counterUsable = -1; /* 1 if the counter can be used. 0 if not. -1 if not checked yet */
+
+/*****************************************************************************/
+static timelib64_t timelib_clockUsec(clockid_t clock)
+{
+    struct timespec now;
+
+    clock_gettime(clock, &now);
+    return now.tv_sec * (timelib64_t)1000000 + now.tv_nsec / 1000;
+}
+
+/*****************************************************************************/
+static int timelib_checkCounter(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    char clocksource[32] = { 0 };
+    FILE *fp;
+
+    /* The TSC has to tick at a constant rate through frequency and sleep state changes... */
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1 << 8)))
+        return 0;
+
+    /* ...and agree across CPUs, which the kernel only vouches for by using it itself.
+       Hypervisors commonly hide an unreliable TSC this way */
+    fp = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if (!fp)
+        return 0;
+    if (!fgets(clocksource, sizeof(clocksource), fp))
+        clocksource[0] = 0;
+    fclose(fp);
+    return !strcmp(clocksource, "tsc\n");
+#elif defined(TIMELIB_HAVE_COUNTER)
+    return 1; /* Architecturally constant rate and synchronized */
+#else
+    return 0;
+#endif
+}
+
+/*****************************************************************************/
+static int timelib_counterUsable(void)
+{
+    int usable = __atomic_load_n(&counterUsable, __ATOMIC_RELAXED);
+
+    if (usable < 0)
+    {
+        usable = timelib_checkCounter();
+        __atomic_store_n(&counterUsable, usable, __ATOMIC_RELAXED);
+    }
+    return usable;
+}
+
+#ifdef TIMELIB_HAVE_COUNTER
+/*****************************************************************************/
+/* Read the kernel's clocks and recalibrate the counter against them. Returns
+ * CLOCK_MONOTONIC in usec */
+static timelib64_t timelib_syncCounter(timelib_counterClock_t *c, unsigned long long cycles)
+{
+    timelib64_t monoUsec = timelib_clockUsec(CLOCK_MONOTONIC);
+
+    c->wallOffsetUsec = timelib_clockUsec(CLOCK_REALTIME) - monoUsec;
+
+    if (!c->haveSynced)
+    {
+        c->firstCycles   = cycles;
+        c->firstMonoUsec = monoUsec;
+        c->haveSynced    = 1;
+    }
+    else if (monoUsec - c->firstMonoUsec >= TIMELIB_CALIBRATE_USEC && cycles > c->firstCycles)
+    {
+        /* Measured over the life of the thread so far, so it only gets more precise */
+        c->usecPerCycle = (double)(monoUsec - c->firstMonoUsec) / (double)(cycles - c->firstCycles);
+        c->calibrated   = 1;
+    }
+
+    c->syncCycles   = cycles;
+    c->syncMonoUsec = monoUsec;
+
+    /* Until the rate is known, every call syncs */
+    c->nextSyncCycles = cycles;
+    if (c->calibrated)
+        c->nextSyncCycles += (unsigned long long)(TIMELIB_RESYNC_USEC / c->usecPerCycle);
+    return monoUsec;
+}
+#endif
+
+/*****************************************************************************/
+timelib64_t timelib_monotonicUsec(void)
+{
+    timelib_counterClock_t *c = &counterClock;
+    timelib64_t usec;
+
+    if (!timelib_counterUsable())
+        usec = timelib_clockUsec(CLOCK_MONOTONIC);
+    else
+    {
+#ifdef TIMELIB_HAVE_COUNTER
+        unsigned long long cycles = timelib_readCounter();
+
+        if (!c->calibrated || cycles >= c->nextSyncCycles || cycles < c->syncCycles)
+            usec = timelib_syncCounter(c, cycles);
+        else
+            usec = c->syncMonoUsec + (timelib64_t)((double)(cycles - c->syncCycles) * c->usecPerCycle);
+#else
+        usec = timelib_clockUsec(CLOCK_MONOTONIC); /* Not reachable */
+#endif
+    }
+
+    /* A resync can land slightly behind what the counter extrapolated */
+    if (usec < c->lastMonoUsec)
+        usec = c->lastMonoUsec;
+    c->lastMonoUsec = usec;
+    return usec;
+}
+
+/*****************************************************************************/
+timelib64_t timelib_fastUsecSince1970(void)
+{
+    timelib64_t monoUsec;
+
+    if (!timelib_counterUsable())
+        return timelib_usecSince1970();
+
+    /* Syncs, and so updates the offset, first if it is due */
+    monoUsec = timelib_monotonicUsec();
+    return monoUsec + counterClock.wallOffsetUsec;
+}
+
 #if 0
 /*****************************************************************************/
 unsigned long timelib_getMillis(void)
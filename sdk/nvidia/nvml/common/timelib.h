@@ -45,6 +45,31 @@ extern "C"
 	Returns microseconds since 1970 as a double
 */
 
+    /*****************************************************************************/
+    timelib64_t timelib_monotonicUsec(void);
+    /*
+	Returns microseconds since an unspecified starting point. This never goes
+	backwards within a thread and is not affected by changes to the system clock,
+	so it is what to use for measuring how long something took.
+
+	Where the CPU has a constant rate counter that the kernel trusts (an invariant
+	TSC on x86, the generic timer on ARM, the timebase on POWER), this is a read
+	of that counter scaled by a per-thread calibration against CLOCK_MONOTONIC,
+	which is several times cheaper than asking the kernel. Otherwise, and for the
+	first few ms of each thread while it calibrates, it is CLOCK_MONOTONIC.
+*/
+
+    /*****************************************************************************/
+    timelib64_t timelib_fastUsecSince1970(void);
+    /*
+	Returns microseconds since 1970 like timelib_usecSince1970(), derived from
+	timelib_monotonicUsec() plus an offset to the system clock that is resynced
+	every TIMELIB_RESYNC_USEC. Changes to the system clock take up to that long
+	to show up. Meant for hot paths that timestamp many samples in a row
+*/
+
+#define TIMELIB_RESYNC_USEC 100000 /* How often timelib_fastUsecSince1970() resyncs with the system clock */
+
     /*****************************************************************************/
     void timelib_addToClock(timelib64_t howMuch);
     /*
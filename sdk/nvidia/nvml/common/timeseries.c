@@ -16,6 +16,13 @@
 
 #endif // _WINDOWS
 
+#define TS_INSERT_MANY_CHUNK 256 /* Entries timeseries_insert_many() stages on the stack for keyedvector_append() */
+
+/*****************************************************************************/
+/* Stubs for local functions */
+static int timeseries_ring_total(timeseries_p ts);
+static void timeseries_blocks_remove_front(timeseries_blocks_p c, int numBlocks);
+
 /*****************************************************************************/
 static int timeseries_compareCB(timeseries_entry_p elem1, timeseries_entry_p elem2)
 {
@@ -33,6 +40,156 @@ static int timeseries_mergeCB(timeseries_entry_p current, timeseries_entry_p ins
     return KV_ST_DUPLICATE; /* Need to resolve */
 }
 
+/*****************************************************************************/
+/* Bytes a value of valueSize takes up in a slab, including its header */
+static long long timeseries_slab_value_size(long long valueSize)
+{
+    return TS_SLAB_ALIGN + ((valueSize + TS_SLAB_ALIGN - 1) & ~(long long)(TS_SLAB_ALIGN - 1));
+}
+
+/*****************************************************************************/
+static void timeseries_arena_free_slab(timeseries_arena_p arena, timeseries_slab_p slab)
+{
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        arena->oldest = slab->next;
+    if (slab->next)
+        slab->next->prev = slab->prev;
+    else
+        arena->newest = slab->prev;
+
+    if (arena->current == slab)
+        arena->current = 0;
+
+    arena->numSlabs--;
+    arena->slabBytes -= sizeof(*slab) + slab->size;
+    free(slab);
+}
+
+/*****************************************************************************/
+/* Allocate valueSize bytes for a value. Returns NULL if out of memory */
+static void *timeseries_arena_alloc(timeseries_arena_p arena, long long valueSize)
+{
+    long long needed       = timeseries_slab_value_size(valueSize);
+    timeseries_slab_p slab = arena->current;
+    int dedicated          = needed > TS_SLAB_MAX_SIZE / 4;
+    char *value;
+
+    /* Nothing left in the current slab. Start over at its front */
+    if (slab && !slab->numLive)
+        slab->used = 0;
+
+    if (dedicated || !slab || slab->size - slab->used < needed)
+    {
+        long long slabSize = 2 * arena->liveBytes;
+        if (slabSize < TS_SLAB_MIN_SIZE)
+            slabSize = TS_SLAB_MIN_SIZE;
+        if (slabSize > TS_SLAB_MAX_SIZE)
+            slabSize = TS_SLAB_MAX_SIZE;
+        if (dedicated)
+            slabSize = needed;
+
+        slab = (timeseries_slab_p)malloc(sizeof(*slab) + slabSize);
+        if (!slab)
+            return NULL;
+
+        slab->prev    = arena->newest;
+        slab->next    = 0;
+        slab->size    = slabSize;
+        slab->used    = 0;
+        slab->numLive = 0;
+        if (arena->newest)
+            arena->newest->next = slab;
+        else
+            arena->oldest = slab;
+        arena->newest = slab;
+        arena->numSlabs++;
+        arena->slabBytes += sizeof(*slab) + slabSize;
+
+        /* Oversized values don't take over the current slab */
+        if (!dedicated)
+        {
+            if (arena->current && !arena->current->numLive)
+                timeseries_arena_free_slab(arena, arena->current);
+            arena->current = slab;
+        }
+    }
+
+    value = (char *)(slab + 1) + slab->used;
+    *(timeseries_slab_p *)value = slab;
+    slab->used += needed;
+    slab->numLive++;
+    arena->liveBytes += needed;
+    return value + TS_SLAB_ALIGN;
+}
+
+/*****************************************************************************/
+/* Release a value from timeseries_arena_alloc(). Its slab is freed once it has
+ * no values left, unless it is still being carved from */
+static void timeseries_arena_release(timeseries_arena_p arena, void *value, long long valueSize)
+{
+    timeseries_slab_p slab = *(timeseries_slab_p *)((char *)value - TS_SLAB_ALIGN);
+
+    slab->numLive--;
+    arena->liveBytes -= timeseries_slab_value_size(valueSize);
+
+    if (!slab->numLive && slab != arena->current)
+        timeseries_arena_free_slab(arena, slab);
+}
+
+/*****************************************************************************/
+/* Allocate a column of a ring from its allocator */
+static void *timeseries_ring_alloc(timeseries_allocator_p allocator, size_t size)
+{
+    if (allocator)
+        return allocator->alloc(allocator->userData, size);
+    return malloc(size);
+}
+
+/*****************************************************************************/
+/* Same as timeseries_ring_alloc() but zeroed */
+static void *timeseries_ring_calloc(timeseries_allocator_p allocator, size_t size)
+{
+    void *ptr = timeseries_ring_alloc(allocator, size);
+    if (ptr)
+        memset(ptr, 0, size);
+    return ptr;
+}
+
+/*****************************************************************************/
+/* Free a column of capacity slots from timeseries_ring_alloc() */
+static void timeseries_ring_free(timeseries_allocator_p allocator, void *ptr, int capacity)
+{
+    if (!ptr)
+        return;
+    if (allocator)
+        allocator->release(allocator->userData, ptr, (size_t)capacity * sizeof(timeseries_value_t));
+    else
+        free(ptr);
+}
+
+/*****************************************************************************/
+/* Allocate the val2 column of a ring on the first non-zero val2 */
+static int timeseries_ring_alloc_val2(timeseries_ring_p ring)
+{
+    ring->val2 = (timeseries_value_t *)timeseries_ring_calloc(ring->allocator,
+                                                              ring->capacity * sizeof(timeseries_value_t));
+    return ring->val2 ? TS_ST_OK : TS_ST_MEMORY;
+}
+
+/*****************************************************************************/
+/* Free the columns of a ring, which were allocated from allocator */
+static void timeseries_ring_free_columns(timeseries_ring_p ring, timeseries_allocator_p allocator)
+{
+    timeseries_ring_free(allocator, ring->usecSince1970, ring->capacity);
+    timeseries_ring_free(allocator, ring->val, ring->capacity);
+    timeseries_ring_free(allocator, ring->val2, ring->capacity);
+    ring->usecSince1970 = 0;
+    ring->val           = 0;
+    ring->val2          = 0;
+}
+
 /*****************************************************************************/
 static void timeseries_freeCB(timeseries_entry_p elem, timeseries_p ts)
 {
@@ -40,7 +197,7 @@ static void timeseries_freeCB(timeseries_entry_p elem, timeseries_p ts)
     if (ts->tsType == TS_TYPE_STRING || ts->tsType == TS_TYPE_BLOB)
     {
         if (elem->val.ptr)
-            free(elem->val.ptr);
+            timeseries_arena_release(ts->arena, elem->val.ptr, elem->val2.ptrSize);
         elem->val.ptr      = 0;
         elem->val2.ptrSize = 0;
     }
@@ -58,6 +215,33 @@ void timeseries_destroy(timeseries_p ts)
         ts->keyedVector = 0;
     }
 
+    /* After the keyedvector, since freeing its entries releases their values */
+    if (ts->arena)
+    {
+        while (ts->arena->oldest)
+            timeseries_arena_free_slab(ts->arena, ts->arena->oldest);
+        free(ts->arena);
+        ts->arena = 0;
+    }
+
+    if (ts->compressed)
+    {
+        timeseries_blocks_remove_front(ts->compressed, ts->compressed->numBlocks);
+        free(ts->compressed->blocks);
+        free(ts->compressed->decodedUsec);
+        free(ts->compressed->decodedVal);
+        free(ts->compressed->decodedVal2);
+        free(ts->compressed);
+        ts->compressed = 0;
+    }
+
+    if (ts->ring)
+    {
+        timeseries_ring_free_columns(ts->ring, ts->ring->allocator);
+        free(ts->ring);
+        ts->ring = 0;
+    }
+
     free(ts);
 }
 
@@ -88,6 +272,17 @@ timeseries_p timeseries_alloc(int tsType, int *errorSt)
 
     ts->tsType = tsType;
 
+    if (tsType == TS_TYPE_STRING || tsType == TS_TYPE_BLOB)
+    {
+        ts->arena = (timeseries_arena_p)calloc(1, sizeof(*ts->arena));
+        if (!ts->arena)
+        {
+            *errorSt = TS_ST_MEMORY;
+            timeseries_destroy(ts);
+            return NULL;
+        }
+    }
+
     /* allocate the keyedvector */
     ts->keyedVector = keyedvector_alloc(sizeof(timeseries_entry_t),
                                         0,
@@ -106,15 +301,683 @@ timeseries_p timeseries_alloc(int tsType, int *errorSt)
     return ts;
 }
 
+/*****************************************************************************/
+timeseries_p timeseries_alloc_ring(int tsType, int initialCapacity, int *errorSt)
+{
+    timeseries_p ts = 0;
+    int capacity    = 1;
+
+    if (!errorSt)
+        return NULL;
+
+    *errorSt = TS_ST_OK;
+
+    if ((tsType != TS_TYPE_INT64 && tsType != TS_TYPE_DOUBLE) || initialCapacity < 1
+        || initialCapacity > TS_RING_MAX_CAPACITY)
+    {
+        *errorSt = TS_ST_BADPARAM;
+        return NULL;
+    }
+
+    while (capacity < initialCapacity)
+        capacity <<= 1;
+
+    ts = (timeseries_p)malloc(sizeof(*ts));
+    if (!ts)
+    {
+        *errorSt = TS_ST_MEMORY;
+        return NULL;
+    }
+    memset(ts, 0, sizeof(*ts));
+
+    ts->tsType  = tsType;
+    ts->storage = TS_STORAGE_RING;
+
+    ts->ring = (timeseries_ring_p)malloc(sizeof(*ts->ring));
+    if (!ts->ring)
+    {
+        *errorSt = TS_ST_MEMORY;
+        timeseries_destroy(ts);
+        return NULL;
+    }
+    memset(ts->ring, 0, sizeof(*ts->ring));
+
+    /* val2 is allocated lazily since most fields never set it */
+    ts->ring->capacity      = capacity;
+    ts->ring->usecSince1970 = (timelib64_t *)timeseries_ring_alloc(0, capacity * sizeof(timelib64_t));
+    ts->ring->val           = (timeseries_value_t *)timeseries_ring_alloc(0, capacity * sizeof(timeseries_value_t));
+    if (!ts->ring->usecSince1970 || !ts->ring->val)
+    {
+        PRINT_ERROR("%d", "Unable to allocate a timeseries ring of capacity %d\n", capacity);
+        *errorSt = TS_ST_MEMORY;
+        timeseries_destroy(ts);
+        return NULL;
+    }
+
+    return ts;
+}
+
+/*****************************************************************************/
+timeseries_p timeseries_alloc_compressed(int tsType, int *errorSt)
+{
+    timeseries_p ts = timeseries_alloc_ring(tsType, 2 * TS_BLOCK_SAMPLES, errorSt);
+    if (!ts)
+        return NULL;
+
+    ts->compressed = (timeseries_blocks_p)malloc(sizeof(*ts->compressed));
+    if (!ts->compressed)
+    {
+        *errorSt = TS_ST_MEMORY;
+        timeseries_destroy(ts);
+        return NULL;
+    }
+    memset(ts->compressed, 0, sizeof(*ts->compressed));
+    ts->compressed->decodedBlock = -1;
+
+    return ts;
+}
+
 /*****************************************************************************/
 int timeseries_size(timeseries_p ts)
 {
-    if (!ts || !ts->keyedVector)
+    if (!ts)
+        return 0;
+
+    if (ts->ring)
+        return timeseries_ring_total(ts);
+
+    if (!ts->keyedVector)
         return 0;
 
     return keyedvector_size(ts->keyedVector);
 }
 
+/*****************************************************************************/
+/* Convert a logical ring index (0=oldest) to a physical slot */
+static inline int timeseries_ring_slot(timeseries_ring_p ring, int index)
+{
+    return (ring->head + index) & (ring->capacity - 1);
+}
+
+/*****************************************************************************/
+/* Return the logical index of the first sample with a timestamp >= time.
+ * Returns ring->count if there is no such sample */
+static int timeseries_ring_lower_bound(timeseries_ring_p ring, timelib64_t time)
+{
+    int low  = 0;
+    int high = ring->count;
+
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        if (ring->usecSince1970[timeseries_ring_slot(ring, mid)] < time)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+/*****************************************************************************/
+/* Copy the sample at logical index into entry and return entry */
+static timeseries_entry_p timeseries_ring_materialize(timeseries_ring_p ring, int index, timeseries_entry_p entry)
+{
+    int slot = timeseries_ring_slot(ring, index);
+
+    entry->usecSince1970 = ring->usecSince1970[slot];
+    entry->val.i64       = ring->val[slot].i64;
+    entry->val2.i64      = ring->val2 ? ring->val2[slot].i64 : 0;
+    return entry;
+}
+
+/*****************************************************************************/
+/* Move the samples of the ring into columns of newCapacity slots from allocator,
+ * compacting them so that head is 0. newCapacity must be at least ring->count */
+static int timeseries_ring_move(timeseries_ring_p ring, int newCapacity, timeseries_allocator_p allocator)
+{
+    int i, slot;
+    timelib64_t *newTimes;
+    timeseries_value_t *newVal;
+    timeseries_value_t *newVal2 = 0;
+
+    newTimes = (timelib64_t *)timeseries_ring_alloc(allocator, newCapacity * sizeof(timelib64_t));
+    newVal   = (timeseries_value_t *)timeseries_ring_alloc(allocator, newCapacity * sizeof(timeseries_value_t));
+    if (ring->val2)
+        newVal2 = (timeseries_value_t *)timeseries_ring_calloc(allocator, newCapacity * sizeof(timeseries_value_t));
+
+    if (!newTimes || !newVal || (ring->val2 && !newVal2))
+    {
+        timeseries_ring_free(allocator, newTimes, newCapacity);
+        timeseries_ring_free(allocator, newVal, newCapacity);
+        timeseries_ring_free(allocator, newVal2, newCapacity);
+        return TS_ST_MEMORY;
+    }
+
+    for (i = 0; i < ring->count; i++)
+    {
+        slot        = timeseries_ring_slot(ring, i);
+        newTimes[i] = ring->usecSince1970[slot];
+        newVal[i]   = ring->val[slot];
+        if (newVal2)
+            newVal2[i] = ring->val2[slot];
+    }
+
+    timeseries_ring_free_columns(ring, ring->allocator);
+
+    ring->usecSince1970 = newTimes;
+    ring->val           = newVal;
+    ring->val2          = newVal2;
+    ring->capacity      = newCapacity;
+    ring->head          = 0;
+    ring->allocator     = allocator;
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+/* Move the samples of the ring into columns of newCapacity slots, which must be
+ * at least ring->count */
+static int timeseries_ring_resize(timeseries_ring_p ring, int newCapacity)
+{
+    return timeseries_ring_move(ring, newCapacity, ring->allocator);
+}
+
+/*****************************************************************************/
+int timeseries_set_allocator(timeseries_p ts, timeseries_allocator_p allocator)
+{
+    if (!ts || !ts->ring)
+        return TS_ST_BADPARAM;
+
+    if (ts->ring->allocator == allocator)
+        return TS_ST_OK;
+
+    return timeseries_ring_move(ts->ring, ts->ring->capacity, allocator);
+}
+
+/*****************************************************************************/
+static int timeseries_ring_grow(timeseries_ring_p ring)
+{
+    if (ring->capacity * 2 > TS_RING_MAX_CAPACITY)
+        return TS_ST_MEMORY;
+
+    return timeseries_ring_resize(ring, ring->capacity * 2);
+}
+
+/*****************************************************************************/
+static int timeseries_ring_insert(timeseries_p ts, timeseries_entry_p entry)
+{
+    timeseries_ring_p ring = ts->ring;
+    int tries;
+    int maxTries = 10000; /* infinite loops are bad */
+    int index, i, slot, prevSlot;
+    int st;
+
+    if (!entry->usecSince1970)
+        entry->usecSince1970 = timelib_usecSince1970();
+
+    if (ring->count == ring->capacity)
+    {
+        st = timeseries_ring_grow(ring);
+        if (st)
+        {
+            PRINT_ERROR("%d %d", "Error %d growing timeseries ring of capacity %d\n", st, ring->capacity);
+            return st;
+        }
+    }
+
+    if (entry->val2.i64 != 0 && !ring->val2)
+    {
+        if (timeseries_ring_alloc_val2(ring))
+            return TS_ST_MEMORY;
+    }
+
+    if (!ring->count || entry->usecSince1970 > ring->usecSince1970[timeseries_ring_slot(ring, ring->count - 1)])
+    {
+        /* Fast path. Samples almost always arrive in time order */
+        index = ring->count;
+    }
+    else
+    {
+        /* Same collision behavior as the keyedvector storage: bump the timestamp
+           until it is unique */
+        for (tries = 0;; tries++)
+        {
+            if (tries >= maxTries)
+                return TS_ST_DUPETIMESTAMP;
+
+            index = timeseries_ring_lower_bound(ring, entry->usecSince1970);
+            if (index >= ring->count
+                || ring->usecSince1970[timeseries_ring_slot(ring, index)] != entry->usecSince1970)
+                break;
+
+            entry->usecSince1970++;
+        }
+
+        /* Shift newer samples up a slot to make room */
+        for (i = ring->count; i > index; i--)
+        {
+            slot                      = timeseries_ring_slot(ring, i);
+            prevSlot                  = timeseries_ring_slot(ring, i - 1);
+            ring->usecSince1970[slot] = ring->usecSince1970[prevSlot];
+            ring->val[slot]           = ring->val[prevSlot];
+            if (ring->val2)
+                ring->val2[slot] = ring->val2[prevSlot];
+        }
+    }
+
+    slot                      = timeseries_ring_slot(ring, index);
+    ring->usecSince1970[slot] = entry->usecSince1970;
+    ring->val[slot].i64       = entry->val.i64;
+    if (ring->val2)
+        ring->val2[slot].i64 = entry->val2.i64;
+    ring->count++;
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+/* Drop the oldest numToDrop samples from the ring. O(1) */
+static void timeseries_ring_drop_oldest(timeseries_ring_p ring, int numToDrop)
+{
+    if (numToDrop >= ring->count)
+    {
+        ring->head  = 0;
+        ring->count = 0;
+        return;
+    }
+
+    ring->head = timeseries_ring_slot(ring, numToDrop);
+    ring->count -= numToDrop;
+}
+
+/*****************************************************************************/
+/* Push a sample in front of the oldest sample of the ring. The caller is
+ * responsible for keeping the ring in time order */
+static int timeseries_ring_push_front(timeseries_ring_p ring, timelib64_t usec, long long val, long long val2)
+{
+    int st;
+
+    if (ring->count == ring->capacity)
+    {
+        st = timeseries_ring_grow(ring);
+        if (st)
+            return st;
+    }
+
+    if (val2 != 0 && !ring->val2)
+    {
+        if (timeseries_ring_alloc_val2(ring))
+            return TS_ST_MEMORY;
+    }
+
+    ring->head                      = (ring->head + ring->capacity - 1) & (ring->capacity - 1);
+    ring->usecSince1970[ring->head] = usec;
+    ring->val[ring->head].i64       = val;
+    if (ring->val2)
+        ring->val2[ring->head].i64 = val2;
+    ring->count++;
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+/* Total number of samples in a TS_STORAGE_RING timeseries, including its
+ * compressed history */
+static int timeseries_ring_total(timeseries_p ts)
+{
+    return ts->ring->count + (ts->compressed ? ts->compressed->numSamples : 0);
+}
+
+/*****************************************************************************/
+/* Make blockIndex the decoded block of ts->compressed. decodedBase must be
+ * updated by the caller */
+static int timeseries_blocks_decode(timeseries_p ts, int blockIndex)
+{
+    timeseries_blocks_p c = ts->compressed;
+    int st;
+
+    if (c->decodedBlock == blockIndex)
+        return TS_ST_OK;
+
+    if (!c->decodedUsec)
+    {
+        c->decodedUsec = (timelib64_t *)malloc(TS_BLOCK_SAMPLES * sizeof(timelib64_t));
+        c->decodedVal  = (long long *)malloc(TS_BLOCK_SAMPLES * sizeof(long long));
+        c->decodedVal2 = (long long *)malloc(TS_BLOCK_SAMPLES * sizeof(long long));
+        if (!c->decodedUsec || !c->decodedVal || !c->decodedVal2)
+        {
+            free(c->decodedUsec);
+            free(c->decodedVal);
+            free(c->decodedVal2);
+            c->decodedUsec = 0;
+            c->decodedVal  = 0;
+            c->decodedVal2 = 0;
+            return TS_ST_MEMORY;
+        }
+    }
+
+    c->decodedBlock = -1;
+    st              = tscompress_decode_block(
+        ts->tsType, &c->blocks[blockIndex], c->decodedUsec, c->decodedVal, c->decodedVal2);
+    if (st)
+        return st;
+
+    c->decodedBlock = blockIndex;
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+/* Decode the block that contains the live sample at logical index, which must
+ * be < ts->compressed->numSamples. Returns the position of the sample within
+ * the decoded arrays or < 0 on error */
+static int timeseries_blocks_locate(timeseries_p ts, int index)
+{
+    timeseries_blocks_p c = ts->compressed;
+    timeseries_block_p block;
+    int blockIndex = 0, base = 0, live, st;
+
+    /* Sequential reads stay within the last decoded block */
+    if (c->decodedBlock >= 0)
+    {
+        block = &c->blocks[c->decodedBlock];
+        if (index >= c->decodedBase && index < c->decodedBase + block->count - block->skip)
+            return block->skip + index - c->decodedBase;
+
+        /* Start walking from the decoded block if we're past it */
+        if (index >= c->decodedBase)
+        {
+            blockIndex = c->decodedBlock;
+            base       = c->decodedBase;
+        }
+    }
+
+    for (; blockIndex < c->numBlocks; blockIndex++)
+    {
+        block = &c->blocks[blockIndex];
+        live  = block->count - block->skip;
+        if (index < base + live)
+        {
+            st = timeseries_blocks_decode(ts, blockIndex);
+            if (st)
+                return st;
+            c->decodedBase = base;
+            return block->skip + index - base;
+        }
+        base += live;
+    }
+
+    return TS_ST_BADPARAM;
+}
+
+/*****************************************************************************/
+/* Copy the sample at logical index of a TS_STORAGE_RING timeseries into entry.
+ * Returns NULL if the sample couldn't be decoded */
+static timeseries_entry_p timeseries_ring_entry(timeseries_p ts, int index, timeseries_entry_p entry)
+{
+    timeseries_blocks_p c = ts->compressed;
+    int position;
+
+    if (!c || index >= c->numSamples)
+        return timeseries_ring_materialize(ts->ring, index - (c ? c->numSamples : 0), entry);
+
+    position = timeseries_blocks_locate(ts, index);
+    if (position < 0)
+        return NULL;
+
+    entry->usecSince1970 = c->decodedUsec[position];
+    entry->val.i64       = c->decodedVal[position];
+    entry->val2.i64      = c->decodedVal2[position];
+    return entry;
+}
+
+/*****************************************************************************/
+/* Return the logical index of the first sample with a timestamp >= time across
+ * the compressed history and the ring */
+static int timeseries_ring_total_lower_bound(timeseries_p ts, timelib64_t time)
+{
+    timeseries_blocks_p c = ts->compressed;
+    timeseries_block_p block = NULL;
+    int blockIndex, base = 0, low, high, mid;
+
+    if (c && c->numSamples && time <= c->blocks[c->numBlocks - 1].lastUsec)
+    {
+        for (blockIndex = 0; blockIndex < c->numBlocks; blockIndex++)
+        {
+            if (c->blocks[blockIndex].lastUsec >= time)
+            {
+                block = &c->blocks[blockIndex];
+                break;
+            }
+            base += c->blocks[blockIndex].count - c->blocks[blockIndex].skip;
+        }
+
+        /* Every compressed sample is before time. The bound is in the ring */
+        if (!block)
+            return base + timeseries_ring_lower_bound(ts->ring, time);
+
+        if (timeseries_blocks_decode(ts, blockIndex))
+            return base; /* Already logged. Best effort */
+        c->decodedBase = base;
+
+        low  = block->skip;
+        high = block->count;
+        while (low < high)
+        {
+            mid = low + (high - low) / 2;
+            if (c->decodedUsec[mid] < time)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        return base + low - block->skip;
+    }
+
+    return (c ? c->numSamples : 0) + timeseries_ring_lower_bound(ts->ring, time);
+}
+
+/*****************************************************************************/
+/* Find the logical index of the sample matching time and findOp (TS_LGE_?).
+ * Returns -1 if not found */
+static int timeseries_ring_find_index(timeseries_p ts, timelib64_t time, int findOp)
+{
+    timeseries_entry_t entry;
+    int total = timeseries_ring_total(ts);
+    int index;
+
+    switch (findOp)
+    {
+        case TS_LGE_EQUAL:
+            index = timeseries_ring_total_lower_bound(ts, time);
+            if (index < total && timeseries_ring_entry(ts, index, &entry) && entry.usecSince1970 == time)
+                return index;
+            return -1;
+
+        case TS_LGE_GREATEQUAL:
+            index = timeseries_ring_total_lower_bound(ts, time);
+            break;
+
+        case TS_LGE_GREATER:
+            index = timeseries_ring_total_lower_bound(ts, time + 1);
+            break;
+
+        case TS_LGE_LESSEQUAL:
+            index = timeseries_ring_total_lower_bound(ts, time + 1) - 1;
+            break;
+
+        case TS_LGE_LESS:
+            index = timeseries_ring_total_lower_bound(ts, time) - 1;
+            break;
+
+        default:
+            return -1;
+    }
+
+    if (index < 0 || index >= total)
+        return -1;
+    return index;
+}
+
+/*****************************************************************************/
+/* Remove the first numBlocks blocks of the compressed history */
+static void timeseries_blocks_remove_front(timeseries_blocks_p c, int numBlocks)
+{
+    int i;
+
+    for (i = 0; i < numBlocks; i++)
+    {
+        c->numSamples -= c->blocks[i].count - c->blocks[i].skip;
+        c->numBytes -= c->blocks[i].numBytes;
+        tscompress_free_block(&c->blocks[i]);
+    }
+
+    c->numBlocks -= numBlocks;
+    memmove(c->blocks, &c->blocks[numBlocks], c->numBlocks * sizeof(c->blocks[0]));
+    c->decodedBlock = -1;
+}
+
+/*****************************************************************************/
+/* Seal the oldest TS_BLOCK_SAMPLES samples of the ring into a compressed block */
+static int timeseries_blocks_seal_oldest(timeseries_p ts)
+{
+    timeseries_blocks_p c  = ts->compressed;
+    timeseries_ring_p ring = ts->ring;
+    timelib64_t usec[TS_BLOCK_SAMPLES];
+    long long val[TS_BLOCK_SAMPLES];
+    long long val2[TS_BLOCK_SAMPLES];
+    int i, slot, st;
+
+    if (c->numBlocks == c->capacity)
+    {
+        int newCapacity                = c->capacity ? c->capacity * 2 : 16;
+        timeseries_block_p newBlocks = (timeseries_block_p)realloc(c->blocks, newCapacity * sizeof(c->blocks[0]));
+        if (!newBlocks)
+            return TS_ST_MEMORY;
+        c->blocks   = newBlocks;
+        c->capacity = newCapacity;
+    }
+
+    for (i = 0; i < TS_BLOCK_SAMPLES; i++)
+    {
+        slot    = timeseries_ring_slot(ring, i);
+        usec[i] = ring->usecSince1970[slot];
+        val[i]  = ring->val[slot].i64;
+        val2[i] = ring->val2 ? ring->val2[slot].i64 : 0;
+    }
+
+    st = tscompress_encode_block(
+        ts->tsType, usec, val, ring->val2 ? val2 : NULL, TS_BLOCK_SAMPLES, &c->blocks[c->numBlocks]);
+    if (st)
+        return st;
+
+    c->numSamples += TS_BLOCK_SAMPLES;
+    c->numBytes += c->blocks[c->numBlocks].numBytes;
+    c->numBlocks++;
+    timeseries_ring_drop_oldest(ring, TS_BLOCK_SAMPLES);
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+/* Move the live samples of the newest compressed block back into the ring so an
+ * out-of-order sample can be inserted before them */
+static int timeseries_blocks_unseal_newest(timeseries_p ts)
+{
+    timeseries_blocks_p c = ts->compressed;
+    int blockIndex        = c->numBlocks - 1;
+    timeseries_block_p block;
+    int i, st;
+
+    st = timeseries_blocks_decode(ts, blockIndex);
+    if (st)
+        return st;
+
+    block = &c->blocks[blockIndex];
+    for (i = block->count - 1; i >= block->skip; i--)
+    {
+        st = timeseries_ring_push_front(ts->ring, c->decodedUsec[i], c->decodedVal[i], c->decodedVal2[i]);
+        if (st)
+            return st;
+    }
+
+    c->numSamples -= block->count - block->skip;
+    c->numBytes -= block->numBytes;
+    tscompress_free_block(block);
+    c->numBlocks--;
+    c->decodedBlock = -1;
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+/* Drop the oldest numToDrop samples of a compressed TS_STORAGE_RING timeseries */
+static void timeseries_blocks_drop_oldest(timeseries_p ts, int numToDrop)
+{
+    timeseries_blocks_p c = ts->compressed;
+    int numWholeBlocks    = 0;
+    int live;
+
+    while (numToDrop > 0 && numWholeBlocks < c->numBlocks)
+    {
+        live = c->blocks[numWholeBlocks].count - c->blocks[numWholeBlocks].skip;
+        if (numToDrop < live)
+            break;
+        numToDrop -= live;
+        numWholeBlocks++;
+    }
+
+    if (numWholeBlocks)
+        timeseries_blocks_remove_front(c, numWholeBlocks);
+
+    if (numToDrop <= 0)
+        return;
+
+    if (c->numBlocks)
+    {
+        /* Partially consumed block. The decoded copy stays valid but its base moves */
+        c->blocks[0].skip += numToDrop;
+        c->numSamples -= numToDrop;
+        if (c->decodedBlock == 0)
+            c->decodedBase = 0;
+        else
+            c->decodedBlock = -1;
+        return;
+    }
+
+    timeseries_ring_drop_oldest(ts->ring, numToDrop);
+}
+
+/*****************************************************************************/
+static int timeseries_compressed_insert(timeseries_p ts, timeseries_entry_p entry)
+{
+    timeseries_blocks_p c = ts->compressed;
+    int st;
+
+    if (!entry->usecSince1970)
+        entry->usecSince1970 = timelib_usecSince1970();
+
+    /* Rare: the sample belongs inside the sealed history. Unseal until it doesn't */
+    while (c->numBlocks && entry->usecSince1970 <= c->blocks[c->numBlocks - 1].lastUsec)
+    {
+        st = timeseries_blocks_unseal_newest(ts);
+        if (st)
+            return st;
+    }
+
+    st = timeseries_ring_insert(ts, entry);
+    if (st)
+        return st;
+
+    /* Keep at least a block's worth of samples uncompressed so recent reads stay cheap */
+    while (ts->ring->count >= 2 * TS_BLOCK_SAMPLES)
+    {
+        st = timeseries_blocks_seal_oldest(ts);
+        if (st)
+        {
+            PRINT_ERROR("%d", "Error %d sealing a timeseries block\n", st);
+            return st;
+        }
+    }
+
+    return TS_ST_OK;
+}
+
 /*****************************************************************************/
 static int timeseries_insert(timeseries_p ts, timeseries_entry_p entry)
 {
@@ -123,6 +986,11 @@ static int timeseries_insert(timeseries_p ts, timeseries_entry_p entry)
     int insertSt;
     kv_cursor_t cursor;
 
+    if (ts->compressed)
+        return timeseries_compressed_insert(ts, entry);
+    if (ts->ring)
+        return timeseries_ring_insert(ts, entry);
+
     if (!entry->usecSince1970)
         entry->usecSince1970 = timelib_usecSince1970();
 
@@ -177,9 +1045,16 @@ int timeseries_insert_string(timeseries_p ts, timelib64_t timestamp, char *value
         return TS_ST_WRONGTYPE;
 
     entry.usecSince1970 = timestamp;
-    entry.val.ptr       = strdup(value);
     entry.val2.ptrSize  = strlen(value) + 1;
-    retSt               = timeseries_insert(ts, &entry);
+    entry.val.ptr       = timeseries_arena_alloc(ts->arena, entry.val2.ptrSize);
+    if (!entry.val.ptr)
+        return TS_ST_MEMORY;
+
+    memcpy(entry.val.ptr, value, entry.val2.ptrSize);
+
+    retSt = timeseries_insert(ts, &entry);
+    if (retSt != TS_ST_OK)
+        timeseries_arena_release(ts->arena, entry.val.ptr, entry.val2.ptrSize);
     return retSt;
 }
 
@@ -195,7 +1070,7 @@ int timeseries_insert_blob(timeseries_p ts, timelib64_t timestamp, void *value,
         return TS_ST_WRONGTYPE;
 
     entry.usecSince1970 = timestamp;
-    entry.val.ptr       = malloc(valueSize);
+    entry.val.ptr       = timeseries_arena_alloc(ts->arena, valueSize);
     if (!entry.val.ptr)
         return TS_ST_MEMORY;
 
@@ -203,6 +1078,8 @@ int timeseries_insert_blob(timeseries_p ts, timelib64_t timestamp, void *value,
 
     entry.val2.ptrSize = valueSize;
     retSt              = timeseries_insert(ts, &entry);
+    if (retSt != TS_ST_OK)
+        timeseries_arena_release(ts->arena, entry.val.ptr, entry.val2.ptrSize);
     return retSt;
 }
 
@@ -245,51 +1122,192 @@ int timeseries_insert_double(timeseries_p ts, timelib64_t timestamp, double valu
     int retSt;
     timeseries_entry_t entry;
 
-    if (!ts || !ts->keyedVector)
+    if (!ts || (!ts->keyedVector && !ts->ring))
         return TS_ST_BADPARAM;
     if (ts->tsType != TS_TYPE_DOUBLE)
         return TS_ST_WRONGTYPE;
 
-    entry.usecSince1970 = timestamp;
-    entry.val.dbl       = value1;
-    entry.val2.dbl      = value2;
-    retSt               = timeseries_insert(ts, &entry);
-    return retSt;
+    entry.usecSince1970 = timestamp;
+    entry.val.dbl       = value1;
+    entry.val2.dbl      = value2;
+    retSt               = timeseries_insert(ts, &entry);
+    return retSt;
+}
+
+/*****************************************************************************/
+int timeseries_insert_double_coerce(timeseries_p ts, timelib64_t timestamp, double value1, double value2)
+{
+    int retSt;
+    timeseries_entry_t entry;
+
+    if (!ts || (!ts->keyedVector && !ts->ring))
+        return TS_ST_BADPARAM;
+
+    switch (ts->tsType)
+    {
+        case TS_TYPE_DOUBLE:
+            break; /* Fall through */
+
+        case TS_TYPE_INT64: {
+            long long i64Value1 = nvcmvalue_double_to_int64(value1);
+            long long i64Value2 = nvcmvalue_double_to_int64(value2);
+            return timeseries_insert_int64(ts, timestamp, i64Value1, i64Value2);
+        }
+
+        default:
+            return TS_ST_WRONGTYPE; /* No coercion available */
+    }
+
+    entry.usecSince1970 = timestamp;
+    entry.val.dbl       = value1;
+    entry.val2.dbl      = value2;
+    retSt               = timeseries_insert(ts, &entry);
+    return retSt;
+}
+
+/*****************************************************************************/
+/* Append count samples to the ring. They must be in time order and newer than
+ * the newest sample of the ring. Each column is copied in at most two runs */
+static int timeseries_ring_append(timeseries_ring_p ring,
+                                  timelib64_t const *timestamps,
+                                  timeseries_value_t const *values,
+                                  timeseries_value_t const *values2,
+                                  int count)
+{
+    int capacity = ring->capacity;
+    int i, tail, runLength;
+    int st;
+
+    while (capacity < ring->count + count)
+    {
+        if (capacity >= TS_RING_MAX_CAPACITY)
+            return TS_ST_MEMORY;
+        capacity *= 2;
+    }
+    if (capacity != ring->capacity)
+    {
+        st = timeseries_ring_resize(ring, capacity);
+        if (st)
+        {
+            PRINT_ERROR("%d %d", "Error %d growing timeseries ring to capacity %d\n", st, capacity);
+            return st;
+        }
+    }
+
+    for (i = 0; values2 && !ring->val2 && i < count; i++)
+    {
+        if (values2[i].i64 != 0)
+        {
+            if (timeseries_ring_alloc_val2(ring))
+                return TS_ST_MEMORY;
+        }
+    }
+
+    tail      = timeseries_ring_slot(ring, ring->count);
+    runLength = ring->capacity - tail;
+    if (runLength > count)
+        runLength = count;
+
+    memcpy(&ring->usecSince1970[tail], timestamps, runLength * sizeof(timelib64_t));
+    memcpy(ring->usecSince1970, &timestamps[runLength], (count - runLength) * sizeof(timelib64_t));
+    memcpy(&ring->val[tail], values, runLength * sizeof(timeseries_value_t));
+    memcpy(ring->val, &values[runLength], (count - runLength) * sizeof(timeseries_value_t));
+    if (ring->val2 && values2)
+    {
+        memcpy(&ring->val2[tail], values2, runLength * sizeof(timeseries_value_t));
+        memcpy(ring->val2, &values2[runLength], (count - runLength) * sizeof(timeseries_value_t));
+    }
+    else if (ring->val2)
+    {
+        memset(&ring->val2[tail], 0, runLength * sizeof(timeseries_value_t));
+        memset(ring->val2, 0, (count - runLength) * sizeof(timeseries_value_t));
+    }
+
+    ring->count += count;
+    return TS_ST_OK;
 }
 
 /*****************************************************************************/
-int timeseries_insert_double_coerce(timeseries_p ts, timelib64_t timestamp, double value1, double value2)
+int timeseries_insert_many(timeseries_p ts,
+                           timelib64_t const *timestamps,
+                           timeseries_value_t const *values,
+                           timeseries_value_t const *values2,
+                           int count)
 {
-    int retSt;
+    timeseries_entry_t chunk[TS_INSERT_MANY_CHUNK];
     timeseries_entry_t entry;
+    timeseries_ring_p ring;
+    timelib64_t newest;
+    int i, runLength, appended;
+    int st;
 
-    if (!ts || !ts->keyedVector)
+    if (!ts || count < 0 || (count && (!timestamps || !values)))
         return TS_ST_BADPARAM;
+    if (ts->tsType != TS_TYPE_INT64 && ts->tsType != TS_TYPE_DOUBLE)
+        return TS_ST_WRONGTYPE;
 
-    switch (ts->tsType)
+    for (i = 0; i < count;)
     {
-        case TS_TYPE_DOUBLE:
-            break; /* Fall through */
-
-        case TS_TYPE_INT64: {
-            long long i64Value1 = nvcmvalue_double_to_int64(value1);
-            long long i64Value2 = nvcmvalue_double_to_int64(value2);
-            return timeseries_insert_int64(ts, timestamp, i64Value1, i64Value2);
+        /* Bulk copy the run of samples that goes past the end. A timestamp of 0
+           stops it since that means now, which may not be past the end */
+        if (ts->ring && !ts->compressed)
+        {
+            ring   = ts->ring;
+            newest = ring->count ? ring->usecSince1970[timeseries_ring_slot(ring, ring->count - 1)] : 0;
+            for (runLength = 0; i + runLength < count; runLength++)
+            {
+                if (!timestamps[i + runLength] || timestamps[i + runLength] <= newest)
+                    break;
+                newest = timestamps[i + runLength];
+            }
+
+            if (runLength)
+            {
+                st = timeseries_ring_append(
+                    ring, &timestamps[i], &values[i], values2 ? &values2[i] : NULL, runLength);
+                if (st)
+                    return st;
+                i += runLength;
+                continue;
+            }
+        }
+        else if (ts->keyedVector)
+        {
+            for (runLength = 0; runLength < TS_INSERT_MANY_CHUNK && i + runLength < count; runLength++)
+            {
+                if (!timestamps[i + runLength])
+                    break;
+                chunk[runLength].usecSince1970 = timestamps[i + runLength];
+                chunk[runLength].val.i64       = values[i + runLength].i64;
+                chunk[runLength].val2.i64      = values2 ? values2[i + runLength].i64 : 0;
+            }
+
+            appended = keyedvector_append(ts->keyedVector, chunk, runLength);
+            if (appended < 0)
+            {
+                PRINT_ERROR("%d", "Error %d from keyedvector_append\n", appended);
+                return TS_ST_UNKNOWN;
+            }
+            i += appended;
+            if (appended)
+                continue;
         }
 
-        default:
-            return TS_ST_WRONGTYPE; /* No coercion available */
+        /* Out of order, duplicate or 0 timestamp, or compressed storage */
+        entry.usecSince1970 = timestamps[i];
+        entry.val.i64       = values[i].i64;
+        entry.val2.i64      = values2 ? values2[i].i64 : 0;
+        st                  = timeseries_insert(ts, &entry);
+        if (st)
+            return st;
+        i++;
     }
 
-    entry.usecSince1970 = timestamp;
-    entry.val.dbl       = value1;
-    entry.val2.dbl      = value2;
-    retSt               = timeseries_insert(ts, &entry);
-    return retSt;
+    return TS_ST_OK;
 }
 
 /*****************************************************************************/
-int timeseries_enforce_quota(timeseries_p ts, timelib64_t oldestKeepTimestamp, int maxKeepEntries)
+static int timeseries_remove_oldest(timeseries_p ts, timelib64_t oldestKeepTimestamp, int maxKeepEntries)
 {
     timeseries_entry_t key, *elem;
     kv_cursor_t firstElemCursor;
@@ -297,6 +1315,34 @@ int timeseries_enforce_quota(timeseries_p ts, timelib64_t oldestKeepTimestamp, i
     int st;
     int currentCount, NtoDelete;
 
+    if (ts && ts->compressed)
+    {
+        /* Most of the time only whole blocks need to go. Skip decoding if so */
+        timeseries_blocks_p c = ts->compressed;
+        int numWholeBlocks    = 0;
+        while (oldestKeepTimestamp && numWholeBlocks < c->numBlocks
+               && c->blocks[numWholeBlocks].lastUsec < oldestKeepTimestamp)
+            numWholeBlocks++;
+        if (numWholeBlocks)
+            timeseries_blocks_remove_front(c, numWholeBlocks);
+
+        if (oldestKeepTimestamp)
+            timeseries_blocks_drop_oldest(ts, timeseries_ring_total_lower_bound(ts, oldestKeepTimestamp));
+        if (maxKeepEntries > 0 && timeseries_ring_total(ts) > maxKeepEntries)
+            timeseries_blocks_drop_oldest(ts, timeseries_ring_total(ts) - maxKeepEntries);
+        return TS_ST_OK;
+    }
+
+    if (ts && ts->ring)
+    {
+        /* Samples are sorted, so everything to drop is at the head of the ring */
+        if (oldestKeepTimestamp)
+            timeseries_ring_drop_oldest(ts->ring, timeseries_ring_lower_bound(ts->ring, oldestKeepTimestamp));
+        if (maxKeepEntries > 0 && ts->ring->count > maxKeepEntries)
+            timeseries_ring_drop_oldest(ts->ring, ts->ring->count - maxKeepEntries);
+        return TS_ST_OK;
+    }
+
     if (!ts || !ts->keyedVector)
         return TS_ST_BADPARAM;
 
@@ -332,23 +1378,27 @@ int timeseries_enforce_quota(timeseries_p ts, timelib64_t oldestKeepTimestamp, i
 
     NtoDelete = currentCount - maxKeepEntries;
 
-    /* Refind the first element in case elements were deleted above */
-    elem = (timeseries_entry_t *)keyedvector_first(ts->keyedVector, &firstElemCursor);
-    if (!elem)
-        return TS_ST_OK; /* Nothing to do */
-
-    elem = (timeseries_entry_t *)keyedvector_find_by_index(ts->keyedVector, NtoDelete - 1, &lastDeleteCursor);
-    if (!elem)
-        return TS_ST_OK; /* Nothing to do */
-
-    /* Delete the elements from the first to elem[NtoDelete] */
-    st = keyedvector_remove_range_by_cursor(ts->keyedVector, &firstElemCursor, &lastDeleteCursor);
+    /* Delete the oldest NtoDelete elements. Whole blocks of them are freed at once */
+    st = keyedvector_remove_first(ts->keyedVector, NtoDelete);
     if (st)
         return st;
 
     return TS_ST_OK;
 }
 
+/*****************************************************************************/
+int timeseries_enforce_quota(timeseries_p ts, timelib64_t oldestKeepTimestamp, int maxKeepEntries)
+{
+    int sizeBefore = timeseries_size(ts);
+    int st         = timeseries_remove_oldest(ts, oldestKeepTimestamp, maxKeepEntries);
+
+    /* Entries are only ever removed from the front, so this keeps serials of
+       timeseries_position_t pointing at the same entries */
+    if (ts)
+        ts->numRemoved += sizeBefore - timeseries_size(ts);
+    return st;
+}
+
 /*****************************************************************************/
 /* Simple one-return calculations from startTime to endTime */
 #define TS_CALC_SUM 0
@@ -361,13 +1411,12 @@ timeseries_simple_calc_int64(timeseries_p ts, int tsCalc, timelib64_t startTime,
 {
     long long retVal = TS_EMPTY_INT64;
     int Nsamples     = 0;
-    kv_cursor_t cursor;
-    timeseries_entry_t searchEntry;
+    timeseries_cursor_t cursor;
     timeseries_entry_p elem;
 
     if (!errorSt)
         return TS_EMPTY_INT64;
-    if (!ts || !ts->keyedVector)
+    if (!ts || (!ts->keyedVector && !ts->ring))
     {
         *errorSt = TS_ST_BADPARAM;
         return TS_EMPTY_INT64;
@@ -381,12 +1430,11 @@ timeseries_simple_calc_int64(timeseries_p ts, int tsCalc, timelib64_t startTime,
     /* Get the starting iteration point */
     if (startTime)
     {
-        searchEntry.usecSince1970 = startTime;
-        elem = (timeseries_entry_p)keyedvector_find_by_key(ts->keyedVector, &searchEntry, KV_LGE_GREATEQUAL, &cursor);
+        elem = timeseries_find(ts, startTime, TS_LGE_GREATEQUAL, &cursor);
     }
     else
     {
-        elem = (timeseries_entry_p)keyedvector_first(ts->keyedVector, &cursor);
+        elem = timeseries_first(ts, &cursor);
     }
 
     if (!elem)
@@ -395,7 +1443,7 @@ timeseries_simple_calc_int64(timeseries_p ts, int tsCalc, timelib64_t startTime,
         return retVal; /* No records >= start time. Easy enough */
     }
 
-    for (; elem; elem = (timeseries_entry_p)keyedvector_next(ts->keyedVector, &cursor))
+    for (; elem; elem = timeseries_next(ts, &cursor))
     {
         /* Past end of our time searching range? */
         if (endTime && elem->usecSince1970 > endTime)
@@ -436,13 +1484,12 @@ timeseries_simple_calc_double(timeseries_p ts, int tsCalc, timelib64_t startTime
 {
     double retVal = TS_EMPTY_DOUBLE;
     int Nsamples  = 0;
-    kv_cursor_t cursor;
-    timeseries_entry_t searchEntry;
+    timeseries_cursor_t cursor;
     timeseries_entry_p elem;
 
     if (!errorSt)
         return TS_EMPTY_DOUBLE;
-    if (!ts || !ts->keyedVector)
+    if (!ts || (!ts->keyedVector && !ts->ring))
     {
         *errorSt = TS_ST_BADPARAM;
         return TS_EMPTY_DOUBLE;
@@ -456,12 +1503,11 @@ timeseries_simple_calc_double(timeseries_p ts, int tsCalc, timelib64_t startTime
     /* Get the starting iteration point */
     if (startTime)
     {
-        searchEntry.usecSince1970 = startTime;
-        elem = (timeseries_entry_p)keyedvector_find_by_key(ts->keyedVector, &searchEntry, KV_LGE_GREATEQUAL, &cursor);
+        elem = timeseries_find(ts, startTime, TS_LGE_GREATEQUAL, &cursor);
     }
     else
     {
-        elem = (timeseries_entry_p)keyedvector_first(ts->keyedVector, &cursor);
+        elem = timeseries_first(ts, &cursor);
     }
 
     if (!elem)
@@ -470,7 +1516,7 @@ timeseries_simple_calc_double(timeseries_p ts, int tsCalc, timelib64_t startTime
         return retVal; /* No records >= start time. Easy enough */
     }
 
-    for (; elem; elem = (timeseries_entry_p)keyedvector_next(ts->keyedVector, &cursor))
+    for (; elem; elem = timeseries_next(ts, &cursor))
     {
         /* Past end of our time searching range? */
         if (endTime && elem->usecSince1970 > endTime)
@@ -522,13 +1568,12 @@ double timeseries_average(timeseries_p ts, timelib64_t startTime, timelib64_t en
 {
     double retVal = 0;
     int Nsamples  = 0;
-    kv_cursor_t cursor;
-    timeseries_entry_t searchEntry;
+    timeseries_cursor_t cursor;
     timeseries_entry_p elem;
 
     if (!errorSt)
         return TS_EMPTY_DOUBLE;
-    if (!ts || !ts->keyedVector)
+    if (!ts || (!ts->keyedVector && !ts->ring))
     {
         *errorSt = TS_ST_BADPARAM;
         return TS_EMPTY_DOUBLE;
@@ -542,12 +1587,11 @@ double timeseries_average(timeseries_p ts, timelib64_t startTime, timelib64_t en
     /* Get the starting iteration point */
     if (startTime)
     {
-        searchEntry.usecSince1970 = startTime;
-        elem = (timeseries_entry_p)keyedvector_find_by_key(ts->keyedVector, &searchEntry, KV_LGE_GREATEQUAL, &cursor);
+        elem = timeseries_find(ts, startTime, TS_LGE_GREATEQUAL, &cursor);
     }
     else
     {
-        elem = (timeseries_entry_p)keyedvector_first(ts->keyedVector, &cursor);
+        elem = timeseries_first(ts, &cursor);
     }
 
     if (!elem)
@@ -555,7 +1599,7 @@ double timeseries_average(timeseries_p ts, timelib64_t startTime, timelib64_t en
         *errorSt = TS_ST_NODATA;
         return TS_EMPTY_DOUBLE; /* Undefined if no samples. Beats dividing by 0 */
     }
-    for (; elem; elem = (timeseries_entry_p)keyedvector_next(ts->keyedVector, &cursor))
+    for (; elem; elem = timeseries_next(ts, &cursor))
     {
         /* Past end of our time searching range? */
         if (endTime && elem->usecSince1970 > endTime)
@@ -594,13 +1638,12 @@ double timeseries_moving_average(timeseries_p ts, timelib64_t endTime, int maxSa
 {
     double retVal = 0;
     int Nsamples  = 0;
-    kv_cursor_t cursor;
-    timeseries_entry_t searchEntry;
+    timeseries_cursor_t cursor;
     timeseries_entry_p elem;
 
     if (!errorSt)
         return TS_EMPTY_DOUBLE;
-    if (!ts || !ts->keyedVector || maxSamples < 0)
+    if (!ts || (!ts->keyedVector && !ts->ring) || maxSamples < 0)
     {
         *errorSt = TS_ST_BADPARAM;
         return TS_EMPTY_DOUBLE;
@@ -614,12 +1657,11 @@ double timeseries_moving_average(timeseries_p ts, timelib64_t endTime, int maxSa
     /* Get the starting iteration point */
     if (endTime)
     {
-        searchEntry.usecSince1970 = endTime;
-        elem = (timeseries_entry_p)keyedvector_find_by_key(ts->keyedVector, &searchEntry, KV_LGE_LESSEQUAL, &cursor);
+        elem = timeseries_find(ts, endTime, TS_LGE_LESSEQUAL, &cursor);
     }
     else
     {
-        elem = (timeseries_entry_p)keyedvector_last(ts->keyedVector, &cursor);
+        elem = timeseries_last(ts, &cursor);
     }
 
     if (!elem)
@@ -628,7 +1670,7 @@ double timeseries_moving_average(timeseries_p ts, timelib64_t endTime, int maxSa
         return TS_EMPTY_DOUBLE; /* Undefined if no samples. Beats dividing by 0 */
     }
 
-    for (; elem; elem = (timeseries_entry_p)keyedvector_prev(ts->keyedVector, &cursor))
+    for (; elem; elem = timeseries_prev(ts, &cursor))
     {
         /* Collected enough samples yet? */
         if (Nsamples >= maxSamples)
@@ -696,28 +1738,26 @@ int timeseries_threshold_count(timeseries_p ts,
     double val          = 0;
     int Nsamples        = 0;
     int NmatchedSamples = 0;
-    kv_cursor_t cursor;
-    timeseries_entry_t searchEntry;
+    timeseries_cursor_t cursor;
     timeseries_entry_p elem;
 
-    if (!ts || !ts->keyedVector)
+    if (!ts || (!ts->keyedVector && !ts->ring))
         return TS_ST_BADPARAM;
 
     /* Get the starting iteration point */
     if (startTime)
     {
-        searchEntry.usecSince1970 = startTime;
-        elem = (timeseries_entry_p)keyedvector_find_by_key(ts->keyedVector, &searchEntry, KV_LGE_GREATEQUAL, &cursor);
+        elem = timeseries_find(ts, startTime, TS_LGE_GREATEQUAL, &cursor);
     }
     else
     {
-        elem = (timeseries_entry_p)keyedvector_first(ts->keyedVector, &cursor);
+        elem = timeseries_first(ts, &cursor);
     }
 
     if (!elem)
         return 0; /* No data */
 
-    for (; elem; elem = (timeseries_entry_p)keyedvector_next(ts->keyedVector, &cursor))
+    for (; elem; elem = timeseries_next(ts, &cursor))
     {
         /* Past end of our time searching range? */
         if (endTime && elem->usecSince1970 > endTime)
@@ -769,24 +1809,448 @@ int timeseries_threshold_count(timeseries_p ts,
     return NmatchedSamples;
 }
 
+/*****************************************************************************/
+/* Add a sample to the buckets of timeseries_bucketize(), starting a new bucket
+ * if it falls after the current one. Returns 1 if buckets[] is full and the
+ * walk should stop, 0 otherwise */
+static int timeseries_bucket_sample(timeseries_p ts,
+                                    timelib64_t usec,
+                                    timeseries_value_t value,
+                                    timelib64_t bucketWidth,
+                                    timeseries_bucket_p buckets,
+                                    int maxBuckets,
+                                    int *numBuckets)
+{
+    timeseries_bucket_p bucket;
+    timelib64_t startUsec;
+    double dblValue;
+
+    /* Ignore blank values */
+    if (ts->tsType == TS_TYPE_DOUBLE)
+    {
+        if (DCGM_FP64_IS_BLANK(value.dbl))
+            return 0;
+        dblValue = value.dbl;
+    }
+    else
+    {
+        if (DCGM_INT64_IS_BLANK(value.i64))
+            return 0;
+        dblValue = (double)value.i64;
+    }
+
+    startUsec = usec - (usec % bucketWidth);
+    if (usec < 0 && startUsec != usec)
+        startUsec -= bucketWidth;
+
+    bucket = *numBuckets ? &buckets[*numBuckets - 1] : NULL;
+    if (!bucket || bucket->startUsec != startUsec)
+    {
+        if (*numBuckets >= maxBuckets)
+            return 1;
+
+        bucket = &buckets[*numBuckets];
+        (*numBuckets)++;
+        memset(bucket, 0, sizeof(*bucket));
+        bucket->startUsec = startUsec;
+        bucket->min       = value;
+        bucket->max       = value;
+    }
+    else if (ts->tsType == TS_TYPE_DOUBLE)
+    {
+        if (value.dbl < bucket->min.dbl)
+            bucket->min = value;
+        if (value.dbl > bucket->max.dbl)
+            bucket->max = value;
+    }
+    else
+    {
+        if (value.i64 < bucket->min.i64)
+            bucket->min = value;
+        if (value.i64 > bucket->max.i64)
+            bucket->max = value;
+    }
+
+    bucket->count++;
+    bucket->sum += dblValue;
+    bucket->last     = value;
+    bucket->lastUsec = usec;
+    return 0;
+}
+
+/*****************************************************************************/
+int timeseries_bucketize(timeseries_p ts,
+                         timelib64_t startTime,
+                         timelib64_t endTime,
+                         timelib64_t bucketWidth,
+                         timeseries_bucket_p buckets,
+                         int maxBuckets)
+{
+    int numBuckets = 0;
+    timeseries_ring_p ring;
+    timeseries_cursor_t cursor;
+    timeseries_entry_p elem;
+    timeseries_value_t value;
+    int index, slot;
+
+    if (!ts || (!ts->keyedVector && !ts->ring) || bucketWidth <= 0 || !buckets || maxBuckets < 1)
+        return TS_ST_BADPARAM;
+    if (ts->tsType != TS_TYPE_INT64 && ts->tsType != TS_TYPE_DOUBLE)
+        return TS_ST_WRONGTYPE;
+
+    /* Everything is in the ring's columns. Walk them without materializing entries */
+    if (ts->ring && (!ts->compressed || !ts->compressed->numSamples))
+    {
+        ring = ts->ring;
+        for (index = startTime ? timeseries_ring_lower_bound(ring, startTime) : 0; index < ring->count; index++)
+        {
+            slot = timeseries_ring_slot(ring, index);
+            if (endTime && ring->usecSince1970[slot] > endTime)
+                break;
+
+            if (timeseries_bucket_sample(
+                    ts, ring->usecSince1970[slot], ring->val[slot], bucketWidth, buckets, maxBuckets, &numBuckets))
+                break;
+        }
+
+        return numBuckets;
+    }
+
+    if (startTime)
+        elem = timeseries_find(ts, startTime, TS_LGE_GREATEQUAL, &cursor);
+    else
+        elem = timeseries_first(ts, &cursor);
+
+    for (; elem; elem = timeseries_next(ts, &cursor))
+    {
+        if (endTime && elem->usecSince1970 > endTime)
+            break;
+
+        value.i64 = elem->val.i64;
+        if (timeseries_bucket_sample(ts, elem->usecSince1970, value, bucketWidth, buckets, maxBuckets, &numBuckets))
+            break;
+    }
+
+    return numBuckets;
+}
+
+/*****************************************************************************/
+/* Return the first position in [low, high) of usec[] with a timestamp >= time.
+ * Returns high if there is no such position */
+static int timeseries_usec_lower_bound(timelib64_t const *usec, int low, int high, timelib64_t time)
+{
+    int mid;
+
+    while (low < high)
+    {
+        mid = low + (high - low) / 2;
+        if (usec[mid] < time)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+/*****************************************************************************/
+int timeseries_for_each_span(timeseries_p ts,
+                             timelib64_t startTime,
+                             timelib64_t endTime,
+                             timeseries_span_f spanCB,
+                             void *userData)
+{
+    timeseries_blocks_p c;
+    timeseries_block_p block;
+    timeseries_ring_p ring;
+    timeseries_value_t const *values;
+    int blockIndex, base = 0, first, last, slot, runLength, st;
+
+    if (!ts || !spanCB)
+        return TS_ST_BADPARAM;
+    if (!ts->ring || (ts->tsType != TS_TYPE_INT64 && ts->tsType != TS_TYPE_DOUBLE))
+        return TS_ST_WRONGTYPE;
+
+    c = ts->compressed;
+    for (blockIndex = 0; c && blockIndex < c->numBlocks; blockIndex++)
+    {
+        block = &c->blocks[blockIndex];
+        if (endTime && block->firstUsec > endTime)
+            return TS_ST_OK;
+        if (block->lastUsec < startTime)
+        {
+            base += block->count - block->skip;
+            continue;
+        }
+
+        st = timeseries_blocks_decode(ts, blockIndex);
+        if (st)
+            return st;
+        c->decodedBase = base;
+        base += block->count - block->skip;
+
+        first = timeseries_usec_lower_bound(c->decodedUsec, block->skip, block->count, startTime);
+        last  = block->count;
+        if (endTime)
+            last = timeseries_usec_lower_bound(c->decodedUsec, first, block->count, endTime + 1);
+
+        /* Decoded values are the raw bits of the column, so they read the same as ring->val */
+        if (last > first)
+        {
+            values = (timeseries_value_t const *)&c->decodedVal[first];
+            if (spanCB(&c->decodedUsec[first], values, last - first, userData))
+                return TS_ST_OK;
+        }
+    }
+
+    ring  = ts->ring;
+    first = startTime ? timeseries_ring_lower_bound(ring, startTime) : 0;
+    last  = endTime ? timeseries_ring_lower_bound(ring, endTime + 1) : ring->count;
+
+    /* At most two runs: up to the end of the columns, then from their start after wrapping */
+    while (first < last)
+    {
+        slot      = timeseries_ring_slot(ring, first);
+        runLength = ring->capacity - slot;
+        if (runLength > last - first)
+            runLength = last - first;
+
+        if (spanCB(&ring->usecSince1970[slot], &ring->val[slot], runLength, userData))
+            break;
+        first += runLength;
+    }
+
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+int timeseries_ring_spans(timeseries_p ts,
+                          timelib64_t startTime,
+                          int maxCount,
+                          timeseries_span_t spans[2],
+                          int *olderInHistory)
+{
+    timeseries_blocks_p c;
+    timeseries_ring_p ring;
+    int first, last, slot, runLength, numSpans = 0;
+
+    if (!ts || !spans)
+        return TS_ST_BADPARAM;
+    if (!ts->ring || (ts->tsType != TS_TYPE_INT64 && ts->tsType != TS_TYPE_DOUBLE))
+        return TS_ST_WRONGTYPE;
+
+    memset(spans, 0, 2 * sizeof(spans[0]));
+
+    ring  = ts->ring;
+    first = startTime ? timeseries_ring_lower_bound(ring, startTime) : 0;
+    last  = ring->count;
+    if (maxCount > 0 && last - first > maxCount)
+        first = last - maxCount;
+
+    if (olderInHistory)
+    {
+        c               = ts->compressed;
+        *olderInHistory = c && c->numSamples > 0 && c->blocks[c->numBlocks - 1].lastUsec >= startTime
+                          && (maxCount <= 0 || last - first < maxCount);
+    }
+
+    /* At most two runs: up to the end of the columns, then from their start after wrapping */
+    while (first < last)
+    {
+        slot      = timeseries_ring_slot(ring, first);
+        runLength = ring->capacity - slot;
+        if (runLength > last - first)
+            runLength = last - first;
+
+        spans[numSpans].usecSince1970 = &ring->usecSince1970[slot];
+        spans[numSpans].values        = &ring->val[slot];
+        spans[numSpans].count         = runLength;
+        numSpans++;
+        first += runLength;
+    }
+
+    return numSpans;
+}
+
+/*****************************************************************************/
+int timeseries_copy_range(timeseries_p ts,
+                          timelib64_t startTime,
+                          timelib64_t endTime,
+                          timeseries_entry_p entries,
+                          int maxEntries)
+{
+    timeseries_entry_t key;
+    kv_cursor_t startCursor, endCursor;
+    timeseries_ring_p ring;
+    int index, total, numCopied;
+    int slot, last, runLength, i;
+
+    if (!ts || maxEntries < 0 || (maxEntries && !entries))
+        return TS_ST_BADPARAM;
+
+    if (ts->ring && !ts->compressed)
+    {
+        ring  = ts->ring;
+        index = startTime ? timeseries_ring_lower_bound(ring, startTime) : 0;
+        last  = endTime ? timeseries_ring_lower_bound(ring, endTime + 1) : ring->count;
+        if (last - index > maxEntries)
+            last = index + maxEntries;
+
+        /* At most two runs of the columns, like timeseries_for_each_span() */
+        for (numCopied = 0; index < last; index += runLength)
+        {
+            slot      = timeseries_ring_slot(ring, index);
+            runLength = ring->capacity - slot;
+            if (runLength > last - index)
+                runLength = last - index;
+
+            for (i = 0; i < runLength; i++, numCopied++)
+            {
+                entries[numCopied].usecSince1970 = ring->usecSince1970[slot + i];
+                entries[numCopied].val.i64       = ring->val[slot + i].i64;
+                entries[numCopied].val2.i64      = ring->val2 ? ring->val2[slot + i].i64 : 0;
+            }
+        }
+        return numCopied;
+    }
+
+    if (ts->ring)
+    {
+        total     = timeseries_ring_total(ts);
+        index     = startTime ? timeseries_ring_total_lower_bound(ts, startTime) : 0;
+        numCopied = 0;
+        while (numCopied < maxEntries && index < total)
+        {
+            /* Like timeseries_next(), a compressed block that fails to decode ends the range */
+            if (!timeseries_ring_entry(ts, index, &entries[numCopied]))
+                break;
+            if (endTime && entries[numCopied].usecSince1970 > endTime)
+                break;
+            numCopied++;
+            index++;
+        }
+        return numCopied;
+    }
+
+    if (!ts->keyedVector)
+        return TS_ST_BADPARAM;
+
+    memset(&key, 0, sizeof(key));
+
+    key.usecSince1970 = startTime;
+    if (startTime && !keyedvector_find_by_key(ts->keyedVector, &key, KV_LGE_GREATEQUAL, &startCursor))
+        return 0; /* Everything is before startTime */
+    else if (!startTime && !keyedvector_first(ts->keyedVector, &startCursor))
+        return 0; /* Empty */
+
+    key.usecSince1970 = endTime;
+    if (endTime && !keyedvector_find_by_key(ts->keyedVector, &key, KV_LGE_LESSEQUAL, &endCursor))
+        return 0; /* Everything is after endTime */
+    else if (!endTime && !keyedvector_last(ts->keyedVector, &endCursor))
+        return 0; /* Empty */
+
+    numCopied = keyedvector_copy_range(ts->keyedVector, &startCursor, &endCursor, entries, maxEntries);
+    if (numCopied < 0)
+    {
+        PRINT_ERROR("%d", "Error %d from keyedvector_copy_range\n", numCopied);
+        return TS_ST_UNKNOWN;
+    }
+
+    return numCopied;
+}
+
+/*****************************************************************************/
+int timeseries_shrink(timeseries_p ts, int minCapacity)
+{
+    int capacity = 1;
+
+    if (!ts)
+        return TS_ST_BADPARAM;
+    if (!ts->ring)
+        return TS_ST_OK; /* keyedvector storage frees its blocks as they empty */
+
+    while (capacity < ts->ring->count || capacity < minCapacity)
+        capacity <<= 1;
+
+    if (capacity >= ts->ring->capacity)
+        return TS_ST_OK;
+
+    return timeseries_ring_resize(ts->ring, capacity);
+}
+
 /*****************************************************************************/
 long long timeseries_bytes_used(timeseries_p ts)
 {
     if (!ts)
         return 0;
 
-    long long bytesUsed = sizeof(*ts) + keyedvector_bytes_used(ts->keyedVector);
+    long long bytesUsed = sizeof(*ts);
+
+    if (ts->ring)
+    {
+        bytesUsed += sizeof(*ts->ring);
+        bytesUsed += (long long)ts->ring->capacity * (sizeof(timelib64_t) + sizeof(timeseries_value_t));
+        if (ts->ring->val2)
+            bytesUsed += (long long)ts->ring->capacity * sizeof(timeseries_value_t);
+    }
+    else if (ts->compressed)
+    {
+        bytesUsed += sizeof(*ts->compressed);
+        bytesUsed += (long long)ts->compressed->capacity * sizeof(timeseries_block_t);
+        bytesUsed += ts->compressed->numBytes;
+        if (ts->compressed->decodedUsec)
+            bytesUsed += TS_BLOCK_SAMPLES * (sizeof(timelib64_t) + 2 * sizeof(long long));
+    }
+    else
+    {
+        bytesUsed += keyedvector_bytes_used(ts->keyedVector);
+    }
+
+    if (ts->arena)
+        bytesUsed += sizeof(*ts->arena) + ts->arena->slabBytes;
 
     return bytesUsed;
 }
 
+/*****************************************************************************/
+/* Position cursor at logical index of a TS_STORAGE_RING timeseries and return the
+ * materialized entry. Returns NULL and invalidates the cursor if index is out of range */
+static timeseries_entry_p timeseries_ring_seek(timeseries_p ts, int index, timeseries_cursor_p cursor)
+{
+    if (index < 0 || index >= timeseries_ring_total(ts))
+    {
+        cursor->ringIndex = -1;
+        return NULL;
+    }
+
+    cursor->ringIndex = index;
+    return timeseries_ring_entry(ts, index, &cursor->entry);
+}
+
+/*****************************************************************************/
+/* Copy a cursor-owned entry to the timeseries' scratch entry for callers that
+ * didn't pass a cursor of their own */
+static timeseries_entry_p timeseries_ring_scratch(timeseries_p ts, timeseries_entry_p entry)
+{
+    if (!entry)
+        return NULL;
+    ts->scratchEntry = *entry;
+    return &ts->scratchEntry;
+}
+
 /*****************************************************************************/
 timeseries_entry_p timeseries_first(timeseries_p ts, timeseries_cursor_p cursor)
 {
     timeseries_cursor_t tempCursor;
     if (NULL == cursor)
+    {
+        if (ts->ring)
+            return timeseries_ring_scratch(ts, timeseries_ring_seek(ts, 0, &tempCursor));
         cursor = &tempCursor;
-    return (timeseries_entry_p)keyedvector_first(ts->keyedVector, cursor);
+    }
+    if (ts->ring)
+        return timeseries_ring_seek(ts, 0, cursor);
+    return (timeseries_entry_p)keyedvector_first(ts->keyedVector, &cursor->kvCursor);
 }
 
 /*****************************************************************************/
@@ -794,20 +2258,92 @@ timeseries_entry_p timeseries_last(timeseries_p ts, timeseries_cursor_p cursor)
 {
     timeseries_cursor_t tempCursor;
     if (NULL == cursor)
+    {
+        if (ts->ring)
+            return timeseries_ring_scratch(ts, timeseries_ring_seek(ts, timeseries_ring_total(ts) - 1, &tempCursor));
         cursor = &tempCursor;
-    return (timeseries_entry_p)keyedvector_last(ts->keyedVector, cursor);
+    }
+    if (ts->ring)
+        return timeseries_ring_seek(ts, timeseries_ring_total(ts) - 1, cursor);
+    return (timeseries_entry_p)keyedvector_last(ts->keyedVector, &cursor->kvCursor);
 }
 
 /*****************************************************************************/
 timeseries_entry_p timeseries_next(timeseries_p ts, timeseries_cursor_p cursor)
 {
-    return (timeseries_entry_p)keyedvector_next(ts->keyedVector, cursor);
+    if (ts->ring)
+    {
+        if (cursor->ringIndex < 0)
+            return NULL;
+        return timeseries_ring_seek(ts, cursor->ringIndex + 1, cursor);
+    }
+    return (timeseries_entry_p)keyedvector_next(ts->keyedVector, &cursor->kvCursor);
 }
 
 /*****************************************************************************/
 timeseries_entry_p timeseries_prev(timeseries_p ts, timeseries_cursor_p cursor)
 {
-    return (timeseries_entry_p)keyedvector_prev(ts->keyedVector, cursor);
+    if (ts->ring)
+    {
+        if (cursor->ringIndex < 0)
+            return NULL;
+        return timeseries_ring_seek(ts, cursor->ringIndex - 1, cursor);
+    }
+    return (timeseries_entry_p)keyedvector_prev(ts->keyedVector, &cursor->kvCursor);
+}
+
+/*****************************************************************************/
+timeseries_entry_p timeseries_resume(timeseries_p ts,
+                                     timeseries_position_p position,
+                                     timeseries_cursor_p cursor,
+                                     long long *entriesSkipped)
+{
+    timeseries_entry_p entry;
+    timeseries_entry_t before;
+    long long index;
+
+    if (entriesSkipped)
+        *entriesSkipped = 0;
+
+    if (!position->usecSince1970)
+        return timeseries_first(ts, cursor);
+
+    if (ts->ring && position->serial >= 0)
+    {
+        /* Fast path. The next entry is still where it was unless entries were
+           inserted out of order or the timeseries was replaced */
+        index = position->serial - ts->numRemoved;
+        if (index <= 0)
+        {
+            entry = timeseries_first(ts, cursor);
+            if (entry && entry->usecSince1970 > position->usecSince1970)
+            {
+                if (entriesSkipped)
+                    *entriesSkipped = -index;
+                return entry;
+            }
+        }
+        else if (index <= timeseries_ring_total(ts) && timeseries_ring_entry(ts, (int)index - 1, &before)
+                 && before.usecSince1970 == position->usecSince1970)
+        {
+            return timeseries_ring_seek(ts, (int)index, cursor);
+        }
+    }
+
+    return timeseries_find(ts, position->usecSince1970, TS_LGE_GREATER, cursor);
+}
+
+/*****************************************************************************/
+void timeseries_position_after(timeseries_p ts,
+                               timeseries_entry_p entry,
+                               timeseries_cursor_p cursor,
+                               timeseries_position_p position)
+{
+    position->usecSince1970 = entry->usecSince1970;
+    if (ts->ring && cursor->ringIndex >= 0)
+        position->serial = ts->numRemoved + cursor->ringIndex + 1;
+    else
+        position->serial = -1;
 }
 
 /*****************************************************************************/
@@ -815,6 +2351,13 @@ timeseries_entry_p timeseries_find(timeseries_p ts, timelib64_t time, int findOp
 {
     timeseries_cursor_t tempCursor;
     if (NULL == cursor)
+    {
+        if (ts->ring)
+            return timeseries_ring_scratch(
+                ts, timeseries_ring_seek(ts, timeseries_ring_find_index(ts, time, findOp), &tempCursor));
         cursor = &tempCursor;
-    return (timeseries_entry_p)keyedvector_find_by_key(ts->keyedVector, &time, findOp, cursor);
+    }
+    if (ts->ring)
+        return timeseries_ring_seek(ts, timeseries_ring_find_index(ts, time, findOp), cursor);
+    return (timeseries_entry_p)keyedvector_find_by_key(ts->keyedVector, &time, findOp, &cursor->kvCursor);
 }
@@ -8,8 +8,10 @@
 
 #include "keyedvector.h"
 #include "timelib.h"
+#include "tscompress.h"
 #include <float.h>  //DBL_MAX
 #include <limits.h> //LLONG_MAX
+#include <stddef.h> //size_t
 
 #ifdef __cplusplus
 extern "C"
@@ -57,20 +59,21 @@ extern "C"
 #define TS_LGE_LESS KV_LGE_LESS             /* return nearest < time */
 #define TS_LGE_GREATER KV_LGE_GREATER       /* return nearest > time */
 
-    /*****************************************************************************/
-    /* Handle to a timeseries structure */
-    typedef struct timeseries_t
-    {
-        int tsType;                /* TS_TYPE_? #define of the type of value stored
-                                  in keyedVector */
-        keyedvector_p keyedVector; /* Data structure to hold the time series */
-    } timeseries_t, *timeseries_p;
+/*****************************************************************************/
+/* Storage backends for a timeseries */
+#define TS_STORAGE_KEYEDVECTOR 0 /* Sorted keyedvector of timeseries_entry_t. Supports all types */
+#define TS_STORAGE_RING \
+    1 /* Columnar ring buffer of timestamps and values. Only supports
+                                    TS_TYPE_INT64 and TS_TYPE_DOUBLE */
 
-    /* Cursor into a timeseries enumeration. Note that these cursors are only
- * valid as long as the timeseries is not modified (inserting or removing elements).
- */
-    typedef kv_cursor_t timeseries_cursor_t;
-    typedef kv_cursor_p timeseries_cursor_p;
+#define TS_RING_MAX_CAPACITY (1 << 30) /* Maximum number of samples a ring can grow to */
+
+/*****************************************************************************/
+/* Slab sizes of the arena that holds TS_TYPE_STRING and TS_TYPE_BLOB values */
+#define TS_SLAB_MIN_SIZE 1024  /* Smallest slab. New slabs are twice the live bytes up to TS_SLAB_MAX_SIZE */
+#define TS_SLAB_MAX_SIZE 65536 /* Largest shared slab. Values over 1/4 of this get a slab of their own */
+#define TS_SLAB_ALIGN 8        /* Alignment of values. Each value is preceded by this many bytes
+                                  that point back at its slab */
 
     /* Entry stored in keyed vector */
     typedef struct timeseries_entry_t
@@ -91,6 +94,131 @@ extern "C"
         } val2;                /* To store any additional Information at time usecSince1970 */
     } timeseries_entry_t, *timeseries_entry_p;
 
+    /* Numeric value stored in a column of a TS_STORAGE_RING timeseries */
+    typedef union timeseries_value_t
+    {
+        double dbl;
+        long long i64;
+    } timeseries_value_t;
+
+    /* Allocator of the columns of a TS_STORAGE_RING timeseries, so that they can be
+ * carved from memory the caller manages. See timeseries_set_allocator() */
+    typedef struct timeseries_allocator_t
+    {
+        void *(*alloc)(void *userData, size_t size);             /* Returns NULL if out of memory */
+        void (*release)(void *userData, void *ptr, size_t size); /* size is what ptr was allocated with */
+        void *userData;                                          /* Passed to alloc and release */
+    } timeseries_allocator_t, *timeseries_allocator_p;
+
+    /* Columnar ring buffer backing a TS_STORAGE_RING timeseries. Samples are kept
+ * in ascending time order starting at physical slot head */
+    typedef struct timeseries_ring_t
+    {
+        int capacity;               /* Number of slots in each column. Always a power of 2 */
+        int head;                   /* Physical slot of the oldest sample */
+        int count;                  /* Number of samples currently stored */
+        timelib64_t *usecSince1970; /* Timestamp column */
+        timeseries_value_t *val;    /* Value column */
+        timeseries_value_t *val2;   /* Secondary value column. NULL until the first
+                                       non-zero val2 is inserted. Missing = 0 */
+        timeseries_allocator_p allocator; /* Where the columns are allocated from. NULL = malloc */
+    } timeseries_ring_t, *timeseries_ring_p;
+
+    /* Sealed history of a compressed TS_STORAGE_RING timeseries. Samples older than
+ * the ring are kept here as compressed blocks in ascending time order */
+    typedef struct timeseries_blocks_t
+    {
+        timeseries_block_p blocks; /* Array of blocks. Oldest first */
+        int numBlocks;             /* Number of blocks in use */
+        int capacity;              /* Number of blocks allocated */
+        int numSamples;            /* Live samples across all blocks (count - skip) */
+        long long numBytes;        /* Encoded bytes across all blocks */
+
+        /* Most recently decoded block. Sequential reads hit this cache. The arrays
+           are allocated on first read and hold TS_BLOCK_SAMPLES entries each */
+        int decodedBlock;         /* Index into blocks or -1 if none */
+        int decodedBase;          /* Logical index of the first live sample of decodedBlock */
+        timelib64_t *decodedUsec; /* Decoded timestamps */
+        long long *decodedVal;    /* Decoded values */
+        long long *decodedVal2;   /* Decoded secondary values */
+    } timeseries_blocks_t, *timeseries_blocks_p;
+
+    /* Slab of the arena of a TS_TYPE_STRING or TS_TYPE_BLOB timeseries. Values are
+ * carved from the front of its data, which follows this struct */
+    typedef struct timeseries_slab_t
+    {
+        struct timeseries_slab_t *prev; /* Next older slab. NULL if oldest */
+        struct timeseries_slab_t *next; /* Next newer slab. NULL if newest */
+        long long size;                 /* Bytes of data */
+        long long used;                 /* Bytes of data handed out */
+        long long numLive;              /* Values from this slab still in the timeseries */
+    } timeseries_slab_t, *timeseries_slab_p;
+
+    /* Storage of the values of a TS_TYPE_STRING or TS_TYPE_BLOB timeseries. Values
+ * are appended to the current slab, so slabs fill up in time order and whole
+ * slabs are freed as quota enforcement removes old values */
+    typedef struct timeseries_arena_t
+    {
+        timeseries_slab_p oldest;  /* List of all slabs, oldest first */
+        timeseries_slab_p newest;  /* Last slab in the list */
+        timeseries_slab_p current; /* Slab new values are carved from. NULL if none */
+        int numSlabs;              /* Number of slabs in the list */
+        long long slabBytes;       /* Bytes allocated for slabs, including their headers */
+        long long liveBytes;       /* Bytes of values still in the timeseries, including their headers */
+    } timeseries_arena_t, *timeseries_arena_p;
+
+    /*****************************************************************************/
+    /* Handle to a timeseries structure */
+    typedef struct timeseries_t
+    {
+        int tsType;                /* TS_TYPE_? #define of the type of value stored
+                                  in keyedVector */
+        int storage;               /* TS_STORAGE_? #define of how the values are stored */
+        keyedvector_p keyedVector; /* Data structure to hold the time series.
+                                      Only set for TS_STORAGE_KEYEDVECTOR */
+        timeseries_ring_p ring;    /* Ring buffer to hold the time series.
+                                      Only set for TS_STORAGE_RING */
+        timeseries_blocks_p compressed; /* Compressed history older than ring. Only set
+                                           for TS_STORAGE_RING with compression enabled */
+        timeseries_entry_t scratchEntry; /* Entry returned by TS_STORAGE_RING lookups
+                                            that were not passed a cursor */
+        timeseries_arena_p arena;        /* Storage of val.ptr of entries. Only set for
+                                            TS_TYPE_STRING and TS_TYPE_BLOB */
+        long long numRemoved;            /* Entries timeseries_enforce_quota() has removed so far.
+                                            See timeseries_position_t */
+    } timeseries_t, *timeseries_p;
+
+    /* Cursor into a timeseries enumeration. Note that these cursors are only
+ * valid as long as the timeseries is not modified (inserting or removing elements).
+ *
+ * For TS_STORAGE_RING timeseries, entries returned by the timeseries_first/last/
+ * next/prev/find functions are materialized into the cursor and are only valid
+ * until the cursor is moved again.
+ */
+    typedef struct timeseries_cursor_t
+    {
+        kv_cursor_t kvCursor;     /* Position within a TS_STORAGE_KEYEDVECTOR timeseries */
+        int ringIndex;            /* Logical index (0=oldest) within a TS_STORAGE_RING timeseries,
+                                     including its compressed history */
+        timeseries_entry_t entry; /* Materialized entry of a TS_STORAGE_RING timeseries */
+    } timeseries_cursor_t, *timeseries_cursor_p;
+
+    /* Position after an entry of a timeseries that, unlike a cursor, stays valid
+ * while the timeseries is modified. Used to read a timeseries in pages.
+ *
+ * Timestamps within a timeseries are unique, so the position is the timestamp
+ * of the last entry read. serial remembers where the next entry was, so that a
+ * TS_STORAGE_RING timeseries can resume in O(1) when only newer entries were
+ * added and older ones removed since, which is the usual case. Otherwise the
+ * timestamp is searched for.
+ */
+    typedef struct timeseries_position_t
+    {
+        timelib64_t usecSince1970; /* Timestamp of the last entry read. 0 = before the first entry */
+        long long serial;          /* numRemoved + logical index of the next entry when the
+                                      position was taken. -1 = unknown */
+    } timeseries_position_t, *timeseries_position_p;
+
     /*****************************************************************************/
     /*
  * Allocate a timeseries collection
@@ -101,6 +229,46 @@ extern "C"
  */
     timeseries_p timeseries_alloc(int tsType, int *errorSt);
 
+    /*****************************************************************************/
+    /*
+ * Allocate a timeseries collection backed by a columnar ring buffer
+ * (TS_STORAGE_RING). Appending in time order is O(1) and does not allocate
+ * memory until the ring is full, at which point its capacity is doubled.
+ *
+ * tsType           IN: TS_TYPE_INT64 or TS_TYPE_DOUBLE
+ * initialCapacity  IN: Number of samples to preallocate room for. This is
+ *                      rounded up to a power of 2
+ * errorSt         OUT: Where to store the error
+ *
+ */
+    timeseries_p timeseries_alloc_ring(int tsType, int initialCapacity, int *errorSt);
+
+    /*****************************************************************************/
+    /*
+ * Allocate a TS_STORAGE_RING timeseries that compresses its history. The newest
+ * samples stay uncompressed in the ring and older ones are sealed into
+ * TS_BLOCK_SAMPLES-sample compressed blocks (see tscompress.h) that are decoded
+ * on read. This trades CPU on reads for a much smaller footprint on long-lived
+ * watches of slowly changing values.
+ *
+ * tsType    IN: TS_TYPE_INT64 or TS_TYPE_DOUBLE
+ * errorSt  OUT: Where to store the error
+ *
+ */
+    timeseries_p timeseries_alloc_compressed(int tsType, int *errorSt);
+
+    /*****************************************************************************/
+    /*
+ * Move the columns of a TS_STORAGE_RING timeseries into memory from allocator,
+ * which they are allocated from as the ring grows and shrinks from then on.
+ * allocator must outlive the timeseries. NULL moves them back to malloc. Other
+ * storage, like compressed history, is left as is.
+ *
+ * Returns: 0 if OK
+ *         <0 TS_ST_? #define on error. The columns are left where they were
+ */
+    int timeseries_set_allocator(timeseries_p ts, timeseries_allocator_p allocator);
+
     /*****************************************************************************/
     /*
  * Destroy an allocated timeseries collection
@@ -173,6 +341,28 @@ extern "C"
  */
     int timeseries_insert_blob(timeseries_p ts, timelib64_t timestamp, void *value, int valueSize);
 
+    /*****************************************************************************/
+    /*
+ * Insert count samples into a TS_TYPE_INT64 or TS_TYPE_DOUBLE time series, which
+ * is what values and values2 hold. Samples in ascending time order past the last
+ * sample are copied in bulk. Others are inserted one at a time with the same
+ * timestamp rules as timeseries_insert_int64().
+ *
+ * timestamps  IN: Timestamp of each sample. 0 means use the current time
+ * values      IN: First value of each sample
+ * values2     IN: Second value of each sample. NULL = all 0
+ * count       IN: Number of samples
+ *
+ * Returns: 0 if OK
+ *         <0 TS_ST_? #define on error. Samples before the failing one were inserted
+ *
+ */
+    int timeseries_insert_many(timeseries_p ts,
+                               timelib64_t const *timestamps,
+                               timeseries_value_t const *values,
+                               timeseries_value_t const *values2,
+                               int count);
+
     /*****************************************************************************/
     /*
  * Enforce a quota on this time series on both number of records kept and
@@ -188,6 +378,18 @@ extern "C"
  */
     int timeseries_enforce_quota(timeseries_p ts, timelib64_t oldestKeepTimestamp, int maxKeepEntries);
 
+    /*****************************************************************************/
+    /*
+ * Release preallocated space that the samples of a TS_STORAGE_RING timeseries
+ * no longer need, for instance after timeseries_enforce_quota() dropped most of
+ * them. The ring keeps at least minCapacity slots and grows again as needed.
+ * Other storage is left as is.
+ *
+ * Returns: 0 if OK
+ *         <0 TS_ST_? #define on error
+ */
+    int timeseries_shrink(timeseries_p ts, int minCapacity);
+
     /*****************************************************************************/
     /*
  * Coersion versions of above functions to insert an int64 or double into a time
@@ -277,6 +479,137 @@ extern "C"
     long long timeseries_max_int64(timeseries_p ts, timelib64_t startTime, timelib64_t endTime, int *errorSt);
     double timeseries_max_double(timeseries_p ts, timelib64_t startTime, timelib64_t endTime, int *errorSt);
 
+    /*****************************************************************************/
+    /* Aggregate of the non-blank samples of one bucket of timeseries_bucketize() */
+    typedef struct timeseries_bucket_t
+    {
+        timelib64_t startUsec;  /* Start of the bucket. A multiple of the bucket width */
+        timelib64_t lastUsec;   /* Timestamp of the last sample */
+        long long count;        /* Number of samples. Buckets with none are not returned */
+        double sum;             /* Sum of the samples */
+        timeseries_value_t min; /* Smallest sample, in the type of the timeseries */
+        timeseries_value_t max; /* Largest sample, in the type of the timeseries */
+        timeseries_value_t last; /* Sample at lastUsec, in the type of the timeseries */
+    } timeseries_bucket_t, *timeseries_bucket_p;
+
+    /*****************************************************************************/
+    /*
+ * Group the samples of a TS_TYPE_INT64 or TS_TYPE_DOUBLE timeseries from startTime
+ * to endTime into buckets of bucketWidth usec that start at multiples of
+ * bucketWidth. Blank values are skipped. A TS_STORAGE_RING timeseries without
+ * compressed history is read straight from its columns.
+ *
+ * startTime   IN: Earliest time of values to consider. 0=start at beginning
+ * endTime     IN: Latest time of values to consider. 0=go until the end
+ * bucketWidth IN: Width of each bucket in usec. Must be > 0
+ * buckets    OUT: Buckets that had samples in ascending time order
+ * maxBuckets  IN: Capacity of buckets[]. Samples past the last bucket that fits
+ *                 are not looked at
+ *
+ * Returns: >= 0 Number of buckets written to buckets[]
+ *           < 0 TS_ST_? #define on error
+ *
+ */
+    int timeseries_bucketize(timeseries_p ts,
+                             timelib64_t startTime,
+                             timelib64_t endTime,
+                             timelib64_t bucketWidth,
+                             timeseries_bucket_p buckets,
+                             int maxBuckets);
+
+    /*****************************************************************************/
+    /*
+ * Callback for timeseries_for_each_span(). usecSince1970 and values are count
+ * consecutive samples in ascending time order. They are only valid during the
+ * call, which must not modify the timeseries.
+ *
+ * Returns: 0 to keep going
+ *          !0 to stop
+ */
+    typedef int (*timeseries_span_f)(timelib64_t const *usecSince1970,
+                                     timeseries_value_t const *values,
+                                     int count,
+                                     void *userData);
+
+    /*****************************************************************************/
+    /*
+ * Walk the samples of a TS_STORAGE_RING TS_TYPE_INT64 or TS_TYPE_DOUBLE timeseries
+ * from startTime to endTime as runs that are contiguous in memory: each
+ * compressed block that is decoded, then at most two runs of the ring's columns.
+ * This lets callers reduce samples over plain arrays instead of a cursor.
+ *
+ * startTime  IN: Earliest time of values to consider. 0=start at beginning
+ * endTime    IN: Latest time of values to consider. 0=go until the end
+ * spanCB     IN: Called for each run in ascending time order
+ * userData   IN: Passed to spanCB
+ *
+ * Returns: TS_ST_OK on success. This includes spanCB stopping early
+ *          TS_ST_WRONGTYPE if the timeseries isn't a numeric TS_STORAGE_RING
+ *          < 0 Other TS_ST_? #define on error
+ *
+ */
+    int timeseries_for_each_span(timeseries_p ts,
+                                 timelib64_t startTime,
+                                 timelib64_t endTime,
+                                 timeseries_span_f spanCB,
+                                 void *userData);
+
+    /* Run of samples that are contiguous in memory. See timeseries_ring_spans() */
+    typedef struct timeseries_span_t
+    {
+        timelib64_t const *usecSince1970; /* Timestamps in ascending order */
+        timeseries_value_t const *values; /* Value at each timestamp */
+        int count;                        /* Number of samples */
+    } timeseries_span_t, *timeseries_span_p;
+
+    /*****************************************************************************/
+    /*
+ * Point spans at the samples in the ring of a TS_STORAGE_RING TS_TYPE_INT64 or
+ * TS_TYPE_DOUBLE timeseries from startTime on, without copying them. The ring's
+ * columns hold them in at most two runs. Compressed history older than the ring
+ * is not included. The spans are only valid until the timeseries is modified.
+ *
+ * startTime       IN: Earliest time of values to include. 0=start at the beginning
+ * maxCount        IN: Only include the newest maxCount of those. 0=no limit
+ * spans          OUT: Runs in ascending time order. Unused runs have a count of 0
+ * olderInHistory OUT: Optional. Set to 1 if compressed history has samples from
+ *                     startTime on that were wanted but aren't in spans, else 0
+ *
+ * Returns: >= 0 Number of runs in spans
+ *          TS_ST_WRONGTYPE if the timeseries isn't a numeric TS_STORAGE_RING
+ *          < 0 Other TS_ST_? #define on error
+ *
+ */
+    int timeseries_ring_spans(timeseries_p ts,
+                              timelib64_t startTime,
+                              int maxCount,
+                              timeseries_span_t spans[2],
+                              int *olderInHistory);
+
+    /*****************************************************************************/
+    /*
+ * Copy the entries from startTime to endTime to entries in ascending time order.
+ * Both ends of the range are found by binary search. A TS_STORAGE_KEYEDVECTOR
+ * timeseries is then copied a block at a time.
+ *
+ * val.ptr of TS_TYPE_STRING and TS_TYPE_BLOB entries still points into the
+ * timeseries and is only valid until it is modified.
+ *
+ * startTime   IN: Earliest time of entries to copy. 0=start at beginning
+ * endTime     IN: Latest time of entries to copy. 0=go until the end
+ * entries    OUT: Where to copy the entries
+ * maxEntries  IN: Capacity of entries[]. Later entries are not copied
+ *
+ * Returns: >= 0 Number of entries copied
+ *           < 0 TS_ST_? #define on error
+ *
+ */
+    int timeseries_copy_range(timeseries_p ts,
+                              timelib64_t startTime,
+                              timelib64_t endTime,
+                              timeseries_entry_p entries,
+                              int maxEntries);
+
 /*****************************************************************************/
 /* Relation operators for matching relative to a base value */
 #define TS_REL_EQUAL 0      /* Matches == value (or none) */
@@ -308,6 +641,7 @@ extern "C"
 
     /*****************************************************************************/
     /* Calculate (roughly) the number of bytes in memory that this timeseries takes up.
+ * This includes the slabs holding string and blob values.
  *
  * Returns >= 0 Number of bytes
  */
@@ -352,6 +686,31 @@ Returns NULL if not found.
 */
     timeseries_entry_p timeseries_find(timeseries_p ts, timelib64_t time, int findOp, timeseries_cursor_p cursor);
 
+    /*************************************************************************/
+    /*
+Get the first entry after position and a cursor to the entry. Entries that
+were removed by timeseries_enforce_quota() before they were read are skipped.
+
+entriesSkipped OUT: Optional. How many entries were removed between position
+                    and the returned entry, if known. 0 otherwise
+
+Returns NULL if there are no entries after position
+*/
+    timeseries_entry_p timeseries_resume(timeseries_p ts,
+                                         timeseries_position_p position,
+                                         timeseries_cursor_p cursor,
+                                         long long *entriesSkipped);
+
+    /*************************************************************************/
+    /*
+Get the position after entry, which cursor points at. entry and cursor are as
+returned by the timeseries_first/next/find/resume functions
+*/
+    void timeseries_position_after(timeseries_p ts,
+                                   timeseries_entry_p entry,
+                                   timeseries_cursor_p cursor,
+                                   timeseries_position_p position);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,415 @@
+#include "tscompress.h"
+#include "logging.h"
+#include "timeseries.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*****************************************************************************/
+/* Growable bit stream for encoding. Bits are filled MSB first */
+typedef struct tscompress_writer_t
+{
+    unsigned char *buf;
+    int capacity;      /* Bytes allocated in buf */
+    long long numBits; /* Bits written so far */
+    int error;         /* Set to TS_ST_MEMORY if a reallocation failed */
+} tscompress_writer_t, *tscompress_writer_p;
+
+/* Cursor over an encoded bit stream for decoding */
+typedef struct tscompress_reader_t
+{
+    const unsigned char *buf;
+    long long bitPos;  /* Next bit to read */
+    long long numBits; /* Bits available in buf */
+    int error;         /* Set to TS_ST_UNKNOWN if we read past the end */
+} tscompress_reader_t, *tscompress_reader_p;
+
+/* Leading and trailing zero bits of the last non-zero XOR. Consecutive XORs
+   usually fit within the same window, so it is only re-sent when they don't */
+typedef struct tscompress_xor_window_t
+{
+    int valid;
+    int leading;
+    int trailing;
+} tscompress_xor_window_t;
+
+/*****************************************************************************/
+static void tscompress_put_bits(tscompress_writer_p w, unsigned long long value, int numBits)
+{
+    int i;
+
+    if (w->error)
+        return;
+
+    if ((w->numBits + numBits + 7) / 8 > w->capacity)
+    {
+        int newCapacity        = w->capacity ? w->capacity * 2 : 64;
+        unsigned char *newBuf = (unsigned char *)realloc(w->buf, newCapacity);
+        if (!newBuf)
+        {
+            w->error = TS_ST_MEMORY;
+            return;
+        }
+        memset(newBuf + w->capacity, 0, newCapacity - w->capacity);
+        w->buf      = newBuf;
+        w->capacity = newCapacity;
+    }
+
+    for (i = numBits - 1; i >= 0; i--, w->numBits++)
+    {
+        if ((value >> i) & 1)
+            w->buf[w->numBits / 8] |= (unsigned char)(0x80 >> (w->numBits % 8));
+    }
+}
+
+/*****************************************************************************/
+static unsigned long long tscompress_get_bits(tscompress_reader_p r, int numBits)
+{
+    unsigned long long value = 0;
+    int i;
+
+    if (r->bitPos + numBits > r->numBits)
+    {
+        r->error = TS_ST_UNKNOWN;
+        return 0;
+    }
+
+    for (i = 0; i < numBits; i++, r->bitPos++)
+        value = (value << 1) | ((r->buf[r->bitPos / 8] >> (7 - r->bitPos % 8)) & 1);
+
+    return value;
+}
+
+/*****************************************************************************/
+static unsigned long long tscompress_zigzag(long long value)
+{
+    return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+/*****************************************************************************/
+static long long tscompress_unzigzag(unsigned long long value)
+{
+    return (long long)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+/*****************************************************************************/
+static int tscompress_leading_zeros(unsigned long long value)
+{
+    int count = 0;
+    while (count < 64 && !(value & (1ULL << (63 - count))))
+        count++;
+    return count;
+}
+
+/*****************************************************************************/
+static int tscompress_trailing_zeros(unsigned long long value)
+{
+    int count = 0;
+    while (count < 64 && !(value & (1ULL << count)))
+        count++;
+    return count;
+}
+
+/*****************************************************************************/
+/* Delta-of-delta timestamp buckets: '0', '10'+7, '110'+9, '1110'+12 or '1111'+64 bits */
+static void tscompress_put_dod(tscompress_writer_p w, long long dod)
+{
+    unsigned long long zz = tscompress_zigzag(dod);
+
+    if (!zz)
+        tscompress_put_bits(w, 0, 1);
+    else if (zz < (1ULL << 7))
+    {
+        tscompress_put_bits(w, 0x2, 2);
+        tscompress_put_bits(w, zz, 7);
+    }
+    else if (zz < (1ULL << 9))
+    {
+        tscompress_put_bits(w, 0x6, 3);
+        tscompress_put_bits(w, zz, 9);
+    }
+    else if (zz < (1ULL << 12))
+    {
+        tscompress_put_bits(w, 0xE, 4);
+        tscompress_put_bits(w, zz, 12);
+    }
+    else
+    {
+        tscompress_put_bits(w, 0xF, 4);
+        tscompress_put_bits(w, zz, 64);
+    }
+}
+
+/*****************************************************************************/
+static long long tscompress_get_dod(tscompress_reader_p r)
+{
+    int numOnes;
+
+    /* Count the prefix 1s, up to 4 */
+    for (numOnes = 0; numOnes < 4 && tscompress_get_bits(r, 1); numOnes++)
+        ;
+
+    switch (numOnes)
+    {
+        case 0:
+            return 0;
+        case 1:
+            return tscompress_unzigzag(tscompress_get_bits(r, 7));
+        case 2:
+            return tscompress_unzigzag(tscompress_get_bits(r, 9));
+        case 3:
+            return tscompress_unzigzag(tscompress_get_bits(r, 12));
+        default:
+            return tscompress_unzigzag(tscompress_get_bits(r, 64));
+    }
+}
+
+/*****************************************************************************/
+/* Gorilla-style XOR: '0' if unchanged, '10' + bits within the previous window,
+ * or '11' + 5 bits of leading zeros + 6 bits of (length - 1) + the meaningful bits */
+static void tscompress_put_xor(tscompress_writer_p w, unsigned long long xorValue, tscompress_xor_window_t *window)
+{
+    int leading, trailing, length;
+
+    if (!xorValue)
+    {
+        tscompress_put_bits(w, 0, 1);
+        return;
+    }
+
+    leading  = tscompress_leading_zeros(xorValue);
+    trailing = tscompress_trailing_zeros(xorValue);
+    if (leading > 31)
+        leading = 31;
+
+    if (window->valid && leading >= window->leading && trailing >= window->trailing)
+    {
+        length = 64 - window->leading - window->trailing;
+        tscompress_put_bits(w, 0x2, 2);
+        tscompress_put_bits(w, xorValue >> window->trailing, length);
+        return;
+    }
+
+    length = 64 - leading - trailing;
+    tscompress_put_bits(w, 0x3, 2);
+    tscompress_put_bits(w, (unsigned long long)leading, 5);
+    tscompress_put_bits(w, (unsigned long long)(length - 1), 6);
+    tscompress_put_bits(w, xorValue >> trailing, length);
+
+    window->valid    = 1;
+    window->leading  = leading;
+    window->trailing = trailing;
+}
+
+/*****************************************************************************/
+static unsigned long long tscompress_get_xor(tscompress_reader_p r, tscompress_xor_window_t *window)
+{
+    int length;
+
+    if (!tscompress_get_bits(r, 1))
+        return 0;
+
+    if (tscompress_get_bits(r, 1))
+    {
+        window->valid    = 1;
+        window->leading  = (int)tscompress_get_bits(r, 5);
+        length           = (int)tscompress_get_bits(r, 6) + 1;
+        window->trailing = 64 - window->leading - length;
+        if (window->trailing < 0)
+        {
+            r->error = TS_ST_UNKNOWN;
+            return 0;
+        }
+    }
+    else if (!window->valid)
+    {
+        r->error = TS_ST_UNKNOWN;
+        return 0;
+    }
+
+    length = 64 - window->leading - window->trailing;
+    return tscompress_get_bits(r, length) << window->trailing;
+}
+
+/*****************************************************************************/
+/* int64 deltas: '0' if unchanged, otherwise '1' + 6 bits of (length - 1) + the
+ * zig-zag encoded delta */
+static void tscompress_put_delta(tscompress_writer_p w, long long delta)
+{
+    unsigned long long zz = tscompress_zigzag(delta);
+    int length;
+
+    if (!zz)
+    {
+        tscompress_put_bits(w, 0, 1);
+        return;
+    }
+
+    length = 64 - tscompress_leading_zeros(zz);
+    tscompress_put_bits(w, 1, 1);
+    tscompress_put_bits(w, (unsigned long long)(length - 1), 6);
+    tscompress_put_bits(w, zz, length);
+}
+
+/*****************************************************************************/
+static long long tscompress_get_delta(tscompress_reader_p r)
+{
+    int length;
+
+    if (!tscompress_get_bits(r, 1))
+        return 0;
+
+    length = (int)tscompress_get_bits(r, 6) + 1;
+    return tscompress_unzigzag(tscompress_get_bits(r, length));
+}
+
+/*****************************************************************************/
+/* Encode value relative to prev. doubles are XORed and int64s are delta-encoded */
+static void tscompress_put_value(tscompress_writer_p w,
+                                 int tsType,
+                                 long long value,
+                                 long long prev,
+                                 tscompress_xor_window_t *window)
+{
+    if (tsType == TS_TYPE_DOUBLE)
+        tscompress_put_xor(w, (unsigned long long)value ^ (unsigned long long)prev, window);
+    else
+        tscompress_put_delta(w, (long long)((unsigned long long)value - (unsigned long long)prev));
+}
+
+/*****************************************************************************/
+static long long tscompress_get_value(tscompress_reader_p r, int tsType, long long prev, tscompress_xor_window_t *window)
+{
+    if (tsType == TS_TYPE_DOUBLE)
+        return (long long)(tscompress_get_xor(r, window) ^ (unsigned long long)prev);
+
+    return (long long)((unsigned long long)prev + (unsigned long long)tscompress_get_delta(r));
+}
+
+/*****************************************************************************/
+int tscompress_encode_block(int tsType,
+                            const timelib64_t *times,
+                            const long long *val,
+                            const long long *val2,
+                            int count,
+                            timeseries_block_p block)
+{
+    tscompress_writer_t w;
+    tscompress_xor_window_t window, window2;
+    timelib64_t prevDelta = 0;
+    long long prevVal = 0, prevVal2 = 0;
+    int i;
+
+    if (!times || !val || !block || count < 1 || count > TS_BLOCK_SAMPLES)
+        return TS_ST_BADPARAM;
+    if (tsType != TS_TYPE_INT64 && tsType != TS_TYPE_DOUBLE)
+        return TS_ST_WRONGTYPE;
+
+    memset(&w, 0, sizeof(w));
+    memset(&window, 0, sizeof(window));
+    memset(&window2, 0, sizeof(window2));
+    memset(block, 0, sizeof(*block));
+
+    block->count     = count;
+    block->firstUsec = times[0];
+    block->lastUsec  = times[count - 1];
+
+    /* Only store val2 if any of it is non-zero */
+    for (i = 0; val2 && i < count && !block->hasVal2; i++)
+    {
+        if (val2[i])
+            block->hasVal2 = 1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            timelib64_t delta = times[i] - times[i - 1];
+            tscompress_put_dod(&w, delta - prevDelta);
+            prevDelta = delta;
+        }
+
+        tscompress_put_value(&w, tsType, val[i], prevVal, &window);
+        prevVal = val[i];
+
+        if (block->hasVal2)
+        {
+            tscompress_put_value(&w, tsType, val2[i], prevVal2, &window2);
+            prevVal2 = val2[i];
+        }
+    }
+
+    if (w.error)
+    {
+        free(w.buf);
+        return w.error;
+    }
+
+    /* Give back the slack from doubling */
+    block->numBytes = (int)((w.numBits + 7) / 8);
+    block->bytes    = (unsigned char *)realloc(w.buf, block->numBytes);
+    if (!block->bytes)
+        block->bytes = w.buf;
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+int tscompress_decode_block(int tsType, timeseries_block_p block, timelib64_t *times, long long *val, long long *val2)
+{
+    tscompress_reader_t r;
+    tscompress_xor_window_t window, window2;
+    timelib64_t prevDelta = 0;
+    long long prevVal = 0, prevVal2 = 0;
+    int i;
+
+    if (!block || !times || !val || !val2 || block->count < 1 || block->count > TS_BLOCK_SAMPLES)
+        return TS_ST_BADPARAM;
+
+    r.buf     = block->bytes;
+    r.bitPos  = 0;
+    r.numBits = (long long)block->numBytes * 8;
+    r.error   = 0;
+    memset(&window, 0, sizeof(window));
+    memset(&window2, 0, sizeof(window2));
+
+    for (i = 0; i < block->count; i++)
+    {
+        if (i == 0)
+            times[i] = block->firstUsec;
+        else
+        {
+            prevDelta += tscompress_get_dod(&r);
+            times[i] = times[i - 1] + prevDelta;
+        }
+
+        val[i]  = tscompress_get_value(&r, tsType, prevVal, &window);
+        prevVal = val[i];
+
+        if (block->hasVal2)
+        {
+            val2[i]  = tscompress_get_value(&r, tsType, prevVal2, &window2);
+            prevVal2 = val2[i];
+        }
+        else
+            val2[i] = 0;
+    }
+
+    if (r.error)
+    {
+        PRINT_ERROR("%d %d", "Corrupt timeseries block of %d samples, %d bytes\n", block->count, block->numBytes);
+        return r.error;
+    }
+
+    return TS_ST_OK;
+}
+
+/*****************************************************************************/
+void tscompress_free_block(timeseries_block_p block)
+{
+    if (!block)
+        return;
+
+    free(block->bytes);
+    block->bytes    = 0;
+    block->numBytes = 0;
+}
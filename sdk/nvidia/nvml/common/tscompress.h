@@ -0,0 +1,80 @@
+/*
+ * tscompress.h
+ *
+ * Block codec for compressed timeseries history, after Facebook's Gorilla
+ * TSDB. Timestamps are stored as bucketed delta-of-deltas, doubles as XORs
+ * against the previous value, and int64s as zig-zag deltas, all in a bit
+ * stream. A run of regularly spaced, unchanging samples costs 2 bits per sample.
+ *
+ */
+
+#ifndef TSCOMPRESS_H
+#define TSCOMPRESS_H
+
+#include "timelib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*****************************************************************************/
+#define TS_BLOCK_SAMPLES 64 /* Maximum number of samples encoded per block */
+
+    /*****************************************************************************/
+    /* A sealed block of compressed samples */
+    typedef struct timeseries_block_t
+    {
+        timelib64_t firstUsec; /* Timestamp of the first encoded sample */
+        timelib64_t lastUsec;  /* Timestamp of the last encoded sample */
+        unsigned char *bytes;  /* Encoded samples */
+        int numBytes;          /* Size of bytes in bytes */
+        short count;           /* Number of samples encoded in bytes */
+        short skip;            /* Number of leading samples that have been logically
+                                  removed by quota enforcement */
+        char hasVal2;          /* Whether val2 was encoded. If not, val2 = 0 */
+    } timeseries_block_t, *timeseries_block_p;
+
+    /*****************************************************************************/
+    /*
+ * Encode count samples into block. times must be ascending. val2 can be NULL
+ * if no val2 values are to be stored.
+ *
+ * tsType IN: TS_TYPE_INT64 or TS_TYPE_DOUBLE. Determines how val/val2 are encoded
+ *
+ * Returns: 0 if OK
+ *         <0 TS_ST_? #define on error
+ */
+    int tscompress_encode_block(int tsType,
+                                const timelib64_t *times,
+                                const long long *val,
+                                const long long *val2,
+                                int count,
+                                timeseries_block_p block);
+
+    /*****************************************************************************/
+    /*
+ * Decode all block->count samples of block into times, val and val2, which
+ * must each have room for TS_BLOCK_SAMPLES entries. val2 is zero-filled if
+ * the block didn't store val2
+ *
+ * Returns: 0 if OK
+ *         <0 TS_ST_? #define on error
+ */
+    int tscompress_decode_block(int tsType,
+                                timeseries_block_p block,
+                                timelib64_t *times,
+                                long long *val,
+                                long long *val2);
+
+    /*****************************************************************************/
+    /*
+ * Free the encoded bytes of a block
+ */
+    void tscompress_free_block(timeseries_block_p block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TSCOMPRESS_H */
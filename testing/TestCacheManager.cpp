@@ -786,121 +786,47 @@ void setup_topology(dcgmTopology_t &top)
     top.numElements = numElements;
 }
 
-bool containsConnectionPair(const std::vector<DcgmGpuConnectionPair> &level, const DcgmGpuConnectionPair &cp)
-{
-    bool found = false;
-    for (size_t i = 0; i < level.size(); i++)
-    {
-        if (level[i] == cp)
-        {
-            found = true;
-            break;
-        }
-    }
-
-    return found;
-}
-
 /*****************************************************************************/
-int TestCacheManager::TestSetIOConnectionLevels()
+int TestCacheManager::TestTopologySelectorLinks()
 {
-    int retSt          = 0;
     dcgmTopology_t top = {};
-    std::map<unsigned int, std::vector<DcgmGpuConnectionPair>> connectionLevel;
-    DcgmCacheManager dcm;
-
-    std::vector<unsigned int> affinityGroup;
-    for (unsigned int i = 0; i < 4; i++)
-        affinityGroup.push_back(i);
 
     setup_topology(top);
 
-    dcm.SetIOConnectionLevels(affinityGroup, &top, connectionLevel);
-
-    if (connectionLevel.size() != 2)
-    {
-        fprintf(stderr,
-                "Expected 2 populated connection levels, but found %d.\n",
-                static_cast<int>(connectionLevel.size()));
-        retSt = 100;
-    }
-
-    if (connectionLevel[1].size() != 2)
-    {
-        fprintf(
-            stderr, "Level 0 should have 2 connections, but it has %d.\n", static_cast<int>(connectionLevel[0].size()));
-        return 100;
-    }
-
-    if (connectionLevel[2].size() != 4)
-    {
-        fprintf(
-            stderr, "Level 1 should have 4 connections, but it has %d.\n", static_cast<int>(connectionLevel[1].size()));
-        return 100;
-    }
-
-    DcgmGpuConnectionPair level1[2] = { DcgmGpuConnectionPair(0, 1), DcgmGpuConnectionPair(2, 3) };
-    DcgmGpuConnectionPair level2[4] = { DcgmGpuConnectionPair(0, 2),
-                                        DcgmGpuConnectionPair(0, 3),
-                                        DcgmGpuConnectionPair(1, 2),
-                                        DcgmGpuConnectionPair(1, 3) };
+    DcgmTopologySelector selector(&top);
 
-    for (unsigned int i = 0; i < 2; i++)
-    {
-        if (containsConnectionPair(connectionLevel[1], level1[i]) == false)
-        {
-            fprintf(stderr, "Expected to find %u,%u in level 0, but didn't.\n", level1[i].gpu1, level1[i].gpu2);
-            return 100;
-        }
-    }
+    unsigned int expected[4][4] = { { 0, 1, 2, 2 }, { 1, 0, 2, 2 }, { 2, 2, 0, 1 }, { 2, 2, 1, 0 } };
 
-    for (unsigned int i = 0; i < 4; i++)
+    for (unsigned int gpuA = 0; gpuA < 4; gpuA++)
     {
-        if (containsConnectionPair(connectionLevel[2], level2[i]) == false)
+        for (unsigned int gpuB = 0; gpuB < 4; gpuB++)
         {
-            fprintf(stderr, "Expected to find %u,%u in level 1, but didn't.\n", level2[i].gpu1, level2[i].gpu2);
-            return 100;
+            if (selector.Links(gpuA, gpuB) != expected[gpuA][gpuB])
+            {
+                fprintf(stderr,
+                        "Expected %u NvLinks between %u and %u, but found %u.\n",
+                        expected[gpuA][gpuB],
+                        gpuA,
+                        gpuB,
+                        selector.Links(gpuA, gpuB));
+                return 100;
+            }
         }
     }
 
-    uint64_t outputGpus = 0;
-    if (dcm.HasStrongConnection(connectionLevel[1], 4, outputGpus) == true)
+    if (selector.Score(0xF) != 10)
     {
-        fprintf(stderr, "Level 0 doesn't have a strong connection between 4 gpus, but reported to.\n");
-        return 100;
-    }
-    if (outputGpus != 0)
-    {
-        fprintf(stderr, "Output gpus shouldn't have been set, but was.\n");
+        fprintf(stderr, "All 4 gpus should score 10, but scored %u.\n", selector.Score(0xF));
         return 100;
     }
 
-    if (dcm.HasStrongConnection(connectionLevel[1], 2, outputGpus) == false)
+    if (selector.Score(0x3) != 1)
     {
-        fprintf(stderr, "Level 0 has a strong connection between 2 gpus, but said it didn't.\n");
+        fprintf(stderr, "Gpus 0 and 1 should score 1, but scored %u.\n", selector.Score(0x3));
         return 100;
     }
 
-    if (outputGpus != 0x3)
-    {
-        fprintf(stderr, "Output gpus should've been set to 0x3, but is %llx.\n", static_cast<long long>(outputGpus));
-        return 100;
-    }
-
-    outputGpus = 0;
-    if (dcm.HasStrongConnection(connectionLevel[2], 4, outputGpus) == false)
-    {
-        fprintf(stderr, "Level 1 has a strong connection between 4 gpus, but said it didn't.\n");
-        return 100;
-    }
-
-    if (outputGpus != 0xF)
-    {
-        fprintf(stderr, "Output gpus should've been set to 0xF, but is %llx.\n", static_cast<long long>(outputGpus));
-        return 100;
-    }
-
-    return retSt;
+    return 0;
 }
 
 /*****************************************************************************/
@@ -922,7 +848,7 @@ int TestCacheManager::TestMatchByIO()
 
     potentialCpuMatches.push_back(0);
 
-    dcm.MatchByIO(affinityGroups, &top, potentialCpuMatches, 2, outputGpus);
+    dcm.MatchByIO(affinityGroups, DcgmTopologySelector(&top), potentialCpuMatches, 2, outputGpus);
 
     if (outputGpus != 0x5)
     {
@@ -930,15 +856,16 @@ int TestCacheManager::TestMatchByIO()
         retSt = 100;
     }
 
-    dcm.MatchByIO(affinityGroups, &top, potentialCpuMatches, 3, outputGpus);
+    // Every set of 3 has 5 NvLinks between its gpus, so the lowest gpuIds win
+    dcm.MatchByIO(affinityGroups, DcgmTopologySelector(&top), potentialCpuMatches, 3, outputGpus);
 
-    if (outputGpus != 0xd)
+    if (outputGpus != 0x7)
     {
-        fprintf(stderr, "Output gpus should've been set to 0xd, but is %llx.\n", static_cast<long long>(outputGpus));
+        fprintf(stderr, "Output gpus should've been set to 0x7, but is %llx.\n", static_cast<long long>(outputGpus));
         retSt = 100;
     }
 
-    dcm.MatchByIO(affinityGroups, &top, potentialCpuMatches, 4, outputGpus);
+    dcm.MatchByIO(affinityGroups, DcgmTopologySelector(&top), potentialCpuMatches, 4, outputGpus);
 
     if (outputGpus != 0xF)
     {
@@ -949,7 +876,7 @@ int TestCacheManager::TestMatchByIO()
     // Alter the topology
     top.element[5].path = DCGM_TOPOLOGY_NVLINK3;
 
-    dcm.MatchByIO(affinityGroups, &top, potentialCpuMatches, 2, outputGpus);
+    dcm.MatchByIO(affinityGroups, DcgmTopologySelector(&top), potentialCpuMatches, 2, outputGpus);
 
     if (outputGpus != 0xC)
     {
@@ -2635,7 +2562,7 @@ int TestCacheManager::Run()
         CompleteTest("TestCreateGroupsFromCpuAffinities", TestCreateGroupsFromCpuAffinities(), Nfailed);
         CompleteTest("TestPopulatePotentialCpuMatches", TestPopulatePotentialCpuMatches(), Nfailed);
         CompleteTest("TestCombineAffinityGroups", TestCombineAffinityGroups(), Nfailed);
-        CompleteTest("TestSetIOConnectionLevels", TestSetIOConnectionLevels(), Nfailed);
+        CompleteTest("TestTopologySelectorLinks", TestTopologySelectorLinks(), Nfailed);
         CompleteTest("TestMatchByIO", TestMatchByIO(), Nfailed);
         CompleteTest("TestSimulatedAttachDetach", TestSimulatedAttachDetach(), Nfailed);
         CompleteTest("TestAttachDetachNoWatches", TestAttachDetachNoWatches(), Nfailed);
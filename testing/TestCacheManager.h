@@ -71,7 +71,7 @@ private:
     int TestCreateGroupsFromCpuAffinities();
     int TestPopulatePotentialCpuMatches();
     int TestCombineAffinityGroups();
-    int TestSetIOConnectionLevels();
+    int TestTopologySelectorLinks();
     int TestMatchByIO();
     int TestSimulatedAttachDetach();
     int TestAttachDetachNoWatches();
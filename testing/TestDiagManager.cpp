@@ -17,11 +17,13 @@
 #include <iostream>
 #include <stddef.h>
 #include <string>
+#include <unistd.h>
 
 #include "DcgmDiagCommon.h"
 #include "DcgmDiagManager.h"
 #include "DcgmDiagResponseWrapper.h"
 #include "DcgmError.h"
+#include "DcgmNvvsWorker.h"
 #include "TestDiagManager.h"
 #include "TestDiagManagerStrings.h"
 #include <DcgmCoreCommunication.h>
@@ -121,6 +123,42 @@ int TestDiagManager::Run()
     else
         printf("TestDiagManager::TestErrorsFromLevelOne PASSED\n");
 
+    st = TestNvvsWorker();
+    if (st < 0)
+    {
+        Nfailed++;
+        fprintf(stderr, "TestDiagManager::TestNvvsWorker FAILED with %d\n", st);
+    }
+    else
+        printf("TestDiagManager::TestNvvsWorker PASSED\n");
+
+    st = TestProcessStreamedResults();
+    if (st < 0)
+    {
+        Nfailed++;
+        fprintf(stderr, "TestDiagManager::TestProcessStreamedResults FAILED with %d\n", st);
+    }
+    else
+        printf("TestDiagManager::TestProcessStreamedResults PASSED\n");
+
+    st = TestConcurrentRunAdmission();
+    if (st < 0)
+    {
+        Nfailed++;
+        fprintf(stderr, "TestDiagManager::TestConcurrentRunAdmission FAILED with %d\n", st);
+    }
+    else
+        printf("TestDiagManager::TestConcurrentRunAdmission PASSED\n");
+
+    st = TestResultReuse();
+    if (st < 0)
+    {
+        Nfailed++;
+        fprintf(stderr, "TestDiagManager::TestResultReuse FAILED with %d\n", st);
+    }
+    else
+        printf("TestDiagManager::TestResultReuse PASSED\n");
+
     if (Nfailed > 0)
     {
         fprintf(stderr, "%d tests FAILED\n", Nfailed);
@@ -1216,3 +1254,243 @@ int TestDiagManager::TestPerformExternalCommand()
 
     return result;
 }
+
+void TestDiagManager::CreateDummyWorkerScript()
+{
+    std::ofstream dummyScript;
+    dummyScript.open("dummy_worker");
+    dummyScript << "#!/bin/bash" << std::endl;
+    dummyScript << "while read -r line; do" << std::endl;
+    dummyScript << "    echo \"ran $line\"" << std::endl;
+    dummyScript << "    if [[ \"$line\" == *crash* ]]; then exit 1; fi" << std::endl;
+    dummyScript << "    if [[ \"$line\" == *fail* ]]; then echo NVVS_WORKER_END_OF_RUN 1; continue; fi" << std::endl;
+    dummyScript << "    echo NVVS_WORKER_END_OF_RUN 0" << std::endl;
+    dummyScript << "done" << std::endl;
+    dummyScript.close();
+    system("chmod 755 dummy_worker");
+}
+
+int TestDiagManager::TestNvvsWorker()
+{
+    std::string output;
+    int returnCode = -1;
+
+    output = "{}\nNVVS_WORKER_END_OF_RUN 3\n";
+    if (!DcgmNvvsWorker::ParseEndOfRun(output, returnCode) || returnCode != 3 || output != "{}\n")
+    {
+        fprintf(stderr, "Expected to find the end of a run with code 3, found '%s' %d\n", output.c_str(), returnCode);
+        return -1;
+    }
+
+    output = "{}\nNVVS_WORKER_END_OF_RUN 0";
+    if (DcgmNvvsWorker::ParseEndOfRun(output, returnCode))
+    {
+        fprintf(stderr, "Found the end of a run before the end of its line\n");
+        return -1;
+    }
+
+    CreateDummyWorkerScript();
+
+    DcgmNvvsWorker worker("./dummy_worker");
+    pid_t pid = worker.Start();
+    if (pid < 0 || worker.Start() != pid)
+    {
+        fprintf(stderr, "Expected the worker to be started once, got pid %d\n", (int)pid);
+        return -1;
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        dcgmReturn_t ret = worker.Run({ "-j", "--specifiedtest", "short" }, output);
+        if (ret != DCGM_ST_OK || output != "ran [\"-j\",\"--specifiedtest\",\"short\"]\n")
+        {
+            fprintf(stderr, "Run %d of the worker returned %d with output '%s'\n", i, ret, output.c_str());
+            return -1;
+        }
+    }
+
+    if (worker.Run({ "fail" }, output) != DCGM_ST_NVVS_ERROR || worker.Start() != pid)
+    {
+        fprintf(stderr, "A failed run should be reported without restarting the worker\n");
+        return -1;
+    }
+
+    if (worker.Run({ "crash" }, output) != DCGM_ST_NVVS_ERROR || output != "ran [\"crash\"]\n")
+    {
+        fprintf(stderr, "Expected the crashed run to fail with its output, got '%s'\n", output.c_str());
+        return -1;
+    }
+
+    pid_t newPid = worker.Start();
+    if (newPid < 0 || newPid == pid || worker.Run({ "-j" }, output) != DCGM_ST_OK)
+    {
+        fprintf(stderr, "Expected a new worker after the crash, got pid %d\n", (int)newPid);
+        return -1;
+    }
+
+    worker.Stop();
+    unlink("dummy_worker");
+
+    return 0;
+}
+
+int TestDiagManager::TestProcessStreamedResults()
+{
+    DcgmDiagManager am(g_coreCallbacks);
+    dcgmDiagResponse_t response = {};
+    response.version            = dcgmDiagResponse_version;
+    DcgmDiagResponseWrapper drw;
+    drw.SetVersion6(&response);
+    drw.InitializeResponseStruct(2);
+
+    std::string smStress("NVVS_STREAM_RESULT {\"version\":\"2.0\",\"test\":{\"name\":\"SM Stress\",\"results\":"
+                         "[{\"gpu_ids\":\"0\",\"status\":\"PASS\"},"
+                         "{\"gpu_ids\":\"1\",\"status\":\"FAIL\","
+                         "\"warnings\":[{\"warning\":\"GPU 1 is broken\",\"error_id\":3}]}]}}\n");
+    std::string pcie("NVVS_STREAM_RESULT {\"version\":\"2.0\",\"test\":{\"name\":\"PCIe\",\"results\":"
+                     "[{\"gpu_ids\":\"0\",\"status\":\"PASS\"}]}}\n");
+
+    /* The second result arrives in two reads */
+    DcgmDiagStreamState state;
+    std::string output = "Starting\n" + smStress + pcie.substr(0, 20);
+    am.ProcessStreamedResults(output, state, drw);
+    if (state.testCount != 1 || output != "Starting\n" + pcie.substr(0, 20))
+    {
+        fprintf(stderr, "Expected one streamed result taken out, got %u: '%s'\n", state.testCount, output.c_str());
+        return -1;
+    }
+
+    if (response.perGpuResponses[0].results[DCGM_SM_STRESS_INDEX].status != DCGM_DIAG_RESULT_PASS
+        || response.perGpuResponses[1].results[DCGM_SM_STRESS_INDEX].status != DCGM_DIAG_RESULT_FAIL
+        || response.perGpuResponses[1].results[DCGM_SM_STRESS_INDEX].error.code != 3
+        || response.perGpuResponses[0].results[DCGM_PCI_INDEX].status != DCGM_DIAG_RESULT_NOT_RUN)
+    {
+        fprintf(stderr, "The streamed SM Stress results weren't filled in\n");
+        return -1;
+    }
+
+    output += pcie.substr(20) + "{ \"DCGM GPU Diagnostic\" : {} }\n";
+    am.ProcessStreamedResults(output, state, drw);
+    if (state.testCount != 2 || output != "Starting\n{ \"DCGM GPU Diagnostic\" : {} }\n"
+        || response.perGpuResponses[0].results[DCGM_PCI_INDEX].status != DCGM_DIAG_RESULT_PASS)
+    {
+        fprintf(stderr, "Expected the PCIe result once it was complete, got '%s'\n", output.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+int TestDiagManager::TestConcurrentRunAdmission()
+{
+    DcgmDiagManager am(g_coreCallbacks);
+    uint64_t first, second, third;
+
+    if (DcgmDiagManager::ParseGpuIdSet("0,1,3") != std::set<unsigned int> { 0, 1, 3 }
+        || !DcgmDiagManager::ParseGpuIdSet("").empty())
+    {
+        fprintf(stderr, "Couldn't parse GPU id lists\n");
+        return -1;
+    }
+
+    if (am.AdmitRun({ 0, 1, 2, 3 }, first) != DCGM_ST_OK || am.AdmitRun({ 4, 5, 6, 7 }, second) != DCGM_ST_OK)
+    {
+        fprintf(stderr, "Runs on disjoint GPUs should have been admitted\n");
+        return -1;
+    }
+
+    if (am.AdmitRun({ 3, 4 }, third) != DCGM_ST_DIAG_ALREADY_RUNNING
+        || am.AdmitRun({}, third) != DCGM_ST_DIAG_ALREADY_RUNNING)
+    {
+        fprintf(stderr, "Runs on GPUs that are already running a diagnostic should have been turned away\n");
+        return -1;
+    }
+
+    am.RetireRun(first);
+    if (am.AdmitRun({ 3 }, third) != DCGM_ST_OK)
+    {
+        fprintf(stderr, "A run on GPUs of a retired run should have been admitted\n");
+        return -1;
+    }
+
+    am.RetireRun(second);
+    am.RetireRun(third);
+    if (am.AdmitRun({}, first) != DCGM_ST_OK || am.AdmitRun({ 0 }, second) != DCGM_ST_DIAG_ALREADY_RUNNING)
+    {
+        fprintf(stderr, "A run on all GPUs should be admitted only while no other run is active\n");
+        return -1;
+    }
+
+    am.RetireRun(first);
+    return 0;
+}
+
+int TestDiagManager::TestResultReuse()
+{
+    DcgmDiagResultCache cache(1000);
+    DcgmDiagHealthSnapshot health { { DCGM_FI_DEV_XID_ERRORS, DCGM_INT64_BLANK },
+                                    { DCGM_FI_DEV_ECC_DBE_VOL_TOTAL, 0 } };
+    DcgmDiagCachedResult passed;
+    DcgmDiagCachedResult result;
+
+    passed.resultTime = 5000;
+    passed.health     = health;
+    for (auto &test : passed.perGpu.results)
+    {
+        test.status = DCGM_DIAG_RESULT_NOT_RUN;
+    }
+    passed.perGpu.results[DCGM_MEMORY_INDEX].status = DCGM_DIAG_RESULT_PASS;
+    cache.Store("short", 0, passed);
+
+    if (!cache.Lookup("short", 0, 5500, health, result) || cache.Lookup("long", 0, 5500, health, result)
+        || cache.Lookup("short", 1, 5500, health, result))
+    {
+        fprintf(stderr, "Results should only be reused for the same signature and GPU\n");
+        return -1;
+    }
+
+    if (cache.Lookup("short", 0, 6001, health, result) || cache.Lookup("short", 0, 5500, health, result))
+    {
+        fprintf(stderr, "Results older than the validity window should be forgotten\n");
+        return -1;
+    }
+
+    cache.Store("short", 0, passed);
+    DcgmDiagHealthSnapshot xid = health;
+    xid[DCGM_FI_DEV_XID_ERRORS] = 5200;
+    if (cache.Lookup("short", 0, 5500, xid, result) || cache.Lookup("short", 0, 5500, health, result))
+    {
+        fprintf(stderr, "Results of a GPU that had an XID since should be forgotten\n");
+        return -1;
+    }
+
+    DcgmDiagCachedResult failed = passed;
+    failed.perGpu.results[DCGM_PCI_INDEX].status = DCGM_DIAG_RESULT_FAIL;
+    cache.Store("short", 0, passed);
+    cache.Store("long", 0, failed);
+    if (cache.Lookup("short", 0, 5500, health, result))
+    {
+        fprintf(stderr, "A failing run should forget all of the results of its GPU\n");
+        return -1;
+    }
+
+    dcgmRunDiag_t shortRun {};
+    dcgmRunDiag_t memtestRun {};
+    shortRun.validate = DCGM_POLICY_VALID_SV_SHORT;
+    snprintf(memtestRun.testNames[0], sizeof(memtestRun.testNames[0]), "memtest");
+    if (DcgmDiagManager::GetResultSignature(&shortRun) == DcgmDiagManager::GetResultSignature(&memtestRun))
+    {
+        fprintf(stderr, "Runs of different tests should have different signatures\n");
+        return -1;
+    }
+
+    DcgmDiagManager::MarkReused(passed, 90000000);
+    if (std::string(passed.perGpu.results[DCGM_MEMORY_INDEX].info) != "Reused the result of a run 90 seconds ago."
+        || passed.perGpu.results[DCGM_PCI_INDEX].info[0] != '\0')
+    {
+        fprintf(stderr, "Only the results that ran should be marked as reused\n");
+        return -1;
+    }
+
+    return 0;
+}
@@ -54,8 +54,13 @@ private:
     int TestPerformExternalCommand();
     int TestErrorsFromLevelOne();
     int TestInvalidVersion();
+    int TestNvvsWorker();
+    int TestProcessStreamedResults();
+    int TestConcurrentRunAdmission();
+    int TestResultReuse();
     void CreateDummyScript();
     void CreateDummyFailScript();
+    void CreateDummyWorkerScript();
     void RemoveDummyScript();
 };
 
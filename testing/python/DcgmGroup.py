@@ -481,9 +481,9 @@ class DcgmGroupProfiling:
 
     Returns a dcgm_structs.c_dcgmProfWatchFields_v1 instance
     '''
-    def WatchFields(self, fieldIds, updateFreq, maxKeepAge, maxKeepSamples):
+    def WatchFields(self, fieldIds, updateFreq, maxKeepAge, maxKeepSamples, flags=0):
         ret = dcgm_agent.dcgmProfWatchFields(self._dcgmHandle.handle, fieldIds, self._groupId, 
-                                             updateFreq, maxKeepAge, maxKeepSamples)
+                                             updateFreq, maxKeepAge, maxKeepSamples, flags)
         return ret
     
     '''
@@ -654,13 +654,14 @@ def dcgmProfGetSupportedMetricGroups(dcgmHandle, groupId):
     dcgm_structs._dcgmCheckReturn(ret)
     return msg
 
-def dcgmProfWatchFields(dcgmHandle, fieldIds, groupId, updateFreq, maxKeepAge, maxKeepSamples):
+def dcgmProfWatchFields(dcgmHandle, fieldIds, groupId, updateFreq, maxKeepAge, maxKeepSamples, flags=0):
     msg = dcgm_structs.c_dcgmProfWatchFields_v1()
     msg.version = dcgm_structs.dcgmProfWatchFields_version1
     msg.groupId = groupId
     msg.updateFreq = updateFreq
     msg.maxKeepAge = maxKeepAge
     msg.maxKeepSamples = maxKeepSamples
+    msg.flags = flags
     msg.numFieldIds = c_uint32(len(fieldIds))
     for i, fieldId in enumerate(fieldIds):
         msg.fieldIds[i] = fieldId
@@ -1613,6 +1613,8 @@ DCGM_RUN_FLAGS_STATSONFAIL = 0x0002
 DCGM_RUN_FLAGS_TRAIN       = 0x0004
 DCGM_RUN_FLAGS_FORCE_TRAIN = 0x0008
 DCGM_RUN_FLAGS_FAIL_EARLY  = 0x0010 # Enable fail early checks for the Targeted Stress, Targeted Power, SM Stress, and Diagnostic tests
+DCGM_RUN_FLAGS_FAIL_FAST   = 0x0020 # Stop the whole run at the first fatal error on any GPU
+DCGM_RUN_FLAGS_REUSE_RESULTS = 0x0040 # Return recent passing results of the same tests on a GPU instead of running them again
 
 class c_dcgmRunDiag_v7(_PrintableStructure):
     _fields_ = [
@@ -1821,6 +1823,9 @@ class c_dcgmProfGetMetricGroups_v2(_PrintableStructure):
 
 dcgmProfGetMetricGroups_version1 = make_dcgm_version(c_dcgmProfGetMetricGroups_v2, 2)
 
+DCGM_PROF_WATCH_FLAG_MULTIPLEX = 0x00000001 # Time-multiplex metric groups that can't be collected together
+DCGM_PROF_WATCH_FLAG_BUFFERED = 0x00000002 # Keep every counter sample, delivered in batches every updateFreq
+
 class c_dcgmProfWatchFields_v1(_PrintableStructure):
     _fields_ = [
         ('version', c_uint32),
@@ -112,7 +112,27 @@ class DcgmGroupSamples:
     def UnwatchFields(self, fieldGroup):
         ret = dcgm_agent.dcgmUnwatchFields(self._dcgmHandle.handle, self._groupId, fieldGroup.fieldGroupId)
         dcgm_structs._dcgmCheckReturn(ret)
-    
+
+    '''
+    Tell DCGM to watch the given field group and push its values to us as they are sampled
+
+    fieldGroup, updateFreq, maxKeepAge and maxKeepSamples are as for WatchFields()
+    callback: dcgm_agent.dcgmFieldValueEntityEnumeration_f invoked on a DCGM thread with each run of values of an
+              entity. It must not call DCGM and should return quickly. Keep it alive until UnsubscribeFields()
+    userData: Object passed to callback
+
+    Returns the streamId to pass to UnsubscribeFields()
+    '''
+    def SubscribeFields(self, fieldGroup, updateFreq, maxKeepAge, maxKeepSamples, callback, userData):
+        return dcgm_agent.dcgmFieldValueStreamSubscribe(self._dcgmHandle.handle, self._groupId, fieldGroup.fieldGroupId,
+                                                        updateFreq, maxKeepAge, maxKeepSamples, callback, userData)
+
+    '''
+    Stop a stream started by SubscribeFields() and remove its watches
+    '''
+    def UnsubscribeFields(self, streamId):
+        dcgm_agent.dcgmFieldValueStreamUnsubscribe(self._dcgmHandle.handle, streamId)
+
     '''
     Get the most recent values for each field in a field collection
 
@@ -481,9 +501,9 @@ class DcgmGroupProfiling:
 
     Returns a dcgm_structs.c_dcgmProfWatchFields_v1 instance
     '''
-    def WatchFields(self, fieldIds, updateFreq, maxKeepAge, maxKeepSamples):
+    def WatchFields(self, fieldIds, updateFreq, maxKeepAge, maxKeepSamples, flags=0):
         ret = dcgm_agent.dcgmProfWatchFields(self._dcgmHandle.handle, fieldIds, self._groupId, 
-                                             updateFreq, maxKeepAge, maxKeepSamples)
+                                             updateFreq, maxKeepAge, maxKeepSamples, flags)
         return ret
     
     '''
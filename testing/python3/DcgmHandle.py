@@ -23,7 +23,8 @@ class DcgmHandle:
 
     def __init__(self, handle=None, ipAddress=None,
                  opMode=dcgm_structs.DCGM_OPERATION_MODE_AUTO, persistAfterDisconnect=False,
-                 unixSocketPath=None, timeoutMs=0):
+                 unixSocketPath=None, timeoutMs=0, useSharedMemory=False,
+                 compression=dcgm_structs.DCGM_TRANSPORT_COMPRESSION_NONE, compressionThreshold=0):
         '''
         Constructor
 
@@ -35,6 +36,10 @@ class DcgmHandle:
         unixSocketPath is a path to a path on the local filesystem that is a unix socket that the host engine is listening on.
                        This option is mutually exclusive with ipAddress
         timeoutMs is how long to wait for TCP/IP or Unix domain connections to establish in ms. 0=Default timeout (5000ms)
+        useSharedMemory (unix socket connections only) is whether to exchange messages with the host engine through
+                        shared memory instead of the socket. Falls back to the socket if the host engine can't
+        compression (ipAddress connections only) is the DCGM_TRANSPORT_COMPRESSION_? to compress messages with.
+                    Messages smaller than compressionThreshold bytes are sent as they are. 0=The host engine's default
         '''
         self._handleCreated = False
         self._persistAfterDisconnect = persistAfterDisconnect
@@ -61,7 +66,7 @@ class DcgmHandle:
             return        
         
         #Set up connection parameters. We're connecting to something
-        connectParams = dcgm_structs.c_dcgmConnectV2Params_v2()
+        connectParams = dcgm_structs.c_dcgmConnectV2Params_v4()
         connectParams.version = dcgm_structs.c_dcgmConnectV2Params_version
         connectParams.timeoutMs = timeoutMs
         if self._persistAfterDisconnect:
@@ -72,9 +77,12 @@ class DcgmHandle:
         if ipAddress is not None:
             connectToAddress = ipAddress
             connectParams.addressIsUnixSocket = 0
+            connectParams.compression = compression
+            connectParams.compressionThreshold = compressionThreshold
         else:
             connectToAddress = unixSocketPath
             connectParams.addressIsUnixSocket = 1
+            connectParams.useSharedMemory = 1 if useSharedMemory else 0
         
         self.handle = dcgm_agent.dcgmConnect_v2(connectToAddress, connectParams)
         self.isEmbedded = False
@@ -17,6 +17,9 @@ import pydcgm
 import dcgm_structs
 import threading
 import dcgm_fields
+import dcgm_agent
+import dcgm_field_helpers
+import ctypes
 import sys
 import logging
 
@@ -66,6 +69,13 @@ def entity_group_id_to_string(entityGroupId):
     else:
         return ''
 
+def py_helper_dcgm_reader_stream_callback(entityGroupId, entityId, values, numValues, userData):
+    userData = ctypes.cast(userData, ctypes.py_object).value
+    userData.QueueStreamedValues(entityGroupId, entityId, values, numValues)
+    return 0
+
+helper_dcgm_reader_stream_callback = dcgm_agent.dcgmFieldValueEntityEnumeration_f(py_helper_dcgm_reader_stream_callback)
+
 class DcgmReader(object):
     ###########################################################################
     '''
@@ -169,10 +179,13 @@ class DcgmReader(object):
     maxKeepAge      : Max time to keep data from NVML, in seconds. Default is 3600.0 (1 hour)
     ignoreList      : List of the field ids we want to query but not publish.
     gpuIds          : List of GPU IDs to monitor. If not provided, DcgmReader will monitor all GPUs on the system
+    subscribe       : Have nv-hostengine push every sample to us instead of reading the latest ones. Process()
+                      then hands the data handlers each sample taken since the last call, oldest first, and
+                      skips them if there are none. Falls back to reading if the host engine can't stream
     '''
     def __init__(self, hostname='localhost', fieldIds=None, updateFrequency=10000000,
                  maxKeepAge=3600.0, ignoreList=None, fieldGroupName='dcgm_fieldgroupData', gpuIds=None,
-                 entities=None):
+                 entities=None, subscribe=False):
         fieldIds = fieldIds or defaultFieldIds
         ignoreList = ignoreList or []
         self.m_dcgmHostName = hostname
@@ -195,6 +208,13 @@ class DcgmReader(object):
         self.m_lock = threading.Lock() #DCGM connection start-up/shutdown is not thread safe. Just lock pessimistically
         self.m_debug = False
 
+        self.m_subscribe = subscribe
+        self.m_streamId = None #Stream of our field group while subscribed
+        self.m_streamCondition = threading.Condition() #Protects m_streamedValues and m_stopThread
+        self.m_streamedValues = [] #(entityGroupId, entityId, [DcgmFieldValue]) pushed since the last Process()
+        self.m_thread = None
+        self.m_stopThread = False
+
     ###########################################################################
     '''
     Define what should happen to this object at the beginning of a with
@@ -238,6 +258,13 @@ class DcgmReader(object):
     Delete the dcgm group, dcgm system and dcgm handle and clear the attributes on shutdown.
     '''
     def SetDisconnected(self):
+        if self.m_streamId is not None:
+            try:
+                self.m_dcgmGroup.samples.UnsubscribeFields(self.m_streamId)
+            except dcgm_structs.DCGMError:
+                pass #The stream ends with the connection anyway
+            self.m_streamId = None
+
         #Force destructors since DCGM currently doesn't support more than one client connection per process
         if self.m_dcgmGroup is not None:
             del(self.m_dcgmGroup)
@@ -255,10 +282,54 @@ class DcgmReader(object):
     dcgm handle and dcgm group.
     '''
     def Shutdown(self):
+        self.Stop()
         with self.m_lock:
             if self.m_closeHandle == True:
                 self.SetDisconnected()
 
+    ###########################################################################
+    '''
+    Call Process() on a background thread until Stop() or Shutdown() is called. When subscribed, data is
+    handled as soon as it is pushed. Otherwise, it is read every updateFrequency. The data handlers are invoked
+    on that thread
+    '''
+    def Start(self):
+        if self.m_thread is not None:
+            return
+
+        self.m_stopThread = False
+        self.m_thread = threading.Thread(target=self._ProcessLoop, name='DcgmReader')
+        self.m_thread.daemon = True
+        self.m_thread.start()
+
+    ###########################################################################
+    '''
+    Stop the thread started by Start() and wait for it
+    '''
+    def Stop(self):
+        if self.m_thread is None:
+            return
+
+        with self.m_streamCondition:
+            self.m_stopThread = True
+            self.m_streamCondition.notify()
+        self.m_thread.join()
+        self.m_thread = None
+
+    ###########################################################################
+    def _ProcessLoop(self):
+        waitSec = self.m_updateFreq / 1000000.0
+        while True:
+            with self.m_streamCondition:
+                if self.m_streamId is not None:
+                    #Only wake up early for pushed values. The timeout lets Process() reconnect
+                    self.m_streamCondition.wait_for(lambda: self.m_stopThread or self.m_streamedValues, waitSec)
+                else:
+                    self.m_streamCondition.wait_for(lambda: self.m_stopThread, waitSec)
+                if self.m_stopThread:
+                    return
+            self.Process()
+
     ############################################################################
     '''
     Turns debugging output on
@@ -338,9 +409,57 @@ class DcgmReader(object):
     '''
     def AddFieldWatches(self):
         maxKeepSamples = 0 #No limit. Handled by m_maxKeepAge
-        self.m_dcgmGroup.samples.WatchFields(self.m_fieldGroup, self.m_updateFreq, self.m_maxKeepAge, maxKeepSamples)
+        if self.m_subscribe:
+            try:
+                self.m_streamId = self.m_dcgmGroup.samples.SubscribeFields(self.m_fieldGroup, self.m_updateFreq,
+                                                                           self.m_maxKeepAge, maxKeepSamples,
+                                                                           helper_dcgm_reader_stream_callback, self)
+            except dcgm_structs.dcgmExceptionClass(dcgm_structs.DCGM_ST_CONNECTION_NOT_VALID):
+                raise
+            except dcgm_structs.DCGMError as e:
+                self.LogError("Can't subscribe to field values (%s). Reading them instead." % str(e))
+                self.m_subscribe = False
+
+        if not self.m_subscribe:
+            self.m_dcgmGroup.samples.WatchFields(self.m_fieldGroup, self.m_updateFreq, self.m_maxKeepAge, maxKeepSamples)
         self.m_dcgmSystem.UpdateAllFields(1)
 
+    ###########################################################################
+    '''
+    Queue values pushed by our stream for the next Process(). Called on a DCGM thread, so it only copies them
+    '''
+    def QueueStreamedValues(self, entityGroupId, entityId, values, numValues):
+        fvs = [dcgm_field_helpers.DcgmFieldValue(values[i]) for i in range(numValues)]
+        with self.m_streamCondition:
+            self.m_streamedValues.append((entityGroupId, entityId, fvs))
+            self.m_streamCondition.notify()
+
+    ###########################################################################
+    '''
+    Take the queued values in the format of GetLatest().values (gpuId -> fieldId -> values) or, if
+    entitiesFormat, of GetLatest_v2().values (entityGroupId -> entityId -> fieldId -> values)
+    '''
+    def TakeStreamedValues(self, entitiesFormat):
+        with self.m_streamCondition:
+            streamedValues = self.m_streamedValues
+            self.m_streamedValues = []
+
+        values = {}
+        for entityGroupId, entityId, fvs in streamedValues:
+            if entitiesFormat:
+                entityValues = values.setdefault(entityGroupId, {}).setdefault(entityId, {})
+            elif entityGroupId == dcgm_fields.DCGM_FE_GPU:
+                entityValues = values.setdefault(entityId, {})
+            else:
+                continue
+
+            for fv in fvs:
+                if fv.fieldId not in entityValues:
+                    entityValues[fv.fieldId] = dcgm_field_helpers.DcgmFieldValueTimeSeries()
+                entityValues[fv.fieldId].InsertValue(fv)
+
+        return values
+
     ###########################################################################
     '''
     If the groupID already exists, we delete that group and create a new fieldgroup with
@@ -371,12 +490,24 @@ class DcgmReader(object):
     @params:
     self.m_dcgmGroup.samples.GetLatest(self.m_fieldGroup).values : The field values for each field. This dictionary contains fieldInfo
                                                                    for each field id requested to be watches.
+    When subscribed, the values are the ones pushed since the last call instead, and the handler isn't called if
+    there are none.
     '''
     def Process(self):
         with self.m_lock:
             try:
                 self.Reconnect()
-                if not self.m_requestedEntities:
+                if self.m_streamId is not None:
+                    fvs = self.TakeStreamedValues(bool(self.m_requestedEntities))
+                    if not fvs:
+                        #Nothing was pushed. Make sure that isn't because the connection is gone
+                        self.m_dcgmGroup.GetGpuIds()
+                        return None
+                    elif not self.m_requestedEntities:
+                        return self.CustomDataHandler(fvs)
+                    else:
+                        return self.CustomDataHandler_v2(fvs)
+                elif not self.m_requestedEntities:
                     return self.CustomDataHandler(self.m_dcgmGroup.samples.GetLatest(self.m_fieldGroup).values)
                 else:
                     return self.CustomDataHandler_v2(self.m_dcgmGroup.samples.GetLatest_v2(self.m_fieldGroup).values)
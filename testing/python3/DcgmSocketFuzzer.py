@@ -231,6 +231,7 @@ def testModuleCommandBodyGarbage():
         [0xb0, dcgm_structs.DcgmModuleIdPolicy, 2, 0x10000b0], #DCGM_POLICY_SR_SET_POLICY
         [0x28,  dcgm_structs.DcgmModuleIdPolicy, 3, 0x1000028], #DCGM_POLICY_SR_REGISTER
         [0x28, dcgm_structs.DcgmModuleIdPolicy, 4, 0x1000028], #DCGM_POLICY_SR_UNREGISTER
+        [0x38, dcgm_structs.DcgmModuleIdPolicy, 5, 0x2000038], #DCGM_POLICY_SR_REGISTER_V2
         #Profiling
         [0x120, dcgm_structs.DcgmModuleIdProfiling, 1, 0x1000120], #DCGM_PROFILING_SR_GET_MGS
         [0x68,  dcgm_structs.DcgmModuleIdProfiling, 2, 0x1000068], #DCGM_PROFILING_SR_WATCH_FIELDS
@@ -260,7 +261,7 @@ def testModuleCommandBodyGarbage():
         [0x1c,    dcgm_structs.DcgmModuleIdCore, 1,  0x100001c], #DCGM_CORE_SR_CLIENT_DISCONNECT
         [0x20,    dcgm_structs.DcgmModuleIdCore, 2,  0x1000020], #DCGM_CORE_SR_SET_LOGGING_SEVERITY
         [0x1c,    dcgm_structs.DcgmModuleIdCore, 3,  0x100001c], #DCGM_CORE_SR_GROUP_REMOVED
-        [0x28,    dcgm_structs.DcgmModuleIdCore, 4,  0x1000028], #DCGM_CORE_SR_FIELD_VALUES_UPDATED
+        [0x30,    dcgm_structs.DcgmModuleIdCore, 4,  0x2000030], #DCGM_CORE_SR_FIELD_VALUES_UPDATED
         [0x18,    dcgm_structs.DcgmModuleIdCore, 5,  0x1000018], #DCGM_CORE_SR_LOGGING_CHANGED
         [0x1c,    dcgm_structs.DcgmModuleIdCore, 6,  0x100001c], #DCGM_CORE_SR_MIG_UPDATED
         [0x2c,    dcgm_structs.DcgmModuleIdCore, 7,  0x100002c], #DCGM_CORE_SR_MIG_ENTITY_CREATE
@@ -307,6 +308,23 @@ def testModuleCommandBodyGarbage():
         [0x20,    dcgm_structs.DcgmModuleIdCore, 48 ,0x1000020], #DCGM_CORE_SR_HOSTENGINE_HEALTH
         [0x8428,  dcgm_structs.DcgmModuleIdCore, 49, 0x1008428], #DCGM_CORE_SR_FIELDGROUP_GET_ALL
         [0x11f28, dcgm_structs.DcgmModuleIdCore, 50, 0x1011f28], #DCGM_CORE_SR_GET_GPU_INSTANCE_HIERARCHY
+        [0x360,   dcgm_structs.DcgmModuleIdCore, 55, 0x2000360], #DCGM_CORE_SR_GET_MULTIPLE_LATEST_VALUES
+        [0x68,    dcgm_structs.DcgmModuleIdCore, 56, 0x2000068], #DCGM_CORE_SR_GET_FIELD_MULTIPLE_VALUES
+        [0x98,    dcgm_structs.DcgmModuleIdCore, 57, 0x2000098], #DCGM_CORE_SR_GET_TRANSPORT_STATS
+        [0x28,    dcgm_structs.DcgmModuleIdCore, 58, 0x1000028], #DCGM_CORE_SR_ATTRIBUTE_CACHE_SUBSCRIBE
+        [0x58,    dcgm_structs.DcgmModuleIdCore, 59, 0x1000058], #DCGM_CORE_SR_PROXY_STREAM_SUBSCRIBE
+        [0x20,    dcgm_structs.DcgmModuleIdCore, 60, 0x1000020], #DCGM_CORE_SR_PROXY_STREAM_UNSUBSCRIBE
+        [0x9428,  dcgm_structs.DcgmModuleIdCore, 61, 0x1009428], #DCGM_CORE_SR_PROXY_GET_HOSTS
+        [0x268,   dcgm_structs.DcgmModuleIdCore, 62, 0x1000268], #DCGM_CORE_SR_GET_WORKER_STATS
+        [0xe830,  dcgm_structs.DcgmModuleIdCore, 63, 0x100e830], #DCGM_CORE_SR_GET_REQUEST_STATS
+        [0xe30,   dcgm_structs.DcgmModuleIdCore, 64, 0x1000e30], #DCGM_CORE_SR_GET_MEMORY_ACCOUNTING
+        [0x28,    dcgm_structs.DcgmModuleIdCore, 65, 0x1000028], #DCGM_CORE_SR_SESSION_GET_TOKEN
+        [0x28,    dcgm_structs.DcgmModuleIdCore, 66, 0x1000028], #DCGM_CORE_SR_SESSION_RESUME
+        [0x2c78,  dcgm_structs.DcgmModuleIdCore, 67, 0x1002c78], #DCGM_CORE_SR_ESTIMATE_WATCH_COST
+        [0x28,    dcgm_structs.DcgmModuleIdCore, 68, 0x1000028], #DCGM_CORE_SR_INJECT_FIELD_VALUES
+        [0x1718,  dcgm_structs.DcgmModuleIdCore, 69, 0x1001718], #DCGM_CORE_SR_JOB_GET_PERCENTILES
+        [0x3b0,   dcgm_structs.DcgmModuleIdCore, 70, 0x10003b0], #DCGM_CORE_SR_GET_LATEST_VALUES_MATRIX
+        [0x9910,  dcgm_structs.DcgmModuleIdCore, 73, 0x1009910], #DCGM_CORE_SR_JOB_GET_STATS_SINCE
     ]
 
     while time.time() - startTime < duration:
@@ -202,7 +202,7 @@ class DcgmSystemIntrospectExecTime:
         fieldGroup:        DcgmFieldGroup() instance
         waitIfNoData:      wait for metadata to be updated if it's not available
                       
-        Returns a dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v2 object
+        Returns a dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v4 object
         Raises an exception for DCGM_ST_NOT_WATCHED if the field group is not watched.
         Raises an exception for DCGM_ST_NO_DATA if no data is available yet and \ref waitIfNoData is False
         '''
@@ -222,7 +222,7 @@ class DcgmSystemIntrospectExecTime:
         
         waitIfNoData:      wait for metadata to be updated if it's not available
                       
-        Returns a dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v2 object
+        Returns a dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v4 object
         Raises an exception for DCGM_ST_NOT_WATCHED if the field group is not watched.
         Raises an exception for DCGM_ST_NO_DATA if no data is available yet and \ref waitIfNoData is False
         '''
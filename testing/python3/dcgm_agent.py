@@ -105,6 +105,13 @@ def dcgmConnect_v2(ip_address, connectParams, version=dcgm_structs.c_dcgmConnect
     dcgm_structs._dcgmCheckReturn(ret)
     return dcgm_handle
 
+def dcgmConnectShared(dcgm_handle, persistAfterDisconnect=0):
+    shared_handle = c_void_p()
+    fn = dcgmFP("dcgmConnectShared")
+    ret = fn(dcgm_handle, c_uint(persistAfterDisconnect), byref(shared_handle))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return shared_handle
+
 @ensure_byte_strings()
 def dcgmDisconnect(dcgm_handle):
     fn = dcgmFP("dcgmDisconnect")
@@ -112,6 +119,34 @@ def dcgmDisconnect(dcgm_handle):
     dcgm_structs._dcgmCheckReturn(ret)
     return ret
 
+@ensure_byte_strings()
+def dcgmGetTransportStats(dcgm_handle):
+    stats = dcgm_structs.c_dcgmTransportStats_v2()
+    stats.version = dcgm_structs.c_dcgmTransportStats_version
+    fn = dcgmFP("dcgmGetTransportStats")
+    ret = fn(dcgm_handle, byref(stats))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return stats
+
+def dcgmClientCacheEnable(dcgm_handle):
+    fn = dcgmFP("dcgmClientCacheEnable")
+    ret = fn(dcgm_handle)
+    dcgm_structs._dcgmCheckReturn(ret)
+    return ret
+
+def dcgmSessionGetToken(dcgm_handle):
+    c_token = c_ulonglong()
+    fn = dcgmFP("dcgmSessionGetToken")
+    ret = fn(dcgm_handle, byref(c_token))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return c_token.value
+
+def dcgmSessionResume(dcgm_handle, token):
+    fn = dcgmFP("dcgmSessionResume")
+    ret = fn(dcgm_handle, c_ulonglong(token))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return ret
+
 @ensure_byte_strings()
 def dcgmGetAllSupportedDevices(dcgm_handle):
     c_count = c_uint()
@@ -141,6 +176,17 @@ def dcgmGetDeviceAttributes(dcgm_handle, gpuId):
     dcgm_structs._dcgmCheckReturn(ret)
     return device_values
 
+@ensure_byte_strings()
+def dcgmGetDeviceAttributesBulk(dcgm_handle, gpuIds):
+    fn = dcgmFP("dcgmGetDeviceAttributesBulk")
+    c_gpuIds = (c_uint32 * len(gpuIds))(*gpuIds)
+    device_values = (dcgm_structs.c_dcgmDeviceAttributes_v2 * len(gpuIds))()
+    for device_value in device_values:
+        device_value.version = dcgm_structs.dcgmDeviceAttributes_version2
+    ret = fn(dcgm_handle, c_gpuIds, c_uint32(len(gpuIds)), device_values)
+    dcgm_structs._dcgmCheckReturn(ret)
+    return list(device_values)
+
 @ensure_byte_strings()
 def dcgmGetEntityGroupEntities(dcgm_handle, entityGroup, flags):
     capacity = dcgm_structs.DCGM_GROUP_MAX_ENTITIES
@@ -401,6 +447,8 @@ def dcgmPolicySet(dcgm_handle, group_id, policy, status_handle):
 #First parameter below is the return type
 dcgmFieldValueEnumeration_f = CFUNCTYPE(c_int32, c_uint32, POINTER(dcgm_structs.c_dcgmFieldValue_v1), c_int32, c_void_p)
 dcgmFieldValueEntityEnumeration_f = CFUNCTYPE(c_int32, c_uint32, c_uint32, POINTER(dcgm_structs.c_dcgmFieldValue_v1), c_int32, c_void_p)
+dcgmProxyFieldValueEnumeration_f = CFUNCTYPE(c_int32, c_uint32, c_uint32, c_uint32, POINTER(dcgm_structs.c_dcgmFieldValue_v1), c_int32, c_void_p)
+dcgmRequestComplete_f = CFUNCTYPE(None, c_int32, c_void_p)
 
 @ensure_byte_strings()
 def dcgmGetValuesSince(dcgm_handle, groupId, fieldGroupId, sinceTimestamp, enumCB, userData):
@@ -418,6 +466,71 @@ def dcgmGetValuesSince_v2(dcgm_handle, groupId, fieldGroupId, sinceTimestamp, en
     dcgm_structs._dcgmCheckReturn(ret)
     return c_nextSinceTimestamp.value
 
+@ensure_byte_strings()
+def dcgmGetValuesSinceBucketed(dcgm_handle, groupId, fieldGroupId, sinceTimestamp, bucketWidthUsec, aggregation, enumCB, userData):
+    fn = dcgmFP("dcgmGetValuesSinceBucketed")
+    c_nextSinceTimestamp = c_int64()
+    ret = fn(dcgm_handle, groupId, fieldGroupId, c_int64(sinceTimestamp), c_int64(bucketWidthUsec), c_int32(aggregation), byref(c_nextSinceTimestamp), enumCB, py_object(userData))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return c_nextSinceTimestamp.value
+
+@ensure_byte_strings()
+def dcgmFieldValueStreamSubscribe(dcgm_handle, groupId, fieldGroupId, updateFreq, maxKeepAge, maxKeepSamples, callback, userData, maxBatchesInFlight=0, maxPendingValues=0):
+    fn = dcgmFP("dcgmFieldValueStreamSubscribe")
+    params = dcgm_structs.c_dcgmFieldValueStreamParams_v1()
+    params.version = dcgm_structs.dcgmFieldValueStreamParams_version1
+    params.groupId = groupId
+    params.fieldGroupId = fieldGroupId
+    params.updateFreq = updateFreq
+    params.maxKeepAge = maxKeepAge
+    params.maxKeepSamples = maxKeepSamples
+    params.maxBatchesInFlight = maxBatchesInFlight
+    params.maxPendingValues = maxPendingValues
+    c_streamId = c_uint32()
+    ret = fn(dcgm_handle, byref(params), callback, py_object(userData), byref(c_streamId))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return c_streamId.value
+
+@ensure_byte_strings()
+def dcgmFieldValueStreamUnsubscribe(dcgm_handle, streamId):
+    fn = dcgmFP("dcgmFieldValueStreamUnsubscribe")
+    ret = fn(dcgm_handle, c_uint32(streamId))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return ret
+
+@ensure_byte_strings()
+def dcgmProxyStreamSubscribe(dcgm_handle, groupId, fieldGroupId, updateFreq, maxKeepAge, maxKeepSamples, callback, userData, maxBatchesInFlight=0, maxPendingValues=0):
+    fn = dcgmFP("dcgmProxyStreamSubscribe")
+    params = dcgm_structs.c_dcgmFieldValueStreamParams_v1()
+    params.version = dcgm_structs.dcgmFieldValueStreamParams_version1
+    params.groupId = groupId
+    params.fieldGroupId = fieldGroupId
+    params.updateFreq = updateFreq
+    params.maxKeepAge = maxKeepAge
+    params.maxKeepSamples = maxKeepSamples
+    params.maxBatchesInFlight = maxBatchesInFlight
+    params.maxPendingValues = maxPendingValues
+    c_streamId = c_uint32()
+    ret = fn(dcgm_handle, byref(params), callback, py_object(userData), byref(c_streamId))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return c_streamId.value
+
+@ensure_byte_strings()
+def dcgmProxyStreamUnsubscribe(dcgm_handle, streamId):
+    fn = dcgmFP("dcgmProxyStreamUnsubscribe")
+    ret = fn(dcgm_handle, c_uint32(streamId))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return ret
+
+@ensure_byte_strings()
+def dcgmProxyGetHosts(dcgm_handle):
+    fn = dcgmFP("dcgmProxyGetHosts")
+    hosts = dcgm_structs.c_dcgmProxyHosts_v1()
+    hosts.version = dcgm_structs.dcgmProxyHosts_version1
+    ret = fn(dcgm_handle, byref(hosts))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return hosts
+
 @ensure_byte_strings()
 def dcgmGetLatestValues(dcgm_handle, groupId, fieldGroupId, enumCB, userData):
     fn = dcgmFP("dcgmGetLatestValues")
@@ -439,6 +552,26 @@ def dcgmWatchFields(dcgm_handle, groupId, fieldGroupId, updateFreq, maxKeepAge,
     dcgm_structs._dcgmCheckReturn(ret)
     return ret
 
+@ensure_byte_strings()
+def dcgmWatchFieldsSnapshot(dcgm_handle, groupId, fieldGroupId, updateFreq, maxKeepAge, maxKeepSamples):
+    fn = dcgmFP("dcgmWatchFieldsSnapshot")
+    ret = fn(dcgm_handle, groupId, fieldGroupId, c_int64(updateFreq), c_double(maxKeepAge), c_int32(maxKeepSamples))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return ret
+
+@ensure_byte_strings()
+def dcgmSetDerivedField(dcgm_handle, fieldId, expression):
+    fn = dcgmFP("dcgmSetDerivedField")
+
+    derivedField = dcgm_structs.c_dcgmDerivedField_v1()
+    derivedField.version = dcgm_structs.dcgmDerivedField_version1
+    derivedField.fieldId = fieldId
+    derivedField.expression = expression
+
+    ret = fn(dcgm_handle, byref(derivedField))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return derivedField
+
 @ensure_byte_strings()
 def dcgmUnwatchFields(dcgm_handle, groupId, fieldGroupId):
     fn = dcgmFP("dcgmUnwatchFields")
@@ -487,6 +620,16 @@ def dcgmHealthCheck(dcgm_handle, groupId, version=dcgm_structs.dcgmHealthRespons
     dcgm_structs._dcgmCheckReturn(ret)
     return c_results
 
+# The returned results are filled in when callback is invoked. Keep them and callback alive until then
+@ensure_byte_strings()
+def dcgmHealthCheckAsync(dcgm_handle, groupId, callback, userData):
+    c_results = dcgm_structs.c_dcgmHealthResponse_v4()
+    c_results.version = dcgm_structs.dcgmHealthResponse_version4
+    fn = dcgmFP("dcgmHealthCheckAsync")
+    ret = fn(dcgm_handle, groupId, byref(c_results), callback, py_object(userData))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return c_results
+
 @ensure_byte_strings()
 def dcgmPolicyRegister(dcgm_handle, groupId, condition, beginCallback, finishCallback):
     fn = dcgmFP("dcgmPolicyRegister")
@@ -494,6 +637,21 @@ def dcgmPolicyRegister(dcgm_handle, groupId, condition, beginCallback, finishCal
     dcgm_structs._dcgmCheckReturn(ret)
     return ret
 
+@ensure_byte_strings()
+def dcgmPolicyRegister_v2(dcgm_handle, groupId, condition, beginCallback, finishCallback, coalesceWindowUsec=0, maxNotificationsPerSec=0):
+    params = dcgm_structs.c_dcgmPolicyRegisterParams_v1()
+    params.version = dcgm_structs.dcgmPolicyRegisterParams_version1
+    params.groupId = groupId
+    params.condition = condition
+    params.beginCallback = cast(beginCallback, c_void_p)
+    params.finishCallback = cast(finishCallback, c_void_p)
+    params.coalesceWindowUsec = coalesceWindowUsec
+    params.maxNotificationsPerSec = maxNotificationsPerSec
+    fn = dcgmFP("dcgmPolicyRegister_v2")
+    ret = fn(dcgm_handle, byref(params))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return ret
+
 @ensure_byte_strings()
 def dcgmPolicyUnregister(dcgm_handle, groupId, condition):
     fn = dcgmFP("dcgmPolicyUnregister")
@@ -585,6 +743,15 @@ def dcgmGetDeviceTopology(dcgm_handle, gpuId):
     dcgm_structs._dcgmCheckReturn(ret)
     return devtopo
 
+@ensure_byte_strings()
+def dcgmGetDeviceTopologyBulk(dcgm_handle, gpuIds):
+    devtopos = (dcgm_structs.c_dcgmDeviceTopology_v1 * len(gpuIds))()
+    c_gpuIds = (c_uint32 * len(gpuIds))(*gpuIds)
+    fn = dcgmFP("dcgmGetDeviceTopologyBulk")
+    ret = fn(dcgm_handle, c_gpuIds, c_uint32(len(gpuIds)), devtopos)
+    dcgm_structs._dcgmCheckReturn(ret)
+    return list(devtopos)
+
 @ensure_byte_strings()
 def dcgmGetGroupTopology(dcgm_handle, groupId):
     grouptopo = dcgm_structs.c_dcgmGroupTopology_v1()
@@ -625,6 +792,44 @@ def dcgmJobGetStats(dcgm_handle, jobid):
     dcgm_structs._dcgmCheckReturn(ret)
     return jobInfo
 
+# Returns (jobInfo, updateSequence). jobInfo is None if the job didn't change since updateSequence
+@ensure_byte_strings()
+def dcgmJobGetStatsSince(dcgm_handle, jobid, updateSequence=0):
+    fn = dcgmFP("dcgmJobGetStatsSince")
+    jobInfo = dcgm_structs.c_dcgmJobInfo_v3()
+
+    jobInfo.version = dcgm_structs.dcgmJobInfo_version3
+    c_updateSequence = c_ulonglong(updateSequence)
+
+    ret = fn(dcgm_handle, jobid, byref(c_updateSequence), byref(jobInfo))
+    dcgm_structs._dcgmCheckReturn(ret)
+    if c_updateSequence.value == updateSequence:
+        return None, updateSequence
+    return jobInfo, c_updateSequence.value
+
+@ensure_byte_strings()
+def dcgmJobGetPercentiles(dcgm_handle, jobid):
+    fn = dcgmFP("dcgmJobGetPercentiles")
+    percentiles = dcgm_structs.c_dcgmJobPercentiles_v1()
+
+    percentiles.version = dcgm_structs.dcgmJobPercentiles_version1
+
+    ret = fn(dcgm_handle, jobid, byref(percentiles))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return percentiles
+
+# The returned jobInfo is filled in when callback is invoked. Keep it and callback alive until then
+@ensure_byte_strings()
+def dcgmJobGetStatsAsync(dcgm_handle, jobid, callback, userData):
+    fn = dcgmFP("dcgmJobGetStatsAsync")
+    jobInfo = dcgm_structs.c_dcgmJobInfo_v3()
+
+    jobInfo.version = dcgm_structs.dcgmJobInfo_version3
+
+    ret = fn(dcgm_handle, jobid, byref(jobInfo), callback, py_object(userData))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return jobInfo
+
 @ensure_byte_strings()
 def dcgmJobRemove(dcgm_handle, jobid):
     fn = dcgmFP("dcgmJobRemove")
@@ -668,12 +873,23 @@ def dcgmIntrospectGetHostengineCpuUtilization(dcgm_handle, waitIfNoData=True):
     dcgm_structs._dcgmCheckReturn(ret)
     return cpuUtil
 
+@ensure_byte_strings()
+def dcgmIntrospectGetHostengineThreadCpuUtilization(dcgm_handle, waitIfNoData=True):
+    fn = dcgmFP("dcgmIntrospectGetHostengineThreadCpuUtilization")
+
+    cpuUtil = dcgm_structs.c_dcgmIntrospectThreadCpuUtil_v1()
+    cpuUtil.version = dcgm_structs.dcgmIntrospectThreadCpuUtil_version1
+
+    ret = fn(dcgm_handle, byref(cpuUtil), waitIfNoData)
+    dcgm_structs._dcgmCheckReturn(ret)
+    return cpuUtil
+
 @ensure_byte_strings()
 def dcgmIntrospectGetFieldsExecTime(dcgm_handle, introspectContext, waitIfNoData=True):
     fn = dcgmFP("dcgmIntrospectGetFieldsExecTime")
     
-    execTime = dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v2()
-    execTime.version = dcgm_structs.dcgmIntrospectFullFieldsExecTime_version2
+    execTime = dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v4()
+    execTime.version = dcgm_structs.dcgmIntrospectFullFieldsExecTime_version4
     
     ret = fn(dcgm_handle, byref(introspectContext), byref(execTime), waitIfNoData)
     dcgm_structs._dcgmCheckReturn(ret)
@@ -695,6 +911,44 @@ def dcgmIntrospectUpdateAll(dcgmHandle, waitForUpdate):
     fn = dcgmFP("dcgmIntrospectUpdateAll")
     ret = fn(dcgmHandle, c_int(waitForUpdate))
     dcgm_structs._dcgmCheckReturn(ret)
+
+@ensure_byte_strings()
+def dcgmIntrospectGetRequestStats(dcgm_handle, flags=0):
+    fn = dcgmFP("dcgmIntrospectGetRequestStats")
+
+    requestStats = dcgm_structs.c_dcgmIntrospectRequestStats_v1()
+    requestStats.version = dcgm_structs.dcgmIntrospectRequestStats_version1
+    requestStats.flags = flags
+
+    ret = fn(dcgm_handle, byref(requestStats))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return requestStats
+
+@ensure_byte_strings()
+def dcgmIntrospectGetMemoryAccounting(dcgm_handle):
+    fn = dcgmFP("dcgmIntrospectGetMemoryAccounting")
+
+    accounting = dcgm_structs.c_dcgmIntrospectMemoryAccounting_v1()
+    accounting.version = dcgm_structs.dcgmIntrospectMemoryAccounting_version1
+
+    ret = fn(dcgm_handle, byref(accounting))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return accounting
+
+def dcgmIntrospectEstimateWatchCost(dcgm_handle, groupId, fieldGroupId, updateFreq, maxKeepAge, maxKeepSamples):
+    fn = dcgmFP("dcgmIntrospectEstimateWatchCost")
+
+    cost = dcgm_structs.c_dcgmIntrospectWatchCost_v1()
+    cost.version = dcgm_structs.dcgmIntrospectWatchCost_version1
+    cost.groupId = groupId
+    cost.fieldGroupId = fieldGroupId
+    cost.updateFreq = updateFreq
+    cost.maxKeepAge = maxKeepAge
+    cost.maxKeepSamples = maxKeepSamples
+
+    ret = fn(dcgm_handle, byref(cost))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return cost
     
 @ensure_byte_strings()
 def dcgmEntityGetLatestValues(dcgmHandle, entityGroup, entityId, fieldIds):
@@ -716,6 +970,79 @@ def dcgmEntitiesGetLatestValues(dcgmHandle, entities, fieldIds, flags):
     dcgm_structs._dcgmCheckReturn(ret)
     return field_values
 
+# Returns (values, count, updateSequence). Pass updateSequence back in to only get what changed since
+@ensure_byte_strings()
+def dcgmEntitiesGetLatestValuesSince(dcgmHandle, entities, fieldIds, flags, updateSequence):
+    fn = dcgmFP("dcgmEntitiesGetLatestValuesSince")
+    numFvs =  len(fieldIds) * len(entities)
+    field_values = (dcgm_structs.c_dcgmFieldValue_v2 * numFvs)()
+    entities_values = (dcgm_structs.c_dcgmGroupEntityPair_t * len(entities))(*entities)
+    field_id_values = (c_uint16 * len(fieldIds))(*fieldIds)
+    c_updateSequence = c_uint64(updateSequence)
+    c_count = c_uint32(0)
+    ret = fn(dcgmHandle, entities_values, c_uint(len(entities)), field_id_values, c_uint(len(fieldIds)), flags, byref(c_updateSequence), field_values, byref(c_count))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return field_values, c_count.value, c_updateSequence.value
+
+# The returned values are filled in when callback is invoked. Keep them and callback alive until then
+@ensure_byte_strings()
+def dcgmEntitiesGetLatestValuesAsync(dcgmHandle, entities, fieldIds, flags, callback, userData):
+    fn = dcgmFP("dcgmEntitiesGetLatestValuesAsync")
+    numFvs =  len(fieldIds) * len(entities)
+    field_values = (dcgm_structs.c_dcgmFieldValue_v2 * numFvs)()
+    entities_values = (dcgm_structs.c_dcgmGroupEntityPair_t * len(entities))(*entities)
+    field_id_values = (c_uint16 * len(fieldIds))(*fieldIds)
+    ret = fn(dcgmHandle, entities_values, c_uint(len(entities)), field_id_values, c_uint(len(fieldIds)), flags, field_values, callback, py_object(userData))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return field_values
+
+# Returns (values, count, valuesSkipped). Pass the same cursor, a c_dcgmValuesCursor_t, to get the next page
+@ensure_byte_strings()
+def dcgmEntityGetValuesPage(dcgmHandle, entityGroup, entityId, fieldId, cursor, maxCount):
+    fn = dcgmFP("dcgmEntityGetValuesPage")
+    c_count = c_int32(maxCount)
+    c_valuesSkipped = c_int64(0)
+    field_values = (dcgm_structs.c_dcgmFieldValue_v1 * maxCount)()
+    ret = fn(dcgmHandle, c_uint(entityGroup), dcgm_fields.c_dcgm_field_eid_t(entityId), c_uint16(fieldId), byref(cursor), byref(c_count), field_values, byref(c_valuesSkipped))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return field_values, c_count.value, c_valuesSkipped.value
+
+# Fills timestamps and values in place from the numeric field's next page and returns (count, valuesSkipped).
+# Both must be writable buffers of 8 byte items that are the same length, like NumPy arrays of int64 timestamps
+# and of int64 or float64 values, depending on the field type. Nothing is copied through Python objects
+@ensure_byte_strings()
+def dcgmEntityGetValuesPageNumeric(dcgmHandle, entityGroup, entityId, fieldId, cursor, timestamps, values):
+    fn = dcgmFP("dcgmEntityGetValuesPageNumeric")
+    maxCount = memoryview(timestamps).nbytes // 8
+    if maxCount < 1 or memoryview(values).nbytes != maxCount * 8:
+        raise dcgm_structs.DCGMError(dcgm_structs.DCGM_ST_BADPARAM)
+    c_timestamps = (c_int64 * maxCount).from_buffer(timestamps)
+    c_values = (c_int64 * maxCount).from_buffer(values)
+    c_count = c_int32(maxCount)
+    c_valuesSkipped = c_int64(0)
+    ret = fn(dcgmHandle, c_uint(entityGroup), dcgm_fields.c_dcgm_field_eid_t(entityId), c_uint16(fieldId), byref(cursor), byref(c_count), c_timestamps, c_values, byref(c_valuesSkipped))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return c_count.value, c_valuesSkipped.value
+
+# Returns a dcgm_structs.c_dcgmLatestValuesMatrix_v1 of the latest values of fieldGroupId for the entities of groupId
+def dcgmGetLatestValuesMatrix(dcgmHandle, groupId, fieldGroupId):
+    fn = dcgmFP("dcgmGetLatestValuesMatrix")
+    matrix = dcgm_structs.c_dcgmLatestValuesMatrix_v1()
+    matrix.version = dcgm_structs.dcgmLatestValuesMatrix_version1
+    ret = fn(dcgmHandle, groupId, fieldGroupId, byref(matrix))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return matrix
+
+# Returns (count, values). Both are filled in when callback is invoked. Keep them and callback alive until then
+@ensure_byte_strings()
+def dcgmEntityGetValuesSinceAsync(dcgmHandle, entityGroup, entityId, fieldId, sinceTimestamp, maxCount, callback, userData):
+    fn = dcgmFP("dcgmEntityGetValuesSinceAsync")
+    c_count = c_int32(maxCount)
+    field_values = (dcgm_structs.c_dcgmFieldValue_v1 * maxCount)()
+    ret = fn(dcgmHandle, c_uint(entityGroup), dcgm_fields.c_dcgm_field_eid_t(entityId), c_uint16(fieldId), c_int64(sinceTimestamp), byref(c_count), field_values, callback, py_object(userData))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return c_count, field_values
+
 @ensure_byte_strings()
 def dcgmSelectGpusByTopology(dcgmHandle, inputGpuIds, numGpus, hintFlags):
     fn = dcgmFP("dcgmSelectGpusByTopology")
@@ -766,13 +1093,14 @@ def dcgmProfGetSupportedMetricGroups(dcgmHandle, groupId):
     return msg
 
 @ensure_byte_strings()
-def dcgmProfWatchFields(dcgmHandle, fieldIds, groupId, updateFreq, maxKeepAge, maxKeepSamples):
+def dcgmProfWatchFields(dcgmHandle, fieldIds, groupId, updateFreq, maxKeepAge, maxKeepSamples, flags=0):
     msg = dcgm_structs.c_dcgmProfWatchFields_v1()
     msg.version = dcgm_structs.dcgmProfWatchFields_version1
     msg.groupId = groupId
     msg.updateFreq = updateFreq
     msg.maxKeepAge = maxKeepAge
     msg.maxKeepSamples = maxKeepSamples
+    msg.flags = flags
     msg.numFieldIds = c_uint32(len(fieldIds))
     for i, fieldId in enumerate(fieldIds):
         msg.fieldIds[i] = fieldId
@@ -823,3 +1151,12 @@ def dcgmHostengineIsHealthy(dcgmHandle):
     ret = fn(dcgmHandle, byref(heHealth))
     dcgm_structs._dcgmCheckReturn(ret)
     return heHealth
+
+@ensure_byte_strings()
+def dcgmHostengineGetWorkerStats(dcgmHandle):
+    stats = dcgm_structs.c_dcgmHostengineWorkerStats_v1()
+    stats.version = dcgm_structs.dcgmHostengineWorkerStats_version1
+    fn = dcgmFP("dcgmHostengineGetWorkerStats")
+    ret = fn(dcgmHandle, byref(stats))
+    dcgm_structs._dcgmCheckReturn(ret)
+    return stats
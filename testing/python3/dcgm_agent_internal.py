@@ -91,6 +91,21 @@ def dcgmInjectEntityFieldValue(dcgmHandle, entityGroupId, entityId, value):
     _dcgmIntCheckReturn(ret)
     return ret
 
+# Inject many values at once. entityValues is a list of (entityGroupId, entityId, value) tuples
+# where value is a dcgmInjectFieldValue_t
+def dcgmInjectEntityFieldValues(dcgmHandle, entityValues):
+    count = len(entityValues)
+    entities = (dcgm_structs.c_dcgmGroupEntityPair_t * count)()
+    values = (dcgmInjectFieldValue_t * count)()
+    for i, (entityGroupId, entityId, value) in enumerate(entityValues):
+        entities[i].entityGroupId = entityGroupId
+        entities[i].entityId = entityId
+        values[i] = value
+    fn = dcgm_structs._dcgmGetFunctionPointer("dcgmInjectEntityFieldValues")
+    ret = fn(dcgmHandle, entities, values, c_uint(count))
+    _dcgmIntCheckReturn(ret)
+    return ret
+
 @dcgm_agent.ensure_byte_strings()
 def dcgmSetEntityNvLinkLinkState(dcgmHandle, entityGroupId, entityId, linkId, linkState):
     linkStateStruct = dcgm_structs_internal.c_dcgmSetNvLinkLinkState_v1()
@@ -107,7 +122,7 @@ def dcgmSetEntityNvLinkLinkState(dcgmHandle, entityGroupId, entityId, linkId, li
 @dcgm_agent.ensure_byte_strings()
 def dcgmGetCacheManagerFieldInfo(dcgmHandle, gpuId, fieldId):
     fn = dcgm_structs._dcgmGetFunctionPointer("dcgmGetCacheManagerFieldInfo")
-    cmfi = dcgm_structs_internal.dcgmCacheManagerFieldInfo_v3()
+    cmfi = dcgm_structs_internal.dcgmCacheManagerFieldInfo_v5()
 
     cmfi.gpuId = gpuId
     cmfi.fieldId = fieldId
@@ -117,6 +132,18 @@ def dcgmGetCacheManagerFieldInfo(dcgmHandle, gpuId, fieldId):
     return cmfi
 
 
+def dcgmTraceControl(dcgmHandle, action, numSpans=0):
+    fn = dcgm_structs._dcgmGetFunctionPointer("dcgmTraceControl")
+    traceControl = dcgm_structs_internal.c_dcgmTraceControl_v1()
+    traceControl.version = dcgm_structs_internal.dcgmTraceControl_version1
+    traceControl.action = action
+    traceControl.numSpans = numSpans
+
+    ret = fn(dcgmHandle, byref(traceControl))
+    _dcgmIntCheckReturn(ret)
+    return traceControl
+
+
 @dcgm_agent.ensure_byte_strings()
 def dcgmCreateFakeEntities(dcgmHandle, cfe):
     fn = dcgm_structs._dcgmGetFunctionPointer("dcgmCreateFakeEntities")
@@ -150,8 +177,8 @@ def dcgmMetadataStateSetRunInterval(dcgmHandle, runIntervalMs):
 def dcgmIntrospectGetFieldExecTime(dcgm_handle, fieldId, waitIfNoData=True):
     fn = dcgm_structs._dcgmGetFunctionPointer("dcgmIntrospectGetFieldExecTime")
     
-    execTime = dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v2()
-    execTime.version = dcgm_structs.dcgmIntrospectFullFieldsExecTime_version2
+    execTime = dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v4()
+    execTime.version = dcgm_structs.dcgmIntrospectFullFieldsExecTime_version4
     
     ret = fn(dcgm_handle, fieldId, byref(execTime), waitIfNoData)
     dcgm_structs._dcgmCheckReturn(ret)
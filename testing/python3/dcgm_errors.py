@@ -100,7 +100,8 @@ DCGM_FR_EMPTY_GPU_LIST                      = 82 # No GPU information given to p
 DCGM_FR_DBE_PENDING_PAGE_RETIREMENTS        = 83 # Pending page retirements due to a DBE
 DCGM_FR_UNCORRECTABLE_ROW_REMAP             = 84 # Uncorrectable row remapping
 DCGM_FR_PENDING_ROW_REMAP                   = 85 # Row remapping is pending
-DCGM_FR_ERROR_SENTINEL                      = 86 # MUST BE THE LAST ERROR CODE
+DCGM_FR_FIELD_ANOMALY                       = 86 # A field drifted away from its usual level
+DCGM_FR_ERROR_SENTINEL                      = 87 # MUST BE THE LAST ERROR CODE
 
 # Standard message for running a field diagnostic 
 TRIAGE_RUN_FIELD_DIAG_MSG = "Run a field diagnostic on the GPU."
@@ -250,6 +251,7 @@ DCGM_FR_EMPTY_GPU_LIST_MSG             = "No valid GPUs passed to plugin"
 DCGM_FR_DBE_PENDING_PAGE_RETIREMENTS_MSG  = "Pending page retirements together with a DBE were detected on GPU %u."
 DCGM_FR_UNCORRECTABLE_ROW_REMAP_MSG   = "GPU %u has uncorrectable row remappings"
 DCGM_FR_PENDING_ROW_REMAP_MSG         = "GPU %u has pending row remappings"
+DCGM_FR_FIELD_ANOMALY_MSG             = "The %s of GPU %u has %s from a baseline of %.1f to %.1f."
 
 # Suggestions for next steps for the corresponding error message
 DCGM_FR_OK_NEXT                       = "N/A"
@@ -357,6 +359,7 @@ DCGM_FR_EMPTY_GPU_LIST_NEXT           = ""
 DCGM_FR_DBE_PENDING_PAGE_RETIREMENTS_NEXT  = "Drain the GPU and reset it or reboot the node to resolve this issue."
 DCGM_FR_UNCORRECTABLE_ROW_REMAP_NEXT  = ""
 DCGM_FR_PENDING_ROW_REMAP_NEXT        = ""
+DCGM_FR_FIELD_ANOMALY_NEXT            = "Check the GPU cooling and workload. " + TRIAGE_RUN_FIELD_DIAG_MSG
 
 def dcgmErrorGetPriorityByCode(code):
     fn = dcgm_structs._dcgmGetFunctionPointer("dcgmErrorGetPriorityByCode")
@@ -106,6 +106,13 @@ DCGM_FI_NVML_VERSION            = 2   #Underlying NVML version
 DCGM_FI_PROCESS_NAME            = 3   #Process Name. Will be nv-hostengine or your process's name in embedded mode
 DCGM_FI_DEV_COUNT               = 4   #Number of Devices on the node
 DCGM_FI_CUDA_DRIVER_VERSION     = 5   #Cuda Driver Version as an integer. CUDA 11.1 = 11100
+#Hostengine self-telemetry
+DCGM_FI_HOSTENGINE_UPDATE_LOOP_USEC         = 20 #Duration of the most recent field cache update cycle in usec
+DCGM_FI_HOSTENGINE_UPDATE_OVERRUNS          = 21 #Update cycles that left no time to sleep before the next one
+DCGM_FI_HOSTENGINE_SUBSCRIBER_CALLBACK_USEC = 22 #Time the most recent update cycle spent notifying subscribers in usec
+DCGM_FI_HOSTENGINE_IPC_QUEUE_DEPTH          = 23 #Client requests waiting for a hostengine worker
+DCGM_FI_HOSTENGINE_CONNECTIONS              = 24 #Open connections of the hostengine
+DCGM_FI_HOSTENGINE_CACHE_BYTES              = 25 #Bytes of samples held by the field cache
 #Device attributes
 DCGM_FI_DEV_NAME                = 50  #Name of the GPU device
 DCGM_FI_DEV_BRAND               = 51  #Device Brand
@@ -195,6 +202,15 @@ DCGM_FI_DEV_TOTAL_BASE_CLOCKS_VIOLATION = 247 #Base Clocks Violation time in use
 DCGM_FI_DEV_FB_TOTAL            = 250 #Total framebuffer memory in MB
 DCGM_FI_DEV_FB_FREE             = 251 #Total framebuffer used in MB
 DCGM_FI_DEV_FB_USED             = 252 #Total framebuffer free in MB
+#Rates of counter fields, derived by the host engine
+DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION_RATE    = 270 #Rate of DCGM_FI_DEV_TOTAL_ENERGY_CONSUMPTION in W
+DCGM_FI_DEV_PCIE_REPLAY_RATE                 = 271 #Rate of DCGM_FI_DEV_PCIE_REPLAY_COUNTER per second
+DCGM_FI_DEV_ECC_SBE_AGG_RATE                 = 272 #Rate of DCGM_FI_DEV_ECC_SBE_AGG_TOTAL per second
+DCGM_FI_DEV_ECC_DBE_AGG_RATE                 = 273 #Rate of DCGM_FI_DEV_ECC_DBE_AGG_TOTAL per second
+DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_RATE_TOTAL = 274 #Rate of DCGM_FI_DEV_NVLINK_CRC_FLIT_ERROR_COUNT_TOTAL per second
+DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_RATE_TOTAL = 275 #Rate of DCGM_FI_DEV_NVLINK_CRC_DATA_ERROR_COUNT_TOTAL per second
+DCGM_FI_DEV_NVLINK_REPLAY_ERROR_RATE_TOTAL   = 276 #Rate of DCGM_FI_DEV_NVLINK_REPLAY_ERROR_COUNT_TOTAL per second
+DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_RATE_TOTAL = 277 #Rate of DCGM_FI_DEV_NVLINK_RECOVERY_ERROR_COUNT_TOTAL per second
 #Device ECC Counters
 DCGM_FI_DEV_ECC_CURRENT         = 300 #Current ECC mode for the device
 DCGM_FI_DEV_ECC_PENDING         = 301 #Pending ECC mode for the device
@@ -473,6 +489,12 @@ DCGM_FI_DEV_NVSWITCH_BANDWIDTH_RX_1_P17          = 855
 DCGM_FI_DEV_NVSWITCH_FATAL_ERRORS                = 856
 DCGM_FI_DEV_NVSWITCH_NON_FATAL_ERRORS            = 857
 
+'''
+Derived fields. Define them with dcgm_agent.dcgmSetDerivedField()
+'''
+DCGM_FI_FIRST_DERIVED_FIELD_ID                   = 900
+DCGM_FI_LAST_DERIVED_FIELD_ID                    = 915
+
 '''
 Profiling Fields
 '''
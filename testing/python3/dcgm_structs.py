@@ -54,6 +54,13 @@ DCGM_MAX_FBC_SESSIONS                 =   256
 DCGM_ORDER_ASCENDING  = 1
 DCGM_ORDER_DESCENDING = 2
 
+#How the samples of each bucket are combined by dcgmGetValuesSinceBucketed
+DCGM_BUCKET_AGG_MIN   = 1
+DCGM_BUCKET_AGG_MAX   = 2
+DCGM_BUCKET_AGG_AVG   = 3
+DCGM_BUCKET_AGG_LAST  = 4
+DCGM_BUCKET_AGG_COUNT = 5
+
 DCGM_OPERATION_MODE_AUTO   = 1
 DCGM_OPERATION_MODE_MANUAL = 2
 
@@ -633,7 +640,127 @@ class c_dcgmConnectV2Params_v2(_PrintableStructure):
     ]
 
 c_dcgmConnectV2Params_version2 = make_dcgm_version(c_dcgmConnectV2Params_v2, 2)
-c_dcgmConnectV2Params_version = c_dcgmConnectV2Params_version2
+
+class c_dcgmConnectV2Params_v3(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint),
+        ('persistAfterDisconnect', c_uint),
+        ('timeoutMs', c_uint),
+        ('addressIsUnixSocket', c_uint),
+        ('useSharedMemory', c_uint)
+    ]
+
+c_dcgmConnectV2Params_version3 = make_dcgm_version(c_dcgmConnectV2Params_v3, 3)
+
+#Compression of the messages of a TCP/IP connection to the host engine
+DCGM_TRANSPORT_COMPRESSION_NONE = 0
+DCGM_TRANSPORT_COMPRESSION_ZLIB = 1
+
+class c_dcgmConnectV2Params_v4(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint),
+        ('persistAfterDisconnect', c_uint),
+        ('timeoutMs', c_uint),
+        ('addressIsUnixSocket', c_uint),
+        ('useSharedMemory', c_uint),
+        ('compression', c_uint),
+        ('compressionThreshold', c_uint)
+    ]
+
+c_dcgmConnectV2Params_version4 = make_dcgm_version(c_dcgmConnectV2Params_v4, 4)
+c_dcgmConnectV2Params_version = c_dcgmConnectV2Params_version4
+
+class c_dcgmTransportCounters_t(_PrintableStructure):
+    _fields_ = [
+        ('messagesSent', c_uint64),
+        ('messagesSentCompressed', c_uint64),
+        ('bytesSent', c_uint64),
+        ('uncompressedBytesSent', c_uint64),
+        ('messagesReceived', c_uint64),
+        ('bytesReceived', c_uint64),
+        ('uncompressedBytesReceived', c_uint64),
+        ('compressUsec', c_uint64),
+        ('decompressUsec', c_uint64)
+    ]
+
+class c_dcgmTransportStats_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint),
+        ('compression', c_uint),
+        ('compressionThreshold', c_uint),
+        ('unused', c_uint),
+        ('client', c_dcgmTransportCounters_t),
+        ('hostEngine', c_dcgmTransportCounters_t)
+    ]
+
+c_dcgmTransportStats_version1 = make_dcgm_version(c_dcgmTransportStats_v1, 1)
+
+class c_dcgmSendQueueStats_t(_PrintableStructure):
+    _fields_ = [
+        ('queuedBytes', c_uint64),
+        ('maxQueuedBytes', c_uint64),
+        ('heldMessages', c_uint64),
+        ('highWatermarkHits', c_uint64),
+        ('messagesDropped', c_uint64),
+        ('messagesCoalesced', c_uint64)
+    ]
+
+class c_dcgmTransportStats_v2(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint),
+        ('compression', c_uint),
+        ('compressionThreshold', c_uint),
+        ('unused', c_uint),
+        ('client', c_dcgmTransportCounters_t),
+        ('hostEngine', c_dcgmTransportCounters_t),
+        ('clientSendQueue', c_dcgmSendQueueStats_t),
+        ('hostEngineSendQueue', c_dcgmSendQueueStats_t)
+    ]
+
+c_dcgmTransportStats_version2 = make_dcgm_version(c_dcgmTransportStats_v2, 2)
+c_dcgmTransportStats_version = c_dcgmTransportStats_version2
+
+#Defaults of c_dcgmFieldValueStreamParams_v1 fields that are left 0
+DCGM_FV_STREAM_DEFAULT_BATCHES_IN_FLIGHT = 4
+DCGM_FV_STREAM_DEFAULT_PENDING_VALUES = 100000
+
+class c_dcgmFieldValueStreamParams_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint),
+        ('groupId', c_void_p),
+        ('fieldGroupId', c_void_p),
+        ('updateFreq', c_int64),
+        ('maxKeepAge', c_double),
+        ('maxKeepSamples', c_int32),
+        ('maxBatchesInFlight', c_uint),
+        ('maxPendingValues', c_uint)
+    ]
+
+dcgmFieldValueStreamParams_version1 = make_dcgm_version(c_dcgmFieldValueStreamParams_v1, 1)
+dcgmFieldValueStreamParams_version = dcgmFieldValueStreamParams_version1
+
+DCGM_PROXY_MAX_HOSTS = 128
+
+class c_dcgmProxyHostStatus_v1(_PrintableStructure):
+    _fields_ = [
+        ('address', c_char * DCGM_MAX_STR_LENGTH),
+        ('connected', c_uint),
+        ('numConnects', c_uint),
+        ('lastStatus', c_int32),
+        ('nextConnectTime', c_int64),
+        ('valuesForwarded', c_uint64),
+        ('valuesDropped', c_uint64)
+    ]
+
+class c_dcgmProxyHosts_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint),
+        ('numHosts', c_uint),
+        ('hosts', c_dcgmProxyHostStatus_v1 * DCGM_PROXY_MAX_HOSTS)
+    ]
+
+dcgmProxyHosts_version1 = make_dcgm_version(c_dcgmProxyHosts_v1, 1)
+dcgmProxyHosts_version = dcgmProxyHosts_version1
 
 class c_dcgmHostengineHealth_v1(_PrintableStructure):
     _fields_ = [
@@ -644,6 +771,35 @@ class c_dcgmHostengineHealth_v1(_PrintableStructure):
 dcgmHostengineHealth_version1 = make_dcgm_version(c_dcgmHostengineHealth_v1, 1)
 dcgmHostengineHealth_version = dcgmHostengineHealth_version1
 
+DCGM_MAX_WORKER_LANES = 8
+
+class c_dcgmWorkerLaneStats_t(_PrintableStructure):
+    _fields_ = [
+        ('minWorkers', c_uint),
+        ('maxWorkers', c_uint),
+        ('numWorkers', c_uint),
+        ('busyWorkers', c_uint),
+        ('peakWorkers', c_uint),
+        ('queueDepth', c_uint),
+        ('maxQueueDepth', c_uint),
+        ('unused', c_uint),
+        ('tasksProcessed', c_uint64),
+        ('totalWaitUsec', c_uint64),
+        ('maxWaitUsec', c_uint64),
+        ('workersStarted', c_uint64),
+        ('workersStopped', c_uint64)
+    ]
+
+class c_dcgmHostengineWorkerStats_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint),
+        ('numLanes', c_uint),
+        ('lanes', c_dcgmWorkerLaneStats_t * DCGM_MAX_WORKER_LANES)
+    ]
+
+dcgmHostengineWorkerStats_version1 = make_dcgm_version(c_dcgmHostengineWorkerStats_v1, 1)
+dcgmHostengineWorkerStats_version = dcgmHostengineWorkerStats_version1
+
 #Represents memory and proc clocks for a device
 class c_dcgmClockSet_v1(_PrintableStructure):
     _fields_ = [
@@ -1295,6 +1451,31 @@ class c_dcgmPolicyCallbackResponse_v1(_PrintableStructure):
         ("val", Value)
     ]
 
+class c_dcgmPolicyCallbackResponse_v2(_PrintableStructure):
+    _fields_ = [
+        ("version", c_uint),
+        ("condition", c_int),   # an OR'ed list of DCGM_POLICY_COND_*
+        ("val", c_dcgmPolicyCallbackResponse_v1.Value),
+        ("numViolations", c_uint),      # how many violations this callback stands for
+        ("firstTimestamp", c_longlong), # timestamp of the first of them
+        ("lastTimestamp", c_longlong)   # timestamp of the last of them
+    ]
+
+dcgmPolicyCallbackResponse_version2 = make_dcgm_version(c_dcgmPolicyCallbackResponse_v2, 2)
+
+class c_dcgmPolicyRegisterParams_v1(_PrintableStructure):
+    _fields_ = [
+        ("version", c_uint),
+        ("groupId", c_void_p),
+        ("condition", c_uint),              # an OR'ed list of DCGM_POLICY_COND_*
+        ("beginCallback", c_void_p),
+        ("finishCallback", c_void_p),
+        ("coalesceWindowUsec", c_longlong), # 0 = notify every violation
+        ("maxNotificationsPerSec", c_uint)  # 0 = no cap
+    ]
+
+dcgmPolicyRegisterParams_version1 = make_dcgm_version(c_dcgmPolicyRegisterParams_v1, 1)
+
 class c_dcgmFieldValue_v1_value(DcgmUnion):
     _fields_ = [
         ('i64', c_int64),
@@ -1317,6 +1498,12 @@ class c_dcgmFieldValue_v1(_PrintableStructure):
 
 dcgmFieldValue_version1 = make_dcgm_version(c_dcgmFieldValue_v1, 1)
 
+# Opaque position in the cached values of one field of one entity. See dcgmEntityGetValuesPage
+class c_dcgmValuesCursor_t(_PrintableStructure):
+    _fields_ = [
+        ('opaque', c_int64 * 2)
+    ]
+
 # This structure is used to represent value for the field to be queried (version 2)
 class c_dcgmFieldValue_v2(_PrintableStructure):
     _fields_ = [
@@ -1533,6 +1720,35 @@ class c_dcgmJobInfo_v3(_PrintableStructure):
 
 dcgmJobInfo_version3 = make_dcgm_version(c_dcgmJobInfo_v3, 3)
 
+class c_dcgmStatPercentilesFp64_t(_PrintableStructure):
+    _fields_ = [
+        ('p50', c_double),
+        ('p95', c_double),
+        ('p99', c_double)
+    ]
+
+class c_dcgmGpuUsagePercentiles_t(_PrintableStructure):
+    _fields_ = [
+        ('gpuId', c_uint32),
+        ('powerUsage', c_dcgmStatPercentilesFp64_t),
+        ('pcieRxBandwidth', c_dcgmStatPercentilesFp64_t),
+        ('pcieTxBandwidth', c_dcgmStatPercentilesFp64_t),
+        ('smUtilization', c_dcgmStatPercentilesFp64_t),
+        ('memoryUtilization', c_dcgmStatPercentilesFp64_t),
+        ('memoryClock', c_dcgmStatPercentilesFp64_t),
+        ('smClock', c_dcgmStatPercentilesFp64_t)
+    ]
+
+class c_dcgmJobPercentiles_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),
+        ('numGpus', c_int32),
+        ('summary', c_dcgmGpuUsagePercentiles_t),
+        ('gpus', c_dcgmGpuUsagePercentiles_t * DCGM_MAX_NUM_DEVICES)
+    ]
+
+dcgmJobPercentiles_version1 = make_dcgm_version(c_dcgmJobPercentiles_v1, 1)
+
 class c_dcgmDiagTestResult_v2(_PrintableStructure):
     _fields_ = [
         ('result', c_uint),
@@ -1621,6 +1837,56 @@ class c_dcgmAllFieldGroup_v1(_PrintableStructure):
 
 dcgmAllFieldGroup_version1 = make_dcgm_version(c_dcgmAllFieldGroup_v1, 1)
 
+DCGM_DERIVED_FIELD_EXPRESSION_SIZE = 256
+DCGM_DERIVED_FIELD_MAX_INPUTS = 8
+
+class c_dcgmDerivedField_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),
+        ('fieldId', c_uint16),
+        ('unused', c_uint16),
+        ('expression', c_char * DCGM_DERIVED_FIELD_EXPRESSION_SIZE),
+        ('error', c_char * DCGM_MAX_STR_LENGTH)
+    ]
+
+dcgmDerivedField_version1 = make_dcgm_version(c_dcgmDerivedField_v1, 1)
+
+
+# Most cells and bytes of strings of a c_dcgmLatestValuesMatrix_v1
+DCGM_MATRIX_MAX_CELLS = DCGM_GROUP_MAX_ENTITIES * DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP
+DCGM_MATRIX_STRINGS_SIZE = 65536
+
+# Status bits of a c_dcgmLatestValuesMatrix_v1 cell. 0 = the cell holds its whole value
+DCGM_MATRIX_CELL_BLANK         = 0x01
+DCGM_MATRIX_CELL_NOT_WATCHED   = 0x02
+DCGM_MATRIX_CELL_NOT_SUPPORTED = 0x04
+DCGM_MATRIX_CELL_ERROR         = 0x08
+DCGM_MATRIX_CELL_TRUNCATED     = 0x10
+
+class c_dcgmMatrixValue_t(DcgmUnion):
+    _fields_ = [
+        ('i64', c_int64),
+        ('dbl', c_double)
+    ]
+
+# Returned by dcgm_agent.dcgmGetLatestValuesMatrix(). The cell of row r and column c is at r * numFields + c
+class c_dcgmLatestValuesMatrix_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),
+        ('numEntities', c_uint32),
+        ('numFields', c_uint32),
+        ('stringsSize', c_uint32),
+        ('entities', c_dcgmGroupEntityPair_t * DCGM_GROUP_MAX_ENTITIES),
+        ('fieldIds', c_uint16 * DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP),
+        ('fieldTypes', c_uint8 * DCGM_MAX_FIELD_IDS_PER_FIELD_GROUP),
+        ('values', c_dcgmMatrixValue_t * DCGM_MATRIX_MAX_CELLS),
+        ('timestamps', c_int64 * DCGM_MATRIX_MAX_CELLS),
+        ('status', c_uint8 * DCGM_MATRIX_MAX_CELLS),
+        ('strings', c_char * DCGM_MATRIX_STRINGS_SIZE)
+    ]
+
+dcgmLatestValuesMatrix_version1 = make_dcgm_version(c_dcgmLatestValuesMatrix_v1, 1)
+
 
 class DCGM_INTROSPECT_LVL(object):
     '''
@@ -1653,20 +1919,19 @@ dcgmIntrospectMemory_version1 = make_dcgm_version(c_dcgmIntrospectMemory_v1, 1)
 
 class c_dcgmIntrospectFieldsExecTime_v1(_PrintableStructure):
     _fields_ = [
-        ('version', c_uint32),               # version number (dcgmIntrospectFieldsExecTime_version)                              
-        ('meanUpdateFreqUsec', c_longlong),  # the mean update frequency of all fields                                                                                      
-        ('recentUpdateUsec', c_double),      # the sum of every field's most recent execution time after they                                            
-                                             # have been normalized to \ref meanUpdateFreqUsec.           
-                                             # This is roughly how long it takes to update fields every \ref meanUpdateFreqUsec                                                                              
-                                                                
-        ('totalEverUpdateUsec', c_longlong), # The total amount of time, ever, that has been spent updating all the fields                                
+        ('version', c_uint32),               # version number (dcgmIntrospectFieldsExecTime_version1)
+        ('meanUpdateFreqUsec', c_longlong),  # the mean update frequency of all fields
+        ('recentUpdateUsec', c_double),      # the sum of every field's most recent execution time after they
+                                             # have been normalized to \ref meanUpdateFreqUsec.
+                                             # This is roughly how long it takes to update fields every \ref meanUpdateFreqUsec
+        ('totalEverUpdateUsec', c_longlong), # The total amount of time, ever, that has been spent updating all the fields
     ]
-                                                                                                                                    
+
 dcgmIntrospectFieldsExecTime_version1 = make_dcgm_version(c_dcgmIntrospectFieldsExecTime_v1, 1)
 
 class c_dcgmIntrospectFullFieldsExecTime_v2(_PrintableStructure):
     '''
-    Full introspection info for field execution time
+    Full introspection info for field execution time, made of c_dcgmIntrospectFieldsExecTime_v1
     '''
     _fields_ = [
         ('version', c_uint32),
@@ -1682,6 +1947,87 @@ class c_dcgmIntrospectFullFieldsExecTime_v2(_PrintableStructure):
 
 dcgmIntrospectFullFieldsExecTime_version2 = make_dcgm_version(c_dcgmIntrospectFullFieldsExecTime_v2, 2)
 
+DCGM_INTROSPECT_EXEC_TIME_BUCKETS = 20
+
+class c_dcgmIntrospectFieldsExecTime_v2(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),               # version number (dcgmIntrospectFieldsExecTime_version2)
+        ('meanUpdateFreqUsec', c_longlong),  # the mean update frequency of all fields
+        ('recentUpdateUsec', c_double),      # the sum of every field's most recent execution time after they
+                                             # have been normalized to \ref meanUpdateFreqUsec.
+                                             # This is roughly how long it takes to update fields every \ref meanUpdateFreqUsec
+        ('totalEverUpdateUsec', c_longlong), # The total amount of time, ever, that has been spent updating all the fields
+        ('maxUpdateUsec', c_longlong),       # The longest that a single update of any of the fields has ever taken
+        ('updateUsecHistogram', c_longlong * DCGM_INTROSPECT_EXEC_TIME_BUCKETS), # Number of updates by how long they took.
+                                             # Bucket 0 is < 2 usec. Bucket i is [2^i, 2^(i+1)) usec. The last bucket
+                                             # also counts everything longer
+    ]
+
+dcgmIntrospectFieldsExecTime_version2 = make_dcgm_version(c_dcgmIntrospectFieldsExecTime_v2, 2)
+
+class c_dcgmIntrospectFullFieldsExecTime_v3(_PrintableStructure):
+    '''
+    Full introspection info for field execution time, made of c_dcgmIntrospectFieldsExecTime_v2
+    '''
+    _fields_ = [
+        ('version', c_uint32),
+        ('aggregateInfo', c_dcgmIntrospectFieldsExecTime_v2),   # info that includes global and device scope
+        ('hasGlobalInfo', c_int),                               # 0 means \ref globalInfo is populated, !0 means it's not
+        ('globalInfo', c_dcgmIntrospectFieldsExecTime_v2),      # info that only includes global field scope
+        ('gpuInfoCount', c_uint),                               # count of how many entries in \ref gpuInfo are populated
+        ('gpuIdsForGpuInfo', c_uint * DCGM_MAX_NUM_DEVICES),    # the GPU ID at a given index identifies which gpu
+                                                                # the corresponding entry in \ref gpuInfo is from
+        ('gpuInfo', c_dcgmIntrospectFieldsExecTime_v2 * DCGM_MAX_NUM_DEVICES),  # info that is separated by the
+                                                                                # GPU ID that the watches were for
+    ]
+
+dcgmIntrospectFullFieldsExecTime_version3 = make_dcgm_version(c_dcgmIntrospectFullFieldsExecTime_v3, 3)
+
+# Stages of sample age measurement. See dcgmIntrospectLagStage_t
+DCGM_INTROSPECT_LAG_CACHE_INSERT        = 0 # The sample was stored in the cache
+DCGM_INTROSPECT_LAG_SUBSCRIBER_DISPATCH = 1 # The sample was published to modules and field value streams
+DCGM_INTROSPECT_LAG_IPC_SEND            = 2 # The sample was sent to a client
+DCGM_INTROSPECT_LAG_STAGE_COUNT         = 3
+
+class c_dcgmIntrospectFieldsExecTime_v3(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),               # version number (dcgmIntrospectFieldsExecTime_version)
+        ('meanUpdateFreqUsec', c_longlong),  # the mean update frequency of all fields
+        ('recentUpdateUsec', c_double),      # the sum of every field's most recent execution time after they
+                                             # have been normalized to \ref meanUpdateFreqUsec.
+                                             # This is roughly how long it takes to update fields every \ref meanUpdateFreqUsec
+        ('totalEverUpdateUsec', c_longlong), # The total amount of time, ever, that has been spent updating all the fields
+        ('maxUpdateUsec', c_longlong),       # The longest that a single update of any of the fields has ever taken
+        ('updateUsecHistogram', c_longlong * DCGM_INTROSPECT_EXEC_TIME_BUCKETS), # Number of updates by how long they took.
+                                             # Bucket 0 is < 2 usec. Bucket i is [2^i, 2^(i+1)) usec. The last bucket
+                                             # also counts everything longer
+        ('maxSampleLagUsec', c_longlong * DCGM_INTROSPECT_LAG_STAGE_COUNT), # The oldest that a sample of any of the
+                                             # fields has been at each DCGM_INTROSPECT_LAG_*
+        ('sampleLagUsecHistogram', c_longlong * DCGM_INTROSPECT_EXEC_TIME_BUCKETS * DCGM_INTROSPECT_LAG_STAGE_COUNT),
+                                             # Number of samples by how old they were at each DCGM_INTROSPECT_LAG_*.
+                                             # Same buckets as updateUsecHistogram
+    ]
+
+dcgmIntrospectFieldsExecTime_version3 = make_dcgm_version(c_dcgmIntrospectFieldsExecTime_v3, 3)
+
+class c_dcgmIntrospectFullFieldsExecTime_v4(_PrintableStructure):
+    '''
+    Full introspection info for field execution time
+    '''
+    _fields_ = [
+        ('version', c_uint32),
+        ('aggregateInfo', c_dcgmIntrospectFieldsExecTime_v3),   # info that includes global and device scope
+        ('hasGlobalInfo', c_int),                               # 0 means \ref globalInfo is populated, !0 means it's not
+        ('globalInfo', c_dcgmIntrospectFieldsExecTime_v3),      # info that only includes global field scope
+        ('gpuInfoCount', c_uint),                               # count of how many entries in \ref gpuInfo are populated
+        ('gpuIdsForGpuInfo', c_uint * DCGM_MAX_NUM_DEVICES),    # the GPU ID at a given index identifies which gpu
+                                                                # the corresponding entry in \ref gpuInfo is from
+        ('gpuInfo', c_dcgmIntrospectFieldsExecTime_v3 * DCGM_MAX_NUM_DEVICES),  # info that is separated by the
+                                                                                # GPU ID that the watches were for
+    ]
+
+dcgmIntrospectFullFieldsExecTime_version4 = make_dcgm_version(c_dcgmIntrospectFullFieldsExecTime_v4, 4)
+
 class c_dcgmIntrospectFullMemory_v1(_PrintableStructure):
     '''
     Full introspection info for field memory
@@ -1710,6 +2056,146 @@ class c_dcgmIntrospectCpuUtil_v1(_PrintableStructure):
 
 dcgmIntrospectCpuUtil_version1 = make_dcgm_version(c_dcgmIntrospectCpuUtil_v1, 1)
 
+DCGM_INTROSPECT_MAX_THREADS = 256
+
+class c_dcgmIntrospectThreadCpuUtilEntry_t(_PrintableStructure):
+    _fields_ = [
+        ('tid', c_uint32),         #!< Thread ID as seen in /proc/<pid>/task
+        ('name', c_char * 16),     #!< Thread name, like cache_mgr_main or dcgm_ipc
+        ('unused', c_uint32),
+        ('total', c_double),       #!< fraction of device's CPU resources that this thread used
+        ('kernel', c_double),      #!< fraction of device's CPU resources that this thread used in kernel mode
+        ('user', c_double),        #!< fraction of device's CPU resources that this thread used in user mode
+    ]
+
+class c_dcgmIntrospectThreadCpuUtil_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),
+        ('numThreads', c_uint32),  # Number of populated entries in threads
+        ('moreThreads', c_uint32), # 1 if the hostengine had more than DCGM_INTROSPECT_MAX_THREADS threads
+        ('unused', c_uint32),
+        ('threads', c_dcgmIntrospectThreadCpuUtilEntry_t * DCGM_INTROSPECT_MAX_THREADS), # Busiest thread first
+    ]
+
+dcgmIntrospectThreadCpuUtil_version1 = make_dcgm_version(c_dcgmIntrospectThreadCpuUtil_v1, 1)
+
+DCGM_INTROSPECT_LATENCY_BUCKETS = 24
+DCGM_INTROSPECT_MAX_REQUEST_TYPES = 128
+DCGM_INTROSPECT_REQUEST_PROTOBUF = 0xFFFFFFFF
+DCGM_INTROSPECT_REQUEST_STATS_PER_CONNECTION = 0x1
+
+class c_dcgmIntrospectRequestTypeStats_t(_PrintableStructure):
+    _fields_ = [
+        ('moduleId', c_uint32),
+        ('command', c_uint32),
+        ('connectionId', c_uint32),
+        ('unused', c_uint32),
+        ('count', c_uint64),
+        ('errorCount', c_uint64),
+        ('totalQueueWaitUsec', c_uint64),
+        ('maxQueueWaitUsec', c_uint64),
+        ('totalProcessUsec', c_uint64),
+        ('maxProcessUsec', c_uint64),
+        ('totalReplyBytes', c_uint64),
+        ('maxReplyBytes', c_uint64),
+        ('queueWaitHistogram', c_uint64 * DCGM_INTROSPECT_LATENCY_BUCKETS),
+        ('processHistogram', c_uint64 * DCGM_INTROSPECT_LATENCY_BUCKETS),
+    ]
+
+class c_dcgmIntrospectRequestStats_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),
+        ('flags', c_uint32),
+        ('numEntries', c_uint32),
+        ('moreEntries', c_uint32),
+        ('entries', c_dcgmIntrospectRequestTypeStats_t * DCGM_INTROSPECT_MAX_REQUEST_TYPES),
+    ]
+
+dcgmIntrospectRequestStats_version1 = make_dcgm_version(c_dcgmIntrospectRequestStats_v1, 1)
+
+DCGM_INTROSPECT_MEM_TAG_CACHE = 0
+DCGM_INTROSPECT_MEM_TAG_IPC_SEND_QUEUES = 1
+DCGM_INTROSPECT_MEM_TAG_IPC_BUFFER_POOL = 2
+DCGM_INTROSPECT_MEM_TAG_PROTOBUF = 3
+DCGM_INTROSPECT_MEM_TAG_MODULE_REQUESTS = 4
+DCGM_INTROSPECT_MEM_TAG_CACHE_ARENAS = 5
+DCGM_INTROSPECT_MEM_TAG_COUNT = 6
+DCGM_INTROSPECT_MEM_MAX_TAGS = 16
+DCGM_INTROSPECT_MEM_MAX_MODULES = 16
+DCGM_INTROSPECT_MEM_MAX_WATCHERS = 128
+
+class c_dcgmIntrospectMemoryTag_t(_PrintableStructure):
+    _fields_ = [
+        ('bytesUsed', c_int64),
+        ('maxBytesUsed', c_int64),
+    ]
+
+class c_dcgmIntrospectWatcherMemory_t(_PrintableStructure):
+    _fields_ = [
+        ('watcherType', c_uint32),
+        ('connectionId', c_uint32),
+        ('cacheBytes', c_int64),
+        ('sendQueueBytes', c_int64),
+    ]
+
+class c_dcgmIntrospectMemoryAccounting_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),
+        ('numTags', c_uint32),
+        ('numWatchers', c_uint32),
+        ('moreWatchers', c_uint32),
+        ('tags', c_dcgmIntrospectMemoryTag_t * DCGM_INTROSPECT_MEM_MAX_TAGS),
+        ('modules', c_dcgmIntrospectMemoryTag_t * DCGM_INTROSPECT_MEM_MAX_MODULES),
+        ('watchers', c_dcgmIntrospectWatcherMemory_t * DCGM_INTROSPECT_MEM_MAX_WATCHERS),
+    ]
+
+dcgmIntrospectMemoryAccounting_version1 = make_dcgm_version(c_dcgmIntrospectMemoryAccounting_v1, 1)
+
+DCGM_INTROSPECT_FETCH_SINGLE = 0
+DCGM_INTROSPECT_FETCH_FIELD_VALUES = 1
+DCGM_INTROSPECT_FETCH_SHARED = 2
+DCGM_INTROSPECT_FETCH_COLLECTOR = 3
+DCGM_INTROSPECT_WATCH_COST_MAX_FIELDS = 128
+
+class c_dcgmIntrospectFieldCost_t(_PrintableStructure):
+    _fields_ = [
+        ('fieldId', c_uint16),
+        ('fetchMethod', c_uint16),
+        ('numEntities', c_uint32),
+        ('numMeasured', c_uint32),
+        ('numWatched', c_uint32),
+        ('execUsecPerFetch', c_double),
+        ('bytesPerSample', c_int64),
+        ('samplesKept', c_int64),
+        ('cpuUsecPerSec', c_double),
+        ('driverCallsPerSec', c_double),
+        ('cacheBytes', c_int64),
+        ('marginalCpuUsecPerSec', c_double),
+        ('marginalDriverCallsPerSec', c_double),
+        ('marginalCacheBytes', c_int64),
+    ]
+
+class c_dcgmIntrospectWatchCost_v1(_PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),
+        ('groupId', c_uint32),
+        ('fieldGroupId', c_uint32),
+        ('numFields', c_uint32),
+        ('updateFreq', c_int64),
+        ('maxKeepAge', c_double),
+        ('maxKeepSamples', c_int32),
+        ('reserved', c_uint32),
+        ('cpuUsecPerSec', c_double),
+        ('driverCallsPerSec', c_double),
+        ('cacheBytes', c_int64),
+        ('marginalCpuUsecPerSec', c_double),
+        ('marginalDriverCallsPerSec', c_double),
+        ('marginalCacheBytes', c_int64),
+        ('fields', c_dcgmIntrospectFieldCost_t * DCGM_INTROSPECT_WATCH_COST_MAX_FIELDS),
+    ]
+
+dcgmIntrospectWatchCost_version1 = make_dcgm_version(c_dcgmIntrospectWatchCost_v1, 1)
+
 DCGM_MAX_CONFIG_FILE_LEN = 10000
 DCGM_MAX_TEST_NAMES = 20
 DCGM_MAX_TEST_NAMES_LEN = 50
@@ -1726,6 +2212,8 @@ DCGM_RUN_FLAGS_STATSONFAIL = 0x0002
 DCGM_RUN_FLAGS_TRAIN       = 0x0004
 DCGM_RUN_FLAGS_FORCE_TRAIN = 0x0008
 DCGM_RUN_FLAGS_FAIL_EARLY  = 0x0010 # Enable fail early checks for the Targeted Stress, Targeted Power, SM Stress, and Diagnostic tests
+DCGM_RUN_FLAGS_FAIL_FAST   = 0x0020 # Stop the whole run at the first fatal error on any GPU
+DCGM_RUN_FLAGS_REUSE_RESULTS = 0x0040 # Return recent passing results of the same tests on a GPU instead of running them again
 
 class c_dcgmRunDiag_v7(_PrintableStructure):
     _fields_ = [
@@ -1846,7 +2334,10 @@ DCGM_SUMMARY_SUM      = 0x00000008
 DCGM_SUMMARY_COUNT    = 0x00000010
 DCGM_SUMMARY_INTEGRAL = 0x00000020
 DCGM_SUMMARY_DIFF     = 0x00000040
-DCGM_SUMMARY_SIZE     = 7
+DCGM_SUMMARY_P50      = 0x00000080
+DCGM_SUMMARY_P95      = 0x00000100
+DCGM_SUMMARY_P99      = 0x00000200
+DCGM_SUMMARY_SIZE     = 7 # Most summaries one request can ask for
 
 class c_dcgmSummaryResponse_t(_PrintableStructure):
     class ResponseValue(DcgmUnion):
@@ -1934,6 +2425,9 @@ class c_dcgmProfGetMetricGroups_v2(_PrintableStructure):
 
 dcgmProfGetMetricGroups_version1 = make_dcgm_version(c_dcgmProfGetMetricGroups_v2, 2)
 
+DCGM_PROF_WATCH_FLAG_MULTIPLEX = 0x00000001 # Time-multiplex metric groups that can't be collected together
+DCGM_PROF_WATCH_FLAG_BUFFERED = 0x00000002 # Keep every counter sample, delivered in batches every updateFreq
+
 class c_dcgmProfWatchFields_v1(_PrintableStructure):
     _fields_ = [
         ('version', c_uint32),
@@ -98,6 +98,7 @@ dcgmInjectFieldValue_version1  = dcgm_structs.make_dcgm_version(c_dcgmInjectFiel
 
 #Cache Manager Info flags
 DCGM_CMI_F_WATCHED = 0x00000001
+DCGM_CMI_F_ADAPTIVE_DECIMATED = 0x00000002
 
 #Watcher types
 DcgmWatcherTypeClient           = 0 # Embedded or remote client via external APIs
@@ -107,6 +108,12 @@ DcgmWatcherTypePolicyManager    = 3 # Watcher is NvcmPolicyMgr
 DcgmWatcherTypeCacheManager     = 4 # Watcher is DcgmCacheManager
 DcgmWatcherTypeConfigManager    = 5 # Watcher is NvcmConfigMgr
 DcgmWatcherTypeNvSwitchManager  = 6 # Watcher is NvSwitchManager
+DcgmWatcherTypeFvStream         = 7 # Field value stream of a client
+DcgmWatcherTypeJobStats         = 8 # Running job stats
+DcgmWatcherTypeMetricsExporter  = 9 # OpenMetrics endpoint of the host engine
+DcgmWatcherTypeOtlpExporter     = 10 # OTLP metrics push of the host engine
+DcgmWatcherTypeLatestValueBoard = 11 # Shared memory latest value board of the host engine
+DcgmWatcherTypeDiagResultCache  = 12 # Health of GPUs with reusable diagnostic results
 
 
 # ID of a remote client connection within the host engine
@@ -122,10 +129,11 @@ class c_dcgm_cm_field_info_watcher_t(dcgm_structs._PrintableStructure):
         ('watcherType', c_uint),
         ('connectionId', dcgm_connection_id_t),
         ('monitorFrequencyUsec', c_int64),
-        ('maxAgeUsec', c_int64)
+        ('maxAgeUsec', c_int64),
+        ('bytesUsed', c_int64)
     ]
 
-class dcgmCacheManagerFieldInfo_v3(dcgm_structs._PrintableStructure):
+class dcgmCacheManagerFieldInfo_v5(dcgm_structs._PrintableStructure):
     _fields_ = [
         ('version', c_uint32),
         ('flags', c_uint32),
@@ -138,12 +146,15 @@ class dcgmCacheManagerFieldInfo_v3(dcgm_structs._PrintableStructure):
         ('maxAgeUsec', c_int64),
         ('execTimeUsec', c_int64),
         ('fetchCount', c_int64),
+        ('bytesUsed', c_int64),
+        ('lastReadUsec', c_int64),
+        ('pollIntervalUsec', c_int64),
         ('numSamples', c_int32),
         ('numWatchers', c_int32),
         ('watchers', c_dcgm_cm_field_info_watcher_t * DCGM_CM_FIELD_INFO_NUM_WATCHERS)
     ]
 
-dcgmCacheManagerFieldInfo_version3 = dcgm_structs.make_dcgm_version(dcgmCacheManagerFieldInfo_v3, 3)
+dcgmCacheManagerFieldInfo_version5 = dcgm_structs.make_dcgm_version(dcgmCacheManagerFieldInfo_v5, 5)
 
 class c_dcgmCreateFakeEntities_v2(dcgm_structs._PrintableStructure):
     _fields_ = [
@@ -165,3 +176,22 @@ class c_dcgmSetNvLinkLinkState_v1(dcgm_structs._PrintableStructure):
     ]
 
 dcgmSetNvLinkLinkState_version1 = dcgm_structs.make_dcgm_version(c_dcgmSetNvLinkLinkState_v1, 1)
+
+# Actions for dcgmTraceControl
+DCGM_TRACE_ACTION_START = 1 # Start recording update-loop and request spans
+DCGM_TRACE_ACTION_STOP  = 2 # Stop recording. Recorded spans are kept
+DCGM_TRACE_ACTION_DUMP  = 3 # Write the recorded spans as Chrome trace JSON on the hostengine's host
+DCGM_TRACE_ACTION_MUTEX_PROFILE_START = 4 # Reset the DcgmMutex profiles and start recording waits and holds
+DCGM_TRACE_ACTION_MUTEX_PROFILE_STOP  = 5 # Stop profiling DcgmMutexes. Recorded profiles are kept
+DCGM_TRACE_ACTION_MUTEX_PROFILE_DUMP  = 6 # Write the mutex profiles as JSON on the hostengine's host
+
+class c_dcgmTraceControl_v1(dcgm_structs._PrintableStructure):
+    _fields_ = [
+        ('version', c_uint32),                          # Version. Should be dcgmTraceControl_version1
+        ('action', c_uint32),                           # One of DCGM_TRACE_ACTION_*
+        ('numSpans', c_uint32),                         # IN: ring size for the first START. OUT: ring size in use
+        ('isEnabled', c_uint32),                        # OUT: whether spans are being recorded
+        ('filename', c_char * DCGM_MAX_STR_LENGTH)      # OUT: for DUMP, the path of the file that was written
+    ]
+
+dcgmTraceControl_version1 = dcgm_structs.make_dcgm_version(c_dcgmTraceControl_v1, 1)
@@ -125,6 +125,22 @@ def parse_options():
                  "This option is useful for debugging the stand-alone host engine, which can be started separately inside of" +
                   "valgrind or gdb. This will skip embedded-only tests due to the host engine already being running."
             )
+    parser.add_option(
+            "--perf-regression",
+            dest="perf_regression",
+            action="store_true",
+            default=False,
+            help="Run the performance regression tests, which compare the host engine's CPU, memory and request " +
+                 "latency against the baselines in tests/perf_baselines.json. These take over 10 minutes"
+            )
+    parser.add_option(
+            "--update-perf-baselines",
+            dest="update_perf_baselines",
+            action="store_true",
+            default=False,
+            help="Record what the performance regression tests measure as their new baselines instead of " +
+                 "comparing against them. Implies --perf-regression"
+            )
     parser.add_option(
             "--coverage",
             dest="coverage",
@@ -189,6 +205,9 @@ def parse_options():
     if options.debug:
         logger.stdout_loglevel = logger.DEBUG
 
+    if options.update_perf_baselines:
+        options.perf_regression = True
+
     # by default some actions shouldn't generate any log
     if options.test_info:
         test_utils.noLogging = True
@@ -223,6 +242,8 @@ class OptionParserStub():
         self.use_running_hostengine = False
         self.no_process_check = False
         self.developer_mode = False
+        self.perf_regression = False
+        self.update_perf_baselines = False
         self.no_env_check = False
         self.coverage = ''
         self.dvssc_testing = False
@@ -49,3 +49,17 @@ def standard_deviation(x):
     sumTerm = sum((xi - xBar)**2 for xi in x)
     
     return math.sqrt((1./(N-1)) * sumTerm)
+
+def percentile(series, pct):
+    '''
+    The pct-th percentile of series (0 <= pct <= 100), interpolating between the closest ranks
+    '''
+    ordered = sorted(series)
+    if len(ordered) == 0:
+        return 0
+
+    rank = (len(ordered) - 1) * (pct / 100.)
+    low = int(math.floor(rank))
+    high = int(math.ceil(rank))
+
+    return ordered[low] + (ordered[high] - ordered[low]) * (rank - low)
@@ -1074,7 +1074,8 @@ class RunClientInitShutdown:
         self.persistAfterDisconnect = persistAfterDisconnect
 
     def __enter__(self):
-        connectParams = dcgm_structs.c_dcgmConnectV2Params_v1()
+        #dcgmConnect_v2() stamps the latest version on this, so it has to be the latest struct
+        connectParams = dcgm_structs.c_dcgmConnectV2Params_v4()
         if self.persistAfterDisconnect:
             connectParams.persistAfterDisconnect = 1
         else:
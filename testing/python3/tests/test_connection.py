@@ -154,6 +154,112 @@ def test_dcgm_connection_versions(handle):
     dcgm_agent.dcgmDisconnect(v1Handle)
     dcgm_agent.dcgmDisconnect(v2Handle)
 
+@test_utils.run_with_standalone_host_engine(20)
+@test_utils.run_with_initialized_client()
+def test_dcgm_connection_compression(handle):
+    '''
+    Test that a TCP/IP connection can compress its messages and that its traffic is counted
+    '''
+    dcgmHandle = pydcgm.DcgmHandle(ipAddress="127.0.0.1",
+                                   compression=dcgm_structs.DCGM_TRANSPORT_COMPRESSION_ZLIB,
+                                   compressionThreshold=1024)
+
+    #dcgm_core_msg_fieldgroup_get_all_t is large and mostly zeros, so it's compressed both ways
+    fieldGroups = dcgm_agent.dcgmFieldGroupGetAll(dcgmHandle.handle)
+    uncompressedFieldGroups = dcgm_agent.dcgmFieldGroupGetAll(handle)
+    assert fieldGroups.numFieldGroups == uncompressedFieldGroups.numFieldGroups, \
+        "%d != %d" % (fieldGroups.numFieldGroups, uncompressedFieldGroups.numFieldGroups)
+
+    stats = dcgm_agent.dcgmGetTransportStats(dcgmHandle.handle)
+    assert stats.compression == dcgm_structs.DCGM_TRANSPORT_COMPRESSION_ZLIB, "%d" % stats.compression
+    assert stats.compressionThreshold == 1024, "%d" % stats.compressionThreshold
+    assert stats.client.messagesSentCompressed > 0, str(stats)
+    assert stats.client.bytesSent < stats.client.uncompressedBytesSent, str(stats)
+    assert stats.hostEngine.messagesSentCompressed > 0, str(stats)
+    assert stats.hostEngine.bytesSent < stats.hostEngine.uncompressedBytesSent, str(stats)
+    assert stats.client.bytesReceived < stats.client.uncompressedBytesReceived, str(stats)
+
+    #Connections don't compress by default
+    uncompressedHandle = pydcgm.DcgmHandle(ipAddress="127.0.0.1")
+    dcgm_agent.dcgmFieldGroupGetAll(uncompressedHandle.handle)
+    stats = dcgm_agent.dcgmGetTransportStats(uncompressedHandle.handle)
+    assert stats.compression == dcgm_structs.DCGM_TRANSPORT_COMPRESSION_NONE, "%d" % stats.compression
+    assert stats.client.bytesSent == stats.client.uncompressedBytesSent, str(stats)
+
+    del(uncompressedHandle)
+    uncompressedHandle = None
+    del(dcgmHandle)
+    dcgmHandle = None
+
+@test_utils.run_with_standalone_host_engine(20)
+@test_utils.run_with_initialized_client()
+def test_dcgm_connection_client_cache(handle):
+    '''
+    Test that a connection with the client cache enabled answers repeated calls locally and
+    drops what it cached when another client changes the field groups
+    '''
+    dcgmHandle = pydcgm.DcgmHandle(ipAddress="127.0.0.1")
+    dcgm_agent.dcgmClientCacheEnable(dcgmHandle.handle)
+    dcgm_agent.dcgmClientCacheEnable(dcgmHandle.handle) #Enabling it again is fine
+
+    numFieldGroups = dcgm_agent.dcgmFieldGroupGetAll(dcgmHandle.handle).numFieldGroups
+
+    #Only the stats request itself should go over the connection
+    before = dcgm_agent.dcgmGetTransportStats(dcgmHandle.handle)
+    for i in range(5):
+        assert dcgm_agent.dcgmFieldGroupGetAll(dcgmHandle.handle).numFieldGroups == numFieldGroups
+    after = dcgm_agent.dcgmGetTransportStats(dcgmHandle.handle)
+    assert after.client.messagesSent - before.client.messagesSent == 1, \
+        "%d -> %d" % (before.client.messagesSent, after.client.messagesSent)
+
+    #Another client creating a field group is pushed to this one, which then asks the host engine again
+    fieldGroupId = dcgm_agent.dcgmFieldGroupCreate(handle, [dcgm_fields.DCGM_FI_DEV_GPU_TEMP], "cachetest")
+    for i in range(100):
+        if dcgm_agent.dcgmFieldGroupGetAll(dcgmHandle.handle).numFieldGroups == numFieldGroups + 1:
+            break
+        time.sleep(0.01)
+    else:
+        assert False, "Cached field groups were never dropped"
+
+    dcgm_agent.dcgmFieldGroupDestroy(handle, fieldGroupId)
+    del(dcgmHandle)
+    dcgmHandle = None
+
+@test_utils.run_with_standalone_host_engine(20)
+@test_utils.run_with_initialized_client()
+def test_dcgm_connection_shared(handle):
+    '''
+    Test that handles sharing one connection are separate connections to the host engine
+    '''
+    dcgmHandle = pydcgm.DcgmHandle(ipAddress="127.0.0.1")
+    sharedHandles = [dcgm_agent.dcgmConnectShared(dcgmHandle.handle) for i in range(3)]
+
+    groupIds = []
+    for i, sharedHandle in enumerate(sharedHandles):
+        groupIds.append(dcgm_agent.dcgmGroupCreate(sharedHandle, dcgm_structs.DCGM_GROUP_EMPTY, "shared%d" % i))
+    assert len(set(groupIds)) == len(groupIds), str(groupIds)
+
+    #A shared handle reports the traffic of the socket it shares
+    carrierStats = dcgm_agent.dcgmGetTransportStats(dcgmHandle.handle)
+    sharedStats = dcgm_agent.dcgmGetTransportStats(sharedHandles[0])
+    assert sharedStats.client.messagesSent > carrierStats.client.messagesSent, str(sharedStats)
+
+    #The groups of a shared handle go away with it, and only its groups
+    dcgm_agent.dcgmDisconnect(sharedHandles[0])
+    for i in range(100):
+        if groupIds[0] not in dcgm_agent.dcgmGroupGetAllIds(dcgmHandle.handle):
+            break
+        time.sleep(0.01)
+    else:
+        assert False, "The group of a disconnected shared handle was never removed"
+    assert groupIds[1] in dcgm_agent.dcgmGroupGetAllIds(sharedHandles[1])
+
+    #Closing the shared connection closes every handle on it
+    del(dcgmHandle)
+    dcgmHandle = None
+    with test_utils.assert_raises(dcgm_structs.dcgmExceptionClass(dcgm_structs.DCGM_ST_CONNECTION_NOT_VALID)):
+        dcgm_agent.dcgmGroupGetAllIds(sharedHandles[1])
+
 
 def _test_connection_helper(domainSocketName):
     #Make sure the library is initialized
@@ -177,6 +283,16 @@ def _test_connection_helper(domainSocketName):
     del(dcgmHandle)
     dcgmHandle = None
 
+    #Same again over shared memory. The answers shouldn't change
+    dcgmHandle = pydcgm.DcgmHandle(unixSocketPath=domainSocketName, useSharedMemory=True)
+    dcgmSystem = dcgmHandle.GetSystem()
+
+    shmGpuIds = dcgmSystem.discovery.GetAllGpuIds()
+    assert shmGpuIds == gpuIds, "%s != %s" % (str(shmGpuIds), str(gpuIds))
+
+    del(dcgmHandle)
+    dcgmHandle = None
+
 
 # Add a date-based extension to the path to prevent having trouble when the framework is run as root
 # and then again as non-root
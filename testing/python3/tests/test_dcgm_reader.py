@@ -138,3 +138,38 @@ def test_reading_pid_fields(handle, gpuIds, cudaApp):
 
     logger.debug("PIDs: %s. cudaApp PID: %d" % (str(pids), cudaApp.getpid()))
     assert cudaApp.getpid() in pids, "could not find cudaApp PID"
+
+@test_utils.run_with_standalone_host_engine(20)
+@test_utils.run_with_initialized_client()
+@test_utils.run_only_with_live_gpus()
+def test_dcgm_reader_subscribe(handle, gpuIds):
+    """
+    Verifies that a subscribed DcgmReader hands each pushed sample to its handlers exactly once
+    """
+    fieldId = dcgm_fields.DCGM_FI_DEV_GPU_TEMP
+
+    # pylint: disable=undefined-variable
+    class SampleCollector(DcgmReader):
+        def __init__(self):
+            DcgmReader.__init__(self, fieldIds=[fieldId], updateFrequency=100000, gpuIds=[gpuIds[0]], subscribe=True)
+            self.timestamps = []
+
+        def CustomDataHandler(self, fvs):
+            for fv in fvs[gpuIds[0]][fieldId]:
+                self.timestamps.append(fv.ts)
+
+    dr = SampleCollector()
+    dr.SetHandle(handle)
+    assert dr.m_streamId is not None
+
+    # Polling every 100 ms sees 5 samples in about half a second. Allow for slow test machines
+    dr.Start()
+    deadline = time.time() + 10.0
+    while len(dr.timestamps) < 5 and time.time() < deadline:
+        time.sleep(0.1)
+    dr.Stop()
+    dr.Process()
+    dr.m_dcgmGroup.samples.UnsubscribeFields(dr.m_streamId)
+
+    assert len(dr.timestamps) >= 5, "only got %d samples" % len(dr.timestamps)
+    assert dr.timestamps == sorted(set(dr.timestamps)), "got duplicate or out of order samples"
@@ -831,6 +831,32 @@ def test_dcgm_introspect_get_field_exec_time_validate(handle):
         versionTest = 50 #random number version
         ret = vtDcgmIntrospectGetFieldExecTime(handle, fieldId, versionTest, waitIfNoData)
 
+# Every version of dcgmIntrospectFullFieldsExecTime that dcgmIntrospectGetFieldExecTime accepts
+FULL_FIELDS_EXEC_TIME_VERSIONS = [
+    (dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v2, dcgm_structs.dcgmIntrospectFullFieldsExecTime_version2),
+    (dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v3, dcgm_structs.dcgmIntrospectFullFieldsExecTime_version3),
+    (dcgm_structs.c_dcgmIntrospectFullFieldsExecTime_v4, dcgm_structs.dcgmIntrospectFullFieldsExecTime_version4),
+]
+
+@test_utils.run_with_embedded_host_engine()
+@test_utils.run_with_introspection_enabled()
+def test_dcgm_introspect_get_field_exec_time_all_versions(handle):
+
+    """
+    Validates that older structure versions are still accepted
+    """
+    fn = dcgm_structs._dcgmGetFunctionPointer("dcgmIntrospectGetFieldExecTime")
+    fieldId = dcgm_fields.DCGM_FI_DEV_GPU_TEMP
+    waitIfNoData = False
+
+    for structClass, version in FULL_FIELDS_EXEC_TIME_VERSIONS:
+        execTime = structClass()
+        execTime.version = version
+
+        ret = fn(handle, fieldId, byref(execTime), waitIfNoData)
+        assert ret != dcgm_structs.DCGM_ST_VER_MISMATCH, "Version 0x%X was rejected" % version
+        assert execTime.version == version, "Version 0x%X came back as 0x%X" % (version, execTime.version)
+
 
 def vtDcgmIntrospectGetFieldMemoryUsage(dcgm_handle, fieldId, versionTest, waitIfNoData=True):
     fn = dcgm_structs._dcgmGetFunctionPointer("dcgmIntrospectGetFieldMemoryUsage")
@@ -28,6 +28,7 @@ import apps
 from dcgm_structs import dcgmExceptionClass
 import utils
 import os
+import threading
 
 g_profilingFieldIds = [
     dcgm_fields.DCGM_FI_PROF_GR_ENGINE_ACTIVE,
@@ -291,6 +292,45 @@ def helper_dcgm_entities_get_latest_values(handle, gpuIds):
 def test_dcgm_entities_get_latest_values_embedded(handle, gpuIds):
     helper_dcgm_entities_get_latest_values(handle, gpuIds)
 
+def helper_dcgm_entities_get_latest_values_async(handle, gpuIds):
+    fieldIds = [dcgm_fields.DCGM_FI_DEV_GPU_TEMP, dcgm_fields.DCGM_FI_DEV_SM_CLOCK]
+    entityPairList = [dcgm_structs.c_dcgmGroupEntityPair_t(dcgm_fields.DCGM_FE_GPU, gpuId) for gpuId in gpuIds]
+    numRequests = 10
+    statuses = []
+    done = threading.Event()
+
+    def on_complete(status, userData):
+        statuses.append(status)
+        if len(statuses) == numRequests:
+            done.set()
+
+    #Keep the callback and every request's values alive until the requests complete
+    callback = dcgm_agent.dcgmRequestComplete_f(on_complete)
+    flags = dcgm_structs.DCGM_FV_FLAG_LIVE_DATA
+    requests = []
+    for i in range(numRequests):
+        requests.append(dcgm_agent.dcgmEntitiesGetLatestValuesAsync(handle, entityPairList, fieldIds, flags, callback, None))
+
+    assert done.wait(30), "Only %d of %d requests completed" % (len(statuses), numRequests)
+    assert statuses == [dcgm_structs.DCGM_ST_OK] * numRequests, "Got statuses %s" % str(statuses)
+
+    for fieldValues in requests:
+        for i, fieldValue in enumerate(fieldValues):
+            assert(fieldValue.version == dcgm_structs.dcgmFieldValue_version2), "idx %d Version was x%X" % (i, fieldValue.version)
+            assert(fieldValue.entityId in gpuIds and fieldValue.fieldId in fieldIds), "idx %d unexpected eid %d fieldId %d" % (i, fieldValue.entityId, fieldValue.fieldId)
+            assert(fieldValue.status == dcgm_structs.DCGM_ST_OK), "idx %d status was %d" % (i, fieldValue.status)
+
+@test_utils.run_with_embedded_host_engine()
+@test_utils.run_only_with_live_gpus()
+def test_dcgm_entities_get_latest_values_async_embedded(handle, gpuIds):
+    helper_dcgm_entities_get_latest_values_async(handle, gpuIds)
+
+@test_utils.run_with_standalone_host_engine(20)
+@test_utils.run_with_initialized_client()
+@test_utils.run_only_with_live_gpus()
+def test_dcgm_entities_get_latest_values_async_remote(handle, gpuIds):
+    helper_dcgm_entities_get_latest_values_async(handle, gpuIds)
+
 #Skip this test when running in injection-only mode
 @test_utils.run_with_embedded_host_engine()
 @test_utils.run_only_with_live_gpus()
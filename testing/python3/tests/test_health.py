@@ -468,7 +468,54 @@ def test_dcgm_standalone_health_check_thermal(handle, gpuIds):
     assert (responseV4.incidents[0].entityInfo.entityId == gpuIds[0])
     assert (responseV4.incidents[0].system == dcgm_structs.DCGM_HEALTH_WATCH_THERMAL)
     assert (responseV4.incidents[0].error.code == dcgm_errors.DCGM_FR_CLOCK_THROTTLE_THERMAL)
-    
+
+def helper_dcgm_health_check_thermal_anomaly(handle, gpuIds):
+    """
+    Verifies that a temperature creeping away from its baseline is reported as an anomaly
+    """
+    handleObj = pydcgm.DcgmHandle(handle=handle)
+    systemObj = handleObj.GetSystem()
+    groupObj = systemObj.GetEmptyGroup("test1")
+    groupObj.AddGpu(gpuIds[0])
+    gpuId = gpuIds[0]
+
+    groupObj.health.Set(dcgm_structs.DCGM_HEALTH_WATCH_THERMAL)
+
+    # Learn a baseline of 50C, alternating by a degree
+    for i in range(40):
+        ret = dcgm_internal_helpers.inject_field_value_i64(handle, gpuId, dcgm_fields.DCGM_FI_DEV_GPU_TEMP,
+                                                           50 + (i % 2), -100 + i)
+        assert (ret == dcgm_structs.DCGM_ST_OK)
+
+    responseV4 = groupObj.health.Check(dcgm_structs.dcgmHealthResponse_version4)
+    assert (responseV4.incidentCount == 0), "Got %d incidents on a flat baseline" % responseV4.incidentCount
+
+    # Creep up a degree per sample. No single sample is out of bounds, but together they are
+    for i in range(20):
+        ret = dcgm_internal_helpers.inject_field_value_i64(handle, gpuId, dcgm_fields.DCGM_FI_DEV_GPU_TEMP,
+                                                           51 + i, -60 + i)
+        assert (ret == dcgm_structs.DCGM_ST_OK)
+
+    responseV4 = groupObj.health.Check(dcgm_structs.dcgmHealthResponse_version4)
+
+    assert (responseV4.incidentCount == 1)
+    assert (responseV4.incidents[0].entityInfo.entityGroupId == dcgm_fields.DCGM_FE_GPU)
+    assert (responseV4.incidents[0].entityInfo.entityId == gpuId)
+    assert (responseV4.incidents[0].system == dcgm_structs.DCGM_HEALTH_WATCH_THERMAL)
+    assert (responseV4.incidents[0].health == dcgm_structs.DCGM_HEALTH_RESULT_WARN)
+    assert (responseV4.incidents[0].error.code == dcgm_errors.DCGM_FR_FIELD_ANOMALY)
+
+@test_utils.run_with_standalone_host_engine(120)
+@test_utils.run_with_initialized_client()
+@test_utils.run_with_injection_gpus()
+def test_dcgm_standalone_health_check_thermal_anomaly(handle, gpuIds):
+    helper_dcgm_health_check_thermal_anomaly(handle, gpuIds)
+
+@test_utils.run_with_embedded_host_engine()
+@test_utils.run_with_injection_gpus()
+def test_dcgm_embedded_health_check_thermal_anomaly(handle, gpuIds):
+    helper_dcgm_health_check_thermal_anomaly(handle, gpuIds)
+
 @test_utils.run_with_standalone_host_engine(20)
 @test_utils.run_with_initialized_client()
 def test_dcgm_standalone_health_set_power(handle):
@@ -1244,3 +1291,52 @@ def helper_test_dcgm_health_check_row_remap_failure(handle, gpuIds):
 @test_utils.run_with_injection_gpus(2)
 def test_dcgm_health_check_row_remap_failure(handle, gpuIds):
     helper_test_dcgm_health_check_row_remap_failure(handle, gpuIds)
+
+def helper_test_dcgm_health_check_pcie_window(handle, gpuIds):
+    """
+    Verifies that a default check only counts the PCIe replays of the last minute, including
+    samples that arrived after the previous check
+    """
+    handleObj = pydcgm.DcgmHandle(handle=handle)
+    systemObj = handleObj.GetSystem()
+    groupObj = systemObj.GetEmptyGroup("test1")
+    groupObj.AddGpu(gpuIds[0])
+    gpuIds = groupObj.GetGpuIds() #Limit gpuIds to GPUs in our group
+    gpuId = gpuIds[0]
+
+    newSystems = dcgm_structs.DCGM_HEALTH_WATCH_PCIE
+    groupObj.health.Set(newSystems)
+
+    skip_test_if_unhealthy(groupObj)
+
+    # Replays from before the last minute don't count
+    ret = dcgm_internal_helpers.inject_field_value_i64(handle, gpuId, dcgm_fields.DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
+            0, -90) # set the injected data to 90 seconds ago
+    assert (ret == dcgm_structs.DCGM_ST_OK)
+    ret = dcgm_internal_helpers.inject_field_value_i64(handle, gpuId, dcgm_fields.DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
+            100, -50) # set the injected data to 50 seconds ago
+    assert (ret == dcgm_structs.DCGM_ST_OK)
+
+    responseV4 = groupObj.health.Check(dcgm_structs.dcgmHealthResponse_version4)
+    assert (responseV4.incidentCount == 0), "Got %d incidents" % responseV4.incidentCount
+
+    ret = dcgm_internal_helpers.inject_field_value_i64(handle, gpuId, dcgm_fields.DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
+            110, 0) # set the injected data to now
+    assert (ret == dcgm_structs.DCGM_ST_OK)
+
+    responseV4 = groupObj.health.Check(dcgm_structs.dcgmHealthResponse_version4)
+    assert (responseV4.incidentCount == 1)
+    assert (responseV4.incidents[0].entityInfo.entityId == gpuId)
+    assert (responseV4.incidents[0].system == dcgm_structs.DCGM_HEALTH_WATCH_PCIE)
+    assert (responseV4.incidents[0].error.code == dcgm_errors.DCGM_FR_PCI_REPLAY_RATE)
+
+@test_utils.run_with_embedded_host_engine()
+@test_utils.run_with_injection_gpus()
+def test_dcgm_health_check_pcie_window_embedded(handle, gpuIds):
+    helper_test_dcgm_health_check_pcie_window(handle, gpuIds)
+
+@test_utils.run_with_standalone_host_engine(120)
+@test_utils.run_with_initialized_client()
+@test_utils.run_with_injection_gpus()
+def test_dcgm_health_check_pcie_window_standalone(handle, gpuIds):
+    helper_test_dcgm_health_check_pcie_window(handle, gpuIds)
@@ -12,11 +12,14 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 # test the metadata API calls for DCGM
+import json
+import os
 import time
 from sys import float_info
 
 import dcgm_structs
 import dcgm_agent_internal
+import dcgm_structs_internal
 import dcgm_field_helpers
 import dcgm_fields
 import pydcgm
@@ -462,3 +465,69 @@ def test_dcgm_embedded_metadata_cpuutil_get_hostengine_sane(handle):
            'CPU kernel and user utilization did not add up to total. Kernel: %f, User: %f, Total: %f' \
            % (cpuUtil.kernel, cpuUtil.user, cpuUtil.total)
 
+
+@test_utils.run_with_embedded_host_engine()
+def test_dcgm_embedded_trace_dump(handle):
+    """
+    Verifies that a started trace records update-loop spans and dumps them as Chrome trace JSON
+    """
+    dcgmHandle = pydcgm.DcgmHandle(handle)
+    group = pydcgm.DcgmGroup(dcgmHandle, groupName="trace-test", groupType=dcgm_structs.DCGM_GROUP_DEFAULT)
+
+    traceControl = dcgm_agent_internal.dcgmTraceControl(handle, dcgm_structs_internal.DCGM_TRACE_ACTION_START, 1024)
+    assert traceControl.isEnabled == 1
+    assert traceControl.numSpans > 0, "numSpans %d" % traceControl.numSpans
+
+    _watch_field_group_basic(pydcgm.DcgmFieldGroup(dcgmHandle, "trace-test", [dcgm_fields.DCGM_FI_DEV_GPU_TEMP, ]),
+                             dcgmHandle.handle, group.GetId())
+    dcgmHandle.GetSystem().UpdateAllFields(1)
+
+    traceControl = dcgm_agent_internal.dcgmTraceControl(handle, dcgm_structs_internal.DCGM_TRACE_ACTION_DUMP)
+    filename = traceControl.filename.decode('utf-8')
+    try:
+        with open(filename) as traceFile:
+            trace = json.load(traceFile)
+    finally:
+        os.remove(filename)
+
+    names = set(event['name'] for event in trace['traceEvents'])
+    assert 'ActuallyUpdateAllFields' in names, "Got span names %s" % str(names)
+    for event in trace['traceEvents']:
+        assert event['ph'] == 'X' and event['dur'] >= 0, str(event)
+
+    traceControl = dcgm_agent_internal.dcgmTraceControl(handle, dcgm_structs_internal.DCGM_TRACE_ACTION_STOP)
+    assert traceControl.isEnabled == 0
+
+
+@test_utils.run_with_embedded_host_engine()
+def test_dcgm_embedded_mutex_profile_dump(handle):
+    """
+    Verifies that mutex profiling records waits and holds per call site and dumps them as JSON
+    """
+    dcgmHandle = pydcgm.DcgmHandle(handle)
+
+    traceControl = dcgm_agent_internal.dcgmTraceControl(
+        handle, dcgm_structs_internal.DCGM_TRACE_ACTION_MUTEX_PROFILE_START)
+    assert traceControl.isEnabled == 1
+
+    dcgmHandle.GetSystem().UpdateAllFields(1)
+    pydcgm.DcgmGroup(dcgmHandle, groupName="mutex-profile-test", groupType=dcgm_structs.DCGM_GROUP_EMPTY).Delete()
+
+    traceControl = dcgm_agent_internal.dcgmTraceControl(
+        handle, dcgm_structs_internal.DCGM_TRACE_ACTION_MUTEX_PROFILE_DUMP)
+    filename = traceControl.filename.decode('utf-8')
+    try:
+        with open(filename) as profileFile:
+            profile = json.load(profileFile)
+    finally:
+        os.remove(filename)
+
+    files = set(os.path.basename(site['file']) for site in profile['sites'])
+    assert 'DcgmCacheManager.cpp' in files, "Got sites in %s" % str(files)
+    assert 'DcgmGroupManager.cpp' in files, "Got sites in %s" % str(files)
+    for site in profile['sites']:
+        assert sum(site['wait']['buckets']) == site['wait']['count'], str(site)
+
+    traceControl = dcgm_agent_internal.dcgmTraceControl(
+        handle, dcgm_structs_internal.DCGM_TRACE_ACTION_MUTEX_PROFILE_STOP)
+    assert traceControl.isEnabled == 0
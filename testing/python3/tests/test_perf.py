@@ -24,7 +24,9 @@ from collections import defaultdict
 from distutils.version import LooseVersion # pylint: disable=import-error,no-name-in-module
 
 import dcgm_structs
+import dcgm_agent
 import dcgm_agent_internal
+import dcgm_internal_helpers
 import dcgm_fields
 import pydcgm
 import logger
@@ -495,3 +497,196 @@ def _test_cpuutil_bounded_flatlines_hostengine(cpuUtilTS):
         'CPU utilization did not stay consistent.  It varied for %.2f%% of the time out of %d points '
         % (100*relativeOutliers, len(tail))
         + 'but it is only allowed to vary %.2f%% of the time' % (100*relativeOutliersAllowed))
+
+################################################################################
+# Performance regression tier. Run with --perf-regression.
+#
+# Each test measures the host engine against fake GPUs with injected values and
+# compares what it measured against tests/perf_baselines.json. A baseline is
+# allowed to grow by its relative tolerance plus its absolute slack before the
+# test fails. Rerun with --update-perf-baselines on the reference machine to
+# record new baselines after an intentional change.
+################################################################################
+
+PERF_BASELINES_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'perf_baselines.json')
+PERF_GPU_COUNT = 8
+PERF_UPDATE_FREQ = 100000 # 100 ms
+PERF_SAMPLE_DURATION = 30 # seconds to average the update loop's CPU over
+PERF_REQUEST_COUNT = 1000
+PERF_SOAK_DURATION = 600 # seconds
+
+# Fields a typical monitoring agent watches
+PERF_FIELD_IDS = [dcgm_fields.DCGM_FI_DEV_SM_CLOCK,
+                  dcgm_fields.DCGM_FI_DEV_MEM_CLOCK,
+                  dcgm_fields.DCGM_FI_DEV_GPU_TEMP,
+                  dcgm_fields.DCGM_FI_DEV_POWER_USAGE,
+                  dcgm_fields.DCGM_FI_DEV_PCIE_REPLAY_COUNTER,
+                  dcgm_fields.DCGM_FI_DEV_GPU_UTIL,
+                  dcgm_fields.DCGM_FI_DEV_MEM_COPY_UTIL,
+                  dcgm_fields.DCGM_FI_DEV_XID_ERRORS,
+                  dcgm_fields.DCGM_FI_DEV_FB_USED,
+                  dcgm_fields.DCGM_FI_DEV_ECC_DBE_VOL_TOTAL]
+
+def _skip_unless_perf_regression():
+    if not option_parser.options.perf_regression:
+        test_utils.skip_test("Skipping perf regression test. Run with --perf-regression")
+
+def _check_perf_baseline(name, measured):
+    '''
+    Compare measured against the baseline called name, or record it as the new baseline
+    with --update-perf-baselines
+    '''
+    with open(PERF_BASELINES_FILE) as f:
+        baselines = json.load(f)
+
+    assert name in baselines, 'No baseline called "%s" in %s' % (name, PERF_BASELINES_FILE)
+    baseline = baselines[name]
+    logger.info('%s: measured %.2f %s, baseline %s' % (name, measured, baseline['units'], baseline['value']))
+
+    if option_parser.options.update_perf_baselines:
+        baseline['value'] = round(measured, 2)
+        with open(PERF_BASELINES_FILE, 'w') as f:
+            json.dump(baselines, f, indent=4, sort_keys=True)
+            f.write('\n')
+        return
+
+    if baseline['value'] is None:
+        logger.warning('No baseline recorded for %s yet. Record one with --update-perf-baselines' % name)
+        return
+
+    limit = baseline['value'] * (1 + baseline['tolerance']) + baseline['slack']
+    assert measured <= limit, \
+        '%s regressed: measured %.2f %s but the limit is %.2f (baseline %.2f + %d%% + %.2f). ' % \
+        (name, measured, baseline['units'], limit, baseline['value'], 100 * baseline['tolerance'], baseline['slack']) \
+        + 'If this is expected, record a new baseline with --update-perf-baselines.'
+
+def _perf_setup(handle, gpuIds):
+    handleObj = pydcgm.DcgmHandle(handle=handle)
+    groupObj = handleObj.GetSystem().GetEmptyGroup("perf-regression")
+    for gpuId in gpuIds:
+        groupObj.AddGpu(gpuId)
+    fieldGroup = pydcgm.DcgmFieldGroup(handleObj, "perf-regression", PERF_FIELD_IDS)
+    return handleObj, groupObj, fieldGroup
+
+def _perf_inject(handle, gpuIds, value):
+    '''Inject a new value of every PERF_FIELD_IDS field on each GPU'''
+    for gpuId in gpuIds:
+        for fieldId in PERF_FIELD_IDS:
+            if dcgm_fields.DcgmFieldGetById(fieldId).fieldType == dcgm_fields.DCGM_FT_DOUBLE:
+                dcgm_internal_helpers.inject_field_value_fp64(handle, gpuId, fieldId, float(value), 0)
+            else:
+                dcgm_internal_helpers.inject_field_value_i64(handle, gpuId, fieldId, value, 0)
+
+def _perf_latencies_usec(fn, count):
+    latencies = []
+    for _ in range(count):
+        start = time.time()
+        fn()
+        latencies.append((time.time() - start) * 1000000.0)
+    return latencies
+
+@test_utils.run_with_standalone_host_engine(timeout=PERF_SAMPLE_DURATION + 60)
+@test_utils.run_with_initialized_client()
+@test_utils.run_with_introspection_enabled(runIntervalMs=1000)
+@test_utils.run_with_injection_gpus(PERF_GPU_COUNT)
+def test_dcgm_perf_regression_update_loop_cpu(handle, gpuIds):
+    '''
+    The CPU the update loop uses for each watch (one field of one GPU) doesn't regress
+    '''
+    _skip_unless_perf_regression()
+    handleObj, groupObj, fieldGroup = _perf_setup(handle, gpuIds)
+    _perf_inject(handle, gpuIds, 1)
+
+    groupObj.samples.WatchFields(fieldGroup, PERF_UPDATE_FREQ, 3600.0, 0)
+    handleObj.GetSystem().UpdateAllFields(True)
+    time.sleep(5) # let the update loop settle
+
+    cpuUtil = []
+    end = time.time() + PERF_SAMPLE_DURATION
+    while time.time() < end:
+        cpuUtil.append(handleObj.GetSystem().introspect.cpuUtil.GetForHostengine().total)
+        time.sleep(1)
+
+    numWatches = len(gpuIds) * len(PERF_FIELD_IDS)
+    cpuUsecPerSecPerWatch = stats.mean(cpuUtil) * 1000000.0 / numWatches
+    _check_perf_baseline('update_loop_cpu_usec_per_sec_per_watch', cpuUsecPerSecPerWatch)
+
+@test_utils.run_with_standalone_host_engine(timeout=120)
+@test_utils.run_with_initialized_client()
+@test_utils.run_with_injection_gpus(PERF_GPU_COUNT)
+def test_dcgm_perf_regression_request_latency(handle, gpuIds):
+    '''
+    The latency of reading the latest values of every watch doesn't regress
+    '''
+    _skip_unless_perf_regression()
+    handleObj, groupObj, fieldGroup = _perf_setup(handle, gpuIds)
+    _perf_inject(handle, gpuIds, 1)
+
+    groupObj.samples.WatchFields(fieldGroup, PERF_UPDATE_FREQ, 3600.0, 0)
+    handleObj.GetSystem().UpdateAllFields(True)
+
+    entities = [dcgm_structs.c_dcgmGroupEntityPair_t(dcgm_fields.DCGM_FE_GPU, gpuId) for gpuId in gpuIds]
+    latencies = _perf_latencies_usec(
+        lambda: dcgm_agent.dcgmEntitiesGetLatestValues(handle, entities, PERF_FIELD_IDS, 0), PERF_REQUEST_COUNT)
+
+    _check_perf_baseline('get_latest_values_p50_usec', stats.percentile(latencies, 50))
+    _check_perf_baseline('get_latest_values_p99_usec', stats.percentile(latencies, 99))
+
+@test_utils.run_with_standalone_host_engine(timeout=120)
+@test_utils.run_with_initialized_client()
+@test_utils.run_with_injection_gpus(PERF_GPU_COUNT)
+def test_dcgm_perf_regression_health_and_job_stats_latency(handle, gpuIds):
+    '''
+    The latency of health checks and of getting job stats doesn't regress
+    '''
+    _skip_unless_perf_regression()
+    handleObj, groupObj, fieldGroup = _perf_setup(handle, gpuIds)
+    _perf_inject(handle, gpuIds, 1)
+
+    groupObj.health.Set(dcgm_structs.DCGM_HEALTH_WATCH_ALL)
+    groupObj.stats.WatchJobFields(PERF_UPDATE_FREQ, 3600.0, 0)
+    groupObj.stats.StartJobStats("perf-regression")
+    handleObj.GetSystem().UpdateAllFields(True)
+    time.sleep(2) # build up some samples for the job
+    groupObj.stats.StopJobStats("perf-regression")
+
+    latencies = _perf_latencies_usec(lambda: groupObj.health.Check(), PERF_REQUEST_COUNT)
+    _check_perf_baseline('health_check_p50_usec', stats.percentile(latencies, 50))
+    _check_perf_baseline('health_check_p99_usec', stats.percentile(latencies, 99))
+
+    latencies = _perf_latencies_usec(lambda: groupObj.stats.GetJobStats("perf-regression"), PERF_REQUEST_COUNT)
+    _check_perf_baseline('job_get_stats_p50_usec', stats.percentile(latencies, 50))
+    _check_perf_baseline('job_get_stats_p99_usec', stats.percentile(latencies, 99))
+
+@test_utils.run_with_standalone_host_engine(timeout=PERF_SOAK_DURATION + 120)
+@test_utils.run_with_initialized_client()
+@test_utils.run_with_introspection_enabled(runIntervalMs=1000)
+@test_utils.run_with_injection_gpus(PERF_GPU_COUNT)
+def test_dcgm_perf_regression_soak_memory(handle, gpuIds):
+    '''
+    The host engine's RSS stops growing once its watches are full while values keep arriving
+    '''
+    _skip_unless_perf_regression()
+    handleObj, groupObj, fieldGroup = _perf_setup(handle, gpuIds)
+    _perf_inject(handle, gpuIds, 1)
+
+    # Keep 60 seconds of samples so that the caches fill up early in the soak
+    groupObj.samples.WatchFields(fieldGroup, PERF_UPDATE_FREQ, 60.0, 0)
+    handleObj.GetSystem().UpdateAllFields(True)
+
+    introspect = handleObj.GetSystem().introspect
+    startBytes = None
+    value = 1
+    end = time.time() + PERF_SOAK_DURATION
+    while time.time() < end:
+        value += 1
+        _perf_inject(handle, gpuIds, value)
+        groupObj.samples.GetLatest_v2(fieldGroup)
+        time.sleep(1)
+
+        # Start measuring once the caches are full
+        if startBytes is None and time.time() > end - PERF_SOAK_DURATION + 120:
+            startBytes = introspect.memory.GetForHostengine().bytesUsed
+
+    growthKiB = (introspect.memory.GetForHostengine().bytesUsed - startBytes) / 1024.0
+    _check_perf_baseline('soak_rss_growth_kib', max(growthKiB, 0.0))
@@ -15,6 +15,7 @@
 
 import dcgm_structs
 import dcgm_structs_internal
+import dcgm_agent
 import dcgm_agent_internal
 import dcgmvalue
 import pydcgm
@@ -335,6 +336,67 @@ def test_dcgm_policy_inject_pcierror_standalone(handle, gpuIds):
 def test_dcgm_policy_inject_pcierror_embedded(handle, gpuIds):
     helper_dcgm_policy_inject_pcierror(handle, gpuIds)
 
+def create_c_callback_v2(queue):
+    @CFUNCTYPE(None, c_void_p)
+    def c_callback(data):
+        callbackData = dcgm_structs.c_dcgmPolicyCallbackResponse_v2()
+        memmove(addressof(callbackData), data, callbackData.FieldsSizeof())
+        queue.put(callbackData)
+    return c_callback
+
+@test_utils.run_with_standalone_host_engine(40)
+@test_utils.run_with_initialized_client()
+@test_utils.run_with_injection_gpus()
+def test_dcgm_policy_coalesce_pcierrors_standalone(handle, gpuIds):
+    """
+    Verifies that violations within a registration's coalescing window are folded into one callback
+    """
+    newPolicy = dcgm_structs.c_dcgmPolicy_v1()
+    newPolicy.version = dcgm_structs.dcgmPolicy_version1
+    newPolicy.condition = dcgm_structs.DCGM_POLICY_COND_PCI
+    newPolicy.parms[1].tag = 1
+    newPolicy.parms[1].val.llval = 0
+
+    gpuId = gpuIds[0]
+    group = pydcgm.DcgmGroup(pydcgm.DcgmHandle(handle), groupName="test1", groupType=dcgm_structs.DCGM_GROUP_EMPTY)
+    group.AddGpu(gpuId)
+    group.policy.Set(newPolicy)
+
+    callbackQueue = queue.Queue()
+    c_callback = create_c_callback_v2(callbackQueue)
+    windowUsec = 30 * 1000000
+    dcgm_agent.dcgmPolicyRegister_v2(handle, group.GetId(), dcgm_structs.DCGM_POLICY_COND_PCI, None, c_callback,
+                                     coalesceWindowUsec=windowUsec)
+
+    # The first violation is notified right away. The next two fall in its window and are folded into the
+    # notification of the fourth, which comes after the window
+    startTs = int((time.time()+60) * 1000000.0) # set the injected data into the future
+    injectTs = [startTs, startTs + 1000000, startTs + 2000000, startTs + windowUsec + 1000000]
+    for i, ts in enumerate(injectTs):
+        field = dcgm_structs_internal.c_dcgmInjectFieldValue_v1()
+        field.version = dcgm_structs_internal.dcgmInjectFieldValue_version1
+        field.fieldId = dcgm_fields.DCGM_FI_DEV_PCIE_REPLAY_COUNTER
+        field.status = 0
+        field.fieldType = ord(dcgm_fields.DCGM_FT_INT64)
+        field.ts = ts
+        field.value.i64 = i + 1
+        ret = dcgm_agent_internal.dcgmInjectFieldValue(handle, gpuId, field)
+        assert (ret == dcgm_structs.DCGM_ST_OK)
+
+    callbacks = []
+    try:
+        while sum([c.numViolations for c in callbacks]) < len(injectTs):
+            callbacks.append(callbackQueue.get(timeout=POLICY_CALLBACK_TIMEOUT_SECS))
+    except queue.Empty:
+        assert False, "Got %d callbacks for %s" % (len(callbacks), str([c.numViolations for c in callbacks]))
+
+    assert len(callbacks) == 2, "Expected 2 callbacks but got %d" % len(callbacks)
+    assert callbacks[0].version == dcgm_structs.dcgmPolicyCallbackResponse_version2
+    assert callbacks[0].numViolations == 1 and callbacks[0].firstTimestamp == injectTs[0]
+    assert callbacks[1].numViolations == 3, "Expected 3 violations but got %d" % callbacks[1].numViolations
+    assert callbacks[1].firstTimestamp == injectTs[1] and callbacks[1].lastTimestamp == injectTs[3]
+    assert callbacks[1].val.pci.counter == 4, "Expected counter 4 but got %d" % callbacks[1].val.pci.counter
+
 
 @test_utils.run_with_standalone_host_engine(40)
 @test_utils.run_with_initialized_client()
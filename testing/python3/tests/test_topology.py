@@ -93,6 +93,32 @@ def test_dcgm_topology_device_nvlink_standalone(handle, gpuIds):
 
     assert ((topologyInfo.gpuPaths[0].path & 0xFFFFFF00) > 0), "No NVLINK state set when localNvLinkIds is > 0"
 
+@test_utils.run_with_standalone_host_engine(20)
+@test_utils.run_with_initialized_client()
+@test_utils.run_only_with_all_supported_gpus()
+def test_dcgm_bulk_attributes_and_topology_standalone(handle, gpuIds):
+    """
+    Verifies that the bulk attribute and topology gets match the ones of each GPU
+    """
+    bulkAttributes = dcgm_agent.dcgmGetDeviceAttributesBulk(handle, gpuIds)
+    bulkTopologies = dcgm_agent.dcgmGetDeviceTopologyBulk(handle, gpuIds)
+
+    assert len(bulkAttributes) == len(gpuIds), "Expected %d attributes, got %d" % (len(gpuIds), len(bulkAttributes))
+    assert len(bulkTopologies) == len(gpuIds), "Expected %d topologies, got %d" % (len(gpuIds), len(bulkTopologies))
+
+    for i, gpuId in enumerate(gpuIds):
+        attributes = dcgm_agent.dcgmGetDeviceAttributes(handle, gpuId)
+        assert bulkAttributes[i].identifiers.uuid == attributes.identifiers.uuid, \
+            "GPU %d: UUID %s != %s" % (gpuId, bulkAttributes[i].identifiers.uuid, attributes.identifiers.uuid)
+        assert bulkAttributes[i].identifiers.pciBusId == attributes.identifiers.pciBusId, \
+            "GPU %d: PCI bus ID differs" % gpuId
+
+        topology = dcgm_agent.dcgmGetDeviceTopology(handle, gpuId)
+        assert bulkTopologies[i].numGpus == topology.numGpus, \
+            "GPU %d: numGpus %d != %d" % (gpuId, bulkTopologies[i].numGpus, topology.numGpus)
+        assert bulkTopologies[i].cpuAffinityMask[0] == topology.cpuAffinityMask[0], \
+            "GPU %d: cpuAffinityMask differs" % gpuId
+
 def helper_test_select_gpus_by_topology(handle, gpuIds):
     '''
     Verifies basic selection of GPUs by topology. 